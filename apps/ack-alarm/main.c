@@ -413,11 +413,13 @@ int main(int argc, char *argv[])
                 Request_Invoke_ID = Send_Alarm_Acknowledgement_Address(
                     Handler_Transmit_Buffer, sizeof(Handler_Transmit_Buffer),
                     &data, &Target_Address);
-            } else if (tsm_invoke_id_free(Request_Invoke_ID)) {
+            } else if (tsm_invoke_id_free_peer(
+                           &Target_Address, Request_Invoke_ID)) {
                 break;
-            } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
+            } else if (tsm_invoke_id_failed_peer(
+                           &Target_Address, Request_Invoke_ID)) {
                 fprintf(stderr, "\rError: TSM Timeout!\n");
-                tsm_free_invoke_id(Request_Invoke_ID);
+                tsm_free_invoke_id_peer(&Target_Address, Request_Invoke_ID);
                 Error_Detected = true;
                 /* try again or abort? */
                 break;
@@ -492,11 +492,13 @@ int main(int argc, char *argv[])
                     Target_Device_Object_Instance, Target_Object_Type,
                     Target_Object_Instance, Target_Object_Property,
                     &Target_Object_Value, Target_Object_Array_Index);
-            } else if (tsm_invoke_id_free(Request_Invoke_ID)) {
+            } else if (tsm_invoke_id_free_peer(
+                           &Target_Address, Request_Invoke_ID)) {
                 break;
-            } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
+            } else if (tsm_invoke_id_failed_peer(
+                           &Target_Address, Request_Invoke_ID)) {
                 fprintf(stderr, "\rError: TSM Timeout!\n");
-                tsm_free_invoke_id(Request_Invoke_ID);
+                tsm_free_invoke_id_peer(&Target_Address, Request_Invoke_ID);
                 Error_Detected = true;
                 /* abort */
                 break;
@@ -0,0 +1,291 @@
+/**
+ * @file
+ * @brief Benchmarks for the BACnet encoding and decoding hot paths
+ *
+ * Each operation is timed alone over many iterations, and the cost of
+ * the loop that calls it is measured and taken off, so that the result
+ * is the cost of one call.  None of the operations allocate memory.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/rpm.h"
+#include "bacnet/datalink/cobs.h"
+#include "bacnet/datalink/crc.h"
+#include "bacnet/version.h"
+#include "codec.h"
+
+/* the results are stored here so that the calls are not optimized away */
+static volatile uint32_t Codec_Sink;
+
+/* the encoded data that is decoded by the benchmarks */
+static uint8_t Codec_Tag_APDU[MAX_APDU];
+static int Codec_Tag_APDU_Len;
+static uint8_t Codec_Real_APDU[MAX_APDU];
+static int Codec_Real_APDU_Len;
+static uint8_t Codec_String_APDU[MAX_APDU];
+static int Codec_String_APDU_Len;
+static uint8_t Codec_RPM_APDU[MAX_APDU];
+static int Codec_RPM_APDU_Len;
+static uint8_t Codec_RPM_Array_APDU[MAX_APDU];
+static int Codec_RPM_Array_APDU_Len;
+/* an MS/TP frame header without the preamble, and the largest frames */
+static uint8_t Codec_MSTP_Header[5] = { 0x05, 0x7F, 0x01, 0x01, 0xF4 };
+static uint8_t Codec_MSTP_Data[501];
+static uint8_t Codec_COBS_Data[1497];
+static BACNET_APPLICATION_DATA_VALUE Codec_Real_Value;
+static BACNET_APPLICATION_DATA_VALUE Codec_String_Value;
+static BACNET_CHARACTER_STRING Codec_String_A;
+static BACNET_CHARACTER_STRING Codec_String_B;
+static const char *Codec_String_Text = "Zone Temperature Setpoint 1";
+
+struct codec_benchmark {
+    const char *name;
+    void (*operation)(void);
+};
+
+static void codec_baseline(void)
+{
+    Codec_Sink++;
+}
+
+static void codec_tag_decode(void)
+{
+    BACNET_TAG tag = { 0 };
+
+    Codec_Sink += (uint32_t)bacnet_tag_decode(
+        Codec_Tag_APDU, (uint32_t)Codec_Tag_APDU_Len, &tag);
+}
+
+static void codec_real_encode(void)
+{
+    uint8_t apdu[8];
+
+    Codec_Sink += (uint32_t)encode_application_real(apdu, 21.5f);
+}
+
+static void codec_real_decode(void)
+{
+    float value = 0.0f;
+
+    Codec_Sink += (uint32_t)bacnet_real_application_decode(
+        Codec_Real_APDU, (uint32_t)Codec_Real_APDU_Len, &value);
+}
+
+static void codec_bacapp_real_encode(void)
+{
+    uint8_t apdu[16];
+
+    Codec_Sink +=
+        (uint32_t)bacapp_encode_application_data(apdu, &Codec_Real_Value);
+}
+
+static void codec_bacapp_real_decode(void)
+{
+    BACNET_APPLICATION_DATA_VALUE value;
+
+    Codec_Sink += (uint32_t)bacapp_decode_application_data(
+        Codec_Real_APDU, (uint32_t)Codec_Real_APDU_Len, &value);
+}
+
+static void codec_bacapp_string_encode(void)
+{
+    uint8_t apdu[MAX_APDU];
+
+    Codec_Sink +=
+        (uint32_t)bacapp_encode_application_data(apdu, &Codec_String_Value);
+}
+
+static void codec_bacapp_string_decode(void)
+{
+    BACNET_APPLICATION_DATA_VALUE value;
+
+    Codec_Sink += (uint32_t)bacapp_decode_application_data(
+        Codec_String_APDU, (uint32_t)Codec_String_APDU_Len, &value);
+}
+
+static void codec_rpm_ack_decode(void)
+{
+    BACNET_PROPERTY_ID property = PROP_ALL;
+    BACNET_ARRAY_INDEX array_index = BACNET_ARRAY_ALL;
+
+    Codec_Sink += (uint32_t)rpm_ack_decode_object_property(
+        Codec_RPM_APDU, (unsigned)Codec_RPM_APDU_Len, &property,
+        &array_index);
+}
+
+static void codec_rpm_ack_decode_array(void)
+{
+    BACNET_PROPERTY_ID property = PROP_ALL;
+    BACNET_ARRAY_INDEX array_index = BACNET_ARRAY_ALL;
+
+    Codec_Sink += (uint32_t)rpm_ack_decode_object_property(
+        Codec_RPM_Array_APDU, (unsigned)Codec_RPM_Array_APDU_Len, &property,
+        &array_index);
+}
+
+static void codec_characterstring_init(void)
+{
+    Codec_Sink +=
+        (uint32_t)characterstring_init_ansi(&Codec_String_B, Codec_String_Text);
+}
+
+static void codec_characterstring_copy(void)
+{
+    Codec_Sink +=
+        (uint32_t)characterstring_copy(&Codec_String_B, &Codec_String_A);
+}
+
+static void codec_characterstring_same(void)
+{
+    Codec_Sink +=
+        (uint32_t)characterstring_same(&Codec_String_A, &Codec_String_B);
+}
+
+static void codec_crc_header(void)
+{
+    uint8_t crc = 0xFF;
+    unsigned i;
+
+    for (i = 0; i < sizeof(Codec_MSTP_Header); i++) {
+        crc = CRC_Calc_Header(Codec_MSTP_Header[i], crc);
+    }
+    Codec_Sink += crc;
+}
+
+static void codec_crc_data(void)
+{
+    Codec_Sink += CRC_Calc_Data_Block(
+        Codec_MSTP_Data, sizeof(Codec_MSTP_Data), 0xFFFF);
+}
+
+static void codec_crc32k(void)
+{
+    Codec_Sink += cobs_crc32k_block(
+        Codec_COBS_Data, sizeof(Codec_COBS_Data), 0xFFFFFFFF);
+}
+
+static const struct codec_benchmark Codec_Benchmarks[] = {
+    { "bacnet_tag_decode", codec_tag_decode },
+    { "encode_application_real", codec_real_encode },
+    { "bacnet_real_application_decode", codec_real_decode },
+    { "bacapp_encode_application_data/real", codec_bacapp_real_encode },
+    { "bacapp_decode_application_data/real", codec_bacapp_real_decode },
+    { "bacapp_encode_application_data/string", codec_bacapp_string_encode },
+    { "bacapp_decode_application_data/string", codec_bacapp_string_decode },
+    { "rpm_ack_decode_object_property", codec_rpm_ack_decode },
+    { "rpm_ack_decode_object_property/array", codec_rpm_ack_decode_array },
+    { "characterstring_init_ansi", codec_characterstring_init },
+    { "characterstring_copy", codec_characterstring_copy },
+    { "characterstring_same", codec_characterstring_same },
+    { "CRC_Calc_Header/5", codec_crc_header },
+    { "CRC_Calc_Data_Block/501", codec_crc_data },
+    { "cobs_crc32k_block/1497", codec_crc32k },
+};
+#define CODEC_BENCHMARKS \
+    (sizeof(Codec_Benchmarks) / sizeof(Codec_Benchmarks[0]))
+
+/**
+ * @brief Encode the data that the decode benchmarks decode
+ */
+static void codec_setup(void)
+{
+    unsigned i;
+
+    Codec_Tag_APDU_Len = encode_application_unsigned(Codec_Tag_APDU, 65535);
+    Codec_Real_APDU_Len = encode_application_real(Codec_Real_APDU, 21.5f);
+    Codec_Real_Value.tag = BACNET_APPLICATION_TAG_REAL;
+    Codec_Real_Value.type.Real = 21.5f;
+    Codec_String_Value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(
+        &Codec_String_Value.type.Character_String, Codec_String_Text);
+    Codec_String_APDU_Len =
+        bacapp_encode_application_data(Codec_String_APDU, &Codec_String_Value);
+    Codec_RPM_APDU_Len = rpm_ack_encode_apdu_object_property(
+        Codec_RPM_APDU, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    Codec_RPM_Array_APDU_Len = rpm_ack_encode_apdu_object_property(
+        Codec_RPM_Array_APDU, PROP_PRIORITY_ARRAY, 16);
+    characterstring_init_ansi(&Codec_String_A, Codec_String_Text);
+    characterstring_init_ansi(&Codec_String_B, Codec_String_Text);
+    for (i = 0; i < sizeof(Codec_MSTP_Data); i++) {
+        Codec_MSTP_Data[i] = (uint8_t)(i * 7);
+    }
+    for (i = 0; i < sizeof(Codec_COBS_Data); i++) {
+        Codec_COBS_Data[i] = (uint8_t)(i * 13);
+    }
+}
+
+/**
+ * @brief Time a number of calls to an operation
+ * @param operation - the operation to call
+ * @param iterations - number of calls
+ * @return average nanoseconds per call, including the loop
+ */
+static double
+codec_benchmark_nsec(void (*operation)(void), unsigned long iterations)
+{
+    unsigned long i;
+    clock_t start;
+
+    if (iterations == 0) {
+        return 0.0;
+    }
+    start = clock();
+    for (i = 0; i < iterations; i++) {
+        operation();
+    }
+
+    return ((double)(clock() - start) * 1000000000.0) /
+        ((double)CLOCKS_PER_SEC * iterations);
+}
+
+/**
+ * @brief Benchmark the encoding and decoding hot paths
+ * @param iterations - number of calls of each operation
+ * @param json - true to print the results as JSON, false as a table
+ */
+void benchmark_codec(unsigned long iterations, bool json)
+{
+    double baseline, nsec;
+    unsigned i;
+
+    codec_setup();
+    baseline = codec_benchmark_nsec(codec_baseline, iterations);
+    if (json) {
+        printf("{\"bacbench\":\"%s\",", BACNET_VERSION_TEXT);
+        printf("\"benchmark\":\"codec\",\"iterations\":%lu,", iterations);
+        printf("\"allocations_per_op\":0,\"results\":[");
+    } else {
+        printf("codec: ns/op over %lu iterations\n", iterations);
+        printf("%-40s %12s\n", "operation", "ns/op");
+    }
+    for (i = 0; i < CODEC_BENCHMARKS; i++) {
+        nsec = codec_benchmark_nsec(Codec_Benchmarks[i].operation, iterations);
+        nsec -= baseline;
+        if (nsec < 0.0) {
+            nsec = 0.0;
+        }
+        if (json) {
+            printf(
+                "%s{\"name\":\"%s\",\"ns_per_op\":%.3f}", i ? "," : "",
+                Codec_Benchmarks[i].name, nsec);
+        } else {
+            printf("%-40s %12.3f\n", Codec_Benchmarks[i].name, nsec);
+        }
+    }
+    if (json) {
+        printf("]}\n");
+    }
+}
@@ -0,0 +1,20 @@
+/**
+ * @file
+ * @brief Benchmarks for the BACnet encoding and decoding hot paths
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BENCHMARK_CODEC_H
+#define BACNET_BENCHMARK_CODEC_H
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+void benchmark_codec(unsigned long iterations, bool json);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
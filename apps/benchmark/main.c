@@ -0,0 +1,636 @@
+/**
+ * @file
+ * @brief Benchmarks for BACnet stack hot paths
+ *
+ * Each benchmark reports the average cost of an operation in
+ * microseconds as the workload grows, so that changes to the stack
+ * can be compared before and after.
+ *
+ * Usage:
+ * $ ./bacbench [benchmark] [options]
+ *
+ * Benchmarks:
+ * - object-name [max-objects]: Device_Valid_Object_Name() lookups
+ *   with and without the object name index.
+ * - object-create [count]: creating objects one at a time, and as a
+ *   range with Analog_Value_Create_Range().
+ * - object-list [max-objects]: Device_Object_List_Identifier() lookups
+ *   with and without the Object_List snapshot.
+ * - who-has [objects]: the Who-Has handler of a gateway with routed
+ *   devices, with and without the object name index.
+ * - trend-log: ReadRange of the log buffer of a full trend log, by
+ *   time and by sequence number, at the start and end of the log.
+ * - bbmd-forward [foreign-devices]: a BBMD registering foreign devices,
+ *   and forwarding a broadcast to each of them, one send at a time and
+ *   as a batch.
+ * - codec [iterations] [--json]: the encoding and decoding of tags,
+ *   application data, ReadPropertyMultiple-ACK, character strings,
+ *   and the MS/TP CRCs, in nanoseconds per operation.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacstr.h"
+#include "bacnet/dcc.h"
+#include "bacnet/whohas.h"
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/trendlog.h"
+#include "bacnet/basic/service/h_whohas.h"
+#if defined(BACDL_BIP)
+#include "bacnet/datalink/bip.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/basic/bbmd/h_bbmd.h"
+#endif
+#include "bacnet/version.h"
+#include "codec.h"
+
+/* number of times each operation is repeated for the average */
+#define BENCHMARK_REPEAT 1000
+
+/**
+ * @brief Convert processor clock ticks to microseconds per operation
+ * @param ticks - number of clock ticks elapsed
+ * @param count - number of operations
+ * @return average microseconds per operation
+ */
+static double benchmark_usec(clock_t ticks, unsigned long count)
+{
+    if (count == 0) {
+        return 0.0;
+    }
+
+    return ((double)ticks * 1000000.0) / ((double)CLOCKS_PER_SEC * count);
+}
+
+/**
+ * @brief Time a number of object name lookups
+ * @param object_count - number of analog value objects
+ * @param repeat - number of lookups
+ * @return average microseconds per lookup
+ */
+static double
+benchmark_object_name_lookup(unsigned object_count, unsigned repeat)
+{
+    BACNET_CHARACTER_STRING object_name;
+    char name_text[32];
+    unsigned i;
+    clock_t start;
+    bool found;
+
+    start = clock();
+    for (i = 0; i < repeat; i++) {
+        /* a mix of names near the end of the list, and names that
+           are not found and must be searched for completely */
+        if (i & 1) {
+            snprintf(name_text, sizeof(name_text), "BENCH-MISS-%u", i);
+        } else {
+            snprintf(
+                name_text, sizeof(name_text), "BENCH-AV-%u",
+                object_count - 1 - (i % object_count));
+        }
+        characterstring_init_ansi(&object_name, name_text);
+        found = Device_Valid_Object_Name(&object_name, NULL, NULL);
+        if (found != !(i & 1)) {
+            fprintf(stderr, "object name lookup failed: %s\n", name_text);
+            exit(1);
+        }
+    }
+
+    return benchmark_usec(clock() - start, repeat);
+}
+
+/**
+ * @brief Benchmark Device_Valid_Object_Name() with and without the index
+ * @param max_objects - largest number of objects to benchmark
+ */
+static void benchmark_object_name(unsigned max_objects)
+{
+    char **names;
+    unsigned object_count = 0;
+    unsigned step;
+    unsigned i;
+    double linear_usec, index_usec;
+
+    names = calloc(max_objects, sizeof(char *));
+    if (!names) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    Device_Init(NULL);
+    printf("object-name: Device_Valid_Object_Name() usec/lookup\n");
+    printf("%10s %12s %12s\n", "objects", "linear", "index");
+    for (step = 100; step <= max_objects; step *= 10) {
+        for (i = object_count; i < step; i++) {
+            names[i] = calloc(1, 32);
+            if (!names[i]) {
+                fprintf(stderr, "out of memory\n");
+                exit(1);
+            }
+            snprintf(names[i], 32, "BENCH-AV-%u", i);
+            Analog_Value_Create(1000 + i);
+            Analog_Value_Name_Set(1000 + i, names[i]);
+        }
+        object_count = step;
+        Device_Object_Name_Index_Enable(false);
+        linear_usec =
+            benchmark_object_name_lookup(object_count, BENCHMARK_REPEAT);
+        Device_Object_Name_Index_Enable(true);
+        index_usec =
+            benchmark_object_name_lookup(object_count, BENCHMARK_REPEAT);
+        printf("%10u %12.3f %12.3f\n", object_count, linear_usec, index_usec);
+        if ((step < max_objects) && ((step * 10) > max_objects)) {
+            step = max_objects / 10;
+        }
+    }
+    Device_Object_Name_Index_Enable(false);
+}
+
+/**
+ * @brief Benchmark creating objects one at a time, and as a range
+ * @param count - number of objects to create
+ */
+static void benchmark_object_create(unsigned count)
+{
+    double single_usec, range_usec;
+    clock_t start;
+    unsigned i;
+
+    Analog_Value_Init();
+    printf("object-create: usec/object\n");
+    printf("%10s %12s %12s\n", "objects", "single", "range");
+    start = clock();
+    for (i = 0; i < count; i++) {
+        Analog_Value_Create(1000 + i);
+    }
+    single_usec = benchmark_usec(clock() - start, count);
+    Analog_Value_Cleanup();
+    Analog_Value_Init();
+    start = clock();
+    if (Analog_Value_Create_Range(1000, count) != count) {
+        fprintf(stderr, "object create range failed\n");
+        exit(1);
+    }
+    range_usec = benchmark_usec(clock() - start, count);
+    Analog_Value_Cleanup();
+    printf("%10u %12.3f %12.3f\n", count, single_usec, range_usec);
+}
+
+/**
+ * @brief Time a number of Object_List element lookups
+ * @param object_count - number of objects in the Object_List
+ * @param repeat - number of lookups
+ * @return average microseconds per lookup
+ */
+static double
+benchmark_object_list_lookup(unsigned object_count, unsigned repeat)
+{
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t instance;
+    unsigned i;
+    clock_t start;
+
+    start = clock();
+    for (i = 0; i < repeat; i++) {
+        /* spread the lookups over the whole list */
+        if (!Device_Object_List_Identifier(
+                1 + ((i * 7919U) % object_count), &object_type, &instance)) {
+            fprintf(stderr, "object list lookup failed: %u\n", i);
+            exit(1);
+        }
+    }
+
+    return benchmark_usec(clock() - start, repeat);
+}
+
+/**
+ * @brief Benchmark Device_Object_List_Identifier() with and without
+ *  the Object_List snapshot
+ * @param max_objects - largest number of objects to benchmark
+ */
+static void benchmark_object_list(unsigned max_objects)
+{
+    unsigned object_count = 0;
+    unsigned step;
+    double walk_usec, cache_usec;
+
+    Device_Init(NULL);
+    printf("object-list: Device_Object_List_Identifier() usec/lookup\n");
+    printf("%10s %12s %12s\n", "objects", "walk", "snapshot");
+    for (step = 100; step <= max_objects; step *= 10) {
+        (void)Analog_Value_Create_Range(
+            1000 + object_count, step - object_count);
+        object_count = step;
+        Device_Object_List_Cache_Enable(false);
+        walk_usec = benchmark_object_list_lookup(
+            Device_Object_List_Count(), BENCHMARK_REPEAT);
+        Device_Object_List_Cache_Enable(true);
+        cache_usec = benchmark_object_list_lookup(
+            Device_Object_List_Count(), BENCHMARK_REPEAT);
+        printf("%10u %12.3f %12.3f\n", object_count, walk_usec, cache_usec);
+        if ((step < max_objects) && ((step * 10) > max_objects)) {
+            step = max_objects / 10;
+        }
+    }
+    Device_Object_List_Cache_Enable(false);
+}
+
+#if defined(BAC_ROUTING)
+/**
+ * @brief Time a number of Who-Has requests for an object name
+ * @param name - the object name in the Who-Has request
+ * @param repeat - number of requests
+ * @return average microseconds per request
+ */
+static double benchmark_who_has_request(const char *name, unsigned repeat)
+{
+    BACNET_WHO_HAS_DATA data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t apdu[MAX_APDU];
+    int apdu_len;
+    unsigned i;
+    clock_t start;
+
+    data.low_limit = -1;
+    data.high_limit = -1;
+    data.is_object_name = true;
+    characterstring_init_ansi(&data.object.name, name);
+    apdu_len = bacnet_who_has_request_encode(apdu, &data);
+    start = clock();
+    for (i = 0; i < repeat; i++) {
+        handler_who_has_for_routing(apdu, apdu_len, &src);
+    }
+
+    return benchmark_usec(clock() - start, repeat);
+}
+
+/**
+ * @brief Benchmark the Who-Has handler of a gateway with MAX_NUM_DEVICES
+ *  routed devices, with and without the object name index
+ * @param object_count - number of analog value objects in each device
+ */
+static void benchmark_who_has(unsigned object_count)
+{
+    BACNET_CHARACTER_STRING name_string;
+    char device_name[32];
+    char object_name[32];
+    double usec[2][3];
+    unsigned i, repeat;
+
+    Device_Init(NULL);
+    Routing_Device_Init(Device_Object_Instance_Number());
+    for (i = 1; i < MAX_NUM_DEVICES; i++) {
+        snprintf(device_name, sizeof(device_name), "BENCH-DEV-%u", i);
+        characterstring_init_ansi(&name_string, device_name);
+        Add_Routed_Device(
+            Device_Object_Instance_Number() + i, &name_string, "Benchmark");
+    }
+    /* each routed device has its own objects */
+    for (i = 0; i < MAX_NUM_DEVICES; i++) {
+        Set_Routed_Device_Object_Index(i);
+        if (Analog_Value_Create_Range(1000, object_count) != object_count) {
+            fprintf(stderr, "object create range failed\n");
+            exit(1);
+        }
+    }
+    Set_Routed_Device_Object_Index(0);
+    /* the I-Have replies are not sent, so that only the handler is timed */
+    dcc_set_status_duration(COMMUNICATION_DISABLE, 0);
+    snprintf(
+        object_name, sizeof(object_name), "ANALOG VALUE %u",
+        1000 + object_count - 1);
+    /* fewer linear requests, since each reads every object name */
+    for (i = 0; i < 2; i++) {
+        Device_Object_Name_Index_Enable(i == 1);
+        repeat = i ? BENCHMARK_REPEAT : 10;
+        usec[i][0] = benchmark_who_has_request(device_name, repeat);
+        usec[i][1] = benchmark_who_has_request(object_name, repeat);
+        usec[i][2] = benchmark_who_has_request("BENCH-MISS", repeat);
+    }
+    Device_Object_Name_Index_Enable(false);
+    dcc_set_status_duration(COMMUNICATION_ENABLE, 0);
+    printf(
+        "who-has: %u devices, %u objects each, usec/request\n",
+        (unsigned)MAX_NUM_DEVICES, object_count);
+    printf("%10s %12s %12s %12s\n", "", "device", "object", "missing");
+    printf(
+        "%10s %12.3f %12.3f %12.3f\n", "linear", usec[0][0], usec[0][1],
+        usec[0][2]);
+    printf(
+        "%10s %12.3f %12.3f %12.3f\n", "index", usec[1][0], usec[1][1],
+        usec[1][2]);
+}
+#endif
+
+/**
+ * @brief Time a number of ReadRange requests of a trend log buffer
+ * @param request_type - RR_BY_TIME or RR_BY_SEQUENCE
+ * @param seconds - reference time for RR_BY_TIME
+ * @param sequence - reference sequence number for RR_BY_SEQUENCE
+ * @param count - number of records requested
+ * @param repeat - number of requests
+ * @return average microseconds per request
+ */
+static double benchmark_trend_log_request(
+    int request_type,
+    bacnet_time_t seconds,
+    uint32_t sequence,
+    int32_t count,
+    unsigned repeat)
+{
+    static uint8_t apdu[MAX_APDU];
+    BACNET_READ_RANGE_DATA request = { 0 };
+    clock_t start;
+    unsigned i;
+
+    start = clock();
+    for (i = 0; i < repeat; i++) {
+        memset(&request, 0, sizeof(request));
+        request.object_type = OBJECT_TRENDLOG;
+        request.object_instance = Trend_Log_Index_To_Instance(0);
+        request.object_property = PROP_LOG_BUFFER;
+        request.array_index = BACNET_ARRAY_ALL;
+        request.RequestType = request_type;
+        if (request_type == RR_BY_TIME) {
+            TL_Local_Time_To_BAC(&request.Range.RefTime, seconds);
+        } else {
+            request.Range.RefSeqNum = sequence;
+        }
+        request.Count = count;
+        bitstring_init(&request.ResultFlags);
+        if (rr_trend_log_encode(apdu, &request) <= 0) {
+            fprintf(stderr, "trend log read range failed\n");
+            exit(1);
+        }
+    }
+
+    return benchmark_usec(clock() - start, repeat);
+}
+
+/**
+ * @brief Benchmark ReadRange of a full trend log buffer, by time and by
+ *  sequence number, for the first and the last hour of the log
+ */
+static void benchmark_trend_log(void)
+{
+    BACNET_DATE_TIME bdatetime = { 0 };
+    bacnet_time_t first_time, last_time;
+    uint32_t instance, first_seq, last_seq;
+    /* each request is short, so more of them for the average */
+    unsigned repeat = BENCHMARK_REPEAT * 100;
+    double usec[2][2];
+
+    Device_Init(NULL);
+    Trend_Log_Init();
+    /* the first log holds a record every 15 minutes from January 2009 */
+    datetime_set_values(&bdatetime, 2009, 1, 1, 0, 0, 0, 0);
+    first_time = datetime_seconds_since_epoch(&bdatetime);
+    instance = Trend_Log_Index_To_Instance(0);
+    last_time = first_time + (900 * (Trend_Log_Record_Count(instance) - 1));
+    last_seq = Trend_Log_Total_Record_Count(instance);
+    first_seq = last_seq - Trend_Log_Record_Count(instance) + 1;
+    /* an hour of records after the reference */
+    usec[0][0] = benchmark_trend_log_request(
+        RR_BY_TIME, first_time, 0, 4, repeat);
+    usec[0][1] = benchmark_trend_log_request(
+        RR_BY_TIME, last_time - 3600, 0, 4, repeat);
+    usec[1][0] = benchmark_trend_log_request(
+        RR_BY_SEQUENCE, 0, first_seq, 4, repeat);
+    usec[1][1] = benchmark_trend_log_request(
+        RR_BY_SEQUENCE, 0, last_seq - 3, 4, repeat);
+    printf(
+        "trend-log: %u records, ReadRange of an hour usec/request\n",
+        (unsigned)Trend_Log_Record_Count(instance));
+    printf("%10s %12s %12s\n", "", "first-hour", "last-hour");
+    printf("%10s %12.3f %12.3f\n", "time", usec[0][0], usec[0][1]);
+    printf("%10s %12.3f %12.3f\n", "sequence", usec[1][0], usec[1][1]);
+}
+
+#if defined(BACDL_BIP)
+/**
+ * @brief Benchmark a BBMD forwarding a broadcast to foreign devices
+ * @param fd_count - number of foreign devices registered with the BBMD
+ */
+static void benchmark_bbmd_forward(unsigned fd_count)
+{
+    BACNET_IP_ADDRESS *fd_addr;
+    BACNET_ADDRESS src = { 0 };
+    /* Who-Is with a device instance range */
+    uint8_t npdu[] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF,
+                       0x10, 0x08, 0x09, 0x00, 0x19, 0x00 };
+    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
+    uint16_t mtu_len;
+    double register_usec, loop_usec, batch_usec, bbmd_usec;
+    unsigned i, r;
+    clock_t start;
+
+    fd_addr = calloc(fd_count, sizeof(BACNET_IP_ADDRESS));
+    if (!fd_addr) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    /* datagrams to the foreign devices are sent and dropped on loopback */
+    bip_set_port(47900);
+    if (!bip_init("lo")) {
+        fprintf(stderr, "BACnet/IP loopback interface failed\n");
+        exit(1);
+    }
+    bvlc_init();
+    if (!bvlc_fdt_size_set(fd_count)) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    start = clock();
+    for (i = 0; i < fd_count; i++) {
+        bvlc_address_set(&fd_addr[i], 127, 0, 0, 1);
+        fd_addr[i].port = 48000 + i;
+        mtu_len = bvlc_encode_register_foreign_device(mtu, sizeof(mtu), 600);
+        (void)bvlc_handler(&fd_addr[i], &src, mtu, mtu_len);
+    }
+    register_usec = benchmark_usec(clock() - start, fd_count);
+    mtu_len = bvlc_encode_forwarded_npdu(
+        mtu, sizeof(mtu), &fd_addr[0], npdu, sizeof(npdu));
+    printf("bbmd-forward: usec/foreign-device, distribute usec/broadcast\n");
+    printf(
+        "%10s %12s %12s %12s %12s\n", "devices", "register", "loop", "batch",
+        "distribute");
+    start = clock();
+    for (r = 0; r < BENCHMARK_REPEAT / 10; r++) {
+        for (i = 0; i < fd_count; i++) {
+            (void)bip_send_mpdu(&fd_addr[i], mtu, mtu_len);
+        }
+    }
+    loop_usec = benchmark_usec(clock() - start, fd_count * r);
+    start = clock();
+    for (r = 0; r < BENCHMARK_REPEAT / 10; r++) {
+        (void)bip_send_mpdu_multiple(fd_addr, fd_count, mtu, mtu_len);
+    }
+    batch_usec = benchmark_usec(clock() - start, fd_count * r);
+    /* the whole Distribute-Broadcast-To-Network from a foreign device */
+    mtu_len = bvlc_encode_distribute_broadcast_to_network(
+        mtu, sizeof(mtu), npdu, sizeof(npdu));
+    start = clock();
+    for (r = 0; r < BENCHMARK_REPEAT / 10; r++) {
+        /* a different range each time, so that the BBMD does not drop
+           the broadcast as a duplicate */
+        mtu[4 + 9] = (uint8_t)r;
+        mtu[4 + 11] = (uint8_t)r;
+        (void)bvlc_handler(&fd_addr[0], &src, mtu, mtu_len);
+    }
+    bbmd_usec = benchmark_usec(clock() - start, r);
+    printf(
+        "%10u %12.3f %12.3f %12.3f %12.3f\n", fd_count, register_usec,
+        loop_usec, batch_usec, bbmd_usec);
+    (void)bvlc_fdt_size_set(0);
+    bip_cleanup();
+    free(fd_addr);
+}
+#endif
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [object-name [max-objects]]\n", filename);
+    printf("       [object-create [count]]\n");
+    printf("       [object-list [max-objects]]\n");
+    printf("       [who-has [objects]]\n");
+    printf("       [trend-log]\n");
+    printf("       [bbmd-forward [foreign-devices]]\n");
+    printf("       [codec [iterations] [--json]]\n");
+    printf("       [--help][--version]\n");
+}
+
+static void print_help(const char *filename)
+{
+    printf("Benchmarks for BACnet stack hot paths.\n");
+    printf("object-name [max-objects]:\n"
+           "Time Device_Valid_Object_Name() with and without the\n"
+           "object name index, from 100 to max-objects (default 20000).\n");
+    printf("object-create [count]:\n"
+           "Time creating count objects (default 30000) one at a time,\n"
+           "and all at once with Analog_Value_Create_Range().\n");
+    printf("object-list [max-objects]:\n"
+           "Time Device_Object_List_Identifier() with and without the\n"
+           "Object_List snapshot, from 100 to max-objects (default 50000).\n");
+    printf("who-has [objects]:\n"
+           "Time Who-Has requests to a gateway with MAX_NUM_DEVICES\n"
+           "routed devices, each with objects (default 1000), with and\n"
+           "without the object name index.\n");
+    printf("trend-log:\n"
+           "Time ReadRange by time and by sequence number of an hour\n"
+           "of records at the start and end of a full trend log.\n");
+    printf("bbmd-forward [foreign-devices]:\n"
+           "Time a BBMD registering foreign-devices (default 128),\n"
+           "and forwarding a broadcast to them on the loopback\n"
+           "interface.\n");
+    printf("codec [iterations] [--json]:\n"
+           "Time encoding and decoding tags, application data,\n"
+           "ReadPropertyMultiple-ACK, and character strings, and the\n"
+           "MS/TP CRCs, each for iterations (default 1000000) calls.\n"
+           "--json prints the results as one JSON object.\n");
+    (void)filename;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *benchmark = "object-name";
+    unsigned long max_objects = 20000;
+    const char *filename;
+
+    filename = argv[0];
+    if (argc > 1) {
+        if (strcmp(argv[1], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[1], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            return 0;
+        }
+        benchmark = argv[1];
+    }
+    if (strcmp(benchmark, "object-name") == 0) {
+        if (argc > 2) {
+            max_objects = strtoul(argv[2], NULL, 0);
+        }
+        if ((max_objects < 100) || (max_objects > BACNET_MAX_INSTANCE)) {
+            max_objects = 100;
+        }
+        benchmark_object_name((unsigned)max_objects);
+    } else if (strcmp(benchmark, "object-create") == 0) {
+        max_objects = 30000;
+        if (argc > 2) {
+            max_objects = strtoul(argv[2], NULL, 0);
+        }
+        if ((max_objects < 1) || (max_objects > (BACNET_MAX_INSTANCE - 1000))) {
+            max_objects = 1;
+        }
+        benchmark_object_create((unsigned)max_objects);
+    } else if (strcmp(benchmark, "object-list") == 0) {
+        max_objects = 50000;
+        if (argc > 2) {
+            max_objects = strtoul(argv[2], NULL, 0);
+        }
+        if ((max_objects < 100) ||
+            (max_objects > (BACNET_MAX_INSTANCE - 1000))) {
+            max_objects = 100;
+        }
+        benchmark_object_list((unsigned)max_objects);
+#if defined(BAC_ROUTING)
+    } else if (strcmp(benchmark, "who-has") == 0) {
+        max_objects = 1000;
+        if (argc > 2) {
+            max_objects = strtoul(argv[2], NULL, 0);
+        }
+        if ((max_objects < 1) ||
+            (max_objects > (BACNET_MAX_INSTANCE - 1000))) {
+            max_objects = 1;
+        }
+        benchmark_who_has((unsigned)max_objects);
+#endif
+    } else if (strcmp(benchmark, "trend-log") == 0) {
+        benchmark_trend_log();
+#if defined(BACDL_BIP)
+    } else if (strcmp(benchmark, "bbmd-forward") == 0) {
+        max_objects = 128;
+        if (argc > 2) {
+            max_objects = strtoul(argv[2], NULL, 0);
+        }
+        if ((max_objects < 1) || (max_objects > 10000)) {
+            max_objects = 1;
+        }
+        benchmark_bbmd_forward((unsigned)max_objects);
+#endif
+    } else if (strcmp(benchmark, "codec") == 0) {
+        bool json = false;
+        int argi;
+
+        max_objects = 1000000;
+        for (argi = 2; argi < argc; argi++) {
+            if (strcmp(argv[argi], "--json") == 0) {
+                json = true;
+            } else {
+                max_objects = strtoul(argv[argi], NULL, 0);
+            }
+        }
+        if (max_objects < 1) {
+            max_objects = 1;
+        }
+        benchmark_codec(max_objects, json);
+    } else {
+        print_usage(filename);
+        return 1;
+    }
+
+    return 0;
+}
@@ -184,7 +184,7 @@ static void Color_Temperature_Write_Value_Handler(
         index = object_instance - 1;
     }
     if (index < blinkt_led_count()) {
-        color_rgb_from_temperature(value, &red, &green, &blue);
+        color_rgb_from_temperature_fast(value, &red, &green, &blue);
         blinkt_set_pixel(index, red, green, blue);
         printf(
             "%u Kelvin RGB[%u]=%u,%u,%u\n", (unsigned)value, (unsigned)index,
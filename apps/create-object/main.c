@@ -591,13 +591,15 @@ int main(int argc, char *argv[])
                 Request_Invoke_ID = Send_Create_Object_Request_Data(
                     Target_Device_Object_Instance, Target_Object_Type,
                     Target_Object_Instance, Target_Initial_Values);
-            } else if (tsm_invoke_id_free(Request_Invoke_ID)) {
+            } else if (tsm_invoke_id_free_peer(
+                           &Target_Address, Request_Invoke_ID)) {
                 break;
-            } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
+            } else if (tsm_invoke_id_failed_peer(
+                           &Target_Address, Request_Invoke_ID)) {
                 MyPrintHandler(
                     Target_Object_Type, Target_Object_Instance,
                     ERROR_CLASS_COMMUNICATION, ERROR_CODE_ABORT_TSM_TIMEOUT, 0);
-                tsm_free_invoke_id(Request_Invoke_ID);
+                tsm_free_invoke_id_peer(&Target_Address, Request_Invoke_ID);
                 Error_Detected = true;
                 /* abort */
                 break;
@@ -328,11 +328,11 @@ int main(int argc, char *argv[])
                     Target_Device_Object_Instance,
                     Communication_Timeout_Minutes, Communication_State,
                     Communication_Password);
-            } else if (tsm_invoke_id_free(invoke_id)) {
+            } else if (tsm_invoke_id_free_peer(&Target_Address, invoke_id)) {
                 break;
-            } else if (tsm_invoke_id_failed(invoke_id)) {
+            } else if (tsm_invoke_id_failed_peer(&Target_Address, invoke_id)) {
                 fprintf(stderr, "\rError: TSM Timeout!\n");
-                tsm_free_invoke_id(invoke_id);
+                tsm_free_invoke_id_peer(&Target_Address, invoke_id);
                 /* try again or abort? */
                 break;
             }
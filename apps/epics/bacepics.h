@@ -21,8 +21,9 @@
  * each of those Objects.
  *
  * Usage:
- *  bacepics [-v] [-p sport] [-t target_mac] device-instance
+ *  bacepics [-v] [-w window] [-p sport] [-t target_mac] device-instance
  *    -v: show values instead of '?'
+ *    -w: number of Objects read at the same time with RPM ALL (default 4)
  *    -p: Use sport for "my" port, instead of 0xBAC0 (BACnet/IP only)
  *        Allows you to communicate with a localhost target.
  *    -t: declare target's MAC instead of using Who-Is to bind to
@@ -59,6 +60,9 @@
  * The Device Object will have fetched the Object List property and built a list
  * of objects from that; use it now to cycle through each other Object and
  * repeat the above process to get and print out their property values.
+ * - A long Object List is walked with RPM, many elements per request
+ * - While one Object prints, the next few Objects are already requested
+ *   with RPM ALL (-w sets how many), and printed in Object List order
  */
 
 /** The allowed States of the bacepics State Machine.
@@ -98,6 +98,22 @@ typedef struct BACnet_RPM_Service_Data_t {
 } BACNET_RPM_SERVICE_DATA;
 static BACNET_RPM_SERVICE_DATA Read_Property_Multiple_Data;
 
+/* RPM ALL requests sent ahead for the next objects of the Object_List,
+ * so that a few objects are in flight while the current one prints */
+#define MAX_PREFETCH 16
+typedef struct BACnet_RPM_Prefetch_t {
+    bool in_use;
+    bool failed;
+    uint8_t invoke_id;
+    BACNET_OBJECT_ID object;
+    BACNET_READ_ACCESS_DATA *rpm_data;
+} BACNET_RPM_PREFETCH;
+static BACNET_RPM_PREFETCH Prefetch_List[MAX_PREFETCH];
+/* number of objects read at the same time, including the current one */
+static unsigned Prefetch_Window = 4;
+/* index of the next Object_List entry to read ahead */
+static int32_t Prefetch_Index = 0;
+
 /* We get the length of the object list,
    and then get the objects one at a time */
 static uint32_t Object_List_Length = 0;
@@ -153,6 +169,11 @@ static bool Using_Walked_List = false;
 /* When requesting RP for BACNET_ARRAY_ALL of what we know can be a long
  * array, then set this true in case it aborts and we need Using_Walked_List */
 static bool IsLongArray = false;
+/* Number of Object_List elements read per RPM while walking the list */
+#define MAX_WALKED_LIST_BATCH 32
+static uint32_t Walked_List_Batch = 1;
+/* True if the request in flight reads several walked list elements */
+static bool Walked_List_Batched = false;
 /* Show value instead of '?' */
 static bool ShowValues = false;
 /* show only device object properties */
@@ -164,6 +185,80 @@ static bool Optional_Properties = false;
 #define PRINT_ERRORS 1
 #endif
 
+/** Find the read ahead request of an invoke ID
+ * @param invoke_id [in] The invoke ID of the request
+ * @return The read ahead request, or NULL if not found
+ */
+static BACNET_RPM_PREFETCH *Prefetch_Find_Invoke_ID(uint8_t invoke_id)
+{
+    unsigned i;
+
+    if (invoke_id == 0) {
+        return NULL;
+    }
+    for (i = 0; i < MAX_PREFETCH; i++) {
+        if (Prefetch_List[i].in_use &&
+            (Prefetch_List[i].invoke_id == invoke_id)) {
+            return &Prefetch_List[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** Find the read ahead request of an object
+ * @param pObject [in] The object type and instance
+ * @return The read ahead request, or NULL if not found
+ */
+static BACNET_RPM_PREFETCH *
+Prefetch_Find_Object(const BACNET_OBJECT_ID *pObject)
+{
+    unsigned i;
+
+    for (i = 0; i < MAX_PREFETCH; i++) {
+        if (Prefetch_List[i].in_use &&
+            (Prefetch_List[i].object.type == pObject->type) &&
+            (Prefetch_List[i].object.instance == pObject->instance)) {
+            return &Prefetch_List[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** Release a read ahead request and any data it got
+ * @param prefetch [in] The read ahead request
+ */
+static void Prefetch_Free(BACNET_RPM_PREFETCH *prefetch)
+{
+    while (prefetch->rpm_data) {
+        prefetch->rpm_data = rpm_data_free(prefetch->rpm_data);
+    }
+    prefetch->in_use = false;
+    prefetch->failed = false;
+    prefetch->invoke_id = 0;
+}
+
+/** Mark a read ahead request as failed when the device answered with
+ *  an error, reject or abort.  The object is read again when its turn
+ *  comes, which takes the usual fallback paths.
+ * @param src [in] The address the answer came from
+ * @param invoke_id [in] The invoke ID of the answer
+ */
+static void Prefetch_Failed(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    BACNET_RPM_PREFETCH *prefetch;
+
+    if (!address_match(&Target_Address, src)) {
+        return;
+    }
+    prefetch = Prefetch_Find_Invoke_ID(invoke_id);
+    if (prefetch) {
+        prefetch->failed = true;
+        prefetch->invoke_id = 0;
+    }
+}
+
 static void MyErrorHandler(
     BACNET_ADDRESS *src,
     uint8_t invoke_id,
@@ -183,6 +278,8 @@ static void MyErrorHandler(
         Error_Detected = true;
         Last_Error_Class = error_class;
         Last_Error_Code = error_code;
+    } else {
+        Prefetch_Failed(src, invoke_id);
     }
 }
 
@@ -203,6 +300,8 @@ static void MyAbortHandler(
         Error_Detected = true;
         Last_Error_Class = ERROR_CLASS_SERVICES;
         Last_Error_Code = abort_convert_to_error_code(abort_reason);
+    } else {
+        Prefetch_Failed(src, invoke_id);
     }
 }
 
@@ -226,6 +325,8 @@ MyRejectHandler(BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
         } else {
             Last_Error_Code = ERROR_CODE_REJECT_OTHER;
         }
+    } else {
+        Prefetch_Failed(src, invoke_id);
     }
 }
 
@@ -268,9 +369,29 @@ static void MyReadPropertyMultipleAckHandler(
 {
     int len = 0;
     BACNET_READ_ACCESS_DATA *rpm_data;
+    BACNET_RPM_PREFETCH *prefetch;
 
-    if (address_match(&Target_Address, src) &&
-        (service_data->invoke_id == Request_Invoke_ID)) {
+    if (!address_match(&Target_Address, src)) {
+        return;
+    }
+    prefetch = Prefetch_Find_Invoke_ID(service_data->invoke_id);
+    if (prefetch && (service_data->invoke_id != Request_Invoke_ID)) {
+        /* keep the object read ahead until it is its turn to print */
+        rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+        if (rpm_data) {
+            len = rpm_ack_decode_service_request(
+                service_request, service_len, rpm_data);
+        }
+        if (len > 0) {
+            prefetch->rpm_data = rpm_data;
+        } else {
+            while (rpm_data) {
+                rpm_data = rpm_data_free(rpm_data);
+            }
+            prefetch->failed = true;
+        }
+        prefetch->invoke_id = 0;
+    } else if (service_data->invoke_id == Request_Invoke_ID) {
         rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
         if (rpm_data) {
             len = rpm_ack_decode_service_request(
@@ -327,6 +448,8 @@ static void Init_Service_Handlers(void)
         SERVICE_CONFIRMED_READ_PROP_MULTIPLE, MyReadPropertyMultipleAckHandler);
     /* handle any errors coming back */
     apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, MyErrorHandler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, MyErrorHandler);
     apdu_set_abort_handler(MyAbortHandler);
     apdu_set_reject_handler(MyRejectHandler);
 }
@@ -713,6 +836,45 @@ static void BuildPropRequest(BACNET_READ_ACCESS_DATA *rpm_object)
     }
 }
 
+/** Send an RPM request to read the next few elements of a walked
+ * Object_List, as many as fit in one reply of the device.
+ *
+ * @param device_instance [in] Our target device's instance.
+ * @param pMyObject [in] The current Object's type and instance numbers.
+ * @param prop [in] The walked property.
+ * @return The invokeID of the message sent, or 0 on failure.
+ */
+static uint8_t Read_Walked_List_Batch(
+    uint32_t device_instance, const BACNET_OBJECT_ID *pMyObject, int prop)
+{
+    BACNET_READ_ACCESS_DATA rpm_object = { 0 };
+    BACNET_PROPERTY_REFERENCE rpm_property[MAX_WALKED_LIST_BATCH] = { 0 };
+    uint8_t buffer[MAX_PDU] = { 0 };
+    uint32_t array_index = Walked_List_Index;
+    uint8_t invoke_id = 0;
+    unsigned i = 0;
+
+    rpm_object.object_type = pMyObject->type;
+    rpm_object.object_instance = pMyObject->instance;
+    rpm_object.listOfProperties = &rpm_property[0];
+    while ((i < Walked_List_Batch) && (array_index <= Walked_List_Length)) {
+        rpm_property[i].propertyIdentifier = prop;
+        rpm_property[i].propertyArrayIndex = array_index;
+        if (i > 0) {
+            rpm_property[i - 1].next = &rpm_property[i];
+        }
+        array_index++;
+        i++;
+    }
+    invoke_id = Send_Read_Property_Multiple_Request(
+        buffer, sizeof(buffer), device_instance, &rpm_object);
+    if (invoke_id > 0) {
+        Walked_List_Batched = true;
+    }
+
+    return invoke_id;
+}
+
 /** Send an RP request to read one property from the current Object.
  * Singly process large arrays too, like the Device Object's Object_List.
  * If GET_LIST_OF_ALL_RESPONSE failed, we will fall back to using just
@@ -789,9 +951,19 @@ Read_Properties(uint32_t device_instance, const BACNET_OBJECT_ID *pMyObject)
                     break;
             }
         }
-        invoke_id = Send_Read_Property_Request(
-            device_instance, pMyObject->type, pMyObject->instance, prop,
-            array_index);
+        Walked_List_Batched = false;
+        if (Using_Walked_List && (array_index > 0) && Has_RPM &&
+            (Walked_List_Batch > 1) &&
+            ((prop == PROP_OBJECT_LIST) ||
+             (prop == PROP_STRUCTURED_OBJECT_LIST))) {
+            /* object identifiers are small, so read many per request */
+            invoke_id =
+                Read_Walked_List_Batch(device_instance, pMyObject, prop);
+        } else {
+            invoke_id = Send_Read_Property_Request(
+                device_instance, pMyObject->type, pMyObject->instance, prop,
+                array_index);
+        }
     }
 
     return invoke_id;
@@ -903,7 +1075,7 @@ ProcessRPMData(BACNET_READ_ACCESS_DATA *rpm_data, EPICS_STATES state)
 static void print_usage(const char *filename)
 {
     printf(
-        "Usage: %s [-v] [-d] [-p sport] [-t target_mac [-n dnet]]"
+        "Usage: %s [-v] [-d] [-w window] [-p sport] [-t target_mac [-n dnet]]"
         " device-instance\n",
         filename);
     printf("       [--version][--help]\n");
@@ -922,6 +1094,8 @@ static void print_help(const char *filename)
     printf("-v: show values instead of '?' \n");
     printf("-c: columns break for BACnetARRAY. Default is 0=always\n");
     printf("-d: show only device object properties\n");
+    printf("-w: number of objects read at the same time with RPM ALL.\n");
+    printf("    Default is 4. Use 1 to read one object at a time.\n");
     printf("-p: Use sport for \"my\" port.  0xBAC0 is default.\n");
     printf("    Allows you to communicate with a localhost target.\n");
     printf("-t: declare target's MAC instead of using Who-Is to bind to  \n");
@@ -981,6 +1155,16 @@ static int CheckCommandLineArgs(int argc, char *argv[])
                 case 'd':
                     ShowDeviceObjectOnly = true;
                     break;
+                case 'w':
+                    if (++i < argc) {
+                        Prefetch_Window = strtol(argv[i], NULL, 0);
+                        if (Prefetch_Window < 1) {
+                            Prefetch_Window = 1;
+                        } else if (Prefetch_Window > MAX_PREFETCH) {
+                            Prefetch_Window = MAX_PREFETCH;
+                        }
+                    }
+                    break;
                 case 'p':
                     if (++i < argc) {
 #if defined(BACDL_BIP)
@@ -1297,6 +1481,82 @@ static void PrintHeading(void)
     printf("}\n\n");
 }
 
+/** Read ahead the next objects of the Object_List with RPM ALL,
+ * keeping up to Prefetch_Window objects in flight, and notice
+ * read ahead requests the device never answered.
+ *
+ * @param buffer [in] The buffer used to encode the requests.
+ * @param buffer_size [in] The size of the buffer.
+ */
+static void Prefetch_Task(uint8_t *buffer, size_t buffer_size)
+{
+    BACNET_READ_ACCESS_DATA rpm_object = { 0 };
+    BACNET_PROPERTY_REFERENCE rpm_property = { 0 };
+    BACNET_RPM_PREFETCH *prefetch = NULL;
+    unsigned count = 0;
+    unsigned i = 0;
+    KEY key;
+
+    for (i = 0; i < MAX_PREFETCH; i++) {
+        prefetch = &Prefetch_List[i];
+        if (!prefetch->in_use) {
+            continue;
+        }
+        if (prefetch->invoke_id > 0) {
+            if (tsm_invoke_id_failed_peer(
+                    &Target_Address, prefetch->invoke_id)) {
+                tsm_free_invoke_id_peer(&Target_Address, prefetch->invoke_id);
+                prefetch->failed = true;
+                prefetch->invoke_id = 0;
+            } else if (tsm_invoke_id_free_peer(
+                           &Target_Address, prefetch->invoke_id)) {
+                /* answered with something we did not keep */
+                prefetch->failed = true;
+                prefetch->invoke_id = 0;
+            }
+        }
+        count++;
+    }
+    if (Prefetch_Index <= Object_List_Index) {
+        Prefetch_Index = Object_List_Index + 1;
+    }
+    rpm_object.listOfProperties = &rpm_property;
+    rpm_property.propertyIdentifier = PROP_ALL;
+    rpm_property.propertyArrayIndex = BACNET_ARRAY_ALL;
+    while (((count + 1) < Prefetch_Window) &&
+           (Prefetch_Index < Keylist_Count(Object_List))) {
+        if (!Keylist_Index_Key(Object_List, Prefetch_Index, &key) ||
+            (KEY_DECODE_TYPE(key) == OBJECT_DEVICE)) {
+            Prefetch_Index++;
+            continue;
+        }
+        for (i = 0; i < MAX_PREFETCH; i++) {
+            if (!Prefetch_List[i].in_use) {
+                break;
+            }
+        }
+        if (i >= MAX_PREFETCH) {
+            break;
+        }
+        prefetch = &Prefetch_List[i];
+        rpm_object.object_type = KEY_DECODE_TYPE(key);
+        rpm_object.object_instance = KEY_DECODE_ID(key);
+        prefetch->invoke_id = Send_Read_Property_Multiple_Request(
+            buffer, buffer_size, Target_Device_Object_Instance, &rpm_object);
+        if (prefetch->invoke_id == 0) {
+            /* no free transaction; try again later */
+            break;
+        }
+        prefetch->in_use = true;
+        prefetch->failed = false;
+        prefetch->object.type = rpm_object.object_type;
+        prefetch->object.instance = rpm_object.object_instance;
+        prefetch->rpm_data = NULL;
+        Prefetch_Index++;
+        count++;
+    }
+}
+
 static void Print_Device_Heading(void)
 {
     printf("List of Objects in Test Device:\n");
@@ -1349,6 +1609,10 @@ int main(int argc, char *argv[])
     BACNET_OBJECT_ID myObject;
     uint8_t buffer[MAX_PDU] = { 0 };
     BACNET_READ_ACCESS_DATA *rpm_object = NULL;
+    BACNET_READ_ACCESS_DATA *rp_data = NULL;
+    BACNET_PROPERTY_REFERENCE *rpm_property = NULL;
+    BACNET_RPM_PREFETCH *prefetch = NULL;
+    unsigned i = 0;
     KEY nextKey;
 
     CheckCommandLineArgs(argc, argv); /* Won't return if there is an issue. */
@@ -1460,6 +1724,16 @@ int main(int argc, char *argv[])
                 } else {
                     rpm_object = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
                     assert(rpm_object);
+                    /* An Object_List element takes less than 16 octets
+                       in an RPM reply, which fits both APDU sizes */
+                    if (max_apdu > MAX_APDU) {
+                        max_apdu = MAX_APDU;
+                    }
+                    Walked_List_Batch = (max_apdu > 32) ? (max_apdu - 16) / 16
+                                                        : 1;
+                    if (Walked_List_Batch > MAX_WALKED_LIST_BATCH) {
+                        Walked_List_Batch = MAX_WALKED_LIST_BATCH;
+                    }
                     myState = GET_HEADING_INFO;
                 }
                 break;
@@ -1496,16 +1770,42 @@ int main(int argc, char *argv[])
                 /* Update times; aids single-step debugging */
                 last_seconds = current_seconds;
                 StartNextObject(rpm_object, &myObject);
-
-                Request_Invoke_ID = Send_Read_Property_Multiple_Request(
-                    buffer, MAX_PDU, Target_Device_Object_Instance, rpm_object);
-                if (Request_Invoke_ID > 0) {
+                prefetch = NULL;
+                if (myState == GET_ALL_REQUEST) {
+                    prefetch = Prefetch_Find_Object(&myObject);
+                }
+                if (prefetch && prefetch->rpm_data) {
+                    /* This Object was already read ahead */
+                    myState =
+                        ProcessRPMData(prefetch->rpm_data, GET_ALL_RESPONSE);
+                    prefetch->rpm_data = NULL;
+                    Prefetch_Free(prefetch);
                     elapsed_seconds = 0;
-                    if (myState == GET_LIST_OF_ALL_REQUEST) {
-                        myState = GET_LIST_OF_ALL_RESPONSE;
-                    } else {
-                        myState = GET_ALL_RESPONSE;
+                } else if (prefetch && (prefetch->invoke_id > 0)) {
+                    /* The read ahead is still in flight; wait for it */
+                    Request_Invoke_ID = prefetch->invoke_id;
+                    Prefetch_Free(prefetch);
+                    elapsed_seconds = 0;
+                    myState = GET_ALL_RESPONSE;
+                } else {
+                    if (prefetch) {
+                        /* The read ahead failed; ask again and fall back */
+                        Prefetch_Free(prefetch);
                     }
+                    Request_Invoke_ID = Send_Read_Property_Multiple_Request(
+                        buffer, MAX_PDU, Target_Device_Object_Instance,
+                        rpm_object);
+                    if (Request_Invoke_ID > 0) {
+                        elapsed_seconds = 0;
+                        if (myState == GET_LIST_OF_ALL_REQUEST) {
+                            myState = GET_LIST_OF_ALL_RESPONSE;
+                        } else {
+                            myState = GET_ALL_RESPONSE;
+                        }
+                    }
+                }
+                if (myObject.type != OBJECT_DEVICE) {
+                    Prefetch_Task(buffer, sizeof(buffer));
                 }
                 break;
 
@@ -1526,14 +1826,16 @@ int main(int argc, char *argv[])
                     Read_Property_Multiple_Data.new_data = false;
                     myState = ProcessRPMData(
                         Read_Property_Multiple_Data.rpm_data, myState);
-                    if (tsm_invoke_id_free(Request_Invoke_ID)) {
+                    if (tsm_invoke_id_free_peer(
+                            &Target_Address, Request_Invoke_ID)) {
                         Request_Invoke_ID = 0;
                     } else {
                         assert(false); /* How can this be? */
                         Request_Invoke_ID = 0;
                     }
                     elapsed_seconds = 0;
-                } else if (tsm_invoke_id_free(Request_Invoke_ID)) {
+                } else if (tsm_invoke_id_free_peer(
+                               &Target_Address, Request_Invoke_ID)) {
                     elapsed_seconds = 0;
                     Request_Invoke_ID = 0;
                     if (myState == GET_HEADING_RESPONSE) {
@@ -1564,9 +1866,10 @@ int main(int argc, char *argv[])
                     } else {
                         myState = GET_PROPERTY_REQUEST;
                     }
-                } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
+                } else if (tsm_invoke_id_failed_peer(
+                               &Target_Address, Request_Invoke_ID)) {
                     fprintf(stderr, "\rError: TSM Timeout!\n");
-                    tsm_free_invoke_id(Request_Invoke_ID);
+                    tsm_free_invoke_id_peer(&Target_Address, Request_Invoke_ID);
                     Request_Invoke_ID = 0;
                     elapsed_seconds = 0;
                     if (myState == GET_HEADING_RESPONSE) {
@@ -1620,34 +1923,52 @@ int main(int argc, char *argv[])
                     (Request_Invoke_ID ==
                      Read_Property_Multiple_Data.service_data.invoke_id)) {
                     Read_Property_Multiple_Data.new_data = false;
-                    PrintReadPropertyData(
-                        Read_Property_Multiple_Data.rpm_data->object_type,
-                        Read_Property_Multiple_Data.rpm_data->object_instance,
-                        Read_Property_Multiple_Data.rpm_data->listOfProperties);
-                    if (tsm_invoke_id_free(Request_Invoke_ID)) {
+                    rp_data = Read_Property_Multiple_Data.rpm_data;
+                    /* One value for RP, or a batch of walked list
+                       elements for RPM */
+                    rpm_property = rp_data->listOfProperties;
+                    while (rpm_property) {
+                        PrintReadPropertyData(
+                            rp_data->object_type, rp_data->object_instance,
+                            rpm_property);
+                        /* the values were freed while printing */
+                        rpm_property->value = NULL;
+                        rpm_property = rpm_property->next;
+                        /* Advance the property (or Array List) index */
+                        if (Using_Walked_List) {
+                            Walked_List_Index++;
+                            if (Walked_List_Index > Walked_List_Length) {
+                                /* go on to next property */
+                                Property_List_Index++;
+                                Using_Walked_List = false;
+                                break;
+                            }
+                        } else {
+                            Property_List_Index++;
+                        }
+                    }
+                    while (rp_data) {
+                        rp_data = rpm_data_free(rp_data);
+                    }
+                    Read_Property_Multiple_Data.rpm_data = NULL;
+                    if (tsm_invoke_id_free_peer(
+                            &Target_Address, Request_Invoke_ID)) {
                         Request_Invoke_ID = 0;
                     } else {
                         assert(false); /* How can this be? */
                         Request_Invoke_ID = 0;
                     }
                     elapsed_seconds = 0;
-                    /* Advance the property (or Array List) index */
-                    if (Using_Walked_List) {
-                        Walked_List_Index++;
-                        if (Walked_List_Index > Walked_List_Length) {
-                            /* go on to next property */
-                            Property_List_Index++;
-                            Using_Walked_List = false;
-                        }
-                    } else {
-                        Property_List_Index++;
-                    }
                     myState = GET_PROPERTY_REQUEST; /* Go fetch next Property */
-                } else if (tsm_invoke_id_free(Request_Invoke_ID)) {
+                } else if (tsm_invoke_id_free_peer(
+                               &Target_Address, Request_Invoke_ID)) {
                     Request_Invoke_ID = 0;
                     elapsed_seconds = 0;
                     myState = GET_PROPERTY_REQUEST;
-                    if (Error_Detected) {
+                    if (Error_Detected && Walked_List_Batched) {
+                        /* Retry the same elements one at a time */
+                        Walked_List_Batch = 1;
+                    } else if (Error_Detected) {
                         if ((Last_Error_Class != ERROR_CLASS_PROPERTY) &&
                             (Last_Error_Code != ERROR_CODE_UNKNOWN_PROPERTY)) {
                             if (IsLongArray) {
@@ -1680,9 +2001,10 @@ int main(int argc, char *argv[])
                             }
                         }
                     }
-                } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
+                } else if (tsm_invoke_id_failed_peer(
+                               &Target_Address, Request_Invoke_ID)) {
                     fprintf(stderr, "\rError: TSM Timeout!\n");
-                    tsm_free_invoke_id(Request_Invoke_ID);
+                    tsm_free_invoke_id_peer(&Target_Address, Request_Invoke_ID);
                     elapsed_seconds = 0;
                     Request_Invoke_ID = 0;
                     myState = 3; /* Let's try again, same Property */
@@ -1773,6 +2095,9 @@ int main(int argc, char *argv[])
         }
 
     } while (myObject.type < MAX_BACNET_OBJECT_TYPE);
+    for (i = 0; i < MAX_PREFETCH; i++) {
+        Prefetch_Free(&Prefetch_List[i]);
+    }
 
     if (Error_Count > 0) {
         fprintf(stdout, "\r-- Found %d Errors \n", Error_Count);
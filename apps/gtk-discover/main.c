@@ -28,6 +28,7 @@
 #include "bacnet/whois.h"
 #include "bacnet/basic/binding/address.h"
 #include "bacnet/basic/client/bac-discover.h"
+#include "bacnet/basic/client/bac-rw.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/filename.h"
@@ -59,6 +60,39 @@ static struct mstimer BACnet_TSM_Timer;
 static bool bacnet_initialized = false;
 static guint bacnet_timeout_id = 0;
 
+/* The device list is kept up to date in the background, a few devices
+   at a time, and the object list of a device is filled in batches, so
+   that the window stays responsive on a large network. */
+#ifndef DEVICE_SYNC_MILLISECONDS
+#define DEVICE_SYNC_MILLISECONDS 100
+#endif
+#ifndef DEVICE_ROWS_PER_SYNC
+#define DEVICE_ROWS_PER_SYNC 64
+#endif
+#ifndef OBJECT_ROWS_PER_IDLE
+#define OBJECT_ROWS_PER_IDLE 200
+#endif
+/* device ID to the GtkTreeIter of its row in the device store */
+static GHashTable *device_rows;
+/* index of the next device of the discovery to look at */
+static unsigned int device_sync_index;
+static guint device_sync_id;
+/* the device whose objects are being added to the object store */
+static uint32_t object_fill_device;
+static unsigned int object_fill_index;
+static guint object_fill_id;
+/* the object whose properties are in the property store */
+static uint32_t property_device_id;
+static BACNET_OBJECT_TYPE property_object_type;
+static uint32_t property_object_instance;
+/* property values that were not in the discovery, read on demand */
+struct property_cache_entry {
+    bool pending;
+    int tag;
+    GString *text;
+};
+static GHashTable *property_cache;
+
 /* Tree store columns */
 enum {
     DEVICE_COL_ID,
@@ -178,12 +212,32 @@ static void add_discovered_device_to_gui(
 {
     GtkTreeIter iter;
     char address_str[64] = "MAC-Address";
+    gchar *name = NULL, *model = NULL, *address_text = NULL;
+    GtkTreeIter *row;
 
     /* Fill device structure */
     /* Create address string */
     if (address) {
         bacapp_snprintf_address(address_str, sizeof(address_str), address);
     }
+    row = g_hash_table_lookup(device_rows, GUINT_TO_POINTER(device_id));
+    if (row) {
+        /* only touch the row when the device has changed */
+        gtk_tree_model_get(
+            GTK_TREE_MODEL(device_store), row, DEVICE_COL_NAME, &name,
+            DEVICE_COL_MODEL, &model, DEVICE_COL_ADDRESS, &address_text, -1);
+        if (g_strcmp0(name, device_name) || g_strcmp0(model, device_model) ||
+            g_strcmp0(address_text, address_str)) {
+            gtk_list_store_set(
+                device_store, row, DEVICE_COL_NAME, device_name,
+                DEVICE_COL_MODEL, device_model, DEVICE_COL_ADDRESS,
+                address_str, -1);
+        }
+        g_free(name);
+        g_free(model);
+        g_free(address_text);
+        return;
+    }
     printf("%lu|%s|%s\n", (unsigned long)device_id, device_name, address_str);
     /* Add to GUI */
     gtk_list_store_append(device_store, &iter);
@@ -191,22 +245,31 @@ static void add_discovered_device_to_gui(
         device_store, &iter, DEVICE_COL_ID, device_id, DEVICE_COL_NAME,
         device_name, DEVICE_COL_MODEL, device_model, DEVICE_COL_ADDRESS,
         address_str, -1);
+    /* the iterators of a list store stay valid while the row exists */
+    g_hash_table_insert(
+        device_rows, GUINT_TO_POINTER(device_id), gtk_tree_iter_copy(&iter));
 }
 
 /**
- * @brief Add discovered objects for a device to the GUI
+ * @brief Add some of the discovered objects of a device to the GUI
  * @param device_id - Device which contains objects
+ * @param object_index - index of the first object to add
+ * @param object_count - number of objects to add at most
+ * @return index of the object after the last one that was added
  */
-static void add_discovered_objects_to_gui(uint32_t device_id)
+static unsigned int add_discovered_objects_to_gui(
+    uint32_t device_id, unsigned int object_index, unsigned int object_count)
 {
     GtkTreeIter iter;
-    unsigned int object_index = 0;
-    unsigned int object_count = 0;
+    unsigned int object_end = 0;
     BACNET_OBJECT_ID object_id = { 0 };
     char object_name[MAX_CHARACTER_STRING_BYTES] = { 0 };
 
-    object_count = bacnet_discover_device_object_count(device_id);
-    for (object_index = 0; object_index < object_count; object_index++) {
+    object_end = bacnet_discover_device_object_count(device_id);
+    if (object_end > (object_index + object_count)) {
+        object_end = object_index + object_count;
+    }
+    for (; object_index < object_end; object_index++) {
         if (bacnet_discover_device_object_identifier(
                 device_id, object_index, &object_id)) {
             gtk_list_store_append(object_store, &iter);
@@ -220,6 +283,53 @@ static void add_discovered_objects_to_gui(uint32_t device_id)
                 object_id.instance, OBJECT_COL_NAME, object_name, -1);
         }
     }
+
+    return object_index;
+}
+
+/**
+ * @brief Add the next batch of objects of the selected device
+ * @param data optional data in the callback
+ * @return TRUE while there are more objects to add
+ */
+static gboolean object_fill_idle(gpointer data)
+{
+    unsigned int object_count;
+
+    (void)data;
+    object_fill_index = add_discovered_objects_to_gui(
+        object_fill_device, object_fill_index, OBJECT_ROWS_PER_IDLE);
+    object_count = bacnet_discover_device_object_count(object_fill_device);
+    if (object_fill_index >= object_count) {
+        object_fill_id = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop adding the objects of a device to the object store
+ */
+static void object_fill_stop(void)
+{
+    if (object_fill_id > 0) {
+        g_source_remove(object_fill_id);
+        object_fill_id = 0;
+    }
+}
+
+/**
+ * @brief Start adding the objects of a device to the object store,
+ *  in batches when the main loop is idle
+ * @param device_id - Device which contains objects
+ */
+static void object_fill_start(uint32_t device_id)
+{
+    object_fill_stop();
+    object_fill_device = device_id;
+    object_fill_index = 0;
+    object_fill_id = g_idle_add(object_fill_idle, NULL);
 }
 
 /**
@@ -241,8 +351,192 @@ on_device_selection_changed(GtkTreeSelection *selection, gpointer data)
         /* Clear object store and reload objects for selected device */
         gtk_list_store_clear(object_store);
         gtk_list_store_clear(property_store);
-        add_discovered_objects_to_gui(device_id);
+        object_fill_start(device_id);
+    }
+}
+
+/**
+ * @brief Make the key of a property in the property cache
+ * @param device_id Device instance of the object property
+ * @param object_type Object type of the property
+ * @param object_instance Object instance of the property
+ * @param property_id Property identifier
+ * @return newly allocated key, owned by the caller or the cache
+ */
+static gchar *property_cache_key(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t property_id)
+{
+    return g_strdup_printf(
+        "%lu:%u:%lu:%lu", (unsigned long)device_id, (unsigned)object_type,
+        (unsigned long)object_instance, (unsigned long)property_id);
+}
+
+/**
+ * @brief Free an entry of the property cache
+ * @param data the entry
+ */
+static void property_cache_entry_free(gpointer data)
+{
+    struct property_cache_entry *entry = data;
+
+    g_string_free(entry->text, TRUE);
+    g_free(entry);
+}
+
+/**
+ * @brief Show a value in the row of a property, if the object of the
+ *  property is the one in the property store
+ * @param device_id Device instance of the object property
+ * @param object_type Object type of the property
+ * @param object_instance Object instance of the property
+ * @param property_id Property identifier
+ * @param entry the value in the property cache
+ */
+static void property_row_update(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t property_id,
+    const struct property_cache_entry *entry)
+{
+    GtkTreeModel *model = GTK_TREE_MODEL(property_store);
+    GtkTreeIter iter;
+    guint row_property_id = 0;
+    gboolean valid;
+
+    if ((device_id != property_device_id) ||
+        (object_type != property_object_type) ||
+        (object_instance != property_object_instance)) {
+        return;
+    }
+    valid = gtk_tree_model_get_iter_first(model, &iter);
+    while (valid) {
+        gtk_tree_model_get(model, &iter, PROPERTY_COL_ID, &row_property_id, -1);
+        if (row_property_id == property_id) {
+            gtk_list_store_set(
+                property_store, &iter, PROPERTY_COL_VALUE_TAG, entry->tag,
+                PROPERTY_COL_VALUE, entry->text->str, -1);
+            break;
+        }
+        valid = gtk_tree_model_iter_next(model, &iter);
+    }
+}
+
+/**
+ * @brief Keep the value of a property that was read on demand. The
+ *  elements of an array arrive one at a time, and are joined.
+ * @param context context that was given when the read was queued
+ * @param device_id device instance number where data originated
+ * @param rp_data the object, property, and array index of the result
+ * @param value the decoded value, or NULL when the read failed
+ */
+static void property_read_result(
+    void *context,
+    uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    struct property_cache_entry *entry;
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    gchar *key;
+    int str_len;
+
+    (void)context;
+    if (!rp_data || !property_cache) {
+        return;
     }
+    key = property_cache_key(
+        device_id, rp_data->object_type, rp_data->object_instance,
+        rp_data->object_property);
+    entry = g_hash_table_lookup(property_cache, key);
+    if (!entry) {
+        /* the cache was cleared while the read was queued */
+        g_free(key);
+        return;
+    }
+    if (!value || (rp_data->error_code != ERROR_CODE_SUCCESS)) {
+        if (entry->pending) {
+            /* read it again the next time the object is selected */
+            g_hash_table_remove(property_cache, key);
+        }
+        g_free(key);
+        return;
+    }
+    g_free(key);
+    if (entry->pending || (rp_data->array_index <= 1)) {
+        entry->pending = false;
+        entry->tag = value->tag;
+        g_string_truncate(entry->text, 0);
+    } else {
+        g_string_append(entry->text, ", ");
+    }
+    object_value.object_type = rp_data->object_type;
+    object_value.object_instance = rp_data->object_instance;
+    object_value.object_property = rp_data->object_property;
+    object_value.array_index = rp_data->array_index;
+    object_value.value = value;
+    str_len = bacapp_snprintf_value(NULL, 0, &object_value);
+    if (str_len > 0) {
+        char str[str_len + 1];
+        bacapp_snprintf_value(str, str_len + 1, &object_value);
+        g_string_append(entry->text, str);
+    }
+    property_row_update(
+        device_id, rp_data->object_type, rp_data->object_instance,
+        rp_data->object_property, entry);
+}
+
+/**
+ * @brief Show the value of a property that was not in the discovery
+ *  from the property cache, or read it in the background
+ * @param iter the row of the property
+ * @param device_id Device instance of the object property
+ * @param object_type Object type of the property
+ * @param object_instance Object instance of the property
+ * @param property_id Property identifier
+ * @return true if the value is in the cache and was shown
+ */
+static bool property_cache_value(
+    GtkTreeIter *iter,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t property_id)
+{
+    struct property_cache_entry *entry;
+    gchar *key;
+
+    key = property_cache_key(
+        device_id, object_type, object_instance, property_id);
+    entry = g_hash_table_lookup(property_cache, key);
+    if (entry) {
+        g_free(key);
+        if (entry->pending) {
+            return false;
+        }
+        gtk_list_store_set(
+            property_store, iter, PROPERTY_COL_VALUE_TAG, entry->tag,
+            PROPERTY_COL_VALUE, entry->text->str, -1);
+        return true;
+    }
+    if (bacnet_read_property_queue_callback(
+            device_id, object_type, object_instance,
+            (BACNET_PROPERTY_ID)property_id, BACNET_ARRAY_ALL,
+            property_read_result, NULL)) {
+        entry = g_new0(struct property_cache_entry, 1);
+        entry->pending = true;
+        entry->tag = BACNET_APPLICATION_TAG_NULL;
+        entry->text = g_string_new(NULL);
+        g_hash_table_insert(property_cache, key, entry);
+    } else {
+        /* the queue is full, so try again the next time */
+        g_free(key);
+    }
+
+    return false;
 }
 
 /**
@@ -267,6 +561,9 @@ static void add_discovered_properties_to_gui(
     int str_len = 0;
     char *property_string;
 
+    property_device_id = device_id;
+    property_object_type = object_type;
+    property_object_instance = object_instance;
     property_count = bacnet_discover_object_property_count(
         device_id, object_type, object_instance);
     for (index = 0; index < property_count; index++) {
@@ -312,6 +609,8 @@ static void add_discovered_properties_to_gui(
                 PROPERTY_COL_ARRAY_INDEX, array_index, PROPERTY_COL_VALUE_TAG,
                 value.tag, PROPERTY_COL_NAME, property_string,
                 PROPERTY_COL_VALUE, "-", -1);
+            property_cache_value(
+                &iter, device_id, object_type, object_instance, property_id);
         }
     }
 }
@@ -461,11 +760,12 @@ static void on_property_edited(
 }
 
 /**
- * @brief Process discovered devices and add them to the GUI
+ * @brief Add some of the discovered devices to the GUI, or update their
+ *  rows, continuing from where the last call stopped
+ * @param rows number of devices to look at
  */
-static void process_discovered_devices(void)
+static void process_discovered_devices(unsigned int rows)
 {
-    unsigned int device_index = 0;
     unsigned int device_count = 0;
     unsigned int max_apdu = 0;
     BACNET_ADDRESS device_address = { 0 };
@@ -474,8 +774,16 @@ static void process_discovered_devices(void)
     char object_name[MAX_CHARACTER_STRING_BYTES] = { "-" };
 
     device_count = bacnet_discover_device_count();
-    for (device_index = 0; device_index < device_count; device_index++) {
-        device_id = bacnet_discover_device_instance(device_index);
+    if (rows > device_count) {
+        rows = device_count;
+    }
+    while (rows > 0) {
+        rows--;
+        if (device_sync_index >= device_count) {
+            device_sync_index = 0;
+        }
+        device_id = bacnet_discover_device_instance(device_sync_index);
+        device_sync_index++;
         bacnet_discover_property_name(
             device_id, OBJECT_DEVICE, device_id, PROP_MODEL_NAME, model_name,
             sizeof(model_name), "model-name");
@@ -488,6 +796,22 @@ static void process_discovered_devices(void)
     }
 }
 
+/**
+ * @brief GTK timeout callback that keeps the device list up to date
+ * @param data optional data for the callback
+ * @return TRUE to continue calling this function
+ */
+static gboolean device_sync_timeout(gpointer data)
+{
+    (void)data; /* unused parameter */
+
+    if (bacnet_initialized) {
+        process_discovered_devices(DEVICE_ROWS_PER_SYNC);
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Handle refresh button click
  * @param button button that was clicked
@@ -498,10 +822,14 @@ static void on_refresh_clicked(GtkButton *button, gpointer data)
     (void)button; /* unused parameter */
     (void)data; /* unused parameter */
 
+    object_fill_stop();
+    g_hash_table_remove_all(device_rows);
+    g_hash_table_remove_all(property_cache);
     gtk_list_store_clear(device_store);
     gtk_list_store_clear(object_store);
     gtk_list_store_clear(property_store);
-    process_discovered_devices();
+    device_sync_index = 0;
+    process_discovered_devices(DEVICE_ROWS_PER_SYNC);
 }
 
 /**
@@ -816,6 +1144,8 @@ static void bacnet_server_init(void)
 
     /* Start BACnet background processing */
     bacnet_timeout_id = g_timeout_add(10, bacnet_task_timeout, NULL);
+    device_sync_id =
+        g_timeout_add(DEVICE_SYNC_MILLISECONDS, device_sync_timeout, NULL);
 
     bacnet_initialized = true;
     printf("BACnet Stack initialized\n");
@@ -828,6 +1158,11 @@ static void bacnet_cleanup(void)
         g_source_remove(bacnet_timeout_id);
         bacnet_timeout_id = 0;
     }
+    if (device_sync_id > 0) {
+        g_source_remove(device_sync_id);
+        device_sync_id = 0;
+    }
+    object_fill_stop();
 
     if (bacnet_initialized) {
         datalink_cleanup();
@@ -835,6 +1170,10 @@ static void bacnet_cleanup(void)
         printf("BACnet Stack cleanup completed\n");
     }
     bacnet_discover_cleanup();
+    g_hash_table_destroy(property_cache);
+    property_cache = NULL;
+    g_hash_table_destroy(device_rows);
+    device_rows = NULL;
 }
 
 /* Main function */
@@ -845,6 +1184,11 @@ int main(int argc, char *argv[])
 
     /* Initialize GTK */
     gtk_init(&argc, &argv);
+    device_rows = g_hash_table_new_full(
+        g_direct_hash, g_direct_equal, NULL,
+        (GDestroyNotify)gtk_tree_iter_free);
+    property_cache = g_hash_table_new_full(
+        g_str_hash, g_str_equal, g_free, property_cache_entry_free);
 
     /* Initialize BACnet */
     dlenv_init();
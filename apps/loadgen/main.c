@@ -0,0 +1,788 @@
+/**
+ * @file
+ * @brief command line tool that sends a mix of BACnet requests to
+ * another device at a target rate, keeping many requests outstanding,
+ * and prints the throughput and the latency of the replies.
+ *
+ * Usage:
+ * $ ./bacload device-instance [options]
+ *
+ * The requests are ReadProperty, ReadPropertyMultiple, WriteProperty,
+ * and SubscribeCOV of one object in the device, and Who-Is of the
+ * device, answered by its I-Am.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bactext.h"
+#include "bacnet/iam.h"
+#include "bacnet/npdu.h"
+#include "bacnet/apdu.h"
+#include "bacnet/rpm.h"
+#include "bacnet/whois.h"
+#include "bacnet/version.h"
+/* some demo stuff needed */
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/perfstat.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/datalink/dlenv.h"
+#include "bacport.h"
+
+/* the services in the mix of requests */
+typedef enum loadgen_service {
+    LOADGEN_READ_PROPERTY = 0,
+    LOADGEN_READ_PROPERTY_MULTIPLE,
+    LOADGEN_WRITE_PROPERTY,
+    LOADGEN_SUBSCRIBE_COV,
+    LOADGEN_WHO_IS,
+    LOADGEN_SERVICE_MAX
+} LOADGEN_SERVICE;
+
+struct loadgen_service_stats {
+    uint32_t sent;
+    uint32_t acks;
+    uint32_t errors;
+    uint32_t timeouts;
+    /* requests that could not be sent, because the TSM was full */
+    uint32_t dropped;
+    /* time from the request to the reply, in microseconds */
+    PERFSTAT_HISTOGRAM latency;
+};
+
+struct loadgen_request {
+    bool active;
+    LOADGEN_SERVICE service;
+    uint32_t start;
+};
+
+/* Who-Is is unconfirmed, so the I-Am that answers it is matched
+   to the oldest Who-Is that is not answered yet */
+#define LOADGEN_WHO_IS_MAX 64
+
+/* buffer used for receive */
+static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+
+/* global variables used in this file */
+static uint32_t Target_Device_Object_Instance = BACNET_MAX_INSTANCE;
+static BACNET_ADDRESS Target_Address;
+static BACNET_OBJECT_TYPE Target_Object_Type = OBJECT_ANALOG_VALUE;
+static uint32_t Target_Object_Instance = 1;
+static const char *Service_Names[LOADGEN_SERVICE_MAX] = {
+    "read-property", "read-property-multiple", "write-property",
+    "subscribe-cov", "who-is"
+};
+/* share of each service in the mix of requests */
+static unsigned Service_Weight[LOADGEN_SERVICE_MAX] = { 60, 20, 10, 5, 5 };
+static int Service_Current_Weight[LOADGEN_SERVICE_MAX];
+static struct loadgen_service_stats Service_Stats[LOADGEN_SERVICE_MAX];
+/* indexed by the invoke ID of the request */
+static struct loadgen_request Requests[256];
+static unsigned Requests_Active;
+static uint32_t Who_Is_Start[LOADGEN_WHO_IS_MAX];
+static unsigned Who_Is_Head;
+static unsigned Who_Is_Count;
+static uint32_t COV_Notifications;
+/* requests of the schedule that were not sent, because the window
+   was full of requests waiting for a reply */
+static uint32_t Schedule_Missed;
+static PERFSTAT_HISTOGRAM Total_Latency;
+
+/**
+ * @brief Get the time for the latency
+ * @return a free running time in microseconds
+ */
+static uint32_t loadgen_usec(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000U) + (ts.tv_nsec / 1000));
+#else
+    return (uint32_t)(mstimer_now() * 1000UL);
+#endif
+}
+
+/**
+ * @brief Record the reply to a confirmed request
+ * @param src - BACnet address of the device that sent the reply
+ * @param invoke_id - invoke ID of the request
+ * @param error - true if the reply was an Error, Reject, or Abort
+ */
+static void loadgen_reply(BACNET_ADDRESS *src, uint8_t invoke_id, bool error)
+{
+    struct loadgen_request *request;
+    struct loadgen_service_stats *stats;
+    uint32_t latency;
+
+    if (!address_match(&Target_Address, src)) {
+        return;
+    }
+    request = &Requests[invoke_id];
+    if (!request->active) {
+        return;
+    }
+    latency = loadgen_usec() - request->start;
+    stats = &Service_Stats[request->service];
+    if (error) {
+        stats->errors++;
+    } else {
+        stats->acks++;
+    }
+    perfstat_histogram_record(&stats->latency, latency);
+    perfstat_histogram_record(&Total_Latency, latency);
+    request->active = false;
+    Requests_Active--;
+}
+
+static void My_Read_Property_Ack_Handler(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    loadgen_reply(src, service_data->invoke_id, false);
+}
+
+static void My_Simple_Ack_Handler(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    loadgen_reply(src, invoke_id, false);
+}
+
+static void MyErrorHandler(
+    BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    (void)error_class;
+    (void)error_code;
+    loadgen_reply(src, invoke_id, true);
+}
+
+static void MyAbortHandler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
+{
+    (void)abort_reason;
+    (void)server;
+    loadgen_reply(src, invoke_id, true);
+}
+
+static void
+MyRejectHandler(BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
+{
+    (void)reject_reason;
+    loadgen_reply(src, invoke_id, true);
+}
+
+static void My_I_Am_Handler(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    struct loadgen_service_stats *stats = &Service_Stats[LOADGEN_WHO_IS];
+    uint32_t device_id = 0;
+    uint32_t latency;
+    int len;
+
+    handler_i_am_bind(service_request, service_len, src);
+    len = iam_decode_service_request(
+        service_request, &device_id, NULL, NULL, NULL);
+    if ((len > 0) && (device_id == Target_Device_Object_Instance) &&
+        (Who_Is_Count > 0)) {
+        latency = loadgen_usec() - Who_Is_Start[Who_Is_Head];
+        Who_Is_Head = (Who_Is_Head + 1) % LOADGEN_WHO_IS_MAX;
+        Who_Is_Count--;
+        stats->acks++;
+        perfstat_histogram_record(&stats->latency, latency);
+        perfstat_histogram_record(&Total_Latency, latency);
+    }
+}
+
+static void My_COV_Notification_Handler(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    (void)service_request;
+    (void)service_len;
+    if (address_match(&Target_Address, src)) {
+        COV_Notifications++;
+    }
+}
+
+static void Init_Service_Handlers(void)
+{
+    Device_Init(NULL);
+    /* we need to handle who-is
+       to support dynamic device binding to us */
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_IS, handler_who_is);
+    /* handle i-am to bind to the device, and to answer our who-is */
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, My_I_Am_Handler);
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_COV_NOTIFICATION, My_COV_Notification_Handler);
+    /* set the handler for all the services we don't implement
+       It is required to send the proper reject message... */
+    apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
+    /* we must implement read property - it's required! */
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property);
+    /* answer the mix of requests too, so that with the loopback
+       datalink this device can be the target of its own load */
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, handler_read_property_multiple);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_WRITE_PROPERTY, handler_write_property);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, handler_cov_subscribe);
+    /* handle the data coming back from confirmed requests */
+    apdu_set_confirmed_ack_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, My_Read_Property_Ack_Handler);
+    apdu_set_confirmed_ack_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, My_Read_Property_Ack_Handler);
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_WRITE_PROPERTY, My_Simple_Ack_Handler);
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, My_Simple_Ack_Handler);
+    /* handle any errors coming back */
+    apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, MyErrorHandler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, MyErrorHandler);
+    apdu_set_error_handler(SERVICE_CONFIRMED_WRITE_PROPERTY, MyErrorHandler);
+    apdu_set_error_handler(SERVICE_CONFIRMED_SUBSCRIBE_COV, MyErrorHandler);
+    apdu_set_abort_handler(MyAbortHandler);
+    apdu_set_reject_handler(MyRejectHandler);
+}
+
+/**
+ * @brief Choose the next service of the mix, so that the services
+ *  are spread out in proportion to their weights
+ * @return the next service
+ */
+static LOADGEN_SERVICE loadgen_service_next(void)
+{
+    LOADGEN_SERVICE service = LOADGEN_READ_PROPERTY;
+    int total = 0;
+    unsigned i;
+
+    for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+        Service_Current_Weight[i] += (int)Service_Weight[i];
+        total += (int)Service_Weight[i];
+        if (Service_Current_Weight[i] > Service_Current_Weight[service]) {
+            service = (LOADGEN_SERVICE)i;
+        }
+    }
+    Service_Current_Weight[service] -= total;
+
+    return service;
+}
+
+/**
+ * @brief Send one request of the mix to the device
+ * @param service - the service of the request
+ */
+static void loadgen_send(LOADGEN_SERVICE service)
+{
+    static uint8_t pdu[MAX_PDU];
+    static BACNET_PROPERTY_REFERENCE rpm_property[3];
+    static BACNET_READ_ACCESS_DATA rpm_object;
+    static float real_value;
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    struct loadgen_service_stats *stats = &Service_Stats[service];
+    uint8_t invoke_id = 0;
+    unsigned index;
+
+    switch (service) {
+        case LOADGEN_READ_PROPERTY:
+            invoke_id = Send_Read_Property_Request(
+                Target_Device_Object_Instance, Target_Object_Type,
+                Target_Object_Instance, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+            break;
+        case LOADGEN_READ_PROPERTY_MULTIPLE:
+            rpm_property[0].propertyIdentifier = PROP_PRESENT_VALUE;
+            rpm_property[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+            rpm_property[0].next = &rpm_property[1];
+            rpm_property[1].propertyIdentifier = PROP_STATUS_FLAGS;
+            rpm_property[1].propertyArrayIndex = BACNET_ARRAY_ALL;
+            rpm_property[1].next = &rpm_property[2];
+            rpm_property[2].propertyIdentifier = PROP_OUT_OF_SERVICE;
+            rpm_property[2].propertyArrayIndex = BACNET_ARRAY_ALL;
+            rpm_property[2].next = NULL;
+            rpm_object.object_type = Target_Object_Type;
+            rpm_object.object_instance = Target_Object_Instance;
+            rpm_object.listOfProperties = &rpm_property[0];
+            rpm_object.next = NULL;
+            invoke_id = Send_Read_Property_Multiple_Request(
+                pdu, sizeof(pdu), Target_Device_Object_Instance, &rpm_object);
+            break;
+        case LOADGEN_WRITE_PROPERTY:
+            /* a new value each time, so that COV notifications are sent */
+            real_value += 1.0f;
+            if (real_value > 100.0f) {
+                real_value = 0.0f;
+            }
+            value.tag = BACNET_APPLICATION_TAG_REAL;
+            value.type.Real = real_value;
+            invoke_id = Send_Write_Property_Request(
+                Target_Device_Object_Instance, Target_Object_Type,
+                Target_Object_Instance, PROP_PRESENT_VALUE, &value,
+                BACNET_MAX_PRIORITY, BACNET_ARRAY_ALL);
+            break;
+        case LOADGEN_SUBSCRIBE_COV:
+            /* the same subscription is renewed each time */
+            cov_data.subscriberProcessIdentifier = 1;
+            cov_data.monitoredObjectIdentifier.type = Target_Object_Type;
+            cov_data.monitoredObjectIdentifier.instance =
+                Target_Object_Instance;
+            cov_data.issueConfirmedNotifications = false;
+            cov_data.lifetime = 60;
+            invoke_id =
+                Send_COV_Subscribe(Target_Device_Object_Instance, &cov_data);
+            break;
+        case LOADGEN_WHO_IS:
+            if (Who_Is_Count >= LOADGEN_WHO_IS_MAX) {
+                /* the oldest Who-Is was not answered */
+                Who_Is_Head = (Who_Is_Head + 1) % LOADGEN_WHO_IS_MAX;
+                Who_Is_Count--;
+                stats->timeouts++;
+            }
+            index = (Who_Is_Head + Who_Is_Count) % LOADGEN_WHO_IS_MAX;
+            Who_Is_Start[index] = loadgen_usec();
+            Who_Is_Count++;
+            Send_WhoIs(
+                Target_Device_Object_Instance, Target_Device_Object_Instance);
+            stats->sent++;
+            return;
+        default:
+            return;
+    }
+    if (invoke_id == 0) {
+        stats->dropped++;
+        return;
+    }
+    stats->sent++;
+    Requests[invoke_id].active = true;
+    Requests[invoke_id].service = service;
+    Requests[invoke_id].start = loadgen_usec();
+    Requests_Active++;
+}
+
+/**
+ * @brief Count the confirmed requests that failed after their retries
+ */
+static void loadgen_timeouts(void)
+{
+    unsigned invoke_id;
+
+    for (invoke_id = 1; invoke_id <= 255; invoke_id++) {
+        if (Requests[invoke_id].active &&
+            tsm_invoke_id_failed_peer(&Target_Address, (uint8_t)invoke_id)) {
+            tsm_free_invoke_id_peer(&Target_Address, (uint8_t)invoke_id);
+            Service_Stats[Requests[invoke_id].service].timeouts++;
+            Requests[invoke_id].active = false;
+            Requests_Active--;
+        }
+    }
+}
+
+/**
+ * @brief Parse the mix of requests, like rp=60,rpm=20,wp=10,cov=5,whois=5
+ * @param argv - the mix string
+ * @return true if the mix was valid
+ */
+static bool loadgen_mix_parse(char *argv)
+{
+    static const char *names[LOADGEN_SERVICE_MAX] = { "rp", "rpm", "wp",
+                                                      "cov", "whois" };
+    char *token;
+    char *weight;
+    unsigned total = 0;
+    unsigned i;
+
+    for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+        Service_Weight[i] = 0;
+    }
+    for (token = strtok(argv, ","); token; token = strtok(NULL, ",")) {
+        weight = strchr(token, '=');
+        if (!weight) {
+            return false;
+        }
+        *weight++ = 0;
+        for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+            if (strcmp(token, names[i]) == 0) {
+                break;
+            }
+        }
+        if (i >= LOADGEN_SERVICE_MAX) {
+            return false;
+        }
+        Service_Weight[i] = (unsigned)strtoul(weight, NULL, 0);
+        total += Service_Weight[i];
+    }
+
+    return total > 0;
+}
+
+/**
+ * @brief Print the results of the run
+ * @param elapsed_usec - length of the run in microseconds
+ * @param json - true to print the results as JSON, false as a table
+ */
+static void loadgen_report(uint32_t elapsed_usec, bool json)
+{
+    const struct loadgen_service_stats *stats;
+    const PERFSTAT_HISTOGRAM *latency;
+    uint32_t replies = 0, sent = 0, errors = 0, timeouts = 0, dropped = 0;
+    double seconds = (double)elapsed_usec / 1000000.0;
+    const char *separator = "";
+    unsigned i;
+
+    if (seconds <= 0.0) {
+        seconds = 1.0;
+    }
+    if (json) {
+        printf(
+            "{\"bacload\":\"%s\",\"seconds\":%.3f,", BACNET_VERSION_TEXT,
+            seconds);
+        printf("\"services\":[");
+    } else {
+        printf(
+            "%-22s %8s %8s %7s %7s %7s %8s %8s %8s %8s\n", "service", "sent",
+            "ack", "error", "timeout", "dropped", "p50-us", "p99-us",
+            "p999-us", "max-us");
+    }
+    for (i = 0; i < LOADGEN_SERVICE_MAX; i++) {
+        stats = &Service_Stats[i];
+        latency = &stats->latency;
+        sent += stats->sent;
+        replies += stats->acks + stats->errors;
+        errors += stats->errors;
+        timeouts += stats->timeouts;
+        dropped += stats->dropped;
+        if (Service_Weight[i] == 0) {
+            continue;
+        }
+        if (json) {
+            printf(
+                "%s{\"name\":\"%s\",\"sent\":%lu,\"ack\":%lu,\"error\":%lu,"
+                "\"timeout\":%lu,\"dropped\":%lu,\"p50_us\":%lu,"
+                "\"p99_us\":%lu,\"p999_us\":%lu,\"max_us\":%lu}",
+                separator, Service_Names[i], (unsigned long)stats->sent,
+                (unsigned long)stats->acks, (unsigned long)stats->errors,
+                (unsigned long)stats->timeouts, (unsigned long)stats->dropped,
+                (unsigned long)perfstat_histogram_permille(latency, 500),
+                (unsigned long)perfstat_histogram_permille(latency, 990),
+                (unsigned long)perfstat_histogram_permille(latency, 999),
+                (unsigned long)latency->max);
+            separator = ",";
+        } else {
+            printf(
+                "%-22s %8lu %8lu %7lu %7lu %7lu %8lu %8lu %8lu %8lu\n",
+                Service_Names[i], (unsigned long)stats->sent,
+                (unsigned long)stats->acks, (unsigned long)stats->errors,
+                (unsigned long)stats->timeouts, (unsigned long)stats->dropped,
+                (unsigned long)perfstat_histogram_permille(latency, 500),
+                (unsigned long)perfstat_histogram_permille(latency, 990),
+                (unsigned long)perfstat_histogram_permille(latency, 999),
+                (unsigned long)latency->max);
+        }
+    }
+    latency = &Total_Latency;
+    if (json) {
+        printf(
+            "],\"sent\":%lu,\"replies\":%lu,\"errors\":%lu,\"timeouts\":%lu,"
+            "\"dropped\":%lu,\"missed\":%lu,\"cov_notifications\":%lu,"
+            "\"replies_per_second\":%.1f,\"p50_us\":%lu,\"p99_us\":%lu,"
+            "\"p999_us\":%lu,\"max_us\":%lu}\n",
+            (unsigned long)sent, (unsigned long)replies, (unsigned long)errors,
+            (unsigned long)timeouts, (unsigned long)dropped,
+            (unsigned long)Schedule_Missed, (unsigned long)COV_Notifications,
+            (double)replies / seconds,
+            (unsigned long)perfstat_histogram_permille(latency, 500),
+            (unsigned long)perfstat_histogram_permille(latency, 990),
+            (unsigned long)perfstat_histogram_permille(latency, 999),
+            (unsigned long)latency->max);
+    } else {
+        printf(
+            "%-22s %8lu %8lu %7lu %7lu %7lu %8lu %8lu %8lu %8lu\n", "total",
+            (unsigned long)sent, (unsigned long)(replies - errors),
+            (unsigned long)errors, (unsigned long)timeouts,
+            (unsigned long)dropped,
+            (unsigned long)perfstat_histogram_permille(latency, 500),
+            (unsigned long)perfstat_histogram_permille(latency, 990),
+            (unsigned long)perfstat_histogram_permille(latency, 999),
+            (unsigned long)latency->max);
+        printf(
+            "%.1f replies/s in %.3f s, %lu COV notifications\n",
+            (double)replies / seconds, seconds,
+            (unsigned long)COV_Notifications);
+        if (Schedule_Missed) {
+            printf(
+                "%lu requests not sent on time, because the window was "
+                "full\n",
+                (unsigned long)Schedule_Missed);
+        }
+    }
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s device-instance\n", filename);
+    printf("       [--rate requests-per-second][--duration seconds]\n");
+    printf("       [--window requests][--mix service=weight[,...]]\n");
+    printf("       [--object object-type object-instance][--json]\n");
+    printf("       [--help][--version]\n");
+}
+
+static void print_help(const char *filename)
+{
+    printf("Send a mix of requests to a BACnet device at a target rate\n"
+           "and print the throughput and the latency of the replies.\n");
+    printf("\n");
+    printf("device-instance:\n"
+           "BACnet Device Object Instance number of the device under\n"
+           "load. The device is bound using Who-Is and I-Am.\n"
+           "With BACNET_DATALINK=loopback, use %u to load this\n"
+           "tool's own device in the same process, without sockets.\n",
+           (unsigned)BACNET_MAX_INSTANCE);
+    printf("\n");
+    printf("--rate requests-per-second\n"
+           "Number of requests to send each second (default 100).\n"
+           "Use 0 to send as fast as the window allows.\n");
+    printf("\n");
+    printf("--duration seconds\n"
+           "Number of seconds to send requests (default 10, at most 3600).\n");
+    printf("\n");
+    printf("--window requests\n"
+           "Largest number of confirmed requests waiting for a reply\n"
+           "(default 16, at most %u).\n",
+           (unsigned)MAX_TSM_TRANSACTIONS);
+    printf("\n");
+    printf("--mix service=weight[,...]\n"
+           "Share of each service in the requests, where the services\n"
+           "are rp, rpm, wp, cov, and whois\n"
+           "(default rp=60,rpm=20,wp=10,cov=5,whois=5).\n");
+    printf("\n");
+    printf("--object object-type object-instance\n"
+           "The object that is read, written, and subscribed\n"
+           "(default analog-value 1). WriteProperty writes a REAL\n"
+           "to the Present_Value at priority 16.\n");
+    printf("\n");
+    printf("--json\n"
+           "Print the results as one JSON object.\n");
+    printf("\n");
+    printf("Example:\n"
+           "%s 123 --rate 500 --duration 30 --mix rp=80,wp=20\n",
+           filename);
+}
+
+int main(int argc, char *argv[])
+{
+    BACNET_ADDRESS src = { 0 }; /* address where message came from */
+    uint16_t pdu_len = 0;
+    unsigned timeout = 0; /* milliseconds */
+    unsigned max_apdu = 0;
+    unsigned long rate = 100;
+    unsigned long duration = 10;
+    unsigned long window = 16;
+    bool json = false;
+    bool found = false;
+    bool sending = false;
+    uint32_t now = 0, run_start = 0, last_tick = 0, bind_start = 0;
+    uint32_t elapsed_usec = 0, drain_usec = 0, tick_usec = 0;
+    uint64_t sent_count = 0, due_count = 0;
+    unsigned object_type = 0;
+    unsigned long index = 0;
+    int argi = 0;
+    unsigned target_args = 0;
+    const char *filename = NULL;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2026 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if (strcmp(argv[argi], "--rate") == 0) {
+            if (++argi < argc) {
+                rate = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--duration") == 0) {
+            if (++argi < argc) {
+                duration = strtoul(argv[argi], NULL, 0);
+            }
+            if (duration > 3600) {
+                fprintf(
+                    stderr, "duration=%lu - not greater than 3600\n",
+                    duration);
+                return 1;
+            }
+        } else if (strcmp(argv[argi], "--window") == 0) {
+            if (++argi < argc) {
+                window = strtoul(argv[argi], NULL, 0);
+            }
+            if ((window < 1) || (window > MAX_TSM_TRANSACTIONS)) {
+                fprintf(
+                    stderr, "window=%lu - it must be 1 to %u\n", window,
+                    (unsigned)MAX_TSM_TRANSACTIONS);
+                return 1;
+            }
+        } else if (strcmp(argv[argi], "--mix") == 0) {
+            if ((++argi >= argc) || !loadgen_mix_parse(argv[argi])) {
+                fprintf(stderr, "Error: mix invalid\n");
+                return 1;
+            }
+        } else if (strcmp(argv[argi], "--object") == 0) {
+            if ((argi + 2) >= argc) {
+                fprintf(stderr, "Error: object missing\n");
+                return 1;
+            }
+            if (!bactext_object_type_strtol(argv[++argi], &object_type) ||
+                (object_type >= MAX_BACNET_OBJECT_TYPE)) {
+                fprintf(
+                    stderr, "Error: object-type=%s invalid\n", argv[argi]);
+                return 1;
+            }
+            Target_Object_Type = (BACNET_OBJECT_TYPE)object_type;
+            Target_Object_Instance = strtoul(argv[++argi], NULL, 0);
+            if (Target_Object_Instance > BACNET_MAX_INSTANCE) {
+                fprintf(
+                    stderr, "object-instance=%u - not greater than %u\n",
+                    Target_Object_Instance, BACNET_MAX_INSTANCE);
+                return 1;
+            }
+        } else if (strcmp(argv[argi], "--json") == 0) {
+            json = true;
+        } else if (target_args == 0) {
+            Target_Device_Object_Instance = strtoul(argv[argi], NULL, 0);
+            if (Target_Device_Object_Instance > BACNET_MAX_INSTANCE) {
+                fprintf(
+                    stderr, "device-instance=%u - not greater than %u\n",
+                    Target_Device_Object_Instance, BACNET_MAX_INSTANCE);
+                return 1;
+            }
+            target_args++;
+        }
+    }
+    if (target_args < 1) {
+        print_usage(filename);
+        return 1;
+    }
+    /* setup my info */
+    Device_Set_Object_Instance_Number(BACNET_MAX_INSTANCE);
+    address_init();
+    Init_Service_Handlers();
+    dlenv_init();
+    atexit(datalink_cleanup);
+    /* try to bind with the device */
+    bind_start = loadgen_usec();
+    last_tick = bind_start;
+    found = address_bind_request(
+        Target_Device_Object_Instance, &max_apdu, &Target_Address);
+    if (!found) {
+        Send_WhoIs(
+            Target_Device_Object_Instance, Target_Device_Object_Instance);
+    }
+    /* the time to wait for the replies after the last request */
+    drain_usec = apdu_timeout() * (apdu_retries() + 1U) * 1000U;
+    for (;;) {
+        now = loadgen_usec();
+        /* the TSM and the datalink count time in milliseconds */
+        tick_usec += now - last_tick;
+        last_tick = now;
+        if (tick_usec >= 1000U) {
+            tsm_timer_milliseconds(tick_usec / 1000U);
+            tick_usec %= 1000U;
+        }
+        if (!found) {
+            found = address_bind_request(
+                Target_Device_Object_Instance, &max_apdu, &Target_Address);
+            if (found) {
+                /* the I-Am of the binding does not answer the run */
+                run_start = loadgen_usec();
+                sending = true;
+                Who_Is_Count = 0;
+            } else if ((now - bind_start) > drain_usec) {
+                fprintf(
+                    stderr, "Error: device %u not bound!\n",
+                    Target_Device_Object_Instance);
+                return 1;
+            }
+        }
+        timeout = 1;
+        if (sending) {
+            elapsed_usec = now - run_start;
+            if (elapsed_usec >= (duration * 1000000UL)) {
+                sending = false;
+            } else if (rate == 0) {
+                /* a window of requests at most, since Who-Is and
+                   requests dropped by a full TSM do not fill it */
+                for (index = 0; (index < window) && (Requests_Active < window);
+                     index++) {
+                    loadgen_send(loadgen_service_next());
+                }
+                timeout = 0;
+            } else {
+                due_count = ((uint64_t)elapsed_usec * rate) / 1000000U;
+                while ((sent_count < due_count) &&
+                       (Requests_Active < window)) {
+                    loadgen_send(loadgen_service_next());
+                    sent_count++;
+                }
+                if (sent_count < due_count) {
+                    /* the window is full, so the schedule slips */
+                    Schedule_Missed += (uint32_t)(due_count - sent_count);
+                    sent_count = due_count;
+                }
+            }
+        } else if (found) {
+            elapsed_usec = now - run_start;
+            if ((Requests_Active == 0) ||
+                (elapsed_usec >= ((duration * 1000000UL) + drain_usec))) {
+                break;
+            }
+        }
+        loadgen_timeouts();
+        /* returns 0 bytes on timeout */
+        pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, timeout);
+        /* process */
+        if (pdu_len) {
+            npdu_handler(&src, &Rx_Buf[0], pdu_len);
+        }
+    }
+    /* the requests that are still outstanding did not get a reply */
+    for (argi = 1; argi <= 255; argi++) {
+        if (Requests[argi].active) {
+            Service_Stats[Requests[argi].service].timeouts++;
+        }
+    }
+    Service_Stats[LOADGEN_WHO_IS].timeouts += Who_Is_Count;
+    loadgen_report(loadgen_usec() - run_start, json);
+
+    return 0;
+}
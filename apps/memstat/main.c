@@ -0,0 +1,194 @@
+/**
+ * @file
+ * @brief command line tool that prints the memory footprint of the
+ * BACnet stack, by subsystem and by object type, after creating a
+ * number of objects of each type that has a memory pool.
+ *
+ * Usage:
+ * $ ./bacmem [--count N]
+ *
+ * The numbers come from the memory accounting, so the stack library
+ * must be built with BACNET_MEMSTAT_ENABLED=1.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/bactext.h"
+#include "bacnet/version.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/ai.h"
+#include "bacnet/basic/object/ao.h"
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/bi.h"
+#include "bacnet/basic/object/bo.h"
+#include "bacnet/basic/object/bv.h"
+#include "bacnet/basic/object/color_object.h"
+#include "bacnet/basic/object/lo.h"
+#include "bacnet/basic/object/ms-input.h"
+#include "bacnet/basic/object/mso.h"
+#include "bacnet/basic/object/msv.h"
+#include "bacnet/basic/service/h_cov.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/sys/memstat.h"
+#include "bacnet/basic/tsm/tsm.h"
+
+/* the object types that take their data from a memory pool */
+static const struct memstat_object_type {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t (*create)(uint32_t object_instance);
+    unsigned (*count)(void);
+} Object_Types[] = {
+    { OBJECT_ANALOG_INPUT, Analog_Input_Create, Analog_Input_Count },
+    { OBJECT_ANALOG_OUTPUT, Analog_Output_Create, Analog_Output_Count },
+    { OBJECT_ANALOG_VALUE, Analog_Value_Create, Analog_Value_Count },
+    { OBJECT_BINARY_INPUT, Binary_Input_Create, Binary_Input_Count },
+    { OBJECT_BINARY_OUTPUT, Binary_Output_Create, Binary_Output_Count },
+    { OBJECT_BINARY_VALUE, Binary_Value_Create, Binary_Value_Count },
+    { OBJECT_COLOR, Color_Create, Color_Count },
+    { OBJECT_LIGHTING_OUTPUT, Lighting_Output_Create, Lighting_Output_Count },
+    { OBJECT_MULTI_STATE_INPUT, Multistate_Input_Create,
+      Multistate_Input_Count },
+    { OBJECT_MULTI_STATE_OUTPUT, Multistate_Output_Create,
+      Multistate_Output_Count },
+    { OBJECT_MULTI_STATE_VALUE, Multistate_Value_Create,
+      Multistate_Value_Count },
+};
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--count N]\n", filename);
+    printf("       [--help][--version]\n");
+}
+
+static void print_help(const char *filename)
+{
+    printf("Print the bytes of memory used by each subsystem of the\n"
+           "BACnet stack, and by each object type that has a memory pool.\n");
+    printf("\n");
+    printf("--count N\n"
+           "Create N objects of each object type that has a memory pool.\n"
+           "The default is 100.\n");
+    printf("\n");
+    printf(
+        "The stack library must be built with BACNET_MEMSTAT_ENABLED=1,\n"
+        "for example with make MEMSTAT=1, or cmake -DBACNET_MEMSTAT=ON.\n");
+    printf("\n");
+    printf("Example:\n"
+           "%s --count 1000\n",
+           filename);
+}
+
+/**
+ * @brief Print the memory used by each subsystem
+ */
+static void print_subsystems(void)
+{
+    MEMSTAT_USAGE usage = { 0 };
+    unsigned i;
+
+    printf("%-10s %12s %12s %12s\n", "subsystem", "heap", "peak", "fixed");
+    for (i = 0; i < MEMSTAT_SUBSYSTEM_MAX; i++) {
+        memstat_subsystem(i, &usage);
+        printf(
+            "%-10s %12lu %12lu %12lu\n", memstat_subsystem_name(i),
+            (unsigned long)usage.heap, (unsigned long)usage.peak,
+            (unsigned long)usage.fixed);
+    }
+    printf("%-10s %12lu\n", "total", (unsigned long)memstat_total());
+}
+
+/**
+ * @brief Print the memory used by the pool of each object type
+ */
+static void print_object_types(void)
+{
+    MEMSTAT_USAGE usage = { 0 };
+    unsigned count;
+    unsigned i;
+
+    printf(
+        "%-24s %8s %12s %12s\n", "object-type", "objects", "heap",
+        "per-object");
+    for (i = 0; i < sizeof(Object_Types) / sizeof(Object_Types[0]); i++) {
+        memstat_object_type(Object_Types[i].object_type, &usage);
+        count = Object_Types[i].count();
+        printf(
+            "%-24s %8u %12lu %12lu\n",
+            bactext_object_type_name(Object_Types[i].object_type), count,
+            (unsigned long)usage.heap,
+            (unsigned long)(count ? (usage.heap / count) : 0));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filename = NULL;
+    unsigned long count = 100;
+    unsigned long n;
+    unsigned i;
+    int argi;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2026 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if (strcmp(argv[argi], "--count") == 0) {
+            if (++argi < argc) {
+                count = strtoul(argv[argi], NULL, 0);
+            }
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if (!BACNET_MEMSTAT_ENABLED) {
+        fprintf(
+            stderr,
+            "Error: the memory accounting is not built in. "
+            "Build with BACNET_MEMSTAT_ENABLED=1.\n");
+        return 1;
+    }
+    Device_Init(NULL);
+    address_init();
+    handler_cov_init();
+    tsm_timer_milliseconds(0);
+    for (i = 0; i < sizeof(Object_Types) / sizeof(Object_Types[0]); i++) {
+        for (n = 0; n < count; n++) {
+            if (Object_Types[i].create(BACNET_MAX_INSTANCE) ==
+                BACNET_MAX_INSTANCE) {
+                fprintf(
+                    stderr, "Error: unable to create %s objects\n",
+                    bactext_object_type_name(Object_Types[i].object_type));
+                break;
+            }
+        }
+    }
+    print_subsystems();
+    printf("\n");
+    print_object_types();
+
+    return 0;
+}
@@ -24,6 +24,8 @@
 #include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/datalink/crc.h"
 #include "bacnet/datalink/mstptext.h"
+#include "bacnet/datalink/mstpstat.h"
+#include "bacnet/basic/sys/fifo.h"
 #include "bacnet/basic/sys/filename.h"
 /* OS specific includes */
 #include "bacport.h"
@@ -49,6 +51,28 @@
 #endif
 
 #define MSTP_HEADER_MAX (2 + 1 + 1 + 1 + 2 + 1)
+/* the largest frame that is captured: header, data, and data CRC */
+#define MSTP_FRAME_MAX (MSTP_HEADER_MAX + DLMSTP_MPDU_MAX + 2)
+
+/* pcapng block types, and the magic number of the host byte order */
+#define PCAPNG_SECTION_HEADER_BLOCK 0x0A0D0D0AUL
+#define PCAPNG_INTERFACE_DESCRIPTION_BLOCK 1UL
+#define PCAPNG_ENHANCED_PACKET_BLOCK 6UL
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4DUL
+/* octets of an enhanced packet block, not counting the padded frame */
+#define PCAPNG_PACKET_OVERHEAD 32
+/* the largest enhanced packet block that is written */
+#define PCAPNG_PACKET_MAX (PCAPNG_PACKET_OVERHEAD + MSTP_FRAME_MAX + 3)
+/* the largest block that is read from a scanned file */
+#define PCAPNG_BLOCK_MAX 65536UL
+/* interfaces of a scanned pcapng section that are tracked */
+#define PCAPNG_INTERFACE_MAX 8
+
+/* octets of captured frames that wait for the writer thread, which keeps
+   the serial port read while the disk is slow */
+#ifndef MSTPCAP_QUEUE_SIZE
+#define MSTPCAP_QUEUE_SIZE (8UL * 1024UL * 1024UL)
+#endif
 
 /* local port data - shared with RS-485 */
 static struct mstp_port_struct_t MSTP_Port;
@@ -117,6 +141,23 @@ struct mstp_statistics {
 #define MAX_MSTP_DEVICES 256
 static struct mstp_statistics MSTP_Statistics[MAX_MSTP_DEVICES];
 static uint32_t Invalid_Frame_Count;
+/* frames that did not fit into the capture queue */
+static uint32_t Capture_Dropped_Count;
+/* token rotation, usage, and utilization of the trunk */
+static MSTPSTAT MSTP_Analyzer;
+/* print a line of the trunk analysis after each interval */
+static bool Analyze_Samples;
+static uint32_t Analyze_Interval_Seconds = 10;
+static struct mstimer Analyze_Timer;
+/* baud rate of the trunk, for its utilization */
+static uint32_t Analyze_Baud = 38400;
+/* time of the last frame, in microseconds */
+static uint32_t Frame_Time_Usec;
+
+static uint32_t timeval_usec(const struct timeval *tv)
+{
+    return (uint32_t)tv->tv_sec * 1000000UL + (uint32_t)tv->tv_usec;
+}
 
 static uint32_t
 timeval_diff_ms(const struct timeval *old, const struct timeval *now)
@@ -185,6 +226,10 @@ static void packet_statistics(
     dst = mstp_port->DestinationAddress;
     src = mstp_port->SourceAddress;
     frame = mstp_port->FrameType;
+    Frame_Time_Usec = timeval_usec(tv);
+    mstpstat_frame(
+        &MSTP_Analyzer, Frame_Time_Usec, frame, dst, src,
+        mstp_port->DataLength);
     switch (frame) {
         case FRAME_TYPE_TOKEN:
             MSTP_Statistics[src].token_count++;
@@ -303,6 +348,182 @@ static void packet_statistics(
     old_tv.tv_usec = tv->tv_usec;
 }
 
+/**
+ * @brief Format a permille value as a percentage
+ * @param permille - the value, in permille
+ * @param buffer - buffer for the text
+ * @param buffer_size - size of the buffer
+ * @return the text
+ */
+static const char *
+permille_text(uint32_t permille, char *buffer, size_t buffer_size)
+{
+    snprintf(
+        buffer, buffer_size, "%lu.%lu%%", (unsigned long)(permille / 10),
+        (unsigned long)(permille % 10));
+
+    return buffer;
+}
+
+/**
+ * @brief Print a line of the trunk analysis for a sample interval
+ * @param sample - the sample
+ */
+static void analyzer_sample_print(const MSTPSTAT_SAMPLE *sample)
+{
+    static bool header_printed;
+    const MSTPSTAT_SAMPLE *total;
+    char utilization[16], pfm[16];
+
+    if (!header_printed) {
+        fprintf(stdout, "\n");
+        fprintf(
+            stdout, "%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-7s", "Time",
+            "Frames", "Invalid", "Util", "Tokens", "PFM", "DER", "Postpd",
+            "Trot", "TrotMax");
+        fprintf(stdout, "\n");
+        header_printed = true;
+    }
+    total = mstpstat_total(&MSTP_Analyzer);
+    fprintf(
+        stdout, "%-8lu%-8lu%-8lu%-8s%-8lu",
+        (unsigned long)(total->duration_us / 1000000UL),
+        (unsigned long)sample->frames, (unsigned long)sample->invalid_frames,
+        permille_text(
+            mstpstat_utilization(sample, Analyze_Baud), utilization,
+            sizeof(utilization)),
+        (unsigned long)sample->tokens);
+    fprintf(
+        stdout, "%-8s%-8lu%-8lu%-8lu%-7lu",
+        permille_text(mstpstat_pfm_permille(sample), pfm, sizeof(pfm)),
+        (unsigned long)sample->der, (unsigned long)sample->reply_postponed,
+        (unsigned long)(mstpstat_rotation_average(sample) / 1000UL),
+        (unsigned long)(sample->rotation_max_us / 1000UL));
+    fprintf(stdout, "\n");
+    fflush(stdout);
+}
+
+/**
+ * @brief Print the trunk analysis since the start, with the usage of
+ *  each master and the settings that look wrong
+ */
+static void analyzer_print(void)
+{
+    const MSTPSTAT_SAMPLE *total;
+    const MSTPSTAT_NODE *node;
+    char text[3][16];
+    unsigned i, advice;
+    uint64_t duration_us, octets;
+    uint32_t rotation_us, octets_permille, full_permille;
+
+    (void)mstpstat_sample_take(&MSTP_Analyzer, Frame_Time_Usec, NULL);
+    total = mstpstat_total(&MSTP_Analyzer);
+    duration_us = total->duration_us;
+    octets = total->octets;
+    if (duration_us == 0) {
+        return;
+    }
+    fprintf(stdout, "\n");
+    fprintf(stdout, "==== MS/TP Trunk Analysis ====\n");
+    fprintf(
+        stdout, "Duration: %lu ms at %lu bps\n",
+        (unsigned long)(duration_us / 1000UL), (unsigned long)Analyze_Baud);
+    fprintf(
+        stdout, "Utilization: %s of the baud rate\n",
+        permille_text(
+            mstpstat_utilization(total, Analyze_Baud), text[0],
+            sizeof(text[0])));
+    fprintf(
+        stdout, "Token Rotation: %lu ms average, %lu ms min, %lu ms max\n",
+        (unsigned long)(mstpstat_rotation_average(total) / 1000UL),
+        (unsigned long)(total->rotation_min_us / 1000UL),
+        (unsigned long)(total->rotation_max_us / 1000UL));
+    fprintf(
+        stdout, "Poll For Master: %lu frames, %s of the time\n",
+        (unsigned long)total->pfm,
+        permille_text(mstpstat_pfm_permille(total), text[0], sizeof(text[0])));
+    fprintf(
+        stdout, "Reply Postponed: %lu of %lu requests, %lu token retries\n",
+        (unsigned long)total->reply_postponed, (unsigned long)total->der,
+        (unsigned long)total->token_retries);
+    fprintf(stdout, "\n");
+    fprintf(stdout, "==== MS/TP Master Usage ====\n");
+    fprintf(
+        stdout, "%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-7s", "MAC", "Tokens",
+        "Frames", "Octets", "Hold", "Trot", "TrotMax", "MaxInfo", "Full",
+        "Tusage");
+    fprintf(stdout, "\n");
+    for (i = 0; i < MSTPSTAT_NODES; i++) {
+        node = mstpstat_node(&MSTP_Analyzer, i);
+        if (node->tokens == 0) {
+            continue;
+        }
+        rotation_us = 0;
+        if (node->rotation_count) {
+            rotation_us =
+                (uint32_t)(node->rotation_sum_us / node->rotation_count);
+        }
+        octets_permille = 0;
+        if (octets) {
+            octets_permille = (uint32_t)((node->octets * 1000ULL) / octets);
+        }
+        full_permille = 0;
+        if (node->data_tokens) {
+            full_permille =
+                (uint32_t)((node->full_tokens * 1000ULL) / node->data_tokens);
+        }
+        fprintf(
+            stdout, "%-8u%-8lu%-8lu%-8s%-8s", i, (unsigned long)node->tokens,
+            (unsigned long)node->frames,
+            permille_text(octets_permille, text[0], sizeof(text[0])),
+            permille_text(
+                (uint32_t)((node->token_time_us * 1000ULL) / duration_us),
+                text[1], sizeof(text[1])));
+        fprintf(
+            stdout, "%-8lu%-8lu%-8u%-8s%-7lu",
+            (unsigned long)(rotation_us / 1000UL),
+            (unsigned long)(node->rotation_max_us / 1000UL),
+            (unsigned)node->max_info_frames,
+            permille_text(full_permille, text[2], sizeof(text[2])),
+            (unsigned long)(node->tusage_max_us / 1000UL));
+        fprintf(stdout, "\n");
+    }
+    for (i = 0; i < MSTPSTAT_NODES; i++) {
+        advice = mstpstat_advice(&MSTP_Analyzer, i);
+        node = mstpstat_node(&MSTP_Analyzer, i);
+        if (advice & MSTPSTAT_ADVICE_MAX_INFO_FRAMES) {
+            fprintf(
+                stdout,
+                "MAC %u: sends all of its %u frames in most tokens - "
+                "raise its Max_Info_Frames\n",
+                i, (unsigned)node->max_info_frames);
+        }
+        if (advice & MSTPSTAT_ADVICE_MAX_MASTER) {
+            fprintf(
+                stdout,
+                "MAC %u: polls up to MAC %u above the last master %u - "
+                "lower its Max_Master\n",
+                i, (unsigned)node->max_master,
+                (unsigned)MSTP_Analyzer.max_master);
+        }
+        if (advice & MSTPSTAT_ADVICE_TUSAGE_TIMEOUT) {
+            fprintf(
+                stdout,
+                "MAC %u: waits %lu ms for absent masters - "
+                "lower its Tusage_timeout\n",
+                i, (unsigned long)(node->tusage_max_us / 1000UL));
+        }
+        if (advice & MSTPSTAT_ADVICE_REPLY_POSTPONED) {
+            fprintf(
+                stdout,
+                "MAC %u: postpones %lu of %lu requests - "
+                "its replies wait for a token\n",
+                i, (unsigned long)node->reply_postponed,
+                (unsigned long)node->der_received);
+        }
+    }
+}
+
 static void packet_statistics_print(void)
 {
     unsigned i; /* loop counter */
@@ -379,6 +600,12 @@ static void packet_statistics_print(void)
     fprintf(
         stdout, "Invalid Frame Count: %lu\n",
         (long unsigned int)Invalid_Frame_Count);
+    if (Capture_Dropped_Count) {
+        fprintf(
+            stdout, "Dropped Frame Count: %lu\n",
+            (long unsigned int)Capture_Dropped_Count);
+    }
+    analyzer_print();
     fflush(stdout);
 }
 
@@ -391,6 +618,7 @@ static void packet_statistics_clear(void)
         MSTP_Statistics[i].device_id = 0xFFFFFFFF;
     }
     Invalid_Frame_Count = 0;
+    mstpstat_init(&MSTP_Analyzer, Analyze_Interval_Seconds * 1000UL);
 }
 
 static uint32_t Timer_Silence(void *pArg)
@@ -445,7 +673,7 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     return 0;
 }
 
-static char Capture_Filename[64] = "mstp_20090123091200.cap";
+static char Capture_Filename[64] = "mstp_20090123091200.pcapng";
 static FILE *File_Handle = NULL; /* stream pointer */
 #if defined(_WIN32)
 static HANDLE Pipe_Handle = INVALID_HANDLE_VALUE; /* pipe handle */
@@ -562,6 +790,66 @@ static size_t data_write_header(const void *ptr, size_t size, size_t nitems)
 }
 #endif
 
+/* captured frames, as pcapng enhanced packet blocks */
+static FIFO_DATA_STORE(Capture_Queue_Data, MSTPCAP_QUEUE_SIZE);
+static FIFO_BUFFER Capture_Queue;
+/* the writer thread stops when this is false and the queue is empty */
+static volatile bool Capture_Writer_Running;
+#if defined(_WIN32)
+static HANDLE Capture_Writer_Thread;
+#else
+static pthread_t Capture_Writer_Thread;
+#endif
+/* a new file is created after this many frames, octets, or seconds;
+   zero is no limit */
+static uint32_t Rotate_Packets = 65535;
+static uint64_t Rotate_Octets;
+static uint32_t Rotate_Seconds;
+/* frames and octets written to the file, and when it was created */
+static uint32_t File_Packets;
+static uint64_t File_Octets;
+static time_t File_Created;
+/* the scanned file is pcapng rather than libpcap */
+static bool Scan_Pcapng;
+/* link type and timestamp resolution of each interface of the section */
+static uint16_t Scan_Link_Type[PCAPNG_INTERFACE_MAX];
+static uint8_t Scan_Ts_Resolution[PCAPNG_INTERFACE_MAX];
+static unsigned Scan_Interface_Count;
+
+/**
+ * @brief Get the time of day
+ * @return nanoseconds since the epoch
+ */
+static uint64_t capture_time_ns(void)
+{
+#if defined(_WIN32)
+    FILETIME ft;
+    ULARGE_INTEGER t;
+
+    GetSystemTimeAsFileTime(&ft);
+    t.LowPart = ft.dwLowDateTime;
+    t.HighPart = ft.dwHighDateTime;
+    /* from 100 nanoseconds since 1601 */
+    return (t.QuadPart - 116444736000000000ULL) * 100ULL;
+#else
+    struct timespec ts = { 0 };
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Convert nanoseconds since the epoch for the statistics
+ * @param ns - nanoseconds since the epoch
+ * @param tv - [out] the time as seconds and microseconds
+ */
+static void capture_time_timeval(uint64_t ns, struct timeval *tv)
+{
+    tv->tv_sec = (long)(ns / 1000000000ULL);
+    tv->tv_usec = (long)((ns % 1000000000ULL) / 1000ULL);
+}
+
 static void filename_create_new(void)
 {
     BACNET_DATE bdate;
@@ -576,13 +864,18 @@ static void filename_create_new(void)
         fclose(File_Handle);
     }
     File_Handle = NULL;
+    File_Packets = 0;
+    File_Octets = 0;
+    File_Created = time(NULL);
     datetime_local(&bdate, &btime, NULL, NULL);
     snprintf(
-        filename, filename_size, "mstp_%04d%02d%02d%02d%02d%02d.cap",
+        filename, filename_size, "mstp_%04d%02d%02d%02d%02d%02d.pcapng",
         (int)bdate.year, (int)bdate.month, (int)bdate.day, (int)btime.hour,
         (int)btime.min, (int)btime.sec);
     File_Handle = fopen(filename, "wb");
     if (File_Handle) {
+        /* the writer thread hands large chunks to the disk */
+        (void)setvbuf(File_Handle, NULL, _IOFBF, 1024UL * 1024UL);
         fprintf(stdout, "mstpcap: saving capture to %s\n", filename);
     } else {
         fprintf(
@@ -591,48 +884,93 @@ static void filename_create_new(void)
     }
 }
 
-/* write packet to file in libpcap format */
+static unsigned pcapng_encode_u16(uint8_t *buffer, unsigned len, uint16_t value)
+{
+    memcpy(&buffer[len], &value, sizeof(value));
+
+    return len + sizeof(value);
+}
+
+static unsigned pcapng_encode_u32(uint8_t *buffer, unsigned len, uint32_t value)
+{
+    memcpy(&buffer[len], &value, sizeof(value));
+
+    return len + sizeof(value);
+}
+
+static uint16_t pcapng_decode_u16(const uint8_t *buffer)
+{
+    uint16_t value;
+
+    memcpy(&value, buffer, sizeof(value));
+
+    return value;
+}
+
+static uint32_t pcapng_decode_u32(const uint8_t *buffer)
+{
+    uint32_t value;
+
+    memcpy(&value, buffer, sizeof(value));
+
+    return value;
+}
+
+/* write the section header and interface description of a new file in
+   pcapng format, in the byte order of this host */
 static void write_global_header(void)
 {
-    uint32_t magic_number = 0xa1b2c3d4; /* magic number */
-    uint16_t version_major = 2; /* major version number */
-    uint16_t version_minor = 4; /* minor version number */
-    int32_t thiszone = 0; /* GMT to local correction */
-    uint32_t sigfigs = 0; /* accuracy of timestamps */
-    uint32_t snaplen = 65535; /* max length of captured packets, in octets */
-    uint32_t network = DLT_BACNET_MS_TP; /* data link type - BACNET_MS_TP */
-
-    /* create a new file. */
-    (void)data_write_header(&magic_number, sizeof(magic_number), 1);
-    (void)data_write_header(&version_major, sizeof(version_major), 1);
-    (void)data_write_header(&version_minor, sizeof(version_minor), 1);
-    (void)data_write_header(&thiszone, sizeof(thiszone), 1);
-    (void)data_write_header(&sigfigs, sizeof(sigfigs), 1);
-    (void)data_write_header(&snaplen, sizeof(snaplen), 1);
-    (void)data_write_header(&network, sizeof(network), 1);
-    fflush(File_Handle);
+    uint8_t block[32] = { 0 };
+    unsigned len = 0;
+
+    /* section header block, with an unknown section length */
+    len = pcapng_encode_u32(block, 0, PCAPNG_SECTION_HEADER_BLOCK);
+    len = pcapng_encode_u32(block, len, 28);
+    len = pcapng_encode_u32(block, len, PCAPNG_BYTE_ORDER_MAGIC);
+    len = pcapng_encode_u16(block, len, 1); /* major version number */
+    len = pcapng_encode_u16(block, len, 0); /* minor version number */
+    len = pcapng_encode_u32(block, len, UINT32_MAX);
+    len = pcapng_encode_u32(block, len, UINT32_MAX);
+    len = pcapng_encode_u32(block, len, 28);
+    (void)data_write_header(block, len, 1);
+    /* interface description block, with nanosecond timestamps */
+    len = pcapng_encode_u32(block, 0, PCAPNG_INTERFACE_DESCRIPTION_BLOCK);
+    len = pcapng_encode_u32(block, len, 32);
+    len = pcapng_encode_u16(block, len, DLT_BACNET_MS_TP);
+    len = pcapng_encode_u16(block, len, 0); /* reserved */
+    len = pcapng_encode_u32(block, len, 65535); /* snaplen */
+    len = pcapng_encode_u16(block, len, 9); /* if_tsresol option */
+    len = pcapng_encode_u16(block, len, 1);
+    block[len] = 9; /* 10^-9 seconds, and 3 octets of padding */
+    len += 4;
+    len = pcapng_encode_u32(block, len, 0); /* opt_endofopt */
+    len = pcapng_encode_u32(block, len, 32);
+    (void)data_write_header(block, len, 1);
+    File_Octets += 28 + 32;
+    if (File_Handle) {
+        fflush(File_Handle);
+    }
 }
 
+/* queue the frame as a pcapng enhanced packet block for the writer */
 static void
 write_received_packet(struct mstp_port_struct_t *mstp_port, size_t header_len)
 {
-    uint32_t ts_sec = 0; /* timestamp seconds */
-    uint32_t ts_usec = 0; /* timestamp microseconds */
+    static uint8_t block[PCAPNG_PACKET_MAX];
+    uint64_t ts_ns = 0; /* timestamp nanoseconds */
     uint32_t incl_len = 0; /* number of octets of packet saved in file */
     uint32_t orig_len = 0; /* actual length of packet */
     uint32_t data_crc_len = 2;
-    uint8_t header[MSTP_HEADER_MAX] = { 0 }; /* MS/TP header */
+    uint8_t *header; /* MS/TP header */
     struct timeval tv;
     size_t max_data = 0;
+    unsigned len = 0;
 
-    gettimeofday(&tv, NULL);
-    ts_sec = tv.tv_sec;
-    ts_usec = tv.tv_usec;
+    ts_ns = capture_time_ns();
+    capture_time_timeval(ts_ns, &tv);
     if (mstp_port->ReceivedValidFrame) {
         packet_statistics(&tv, mstp_port);
     }
-    (void)data_write(&ts_sec, sizeof(ts_sec), 1);
-    (void)data_write(&ts_usec, sizeof(ts_usec), 1);
     if (mstp_port->ReceivedInvalidFrame) {
         if (mstp_port->Index) {
             max_data = min(mstp_port->InputBufferSize, mstp_port->Index);
@@ -656,8 +994,13 @@ write_received_packet(struct mstp_port_struct_t *mstp_port, size_t header_len)
             incl_len = orig_len = header_len;
         }
     }
-    (void)data_write(&incl_len, sizeof(incl_len), 1);
-    (void)data_write(&orig_len, sizeof(orig_len), 1);
+    if (!mstp_port->ReceivedValidFrame &&
+        !mstp_port->ReceivedValidFrameNotForUs) {
+        Frame_Time_Usec = timeval_usec(&tv);
+        mstpstat_invalid_frame(&MSTP_Analyzer, Frame_Time_Usec, orig_len);
+    }
+    /* the captured octets come after the block header */
+    header = &block[28];
     if (header_len == 1) {
         header[0] = mstp_port->DataRegister;
     } else if (header_len == 2) {
@@ -673,15 +1016,166 @@ write_received_packet(struct mstp_port_struct_t *mstp_port, size_t header_len)
         header[6] = LO_BYTE(mstp_port->DataLength);
         header[7] = mstp_port->HeaderCRCActual;
     }
-    (void)data_write(header, header_len, 1);
+    len = 28 + header_len;
     if (max_data) {
-        (void)data_write(mstp_port->InputBuffer, max_data, 1);
-        (void)data_write((char *)&mstp_port->DataCRCActualMSB, 1, 1);
-        (void)data_write((char *)&mstp_port->DataCRCActualLSB, 1, 1);
+        memcpy(&block[len], mstp_port->InputBuffer, max_data);
+        len += max_data;
+        block[len++] = mstp_port->DataCRCActualMSB;
+        block[len++] = mstp_port->DataCRCActualLSB;
+    }
+    /* the recorded lengths are kept, as in the libpcap format */
+    len = 28 + incl_len;
+    while (len % 4) {
+        block[len++] = 0;
+    }
+    len = pcapng_encode_u32(block, len, len + 4);
+    (void)pcapng_encode_u32(block, 0, PCAPNG_ENHANCED_PACKET_BLOCK);
+    (void)pcapng_encode_u32(block, 4, len);
+    (void)pcapng_encode_u32(block, 8, 0); /* interface */
+    (void)pcapng_encode_u32(block, 12, (uint32_t)(ts_ns >> 32));
+    (void)pcapng_encode_u32(block, 16, (uint32_t)ts_ns);
+    (void)pcapng_encode_u32(block, 20, incl_len);
+    (void)pcapng_encode_u32(block, 24, orig_len);
+    if (!FIFO_Add(&Capture_Queue, block, len)) {
+        Capture_Dropped_Count++;
+    }
+}
+
+/* create a new file when the current file reaches a rotation limit */
+static void capture_file_rotate(void)
+{
+    bool rotate = false;
+
+    if (Wireshark_Capture) {
+        return;
+    }
+    if (Rotate_Packets && (File_Packets >= Rotate_Packets)) {
+        rotate = true;
+    }
+    if (Rotate_Octets && (File_Octets >= Rotate_Octets)) {
+        rotate = true;
+    }
+    if (Rotate_Seconds &&
+        (difftime(time(NULL), File_Created) >= (double)Rotate_Seconds)) {
+        rotate = true;
+    }
+    if (rotate) {
+        filename_create_new();
+        write_global_header();
+    }
+}
+
+/* write the queued blocks to the file or pipe until the capture stops */
+static void capture_writer_task(void)
+{
+    static uint8_t block[PCAPNG_PACKET_MAX];
+    uint32_t block_len = 0;
+
+    while (Capture_Writer_Running || !FIFO_Empty(&Capture_Queue)) {
+        /* each block is queued whole, so its length is enough */
+        if (FIFO_Peek_Ahead(&Capture_Queue, block, 8) == 8) {
+            block_len = pcapng_decode_u32(&block[4]);
+            (void)FIFO_Pull(&Capture_Queue, block, block_len);
+            capture_file_rotate();
+            (void)data_write(block, block_len, 1);
+            File_Packets++;
+            File_Octets += block_len;
+        } else {
+            /* nothing to write, so hand the buffered blocks over */
+            if (File_Handle) {
+                fflush(File_Handle);
+            }
+#if defined(_WIN32)
+            Sleep(10);
+#else
+            usleep(10000);
+#endif
+        }
+    }
+    if (File_Handle) {
+        fflush(File_Handle);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI capture_writer_thread(LPVOID arg)
+{
+    (void)arg;
+    capture_writer_task();
+
+    return 0;
+}
+#else
+static void *capture_writer_thread(void *arg)
+{
+    (void)arg;
+    capture_writer_task();
+
+    return NULL;
+}
+#endif
+
+/* start the thread that writes the captured frames */
+static bool capture_writer_start(void)
+{
+    FIFO_Init(&Capture_Queue, Capture_Queue_Data, sizeof(Capture_Queue_Data));
+    Capture_Writer_Running = true;
+#if defined(_WIN32)
+    Capture_Writer_Thread =
+        CreateThread(NULL, 0, capture_writer_thread, NULL, 0, NULL);
+    if (Capture_Writer_Thread == NULL) {
+        Capture_Writer_Running = false;
+    }
+#else
+    if (pthread_create(
+            &Capture_Writer_Thread, NULL, capture_writer_thread, NULL) != 0) {
+        Capture_Writer_Running = false;
+    }
+#endif
+
+    return Capture_Writer_Running;
+}
+
+/* stop the writer thread after it writes the queued frames */
+static void capture_writer_stop(void)
+{
+    if (Capture_Writer_Running) {
+        Capture_Writer_Running = false;
+#if defined(_WIN32)
+        WaitForSingleObject(Capture_Writer_Thread, INFINITE);
+        CloseHandle(Capture_Writer_Thread);
+#else
+        pthread_join(Capture_Writer_Thread, NULL);
+#endif
+    }
+}
+
+/* read the rest of a pcapng section header block, after its type */
+static bool read_pcapng_section(void)
+{
+    uint32_t block_len = 0;
+    uint32_t byte_order = 0;
+
+    if ((fread(&block_len, sizeof(block_len), 1, File_Handle) != 1) ||
+        (fread(&byte_order, sizeof(byte_order), 1, File_Handle) != 1)) {
+        fprintf(stderr, "mstpcap: unable to read section header\n");
+        return false;
+    }
+    if (byte_order != PCAPNG_BYTE_ORDER_MAGIC) {
+        fprintf(stderr, "mstpcap: unsupported byte order\n");
+        return false;
+    }
+    if ((block_len < 28) || (block_len % 4) ||
+        (fseek(File_Handle, (long)(block_len - 12), SEEK_CUR) != 0)) {
+        fprintf(stderr, "mstpcap: invalid section header\n");
+        return false;
     }
+    Scan_Interface_Count = 0;
+
+    return true;
 }
 
-/* read header from file in libpcap format */
+/* read header from file in libpcap or pcapng format */
 static bool test_global_header(const char *filename)
 {
     uint32_t magic_number = 0; /* magic number */
@@ -697,6 +1191,15 @@ static bool test_global_header(const char *filename)
     File_Handle = fopen(filename, "rb");
     if (File_Handle) {
         count = fread(&magic_number, sizeof(magic_number), 1, File_Handle);
+        if ((count == 1) && (magic_number == PCAPNG_SECTION_HEADER_BLOCK)) {
+            Scan_Pcapng = true;
+            if (!read_pcapng_section()) {
+                fclose(File_Handle);
+                File_Handle = NULL;
+                return false;
+            }
+            return true;
+        }
         if ((count != 1) || (magic_number != 0xa1b2c3d4)) {
             fprintf(stderr, "mstpcap: invalid magic number\n");
             fclose(File_Handle);
@@ -755,94 +1258,217 @@ static bool test_global_header(const char *filename)
     return true;
 }
 
-static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
+/* convert a pcapng timestamp with an interface resolution */
+static uint64_t pcapng_time_ns(uint64_t timestamp, uint8_t resolution)
+{
+    unsigned exponent = resolution & 0x7F;
+
+    if (resolution & 0x80) {
+        /* units of a negative power of two */
+        if (exponent > 32) {
+            timestamp >>= (exponent - 32);
+            exponent = 32;
+        }
+        return ((timestamp >> exponent) * 1000000000ULL) +
+            (((timestamp & ((1ULL << exponent) - 1)) * 1000000000ULL) >>
+             exponent);
+    }
+    /* units of a negative power of ten */
+    while (exponent < 9) {
+        timestamp *= 10;
+        exponent++;
+    }
+    while (exponent > 9) {
+        timestamp /= 10;
+        exponent--;
+    }
+
+    return timestamp;
+}
+
+/* read the interface of a pcapng interface description block */
+static void read_pcapng_interface(const uint8_t *block, uint32_t block_len)
+{
+    uint32_t offset = 8;
+    uint16_t code, len;
+    /* microseconds, unless the if_tsresol option is given */
+    uint8_t resolution = 6;
+
+    if (block_len < 8) {
+        return;
+    }
+    while ((offset + 4) <= block_len) {
+        code = pcapng_decode_u16(&block[offset]);
+        len = pcapng_decode_u16(&block[offset + 2]);
+        if ((code == 0) || ((offset + 4 + len) > block_len)) {
+            break;
+        }
+        if ((code == 9) && (len == 1)) {
+            resolution = block[offset + 4];
+        }
+        offset += 4 + ((len + 3U) & ~3U);
+    }
+    if (Scan_Interface_Count < PCAPNG_INTERFACE_MAX) {
+        Scan_Link_Type[Scan_Interface_Count] = pcapng_decode_u16(&block[0]);
+        Scan_Ts_Resolution[Scan_Interface_Count] = resolution;
+    }
+    Scan_Interface_Count++;
+}
+
+/* read the next MS/TP frame of a pcapng file */
+static bool read_pcapng_record(
+    uint64_t *ts_ns,
+    uint8_t *frame,
+    uint32_t frame_size,
+    uint32_t *incl_len,
+    uint32_t *orig_len)
+{
+    static uint8_t block[PCAPNG_BLOCK_MAX];
+    uint32_t block_type = 0;
+    uint32_t block_len = 0;
+    uint32_t interface = 0;
+    uint64_t timestamp = 0;
+
+    for (;;) {
+        if (fread(&block_type, sizeof(block_type), 1, File_Handle) != 1) {
+            return false;
+        }
+        if (block_type == PCAPNG_SECTION_HEADER_BLOCK) {
+            if (!read_pcapng_section()) {
+                return false;
+            }
+            continue;
+        }
+        if ((fread(&block_len, sizeof(block_len), 1, File_Handle) != 1) ||
+            (block_len < 12) || (block_len % 4)) {
+            return false;
+        }
+        /* the body and the trailing block length */
+        block_len -= 8;
+        if (block_len > sizeof(block)) {
+            if (fseek(File_Handle, (long)block_len, SEEK_CUR) != 0) {
+                return false;
+            }
+            continue;
+        }
+        if (fread(block, block_len, 1, File_Handle) != 1) {
+            return false;
+        }
+        if (block_type == PCAPNG_INTERFACE_DESCRIPTION_BLOCK) {
+            read_pcapng_interface(block, block_len - 4);
+        } else if (
+            (block_type == PCAPNG_ENHANCED_PACKET_BLOCK) &&
+            (block_len >= 24)) {
+            interface = pcapng_decode_u32(&block[0]);
+            if ((interface >= Scan_Interface_Count) ||
+                (interface >= PCAPNG_INTERFACE_MAX) ||
+                (Scan_Link_Type[interface] != DLT_BACNET_MS_TP)) {
+                continue;
+            }
+            timestamp = pcapng_decode_u32(&block[4]);
+            timestamp = (timestamp << 32) | pcapng_decode_u32(&block[8]);
+            *ts_ns =
+                pcapng_time_ns(timestamp, Scan_Ts_Resolution[interface]);
+            *incl_len = pcapng_decode_u32(&block[12]);
+            *orig_len = pcapng_decode_u32(&block[16]);
+            if (*incl_len > (block_len - 24)) {
+                return false;
+            }
+            if (*incl_len > frame_size) {
+                *incl_len = frame_size;
+            }
+            memcpy(frame, &block[20], *incl_len);
+            return true;
+        }
+    }
+}
+
+/* read the next MS/TP frame of a libpcap file */
+static bool read_pcap_record(
+    uint64_t *ts_ns,
+    uint8_t *frame,
+    uint32_t frame_size,
+    uint32_t *incl_len,
+    uint32_t *orig_len)
 {
     uint32_t ts_sec = 0; /* timestamp seconds */
     uint32_t ts_usec = 0; /* timestamp microseconds */
+    uint32_t skip_len = 0;
+
+    if ((fread(&ts_sec, sizeof(ts_sec), 1, File_Handle) != 1) ||
+        (fread(&ts_usec, sizeof(ts_usec), 1, File_Handle) != 1) ||
+        (fread(incl_len, sizeof(*incl_len), 1, File_Handle) != 1) ||
+        (fread(orig_len, sizeof(*orig_len), 1, File_Handle) != 1)) {
+        return false;
+    }
+    *ts_ns = (uint64_t)ts_sec * 1000000000ULL + (uint64_t)ts_usec * 1000ULL;
+    if (*incl_len > frame_size) {
+        skip_len = *incl_len - frame_size;
+        *incl_len = frame_size;
+    }
+    if (*incl_len && (fread(frame, *incl_len, 1, File_Handle) != 1)) {
+        return false;
+    }
+    if (skip_len && (fseek(File_Handle, (long)skip_len, SEEK_CUR) != 0)) {
+        return false;
+    }
+
+    return true;
+}
+
+static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
+{
+    static uint8_t frame[MSTP_FRAME_MAX];
+    uint64_t ts_ns = 0; /* timestamp nanoseconds */
     uint32_t incl_len = 0; /* number of octets of packet saved in file */
     uint32_t orig_len = 0; /* actual length of packet */
-    uint8_t header[8] = { 0 }; /* MS/TP header */
     struct timeval tv;
-    size_t count = 0;
+    bool status = false;
     unsigned i = 0;
 
     if (File_Handle) {
-        count = fread(&ts_sec, sizeof(ts_sec), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        count = fread(&ts_usec, sizeof(ts_usec), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
-        }
-        tv.tv_sec = ts_sec;
-        tv.tv_usec = ts_usec;
-        count = fread(&incl_len, sizeof(incl_len), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
+        if (Scan_Pcapng) {
+            status = read_pcapng_record(
+                &ts_ns, frame, sizeof(frame), &incl_len, &orig_len);
+        } else {
+            status = read_pcap_record(
+                &ts_ns, frame, sizeof(frame), &incl_len, &orig_len);
         }
-        count = fread(&orig_len, sizeof(orig_len), 1, File_Handle);
-        if (count != 1) {
+        if (!status) {
             fclose(File_Handle);
             File_Handle = NULL;
             return false;
         }
-        count = fread(&header, sizeof(header), 1, File_Handle);
-        if (count != 1) {
-            fclose(File_Handle);
-            File_Handle = NULL;
-            return false;
+        capture_time_timeval(ts_ns, &tv);
+        if (incl_len < MSTP_HEADER_MAX) {
+            /* a partial header is an invalid frame */
+            memset(&frame[incl_len], 0, MSTP_HEADER_MAX - incl_len);
         }
-        mstp_port->FrameType = header[2];
-        mstp_port->DestinationAddress = header[3];
-        mstp_port->SourceAddress = header[4];
-        mstp_port->DataLength = MAKE_WORD(header[6], header[5]);
-        mstp_port->HeaderCRCActual = header[7];
+        mstp_port->FrameType = frame[2];
+        mstp_port->DestinationAddress = frame[3];
+        mstp_port->SourceAddress = frame[4];
+        mstp_port->DataLength = MAKE_WORD(frame[6], frame[5]);
+        mstp_port->HeaderCRCActual = frame[7];
         mstp_port->HeaderCRC = 0xFF;
         for (i = 2; i < 8; i++) {
             mstp_port->HeaderCRC =
-                CRC_Calc_Header(header[i], mstp_port->HeaderCRC);
+                CRC_Calc_Header(frame[i], mstp_port->HeaderCRC);
         }
         if (mstp_port->HeaderCRC == 0x55) {
             mstp_port->ReceivedValidFrame = true;
             mstp_port->ReceivedInvalidFrame = false;
-            if (mstp_port->DataLength == 0) {
-                mstp_port->ReceivedValidFrame = true;
-            }
         } else {
             mstp_port->ReceivedValidFrame = false;
             mstp_port->ReceivedInvalidFrame = true;
         }
-        if (orig_len > 8) {
+        if (incl_len >= (MSTP_HEADER_MAX + 2)) {
             /* packet includes data */
-            mstp_port->DataLength = orig_len - 8 - 2;
-            count = fread(
-                mstp_port->InputBuffer, mstp_port->DataLength, 1, File_Handle);
-            if (count != 1) {
-                fclose(File_Handle);
-                File_Handle = NULL;
-                return false;
-            }
-            count =
-                fread((char *)&mstp_port->DataCRCActualMSB, 1, 1, File_Handle);
-            if (count != 1) {
-                fclose(File_Handle);
-                File_Handle = NULL;
-                return false;
-            }
-            count =
-                fread((char *)&mstp_port->DataCRCActualLSB, 1, 1, File_Handle);
-            if (count != 1) {
-                fclose(File_Handle);
-                File_Handle = NULL;
-                return false;
-            }
+            mstp_port->DataLength = incl_len - MSTP_HEADER_MAX - 2;
+            memcpy(
+                mstp_port->InputBuffer, &frame[MSTP_HEADER_MAX],
+                mstp_port->DataLength);
+            mstp_port->DataCRCActualMSB = frame[incl_len - 2];
+            mstp_port->DataCRCActualLSB = frame[incl_len - 1];
             mstp_port->DataCRC = 0xFFFF;
             for (i = 0; i < mstp_port->DataLength; i++) {
                 mstp_port->DataCRC = CRC_Calc_Data(
@@ -860,10 +1486,17 @@ static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
                 mstp_port->ReceivedValidFrame = false;
             }
         } else {
+            if (incl_len > MSTP_HEADER_MAX) {
+                /* data without its CRC */
+                mstp_port->ReceivedInvalidFrame = true;
+                mstp_port->ReceivedValidFrame = false;
+            }
             mstp_port->DataLength = 0;
         }
         if (mstp_port->ReceivedInvalidFrame) {
             Invalid_Frame_Count++;
+            Frame_Time_Usec = timeval_usec(&tv);
+            mstpstat_invalid_frame(&MSTP_Analyzer, Frame_Time_Usec, orig_len);
         } else if (mstp_port->ReceivedValidFrame) {
             packet_statistics(&tv, mstp_port);
         }
@@ -876,6 +1509,8 @@ static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
 
 static void cleanup(void)
 {
+    /* write the frames that are still queued */
+    capture_writer_stop();
     if (!Wireshark_Capture) {
         packet_statistics_print();
     }
@@ -930,6 +1565,8 @@ static void print_usage(const char *filename)
     printf(" [--extcap-interface port]\n");
     printf(" [--extcap-interfaces][--extcap-dlts][--extcap-config]\n");
     printf(" [--capture][--baud baud][--fifo pipe]\n");
+    printf(" [--analyze seconds]\n");
+    printf(" [--rotate-size megabytes][--rotate-time seconds]\n");
     printf(" [--version][--help]\n");
 }
 
@@ -942,8 +1579,10 @@ static void print_help(const char *filename)
     printf("\n");
     printf("Captures MS/TP packets from a serial interface\n"
            "and writes them to a file or a pipe, or scans a file for stats."
-           "Filename is of the form mstp_20090123091200.cap (timestamp).\n"
-           "New files are created after receiving 65535 packets.\n");
+           "Filename is of the form mstp_20090123091200.pcapng (timestamp).\n"
+           "New files are created after receiving 65535 packets,\n"
+           "or at the --rotate-size or --rotate-time limits.\n"
+           "Old libpcap .cap files can still be scanned.\n");
     printf("\n");
     printf("Command line options:\n"
            "[--extcap-interface port] - serial interface.\n"
@@ -962,6 +1601,15 @@ static void print_help(const char *filename)
            "    Supported values: any file name\n"
 #endif
            "    Use that name as the interface name in Wireshark.\n");
+    printf("[--analyze seconds] - print the token rotation, utilization,\n"
+           "    and Poll For Master overhead of the trunk after each\n"
+           "    interval of seconds, during a capture or a scan.\n"
+           "    The baud rate of a scan is given with --baud.\n");
+    printf("[--rotate-size megabytes] - create a new file when the file\n"
+           "    reaches this size, rather than after 65535 packets.\n"
+           "[--rotate-time seconds] - create a new file when the file\n"
+           "    is this old, at least 60 seconds, rather than after\n"
+           "    65535 packets.\n");
     printf("\n");
     printf(
         "%s [--extcap-interfaces][--extcap-dlts][--extcap-config]\n"
@@ -1001,6 +1649,9 @@ int main(int argc, char *argv[])
     uint32_t header_len = 0;
     int argi = 0;
     const char *filename = NULL;
+    const char *scan_filename = NULL;
+    MSTPSTAT_SAMPLE sample = { 0 };
+    struct timeval tv;
 
     MSTP_Port.InputBuffer = &RxBuffer[0];
     MSTP_Port.InputBufferSize = sizeof(RxBuffer);
@@ -1014,7 +1665,6 @@ int main(int argc, char *argv[])
     /* mimic our pointer in the state machine */
     mstp_port = &MSTP_Port;
     MSTP_Init(mstp_port);
-    packet_statistics_clear();
     /* decode any command line parameters */
     filename = filename_remove_path(argv[0]);
     for (argi = 1; argi < argc; argi++) {
@@ -1038,21 +1688,22 @@ int main(int argc, char *argv[])
                 printf("An file name must be provided.\n");
                 return 1;
             }
-            printf("Scanning %s\n", argv[argi]);
-            /* perform statistics on the file */
-            if (test_global_header(argv[argi])) {
-                while (read_received_packet(mstp_port)) {
-                    packet_count++;
-                    fprintf(stderr, "\r%u packets", (unsigned)packet_count);
-                }
-                if (packet_count) {
-                    packet_statistics_print();
-                }
-                Exit_Requested = true;
-            } else {
-                fprintf(stderr, "File header does not match.\n");
+            /* scan after the other options, which set the analysis */
+            scan_filename = argv[argi];
+        }
+        if (strcmp(argv[argi], "--analyze") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("An interval must be provided.\n");
+                return 1;
+            }
+            Analyze_Interval_Seconds = strtoul(argv[argi], NULL, 0);
+            if ((Analyze_Interval_Seconds < 1) ||
+                (Analyze_Interval_Seconds > 3600)) {
+                printf("The interval must be 1 to 3600 seconds.\n");
                 return 1;
             }
+            Analyze_Samples = true;
         }
         if (strcmp(argv[argi], "--extcap-interfaces") == 0) {
             RS485_Print_Ports();
@@ -1128,6 +1779,34 @@ int main(int argc, char *argv[])
             }
             my_baud = strtol(argv[argi], NULL, 0);
             RS485_Set_Baud_Rate(my_baud);
+            Analyze_Baud = (uint32_t)my_baud;
+        }
+        if (strcmp(argv[argi], "--rotate-size") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A size in megabytes must be provided.\n");
+                return 1;
+            }
+            Rotate_Octets = strtoul(argv[argi], NULL, 0);
+            if (Rotate_Octets < 1) {
+                printf("The size must be at least 1 megabyte.\n");
+                return 1;
+            }
+            Rotate_Octets *= 1024UL * 1024UL;
+            Rotate_Packets = 0;
+        }
+        if (strcmp(argv[argi], "--rotate-time") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A time in seconds must be provided.\n");
+                return 1;
+            }
+            Rotate_Seconds = strtoul(argv[argi], NULL, 0);
+            if (Rotate_Seconds < 60) {
+                printf("The time must be at least 60 seconds.\n");
+                return 1;
+            }
+            Rotate_Packets = 0;
         }
         if (strcmp(argv[argi], "--fifo") == 0) {
             argi++;
@@ -1138,6 +1817,30 @@ int main(int argc, char *argv[])
             named_pipe_create(argv[argi]);
         }
     }
+    packet_statistics_clear();
+    if (scan_filename) {
+        printf("Scanning %s\n", scan_filename);
+        /* perform statistics on the file */
+        if (!test_global_header(scan_filename)) {
+            fprintf(stderr, "File header does not match.\n");
+            return 1;
+        }
+        while (read_received_packet(mstp_port)) {
+            packet_count++;
+            if (Analyze_Samples &&
+                mstpstat_sample_ready(&MSTP_Analyzer, Frame_Time_Usec)) {
+                (void)mstpstat_sample_take(
+                    &MSTP_Analyzer, Frame_Time_Usec, &sample);
+                analyzer_sample_print(&sample);
+            } else if (!Analyze_Samples) {
+                fprintf(stderr, "\r%u packets", (unsigned)packet_count);
+            }
+        }
+        if (packet_count) {
+            packet_statistics_print();
+        }
+        return 0;
+    }
     if (Exit_Requested) {
         return 0;
     }
@@ -1148,6 +1851,8 @@ int main(int argc, char *argv[])
     atexit(cleanup);
     RS485_Initialize();
     mstimer_init();
+    Analyze_Baud = (uint32_t)RS485_Get_Baud_Rate();
+    mstimer_set(&Analyze_Timer, Analyze_Interval_Seconds * 1000UL);
     if (!Wireshark_Capture) {
         fprintf(
             stdout, "mstpcap: Using %s for capture at %ld bps.\n",
@@ -1161,6 +1866,10 @@ int main(int argc, char *argv[])
 #endif
     filename_create_new();
     write_global_header();
+    if (!capture_writer_start()) {
+        fprintf(stderr, "mstpcap: unable to start the writer thread\n");
+        return 1;
+    }
     /* run forever */
     for (;;) {
         RS485_Check_UART_Data(mstp_port);
@@ -1206,18 +1915,26 @@ int main(int argc, char *argv[])
                 Invalid_Frame_Count++;
             }
         }
+        if (!Wireshark_Capture && Analyze_Samples &&
+            mstimer_expired(&Analyze_Timer)) {
+            mstimer_restart(&Analyze_Timer);
+            gettimeofday(&tv, NULL);
+            if (mstpstat_sample_take(
+                    &MSTP_Analyzer, timeval_usec(&tv), &sample)) {
+                analyzer_sample_print(&sample);
+            }
+        }
         if (!Wireshark_Capture) {
-            if (!(packet_count % 100)) {
+            if (!Analyze_Samples && !(packet_count % 100)) {
                 fprintf(
                     stdout, "\r%u packets, %u invalid frames",
                     (unsigned)packet_count, (unsigned)Invalid_Frame_Count);
                 fflush(stdout);
             }
             if (packet_count >= 65535) {
+                /* the writer thread creates the new files */
                 packet_statistics_print();
                 packet_statistics_clear();
-                filename_create_new();
-                write_global_header();
                 packet_count = 0;
             }
         }
@@ -0,0 +1,801 @@
+/**
+ * @file
+ * @brief command line tool that runs the MS/TP state machines of many
+ * master and slave nodes against one simulated RS-485 wire, with a
+ * synthetic load, and prints the token rotation time, the throughput
+ * and the latency of the data frames.
+ *
+ * Usage:
+ * $ ./mstpsim [--masters N][--slaves N][--baud N][--time seconds]
+ *
+ * The simulation runs in virtual time, one octet time per step, so the
+ * results do not depend on the speed of the host.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/version.h"
+#include "bacnet/datalink/dlmstp.h"
+#include "bacnet/datalink/mstp.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "bacnet/basic/sys/fifo.h"
+#include "bacnet/basic/sys/filename.h"
+
+/* the largest frame: header, data, and data CRC */
+#define SIM_FRAME_MAX (8 + DLMSTP_MPDU_MAX + 2)
+/* number of PDUs that wait in the transmit queue of a node */
+#define SIM_QUEUE_MAX 64
+/* number of frames that can be on the wire, one after another */
+#define SIM_WIRE_FRAMES 4
+/* octets received by a node before its receive state machine runs */
+#define SIM_RECEIVE_FIFO 512
+/* latency histograms: 0.1 millisecond buckets up to 100 milliseconds,
+   then 1 millisecond buckets up to 60 seconds, the last one overflows */
+#define SIM_FINE_BUCKET_NS 100000ULL
+#define SIM_FINE_BUCKETS 1000
+#define SIM_BUCKET_NS 1000000ULL
+#define SIM_BUCKETS (SIM_FINE_BUCKETS + 59900)
+/* address of the first slave node */
+#define SIM_SLAVE_ADDRESS 128
+/* nanoseconds */
+#define NS_PER_MS 1000000ULL
+#define NS_PER_S 1000000000ULL
+
+struct sim_node {
+    struct mstp_port_struct_t port;
+    uint8_t input[DLMSTP_MPDU_MAX];
+    uint8_t output[SIM_FRAME_MAX];
+    FIFO_BUFFER receive;
+    FIFO_DATA_STORE(receive_data, SIM_RECEIVE_FIFO);
+    /* time of the last silence timer reset */
+    uint64_t silence_time;
+    /* the node transmits until this time */
+    uint64_t busy_time;
+    /* queue times of the PDUs that wait to be sent */
+    uint64_t queue_time[SIM_QUEUE_MAX];
+    unsigned queue_head;
+    unsigned queue_count;
+    uint64_t arrival_time;
+    /* queue time of the PDU in the output buffer */
+    bool sending;
+    uint64_t sending_time;
+    /* queue time of the request that waits for a reply */
+    bool request;
+    uint64_t request_time;
+    /* time that the node last received the token */
+    bool token;
+    uint64_t token_time;
+    /* next slave that a request is sent to */
+    unsigned slave;
+    /* a slave has a request from this master to answer */
+    bool reply;
+    uint8_t reply_station;
+};
+
+struct sim_frame {
+    struct sim_node *sender;
+    /* time of the first bit of the frame */
+    uint64_t start_time;
+    uint16_t length;
+    uint16_t delivered;
+    /* queue time of the PDU of a data frame */
+    bool timed;
+    uint64_t queue_time;
+    uint8_t data[SIM_FRAME_MAX];
+};
+
+struct sim_histogram {
+    uint32_t bucket[SIM_BUCKETS];
+    unsigned long count;
+    uint64_t sum;
+    uint64_t max;
+};
+
+/* simulation settings */
+static unsigned Masters = 4;
+static unsigned Slaves = 0;
+static uint32_t Baud_Rate = 38400;
+static unsigned Turnaround_Bits = 40;
+static double Noise = 0.0;
+static unsigned Seconds = 60;
+static unsigned Warmup_Seconds = 5;
+static double Load_Rate = 10.0;
+static unsigned Payload_Size = 50;
+static unsigned Max_Info_Frames = DEFAULT_MAX_INFO_FRAMES;
+static unsigned Max_Master = DEFAULT_MAX_MASTER;
+static unsigned Adaptive_Max_Info_Frames = 0;
+static uint32_t Seed = 1;
+/* simulation state */
+static struct sim_node
+    Nodes[DEFAULT_MAX_MASTER + 1 + MSTP_BROADCAST_ADDRESS - SIM_SLAVE_ADDRESS];
+static unsigned Node_Count;
+static struct sim_node *Node_Address[MSTP_BROADCAST_ADDRESS + 1];
+static struct sim_frame Wire[SIM_WIRE_FRAMES];
+static unsigned Wire_Head;
+static unsigned Wire_Count;
+/* the end of the last frame that is on the wire */
+static uint64_t Wire_Idle_Time;
+static uint64_t Now;
+static uint64_t Octet_Time;
+static uint64_t Warmup_Time;
+static uint8_t Payload[DLMSTP_MPDU_MAX];
+/* statistics */
+static struct sim_histogram Token_Rotation;
+static struct sim_histogram Queue_Latency;
+static struct sim_histogram Reply_Latency;
+static unsigned long Frames;
+static unsigned long Data_Frames;
+static unsigned long long Data_Octets;
+static uint64_t Busy_Time;
+static unsigned long Invalid_Frames;
+static unsigned long Lost_Tokens;
+static unsigned long Overlaps;
+static unsigned long Dropped;
+static unsigned long Overruns;
+
+/**
+ * @brief Get a pseudo-random number, the same sequence for each seed
+ * @return pseudo-random number
+ */
+static uint32_t sim_random(void)
+{
+    /* xorshift32 */
+    Seed ^= Seed << 13;
+    Seed ^= Seed >> 17;
+    Seed ^= Seed << 5;
+
+    return Seed;
+}
+
+/**
+ * @brief Get a pseudo-random number from 0 up to 1
+ * @return pseudo-random number
+ */
+static double sim_random_unit(void)
+{
+    return (double)sim_random() / 4294967296.0;
+}
+
+static bool sim_statistics(void)
+{
+    return Now >= Warmup_Time;
+}
+
+/**
+ * @brief Get the upper edge of a histogram bucket
+ * @param index - bucket index
+ * @return upper edge of the bucket, in nanoseconds
+ */
+static uint64_t sim_bucket_edge(uint64_t index)
+{
+    if (index < SIM_FINE_BUCKETS) {
+        return (index + 1) * SIM_FINE_BUCKET_NS;
+    }
+
+    return (SIM_FINE_BUCKETS * SIM_FINE_BUCKET_NS) +
+        ((index - SIM_FINE_BUCKETS + 1) * SIM_BUCKET_NS);
+}
+
+static void sim_histogram_add(struct sim_histogram *histogram, uint64_t value)
+{
+    uint64_t index;
+
+    index = value / SIM_FINE_BUCKET_NS;
+    if (index >= SIM_FINE_BUCKETS) {
+        index = SIM_FINE_BUCKETS +
+            ((value - (SIM_FINE_BUCKETS * SIM_FINE_BUCKET_NS)) /
+             SIM_BUCKET_NS);
+    }
+    if (index >= SIM_BUCKETS) {
+        index = SIM_BUCKETS - 1;
+    }
+    histogram->bucket[index]++;
+    histogram->count++;
+    histogram->sum += value;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+/**
+ * @brief Get the value below which a part of the samples are
+ * @param histogram - the samples
+ * @param percent - part of the samples, 0..100
+ * @return the upper edge of the bucket, in milliseconds
+ */
+static double
+sim_histogram_percentile(const struct sim_histogram *histogram, double percent)
+{
+    unsigned long count = 0;
+    double target;
+    unsigned i;
+
+    target = (histogram->count * percent) / 100.0;
+    for (i = 0; i < SIM_BUCKETS; i++) {
+        count += histogram->bucket[i];
+        if ((count > 0) && (count >= target)) {
+            break;
+        }
+    }
+    if ((i == (SIM_BUCKETS - 1)) || (sim_bucket_edge(i) > histogram->max)) {
+        return (double)histogram->max / NS_PER_MS;
+    }
+
+    return (double)sim_bucket_edge(i) / NS_PER_MS;
+}
+
+static void
+sim_histogram_print(const char *name, const struct sim_histogram *histogram)
+{
+    if (histogram->count == 0) {
+        printf("%-20s no samples\n", name);
+        return;
+    }
+    printf(
+        "%-20s %8lu %9.1f %9.1f %9.1f %9.1f %9.1f\n", name, histogram->count,
+        ((double)histogram->sum / histogram->count) / NS_PER_MS,
+        sim_histogram_percentile(histogram, 50.0),
+        sim_histogram_percentile(histogram, 90.0),
+        sim_histogram_percentile(histogram, 99.0),
+        (double)histogram->max / NS_PER_MS);
+}
+
+/**
+ * @brief The silence timer of a node, which counts from the end of its
+ *  own transmission while it transmits
+ * @param pArg - the MS/TP port of the node
+ * @return milliseconds of silence
+ */
+static uint32_t sim_silence_timer(void *pArg)
+{
+    struct mstp_port_struct_t *mstp_port = pArg;
+    struct sim_node *node = mstp_port->UserData;
+    uint64_t start;
+
+    start = node->silence_time;
+    if (node->busy_time > start) {
+        start = node->busy_time;
+    }
+    if (Now <= start) {
+        return 0;
+    }
+
+    return (uint32_t)((Now - start) / NS_PER_MS);
+}
+
+static void sim_silence_timer_reset(void *pArg)
+{
+    struct mstp_port_struct_t *mstp_port = pArg;
+    struct sim_node *node = mstp_port->UserData;
+
+    node->silence_time = Now;
+}
+
+/**
+ * @brief Put a frame on the wire, after the frame that is on it and after
+ *  the turnaround time
+ * @param mstp_port port specific context data
+ * @param buffer pointer to the frame data
+ * @param nbytes number of bytes to send
+ */
+void MSTP_Send_Frame(
+    struct mstp_port_struct_t *mstp_port,
+    const uint8_t *buffer,
+    uint16_t nbytes)
+{
+    struct sim_node *node = mstp_port->UserData;
+    struct sim_frame *frame;
+    uint64_t start_time;
+
+    if ((nbytes == 0) || (nbytes > SIM_FRAME_MAX) ||
+        (Wire_Count >= SIM_WIRE_FRAMES)) {
+        return;
+    }
+    if ((Now < Wire_Idle_Time) && sim_statistics()) {
+        /* a real transmitter would have collided with the frame */
+        Overlaps++;
+    }
+    start_time = Wire_Idle_Time + (Turnaround_Bits * Octet_Time) / 10;
+    if (start_time < Now) {
+        start_time = Now;
+    }
+    frame = &Wire[(Wire_Head + Wire_Count) % SIM_WIRE_FRAMES];
+    Wire_Count++;
+    frame->sender = node;
+    frame->start_time = start_time;
+    frame->length = nbytes;
+    frame->delivered = 0;
+    frame->timed = node->sending;
+    frame->queue_time = node->sending_time;
+    node->sending = false;
+    memcpy(frame->data, buffer, nbytes);
+    Wire_Idle_Time = start_time + (nbytes * Octet_Time);
+    node->busy_time = Wire_Idle_Time;
+}
+
+/**
+ * @brief MS/TP state machine received a data frame for this node
+ * @param mstp_port port specific context data
+ * @return number of bytes of the PDU
+ */
+uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
+{
+    struct sim_node *node = mstp_port->UserData;
+
+    if (mstp_port->SlaveNodeEnabled) {
+        if ((mstp_port->FrameType == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) ||
+            (mstp_port->FrameType ==
+             FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY)) {
+            node->reply = true;
+            node->reply_station = mstp_port->SourceAddress;
+        }
+    } else if (
+        node->request && (mstp_port->SourceAddress >= SIM_SLAVE_ADDRESS)) {
+        node->request = false;
+        if (sim_statistics() && (node->request_time >= Warmup_Time)) {
+            sim_histogram_add(&Reply_Latency, Now - node->request_time);
+        }
+    }
+
+    return mstp_port->DataLength;
+}
+
+/**
+ * @brief MS/TP state machine calls this to get data to send
+ * @param mstp_port port specific context data
+ * @param timeout milliseconds to wait for a packet to send
+ * @return number of bytes of the frame in the output buffer, or zero
+ */
+uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    struct sim_node *node = mstp_port->UserData;
+    uint8_t frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
+    uint8_t destination;
+    uint16_t length;
+
+    (void)timeout;
+    if ((node->queue_count == 0) || node->request) {
+        return 0;
+    }
+    if (Slaves > 0) {
+        /* requests go to the slaves, one after another */
+        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
+        destination = (uint8_t)(SIM_SLAVE_ADDRESS + node->slave);
+        node->slave = (node->slave + 1) % Slaves;
+    } else if (Masters > 1) {
+        /* each master sends to the next one */
+        destination = (uint8_t)((mstp_port->This_Station + 1) % Masters);
+    } else {
+        destination = MSTP_BROADCAST_ADDRESS;
+    }
+    length = MSTP_Create_Frame(
+        mstp_port->OutputBuffer, mstp_port->OutputBufferSize, frame_type,
+        destination, mstp_port->This_Station, Payload, Payload_Size);
+    if (length == 0) {
+        return 0;
+    }
+    node->sending = true;
+    node->sending_time = node->queue_time[node->queue_head];
+    if (frame_type == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) {
+        node->request = true;
+        node->request_time = node->sending_time;
+    }
+    node->queue_head = (node->queue_head + 1) % SIM_QUEUE_MAX;
+    node->queue_count--;
+
+    return length;
+}
+
+/**
+ * @brief MS/TP state machine calls this to get the reply to a
+ *  Data-Expecting-Reply frame. The slaves answer at once, and the
+ *  masters get no requests.
+ * @param mstp_port port specific context data
+ * @param timeout milliseconds to wait for a packet
+ * @return number of bytes of the frame in the output buffer, or zero
+ */
+uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    struct sim_node *node = mstp_port->UserData;
+
+    (void)timeout;
+    if (!node->reply) {
+        return 0;
+    }
+    node->reply = false;
+
+    return MSTP_Create_Frame(
+        mstp_port->OutputBuffer, mstp_port->OutputBufferSize,
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, node->reply_station,
+        mstp_port->This_Station, Payload, Payload_Size);
+}
+
+/**
+ * @brief Account a frame that has left the wire
+ * @param frame - the frame
+ */
+static void sim_frame_complete(const struct sim_frame *frame)
+{
+    struct sim_node *node;
+    uint8_t frame_type = frame->data[2];
+
+    if (!sim_statistics()) {
+        return;
+    }
+    Frames++;
+    Busy_Time += frame->length * Octet_Time;
+    switch (frame_type) {
+        case FRAME_TYPE_TOKEN:
+            node = Node_Address[frame->data[3]];
+            if (node) {
+                if (node->token) {
+                    sim_histogram_add(&Token_Rotation, Now - node->token_time);
+                }
+                node->token = true;
+                node->token_time = Now;
+            }
+            break;
+        case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY:
+            Data_Frames++;
+            Data_Octets += Payload_Size;
+            if (frame->timed && (frame->queue_time >= Warmup_Time)) {
+                sim_histogram_add(&Queue_Latency, Now - frame->queue_time);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Hand the octets that have arrived to every node but the sender,
+ *  with noise
+ */
+static void sim_wire_task(void)
+{
+    struct sim_frame *frame;
+    struct sim_node *node;
+    uint8_t octet;
+    unsigned i;
+
+    while (Wire_Count > 0) {
+        frame = &Wire[Wire_Head];
+        while ((frame->delivered < frame->length) &&
+               ((frame->start_time +
+                 ((frame->delivered + 1) * Octet_Time)) <= Now)) {
+            octet = frame->data[frame->delivered];
+            if ((Noise > 0.0) && (sim_random_unit() < Noise)) {
+                octet ^= (uint8_t)(1 << (sim_random() % 8));
+            }
+            for (i = 0; i < Node_Count; i++) {
+                node = &Nodes[i];
+                if (node == frame->sender) {
+                    continue;
+                }
+                if (!FIFO_Put(&node->receive, octet)) {
+                    Overruns++;
+                }
+            }
+            frame->delivered++;
+        }
+        if (frame->delivered < frame->length) {
+            break;
+        }
+        sim_frame_complete(frame);
+        Wire_Head = (Wire_Head + 1) % SIM_WIRE_FRAMES;
+        Wire_Count--;
+    }
+}
+
+/**
+ * @brief Add the PDUs of the synthetic load to the queue of a master,
+ *  at the load rate with a random spread
+ * @param node - the master node
+ */
+static void sim_load_task(struct sim_node *node)
+{
+    uint64_t interval;
+
+    if (Load_Rate <= 0.0) {
+        return;
+    }
+    interval = (uint64_t)(NS_PER_S / Load_Rate);
+    while (node->arrival_time <= Now) {
+        if (node->queue_count < SIM_QUEUE_MAX) {
+            node->queue_time
+                [(node->queue_head + node->queue_count) % SIM_QUEUE_MAX] =
+                node->arrival_time;
+            node->queue_count++;
+        } else if (sim_statistics()) {
+            Dropped++;
+        }
+        node->arrival_time +=
+            (uint64_t)(interval * (0.5 + sim_random_unit()));
+    }
+}
+
+/**
+ * @brief Run the state machines of a node, as its datalink thread would
+ * @param node - the node
+ */
+static void sim_node_task(struct sim_node *node)
+{
+    struct mstp_port_struct_t *mstp_port = &node->port;
+    MSTP_MASTER_STATE master_state;
+    unsigned loops = 0;
+
+    if (Now < node->busy_time) {
+        /* the transmitter does not return until the frame is sent */
+        return;
+    }
+    do {
+        if (mstp_port->ReceivedValidFrame ||
+            mstp_port->ReceivedValidFrameNotForUs ||
+            mstp_port->ReceivedInvalidFrame) {
+            break;
+        }
+        if (!FIFO_Empty(&node->receive)) {
+            mstp_port->DataRegister = FIFO_Get(&node->receive);
+            mstp_port->DataAvailable = true;
+        }
+        MSTP_Receive_Frame_FSM(mstp_port);
+    } while (!FIFO_Empty(&node->receive));
+    if (mstp_port->ReceivedInvalidFrame && sim_statistics()) {
+        Invalid_Frames++;
+    }
+    if (mstp_port->ReceivedValidFrameNotForUs) {
+        mstp_port->ReceivedValidFrameNotForUs = false;
+    }
+    if (mstp_port->SlaveNodeEnabled) {
+        MSTP_Slave_Node_FSM(mstp_port);
+        return;
+    }
+    master_state = mstp_port->master_state;
+    while (MSTP_Master_Node_FSM(mstp_port)) {
+        if ((Now < node->busy_time) || (++loops > 16)) {
+            break;
+        }
+    }
+    if ((master_state != mstp_port->master_state) &&
+        (mstp_port->master_state == MSTP_MASTER_STATE_NO_TOKEN) &&
+        sim_statistics()) {
+        Lost_Tokens++;
+    }
+}
+
+/**
+ * @brief Initialize a node
+ * @param node - the node
+ * @param address - MS/TP address of the node
+ * @param slave - true for a slave node
+ */
+static void sim_node_init(struct sim_node *node, uint8_t address, bool slave)
+{
+    struct mstp_port_struct_t *mstp_port = &node->port;
+
+    memset(node, 0, sizeof(*node));
+    FIFO_Init(&node->receive, node->receive_data, sizeof(node->receive_data));
+    mstp_port->UserData = node;
+    mstp_port->InputBuffer = node->input;
+    mstp_port->InputBufferSize = sizeof(node->input);
+    mstp_port->OutputBuffer = node->output;
+    mstp_port->OutputBufferSize = sizeof(node->output);
+    mstp_port->This_Station = address;
+    mstp_port->Nmax_info_frames = (uint8_t)Max_Info_Frames;
+    mstp_port->Nmax_master = (uint8_t)Max_Master;
+    if (Adaptive_Max_Info_Frames > 0) {
+        mstp_port->AdaptiveEnabled = true;
+        mstp_port->Adaptive_Max_Info_Frames = (uint8_t)Adaptive_Max_Info_Frames;
+    }
+    mstp_port->SlaveNodeEnabled = slave;
+    mstp_port->SilenceTimer = sim_silence_timer;
+    mstp_port->SilenceTimerReset = sim_silence_timer_reset;
+    MSTP_Init(mstp_port);
+    /* the loads of the masters start at random times */
+    if (!slave && (Load_Rate > 0.0)) {
+        node->arrival_time =
+            (uint64_t)((NS_PER_S / Load_Rate) * sim_random_unit());
+    }
+    Node_Address[address] = node;
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--masters N][--slaves N][--baud N]\n", filename);
+    printf("       [--turnaround bits][--noise probability]\n");
+    printf("       [--rate frames][--size octets][--max-info-frames N]\n");
+    printf("       [--adaptive N][--max-master N][--time seconds]\n");
+    printf("       [--warmup seconds][--seed N][--help][--version]\n");
+}
+
+static void print_help(const char *filename)
+{
+    printf(
+        "Run the MS/TP state machines of many nodes against one simulated\n"
+        "RS-485 wire, and print the token rotation time, the throughput,\n"
+        "and the latency of the data frames.\n");
+    printf("\n");
+    printf("--masters N\n"
+           "Number of master nodes, at addresses 0 to N-1.\n"
+           "The default is 4.\n");
+    printf("--slaves N\n"
+           "Number of slave nodes, at addresses from 128. When there are\n"
+           "slaves, the masters send them requests that they answer.\n");
+    printf("--baud N\n"
+           "Baud rate of the wire. The default is 38400.\n");
+    printf("--turnaround bits\n"
+           "Bit times between a frame and the next one. The default is 40.\n");
+    printf("--noise probability\n"
+           "Probability that an octet on the wire gets a bit error.\n");
+    printf("--rate frames\n"
+           "PDUs queued per second by each master. The default is 10.\n");
+    printf("--size octets\n"
+           "Octets of each PDU. Above 501, the frames are extended frames.\n"
+           "The default is 50.\n");
+    printf("--max-info-frames N\n"
+           "Max_Info_Frames of each master. The default is 1.\n");
+    printf("--adaptive N\n"
+           "Let each master adapt its information frames, up to N.\n");
+    printf("--max-master N\n"
+           "Max_Master of each master. The default is 127.\n");
+    printf("--time seconds\n"
+           "Seconds of simulated time. The default is 60.\n");
+    printf("--warmup seconds\n"
+           "Seconds before the statistics start. The default is 5.\n");
+    printf("--seed N\n"
+           "Seed of the random numbers, for repeatable runs.\n");
+    printf("\n");
+    printf("Example:\n"
+           "%s --masters 32 --baud 76800 --rate 5 --adaptive 8\n",
+           filename);
+}
+
+static void print_report(void)
+{
+    double seconds = Seconds - Warmup_Seconds;
+
+    printf(
+        "MS/TP simulation: %u masters, %u slaves, %lu bps\n", Masters, Slaves,
+        (unsigned long)Baud_Rate);
+    printf(
+        "load: %.1f PDUs/s of %u octets per master, Max_Info_Frames %u",
+        Load_Rate, Payload_Size, Max_Info_Frames);
+    if (Adaptive_Max_Info_Frames > 0) {
+        printf(" adaptive to %u", Adaptive_Max_Info_Frames);
+    }
+    printf("\n");
+    printf("time: %u s, statistics after %u s\n", Seconds, Warmup_Seconds);
+    printf("\n");
+    printf(
+        "%-20s %8s %9s %9s %9s %9s %9s\n", "milliseconds", "samples", "mean",
+        "p50", "p90", "p99", "max");
+    sim_histogram_print("token-rotation", &Token_Rotation);
+    sim_histogram_print("queue-latency", &Queue_Latency);
+    if (Slaves > 0) {
+        sim_histogram_print("reply-latency", &Reply_Latency);
+    }
+    printf("\n");
+    printf(
+        "throughput: %.1f data frames/s, %.0f data octets/s, "
+        "wire busy %.1f%%\n",
+        Data_Frames / seconds, Data_Octets / seconds,
+        (100.0 * Busy_Time) / (seconds * NS_PER_S));
+    printf(
+        "frames: %lu, invalid frames received: %lu, lost tokens: %lu\n",
+        Frames, Invalid_Frames, Lost_Tokens);
+    printf(
+        "overlapping frames: %lu, dropped PDUs: %lu, receive overruns: %lu\n",
+        Overlaps, Dropped, Overruns);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filename = NULL;
+    uint64_t end_time;
+    unsigned i;
+    int argi;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2026 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if ((argi + 1) >= argc) {
+            print_usage(filename);
+            return 1;
+        }
+        if (strcmp(argv[argi], "--masters") == 0) {
+            Masters = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--slaves") == 0) {
+            Slaves = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--baud") == 0) {
+            Baud_Rate = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--turnaround") == 0) {
+            Turnaround_Bits = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--noise") == 0) {
+            Noise = strtod(argv[++argi], NULL);
+        } else if (strcmp(argv[argi], "--rate") == 0) {
+            Load_Rate = strtod(argv[++argi], NULL);
+        } else if (strcmp(argv[argi], "--size") == 0) {
+            Payload_Size = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--max-info-frames") == 0) {
+            Max_Info_Frames = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--adaptive") == 0) {
+            Adaptive_Max_Info_Frames = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--max-master") == 0) {
+            Max_Master = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--time") == 0) {
+            Seconds = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--warmup") == 0) {
+            Warmup_Seconds = strtoul(argv[++argi], NULL, 0);
+        } else if (strcmp(argv[argi], "--seed") == 0) {
+            Seed = strtoul(argv[++argi], NULL, 0);
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if ((Masters < 1) || (Masters > (DEFAULT_MAX_MASTER + 1)) ||
+        (Slaves > (MSTP_BROADCAST_ADDRESS - SIM_SLAVE_ADDRESS)) ||
+        (Baud_Rate == 0) || (Seconds <= Warmup_Seconds) ||
+        (Payload_Size < 2) || (Payload_Size > sizeof(Payload)) ||
+        (Max_Info_Frames < 1) || (Max_Info_Frames > 255) ||
+        (Adaptive_Max_Info_Frames > 255) || (Max_Master < (Masters - 1)) ||
+        (Max_Master > DEFAULT_MAX_MASTER)) {
+        fprintf(stderr, "Error: a setting is out of range.\n");
+        return 1;
+    }
+    if (Seed == 0) {
+        Seed = 1;
+    }
+    /* an NPDU header, then a pattern */
+    memset(Payload, 0x55, sizeof(Payload));
+    Payload[0] = BACNET_PROTOCOL_VERSION;
+    Payload[1] = 0;
+    /* 10 bit times per octet */
+    Octet_Time = (10ULL * NS_PER_S) / Baud_Rate;
+    Warmup_Time = Warmup_Seconds * NS_PER_S;
+    end_time = Seconds * NS_PER_S;
+    for (i = 0; i < Masters; i++) {
+        sim_node_init(&Nodes[Node_Count++], (uint8_t)i, false);
+    }
+    for (i = 0; i < Slaves; i++) {
+        sim_node_init(
+            &Nodes[Node_Count++], (uint8_t)(SIM_SLAVE_ADDRESS + i), true);
+    }
+    for (Now = 0; Now < end_time; Now += Octet_Time) {
+        sim_wire_task();
+        for (i = 0; i < Node_Count; i++) {
+            if (!Nodes[i].port.SlaveNodeEnabled) {
+                sim_load_task(&Nodes[i]);
+            }
+            sim_node_task(&Nodes[i]);
+        }
+    }
+    print_report();
+
+    return 0;
+}
@@ -450,11 +450,12 @@ static void Wait_For_Answer_Or_Timeout(unsigned timeout_ms, waitAction action)
         }
         if (action == waitAnswer) {
             /* Response was received. Exit. */
-            if (tsm_invoke_id_free(Request_Invoke_ID)) {
+            if (tsm_invoke_id_free_peer(&Target_Address, Request_Invoke_ID)) {
                 break;
-            } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
+            } else if (tsm_invoke_id_failed_peer(
+                           &Target_Address, Request_Invoke_ID)) {
                 LogError("TSM Timeout!");
-                tsm_free_invoke_id(Request_Invoke_ID);
+                tsm_free_invoke_id_peer(&Target_Address, Request_Invoke_ID);
                 break;
             }
         } else if (action == waitBind) {
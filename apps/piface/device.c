@@ -57,7 +57,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Device_Writable_Property_List },
+      Device_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #if (BACNET_PROTOCOL_REVISION >= 17)
     { OBJECT_NETWORK_PORT,
       Network_Port_Init,
@@ -79,7 +84,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Network_Port_Writable_Property_List },
+      Network_Port_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
     { OBJECT_BINARY_INPUT,
       Binary_Input_Init,
@@ -101,7 +111,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Binary_Input_Writable_Property_List },
+      Binary_Input_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      Binary_Input_Present_Value_Enumerated,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Binary_Input_Status_Flags },
     { OBJECT_BINARY_LIGHTING_OUTPUT,
       Binary_Lighting_Output_Init,
       Binary_Lighting_Output_Count,
@@ -122,7 +137,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Lighting_Output_Create,
       Binary_Lighting_Output_Delete,
       Binary_Lighting_Output_Timer,
-      Binary_Lighting_Output_Writable_Property_List },
+      Binary_Lighting_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_BINARY_OUTPUT,
       Binary_Output_Init,
       Binary_Output_Count,
@@ -143,7 +163,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Output_Create,
       Binary_Output_Delete,
       NULL /* Timer */,
-      Binary_Output_Writable_Property_List },
+      Binary_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      Binary_Output_Present_Value_Enumerated,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Binary_Output_Status_Flags },
     { MAX_BACNET_OBJECT_TYPE,
       NULL /* Init */,
       NULL /* Count */,
@@ -164,7 +189,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      NULL /* Writable_Property_List */ }
+      NULL /* Writable_Property_List */,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ }
 };
 
 /** Glue function to let the Device object, when called by a handler,
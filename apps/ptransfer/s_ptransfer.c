@@ -54,7 +54,7 @@ uint8_t Send_Private_Transfer_Request(
     status = address_get_by_device(device_id, &max_apdu, &dest);
     /* is there a tsm available? */
     if (status) {
-        invoke_id = tsm_next_free_invokeID();
+        invoke_id = tsm_next_free_invokeID_peer(&dest);
     }
     if (invoke_id) {
         /* encode the NPDU portion of the packet */
@@ -96,7 +96,7 @@ uint8_t Send_Private_Transfer_Request(
                 }
 #endif
             } else {
-                tsm_free_invoke_id(invoke_id);
+                tsm_free_invoke_id_peer(&dest, invoke_id);
                 invoke_id = 0;
 #if PRINT_ENABLED
                 fprintf(
@@ -35,6 +35,11 @@
 #error "App requires server-only features disabled! Set BACNET_SVC_SERVER=0"
 #endif
 
+/* the largest number of AtomicReadFile requests that are in flight */
+#ifndef READFILE_WINDOW_MAX
+#define READFILE_WINDOW_MAX 32
+#endif
+
 /* buffer used for receive */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
 
@@ -42,12 +47,61 @@ static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
 static uint32_t Target_File_Object_Instance = BACNET_MAX_INSTANCE;
 static uint32_t Target_Device_Object_Instance = BACNET_MAX_INSTANCE;
 static BACNET_ADDRESS Target_Address;
+static int Target_Segmentation = SEGMENTATION_NONE;
 static char *Local_File_Name = NULL;
-static int Target_File_Start_Position;
+static FILE *Local_File = NULL;
 static unsigned int Target_File_Requested_Octet_Count;
-static bool End_Of_File_Detected = false;
 static bool Error_Detected = false;
-static uint8_t Request_Invoke_ID = 0;
+/* the requests in flight, each reading a chunk of the file */
+struct read_request {
+    uint8_t invoke_id;
+    /* true if the chunk is still to be requested */
+    bool pending;
+    int32_t position;
+    unsigned int octet_count;
+};
+static struct read_request Read_Request[READFILE_WINDOW_MAX];
+static unsigned int Read_Window = 4;
+/* file position of the next chunk to be requested */
+static int32_t Next_File_Position;
+/* file position of the end of the file, once it is known */
+static int32_t End_Of_File_Position = INT32_MAX;
+static unsigned long Octets_Received;
+
+/**
+ * @brief Find the request in flight for a response
+ * @param src - address of the device that sent the response
+ * @param invoke_id - invoke ID of the response
+ * @return the request, or NULL if the response is not for a request
+ */
+static struct read_request *
+read_request_find(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    unsigned int i;
+
+    if ((invoke_id == 0) || !address_match(&Target_Address, src)) {
+        return NULL;
+    }
+    for (i = 0; i < Read_Window; i++) {
+        if (Read_Request[i].invoke_id == invoke_id) {
+            return &Read_Request[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Note the end of the file.  The chunks past the end of the file
+ *  that were already requested come back empty.
+ * @param position - file position of the end of the file
+ */
+static void end_of_file_set(int32_t position)
+{
+    if (position < End_Of_File_Position) {
+        End_Of_File_Position = position;
+    }
+}
 
 static void Atomic_Read_File_Error_Handler(
     BACNET_ADDRESS *src,
@@ -55,8 +109,18 @@ static void Atomic_Read_File_Error_Handler(
     BACNET_ERROR_CLASS error_class,
     BACNET_ERROR_CODE error_code)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
+    struct read_request *request;
+
+    request = read_request_find(src, invoke_id);
+    if (!request) {
+        return;
+    }
+    if ((error_code == ERROR_CODE_INVALID_FILE_START_POSITION) &&
+        (request->position > 0)) {
+        /* some devices answer a chunk past the end of the file
+           with an error instead of an empty chunk */
+        end_of_file_set(request->position);
+    } else {
         printf(
             "BACnet Error: %s: %s\n",
             bactext_error_class_name((int)error_class),
@@ -69,8 +133,7 @@ static void MyAbortHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
 {
     (void)server;
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
+    if (read_request_find(src, invoke_id)) {
         printf(
             "BACnet Abort: %s\n", bactext_abort_reason_name((int)abort_reason));
         Error_Detected = true;
@@ -80,8 +143,7 @@ static void MyAbortHandler(
 static void
 MyRejectHandler(BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
+    if (read_request_find(src, invoke_id)) {
         printf(
             "BACnet Reject: %s\n",
             bactext_reject_reason_name((int)reject_reason));
@@ -96,72 +158,59 @@ static void AtomicReadFileAckHandler(
     BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
 {
     int len = 0;
-    int result = 0;
     BACNET_ATOMIC_READ_FILE_DATA data;
-    FILE *pFile = NULL; /* stream pointer */
+    struct read_request *request;
     size_t octets_written = 0;
     size_t octet_count = 0;
-    uint8_t *octet_buffer = NULL;
-
-    if (address_match(&Target_Address, src) &&
-        (service_data->invoke_id == Request_Invoke_ID)) {
-        len =
-            arf_ack_decode_service_request(service_request, service_len, &data);
-        if ((len > 0) && (data.access == FILE_STREAM_ACCESS)) {
-            if (data.type.stream.fileStartPosition == 0) {
-                pFile = fopen(Local_File_Name, "wb");
-            } else {
-                pFile = fopen(Local_File_Name, "rb+");
-            }
-            if (pFile) {
-                octet_count = octetstring_length(&data.fileData[0]);
-                if (octet_count == 0) {
-                    /* asked for many octets, and got zero. Force EOF */
-                    if (!data.endOfFile) {
-                        fprintf(stderr, "Missing EOF!\n");
-                        data.endOfFile = true;
-                    }
-                } else {
-                    result = fseek(
-                        pFile, data.type.stream.fileStartPosition, SEEK_SET);
-                    if (result == 0) {
-                        /* unit to write in bytes -
-                           in our case, an octet is one byte */
-                        octet_buffer = octetstring_value(&data.fileData[0]);
-                        octets_written =
-                            fwrite(octet_buffer, 1, octet_count, pFile);
-                        if (octets_written != octet_count) {
-                            fprintf(
-                                stderr,
-                                "Unable to write data to file \"%s\".\n",
-                                Local_File_Name);
-                        } else {
-                            Target_File_Start_Position =
-                                data.type.stream.fileStartPosition +
-                                octets_written;
-                            printf(
-                                "\r%d bytes", (int)Target_File_Start_Position);
-                        }
-                        fflush(pFile);
-                    } else {
-                        fprintf(
-                            stderr, "Unable to seek to %d!\n",
-                            data.type.stream.fileStartPosition);
-                    }
-                }
-                fclose(pFile);
-            }
-            if (data.endOfFile) {
-                End_Of_File_Detected = true;
-                printf("\n");
-            }
-        } else {
-            fprintf(stderr, "Decode error! %d bytes decoded.\n", len);
-        }
-    } else {
+    int32_t position;
+
+    request = read_request_find(src, service_data->invoke_id);
+    if (!request) {
         fprintf(
             stderr, "Address & Invoke ID mismatch! Invoke ID=%d\n",
-            Request_Invoke_ID);
+            service_data->invoke_id);
+        return;
+    }
+    len = arf_ack_decode_service_request(service_request, service_len, &data);
+    if ((len <= 0) || (data.access != FILE_STREAM_ACCESS)) {
+        fprintf(stderr, "Decode error! %d bytes decoded.\n", len);
+        Error_Detected = true;
+        return;
+    }
+    position = data.type.stream.fileStartPosition;
+    octet_count = octetstring_length(&data.fileData[0]);
+    if (octet_count == 0) {
+        /* asked for many octets, and got zero. Force EOF */
+        if (!data.endOfFile) {
+            fprintf(stderr, "Missing EOF!\n");
+            data.endOfFile = true;
+        }
+    } else if (fseek(Local_File, position, SEEK_SET) != 0) {
+        fprintf(stderr, "Unable to seek to %d!\n", (int)position);
+        Error_Detected = true;
+    } else {
+        /* unit to write in bytes - in our case, an octet is one byte */
+        octets_written = fwrite(
+            octetstring_value(&data.fileData[0]), 1, octet_count, Local_File);
+        if (octets_written != octet_count) {
+            fprintf(
+                stderr, "Unable to write data to file \"%s\".\n",
+                Local_File_Name);
+            Error_Detected = true;
+        } else {
+            Octets_Received += octets_written;
+            printf("\r%lu bytes", Octets_Received);
+        }
+    }
+    if (data.endOfFile) {
+        end_of_file_set(position + (int32_t)octet_count);
+    } else if (
+        (octet_count > 0) && (octet_count < request->octet_count) &&
+        (position == request->position)) {
+        /* a short chunk: request the rest of it again */
+        request->position += (int32_t)octet_count;
+        request->octet_count -= (unsigned int)octet_count;
+        request->pending = true;
     }
 }
 
@@ -180,6 +229,9 @@ static void LocalIAmHandler(
         service_request, &device_id, &max_apdu, &segmentation, &vendor_id);
     if (len != -1) {
         address_add(device_id, max_apdu, src);
+        if (device_id == Target_Device_Object_Instance) {
+            Target_Segmentation = segmentation;
+        }
     } else {
         fprintf(stderr, "!\n");
     }
@@ -187,6 +239,54 @@ static void LocalIAmHandler(
     return;
 }
 
+/**
+ * @brief Determine the number of octets to request in each chunk
+ * @param max_apdu - the maximum APDU accepted by the device
+ * @param segmentation - the segmentation supported by the device
+ * @return number of octets to request in each chunk
+ */
+static unsigned int file_octet_count(unsigned max_apdu, int segmentation)
+{
+    unsigned int octet_count = 0;
+    uint16_t my_max_apdu = 0;
+
+    /* calculate the smaller of our APDU size or theirs
+       and remove the overhead of the APDU (about 16 octets max).
+       note: we could fail if there is a bottle neck (router)
+       and smaller MPDU in betweeen. */
+    if (max_apdu < MAX_APDU) {
+        my_max_apdu = max_apdu;
+    } else {
+        my_max_apdu = MAX_APDU;
+    }
+    /* Typical sizes are 50, 128, 206, 480, 1024, and 1476 octets */
+    if (my_max_apdu <= 50) {
+        octet_count = my_max_apdu - 20;
+    } else if (my_max_apdu <= 480) {
+        octet_count = my_max_apdu - 32;
+    } else if (my_max_apdu <= 1476) {
+        octet_count = my_max_apdu - 64;
+    } else {
+        octet_count = my_max_apdu / 2;
+    }
+#if BACNET_SEGMENTATION_ENABLED
+    /* a device that can send a segmented ACK is asked for as much as
+       we can reassemble, instead of one APDU */
+    if ((segmentation == SEGMENTATION_BOTH) ||
+        (segmentation == SEGMENTATION_TRANSMIT)) {
+        octet_count = (MAX_ASDU - MAX_NPDU) - 64;
+    }
+#else
+    (void)segmentation;
+#endif
+    /* the chunk is received in one octet string */
+    if (octet_count > MAX_OCTET_STRING_BYTES) {
+        octet_count = MAX_OCTET_STRING_BYTES;
+    }
+
+    return octet_count;
+}
+
 static void Init_Service_Handlers(void)
 {
     Device_Init(NULL);
@@ -214,7 +314,7 @@ static void Init_Service_Handlers(void)
 static void print_usage(const char *filename)
 {
     printf("Usage: %s device-instance file-instance local-name\n", filename);
-    printf("       [--version][--help]\n");
+    printf("       [--window N][--version][--help]\n");
 }
 
 static void print_help(const char *filename)
@@ -237,6 +337,12 @@ static void print_help(const char *filename)
     printf("local-name:\n"
            "The name of the file that will be stored locally.\n");
     printf("\n");
+    printf(
+        "--window N:\n"
+        "The number of chunks that are requested at the same time,\n"
+        "from 1 to %u.  The default is %u.\n",
+        (unsigned)READFILE_WINDOW_MAX, Read_Window);
+    printf("\n");
     printf(
         "Example:\n"
         "If you want read File 2 from Device 123 and save it to temp.txt,\n"
@@ -245,6 +351,81 @@ static void print_help(const char *filename)
         filename);
 }
 
+/**
+ * @brief Request the chunks of the file, keeping the window of requests
+ *  in flight.  A request that could not be sent is tried again later.
+ */
+static void read_requests_send(void)
+{
+    struct read_request *request;
+    uint8_t invoke_id = 0;
+    unsigned int i;
+
+    for (i = 0; i < Read_Window; i++) {
+        request = &Read_Request[i];
+        if (request->invoke_id != 0) {
+            continue;
+        }
+        if (request->pending && (request->position >= End_Of_File_Position)) {
+            request->pending = false;
+        }
+        if (!request->pending) {
+            if (Next_File_Position >= End_Of_File_Position) {
+                continue;
+            }
+            request->position = Next_File_Position;
+            request->octet_count = Target_File_Requested_Octet_Count;
+            request->pending = true;
+            Next_File_Position += (int32_t)request->octet_count;
+        }
+        invoke_id = Send_Atomic_Read_File_Stream(
+            Target_Device_Object_Instance, Target_File_Object_Instance,
+            request->position, request->octet_count);
+        if (invoke_id == 0) {
+            break;
+        }
+        request->invoke_id = invoke_id;
+        request->pending = false;
+    }
+}
+
+/**
+ * @brief Check the requests in flight
+ * @return true if all of the requests are done
+ */
+static bool read_requests_done(void)
+{
+    struct read_request *request;
+    bool done = true;
+    unsigned int i;
+
+    for (i = 0; i < Read_Window; i++) {
+        request = &Read_Request[i];
+        if (request->invoke_id == 0) {
+            /* idle, or not sent yet */
+        } else if (tsm_invoke_id_failed_peer(
+                       &Target_Address, request->invoke_id)) {
+            fprintf(stderr, "\rError: TSM Timeout!\n");
+            tsm_free_invoke_id_peer(&Target_Address, request->invoke_id);
+            request->invoke_id = 0;
+            /* try again or abort? */
+            Error_Detected = true;
+        } else if (tsm_invoke_id_free_peer(
+                       &Target_Address, request->invoke_id)) {
+            /* the ACK, if any, was handled */
+            request->invoke_id = 0;
+        }
+        if ((request->invoke_id != 0) || request->pending) {
+            done = false;
+        }
+    }
+    if (Next_File_Position < End_Of_File_Position) {
+        done = false;
+    }
+
+    return done;
+}
+
 int main(int argc, char *argv[])
 {
     BACNET_ADDRESS src = { 0 }; /* address where message came from */
@@ -255,10 +436,9 @@ int main(int argc, char *argv[])
     time_t last_seconds = 0;
     time_t current_seconds = 0;
     time_t timeout_seconds = 0;
-    uint8_t invoke_id = 0;
     bool found = false;
-    uint16_t my_max_apdu = 0;
     int argi = 0;
+    unsigned int target_args = 0;
     const char *filename = NULL;
 
     /* print help if requested */
@@ -278,19 +458,29 @@ int main(int argc, char *argv[])
                    "FITNESS FOR A PARTICULAR PURPOSE.\n");
             return 0;
         }
+        if (strcmp(argv[argi], "--window") == 0) {
+            if (++argi < argc) {
+                Read_Window = strtol(argv[argi], NULL, 0);
+            }
+        } else if (target_args == 0) {
+            Target_Device_Object_Instance = strtol(argv[argi], NULL, 0);
+            target_args++;
+        } else if (target_args == 1) {
+            Target_File_Object_Instance = strtol(argv[argi], NULL, 0);
+            target_args++;
+        } else if (target_args == 2) {
+            if (!filename_path_valid(argv[argi])) {
+                fprintf(stderr, "Invalid file path: %s\n", argv[argi]);
+                return 1;
+            }
+            Local_File_Name = argv[argi];
+            target_args++;
+        }
     }
-    if (argc < 4) {
+    if (target_args < 3) {
         print_usage(filename);
         return 0;
     }
-    /* decode the command line parameters */
-    Target_Device_Object_Instance = strtol(argv[1], NULL, 0);
-    Target_File_Object_Instance = strtol(argv[2], NULL, 0);
-    if (!filename_path_valid(argv[3])) {
-        fprintf(stderr, "Invalid file path: %s\n", argv[3]);
-        return 1;
-    }
-    Local_File_Name = argv[3];
     if (Target_Device_Object_Instance > BACNET_MAX_INSTANCE) {
         fprintf(
             stderr, "device-instance=%u - not greater than %u\n",
@@ -303,6 +493,19 @@ int main(int argc, char *argv[])
             Target_File_Object_Instance, BACNET_MAX_INSTANCE);
         return 1;
     }
+    if ((Read_Window < 1) || (Read_Window > READFILE_WINDOW_MAX)) {
+        fprintf(
+            stderr, "window=%u - not from 1 to %u\n", Read_Window,
+            (unsigned)READFILE_WINDOW_MAX);
+        return 1;
+    }
+    Local_File = fopen(Local_File_Name, "wb");
+    if (!Local_File) {
+        fprintf(
+            stderr, "Unable to open file \"%s\" for writing.\n",
+            Local_File_Name);
+        return 1;
+    }
     /* setup my info */
     Device_Set_Object_Instance_Number(BACNET_MAX_INSTANCE);
     address_init();
@@ -342,46 +545,17 @@ int main(int argc, char *argv[])
                 Target_Device_Object_Instance, &max_apdu, &Target_Address);
         }
         if (found) {
-            /* calculate the smaller of our APDU size or theirs
-               and remove the overhead of the APDU (about 16 octets max).
-               note: we could fail if there is a bottle neck (router)
-               and smaller MPDU in betweeen. */
-            if (max_apdu < MAX_APDU) {
-                my_max_apdu = max_apdu;
-            } else {
-                my_max_apdu = MAX_APDU;
-            }
-            /* Typical sizes are 50, 128, 206, 480, 1024, and 1476 octets */
-            if (my_max_apdu <= 50) {
-                Target_File_Requested_Octet_Count = my_max_apdu - 20;
-            } else if (my_max_apdu <= 480) {
-                Target_File_Requested_Octet_Count = my_max_apdu - 32;
-            } else if (my_max_apdu <= 1476) {
-                Target_File_Requested_Octet_Count = my_max_apdu - 64;
-            } else {
-                Target_File_Requested_Octet_Count = my_max_apdu / 2;
+            if (Target_File_Requested_Octet_Count == 0) {
+                /* we'll read the file in chunks that fit the device */
+                Target_File_Requested_Octet_Count =
+                    file_octet_count(max_apdu, Target_Segmentation);
             }
-            /* has the previous invoke id expired or returned?
-               note: invoke ID = 0 is invalid, so it will be idle */
-            if ((invoke_id == 0) || tsm_invoke_id_free(invoke_id)) {
-                if (End_Of_File_Detected || Error_Detected) {
-                    break;
-                }
-                /* the ACK will increment the start position if OK */
-                /* we'll read the file in chunks
-                   less than max_apdu to keep unsegmented */
-                invoke_id = Send_Atomic_Read_File_Stream(
-                    Target_Device_Object_Instance, Target_File_Object_Instance,
-                    Target_File_Start_Position,
-                    Target_File_Requested_Octet_Count);
-                Request_Invoke_ID = invoke_id;
-            } else if (tsm_invoke_id_failed(invoke_id)) {
-                fprintf(stderr, "\rError: TSM Timeout!\n");
-                tsm_free_invoke_id(invoke_id);
-                /* try again or abort? */
-                Error_Detected = true;
+            /* the ACKs come back in any order, and each one is
+               written to its own place in the file */
+            if (read_requests_done() || Error_Detected) {
                 break;
             }
+            read_requests_send();
         } else {
             /* increment timer - exit if timed out */
             elapsed_seconds += (current_seconds - last_seconds);
@@ -394,6 +568,8 @@ int main(int argc, char *argv[])
         /* keep track of time for next check */
         last_seconds = current_seconds;
     }
+    printf("\n");
+    fclose(Local_File);
 
     if (Error_Detected) {
         return 1;
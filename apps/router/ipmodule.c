@@ -11,7 +11,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/ipc.h>
 #include "ipmodule.h"
 #include "bacnet/bacint.h"
 
@@ -33,6 +32,7 @@ void *dl_ip_thread(void *pArgs)
     IP_DATA ip_data; /* port specific parameters */
     BACNET_ADDRESS address = { 0 };
     int status;
+    unsigned timeout;
     uint8_t shutdown = 0;
 
     /* initialize router port */
@@ -58,11 +58,12 @@ void *dl_ip_thread(void *pArgs)
     }
 
     port->port_id = msgboxid;
+    ip_data.wakeup_fd = msgbox_fd(msgboxid);
     port->state = RUNNING;
 
     while (!shutdown) {
         /* check for incoming messages */
-        bacmsg = recv_from_msgbox(port->port_id, &msg_storage, IPC_NOWAIT);
+        bacmsg = recv_from_msgbox(port->port_id, &msg_storage, 0);
 
         if (bacmsg) {
             switch (bacmsg->type) {
@@ -97,7 +98,10 @@ void *dl_ip_thread(void *pArgs)
                     break;
             }
         } else {
-            status = dl_ip_recv(&ip_data, &msg_data, &address, 5);
+            /* wait for a packet, or for a message to send */
+            timeout = msgbox_wait_begin(port->port_id) ? 1000 : 0;
+            status = dl_ip_recv(&ip_data, &msg_data, &address, timeout);
+            msgbox_wait_end(port->port_id);
             if (status > 0) {
                 memmove(&msg_data->src.len, &address.mac_len, 1);
                 memmove(&msg_data->src.adr[0], &address.mac[0], MAX_MAC_LEN);
@@ -126,6 +130,7 @@ bool dl_ip_init(ROUTER_PORT *port, IP_DATA *ip_data)
 
     /* setup port for later use */
     ip_data->port = htons(port->params.bip_params.port);
+    ip_data->wakeup_fd = -1;
 
     /* get local address */
     status = bip_get_local_address_ioctl(
@@ -266,6 +271,7 @@ int dl_ip_recv(
     struct timeval select_timeout;
     struct sockaddr_in sin = { 0 };
     socklen_t sin_len = sizeof(sin);
+    int max_fd;
     int ret;
     /* make sure the socket is open */
     if (data->socket < 0) {
@@ -283,6 +289,14 @@ int dl_ip_recv(
 
     FD_ZERO(&read_fds);
     FD_SET(data->socket, &read_fds);
+    max_fd = data->socket;
+    /* a message to send ends the wait */
+    if (data->wakeup_fd >= 0) {
+        FD_SET(data->wakeup_fd, &read_fds);
+        if (data->wakeup_fd > max_fd) {
+            max_fd = data->wakeup_fd;
+        }
+    }
 
 #ifdef TEST_PACKET
     received_bytes = sizeof(test_packet);
@@ -290,9 +304,9 @@ int dl_ip_recv(
     sin.sin_addr.s_addr = 0x7E1D40A;
     sin.sin_port = 0xC0BA;
 #else
-    ret = select(data->socket + 1, &read_fds, NULL, NULL, &select_timeout);
+    ret = select(max_fd + 1, &read_fds, NULL, NULL, &select_timeout);
     /* see if there is a packet for us */
-    if (ret > 0) {
+    if ((ret > 0) && FD_ISSET(data->socket, &read_fds)) {
         received_bytes = recvfrom(
             data->socket, (char *)&data->buff[0], data->max_buff, 0,
             (struct sockaddr *)&sin, &sin_len);
@@ -328,11 +342,14 @@ int dl_ip_recv(
                 (void)decode_unsigned16(&data->buff[2], &buff_len);
                 /* subtract off the BVLC header */
                 buff_len -= 4;
-                if (buff_len < data->max_buff) {
-                    /* allocate data message stucture */
-                    (*msg_data) = (MSG_DATA *)malloc(sizeof(MSG_DATA));
+                if (buff_len <= MSG_DATA_PDU_SIZE) {
+                    /* get a data message stucture from the pool */
+                    (*msg_data) = alloc_data();
+                    if (!(*msg_data)) {
+                        PRINT(ERROR, "BIP: No message buffer. Discarded!\n");
+                        return 0;
+                    }
                     (*msg_data)->pdu_len = buff_len;
-                    (*msg_data)->pdu = (uint8_t *)malloc((*msg_data)->pdu_len);
                     /* fill up data message structure */
                     memmove(
                         &(*msg_data)->pdu[0], &data->buff[4],
@@ -362,11 +379,14 @@ int dl_ip_recv(
                 (void)decode_unsigned16(&data->buff[2], &buff_len);
                 /* subtract off the BVLC header */
                 buff_len -= 10;
-                if (buff_len < data->max_buff) {
-                    /* allocate data message stucture */
-                    (*msg_data) = (MSG_DATA *)malloc(sizeof(MSG_DATA));
+                if (buff_len <= MSG_DATA_PDU_SIZE) {
+                    /* get a data message stucture from the pool */
+                    (*msg_data) = alloc_data();
+                    if (!(*msg_data)) {
+                        PRINT(ERROR, "BIP: No message buffer. Discarded!\n");
+                        return 0;
+                    }
                     (*msg_data)->pdu_len = buff_len;
-                    (*msg_data)->pdu = (uint8_t *)malloc((*msg_data)->pdu_len);
                     /* fill up data message structure */
                     memmove(
                         &(*msg_data)->pdu[0], &data->buff[4 + 6],
@@ -33,6 +33,8 @@ typedef struct ip_data {
     struct in_addr broadcast_addr;
     uint8_t *buff;
     uint16_t max_buff;
+    /* readable when there is a message to send, or -1 */
+    int wakeup_fd;
 } IP_DATA;
 
 void *dl_ip_thread(void *pArgs);
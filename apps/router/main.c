@@ -94,32 +94,37 @@ int main(int argc, char *argv[])
             }
         }
 
-        /* blocking dequeue here */
-        bacmsg = recv_from_msgbox(head->main_id, &msg_storage, 0);
+        /* wait for a message, and check the keyboard now and then */
+        bacmsg = recv_from_msgbox(head->main_id, &msg_storage, 1000);
         if (bacmsg) {
             switch (bacmsg->type) {
                 case DATA: {
                     MSGBOX_ID msg_src = bacmsg->origin;
+                    MSG_DATA *rx_data = (MSG_DATA *)bacmsg->data;
+                    bool network_msg = is_network_msg(bacmsg);
 
-                    /* allocate message structure */
-                    msg_data = malloc(sizeof(MSG_DATA));
+                    /* get a message structure from the pool */
+                    msg_data = alloc_data();
                     if (!msg_data) {
                         PRINT(ERROR, "Error: Could not allocate memory\n");
+                        check_data(rx_data);
                         break;
                     }
 
                     /* print_msg(bacmsg); */
 
-                    if (is_network_msg(bacmsg)) {
+                    if (network_msg) {
                         buff_len =
                             process_network_message(bacmsg, msg_data, &buff);
-                        if (buff_len == 0) {
-                            free_data(bacmsg->data);
-                            break;
-                        }
                     } else {
                         buff_len = process_msg(bacmsg, msg_data, &buff);
                     }
+                    /* delete received message */
+                    check_data(rx_data);
+                    if (network_msg && (buff_len == 0)) {
+                        free_data(msg_data);
+                        break;
+                    }
 
                     /* if buff_len */
                     /* >0 - form new message and send */
@@ -134,29 +139,35 @@ int main(int argc, char *argv[])
                         msg_storage.type = DATA;
                         msg_storage.data = msg_data;
 
-                        /* print_msg(bacmsg); */
-
-                        if (is_network_msg(bacmsg)) {
-                            msg_data->ref_count = 1;
-                            send_to_msgbox(msg_src, &msg_storage);
+                        if (network_msg) {
+                            if (!send_to_msgbox(msg_src, &msg_storage)) {
+                                free_data(msg_data);
+                            }
                         } else if (
                             msg_data->dest.net != BACNET_BROADCAST_NETWORK) {
-                            msg_data->ref_count = 1;
                             port =
                                 find_dnet(msg_data->dest.net, &msg_data->dest);
-                            send_to_msgbox(port->port_id, &msg_storage);
+                            if (!port ||
+                                !send_to_msgbox(port->port_id, &msg_storage)) {
+                                free_data(msg_data);
+                            }
                         } else {
+                            /* each port holds a reference until sent */
                             port = head;
-                            msg_data->ref_count = port_count - 1;
                             while (port != NULL) {
                                 if (port->port_id == msg_src ||
                                     port->state == FINISHED) {
                                     port = port->next;
                                     continue;
                                 }
-                                send_to_msgbox(port->port_id, &msg_storage);
+                                hold_data(msg_data);
+                                if (!send_to_msgbox(
+                                        port->port_id, &msg_storage)) {
+                                    check_data(msg_data);
+                                }
                                 port = port->next;
                             }
+                            check_data(msg_data);
                         }
                     } else if (buff_len == -1) {
                         uint16_t net = msg_data->dest.net; /* NET to find */
@@ -668,6 +679,7 @@ bool init_router(void)
     /* add main message box id to all ports */
     while (port != NULL) {
         port->main_id = msgboxid;
+        add_port_net(port);
         port = port->next;
     }
 
@@ -727,7 +739,6 @@ void cleanup(void)
         }
     }
 
-    pthread_mutex_destroy(&msg_lock);
 }
 
 void print_msg(const BACMSG *msg)
@@ -757,12 +768,15 @@ uint16_t process_msg(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
     int apdu_offset;
     int apdu_len;
     int npdu_len;
+    const MSG_DATA *rx_data = (const MSG_DATA *)msg->data;
 
-    memmove(data, msg->data, sizeof(MSG_DATA));
+    /* the message is formed in data, from the received message */
+    data->dest = rx_data->dest;
+    data->src = rx_data->src;
 
     apdu_offset = bacnet_npdu_decode(
-        data->pdu, data->pdu_len, &data->dest, &addr, &npdu_data);
-    apdu_len = data->pdu_len - apdu_offset;
+        rx_data->pdu, rx_data->pdu_len, &data->dest, &addr, &npdu_data);
+    apdu_len = rx_data->pdu_len - apdu_offset;
 
     srcport = find_snet(msg->origin);
     destport = find_dnet(data->dest.net, NULL);
@@ -788,12 +802,16 @@ uint16_t process_msg(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
             npdu_len = npdu_encode_pdu(npdu, NULL, &data->src, &npdu_data);
         }
 
-        buff_len = npdu_len + data->pdu_len - apdu_offset;
+        buff_len = npdu_len + apdu_len;
+        if ((apdu_len < 0) || (buff_len > (int)sizeof(data->buffer))) {
+            /* discard message */
+            return -2;
+        }
 
-        *buff = (uint8_t *)malloc(buff_len);
+        *buff = data->buffer;
         memmove(*buff, npdu, npdu_len); /* copy newly formed NPDU */
         memmove(
-            *buff + npdu_len, &data->pdu[apdu_offset],
+            *buff + npdu_len, &rx_data->pdu[apdu_offset],
             apdu_len); /* copy APDU */
 
     } else {
@@ -801,9 +819,6 @@ uint16_t process_msg(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
         return -1;
     }
 
-    /* delete received message */
-    free_data((MSG_DATA *)msg->data);
-
     return buff_len;
 }
 
@@ -3,6 +3,13 @@
  * @author Andriy Sukhynyuk, Vasyl Tkhir, Andriy Ivasiv
  * @date 2012
  * @brief Message queue module
+ * @details The threads of the router pass messages to each other through
+ *  message boxes in the process.  A message box is a bounded ring of
+ *  messages that any thread can send to without a lock or a system call,
+ *  and that its owner thread receives from.  The owner waits for a message
+ *  on the eventfd of the box, which a sender writes only when the owner
+ *  is waiting.  The data of the messages comes from a pool of buffers,
+ *  which is a ring of the free buffers.
  *
  * @section LICENSE
  *
@@ -11,73 +18,330 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <poll.h>
 #include <pthread.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 #include "msgqueue.h"
 
-pthread_mutex_t msg_lock = PTHREAD_MUTEX_INITIALIZER;
+#if (MSGBOX_DEPTH & (MSGBOX_DEPTH - 1)) != 0
+#error "MSGBOX_DEPTH must be a power of two"
+#endif
+#if MSG_DATA_POOL_SIZE > MSGBOX_DEPTH
+#error "MSG_DATA_POOL_SIZE must not be greater than MSGBOX_DEPTH"
+#endif
+
+/* a slot of the ring, with the turn of the slot in the sequence */
+struct msg_cell {
+    size_t sequence;
+    BACMSG msg;
+};
+
+/* bounded ring of messages for many senders and receivers */
+struct msg_ring {
+    struct msg_cell cell[MSGBOX_DEPTH];
+    size_t put_position;
+    size_t get_position;
+};
+
+typedef struct _msgbox {
+    bool used;
+    int event_fd;
+    /* true while the owner is waiting on event_fd */
+    bool waiting;
+    struct msg_ring ring;
+} MSGBOX;
+
+static MSGBOX Msgbox[MSGBOX_MAX];
+static MSG_DATA Msg_Data_Pool[MSG_DATA_POOL_SIZE];
+static struct msg_ring Msg_Data_Free;
+static pthread_once_t Msg_Data_Once = PTHREAD_ONCE_INIT;
+
+static void msg_ring_init(struct msg_ring *ring)
+{
+    size_t i;
+
+    for (i = 0; i < MSGBOX_DEPTH; i++) {
+        ring->cell[i].sequence = i;
+    }
+    ring->put_position = 0;
+    ring->get_position = 0;
+}
+
+static bool msg_ring_put(struct msg_ring *ring, const BACMSG *msg)
+{
+    struct msg_cell *cell;
+    size_t position;
+    size_t sequence;
+    intptr_t diff;
+
+    position = __atomic_load_n(&ring->put_position, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = &ring->cell[position & (MSGBOX_DEPTH - 1)];
+        sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        diff = (intptr_t)sequence - (intptr_t)position;
+        if (diff == 0) {
+            /* the slot is free: claim it */
+            if (__atomic_compare_exchange_n(
+                    &ring->put_position, &position, position + 1, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* full */
+            return false;
+        } else {
+            position = __atomic_load_n(&ring->put_position, __ATOMIC_RELAXED);
+        }
+    }
+    cell->msg = *msg;
+    __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+static bool msg_ring_get(struct msg_ring *ring, BACMSG *msg)
+{
+    struct msg_cell *cell;
+    size_t position;
+    size_t sequence;
+    intptr_t diff;
+
+    position = __atomic_load_n(&ring->get_position, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = &ring->cell[position & (MSGBOX_DEPTH - 1)];
+        sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        diff = (intptr_t)sequence - (intptr_t)(position + 1);
+        if (diff == 0) {
+            /* the slot holds a message: claim it */
+            if (__atomic_compare_exchange_n(
+                    &ring->get_position, &position, position + 1, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* empty */
+            return false;
+        } else {
+            position = __atomic_load_n(&ring->get_position, __ATOMIC_RELAXED);
+        }
+    }
+    *msg = cell->msg;
+    __atomic_store_n(
+        &cell->sequence, position + MSGBOX_DEPTH, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+static bool msg_ring_empty(struct msg_ring *ring)
+{
+    size_t position;
+    size_t sequence;
+
+    position = __atomic_load_n(&ring->get_position, __ATOMIC_RELAXED);
+    sequence = __atomic_load_n(
+        &ring->cell[position & (MSGBOX_DEPTH - 1)].sequence, __ATOMIC_ACQUIRE);
+
+    return sequence != (position + 1);
+}
+
+static MSGBOX *msgbox_get(MSGBOX_ID msgboxid)
+{
+    if ((msgboxid < 0) || (msgboxid >= MSGBOX_MAX)) {
+        return NULL;
+    }
+    if (!__atomic_load_n(&Msgbox[msgboxid].used, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+
+    return &Msgbox[msgboxid];
+}
 
 MSGBOX_ID create_msgbox(void)
 {
     MSGBOX_ID msgboxid;
+    bool used;
 
-    msgboxid = msgget(IPC_PRIVATE, 0666 | IPC_CREAT);
-    if (msgboxid == INVALID_MSGBOX_ID) {
+    for (msgboxid = 0; msgboxid < MSGBOX_MAX; msgboxid++) {
+        used = false;
+        if (__atomic_compare_exchange_n(
+                &Msgbox[msgboxid].used, &used, true, false, __ATOMIC_ACQUIRE,
+                __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    if (msgboxid == MSGBOX_MAX) {
+        return INVALID_MSGBOX_ID;
+    }
+    Msgbox[msgboxid].event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (Msgbox[msgboxid].event_fd < 0) {
+        __atomic_store_n(&Msgbox[msgboxid].used, false, __ATOMIC_RELEASE);
         return INVALID_MSGBOX_ID;
     }
+    Msgbox[msgboxid].waiting = false;
+    msg_ring_init(&Msgbox[msgboxid].ring);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
 
     return msgboxid;
 }
 
 bool send_to_msgbox(MSGBOX_ID dest, BACMSG *msg)
 {
-    int err;
+    MSGBOX *box;
 
-    err = msgsnd(dest, msg, sizeof(BACMSG) - sizeof(MSGTYPE), 0);
-    if (err) {
+    box = msgbox_get(dest);
+    if (!box) {
         return false;
     }
+    if (!msg_ring_put(&box->ring, msg)) {
+        return false;
+    }
+    /* the owner checks the ring after it says it is waiting,
+       and we check it is waiting after the message is in the ring */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&box->waiting, false, __ATOMIC_SEQ_CST)) {
+        (void)eventfd_write(box->event_fd, 1);
+    }
+
     return true;
 }
 
-BACMSG *recv_from_msgbox(MSGBOX_ID src, BACMSG *msg, int flags)
+BACMSG *recv_from_msgbox(MSGBOX_ID src, BACMSG *msg, int timeout)
 {
-    int recv_bytes;
+    MSGBOX *box;
+    struct pollfd fds = { 0 };
 
-    recv_bytes = msgrcv(src, msg, sizeof(BACMSG) - sizeof(MSGTYPE), 0, flags);
-    if (recv_bytes > 0) {
+    box = msgbox_get(src);
+    if (!box) {
+        return NULL;
+    }
+    if (msg_ring_get(&box->ring, msg)) {
         return msg;
-    } else {
+    }
+    if (timeout == 0) {
         return NULL;
     }
+    if (msgbox_wait_begin(src)) {
+        fds.fd = box->event_fd;
+        fds.events = POLLIN;
+        (void)poll(&fds, 1, timeout);
+    }
+    msgbox_wait_end(src);
+    if (msg_ring_get(&box->ring, msg)) {
+        return msg;
+    }
+
+    return NULL;
 }
 
 void del_msgbox(MSGBOX_ID msgboxid)
 {
-    if (msgboxid == INVALID_MSGBOX_ID) {
+    MSGBOX *box;
+    BACMSG msg;
+
+    box = msgbox_get(msgboxid);
+    if (!box) {
         return;
-    } else {
-        msgctl(msgboxid, IPC_RMID, NULL);
     }
+    __atomic_store_n(&box->used, false, __ATOMIC_RELEASE);
+    /* let go of the data that was never received */
+    while (msg_ring_get(&box->ring, &msg)) {
+        if ((msg.type == DATA) && msg.data) {
+            check_data((MSG_DATA *)msg.data);
+        }
+    }
+    close(box->event_fd);
+    box->event_fd = -1;
 }
 
-void free_data(MSG_DATA *data)
+int msgbox_fd(MSGBOX_ID msgboxid)
+{
+    MSGBOX *box;
+
+    box = msgbox_get(msgboxid);
+    if (!box) {
+        return -1;
+    }
+
+    return box->event_fd;
+}
+
+bool msgbox_wait_begin(MSGBOX_ID msgboxid)
+{
+    MSGBOX *box;
+
+    box = msgbox_get(msgboxid);
+    if (!box) {
+        return false;
+    }
+    __atomic_store_n(&box->waiting, true, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return msg_ring_empty(&box->ring);
+}
+
+void msgbox_wait_end(MSGBOX_ID msgboxid)
 {
-    if (data->pdu) {
-        free(data->pdu);
-        data->pdu = NULL;
+    MSGBOX *box;
+    eventfd_t value;
+
+    box = msgbox_get(msgboxid);
+    if (!box) {
+        return;
+    }
+    __atomic_store_n(&box->waiting, false, __ATOMIC_SEQ_CST);
+    (void)eventfd_read(box->event_fd, &value);
+}
+
+static void msg_data_pool_init(void)
+{
+    BACMSG msg = { 0 };
+    unsigned i;
+
+    msg_ring_init(&Msg_Data_Free);
+    for (i = 0; i < MSG_DATA_POOL_SIZE; i++) {
+        msg.data = &Msg_Data_Pool[i];
+        (void)msg_ring_put(&Msg_Data_Free, &msg);
+    }
+}
+
+MSG_DATA *alloc_data(void)
+{
+    BACMSG msg;
+    MSG_DATA *data;
+
+    (void)pthread_once(&Msg_Data_Once, msg_data_pool_init);
+    if (!msg_ring_get(&Msg_Data_Free, &msg)) {
+        return NULL;
     }
+    data = (MSG_DATA *)msg.data;
+    data->pdu = data->buffer;
+    data->pdu_len = 0;
+    data->ref_count = 1;
+
+    return data;
+}
+
+void free_data(MSG_DATA *data)
+{
+    BACMSG msg = { 0 };
+
     if (data) {
-        free(data);
-        data = NULL;
+        /* the free ring holds the whole pool, so it is never full */
+        msg.data = data;
+        (void)msg_ring_put(&Msg_Data_Free, &msg);
     }
 }
 
+void hold_data(MSG_DATA *data)
+{
+    (void)__atomic_add_fetch(&data->ref_count, 1, __ATOMIC_RELAXED);
+}
+
 void check_data(MSG_DATA *data)
 {
-    /* lock and decrement messages reference count */
-    pthread_mutex_lock(&msg_lock);
-    if (--data->ref_count == 0) {
+    /* decrement messages reference count */
+    if (__atomic_sub_fetch(&data->ref_count, 1, __ATOMIC_ACQ_REL) == 0) {
         free_data(data);
     }
-    pthread_mutex_unlock(&msg_lock);
 }
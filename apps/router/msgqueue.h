@@ -11,20 +11,36 @@
 #ifndef MSGQUEUE_H
 #define MSGQUEUE_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <sys/types.h>
-#include <sys/ipc.h>
-#include <sys/msg.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/npdu.h"
 
-extern pthread_mutex_t msg_lock;
-
 #define INVALID_MSGBOX_ID -1
 
+/* number of message boxes: one for each router port, and the router's */
+#ifndef MSGBOX_MAX
+#define MSGBOX_MAX 16
+#endif
+
+/* number of messages that a message box holds, a power of two */
+#ifndef MSGBOX_DEPTH
+#define MSGBOX_DEPTH 256
+#endif
+
+/* number of data messages that can be in flight between the threads */
+#ifndef MSG_DATA_POOL_SIZE
+#define MSG_DATA_POOL_SIZE 256
+#endif
+
+/* largest NPDU of a data message */
+#ifndef MSG_DATA_PDU_SIZE
+#define MSG_DATA_PDU_SIZE (MAX_NPDU + 1476)
+#endif
+
 typedef int MSGBOX_ID;
 
 typedef enum { DATA = 1, SERVICE } MSGTYPE;
@@ -46,21 +62,40 @@ typedef struct _msg_data {
     uint8_t *pdu;
     uint16_t pdu_len;
     uint8_t ref_count;
+    /* the PDU, unless pdu points elsewhere */
+    uint8_t buffer[MSG_DATA_PDU_SIZE];
 } MSG_DATA;
 
 MSGBOX_ID create_msgbox(void);
 
-/* returns sent byte count */
+/* returns true if the message was queued */
 bool send_to_msgbox(MSGBOX_ID dest, BACMSG *msg);
 
-/* returns received message */
-BACMSG *recv_from_msgbox(MSGBOX_ID src, BACMSG *msg, int flags);
+/* returns received message, waiting up to timeout milliseconds,
+   or forever if timeout is negative */
+BACMSG *recv_from_msgbox(MSGBOX_ID src, BACMSG *msg, int timeout);
 
 void del_msgbox(MSGBOX_ID msgboxid);
 
+/* event file descriptor that is readable when a message is sent */
+int msgbox_fd(MSGBOX_ID msgboxid);
+
+/* get ready to wait on the event file descriptor,
+   returns false if there are messages to receive */
+bool msgbox_wait_begin(MSGBOX_ID msgboxid);
+
+/* done waiting on the event file descriptor */
+void msgbox_wait_end(MSGBOX_ID msgboxid);
+
+/* get a message data structure from the pool, with a reference count of 1 */
+MSG_DATA *alloc_data(void);
+
 /* free message data structure */
 void free_data(MSG_DATA *data);
 
+/* add a reference to the message data structure */
+void hold_data(MSG_DATA *data);
+
 /* check message reference counter and delete data if needed */
 void check_data(MSG_DATA *data);
 
@@ -11,7 +11,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/ipc.h>
 #include "mstpmodule.h"
 #include "bacnet/bacint.h"
 #include "dlmstp_port.h"
@@ -65,6 +64,8 @@ void *dl_mstp_thread(void *pArgs)
     dlmstp_set_max_master(&mstp_port, port->params.mstp_params.max_master);
     if (!dlmstp_init(&mstp_port, port->iface)) {
         printf("MSTP %s init failed. Stop.\n", port->iface);
+        port->state = INIT_FAILED;
+        return NULL;
     }
     mstp_port.Treply_timeout = 260;
     mstp_port.Tusage_timeout = 30;
@@ -81,24 +82,25 @@ void *dl_mstp_thread(void *pArgs)
         /* message loop */
         BACMSG msg_storage, *bacmsg;
         MSG_DATA *msg_data;
+        BACNET_ADDRESS dest;
 
-        bacmsg = recv_from_msgbox(port->port_id, &msg_storage, IPC_NOWAIT);
+        bacmsg = recv_from_msgbox(port->port_id, &msg_storage, 0);
 
         if (bacmsg) {
             switch (bacmsg->type) {
                 case DATA:
                     msg_data = (MSG_DATA *)bacmsg->data;
-
-                    if (msg_data->dest.net == BACNET_BROADCAST_NETWORK) {
-                        dlmstp_get_broadcast_address(&(msg_data->dest));
+                    /* the data may be shared with the other ports */
+                    dest = msg_data->dest;
+                    if (dest.net == BACNET_BROADCAST_NETWORK) {
+                        dlmstp_get_broadcast_address(&dest);
                     } else {
-                        msg_data->dest.mac[0] = msg_data->dest.adr[0];
-                        msg_data->dest.mac_len = 1;
+                        dest.mac[0] = dest.adr[0];
+                        dest.mac_len = 1;
                     }
 
                     dlmstp_send_pdu(
-                        &mstp_port, &(msg_data->dest), msg_data->pdu,
-                        msg_data->pdu_len);
+                        &mstp_port, &dest, msg_data->pdu, msg_data->pdu_len);
 
                     check_data(msg_data);
 
@@ -106,6 +108,7 @@ void *dl_mstp_thread(void *pArgs)
                 case SERVICE:
                     switch (bacmsg->subtype) {
                         case SHUTDOWN:
+                            del_msgbox(port->port_id);
                             shutdown = 1;
                             break;
                         default:
@@ -119,15 +122,18 @@ void *dl_mstp_thread(void *pArgs)
         } else {
             pdu_len = dlmstp_receive(&mstp_port, NULL, NULL, 0, 5);
 
-            if (pdu_len > 0) {
-                msg_data = (MSG_DATA *)malloc(sizeof(MSG_DATA));
+            if ((pdu_len > 0) && (pdu_len <= MSG_DATA_PDU_SIZE)) {
+                /* get a data message stucture from the pool */
+                msg_data = alloc_data();
+                if (!msg_data) {
+                    continue;
+                }
                 memmove(
                     &(msg_data->src),
                     (const void *)&(shared_port_data.Receive_Packet.address),
                     sizeof(shared_port_data.Receive_Packet.address));
                 msg_data->src.adr[0] = msg_data->src.mac[0];
                 msg_data->src.len = 1;
-                msg_data->pdu = (uint8_t *)malloc(pdu_len);
                 memmove(
                     msg_data->pdu,
                     (const void *)&(shared_port_data.Receive_Packet.pdu),
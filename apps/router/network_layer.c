@@ -27,12 +27,16 @@ process_network_message(const BACMSG *msg, MSG_DATA *data, uint8_t **buff)
     int apdu_len;
     int net_count;
     int i;
+    const MSG_DATA *rx_data = (const MSG_DATA *)msg->data;
+    const uint8_t *pdu = rx_data->pdu;
 
-    memmove(data, msg->data, sizeof(MSG_DATA));
+    /* the reply is formed in data, from the received message */
+    data->dest = rx_data->dest;
+    data->src = rx_data->src;
 
     apdu_offset = bacnet_npdu_decode(
-        data->pdu, data->pdu_len, &data->dest, NULL, &npdu_data);
-    apdu_len = data->pdu_len - apdu_offset;
+        pdu, rx_data->pdu_len, &data->dest, NULL, &npdu_data);
+    apdu_len = rx_data->pdu_len - apdu_offset;
 
     srcport = find_snet(msg->origin);
     data->src.net = srcport->route_info.net;
@@ -42,7 +46,7 @@ process_network_message(const BACMSG *msg, MSG_DATA *data, uint8_t **buff)
             PRINT(INFO, "Recieved Who-Is-Router-To-Network message\n");
             if (apdu_len) {
                 /* if NET specified */
-                decode_unsigned16(&data->pdu[apdu_offset], &net);
+                decode_unsigned16(&pdu[apdu_offset], &net);
                 if (srcport->route_info.net == net) {
                     PRINT(INFO, "Message discarded: NET directly connected\n");
                     return -2;
@@ -73,10 +77,10 @@ process_network_message(const BACMSG *msg, MSG_DATA *data, uint8_t **buff)
             net_count = apdu_len / 2;
             for (i = 0; i < net_count; i++) {
                 decode_unsigned16(
-                    &data->pdu[apdu_offset + 2 * i],
+                    &pdu[apdu_offset + 2 * i],
                     &net); /* decode received NET values */
                 add_dnet(
-                    &srcport->route_info, net,
+                    srcport, net,
                     data->src); /* and update routing table */
             }
             break;
@@ -85,7 +89,7 @@ process_network_message(const BACMSG *msg, MSG_DATA *data, uint8_t **buff)
             /* first octet of the message contains rejection reason */
             /* next two octets contain NET (can be decoded for additional info
              * on error) */
-            error_code = data->pdu[apdu_offset];
+            error_code = pdu[apdu_offset];
             switch (error_code) {
                 case 0:
                     PRINT(ERROR, "Error!\n");
@@ -109,19 +113,19 @@ process_network_message(const BACMSG *msg, MSG_DATA *data, uint8_t **buff)
         }
         case NETWORK_MESSAGE_INIT_RT_TABLE:
             PRINT(INFO, "Recieved Initialize-Routing-Table message\n");
-            if (data->pdu[apdu_offset] > 0) {
-                int net_count = data->pdu[apdu_offset];
+            if (pdu[apdu_offset] > 0) {
+                int net_count = pdu[apdu_offset];
                 while (net_count--) {
                     int i = 1;
                     decode_unsigned16(
-                        &data->pdu[apdu_offset + i],
+                        &pdu[apdu_offset + i],
                         &net); /* decode received NET values */
                     add_dnet(
-                        &srcport->route_info, net,
+                        srcport, net,
                         data->src); /* and update routing table */
-                    if (data->pdu[apdu_offset + i + 3] >
+                    if (pdu[apdu_offset + i + 3] >
                         0) { /* find next NET value */
-                        i = data->pdu[apdu_offset + i + 3] + 4;
+                        i = pdu[apdu_offset + i + 3] + 4;
                     } else {
                         i = i + 4;
                     }
@@ -136,19 +140,19 @@ process_network_message(const BACMSG *msg, MSG_DATA *data, uint8_t **buff)
 
         case NETWORK_MESSAGE_INIT_RT_TABLE_ACK:
             PRINT(INFO, "Recieved Initialize-Routing-Table-Ack message\n");
-            if (data->pdu[apdu_offset] > 0) {
-                int net_count = data->pdu[apdu_offset];
+            if (pdu[apdu_offset] > 0) {
+                int net_count = pdu[apdu_offset];
                 while (net_count--) {
                     int i = 1;
                     decode_unsigned16(
-                        &data->pdu[apdu_offset + i],
+                        &pdu[apdu_offset + i],
                         &net); /* decode received NET values */
                     add_dnet(
-                        &srcport->route_info, net,
+                        srcport, net,
                         data->src); /* and update routing table */
-                    if (data->pdu[apdu_offset + i + 3] >
+                    if (pdu[apdu_offset + i + 3] >
                         0) { /* find next NET value */
-                        i = data->pdu[apdu_offset + i + 3] + 4;
+                        i = pdu[apdu_offset + i + 3] + 4;
                     } else {
                         i = i + 4;
                     }
@@ -156,10 +160,27 @@ process_network_message(const BACMSG *msg, MSG_DATA *data, uint8_t **buff)
             }
             break;
 
+        case NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK:
+        case NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK: {
+            bool available = (npdu_data.network_message_type ==
+                              NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK);
+            PRINT(INFO, "Recieved Router-Busy/Available-To-Network message\n");
+            net_count = apdu_len / 2;
+            if (net_count == 0) {
+                /* all of the networks served by the router */
+                set_dnet_state(
+                    srcport, BACNET_BROADCAST_NETWORK, &data->src, available);
+            }
+            for (i = 0; i < net_count; i++) {
+                decode_unsigned16(
+                    &pdu[apdu_offset + 2 * i],
+                    &net); /* decode received NET values */
+                set_dnet_state(srcport, net, &data->src, available);
+            }
+            break;
+        }
         case NETWORK_MESSAGE_INVALID:
         case NETWORK_MESSAGE_I_COULD_BE_ROUTER_TO_NETWORK:
-        case NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK:
-        case NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK:
         case NETWORK_MESSAGE_ESTABLISH_CONNECTION_TO_NETWORK:
         case NETWORK_MESSAGE_DISCONNECT_CONNECTION_TO_NETWORK:
             /* hell if I know what to do with these messages */
@@ -203,7 +224,8 @@ uint16_t create_network_message(
     }
     init_npdu(&npdu_data, network_message_type, data_expecting_reply);
 
-    *buff = (uint8_t *)malloc(128); /* resolve different length */
+    /* the message is encoded in the buffer of the data */
+    *buff = data->buffer;
 
     /* manual destination setup for Init-RT-Table-Ack message */
     data->dest.net = BACNET_BROADCAST_NETWORK;
@@ -317,7 +339,11 @@ void send_network_message(
     int16_t buff_len;
 
     if (!data) {
-        data = (MSG_DATA *)malloc(sizeof(MSG_DATA));
+        data = alloc_data();
+        if (!data) {
+            PRINT(ERROR, "Error: Could not allocate memory\n");
+            return;
+        }
         data->dest.net = BACNET_BROADCAST_NETWORK;
         data->dest.len = 0;
     }
@@ -331,15 +357,20 @@ void send_network_message(
     msg.type = DATA;
     msg.data = data;
 
-    data->ref_count = port_count;
+    /* each port holds a reference until it has sent the message */
+    data->ref_count = 1;
     while (port != NULL) {
         if (port->state == FINISHED) {
             port = port->next;
             continue;
         }
-        send_to_msgbox(port->port_id, &msg);
+        hold_data(data);
+        if (!send_to_msgbox(port->port_id, &msg)) {
+            check_data(data);
+        }
         port = port->next;
     }
+    check_data(data);
 }
 
 void init_npdu(
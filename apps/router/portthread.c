@@ -13,6 +13,15 @@
 #include <string.h>
 #include "portthread.h"
 
+/* the router port, and the next router if any, of a network */
+typedef struct _route {
+    ROUTER_PORT *port;
+    DNET *dnet; /* NULL if the network is directly connected */
+} ROUTE;
+
+/* routes of all of the networks, indexed by network number */
+static ROUTE Route_Table[BACNET_BROADCAST_NETWORK];
+
 ROUTER_PORT *find_snet(MSGBOX_ID id)
 {
     ROUTER_PORT *port = head;
@@ -29,67 +38,109 @@ ROUTER_PORT *find_snet(MSGBOX_ID id)
 
 ROUTER_PORT *find_dnet(uint16_t net, BACNET_ADDRESS *addr)
 {
-    ROUTER_PORT *port = head;
-    DNET *dnet;
+    ROUTE *route;
 
     /* for broadcast messages no search is needed */
     if (net == BACNET_BROADCAST_NETWORK) {
-        return port;
+        return head;
     }
 
-    while (port != NULL) {
-        /* check if DNET is directly connected to the router */
-        if (net == port->route_info.net) {
-            return port;
-
-            /* else search router ports DNET list */
-        } else if (port->route_info.dnets) {
-            dnet = port->route_info.dnets;
-            while (dnet != NULL) {
-                if (net == dnet->net) {
-                    if (addr) {
-                        memmove(&addr->len, &dnet->mac_len, 1);
-                        memmove(&addr->adr[0], &dnet->mac[0], MAX_MAC_LEN);
-                    }
-                    return port;
-                }
-                dnet = dnet->next;
-            }
+    route = &Route_Table[net];
+    if (route->dnet) {
+        /* a busy router is not used until it is available again */
+        if (!route->dnet->state) {
+            return NULL;
+        }
+        if (addr) {
+            memmove(&addr->len, &route->dnet->mac_len, 1);
+            memmove(&addr->adr[0], &route->dnet->mac[0], MAX_MAC_LEN);
         }
-        port = port->next;
     }
 
-    return NULL;
+    return route->port;
+}
+
+void add_port_net(ROUTER_PORT *port)
+{
+    if (port->route_info.net < BACNET_BROADCAST_NETWORK) {
+        Route_Table[port->route_info.net].port = port;
+        Route_Table[port->route_info.net].dnet = NULL;
+    }
 }
 
-void add_dnet(RT_ENTRY *route_info, uint16_t net, BACNET_ADDRESS addr)
+static void remove_dnet(ROUTER_PORT *port, DNET *dnet)
 {
-    DNET *dnet = route_info->dnets;
-    DNET *tmp;
-
-    if (dnet == NULL) {
-        route_info->dnets = (DNET *)malloc(sizeof(DNET));
-        memmove(&route_info->dnets->mac_len, &addr.len, 1);
-        memmove(&route_info->dnets->mac[0], &addr.adr[0], MAX_MAC_LEN);
-        route_info->dnets->net = net;
-        route_info->dnets->state = true;
-        route_info->dnets->next = NULL;
-    } else {
-        while (dnet != NULL) {
-            if (dnet->net == net) { /* make sure NETs are not repeated */
-                return;
-            }
-            tmp = dnet;
-            dnet = dnet->next;
+    DNET **next = &port->route_info.dnets;
+
+    while (*next != NULL) {
+        if (*next == dnet) {
+            *next = dnet->next;
+            dnet->next = NULL;
+            return;
         }
+        next = &(*next)->next;
+    }
+}
+
+void add_dnet(ROUTER_PORT *port, uint16_t net, BACNET_ADDRESS addr)
+{
+    ROUTE *route;
+    DNET *dnet;
+    DNET **next;
 
+    if (net >= BACNET_BROADCAST_NETWORK) {
+        return;
+    }
+    route = &Route_Table[net];
+    if (route->port && !route->dnet) {
+        /* never route a directly connected network elsewhere */
+        return;
+    }
+    dnet = route->dnet;
+    if (dnet && (route->port != port)) {
+        if (dnet->state) {
+            /* keep the route that was learned first */
+            return;
+        }
+        /* the router was busy: move the network to the new router */
+        remove_dnet(route->port, dnet);
+        route->port = NULL;
+    }
+    if (!dnet) {
         dnet = (DNET *)malloc(sizeof(DNET));
-        memmove(&dnet->mac_len, &addr.len, 1);
-        memmove(&dnet->mac[0], &addr.adr[0], MAX_MAC_LEN);
+        if (!dnet) {
+            return;
+        }
         dnet->net = net;
-        dnet->state = true;
         dnet->next = NULL;
-        tmp->next = dnet;
+    }
+    memmove(&dnet->mac_len, &addr.len, 1);
+    memmove(&dnet->mac[0], &addr.adr[0], MAX_MAC_LEN);
+    dnet->state = true;
+    if (route->port != port) {
+        /* append, to keep the order that the networks were learned */
+        next = &port->route_info.dnets;
+        while (*next != NULL) {
+            next = &(*next)->next;
+        }
+        *next = dnet;
+        route->port = port;
+        route->dnet = dnet;
+    }
+}
+
+void set_dnet_state(
+    ROUTER_PORT *port, uint16_t net, const BACNET_ADDRESS *addr, bool state)
+{
+    DNET *dnet = port->route_info.dnets;
+
+    while (dnet != NULL) {
+        if (((net == BACNET_BROADCAST_NETWORK) || (net == dnet->net)) &&
+            (dnet->mac_len == addr->len) &&
+            (memcmp(dnet->mac, addr->adr, dnet->mac_len) == 0)) {
+            dnet->state = state;
+        }
+        dnet = dnet->next;
     }
 }
 
@@ -97,6 +148,10 @@ void cleanup_dnets(DNET *dnets)
 {
     DNET *dnet = dnets;
     while (dnet != NULL) {
+        if (Route_Table[dnet->net].dnet == dnet) {
+            Route_Table[dnet->net].port = NULL;
+            Route_Table[dnet->net].dnet = NULL;
+        }
         dnet = dnet->next;
         free(dnets);
         dnets = dnet;
@@ -96,8 +96,16 @@ ROUTER_PORT *find_snet(MSGBOX_ID id);
 /* get sending router port */
 ROUTER_PORT *find_dnet(uint16_t net, BACNET_ADDRESS *addr);
 
+/* add directly connected network of router port to the routing table */
+void add_port_net(ROUTER_PORT *port);
+
 /* add reacheble network for specified router port */
-void add_dnet(RT_ENTRY *route_info, uint16_t net, BACNET_ADDRESS addr);
+void add_dnet(ROUTER_PORT *port, uint16_t net, BACNET_ADDRESS addr);
+
+/* set reacheble network, or all of the networks if net is the broadcast
+   network, of the router at addr as enabled or disabled (busy) */
+void set_dnet_state(
+    ROUTER_PORT *port, uint16_t net, const BACNET_ADDRESS *addr, bool state);
 
 void cleanup_dnets(DNET *dnets);
 
@@ -236,6 +236,15 @@ int main(int argc, char *argv[])
                     return 1;
                     break;
             }
+            if (bacnet_data_object_stale(
+                    target_device_object_instance, target_object_type,
+                    target_object_instance)) {
+                PRINTF(
+                    "Device %u %s-%u value is stale\n",
+                    (unsigned)target_device_object_instance,
+                    bactext_object_type_name(target_object_type),
+                    (unsigned)target_object_instance);
+            }
         }
     }
 
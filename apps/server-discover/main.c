@@ -54,6 +54,18 @@ static struct mstimer BACnet_TSM_Timer;
 static struct mstimer BACnet_Print_Timer;
 /* flag to determine if devices or both devices and objects are printed */
 static bool Print_Summary = false;
+/* file where the discovered devices are kept between runs */
+static const char *Cache_Filename = NULL;
+
+/**
+ * @brief Save the discovered devices to the cache file
+ */
+static void discover_cache_save(void)
+{
+    if (Cache_Filename && !bacnet_discover_save(Cache_Filename)) {
+        debug_fprintf(stderr, "Unable to save %s\n", Cache_Filename);
+    }
+}
 
 /**
  * @brief Print the list of discovered devices and their objects
@@ -71,9 +83,17 @@ static void print_discovered_devices(void)
     size_t heap_ram = 0;
     char model_name[MAX_CHARACTER_STRING_BYTES] = { 0 };
     char object_name[MAX_CHARACTER_STRING_BYTES] = { 0 };
+    BACNET_DISCOVER_PROGRESS progress = { 0 };
 
     device_count = bacnet_discover_device_count();
     printf("----list of %u devices ----\n", device_count);
+    bacnet_discover_progress(&progress);
+    printf(
+        "discovered %u of %u devices, requested %lu of %lu objects, "
+        "%lu replies in %lums (%lu/s)\n",
+        progress.devices_discovered, progress.devices,
+        progress.objects_requested, progress.objects, progress.replies,
+        progress.milliseconds, progress.replies_per_second);
     for (device_index = 0; device_index < device_count; device_index++) {
         device_id = bacnet_discover_device_instance(device_index);
         object_count = bacnet_discover_device_object_count(device_id);
@@ -176,6 +196,7 @@ static void print_usage(const char *filename)
 {
     printf("Usage: %s [--dnet][--dadr][--mac]\n", filename);
     printf("       [--discover-seconds][--print-seconds][--print-summary]\n");
+    printf("       [--cache filename]\n");
     printf("       [--version][--help]\n");
 }
 
@@ -191,6 +212,9 @@ static void print_help(const char *filename)
            "Number of seconds to wait before printing list of devices.\n");
     printf("--print-summary:\n"
            "Print only the list of devices.\n");
+    printf("--cache filename:\n"
+           "File where the discovered devices are saved and loaded,\n"
+           "so that only the devices that changed are discovered again.\n");
     printf("\n");
     printf("--dnet N\n"
            "Optional BACnet network number N for directed requests.\n"
@@ -260,6 +284,10 @@ int main(int argc, char *argv[])
             }
         } else if (strcmp(argv[argi], "--print-summary") == 0) {
             Print_Summary = true;
+        } else if (strcmp(argv[argi], "--cache") == 0) {
+            if (++argi < argc) {
+                Cache_Filename = argv[argi];
+            }
         } else if (strcmp(argv[argi], "--dnet") == 0) {
             if (++argi < argc) {
                 long_value = strtol(argv[argi], NULL, 0);
@@ -315,6 +343,12 @@ int main(int argc, char *argv[])
     bacnet_discover_seconds_set(discover_seconds);
     bacnet_discover_init();
     atexit(bacnet_discover_cleanup);
+    if (Cache_Filename) {
+        if (!bacnet_discover_load(Cache_Filename)) {
+            debug_printf_stdout("Unable to load %s\n", Cache_Filename);
+        }
+        atexit(discover_cache_save);
+    }
     mstimer_set(&BACnet_Print_Timer, print_seconds * 1000UL);
     /* loop forever */
     for (;;) {
@@ -323,6 +357,7 @@ int main(int argc, char *argv[])
         if (mstimer_expired(&BACnet_Print_Timer)) {
             mstimer_reset(&BACnet_Print_Timer);
             print_discovered_devices();
+            discover_cache_save();
         }
     }
 
@@ -103,7 +103,12 @@ static object_functions_t My_Object_Table[] = {
       NULL,
       NULL,
       NULL,
-      Device_Writable_Property_List },
+      Device_Writable_Property_List,
+      NULL,
+      NULL,
+      NULL,
+      NULL,
+      NULL },
 
     /* Analog Value (Read-Only) */
     { OBJECT_ANALOG_VALUE,
@@ -126,7 +131,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Value_Create,
       Analog_Value_Delete,
       NULL,
-      Analog_Value_Writable_Property_List },
+      Analog_Value_Writable_Property_List,
+      Analog_Value_Present_Value_Real,
+      NULL,
+      NULL,
+      NULL,
+      Analog_Value_Status_Flags },
 
     /* Analog Output (Commandable) */
     { OBJECT_ANALOG_OUTPUT,
@@ -149,7 +159,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Output_Create,
       Analog_Output_Delete,
       NULL,
-      Analog_Output_Writable_Property_List },
+      Analog_Output_Writable_Property_List,
+      Analog_Output_Present_Value_Real,
+      NULL,
+      NULL,
+      NULL,
+      Analog_Output_Status_Flags },
 
     /* Binary Output (Commandable) */
     { OBJECT_BINARY_OUTPUT,
@@ -172,7 +187,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Output_Create,
       Binary_Output_Delete,
       NULL,
-      Binary_Output_Writable_Property_List },
+      Binary_Output_Writable_Property_List,
+      NULL,
+      Binary_Output_Present_Value_Enumerated,
+      NULL,
+      NULL,
+      Binary_Output_Status_Flags },
 
     /* Binary Value (Read-Only) */
     { OBJECT_BINARY_VALUE,
@@ -195,7 +215,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Value_Create,
       Binary_Value_Delete,
       NULL,
-      Binary_Value_Writable_Property_List },
+      Binary_Value_Writable_Property_List,
+      NULL,
+      Binary_Value_Present_Value_Enumerated,
+      NULL,
+      NULL,
+      Binary_Value_Status_Flags },
 
     { MAX_BACNET_OBJECT_TYPE,
       NULL,
@@ -217,6 +242,11 @@ static object_functions_t My_Object_Table[] = {
       NULL,
       NULL,
       NULL,
+      NULL,
+      NULL,
+      NULL,
+      NULL,
+      NULL,
       NULL }
 };
 
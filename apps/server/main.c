@@ -25,6 +25,7 @@
 #include "bacnet/version.h"
 /* some demo stuff needed */
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/npdu/h_admission.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/filename.h"
 #include "bacnet/basic/sys/mstimer.h"
@@ -53,6 +54,10 @@
 #if defined(BAC_UCI)
 #include "bacnet/basic/ucix/ucix.h"
 #endif /* defined(BAC_UCI) */
+#if defined(__linux__) && defined(BACDL_BIP)
+#include "bip-workers.h"
+#define SERVER_BIP_WORKERS 1
+#endif
 
 /* (Doxygen note: The next two lines pull all the following Javadoc
  *  into the ServerDemo module.) */
@@ -75,6 +80,27 @@ static struct mstimer BACnet_Notification_Timer;
 static struct mstimer BACnet_Object_Timer;
 /** Buffer used for receiving */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+/* maximum number of packets handled before running the timers again */
+#ifndef SERVER_RECEIVE_BATCH
+#define SERVER_RECEIVE_BATCH 16
+#endif
+#if defined(SERVER_BIP_WORKERS)
+/* the worker threads only read the objects while they are not locked,
+   and only the owner of the lock keeps values in the property cache */
+#define SERVER_LOCK()                             \
+    do {                                          \
+        bip_workers_lock();                       \
+        Device_Property_Cache_Store_Enable(true); \
+    } while (0)
+#define SERVER_UNLOCK()                            \
+    do {                                           \
+        Device_Property_Cache_Store_Enable(false); \
+        bip_workers_unlock();                      \
+    } while (0)
+#else
+#define SERVER_LOCK()
+#define SERVER_UNLOCK()
+#endif
 
 /* configure an example structured view object subordinate list */
 #if (BACNET_PROTOCOL_REVISION >= 4)
@@ -117,6 +143,28 @@ static BACNET_SUBORDINATE_DATA Lighting_Subordinate[] = {
 #endif
 };
 static BACNET_WRITE_GROUP_NOTIFICATION Write_Group_Notification = { 0 };
+static BACNET_COV_NOTIFICATION Trend_Log_COV_Unconfirmed = { 0 };
+
+/**
+ * @brief Subscribe a Trend Log with a Logging_Type of COV to its
+ *  remote source, and bind to the remote device if needed
+ * @param device_id - device instance of the remote source
+ * @param cov_data - the subscription
+ * @return invoke ID of the request, or 0 if it was not sent
+ */
+static uint8_t Trend_Log_COV_Subscribe(
+    uint32_t device_id, const BACNET_SUBSCRIBE_COV_DATA *cov_data)
+{
+    BACNET_ADDRESS dest = { 0 };
+    unsigned max_apdu = 0;
+
+    if (!address_bind_request(device_id, &max_apdu, &dest)) {
+        Send_WhoIs(device_id, device_id);
+        return 0;
+    }
+
+    return Send_COV_Subscribe_Address(&dest, max_apdu, cov_data);
+}
 
 /**
  * @brief Update the strcutured view static data with device ID and linked lists
@@ -155,6 +203,20 @@ static void Structured_View_Update(void)
         instance, BACNET_RELATIONSHIP_CONTAINS);
 }
 
+/**
+ * @brief Set the clock from a TimeSynchronization service, and read it
+ *  back into the Device object so that its cached clock follows at once
+ * @param bdate - the date from the service
+ * @param btime - the time from the service
+ * @param utc - true for UTC synchronization
+ */
+static void
+Time_Synchronization(BACNET_DATE *bdate, BACNET_TIME *btime, bool utc)
+{
+    datetime_timesync(bdate, btime, utc);
+    Device_Local_Time_Refresh();
+}
+
 /** Initialize the handlers we will utilize.
  * @see Device_Init, apdu_set_unconfirmed_handler, apdu_set_confirmed_handler
  */
@@ -226,6 +288,11 @@ static void Init_Service_Handlers(void)
         SERVICE_CONFIRMED_SUBSCRIBE_COV, handler_cov_subscribe);
     apdu_set_unconfirmed_handler(
         SERVICE_UNCONFIRMED_COV_NOTIFICATION, handler_ucov_notification);
+    /* COV Trend Logs of remote objects subscribe, and bind with I-Am */
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, handler_i_am_bind);
+    Trend_Log_COV_Unconfirmed.callback = Trend_Log_COV_Notification;
+    handler_ucov_notification_add(&Trend_Log_COV_Unconfirmed);
+    Trend_Log_COV_Subscribe_Callback_Set(Trend_Log_COV_Subscribe);
     /* handle communication so we can shutup when asked */
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL,
@@ -264,6 +331,78 @@ static void Init_Service_Handlers(void)
 #endif
 }
 
+/**
+ * @brief Handle a received NPDU while the worker threads are locked out
+ * @param src [in] source address of the NPDU
+ * @param pdu [in] the NPDU
+ * @param pdu_len [in] number of bytes in the NPDU
+ */
+static void server_npdu_handler(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
+{
+    if (bacnet_admission_check(src, pdu, pdu_len) != BACNET_ADMISSION_ACCEPT) {
+        /* dropped, or deferred behind the other messages */
+        return;
+    }
+    SERVER_LOCK();
+    npdu_handler(src, pdu, pdu_len);
+    SERVER_UNLOCK();
+}
+
+/**
+ * @brief Print the counters of the admission control
+ */
+static void server_admission_cleanup(void)
+{
+    printf(
+        "Admission: %lu accepted, %lu deferred, %lu dropped by rate, "
+        "%lu duplicate discovery, %lu retries\n",
+        bacnet_admission_accepted(), bacnet_admission_deferred_count(),
+        bacnet_admission_dropped(BACNET_ADMISSION_DROP_RATE),
+        bacnet_admission_dropped(BACNET_ADMISSION_DROP_DISCOVERY),
+        bacnet_admission_dropped(BACNET_ADMISSION_DROP_RETRY));
+}
+
+/**
+ * @brief Get the time until a task timer expires
+ * @param t [in] the task timer
+ * @param timeout [in] the time until the earlier task timers expire
+ * @return the time until this or the earlier task timers expire
+ */
+static unsigned server_timer_deadline(const struct mstimer *t, unsigned timeout)
+{
+    unsigned long remaining = 0;
+
+    if (!mstimer_expired(t)) {
+        remaining = mstimer_remaining(t);
+    }
+    if (remaining < timeout) {
+        timeout = (unsigned)remaining;
+    }
+
+    return timeout;
+}
+
+/**
+ * @brief Get the time to wait for packets, which is until the next task
+ *  timer expires, so that an idle server sleeps instead of polling
+ * @return milliseconds to wait for packets
+ */
+static unsigned server_receive_timeout(void)
+{
+    unsigned timeout = 1000;
+
+    timeout = server_timer_deadline(&BACnet_Task_Timer, timeout);
+    timeout = server_timer_deadline(&BACnet_TSM_Timer, timeout);
+    timeout = server_timer_deadline(&BACnet_Address_Timer, timeout);
+#if defined(INTRINSIC_REPORTING)
+    timeout = server_timer_deadline(&BACnet_Notification_Timer, timeout);
+#endif
+    timeout = server_timer_deadline(&BACnet_Object_Timer, timeout);
+
+    return timeout;
+}
+
 static void print_usage(const char *filename)
 {
     printf("Usage: %s [device-instance [device-name]]\n", filename);
@@ -287,6 +426,16 @@ static void print_help(const char *filename)
         "To simulate Device 123 named Fred, use following command:\n"
         "%s 123 Fred\n",
         filename);
+    printf("\nBACNET_ADMISSION_RATE=n[,burst] (environment):\n"
+           "Admit at most n requests per second from each source,\n"
+           "and at most burst requests at once (default 2n).\n"
+           "Duplicate Who-Is and retried requests are dropped, and\n"
+           "reads are handled after the replies and the writes.\n");
+#if defined(SERVER_BIP_WORKERS)
+    printf("\nBACNET_IP_WORKERS=n (environment):\n"
+           "Answer ReadProperty and ReadPropertyMultiple requests\n"
+           "on n worker threads that share the BACnet/IP port.\n");
+#endif
 }
 
 /** Main function of server demo.
@@ -304,7 +453,7 @@ int main(int argc, char *argv[])
 {
     BACNET_ADDRESS src = { 0 }; /* address where message came from */
     uint16_t pdu_len = 0;
-    unsigned timeout = 1; /* milliseconds */
+    unsigned timeout = 0; /* milliseconds */
     uint32_t elapsed_milliseconds = 0;
     uint32_t elapsed_seconds = 0;
     BACNET_CHARACTER_STRING DeviceName;
@@ -318,6 +467,12 @@ int main(int argc, char *argv[])
 #endif
     int argi = 0;
     const char *filename = NULL;
+    char *pEnv = NULL;
+    unsigned rate = 0;
+    unsigned burst = 0;
+#if defined(SERVER_BIP_WORKERS)
+    unsigned workers = 0;
+#endif
 
     filename = filename_remove_path(argv[0]);
     for (argi = 1; argi < argc; argi++) {
@@ -367,7 +522,7 @@ int main(int argc, char *argv[])
     address_init();
     Init_Service_Handlers();
     /* initialize timesync callback function. */
-    handler_timesync_set_callback_set(&datetime_timesync);
+    handler_timesync_set_callback_set(&Time_Synchronization);
 
 #if defined(BAC_UCI)
     const char *uciname;
@@ -390,8 +545,47 @@ int main(int argc, char *argv[])
     if (Device_Object_Name(Device_Object_Instance_Number(), &DeviceName)) {
         printf("BACnet Device Name: %s\n", DeviceName.value);
     }
+    pEnv = getenv("BACNET_IAM_JITTER");
+    if (pEnv) {
+        handler_who_is_jitter_set(strtoul(pEnv, NULL, 0));
+    }
+    bacnet_admission_init();
+    pEnv = getenv("BACNET_ADMISSION_RATE");
+    if (pEnv) {
+        rate = strtoul(pEnv, &pEnv, 0);
+        burst = 2 * rate;
+        if (*pEnv == ',') {
+            burst = strtoul(pEnv + 1, NULL, 0);
+        }
+        bacnet_admission_rate_set(rate, burst);
+        if (bacnet_admission_enabled()) {
+            printf("Admission: %u requests per second\n", rate);
+            atexit(server_admission_cleanup);
+        }
+    }
+#if defined(SERVER_BIP_WORKERS)
+    pEnv = getenv("BACNET_IP_WORKERS");
+    if (pEnv) {
+        workers = strtoul(pEnv, NULL, 0);
+    }
+    if (workers > 0) {
+        bip_set_reuse_port(true);
+    }
+#endif
     dlenv_init();
     atexit(datalink_cleanup);
+#if defined(SERVER_BIP_WORKERS)
+    if (workers > 0) {
+        Device_Property_Cache_Store_Enable(false);
+        if (bip_workers_init(workers)) {
+            printf("BACnet/IP worker threads: %u\n", workers);
+            /* stop the workers before the datalink is closed */
+            atexit(bip_workers_cleanup);
+        } else {
+            fprintf(stderr, "Failed to start %u worker threads\n", workers);
+        }
+    }
+#endif
 #if BACNET_PROTOCOL_REVISION >= 22
     if (Device_Object_Instance_Number() == BACNET_MAX_INSTANCE) {
         apdu_set_unconfirmed_handler(
@@ -406,6 +600,7 @@ int main(int argc, char *argv[])
 #endif
     /* loop forever */
     for (;;) {
+        SERVER_LOCK();
         if (device_id != Device_Object_Instance_Number()) {
             device_id = Device_Object_Instance_Number();
             /* update structured view with this device instance */
@@ -415,13 +610,24 @@ int main(int argc, char *argv[])
                 Send_I_Am(&Handler_Transmit_Buffer[0]);
             }
         }
-        /* input */
-        pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, timeout);
-
-        /* process */
-        if (pdu_len) {
+        SERVER_UNLOCK();
+        /* input and process a burst of packets, or sleep until the
+           next task timer expires */
+        timeout = server_receive_timeout();
+        (void)datalink_receive_batch(
+            &src, &Rx_Buf[0], MAX_MPDU, timeout, SERVER_RECEIVE_BATCH,
+            server_npdu_handler);
+        /* the reads that were deferred behind the other messages */
+        for (;;) {
+            pdu_len = bacnet_admission_deferred(&src, &Rx_Buf[0], MAX_MPDU);
+            if (pdu_len == 0) {
+                break;
+            }
+            SERVER_LOCK();
             npdu_handler(&src, &Rx_Buf[0], pdu_len);
+            SERVER_UNLOCK();
         }
+        SERVER_LOCK();
         if (mstimer_expired(&BACnet_Task_Timer)) {
             mstimer_reset(&BACnet_Task_Timer);
             elapsed_milliseconds = mstimer_interval(&BACnet_Task_Timer);
@@ -434,6 +640,7 @@ int main(int argc, char *argv[])
             trend_log_timer(elapsed_seconds);
 #if defined(INTRINSIC_REPORTING)
             Device_local_reporting();
+            Notification_Class_Event_Queue_Timer(elapsed_milliseconds);
 #endif
 #if defined(BACNET_TIME_MASTER)
             Device_getCurrentDateTime(&bdatetime);
@@ -444,6 +651,7 @@ int main(int argc, char *argv[])
             mstimer_reset(&BACnet_TSM_Timer);
             elapsed_milliseconds = mstimer_interval(&BACnet_TSM_Timer);
             tsm_timer_milliseconds(elapsed_milliseconds);
+            bacnet_admission_timer(elapsed_milliseconds);
         }
         if (mstimer_expired(&BACnet_Address_Timer)) {
             mstimer_reset(&BACnet_Address_Timer);
@@ -452,6 +660,7 @@ int main(int argc, char *argv[])
             address_cache_timer(elapsed_seconds);
         }
         handler_cov_task();
+        handler_who_is_task();
 #if defined(INTRINSIC_REPORTING)
         if (mstimer_expired(&BACnet_Notification_Timer)) {
             mstimer_reset(&BACnet_Notification_Timer);
@@ -464,6 +673,7 @@ int main(int argc, char *argv[])
             elapsed_milliseconds = mstimer_interval(&BACnet_Object_Timer);
             Device_Timer(elapsed_milliseconds);
         }
+        SERVER_UNLOCK();
     }
 
     return 0;
@@ -0,0 +1,356 @@
+/**
+ * @file
+ * @brief command line tool that prints the events of a BACnet stack
+ * trace file, one event on each line, or as JSON.
+ *
+ * Usage:
+ * $ ./bactrace [--json] trace-file
+ *
+ * The trace file is written by a BACnet application that was built with
+ * BACNET_TRACE_ENABLED=1 and run with BACNET_TRACE_FILE=trace-file, when
+ * it exits or when it gets the SIGUSR1 signal.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/bacint.h"
+#include "bacnet/bactext.h"
+#include "bacnet/version.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/sys/perfstat.h"
+
+static const char *Datalink_Names[PERFSTAT_DATALINK_MAX] = {
+    "none", "bip", "bip6", "mstp", "ethernet", "arcnet", "zigbee", "bsc"
+};
+
+static const char *Npdu_Names[] = { "apdu", "network-message", "discarded",
+                                    "decode-error" };
+
+static const char *Tsm_State_Names[] = { "idle", "await-confirmation",
+                                         "await-response", "segmented-request",
+                                         "segmented-confirmation" };
+
+static const char *Pdu_Type_Names[] = {
+    "confirmed-request", "unconfirmed-request", "simple-ack", "complex-ack",
+    "segment-ack",       "error",               "reject",     "abort"
+};
+
+/* print the events as one JSON object, instead of one on each line */
+static bool Json_Output;
+
+/**
+ * @brief Get a name from a table of names
+ * @param names - the table
+ * @param count - number of names in the table
+ * @param index - index of the name
+ * @return the name, or "unknown"
+ */
+static const char *
+trace_name(const char *const *names, unsigned count, unsigned index)
+{
+    if (index < count) {
+        return names[index];
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief Print a field of an event that is a name
+ * @param field - name of the field
+ * @param value - the name
+ */
+static void print_name_field(const char *field, const char *value)
+{
+    if (Json_Output) {
+        printf(",\"%s\":\"%s\"", field, value);
+    } else {
+        printf(" %s=%s", field, value);
+    }
+}
+
+/**
+ * @brief Print a field of an event that is a number
+ * @param field - name of the field
+ * @param value - the number
+ */
+static void print_number_field(const char *field, unsigned long value)
+{
+    if (Json_Output) {
+        printf(",\"%s\":%lu", field, value);
+    } else {
+        printf(" %s=%lu", field, value);
+    }
+}
+
+/**
+ * @brief Get the name of the service of an APDU
+ * @param pdu_type - BACNET_PDU_TYPE of the APDU
+ * @param service - service choice of the APDU
+ * @return the name of the service, or NULL when the APDU has none
+ */
+static const char *apdu_service_name(uint8_t pdu_type, uint16_t service)
+{
+    switch (pdu_type) {
+        case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
+        case PDU_TYPE_SIMPLE_ACK:
+        case PDU_TYPE_COMPLEX_ACK:
+        case PDU_TYPE_ERROR:
+            return bactext_confirmed_service_name(service);
+        case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
+            return bactext_unconfirmed_service_name(service);
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Print an event
+ * @param ring - index of the ring of the event
+ * @param event - the event
+ */
+static void print_event(unsigned ring, const BACTRACE_EVENT *event)
+{
+    const char *service_name;
+
+    if (Json_Output) {
+        printf(
+            "{\"ring\":%u,\"time\":%lu,\"event\":\"%s\"", ring,
+            (unsigned long)event->time, bactrace_event_name(event->type));
+    } else {
+        printf(
+            "%u %10lu %s", ring, (unsigned long)event->time,
+            bactrace_event_name(event->type));
+    }
+    switch (event->type) {
+        case BACTRACE_EVENT_DATALINK_RECEIVE:
+        case BACTRACE_EVENT_DATALINK_SEND:
+            print_name_field(
+                "datalink",
+                trace_name(
+                    Datalink_Names, PERFSTAT_DATALINK_MAX, event->arg8));
+            print_number_field("length", event->arg16);
+            break;
+        case BACTRACE_EVENT_NPDU:
+            print_name_field(
+                "npdu",
+                trace_name(
+                    Npdu_Names, sizeof(Npdu_Names) / sizeof(Npdu_Names[0]),
+                    event->arg8));
+            print_number_field("dnet", event->arg16);
+            print_number_field("snet", event->arg32[0]);
+            print_number_field("length", event->arg32[1]);
+            break;
+        case BACTRACE_EVENT_APDU_BEGIN:
+            print_name_field(
+                "pdu",
+                trace_name(
+                    Pdu_Type_Names,
+                    sizeof(Pdu_Type_Names) / sizeof(Pdu_Type_Names[0]),
+                    event->arg8 >> 4));
+            print_number_field("length", event->arg16);
+            break;
+        case BACTRACE_EVENT_APDU_END:
+            print_name_field(
+                "pdu",
+                trace_name(
+                    Pdu_Type_Names,
+                    sizeof(Pdu_Type_Names) / sizeof(Pdu_Type_Names[0]),
+                    event->arg8 >> 4));
+            service_name = apdu_service_name(event->arg8, event->arg16);
+            if (service_name) {
+                print_name_field("service", service_name);
+            }
+            break;
+        case BACTRACE_EVENT_TSM_STATE:
+            print_name_field(
+                "state",
+                trace_name(
+                    Tsm_State_Names,
+                    sizeof(Tsm_State_Names) / sizeof(Tsm_State_Names[0]),
+                    event->arg8));
+            print_number_field("invoke-id", event->arg16);
+            print_number_field("index", event->arg32[0]);
+            print_number_field("retries", event->arg32[1]);
+            break;
+        case BACTRACE_EVENT_COV_SEND:
+            print_name_field("confirmed", event->arg8 ? "true" : "false");
+            print_number_field("count", event->arg16);
+            print_name_field(
+                "object-type",
+                bactext_object_type_name(BACNET_TYPE(event->arg32[0])));
+            print_number_field(
+                "object-instance", BACNET_INSTANCE(event->arg32[0]));
+            print_number_field("process-id", event->arg32[1]);
+            break;
+        default:
+            break;
+    }
+    if (Json_Output) {
+        printf("}");
+    } else {
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Print the events of a trace file
+ * @param file - the trace file
+ * @return true if the whole file was read
+ */
+static bool print_trace_file(FILE *file)
+{
+    uint8_t buffer[BACTRACE_FILE_HEADER_SIZE];
+    BACTRACE_EVENT event;
+    uint16_t version = 0, event_size = 0;
+    uint32_t rings = 0, dropped = 0, count = 0, lost = 0, i;
+    unsigned ring;
+
+    if (fread(buffer, BACTRACE_FILE_HEADER_SIZE, 1, file) != 1) {
+        fprintf(stderr, "Error: trace file header is missing\n");
+        return false;
+    }
+    if (memcmp(&buffer[0], BACTRACE_FILE_MAGIC, BACTRACE_FILE_MAGIC_SIZE) !=
+        0) {
+        fprintf(stderr, "Error: not a trace file\n");
+        return false;
+    }
+    (void)decode_unsigned16(&buffer[8], &version);
+    (void)decode_unsigned16(&buffer[10], &event_size);
+    (void)decode_unsigned32(&buffer[12], &rings);
+    (void)decode_unsigned32(&buffer[16], &dropped);
+    if ((version != BACTRACE_FILE_VERSION) ||
+        (event_size != BACTRACE_EVENT_SIZE)) {
+        fprintf(
+            stderr, "Error: trace file version %u is not supported\n",
+            (unsigned)version);
+        return false;
+    }
+    if (Json_Output) {
+        printf("{\"dropped\":%lu,\"rings\":[", (unsigned long)dropped);
+    }
+    for (ring = 0; ring < rings; ring++) {
+        if (fread(buffer, BACTRACE_FILE_RING_HEADER_SIZE, 1, file) != 1) {
+            fprintf(stderr, "Error: ring %u header is missing\n", ring);
+            return false;
+        }
+        (void)decode_unsigned32(&buffer[0], &count);
+        (void)decode_unsigned32(&buffer[4], &lost);
+        if (Json_Output) {
+            printf(
+                "%s\n{\"lost\":%lu,\"events\":[", (ring > 0) ? "," : "",
+                (unsigned long)lost);
+        }
+        for (i = 0; i < count; i++) {
+            if (fread(buffer, BACTRACE_EVENT_SIZE, 1, file) != 1) {
+                fprintf(stderr, "Error: ring %u event is missing\n", ring);
+                return false;
+            }
+            bactrace_event_decode(buffer, &event);
+            if (Json_Output && (i > 0)) {
+                printf(",");
+            }
+            if (Json_Output) {
+                printf("\n");
+            }
+            print_event(ring, &event);
+        }
+        if (Json_Output) {
+            printf("]}");
+        } else {
+            printf(
+                "ring %u: %lu events, %lu lost\n", ring, (unsigned long)count,
+                (unsigned long)lost);
+        }
+    }
+    if (Json_Output) {
+        printf("]}\n");
+    } else {
+        printf("dropped: %lu events\n", (unsigned long)dropped);
+    }
+
+    return true;
+}
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--json] trace-file\n", filename);
+    printf("       [--help][--version]\n");
+}
+
+static void print_help(const char *filename)
+{
+    printf("Print the events of a BACnet stack trace file.\n");
+    printf("\n");
+    printf("trace-file:\n"
+           "file written by a BACnet application built with\n"
+           "BACNET_TRACE_ENABLED=1 and run with BACNET_TRACE_FILE set,\n"
+           "when it exits, or when it is sent the SIGUSR1 signal.\n");
+    printf("\n");
+    printf("--json\n"
+           "Print the events as JSON, instead of one on each line.\n");
+    printf("\n");
+    printf(
+        "Example:\n"
+        "BACNET_TRACE_FILE=bacserv.trace bacserv 1234\n"
+        "%s bacserv.trace\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *pathname = NULL;
+    const char *filename = NULL;
+    FILE *file;
+    bool status;
+    int argi;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2026 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+        if (strcmp(argv[argi], "--json") == 0) {
+            Json_Output = true;
+        } else if (!pathname) {
+            pathname = argv[argi];
+        }
+    }
+    if (!pathname) {
+        print_usage(filename);
+        return 1;
+    }
+    file = fopen(pathname, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: unable to open %s\n", pathname);
+        return 1;
+    }
+    status = print_trace_file(file);
+    fclose(file);
+
+    return status ? 0 : 1;
+}
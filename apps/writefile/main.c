@@ -31,6 +31,11 @@
 #include "bacnet/datalink/dlenv.h"
 #include "bacport.h"
 
+/* the largest number of AtomicWriteFile requests that are in flight */
+#ifndef WRITEFILE_WINDOW_MAX
+#define WRITEFILE_WINDOW_MAX 32
+#endif
+
 /* buffer used for receive */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
 
@@ -39,11 +44,46 @@ static uint32_t Target_File_Object_Instance = 4194303;
 static uint32_t Target_Device_Object_Instance = 4194303;
 static uint32_t Target_File_Requested_Octet_Count;
 static uint8_t Target_File_Requested_Octet_Pad_Byte;
+static bool Target_File_Requested_Octet_Pad;
 static BACNET_ADDRESS Target_Address;
 static char *Local_File_Name = NULL;
+static FILE *Local_File = NULL;
 static bool End_Of_File_Detected = false;
 static bool Error_Detected = false;
-static uint8_t Current_Invoke_ID = 0;
+/* the requests in flight, each writing a chunk of the file */
+struct write_request {
+    uint8_t invoke_id;
+    int32_t position;
+};
+static struct write_request Write_Request[WRITEFILE_WINDOW_MAX];
+static unsigned int Write_Window = 4;
+/* file position of the next chunk to be sent */
+static int32_t Next_File_Position;
+/* true once the chunk at the start of the file was written */
+static bool Start_Of_File_Written;
+
+/**
+ * @brief Find the request in flight for a response
+ * @param src - address of the device that sent the response
+ * @param invoke_id - invoke ID of the response
+ * @return the request, or NULL if the response is not for a request
+ */
+static struct write_request *
+write_request_find(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    unsigned int i;
+
+    if ((invoke_id == 0) || !address_match(&Target_Address, src)) {
+        return NULL;
+    }
+    for (i = 0; i < Write_Window; i++) {
+        if (Write_Request[i].invoke_id == invoke_id) {
+            return &Write_Request[i];
+        }
+    }
+
+    return NULL;
+}
 
 static void Atomic_Write_File_Error_Handler(
     BACNET_ADDRESS *src,
@@ -51,8 +91,7 @@ static void Atomic_Write_File_Error_Handler(
     BACNET_ERROR_CLASS error_class,
     BACNET_ERROR_CODE error_code)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Current_Invoke_ID)) {
+    if (write_request_find(src, invoke_id)) {
         printf("\r\nBACnet Error!\r\n");
         printf("Error Class: %s\r\n", bactext_error_class_name(error_class));
         printf("Error Code: %s\r\n", bactext_error_code_name(error_code));
@@ -64,8 +103,7 @@ static void MyAbortHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
 {
     (void)server;
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Current_Invoke_ID)) {
+    if (write_request_find(src, invoke_id)) {
         printf(
             "BACnet Abort: %s\r\n",
             bactext_abort_reason_name((int)abort_reason));
@@ -76,8 +114,7 @@ static void MyAbortHandler(
 static void
 MyRejectHandler(BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Current_Invoke_ID)) {
+    if (write_request_find(src, invoke_id)) {
         printf(
             "BACnet Reject: %s\r\n",
             bactext_reject_reason_name((int)reject_reason));
@@ -128,6 +165,146 @@ static void Init_Service_Handlers(void)
     apdu_set_reject_handler(MyRejectHandler);
 }
 
+/**
+ * @brief Determine the number of octets to send in each chunk
+ * @param max_apdu - the maximum APDU accepted by the device
+ * @return number of octets to send in each chunk
+ * @note The requests are sent unsegmented, so a chunk fits in one APDU
+ *  whatever the segmentation supported by the device.
+ */
+static unsigned int file_octet_count(unsigned max_apdu)
+{
+    unsigned int octet_count = 0;
+    uint16_t my_max_apdu = 0;
+
+    /* calculate the smaller of our APDU size or theirs
+       and remove the overhead of the APDU (varies depending on
+       size). note: we could fail if there is a bottle neck (router)
+       and smaller MPDU in betweeen. */
+    if (max_apdu < MAX_APDU) {
+        my_max_apdu = max_apdu;
+    } else {
+        my_max_apdu = MAX_APDU;
+    }
+    /* Typical sizes are 50, 128, 206, 480, 1024, and 1476 octets */
+    if (my_max_apdu <= 50) {
+        octet_count = my_max_apdu - 19;
+    } else if (my_max_apdu <= 480) {
+        octet_count = my_max_apdu - 32;
+    } else if (my_max_apdu <= 1476) {
+        octet_count = my_max_apdu - 64;
+    } else {
+        octet_count = my_max_apdu / 2;
+    }
+
+    return octet_count;
+}
+
+/**
+ * @brief Send the chunks of the file, keeping the window of requests
+ *  in flight.  A chunk that could not be sent is read and sent again
+ *  later.
+ * @param octet_count - number of octets in each chunk
+ */
+static void write_requests_send(unsigned int octet_count)
+{
+    static BACNET_OCTET_STRING fileData;
+    struct write_request *request;
+    uint8_t invoke_id = 0;
+    size_t len = 0;
+    unsigned int i;
+
+    for (i = 0; i < Write_Window; i++) {
+        request = &Write_Request[i];
+        if (request->invoke_id != 0) {
+            continue;
+        }
+        if (End_Of_File_Detected) {
+            break;
+        }
+        /* the chunk at the start of the file is a clean slate for the
+           device, so it is written before any of the others are sent */
+        if ((Next_File_Position > 0) && !Start_Of_File_Written) {
+            break;
+        }
+        len = 0;
+        if (fseek(Local_File, Next_File_Position, SEEK_SET) == 0) {
+            len = fread(
+                octetstring_value(&fileData), 1, octet_count, Local_File);
+        }
+        if ((len == 0) && (Next_File_Position > 0)) {
+            /* nothing is left to send */
+            End_Of_File_Detected = true;
+            break;
+        }
+        if ((len < octet_count) && Target_File_Requested_Octet_Pad) {
+            memset(
+                octetstring_value(&fileData) + len,
+                (int)Target_File_Requested_Octet_Pad_Byte, octet_count - len);
+            len = octet_count;
+        }
+        octetstring_truncate(&fileData, len);
+        invoke_id = Send_Atomic_Write_File_Stream(
+            Target_Device_Object_Instance, Target_File_Object_Instance,
+            Next_File_Position, &fileData);
+        if (invoke_id == 0) {
+            break;
+        }
+        request->invoke_id = invoke_id;
+        request->position = Next_File_Position;
+        printf("\rSending %d bytes", (int)(Next_File_Position + len));
+        Next_File_Position += (int32_t)octet_count;
+        if (feof(Local_File) || (len < octet_count)) {
+            End_Of_File_Detected = true;
+        }
+    }
+}
+
+/**
+ * @brief Check the requests in flight
+ * @return true if all of the chunks were sent and acknowledged
+ */
+static bool write_requests_done(void)
+{
+    struct write_request *request;
+    bool done = End_Of_File_Detected;
+    unsigned int i;
+
+    for (i = 0; i < Write_Window; i++) {
+        request = &Write_Request[i];
+        if (request->invoke_id == 0) {
+            continue;
+        }
+        if (tsm_invoke_id_failed_peer(&Target_Address, request->invoke_id)) {
+            fprintf(stderr, "\rError: TSM Timeout!\r\n");
+            tsm_free_invoke_id_peer(&Target_Address, request->invoke_id);
+            request->invoke_id = 0;
+            /* try again or abort? */
+            Error_Detected = true;
+        } else if (tsm_invoke_id_free_peer(
+                       &Target_Address, request->invoke_id)) {
+            /* acknowledged, or the error was handled */
+            request->invoke_id = 0;
+            if ((request->position == 0) && !Error_Detected) {
+                Start_Of_File_Written = true;
+            }
+        } else {
+            done = false;
+        }
+    }
+
+    return done;
+}
+
+static void print_usage(const char *filename)
+{
+    printf(
+        "Usage: %s device-instance file-instance local-name "
+        "[octet-count] [pad-value]\n",
+        filename);
+    printf("       [--window N]\n");
+}
+
 int main(int argc, char *argv[])
 {
     BACNET_ADDRESS src = { 0 }; /* address where message came from */
@@ -138,32 +315,43 @@ int main(int argc, char *argv[])
     time_t last_seconds = 0;
     time_t current_seconds = 0;
     time_t timeout_seconds = 0;
-    int fileStartPosition = 0;
     unsigned requestedOctetCount = 0;
-    uint8_t invoke_id = 0;
     bool found = false;
-    uint16_t my_max_apdu = 0;
-    FILE *pFile = NULL;
-    static BACNET_OCTET_STRING fileData;
-    size_t len = 0;
-    bool pad_byte = false;
+    int argi = 0;
+    unsigned int target_args = 0;
 
-    if (argc < 4) {
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--window") == 0) {
+            if (++argi < argc) {
+                Write_Window = strtol(argv[argi], NULL, 0);
+            }
+        } else if (target_args == 0) {
+            Target_Device_Object_Instance = strtol(argv[argi], NULL, 0);
+            target_args++;
+        } else if (target_args == 1) {
+            Target_File_Object_Instance = strtol(argv[argi], NULL, 0);
+            target_args++;
+        } else if (target_args == 2) {
+            if (!filename_path_valid(argv[argi])) {
+                fprintf(stderr, "Invalid file path: %s\n", argv[argi]);
+                return 1;
+            }
+            Local_File_Name = argv[argi];
+            target_args++;
+        } else if (target_args == 3) {
+            Target_File_Requested_Octet_Count = strtol(argv[argi], NULL, 0);
+            target_args++;
+        } else if (target_args == 4) {
+            Target_File_Requested_Octet_Pad_Byte = strtol(argv[argi], NULL, 0);
+            Target_File_Requested_Octet_Pad = true;
+            target_args++;
+        }
+    }
+    if (target_args < 3) {
         /* FIXME: what about access method - record or stream? */
-        printf(
-            "%s device-instance file-instance local-name [octet count] [pad "
-            "value]\r\n",
-            filename_remove_path(argv[0]));
+        print_usage(filename_remove_path(argv[0]));
         return 0;
     }
-    /* decode the command line parameters */
-    Target_Device_Object_Instance = strtol(argv[1], NULL, 0);
-    Target_File_Object_Instance = strtol(argv[2], NULL, 0);
-    if (!filename_path_valid(argv[3])) {
-        fprintf(stderr, "Invalid file path: %s\n", argv[3]);
-        return 1;
-    }
-    Local_File_Name = argv[3];
     if (Target_Device_Object_Instance > BACNET_MAX_INSTANCE) {
         fprintf(
             stderr, "device-instance=%u - not greater than %u\r\n",
@@ -176,12 +364,25 @@ int main(int argc, char *argv[])
             Target_File_Object_Instance, BACNET_MAX_INSTANCE);
         return 1;
     }
-    if (argc > 4) {
-        Target_File_Requested_Octet_Count = strtol(argv[4], NULL, 0);
+    if (Target_File_Requested_Octet_Count > MAX_OCTET_STRING_BYTES) {
+        fprintf(
+            stderr, "octet-count=%u - not greater than %u\r\n",
+            (unsigned)Target_File_Requested_Octet_Count,
+            (unsigned)MAX_OCTET_STRING_BYTES);
+        return 1;
+    }
+    if ((Write_Window < 1) || (Write_Window > WRITEFILE_WINDOW_MAX)) {
+        fprintf(
+            stderr, "window=%u - not from 1 to %u\r\n", Write_Window,
+            (unsigned)WRITEFILE_WINDOW_MAX);
+        return 1;
     }
-    if (argc > 5) {
-        Target_File_Requested_Octet_Pad_Byte = strtol(argv[5], NULL, 0);
-        pad_byte = true;
+    Local_File = fopen(Local_File_Name, "rb");
+    if (!Local_File) {
+        fprintf(
+            stderr, "Unable to open file \"%s\" for reading.\r\n",
+            Local_File_Name);
+        return 1;
     }
     /* setup my info */
     Device_Set_Object_Instance_Number(BACNET_MAX_INSTANCE);
@@ -222,74 +423,20 @@ int main(int argc, char *argv[])
                 Target_Device_Object_Instance, &max_apdu, &Target_Address);
         }
         if (found) {
-            if (Target_File_Requested_Octet_Count) {
-                requestedOctetCount = Target_File_Requested_Octet_Count;
-            } else {
-                /* calculate the smaller of our APDU size or theirs
-                   and remove the overhead of the APDU (varies depending on
-                   size). note: we could fail if there is a bottle neck (router)
-                   and smaller MPDU in betweeen. */
-                if (max_apdu < MAX_APDU) {
-                    my_max_apdu = max_apdu;
-                } else {
-                    my_max_apdu = MAX_APDU;
-                }
-                /* Typical sizes are 50, 128, 206, 480, 1024, and 1476 octets */
-                if (my_max_apdu <= 50) {
-                    requestedOctetCount = my_max_apdu - 19;
-                } else if (my_max_apdu <= 480) {
-                    requestedOctetCount = my_max_apdu - 32;
-                } else if (my_max_apdu <= 1476) {
-                    requestedOctetCount = my_max_apdu - 64;
+            if (requestedOctetCount == 0) {
+                if (Target_File_Requested_Octet_Count) {
+                    requestedOctetCount = Target_File_Requested_Octet_Count;
                 } else {
-                    requestedOctetCount = my_max_apdu / 2;
+                    requestedOctetCount = file_octet_count(max_apdu);
                 }
             }
-            /* has the previous invoke id expired or returned?
-               note: invoke ID = 0 is invalid, so it will be idle */
-            if ((invoke_id == 0) || tsm_invoke_id_free(invoke_id)) {
-                if (End_Of_File_Detected || Error_Detected) {
-                    printf("\r\n");
-                    break;
-                }
-                if (invoke_id != 0) {
-                    fileStartPosition += requestedOctetCount;
-                }
-                /* we'll read the file in chunks
-                   less than max_apdu to keep unsegmented */
-                pFile = fopen(Local_File_Name, "rb");
-                if (pFile) {
-                    (void)fseek(pFile, fileStartPosition, SEEK_SET);
-                    len = fread(
-                        octetstring_value(&fileData), 1, requestedOctetCount,
-                        pFile);
-                    if (len < requestedOctetCount) {
-                        End_Of_File_Detected = true;
-                        if (pad_byte) {
-                            memset(
-                                octetstring_value(&fileData) + len + 1,
-                                (int)Target_File_Requested_Octet_Pad_Byte,
-                                requestedOctetCount - len);
-                            len = requestedOctetCount;
-                        }
-                    }
-                    octetstring_truncate(&fileData, len);
-                    fclose(pFile);
-                } else {
-                    End_Of_File_Detected = true;
-                }
-                printf("\rSending %d bytes", (int)(fileStartPosition + len));
-                invoke_id = Send_Atomic_Write_File_Stream(
-                    Target_Device_Object_Instance, Target_File_Object_Instance,
-                    fileStartPosition, &fileData);
-                Current_Invoke_ID = invoke_id;
-            } else if (tsm_invoke_id_failed(invoke_id)) {
-                fprintf(stderr, "\rError: TSM Timeout!\r\n");
-                tsm_free_invoke_id(invoke_id);
-                Error_Detected = true;
-                /* try again or abort? */
+            if (write_requests_done() || Error_Detected) {
+                printf("\r\n");
                 break;
             }
+            /* we'll send the file in chunks
+               less than max_apdu to keep unsegmented */
+            write_requests_send(requestedOctetCount);
         } else {
             /* increment timer - exit if timed out */
             elapsed_seconds += (current_seconds - last_seconds);
@@ -302,6 +449,7 @@ int main(int argc, char *argv[])
         /* keep track of time for next check */
         last_seconds = current_seconds;
     }
+    fclose(Local_File);
 
     if (Error_Detected) {
         return 1;
@@ -0,0 +1,63 @@
+/**************************************************************************
+*
+* SPDX-License-Identifier: MIT
+*
+*********************************************************************/
+#ifndef DEVICE_OBJECTS_H
+#define DEVICE_OBJECTS_H
+
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/ai.h"
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/bi.h"
+#include "bacnet/basic/object/bo.h"
+#if (BACNET_PROTOCOL_REVISION >= 17)
+#include "bacnet/basic/object/netport.h"
+#endif
+
+/* The object types of this device. device.c expands the list into a
+   constant table in flash, and into a switch that finds the entry of an
+   object type. Each entry is:
+   X(object type, init, count, index-to-instance, valid-instance,
+     object-name, read-property, write-property, property-lists) */
+#define DEVICE_OBJECTS_BASE(X) \
+    X(OBJECT_DEVICE, NULL, Device_Count, Device_Index_To_Instance, \
+        Device_Valid_Object_Instance_Number, Device_Object_Name, \
+        Device_Read_Property_Local, Device_Write_Property_Local, \
+        Device_Property_Lists) \
+    X(OBJECT_ANALOG_INPUT, Analog_Input_Init, Analog_Input_Count, \
+        Analog_Input_Index_To_Instance, Analog_Input_Valid_Instance, \
+        Analog_Input_Object_Name, Analog_Input_Read_Property, NULL, \
+        Analog_Input_Property_Lists) \
+    X(OBJECT_ANALOG_VALUE, Analog_Value_Init, Analog_Value_Count, \
+        Analog_Value_Index_To_Instance, Analog_Value_Valid_Instance, \
+        Analog_Value_Object_Name, Analog_Value_Read_Property, \
+        Analog_Value_Write_Property, Analog_Value_Property_Lists) \
+    X(OBJECT_BINARY_INPUT, Binary_Input_Init, Binary_Input_Count, \
+        Binary_Input_Index_To_Instance, Binary_Input_Valid_Instance, \
+        Binary_Input_Object_Name, Binary_Input_Read_Property, NULL, \
+        Binary_Input_Property_Lists) \
+    X(OBJECT_BINARY_OUTPUT, Binary_Output_Init, Binary_Output_Count, \
+        Binary_Output_Index_To_Instance, Binary_Output_Valid_Instance, \
+        Binary_Output_Object_Name, Binary_Output_Read_Property, \
+        Binary_Output_Write_Property, Binary_Output_Property_Lists)
+
+#if (BACNET_PROTOCOL_REVISION >= 17)
+#define DEVICE_OBJECTS(X) \
+    DEVICE_OBJECTS_BASE(X) \
+    X(OBJECT_NETWORK_PORT, Network_Port_Init, Network_Port_Count, \
+        Network_Port_Index_To_Instance, Network_Port_Valid_Instance, \
+        Network_Port_Object_Name, Network_Port_Read_Property, \
+        Network_Port_Write_Property, Network_Port_Property_Lists)
+#else
+#define DEVICE_OBJECTS(X) DEVICE_OBJECTS_BASE(X)
+#endif
+
+/* the object table is read from flash where the compiler can */
+#if defined(__FLASH) || defined(__ICCAVR__)
+#define DEVICE_OBJECTS_FLASH __flash
+#else
+#define DEVICE_OBJECTS_FLASH
+#endif
+
+#endif
@@ -24,14 +24,7 @@
 #include "bname.h"
 #include "bacnet/proplist.h"
 /* objects */
-#include "bacnet/basic/object/device.h"
-#if (BACNET_PROTOCOL_REVISION >= 17)
-#include "bacnet/basic/object/netport.h"
-#endif
-#include "bacnet/basic/object/ai.h"
-#include "bacnet/basic/object/av.h"
-#include "bacnet/basic/object/bi.h"
-#include "bacnet/basic/object/bo.h"
+#include "device-objects.h"
 
 /* current version of the BACnet stack */
 static const char *BACnet_Version = BACNET_VERSION_TEXT;
@@ -40,7 +33,7 @@ static const char *BACnet_Version = BACNET_VERSION_TEXT;
 int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata);
 bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data);
 
-static struct my_object_functions {
+struct my_object_functions {
     BACNET_OBJECT_TYPE Object_Type;
     object_init_function Object_Init;
     object_count_function Object_Count;
@@ -50,34 +43,26 @@ static struct my_object_functions {
     read_property_function Object_Read_Property;
     write_property_function Object_Write_Property;
     rpm_property_lists_function Object_RPM_List;
-} Object_Table[] = { { OBJECT_DEVICE, NULL, /* don't init - recursive! */
-                         Device_Count, Device_Index_To_Instance,
-                         Device_Valid_Object_Instance_Number,
-                         Device_Object_Name, Device_Read_Property_Local,
-                         Device_Write_Property_Local, Device_Property_Lists },
-    { OBJECT_ANALOG_INPUT, Analog_Input_Init, Analog_Input_Count,
-        Analog_Input_Index_To_Instance, Analog_Input_Valid_Instance,
-        Analog_Input_Object_Name, Analog_Input_Read_Property, NULL,
-        Analog_Input_Property_Lists },
-    { OBJECT_ANALOG_VALUE, Analog_Value_Init, Analog_Value_Count,
-        Analog_Value_Index_To_Instance, Analog_Value_Valid_Instance,
-        Analog_Value_Object_Name, Analog_Value_Read_Property,
-        Analog_Value_Write_Property, Analog_Value_Property_Lists },
-    { OBJECT_BINARY_INPUT, Binary_Input_Init, Binary_Input_Count,
-        Binary_Input_Index_To_Instance, Binary_Input_Valid_Instance,
-        Binary_Input_Object_Name, Binary_Input_Read_Property, NULL,
-        Binary_Input_Property_Lists },
-    { OBJECT_BINARY_OUTPUT, Binary_Output_Init, Binary_Output_Count,
-        Binary_Output_Index_To_Instance, Binary_Output_Valid_Instance,
-        Binary_Output_Object_Name, Binary_Output_Read_Property,
-        Binary_Output_Write_Property, Binary_Output_Property_Lists },
-#if (BACNET_PROTOCOL_REVISION >= 17)
-    { OBJECT_NETWORK_PORT, Network_Port_Init, Network_Port_Count,
-        Network_Port_Index_To_Instance, Network_Port_Valid_Instance,
-        Network_Port_Object_Name, Network_Port_Read_Property,
-        Network_Port_Write_Property, Network_Port_Property_Lists },
-#endif
-    { MAX_BACNET_OBJECT_TYPE, NULL, NULL, NULL, NULL, NULL, NULL, NULL } };
+};
+
+/* index of each object type in the object table */
+enum my_object_index {
+#define DEVICE_OBJECT_INDEX(type, init, count, index, valid, name, rp, wp, \
+    lists) \
+    MY_OBJECT_INDEX_##type,
+    DEVICE_OBJECTS(DEVICE_OBJECT_INDEX)
+#undef DEVICE_OBJECT_INDEX
+    MY_OBJECT_TABLE_SIZE
+};
+
+static const DEVICE_OBJECTS_FLASH struct my_object_functions
+    Object_Table[MY_OBJECT_TABLE_SIZE] = {
+#define DEVICE_OBJECT_ENTRY(type, init, count, index, valid, name, rp, wp, \
+    lists) \
+    { type, init, count, index, valid, name, rp, wp, lists },
+        DEVICE_OBJECTS(DEVICE_OBJECT_ENTRY)
+#undef DEVICE_OBJECT_ENTRY
+    };
 
 /* note: you really only need to define variables for
    properties that are writable or that may change.
@@ -105,19 +90,18 @@ static const int32_t Device_Properties_Optional[] = { PROP_MAX_MASTER,
 
 static const int32_t Device_Properties_Proprietary[] = { 512, 513, 9600, -1 };
 
-static struct my_object_functions *Device_Objects_Find_Functions(
-    BACNET_OBJECT_TYPE Object_Type)
+static const DEVICE_OBJECTS_FLASH struct my_object_functions *
+Device_Objects_Find_Functions(BACNET_OBJECT_TYPE Object_Type)
 {
-    struct my_object_functions *pObject = NULL;
-
-    pObject = &Object_Table[0];
-    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
-        /* handle each object type */
-        if (pObject->Object_Type == Object_Type) {
-            return (pObject);
-        }
-
-        pObject++;
+    switch (Object_Type) {
+#define DEVICE_OBJECT_CASE(type, init, count, index, valid, name, rp, wp, \
+    lists) \
+    case type: \
+        return &Object_Table[MY_OBJECT_INDEX_##type];
+        DEVICE_OBJECTS(DEVICE_OBJECT_CASE)
+#undef DEVICE_OBJECT_CASE
+        default:
+            break;
     }
 
     return (NULL);
@@ -128,7 +112,7 @@ static struct my_object_functions *Device_Objects_Find_Functions(
 int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 {
     int apdu_len = BACNET_STATUS_ERROR;
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 #if (BACNET_PROTOCOL_REVISION >= 14)
     struct special_property_list_t property_list;
 #endif
@@ -224,7 +208,7 @@ static bool Device_Write_Property_Object_Name(
 bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
     bool status = false;
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 
     /* initialize the default return values */
     pObject = Device_Objects_Find_Functions(wp_data->object_type);
@@ -288,7 +272,7 @@ void Device_Objects_Property_List(BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     struct special_property_list_t *pPropertyList)
 {
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 
     (void)object_instance;
     pPropertyList->Required.pList = NULL;
@@ -497,18 +481,17 @@ BACNET_REINITIALIZED_STATE Device_Reinitialized_State(void)
 
 void Device_Init(object_functions_t *object_table)
 {
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 
     /* we don't use the object table passed in
        since there is extra stuff we don't need in there. */
     (void)object_table;
     /* our local object table */
-    pObject = &Object_Table[0];
-    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+    for (pObject = &Object_Table[0];
+         pObject < &Object_Table[MY_OBJECT_TABLE_SIZE]; pObject++) {
         if (pObject->Object_Init) {
             pObject->Object_Init();
         }
-        pObject++;
     }
     dcc_set_status_duration(COMMUNICATION_ENABLE, 0);
 }
@@ -582,15 +565,14 @@ void Device_Inc_Database_Revision(void)
 unsigned Device_Object_List_Count(void)
 {
     unsigned count = 0; /* number of objects */
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 
     /* initialize the default return values */
-    pObject = &Object_Table[0];
-    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+    for (pObject = &Object_Table[0];
+         pObject < &Object_Table[MY_OBJECT_TABLE_SIZE]; pObject++) {
         if (pObject->Object_Count) {
             count += pObject->Object_Count();
         }
-        pObject++;
     }
 
     return count;
@@ -602,7 +584,7 @@ bool Device_Object_List_Identifier(
     bool status = false;
     uint32_t count = 0;
     uint32_t object_index = 0;
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 
     /* array index zero is length - so invalid */
     if (array_index == 0) {
@@ -610,8 +592,8 @@ bool Device_Object_List_Identifier(
     }
     object_index = array_index - 1;
     /* initialize the default return values */
-    pObject = &Object_Table[0];
-    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+    for (pObject = &Object_Table[0];
+         pObject < &Object_Table[MY_OBJECT_TABLE_SIZE]; pObject++) {
         if (pObject->Object_Count && pObject->Object_Index_To_Instance) {
             object_index -= count;
             count = pObject->Object_Count();
@@ -622,7 +604,6 @@ bool Device_Object_List_Identifier(
                 break;
             }
         }
-        pObject++;
     }
 
     return status;
@@ -671,7 +652,7 @@ bool Device_Valid_Object_Name(const BACNET_CHARACTER_STRING *object_name1,
     uint32_t max_objects = 0, i = 0;
     bool check_id = false;
     BACNET_CHARACTER_STRING object_name2;
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 
     max_objects = Device_Object_List_Count();
     for (i = 1; i <= max_objects; i++) {
@@ -700,7 +681,7 @@ bool Device_Valid_Object_Id(
     BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
 {
     bool status = false; /* return value */
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 
     pObject = Device_Objects_Find_Functions((BACNET_OBJECT_TYPE)object_type);
     if ((pObject != NULL) && (pObject->Object_Valid_Instance != NULL)) {
@@ -714,9 +695,10 @@ bool Device_Object_Name_Copy(BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     BACNET_CHARACTER_STRING *object_name)
 {
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
     bool found = false;
 
+    pObject = Device_Objects_Find_Functions(object_type);
     if (pObject != NULL) {
         if (pObject->Object_Valid_Instance &&
             pObject->Object_Valid_Instance(object_instance)) {
@@ -739,7 +721,7 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     uint32_t count = 0;
     uint8_t *apdu = NULL;
     int apdu_max = 0;
-    struct my_object_functions *pObject = NULL;
+    const DEVICE_OBJECTS_FLASH struct my_object_functions *pObject = NULL;
 
     if ((rpdata->application_data == NULL) ||
         (rpdata->application_data_len == 0)) {
@@ -827,13 +809,11 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
                 bitstring_set_bit(&bit_string, (uint8_t)i, false);
             }
             /* set the object types with objects to supported */
-            i = 0;
-            pObject = &Object_Table[i];
-            while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+            for (pObject = &Object_Table[0];
+                 pObject < &Object_Table[MY_OBJECT_TABLE_SIZE]; pObject++) {
                 if ((pObject->Object_Count) && (pObject->Object_Count() > 0)) {
                     bitstring_set_bit(&bit_string, pObject->Object_Type, true);
                 }
-                pObject++;
             }
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
@@ -34,6 +34,9 @@ static bool BIP_Broadcast_Binding_Address_Override;
 static struct in_addr BIP_Broadcast_Binding_Address;
 /* point-to-point interface flag - uses the unicast socket for broadcast */
 static bool BIP_Point_To_Point = false;
+/* multicast group that replaces the broadcast address, see J.8 */
+static struct in_addr BIP_Multicast_Group;
+static uint8_t BIP_Multicast_TTL = 1;
 /* enable debugging */
 static bool BIP_Debug = false;
 /* interface name */
@@ -284,6 +287,36 @@ int bip_send_mpdu(
         sizeof(struct sockaddr));
 }
 
+/**
+ * The send function for BACnet/IP driver layer to send the same MPDU
+ * to many destinations, such as a BBMD forwarding a broadcast to each
+ * BDT and FDT entry.
+ *
+ * @param dest - array of BACNET_IP_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return the number of destinations the MPDU was sent to
+ */
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+    int sent_count = 0;
+
+    for (i = 0; i < dest_count; i++) {
+        if (bip_send_mpdu(&dest[i], mtu, mtu_len) > 0) {
+            sent_count++;
+        }
+    }
+
+    return sent_count;
+}
+
 /**
  * BACnet/IP Datalink Receive handler.
  *
@@ -563,6 +596,94 @@ int bip_get_local_netmask(struct in_addr *netmask)
     return rv;
 }
 
+/**
+ * @brief Use an IP multicast group for the BACnet broadcasts, as
+ *  described in Annex J.8, instead of the subnet directed broadcast.
+ *  The group is joined on the interface, so that switches that snoop
+ *  IGMP forward the group to this port.
+ * @note Must be called before bip_init()
+ * @param group - multicast group address and UDP port, or NULL or
+ *  an address of 0.0.0.0 to use the subnet directed broadcast
+ * @param ttl - time-to-live of the multicasts, which is 1 to keep them
+ *  on the local subnet, or more to let multicast routers forward them
+ * @return true if the group was set
+ */
+bool bip_set_multicast_group(const BACNET_IP_ADDRESS *group, uint8_t ttl)
+{
+    struct in_addr address = { 0 };
+
+    if (group) {
+        memcpy(&address.s_addr, &group->address[0], 4);
+    }
+    if ((address.s_addr != 0) && !IN_MULTICAST(ntohl(address.s_addr))) {
+        return false;
+    }
+    BIP_Multicast_Group = address;
+    BIP_Multicast_TTL = ttl;
+
+    return true;
+}
+
+/**
+ * @brief Get the IP multicast group that is used for the BACnet broadcasts
+ * @param group - multicast group address and UDP port
+ * @return true if a multicast group is used
+ */
+bool bip_get_multicast_group(BACNET_IP_ADDRESS *group)
+{
+    if (BIP_Multicast_Group.s_addr == 0) {
+        return false;
+    }
+    if (group) {
+        memcpy(&group->address[0], &BIP_Multicast_Group.s_addr, 4);
+        group->port = ntohs(BIP_Port);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Join the multicast group on the socket that receives the
+ *  broadcasts, and send the multicasts from the unicast socket on the
+ *  interface with the configured time-to-live
+ * @return true if the sockets are configured for the multicast group
+ */
+static bool bip_multicast_join(void)
+{
+    struct ip_mreq mreq = { 0 };
+    unsigned char ttl = BIP_Multicast_TTL;
+    unsigned char loop = 0;
+
+    mreq.imr_multiaddr = BIP_Multicast_Group;
+    mreq.imr_interface = BIP_Address;
+    if (setsockopt(
+            BIP_Broadcast_Socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq,
+            sizeof(mreq)) < 0) {
+        if (BIP_Debug) {
+            perror("IP_ADD_MEMBERSHIP: ");
+        }
+        return false;
+    }
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_IF, &BIP_Address,
+            sizeof(BIP_Address)) < 0) {
+        return false;
+    }
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) <
+        0) {
+        return false;
+    }
+    /* our own broadcasts are not received */
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) <
+        0) {
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief Set the broadcast socket binding address
  * @param baddr The broadcast socket binding address, in host order.
@@ -638,6 +759,10 @@ void bip_set_interface(const char *ifname)
         }
     }
 #endif
+    if (BIP_Multicast_Group.s_addr != 0) {
+        /* the BACnet broadcasts are sent to the multicast group */
+        BIP_Broadcast_Addr = BIP_Multicast_Group;
+    }
     if (BIP_Debug) {
         fprintf(
             stderr, "BIP: Broadcast Address: %s\n",
@@ -760,6 +885,10 @@ bool bip_init(char *ifname)
         if (BIP_Broadcast_Binding_Address_Override) {
             broadcast_sin_config.sin_addr.s_addr =
                 BIP_Broadcast_Binding_Address.s_addr;
+        } else if (BIP_Multicast_Group.s_addr != 0) {
+            /* receive the multicast group and the subnet broadcasts
+               of the devices that do not use the group */
+            broadcast_sin_config.sin_addr.s_addr = htonl(INADDR_ANY);
         } else {
 #if defined(BACNET_IP_BROADCAST_USE_INADDR_ANY)
             broadcast_sin_config.sin_addr.s_addr = htonl(INADDR_ANY);
@@ -783,6 +912,14 @@ bool bip_init(char *ifname)
             }
         }
     }
+    if ((BIP_Multicast_Group.s_addr != 0) && !bip_multicast_join()) {
+        fprintf(
+            stderr, "BIP: Failed to join the multicast group %s!\n",
+            inet_ntoa(BIP_Multicast_Group));
+        fflush(stderr);
+        bip_cleanup();
+        return false;
+    }
     bvlc_init();
 
     return true;
@@ -281,6 +281,36 @@ int bip6_send_mpdu(
         (struct sockaddr *)&bvlc_dest, sizeof(bvlc_dest));
 }
 
+/**
+ * The send function for BACnet/IPv6 driver layer to send the same MPDU
+ * to many destinations, such as a BBMD forwarding a broadcast to each
+ * BDT and FDT entry.
+ *
+ * @param dest - array of BACNET_IP6_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return the number of destinations the MPDU was sent to
+ */
+int bip6_send_mpdu_multiple(
+    const BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+    int sent_count = 0;
+
+    for (i = 0; i < dest_count; i++) {
+        if (bip6_send_mpdu(&dest[i], mtu, mtu_len) > 0) {
+            sent_count++;
+        }
+    }
+
+    return sent_count;
+}
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
@@ -389,6 +419,15 @@ uint16_t bip6_receive(
     return npdu_len;
 }
 
+/**
+ * @brief Get the BACnet/IPv6 socket, for use with an event loop
+ * @return the BACnet/IPv6 socket, or -1 if not initialized
+ */
+int bip6_get_socket(void)
+{
+    return BIP6_Socket;
+}
+
 /** Cleanup and close out the BACnet/IP services by closing the socket.
  * @ingroup DLBIP6
  */
@@ -40,6 +40,20 @@ bool ethernet_valid(void)
     return (pcap_eth802_fp != NULL);
 }
 
+/**
+ * @brief Get the selectable file descriptor of the pcap handle, for use
+ *  with an event loop
+ * @return the file descriptor, or -1 if not initialized
+ */
+int ethernet_get_socket(void)
+{
+    if (!pcap_eth802_fp) {
+        return -1;
+    }
+
+    return pcap_get_selectable_fd(pcap_eth802_fp);
+}
+
 void ethernet_cleanup(void)
 {
     if (pcap_eth802_fp) {
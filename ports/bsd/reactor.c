@@ -0,0 +1,573 @@
+/**
+ * @file
+ * @brief BSD event loop for datalink sockets, events, and timers
+ *
+ * One kqueue waits for every registered source, so an application gets
+ * a single wakeup for network packets, signals from other threads
+ * (EVFILT_USER), and periodic timers (EVFILT_TIMER), instead of polling
+ * each datalink with a receive timeout.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/datalink.h"
+#include "reactor.h"
+
+/* number of NPDUs received from the datalink before other events */
+#ifndef REACTOR_DATALINK_BATCH
+#define REACTOR_DATALINK_BATCH 16
+#endif
+/* milliseconds between polls of a datalink without a file descriptor */
+#ifndef REACTOR_DATALINK_POLL
+#define REACTOR_DATALINK_POLL 10
+#endif
+/* maximum number of datalink file descriptors */
+#define REACTOR_DATALINK_FD_MAX 6
+/* first identifier of a timer or an event, above the file descriptors */
+#define REACTOR_IDENT_FIRST 0x40000000
+
+typedef enum reactor_type {
+    REACTOR_TYPE_NONE = 0,
+    REACTOR_TYPE_FD,
+    REACTOR_TYPE_TIMER,
+    REACTOR_TYPE_EVENT
+} REACTOR_TYPE;
+
+struct reactor_entry {
+    int fd;
+    REACTOR_TYPE type;
+    reactor_callback callback;
+    void *context;
+};
+static struct reactor_entry Reactor_List[REACTOR_MAX_ENTRIES];
+static int Reactor_Kqueue = -1;
+/* the next identifier of a timer or an event */
+static int Reactor_Next_Ident = REACTOR_IDENT_FIRST;
+/* event used by reactor_stop() to wake up reactor_run() */
+static int Reactor_Stop_Event = -1;
+static bool Reactor_Running;
+/* the datalink NPDUs are received into */
+static struct reactor_datalink {
+    uint8_t *pdu;
+    uint16_t max_pdu;
+    datalink_receive_handler handler;
+    BACNET_ADDRESS src;
+    int event;
+    int timer;
+    int fd[REACTOR_DATALINK_FD_MAX];
+    unsigned fd_count;
+} Reactor_Datalink;
+
+/**
+ * @brief Get the kqueue filter of a type of entry
+ * @param type - type of entry
+ * @return the filter
+ */
+static short reactor_filter(REACTOR_TYPE type)
+{
+    switch (type) {
+        case REACTOR_TYPE_TIMER:
+            return EVFILT_TIMER;
+        case REACTOR_TYPE_EVENT:
+            return EVFILT_USER;
+        default:
+            break;
+    }
+
+    return EVFILT_READ;
+}
+
+/**
+ * @brief Find the entry for a file descriptor, timer, or event
+ * @param fd - file descriptor, timer, or event
+ * @return the entry, or NULL if not found
+ */
+static struct reactor_entry *reactor_entry_find(int fd)
+{
+    unsigned i;
+
+    if (fd < 0) {
+        return NULL;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if ((Reactor_List[i].type != REACTOR_TYPE_NONE) &&
+            (Reactor_List[i].fd == fd)) {
+            return &Reactor_List[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a file descriptor, timer, or event to the kqueue
+ * @param fd - file descriptor, or identifier of the timer or event
+ * @param type - type of entry
+ * @param data - timer interval in milliseconds, or 0
+ * @param callback - function called when the entry is ready
+ * @param context - passed to the callback
+ * @return true if added
+ */
+static bool reactor_entry_add(
+    int fd,
+    REACTOR_TYPE type,
+    intptr_t data,
+    reactor_callback callback,
+    void *context)
+{
+    struct kevent change;
+    unsigned short flags = EV_ADD;
+    unsigned i;
+
+    if ((Reactor_Kqueue < 0) || (fd < 0) || !callback) {
+        return false;
+    }
+    if (reactor_entry_find(fd)) {
+        return false;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if (Reactor_List[i].type == REACTOR_TYPE_NONE) {
+            break;
+        }
+    }
+    if (i == REACTOR_MAX_ENTRIES) {
+        return false;
+    }
+    if (type == REACTOR_TYPE_EVENT) {
+        /* signals before the wait are combined into one callback */
+        flags |= EV_CLEAR;
+    }
+    /* the entry index, so that an event for an entry that was removed
+       during the same wait is ignored */
+    EV_SET(
+        &change, (uintptr_t)fd, reactor_filter(type), flags, 0, data,
+        (void *)(uintptr_t)i);
+    if (kevent(Reactor_Kqueue, &change, 1, NULL, 0, NULL) != 0) {
+        return false;
+    }
+    Reactor_List[i].fd = fd;
+    Reactor_List[i].type = type;
+    Reactor_List[i].callback = callback;
+    Reactor_List[i].context = context;
+
+    return true;
+}
+
+/**
+ * @brief Remove an entry from the kqueue
+ * @param entry - the entry to remove
+ */
+static void reactor_entry_remove(struct reactor_entry *entry)
+{
+    struct kevent change;
+
+    EV_SET(
+        &change, (uintptr_t)entry->fd, reactor_filter(entry->type), EV_DELETE,
+        0, 0, NULL);
+    (void)kevent(Reactor_Kqueue, &change, 1, NULL, 0, NULL);
+    entry->fd = -1;
+    entry->type = REACTOR_TYPE_NONE;
+    entry->callback = NULL;
+    entry->context = NULL;
+}
+
+/**
+ * @brief Get an identifier for a new timer or event, which is not
+ *  the same as a file descriptor or another timer or event
+ * @return the identifier
+ */
+static int reactor_ident_next(void)
+{
+    int ident;
+
+    do {
+        ident = Reactor_Next_Ident;
+        if (Reactor_Next_Ident == INT32_MAX) {
+            Reactor_Next_Ident = REACTOR_IDENT_FIRST;
+        } else {
+            Reactor_Next_Ident++;
+        }
+    } while (reactor_entry_find(ident));
+
+    return ident;
+}
+
+/**
+ * @brief The reactor_stop() event was signaled
+ * @param fd - the event
+ * @param context - not used
+ */
+static void reactor_stop_handler(int fd, void *context)
+{
+    (void)fd;
+    (void)context;
+    Reactor_Running = false;
+}
+
+/**
+ * @brief Initialize the event loop
+ * @return true if the event loop is ready
+ */
+bool reactor_init(void)
+{
+    unsigned i;
+
+    if (Reactor_Kqueue >= 0) {
+        return true;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        Reactor_List[i].fd = -1;
+        Reactor_List[i].type = REACTOR_TYPE_NONE;
+        Reactor_List[i].callback = NULL;
+        Reactor_List[i].context = NULL;
+    }
+    Reactor_Datalink.event = -1;
+    Reactor_Datalink.timer = -1;
+    Reactor_Kqueue = kqueue();
+    if (Reactor_Kqueue < 0) {
+        return false;
+    }
+    Reactor_Stop_Event = reactor_event_add(reactor_stop_handler, NULL);
+    if (Reactor_Stop_Event < 0) {
+        reactor_cleanup();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove everything from the event loop, and close the timers
+ *  and events that it created
+ */
+void reactor_cleanup(void)
+{
+    unsigned i;
+    int fd;
+
+    if (Reactor_Kqueue < 0) {
+        return;
+    }
+    reactor_datalink_remove();
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if (Reactor_List[i].type != REACTOR_TYPE_NONE) {
+            reactor_close(Reactor_List[i].fd);
+        }
+    }
+    Reactor_Stop_Event = -1;
+    Reactor_Running = false;
+    fd = Reactor_Kqueue;
+    Reactor_Kqueue = -1;
+    close(fd);
+}
+
+/**
+ * @brief Add a file descriptor, such as a datalink socket, that calls
+ *  back when it is readable
+ * @param fd - file descriptor, which is still owned by the caller
+ * @param callback - function called when the file descriptor is readable
+ * @param context - passed to the callback
+ * @return true if added
+ */
+bool reactor_fd_add(int fd, reactor_callback callback, void *context)
+{
+    if (fd >= REACTOR_IDENT_FIRST) {
+        return false;
+    }
+
+    return reactor_entry_add(fd, REACTOR_TYPE_FD, 0, callback, context);
+}
+
+/**
+ * @brief Remove a file descriptor without closing it
+ * @param fd - file descriptor
+ * @return true if removed
+ */
+bool reactor_fd_remove(int fd)
+{
+    struct reactor_entry *entry;
+
+    entry = reactor_entry_find(fd);
+    if (!entry || (entry->type != REACTOR_TYPE_FD)) {
+        return false;
+    }
+    reactor_entry_remove(entry);
+
+    return true;
+}
+
+/**
+ * @brief Add a periodic timer
+ * @param milliseconds - interval between callbacks, greater than zero
+ * @param callback - function called each time the timer expires
+ * @param context - passed to the callback
+ * @return the timer, or -1 on error
+ */
+int reactor_timer_add(
+    unsigned long milliseconds, reactor_callback callback, void *context)
+{
+    int ident;
+
+    if ((Reactor_Kqueue < 0) || (milliseconds == 0) || !callback) {
+        return -1;
+    }
+    ident = reactor_ident_next();
+    /* EVFILT_TIMER data is in milliseconds, and periodic by default */
+    if (!reactor_entry_add(
+            ident, REACTOR_TYPE_TIMER, (intptr_t)milliseconds, callback,
+            context)) {
+        return -1;
+    }
+
+    return ident;
+}
+
+/**
+ * @brief Add an event that another thread, or a callback, can signal
+ *  with reactor_event_signal() to wake up the event loop
+ * @param callback - function called after the event is signaled
+ * @param context - passed to the callback
+ * @return the event, or -1 on error
+ */
+int reactor_event_add(reactor_callback callback, void *context)
+{
+    int ident;
+
+    if ((Reactor_Kqueue < 0) || !callback) {
+        return -1;
+    }
+    ident = reactor_ident_next();
+    if (!reactor_entry_add(ident, REACTOR_TYPE_EVENT, 0, callback, context)) {
+        return -1;
+    }
+
+    return ident;
+}
+
+/**
+ * @brief Signal an event. Safe to call from any thread.
+ * @param fd - the event from reactor_event_add()
+ * @return true if signaled
+ */
+bool reactor_event_signal(int fd)
+{
+    struct kevent change;
+
+    if ((Reactor_Kqueue < 0) || (fd < REACTOR_IDENT_FIRST)) {
+        return false;
+    }
+    EV_SET(&change, (uintptr_t)fd, EVFILT_USER, 0, NOTE_TRIGGER, 0, NULL);
+
+    return (kevent(Reactor_Kqueue, &change, 1, NULL, 0, NULL) == 0);
+}
+
+/**
+ * @brief Remove a file descriptor, timer, or event. Timers and events
+ *  that were created by the event loop end with it; file descriptors
+ *  are not closed.
+ * @param fd - file descriptor, timer, or event
+ */
+void reactor_close(int fd)
+{
+    struct reactor_entry *entry;
+
+    entry = reactor_entry_find(fd);
+    if (!entry) {
+        return;
+    }
+    reactor_entry_remove(entry);
+}
+
+/**
+ * @brief Wait for the file descriptors, timers, and events, and call
+ *  back for each one that is ready
+ * @param timeout - milliseconds to wait, or -1 to wait forever
+ * @return number of callbacks, or -1 on error
+ */
+int reactor_run_once(int timeout)
+{
+    struct kevent events[REACTOR_MAX_ENTRIES];
+    struct reactor_entry *entry;
+    struct timespec spec = { 0 };
+    struct timespec *wait = NULL;
+    unsigned index;
+    int count = 0;
+    int fd;
+    int n, i;
+
+    if (Reactor_Kqueue < 0) {
+        return -1;
+    }
+    if (timeout >= 0) {
+        spec.tv_sec = timeout / 1000;
+        spec.tv_nsec = (long)(timeout % 1000) * 1000000L;
+        wait = &spec;
+    }
+    n = kevent(Reactor_Kqueue, NULL, 0, events, REACTOR_MAX_ENTRIES, wait);
+    if (n < 0) {
+        return (errno == EINTR) ? 0 : -1;
+    }
+    for (i = 0; i < n; i++) {
+        if (events[i].flags & EV_ERROR) {
+            continue;
+        }
+        index = (unsigned)(uintptr_t)events[i].udata;
+        fd = (int)events[i].ident;
+        if (index >= REACTOR_MAX_ENTRIES) {
+            continue;
+        }
+        entry = &Reactor_List[index];
+        if ((entry->type == REACTOR_TYPE_NONE) || (entry->fd != fd) ||
+            (reactor_filter(entry->type) != events[i].filter)) {
+            /* removed by an earlier callback */
+            continue;
+        }
+        entry->callback(fd, entry->context);
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Run the event loop until reactor_stop() is called
+ */
+void reactor_run(void)
+{
+    Reactor_Running = true;
+    while (Reactor_Running) {
+        if (reactor_run_once(-1) < 0) {
+            break;
+        }
+    }
+    Reactor_Running = false;
+}
+
+/**
+ * @brief Stop reactor_run(). Safe to call from any thread.
+ */
+void reactor_stop(void)
+{
+    (void)reactor_event_signal(Reactor_Stop_Event);
+}
+
+/**
+ * @brief Receive a batch of NPDUs from the datalink
+ * @param fd - the datalink file descriptor, event, or timer
+ * @param context - not used
+ */
+static void reactor_datalink_receive(int fd, void *context)
+{
+    unsigned count;
+
+    (void)fd;
+    (void)context;
+    count = datalink_receive_batch(
+        &Reactor_Datalink.src, Reactor_Datalink.pdu, Reactor_Datalink.max_pdu,
+        0, REACTOR_DATALINK_BATCH, Reactor_Datalink.handler);
+    if (count >= REACTOR_DATALINK_BATCH) {
+        /* more may be waiting in the datalink buffers, so come back
+           after the other file descriptors are handled */
+        (void)reactor_event_signal(Reactor_Datalink.event);
+    }
+}
+
+#if defined(BACDL_BIP) || defined(BACDL_BIP6) || defined(BACDL_ETHERNET)
+/**
+ * @brief Add a datalink file descriptor, if it is open
+ * @param fd - datalink file descriptor, or -1
+ */
+static void reactor_datalink_fd_add(int fd)
+{
+    if ((fd < 0) || (Reactor_Datalink.fd_count >= REACTOR_DATALINK_FD_MAX)) {
+        return;
+    }
+    if (reactor_fd_add(fd, reactor_datalink_receive, NULL)) {
+        Reactor_Datalink.fd[Reactor_Datalink.fd_count] = fd;
+        Reactor_Datalink.fd_count++;
+    }
+}
+#endif
+
+/**
+ * @brief Add the file descriptors of the initialized datalinks, so that
+ *  each received NPDU is passed to the handler, such as npdu_handler().
+ *
+ * BACnet/IP, BACnet/IPv6, and Ethernet are added to the kqueue. MS/TP,
+ * which has no file descriptor for received frames on BSD, is polled
+ * every REACTOR_DATALINK_POLL milliseconds.
+ * The datalink must be initialized first.
+ *
+ * @param pdu - buffer for each received NPDU
+ * @param max_pdu - size of the buffer
+ * @param handler - function called with each NPDU
+ * @return true if added
+ */
+bool reactor_datalink_add(
+    uint8_t *pdu, uint16_t max_pdu, datalink_receive_handler handler)
+{
+    if ((Reactor_Kqueue < 0) || !pdu || !handler) {
+        return false;
+    }
+    reactor_datalink_remove();
+    Reactor_Datalink.pdu = pdu;
+    Reactor_Datalink.max_pdu = max_pdu;
+    Reactor_Datalink.handler = handler;
+    Reactor_Datalink.event = reactor_event_add(reactor_datalink_receive, NULL);
+    if (Reactor_Datalink.event < 0) {
+        return false;
+    }
+#if defined(BACDL_BIP)
+    reactor_datalink_fd_add(bip_get_socket());
+    if (bip_get_broadcast_socket() != bip_get_socket()) {
+        reactor_datalink_fd_add(bip_get_broadcast_socket());
+    }
+#endif
+#if defined(BACDL_BIP6)
+    reactor_datalink_fd_add(bip6_get_socket());
+#endif
+#if defined(BACDL_ETHERNET)
+    reactor_datalink_fd_add(ethernet_get_socket());
+#endif
+#if defined(BACDL_MSTP)
+    Reactor_Datalink.timer = reactor_timer_add(
+        REACTOR_DATALINK_POLL, reactor_datalink_receive, NULL);
+#endif
+    /* receive anything that arrived before the datalink was added */
+    (void)reactor_event_signal(Reactor_Datalink.event);
+
+    return true;
+}
+
+/**
+ * @brief Remove the datalink file descriptors from the event loop
+ */
+void reactor_datalink_remove(void)
+{
+    unsigned i;
+
+    for (i = 0; i < Reactor_Datalink.fd_count; i++) {
+        (void)reactor_fd_remove(Reactor_Datalink.fd[i]);
+    }
+    Reactor_Datalink.fd_count = 0;
+    if (Reactor_Datalink.timer >= 0) {
+        reactor_close(Reactor_Datalink.timer);
+        Reactor_Datalink.timer = -1;
+    }
+    if (Reactor_Datalink.event >= 0) {
+        reactor_close(Reactor_Datalink.event);
+        Reactor_Datalink.event = -1;
+    }
+    Reactor_Datalink.handler = NULL;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @brief BSD event loop for datalink sockets, events, and timers
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_PORT_BSD_REACTOR_H
+#define BACNET_PORT_BSD_REACTOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/datalink.h"
+
+/* maximum number of file descriptors, timers, and events */
+#ifndef REACTOR_MAX_ENTRIES
+#define REACTOR_MAX_ENTRIES 32
+#endif
+
+/**
+ * @brief Callback when a file descriptor is readable, a timer expires,
+ *  or an event is signaled
+ * @param fd - the file descriptor, timer, or event
+ * @param context - the context given when it was added
+ */
+typedef void (*reactor_callback)(int fd, void *context);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool reactor_init(void);
+BACNET_STACK_EXPORT
+void reactor_cleanup(void);
+
+BACNET_STACK_EXPORT
+bool reactor_fd_add(int fd, reactor_callback callback, void *context);
+BACNET_STACK_EXPORT
+bool reactor_fd_remove(int fd);
+
+BACNET_STACK_EXPORT
+int reactor_timer_add(
+    unsigned long milliseconds, reactor_callback callback, void *context);
+BACNET_STACK_EXPORT
+int reactor_event_add(reactor_callback callback, void *context);
+BACNET_STACK_EXPORT
+bool reactor_event_signal(int fd);
+BACNET_STACK_EXPORT
+void reactor_close(int fd);
+
+BACNET_STACK_EXPORT
+int reactor_run_once(int timeout);
+BACNET_STACK_EXPORT
+void reactor_run(void);
+BACNET_STACK_EXPORT
+void reactor_stop(void);
+
+BACNET_STACK_EXPORT
+bool reactor_datalink_add(
+    uint8_t *pdu, uint16_t max_pdu, datalink_receive_handler handler);
+BACNET_STACK_EXPORT
+void reactor_datalink_remove(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
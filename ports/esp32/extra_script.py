@@ -9,6 +9,7 @@ from pathlib import Path
 PIOENV = env.get("PIOENV", "")
 if PIOENV not in (
     "m5stamplc-mstp",
+    "m5stamplc-mstp-dual-core",
     "m5stamplc-bip",
     "esp32-poe-wifi-bip",
     "esp32-poe-eth-bip",
@@ -38,6 +39,7 @@ bacnet_common_sources = [
     "bacnet/basic/service/h_wp.c",
     "bacnet/basic/service/s_iam.c",
     "bacnet/basic/service/s_ihave.c",
+    "bacnet/basic/sys/arena.c",
     "bacnet/basic/sys/datetime_mstimer.c",
     "bacnet/basic/sys/days.c",
     "bacnet/basic/sys/dst.c",
@@ -54,6 +56,7 @@ bacnet_common_sources = [
     "bacnet/bacdest.c",
     "bacnet/bacdevobjpropref.c",
     "bacnet/bacerror.c",
+    "bacnet/bacexport.c",
     "bacnet/bacint.c",
     "bacnet/bacreal.c",
     "bacnet/bacstr.c",
@@ -76,6 +79,7 @@ bacnet_common_sources = [
     "bacnet/wp.c",
     "bacnet/cov.c",
     "bacnet/basic/sys/keylist.c",
+    "bacnet/basic/sys/priority_array.c",
 ]
 
 bacnet_transport_sources = {
@@ -86,6 +90,13 @@ bacnet_transport_sources = {
         "bacnet/datalink/mstp.c",
         "bacnet/datalink/mstptext.c",
     ],
+    "m5stamplc-mstp-dual-core": [
+        "bacnet/datalink/cobs.c",
+        "bacnet/datalink/crc.c",
+        "bacnet/datalink/dlmstp.c",
+        "bacnet/datalink/mstp.c",
+        "bacnet/datalink/mstptext.c",
+    ],
     "m5stamplc-bip": [
         "bacnet/datalink/bvlc.c",
     ],
@@ -13,6 +13,9 @@
 #if defined(BACDL_MSTP)
 #include "dlenv.h"
 #include "bacnet/datalink/datalink.h"
+#if BACNET_DUAL_CORE
+#include "mstp_task.h"
+#endif
 #elif defined(BACDL_BIP)
 #include "bip.h"
 #endif
@@ -32,7 +35,7 @@
 
 #if defined(BACDL_BIP)
 static uint8_t PDUBuffer[BIP_MPDU_MAX];
-#else
+#elif !BACNET_DUAL_CORE
 static uint8_t PDUBuffer[MAX_MPDU + 16];
 #endif
 
@@ -102,7 +105,12 @@ static object_functions_t My_Object_Table[] = {
       NULL,
       NULL,
       NULL,
-      Device_Writable_Property_List },
+      Device_Writable_Property_List,
+      NULL,
+      NULL,
+      NULL,
+      NULL,
+      NULL },
 
     { OBJECT_BINARY_INPUT,
       Binary_Input_Init,
@@ -124,7 +132,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Input_Create,
       Binary_Input_Delete,
       NULL,
-      Binary_Input_Writable_Property_List },
+      Binary_Input_Writable_Property_List,
+      NULL,
+      Binary_Input_Present_Value_Enumerated,
+      NULL,
+      NULL,
+      Binary_Input_Status_Flags },
 
     { OBJECT_ANALOG_INPUT,
       Analog_Input_Init,
@@ -146,7 +159,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Input_Create,
       Analog_Input_Delete,
       NULL,
-      Analog_Input_Writable_Property_List },
+      Analog_Input_Writable_Property_List,
+      Analog_Input_Present_Value_Real,
+      NULL,
+      NULL,
+      NULL,
+      Analog_Input_Status_Flags },
 
     { OBJECT_BINARY_OUTPUT,
       Binary_Output_Init,
@@ -168,7 +186,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Output_Create,
       Binary_Output_Delete,
       NULL,
-      Binary_Output_Writable_Property_List },
+      Binary_Output_Writable_Property_List,
+      NULL,
+      Binary_Output_Present_Value_Enumerated,
+      NULL,
+      NULL,
+      Binary_Output_Status_Flags },
 
     { MAX_BACNET_OBJECT_TYPE,
       NULL,
@@ -190,6 +213,11 @@ static object_functions_t My_Object_Table[] = {
       NULL,
       NULL,
       NULL,
+      NULL,
+      NULL,
+      NULL,
+      NULL,
+      NULL,
       NULL }
 };
 
@@ -245,7 +273,11 @@ void bacnet_app_init(void)
     Device_Set_Object_Instance_Number(12345);
     init_server_objects();
 
-#if defined(BACDL_MSTP)
+#if defined(BACDL_MSTP) && BACNET_DUAL_CORE
+    if (!mstp_task_init(2)) {
+        for (;;) { }
+    }
+#elif defined(BACDL_MSTP)
     if (!m5_dlenv_init(2)) {
         for (;;) { }
     }
@@ -276,6 +308,9 @@ void bacnet_app_init(void)
  */
 void bacnet_app_tick(void)
 {
+#if defined(BACDL_MSTP) && BACNET_DUAL_CORE
+    (void)mstp_task_receive(npdu_handler);
+#else
     BACNET_ADDRESS src = { 0 };
     uint16_t pdu_len = 0;
 
@@ -287,6 +322,7 @@ void bacnet_app_tick(void)
     if (pdu_len) {
         npdu_handler(&src, &PDUBuffer[0], pdu_len);
     }
+#endif
 
     tsm_timer_milliseconds(1);
 }
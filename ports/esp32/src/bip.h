@@ -155,6 +155,20 @@ int bip_send_pdu(
 int bip_send_mpdu(
     const BACNET_IP_ADDRESS *dest, const uint8_t *mtu, uint16_t mtu_len);
 
+/**
+ * @brief Send a raw BACnet/IP MPDU to many hosts and ports
+ * @param dest array of destination IPv4 addresses and ports
+ * @param dest_count number of destinations
+ * @param mtu raw BVLC/NPDU buffer
+ * @param mtu_len buffer length in bytes
+ * @return number of destinations the MPDU was sent to
+ */
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len);
+
 /**
  * @brief Receive a BACnet/IP NPDU
  * @param src source BACnet address
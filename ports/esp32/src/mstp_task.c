@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @brief BACnet MS/TP datalink task for the dual-core PlatformIO ESP32 port
+ *
+ * The MS/TP state machines and the RS-485 UART run in a task that is
+ * pinned to one core, so that token passing keeps its timing while the
+ * Arduino loop() processes the objects and services on the other core.
+ * The task puts each received NPDU into a lock-free queue that the
+ * application takes them from. The application sends with
+ * dlmstp_send_pdu(), whose queue is only taken by the MS/TP task.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "dlenv.h"
+#include "mstp_task.h"
+
+#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/datalink/dlmstp.h"
+
+/* a received NPDU, as it waits for the application */
+struct mstp_task_packet {
+    BACNET_ADDRESS src;
+    uint16_t pdu_len;
+    uint8_t pdu[DLMSTP_MPDU_MAX];
+};
+
+static struct mstp_task_packet Receive_Buffer[BACNET_MSTP_TASK_RECEIVE_QUEUE];
+static RING_BUFFER Receive_Queue;
+/* the task keeps passing the token when the application falls behind */
+static uint8_t Drop_Buffer[DLMSTP_MPDU_MAX];
+static volatile uint32_t Receive_Dropped;
+static uint8_t MAC_Address;
+static volatile bool Task_Started;
+static SemaphoreHandle_t Task_Ready;
+
+/**
+ * @brief Start the datalink, and run the MS/TP state machines
+ * @param arg unused
+ */
+static void mstp_task(void *arg)
+{
+    struct mstp_task_packet *packet;
+    BACNET_ADDRESS src = { 0 };
+    uint16_t pdu_len;
+
+    (void)arg;
+    /* the UART interrupt is allocated on the core that installs it */
+    Task_Started = m5_dlenv_init(MAC_Address);
+    xSemaphoreGive(Task_Ready);
+    if (!Task_Started) {
+        vTaskDelete(NULL);
+        return;
+    }
+    for (;;) {
+        packet = (struct mstp_task_packet *)Ringbuf_Data_Peek(&Receive_Queue);
+        if (packet) {
+            pdu_len = dlmstp_receive(
+                &packet->src, packet->pdu, sizeof(packet->pdu), 0);
+            if (pdu_len) {
+                packet->pdu_len = pdu_len;
+                (void)Ringbuf_Data_Put(&Receive_Queue, (uint8_t *)packet);
+            }
+        } else {
+            pdu_len =
+                dlmstp_receive(&src, Drop_Buffer, sizeof(Drop_Buffer), 0);
+            if (pdu_len) {
+                Receive_Dropped++;
+            }
+        }
+        /* the UART driver buffers the octets, and the idle task of this
+           core feeds the task watchdog */
+        vTaskDelay(1);
+    }
+}
+
+unsigned mstp_task_receive(datalink_receive_handler handler)
+{
+    struct mstp_task_packet *packet;
+    unsigned count = 0;
+
+    while ((packet = (struct mstp_task_packet *)Ringbuf_Peek(
+                &Receive_Queue)) != NULL) {
+        if (handler) {
+            handler(&packet->src, packet->pdu, packet->pdu_len);
+        }
+        (void)Ringbuf_Pop(&Receive_Queue, NULL);
+        count++;
+    }
+
+    return count;
+}
+
+uint32_t mstp_task_dropped(void)
+{
+    return Receive_Dropped;
+}
+
+bool mstp_task_init(uint8_t mac_address)
+{
+    if (!Ringbuf_Initialize(
+            &Receive_Queue, (volatile uint8_t *)Receive_Buffer,
+            sizeof(Receive_Buffer), sizeof(Receive_Buffer[0]),
+            BACNET_MSTP_TASK_RECEIVE_QUEUE)) {
+        return false;
+    }
+    Task_Ready = xSemaphoreCreateBinary();
+    if (!Task_Ready) {
+        return false;
+    }
+    MAC_Address = mac_address;
+    if (xTaskCreatePinnedToCore(
+            mstp_task, "bacnet-mstp", BACNET_MSTP_TASK_STACK_SIZE, NULL,
+            BACNET_MSTP_TASK_PRIORITY, NULL,
+            BACNET_MSTP_TASK_CORE) != pdPASS) {
+        return false;
+    }
+    (void)xSemaphoreTake(Task_Ready, portMAX_DELAY);
+
+    return Task_Started;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @brief BACnet MS/TP datalink task for the dual-core PlatformIO ESP32 port
+ */
+
+#ifndef M5STAMPLC_MSTP_TASK_H
+#define M5STAMPLC_MSTP_TASK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bacnet/bacdef.h"
+#include "bacnet/datalink/datalink.h"
+
+/* core that runs the MS/TP state machines. The Arduino loop() runs on
+   the other core (ARDUINO_RUNNING_CORE is 1). */
+#ifndef BACNET_MSTP_TASK_CORE
+#define BACNET_MSTP_TASK_CORE 0
+#endif
+#ifndef BACNET_MSTP_TASK_PRIORITY
+#define BACNET_MSTP_TASK_PRIORITY (configMAX_PRIORITIES - 2)
+#endif
+#ifndef BACNET_MSTP_TASK_STACK_SIZE
+#define BACNET_MSTP_TASK_STACK_SIZE 4096
+#endif
+/* number of received NPDUs that wait for the application, as a power
+   of two */
+#ifndef BACNET_MSTP_TASK_RECEIVE_QUEUE
+#define BACNET_MSTP_TASK_RECEIVE_QUEUE 4
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the MS/TP datalink in a task of its own
+ * @param mac_address local MS/TP MAC address
+ * @return true if the task started the datalink
+ */
+bool mstp_task_init(uint8_t mac_address);
+
+/**
+ * @brief Handle the NPDUs that the MS/TP task has received
+ * @param handler called for each NPDU
+ * @return number of NPDUs that were handled
+ */
+unsigned mstp_task_receive(datalink_receive_handler handler);
+
+/**
+ * @brief Get the number of NPDUs that were dropped while the queue was full
+ * @return number of dropped NPDUs
+ */
+uint32_t mstp_task_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,6 +9,8 @@
 #include "bacnet/bacdef.h"
 #include "bacnet/npdu.h"
 #include "bacnet/datalink/arcnet.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacport.h"
 
 /** @file linux/arcnet.c  Provides Linux-specific functions for Arcnet. */
@@ -60,6 +62,15 @@ bool arcnet_valid(void)
     return (ARCNET_Sock_FD >= 0);
 }
 
+/**
+ * @brief Get the ARCNET socket, for use with an event loop
+ * @return the ARCNET socket, or -1 if not initialized
+ */
+int arcnet_get_socket(void)
+{
+    return ARCNET_Sock_FD;
+}
+
 void arcnet_cleanup(void)
 {
     if (arcnet_valid()) {
@@ -232,6 +243,9 @@ int arcnet_send_pdu(
     /* did it get sent? */
     if (bytes < 0) {
         fprintf(stderr, "arcnet: Error sending packet: %s\n", strerror(errno));
+    } else {
+        PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_ARCNET);
+        BACTRACE_DATALINK_SEND(PERFSTAT_DATALINK_ARCNET, pdu_len);
     }
 
     return bytes;
@@ -336,6 +350,8 @@ uint16_t arcnet_receive(
     /* copy the buffer into the PDU */
     if (pdu_len < max_pdu) {
         memmove(&pdu[0], &pkt->soft.raw[4], pdu_len);
+        PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_ARCNET);
+        BACTRACE_DATALINK_RECEIVE(PERFSTAT_DATALINK_ARCNET, pdu_len);
     }
     /* silently ignore packets that are too large */
     else {
@@ -0,0 +1,345 @@
+/**
+ * @file
+ * @brief File object stream access in memory mapped files (Linux)
+ * @details The POSIX backend opens, seeks and closes the file for every
+ *  AtomicReadFile and AtomicWriteFile chunk.  This backend keeps the
+ *  last used files open, each with a shared read-only mapping of the
+ *  whole file, so that a chunk read is a copy out of the page cache.
+ *  That suits a file, such as a firmware image, that is read in small
+ *  chunks by many clients at the same time.  A chunk write goes to the
+ *  open file with pwrite(), and the mapping follows the size of the
+ *  file on the next read.  A file that is replaced under its pathname
+ *  is seen after bacfile_mmap_invalidate().  Record access is left to
+ *  the record callbacks already set, such as the POSIX ones.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/bacfile.h"
+#include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacfile-mmap.h"
+
+struct bacfile_mmap_entry {
+    char pathname[PATH_MAX];
+    /* true if the entry holds an open file */
+    bool open;
+    int fd;
+    bool writable;
+    /* mapping of the whole file, or NULL if the file is empty */
+    uint8_t *map;
+    size_t map_size;
+    /* for the least recently used entry to be reused */
+    unsigned long used;
+};
+static struct bacfile_mmap_entry File_Entry[BACFILE_MMAP_FILES_MAX];
+static unsigned long File_Entry_Used;
+
+/**
+ * @brief Unmap and close the file of an entry, and free the entry
+ * @param entry - entry of the file
+ */
+static void bacfile_mmap_entry_close(struct bacfile_mmap_entry *entry)
+{
+    if (entry->map) {
+        munmap(entry->map, entry->map_size);
+    }
+    entry->map = NULL;
+    entry->map_size = 0;
+    if (entry->open) {
+        close(entry->fd);
+    }
+    entry->open = false;
+    entry->pathname[0] = 0;
+}
+
+/**
+ * @brief Find the entry of a file that is already open
+ * @param pathname - pathname of the file
+ * @return the entry, or NULL if the file is not open
+ */
+static struct bacfile_mmap_entry *bacfile_mmap_entry_find(const char *pathname)
+{
+    unsigned i;
+
+    for (i = 0; i < BACFILE_MMAP_FILES_MAX; i++) {
+        if (File_Entry[i].open &&
+            (strcmp(File_Entry[i].pathname, pathname) == 0)) {
+            return &File_Entry[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get the entry of a file, opening the file in a free entry or
+ *  in the least recently used entry if it is not already open.
+ *  A file that can not be written is opened for reading only.
+ * @param pathname - pathname of the file
+ * @param create - true to create the file if it does not exist
+ * @return the entry, or NULL if the file could not be opened
+ */
+static struct bacfile_mmap_entry *
+bacfile_mmap_entry_open(const char *pathname, bool create)
+{
+    struct bacfile_mmap_entry *entry;
+    bool writable = true;
+    unsigned i;
+    int fd;
+
+    if (!filename_path_valid(pathname) || (strlen(pathname) >= PATH_MAX)) {
+        return NULL;
+    }
+    entry = bacfile_mmap_entry_find(pathname);
+    if (!entry) {
+        fd = open(pathname, create ? (O_RDWR | O_CREAT) : O_RDWR, 0644);
+        if ((fd < 0) && !create && ((errno == EACCES) || (errno == EROFS))) {
+            fd = open(pathname, O_RDONLY);
+            writable = false;
+        }
+        if (fd < 0) {
+            debug_printf_stderr("Failed to open %s!\n", pathname);
+            return NULL;
+        }
+        entry = &File_Entry[0];
+        for (i = 0; i < BACFILE_MMAP_FILES_MAX; i++) {
+            if (!File_Entry[i].open) {
+                entry = &File_Entry[i];
+                break;
+            }
+            if (File_Entry[i].used < entry->used) {
+                entry = &File_Entry[i];
+            }
+        }
+        bacfile_mmap_entry_close(entry);
+        entry->open = true;
+        entry->fd = fd;
+        entry->writable = writable;
+        strcpy(entry->pathname, pathname);
+    }
+    File_Entry_Used++;
+    entry->used = File_Entry_Used;
+
+    return entry;
+}
+
+/**
+ * @brief Map the whole file of an entry again if its size has changed
+ * @param entry - entry of the file
+ * @return true if the mapping has the size of the file
+ */
+static bool bacfile_mmap_entry_map(struct bacfile_mmap_entry *entry)
+{
+    struct stat st = { 0 };
+    void *map;
+
+    if (fstat(entry->fd, &st) != 0) {
+        debug_perror("bacfile-mmap: fstat");
+        return false;
+    }
+    if ((size_t)st.st_size == entry->map_size) {
+        return true;
+    }
+    if (entry->map) {
+        munmap(entry->map, entry->map_size);
+        entry->map = NULL;
+        entry->map_size = 0;
+    }
+    if (st.st_size > 0) {
+        map = mmap(
+            NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, entry->fd, 0);
+        if (map == MAP_FAILED) {
+            debug_perror("bacfile-mmap: mmap");
+            return false;
+        }
+        entry->map = map;
+        entry->map_size = (size_t)st.st_size;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Determines the file size for a given file
+ * @param pathname - name of the file to get the size for
+ * @return file size in bytes, or 0 if not found
+ */
+size_t bacfile_mmap_file_size(const char *pathname)
+{
+    struct bacfile_mmap_entry *entry;
+
+    entry = bacfile_mmap_entry_open(pathname, false);
+    if (entry && bacfile_mmap_entry_map(entry)) {
+        return entry->map_size;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Sets the file size, truncating or extending the file
+ * @param pathname - name of the file to set the size for
+ * @param file_size - value of the file size property
+ * @return true if the file size was set
+ */
+bool bacfile_mmap_file_size_set(const char *pathname, size_t file_size)
+{
+    struct bacfile_mmap_entry *entry;
+
+    entry = bacfile_mmap_entry_open(pathname, false);
+    if (entry && entry->writable) {
+        if (ftruncate(entry->fd, (off_t)file_size) == 0) {
+            return true;
+        }
+        debug_perror("bacfile-mmap: ftruncate");
+    }
+
+    return false;
+}
+
+/**
+ * @brief Reads stream data from the mapping of a file
+ * @param pathname - name of the file to read from
+ * @param fileStartPosition - starting position in the file
+ * @param fileData - data buffer to read into
+ * @param fileDataLen - size of the data buffer
+ * @return number of bytes read, or 0 if not successful
+ */
+size_t bacfile_mmap_read_stream_data(
+    const char *pathname,
+    int32_t fileStartPosition,
+    uint8_t *fileData,
+    size_t fileDataLen)
+{
+    struct bacfile_mmap_entry *entry;
+    size_t len = 0;
+
+    if (fileStartPosition < 0) {
+        return 0;
+    }
+    entry = bacfile_mmap_entry_open(pathname, false);
+    if (entry && bacfile_mmap_entry_map(entry) &&
+        ((size_t)fileStartPosition < entry->map_size)) {
+        len = entry->map_size - (size_t)fileStartPosition;
+        if (len > fileDataLen) {
+            len = fileDataLen;
+        }
+        memcpy(fileData, &entry->map[fileStartPosition], len);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Writes stream data to a file
+ * @param pathname - name of the file to write to
+ * @param fileStartPosition - starting position in the file, 0 to write
+ *  the file as a clean slate, or -1 to append to the end of the file
+ * @param fileData - data buffer to write from
+ * @param fileDataLen - size of the data buffer
+ * @return number of bytes written, or 0 if not successful
+ */
+size_t bacfile_mmap_write_stream_data(
+    const char *pathname,
+    int32_t fileStartPosition,
+    const uint8_t *fileData,
+    size_t fileDataLen)
+{
+    struct bacfile_mmap_entry *entry;
+    struct stat st = { 0 };
+    size_t bytes_written = 0;
+    off_t offset;
+    ssize_t len;
+
+    if (fileStartPosition < -1) {
+        return 0;
+    }
+    entry = bacfile_mmap_entry_open(pathname, true);
+    if (!entry || !entry->writable) {
+        return 0;
+    }
+    if (fileStartPosition == 0) {
+        if (ftruncate(entry->fd, 0) != 0) {
+            debug_perror("bacfile-mmap: ftruncate");
+            return 0;
+        }
+        offset = 0;
+    } else if (fileStartPosition == -1) {
+        if (fstat(entry->fd, &st) != 0) {
+            debug_perror("bacfile-mmap: fstat");
+            return 0;
+        }
+        offset = st.st_size;
+    } else {
+        offset = fileStartPosition;
+    }
+    while (bytes_written < fileDataLen) {
+        len = pwrite(
+            entry->fd, &fileData[bytes_written], fileDataLen - bytes_written,
+            offset + (off_t)bytes_written);
+        if (len > 0) {
+            bytes_written += (size_t)len;
+        } else if ((len < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            debug_perror("bacfile-mmap: pwrite");
+            break;
+        }
+    }
+
+    return bytes_written;
+}
+
+/**
+ * @brief Close a file, so that the next access opens and maps the file
+ *  under its pathname again, for example after the file was replaced.
+ * @param pathname - name of the file, or NULL for all files
+ */
+void bacfile_mmap_invalidate(const char *pathname)
+{
+    struct bacfile_mmap_entry *entry;
+    unsigned i;
+
+    if (pathname) {
+        entry = bacfile_mmap_entry_find(pathname);
+        if (entry) {
+            bacfile_mmap_entry_close(entry);
+        }
+    } else {
+        for (i = 0; i < BACFILE_MMAP_FILES_MAX; i++) {
+            bacfile_mmap_entry_close(&File_Entry[i]);
+        }
+    }
+}
+
+/**
+ * @brief Use the memory mapped files for the stream access and the
+ *  file size of the File objects
+ */
+void bacfile_mmap_init(void)
+{
+    bacfile_write_stream_data_callback_set(bacfile_mmap_write_stream_data);
+    bacfile_read_stream_data_callback_set(bacfile_mmap_read_stream_data);
+    bacfile_file_size_callback_set(bacfile_mmap_file_size);
+    bacfile_file_size_set_callback_set(bacfile_mmap_file_size_set);
+}
+
+/**
+ * @brief Unmap and close all of the files
+ */
+void bacfile_mmap_cleanup(void)
+{
+    bacfile_mmap_invalidate(NULL);
+}
@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @brief API for File object stream access in memory mapped files (Linux)
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#ifndef BACNET_PORT_LINUX_BACFILE_MMAP_H
+#define BACNET_PORT_LINUX_BACFILE_MMAP_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* number of files that are kept open and mapped at the same time */
+#ifndef BACFILE_MMAP_FILES_MAX
+#define BACFILE_MMAP_FILES_MAX 8
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+size_t bacfile_mmap_file_size(const char *pathname);
+BACNET_STACK_EXPORT
+bool bacfile_mmap_file_size_set(const char *pathname, size_t file_size);
+BACNET_STACK_EXPORT
+size_t bacfile_mmap_read_stream_data(
+    const char *pathname,
+    int32_t fileStartPosition,
+    uint8_t *fileData,
+    size_t fileDataLen);
+BACNET_STACK_EXPORT
+size_t bacfile_mmap_write_stream_data(
+    const char *pathname,
+    int32_t fileStartPosition,
+    const uint8_t *fileData,
+    size_t fileDataLen);
+BACNET_STACK_EXPORT
+void bacfile_mmap_invalidate(const char *pathname);
+BACNET_STACK_EXPORT
+void bacfile_mmap_init(void);
+BACNET_STACK_EXPORT
+void bacfile_mmap_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -5,6 +5,10 @@
  * @date 2005
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
+/* for recvmmsg() and sendmmsg() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <asm/types.h>
 #include <netinet/ether.h>
 #include <netinet/in.h>
@@ -14,7 +18,9 @@
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <sys/types.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
+#include <pthread.h>
 /* standard C */
 #include <stdint.h> /* for standard integer types uint8_t etc. */
 #include <stdbool.h> /* for the standard bool type. */
@@ -30,6 +36,7 @@
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 #include "bacport.h"
+#include "bip-workers.h"
 
 /* unix sockets */
 static int BIP_Socket = -1;
@@ -50,10 +57,55 @@ static struct in_addr BIP_Netmask;
 /* broadcast binding mechanism */
 static bool BIP_Broadcast_Binding_Address_Override;
 static struct in_addr BIP_Broadcast_Binding_Address;
+/* multicast group that replaces the broadcast address, see J.8 */
+static struct in_addr BIP_Multicast_Group;
+static uint8_t BIP_Multicast_TTL = 1;
 /* enable debugging */
 static bool BIP_Debug = false;
+/* share the unicast port with other sockets, see bip_set_reuse_port() */
+static bool BIP_Reuse_Port = false;
 /* interface name */
 static char BIP_Interface_Name[IF_NAMESIZE] = { 0 };
+/* number of datagrams read from a socket with one recvmmsg() */
+#ifndef BIP_RECEIVE_RING_SIZE
+#define BIP_RECEIVE_RING_SIZE 16
+#endif
+/* number of datagrams sent with one sendmmsg() */
+#ifndef BIP_SEND_BATCH_SIZE
+#define BIP_SEND_BATCH_SIZE 64
+#endif
+/* zero bytes after each datagram as a safety margin for the decoders */
+#define BIP_RECEIVE_MARGIN 16
+/* a datagram in the receive ring */
+typedef struct BIP_Receive_Packet {
+    struct sockaddr_in sin;
+    bool broadcast;
+    uint16_t mtu_len;
+    uint8_t mtu[BIP_MPDU_MAX + BIP_RECEIVE_MARGIN];
+} BIP_RECEIVE_PACKET;
+static BIP_RECEIVE_PACKET BIP_Receive_Ring[BIP_RECEIVE_RING_SIZE];
+/* next datagram to return, and number of datagrams left to return */
+static unsigned BIP_Receive_Head;
+static unsigned BIP_Receive_Count;
+/* number of datagrams that other threads can hand to bip_receive() */
+#ifndef BIP_HANDOFF_RING_SIZE
+#define BIP_HANDOFF_RING_SIZE 32
+#endif
+static BIP_RECEIVE_PACKET BIP_Handoff_Ring[BIP_HANDOFF_RING_SIZE];
+static unsigned BIP_Handoff_Head;
+static unsigned BIP_Handoff_Count;
+static pthread_mutex_t BIP_Handoff_Mutex = PTHREAD_MUTEX_INITIALIZER;
+/* eventfd that is readable while datagrams are handed off */
+static int BIP_Handoff_Event = -1;
+/* DSCP of the datagrams of each network priority, see RFC 4594:
+   normal is default forwarding, urgent is AF31, critical equipment
+   is CS5, and life safety is EF */
+static uint8_t BIP_DSCP[MESSAGE_PRIORITY_LIFE_SAFETY + 1] = { 0, 26, 40, 46 };
+/* ancillary data that carries the IP_TOS of one datagram */
+typedef union BIP_TOS_Control {
+    char buf[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+} BIP_TOS_CONTROL;
 
 /**
  * @brief Print the IPv4 address with debug info
@@ -110,6 +162,84 @@ void bip_debug_disable(void)
     BIP_Debug = false;
 }
 
+/**
+ * @brief Let other sockets bind to the same BACnet/IP address and port
+ *  with SO_REUSEPORT, so that the kernel shares the unicast datagrams
+ *  between them, for example with bip_workers_init().
+ * @note Set before bip_init(), since it applies when the socket is bound.
+ * @param enable - true to set SO_REUSEPORT on the BACnet/IP sockets
+ */
+void bip_set_reuse_port(bool enable)
+{
+    BIP_Reuse_Port = enable;
+}
+
+/**
+ * @brief Set the DSCP that the datagrams of a network priority are
+ *  marked with, so that the network can queue the alarm and life safety
+ *  messages ahead of bulk reads and file transfers.
+ * @note The kernel also sets the queueing priority of the datagram from
+ *  its IP TOS, as it would for SO_PRIORITY. A DSCP of zero sends the
+ *  datagram with the socket defaults.
+ * @param priority - network priority from the NPDU control octet
+ * @param dscp - differentiated services code point, 0..63
+ */
+void bip_set_network_priority_dscp(
+    BACNET_MESSAGE_PRIORITY priority, uint8_t dscp)
+{
+    if ((unsigned)priority <= MESSAGE_PRIORITY_LIFE_SAFETY) {
+        BIP_DSCP[priority] = dscp & 0x3F;
+    }
+}
+
+/**
+ * @brief Get the DSCP that the datagrams of a network priority are
+ *  marked with
+ * @param priority - network priority from the NPDU control octet
+ * @return differentiated services code point, 0..63
+ */
+uint8_t bip_network_priority_dscp(BACNET_MESSAGE_PRIORITY priority)
+{
+    if ((unsigned)priority <= MESSAGE_PRIORITY_LIFE_SAFETY) {
+        return BIP_DSCP[priority];
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Build the ancillary data that marks a datagram with the DSCP of
+ *  the network priority of its NPDU. Each datagram carries its own mark,
+ *  so threads that share the socket do not change each other's marks.
+ * @param control - buffer for the ancillary data
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ * @return number of bytes of ancillary data, or 0 when the datagram is
+ *  sent with the socket defaults
+ */
+static size_t bip_tos_control(
+    BIP_TOS_CONTROL *control, const uint8_t *mtu, uint16_t mtu_len)
+{
+    struct cmsghdr *cmsg;
+    uint8_t dscp;
+    int tos;
+
+    dscp = bip_network_priority_dscp(bvlc_network_priority(mtu, mtu_len));
+    if (dscp == 0) {
+        return 0;
+    }
+    memset(control, 0, sizeof(*control));
+    cmsg = &control->align;
+    cmsg->cmsg_level = IPPROTO_IP;
+    cmsg->cmsg_type = IP_TOS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(tos));
+    /* DSCP is the upper six bits of the TOS octet */
+    tos = dscp << 2;
+    memcpy(CMSG_DATA(cmsg), &tos, sizeof(tos));
+
+    return CMSG_SPACE(sizeof(tos));
+}
+
 /**
  * @brief Set the BACnet IPv4 UDP port number
  * @param port - IPv4 UDP port number - in host byte order
@@ -297,6 +427,9 @@ int bip_send_mpdu(
     const BACNET_IP_ADDRESS *dest, const uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in bip_dest = { 0 };
+    BIP_TOS_CONTROL control;
+    struct msghdr msg = { 0 };
+    struct iovec iov;
 
     /* assumes that the driver has already been initialized */
     if (BIP_Socket < 0) {
@@ -313,113 +446,208 @@ int bip_send_mpdu(
     /* Send the packet */
     debug_print_ipv4(
         "Sending MPDU->", &bip_dest.sin_addr, bip_dest.sin_port, mtu_len);
-    return sendto(
-        BIP_Socket, (const char *)mtu, mtu_len, 0, (struct sockaddr *)&bip_dest,
-        sizeof(struct sockaddr));
+    msg.msg_controllen = bip_tos_control(&control, mtu, mtu_len);
+    if (msg.msg_controllen == 0) {
+        return sendto(
+            BIP_Socket, (const char *)mtu, mtu_len, 0,
+            (struct sockaddr *)&bip_dest, sizeof(struct sockaddr));
+    }
+    iov.iov_base = (void *)mtu;
+    iov.iov_len = mtu_len;
+    msg.msg_name = &bip_dest;
+    msg.msg_namelen = sizeof(struct sockaddr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+
+    return sendmsg(BIP_Socket, &msg, 0);
 }
 
 /**
- * BACnet/IP Datalink Receive handler.
+ * The send function for BACnet/IP driver layer to send the same MPDU
+ * to many destinations, such as a BBMD forwarding a broadcast to each
+ * BDT and FDT entry. The datagrams are sent in batches with sendmmsg().
  *
- * @param src - returns the source address
- * @param npdu - returns the NPDU buffer
- * @param max_npdu -maximum size of the NPDU buffer
- * @param timeout - number of milliseconds to wait for a packet
+ * @param dest - array of BACNET_IP_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
  *
- * @return Number of bytes received, or 0 if none or timeout.
+ * @return Upon successful completion, returns the number of destinations
+ *  the MPDU was sent to. Otherwise, -1 shall be returned to indicate the
+ *  error.
  */
-uint16_t bip_receive(
-    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
 {
-    uint16_t npdu_len = 0; /* return value */
-    fd_set read_fds;
-    int max = 0;
-    struct timeval select_timeout;
-    struct sockaddr_in sin = { 0 };
-    BACNET_IP_ADDRESS addr = { 0 };
-    socklen_t sin_len = sizeof(sin);
-    int received_bytes = 0;
-    int offset = 0;
-    uint16_t i = 0;
-    int socket;
+    struct mmsghdr msgs[BIP_SEND_BATCH_SIZE];
+    struct sockaddr_in bip_dest[BIP_SEND_BATCH_SIZE];
+    struct iovec iov;
+    BIP_TOS_CONTROL control;
+    size_t control_len;
+    unsigned count = 0, batch, i;
+    int sent_count = 0;
+    int sent;
 
-    /* Make sure the socket is open */
+    /* assumes that the driver has already been initialized */
     if (BIP_Socket < 0) {
-        return 0;
+        if (BIP_Debug) {
+            debug_fprintf(stderr, "BIP: driver not initialized!\n");
+            fflush(stderr);
+        }
+        return BIP_Socket;
     }
-    /* we could just use a non-blocking socket, but that consumes all
-       the CPU time.  We can use a timeout; it is only supported as
-       a select. */
-    if (timeout >= 1000) {
-        select_timeout.tv_sec = timeout / 1000;
-        select_timeout.tv_usec =
-            1000 * (timeout - select_timeout.tv_sec * 1000);
-    } else {
-        select_timeout.tv_sec = 0;
-        select_timeout.tv_usec = 1000 * timeout;
-    }
-    FD_ZERO(&read_fds);
-    FD_SET(BIP_Socket, &read_fds);
-    FD_SET(BIP_Broadcast_Socket, &read_fds);
-
-    max = BIP_Socket > BIP_Broadcast_Socket ? BIP_Socket : BIP_Broadcast_Socket;
-
-    /* see if there is a packet for us */
-    if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0) {
-        socket =
-            FD_ISSET(BIP_Socket, &read_fds) ? BIP_Socket : BIP_Broadcast_Socket;
-        received_bytes = recvfrom(
-            socket, (char *)&npdu[0], max_npdu, 0, (struct sockaddr *)&sin,
-            &sin_len);
-    } else {
+    /* every datagram uses the same data */
+    iov.iov_base = (void *)mtu;
+    iov.iov_len = mtu_len;
+    control_len = bip_tos_control(&control, mtu, mtu_len);
+    while (count < dest_count) {
+        batch = dest_count - count;
+        if (batch > BIP_SEND_BATCH_SIZE) {
+            batch = BIP_SEND_BATCH_SIZE;
+        }
+        memset(msgs, 0, sizeof(msgs[0]) * batch);
+        memset(bip_dest, 0, sizeof(bip_dest[0]) * batch);
+        for (i = 0; i < batch; i++) {
+            /* load destination IP address */
+            bip_dest[i].sin_family = AF_INET;
+            memcpy(
+                &bip_dest[i].sin_addr.s_addr, &dest[count + i].address[0], 4);
+            bip_dest[i].sin_port = htons(dest[count + i].port);
+            debug_print_ipv4(
+                "Sending MPDU->", &bip_dest[i].sin_addr, bip_dest[i].sin_port,
+                mtu_len);
+            msgs[i].msg_hdr.msg_name = &bip_dest[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr);
+            msgs[i].msg_hdr.msg_iov = &iov;
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            if (control_len > 0) {
+                msgs[i].msg_hdr.msg_control = control.buf;
+                msgs[i].msg_hdr.msg_controllen = control_len;
+            }
+        }
+        sent = sendmmsg(BIP_Socket, msgs, batch, 0);
+        if (sent > 0) {
+            count += sent;
+            sent_count += sent;
+        } else {
+            /* skip the destination that failed, as sendto() would */
+            count++;
+        }
+    }
+
+    return sent_count;
+}
+
+/**
+ * @brief Fill the receive ring with datagrams that are waiting on a socket
+ * @param socket - the socket to read from
+ * @param broadcast - true if the socket is the broadcast socket
+ * @return number of datagrams added to the receive ring
+ */
+static unsigned bip_receive_ring_fill(int socket, bool broadcast)
+{
+    struct mmsghdr msgs[BIP_RECEIVE_RING_SIZE];
+    struct iovec iovecs[BIP_RECEIVE_RING_SIZE];
+    BIP_RECEIVE_PACKET *packet;
+    unsigned count, i;
+    int received;
+
+    count = BIP_RECEIVE_RING_SIZE - BIP_Receive_Count;
+    if (count == 0) {
         return 0;
     }
-    /* See if there is a problem */
-    if (received_bytes < 0) {
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+    for (i = 0; i < count; i++) {
+        packet = &BIP_Receive_Ring[BIP_Receive_Count + i];
+        iovecs[i].iov_base = packet->mtu;
+        iovecs[i].iov_len = BIP_MPDU_MAX;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &packet->sin;
+        msgs[i].msg_hdr.msg_namelen = sizeof(packet->sin);
+    }
+    /* the socket is already known to be readable, so just take
+       what is waiting without blocking */
+    received = recvmmsg(socket, msgs, count, MSG_DONTWAIT, NULL);
+    if (received <= 0) {
         return 0;
     }
+    for (i = 0; i < (unsigned)received; i++) {
+        packet = &BIP_Receive_Ring[BIP_Receive_Count + i];
+        packet->mtu_len = msgs[i].msg_len;
+        packet->broadcast = broadcast;
+        /* Erase up to 16 bytes after the received bytes as safety margin
+         * to ensure that the decoding functions will run into a 'safe
+         * field' of zero, if for any reason they would overrun, when
+         * parsing the message. */
+        memset(&packet->mtu[packet->mtu_len], 0, BIP_RECEIVE_MARGIN);
+    }
+    BIP_Receive_Count += received;
+
+    return received;
+}
+
+/**
+ * @brief Handle one received datagram from the receive ring
+ * @param packet - the received datagram
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @return Number of NPDU bytes, or 0 if the datagram held no NPDU
+ */
+static uint16_t bip_receive_packet(
+    BIP_RECEIVE_PACKET *packet,
+    BACNET_ADDRESS *src,
+    uint8_t *npdu,
+    uint16_t max_npdu)
+{
+    uint16_t npdu_len = 0;
+    BACNET_IP_ADDRESS addr = { 0 };
+    int offset = 0;
+    int max = 0;
+
     /* no problem, just no bytes */
-    if (received_bytes == 0) {
+    if (packet->mtu_len == 0) {
         return 0;
     }
     /* the signature of a BACnet/IPv packet */
-    if (npdu[0] != BVLL_TYPE_BACNET_IP) {
+    if (packet->mtu[0] != BVLL_TYPE_BACNET_IP) {
         return 0;
     }
-    /* Erase up to 16 bytes after the received bytes as safety margin to
-     * ensure that the decoding functions will run into a 'safe field'
-     * of zero, if for any reason they would overrun, when parsing the
-     * message. */
-    max = (int)max_npdu - received_bytes;
-    if (max > 0) {
-        if (max > 16) {
-            max = 16;
-        }
-        memset(&npdu[received_bytes], 0, max);
-    }
     /* Data link layer addressing between B/IPv4 nodes consists of a 32-bit
        IPv4 address followed by a two-octet UDP port number (both of which
        shall be transmitted with the most significant octet first). This
        address shall be referred to as a B/IPv4 address.
     */
-    memcpy(&addr.address[0], &sin.sin_addr.s_addr, 4);
-    addr.port = ntohs(sin.sin_port);
+    memcpy(&addr.address[0], &packet->sin.sin_addr.s_addr, 4);
+    addr.port = ntohs(packet->sin.sin_port);
     debug_print_ipv4(
-        "Received MPDU->", &sin.sin_addr, sin.sin_port, received_bytes);
+        "Received MPDU->", &packet->sin.sin_addr, packet->sin.sin_port,
+        packet->mtu_len);
     /* pass the packet into the BBMD handler */
-    if (socket == BIP_Socket) {
-        offset = bvlc_handler(&addr, src, npdu, received_bytes);
+    if (packet->broadcast) {
+        offset = bvlc_broadcast_handler(
+            &addr, src, packet->mtu, packet->mtu_len);
     } else {
-        offset = bvlc_broadcast_handler(&addr, src, npdu, received_bytes);
+        offset = bvlc_handler(&addr, src, packet->mtu, packet->mtu_len);
     }
     if (offset > 0) {
-        npdu_len = received_bytes - offset;
+        npdu_len = packet->mtu_len - offset;
         debug_print_ipv4(
-            "Received NPDU->", &sin.sin_addr, sin.sin_port, npdu_len);
+            "Received NPDU->", &packet->sin.sin_addr, packet->sin.sin_port,
+            npdu_len);
         if (npdu_len <= max_npdu) {
-            /* shift the buffer to return a valid NPDU */
-            for (i = 0; i < npdu_len; i++) {
-                npdu[i] = npdu[offset + i];
+            memcpy(npdu, &packet->mtu[offset], npdu_len);
+            max = (int)max_npdu - npdu_len;
+            if (max > 0) {
+                if (max > BIP_RECEIVE_MARGIN) {
+                    max = BIP_RECEIVE_MARGIN;
+                }
+                memset(&npdu[npdu_len], 0, max);
             }
         } else {
             if (BIP_Debug) {
@@ -433,6 +661,180 @@ uint16_t bip_receive(
     return npdu_len;
 }
 
+/**
+ * @brief Enable other threads to hand received datagrams to the thread
+ *  that calls bip_receive(), with bip_receive_handoff()
+ * @return true if enabled
+ */
+bool bip_receive_handoff_init(void)
+{
+    if (BIP_Handoff_Event < 0) {
+        BIP_Handoff_Event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+
+    return BIP_Handoff_Event >= 0;
+}
+
+/**
+ * @brief Get the file descriptor that is readable while datagrams are
+ *  handed off, for an event loop
+ * @return file descriptor, or -1 if handoff is not enabled
+ */
+int bip_get_handoff_fd(void)
+{
+    return BIP_Handoff_Event;
+}
+
+/**
+ * @brief Hand a datagram that was received by another thread, for
+ *  example on a worker socket, to the thread that calls bip_receive(),
+ *  which passes it to the BVLC layer as if it had been received on the
+ *  unicast socket.  Safe to call from any thread.
+ * @param sin - source address of the datagram
+ * @param mtu - the datagram
+ * @param mtu_len - number of bytes in the datagram
+ * @return true if the datagram was queued, false if handoff is not
+ *  enabled or the queue is full
+ */
+bool bip_receive_handoff(
+    const struct sockaddr_in *sin, const uint8_t *mtu, uint16_t mtu_len)
+{
+    BIP_RECEIVE_PACKET *packet;
+    uint64_t event = 1;
+    bool status = false;
+    unsigned index;
+
+    if ((BIP_Handoff_Event < 0) || (mtu_len > BIP_MPDU_MAX)) {
+        return false;
+    }
+    pthread_mutex_lock(&BIP_Handoff_Mutex);
+    if (BIP_Handoff_Count < BIP_HANDOFF_RING_SIZE) {
+        index = (BIP_Handoff_Head + BIP_Handoff_Count) % BIP_HANDOFF_RING_SIZE;
+        packet = &BIP_Handoff_Ring[index];
+        packet->sin = *sin;
+        packet->broadcast = false;
+        packet->mtu_len = mtu_len;
+        memcpy(packet->mtu, mtu, mtu_len);
+        memset(&packet->mtu[mtu_len], 0, BIP_RECEIVE_MARGIN);
+        BIP_Handoff_Count++;
+        status = true;
+    }
+    pthread_mutex_unlock(&BIP_Handoff_Mutex);
+    if (status) {
+        (void)write(BIP_Handoff_Event, &event, sizeof(event));
+    }
+
+    return status;
+}
+
+/**
+ * @brief Move the handed off datagrams into the receive ring
+ * @return number of datagrams added to the receive ring
+ */
+static unsigned bip_receive_handoff_fill(void)
+{
+    uint64_t event = 0;
+    unsigned count = 0;
+
+    (void)read(BIP_Handoff_Event, &event, sizeof(event));
+    pthread_mutex_lock(&BIP_Handoff_Mutex);
+    while ((BIP_Handoff_Count > 0) &&
+           ((BIP_Receive_Count + count) < BIP_RECEIVE_RING_SIZE)) {
+        BIP_Receive_Ring[BIP_Receive_Count + count] =
+            BIP_Handoff_Ring[BIP_Handoff_Head];
+        BIP_Handoff_Head = (BIP_Handoff_Head + 1) % BIP_HANDOFF_RING_SIZE;
+        BIP_Handoff_Count--;
+        count++;
+    }
+    if (BIP_Handoff_Count > 0) {
+        /* the rest are received on the next call */
+        event = 1;
+        (void)write(BIP_Handoff_Event, &event, sizeof(event));
+    }
+    pthread_mutex_unlock(&BIP_Handoff_Mutex);
+    BIP_Receive_Count += count;
+
+    return count;
+}
+
+/**
+ * BACnet/IP Datalink Receive handler.
+ *
+ * Datagrams are read from the sockets in batches with recvmmsg() into
+ * a ring of receive buffers, and returned one at a time, so that a
+ * burst of datagrams costs one select() and one recvmmsg() per socket
+ * instead of one of each per datagram.
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+uint16_t bip_receive(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+    uint16_t npdu_len = 0; /* return value */
+    fd_set read_fds;
+    int max = 0;
+    struct timeval select_timeout;
+
+    /* Make sure the socket is open */
+    if (BIP_Socket < 0) {
+        return 0;
+    }
+    if (BIP_Receive_Count == 0) {
+        BIP_Receive_Head = 0;
+        /* we could just use a non-blocking socket, but that consumes all
+           the CPU time.  We can use a timeout; it is only supported as
+           a select. */
+        if (timeout >= 1000) {
+            select_timeout.tv_sec = timeout / 1000;
+            select_timeout.tv_usec =
+                1000 * (timeout - select_timeout.tv_sec * 1000);
+        } else {
+            select_timeout.tv_sec = 0;
+            select_timeout.tv_usec = 1000 * timeout;
+        }
+        FD_ZERO(&read_fds);
+        FD_SET(BIP_Socket, &read_fds);
+        FD_SET(BIP_Broadcast_Socket, &read_fds);
+        max = BIP_Socket > BIP_Broadcast_Socket ? BIP_Socket
+                                                : BIP_Broadcast_Socket;
+        if (BIP_Handoff_Event >= 0) {
+            FD_SET(BIP_Handoff_Event, &read_fds);
+            if (BIP_Handoff_Event > max) {
+                max = BIP_Handoff_Event;
+            }
+        }
+        /* see if there is a packet for us */
+        if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) <= 0) {
+            return 0;
+        }
+        if (FD_ISSET(BIP_Socket, &read_fds)) {
+            (void)bip_receive_ring_fill(BIP_Socket, false);
+        }
+        if ((BIP_Broadcast_Socket != BIP_Socket) &&
+            FD_ISSET(BIP_Broadcast_Socket, &read_fds)) {
+            (void)bip_receive_ring_fill(BIP_Broadcast_Socket, true);
+        }
+        if ((BIP_Handoff_Event >= 0) &&
+            FD_ISSET(BIP_Handoff_Event, &read_fds)) {
+            (void)bip_receive_handoff_fill();
+        }
+    }
+    /* skip the datagrams that were consumed by the BVLC layer */
+    while ((npdu_len == 0) && (BIP_Receive_Count > 0)) {
+        npdu_len = bip_receive_packet(
+            &BIP_Receive_Ring[BIP_Receive_Head], src, npdu, max_npdu);
+        BIP_Receive_Head++;
+        BIP_Receive_Count--;
+    }
+
+    return npdu_len;
+}
+
 /**
  * The common send function for BACnet/IP application layer
  *
@@ -758,6 +1160,94 @@ int bip_get_local_netmask(struct in_addr *netmask)
     return rv;
 }
 
+/**
+ * @brief Use an IP multicast group for the BACnet broadcasts, as
+ *  described in Annex J.8, instead of the subnet directed broadcast.
+ *  The group is joined on the interface, so that switches that snoop
+ *  IGMP forward the group to this port.
+ * @note Must be called before bip_init()
+ * @param group - multicast group address and UDP port, or NULL or
+ *  an address of 0.0.0.0 to use the subnet directed broadcast
+ * @param ttl - time-to-live of the multicasts, which is 1 to keep them
+ *  on the local subnet, or more to let multicast routers forward them
+ * @return true if the group was set
+ */
+bool bip_set_multicast_group(const BACNET_IP_ADDRESS *group, uint8_t ttl)
+{
+    struct in_addr address = { 0 };
+
+    if (group) {
+        memcpy(&address.s_addr, &group->address[0], 4);
+    }
+    if ((address.s_addr != 0) && !IN_MULTICAST(ntohl(address.s_addr))) {
+        return false;
+    }
+    BIP_Multicast_Group = address;
+    BIP_Multicast_TTL = ttl;
+
+    return true;
+}
+
+/**
+ * @brief Get the IP multicast group that is used for the BACnet broadcasts
+ * @param group - multicast group address and UDP port
+ * @return true if a multicast group is used
+ */
+bool bip_get_multicast_group(BACNET_IP_ADDRESS *group)
+{
+    if (BIP_Multicast_Group.s_addr == 0) {
+        return false;
+    }
+    if (group) {
+        memcpy(&group->address[0], &BIP_Multicast_Group.s_addr, 4);
+        group->port = ntohs(BIP_Port);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Join the multicast group on the socket that receives the
+ *  broadcasts, and send the multicasts from the unicast socket on the
+ *  interface with the configured time-to-live
+ * @return true if the sockets are configured for the multicast group
+ */
+static bool bip_multicast_join(void)
+{
+    struct ip_mreq mreq = { 0 };
+    unsigned char ttl = BIP_Multicast_TTL;
+    unsigned char loop = 0;
+
+    mreq.imr_multiaddr = BIP_Multicast_Group;
+    mreq.imr_interface = BIP_Address;
+    if (setsockopt(
+            BIP_Broadcast_Socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq,
+            sizeof(mreq)) < 0) {
+        if (BIP_Debug) {
+            perror("IP_ADD_MEMBERSHIP: ");
+        }
+        return false;
+    }
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_IF, &BIP_Address,
+            sizeof(BIP_Address)) < 0) {
+        return false;
+    }
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) <
+        0) {
+        return false;
+    }
+    /* our own broadcasts are not received */
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) <
+        0) {
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief Set the broadcast socket binding address
  * @param baddr The broadcast socket binding address, in host order.
@@ -832,6 +1322,10 @@ void bip_set_interface(const char *ifname)
         BIP_Broadcast_Addr.s_addr |= (~netmask.s_addr);
     }
 #endif
+    if (BIP_Multicast_Group.s_addr != 0) {
+        /* the BACnet broadcasts are sent to the multicast group */
+        BIP_Broadcast_Addr = BIP_Multicast_Group;
+    }
     if (BIP_Debug) {
         debug_fprintf(
             stderr, "BIP: Broadcast Address: %s\n",
@@ -875,6 +1369,15 @@ static int createSocket(const struct sockaddr_in *sin)
         close(sock_fd);
         return status;
     }
+    if (BIP_Reuse_Port) {
+        /* share the port with the worker sockets */
+        status = setsockopt(
+            sock_fd, SOL_SOCKET, SO_REUSEPORT, &sockopt, sizeof(sockopt));
+        if (status < 0) {
+            close(sock_fd);
+            return status;
+        }
+    }
     /* Bind to the proper interface to send without default gateway */
     status = setsockopt(
         sock_fd, SOL_SOCKET, SO_BINDTODEVICE, BIP_Interface_Name,
@@ -952,6 +1455,10 @@ bool bip_init(char *ifname)
     if (BIP_Broadcast_Binding_Address_Override) {
         broadcast_sin_config.sin_addr.s_addr =
             BIP_Broadcast_Binding_Address.s_addr;
+    } else if (BIP_Multicast_Group.s_addr != 0) {
+        /* receive the multicast group and the subnet broadcasts
+           of the devices that do not use the group */
+        broadcast_sin_config.sin_addr.s_addr = htonl(INADDR_ANY);
     } else {
 #if defined(BACNET_IP_BROADCAST_USE_INADDR_ANY)
         broadcast_sin_config.sin_addr.s_addr = htonl(INADDR_ANY);
@@ -974,6 +1481,14 @@ bool bip_init(char *ifname)
             return false;
         }
     }
+    if ((BIP_Multicast_Group.s_addr != 0) && !bip_multicast_join()) {
+        debug_fprintf(
+            stderr, "BIP: Failed to join the multicast group %s!\n",
+            inet_ntoa(BIP_Multicast_Group));
+        fflush(stderr);
+        bip_cleanup();
+        return false;
+    }
 
     bvlc_init();
 
@@ -1003,6 +1518,17 @@ void bip_cleanup(void)
         close(BIP_Broadcast_Socket);
     }
     BIP_Broadcast_Socket = -1;
+    /* discard any datagrams that were not returned yet */
+    BIP_Receive_Head = 0;
+    BIP_Receive_Count = 0;
+    if (BIP_Handoff_Event != -1) {
+        close(BIP_Handoff_Event);
+    }
+    BIP_Handoff_Event = -1;
+    pthread_mutex_lock(&BIP_Handoff_Mutex);
+    BIP_Handoff_Head = 0;
+    BIP_Handoff_Count = 0;
+    pthread_mutex_unlock(&BIP_Handoff_Mutex);
     /* these were set non-zero during interface configuration */
     BIP_Address.s_addr = 0;
     BIP_Broadcast_Addr.s_addr = 0;
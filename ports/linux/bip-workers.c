@@ -0,0 +1,456 @@
+/**
+ * @file
+ * @brief BACnet/IP worker threads that answer read requests (Linux)
+ * @details Each worker thread receives on its own UDP socket that is
+ *  bound with SO_REUSEPORT to the BACnet/IP address and port, so the
+ *  kernel shares the unicast datagrams between the workers and the
+ *  socket of bip_init() by a hash of the source address and port.
+ *
+ *  A worker answers a confirmed ReadProperty or ReadPropertyMultiple
+ *  request itself, in its own buffers, inside a read section.
+ *  Every other datagram, such as a write, a BVLC message for the BBMD,
+ *  or a network layer message, is handed to the thread that calls
+ *  bip_receive(), which is the owner of the stack and its only writer.
+ *  The owner holds the write lock with bip_workers_lock() while it
+ *  handles a message or runs the timers, so that the object tables are
+ *  not changed during a read.  Broadcasts are received by the owner only.
+ *
+ *  A read section only writes the epoch of its own worker: the epoch is
+ *  odd while the worker reads.  Readers on many cores thus do not share
+ *  a lock word, which a read-write lock bounces between the cores for
+ *  every read.  The owner takes the write lock by raising a flag and
+ *  waiting until every worker that was reading has moved to a newer
+ *  epoch, like the grace period of read-copy-update.  A worker that
+ *  finds the flag raised leaves its read section and sleeps until the
+ *  owner releases the write lock.
+ *
+ *  The readers only answer with handler_read_property_encode() and
+ *  handler_read_property_multiple_encode(), so an application that
+ *  replaces these handlers should not start any workers.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/dcc.h"
+#include "bacnet/npdu.h"
+#include "bacnet/datalink/bip.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/debug.h"
+#include "bip-workers.h"
+
+/* zero bytes after each datagram as a safety margin for the decoders */
+#define BIP_WORKER_MARGIN 16
+
+struct bip_worker {
+    /* odd while the worker reads the objects, on a cache line of its own */
+    unsigned long epoch __attribute__((aligned(64)));
+    pthread_t thread;
+    int socket;
+    /* received datagram */
+    uint8_t mtu[BIP_MPDU_MAX + BIP_WORKER_MARGIN];
+    /* reply, with the NPDU encoded after the BVLC header */
+    uint8_t reply[BIP_MPDU_MAX];
+    unsigned long reply_count;
+};
+static struct bip_worker BIP_Workers[BIP_WORKERS_MAX];
+static unsigned BIP_Worker_Count;
+/* eventfd that wakes up the workers to stop */
+static int BIP_Worker_Stop = -1;
+/* true while the owner holds the write lock */
+static bool BIP_Writer_Active;
+/* the workers sleep here while the owner holds the write lock */
+static pthread_mutex_t BIP_Writer_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t BIP_Writer_Done = PTHREAD_COND_INITIALIZER;
+static unsigned BIP_Writer_Waiting;
+
+/**
+ * @brief Begin a read section of a worker, once the owner does not hold
+ *  the write lock
+ * @param worker - the worker
+ */
+static void bip_worker_read_lock(struct bip_worker *worker)
+{
+    for (;;) {
+        /* odd epoch: reading */
+        (void)__atomic_add_fetch(&worker->epoch, 1, __ATOMIC_SEQ_CST);
+        if (!__atomic_load_n(&BIP_Writer_Active, __ATOMIC_SEQ_CST)) {
+            break;
+        }
+        /* let the owner write, and wait until it is done */
+        (void)__atomic_add_fetch(&worker->epoch, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_lock(&BIP_Writer_Mutex);
+        BIP_Writer_Waiting++;
+        while (__atomic_load_n(&BIP_Writer_Active, __ATOMIC_SEQ_CST)) {
+            pthread_cond_wait(&BIP_Writer_Done, &BIP_Writer_Mutex);
+        }
+        BIP_Writer_Waiting--;
+        pthread_mutex_unlock(&BIP_Writer_Mutex);
+    }
+}
+
+/**
+ * @brief End a read section of a worker
+ * @param worker - the worker
+ */
+static void bip_worker_read_unlock(struct bip_worker *worker)
+{
+    /* even epoch: not reading */
+    (void)__atomic_add_fetch(&worker->epoch, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Open a worker socket on the BACnet/IP address and port
+ * @return socket, or -1 on error
+ */
+static int bip_worker_socket(void)
+{
+    BACNET_IP_ADDRESS addr = { 0 };
+    struct sockaddr_in sin = { 0 };
+    int sockopt = 1;
+    int sock_fd;
+
+    if (!bip_get_addr(&addr)) {
+        return -1;
+    }
+    sock_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock_fd < 0) {
+        return -1;
+    }
+    if (setsockopt(
+            sock_fd, SOL_SOCKET, SO_REUSEPORT, &sockopt, sizeof(sockopt)) < 0) {
+        close(sock_fd);
+        return -1;
+    }
+    sin.sin_family = AF_INET;
+    memcpy(&sin.sin_addr.s_addr, &addr.address[0], 4);
+    sin.sin_port = htons(addr.port);
+    if (bind(sock_fd, (const struct sockaddr *)&sin, sizeof(sin)) < 0) {
+        /* the socket of bip_init() was not bound with SO_REUSEPORT,
+           see bip_set_reuse_port() */
+        close(sock_fd);
+        return -1;
+    }
+
+    return sock_fd;
+}
+
+/**
+ * @brief Answer a datagram if it is a ReadProperty or ReadPropertyMultiple
+ *  request for this device
+ * @param worker - the worker that received the datagram
+ * @param sin - source address of the datagram
+ * @param mtu_len - number of bytes in the datagram
+ * @return true if it was answered, false if it is for the owner
+ */
+static bool bip_worker_reply(
+    struct bip_worker *worker, const struct sockaddr_in *sin, uint16_t mtu_len)
+{
+    BACNET_IP_ADDRESS addr = { 0 };
+    BACNET_IP_ADDRESS my_addr = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_NPDU_DATA reply_npdu_data = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    uint8_t service_choice = 0;
+    uint8_t *service_request = NULL;
+    uint16_t service_request_len = 0;
+    uint8_t message_type = 0;
+    uint16_t message_length = 0;
+    uint8_t *npdu, *apdu;
+    uint16_t npdu_len, apdu_len;
+    int apdu_offset, pdu_len = 0;
+
+    if (bvlc_decode_header(
+            worker->mtu, mtu_len, &message_type, &message_length) !=
+        BIP_HEADER_MAX) {
+        return false;
+    }
+    if ((message_type != BVLC_ORIGINAL_UNICAST_NPDU) ||
+        (message_length != mtu_len)) {
+        return false;
+    }
+    memcpy(&addr.address[0], &sin->sin_addr.s_addr, 4);
+    addr.port = ntohs(sin->sin_port);
+    if (!bip_get_addr(&my_addr) || !bvlc_address_different(&addr, &my_addr)) {
+        /* the owner drops messages from my IPv4 address */
+        return false;
+    }
+    npdu = &worker->mtu[BIP_HEADER_MAX];
+    npdu_len = mtu_len - BIP_HEADER_MAX;
+    if ((npdu_len < 1) || (npdu[0] != BACNET_PROTOCOL_VERSION)) {
+        return false;
+    }
+    bvlc_ip_address_to_bacnet_local(&src, &addr);
+    apdu_offset = bacnet_npdu_decode(npdu, npdu_len, &dest, &src, &npdu_data);
+    if ((apdu_offset <= 0) || (apdu_offset >= npdu_len) ||
+        npdu_data.network_layer_message || (dest.net != 0)) {
+        return false;
+    }
+    apdu = &npdu[apdu_offset];
+    apdu_len = npdu_len - apdu_offset;
+    if ((apdu[0] & 0xF0) != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
+        return false;
+    }
+    if (apdu_decode_confirmed_service_request(
+            apdu, apdu_len, &service_data, &service_choice, &service_request,
+            &service_request_len) == 0) {
+        return false;
+    }
+    if (service_data.segmented_message) {
+        return false;
+    }
+    if ((service_choice != SERVICE_CONFIRMED_READ_PROPERTY) &&
+        (service_choice != SERVICE_CONFIRMED_READ_PROP_MULTIPLE)) {
+        return false;
+    }
+    if (npdu_data.data_expecting_reply) {
+        service_data.priority = npdu_data.priority;
+    } else {
+        service_data.priority = MESSAGE_PRIORITY_NORMAL;
+    }
+    bip_worker_read_lock(worker);
+    if (!dcc_communication_enabled()) {
+        /* the owner decides what is still answered */
+    } else if (service_choice == SERVICE_CONFIRMED_READ_PROPERTY) {
+        pdu_len = handler_read_property_encode(
+            &worker->reply[BIP_HEADER_MAX], MAX_PDU, service_request,
+            service_request_len, &src, &service_data, &reply_npdu_data);
+    } else {
+        pdu_len = handler_read_property_multiple_encode(
+            &worker->reply[BIP_HEADER_MAX], MAX_PDU, service_request,
+            service_request_len, &src, &service_data, &reply_npdu_data);
+    }
+    bip_worker_read_unlock(worker);
+    if (pdu_len <= 0) {
+        return false;
+    }
+#if BACNET_SEGMENTATION_ENABLED
+    if (service_data.segmented_response_accepted) {
+        /* a reply that is too big is sent in segments by the owner */
+        apdu_offset = bacnet_npdu_decode(
+            &worker->reply[BIP_HEADER_MAX], (uint16_t)pdu_len, NULL, NULL,
+            &reply_npdu_data);
+        if ((apdu_offset > 0) && (apdu_offset < pdu_len) &&
+            ((worker->reply[BIP_HEADER_MAX + apdu_offset] & 0xF0) ==
+             PDU_TYPE_ABORT)) {
+            return false;
+        }
+    }
+#endif
+    pdu_len += BIP_HEADER_MAX;
+    (void)bvlc_encode_header(
+        worker->reply, sizeof(worker->reply), BVLC_ORIGINAL_UNICAST_NPDU,
+        (uint16_t)pdu_len);
+    if (sendto(
+            worker->socket, worker->reply, pdu_len, 0,
+            (const struct sockaddr *)sin, sizeof(*sin)) < 0) {
+        debug_perror("BIP: worker sendto");
+    }
+    (void)__atomic_add_fetch(&worker->reply_count, 1, __ATOMIC_RELAXED);
+
+    return true;
+}
+
+/**
+ * @brief Receive and answer datagrams on a worker socket until stopped
+ * @param arg - the worker
+ * @return NULL
+ */
+static void *bip_worker_thread(void *arg)
+{
+    struct bip_worker *worker = arg;
+    struct pollfd fds[2];
+    struct sockaddr_in sin;
+    socklen_t sin_len;
+    ssize_t received;
+
+    fds[0].fd = worker->socket;
+    fds[0].events = POLLIN;
+    fds[1].fd = BIP_Worker_Stop;
+    fds[1].events = POLLIN;
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+        sin_len = sizeof(sin);
+        received = recvfrom(
+            worker->socket, worker->mtu, BIP_MPDU_MAX, MSG_DONTWAIT,
+            (struct sockaddr *)&sin, &sin_len);
+        if (received <= 0) {
+            continue;
+        }
+        memset(&worker->mtu[received], 0, BIP_WORKER_MARGIN);
+        if (!bip_worker_reply(worker, &sin, (uint16_t)received)) {
+            if (!bip_receive_handoff(&sin, worker->mtu, (uint16_t)received)) {
+                debug_fprintf(stderr, "BIP: worker datagram dropped!\n");
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Start worker threads that answer ReadProperty and
+ *  ReadPropertyMultiple requests on their own sockets.
+ * @note bip_set_reuse_port(true) must be called before bip_init(), and
+ *  the owner must then call bip_workers_lock() and bip_workers_unlock()
+ *  around everything it does with the stack other than bip_receive().
+ *  Call bip_workers_cleanup() before bip_cleanup().
+ * @param count - number of worker threads, from 1 to BIP_WORKERS_MAX
+ * @return true if the workers were started
+ */
+bool bip_workers_init(unsigned count)
+{
+    struct bip_worker *worker;
+    unsigned i;
+
+    if ((count == 0) || (count > BIP_WORKERS_MAX) || (BIP_Worker_Count > 0) ||
+        !bip_valid()) {
+        return false;
+    }
+    if (!bip_receive_handoff_init()) {
+        return false;
+    }
+    BIP_Worker_Stop = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (BIP_Worker_Stop < 0) {
+        return false;
+    }
+    BIP_Writer_Active = false;
+    for (i = 0; i < count; i++) {
+        worker = &BIP_Workers[i];
+        worker->epoch = 0;
+        worker->reply_count = 0;
+        worker->socket = bip_worker_socket();
+        if (worker->socket < 0) {
+            break;
+        }
+        if (pthread_create(
+                &worker->thread, NULL, bip_worker_thread, worker) != 0) {
+            close(worker->socket);
+            break;
+        }
+        BIP_Worker_Count++;
+    }
+    if (BIP_Worker_Count < count) {
+        bip_workers_cleanup();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Stop the worker threads and close their sockets
+ */
+void bip_workers_cleanup(void)
+{
+    uint64_t event = 1;
+    unsigned i;
+
+    if (BIP_Worker_Stop < 0) {
+        return;
+    }
+    (void)write(BIP_Worker_Stop, &event, sizeof(event));
+    for (i = 0; i < BIP_Worker_Count; i++) {
+        pthread_join(BIP_Workers[i].thread, NULL);
+        close(BIP_Workers[i].socket);
+        BIP_Workers[i].socket = -1;
+    }
+    BIP_Worker_Count = 0;
+    close(BIP_Worker_Stop);
+    BIP_Worker_Stop = -1;
+}
+
+/**
+ * @brief Get the number of running worker threads
+ * @return number of worker threads
+ */
+unsigned bip_workers_count(void)
+{
+    return BIP_Worker_Count;
+}
+
+/**
+ * @brief Get the number of requests that were answered by the workers
+ * @return number of replies
+ */
+unsigned long bip_workers_reply_count(void)
+{
+    unsigned long count = 0;
+    unsigned i;
+
+    for (i = 0; i < BIP_Worker_Count; i++) {
+        count += __atomic_load_n(&BIP_Workers[i].reply_count, __ATOMIC_RELAXED);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Take the write lock, so that no worker reads the objects
+ *  while the owner handles a message or runs the timers
+ */
+void bip_workers_lock(void)
+{
+    unsigned long epoch[BIP_WORKERS_MAX];
+    unsigned i;
+
+    if (BIP_Worker_Count == 0) {
+        return;
+    }
+    /* no new read sections */
+    __atomic_store_n(&BIP_Writer_Active, true, __ATOMIC_SEQ_CST);
+    for (i = 0; i < BIP_Worker_Count; i++) {
+        epoch[i] = __atomic_load_n(&BIP_Workers[i].epoch, __ATOMIC_SEQ_CST);
+    }
+    /* wait for the read sections in progress to end */
+    for (i = 0; i < BIP_Worker_Count; i++) {
+        while ((epoch[i] & 1) &&
+               (__atomic_load_n(&BIP_Workers[i].epoch, __ATOMIC_ACQUIRE) ==
+                epoch[i])) {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * @brief Release the write lock
+ */
+void bip_workers_unlock(void)
+{
+    if (BIP_Worker_Count == 0) {
+        return;
+    }
+    pthread_mutex_lock(&BIP_Writer_Mutex);
+    __atomic_store_n(&BIP_Writer_Active, false, __ATOMIC_SEQ_CST);
+    if (BIP_Writer_Waiting > 0) {
+        pthread_cond_broadcast(&BIP_Writer_Done);
+    }
+    pthread_mutex_unlock(&BIP_Writer_Mutex);
+}
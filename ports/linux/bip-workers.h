@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief API for BACnet/IP worker threads that answer read requests
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#ifndef BACNET_PORT_LINUX_BIP_WORKERS_H
+#define BACNET_PORT_LINUX_BIP_WORKERS_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <netinet/in.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* maximum number of worker threads */
+#ifndef BIP_WORKERS_MAX
+#define BIP_WORKERS_MAX 16
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool bip_workers_init(unsigned count);
+BACNET_STACK_EXPORT
+void bip_workers_cleanup(void);
+BACNET_STACK_EXPORT
+unsigned bip_workers_count(void);
+BACNET_STACK_EXPORT
+unsigned long bip_workers_reply_count(void);
+
+BACNET_STACK_EXPORT
+void bip_workers_lock(void);
+BACNET_STACK_EXPORT
+void bip_workers_unlock(void);
+
+/* implemented in bip-init.c */
+BACNET_STACK_EXPORT
+void bip_set_reuse_port(bool enable);
+BACNET_STACK_EXPORT
+void bip_set_network_priority_dscp(
+    BACNET_MESSAGE_PRIORITY priority, uint8_t dscp);
+BACNET_STACK_EXPORT
+uint8_t bip_network_priority_dscp(BACNET_MESSAGE_PRIORITY priority);
+BACNET_STACK_EXPORT
+bool bip_receive_handoff_init(void);
+BACNET_STACK_EXPORT
+int bip_get_handoff_fd(void);
+BACNET_STACK_EXPORT
+bool bip_receive_handoff(
+    const struct sockaddr_in *sin, const uint8_t *mtu, uint16_t mtu_len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -5,6 +5,10 @@
  * @date 2016
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
+/* for sendmmsg() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <ifaddrs.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,6 +28,10 @@
 
 /* enable debugging */
 static bool BIP6_Debug = false;
+/* number of datagrams sent with one sendmmsg() */
+#ifndef BIP6_SEND_BATCH_SIZE
+#define BIP6_SEND_BATCH_SIZE 64
+#endif
 
 /**
  * @brief Conditionally use the debug_printf function
@@ -227,6 +235,32 @@ bool bip6_get_broadcast_addr(BACNET_IP6_ADDRESS *addr)
     return bvlc6_address_copy(addr, &BIP6_Broadcast_Addr);
 }
 
+/**
+ * @brief Load a BACnet/IPv6 address into a socket address
+ * @param bvlc_dest - [out] socket address
+ * @param dest - BACnet/IPv6 address
+ */
+static void bip6_sockaddr_set(
+    struct sockaddr_in6 *bvlc_dest, const BACNET_IP6_ADDRESS *dest)
+{
+    uint16_t addr16[8];
+
+    bvlc_dest->sin6_family = AF_INET6;
+    bvlc6_address_get(
+        dest, &addr16[0], &addr16[1], &addr16[2], &addr16[3], &addr16[4],
+        &addr16[5], &addr16[6], &addr16[7]);
+    bvlc_dest->sin6_addr.s6_addr16[0] = htons(addr16[0]);
+    bvlc_dest->sin6_addr.s6_addr16[1] = htons(addr16[1]);
+    bvlc_dest->sin6_addr.s6_addr16[2] = htons(addr16[2]);
+    bvlc_dest->sin6_addr.s6_addr16[3] = htons(addr16[3]);
+    bvlc_dest->sin6_addr.s6_addr16[4] = htons(addr16[4]);
+    bvlc_dest->sin6_addr.s6_addr16[5] = htons(addr16[5]);
+    bvlc_dest->sin6_addr.s6_addr16[6] = htons(addr16[6]);
+    bvlc_dest->sin6_addr.s6_addr16[7] = htons(addr16[7]);
+    bvlc_dest->sin6_port = htons(dest->port);
+    bvlc_dest->sin6_scope_id = BIP6_Socket_Scope_Id;
+}
+
 /**
  * The send function for BACnet/IPv6 driver layer
  *
@@ -242,27 +276,13 @@ int bip6_send_mpdu(
     const BACNET_IP6_ADDRESS *dest, const uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in6 bvlc_dest = { 0 };
-    uint16_t addr16[8];
 
     /* assumes that the driver has already been initialized */
     if (BIP6_Socket < 0) {
         return 0;
     }
     /* load destination IP address */
-    bvlc_dest.sin6_family = AF_INET6;
-    bvlc6_address_get(
-        dest, &addr16[0], &addr16[1], &addr16[2], &addr16[3], &addr16[4],
-        &addr16[5], &addr16[6], &addr16[7]);
-    bvlc_dest.sin6_addr.s6_addr16[0] = htons(addr16[0]);
-    bvlc_dest.sin6_addr.s6_addr16[1] = htons(addr16[1]);
-    bvlc_dest.sin6_addr.s6_addr16[2] = htons(addr16[2]);
-    bvlc_dest.sin6_addr.s6_addr16[3] = htons(addr16[3]);
-    bvlc_dest.sin6_addr.s6_addr16[4] = htons(addr16[4]);
-    bvlc_dest.sin6_addr.s6_addr16[5] = htons(addr16[5]);
-    bvlc_dest.sin6_addr.s6_addr16[6] = htons(addr16[6]);
-    bvlc_dest.sin6_addr.s6_addr16[7] = htons(addr16[7]);
-    bvlc_dest.sin6_port = htons(dest->port);
-    bvlc_dest.sin6_scope_id = BIP6_Socket_Scope_Id;
+    bip6_sockaddr_set(&bvlc_dest, dest);
     debug_print_ipv6("Sending MPDU->", &bvlc_dest.sin6_addr);
     /* Send the packet */
     return sendto(
@@ -270,6 +290,67 @@ int bip6_send_mpdu(
         (struct sockaddr *)&bvlc_dest, sizeof(bvlc_dest));
 }
 
+/**
+ * The send function for BACnet/IPv6 driver layer to send the same MPDU
+ * to many destinations, such as a BBMD forwarding a broadcast to each
+ * BDT and FDT entry.  The MPDU is sent in batches of up to
+ * BIP6_SEND_BATCH_SIZE datagrams with one sendmmsg().
+ *
+ * @param dest - array of BACNET_IP6_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return the number of destinations the MPDU was sent to
+ */
+int bip6_send_mpdu_multiple(
+    const BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    struct mmsghdr msgs[BIP6_SEND_BATCH_SIZE];
+    struct sockaddr_in6 bvlc_dest[BIP6_SEND_BATCH_SIZE];
+    struct iovec iov;
+    unsigned count = 0, batch, i;
+    int sent_count = 0;
+    int sent;
+
+    /* assumes that the driver has already been initialized */
+    if (BIP6_Socket < 0) {
+        return 0;
+    }
+    /* every datagram uses the same data */
+    iov.iov_base = (void *)mtu;
+    iov.iov_len = mtu_len;
+    while (count < dest_count) {
+        batch = dest_count - count;
+        if (batch > BIP6_SEND_BATCH_SIZE) {
+            batch = BIP6_SEND_BATCH_SIZE;
+        }
+        memset(msgs, 0, sizeof(msgs[0]) * batch);
+        memset(bvlc_dest, 0, sizeof(bvlc_dest[0]) * batch);
+        for (i = 0; i < batch; i++) {
+            bip6_sockaddr_set(&bvlc_dest[i], &dest[count + i]);
+            debug_print_ipv6("Sending MPDU->", &bvlc_dest[i].sin6_addr);
+            msgs[i].msg_hdr.msg_name = &bvlc_dest[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(bvlc_dest[i]);
+            msgs[i].msg_hdr.msg_iov = &iov;
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        sent = sendmmsg(BIP6_Socket, msgs, batch, 0);
+        if (sent > 0) {
+            count += sent;
+            sent_count += sent;
+        } else {
+            /* skip the destination that failed, as sendto() would */
+            count++;
+        }
+    }
+
+    return sent_count;
+}
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
@@ -378,6 +459,15 @@ uint16_t bip6_receive(
     return npdu_len;
 }
 
+/**
+ * @brief Get the BACnet/IPv6 socket, for use with an event loop
+ * @return the BACnet/IPv6 socket, or -1 if not initialized
+ */
+int bip6_get_socket(void)
+{
+    return BIP6_Socket;
+}
+
 /** Cleanup and close out the BACnet/IP services by closing the socket.
  * @ingroup DLBIP6
  */
@@ -6,13 +6,21 @@
  * @date 2008
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
+/* for pthread_setaffinity_np() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <poll.h>
 #include <sys/time.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -23,6 +31,8 @@
 #include "bacnet/basic/sys/ringbuf.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/perfstat.h"
 /* OS Specific include */
 #include "bacport.h"
 /* port specific */
@@ -32,16 +42,14 @@
 #ifndef MSTP_RECEIVE_PACKET_COUNT
 #define MSTP_RECEIVE_PACKET_COUNT 8
 #endif
+/* The queues are single producer, single consumer rings without a lock:
+   the MS/TP thread puts received packets and takes the PDUs to send,
+   and one application thread does the opposite. */
 static DLMSTP_PACKET Receive_Buffer[MSTP_RECEIVE_PACKET_COUNT];
 static RING_BUFFER Receive_Queue;
-/* mechanism to wait for a packet */
-static pthread_cond_t Receive_Packet_Flag;
-static pthread_mutex_t Receive_Packet_Mutex;
-static pthread_cond_t Received_Frame_Flag;
-static pthread_mutex_t Received_Frame_Mutex;
-static pthread_cond_t Master_Done_Flag;
-static pthread_mutex_t Master_Done_Mutex;
-static pthread_mutex_t Ring_Buffer_Mutex;
+/* readable while the receive queue is not empty, to wait for a packet
+   here or in an event loop */
+static int Receive_Packet_Event = -1;
 static pthread_mutex_t Thread_Mutex;
 static pthread_t hThread;
 static struct timespec Clock_Get_Time_Start;
@@ -75,6 +83,12 @@ static dlmstp_hook_frame_rx_complete_cb Valid_Frame_Not_For_Us_Rx_Callback;
 static dlmstp_hook_frame_rx_complete_cb Invalid_Frame_Rx_Callback;
 static DLMSTP_STATISTICS DLMSTP_Statistics;
 static bool DLMSTP_Initialized;
+/* precise timing: the silence is measured with the raw monotonic clock,
+   the thread sleeps until the next timeout, and is pinned to a CPU */
+static bool Precise_Timing;
+static int Precise_Timing_CPU = -1;
+static struct timespec Silence_Start;
+static DLMSTP_TIMING_STATISTICS DLMSTP_Timing_Statistics;
 
 /**
  * @brief Cleanup the MS/TP datalink
@@ -85,16 +99,24 @@ void dlmstp_cleanup(void)
     Thread_Run = false;
     pthread_mutex_unlock(&Thread_Mutex);
     pthread_join(hThread, NULL);
-    pthread_cond_destroy(&Received_Frame_Flag);
-    pthread_cond_destroy(&Receive_Packet_Flag);
-    pthread_cond_destroy(&Master_Done_Flag);
-    pthread_mutex_destroy(&Received_Frame_Mutex);
-    pthread_mutex_destroy(&Receive_Packet_Mutex);
-    pthread_mutex_destroy(&Master_Done_Mutex);
-    pthread_mutex_destroy(&Ring_Buffer_Mutex);
+    pthread_mutex_destroy(&Thread_Mutex);
+    if (Receive_Packet_Event >= 0) {
+        close(Receive_Packet_Event);
+        Receive_Packet_Event = -1;
+    }
     DLMSTP_Initialized = false;
 }
 
+/**
+ * @brief Get a file descriptor that is readable while a received PDU
+ *  is waiting for dlmstp_receive(), for use with an event loop
+ * @return file descriptor, or -1 if not initialized
+ */
+int dlmstp_get_receive_fd(void)
+{
+    return Receive_Packet_Event;
+}
+
 /**
  * @brief send an PDU via MSTP
  * @param dest - BACnet destination address
@@ -112,7 +134,13 @@ int dlmstp_send_pdu(
     int bytes_sent = 0;
     struct mstp_pdu_packet *pkt;
     unsigned i = 0;
-    pthread_mutex_lock(&Ring_Buffer_Mutex);
+
+    if ((pdu_len > MSTP_FRAME_NPDU_MAX) && dest && dest->mac_len &&
+        MSTP_Extended_Frames_Refused(&MSTP_Port, dest->mac[0])) {
+        /* the station does not accept the extended frame that
+           the PDU needs, so the caller segments it or sends less */
+        return 0;
+    }
     pkt = (struct mstp_pdu_packet *)Ringbuf_Data_Peek(&PDU_Queue);
     if (pkt) {
         pkt->data_expecting_reply = npdu_data->data_expecting_reply;
@@ -130,7 +158,6 @@ int dlmstp_send_pdu(
             bytes_sent = pdu_len;
         }
     }
-    pthread_mutex_unlock(&Ring_Buffer_Mutex);
     if (!pkt) {
         debug_printf("DLMSTP: PDU Queue Full!\n");
     }
@@ -151,12 +178,10 @@ uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     struct mstp_pdu_packet *pkt;
 
     (void)timeout;
-    pthread_mutex_lock(&Ring_Buffer_Mutex);
-    if (Ringbuf_Empty(&PDU_Queue)) {
-        pthread_mutex_unlock(&Ring_Buffer_Mutex);
+    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue);
+    if (!pkt) {
         return 0;
     }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue);
     if (pkt->data_expecting_reply) {
         frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
     } else {
@@ -168,7 +193,6 @@ uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
         mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
         mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
     (void)Ringbuf_Pop(&PDU_Queue, NULL);
-    pthread_mutex_unlock(&Ring_Buffer_Mutex);
 
     return pdu_len;
 }
@@ -235,7 +259,6 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     struct mstp_pdu_packet *pkt;
     (void)timeout;
 
-    pthread_mutex_lock(&Ring_Buffer_Mutex);
     for (pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue); pkt;
          pkt = (struct mstp_pdu_packet *)Ringbuf_Peek_Next(
              &PDU_Queue, (uint8_t *)pkt)) {
@@ -260,10 +283,11 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
             mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
             mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
         DLMSTP_Statistics.transmit_pdu_counter++;
+        PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_MSTP);
+        BACTRACE_DATALINK_SEND(PERFSTAT_DATALINK_MSTP, pkt->length);
         /* This will pop the element no matter where we found it */
         (void)Ringbuf_Pop_Element(&PDU_Queue, (uint8_t *)pkt, NULL);
     }
-    pthread_mutex_unlock(&Ring_Buffer_Mutex);
     if (pdu_len <= 0) {
         /* Didn't find a match so wait for application layer to provide one */
         millisleep(1);
@@ -283,8 +307,22 @@ void MSTP_Send_Frame(
     const uint8_t *buffer,
     uint16_t nbytes)
 {
+    DLMSTP_TIMING_STATISTICS *timing = &DLMSTP_Timing_Statistics;
+    uint32_t turnaround_usec;
+
     RS485_Send_Frame(mstp_port, buffer, nbytes);
     DLMSTP_Statistics.transmit_frame_counter++;
+    if (Precise_Timing) {
+        turnaround_usec = RS485_Turnaround_Microseconds();
+        if ((timing->turnaround_counter == 0) ||
+            (turnaround_usec < timing->turnaround_min_usec)) {
+            timing->turnaround_min_usec = turnaround_usec;
+        }
+        if (turnaround_usec > timing->turnaround_max_usec) {
+            timing->turnaround_max_usec = turnaround_usec;
+        }
+        timing->turnaround_counter++;
+    }
 }
 
 /**
@@ -296,7 +334,6 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
     uint16_t pdu_len = 0;
     DLMSTP_PACKET *pkt;
 
-    pthread_mutex_lock(&Receive_Packet_Mutex);
     pkt = (DLMSTP_PACKET *)Ringbuf_Data_Peek(&Receive_Queue);
     if (!pkt) {
         debug_printf("MS/TP: Dropped! Not Ready.\n");
@@ -315,10 +352,9 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
         pkt->pdu_len = mstp_port->DataLength;
         pkt->ready = true;
         if (Ringbuf_Data_Put(&Receive_Queue, (uint8_t *)pkt)) {
-            pthread_cond_signal(&Receive_Packet_Flag);
+            (void)eventfd_write(Receive_Packet_Event, 1);
         }
     }
-    pthread_mutex_unlock(&Receive_Packet_Mutex);
 
     return pdu_len;
 }
@@ -336,15 +372,21 @@ uint16_t dlmstp_receive(
     unsigned timeout)
 { /* milliseconds to wait for a packet */
     uint16_t pdu_len = 0;
-    struct timespec abstime;
+    struct pollfd fds = { 0 };
     DLMSTP_PACKET *pkt;
+    eventfd_t value;
     (void)max_pdu;
 
-    pthread_mutex_lock(&Receive_Packet_Mutex);
-    if (timeout > 0) {
-        get_abstime(&abstime, timeout);
-        pthread_cond_timedwait(
-            &Receive_Packet_Flag, &Receive_Packet_Mutex, &abstime);
+    if ((timeout > 0) && Ringbuf_Empty(&Receive_Queue)) {
+        if (timeout > 1000) {
+            fprintf(
+                stderr, "DLMSTP: limited timeout of %ums to 1000ms\n",
+                timeout);
+            timeout = 1000;
+        }
+        fds.fd = Receive_Packet_Event;
+        fds.events = POLLIN;
+        (void)poll(&fds, 1, timeout);
     }
 
     /* see if there is a packet available, and a place
@@ -353,6 +395,8 @@ uint16_t dlmstp_receive(
     if (pkt) {
         if (pkt->pdu_len) {
             DLMSTP_Statistics.receive_pdu_counter++;
+            PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_MSTP);
+            BACTRACE_DATALINK_RECEIVE(PERFSTAT_DATALINK_MSTP, pkt->pdu_len);
             if (src) {
                 memmove(src, &pkt->address, sizeof(pkt->address));
             }
@@ -364,18 +408,87 @@ uint16_t dlmstp_receive(
         pkt->ready = false;
         (void)Ringbuf_Pop(&Receive_Queue, NULL);
     }
-    pthread_mutex_unlock(&Receive_Packet_Mutex);
+    if (Ringbuf_Empty(&Receive_Queue)) {
+        /* nothing left to receive, so clear the event, unless a packet
+           was put between the check and the clear */
+        (void)eventfd_read(Receive_Packet_Event, &value);
+        if (!Ringbuf_Empty(&Receive_Queue)) {
+            (void)eventfd_write(Receive_Packet_Event, 1);
+        }
+    }
 
     return pdu_len;
 }
 
+/**
+ * @brief Get the RS-485 silence time in microseconds
+ * @return silence time in microseconds
+ */
+static uint32_t dlmstp_silence_microseconds(void)
+{
+    struct timespec now;
+    int64_t usec;
+
+    if (Precise_Timing) {
+        clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+        usec = ((int64_t)(now.tv_sec - Silence_Start.tv_sec) * 1000000LL) +
+            ((now.tv_nsec - Silence_Start.tv_nsec) / 1000L);
+    } else {
+        usec = (int64_t)mstimer_elapsed(&Silence_Timer) * 1000LL;
+    }
+    if (usec < 0) {
+        usec = 0;
+    } else if (usec > UINT32_MAX) {
+        usec = UINT32_MAX;
+    }
+
+    return (uint32_t)usec;
+}
+
+/**
+ * @brief Get the silence after which the master node state machine
+ *  has a timeout to handle in its current state
+ * @return timeout in milliseconds, or 0 if the state machine runs now
+ */
+static uint32_t dlmstp_master_timeout(void)
+{
+    switch (MSTP_Port.master_state) {
+        case MSTP_MASTER_STATE_IDLE:
+            return Tno_token;
+        case MSTP_MASTER_STATE_WAIT_FOR_REPLY:
+            return MSTP_Port.Treply_timeout;
+        case MSTP_MASTER_STATE_POLL_FOR_MASTER:
+            return MSTP_Port.Tusage_timeout;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Count a timeout that the state machine handles
+ * @param late_usec - microseconds since the timeout expired
+ */
+static void dlmstp_timing_timeout(uint32_t late_usec)
+{
+    DLMSTP_TIMING_STATISTICS *timing = &DLMSTP_Timing_Statistics;
+
+    timing->timeout_counter++;
+    timing->timeout_late_sum_usec += late_usec;
+    if (late_usec > timing->timeout_late_max_usec) {
+        timing->timeout_late_max_usec = late_usec;
+    }
+}
+
 /**
  * @brief Thread for the MS/TP state machines
  * @param pArg not used
  */
 static void *dlmstp_thread(void *pArg)
 {
-    uint32_t silence_milliseconds = 0;
+    uint32_t silence_microseconds = 0;
+    uint32_t timeout_microseconds = 0;
     bool run_master = false;
     bool thread_alive = true;
     bool run_loop;
@@ -428,26 +541,18 @@ static void *dlmstp_thread(void *pArg)
             }
             run_master = true;
         } else {
-            silence_milliseconds = MSTP_Port.SilenceTimer(&MSTP_Port);
-            switch (MSTP_Port.master_state) {
-                case MSTP_MASTER_STATE_IDLE:
-                    if (silence_milliseconds >= Tno_token) {
-                        run_master = true;
-                    }
-                    break;
-                case MSTP_MASTER_STATE_WAIT_FOR_REPLY:
-                    if (silence_milliseconds >= MSTP_Port.Treply_timeout) {
-                        run_master = true;
-                    }
-                    break;
-                case MSTP_MASTER_STATE_POLL_FOR_MASTER:
-                    if (silence_milliseconds >= MSTP_Port.Tusage_timeout) {
-                        run_master = true;
-                    }
-                    break;
-                default:
-                    run_master = true;
-                    break;
+            timeout_microseconds = dlmstp_master_timeout() * 1000UL;
+            silence_microseconds = dlmstp_silence_microseconds();
+            if (silence_microseconds >= timeout_microseconds) {
+                run_master = true;
+                if (timeout_microseconds > 0) {
+                    dlmstp_timing_timeout(
+                        silence_microseconds - timeout_microseconds);
+                }
+            } else if (Precise_Timing) {
+                /* wake up when the timeout expires, unless an octet
+                   arrives before */
+                RS485_Timer_Arm(timeout_microseconds - silence_microseconds);
             }
         }
         if (run_master) {
@@ -560,11 +665,12 @@ void dlmstp_set_max_info_frames(uint8_t max_info_frames)
 
 /**
  * @brief Get the MSTP max-info-frames value
- * @return the MSTP max-info-frames value
+ * @return the MSTP max-info-frames value, which is the value chosen
+ *  by the adaptive tuning when it is enabled
  */
 uint8_t dlmstp_max_info_frames(void)
 {
-    return MSTP_Port.Nmax_info_frames;
+    return MSTP_Max_Info_Frames(&MSTP_Port);
 }
 
 /**
@@ -589,11 +695,12 @@ void dlmstp_set_max_master(uint8_t max_master)
 
 /**
  * @brief Get the largest peer MAC address that we will seek
- * @return largest peer MAC address
+ * @return largest peer MAC address, which is the value chosen
+ *  by the adaptive tuning when it is enabled
  */
 uint8_t dlmstp_max_master(void)
 {
-    return MSTP_Port.Nmax_master;
+    return MSTP_Max_Master(&MSTP_Port);
 }
 
 /**
@@ -720,6 +827,38 @@ bool dlmstp_check_auto_baud_set(bool flag)
     return true;
 }
 
+/**
+ * @brief Get the MSTP port AdaptiveEnabled status
+ * @return true if the MSTP port has AdaptiveEnabled
+ */
+bool dlmstp_adaptive_enabled(void)
+{
+    return MSTP_Port.AdaptiveEnabled;
+}
+
+/**
+ * @brief Set the MSTP port AdaptiveEnabled flag
+ * @param flag - true if the MSTP port has AdaptiveEnabled
+ * @return true if the MSTP port AdaptiveEnabled was set
+ * @note This flag is used to enable the adaptive tuning of the MSTP port.
+ *  The max-info-frames value set for the port is raised, up to the number
+ *  of PDUs in the transmit queue, while the queue keeps the node busy for
+ *  its whole token. The Poll For Master sweeps stop at the highest master
+ *  node on the network, and go up to the max-master value set for the port
+ *  every MSTP_ADAPTIVE_SWEEPS sweeps to find new master nodes.
+ */
+bool dlmstp_adaptive_enabled_set(bool flag)
+{
+    MSTP_Port.AdaptiveEnabled = flag;
+    MSTP_Port.Adaptive_Max_Info_Frames = MSTP_PDU_PACKET_COUNT;
+    MSTP_Port.Adaptive_Info_Frames = MSTP_Port.Nmax_info_frames;
+    MSTP_Port.Adaptive_Idle_Tokens = 0;
+    MSTP_Port.Adaptive_Max_Master_Seen = MSTP_Port.This_Station;
+    MSTP_Port.Adaptive_Sweep_Count = 0;
+
+    return true;
+}
+
 /**
  * @brief Get the MSTP port MAC address that this node prefers to use.
  * @return ZeroConfigStation value, or an out-of-range value if invalid
@@ -823,6 +962,53 @@ void dlmstp_fill_statistics(struct dlmstp_statistics *statistics)
     memmove(statistics, &DLMSTP_Statistics, sizeof(struct dlmstp_statistics));
 }
 
+/**
+ * @brief Enable the precise timing of the MS/TP thread, which uses the
+ *  raw monotonic clock for the silence, a timerfd to wake up at the next
+ *  timeout, the low latency mode of the serial port, and locked memory.
+ * @param enable - true to enable the precise timing at dlmstp_init()
+ * @param cpu - CPU to pin the MS/TP thread to, or -1 for any CPU
+ */
+void dlmstp_precise_timing_set(bool enable, int cpu)
+{
+    Precise_Timing = enable;
+    Precise_Timing_CPU = cpu;
+}
+
+/**
+ * @brief Determine if the precise timing of the MS/TP thread is enabled
+ * @return true if enabled
+ */
+bool dlmstp_precise_timing(void)
+{
+    return Precise_Timing;
+}
+
+/**
+ * @brief Reset the timing statistics of the MS/TP thread
+ */
+void dlmstp_reset_timing_statistics(void)
+{
+    memset(&DLMSTP_Timing_Statistics, 0, sizeof(DLMSTP_Timing_Statistics));
+}
+
+/**
+ * @brief Copy the timing statistics of the MS/TP thread.  The turnaround
+ *  is only counted in the precise timing mode, and the lateness of the
+ *  timeouts is only measured to the millisecond without it.
+ * @param statistics - timing statistics
+ */
+void dlmstp_fill_timing_statistics(
+    struct dlmstp_timing_statistics *statistics)
+{
+    if (statistics == NULL) {
+        return;
+    }
+    memmove(
+        statistics, &DLMSTP_Timing_Statistics,
+        sizeof(struct dlmstp_timing_statistics));
+}
+
 /**
  * @brief Get the MSTP port Max-Info-Frames limit
  * @return Max-Info-Frames limit
@@ -849,6 +1035,9 @@ uint8_t dlmstp_max_master_limit(void)
 uint32_t dlmstp_silence_milliseconds(void *arg)
 {
     (void)arg;
+    if (Precise_Timing) {
+        return dlmstp_silence_microseconds() / 1000UL;
+    }
     return mstimer_elapsed(&Silence_Timer);
 }
 
@@ -882,6 +1071,9 @@ void dlmstp_silence_reset(void *arg)
 {
     (void)arg;
     mstimer_set(&Silence_Timer, 0);
+    if (Precise_Timing) {
+        clock_gettime(CLOCK_MONOTONIC_RAW, &Silence_Start);
+    }
 }
 
 /**
@@ -914,7 +1106,8 @@ bool dlmstp_init(char *ifname)
 {
     pthread_attr_t thread_attr;
     struct sched_param sch_param;
-    pthread_condattr_t attr;
+    cpu_set_t cpu_set;
+    const char *pEnv;
     int rv = 0;
 
     if (DLMSTP_Initialized) {
@@ -928,15 +1121,7 @@ bool dlmstp_init(char *ifname)
     } else {
         ifname = (char *)RS485_Interface();
     }
-    pthread_condattr_init(&attr);
-    if ((rv = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC)) != 0) {
-        fprintf(
-            stderr, "MS/TP Interface: %s\n failed to set MONOTONIC clock\n",
-            ifname);
-        exit(1);
-    }
-    pthread_mutex_init(&Thread_Mutex, NULL);
-    rv = pthread_mutex_init(&Ring_Buffer_Mutex, NULL);
+    rv = pthread_mutex_init(&Thread_Mutex, NULL);
     if (rv != 0) {
         fprintf(
             stderr, "MS/TP Interface: %s\n cannot allocate PThread Mutex.\n",
@@ -951,24 +1136,32 @@ bool dlmstp_init(char *ifname)
     Ringbuf_Init(
         &Receive_Queue, (uint8_t *)&Receive_Buffer, sizeof(DLMSTP_PACKET),
         MSTP_RECEIVE_PACKET_COUNT);
-    rv = pthread_cond_init(&Receive_Packet_Flag, &attr);
-    if (rv != 0) {
+    Receive_Packet_Event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (Receive_Packet_Event < 0) {
         fprintf(
-            stderr,
-            "MS/TP Interface: %s\n cannot allocate PThread Condition.\n",
-            ifname);
-        exit(1);
-    }
-    rv = pthread_mutex_init(&Receive_Packet_Mutex, NULL);
-    if (rv != 0) {
-        fprintf(
-            stderr, "MS/TP Interface: %s\n cannot allocate PThread Mutex.\n",
+            stderr, "MS/TP Interface: %s\n cannot allocate an eventfd.\n",
             ifname);
         exit(1);
     }
     clock_gettime(CLOCK_MONOTONIC, &Clock_Get_Time_Start);
+    pEnv = getenv("BACNET_MSTP_PRECISE");
+    if (pEnv) {
+        Precise_Timing = strtol(pEnv, NULL, 0) != 0;
+    }
+    pEnv = getenv("BACNET_MSTP_CPU");
+    if (pEnv) {
+        Precise_Timing_CPU = strtol(pEnv, NULL, 0);
+    }
+    if (Precise_Timing) {
+        /* no page faults in the MS/TP thread */
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            debug_fprintf(stderr, "MS/TP: cannot lock the memory.\n");
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &Silence_Start);
+    }
     /* initialize hardware */
     mstimer_set(&Silence_Timer, 0);
+    RS485_Precise_Timing_Set(Precise_Timing);
     RS485_Initialize();
     MSTP_Port.InputBuffer = &RxBuffer[0];
     MSTP_Port.InputBufferSize = sizeof(RxBuffer);
@@ -1057,6 +1250,16 @@ bool dlmstp_init(char *ifname)
             ifname);
         exit(1);
     }
+    if (Precise_Timing && (Precise_Timing_CPU >= 0)) {
+        CPU_ZERO(&cpu_set);
+        CPU_SET(Precise_Timing_CPU, &cpu_set);
+        rv = pthread_setaffinity_np(hThread, sizeof(cpu_set), &cpu_set);
+        if (rv != 0) {
+            fprintf(
+                stderr, "MS/TP Interface: %s\n cannot pin thread to CPU %d.\n",
+                ifname, Precise_Timing_CPU);
+        }
+    }
 
     return true;
 }
@@ -72,6 +72,22 @@ static void Timer_Silence_Reset(void *poPort)
     gettimeofday(&poSharedData->start, NULL);
 }
 
+/**
+ * @brief Determine if the state machine thread of a port should run
+ * @param poSharedData - port specific data
+ * @return true if the thread should keep running
+ */
+static bool dlmstp_thread_run(SHARED_MSTP_DATA *poSharedData)
+{
+    bool status;
+
+    pthread_mutex_lock(&poSharedData->Thread_Mutex);
+    status = poSharedData->Thread_Run;
+    pthread_mutex_unlock(&poSharedData->Thread_Mutex);
+
+    return status;
+}
+
 static void get_abstime(struct timespec *abstime, unsigned long milliseconds)
 {
     struct timeval now, offset, result;
@@ -95,7 +111,16 @@ void dlmstp_cleanup(void *poPort)
     if (!poSharedData) {
         return;
     }
-
+    /* stop the state machines before the port is closed under them */
+    pthread_mutex_lock(&poSharedData->Thread_Mutex);
+    if (poSharedData->Thread_Run) {
+        poSharedData->Thread_Run = false;
+        pthread_mutex_unlock(&poSharedData->Thread_Mutex);
+        pthread_join(poSharedData->Thread, NULL);
+    } else {
+        pthread_mutex_unlock(&poSharedData->Thread_Mutex);
+    }
+    pthread_mutex_destroy(&poSharedData->Thread_Mutex);
     /* restore the old port settings */
     termios2_tcsetattr(
         poSharedData->RS485_Handle, TCSANOW, &poSharedData->RS485_oldtio2);
@@ -207,7 +232,7 @@ static void *dlmstp_receive_fsm_task(void *pArg)
         return NULL;
     }
 
-    for (;;) {
+    while (dlmstp_thread_run(poSharedData)) {
         /* only do receive state machine while we don't have a frame */
         if ((mstp_port->ReceivedValidFrame == false) &&
             (mstp_port->ReceivedValidFrameNotForUs == false) &&
@@ -245,7 +270,8 @@ static void *dlmstp_master_fsm_task(void *pArg)
         return NULL;
     }
 
-    for (;;) {
+    while (dlmstp_thread_run(poSharedData)) {
+        run_master = false;
         if (mstp_port->ReceivedValidFrame == false &&
             mstp_port->ReceivedValidFrameNotForUs == false &&
             mstp_port->ReceivedInvalidFrame == false) {
@@ -256,7 +282,7 @@ static void *dlmstp_master_fsm_task(void *pArg)
             mstp_port->ReceivedValidFrameNotForUs) {
             run_master = true;
         } else {
-            silence = mstp_port->SilenceTimer(NULL);
+            silence = mstp_port->SilenceTimer(mstp_port);
             switch (mstp_port->master_state) {
                 case MSTP_MASTER_STATE_IDLE:
                     if (silence >= Tno_token) {
@@ -636,7 +662,8 @@ void dlmstp_get_broadcast_address(BACNET_ADDRESS *dest)
 
 bool dlmstp_init(void *poPort, char *ifname)
 {
-    unsigned long hThread = 0;
+    pthread_attr_t thread_attr;
+    struct sched_param sch_param;
     int rv = 0;
     SHARED_MSTP_DATA *poSharedData;
     struct termios2 newtio;
@@ -665,8 +692,20 @@ bool dlmstp_init(void *poPort, char *ifname)
             stderr,
             "MS/TP Interface: %s\n cannot allocate PThread Condition.\n",
             ifname);
-        exit(1);
+        return false;
     }
+    pthread_cond_init(&poSharedData->Received_Frame_Flag, NULL);
+    pthread_mutex_init(&poSharedData->Received_Frame_Mutex, NULL);
+    pthread_cond_init(&poSharedData->Master_Done_Flag, NULL);
+    pthread_mutex_init(&poSharedData->Master_Done_Mutex, NULL);
+    rv = pthread_mutex_init(&poSharedData->Thread_Mutex, NULL);
+    if (rv != 0) {
+        fprintf(
+            stderr, "MS/TP Interface: %s\n cannot allocate PThread Mutex.\n",
+            ifname);
+        return false;
+    }
+    poSharedData->Thread_Run = false;
 
     printf("RS485: Initializing %s", poSharedData->RS485_Port_Name);
     /*
@@ -678,7 +717,7 @@ bool dlmstp_init(void *poPort, char *ifname)
         O_RDWR | O_NOCTTY | O_NONBLOCK /*| O_NDELAY */);
     if (poSharedData->RS485_Handle < 0) {
         perror(poSharedData->RS485_Port_Name);
-        exit(-1);
+        return false;
     }
 #if 0
     /* non blocking for the read */
@@ -732,9 +771,32 @@ bool dlmstp_init(void *poPort, char *ifname)
     debug_fprintf(stderr, "MS/TP Max_Master: %02X\n", mstp_port->Nmax_master);
     debug_fprintf(
         stderr, "MS/TP Max_Info_Frames: %u\n", mstp_port->Nmax_info_frames);
-    rv = pthread_create(&hThread, NULL, dlmstp_master_fsm_task, mstp_port);
+    /* each port gets its own real-time thread, so that the timing of
+       one trunk does not depend on the traffic of the others */
+    pthread_attr_init(&thread_attr);
+    pthread_attr_setinheritsched(&thread_attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&thread_attr, SCHED_FIFO);
+    sch_param.sched_priority = 99;
+    pthread_attr_setschedparam(&thread_attr, &sch_param);
+    poSharedData->Thread_Run = true;
+    rv = pthread_create(
+        &poSharedData->Thread, &thread_attr, dlmstp_master_fsm_task,
+        mstp_port);
+    if (rv == EPERM) {
+        fprintf(
+            stdout,
+            "MS/TP Interface: %s\n"
+            "  Insufficient permissions to create thread with priority.\n"
+            "    A thread without priority will be created.\n",
+            ifname);
+        rv = pthread_create(
+            &poSharedData->Thread, NULL, dlmstp_master_fsm_task, mstp_port);
+    }
+    pthread_attr_destroy(&thread_attr);
     if (rv != 0) {
+        poSharedData->Thread_Run = false;
         fprintf(stderr, "Failed to start Master Node FSM task\n");
+        return false;
     }
 
     /* You can try also this for thread. This here so we ignore
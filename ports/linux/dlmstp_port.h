@@ -69,6 +69,11 @@ typedef struct shared_mstp_data {
     pthread_mutex_t Received_Frame_Mutex;
     pthread_cond_t Master_Done_Flag;
     pthread_mutex_t Master_Done_Mutex;
+    /* the real-time thread that runs the state machines of this port,
+       until Thread_Run is cleared by dlmstp_cleanup() */
+    pthread_t Thread;
+    pthread_mutex_t Thread_Mutex;
+    bool Thread_Run;
     /* buffers needed by mstp port struct */
     uint8_t TxBuffer[DLMSTP_MPDU_MAX];
     uint8_t RxBuffer[DLMSTP_MPDU_MAX];
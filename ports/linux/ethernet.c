@@ -9,13 +9,40 @@
 #include <stdbool.h> /* for the standard bool type. */
 
 #include "bacport.h"
+#include <poll.h>
+#include <sys/mman.h>
+#include <linux/filter.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/datalink/ethernet.h"
 #include "bacnet/bacint.h"
+#include "bacnet/basic/sys/perfstat.h"
 
 /** @file linux/ethernet.c  Provides Linux-specific functions for
  * BACnet/Ethernet. */
 
+/* Receive from a TPACKET_V3 ring buffer that is shared with the kernel,
+   which fills whole blocks of frames before waking us up, instead of
+   one read() per frame.  Falls back to the 802.2 socket if the ring
+   is not available. */
+#if !defined(ETHERNET_PACKET_RING) && defined(TPACKET3_HDRLEN)
+#define ETHERNET_PACKET_RING 1
+#endif
+#ifndef ETHERNET_PACKET_RING
+#define ETHERNET_PACKET_RING 0
+#endif
+/* size of each block of the ring, a multiple of the page size */
+#ifndef ETHERNET_RING_BLOCK_SIZE
+#define ETHERNET_RING_BLOCK_SIZE (1UL << 16)
+#endif
+/* number of blocks in the ring */
+#ifndef ETHERNET_RING_BLOCK_COUNT
+#define ETHERNET_RING_BLOCK_COUNT 8
+#endif
+/* milliseconds until a block that is not full is given to us */
+#ifndef ETHERNET_RING_TIMEOUT
+#define ETHERNET_RING_TIMEOUT 10
+#endif
+
 /* commonly used comparison address for ethernet */
 uint8_t Ethernet_Broadcast[MAX_MAC_LEN] = {
     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
@@ -28,18 +55,59 @@ uint8_t Ethernet_MAC_Address[MAX_MAC_LEN] = { 0 };
 
 static int eth802_sockfd = -1; /* 802.2 file handle */
 static struct sockaddr eth_addr = { 0 }; /* used for binding 802.2 */
+#if ETHERNET_PACKET_RING
+/* used for sending when the packet ring is used */
+static struct sockaddr_ll eth_ll_addr = { 0 };
+static uint8_t *Ethernet_Ring;
+static unsigned Ethernet_Ring_Block;
+static struct tpacket3_hdr *Ethernet_Ring_Packet;
+static uint32_t Ethernet_Ring_Packet_Count;
+#endif
+
+/* The kernel only passes 802.3 frames with the BACnet LLC header
+   (DSAP 0x82, SSAP 0x82) to our socket, and only wakes us for them. */
+static struct sock_filter Ethernet_Filter[] = {
+    /* length field, which is a type field above 1500 */
+    BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12),
+    BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K, 1500, 2, 0),
+    /* DSAP and SSAP */
+    BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 14),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x8282, 1, 0),
+    BPF_STMT(BPF_RET | BPF_K, 0),
+    BPF_STMT(BPF_RET | BPF_K, 0xFFFF),
+};
 
 bool ethernet_valid(void)
 {
     return (eth802_sockfd >= 0);
 }
 
+/**
+ * @brief Get the 802.2 socket, for use with an event loop
+ * @return the 802.2 socket, or -1 if not initialized
+ */
+int ethernet_get_socket(void)
+{
+    return eth802_sockfd;
+}
+
 void ethernet_cleanup(void)
 {
     if (ethernet_valid()) {
         close(eth802_sockfd);
     }
     eth802_sockfd = -1;
+#if ETHERNET_PACKET_RING
+    if (Ethernet_Ring) {
+        munmap(
+            Ethernet_Ring,
+            ETHERNET_RING_BLOCK_SIZE * ETHERNET_RING_BLOCK_COUNT);
+    }
+    Ethernet_Ring = NULL;
+    Ethernet_Ring_Block = 0;
+    Ethernet_Ring_Packet = NULL;
+    Ethernet_Ring_Packet_Count = 0;
+#endif
 
     return;
 }
@@ -65,6 +133,92 @@ int setNonblocking(
 }
 #endif
 
+/**
+ * @brief Attach the BACnet LLC filter to a socket
+ * @param sock_fd - socket to filter
+ * @return true if the filter was attached
+ */
+static bool ethernet_filter_attach(int sock_fd)
+{
+    struct sock_fprog filter = { 0 };
+
+    filter.len = sizeof(Ethernet_Filter) / sizeof(Ethernet_Filter[0]);
+    filter.filter = Ethernet_Filter;
+
+    return setsockopt(
+               sock_fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter,
+               sizeof(filter)) == 0;
+}
+
+#if ETHERNET_PACKET_RING
+/**
+ * @brief Open a packet socket with a TPACKET_V3 receive ring
+ * @param interface_name - the interface to bind
+ * @return the socket, or -1 if the ring is not available
+ */
+static int ethernet_ring_bind(const char *interface_name)
+{
+    struct tpacket_req3 req = { 0 };
+    int version = TPACKET_V3;
+    unsigned ifindex;
+    size_t ring_size;
+    void *ring;
+    int sock_fd;
+
+    ifindex = if_nametoindex(interface_name);
+    if (ifindex == 0) {
+        return -1;
+    }
+    sock_fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_802_2));
+    if (sock_fd < 0) {
+        return -1;
+    }
+    ring_size = ETHERNET_RING_BLOCK_SIZE * ETHERNET_RING_BLOCK_COUNT;
+    req.tp_block_size = ETHERNET_RING_BLOCK_SIZE;
+    req.tp_block_nr = ETHERNET_RING_BLOCK_COUNT;
+    req.tp_frame_size = TPACKET_ALIGN(
+        TPACKET3_HDRLEN + sizeof(struct sockaddr_ll) + ETHERNET_MPDU_MAX);
+    req.tp_frame_nr = (ETHERNET_RING_BLOCK_SIZE / req.tp_frame_size) *
+        ETHERNET_RING_BLOCK_COUNT;
+    req.tp_retire_blk_tov = ETHERNET_RING_TIMEOUT;
+    if (!ethernet_filter_attach(sock_fd) ||
+        (setsockopt(
+             sock_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) !=
+         0) ||
+        (setsockopt(sock_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) !=
+         0)) {
+        close(sock_fd);
+        return -1;
+    }
+    ring = mmap(
+        NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, sock_fd, 0);
+    if (ring == MAP_FAILED) {
+        close(sock_fd);
+        return -1;
+    }
+    eth_ll_addr.sll_family = AF_PACKET;
+    eth_ll_addr.sll_protocol = htons(ETH_P_802_2);
+    eth_ll_addr.sll_ifindex = (int)ifindex;
+    eth_ll_addr.sll_halen = 6;
+    if (bind(sock_fd, (struct sockaddr *)&eth_ll_addr, sizeof(eth_ll_addr)) !=
+        0) {
+        munmap(ring, ring_size);
+        close(sock_fd);
+        return -1;
+    }
+    Ethernet_Ring = ring;
+    Ethernet_Ring_Block = 0;
+    Ethernet_Ring_Packet = NULL;
+    Ethernet_Ring_Packet_Count = 0;
+    fprintf(
+        stderr, "ethernet: receiving \"%s\" with a packet ring\n",
+        interface_name);
+    atexit(ethernet_cleanup);
+
+    return sock_fd;
+}
+#endif
+
 /* opens an 802.2 socket to receive and send packets */
 static int ethernet_bind(struct sockaddr *eth_addr, const char *interface_name)
 {
@@ -141,6 +295,7 @@ static int ethernet_bind(struct sockaddr *eth_addr, const char *interface_name)
         close(sock_fd);
         exit(-1);
     }
+    (void)ethernet_filter_attach(sock_fd);
 
     atexit(ethernet_cleanup);
 
@@ -171,25 +326,50 @@ static int get_local_hwaddr(const char *ifname, unsigned char *mac)
 
 bool ethernet_init(char *interface_name)
 {
+    const char *ifname = "eth0";
+
     if (interface_name) {
-        get_local_hwaddr(interface_name, Ethernet_MAC_Address);
-        eth802_sockfd = ethernet_bind(&eth_addr, interface_name);
-    } else {
-        get_local_hwaddr("eth0", Ethernet_MAC_Address);
-        eth802_sockfd = ethernet_bind(&eth_addr, "eth0");
+        ifname = interface_name;
     }
+    get_local_hwaddr(ifname, Ethernet_MAC_Address);
+#if ETHERNET_PACKET_RING
+    eth802_sockfd = ethernet_ring_bind(ifname);
+    if (eth802_sockfd >= 0) {
+        return true;
+    }
+#endif
+    eth802_sockfd = ethernet_bind(&eth_addr, ifname);
 
     return ethernet_valid();
 }
 
+/**
+ * @brief Send a frame with the socket that is open
+ * @param mtu - the frame, starting with the destination MAC address
+ * @param mtu_len - number of bytes in the frame
+ * @return number of bytes sent, or -1 on error
+ */
+static int ethernet_sendto(const uint8_t *mtu, int mtu_len)
+{
+#if ETHERNET_PACKET_RING
+    if (Ethernet_Ring) {
+        memcpy(eth_ll_addr.sll_addr, mtu, 6);
+        return sendto(
+            eth802_sockfd, mtu, mtu_len, 0, (struct sockaddr *)&eth_ll_addr,
+            sizeof(eth_ll_addr));
+    }
+#endif
+    return sendto(
+        eth802_sockfd, mtu, mtu_len, 0, (struct sockaddr *)&eth_addr,
+        sizeof(struct sockaddr));
+}
+
 int ethernet_send(uint8_t *mtu, int mtu_len)
 {
     int bytes = 0;
 
     /* Send the packet */
-    bytes = sendto(
-        eth802_sockfd, &mtu, mtu_len, 0, (struct sockaddr *)&eth_addr,
-        sizeof(struct sockaddr));
+    bytes = ethernet_sendto(mtu, mtu_len);
     /* did it get sent? */
     if (bytes < 0) {
         fprintf(
@@ -259,18 +439,148 @@ int ethernet_send_pdu(
     encode_unsigned16(&mtu[12], 3 + pdu_len);
 
     /* Send the packet */
-    bytes = sendto(
-        eth802_sockfd, &mtu, mtu_len, 0, (struct sockaddr *)&eth_addr,
-        sizeof(struct sockaddr));
+    bytes = ethernet_sendto(mtu, mtu_len);
     /* did it get sent? */
     if (bytes < 0) {
         fprintf(
             stderr, "ethernet: Error sending packet: %s\n", strerror(errno));
+    } else {
+        PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_ETHERNET);
     }
 
     return bytes;
 }
 
+/**
+ * @brief Decode a received 802.2 frame
+ * @param buf - the frame, starting with the destination MAC address
+ * @param buf_len - number of bytes in the frame
+ * @param src - [out] source address
+ * @param pdu - [out] buffer for the PDU
+ * @param max_pdu - size of the PDU buffer
+ * @return the number of octets in the PDU, or zero if the frame is not
+ *  a BACnet frame for us
+ */
+static uint16_t ethernet_frame_decode(
+    const uint8_t *buf,
+    unsigned buf_len,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu)
+{
+    uint16_t pdu_len = 0; /* return value */
+
+    if (buf_len < 17) {
+        return 0;
+    }
+    /* the signature of an 802.2 BACnet packet */
+    if ((buf[14] != 0x82) && (buf[15] != 0x82)) {
+        /*fprintf(stderr,"ethernet: Non-BACnet packet\n"); */
+        return 0;
+    }
+    /* copy the source address */
+    src->mac_len = 6;
+    memmove(src->mac, &buf[6], 6);
+
+    /* check destination address for when */
+    /* the Ethernet card is in promiscious mode */
+    if ((memcmp(&buf[0], Ethernet_MAC_Address, 6) != 0) &&
+        (memcmp(&buf[0], Ethernet_Broadcast, 6) != 0)) {
+        /*fprintf(stderr, "ethernet: This packet isn't for us\n"); */
+        return 0;
+    }
+
+    (void)decode_unsigned16(&buf[12], &pdu_len);
+    if ((pdu_len < 3) || (pdu_len > (buf_len - 14))) {
+        return 0;
+    }
+    pdu_len -= 3 /* DSAP, SSAP, LLC Control */;
+    /* copy the buffer into the PDU */
+    if (pdu_len < max_pdu) {
+        memmove(&pdu[0], &buf[17], pdu_len);
+        PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_ETHERNET);
+    }
+    /* ignore packets that are too large */
+    else {
+        pdu_len = 0;
+    }
+
+    return pdu_len;
+}
+
+#if ETHERNET_PACKET_RING
+/**
+ * @brief Get a block of the packet ring
+ * @param index - zero based block number
+ * @return pointer to the block descriptor
+ */
+static struct tpacket_block_desc *ethernet_ring_block(unsigned index)
+{
+    return (struct tpacket_block_desc *)&Ethernet_Ring
+        [(size_t)index * ETHERNET_RING_BLOCK_SIZE];
+}
+
+/**
+ * @brief Receive the next BACnet frame from the packet ring.  The frames
+ *  of a block are decoded straight from the ring, and the block is
+ *  given back to the kernel after its last frame.
+ * @param src - [out] source address
+ * @param pdu - [out] buffer for the PDU
+ * @param max_pdu - size of the PDU buffer
+ * @param timeout - number of milliseconds to wait for a block
+ * @return the number of octets in the PDU, or zero if none
+ */
+static uint16_t ethernet_ring_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    struct tpacket_block_desc *block;
+    struct tpacket3_hdr *packet;
+    struct pollfd pfd = { 0 };
+    uint16_t pdu_len = 0;
+
+    while (pdu_len == 0) {
+        block = ethernet_ring_block(Ethernet_Ring_Block);
+        if (Ethernet_Ring_Packet_Count == 0) {
+            if (!(block->hdr.bh1.block_status & TP_STATUS_USER) &&
+                (timeout > 0)) {
+                pfd.fd = eth802_sockfd;
+                pfd.events = POLLIN | POLLERR;
+                (void)poll(&pfd, 1, (int)timeout);
+            }
+            timeout = 0;
+            if (!(block->hdr.bh1.block_status & TP_STATUS_USER)) {
+                return 0;
+            }
+            /* read the block only after its status */
+            __sync_synchronize();
+            Ethernet_Ring_Packet =
+                (struct tpacket3_hdr *)((uint8_t *)block +
+                                        block->hdr.bh1.offset_to_first_pkt);
+            Ethernet_Ring_Packet_Count = block->hdr.bh1.num_pkts;
+        }
+        if (Ethernet_Ring_Packet_Count > 0) {
+            packet = Ethernet_Ring_Packet;
+            pdu_len = ethernet_frame_decode(
+                (uint8_t *)packet + packet->tp_mac, packet->tp_snaplen, src,
+                pdu, max_pdu);
+            Ethernet_Ring_Packet =
+                (struct tpacket3_hdr *)((uint8_t *)packet +
+                                        packet->tp_next_offset);
+            Ethernet_Ring_Packet_Count--;
+        }
+        if (Ethernet_Ring_Packet_Count == 0) {
+            /* give the block back to the kernel */
+            __sync_synchronize();
+            block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+            Ethernet_Ring_Block =
+                (Ethernet_Ring_Block + 1) % ETHERNET_RING_BLOCK_COUNT;
+        }
+    }
+
+    return pdu_len;
+}
+#endif
+
 /* receives an 802.2 framed packet */
 /* returns the number of octets in the PDU, or zero on failure */
 uint16_t ethernet_receive(
@@ -281,7 +591,6 @@ uint16_t ethernet_receive(
 { /* number of milliseconds to wait for a packet */
     int received_bytes;
     uint8_t buf[ETHERNET_MPDU_MAX] = { 0 }; /* data */
-    uint16_t pdu_len = 0; /* return value */
     fd_set read_fds;
     int max;
     struct timeval select_timeout;
@@ -290,6 +599,11 @@ uint16_t ethernet_receive(
     if (eth802_sockfd <= 0) {
         return 0;
     }
+#if ETHERNET_PACKET_RING
+    if (Ethernet_Ring) {
+        return ethernet_ring_receive(src, pdu, max_pdu, timeout);
+    }
+#endif
 
     /* we could just use a non-blocking socket, but that consumes all
        the CPU time.  We can use a timeout; it is only supported as
@@ -329,35 +643,7 @@ uint16_t ethernet_receive(
         return 0;
     }
 
-    /* the signature of an 802.2 BACnet packet */
-    if ((buf[14] != 0x82) && (buf[15] != 0x82)) {
-        /*fprintf(stderr,"ethernet: Non-BACnet packet\n"); */
-        return 0;
-    }
-    /* copy the source address */
-    src->mac_len = 6;
-    memmove(src->mac, &buf[6], 6);
-
-    /* check destination address for when */
-    /* the Ethernet card is in promiscious mode */
-    if ((memcmp(&buf[0], Ethernet_MAC_Address, 6) != 0) &&
-        (memcmp(&buf[0], Ethernet_Broadcast, 6) != 0)) {
-        /*fprintf(stderr, "ethernet: This packet isn't for us\n"); */
-        return 0;
-    }
-
-    (void)decode_unsigned16(&buf[12], &pdu_len);
-    pdu_len -= 3 /* DSAP, SSAP, LLC Control */;
-    /* copy the buffer into the PDU */
-    if (pdu_len < max_pdu) {
-        memmove(&pdu[0], &buf[17], pdu_len);
-    }
-    /* ignore packets that are too large */
-    else {
-        pdu_len = 0;
-    }
-
-    return pdu_len;
+    return ethernet_frame_decode(buf, received_bytes, src, pdu, max_pdu);
 }
 
 void ethernet_set_my_address(const BACNET_ADDRESS *my_address)
@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @brief Event Log record storage in memory mapped files (Linux)
+ * @details The storage block of each Event Log is a file in a directory,
+ *  named for the routed device index and the object instance, that is
+ *  mapped shared into memory.  A new record is written in place in its
+ *  slot of the circular buffer, and the kernel writes the dirty pages
+ *  back to the file, so the event records are retained over a restart
+ *  of the application: the next Event_Log_Create() of the same object
+ *  maps the same file and carries on.  The file is removed when the
+ *  object is deleted.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/eventlog.h"
+#include "mmap-file.h"
+#include "eventlog-mmap.h"
+
+/* directory of the storage files */
+static char Storage_Directory[PATH_MAX];
+
+/**
+ * @brief Get the pathname of the storage file of a log
+ * @param pathname - [out] buffer for the pathname
+ * @param size - size of the buffer
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @return true if the pathname fits in the buffer
+ */
+static bool event_log_mmap_pathname(
+    char *pathname,
+    size_t size,
+    unsigned device_index,
+    uint32_t object_instance)
+{
+    int len;
+
+    len = snprintf(
+        pathname, size, "%s/eventlog-%u-%lu.dat", Storage_Directory,
+        device_index, (unsigned long)object_instance);
+
+    return (len > 0) && ((size_t)len < size);
+}
+
+/**
+ * @brief Map the storage file of a log, creating the file with the
+ *  size wanted if it is new or empty.  An existing file is mapped with
+ *  its own size, so that a log that was resized keeps its buffer size.
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param size - [in] the size wanted for a new file,
+ *  [out] the size of the mapped file
+ * @return the mapped file, or NULL on error
+ */
+uint8_t *event_log_mmap_open(
+    unsigned device_index, uint32_t object_instance, size_t *size)
+{
+    char pathname[PATH_MAX];
+
+    if (!event_log_mmap_pathname(
+            pathname, sizeof(pathname), device_index, object_instance)) {
+        return NULL;
+    }
+
+    return mmap_file_open(pathname, size);
+}
+
+/**
+ * @brief Unmap the storage file of a log, and remove the file if its
+ *  records are no longer wanted
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param storage - the mapped file
+ * @param size - the size of the mapped file
+ * @param purge - true to remove the file
+ */
+void event_log_mmap_close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge)
+{
+    char pathname[PATH_MAX];
+
+    if (!event_log_mmap_pathname(
+            pathname, sizeof(pathname), device_index, object_instance)) {
+        purge = false;
+    }
+    mmap_file_close(purge ? pathname : NULL, storage, size, purge);
+}
+
+/**
+ * @brief Keep the records of the Event Logs in files in a directory.
+ * @note Call before the Event Log objects are created.
+ * @param directory - directory of the storage files, which must exist
+ * @return true if the directory can be used
+ */
+bool event_log_mmap_init(const char *directory)
+{
+    int len;
+
+    if (!directory || (access(directory, R_OK | W_OK | X_OK) != 0)) {
+        return false;
+    }
+    len = snprintf(
+        Storage_Directory, sizeof(Storage_Directory), "%s", directory);
+    if ((len <= 0) || ((size_t)len >= sizeof(Storage_Directory))) {
+        Storage_Directory[0] = 0;
+        return false;
+    }
+    Event_Log_Storage_Callback_Set(event_log_mmap_open, event_log_mmap_close);
+
+    return true;
+}
+
+/**
+ * @brief Unmap the storage files, leaving the records in the files,
+ *  and go back to the default storage of the Event Logs
+ */
+void event_log_mmap_cleanup(void)
+{
+    Event_Log_Cleanup();
+    Event_Log_Storage_Callback_Set(NULL, NULL);
+    Storage_Directory[0] = 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @brief Storage blocks in memory mapped files (Linux)
+ * @details A storage block is a file that is mapped shared into memory.
+ *  The kernel writes the dirty pages back to the file, so what is
+ *  written in the block survives a restart of the application without
+ *  being read in or rebuilt.  Used by the storage of the log objects.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/debug.h"
+#include "mmap-file.h"
+
+/**
+ * @brief Map a file, creating the file with the size wanted if it is
+ *  new or empty.  An existing file is mapped with its own size.
+ * @param pathname - pathname of the file
+ * @param size - [in] the size wanted for a new file,
+ *  [out] the size of the mapped file
+ * @return the mapped file, or NULL on error
+ */
+uint8_t *mmap_file_open(const char *pathname, size_t *size)
+{
+    struct stat st = { 0 };
+    void *storage = NULL;
+    int fd;
+
+    fd = open(pathname, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        debug_perror("mmap-file: open");
+        return NULL;
+    }
+    if (fstat(fd, &st) == 0) {
+        if (st.st_size > 0) {
+            *size = (size_t)st.st_size;
+        } else if (ftruncate(fd, (off_t)*size) != 0) {
+            debug_perror("mmap-file: ftruncate");
+            *size = 0;
+        }
+        if (*size > 0) {
+            storage =
+                mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (storage == MAP_FAILED) {
+                debug_perror("mmap-file: mmap");
+                storage = NULL;
+            }
+        }
+    }
+    /* the mapping keeps the file */
+    close(fd);
+
+    return storage;
+}
+
+/**
+ * @brief Unmap a file, and remove the file if its contents are no
+ *  longer wanted
+ * @param pathname - pathname of the file
+ * @param storage - the mapped file
+ * @param size - the size of the mapped file
+ * @param purge - true to remove the file
+ */
+void mmap_file_close(
+    const char *pathname, uint8_t *storage, size_t size, bool purge)
+{
+    if (!purge) {
+        msync(storage, size, MS_ASYNC);
+    }
+    munmap(storage, size);
+    if (purge && pathname) {
+        if ((unlink(pathname) != 0) && (errno != ENOENT)) {
+            debug_perror("mmap-file: unlink");
+        }
+    }
+}
@@ -0,0 +1,28 @@
+/**
+ * @file
+ * @brief API for storage blocks in memory mapped files (Linux)
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#ifndef BACNET_PORT_LINUX_MMAP_FILE_H
+#define BACNET_PORT_LINUX_MMAP_FILE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+uint8_t *mmap_file_open(const char *pathname, size_t *size);
+BACNET_STACK_EXPORT
+void mmap_file_close(
+    const char *pathname, uint8_t *storage, size_t size, bool purge);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
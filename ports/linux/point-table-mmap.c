@@ -0,0 +1,177 @@
+/**
+ * @file
+ * @brief A point table shared in a memory mapped file (Linux)
+ * @details The point table is a file, such as one in /dev/shm, that is
+ *  mapped shared into the memory of the BACnet server and of the
+ *  processes that drive the field-bus I/O.  A driver writes the value
+ *  of each point into the table without a lock or a system call, and
+ *  the task of the server picks up the points that changed and writes
+ *  them into the Present_Value and Reliability of the bound objects, so
+ *  that COV and intrinsic reporting see them like any other change.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/basic/object/ai.h"
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/bi.h"
+#include "bacnet/basic/object/bv.h"
+#include "bacnet/basic/object/ms-input.h"
+#include "bacnet/basic/object/msv.h"
+#include "mmap-file.h"
+#include "point-table-mmap.h"
+
+/* the mapped point table */
+static char Point_Table_Pathname[PATH_MAX];
+static uint8_t *Point_Table_Storage;
+static size_t Point_Table_Storage_Size;
+static POINT_TABLE *Point_Table_Mapped;
+
+/**
+ * @brief Map the point table file, making a new table of unbound points
+ *  if the file is new or does not hold a table.  An existing table is
+ *  used with its own number of points, so that a driver that made the
+ *  table first keeps its bindings.
+ * @param pathname - pathname of the file, such as /dev/shm/bacnet-points
+ * @param count - number of points for a new table
+ * @return the point table, or NULL on error
+ */
+POINT_TABLE *point_table_mmap_init(const char *pathname, unsigned count)
+{
+    int len;
+
+    if (Point_Table_Mapped) {
+        point_table_mmap_cleanup(false);
+    }
+    if (!pathname) {
+        return NULL;
+    }
+    len = snprintf(
+        Point_Table_Pathname, sizeof(Point_Table_Pathname), "%s", pathname);
+    if ((len <= 0) || ((size_t)len >= sizeof(Point_Table_Pathname))) {
+        return NULL;
+    }
+    Point_Table_Storage_Size = Point_Table_Size(count);
+    Point_Table_Storage =
+        mmap_file_open(Point_Table_Pathname, &Point_Table_Storage_Size);
+    if (!Point_Table_Storage) {
+        return NULL;
+    }
+    Point_Table_Mapped =
+        Point_Table_Attach(Point_Table_Storage, Point_Table_Storage_Size);
+    if (!Point_Table_Mapped) {
+        Point_Table_Mapped = Point_Table_Format(
+            Point_Table_Storage, Point_Table_Storage_Size, count);
+    }
+    if (!Point_Table_Mapped) {
+        mmap_file_close(
+            Point_Table_Pathname, Point_Table_Storage,
+            Point_Table_Storage_Size, false);
+        Point_Table_Storage = NULL;
+    }
+
+    return Point_Table_Mapped;
+}
+
+/**
+ * @brief Unmap the point table file, and remove the file if the table
+ *  is no longer wanted by any process
+ * @param purge - true to remove the file
+ */
+void point_table_mmap_cleanup(bool purge)
+{
+    if (Point_Table_Storage) {
+        mmap_file_close(
+            Point_Table_Pathname, Point_Table_Storage,
+            Point_Table_Storage_Size, purge);
+    }
+    Point_Table_Storage = NULL;
+    Point_Table_Storage_Size = 0;
+    Point_Table_Mapped = NULL;
+}
+
+/**
+ * @brief Get the mapped point table
+ * @return the point table, or NULL if none is mapped
+ */
+POINT_TABLE *point_table_mmap(void)
+{
+    return Point_Table_Mapped;
+}
+
+/**
+ * @brief Write a changed point into its object
+ * @param object_type - the object type bound to the point
+ * @param object_instance - the object instance bound to the point
+ * @param value - the value of the point
+ * @param context - not used
+ */
+void point_table_mmap_object_update(
+    uint16_t object_type,
+    uint32_t object_instance,
+    const POINT_TABLE_VALUE *value,
+    void *context)
+{
+    BACNET_RELIABILITY reliability;
+    BACNET_BINARY_PV binary_value;
+    uint32_t state;
+
+    (void)context;
+    if (!value) {
+        return;
+    }
+    reliability = (BACNET_RELIABILITY)value->reliability;
+    binary_value = isgreater(fabs(value->value), 0.0) ? BINARY_ACTIVE
+                                                      : BINARY_INACTIVE;
+    state = (value->value > 0.0) ? (uint32_t)value->value : 0;
+    switch (object_type) {
+        case OBJECT_ANALOG_INPUT:
+            Analog_Input_Present_Value_Set(
+                object_instance, (float)value->value);
+            Analog_Input_Reliability_Set(object_instance, reliability);
+            break;
+        case OBJECT_ANALOG_VALUE:
+            Analog_Value_Present_Value_Set(
+                object_instance, (float)value->value, BACNET_MAX_PRIORITY);
+            Analog_Value_Reliability_Set(object_instance, reliability);
+            break;
+        case OBJECT_BINARY_INPUT:
+            Binary_Input_Present_Value_Set(object_instance, binary_value);
+            Binary_Input_Reliability_Set(object_instance, reliability);
+            break;
+        case OBJECT_BINARY_VALUE:
+            Binary_Value_Present_Value_Set(object_instance, binary_value);
+            Binary_Value_Reliability_Set(object_instance, reliability);
+            break;
+        case OBJECT_MULTI_STATE_INPUT:
+            Multistate_Input_Present_Value_Set(object_instance, state);
+            Multistate_Input_Reliability_Set(object_instance, reliability);
+            break;
+        case OBJECT_MULTI_STATE_VALUE:
+            Multistate_Value_Present_Value_Set(object_instance, state);
+            Multistate_Value_Reliability_Set(object_instance, reliability);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Pick up the points that changed since the last task, and write
+ *  them into their objects
+ * @return number of points that were picked up
+ */
+unsigned point_table_mmap_task(void)
+{
+    return Point_Table_Poll(
+        Point_Table_Mapped, point_table_mmap_object_update, NULL);
+}
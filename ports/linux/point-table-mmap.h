@@ -0,0 +1,40 @@
+/**
+ * @file
+ * @brief API for a point table shared in a memory mapped file (Linux)
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#ifndef BACNET_PORT_LINUX_POINT_TABLE_MMAP_H
+#define BACNET_PORT_LINUX_POINT_TABLE_MMAP_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/point_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+POINT_TABLE *point_table_mmap_init(const char *pathname, unsigned count);
+BACNET_STACK_EXPORT
+void point_table_mmap_cleanup(bool purge);
+BACNET_STACK_EXPORT
+POINT_TABLE *point_table_mmap(void);
+
+BACNET_STACK_EXPORT
+void point_table_mmap_object_update(
+    uint16_t object_type,
+    uint32_t object_instance,
+    const POINT_TABLE_VALUE *value,
+    void *context);
+BACNET_STACK_EXPORT
+unsigned point_table_mmap_task(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
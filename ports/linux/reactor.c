@@ -0,0 +1,516 @@
+/**
+ * @file
+ * @brief Linux event loop for datalink sockets, events, and timers
+ *
+ * One epoll file descriptor waits for every registered source, so an
+ * application gets a single wakeup for network packets, MS/TP frames
+ * passed up from the MS/TP thread, signals from other threads
+ * (eventfd), and periodic timers (timerfd), instead of polling each
+ * datalink with a receive timeout.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/datalink.h"
+#if defined(BACDL_BIP)
+#include "bip-workers.h"
+#endif
+#include "reactor.h"
+
+/* number of NPDUs received from the datalink before other events */
+#ifndef REACTOR_DATALINK_BATCH
+#define REACTOR_DATALINK_BATCH 16
+#endif
+/* maximum number of datalink file descriptors */
+#define REACTOR_DATALINK_FD_MAX 6
+
+typedef enum reactor_type {
+    REACTOR_TYPE_NONE = 0,
+    REACTOR_TYPE_FD,
+    REACTOR_TYPE_TIMER,
+    REACTOR_TYPE_EVENT
+} REACTOR_TYPE;
+
+struct reactor_entry {
+    int fd;
+    REACTOR_TYPE type;
+    reactor_callback callback;
+    void *context;
+};
+static struct reactor_entry Reactor_List[REACTOR_MAX_ENTRIES];
+static int Reactor_Epoll = -1;
+/* event used by reactor_stop() to wake up reactor_run() */
+static int Reactor_Stop_Event = -1;
+static bool Reactor_Running;
+/* the datalink NPDUs are received into */
+static struct reactor_datalink {
+    uint8_t *pdu;
+    uint16_t max_pdu;
+    datalink_receive_handler handler;
+    BACNET_ADDRESS src;
+    int event;
+    int fd[REACTOR_DATALINK_FD_MAX];
+    unsigned fd_count;
+} Reactor_Datalink;
+
+/**
+ * @brief Find the entry for a file descriptor
+ * @param fd - file descriptor
+ * @return the entry, or NULL if not found
+ */
+static struct reactor_entry *reactor_entry_find(int fd)
+{
+    unsigned i;
+
+    if (fd < 0) {
+        return NULL;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if ((Reactor_List[i].type != REACTOR_TYPE_NONE) &&
+            (Reactor_List[i].fd == fd)) {
+            return &Reactor_List[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a file descriptor to the epoll set
+ * @param fd - file descriptor
+ * @param type - type of file descriptor
+ * @param callback - function called when the file descriptor is readable
+ * @param context - passed to the callback
+ * @return true if added
+ */
+static bool reactor_entry_add(
+    int fd, REACTOR_TYPE type, reactor_callback callback, void *context)
+{
+    struct epoll_event event = { 0 };
+    unsigned i;
+
+    if ((Reactor_Epoll < 0) || (fd < 0) || !callback) {
+        return false;
+    }
+    if (reactor_entry_find(fd)) {
+        return false;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if (Reactor_List[i].type == REACTOR_TYPE_NONE) {
+            break;
+        }
+    }
+    if (i == REACTOR_MAX_ENTRIES) {
+        return false;
+    }
+    /* the entry index and file descriptor, so that an event for an
+       entry that was removed during the same wait is ignored */
+    event.events = EPOLLIN;
+    event.data.u64 = ((uint64_t)(uint32_t)fd << 32) | i;
+    if (epoll_ctl(Reactor_Epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+        return false;
+    }
+    Reactor_List[i].fd = fd;
+    Reactor_List[i].type = type;
+    Reactor_List[i].callback = callback;
+    Reactor_List[i].context = context;
+
+    return true;
+}
+
+/**
+ * @brief Remove an entry from the epoll set
+ * @param entry - the entry to remove
+ */
+static void reactor_entry_remove(struct reactor_entry *entry)
+{
+    (void)epoll_ctl(Reactor_Epoll, EPOLL_CTL_DEL, entry->fd, NULL);
+    entry->fd = -1;
+    entry->type = REACTOR_TYPE_NONE;
+    entry->callback = NULL;
+    entry->context = NULL;
+}
+
+/**
+ * @brief The reactor_stop() event was signaled
+ * @param fd - the event
+ * @param context - not used
+ */
+static void reactor_stop_handler(int fd, void *context)
+{
+    (void)fd;
+    (void)context;
+    Reactor_Running = false;
+}
+
+/**
+ * @brief Initialize the event loop
+ * @return true if the event loop is ready
+ */
+bool reactor_init(void)
+{
+    unsigned i;
+
+    if (Reactor_Epoll >= 0) {
+        return true;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        Reactor_List[i].fd = -1;
+        Reactor_List[i].type = REACTOR_TYPE_NONE;
+        Reactor_List[i].callback = NULL;
+        Reactor_List[i].context = NULL;
+    }
+    Reactor_Datalink.event = -1;
+    Reactor_Epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (Reactor_Epoll < 0) {
+        return false;
+    }
+    Reactor_Stop_Event = reactor_event_add(reactor_stop_handler, NULL);
+    if (Reactor_Stop_Event < 0) {
+        reactor_cleanup();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove everything from the event loop, and close the timers
+ *  and events that it created
+ */
+void reactor_cleanup(void)
+{
+    unsigned i;
+    int fd;
+
+    if (Reactor_Epoll < 0) {
+        return;
+    }
+    reactor_datalink_remove();
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if (Reactor_List[i].type != REACTOR_TYPE_NONE) {
+            reactor_close(Reactor_List[i].fd);
+        }
+    }
+    Reactor_Stop_Event = -1;
+    Reactor_Running = false;
+    fd = Reactor_Epoll;
+    Reactor_Epoll = -1;
+    close(fd);
+}
+
+/**
+ * @brief Add a file descriptor, such as a datalink socket, that calls
+ *  back when it is readable
+ * @param fd - file descriptor, which is still owned by the caller
+ * @param callback - function called when the file descriptor is readable
+ * @param context - passed to the callback
+ * @return true if added
+ */
+bool reactor_fd_add(int fd, reactor_callback callback, void *context)
+{
+    return reactor_entry_add(fd, REACTOR_TYPE_FD, callback, context);
+}
+
+/**
+ * @brief Remove a file descriptor without closing it
+ * @param fd - file descriptor
+ * @return true if removed
+ */
+bool reactor_fd_remove(int fd)
+{
+    struct reactor_entry *entry;
+
+    entry = reactor_entry_find(fd);
+    if (!entry) {
+        return false;
+    }
+    reactor_entry_remove(entry);
+
+    return true;
+}
+
+/**
+ * @brief Add a periodic timer
+ * @param milliseconds - interval between callbacks, greater than zero
+ * @param callback - function called each time the timer expires
+ * @param context - passed to the callback
+ * @return the timer file descriptor, or -1 on error
+ */
+int reactor_timer_add(
+    unsigned long milliseconds, reactor_callback callback, void *context)
+{
+    struct itimerspec spec = { 0 };
+    int fd;
+
+    if ((Reactor_Epoll < 0) || (milliseconds == 0) || !callback) {
+        return -1;
+    }
+    fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    spec.it_interval.tv_sec = milliseconds / 1000;
+    spec.it_interval.tv_nsec = (milliseconds % 1000) * 1000000L;
+    spec.it_value = spec.it_interval;
+    if ((timerfd_settime(fd, 0, &spec, NULL) != 0) ||
+        !reactor_entry_add(fd, REACTOR_TYPE_TIMER, callback, context)) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+ * @brief Add an event that another thread, or a callback, can signal
+ *  with reactor_event_signal() to wake up the event loop
+ * @param callback - function called after the event is signaled
+ * @param context - passed to the callback
+ * @return the event file descriptor, or -1 on error
+ */
+int reactor_event_add(reactor_callback callback, void *context)
+{
+    int fd;
+
+    if ((Reactor_Epoll < 0) || !callback) {
+        return -1;
+    }
+    fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    if (!reactor_entry_add(fd, REACTOR_TYPE_EVENT, callback, context)) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+ * @brief Signal an event. Safe to call from any thread.
+ * @param fd - the event from reactor_event_add()
+ * @return true if signaled
+ */
+bool reactor_event_signal(int fd)
+{
+    if (fd < 0) {
+        return false;
+    }
+
+    return (eventfd_write(fd, 1) == 0);
+}
+
+/**
+ * @brief Remove a file descriptor, and close it if it is a timer or
+ *  an event that was created by the event loop
+ * @param fd - file descriptor
+ */
+void reactor_close(int fd)
+{
+    struct reactor_entry *entry;
+    bool owned;
+
+    entry = reactor_entry_find(fd);
+    if (!entry) {
+        return;
+    }
+    owned = (entry->type == REACTOR_TYPE_TIMER) ||
+        (entry->type == REACTOR_TYPE_EVENT);
+    reactor_entry_remove(entry);
+    if (owned) {
+        close(fd);
+    }
+}
+
+/**
+ * @brief Wait for the file descriptors, timers, and events, and call
+ *  back for each one that is ready
+ * @param timeout - milliseconds to wait, or -1 to wait forever
+ * @return number of callbacks, or -1 on error
+ */
+int reactor_run_once(int timeout)
+{
+    struct epoll_event events[REACTOR_MAX_ENTRIES];
+    struct reactor_entry *entry;
+    uint64_t value;
+    unsigned index;
+    int count = 0;
+    int fd;
+    int n, i;
+
+    if (Reactor_Epoll < 0) {
+        return -1;
+    }
+    n = epoll_wait(Reactor_Epoll, events, REACTOR_MAX_ENTRIES, timeout);
+    if (n < 0) {
+        return (errno == EINTR) ? 0 : -1;
+    }
+    for (i = 0; i < n; i++) {
+        index = (unsigned)(events[i].data.u64 & 0xFFFFFFFFUL);
+        fd = (int)(events[i].data.u64 >> 32);
+        if (index >= REACTOR_MAX_ENTRIES) {
+            continue;
+        }
+        entry = &Reactor_List[index];
+        if ((entry->type == REACTOR_TYPE_NONE) || (entry->fd != fd)) {
+            /* removed by an earlier callback */
+            continue;
+        }
+        if ((entry->type == REACTOR_TYPE_TIMER) ||
+            (entry->type == REACTOR_TYPE_EVENT)) {
+            /* clear the expirations or signals before the callback,
+               so that any that happen during the callback are kept */
+            if (read(fd, &value, sizeof(value)) < 0) {
+                value = 0;
+            }
+        }
+        entry->callback(fd, entry->context);
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Run the event loop until reactor_stop() is called
+ */
+void reactor_run(void)
+{
+    Reactor_Running = true;
+    while (Reactor_Running) {
+        if (reactor_run_once(-1) < 0) {
+            break;
+        }
+    }
+    Reactor_Running = false;
+}
+
+/**
+ * @brief Stop reactor_run(). Safe to call from any thread.
+ */
+void reactor_stop(void)
+{
+    (void)reactor_event_signal(Reactor_Stop_Event);
+}
+
+/**
+ * @brief Receive a batch of NPDUs from the datalink
+ * @param fd - the datalink file descriptor or event
+ * @param context - not used
+ */
+static void reactor_datalink_receive(int fd, void *context)
+{
+    unsigned count;
+
+    (void)fd;
+    (void)context;
+    count = datalink_receive_batch(
+        &Reactor_Datalink.src, Reactor_Datalink.pdu, Reactor_Datalink.max_pdu,
+        0, REACTOR_DATALINK_BATCH, Reactor_Datalink.handler);
+    if (count >= REACTOR_DATALINK_BATCH) {
+        /* more may be waiting in the datalink buffers, so come back
+           after the other file descriptors are handled */
+        (void)reactor_event_signal(Reactor_Datalink.event);
+    }
+}
+
+#if defined(BACDL_BIP) || defined(BACDL_BIP6) || defined(BACDL_ETHERNET) || \
+    defined(BACDL_ARCNET) || defined(BACDL_MSTP)
+/**
+ * @brief Add a datalink file descriptor, if it is open
+ * @param fd - datalink file descriptor, or -1
+ */
+static void reactor_datalink_fd_add(int fd)
+{
+    if ((fd < 0) || (Reactor_Datalink.fd_count >= REACTOR_DATALINK_FD_MAX)) {
+        return;
+    }
+    if (reactor_fd_add(fd, reactor_datalink_receive, NULL)) {
+        Reactor_Datalink.fd[Reactor_Datalink.fd_count] = fd;
+        Reactor_Datalink.fd_count++;
+    }
+}
+#endif
+
+/**
+ * @brief Add the file descriptors of the initialized datalinks, so that
+ *  each received NPDU is passed to the handler, such as npdu_handler().
+ *
+ * BACnet/IP, BACnet/IPv6, Ethernet, ARCNET, and MS/TP are supported.
+ * The datalink must be initialized first.
+ *
+ * @param pdu - buffer for each received NPDU
+ * @param max_pdu - size of the buffer
+ * @param handler - function called with each NPDU
+ * @return true if added
+ */
+bool reactor_datalink_add(
+    uint8_t *pdu, uint16_t max_pdu, datalink_receive_handler handler)
+{
+    if ((Reactor_Epoll < 0) || !pdu || !handler) {
+        return false;
+    }
+    reactor_datalink_remove();
+    Reactor_Datalink.pdu = pdu;
+    Reactor_Datalink.max_pdu = max_pdu;
+    Reactor_Datalink.handler = handler;
+    Reactor_Datalink.event = reactor_event_add(reactor_datalink_receive, NULL);
+    if (Reactor_Datalink.event < 0) {
+        return false;
+    }
+#if defined(BACDL_BIP)
+    reactor_datalink_fd_add(bip_get_socket());
+    if (bip_get_broadcast_socket() != bip_get_socket()) {
+        reactor_datalink_fd_add(bip_get_broadcast_socket());
+    }
+    /* datagrams handed back by the BACnet/IP worker threads */
+    reactor_datalink_fd_add(bip_get_handoff_fd());
+#endif
+#if defined(BACDL_BIP6)
+    reactor_datalink_fd_add(bip6_get_socket());
+#endif
+#if defined(BACDL_ETHERNET)
+    reactor_datalink_fd_add(ethernet_get_socket());
+#endif
+#if defined(BACDL_ARCNET)
+    reactor_datalink_fd_add(arcnet_get_socket());
+#endif
+#if defined(BACDL_MSTP)
+    reactor_datalink_fd_add(dlmstp_get_receive_fd());
+#endif
+    /* receive anything that arrived before the datalink was added */
+    (void)reactor_event_signal(Reactor_Datalink.event);
+
+    return true;
+}
+
+/**
+ * @brief Remove the datalink file descriptors from the event loop
+ */
+void reactor_datalink_remove(void)
+{
+    unsigned i;
+
+    for (i = 0; i < Reactor_Datalink.fd_count; i++) {
+        (void)reactor_fd_remove(Reactor_Datalink.fd[i]);
+    }
+    Reactor_Datalink.fd_count = 0;
+    if (Reactor_Datalink.event >= 0) {
+        reactor_close(Reactor_Datalink.event);
+        Reactor_Datalink.event = -1;
+    }
+    Reactor_Datalink.handler = NULL;
+}
@@ -26,6 +26,8 @@
 #include <unistd.h>
 #include <sched.h>
 #include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <time.h>
 /* for scandir */
 #include <dirent.h>
 /* for basename */
@@ -67,6 +69,34 @@ static struct termios2 RS485_oldtio2;
 static FIFO_BUFFER Rx_FIFO;
 /* buffer size needs to be a power of 2 */
 static uint8_t Rx_Buffer[4096];
+/* In the precise timing mode, a timerfd wakes the MS/TP thread at the
+   next timeout of the state machine instead of the 5ms select() poll,
+   and the turnaround is measured from the last octet on the wire. */
+static bool RS485_Precise;
+static int RS485_Timer_Handle = -1;
+static struct timespec RS485_Last_Activity;
+static uint32_t RS485_Turnaround_Usec;
+
+/**
+ * @brief Get the microseconds since a time of the raw monotonic clock,
+ *  which is not slewed by NTP
+ * @param start - the earlier time
+ * @return microseconds since the start time
+ */
+static uint32_t RS485_Elapsed_Microseconds(const struct timespec *start)
+{
+    struct timespec now;
+    int64_t usec;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    usec = ((int64_t)(now.tv_sec - start->tv_sec) * 1000000LL) +
+        ((now.tv_nsec - start->tv_nsec) / 1000L);
+    if (usec < 0) {
+        usec = 0;
+    }
+
+    return (uint32_t)usec;
+}
 
 /*********************************************************************
  * DESCRIPTION: Configures the interface name
@@ -104,6 +134,61 @@ uint32_t RS485_Get_Baud_Rate(void)
     return RS485_Baud;
 }
 
+/****************************************************************************
+ * DESCRIPTION: Enables the precise timing mode, before RS485_Initialize()
+ * RETURN:      none
+ * ALGORITHM:   none
+ * NOTES:       only for the interface of this module, not the ports
+ *              of dlmstp_port.c that have their own handle
+ *****************************************************************************/
+void RS485_Precise_Timing_Set(bool enable)
+{
+    RS485_Precise = enable;
+}
+
+/****************************************************************************
+ * DESCRIPTION: Returns true if the precise timing mode is enabled
+ * RETURN:      true if enabled
+ * ALGORITHM:   none
+ * NOTES:       none
+ *****************************************************************************/
+bool RS485_Precise_Timing(void)
+{
+    return RS485_Precise;
+}
+
+/****************************************************************************
+ * DESCRIPTION: Wakes RS485_Check_UART_Data() after a number of microseconds,
+ *              even if no octet is received, in the precise timing mode
+ * RETURN:      none
+ * ALGORITHM:   one-shot timerfd; zero disarms the timer
+ * NOTES:       timerfd has no raw monotonic clock, so it uses the
+ *              monotonic clock, which only differs by the NTP slew
+ *****************************************************************************/
+void RS485_Timer_Arm(uint32_t microseconds)
+{
+    struct itimerspec timer = { 0 };
+
+    if (RS485_Timer_Handle < 0) {
+        return;
+    }
+    timer.it_value.tv_sec = microseconds / 1000000UL;
+    timer.it_value.tv_nsec = (microseconds % 1000000UL) * 1000L;
+    (void)timerfd_settime(RS485_Timer_Handle, 0, &timer, NULL);
+}
+
+/****************************************************************************
+ * DESCRIPTION: Returns the time from the last octet on the wire to the
+ *              start of the last frame sent, in the precise timing mode
+ * RETURN:      microseconds
+ * ALGORITHM:   none
+ * NOTES:       none
+ *****************************************************************************/
+uint32_t RS485_Turnaround_Microseconds(void)
+{
+    return RS485_Turnaround_Usec;
+}
+
 /****************************************************************************
  * DESCRIPTION: Returns the baud rate that we are currently running at
  * RETURN:      none
@@ -203,6 +288,9 @@ void RS485_Send_Frame(
     ssize_t written = 0;
     int greska;
     const SHARED_MSTP_DATA *poSharedData = NULL;
+    uint32_t elapsed_usec;
+    struct timespec delay;
+    bool precise = RS485_Precise;
 
     if (mstp_port && mstp_port->UserData) {
         poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
@@ -214,11 +302,27 @@ void RS485_Send_Frame(
          */
         baud = dlmstp_baud_rate(mstp_port);
         handle = poSharedData->RS485_Handle;
+        precise = false;
     }
 
     /* sleeping for turnaround time is necessary to give other devices
        time to change from sending to receiving state. */
-    usleep(turnaround_time_usec / baud);
+    if (precise) {
+        /* only the part of the turnaround that has not passed yet */
+        turnaround_time_usec /= baud;
+        elapsed_usec = RS485_Elapsed_Microseconds(&RS485_Last_Activity);
+        if (elapsed_usec < turnaround_time_usec) {
+            delay.tv_sec = 0;
+            delay.tv_nsec = (turnaround_time_usec - elapsed_usec) * 1000L;
+            while (clock_nanosleep(CLOCK_MONOTONIC, 0, &delay, &delay) ==
+                   EINTR) {
+            }
+        }
+        RS485_Turnaround_Usec =
+            RS485_Elapsed_Microseconds(&RS485_Last_Activity);
+    } else {
+        usleep(turnaround_time_usec / baud);
+    }
     /*
        On  success,  the  number of bytes written are returned (zero
        indicates nothing was written).  On error, -1  is  returned,  and
@@ -235,6 +339,9 @@ void RS485_Send_Frame(
         /* wait until all output has been transmitted. */
         termios2_tcdrain(handle);
     }
+    if (precise) {
+        clock_gettime(CLOCK_MONOTONIC_RAW, &RS485_Last_Activity);
+    }
 
     /* per MSTP spec, sort of */
     if (mstp_port) {
@@ -255,6 +362,9 @@ void RS485_Check_UART_Data(struct mstp_port_struct_t *mstp_port)
     uint8_t buf[2048];
     ssize_t n;
     int handle = RS485_Handle;
+    int timer_handle = -1;
+    int max_handle;
+    uint64_t expirations;
     SHARED_MSTP_DATA *poSharedData;
     FIFO_BUFFER *fifo = &Rx_FIFO;
 
@@ -264,6 +374,8 @@ void RS485_Check_UART_Data(struct mstp_port_struct_t *mstp_port)
     if (poSharedData) {
         handle = poSharedData->RS485_Handle;
         fifo = &poSharedData->Rx_FIFO;
+    } else if (RS485_Precise) {
+        timer_handle = RS485_Timer_Handle;
     }
     if (mstp_port->ReceiveError == true) {
         /* do nothing but wait for state machine to clear the error */
@@ -281,14 +393,28 @@ void RS485_Check_UART_Data(struct mstp_port_struct_t *mstp_port)
     /* grab bytes and stuff them into the FIFO every time */
     FD_ZERO(&input);
     FD_SET(handle, &input);
-    n = select(handle + 1, &input, NULL, NULL, &waiter);
+    max_handle = handle;
+    if (timer_handle >= 0) {
+        FD_SET(timer_handle, &input);
+        if (timer_handle > max_handle) {
+            max_handle = timer_handle;
+        }
+    }
+    n = select(max_handle + 1, &input, NULL, NULL, &waiter);
     if (n < 0) {
         return;
     }
+    if ((timer_handle >= 0) && FD_ISSET(timer_handle, &input)) {
+        /* the state machine has a timeout to handle */
+        (void)read(timer_handle, &expirations, sizeof(expirations));
+    }
     if (FD_ISSET(handle, &input)) {
         n = read(handle, buf, sizeof(buf));
         if (n > 0) {
             FIFO_Add(fifo, &buf[0], n);
+            if (timer_handle >= 0) {
+                clock_gettime(CLOCK_MONOTONIC_RAW, &RS485_Last_Activity);
+            }
         }
     }
 }
@@ -298,6 +424,41 @@ void RS485_Cleanup(void)
     /* restore the old port settings */
     termios2_tcsetattr(RS485_Handle, TCSANOW, &RS485_oldtio2);
     close(RS485_Handle);
+    if (RS485_Timer_Handle >= 0) {
+        close(RS485_Timer_Handle);
+        RS485_Timer_Handle = -1;
+    }
+}
+
+/****************************************************************************
+ * DESCRIPTION: Asks the serial driver to hand over each received octet
+ *              without delay, for the precise timing mode
+ * RETURN:      none
+ * ALGORITHM:   ASYNC_LOW_LATENCY flag, and the latency timer of a
+ *              USB serial adapter, which defaults to 16ms on FTDI
+ * NOTES:       both are best effort, and need the permission to write
+ *****************************************************************************/
+static void RS485_Low_Latency(void)
+{
+    struct serial_struct serinfo;
+    char pathname[256];
+    const char *name;
+    FILE *file;
+
+    if (ioctl(RS485_Handle, TIOCGSERIAL, &serinfo) == 0) {
+        serinfo.flags |= ASYNC_LOW_LATENCY;
+        (void)ioctl(RS485_Handle, TIOCSSERIAL, &serinfo);
+    }
+    name = strrchr(RS485_Port_Name, '/');
+    name = name ? name + 1 : RS485_Port_Name;
+    snprintf(
+        pathname, sizeof(pathname), "/sys/class/tty/%s/device/latency_timer",
+        name);
+    file = fopen(pathname, "w");
+    if (file) {
+        fputs("1", file);
+        fclose(file);
+    }
 }
 
 void RS485_Initialize(void)
@@ -333,6 +494,15 @@ void RS485_Initialize(void)
     termios2_tcflush(RS485_Handle, TCIOFLUSH);
     /* ringbuffer */
     FIFO_Init(&Rx_FIFO, Rx_Buffer, sizeof(Rx_Buffer));
+    if (RS485_Precise) {
+        RS485_Low_Latency();
+        RS485_Timer_Handle =
+            timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (RS485_Timer_Handle < 0) {
+            perror("RS485: timerfd");
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &RS485_Last_Activity);
+    }
 }
 
 /* Print in a format for Wireshark ExtCap */
@@ -9,6 +9,7 @@
 #define RS485_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "bacnet/datalink/mstp.h"
 
 #include <linux/serial.h> /* for serial_rs485 */
@@ -45,6 +46,15 @@ bool RS485_Get_Config(struct serial_rs485 *config);
 BACNET_STACK_EXPORT
 bool RS485_Set_Config(const struct serial_rs485 *config);
 
+BACNET_STACK_EXPORT
+void RS485_Precise_Timing_Set(bool enable);
+BACNET_STACK_EXPORT
+bool RS485_Precise_Timing(void);
+BACNET_STACK_EXPORT
+void RS485_Timer_Arm(uint32_t microseconds);
+BACNET_STACK_EXPORT
+uint32_t RS485_Turnaround_Microseconds(void);
+
 BACNET_STACK_EXPORT
 void RS485_Cleanup(void);
 BACNET_STACK_EXPORT
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @brief Trend Log record storage in memory mapped files (Linux)
+ * @details The storage block of each Trend Log is a file in a directory,
+ *  named for the routed device index and the object instance, that is
+ *  mapped shared into memory.  A new record is written in place at the
+ *  insertion point of the log, and the kernel writes the dirty pages back
+ *  to the file, so the records survive a restart of the application
+ *  without being read in or rebuilt: the next Trend_Log_Init() maps the
+ *  same file and carries on.  The file is sized once for Buffer_Size
+ *  records, so the log uses only as much disk as it can hold, and only
+ *  the pages in use take up memory.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/trendlog.h"
+#include "mmap-file.h"
+#include "trendlog-mmap.h"
+
+/* directory of the storage files */
+static char Storage_Directory[PATH_MAX];
+
+/**
+ * @brief Get the pathname of the storage file of a log
+ * @param pathname - [out] buffer for the pathname
+ * @param size - size of the buffer
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @return true if the pathname fits in the buffer
+ */
+static bool trend_log_mmap_pathname(
+    char *pathname,
+    size_t size,
+    unsigned device_index,
+    uint32_t object_instance)
+{
+    int len;
+
+    len = snprintf(
+        pathname, size, "%s/trendlog-%u-%lu.dat", Storage_Directory,
+        device_index, (unsigned long)object_instance);
+
+    return (len > 0) && ((size_t)len < size);
+}
+
+/**
+ * @brief Map the storage file of a log, creating the file with the
+ *  size wanted if it is new or empty.  An existing file is mapped with
+ *  its own size, so that a log that was resized keeps its records.
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param size - [in] the size wanted for a new file,
+ *  [out] the size of the mapped file
+ * @return the mapped file, or NULL on error
+ */
+uint8_t *trend_log_mmap_open(
+    unsigned device_index, uint32_t object_instance, size_t *size)
+{
+    char pathname[PATH_MAX];
+
+    if (!trend_log_mmap_pathname(
+            pathname, sizeof(pathname), device_index, object_instance)) {
+        return NULL;
+    }
+
+    return mmap_file_open(pathname, size);
+}
+
+/**
+ * @brief Unmap the storage file of a log, and remove the file if its
+ *  records are no longer wanted
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param storage - the mapped file
+ * @param size - the size of the mapped file
+ * @param purge - true to remove the file
+ */
+void trend_log_mmap_close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge)
+{
+    char pathname[PATH_MAX];
+
+    if (!trend_log_mmap_pathname(
+            pathname, sizeof(pathname), device_index, object_instance)) {
+        purge = false;
+    }
+    mmap_file_close(purge ? pathname : NULL, storage, size, purge);
+}
+
+/**
+ * @brief Keep the records of the Trend Logs in files in a directory.
+ * @note Call before Trend_Log_Init(), which is called by Device_Init().
+ * @param directory - directory of the storage files, which must exist
+ * @return true if the directory can be used
+ */
+bool trend_log_mmap_init(const char *directory)
+{
+    int len;
+
+    if (!directory || (access(directory, R_OK | W_OK | X_OK) != 0)) {
+        return false;
+    }
+    len = snprintf(
+        Storage_Directory, sizeof(Storage_Directory), "%s", directory);
+    if ((len <= 0) || ((size_t)len >= sizeof(Storage_Directory))) {
+        Storage_Directory[0] = 0;
+        return false;
+    }
+    Trend_Log_Storage_Callback_Set(trend_log_mmap_open, trend_log_mmap_close);
+
+    return true;
+}
+
+/**
+ * @brief Unmap the storage files, leaving the records in the files,
+ *  and go back to the default storage of the Trend Logs
+ */
+void trend_log_mmap_cleanup(void)
+{
+    Trend_Log_Cleanup();
+    Trend_Log_Storage_Callback_Set(NULL, NULL);
+    Storage_Directory[0] = 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief API for Trend Log record storage in memory mapped files (Linux)
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#ifndef BACNET_PORT_LINUX_TRENDLOG_MMAP_H
+#define BACNET_PORT_LINUX_TRENDLOG_MMAP_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool trend_log_mmap_init(const char *directory);
+BACNET_STACK_EXPORT
+void trend_log_mmap_cleanup(void);
+
+BACNET_STACK_EXPORT
+uint8_t *trend_log_mmap_open(
+    unsigned device_index, uint32_t object_instance, size_t *size);
+BACNET_STACK_EXPORT
+void trend_log_mmap_close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <time.h>
 #include <libwebsockets.h>
 #include "websocket-global.h"
 #include "bacnet/basic/sys/debug.h"
@@ -20,14 +21,86 @@
 #endif
 
 static pthread_mutex_t websocket_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+/* The dispatch lock guards the whole BSC core, which runs on the client,
+   server, and event threads, and whose hub and node switch forward
+   between connections, so it is not split per connection.  There is no
+   thread of the core that a lock-free queue could hand the received
+   messages to, so they are dispatched under this lock; the counters
+   show how long the threads wait for it. */
 static pthread_mutex_t websocket_dispatch_mutex =
     PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static BSC_WEBSOCKET_LOCK_STATS websocket_lock_stats[BSC_WEBSOCKET_LOCK_MAX];
+
+/**
+ * @brief Take a lock of the websocket layer, and count the times that it
+ *  was held by another thread, and the time spent waiting for it
+ * @param mutex - the lock
+ * @param lock - which lock of the websocket layer it is
+ */
+void bsc_websocket_mutex_lock(pthread_mutex_t *mutex, BSC_WEBSOCKET_LOCK lock)
+{
+    BSC_WEBSOCKET_LOCK_STATS *stats = &websocket_lock_stats[lock];
+    struct timespec start, end;
+    int64_t wait_ns;
+
+    if (pthread_mutex_trylock(mutex) != 0) {
+        (void)__atomic_add_fetch(&stats->contended, 1, __ATOMIC_RELAXED);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pthread_mutex_lock(mutex);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        wait_ns = (int64_t)(end.tv_sec - start.tv_sec) * 1000000000LL +
+            (end.tv_nsec - start.tv_nsec);
+        if (wait_ns > 0) {
+            (void)__atomic_add_fetch(
+                &stats->wait_ns, (uint64_t)wait_ns, __ATOMIC_RELAXED);
+        }
+    }
+    (void)__atomic_add_fetch(&stats->acquired, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Get the contention counters of a lock of the websocket layer
+ * @param lock - which lock
+ * @param stats - the counters are copied here
+ * @return true if the lock is known
+ */
+bool bsc_websocket_lock_stats(
+    BSC_WEBSOCKET_LOCK lock, BSC_WEBSOCKET_LOCK_STATS *stats)
+{
+    if ((lock >= BSC_WEBSOCKET_LOCK_MAX) || !stats) {
+        return false;
+    }
+    stats->acquired = __atomic_load_n(
+        &websocket_lock_stats[lock].acquired, __ATOMIC_RELAXED);
+    stats->contended = __atomic_load_n(
+        &websocket_lock_stats[lock].contended, __ATOMIC_RELAXED);
+    stats->wait_ns = __atomic_load_n(
+        &websocket_lock_stats[lock].wait_ns, __ATOMIC_RELAXED);
+
+    return true;
+}
+
+/**
+ * @brief Clear the contention counters of the locks of the websocket layer
+ */
+void bsc_websocket_lock_stats_reset(void)
+{
+    unsigned i;
+
+    for (i = 0; i < BSC_WEBSOCKET_LOCK_MAX; i++) {
+        __atomic_store_n(
+            &websocket_lock_stats[i].acquired, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(
+            &websocket_lock_stats[i].contended, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&websocket_lock_stats[i].wait_ns, 0, __ATOMIC_RELAXED);
+    }
+}
 
 #if (BSC_DEBUG_WEBSOCKET_MUTEX_ENABLED != 1)
 
 void bsc_websocket_global_lock(void)
 {
-    pthread_mutex_lock(&websocket_mutex);
+    bsc_websocket_mutex_lock(&websocket_mutex, BSC_WEBSOCKET_LOCK_GLOBAL);
 }
 
 void bsc_websocket_global_unlock(void)
@@ -37,7 +110,8 @@ void bsc_websocket_global_unlock(void)
 
 void bws_dispatch_lock(void)
 {
-    pthread_mutex_lock(&websocket_dispatch_mutex);
+    bsc_websocket_mutex_lock(
+        &websocket_dispatch_mutex, BSC_WEBSOCKET_LOCK_DISPATCH);
 }
 
 void bws_dispatch_unlock(void)
@@ -56,7 +130,7 @@ void bsc_websocket_global_lock_dbg(char *f, int line)
         line, websocket_mutex_cnt, pthread_self());
     websocket_mutex_cnt++;
     fflush(stdout);
-    pthread_mutex_lock(&websocket_mutex);
+    bsc_websocket_mutex_lock(&websocket_mutex, BSC_WEBSOCKET_LOCK_GLOBAL);
     debug_printf(
         "bsc_websocket_global_lock_dbg() <<< lock_cnt %d tid = %ld\n",
         websocket_mutex_cnt, pthread_self());
@@ -84,7 +158,8 @@ void bws_dispatch_lock_dbg(char *f, int line)
         websocket_dispatch_mutex_cnt, pthread_self());
     websocket_dispatch_mutex_cnt++;
     fflush(stdout);
-    pthread_mutex_lock(&websocket_dispatch_mutex);
+    bsc_websocket_mutex_lock(
+        &websocket_dispatch_mutex, BSC_WEBSOCKET_LOCK_DISPATCH);
     debug_printf(
         "bws_dispatch_lock_dbg() <<< lock_cnt %d tid = %ld\n",
         websocket_dispatch_mutex_cnt, pthread_self());
@@ -107,23 +182,24 @@ void bws_dispatch_unlock_dbg(char *f, int line)
 
 #endif
 
-static bool bsc_websocket_log_initialized = false;
+static pthread_once_t bsc_websocket_log_once = PTHREAD_ONCE_INIT;
 
-void bsc_websocket_init_log(void)
+static void bsc_websocket_log_init_once(void)
 {
-    bsc_websocket_global_lock();
-    if (!bsc_websocket_log_initialized) {
-        bsc_websocket_log_initialized = true;
 #if DEBUG_LIBWEBSOCKETS_ENABLED == 1
-        debug_printf("LWS_MAX_SMP = %d", LWS_MAX_SMP);
-        lws_set_log_level(
-            LLL_ERR | LLL_WARN | LLL_NOTICE | LLL_INFO | LLL_DEBUG |
-                LLL_PARSER | LLL_HEADER | LLL_EXT | LLL_CLIENT | LLL_LATENCY |
-                LLL_USER | LLL_THREAD,
-            NULL);
+    debug_printf("LWS_MAX_SMP = %d", LWS_MAX_SMP);
+    lws_set_log_level(
+        LLL_ERR | LLL_WARN | LLL_NOTICE | LLL_INFO | LLL_DEBUG | LLL_PARSER |
+            LLL_HEADER | LLL_EXT | LLL_CLIENT | LLL_LATENCY | LLL_USER |
+            LLL_THREAD,
+        NULL);
 #else
-        lws_set_log_level(0, NULL);
+    lws_set_log_level(0, NULL);
 #endif
-    }
-    bsc_websocket_global_unlock();
+}
+
+void bsc_websocket_init_log(void)
+{
+    /* once, without the global lock that the connections contend on */
+    (void)pthread_once(&bsc_websocket_log_once, bsc_websocket_log_init_once);
 }
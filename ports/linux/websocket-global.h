@@ -8,10 +8,37 @@
 #ifndef __BSC_WEBSOCKET_MUTEX_INCLUDED__
 #define __BSC_WEBSOCKET_MUTEX_INCLUDED__
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
 #ifndef BSC_DEBUG_WEBSOCKET_MUTEX_ENABLED
 #define BSC_DEBUG_WEBSOCKET_MUTEX_ENABLED 0
 #endif
 
+/* the locks of the websocket layer, with contention counters */
+typedef enum {
+    BSC_WEBSOCKET_LOCK_GLOBAL = 0,
+    BSC_WEBSOCKET_LOCK_DISPATCH = 1,
+    BSC_WEBSOCKET_LOCK_CLIENT = 2,
+    BSC_WEBSOCKET_LOCK_SERVER = 3,
+    BSC_WEBSOCKET_LOCK_MAX = 4
+} BSC_WEBSOCKET_LOCK;
+
+typedef struct {
+    /* number of times that the lock was taken */
+    uint64_t acquired;
+    /* number of times that the lock was held by another thread */
+    uint64_t contended;
+    /* nanoseconds spent waiting for the lock held by another thread */
+    uint64_t wait_ns;
+} BSC_WEBSOCKET_LOCK_STATS;
+
+void bsc_websocket_mutex_lock(pthread_mutex_t *mutex, BSC_WEBSOCKET_LOCK lock);
+bool bsc_websocket_lock_stats(
+    BSC_WEBSOCKET_LOCK lock, BSC_WEBSOCKET_LOCK_STATS *stats);
+void bsc_websocket_lock_stats_reset(void);
+
 #if (BSC_DEBUG_WEBSOCKET_MUTEX_ENABLED != 1)
 void bsc_websocket_global_lock(void);
 void bsc_websocket_global_unlock(void);
@@ -58,42 +58,59 @@ typedef struct {
     size_t fragment_buffer_size;
     size_t fragment_buffer_len;
     BACNET_ERROR_CODE err_code;
+    /* index of the service thread of the connection */
+    int tsi;
 } BSC_WEBSOCKET_CONNECTION;
 
 #if BSC_CONF_WEBSOCKET_SERVERS_NUM < 1
 #error "BSC_CONF_WEBSOCKET_SERVERS_NUM must be >= 1"
 #endif
 
+#if BSC_CONF_WEBSOCKET_SERVICE_THREADS_NUM < 1
+#error "BSC_CONF_WEBSOCKET_SERVICE_THREADS_NUM must be >= 1"
+#endif
+
 static pthread_mutex_t bws_global_mutex =
     PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 static pthread_mutex_t bws_srv_direct_mutex[BSC_CONF_WEBSOCKET_SERVERS_NUM];
 static pthread_mutex_t bws_srv_hub_mutex[BSC_CONF_WEBSOCKET_SERVERS_NUM];
 
-#if BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM > 0
-static BSC_WEBSOCKET_CONNECTION
-    bws_hub_conn[BSC_CONF_WEBSOCKET_SERVERS_NUM]
-                [BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM] = { 0 };
-#else
-static BSC_WEBSOCKET_CONNECTION bws_hub_conn[1][1] = { 0 };
-#endif
+/* take a server lock, counting the contention of the server threads */
+static void bws_srv_lock(pthread_mutex_t *mutex)
+{
+    bsc_websocket_mutex_lock(mutex, BSC_WEBSOCKET_LOCK_SERVER);
+}
 
-#if BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM > 0
-static BSC_WEBSOCKET_CONNECTION
-    bws_direct_conn[BSC_CONF_WEBSOCKET_SERVERS_NUM]
-                   [BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM] = { 0 };
-#else
-static BSC_WEBSOCKET_CONNECTION bws_direct_conn[1][1] = { 0 };
-#endif
+/* number of connections of the servers that start next, for each protocol.
+   The connections of a server are allocated when it starts. */
+static int bws_srv_connections_num[BSC_WEBSOCKET_PROTOCOLS_AMOUNT] = {
+    BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM, BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM
+};
+
+struct BACNetWebsocketServerContext;
+
+/* a thread that services the connections of one libwebsockets
+   service thread index */
+typedef struct {
+    struct BACNetWebsocketServerContext *ctx;
+    int tsi;
+    pthread_t thread_id;
+    bool started;
+} BSC_WEBSOCKET_SERVICE_THREAD;
 
 typedef struct BACNetWebsocketServerContext {
     bool used;
     struct lws_context *wsctx;
     BSC_WEBSOCKET_PROTOCOL proto;
     BSC_WEBSOCKET_CONNECTION *conn;
+    int conn_num;
     pthread_mutex_t *mutex;
     BSC_WEBSOCKET_SRV_DISPATCH dispatch_func;
     void *user_param;
     bool stop_worker;
+    BSC_WEBSOCKET_SERVICE_THREAD
+        service[BSC_CONF_WEBSOCKET_SERVICE_THREADS_NUM];
+    int service_threads_num;
 } BSC_WEBSOCKET_CONTEXT;
 
 static BSC_WEBSOCKET_CONTEXT bws_hub_ctx[BSC_CONF_WEBSOCKET_SERVERS_NUM] = {
@@ -132,20 +149,31 @@ static BSC_WEBSOCKET_CONTEXT *bws_alloc_server_ctx(BSC_WEBSOCKET_PROTOCOL proto)
         ? &bws_hub_ctx[0]
         : &bws_direct_ctx[0];
 
-    pthread_mutex_lock(&bws_global_mutex);
+    bws_srv_lock(&bws_global_mutex);
     DEBUG_PRINTF("bws_alloc_server_ctx() >>> proto = %d\n", proto);
 
     for (i = 0; i < BSC_CONF_WEBSOCKET_SERVERS_NUM; i++) {
         if (!ctx[i].used) {
             if (proto == BSC_WEBSOCKET_HUB_PROTOCOL) {
                 ctx[i].mutex = &bws_srv_hub_mutex[i];
-                ctx[i].conn = &bws_hub_conn[i][0];
             } else {
                 ctx[i].mutex = &bws_srv_direct_mutex[i];
-                ctx[i].conn = &bws_direct_conn[i][0];
+            }
+            ctx[i].conn_num = bws_srv_connections_num[proto];
+            ctx[i].conn = NULL;
+            if (ctx[i].conn_num > 0) {
+                ctx[i].conn = calloc(
+                    (size_t)ctx[i].conn_num, sizeof(BSC_WEBSOCKET_CONNECTION));
+                if (!ctx[i].conn) {
+                    DEBUG_PRINTF("bws_alloc_server_ctx() <<< ret = NULL\n");
+                    pthread_mutex_unlock(&bws_global_mutex);
+                    return NULL;
+                }
             }
             if (!bws_mutex_init(ctx[i].mutex)) {
                 DEBUG_PRINTF("bws_alloc_server_ctx() <<< ret = %p\n", &ctx[i]);
+                free(ctx[i].conn);
+                ctx[i].conn = NULL;
                 pthread_mutex_unlock(&bws_global_mutex);
                 return NULL;
             }
@@ -218,15 +246,18 @@ static void bws_set_disconnect_reason(
 
 static void bws_free_server_ctx(BSC_WEBSOCKET_CONTEXT *ctx)
 {
-    pthread_mutex_lock(&bws_global_mutex);
+    bws_srv_lock(&bws_global_mutex);
     DEBUG_PRINTF("bws_free_server_ctx() >>> ctx = %p\n", ctx);
     ctx->used = false;
     ctx->wsctx = NULL;
+    free(ctx->conn);
     ctx->conn = NULL;
+    ctx->conn_num = 0;
     pthread_mutex_destroy(ctx->mutex);
     ctx->mutex = NULL;
     ctx->dispatch_func = NULL;
     ctx->user_param = NULL;
+    ctx->service_threads_num = 0;
     DEBUG_PRINTF("bws_free_server_ctx() <<< \n");
     pthread_mutex_unlock(&bws_global_mutex);
 }
@@ -237,7 +268,7 @@ static bool bws_validate_ctx_pointer(BSC_WEBSOCKET_CONTEXT *ctx)
     bool is_validated = false;
     int i;
 
-    pthread_mutex_lock(&bws_global_mutex);
+    bws_srv_lock(&bws_global_mutex);
 
     for (i = 0; i < BSC_CONF_WEBSOCKET_SERVERS_NUM; i++) {
         if (ctx == &bws_hub_ctx[i]) {
@@ -260,24 +291,13 @@ static bool bws_validate_ctx_pointer(BSC_WEBSOCKET_CONTEXT *ctx)
 }
 #endif
 
-static int bws_srv_get_max_sockets(BSC_WEBSOCKET_PROTOCOL proto)
-{
-    int max = 0;
-    if (proto == BSC_WEBSOCKET_HUB_PROTOCOL) {
-        max = BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM;
-    } else if (proto == BSC_WEBSOCKET_DIRECT_PROTOCOL) {
-        max = BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM;
-    }
-    return max;
-}
-
 static BSC_WEBSOCKET_HANDLE bws_srv_alloc_connection(BSC_WEBSOCKET_CONTEXT *ctx)
 {
     int i;
 
     DEBUG_PRINTF("bws_srv_alloc_connection() >>> ctx = %p\n", ctx);
 
-    for (i = 0; i < bws_srv_get_max_sockets(ctx->proto); i++) {
+    for (i = 0; i < ctx->conn_num; i++) {
         if (ctx->conn[i].state == BSC_WEBSOCKET_STATE_IDLE) {
             memset(&ctx->conn[i], 0, sizeof(ctx->conn[i]));
             DEBUG_PRINTF("bws_srv_alloc_connection() <<< ret = %d\n", i);
@@ -290,12 +310,31 @@ static BSC_WEBSOCKET_HANDLE bws_srv_alloc_connection(BSC_WEBSOCKET_CONTEXT *ctx)
     return BSC_WEBSOCKET_INVALID_HANDLE;
 }
 
+/**
+ * @brief Get the index of the service thread that calls the function
+ * @param ctx - websocket server context, locked by the caller
+ * @return index of the service thread, or 0 if the caller is not one
+ */
+static int bws_srv_service_thread_index(BSC_WEBSOCKET_CONTEXT *ctx)
+{
+    int i;
+
+    for (i = 1; i < ctx->service_threads_num; i++) {
+        if (ctx->service[i].started &&
+            pthread_equal(ctx->service[i].thread_id, pthread_self())) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
 static void
 bws_srv_free_connection(BSC_WEBSOCKET_CONTEXT *ctx, BSC_WEBSOCKET_HANDLE h)
 {
     DEBUG_PRINTF("bws_srv_free_connection() >>> ctx = %p, h = %d\n", ctx, h);
 
-    if (h >= 0 && h < bws_srv_get_max_sockets(ctx->proto)) {
+    if (h >= 0 && h < ctx->conn_num) {
         if (ctx->conn[h].state != BSC_WEBSOCKET_STATE_IDLE) {
             if (ctx->conn[h].fragment_buffer) {
                 free(ctx->conn[h].fragment_buffer);
@@ -314,7 +353,7 @@ static BSC_WEBSOCKET_HANDLE
 bws_find_connnection(BSC_WEBSOCKET_CONTEXT *ctx, struct lws *ws)
 {
     int i;
-    for (i = 0; i < bws_srv_get_max_sockets(ctx->proto); i++) {
+    for (i = 0; i < ctx->conn_num; i++) {
         if (ctx->conn[i].ws == ws &&
             ctx->conn[i].state != BSC_WEBSOCKET_STATE_IDLE) {
             return i;
@@ -349,7 +388,7 @@ static int bws_srv_websocket_event(
 
     switch (reason) {
         case LWS_CALLBACK_ESTABLISHED: {
-            pthread_mutex_lock(ctx->mutex);
+            bws_srv_lock(ctx->mutex);
             DEBUG_PRINTF("bws_srv_websocket_event() established connection\n");
             h = bws_srv_alloc_connection(ctx);
             if (h == BSC_WEBSOCKET_INVALID_HANDLE) {
@@ -365,6 +404,7 @@ static int bws_srv_websocket_event(
             ctx->conn[h].ws = wsi;
             ctx->conn[h].state = BSC_WEBSOCKET_STATE_CONNECTED;
             ctx->conn[h].err_code = ERROR_CODE_SUCCESS;
+            ctx->conn[h].tsi = bws_srv_service_thread_index(ctx);
             dispatch_func = ctx->dispatch_func;
             user_param = ctx->user_param;
             pthread_mutex_unlock(ctx->mutex);
@@ -377,7 +417,7 @@ static int bws_srv_websocket_event(
         }
         case LWS_CALLBACK_CLOSED: {
             DEBUG_PRINTF("bws_srv_websocket_event() closed connection\n");
-            pthread_mutex_lock(ctx->mutex);
+            bws_srv_lock(ctx->mutex);
             h = bws_find_connnection(ctx, wsi);
             if (h == BSC_WEBSOCKET_INVALID_HANDLE) {
                 pthread_mutex_unlock(ctx->mutex);
@@ -403,7 +443,7 @@ static int bws_srv_websocket_event(
             break;
         }
         case LWS_CALLBACK_WS_PEER_INITIATED_CLOSE: {
-            pthread_mutex_lock(ctx->mutex);
+            bws_srv_lock(ctx->mutex);
             h = bws_find_connnection(ctx, wsi);
             if (h != BSC_WEBSOCKET_INVALID_HANDLE && len >= 2) {
                 err_code[0] = ((uint8_t *)in)[1];
@@ -414,7 +454,7 @@ static int bws_srv_websocket_event(
             break;
         }
         case LWS_CALLBACK_RECEIVE: {
-            pthread_mutex_lock(ctx->mutex);
+            bws_srv_lock(ctx->mutex);
             h = bws_find_connnection(ctx, wsi);
             if (h == BSC_WEBSOCKET_INVALID_HANDLE) {
                 pthread_mutex_unlock(ctx->mutex);
@@ -446,7 +486,7 @@ static int bws_srv_websocket_event(
                 } else {
                     if (!ctx->conn[h].fragment_buffer) {
                         ctx->conn[h].fragment_buffer =
-                            malloc(BSC_RX_BUFFER_LEN);
+                            malloc(BSC_WEBSOCKET_RX_PRE + BSC_RX_BUFFER_LEN);
                         if (!ctx->conn[h].fragment_buffer) {
                             lws_close_reason(
                                 wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, NULL,
@@ -472,7 +512,8 @@ static int bws_srv_websocket_event(
 
                         ctx->conn[h].fragment_buffer = realloc(
                             ctx->conn[h].fragment_buffer,
-                            ctx->conn[h].fragment_buffer_len + len);
+                            BSC_WEBSOCKET_RX_PRE +
+                                ctx->conn[h].fragment_buffer_len + len);
                         if (!ctx->conn[h].fragment_buffer) {
                             lws_close_reason(
                                 wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, NULL,
@@ -492,8 +533,9 @@ static int bws_srv_websocket_event(
                         "socket %d total_len %d\n",
                         len, h, ctx->conn[h].fragment_buffer_len);
                     memcpy(
-                        &ctx->conn[h]
-                             .fragment_buffer[ctx->conn[h].fragment_buffer_len],
+                        &ctx->conn[h].fragment_buffer
+                             [BSC_WEBSOCKET_RX_PRE +
+                              ctx->conn[h].fragment_buffer_len],
                         in, len);
                     ctx->conn[h].fragment_buffer_len += len;
                     if (lws_is_final_fragment(wsi) && !ctx->stop_worker) {
@@ -503,9 +545,9 @@ static int bws_srv_websocket_event(
                         dispatch_func(
                             (BSC_WEBSOCKET_SRV_HANDLE)ctx, h,
                             BSC_WEBSOCKET_RECEIVED, 0, NULL,
-                            ctx->conn[h].fragment_buffer,
+                            &ctx->conn[h].fragment_buffer[BSC_WEBSOCKET_RX_PRE],
                             ctx->conn[h].fragment_buffer_len, user_param);
-                        pthread_mutex_lock(ctx->mutex);
+                        bws_srv_lock(ctx->mutex);
                         ctx->conn[h].fragment_buffer_len = 0;
                         pthread_mutex_unlock(ctx->mutex);
                     } else {
@@ -516,7 +558,7 @@ static int bws_srv_websocket_event(
             break;
         }
         case LWS_CALLBACK_SERVER_WRITEABLE: {
-            pthread_mutex_lock(ctx->mutex);
+            bws_srv_lock(ctx->mutex);
             DEBUG_PRINTF(
                 "bws_srv_websocket_event() ctx %p proto %d can write\n", ctx,
                 ctx->proto);
@@ -548,7 +590,7 @@ static int bws_srv_websocket_event(
                             BSC_WEBSOCKET_SENDABLE, 0, NULL, NULL, 0,
                             user_param);
                     }
-                    pthread_mutex_lock(ctx->mutex);
+                    bws_srv_lock(ctx->mutex);
                     ctx->conn[h].want_send_data = false;
                     ctx->conn[h].can_send_data = false;
                     pthread_mutex_unlock(ctx->mutex);
@@ -569,10 +611,119 @@ static int bws_srv_websocket_event(
     return ret;
 }
 
+/**
+ * @brief Request writable callbacks for the connections of a service thread
+ * @param ctx - websocket server context, locked by the caller
+ * @param tsi - index of the service thread
+ */
+static void bws_srv_service_writable(BSC_WEBSOCKET_CONTEXT *ctx, int tsi)
+{
+    int i;
+
+    /* libwebsockets wants lws_callback_on_writable() to be called
+       from the service thread of the connection */
+    for (i = 0; i < ctx->conn_num; i++) {
+        if (ctx->conn[i].tsi != tsi) {
+            continue;
+        }
+        DEBUG_PRINTF(
+            "bws_srv_worker() ctx %p user_param %p proto %d "
+            "socket %d(%p) state = %d\n",
+            ctx, ctx->user_param, ctx->proto, i, &ctx->conn[i],
+            ctx->conn[i].state);
+        if (ctx->conn[i].state == BSC_WEBSOCKET_STATE_CONNECTED) {
+            if (ctx->conn[i].want_send_data) {
+                DEBUG_PRINTF(
+                    "bws_srv_worker() process request for sending "
+                    "data on socket %d\n",
+                    i);
+                lws_callback_on_writable(ctx->conn[i].ws);
+            }
+        } else if (ctx->conn[i].state == BSC_WEBSOCKET_STATE_DISCONNECTING) {
+            DEBUG_PRINTF(
+                "bws_srv_worker() process disconnecting event on "
+                "socket %d\n",
+                i);
+            lws_callback_on_writable(ctx->conn[i].ws);
+        }
+    }
+}
+
+/**
+ * @brief Worker of the additional service threads of a server, which
+ *  only service their connections until the server is stopped
+ * @param arg - service thread of the server
+ */
+static void *bws_srv_service_worker(void *arg)
+{
+    BSC_WEBSOCKET_SERVICE_THREAD *service = (BSC_WEBSOCKET_SERVICE_THREAD *)arg;
+    BSC_WEBSOCKET_CONTEXT *ctx = service->ctx;
+
+    DEBUG_PRINTF(
+        "bws_srv_service_worker() started for ctx %p tsi %d\n", ctx,
+        service->tsi);
+
+    while (1) {
+        bws_srv_lock(ctx->mutex);
+        if (ctx->stop_worker) {
+            pthread_mutex_unlock(ctx->mutex);
+            DEBUG_PRINTF(
+                "bws_srv_service_worker() ctx %p tsi %d stopped\n", ctx,
+                service->tsi);
+            return NULL;
+        }
+        bws_srv_service_writable(ctx, service->tsi);
+        pthread_mutex_unlock(ctx->mutex);
+        lws_service_tsi(ctx->wsctx, 0, service->tsi);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Start the additional service threads of a server
+ * @param ctx - websocket server context
+ * @return true if all the service threads are started
+ */
+static bool bws_srv_service_start(BSC_WEBSOCKET_CONTEXT *ctx)
+{
+    int i;
+
+    for (i = 1; i < ctx->service_threads_num; i++) {
+        ctx->service[i].ctx = ctx;
+        ctx->service[i].tsi = i;
+        if (pthread_create(
+                &ctx->service[i].thread_id, NULL, &bws_srv_service_worker,
+                &ctx->service[i]) != 0) {
+            return false;
+        }
+        ctx->service[i].started = true;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Wait for the additional service threads of a stopping server
+ * @param ctx - websocket server context, with stop_worker set
+ */
+static void bws_srv_service_join(BSC_WEBSOCKET_CONTEXT *ctx)
+{
+    int i;
+
+    for (i = 1; i < ctx->service_threads_num; i++) {
+        if (ctx->service[i].started) {
+            /* wake up the libwebsockets runloop of every thread */
+            lws_cancel_service(ctx->wsctx);
+            pthread_join(ctx->service[i].thread_id, NULL);
+            ctx->service[i].started = false;
+        }
+    }
+}
+
 static void *bws_srv_worker(void *arg)
 {
     BSC_WEBSOCKET_CONTEXT *ctx = (BSC_WEBSOCKET_CONTEXT *)arg;
-    int i;
     BSC_WEBSOCKET_SRV_DISPATCH dispatch_func;
     void *user_param;
 
@@ -580,7 +731,7 @@ static void *bws_srv_worker(void *arg)
         "bws_srv_worker() started for ctx %p proto %d user_param %p\n", ctx,
         ctx->proto, ctx->user_param);
 
-    pthread_mutex_lock(ctx->mutex);
+    bws_srv_lock(ctx->mutex);
     dispatch_func = ctx->dispatch_func;
     user_param = ctx->user_param;
     pthread_mutex_unlock(ctx->mutex);
@@ -589,11 +740,22 @@ static void *bws_srv_worker(void *arg)
         (BSC_WEBSOCKET_SRV_HANDLE)ctx, 0, BSC_WEBSOCKET_SERVER_STARTED, 0, NULL,
         NULL, 0, user_param);
 
+    /* the other service threads start after the start event, so that
+       no connection is reported before it */
+    bws_srv_lock(ctx->mutex);
+    if (!bws_srv_service_start(ctx)) {
+        DEBUG_PRINTF(
+            "bws_srv_worker() ctx %p proto %d cannot start service threads\n",
+            ctx, ctx->proto);
+        ctx->stop_worker = true;
+    }
+    pthread_mutex_unlock(ctx->mutex);
+
     while (1) {
         DEBUG_PRINTF(
             "bws_srv_worker() ctx %p proto %d blocked user_param %p\n", ctx,
             ctx->proto, ctx->user_param);
-        pthread_mutex_lock(ctx->mutex);
+        bws_srv_lock(ctx->mutex);
 
         if (ctx->stop_worker) {
             DEBUG_PRINTF(
@@ -620,10 +782,11 @@ static void *bws_srv_worker(void *arg)
                        protected by global websocket mutex.
             */
             pthread_mutex_unlock(ctx->mutex);
+            bws_srv_service_join(ctx);
             bsc_websocket_global_lock();
             lws_context_destroy(ctx->wsctx);
             bsc_websocket_global_unlock();
-            pthread_mutex_lock(ctx->mutex);
+            bws_srv_lock(ctx->mutex);
             ctx->wsctx = NULL;
             DEBUG_PRINTF("bws_srv_worker() set wsctx %p\n", ctx->wsctx);
             ctx->stop_worker = false;
@@ -644,29 +807,7 @@ static void *bws_srv_worker(void *arg)
             return NULL;
         }
 
-        for (i = 0; i < bws_srv_get_max_sockets(ctx->proto); i++) {
-            DEBUG_PRINTF(
-                "bws_srv_worker() ctx %p user_param %p proto %d "
-                "socket %d(%p) state = %d\n",
-                ctx, ctx->user_param, ctx->proto, i, &ctx->conn[i],
-                ctx->conn[i].state);
-            if (ctx->conn[i].state == BSC_WEBSOCKET_STATE_CONNECTED) {
-                if (ctx->conn[i].want_send_data) {
-                    DEBUG_PRINTF(
-                        "bws_srv_worker() process request for sending "
-                        "data on socket %d\n",
-                        i);
-                    lws_callback_on_writable(ctx->conn[i].ws);
-                }
-            } else if (
-                ctx->conn[i].state == BSC_WEBSOCKET_STATE_DISCONNECTING) {
-                DEBUG_PRINTF(
-                    "bws_srv_worker() process disconnecting event on "
-                    "socket %d\n",
-                    i);
-                lws_callback_on_writable(ctx->conn[i].ws);
-            }
-        }
+        bws_srv_service_writable(ctx, 0);
 
         DEBUG_PRINTF(
             "bws_srv_worker() ctx %p proto %d unblocked\n", ctx, ctx->proto);
@@ -676,12 +817,23 @@ static void *bws_srv_worker(void *arg)
             "bws_srv_worker() ctx %p user_param %p proto %d going to block on "
             "lws_service() call\n",
             ctx, ctx->user_param, ctx->proto);
-        lws_service(ctx->wsctx, 0);
+        lws_service_tsi(ctx->wsctx, 0, 0);
     }
 
     return NULL;
 }
 
+void bws_srv_connections_set(BSC_WEBSOCKET_PROTOCOL proto, int num)
+{
+    if ((proto == BSC_WEBSOCKET_HUB_PROTOCOL ||
+         proto == BSC_WEBSOCKET_DIRECT_PROTOCOL) &&
+        (num >= 0)) {
+        bws_srv_lock(&bws_global_mutex);
+        bws_srv_connections_num[proto] = num;
+        pthread_mutex_unlock(&bws_global_mutex);
+    }
+}
+
 BSC_WEBSOCKET_RET bws_srv_start(
     BSC_WEBSOCKET_PROTOCOL proto,
     int port,
@@ -744,7 +896,7 @@ BSC_WEBSOCKET_RET bws_srv_start(
 
     bsc_websocket_init_log();
 
-    pthread_mutex_lock(ctx->mutex);
+    bws_srv_lock(ctx->mutex);
     info.port = port;
     info.iface = iface;
     info.protocols = protos;
@@ -761,6 +913,7 @@ BSC_WEBSOCKET_RET bws_srv_start(
     info.timeout_secs = timeout_s;
     info.connect_timeout_secs = timeout_s;
     info.user = ctx;
+    info.count_threads = BSC_CONF_WEBSOCKET_SERVICE_THREADS_NUM;
 
     /* TRICKY: check comments related to lws_context_destroy() call */
 
@@ -768,7 +921,7 @@ BSC_WEBSOCKET_RET bws_srv_start(
     bsc_websocket_global_lock();
     ctx->wsctx = lws_create_context(&info);
     bsc_websocket_global_unlock();
-    pthread_mutex_lock(ctx->mutex);
+    bws_srv_lock(ctx->mutex);
 
     if (!ctx->wsctx) {
         pthread_mutex_unlock(ctx->mutex);
@@ -780,6 +933,12 @@ BSC_WEBSOCKET_RET bws_srv_start(
     ctx->dispatch_func = dispatch_func;
     ctx->user_param = dispatch_func_user_param;
     ctx->proto = proto;
+    /* libwebsockets may be built with fewer service threads */
+    ctx->service_threads_num = lws_get_count_threads(ctx->wsctx);
+    if ((ctx->service_threads_num < 1) ||
+        (ctx->service_threads_num > BSC_CONF_WEBSOCKET_SERVICE_THREADS_NUM)) {
+        ctx->service_threads_num = 1;
+    }
     r = pthread_attr_init(&attr);
 
     if (!r) {
@@ -810,7 +969,7 @@ BSC_WEBSOCKET_RET bws_srv_start(
         bsc_websocket_global_lock();
         lws_context_destroy(ctx->wsctx);
         bsc_websocket_global_unlock();
-        pthread_mutex_lock(ctx->mutex);
+        bws_srv_lock(ctx->mutex);
         ctx->wsctx = NULL;
         pthread_mutex_unlock(ctx->mutex);
         bws_free_server_ctx(ctx);
@@ -840,7 +999,7 @@ BSC_WEBSOCKET_RET bws_srv_stop(BSC_WEBSOCKET_SRV_HANDLE sh)
     }
 #endif
 
-    pthread_mutex_lock(ctx->mutex);
+    bws_srv_lock(ctx->mutex);
 
     if (ctx->stop_worker) {
         pthread_mutex_unlock(ctx->mutex);
@@ -870,8 +1029,8 @@ void bws_srv_disconnect(BSC_WEBSOCKET_SRV_HANDLE sh, BSC_WEBSOCKET_HANDLE h)
     }
 #endif
 
-    pthread_mutex_lock(ctx->mutex);
-    if (h >= 0 && h < bws_srv_get_max_sockets(ctx->proto) &&
+    bws_srv_lock(ctx->mutex);
+    if (h >= 0 && h < ctx->conn_num &&
         !ctx->stop_worker) {
         if (ctx->conn[h].state == BSC_WEBSOCKET_STATE_CONNECTED) {
             /* tell worker to process change of connection state */
@@ -896,7 +1055,7 @@ void bws_srv_send(BSC_WEBSOCKET_SRV_HANDLE sh, BSC_WEBSOCKET_HANDLE h)
     }
 #endif
 
-    pthread_mutex_lock(ctx->mutex);
+    bws_srv_lock(ctx->mutex);
     if (ctx->conn[h].state == BSC_WEBSOCKET_STATE_CONNECTED) {
         /* tell worker to process send request */
         ctx->conn[h].want_send_data = true;
@@ -929,7 +1088,7 @@ BSC_WEBSOCKET_RET bws_srv_dispatch_send(
     }
 #endif
 
-    if (h < 0 || h >= bws_srv_get_max_sockets(ctx->proto)) {
+    if (h < 0 || h >= ctx->conn_num) {
         DEBUG_PRINTF("bws_srv_dispatch_send() <<< BSC_WEBSOCKET_BAD_PARAM\n");
         return BSC_WEBSOCKET_BAD_PARAM;
     }
@@ -939,7 +1098,7 @@ BSC_WEBSOCKET_RET bws_srv_dispatch_send(
         return BSC_WEBSOCKET_BAD_PARAM;
     }
 
-    pthread_mutex_lock(ctx->mutex);
+    bws_srv_lock(ctx->mutex);
 
     if (ctx->stop_worker) {
         pthread_mutex_unlock(ctx->mutex);
@@ -991,11 +1150,11 @@ bool bws_srv_get_peer_ip_addr(
     const char *ret = NULL;
 
     if (!ctx || h < 0 || !ip_str || !ip_str_len || !port ||
-        h >= bws_srv_get_max_sockets(ctx->proto)) {
+        h >= ctx->conn_num) {
         return false;
     }
 
-    pthread_mutex_lock(ctx->mutex);
+    bws_srv_lock(ctx->mutex);
 
     if (ctx->conn[h].state != BSC_WEBSOCKET_STATE_IDLE &&
         ctx->conn[h].ws != NULL && !ctx->stop_worker) {
@@ -18,6 +18,15 @@
 
 /** @file bip.c  Configuration and Operations for BACnet/IP */
 
+/* The MPDU is sent from the stack buffer with a PBUF_REF pbuf, and lwIP
+   chains its own IP and UDP header pbuf in front of it, so the MPDU is
+   not copied. lwIP copies a PBUF_REF payload if the packet has to be
+   queued, such as while ARP resolves the destination. Set to 0 when the
+   network driver keeps a pbuf after its output function returns. */
+#ifndef BIP_LWIP_ZERO_COPY
+#define BIP_LWIP_ZERO_COPY 1
+#endif
+
 /* port to use - stored in network byte order */
 static bool BIP_Port_Changed;
 /* IP Address */
@@ -26,6 +35,8 @@ static BACNET_IP_ADDRESS BIP_Address;
 static BACNET_IP_ADDRESS BIP_Broadcast_Address;
 /* lwIP socket, of sorts */
 static struct udp_pcb *Server_upcb;
+/* a received MPDU that lwIP split across a chain of pbufs */
+static uint8_t BIP_Rx_Buffer[BIP_MPDU_MAX];
 /* track packets for diagnostics */
 struct bacnet_stats {
     uint32_t xmit; /* Transmitted packets. */
@@ -205,32 +216,74 @@ static int bip_encode_bip_address(
     return len;
 }
 
+/**
+ * @brief Get a pbuf that holds an MPDU for sending
+ * @param mtu [in] Buffer of data to be sent
+ * @param mtu_len [in] Number of bytes of data to be sent
+ * @return pbuf for udp_sendto(), or NULL if none is available
+ */
+static struct pbuf *bip_mpdu_pbuf(const uint8_t *mtu, uint16_t mtu_len)
+{
+    struct pbuf *pkt = NULL;
+
+#if BIP_LWIP_ZERO_COPY
+    pkt = pbuf_alloc(PBUF_RAW, 0, PBUF_REF);
+    if (pkt) {
+        /* lwIP does not write to the payload of a PBUF_REF pbuf */
+        pkt->payload = (void *)mtu;
+        pkt->len = mtu_len;
+        pkt->tot_len = mtu_len;
+    }
+#else
+    pkt = pbuf_alloc(PBUF_TRANSPORT, mtu_len, PBUF_POOL);
+    if (pkt) {
+        pbuf_take(pkt, mtu, mtu_len);
+    }
+#endif
+
+    return pkt;
+}
+
+/**
+ * @brief Send a pbuf to a BACnet/IP address. The pbuf is left for the
+ *  caller to free, and may be sent again to another destination.
+ * @param dest [in] Destination address and port
+ * @param pkt [in] pbuf holding the MPDU
+ * @return true if lwIP accepted the packet
+ */
+static bool bip_sendto(const BACNET_IP_ADDRESS *dest, struct pbuf *pkt)
+{
+    /* addr and port in host format */
+    ip_addr_t dst_ip;
+    uint16_t port = 0;
+
+    bip_decode_bip_address(dest, &dst_ip, &port);
+    if (udp_sendto(Server_upcb, pkt, &dst_ip, port) != ERR_OK) {
+        return false;
+    }
+    BIP_STATS_INC(xmit);
+
+    return true;
+}
+
 /** Function to send a packet out the BACnet/IP socket (Annex J).
  * @ingroup DLBIP
  *
  * @param dest [in] Destination address and port
- * @param mtu_len [in] PBUF packet
+ * @param mtu [in] Buffer of data to be sent
+ * @param mtu_len [in] Number of bytes of data to be sent
  * @return number of bytes sent, or 0 on failure.
  */
 int bip_send_mpdu(
     const BACNET_IP_ADDRESS *dest, const uint8_t *mtu, uint16_t mtu_len)
 {
     struct pbuf *pkt = NULL;
-    /* addr and port in host format */
-    ip_addr_t dst_ip;
-    uint16_t port = 0;
-    err_t status = ERR_OK;
 
-    pkt = pbuf_alloc(PBUF_TRANSPORT, mtu_len, PBUF_POOL);
+    pkt = bip_mpdu_pbuf(mtu, mtu_len);
     if (pkt == NULL) {
         return 0;
     }
-    bip_decode_bip_address(dest, &dst_ip, &port);
-    pbuf_take(pkt, mtu, mtu_len);
-    status = udp_sendto(Server_upcb, pkt, &dst_ip, port);
-    if (status == ERR_OK) {
-        BIP_STATS_INC(xmit);
-    } else {
+    if (!bip_sendto(dest, pkt)) {
         mtu_len = 0;
     }
     pbuf_free(pkt);
@@ -238,6 +291,44 @@ int bip_send_mpdu(
     return mtu_len;
 }
 
+/** Function to send the same packet to many destinations out the
+ * BACnet/IP socket (Annex J). One pbuf holds the packet for every
+ * destination, and lwIP adds the headers for each one.
+ * @ingroup DLBIP
+ *
+ * @param dest [in] Array of destination addresses and ports
+ * @param dest_count [in] Number of destinations
+ * @param mtu [in] Buffer of data to be sent
+ * @param mtu_len [in] Number of bytes of data to be sent
+ * @return number of destinations the packet was sent to.
+ */
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    struct pbuf *pkt = NULL;
+    unsigned i;
+    int sent_count = 0;
+
+    if (dest_count == 0) {
+        return 0;
+    }
+    pkt = bip_mpdu_pbuf(mtu, mtu_len);
+    if (pkt == NULL) {
+        return 0;
+    }
+    for (i = 0; i < dest_count; i++) {
+        if (bip_sendto(&dest[i], pkt)) {
+            sent_count++;
+        }
+    }
+    pbuf_free(pkt);
+
+    return sent_count;
+}
+
 /** Send the Original Broadcast or Unicast messages
  *
  * @param dest [in] Destination address (may encode an IP address and port #).
@@ -256,7 +347,8 @@ int bip_send_pdu(
     return bvlc_send_pdu(dest, npdu_data, pdu, pdu_len);
 }
 
-/** LwIP BACnet service callback
+/** LwIP BACnet service callback. The packet is handled in place in the
+ * pbuf payload, unless lwIP split it across a chain of pbufs.
  *
  * @param arg [in] optional argument from service
  * @param upcb [in] UDP control block
@@ -271,13 +363,23 @@ void bip_server_callback(
     const ip_addr_t *addr,
     u16_t port)
 {
-    uint8_t function = 0;
     uint16_t npdu_offset = 0;
     BACNET_ADDRESS src = { 0 }; /* address where message came from */
     BACNET_IP_ADDRESS saddr;
     uint8_t *npdu = (uint8_t *)pkt->payload;
     uint16_t npdu_len = pkt->tot_len;
 
+    (void)arg;
+    (void)upcb;
+    if (pkt->len < pkt->tot_len) {
+        if (pkt->tot_len > sizeof(BIP_Rx_Buffer)) {
+            BIP_STATS_INC(drop);
+            pbuf_free(pkt);
+            return;
+        }
+        npdu = &BIP_Rx_Buffer[0];
+        npdu_len = pbuf_copy_partial(pkt, npdu, pkt->tot_len, 0);
+    }
     bip_encode_bip_address(&saddr, addr, port);
     npdu_offset = bvlc_handler(&saddr, &src, npdu, npdu_len);
     if (npdu_offset > 0) {
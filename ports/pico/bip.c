@@ -371,3 +371,29 @@ int bip_send_mpdu(
 
     return bytes_sent;
 }
+
+/**
+ * @brief Send a raw BACnet/IP MPDU to many hosts and ports
+ * @param dest array of destination IPv4 addresses and ports
+ * @param dest_count number of destinations
+ * @param mtu raw BVLC/NPDU buffer
+ * @param mtu_len buffer length in bytes
+ * @return number of destinations the MPDU was sent to
+ */
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+    int sent_count = 0;
+
+    for (i = 0; i < dest_count; i++) {
+        if (bip_send_mpdu(&dest[i], mtu, mtu_len) > 0) {
+            sent_count++;
+        }
+    }
+
+    return sent_count;
+}
@@ -102,6 +102,13 @@ int bip_send_pdu(
 int bip_send_mpdu(
     const BACNET_IP_ADDRESS *dest, const uint8_t *mtu, uint16_t mtu_len);
 
+/* Function to send a packet to many destinations (Annex J) */
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len);
+
 /* receives a BACnet/IP packet */
 uint16_t bip_receive(
     BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout);
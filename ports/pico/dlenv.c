@@ -24,7 +24,11 @@ static struct dlmstp_rs485_driver RS485_Driver = {
     .baud_rate = rs485_baud_rate,
     .baud_rate_set = rs485_baud_rate_set,
     .silence_milliseconds = rs485_silence_milliseconds,
-    .silence_reset = rs485_silence_reset
+    .silence_reset = rs485_silence_reset,
+#if BACNET_RS485_PIO
+    .read_block = rs485_read_block,
+    .read_block_done = rs485_read_block_done,
+#endif
 };
 
 // TO BE IMPROVED
@@ -12,6 +12,9 @@
 
 #include "dlenv.h"
 #include "mstimer_init.h"
+#if BACNET_DUAL_CORE
+#include "mstp_core1.h"
+#endif
 
 #include "bacnet/basic/binding/address.h"
 #include "bacnet/basic/object/device.h"
@@ -20,12 +23,16 @@
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/npdu.h"
 
+#if !BACNET_DUAL_CORE
 static uint8_t PDUBuffer[MAX_MPDU + 16];
+#endif
 
 int main(void)
 {
+#if !BACNET_DUAL_CORE
     uint16_t pdu_len = 0;
     BACNET_ADDRESS src = { 0 };
+#endif
 
     stdio_init_all();
     systimer_init();
@@ -34,7 +41,11 @@ int main(void)
     Device_Set_Object_Instance_Number(12345);
     Device_Init(NULL);
 
+#if BACNET_DUAL_CORE
+    if (!mstp_core1_init(2)) {
+#else
     if (!pico_dlenv_init(2)) {
+#endif
         while (true) {
             tight_loop_contents();
         }
@@ -56,10 +67,14 @@ int main(void)
     Send_I_Am(&Handler_Transmit_Buffer[0]);
 
     for (;;) {
+#if BACNET_DUAL_CORE
+        (void)mstp_core1_receive(npdu_handler);
+#else
         pdu_len = datalink_receive(&src, &PDUBuffer[0], MAX_MPDU, 0);
         if (pdu_len) {
             npdu_handler(&src, &PDUBuffer[0], pdu_len);
         }
+#endif
         tsm_timer_milliseconds(1);
         tight_loop_contents();
     }
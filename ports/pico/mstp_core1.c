@@ -0,0 +1,126 @@
+/**************************************************************************
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ *
+ * Runs the MS/TP state machines and the RS-485 driver on core 1, so
+ * that the token passing keeps its timing while core 0 processes the
+ * objects and services. Core 1 puts each received NPDU into a lock-free
+ * queue that core 0 takes them from. Core 0 sends with dlmstp_send_pdu(),
+ * whose queue is already taken by the state machines on core 1 only.
+ *
+ *********************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+
+#include "dlenv.h"
+#include "mstp_core1.h"
+
+#include "bacnet/datalink/dlmstp.h"
+#include "bacnet/basic/sys/ringbuf.h"
+
+/* a received NPDU, as it waits for core 0 */
+struct mstp_core1_packet {
+    BACNET_ADDRESS src;
+    uint16_t pdu_len;
+    uint8_t pdu[DLMSTP_MPDU_MAX];
+};
+
+static struct mstp_core1_packet Receive_Buffer[MSTP_CORE1_RECEIVE_QUEUE];
+static RING_BUFFER Receive_Queue;
+/* core 1 keeps passing the token when core 0 falls behind */
+static uint8_t Drop_Buffer[DLMSTP_MPDU_MAX];
+static volatile uint32_t Receive_Dropped;
+static uint8_t MAC_Address;
+
+/**
+ * @brief Core 1: start the datalink, and run the MS/TP state machines
+ */
+static void mstp_core1_entry(void)
+{
+    struct mstp_core1_packet *packet;
+    BACNET_ADDRESS src = { 0 };
+    uint16_t pdu_len;
+
+    /* the RS-485 interrupt is handled by the core that enables it */
+    if (!pico_dlenv_init(MAC_Address)) {
+        multicore_fifo_push_blocking(0);
+        for (;;) {
+            tight_loop_contents();
+        }
+    }
+    multicore_fifo_push_blocking(1);
+    for (;;) {
+        packet = (struct mstp_core1_packet *)Ringbuf_Data_Peek(&Receive_Queue);
+        if (packet) {
+            pdu_len = dlmstp_receive(
+                &packet->src, packet->pdu, sizeof(packet->pdu), 0);
+            if (pdu_len) {
+                packet->pdu_len = pdu_len;
+                (void)Ringbuf_Data_Put(&Receive_Queue, (uint8_t *)packet);
+            }
+        } else {
+            pdu_len =
+                dlmstp_receive(&src, Drop_Buffer, sizeof(Drop_Buffer), 0);
+            if (pdu_len) {
+                Receive_Dropped++;
+            }
+        }
+        tight_loop_contents();
+    }
+}
+
+/**
+ * @brief Core 0: handle the NPDUs that core 1 has received
+ * @param handler - called for each NPDU, which is only valid during the
+ *  call
+ * @return number of NPDUs that were handled
+ */
+unsigned mstp_core1_receive(datalink_receive_handler handler)
+{
+    struct mstp_core1_packet *packet;
+    unsigned count = 0;
+
+    while ((packet = (struct mstp_core1_packet *)Ringbuf_Peek(
+                &Receive_Queue)) != NULL) {
+        if (handler) {
+            handler(&packet->src, packet->pdu, packet->pdu_len);
+        }
+        (void)Ringbuf_Pop(&Receive_Queue, NULL);
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Core 0: number of NPDUs that core 1 received while the queue
+ *  was full
+ * @return number of dropped NPDUs
+ */
+uint32_t mstp_core1_dropped(void)
+{
+    return Receive_Dropped;
+}
+
+/**
+ * @brief Core 0: start the datalink on core 1
+ * @param mac_address - MS/TP station address of this node
+ * @return true when core 1 started the datalink
+ */
+bool mstp_core1_init(uint8_t mac_address)
+{
+    if (!Ringbuf_Initialize(
+            &Receive_Queue, (volatile uint8_t *)Receive_Buffer,
+            sizeof(Receive_Buffer), sizeof(Receive_Buffer[0]),
+            MSTP_CORE1_RECEIVE_QUEUE)) {
+        return false;
+    }
+    MAC_Address = mac_address;
+    multicore_launch_core1(mstp_core1_entry);
+
+    return multicore_fifo_pop_blocking() != 0;
+}
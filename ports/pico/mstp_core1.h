@@ -0,0 +1,32 @@
+/**************************************************************************
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ *
+ *********************************************************************/
+
+#ifndef MSTP_CORE1_H
+#define MSTP_CORE1_H
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bacnet/bacdef.h"
+#include "bacnet/datalink/datalink.h"
+
+/* number of received NPDUs that wait for core 0, as a power of two */
+#ifndef MSTP_CORE1_RECEIVE_QUEUE
+#define MSTP_CORE1_RECEIVE_QUEUE 4
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+bool mstp_core1_init(uint8_t mac_address);
+unsigned mstp_core1_receive(datalink_receive_handler handler);
+uint32_t mstp_core1_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
@@ -0,0 +1,367 @@
+/**************************************************************************
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ *
+ * RS-485 driver that uses two PIO state machines in place of the UART.
+ * The transmitter drives DE/RE itself, so the driver turnaround does not
+ * depend on the CPU, and a DMA channel feeds it from the frame buffer.
+ * The receiver detects the idle line after a run of octets, and a DMA
+ * channel streams the octets into a ring buffer that is given to the
+ * MS/TP receive state machine one block at a time.
+ *
+ *********************************************************************/
+
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/datalink/dlmstp.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "rs485.h"
+#include "rs485.pio.h"
+#include "mstimer_init.h"
+
+#ifndef RS485_PIO
+#define RS485_PIO pio0
+#endif
+/* the receive ring buffer is 2^RS485_RX_BUFFER_BITS octets, and is
+   aligned to its size for the DMA ring */
+#ifndef RS485_RX_BUFFER_BITS
+#define RS485_RX_BUFFER_BITS 10
+#endif
+#define RS485_RX_BUFFER_SIZE (1U << RS485_RX_BUFFER_BITS)
+#define RS485_RX_BUFFER_MASK (RS485_RX_BUFFER_SIZE - 1)
+/* state machine clocks per bit, as written in rs485.pio */
+#define RS485_PIO_CLOCKS_PER_BIT 8
+
+static uint8_t Rx_Buffer[RS485_RX_BUFFER_SIZE]
+    __attribute__((aligned(RS485_RX_BUFFER_SIZE)));
+/* the frame that the DMA is sending, so that the state machine can build
+   the next one in its own buffer */
+static uint8_t Tx_Buffer[DLMSTP_MPDU_MAX];
+/* next octet that is given to the MS/TP state machine */
+static uint16_t Rx_Index;
+/* octet where the DMA was found writing the last time */
+static uint16_t Rx_Index_Seen;
+static uint Tx_SM;
+static uint Rx_SM;
+static uint Tx_DMA;
+static uint Rx_DMA;
+static volatile bool Tx_Active;
+static uint32_t Rs485_Baud_Rate = RS485_BAUD_RATE;
+static volatile uint32_t Rs485_Bytes_Tx = 0;
+static volatile uint32_t Rs485_Bytes_Rx = 0;
+
+/* amount of silence on the wire */
+static struct mstimer Silence_Timer;
+
+/**
+ * @brief Get the state machine clock divider for a baud rate
+ * @param baud - the baud rate
+ * @return the clock divider
+ */
+static float rs485_clock_divider(uint32_t baud)
+{
+    return (float)clock_get_hz(clk_sys) /
+        (float)(RS485_PIO_CLOCKS_PER_BIT * baud);
+}
+
+/**
+ * @brief Get the octet of the ring buffer that the DMA writes next, and
+ *  note the activity on the line.
+ * @return index into the ring buffer
+ */
+static uint16_t rs485_rx_update(void)
+{
+    uint16_t index;
+
+    if (!dma_channel_is_busy(Rx_DMA)) {
+        /* continue where the DMA stopped, which is only after 2^32
+           octets, unless the channel is endless */
+        dma_channel_set_trans_count(Rx_DMA, UINT32_MAX, true);
+    }
+    index = (uint16_t)((uintptr_t)dma_channel_hw_addr(Rx_DMA)->write_addr -
+                (uintptr_t)Rx_Buffer) &
+        RS485_RX_BUFFER_MASK;
+    if (index != Rx_Index_Seen) {
+        Rx_Index_Seen = index;
+        rs485_silence_reset();
+    }
+    if (pio_interrupt_get(RS485_PIO, Rx_SM)) {
+        /* the line went idle after the last octet */
+        pio_interrupt_clear(RS485_PIO, Rx_SM);
+        rs485_silence_reset();
+    }
+
+    return index;
+}
+
+/**
+ * @brief Initialize the RS-485 state machines, DMA channels, and pins.
+ */
+void rs485_init(void)
+{
+    pio_sm_config config;
+    dma_channel_config dma_config;
+    uint offset;
+    float divider = rs485_clock_divider(Rs485_Baud_Rate);
+
+    /* transmitter: TX on the OUT and SET pins, DE/RE on the side-set */
+    Tx_SM = pio_claim_unused_sm(RS485_PIO, true);
+    offset = pio_add_program(RS485_PIO, &rs485_tx_program);
+    config = rs485_tx_program_get_default_config(offset);
+    sm_config_set_out_pins(&config, RS485_TX_PIN, 1);
+    sm_config_set_set_pins(&config, RS485_TX_PIN, 1);
+    sm_config_set_sideset_pins(&config, RS485_DE_PIN);
+    sm_config_set_out_shift(&config, true, false, 32);
+    sm_config_set_fifo_join(&config, PIO_FIFO_JOIN_TX);
+    sm_config_set_mov_status(&config, STATUS_TX_LESSTHAN, 1);
+    sm_config_set_clkdiv(&config, divider);
+    pio_sm_set_pins_with_mask(
+        RS485_PIO, Tx_SM, 1U << RS485_TX_PIN,
+        (1U << RS485_TX_PIN) | (1U << RS485_DE_PIN));
+    pio_sm_set_pindirs_with_mask(
+        RS485_PIO, Tx_SM, (1U << RS485_TX_PIN) | (1U << RS485_DE_PIN),
+        (1U << RS485_TX_PIN) | (1U << RS485_DE_PIN));
+    pio_gpio_init(RS485_PIO, RS485_TX_PIN);
+    pio_gpio_init(RS485_PIO, RS485_DE_PIN);
+    pio_sm_init(RS485_PIO, Tx_SM, offset, &config);
+
+    /* receiver: RX on the IN and JMP pins */
+    Rx_SM = pio_claim_unused_sm(RS485_PIO, true);
+    offset = pio_add_program(RS485_PIO, &rs485_rx_program);
+    config = rs485_rx_program_get_default_config(offset);
+    sm_config_set_in_pins(&config, RS485_RX_PIN);
+    sm_config_set_jmp_pin(&config, RS485_RX_PIN);
+    sm_config_set_in_shift(&config, true, false, 32);
+    sm_config_set_fifo_join(&config, PIO_FIFO_JOIN_RX);
+    sm_config_set_clkdiv(&config, divider);
+    pio_sm_set_consecutive_pindirs(RS485_PIO, Rx_SM, RS485_RX_PIN, 1, false);
+    pio_gpio_init(RS485_PIO, RS485_RX_PIN);
+    gpio_pull_up(RS485_RX_PIN);
+    pio_sm_init(RS485_PIO, Rx_SM, offset, &config);
+
+    /* the frame buffer is written to the transmitter FIFO */
+    Tx_DMA = (uint)dma_claim_unused_channel(true);
+    dma_config = dma_channel_get_default_config(Tx_DMA);
+    channel_config_set_transfer_data_size(&dma_config, DMA_SIZE_8);
+    channel_config_set_read_increment(&dma_config, true);
+    channel_config_set_write_increment(&dma_config, false);
+    channel_config_set_dreq(
+        &dma_config, pio_get_dreq(RS485_PIO, Tx_SM, true));
+    dma_channel_configure(
+        Tx_DMA, &dma_config, &RS485_PIO->txf[Tx_SM], NULL, 0, false);
+
+    /* the octet is in the top byte of the receiver FIFO */
+    Rx_DMA = (uint)dma_claim_unused_channel(true);
+    dma_config = dma_channel_get_default_config(Rx_DMA);
+    channel_config_set_transfer_data_size(&dma_config, DMA_SIZE_8);
+    channel_config_set_read_increment(&dma_config, false);
+    channel_config_set_write_increment(&dma_config, true);
+    channel_config_set_ring(&dma_config, true, RS485_RX_BUFFER_BITS);
+    channel_config_set_dreq(
+        &dma_config, pio_get_dreq(RS485_PIO, Rx_SM, false));
+    dma_channel_configure(
+        Rx_DMA, &dma_config, Rx_Buffer,
+        (io_rw_8 *)&RS485_PIO->rxf[Rx_SM] + 3, UINT32_MAX, true);
+
+    pio_sm_set_enabled(RS485_PIO, Tx_SM, true);
+    pio_sm_set_enabled(RS485_PIO, Rx_SM, true);
+    rs485_silence_reset();
+}
+
+/**
+ * @brief The transmitter state machine drives DE/RE, so this only
+ *  exists for the API of the UART driver.
+ * @param enable True to enable transmitter (TX), False to enable receiver (RX).
+ */
+void rs485_rts_enable(bool enable)
+{
+    (void)enable;
+}
+
+/**
+ * @brief Determine if a frame is being transmitted
+ * @return True until the stop bit of the last octet has been sent
+ */
+bool rs485_rts_enabled(void)
+{
+    if (Tx_Active && !dma_channel_is_busy(Tx_DMA) &&
+        pio_sm_is_tx_fifo_empty(RS485_PIO, Tx_SM) &&
+        pio_interrupt_get(RS485_PIO, Tx_SM)) {
+        /* the DMA keeps the FIFO filled, so the FIFO only becomes empty
+           after the last octet of the frame */
+        pio_interrupt_clear(RS485_PIO, Tx_SM);
+        Tx_Active = false;
+        rs485_silence_reset();
+    }
+
+    return Tx_Active;
+}
+
+/**
+ * @brief Attempts to read a single byte from the receive ring buffer.
+ * @param data_register Pointer to store the received byte, or NULL to
+ *  only check if one is available.
+ * @return True if a byte was received, False otherwise.
+ */
+bool rs485_byte_available(uint8_t *data_register)
+{
+    if (rs485_rx_update() == Rx_Index) {
+        return false;
+    }
+    if (data_register) {
+        *data_register = Rx_Buffer[Rx_Index];
+        Rx_Index = (Rx_Index + 1) & RS485_RX_BUFFER_MASK;
+        Rs485_Bytes_Rx++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the run of received octets that are in the ring buffer
+ * @param buffer [out] the first octet of the run
+ * @return number of octets in the run, up to the end of the ring buffer
+ */
+uint16_t rs485_read_block(const uint8_t **buffer)
+{
+    uint16_t index;
+
+    index = rs485_rx_update();
+    if (index == Rx_Index) {
+        return 0;
+    }
+    if (buffer) {
+        *buffer = &Rx_Buffer[Rx_Index];
+    }
+    if (index > Rx_Index) {
+        return index - Rx_Index;
+    }
+
+    return RS485_RX_BUFFER_SIZE - Rx_Index;
+}
+
+/**
+ * @brief Release the octets that the MS/TP state machine has consumed
+ * @param count - number of octets from the start of the run
+ */
+void rs485_read_block_done(uint16_t count)
+{
+    Rx_Index = (Rx_Index + count) & RS485_RX_BUFFER_MASK;
+    Rs485_Bytes_Rx += count;
+}
+
+/**
+ * @brief Checks the receiver state machine for a framing error.
+ * @return True if a receive error is present, False otherwise.
+ */
+bool rs485_receive_error(void)
+{
+    if (pio_interrupt_get(RS485_PIO, 4 + Rx_SM)) {
+        pio_interrupt_clear(RS485_PIO, 4 + Rx_SM);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Start to send a buffer of bytes, after the frame before it has
+ *  been sent. The DMA sends a copy of the buffer, and rs485_rts_enabled()
+ *  returns true until the last octet has been sent.
+ * @param buffer Pointer to the data buffer.
+ * @param nbytes Number of bytes to send.
+ */
+void rs485_bytes_send(const uint8_t *buffer, uint16_t nbytes)
+{
+    if (!buffer || !nbytes || (nbytes > sizeof(Tx_Buffer))) {
+        return;
+    }
+    while (rs485_rts_enabled()) {
+        tight_loop_contents();
+    }
+    memcpy(Tx_Buffer, buffer, nbytes);
+    pio_interrupt_clear(RS485_PIO, Tx_SM);
+    Tx_Active = true;
+    Rs485_Bytes_Tx += nbytes;
+    dma_channel_transfer_from_buffer_now(Tx_DMA, Tx_Buffer, nbytes);
+}
+
+/**
+ * @brief Returns the currently configured baud rate.
+ * @return The current baud rate.
+ */
+uint32_t rs485_baud_rate(void)
+{
+    return Rs485_Baud_Rate;
+}
+
+/**
+ * @brief Sets a new baud rate for both state machines.
+ * @param baud The new baud rate to set.
+ * @return True if the baud rate was successfully set, False otherwise.
+ */
+bool rs485_baud_rate_set(uint32_t baud)
+{
+    float divider;
+
+    switch (baud) {
+        case 9600:
+        case 19200:
+        case 38400:
+        case 57600:
+        case 76800:
+        case 115200:
+            Rs485_Baud_Rate = baud;
+            divider = rs485_clock_divider(baud);
+            pio_sm_set_clkdiv(RS485_PIO, Tx_SM, divider);
+            pio_sm_set_clkdiv(RS485_PIO, Rx_SM, divider);
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Measures the duration of silence on the bus since the last byte (Tx or
+ * Rx).
+ * @return The duration of silence in milliseconds.
+ */
+uint32_t rs485_silence_milliseconds(void)
+{
+    (void)rs485_rx_update();
+
+    return mstimer_elapsed(&Silence_Timer);
+}
+
+/**
+ * @brief Resets the silence timer to the current time.
+ */
+void rs485_silence_reset(void)
+{
+    mstimer_set(&Silence_Timer, 0);
+}
+
+/**
+ * @brief Gets the total number of bytes transmitted.
+ * @return The byte count.
+ */
+uint32_t rs485_bytes_transmitted(void)
+{
+    return Rs485_Bytes_Tx;
+}
+
+/**
+ * @brief Gets the total number of bytes received.
+ * @return The byte count.
+ */
+uint32_t rs485_bytes_received(void)
+{
+    return Rs485_Bytes_Rx;
+}
@@ -31,6 +31,9 @@ extern "C" {
 void rs485_rts_enable(bool enable);
 bool rs485_rts_enabled(void);
 bool rs485_byte_available(uint8_t *data_register);
+/* only in the PIO driver, rs485-pio.c */
+uint16_t rs485_read_block(const uint8_t **buffer);
+void rs485_read_block_done(uint16_t count);
 bool rs485_receive_error(void);
 
 void rs485_bytes_send(const uint8_t *buffer, uint16_t nbytes);
@@ -55,6 +55,10 @@ static int Program_Run(void *context)
         return -1;
     }
     (void)ubasic_program_location(data);
+    if (result > 1) {
+        /* sleeping: wait in the WAITING state */
+        return result;
+    }
 
     return 0;
 }
@@ -8,6 +8,7 @@
  *********************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdint.h> /* for standard integer types uint8_t etc. */
 #include <stdbool.h> /* for the standard bool type. */
 #include "bacnet/bacdcode.h"
@@ -17,6 +18,7 @@
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 #include "bacport.h"
+#include "bip-iocp.h"
 
 /* Windows sockets */
 static SOCKET BIP_Socket = INVALID_SOCKET;
@@ -36,8 +38,42 @@ static struct in_addr BIP_Broadcast_Addr;
 /* broadcast binding mechanism */
 static bool BIP_Broadcast_Binding_Address_Override;
 static struct in_addr BIP_Broadcast_Binding_Address;
+/* multicast group that replaces the broadcast address, see J.8 */
+static struct in_addr BIP_Multicast_Group;
+static uint8_t BIP_Multicast_TTL = 1;
 /* enable debugging */
 static bool BIP_Debug;
+#if BIP_IOCP
+#ifndef SIO_UDP_CONNRESET
+#define SIO_UDP_CONNRESET _WSAIOW(IOC_VENDOR, 12)
+#endif
+/* a receive or a send with overlapped I/O */
+struct bip_iocp_slot {
+    /* the slot is found from the OVERLAPPED of a completion */
+    OVERLAPPED overlapped;
+    WSABUF wsabuf;
+    SOCKET socket;
+    struct sockaddr_in sin;
+    INT sin_len;
+    DWORD flags;
+    DWORD length;
+    /* the I/O has not completed yet */
+    volatile LONG pending;
+    /* room for the 16 octets of zero after a received MPDU */
+    uint8_t buffer[BIP_MPDU_MAX + 16];
+};
+static struct bip_iocp_slot BIP_IOCP_Receive[BIP_IOCP_RECEIVES_MAX];
+static struct bip_iocp_slot BIP_IOCP_Send[BIP_IOCP_SENDS_MAX];
+/* receive slots with a datagram, in the order they completed */
+static unsigned BIP_IOCP_Ready[BIP_IOCP_RECEIVES_MAX];
+static unsigned BIP_IOCP_Ready_Head;
+static unsigned BIP_IOCP_Ready_Count;
+/* the completion port, and if bip_receive() waits on it */
+static HANDLE BIP_IOCP_Port;
+static bool BIP_IOCP_Port_Owned;
+/* the select() receive path is used instead */
+static bool BIP_IOCP_Failed;
+#endif
 
 /**
  * @brief Print the IPv4 address with debug info
@@ -239,8 +275,11 @@ static void bip_init_windows(void)
     WSADATA wd;
 
     if (!BIP_Initialized) {
+#if BIP_IOCP
+        Result = WSAStartup(MAKEWORD(2, 2), &wd);
+#else
         Result = WSAStartup((1 << 8) | 1, &wd);
-        /*Result = WSAStartup(MAKEWORD(2,2), &wd); */
+#endif
         if (Result != 0) {
             print_last_error("TCP/IP stack initialization failed");
             exit(1);
@@ -250,6 +289,315 @@ static void bip_init_windows(void)
     }
 }
 
+#if BIP_IOCP
+/**
+ * @brief Post a receive of a datagram to the socket of a receive slot
+ * @param slot - the receive slot
+ * @return true if the receive was posted
+ */
+static bool bip_iocp_receive_post(struct bip_iocp_slot *slot)
+{
+    int rv;
+
+    memset(&slot->overlapped, 0, sizeof(slot->overlapped));
+    slot->wsabuf.buf = (char *)slot->buffer;
+    slot->wsabuf.len = BIP_MPDU_MAX;
+    slot->sin_len = sizeof(slot->sin);
+    slot->flags = 0;
+    slot->length = 0;
+    slot->pending = 1;
+    rv = WSARecvFrom(
+        slot->socket, &slot->wsabuf, 1, NULL, &slot->flags,
+        (struct sockaddr *)&slot->sin, &slot->sin_len, &slot->overlapped,
+        NULL);
+    if ((rv == SOCKET_ERROR) && (WSAGetLastError() != WSA_IO_PENDING)) {
+        print_last_error("WSARecvFrom");
+        slot->pending = 0;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Take the next completed receive slot, in the order received
+ * @return the receive slot, or NULL if none have completed
+ */
+static struct bip_iocp_slot *bip_iocp_ready_pop(void)
+{
+    struct bip_iocp_slot *slot;
+
+    if (BIP_IOCP_Ready_Count == 0) {
+        return NULL;
+    }
+    slot = &BIP_IOCP_Receive[BIP_IOCP_Ready[BIP_IOCP_Ready_Head]];
+    BIP_IOCP_Ready_Head = (BIP_IOCP_Ready_Head + 1) % BIP_IOCP_RECEIVES_MAX;
+    BIP_IOCP_Ready_Count--;
+
+    return slot;
+}
+
+/**
+ * @brief Handle a completion of the BACnet/IP overlapped I/O that was
+ *  taken from the completion port, such as by an event loop that the
+ *  datalink is attached to with bip_iocp_attach()
+ * @param overlapped - the OVERLAPPED of the completion entry
+ * @return true if a received datagram is ready for bip_receive()
+ */
+bool bip_iocp_complete(LPOVERLAPPED overlapped)
+{
+    struct bip_iocp_slot *slot;
+    DWORD length = 0;
+    DWORD flags = 0;
+    BOOL status;
+    unsigned index;
+
+    if (!overlapped) {
+        return false;
+    }
+    slot = CONTAINING_RECORD(overlapped, struct bip_iocp_slot, overlapped);
+    if ((slot >= &BIP_IOCP_Send[0]) &&
+        (slot < &BIP_IOCP_Send[BIP_IOCP_SENDS_MAX])) {
+        if (!WSAGetOverlappedResult(
+                slot->socket, overlapped, &length, FALSE, &flags) &&
+            BIP_IOCP_Port) {
+            print_last_error("WSASendTo");
+        }
+        InterlockedExchange(&slot->pending, 0);
+        return false;
+    }
+    if ((slot < &BIP_IOCP_Receive[0]) ||
+        (slot >= &BIP_IOCP_Receive[BIP_IOCP_RECEIVES_MAX])) {
+        return false;
+    }
+    status = WSAGetOverlappedResult(
+        slot->socket, overlapped, &length, FALSE, &flags);
+    slot->pending = 0;
+    if (!BIP_IOCP_Port) {
+        /* canceled by bip_cleanup() */
+        return false;
+    }
+    if (status && (length > 0) &&
+        (BIP_IOCP_Ready_Count < BIP_IOCP_RECEIVES_MAX)) {
+        slot->length = length;
+        index = (BIP_IOCP_Ready_Head + BIP_IOCP_Ready_Count) %
+            BIP_IOCP_RECEIVES_MAX;
+        BIP_IOCP_Ready[index] = (unsigned)(slot - &BIP_IOCP_Receive[0]);
+        BIP_IOCP_Ready_Count++;
+        return true;
+    }
+    /* an empty datagram, or an error: receive the next one */
+    (void)bip_iocp_receive_post(slot);
+
+    return false;
+}
+
+/**
+ * @brief Wait for a batch of completions on a completion port
+ * @param port - the completion port
+ * @param timeout - number of milliseconds to wait
+ */
+static void bip_iocp_wait(HANDLE port, DWORD timeout)
+{
+    OVERLAPPED_ENTRY entries[BIP_IOCP_BATCH];
+    ULONG count = 0;
+    ULONG i;
+
+    if (GetQueuedCompletionStatusEx(
+            port, entries, BIP_IOCP_BATCH, &count, timeout, FALSE)) {
+        for (i = 0; i < count; i++) {
+            (void)bip_iocp_complete(entries[i].lpOverlapped);
+        }
+    }
+}
+
+/**
+ * @brief Associate the sockets with a completion port, and post the
+ *  receives to them
+ * @param port - the completion port, or NULL to create one that
+ *  bip_receive() waits on
+ * @param key - the completion key of the sockets
+ * @return true if the receives and sends use the completion port
+ */
+static bool bip_iocp_start(HANDLE port, ULONG_PTR key)
+{
+    BOOL connreset = FALSE;
+    DWORD bytes = 0;
+    bool owned = false;
+    unsigned i;
+
+    if (BIP_IOCP_Port || (BIP_Socket == INVALID_SOCKET)) {
+        return false;
+    }
+    if (!port) {
+        port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+        if (!port) {
+            print_last_error("CreateIoCompletionPort");
+            return false;
+        }
+        owned = true;
+    }
+    if (!CreateIoCompletionPort((HANDLE)BIP_Socket, port, key, 0) ||
+        ((BIP_Broadcast_Socket != BIP_Socket) &&
+         !CreateIoCompletionPort(
+             (HANDLE)BIP_Broadcast_Socket, port, key, 0))) {
+        print_last_error("CreateIoCompletionPort");
+        if (owned) {
+            CloseHandle(port);
+        }
+        return false;
+    }
+    /* an ICMP port unreachable for a datagram that was sent would
+       otherwise fail the next receive with WSAECONNRESET */
+    (void)WSAIoctl(
+        BIP_Socket, SIO_UDP_CONNRESET, &connreset, sizeof(connreset), NULL, 0,
+        &bytes, NULL, NULL);
+    if (BIP_Broadcast_Socket != BIP_Socket) {
+        (void)WSAIoctl(
+            BIP_Broadcast_Socket, SIO_UDP_CONNRESET, &connreset,
+            sizeof(connreset), NULL, 0, &bytes, NULL, NULL);
+    }
+    BIP_IOCP_Port = port;
+    BIP_IOCP_Port_Owned = owned;
+    BIP_IOCP_Ready_Head = 0;
+    BIP_IOCP_Ready_Count = 0;
+    for (i = 0; i < BIP_IOCP_RECEIVES_MAX; i++) {
+        /* every other receive is from the broadcast socket */
+        if ((i & 1) && (BIP_Broadcast_Socket != BIP_Socket)) {
+            BIP_IOCP_Receive[i].socket = BIP_Broadcast_Socket;
+        } else {
+            BIP_IOCP_Receive[i].socket = BIP_Socket;
+        }
+        /* a receive that was canceled by bip_cleanup() with its
+           completion still in the queue of the event loop is posted
+           again when that completion is taken */
+        if (!BIP_IOCP_Receive[i].pending) {
+            (void)bip_iocp_receive_post(&BIP_IOCP_Receive[i]);
+        }
+    }
+    if (BIP_Debug) {
+        fprintf(
+            stderr, "BIP: I/O completion port with %u receives\n",
+            (unsigned)BIP_IOCP_RECEIVES_MAX);
+        fflush(stderr);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Cancel the receives and sends, and let go of the completion port
+ */
+static void bip_iocp_stop(void)
+{
+    HANDLE port = BIP_IOCP_Port;
+    unsigned tries;
+    unsigned i;
+    bool pending;
+
+    if (!port) {
+        return;
+    }
+    BIP_IOCP_Port = NULL;
+    BIP_IOCP_Ready_Count = 0;
+    (void)CancelIoEx((HANDLE)BIP_Socket, NULL);
+    if (BIP_Broadcast_Socket != BIP_Socket) {
+        (void)CancelIoEx((HANDLE)BIP_Broadcast_Socket, NULL);
+    }
+    if (BIP_IOCP_Port_Owned) {
+        /* take the canceled I/O from the port before it is closed */
+        for (tries = 0; tries < 10; tries++) {
+            pending = false;
+            for (i = 0; i < BIP_IOCP_RECEIVES_MAX; i++) {
+                pending |= (BIP_IOCP_Receive[i].pending != 0);
+            }
+            for (i = 0; i < BIP_IOCP_SENDS_MAX; i++) {
+                pending |= (BIP_IOCP_Send[i].pending != 0);
+            }
+            if (!pending) {
+                break;
+            }
+            bip_iocp_wait(port, 10);
+        }
+        CloseHandle(port);
+        for (i = 0; i < BIP_IOCP_RECEIVES_MAX; i++) {
+            BIP_IOCP_Receive[i].pending = 0;
+        }
+        for (i = 0; i < BIP_IOCP_SENDS_MAX; i++) {
+            BIP_IOCP_Send[i].pending = 0;
+        }
+    }
+    BIP_IOCP_Port_Owned = false;
+}
+
+/**
+ * @brief Attach the BACnet/IP sockets to the completion port of an
+ *  event loop. The event loop gives each completion with the key to
+ *  bip_iocp_complete(), and calls bip_receive() with no timeout while
+ *  it returns true.
+ * @param port - the completion port of the event loop
+ * @param key - the completion key of the sockets
+ * @return true if attached, or false if the datalink is not initialized
+ *  or bip_receive() already waits on a completion port of its own
+ */
+bool bip_iocp_attach(HANDLE port, ULONG_PTR key)
+{
+    if (!port) {
+        return false;
+    }
+    if (BIP_IOCP_Port == port) {
+        return true;
+    }
+
+    return bip_iocp_start(port, key);
+}
+
+/**
+ * @brief Start an overlapped send of a copy of the MPDU
+ * @param dest - the destination address
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ * @return the number of bytes, or -1 if every send slot is in use
+ */
+static int bip_iocp_send(
+    const struct sockaddr_in *dest, const uint8_t *mtu, uint16_t mtu_len)
+{
+    struct bip_iocp_slot *slot = NULL;
+    unsigned i;
+    int rv;
+
+    if (!BIP_IOCP_Port || (mtu_len > BIP_MPDU_MAX)) {
+        return -1;
+    }
+    for (i = 0; i < BIP_IOCP_SENDS_MAX; i++) {
+        if (InterlockedCompareExchange(&BIP_IOCP_Send[i].pending, 1, 0) ==
+            0) {
+            slot = &BIP_IOCP_Send[i];
+            break;
+        }
+    }
+    if (!slot) {
+        return -1;
+    }
+    memcpy(slot->buffer, mtu, mtu_len);
+    memset(&slot->overlapped, 0, sizeof(slot->overlapped));
+    slot->socket = BIP_Socket;
+    slot->sin = *dest;
+    slot->wsabuf.buf = (char *)slot->buffer;
+    slot->wsabuf.len = mtu_len;
+    rv = WSASendTo(
+        BIP_Socket, &slot->wsabuf, 1, NULL, 0,
+        (const struct sockaddr *)&slot->sin, sizeof(slot->sin),
+        &slot->overlapped, NULL);
+    if ((rv == SOCKET_ERROR) && (WSAGetLastError() != WSA_IO_PENDING)) {
+        InterlockedExchange(&slot->pending, 0);
+        return -1;
+    }
+
+    return mtu_len;
+}
+#endif
+
 /**
  * @brief Set the BACnet IPv4 UDP port number
  * @param port - IPv4 UDP port number - in host byte order
@@ -436,6 +784,12 @@ int bip_send_mpdu(
     /* Send the packet */
     debug_print_ipv4(
         "Sending MPDU->", &bip_dest.sin_addr, bip_dest.sin_port, mtu_len);
+#if BIP_IOCP
+    rv = bip_iocp_send(&bip_dest, mtu, mtu_len);
+    if (rv >= 0) {
+        return rv;
+    }
+#endif
     rv = sendto(
         BIP_Socket, (const char *)mtu, mtu_len, 0, (struct sockaddr *)&bip_dest,
         sizeof(struct sockaddr));
@@ -446,6 +800,108 @@ int bip_send_mpdu(
     return rv;
 }
 
+/**
+ * The send function for BACnet/IP driver layer to send the same MPDU
+ * to many destinations, such as a BBMD forwarding a broadcast to each
+ * BDT and FDT entry.
+ *
+ * @param dest - array of BACNET_IP_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return the number of destinations the MPDU was sent to
+ */
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+    int sent_count = 0;
+
+    for (i = 0; i < dest_count; i++) {
+        if (bip_send_mpdu(&dest[i], mtu, mtu_len) > 0) {
+            sent_count++;
+        }
+    }
+
+    return sent_count;
+}
+
+/**
+ * @brief Handle a received MPDU in the BVLC layer, and move its NPDU
+ * @param socket - the socket that the MPDU was received from
+ * @param sin - the source address of the MPDU
+ * @param src - returns the source address
+ * @param mpdu - the received MPDU, which is changed
+ * @param mpdu_len - number of bytes received
+ * @param mpdu_size - size of the MPDU buffer
+ * @param npdu - returns the NPDU, which may be the MPDU buffer
+ * @param max_npdu - maximum size of the NPDU buffer
+ * @return Number of bytes in the NPDU, or 0 if none
+ */
+static uint16_t bip_mpdu_handler(
+    SOCKET socket,
+    const struct sockaddr_in *sin,
+    BACNET_ADDRESS *src,
+    uint8_t *mpdu,
+    int mpdu_len,
+    int mpdu_size,
+    uint8_t *npdu,
+    uint16_t max_npdu)
+{
+    BACNET_IP_ADDRESS addr = { 0 };
+    uint16_t npdu_len = 0;
+    int offset = 0;
+    int max = 0;
+
+    /* no problem, just no bytes */
+    if (mpdu_len <= 0) {
+        return 0;
+    }
+    /* the signature of a BACnet/IPv packet */
+    if (mpdu[0] != BVLL_TYPE_BACNET_IP) {
+        return 0;
+    }
+    /* Erase up to 16 bytes after the received bytes as safety margin to
+     * ensure that the decoding functions will run into a 'safe field'
+     * of zero, if for any reason they would overrun, when parsing the
+     * message. */
+    max = mpdu_size - mpdu_len;
+    if (max > 0) {
+        if (max > 16) {
+            max = 16;
+        }
+        memset(&mpdu[mpdu_len], 0, max);
+    }
+    /* Data link layer addressing between B/IPv4 nodes consists of a 32-bit
+       IPv4 address followed by a two-octet UDP port number (both of which
+       shall be transmitted with the most significant octet first). This
+       address shall be referred to as a B/IPv4 address.
+    */
+    memcpy(&addr.address[0], &sin->sin_addr.s_addr, 4);
+    addr.port = ntohs(sin->sin_port);
+    debug_print_ipv4(
+        "Received MPDU->", &sin->sin_addr, sin->sin_port, mpdu_len);
+    /* pass the packet into the BBMD handler */
+    offset = socket == BIP_Socket
+        ? bvlc_handler(&addr, src, mpdu, mpdu_len)
+        : bvlc_broadcast_handler(&addr, src, mpdu, mpdu_len);
+    if (offset > 0) {
+        npdu_len = mpdu_len - offset;
+        if (npdu_len <= max_npdu) {
+            /* shift the buffer to return a valid NPDU */
+            memmove(&npdu[0], &mpdu[offset], npdu_len);
+        } else {
+            npdu_len = 0;
+        }
+    }
+
+    return npdu_len;
+}
+
 /**
  * BACnet/IP Datalink Receive handler.
  *
@@ -455,6 +911,10 @@ int bip_send_mpdu(
  * @param timeout - number of milliseconds to wait for a packet
  *
  * @return Number of bytes received, or 0 if none or timeout.
+ * @note With a completion port, the datagrams of many posted receives
+ *  are taken in one batch, and returned one per call. When the datalink
+ *  is attached to an event loop with bip_iocp_attach(), the event loop
+ *  waits instead, and the timeout is not used.
  */
 uint16_t bip_receive(
     BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
@@ -464,17 +924,38 @@ uint16_t bip_receive(
     int max = 0;
     struct timeval select_timeout;
     struct sockaddr_in sin = { 0 };
-    BACNET_IP_ADDRESS addr = { 0 };
     socklen_t sin_len = sizeof(sin);
     int received_bytes = 0;
-    int offset = 0;
-    uint16_t i = 0;
     SOCKET socket;
+#if BIP_IOCP
+    struct bip_iocp_slot *slot;
+#endif
 
     /* Make sure the socket is open */
     if (BIP_Socket == INVALID_SOCKET) {
         return 0;
     }
+#if BIP_IOCP
+    if (!BIP_IOCP_Port && !BIP_IOCP_Failed) {
+        /* not attached to an event loop: wait on a port of our own */
+        BIP_IOCP_Failed = !bip_iocp_start(NULL, 0);
+    }
+    if (BIP_IOCP_Port) {
+        slot = bip_iocp_ready_pop();
+        if (!slot && BIP_IOCP_Port_Owned) {
+            bip_iocp_wait(BIP_IOCP_Port, timeout);
+            slot = bip_iocp_ready_pop();
+        }
+        if (!slot) {
+            return 0;
+        }
+        npdu_len = bip_mpdu_handler(
+            slot->socket, &slot->sin, src, slot->buffer, (int)slot->length,
+            (int)sizeof(slot->buffer), npdu, max_npdu);
+        (void)bip_iocp_receive_post(slot);
+        return npdu_len;
+    }
+#endif
     /* we could just use a non-blocking socket, but that consumes all
        the CPU time.  We can use a timeout; it is only supported as
        a select. */
@@ -506,51 +987,9 @@ uint16_t bip_receive(
     if (received_bytes < 0) {
         return 0;
     }
-    /* no problem, just no bytes */
-    if (received_bytes == 0) {
-        return 0;
-    }
-    /* the signature of a BACnet/IPv packet */
-    if (npdu[0] != BVLL_TYPE_BACNET_IP) {
-        return 0;
-    }
-    /* Erase up to 16 bytes after the received bytes as safety margin to
-     * ensure that the decoding functions will run into a 'safe field'
-     * of zero, if for any reason they would overrun, when parsing the
-     * message. */
-    max = (int)max_npdu - received_bytes;
-    if (max > 0) {
-        if (max > 16) {
-            max = 16;
-        }
-        memset(&npdu[received_bytes], 0, max);
-    }
-    /* Data link layer addressing between B/IPv4 nodes consists of a 32-bit
-       IPv4 address followed by a two-octet UDP port number (both of which
-       shall be transmitted with the most significant octet first). This
-       address shall be referred to as a B/IPv4 address.
-    */
-    memcpy(&addr.address[0], &sin.sin_addr.s_addr, 4);
-    addr.port = ntohs(sin.sin_port);
-    debug_print_ipv4(
-        "Received MPDU->", &sin.sin_addr, sin.sin_port, received_bytes);
-    /* pass the packet into the BBMD handler */
-    offset = socket == BIP_Socket
-        ? bvlc_handler(&addr, src, npdu, received_bytes)
-        : bvlc_broadcast_handler(&addr, src, npdu, received_bytes);
-    if (offset > 0) {
-        npdu_len = received_bytes - offset;
-        if (npdu_len <= max_npdu) {
-            /* shift the buffer to return a valid NPDU */
-            for (i = 0; i < npdu_len; i++) {
-                npdu[i] = npdu[offset + i];
-            }
-        } else {
-            npdu_len = 0;
-        }
-    }
 
-    return npdu_len;
+    return bip_mpdu_handler(
+        socket, &sin, src, npdu, received_bytes, max_npdu, npdu, max_npdu);
 }
 
 /**
@@ -687,6 +1126,93 @@ int bip_get_local_netmask(struct in_addr *netmask)
     return 0;
 }
 
+/**
+ * @brief Use an IP multicast group for the BACnet broadcasts, as
+ *  described in Annex J.8, instead of the subnet directed broadcast.
+ *  The group is joined on the interface, so that switches that snoop
+ *  IGMP forward the group to this port.
+ * @note Must be called before bip_init()
+ * @param group - multicast group address and UDP port, or NULL or
+ *  an address of 0.0.0.0 to use the subnet directed broadcast
+ * @param ttl - time-to-live of the multicasts, which is 1 to keep them
+ *  on the local subnet, or more to let multicast routers forward them
+ * @return true if the group was set
+ */
+bool bip_set_multicast_group(const BACNET_IP_ADDRESS *group, uint8_t ttl)
+{
+    struct in_addr address = { 0 };
+
+    if (group) {
+        memcpy(&address.s_addr, &group->address[0], 4);
+    }
+    if ((address.s_addr != 0) && !IN_MULTICAST(ntohl(address.s_addr))) {
+        return false;
+    }
+    BIP_Multicast_Group = address;
+    BIP_Multicast_TTL = ttl;
+
+    return true;
+}
+
+/**
+ * @brief Get the IP multicast group that is used for the BACnet broadcasts
+ * @param group - multicast group address and UDP port
+ * @return true if a multicast group is used
+ */
+bool bip_get_multicast_group(BACNET_IP_ADDRESS *group)
+{
+    if (BIP_Multicast_Group.s_addr == 0) {
+        return false;
+    }
+    if (group) {
+        memcpy(&group->address[0], &BIP_Multicast_Group.s_addr, 4);
+        group->port = ntohs(BIP_Port);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Join the multicast group on the socket that receives the
+ *  broadcasts, and send the multicasts from the unicast socket on the
+ *  interface with the configured time-to-live
+ * @return true if the sockets are configured for the multicast group
+ */
+static bool bip_multicast_join(void)
+{
+    struct ip_mreq mreq = { 0 };
+    DWORD ttl = BIP_Multicast_TTL;
+    DWORD loop = 0;
+
+    mreq.imr_multiaddr = BIP_Multicast_Group;
+    mreq.imr_interface = BIP_Address;
+    if (setsockopt(
+            BIP_Broadcast_Socket, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+            (const char *)&mreq, sizeof(mreq)) == SOCKET_ERROR) {
+        print_last_error("IP_ADD_MEMBERSHIP");
+        return false;
+    }
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_IF,
+            (const char *)&BIP_Address, sizeof(BIP_Address)) ==
+        SOCKET_ERROR) {
+        return false;
+    }
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_TTL, (const char *)&ttl,
+            sizeof(ttl)) == SOCKET_ERROR) {
+        return false;
+    }
+    /* our own broadcasts are not received */
+    if (setsockopt(
+            BIP_Socket, IPPROTO_IP, IP_MULTICAST_LOOP, (const char *)&loop,
+            sizeof(loop)) == SOCKET_ERROR) {
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief Set the broadcast socket binding address
  * @param baddr The broadcast socket binding address, in host order.
@@ -837,6 +1363,10 @@ bool bip_init(char *ifname)
     if (BIP_Broadcast_Addr.s_addr == 0) {
         set_broadcast_address(BIP_Address.s_addr);
     }
+    if (BIP_Multicast_Group.s_addr != 0) {
+        /* the BACnet broadcasts are sent to the multicast group */
+        BIP_Broadcast_Addr = BIP_Multicast_Group;
+    }
     if (BIP_Debug) {
         fprintf(stderr, "BIP: Address: %s\n", inet_ntoa(BIP_Address));
         fprintf(
@@ -900,6 +1430,14 @@ bool bip_init(char *ifname)
             return false;
         }
     }
+    if ((BIP_Multicast_Group.s_addr != 0) && !bip_multicast_join()) {
+        fprintf(
+            stderr, "BIP: Failed to join the multicast group %s!\n",
+            inet_ntoa(BIP_Multicast_Group));
+        fflush(stderr);
+        bip_cleanup();
+        return false;
+    }
     bvlc_init();
 
     return true;
@@ -921,6 +1459,10 @@ void bip_cleanup(void)
 {
     SOCKET sock_fd = 0;
 
+#if BIP_IOCP
+    bip_iocp_stop();
+    BIP_IOCP_Failed = false;
+#endif
     if (BIP_Socket != INVALID_SOCKET) {
         sock_fd = BIP_Socket;
         closesocket(sock_fd);
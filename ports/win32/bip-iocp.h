@@ -0,0 +1,53 @@
+/**
+ * @file
+ * @brief BACnet/IP overlapped I/O on a Windows I/O completion port
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_PORT_WIN32_BIP_IOCP_H
+#define BACNET_PORT_WIN32_BIP_IOCP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+#include "bacport.h"
+
+/* GetQueuedCompletionStatusEx() and CancelIoEx() need Windows Vista.
+   Define BIP_IOCP=0 to use the select() receive path only. */
+#ifndef BIP_IOCP
+#if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0600)
+#define BIP_IOCP 1
+#else
+#define BIP_IOCP 0
+#endif
+#endif
+/* number of receives that are posted to the sockets at the same time */
+#ifndef BIP_IOCP_RECEIVES_MAX
+#define BIP_IOCP_RECEIVES_MAX 32
+#endif
+/* number of sends that are in progress at the same time. When all are
+   in progress, a send waits for the socket like before. */
+#ifndef BIP_IOCP_SENDS_MAX
+#define BIP_IOCP_SENDS_MAX 16
+#endif
+/* number of completions that are taken from the port with one call */
+#ifndef BIP_IOCP_BATCH
+#define BIP_IOCP_BATCH 16
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#if BIP_IOCP
+BACNET_STACK_EXPORT
+bool bip_iocp_attach(HANDLE port, ULONG_PTR key);
+BACNET_STACK_EXPORT
+bool bip_iocp_complete(LPOVERLAPPED overlapped);
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
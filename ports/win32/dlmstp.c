@@ -472,11 +472,12 @@ void dlmstp_set_max_info_frames(uint8_t max_info_frames)
 
 /**
  * @brief Get the MSTP max-info-frames value
- * @return the MSTP max-info-frames value
+ * @return the MSTP max-info-frames value, which is the value chosen
+ *  by the adaptive tuning when it is enabled
  */
 uint8_t dlmstp_max_info_frames(void)
 {
-    return MSTP_Port.Nmax_info_frames;
+    return MSTP_Max_Info_Frames(&MSTP_Port);
 }
 
 /**
@@ -501,11 +502,12 @@ void dlmstp_set_max_master(uint8_t max_master)
 
 /**
  * @brief Get the largest peer MAC address that we will seek
- * @return largest peer MAC address
+ * @return largest peer MAC address, which is the value chosen
+ *  by the adaptive tuning when it is enabled
  */
 uint8_t dlmstp_max_master(void)
 {
-    return MSTP_Port.Nmax_master;
+    return MSTP_Max_Master(&MSTP_Port);
 }
 
 /**
@@ -632,6 +634,38 @@ bool dlmstp_check_auto_baud_set(bool flag)
     return true;
 }
 
+/**
+ * @brief Get the MSTP port AdaptiveEnabled status
+ * @return true if the MSTP port has AdaptiveEnabled
+ */
+bool dlmstp_adaptive_enabled(void)
+{
+    return MSTP_Port.AdaptiveEnabled;
+}
+
+/**
+ * @brief Set the MSTP port AdaptiveEnabled flag
+ * @param flag - true if the MSTP port has AdaptiveEnabled
+ * @return true if the MSTP port AdaptiveEnabled was set
+ * @note This flag is used to enable the adaptive tuning of the MSTP port.
+ *  The max-info-frames value set for the port is raised, up to the number
+ *  of PDUs in the transmit queue, while the queue keeps the node busy for
+ *  its whole token. The Poll For Master sweeps stop at the highest master
+ *  node on the network, and go up to the max-master value set for the port
+ *  every MSTP_ADAPTIVE_SWEEPS sweeps to find new master nodes.
+ */
+bool dlmstp_adaptive_enabled_set(bool flag)
+{
+    MSTP_Port.AdaptiveEnabled = flag;
+    MSTP_Port.Adaptive_Max_Info_Frames = MSTP_PDU_PACKET_COUNT;
+    MSTP_Port.Adaptive_Info_Frames = MSTP_Port.Nmax_info_frames;
+    MSTP_Port.Adaptive_Idle_Tokens = 0;
+    MSTP_Port.Adaptive_Max_Master_Seen = MSTP_Port.This_Station;
+    MSTP_Port.Adaptive_Sweep_Count = 0;
+
+    return true;
+}
+
 /**
  * @brief Get the MSTP port MAC address that this node prefers to use.
  * @return ZeroConfigStation value, or an out-of-range value if invalid
@@ -0,0 +1,640 @@
+/**
+ * @file
+ * @brief Windows event loop for datalink sockets, events, and timers
+ *
+ * One I/O completion port waits for every registered source, so an
+ * application gets a single wakeup for the overlapped receives and
+ * sends of the BACnet/IP sockets, signals from other threads, and
+ * periodic timers, instead of polling each datalink with a receive
+ * timeout. Other sockets, and datalinks that do not use the completion
+ * port, are polled with select() between the waits.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/datalink.h"
+#include "bacport.h"
+#if defined(BACDL_BIP)
+#include "bip-iocp.h"
+#endif
+#include "reactor.h"
+
+/* number of NPDUs received from the datalink before other events */
+#ifndef REACTOR_DATALINK_BATCH
+#define REACTOR_DATALINK_BATCH 16
+#endif
+/* milliseconds between polls of sockets, and of datalinks that do
+   not use the completion port */
+#ifndef REACTOR_POLL_INTERVAL
+#define REACTOR_POLL_INTERVAL 10
+#endif
+/* completion keys of the completion port */
+#define REACTOR_KEY_EVENT 1
+#define REACTOR_KEY_DATALINK 2
+
+typedef enum reactor_type {
+    REACTOR_TYPE_NONE = 0,
+    REACTOR_TYPE_FD,
+    REACTOR_TYPE_TIMER,
+    REACTOR_TYPE_EVENT
+} REACTOR_TYPE;
+
+struct reactor_entry {
+    int fd;
+    REACTOR_TYPE type;
+    reactor_callback callback;
+    void *context;
+    /* timer interval, and the time that it expires next */
+    unsigned long interval;
+    ULONGLONG expires;
+    /* the event has a completion in the queue of the port */
+    volatile LONG signaled;
+};
+static struct reactor_entry Reactor_List[REACTOR_MAX_ENTRIES];
+static HANDLE Reactor_Port;
+/* the next identifier of a timer or an event */
+static int Reactor_Next_FD = 1;
+/* event used by reactor_stop() to wake up reactor_run() */
+static int Reactor_Stop_Event = -1;
+static bool Reactor_Running;
+/* the datalink NPDUs are received into */
+static struct reactor_datalink {
+    uint8_t *pdu;
+    uint16_t max_pdu;
+    datalink_receive_handler handler;
+    BACNET_ADDRESS src;
+    int event;
+    int timer;
+} Reactor_Datalink;
+
+/**
+ * @brief Find the entry for a socket, timer, or event
+ * @param fd - socket, timer, or event
+ * @return the entry, or NULL if not found
+ */
+static struct reactor_entry *reactor_entry_find(int fd)
+{
+    unsigned i;
+
+    if (fd < 0) {
+        return NULL;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if ((Reactor_List[i].type != REACTOR_TYPE_NONE) &&
+            (Reactor_List[i].fd == fd)) {
+            return &Reactor_List[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add an entry
+ * @param fd - socket, timer, or event
+ * @param type - type of entry
+ * @param callback - function called when the entry is ready
+ * @param context - passed to the callback
+ * @return the entry, or NULL if not added
+ */
+static struct reactor_entry *reactor_entry_add(
+    int fd, REACTOR_TYPE type, reactor_callback callback, void *context)
+{
+    unsigned i;
+
+    if (!Reactor_Port || (fd < 0) || !callback) {
+        return NULL;
+    }
+    if (reactor_entry_find(fd)) {
+        return NULL;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if (Reactor_List[i].type == REACTOR_TYPE_NONE) {
+            break;
+        }
+    }
+    if (i == REACTOR_MAX_ENTRIES) {
+        return NULL;
+    }
+    Reactor_List[i].fd = fd;
+    Reactor_List[i].callback = callback;
+    Reactor_List[i].context = context;
+    Reactor_List[i].interval = 0;
+    Reactor_List[i].expires = 0;
+    Reactor_List[i].signaled = 0;
+    Reactor_List[i].type = type;
+
+    return &Reactor_List[i];
+}
+
+/**
+ * @brief Remove an entry
+ * @param entry - the entry to remove
+ */
+static void reactor_entry_remove(struct reactor_entry *entry)
+{
+    entry->type = REACTOR_TYPE_NONE;
+    entry->fd = -1;
+    entry->callback = NULL;
+    entry->context = NULL;
+}
+
+/**
+ * @brief Get an identifier for a new timer or event, which is not
+ *  the same as a socket or another timer or event
+ * @return the identifier
+ */
+static int reactor_fd_next(void)
+{
+    int fd;
+
+    do {
+        fd = Reactor_Next_FD;
+        if (Reactor_Next_FD == INT32_MAX) {
+            Reactor_Next_FD = 1;
+        } else {
+            Reactor_Next_FD++;
+        }
+    } while (reactor_entry_find(fd));
+
+    return fd;
+}
+
+/**
+ * @brief The reactor_stop() event was signaled
+ * @param fd - the event
+ * @param context - not used
+ */
+static void reactor_stop_handler(int fd, void *context)
+{
+    (void)fd;
+    (void)context;
+    Reactor_Running = false;
+}
+
+/**
+ * @brief Initialize the event loop
+ * @return true if the event loop is ready
+ */
+bool reactor_init(void)
+{
+    unsigned i;
+
+    if (Reactor_Port) {
+        return true;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        Reactor_List[i].fd = -1;
+        Reactor_List[i].type = REACTOR_TYPE_NONE;
+        Reactor_List[i].callback = NULL;
+        Reactor_List[i].context = NULL;
+    }
+    Reactor_Datalink.event = -1;
+    Reactor_Datalink.timer = -1;
+    Reactor_Port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (!Reactor_Port) {
+        return false;
+    }
+    Reactor_Stop_Event = reactor_event_add(reactor_stop_handler, NULL);
+    if (Reactor_Stop_Event < 0) {
+        reactor_cleanup();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove everything from the event loop, and close the timers
+ *  and events that it created
+ * @note A BACnet/IP datalink that was attached to the completion port
+ *  keeps its receives posted to it, so call bip_cleanup() first.
+ */
+void reactor_cleanup(void)
+{
+    unsigned i;
+    HANDLE port;
+
+    if (!Reactor_Port) {
+        return;
+    }
+    reactor_datalink_remove();
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if (Reactor_List[i].type != REACTOR_TYPE_NONE) {
+            reactor_close(Reactor_List[i].fd);
+        }
+    }
+    Reactor_Stop_Event = -1;
+    Reactor_Running = false;
+    port = Reactor_Port;
+    Reactor_Port = NULL;
+    CloseHandle(port);
+}
+
+/**
+ * @brief Add a socket, such as a datalink socket, that calls back when
+ *  it is readable. Sockets are polled between the waits, at least every
+ *  REACTOR_POLL_INTERVAL milliseconds.
+ * @param fd - socket, which is still owned by the caller
+ * @param callback - function called when the socket is readable
+ * @param context - passed to the callback
+ * @return true if added
+ */
+bool reactor_fd_add(int fd, reactor_callback callback, void *context)
+{
+    return (reactor_entry_add(fd, REACTOR_TYPE_FD, callback, context) != NULL);
+}
+
+/**
+ * @brief Remove a socket without closing it
+ * @param fd - socket
+ * @return true if removed
+ */
+bool reactor_fd_remove(int fd)
+{
+    struct reactor_entry *entry;
+
+    entry = reactor_entry_find(fd);
+    if (!entry || (entry->type != REACTOR_TYPE_FD)) {
+        return false;
+    }
+    reactor_entry_remove(entry);
+
+    return true;
+}
+
+/**
+ * @brief Add a periodic timer
+ * @param milliseconds - interval between callbacks, greater than zero
+ * @param callback - function called each time the timer expires
+ * @param context - passed to the callback
+ * @return the timer, or -1 on error
+ */
+int reactor_timer_add(
+    unsigned long milliseconds, reactor_callback callback, void *context)
+{
+    struct reactor_entry *entry;
+
+    if (!Reactor_Port || (milliseconds == 0) || !callback) {
+        return -1;
+    }
+    entry = reactor_entry_add(
+        reactor_fd_next(), REACTOR_TYPE_TIMER, callback, context);
+    if (!entry) {
+        return -1;
+    }
+    entry->interval = milliseconds;
+    entry->expires = GetTickCount64() + milliseconds;
+
+    return entry->fd;
+}
+
+/**
+ * @brief Add an event that another thread, or a callback, can signal
+ *  with reactor_event_signal() to wake up the event loop
+ * @param callback - function called after the event is signaled
+ * @param context - passed to the callback
+ * @return the event, or -1 on error
+ */
+int reactor_event_add(reactor_callback callback, void *context)
+{
+    struct reactor_entry *entry;
+
+    if (!Reactor_Port || !callback) {
+        return -1;
+    }
+    entry = reactor_entry_add(
+        reactor_fd_next(), REACTOR_TYPE_EVENT, callback, context);
+    if (!entry) {
+        return -1;
+    }
+
+    return entry->fd;
+}
+
+/**
+ * @brief Signal an event. Safe to call from any thread.
+ * @param fd - the event from reactor_event_add()
+ * @return true if signaled
+ */
+bool reactor_event_signal(int fd)
+{
+    struct reactor_entry *entry;
+
+    entry = reactor_entry_find(fd);
+    if (!entry || (entry->type != REACTOR_TYPE_EVENT)) {
+        return false;
+    }
+    /* signals before the wait are combined into one callback */
+    if (InterlockedExchange(&entry->signaled, 1) != 0) {
+        return true;
+    }
+    if (!PostQueuedCompletionStatus(
+            Reactor_Port, 0, REACTOR_KEY_EVENT,
+            (LPOVERLAPPED)(ULONG_PTR)fd)) {
+        InterlockedExchange(&entry->signaled, 0);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove a socket, timer, or event. Timers and events that were
+ *  created by the event loop are closed; sockets are not.
+ * @param fd - socket, timer, or event
+ */
+void reactor_close(int fd)
+{
+    struct reactor_entry *entry;
+
+    entry = reactor_entry_find(fd);
+    if (!entry) {
+        return;
+    }
+    /* a completion of a signaled event that is still in the queue
+       of the port is ignored, since the entry is not found */
+    reactor_entry_remove(entry);
+}
+
+/**
+ * @brief Get the number of milliseconds to wait on the completion port
+ * @param timeout - milliseconds to wait, or -1 to wait forever
+ * @return milliseconds until the first timer, socket poll, or timeout
+ */
+static DWORD reactor_wait_time(int timeout)
+{
+    ULONGLONG now;
+    DWORD wait;
+    DWORD next;
+    unsigned i;
+
+    wait = (timeout < 0) ? INFINITE : (DWORD)timeout;
+    now = GetTickCount64();
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        next = wait;
+        if (Reactor_List[i].type == REACTOR_TYPE_TIMER) {
+            if (Reactor_List[i].expires <= now) {
+                next = 0;
+            } else {
+                next = (DWORD)(Reactor_List[i].expires - now);
+            }
+        } else if (Reactor_List[i].type == REACTOR_TYPE_FD) {
+            next = REACTOR_POLL_INTERVAL;
+        }
+        if (next < wait) {
+            wait = next;
+        }
+    }
+
+    return wait;
+}
+
+/**
+ * @brief Call back for each socket that is readable
+ * @return number of callbacks
+ */
+static int reactor_fd_poll(void)
+{
+    struct timeval select_timeout = { 0 };
+    fd_set read_fds;
+    unsigned i;
+    int count = 0;
+
+    FD_ZERO(&read_fds);
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        if (Reactor_List[i].type == REACTOR_TYPE_FD) {
+            FD_SET((SOCKET)Reactor_List[i].fd, &read_fds);
+        }
+    }
+    if (read_fds.fd_count == 0) {
+        return 0;
+    }
+    if (select(0, &read_fds, NULL, NULL, &select_timeout) <= 0) {
+        return 0;
+    }
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        /* an earlier callback may have removed the entry */
+        if ((Reactor_List[i].type == REACTOR_TYPE_FD) &&
+            FD_ISSET((SOCKET)Reactor_List[i].fd, &read_fds)) {
+            Reactor_List[i].callback(
+                Reactor_List[i].fd, Reactor_List[i].context);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Call back for each timer that expired
+ * @return number of callbacks
+ */
+static int reactor_timer_expired(void)
+{
+    struct reactor_entry *entry;
+    ULONGLONG now;
+    unsigned i;
+    int count = 0;
+
+    now = GetTickCount64();
+    for (i = 0; i < REACTOR_MAX_ENTRIES; i++) {
+        entry = &Reactor_List[i];
+        if ((entry->type != REACTOR_TYPE_TIMER) || (entry->expires > now)) {
+            continue;
+        }
+        /* expirations that were missed are combined into one */
+        entry->expires += entry->interval;
+        if (entry->expires <= now) {
+            entry->expires = now + entry->interval;
+        }
+        entry->callback(entry->fd, entry->context);
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Receive a batch of NPDUs from the datalink
+ * @param fd - the datalink event or timer
+ * @param context - not used
+ */
+static void reactor_datalink_receive(int fd, void *context)
+{
+    unsigned count;
+
+    (void)fd;
+    (void)context;
+    if (!Reactor_Datalink.handler) {
+        return;
+    }
+    count = datalink_receive_batch(
+        &Reactor_Datalink.src, Reactor_Datalink.pdu, Reactor_Datalink.max_pdu,
+        0, REACTOR_DATALINK_BATCH, Reactor_Datalink.handler);
+    if (count >= REACTOR_DATALINK_BATCH) {
+        /* more may be waiting in the datalink buffers, so come back
+           after the other completions are handled */
+        (void)reactor_event_signal(Reactor_Datalink.event);
+    }
+}
+
+/**
+ * @brief Wait for the completions, timers, events, and sockets, and
+ *  call back for each one that is ready
+ * @param timeout - milliseconds to wait, or -1 to wait forever
+ * @return number of callbacks, or -1 on error
+ */
+int reactor_run_once(int timeout)
+{
+    OVERLAPPED_ENTRY entries[REACTOR_MAX_ENTRIES];
+    struct reactor_entry *entry;
+    bool datalink = false;
+    ULONG n = 0;
+    ULONG i;
+    int count = 0;
+    int fd;
+
+    if (!Reactor_Port) {
+        return -1;
+    }
+    if (!GetQueuedCompletionStatusEx(
+            Reactor_Port, entries, REACTOR_MAX_ENTRIES, &n,
+            reactor_wait_time(timeout), FALSE)) {
+        if (GetLastError() != WAIT_TIMEOUT) {
+            return -1;
+        }
+        n = 0;
+    }
+    for (i = 0; i < n; i++) {
+        if (entries[i].lpCompletionKey == REACTOR_KEY_EVENT) {
+            fd = (int)(ULONG_PTR)entries[i].lpOverlapped;
+            entry = reactor_entry_find(fd);
+            if (!entry || (entry->type != REACTOR_TYPE_EVENT)) {
+                /* closed by an earlier callback */
+                continue;
+            }
+            /* clear the signal before the callback, so that any
+               that happen during the callback are kept */
+            InterlockedExchange(&entry->signaled, 0);
+            entry->callback(fd, entry->context);
+            count++;
+        }
+#if defined(BACDL_BIP) && BIP_IOCP
+        else if (entries[i].lpCompletionKey == REACTOR_KEY_DATALINK) {
+            /* receives and sends of the BACnet/IP sockets */
+            if (bip_iocp_complete(entries[i].lpOverlapped)) {
+                datalink = true;
+            }
+        }
+#endif
+    }
+    if (datalink && Reactor_Datalink.handler) {
+        /* one batch for all of the datagrams of this wait */
+        reactor_datalink_receive(Reactor_Datalink.event, NULL);
+        count++;
+    }
+    count += reactor_fd_poll();
+    count += reactor_timer_expired();
+
+    return count;
+}
+
+/**
+ * @brief Run the event loop until reactor_stop() is called
+ */
+void reactor_run(void)
+{
+    Reactor_Running = true;
+    while (Reactor_Running) {
+        if (reactor_run_once(-1) < 0) {
+            break;
+        }
+    }
+    Reactor_Running = false;
+}
+
+/**
+ * @brief Stop reactor_run(). Safe to call from any thread.
+ */
+void reactor_stop(void)
+{
+    (void)reactor_event_signal(Reactor_Stop_Event);
+}
+
+/**
+ * @brief Attach the initialized datalinks, so that each received NPDU
+ *  is passed to the handler, such as npdu_handler().
+ *
+ * The BACnet/IP sockets are attached to the completion port of the
+ * event loop, so each batch of received datagrams wakes it up. The
+ * other datalinks, and BACnet/IP when bip_receive() was already
+ * called before, are polled every REACTOR_POLL_INTERVAL milliseconds.
+ * The datalink must be initialized first.
+ *
+ * @param pdu - buffer for each received NPDU
+ * @param max_pdu - size of the buffer
+ * @param handler - function called with each NPDU
+ * @return true if added
+ */
+bool reactor_datalink_add(
+    uint8_t *pdu, uint16_t max_pdu, datalink_receive_handler handler)
+{
+    bool poll = false;
+
+    if (!Reactor_Port || !pdu || !handler) {
+        return false;
+    }
+    reactor_datalink_remove();
+    Reactor_Datalink.pdu = pdu;
+    Reactor_Datalink.max_pdu = max_pdu;
+    Reactor_Datalink.handler = handler;
+    Reactor_Datalink.event = reactor_event_add(reactor_datalink_receive, NULL);
+    if (Reactor_Datalink.event < 0) {
+        Reactor_Datalink.handler = NULL;
+        return false;
+    }
+#if defined(BACDL_BIP) && BIP_IOCP
+    poll = !bip_iocp_attach(Reactor_Port, REACTOR_KEY_DATALINK);
+#elif defined(BACDL_BIP)
+    poll = true;
+#endif
+#if defined(BACDL_BIP6) || defined(BACDL_ETHERNET) || \
+    defined(BACDL_ARCNET) || defined(BACDL_MSTP) || defined(BACDL_BSC)
+    poll = true;
+#endif
+    if (poll) {
+        Reactor_Datalink.timer = reactor_timer_add(
+            REACTOR_POLL_INTERVAL, reactor_datalink_receive, NULL);
+        if (Reactor_Datalink.timer < 0) {
+            reactor_datalink_remove();
+            return false;
+        }
+    }
+    /* receive anything that arrived before the datalink was added */
+    (void)reactor_event_signal(Reactor_Datalink.event);
+
+    return true;
+}
+
+/**
+ * @brief Remove the datalinks from the event loop
+ */
+void reactor_datalink_remove(void)
+{
+    if (Reactor_Datalink.timer >= 0) {
+        reactor_close(Reactor_Datalink.timer);
+        Reactor_Datalink.timer = -1;
+    }
+    if (Reactor_Datalink.event >= 0) {
+        reactor_close(Reactor_Datalink.event);
+        Reactor_Datalink.event = -1;
+    }
+    Reactor_Datalink.handler = NULL;
+}
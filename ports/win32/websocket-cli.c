@@ -50,8 +50,25 @@ typedef struct {
     size_t fragment_buffer_len;
     char err_desc[BSC_WEBSOCKET_ERR_DESC_STR_MAX_LEN];
     BACNET_ERROR_CODE err_code;
+#if defined(LWS_WITH_TLS_SESSIONS)
+    char host[BSC_WSURL_MAX_LEN];
+    int port;
+#endif
 } BSC_WEBSOCKET_CONNECTION;
 
+#if defined(LWS_WITH_TLS_SESSIONS)
+/* Each connection has its own lws context, and so its own TLS session
+   cache, which is gone with the context. The session of each host is
+   kept here, so that the next connection to the host, after a reconnect
+   or a failover, resumes it instead of a full TLS handshake. */
+typedef struct {
+    char host[BSC_WSURL_MAX_LEN];
+    int port;
+    uint8_t *blob;
+    size_t blob_len;
+} BSC_WEBSOCKET_TLS_SESSION;
+#endif
+
 /* Some forward function declarations */
 
 static int bws_cli_websocket_event(
@@ -86,6 +103,89 @@ static BSC_WEBSOCKET_CONNECTION bws_cli_conn[BSC_CLIENT_WEBSOCKETS_MAX_NUM] = {
     0
 };
 
+#if defined(LWS_WITH_TLS_SESSIONS)
+static BSC_WEBSOCKET_TLS_SESSION
+    bws_cli_tls_session[BSC_CLIENT_WEBSOCKETS_MAX_NUM] = { 0 };
+static unsigned int bws_cli_tls_session_next;
+
+static BSC_WEBSOCKET_TLS_SESSION *
+bws_cli_tls_session_find(const char *host, int port, bool add)
+{
+    BSC_WEBSOCKET_TLS_SESSION *s = NULL;
+    int i;
+
+    for (i = 0; i < BSC_CLIENT_WEBSOCKETS_MAX_NUM; i++) {
+        if (bws_cli_tls_session[i].blob &&
+            bws_cli_tls_session[i].port == port &&
+            strcmp(bws_cli_tls_session[i].host, host) == 0) {
+            return &bws_cli_tls_session[i];
+        }
+        if (!s && !bws_cli_tls_session[i].blob) {
+            s = &bws_cli_tls_session[i];
+        }
+    }
+    if (!add) {
+        return NULL;
+    }
+    if (!s) {
+        /* replace the sessions in turn */
+        s = &bws_cli_tls_session[bws_cli_tls_session_next];
+        bws_cli_tls_session_next =
+            (bws_cli_tls_session_next + 1) % BSC_CLIENT_WEBSOCKETS_MAX_NUM;
+    }
+    snprintf(s->host, sizeof(s->host), "%s", host);
+    s->port = port;
+
+    return s;
+}
+
+static int bws_cli_tls_session_save(
+    struct lws_context *cx, struct lws_tls_session_dump *info)
+{
+    BSC_WEBSOCKET_CONNECTION *conn = (BSC_WEBSOCKET_CONNECTION *)info->opaque;
+    BSC_WEBSOCKET_TLS_SESSION *s;
+    uint8_t *blob;
+
+    (void)cx;
+    s = bws_cli_tls_session_find(conn->host, conn->port, true);
+    blob = realloc(s->blob, info->blob_len);
+    if (!blob) {
+        return 1;
+    }
+    memcpy(blob, info->blob, info->blob_len);
+    s->blob = blob;
+    s->blob_len = info->blob_len;
+    DEBUG_PRINTF(
+        "bws_cli_tls_session_save() saved %d bytes for %s:%d\n",
+        s->blob_len, s->host, s->port);
+    return 0;
+}
+
+static int bws_cli_tls_session_load(
+    struct lws_context *cx, struct lws_tls_session_dump *info)
+{
+    BSC_WEBSOCKET_CONNECTION *conn = (BSC_WEBSOCKET_CONNECTION *)info->opaque;
+    BSC_WEBSOCKET_TLS_SESSION *s;
+
+    (void)cx;
+    s = bws_cli_tls_session_find(conn->host, conn->port, false);
+    if (!s) {
+        return 1;
+    }
+    /* libwebsockets frees the copy after it is deserialized */
+    info->blob = malloc(s->blob_len);
+    if (!info->blob) {
+        return 1;
+    }
+    memcpy(info->blob, s->blob, s->blob_len);
+    info->blob_len = s->blob_len;
+    DEBUG_PRINTF(
+        "bws_cli_tls_session_load() resume session of %s:%d\n", s->host,
+        s->port);
+    return 0;
+}
+#endif
+
 static BSC_WEBSOCKET_HANDLE bws_cli_alloc_connection(void)
 {
     int i;
@@ -237,6 +337,12 @@ static int bws_cli_websocket_event(
             }
 
             DEBUG_PRINTF("bws_cli_websocket_event() connection established\n");
+#if defined(LWS_WITH_TLS_SESSIONS)
+            (void)lws_tls_session_dump_save(
+                lws_get_vhost(wsi), bws_cli_conn[h].host,
+                (uint16_t)bws_cli_conn[h].port, bws_cli_tls_session_save,
+                &bws_cli_conn[h]);
+#endif
             bws_cli_conn[h].state = BSC_WEBSOCKET_STATE_CONNECTED;
             dispatch_func = bws_cli_conn[h].dispatch_func;
             user_param = bws_cli_conn[h].user_param;
@@ -284,7 +390,8 @@ static int bws_cli_websocket_event(
                         "bws_cli_websocket_event() alloc %d bytes for "
                         "socket %d\n",
                         len, h);
-                    bws_cli_conn[h].fragment_buffer = malloc(BSC_RX_BUFFER_LEN);
+                    bws_cli_conn[h].fragment_buffer =
+                        malloc(BSC_WEBSOCKET_RX_PRE + BSC_RX_BUFFER_LEN);
                     if (!bws_cli_conn[h].fragment_buffer) {
                         lws_close_reason(
                             wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, NULL, 0);
@@ -307,7 +414,8 @@ static int bws_cli_websocket_event(
                         bws_cli_conn[h].fragment_buffer_len + len);
                     bws_cli_conn[h].fragment_buffer = realloc(
                         bws_cli_conn[h].fragment_buffer,
-                        bws_cli_conn[h].fragment_buffer_len + len);
+                        BSC_WEBSOCKET_RX_PRE +
+                            bws_cli_conn[h].fragment_buffer_len + len);
                     if (!bws_cli_conn[h].fragment_buffer) {
                         lws_close_reason(
                             wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, NULL, 0);
@@ -326,8 +434,9 @@ static int bws_cli_websocket_event(
                     "socket %d\n",
                     len, h);
                 memcpy(
-                    &bws_cli_conn[h]
-                         .fragment_buffer[bws_cli_conn[h].fragment_buffer_len],
+                    &bws_cli_conn[h].fragment_buffer
+                         [BSC_WEBSOCKET_RX_PRE +
+                          bws_cli_conn[h].fragment_buffer_len],
                     in, len);
                 bws_cli_conn[h].fragment_buffer_len += len;
 
@@ -339,7 +448,7 @@ static int bws_cli_websocket_event(
                     bsc_mutex_unlock(&bws_cli_mutex);
                     dispatch_func(
                         h, BSC_WEBSOCKET_RECEIVED, 0, NULL,
-                        &bws_cli_conn[h].fragment_buffer[0],
+                        &bws_cli_conn[h].fragment_buffer[BSC_WEBSOCKET_RX_PRE],
                         bws_cli_conn[h].fragment_buffer_len, user_param);
                     bsc_mutex_lock(&bws_cli_mutex);
                     bws_cli_conn[h].fragment_buffer_len = 0;
@@ -523,6 +632,9 @@ BSC_WEBSOCKET_RET bws_cli_connect(
     int port = -1;
     BSC_WEBSOCKET_HANDLE h;
     struct lws_client_connect_info cinfo;
+#if defined(LWS_WITH_TLS_SESSIONS)
+    struct lws_vhost *vh;
+#endif
     HANDLE thread;
     size_t len;
 
@@ -616,6 +728,17 @@ BSC_WEBSOCKET_RET bws_cli_connect(
     }
 
     bws_cli_conn[h].ws = NULL;
+#if defined(LWS_WITH_TLS_SESSIONS)
+    snprintf(
+        bws_cli_conn[h].host, sizeof(bws_cli_conn[h].host), "%s", addr);
+    bws_cli_conn[h].port = port;
+    vh = lws_get_vhost_by_name(bws_cli_conn[h].ctx, "default");
+    if (vh) {
+        (void)lws_tls_session_dump_load(
+            vh, addr, (uint16_t)port, bws_cli_tls_session_load,
+            &bws_cli_conn[h]);
+    }
+#endif
     cinfo.context = bws_cli_conn[h].ctx;
     cinfo.address = addr;
     cinfo.origin = cinfo.address;
@@ -243,13 +243,17 @@ static bool bws_validate_ctx_pointer(BSC_WEBSOCKET_CONTEXT *ctx)
 }
 #endif
 
+/* number of connections of the servers, limited to the static tables */
+static int bws_srv_connections_num[BSC_WEBSOCKET_PROTOCOLS_AMOUNT] = {
+    BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM, BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM
+};
+
 static int bws_srv_get_max_sockets(BSC_WEBSOCKET_PROTOCOL proto)
 {
     int max = 0;
-    if (proto == BSC_WEBSOCKET_HUB_PROTOCOL) {
-        max = BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM;
-    } else if (proto == BSC_WEBSOCKET_DIRECT_PROTOCOL) {
-        max = BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM;
+    if (proto == BSC_WEBSOCKET_HUB_PROTOCOL ||
+        proto == BSC_WEBSOCKET_DIRECT_PROTOCOL) {
+        max = bws_srv_connections_num[proto];
     }
     return max;
 }
@@ -429,7 +433,7 @@ static int bws_srv_websocket_event(
                 } else {
                     if (!ctx->conn[h].fragment_buffer) {
                         ctx->conn[h].fragment_buffer =
-                            malloc(BSC_RX_BUFFER_LEN);
+                            malloc(BSC_WEBSOCKET_RX_PRE + BSC_RX_BUFFER_LEN);
                         if (!ctx->conn[h].fragment_buffer) {
                             lws_close_reason(
                                 wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, NULL,
@@ -455,7 +459,8 @@ static int bws_srv_websocket_event(
 
                         ctx->conn[h].fragment_buffer = realloc(
                             ctx->conn[h].fragment_buffer,
-                            ctx->conn[h].fragment_buffer_len + len);
+                            BSC_WEBSOCKET_RX_PRE +
+                                ctx->conn[h].fragment_buffer_len + len);
                         if (!ctx->conn[h].fragment_buffer) {
                             lws_close_reason(
                                 wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, NULL,
@@ -475,8 +480,9 @@ static int bws_srv_websocket_event(
                         "socket %d total_len %d\n",
                         len, h, ctx->conn[h].fragment_buffer_len);
                     memcpy(
-                        &ctx->conn[h]
-                             .fragment_buffer[ctx->conn[h].fragment_buffer_len],
+                        &ctx->conn[h].fragment_buffer
+                             [BSC_WEBSOCKET_RX_PRE +
+                              ctx->conn[h].fragment_buffer_len],
                         in, len);
                     ctx->conn[h].fragment_buffer_len += len;
                     if (lws_is_final_fragment(wsi) && !ctx->stop_worker) {
@@ -486,7 +492,7 @@ static int bws_srv_websocket_event(
                         dispatch_func(
                             (BSC_WEBSOCKET_SRV_HANDLE)ctx, h,
                             BSC_WEBSOCKET_RECEIVED, 0, NULL,
-                            &ctx->conn[h].fragment_buffer[0],
+                            &ctx->conn[h].fragment_buffer[BSC_WEBSOCKET_RX_PRE],
                             ctx->conn[h].fragment_buffer_len, user_param);
                         bsc_mutex_lock(&ctx->mutex);
                         ctx->conn[h].fragment_buffer_len = 0;
@@ -667,6 +673,26 @@ static DWORD WINAPI bws_srv_worker(LPVOID arg)
     return 0;
 }
 
+void bws_srv_connections_set(BSC_WEBSOCKET_PROTOCOL proto, int num)
+{
+    if (num < 0) {
+        return;
+    }
+    bsc_mutex_lock(&bws_global_mutex);
+    if (proto == BSC_WEBSOCKET_HUB_PROTOCOL) {
+        bws_srv_connections_num[proto] =
+            (num < BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM)
+            ? num
+            : BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM;
+    } else if (proto == BSC_WEBSOCKET_DIRECT_PROTOCOL) {
+        bws_srv_connections_num[proto] =
+            (num < BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM)
+            ? num
+            : BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM;
+    }
+    bsc_mutex_unlock(&bws_global_mutex);
+}
+
 BSC_WEBSOCKET_RET bws_srv_start(
     BSC_WEBSOCKET_PROTOCOL proto,
     int port,
@@ -97,6 +97,38 @@ bool bacnet_address_same(const BACNET_ADDRESS *dest, const BACNET_ADDRESS *src)
     return true;
 }
 
+/**
+ * @brief Compute a 32-bit FNV-1a hash of a #BACNET_ADDRESS value
+ *  from the same fields that bacnet_address_same() compares, so that
+ *  the same addresses always have the same hash
+ * @param address - #BACNET_ADDRESS to be hashed
+ * @return hash value
+ */
+uint32_t bacnet_address_hash(const BACNET_ADDRESS *address)
+{
+    uint32_t hash = 2166136261UL;
+    uint8_t i;
+
+    if (!address) {
+        return hash;
+    }
+    hash = (hash ^ address->mac_len) * 16777619UL;
+    for (i = 0; (i < address->mac_len) && (i < MAX_MAC_LEN); i++) {
+        hash = (hash ^ address->mac[i]) * 16777619UL;
+    }
+    hash = (hash ^ (address->net >> 8)) * 16777619UL;
+    hash = (hash ^ (address->net & 0xFF)) * 16777619UL;
+    /* if local, ignore remaining fields */
+    if (address->net) {
+        hash = (hash ^ address->len) * 16777619UL;
+        for (i = 0; (i < address->len) && (i < MAX_MAC_LEN); i++) {
+            hash = (hash ^ address->adr[i]) * 16777619UL;
+        }
+    }
+
+    return hash;
+}
+
 /**
  * @brief Compare two BACnetAddress strictly from encoding based
  *  on network number.
@@ -50,6 +50,8 @@ void bacnet_address_copy(BACNET_ADDRESS *dest, const BACNET_ADDRESS *src);
 BACNET_STACK_EXPORT
 bool bacnet_address_same(const BACNET_ADDRESS *dest, const BACNET_ADDRESS *src);
 BACNET_STACK_EXPORT
+uint32_t bacnet_address_hash(const BACNET_ADDRESS *address);
+BACNET_STACK_EXPORT
 bool bacnet_address_net_same(
     const BACNET_ADDRESS *dest, const BACNET_ADDRESS *src);
 BACNET_STACK_EXPORT
@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <stdlib.h> /* for strtol */
 #include <ctype.h> /* for isalnum */
+#include <float.h>
 #include <math.h>
 #if (__STDC_VERSION__ >= 199901L) && defined(__STDC_ISO_10646__)
 #include <wchar.h>
@@ -1927,6 +1928,100 @@ int bacapp_snprintf_shift(int len, char **buf, size_t *buf_size)
     return len;
 }
 
+static const char Hex_Digits[] = "0123456789ABCDEF";
+
+/**
+ * @brief Copy characters to a string like snprintf() with "%s" would,
+ *  without parsing a format
+ * @param str - destination string, or NULL for length only
+ * @param str_len - length of the destination string, or 0 for length only
+ * @param text - characters to copy
+ * @param len - number of characters to copy
+ * @return number of characters written
+ */
+static int
+bacapp_snprintf_chars(char *str, size_t str_len, const char *text, size_t len)
+{
+    size_t copy_len = len;
+
+    if (str && (str_len > 0)) {
+        if (copy_len >= str_len) {
+            copy_len = str_len - 1;
+        }
+        memcpy(str, text, copy_len);
+        str[copy_len] = 0;
+    }
+
+    return (int)len;
+}
+
+/**
+ * @brief Copy a string like snprintf() with "%s" would
+ * @param str - destination string, or NULL for length only
+ * @param str_len - length of the destination string, or 0 for length only
+ * @param text - string to copy, or NULL for none
+ * @return number of characters written
+ */
+static int bacapp_snprintf_text(char *str, size_t str_len, const char *text)
+{
+    if (!text) {
+        text = "";
+    }
+
+    return bacapp_snprintf_chars(str, str_len, text, strlen(text));
+}
+
+/**
+ * @brief Print an unsigned integer like snprintf() with "%lu" would,
+ *  without parsing a format
+ * @param str - destination string, or NULL for length only
+ * @param str_len - length of the destination string, or 0 for length only
+ * @param value - value to print
+ * @return number of characters written
+ */
+static int bacapp_snprintf_unsigned(
+    char *str, size_t str_len, BACNET_UNSIGNED_INTEGER value)
+{
+    /* the digits of a 64-bit value, from the end */
+    char digits[20];
+    size_t len = 0;
+
+    do {
+        digits[sizeof(digits) - 1 - len] = (char)('0' + (value % 10));
+        value /= 10;
+        len++;
+    } while (value);
+
+    return bacapp_snprintf_chars(
+        str, str_len, &digits[sizeof(digits) - len], len);
+}
+
+/**
+ * @brief Print a signed integer like snprintf() with "%ld" would,
+ *  without parsing a format
+ * @param str - destination string, or NULL for length only
+ * @param str_len - length of the destination string, or 0 for length only
+ * @param value - value to print
+ * @return number of characters written
+ */
+static int bacapp_snprintf_signed(char *str, size_t str_len, int32_t value)
+{
+    int slen = 0;
+    int ret_val = 0;
+    uint32_t magnitude;
+
+    if (value < 0) {
+        slen = bacapp_snprintf_chars(str, str_len, "-", 1);
+        ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+        magnitude = 0U - (uint32_t)value;
+    } else {
+        magnitude = (uint32_t)value;
+    }
+    ret_val += bacapp_snprintf_unsigned(str, str_len, magnitude);
+
+    return ret_val;
+}
+
 /**
  * @brief Print a value to a string for EPICS
  * @param str - destination string, or NULL for length only
@@ -1942,9 +2037,9 @@ static int bacapp_snprintf_property_identifier(
 
     char_str = bactext_property_name_default(property, NULL);
     if (char_str) {
-        ret_val = bacapp_snprintf(str, str_len, "%s", char_str);
+        ret_val = bacapp_snprintf_text(str, str_len, char_str);
     } else {
-        ret_val = bacapp_snprintf(str, str_len, "%lu", (unsigned long)property);
+        ret_val = bacapp_snprintf_unsigned(str, str_len, property);
     }
 
     return ret_val;
@@ -1959,7 +2054,7 @@ static int bacapp_snprintf_property_identifier(
  */
 static int bacapp_snprintf_null(char *str, size_t str_len)
 {
-    return bacapp_snprintf(str, str_len, "Null");
+    return bacapp_snprintf_text(str, str_len, "Null");
 }
 #endif
 
@@ -1974,9 +2069,9 @@ static int bacapp_snprintf_null(char *str, size_t str_len)
 static int bacapp_snprintf_boolean(char *str, size_t str_len, bool value)
 {
     if (value) {
-        return bacapp_snprintf(str, str_len, "TRUE");
+        return bacapp_snprintf_text(str, str_len, "TRUE");
     } else {
-        return bacapp_snprintf(str, str_len, "FALSE");
+        return bacapp_snprintf_text(str, str_len, "FALSE");
     }
 }
 #endif
@@ -1991,7 +2086,7 @@ static int bacapp_snprintf_boolean(char *str, size_t str_len, bool value)
 static int bacapp_snprintf_unsigned_integer(
     char *str, size_t str_len, BACNET_UNSIGNED_INTEGER value)
 {
-    return bacapp_snprintf(str, str_len, "%lu", (unsigned long)value);
+    return bacapp_snprintf_unsigned(str, str_len, value);
 }
 #endif
 
@@ -2006,7 +2101,7 @@ static int bacapp_snprintf_unsigned_integer(
 static int
 bacapp_snprintf_signed_integer(char *str, size_t str_len, int32_t value)
 {
-    return bacapp_snprintf(str, str_len, "%ld", (long)value);
+    return bacapp_snprintf_signed(str, str_len, value);
 }
 #endif
 
@@ -2052,19 +2147,22 @@ int bacapp_snprintf_octet_string(
     int slen = 0;
     int i = 0;
     const uint8_t *octet_str;
+    char hex[2];
 
-    slen = bacapp_snprintf(str, str_len, "X'");
+    slen = bacapp_snprintf_text(str, str_len, "X'");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     len = octetstring_length(value);
     if (len > 0) {
         octet_str = octetstring_value((BACNET_OCTET_STRING *)value);
         for (i = 0; i < len; i++) {
-            slen = bacapp_snprintf(str, str_len, "%02X", *octet_str);
+            hex[0] = Hex_Digits[*octet_str >> 4];
+            hex[1] = Hex_Digits[*octet_str & 0x0F];
+            slen = bacapp_snprintf_chars(str, str_len, hex, sizeof(hex));
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
             octet_str++;
         }
     }
-    slen = bacapp_snprintf(str, str_len, "'");
+    slen = bacapp_snprintf_text(str, str_len, "'");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     return ret_val;
@@ -2094,7 +2192,7 @@ int bacapp_snprintf_character_string(
 
     len = characterstring_length(value);
     char_str = characterstring_value(value);
-    slen = bacapp_snprintf(str, str_len, "\"");
+    slen = bacapp_snprintf_text(str, str_len, "\"");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 #if (__STDC_VERSION__ >= 199901L) && defined(__STDC_ISO_10646__)
     if (characterstring_encoding(value) == CHARACTER_UTF8) {
@@ -2131,15 +2229,15 @@ int bacapp_snprintf_character_string(
     {
         for (i = 0; i < len; i++) {
             if (isprint(*((const unsigned char *)char_str))) {
-                slen = bacapp_snprintf(str, str_len, "%c", *char_str);
+                slen = bacapp_snprintf_chars(str, str_len, char_str, 1);
             } else {
-                slen = bacapp_snprintf(str, str_len, "%c", '.');
+                slen = bacapp_snprintf_chars(str, str_len, ".", 1);
             }
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
             char_str++;
         }
     }
-    slen = bacapp_snprintf(str, str_len, "\"");
+    slen = bacapp_snprintf_text(str, str_len, "\"");
     ret_val += slen;
 
     return ret_val;
@@ -2162,19 +2260,19 @@ static int bacapp_snprintf_bit_string(
     int i = 0;
 
     len = bitstring_bits_used(value);
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     for (i = 0; i < len; i++) {
         bool bit;
         bit = bitstring_bit(value, (uint8_t)i);
-        slen = bacapp_snprintf(str, str_len, "%s", bit ? "true" : "false");
+        slen = bacapp_snprintf_text(str, str_len, bit ? "true" : "false");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
         if (i < (len - 1)) {
-            slen = bacapp_snprintf(str, str_len, ",");
+            slen = bacapp_snprintf_text(str, str_len, ",");
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
         }
     }
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     return ret_val;
@@ -2206,8 +2304,8 @@ static int bacapp_snprintf_enumerated(
             break;
         case PROP_OBJECT_TYPE:
             if (value <= BACNET_OBJECT_TYPE_RESERVED_MIN) {
-                ret_val = bacapp_snprintf(
-                    str, str_len, "%s", bactext_object_type_name(value));
+                ret_val = bacapp_snprintf_text(
+                    str, str_len, bactext_object_type_name(value));
             } else if (value <= BACNET_OBJECT_TYPE_RESERVED_MAX) {
                 ret_val = bacapp_snprintf(
                     str, str_len, "reserved %lu", (unsigned long)value);
@@ -2217,8 +2315,8 @@ static int bacapp_snprintf_enumerated(
             }
             break;
         case PROP_EVENT_STATE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_event_state_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_event_state_name(value));
             break;
         case PROP_UNITS:
         case PROP_CONTROLLED_VARIABLE_UNITS:
@@ -2231,13 +2329,13 @@ static int bacapp_snprintf_enumerated(
                 ret_val = bacapp_snprintf(
                     str, str_len, "proprietary-%lu", (unsigned long)value);
             } else {
-                ret_val = bacapp_snprintf(
-                    str, str_len, "%s", bactext_engineering_unit_name(value));
+                ret_val = bacapp_snprintf_text(
+                    str, str_len, bactext_engineering_unit_name(value));
             }
             break;
         case PROP_POLARITY:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_binary_polarity_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_binary_polarity_name(value));
             break;
         case PROP_PRESENT_VALUE:
         case PROP_RELINQUISH_DEFAULT:
@@ -2246,41 +2344,38 @@ static int bacapp_snprintf_enumerated(
                 case OBJECT_BINARY_INPUT:
                 case OBJECT_BINARY_OUTPUT:
                 case OBJECT_BINARY_VALUE:
-                    ret_val = bacapp_snprintf(
-                        str, str_len, "%s",
-                        bactext_binary_present_value_name(value));
+                    ret_val = bacapp_snprintf_text(
+                        str, str_len, bactext_binary_present_value_name(value));
                     break;
                 case OBJECT_BINARY_LIGHTING_OUTPUT:
-                    ret_val = bacapp_snprintf(
-                        str, str_len, "%s",
-                        bactext_binary_lighting_pv_name(value));
+                    ret_val = bacapp_snprintf_text(
+                        str, str_len, bactext_binary_lighting_pv_name(value));
                     break;
                 case OBJECT_ACCESS_DOOR:
-                    ret_val = bacapp_snprintf(
-                        str, str_len, "%s", bactext_door_value_name(value));
+                    ret_val = bacapp_snprintf_text(
+                        str, str_len, bactext_door_value_name(value));
                     break;
                 default:
-                    ret_val = bacapp_snprintf(
-                        str, str_len, "%lu", (unsigned long)value);
+                    ret_val = bacapp_snprintf_unsigned(str, str_len, value);
                     break;
             }
             break;
         case PROP_RELIABILITY:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_reliability_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_reliability_name(value));
             break;
         case PROP_SYSTEM_STATUS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_device_status_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_device_status_name(value));
             break;
         case PROP_SEGMENTATION_SUPPORTED:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_segmentation_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_segmentation_name(value));
             break;
         case PROP_NODE_TYPE:
         case PROP_SUBORDINATE_NODE_TYPES:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_node_type_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_node_type_name(value));
             break;
         case PROP_SUBORDINATE_RELATIONSHIPS:
         case PROP_DEFAULT_SUBORDINATE_RELATIONSHIP:
@@ -2288,207 +2383,202 @@ static int bacapp_snprintf_enumerated(
                 ret_val = bacapp_snprintf(
                     str, str_len, "proprietary-%lu", (unsigned long)value);
             } else {
-                ret_val = bacapp_snprintf(
-                    str, str_len, "%s", bactext_node_relationship_name(value));
+                ret_val = bacapp_snprintf_text(
+                    str, str_len, bactext_node_relationship_name(value));
             }
             break;
         case PROP_TRANSITION:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_lighting_transition(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_lighting_transition(value));
             break;
         case PROP_IN_PROGRESS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_lighting_in_progress(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_lighting_in_progress(value));
             break;
         case PROP_LOGGING_TYPE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_logging_type_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_logging_type_name(value));
             break;
         case PROP_MODE:
         case PROP_ACCEPTED_MODES:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_life_safety_mode_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_life_safety_mode_name(value));
             break;
         case PROP_OPERATION_EXPECTED:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_life_safety_operation_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_life_safety_operation_name(value));
             break;
         case PROP_TRACKING_VALUE:
             switch (object_type) {
                 case OBJECT_LIFE_SAFETY_POINT:
                 case OBJECT_LIFE_SAFETY_ZONE:
-                    ret_val = bacapp_snprintf(
-                        str, str_len, "%s",
-                        bactext_life_safety_state_name(value));
+                    ret_val = bacapp_snprintf_text(
+                        str, str_len, bactext_life_safety_state_name(value));
                     break;
                 default:
-                    ret_val = bacapp_snprintf(
-                        str, str_len, "%lu", (unsigned long)value);
+                    ret_val = bacapp_snprintf_unsigned(str, str_len, value);
                     break;
             }
             break;
         case PROP_PROGRAM_CHANGE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_program_request_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_program_request_name(value));
             break;
         case PROP_PROGRAM_STATE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_program_state_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_program_state_name(value));
             break;
         case PROP_REASON_FOR_HALT:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_program_error_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_program_error_name(value));
             break;
         case PROP_NETWORK_NUMBER_QUALITY:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_network_number_quality_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_network_number_quality_name(value));
             break;
         case PROP_NETWORK_TYPE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_network_port_type_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_network_port_type_name(value));
             break;
         case PROP_PROTOCOL_LEVEL:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_protocol_level_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_protocol_level_name(value));
             break;
         case PROP_EVENT_TYPE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_event_type_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_event_type_name(value));
             break;
         case PROP_NOTIFY_TYPE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_notify_type_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_notify_type_name(value));
             break;
         case PROP_TIMER_STATE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_timer_state_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_timer_state_name(value));
             break;
         case PROP_LAST_STATE_CHANGE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_timer_transition_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_timer_transition_name(value));
             break;
         case PROP_ACTION:
             ret_val =
-                bacapp_snprintf(str, str_len, "%s", bactext_action_name(value));
+                bacapp_snprintf_text(str, str_len, bactext_action_name(value));
             break;
         case PROP_FILE_ACCESS_METHOD:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_file_access_method_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_file_access_method_name(value));
             break;
         case PROP_LOCK_STATUS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_lock_status_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_lock_status_name(value));
             break;
         case PROP_DOOR_ALARM_STATE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_door_alarm_state_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_door_alarm_state_name(value));
             break;
         case PROP_DOOR_STATUS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_door_status_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_door_status_name(value));
             break;
         case PROP_SECURED_STATUS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_door_secured_status_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_door_secured_status_name(value));
             break;
         case PROP_ACCESS_EVENT:
         case PROP_LAST_ACCESS_EVENT:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_access_event_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_access_event_name(value));
             break;
         case PROP_AUTHENTICATION_STATUS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_authentication_status_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_authentication_status_name(value));
             break;
         case PROP_AUTHORIZATION_MODE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_authorization_mode_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_authorization_mode_name(value));
             break;
         case PROP_CREDENTIAL_STATUS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_binary_present_value_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_binary_present_value_name(value));
             break;
         case PROP_CREDENTIAL_DISABLE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s",
-                bactext_access_credential_disable_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_access_credential_disable_name(value));
             break;
         case PROP_REASON_FOR_DISABLE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s",
+            ret_val = bacapp_snprintf_text(
+                str, str_len,
                 bactext_access_credential_disable_reason_name(value));
             break;
         case PROP_USER_TYPE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_access_user_type_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_access_user_type_name(value));
             break;
         case PROP_OCCUPANCY_STATE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s",
-                bactext_access_zone_occupancy_state_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_access_zone_occupancy_state_name(value));
             break;
         case PROP_SILENCED:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_silenced_state_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_silenced_state_name(value));
             break;
         case PROP_WRITE_STATUS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_write_status_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_write_status_name(value));
             break;
         case PROP_BACNET_IP_MODE:
         case PROP_BACNET_IPV6_MODE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_ip_mode_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_ip_mode_name(value));
             break;
         case PROP_SC_HUB_CONNECTOR_STATE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_sc_hub_connector_state_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_sc_hub_connector_state_name(value));
             break;
         case PROP_MAINTENANCE_REQUIRED:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_maintenance_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_maintenance_name(value));
             break;
         case PROP_FAULT_SIGNALS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_escalator_fault_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_escalator_fault_name(value));
             break;
         case PROP_OPERATION_DIRECTION:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s",
+            ret_val = bacapp_snprintf_text(
+                str, str_len,
                 bactext_escalator_operation_direction_name(value));
             break;
         case PROP_BACKUP_AND_RESTORE_STATE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_backup_state_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_backup_state_name(value));
             break;
         case PROP_BASE_DEVICE_SECURITY_POLICY:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_security_level_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_security_level_name(value));
             break;
         case PROP_GROUP_MODE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_lift_group_mode_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_lift_group_mode_name(value));
             break;
         case PROP_CAR_MODE:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_lift_car_mode_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_lift_car_mode_name(value));
             break;
         case PROP_CAR_DRIVE_STATUS:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_lift_car_drive_status_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_lift_car_drive_status_name(value));
             break;
         case PROP_CAR_DOOR_COMMAND:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_lift_car_door_command_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_lift_car_door_command_name(value));
             break;
         case PROP_CAR_ASSIGNED_DIRECTION:
         case PROP_CAR_MOVING_DIRECTION:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%s", bactext_lift_car_direction_name(value));
+            ret_val = bacapp_snprintf_text(
+                str, str_len, bactext_lift_car_direction_name(value));
             break;
         default:
-            ret_val =
-                bacapp_snprintf(str, str_len, "%lu", (unsigned long)value);
+            ret_val = bacapp_snprintf_unsigned(str, str_len, value);
             break;
     }
 
@@ -2523,13 +2613,13 @@ bacapp_snprintf_date(char *str, size_t str_len, const BACNET_DATE *bdate)
     slen = bacapp_snprintf(str, str_len, "%s, %s", weekday_text, month_text);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (bdate->day == 255) {
-        slen = bacapp_snprintf(str, str_len, " (unspecified), ");
+        slen = bacapp_snprintf_text(str, str_len, " (unspecified), ");
     } else {
         slen = bacapp_snprintf(str, str_len, " %u, ", (unsigned)bdate->day);
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (bdate->year == 2155) {
-        slen = bacapp_snprintf(str, str_len, "(unspecified)");
+        slen = bacapp_snprintf_text(str, str_len, "(unspecified)");
     } else {
         slen = bacapp_snprintf(str, str_len, "%u", (unsigned)bdate->year);
     }
@@ -2555,19 +2645,19 @@ static int bacapp_snprintf_date_numeric(
     int slen = 0;
 
     if (bdate->year == 2155) {
-        slen = bacapp_snprintf(str, str_len, "****-");
+        slen = bacapp_snprintf_text(str, str_len, "****-");
     } else {
         slen = bacapp_snprintf(str, str_len, "%04u-", (unsigned)bdate->year);
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (bdate->month == 255) {
-        slen = bacapp_snprintf(str, str_len, "**-");
+        slen = bacapp_snprintf_text(str, str_len, "**-");
     } else {
         slen = bacapp_snprintf(str, str_len, "%02u-", (unsigned)bdate->month);
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (bdate->day == 255) {
-        slen = bacapp_snprintf(str, str_len, "**");
+        slen = bacapp_snprintf_text(str, str_len, "**");
     } else {
         slen = bacapp_snprintf(str, str_len, "%02u", (unsigned)bdate->day);
     }
@@ -2596,25 +2686,25 @@ bacapp_snprintf_time(char *str, size_t str_len, const BACNET_TIME *btime)
     int slen = 0;
 
     if (btime->hour == 255) {
-        slen = bacapp_snprintf(str, str_len, "**:");
+        slen = bacapp_snprintf_text(str, str_len, "**:");
     } else {
         slen = bacapp_snprintf(str, str_len, "%02u:", (unsigned)btime->hour);
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (btime->min == 255) {
-        slen = bacapp_snprintf(str, str_len, "**:");
+        slen = bacapp_snprintf_text(str, str_len, "**:");
     } else {
         slen = bacapp_snprintf(str, str_len, "%02u:", (unsigned)btime->min);
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (btime->sec == 255) {
-        slen = bacapp_snprintf(str, str_len, "**.");
+        slen = bacapp_snprintf_text(str, str_len, "**.");
     } else {
         slen = bacapp_snprintf(str, str_len, "%02u.", (unsigned)btime->sec);
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (btime->hundredths == 255) {
-        slen = bacapp_snprintf(str, str_len, "**");
+        slen = bacapp_snprintf_text(str, str_len, "**");
     } else {
         slen =
             bacapp_snprintf(str, str_len, "%02u", (unsigned)btime->hundredths);
@@ -2639,7 +2729,7 @@ static int bacapp_snprintf_object_id(
     int ret_val = 0;
     int slen = 0;
 
-    slen = bacapp_snprintf(str, str_len, "(");
+    slen = bacapp_snprintf_text(str, str_len, "(");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (object_id->type <= BACNET_OBJECT_TYPE_RESERVED_MIN) {
         slen = bacapp_snprintf(
@@ -2674,15 +2764,15 @@ static int bacapp_snprintf_datetime(
     int ret_val = 0;
     int slen = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     slen = bacapp_snprintf_date(str, str_len, &value->date);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, "-");
+    slen = bacapp_snprintf_text(str, str_len, "-");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     slen = bacapp_snprintf_time(str, str_len, &value->time);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    ret_val += bacapp_snprintf(str, str_len, "}");
+    ret_val += bacapp_snprintf_text(str, str_len, "}");
 
     return ret_val;
 }
@@ -2702,15 +2792,15 @@ static int bacapp_snprintf_datetime_numeric(
     int ret_val = 0;
     int slen = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     slen = bacapp_snprintf_date_numeric(str, str_len, &value->date);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, "-");
+    slen = bacapp_snprintf_text(str, str_len, "-");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     slen = bacapp_snprintf_time(str, str_len, &value->time);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    ret_val += bacapp_snprintf(str, str_len, "}");
+    ret_val += bacapp_snprintf_text(str, str_len, "}");
 
     return ret_val;
 }
@@ -2730,15 +2820,15 @@ static int bacapp_snprintf_daterange(
     int ret_val = 0;
     int slen = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     slen = bacapp_snprintf_date(str, str_len, &value->startdate);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, "..");
+    slen = bacapp_snprintf_text(str, str_len, "..");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     slen = bacapp_snprintf_date(str, str_len, &value->enddate);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    ret_val += bacapp_snprintf(str, str_len, "}");
+    ret_val += bacapp_snprintf_text(str, str_len, "}");
 
     return ret_val;
 }
@@ -2764,15 +2854,15 @@ static int bacapp_snprintf_weeknday(
     int ret_val = 0;
     int slen = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* 1=Jan 13=odd 14=even FF=any */
     if (value->month == 255) {
-        slen = bacapp_snprintf(str, str_len, "*, ");
+        slen = bacapp_snprintf_text(str, str_len, "*, ");
     } else if (value->month == 13) {
-        slen = bacapp_snprintf(str, str_len, "odd, ");
+        slen = bacapp_snprintf_text(str, str_len, "odd, ");
     } else if (value->month == 14) {
-        slen = bacapp_snprintf(str, str_len, "even, ");
+        slen = bacapp_snprintf_text(str, str_len, "even, ");
     } else {
         slen = bacapp_snprintf(str, str_len, "%u, ", (unsigned)value->month);
     }
@@ -2780,9 +2870,9 @@ static int bacapp_snprintf_weeknday(
     /* 1=days 1-7, 2=days 8-14, 3=days 15-21, 4=days 22-28,
        5=days 29-31, 6=last 7 days, FF=any week */
     if (value->weekofmonth == 255) {
-        slen = bacapp_snprintf(str, str_len, "*, ");
+        slen = bacapp_snprintf_text(str, str_len, "*, ");
     } else if (value->weekofmonth == 6) {
-        slen = bacapp_snprintf(str, str_len, "last, ");
+        slen = bacapp_snprintf_text(str, str_len, "last, ");
     } else {
         slen =
             bacapp_snprintf(str, str_len, "%u, ", (unsigned)value->weekofmonth);
@@ -2790,13 +2880,13 @@ static int bacapp_snprintf_weeknday(
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* 1=Monday-7=Sunday, FF=any */
     if (value->dayofweek == 255) {
-        slen = bacapp_snprintf(str, str_len, "*");
+        slen = bacapp_snprintf_text(str, str_len, "*");
     } else {
-        slen = bacapp_snprintf(
-            str, str_len, "%s", bactext_day_of_week_name(value->dayofweek));
+        slen = bacapp_snprintf_text(
+            str, str_len, bactext_day_of_week_name(value->dayofweek));
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    ret_val += bacapp_snprintf(str, str_len, "}");
+    ret_val += bacapp_snprintf_text(str, str_len, "}");
 
     return ret_val;
 }
@@ -2818,33 +2908,32 @@ static int bacapp_snprintf_device_object_property_reference(
     int slen;
     int ret_val = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* object-identifier       [0] BACnetObjectIdentifier */
     slen = bacapp_snprintf_object_id(str, str_len, &value->objectIdentifier);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* property-identifier     [1] BACnetPropertyIdentifier */
     slen = bacapp_snprintf_property_identifier(
         str, str_len, value->propertyIdentifier);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* property-array-index    [2] Unsigned OPTIONAL,*/
     if (value->arrayIndex == BACNET_ARRAY_ALL) {
-        slen = bacapp_snprintf(str, str_len, "-1");
+        slen = bacapp_snprintf_text(str, str_len, "-1");
     } else {
-        slen = bacapp_snprintf(
-            str, str_len, "%lu", (unsigned long)value->arrayIndex);
+        slen = bacapp_snprintf_unsigned(str, str_len, value->arrayIndex);
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* device-identifier       [3] BACnetObjectIdentifier OPTIONAL */
     slen = bacapp_snprintf_object_id(str, str_len, &value->deviceIdentifier);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    ret_val += bacapp_snprintf(str, str_len, "}");
+    ret_val += bacapp_snprintf_text(str, str_len, "}");
 
     return ret_val;
 }
@@ -2865,18 +2954,18 @@ static int bacapp_snprintf_device_object_reference(
     int ret_val = 0;
 
     /* BACnetDeviceObjectReference */
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (value->deviceIdentifier.type == OBJECT_DEVICE) {
         slen =
             bacapp_snprintf_object_id(str, str_len, &value->deviceIdentifier);
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-        slen = bacapp_snprintf(str, str_len, ",");
+        slen = bacapp_snprintf_text(str, str_len, ",");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     }
     slen = bacapp_snprintf_object_id(str, str_len, &value->objectIdentifier);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += slen;
 
     return ret_val;
@@ -2897,14 +2986,14 @@ static int bacapp_snprintf_object_property_reference(
     int slen;
     int ret_val = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (value->object_identifier.type != OBJECT_NONE) {
         /* object-identifier [0] BACnetObjectIdentifier */
         slen =
             bacapp_snprintf_object_id(str, str_len, &value->object_identifier);
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-        slen = bacapp_snprintf(str, str_len, ",");
+        slen = bacapp_snprintf_text(str, str_len, ",");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     }
     /* property-identifier [1] BACnetPropertyIdentifier */
@@ -2917,7 +3006,7 @@ static int bacapp_snprintf_object_property_reference(
             str, str_len, ", %lu", (unsigned long)value->property_array_index);
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     }
-    ret_val += bacapp_snprintf(str, str_len, "}");
+    ret_val += bacapp_snprintf_text(str, str_len, "}");
 
     return ret_val;
 }
@@ -2937,31 +3026,31 @@ static int bacapp_snprintf_access_rule(
     int slen;
     int ret_val = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /*  specified (0), always (1) */
     if (value->time_range_specifier == TIME_RANGE_SPECIFIER_SPECIFIED) {
-        slen = bacapp_snprintf(str, str_len, "specified, ");
+        slen = bacapp_snprintf_text(str, str_len, "specified, ");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
         slen = bacapp_snprintf_device_object_property_reference(
             str, str_len, &value->time_range);
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     } else {
-        slen = bacapp_snprintf(str, str_len, "always, ");
+        slen = bacapp_snprintf_text(str, str_len, "always, ");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     }
     /* specified (0), all (1) */
     if (value->location_specifier == LOCATION_SPECIFIER_SPECIFIED) {
-        slen = bacapp_snprintf(str, str_len, "specified, ");
+        slen = bacapp_snprintf_text(str, str_len, "specified, ");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
         slen = bacapp_snprintf_device_object_reference(
             str, str_len, &value->location);
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     } else {
-        slen = bacapp_snprintf(str, str_len, "all");
+        slen = bacapp_snprintf_text(str, str_len, "all");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     }
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     return ret_val;
@@ -2982,19 +3071,19 @@ static int bacapp_snprintf_color_command(
     int slen;
     int ret_val = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, "(");
+    slen = bacapp_snprintf_text(str, str_len, "(");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(
-        str, str_len, "%s", bactext_color_operation_name(value->operation));
+    slen = bacapp_snprintf_text(
+        str, str_len, bactext_color_operation_name(value->operation));
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ")");
+    slen = bacapp_snprintf_text(str, str_len, ")");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     /* FIXME: add the Color Command optional values */
 
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     return ret_val;
 }
@@ -3047,8 +3136,8 @@ static int bacapp_snprintf_channel_value(
             break;
         case BACNET_APPLICATION_TAG_ENUMERATED:
 #if defined(CHANNEL_ENUMERATED)
-            ret_val = bacapp_snprintf(
-                str, str_len, "%lu", (unsigned long)value->type.Enumerated);
+            ret_val = bacapp_snprintf_unsigned(
+                str, str_len, value->type.Enumerated);
 #endif
             break;
         case BACNET_APPLICATION_TAG_LIGHTING_COMMAND:
@@ -3230,7 +3319,7 @@ static int bacapp_snprintf_log_record(
     int ret_val = 0, slen;
     BACNET_BIT_STRING bitstring;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     slen = bacapp_snprintf_datetime_numeric(str, str_len, &value->timestamp);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
@@ -3258,9 +3347,8 @@ static int bacapp_snprintf_log_record(
                 bacapp_snprintf_real(str, str_len, value->log_datum.real_value);
             break;
         case BACNET_LOG_DATUM_ENUMERATED:
-            slen = bacapp_snprintf(
-                str, str_len, "%lu",
-                (unsigned long)value->log_datum.enumerated_value);
+            slen = bacapp_snprintf_unsigned(
+                str, str_len, value->log_datum.enumerated_value);
             break;
         case BACNET_LOG_DATUM_UNSIGNED:
             slen = bacapp_snprintf_unsigned_integer(
@@ -3289,7 +3377,7 @@ static int bacapp_snprintf_log_record(
     }
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* FIXME: optional status flags */
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     return ret_val;
@@ -3336,9 +3424,9 @@ static int bacapp_snprintf_weeklyschedule(
     }
 
     if (inner_tag == -1) {
-        slen = bacapp_snprintf(str, str_len, "(Null; ");
+        slen = bacapp_snprintf_text(str, str_len, "(Null; ");
     } else if (inner_tag == -2) {
-        slen = bacapp_snprintf(str, str_len, "(MIXED_TYPES; ");
+        slen = bacapp_snprintf_text(str, str_len, "(MIXED_TYPES; ");
     } else {
         slen = bacapp_snprintf(
             str, str_len, "(%s; ", bactext_application_tag_name(inner_tag));
@@ -3360,7 +3448,7 @@ static int bacapp_snprintf_weeklyschedule(
             slen =
                 bacapp_snprintf_time(str, str_len, &ds->Time_Values[ti].Time);
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-            slen = bacapp_snprintf(str, str_len, " ");
+            slen = bacapp_snprintf_text(str, str_len, " ");
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
             bacnet_primitive_to_application_data_value(
                 &dummyDataValue, &ds->Time_Values[ti].Value);
@@ -3371,16 +3459,16 @@ static int bacapp_snprintf_weeklyschedule(
             slen = bacapp_snprintf_value(str, str_len, &dummyPropValue);
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
             if (ti < ds->TV_Count - 1) {
-                slen = bacapp_snprintf(str, str_len, ", ");
+                slen = bacapp_snprintf_text(str, str_len, ", ");
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
             }
         }
         if (wi < loopend - 1) {
-            slen = bacapp_snprintf(str, str_len, "]; ");
+            slen = bacapp_snprintf_text(str, str_len, "]; ");
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
         }
     }
-    slen = bacapp_snprintf(str, str_len, "])");
+    slen = bacapp_snprintf_text(str, str_len, "])");
     ret_val += slen;
     return ret_val;
 }
@@ -3401,7 +3489,7 @@ static int bacapp_snprintf_host_n_port(
     const char *char_str;
     int ret_val = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     if (value->host_ip_address) {
         const uint8_t *octet_str;
@@ -3417,21 +3505,21 @@ static int bacapp_snprintf_host_n_port(
         name = &value->host.name;
         len = characterstring_length(name);
         char_str = characterstring_value(name);
-        slen = bacapp_snprintf(str, str_len, "\"");
+        slen = bacapp_snprintf_text(str, str_len, "\"");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
         for (i = 0; i < len; i++) {
             if (isprint(*((const unsigned char *)char_str))) {
-                slen = bacapp_snprintf(str, str_len, "%c", *char_str);
+                slen = bacapp_snprintf_chars(str, str_len, char_str, 1);
             } else {
-                slen = bacapp_snprintf(str, str_len, "%c", '.');
+                slen = bacapp_snprintf_chars(str, str_len, ".", 1);
             }
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
             char_str++;
         }
-        slen = bacapp_snprintf(str, str_len, "\"");
+        slen = bacapp_snprintf_text(str, str_len, "\"");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     }
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     return ret_val;
@@ -3452,7 +3540,7 @@ static int bacapp_snprintf_calendar_entry(
     int slen;
     int ret_val = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     switch (value->tag) {
         case BACNET_CALENDAR_DATE:
@@ -3473,7 +3561,7 @@ static int bacapp_snprintf_calendar_entry(
             /* do nothing */
             break;
     }
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     return ret_val;
@@ -3529,8 +3617,8 @@ static int bacapp_snprintf_primitive_data_value(
 #endif
 #if defined(BACAPP_ENUMERATED)
         case BACNET_APPLICATION_TAG_ENUMERATED:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%lu", (unsigned long)value->type.Enumerated);
+            ret_val = bacapp_snprintf_unsigned(
+                str, str_len, value->type.Enumerated);
             break;
 #endif
         case BACNET_APPLICATION_TAG_EMPTYLIST:
@@ -3558,22 +3646,22 @@ static int bacapp_snprintf_daily_schedule(
     int ret_val = 0;
     uint16_t i;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     for (i = 0; i < value->TV_Count; i++) {
         if (i != 0) {
-            slen = bacapp_snprintf(str, str_len, ", ");
+            slen = bacapp_snprintf_text(str, str_len, ", ");
             ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
         }
         slen = bacapp_snprintf_time(str, str_len, &value->Time_Values[i].Time);
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-        slen = bacapp_snprintf(str, str_len, ",");
+        slen = bacapp_snprintf_text(str, str_len, ",");
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
         slen = bacapp_snprintf_primitive_data_value(
             str, str_len, &value->Time_Values[i].Value);
         ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     }
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     return ret_val;
@@ -3595,7 +3683,7 @@ static int bacapp_snprintf_special_event(
     int slen;
     int ret_val = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     switch (value->periodTag) {
         case BACNET_SPECIAL_EVENT_PERIOD_CALENDAR_ENTRY:
@@ -3670,8 +3758,8 @@ static int bacapp_snprintf_action_property_value(
 #endif
 #if defined(BACACTION_ENUMERATED)
         case BACNET_APPLICATION_TAG_ENUMERATED:
-            ret_val = bacapp_snprintf(
-                str, str_len, "%lu", (unsigned long)value->type.Enumerated);
+            ret_val = bacapp_snprintf_unsigned(
+                str, str_len, value->type.Enumerated);
             break;
 #endif
         case BACNET_APPLICATION_TAG_EMPTYLIST:
@@ -3698,27 +3786,27 @@ static int bacapp_snprintf_action_command(
     int slen;
     int ret_val = 0;
 
-    slen = bacapp_snprintf(str, str_len, "{");
+    slen = bacapp_snprintf_text(str, str_len, "{");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* deviceIdentifier [0] BACnetObjectIdentifier OPTIONAL */
     slen = bacapp_snprintf_object_id(str, str_len, &value->Device_Id);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* objectIdentifier [1] BACnetObjectIdentifier */
     slen = bacapp_snprintf_object_id(str, str_len, &value->Device_Id);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* propertyIdentifier [2] BACnetPropertyIdentifier */
     slen = bacapp_snprintf_property_identifier(
         str, str_len, value->Property_Identifier);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* propertyArrayIndex [3] Unsigned OPTIONAL */
     if (value->Property_Array_Index == BACNET_ARRAY_ALL) {
-        slen = bacapp_snprintf(str, str_len, "-1,");
+        slen = bacapp_snprintf_text(str, str_len, "-1,");
     } else {
         slen = bacapp_snprintf(
             str, str_len, "%lu,", (unsigned long)value->Property_Array_Index);
@@ -3727,28 +3815,27 @@ static int bacapp_snprintf_action_command(
     /* propertyValue [4] ABSTRACT-SYNTAX.&Type */
     slen = bacapp_snprintf_action_property_value(str, str_len, &value->Value);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* priority [5] Unsigned (1..16) OPTIONAL */
-    slen = bacapp_snprintf(str, str_len, "%lu", (unsigned long)value->Priority);
+    slen = bacapp_snprintf_unsigned(str, str_len, value->Priority);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* postDelay [6] Unsigned OPTIONAL */
-    slen =
-        bacapp_snprintf(str, str_len, "%lu", (unsigned long)value->Post_Delay);
+    slen = bacapp_snprintf_unsigned(str, str_len, value->Post_Delay);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* quitOnFailure [7] BOOLEAN */
     slen = bacapp_snprintf_boolean(str, str_len, value->Quit_On_Failure);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, ",");
+    slen = bacapp_snprintf_text(str, str_len, ",");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
     /* writeSuccessful [8] BOOLEAN */
     slen = bacapp_snprintf_boolean(str, str_len, value->Write_Successful);
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-    slen = bacapp_snprintf(str, str_len, "}");
+    slen = bacapp_snprintf_text(str, str_len, "}");
     ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
 
     return ret_val;
@@ -3968,23 +4055,23 @@ int bacapp_snprintf_value(
 #endif
 #if defined(BACAPP_BDT_ENTRY)
             case BACNET_APPLICATION_TAG_BDT_ENTRY:
-                slen = bacapp_snprintf(str, str_len, "{");
+                slen = bacapp_snprintf_text(str, str_len, "{");
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
                 slen = bacnet_bdt_entry_to_ascii(
                     str, str_len, &value->type.BDT_Entry);
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-                slen = bacapp_snprintf(str, str_len, "}");
+                slen = bacapp_snprintf_text(str, str_len, "}");
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
                 break;
 #endif
 #if defined(BACAPP_FDT_ENTRY)
             case BACNET_APPLICATION_TAG_FDT_ENTRY:
-                slen = bacapp_snprintf(str, str_len, "{");
+                slen = bacapp_snprintf_text(str, str_len, "{");
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
                 slen = bacnet_fdt_entry_to_ascii(
                     str, str_len, &value->type.FDT_Entry);
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-                slen = bacapp_snprintf(str, str_len, "}");
+                slen = bacapp_snprintf_text(str, str_len, "}");
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
                 break;
 #endif
@@ -4009,12 +4096,12 @@ int bacapp_snprintf_value(
 #endif
 #if defined(BACAPP_SHED_LEVEL)
             case BACNET_APPLICATION_TAG_SHED_LEVEL:
-                slen = bacapp_snprintf(str, str_len, "{");
+                slen = bacapp_snprintf_text(str, str_len, "{");
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
                 slen = bacapp_snprintf_shed_level(
                     str, str_len, &value->type.Shed_Level);
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
-                slen = bacapp_snprintf(str, str_len, "}");
+                slen = bacapp_snprintf_text(str, str_len, "}");
                 ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
                 break;
 #endif
@@ -4060,7 +4147,7 @@ int bacapp_snprintf_value(
                 break;
 #endif
             case BACNET_APPLICATION_TAG_EMPTYLIST:
-                ret_val = bacapp_snprintf(str, str_len, "{}");
+                ret_val = bacapp_snprintf_text(str, str_len, "{}");
                 break;
             default:
                 ret_val = bacapp_snprintf(
@@ -4072,6 +4159,344 @@ int bacapp_snprintf_value(
     return ret_val;
 }
 
+#if defined(BACAPP_REAL) || defined(BACAPP_DOUBLE)
+/**
+ * @brief Print a floating point value with the fewest digits that read
+ *  back as the same value, or null if it is not a JSON number
+ * @param str - destination string, or NULL for length only
+ * @param str_len - length of the destination string, or 0 for length only
+ * @param value - value to print
+ * @param single - true if the value is a single precision REAL
+ * @return number of characters written
+ */
+static int bacapp_snprintf_json_number(
+    char *str, size_t str_len, double value, bool single)
+{
+    char text[32];
+    int precision, precision_max;
+    int len = 0;
+
+    if (!isfinite(value)) {
+        return bacapp_snprintf_text(str, str_len, "null");
+    }
+    /* the rounding to the first precision is the shortest text, when
+       there is one that short, since the digits that follow are 0 */
+    if (single) {
+        precision = FLT_DIG;
+        precision_max = 9;
+    } else {
+        precision = DBL_DIG;
+        precision_max = 17;
+    }
+    for (; precision <= precision_max; precision++) {
+        len = snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (single) {
+            if (!islessgreater((float)strtod(text, NULL), (float)value)) {
+                break;
+            }
+        } else if (!islessgreater(strtod(text, NULL), value)) {
+            break;
+        }
+    }
+
+    return bacapp_snprintf_chars(str, str_len, text, (size_t)len);
+}
+#endif
+
+/**
+ * @brief Print characters as a JSON string, with the quotes and escapes
+ * @param str - destination string, or NULL for length only
+ * @param str_len - length of the destination string, or 0 for length only
+ * @param text - characters to print
+ * @param len - number of characters to print
+ * @param utf8 - true if the characters are UTF-8, false to print the
+ *  characters that are not ASCII as '.'
+ * @return number of characters written
+ */
+static int bacapp_snprintf_json_string(
+    char *str, size_t str_len, const char *text, size_t len, bool utf8)
+{
+    int ret_val = 0;
+    int slen = 0;
+    size_t i = 0, run = 0;
+    unsigned char c;
+    char escape[6] = { '\\', 'u', '0', '0', 0, 0 };
+    size_t escape_len;
+
+    slen = bacapp_snprintf_chars(str, str_len, "\"", 1);
+    ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+    while (i < len) {
+        /* the characters that need no escape are copied at once */
+        run = i;
+        while (run < len) {
+            c = (unsigned char)text[run];
+            if ((c < 0x20) || (c == '"') || (c == '\\') ||
+                ((c >= 0x80) && !utf8)) {
+                break;
+            }
+            run++;
+        }
+        if (run > i) {
+            slen = bacapp_snprintf_chars(str, str_len, &text[i], run - i);
+            ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+            i = run;
+            continue;
+        }
+        c = (unsigned char)text[i];
+        escape_len = 2;
+        if (c >= 0x80) {
+            escape[0] = '.';
+            escape_len = 1;
+        } else if ((c == '"') || (c == '\\')) {
+            escape[1] = (char)c;
+        } else if (c == '\n') {
+            escape[1] = 'n';
+        } else if (c == '\r') {
+            escape[1] = 'r';
+        } else if (c == '\t') {
+            escape[1] = 't';
+        } else {
+            escape[1] = 'u';
+            escape[4] = Hex_Digits[c >> 4];
+            escape[5] = Hex_Digits[c & 0x0F];
+            escape_len = sizeof(escape);
+        }
+        slen = bacapp_snprintf_chars(str, str_len, escape, escape_len);
+        ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+        escape[0] = '\\';
+        i++;
+    }
+    slen = bacapp_snprintf_chars(str, str_len, "\"", 1);
+    ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+
+    return ret_val;
+}
+
+/**
+ * @brief Print a value as JSON from its EPICS text: a number if the text
+ *  is only digits, or else a JSON string of the text
+ * @param str - destination string, or NULL for length only
+ * @param str_len - length of the destination string, or 0 for length only
+ * @param object_value - ptr to BACnet object value from which to extract str
+ * @return number of characters written, or -1 if out of memory
+ */
+static int bacapp_snprintf_json_text(
+    char *str, size_t str_len, const BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    int ret_val = 0;
+    int len = 0;
+    int i = 0;
+    char *text;
+
+    len = bacapp_snprintf_value(NULL, 0, object_value);
+    if (len <= 0) {
+        return bacapp_snprintf_text(str, str_len, "null");
+    }
+    text = malloc((size_t)len + 1);
+    if (!text) {
+        return -1;
+    }
+    bacapp_snprintf_value(text, (size_t)len + 1, object_value);
+    while ((i < len) && isdigit((unsigned char)text[i])) {
+        i++;
+    }
+    if (i == len) {
+        ret_val = bacapp_snprintf_chars(str, str_len, text, (size_t)len);
+    } else {
+        ret_val =
+            bacapp_snprintf_json_string(str, str_len, text, (size_t)len, true);
+    }
+    free(text);
+
+    return ret_val;
+}
+
+/**
+ * @brief Print a value to a string as JSON. The numbers, booleans and
+ *  strings are the JSON types, and the real values are printed with the
+ *  fewest digits that read back as the same value. An enumerated value
+ *  is the string of its name, or its number when it has none, and the
+ *  other values are the JSON string of their EPICS text.
+ * @param str - destination string, or NULL for length only
+ * @param str_len - length of the destination string, or 0 for length only
+ * @param object_value - ptr to BACnet object value from which to extract str
+ * @return number of characters written, or -1 if out of memory
+ */
+int bacapp_snprintf_value_json(
+    char *str, size_t str_len, const BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    const BACNET_APPLICATION_DATA_VALUE *value;
+    int ret_val = 0;
+#if defined(BACAPP_OCTET_STRING) || defined(BACAPP_BIT_STRING)
+    int slen = 0;
+    int len = 0;
+    int i = 0;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+    const uint8_t *octet_str;
+    char hex[2];
+#endif
+
+    if (!object_value || !object_value->value) {
+        return 0;
+    }
+    value = object_value->value;
+    switch (value->tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            ret_val = bacapp_snprintf_text(str, str_len, "null");
+            break;
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            ret_val = bacapp_snprintf_text(
+                str, str_len, value->type.Boolean ? "true" : "false");
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            ret_val = bacapp_snprintf_unsigned(
+                str, str_len, value->type.Unsigned_Int);
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            ret_val =
+                bacapp_snprintf_signed(str, str_len, value->type.Signed_Int);
+            break;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            ret_val = bacapp_snprintf_json_number(
+                str, str_len, (double)value->type.Real, true);
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            ret_val = bacapp_snprintf_json_number(
+                str, str_len, value->type.Double, false);
+            break;
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            ret_val = bacapp_snprintf_json_string(
+                str, str_len,
+                characterstring_value(&value->type.Character_String),
+                characterstring_length(&value->type.Character_String),
+                characterstring_encoding(&value->type.Character_String) ==
+                    CHARACTER_UTF8);
+            break;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            slen = bacapp_snprintf_chars(str, str_len, "\"", 1);
+            ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+            len = octetstring_length(&value->type.Octet_String);
+            octet_str = octetstring_value(
+                (BACNET_OCTET_STRING *)&value->type.Octet_String);
+            for (i = 0; i < len; i++) {
+                hex[0] = Hex_Digits[octet_str[i] >> 4];
+                hex[1] = Hex_Digits[octet_str[i] & 0x0F];
+                slen = bacapp_snprintf_chars(str, str_len, hex, sizeof(hex));
+                ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+            }
+            slen = bacapp_snprintf_chars(str, str_len, "\"", 1);
+            ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+            break;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            slen = bacapp_snprintf_chars(str, str_len, "[", 1);
+            ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+            len = bitstring_bits_used(&value->type.Bit_String);
+            for (i = 0; i < len; i++) {
+                if (i > 0) {
+                    slen = bacapp_snprintf_chars(str, str_len, ",", 1);
+                    ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+                }
+                slen = bacapp_snprintf_text(
+                    str, str_len,
+                    bitstring_bit(&value->type.Bit_String, (uint8_t)i)
+                        ? "true"
+                        : "false");
+                ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+            }
+            slen = bacapp_snprintf_chars(str, str_len, "]", 1);
+            ret_val += bacapp_snprintf_shift(slen, &str, &str_len);
+            break;
+#endif
+        default:
+            ret_val = bacapp_snprintf_json_text(str, str_len, object_value);
+            break;
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief Append a value to a text buffer, which grows as needed
+ * @param text - the text buffer, where the data is NULL or from malloc()
+ * @param object_value - ptr to BACnet object value from which to extract str
+ * @param json - true to print the value as JSON, false for EPICS
+ * @return true if the value was appended
+ */
+bool bacapp_text_value_append(
+    BACAPP_TEXT *text,
+    const BACNET_OBJECT_PROPERTY_VALUE *object_value,
+    bool json)
+{
+    char *data;
+    size_t available = 0;
+    size_t size;
+    int len;
+
+    if (!text) {
+        return false;
+    }
+    if (text->data) {
+        available = text->size - text->length;
+    }
+    if (json) {
+        len = bacapp_snprintf_value_json(
+            text->data ? &text->data[text->length] : NULL, available,
+            object_value);
+    } else {
+        len = bacapp_snprintf_value(
+            text->data ? &text->data[text->length] : NULL, available,
+            object_value);
+    }
+    if (len < 0) {
+        return false;
+    }
+    if ((size_t)len >= available) {
+        /* grow by at least double, to append many values in few moves */
+        size = text->length + (size_t)len + 1;
+        if (size < (text->size * 2)) {
+            size = text->size * 2;
+        }
+        data = realloc(text->data, size);
+        if (!data) {
+            return false;
+        }
+        text->data = data;
+        text->size = size;
+        if (json) {
+            len = bacapp_snprintf_value_json(
+                &text->data[text->length], size - text->length, object_value);
+        } else {
+            len = bacapp_snprintf_value(
+                &text->data[text->length], size - text->length, object_value);
+        }
+        if (len < 0) {
+            text->data[text->length] = 0;
+            return false;
+        }
+    }
+    text->length += (size_t)len;
+
+    return true;
+}
+
 #ifdef BACAPP_PRINT_ENABLED
 /**
  * Print the extracted value from the requested BACnet object property to the
@@ -230,6 +230,15 @@ typedef struct BACnet_Object_Property_Value {
     BACNET_APPLICATION_DATA_VALUE *value;
 } BACNET_OBJECT_PROPERTY_VALUE;
 
+/* text that the printed values are appended to, which grows as needed.
+   The data is NULL or from malloc(), and is freed by the owner. */
+typedef struct bacapp_text {
+    char *data;
+    size_t size;
+    /* characters in the data, not counting the terminating null */
+    size_t length;
+} BACAPP_TEXT;
+
 struct BACnetDeviceObjectPropertyValue;
 typedef struct BACnetDeviceObjectPropertyValue {
     BACNET_OBJECT_ID device_identifier;
@@ -421,6 +430,16 @@ int bacapp_snprintf_value(
     char *str,
     size_t str_len,
     const BACNET_OBJECT_PROPERTY_VALUE *object_value);
+BACNET_STACK_EXPORT
+int bacapp_snprintf_value_json(
+    char *str,
+    size_t str_len,
+    const BACNET_OBJECT_PROPERTY_VALUE *object_value);
+BACNET_STACK_EXPORT
+bool bacapp_text_value_append(
+    BACAPP_TEXT *text,
+    const BACNET_OBJECT_PROPERTY_VALUE *object_value,
+    bool json);
 int bacapp_snprintf_octet_string(
     char *str, size_t str_len, const BACNET_OCTET_STRING *value);
 int bacapp_snprintf_character_string(
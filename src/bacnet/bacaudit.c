@@ -8,6 +8,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -1093,3 +1094,160 @@ bool bacnet_audit_log_record_same(
 
     return status;
 }
+
+/**
+ * @brief Encode the AuditNotification service request
+ *
+ *  AuditNotification-Request ::= SEQUENCE {
+ *      notifications [0] SEQUENCE OF BACnetAuditNotification
+ *  }
+ *
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @param notifications - array of notifications to be encoded
+ * @param count - number of notifications in the array
+ * @return the number of apdu bytes encoded
+ */
+int bacnet_audit_notification_request_encode(
+    uint8_t *apdu,
+    const BACNET_AUDIT_NOTIFICATION *notifications,
+    unsigned count)
+{
+    int len, apdu_len = 0; /* total length of the apdu, return value */
+    unsigned i;
+
+    if (!notifications || (count == 0)) {
+        return 0;
+    }
+    len = encode_opening_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    for (i = 0; i < count; i++) {
+        len = bacnet_audit_log_notification_encode(apdu, &notifications[i]);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+    len = encode_closing_tag(apdu, 0);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode a complete AuditNotification APDU from a body of
+ *  BACnetAuditNotification encodings that were collected ahead of time,
+ *  so that several audit notifications share one service request.
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @param apdu_size - number of bytes available in the buffer
+ * @param confirmed - true for ConfirmedAuditNotification
+ * @param invoke_id - invokeID for the confirmed service request
+ * @param body - concatenated bacnet_audit_log_notification_encode() values
+ * @param body_len - number of bytes in the body
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+size_t bacnet_audit_notification_apdu_body_encode(
+    uint8_t *apdu,
+    size_t apdu_size,
+    bool confirmed,
+    uint8_t invoke_id,
+    const uint8_t *body,
+    size_t body_len)
+{
+    size_t apdu_len = 0; /* total length of the apdu, return value */
+    uint8_t header[4] = { 0 };
+    size_t header_len;
+
+    if (!body || (body_len == 0)) {
+        return 0;
+    }
+    if (confirmed) {
+        header[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        header[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+        header[2] = invoke_id;
+        header[3] = SERVICE_CONFIRMED_AUDIT_NOTIFICATION;
+        header_len = 4;
+    } else {
+        header[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+        header[1] = SERVICE_UNCONFIRMED_AUDIT_NOTIFICATION;
+        header_len = 2;
+    }
+    /* notifications [0] SEQUENCE OF BACnetAuditNotification */
+    apdu_len = header_len;
+    apdu_len += encode_opening_tag(NULL, 0);
+    apdu_len += body_len;
+    apdu_len += encode_closing_tag(NULL, 0);
+    if (apdu_len > apdu_size) {
+        return 0;
+    }
+    if (apdu) {
+        memcpy(apdu, header, header_len);
+        apdu_len = header_len;
+        apdu_len += encode_opening_tag(&apdu[apdu_len], 0);
+        memcpy(&apdu[apdu_len], body, body_len);
+        apdu_len += body_len;
+        apdu_len += encode_closing_tag(&apdu[apdu_len], 0);
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode the AuditNotification service request
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param notifications - array to store the decoded notifications, or NULL
+ * @param size - number of notifications the array can hold
+ * @param count - number of notifications in the request, or NULL
+ * @return number of bytes decoded, or #BACNET_STATUS_ERROR (-1) if
+ *  malformed or there are more notifications than the array can hold
+ */
+int bacnet_audit_notification_request_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_AUDIT_NOTIFICATION *notifications,
+    unsigned size,
+    unsigned *count)
+{
+    int len = 0;
+    int apdu_len = 0;
+    unsigned i = 0;
+    BACNET_AUDIT_NOTIFICATION *value = NULL;
+
+    if (!apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    /* notifications [0] SEQUENCE OF BACnetAuditNotification */
+    if (!bacnet_is_opening_tag_number(apdu, apdu_size, 0, &len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    while (!bacnet_is_closing_tag_number(
+        &apdu[apdu_len], apdu_size - apdu_len, 0, &len)) {
+        if (notifications) {
+            if (i >= size) {
+                return BACNET_STATUS_ERROR;
+            }
+            value = &notifications[i];
+        }
+        len = bacnet_audit_log_notification_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, value);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        i++;
+    }
+    apdu_len += len;
+    if (i == 0) {
+        /* the sequence shall contain at least one notification */
+        return BACNET_STATUS_ERROR;
+    }
+    if (count) {
+        *count = i;
+    }
+
+    return apdu_len;
+}
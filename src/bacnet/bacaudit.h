@@ -10,6 +10,7 @@
 #ifndef BACNET_AUDIT_H
 #define BACNET_AUDIT_H
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -234,6 +235,27 @@ bool bacnet_audit_log_notification_same(
     const BACNET_AUDIT_NOTIFICATION *value1,
     const BACNET_AUDIT_NOTIFICATION *value2);
 
+BACNET_STACK_EXPORT
+int bacnet_audit_notification_request_encode(
+    uint8_t *apdu,
+    const BACNET_AUDIT_NOTIFICATION *notifications,
+    unsigned count);
+BACNET_STACK_EXPORT
+size_t bacnet_audit_notification_apdu_body_encode(
+    uint8_t *apdu,
+    size_t apdu_size,
+    bool confirmed,
+    uint8_t invoke_id,
+    const uint8_t *body,
+    size_t body_len);
+BACNET_STACK_EXPORT
+int bacnet_audit_notification_request_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_AUDIT_NOTIFICATION *notifications,
+    unsigned size,
+    unsigned *count);
+
 BACNET_STACK_EXPORT
 int bacnet_audit_value_encode(uint8_t *apdu, const BACNET_AUDIT_VALUE *value);
 BACNET_STACK_EXPORT
@@ -111,6 +111,37 @@ uint8_t encode_max_segs_max_apdu(int max_segs, int max_apdu)
     return octet;
 }
 
+/**
+ * Encode the fixed header of a BACnet-Confirmed-Request-PDU, from
+ * clause 20.1.2.  When segmentation is enabled, the header says that a
+ * segmented response is accepted, with BACNET_MAX_SEGMENTS_ACCEPTED.
+ *
+ * @param apdu  buffer for the 4 octets of the header, or NULL for length
+ * @param invoke_id  from clause 20.1.2.6 invokeID
+ * @param service_choice  the BACNET_CONFIRMED_SERVICE of the request
+ *
+ * @return number of bytes encoded
+ */
+int encode_confirmed_request_header(
+    uint8_t *apdu, uint8_t invoke_id, uint8_t service_choice)
+{
+    if (apdu) {
+#if BACNET_SEGMENTATION_ENABLED
+        /* the reply may be sent in segments */
+        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST | BIT(1);
+        apdu[1] =
+            encode_max_segs_max_apdu(BACNET_MAX_SEGMENTS_ACCEPTED, MAX_APDU);
+#else
+        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+#endif
+        apdu[2] = invoke_id;
+        apdu[3] = service_choice;
+    }
+
+    return 4;
+}
+
 /**
  * Decode the given octed into a maximum segments value.
  *
@@ -808,30 +839,53 @@ int bacnet_application_data_length(uint8_t tag_number, uint32_t len_value_type)
     return len;
 }
 
+/* classes of the low nibble of the first octet of a tag, which holds
+   the class bit and the length/value/type field, for the skipper in
+   bacnet_enclosed_data_length() */
+#define TAG_CLASS_VALUE_MASK 0x07
+#define TAG_CLASS_EXTENDED 0x10
+#define TAG_CLASS_OPENING 0x20
+#define TAG_CLASS_CLOSING 0x40
+#define TAG_CLASS_CONTEXT 0x80
+#define TAG_CLASS_SLOW \
+    (TAG_CLASS_EXTENDED | TAG_CLASS_OPENING | TAG_CLASS_CLOSING)
+static const uint8_t Tag_Class[16] = {
+    /* application tags: the reserved values 6 and 7 have no data */
+    0, 1, 2, 3, 4, TAG_CLASS_EXTENDED, 0, 0,
+    /* context tags */
+    TAG_CLASS_CONTEXT | 0, TAG_CLASS_CONTEXT | 1, TAG_CLASS_CONTEXT | 2,
+    TAG_CLASS_CONTEXT | 3, TAG_CLASS_CONTEXT | 4,
+    TAG_CLASS_CONTEXT | TAG_CLASS_EXTENDED, TAG_CLASS_OPENING,
+    TAG_CLASS_CLOSING
+};
+/* application tags 2..12 are followed by len_value_type data octets,
+   as in bacnet_application_data_length() */
+#define TAG_CLASS_APPLICATION_DATA(n) (((n) >= 2) && ((n) <= 12))
+
 /**
  * @brief Returns the length of data between an opening tag and a closing tag.
  * @note Expects that the first octet contain the opening tag.
+ * @details Skips over the tags without a full tag decode, classifying
+ *  each tag from its first octet. The result is the same as walking the
+ *  data with bacnet_tag_decode(): only opening and closing tags with
+ *  the number of the first opening tag are counted for the nesting.
  * @param apdu Pointer to the APDU buffer
  * @param apdu_size Bytes valid in the buffer
- * @param property ID of the property to get the length for.
  * @return length of data between an opening tag and a closing tag 0..N,
  *  or BACNET_STATUS_ERROR.
  */
 int bacnet_enclosed_data_length(const uint8_t *apdu, size_t apdu_size)
 {
-    int len = 0;
-    int total_len = 0;
-    int apdu_len = 0;
-    BACNET_TAG tag = { 0 };
+    size_t apdu_len = 0;
+    size_t total_len = 0;
+    size_t len, remaining;
+    uint32_t len_value_type;
+    uint8_t octet, tag_class, tag_number;
     uint8_t opening_tag_number = 0;
     uint8_t opening_tag_number_counter = 0;
     bool total_len_enable = false;
 
-    if (!apdu) {
-        return BACNET_STATUS_ERROR;
-    }
-    if (apdu_size <= apdu_len) {
-        /* error: exceeding our buffer limit */
+    if (!apdu || (apdu_size == 0)) {
         return BACNET_STATUS_ERROR;
     }
     if (!bacnet_is_opening_tag(apdu, apdu_size)) {
@@ -839,64 +893,104 @@ int bacnet_enclosed_data_length(const uint8_t *apdu, size_t apdu_size)
         return BACNET_STATUS_ERROR;
     }
     do {
-        len = bacnet_tag_decode(apdu, apdu_size - apdu_len, &tag);
-        if (len == 0) {
-            return BACNET_STATUS_ERROR;
+        /* fast path: primitive data with a one octet tag */
+        while (opening_tag_number_counter > 0) {
+            octet = apdu[apdu_len];
+            tag_class = Tag_Class[octet & 0x0F];
+            if ((tag_class & TAG_CLASS_SLOW) || IS_EXTENDED_TAG_NUMBER(octet)) {
+                break;
+            }
+            len = 1;
+            if ((tag_class & TAG_CLASS_CONTEXT) ||
+                TAG_CLASS_APPLICATION_DATA(octet >> 4)) {
+                len += tag_class & TAG_CLASS_VALUE_MASK;
+            }
+            total_len += len;
+            apdu_len += len;
+            if (apdu_size <= apdu_len) {
+                /* error: exceeding our buffer limit */
+                return BACNET_STATUS_ERROR;
+            }
+        }
+        remaining = apdu_size - apdu_len;
+        octet = apdu[apdu_len];
+        tag_class = Tag_Class[octet & 0x0F];
+        if (IS_EXTENDED_TAG_NUMBER(octet)) {
+            if (remaining < 2) {
+                return BACNET_STATUS_ERROR;
+            }
+            tag_number = apdu[apdu_len + 1];
+            len = 2;
+        } else {
+            tag_number = octet >> 4;
+            len = 1;
+        }
+        if (tag_class & TAG_CLASS_EXTENDED) {
+            if (remaining <= len) {
+                return BACNET_STATUS_ERROR;
+            }
+            octet = apdu[apdu_len + len];
+            if ((octet == 255) && ((remaining - len) >= 5)) {
+                len_value_type = ((uint32_t)apdu[apdu_len + len + 1] << 24) |
+                    ((uint32_t)apdu[apdu_len + len + 2] << 16) |
+                    ((uint32_t)apdu[apdu_len + len + 3] << 8) |
+                    (uint32_t)apdu[apdu_len + len + 4];
+                len += 5;
+            } else if ((octet == 254) && ((remaining - len) >= 3)) {
+                len_value_type = ((uint32_t)apdu[apdu_len + len + 1] << 8) |
+                    (uint32_t)apdu[apdu_len + len + 2];
+                len += 3;
+            } else if (octet < 254) {
+                len_value_type = octet;
+                len++;
+            } else {
+                return BACNET_STATUS_ERROR;
+            }
+        } else {
+            len_value_type = tag_class & TAG_CLASS_VALUE_MASK;
         }
-        if (tag.opening) {
+        if (tag_class & TAG_CLASS_OPENING) {
             if (opening_tag_number_counter == 0) {
-                opening_tag_number = tag.number;
+                opening_tag_number = tag_number;
                 opening_tag_number_counter = 1;
                 total_len_enable = false;
-            } else if (tag.number == opening_tag_number) {
+            } else if (tag_number == opening_tag_number) {
                 total_len_enable = true;
                 opening_tag_number_counter++;
             } else {
                 total_len_enable = true;
             }
-        } else if (tag.closing) {
-            if (tag.number == opening_tag_number) {
+        } else if (tag_class & TAG_CLASS_CLOSING) {
+            if (tag_number == opening_tag_number) {
                 if (opening_tag_number_counter > 0) {
                     opening_tag_number_counter--;
                 }
             }
             total_len_enable = true;
-        } else if (tag.context) {
-            if (tag.len_value_type > INT_MAX) {
-                /* error: length is out of range */
-                return BACNET_STATUS_ERROR;
-            }
-            len += tag.len_value_type;
-            total_len_enable = true;
         } else {
-            if (tag.len_value_type > INT_MAX) {
+            if (len_value_type > INT_MAX) {
                 /* error: length is out of range */
                 return BACNET_STATUS_ERROR;
             }
-            /* application tagged data */
-            len +=
-                bacnet_application_data_length(tag.number, tag.len_value_type);
+            if ((tag_class & TAG_CLASS_CONTEXT) ||
+                TAG_CLASS_APPLICATION_DATA(tag_number)) {
+                len += len_value_type;
+            }
             total_len_enable = true;
         }
         if (opening_tag_number_counter > 0) {
-            if (len > 0) {
-                if (total_len_enable) {
-                    total_len += len;
-                }
-            } else {
-                /* error: len is not incrementing */
-                return BACNET_STATUS_ERROR;
+            if (total_len_enable) {
+                total_len += len;
             }
             apdu_len += len;
             if (apdu_size <= apdu_len) {
                 /* error: exceeding our buffer limit */
                 return BACNET_STATUS_ERROR;
             }
-            apdu += len;
         }
     } while (opening_tag_number_counter > 0);
 
-    return total_len;
+    return (int)total_len;
 }
 
 #if defined(BACNET_STACK_DEPRECATED_DISABLE)
@@ -3563,6 +3657,261 @@ bool bacnet_character_string_buffer_unpack(
     return false;
 }
 
+/**
+ * @brief Encode the BACnet Character String Value from a view
+ *  from 20.2.9 Encoding of a Character String Value
+ *  and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the bytes, or NULL for length
+ * @param value - the BACnetCharacterString view to be encoded
+ *
+ * @return returns the number of apdu bytes consumed, or 0 if invalid
+ */
+uint32_t encode_bacnet_character_string_view(
+    uint8_t *apdu, const BACNET_CHARACTER_STRING_VIEW *value)
+{
+    uint32_t apdu_len = 1 /*encoding */;
+
+    if (!value || (value->length > UINT32_MAX - 1)) {
+        return 0;
+    }
+    if ((value->length > 0) && !value->value) {
+        return 0;
+    }
+    if (apdu) {
+        apdu[0] = value->encoding;
+        if (value->length > 0) {
+            memcpy(&apdu[1], value->value, value->length);
+        }
+    }
+    apdu_len += (uint32_t)value->length;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the BACnet Character String Value from a view as context
+ *  tagged from 20.2.9 Encoding of a Character String Value
+ *  and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the bytes, or NULL for length
+ * @param tag_number - context tag number to encode
+ * @param char_string - the BACnet Character String view to be encoded
+ *
+ * @return returns the number of apdu bytes consumed
+ */
+int encode_context_character_string_view(
+    uint8_t *apdu,
+    uint8_t tag_number,
+    const BACNET_CHARACTER_STRING_VIEW *char_string)
+{
+    int apdu_len = 0;
+    int len = 0;
+    uint32_t tag_len;
+
+    tag_len = encode_bacnet_character_string_view(NULL, char_string);
+    if (tag_len == 0) {
+        /* malformed, cannot be zero */
+        return 0;
+    }
+    len = encode_tag(apdu, tag_number, true, tag_len);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_bacnet_character_string_view(apdu, char_string);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the BACnet Character String Value from a view as
+ *  application tagged from 20.2.9 Encoding of a Character String Value
+ *  and 20.2.1 General Rules for Encoding BACnet Tags
+ * @note The characters are copied once, from the view to the APDU.
+ *
+ * @param apdu - buffer to hold the bytes, or NULL for length
+ * @param char_string - the BACnet Character String view to be encoded
+ *
+ * @return returns the number of apdu bytes consumed
+ */
+int encode_application_character_string_view(
+    uint8_t *apdu, const BACNET_CHARACTER_STRING_VIEW *char_string)
+{
+    int apdu_len = 0;
+    int len = 0;
+    uint32_t tag_len;
+
+    tag_len = encode_bacnet_character_string_view(NULL, char_string);
+    if (tag_len == 0) {
+        /* malformed, cannot be zero */
+        return 0;
+    }
+    len = encode_tag(
+        apdu, BACNET_APPLICATION_TAG_CHARACTER_STRING, false, tag_len);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_bacnet_character_string_view(apdu, char_string);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the BACnet Character String Value from a view as
+ *  application tagged from 20.2.9 Encoding of a Character String Value
+ *  and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the data to be encoded, or NULL for length
+ * @param apdu_size - number of bytes in the buffer
+ * @param value - the BACnet Character String view to be encoded
+ *
+ * @return returns the number of apdu bytes encoded
+ *  or 0 if apdu_size is too small to fit the data
+ */
+int bacnet_character_string_view_application_encode(
+    uint8_t *apdu,
+    uint32_t apdu_size,
+    const BACNET_CHARACTER_STRING_VIEW *value)
+{
+    int apdu_len = 0; /* total length of the apdu, return value */
+
+    apdu_len = encode_application_character_string_view(NULL, value);
+    if (apdu_len > apdu_size) {
+        apdu_len = 0;
+    } else {
+        apdu_len = encode_application_character_string_view(apdu, value);
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decodes from bytes into a view of a BACnet Character String value
+ * from clause 20.2.9 Encoding of a Character String Value
+ * and 20.2.1 General Rules for Encoding BACnet Tags
+ * @note The view refers to the characters in the APDU, and is valid for
+ *  as long as the APDU buffer is kept.
+ *
+ * @param apdu - buffer to hold the bytes
+ * @param apdu_size - number of bytes in the buffer to decode
+ * @param len_value - number of bytes in the character string encoding
+ * @param value - the BACnetCharacterString view to be decoded
+ *
+ * @return number of bytes decoded, or zero if malformed or APDU overflow.
+ */
+int bacnet_character_string_view_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint32_t len_value,
+    BACNET_CHARACTER_STRING_VIEW *value)
+{
+    if ((len_value > apdu_size) || (len_value == 0)) {
+        /* malformed */
+        return 0;
+    }
+    if (value) {
+        value->encoding = apdu[0];
+        value->value = (const char *)&apdu[1];
+        value->length = len_value - 1;
+    }
+
+    return (int)len_value;
+}
+
+/**
+ * @brief Decodes from bytes into a view of a BACnet Character String value
+ * from clause 20.2.9 Encoding of a Character String Value
+ * and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param value - the BACnetCharacterString view to be decoded
+ *
+ * @return number of bytes decoded, zero if tag mismatch,
+ * or #BACNET_STATUS_ERROR (-1) if malformed
+ */
+int bacnet_character_string_view_application_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_CHARACTER_STRING_VIEW *value)
+{
+    int apdu_len = BACNET_STATUS_ERROR;
+    int len = 0;
+    BACNET_TAG tag = { 0 };
+
+    if (apdu_size == 0) {
+        return 0;
+    }
+    len = bacnet_tag_decode(apdu, apdu_size, &tag);
+    if (len > 0) {
+        if (tag.application &&
+            (tag.number == BACNET_APPLICATION_TAG_CHARACTER_STRING)) {
+            apdu_len = len;
+            len = bacnet_character_string_view_decode(
+                &apdu[len], apdu_size - apdu_len, tag.len_value_type, value);
+            if (len > 0) {
+                apdu_len += len;
+            } else {
+                apdu_len = BACNET_STATUS_ERROR;
+            }
+        } else {
+            apdu_len = 0;
+        }
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decodes from bytes into a view of a BACnet Character String value
+ * from clause 20.2.9 Encoding of a Character String Value
+ * and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the bytes
+ * @param apdu_size - number of bytes in the buffer to decode
+ * @param tag_value - context tag number expected
+ * @param value - the BACnetCharacterString view to be decoded
+ *
+ * @return  number of bytes decoded, or zero if tag mismatch, or
+ * #BACNET_STATUS_ERROR (-1) if malformed
+ */
+int bacnet_character_string_view_context_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint8_t tag_value,
+    BACNET_CHARACTER_STRING_VIEW *value)
+{
+    int apdu_len = BACNET_STATUS_ERROR;
+    int len = 0;
+    BACNET_TAG tag = { 0 };
+
+    if (apdu_size == 0) {
+        return 0;
+    }
+    len = bacnet_tag_decode(apdu, apdu_size, &tag);
+    if (len > 0) {
+        if (tag.context && (tag.number == tag_value)) {
+            apdu_len = len;
+            len = bacnet_character_string_view_decode(
+                &apdu[apdu_len], apdu_size - apdu_len, tag.len_value_type,
+                value);
+            if (len > 0) {
+                apdu_len += len;
+            } else {
+                apdu_len = BACNET_STATUS_ERROR;
+            }
+        } else {
+            apdu_len = 0;
+        }
+    }
+
+    return apdu_len;
+}
+
 /**
  * @brief Decodes from bytes into a BACnet Unsigned value
  * from clause 20.2.4 Encoding of an Unsigned Integer Value
@@ -3874,6 +4223,52 @@ int encode_bacnet_unsigned(uint8_t *apdu, BACNET_UNSIGNED_INTEGER value)
     return len;
 }
 
+/**
+ * @brief Encode consecutive BACnet Unsigned values as application tagged
+ *  Unsigned values, in one pass. As defined in clause 20.2.4 Encoding of
+ *  an Unsigned Integer Value and 20.2.1 General Rules for Encoding BACnet
+ *  Tags.
+ *
+ *  The encoding is the same as encode_application_unsigned() for each
+ *  value, with the tag and the value octets written in the same loop.
+ *
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @param values - array of the values to be encoded
+ * @param count - number of values in the array
+ *
+ * @return the number of apdu bytes encoded
+ */
+int encode_application_unsigned_array(
+    uint8_t *apdu, const BACNET_UNSIGNED_INTEGER *values, size_t count)
+{
+    int apdu_len = 0;
+    int len, shift;
+    size_t i;
+
+    if (!values) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        len = bacnet_unsigned_length(values[i]);
+        if (apdu) {
+            if (len <= 4) {
+                *apdu++ =
+                    (uint8_t)((BACNET_APPLICATION_TAG_UNSIGNED_INT << 4) | len);
+            } else {
+                /* extended length octet */
+                *apdu++ = (BACNET_APPLICATION_TAG_UNSIGNED_INT << 4) | 5;
+                *apdu++ = (uint8_t)len;
+            }
+            for (shift = (len - 1) * 8; shift >= 0; shift -= 8) {
+                *apdu++ = (uint8_t)(values[i] >> shift);
+            }
+        }
+        apdu_len += len + ((len > 4) ? 2 : 1);
+    }
+
+    return apdu_len;
+}
+
 /**
  * @brief Encode the BACnet Unsigned value as Context Tagged
  * as defined in clause 20.2.4 Encoding of an Unsigned Integer Value
@@ -4524,6 +4919,45 @@ int encode_application_real(uint8_t *apdu, float value)
     return apdu_len;
 }
 
+/**
+ * @brief Encode consecutive real floating values as application tagged
+ *  REAL values, in one pass. From clause 20.2.6 Encoding of a Real Number
+ *  Value and 20.2.1 General Rules for Encoding BACnet Tags.
+ *
+ *  The encoding is the same as encode_application_real() for each value.
+ *  The tag octet is the same for every value, and each value is copied
+ *  into an integer and shifted out most significant octet first, so the
+ *  loop has no calls or byte order tests and the compiler is free to
+ *  unroll it or to use its vector byte swap.
+ *
+ * @param apdu  buffer to be encoded, or NULL for length
+ * @param values  array of the float values to be encoded
+ * @param count  number of values in the array
+ *
+ * @return the number of apdu bytes encoded
+ */
+int encode_application_real_array(
+    uint8_t *apdu, const float *values, size_t count)
+{
+    uint32_t value;
+    size_t i;
+
+    if (apdu && values) {
+        for (i = 0; i < count; i++) {
+            /* NOTE: assumes float and uint32_t have the same byte order */
+            memcpy(&value, &values[i], sizeof(value));
+            apdu[0] = (BACNET_APPLICATION_TAG_REAL << 4) | 4;
+            apdu[1] = (uint8_t)(value >> 24);
+            apdu[2] = (uint8_t)(value >> 16);
+            apdu[3] = (uint8_t)(value >> 8);
+            apdu[4] = (uint8_t)value;
+            apdu += 5;
+        }
+    }
+
+    return (int)(count * 5);
+}
+
 /**
  * @brief Encode a real floating value with a given tag. From clause 20.2.6
  *        Encoding of a Real Number Value and 20.2.1 General Rules for
@@ -6027,3 +6461,401 @@ BACNET_ERROR_CODE bacnet_list_write(
 
     return error_code;
 }
+
+/**
+ * @brief Start a walk over the tags of an APDU
+ * @param iter - iterator to initialize
+ * @param apdu - buffer of encoded tags, which must outlive the iterator
+ * @param apdu_size - number of bytes in the buffer
+ */
+void bacnet_tag_iterator_init(
+    BACNET_TAG_ITERATOR *iter, const uint8_t *apdu, uint32_t apdu_size)
+{
+    if (iter) {
+        iter->apdu = apdu;
+        iter->apdu_size = apdu_size;
+        iter->offset = 0;
+        iter->depth = 0;
+        iter->error = false;
+    }
+}
+
+/**
+ * @brief Get the next tag of the APDU, without copying its value
+ * @details Opening tags increment the depth and closing tags decrement
+ *  it, so a caller can tell the end of a constructed value from the
+ *  depth alone. Tag numbers of opening and closing tags are not matched.
+ * @param iter - iterator from bacnet_tag_iterator_init()
+ * @param view - the tag and its value octets, or NULL to just advance
+ * @return true if a tag was decoded, or false at the end of the APDU
+ *  or on a malformed tag, which also sets iter->error
+ */
+bool bacnet_tag_iterator_next(BACNET_TAG_ITERATOR *iter, BACNET_TAG_VIEW *view)
+{
+    BACNET_TAG tag = { 0 };
+    uint32_t apdu_len, value_len = 0;
+    int len;
+
+    if (!iter || !iter->apdu || iter->error ||
+        (iter->offset >= iter->apdu_size)) {
+        return false;
+    }
+    apdu_len = iter->apdu_size - iter->offset;
+    len = bacnet_tag_decode(&iter->apdu[iter->offset], apdu_len, &tag);
+    if (len <= 0) {
+        iter->error = true;
+        return false;
+    }
+    if (tag.closing) {
+        if (iter->depth == 0) {
+            /* closing tag without an opening tag */
+            iter->error = true;
+            return false;
+        }
+        iter->depth--;
+    } else if (tag.context) {
+        value_len = tag.len_value_type;
+    } else if (tag.application &&
+               (tag.number != BACNET_APPLICATION_TAG_BOOLEAN)) {
+        /* the application boolean value is in the tag */
+        value_len = tag.len_value_type;
+    }
+    if (value_len > (apdu_len - len)) {
+        iter->error = true;
+        return false;
+    }
+    if (view) {
+        view->tag = tag;
+        view->depth = iter->depth;
+        if (tag.opening || tag.closing) {
+            view->value = NULL;
+        } else {
+            view->value = &iter->apdu[iter->offset + len];
+        }
+        view->value_len = value_len;
+    }
+    if (tag.opening) {
+        iter->depth++;
+    }
+    iter->offset += len + value_len;
+
+    return true;
+}
+
+/**
+ * @brief Skip the rest of the constructed value that the iterator is in,
+ *  such as a property value that the caller does not need
+ * @param iter - iterator that has returned an opening tag
+ * @return true if the closing tag was found, or false at the end of the
+ *  APDU, on a malformed tag, or if the iterator is not inside an
+ *  opening tag
+ */
+bool bacnet_tag_iterator_skip(BACNET_TAG_ITERATOR *iter)
+{
+    unsigned depth;
+
+    if (!iter || (iter->depth == 0)) {
+        return false;
+    }
+    depth = iter->depth - 1;
+    while (bacnet_tag_iterator_next(iter, NULL)) {
+        if (iter->depth == depth) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Check that a tag view holds primitive data of a type
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param tag_number - application tag number of the type. Context tags
+ *  are taken as the type that the caller asks for.
+ * @return true if the view holds primitive data of the type
+ */
+static bool bacnet_tag_view_primitive(
+    const BACNET_TAG_VIEW *view, uint8_t tag_number)
+{
+    if (!view || !view->value) {
+        return false;
+    }
+    if (view->tag.context) {
+        return true;
+    }
+
+    return view->tag.application && (view->tag.number == tag_number);
+}
+
+/**
+ * @brief Get a Null from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @return true if the view holds a Null
+ */
+bool bacnet_tag_view_null(const BACNET_TAG_VIEW *view)
+{
+    return bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_NULL) &&
+        (view->value_len == 0);
+}
+
+/**
+ * @brief Get a Boolean from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - decoded value
+ * @return true if the view holds a Boolean
+ */
+bool bacnet_tag_view_boolean(const BACNET_TAG_VIEW *view, bool *value)
+{
+    bool boolean_value;
+
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_BOOLEAN)) {
+        return false;
+    }
+    if (view->tag.application) {
+        boolean_value = view->tag.len_value_type != 0;
+    } else if (view->value_len == 1) {
+        boolean_value = view->value[0] != 0;
+    } else {
+        return false;
+    }
+    if (value) {
+        *value = boolean_value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get an Unsigned Integer from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - decoded value
+ * @return true if the view holds an Unsigned Integer
+ */
+bool bacnet_tag_view_unsigned(
+    const BACNET_TAG_VIEW *view, BACNET_UNSIGNED_INTEGER *value)
+{
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+
+    if (!bacnet_tag_view_primitive(
+            view, BACNET_APPLICATION_TAG_UNSIGNED_INT)) {
+        return false;
+    }
+    if (bacnet_unsigned_decode(
+            view->value, view->value_len, view->value_len, &unsigned_value) <=
+        0) {
+        return false;
+    }
+    if (value) {
+        *value = unsigned_value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get a Signed Integer from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - decoded value
+ * @return true if the view holds a Signed Integer
+ */
+bool bacnet_tag_view_signed(const BACNET_TAG_VIEW *view, int32_t *value)
+{
+    int32_t signed_value = 0;
+
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_SIGNED_INT)) {
+        return false;
+    }
+    if (bacnet_signed_decode(
+            view->value, view->value_len, view->value_len, &signed_value) <=
+        0) {
+        return false;
+    }
+    if (value) {
+        *value = signed_value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get a Real from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - decoded value
+ * @return true if the view holds a Real
+ */
+bool bacnet_tag_view_real(const BACNET_TAG_VIEW *view, float *value)
+{
+    float real_value = 0.0f;
+
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_REAL)) {
+        return false;
+    }
+    if (bacnet_real_decode(
+            view->value, view->value_len, view->value_len, &real_value) <= 0) {
+        return false;
+    }
+    if (value) {
+        *value = real_value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get a Double from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - decoded value
+ * @return true if the view holds a Double
+ */
+bool bacnet_tag_view_double(const BACNET_TAG_VIEW *view, double *value)
+{
+    double double_value = 0.0;
+
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_DOUBLE)) {
+        return false;
+    }
+    if (bacnet_double_decode(
+            view->value, view->value_len, view->value_len, &double_value) <=
+        0) {
+        return false;
+    }
+    if (value) {
+        *value = double_value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get an Enumerated from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - decoded value
+ * @return true if the view holds an Enumerated
+ */
+bool bacnet_tag_view_enumerated(const BACNET_TAG_VIEW *view, uint32_t *value)
+{
+    uint32_t enum_value = 0;
+
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_ENUMERATED)) {
+        return false;
+    }
+    if (bacnet_enumerated_decode(
+            view->value, view->value_len, view->value_len, &enum_value) <= 0) {
+        return false;
+    }
+    if (value) {
+        *value = enum_value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get a BACnetObjectIdentifier from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param object_type - decoded object type
+ * @param instance - decoded object instance
+ * @return true if the view holds a BACnetObjectIdentifier
+ */
+bool bacnet_tag_view_object_id(
+    const BACNET_TAG_VIEW *view,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *instance)
+{
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_OBJECT_ID)) {
+        return false;
+    }
+
+    return bacnet_object_id_decode(
+               view->value, view->value_len, view->value_len, object_type,
+               instance) > 0;
+}
+
+/**
+ * @brief Get a Date from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - decoded value
+ * @return true if the view holds a Date
+ */
+bool bacnet_tag_view_date(const BACNET_TAG_VIEW *view, BACNET_DATE *value)
+{
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_DATE)) {
+        return false;
+    }
+
+    return bacnet_date_decode(
+               view->value, view->value_len, view->value_len, value) > 0;
+}
+
+/**
+ * @brief Get a Time from a tag view
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - decoded value
+ * @return true if the view holds a Time
+ */
+bool bacnet_tag_view_time(const BACNET_TAG_VIEW *view, BACNET_TIME *value)
+{
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_TIME)) {
+        return false;
+    }
+
+    return bacnet_time_decode(
+               view->value, view->value_len, view->value_len, value) > 0;
+}
+
+/**
+ * @brief Get an Octet String from a tag view, without copying it
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param value - the octets, in the APDU
+ * @param length - number of octets
+ * @return true if the view holds an Octet String
+ */
+bool bacnet_tag_view_octet_string(
+    const BACNET_TAG_VIEW *view, const uint8_t **value, uint32_t *length)
+{
+    if (!bacnet_tag_view_primitive(view, BACNET_APPLICATION_TAG_OCTET_STRING)) {
+        return false;
+    }
+    if (value) {
+        *value = view->value;
+    }
+    if (length) {
+        *length = view->value_len;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get a Character String from a tag view, without copying it
+ * @param view - tag view from bacnet_tag_iterator_next()
+ * @param encoding - character set of the string
+ * @param value - the characters, in the APDU, which are not terminated
+ * @param length - number of octets of characters
+ * @return true if the view holds a Character String
+ */
+bool bacnet_tag_view_character_string(
+    const BACNET_TAG_VIEW *view,
+    uint8_t *encoding,
+    const char **value,
+    uint32_t *length)
+{
+    if (!bacnet_tag_view_primitive(
+            view, BACNET_APPLICATION_TAG_CHARACTER_STRING)) {
+        return false;
+    }
+    if (view->value_len < 1) {
+        return false;
+    }
+    if (encoding) {
+        *encoding = view->value[0];
+    }
+    if (value) {
+        *value = (const char *)&view->value[1];
+    }
+    if (length) {
+        *length = view->value_len - 1;
+    }
+
+    return true;
+}
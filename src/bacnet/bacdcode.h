@@ -91,6 +91,27 @@ typedef struct BACnetTag {
 /* max size of a BACnet tag */
 #define BACNET_TAG_SIZE 7
 
+/* one tag in an APDU, as returned by bacnet_tag_iterator_next().
+   The value points into the APDU, so it is valid as long as the APDU. */
+typedef struct BACnetTagView {
+    BACNET_TAG tag;
+    /* nesting depth of the tag: opening and closing tags pair at a depth */
+    unsigned depth;
+    /* primitive data octets, or NULL for opening and closing tags */
+    const uint8_t *value;
+    uint32_t value_len;
+} BACNET_TAG_VIEW;
+
+/* pull-style walk over the tags of an APDU, without copying the values */
+typedef struct BACnetTagIterator {
+    const uint8_t *apdu;
+    uint32_t apdu_size;
+    uint32_t offset;
+    unsigned depth;
+    /* true if the walk stopped on a malformed or unbalanced tag */
+    bool error;
+} BACNET_TAG_ITERATOR;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -265,6 +286,9 @@ int bacnet_bitstring_context_decode(
 BACNET_STACK_EXPORT
 int encode_application_real(uint8_t *apdu, float value);
 BACNET_STACK_EXPORT
+int encode_application_real_array(
+    uint8_t *apdu, const float *values, size_t count);
+BACNET_STACK_EXPORT
 int encode_context_real(uint8_t *apdu, uint8_t tag_number, float value);
 BACNET_STACK_DEPRECATED("Use bacnet_real_context_decode() instead")
 BACNET_STACK_EXPORT
@@ -528,6 +552,40 @@ bool bacnet_character_string_buffer_unpack(
     char *buffer,
     uint32_t *buffer_length);
 
+BACNET_STACK_EXPORT
+uint32_t encode_bacnet_character_string_view(
+    uint8_t *apdu, const BACNET_CHARACTER_STRING_VIEW *value);
+BACNET_STACK_EXPORT
+int encode_context_character_string_view(
+    uint8_t *apdu,
+    uint8_t tag_number,
+    const BACNET_CHARACTER_STRING_VIEW *char_string);
+BACNET_STACK_EXPORT
+int encode_application_character_string_view(
+    uint8_t *apdu, const BACNET_CHARACTER_STRING_VIEW *char_string);
+BACNET_STACK_EXPORT
+int bacnet_character_string_view_application_encode(
+    uint8_t *apdu,
+    uint32_t apdu_size,
+    const BACNET_CHARACTER_STRING_VIEW *value);
+BACNET_STACK_EXPORT
+int bacnet_character_string_view_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint32_t len_value,
+    BACNET_CHARACTER_STRING_VIEW *value);
+BACNET_STACK_EXPORT
+int bacnet_character_string_view_application_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_CHARACTER_STRING_VIEW *value);
+BACNET_STACK_EXPORT
+int bacnet_character_string_view_context_decode(
+    const uint8_t *apdu,
+    uint32_t apdu_size,
+    uint8_t tag_value,
+    BACNET_CHARACTER_STRING_VIEW *value);
+
 BACNET_STACK_EXPORT
 int encode_bacnet_character_string(
     uint8_t *apdu, const BACNET_CHARACTER_STRING *char_string);
@@ -578,6 +636,9 @@ int encode_context_unsigned(
     uint8_t *apdu, uint8_t tag_number, BACNET_UNSIGNED_INTEGER value);
 BACNET_STACK_EXPORT
 int encode_application_unsigned(uint8_t *apdu, BACNET_UNSIGNED_INTEGER value);
+BACNET_STACK_EXPORT
+int encode_application_unsigned_array(
+    uint8_t *apdu, const BACNET_UNSIGNED_INTEGER *values, size_t count);
 BACNET_STACK_DEPRECATED("Use bacnet_unsigned_decode() instead")
 BACNET_STACK_EXPORT
 int decode_unsigned(
@@ -783,6 +844,9 @@ bool bacnet_constructed_value_copy(
 BACNET_STACK_EXPORT
 uint8_t encode_max_segs_max_apdu(int max_segs, int max_apdu);
 BACNET_STACK_EXPORT
+int encode_confirmed_request_header(
+    uint8_t *apdu, uint8_t invoke_id, uint8_t service_choice);
+BACNET_STACK_EXPORT
 int decode_max_segs(uint8_t octet);
 BACNET_STACK_EXPORT
 int decode_max_apdu(uint8_t octet);
@@ -820,6 +884,48 @@ BACNET_ERROR_CODE bacnet_list_write(
     uint8_t *apdu,
     size_t apdu_size);
 
+BACNET_STACK_EXPORT
+void bacnet_tag_iterator_init(
+    BACNET_TAG_ITERATOR *iter, const uint8_t *apdu, uint32_t apdu_size);
+BACNET_STACK_EXPORT
+bool bacnet_tag_iterator_next(BACNET_TAG_ITERATOR *iter, BACNET_TAG_VIEW *view);
+BACNET_STACK_EXPORT
+bool bacnet_tag_iterator_skip(BACNET_TAG_ITERATOR *iter);
+
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_null(const BACNET_TAG_VIEW *view);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_boolean(const BACNET_TAG_VIEW *view, bool *value);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_unsigned(
+    const BACNET_TAG_VIEW *view, BACNET_UNSIGNED_INTEGER *value);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_signed(const BACNET_TAG_VIEW *view, int32_t *value);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_real(const BACNET_TAG_VIEW *view, float *value);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_double(const BACNET_TAG_VIEW *view, double *value);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_enumerated(const BACNET_TAG_VIEW *view, uint32_t *value);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_object_id(
+    const BACNET_TAG_VIEW *view,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *instance);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_date(const BACNET_TAG_VIEW *view, BACNET_DATE *value);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_time(const BACNET_TAG_VIEW *view, BACNET_TIME *value);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_octet_string(
+    const BACNET_TAG_VIEW *view, const uint8_t **value, uint32_t *length);
+BACNET_STACK_EXPORT
+bool bacnet_tag_view_character_string(
+    const BACNET_TAG_VIEW *view,
+    uint8_t *encoding,
+    const char **value,
+    uint32_t *length);
+
 /* from clause 20.2.1.2 Tag Number */
 /* true if extended tag numbering is used */
 #define IS_EXTENDED_TAG_NUMBER(x) (((x) & 0xF0) == 0xF0)
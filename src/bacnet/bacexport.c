@@ -0,0 +1,1030 @@
+/**
+ * @file
+ * @brief Export encoded BACnet application data as JSON or CBOR.
+ *  The tags are walked in the APDU and each value is written as soon as
+ *  it is decoded, so that the service data, such as a ReadPropertyMultiple
+ *  acknowledgment or a COV notification, is not decoded into a list of
+ *  values before it is exported.
+ *
+ *  The values are exported with the same data model in both formats:
+ *  null, booleans, integers, REAL and DOUBLE numbers, character strings,
+ *  octet strings (a hex string in JSON and a byte string in CBOR), and
+ *  bit strings as an array of booleans. Other application data, such as
+ *  enumerations, dates, times and object identifiers, is a string with
+ *  the EPICS text of the value. A context tagged value is a map of its
+ *  tag number to its data, and a list of values is an array unless it
+ *  has a single value.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacreal.h"
+#include "bacnet/bacexport.h"
+
+/* CBOR major types and simple values from RFC 8949 */
+#define CBOR_MAJOR_UNSIGNED 0
+#define CBOR_MAJOR_NEGATIVE 1
+#define CBOR_MAJOR_BYTES 2
+#define CBOR_MAJOR_TEXT 3
+#define CBOR_MAJOR_ARRAY 4
+#define CBOR_MAJOR_MAP 5
+#define CBOR_INDEFINITE 31
+#define CBOR_FALSE 0xF4
+#define CBOR_TRUE 0xF5
+#define CBOR_NULL 0xF6
+#define CBOR_FLOAT32 0xFA
+#define CBOR_FLOAT64 0xFB
+#define CBOR_BREAK 0xFF
+
+/* an array or a map with a count that is not known when it begins */
+#define BACEXPORT_COUNT_INDEFINITE (-1)
+
+static const char Hex_Digits[] = "0123456789ABCDEF";
+
+/**
+ * @brief Get the space left in the export buffer
+ * @param exp - export state
+ * @return the number of octets left, including the terminating zero
+ */
+static size_t bacexport_room(const BACEXPORT *exp)
+{
+    if (!exp->buffer || (exp->length >= exp->size)) {
+        return 0;
+    }
+
+    return exp->size - exp->length;
+}
+
+/**
+ * @brief Write octets to the export, keeping the export terminated
+ * @param exp - export state
+ * @param data - octets to write
+ * @param data_len - number of octets to write
+ */
+static void
+bacexport_octets(BACEXPORT *exp, const void *data, size_t data_len)
+{
+    size_t room, copy_len;
+
+    room = bacexport_room(exp);
+    if (room > 0) {
+        copy_len = data_len;
+        if (copy_len >= room) {
+            copy_len = room - 1;
+        }
+        memcpy(&exp->buffer[exp->length], data, copy_len);
+        exp->buffer[exp->length + copy_len] = 0;
+    }
+    exp->length += data_len;
+}
+
+/**
+ * @brief Write one octet to the export
+ * @param exp - export state
+ * @param octet - octet to write
+ */
+static void bacexport_octet(BACEXPORT *exp, uint8_t octet)
+{
+    bacexport_octets(exp, &octet, 1);
+}
+
+/**
+ * @brief Write the decimal digits of an unsigned value as JSON text
+ * @param exp - export state
+ * @param value - value to write
+ */
+static void bacexport_digits(BACEXPORT *exp, BACNET_UNSIGNED_INTEGER value)
+{
+    char digits[24];
+    size_t len = sizeof(digits);
+
+    do {
+        len--;
+        digits[len] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value > 0);
+    bacexport_octets(exp, &digits[len], sizeof(digits) - len);
+}
+
+/**
+ * @brief Write a CBOR data item head with its argument
+ * @param exp - export state
+ * @param major - CBOR major type
+ * @param value - argument of the head, such as a value or a length
+ */
+static void bacexport_cbor_head(
+    BACEXPORT *exp, uint8_t major, BACNET_UNSIGNED_INTEGER value)
+{
+    uint8_t head[9];
+    size_t octets, i;
+    uint8_t info;
+
+    if (value < 24) {
+        head[0] = (uint8_t)((major << 5) | value);
+        bacexport_octets(exp, head, 1);
+        return;
+    }
+    /* the argument follows in 1, 2, 4 or 8 octets, big-endian */
+    octets = 1;
+    info = 24;
+    while ((octets < sizeof(value)) && ((value >> (8 * octets)) != 0)) {
+        octets *= 2;
+        info++;
+    }
+    head[0] = (uint8_t)((major << 5) | info);
+    for (i = 0; i < octets; i++) {
+        head[1 + i] = (uint8_t)(value >> (8 * (octets - 1 - i)));
+    }
+    bacexport_octets(exp, head, 1 + octets);
+}
+
+/**
+ * @brief Begin a value, with the JSON separator when one is needed
+ * @param exp - export state
+ */
+static void bacexport_value_begin(BACEXPORT *exp)
+{
+    if ((exp->format == BACEXPORT_FORMAT_JSON) && exp->separator) {
+        bacexport_octet(exp, ',');
+    }
+    exp->separator = true;
+}
+
+/**
+ * @brief Begin an array or a map
+ * @param exp - export state
+ * @param major - CBOR_MAJOR_ARRAY or CBOR_MAJOR_MAP
+ * @param count - number of elements or pairs, or BACEXPORT_COUNT_INDEFINITE
+ */
+static void bacexport_container_begin(BACEXPORT *exp, uint8_t major, int count)
+{
+    bacexport_value_begin(exp);
+    if (exp->format == BACEXPORT_FORMAT_JSON) {
+        bacexport_octet(exp, (major == CBOR_MAJOR_MAP) ? '{' : '[');
+    } else if (count < 0) {
+        bacexport_octet(exp, (uint8_t)((major << 5) | CBOR_INDEFINITE));
+    } else {
+        bacexport_cbor_head(exp, major, (BACNET_UNSIGNED_INTEGER)count);
+    }
+    exp->separator = false;
+}
+
+/**
+ * @brief End an array or a map
+ * @param exp - export state
+ * @param major - CBOR_MAJOR_ARRAY or CBOR_MAJOR_MAP
+ * @param count - the count given when the array or map began
+ */
+static void bacexport_container_end(BACEXPORT *exp, uint8_t major, int count)
+{
+    if (exp->format == BACEXPORT_FORMAT_JSON) {
+        bacexport_octet(exp, (major == CBOR_MAJOR_MAP) ? '}' : ']');
+    } else if (count < 0) {
+        bacexport_octet(exp, CBOR_BREAK);
+    }
+    exp->separator = true;
+}
+
+/**
+ * @brief Write the key of the next pair of a map
+ * @param exp - export state
+ * @param name - key, which needs no JSON escapes
+ */
+static void bacexport_key(BACEXPORT *exp, const char *name)
+{
+    size_t len = strlen(name);
+
+    bacexport_value_begin(exp);
+    if (exp->format == BACEXPORT_FORMAT_JSON) {
+        bacexport_octet(exp, '"');
+        bacexport_octets(exp, name, len);
+        bacexport_octets(exp, "\":", 2);
+    } else {
+        bacexport_cbor_head(exp, CBOR_MAJOR_TEXT, len);
+        bacexport_octets(exp, name, len);
+    }
+    exp->separator = false;
+}
+
+/**
+ * @brief Write a tag number as the key of the next pair of a map
+ * @param exp - export state
+ * @param tag_number - context tag number
+ */
+static void bacexport_key_number(BACEXPORT *exp, uint8_t tag_number)
+{
+    bacexport_value_begin(exp);
+    if (exp->format == BACEXPORT_FORMAT_JSON) {
+        bacexport_octet(exp, '"');
+        bacexport_digits(exp, tag_number);
+        bacexport_octets(exp, "\":", 2);
+    } else {
+        bacexport_cbor_head(exp, CBOR_MAJOR_UNSIGNED, tag_number);
+    }
+    exp->separator = false;
+}
+
+/**
+ * @brief Write an unsigned value
+ * @param exp - export state
+ * @param value - value to write
+ */
+static void bacexport_unsigned(BACEXPORT *exp, BACNET_UNSIGNED_INTEGER value)
+{
+    bacexport_value_begin(exp);
+    if (exp->format == BACEXPORT_FORMAT_JSON) {
+        bacexport_digits(exp, value);
+    } else {
+        bacexport_cbor_head(exp, CBOR_MAJOR_UNSIGNED, value);
+    }
+}
+
+/**
+ * @brief Write octets as a JSON hex string or a CBOR byte string,
+ *  after the value has begun
+ * @param exp - export state
+ * @param data - octets to write
+ * @param data_len - number of octets
+ */
+static void
+bacexport_bytes(BACEXPORT *exp, const uint8_t *data, size_t data_len)
+{
+    char hex[2];
+    size_t i;
+
+    if (exp->format == BACEXPORT_FORMAT_JSON) {
+        bacexport_octet(exp, '"');
+        for (i = 0; i < data_len; i++) {
+            hex[0] = Hex_Digits[data[i] >> 4];
+            hex[1] = Hex_Digits[data[i] & 0x0F];
+            bacexport_octets(exp, hex, sizeof(hex));
+        }
+        bacexport_octet(exp, '"');
+    } else {
+        bacexport_cbor_head(exp, CBOR_MAJOR_BYTES, data_len);
+        bacexport_octets(exp, data, data_len);
+    }
+}
+
+/**
+ * @brief Write the EPICS text of a value as a CBOR text string
+ * @param exp - export state
+ * @param object_value - value with the object and property that it is from
+ * @return true if the text was written
+ */
+static bool bacexport_cbor_text(
+    BACEXPORT *exp, const BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    int len;
+    size_t room;
+
+    len = bacapp_snprintf_value(NULL, 0, object_value);
+    if (len < 0) {
+        return false;
+    }
+    bacexport_cbor_head(exp, CBOR_MAJOR_TEXT, (BACNET_UNSIGNED_INTEGER)len);
+    room = bacexport_room(exp);
+    if (room > 0) {
+        bacapp_snprintf_value(
+            (char *)&exp->buffer[exp->length], room, object_value);
+    }
+    exp->length += (size_t)len;
+
+    return true;
+}
+
+/**
+ * @brief Write a decoded application data value
+ * @param exp - export state
+ * @param object_value - value with the object and property that it is from
+ * @return true if the value was written
+ */
+static bool bacexport_application_value(
+    BACEXPORT *exp, const BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    const BACNET_APPLICATION_DATA_VALUE *value = object_value->value;
+    uint8_t number[9];
+    size_t room;
+    int len;
+#if defined(BACAPP_BIT_STRING)
+    uint8_t i, bits_used;
+#endif
+
+    bacexport_value_begin(exp);
+    if (exp->format == BACEXPORT_FORMAT_JSON) {
+        room = bacexport_room(exp);
+        len = bacapp_snprintf_value_json(
+            room ? (char *)&exp->buffer[exp->length] : NULL, room,
+            object_value);
+        if (len < 0) {
+            return false;
+        }
+        exp->length += (size_t)len;
+        return true;
+    }
+    switch (value->tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            bacexport_octet(exp, CBOR_NULL);
+            break;
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            bacexport_octet(exp, value->type.Boolean ? CBOR_TRUE : CBOR_FALSE);
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            bacexport_cbor_head(
+                exp, CBOR_MAJOR_UNSIGNED, value->type.Unsigned_Int);
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            if (value->type.Signed_Int < 0) {
+                /* a negative integer N is encoded as -1 - N */
+                bacexport_cbor_head(
+                    exp, CBOR_MAJOR_NEGATIVE,
+                    (uint32_t)(-(value->type.Signed_Int + 1)));
+            } else {
+                bacexport_cbor_head(
+                    exp, CBOR_MAJOR_UNSIGNED,
+                    (uint32_t)value->type.Signed_Int);
+            }
+            break;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            /* BACnet and CBOR both use IEEE-754 in big-endian order */
+            number[0] = CBOR_FLOAT32;
+            len = encode_bacnet_real(value->type.Real, &number[1]);
+            bacexport_octets(exp, number, 1 + (size_t)len);
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            number[0] = CBOR_FLOAT64;
+            len = encode_bacnet_double(value->type.Double, &number[1]);
+            bacexport_octets(exp, number, 1 + (size_t)len);
+            break;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            bacexport_bytes(
+                exp, octetstring_value((BACNET_OCTET_STRING *)&value->type
+                                           .Octet_String),
+                octetstring_length(&value->type.Octet_String));
+            break;
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            if (characterstring_encoding(&value->type.Character_String) !=
+                CHARACTER_UTF8) {
+                return bacexport_cbor_text(exp, object_value);
+            }
+            len = (int)characterstring_length(&value->type.Character_String);
+            bacexport_cbor_head(
+                exp, CBOR_MAJOR_TEXT, (BACNET_UNSIGNED_INTEGER)len);
+            bacexport_octets(
+                exp, characterstring_value(&value->type.Character_String),
+                (size_t)len);
+            break;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            bits_used = bitstring_bits_used(&value->type.Bit_String);
+            bacexport_cbor_head(exp, CBOR_MAJOR_ARRAY, bits_used);
+            for (i = 0; i < bits_used; i++) {
+                bacexport_octet(
+                    exp,
+                    bitstring_bit(&value->type.Bit_String, i) ? CBOR_TRUE
+                                                              : CBOR_FALSE);
+            }
+            break;
+#endif
+        default:
+            return bacexport_cbor_text(exp, object_value);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Decode and write one application tagged value
+ * @param exp - export state
+ * @param apdu - encoded application data
+ * @param apdu_size - number of octets in the buffer
+ * @param object_value - the object and property that the value is from
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+static int bacexport_application_element(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len;
+
+    len = bacapp_decode_application_data(apdu, apdu_size, &value);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    object_value->value = &value;
+    if (!bacexport_application_value(exp, object_value)) {
+        len = BACNET_STATUS_ERROR;
+    }
+    object_value->value = NULL;
+
+    return len;
+}
+
+/**
+ * @brief Count the elements of a list up to its closing tag, or the end
+ *  of the buffer. An element is one tagged value, or an opening tag with
+ *  its data and closing tag.
+ * @param apdu - encoded list
+ * @param apdu_size - number of octets in the buffer
+ * @return number of elements, or BACNET_STATUS_ERROR
+ */
+static int bacexport_element_count(const uint8_t *apdu, size_t apdu_size)
+{
+    BACNET_TAG_ITERATOR iter = { 0 };
+    BACNET_TAG_VIEW view = { 0 };
+    int count = 0;
+
+    bacnet_tag_iterator_init(&iter, apdu, (uint32_t)apdu_size);
+    while (iter.offset < iter.apdu_size) {
+        if (bacnet_is_closing_tag(
+                &apdu[iter.offset], iter.apdu_size - iter.offset)) {
+            break;
+        }
+        if (!bacnet_tag_iterator_next(&iter, &view)) {
+            return BACNET_STATUS_ERROR;
+        }
+        if (view.tag.opening && !bacnet_tag_iterator_skip(&iter)) {
+            return BACNET_STATUS_ERROR;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+static int bacexport_list(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_OBJECT_PROPERTY_VALUE *object_value,
+    unsigned depth);
+
+/**
+ * @brief Decode and write the next element of a list
+ * @param exp - export state
+ * @param apdu - encoded list
+ * @param apdu_size - number of octets in the buffer
+ * @param object_value - the object and property that the list is from
+ * @param depth - number of opening tags around the element
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+static int bacexport_element(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_OBJECT_PROPERTY_VALUE *object_value,
+    unsigned depth)
+{
+    BACNET_TAG tag = { 0 };
+    int apdu_len, len;
+
+    apdu_len = bacnet_tag_decode(apdu, apdu_size, &tag);
+    if ((apdu_len <= 0) || tag.closing) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (tag.application) {
+        return bacexport_application_element(
+            exp, apdu, apdu_size, object_value);
+    }
+    bacexport_container_begin(exp, CBOR_MAJOR_MAP, 1);
+    bacexport_key_number(exp, tag.number);
+    if (tag.opening) {
+        if (depth >= BACEXPORT_NESTING_MAX) {
+            return BACNET_STATUS_ERROR;
+        }
+        len = bacexport_list(
+            exp, &apdu[apdu_len], apdu_size - apdu_len, object_value,
+            depth + 1);
+        if (len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        if (!bacnet_is_closing_tag_number(
+                &apdu[apdu_len], apdu_size - apdu_len, tag.number, &len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+    } else {
+        /* the datatype of a context tagged value is not known here */
+        if (tag.len_value_type > (apdu_size - apdu_len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        bacexport_value_begin(exp);
+        bacexport_bytes(exp, &apdu[apdu_len], tag.len_value_type);
+        apdu_len += (int)tag.len_value_type;
+    }
+    bacexport_container_end(exp, CBOR_MAJOR_MAP, 1);
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode and write the elements of a list up to its closing tag,
+ *  or the end of the buffer
+ * @param exp - export state
+ * @param apdu - encoded list
+ * @param apdu_size - number of octets in the buffer
+ * @param object_value - the object and property that the list is from
+ * @param depth - number of opening tags around the list
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+static int bacexport_list(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_OBJECT_PROPERTY_VALUE *object_value,
+    unsigned depth)
+{
+    size_t apdu_len = 0;
+    int len, count, i;
+
+    /* count the elements first, so that a single value is not an array */
+    count = bacexport_element_count(apdu, apdu_size);
+    if (count < 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (count != 1) {
+        bacexport_container_begin(exp, CBOR_MAJOR_ARRAY, count);
+    }
+    for (i = 0; i < count; i++) {
+        len = bacexport_element(
+            exp, &apdu[apdu_len], apdu_size - apdu_len, object_value, depth);
+        if (len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += (size_t)len;
+    }
+    if (count != 1) {
+        bacexport_container_end(exp, CBOR_MAJOR_ARRAY, count);
+    }
+
+    return (int)apdu_len;
+}
+
+/**
+ * @brief Write an object identifier
+ * @param exp - export state
+ * @param object_type - object type of the identifier
+ * @param object_instance - object instance of the identifier
+ */
+static void bacexport_object_id(
+    BACEXPORT *exp, BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+#if defined(BACAPP_OBJECT_ID)
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+
+    value.tag = BACNET_APPLICATION_TAG_OBJECT_ID;
+    value.type.Object_Id.type = object_type;
+    value.type.Object_Id.instance = object_instance;
+    object_value.object_type = object_type;
+    object_value.object_instance = object_instance;
+    object_value.object_property = PROP_OBJECT_IDENTIFIER;
+    object_value.array_index = BACNET_ARRAY_ALL;
+    object_value.value = &value;
+    (void)bacexport_application_value(exp, &object_value);
+#else
+    bacexport_container_begin(exp, CBOR_MAJOR_ARRAY, 2);
+    bacexport_unsigned(exp, object_type);
+    bacexport_unsigned(exp, object_instance);
+    bacexport_container_end(exp, CBOR_MAJOR_ARRAY, 2);
+#endif
+}
+
+/**
+ * @brief Decode and write the list of values that is enclosed in
+ *  an opening and closing tag
+ * @param exp - export state
+ * @param apdu - encoded data, starting with the opening tag
+ * @param apdu_size - number of octets in the buffer
+ * @param tag_number - number of the opening and closing tag
+ * @param object_value - the object and property that the list is from
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+static int bacexport_enclosed_list(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    uint8_t tag_number,
+    BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    int apdu_len = 0, len = 0;
+
+    if (!bacnet_is_opening_tag_number(apdu, apdu_size, tag_number, &len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    len = bacexport_list(
+        exp, &apdu[apdu_len], apdu_size - apdu_len, object_value, 1);
+    if (len < 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    if (!bacnet_is_closing_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, tag_number, &len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Initialize an export
+ * @param exp - export state
+ * @param format - BACEXPORT_FORMAT_JSON or BACEXPORT_FORMAT_CBOR
+ * @param buffer - buffer for the export, or NULL to only count its length
+ * @param size - number of octets in the buffer
+ */
+void bacexport_init(
+    BACEXPORT *exp, BACEXPORT_FORMAT format, uint8_t *buffer, size_t size)
+{
+    if (exp) {
+        exp->format = format;
+        exp->buffer = buffer;
+        exp->size = buffer ? size : 0;
+        exp->length = 0;
+        exp->separator = false;
+        if (exp->size > 0) {
+            exp->buffer[0] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Determine if all of the export fit in its buffer
+ * @param exp - export state
+ * @return true if the export is complete, or false if the buffer
+ *  needs at least length + 1 octets
+ */
+bool bacexport_complete(const BACEXPORT *exp)
+{
+    if (!exp) {
+        return false;
+    }
+
+    return exp->length < exp->size;
+}
+
+/**
+ * @brief Export encoded application data, such as the value of
+ *  a ReadProperty acknowledgment
+ * @param exp - export state
+ * @param apdu - encoded application data
+ * @param apdu_size - number of octets in the buffer
+ * @param object_type - object type that the data is from, for the
+ *  enumerations of its properties
+ * @param property - property that the data is from
+ * @return number of octets decoded up to a closing tag or the end of the
+ *  buffer, or BACNET_STATUS_ERROR
+ */
+int bacexport_application_data(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID property)
+{
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+
+    if (!exp || !apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    object_value.object_type = object_type;
+    object_value.object_property = property;
+    object_value.array_index = BACNET_ARRAY_ALL;
+
+    return bacexport_list(exp, apdu, apdu_size, &object_value, 0);
+}
+
+/**
+ * @brief Export one result of a ReadPropertyMultiple acknowledgment
+ * @param exp - export state
+ * @param apdu - encoded result, starting with its propertyIdentifier
+ * @param apdu_size - number of octets in the buffer
+ * @param object_value - the object that the result is from
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+static int bacexport_rpm_result(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    int apdu_len = 0, len = 0;
+    uint32_t property = 0, error_class = 0, error_code = 0;
+    BACNET_UNSIGNED_INTEGER array_index = 0;
+    bool has_index;
+
+    /* propertyIdentifier [2] BACnetPropertyIdentifier */
+    len = bacnet_enumerated_context_decode(apdu, apdu_size, 2, &property);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    /* propertyArrayIndex [3] Unsigned OPTIONAL */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 3, &array_index);
+    if (len < 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    has_index = (len > 0);
+    object_value->object_property = (BACNET_PROPERTY_ID)property;
+    object_value->array_index =
+        has_index ? (BACNET_ARRAY_INDEX)array_index : BACNET_ARRAY_ALL;
+    bacexport_container_begin(exp, CBOR_MAJOR_MAP, has_index ? 3 : 2);
+    bacexport_key(exp, "propertyIdentifier");
+    bacexport_unsigned(exp, property);
+    if (has_index) {
+        bacexport_key(exp, "propertyArrayIndex");
+        bacexport_unsigned(exp, array_index);
+    }
+    if (bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 4, NULL)) {
+        /* propertyValue [4] ABSTRACT-SYNTAX.&Type */
+        bacexport_key(exp, "propertyValue");
+        len = bacexport_enclosed_list(
+            exp, &apdu[apdu_len], apdu_size - apdu_len, 4, object_value);
+        if (len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+    } else if (bacnet_is_opening_tag_number(
+                   &apdu[apdu_len], apdu_size - apdu_len, 5, &len)) {
+        /* propertyAccessError [5] Error */
+        apdu_len += len;
+        len = bacnet_enumerated_application_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, &error_class);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        len = bacnet_enumerated_application_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, &error_code);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        if (!bacnet_is_closing_tag_number(
+                &apdu[apdu_len], apdu_size - apdu_len, 5, &len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        bacexport_key(exp, "propertyAccessError");
+        bacexport_container_begin(exp, CBOR_MAJOR_MAP, 2);
+        bacexport_key(exp, "errorClass");
+        bacexport_unsigned(exp, error_class);
+        bacexport_key(exp, "errorCode");
+        bacexport_unsigned(exp, error_code);
+        bacexport_container_end(exp, CBOR_MAJOR_MAP, 2);
+    } else {
+        return BACNET_STATUS_ERROR;
+    }
+    bacexport_container_end(exp, CBOR_MAJOR_MAP, has_index ? 3 : 2);
+
+    return apdu_len;
+}
+
+/**
+ * @brief Export the service data of a ReadPropertyMultiple acknowledgment
+ *  as an array of the objects, each with their listOfResults
+ * @param exp - export state
+ * @param apdu - encoded service data, without the APDU header
+ * @param apdu_size - number of octets in the buffer
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+int bacexport_rpm_ack(BACEXPORT *exp, const uint8_t *apdu, size_t apdu_size)
+{
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    size_t apdu_len = 0;
+    int len = 0;
+
+    if (!exp || !apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    bacexport_container_begin(
+        exp, CBOR_MAJOR_ARRAY, BACEXPORT_COUNT_INDEFINITE);
+    while (apdu_len < apdu_size) {
+        /* objectIdentifier [0] BACnetObjectIdentifier */
+        len = bacnet_object_id_context_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, 0, &object_type,
+            &object_instance);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        object_value.object_type = object_type;
+        object_value.object_instance = object_instance;
+        bacexport_container_begin(exp, CBOR_MAJOR_MAP, 2);
+        bacexport_key(exp, "objectIdentifier");
+        bacexport_object_id(exp, object_type, object_instance);
+        /* listOfResults [1] SEQUENCE OF SEQUENCE */
+        if (!bacnet_is_opening_tag_number(
+                &apdu[apdu_len], apdu_size - apdu_len, 1, &len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        bacexport_key(exp, "listOfResults");
+        bacexport_container_begin(
+            exp, CBOR_MAJOR_ARRAY, BACEXPORT_COUNT_INDEFINITE);
+        while (!bacnet_is_closing_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &len)) {
+            len = bacexport_rpm_result(
+                exp, &apdu[apdu_len], apdu_size - apdu_len, &object_value);
+            if (len <= 0) {
+                return BACNET_STATUS_ERROR;
+            }
+            apdu_len += len;
+        }
+        apdu_len += len;
+        bacexport_container_end(
+            exp, CBOR_MAJOR_ARRAY, BACEXPORT_COUNT_INDEFINITE);
+        bacexport_container_end(exp, CBOR_MAJOR_MAP, 2);
+    }
+    bacexport_container_end(exp, CBOR_MAJOR_ARRAY, BACEXPORT_COUNT_INDEFINITE);
+
+    return (int)apdu_len;
+}
+
+/**
+ * @brief Export one BACnetPropertyValue of a COV notification
+ * @param exp - export state
+ * @param apdu - encoded property value
+ * @param apdu_size - number of octets in the buffer
+ * @param object_value - the object that the value is from
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+static int bacexport_property_value(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    int apdu_len = 0, len = 0;
+    uint32_t property = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+
+    /* propertyIdentifier [0] BACnetPropertyIdentifier */
+    len = bacnet_enumerated_context_decode(apdu, apdu_size, 0, &property);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    object_value->object_property = (BACNET_PROPERTY_ID)property;
+    object_value->array_index = BACNET_ARRAY_ALL;
+    /* the priority follows the value, so the count is not known here */
+    bacexport_container_begin(
+        exp, CBOR_MAJOR_MAP, BACEXPORT_COUNT_INDEFINITE);
+    bacexport_key(exp, "propertyIdentifier");
+    bacexport_unsigned(exp, property);
+    /* propertyArrayIndex [1] Unsigned OPTIONAL */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 1, &unsigned_value);
+    if (len < 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (len > 0) {
+        apdu_len += len;
+        object_value->array_index = (BACNET_ARRAY_INDEX)unsigned_value;
+        bacexport_key(exp, "propertyArrayIndex");
+        bacexport_unsigned(exp, unsigned_value);
+    }
+    /* value [2] ABSTRACT-SYNTAX.&Type */
+    bacexport_key(exp, "value");
+    len = bacexport_enclosed_list(
+        exp, &apdu[apdu_len], apdu_size - apdu_len, 2, object_value);
+    if (len < 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    /* priority [3] Unsigned (1..16) OPTIONAL */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 3, &unsigned_value);
+    if (len < 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (len > 0) {
+        apdu_len += len;
+        bacexport_key(exp, "priority");
+        bacexport_unsigned(exp, unsigned_value);
+    }
+    bacexport_container_end(exp, CBOR_MAJOR_MAP, BACEXPORT_COUNT_INDEFINITE);
+
+    return apdu_len;
+}
+
+/**
+ * @brief Export the service data of a confirmed or unconfirmed
+ *  COV notification
+ * @param exp - export state
+ * @param apdu - encoded service data, without the APDU header
+ * @param apdu_size - number of octets in the buffer
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+int bacexport_cov_notification(
+    BACEXPORT *exp, const uint8_t *apdu, size_t apdu_size)
+{
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    size_t apdu_len = 0;
+    int len = 0;
+
+    if (!exp || !apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    bacexport_container_begin(exp, CBOR_MAJOR_MAP, 5);
+    /* subscriberProcessIdentifier [0] Unsigned32 */
+    len = bacnet_unsigned_context_decode(apdu, apdu_size, 0, &unsigned_value);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    bacexport_key(exp, "subscriberProcessIdentifier");
+    bacexport_unsigned(exp, unsigned_value);
+    /* initiatingDeviceIdentifier [1] BACnetObjectIdentifier */
+    len = bacnet_object_id_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 1, &object_type,
+        &object_instance);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    bacexport_key(exp, "initiatingDeviceIdentifier");
+    bacexport_object_id(exp, object_type, object_instance);
+    /* monitoredObjectIdentifier [2] BACnetObjectIdentifier */
+    len = bacnet_object_id_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 2, &object_type,
+        &object_instance);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    object_value.object_type = object_type;
+    object_value.object_instance = object_instance;
+    bacexport_key(exp, "monitoredObjectIdentifier");
+    bacexport_object_id(exp, object_type, object_instance);
+    /* timeRemaining [3] Unsigned */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 3, &unsigned_value);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    bacexport_key(exp, "timeRemaining");
+    bacexport_unsigned(exp, unsigned_value);
+    /* listOfValues [4] SEQUENCE OF BACnetPropertyValue */
+    if (!bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 4, &len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    bacexport_key(exp, "listOfValues");
+    bacexport_container_begin(
+        exp, CBOR_MAJOR_ARRAY, BACEXPORT_COUNT_INDEFINITE);
+    while (!bacnet_is_closing_tag_number(
+        &apdu[apdu_len], apdu_size - apdu_len, 4, &len)) {
+        len = bacexport_property_value(
+            exp, &apdu[apdu_len], apdu_size - apdu_len, &object_value);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+    }
+    apdu_len += len;
+    bacexport_container_end(exp, CBOR_MAJOR_ARRAY, BACEXPORT_COUNT_INDEFINITE);
+    bacexport_container_end(exp, CBOR_MAJOR_MAP, 5);
+
+    return (int)apdu_len;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @brief API to export encoded BACnet application data as JSON or CBOR
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_EXPORT_H
+#define BACNET_EXPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* the deepest nesting of opening tags that is exported */
+#ifndef BACEXPORT_NESTING_MAX
+#define BACEXPORT_NESTING_MAX 16
+#endif
+
+typedef enum bacexport_format {
+    BACEXPORT_FORMAT_JSON = 0,
+    BACEXPORT_FORMAT_CBOR = 1
+} BACEXPORT_FORMAT;
+
+/* The export is written as the APDU is decoded. Like snprintf(), the
+   length counts every octet of the export, even those that did not fit,
+   and the export is complete when the length is less than the size.
+   The octet after the export is set to zero. */
+typedef struct bacexport {
+    BACEXPORT_FORMAT format;
+    /* buffer for the export, or NULL to only count the length */
+    uint8_t *buffer;
+    size_t size;
+    size_t length;
+    /* JSON: a value was written, and the next one needs a comma */
+    bool separator;
+} BACEXPORT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacexport_init(
+    BACEXPORT *exp, BACEXPORT_FORMAT format, uint8_t *buffer, size_t size);
+BACNET_STACK_EXPORT
+bool bacexport_complete(const BACEXPORT *exp);
+
+BACNET_STACK_EXPORT
+int bacexport_application_data(
+    BACEXPORT *exp,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID property);
+BACNET_STACK_EXPORT
+int bacexport_rpm_ack(BACEXPORT *exp, const uint8_t *apdu, size_t apdu_size);
+BACNET_STACK_EXPORT
+int bacexport_cov_notification(
+    BACEXPORT *exp, const uint8_t *apdu, size_t apdu_size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -45,14 +45,41 @@
  */
 void bitstring_init(BACNET_BIT_STRING *bit_string)
 {
-    unsigned i;
-
     if (bit_string) {
         bit_string->bits_used = 0;
-        for (i = 0; i < MAX_BITSTRING_BYTES; i++) {
-            bit_string->value[i] = 0;
+        memset(bit_string->value, 0, sizeof(bit_string->value));
+    }
+}
+
+/**
+ * @brief Initialize a bit string from its octets, such as a constant
+ *  mask of the bits that are set, instead of one bit at a time
+ * @param bit_string  Pointer to the bit string structure.
+ * @param octets  The octets, with bit 0 in the least significant bit of
+ *  the first octet, or NULL for all bits clear
+ * @param bits_used  Number of bits in the bit string
+ * @return true on success, false if the bits exceed the capacity
+ */
+bool bitstring_init_octets(
+    BACNET_BIT_STRING *bit_string, const uint8_t *octets, unsigned bits_used)
+{
+    unsigned bytes_used = (bits_used + 7) / 8;
+
+    if (!bit_string || (bits_used > bitstring_bits_capacity(bit_string)) ||
+        (bits_used > UINT8_MAX)) {
+        return false;
+    }
+    bit_string->bits_used = (uint8_t)bits_used;
+    memset(bit_string->value, 0, sizeof(bit_string->value));
+    if (octets && bytes_used) {
+        memcpy(bit_string->value, octets, bytes_used);
+        if (bits_used % 8) {
+            /* clear the unused bits of the last octet */
+            bit_string->value[bytes_used - 1] &= 0xFF >> (8 - (bits_used % 8));
         }
     }
+
+    return true;
 }
 
 /**
@@ -262,14 +289,11 @@ unsigned bitstring_bits_capacity(const BACNET_BIT_STRING *bit_string)
  */
 bool bitstring_copy(BACNET_BIT_STRING *dest, const BACNET_BIT_STRING *src)
 {
-    unsigned i;
     bool status = false;
 
     if (dest && src) {
         dest->bits_used = src->bits_used;
-        for (i = 0; i < MAX_BITSTRING_BYTES; i++) {
-            dest->value[i] = src->value[i];
-        }
+        memcpy(dest->value, src->value, sizeof(dest->value));
         status = true;
     }
 
@@ -288,29 +312,30 @@ bool bitstring_copy(BACNET_BIT_STRING *dest, const BACNET_BIT_STRING *src)
 bool bitstring_same(
     const BACNET_BIT_STRING *bitstring1, const BACNET_BIT_STRING *bitstring2)
 {
-    int i; /* loop counter */
-    int bytes_used = 0;
+    unsigned bytes_used = 0;
+    unsigned partial_bits = 0;
     uint8_t compare_mask = 0;
 
     if (bitstring1 && bitstring2) {
-        bytes_used = (int)(bitstring1->bits_used / 8);
-        if ((bitstring1->bits_used == bitstring2->bits_used) &&
-            (bytes_used <= MAX_BITSTRING_BYTES)) {
-            /* compare fully used bytes */
-            for (i = 0; i < bytes_used; i++) {
-                if (bitstring1->value[i] != bitstring2->value[i]) {
-                    return false;
-                }
-            }
+        bytes_used = bitstring1->bits_used / 8;
+        partial_bits = bitstring1->bits_used % 8;
+        if ((bitstring1->bits_used != bitstring2->bits_used) ||
+            (bytes_used > MAX_BITSTRING_BYTES)) {
+            return false;
+        }
+        /* compare fully used bytes */
+        if (memcmp(bitstring1->value, bitstring2->value, bytes_used) != 0) {
+            return false;
+        }
+        if (partial_bits && (bytes_used < MAX_BITSTRING_BYTES)) {
             /* compare only the relevant bits of last partly used byte */
-            compare_mask = 0xFF >> (8 - (bitstring1->bits_used % 8));
+            compare_mask = 0xFF >> (8 - partial_bits);
             if ((bitstring1->value[bytes_used] & compare_mask) !=
                 (bitstring2->value[bytes_used] & compare_mask)) {
                 return false;
-            } else {
-                return true;
             }
         }
+        return true;
     }
 
     return false;
@@ -1047,6 +1072,130 @@ char *characterstring_utf8_strdup(const BACNET_CHARACTER_STRING *char_string)
     return str;
 }
 
+/**
+ * @brief Initialize a BACnet character string view, which refers to
+ *  the value without copying it. The value must be kept for as long
+ *  as the view is used.
+ * @param view  Pointer to the BACnet character string view
+ * @param encoding  BACnet character string encoding of the value
+ * @param value  Pointer to the characters, or NULL for an empty string
+ * @param length  Number of characters in the value
+ * @return false if the value exceeds the capacity of a BACnet
+ *  character string, so that the view is encoded like one
+ */
+bool characterstring_view_init(
+    BACNET_CHARACTER_STRING_VIEW *view,
+    uint8_t encoding,
+    const char *value,
+    size_t length)
+{
+    if (!view) {
+        return false;
+    }
+    view->encoding = encoding;
+    view->value = value;
+    view->length = value ? length : 0;
+
+    return view->length <= CHARACTER_STRING_CAPACITY;
+}
+
+/**
+ * @brief Initialize a BACnet character string view of a C string
+ * @param view  Pointer to the BACnet character string view
+ * @param value  C string, or NULL for an empty string
+ * @return false if the value exceeds the capacity of a BACnet
+ *  character string
+ */
+bool characterstring_view_init_ansi(
+    BACNET_CHARACTER_STRING_VIEW *view, const char *value)
+{
+    return characterstring_view_init(
+        view, CHARACTER_ANSI_X34, value, value ? strlen(value) : 0);
+}
+
+/**
+ * @brief Initialize a BACnet character string view of a BACnet
+ *  character string
+ * @param view  Pointer to the BACnet character string view
+ * @param char_string  Pointer to the BACnet character string
+ */
+void characterstring_view_from(
+    BACNET_CHARACTER_STRING_VIEW *view,
+    const BACNET_CHARACTER_STRING *char_string)
+{
+    if (view && char_string) {
+        view->encoding = char_string->encoding;
+        view->value = char_string->value;
+        view->length = char_string->length;
+    }
+}
+
+/**
+ * @brief Copy the value of a BACnet character string view
+ * @param dest  Pointer to the destination BACnet character string
+ * @param src  Pointer to the BACnet character string view
+ * @return false if the value exceeds the capacity of the destination
+ */
+bool characterstring_view_copy(
+    BACNET_CHARACTER_STRING *dest, const BACNET_CHARACTER_STRING_VIEW *src)
+{
+    if (!src) {
+        return false;
+    }
+
+    return characterstring_init(dest, src->encoding, src->value, src->length);
+}
+
+/**
+ * @brief Compare a BACnet character string view to a BACnet
+ *  character string
+ * @param view  Pointer to the BACnet character string view
+ * @param char_string  Pointer to the BACnet character string
+ * @return true if the encoding and the characters are the same
+ */
+bool characterstring_view_same(
+    const BACNET_CHARACTER_STRING_VIEW *view,
+    const BACNET_CHARACTER_STRING *char_string)
+{
+    if (!view || !char_string) {
+        return false;
+    }
+    if ((view->encoding != char_string->encoding) ||
+        (view->length != char_string->length)) {
+        return false;
+    }
+    if (view->length == 0) {
+        return true;
+    }
+
+    return memcmp(view->value, char_string->value, view->length) == 0;
+}
+
+/**
+ * @brief Compare a BACnet character string view to a C string
+ * @param view  Pointer to the BACnet character string view
+ * @param value  C string to compare to
+ * @return true if the view is ANSI X3.4 and the characters are the same
+ */
+bool characterstring_view_ansi_same(
+    const BACNET_CHARACTER_STRING_VIEW *view, const char *value)
+{
+    size_t length;
+
+    if (!view || (view->encoding != CHARACTER_ANSI_X34)) {
+        return false;
+    }
+    length = value ? strlen(value) : 0;
+    if (view->length != length) {
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+
+    return memcmp(view->value, value, length) == 0;
+}
+
 #if BACNET_USE_OCTETSTRING
 /**
  * @brief Initialize an octet string with the given bytes or
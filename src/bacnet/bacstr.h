@@ -42,6 +42,15 @@ typedef struct BACnetCharacterStringBuffer {
     uint32_t buffer_length;
 } BACNET_CHARACTER_STRING_BUFFER;
 
+/* non-owning view version of Character String, which refers to
+   a value that is kept elsewhere, such as in static storage or in
+   the APDU, and is not NUL terminated */
+typedef struct BACnetCharacterStringView {
+    uint8_t encoding;
+    const char *value;
+    size_t length;
+} BACNET_CHARACTER_STRING_VIEW;
+
 /* buffer pointer version of Octet String */
 typedef struct BACnetOctetStringBuffer {
     uint8_t *buffer;
@@ -56,6 +65,9 @@ extern "C" {
 BACNET_STACK_EXPORT
 void bitstring_init(BACNET_BIT_STRING *bit_string);
 BACNET_STACK_EXPORT
+bool bitstring_init_octets(
+    BACNET_BIT_STRING *bit_string, const uint8_t *octets, unsigned bits_used);
+BACNET_STACK_EXPORT
 void bitstring_set_bit(
     BACNET_BIT_STRING *bit_string, uint8_t bit_number, bool value);
 BACNET_STACK_EXPORT
@@ -154,6 +166,30 @@ bool characterstring_utf8_valid(const BACNET_CHARACTER_STRING *char_string);
 BACNET_STACK_EXPORT
 char *characterstring_utf8_strdup(const BACNET_CHARACTER_STRING *char_string);
 
+BACNET_STACK_EXPORT
+bool characterstring_view_init(
+    BACNET_CHARACTER_STRING_VIEW *view,
+    uint8_t encoding,
+    const char *value,
+    size_t length);
+BACNET_STACK_EXPORT
+bool characterstring_view_init_ansi(
+    BACNET_CHARACTER_STRING_VIEW *view, const char *value);
+BACNET_STACK_EXPORT
+void characterstring_view_from(
+    BACNET_CHARACTER_STRING_VIEW *view,
+    const BACNET_CHARACTER_STRING *char_string);
+BACNET_STACK_EXPORT
+bool characterstring_view_copy(
+    BACNET_CHARACTER_STRING *dest, const BACNET_CHARACTER_STRING_VIEW *src);
+BACNET_STACK_EXPORT
+bool characterstring_view_same(
+    const BACNET_CHARACTER_STRING_VIEW *view,
+    const BACNET_CHARACTER_STRING *char_string);
+BACNET_STACK_EXPORT
+bool characterstring_view_ansi_same(
+    const BACNET_CHARACTER_STRING_VIEW *view, const char *value);
+
 /* returns false if the string exceeds capacity
    initialize by using length=0 */
 BACNET_STACK_EXPORT
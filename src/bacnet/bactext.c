@@ -27,7 +27,7 @@ static bool bactext_string_to_uint32_index(
     return bacnet_string_to_uint32(search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_confirmed_service_names[] = {
+INDTEXT_DATA bacnet_confirmed_service_names[] BACNET_STACK_PROGMEM = {
     { SERVICE_CONFIRMED_ACKNOWLEDGE_ALARM, "AcknowledgeAlarm" },
     { SERVICE_CONFIRMED_COV_NOTIFICATION, "ConfirmedCOVNotification" },
     { SERVICE_CONFIRMED_EVENT_NOTIFICATION, "ConfirmedEventNotification" },
@@ -89,7 +89,7 @@ bool bactext_confirmed_service_strtol(
         bacnet_confirmed_service_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_unconfirmed_service_names[] = {
+INDTEXT_DATA bacnet_unconfirmed_service_names[] BACNET_STACK_PROGMEM = {
     { SERVICE_UNCONFIRMED_I_AM, "I-Am" },
     { SERVICE_UNCONFIRMED_I_HAVE, "I-Have" },
     { SERVICE_UNCONFIRMED_COV_NOTIFICATION, "UnconfirmedCOVNotification" },
@@ -129,7 +129,7 @@ bool bactext_unconfirmed_service_strtol(
         bacnet_unconfirmed_service_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_application_tag_names[] = {
+INDTEXT_DATA bacnet_application_tag_names[] BACNET_STACK_PROGMEM = {
     { BACNET_APPLICATION_TAG_NULL, "Null" },
     { BACNET_APPLICATION_TAG_BOOLEAN, "Boolean" },
     { BACNET_APPLICATION_TAG_UNSIGNED_INT, "Unsigned Int" },
@@ -214,7 +214,7 @@ bool bactext_application_tag_index(
         bacnet_application_tag_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_reinitialized_state_names[] = {
+INDTEXT_DATA bacnet_reinitialized_state_names[] BACNET_STACK_PROGMEM = {
     { BACNET_REINIT_COLDSTART, "coldstart" },
     { BACNET_REINIT_WARMSTART, "warmstart" },
     { BACNET_REINIT_STARTBACKUP, "startbackup" },
@@ -241,7 +241,7 @@ bool bactext_reinitialized_state_strtol(
         bacnet_reinitialized_state_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_character_string_encoding_names[] = {
+INDTEXT_DATA bacnet_character_string_encoding_names[] BACNET_STACK_PROGMEM = {
     { CHARACTER_ANSI_X34, "ANSI X3.4" },
     { CHARACTER_MS_DBCS, "IBM/Microsoft DBCS" },
     { CHARACTER_JISC_6226, "JIS C 6226" },
@@ -264,7 +264,7 @@ bool bactext_character_string_encoding_strtol(
         bacnet_character_string_encoding_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_object_type_names[] = {
+INDTEXT_DATA bacnet_object_type_names[] BACNET_STACK_PROGMEM = {
     { OBJECT_ANALOG_INPUT, "analog-input" },
     { OBJECT_ANALOG_OUTPUT, "analog-output" },
     { OBJECT_ANALOG_VALUE, "analog-value" },
@@ -362,7 +362,7 @@ bool bactext_object_type_strtol(const char *search_name, uint32_t *found_index)
         bacnet_object_type_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_object_type_names_capitalized[] = {
+INDTEXT_DATA bacnet_object_type_names_capitalized[] BACNET_STACK_PROGMEM = {
     { OBJECT_ANALOG_INPUT, "Analog Input" },
     { OBJECT_ANALOG_OUTPUT, "Analog Output" },
     { OBJECT_ANALOG_VALUE, "Analog Value" },
@@ -455,7 +455,7 @@ bool bactext_object_type_name_capitalized_strtol(
         bacnet_object_type_names_capitalized, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_property_names[] = {
+INDTEXT_DATA bacnet_property_names[] BACNET_STACK_PROGMEM = {
     /* FIXME: use the enumerations from bacenum.h */
     { PROP_ACKED_TRANSITIONS, "acked-transitions" },
     { PROP_ACK_REQUIRED, "ack-required" },
@@ -1055,7 +1055,7 @@ bool bactext_property_strtol(const char *search_name, uint32_t *found_index)
         bacnet_property_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_engineering_unit_names[] = {
+INDTEXT_DATA bacnet_engineering_unit_names[] BACNET_STACK_PROGMEM = {
     { UNITS_SQUARE_METERS, "square-meters" },
     { UNITS_SQUARE_FEET, "square-feet" },
     { UNITS_MILLIAMPERES, "milliamperes" },
@@ -1547,7 +1547,7 @@ bool bactext_engineering_unit_index(
         bacnet_engineering_unit_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_reject_reason_names[] = {
+INDTEXT_DATA bacnet_reject_reason_names[] BACNET_STACK_PROGMEM = {
     { REJECT_REASON_OTHER, "Other" },
     { REJECT_REASON_BUFFER_OVERFLOW, "Buffer Overflow" },
     { REJECT_REASON_INCONSISTENT_PARAMETERS, "Inconsistent Parameters" },
@@ -1585,7 +1585,7 @@ bool bactext_reject_reason_strtol(
         bacnet_reject_reason_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_abort_reason_names[] = {
+INDTEXT_DATA bacnet_abort_reason_names[] BACNET_STACK_PROGMEM = {
     { ABORT_REASON_OTHER, "Other" },
     { ABORT_REASON_BUFFER_OVERFLOW, "Buffer Overflow" },
     { ABORT_REASON_INVALID_APDU_IN_THIS_STATE, "Invalid APDU in this State" },
@@ -1624,7 +1624,7 @@ bool bactext_abort_reason_strtol(const char *search_name, uint32_t *found_index)
         bacnet_abort_reason_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_error_class_names[] = {
+INDTEXT_DATA bacnet_error_class_names[] BACNET_STACK_PROGMEM = {
     { ERROR_CLASS_DEVICE, "device" },
     { ERROR_CLASS_OBJECT, "object" },
     { ERROR_CLASS_PROPERTY, "property" },
@@ -1656,7 +1656,7 @@ bool bactext_error_class_strtol(const char *search_name, uint32_t *found_index)
         bacnet_error_class_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_error_code_names[] = {
+INDTEXT_DATA bacnet_error_code_names[] BACNET_STACK_PROGMEM = {
     { ERROR_CODE_OTHER, "other" },
     { ERROR_CODE_AUTHENTICATION_FAILED, "authentication-failed" },
     { ERROR_CODE_CHARACTER_SET_NOT_SUPPORTED, "character-set-not-supported" },
@@ -1945,7 +1945,7 @@ bool bactext_error_code_strtol(const char *search_name, uint32_t *found_index)
         bacnet_error_code_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_month_names[] = {
+INDTEXT_DATA bacnet_month_names[] BACNET_STACK_PROGMEM = {
     { 1, "January" },     { 2, "February" },     { 3, "March" },
     { 4, "April" },       { 5, "May" },          { 6, "June" },
     { 7, "July" },        { 8, "August" },       { 9, "September" },
@@ -1972,7 +1972,7 @@ bool bactext_month_strtol(const char *search_name, uint32_t *found_index)
         bacnet_month_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_week_of_month_names[] = {
+INDTEXT_DATA bacnet_week_of_month_names[] BACNET_STACK_PROGMEM = {
     { 1, "days numbered 1-7" },        { 2, "days numbered 8-14" },
     { 3, "days numbered 15-21" },      { 4, "days numbered 22-28" },
     { 5, "days numbered 29-31" },      { 6, "last 7 days of this month" },
@@ -1999,7 +1999,7 @@ bool bactext_week_of_month_strtol(
 }
 
 /* note: different than DaysOfWeek bit string where 0=monday */
-INDTEXT_DATA bacnet_day_of_week_names[] = {
+INDTEXT_DATA bacnet_day_of_week_names[] BACNET_STACK_PROGMEM = {
     { 1, "Monday" },    { 2, "Tuesday" },
     { 3, "Wednesday" }, { 4, "Thursday" },
     { 5, "Friday" },    { 6, "Saturday" },
@@ -2026,7 +2026,7 @@ bool bactext_day_of_week_strtol(const char *search_name, uint32_t *found_index)
 }
 
 /* note: different than DayOfWeek bit string where 1=monday */
-INDTEXT_DATA bacnet_days_of_week_names[] = {
+INDTEXT_DATA bacnet_days_of_week_names[] BACNET_STACK_PROGMEM = {
     { BACNET_DAYS_OF_WEEK_MONDAY, "Monday" },
     { BACNET_DAYS_OF_WEEK_TUESDAY, "Tuesday" },
     { BACNET_DAYS_OF_WEEK_WEDNESDAY, "Wednesday" },
@@ -2055,7 +2055,7 @@ bool bactext_days_of_week_strtol(const char *search_name, uint32_t *found_index)
         bacnet_days_of_week_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_notify_type_names[] = {
+INDTEXT_DATA bacnet_notify_type_names[] BACNET_STACK_PROGMEM = {
     /* BACnetNotifyType enumerations */
     { NOTIFY_ALARM, "alarm" },
     { NOTIFY_EVENT, "event" },
@@ -2087,7 +2087,7 @@ bool bactext_notify_type_strtol(const char *search_name, uint32_t *found_index)
         bacnet_notify_type_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_event_transition_names[] = {
+INDTEXT_DATA bacnet_event_transition_names[] BACNET_STACK_PROGMEM = {
     { TRANSITION_TO_OFFNORMAL, "offnormal" },
     { TRANSITION_TO_NORMAL, "normal" },
     { TRANSITION_TO_FAULT, "fault" },
@@ -2113,7 +2113,7 @@ bool bactext_event_transition_strtol(
         bacnet_event_transition_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_event_state_names[] = {
+INDTEXT_DATA bacnet_event_state_names[] BACNET_STACK_PROGMEM = {
     { EVENT_STATE_NORMAL, "normal" },
     { EVENT_STATE_FAULT, "fault" },
     { EVENT_STATE_OFFNORMAL, "offnormal" },
@@ -2141,7 +2141,7 @@ bool bactext_event_state_strtol(const char *search_name, uint32_t *found_index)
         bacnet_event_state_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_event_type_names[] = {
+INDTEXT_DATA bacnet_event_type_names[] BACNET_STACK_PROGMEM = {
     { EVENT_CHANGE_OF_BITSTRING, "change-of-bitstring" },
     { EVENT_CHANGE_OF_STATE, "change-of-state" },
     { EVENT_CHANGE_OF_VALUE, "change-of-value" },
@@ -2187,7 +2187,7 @@ bool bactext_event_type_strtol(const char *search_name, uint32_t *found_index)
         bacnet_event_type_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_binary_present_value_names[] = {
+INDTEXT_DATA bacnet_binary_present_value_names[] BACNET_STACK_PROGMEM = {
     /* list of each index and associated unique name */
     { BINARY_INACTIVE, "inactive" },
     { BINARY_ACTIVE, "active" },
@@ -2207,7 +2207,7 @@ bool bactext_binary_present_value_index(
         bacnet_binary_present_value_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_binary_polarity_names[] = {
+INDTEXT_DATA bacnet_binary_polarity_names[] BACNET_STACK_PROGMEM = {
     /* list of each index and associated unique name */
     { POLARITY_NORMAL, "normal" },
     { POLARITY_REVERSE, "reverse" },
@@ -2220,7 +2220,7 @@ const char *bactext_binary_polarity_name(uint32_t index)
         bacnet_binary_polarity_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bacnet_reliability_names[] = {
+INDTEXT_DATA bacnet_reliability_names[] BACNET_STACK_PROGMEM = {
     { RELIABILITY_NO_FAULT_DETECTED, "no-fault-detected" },
     { RELIABILITY_NO_SENSOR, "no-sensor" },
     { RELIABILITY_OVER_RANGE, "over-range" },
@@ -2258,7 +2258,7 @@ const char *bactext_reliability_name(uint32_t index)
         bacnet_reliability_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bacnet_device_status_names[] = {
+INDTEXT_DATA bacnet_device_status_names[] BACNET_STACK_PROGMEM = {
     { STATUS_OPERATIONAL, "operational" },
     { STATUS_OPERATIONAL_READ_ONLY, "operational-read-only" },
     { STATUS_DOWNLOAD_REQUIRED, "download-required" },
@@ -2274,7 +2274,7 @@ const char *bactext_device_status_name(uint32_t index)
         bacnet_device_status_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bacnet_segmentation_names[] = {
+INDTEXT_DATA bacnet_segmentation_names[] BACNET_STACK_PROGMEM = {
     { SEGMENTATION_BOTH, "segmented-both" },
     { SEGMENTATION_TRANSMIT, "segmented-transmit" },
     { SEGMENTATION_RECEIVE, "segmented-receive" },
@@ -2294,7 +2294,7 @@ bool bactext_segmentation_index(const char *search_name, uint32_t *found_index)
         bacnet_segmentation_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_node_type_names[] = {
+INDTEXT_DATA bacnet_node_type_names[] BACNET_STACK_PROGMEM = {
     { BACNET_NODE_UNKNOWN, "unknown" },
     { BACNET_NODE_SYSTEM, "system" },
     { BACNET_NODE_NETWORK, "network" },
@@ -2326,7 +2326,7 @@ const char *bactext_node_type_name(uint32_t index)
         bacnet_node_type_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bacnet_node_relationship_names[] = {
+INDTEXT_DATA bacnet_node_relationship_names[] BACNET_STACK_PROGMEM = {
     { BACNET_RELATIONSHIP_UNKNOWN, "unknown" },
     { BACNET_RELATIONSHIP_DEFAULT, "default" },
     { BACNET_RELATIONSHIP_CONTAINS, "contains" },
@@ -2397,7 +2397,7 @@ bool bactext_node_relationship_name_reserved(uint32_t index)
     return status;
 }
 
-INDTEXT_DATA network_layer_msg_names[] = {
+INDTEXT_DATA network_layer_msg_names[] BACNET_STACK_PROGMEM = {
     { NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK, "Who-Is-Router-To-Network" },
     { NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK, "I-Am-Router-To-Network" },
     { NETWORK_MESSAGE_I_COULD_BE_ROUTER_TO_NETWORK,
@@ -2442,7 +2442,7 @@ bool bactext_network_layer_msg_strtol(
         network_layer_msg_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_life_safety_mode_names[] = {
+INDTEXT_DATA bactext_life_safety_mode_names[] BACNET_STACK_PROGMEM = {
     { LIFE_SAFETY_MODE_OFF, "off" },
     { LIFE_SAFETY_MODE_ON, "on" },
     { LIFE_SAFETY_MODE_TEST, "test" },
@@ -2480,7 +2480,7 @@ const char *bactext_life_safety_mode_name(uint32_t index)
     }
 }
 
-INDTEXT_DATA bactext_life_safety_operation_names[] = {
+INDTEXT_DATA bactext_life_safety_operation_names[] BACNET_STACK_PROGMEM = {
     { LIFE_SAFETY_OP_NONE, "none" },
     { LIFE_SAFETY_OP_SILENCE, "silence" },
     { LIFE_SAFETY_OP_SILENCE_AUDIBLE, "silence-audible" },
@@ -2506,7 +2506,7 @@ const char *bactext_life_safety_operation_name(uint32_t index)
     }
 }
 
-INDTEXT_DATA bactext_life_safety_state_names[] = {
+INDTEXT_DATA bactext_life_safety_state_names[] BACNET_STACK_PROGMEM = {
     { LIFE_SAFETY_STATE_QUIET, "quiet" },
     { LIFE_SAFETY_STATE_PRE_ALARM, "pre-alarm" },
     { LIFE_SAFETY_STATE_ALARM, "alarm" },
@@ -2557,7 +2557,7 @@ const char *bactext_life_safety_state_name(uint32_t index)
     }
 }
 
-INDTEXT_DATA bactext_silenced_state_names[] = {
+INDTEXT_DATA bactext_silenced_state_names[] BACNET_STACK_PROGMEM = {
     { SILENCED_STATE_UNSILENCED, "unsilenced" },
     { SILENCED_STATE_AUDIBLE_SILENCED, "audible-silenced" },
     { SILENCED_STATE_VISIBLE_SILENCED, "visible-silenced" },
@@ -2577,7 +2577,7 @@ const char *bactext_silenced_state_name(uint32_t index)
     }
 }
 
-INDTEXT_DATA bacnet_lighting_in_progress_names[] = {
+INDTEXT_DATA bacnet_lighting_in_progress_names[] BACNET_STACK_PROGMEM = {
     { BACNET_LIGHTING_IDLE, "idle" },
     { BACNET_LIGHTING_FADE_ACTIVE, "fade" },
     { BACNET_LIGHTING_RAMP_ACTIVE, "ramp" },
@@ -2597,7 +2597,7 @@ const char *bactext_lighting_in_progress(uint32_t index)
     }
 }
 
-INDTEXT_DATA bacnet_lighting_transition_names[] = {
+INDTEXT_DATA bacnet_lighting_transition_names[] BACNET_STACK_PROGMEM = {
     { BACNET_LIGHTING_TRANSITION_NONE, "none" },
     { BACNET_LIGHTING_TRANSITION_FADE, "fade" },
     { BACNET_LIGHTING_TRANSITION_RAMP, "ramp" },
@@ -2616,7 +2616,7 @@ const char *bactext_lighting_transition(uint32_t index)
     }
 }
 
-INDTEXT_DATA bacnet_lighting_operation_names[] = {
+INDTEXT_DATA bacnet_lighting_operation_names[] BACNET_STACK_PROGMEM = {
     { BACNET_LIGHTS_NONE, "none" },
     { BACNET_LIGHTS_FADE_TO, "fade-to" },
     { BACNET_LIGHTS_RAMP_TO, "ramp-to" },
@@ -2654,7 +2654,7 @@ bool bactext_lighting_operation_strtol(
         bacnet_lighting_operation_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_binary_lighting_pv_names[] = {
+INDTEXT_DATA bacnet_binary_lighting_pv_names[] BACNET_STACK_PROGMEM = {
     { BINARY_LIGHTING_PV_OFF, "off" },
     { BINARY_LIGHTING_PV_ON, "on" },
     { BINARY_LIGHTING_PV_WARN, "warn" },
@@ -2684,7 +2684,7 @@ bool bactext_binary_lighting_pv_names_strtol(
         bacnet_binary_lighting_pv_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_color_operation_names[] = {
+INDTEXT_DATA bacnet_color_operation_names[] BACNET_STACK_PROGMEM = {
     { BACNET_COLOR_OPERATION_NONE, "none" },
     { BACNET_COLOR_OPERATION_FADE_TO_COLOR, "fade-to-color" },
     { BACNET_COLOR_OPERATION_FADE_TO_CCT, "fade-to-cct" },
@@ -2708,7 +2708,7 @@ bool bactext_color_operation_strtol(
         bacnet_color_operation_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_device_communications_names[] = {
+INDTEXT_DATA bacnet_device_communications_names[] BACNET_STACK_PROGMEM = {
     { COMMUNICATION_ENABLE, "enabled" },
     { COMMUNICATION_DISABLE, "disabled" },
     { COMMUNICATION_DISABLE_INITIATION, "initiation disabled" },
@@ -2728,7 +2728,7 @@ bool bactext_device_communications_strtol(
         bacnet_device_communications_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_shed_state_names[] = {
+INDTEXT_DATA bacnet_shed_state_names[] BACNET_STACK_PROGMEM = {
     { BACNET_SHED_INACTIVE, "shed-inactive" },
     { BACNET_SHED_REQUEST_PENDING, "shed-request-pending" },
     { BACNET_SHED_COMPLIANT, "shed-compliant" },
@@ -2742,7 +2742,7 @@ const char *bactext_shed_state_name(uint32_t index)
         bacnet_shed_state_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bacnet_shed_level_type_names[] = {
+INDTEXT_DATA bacnet_shed_level_type_names[] BACNET_STACK_PROGMEM = {
     { BACNET_SHED_TYPE_PERCENT, "percent" },
     { BACNET_SHED_TYPE_LEVEL, "level" },
     { BACNET_SHED_TYPE_AMOUNT, "amount" },
@@ -2762,7 +2762,7 @@ bool bactext_shed_level_type_strtol(
         bacnet_shed_level_type_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_log_datum_names[] = {
+INDTEXT_DATA bacnet_log_datum_names[] BACNET_STACK_PROGMEM = {
     { BACNET_LOG_DATUM_STATUS, "status" },
     { BACNET_LOG_DATUM_BOOLEAN, "boolean" },
     { BACNET_LOG_DATUM_REAL, "real" },
@@ -2789,7 +2789,7 @@ bool bactext_log_datum_strtol(const char *search_name, uint32_t *found_index)
         bacnet_log_datum_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_restart_reason_names[] = {
+INDTEXT_DATA bactext_restart_reason_names[] BACNET_STACK_PROGMEM = {
     { RESTART_REASON_UNKNOWN, "unknown" },
     { RESTART_REASON_COLDSTART, "coldstart" },
     { RESTART_REASON_WARMSTART, "warmstart" },
@@ -2814,7 +2814,7 @@ const char *bactext_restart_reason_name(uint32_t index)
     }
 }
 
-INDTEXT_DATA bactext_network_port_type_names[] = {
+INDTEXT_DATA bactext_network_port_type_names[] BACNET_STACK_PROGMEM = {
     { PORT_TYPE_ETHERNET, "ethernet" },
     { PORT_TYPE_ARCNET, "arcnet" },
     { PORT_TYPE_MSTP, "mstp" },
@@ -2843,7 +2843,7 @@ const char *bactext_network_port_type_name(uint32_t index)
     }
 }
 
-INDTEXT_DATA bactext_network_number_quality_names[] = {
+INDTEXT_DATA bactext_network_number_quality_names[] BACNET_STACK_PROGMEM = {
     { PORT_QUALITY_UNKNOWN, "unknown" },
     { PORT_QUALITY_LEARNED, "learned" },
     { PORT_QUALITY_LEARNED_CONFIGURED, "learned-configured" },
@@ -2857,7 +2857,7 @@ const char *bactext_network_number_quality_name(uint32_t index)
         bactext_network_number_quality_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_protocol_level_names[] = {
+INDTEXT_DATA bactext_protocol_level_names[] BACNET_STACK_PROGMEM = {
     { BACNET_PROTOCOL_LEVEL_PHYSICAL, "physical" },
     { BACNET_PROTOCOL_LEVEL_PROTOCOL, "protocol" },
     { BACNET_PROTOCOL_LEVEL_BACNET_APPLICATION, "bacnet-application" },
@@ -2871,7 +2871,7 @@ const char *bactext_protocol_level_name(uint32_t index)
         bactext_protocol_level_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_network_port_command_names[] = {
+INDTEXT_DATA bactext_network_port_command_names[] BACNET_STACK_PROGMEM = {
     { PORT_COMMAND_IDLE, "idle" },
     { PORT_COMMAND_DISCARD_CHANGES, "discard-changes" },
     { PORT_COMMAND_RENEW_FD_REGISTRATION, "renew-fd-registration" },
@@ -2898,7 +2898,7 @@ const char *bactext_network_port_command_name(uint32_t index)
     }
 }
 
-INDTEXT_DATA bactext_authentication_decision_names[] = {
+INDTEXT_DATA bactext_authentication_decision_names[] BACNET_STACK_PROGMEM = {
     { BACNET_AUTHENTICATION_DECISION_ALLOW_MATCH, "allow-match" },
     { BACNET_AUTHENTICATION_DECISION_DENY_MISMATCH, "deny-mismatch" },
     { BACNET_AUTHENTICATION_DECISION_DENY_NON_RELAY, "deny-non-relay" },
@@ -2918,7 +2918,7 @@ bool bactext_authentication_decision_strtol(
         bactext_authentication_decision_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_authorization_posture_names[] = {
+INDTEXT_DATA bactext_authorization_posture_names[] BACNET_STACK_PROGMEM = {
     { BACNET_AUTHORIZATION_POSTURE_OPEN, "open" },
     { BACNET_AUTHORIZATION_POSTURE_PROPRIETARY, "proprietary" },
     { BACNET_AUTHORIZATION_POSTURE_CONFIGURED, "configured" },
@@ -2941,7 +2941,7 @@ bool bactext_authorization_posture_strtol(
         bactext_authorization_posture_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_fault_type_names[] = {
+INDTEXT_DATA bactext_fault_type_names[] BACNET_STACK_PROGMEM = {
     { BACNET_FAULT_TYPE_NONE, "none" },
     { BACNET_FAULT_TYPE_CHARACTERSTRING, "characterstring" },
     { BACNET_FAULT_TYPE_EXTENDED, "extended" },
@@ -2965,7 +2965,7 @@ bool bactext_fault_type_strtol(const char *search_name, uint32_t *found_index)
         bactext_fault_type_names, search_name, found_index);
 }
 
-INDTEXT_DATA bacnet_priority_filter_names[] = {
+INDTEXT_DATA bacnet_priority_filter_names[] BACNET_STACK_PROGMEM = {
     { BACNET_PRIORITY_FILTER_MANUAL_LIFE_SAFETY, "manual-life-safety" },
     { BACNET_PRIORITY_FILTER_AUTOMATIC_LIFE_SAFETY, "automatic-life-safety" },
     { BACNET_PRIORITY_FILTER_PRIORITY_3, "priority-3" },
@@ -2999,7 +2999,7 @@ bool bactext_priority_filter_strtol(
         bacnet_priority_filter_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_result_flags_names[] = {
+INDTEXT_DATA bactext_result_flags_names[] BACNET_STACK_PROGMEM = {
     { RESULT_FLAG_FIRST_ITEM, "first-item" },
     { RESULT_FLAG_LAST_ITEM, "last-item" },
     { RESULT_FLAG_MORE_ITEMS, "more-items" },
@@ -3018,7 +3018,7 @@ bool bactext_result_flags_strtol(const char *search_name, uint32_t *found_index)
         bactext_result_flags_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_success_filter_names[] = {
+INDTEXT_DATA bactext_success_filter_names[] BACNET_STACK_PROGMEM = {
     { BACNET_SUCCESS_FILTER_ALL, "all" },
     { BACNET_SUCCESS_FILTER_SUCCESS_ONLY, "success-only" },
     { BACNET_SUCCESS_FILTER_FAILURES_ONLY, "failures-only" },
@@ -3038,7 +3038,7 @@ bool bactext_success_filter_strtol(
         bactext_success_filter_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_logging_type_names[] = {
+INDTEXT_DATA bactext_logging_type_names[] BACNET_STACK_PROGMEM = {
     /* BACnetLoggingType enumerations */
     { LOGGING_TYPE_POLLED, "polled" },
     { LOGGING_TYPE_COV, "cov" },
@@ -3058,7 +3058,7 @@ bool bactext_logging_type_strtol(const char *search_name, uint32_t *found_index)
         bactext_logging_type_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_program_request_names[] = {
+INDTEXT_DATA bactext_program_request_names[] BACNET_STACK_PROGMEM = {
     { PROGRAM_REQUEST_READY, "ready" },
     { PROGRAM_REQUEST_LOAD, "load" },
     { PROGRAM_REQUEST_RUN, "run" },
@@ -3074,7 +3074,7 @@ const char *bactext_program_request_name(uint32_t index)
         bactext_program_request_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_program_state_names[] = {
+INDTEXT_DATA bactext_program_state_names[] BACNET_STACK_PROGMEM = {
     /* BACnetProgramState enumerations */
     { PROGRAM_STATE_IDLE, "idle" },
     { PROGRAM_STATE_LOADING, "loading" },
@@ -3091,7 +3091,7 @@ const char *bactext_program_state_name(uint32_t index)
         bactext_program_state_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_program_error_names[] = {
+INDTEXT_DATA bactext_program_error_names[] BACNET_STACK_PROGMEM = {
     /* BACnetProgramError enumerations */
     { PROGRAM_ERROR_NORMAL, "normal" },
     { PROGRAM_ERROR_LOAD_FAILED, "load-failed" },
@@ -3113,7 +3113,7 @@ const char *bactext_program_error_name(uint32_t index)
     }
 }
 
-INDTEXT_DATA bactext_timer_state_names[] = {
+INDTEXT_DATA bactext_timer_state_names[] BACNET_STACK_PROGMEM = {
     /* BACnetTimerState enumerations */
     { TIMER_STATE_IDLE, "idle" },
     { TIMER_STATE_RUNNING, "running" },
@@ -3127,7 +3127,7 @@ const char *bactext_timer_state_name(uint32_t index)
         bactext_timer_state_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_timer_transition_names[] = {
+INDTEXT_DATA bactext_timer_transition_names[] BACNET_STACK_PROGMEM = {
     /* BACnetTimerTransition enumerations */
     { TIMER_TRANSITION_NONE, "none" },
     { TIMER_TRANSITION_IDLE_TO_RUNNING, "idle-to-running" },
@@ -3146,9 +3146,9 @@ const char *bactext_timer_transition_name(uint32_t index)
         bactext_timer_transition_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_boolean_value_names[] = { { false, "false" },
-                                               { true, "true" },
-                                               { 0, NULL } };
+INDTEXT_DATA bactext_boolean_value_names[] BACNET_STACK_PROGMEM = {
+    { false, "false" }, { true, "true" }, { 0, NULL }
+};
 
 const char *bactext_boolean_value_name(uint32_t index)
 {
@@ -3156,7 +3156,7 @@ const char *bactext_boolean_value_name(uint32_t index)
         bactext_boolean_value_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_action_names[] = {
+INDTEXT_DATA bactext_action_names[] BACNET_STACK_PROGMEM = {
     /* BACnetAction enumerations */
     { ACTION_DIRECT, "direct" },
     { ACTION_REVERSE, "reverse" },
@@ -3169,7 +3169,7 @@ const char *bactext_action_name(uint32_t index)
         bactext_action_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_file_access_method_names[] = {
+INDTEXT_DATA bactext_file_access_method_names[] BACNET_STACK_PROGMEM = {
     /* BACnetFileAccessMethod enumerations */
     { FILE_RECORD_ACCESS, "record-access" },
     { FILE_STREAM_ACCESS, "stream-access" },
@@ -3183,7 +3183,7 @@ const char *bactext_file_access_method_name(uint32_t index)
         bactext_file_access_method_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_lock_status_names[] = {
+INDTEXT_DATA bactext_lock_status_names[] BACNET_STACK_PROGMEM = {
     /* BACnetLockStatus enumerations */
     { LOCK_STATUS_LOCKED, "locked" },
     { LOCK_STATUS_UNLOCKED, "unlocked" },
@@ -3199,7 +3199,7 @@ const char *bactext_lock_status_name(uint32_t index)
         bactext_lock_status_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_door_alarm_state_names[] = {
+INDTEXT_DATA bactext_door_alarm_state_names[] BACNET_STACK_PROGMEM = {
     /* BACnetDoorAlarmState enumerations */
     { DOOR_ALARM_STATE_NORMAL, "normal" },
     { DOOR_ALARM_STATE_ALARM, "alarm" },
@@ -3223,7 +3223,7 @@ const char *bactext_door_alarm_state_name(uint32_t index)
         Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_door_status_names[] = {
+INDTEXT_DATA bactext_door_status_names[] BACNET_STACK_PROGMEM = {
     /* BACnetDoorStatus enumerations */
     { DOOR_STATUS_CLOSED, "closed" },
     { DOOR_STATUS_OPENED, "opened" },
@@ -3248,7 +3248,7 @@ const char *bactext_door_status_name(uint32_t index)
         Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_door_secured_status_names[] = {
+INDTEXT_DATA bactext_door_secured_status_names[] BACNET_STACK_PROGMEM = {
     /* BACnetDoorSecuredStatus enumerations */
     { DOOR_SECURED_STATUS_SECURED, "secured" },
     { DOOR_SECURED_STATUS_UNSECURED, "unsecured" },
@@ -3262,7 +3262,7 @@ const char *bactext_door_secured_status_name(uint32_t index)
         bactext_door_secured_status_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_access_event_names[] = {
+INDTEXT_DATA bactext_access_event_names[] BACNET_STACK_PROGMEM = {
     /* BACnetAccessEvent enumerations */
     { ACCESS_EVENT_NONE, "none" },
     { ACCESS_EVENT_GRANTED, "granted" },
@@ -3358,7 +3358,7 @@ bactext_access_event_name_default(uint32_t index, const char *default_string)
         bactext_access_event_names, index, default_string);
 }
 
-INDTEXT_DATA bactext_authentication_status_names[] = {
+INDTEXT_DATA bactext_authentication_status_names[] BACNET_STACK_PROGMEM = {
     /* BACnetAuthenticationStatus enumerations */
     { AUTHENTICATION_STATUS_NOT_READY, "not-ready" },
     { AUTHENTICATION_STATUS_READY, "ready" },
@@ -3379,7 +3379,7 @@ const char *bactext_authentication_status_name(uint32_t index)
         bactext_authentication_status_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_authorization_mode_names[] = {
+INDTEXT_DATA bactext_authorization_mode_names[] BACNET_STACK_PROGMEM = {
     /* BACnetAuthorizationMode enumerations */
     { AUTHORIZATION_MODE_AUTHORIZE, "authorize" },
     { AUTHORIZATION_MODE_GRANT_ACTIVE, "grant-active" },
@@ -3407,7 +3407,7 @@ bool bactext_authorization_mode_strtol(
         bactext_authorization_mode_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_access_credential_disable_names[] = {
+INDTEXT_DATA bactext_access_credential_disable_names[] BACNET_STACK_PROGMEM = {
     /* BACnetAccessCredentialDisable enumerations */
     { ACCESS_CREDENTIAL_DISABLE_NONE, "none" },
     { ACCESS_CREDENTIAL_DISABLE_DISABLE, "disable" },
@@ -3427,7 +3427,8 @@ const char *bactext_access_credential_disable_name(uint32_t index)
         Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_access_credential_disable_reason_names[] = {
+INDTEXT_DATA bactext_access_credential_disable_reason_names[]
+    BACNET_STACK_PROGMEM = {
     /* BACnetAccessCredentialDisableReason enumerations */
     { CREDENTIAL_DISABLED, "none" },
     { CREDENTIAL_DISABLED_NEEDS_PROVISIONING, "needs-provisioning" },
@@ -3453,7 +3454,7 @@ const char *bactext_access_credential_disable_reason_name(uint32_t index)
         Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_access_user_type_names[] = {
+INDTEXT_DATA bactext_access_user_type_names[] BACNET_STACK_PROGMEM = {
     /* BACnetAccessUserType enumerations */
     { ACCESS_USER_TYPE_ASSET, "asset" },
     { ACCESS_USER_TYPE_GROUP, "group" },
@@ -3478,7 +3479,8 @@ bool bactext_access_user_type_strtol(
         bactext_access_user_type_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_access_zone_occupancy_state_names[] = {
+INDTEXT_DATA bactext_access_zone_occupancy_state_names[]
+    BACNET_STACK_PROGMEM = {
     /* BACnetAccessZoneOccupancyState enumerations */
     { ACCESS_ZONE_OCCUPANCY_STATE_NORMAL, "normal" },
     { ACCESS_ZONE_OCCUPANCY_STATE_BELOW_LOWER_LIMIT, "below-lower-limit" },
@@ -3500,7 +3502,7 @@ const char *bactext_access_zone_occupancy_state_name(uint32_t index)
         ASHRAE_Reserved_String, Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_write_status_names[] = {
+INDTEXT_DATA bactext_write_status_names[] BACNET_STACK_PROGMEM = {
     /* BACnetWriteStatus enumerations */
     { BACNET_WRITE_STATUS_IDLE, "idle" },
     { BACNET_WRITE_STATUS_IN_PROGRESS, "in-progress" },
@@ -3515,7 +3517,7 @@ const char *bactext_write_status_name(uint32_t index)
         bactext_write_status_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_ip_mode_names[] = {
+INDTEXT_DATA bactext_ip_mode_names[] BACNET_STACK_PROGMEM = {
     /* BACnetIPMode enumerations */
     { BACNET_IP_MODE_NORMAL, "normal" },
     { BACNET_IP_MODE_FOREIGN, "foreign" },
@@ -3535,7 +3537,7 @@ bool bactext_ip_mode_strtol(const char *search_name, uint32_t *found_index)
         bactext_ip_mode_names, search_name, found_index);
 }
 
-INDTEXT_DATA bactext_door_value_names[] = {
+INDTEXT_DATA bactext_door_value_names[] BACNET_STACK_PROGMEM = {
     /* BACnetDoorValue enumerations */
     { DOOR_VALUE_LOCK, "lock" },
     { DOOR_VALUE_UNLOCK, "unlock" },
@@ -3550,7 +3552,7 @@ const char *bactext_door_value_name(uint32_t index)
         bactext_door_value_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_maintenance_names[] = {
+INDTEXT_DATA bactext_maintenance_names[] BACNET_STACK_PROGMEM = {
     /* BACnetMaintenance enumerations */
     { MAINTENANCE_NONE, "none" },
     { MAINTENANCE_PERIODIC_TEST, "periodic-test" },
@@ -3569,7 +3571,7 @@ const char *bactext_maintenance_name(uint32_t index)
         ASHRAE_Reserved_String, Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_escalator_fault_names[] = {
+INDTEXT_DATA bactext_escalator_fault_names[] BACNET_STACK_PROGMEM = {
     /* BACnetEscalatorFault enumerations */
     { ESCALATOR_FAULT_CONTROLLER_FAULT, "controller-fault" },
     { ESCALATOR_FAULT_DRIVE_AND_MOTOR_FAULT, "drive-and-motor-fault" },
@@ -3595,7 +3597,7 @@ const char *bactext_escalator_fault_name(uint32_t index)
         ASHRAE_Reserved_String, Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_escalator_mode_names[] = {
+INDTEXT_DATA bactext_escalator_mode_names[] BACNET_STACK_PROGMEM = {
     /* BACnetEscalatorMode enumerations */
     { ESCALATOR_MODE_UNKNOWN, "unknown" },
     { ESCALATOR_MODE_STOP, "stop" },
@@ -3616,7 +3618,8 @@ const char *bactext_escalator_mode_name(uint32_t index)
         ASHRAE_Reserved_String, Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_escalator_operation_direction_names[] = {
+INDTEXT_DATA bactext_escalator_operation_direction_names[]
+    BACNET_STACK_PROGMEM = {
     /* BACnetEscalatorOperationDirection enumerations */
     { ESCALATOR_OPERATION_DIRECTION_UNKNOWN, "unknown" },
     { ESCALATOR_OPERATION_DIRECTION_STOPPED, "stopped" },
@@ -3637,7 +3640,7 @@ const char *bactext_escalator_operation_direction_name(uint32_t index)
         Vendor_Proprietary_String);
 }
 
-INDTEXT_DATA bactext_backup_state_names[] = {
+INDTEXT_DATA bactext_backup_state_names[] BACNET_STACK_PROGMEM = {
     /* BACnetBackupState enumerations */
     { BACKUP_STATE_IDLE, "idle" },
     { BACKUP_STATE_PREPARING_FOR_BACKUP, "preparing-for-backup" },
@@ -3655,7 +3658,7 @@ const char *bactext_backup_state_name(uint32_t index)
         bactext_backup_state_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_security_level_names[] = {
+INDTEXT_DATA bactext_security_level_names[] BACNET_STACK_PROGMEM = {
     /* BACnetSecurityLevel enumerations */
     { BACNET_SECURITY_LEVEL_INCAPABLE, "incapable" },
     { BACNET_SECURITY_LEVEL_PLAIN, "plain" },
@@ -3672,7 +3675,7 @@ const char *bactext_security_level_name(uint32_t index)
         bactext_security_level_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_lift_car_direction_names[] = {
+INDTEXT_DATA bactext_lift_car_direction_names[] BACNET_STACK_PROGMEM = {
     /* BACnetLiftCarDirection enumerations */
     { LIFT_CAR_DIRECTION_UNKNOWN, "unknown" },
     { LIFT_CAR_DIRECTION_NONE, "none" },
@@ -3689,7 +3692,7 @@ const char *bactext_lift_car_direction_name(uint32_t index)
         bactext_lift_car_direction_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_lift_car_door_command_names[] = {
+INDTEXT_DATA bactext_lift_car_door_command_names[] BACNET_STACK_PROGMEM = {
     /* BACnetLiftCarDoorCommand enumerations */
     { LIFT_CAR_DOOR_COMMAND_NONE, "none" },
     { LIFT_CAR_DOOR_COMMAND_OPEN, "open" },
@@ -3703,7 +3706,7 @@ const char *bactext_lift_car_door_command_name(uint32_t index)
         bactext_lift_car_door_command_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_lift_car_drive_status_names[] = {
+INDTEXT_DATA bactext_lift_car_drive_status_names[] BACNET_STACK_PROGMEM = {
     /* BACnetLiftCarDriveStatus enumerations */
     { LIFT_CAR_DRIVE_STATUS_UNKNOWN, "unknown" },
     { LIFT_CAR_DRIVE_STATUS_STATIONARY, "stationary" },
@@ -3724,7 +3727,7 @@ const char *bactext_lift_car_drive_status_name(uint32_t index)
         bactext_lift_car_drive_status_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_lift_car_mode_names[] = {
+INDTEXT_DATA bactext_lift_car_mode_names[] BACNET_STACK_PROGMEM = {
     /* BACnetLiftCarMode enumerations */
     { LIFT_CAR_MODE_UNKNOWN, "unknown" },
     { LIFT_CAR_MODE_NORMAL, "normal" },
@@ -3749,7 +3752,7 @@ const char *bactext_lift_car_mode_name(uint32_t index)
         bactext_lift_car_mode_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_lift_fault_names[] = {
+INDTEXT_DATA bactext_lift_fault_names[] BACNET_STACK_PROGMEM = {
     /* BACnetLiftFault enumerations */
     { LIFT_FAULT_CONTROLLER_FAULT, "controller-fault" },
     { LIFT_FAULT_DRIVE_AND_MOTOR_FAULT, "drive-and-motor-fault" },
@@ -3779,7 +3782,7 @@ const char *bactext_lift_fault_name(uint32_t index)
         bactext_lift_fault_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_lift_group_mode_names[] = {
+INDTEXT_DATA bactext_lift_group_mode_names[] BACNET_STACK_PROGMEM = {
     /* BACnetLiftGroupMode enumerations */
     { LIFT_GROUP_MODE_UNKNOWN, "unknown" },
     { LIFT_GROUP_MODE_NORMAL, "normal" },
@@ -3797,7 +3800,7 @@ const char *bactext_lift_group_mode_name(uint32_t index)
         bactext_lift_group_mode_names, index, ASHRAE_Reserved_String);
 }
 
-static INDTEXT_DATA bactext_audit_level_names[] = {
+static INDTEXT_DATA bactext_audit_level_names[] BACNET_STACK_PROGMEM = {
     /* BACnetAuditLevel enumerations */
     { AUDIT_LEVEL_NONE, "none" },
     { AUDIT_LEVEL_AUDIT_ALL, "audit-all" },
@@ -3812,7 +3815,7 @@ const char *bactext_audit_level_name(uint32_t index)
         bactext_audit_level_names, index, ASHRAE_Reserved_String);
 }
 
-static INDTEXT_DATA bactext_audit_operation_names[] = {
+static INDTEXT_DATA bactext_audit_operation_names[] BACNET_STACK_PROGMEM = {
     /* BACnetAuditOperation enumerations */
     { AUDIT_OPERATION_READ, "read" },
     { AUDIT_OPERATION_WRITE, "write" },
@@ -3839,7 +3842,7 @@ const char *bactext_audit_operation_name(uint32_t index)
         bactext_audit_operation_names, index, ASHRAE_Reserved_String);
 }
 
-INDTEXT_DATA bactext_sc_hub_connector_state_names[] = {
+INDTEXT_DATA bactext_sc_hub_connector_state_names[] BACNET_STACK_PROGMEM = {
     /* BACnetSCHubConnectorState enumerations */
     { BACNET_SC_HUB_CONNECTOR_STATE_NO_HUB_CONNECTION, "no-hub-connection" },
     { BACNET_SC_HUB_CONNECTOR_STATE_CONNECTED_TO_PRIMARY,
@@ -3855,7 +3858,7 @@ const char *bactext_sc_hub_connector_state_name(uint32_t index)
         bactext_sc_hub_connector_state_names, index, ASHRAE_Reserved_String);
 }
 
-static INDTEXT_DATA bactext_sc_connection_state_names[] = {
+static INDTEXT_DATA bactext_sc_connection_state_names[] BACNET_STACK_PROGMEM = {
     /* BACnetSCConnectionState enumerations */
     { BACNET_SC_CONNECTION_STATE_NOT_CONNECTED, "not-connected" },
     { BACNET_SC_CONNECTION_STATE_CONNECTED, "connected" },
@@ -3876,8 +3879,12 @@ typedef const struct {
     const uint32_t index;
     INDTEXT_DATA *data_list;
 } INDTEXT_PROPERTY_DATA;
+#define BACTEXT_PROPERTY_INDEX(data) \
+    ((uint32_t)bacnet_progmem_uint32(&(data)->index))
+#define BACTEXT_PROPERTY_LIST(data) \
+    ((INDTEXT_DATA *)bacnet_progmem_pointer(&(data)->data_list))
 
-INDTEXT_PROPERTY_DATA bactext_property_states_data[] = {
+INDTEXT_PROPERTY_DATA bactext_property_states_data[] BACNET_STACK_PROGMEM = {
     { PROP_STATE_BOOLEAN_VALUE, bactext_boolean_value_names },
     { PROP_STATE_BINARY_VALUE, bacnet_binary_present_value_names },
     { PROP_STATE_EVENT_TYPE, bacnet_event_type_names },
@@ -3956,10 +3963,10 @@ bool bactext_property_states_strtoul(
     INDTEXT_PROPERTY_DATA *list;
 
     list = bactext_property_states_data;
-    while (list->data_list != NULL) {
-        if (list->index == property_state) {
+    while (BACTEXT_PROPERTY_LIST(list) != NULL) {
+        if (BACTEXT_PROPERTY_INDEX(list) == property_state) {
             status = bactext_string_to_uint32_index(
-                list->data_list, search_name, found_index);
+                BACTEXT_PROPERTY_LIST(list), search_name, found_index);
             break;
         }
         list++;
@@ -3980,11 +3987,11 @@ const char *bactext_property_states_name(
     const char *name = NULL;
     INDTEXT_PROPERTY_DATA *list;
     list = bactext_property_states_data;
-    while (list->data_list != NULL) {
-        if (list->index == property_state) {
-            if (list->data_list != NULL) {
+    while (BACTEXT_PROPERTY_LIST(list) != NULL) {
+        if (BACTEXT_PROPERTY_INDEX(list) == property_state) {
+            if (BACTEXT_PROPERTY_LIST(list) != NULL) {
                 name = indtext_by_index_default(
-                    list->data_list, index, default_string);
+                    BACTEXT_PROPERTY_LIST(list), index, default_string);
             }
             break;
         }
@@ -3996,7 +4003,7 @@ const char *bactext_property_states_name(
     return name;
 }
 
-INDTEXT_PROPERTY_DATA bactext_object_property_data[] = {
+INDTEXT_PROPERTY_DATA bactext_object_property_data[] BACNET_STACK_PROGMEM = {
     { PROP_PROPERTY_LIST, bacnet_property_names },
     { PROP_OBJECT_TYPE, bacnet_object_type_names },
     { PROP_EVENT_STATE, bacnet_event_state_names },
@@ -4091,10 +4098,10 @@ const char *bactext_object_property_name(
     INDTEXT_PROPERTY_DATA *list;
 
     list = bactext_object_property_data;
-    while (list->data_list != NULL) {
-        if (list->index == object_property) {
+    while (BACTEXT_PROPERTY_LIST(list) != NULL) {
+        if (BACTEXT_PROPERTY_INDEX(list) == object_property) {
             name = indtext_by_index_default(
-                list->data_list, index, default_string);
+                BACTEXT_PROPERTY_LIST(list), index, default_string);
             break;
         }
         list++;
@@ -4197,10 +4204,10 @@ bool bactext_object_property_strtoul(
     INDTEXT_PROPERTY_DATA *list;
 
     list = bactext_object_property_data;
-    while (list->data_list != NULL) {
-        if (list->index == object_property) {
+    while (BACTEXT_PROPERTY_LIST(list) != NULL) {
+        if (BACTEXT_PROPERTY_INDEX(list) == object_property) {
             status = bactext_string_to_uint32_index(
-                list->data_list, search_name, found_index);
+                BACTEXT_PROPERTY_LIST(list), search_name, found_index);
             break;
         }
         list++;
@@ -18,41 +18,44 @@
 #include "bacnet/bacint.h"
 #include "bacnet/datetime.h"
 
-/**
- * Smaller version of BACnet_Application_Data_Value used in BACnetTimeValue
- *
- * This must be a separate struct to avoid recursive structure.
- * Keeping it small also helps keep the size of BACNET_APPLICATION_DATA_VALUE
- * small. Besides, schedule can't contain complex types.
- */
-typedef struct BACnet_Primitive_Data_Value {
-    uint8_t tag; /* application tag data type */
-    union {
-        /*
-         * ATTENTION! If a new type is added here, update
-         * `is_data_value_schedule_compatible()` in bactimevalue.c!
-         */
-
-        /* NULL - not needed as it is encoded in the tag alone */
+/* the value of a BACnet_Primitive_Data_Value, without its tag */
+typedef union BACnet_Primitive_Data_Type {
+    /*
+     * ATTENTION! If a new type is added here, update
+     * `is_data_value_schedule_compatible()` in bactimevalue.c!
+     */
+
+    /* NULL - not needed as it is encoded in the tag alone */
 #if defined(BACAPP_BOOLEAN)
-        bool Boolean;
+    bool Boolean;
 #endif
 #if defined(BACAPP_UNSIGNED)
-        BACNET_UNSIGNED_INTEGER Unsigned_Int;
+    BACNET_UNSIGNED_INTEGER Unsigned_Int;
 #endif
 #if defined(BACAPP_SIGNED)
-        int32_t Signed_Int;
+    int32_t Signed_Int;
 #endif
 #if defined(BACAPP_REAL)
-        float Real;
+    float Real;
 #endif
 #if defined(BACAPP_DOUBLE)
-        double Double;
+    double Double;
 #endif
 #if defined(BACAPP_ENUMERATED)
-        uint32_t Enumerated;
+    uint32_t Enumerated;
 #endif
-    } type;
+} BACNET_PRIMITIVE_DATA_TYPE;
+
+/**
+ * Smaller version of BACnet_Application_Data_Value used in BACnetTimeValue
+ *
+ * This must be a separate struct to avoid recursive structure.
+ * Keeping it small also helps keep the size of BACNET_APPLICATION_DATA_VALUE
+ * small. Besides, schedule can't contain complex types.
+ */
+typedef struct BACnet_Primitive_Data_Value {
+    uint8_t tag; /* application tag data type */
+    BACNET_PRIMITIVE_DATA_TYPE type;
 } BACNET_PRIMITIVE_DATA_VALUE;
 
 typedef struct BACnet_Time_Value {
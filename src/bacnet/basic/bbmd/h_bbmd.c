@@ -8,12 +8,15 @@
 #include <stdio.h> /* for standard i/o, like printing */
 #include <stdint.h> /* for standard integer types uint8_t etc. */
 #include <stdbool.h> /* for the standard bool type. */
+#include <stdlib.h> /* for calloc */
 #include <string.h> /* for memcpy */
 #include "bacnet/bacdcode.h"
 #include "bacnet/npdu.h"
 #include "bacnet/datalink/bip.h"
 #include "bacnet/datalink/bvlc.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 
@@ -63,11 +66,76 @@ static uint16_t BVLC_Buffer_Len;
 #endif
 static BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY
     BBMD_Table[MAX_BBMD_ENTRIES];
-/* Foreign Device Table */
+/* Foreign Device Table - the default size, which can be changed at
+   runtime with bvlc_fdt_size_set() */
 #ifndef MAX_FD_ENTRIES
 #define MAX_FD_ENTRIES 128
 #endif
-static BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY FD_Table[MAX_FD_ENTRIES];
+/* number of one second slots in the FDT timer wheel */
+#ifndef BBMD_FDT_WHEEL_SIZE
+#define BBMD_FDT_WHEEL_SIZE 64
+#endif
+/* seconds between updates of the FDT remaining time-to-live values
+   that are shown in the FDT list; the entries expire on time anyway */
+#ifndef BBMD_FDT_REFRESH_SECONDS
+#define BBMD_FDT_REFRESH_SECONDS 1
+#endif
+/* The FDT entries are found by a hash of their B/IPv4 address, and
+   expire from a timer wheel of one second slots that holds each valid
+   entry in the slot of its expiration time, so that registering,
+   deleting, and expiring an entry does not search the table. */
+/* links to the entries are the index plus one, and zero is no entry */
+#define BBMD_FDT_NONE 0
+struct bbmd_fdt_index {
+    uint32_t expires; /* FD_Clock when the entry expires */
+    uint32_t hash_next; /* next entry in the same hash bucket */
+    uint32_t wheel_next; /* next entry in the same timer wheel slot */
+    uint32_t wheel_prev; /* previous entry in the same timer wheel slot */
+};
+static BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY FD_Table_Default[MAX_FD_ENTRIES];
+static struct bbmd_fdt_index FD_Index_Default[MAX_FD_ENTRIES];
+static uint32_t FD_Hash_Default[MAX_FD_ENTRIES];
+/* destinations for one Forwarded-NPDU: local broadcast, BDT, and FDT */
+static BACNET_IP_ADDRESS
+    BBMD_Forward_Dest_Default[1 + MAX_BBMD_ENTRIES + MAX_FD_ENTRIES];
+static BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *FD_Table = FD_Table_Default;
+static struct bbmd_fdt_index *FD_Index = FD_Index_Default;
+static uint32_t *FD_Hash = FD_Hash_Default;
+static BACNET_IP_ADDRESS *BBMD_Forward_Dest = BBMD_Forward_Dest_Default;
+static uint32_t FD_Table_Size = MAX_FD_ENTRIES;
+static uint32_t FD_Wheel[BBMD_FDT_WHEEL_SIZE];
+static uint32_t FD_Clock;
+static uint32_t FD_Refresh_Clock;
+#define BBMD_FORWARD_BROADCAST 0x01
+#define BBMD_FORWARD_BDT 0x02
+#define BBMD_FORWARD_FDT 0x04
+/* number of recent broadcasts that are kept to drop their duplicates,
+   or zero to forward every broadcast */
+#ifndef BBMD_DUPLICATE_CACHE_SIZE
+#define BBMD_DUPLICATE_CACHE_SIZE 32
+#endif
+/* seconds that a broadcast is kept to drop its duplicates */
+#ifndef BBMD_DUPLICATE_WINDOW_SECONDS
+#define BBMD_DUPLICATE_WINDOW_SECONDS 2
+#endif
+/* In a meshed BDT, or when a foreign device is registered with more
+   than one BBMD, the same broadcast can reach a BBMD more than once.
+   Each broadcast is kept by the 64-bit hash of its originator and NPDU
+   in the slot of that hash, and the same broadcast from the same
+   originator within the window is dropped instead of forwarded again.
+   The hash is wide enough that a different broadcast of the same length
+   from the same originator is not mistaken for a duplicate. */
+#if BBMD_DUPLICATE_CACHE_SIZE
+struct bbmd_duplicate_entry {
+    BACNET_IP_ADDRESS originator;
+    uint64_t hash; /* hash of the originator and the NPDU */
+    uint32_t clock; /* FD_Clock when the broadcast was received */
+    uint16_t npdu_len;
+    bool valid;
+};
+static struct bbmd_duplicate_entry BBMD_Duplicate[BBMD_DUPLICATE_CACHE_SIZE];
+#endif
+static uint32_t BBMD_Duplicate_Count;
 #endif
 
 /**
@@ -239,6 +307,319 @@ void bvlc_bdt_restore_local(void)
 #endif
 #endif
 
+#if BBMD_ENABLED
+/**
+ * @brief Get the hash bucket of a B/IPv4 address in the FDT
+ * @param addr - B/IPv4 address
+ * @return index of the hash bucket
+ */
+static uint32_t bbmd_fdt_hash(const BACNET_IP_ADDRESS *addr)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned i;
+
+    /* FNV-1a of the address and port */
+    for (i = 0; i < IP_ADDRESS_MAX; i++) {
+        hash = (hash ^ addr->address[i]) * 16777619UL;
+    }
+    hash = (hash ^ (addr->port >> 8)) * 16777619UL;
+    hash = (hash ^ (addr->port & 0xFF)) * 16777619UL;
+
+    return hash % FD_Table_Size;
+}
+
+/**
+ * @brief Find a valid FDT entry
+ * @param addr - B/IPv4 address of the foreign device
+ * @return link to the entry, or BBMD_FDT_NONE if not found
+ */
+static uint32_t bbmd_fdt_find(const BACNET_IP_ADDRESS *addr)
+{
+    uint32_t link;
+
+    link = FD_Hash[bbmd_fdt_hash(addr)];
+    while (link != BBMD_FDT_NONE) {
+        if (!bvlc_address_different(&FD_Table[link - 1].dest_address, addr)) {
+            break;
+        }
+        link = FD_Index[link - 1].hash_next;
+    }
+
+    return link;
+}
+
+/**
+ * @brief Put a valid FDT entry in the hash and in the timer wheel slot
+ *  of its expiration time
+ * @param link - link to the entry
+ * @param seconds - seconds until the entry expires
+ */
+static void bbmd_fdt_link(uint32_t link, uint16_t seconds)
+{
+    struct bbmd_fdt_index *entry = &FD_Index[link - 1];
+    uint32_t bucket, slot;
+
+    bucket = bbmd_fdt_hash(&FD_Table[link - 1].dest_address);
+    entry->hash_next = FD_Hash[bucket];
+    FD_Hash[bucket] = link;
+    entry->expires = FD_Clock + seconds;
+    slot = entry->expires % BBMD_FDT_WHEEL_SIZE;
+    entry->wheel_prev = BBMD_FDT_NONE;
+    entry->wheel_next = FD_Wheel[slot];
+    if (entry->wheel_next != BBMD_FDT_NONE) {
+        FD_Index[entry->wheel_next - 1].wheel_prev = link;
+    }
+    FD_Wheel[slot] = link;
+}
+
+/**
+ * @brief Take a valid FDT entry out of the hash and the timer wheel
+ * @param link - link to the entry
+ */
+static void bbmd_fdt_unlink(uint32_t link)
+{
+    struct bbmd_fdt_index *entry = &FD_Index[link - 1];
+    uint32_t *next;
+
+    next = &FD_Hash[bbmd_fdt_hash(&FD_Table[link - 1].dest_address)];
+    while (*next != BBMD_FDT_NONE) {
+        if (*next == link) {
+            *next = entry->hash_next;
+            break;
+        }
+        next = &FD_Index[*next - 1].hash_next;
+    }
+    if (entry->wheel_prev != BBMD_FDT_NONE) {
+        FD_Index[entry->wheel_prev - 1].wheel_next = entry->wheel_next;
+    } else {
+        FD_Wheel[entry->expires % BBMD_FDT_WHEEL_SIZE] = entry->wheel_next;
+    }
+    if (entry->wheel_next != BBMD_FDT_NONE) {
+        FD_Index[entry->wheel_next - 1].wheel_prev = entry->wheel_prev;
+    }
+}
+
+/**
+ * @brief Update the remaining time-to-live of each valid FDT entry
+ *  from its expiration time
+ */
+static void bbmd_fdt_refresh(void)
+{
+    uint32_t slot, link;
+
+    for (slot = 0; slot < BBMD_FDT_WHEEL_SIZE; slot++) {
+        link = FD_Wheel[slot];
+        while (link != BBMD_FDT_NONE) {
+            FD_Table[link - 1].ttl_seconds_remaining =
+                (uint16_t)(FD_Index[link - 1].expires - FD_Clock);
+            link = FD_Index[link - 1].wheel_next;
+        }
+    }
+    FD_Refresh_Clock = FD_Clock;
+}
+
+/**
+ * @brief Rebuild the FDT hash and timer wheel from the valid entries
+ *  and their remaining time-to-live
+ */
+static void bbmd_fdt_index_rebuild(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < FD_Table_Size; i++) {
+        FD_Hash[i] = BBMD_FDT_NONE;
+    }
+    for (i = 0; i < BBMD_FDT_WHEEL_SIZE; i++) {
+        FD_Wheel[i] = BBMD_FDT_NONE;
+    }
+    bvlc_foreign_device_table_link_array(&FD_Table[0], FD_Table_Size);
+    for (i = 0; i < FD_Table_Size; i++) {
+        if (FD_Table[i].valid) {
+            if (FD_Table[i].ttl_seconds_remaining == 0) {
+                FD_Table[i].valid = false;
+            } else {
+                bbmd_fdt_link(i + 1, FD_Table[i].ttl_seconds_remaining);
+            }
+        }
+    }
+    FD_Refresh_Clock = FD_Clock;
+}
+
+/**
+ * @brief Add or update an entry in the Foreign-Device-Table
+ * @param addr - B/IPv4 address of the foreign device
+ * @param ttl_seconds - Time-to-Live requested by the foreign device
+ * @return true if the entry was added or updated
+ */
+static bool bbmd_fdt_add(const BACNET_IP_ADDRESS *addr, uint16_t ttl_seconds)
+{
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_entry;
+    uint16_t seconds;
+    uint32_t link;
+    uint32_t i;
+
+    /* a fixed grace period of 30 seconds is added to the Time-to-Live */
+    if (ttl_seconds < (UINT16_MAX - 30)) {
+        seconds = ttl_seconds + 30;
+    } else {
+        seconds = UINT16_MAX;
+    }
+    link = bbmd_fdt_find(addr);
+    if (link != BBMD_FDT_NONE) {
+        /* am I here already?  If so, restart my time to live... */
+        bbmd_fdt_unlink(link);
+    } else {
+        for (i = 0; i < FD_Table_Size; i++) {
+            if (!FD_Table[i].valid) {
+                link = i + 1;
+                break;
+            }
+        }
+        if (link == BBMD_FDT_NONE) {
+            return false;
+        }
+    }
+    fdt_entry = &FD_Table[link - 1];
+    bvlc_address_copy(&fdt_entry->dest_address, addr);
+    fdt_entry->ttl_seconds = ttl_seconds;
+    fdt_entry->ttl_seconds_remaining = seconds;
+    fdt_entry->valid = true;
+    bbmd_fdt_link(link, seconds);
+
+    return true;
+}
+
+/**
+ * @brief Clear an FDT entry that is deleted or expired
+ * @param link - link to the entry
+ */
+static void bbmd_fdt_clear(uint32_t link)
+{
+    bbmd_fdt_unlink(link);
+    FD_Table[link - 1].valid = false;
+    FD_Table[link - 1].ttl_seconds_remaining = 0;
+}
+
+/**
+ * @brief Delete an entry in the Foreign-Device-Table
+ * @param addr - B/IPv4 address of the foreign device
+ * @return true if the entry was found and deleted
+ */
+static bool bbmd_fdt_delete(const BACNET_IP_ADDRESS *addr)
+{
+    uint32_t link;
+
+    link = bbmd_fdt_find(addr);
+    if (link == BBMD_FDT_NONE) {
+        return false;
+    }
+    bbmd_fdt_clear(link);
+
+    return true;
+}
+
+/**
+ * @brief Advance the FDT clock, and clear the entries that expire,
+ *  which are only found in the timer wheel slots that are passed
+ * @param seconds - number of elapsed seconds
+ */
+static void bbmd_fdt_timer(uint16_t seconds)
+{
+    uint32_t clock, slot, link, next;
+    unsigned steps, i;
+
+    clock = FD_Clock + seconds;
+    steps = seconds;
+    if (steps > BBMD_FDT_WHEEL_SIZE) {
+        steps = BBMD_FDT_WHEEL_SIZE;
+    }
+    for (i = 1; i <= steps; i++) {
+        slot = (FD_Clock + i) % BBMD_FDT_WHEEL_SIZE;
+        link = FD_Wheel[slot];
+        while (link != BBMD_FDT_NONE) {
+            next = FD_Index[link - 1].wheel_next;
+            /* later turns of the wheel stay in the slot */
+            if ((int32_t)(clock - FD_Index[link - 1].expires) >= 0) {
+                debug_print_bip(
+                    "FDT entry expired", &FD_Table[link - 1].dest_address);
+                bbmd_fdt_clear(link);
+            }
+            link = next;
+        }
+    }
+    FD_Clock = clock;
+    if ((FD_Clock - FD_Refresh_Clock) >= BBMD_FDT_REFRESH_SECONDS) {
+        bbmd_fdt_refresh();
+    }
+}
+#endif
+
+#if BBMD_ENABLED
+/**
+ * @brief Check if a broadcast was received within the window, and keep
+ *  it if it was not
+ * @param originator - B/IPv4 address of the originator of the broadcast
+ * @param npdu - the NPDU of the broadcast
+ * @param npdu_len - number of bytes in the NPDU
+ * @return true if the broadcast is a duplicate, which is counted
+ */
+static bool bbmd_duplicate(
+    const BACNET_IP_ADDRESS *originator,
+    const uint8_t *npdu,
+    uint16_t npdu_len)
+{
+#if BBMD_DUPLICATE_CACHE_SIZE
+    struct bbmd_duplicate_entry *entry;
+    uint64_t hash = 14695981039346656037ULL;
+    unsigned i;
+
+    /* 64-bit FNV-1a of the originator and the NPDU */
+    for (i = 0; i < IP_ADDRESS_MAX; i++) {
+        hash = (hash ^ originator->address[i]) * 1099511628211ULL;
+    }
+    hash = (hash ^ (originator->port >> 8)) * 1099511628211ULL;
+    hash = (hash ^ (originator->port & 0xFF)) * 1099511628211ULL;
+    for (i = 0; i < npdu_len; i++) {
+        hash = (hash ^ npdu[i]) * 1099511628211ULL;
+    }
+    entry = &BBMD_Duplicate[hash % BBMD_DUPLICATE_CACHE_SIZE];
+    if (entry->valid && (entry->hash == hash) &&
+        (entry->npdu_len == npdu_len) &&
+        ((FD_Clock - entry->clock) < BBMD_DUPLICATE_WINDOW_SECONDS) &&
+        !bvlc_address_different(&entry->originator, originator)) {
+        BBMD_Duplicate_Count++;
+        debug_print_bip("Dropped duplicate broadcast from", originator);
+        return true;
+    }
+    bvlc_address_copy(&entry->originator, originator);
+    entry->hash = hash;
+    entry->clock = FD_Clock;
+    entry->npdu_len = npdu_len;
+    entry->valid = true;
+#else
+    (void)originator;
+    (void)npdu;
+    (void)npdu_len;
+#endif
+
+    return false;
+}
+
+/**
+ * @brief Forget the broadcasts that were kept to drop their duplicates
+ */
+static void bbmd_duplicate_clear(void)
+{
+#if BBMD_DUPLICATE_CACHE_SIZE
+    unsigned i;
+
+    for (i = 0; i < BBMD_DUPLICATE_CACHE_SIZE; i++) {
+        BBMD_Duplicate[i].valid = false;
+    }
+#endif
+}
+#endif
+
 /** A timer function that is called about once a second.
  *
  * @param seconds - number of elapsed seconds since the last call
@@ -246,7 +627,7 @@ void bvlc_bdt_restore_local(void)
 void bvlc_maintenance_timer(uint16_t seconds)
 {
 #if BBMD_ENABLED
-    bvlc_foreign_device_table_maintenance_timer(&FD_Table[0], seconds);
+    bbmd_fdt_timer(seconds);
 #else
     (void)seconds;
 #endif
@@ -308,55 +689,73 @@ static bool bbmd_bdt_member_mask_is_unicast(const BACNET_IP_ADDRESS *addr)
     return unicast;
 }
 
-/** Send a BVLL Forwarded-NPDU message on its local IP subnet using
- * the local B/IP broadcast address as the destination address.
+/** Check if a Forwarded NPDU should not be sent to a BDT or FDT entry
  *
+ * @param bip_dest - IP address and UDP port of the BDT or FDT entry
  * @param bip_src - source IP address and UDP port
- * @param npdu - returns the NPDU
- * @param max_npdu - amount of space available in the NPDU
- * @param npdu_length - reported length of the NPDU
- * @return number of bytes encoded in the Forwarded NPDU
+ * @param my_addr - our IP address and UDP port
+ * @return true if the destination is to be skipped
  */
-static uint16_t bbmd_forward_npdu(
-    const BACNET_IP_ADDRESS *bip_src, const uint8_t *npdu, uint16_t npdu_length)
+static bool bbmd_forward_dest_skip(
+    const BACNET_IP_ADDRESS *bip_dest,
+    const BACNET_IP_ADDRESS *bip_src,
+    const BACNET_IP_ADDRESS *my_addr)
 {
-    BACNET_IP_ADDRESS broadcast_address = { 0 };
-    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
-    uint16_t mtu_len = 0;
-
-    mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(
-        &mtu[0], (uint16_t)sizeof(mtu), bip_src, npdu, npdu_length);
-    if (mtu_len > 0) {
-        bip_get_broadcast_addr(&broadcast_address);
-        bip_send_mpdu(&broadcast_address, mtu, mtu_len);
-        debug_printf("BVLC: Sent Forwarded-NPDU as local broadcast.\n");
+    if (!bvlc_address_different(bip_dest, my_addr)) {
+        /* don't forward to our selves */
+        return true;
+    }
+    if (!bvlc_address_different(bip_dest, bip_src)) {
+        /* don't forward back to origin */
+        return true;
+    }
+    if (BVLC_NAT_Handling) {
+        if (bvlc_address_different(bip_dest, &BVLC_Global_Address)) {
+            /* NAT router port forwards BACnet packets from global IP.
+               Packets sent to that global IP by us would end up back,
+               creating a loop. */
+            return true;
+        }
     }
 
-    return mtu_len;
+    return false;
 }
 
-/** Sends all Broadcast Devices a Forwarded NPDU
+/** Sends a Forwarded NPDU to the local subnet, Broadcast Devices,
+ * and Foreign Devices
+ *
+ * The Forwarded NPDU is encoded once, and sent to all of the
+ * destinations with one call to the port layer.
  *
  * @param bip_src - source IP address and UDP port
- * @param npdu - returns the NPDU
- * @param max_npdu - amount of space available in the NPDU
+ * @param npdu - the NPDU
  * @param npdu_length - reported length of the NPDU
  * @param original - was the message an original (not forwarded)
+ * @param destinations - any of BBMD_FORWARD_BROADCAST, BBMD_FORWARD_BDT,
+ *  and BBMD_FORWARD_FDT
  * @return number of bytes encoded in the Forwarded NPDU
  */
-static uint16_t bbmd_bdt_forward_npdu(
+static uint16_t bbmd_forward_npdu(
     const BACNET_IP_ADDRESS *bip_src,
     const uint8_t *npdu,
     uint16_t npdu_length,
-    bool original)
+    bool original,
+    uint8_t destinations)
 {
     uint8_t mtu[BIP_MPDU_MAX] = { 0 };
     uint16_t mtu_len = 0;
     unsigned i = 0; /* loop counter */
-    BACNET_IP_ADDRESS bip_dest = { 0 };
+    unsigned dest_count = 0;
+    BACNET_IP_ADDRESS *bip_dest;
     BACNET_IP_ADDRESS my_addr = { 0 };
+    BACNET_IP_ADDRESS broadcast_addr = { 0 };
+    bool broadcast_sent;
 
     bip_get_addr(&my_addr);
+    bip_get_broadcast_addr(&broadcast_addr);
+    /* an original broadcast was sent to, or received on, our B/IP
+       broadcast address, and so was the local broadcast */
+    broadcast_sent = original || (destinations & BBMD_FORWARD_BROADCAST);
     /* If we are forwarding an original broadcast message and the NAT
      * handling is enabled, change the source address to NAT routers
      * global IP address so the recipient can reply (local IP address
@@ -373,98 +772,54 @@ static uint16_t bbmd_bdt_forward_npdu(
         mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(
             &mtu[0], (uint16_t)sizeof(mtu), bip_src, npdu, npdu_length);
     }
-    /* loop through the BDT and send one to each entry */
-    for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
-        if (BBMD_Table[i].valid) {
-            bvlc_broadcast_distribution_table_entry_forward_address(
-                &bip_dest, &BBMD_Table[i]);
-            if (!bvlc_address_different(&bip_dest, &my_addr)) {
-                /* don't forward to our selves */
-                continue;
-            }
-            if (!bvlc_address_different(&bip_dest, bip_src)) {
-                /* don't forward back to origin */
-                continue;
-            }
-            if (BVLC_NAT_Handling) {
-                if (bvlc_address_different(&bip_dest, &BVLC_Global_Address)) {
-                    /* NAT router port forwards BACnet packets from global IP.
-                       Packets sent to that global IP by us would end up back,
-                       creating a loop. */
+    if (mtu_len == 0) {
+        return 0;
+    }
+    if (destinations & BBMD_FORWARD_BROADCAST) {
+        bip_get_broadcast_addr(&BBMD_Forward_Dest[dest_count]);
+        dest_count++;
+        debug_printf("BVLC: Send Forwarded-NPDU as local broadcast.\n");
+    }
+    /* loop through the BDT and add each entry */
+    if (destinations & BBMD_FORWARD_BDT) {
+        for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
+            if (BBMD_Table[i].valid) {
+                bip_dest = &BBMD_Forward_Dest[dest_count];
+                bvlc_broadcast_distribution_table_entry_forward_address(
+                    bip_dest, &BBMD_Table[i]);
+                if (bbmd_forward_dest_skip(bip_dest, bip_src, &my_addr)) {
+                    continue;
+                }
+                if (broadcast_sent &&
+                    !bvlc_address_different(bip_dest, &broadcast_addr)) {
+                    /* a multicast group (Annex J.8) that the peers have
+                       joined, which already has the broadcast */
                     continue;
                 }
+                dest_count++;
+                debug_print_bip("BDT Send Forwarded-NPDU", bip_dest);
             }
-            bip_send_mpdu(&bip_dest, mtu, mtu_len);
-            debug_print_bip("BDT Send Forwarded-NPDU", &bip_dest);
         }
     }
-
-    return mtu_len;
-}
-
-/** Sends all Foreign Devices a Forwarded NPDU
- *
- * @param bip_src - source IP address and UDP port
- * @param npdu - returns the NPDU
- * @param max_npdu - amount of space available in the NPDU
- * @param npdu_length - reported length of the NPDU
- * @param original - was the message an original (not forwarded)
- * @return number of bytes encoded in the Forwarded NPDU
- */
-static uint16_t bbmd_fdt_forward_npdu(
-    const BACNET_IP_ADDRESS *bip_src,
-    const uint8_t *npdu,
-    uint16_t npdu_length,
-    bool original)
-{
-    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
-    uint16_t mtu_len = 0;
-    unsigned i = 0; /* loop counter */
-    BACNET_IP_ADDRESS bip_dest = { 0 };
-    BACNET_IP_ADDRESS my_addr = { 0 };
-
-    bip_get_addr(&my_addr);
-    /* If we are forwarding an original broadcast message and the NAT
-     * handling is enabled, change the source address to NAT routers
-     * global IP address so the recipient can reply (local IP address
-     * is not accessible from internet side.
-     *
-     * If we are forwarding a message from peer BBMD or foreign device
-     * or the NAT handling is disabled, leave the source address as is.
-     */
-    if (BVLC_NAT_Handling && original) {
-        mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(
-            &mtu[0], (uint16_t)sizeof(mtu), &BVLC_Global_Address, npdu,
-            npdu_length);
-    } else {
-        mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(
-            &mtu[0], (uint16_t)sizeof(mtu), bip_src, npdu, npdu_length);
-    }
-
-    /* loop through the FDT and send one to each entry */
-    for (i = 0; i < MAX_FD_ENTRIES; i++) {
-        if (FD_Table[i].valid && FD_Table[i].ttl_seconds_remaining) {
-            bvlc_address_copy(&bip_dest, &FD_Table[i].dest_address);
-            if (!bvlc_address_different(&bip_dest, &my_addr)) {
-                /* don't forward to our selves */
-                continue;
-            }
-            if (!bvlc_address_different(&bip_dest, bip_src)) {
-                /* don't forward back to origin */
-                continue;
-            }
-            if (BVLC_NAT_Handling) {
-                if (bvlc_address_different(&bip_dest, &BVLC_Global_Address)) {
-                    /* NAT router port forwards BACnet packets from global IP.
-                       Packets sent to that global IP by us would end up back,
-                       creating a loop. */
+    /* loop through the FDT and add each entry */
+    if (destinations & BBMD_FORWARD_FDT) {
+        for (i = 0; i < FD_Table_Size; i++) {
+            if (FD_Table[i].valid) {
+                bip_dest = &BBMD_Forward_Dest[dest_count];
+                bvlc_address_copy(bip_dest, &FD_Table[i].dest_address);
+                if (bbmd_forward_dest_skip(bip_dest, bip_src, &my_addr)) {
                     continue;
                 }
+                dest_count++;
+                debug_print_bip("FDT Send Forwarded-NPDU", bip_dest);
             }
-            bip_send_mpdu(&bip_dest, mtu, mtu_len);
-            debug_print_bip("FDT Send Forwarded-NPDU", &bip_dest);
         }
     }
+    if (dest_count > 0) {
+        (void)bip_send_mpdu_multiple(
+            &BBMD_Forward_Dest[0], dest_count, mtu, mtu_len);
+        PERFSTAT_DATALINK_FORWARD(PERFSTAT_DATALINK_BIP, dest_count);
+    }
 
     return mtu_len;
 }
@@ -569,52 +924,48 @@ static void bbmd_read_fdt_ack_handler(
 #endif
 
 /**
- * The common send function for BACnet/IP application layer
- *
+ * @brief Choose the destination and BVLC message for an NPDU, and
+ *  forward an original broadcast to the BDT and FDT when we are a BBMD
  * @param dest - Points to a #BACNET_ADDRESS structure containing the
  *  destination address.
- * @param npdu_data - Points to a BACNET_NPDU_DATA structure containing the
- *  destination network layer control flags and data.
- * @param mtu - the bytes of data to send
- * @param mtu_len - the number of bytes of data to send
- * @return Upon successful completion, returns the number of bytes sent.
- *  Otherwise, -1 shall be returned to indicate the error.
+ * @param pdu - the NPDU to send
+ * @param pdu_len - the number of bytes in the NPDU
+ * @param bvlc_dest - [out] the B/IPv4 destination address
+ * @return the BVLC message type, or -1 if the address is not valid
  */
-int bvlc_send_pdu(
+static int bvlc_send_destination(
     const BACNET_ADDRESS *dest,
-    const BACNET_NPDU_DATA *npdu_data,
     const uint8_t *pdu,
-    unsigned pdu_len)
+    unsigned pdu_len,
+    BACNET_IP_ADDRESS *bvlc_dest)
 {
-    BACNET_IP_ADDRESS bvlc_dest = { 0 };
-    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
-    uint16_t mtu_len = 0;
+    int message_type;
 #if BBMD_ENABLED
     BACNET_IP_ADDRESS bip_src = { 0 };
+#else
+    (void)pdu;
+    (void)pdu_len;
 #endif
 
-    /* this datalink doesn't need to know the npdu data */
-    (void)npdu_data;
     /* handle various broadcasts: */
     if ((dest->net == BACNET_BROADCAST_NETWORK) || (dest->mac_len == 0)) {
         /* mac_len = 0 is a broadcast address */
         /* net = 0 indicates local, net = 65535 indicates global */
         if (Remote_BBMD.port) {
             /* we are a foreign device */
-            bvlc_address_copy(&bvlc_dest, &Remote_BBMD);
-            mtu_len = bvlc_encode_distribute_broadcast_to_network(
-                mtu, sizeof(mtu), pdu, pdu_len);
-            debug_print_bip("Send Distribute-Broadcast-to-Network", &bvlc_dest);
+            bvlc_address_copy(bvlc_dest, &Remote_BBMD);
+            message_type = BVLC_DISTRIBUTE_BROADCAST_TO_NETWORK;
+            debug_print_bip("Send Distribute-Broadcast-to-Network", bvlc_dest);
         } else {
-            bip_get_broadcast_addr(&bvlc_dest);
-            mtu_len =
-                bvlc_encode_original_broadcast(mtu, sizeof(mtu), pdu, pdu_len);
-            debug_print_bip("Send Original-Broadcast-NPDU", &bvlc_dest);
+            bip_get_broadcast_addr(bvlc_dest);
+            message_type = BVLC_ORIGINAL_BROADCAST_NPDU;
+            debug_print_bip("Send Original-Broadcast-NPDU", bvlc_dest);
 #if BBMD_ENABLED
-            if (mtu_len > 0) {
+            if (pdu_len <= (BIP_MPDU_MAX - 4)) {
                 bip_get_addr(&bip_src);
-                (void)bbmd_fdt_forward_npdu(&bip_src, pdu, pdu_len, true);
-                (void)bbmd_bdt_forward_npdu(&bip_src, pdu, pdu_len, true);
+                (void)bbmd_forward_npdu(
+                    &bip_src, pdu, pdu_len, true,
+                    BBMD_FORWARD_BDT | BBMD_FORWARD_FDT);
             }
 #endif
         }
@@ -622,26 +973,109 @@ int bvlc_send_pdu(
         /* net > 0 and net < 65535 are network specific broadcast if len = 0 */
         if (dest->mac_len == 6) {
             /* network specific broadcast to address */
-            bvlc_ip_address_from_bacnet_local(&bvlc_dest, dest);
+            bvlc_ip_address_from_bacnet_local(bvlc_dest, dest);
         } else {
-            bip_get_broadcast_addr(&bvlc_dest);
+            bip_get_broadcast_addr(bvlc_dest);
         }
-        mtu_len =
-            bvlc_encode_original_broadcast(mtu, sizeof(mtu), pdu, pdu_len);
-        debug_print_bip("Send Original-Broadcast-NPDU", &bvlc_dest);
+        message_type = BVLC_ORIGINAL_BROADCAST_NPDU;
+        debug_print_bip("Send Original-Broadcast-NPDU", bvlc_dest);
     } else if (dest->mac_len == 6) {
         /* valid unicast */
-        bvlc_ip_address_from_bacnet_local(&bvlc_dest, dest);
-        mtu_len = bvlc_encode_original_unicast(mtu, sizeof(mtu), pdu, pdu_len);
-        debug_print_bip("Send Original-Unicast-NPDU", &bvlc_dest);
+        bvlc_ip_address_from_bacnet_local(bvlc_dest, dest);
+        message_type = BVLC_ORIGINAL_UNICAST_NPDU;
+        debug_print_bip("Send Original-Unicast-NPDU", bvlc_dest);
     } else {
         debug_print_string("Send failure. Invalid Address.");
+        message_type = -1;
+    }
+
+    return message_type;
+}
+
+/**
+ * The common send function for BACnet/IP application layer
+ *
+ * @param dest - Points to a #BACNET_ADDRESS structure containing the
+ *  destination address.
+ * @param npdu_data - Points to a BACNET_NPDU_DATA structure containing the
+ *  destination network layer control flags and data.
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ * @return Upon successful completion, returns the number of bytes sent.
+ *  Otherwise, -1 shall be returned to indicate the error.
+ */
+int bvlc_send_pdu(
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *npdu_data,
+    const uint8_t *pdu,
+    unsigned pdu_len)
+{
+    BACNET_IP_ADDRESS bvlc_dest = { 0 };
+    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
+    uint16_t mtu_len = 0;
+    int message_type;
+
+    /* this datalink doesn't need to know the npdu data */
+    (void)npdu_data;
+    message_type = bvlc_send_destination(dest, pdu, pdu_len, &bvlc_dest);
+    if (message_type < 0) {
         return -1;
     }
+    if (pdu && (pdu_len <= (sizeof(mtu) - 4))) {
+        mtu_len = (uint16_t)(4 + pdu_len);
+        (void)bvlc_encode_header(
+            mtu, sizeof(mtu), (uint8_t)message_type, mtu_len);
+        memcpy(&mtu[4], pdu, pdu_len);
+    }
+    PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_BIP);
+    BACTRACE_DATALINK_SEND(PERFSTAT_DATALINK_BIP, pdu_len);
 
     return bip_send_mpdu(&bvlc_dest, mtu, mtu_len);
 }
 
+/**
+ * @brief Send an NPDU from a PDU buffer, with the BVLC header prepended
+ *  in the headroom of the buffer instead of copying the NPDU
+ *
+ * The buffer holds the BVLL message after this returns.  If it does
+ * not have 4 bytes of headroom, the NPDU is copied as by bvlc_send_pdu().
+ *
+ * @param dest - Points to a #BACNET_ADDRESS structure containing the
+ *  destination address.
+ * @param npdu_data - Points to a BACNET_NPDU_DATA structure containing the
+ *  destination network layer control flags and data.
+ * @param buf - PDU buffer holding the NPDU
+ * @return Upon successful completion, returns the number of bytes sent.
+ *  Otherwise, -1 shall be returned to indicate the error.
+ */
+int bvlc_send_pdubuf(
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *npdu_data,
+    PDU_BUFFER *buf)
+{
+    BACNET_IP_ADDRESS bvlc_dest = { 0 };
+    uint16_t pdu_len;
+    uint8_t *mtu;
+    int message_type;
+
+    pdu_len = pdubuf_length(buf);
+    if ((pdubuf_headroom(buf) < 4) || (pdu_len > (BIP_MPDU_MAX - 4))) {
+        return bvlc_send_pdu(dest, npdu_data, pdubuf_data(buf), pdu_len);
+    }
+    message_type =
+        bvlc_send_destination(dest, pdubuf_data(buf), pdu_len, &bvlc_dest);
+    if (message_type < 0) {
+        return -1;
+    }
+    mtu = pdubuf_push(buf, 4);
+    (void)bvlc_encode_header(
+        mtu, 4, (uint8_t)message_type, pdubuf_length(buf));
+    PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_BIP);
+    BACTRACE_DATALINK_SEND(PERFSTAT_DATALINK_BIP, pdubuf_length(buf) - 4U);
+
+    return bip_send_mpdu(&bvlc_dest, mtu, pdubuf_length(buf));
+}
+
 /**
  * The Result Code send function for BACnet/IPv4 application layer
  *
@@ -958,6 +1392,13 @@ int bvlc_bbmd_enabled_handler(
                     debug_print_string("Dropped Forwarded-NPDU from me!");
                     break;
                 }
+                offset = header_len + function_len - npdu_len;
+                npdu = &mtu[offset];
+                if (bbmd_duplicate(&fwd_address, npdu, npdu_len)) {
+                    /* already forwarded, and given to me */
+                    offset = 0;
+                    break;
+                }
                 if (bbmd_bdt_member_mask_is_unicast(addr)) {
                     /*  Upon receipt of a BVLL Forwarded-NPDU message
                         from a BBMD which is in the receiving BBMD's BDT,
@@ -970,10 +1411,8 @@ int bvlc_bbmd_enabled_handler(
                 /*  In addition, the constructed BVLL Forwarded-NPDU
                     message shall be unicast to each foreign device in
                     the BBMD's FDT. */
-                offset = header_len + function_len - npdu_len;
-                npdu = &mtu[offset];
-                (void)bbmd_fdt_forward_npdu(
-                    &fwd_address, npdu, npdu_len, false);
+                (void)bbmd_forward_npdu(
+                    &fwd_address, npdu, npdu_len, false, BBMD_FORWARD_FDT);
                 /* prepare the message for me! */
                 bvlc_ip_address_to_bacnet_local(src, &fwd_address);
                 debug_print_npdu("Forwarded-NPDU", offset, npdu_len);
@@ -1000,8 +1439,7 @@ int bvlc_bbmd_enabled_handler(
             function_len =
                 bvlc_decode_register_foreign_device(pdu, pdu_len, &ttl_seconds);
             if (function_len) {
-                if (bvlc_foreign_device_table_entry_add(
-                        &FD_Table[0], addr, ttl_seconds)) {
+                if (bbmd_fdt_add(addr, ttl_seconds)) {
                     result_code = BVLC_RESULT_SUCCESSFUL_COMPLETION;
                     send_result = true;
                 } else {
@@ -1021,6 +1459,7 @@ int bvlc_bbmd_enabled_handler(
                it shall return a BVLC-Result message to the originating device
                with a result code of X'0040' indicating that the read attempt
                has failed. */
+            bbmd_fdt_refresh();
             BVLC_Buffer_Len = bvlc_encode_read_foreign_device_table_ack(
                 BVLC_Buffer, sizeof(BVLC_Buffer), &FD_Table[0]);
             if (BVLC_Buffer_Len > 0) {
@@ -1051,8 +1490,7 @@ int bvlc_bbmd_enabled_handler(
             function_len =
                 bvlc_decode_delete_foreign_device(pdu, pdu_len, &fwd_address);
             if (function_len > 0) {
-                if (bvlc_foreign_device_table_entry_delete(
-                        &FD_Table[0], &fwd_address)) {
+                if (bbmd_fdt_delete(&fwd_address)) {
                     result_code = BVLC_RESULT_SUCCESSFUL_COMPLETION;
                     send_result = true;
                 } else {
@@ -1081,11 +1519,15 @@ int bvlc_bbmd_enabled_handler(
                it shall return a BVLC-Result message to the foreign device
                with a result code of X'0060' indicating that the forwarding
                attempt was unsuccessful */
-            npdu_len = bbmd_forward_npdu(addr, pdu, pdu_len);
-            if (npdu_len > 0) {
-                (void)bbmd_fdt_forward_npdu(addr, pdu, pdu_len, false);
-                (void)bbmd_bdt_forward_npdu(addr, pdu, pdu_len, false);
-            } else {
+            if (bbmd_duplicate(addr, pdu, pdu_len)) {
+                /* already forwarded */
+                offset = 0;
+                break;
+            }
+            npdu_len = bbmd_forward_npdu(
+                addr, pdu, pdu_len, false,
+                BBMD_FORWARD_BROADCAST | BBMD_FORWARD_BDT | BBMD_FORWARD_FDT);
+            if (npdu_len == 0) {
                 result_code = BVLC_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK;
                 send_result = true;
             }
@@ -1148,9 +1590,13 @@ int bvlc_bbmd_enabled_handler(
                     offset = 0;
                     debug_print_string("Dropped Original-Broadcast-NPDU: "
                                        "Confirmed Service!");
+                } else if (bbmd_duplicate(addr, npdu, npdu_len)) {
+                    /* already forwarded, and given to me */
+                    offset = 0;
                 } else {
-                    (void)bbmd_fdt_forward_npdu(addr, npdu, npdu_len, true);
-                    (void)bbmd_bdt_forward_npdu(addr, npdu, npdu_len, true);
+                    (void)bbmd_forward_npdu(
+                        addr, npdu, npdu_len, true,
+                        BBMD_FORWARD_BDT | BBMD_FORWARD_FDT);
                     debug_print_npdu(
                         "Original-Broadcast-NPDU", offset, npdu_len);
                 }
@@ -1191,6 +1637,8 @@ int bvlc_handler(
     uint8_t *npdu,
     uint16_t npdu_len)
 {
+    PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_BIP);
+    BACTRACE_DATALINK_RECEIVE(PERFSTAT_DATALINK_BIP, npdu_len);
 #if BBMD_ENABLED
     debug_print_bip("Received BVLC (BBMD Enabled)", addr);
     return bvlc_bbmd_enabled_handler(addr, src, npdu, npdu_len);
@@ -1211,6 +1659,8 @@ int bvlc_broadcast_handler(
     uint16_t message_length = 0;
     int header_len = 0;
 
+    PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_BIP);
+    BACTRACE_DATALINK_RECEIVE(PERFSTAT_DATALINK_BIP, npdu_len);
     debug_print_bip("Received Broadcast", addr);
     header_len =
         bvlc_decode_header(npdu, npdu_len, &message_type, &message_length);
@@ -1410,9 +1860,92 @@ void bvlc_set_function_code(uint8_t function_code)
  */
 BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *bvlc_fdt_list(void)
 {
+    bbmd_fdt_refresh();
+
     return &FD_Table[0];
 }
 
+/**
+ * @brief Get the number of entries in the foreign device table (FDT)
+ * @return number of valid and free entries
+ */
+unsigned bvlc_fdt_size(void)
+{
+    return FD_Table_Size;
+}
+
+/**
+ * @brief Size the foreign device table (FDT) at runtime.  The valid
+ *  entries are kept, up to the new size, with their remaining time.
+ * @param size - number of entries, or zero for the default size
+ * @return true if the table was sized
+ */
+bool bvlc_fdt_size_set(unsigned size)
+{
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_table;
+    struct bbmd_fdt_index *fdt_index;
+    uint32_t *fdt_hash;
+    BACNET_IP_ADDRESS *forward_dest;
+    uint32_t i, count = 0;
+
+    bbmd_fdt_refresh();
+    if ((size == 0) || (size == MAX_FD_ENTRIES)) {
+        size = MAX_FD_ENTRIES;
+        fdt_table = FD_Table_Default;
+        fdt_index = FD_Index_Default;
+        fdt_hash = FD_Hash_Default;
+        forward_dest = BBMD_Forward_Dest_Default;
+    } else if (size > (UINT32_MAX / 2)) {
+        return false;
+    } else {
+        fdt_table = calloc(size, sizeof(*fdt_table));
+        fdt_index = calloc(size, sizeof(*fdt_index));
+        fdt_hash = calloc(size, sizeof(*fdt_hash));
+        forward_dest =
+            calloc(1 + MAX_BBMD_ENTRIES + size, sizeof(*forward_dest));
+        if (!fdt_table || !fdt_index || !fdt_hash || !forward_dest) {
+            free(fdt_table);
+            free(fdt_index);
+            free(fdt_hash);
+            free(forward_dest);
+            return false;
+        }
+    }
+    if (fdt_table != FD_Table) {
+        for (i = 0; i < FD_Table_Size; i++) {
+            if (FD_Table[i].valid && (count < size)) {
+                fdt_table[count] = FD_Table[i];
+                count++;
+            }
+            FD_Table[i].valid = false;
+        }
+        if (FD_Table != FD_Table_Default) {
+            free(FD_Table);
+            free(FD_Index);
+            free(FD_Hash);
+            free(BBMD_Forward_Dest);
+        }
+        FD_Table = fdt_table;
+        FD_Index = fdt_index;
+        FD_Hash = fdt_hash;
+        BBMD_Forward_Dest = forward_dest;
+        FD_Table_Size = size;
+    }
+    bbmd_fdt_index_rebuild();
+
+    return true;
+}
+
+/**
+ * @brief Get the number of duplicate broadcasts that were dropped
+ *  instead of forwarded again
+ * @return number of duplicate broadcasts
+ */
+uint32_t bvlc_bbmd_duplicate_count(void)
+{
+    return BBMD_Duplicate_Count;
+}
+
 /**
  * @brief Get handle to broadcast distribution table (BDT).
  * @return pointer to first entry of broadcast distribution table
@@ -1470,7 +2003,9 @@ void bvlc_init(void)
     debug_print_string("Initializing (BBMD Enabled).");
     bvlc_broadcast_distribution_table_link_array(
         &BBMD_Table[0], MAX_BBMD_ENTRIES);
-    bvlc_foreign_device_table_link_array(&FD_Table[0], MAX_FD_ENTRIES);
+    bbmd_fdt_refresh();
+    bbmd_fdt_index_rebuild();
+    bbmd_duplicate_clear();
 #else
     debug_print_string("Initializing (BBMD Disabled).");
 #endif
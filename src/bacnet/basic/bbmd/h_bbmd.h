@@ -15,6 +15,7 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/datalink/bvlc.h"
+#include "bacnet/basic/sys/pdubuf.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,6 +56,11 @@ int bvlc_send_pdu(
     const BACNET_NPDU_DATA *npdu_data,
     const uint8_t *pdu,
     unsigned pdu_len);
+BACNET_STACK_EXPORT
+int bvlc_send_pdubuf(
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *npdu_data,
+    PDU_BUFFER *buf);
 
 BACNET_STACK_EXPORT
 uint16_t bvlc_get_last_result(void);
@@ -120,6 +126,14 @@ void bvlc_bdt_list_clear(void);
 
 /* Get foreign device table list */
 BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *bvlc_fdt_list(void);
+/* Get or change the number of foreign device table entries */
+BACNET_STACK_EXPORT
+unsigned bvlc_fdt_size(void);
+BACNET_STACK_EXPORT
+bool bvlc_fdt_size_set(unsigned size);
+/* Get the number of duplicate broadcasts that were dropped */
+BACNET_STACK_EXPORT
+uint32_t bvlc_bbmd_duplicate_count(void);
 
 /* Backup broadcast distribution table to a file.
  * Filename is the BBMD_BACKUP_FILE constant
@@ -13,6 +13,9 @@
 #include "bacnet/datalink/bip6.h"
 #include "bacnet/datalink/bvlc6.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keyhash.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd6/vmac.h"
 #include "bacnet/basic/bbmd6/h_bbmd6.h"
@@ -53,9 +56,6 @@ static BACNET_IP6_ADDRESS Remote_BBMD;
 /** if we are a foreign device, store the Time-To-Live Seconds here */
 static uint16_t Remote_BBMD_TTL_Seconds;
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
-/* local buffer & length for sending */
-static uint8_t BVLC6_Buffer[BIP6_MPDU_MAX];
-static uint16_t BVLC6_Buffer_Len;
 /* Broadcast Distribution Table */
 #ifndef MAX_BBMD6_ENTRIES
 #define MAX_BBMD6_ENTRIES 128
@@ -67,6 +67,14 @@ static BACNET_IP6_BROADCAST_DISTRIBUTION_TABLE_ENTRY
 #define MAX_FD6_ENTRIES 128
 #endif
 static BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY FD_Table[MAX_FD6_ENTRIES];
+/* FDT index by B/IPv6 address - without it, the FDT is searched */
+static OS_Keyhash FD_Index;
+/* destinations for one Forwarded-NPDU: local multicast, BDT, and FDT */
+static BACNET_IP6_ADDRESS
+    BBMD6_Forward_Dest[1 + MAX_BBMD6_ENTRIES + MAX_FD6_ENTRIES];
+#define BBMD6_FORWARD_BROADCAST 0x01
+#define BBMD6_FORWARD_BDT 0x02
+#define BBMD6_FORWARD_FDT 0x04
 #endif
 
 /**
@@ -78,6 +86,128 @@ void bvlc6_debug_enable(void)
     VMAC_Debug_Enable();
 }
 
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+/**
+ * @brief Compute the FDT index hash of a B/IPv6 address
+ * @param addr - B/IPv6 address and port of the foreign device
+ * @return hash of the address
+ */
+static uint32_t bbmd6_fdt_hash(const BACNET_IP6_ADDRESS *addr)
+{
+    uint8_t octets[BIP6_ADDRESS_MAX] = { 0 };
+
+    memcpy(&octets[0], &addr->address[0], IP6_ADDRESS_MAX);
+    encode_unsigned16(&octets[IP6_ADDRESS_MAX], addr->port);
+
+    return Keyhash_FNV1a(&octets[0], sizeof(octets));
+}
+
+/**
+ * @brief Find the FDT entry of a foreign device
+ * @param addr - B/IPv6 address and port of the foreign device
+ * @return index of the entry, or MAX_FD6_ENTRIES if not found
+ */
+static unsigned bbmd6_fdt_entry_find(const BACNET_IP6_ADDRESS *addr)
+{
+    unsigned iterator = 0;
+    unsigned i = 0;
+    KEY key = 0;
+
+    if (FD_Index) {
+        while (Keyhash_Find(FD_Index, bbmd6_fdt_hash(addr), &iterator, &key)) {
+            /* different addresses may have the same hash */
+            if ((key < MAX_FD6_ENTRIES) && FD_Table[key].valid &&
+                !bvlc6_address_different(&FD_Table[key].bip6_address, addr)) {
+                return key;
+            }
+        }
+        return MAX_FD6_ENTRIES;
+    }
+    for (i = 0; i < MAX_FD6_ENTRIES; i++) {
+        if (FD_Table[i].valid &&
+            !bvlc6_address_different(&FD_Table[i].bip6_address, addr)) {
+            return i;
+        }
+    }
+
+    return MAX_FD6_ENTRIES;
+}
+
+/**
+ * @brief Add a foreign device to the FDT, or restart its timer
+ * @param addr - B/IPv6 address and port of the foreign device
+ * @param ttl_seconds - Time-to-Live supplied by the foreign device
+ * @return true if the foreign device is in the FDT
+ */
+static bool
+bbmd6_fdt_entry_register(const BACNET_IP6_ADDRESS *addr, uint16_t ttl_seconds)
+{
+    unsigned index = 0;
+    uint32_t seconds_remaining = 0;
+
+    index = bbmd6_fdt_entry_find(addr);
+    if (index >= MAX_FD6_ENTRIES) {
+        for (index = 0; index < MAX_FD6_ENTRIES; index++) {
+            if (!FD_Table[index].valid) {
+                break;
+            }
+        }
+        if (index >= MAX_FD6_ENTRIES) {
+            return false;
+        }
+        bvlc6_address_copy(&FD_Table[index].bip6_address, addr);
+        FD_Table[index].valid = true;
+        if (FD_Index && !Keyhash_Add(FD_Index, bbmd6_fdt_hash(addr), index)) {
+            /* an incomplete index is worse than none */
+            Keyhash_Delete(FD_Index);
+            FD_Index = NULL;
+        }
+    }
+    FD_Table[index].ttl_seconds = ttl_seconds;
+    /* U.4.5.2: the Time-to-Live plus a grace period of 30 seconds,
+       with a maximum of 65535 */
+    seconds_remaining = (uint32_t)ttl_seconds + 30;
+    if (seconds_remaining > UINT16_MAX) {
+        seconds_remaining = UINT16_MAX;
+    }
+    FD_Table[index].ttl_seconds_remaining = (uint16_t)seconds_remaining;
+
+    return true;
+}
+
+/**
+ * @brief Remove an entry from the FDT
+ * @param index - index of the entry
+ */
+static void bbmd6_fdt_entry_remove(unsigned index)
+{
+    if ((index < MAX_FD6_ENTRIES) && FD_Table[index].valid) {
+        (void)Keyhash_Remove(
+            FD_Index, bbmd6_fdt_hash(&FD_Table[index].bip6_address), index);
+        FD_Table[index].valid = false;
+    }
+}
+
+/**
+ * @brief Determine if a B/IPv6 address is a peer BBMD in the BDT
+ * @param addr - B/IPv6 address and port
+ * @return true if the address is in the BDT
+ */
+static bool bbmd6_bdt_member(const BACNET_IP6_ADDRESS *addr)
+{
+    unsigned i = 0;
+
+    for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
+        if (BBMD_Table[i].valid &&
+            !bvlc6_address_different(&BBMD_Table[i].bip6_address, addr)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
 /** A timer function that is called about once a second.
  *
  * @param seconds - number of elapsed seconds since the last call
@@ -96,7 +226,7 @@ void bvlc6_maintenance_timer(uint16_t seconds)
                     FD_Table[i].ttl_seconds_remaining -= seconds;
                 }
                 if (FD_Table[i].ttl_seconds_remaining == 0) {
-                    FD_Table[i].valid = false;
+                    bbmd6_fdt_entry_remove(i);
                 }
             }
         }
@@ -167,7 +297,6 @@ static void bbmd6_add_vmac(uint32_t device_id, const BACNET_IP6_ADDRESS *addr)
 {
     bool found = false;
     uint32_t list_device_id = 0;
-    struct vmac_data *vmac;
     struct vmac_data new_vmac;
     unsigned i = 0;
 
@@ -192,10 +321,9 @@ static void bbmd6_add_vmac(uint32_t device_id, const BACNET_IP6_ADDRESS *addr)
             }
         }
         if (!found) {
-            vmac = VMAC_Find_By_Key(device_id);
-            if (vmac) {
+            if (VMAC_Delete(device_id)) {
                 /* device ID already exists. Update MAC. */
-                memmove(vmac, &new_vmac, sizeof(struct vmac_data));
+                VMAC_Add(device_id, &new_vmac);
                 PRINTF("BVLC6: VMAC for %u [", (unsigned int)device_id);
                 for (i = 0; i < new_vmac.mac_len; i++) {
                     PRINTF("%02X", new_vmac.mac[i]);
@@ -275,6 +403,103 @@ static bool bbmd6_address_from_bacnet_address(
     return status;
 }
 
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+/**
+ * @brief Send one MPDU to the local multicast domain, the BDT, and the FDT
+ *
+ * The destinations are collected and sent with one call to the port
+ * layer. This BBMD and the originating node are not sent the MPDU.
+ *
+ * @param orig_addr - B/IPv6 address of the originating node
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ * @param destinations - any of BBMD6_FORWARD_BROADCAST, BBMD6_FORWARD_BDT,
+ *  and BBMD6_FORWARD_FDT
+ * @return number of destinations the MPDU was sent to
+ */
+static unsigned bbmd6_send_mpdu_destinations(
+    const BACNET_IP6_ADDRESS *orig_addr,
+    const uint8_t *mtu,
+    uint16_t mtu_len,
+    uint8_t destinations)
+{
+    BACNET_IP6_ADDRESS my_addr = { 0 };
+    const BACNET_IP6_ADDRESS *bip6_dest = NULL;
+    unsigned dest_count = 0;
+    unsigned i = 0; /* loop counter */
+
+    bip6_get_addr(&my_addr);
+    if (destinations & BBMD6_FORWARD_BROADCAST) {
+        bip6_get_broadcast_addr(&BBMD6_Forward_Dest[dest_count]);
+        dest_count++;
+    }
+    if (destinations & BBMD6_FORWARD_BDT) {
+        for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
+            bip6_dest = &BBMD_Table[i].bip6_address;
+            if (BBMD_Table[i].valid &&
+                bvlc6_address_different(&my_addr, bip6_dest) &&
+                bvlc6_address_different(orig_addr, bip6_dest)) {
+                bvlc6_address_copy(&BBMD6_Forward_Dest[dest_count], bip6_dest);
+                dest_count++;
+            }
+        }
+    }
+    if (destinations & BBMD6_FORWARD_FDT) {
+        for (i = 0; i < MAX_FD6_ENTRIES; i++) {
+            bip6_dest = &FD_Table[i].bip6_address;
+            if (FD_Table[i].valid &&
+                bvlc6_address_different(&my_addr, bip6_dest) &&
+                bvlc6_address_different(orig_addr, bip6_dest)) {
+                bvlc6_address_copy(&BBMD6_Forward_Dest[dest_count], bip6_dest);
+                dest_count++;
+            }
+        }
+    }
+    if (dest_count > 0) {
+        (void)bip6_send_mpdu_multiple(
+            &BBMD6_Forward_Dest[0], dest_count, mtu, mtu_len);
+        PERFSTAT_DATALINK_FORWARD(PERFSTAT_DATALINK_BIP6, dest_count);
+    }
+
+    return dest_count;
+}
+
+/**
+ * @brief Send a Forwarded-NPDU to the local multicast domain, the BDT,
+ *  and the FDT
+ *
+ * The Forwarded-NPDU is encoded once, and sent to all of the
+ * destinations with one call to the port layer.
+ *
+ * @param vmac_src - Source-Virtual-Address of the originating node
+ * @param orig_addr - B/IPv6 address of the originating node
+ * @param npdu - the bytes of NPDU+APDU data to send
+ * @param npdu_len - the number of bytes of NPDU+APDU data to send
+ * @param destinations - any of BBMD6_FORWARD_BROADCAST, BBMD6_FORWARD_BDT,
+ *  and BBMD6_FORWARD_FDT
+ * @return number of bytes encoded in the Forwarded-NPDU
+ */
+static uint16_t bbmd6_forward_npdu(
+    uint32_t vmac_src,
+    const BACNET_IP6_ADDRESS *orig_addr,
+    const uint8_t *npdu,
+    uint16_t npdu_len,
+    uint8_t destinations)
+{
+    uint8_t mtu[BIP6_MPDU_MAX] = { 0 };
+    uint16_t mtu_len = 0;
+
+    mtu_len = (uint16_t)bvlc6_encode_forwarded_npdu(
+        &mtu[0], sizeof(mtu), vmac_src, orig_addr, npdu, npdu_len);
+    if (mtu_len > 0) {
+        (void)bbmd6_send_mpdu_destinations(
+            orig_addr, mtu, mtu_len, destinations);
+    }
+
+    return mtu_len;
+}
+#endif
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
@@ -298,6 +523,9 @@ int bvlc6_send_pdu(
     uint16_t mtu_len = 0;
     uint32_t vmac_src = 0;
     uint32_t vmac_dst = 0;
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+    BACNET_IP6_ADDRESS my_addr = { 0 };
+#endif
 
     /* this datalink doesn't need to know the npdu data */
     (void)npdu_data;
@@ -318,6 +546,16 @@ int bvlc6_send_pdu(
             mtu_len = bvlc6_encode_original_broadcast(
                 mtu, sizeof(mtu), vmac_src, pdu, pdu_len);
             PRINTF("BVLC6: Sent Original-Broadcast-NPDU.\n");
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+            /* as a BBMD, our own broadcasts are forwarded to the peer
+               BBMDs and foreign devices */
+            if (mtu_len > 0) {
+                bip6_get_addr(&my_addr);
+                (void)bbmd6_forward_npdu(
+                    vmac_src, &my_addr, pdu, (uint16_t)pdu_len,
+                    BBMD6_FORWARD_BDT | BBMD6_FORWARD_FDT);
+            }
+#endif
         }
     } else if ((dest->net > 0) && (dest->len == 0)) {
         /* net > 0 and net < 65535 are network specific broadcast if len = 0 */
@@ -343,66 +581,12 @@ int bvlc6_send_pdu(
         PRINTF("BVLC6: Send failure. Invalid Address.\n");
         return -1;
     }
+    PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_BIP6);
+    BACTRACE_DATALINK_SEND(PERFSTAT_DATALINK_BIP6, pdu_len);
 
     return bip6_send_mpdu(&bvlc_dest, mtu, mtu_len);
 }
 
-#if defined(BACDL_BIP6) && BBMD6_ENABLED
-/**
- * The send function for Broadcast Distribution Table
- *
- * @param addr - Points to a #BACNET_IP6_ADDRESS structure containing the
- *  source IPv6 address.
- * @param vmac_src - Source-Virtual-Address
- * @param npdu - the bytes of NPDU+APDU data to send
- * @param npdu_len - the number of bytes of NPDU+APDU data to send
- */
-static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
-{
-    BACNET_IP6_ADDRESS my_addr = { 0 };
-    unsigned i = 0; /* loop counter */
-
-    if (mtu) {
-        bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
-            if (BBMD_Table[i].valid) {
-                if (bvlc6_address_different(
-                        &my_addr, &BBMD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&BBMD_Table[i].bip6_address, mtu, mtu_len);
-                }
-            }
-        }
-    }
-}
-
-/**
- * The send function for Broadcast Distribution Table
- *
- * @param addr - Points to a #BACNET_IP6_ADDRESS structure containing the
- *  source IPv6 address.
- * @param vmac_src - Source-Virtual-Address
- * @param npdu - the bytes of NPDU+APDU data to send
- * @param npdu_len - the number of bytes of NPDU+APDU data to send
- */
-static void bbmd6_send_pdu_fdt(uint8_t *mtu, unsigned int mtu_len)
-{
-    BACNET_IP6_ADDRESS my_addr = { 0 };
-    unsigned i = 0; /* loop counter */
-
-    if (mtu) {
-        bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_FD6_ENTRIES; i++) {
-            if (FD_Table[i].valid) {
-                if (bvlc6_address_different(
-                        &my_addr, &FD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&FD_Table[i].bip6_address, mtu, mtu_len);
-                }
-            }
-        }
-    }
-}
-#endif
-
 /**
  * The Result Code send function for BACnet/IPv6 application layer
  *
@@ -600,6 +784,44 @@ static void bbmd6_address_resolution_ack_handler(
     }
 }
 
+/**
+ * Handler for Forwarded-Address-Resolution
+ *
+ * @param addr - BACnet/IPv6 source address any NAK or reply back to.
+ * @param pdu - The received NPDU+APDU buffer.
+ * @param pdu_len - How many bytes in NPDU+APDU buffer.
+ */
+static void bbmd6_forwarded_address_resolution_handler(
+    const BACNET_IP6_ADDRESS *addr, const uint8_t *pdu, uint16_t pdu_len)
+{
+    int function_len = 0;
+    uint32_t vmac_src = 0;
+    uint32_t vmac_target = 0;
+    uint32_t vmac_me = 0;
+    BACNET_IP6_ADDRESS orig_addr = { 0 };
+
+    if (addr && pdu) {
+        PRINTF("BIP6: Received Forwarded-Address-Resolution.\n");
+        if (bbmd6_address_match_self(addr)) {
+            /* ignore messages from my IPv6 address */
+        } else {
+            function_len = bvlc6_decode_forwarded_address_resolution(
+                pdu, pdu_len, &vmac_src, &vmac_target, &orig_addr);
+            if (function_len) {
+                bbmd6_add_vmac(vmac_src, &orig_addr);
+                vmac_me = Device_Object_Instance_Number();
+                if (vmac_target == vmac_me) {
+                    /* The Address-Resolution-ACK message is unicast
+                       to the B/IPv6 node that originally initiated
+                       the Address-Resolution message. */
+                    bvlc6_send_address_resolution_ack(
+                        &orig_addr, vmac_me, vmac_src);
+                }
+            }
+        }
+    }
+}
+
 /**
  * Use this handler when you are not a BBMD.
  * Sets the BVLC6_Function_Code in case it is needed later.
@@ -749,8 +971,7 @@ int bvlc6_bbmd_disabled_handler(
                 }
                 break;
             case BVLC6_FORWARDED_ADDRESS_RESOLUTION:
-                result_code = BVLC6_RESULT_ADDRESS_RESOLUTION_NAK;
-                send_result = true;
+                bbmd6_forwarded_address_resolution_handler(addr, pdu, pdu_len);
                 break;
             case BVLC6_ADDRESS_RESOLUTION:
                 bbmd6_address_resolution_handler(addr, pdu, pdu_len);
@@ -781,7 +1002,45 @@ int bvlc6_bbmd_disabled_handler(
 }
 
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
-#warning FIXME: Needs ported to IPv6
+/**
+ * Forward an Address-Resolution for another node as
+ * Forwarded-Address-Resolution to the peer BBMDs and foreign devices,
+ * and to the local multicast domain when it came from a foreign device.
+ *
+ * @param addr - BACnet/IPv6 source address of the Address-Resolution
+ * @param pdu - The received NPDU+APDU buffer.
+ * @param pdu_len - How many bytes in NPDU+APDU buffer.
+ */
+static void bbmd6_address_resolution_forward(
+    const BACNET_IP6_ADDRESS *addr, const uint8_t *pdu, uint16_t pdu_len)
+{
+    uint8_t mtu[BIP6_MPDU_MAX] = { 0 };
+    uint16_t mtu_len = 0;
+    uint32_t vmac_src = 0;
+    uint32_t vmac_target = 0;
+    uint8_t destinations = BBMD6_FORWARD_BDT | BBMD6_FORWARD_FDT;
+
+    if (bbmd6_address_match_self(addr)) {
+        return;
+    }
+    if (!bvlc6_decode_address_resolution(
+            pdu, pdu_len, &vmac_src, &vmac_target)) {
+        return;
+    }
+    if (vmac_target == Device_Object_Instance_Number()) {
+        return;
+    }
+    if (bbmd6_fdt_entry_find(addr) < MAX_FD6_ENTRIES) {
+        destinations |= BBMD6_FORWARD_BROADCAST;
+    }
+    mtu_len = (uint16_t)bvlc6_encode_forwarded_address_resolution(
+        &mtu[0], sizeof(mtu), vmac_src, vmac_target, addr);
+    if (mtu_len > 0) {
+        (void)bbmd6_send_mpdu_destinations(addr, mtu, mtu_len, destinations);
+        PRINTF("BIP6: Sent Forwarded-Address-Resolution.\n");
+    }
+}
+
 /**
  * Use this handler when you are a BBMD.
  * Sets the BVLC6_Function_Code in case it is needed later.
@@ -812,6 +1071,8 @@ int bvlc6_bbmd_enabled_handler(
     uint16_t npdu_len = 0;
     bool send_result = false;
     uint16_t offset = 0;
+    uint16_t ttl_seconds = 0;
+    unsigned index = 0;
     BACNET_IP6_ADDRESS fwd_address = { 0 };
 
     header_len =
@@ -836,16 +1097,80 @@ int bvlc6_bbmd_enabled_handler(
                 }
                 break;
             case BVLC6_REGISTER_FOREIGN_DEVICE:
-                result_code = BVLC6_RESULT_REGISTER_FOREIGN_DEVICE_NAK;
+                PRINTF("BIP6: Received Register-Foreign-Device.\n");
+                /*  Upon receipt of a BVLL Register-Foreign-Device message,
+                    a BBMD shall start a timer with a value equal to the
+                    Time-to-Live parameter supplied plus a fixed grace
+                    period of 30 seconds. If another BVLL
+                    Register-Foreign-Device message from the same device is
+                    received, the timer shall be reset and restarted. */
+                function_len = bvlc6_decode_register_foreign_device(
+                    pdu, pdu_len, &vmac_src, &ttl_seconds);
+                if (function_len &&
+                    bbmd6_fdt_entry_register(addr, ttl_seconds)) {
+                    bbmd6_add_vmac(vmac_src, addr);
+                    result_code = BVLC6_RESULT_SUCCESSFUL_COMPLETION;
+                } else {
+                    result_code = BVLC6_RESULT_REGISTER_FOREIGN_DEVICE_NAK;
+                }
                 send_result = true;
                 break;
             case BVLC6_DELETE_FOREIGN_DEVICE:
-                result_code = BVLC6_RESULT_DELETE_FOREIGN_DEVICE_NAK;
+                PRINTF("BIP6: Received Delete-Foreign-Device.\n");
+                function_len = bvlc6_decode_delete_foreign_device(
+                    pdu, pdu_len, &vmac_src, &fwd_address);
+                index = MAX_FD6_ENTRIES;
+                if (function_len) {
+                    index = bbmd6_fdt_entry_find(&fwd_address);
+                }
+                if (index < MAX_FD6_ENTRIES) {
+                    bbmd6_fdt_entry_remove(index);
+                    result_code = BVLC6_RESULT_SUCCESSFUL_COMPLETION;
+                } else {
+                    result_code = BVLC6_RESULT_DELETE_FOREIGN_DEVICE_NAK;
+                }
                 send_result = true;
                 break;
             case BVLC6_DISTRIBUTE_BROADCAST_TO_NETWORK:
-                result_code = BVLC6_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK;
-                send_result = true;
+                PRINTF("BIP6: Received Distribute-Broadcast-To-Network.\n");
+                function_len = bvlc6_decode_distribute_broadcast_to_network(
+                    pdu, pdu_len, &vmac_src, NULL, 0, &npdu_len);
+                if ((function_len > 0) &&
+                    (bbmd6_fdt_entry_find(addr) < MAX_FD6_ENTRIES)) {
+                    /*  Upon receipt of a BVLL Distribute-Broadcast-To-Network
+                        message from a registered foreign device, the
+                        receiving BBMD shall transmit a BVLL Forwarded-NPDU
+                        message via multicast to the local multicast domain,
+                        and unicast it to each entry in its BDT and to each
+                        foreign device in its FDT except the originating
+                        node. */
+                    offset = header_len + (function_len - npdu_len);
+                    npdu = &mtu[offset];
+                    (void)bbmd6_forward_npdu(
+                        vmac_src, addr, npdu, npdu_len,
+                        BBMD6_FORWARD_BROADCAST | BBMD6_FORWARD_BDT |
+                            BBMD6_FORWARD_FDT);
+                    bbmd6_add_vmac(vmac_src, addr);
+                    bvlc6_vmac_address_set(src, vmac_src);
+                    /* BTL test: verifies that the IUT will quietly
+                       discard any Confirmed-Request-PDU, whose
+                       destination address is a multicast or
+                       broadcast address, received from the
+                       network layer. */
+                    if (npdu_confirmed_service(npdu, npdu_len)) {
+                        offset = 0;
+                        PRINTF("BIP6: Distribute-Broadcast-To-Network: "
+                               "Confirmed Service! Discard!");
+                    }
+                } else {
+                    /*  If the BBMD is unable to perform the forwarding
+                        function, or the message was not received from a
+                        registered foreign device, it shall return a
+                        BVLC-Result message to the foreign device. */
+                    result_code =
+                        BVLC6_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK;
+                    send_result = true;
+                }
                 break;
             case BVLC6_ORIGINAL_UNICAST_NPDU:
                 /* This message is used to send directed NPDUs to
@@ -877,6 +1202,11 @@ int bvlc6_bbmd_enabled_handler(
                            "registered as a foreign device.\n");
                     break;
                 }
+                if (bbmd6_address_match_self(addr)) {
+                    /* our own broadcasts were forwarded when sent */
+                    PRINTF("BIP6: Ignore Original-Broadcast-NPDU from self!\n");
+                    break;
+                }
                 function_len = bvlc6_decode_original_broadcast(
                     pdu, pdu_len, &vmac_src, NULL, 0, &npdu_len);
                 if (function_len) {
@@ -899,62 +1229,66 @@ int bvlc6_bbmd_enabled_handler(
                             the constructed BVLL Forwarded-NPDU message shall
                             be unicast to each foreign device currently in
                             the BBMD's FDT */
-                        BVLC6_Buffer_Len = bvlc6_encode_forwarded_npdu(
-                            &BVLC6_Buffer[0], sizeof(BVLC6_Buffer), vmac_src,
-                            addr, npdu, npdu_len);
-                        bbmd6_send_pdu_bdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
-                        bbmd6_send_pdu_fdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
-                    }
-                    if (!bbmd6_address_match_self(addr)) {
-                        /* The Virtual MAC address table shall be updated
-                           using the respective parameter values of the
-                           incoming messages. */
-                        bbmd6_add_vmac(vmac_src, addr);
-                        bvlc6_vmac_address_set(src, vmac_src);
+                        (void)bbmd6_forward_npdu(
+                            vmac_src, addr, npdu, npdu_len,
+                            BBMD6_FORWARD_BDT | BBMD6_FORWARD_FDT);
                     }
+                    /* The Virtual MAC address table shall be updated
+                       using the respective parameter values of the
+                       incoming messages. */
+                    bbmd6_add_vmac(vmac_src, addr);
+                    bvlc6_vmac_address_set(src, vmac_src);
                 }
                 break;
             case BVLC6_FORWARDED_NPDU:
                 PRINTF("BIP6: Received Forwarded-NPDU.\n");
                 function_len = bvlc6_decode_forwarded_npdu(
                     pdu, pdu_len, &vmac_src, &fwd_address, NULL, 0, &npdu_len);
-                if (function_len) {
-                    offset = header_len + (function_len - npdu_len);
-                    npdu = &mtu[offset];
+                if (function_len == 0) {
+                    PRINTF("BIP6: Forwarded-NPDU: Unable to decode!\n");
+                    break;
+                }
+                if (bbmd6_address_match_self(addr) ||
+                    bbmd6_address_match_self(&fwd_address)) {
+                    /* ignore messages from my IPv6 address */
+                    PRINTF("BIP6: Forwarded-NPDU is me!\n");
+                    break;
+                }
+                offset = header_len + (function_len - npdu_len);
+                npdu = &mtu[offset];
+                if (bbmd6_bdt_member(addr)) {
                     /*  Upon receipt of a BVLL Forwarded-NPDU message
                         from a BBMD which is in the receiving BBMD's BDT,
                         a BBMD shall construct a BVLL Forwarded-NPDU and
                         transmit it via multicast to B/IPv6 devices in the
-                        local multicast domain. */
-                    BVLC6_Buffer_Len = bvlc6_encode_forwarded_npdu(
-                        &BVLC6_Buffer[0], sizeof(BVLC6_Buffer), vmac_src, addr,
-                        npdu, npdu_len);
-                    bip6_get_broadcast_addr(&bvlc_dest);
-                    bip6_send_mpdu(
-                        &bvlc_dest, &BVLC6_Buffer[0], BVLC6_Buffer_Len);
-                    /*  In addition, the constructed BVLL Forwarded-NPDU
-                        message shall be unicast to each foreign device in
-                        the BBMD's FDT. If the BBMD is unable to transmit
-                        the Forwarded-NPDU, or the message was not received
-                        from a BBMD which is in the receiving BBMD's BDT,
-                        no BVLC-Result shall be returned and the message
-                        shall be discarded. */
-                    bbmd6_send_pdu_fdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
-                    if (!bbmd6_address_match_self(addr)) {
-                        /* The Virtual MAC address table shall be updated
-                           using the respective parameter values of the
-                           incoming messages. */
-                        bbmd6_add_vmac(vmac_src, &fwd_address);
-                        bvlc6_vmac_address_set(src, vmac_src);
-                    }
+                        local multicast domain. In addition, the constructed
+                        BVLL Forwarded-NPDU message shall be unicast to each
+                        foreign device in the BBMD's FDT. */
+                    (void)bbmd6_forward_npdu(
+                        vmac_src, &fwd_address, npdu, npdu_len,
+                        BBMD6_FORWARD_BROADCAST | BBMD6_FORWARD_FDT);
                 }
+                /* The Virtual MAC address table shall be updated
+                   using the respective parameter values of the
+                   incoming messages. */
+                bbmd6_add_vmac(vmac_src, &fwd_address);
+                bvlc6_vmac_address_set(src, vmac_src);
                 break;
             case BVLC6_FORWARDED_ADDRESS_RESOLUTION:
-                result_code = BVLC6_RESULT_ADDRESS_RESOLUTION_NAK;
-                send_result = true;
+                bbmd6_forwarded_address_resolution_handler(addr, pdu, pdu_len);
+                if (bbmd6_bdt_member(addr) &&
+                    bvlc6_decode_forwarded_address_resolution(
+                        pdu, pdu_len, &vmac_src, &vmac_dst, &fwd_address)) {
+                    /* from a peer BBMD: pass it on to the local multicast
+                       domain and to the foreign devices */
+                    (void)bbmd6_send_mpdu_destinations(
+                        &fwd_address, mtu, mtu_len,
+                        BBMD6_FORWARD_BROADCAST | BBMD6_FORWARD_FDT);
+                }
                 break;
             case BVLC6_ADDRESS_RESOLUTION:
                 bbmd6_address_resolution_handler(addr, pdu, pdu_len);
+                bbmd6_address_resolution_forward(addr, pdu, pdu_len);
                 break;
             case BVLC6_ADDRESS_RESOLUTION_ACK:
                 bbmd6_address_resolution_ack_handler(addr, pdu, pdu_len);
@@ -998,6 +1332,8 @@ int bvlc6_handler(
     uint8_t *npdu,
     uint16_t npdu_len)
 {
+    PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_BIP6);
+    BACTRACE_DATALINK_RECEIVE(PERFSTAT_DATALINK_BIP6, npdu_len);
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
     return bvlc6_bbmd_enabled_handler(addr, src, npdu, npdu_len);
 #else
@@ -1080,12 +1416,74 @@ uint8_t bvlc6_get_function_code(void)
     return BVLC6_Function_Code;
 }
 
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+/**
+ * @brief Get the broadcast distribution table (BDT)
+ * @return head of the linked list of BDT entries
+ */
+BACNET_IP6_BROADCAST_DISTRIBUTION_TABLE_ENTRY *bvlc6_bdt_list(void)
+{
+    return &BBMD_Table[0];
+}
+
+/**
+ * @brief Invalidate all entries in the broadcast distribution table (BDT)
+ */
+void bvlc6_bdt_list_clear(void)
+{
+    unsigned i = 0;
+
+    for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
+        BBMD_Table[i].valid = false;
+    }
+}
+
+/**
+ * @brief Add a peer BBMD to the broadcast distribution table (BDT)
+ * @param addr - B/IPv6 address and port of the peer BBMD
+ * @return true if the peer BBMD is in the BDT
+ */
+bool bvlc6_bdt_entry_add(const BACNET_IP6_ADDRESS *addr)
+{
+    unsigned i = 0;
+
+    if (!addr) {
+        return false;
+    }
+    if (bbmd6_bdt_member(addr)) {
+        return true;
+    }
+    for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
+        if (!BBMD_Table[i].valid) {
+            bvlc6_address_copy(&BBMD_Table[i].bip6_address, addr);
+            BBMD_Table[i].valid = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get the foreign device table (FDT)
+ * @return head of the linked list of FDT entries
+ */
+BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *bvlc6_fdt_list(void)
+{
+    return &FD_Table[0];
+}
+#endif
+
 /**
  * Cleanup any memory usage
  */
 void bvlc6_cleanup(void)
 {
     VMAC_Cleanup();
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+    Keyhash_Delete(FD_Index);
+    FD_Index = NULL;
+#endif
 }
 
 /**
@@ -1093,6 +1491,10 @@ void bvlc6_cleanup(void)
  */
 void bvlc6_init(void)
 {
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+    unsigned i = 0;
+#endif
+
     VMAC_Init();
     BVLC6_Result_Code = BVLC6_RESULT_SUCCESSFUL_COMPLETION;
     BVLC6_Function_Code = BVLC6_RESULT;
@@ -1100,6 +1502,14 @@ void bvlc6_init(void)
         &Remote_BBMD, 0, 0, 0, 0, 0, 0, 0, BIP6_MULTICAST_GROUP_ID);
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
     memset(&BBMD_Table, 0, sizeof(BBMD_Table));
+    for (i = 1; i < MAX_BBMD6_ENTRIES; i++) {
+        BBMD_Table[i - 1].next = &BBMD_Table[i];
+    }
     memset(&FD_Table, 0, sizeof(FD_Table));
+    for (i = 1; i < MAX_FD6_ENTRIES; i++) {
+        FD_Table[i - 1].next = &FD_Table[i];
+    }
+    Keyhash_Delete(FD_Index);
+    FD_Index = Keyhash_Create();
 #endif
 }
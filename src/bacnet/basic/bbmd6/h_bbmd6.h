@@ -71,6 +71,15 @@ void bvlc6_maintenance_timer(uint16_t seconds);
 BACNET_STACK_EXPORT
 void bvlc6_debug_enable(void);
 
+BACNET_STACK_EXPORT
+BACNET_IP6_BROADCAST_DISTRIBUTION_TABLE_ENTRY *bvlc6_bdt_list(void);
+BACNET_STACK_EXPORT
+void bvlc6_bdt_list_clear(void);
+BACNET_STACK_EXPORT
+bool bvlc6_bdt_entry_add(const BACNET_IP6_ADDRESS *addr);
+BACNET_STACK_EXPORT
+BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *bvlc6_fdt_list(void);
+
 BACNET_STACK_EXPORT
 void bvlc6_cleanup(void);
 
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keyhash.h"
 #include "bacnet/basic/sys/keylist.h"
 /* me! */
 #include "bacnet/basic/bbmd6/vmac.h"
@@ -35,6 +36,24 @@ void VMAC_Debug_Enable(void)
 
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist VMAC_List;
+/* Index of the Device IDs by a hash of their VMAC address */
+static OS_Keyhash VMAC_Index;
+
+/**
+ * @brief Compute the hash of a VMAC address for the index
+ * @param vmac - VMAC address
+ * @return hash of the VMAC address
+ */
+static uint32_t VMAC_Hash(const struct vmac_data *vmac)
+{
+    size_t mac_len = vmac->mac_len;
+
+    if (mac_len > sizeof(vmac->mac)) {
+        mac_len = sizeof(vmac->mac);
+    }
+
+    return Keyhash_FNV1a(vmac->mac, mac_len);
+}
 
 /**
  * Returns the number of VMAC in the list
@@ -74,11 +93,18 @@ bool VMAC_Add(uint32_t device_id, const struct vmac_data *src)
             pVMAC->mac_len = src->mac_len;
             index = Keylist_Data_Add(VMAC_List, device_id, pVMAC);
             if (index >= 0) {
+                if (!Keyhash_Add(VMAC_Index, VMAC_Hash(pVMAC), device_id)) {
+                    /* without the index, the list is searched */
+                    Keyhash_Delete(VMAC_Index);
+                    VMAC_Index = NULL;
+                }
                 status = true;
                 if (VMAC_Debug) {
                     debug_fprintf(
                         stderr, "VMAC %u added.\n", (unsigned int)device_id);
                 }
+            } else {
+                free(pVMAC);
             }
         }
     }
@@ -100,6 +126,7 @@ bool VMAC_Delete(uint32_t device_id)
 
     pVMAC = Keylist_Data_Delete(VMAC_List, device_id);
     if (pVMAC) {
+        (void)Keyhash_Remove(VMAC_Index, VMAC_Hash(pVMAC), device_id);
         free(pVMAC);
         status = true;
     }
@@ -109,6 +136,8 @@ bool VMAC_Delete(uint32_t device_id)
 
 /**
  * Finds a VMAC in the list by seeking the Device ID.
+ * @note To change the VMAC address of a Device ID, delete and add it
+ *  again, so that the address index follows.
  *
  * @param device_id - BACnet device object instance number
  *
@@ -236,7 +265,26 @@ bool VMAC_Find_By_Data(const struct vmac_data *vmac, uint32_t *device_id)
     struct vmac_data *list_vmac;
     int count = 0;
     int index = 0;
+    unsigned iterator = 0;
+    KEY key = 0;
 
+    if (!vmac) {
+        return false;
+    }
+    if (VMAC_Index) {
+        while (Keyhash_Find(VMAC_Index, VMAC_Hash(vmac), &iterator, &key)) {
+            /* different addresses may have the same hash */
+            list_vmac = Keylist_Data(VMAC_List, key);
+            if (VMAC_Match(vmac, list_vmac)) {
+                if (device_id) {
+                    *device_id = key;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+    /* without the index, the list is searched */
     count = Keylist_Count(VMAC_List);
     while (count) {
         index = count - 1;
@@ -285,6 +333,8 @@ void VMAC_Cleanup(void)
         Keylist_Delete(VMAC_List);
         VMAC_List = NULL;
     }
+    Keyhash_Delete(VMAC_Index);
+    VMAC_Index = NULL;
 }
 
 /**
@@ -293,6 +343,7 @@ void VMAC_Cleanup(void)
 void VMAC_Init(void)
 {
     VMAC_List = Keylist_Create();
+    VMAC_Index = Keyhash_Create();
     if (VMAC_List) {
         atexit(VMAC_Cleanup);
         debug_fprintf(stderr, "VMAC List initialized.\n");
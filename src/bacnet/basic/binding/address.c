@@ -10,6 +10,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -17,6 +18,9 @@
 #include "bacnet/bacdcode.h"
 #include "bacnet/readrange.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/memstat.h"
+#include "bacnet/basic/sys/perfstat.h"
+#include "bacnet/basic/sys/timer_wheel.h"
 
 /* we are likely compiling the demo command line tools if print enabled */
 #if !defined(BACNET_ADDRESS_CACHE_FILE)
@@ -24,6 +28,14 @@
 #define BACNET_ADDRESS_CACHE_FILE
 #endif
 #endif
+/* the learned bindings are saved in a binary file with the text file */
+#if !defined(BACNET_ADDRESS_CACHE_PERSIST)
+#ifdef BACNET_ADDRESS_CACHE_FILE
+#define BACNET_ADDRESS_CACHE_PERSIST 1
+#else
+#define BACNET_ADDRESS_CACHE_PERSIST 0
+#endif
+#endif
 
 /* This module is used to handle the address binding that */
 /* occurs in BACnet.  A device id is bound to a MAC address. */
@@ -40,9 +52,13 @@ static uint32_t Own_Device_ID = 0xFFFFFFFF;
 #if !defined(MAX_ADDRESS_CACHE)
 #define MAX_ADDRESS_CACHE 255
 #endif
+/* number of octets of a Protocol_Services_Supported bit string */
+#define ADDRESS_SERVICES_OCTETS ((MAX_BACNET_SERVICES_SUPPORTED + 7) / 8)
 
 static struct Address_Cache_Entry {
     uint8_t Flags;
+    /* ADDRESS_INDEX flags of the indexes that hold this entry */
+    uint8_t Indexed;
     uint32_t device_id;
     unsigned max_apdu;
 #if BACNET_SEGMENTATION_ENABLED
@@ -50,9 +66,52 @@ static struct Address_Cache_Entry {
     uint16_t maxsegments;
 #endif
     BACNET_ADDRESS address;
-    uint32_t TimeToLive;
+    /* expires the entry when its time to live, in seconds, has passed */
+    struct Timer_Wheel_Entry TimeToLive;
+    /* what the device told about itself in its I-Am */
+    bool iam_known;
+    uint8_t iam_segmentation;
+    uint16_t iam_vendor_id;
+    /* the services whose support is known, and the supported services,
+       from the Protocol_Services_Supported of the device and from the
+       services that the device rejected */
+    uint8_t services_known[ADDRESS_SERVICES_OCTETS];
+    uint8_t services_supported[ADDRESS_SERVICES_OCTETS];
+    /* next entry plus one in the device ID hash chain, or zero */
+    uint16_t device_next;
+    /* next entry plus one in the address hash chain, or zero */
+    uint16_t address_next;
+    /* the next newer and older entries plus one in the LRU list */
+    uint16_t lru_newer;
+    uint16_t lru_older;
 } Address_Cache[MAX_ADDRESS_CACHE];
 
+/* The entries that are in use are found by device ID, and the bound
+   entries by address, using hash chains of entry indexes plus one.
+   The entries that are in use are also kept in the order they were
+   last used, so that the least recently used entry is removed first
+   when the cache is full. */
+static uint16_t Address_Device_Head[MAX_ADDRESS_CACHE];
+static uint16_t Address_Address_Head[MAX_ADDRESS_CACHE];
+static uint16_t Address_LRU_Newest;
+static uint16_t Address_LRU_Oldest;
+/* number of entries that are in use */
+static unsigned Address_In_Use_Count;
+/* there are no free entries below this index */
+static unsigned Address_Free_Index;
+/* the time to live of the entries, in ticks of one second, so that
+   the timer only looks at the entries that expire */
+static TIMER_WHEEL Address_TTL_Wheel;
+#if BACNET_ADDRESS_CACHE_PERSIST
+/* the entries that changed since they were last written to the file */
+static uint8_t Address_Dirty[(MAX_ADDRESS_CACHE + 7) / 8];
+static unsigned Address_Dirty_Count;
+/* the file that address_cache_timer() writes the changed entries to */
+static const char *Address_Persist_Filename;
+static uint32_t Address_Persist_Interval;
+static uint32_t Address_Persist_Elapsed;
+#endif
+
 /* State flags for cache entries */
 
 /* Address cache entry in use */
@@ -73,6 +132,369 @@ static struct Address_Cache_Entry {
 #define BAC_ADDR_SHORT_TIME BAC_ADDR_SECS_1HOUR
 #define BAC_ADDR_FOREVER 0xFFFFFFFF /* Permanent entry */
 
+/* Index flags for cache entries */
+
+/* Entry is in the device ID hash chain and the LRU list */
+#define ADDRESS_INDEX_DEVICE BIT(0)
+/* Entry is in the address hash chain */
+#define ADDRESS_INDEX_ADDRESS BIT(1)
+
+/**
+ * @brief Compute the hash bucket of a device ID
+ * @param device_id - device instance
+ * @return hash bucket 0..MAX_ADDRESS_CACHE-1
+ */
+static unsigned address_device_bucket(uint32_t device_id)
+{
+    /* spread the bits, since device IDs are often assigned in
+       patterns, for example by network and MAC address */
+    device_id ^= device_id >> 16;
+    device_id *= 0x85ebca6bUL;
+    device_id ^= device_id >> 13;
+    device_id *= 0xc2b2ae35UL;
+    device_id ^= device_id >> 16;
+
+    return (unsigned)(device_id % MAX_ADDRESS_CACHE);
+}
+
+/**
+ * @brief Compute the hash bucket of an address
+ * @param address - BACnet address
+ * @return hash bucket 0..MAX_ADDRESS_CACHE-1
+ */
+static unsigned address_address_bucket(const BACNET_ADDRESS *address)
+{
+    return (unsigned)(bacnet_address_hash(address) % MAX_ADDRESS_CACHE);
+}
+
+/**
+ * @brief Remove an entry from a hash chain
+ * @param link - head of the hash chain
+ * @param index - index of the entry
+ * @param device - true for the device ID chain, false for the address chain
+ */
+static void address_chain_remove(uint16_t *link, unsigned index, bool device)
+{
+    struct Address_Cache_Entry *pEntry;
+
+    while (*link) {
+        pEntry = &Address_Cache[*link - 1];
+        if (*link == (index + 1)) {
+            *link = device ? pEntry->device_next : pEntry->address_next;
+            break;
+        }
+        link = device ? &pEntry->device_next : &pEntry->address_next;
+    }
+}
+
+/**
+ * @brief Remove an entry from the LRU list
+ * @param index - index of the entry
+ */
+static void address_lru_remove(unsigned index)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+
+    if (pMatch->lru_newer) {
+        Address_Cache[pMatch->lru_newer - 1].lru_older = pMatch->lru_older;
+    } else {
+        Address_LRU_Newest = pMatch->lru_older;
+    }
+    if (pMatch->lru_older) {
+        Address_Cache[pMatch->lru_older - 1].lru_newer = pMatch->lru_newer;
+    } else {
+        Address_LRU_Oldest = pMatch->lru_newer;
+    }
+    pMatch->lru_newer = 0;
+    pMatch->lru_older = 0;
+}
+
+/**
+ * @brief Add an entry to the LRU list as the most recently used
+ * @param index - index of the entry
+ */
+static void address_lru_add(unsigned index)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+
+    pMatch->lru_newer = 0;
+    pMatch->lru_older = Address_LRU_Newest;
+    if (Address_LRU_Newest) {
+        Address_Cache[Address_LRU_Newest - 1].lru_newer = (uint16_t)(index + 1);
+    } else {
+        Address_LRU_Oldest = (uint16_t)(index + 1);
+    }
+    Address_LRU_Newest = (uint16_t)(index + 1);
+}
+
+/**
+ * @brief Mark an entry as changed, to be written to the file
+ * @param index - index of the entry
+ */
+static void address_entry_dirty(unsigned index)
+{
+#if BACNET_ADDRESS_CACHE_PERSIST
+    uint8_t mask = (uint8_t)BIT(index & 7);
+
+    if ((Address_Dirty[index / 8] & mask) == 0) {
+        Address_Dirty[index / 8] |= mask;
+        Address_Dirty_Count++;
+    }
+#else
+    (void)index;
+#endif
+}
+
+/**
+ * @brief Mark all entries as changed, after the cache is initialized
+ */
+static void address_dirty_all(void)
+{
+#if BACNET_ADDRESS_CACHE_PERSIST
+    memset(Address_Dirty, 0xFF, sizeof(Address_Dirty));
+    Address_Dirty_Count = MAX_ADDRESS_CACHE;
+#endif
+}
+
+/**
+ * @brief Mark an entry as the most recently used
+ * @param index - index of the entry
+ */
+static void address_entry_used(unsigned index)
+{
+    if ((Address_Cache[index].Indexed & ADDRESS_INDEX_DEVICE) &&
+        (Address_LRU_Newest != (index + 1))) {
+        address_lru_remove(index);
+        address_lru_add(index);
+    }
+}
+
+/**
+ * @brief Remove an entry from the indexes. Called before changing
+ *  the flags, device ID or address of an entry.
+ * @param index - index of the entry
+ */
+static void address_entry_unlink(unsigned index)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+
+    address_entry_dirty(index);
+    if (pMatch->Indexed & ADDRESS_INDEX_DEVICE) {
+        address_chain_remove(
+            &Address_Device_Head[address_device_bucket(pMatch->device_id)],
+            index, true);
+        address_lru_remove(index);
+        Address_In_Use_Count--;
+    }
+    if (pMatch->Indexed & ADDRESS_INDEX_ADDRESS) {
+        address_chain_remove(
+            &Address_Address_Head[address_address_bucket(&pMatch->address)],
+            index, false);
+    }
+    pMatch->Indexed = 0;
+}
+
+/**
+ * @brief Add an entry to the indexes that match its flags, as the
+ *  most recently used. Called after changing the flags, device ID
+ *  or address of an entry.
+ * @param index - index of the entry
+ */
+static void address_entry_link(unsigned index)
+{
+    struct Address_Cache_Entry *pMatch = &Address_Cache[index];
+    unsigned bucket;
+
+    if (pMatch->Indexed || ((pMatch->Flags & BAC_ADDR_IN_USE) == 0)) {
+        return;
+    }
+    address_entry_dirty(index);
+    bucket = address_device_bucket(pMatch->device_id);
+    pMatch->device_next = Address_Device_Head[bucket];
+    Address_Device_Head[bucket] = (uint16_t)(index + 1);
+    address_lru_add(index);
+    Address_In_Use_Count++;
+    pMatch->Indexed = ADDRESS_INDEX_DEVICE;
+    if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+        bucket = address_address_bucket(&pMatch->address);
+        pMatch->address_next = Address_Address_Head[bucket];
+        Address_Address_Head[bucket] = (uint16_t)(index + 1);
+        pMatch->Indexed |= ADDRESS_INDEX_ADDRESS;
+    }
+}
+
+/**
+ * @brief Free an entry
+ * @param index - index of the entry
+ */
+static void address_entry_free(unsigned index)
+{
+    address_entry_unlink(index);
+    (void)Timer_Wheel_Cancel(
+        &Address_TTL_Wheel, &Address_Cache[index].TimeToLive);
+    Address_Cache[index].Flags = 0;
+    if (index < Address_Free_Index) {
+        Address_Free_Index = index;
+    }
+}
+
+/**
+ * @brief Free an entry when its time to live has passed
+ * @param entry - the time to live timer of the entry
+ * @param context - the entry
+ */
+static void
+address_entry_expired(struct Timer_Wheel_Entry *entry, void *context)
+{
+    struct Address_Cache_Entry *pMatch = context;
+
+    (void)entry;
+    /* entries holding a slot, except statics */
+    if (((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) != 0) &&
+        ((pMatch->Flags & BAC_ADDR_STATIC) == 0)) {
+        address_entry_free((unsigned)(pMatch - Address_Cache));
+    }
+}
+
+/**
+ * @brief Set the time to live of an entry
+ * @param pMatch - entry
+ * @param ttl - seconds until the entry expires, or BAC_ADDR_FOREVER
+ */
+static void
+address_entry_ttl_set(struct Address_Cache_Entry *pMatch, uint32_t ttl)
+{
+    if (!Timer_Wheel_Pending(&pMatch->TimeToLive)) {
+        /* the cache may be used before it is initialized */
+        Timer_Wheel_Entry_Init(
+            &pMatch->TimeToLive, address_entry_expired, pMatch);
+    }
+    if (ttl == BAC_ADDR_FOREVER) {
+        (void)Timer_Wheel_Cancel(&Address_TTL_Wheel, &pMatch->TimeToLive);
+    } else {
+        /* the entry is freed once more than ttl seconds have passed */
+        if (ttl >= TIMER_WHEEL_TICKS_MAX) {
+            ttl = TIMER_WHEEL_TICKS_MAX - 1;
+        }
+        Timer_Wheel_Add(&Address_TTL_Wheel, &pMatch->TimeToLive, ttl + 1);
+    }
+}
+
+/**
+ * @brief Get the time to live of an entry
+ * @param pMatch - entry
+ * @return seconds until the entry expires, or BAC_ADDR_FOREVER
+ */
+static uint32_t address_entry_ttl(const struct Address_Cache_Entry *pMatch)
+{
+    if (Timer_Wheel_Pending(&pMatch->TimeToLive)) {
+        return Timer_Wheel_Remaining(
+                   &Address_TTL_Wheel, &pMatch->TimeToLive) -
+            1;
+    }
+
+    return BAC_ADDR_FOREVER;
+}
+
+/**
+ * @brief Find the entry that is in use for a device ID
+ * @param device_id - device instance
+ * @return index of the entry, or MAX_ADDRESS_CACHE if not found
+ */
+static unsigned address_entry_find(uint32_t device_id)
+{
+    struct Address_Cache_Entry *pMatch;
+    uint16_t next;
+
+    next = Address_Device_Head[address_device_bucket(device_id)];
+    while (next) {
+        pMatch = &Address_Cache[next - 1];
+        if (pMatch->device_id == device_id) {
+            return next - 1;
+        }
+        next = pMatch->device_next;
+    }
+
+    return MAX_ADDRESS_CACHE;
+}
+
+/**
+ * @brief Find the first bound entry with an address
+ * @param src - BACnet address
+ * @return index of the entry, or MAX_ADDRESS_CACHE if not found
+ */
+static unsigned address_entry_find_address(const BACNET_ADDRESS *src)
+{
+    unsigned index = MAX_ADDRESS_CACHE;
+    uint16_t next;
+
+    next = Address_Address_Head[address_address_bucket(src)];
+    while (next) {
+        /* several devices may share an address, so use the first one
+           in the table like a search from the start would */
+        if (((next - 1U) < index) &&
+            bacnet_address_same(&Address_Cache[next - 1].address, src)) {
+            index = next - 1;
+        }
+        next = Address_Cache[next - 1].address_next;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Forget what is known of the device of an entry, for a new device
+ * @param pMatch - the entry
+ */
+static void address_entry_capability_clear(struct Address_Cache_Entry *pMatch)
+{
+    pMatch->iam_known = false;
+    memset(pMatch->services_known, 0, sizeof(pMatch->services_known));
+}
+
+/**
+ * @brief Find the first free entry
+ * @return index of the entry, or MAX_ADDRESS_CACHE if none are free
+ */
+static unsigned address_entry_find_free(void)
+{
+    unsigned index;
+
+    if (Address_In_Use_Count >= MAX_ADDRESS_CACHE) {
+        return MAX_ADDRESS_CACHE;
+    }
+    for (index = Address_Free_Index; index < MAX_ADDRESS_CACHE; index++) {
+        if ((Address_Cache[index].Flags &
+             (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) == 0) {
+            Address_Free_Index = index;
+            break;
+        }
+    }
+
+    return index;
+}
+
+/**
+ * @brief Rebuild the indexes from the entries that are in use
+ */
+static void address_index_rebuild(void)
+{
+    unsigned index;
+
+    Address_LRU_Newest = 0;
+    Address_LRU_Oldest = 0;
+    Address_In_Use_Count = 0;
+    Address_Free_Index = 0;
+    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+        Address_Device_Head[index] = 0;
+        Address_Address_Head[index] = 0;
+        Address_Cache[index].Indexed = 0;
+    }
+    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+        address_entry_link(index);
+    }
+}
+
 /**
  * @brief Set the index of the first (top) address being protected.
  *
@@ -102,18 +524,13 @@ void address_own_device_id_set(uint32_t own_id)
  */
 void address_remove_device(uint32_t device_id)
 {
-    struct Address_Cache_Entry *pMatch;
-    uint32_t index = 0;
+    unsigned index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            pMatch->Flags = 0;
-            if (index < Top_Protected_Entry) {
-                Top_Protected_Entry--;
-            }
-            break;
+    index = address_entry_find(device_id);
+    if (index < MAX_ADDRESS_CACHE) {
+        address_entry_free(index);
+        if (index < Top_Protected_Entry) {
+            Top_Protected_Entry--;
         }
     }
 
@@ -121,72 +538,63 @@ void address_remove_device(uint32_t device_id)
 }
 
 /**
- * @brief Search the cache for the entry nearest expiry and delete it. Mark the
- * entry as reserved with a 1 hour TTL and return a pointer to the reserved
- * entry. Will not delete a static entry and returns NULL pointer if no
- * entry available to free up. Does not check for free entries as it is
- * assumed we are calling this due to the lack of those.
+ * @brief Search the cache for the least recently used entry and delete it.
+ * Mark the entry as reserved with a 1 hour TTL and return the index of the
+ * reserved entry. Will not delete a static entry and returns
+ * MAX_ADDRESS_CACHE if no entry available to free up. Does not check for
+ * free entries as it is assumed we are calling this due to the lack of those.
  *
- * @return Pointer to the entry that has been removed or NULL.
+ * @return Index of the entry that has been removed or MAX_ADDRESS_CACHE.
  */
-static struct Address_Cache_Entry *address_remove_oldest(void)
+static unsigned address_remove_oldest(void)
 {
     struct Address_Cache_Entry *pMatch;
-    struct Address_Cache_Entry *pCandidate;
-    uint32_t ulTime;
-    unsigned index;
+    unsigned candidate = MAX_ADDRESS_CACHE;
+    uint16_t next;
 
-    pCandidate = NULL;
     if (Top_Protected_Entry > (MAX_ADDRESS_CACHE - 1)) {
-        return pCandidate;
+        return candidate;
     }
-    /* Longest possible non static time to live */
-    ulTime = BAC_ADDR_FOREVER - 1;
 
     /* First pass - try only in use and bound entries */
-
-    for (index = Top_Protected_Entry; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags &
-             (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
-            BAC_ADDR_IN_USE) {
-            if (pMatch->TimeToLive <= ulTime) {
-                /* Shorter lived entry found */
-                ulTime = pMatch->TimeToLive;
-                pCandidate = pMatch;
-            }
+    next = Address_LRU_Oldest;
+    while (next) {
+        pMatch = &Address_Cache[next - 1];
+        if (((next - 1U) >= Top_Protected_Entry) &&
+            ((pMatch->Flags &
+              (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
+             BAC_ADDR_IN_USE)) {
+            candidate = next - 1;
+            break;
         }
-    }
-
-    if (pCandidate != NULL) {
-        /* Found something to free up */
-        pCandidate->Flags = BAC_ADDR_RESERVED;
-        /* only reserve it for a short while */
-        pCandidate->TimeToLive = BAC_ADDR_SHORT_TIME;
-        return (pCandidate);
+        next = pMatch->lru_newer;
     }
 
     /* Second pass - try in use and un bound as last resort */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags &
-             (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
-            ((uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ))) {
-            if (pMatch->TimeToLive <= ulTime) { /* Shorter lived entry found */
-                ulTime = pMatch->TimeToLive;
-                pCandidate = pMatch;
+    if (candidate >= MAX_ADDRESS_CACHE) {
+        next = Address_LRU_Oldest;
+        while (next) {
+            pMatch = &Address_Cache[next - 1];
+            if ((pMatch->Flags &
+                 (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
+                ((uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ))) {
+                candidate = next - 1;
+                break;
             }
+            next = pMatch->lru_newer;
         }
     }
 
-    if (pCandidate != NULL) {
+    if (candidate < MAX_ADDRESS_CACHE) {
         /* Found something to free up */
-        pCandidate->Flags = BAC_ADDR_RESERVED;
+        address_entry_unlink(candidate);
+        pMatch = &Address_Cache[candidate];
+        pMatch->Flags = BAC_ADDR_RESERVED;
         /* only reserve it for a short while */
-        pCandidate->TimeToLive = BAC_ADDR_SHORT_TIME;
+        address_entry_ttl_set(pMatch, BAC_ADDR_SHORT_TIME);
     }
 
-    return (pCandidate);
+    return candidate;
 }
 
 #ifdef BACNET_ADDRESS_CACHE_FILE
@@ -261,11 +669,17 @@ void address_init(void)
     struct Address_Cache_Entry *pMatch;
     unsigned index;
 
+    MEMSTAT_FIXED(MEMSTAT_ADDRESS, Address_Cache, sizeof(Address_Cache));
     Top_Protected_Entry = 0;
+    Timer_Wheel_Init(&Address_TTL_Wheel);
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
         pMatch = &Address_Cache[index];
         pMatch->Flags = 0;
+        Timer_Wheel_Entry_Init(
+            &pMatch->TimeToLive, address_entry_expired, pMatch);
     }
+    address_index_rebuild();
+    address_dirty_all();
 #ifdef BACNET_ADDRESS_CACHE_FILE
     address_file_init(Address_Cache_Filename);
 #endif
@@ -283,13 +697,23 @@ void address_init_partial(void)
 {
     struct Address_Cache_Entry *pMatch;
     unsigned index;
+    uint32_t now, ttl;
 
+    /* the timer links may not have survived either, so keep only
+       the deadlines and put the entries back into the timer wheel */
+    now = Timer_Wheel_Now(&Address_TTL_Wheel);
+    Timer_Wheel_Init(&Address_TTL_Wheel);
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
         pMatch = &Address_Cache[index];
+        ttl = BAC_ADDR_FOREVER;
+        if (pMatch->TimeToLive.pending) {
+            ttl = pMatch->TimeToLive.expires - now - 1;
+        }
+        Timer_Wheel_Entry_Init(
+            &pMatch->TimeToLive, address_entry_expired, pMatch);
         if ((pMatch->Flags & BAC_ADDR_IN_USE) != 0) {
             /* It's in use so let's check further */
-            if (((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) ||
-                (pMatch->TimeToLive == 0)) {
+            if (((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) || (ttl == 0)) {
                 pMatch->Flags = 0;
             }
         }
@@ -298,7 +722,13 @@ void address_init_partial(void)
             /* Reserved entries should be cleared */
             pMatch->Flags = 0;
         }
+        if (pMatch->Flags != 0) {
+            address_entry_ttl_set(pMatch, ttl);
+        }
     }
+    /* the indexes may not have survived with the cache entries */
+    address_index_rebuild();
+    address_dirty_all();
 #ifdef BACNET_ADDRESS_CACHE_FILE
     address_file_init(Address_Cache_Filename);
 #endif
@@ -322,24 +752,22 @@ void address_set_device_TTL(
     struct Address_Cache_Entry *pMatch;
     unsigned index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+    index = address_entry_find(device_id);
+    if (index < MAX_ADDRESS_CACHE) {
         pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* If bound then we have either static or normaal */
-                if (StaticFlag) {
-                    pMatch->Flags |= BAC_ADDR_STATIC;
-                    pMatch->TimeToLive = BAC_ADDR_FOREVER;
-                } else {
-                    pMatch->Flags &= ~BAC_ADDR_STATIC;
-                    pMatch->TimeToLive = TimeOut;
-                }
+        address_entry_dirty(index);
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+            /* If bound then we have either static or normaal */
+            if (StaticFlag) {
+                pMatch->Flags |= BAC_ADDR_STATIC;
+                address_entry_ttl_set(pMatch, BAC_ADDR_FOREVER);
             } else {
-                /* For unbound we can only set the time to live */
-                pMatch->TimeToLive = TimeOut;
+                pMatch->Flags &= ~BAC_ADDR_STATIC;
+                address_entry_ttl_set(pMatch, TimeOut);
             }
-            break; /* Exit now if found at all - bound or unbound */
+        } else {
+            /* For unbound we can only set the time to live */
+            address_entry_ttl_set(pMatch, TimeOut);
         }
     }
 }
@@ -365,35 +793,32 @@ bool address_segment_get_by_device(
     bool found = false; /* return value */
     unsigned index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+    index = address_entry_find(device_id);
+    if (index < MAX_ADDRESS_CACHE) {
         pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* If bound then fetch data */
-                bacnet_address_copy(src, &pMatch->address);
-                if (max_apdu) {
-                    *max_apdu = pMatch->max_apdu;
-                }
-                if (segmentation) {
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+            /* If bound then fetch data */
+            bacnet_address_copy(src, &pMatch->address);
+            if (max_apdu) {
+                *max_apdu = pMatch->max_apdu;
+            }
+            if (segmentation) {
 #if BACNET_SEGMENTATION_ENABLED
-                    *segmentation = pMatch->segmentation;
+                *segmentation = pMatch->segmentation;
 #else
-                    *segmentation = SEGMENTATION_NONE;
+                *segmentation = SEGMENTATION_NONE;
 #endif
-                }
-                if (maxsegments) {
+            }
+            if (maxsegments) {
 #if BACNET_SEGMENTATION_ENABLED
-                    *maxsegments = pMatch->maxsegments;
+                *maxsegments = pMatch->maxsegments;
 #else
-                    *maxsegments = 1;
+                *maxsegments = 1;
 #endif
-                }
-                /* Prove we found it */
-                found = true;
             }
-            /* Exit now if found at all - bound or unbound */
-            break;
+            address_entry_used(index);
+            /* Prove we found it */
+            found = true;
         }
     }
 
@@ -422,23 +847,20 @@ bool address_get_by_device(
  */
 bool address_get_device_id(const BACNET_ADDRESS *src, uint32_t *device_id)
 {
-    struct Address_Cache_Entry *pMatch;
     bool found = false; /* return value */
     unsigned index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
-            BAC_ADDR_IN_USE) {
-            /* If bound */
-            if (bacnet_address_same(&pMatch->address, src)) {
-                if (device_id) {
-                    *device_id = pMatch->device_id;
-                }
-                found = true;
-                break;
-            }
+    if (!src) {
+        return false;
+    }
+    /* If bound */
+    index = address_entry_find_address(src);
+    if (index < MAX_ADDRESS_CACHE) {
+        if (device_id) {
+            *device_id = Address_Cache[index].device_id;
         }
+        address_entry_used(index);
+        found = true;
     }
 
     return found;
@@ -469,60 +891,50 @@ void address_add(
        bind request if it exists */
 
     /* existing device or bind request outstanding - update address */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+    index = address_entry_find(device_id);
+    if (index < MAX_ADDRESS_CACHE) {
         /* Device already in the list, then update the values. */
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            bacnet_address_copy(&pMatch->address, src);
-            pMatch->max_apdu = max_apdu;
-            /* Pick the right time to live */
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) {
-                /* Bind requested so long time */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            } else if ((pMatch->Flags & BAC_ADDR_STATIC) != 0) {
-                /* Static already so make sure it never expires */
-                pMatch->TimeToLive = BAC_ADDR_FOREVER;
-            } else if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
-                /* Opportunistic entry so leave on short fuse */
-                pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-            } else {
-                /* Renewing existing entry */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            }
-            /* Clear bind request flag just in case */
-            pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
-            found = true;
-            break;
+        pMatch = &Address_Cache[index];
+        address_entry_unlink(index);
+        bacnet_address_copy(&pMatch->address, src);
+        pMatch->max_apdu = max_apdu;
+        /* Pick the right time to live */
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) {
+            /* Bind requested so long time */
+            address_entry_ttl_set(pMatch, BAC_ADDR_LONG_TIME);
+        } else if ((pMatch->Flags & BAC_ADDR_STATIC) != 0) {
+            /* Static already so make sure it never expires */
+            address_entry_ttl_set(pMatch, BAC_ADDR_FOREVER);
+        } else if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
+            /* Opportunistic entry so leave on short fuse */
+            address_entry_ttl_set(pMatch, BAC_ADDR_SHORT_TIME);
+        } else {
+            /* Renewing existing entry */
+            address_entry_ttl_set(pMatch, BAC_ADDR_LONG_TIME);
         }
+        /* Clear bind request flag just in case */
+        pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
+        address_entry_link(index);
+        found = true;
     }
     /* New device - add to cache if there is room. */
     if (!found) {
-        for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-            pMatch = &Address_Cache[index];
-            if ((pMatch->Flags & BAC_ADDR_IN_USE) == 0) {
-                pMatch->Flags = BAC_ADDR_IN_USE;
-                pMatch->device_id = device_id;
-                pMatch->max_apdu = max_apdu;
-                bacnet_address_copy(&pMatch->address, src);
-                /* Opportunistic entry so leave on short fuse */
-                pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-                found = true;
-                break;
-            }
+        index = address_entry_find_free();
+        /* If adding has failed, see if we can squeeze it in by removed the
+         * oldest entry. */
+        if (index >= MAX_ADDRESS_CACHE) {
+            index = address_remove_oldest();
         }
-    }
-    /* If adding has failed, see if we can squeeze it in by removed the oldest
-     * entry. */
-    if (!found) {
-        pMatch = address_remove_oldest();
-        if (pMatch != NULL) {
+        if (index < MAX_ADDRESS_CACHE) {
+            pMatch = &Address_Cache[index];
             pMatch->Flags = BAC_ADDR_IN_USE;
             pMatch->device_id = device_id;
+            address_entry_capability_clear(pMatch);
             pMatch->max_apdu = max_apdu;
             bacnet_address_copy(&pMatch->address, src);
             /* Opportunistic entry so leave on short fuse */
-            pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+            address_entry_ttl_set(pMatch, BAC_ADDR_SHORT_TIME);
+            address_entry_link(index);
         }
     }
     return;
@@ -552,58 +964,55 @@ bool address_device_bind_request(
     unsigned index;
 
     /* existing device - update address info if currently bound */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+    index = address_entry_find(device_id);
+    if (index < MAX_ADDRESS_CACHE) {
         pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* Already bound */
-                found = true;
-                if (src) {
-                    bacnet_address_copy(src, &pMatch->address);
-                }
-                if (max_apdu) {
-                    *max_apdu = pMatch->max_apdu;
-                }
-                if (device_ttl) {
-                    *device_ttl = pMatch->TimeToLive;
-                }
-                if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
-                    /* Was picked up opportunistacilly */
-                    /* Convert to normal entry  */
-                    pMatch->Flags &= ~BAC_ADDR_SHORT_TTL;
-                    /* And give it a decent time to live */
-                    pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-                }
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+            /* Already bound */
+            found = true;
+            if (src) {
+                bacnet_address_copy(src, &pMatch->address);
             }
-            /* True if bound, false if bind request outstanding */
-            return (found);
+            if (max_apdu) {
+                *max_apdu = pMatch->max_apdu;
+            }
+            if (device_ttl) {
+                *device_ttl = address_entry_ttl(pMatch);
+            }
+            if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
+                /* Was picked up opportunistacilly */
+                /* Convert to normal entry  */
+                pMatch->Flags &= ~BAC_ADDR_SHORT_TTL;
+                /* And give it a decent time to live */
+                address_entry_ttl_set(pMatch, BAC_ADDR_LONG_TIME);
+            }
+            address_entry_used(index);
+            PERFSTAT_COUNT(PERFSTAT_ADDRESS_CACHE_HITS);
+        } else {
+            PERFSTAT_COUNT(PERFSTAT_ADDRESS_CACHE_MISSES);
         }
+        /* True if bound, false if bind request outstanding */
+        return (found);
     }
+    PERFSTAT_COUNT(PERFSTAT_ADDRESS_CACHE_MISSES);
 
     /* Not there already so look for a free entry to put it in */
-    /* existing device - update address info if currently bound */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) == 0) {
-            /* In use and awaiting binding */
-            pMatch->Flags = (uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ);
-            pMatch->device_id = device_id;
-            /* No point in leaving bind requests in for long haul */
-            pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-            /* now would be a good time to do a Who-Is request */
-            return (false);
-        }
-    }
-
+    index = address_entry_find_free();
     /* No free entries, See if we can squeeze it in by dropping an existing one
      */
-    pMatch = address_remove_oldest();
-    if (pMatch != NULL) {
+    if (index >= MAX_ADDRESS_CACHE) {
+        index = address_remove_oldest();
+    }
+    if (index < MAX_ADDRESS_CACHE) {
+        /* In use and awaiting binding */
+        pMatch = &Address_Cache[index];
         pMatch->Flags = (uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ);
         pMatch->device_id = device_id;
+        address_entry_capability_clear(pMatch);
         /* No point in leaving bind requests in for long haul */
-        pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+        address_entry_ttl_set(pMatch, BAC_ADDR_SHORT_TIME);
+        address_entry_link(index);
+        /* now would be a good time to do a Who-Is request */
     }
     return (false);
 }
@@ -640,25 +1049,183 @@ void address_add_binding(
     unsigned index;
 
     /* existing device or bind request - update address */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+    index = address_entry_find(device_id);
+    if (index < MAX_ADDRESS_CACHE) {
         pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            bacnet_address_copy(&pMatch->address, src);
-            pMatch->max_apdu = max_apdu;
-            /* Clear bind request flag in case it was set */
-            pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
-            /* Only update TTL if not static */
-            if ((pMatch->Flags & BAC_ADDR_STATIC) == 0) {
-                /* and set it on a long fuse */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            }
-            break;
+        address_entry_unlink(index);
+        bacnet_address_copy(&pMatch->address, src);
+        pMatch->max_apdu = max_apdu;
+        /* Clear bind request flag in case it was set */
+        pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
+        /* Only update TTL if not static */
+        if ((pMatch->Flags & BAC_ADDR_STATIC) == 0) {
+            /* and set it on a long fuse */
+            address_entry_ttl_set(pMatch, BAC_ADDR_LONG_TIME);
         }
+        address_entry_link(index);
     }
     return;
 }
 
+/**
+ * @brief Store what a device told about itself in its I-Am
+ * @param device_id - device instance
+ * @param segmentation - BACNET_SEGMENTATION of the device
+ * @param vendor_id - vendor identifier of the device
+ * @return true if the device is in the cache
+ */
+bool address_device_iam_set(
+    uint32_t device_id, int segmentation, uint16_t vendor_id)
+{
+    struct Address_Cache_Entry *pMatch;
+    unsigned index;
+
+    index = address_entry_find(device_id);
+    if (index >= MAX_ADDRESS_CACHE) {
+        return false;
+    }
+    pMatch = &Address_Cache[index];
+    address_entry_dirty(index);
+    pMatch->iam_known = true;
+    pMatch->iam_segmentation = (uint8_t)segmentation;
+    pMatch->iam_vendor_id = vendor_id;
+
+    return true;
+}
+
+/**
+ * @brief Get what a device told about itself in its I-Am
+ * @param device_id - device instance
+ * @param segmentation - pointer to a variable taking the BACNET_SEGMENTATION
+ *  of the device, or NULL
+ * @param vendor_id - pointer to a variable taking the vendor identifier of
+ *  the device, or NULL
+ * @return true if an I-Am of the device was stored
+ */
+bool address_device_iam(
+    uint32_t device_id, int *segmentation, uint16_t *vendor_id)
+{
+    const struct Address_Cache_Entry *pMatch;
+    unsigned index;
+
+    index = address_entry_find(device_id);
+    if (index >= MAX_ADDRESS_CACHE) {
+        return false;
+    }
+    pMatch = &Address_Cache[index];
+    if (!pMatch->iam_known) {
+        return false;
+    }
+    if (segmentation) {
+        *segmentation = pMatch->iam_segmentation;
+    }
+    if (vendor_id) {
+        *vendor_id = pMatch->iam_vendor_id;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Store whether a device supports a service in an entry
+ * @param pMatch - the entry
+ * @param service - BACNET_SERVICES_SUPPORTED of the service
+ * @param supported - true if the device supports the service
+ */
+static void address_entry_service_set(
+    struct Address_Cache_Entry *pMatch, unsigned service, bool supported)
+{
+    uint8_t mask = (uint8_t)(1 << (service % 8));
+
+    pMatch->services_known[service / 8] |= mask;
+    if (supported) {
+        pMatch->services_supported[service / 8] |= mask;
+    } else {
+        pMatch->services_supported[service / 8] &= (uint8_t)~mask;
+    }
+}
+
+/**
+ * @brief Store the Protocol_Services_Supported of a device
+ * @param device_id - device instance
+ * @param services - the Protocol_Services_Supported bit string
+ * @return true if the device is in the cache
+ */
+bool address_device_services_set(
+    uint32_t device_id, const BACNET_BIT_STRING *services)
+{
+    unsigned index, service;
+
+    index = address_entry_find(device_id);
+    if (index >= MAX_ADDRESS_CACHE) {
+        return false;
+    }
+    for (service = 0; (service < MAX_BACNET_SERVICES_SUPPORTED) &&
+         (service < bitstring_bits_used(services));
+         service++) {
+        address_entry_service_set(
+            &Address_Cache[index], service,
+            bitstring_bit(services, (uint8_t)service));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Store whether a device supports a service, for example when
+ *  the device rejected the service as unrecognized
+ * @param device_id - device instance
+ * @param service - BACNET_SERVICES_SUPPORTED of the service
+ * @param supported - true if the device supports the service
+ * @return true if the device is in the cache
+ */
+bool address_device_service_set(
+    uint32_t device_id, BACNET_SERVICES_SUPPORTED service, bool supported)
+{
+    unsigned index;
+
+    index = address_entry_find(device_id);
+    if ((index >= MAX_ADDRESS_CACHE) ||
+        (service >= MAX_BACNET_SERVICES_SUPPORTED)) {
+        return false;
+    }
+    address_entry_service_set(&Address_Cache[index], service, supported);
+
+    return true;
+}
+
+/**
+ * @brief Determine whether a device supports a service
+ * @param device_id - device instance
+ * @param service - BACNET_SERVICES_SUPPORTED of the service
+ * @param supported - pointer to a variable taking true if the device
+ *  supports the service
+ * @return true if it is known whether the device supports the service
+ */
+bool address_device_service_supported(
+    uint32_t device_id, BACNET_SERVICES_SUPPORTED service, bool *supported)
+{
+    const struct Address_Cache_Entry *pMatch;
+    unsigned index;
+    uint8_t mask;
+
+    index = address_entry_find(device_id);
+    if ((index >= MAX_ADDRESS_CACHE) ||
+        (service >= MAX_BACNET_SERVICES_SUPPORTED)) {
+        return false;
+    }
+    pMatch = &Address_Cache[index];
+    mask = (uint8_t)(1 << (service % 8));
+    if ((pMatch->services_known[service / 8] & mask) == 0) {
+        return false;
+    }
+    if (supported) {
+        *supported = (pMatch->services_supported[service / 8] & mask) != 0;
+    }
+
+    return true;
+}
+
 /**
  * Return the device information from the given index in the table.
  *
@@ -696,7 +1263,7 @@ bool address_device_get_by_index(
                 *max_apdu = pMatch->max_apdu;
             }
             if (device_ttl) {
-                *device_ttl = pMatch->TimeToLive;
+                *device_ttl = address_entry_ttl(pMatch);
             }
             found = true;
         }
@@ -1030,21 +1597,351 @@ int rr_address_list_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
  * function
  */
 void address_cache_timer(uint16_t uSeconds)
+{
+    /* expire the entries holding a slot, except statics */
+    Timer_Wheel_Advance(&Address_TTL_Wheel, uSeconds);
+#if BACNET_ADDRESS_CACHE_PERSIST
+    if (Address_Persist_Filename && Address_Persist_Interval) {
+        Address_Persist_Elapsed += uSeconds;
+        if (Address_Persist_Elapsed >= Address_Persist_Interval) {
+            Address_Persist_Elapsed = 0;
+            (void)address_cache_file_flush(Address_Persist_Filename);
+        }
+    }
+#endif
+}
+
+/**
+ * Get the time until the next cache entry expires, so that a main loop
+ * can call address_cache_timer() only when it has something to do.
+ *
+ * @return seconds of address_cache_timer() until the next entry is freed,
+ * or until the changed entries are written to the persistent file,
+ * or BAC_ADDR_FOREVER if there is nothing to do
+ */
+uint32_t address_cache_timer_next(void)
+{
+    uint32_t next = Timer_Wheel_Next(&Address_TTL_Wheel);
+#if BACNET_ADDRESS_CACHE_PERSIST
+    uint32_t flush;
+
+    if (Address_Persist_Filename && Address_Persist_Interval &&
+        Address_Dirty_Count) {
+        flush = 0;
+        if (Address_Persist_Elapsed < Address_Persist_Interval) {
+            flush = Address_Persist_Interval - Address_Persist_Elapsed;
+        }
+        if (flush < next) {
+            next = flush;
+        }
+    }
+#endif
+
+    return next;
+}
+
+#if BACNET_ADDRESS_CACHE_PERSIST
+/* Binary file format, with the multi-octet values in big-endian order:
+   header: 'B' 'A' 'C' 'A', version, MAX_MAC_LEN, number of slots (2)
+   one record per slot of the cache, at the offset of the slot:
+   kind (0=empty, 1=bound, 2=static), device ID (4), max APDU (2),
+   segmentation, max segments (2), network (2), MAC length,
+   MAC (MAX_MAC_LEN), address length, address (MAX_MAC_LEN),
+   I-Am known, I-Am segmentation, I-Am vendor ID (2) */
+#define ADDRESS_FILE_VERSION 1
+#define ADDRESS_FILE_HEADER_SIZE 8
+#define ADDRESS_FILE_RECORD_SIZE (18 + (2 * MAX_MAC_LEN))
+#define ADDRESS_FILE_EMPTY 0
+#define ADDRESS_FILE_BOUND 1
+#define ADDRESS_FILE_STATIC 2
+
+/**
+ * @brief Encode the header of the binary file
+ * @param header - ADDRESS_FILE_HEADER_SIZE octets
+ */
+static void address_file_header_encode(uint8_t *header)
+{
+    header[0] = 'B';
+    header[1] = 'A';
+    header[2] = 'C';
+    header[3] = 'A';
+    header[4] = ADDRESS_FILE_VERSION;
+    header[5] = MAX_MAC_LEN;
+    (void)encode_unsigned16(&header[6], MAX_ADDRESS_CACHE);
+}
+
+/**
+ * @brief Check the header of the binary file
+ * @param header - ADDRESS_FILE_HEADER_SIZE octets
+ * @param slots - returns the number of records in the file
+ * @return true if the file was written with the same record layout
+ */
+static bool address_file_header_valid(const uint8_t *header, uint16_t *slots)
+{
+    if ((header[0] != 'B') || (header[1] != 'A') || (header[2] != 'C') ||
+        (header[3] != 'A') || (header[4] != ADDRESS_FILE_VERSION) ||
+        (header[5] != MAX_MAC_LEN)) {
+        return false;
+    }
+    (void)decode_unsigned16(&header[6], slots);
+
+    return true;
+}
+
+/**
+ * @brief Encode the record of an entry. Only the bound entries are
+ *  kept, since a bind request or a reserved entry is not worth keeping.
+ * @param record - ADDRESS_FILE_RECORD_SIZE octets
+ * @param pMatch - the entry
+ */
+static void address_file_record_encode(
+    uint8_t *record, const struct Address_Cache_Entry *pMatch)
+{
+    uint8_t *adr;
+
+    memset(record, 0, ADDRESS_FILE_RECORD_SIZE);
+    if ((pMatch->Flags &
+         (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_RESERVED)) !=
+        BAC_ADDR_IN_USE) {
+        return;
+    }
+    if (pMatch->Flags & BAC_ADDR_STATIC) {
+        record[0] = ADDRESS_FILE_STATIC;
+    } else {
+        record[0] = ADDRESS_FILE_BOUND;
+    }
+    (void)encode_unsigned32(&record[1], pMatch->device_id);
+    (void)encode_unsigned16(&record[5], (uint16_t)pMatch->max_apdu);
+#if BACNET_SEGMENTATION_ENABLED
+    record[7] = pMatch->segmentation;
+    (void)encode_unsigned16(&record[8], pMatch->maxsegments);
+#else
+    record[7] = SEGMENTATION_NONE;
+    (void)encode_unsigned16(&record[8], 1);
+#endif
+    (void)encode_unsigned16(&record[10], pMatch->address.net);
+    record[12] = pMatch->address.mac_len;
+    memcpy(&record[13], pMatch->address.mac, MAX_MAC_LEN);
+    adr = &record[13 + MAX_MAC_LEN];
+    adr[0] = pMatch->address.len;
+    memcpy(&adr[1], pMatch->address.adr, MAX_MAC_LEN);
+    adr = &adr[1 + MAX_MAC_LEN];
+    adr[0] = pMatch->iam_known ? 1 : 0;
+    adr[1] = pMatch->iam_segmentation;
+    (void)encode_unsigned16(&adr[2], pMatch->iam_vendor_id);
+}
+
+/**
+ * @brief Add the binding of a record to the cache
+ * @param record - ADDRESS_FILE_RECORD_SIZE octets
+ */
+static void address_file_record_decode(const uint8_t *record)
 {
     struct Address_Cache_Entry *pMatch;
+    BACNET_ADDRESS src = { 0 };
+    const uint8_t *adr;
+    uint32_t device_id = 0;
+    uint16_t max_apdu = 0, value = 0;
     unsigned index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) != 0) &&
-            ((pMatch->Flags & BAC_ADDR_STATIC) ==
-             0)) { /* Check all entries holding a slot except statics
-                    */
-            if (pMatch->TimeToLive >= uSeconds) {
-                pMatch->TimeToLive -= uSeconds;
-            } else {
-                pMatch->Flags = 0;
+    if ((record[0] != ADDRESS_FILE_BOUND) &&
+        (record[0] != ADDRESS_FILE_STATIC)) {
+        return;
+    }
+    adr = &record[13 + MAX_MAC_LEN];
+    if ((record[12] > MAX_MAC_LEN) || (adr[0] > MAX_MAC_LEN)) {
+        return;
+    }
+    (void)decode_unsigned32(&record[1], &device_id);
+    (void)decode_unsigned16(&record[5], &max_apdu);
+    (void)decode_unsigned16(&record[10], &src.net);
+    src.mac_len = record[12];
+    memcpy(src.mac, &record[13], MAX_MAC_LEN);
+    src.len = adr[0];
+    memcpy(src.adr, &adr[1], MAX_MAC_LEN);
+    address_add(device_id, max_apdu, &src);
+    index = address_entry_find(device_id);
+    if (index >= MAX_ADDRESS_CACHE) {
+        return;
+    }
+    pMatch = &Address_Cache[index];
+#if BACNET_SEGMENTATION_ENABLED
+    pMatch->segmentation = record[7];
+    (void)decode_unsigned16(&record[8], &pMatch->maxsegments);
+#endif
+    adr = &adr[1 + MAX_MAC_LEN];
+    if (adr[0]) {
+        pMatch->iam_known = true;
+        pMatch->iam_segmentation = adr[1];
+        (void)decode_unsigned16(&adr[2], &value);
+        pMatch->iam_vendor_id = value;
+    }
+    if (record[0] == ADDRESS_FILE_STATIC) {
+        address_set_device_TTL(device_id, 0, true);
+    }
+}
+
+/**
+ * @brief Load the bindings that were saved in a binary file. The loaded
+ *  bindings are used right away, with the short time to live of a
+ *  binding that was picked up from the network, so that a device that
+ *  is no longer there is forgotten unless it sends another I-Am.
+ *  Static bindings stay static.
+ * @param pFilename - name of the file
+ * @return true if the file was read
+ */
+bool address_cache_file_load(const char *pFilename)
+{
+    FILE *pFile = NULL;
+    uint8_t header[ADDRESS_FILE_HEADER_SIZE] = { 0 };
+    uint8_t record[ADDRESS_FILE_RECORD_SIZE] = { 0 };
+    uint16_t slots = 0, slot;
+    bool status = false;
+
+    if (!pFilename) {
+        return false;
+    }
+    pFile = fopen(pFilename, "rb");
+    if (!pFile) {
+        return false;
+    }
+    if ((fread(header, sizeof(header), 1, pFile) == 1) &&
+        address_file_header_valid(header, &slots)) {
+        for (slot = 0; slot < slots; slot++) {
+            if (fread(record, sizeof(record), 1, pFile) != 1) {
+                break;
             }
+            address_file_record_decode(record);
+        }
+        status = true;
+    }
+    fclose(pFile);
+    /* the entries were placed in other slots than in the file */
+    address_dirty_all();
+
+    return status;
+}
+
+/**
+ * @brief Write every entry to a binary file, replacing the file
+ * @param pFilename - name of the file
+ * @return true if the file was written
+ */
+bool address_cache_file_save(const char *pFilename)
+{
+    FILE *pFile = NULL;
+    uint8_t header[ADDRESS_FILE_HEADER_SIZE] = { 0 };
+    uint8_t record[ADDRESS_FILE_RECORD_SIZE] = { 0 };
+    unsigned index;
+    bool status = true;
+
+    if (!pFilename) {
+        return false;
+    }
+    pFile = fopen(pFilename, "wb");
+    if (!pFile) {
+        return false;
+    }
+    address_file_header_encode(header);
+    if (fwrite(header, sizeof(header), 1, pFile) != 1) {
+        status = false;
+    }
+    for (index = 0; status && (index < MAX_ADDRESS_CACHE); index++) {
+        address_file_record_encode(record, &Address_Cache[index]);
+        if (fwrite(record, sizeof(record), 1, pFile) != 1) {
+            status = false;
+        }
+    }
+    if (fclose(pFile) != 0) {
+        status = false;
+    }
+    if (status) {
+        memset(Address_Dirty, 0, sizeof(Address_Dirty));
+        Address_Dirty_Count = 0;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Write the entries that changed since they were last written
+ *  to a binary file, each one over its own record. A file that is
+ *  missing, or that was written by a build with another cache layout,
+ *  is written again in full.
+ * @param pFilename - name of the file
+ * @return number of records that were written, or -1 on error
+ */
+int address_cache_file_flush(const char *pFilename)
+{
+    FILE *pFile = NULL;
+    uint8_t header[ADDRESS_FILE_HEADER_SIZE] = { 0 };
+    uint8_t record[ADDRESS_FILE_RECORD_SIZE] = { 0 };
+    uint16_t slots = 0;
+    unsigned index;
+    int count = 0;
+    long offset;
+    uint8_t mask;
+
+    if (!pFilename) {
+        return -1;
+    }
+    if (Address_Dirty_Count == 0) {
+        return 0;
+    }
+    pFile = fopen(pFilename, "r+b");
+    if (pFile) {
+        if ((fread(header, sizeof(header), 1, pFile) != 1) ||
+            !address_file_header_valid(header, &slots) ||
+            (slots != MAX_ADDRESS_CACHE)) {
+            fclose(pFile);
+            pFile = NULL;
+        }
+    }
+    if (!pFile) {
+        if (!address_cache_file_save(pFilename)) {
+            return -1;
+        }
+        return MAX_ADDRESS_CACHE;
+    }
+    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+        mask = (uint8_t)BIT(index & 7);
+        if ((Address_Dirty[index / 8] & mask) == 0) {
+            continue;
+        }
+        offset = ADDRESS_FILE_HEADER_SIZE +
+            ((long)index * ADDRESS_FILE_RECORD_SIZE);
+        address_file_record_encode(record, &Address_Cache[index]);
+        if ((fseek(pFile, offset, SEEK_SET) != 0) ||
+            (fwrite(record, sizeof(record), 1, pFile) != 1)) {
+            count = -1;
+            break;
         }
+        Address_Dirty[index / 8] &= (uint8_t)~mask;
+        Address_Dirty_Count--;
+        count++;
+    }
+    if (fclose(pFile) != 0) {
+        count = -1;
     }
+
+    return count;
 }
+
+/**
+ * @brief Keep the learned bindings in a binary file. The bindings in the
+ *  file are loaded now, and address_cache_timer() writes the entries
+ *  that changed to the file once the interval has passed.
+ * @param pFilename - name of the file, which is kept, or NULL to stop
+ * @param flush_seconds - seconds between the writes, or zero to write
+ *  only when address_cache_file_flush() is called
+ * @return true if the file was read
+ */
+bool address_cache_file_persist(const char *pFilename, uint32_t flush_seconds)
+{
+    Address_Persist_Filename = pFilename;
+    Address_Persist_Interval = flush_seconds;
+    Address_Persist_Elapsed = 0;
+
+    return address_cache_file_load(pFilename);
+}
+#endif
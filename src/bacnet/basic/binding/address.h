@@ -15,6 +15,7 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/bacaddr.h"
+#include "bacnet/bacstr.h"
 #include "bacnet/readrange.h"
 
 /* refactored utility functions - see bacaddr.c module */
@@ -87,6 +88,26 @@ BACNET_STACK_EXPORT
 void address_add_binding(
     uint32_t device_id, unsigned max_apdu, const BACNET_ADDRESS *src);
 
+BACNET_STACK_EXPORT
+bool address_device_iam_set(
+    uint32_t device_id, int segmentation, uint16_t vendor_id);
+
+BACNET_STACK_EXPORT
+bool address_device_iam(
+    uint32_t device_id, int *segmentation, uint16_t *vendor_id);
+
+BACNET_STACK_EXPORT
+bool address_device_services_set(
+    uint32_t device_id, const BACNET_BIT_STRING *services);
+
+BACNET_STACK_EXPORT
+bool address_device_service_set(
+    uint32_t device_id, BACNET_SERVICES_SUPPORTED service, bool supported);
+
+BACNET_STACK_EXPORT
+bool address_device_service_supported(
+    uint32_t device_id, BACNET_SERVICES_SUPPORTED service, bool *supported);
+
 BACNET_STACK_EXPORT
 int address_list_encode(uint8_t *apdu, unsigned apdu_len);
 
@@ -99,6 +120,17 @@ void address_set_device_TTL(
 
 BACNET_STACK_EXPORT
 void address_cache_timer(uint16_t uSeconds);
+BACNET_STACK_EXPORT
+uint32_t address_cache_timer_next(void);
+
+BACNET_STACK_EXPORT
+bool address_cache_file_load(const char *pFilename);
+BACNET_STACK_EXPORT
+bool address_cache_file_save(const char *pFilename);
+BACNET_STACK_EXPORT
+int address_cache_file_flush(const char *pFilename);
+BACNET_STACK_EXPORT
+bool address_cache_file_persist(const char *pFilename, uint32_t flush_seconds);
 
 BACNET_STACK_EXPORT
 void address_protected_entry_index_set(uint32_t top_protected_entry_index);
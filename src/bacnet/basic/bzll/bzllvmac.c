@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keyhash.h"
 #include "bacnet/basic/sys/keylist.h"
 /* me! */
 #include "bacnet/basic/bzll/bzllvmac.h"
@@ -35,6 +36,26 @@ void BZLL_VMAC_Debug_Enable(void)
 
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist VMAC_List;
+/* Index of the Device IDs by a hash of their VMAC address */
+static OS_Keyhash VMAC_Index;
+
+/**
+ * @brief Compute the hash of a VMAC address and endpoint for the index
+ * @param vmac - VMAC address
+ * @return hash of the VMAC address
+ */
+static uint32_t BZLL_VMAC_Hash(const struct bzll_vmac_data *vmac)
+{
+    uint8_t data[BZLL_VMAC_EUI64 + 1];
+    size_t i;
+
+    for (i = 0; i < BZLL_VMAC_EUI64; i++) {
+        data[i] = vmac->mac[i];
+    }
+    data[BZLL_VMAC_EUI64] = vmac->endpoint;
+
+    return Keyhash_FNV1a(data, sizeof(data));
+}
 
 /**
  * Returns the number of VMAC in the list
@@ -75,7 +96,15 @@ bool BZLL_VMAC_Add(uint32_t device_id, const struct bzll_vmac_data *vmac)
         list_vmac = Keylist_Data(VMAC_List, device_id);
         if (list_vmac) {
             /* device ID already exists. Update MAC. */
+            (void)Keyhash_Remove(
+                VMAC_Index, BZLL_VMAC_Hash(list_vmac), device_id);
             memmove(list_vmac, vmac, sizeof(struct bzll_vmac_data));
+            if (!Keyhash_Add(
+                    VMAC_Index, BZLL_VMAC_Hash(list_vmac), device_id)) {
+                /* without the index, the list is searched */
+                Keyhash_Delete(VMAC_Index);
+                VMAC_Index = NULL;
+            }
             found = true;
             status = true;
         }
@@ -91,12 +120,20 @@ bool BZLL_VMAC_Add(uint32_t device_id, const struct bzll_vmac_data *vmac)
             list_vmac->endpoint = vmac->endpoint;
             index = Keylist_Data_Add(VMAC_List, device_id, list_vmac);
             if (index >= 0) {
+                if (!Keyhash_Add(
+                        VMAC_Index, BZLL_VMAC_Hash(list_vmac), device_id)) {
+                    /* without the index, the list is searched */
+                    Keyhash_Delete(VMAC_Index);
+                    VMAC_Index = NULL;
+                }
                 status = true;
                 if (VMAC_Debug) {
                     debug_fprintf(
                         stderr, "BZLL VMAC %u added.\n",
                         (unsigned int)device_id);
                 }
+            } else {
+                free(list_vmac);
             }
         }
     }
@@ -118,6 +155,7 @@ bool BZLL_VMAC_Delete(uint32_t device_id)
 
     pVMAC = Keylist_Data_Delete(VMAC_List, device_id);
     if (pVMAC) {
+        (void)Keyhash_Remove(VMAC_Index, BZLL_VMAC_Hash(pVMAC), device_id);
         free(pVMAC);
         status = true;
     }
@@ -212,10 +250,27 @@ bool BZLL_VMAC_Entry_To_Device_ID(
     struct bzll_vmac_data *list_vmac;
     int count = 0;
     int index = 0;
+    unsigned iterator = 0;
+    KEY key = 0;
 
     if (!vmac) {
         return false; /* invalid parameter */
     }
+    if (VMAC_Index) {
+        while (Keyhash_Find(
+            VMAC_Index, BZLL_VMAC_Hash(vmac), &iterator, &key)) {
+            /* different addresses may have the same hash */
+            list_vmac = Keylist_Data(VMAC_List, key);
+            if (list_vmac && BZLL_VMAC_Same(vmac, list_vmac)) {
+                if (device_id) {
+                    *device_id = key;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+    /* without the index, the list is searched */
     count = Keylist_Count(VMAC_List);
     while (count) {
         index = count - 1;
@@ -290,6 +345,8 @@ void BZLL_VMAC_Cleanup(void)
         Keylist_Delete(VMAC_List);
         VMAC_List = NULL;
     }
+    Keyhash_Delete(VMAC_Index);
+    VMAC_Index = NULL;
 }
 
 /**
@@ -298,6 +355,7 @@ void BZLL_VMAC_Cleanup(void)
 void BZLL_VMAC_Init(void)
 {
     VMAC_List = Keylist_Create();
+    VMAC_Index = Keyhash_Create();
     if (VMAC_List) {
         atexit(BZLL_VMAC_Cleanup);
         debug_fprintf(stderr, "BZLL VMAC List initialized.\n");
@@ -0,0 +1,212 @@
+/**
+ * @file
+ * @date 2026
+ * @brief Write the actions of the Command objects using the
+ *  read-write client, which writes the actions for other devices
+ *  in parallel and groups the actions for one device into
+ *  WritePropertyMultiple requests.
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacaction.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/object/command.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/client/bac-rw.h"
+#include "bacnet/basic/client/bac-command.h"
+
+struct bacnet_command_write {
+    uint32_t object_instance;
+    BACNET_ACTION_LIST *action;
+};
+
+static struct mstimer Command_Timer_Interval;
+
+/**
+ * @brief Determine if an action is for this device
+ * @param action [in] the action entry
+ * @return true if the action is written to this device
+ */
+static bool bacnet_command_action_local(const BACNET_ACTION_LIST *action)
+{
+    if (action->Device_Id.instance >= BACNET_MAX_INSTANCE) {
+        /* the device identifier is absent */
+        return true;
+    }
+
+    return action->Device_Id.instance == Device_Object_Instance_Number();
+}
+
+/**
+ * @brief Write an action to an object of this device
+ * @param action [in] the action entry
+ * @return true if the write was successful
+ */
+static bool bacnet_command_action_write_local(const BACNET_ACTION_LIST *action)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    int len;
+
+    wp_data.object_type = action->Object_Id.type;
+    wp_data.object_instance = action->Object_Id.instance;
+    wp_data.object_property = action->Property_Identifier;
+    wp_data.array_index = action->Property_Array_Index;
+    wp_data.priority = action->Priority;
+    if (wp_data.priority == BACNET_NO_PRIORITY) {
+        wp_data.priority = BACNET_MAX_PRIORITY;
+    }
+    len = bacnet_action_property_value_encode(
+        wp_data.application_data, &action->Value);
+    if ((len <= 0) || (len > (int)sizeof(wp_data.application_data))) {
+        return false;
+    }
+    wp_data.application_data_len = len;
+
+    return Device_Write_Property(&wp_data);
+}
+
+/**
+ * @brief Convert the value of an action into a value for the client
+ * @param action [in] the action entry
+ * @param value [out] the value to write
+ * @return true if the value type can be written by the client
+ */
+static bool bacnet_command_action_value(
+    const BACNET_ACTION_LIST *action, BACNET_APPLICATION_DATA_VALUE *value)
+{
+    value->tag = action->Value.tag;
+    switch (action->Value.tag) {
+#if defined(BACACTION_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            break;
+#endif
+#if defined(BACACTION_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            value->type.Boolean = action->Value.type.Boolean;
+            break;
+#endif
+#if defined(BACACTION_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            value->type.Unsigned_Int = action->Value.type.Unsigned_Int;
+            break;
+#endif
+#if defined(BACACTION_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            value->type.Signed_Int = action->Value.type.Signed_Int;
+            break;
+#endif
+#if defined(BACACTION_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            value->type.Real = action->Value.type.Real;
+            break;
+#endif
+#if defined(BACACTION_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            value->type.Enumerated = action->Value.type.Enumerated;
+            break;
+#endif
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Handle the result of an action write to another device
+ * @param context [in] the action write
+ * @param device_instance [in] device instance number
+ * @param rp_data [in] the result of the write
+ * @param value [in] unused
+ */
+static void bacnet_command_write_result(
+    void *context,
+    uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    struct bacnet_command_write *write = context;
+    bool success;
+
+    (void)device_instance;
+    (void)value;
+    if (!write) {
+        return;
+    }
+    success = rp_data && (rp_data->error_code == ERROR_CODE_SUCCESS);
+    Command_Action_Write_Result(write->object_instance, write->action, success);
+    free(write);
+}
+
+/**
+ * @brief Write an action of a Command object
+ * @param object_instance [in] the Command object instance
+ * @param action [in] the action entry to write
+ * @return true if the write was started
+ */
+static bool bacnet_command_action_write(
+    uint32_t object_instance, BACNET_ACTION_LIST *action)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    struct bacnet_command_write *write;
+    bool status;
+
+    if (bacnet_command_action_local(action)) {
+        status = bacnet_command_action_write_local(action);
+        Command_Action_Write_Result(object_instance, action, status);
+        return true;
+    }
+    if (!bacnet_command_action_value(action, &value)) {
+        return false;
+    }
+    write = calloc(1, sizeof(struct bacnet_command_write));
+    if (!write) {
+        return false;
+    }
+    write->object_instance = object_instance;
+    write->action = action;
+    status = bacnet_write_property_queue_callback(
+        action->Device_Id.instance, action->Object_Id.type,
+        action->Object_Id.instance, action->Property_Identifier, &value,
+        action->Priority, action->Property_Array_Index,
+        bacnet_command_write_result, write);
+    if (!status) {
+        free(write);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Non-blocking task for the Post_Delay of the Command objects
+ */
+void bacnet_command_task(void)
+{
+    unsigned index, count;
+    uint16_t milliseconds;
+
+    if (mstimer_expired(&Command_Timer_Interval)) {
+        mstimer_reset(&Command_Timer_Interval);
+        milliseconds = (uint16_t)mstimer_interval(&Command_Timer_Interval);
+        count = Command_Count();
+        for (index = 0; index < count; index++) {
+            Command_Timer(Command_Index_To_Instance(index), milliseconds);
+        }
+    }
+}
+
+/**
+ * @brief Write the actions of the Command objects with this module
+ */
+void bacnet_command_init(void)
+{
+    Command_Action_Write_Callback_Set(bacnet_command_action_write);
+    mstimer_set(&Command_Timer_Interval, 100);
+}
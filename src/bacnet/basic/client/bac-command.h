@@ -0,0 +1,26 @@
+/**
+ * @file
+ * @brief API for writing the actions of the Command objects
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_COMMAND_H
+#define BACNET_BASIC_CLIENT_COMMAND_H
+
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_command_init(void);
+BACNET_STACK_EXPORT
+void bacnet_command_task(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -11,6 +11,12 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/bacint.h"
+#include "bacnet/cov.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/service/h_apdu.h"
+#include "bacnet/basic/service/h_ucov.h"
+#include "bacnet/basic/sys/keyhash.h"
 #include "bacnet/basic/sys/mstimer.h"
 /* us */
 #include "bacnet/basic/client/bac-rw.h"
@@ -20,8 +26,19 @@
 #ifndef BACNET_DATA_OBJECT_MAX
 #define BACNET_DATA_OBJECT_MAX 16
 #endif
-/* Polling interval timer */
-static struct mstimer Object_Poll_Timer;
+/* number of poll intervals without a value before a value is stale */
+#ifndef BACNET_DATA_STALE_POLLS
+#define BACNET_DATA_STALE_POLLS 3
+#endif
+/* seconds that a COV subscription lasts, or 0 to only poll */
+#ifndef BACNET_DATA_COV_LIFETIME
+#define BACNET_DATA_COV_LIFETIME 300
+#endif
+/* default polling interval */
+static unsigned long Poll_Milliseconds = 1UL * 60UL * 1000UL;
+static uint32_t Cov_Lifetime = BACNET_DATA_COV_LIFETIME;
+/* where the COV notifications are given */
+static BACNET_COV_NOTIFICATION Cov_Notification;
 /* property R/W process interval timer */
 static struct mstimer Read_Write_Timer;
 
@@ -41,9 +58,176 @@ typedef struct bacnet_object_data {
             uint32_t Enumerated;
         } type;
     } Present_Value;
-    bool refresh;
+    /* milliseconds between polls, or 0 for the default polling interval */
+    unsigned long Poll_Milliseconds;
+    /* when the next poll is due */
+    unsigned long Poll_Deadline;
+    /* position in the poll schedule */
+    unsigned Poll_Heap_Index;
+    /* a read or subscription is queued or is waiting for a reply */
+    bool Poll_Pending;
+    /* the object is subscribed, and the deadline is its renewal */
+    bool Cov_Active;
+    /* the device refused the subscription - poll instead */
+    bool Cov_Refused;
+    /* when the last value was stored, or when the object was added */
+    unsigned long Value_Milliseconds;
 } BACNET_DATA_OBJECT;
 static BACNET_DATA_OBJECT Object_Table[BACNET_DATA_OBJECT_MAX];
+/* objects by hash of their device, type, and instance */
+static OS_Keyhash Object_Index;
+/* objects in the order of their poll deadline, as a binary min-heap */
+static unsigned Poll_Heap[BACNET_DATA_OBJECT_MAX];
+static unsigned Poll_Heap_Count;
+
+/**
+ * @brief Compute the hash of an object, for the object index
+ * @param  device_instance - object-instance number of the device object
+ * @param  object_type - object type of the object
+ * @param  object_instance - object-instance number of the object
+ * @return hash of the object
+ */
+static uint32_t bacnet_data_object_hash(
+    uint32_t device_instance, uint16_t object_type, uint32_t object_instance)
+{
+    uint8_t buffer[10];
+
+    encode_unsigned32(&buffer[0], device_instance);
+    encode_unsigned16(&buffer[4], object_type);
+    encode_unsigned32(&buffer[6], object_instance);
+
+    return Keyhash_FNV1a(buffer, sizeof(buffer));
+}
+
+/**
+ * @brief Get the polling interval of an object
+ * @param object - BACnet object structure data pointer
+ * @return milliseconds between polls
+ */
+static unsigned long bacnet_data_poll_interval(const BACNET_DATA_OBJECT *object)
+{
+    unsigned long interval = object->Poll_Milliseconds;
+
+    if (object->Cov_Active && (Cov_Lifetime > 0)) {
+        /* renew the subscription halfway through its lifetime */
+        return (unsigned long)Cov_Lifetime * 500UL;
+    }
+    if (interval == 0) {
+        interval = Poll_Milliseconds;
+    }
+    if (interval == 0) {
+        interval = 1;
+    }
+
+    return interval;
+}
+
+/**
+ * @brief Compute the next poll deadline of an object.  The deadlines of
+ *  the objects of a device with the same interval fall at the same time,
+ *  so that their reads share a ReadPropertyMultiple request, and the
+ *  devices are spread over the interval by a hash of the device instance.
+ * @param object - BACnet object structure data pointer
+ * @param now - the current time in milliseconds
+ * @return the next poll deadline in milliseconds
+ */
+static unsigned long
+bacnet_data_poll_next(const BACNET_DATA_OBJECT *object, unsigned long now)
+{
+    uint8_t buffer[4];
+    unsigned long interval, phase;
+
+    interval = bacnet_data_poll_interval(object);
+    encode_unsigned32(buffer, object->Device_ID);
+    phase = Keyhash_FNV1a(buffer, sizeof(buffer)) % interval;
+
+    return now + interval - ((now - phase) % interval);
+}
+
+/**
+ * @brief Determine if a time has been reached
+ * @param deadline - time in milliseconds
+ * @param now - the current time in milliseconds
+ * @return true if the deadline is now or has passed
+ */
+static bool
+bacnet_data_deadline_passed(unsigned long deadline, unsigned long now)
+{
+    return (long)(now - deadline) >= 0;
+}
+
+/**
+ * @brief Determine if the value of an object is stale
+ * @param object - BACnet object structure data pointer
+ * @param now - the current time in milliseconds
+ * @return true if no value was stored for several polling intervals
+ */
+static bool
+bacnet_data_value_stale(const BACNET_DATA_OBJECT *object, unsigned long now)
+{
+    return (now - object->Value_Milliseconds) >
+        (BACNET_DATA_STALE_POLLS * bacnet_data_poll_interval(object));
+}
+
+/**
+ * @brief Swap two entries of the poll schedule
+ * @param a - position of one entry
+ * @param b - position of the other entry
+ */
+static void bacnet_data_heap_swap(unsigned a, unsigned b)
+{
+    unsigned index = Poll_Heap[a];
+
+    Poll_Heap[a] = Poll_Heap[b];
+    Poll_Heap[b] = index;
+    Object_Table[Poll_Heap[a]].Poll_Heap_Index = a;
+    Object_Table[Poll_Heap[b]].Poll_Heap_Index = b;
+}
+
+/**
+ * @brief Determine if one entry of the poll schedule is due before another
+ * @param a - position of one entry
+ * @param b - position of the other entry
+ * @return true if the entry at a is due before the entry at b
+ */
+static bool bacnet_data_heap_before(unsigned a, unsigned b)
+{
+    return (long)(Object_Table[Poll_Heap[a]].Poll_Deadline -
+                  Object_Table[Poll_Heap[b]].Poll_Deadline) < 0;
+}
+
+/**
+ * @brief Move an entry of the poll schedule to its place
+ * @param position - position of the entry whose deadline changed
+ */
+static void bacnet_data_heap_update(unsigned position)
+{
+    unsigned parent, child;
+
+    while (position > 0) {
+        parent = (position - 1) / 2;
+        if (!bacnet_data_heap_before(position, parent)) {
+            break;
+        }
+        bacnet_data_heap_swap(position, parent);
+        position = parent;
+    }
+    for (;;) {
+        child = (2 * position) + 1;
+        if (child >= Poll_Heap_Count) {
+            break;
+        }
+        if (((child + 1) < Poll_Heap_Count) &&
+            bacnet_data_heap_before(child + 1, child)) {
+            child++;
+        }
+        if (!bacnet_data_heap_before(child, position)) {
+            break;
+        }
+        bacnet_data_heap_swap(position, child);
+        position = child;
+    }
+}
 
 /**
  * @brief Find the index of a BACnet object type of a given instance.
@@ -56,8 +240,23 @@ static int bacnet_data_object_index_find(
     uint32_t device_instance, uint16_t object_type, uint32_t object_instance)
 {
     BACNET_DATA_OBJECT *object = NULL;
-    unsigned i = 0;
-
+    unsigned i = 0, iterator = 0;
+    uint32_t hash;
+    KEY key;
+
+    if (Object_Index) {
+        hash = bacnet_data_object_hash(
+            device_instance, object_type, object_instance);
+        while (Keyhash_Find(Object_Index, hash, &iterator, &key)) {
+            object = &Object_Table[key];
+            if ((object->Device_ID == device_instance) &&
+                (object->Object_Type == object_type) &&
+                (object->Object_ID == object_instance)) {
+                return (int)key;
+            }
+        }
+        return BACNET_STATUS_ERROR;
+    }
     for (i = 0; i < BACNET_DATA_OBJECT_MAX; i++) {
         object = &Object_Table[i];
         if ((object->Device_ID == device_instance) &&
@@ -105,6 +304,16 @@ static void bacnet_data_object_init(void)
         object->Device_ID = BACNET_MAX_INSTANCE;
         object->Object_Type = MAX_BACNET_OBJECT_TYPE;
         object->Object_ID = BACNET_MAX_INSTANCE;
+        object->Poll_Milliseconds = 0;
+        object->Poll_Pending = false;
+        object->Cov_Active = false;
+        object->Cov_Refused = false;
+    }
+    Poll_Heap_Count = 0;
+    if (Object_Index) {
+        Keyhash_Clear(Object_Index);
+    } else {
+        Object_Index = Keyhash_Create();
     }
 }
 
@@ -139,7 +348,7 @@ static void bacnet_data_object_store(
             default:
                 break;
         }
-        object->refresh = false;
+        object->Value_Milliseconds = mstimer_now();
     }
 }
 
@@ -188,18 +397,164 @@ void bacnet_data_value_save(
     }
 }
 
+/**
+ * @brief Stores the result of a poll
+ * @param context [in] the object that was polled
+ * @param device_instance [in] device instance number where data originated
+ * @param rp_data [in] the result of the read
+ * @param value [in] the decoded value, or NULL when the read failed
+ */
+static void bacnet_data_poll_result(
+    void *context,
+    uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_DATA_OBJECT *object = context;
+
+    object->Poll_Pending = false;
+    bacnet_data_value_save(device_instance, rp_data, value);
+}
+
+/**
+ * @brief Moves the objects of a device that refused COV subscriptions
+ *  to polling, and polls them now
+ * @param device_instance [in] device instance number
+ */
+static void bacnet_data_cov_refused(uint32_t device_instance)
+{
+    BACNET_DATA_OBJECT *object;
+    unsigned i;
+
+    for (i = 0; i < BACNET_DATA_OBJECT_MAX; i++) {
+        object = &Object_Table[i];
+        if ((object->Device_ID == device_instance) && !object->Cov_Refused) {
+            object->Cov_Refused = true;
+            object->Cov_Active = false;
+            object->Poll_Deadline = mstimer_now();
+            bacnet_data_heap_update(object->Poll_Heap_Index);
+        }
+    }
+}
+
+/**
+ * @brief Handles the result of a COV subscription
+ * @param context [in] the object that was subscribed
+ * @param device_instance [in] device instance number where data originated
+ * @param rp_data [in] the result of the subscription
+ * @param value [in] always NULL
+ */
+static void bacnet_data_cov_result(
+    void *context,
+    uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_DATA_OBJECT *object = context;
+
+    (void)value;
+    object->Poll_Pending = false;
+    switch (rp_data->error_code) {
+        case ERROR_CODE_SUCCESS:
+            /* the values come with the notifications */
+            object->Cov_Active = true;
+            object->Poll_Deadline =
+                bacnet_data_poll_next(object, mstimer_now());
+            break;
+        case ERROR_CODE_TIMEOUT:
+        case ERROR_CODE_ABORT_TSM_TIMEOUT:
+            /* the device did not answer - try again at the poll rate */
+            object->Cov_Active = false;
+            object->Poll_Deadline =
+                bacnet_data_poll_next(object, mstimer_now());
+            break;
+        case ERROR_CODE_REJECT_UNRECOGNIZED_SERVICE:
+        case ERROR_CODE_SERVICE_REQUEST_DENIED:
+            /* the device does not do COV - poll all its objects */
+            bacnet_data_cov_refused(device_instance);
+            return;
+        default:
+            /* the object does not do COV - poll it */
+            object->Cov_Active = false;
+            object->Cov_Refused = true;
+            object->Poll_Deadline = mstimer_now();
+            break;
+    }
+    bacnet_data_heap_update(object->Poll_Heap_Index);
+}
+
+/**
+ * @brief Stores the values of a COV notification
+ * @param cov_data [in] data decoded from the COV notification
+ */
+static void bacnet_data_cov_notification(BACNET_COV_DATA *cov_data)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_PROPERTY_VALUE *property_value;
+    int index;
+
+    index = bacnet_data_object_index_find(
+        cov_data->initiatingDeviceIdentifier,
+        cov_data->monitoredObjectIdentifier.type,
+        cov_data->monitoredObjectIdentifier.instance);
+    if (index == BACNET_STATUS_ERROR) {
+        return;
+    }
+    rp_data.object_type = cov_data->monitoredObjectIdentifier.type;
+    rp_data.object_instance = cov_data->monitoredObjectIdentifier.instance;
+    rp_data.error_code = ERROR_CODE_SUCCESS;
+    for (property_value = cov_data->listOfValues; property_value;
+         property_value = property_value->next) {
+        if (property_value->propertyIdentifier == PROP_PRESENT_VALUE) {
+            rp_data.object_property = property_value->propertyIdentifier;
+            rp_data.array_index = property_value->propertyArrayIndex;
+            bacnet_data_object_store(index, &rp_data, &property_value->value);
+        }
+    }
+}
+
 /**
  * @brief Handles the BACnet Data Analog Value processing
  * @param object - BACnet object structure data pointer
+ * @return false if the read could not be queued
  */
-static void bacnet_data_object_process(const BACNET_DATA_OBJECT *object)
+static bool bacnet_data_object_process(BACNET_DATA_OBJECT *object)
 {
-    if (object && (object->Device_ID < BACNET_MAX_INSTANCE) &&
+    bool status, supported = true;
+
+    if (object->Poll_Pending) {
+        /* the last poll has not finished - skip this one */
+        return true;
+    }
+    if ((object->Device_ID < BACNET_MAX_INSTANCE) &&
         (object->Object_ID < BACNET_MAX_INSTANCE)) {
-        bacnet_read_property_queue(
-            object->Device_ID, (BACNET_OBJECT_TYPE)object->Object_Type,
-            object->Object_ID, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+        if ((Cov_Lifetime > 0) && !object->Cov_Refused &&
+            address_device_service_supported(
+                object->Device_ID, SERVICE_SUPPORTED_SUBSCRIBE_COV,
+                &supported) &&
+            !supported) {
+            /* the device is known not to do COV */
+            object->Cov_Refused = true;
+        }
+        if ((Cov_Lifetime > 0) && !object->Cov_Refused) {
+            /* subscribe, or renew the subscription */
+            status = bacnet_subscribe_cov_queue_callback(
+                object->Device_ID, (BACNET_OBJECT_TYPE)object->Object_Type,
+                object->Object_ID, Cov_Lifetime, bacnet_data_cov_result,
+                object);
+        } else {
+            status = bacnet_read_property_queue_callback(
+                object->Device_ID, (BACNET_OBJECT_TYPE)object->Object_Type,
+                object->Object_ID, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL,
+                bacnet_data_poll_result, object);
+        }
+        if (!status) {
+            return false;
+        }
+        object->Poll_Pending = true;
     }
+
+    return true;
 }
 
 /**
@@ -232,17 +587,34 @@ bool bacnet_data_object_add(
                 device_id, object_type, object_instance);
             if (index == BACNET_STATUS_ERROR) {
                 index = bacnet_data_object_index_find_free();
+                if ((index != BACNET_STATUS_ERROR) && Object_Index &&
+                    !Keyhash_Add(
+                        Object_Index,
+                        bacnet_data_object_hash(
+                            device_id, object_type, object_instance),
+                        index)) {
+                    index = BACNET_STATUS_ERROR;
+                }
                 if (index != BACNET_STATUS_ERROR) {
                     object = &Object_Table[index];
                     object->Device_ID = device_id;
                     object->Object_Type = object_type;
                     object->Object_ID = object_instance;
-                    object->refresh = true;
-                    status = true;
+                    object->Poll_Milliseconds = 0;
+                    object->Poll_Pending = false;
+                    object->Cov_Active = false;
+                    object->Cov_Refused = false;
+                    object->Value_Milliseconds = mstimer_now();
+                    object->Poll_Heap_Index = Poll_Heap_Count;
+                    Poll_Heap[Poll_Heap_Count] = index;
+                    Poll_Heap_Count++;
                 }
-            } else {
+            }
+            if (index != BACNET_STATUS_ERROR) {
+                /* poll now */
                 object = &Object_Table[index];
-                object->refresh = true;
+                object->Poll_Deadline = mstimer_now();
+                bacnet_data_heap_update(object->Poll_Heap_Index);
                 status = true;
             }
             break;
@@ -367,32 +739,28 @@ bool bacnet_data_multistate_present_value(
  */
 void bacnet_data_task(void)
 {
-    static unsigned object_index = 0;
     BACNET_DATA_OBJECT *object = NULL;
-    unsigned i = 0;
-
-    if (mstimer_expired(&Object_Poll_Timer)) {
-        mstimer_reset(&Object_Poll_Timer);
-        for (i = 0; i < BACNET_DATA_OBJECT_MAX; i++) {
-            object = &Object_Table[i];
-            object->refresh = true;
+    unsigned long now;
+
+    /* queue the reads that are due, so that the reads of a device
+       can share ReadPropertyMultiple requests */
+    now = mstimer_now();
+    while ((Poll_Heap_Count > 0) && !bacnet_read_write_busy()) {
+        object = &Object_Table[Poll_Heap[0]];
+        if (!bacnet_data_deadline_passed(object->Poll_Deadline, now)) {
+            break;
         }
+        if (!bacnet_data_object_process(object)) {
+            /* the queue is full - try again later */
+            break;
+        }
+        object->Poll_Deadline = bacnet_data_poll_next(object, now);
+        bacnet_data_heap_update(0);
     }
     if (mstimer_expired(&Read_Write_Timer)) {
         mstimer_reset(&Read_Write_Timer);
         bacnet_read_write_task();
     }
-    if (bacnet_read_write_idle()) {
-        object = &Object_Table[object_index];
-        if (object->refresh) {
-            object->refresh = false;
-            bacnet_data_object_process(object);
-        }
-        object_index++;
-        if (object_index >= BACNET_DATA_OBJECT_MAX) {
-            object_index = 0;
-        }
-    }
 }
 
 /**
@@ -401,7 +769,7 @@ void bacnet_data_task(void)
  */
 void bacnet_data_poll_seconds_set(unsigned int seconds)
 {
-    mstimer_set(&Object_Poll_Timer, seconds * 1000);
+    Poll_Milliseconds = (unsigned long)seconds * 1000UL;
 }
 
 /**
@@ -410,7 +778,103 @@ void bacnet_data_poll_seconds_set(unsigned int seconds)
  */
 unsigned int bacnet_data_poll_seconds(void)
 {
-    return mstimer_interval(&Object_Poll_Timer) * 1000;
+    return Poll_Milliseconds / 1000UL;
+}
+
+/**
+ * @brief Set the lifetime of the COV subscriptions.  The objects are
+ *  subscribed first, and are polled when their device refuses.
+ * @param seconds - number of seconds that a subscription lasts, or 0 to
+ *  poll all the objects
+ */
+void bacnet_data_cov_lifetime_set(uint32_t seconds)
+{
+    Cov_Lifetime = seconds;
+}
+
+/**
+ * @brief Get the lifetime of the COV subscriptions
+ * @return number of seconds that a subscription lasts, or 0 when all
+ *  the objects are polled
+ */
+uint32_t bacnet_data_cov_lifetime(void)
+{
+    return Cov_Lifetime;
+}
+
+/**
+ * @brief Set the polling interval of a BACnet Data remote value point
+ * @param device_id - ID of the destination device
+ * @param object_type - BACnet object type
+ * @param object_instance - Instance # of the object
+ * @param seconds - number of seconds between polls, or 0 for the
+ *  default polling interval
+ * @return true if the point exists
+ */
+bool bacnet_data_object_poll_seconds_set(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    unsigned int seconds)
+{
+    BACNET_DATA_OBJECT *object = NULL;
+    int index = 0;
+
+    index =
+        bacnet_data_object_index_find(device_id, object_type, object_instance);
+    if (index == BACNET_STATUS_ERROR) {
+        return false;
+    }
+    object = &Object_Table[index];
+    object->Poll_Milliseconds = (unsigned long)seconds * 1000UL;
+    object->Poll_Deadline = bacnet_data_poll_next(object, mstimer_now());
+    bacnet_data_heap_update(object->Poll_Heap_Index);
+
+    return true;
+}
+
+/**
+ * @brief Determine if the value of a BACnet Data remote value point is
+ *  stale, because no value was stored for several polling intervals
+ * @param device_id - ID of the destination device
+ * @param object_type - BACnet object type
+ * @param object_instance - Instance # of the object
+ * @return true if the value is stale, or the point does not exist
+ */
+bool bacnet_data_object_stale(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance)
+{
+    int index = 0;
+
+    index =
+        bacnet_data_object_index_find(device_id, object_type, object_instance);
+    if (index == BACNET_STATUS_ERROR) {
+        return true;
+    }
+
+    return bacnet_data_value_stale(&Object_Table[index], mstimer_now());
+}
+
+/**
+ * @brief Get the number of BACnet Data remote value points whose value
+ *  is stale
+ * @return number of points whose value is stale
+ */
+unsigned int bacnet_data_stale_count(void)
+{
+    unsigned long now = mstimer_now();
+    unsigned int count = 0;
+    unsigned i;
+
+    for (i = 0; i < Poll_Heap_Count; i++) {
+        if (bacnet_data_value_stale(&Object_Table[Poll_Heap[i]], now)) {
+            count++;
+        }
+    }
+
+    return count;
 }
 
 /**
@@ -420,8 +884,11 @@ void bacnet_data_init(void)
 {
     bacnet_data_object_init();
     bacnet_read_write_init();
-    /* start the cyclic poll timer */
-    mstimer_set(&Object_Poll_Timer, 1 * 60 * 1000);
     mstimer_set(&Read_Write_Timer, 10);
     bacnet_read_write_value_callback_set(bacnet_data_value_save);
+    /* handle the values of the COV subscriptions */
+    Cov_Notification.callback = bacnet_data_cov_notification;
+    handler_ucov_notification_add(&Cov_Notification);
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_COV_NOTIFICATION, handler_ucov_notification);
 }
@@ -16,6 +16,7 @@
 /* BACnet Stack API */
 #include "bacnet/bactext.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/bacint.h"
 #include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/keylist.h"
@@ -35,17 +36,28 @@ static OS_Keylist Device_List = NULL;
 static BACNET_ADDRESS Target_DEST = { 0 };
 /* re-discovery time */
 static unsigned long Discovery_Milliseconds;
+/* when the discovery started, and the number of replies since then */
+static unsigned long Discovery_Start_Milliseconds;
+static unsigned long Discovery_Replies;
+/* first bytes of a discovery cache file, "BDC" and the format version */
+#define BACNET_DISCOVER_CACHE_MAGIC 0x42444301UL
+/* number of requests that each device has queued at the same time */
+#ifndef BACNET_DISCOVER_DEVICE_REQUESTS_MAX
+#define BACNET_DISCOVER_DEVICE_REQUESTS_MAX 16
+#endif
 /* states of discovery */
 typedef enum bacnet_discover_state_enum {
     BACNET_DISCOVER_STATE_INIT = 0,
-    BACNET_DISCOVER_STATE_BINDING,
-    BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST,
-    BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_RESPONSE,
-    BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST,
-    BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE,
-    BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST,
-    BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE,
-    BACNET_DISCOVER_STATE_OBJECT_NEXT,
+    /* the database-revision and last-restore-time are compared */
+    BACNET_DISCOVER_STATE_DATABASE_REVISION,
+    /* the size of the object-list is requested */
+    BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE,
+    /* the whole object-list is requested */
+    BACNET_DISCOVER_STATE_OBJECT_LIST,
+    /* the elements of the object-list are requested one by one */
+    BACNET_DISCOVER_STATE_OBJECT_LIST_ELEMENTS,
+    /* all the properties of each object are requested */
+    BACNET_DISCOVER_STATE_OBJECT_PROPERTIES,
     BACNET_DISCOVER_STATE_DONE
 } BACNET_DISCOVER_STATE;
 
@@ -65,11 +77,18 @@ typedef struct bacnet_device_data_t {
     OS_Keylist Object_List;
     /* used for discovering device data */
     uint32_t Object_List_Size;
+    /* the next object-list element, or object, to request */
     uint32_t Object_List_Index;
+    /* the request for the object-list, or its size, failed */
+    bool Object_List_Error;
     /* timer and stats */
     struct mstimer Discovery_Timer;
     unsigned long Discovery_Elapsed_Milliseconds;
     BACNET_DISCOVER_STATE Discovery_State;
+    /* the device was discovered at least once */
+    bool Discovered;
+    /* the database of the device changed since it was discovered */
+    bool Database_Changed;
 } BACNET_DEVICE_DATA;
 
 /**
@@ -98,6 +117,39 @@ static BACNET_PROPERTY_DATA *bacnet_property_data_add(OS_Keylist list, KEY key)
     return data;
 }
 
+/**
+ * @brief Store the encoded value of a property
+ * @param data - property data structure
+ * @param application_data - encoded value, or NULL for no value
+ * @param application_data_len - number of bytes of the encoded value
+ * @return true if stored, false if unable to allocate
+ */
+static bool bacnet_property_data_set(
+    BACNET_PROPERTY_DATA *data,
+    const uint8_t *application_data,
+    int application_data_len)
+{
+    if (!application_data || (application_data_len <= 0)) {
+        free(data->application_data);
+        data->application_data = NULL;
+        data->application_data_len = 0;
+        return true;
+    }
+    if (!data->application_data ||
+        (data->application_data_len != application_data_len)) {
+        free(data->application_data);
+        data->application_data_len = 0;
+        data->application_data = calloc(1, application_data_len);
+        if (!data->application_data) {
+            return false;
+        }
+    }
+    data->application_data_len = application_data_len;
+    memcpy(data->application_data, application_data, application_data_len);
+
+    return true;
+}
+
 /**
  * @brief Remove all the property data from the property-list
  * @param list - Keylist to remove the property from
@@ -549,6 +601,75 @@ bool bacnet_discover_object_property_identifier(
     return status;
 }
 
+/**
+ * @brief Get the stored encoded value of a property of the device object
+ * @param device_id - device instance number
+ * @param object_property - property of the device object
+ * @param device_data - Pointer to the device data structure
+ * @return Pointer to the property data, or NULL if not stored
+ */
+static BACNET_PROPERTY_DATA *bacnet_discover_device_property(
+    uint32_t device_id,
+    BACNET_PROPERTY_ID object_property,
+    const BACNET_DEVICE_DATA *device_data)
+{
+    BACNET_OBJECT_DATA *object_data;
+    BACNET_PROPERTY_DATA *property_data = NULL;
+
+    object_data = Keylist_Data(
+        device_data->Object_List, KEY_ENCODE(OBJECT_DEVICE, device_id));
+    if (object_data) {
+        property_data =
+            Keylist_Data(object_data->Property_List, object_property);
+    }
+    if (property_data && !property_data->application_data) {
+        property_data = NULL;
+    }
+
+    return property_data;
+}
+
+/**
+ * @brief Compare a database-revision or last-restore-time of a device
+ *  with the value that was stored when the device was discovered
+ * @param device_id - device instance number
+ * @param object_property - property of the device object
+ * @param application_data - encoded value, or NULL if the read failed
+ * @param application_data_len - number of bytes of the encoded value
+ * @param device_data - Pointer to the device data structure
+ */
+static void bacnet_discover_database_compare(
+    uint32_t device_id,
+    BACNET_PROPERTY_ID object_property,
+    const uint8_t *application_data,
+    int application_data_len,
+    BACNET_DEVICE_DATA *device_data)
+{
+    const BACNET_PROPERTY_DATA *property_data;
+
+    if ((object_property != PROP_DATABASE_REVISION) &&
+        (object_property != PROP_LAST_RESTORE_TIME)) {
+        return;
+    }
+    if (application_data_len <= 0) {
+        application_data = NULL;
+    }
+    property_data = bacnet_discover_device_property(
+        device_id, object_property, device_data);
+    if (!property_data) {
+        if (application_data) {
+            device_data->Database_Changed = true;
+        }
+    } else if (
+        !application_data ||
+        (property_data->application_data_len != application_data_len) ||
+        (memcmp(
+             property_data->application_data, application_data,
+             application_data_len) != 0)) {
+        device_data->Database_Changed = true;
+    }
+}
+
 /**
  * @brief add a ReadProperty reply value from a device object property
  * @param device_id [in] Device instance number where data originated
@@ -575,36 +696,28 @@ static void bacnet_device_object_property_add(
         (rp_data->object_property == PROP_OBJECT_LIST)) {
         if (value->tag == BACNET_APPLICATION_TAG_UNSIGNED_INT) {
             device_data->Object_List_Size = value->type.Unsigned_Int;
-            device_data->Object_List_Index = 0;
-            if (device_data->Discovery_State ==
-                BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST) {
-                device_data->Discovery_State =
-                    BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_RESPONSE;
-            }
         } else if (value->tag == BACNET_APPLICATION_TAG_OBJECT_ID) {
             if (rp_data->array_index <= device_data->Object_List_Size) {
                 object_data = bacnet_object_data_add(
                     device_data->Object_List, value->type.Object_Id.type,
                     value->type.Object_Id.instance);
                 debug_printf(
-                    "add %u object-list[%u] %s-%lu %s.\n", device_id,
-                    device_data->Object_List_Index,
+                    "add %u object-list[%lu] %s-%lu %s.\n", device_id,
+                    (unsigned long)rp_data->array_index,
                     bactext_object_type_name(value->type.Object_Id.type),
                     (unsigned long)value->type.Object_Id.instance,
                     object_data ? "success" : "fail");
-                if (device_data->Discovery_State ==
-                    BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST) {
-                    device_data->Discovery_State =
-                        BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE;
-                }
             }
         }
     } else {
-        /* move to next state */
-        if (device_data->Discovery_State ==
-            BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST) {
-            device_data->Discovery_State =
-                BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
+        if ((device_data->Discovery_State ==
+             BACNET_DISCOVER_STATE_DATABASE_REVISION) &&
+            (rp_data->object_type == OBJECT_DEVICE) &&
+            (rp_data->object_instance == device_id)) {
+            bacnet_discover_database_compare(
+                device_id, rp_data->object_property,
+                rp_data->application_data, rp_data->application_data_len,
+                device_data);
         }
         object_data = bacnet_object_data_add(
             device_data->Object_List, rp_data->object_type,
@@ -626,30 +739,14 @@ static void bacnet_device_object_property_add(
                 bactext_property_name(rp_data->object_property));
             return;
         }
-        if (rp_data->application_data_len > 0) {
-            if (property_data->application_data_len !=
-                rp_data->application_data_len) {
-                free(property_data->application_data);
-                property_data->application_data =
-                    calloc(1, rp_data->application_data_len);
-            }
-            if (property_data->application_data) {
-                property_data->application_data_len =
-                    rp_data->application_data_len;
-                memcpy(
-                    property_data->application_data, rp_data->application_data,
-                    rp_data->application_data_len);
-            } else {
-                debug_fprintf(
-                    stderr, "%s-%u %s property fail to allocate!\n",
-                    bactext_object_type_name(rp_data->object_type),
-                    rp_data->object_instance,
-                    bactext_property_name(rp_data->object_property));
-            }
-        } else {
-            free(property_data->application_data);
-            property_data->application_data = NULL;
-            property_data->application_data_len = 0;
+        if (!bacnet_property_data_set(
+                property_data, rp_data->application_data,
+                rp_data->application_data_len)) {
+            debug_fprintf(
+                stderr, "%s-%u %s property fail to allocate!\n",
+                bactext_object_type_name(rp_data->object_type),
+                rp_data->object_instance,
+                bactext_property_name(rp_data->object_property));
         }
         if (rp_data->array_index == BACNET_ARRAY_ALL) {
             debug_printf(
@@ -692,26 +789,24 @@ static void Device_Error_Handler(
             "%u - %s\n", device_id,
             bactext_error_code_name((int)rp_data->error_code));
         switch (device_data->Discovery_State) {
-            case BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST:
-                /* resend request */
-                if (device_data->Object_List_Index != 0) {
-                    device_data->Object_List_Index--;
+            case BACNET_DISCOVER_STATE_DATABASE_REVISION:
+                if ((rp_data->object_type == OBJECT_DEVICE) &&
+                    (rp_data->object_instance == device_id)) {
+                    bacnet_discover_database_compare(
+                        device_id, rp_data->object_property, NULL, 0,
+                        device_data);
                 }
-                device_data->Discovery_State =
-                    BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE;
                 break;
-            case BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST:
-                if (rp_data->error_code == ERROR_CODE_TIMEOUT) {
-                    /* resend request */
-                    if (device_data->Object_List_Index != 0) {
-                        device_data->Object_List_Index--;
-                    }
-                    device_data->Discovery_State =
-                        BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
-                } else if (
-                    (rp_data->error_code ==
-                     ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED) &&
-                    (rp_data->object_property == PROP_ALL)) {
+            case BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE:
+            case BACNET_DISCOVER_STATE_OBJECT_LIST:
+                device_data->Object_List_Error = true;
+                break;
+            case BACNET_DISCOVER_STATE_OBJECT_PROPERTIES:
+                if ((rp_data->object_property == PROP_ALL) &&
+                    ((rp_data->error_code ==
+                      ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED) ||
+                     (rp_data->error_code ==
+                      ERROR_CODE_REJECT_UNRECOGNIZED_SERVICE))) {
                     /* fallback to ReadProperty required properties */
                     /* FIXME: fill a property-list with properties
                        and use FSM to ReadProperty of each.
@@ -720,21 +815,17 @@ static void Device_Error_Handler(
                         device_id, rp_data->object_type,
                         rp_data->object_instance, PROP_OBJECT_NAME,
                         BACNET_ARRAY_ALL);
-                    if (status) {
-                        device_data->Discovery_State =
-                            BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST;
-                    } else {
-                        /* skip */
-                        device_data->Discovery_State =
-                            BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
+                    if (!status) {
+                        debug_fprintf(
+                            stderr, "%u %s-%u object-name fail to queue!\n",
+                            device_id,
+                            bactext_object_type_name(rp_data->object_type),
+                            (unsigned)rp_data->object_instance);
                     }
-                } else {
-                    /* skip */
-                    device_data->Discovery_State =
-                        BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
                 }
                 break;
             default:
+                /* skip - the device is discovered again later */
                 break;
         }
     }
@@ -762,6 +853,7 @@ static void bacnet_read_property_reply(
     if (!device_data) {
         return;
     }
+    Discovery_Replies++;
     if (rp_data->error_code != ERROR_CODE_SUCCESS) {
         Device_Error_Handler(device_id, rp_data, device_data);
     } else if (value) {
@@ -771,7 +863,46 @@ static void bacnet_read_property_reply(
 }
 
 /**
- * @brief Non-blocking task for running BACnet discover state machine
+ * @brief Finishes the discovery of a device, and schedules it to be
+ *  discovered again
+ * @param device_data - Pointer to the device data structure
+ */
+static void bacnet_discover_device_done(BACNET_DEVICE_DATA *device_data)
+{
+    /* track the duration */
+    device_data->Discovery_Elapsed_Milliseconds =
+        mstimer_elapsed(&device_data->Discovery_Timer);
+    /* rediscover in the future */
+    mstimer_set(&device_data->Discovery_Timer, Discovery_Milliseconds);
+    device_data->Discovered = true;
+    device_data->Discovery_State = BACNET_DISCOVER_STATE_DONE;
+}
+
+/**
+ * @brief Requests the size of the object-list of a device, which starts
+ *  the discovery of its objects
+ * @param device_id - Device ID from discovered device
+ * @param device_data - Pointer to the device data structure
+ */
+static void bacnet_discover_object_list_size_request(
+    uint32_t device_id, BACNET_DEVICE_DATA *device_data)
+{
+    device_data->Object_List_Size = 0;
+    device_data->Object_List_Error = false;
+    if (bacnet_read_property_queue(
+            device_id, OBJECT_DEVICE, device_id, PROP_OBJECT_LIST, 0)) {
+        device_data->Discovery_State = BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE;
+    } else {
+        debug_fprintf(
+            stderr, "%u object-list-size fail to queue!\n", device_id);
+    }
+}
+
+/**
+ * @brief Non-blocking task for running BACnet discover state machine.
+ *  Each device keeps several requests queued, so that the devices
+ *  are discovered at the same time, and the requests to a device
+ *  share ReadPropertyMultiple requests.
  * @param device_id - Device ID from discovered device
  * @param device_data - Pointer to the device data structure
  */
@@ -781,102 +912,148 @@ bacnet_discover_device_fsm(uint32_t device_id, BACNET_DEVICE_DATA *device_data)
     KEY key = 0;
     BACNET_OBJECT_TYPE object_type = 0;
     uint32_t object_instance = 0;
+    unsigned requests;
     bool status = false;
 
     if (!device_data) {
         return;
     }
+    requests = bacnet_read_write_device_requests(device_id);
     switch (device_data->Discovery_State) {
         case BACNET_DISCOVER_STATE_INIT:
+            if (!bacnet_discover_device_property(
+                    device_id, PROP_DATABASE_REVISION, device_data)) {
+                bacnet_discover_object_list_size_request(
+                    device_id, device_data);
+                break;
+            }
+            /* discovered before - only discover it again if it changed */
+            device_data->Database_Changed = false;
+            status = bacnet_read_property_queue(
+                device_id, OBJECT_DEVICE, device_id, PROP_DATABASE_REVISION,
+                BACNET_ARRAY_ALL);
+            if (!status) {
+                debug_fprintf(
+                    stderr, "%u database-revision fail to queue!\n",
+                    device_id);
+                break;
+            }
+            if (!bacnet_read_property_queue(
+                    device_id, OBJECT_DEVICE, device_id, PROP_LAST_RESTORE_TIME,
+                    BACNET_ARRAY_ALL)) {
+                device_data->Database_Changed = true;
+            }
+            device_data->Discovery_State =
+                BACNET_DISCOVER_STATE_DATABASE_REVISION;
+            break;
+        case BACNET_DISCOVER_STATE_DATABASE_REVISION:
+            if (requests > 0) {
+                /* waiting for response */
+                break;
+            }
+            if (device_data->Database_Changed) {
+                bacnet_discover_object_list_size_request(
+                    device_id, device_data);
+            } else {
+                debug_printf("%u database is unchanged.\n", device_id);
+                bacnet_discover_device_done(device_data);
+            }
+            break;
+        case BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE:
+            if (requests > 0) {
+                /* waiting for response */
+                break;
+            }
+            if (device_data->Object_List_Error ||
+                (device_data->Object_List_Size == 0)) {
+                bacnet_discover_device_done(device_data);
+                break;
+            }
+            /* the whole object-list, in a segmented reply if needed */
             status = bacnet_read_property_queue(
-                device_id, OBJECT_DEVICE, device_id, PROP_OBJECT_LIST, 0);
+                device_id, OBJECT_DEVICE, device_id, PROP_OBJECT_LIST,
+                BACNET_ARRAY_ALL);
             if (status) {
                 device_data->Discovery_State =
-                    BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST;
+                    BACNET_DISCOVER_STATE_OBJECT_LIST;
             } else {
                 debug_fprintf(
-                    stderr, "%u object-list-size fail to queue!\n", device_id);
+                    stderr, "%u object-list fail to queue!\n", device_id);
             }
             break;
-        case BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST:
-            /* waiting for response */
-            return;
-        case BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_RESPONSE:
+        case BACNET_DISCOVER_STATE_OBJECT_LIST:
+            if (requests > 0) {
+                /* waiting for response */
+                break;
+            }
             device_data->Object_List_Index = 0;
-            device_data->Discovery_State =
-                BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE;
-            break;
-        case BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST:
-            /* waiting for response */
+            if (device_data->Object_List_Error) {
+                /* too big for the device - request each element */
+                device_data->Discovery_State =
+                    BACNET_DISCOVER_STATE_OBJECT_LIST_ELEMENTS;
+            } else {
+                device_data->Discovery_State =
+                    BACNET_DISCOVER_STATE_OBJECT_PROPERTIES;
+            }
             break;
-        case BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE:
-            device_data->Object_List_Index++;
-            if (device_data->Object_List_Index <=
-                device_data->Object_List_Size) {
+        case BACNET_DISCOVER_STATE_OBJECT_LIST_ELEMENTS:
+            while ((requests < BACNET_DISCOVER_DEVICE_REQUESTS_MAX) &&
+                   (device_data->Object_List_Index <
+                    device_data->Object_List_Size)) {
                 debug_printf(
                     "%u object-list[%u] size=%u.\n", device_id,
-                    device_data->Object_List_Index,
+                    device_data->Object_List_Index + 1,
                     device_data->Object_List_Size);
                 status = bacnet_read_property_queue(
                     device_id, OBJECT_DEVICE, device_id, PROP_OBJECT_LIST,
-                    device_data->Object_List_Index);
-                if (status) {
-                    device_data->Discovery_State =
-                        BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST;
-                    return;
-                } else {
+                    device_data->Object_List_Index + 1);
+                if (!status) {
                     debug_fprintf(
-                        stderr, "%u object-list[%u] %s-%u fail to queue!\n",
-                        device_id, device_data->Object_List_Index,
-                        bactext_object_type_name(object_type),
-                        (unsigned)object_instance);
-                    device_data->Object_List_Index--;
+                        stderr, "%u object-list[%u] fail to queue!\n",
+                        device_id, device_data->Object_List_Index + 1);
+                    break;
                 }
-            } else {
+                device_data->Object_List_Index++;
+                requests++;
+            }
+            if ((requests == 0) &&
+                (device_data->Object_List_Index >=
+                 device_data->Object_List_Size)) {
                 device_data->Object_List_Index = 0;
                 device_data->Discovery_State =
-                    BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
+                    BACNET_DISCOVER_STATE_OBJECT_PROPERTIES;
             }
             break;
-        case BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST:
-            /* waiting for response */
-            break;
-        case BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE:
-            if (device_data->Object_List_Index <
-                device_data->Object_List_Size) {
-                if (Keylist_Index_Key(
-                        device_data->Object_List,
-                        device_data->Object_List_Index, &key)) {
-                    object_type = KEY_DECODE_TYPE(key);
-                    object_instance = KEY_DECODE_ID(key);
-                    debug_printf(
-                        "%u object-list[%u] %s-%u read ALL.\n", device_id,
-                        device_data->Object_List_Index,
-                        bactext_object_type_name(object_type),
-                        (unsigned)object_instance);
-                    status = bacnet_read_property_queue(
-                        device_id, object_type, object_instance, PROP_ALL,
-                        BACNET_ARRAY_ALL);
-                }
-                if (status) {
-                    device_data->Discovery_State =
-                        BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST;
-                    device_data->Object_List_Index++;
-                } else {
+        case BACNET_DISCOVER_STATE_OBJECT_PROPERTIES:
+            while ((requests < BACNET_DISCOVER_DEVICE_REQUESTS_MAX) &&
+                   Keylist_Index_Key(
+                       device_data->Object_List,
+                       device_data->Object_List_Index, &key)) {
+                object_type = KEY_DECODE_TYPE(key);
+                object_instance = KEY_DECODE_ID(key);
+                debug_printf(
+                    "%u object-list[%u] %s-%u read ALL.\n", device_id,
+                    device_data->Object_List_Index,
+                    bactext_object_type_name(object_type),
+                    (unsigned)object_instance);
+                status = bacnet_read_property_queue(
+                    device_id, object_type, object_instance, PROP_ALL,
+                    BACNET_ARRAY_ALL);
+                if (!status) {
                     debug_fprintf(
                         stderr, "%u object-list[%u] %s-%u fail to queue!\n",
                         device_id, device_data->Object_List_Index,
                         bactext_object_type_name(object_type),
                         (unsigned)object_instance);
+                    break;
                 }
-            } else {
-                /* track the duration */
-                device_data->Discovery_Elapsed_Milliseconds =
-                    mstimer_elapsed(&device_data->Discovery_Timer);
-                /* rediscover in the future */
-                mstimer_set(
-                    &device_data->Discovery_Timer, Discovery_Milliseconds);
-                device_data->Discovery_State = BACNET_DISCOVER_STATE_DONE;
+                device_data->Object_List_Index++;
+                requests++;
+            }
+            if ((requests == 0) &&
+                (device_data->Object_List_Index >=
+                 (uint32_t)Keylist_Count(device_data->Object_List))) {
+                bacnet_discover_device_done(device_data);
             }
             break;
         case BACNET_DISCOVER_STATE_DONE:
@@ -895,10 +1072,7 @@ bacnet_discover_device_fsm(uint32_t device_id, BACNET_DEVICE_DATA *device_data)
 }
 
 /**
- * @brief Adds a device to the device list
- * @param device_id - Device ID from discovered device
- * @param src - BACnet address from discovered device
- * @return non-zero device index for device if added or existing
+ * @brief Runs the state machine of each device
  */
 static void bacnet_discover_devices_task(void)
 {
@@ -910,6 +1084,10 @@ static void bacnet_discover_devices_task(void)
 
     device_count = Keylist_Count(Device_List);
     for (device_index = 0; device_index < device_count; device_index++) {
+        if (bacnet_read_write_busy()) {
+            /* the other devices get their turn when the queue empties */
+            break;
+        }
         device_data = Keylist_Data_Index(Device_List, device_index);
         if (!device_data) {
             debug_fprintf(stderr, "device[%u] is NULL!\n", device_index);
@@ -1081,13 +1259,266 @@ void bacnet_discover_task(void)
         mstimer_restart(&WhoIs_Timer);
         Send_WhoIs_To_Network(&Target_DEST, -1, -1);
     }
+    bacnet_discover_devices_task();
     if (mstimer_expired(&Read_Write_Timer)) {
         mstimer_restart(&Read_Write_Timer);
         bacnet_read_write_task();
     }
-    if (bacnet_read_write_idle()) {
-        bacnet_discover_devices_task();
+}
+
+/**
+ * @brief Gets the progress of the discovery of all the devices
+ * @param progress [out] the progress of the discovery
+ */
+void bacnet_discover_progress(BACNET_DISCOVER_PROGRESS *progress)
+{
+    BACNET_DEVICE_DATA *device_data;
+    int device_index, device_count;
+
+    if (!progress) {
+        return;
+    }
+    memset(progress, 0, sizeof(*progress));
+    device_count = Keylist_Count(Device_List);
+    for (device_index = 0; device_index < device_count; device_index++) {
+        device_data = Keylist_Data_Index(Device_List, device_index);
+        if (!device_data) {
+            continue;
+        }
+        progress->devices++;
+        if (device_data->Discovered) {
+            progress->devices_discovered++;
+        }
+        progress->objects += device_data->Object_List_Size;
+        if (device_data->Discovery_State == BACNET_DISCOVER_STATE_DONE) {
+            progress->objects_requested += device_data->Object_List_Size;
+        } else if (
+            device_data->Discovery_State ==
+            BACNET_DISCOVER_STATE_OBJECT_PROPERTIES) {
+            progress->objects_requested += device_data->Object_List_Index;
+        }
+    }
+    progress->replies = Discovery_Replies;
+    progress->milliseconds = mstimer_now() - Discovery_Start_Milliseconds;
+    if (progress->milliseconds > 0) {
+        progress->replies_per_second = (unsigned long)(
+            (Discovery_Replies * 1000ULL) / progress->milliseconds);
+    }
+}
+
+/**
+ * @brief Write a number to a discovery cache file
+ * @param file - file to write
+ * @param value - number to write
+ * @return true if written
+ */
+static bool bacnet_discover_cache_write(FILE *file, uint32_t value)
+{
+    uint8_t buffer[4];
+
+    encode_unsigned32(buffer, value);
+
+    return fwrite(buffer, sizeof(buffer), 1, file) == 1;
+}
+
+/**
+ * @brief Read a number from a discovery cache
+ * @param buffer - contents of the discovery cache file
+ * @param buffer_size - number of bytes in the buffer
+ * @param offset - offset of the number, which is moved past the number
+ * @param value - number that was read
+ * @return true if read, false if the buffer is too short
+ */
+static bool bacnet_discover_cache_read(
+    const uint8_t *buffer, size_t buffer_size, size_t *offset, uint32_t *value)
+{
+    if ((buffer_size < 4) || (*offset > (buffer_size - 4))) {
+        return false;
+    }
+    decode_unsigned32(&buffer[*offset], value);
+    *offset += 4;
+
+    return true;
+}
+
+/**
+ * @brief Save the discovered devices, objects, and properties to a file.
+ *  The file is a sequence of big-endian 32-bit numbers: the magic number
+ *  and device count, then for each device its instance and object count,
+ *  for each object its type, instance, and property count, and for each
+ *  property its identifier and length followed by the encoded value,
+ *  which is padded to a multiple of 4 bytes.
+ * @param pathname - name of the file
+ * @return true if the file was written
+ */
+bool bacnet_discover_save(const char *pathname)
+{
+    static const uint8_t padding[4] = { 0 };
+    const BACNET_DEVICE_DATA *device_data;
+    const BACNET_OBJECT_DATA *object_data;
+    const BACNET_PROPERTY_DATA *property_data;
+    int device_index, object_index, property_index;
+    int device_count, object_count, property_count;
+    size_t length, pad;
+    KEY key;
+    FILE *file;
+    bool status;
+
+    if (!pathname) {
+        return false;
+    }
+    file = fopen(pathname, "wb");
+    if (!file) {
+        return false;
+    }
+    device_count = Keylist_Count(Device_List);
+    status = bacnet_discover_cache_write(file, BACNET_DISCOVER_CACHE_MAGIC) &&
+        bacnet_discover_cache_write(file, device_count);
+    for (device_index = 0; status && (device_index < device_count);
+         device_index++) {
+        device_data = Keylist_Data_Index(Device_List, device_index);
+        status = device_data &&
+            Keylist_Index_Key(Device_List, device_index, &key);
+        if (!status) {
+            break;
+        }
+        object_count = Keylist_Count(device_data->Object_List);
+        status = bacnet_discover_cache_write(file, key) &&
+            bacnet_discover_cache_write(file, object_count);
+        for (object_index = 0; status && (object_index < object_count);
+             object_index++) {
+            object_data =
+                Keylist_Data_Index(device_data->Object_List, object_index);
+            status = object_data &&
+                Keylist_Index_Key(device_data->Object_List, object_index, &key);
+            if (!status) {
+                break;
+            }
+            property_count = Keylist_Count(object_data->Property_List);
+            status = bacnet_discover_cache_write(file, KEY_DECODE_TYPE(key)) &&
+                bacnet_discover_cache_write(file, KEY_DECODE_ID(key)) &&
+                bacnet_discover_cache_write(file, property_count);
+            for (property_index = 0;
+                 status && (property_index < property_count);
+                 property_index++) {
+                property_data = Keylist_Data_Index(
+                    object_data->Property_List, property_index);
+                status = property_data &&
+                    Keylist_Index_Key(
+                        object_data->Property_List, property_index, &key);
+                if (!status) {
+                    break;
+                }
+                length = property_data->application_data_len;
+                pad = (4 - (length % 4)) % 4;
+                status = bacnet_discover_cache_write(file, key) &&
+                    bacnet_discover_cache_write(file, length);
+                if (status && (length > 0)) {
+                    status = (fwrite(
+                                  property_data->application_data, length, 1,
+                                  file) == 1) &&
+                        ((pad == 0) || (fwrite(padding, pad, 1, file) == 1));
+                }
+            }
+        }
+    }
+    if (fclose(file) != 0) {
+        status = false;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Load the devices, objects, and properties that were saved by
+ *  bacnet_discover_save().  Each device is refreshed later when its
+ *  database-revision or last-restore-time has changed.
+ * @param pathname - name of the file
+ * @return true if the file was loaded
+ */
+bool bacnet_discover_load(const char *pathname)
+{
+    BACNET_DEVICE_DATA *device_data;
+    BACNET_OBJECT_DATA *object_data;
+    BACNET_PROPERTY_DATA *property_data;
+    uint32_t device_count = 0, object_count = 0, property_count = 0;
+    uint32_t magic = 0, device_id = 0, object_type = 0, object_instance = 0;
+    uint32_t property_id = 0, length = 0;
+    uint8_t *buffer = NULL;
+    size_t buffer_size = 0, offset = 0;
+    long file_size;
+    FILE *file;
+    bool status = false;
+
+    if (!pathname || !Device_List) {
+        return false;
+    }
+    file = fopen(pathname, "rb");
+    if (!file) {
+        return false;
     }
+    if ((fseek(file, 0, SEEK_END) == 0) && ((file_size = ftell(file)) > 0) &&
+        (fseek(file, 0, SEEK_SET) == 0)) {
+        buffer_size = (size_t)file_size;
+        buffer = malloc(buffer_size);
+        if (buffer && (fread(buffer, buffer_size, 1, file) == 1)) {
+            status = true;
+        }
+    }
+    fclose(file);
+    status = status &&
+        bacnet_discover_cache_read(buffer, buffer_size, &offset, &magic) &&
+        (magic == BACNET_DISCOVER_CACHE_MAGIC) &&
+        bacnet_discover_cache_read(buffer, buffer_size, &offset, &device_count);
+    while (status && (device_count > 0)) {
+        device_count--;
+        status = bacnet_discover_cache_read(
+                     buffer, buffer_size, &offset, &device_id) &&
+            bacnet_discover_cache_read(
+                     buffer, buffer_size, &offset, &object_count);
+        device_data = bacnet_device_data_add(device_id);
+        if (status && device_data) {
+            device_data->Object_List_Size = object_count;
+            device_data->Discovered = true;
+        }
+        while (status && (object_count > 0)) {
+            object_count--;
+            status = bacnet_discover_cache_read(
+                         buffer, buffer_size, &offset, &object_type) &&
+                bacnet_discover_cache_read(
+                         buffer, buffer_size, &offset, &object_instance) &&
+                bacnet_discover_cache_read(
+                         buffer, buffer_size, &offset, &property_count);
+            object_data = NULL;
+            if (status && device_data) {
+                object_data = bacnet_object_data_add(
+                    device_data->Object_List, (BACNET_OBJECT_TYPE)object_type,
+                    object_instance);
+            }
+            while (status && (property_count > 0)) {
+                property_count--;
+                status = bacnet_discover_cache_read(
+                             buffer, buffer_size, &offset, &property_id) &&
+                    bacnet_discover_cache_read(
+                             buffer, buffer_size, &offset, &length) &&
+                    (length <= (buffer_size - offset));
+                if (status && object_data) {
+                    property_data = bacnet_property_data_add(
+                        object_data->Property_List, property_id);
+                    if (property_data) {
+                        bacnet_property_data_set(
+                            property_data, &buffer[offset], (int)length);
+                    }
+                }
+                if (status) {
+                    offset += length + ((4 - (length % 4)) % 4);
+                }
+            }
+        }
+    }
+    free(buffer);
+
+    return status;
 }
 
 /**
@@ -1213,6 +1644,8 @@ void bacnet_discover_device_add(
 void bacnet_discover_init(void)
 {
     Device_List = Keylist_Create();
+    Discovery_Start_Milliseconds = mstimer_now();
+    Discovery_Replies = 0;
     bacnet_read_write_init();
     /* default value in case it is not set */
     if (!mstimer_interval(&WhoIs_Timer)) {
@@ -36,6 +36,24 @@ typedef bool (*bacnet_discover_device_callback)(
     BACNET_READ_PROPERTY_DATA *rp_data,
     void *context_data);
 
+/* progress of the discovery of all the devices */
+typedef struct bacnet_discover_progress_t {
+    /* number of devices that were found */
+    unsigned devices;
+    /* number of devices that were discovered at least once */
+    unsigned devices_discovered;
+    /* number of objects in the object-lists of the devices */
+    unsigned long objects;
+    /* number of objects whose properties were requested */
+    unsigned long objects_requested;
+    /* number of values and errors that were received */
+    unsigned long replies;
+    /* milliseconds since the discovery started */
+    unsigned long milliseconds;
+    /* throughput of the discovery */
+    unsigned long replies_per_second;
+} BACNET_DISCOVER_PROGRESS;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -103,6 +121,13 @@ bool bacnet_discover_device_iterate(
 
 BACNET_STACK_EXPORT
 void bacnet_discover_task(void);
+BACNET_STACK_EXPORT
+void bacnet_discover_progress(BACNET_DISCOVER_PROGRESS *progress);
+
+BACNET_STACK_EXPORT
+bool bacnet_discover_save(const char *pathname);
+BACNET_STACK_EXPORT
+bool bacnet_discover_load(const char *pathname);
 
 BACNET_STACK_EXPORT
 void bacnet_discover_dnet_set(uint16_t dnet);
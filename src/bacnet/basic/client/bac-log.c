@@ -0,0 +1,471 @@
+/**
+ * @file
+ * @brief Read the records of logs in other BACnet devices, by sequence
+ *  number, with several ReadRange requests of a log waiting for a reply
+ *  at the same time
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/bacdcode.h"
+#include "bacnet/readrange.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/client/bac-rw.h"
+/* me */
+#include "bacnet/basic/client/bac-log.h"
+
+/* local storage - keeps it off the c-stack */
+static BACNET_LOG_RECORD Log_Record;
+
+static void bacnet_log_read_next(BACNET_LOG_READ *log);
+
+/**
+ * @brief Get the length of the first record of a list of encoded log
+ *  records
+ * @details The records of every log type are a sequence of context
+ *  tagged elements in increasing tag number order, so the next record
+ *  starts with a tag that is not higher than the one before it.
+ * @param apdu [in] the encoded records
+ * @param apdu_size [in] number of octets of the encoded records
+ * @return length of the first record, or BACNET_STATUS_ERROR
+ */
+static int bacnet_log_read_record_length(const uint8_t *apdu, size_t apdu_size)
+{
+    BACNET_TAG_ITERATOR iter;
+    BACNET_TAG_VIEW view;
+    uint32_t offset = 0;
+    uint8_t tag_number = 0;
+    bool first = true;
+
+    bacnet_tag_iterator_init(&iter, apdu, (uint32_t)apdu_size);
+    for (;;) {
+        offset = iter.offset;
+        if (!bacnet_tag_iterator_next(&iter, &view)) {
+            break;
+        }
+        if (!first && (view.tag.number <= tag_number)) {
+            /* the tag of the next record */
+            break;
+        }
+        first = false;
+        tag_number = view.tag.number;
+        if (view.tag.opening && !bacnet_tag_iterator_skip(&iter)) {
+            return BACNET_STATUS_ERROR;
+        }
+    }
+    if (iter.error || first) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return (int)offset;
+}
+
+/**
+ * @brief Get the number of records to request with one ReadRange, so
+ *  that the ReadRange-ACK fits in the APDU of the device
+ * @param log [in] the read of the log
+ * @return number of records, at least 1
+ */
+static uint32_t bacnet_log_read_window_size(const BACNET_LOG_READ *log)
+{
+    BACNET_ADDRESS dest = { 0 };
+    unsigned max_apdu = 0;
+    size_t size = 0;
+
+    if (!address_get_by_device(log->device_id, &max_apdu, &dest) ||
+        (max_apdu > MAX_APDU)) {
+        max_apdu = MAX_APDU;
+    }
+    if (max_apdu > (RR_OVERHEAD + RR_1ST_SEQ_OVERHEAD)) {
+        size = max_apdu - (RR_OVERHEAD + RR_1ST_SEQ_OVERHEAD);
+    }
+    size /= log->record_size;
+    if (size < 1) {
+        size = 1;
+    }
+
+    return (uint32_t)size;
+}
+
+/**
+ * @brief Notes the failure of the read of a log, where the first error
+ *  is the one that is given to the done callback
+ * @param log [in] the read of the log
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void bacnet_log_read_error(
+    BACNET_LOG_READ *log,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    if (!log->error_detected) {
+        log->error_detected = true;
+        log->error_class = error_class;
+        log->error_code = error_code;
+    }
+}
+
+/**
+ * @brief Finishes the read of a log, and tells the reader where the next
+ *  read resumes
+ * @param log [in] the read of the log
+ */
+static void bacnet_log_read_finish(BACNET_LOG_READ *log)
+{
+    unsigned i;
+
+    log->sequence_next = bacnet_log_read_sequence(log);
+    for (i = 0; i < BACNET_LOG_READ_WINDOWS_MAX; i++) {
+        log->window[i].sequence_number = 0;
+        log->window[i].sequence_end = 0;
+        log->window[i].active = false;
+        log->window[i].failed = false;
+    }
+    log->busy = false;
+    if (!log->error_detected) {
+        log->error_class = ERROR_CLASS_SERVICES;
+        log->error_code = ERROR_CODE_SUCCESS;
+    }
+    if (log->done_callback) {
+        log->done_callback(
+            log->context, log->sequence_next, log->error_class,
+            log->error_code);
+    }
+}
+
+/**
+ * @brief Gives the records of a ReadRange-ACK to the reader, straight
+ *  from the received message
+ * @param log [in] the read of the log
+ * @param data [in] the ReadRange-ACK
+ * @return number of records that were given
+ */
+static uint32_t bacnet_log_read_records(
+    const BACNET_LOG_READ *log, const BACNET_READ_RANGE_DATA *data)
+{
+    BACNET_LOG_READ_RECORD record = { 0 };
+    const uint8_t *apdu = data->application_data;
+    size_t apdu_len = 0;
+    uint32_t i;
+    int len;
+
+    if (data->application_data_len > 0) {
+        apdu_len = (size_t)data->application_data_len;
+    }
+    record.device_id = log->device_id;
+    record.object_type = log->object_type;
+    record.object_instance = log->object_instance;
+    for (i = 0; i < data->ItemCount; i++) {
+        len = bacnet_log_read_record_length(apdu, apdu_len);
+        if (len <= 0) {
+            break;
+        }
+        record.sequence_number = data->FirstSequence + i;
+        record.apdu = apdu;
+        record.apdu_len = (size_t)len;
+        record.log_record = NULL;
+        if ((log->object_type == OBJECT_TRENDLOG) &&
+            (bacnet_log_record_decode(apdu, (size_t)len, &Log_Record) > 0)) {
+            record.log_record = &Log_Record;
+        }
+        if (log->record_callback) {
+            log->record_callback(log->context, &record);
+        }
+        apdu += len;
+        apdu_len -= (size_t)len;
+    }
+
+    return i;
+}
+
+/**
+ * @brief Handles the ReadRange-ACK, or the failure, of a range of records
+ * @param context [in] the range of records
+ * @param device_instance [in] device instance number where data originated
+ * @param data [in] the ReadRange-ACK, or the failure
+ */
+static void bacnet_log_read_ack(
+    void *context, uint32_t device_instance, BACNET_READ_RANGE_DATA *data)
+{
+    struct bacnet_log_read_window *window = context;
+    BACNET_LOG_READ *log = window->log;
+    uint32_t count, sequence_number;
+
+    (void)device_instance;
+    window->active = false;
+    if (data->error_code != ERROR_CODE_SUCCESS) {
+        window->failed = true;
+        bacnet_log_read_error(log, data->error_class, data->error_code);
+    } else if (data->ItemCount > 0) {
+        count = bacnet_log_read_records(log, data);
+        sequence_number = data->FirstSequence + count;
+        if (count < data->ItemCount) {
+            /* the rest of the range is read again by the next read */
+            window->sequence_number = sequence_number;
+            window->failed = true;
+            bacnet_log_read_error(
+                log, ERROR_CLASS_SERVICES, ERROR_CODE_INVALID_DATA_ENCODING);
+        } else {
+            log->record_size =
+                ((size_t)data->application_data_len + count - 1) / count;
+            if (log->record_size == 0) {
+                log->record_size = BACNET_LOG_READ_RECORD_SIZE;
+            }
+            if ((sequence_number < window->sequence_end) &&
+                bitstring_bit(&data->ResultFlags, RESULT_FLAG_MORE_ITEMS)) {
+                /* the rest of the range did not fit in the ACK */
+                window->sequence_number = sequence_number;
+            } else {
+                window->sequence_number = window->sequence_end;
+            }
+        }
+    } else {
+        /* the records of the range are no longer in the log */
+        window->sequence_number = window->sequence_end;
+    }
+    bacnet_log_read_next(log);
+}
+
+/**
+ * @brief Handles the Record_Count or Total_Record_Count of a log, which
+ *  bound the records that the read requests
+ * @param context [in] the read of the log
+ * @param device_instance [in] device instance number where data originated
+ * @param rp_data [in] the property, and the error when the read failed
+ * @param value [in] the value, or NULL when the read failed
+ */
+static void bacnet_log_read_count(
+    void *context,
+    uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_LOG_READ *log = context;
+    uint32_t sequence_oldest = 1;
+
+    (void)device_instance;
+    if (value && (value->tag == BACNET_APPLICATION_TAG_UNSIGNED_INT)) {
+        if (rp_data->object_property == PROP_RECORD_COUNT) {
+            log->record_count = (uint32_t)value->type.Unsigned_Int;
+        } else {
+            log->total_record_count = (uint32_t)value->type.Unsigned_Int;
+        }
+    } else if (value) {
+        bacnet_log_read_error(
+            log, ERROR_CLASS_PROPERTY, ERROR_CODE_INVALID_DATA_TYPE);
+    } else {
+        bacnet_log_read_error(log, rp_data->error_class, rp_data->error_code);
+    }
+    if (log->reads > 0) {
+        log->reads--;
+    }
+    if (log->reads > 0) {
+        return;
+    }
+    if (!log->error_detected) {
+        log->sequence_last = log->total_record_count;
+        if (log->record_count <= log->total_record_count) {
+            sequence_oldest =
+                log->total_record_count - log->record_count + 1;
+        }
+        if ((log->sequence_next < sequence_oldest) ||
+            (log->sequence_next > (log->sequence_last + 1))) {
+            /* the records were overwritten, or the log started over */
+            log->sequence_next = sequence_oldest;
+        }
+    }
+    bacnet_log_read_next(log);
+}
+
+/**
+ * @brief Requests the next ranges of records of a log, for as many
+ *  ranges as may wait for a reply, and finishes the read of the log when
+ *  no range is waiting for a reply
+ * @param log [in] the read of the log
+ */
+static void bacnet_log_read_next(BACNET_LOG_READ *log)
+{
+    struct bacnet_log_read_window *window;
+    unsigned active = 0, i;
+    uint32_t count;
+    bool queued = true;
+
+    if (log->reads > 0) {
+        return;
+    }
+    for (i = 0; i < BACNET_LOG_READ_WINDOWS_MAX; i++) {
+        window = &log->window[i];
+        if (window->active) {
+            active++;
+            continue;
+        }
+        if (!queued || log->error_detected || window->failed) {
+            continue;
+        }
+        if (window->sequence_number == window->sequence_end) {
+            if (log->sequence_next > log->sequence_last) {
+                continue;
+            }
+            count = bacnet_log_read_window_size(log);
+            if (count > (log->sequence_last - log->sequence_next + 1)) {
+                count = log->sequence_last - log->sequence_next + 1;
+            }
+            window->sequence_number = log->sequence_next;
+            window->sequence_end = log->sequence_next + count;
+            log->sequence_next = window->sequence_end;
+        }
+        queued = bacnet_read_range_queue_callback(
+            log->device_id, log->object_type, log->object_instance,
+            PROP_LOG_BUFFER, window->sequence_number,
+            (int32_t)(window->sequence_end - window->sequence_number),
+            bacnet_log_read_ack, window);
+        if (queued) {
+            window->active = true;
+            active++;
+        }
+    }
+    if (active > 0) {
+        return;
+    }
+    if (!queued) {
+        /* the queue is full, and no range is waiting for a reply */
+        for (i = 0; i < BACNET_LOG_READ_WINDOWS_MAX; i++) {
+            window = &log->window[i];
+            if (window->sequence_number != window->sequence_end) {
+                window->failed = true;
+            }
+        }
+        bacnet_log_read_error(log, ERROR_CLASS_RESOURCES, ERROR_CODE_BUSY);
+    }
+    bacnet_log_read_finish(log);
+}
+
+/**
+ * @brief Sets up the read of a log
+ * @param log [in] the read of the log, which is owned by the reader and
+ *  stays in place while the read is busy
+ * @param device_id [in] device instance of the device of the log
+ * @param object_type [in] OBJECT_TRENDLOG, OBJECT_EVENT_LOG,
+ *  OBJECT_TREND_LOG_MULTIPLE, or OBJECT_AUDIT_LOG
+ * @param object_instance [in] object instance of the log
+ * @param record_callback [in] function that gets each record
+ * @param done_callback [in] function that is called when a read finishes
+ * @param context [in] context that is given to the callbacks
+ */
+void bacnet_log_read_init(
+    BACNET_LOG_READ *log,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    bacnet_log_read_record_callback_t record_callback,
+    bacnet_log_read_done_callback_t done_callback,
+    void *context)
+{
+    unsigned i;
+
+    if (!log) {
+        return;
+    }
+    memset(log, 0, sizeof(*log));
+    log->device_id = device_id;
+    log->object_type = object_type;
+    log->object_instance = object_instance;
+    log->record_size = BACNET_LOG_READ_RECORD_SIZE;
+    log->record_callback = record_callback;
+    log->done_callback = done_callback;
+    log->context = context;
+    for (i = 0; i < BACNET_LOG_READ_WINDOWS_MAX; i++) {
+        log->window[i].log = log;
+    }
+}
+
+/**
+ * @brief Starts to read the records of a log, from a sequence number up
+ *  to the newest record of the log when the read starts.
+ * @details The Record_Count and Total_Record_Count of the log are read
+ *  first, then the records are read with ReadRange requests by sequence
+ *  number that are sized to fit the APDU of the device.  Each record is
+ *  given to the record callback from the received message, so the
+ *  records of different ranges may come out of order; the sequence
+ *  number of each record tells where it goes.  The done callback gives
+ *  the sequence number where the next read resumes, which is after the
+ *  last record when every range was read.
+ * @param log [in] the read of the log, from bacnet_log_read_init()
+ * @param sequence_number [in] sequence number of the first wanted record,
+ *  usually the one after the last record that was read, or 0 for the
+ *  oldest record of the log
+ * @return true if the read was started, and the done callback is called
+ *  when it finishes
+ */
+bool bacnet_log_read_start(BACNET_LOG_READ *log, uint32_t sequence_number)
+{
+    if (!log || log->busy) {
+        return false;
+    }
+    log->sequence_next = sequence_number;
+    log->sequence_last = 0;
+    log->record_count = 0;
+    log->total_record_count = 0;
+    log->error_detected = false;
+    log->error_class = ERROR_CLASS_SERVICES;
+    log->error_code = ERROR_CODE_SUCCESS;
+    if (!bacnet_read_property_queue_callback(
+            log->device_id, log->object_type, log->object_instance,
+            PROP_RECORD_COUNT, BACNET_ARRAY_ALL, bacnet_log_read_count,
+            log)) {
+        return false;
+    }
+    log->busy = true;
+    log->reads = 1;
+    if (bacnet_read_property_queue_callback(
+            log->device_id, log->object_type, log->object_instance,
+            PROP_TOTAL_RECORD_COUNT, BACNET_ARRAY_ALL, bacnet_log_read_count,
+            log)) {
+        log->reads++;
+    } else {
+        /* the read fails when the Record_Count comes back */
+        bacnet_log_read_error(log, ERROR_CLASS_RESOURCES, ERROR_CODE_BUSY);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Determines if the read of a log has not finished
+ * @param log [in] the read of the log
+ * @return true if the read has not finished
+ */
+bool bacnet_log_read_busy(const BACNET_LOG_READ *log)
+{
+    return log && log->busy;
+}
+
+/**
+ * @brief Get the sequence number where the next read of a log resumes.
+ *  While the read is busy, this is the first record of the ranges that
+ *  have not been read.
+ * @param log [in] the read of the log
+ * @return sequence number of the first record that was not read
+ */
+uint32_t bacnet_log_read_sequence(const BACNET_LOG_READ *log)
+{
+    uint32_t sequence_number;
+    unsigned i;
+
+    if (!log) {
+        return 0;
+    }
+    sequence_number = log->sequence_next;
+    for (i = 0; i < BACNET_LOG_READ_WINDOWS_MAX; i++) {
+        if ((log->window[i].sequence_number !=
+             log->window[i].sequence_end) &&
+            (log->window[i].sequence_number < sequence_number)) {
+            sequence_number = log->window[i].sequence_number;
+        }
+    }
+
+    return sequence_number;
+}
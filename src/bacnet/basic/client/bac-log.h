@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief API to read the records of logs in other BACnet devices
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_LOG_READ_H
+#define BACNET_BASIC_CLIENT_LOG_READ_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/baclog.h"
+
+/* number of ReadRange requests of one log that wait for a reply at the
+   same time. The read-write client sends only as many to one device as
+   bacnet_read_write_requests_max_set() allows. */
+#ifndef BACNET_LOG_READ_WINDOWS_MAX
+#define BACNET_LOG_READ_WINDOWS_MAX 4
+#endif
+/* number of octets that an encoded record is expected to take, until
+   the first ReadRange-ACK of a log tells */
+#ifndef BACNET_LOG_READ_RECORD_SIZE
+#define BACNET_LOG_READ_RECORD_SIZE 24
+#endif
+
+/* a record of a log, as it is received */
+typedef struct bacnet_log_read_record {
+    uint32_t device_id;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    uint32_t sequence_number;
+    /* the encoded record, in the received message */
+    const uint8_t *apdu;
+    size_t apdu_len;
+    /* the decoded record of a Trend Log, or NULL for the other logs */
+    const BACNET_LOG_RECORD *log_record;
+} BACNET_LOG_READ_RECORD;
+
+/**
+ * Give a record of a log to the reader
+ *
+ * @param context [in] context that was given to bacnet_log_read_init()
+ * @param record [in] the record, which is only valid during the call
+ */
+typedef void (*bacnet_log_read_record_callback_t)(
+    void *context, const BACNET_LOG_READ_RECORD *record);
+
+/**
+ * Tell the reader that a read of a log has finished
+ *
+ * @param context [in] context that was given to bacnet_log_read_init()
+ * @param sequence_number [in] sequence number of the first record that
+ *  was not read, where the next read of the log resumes
+ * @param error_class [in] the error class, when the read failed
+ * @param error_code [in] ERROR_CODE_SUCCESS, or the error code
+ */
+typedef void (*bacnet_log_read_done_callback_t)(
+    void *context,
+    uint32_t sequence_number,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code);
+
+/* a range of records that is requested with one ReadRange request */
+struct bacnet_log_read_window {
+    struct bacnet_log_read *log;
+    /* sequence number of the first record, and of the one after the last */
+    uint32_t sequence_number;
+    uint32_t sequence_end;
+    bool active;
+    /* the range was not read, and the next read resumes with it */
+    bool failed;
+};
+
+/* the state of a read of one log, owned by the reader */
+typedef struct bacnet_log_read {
+    uint32_t device_id;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    bool busy;
+    /* the Record_Count and Total_Record_Count that are still awaited */
+    unsigned reads;
+    uint32_t record_count;
+    uint32_t total_record_count;
+    /* sequence number of the next record to request, and of the last */
+    uint32_t sequence_next;
+    uint32_t sequence_last;
+    /* octets that an encoded record takes, from the last ACK */
+    size_t record_size;
+    bool error_detected;
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+    struct bacnet_log_read_window window[BACNET_LOG_READ_WINDOWS_MAX];
+    bacnet_log_read_record_callback_t record_callback;
+    bacnet_log_read_done_callback_t done_callback;
+    void *context;
+} BACNET_LOG_READ;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_log_read_init(
+    BACNET_LOG_READ *log,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    bacnet_log_read_record_callback_t record_callback,
+    bacnet_log_read_done_callback_t done_callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_log_read_start(BACNET_LOG_READ *log, uint32_t sequence_number);
+BACNET_STACK_EXPORT
+bool bacnet_log_read_busy(const BACNET_LOG_READ *log);
+BACNET_STACK_EXPORT
+uint32_t bacnet_log_read_sequence(const BACNET_LOG_READ *log);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -10,16 +10,21 @@
 #include <stdlib.h>
 #include "bacnet/abort.h"
 #include "bacnet/apdu.h"
+#include "bacnet/cov.h"
 #include "bacnet/iam.h"
+#include "bacnet/readrange.h"
 #include "bacnet/reject.h"
 #include "bacnet/rp.h"
+#include "bacnet/rpm.h"
 #include "bacnet/wp.h"
+#include "bacnet/wpm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/binding/address.h"
 #include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/object/device.h"
-#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/slab.h"
 #include "bacnet/basic/tsm/tsm.h"
 /* me */
 #include "bacnet/basic/client/bac-rw.h"
@@ -27,30 +32,16 @@
 /* timer for address cache */
 static struct mstimer Cache_Timer;
 #define CACHE_CYCLE_SECONDS 60
-/* timeout timer for read-write task */
-static struct mstimer Read_Write_Timer;
-/* where the data from the read is stored */
-static bacnet_read_write_value_callback_t bacnet_read_write_value_callback;
-/* where the data from the I-Am is called */
-static bacnet_read_write_device_callback_t bacnet_read_write_device_callback;
-
-/* states for client task */
-typedef enum {
-    BACNET_CLIENT_IDLE,
-    BACNET_CLIENT_BIND,
-    BACNET_CLIENT_BINDING,
-    BACNET_CLIENT_SEND,
-    BACNET_CLIENT_WAITING,
-    BACNET_CLIENT_FINISHED
-} BACNET_CLIENT_STATE;
-/* data queue */
+
+/* a queued request */
 typedef struct target_data_t {
     bool write_property;
+    bool subscribe_cov;
     uint32_t device_id;
     uint32_t object_instance;
     BACNET_OBJECT_TYPE object_type;
     BACNET_PROPERTY_ID object_property;
-    int32_t array_index;
+    BACNET_ARRAY_INDEX array_index;
     uint8_t priority;
     /* application tag data type for writing */
     uint8_t tag;
@@ -62,25 +53,247 @@ typedef struct target_data_t {
         uint32_t Unsigned_Int;
         int32_t Signed_Int;
     } type;
+    /* seconds that a COV subscription lasts */
+    uint32_t lifetime;
+    /* a ReadRange request by sequence number, for range_count items
+       starting with range_sequence */
+    bool read_range;
+    uint32_t range_sequence;
+    int32_t range_count;
+    /* where the ReadRange-ACK, or the failure, of a ReadRange is given */
+    bacnet_read_range_result_callback_t range_callback;
+    /* where the result is given, or NULL for the value callback */
+    bacnet_read_write_result_callback_t callback;
+    void *context;
+    /* the invoke id and the device address are needed to filter
+       incoming messages */
+    uint8_t invoke_id;
+    /* the next request waiting for a reply with the same invoke id,
+       which is only unique for each device */
+    struct target_data_t *invoke_next;
+    bool error_detected;
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+    /* limits the time spent waiting for a free invoke id */
+    bool send_retry;
+    struct mstimer send_timer;
+    struct target_device_t *device;
+    struct target_data_t *next;
+    /* the other requests that share a ReadPropertyMultiple
+       or WritePropertyMultiple request */
+    struct target_data_t *batch;
+    /* the write was not performed, because an earlier write of the
+       shared request failed */
+    bool resend;
 } TARGET_DATA;
-#define TARGET_DATA_QUEUE_SIZE (sizeof(struct target_data_t))
-/* count must be a power of 2 for ringbuf library */
+/* a device with queued requests, or with requests waiting for a reply */
+typedef struct target_device_t {
+    uint32_t device_id;
+    BACNET_ADDRESS address;
+    unsigned max_apdu;
+    /* number of reads that may share a ReadPropertyMultiple request */
+    unsigned rpm_max;
+    /* number of writes that may share a WritePropertyMultiple request */
+    unsigned wpm_max;
+    /* queued writes wait with the timer for more writes to share them */
+    bool write_window;
+    struct mstimer write_timer;
+    bool bound;
+    /* a Who-Is was sent, and the binding times out with the timer */
+    bool binding;
+    struct mstimer bind_timer;
+    /* number of requests that are waiting for a reply */
+    unsigned active;
+    /* number of requests that are queued or waiting for a reply */
+    unsigned requests;
+    /* requests in the order they were queued */
+    TARGET_DATA *head;
+    TARGET_DATA *tail;
+    /* the context that queued the requests */
+    BACNET_READ_WRITE_CONTEXT *rw_context;
+} TARGET_DEVICE;
+/* number of requests that are allocated when the queue grows */
 #ifndef TARGET_DATA_QUEUE_COUNT
 #define TARGET_DATA_QUEUE_COUNT 8
 #endif
-static TARGET_DATA Target_Data_Buffer[TARGET_DATA_QUEUE_COUNT];
-static RING_BUFFER Target_Data_Queue;
-/* local storage - keeps it off the c-stack */
-static BACNET_APPLICATION_DATA_VALUE Target_Decoded_Property_Value;
-/* the invoke id is needed to filter incoming messages */
-static uint8_t Request_Invoke_ID;
-static BACNET_ADDRESS Target_Address;
-static uint32_t Target_Device_ID;
-static uint16_t Target_Vendor_ID;
-static bool Error_Detected = false;
-static BACNET_ERROR_CLASS Error_Class;
-static BACNET_ERROR_CODE Error_Code;
-static BACNET_CLIENT_STATE RW_State = BACNET_CLIENT_IDLE;
+/* number of requests that wait for a reply at the same time */
+#ifndef BACNET_READ_WRITE_REQUESTS_MAX
+#define BACNET_READ_WRITE_REQUESTS_MAX 16
+#endif
+/* number of requests to one device that wait for a reply at the same time */
+#ifndef BACNET_READ_WRITE_DEVICE_REQUESTS_MAX
+#define BACNET_READ_WRITE_DEVICE_REQUESTS_MAX 1
+#endif
+/* number of reads that may share a ReadPropertyMultiple request,
+   or 1 to send each read as a ReadProperty request */
+#ifndef BACNET_READ_WRITE_RPM_PROPERTIES_MAX
+#define BACNET_READ_WRITE_RPM_PROPERTIES_MAX 16
+#endif
+/* number of bytes that the value of a read is expected to add to the
+   ReadPropertyMultiple-ACK, beyond its property reference */
+#ifndef BACNET_READ_WRITE_RPM_VALUE_SIZE
+#define BACNET_READ_WRITE_RPM_VALUE_SIZE 16
+#endif
+#if BACNET_READ_WRITE_RPM_PROPERTIES_MAX < 1
+#error "BACNET_READ_WRITE_RPM_PROPERTIES_MAX must be >= 1"
+#endif
+/* number of writes that may share a WritePropertyMultiple request,
+   or 1 to send each write as a WriteProperty request */
+#ifndef BACNET_READ_WRITE_WPM_PROPERTIES_MAX
+#define BACNET_READ_WRITE_WPM_PROPERTIES_MAX 16
+#endif
+#if BACNET_READ_WRITE_WPM_PROPERTIES_MAX < 1
+#error "BACNET_READ_WRITE_WPM_PROPERTIES_MAX must be >= 1"
+#endif
+/* milliseconds between the Who-Is broadcasts that bind devices */
+#ifndef BACNET_READ_WRITE_WHOIS_MILLISECONDS
+#define BACNET_READ_WRITE_WHOIS_MILLISECONDS 100
+#endif
+/* largest gap between the device instances that share a ranged Who-Is */
+#ifndef BACNET_READ_WRITE_WHOIS_GAP
+#define BACNET_READ_WRITE_WHOIS_GAP 16
+#endif
+/* seconds that the requests to a device that could not be bound fail
+   without a Who-Is, doubled for each failure up to the maximum */
+#ifndef BACNET_READ_WRITE_BIND_BACKOFF_SECONDS
+#define BACNET_READ_WRITE_BIND_BACKOFF_SECONDS 10
+#endif
+#ifndef BACNET_READ_WRITE_BIND_BACKOFF_SECONDS_MAX
+#define BACNET_READ_WRITE_BIND_BACKOFF_SECONDS_MAX 600
+#endif
+/* subscriber process identifier of the COV subscriptions */
+#ifndef BACNET_READ_WRITE_COV_PROCESS_ID
+#define BACNET_READ_WRITE_COV_PROCESS_ID 1
+#endif
+/* room for the NPDU and APDU headers of a WritePropertyMultiple request */
+#define TARGET_WPM_HEADER_SIZE 32
+/* a device that could not be bound, and when it may be tried again */
+typedef struct target_bind_failure_t {
+    unsigned long seconds;
+    struct mstimer timer;
+} TARGET_BIND_FAILURE;
+/* the state of an independent set of requests, with its own queue,
+   request limits, and callbacks.  All of the contexts share the TSM,
+   so a context gets its invoke ids from the same transactions. */
+struct bacnet_read_write_context {
+    SLAB_TYPE Data_Slab;
+    unsigned Requests_Max;
+    unsigned Device_Requests_Max;
+    /* devices with requests, by device instance */
+    OS_Keylist Device_List;
+    /* device that is served first by the next task */
+    int Device_Next;
+    /* true when a device might have no more requests */
+    bool Device_Sweep;
+    /* devices that could not be bound, by device instance */
+    OS_Keylist Bind_Failure_List;
+    /* the next Who-Is waits for the timer */
+    bool WhoIs_Wait;
+    struct mstimer WhoIs_Timer;
+    /* number of queued requests that have not been sent */
+    size_t Queue_Count;
+    /* number of queued requests before the queue is busy, or 0 for none */
+    size_t Queue_Limit;
+    /* requests that are waiting for a reply, and their lists
+       by invoke id */
+    TARGET_DATA *Active_List;
+    TARGET_DATA *Invoke[UINT8_MAX + 1];
+    unsigned Active_Count;
+    /* the ReadPropertyMultiple request that is being encoded */
+    BACNET_READ_ACCESS_DATA RPM_Object[BACNET_READ_WRITE_RPM_PROPERTIES_MAX];
+    BACNET_PROPERTY_REFERENCE
+    RPM_Property[BACNET_READ_WRITE_RPM_PROPERTIES_MAX];
+    /* the WritePropertyMultiple request that is being encoded */
+    BACNET_WRITE_ACCESS_DATA WPM_Object[BACNET_READ_WRITE_WPM_PROPERTIES_MAX];
+    BACNET_PROPERTY_VALUE WPM_Property[BACNET_READ_WRITE_WPM_PROPERTIES_MAX];
+    /* milliseconds that queued writes wait for more writes to the same
+       device, or 0 to send each write as a WriteProperty request */
+    uint16_t WPM_Window;
+    /* local storage - keeps it off the c-stack */
+    BACNET_APPLICATION_DATA_VALUE Decoded_Property_Value;
+    uint16_t Vendor_ID;
+    /* where the data from the read is stored */
+    bacnet_read_write_value_callback_t Value_Callback;
+    bacnet_read_write_context_value_callback_t Context_Value_Callback;
+    /* where the data from the I-Am is called */
+    bacnet_read_write_device_callback_t Device_Callback;
+    bacnet_read_write_context_device_callback_t Context_Device_Callback;
+    struct bacnet_read_write_context *next;
+};
+/* the context of the API functions without a context */
+static BACNET_READ_WRITE_CONTEXT Read_Write_Default;
+/* all of the contexts, starting with the default context */
+static BACNET_READ_WRITE_CONTEXT *Read_Write_Contexts = &Read_Write_Default;
+
+/**
+ * @brief Find the request that is waiting for a reply from a device, in
+ *  any context.  The TSM keeps the invoke id of each device unique, so a
+ *  reply matches the request of one context, which is the context of
+ *  the device of the request.
+ * @param src [in] BACNET_ADDRESS of the source of the reply
+ * @param invoke_id [in] the invokeID of the reply
+ * @return the request, or NULL if no request is waiting for this reply
+ */
+static TARGET_DATA *
+bacnet_read_write_target(const BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    BACNET_READ_WRITE_CONTEXT *context;
+    TARGET_DATA *target;
+
+    for (context = Read_Write_Contexts; context; context = context->next) {
+        for (target = context->Invoke[invoke_id]; target;
+             target = target->invoke_next) {
+            if (address_match(&target->device->address, src)) {
+                return target;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Removes a request from the list of its invoke id
+ * @param rw_context [in] the context of the request
+ * @param target [in] the request that waited for a reply
+ */
+static void bacnet_read_write_invoke_remove(
+    BACNET_READ_WRITE_CONTEXT *rw_context, TARGET_DATA *target)
+{
+    TARGET_DATA **link = &rw_context->Invoke[target->invoke_id];
+
+    while (*link) {
+        if (*link == target) {
+            *link = target->invoke_next;
+            break;
+        }
+        link = &(*link)->invoke_next;
+    }
+    target->invoke_next = NULL;
+}
+
+/**
+ * @brief Note an error for the request that is waiting for a reply
+ * @param src [in] BACNET_ADDRESS of the source of the reply
+ * @param invoke_id [in] the invokeID of the reply
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void bacnet_read_write_error(
+    const BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    TARGET_DATA *target;
+
+    target = bacnet_read_write_target(src, invoke_id);
+    if (target) {
+        target->error_detected = true;
+        target->error_class = error_class;
+        target->error_code = error_code;
+    }
+}
 
 /**
  * @brief Handler for an Error PDU.
@@ -95,11 +308,53 @@ static void MyErrorHandler(
     BACNET_ERROR_CLASS error_class,
     BACNET_ERROR_CODE error_code)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
-        Error_Detected = true;
-        Error_Class = error_class;
-        Error_Code = error_code;
+    bacnet_read_write_error(src, invoke_id, error_class, error_code);
+}
+
+/**
+ * @brief Handler for a WritePropertyMultiple-Error PDU, which names the
+ *  first write that failed.  The writes before it were performed and
+ *  the writes after it were not.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param service_choice [in] the service choice of the request
+ * @param service_request [in] the contents of the error
+ * @param service_len [in] the length of the contents of the error
+ */
+static void My_Write_Property_Multiple_Error_Handler(
+    BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    uint8_t service_choice,
+    uint8_t *service_request,
+    uint16_t service_len)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    TARGET_DATA *target, *member;
+    int len;
+
+    (void)service_choice;
+    target = bacnet_read_write_target(src, invoke_id);
+    if (!target) {
+        return;
+    }
+    len = wpm_error_ack_decode_apdu(service_request, service_len, &wp_data);
+    for (member = target; member; member = member->batch) {
+        if ((member->object_type == wp_data.object_type) &&
+            (member->object_instance == wp_data.object_instance) &&
+            (member->object_property == wp_data.object_property) &&
+            (member->array_index == wp_data.array_index)) {
+            break;
+        }
+    }
+    if ((len <= 0) || !member) {
+        /* unknown which writes were performed */
+        member = target;
+    }
+    member->error_detected = true;
+    member->error_class = wp_data.error_class;
+    member->error_code = wp_data.error_code;
+    for (member = member->batch; member; member = member->batch) {
+        member->resend = true;
     }
 }
 
@@ -114,12 +369,9 @@ static void MyAbortHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
 {
     (void)server;
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
-        Error_Detected = true;
-        Error_Class = ERROR_CLASS_SERVICES;
-        Error_Code = abort_convert_to_error_code(abort_reason);
-    }
+    bacnet_read_write_error(
+        src, invoke_id, ERROR_CLASS_SERVICES,
+        abort_convert_to_error_code(abort_reason));
 }
 
 /**
@@ -131,12 +383,9 @@ static void MyAbortHandler(
 static void
 MyRejectHandler(BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
-        Error_Detected = true;
-        Error_Class = ERROR_CLASS_SERVICES;
-        Error_Code = reject_convert_to_error_code(reject_reason);
-    }
+    bacnet_read_write_error(
+        src, invoke_id, ERROR_CLASS_SERVICES,
+        reject_convert_to_error_code(reject_reason));
 }
 
 /**
@@ -155,15 +404,19 @@ static void My_I_Am_Bind(
     uint16_t vendor_id = 0;
     bool found = false;
     bool bind = false;
+    bool bound = false;
+    BACNET_READ_WRITE_CONTEXT *context;
 
     len = bacnet_iam_request_decode(
         service_request, service_len, &device_id, &max_apdu, &segmentation,
         &vendor_id);
     if (len > 0) {
         found = address_bind_request(device_id, NULL, NULL);
-        if (!found) {
-            if (Target_Vendor_ID != 0) {
-                if (Target_Vendor_ID == vendor_id) {
+        for (context = Read_Write_Contexts; context && !found;
+             context = context->next) {
+            bind = false;
+            if (context->Vendor_ID != 0) {
+                if (context->Vendor_ID == vendor_id) {
                     /* limit binding to specific vendor ID */
                     bind = true;
                 }
@@ -171,13 +424,22 @@ static void My_I_Am_Bind(
                 bind = true;
             }
             if (bind) {
-                address_add_binding(device_id, max_apdu, src);
-                if (bacnet_read_write_device_callback) {
-                    bacnet_read_write_device_callback(
+                if (!bound) {
+                    address_add_binding(device_id, max_apdu, src);
+                    bound = true;
+                }
+                if (context->Device_Callback) {
+                    context->Device_Callback(
                         device_id, max_apdu, segmentation, vendor_id);
                 }
+                if (context->Context_Device_Callback) {
+                    context->Context_Device_Callback(
+                        context, device_id, max_apdu, segmentation,
+                        vendor_id);
+                }
             }
         }
+        address_device_iam_set(device_id, segmentation, vendor_id);
     }
 
     return;
@@ -191,32 +453,82 @@ static void My_I_Am_Bind(
 static void
 MyWritePropertySimpleAckHandler(BACNET_ADDRESS *src, uint8_t invoke_id)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
-        /* nothing to do */
+    if (bacnet_read_write_target(src, invoke_id)) {
+        /* nothing to do - the request finishes when its invoke id is free */
+    }
+}
+
+/**
+ * @brief Give a value, or the result, of a request to its requester
+ * @param rw_context [in] the context of the request
+ * @param device_id [in] The device ID of the source of the message
+ * @param target [in] the request, or NULL if not known
+ * @param rp_data [in] The contents of the result
+ * @param value [in] The decoded value, or NULL if there is no value
+ */
+static void bacnet_read_write_result(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    const TARGET_DATA *target,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    if (target && target->batch) {
+        /* find the read of the shared request that asked for this */
+        while (target) {
+            if ((target->object_type == rp_data->object_type) &&
+                (target->object_instance == rp_data->object_instance) &&
+                (target->object_property == rp_data->object_property) &&
+                ((target->array_index == BACNET_ARRAY_ALL) ||
+                 (target->array_index == rp_data->array_index))) {
+                break;
+            }
+            target = target->batch;
+        }
+    }
+    if (value && (rp_data->object_type == OBJECT_DEVICE) &&
+        (rp_data->object_property == PROP_PROTOCOL_SERVICES_SUPPORTED) &&
+        (value->tag == BACNET_APPLICATION_TAG_BIT_STRING)) {
+        /* remember the services, to choose the requests to send */
+        address_device_services_set(device_id, &value->type.Bit_String);
+    }
+    if (target && target->callback) {
+        target->callback(target->context, device_id, rp_data, value);
+    } else {
+        if (rw_context->Value_Callback) {
+            rw_context->Value_Callback(device_id, rp_data, value);
+        }
+        if (rw_context->Context_Value_Callback) {
+            rw_context->Context_Value_Callback(
+                rw_context, device_id, rp_data, value);
+        }
     }
 }
 
 /**
  * @brief Process a ReadProperty-ACK message
  * @param device_id [in] The device ID of the source of the message
- * @param rp_data [in] The contents of the service request.
+ * @param rp_data [in] The contents of the service request, with the
+ *  request that the ACK is for as its context
  */
 static void bacnet_read_property_ack_process(
     uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
 {
+    BACNET_READ_WRITE_CONTEXT *rw_context;
+    TARGET_DATA *target;
     BACNET_APPLICATION_DATA_VALUE *value;
     uint8_t *apdu;
     int apdu_len, len;
     BACNET_ARRAY_INDEX array_index = 0;
 
-    if (rp_data) {
-        value = &Target_Decoded_Property_Value;
+    if (rp_data && rp_data->context) {
+        target = rp_data->context;
+        rw_context = target->device->rw_context;
+        value = &rw_context->Decoded_Property_Value;
         /* check for property error */
         if (rp_data->error_code != ERROR_CODE_SUCCESS) {
-            if (bacnet_read_write_value_callback) {
-                bacnet_read_write_value_callback(device_id, rp_data, NULL);
-            }
+            bacnet_read_write_result(
+                rw_context, device_id, target, rp_data, NULL);
             return;
         }
         /* check for empty list */
@@ -225,9 +537,8 @@ static void bacnet_read_property_ack_process(
             value->tag = BACNET_APPLICATION_TAG_EMPTYLIST;
             rp_data->error_class = ERROR_CLASS_SERVICES;
             rp_data->error_code = ERROR_CODE_SUCCESS;
-            if (bacnet_read_write_value_callback) {
-                bacnet_read_write_value_callback(device_id, rp_data, value);
-            }
+            bacnet_read_write_result(
+                rw_context, device_id, target, rp_data, value);
             return;
         }
         apdu = rp_data->application_data;
@@ -250,9 +561,8 @@ static void bacnet_read_property_ack_process(
                 if (array_index) {
                     rp_data->array_index = array_index;
                 }
-                if (bacnet_read_write_value_callback) {
-                    bacnet_read_write_value_callback(device_id, rp_data, value);
-                }
+                bacnet_read_write_result(
+                    rw_context, device_id, target, rp_data, value);
                 /* see if there is any more data */
                 if (len < apdu_len) {
                     apdu += len;
@@ -270,9 +580,8 @@ static void bacnet_read_property_ack_process(
                 } else {
                     rp_data->error_code = ERROR_CODE_SUCCESS;
                 }
-                if (bacnet_read_write_value_callback) {
-                    bacnet_read_write_value_callback(device_id, rp_data, NULL);
-                }
+                bacnet_read_write_result(
+                    rw_context, device_id, target, rp_data, NULL);
                 break;
             }
         }
@@ -297,19 +606,21 @@ static void My_Read_Property_Ack_Handler(
     int len = 0;
     BACNET_READ_PROPERTY_DATA rp_data = { 0 };
     uint32_t device_id = 0;
+    TARGET_DATA *target;
 
-    if (address_match(&Target_Address, src) &&
-        (service_data->invoke_id == Request_Invoke_ID)) {
+    target = bacnet_read_write_target(src, service_data->invoke_id);
+    if (target) {
         address_get_device_id(src, &device_id);
         rp_data.error_code = ERROR_CODE_SUCCESS;
         len = rp_ack_decode_service_request(
             service_request, service_len, &rp_data);
         if (len < 0) {
             /* unable to decode value */
-            Error_Detected = true;
-            Error_Class = ERROR_CLASS_SERVICES;
-            Error_Code = ERROR_CODE_INTERNAL_ERROR;
+            target->error_detected = true;
+            target->error_class = ERROR_CLASS_SERVICES;
+            target->error_code = ERROR_CODE_INTERNAL_ERROR;
         } else {
+            rp_data.context = target;
             bacnet_read_property_ack_process(device_id, &rp_data);
         }
     }
@@ -332,17 +643,58 @@ static void My_Read_Property_Multiple_Ack_Handler(
 {
     BACNET_READ_PROPERTY_DATA rp_data = { 0 };
     uint32_t device_id = 0;
+    TARGET_DATA *target;
 
     address_get_device_id(src, &device_id);
-    if (address_match(&Target_Address, src) &&
-        (service_data->invoke_id == Request_Invoke_ID)) {
+    target = bacnet_read_write_target(src, service_data->invoke_id);
+    if (target) {
         rp_data.error_code = ERROR_CODE_SUCCESS;
+        rp_data.context = target;
         rpm_ack_object_property_process(
             apdu, apdu_len, device_id, &rp_data,
             bacnet_read_property_ack_process);
     }
 }
 
+/** Handler for a ReadRange ACK.
+ *  Gives the items of a matching ReadRange request to its callback,
+ *  straight from the received message.
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ * decoded from the APDU header of this message.
+ */
+static void My_Read_Range_Ack_Handler(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
+{
+    int len = 0;
+    BACNET_READ_RANGE_DATA rr_data = { 0 };
+    uint32_t device_id = 0;
+    TARGET_DATA *target;
+
+    target = bacnet_read_write_target(src, service_data->invoke_id);
+    if (target && target->read_range) {
+        address_get_device_id(src, &device_id);
+        len = rr_ack_decode_service_request(
+            service_request, service_len, &rr_data);
+        if (len < 0) {
+            /* unable to decode the ACK */
+            target->error_detected = true;
+            target->error_class = ERROR_CLASS_SERVICES;
+            target->error_code = ERROR_CODE_INTERNAL_ERROR;
+        } else if (target->range_callback) {
+            rr_data.error_class = ERROR_CLASS_SERVICES;
+            rr_data.error_code = ERROR_CODE_SUCCESS;
+            target->range_callback(target->context, device_id, &rr_data);
+        }
+    }
+}
+
 /**
  * @brief Sends a ReadPropertyMultiple service request
  * @param device_id [in] The contents of the service request.
@@ -377,264 +729,1177 @@ static uint8_t Send_RPM_All_Request(
 }
 
 /**
- * @brief Handles the ReadProperty process
- * @param service_request [in] The contents of the service request.
- * @return true if the process is finished
+ * @brief Determines if a request is a read that can share a
+ *  ReadPropertyMultiple request with other reads
+ * @param target [in] the request
+ * @return true if the request can share a ReadPropertyMultiple request
  */
-static bool bacnet_read_write_process(const TARGET_DATA *target)
+static bool bacnet_read_write_batch_read(const TARGET_DATA *target)
 {
-    bool found = false;
-    unsigned max_apdu = 0;
-    uint8_t application_data[16] = { 0 };
-    int application_data_len = 0;
-    bool valid_tag = false;
-
-    switch (RW_State) {
-        case BACNET_CLIENT_IDLE:
-            mstimer_set(&Read_Write_Timer, apdu_timeout());
-            if (target->device_id < BACNET_MAX_INSTANCE) {
-                Error_Detected = false;
-                RW_State = BACNET_CLIENT_BIND;
-            } else {
-                RW_State = BACNET_CLIENT_FINISHED;
-            }
-            break;
-        case BACNET_CLIENT_BIND:
-            /* exclude our device - in case our ID changed */
-            address_own_device_id_set(Device_Object_Instance_Number());
-            /* try to bind with the device */
-            found = address_bind_request(
-                target->device_id, &max_apdu, &Target_Address);
-            if (found) {
-                Target_Device_ID = target->device_id;
-                RW_State = BACNET_CLIENT_SEND;
-            } else {
-                Send_WhoIs(target->device_id, target->device_id);
-                RW_State = BACNET_CLIENT_BINDING;
-            }
+    return !target->write_property && !target->subscribe_cov &&
+        !target->read_range &&
+        (target->object_property != PROP_ALL) &&
+        (target->object_property != PROP_REQUIRED) &&
+        (target->object_property != PROP_OPTIONAL);
+}
+
+/**
+ * @brief Determines if two requests are for the same property, or for
+ *  the same element of a property, so that a result could be for either
+ * @param target [in] the request
+ * @param other [in] the other request
+ * @return true if the requests are for the same property
+ */
+static bool bacnet_read_write_same_property(
+    const TARGET_DATA *target, const TARGET_DATA *other)
+{
+    return (target->object_type == other->object_type) &&
+        (target->object_instance == other->object_instance) &&
+        (target->object_property == other->object_property) &&
+        ((target->array_index == BACNET_ARRAY_ALL) ||
+         (other->array_index == BACNET_ARRAY_ALL) ||
+         (target->array_index == other->array_index));
+}
+
+/**
+ * @brief Encodes the first queued reads of a device into one
+ *  ReadPropertyMultiple request, for as many reads as the device is
+ *  expected to fit into its ReadPropertyMultiple-ACK
+ * @param rw_context [in] the context of the requests
+ * @param device [in] the device
+ * @return number of reads in the request, or 0 if the first request
+ *  is not a read that can share a request
+ */
+static unsigned bacnet_read_write_batch_encode(
+    BACNET_READ_WRITE_CONTEXT *rw_context, const TARGET_DEVICE *device)
+{
+    const TARGET_DATA *target, *other;
+    BACNET_READ_ACCESS_DATA *object = NULL;
+    BACNET_PROPERTY_REFERENCE *property;
+    unsigned count = 0, objects = 0;
+    size_t size;
+    bool shared;
+
+    for (target = device->head; target &&
+         (count < device->rpm_max) &&
+         (count < BACNET_READ_WRITE_RPM_PROPERTIES_MAX);
+         target = target->next) {
+        if (!bacnet_read_write_batch_read(target)) {
             break;
-        case BACNET_CLIENT_BINDING:
-            found = address_bind_request(
-                target->device_id, &max_apdu, &Target_Address);
-            if (found) {
-                Target_Device_ID = target->device_id;
-                mstimer_set(&Read_Write_Timer, apdu_timeout());
-                RW_State = BACNET_CLIENT_SEND;
-            } else if (mstimer_expired(&Read_Write_Timer)) {
-                /* unable to bind within APDU timeout */
-                Error_Detected = true;
-                Error_Class = ERROR_CLASS_SERVICES;
-                Error_Code = ERROR_CODE_TIMEOUT;
-                RW_State = BACNET_CLIENT_FINISHED;
+        }
+        for (other = device->head; other != target; other = other->next) {
+            if (bacnet_read_write_same_property(target, other)) {
+                /* each result must find its own read */
+                break;
             }
+        }
+        if (other != target) {
             break;
-        case BACNET_CLIENT_SEND:
-            if (target->write_property) {
-                switch (target->tag) {
-                    case BACNET_APPLICATION_TAG_NULL:
-                        application_data_len =
-                            encode_application_null(&application_data[0]);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_BOOLEAN:
-                        application_data_len = encode_application_boolean(
-                            &application_data[0], target->type.Boolean);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_REAL:
-                        application_data_len = encode_application_real(
-                            &application_data[0], target->type.Real);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_UNSIGNED_INT:
-                        application_data_len = encode_application_unsigned(
-                            &application_data[0], target->type.Unsigned_Int);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_SIGNED_INT:
-                        application_data_len = encode_application_signed(
-                            &application_data[0], target->type.Signed_Int);
-                        valid_tag = true;
-                        break;
-                    case BACNET_APPLICATION_TAG_ENUMERATED:
-                        application_data_len = encode_application_enumerated(
-                            &application_data[0], target->type.Enumerated);
-                        valid_tag = true;
-                        break;
-                    default:
-                        break;
-                }
-                if (valid_tag) {
-                    Request_Invoke_ID = Send_Write_Property_Request_Data(
-                        target->device_id, target->object_type,
-                        target->object_instance, target->object_property,
-                        &application_data[0], application_data_len,
-                        target->priority, target->array_index);
-                }
-            } else {
-                if (target->object_property == PROP_ALL) {
-                    Request_Invoke_ID = Send_RPM_All_Request(
-                        target->device_id, target->object_type,
-                        target->object_instance);
-                } else {
-                    Request_Invoke_ID = Send_Read_Property_Request(
-                        target->device_id, target->object_type,
-                        target->object_instance, target->object_property,
-                        target->array_index);
-                }
+        }
+        property = &rw_context->RPM_Property[count];
+        property->propertyIdentifier = target->object_property;
+        property->propertyArrayIndex = target->array_index;
+        property->error.error_class = ERROR_CLASS_DEVICE;
+        property->error.error_code = ERROR_CODE_OTHER;
+        property->value = NULL;
+        property->next = NULL;
+        shared = object && (object->object_type == target->object_type) &&
+            (object->object_instance == target->object_instance);
+        if (shared) {
+            /* the reads before this one are of the same object */
+            rw_context->RPM_Property[count - 1].next = property;
+        } else {
+            object = &rw_context->RPM_Object[objects];
+            object->object_type = target->object_type;
+            object->object_instance = target->object_instance;
+            object->listOfProperties = property;
+            object->next = NULL;
+            if (objects > 0) {
+                rw_context->RPM_Object[objects - 1].next = object;
             }
-            if (Request_Invoke_ID == 0) {
-                if (mstimer_expired(&Read_Write_Timer)) {
-                    /* TSM Timeout - no invokeIDs available */
-                    Error_Detected = true;
-                    Error_Class = ERROR_CLASS_SERVICES;
-                    Error_Code = ERROR_CODE_TIMEOUT;
-                    RW_State = BACNET_CLIENT_FINISHED;
-                }
+            objects++;
+        }
+        count++;
+        size = read_property_multiple_request_encode(
+            NULL, rw_context->RPM_Object);
+        size += count * BACNET_READ_WRITE_RPM_VALUE_SIZE;
+        if ((count > 1) && (size > device->max_apdu)) {
+            /* the ACK would not fit - leave this read for later */
+            count--;
+            if (shared) {
+                rw_context->RPM_Property[count - 1].next = NULL;
             } else {
-                RW_State = BACNET_CLIENT_WAITING;
-            }
-            break;
-        case BACNET_CLIENT_WAITING:
-            if (Error_Detected) {
-                RW_State = BACNET_CLIENT_FINISHED;
-            } else if (tsm_invoke_id_free(Request_Invoke_ID)) {
-                Error_Detected = false;
-                RW_State = BACNET_CLIENT_FINISHED;
-            } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
-                Error_Detected = true;
-                Error_Class = ERROR_CLASS_SERVICES;
-                Error_Code = ERROR_CODE_ABORT_TSM_TIMEOUT;
-                RW_State = BACNET_CLIENT_FINISHED;
-                tsm_free_invoke_id(Request_Invoke_ID);
+                objects--;
+                rw_context->RPM_Object[objects - 1].next = NULL;
             }
             break;
-        case BACNET_CLIENT_FINISHED:
-            RW_State = BACNET_CLIENT_IDLE;
-            break;
-        default:
-            break;
+        }
     }
 
-    return (RW_State == BACNET_CLIENT_FINISHED);
+    return count;
 }
 
 /**
- * @brief Sets the callback for when a read-property returns data
- *
- * @param callback - function for callback
+ * @brief Sends the ReadPropertyMultiple request that was encoded
+ *  by bacnet_read_write_batch_encode()
+ * @param rw_context [in] the context of the requests
+ * @param device_id [in] the device instance of the destination
+ * @return invoke_id of request, or 0 if the request was not sent
  */
-void bacnet_read_write_value_callback_set(
-    bacnet_read_write_value_callback_t callback)
+static uint8_t Send_RPM_Batch_Request(
+    BACNET_READ_WRITE_CONTEXT *rw_context, uint32_t device_id)
 {
-    bacnet_read_write_value_callback = callback;
+    uint8_t pdu[MAX_PDU] = { 0 };
+
+    return Send_Read_Property_Multiple_Request(
+        pdu, sizeof(pdu), device_id, &rw_context->RPM_Object[0]);
 }
 
 /**
- * @brief Sets the callback for when an I-Am returns device data
- *
- * @param callback - function for callback
+ * @brief Copies the value of a queued write
+ * @param target [in] the request
+ * @param value [out] the value
  */
-void bacnet_read_write_device_callback_set(
-    bacnet_read_write_device_callback_t callback)
+static void bacnet_write_property_value(
+    const TARGET_DATA *target, BACNET_APPLICATION_DATA_VALUE *value)
 {
-    bacnet_read_write_device_callback = callback;
+    bacapp_value_list_init(value, 1);
+    value->tag = target->tag;
+    switch (target->tag) {
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            value->type.Boolean = target->type.Boolean;
+            break;
+        case BACNET_APPLICATION_TAG_REAL:
+            value->type.Real = target->type.Real;
+            break;
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            value->type.Unsigned_Int = target->type.Unsigned_Int;
+            break;
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            value->type.Signed_Int = target->type.Signed_Int;
+            break;
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            value->type.Enumerated = target->type.Enumerated;
+            break;
+        default:
+            break;
+    }
 }
 
 /**
- * @brief Handles the ReadProperty repetitive task
+ * @brief Encodes the first queued writes of a device into one
+ *  WritePropertyMultiple request, for as many writes as fit into
+ *  the max-APDU of the device
+ * @param rw_context [in] the context of the requests
+ * @param device [in] the device
+ * @param full [out] true if no more writes can share the request
+ * @return number of writes in the request
  */
-void bacnet_read_write_task(void)
+static unsigned bacnet_write_property_batch_encode(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    const TARGET_DEVICE *device,
+    bool *full)
 {
-    TARGET_DATA *target;
-    bool status = false;
-    BACNET_READ_PROPERTY_DATA rp_data;
-
-    if (!Ringbuf_Empty(&Target_Data_Queue)) {
-        target = (TARGET_DATA *)Ringbuf_Peek(&Target_Data_Queue);
-        status = bacnet_read_write_process(target);
-        if (status) {
-            if (Error_Detected) {
-                if (bacnet_read_write_value_callback) {
-                    rp_data.error_class = Error_Class;
-                    rp_data.error_code = Error_Code;
-                    rp_data.object_type = target->object_type;
-                    rp_data.object_instance = target->object_instance;
-                    rp_data.object_property = target->object_property;
-                    rp_data.array_index = target->array_index;
-                    bacnet_read_write_value_callback(
-                        target->device_id, &rp_data, NULL);
-                }
+    const TARGET_DATA *target, *other;
+    BACNET_WRITE_ACCESS_DATA *object = NULL;
+    BACNET_PROPERTY_VALUE *property;
+    unsigned count = 0, objects = 0;
+    size_t size;
+    bool shared;
+
+    *full = true;
+    for (target = device->head; target; target = target->next) {
+        if ((count >= device->wpm_max) ||
+            (count >= BACNET_READ_WRITE_WPM_PROPERTIES_MAX) ||
+            !target->write_property) {
+            return count;
+        }
+        for (other = device->head; other != target; other = other->next) {
+            if (bacnet_read_write_same_property(target, other)) {
+                /* each error must find its own write */
+                return count;
             }
-            Ringbuf_Pop(&Target_Data_Queue, NULL);
+        }
+        property = &rw_context->WPM_Property[count];
+        property->propertyIdentifier = target->object_property;
+        property->propertyArrayIndex = target->array_index;
+        property->priority = target->priority;
+        bacnet_write_property_value(target, &property->value);
+        property->next = NULL;
+        shared = object && (object->object_type == target->object_type) &&
+            (object->object_instance == target->object_instance);
+        if (shared) {
+            /* the writes before this one are of the same object */
+            rw_context->WPM_Property[count - 1].next = property;
+        } else {
+            object = &rw_context->WPM_Object[objects];
+            object->object_type = target->object_type;
+            object->object_instance = target->object_instance;
+            object->listOfProperties = property;
+            object->next = NULL;
+            if (objects > 0) {
+                rw_context->WPM_Object[objects - 1].next = object;
+            }
+            objects++;
+        }
+        count++;
+        size = write_property_multiple_request_encode(
+            NULL, rw_context->WPM_Object);
+        size += TARGET_WPM_HEADER_SIZE;
+        if ((count > 1) && (size > device->max_apdu)) {
+            /* the request would not fit - leave this write for later */
+            count--;
+            if (shared) {
+                rw_context->WPM_Property[count - 1].next = NULL;
+            } else {
+                objects--;
+                rw_context->WPM_Object[objects - 1].next = NULL;
+            }
+            return count;
         }
     }
-    if (mstimer_expired(&Cache_Timer)) {
-        mstimer_reset(&Cache_Timer);
-        address_cache_timer(CACHE_CYCLE_SECONDS);
-    }
+    *full = false;
+
+    return count;
 }
 
 /**
- * @brief Adds a Read Property request remote data point
- * @param device_id - ID of the destination device
- * @param object_type - Type of the object whose property is to be read.
- * @param object_instance - Instance # of the object to be read.
- * @param object_property - Property to be read, but not ALL, REQUIRED, or
- * OPTIONAL.
- * @param array_index [in] Optional: if the Property is an array,
- *   - 0 for the array size
- *   - 1 to n for individual array members
- *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
- * @return true if added, false if not added
+ * @brief Sends the WritePropertyMultiple request that was encoded
+ *  by bacnet_write_property_batch_encode()
+ * @param rw_context [in] the context of the requests
+ * @param device_id [in] the device instance of the destination
+ * @return invoke_id of request, or 0 if the request was not sent
  */
-bool bacnet_read_property_queue(
-    uint32_t device_id,
-    BACNET_OBJECT_TYPE object_type,
-    uint32_t object_instance,
-    BACNET_PROPERTY_ID object_property,
-    uint32_t array_index)
+static uint8_t Send_WPM_Batch_Request(
+    BACNET_READ_WRITE_CONTEXT *rw_context, uint32_t device_id)
 {
-    bool status = false;
-    TARGET_DATA target;
+    uint8_t pdu[MAX_PDU] = { 0 };
 
-    target.write_property = false;
-    target.device_id = device_id;
-    target.object_type = object_type;
-    target.object_instance = object_instance;
-    target.object_property = object_property;
-    target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    return Send_Write_Property_Multiple_Request(
+        pdu, sizeof(pdu), device_id, &rw_context->WPM_Object[0]);
+}
 
-    return status;
+/**
+ * @brief Encode the value of a WriteProperty request
+ * @param target [in] the request
+ * @param application_data [out] buffer for the encoded value
+ * @return number of bytes encoded, or 0 if the tag is not supported
+ */
+static int bacnet_write_property_encode(
+    const TARGET_DATA *target, uint8_t *application_data)
+{
+    int application_data_len = 0;
+
+    switch (target->tag) {
+        case BACNET_APPLICATION_TAG_NULL:
+            application_data_len = encode_application_null(application_data);
+            break;
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            application_data_len = encode_application_boolean(
+                application_data, target->type.Boolean);
+            break;
+        case BACNET_APPLICATION_TAG_REAL:
+            application_data_len =
+                encode_application_real(application_data, target->type.Real);
+            break;
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            application_data_len = encode_application_unsigned(
+                application_data, target->type.Unsigned_Int);
+            break;
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            application_data_len = encode_application_signed(
+                application_data, target->type.Signed_Int);
+            break;
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            application_data_len = encode_application_enumerated(
+                application_data, target->type.Enumerated);
+            break;
+        default:
+            break;
+    }
+
+    return application_data_len;
 }
 
 /**
- * @brief Adds a WriteProperty request to a remote data point - REAL
- * @param device_id - ID of the destination device
- * @param object_type - Type of the object whose property is to be read.
- * @param object_instance - Instance # of the object to be read.
- * @param object_property - Property to be read, but not ALL, REQUIRED, or
- * OPTIONAL.
- * @param value - property value of type REAL (float)
- * @param priority - BACnet priority for writing 1..16, or 0 if not set
- * @param array_index [in] Optional: if the Property is an array,
- *   - 0 for the array size
- *   - 1 to n for individual array members
- *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
- * @return true if added, false if not added
+ * @brief Sends the request to its device
+ * @param target [in] the request
+ * @return invoke_id of request, or 0 if the request was not sent
  */
-bool bacnet_write_property_real_queue(
-    uint32_t device_id,
-    BACNET_OBJECT_TYPE object_type,
-    uint32_t object_instance,
-    BACNET_PROPERTY_ID object_property,
-    float value,
-    uint8_t priority,
-    uint32_t array_index)
+static uint8_t bacnet_read_write_send(const TARGET_DATA *target)
 {
-    bool status = false;
-    TARGET_DATA target = { 0 };
+    uint8_t application_data[16] = { 0 };
+    int application_data_len = 0;
+    uint8_t invoke_id = 0;
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_READ_RANGE_DATA rr_data = { 0 };
+
+    if (target->read_range) {
+        rr_data.object_type = target->object_type;
+        rr_data.object_instance = target->object_instance;
+        rr_data.object_property = target->object_property;
+        rr_data.array_index = target->array_index;
+        rr_data.RequestType = RR_BY_SEQUENCE;
+        rr_data.Range.RefSeqNum = target->range_sequence;
+        rr_data.Count = target->range_count;
+        invoke_id = Send_ReadRange_Request(target->device_id, &rr_data);
+    } else if (target->subscribe_cov) {
+        cov_data.subscriberProcessIdentifier =
+            BACNET_READ_WRITE_COV_PROCESS_ID;
+        cov_data.monitoredObjectIdentifier.type = target->object_type;
+        cov_data.monitoredObjectIdentifier.instance = target->object_instance;
+        cov_data.cancellationRequest = false;
+        cov_data.issueConfirmedNotifications = false;
+        cov_data.lifetime = target->lifetime;
+        invoke_id = Send_COV_Subscribe(target->device_id, &cov_data);
+    } else if (target->write_property) {
+        application_data_len =
+            bacnet_write_property_encode(target, &application_data[0]);
+        if (application_data_len > 0) {
+            invoke_id = Send_Write_Property_Request_Data(
+                target->device_id, target->object_type,
+                target->object_instance, target->object_property,
+                &application_data[0], application_data_len, target->priority,
+                target->array_index);
+        }
+    } else {
+        if (target->object_property == PROP_ALL) {
+            invoke_id = Send_RPM_All_Request(
+                target->device_id, target->object_type,
+                target->object_instance);
+        } else {
+            invoke_id = Send_Read_Property_Request(
+                target->device_id, target->object_type,
+                target->object_instance, target->object_property,
+                target->array_index);
+        }
+    }
+
+    return invoke_id;
+}
+
+/**
+ * @brief Queues requests again, in front of the other queued requests
+ *  of the device
+ * @param rw_context [in] the context of the requests
+ * @param device [in] the device
+ * @param target [in] the first of the requests, which are linked by next
+ */
+static void bacnet_read_write_device_requeue(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    TARGET_DEVICE *device,
+    TARGET_DATA *target)
+{
+    TARGET_DATA *first = target, *last = NULL;
+
+    while (target) {
+        target->batch = NULL;
+        target->resend = false;
+        target->error_detected = false;
+        target->send_retry = false;
+        target->invoke_id = 0;
+        rw_context->Queue_Count++;
+        last = target;
+        target = target->next;
+    }
+    if (last) {
+        last->next = device->head;
+        if (!device->head) {
+            device->tail = last;
+        }
+        device->head = first;
+    }
+}
+
+/**
+ * @brief Queues the requests of a shared request again, when the device
+ *  could not handle a ReadPropertyMultiple or WritePropertyMultiple
+ *  request of that size
+ * @param rw_context [in] the context of the requests
+ * @param target [in] the first request of the shared request, with its error
+ * @return true if the requests were queued again
+ */
+static bool bacnet_read_write_batch_failed(
+    BACNET_READ_WRITE_CONTEXT *rw_context, TARGET_DATA *target)
+{
+    TARGET_DEVICE *device = target->device;
+    TARGET_DATA *member;
+    unsigned count = 0, limit;
+
+    for (member = target; member; member = member->batch) {
+        count++;
+    }
+    switch (target->error_code) {
+        case ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED:
+        case ERROR_CODE_SERVICE_REQUEST_DENIED:
+            if (target->write_property) {
+                /* the error is about one of the writes */
+                return false;
+            }
+            /* fall back to ReadProperty */
+            limit = 1;
+            break;
+        case ERROR_CODE_REJECT_UNRECOGNIZED_SERVICE:
+            /* fall back to ReadProperty or WriteProperty */
+            limit = 1;
+            break;
+        case ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED:
+        case ERROR_CODE_ABORT_BUFFER_OVERFLOW:
+        case ERROR_CODE_ABORT_APDU_TOO_LONG:
+        case ERROR_CODE_REJECT_BUFFER_OVERFLOW:
+            /* the request or its ACK was too large - share fewer */
+            limit = count / 2;
+            if (limit < 1) {
+                limit = 1;
+            }
+            break;
+        default:
+            return false;
+    }
+    if (target->write_property) {
+        device->wpm_max = limit;
+    } else {
+        device->rpm_max = limit;
+    }
+    for (member = target; member; member = member->next) {
+        member->next = member->batch;
+    }
+    bacnet_read_write_device_requeue(rw_context, device, target);
+
+    return true;
+}
+
+/**
+ * @brief Get the service of a request that was sent
+ * @param target [in] the first request of the sent request
+ * @return the service of the request
+ */
+static BACNET_SERVICES_SUPPORTED
+bacnet_read_write_service(const TARGET_DATA *target)
+{
+    if (target->read_range) {
+        return SERVICE_SUPPORTED_READ_RANGE;
+    }
+    if (target->subscribe_cov) {
+        return SERVICE_SUPPORTED_SUBSCRIBE_COV;
+    }
+    if (target->write_property) {
+        return target->batch ? SERVICE_SUPPORTED_WRITE_PROP_MULTIPLE
+                             : SERVICE_SUPPORTED_WRITE_PROPERTY;
+    }
+    if (target->batch || (target->object_property == PROP_ALL)) {
+        return SERVICE_SUPPORTED_READ_PROP_MULTIPLE;
+    }
+
+    return SERVICE_SUPPORTED_READ_PROPERTY;
+}
+
+/**
+ * @brief Sets the limits of a device from what is known of the services
+ *  it supports, so that no requests are sent to find them out
+ * @param device [in] the device
+ */
+static void bacnet_read_write_device_capability(TARGET_DEVICE *device)
+{
+    bool supported = true;
+
+    if (address_device_service_supported(
+            device->device_id, SERVICE_SUPPORTED_READ_PROP_MULTIPLE,
+            &supported) &&
+        !supported) {
+        device->rpm_max = 1;
+    }
+    if (address_device_service_supported(
+            device->device_id, SERVICE_SUPPORTED_WRITE_PROP_MULTIPLE,
+            &supported) &&
+        !supported) {
+        device->wpm_max = 1;
+    }
+}
+
+/**
+ * @brief Gives the failure of a ReadRange request to its callback
+ * @param target [in] the request, with its error
+ */
+static void bacnet_read_range_failed(const TARGET_DATA *target)
+{
+    BACNET_READ_RANGE_DATA rr_data = { 0 };
+
+    rr_data.object_type = target->object_type;
+    rr_data.object_instance = target->object_instance;
+    rr_data.object_property = target->object_property;
+    rr_data.array_index = target->array_index;
+    rr_data.RequestType = RR_BY_SEQUENCE;
+    rr_data.Range.RefSeqNum = target->range_sequence;
+    rr_data.Count = target->range_count;
+    rr_data.error_class = target->error_class;
+    rr_data.error_code = target->error_code;
+    target->range_callback(target->context, target->device_id, &rr_data);
+}
+
+/**
+ * @brief Gives the result of a finished request, and frees the request
+ * @param rw_context [in] the context of the requests
+ * @param target [in] the request
+ */
+static void bacnet_read_write_finish(
+    BACNET_READ_WRITE_CONTEXT *rw_context, TARGET_DATA *target)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    TARGET_DEVICE *device = target->device;
+    TARGET_DATA *batch, *resend = NULL, **resend_tail = &resend;
+    bool error_detected = target->error_detected;
+    BACNET_ERROR_CLASS error_class = target->error_class;
+    BACNET_ERROR_CODE error_code = target->error_code;
+
+    if (target->error_detected &&
+        (target->error_code == ERROR_CODE_REJECT_UNRECOGNIZED_SERVICE)) {
+        /* remember that the device does not support the service */
+        address_device_service_set(
+            target->device_id, bacnet_read_write_service(target), false);
+    }
+    if (target->batch && target->error_detected &&
+        bacnet_read_write_batch_failed(rw_context, target)) {
+        return;
+    }
+    while (target) {
+        batch = target->batch;
+        target->batch = NULL;
+        if (target->resend) {
+            /* the write was not performed - send it again */
+            target->next = NULL;
+            *resend_tail = target;
+            resend_tail = &target->next;
+            target = batch;
+            continue;
+        }
+        if (error_detected && !target->error_detected) {
+            /* the requests of a shared request share its error */
+            target->error_detected = true;
+            target->error_class = error_class;
+            target->error_code = error_code;
+        }
+        rp_data.object_type = target->object_type;
+        rp_data.object_instance = target->object_instance;
+        rp_data.object_property = target->object_property;
+        rp_data.array_index = target->array_index;
+        if (target->read_range) {
+            if (target->error_detected && target->range_callback) {
+                bacnet_read_range_failed(target);
+            }
+        } else if (target->error_detected) {
+            rp_data.error_class = target->error_class;
+            rp_data.error_code = target->error_code;
+            bacnet_read_write_result(
+                rw_context, target->device_id, target, &rp_data, NULL);
+        } else if (
+            (target->write_property || target->subscribe_cov) &&
+            target->callback) {
+            rp_data.error_class = ERROR_CLASS_SERVICES;
+            rp_data.error_code = ERROR_CODE_SUCCESS;
+            target->callback(
+                target->context, target->device_id, &rp_data, NULL);
+        }
+        Slab_Free(&rw_context->Data_Slab, target);
+        device->requests--;
+        target = batch;
+    }
+    bacnet_read_write_device_requeue(rw_context, device, resend);
+    if (!device->head && (device->active == 0)) {
+        rw_context->Device_Sweep = true;
+    }
+}
+
+/**
+ * @brief Removes the first queued request of a device
+ * @param rw_context [in] the context of the requests
+ * @param device [in] the device
+ * @return the request, or NULL if the device has no queued requests
+ */
+static TARGET_DATA *bacnet_read_write_device_pop(
+    BACNET_READ_WRITE_CONTEXT *rw_context, TARGET_DEVICE *device)
+{
+    TARGET_DATA *target;
+
+    target = device->head;
+    if (target) {
+        device->head = target->next;
+        if (!device->head) {
+            device->tail = NULL;
+        }
+        target->next = NULL;
+        rw_context->Queue_Count--;
+    }
+
+    return target;
+}
+
+/**
+ * @brief Finishes the queued requests of a device with an error
+ * @param rw_context [in] the context of the requests
+ * @param device [in] the device
+ * @param error_code [in] the error code
+ */
+static void bacnet_read_write_device_fail(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    TARGET_DEVICE *device,
+    BACNET_ERROR_CODE error_code)
+{
+    TARGET_DATA *target;
+
+    while ((target = bacnet_read_write_device_pop(rw_context, device)) !=
+           NULL) {
+        target->error_detected = true;
+        target->error_class = ERROR_CLASS_SERVICES;
+        target->error_code = error_code;
+        bacnet_read_write_finish(rw_context, target);
+    }
+}
+
+/**
+ * @brief Checks the requests that are waiting for a reply, and
+ *  finishes the requests that got their reply or timed out
+ * @param rw_context [in] the context of the requests
+ */
+static void bacnet_read_write_active_task(BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    TARGET_DATA **link = &rw_context->Active_List;
+    TARGET_DATA *target;
+    bool finished;
+
+    while ((target = *link) != NULL) {
+        finished = false;
+        if (target->error_detected) {
+            finished = true;
+        } else if (tsm_invoke_id_free_peer(
+                       &target->device->address, target->invoke_id)) {
+            finished = true;
+        } else if (tsm_invoke_id_failed_peer(
+                       &target->device->address, target->invoke_id)) {
+            target->error_detected = true;
+            target->error_class = ERROR_CLASS_SERVICES;
+            target->error_code = ERROR_CODE_ABORT_TSM_TIMEOUT;
+            tsm_free_invoke_id_peer(
+                &target->device->address, target->invoke_id);
+            finished = true;
+        }
+        if (finished) {
+            *link = target->next;
+            bacnet_read_write_invoke_remove(rw_context, target);
+            rw_context->Active_Count--;
+            target->device->active--;
+            bacnet_read_write_finish(rw_context, target);
+        } else {
+            link = &target->next;
+        }
+    }
+}
+
+/**
+ * @brief Determines if a device could not be bound recently, so that
+ *  its requests fail without another Who-Is
+ * @param rw_context [in] the context of the requests
+ * @param device_id [in] device instance
+ * @return true if the device may not be tried yet
+ */
+static bool bacnet_read_write_bind_backoff(
+    const BACNET_READ_WRITE_CONTEXT *rw_context, uint32_t device_id)
+{
+    TARGET_BIND_FAILURE *failure;
+
+    failure = Keylist_Data(rw_context->Bind_Failure_List, device_id);
+    if (failure && !mstimer_expired(&failure->timer)) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Notes that a device could not be bound, and doubles the time
+ *  before it is tried again
+ * @param rw_context [in] the context of the requests
+ * @param device_id [in] device instance
+ */
+static void bacnet_read_write_bind_failed(
+    const BACNET_READ_WRITE_CONTEXT *rw_context, uint32_t device_id)
+{
+    TARGET_BIND_FAILURE *failure;
+
+    failure = Keylist_Data(rw_context->Bind_Failure_List, device_id);
+    if (!failure) {
+        failure = calloc(1, sizeof(TARGET_BIND_FAILURE));
+        if (!failure) {
+            return;
+        }
+        if (Keylist_Data_Add(
+                rw_context->Bind_Failure_List, device_id, failure) < 0) {
+            free(failure);
+            return;
+        }
+    }
+    if (failure->seconds == 0) {
+        failure->seconds = BACNET_READ_WRITE_BIND_BACKOFF_SECONDS;
+    } else if (
+        failure->seconds < (BACNET_READ_WRITE_BIND_BACKOFF_SECONDS_MAX / 2)) {
+        failure->seconds *= 2;
+    } else {
+        failure->seconds = BACNET_READ_WRITE_BIND_BACKOFF_SECONDS_MAX;
+    }
+    mstimer_set(&failure->timer, failure->seconds * 1000UL);
+}
+
+/**
+ * @brief Notes that a device is bound
+ * @param rw_context [in] the context of the requests
+ * @param device [in] the device
+ */
+static void bacnet_read_write_bind_success(
+    const BACNET_READ_WRITE_CONTEXT *rw_context, TARGET_DEVICE *device)
+{
+    device->bound = true;
+    device->binding = false;
+    free(Keylist_Data_Delete(rw_context->Bind_Failure_List, device->device_id));
+    bacnet_read_write_device_capability(device);
+}
+
+/**
+ * @brief Determines if a device waits for a Who-Is to bind it
+ * @param rw_context [in] the context of the requests
+ * @param device [in] the device
+ * @return true if the device waits for a Who-Is
+ */
+static bool bacnet_read_write_bind_wanted(
+    const BACNET_READ_WRITE_CONTEXT *rw_context, TARGET_DEVICE *device)
+{
+    if (device->bound || device->binding || !device->head) {
+        return false;
+    }
+    /* exclude our device - in case our ID changed */
+    address_own_device_id_set(Device_Object_Instance_Number());
+    if (address_bind_request(
+            device->device_id, &device->max_apdu, &device->address)) {
+        bacnet_read_write_bind_success(rw_context, device);
+        return false;
+    }
+
+    return !bacnet_read_write_bind_backoff(rw_context, device->device_id);
+}
+
+/**
+ * @brief Binds the devices that wait for a Who-Is.  The devices whose
+ *  instances are close share a ranged Who-Is, and the Who-Is are sent
+ *  at a limited rate, so that binding many devices does not flood the
+ *  network with broadcasts.
+ * @param rw_context [in] the context of the requests
+ */
+static void bacnet_read_write_bind_task(BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    TARGET_DEVICE *device;
+    uint32_t low_limit = 0, high_limit = 0;
+    int count, i, first = -1;
+
+    if (rw_context->WhoIs_Wait && !mstimer_expired(&rw_context->WhoIs_Timer)) {
+        return;
+    }
+    rw_context->WhoIs_Wait = false;
+    /* the devices are in the order of their instance */
+    count = Keylist_Count(rw_context->Device_List);
+    for (i = 0; i < count; i++) {
+        device = Keylist_Data_Index(rw_context->Device_List, i);
+        if (!bacnet_read_write_bind_wanted(rw_context, device)) {
+            continue;
+        }
+        if (first < 0) {
+            first = i;
+            low_limit = device->device_id;
+        } else if (
+            (device->device_id - high_limit) > BACNET_READ_WRITE_WHOIS_GAP) {
+            break;
+        }
+        high_limit = device->device_id;
+    }
+    if (first < 0) {
+        return;
+    }
+    for (i = first; i < count; i++) {
+        device = Keylist_Data_Index(rw_context->Device_List, i);
+        if (device->device_id > high_limit) {
+            break;
+        }
+        if (!device->bound && !device->binding && device->head) {
+            mstimer_set(&device->bind_timer, apdu_timeout());
+            device->binding = true;
+        }
+    }
+    Send_WhoIs(low_limit, high_limit);
+    mstimer_set(&rw_context->WhoIs_Timer, BACNET_READ_WRITE_WHOIS_MILLISECONDS);
+    rw_context->WhoIs_Wait = true;
+}
+
+/**
+ * @brief Binds with a device, and sends its queued requests for as long
+ *  as the device and the client may have more requests waiting for a reply
+ * @param rw_context [in] the context of the requests
+ * @param device [in] the device
+ * @return false if no invoke id was free, so no more requests can be sent
+ */
+static bool bacnet_read_write_device_task(
+    BACNET_READ_WRITE_CONTEXT *rw_context, TARGET_DEVICE *device)
+{
+    TARGET_DATA *target, *batch;
+    unsigned count;
+    uint8_t invoke_id;
+    bool full;
+
+    if (!device->head) {
+        return true;
+    }
+    if (!device->bound) {
+        /* exclude our device - in case our ID changed */
+        address_own_device_id_set(Device_Object_Instance_Number());
+        /* try to bind with the device */
+        if (address_bind_request(
+                device->device_id, &device->max_apdu, &device->address)) {
+            bacnet_read_write_bind_success(rw_context, device);
+        } else if (!device->binding) {
+            if (bacnet_read_write_bind_backoff(rw_context, device->device_id)) {
+                /* the device did not answer recently */
+                bacnet_read_write_device_fail(
+                    rw_context, device, ERROR_CODE_TIMEOUT);
+            }
+            /* otherwise the device waits for the bind task */
+        } else if (mstimer_expired(&device->bind_timer)) {
+            /* unable to bind within APDU timeout */
+            device->binding = false;
+            bacnet_read_write_bind_failed(rw_context, device->device_id);
+            bacnet_read_write_device_fail(
+                rw_context, device, ERROR_CODE_TIMEOUT);
+        }
+    }
+    while (device->bound && device->head &&
+           (device->active < rw_context->Device_Requests_Max) &&
+           (rw_context->Active_Count < rw_context->Requests_Max)) {
+        target = device->head;
+        count = 0;
+        if (target->write_property) {
+            if ((rw_context->WPM_Window > 0) && (device->wpm_max > 1)) {
+                count = bacnet_write_property_batch_encode(
+                    rw_context, device, &full);
+                if (!full && device->write_window &&
+                    !mstimer_expired(&device->write_timer)) {
+                    /* wait for more writes to share the request */
+                    break;
+                }
+                device->write_window = false;
+            }
+        } else if (device->rpm_max > 1) {
+            count = bacnet_read_write_batch_encode(rw_context, device);
+        }
+        if (count > 1) {
+            if (target->write_property) {
+                invoke_id =
+                    Send_WPM_Batch_Request(rw_context, device->device_id);
+            } else {
+                invoke_id =
+                    Send_RPM_Batch_Request(rw_context, device->device_id);
+            }
+        } else {
+            count = 1;
+            invoke_id = bacnet_read_write_send(target);
+        }
+        if (invoke_id == 0) {
+            if (!address_bind_request(
+                    device->device_id, &device->max_apdu,
+                    &device->address)) {
+                /* the binding was lost - bind again */
+                device->bound = false;
+                return true;
+            }
+            if (!target->send_retry) {
+                target->send_retry = true;
+                mstimer_set(&target->send_timer, apdu_timeout());
+            } else if (mstimer_expired(&target->send_timer)) {
+                /* TSM Timeout - no invokeIDs available */
+                target = bacnet_read_write_device_pop(rw_context, device);
+                target->error_detected = true;
+                target->error_class = ERROR_CLASS_SERVICES;
+                target->error_code = ERROR_CODE_TIMEOUT;
+                bacnet_read_write_finish(rw_context, target);
+            }
+            return false;
+        }
+        target = bacnet_read_write_device_pop(rw_context, device);
+        for (batch = target; --count > 0; batch = batch->batch) {
+            /* the requests that share the request wait with the first */
+            batch->batch = bacnet_read_write_device_pop(rw_context, device);
+        }
+        target->invoke_id = invoke_id;
+        target->invoke_next = rw_context->Invoke[invoke_id];
+        rw_context->Invoke[invoke_id] = target;
+        target->next = rw_context->Active_List;
+        rw_context->Active_List = target;
+        rw_context->Active_Count++;
+        device->active++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Sends the queued requests, taking turns between the devices
+ * @param rw_context [in] the context of the requests
+ */
+static void
+bacnet_read_write_dispatch_task(BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    int count, i, index;
+
+    count = Keylist_Count(rw_context->Device_List);
+    for (i = 0; i < count; i++) {
+        if (rw_context->Active_Count >= rw_context->Requests_Max) {
+            break;
+        }
+        index = (rw_context->Device_Next + i) % count;
+        if (!bacnet_read_write_device_task(
+                rw_context,
+                Keylist_Data_Index(rw_context->Device_List, index))) {
+            break;
+        }
+    }
+    if (count > 0) {
+        /* the next task starts with the next device */
+        rw_context->Device_Next = (rw_context->Device_Next + 1) % count;
+    }
+}
+
+/**
+ * @brief Frees the devices that have no more requests
+ * @param rw_context [in] the context of the requests
+ */
+static void bacnet_read_write_sweep_task(BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    TARGET_DEVICE *device;
+    int i;
+
+    if (!rw_context->Device_Sweep) {
+        return;
+    }
+    rw_context->Device_Sweep = false;
+    for (i = Keylist_Count(rw_context->Device_List) - 1; i >= 0; i--) {
+        device = Keylist_Data_Index(rw_context->Device_List, i);
+        if (device && !device->head && (device->active == 0)) {
+            device = Keylist_Data_Delete_By_Index(rw_context->Device_List, i);
+            free(device);
+        }
+    }
+}
+
+/**
+ * @brief Adds a request to the queue of its device
+ * @param rw_context [in] the context of the request
+ * @param data [in] the request
+ * @return true if added, false if not added
+ */
+static bool bacnet_read_write_queue(
+    BACNET_READ_WRITE_CONTEXT *rw_context, const TARGET_DATA *data)
+{
+    TARGET_DEVICE *device;
+    TARGET_DATA *target;
+
+    if (!rw_context || !rw_context->Device_List ||
+        (data->device_id >= BACNET_MAX_INSTANCE)) {
+        return false;
+    }
+    if (rw_context->Queue_Limit &&
+        (rw_context->Queue_Count >= rw_context->Queue_Limit)) {
+        return false;
+    }
+    device = Keylist_Data(rw_context->Device_List, data->device_id);
+    if (!device) {
+        device = calloc(1, sizeof(TARGET_DEVICE));
+        if (!device) {
+            return false;
+        }
+        device->device_id = data->device_id;
+        device->max_apdu = MAX_APDU;
+        device->rpm_max = BACNET_READ_WRITE_RPM_PROPERTIES_MAX;
+        device->wpm_max = BACNET_READ_WRITE_WPM_PROPERTIES_MAX;
+        device->rw_context = rw_context;
+        if (Keylist_Data_Add(rw_context->Device_List, data->device_id, device) <
+            0) {
+            free(device);
+            return false;
+        }
+    }
+    target = Slab_Item_Alloc(&rw_context->Data_Slab);
+    if (!target) {
+        rw_context->Device_Sweep = true;
+        return false;
+    }
+    *target = *data;
+    target->invoke_id = 0;
+    target->invoke_next = NULL;
+    target->error_detected = false;
+    target->send_retry = false;
+    target->device = device;
+    target->batch = NULL;
+    target->resend = false;
+    target->next = NULL;
+    if (target->write_property && (rw_context->WPM_Window > 0) &&
+        !device->write_window) {
+        /* the writes that are queued within the window share requests */
+        mstimer_set(&device->write_timer, rw_context->WPM_Window);
+        device->write_window = true;
+    }
+    if (device->tail) {
+        device->tail->next = target;
+    } else {
+        device->head = target;
+    }
+    device->tail = target;
+    device->requests++;
+    rw_context->Queue_Count++;
+
+    return true;
+}
+
+/**
+ * @brief Sets the callback for when a read-property returns data
+ *
+ * @param callback - function for callback
+ */
+void bacnet_read_write_value_callback_set(
+    bacnet_read_write_value_callback_t callback)
+{
+    Read_Write_Default.Value_Callback = callback;
+}
+
+/**
+ * @brief Sets the callback of a context for when a read-property of the
+ *  context returns data
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param callback - function for callback
+ */
+void bacnet_read_write_context_value_callback_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    bacnet_read_write_context_value_callback_t callback)
+{
+    if (rw_context) {
+        rw_context->Context_Value_Callback = callback;
+    }
+}
+
+/**
+ * @brief Sets the callback for when an I-Am returns device data
+ *
+ * @param callback - function for callback
+ */
+void bacnet_read_write_device_callback_set(
+    bacnet_read_write_device_callback_t callback)
+{
+    Read_Write_Default.Device_Callback = callback;
+}
+
+/**
+ * @brief Sets the callback of a context for when an I-Am that passes the
+ *  vendor filter of the context returns device data
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param callback - function for callback
+ */
+void bacnet_read_write_context_device_callback_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    bacnet_read_write_context_device_callback_t callback)
+{
+    if (rw_context) {
+        rw_context->Context_Device_Callback = callback;
+    }
+}
+
+/**
+ * @brief Handles the ReadProperty repetitive task of every context
+ */
+void bacnet_read_write_task(void)
+{
+    BACNET_READ_WRITE_CONTEXT *rw_context;
+
+    for (rw_context = Read_Write_Contexts; rw_context;
+         rw_context = rw_context->next) {
+        if (!rw_context->Device_List) {
+            /* not initialized */
+            continue;
+        }
+        bacnet_read_write_active_task(rw_context);
+        bacnet_read_write_bind_task(rw_context);
+        bacnet_read_write_dispatch_task(rw_context);
+        bacnet_read_write_sweep_task(rw_context);
+    }
+    if (mstimer_expired(&Cache_Timer)) {
+        mstimer_reset(&Cache_Timer);
+        address_cache_timer(CACHE_CYCLE_SECONDS);
+    }
+}
+
+/**
+ * @brief Adds a Read Property request remote data point
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read, but not ALL, REQUIRED, or
+ * OPTIONAL.
+ * @param array_index [in] Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @return true if added, false if not added
+ */
+bool bacnet_read_property_queue(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index)
+{
+    bool status = false;
+    TARGET_DATA target = { 0 };
+
+    target.write_property = false;
+    target.device_id = device_id;
+    target.object_type = object_type;
+    target.object_instance = object_instance;
+    target.object_property = object_property;
+    target.array_index = array_index;
+    status = bacnet_read_write_queue(&Read_Write_Default, &target);
+
+    return status;
+}
+
+/**
+ * @brief Adds a WriteProperty request to a remote data point - REAL
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read, but not ALL, REQUIRED, or
+ * OPTIONAL.
+ * @param value - property value of type REAL (float)
+ * @param priority - BACnet priority for writing 1..16, or 0 if not set
+ * @param array_index [in] Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @return true if added, false if not added
+ */
+bool bacnet_write_property_real_queue(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    float value,
+    uint8_t priority,
+    uint32_t array_index)
+{
+    bool status = false;
+    TARGET_DATA target = { 0 };
 
     target.write_property = true;
     target.device_id = device_id;
@@ -645,7 +1910,7 @@ bool bacnet_write_property_real_queue(
     target.type.Real = value;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    status = bacnet_read_write_queue(&Read_Write_Default, &target);
 
     return status;
 }
@@ -684,191 +1949,743 @@ bool bacnet_write_property_null_queue(
     target.tag = BACNET_APPLICATION_TAG_NULL;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    status = bacnet_read_write_queue(&Read_Write_Default, &target);
+
+    return status;
+}
+
+/**
+ * @brief Adds a Write Property request to a remote data point
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read, but not ALL, REQUIRED, or
+ * OPTIONAL.
+ * @param value - property value of type ENUMERATED
+ * @param priority - BACnet priority for writing 1..16, or 0 if not set
+ * @param array_index [in] Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @return true if added, false if not added
+ */
+bool bacnet_write_property_enumerated_queue(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    unsigned int value,
+    uint8_t priority,
+    uint32_t array_index)
+{
+    bool status = false;
+    TARGET_DATA target = { 0 };
+
+    target.write_property = true;
+    target.device_id = device_id;
+    target.object_type = object_type;
+    target.object_instance = object_instance;
+    target.object_property = object_property;
+    target.tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    target.type.Enumerated = value;
+    target.priority = priority;
+    target.array_index = array_index;
+    status = bacnet_read_write_queue(&Read_Write_Default, &target);
+
+    return status;
+}
+
+/**
+ * @brief Adds a Write Property request to a remote data point
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read, but not ALL, REQUIRED, or
+ * OPTIONAL.
+ * @param value - property value of type UNSIGNED INT
+ * @param priority - BACnet priority for writing 1..16, or 0 if not set
+ * @param array_index [in] Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @return true if added, false if not added
+ */
+bool bacnet_write_property_unsigned_queue(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    unsigned int value,
+    uint8_t priority,
+    uint32_t array_index)
+{
+    bool status = false;
+    TARGET_DATA target = { 0 };
+
+    target.write_property = true;
+    target.device_id = device_id;
+    target.object_type = object_type;
+    target.object_instance = object_instance;
+    target.object_property = object_property;
+    target.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    target.type.Unsigned_Int = value;
+    target.priority = priority;
+    target.array_index = array_index;
+    status = bacnet_read_write_queue(&Read_Write_Default, &target);
+
+    return status;
+}
+
+/**
+ * @brief Adds a Write Property request to a remote data point
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read, but not ALL, REQUIRED, or
+ * OPTIONAL.
+ * @param value - property value of type SIGNED INT
+ * @param priority - BACnet priority for writing 1..16, or 0 if not set
+ * @param array_index [in] Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @return true if added, false if not added
+ */
+bool bacnet_write_property_signed_queue(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    signed int value,
+    uint8_t priority,
+    uint32_t array_index)
+{
+    bool status = false;
+    TARGET_DATA target = { 0 };
+
+    target.write_property = true;
+    target.device_id = device_id;
+    target.object_type = object_type;
+    target.object_instance = object_instance;
+    target.object_property = object_property;
+    target.tag = BACNET_APPLICATION_TAG_SIGNED_INT;
+    target.type.Signed_Int = value;
+    target.priority = priority;
+    target.array_index = array_index;
+    status = bacnet_read_write_queue(&Read_Write_Default, &target);
+
+    return status;
+}
+
+/**
+ * @brief Adds a Write Property request to a remote data point
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read, but not ALL, REQUIRED, or
+ * OPTIONAL.
+ * @param value - property value of type SIGNED INT
+ * @param priority - BACnet priority for writing 1..16, or 0 if not set
+ * @param array_index [in] Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @return true if added, false if not added
+ */
+bool bacnet_write_property_boolean_queue(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    bool value,
+    uint8_t priority,
+    uint32_t array_index)
+{
+    bool status = false;
+    TARGET_DATA target = { 0 };
+
+    target.write_property = true;
+    target.device_id = device_id;
+    target.object_type = object_type;
+    target.object_instance = object_instance;
+    target.object_property = object_property;
+    target.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    target.type.Boolean = value;
+    target.priority = priority;
+    target.array_index = array_index;
+    status = bacnet_read_write_queue(&Read_Write_Default, &target);
+
+    return status;
+}
+
+/**
+ * @brief Adds a Read Property request remote data point, with a callback
+ *  for its values and errors.
+ *  The request is queued in the given context.
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read, but not REQUIRED, or
+ * OPTIONAL.
+ * @param array_index [in] Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @param callback - function that gets the result, or NULL for the
+ *  value callback
+ * @param context - context that is given to the callback
+ * @return true if added, false if not added
+ */
+bool bacnet_read_write_context_read_property(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index,
+    bacnet_read_write_result_callback_t callback,
+    void *context)
+{
+    TARGET_DATA target = { 0 };
+
+    target.write_property = false;
+    target.device_id = device_id;
+    target.object_type = object_type;
+    target.object_instance = object_instance;
+    target.object_property = object_property;
+    target.array_index = array_index;
+    target.callback = callback;
+    target.context = context;
 
-    return status;
+    return bacnet_read_write_queue(rw_context, &target);
 }
 
 /**
- * @brief Adds a Write Property request to a remote data point
+ * @brief Adds a Read Property request remote data point, with a callback
+ *  for its values and errors
  * @param device_id - ID of the destination device
  * @param object_type - Type of the object whose property is to be read.
  * @param object_instance - Instance # of the object to be read.
- * @param object_property - Property to be read, but not ALL, REQUIRED, or
+ * @param object_property - Property to be read, but not REQUIRED, or
  * OPTIONAL.
- * @param value - property value of type ENUMERATED
- * @param priority - BACnet priority for writing 1..16, or 0 if not set
  * @param array_index [in] Optional: if the Property is an array,
  *   - 0 for the array size
  *   - 1 to n for individual array members
  *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @param callback - function that gets the result, or NULL for the
+ *  value callback
+ * @param context - context that is given to the callback
  * @return true if added, false if not added
  */
-bool bacnet_write_property_enumerated_queue(
+bool bacnet_read_property_queue_callback(
     uint32_t device_id,
     BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     BACNET_PROPERTY_ID object_property,
-    unsigned int value,
-    uint8_t priority,
-    uint32_t array_index)
+    uint32_t array_index,
+    bacnet_read_write_result_callback_t callback,
+    void *context)
 {
-    bool status = false;
-    TARGET_DATA target;
+    return bacnet_read_write_context_read_property(
+        &Read_Write_Default, device_id, object_type, object_instance,
+        object_property, array_index, callback, context);
+}
 
-    target.write_property = true;
+/**
+ * @brief Adds a ReadRange request by sequence number for the items of a
+ *  remote list property, such as the Log_Buffer of a log, with a callback
+ *  for the ReadRange-ACK or the failure of the request.
+ *  The request is queued in the given context.
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - List property to be read.
+ * @param sequence_number - sequence number of the first item
+ * @param count - number of items to read, negative to read the items
+ *  before the sequence number
+ * @param callback - function that gets the ACK or the failure
+ * @param context - context that is given to the callback
+ * @return true if added, false if not added
+ */
+bool bacnet_read_write_context_read_range(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t sequence_number,
+    int32_t count,
+    bacnet_read_range_result_callback_t callback,
+    void *context)
+{
+    TARGET_DATA target = { 0 };
+
+    target.read_range = true;
     target.device_id = device_id;
     target.object_type = object_type;
     target.object_instance = object_instance;
     target.object_property = object_property;
-    target.tag = BACNET_APPLICATION_TAG_ENUMERATED;
-    target.type.Enumerated = value;
-    target.priority = priority;
-    target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    target.array_index = BACNET_ARRAY_ALL;
+    target.range_sequence = sequence_number;
+    target.range_count = count;
+    target.range_callback = callback;
+    target.context = context;
 
-    return status;
+    return bacnet_read_write_queue(rw_context, &target);
 }
 
 /**
- * @brief Adds a Write Property request to a remote data point
+ * @brief Adds a ReadRange request by sequence number for the items of a
+ *  remote list property, such as the Log_Buffer of a log, with a callback
+ *  for the ReadRange-ACK or the failure of the request
  * @param device_id - ID of the destination device
  * @param object_type - Type of the object whose property is to be read.
  * @param object_instance - Instance # of the object to be read.
- * @param object_property - Property to be read, but not ALL, REQUIRED, or
- * OPTIONAL.
- * @param value - property value of type UNSIGNED INT
- * @param priority - BACnet priority for writing 1..16, or 0 if not set
- * @param array_index [in] Optional: if the Property is an array,
- *   - 0 for the array size
- *   - 1 to n for individual array members
- *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @param object_property - List property to be read.
+ * @param sequence_number - sequence number of the first item
+ * @param count - number of items to read, negative to read the items
+ *  before the sequence number
+ * @param callback - function that gets the ACK or the failure
+ * @param context - context that is given to the callback
  * @return true if added, false if not added
  */
-bool bacnet_write_property_unsigned_queue(
+bool bacnet_read_range_queue_callback(
     uint32_t device_id,
     BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     BACNET_PROPERTY_ID object_property,
-    unsigned int value,
-    uint8_t priority,
-    uint32_t array_index)
+    uint32_t sequence_number,
+    int32_t count,
+    bacnet_read_range_result_callback_t callback,
+    void *context)
 {
-    bool status = false;
-    TARGET_DATA target;
+    return bacnet_read_write_context_read_range(
+        &Read_Write_Default, device_id, object_type, object_instance,
+        object_property, sequence_number, count, callback, context);
+}
 
-    target.write_property = true;
+/**
+ * @brief Adds a SubscribeCOV request for a remote object, with a callback
+ *  for its result.  The notifications are unconfirmed, and are handled
+ *  by the COV notification handlers.
+ *  The request is queued in the given context.
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object to be monitored.
+ * @param object_instance - Instance # of the object to be monitored.
+ * @param lifetime - number of seconds that the subscription lasts
+ * @param callback - function that gets the result, or NULL for the
+ *  value callback, which only gets errors
+ * @param context - context that is given to the callback
+ * @return true if added, false if not added
+ */
+bool bacnet_read_write_context_subscribe_cov(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t lifetime,
+    bacnet_read_write_result_callback_t callback,
+    void *context)
+{
+    TARGET_DATA target = { 0 };
+
+    target.subscribe_cov = true;
     target.device_id = device_id;
     target.object_type = object_type;
     target.object_instance = object_instance;
-    target.object_property = object_property;
-    target.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
-    target.type.Unsigned_Int = value;
-    target.priority = priority;
-    target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    target.object_property = PROP_PRESENT_VALUE;
+    target.array_index = BACNET_ARRAY_ALL;
+    target.lifetime = lifetime;
+    target.callback = callback;
+    target.context = context;
 
-    return status;
+    return bacnet_read_write_queue(rw_context, &target);
 }
 
 /**
- * @brief Adds a Write Property request to a remote data point
+ * @brief Adds a SubscribeCOV request for a remote object, with a callback
+ *  for its result.  The notifications are unconfirmed, and are handled
+ *  by the COV notification handlers.
  * @param device_id - ID of the destination device
- * @param object_type - Type of the object whose property is to be read.
- * @param object_instance - Instance # of the object to be read.
- * @param object_property - Property to be read, but not ALL, REQUIRED, or
- * OPTIONAL.
- * @param value - property value of type SIGNED INT
+ * @param object_type - Type of the object to be monitored.
+ * @param object_instance - Instance # of the object to be monitored.
+ * @param lifetime - number of seconds that the subscription lasts
+ * @param callback - function that gets the result, or NULL for the
+ *  value callback, which only gets errors
+ * @param context - context that is given to the callback
+ * @return true if added, false if not added
+ */
+bool bacnet_subscribe_cov_queue_callback(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t lifetime,
+    bacnet_read_write_result_callback_t callback,
+    void *context)
+{
+    return bacnet_read_write_context_subscribe_cov(
+        &Read_Write_Default, device_id, object_type, object_instance, lifetime,
+        callback, context);
+}
+
+/**
+ * @brief Adds a Write Property request to a remote data point, with a
+ *  callback for its result.
+ *  The request is queued in the given context.
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be written.
+ * @param object_instance - Instance # of the object to be written.
+ * @param object_property - Property to be written.
+ * @param value - property value of type NULL, BOOLEAN, REAL, UNSIGNED INT,
+ *  SIGNED INT, or ENUMERATED
  * @param priority - BACnet priority for writing 1..16, or 0 if not set
  * @param array_index [in] Optional: if the Property is an array,
  *   - 0 for the array size
  *   - 1 to n for individual array members
- *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
- * @return true if added, false if not added
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be written.
+ * @param callback - function that gets the result, or NULL for the
+ *  value callback, which only gets errors
+ * @param context - context that is given to the callback
+ * @return true if added, false if not added or the value type is not
+ *  supported
  */
-bool bacnet_write_property_signed_queue(
+bool bacnet_read_write_context_write_property(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
     uint32_t device_id,
     BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     BACNET_PROPERTY_ID object_property,
-    signed int value,
+    const BACNET_APPLICATION_DATA_VALUE *value,
     uint8_t priority,
-    uint32_t array_index)
+    uint32_t array_index,
+    bacnet_read_write_result_callback_t callback,
+    void *context)
 {
-    bool status = false;
-    TARGET_DATA target;
+    TARGET_DATA target = { 0 };
 
+    if (!value) {
+        return false;
+    }
+    switch (value->tag) {
+        case BACNET_APPLICATION_TAG_NULL:
+            break;
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            target.type.Boolean = value->type.Boolean;
+            break;
+        case BACNET_APPLICATION_TAG_REAL:
+            target.type.Real = value->type.Real;
+            break;
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            target.type.Unsigned_Int = (uint32_t)value->type.Unsigned_Int;
+            break;
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            target.type.Signed_Int = value->type.Signed_Int;
+            break;
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            target.type.Enumerated = value->type.Enumerated;
+            break;
+        default:
+            return false;
+    }
     target.write_property = true;
     target.device_id = device_id;
     target.object_type = object_type;
     target.object_instance = object_instance;
     target.object_property = object_property;
-    target.tag = BACNET_APPLICATION_TAG_SIGNED_INT;
-    target.type.Signed_Int = value;
+    target.tag = value->tag;
     target.priority = priority;
     target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+    target.callback = callback;
+    target.context = context;
 
-    return status;
+    return bacnet_read_write_queue(rw_context, &target);
 }
 
 /**
- * @brief Adds a Write Property request to a remote data point
+ * @brief Adds a Write Property request to a remote data point, with a
+ *  callback for its result
  * @param device_id - ID of the destination device
- * @param object_type - Type of the object whose property is to be read.
- * @param object_instance - Instance # of the object to be read.
- * @param object_property - Property to be read, but not ALL, REQUIRED, or
- * OPTIONAL.
- * @param value - property value of type SIGNED INT
+ * @param object_type - Type of the object whose property is to be written.
+ * @param object_instance - Instance # of the object to be written.
+ * @param object_property - Property to be written.
+ * @param value - property value of type NULL, BOOLEAN, REAL, UNSIGNED INT,
+ *  SIGNED INT, or ENUMERATED
  * @param priority - BACnet priority for writing 1..16, or 0 if not set
  * @param array_index [in] Optional: if the Property is an array,
  *   - 0 for the array size
  *   - 1 to n for individual array members
- *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
- * @return true if added, false if not added
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be written.
+ * @param callback - function that gets the result, or NULL for the
+ *  value callback, which only gets errors
+ * @param context - context that is given to the callback
+ * @return true if added, false if not added or the value type is not
+ *  supported
  */
-bool bacnet_write_property_boolean_queue(
+bool bacnet_write_property_queue_callback(
     uint32_t device_id,
     BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     BACNET_PROPERTY_ID object_property,
-    bool value,
+    const BACNET_APPLICATION_DATA_VALUE *value,
     uint8_t priority,
-    uint32_t array_index)
+    uint32_t array_index,
+    bacnet_read_write_result_callback_t callback,
+    void *context)
 {
-    bool status = false;
-    TARGET_DATA target;
+    return bacnet_read_write_context_write_property(
+        &Read_Write_Default, device_id, object_type, object_instance,
+        object_property, value, priority, array_index, callback, context);
+}
 
-    target.write_property = true;
-    target.device_id = device_id;
-    target.object_type = object_type;
-    target.object_instance = object_instance;
-    target.object_property = object_property;
-    target.tag = BACNET_APPLICATION_TAG_BOOLEAN;
-    target.type.Boolean = value;
-    target.priority = priority;
-    target.array_index = array_index;
-    status = Ringbuf_Put(&Target_Data_Queue, (uint8_t *)&target);
+/**
+ * @brief Determines if the queue of a context is empty
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @return true if the parameter queue is empty and no request is
+ *  waiting for a reply, and thus, idle
+ */
+bool bacnet_read_write_context_idle(
+    const BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    if (!rw_context) {
+        return false;
+    }
 
-    return status;
+    return (rw_context->Queue_Count == 0) && (rw_context->Active_Count == 0);
 }
 
 /**
  * @brief Determines if the BACnet ReadProperty queue is empty
- * @return true if the parameter queue is empty, and thus, idle
+ * @return true if the parameter queue is empty and no request is
+ *  waiting for a reply, and thus, idle
  */
 bool bacnet_read_write_idle(void)
 {
-    return Ringbuf_Empty(&Target_Data_Queue);
+    return bacnet_read_write_context_idle(&Read_Write_Default);
+}
+
+/**
+ * @brief Determines if the queue of a context is full
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @return true if the parameter queue has reached its limit, and thus, busy
+ */
+bool bacnet_read_write_context_busy(
+    const BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    if (!rw_context) {
+        return false;
+    }
+
+    return rw_context->Queue_Limit &&
+        (rw_context->Queue_Count >= rw_context->Queue_Limit);
 }
 
 /**
  * @brief Determines if the BACnet ReadProperty queue is full
- * @return true if the parameter queue is full, and thus, busy
+ * @return true if the parameter queue has reached its limit, and thus, busy
  */
 bool bacnet_read_write_busy(void)
 {
-    return Ringbuf_Full(&Target_Data_Queue);
+    return bacnet_read_write_context_busy(&Read_Write_Default);
+}
+
+/**
+ * @brief Gets the number of queued requests of a context that have not
+ *  been sent
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @return number of queued requests
+ */
+size_t bacnet_read_write_context_queue_count(
+    const BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    if (!rw_context) {
+        return 0;
+    }
+
+    return rw_context->Queue_Count;
+}
+
+/**
+ * @brief Gets the number of queued requests that have not been sent
+ * @return number of queued requests
+ */
+size_t bacnet_read_write_queue_count(void)
+{
+    return bacnet_read_write_context_queue_count(&Read_Write_Default);
+}
+
+/**
+ * @brief Sets the number of queued requests at which the queue of a
+ *  context is busy.  The queue grows as needed up to this limit.
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param limit - number of queued requests, or 0 for no limit
+ */
+void bacnet_read_write_context_queue_limit_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context, size_t limit)
+{
+    if (rw_context) {
+        rw_context->Queue_Limit = limit;
+    }
+}
+
+/**
+ * @brief Sets the number of queued requests at which the queue is busy.
+ *  The queue grows as needed up to this limit.
+ * @param limit - number of queued requests, or 0 for no limit
+ */
+void bacnet_read_write_queue_limit_set(size_t limit)
+{
+    bacnet_read_write_context_queue_limit_set(&Read_Write_Default, limit);
+}
+
+/**
+ * @brief Gets the number of requests of a context that wait for a reply
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @return number of requests that wait for a reply
+ */
+unsigned bacnet_read_write_context_active_count(
+    const BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    if (!rw_context) {
+        return 0;
+    }
+
+    return rw_context->Active_Count;
+}
+
+/**
+ * @brief Gets the number of requests that wait for a reply
+ * @return number of requests that wait for a reply
+ */
+unsigned bacnet_read_write_active_count(void)
+{
+    return bacnet_read_write_context_active_count(&Read_Write_Default);
+}
+
+/**
+ * @brief Gets the number of requests of a context to a device that are
+ *  queued or waiting for a reply
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param device_id - device instance number
+ * @return number of requests to the device
+ */
+unsigned bacnet_read_write_context_device_requests(
+    const BACNET_READ_WRITE_CONTEXT *rw_context, uint32_t device_id)
+{
+    TARGET_DEVICE *device;
+
+    if (!rw_context) {
+        return 0;
+    }
+    device = Keylist_Data(rw_context->Device_List, device_id);
+    if (!device) {
+        return 0;
+    }
+
+    return device->requests;
+}
+
+/**
+ * @brief Gets the number of requests to a device that are queued or
+ *  waiting for a reply
+ * @param device_id - device instance number
+ * @return number of requests to the device
+ */
+unsigned bacnet_read_write_device_requests(uint32_t device_id)
+{
+    return bacnet_read_write_context_device_requests(
+        &Read_Write_Default, device_id);
+}
+
+/**
+ * @brief Sets the number of requests of a context that may wait for a
+ *  reply at the same time, to all devices and to any one device
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param requests_max - number of requests to all devices, 1 or more,
+ *  which is limited by the number of TSM transactions
+ * @param device_requests_max - number of requests to any one device,
+ *  1 or more
+ */
+void bacnet_read_write_context_requests_max_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    unsigned requests_max,
+    unsigned device_requests_max)
+{
+    if (!rw_context) {
+        return;
+    }
+    if (requests_max > MAX_TSM_TRANSACTIONS) {
+        requests_max = MAX_TSM_TRANSACTIONS;
+    }
+    if (requests_max < 1) {
+        requests_max = 1;
+    }
+    if (device_requests_max < 1) {
+        device_requests_max = 1;
+    }
+    rw_context->Requests_Max = requests_max;
+    rw_context->Device_Requests_Max = device_requests_max;
+}
+
+/**
+ * @brief Sets the number of requests that may wait for a reply at the
+ *  same time, to all devices and to any one device
+ * @param requests_max - number of requests to all devices, 1 or more,
+ *  which is limited by the number of TSM transactions
+ * @param device_requests_max - number of requests to any one device,
+ *  1 or more
+ */
+void bacnet_read_write_requests_max_set(
+    unsigned requests_max, unsigned device_requests_max)
+{
+    bacnet_read_write_context_requests_max_set(
+        &Read_Write_Default, requests_max, device_requests_max);
+}
+
+/**
+ * @brief Sets the time that the queued writes of a context wait for more
+ *  writes to the same device, so that the writes share
+ *  WritePropertyMultiple requests.
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param milliseconds - time that writes wait, or 0 to send each write
+ *  as a WriteProperty request
+ */
+void bacnet_read_write_context_write_window_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context, uint16_t milliseconds)
+{
+    if (rw_context) {
+        rw_context->WPM_Window = milliseconds;
+    }
+}
+
+/**
+ * @brief Sets the time that queued writes wait for more writes to the
+ *  same device, so that the writes share WritePropertyMultiple requests.
+ *  The writes that a WritePropertyMultiple-Error names as not performed
+ *  are sent again.
+ * @param milliseconds - time that writes wait, or 0 to send each write
+ *  as a WriteProperty request
+ */
+void bacnet_write_property_multiple_window_set(uint16_t milliseconds)
+{
+    bacnet_read_write_context_write_window_set(
+        &Read_Write_Default, milliseconds);
+}
+
+/**
+ * @brief Sets a Vendor ID filter of a context on I-Am bindings
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @param vendor_id - vendor ID to filter, 0=no filter
+ */
+void bacnet_read_write_context_vendor_id_filter_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context, uint16_t vendor_id)
+{
+    if (rw_context) {
+        rw_context->Vendor_ID = vendor_id;
+    }
 }
 
 /**
@@ -878,7 +2695,23 @@ bool bacnet_read_write_busy(void)
  */
 void bacnet_read_write_vendor_id_filter_set(uint16_t vendor_id)
 {
-    Target_Vendor_ID = vendor_id;
+    bacnet_read_write_context_vendor_id_filter_set(
+        &Read_Write_Default, vendor_id);
+}
+
+/**
+ * @brief Gets the Vendor ID filter of a context on I-Am bindings
+ * @param rw_context - context from bacnet_read_write_context_create()
+ * @return vendor_id - vendor ID to filter, 0=no filter
+ */
+uint16_t bacnet_read_write_context_vendor_id_filter(
+    const BACNET_READ_WRITE_CONTEXT *rw_context)
+{
+    if (!rw_context) {
+        return 0;
+    }
+
+    return rw_context->Vendor_ID;
 }
 
 /**
@@ -888,18 +2721,125 @@ void bacnet_read_write_vendor_id_filter_set(uint16_t vendor_id)
  */
 uint16_t bacnet_read_write_vendor_id_filter(void)
 {
-    return Target_Vendor_ID;
+    return bacnet_read_write_context_vendor_id_filter(&Read_Write_Default);
+}
+
+/**
+ * @brief Sets the request limits of a context that were not set yet
+ * @param context - context
+ */
+static void
+bacnet_read_write_context_defaults(BACNET_READ_WRITE_CONTEXT *context)
+{
+    if (context->Requests_Max == 0) {
+        context->Requests_Max = BACNET_READ_WRITE_REQUESTS_MAX;
+    }
+    if (context->Device_Requests_Max == 0) {
+        context->Device_Requests_Max = BACNET_READ_WRITE_DEVICE_REQUESTS_MAX;
+    }
+}
+
+/**
+ * @brief Creates a context with its own queue of requests, limits, and
+ *  callbacks, so that independent parts of an application do not share
+ *  their requests.  The context is given to the
+ *  bacnet_read_write_context_*() functions, and the task of every context
+ *  is run by bacnet_read_write_task().  The functions without a context
+ *  work on a default context, which is initialized by
+ *  bacnet_read_write_init().
+ * @note The contexts share the TSM, the address cache, and the datalink
+ *  of the stack, so they are run from the thread that runs the stack.
+ * @return the new context, or NULL if out of memory
+ */
+BACNET_READ_WRITE_CONTEXT *bacnet_read_write_context_create(void)
+{
+    BACNET_READ_WRITE_CONTEXT *context;
+
+    context = calloc(1, sizeof(BACNET_READ_WRITE_CONTEXT));
+    if (!context) {
+        return NULL;
+    }
+    context->Device_List = Keylist_Create();
+    context->Bind_Failure_List = Keylist_Create();
+    if (!context->Device_List || !context->Bind_Failure_List) {
+        Keylist_Delete(context->Device_List);
+        Keylist_Delete(context->Bind_Failure_List);
+        free(context);
+        return NULL;
+    }
+    Slab_Init(&context->Data_Slab, sizeof(TARGET_DATA));
+    Slab_Grow_Set(&context->Data_Slab, TARGET_DATA_QUEUE_COUNT);
+    bacnet_read_write_context_defaults(context);
+    context->next = Read_Write_Default.next;
+    Read_Write_Default.next = context;
+
+    return context;
+}
+
+/**
+ * @brief Deletes a context and its requests, without calling the result
+ *  callbacks
+ * @param context - context from bacnet_read_write_context_create()
+ */
+void bacnet_read_write_context_delete(BACNET_READ_WRITE_CONTEXT *context)
+{
+    BACNET_READ_WRITE_CONTEXT **link;
+    TARGET_DATA *target;
+
+    if (!context || (context == &Read_Write_Default)) {
+        return;
+    }
+    for (link = &Read_Write_Default.next; *link; link = &(*link)->next) {
+        if (*link == context) {
+            *link = context->next;
+            break;
+        }
+    }
+    for (target = context->Active_List; target; target = target->next) {
+        /* the replies are not wanted anymore */
+        tsm_free_invoke_id_peer(&target->device->address, target->invoke_id);
+    }
+    Keylist_Data_Free(context->Device_List);
+    Keylist_Delete(context->Device_List);
+    Keylist_Data_Free(context->Bind_Failure_List);
+    Keylist_Delete(context->Bind_Failure_List);
+    Slab_Cleanup(&context->Data_Slab);
+    free(context);
 }
 
 /**
- * @brief Initializes the ReadProperty module
+ * @brief Initializes the ReadProperty module, and forgets the requests
+ *  of the default context
  */
 void bacnet_read_write_init(void)
 {
-    Ringbuf_Initialize(
-        &Target_Data_Queue, (uint8_t *)&Target_Data_Buffer,
-        sizeof(Target_Data_Buffer), TARGET_DATA_QUEUE_SIZE,
-        TARGET_DATA_QUEUE_COUNT);
+    BACNET_READ_WRITE_CONTEXT *rw_context = &Read_Write_Default;
+    unsigned i;
+
+    /* forget any requests from before */
+    if (rw_context->Device_List) {
+        Keylist_Data_Free(rw_context->Device_List);
+    } else {
+        rw_context->Device_List = Keylist_Create();
+    }
+    Slab_Cleanup(&rw_context->Data_Slab);
+    Slab_Init(&rw_context->Data_Slab, sizeof(TARGET_DATA));
+    Slab_Grow_Set(&rw_context->Data_Slab, TARGET_DATA_QUEUE_COUNT);
+    bacnet_read_write_context_defaults(rw_context);
+    if (rw_context->Bind_Failure_List) {
+        Keylist_Data_Free(rw_context->Bind_Failure_List);
+    } else {
+        rw_context->Bind_Failure_List = Keylist_Create();
+    }
+    rw_context->WhoIs_Wait = false;
+    rw_context->Device_Next = 0;
+    rw_context->Device_Sweep = false;
+    rw_context->Queue_Count = 0;
+    rw_context->Active_List = NULL;
+    rw_context->Active_Count = 0;
+    for (i = 0; i <= UINT8_MAX; i++) {
+        rw_context->Invoke[i] = NULL;
+    }
     /* handle i-am to support binding to other devices */
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, My_I_Am_Bind);
     /* handle the data coming back from confirmed requests */
@@ -908,12 +2848,26 @@ void bacnet_read_write_init(void)
     apdu_set_confirmed_ack_handler(
         SERVICE_CONFIRMED_READ_PROP_MULTIPLE,
         My_Read_Property_Multiple_Ack_Handler);
+    apdu_set_confirmed_ack_handler(
+        SERVICE_CONFIRMED_READ_RANGE, My_Read_Range_Ack_Handler);
     /* handle the Simple ACK coming back */
     apdu_set_confirmed_simple_ack_handler(
         SERVICE_CONFIRMED_WRITE_PROPERTY, MyWritePropertySimpleAckHandler);
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE,
+        MyWritePropertySimpleAckHandler);
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, MyWritePropertySimpleAckHandler);
     /* handle any errors coming back */
     apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, MyErrorHandler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, MyErrorHandler);
     apdu_set_error_handler(SERVICE_CONFIRMED_WRITE_PROPERTY, MyErrorHandler);
+    apdu_set_error_handler(SERVICE_CONFIRMED_SUBSCRIBE_COV, MyErrorHandler);
+    apdu_set_error_handler(SERVICE_CONFIRMED_READ_RANGE, MyErrorHandler);
+    apdu_set_complex_error_handler(
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE,
+        My_Write_Property_Multiple_Error_Handler);
     apdu_set_abort_handler(MyAbortHandler);
     apdu_set_reject_handler(MyRejectHandler);
     /* configure the address cache */
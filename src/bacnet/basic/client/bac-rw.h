@@ -7,11 +7,14 @@
  */
 #ifndef BACNET_BASIC_CLIENT_READ_WRITE_H
 #define BACNET_BASIC_CLIENT_READ_WRITE_H
+#include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/bacapp.h"
+#include "bacnet/readrange.h"
 #include "bacnet/rp.h"
 
 /**
@@ -42,6 +45,76 @@ typedef void (*bacnet_read_write_device_callback_t)(
     int segmentation,
     uint16_t vendor_id);
 
+/**
+ * Give the result of a queued request to its requester
+ *
+ * @param context [in] context that was given when the request was queued
+ * @param device_instance [in] device instance number where data originated
+ * @param rp_data [in] Pointer to the BACNET_READ_PROPERTY_DATA structure,
+ *  with the object, property, and array index of the result, and the
+ *  error class and error code when the request failed.
+ * @param value [in] pointer to the decoded value from a read, or NULL when
+ *  the request failed, or a write or a COV subscription has finished
+ *  with ERROR_CODE_SUCCESS
+ */
+typedef void (*bacnet_read_write_result_callback_t)(
+    void *context,
+    uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value);
+
+/**
+ * Give the ReadRange-ACK, or the failure, of a queued ReadRange request
+ *
+ * @param context [in] context that was given when the request was queued
+ * @param device_instance [in] device instance number where data originated
+ * @param data [in] the decoded ReadRange-ACK, with the encoded items in
+ *  its application data, or the request with no items and the error
+ *  class and error code when the request failed
+ */
+typedef void (*bacnet_read_range_result_callback_t)(
+    void *context, uint32_t device_instance, BACNET_READ_RANGE_DATA *data);
+
+/* an independent set of requests, with its own queue and callbacks.
+   The contexts share the TSM, the address cache, the datalink, and the
+   transmit buffer of the stack, so all of them, and the functions without
+   a context that use the default context, are run from one thread only.
+   The data and discover clients each use the default context, so only
+   one of them is used at a time. */
+typedef struct bacnet_read_write_context BACNET_READ_WRITE_CONTEXT;
+
+/**
+ * Save the requested ReadProperty data of a context to a data store
+ *
+ * @param rw_context [in] context of the request
+ * @param device_instance [in] device instance number where data originated
+ * @param rp_data [in] Pointer to the BACNET_READ_PROPERTY_DATA structure,
+ *  which is packed with the information from the ReadProperty request.
+ * @param value [in] pointer to the BACNET_APPLICATION_DATA_VALUE structure
+ *  which is packed with the decoded value from the ReadProperty request.
+ */
+typedef void (*bacnet_read_write_context_value_callback_t)(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value);
+
+/**
+ * Save the I-Am service data that passed the filter of a context
+ *
+ * @param rw_context [in] context whose vendor filter the I-Am passed
+ * @param device_instance [in] device instance number where data originated
+ * @param max_apdu [in] maximum APDU size
+ * @param segmentation [in] segmentation flag
+ * @param vendor_id [in] vendor identifier
+ */
+typedef void (*bacnet_read_write_context_device_callback_t)(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_instance,
+    unsigned max_apdu,
+    int segmentation,
+    uint16_t vendor_id);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -49,12 +122,111 @@ extern "C" {
 BACNET_STACK_EXPORT
 void bacnet_read_write_init(void);
 BACNET_STACK_EXPORT
+BACNET_READ_WRITE_CONTEXT *bacnet_read_write_context_create(void);
+BACNET_STACK_EXPORT
+void bacnet_read_write_context_delete(BACNET_READ_WRITE_CONTEXT *context);
+BACNET_STACK_EXPORT
+bool bacnet_read_write_context_idle(
+    const BACNET_READ_WRITE_CONTEXT *rw_context);
+BACNET_STACK_EXPORT
+bool bacnet_read_write_context_busy(
+    const BACNET_READ_WRITE_CONTEXT *rw_context);
+BACNET_STACK_EXPORT
+size_t bacnet_read_write_context_queue_count(
+    const BACNET_READ_WRITE_CONTEXT *rw_context);
+BACNET_STACK_EXPORT
+void bacnet_read_write_context_queue_limit_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context, size_t limit);
+BACNET_STACK_EXPORT
+unsigned bacnet_read_write_context_active_count(
+    const BACNET_READ_WRITE_CONTEXT *rw_context);
+BACNET_STACK_EXPORT
+unsigned bacnet_read_write_context_device_requests(
+    const BACNET_READ_WRITE_CONTEXT *rw_context, uint32_t device_id);
+BACNET_STACK_EXPORT
+void bacnet_read_write_context_requests_max_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    unsigned requests_max,
+    unsigned device_requests_max);
+BACNET_STACK_EXPORT
+void bacnet_read_write_context_write_window_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context, uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void bacnet_read_write_context_vendor_id_filter_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context, uint16_t vendor_id);
+BACNET_STACK_EXPORT
+uint16_t bacnet_read_write_context_vendor_id_filter(
+    const BACNET_READ_WRITE_CONTEXT *rw_context);
+BACNET_STACK_EXPORT
+void bacnet_read_write_context_value_callback_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    bacnet_read_write_context_value_callback_t callback);
+BACNET_STACK_EXPORT
+void bacnet_read_write_context_device_callback_set(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    bacnet_read_write_context_device_callback_t callback);
+BACNET_STACK_EXPORT
+bool bacnet_read_write_context_read_property(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index,
+    bacnet_read_write_result_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_read_write_context_read_range(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t sequence_number,
+    int32_t count,
+    bacnet_read_range_result_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_read_write_context_subscribe_cov(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t lifetime,
+    bacnet_read_write_result_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_read_write_context_write_property(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority,
+    uint32_t array_index,
+    bacnet_read_write_result_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
 void bacnet_read_write_task(void);
 BACNET_STACK_EXPORT
 bool bacnet_read_write_idle(void);
 BACNET_STACK_EXPORT
 bool bacnet_read_write_busy(void);
 BACNET_STACK_EXPORT
+size_t bacnet_read_write_queue_count(void);
+BACNET_STACK_EXPORT
+void bacnet_read_write_queue_limit_set(size_t limit);
+BACNET_STACK_EXPORT
+unsigned bacnet_read_write_active_count(void);
+BACNET_STACK_EXPORT
+unsigned bacnet_read_write_device_requests(uint32_t device_id);
+BACNET_STACK_EXPORT
+void bacnet_write_property_multiple_window_set(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void bacnet_read_write_requests_max_set(
+    unsigned requests_max, unsigned device_requests_max);
+BACNET_STACK_EXPORT
 bool bacnet_read_property_queue(
     uint32_t device_id,
     BACNET_OBJECT_TYPE object_type,
@@ -115,6 +287,44 @@ bool bacnet_write_property_boolean_queue(
     uint8_t priority,
     uint32_t array_index);
 BACNET_STACK_EXPORT
+bool bacnet_read_property_queue_callback(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index,
+    bacnet_read_write_result_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_read_range_queue_callback(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t sequence_number,
+    int32_t count,
+    bacnet_read_range_result_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_subscribe_cov_queue_callback(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t lifetime,
+    bacnet_read_write_result_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_write_property_queue_callback(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority,
+    uint32_t array_index,
+    bacnet_read_write_result_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
 void bacnet_read_write_value_callback_set(
     bacnet_read_write_value_callback_t callback);
 BACNET_STACK_EXPORT
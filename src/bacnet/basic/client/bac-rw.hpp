@@ -0,0 +1,490 @@
+/**
+ * @file
+ * @brief C++20 coroutine API to read and write properties of other
+ * BACnet devices, over the queued requests of the C read/write client.
+ *
+ * The requests are queued with the bacnet_*_queue_callback() functions,
+ * so that the reads to one device are sent together with
+ * ReadPropertyMultiple when the device supports it.  Nothing runs in
+ * another thread: the results are given to the awaiters by the callbacks
+ * of the C client, and the coroutines are resumed by
+ * bacnet::read_write_task(), which is called from the same loop that
+ * calls npdu_handler() and bacnet_read_write_task().
+ *
+ * @code
+ * bacnet::task poll(uint32_t device_id)
+ * {
+ *     auto result = co_await bacnet::read_property(
+ *         device_id, OBJECT_ANALOG_INPUT, 1, PROP_PRESENT_VALUE);
+ *     if (result.ok()) {
+ *         printf("%f\n", result.values[0].type.Real);
+ *     }
+ * }
+ * @endcode
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_READ_WRITE_HPP
+#define BACNET_BASIC_CLIENT_READ_WRITE_HPP
+#if defined(__cplusplus) && (__cplusplus >= 202002L) && \
+    defined(__has_include)
+#if __has_include(<coroutine>)
+/* before the stack headers, which define the min() and max() macros */
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/rp.h"
+#include "bacnet/basic/client/bac-rw.h"
+
+namespace bacnet {
+
+/**
+ * @brief The result of one request: the error class and error code,
+ * and the decoded values of a read, one for each element of an array.
+ */
+struct result {
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = BACNET_MAX_INSTANCE;
+    BACNET_PROPERTY_ID object_property = MAX_BACNET_PROPERTY_ID;
+    uint32_t array_index = BACNET_ARRAY_ALL;
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_SERVICES;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+    std::vector<BACNET_APPLICATION_DATA_VALUE> values;
+
+    bool ok() const noexcept
+    {
+        return error_code == ERROR_CODE_SUCCESS;
+    }
+};
+
+/**
+ * @brief A property to read with bacnet::read_properties()
+ */
+struct point {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    uint32_t array_index = BACNET_ARRAY_ALL;
+};
+
+/**
+ * @brief A coroutine that starts when it is called, and that is not
+ * awaited: its frame is freed when it returns.
+ */
+struct task {
+    struct promise_type {
+        task get_return_object() noexcept
+        {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() noexcept
+        {
+        }
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+namespace detail {
+
+/**
+ * @brief Base of the awaiters: the suspended coroutine, and the link
+ * in the list of the awaiters that have their result.
+ */
+class awaiter_base {
+  public:
+    awaiter_base() = default;
+    awaiter_base(const awaiter_base &) = delete;
+    awaiter_base &operator=(const awaiter_base &) = delete;
+
+  protected:
+    /* the C client calls back from npdu_handler(), while the values of
+       an array are still being decoded, so the coroutine is resumed
+       later from read_write_task() */
+    void ready() noexcept
+    {
+        if (!queued_) {
+            queued_ = true;
+            next_ = nullptr;
+            *ready_tail() = this;
+            ready_tail() = &next_;
+        }
+    }
+    static void store(
+        result &r,
+        const BACNET_READ_PROPERTY_DATA *rp_data,
+        const BACNET_APPLICATION_DATA_VALUE *value)
+    {
+        r.object_type = rp_data->object_type;
+        r.object_instance = rp_data->object_instance;
+        r.object_property = rp_data->object_property;
+        if (value) {
+            r.values.push_back(*value);
+            r.values.back().next = nullptr;
+        } else {
+            r.error_class = rp_data->error_class;
+            r.error_code = rp_data->error_code;
+        }
+    }
+    static void queue_failed(result &r) noexcept
+    {
+        r.error_class = ERROR_CLASS_RESOURCES;
+        r.error_code = ERROR_CODE_NO_SPACE_FOR_OBJECT;
+    }
+
+    std::coroutine_handle<> handle_;
+
+  private:
+    friend void resume_ready();
+    static awaiter_base *&ready_head() noexcept
+    {
+        static awaiter_base *head = nullptr;
+        return head;
+    }
+    static awaiter_base **&ready_tail() noexcept
+    {
+        static awaiter_base **tail = &ready_head();
+        return tail;
+    }
+
+    awaiter_base *next_ = nullptr;
+    bool queued_ = false;
+};
+
+/**
+ * @brief Resume the coroutines whose requests have their result
+ */
+inline void resume_ready()
+{
+    awaiter_base *awaiter;
+
+    while ((awaiter = awaiter_base::ready_head()) != nullptr) {
+        awaiter_base::ready_head() = awaiter->next_;
+        if (!awaiter->next_) {
+            awaiter_base::ready_tail() = &awaiter_base::ready_head();
+        }
+        /* the awaiter is freed when its coroutine continues */
+        awaiter->handle_.resume();
+    }
+}
+
+/**
+ * @brief Awaiter of one queued ReadProperty, WriteProperty, or
+ * SubscribeCOV request
+ */
+class request_awaiter : public awaiter_base {
+  public:
+    enum class kind { read, write, subscribe_cov };
+
+    request_awaiter(
+        kind k,
+        uint32_t device_id,
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        uint32_t array_index)
+        : kind_(k)
+        , device_id_(device_id)
+    {
+        result_.object_type = object_type;
+        result_.object_instance = object_instance;
+        result_.object_property = object_property;
+        result_.array_index = array_index;
+    }
+    request_awaiter(
+        uint32_t device_id,
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        const BACNET_APPLICATION_DATA_VALUE &value,
+        uint8_t priority,
+        uint32_t array_index)
+        : request_awaiter(
+              kind::write,
+              device_id,
+              object_type,
+              object_instance,
+              object_property,
+              array_index)
+    {
+        value_ = value;
+        priority_ = priority;
+    }
+    request_awaiter(
+        uint32_t device_id,
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance,
+        uint32_t lifetime)
+        : request_awaiter(
+              kind::subscribe_cov,
+              device_id,
+              object_type,
+              object_instance,
+              PROP_PRESENT_VALUE,
+              BACNET_ARRAY_ALL)
+    {
+        lifetime_ = lifetime;
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        bool status = false;
+
+        handle_ = handle;
+        switch (kind_) {
+            case kind::read:
+                status = bacnet_read_property_queue_callback(
+                    device_id_, result_.object_type, result_.object_instance,
+                    result_.object_property, result_.array_index, callback,
+                    this);
+                break;
+            case kind::write:
+                status = bacnet_write_property_queue_callback(
+                    device_id_, result_.object_type, result_.object_instance,
+                    result_.object_property, &value_, priority_,
+                    result_.array_index, callback, this);
+                break;
+            case kind::subscribe_cov:
+                status = bacnet_subscribe_cov_queue_callback(
+                    device_id_, result_.object_type, result_.object_instance,
+                    lifetime_, callback, this);
+                break;
+            default:
+                break;
+        }
+        if (!status) {
+            queue_failed(result_);
+        }
+
+        return status;
+    }
+    result await_resume() noexcept
+    {
+        return std::move(result_);
+    }
+
+  private:
+    static void callback(
+        void *context,
+        uint32_t device_instance,
+        BACNET_READ_PROPERTY_DATA *rp_data,
+        BACNET_APPLICATION_DATA_VALUE *value)
+    {
+        request_awaiter *awaiter = static_cast<request_awaiter *>(context);
+
+        (void)device_instance;
+        store(awaiter->result_, rp_data, value);
+        awaiter->ready();
+    }
+
+    kind kind_;
+    uint32_t device_id_;
+    BACNET_APPLICATION_DATA_VALUE value_ = {};
+    uint8_t priority_ = BACNET_NO_PRIORITY;
+    uint32_t lifetime_ = 0;
+    result result_;
+};
+
+/**
+ * @brief Awaiter of the reads of many properties of one device, that
+ * resumes once when all of the reads have their result.
+ */
+class batch_awaiter : public awaiter_base {
+  public:
+    batch_awaiter(uint32_t device_id, const std::vector<point> &points)
+        : device_id_(device_id)
+        , slots_(points.size())
+    {
+        std::size_t i;
+
+        results_.resize(points.size());
+        for (i = 0; i < points.size(); i++) {
+            slots_[i].owner = this;
+            slots_[i].index = i;
+            results_[i].object_type = points[i].object_type;
+            results_[i].object_instance = points[i].object_instance;
+            results_[i].object_property = points[i].object_property;
+            results_[i].array_index = points[i].array_index;
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        return results_.empty();
+    }
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        std::size_t i;
+
+        handle_ = handle;
+        for (i = 0; i < results_.size(); i++) {
+            if (bacnet_read_property_queue_callback(
+                    device_id_, results_[i].object_type,
+                    results_[i].object_instance, results_[i].object_property,
+                    results_[i].array_index, callback, &slots_[i])) {
+                pending_++;
+            } else {
+                queue_failed(results_[i]);
+            }
+        }
+
+        return pending_ > 0;
+    }
+    std::vector<result> await_resume() noexcept
+    {
+        return std::move(results_);
+    }
+
+  private:
+    struct slot {
+        batch_awaiter *owner;
+        std::size_t index;
+        bool done = false;
+    };
+
+    static void callback(
+        void *context,
+        uint32_t device_instance,
+        BACNET_READ_PROPERTY_DATA *rp_data,
+        BACNET_APPLICATION_DATA_VALUE *value)
+    {
+        slot *s = static_cast<slot *>(context);
+        batch_awaiter *awaiter = s->owner;
+
+        (void)device_instance;
+        store(awaiter->results_[s->index], rp_data, value);
+        if (!s->done) {
+            s->done = true;
+            if (--awaiter->pending_ == 0) {
+                awaiter->ready();
+            }
+        }
+    }
+
+    uint32_t device_id_;
+    std::vector<slot> slots_;
+    std::vector<result> results_;
+    std::size_t pending_ = 0;
+};
+
+} /* namespace detail */
+
+/**
+ * @brief Read a property of another device
+ * @param device_id [in] device instance number of the device
+ * @param object_type [in] type of the object to read
+ * @param object_instance [in] instance number of the object to read
+ * @param object_property [in] property to read
+ * @param array_index [in] array index, or BACNET_ARRAY_ALL
+ * @return awaitable of a bacnet::result with the decoded values
+ */
+inline detail::request_awaiter read_property(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index = BACNET_ARRAY_ALL)
+{
+    return detail::request_awaiter(
+        detail::request_awaiter::kind::read, device_id, object_type,
+        object_instance, object_property, array_index);
+}
+
+/**
+ * @brief Read many properties of another device.  The reads are sent
+ * together with ReadPropertyMultiple when the device supports it.
+ * @param device_id [in] device instance number of the device
+ * @param points [in] the properties to read
+ * @return awaitable of the bacnet::result of each point, in order
+ */
+inline detail::batch_awaiter
+read_properties(uint32_t device_id, const std::vector<point> &points)
+{
+    return detail::batch_awaiter(device_id, points);
+}
+
+/**
+ * @brief Write a property of another device
+ * @param device_id [in] device instance number of the device
+ * @param object_type [in] type of the object to write
+ * @param object_instance [in] instance number of the object to write
+ * @param object_property [in] property to write
+ * @param value [in] the value to write: NULL, BOOLEAN, REAL, Unsigned,
+ *  Signed, or ENUMERATED
+ * @param priority [in] BACnet priority 1..16, or BACNET_NO_PRIORITY
+ * @param array_index [in] array index, or BACNET_ARRAY_ALL
+ * @return awaitable of a bacnet::result with no values
+ */
+inline detail::request_awaiter write_property(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    const BACNET_APPLICATION_DATA_VALUE &value,
+    uint8_t priority = BACNET_NO_PRIORITY,
+    uint32_t array_index = BACNET_ARRAY_ALL)
+{
+    return detail::request_awaiter(
+        device_id, object_type, object_instance, object_property, value,
+        priority, array_index);
+}
+
+/**
+ * @brief Subscribe to the COV notifications of an object of another
+ * device.  The notifications are given to the COV handlers of the
+ * application.
+ * @param device_id [in] device instance number of the device
+ * @param object_type [in] type of the object
+ * @param object_instance [in] instance number of the object
+ * @param lifetime [in] seconds that the subscription lasts, or 0
+ * @return awaitable of a bacnet::result with no values
+ */
+inline detail::request_awaiter subscribe_cov(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t lifetime)
+{
+    return detail::request_awaiter(
+        device_id, object_type, object_instance, lifetime);
+}
+
+/**
+ * @brief Run the C read/write client, and resume the coroutines whose
+ * requests have their result.  Call it in place of
+ * bacnet_read_write_task() in the loop of the application.
+ */
+inline void read_write_task()
+{
+    detail::resume_ready();
+    bacnet_read_write_task();
+    detail::resume_ready();
+}
+
+} /* namespace bacnet */
+
+#endif /* __has_include(<coroutine>) */
+#endif /* C++20 */
+#endif
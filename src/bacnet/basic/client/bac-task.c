@@ -34,6 +34,7 @@
 #include "bacnet/basic/object/device.h"
 /* us */
 #include "bacnet/basic/client/bac-rw.h"
+#include "bacnet/basic/client/bac-command.h"
 #include "bacnet/basic/client/bac-data.h"
 #include "bacnet/basic/client/bac-task.h"
 
@@ -78,6 +79,7 @@ void bacnet_task(void)
         tsm_timer_milliseconds(mstimer_interval(&BACnet_TSM_Timer));
     }
     bacnet_data_task();
+    bacnet_command_task();
 }
 
 /**
@@ -104,6 +106,7 @@ void bacnet_task_init(void)
         SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL,
         handler_device_communication_control);
     bacnet_data_init();
+    bacnet_command_init();
     mstimer_set(&BACnet_Task_Timer, 1000);
     mstimer_set(&BACnet_TSM_Timer, 50);
 }
@@ -0,0 +1,556 @@
+/**
+ * @file
+ * @brief Admission control of the received NPDU
+ * @details The admission control sits between the datalink receive and
+ *  npdu_handler(), so that a broadcast storm or a misbehaving client
+ *  cannot keep the device busy until every confirmed request times out.
+ *  Each source has a token bucket that is refilled at the configured
+ *  rate, and a request from a source with an empty bucket is dropped.
+ *  The last quarter of the bucket is kept for the requests that are not
+ *  reads, so that writes are still admitted while bulk reads are not.
+ *  A Who-Is or Who-Has that a source sends again, and a confirmed
+ *  request that a source sends again with the same invoke ID, are
+ *  dropped while the first one is remembered.  Replies and network
+ *  layer messages are always admitted, and read requests are deferred
+ *  until the other messages that were received with them are handled.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacaddr.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/bits.h"
+#include "bacnet/basic/sys/keyhash.h"
+#include "bacnet/basic/npdu/h_admission.h"
+
+/* tokens are counted in thousandths, so that a timer of a few
+   milliseconds still refills the buckets */
+#define ADMISSION_TOKEN 1000UL
+
+/* the token bucket of a source */
+struct bacnet_admission_source {
+    bool used;
+    BACNET_ADDRESS address;
+    uint32_t tokens;
+    uint32_t idle;
+};
+
+/* a recent request of a source, to find its duplicates */
+struct bacnet_admission_recent {
+    bool used;
+    BACNET_ADDRESS address;
+    uint32_t key;
+    uint16_t age;
+};
+
+/* a read request that waits for the other messages */
+struct bacnet_admission_deferral {
+    BACNET_ADDRESS address;
+    uint16_t pdu_len;
+    uint8_t pdu[MAX_PDU];
+};
+
+static struct bacnet_admission_source
+    Admission_Source[BACNET_ADMISSION_SOURCES_MAX];
+static struct bacnet_admission_recent
+    Admission_Recent[BACNET_ADMISSION_RECENT_MAX];
+static struct bacnet_admission_deferral
+    Admission_Deferral[BACNET_ADMISSION_DEFER_MAX];
+static unsigned Admission_Deferral_Head;
+static unsigned Admission_Deferral_Count;
+/* requests per second of each source, and the size of its bucket */
+static uint16_t Admission_Rate;
+static uint16_t Admission_Burst;
+static unsigned long Admission_Accepted;
+static unsigned long Admission_Deferred;
+static unsigned long Admission_Dropped[BACNET_ADMISSION_DROP_MAX];
+
+/**
+ * @brief Find the offset of the APDU of a received NPDU
+ * @param pdu [in] the received NPDU
+ * @param pdu_len [in] number of bytes in the NPDU
+ * @param src [in,out] the source address, which is given the network
+ *  source address of the NPDU if it has one
+ * @param network_layer_message [out] true if the NPDU is a network
+ *  layer message
+ * @return offset of the APDU, or 0 if the NPDU cannot be decoded
+ */
+static uint16_t admission_apdu_offset(
+    const uint8_t *pdu,
+    uint16_t pdu_len,
+    BACNET_ADDRESS *src,
+    bool *network_layer_message)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    if (!pdu || (pdu_len < 2) || (pdu[0] != BACNET_PROTOCOL_VERSION)) {
+        return 0;
+    }
+    len = bacnet_npdu_decode(pdu, pdu_len, &dest, src, &npdu_data);
+    if ((len <= 0) || (len > pdu_len)) {
+        return 0;
+    }
+    *network_layer_message = npdu_data.network_layer_message;
+
+    return (uint16_t)len;
+}
+
+/**
+ * @brief Classify an APDU for the admission control
+ * @param apdu [in] the APDU
+ * @param apdu_len [in] number of bytes in the APDU
+ * @return the admission class of the APDU
+ */
+static BACNET_ADMISSION_CLASS
+admission_apdu_classify(const uint8_t *apdu, uint16_t apdu_len)
+{
+    uint8_t service_choice;
+
+    if (apdu_len < 1) {
+        return BACNET_ADMISSION_CLASS_INVALID;
+    }
+    switch (apdu[0] & 0xF0) {
+        case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
+            if (apdu_len < 4) {
+                return BACNET_ADMISSION_CLASS_INVALID;
+            }
+            if (apdu[0] & BIT(3)) {
+                /* the segments of a request stay in their order */
+                return BACNET_ADMISSION_CLASS_WRITE;
+            }
+            service_choice = apdu[3];
+            if ((service_choice == SERVICE_CONFIRMED_READ_PROPERTY) ||
+                (service_choice == SERVICE_CONFIRMED_READ_PROP_MULTIPLE) ||
+                (service_choice == SERVICE_CONFIRMED_READ_RANGE) ||
+                (service_choice == SERVICE_CONFIRMED_ATOMIC_READ_FILE)) {
+                return BACNET_ADMISSION_CLASS_READ;
+            }
+            return BACNET_ADMISSION_CLASS_WRITE;
+        case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
+            if (apdu_len < 2) {
+                return BACNET_ADMISSION_CLASS_INVALID;
+            }
+            return BACNET_ADMISSION_CLASS_UNCONFIRMED;
+        case PDU_TYPE_SIMPLE_ACK:
+        case PDU_TYPE_COMPLEX_ACK:
+        case PDU_TYPE_SEGMENT_ACK:
+        case PDU_TYPE_ERROR:
+        case PDU_TYPE_REJECT:
+        case PDU_TYPE_ABORT:
+            return BACNET_ADMISSION_CLASS_REPLY;
+        default:
+            break;
+    }
+
+    return BACNET_ADMISSION_CLASS_INVALID;
+}
+
+/**
+ * @brief Classify a received NPDU for the admission control
+ * @param pdu [in] the received NPDU
+ * @param pdu_len [in] number of bytes in the NPDU
+ * @return the admission class of the NPDU
+ */
+BACNET_ADMISSION_CLASS
+bacnet_admission_classify(const uint8_t *pdu, uint16_t pdu_len)
+{
+    BACNET_ADDRESS src = { 0 };
+    bool network_layer_message = false;
+    uint16_t offset;
+
+    offset = admission_apdu_offset(pdu, pdu_len, &src, &network_layer_message);
+    if (offset == 0) {
+        return BACNET_ADMISSION_CLASS_INVALID;
+    }
+    if (network_layer_message) {
+        return BACNET_ADMISSION_CLASS_NETWORK;
+    }
+
+    return admission_apdu_classify(&pdu[offset], pdu_len - offset);
+}
+
+/**
+ * @brief Get the key of a request that its duplicates have
+ * @param apdu [in] the APDU of a confirmed or unconfirmed request
+ * @param apdu_len [in] number of bytes in the APDU
+ * @param key [out] the key of the request
+ * @return true if the duplicates of the request are dropped
+ */
+static bool
+admission_duplicate_key(const uint8_t *apdu, uint16_t apdu_len, uint32_t *key)
+{
+    if ((apdu[0] & 0xF0) == PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
+        if (apdu[0] & BIT(3)) {
+            /* the segments of a request share the invoke ID */
+            return false;
+        }
+        /* the invoke ID and the service choice */
+        *key = 0x80000000UL | ((uint32_t)apdu[3] << 8) | apdu[2];
+        return true;
+    }
+    if ((apdu[1] == SERVICE_UNCONFIRMED_WHO_IS) ||
+        (apdu[1] == SERVICE_UNCONFIRMED_WHO_HAS)) {
+        /* the whole request, with its limits */
+        *key = Keyhash_FNV1a(apdu, apdu_len) & 0x7FFFFFFFUL;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Find a recent request of a source
+ * @param src [in] the source of the request
+ * @param key [in] the key of the request
+ * @return the recent request, or NULL if none was found
+ */
+static struct bacnet_admission_recent *
+admission_recent_find(const BACNET_ADDRESS *src, uint32_t key)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_ADMISSION_RECENT_MAX; i++) {
+        if (Admission_Recent[i].used && (Admission_Recent[i].key == key) &&
+            bacnet_address_same(&Admission_Recent[i].address, src)) {
+            return &Admission_Recent[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Remember a request of a source, in place of the oldest one
+ *  when every entry is used
+ * @param src [in] the source of the request
+ * @param key [in] the key of the request
+ */
+static void admission_recent_add(const BACNET_ADDRESS *src, uint32_t key)
+{
+    struct bacnet_admission_recent *recent = &Admission_Recent[0];
+    unsigned i;
+
+    for (i = 0; i < BACNET_ADMISSION_RECENT_MAX; i++) {
+        if (!Admission_Recent[i].used) {
+            recent = &Admission_Recent[i];
+            break;
+        }
+        if (Admission_Recent[i].age > recent->age) {
+            recent = &Admission_Recent[i];
+        }
+    }
+    recent->used = true;
+    bacnet_address_copy(&recent->address, src);
+    recent->key = key;
+    recent->age = 0;
+}
+
+/**
+ * @brief Find the token bucket of a source, and give a new source the
+ *  bucket of the source that has been idle for the longest time
+ * @param src [in] the source
+ * @return the token bucket of the source
+ */
+static struct bacnet_admission_source *
+admission_source_find(const BACNET_ADDRESS *src)
+{
+    struct bacnet_admission_source *source = NULL;
+    unsigned i;
+
+    for (i = 0; i < BACNET_ADMISSION_SOURCES_MAX; i++) {
+        if (Admission_Source[i].used &&
+            bacnet_address_same(&Admission_Source[i].address, src)) {
+            return &Admission_Source[i];
+        }
+    }
+    for (i = 0; i < BACNET_ADMISSION_SOURCES_MAX; i++) {
+        if (!Admission_Source[i].used) {
+            source = &Admission_Source[i];
+            break;
+        }
+        if (!source || (Admission_Source[i].idle > source->idle)) {
+            source = &Admission_Source[i];
+        }
+    }
+    source->used = true;
+    bacnet_address_copy(&source->address, src);
+    source->tokens = Admission_Burst * ADMISSION_TOKEN;
+    source->idle = 0;
+
+    return source;
+}
+
+/**
+ * @brief Take a token from the bucket of a source
+ * @param src [in] the source of the request
+ * @param reserve [in] number of tokens that are kept for the requests
+ *  that have priority
+ * @return true if the source had a token for the request
+ */
+static bool admission_token_take(const BACNET_ADDRESS *src, uint32_t reserve)
+{
+    struct bacnet_admission_source *source;
+
+    source = admission_source_find(src);
+    source->idle = 0;
+    if (source->tokens < ((reserve + 1) * ADMISSION_TOKEN)) {
+        return false;
+    }
+    source->tokens -= ADMISSION_TOKEN;
+
+    return true;
+}
+
+/**
+ * @brief Queue a read request behind the other messages
+ * @param src [in] the source address of the NPDU
+ * @param pdu [in] the received NPDU
+ * @param pdu_len [in] number of bytes in the NPDU
+ * @return true if the request was queued
+ */
+static bool admission_defer(
+    const BACNET_ADDRESS *src, const uint8_t *pdu, uint16_t pdu_len)
+{
+    struct bacnet_admission_deferral *deferral;
+    unsigned index;
+
+    if ((Admission_Deferral_Count >= BACNET_ADMISSION_DEFER_MAX) ||
+        (pdu_len > sizeof(deferral->pdu))) {
+        return false;
+    }
+    index = (Admission_Deferral_Head + Admission_Deferral_Count) %
+        BACNET_ADMISSION_DEFER_MAX;
+    deferral = &Admission_Deferral[index];
+    bacnet_address_copy(&deferral->address, src);
+    memcpy(deferral->pdu, pdu, pdu_len);
+    deferral->pdu_len = pdu_len;
+    Admission_Deferral_Count++;
+
+    return true;
+}
+
+/**
+ * @brief Decide if a received NPDU is handled now, later, or not at all
+ * @param src [in] the source address of the NPDU from the datalink
+ * @param pdu [in] the received NPDU
+ * @param pdu_len [in] number of bytes in the NPDU
+ * @return BACNET_ADMISSION_ACCEPT if the NPDU is given to npdu_handler()
+ *  now, BACNET_ADMISSION_DEFER if it was queued and is taken later with
+ *  bacnet_admission_deferred(), or BACNET_ADMISSION_DROP if it is dropped
+ */
+BACNET_ADMISSION_RESULT bacnet_admission_check(
+    const BACNET_ADDRESS *src, const uint8_t *pdu, uint16_t pdu_len)
+{
+    BACNET_ADDRESS address = { 0 };
+    BACNET_ADMISSION_CLASS admission_class;
+    bool network_layer_message = false;
+    uint32_t reserve = 0;
+    uint32_t key = 0;
+    bool duplicate_key;
+    uint16_t offset;
+
+    if (!bacnet_admission_enabled()) {
+        return BACNET_ADMISSION_ACCEPT;
+    }
+    if (src) {
+        bacnet_address_copy(&address, src);
+    }
+    offset =
+        admission_apdu_offset(pdu, pdu_len, &address, &network_layer_message);
+    if ((offset == 0) || network_layer_message) {
+        /* the network layer handles these */
+        Admission_Accepted++;
+        return BACNET_ADMISSION_ACCEPT;
+    }
+    admission_class = admission_apdu_classify(&pdu[offset], pdu_len - offset);
+    if ((admission_class == BACNET_ADMISSION_CLASS_REPLY) ||
+        (admission_class == BACNET_ADMISSION_CLASS_INVALID)) {
+        Admission_Accepted++;
+        return BACNET_ADMISSION_ACCEPT;
+    }
+    duplicate_key =
+        admission_duplicate_key(&pdu[offset], pdu_len - offset, &key);
+    if (duplicate_key && admission_recent_find(&address, key)) {
+        if (admission_class == BACNET_ADMISSION_CLASS_UNCONFIRMED) {
+            Admission_Dropped[BACNET_ADMISSION_DROP_DISCOVERY]++;
+        } else {
+            Admission_Dropped[BACNET_ADMISSION_DROP_RETRY]++;
+        }
+        return BACNET_ADMISSION_DROP;
+    }
+    if (admission_class != BACNET_ADMISSION_CLASS_WRITE) {
+        reserve = Admission_Burst / 4;
+    }
+    if (!admission_token_take(&address, reserve)) {
+        Admission_Dropped[BACNET_ADMISSION_DROP_RATE]++;
+        return BACNET_ADMISSION_DROP;
+    }
+    if (duplicate_key) {
+        admission_recent_add(&address, key);
+    }
+    if ((admission_class == BACNET_ADMISSION_CLASS_READ) &&
+        admission_defer(src, pdu, pdu_len)) {
+        Admission_Deferred++;
+        return BACNET_ADMISSION_DEFER;
+    }
+    Admission_Accepted++;
+
+    return BACNET_ADMISSION_ACCEPT;
+}
+
+/**
+ * @brief Take the oldest deferred read request
+ * @param src [out] the source address of the NPDU from the datalink
+ * @param pdu [out] buffer for the NPDU
+ * @param pdu_size [in] size of the buffer
+ * @return number of bytes in the NPDU, or 0 if no request is deferred
+ */
+uint16_t
+bacnet_admission_deferred(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_size)
+{
+    struct bacnet_admission_deferral *deferral;
+    uint16_t pdu_len = 0;
+
+    while ((pdu_len == 0) && (Admission_Deferral_Count > 0)) {
+        deferral = &Admission_Deferral[Admission_Deferral_Head];
+        Admission_Deferral_Head =
+            (Admission_Deferral_Head + 1) % BACNET_ADMISSION_DEFER_MAX;
+        Admission_Deferral_Count--;
+        /* a request that does not fit the buffer is dropped */
+        if (deferral->pdu_len <= pdu_size) {
+            bacnet_address_copy(src, &deferral->address);
+            memcpy(pdu, deferral->pdu, deferral->pdu_len);
+            pdu_len = deferral->pdu_len;
+        }
+    }
+
+    return pdu_len;
+}
+
+/**
+ * @brief Refill the token buckets, and forget the old requests
+ * @param milliseconds [in] milliseconds since the last call
+ */
+void bacnet_admission_timer(uint16_t milliseconds)
+{
+    uint32_t tokens_max = Admission_Burst * ADMISSION_TOKEN;
+    uint32_t tokens = (uint32_t)Admission_Rate * milliseconds;
+    unsigned i;
+
+    for (i = 0; i < BACNET_ADMISSION_SOURCES_MAX; i++) {
+        if (!Admission_Source[i].used) {
+            continue;
+        }
+        if ((tokens < tokens_max) &&
+            (Admission_Source[i].tokens < (tokens_max - tokens))) {
+            Admission_Source[i].tokens += tokens;
+        } else {
+            Admission_Source[i].tokens = tokens_max;
+        }
+        if (Admission_Source[i].idle < (UINT32_MAX - milliseconds)) {
+            Admission_Source[i].idle += milliseconds;
+        }
+    }
+    for (i = 0; i < BACNET_ADMISSION_RECENT_MAX; i++) {
+        if (!Admission_Recent[i].used) {
+            continue;
+        }
+        if (Admission_Recent[i].age < (BACNET_ADMISSION_DUPLICATE_MS -
+                                       milliseconds)) {
+            Admission_Recent[i].age += milliseconds;
+        } else {
+            Admission_Recent[i].used = false;
+        }
+    }
+}
+
+/**
+ * @brief Set the rate of the requests that each source may send
+ * @param rate [in] requests per second of each source, or 0 to admit
+ *  every message
+ * @param burst [in] number of requests that a source may send at once
+ */
+void bacnet_admission_rate_set(uint16_t rate, uint16_t burst)
+{
+    unsigned i;
+
+    Admission_Rate = rate;
+    if (burst < 1) {
+        burst = 1;
+    }
+    Admission_Burst = burst;
+    for (i = 0; i < BACNET_ADMISSION_SOURCES_MAX; i++) {
+        Admission_Source[i].used = false;
+    }
+}
+
+/**
+ * @brief Determine if the admission control is enabled
+ * @return true if a rate of the requests is set
+ */
+bool bacnet_admission_enabled(void)
+{
+    return Admission_Rate > 0;
+}
+
+/**
+ * @brief Get the number of messages that were admitted at once
+ * @return the number of admitted messages
+ */
+unsigned long bacnet_admission_accepted(void)
+{
+    return Admission_Accepted;
+}
+
+/**
+ * @brief Get the number of read requests that were deferred
+ * @return the number of deferred read requests
+ */
+unsigned long bacnet_admission_deferred_count(void)
+{
+    return Admission_Deferred;
+}
+
+/**
+ * @brief Get the number of messages that were dropped for a reason
+ * @param reason [in] the reason that the messages were dropped
+ * @return the number of dropped messages
+ */
+unsigned long bacnet_admission_dropped(BACNET_ADMISSION_DROP_REASON reason)
+{
+    if (reason >= BACNET_ADMISSION_DROP_MAX) {
+        return 0;
+    }
+
+    return Admission_Dropped[reason];
+}
+
+/**
+ * @brief Forget the sources and the deferred requests, clear the
+ *  counters, and admit every message until a rate is set
+ */
+void bacnet_admission_init(void)
+{
+    unsigned i;
+
+    memset(Admission_Source, 0, sizeof(Admission_Source));
+    memset(Admission_Recent, 0, sizeof(Admission_Recent));
+    Admission_Deferral_Head = 0;
+    Admission_Deferral_Count = 0;
+    Admission_Rate = 0;
+    Admission_Burst = 1;
+    Admission_Accepted = 0;
+    Admission_Deferred = 0;
+    for (i = 0; i < BACNET_ADMISSION_DROP_MAX; i++) {
+        Admission_Dropped[i] = 0;
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief API for the admission control of the received NPDU
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_NPDU_ADMISSION_H
+#define BACNET_BASIC_NPDU_ADMISSION_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* number of sources that have their own token bucket */
+#ifndef BACNET_ADMISSION_SOURCES_MAX
+#define BACNET_ADMISSION_SOURCES_MAX 32
+#endif
+/* number of recent requests that duplicates are looked for in */
+#ifndef BACNET_ADMISSION_RECENT_MAX
+#define BACNET_ADMISSION_RECENT_MAX 32
+#endif
+/* milliseconds that a request is remembered to find its duplicates */
+#ifndef BACNET_ADMISSION_DUPLICATE_MS
+#define BACNET_ADMISSION_DUPLICATE_MS 1000
+#endif
+/* number of read requests that are deferred behind the other messages */
+#ifndef BACNET_ADMISSION_DEFER_MAX
+#define BACNET_ADMISSION_DEFER_MAX 8
+#endif
+
+typedef enum bacnet_admission_class {
+    /* network layer messages */
+    BACNET_ADMISSION_CLASS_NETWORK = 0,
+    /* acknowledgements, errors, rejects and aborts */
+    BACNET_ADMISSION_CLASS_REPLY,
+    /* confirmed requests that are not reads, such as writes */
+    BACNET_ADMISSION_CLASS_WRITE,
+    /* ReadProperty, ReadPropertyMultiple, ReadRange and AtomicReadFile */
+    BACNET_ADMISSION_CLASS_READ,
+    /* unconfirmed requests, such as Who-Is */
+    BACNET_ADMISSION_CLASS_UNCONFIRMED,
+    /* messages that cannot be decoded */
+    BACNET_ADMISSION_CLASS_INVALID
+} BACNET_ADMISSION_CLASS;
+
+typedef enum bacnet_admission_result {
+    BACNET_ADMISSION_ACCEPT = 0,
+    /* the message was queued, and is taken with bacnet_admission_deferred */
+    BACNET_ADMISSION_DEFER,
+    BACNET_ADMISSION_DROP
+} BACNET_ADMISSION_RESULT;
+
+typedef enum bacnet_admission_drop_reason {
+    /* the source has sent more requests than its rate */
+    BACNET_ADMISSION_DROP_RATE = 0,
+    /* the same Who-Is or Who-Has was received again from the source */
+    BACNET_ADMISSION_DROP_DISCOVERY,
+    /* a confirmed request was received again with the same invoke ID */
+    BACNET_ADMISSION_DROP_RETRY,
+    BACNET_ADMISSION_DROP_MAX
+} BACNET_ADMISSION_DROP_REASON;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_admission_init(void);
+BACNET_STACK_EXPORT
+void bacnet_admission_rate_set(uint16_t rate, uint16_t burst);
+BACNET_STACK_EXPORT
+bool bacnet_admission_enabled(void);
+BACNET_STACK_EXPORT
+BACNET_ADMISSION_CLASS
+bacnet_admission_classify(const uint8_t *pdu, uint16_t pdu_len);
+BACNET_STACK_EXPORT
+BACNET_ADMISSION_RESULT bacnet_admission_check(
+    const BACNET_ADDRESS *src, const uint8_t *pdu, uint16_t pdu_len);
+BACNET_STACK_EXPORT
+uint16_t bacnet_admission_deferred(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_size);
+BACNET_STACK_EXPORT
+void bacnet_admission_timer(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+unsigned long bacnet_admission_accepted(void);
+BACNET_STACK_EXPORT
+unsigned long bacnet_admission_deferred_count(void);
+BACNET_STACK_EXPORT
+unsigned long bacnet_admission_dropped(BACNET_ADMISSION_DROP_REASON reason);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
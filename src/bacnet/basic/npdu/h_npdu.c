@@ -18,6 +18,8 @@
 #include "bacnet/apdu.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/datalink/datalink.h"
 
 #if PRINT_ENABLED
@@ -253,10 +255,15 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
             bacnet_npdu_decode(&pdu[0], pdu_len, &dest, src, &npdu_data);
         if (npdu_data.network_layer_message) {
             if ((dest.net == 0) || (dest.net == BACNET_BROADCAST_NETWORK)) {
+                BACTRACE_NPDU(
+                    BACTRACE_NPDU_NETWORK_MESSAGE, dest.net, src->net,
+                    pdu_len);
                 network_control_handler(
                     src, &npdu_data, &pdu[apdu_offset],
                     (uint16_t)(pdu_len - apdu_offset));
             } else {
+                BACTRACE_NPDU(
+                    BACTRACE_NPDU_DISCARDED, dest.net, src->net, pdu_len);
                 debug_printf("NPDU: message for router. Discarded!\n");
             }
         } else if ((apdu_offset > 0) && (apdu_offset < pdu_len)) {
@@ -270,7 +277,11 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
                     /* hack for 5.4.5.1 - IDLE */
                     /* ConfirmedBroadcastReceived */
                     /* then enter IDLE - ignore the PDU */
+                    BACTRACE_NPDU(
+                        BACTRACE_NPDU_DISCARDED, dest.net, src->net, pdu_len);
                 } else {
+                    BACTRACE_NPDU(
+                        BACTRACE_NPDU_APDU, dest.net, src->net, pdu_len);
                     if (npdu_data.data_expecting_reply) {
                         apdu_network_priority_set(npdu_data.priority);
                     } else {
@@ -281,13 +292,20 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
                         (uint16_t)(pdu_len - apdu_offset));
                 }
             } else {
+                BACTRACE_NPDU(
+                    BACTRACE_NPDU_DISCARDED, dest.net, src->net, pdu_len);
 #if PRINT_ENABLED
                 debug_printf(
                     "NPDU: DNET=%u.  Discarded!\n", (unsigned)dest.net);
 #endif
             }
+        } else {
+            /* unable to be decoded - simply drop */
+            PERFSTAT_COUNT(PERFSTAT_DECODE_ERRORS);
+            BACTRACE_NPDU(BACTRACE_NPDU_DECODE_ERROR, 0, 0, pdu_len);
         }
     } else {
+        BACTRACE_NPDU(BACTRACE_NPDU_DECODE_ERROR, 0, 0, pdu_len);
 #if PRINT_ENABLED
         debug_printf(
             "NPDU: BACnet Protocol Version=%u.  Discarded!\n",
@@ -19,6 +19,7 @@
 #include "bacnet/apdu.h"
 #include "bacnet/bactext.h"
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/sys/bactrace.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/datalink/datalink.h"
@@ -270,13 +271,19 @@ void routing_npdu_handler(
     if (pdu[0] == BACNET_PROTOCOL_VERSION) {
         apdu_offset = bacnet_npdu_decode(pdu, pdu_len, &dest, src, &npdu_data);
         if (apdu_offset <= 0) {
+            BACTRACE_NPDU(BACTRACE_NPDU_DECODE_ERROR, 0, 0, pdu_len);
             debug_printf("NPDU: Decoding failed; Discarded!\n");
         } else if (npdu_data.network_layer_message) {
             if ((dest.net == 0) || (dest.net == BACNET_BROADCAST_NETWORK)) {
+                BACTRACE_NPDU(
+                    BACTRACE_NPDU_NETWORK_MESSAGE, dest.net, src->net,
+                    pdu_len);
                 network_control_handler(
                     src, DNET_list, &npdu_data, &pdu[apdu_offset],
                     (uint16_t)(pdu_len - apdu_offset));
             } else {
+                BACTRACE_NPDU(
+                    BACTRACE_NPDU_DISCARDED, dest.net, src->net, pdu_len);
                 debug_printf("NPDU: message for our router? Discarded!\n");
                 /* The DNET is set, but we don't support downstream routers,
                  * so we just silently drop this network layer message,
@@ -284,13 +291,19 @@ void routing_npdu_handler(
             }
         } else if (apdu_offset <= pdu_len) {
             if ((dest.net == 0) || (npdu_data.hop_count > 1)) {
+                BACTRACE_NPDU(
+                    BACTRACE_NPDU_APDU, dest.net, src->net, pdu_len);
                 routed_apdu_handler(
                     src, &dest, DNET_list, &pdu[apdu_offset],
                     (uint16_t)(pdu_len - apdu_offset));
+            } else {
+                /* hop_count bottomed out and we discard this one. */
+                BACTRACE_NPDU(
+                    BACTRACE_NPDU_DISCARDED, dest.net, src->net, pdu_len);
             }
-            /* Else, hop_count bottomed out and we discard this one. */
         }
     } else {
+        BACTRACE_NPDU(BACTRACE_NPDU_DECODE_ERROR, 0, 0, pdu_len);
         /* Should we send NETWORK_MESSAGE_REJECT_MESSAGE_TO_NETWORK? */
         debug_printf(
             "NPDU: Unsupported BACnet Protocol Version=%u.  Discarded!\n",
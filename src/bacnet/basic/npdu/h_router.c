@@ -0,0 +1,1361 @@
+/**
+ * @file
+ * @brief A basic BACnet router with a port for each datalink
+ * @details The router forwards an NPDU that it receives on one port into
+ *  the send queue of the port of the destination network, and sends the
+ *  queued NPDUs of each port in batches in bacnet_router_task().  When
+ *  the send queue of a port fills up, the other ports are told that the
+ *  networks of the port are busy with Router-Busy-To-Network, and are told
+ *  that they are available with Router-Available-To-Network after the
+ *  queue has drained.  The remote networks are kept in a routing table,
+ *  with a cache of the routes indexed by network number in front of it.
+ *  The packets to an unknown network wait while the network is sought
+ *  with one Who-Is-Router-To-Network for all of them, and a network that
+ *  is not found is unreachable for a while, which is doubled each time
+ *  that it is not found again.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacaddr.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/npdu/h_router.h"
+
+#if (BACNET_ROUTER_CACHE_SIZE & (BACNET_ROUTER_CACHE_SIZE - 1)) != 0
+#error "BACNET_ROUTER_CACHE_SIZE must be a power of two"
+#endif
+
+/* a remote network, and the next router on the path to it */
+struct bacnet_router_route {
+    uint16_t net;
+    /* port of the next router, or NULL if the route is free */
+    BACNET_ROUTING_PORT *port;
+    uint8_t mac[MAX_MAC_LEN];
+    uint8_t mac_len;
+    /* seconds left of a Router-Busy-To-Network from the next router */
+    uint16_t busy_seconds;
+};
+
+/* a network that was looked up */
+struct bacnet_router_cache_entry {
+    uint16_t net;
+    /* port of the network, or NULL if the entry is empty */
+    BACNET_ROUTING_PORT *port;
+    /* route of the network, or NULL if it is directly connected */
+    struct bacnet_router_route *route;
+};
+
+/* an unknown network that is sought, or was not found */
+struct bacnet_router_discovery {
+    /* network number, or 0 if the entry is free */
+    uint16_t net;
+    /* port that the first packet or request came from */
+    BACNET_ROUTING_PORT *port;
+    /* number of Who-Is-Router-To-Network sent while it is sought */
+    uint8_t attempts;
+    /* true if the network was not found */
+    bool unreachable;
+    /* seconds until the next attempt, or while it is unreachable */
+    uint16_t seconds;
+    /* seconds that it is unreachable when it is not found again */
+    uint16_t backoff_seconds;
+};
+
+/* a packet that waits for the route to its network */
+struct bacnet_router_waiting {
+    /* network number of the destination, or 0 if the entry is free */
+    uint16_t net;
+    /* port where the packet came from, and its source on the port */
+    BACNET_ROUTING_PORT *port;
+    BACNET_ADDRESS src;
+    /* routed source and destination of the packet */
+    BACNET_ADDRESS router_src;
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    uint16_t apdu_len;
+    uint8_t apdu[BACNET_ROUTER_PDU_MAX];
+};
+
+static BACNET_ROUTING_PORT *Port_List;
+static struct bacnet_router_route Route_Table[BACNET_ROUTER_ROUTES_MAX];
+static struct bacnet_router_cache_entry Route_Cache[BACNET_ROUTER_CACHE_SIZE];
+static struct bacnet_router_discovery
+    Route_Discovery[BACNET_ROUTER_DISCOVERY_MAX];
+static struct bacnet_router_waiting
+    Route_Waiting[BACNET_ROUTER_DISCOVERY_QUEUE_SIZE];
+/* buffer for the network layer messages of the router */
+static uint8_t Tx_Buffer[BACNET_ROUTER_PDU_MAX];
+/* optional proxy that answers routed requests, such as a cache */
+static bacnet_router_proxy_request_function Proxy_Request;
+static bacnet_router_proxy_response_function Proxy_Response;
+
+static void router_discovery_resolve(uint16_t net);
+
+/**
+ * @brief Forget a network in the route cache
+ * @param net - network number
+ */
+static void route_cache_invalidate(uint16_t net)
+{
+    struct bacnet_router_cache_entry *entry;
+
+    entry = &Route_Cache[net & (BACNET_ROUTER_CACHE_SIZE - 1)];
+    if (entry->net == net) {
+        entry->port = NULL;
+        entry->route = NULL;
+    }
+}
+
+/**
+ * @brief Look up a network in the route cache, and on a miss in the ports
+ *  and in the routing table
+ * @param net - network number
+ * @return the cache entry of the network, or NULL if there is no route
+ */
+static struct bacnet_router_cache_entry *route_lookup(uint16_t net)
+{
+    struct bacnet_router_cache_entry *entry;
+    BACNET_ROUTING_PORT *port;
+    unsigned i;
+
+    if ((net == 0) || (net == BACNET_BROADCAST_NETWORK)) {
+        return NULL;
+    }
+    entry = &Route_Cache[net & (BACNET_ROUTER_CACHE_SIZE - 1)];
+    if (entry->port && (entry->net == net)) {
+        return entry;
+    }
+    port = Port_List;
+    while (port) {
+        if (port->net == net) {
+            entry->net = net;
+            entry->port = port;
+            entry->route = NULL;
+            return entry;
+        }
+        port = port->next;
+    }
+    for (i = 0; i < BACNET_ROUTER_ROUTES_MAX; i++) {
+        if (Route_Table[i].port && (Route_Table[i].net == net)) {
+            entry->net = net;
+            entry->port = Route_Table[i].port;
+            entry->route = &Route_Table[i];
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a port to the router, directly connected to a network
+ * @param port - port to add, which the router uses until cleanup
+ * @param net - network number of the directly connected network
+ * @param address - MAC address of the port on its network, or NULL
+ * @param send_pdu - function to send a PDU out of the datalink of the port
+ */
+void bacnet_router_port_add(
+    BACNET_ROUTING_PORT *port,
+    uint16_t net,
+    const BACNET_ADDRESS *address,
+    bacnet_router_send_pdu_function send_pdu)
+{
+    BACNET_ROUTING_PORT **next = &Port_List;
+
+    if (!port) {
+        return;
+    }
+    while (*next) {
+        if (*next == port) {
+            /* already added */
+            break;
+        }
+        next = &(*next)->next;
+    }
+    if (*next == NULL) {
+        port->next = NULL;
+        *next = port;
+    }
+    port->net = net;
+    if (address) {
+        bacnet_address_copy(&port->address, address);
+    } else {
+        memset(&port->address, 0, sizeof(port->address));
+    }
+    port->send_pdu = send_pdu;
+    port->queue_head = 0;
+    port->queue_count = 0;
+    port->queue_discards = 0;
+    port->busy = false;
+    port->busy_seconds = 0;
+    memset(Route_Cache, 0, sizeof(Route_Cache));
+}
+
+/**
+ * @brief Find the port of a directly connected network
+ * @param net - network number
+ * @return the port, or NULL if the network is not directly connected
+ */
+BACNET_ROUTING_PORT *bacnet_router_port_find(uint16_t net)
+{
+    BACNET_ROUTING_PORT *port = Port_List;
+
+    while (port) {
+        if (port->net == net) {
+            return port;
+        }
+        port = port->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a route to a remote network, or update the address of its
+ *  next router.  A route through another port is kept unless its next
+ *  router is busy.
+ * @param port - port of the next router
+ * @param dnet - network number of the remote network
+ * @param router - address of the next router, or NULL
+ * @return true if the route was added or updated
+ */
+bool bacnet_router_dnet_add(
+    BACNET_ROUTING_PORT *port, uint16_t dnet, const BACNET_ADDRESS *router)
+{
+    struct bacnet_router_cache_entry *entry;
+    struct bacnet_router_route *route = NULL;
+    unsigned i;
+
+    if (!port) {
+        return false;
+    }
+    entry = route_lookup(dnet);
+    if (entry) {
+        route = entry->route;
+        if (!route) {
+            /* never route a directly connected network elsewhere */
+            return false;
+        }
+        if ((route->port != port) && (route->busy_seconds == 0)) {
+            /* keep the route that was learned first */
+            return false;
+        }
+    } else if ((dnet == 0) || (dnet == BACNET_BROADCAST_NETWORK)) {
+        return false;
+    } else {
+        for (i = 0; i < BACNET_ROUTER_ROUTES_MAX; i++) {
+            if (!Route_Table[i].port) {
+                route = &Route_Table[i];
+                break;
+            }
+        }
+        if (!route) {
+            debug_printf("Router: no room for DNET %u\n", (unsigned)dnet);
+            return false;
+        }
+        route->net = dnet;
+    }
+    route->port = port;
+    if (router) {
+        route->mac_len = router->mac_len;
+        memcpy(route->mac, router->mac, MAX_MAC_LEN);
+    } else {
+        route->mac_len = 0;
+    }
+    route->busy_seconds = 0;
+    route_cache_invalidate(dnet);
+    router_discovery_resolve(dnet);
+
+    return true;
+}
+
+/**
+ * @brief Find the port of a network
+ * @param dnet - network number
+ * @param router - [out] MAC address of the next router, if the network
+ *  is not directly connected.  The caller compares the network number of
+ *  the port with dnet to know if the router address was filled.
+ * @return the port, or NULL if there is no route to the network
+ */
+BACNET_ROUTING_PORT *
+bacnet_router_dnet_find(uint16_t dnet, BACNET_ADDRESS *router)
+{
+    struct bacnet_router_cache_entry *entry;
+
+    entry = route_lookup(dnet);
+    if (!entry) {
+        return NULL;
+    }
+    if (entry->route && router) {
+        router->mac_len = entry->route->mac_len;
+        memcpy(router->mac, entry->route->mac, MAX_MAC_LEN);
+    }
+
+    return entry->port;
+}
+
+/**
+ * @brief Determine if the next router to a network said it is busy
+ * @param dnet - network number
+ * @return true if the route to the network is busy
+ */
+bool bacnet_router_dnet_busy(uint16_t dnet)
+{
+    struct bacnet_router_cache_entry *entry;
+
+    entry = route_lookup(dnet);
+    if (entry && entry->route) {
+        return entry->route->busy_seconds > 0;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Find an unknown network that is sought, or was not found
+ * @param net - network number
+ * @return the discovery entry of the network, or NULL if none
+ */
+static struct bacnet_router_discovery *router_discovery_find(uint16_t net)
+{
+    unsigned i;
+
+    if (net == 0) {
+        return NULL;
+    }
+    for (i = 0; i < BACNET_ROUTER_DISCOVERY_MAX; i++) {
+        if (Route_Discovery[i].net == net) {
+            return &Route_Discovery[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Determine if a network was sought and not found, so that the
+ *  messages to it are rejected until it is sought again
+ * @param dnet - network number
+ * @return true if the network is unreachable
+ */
+bool bacnet_router_dnet_unreachable(uint16_t dnet)
+{
+    const struct bacnet_router_discovery *discovery;
+
+    discovery = router_discovery_find(dnet);
+    if (discovery) {
+        return discovery->unreachable && (discovery->seconds > 0);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Set or clear the Router-Busy-To-Network restriction of the routes
+ *  through a router
+ * @param port - port of the router
+ * @param router - address of the router
+ * @param dnet - network number, or 0 for all of the networks of the router
+ * @param busy - true if the router is busy
+ */
+static void route_busy_set(
+    const BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *router,
+    uint16_t dnet,
+    bool busy)
+{
+    struct bacnet_router_route *route;
+    unsigned i;
+
+    for (i = 0; i < BACNET_ROUTER_ROUTES_MAX; i++) {
+        route = &Route_Table[i];
+        if ((route->port == port) && ((dnet == 0) || (route->net == dnet)) &&
+            (route->mac_len == router->mac_len) &&
+            (memcmp(route->mac, router->mac, route->mac_len) == 0)) {
+            route->busy_seconds = busy ? BACNET_ROUTER_BUSY_SECONDS : 0;
+        }
+    }
+}
+
+/**
+ * @brief Initialize the global broadcast address
+ * @param dest - address to be filled with the broadcast designator
+ */
+static void router_broadcast_address(BACNET_ADDRESS *dest)
+{
+    memset(dest, 0, sizeof(*dest));
+    dest->net = BACNET_BROADCAST_NETWORK;
+}
+
+/**
+ * @brief Encode the NPCI of a network layer message of the router
+ * @param pdu - buffer for the message
+ * @param dest - destination of the message
+ * @param npdu_data - [out] network information of the message
+ * @param network_message_type - type of message
+ * @return number of bytes encoded
+ */
+static int router_network_message_encode(
+    uint8_t *pdu,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    BACNET_NETWORK_MESSAGE_TYPE network_message_type)
+{
+    npdu_encode_npdu_network(
+        npdu_data, network_message_type, false, MESSAGE_PRIORITY_NORMAL);
+    /* We don't need src information, since a message can't originate from
+       our downstream BACnet network. */
+    return npdu_encode_pdu(pdu, dest, NULL, npdu_data);
+}
+
+/**
+ * @brief Encode the network numbers that the router can reach
+ * @param pdu - buffer for the network numbers
+ * @param pdu_size - size of the buffer
+ * @param only - encode only the networks of this port, or NULL for all
+ * @param except - do not encode the networks of this port, or NULL
+ * @return number of bytes encoded
+ */
+static int router_networks_encode(
+    uint8_t *pdu,
+    size_t pdu_size,
+    const BACNET_ROUTING_PORT *only,
+    const BACNET_ROUTING_PORT *except)
+{
+    const BACNET_ROUTING_PORT *port = Port_List;
+    int len = 0;
+    unsigned i;
+
+    while (port) {
+        if ((!only || (port == only)) && (port != except)) {
+            if ((size_t)len + 2 <= pdu_size) {
+                len += encode_unsigned16(&pdu[len], port->net);
+            }
+            for (i = 0; i < BACNET_ROUTER_ROUTES_MAX; i++) {
+                if ((Route_Table[i].port == port) &&
+                    ((size_t)len + 2 <= pdu_size)) {
+                    len += encode_unsigned16(&pdu[len], Route_Table[i].net);
+                }
+            }
+        }
+        port = port->next;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Broadcast an I-Am-Router-To-Network message out of a port
+ * @param port - port to send out of
+ * @param dnet - the network number we are saying we are a router to.
+ *  If the dnet is 0, the message lists each accessible network except
+ *  the networks reachable via the network of the port.
+ */
+void bacnet_router_i_am_router_to_network(
+    BACNET_ROUTING_PORT *port, uint16_t dnet)
+{
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    int pdu_len;
+
+    if (!port || !port->send_pdu) {
+        return;
+    }
+    router_broadcast_address(&dest);
+    pdu_len = router_network_message_encode(
+        Tx_Buffer, &dest, &npdu_data, NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK);
+    if (dnet) {
+        pdu_len += encode_unsigned16(&Tx_Buffer[pdu_len], dnet);
+    } else {
+        pdu_len += router_networks_encode(
+            &Tx_Buffer[pdu_len], sizeof(Tx_Buffer) - pdu_len, NULL, port);
+    }
+    port->send_pdu(&dest, &npdu_data, Tx_Buffer, pdu_len);
+}
+
+/**
+ * @brief Broadcast a Who-Is-Router-To-Network message out of a port
+ * @param port - port to send out of
+ * @param dnet - network number that we are seeking
+ */
+static void
+router_who_is_router_to_network(BACNET_ROUTING_PORT *port, uint16_t dnet)
+{
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    int pdu_len;
+
+    if (!port->send_pdu) {
+        return;
+    }
+    router_broadcast_address(&dest);
+    pdu_len = router_network_message_encode(
+        Tx_Buffer, &dest, &npdu_data,
+        NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK);
+    if (dnet) {
+        pdu_len += encode_unsigned16(&Tx_Buffer[pdu_len], dnet);
+    }
+    port->send_pdu(&dest, &npdu_data, Tx_Buffer, pdu_len);
+}
+
+/**
+ * @brief Send a Reject-Message-To-Network message out of a port
+ * @param port - port to send out of
+ * @param dst - destination of the message, which is the source of the
+ *  rejected message
+ * @param reject_reason - one of the BACNET_NETWORK_REJECT_REASONS codes
+ * @param dnet - network number of the rejected message
+ */
+static void router_reject_message_to_network(
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *dst,
+    uint8_t reject_reason,
+    uint16_t dnet)
+{
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    int pdu_len;
+
+    if (!port->send_pdu) {
+        return;
+    }
+    bacnet_address_copy(&dest, dst);
+    pdu_len = router_network_message_encode(
+        Tx_Buffer, &dest, &npdu_data,
+        NETWORK_MESSAGE_REJECT_MESSAGE_TO_NETWORK);
+    Tx_Buffer[pdu_len] = reject_reason;
+    pdu_len++;
+    pdu_len += encode_unsigned16(&Tx_Buffer[pdu_len], dnet);
+    port->send_pdu(&dest, &npdu_data, Tx_Buffer, pdu_len);
+}
+
+/**
+ * @brief Broadcast our routing table as an Initialize-Routing-Table-Ack
+ *  message out of a port.  We simply use a positive index for the Port ID,
+ *  and have no Port Info.
+ * @param port - port to send out of
+ */
+static void router_initialize_routing_table_ack(BACNET_ROUTING_PORT *port)
+{
+    const BACNET_ROUTING_PORT *entry;
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    uint8_t count = 0;
+    uint8_t port_id = 1;
+    int pdu_len;
+
+    if (!port->send_pdu) {
+        return;
+    }
+    router_broadcast_address(&dest);
+    pdu_len = router_network_message_encode(
+        Tx_Buffer, &dest, &npdu_data, NETWORK_MESSAGE_INIT_RT_TABLE_ACK);
+    entry = Port_List;
+    while (entry) {
+        count++;
+        entry = entry->next;
+    }
+    Tx_Buffer[pdu_len] = count;
+    pdu_len++;
+    entry = Port_List;
+    while (entry) {
+        pdu_len += encode_unsigned16(&Tx_Buffer[pdu_len], entry->net);
+        Tx_Buffer[pdu_len] = port_id;
+        pdu_len++;
+        port_id++;
+        Tx_Buffer[pdu_len] = 0;
+        pdu_len++;
+        entry = entry->next;
+    }
+    port->send_pdu(&dest, &npdu_data, Tx_Buffer, pdu_len);
+}
+
+/**
+ * @brief Broadcast a Router-Busy-To-Network or Router-Available-To-Network
+ *  message with the networks of a port out of the other ports
+ * @param busy_port - port whose networks are busy or available
+ * @param network_message_type - type of message
+ */
+static void router_busy_to_network(
+    const BACNET_ROUTING_PORT *busy_port,
+    BACNET_NETWORK_MESSAGE_TYPE network_message_type)
+{
+    BACNET_ROUTING_PORT *port = Port_List;
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    int pdu_len;
+
+    while (port) {
+        if ((port != busy_port) && port->send_pdu) {
+            router_broadcast_address(&dest);
+            pdu_len = router_network_message_encode(
+                Tx_Buffer, &dest, &npdu_data, network_message_type);
+            pdu_len += router_networks_encode(
+                &Tx_Buffer[pdu_len], sizeof(Tx_Buffer) - pdu_len, busy_port,
+                NULL);
+            port->send_pdu(&dest, &npdu_data, Tx_Buffer, pdu_len);
+        }
+        port = port->next;
+    }
+}
+
+/**
+ * @brief Queue an NPDU to be sent out of a port, and tell the other
+ *  ports that the networks of the port are busy when the queue fills up
+ * @param port - port to send out of
+ * @param dest - destination of the NPDU
+ * @param src - source of the NPDU
+ * @param npdu_data - network information of the NPDU
+ * @param apdu - rest of the NPDU, after the NPCI
+ * @param apdu_len - number of bytes in the rest of the NPDU
+ * @return true if the NPDU was queued, false if the queue is full
+ */
+static bool router_forward(
+    BACNET_ROUTING_PORT *port,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    const BACNET_NPDU_DATA *npdu_data,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    BACNET_ROUTER_PACKET *packet;
+    int len;
+
+    if (port->queue_count >= BACNET_ROUTER_QUEUE_SIZE) {
+        port->queue_discards++;
+        return false;
+    }
+    packet = &port->queue
+                  [(port->queue_head + port->queue_count) %
+                   BACNET_ROUTER_QUEUE_SIZE];
+    len = bacnet_npdu_encode_pdu(
+        packet->pdu, sizeof(packet->pdu), dest, src, npdu_data);
+    if ((len <= 0) || ((size_t)len + apdu_len > sizeof(packet->pdu))) {
+        return false;
+    }
+    memcpy(&packet->pdu[len], apdu, apdu_len);
+    packet->pdu_len = (uint16_t)(len + apdu_len);
+    bacnet_address_copy(&packet->dest, dest);
+    npdu_copy_data(&packet->npdu_data, npdu_data);
+    port->queue_count++;
+    if (!port->busy && (port->queue_count >= BACNET_ROUTER_QUEUE_BUSY)) {
+        debug_printf("Router: port %u is busy\n", (unsigned)port->net);
+        port->busy = true;
+        port->busy_seconds = BACNET_ROUTER_BUSY_SECONDS / 2;
+        router_busy_to_network(port, NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Seek a network with a Who-Is-Router-To-Network out of all of
+ *  the ports, except the port that the discovery came from
+ * @param discovery - the network that is sought
+ */
+static void router_discovery_who_is(struct bacnet_router_discovery *discovery)
+{
+    BACNET_ROUTING_PORT *other = Port_List;
+
+    while (other) {
+        if (other != discovery->port) {
+            router_who_is_router_to_network(other, discovery->net);
+        }
+        other = other->next;
+    }
+    discovery->attempts++;
+    discovery->seconds = BACNET_ROUTER_DISCOVERY_SECONDS;
+}
+
+/**
+ * @brief Start to seek an unknown network, unless it is already sought.
+ *  The entry of a network whose unreachable time is over is used, so
+ *  that its backoff is kept, or else a free or an expired entry.
+ * @param net - network number
+ * @param port - port that the packet or request came from
+ * @return the discovery entry of the network, or NULL if there is no room
+ */
+static struct bacnet_router_discovery *
+router_discovery_start(uint16_t net, BACNET_ROUTING_PORT *port)
+{
+    struct bacnet_router_discovery *discovery;
+    unsigned i;
+
+    discovery = router_discovery_find(net);
+    if (discovery) {
+        if (!discovery->unreachable || (discovery->seconds > 0)) {
+            /* already sought, or still unreachable */
+            return discovery;
+        }
+    } else {
+        for (i = 0; i < BACNET_ROUTER_DISCOVERY_MAX; i++) {
+            if (Route_Discovery[i].net == 0) {
+                discovery = &Route_Discovery[i];
+                break;
+            }
+            if (Route_Discovery[i].unreachable &&
+                (Route_Discovery[i].seconds == 0)) {
+                discovery = &Route_Discovery[i];
+            }
+        }
+        if (!discovery) {
+            return NULL;
+        }
+        discovery->net = net;
+        discovery->backoff_seconds = BACNET_ROUTER_UNREACHABLE_SECONDS;
+    }
+    discovery->port = port;
+    discovery->attempts = 0;
+    discovery->unreachable = false;
+    router_discovery_who_is(discovery);
+
+    return discovery;
+}
+
+/**
+ * @brief Keep a packet to wait for the route to its network
+ * @param port - port where the packet came from
+ * @param src - source of the packet on the port
+ * @param router_src - routed source of the packet
+ * @param dest - destination of the packet, with its network
+ * @param npdu_data - network information of the packet
+ * @param apdu - rest of the NPDU, after the NPCI
+ * @param apdu_len - number of bytes in the rest of the NPDU
+ * @return true if the packet was kept
+ */
+static bool router_waiting_add(
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *router_src,
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *npdu_data,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    struct bacnet_router_waiting *waiting;
+    unsigned i;
+
+    if (apdu_len > sizeof(waiting->apdu)) {
+        return false;
+    }
+    for (i = 0; i < BACNET_ROUTER_DISCOVERY_QUEUE_SIZE; i++) {
+        waiting = &Route_Waiting[i];
+        if (waiting->net == 0) {
+            waiting->net = dest->net;
+            waiting->port = port;
+            bacnet_address_copy(&waiting->src, src);
+            bacnet_address_copy(&waiting->router_src, router_src);
+            bacnet_address_copy(&waiting->dest, dest);
+            npdu_copy_data(&waiting->npdu_data, npdu_data);
+            memcpy(waiting->apdu, apdu, apdu_len);
+            waiting->apdu_len = apdu_len;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Fill the router src address with this port router, router network
+ *  number, and the original src address.
+ * @param router_src - [out] the src address for the routed message
+ * @param port - port where the message came from
+ * @param src - the address of the message's original src
+ */
+static void router_src_address(
+    BACNET_ADDRESS *router_src,
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *src)
+{
+    bacnet_address_copy(router_src, &port->address);
+    if (src->net) {
+        /* from a router - add router our table */
+        (void)bacnet_router_dnet_add(port, src->net, src);
+        /* the routed address stays the same */
+        router_src->net = src->net;
+        router_src->len = src->len;
+        memcpy(router_src->adr, src->adr, MAX_MAC_LEN);
+    } else {
+        /* from our directly connected port */
+        router_src->net = port->net;
+        router_src->len = src->mac_len;
+        memcpy(router_src->adr, src->mac, MAX_MAC_LEN);
+    }
+}
+
+/**
+ * @brief Send a message to a network that has a route.
+ *  Normal routing procedures are described in 6.5.
+ * @param entry - the route cache entry of the destination network
+ * @param port - port where the message came from
+ * @param src - the source of the message on the port
+ * @param router_src - routed source of the message
+ * @param dest - the destination of the message
+ * @param npdu_data - network information of the message
+ * @param apdu - rest of the NPDU, after the NPCI
+ * @param apdu_len - number of bytes in the rest of the NPDU
+ */
+static void router_route_send(
+    const struct bacnet_router_cache_entry *entry,
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *src,
+    BACNET_ADDRESS *router_src,
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *npdu_data,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    BACNET_ADDRESS next_dest = { 0 };
+
+    if (entry->port == port) {
+        debug_printf(
+            "Router: DNET %u is on the port of origin. Discarded!\n",
+            (unsigned)dest->net);
+    } else if (!entry->route) {
+        /* Case 1: the router is directly connected to the network referred
+           to by DNET.  DNET, DADR, and Hop Count are removed from the NPCI
+           and the message is sent directly to the destination device with
+           DA set equal to DADR. */
+        memcpy(next_dest.mac, dest->adr, MAX_MAC_LEN);
+        next_dest.mac_len = dest->len;
+        next_dest.net = 0;
+        if (!router_forward(
+                entry->port, &next_dest, router_src, npdu_data, apdu,
+                apdu_len)) {
+            router_reject_message_to_network(
+                port, src, NETWORK_REJECT_ROUTER_BUSY, dest->net);
+        }
+    } else {
+        /* Case 2: the message is relayed to the next router on the path
+           to the destination network */
+        if (entry->route->busy_seconds) {
+            router_reject_message_to_network(
+                port, src, NETWORK_REJECT_ROUTER_BUSY, dest->net);
+            return;
+        }
+        bacnet_address_copy(&next_dest, dest);
+        memcpy(next_dest.mac, entry->route->mac, MAX_MAC_LEN);
+        next_dest.mac_len = entry->route->mac_len;
+        if (!router_forward(
+                entry->port, &next_dest, router_src, npdu_data, apdu,
+                apdu_len)) {
+            router_reject_message_to_network(
+                port, src, NETWORK_REJECT_ROUTER_BUSY, dest->net);
+        }
+    }
+}
+
+/**
+ * @brief Route an NPDU with a DNET to the port of the destination network.
+ *  Normal routing procedures are described in 6.5.  A global broadcast
+ *  is sent out of all of the other ports.  A message to an unknown
+ *  network waits while the next router on the path to the network is
+ *  sought with a Who-Is-Router-To-Network message, and a message to a
+ *  network that was not found is rejected.
+ * @param port - port where the message came from
+ * @param npdu_data - network information of the message
+ * @param src - the source of the message
+ * @param dest - the destination of the message
+ * @param apdu - rest of the NPDU, after the NPCI
+ * @param apdu_len - number of bytes in the rest of the NPDU
+ */
+static void router_routed_handler(
+    BACNET_ROUTING_PORT *port,
+    BACNET_NPDU_DATA *npdu_data,
+    BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *dest,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    struct bacnet_router_cache_entry *entry;
+    struct bacnet_router_discovery *discovery;
+    BACNET_ROUTING_PORT *other;
+    BACNET_ADDRESS next_dest = { 0 };
+    BACNET_ADDRESS router_src = { 0 };
+
+    /* If the Hop Count is zero, then the router shall discard the message */
+    if (npdu_data->hop_count <= 1) {
+        debug_printf("Router: hop count is zero. Discarded!\n");
+        return;
+    }
+    if (apdu_len > (BACNET_ROUTER_PDU_MAX - MAX_NPDU)) {
+        router_reject_message_to_network(
+            port, src, NETWORK_REJECT_MESSAGE_TOO_LONG, dest->net);
+        return;
+    }
+    npdu_data->hop_count--;
+    router_src_address(&router_src, port, src);
+    if (!npdu_data->network_layer_message &&
+        (dest->net != BACNET_BROADCAST_NETWORK)) {
+        if (Proxy_Response) {
+            Proxy_Response(&router_src, dest, apdu, apdu_len);
+        }
+        if (Proxy_Request && (dest->len > 0) &&
+            Proxy_Request(
+                port, src, &router_src, dest, npdu_data, apdu, apdu_len)) {
+            return;
+        }
+    }
+    if (dest->net == BACNET_BROADCAST_NETWORK) {
+        /* A global broadcast is broadcast on all directly connected
+           networks except the network of origin */
+        router_broadcast_address(&next_dest);
+        other = Port_List;
+        while (other) {
+            if (other != port) {
+                (void)router_forward(
+                    other, &next_dest, &router_src, npdu_data, apdu,
+                    apdu_len);
+            }
+            other = other->next;
+        }
+        return;
+    }
+    entry = route_lookup(dest->net);
+    if (entry) {
+        router_route_send(
+            entry, port, src, &router_src, dest, npdu_data, apdu, apdu_len);
+        return;
+    }
+    /* Case 3: the next router is sought with Who-Is-Router-To-Network,
+       once for all of the messages to the network, and the message waits
+       for the route.  A network that was not found is unreachable. */
+    discovery = router_discovery_start(dest->net, port);
+    if (discovery && discovery->unreachable) {
+        debug_printf("Router: DNET %u is unreachable\n", (unsigned)dest->net);
+        router_reject_message_to_network(
+            port, src, NETWORK_REJECT_NO_ROUTE, dest->net);
+    } else if (discovery) {
+        if (!router_waiting_add(
+                port, src, &router_src, dest, npdu_data, apdu, apdu_len)) {
+            debug_printf(
+                "Router: no room to wait for DNET %u. Discarded!\n",
+                (unsigned)dest->net);
+        }
+    } else {
+        /* no room to seek it: a global broadcast is required, and an
+           attempt is made to identify the next router */
+        debug_printf("Router: unknown route to %u\n", (unsigned)dest->net);
+        bacnet_address_copy(&next_dest, dest);
+        next_dest.mac_len = 0;
+        other = Port_List;
+        while (other) {
+            if (other != port) {
+                (void)router_forward(
+                    other, &next_dest, &router_src, npdu_data, apdu,
+                    apdu_len);
+                router_who_is_router_to_network(other, dest->net);
+            }
+            other = other->next;
+        }
+    }
+}
+
+/**
+ * @brief Send the packets that waited for the route to a network, and
+ *  forget that the network was sought
+ * @param net - network number that a route was added for
+ */
+static void router_discovery_resolve(uint16_t net)
+{
+    struct bacnet_router_discovery *discovery;
+    struct bacnet_router_cache_entry *entry;
+    struct bacnet_router_waiting *waiting;
+    unsigned i;
+
+    discovery = router_discovery_find(net);
+    if (!discovery) {
+        return;
+    }
+    memset(discovery, 0, sizeof(*discovery));
+    entry = route_lookup(net);
+    for (i = 0; i < BACNET_ROUTER_DISCOVERY_QUEUE_SIZE; i++) {
+        waiting = &Route_Waiting[i];
+        if (waiting->net != net) {
+            continue;
+        }
+        if (entry) {
+            router_route_send(
+                entry, waiting->port, &waiting->src, &waiting->router_src,
+                &waiting->dest, &waiting->npdu_data, waiting->apdu,
+                waiting->apdu_len);
+        }
+        waiting->net = 0;
+    }
+}
+
+/**
+ * @brief Seek the unknown networks again, and make the networks that were
+ *  not found unreachable, rejecting the packets that waited for them
+ * @param seconds - number of elapsed seconds since the last call
+ */
+static void router_discovery_timer(uint16_t seconds)
+{
+    struct bacnet_router_discovery *discovery;
+    struct bacnet_router_waiting *waiting;
+    unsigned i, j;
+
+    for (i = 0; i < BACNET_ROUTER_DISCOVERY_MAX; i++) {
+        discovery = &Route_Discovery[i];
+        if (discovery->net == 0) {
+            continue;
+        }
+        if (discovery->seconds > seconds) {
+            discovery->seconds -= seconds;
+            continue;
+        }
+        discovery->seconds = 0;
+        if (discovery->unreachable) {
+            /* it is sought again by the next packet to it */
+            continue;
+        }
+        if (discovery->attempts < BACNET_ROUTER_DISCOVERY_ATTEMPTS) {
+            router_discovery_who_is(discovery);
+            continue;
+        }
+        debug_printf(
+            "Router: DNET %u not found for %u seconds\n",
+            (unsigned)discovery->net, (unsigned)discovery->backoff_seconds);
+        discovery->unreachable = true;
+        discovery->seconds = discovery->backoff_seconds;
+        if (discovery->backoff_seconds <=
+            (BACNET_ROUTER_UNREACHABLE_SECONDS_MAX / 2)) {
+            discovery->backoff_seconds *= 2;
+        } else {
+            discovery->backoff_seconds = BACNET_ROUTER_UNREACHABLE_SECONDS_MAX;
+        }
+        for (j = 0; j < BACNET_ROUTER_DISCOVERY_QUEUE_SIZE; j++) {
+            waiting = &Route_Waiting[j];
+            if (waiting->net == discovery->net) {
+                router_reject_message_to_network(
+                    waiting->port, &waiting->src, NETWORK_REJECT_NO_ROUTE,
+                    waiting->net);
+                waiting->net = 0;
+            }
+        }
+    }
+}
+/**
+ * @brief Set the proxy that looks at the routed messages, and may answer
+ *  the requests instead of forwarding them
+ * @param request - function that may answer a request, or NULL
+ * @param response - function that looks at the other messages, or NULL
+ */
+void bacnet_router_proxy_set(
+    bacnet_router_proxy_request_function request,
+    bacnet_router_proxy_response_function response)
+{
+    Proxy_Request = request;
+    Proxy_Response = response;
+}
+
+/**
+ * @brief Send an APDU back out of the port that a request came from, as
+ *  if it was routed from a device on another network
+ * @param port - port that the request came from
+ * @param src - source of the request, as it was received on the port
+ * @param routed_dest - the device that the request was for, with its
+ *  network, which becomes the routed source of the reply
+ * @param priority - network priority of the reply
+ * @param apdu - APDU of the reply
+ * @param apdu_len - number of bytes in the APDU
+ * @return true if the reply was queued
+ */
+bool bacnet_router_reply(
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *routed_dest,
+    uint8_t priority,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    BACNET_ADDRESS next_dest = { 0 };
+    BACNET_ADDRESS router_src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+
+    if (!port || !src || !routed_dest || !apdu) {
+        return false;
+    }
+    /* back to the requester, or to the router that it is behind */
+    bacnet_address_copy(&next_dest, src);
+    bacnet_address_copy(&router_src, &port->address);
+    router_src.net = routed_dest->net;
+    router_src.len = routed_dest->len;
+    memcpy(router_src.adr, routed_dest->adr, MAX_MAC_LEN);
+    npdu_encode_npdu_data(
+        &npdu_data, false, (BACNET_MESSAGE_PRIORITY)priority);
+
+    return router_forward(
+        port, &next_dest, &router_src, &npdu_data, apdu, apdu_len);
+}
+
+/**
+ * @brief Handle the Network Layer Control Messages that are for the router
+ * @param port - port where the message came from
+ * @param src - the source of the message
+ * @param npdu_data - network information of the message
+ * @param npdu - rest of the NPDU, after the NPCI
+ * @param npdu_len - number of bytes in the rest of the NPDU
+ */
+static void router_network_control_handler(
+    BACNET_ROUTING_PORT *port,
+    BACNET_ADDRESS *src,
+    const BACNET_NPDU_DATA *npdu_data,
+    const uint8_t *npdu,
+    uint16_t npdu_len)
+{
+    struct bacnet_router_cache_entry *entry;
+    BACNET_ROUTING_PORT *other;
+    uint16_t dnet = 0;
+    uint16_t offset = 0;
+    bool busy;
+    uint8_t count;
+    uint8_t info_len;
+
+    switch (npdu_data->network_message_type) {
+        case NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK:
+            if (npdu_len >= 2) {
+                decode_unsigned16(npdu, &dnet);
+                entry = route_lookup(dnet);
+                if (entry) {
+                    if (entry->port != port) {
+                        /* reachable not through the port of the message */
+                        bacnet_router_i_am_router_to_network(port, dnet);
+                    }
+                } else if (!router_discovery_start(dnet, port)) {
+                    /* discover the next router on the path to the network */
+                    other = Port_List;
+                    while (other) {
+                        if (other != port) {
+                            router_who_is_router_to_network(other, dnet);
+                        }
+                        other = other->next;
+                    }
+                }
+            } else {
+                bacnet_router_i_am_router_to_network(port, 0);
+            }
+            break;
+        case NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK:
+            /* add its DNETs to our routing table */
+            while ((offset + 2) <= npdu_len) {
+                offset += decode_unsigned16(&npdu[offset], &dnet);
+                (void)bacnet_router_dnet_add(port, dnet, src);
+            }
+            break;
+        case NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK:
+        case NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK:
+            busy = (npdu_data->network_message_type ==
+                    NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK);
+            if (npdu_len < 2) {
+                /* all of the networks served by the router */
+                route_busy_set(port, src, 0, busy);
+            }
+            while ((offset + 2) <= npdu_len) {
+                offset += decode_unsigned16(&npdu[offset], &dnet);
+                route_busy_set(port, src, dnet, busy);
+            }
+            break;
+        case NETWORK_MESSAGE_REJECT_MESSAGE_TO_NETWORK:
+            if (npdu_len >= 3) {
+                decode_unsigned16(&npdu[1], &dnet);
+                debug_printf(
+                    "Router: Reject-Message-To-Network %u for DNET %u\n",
+                    (unsigned)npdu[0], (unsigned)dnet);
+            }
+            break;
+        case NETWORK_MESSAGE_INIT_RT_TABLE:
+            if (npdu_len > 0) {
+                /* If Number of Ports is 0, broadcast our "full" table,
+                   else update our table from their list, and ack */
+                count = npdu[0];
+                offset = 1;
+                while (count-- && ((offset + 4) <= npdu_len)) {
+                    offset += decode_unsigned16(&npdu[offset], &dnet);
+                    (void)bacnet_router_dnet_add(port, dnet, src);
+                    /* skip the Port ID, and the Port Info */
+                    info_len = npdu[offset + 1];
+                    offset += 2 + info_len;
+                }
+                router_initialize_routing_table_ack(port);
+            }
+            break;
+        case NETWORK_MESSAGE_I_COULD_BE_ROUTER_TO_NETWORK:
+        case NETWORK_MESSAGE_INIT_RT_TABLE_ACK:
+        case NETWORK_MESSAGE_ESTABLISH_CONNECTION_TO_NETWORK:
+        case NETWORK_MESSAGE_DISCONNECT_CONNECTION_TO_NETWORK:
+            /* Do nothing - don't support PTP half-router control */
+            break;
+        default:
+            /* An unrecognized message is bad; send an error response. */
+            router_reject_message_to_network(
+                port, src, NETWORK_REJECT_UNKNOWN_MESSAGE_TYPE, 0);
+            break;
+    }
+}
+
+/**
+ * @brief Handle an NPDU that was received on a port of the router.
+ *  The network layer messages for the router are processed, and the
+ *  messages for other networks are queued to be sent out of the other
+ *  ports by bacnet_router_task().
+ * @param port - port where the NPDU was received
+ * @param src - [in,out] the source MAC address of the NPDU, returned with
+ *  the routing source information, if any
+ * @param pdu - buffer containing the NPDU and APDU of the received packet
+ * @param pdu_len - number of bytes in the received packet
+ * @return offset of the APDU in the pdu buffer if the APDU is also for
+ *  the application of the router, or 0 if it is not
+ */
+int bacnet_router_npdu_handler(
+    BACNET_ROUTING_PORT *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t pdu_len)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int apdu_offset;
+    uint16_t apdu_len;
+
+    if (!port || !src || !pdu || (pdu_len == 0)) {
+        return 0;
+    }
+    if (pdu[0] != BACNET_PROTOCOL_VERSION) {
+        debug_printf(
+            "NPDU: unsupported protocol version %u. Discarded!\n",
+            (unsigned)pdu[0]);
+        return 0;
+    }
+    apdu_offset = bacnet_npdu_decode(pdu, pdu_len, &dest, src, &npdu_data);
+    if ((apdu_offset <= 0) || (apdu_offset > pdu_len)) {
+        debug_printf("NPDU: Decoding failed. Discarded!\n");
+        return 0;
+    }
+    apdu_len = (uint16_t)(pdu_len - apdu_offset);
+    if (npdu_data.network_layer_message) {
+        if ((dest.net == 0) || (dest.net == BACNET_BROADCAST_NETWORK)) {
+            router_network_control_handler(
+                port, src, &npdu_data, &pdu[apdu_offset], apdu_len);
+        } else {
+            router_routed_handler(
+                port, &npdu_data, src, &dest, &pdu[apdu_offset], apdu_len);
+        }
+        return 0;
+    }
+    if (dest.net == 0) {
+        return apdu_offset;
+    }
+    if ((dest.net == BACNET_BROADCAST_NETWORK) && (apdu_len > 0) &&
+        ((pdu[apdu_offset] & 0xF0) == PDU_TYPE_CONFIRMED_SERVICE_REQUEST)) {
+        /* hack for 5.4.5.1 - IDLE */
+        /* ConfirmedBroadcastReceived */
+        /* then enter IDLE - ignore the PDU */
+        return 0;
+    }
+    router_routed_handler(
+        port, &npdu_data, src, &dest, &pdu[apdu_offset], apdu_len);
+    if (dest.net == BACNET_BROADCAST_NETWORK) {
+        return apdu_offset;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Send a batch of the queued NPDUs out of each port, and tell the
+ *  other ports that the networks of a busy port are available after its
+ *  queue has drained.
+ * @return number of NPDUs that were sent
+ */
+unsigned bacnet_router_task(void)
+{
+    BACNET_ROUTING_PORT *port = Port_List;
+    BACNET_ROUTER_PACKET *packet;
+    unsigned sent = 0;
+    unsigned batch;
+
+    while (port) {
+        for (batch = 0;
+             (batch < BACNET_ROUTER_BATCH_SIZE) && (port->queue_count > 0);
+             batch++) {
+            packet = &port->queue[port->queue_head];
+            if (port->send_pdu) {
+                (void)port->send_pdu(
+                    &packet->dest, &packet->npdu_data, packet->pdu,
+                    packet->pdu_len);
+            }
+            port->queue_head =
+                (port->queue_head + 1) % BACNET_ROUTER_QUEUE_SIZE;
+            port->queue_count--;
+            sent++;
+        }
+        if (port->busy &&
+            (port->queue_count <= BACNET_ROUTER_QUEUE_AVAILABLE)) {
+            debug_printf("Router: port %u is available\n", (unsigned)port->net);
+            port->busy = false;
+            port->busy_seconds = 0;
+            router_busy_to_network(
+                port, NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK);
+        }
+        port = port->next;
+    }
+
+    return sent;
+}
+
+/**
+ * @brief Time out the Router-Busy-To-Network restrictions from other
+ *  routers, renew our own while a port is still busy, and seek the
+ *  unknown networks
+ * @param seconds - number of elapsed seconds since the last call
+ */
+void bacnet_router_maintenance_timer(uint16_t seconds)
+{
+    BACNET_ROUTING_PORT *port = Port_List;
+    unsigned i;
+
+    router_discovery_timer(seconds);
+    for (i = 0; i < BACNET_ROUTER_ROUTES_MAX; i++) {
+        if (Route_Table[i].busy_seconds > seconds) {
+            Route_Table[i].busy_seconds -= seconds;
+        } else {
+            Route_Table[i].busy_seconds = 0;
+        }
+    }
+    while (port) {
+        if (port->busy) {
+            if (port->busy_seconds > seconds) {
+                port->busy_seconds -= seconds;
+            } else {
+                port->busy_seconds = BACNET_ROUTER_BUSY_SECONDS / 2;
+                router_busy_to_network(
+                    port, NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK);
+            }
+        }
+        port = port->next;
+    }
+}
+
+/**
+ * @brief Remove all of the ports and routes of the router
+ */
+void bacnet_router_cleanup(void)
+{
+    Port_List = NULL;
+    Proxy_Request = NULL;
+    Proxy_Response = NULL;
+    memset(Route_Table, 0, sizeof(Route_Table));
+    memset(Route_Cache, 0, sizeof(Route_Cache));
+    memset(Route_Discovery, 0, sizeof(Route_Discovery));
+    memset(Route_Waiting, 0, sizeof(Route_Waiting));
+}
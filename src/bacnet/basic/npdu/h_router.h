@@ -0,0 +1,207 @@
+/**
+ * @file
+ * @brief API for a basic BACnet router with a port for each datalink
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_NPDU_ROUTER_HANDLER_H
+#define BACNET_BASIC_NPDU_ROUTER_HANDLER_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/npdu.h"
+
+/* number of packets that each port queues to send */
+#ifndef BACNET_ROUTER_QUEUE_SIZE
+#define BACNET_ROUTER_QUEUE_SIZE 8
+#endif
+/* queued packets at which the networks of a port are busy */
+#ifndef BACNET_ROUTER_QUEUE_BUSY
+#define BACNET_ROUTER_QUEUE_BUSY ((BACNET_ROUTER_QUEUE_SIZE * 3) / 4)
+#endif
+/* queued packets at which the networks of a busy port are available */
+#ifndef BACNET_ROUTER_QUEUE_AVAILABLE
+#define BACNET_ROUTER_QUEUE_AVAILABLE (BACNET_ROUTER_QUEUE_SIZE / 4)
+#endif
+/* number of packets that each port sends in one task */
+#ifndef BACNET_ROUTER_BATCH_SIZE
+#define BACNET_ROUTER_BATCH_SIZE 4
+#endif
+/* number of remote networks in the routing table */
+#ifndef BACNET_ROUTER_ROUTES_MAX
+#define BACNET_ROUTER_ROUTES_MAX 64
+#endif
+/* number of networks in the route cache, a power of two */
+#ifndef BACNET_ROUTER_CACHE_SIZE
+#define BACNET_ROUTER_CACHE_SIZE 16
+#endif
+/* number of unknown networks that are sought or unreachable */
+#ifndef BACNET_ROUTER_DISCOVERY_MAX
+#define BACNET_ROUTER_DISCOVERY_MAX 8
+#endif
+/* number of packets that wait for the route to their network */
+#ifndef BACNET_ROUTER_DISCOVERY_QUEUE_SIZE
+#define BACNET_ROUTER_DISCOVERY_QUEUE_SIZE 4
+#endif
+/* number of Who-Is-Router-To-Network sent to seek a network */
+#ifndef BACNET_ROUTER_DISCOVERY_ATTEMPTS
+#define BACNET_ROUTER_DISCOVERY_ATTEMPTS 3
+#endif
+/* seconds between the Who-Is-Router-To-Network to seek a network */
+#ifndef BACNET_ROUTER_DISCOVERY_SECONDS
+#define BACNET_ROUTER_DISCOVERY_SECONDS 2
+#endif
+/* seconds that a network that was not found is unreachable, which is
+   doubled each time that it is not found again, up to the maximum */
+#ifndef BACNET_ROUTER_UNREACHABLE_SECONDS
+#define BACNET_ROUTER_UNREACHABLE_SECONDS 10
+#endif
+#ifndef BACNET_ROUTER_UNREACHABLE_SECONDS_MAX
+#define BACNET_ROUTER_UNREACHABLE_SECONDS_MAX 600
+#endif
+/* largest NPDU that the router forwards */
+#ifndef BACNET_ROUTER_PDU_MAX
+#define BACNET_ROUTER_PDU_MAX MAX_PDU
+#endif
+/* seconds that a Router-Busy-To-Network restriction lasts */
+#define BACNET_ROUTER_BUSY_SECONDS 30
+
+/**
+ * @brief Send a PDU out of the datalink of a router port
+ * @param dest - destination address
+ * @param npdu_data - network information
+ * @param pdu - NPDU to be sent
+ * @param pdu_len - number of bytes to send
+ * @return number of bytes sent, or <= 0 if not sent
+ */
+typedef int (*bacnet_router_send_pdu_function)(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len);
+
+struct bacnet_router_port;
+
+/**
+ * @brief Look at a routed request before it is forwarded, and answer it
+ *  instead of forwarding it
+ * @param port - port where the request came from
+ * @param src - source of the request, as it was received on the port
+ * @param routed_src - routed source of the request, with its network
+ * @param dest - destination of the request, with its network
+ * @param npdu_data - network information of the request
+ * @param apdu - APDU of the request
+ * @param apdu_len - number of bytes in the APDU
+ * @return true if the request was handled and is not forwarded
+ */
+typedef bool (*bacnet_router_proxy_request_function)(
+    struct bacnet_router_port *port,
+    const BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *routed_src,
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *npdu_data,
+    const uint8_t *apdu,
+    uint16_t apdu_len);
+
+/**
+ * @brief Look at a routed message, such as a reply, before it is forwarded
+ * @param routed_src - routed source of the message, with its network
+ * @param dest - destination of the message, with its network
+ * @param apdu - APDU of the message
+ * @param apdu_len - number of bytes in the APDU
+ */
+typedef void (*bacnet_router_proxy_response_function)(
+    const BACNET_ADDRESS *routed_src,
+    const BACNET_ADDRESS *dest,
+    const uint8_t *apdu,
+    uint16_t apdu_len);
+
+/* a packet in the send queue of a router port */
+typedef struct bacnet_router_packet {
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    uint16_t pdu_len;
+    uint8_t pdu[BACNET_ROUTER_PDU_MAX];
+} BACNET_ROUTER_PACKET;
+
+/* a router port, which is directly connected to a network */
+typedef struct bacnet_router_port {
+    /* network number of the directly connected network */
+    uint16_t net;
+    /* MAC address of the port on its network */
+    BACNET_ADDRESS address;
+    bacnet_router_send_pdu_function send_pdu;
+    /* send queue */
+    BACNET_ROUTER_PACKET queue[BACNET_ROUTER_QUEUE_SIZE];
+    unsigned queue_head;
+    unsigned queue_count;
+    /* packets that were discarded because the queue was full */
+    unsigned long queue_discards;
+    /* true while Router-Busy-To-Network is in effect for the port */
+    bool busy;
+    uint16_t busy_seconds;
+    struct bacnet_router_port *next;
+} BACNET_ROUTING_PORT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_router_port_add(
+    BACNET_ROUTING_PORT *port,
+    uint16_t net,
+    const BACNET_ADDRESS *address,
+    bacnet_router_send_pdu_function send_pdu);
+BACNET_STACK_EXPORT
+BACNET_ROUTING_PORT *bacnet_router_port_find(uint16_t net);
+
+BACNET_STACK_EXPORT
+bool bacnet_router_dnet_add(
+    BACNET_ROUTING_PORT *port, uint16_t dnet, const BACNET_ADDRESS *router);
+BACNET_STACK_EXPORT
+BACNET_ROUTING_PORT *
+bacnet_router_dnet_find(uint16_t dnet, BACNET_ADDRESS *router);
+BACNET_STACK_EXPORT
+bool bacnet_router_dnet_busy(uint16_t dnet);
+BACNET_STACK_EXPORT
+bool bacnet_router_dnet_unreachable(uint16_t dnet);
+
+BACNET_STACK_EXPORT
+int bacnet_router_npdu_handler(
+    BACNET_ROUTING_PORT *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t pdu_len);
+BACNET_STACK_EXPORT
+unsigned bacnet_router_task(void);
+BACNET_STACK_EXPORT
+void bacnet_router_maintenance_timer(uint16_t seconds);
+
+BACNET_STACK_EXPORT
+void bacnet_router_proxy_set(
+    bacnet_router_proxy_request_function request,
+    bacnet_router_proxy_response_function response);
+BACNET_STACK_EXPORT
+bool bacnet_router_reply(
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *routed_dest,
+    uint8_t priority,
+    const uint8_t *apdu,
+    uint16_t apdu_len);
+
+BACNET_STACK_EXPORT
+void bacnet_router_i_am_router_to_network(
+    BACNET_ROUTING_PORT *port, uint16_t dnet);
+
+BACNET_STACK_EXPORT
+void bacnet_router_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
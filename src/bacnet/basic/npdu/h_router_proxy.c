@@ -0,0 +1,732 @@
+/**
+ * @file
+ * @brief A caching read proxy for the devices behind a router
+ * @details The proxy answers ReadProperty and ReadPropertyMultiple
+ *  requests for the configured properties of slow devices, such as the
+ *  devices on an MS/TP trunk, from a cache in the router instead of
+ *  forwarding them to the device.  The cache is filled from the
+ *  ReadProperty-ACK, ReadPropertyMultiple-ACK and COV notifications that
+ *  the router forwards from the devices, and a value is used until it is
+ *  older than the maximum age of its property.  When the value of a
+ *  property is too old, the first request is forwarded to the device and
+ *  the requests that follow wait for its reply, so that the trunk carries
+ *  only one request for the property.  A WriteProperty or
+ *  WritePropertyMultiple request to a device forgets the cached values
+ *  that it changes.  The proxy does not poll or subscribe by itself,
+ *  since the router has no invoke IDs of its own.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/cov.h"
+#include "bacnet/npdu.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#include "bacnet/basic/sys/bits.h"
+#include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/npdu/h_router.h"
+#include "bacnet/basic/npdu/h_router_proxy.h"
+
+/* a request that waits for the reply of the device */
+struct bacnet_router_proxy_waiter {
+    BACNET_ROUTING_PORT *port;
+    BACNET_ADDRESS src;
+    uint8_t invoke_id;
+    uint8_t priority;
+    uint16_t max_apdu;
+};
+
+/* a cached property of a device behind the router */
+struct bacnet_router_proxy_entry {
+    bool used;
+    /* network and MAC address of the device */
+    BACNET_ADDRESS device;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    /* seconds that a value is used, and the age of the value */
+    uint16_t max_age;
+    uint16_t age;
+    bool valid;
+    uint16_t value_len;
+    uint8_t value[BACNET_ROUTER_PROXY_VALUE_MAX];
+    /* the forwarded request that refreshes the value */
+    bool refreshing;
+    uint16_t refresh_seconds;
+    BACNET_ADDRESS refresh_client;
+    uint8_t refresh_invoke_id;
+    unsigned waiter_count;
+    struct bacnet_router_proxy_waiter waiter[BACNET_ROUTER_PROXY_WAITERS_MAX];
+};
+
+static struct bacnet_router_proxy_entry
+    Proxy_Entry[BACNET_ROUTER_PROXY_ENTRIES_MAX];
+/* requests that were answered from the cache, and that were forwarded */
+static unsigned long Proxy_Hits;
+static unsigned long Proxy_Misses;
+/* buffer for the replies from the cache, and for decoding the replies */
+static uint8_t Proxy_Buffer[MAX_APDU];
+/* values of a COV notification */
+static BACNET_PROPERTY_VALUE
+    Proxy_COV_Value[BACNET_ROUTER_PROXY_COV_VALUES_MAX];
+/* the device of the ReadPropertyMultiple-ACK that is looked at */
+static const BACNET_ADDRESS *Proxy_RPM_Device;
+
+/**
+ * @brief Compare the network and MAC address of two routed addresses
+ * @param a - a routed address
+ * @param b - another routed address
+ * @return true if the addresses are the same
+ */
+static bool
+proxy_address_same(const BACNET_ADDRESS *a, const BACNET_ADDRESS *b)
+{
+    if ((a->net != b->net) || (a->len != b->len) || (a->len > MAX_MAC_LEN)) {
+        return false;
+    }
+
+    return memcmp(a->adr, b->adr, a->len) == 0;
+}
+
+/**
+ * @brief Find the cached property of a device
+ * @param device - network and MAC address of the device
+ * @param object_type - object type of the property
+ * @param object_instance - object instance of the property
+ * @param object_property - property identifier
+ * @param array_index - array index of the property
+ * @return the cached property, or NULL if it is not cached
+ */
+static struct bacnet_router_proxy_entry *proxy_entry_find(
+    const BACNET_ADDRESS *device,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    struct bacnet_router_proxy_entry *entry;
+    unsigned i;
+
+    for (i = 0; i < BACNET_ROUTER_PROXY_ENTRIES_MAX; i++) {
+        entry = &Proxy_Entry[i];
+        if (entry->used && (entry->object_type == object_type) &&
+            (entry->object_instance == object_instance) &&
+            (entry->object_property == object_property) &&
+            (entry->array_index == array_index) &&
+            proxy_address_same(&entry->device, device)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Determine if the cached value of a property can be used
+ * @param entry - the cached property
+ * @return true if the value is not older than its maximum age
+ */
+static bool proxy_entry_fresh(const struct bacnet_router_proxy_entry *entry)
+{
+    return entry->valid && (entry->age < entry->max_age);
+}
+
+/**
+ * @brief Store a value of a device in the cache, if it is cached
+ * @param device - network and MAC address of the device
+ * @param rp_data - the property and its encoded value
+ */
+static void proxy_value_store(
+    const BACNET_ADDRESS *device, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    struct bacnet_router_proxy_entry *entry;
+
+    entry = proxy_entry_find(
+        device, rp_data->object_type, rp_data->object_instance,
+        rp_data->object_property, rp_data->array_index);
+    if (!entry) {
+        return;
+    }
+    if ((rp_data->application_data_len > 0) &&
+        (rp_data->application_data_len <= BACNET_ROUTER_PROXY_VALUE_MAX)) {
+        memcpy(
+            entry->value, rp_data->application_data,
+            (size_t)rp_data->application_data_len);
+        entry->value_len = (uint16_t)rp_data->application_data_len;
+        entry->valid = true;
+        entry->age = 0;
+    } else {
+        entry->valid = false;
+    }
+}
+
+/**
+ * @brief Forget the cached values of a device that a write changes
+ * @param device - network and MAC address of the device
+ * @param apdu - the service request of WriteProperty, or NULL to forget
+ *  all of the values of the device
+ * @param apdu_size - number of bytes in the service request
+ */
+static void proxy_write_invalidate(
+    const BACNET_ADDRESS *device, const uint8_t *apdu, unsigned apdu_size)
+{
+    struct bacnet_router_proxy_entry *entry;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    uint32_t object_property = 0;
+    int len = 0;
+    unsigned i;
+
+    if (apdu) {
+        /* objectIdentifier [0] and propertyIdentifier [1] */
+        len = bacnet_object_id_context_decode(
+            apdu, apdu_size, 0, &object_type, &object_instance);
+        if (len <= 0) {
+            return;
+        }
+        if (bacnet_enumerated_context_decode(
+                &apdu[len], apdu_size - len, 1, &object_property) <= 0) {
+            return;
+        }
+    }
+    for (i = 0; i < BACNET_ROUTER_PROXY_ENTRIES_MAX; i++) {
+        entry = &Proxy_Entry[i];
+        if (!entry->used || !proxy_address_same(&entry->device, device)) {
+            continue;
+        }
+        if (!apdu ||
+            ((entry->object_type == object_type) &&
+             (entry->object_instance == object_instance) &&
+             (entry->object_property == object_property))) {
+            entry->valid = false;
+        }
+    }
+}
+
+/**
+ * @brief Answer a ReadProperty request from the cache, or let it wait for
+ *  the reply of the forwarded request for the same property
+ * @param port - port where the request came from
+ * @param src - source of the request, as it was received on the port
+ * @param routed_src - routed source of the request
+ * @param dest - destination device of the request
+ * @param priority - network priority of the request
+ * @param max_apdu - largest APDU that the client accepts
+ * @param invoke_id - invoke ID of the request
+ * @param apdu - service request
+ * @param apdu_size - number of bytes in the service request
+ * @return true if the request is not forwarded
+ */
+static bool proxy_read_property(
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *routed_src,
+    const BACNET_ADDRESS *dest,
+    uint8_t priority,
+    uint16_t max_apdu,
+    uint8_t invoke_id,
+    const uint8_t *apdu,
+    unsigned apdu_size)
+{
+    struct bacnet_router_proxy_entry *entry;
+    struct bacnet_router_proxy_waiter *waiter;
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    int len;
+
+    if (rp_decode_service_request(apdu, apdu_size, &rp_data) <= 0) {
+        return false;
+    }
+    entry = proxy_entry_find(
+        dest, rp_data.object_type, rp_data.object_instance,
+        rp_data.object_property, rp_data.array_index);
+    if (!entry) {
+        return false;
+    }
+    if (proxy_entry_fresh(entry)) {
+        rp_data.application_data = entry->value;
+        rp_data.application_data_len = entry->value_len;
+        len = rp_ack_encode_apdu(NULL, invoke_id, &rp_data);
+        if ((len > 0) && (len <= max_apdu) &&
+            ((size_t)len <= sizeof(Proxy_Buffer))) {
+            len = rp_ack_encode_apdu(Proxy_Buffer, invoke_id, &rp_data);
+            if (bacnet_router_reply(
+                    port, src, dest, priority, Proxy_Buffer, (uint16_t)len)) {
+                Proxy_Hits++;
+                return true;
+            }
+        }
+    }
+    Proxy_Misses++;
+    if (!entry->refreshing) {
+        entry->refreshing = true;
+        entry->refresh_seconds = BACNET_ROUTER_PROXY_WAIT_SECONDS;
+        bacnet_address_copy(&entry->refresh_client, routed_src);
+        entry->refresh_invoke_id = invoke_id;
+        entry->waiter_count = 0;
+        return false;
+    }
+    if ((entry->refresh_invoke_id == invoke_id) &&
+        proxy_address_same(&entry->refresh_client, routed_src)) {
+        /* a retry of the forwarded request */
+        return false;
+    }
+    if (entry->waiter_count >= BACNET_ROUTER_PROXY_WAITERS_MAX) {
+        return false;
+    }
+    waiter = &entry->waiter[entry->waiter_count];
+    waiter->port = port;
+    bacnet_address_copy(&waiter->src, src);
+    waiter->invoke_id = invoke_id;
+    waiter->priority = priority;
+    waiter->max_apdu = max_apdu;
+    entry->waiter_count++;
+    debug_printf(
+        "Router Proxy: request %u waits for the reply of request %u\n",
+        (unsigned)invoke_id, (unsigned)entry->refresh_invoke_id);
+
+    return true;
+}
+
+/**
+ * @brief Answer a ReadPropertyMultiple request from the cache, when all
+ *  of the requested properties are cached and fresh
+ * @param port - port where the request came from
+ * @param src - source of the request, as it was received on the port
+ * @param dest - destination device of the request
+ * @param priority - network priority of the request
+ * @param max_apdu - largest APDU that the client accepts
+ * @param invoke_id - invoke ID of the request
+ * @param apdu - service request
+ * @param apdu_size - number of bytes in the service request
+ * @return true if the request was answered
+ */
+static bool proxy_read_property_multiple(
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *dest,
+    uint8_t priority,
+    uint16_t max_apdu,
+    uint8_t invoke_id,
+    const uint8_t *apdu,
+    unsigned apdu_size)
+{
+    struct bacnet_router_proxy_entry *entry;
+    BACNET_RPM_DATA rpm_data = { 0 };
+    unsigned apdu_max = max_apdu;
+    unsigned ack_len = 0;
+    unsigned properties = 0;
+    int len;
+
+    if (apdu_max > sizeof(Proxy_Buffer)) {
+        apdu_max = sizeof(Proxy_Buffer);
+    }
+    ack_len = (unsigned)rpm_ack_encode_apdu_init(Proxy_Buffer, invoke_id);
+    while (apdu_size) {
+        len = rpm_decode_object_id(apdu, apdu_size, &rpm_data);
+        if (len <= 0) {
+            return false;
+        }
+        apdu += len;
+        apdu_size -= len;
+        len = rpm_ack_encode_apdu_object_begin(NULL, &rpm_data);
+        if ((ack_len + len) > apdu_max) {
+            return false;
+        }
+        ack_len += rpm_ack_encode_apdu_object_begin(
+            &Proxy_Buffer[ack_len], &rpm_data);
+        for (;;) {
+            len = rpm_decode_object_end(apdu, apdu_size);
+            if (len > 0) {
+                apdu += len;
+                apdu_size -= len;
+                break;
+            }
+            len = rpm_decode_object_property(apdu, apdu_size, &rpm_data);
+            if (len <= 0) {
+                return false;
+            }
+            apdu += len;
+            apdu_size -= len;
+            entry = proxy_entry_find(
+                dest, rpm_data.object_type, rpm_data.object_instance,
+                rpm_data.object_property, rpm_data.array_index);
+            if (!entry || !proxy_entry_fresh(entry)) {
+                Proxy_Misses++;
+                return false;
+            }
+            len = rpm_ack_encode_apdu_object_property(
+                NULL, rpm_data.object_property, rpm_data.array_index);
+            len += rpm_ack_encode_apdu_object_property_value(
+                NULL, entry->value, entry->value_len);
+            if ((ack_len + len) > apdu_max) {
+                return false;
+            }
+            ack_len += rpm_ack_encode_apdu_object_property(
+                &Proxy_Buffer[ack_len], rpm_data.object_property,
+                rpm_data.array_index);
+            ack_len += rpm_ack_encode_apdu_object_property_value(
+                &Proxy_Buffer[ack_len], entry->value, entry->value_len);
+            properties++;
+        }
+        if ((ack_len + 1) > apdu_max) {
+            return false;
+        }
+        ack_len += rpm_ack_encode_apdu_object_end(&Proxy_Buffer[ack_len]);
+    }
+    if ((properties == 0) ||
+        !bacnet_router_reply(
+            port, src, dest, priority, Proxy_Buffer, (uint16_t)ack_len)) {
+        return false;
+    }
+    Proxy_Hits++;
+
+    return true;
+}
+
+/**
+ * @brief Look at a routed request for a device behind the router, and
+ *  answer it from the cache when it can
+ * @param port - port where the request came from
+ * @param src - source of the request, as it was received on the port
+ * @param routed_src - routed source of the request, with its network
+ * @param dest - destination of the request, with its network
+ * @param npdu_data - network information of the request
+ * @param apdu - APDU of the request
+ * @param apdu_len - number of bytes in the APDU
+ * @return true if the request was handled and is not forwarded
+ */
+static bool proxy_request_handler(
+    BACNET_ROUTING_PORT *port,
+    const BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *routed_src,
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *npdu_data,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    uint16_t max_apdu;
+    uint8_t invoke_id;
+
+    if ((apdu_len < 4) ||
+        ((apdu[0] & 0xF0) != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) ||
+        (apdu[0] & BIT(3))) {
+        /* only unsegmented confirmed requests */
+        return false;
+    }
+    max_apdu = (uint16_t)decode_max_apdu(apdu[1]);
+    invoke_id = apdu[2];
+    switch (apdu[3]) {
+        case SERVICE_CONFIRMED_READ_PROPERTY:
+            return proxy_read_property(
+                port, src, routed_src, dest, (uint8_t)npdu_data->priority,
+                max_apdu, invoke_id, &apdu[4], apdu_len - 4U);
+        case SERVICE_CONFIRMED_READ_PROP_MULTIPLE:
+            return proxy_read_property_multiple(
+                port, src, dest, (uint8_t)npdu_data->priority, max_apdu,
+                invoke_id, &apdu[4], apdu_len - 4U);
+        case SERVICE_CONFIRMED_WRITE_PROPERTY:
+            proxy_write_invalidate(dest, &apdu[4], apdu_len - 4U);
+            break;
+        case SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE:
+            proxy_write_invalidate(dest, NULL, 0);
+            break;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Store a value of a ReadPropertyMultiple-ACK in the cache
+ * @param device_id - not used
+ * @param rp_data - the property and its encoded value
+ */
+static void
+proxy_rpm_ack_store(uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    (void)device_id;
+    if (Proxy_RPM_Device && (rp_data->error_code == ERROR_CODE_SUCCESS)) {
+        proxy_value_store(Proxy_RPM_Device, rp_data);
+    }
+}
+
+/**
+ * @brief Store the values of a COV notification in the cache
+ * @param device - network and MAC address of the device
+ * @param apdu - service request of the notification
+ * @param apdu_size - number of bytes in the service request
+ */
+static void proxy_cov_store(
+    const BACNET_ADDRESS *device, const uint8_t *apdu, unsigned apdu_size)
+{
+    BACNET_COV_DATA cov_data = { 0 };
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_PROPERTY_VALUE *value;
+    int len;
+
+    bacapp_property_value_list_init(
+        Proxy_COV_Value, BACNET_ROUTER_PROXY_COV_VALUES_MAX);
+    cov_data.listOfValues = Proxy_COV_Value;
+    if (cov_notify_decode_service_request(apdu, apdu_size, &cov_data) <= 0) {
+        return;
+    }
+    rp_data.object_type = cov_data.monitoredObjectIdentifier.type;
+    rp_data.object_instance = cov_data.monitoredObjectIdentifier.instance;
+    value = cov_data.listOfValues;
+    while (value) {
+        len = bacapp_encode_application_data(NULL, &value->value);
+        rp_data.object_property = value->propertyIdentifier;
+        rp_data.array_index = value->propertyArrayIndex;
+        if ((len > 0) && ((size_t)len <= sizeof(Proxy_Buffer))) {
+            rp_data.application_data_len =
+                bacapp_encode_application_data(Proxy_Buffer, &value->value);
+            rp_data.application_data = Proxy_Buffer;
+        } else {
+            rp_data.application_data_len = 0;
+        }
+        proxy_value_store(device, &rp_data);
+        value = value->next;
+    }
+}
+
+/**
+ * @brief Send the reply of a forwarded request to the requests that wait
+ *  for it, with their own invoke IDs
+ * @param device - network and MAC address of the device that replied
+ * @param dest - routed destination of the reply
+ * @param apdu - APDU of the reply
+ * @param apdu_len - number of bytes in the APDU
+ */
+static void proxy_waiters_release(
+    const BACNET_ADDRESS *device,
+    const BACNET_ADDRESS *dest,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    struct bacnet_router_proxy_entry *entry;
+    struct bacnet_router_proxy_waiter *waiter;
+    unsigned i, w;
+
+    for (i = 0; i < BACNET_ROUTER_PROXY_ENTRIES_MAX; i++) {
+        entry = &Proxy_Entry[i];
+        if (!entry->used || !entry->refreshing ||
+            (entry->refresh_invoke_id != apdu[1]) ||
+            !proxy_address_same(&entry->device, device) ||
+            !proxy_address_same(&entry->refresh_client, dest)) {
+            continue;
+        }
+        if (apdu_len <= sizeof(Proxy_Buffer)) {
+            memcpy(Proxy_Buffer, apdu, apdu_len);
+            for (w = 0; w < entry->waiter_count; w++) {
+                waiter = &entry->waiter[w];
+                if (apdu_len > waiter->max_apdu) {
+                    continue;
+                }
+                Proxy_Buffer[1] = waiter->invoke_id;
+                (void)bacnet_router_reply(
+                    waiter->port, &waiter->src, device, waiter->priority,
+                    Proxy_Buffer, apdu_len);
+            }
+        }
+        entry->refreshing = false;
+        entry->waiter_count = 0;
+    }
+}
+
+/**
+ * @brief Look at a routed message from a device, and keep the values of
+ *  its replies and COV notifications
+ * @param routed_src - routed source of the message, with its network
+ * @param dest - destination of the message, with its network
+ * @param apdu - APDU of the message
+ * @param apdu_len - number of bytes in the APDU
+ */
+static void proxy_response_handler(
+    const BACNET_ADDRESS *routed_src,
+    const BACNET_ADDRESS *dest,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    uint8_t pdu_type;
+
+    if ((apdu_len < 2) || (apdu_len > sizeof(Proxy_Buffer))) {
+        return;
+    }
+    pdu_type = apdu[0] & 0xF0;
+    switch (pdu_type) {
+        case PDU_TYPE_COMPLEX_ACK:
+            if ((apdu[0] & BIT(3)) || (apdu_len < 3)) {
+                /* the segments of a reply are not looked at */
+                return;
+            }
+            /* the decoders want a buffer that they may write */
+            memcpy(Proxy_Buffer, apdu, apdu_len);
+            if (apdu[2] == SERVICE_CONFIRMED_READ_PROPERTY) {
+                if (rp_ack_decode_service_request(
+                        &Proxy_Buffer[3], apdu_len - 3, &rp_data) > 0) {
+                    proxy_value_store(routed_src, &rp_data);
+                }
+            } else if (apdu[2] == SERVICE_CONFIRMED_READ_PROP_MULTIPLE) {
+                Proxy_RPM_Device = routed_src;
+                rpm_ack_object_property_process(
+                    &Proxy_Buffer[3], apdu_len - 3U, 0, &rp_data,
+                    proxy_rpm_ack_store);
+                Proxy_RPM_Device = NULL;
+            }
+            proxy_waiters_release(routed_src, dest, apdu, apdu_len);
+            break;
+        case PDU_TYPE_ERROR:
+        case PDU_TYPE_REJECT:
+        case PDU_TYPE_ABORT:
+            proxy_waiters_release(routed_src, dest, apdu, apdu_len);
+            break;
+        case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
+            if (apdu[1] == SERVICE_UNCONFIRMED_COV_NOTIFICATION) {
+                proxy_cov_store(routed_src, &apdu[2], apdu_len - 2U);
+            }
+            break;
+        case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
+            if (!(apdu[0] & BIT(3)) && (apdu_len > 4) &&
+                (apdu[3] == SERVICE_CONFIRMED_COV_NOTIFICATION)) {
+                proxy_cov_store(routed_src, &apdu[4], apdu_len - 4U);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Add a property of a device behind the router to the cache
+ * @param device - network and MAC address of the device
+ * @param object_type - object type of the property
+ * @param object_instance - object instance of the property
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param max_age - seconds that a value of the property is used
+ * @return true if the property was added, or was already cached
+ */
+bool bacnet_router_proxy_add(
+    const BACNET_ADDRESS *device,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    uint16_t max_age)
+{
+    struct bacnet_router_proxy_entry *entry;
+    unsigned i;
+
+    if (!device || (device->len == 0) || (device->len > MAX_MAC_LEN)) {
+        return false;
+    }
+    entry = proxy_entry_find(
+        device, object_type, object_instance, object_property, array_index);
+    if (entry) {
+        entry->max_age = max_age;
+        return true;
+    }
+    for (i = 0; i < BACNET_ROUTER_PROXY_ENTRIES_MAX; i++) {
+        entry = &Proxy_Entry[i];
+        if (!entry->used) {
+            memset(entry, 0, sizeof(*entry));
+            entry->used = true;
+            entry->device.net = device->net;
+            entry->device.len = device->len;
+            memcpy(entry->device.adr, device->adr, device->len);
+            entry->object_type = object_type;
+            entry->object_instance = object_instance;
+            entry->object_property = object_property;
+            entry->array_index = array_index;
+            entry->max_age = max_age;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Age the cached values, and stop waiting for the replies that
+ *  did not come
+ * @param seconds - number of seconds since the last call
+ */
+void bacnet_router_proxy_timer(uint16_t seconds)
+{
+    struct bacnet_router_proxy_entry *entry;
+    unsigned i;
+
+    for (i = 0; i < BACNET_ROUTER_PROXY_ENTRIES_MAX; i++) {
+        entry = &Proxy_Entry[i];
+        if (!entry->used) {
+            continue;
+        }
+        if (entry->age < (UINT16_MAX - seconds)) {
+            entry->age += seconds;
+        } else {
+            entry->age = UINT16_MAX;
+        }
+        if (entry->refreshing) {
+            if (entry->refresh_seconds > seconds) {
+                entry->refresh_seconds -= seconds;
+            } else {
+                /* the clients that wait will retry */
+                entry->refreshing = false;
+                entry->refresh_seconds = 0;
+                entry->waiter_count = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Get the number of requests that were answered from the cache
+ * @return number of requests
+ */
+unsigned long bacnet_router_proxy_hits(void)
+{
+    return Proxy_Hits;
+}
+
+/**
+ * @brief Get the number of requests of cached properties that were
+ *  forwarded to the device
+ * @return number of requests
+ */
+unsigned long bacnet_router_proxy_misses(void)
+{
+    return Proxy_Misses;
+}
+
+/**
+ * @brief Start the proxy with an empty cache, and let it look at the
+ *  messages that the router forwards
+ */
+void bacnet_router_proxy_init(void)
+{
+    memset(Proxy_Entry, 0, sizeof(Proxy_Entry));
+    Proxy_Hits = 0;
+    Proxy_Misses = 0;
+    bacnet_router_proxy_set(proxy_request_handler, proxy_response_handler);
+}
+
+/**
+ * @brief Stop the proxy, and forget the cache
+ */
+void bacnet_router_proxy_cleanup(void)
+{
+    bacnet_router_proxy_set(NULL, NULL);
+    memset(Proxy_Entry, 0, sizeof(Proxy_Entry));
+}
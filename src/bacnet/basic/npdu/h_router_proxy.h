@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @brief API for a caching read proxy for the devices behind a router
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_NPDU_ROUTER_PROXY_H
+#define BACNET_BASIC_NPDU_ROUTER_PROXY_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* number of properties that are cached */
+#ifndef BACNET_ROUTER_PROXY_ENTRIES_MAX
+#define BACNET_ROUTER_PROXY_ENTRIES_MAX 32
+#endif
+/* number of octets of the encoded value of a cached property */
+#ifndef BACNET_ROUTER_PROXY_VALUE_MAX
+#define BACNET_ROUTER_PROXY_VALUE_MAX 64
+#endif
+/* number of requests of a property that wait for the same reply */
+#ifndef BACNET_ROUTER_PROXY_WAITERS_MAX
+#define BACNET_ROUTER_PROXY_WAITERS_MAX 4
+#endif
+/* seconds that the requests wait for the reply of the device */
+#ifndef BACNET_ROUTER_PROXY_WAIT_SECONDS
+#define BACNET_ROUTER_PROXY_WAIT_SECONDS 6
+#endif
+/* number of values in a COV notification that are looked at */
+#ifndef BACNET_ROUTER_PROXY_COV_VALUES_MAX
+#define BACNET_ROUTER_PROXY_COV_VALUES_MAX 4
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_router_proxy_init(void);
+BACNET_STACK_EXPORT
+bool bacnet_router_proxy_add(
+    const BACNET_ADDRESS *device,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    uint16_t max_age);
+BACNET_STACK_EXPORT
+void bacnet_router_proxy_timer(uint16_t seconds);
+BACNET_STACK_EXPORT
+unsigned long bacnet_router_proxy_hits(void);
+BACNET_STACK_EXPORT
+unsigned long bacnet_router_proxy_misses(void);
+BACNET_STACK_EXPORT
+void bacnet_router_proxy_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
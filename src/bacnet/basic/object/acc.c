@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -40,7 +41,26 @@ struct object_data {
     BACNET_ENGINEERING_UNITS Units;
     int32_t Scale;
     bool Out_Of_Service : 1;
+    bool Changed : 1;
+    bool Pulse_Counter_Valid : 1;
     void *Context;
+    /* pulses that are not yet in the Present_Value */
+    uint32_t Pulses_Pending;
+    /* last snapshot of a free-running hardware pulse counter */
+    uint32_t Pulse_Counter;
+    /* Prescale: Multiplier units of Present_Value per Modulo_Divide pulses */
+    uint32_t Prescale_Multiplier;
+    uint32_t Prescale_Modulo_Divide;
+    /* pulses times multiplier that are less than one Modulo_Divide */
+    uint32_t Prescale_Remainder;
+    /* Pulse_Rate over a window of Limit_Monitoring_Interval seconds */
+    BACNET_UNSIGNED_INTEGER Pulse_Rate;
+    uint32_t Limit_Monitoring_Interval;
+    uint32_t Pulse_Rate_Slot[ACCUMULATOR_PULSE_RATE_SLOTS];
+    uint8_t Pulse_Rate_Slot_Index;
+    uint32_t Pulse_Rate_Slot_Elapsed;
+    /* Present_Value at the last reporting boundary */
+    BACNET_UNSIGNED_INTEGER Reported_Value;
 };
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
@@ -59,7 +79,11 @@ static const int32_t Properties_Required[] = {
     -1
 };
 
-static const int32_t Properties_Optional[] = { PROP_DESCRIPTION, -1 };
+static const int32_t Properties_Optional[] = {
+    /* unordered list of optional properties */
+    PROP_DESCRIPTION, PROP_PRESCALE, PROP_PULSE_RATE,
+    PROP_LIMIT_MONITORING_INTERVAL, -1
+};
 
 static const int32_t Properties_Proprietary[] = { -1 };
 
@@ -75,6 +99,7 @@ static const int32_t Writable_Properties[] = {
     PROP_SCALE,
     PROP_UNITS,
     PROP_MAX_PRES_VALUE,
+    PROP_LIMIT_MONITORING_INTERVAL,
     -1
 };
 
@@ -477,6 +502,273 @@ bool Accumulator_Out_Of_Service_Set(uint32_t object_instance, bool value)
     return status;
 }
 
+/**
+ * @brief For a given object instance-number, returns the Prescale
+ * @param  object_instance - object-instance number of the object
+ * @param  multiplier - [out] units of Present_Value per modulo_divide pulses
+ * @param  modulo_divide - [out] number of pulses per multiplier units
+ * @return true if the object instance exists
+ */
+bool Accumulator_Prescale(
+    uint32_t object_instance, uint32_t *multiplier, uint32_t *modulo_divide)
+{
+    bool status = false;
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject) {
+        if (multiplier) {
+            *multiplier = pObject->Prescale_Multiplier;
+        }
+        if (modulo_divide) {
+            *modulo_divide = pObject->Prescale_Modulo_Divide;
+        }
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, sets the Prescale
+ *  which converts the pulses into Present_Value units in fixed point:
+ *  each modulo_divide pulses add multiplier to the Present_Value.
+ * @param  object_instance - object-instance number of the object
+ * @param  multiplier - units of Present_Value per modulo_divide pulses
+ * @param  modulo_divide - number of pulses per multiplier units
+ * @return true if the object instance exists and the values are valid
+ */
+bool Accumulator_Prescale_Set(
+    uint32_t object_instance, uint32_t multiplier, uint32_t modulo_divide)
+{
+    bool status = false;
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject && (multiplier > 0) && (modulo_divide > 0)) {
+        pObject->Prescale_Multiplier = multiplier;
+        pObject->Prescale_Modulo_Divide = modulo_divide;
+        pObject->Prescale_Remainder = 0;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, adds a batch of pulses.
+ *  The pulses are only counted here; they are scaled into the
+ *  Present_Value by Accumulator_Timer() so that high pulse rates
+ *  cost a single addition per batch.
+ * @param  object_instance - object-instance number of the object
+ * @param  pulses - number of pulses since the last batch
+ * @return true if the object instance exists
+ */
+bool Accumulator_Pulses_Add(uint32_t object_instance, uint32_t pulses)
+{
+    bool status = false;
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject) {
+        pObject->Pulses_Pending += pulses;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, adds the pulses counted by
+ *  a free-running hardware counter since its previous snapshot. The
+ *  counter is owned by the interrupt or DMA, and only read here, so no
+ *  locking is needed. The counter may wrap around. The first snapshot
+ *  only sets the starting point.
+ * @param  object_instance - object-instance number of the object
+ * @param  counter - the present value of the free-running counter
+ * @return true if the object instance exists
+ */
+bool Accumulator_Pulse_Counter_Update(
+    uint32_t object_instance, uint32_t counter)
+{
+    bool status = false;
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject) {
+        if (pObject->Pulse_Counter_Valid) {
+            pObject->Pulses_Pending += counter - pObject->Pulse_Counter;
+        }
+        pObject->Pulse_Counter = counter;
+        pObject->Pulse_Counter_Valid = true;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, returns the Pulse_Rate
+ * @param  object_instance - object-instance number of the object
+ * @return number of pulses in the last Limit_Monitoring_Interval seconds
+ */
+BACNET_UNSIGNED_INTEGER Accumulator_Pulse_Rate(uint32_t object_instance)
+{
+    BACNET_UNSIGNED_INTEGER value = 0;
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject) {
+        value = pObject->Pulse_Rate;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, returns the
+ *  Limit_Monitoring_Interval
+ * @param  object_instance - object-instance number of the object
+ * @return the window of the Pulse_Rate, in seconds
+ */
+uint32_t Accumulator_Limit_Monitoring_Interval(uint32_t object_instance)
+{
+    uint32_t value = 0;
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject) {
+        value = pObject->Limit_Monitoring_Interval;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the
+ *  Limit_Monitoring_Interval, and restarts the Pulse_Rate window
+ * @param  object_instance - object-instance number of the object
+ * @param  seconds - the window of the Pulse_Rate, in seconds
+ * @return true if the object instance exists and the value is valid
+ */
+bool Accumulator_Limit_Monitoring_Interval_Set(
+    uint32_t object_instance, uint32_t seconds)
+{
+    bool status = false;
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject && (seconds > 0)) {
+        pObject->Limit_Monitoring_Interval = seconds;
+        memset(pObject->Pulse_Rate_Slot, 0, sizeof(pObject->Pulse_Rate_Slot));
+        pObject->Pulse_Rate_Slot_Index = 0;
+        pObject->Pulse_Rate_Slot_Elapsed = 0;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines if the
+ *  Present_Value changed at the last reporting boundary
+ * @param  object_instance - object-instance number of the object
+ * @return true if the Present_Value changed
+ */
+bool Accumulator_Change_Of_Value(uint32_t object_instance)
+{
+    bool changed = false;
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject) {
+        changed = pObject->Changed;
+    }
+
+    return changed;
+}
+
+/**
+ * @brief For a given object instance-number, clears the COV flag
+ * @param  object_instance - object-instance number of the object
+ */
+void Accumulator_Change_Of_Value_Clear(uint32_t object_instance)
+{
+    struct object_data *pObject = Object_Data(object_instance);
+
+    if (pObject) {
+        pObject->Changed = false;
+    }
+}
+
+/**
+ * @brief Adds a number of Present_Value units, rolling over to zero
+ *  after the Max_Pres_Value
+ * @param pObject - object data
+ * @param units - number of units to add
+ */
+static void Accumulator_Present_Value_Add(
+    struct object_data *pObject, uint64_t units)
+{
+    BACNET_UNSIGNED_INTEGER room;
+
+    room = pObject->Max_Pres_Value - pObject->Present_Value;
+    if (pObject->Present_Value > pObject->Max_Pres_Value) {
+        room = 0;
+    }
+    if (units <= room) {
+        pObject->Present_Value += units;
+    } else {
+        units -= room;
+        units -= 1;
+        if (pObject->Max_Pres_Value < BACNET_UNSIGNED_INTEGER_MAX) {
+            units %= (uint64_t)pObject->Max_Pres_Value + 1;
+        }
+        pObject->Present_Value = units;
+    }
+}
+
+/**
+ * @brief Scales the pending pulses into the Present_Value, and updates
+ *  the Pulse_Rate. At each slot boundary of the Pulse_Rate window the
+ *  Present_Value is reported: the COV flag is set if it has changed.
+ * @param  object_instance - object-instance number of the object
+ * @param  milliseconds - number of milliseconds elapsed
+ */
+void Accumulator_Timer(uint32_t object_instance, uint16_t milliseconds)
+{
+    struct object_data *pObject = Object_Data(object_instance);
+    uint32_t pulses, slot_time;
+    uint64_t units;
+    unsigned i;
+
+    if (!pObject) {
+        return;
+    }
+    pulses = pObject->Pulses_Pending;
+    pObject->Pulses_Pending = 0;
+    if ((pulses > 0) && !pObject->Out_Of_Service) {
+        units = (uint64_t)pulses * pObject->Prescale_Multiplier;
+        units += pObject->Prescale_Remainder;
+        pObject->Prescale_Remainder =
+            (uint32_t)(units % pObject->Prescale_Modulo_Divide);
+        units /= pObject->Prescale_Modulo_Divide;
+        Accumulator_Present_Value_Add(pObject, units);
+    }
+    i = pObject->Pulse_Rate_Slot_Index;
+    pObject->Pulse_Rate_Slot[i] += pulses;
+    pObject->Pulse_Rate_Slot_Elapsed += milliseconds;
+    slot_time =
+        (pObject->Limit_Monitoring_Interval * 1000UL) /
+        ACCUMULATOR_PULSE_RATE_SLOTS;
+    if (pObject->Pulse_Rate_Slot_Elapsed >= slot_time) {
+        pObject->Pulse_Rate_Slot_Elapsed = 0;
+        pObject->Pulse_Rate = 0;
+        for (i = 0; i < ACCUMULATOR_PULSE_RATE_SLOTS; i++) {
+            pObject->Pulse_Rate += pObject->Pulse_Rate_Slot[i];
+        }
+        i = (pObject->Pulse_Rate_Slot_Index + 1) % ACCUMULATOR_PULSE_RATE_SLOTS;
+        pObject->Pulse_Rate_Slot_Index = i;
+        pObject->Pulse_Rate_Slot[i] = 0;
+        if (pObject->Present_Value != pObject->Reported_Value) {
+            pObject->Reported_Value = pObject->Present_Value;
+            pObject->Changed = true;
+        }
+    }
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -492,6 +784,7 @@ int Accumulator_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_len = 0; /* return value */
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
+    uint32_t multiplier = 0, modulo_divide = 0;
     uint8_t *apdu = NULL;
 
     if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
@@ -554,6 +847,25 @@ int Accumulator_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len =
                 encode_application_character_string(&apdu[0], &char_string);
             break;
+        case PROP_PRESCALE:
+            /* BACnetPrescale ::= SEQUENCE {
+                multiplier [0] Unsigned, moduloDivide [1] Unsigned } */
+            Accumulator_Prescale(
+                rpdata->object_instance, &multiplier, &modulo_divide);
+            apdu_len = encode_context_unsigned(&apdu[0], 0, multiplier);
+            apdu_len +=
+                encode_context_unsigned(&apdu[apdu_len], 1, modulo_divide);
+            break;
+        case PROP_PULSE_RATE:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], Accumulator_Pulse_Rate(rpdata->object_instance));
+            break;
+        case PROP_LIMIT_MONITORING_INTERVAL:
+            apdu_len = encode_application_unsigned(
+                &apdu[0],
+                Accumulator_Limit_Monitoring_Interval(
+                    rpdata->object_instance));
+            break;
         default:
             rpdata->error_class = ERROR_CLASS_PROPERTY;
             rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
@@ -660,6 +972,21 @@ bool Accumulator_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     wp_data->object_instance, value.type.Unsigned_Int);
             }
             break;
+        case PROP_LIMIT_MONITORING_INTERVAL:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                if ((value.type.Unsigned_Int > 0) &&
+                    (value.type.Unsigned_Int <= UINT16_MAX)) {
+                    Accumulator_Limit_Monitoring_Interval_Set(
+                        wp_data->object_instance, value.type.Unsigned_Int);
+                } else {
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                    status = false;
+                }
+            }
+            break;
         default:
             if (property_lists_member(
                     Properties_Required, Properties_Optional,
@@ -752,6 +1079,9 @@ uint32_t Accumulator_Create(uint32_t object_instance)
             pObject->Units = UNITS_WATT_HOURS;
             pObject->Scale = 1;
             pObject->Max_Pres_Value = BACNET_UNSIGNED_INTEGER_MAX;
+            pObject->Prescale_Multiplier = 1;
+            pObject->Prescale_Modulo_Divide = 1;
+            pObject->Limit_Monitoring_Interval = 60;
             /* Out_Of_Service is used to simulate a fault condition,
                so set to false by default */
             pObject->Out_Of_Service = false;
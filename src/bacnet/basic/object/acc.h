@@ -17,6 +17,11 @@
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 
+/* number of slots in the sliding window of the Pulse_Rate */
+#ifndef ACCUMULATOR_PULSE_RATE_SLOTS
+#define ACCUMULATOR_PULSE_RATE_SLOTS 6
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -91,6 +96,33 @@ int32_t Accumulator_Scale_Integer(uint32_t object_instance);
 BACNET_STACK_EXPORT
 bool Accumulator_Scale_Integer_Set(uint32_t object_instance, int32_t);
 
+BACNET_STACK_EXPORT
+bool Accumulator_Prescale(
+    uint32_t object_instance, uint32_t *multiplier, uint32_t *modulo_divide);
+BACNET_STACK_EXPORT
+bool Accumulator_Prescale_Set(
+    uint32_t object_instance, uint32_t multiplier, uint32_t modulo_divide);
+
+BACNET_STACK_EXPORT
+bool Accumulator_Pulses_Add(uint32_t object_instance, uint32_t pulses);
+BACNET_STACK_EXPORT
+bool Accumulator_Pulse_Counter_Update(
+    uint32_t object_instance, uint32_t counter);
+BACNET_STACK_EXPORT
+BACNET_UNSIGNED_INTEGER Accumulator_Pulse_Rate(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Accumulator_Limit_Monitoring_Interval(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Accumulator_Limit_Monitoring_Interval_Set(
+    uint32_t object_instance, uint32_t seconds);
+
+BACNET_STACK_EXPORT
+bool Accumulator_Change_Of_Value(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Accumulator_Change_Of_Value_Clear(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Accumulator_Timer(uint32_t object_instance, uint16_t milliseconds);
+
 BACNET_STACK_EXPORT
 bool Accumulator_Out_Of_Service(uint32_t object_instance);
 BACNET_STACK_EXPORT
@@ -19,7 +19,10 @@
 #include "bacnet/proplist.h"
 #include "bacnet/basic/object/access_credential.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/keyhash.h"
 /* BACnet Stack Objects */
+#include "bacnet/basic/object/access_point.h"
+#include "bacnet/basic/object/access_rights.h"
 #include "bacnet/basic/object/device.h"
 
 static bool Access_Credential_Initialized = false;
@@ -31,6 +34,21 @@ static ACCESS_CREDENTIAL_DESCR ac_descrs[MAX_NUM_DEVICES]
 #else
 #define ac_descr (ac_descrs[0])
 #endif
+/* index of the hash of each authentication factor value
+   to the instance of the credential that holds the factor */
+static OS_Keyhash Authentication_Factor_Indexes[MAX_NUM_DEVICES];
+/* index of the instance of each credential to the instance of
+   each access point where its assigned access rights grant access */
+static OS_Keyhash Authorization_Indexes[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Authentication_Factor_Index \
+    (Authentication_Factor_Indexes[Routed_Device_Object_Index()])
+#define Authorization_Index \
+    (Authorization_Indexes[Routed_Device_Object_Index()])
+#else
+#define Authentication_Factor_Index (Authentication_Factor_Indexes[0])
+#define Authorization_Index (Authorization_Indexes[0])
+#endif
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Properties_Required[] = {
@@ -124,6 +142,12 @@ void Access_Credential_Init(void)
                 ac_descr[i].credential_disable = ACCESS_CREDENTIAL_DISABLE_NONE;
                 ac_descr[i].assigned_access_rights_count = 0;
             }
+            if (!Authentication_Factor_Index) {
+                Authentication_Factor_Index = Keyhash_Create();
+            }
+            if (!Authorization_Index) {
+                Authorization_Index = Keyhash_Create();
+            }
         }
     }
 
@@ -192,6 +216,371 @@ bool Access_Credential_Object_Name(
     return status;
 }
 
+/**
+ * @brief Compute the hash of an authentication factor for the index
+ * @param factor [in] The authentication factor
+ * @return hash of the encoded format type, format class, and value
+ */
+static uint32_t
+Access_Credential_Factor_Hash(const BACNET_AUTHENTICATION_FACTOR *factor)
+{
+    uint8_t buffer[MAX_OCTET_STRING_BYTES + 16];
+    int len;
+
+    len = bacapp_encode_authentication_factor(NULL, factor);
+    if ((len <= 0) || (len > (int)sizeof(buffer))) {
+        return Keyhash_FNV1a(
+            factor->value.value, octetstring_length(&factor->value));
+    }
+    len = bacapp_encode_authentication_factor(buffer, factor);
+
+    return Keyhash_FNV1a(buffer, (size_t)len);
+}
+
+/**
+ * @brief Compare two authentication factors
+ * @param factor1 [in] The first authentication factor
+ * @param factor2 [in] The second authentication factor
+ * @return true if the format type, format class, and value are the same
+ */
+static bool Access_Credential_Factor_Same(
+    const BACNET_AUTHENTICATION_FACTOR *factor1,
+    const BACNET_AUTHENTICATION_FACTOR *factor2)
+{
+    return (factor1->format_type == factor2->format_type) &&
+        (factor1->format_class == factor2->format_class) &&
+        octetstring_value_same(&factor1->value, &factor2->value);
+}
+
+/**
+ * @brief Determine if an assigned access rights reference is an
+ *  enabled Access Rights object in this device
+ * @param rights [in] The assigned access rights
+ * @return true if the access rights are evaluated locally
+ */
+static bool
+Access_Credential_Rights_Local(const BACNET_ASSIGNED_ACCESS_RIGHTS *rights)
+{
+    const BACNET_DEVICE_OBJECT_REFERENCE *reference;
+
+    if (!rights->enable) {
+        return false;
+    }
+    reference = &rights->assigned_access_rights;
+    if (reference->objectIdentifier.type != OBJECT_ACCESS_RIGHTS) {
+        return false;
+    }
+    if ((reference->deviceIdentifier.type == OBJECT_DEVICE) &&
+        (reference->deviceIdentifier.instance !=
+         Device_Object_Instance_Number())) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove a credential from the authentication factor and
+ *  authorization indexes
+ * @param object_instance [in] The credential object instance number
+ */
+static void Access_Credential_Index_Remove(uint32_t object_instance)
+{
+    uint32_t i;
+    uint32_t hash;
+    unsigned iterator;
+    KEY key = 0;
+
+    for (i = 0; i < ac_descr[object_instance].auth_factors_count; i++) {
+        hash = Access_Credential_Factor_Hash(
+            &ac_descr[object_instance].auth_factors[i].authentication_factor);
+        (void)Keyhash_Remove(
+            Authentication_Factor_Index, hash, object_instance);
+    }
+    iterator = 0;
+    while (
+        Keyhash_Find(Authorization_Index, object_instance, &iterator, &key)) {
+        (void)Keyhash_Remove(Authorization_Index, object_instance, key);
+        iterator = 0;
+    }
+}
+
+/**
+ * @brief Add a credential to the authentication factor index, and
+ *  precompute the access points where its assigned access rights
+ *  grant access, so that a presented factor is a constant time decision
+ * @param object_instance [in] The credential object instance number
+ */
+static void Access_Credential_Index_Add(uint32_t object_instance)
+{
+    uint32_t i;
+    uint32_t hash;
+    unsigned index, count;
+    uint32_t access_point_instance;
+    const BACNET_ASSIGNED_ACCESS_RIGHTS *rights;
+
+    if (!Authentication_Factor_Index) {
+        Authentication_Factor_Index = Keyhash_Create();
+    }
+    if (!Authorization_Index) {
+        Authorization_Index = Keyhash_Create();
+    }
+    for (i = 0; i < ac_descr[object_instance].auth_factors_count; i++) {
+        hash = Access_Credential_Factor_Hash(
+            &ac_descr[object_instance].auth_factors[i].authentication_factor);
+        if (!Keyhash_Member(
+                Authentication_Factor_Index, hash, object_instance)) {
+            (void)Keyhash_Add(
+                Authentication_Factor_Index, hash, object_instance);
+        }
+    }
+    count = Access_Point_Count();
+    for (index = 0; index < count; index++) {
+        access_point_instance = Access_Point_Index_To_Instance(index);
+        for (i = 0; i < ac_descr[object_instance].assigned_access_rights_count;
+             i++) {
+            rights = &ac_descr[object_instance].assigned_access_rights[i];
+            if (Access_Credential_Rights_Local(rights) &&
+                Access_Rights_Access_Point_Granted(
+                    rights->assigned_access_rights.objectIdentifier.instance,
+                    access_point_instance)) {
+                (void)Keyhash_Add(
+                    Authorization_Index, object_instance,
+                    access_point_instance);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Rebuild the authentication factor and authorization indexes
+ *  of every credential.
+ * @note Call this after the access rules of an Access Rights object,
+ *  or the Access Point objects, are changed.
+ */
+void Access_Credential_Index_Rebuild(void)
+{
+    unsigned i;
+
+    Keyhash_Clear(Authentication_Factor_Index);
+    Keyhash_Clear(Authorization_Index);
+    for (i = 0; i < MAX_ACCESS_CREDENTIALS; i++) {
+        Access_Credential_Index_Add(i);
+    }
+}
+
+/**
+ * @brief Find the credential that holds an authentication factor
+ * @param factor [in] The presented authentication factor
+ * @param object_instance [out] The credential object instance number
+ * @param disable [out] The disable value of the credential factor,
+ *  or NULL if not needed
+ * @return true if a credential holds the authentication factor
+ */
+bool Access_Credential_Authentication_Factor_Find(
+    const BACNET_AUTHENTICATION_FACTOR *factor,
+    uint32_t *object_instance,
+    BACNET_ACCESS_AUTHENTICATION_FACTOR_DISABLE *disable)
+{
+    uint32_t i;
+    unsigned iterator = 0;
+    KEY key = 0;
+    const BACNET_CREDENTIAL_AUTHENTICATION_FACTOR *candidate;
+
+    if (!factor) {
+        return false;
+    }
+    while (Keyhash_Find(
+        Authentication_Factor_Index, Access_Credential_Factor_Hash(factor),
+        &iterator, &key)) {
+        if (key >= MAX_ACCESS_CREDENTIALS) {
+            continue;
+        }
+        for (i = 0; i < ac_descr[key].auth_factors_count; i++) {
+            candidate = &ac_descr[key].auth_factors[i];
+            if (Access_Credential_Factor_Same(
+                    &candidate->authentication_factor, factor)) {
+                if (object_instance) {
+                    *object_instance = key;
+                }
+                if (disable) {
+                    *disable = candidate->disable;
+                }
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determine if the assigned access rights of a credential grant
+ *  access at an access point, from the precomputed authorization index
+ * @param object_instance [in] The credential object instance number
+ * @param access_point_instance [in] The access point object instance number
+ * @return true if access is granted at the access point
+ */
+bool Access_Credential_Access_Point_Authorized(
+    uint32_t object_instance, uint32_t access_point_instance)
+{
+    return Keyhash_Member(
+        Authorization_Index, object_instance, access_point_instance);
+}
+
+/**
+ * @brief For a given object instance-number, determines the credential
+ *  status value
+ * @param object_instance [in] The credential object instance number
+ * @return true if the credential status is active
+ */
+bool Access_Credential_Status(uint32_t object_instance)
+{
+    bool value = false;
+
+    if (object_instance < MAX_ACCESS_CREDENTIALS) {
+        value = ac_descr[object_instance].credential_status;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the credential status
+ * @param object_instance [in] The credential object instance number
+ * @param active [in] true if the credential status is active
+ * @return true if the value was set
+ */
+bool Access_Credential_Status_Set(uint32_t object_instance, bool active)
+{
+    bool status = false;
+
+    if (object_instance < MAX_ACCESS_CREDENTIALS) {
+        ac_descr[object_instance].credential_status = active;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines the credential
+ *  disable value
+ * @param object_instance [in] The credential object instance number
+ * @return the credential disable value
+ */
+BACNET_ACCESS_CREDENTIAL_DISABLE
+Access_Credential_Disable(uint32_t object_instance)
+{
+    BACNET_ACCESS_CREDENTIAL_DISABLE value = ACCESS_CREDENTIAL_DISABLE_NONE;
+
+    if (object_instance < MAX_ACCESS_CREDENTIALS) {
+        value = ac_descr[object_instance].credential_disable;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the credential disable
+ * @param object_instance [in] The credential object instance number
+ * @param value [in] The credential disable value
+ * @return true if the value was set
+ */
+bool Access_Credential_Disable_Set(
+    uint32_t object_instance, BACNET_ACCESS_CREDENTIAL_DISABLE value)
+{
+    bool status = false;
+
+    if ((object_instance < MAX_ACCESS_CREDENTIALS) &&
+        (value <= ACCESS_CREDENTIAL_DISABLE_PROPRIETARY_MAX)) {
+        ac_descr[object_instance].credential_disable = value;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Add an authentication factor to the credential
+ * @param object_instance [in] The credential object instance number
+ * @param factor [in] The credential authentication factor to add
+ * @return true if the authentication factor was added
+ */
+bool Access_Credential_Authentication_Factor_Add(
+    uint32_t object_instance,
+    const BACNET_CREDENTIAL_AUTHENTICATION_FACTOR *factor)
+{
+    uint32_t count;
+
+    if ((object_instance >= MAX_ACCESS_CREDENTIALS) || !factor) {
+        return false;
+    }
+    count = ac_descr[object_instance].auth_factors_count;
+    if (count >= MAX_AUTHENTICATION_FACTORS) {
+        return false;
+    }
+    Access_Credential_Index_Remove(object_instance);
+    ac_descr[object_instance].auth_factors[count] = *factor;
+    ac_descr[object_instance].auth_factors_count++;
+    Access_Credential_Index_Add(object_instance);
+
+    return true;
+}
+
+/**
+ * @brief Remove all the authentication factors of the credential
+ * @param object_instance [in] The credential object instance number
+ */
+void Access_Credential_Authentication_Factors_Clear(uint32_t object_instance)
+{
+    if (object_instance < MAX_ACCESS_CREDENTIALS) {
+        Access_Credential_Index_Remove(object_instance);
+        ac_descr[object_instance].auth_factors_count = 0;
+        Access_Credential_Index_Add(object_instance);
+    }
+}
+
+/**
+ * @brief Add an assigned access rights to the credential
+ * @param object_instance [in] The credential object instance number
+ * @param rights [in] The assigned access rights to add
+ * @return true if the assigned access rights were added
+ */
+bool Access_Credential_Assigned_Access_Rights_Add(
+    uint32_t object_instance, const BACNET_ASSIGNED_ACCESS_RIGHTS *rights)
+{
+    uint32_t count;
+
+    if ((object_instance >= MAX_ACCESS_CREDENTIALS) || !rights) {
+        return false;
+    }
+    count = ac_descr[object_instance].assigned_access_rights_count;
+    if (count >= MAX_ASSIGNED_ACCESS_RIGHTS) {
+        return false;
+    }
+    Access_Credential_Index_Remove(object_instance);
+    ac_descr[object_instance].assigned_access_rights[count] = *rights;
+    ac_descr[object_instance].assigned_access_rights_count++;
+    Access_Credential_Index_Add(object_instance);
+
+    return true;
+}
+
+/**
+ * @brief Remove all the assigned access rights of the credential
+ * @param object_instance [in] The credential object instance number
+ */
+void Access_Credential_Assigned_Access_Rights_Clear(uint32_t object_instance)
+{
+    if (object_instance < MAX_ACCESS_CREDENTIALS) {
+        Access_Credential_Index_Remove(object_instance);
+        ac_descr[object_instance].assigned_access_rights_count = 0;
+        Access_Credential_Index_Add(object_instance);
+    }
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -83,6 +83,39 @@ bool Access_Credential_Object_Name(
 BACNET_STACK_EXPORT
 bool Access_Credential_Name_Set(uint32_t object_instance, char *new_name);
 
+BACNET_STACK_EXPORT
+bool Access_Credential_Status(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Access_Credential_Status_Set(uint32_t object_instance, bool active);
+BACNET_STACK_EXPORT
+BACNET_ACCESS_CREDENTIAL_DISABLE
+Access_Credential_Disable(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Access_Credential_Disable_Set(
+    uint32_t object_instance, BACNET_ACCESS_CREDENTIAL_DISABLE value);
+BACNET_STACK_EXPORT
+bool Access_Credential_Authentication_Factor_Add(
+    uint32_t object_instance,
+    const BACNET_CREDENTIAL_AUTHENTICATION_FACTOR *factor);
+BACNET_STACK_EXPORT
+void Access_Credential_Authentication_Factors_Clear(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Access_Credential_Assigned_Access_Rights_Add(
+    uint32_t object_instance, const BACNET_ASSIGNED_ACCESS_RIGHTS *rights);
+BACNET_STACK_EXPORT
+void Access_Credential_Assigned_Access_Rights_Clear(uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+bool Access_Credential_Authentication_Factor_Find(
+    const BACNET_AUTHENTICATION_FACTOR *factor,
+    uint32_t *object_instance,
+    BACNET_ACCESS_AUTHENTICATION_FACTOR_DISABLE *disable);
+BACNET_STACK_EXPORT
+bool Access_Credential_Access_Point_Authorized(
+    uint32_t object_instance, uint32_t access_point_instance);
+BACNET_STACK_EXPORT
+void Access_Credential_Index_Rebuild(void);
+
 BACNET_STACK_EXPORT
 int Access_Credential_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
 BACNET_STACK_EXPORT
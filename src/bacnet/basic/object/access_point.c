@@ -17,6 +17,7 @@
 #include "access_point.h"
 #include "bacnet/basic/services.h"
 /* BACnet Stack Objects */
+#include "bacnet/basic/object/access_credential.h"
 #include "bacnet/basic/object/device.h"
 
 static bool Access_Point_Initialized = false;
@@ -221,6 +222,73 @@ void Access_Point_Out_Of_Service_Set(uint32_t instance, bool oos_flag)
     }
 }
 
+/**
+ * @brief Decide access for an authentication factor presented at the
+ *  access point, and record the decision as the access event.
+ *  The credential is found from the hashed authentication factor index,
+ *  and the access rights from the precomputed authorization index,
+ *  so that the decision does not depend on the number of credentials.
+ * @param instance - object-instance number of the access point
+ * @param factor - the presented authentication factor
+ * @return ACCESS_EVENT_GRANTED, or the reason that access was denied
+ */
+BACNET_ACCESS_EVENT Access_Point_Authenticate(
+    uint32_t instance, const BACNET_AUTHENTICATION_FACTOR *factor)
+{
+    unsigned index = 0;
+    uint32_t credential_instance = 0;
+    BACNET_ACCESS_AUTHENTICATION_FACTOR_DISABLE factor_disable =
+        ACCESS_AUTHENTICATION_FACTOR_DISABLE_NONE;
+    BACNET_ACCESS_EVENT access_event = ACCESS_EVENT_GRANTED;
+    bool found = false;
+
+    index = Access_Point_Instance_To_Index(instance);
+    if (index >= MAX_ACCESS_POINTS) {
+        return ACCESS_EVENT_DENIED_OTHER;
+    }
+    found = Access_Credential_Authentication_Factor_Find(
+        factor, &credential_instance, &factor_disable);
+    if (!found) {
+        access_event = ACCESS_EVENT_DENIED_UNKNOWN_CREDENTIAL;
+    } else if (factor_disable != ACCESS_AUTHENTICATION_FACTOR_DISABLE_NONE) {
+        access_event = ACCESS_EVENT_DENIED_AUTHENTICATION_FACTOR_DISABLED;
+    } else {
+        switch (Access_Credential_Disable(credential_instance)) {
+            case ACCESS_CREDENTIAL_DISABLE_NONE:
+                if (!Access_Credential_Status(credential_instance)) {
+                    access_event = ACCESS_EVENT_DENIED_CREDENTIAL_DISABLED;
+                } else if (!Access_Credential_Access_Point_Authorized(
+                               credential_instance, instance)) {
+                    access_event = ACCESS_EVENT_DENIED_POINT_NO_ACCESS_RIGHTS;
+                }
+                break;
+            case ACCESS_CREDENTIAL_DISABLE_MANUAL:
+                access_event = ACCESS_EVENT_DENIED_CREDENTIAL_MANUAL_DISABLE;
+                break;
+            case ACCESS_CREDENTIAL_DISABLE_LOCKOUT:
+                access_event = ACCESS_EVENT_DENIED_CREDENTIAL_LOCKOUT;
+                break;
+            default:
+                access_event = ACCESS_EVENT_DENIED_CREDENTIAL_DISABLED;
+                break;
+        }
+    }
+    ap_descr[index].access_event = access_event;
+    ap_descr[index].access_event_tag++;
+    if (found) {
+        ap_descr[index].access_event_credential.deviceIdentifier.type =
+            OBJECT_DEVICE;
+        ap_descr[index].access_event_credential.deviceIdentifier.instance =
+            Device_Object_Instance_Number();
+        ap_descr[index].access_event_credential.objectIdentifier.type =
+            OBJECT_ACCESS_CREDENTIAL;
+        ap_descr[index].access_event_credential.objectIdentifier.instance =
+            credential_instance;
+    }
+
+    return access_event;
+}
+
 /* return apdu len, or BACNET_STATUS_ERROR on error */
 int Access_Point_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 {
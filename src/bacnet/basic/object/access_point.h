@@ -16,6 +16,7 @@
 #include "bacnet/bacerror.h"
 #include "bacnet/timestamp.h"
 #include "bacnet/bacdevobjpropref.h"
+#include "bacnet/authentication_factor.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 
@@ -77,6 +78,10 @@ bool Access_Point_Out_Of_Service(uint32_t instance);
 BACNET_STACK_EXPORT
 void Access_Point_Out_Of_Service_Set(uint32_t instance, bool oos_flag);
 
+BACNET_STACK_EXPORT
+BACNET_ACCESS_EVENT Access_Point_Authenticate(
+    uint32_t instance, const BACNET_AUTHENTICATION_FACTOR *factor);
+
 BACNET_STACK_EXPORT
 int Access_Point_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
 BACNET_STACK_EXPORT
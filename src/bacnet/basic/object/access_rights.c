@@ -187,6 +187,180 @@ bool Access_Rights_Object_Name(
     return status;
 }
 
+/**
+ * @brief For a given object instance-number, determines the enable value
+ * @param object_instance - object-instance number of the object
+ * @return true if the access rights are enabled
+ */
+bool Access_Rights_Enable(uint32_t object_instance)
+{
+    bool value = false;
+
+    if (object_instance < MAX_ACCESS_RIGHTS) {
+        value = ar_descr[object_instance].enable;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the enable value
+ * @param object_instance - object-instance number of the object
+ * @param enable - true if the access rights are enabled
+ * @return true if the value was set
+ * @note Call Access_Credential_Index_Rebuild() after changing the
+ *  access rights of credentials that are already assigned.
+ */
+bool Access_Rights_Enable_Set(uint32_t object_instance, bool enable)
+{
+    bool status = false;
+
+    if (object_instance < MAX_ACCESS_RIGHTS) {
+        ar_descr[object_instance].enable = enable;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Add a rule to the Positive_Access_Rules list
+ * @param object_instance - object-instance number of the object
+ * @param rule - access rule to add
+ * @return true if the rule was added
+ */
+bool Access_Rights_Positive_Access_Rule_Add(
+    uint32_t object_instance, const BACNET_ACCESS_RULE *rule)
+{
+    bool status = false;
+    uint32_t count;
+
+    if ((object_instance < MAX_ACCESS_RIGHTS) && rule) {
+        count = ar_descr[object_instance].positive_access_rules_count;
+        if (count < MAX_POSITIVE_ACCESS_RIGHTS_RULES) {
+            ar_descr[object_instance].positive_access_rules[count] = *rule;
+            ar_descr[object_instance].positive_access_rules_count++;
+            status = true;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Add a rule to the Negative_Access_Rules list
+ * @param object_instance - object-instance number of the object
+ * @param rule - access rule to add
+ * @return true if the rule was added
+ */
+bool Access_Rights_Negative_Access_Rule_Add(
+    uint32_t object_instance, const BACNET_ACCESS_RULE *rule)
+{
+    bool status = false;
+    uint32_t count;
+
+    if ((object_instance < MAX_ACCESS_RIGHTS) && rule) {
+        count = ar_descr[object_instance].negative_access_rules_count;
+        if (count < MAX_NEGATIVE_ACCESS_RIGHTS_RULES) {
+            ar_descr[object_instance].negative_access_rules[count] = *rule;
+            ar_descr[object_instance].negative_access_rules_count++;
+            status = true;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Remove all the positive and negative access rules
+ * @param object_instance - object-instance number of the object
+ */
+void Access_Rights_Access_Rules_Clear(uint32_t object_instance)
+{
+    if (object_instance < MAX_ACCESS_RIGHTS) {
+        ar_descr[object_instance].positive_access_rules_count = 0;
+        ar_descr[object_instance].negative_access_rules_count = 0;
+    }
+}
+
+/**
+ * @brief Determine if an access rule applies to an Access Point
+ *  object in this device
+ * @param rule - access rule
+ * @param access_point_instance - Access Point object-instance number
+ * @return true if the rule applies to the access point
+ * @note A rule with a specified time range depends on the value of
+ *  the referenced property at the time of access, and is not applied.
+ */
+static bool Access_Rule_Access_Point_Applies(
+    const BACNET_ACCESS_RULE *rule, uint32_t access_point_instance)
+{
+    if (!rule->enable) {
+        return false;
+    }
+    if (rule->time_range_specifier != TIME_RANGE_SPECIFIER_ALWAYS) {
+        return false;
+    }
+    if (rule->location_specifier == LOCATION_SPECIFIER_ALL) {
+        return true;
+    }
+    if ((rule->location.objectIdentifier.type != OBJECT_ACCESS_POINT) ||
+        (rule->location.objectIdentifier.instance != access_point_instance)) {
+        return false;
+    }
+    if ((rule->location.deviceIdentifier.type == OBJECT_DEVICE) &&
+        (rule->location.deviceIdentifier.instance !=
+         Device_Object_Instance_Number())) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Evaluate the access rules for an Access Point. Access is
+ *  granted when the access rights are enabled, a positive access rule
+ *  applies to the access point, and no negative access rule applies.
+ * @param object_instance - object-instance number of the object
+ * @param access_point_instance - Access Point object-instance number
+ * @return true if access is granted at the access point
+ */
+bool Access_Rights_Access_Point_Granted(
+    uint32_t object_instance, uint32_t access_point_instance)
+{
+    bool granted = false;
+    uint32_t i;
+
+    if (object_instance >= MAX_ACCESS_RIGHTS) {
+        return false;
+    }
+    if (!ar_descr[object_instance].enable) {
+        return false;
+    }
+    for (i = 0; i < ar_descr[object_instance].positive_access_rules_count;
+         i++) {
+        if (Access_Rule_Access_Point_Applies(
+                &ar_descr[object_instance].positive_access_rules[i],
+                access_point_instance)) {
+            granted = true;
+            break;
+        }
+    }
+    if (!granted) {
+        return false;
+    }
+    for (i = 0; i < ar_descr[object_instance].negative_access_rules_count;
+         i++) {
+        if (Access_Rule_Access_Point_Applies(
+                &ar_descr[object_instance].negative_access_rules[i],
+                access_point_instance)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -71,6 +71,22 @@ bool Access_Rights_Object_Name(
 BACNET_STACK_EXPORT
 bool Access_Rights_Name_Set(uint32_t object_instance, char *new_name);
 
+BACNET_STACK_EXPORT
+bool Access_Rights_Enable(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Access_Rights_Enable_Set(uint32_t object_instance, bool enable);
+BACNET_STACK_EXPORT
+bool Access_Rights_Positive_Access_Rule_Add(
+    uint32_t object_instance, const BACNET_ACCESS_RULE *rule);
+BACNET_STACK_EXPORT
+bool Access_Rights_Negative_Access_Rule_Add(
+    uint32_t object_instance, const BACNET_ACCESS_RULE *rule);
+BACNET_STACK_EXPORT
+void Access_Rights_Access_Rules_Clear(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Access_Rights_Access_Point_Granted(
+    uint32_t object_instance, uint32_t access_point_instance);
+
 BACNET_STACK_EXPORT
 int Access_Rights_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
 BACNET_STACK_EXPORT
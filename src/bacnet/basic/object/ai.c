@@ -9,11 +9,13 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <math.h>
 #include <stdlib.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bactext.h"
 #include "bacnet/datetime.h"
@@ -21,6 +23,7 @@
 #include "bacnet/timestamp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/slab.h"
 #include "bacnet/basic/sys/debug.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
@@ -34,6 +37,10 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* memory pool for the object data */
+static SLAB_TYPE Object_Slab = SLAB_ACCOUNT_INITIALIZER(
+    sizeof(struct analog_input_descr),
+    MEMSTAT_ACCOUNT_OBJECT(OBJECT_ANALOG_INPUT));
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_ANALOG_INPUT;
 
@@ -128,6 +135,38 @@ static struct analog_input_descr *Analog_Input_Object(uint32_t object_instance)
     return Keylist_Data(Object_List, object_instance);
 }
 
+/**
+ * @brief Report that the event state of an object needs to be evaluated
+ * @param  object_instance - object-instance number of the object
+ */
+static void Analog_Input_Intrinsic_Reporting_Changed(uint32_t object_instance)
+{
+#if defined(INTRINSIC_REPORTING)
+    Device_Intrinsic_Reporting_Changed(Object_Type, object_instance);
+#else
+    (void)object_instance;
+#endif
+}
+
+#if defined(INTRINSIC_REPORTING)
+/**
+ * @brief Report whether an object has an active event state, for the
+ *  GetEventInformation and GetAlarmSummary services
+ * @param  object_instance - object-instance number of the object
+ * @param  pObject - object data
+ */
+static void Analog_Input_Event_Active_Update(
+    uint32_t object_instance, const struct analog_input_descr *pObject)
+{
+    handler_get_event_information_active_set(
+        Object_Type, object_instance,
+        (pObject->Event_State != EVENT_STATE_NORMAL) ||
+            !pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ||
+            !pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ||
+            !pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked);
+}
+#endif
+
 #if defined(INTRINSIC_REPORTING)
 /**
  * @brief Gets an object from the list using its index in the list
@@ -211,6 +250,25 @@ float Analog_Input_Present_Value(uint32_t object_instance)
     return value;
 }
 
+/**
+ * @brief For a given object instance-number, reads the present-value
+ *  without encoding it, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  value - [out] the present-value
+ * @return  true if the object instance exists
+ */
+bool Analog_Input_Present_Value_Real(uint32_t object_instance, float *value)
+{
+    if (!Analog_Input_Valid_Instance(object_instance)) {
+        return false;
+    }
+    if (value) {
+        *value = Analog_Input_Present_Value(object_instance);
+    }
+
+    return true;
+}
+
 /**
  * This function is used to detect a value change,
  * using the new value compared against the prior
@@ -221,25 +279,13 @@ float Analog_Input_Present_Value(uint32_t object_instance)
  * @param index  Object index
  * @param value  Given present value.
  */
-static void
-Analog_Input_COV_Detect(struct analog_input_descr *pObject, float value)
+static void Analog_Input_COV_Detect(
+    uint32_t object_instance, struct analog_input_descr *pObject, float value)
 {
-    float prior_value = 0.0f;
-    float cov_increment = 0.0f;
-    float cov_delta = 0.0f;
-
-    if (pObject) {
-        prior_value = pObject->Prior_Value;
-        cov_increment = pObject->COV_Increment;
-        if (prior_value > value) {
-            cov_delta = prior_value - value;
-        } else {
-            cov_delta = value - prior_value;
-        }
-        if (cov_delta >= cov_increment) {
-            pObject->Changed = true;
-            pObject->Prior_Value = value;
-        }
+    if (pObject &&
+        cov_filter_real(&pObject->Prior_Value, value, pObject->COV_Increment)) {
+        pObject->Changed = true;
+        cov_change_of_value_notify(Object_Type, object_instance);
     }
 }
 
@@ -256,8 +302,9 @@ void Analog_Input_Present_Value_Set(uint32_t object_instance, float value)
 
     pObject = Analog_Input_Object(object_instance);
     if (pObject) {
-        Analog_Input_COV_Detect(pObject, value);
+        Analog_Input_COV_Detect(object_instance, pObject, value);
         pObject->Present_Value = value;
+        Analog_Input_Intrinsic_Reporting_Changed(object_instance);
     }
 }
 
@@ -442,6 +489,7 @@ bool Analog_Input_Event_Enable_Set(
               ~(EVENT_ENABLE_TO_OFFNORMAL | EVENT_ENABLE_TO_FAULT |
                 EVENT_ENABLE_TO_NORMAL))) {
             pObject->Event_Enable = event_enable;
+            Analog_Input_Intrinsic_Reporting_Changed(object_instance);
             status = true;
         }
     }
@@ -546,12 +594,14 @@ bool Analog_Input_Event_Detection_Enable_Set(
 
     if (pObject) {
         pObject->Event_Detection_Enable = value;
+        Analog_Input_Intrinsic_Reporting_Changed(object_instance);
         if (!pObject->Event_Detection_Enable) {
             /*When this property is FALSE, Event_State shall be NORMAL, and the
             properties Acked_Transitions, Event_Time_Stamps, and
             Event_Message_Texts shall be equal to their respective initial
             conditions.*/
             Analog_Input_Reset_Event_Properties(pObject);
+            Analog_Input_Event_Active_Update(object_instance, pObject);
         }
         retval = true;
     }
@@ -654,13 +704,78 @@ bool Analog_Input_Reliability_Set(
         pObject->Reliability = value;
         if (fault != Analog_Input_Object_Fault(pObject)) {
             pObject->Changed = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
+        Analog_Input_Intrinsic_Reporting_Changed(object_instance);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Updates the present-value and reliability of many objects in one
+ *  pass, such as a scan of the physical inputs.  COV is detected using
+ *  the COV_Increment and reliability fault status, and only the objects
+ *  whose value or reliability changed are marked for intrinsic reporting.
+ *  Updates sorted by object-instance are found without searching the list.
+ *  Objects that are Out_Of_Service are decoupled from the physical input
+ *  and are not updated.
+ * @param  updates - array of object-instance, present-value, reliability
+ * @param  count - number of elements in the updates array
+ * @return number of objects that were updated
+ */
+unsigned Analog_Input_Present_Value_Update(
+    const ANALOG_INPUT_UPDATE *updates, unsigned count)
+{
+    struct analog_input_descr *pObject;
+    const ANALOG_INPUT_UPDATE *update;
+    unsigned applied = 0;
+    unsigned i;
+    int index = -1;
+    bool fault;
+    bool changed;
+
+    if (!updates) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        update = &updates[i];
+        index = Keylist_Index_Hint(
+            Object_List, update->Object_Instance, index + 1);
+        pObject = Keylist_Data_Index(Object_List, index);
+        if (!pObject) {
+            continue;
+        }
+        if (pObject->Out_Of_Service) {
+            continue;
+        }
+        changed = false;
+        fault = Analog_Input_Object_Fault(pObject);
+        if (pObject->Reliability != update->Reliability) {
+            pObject->Reliability = update->Reliability;
+            changed = true;
+        }
+        if (islessgreater(pObject->Present_Value, update->Present_Value)) {
+            pObject->Present_Value = update->Present_Value;
+            changed = true;
+        }
+        if (cov_filter_real(
+                &pObject->Prior_Value, update->Present_Value,
+                pObject->COV_Increment) ||
+            (fault != Analog_Input_Object_Fault(pObject))) {
+            pObject->Changed = true;
+            cov_change_of_value_notify(Object_Type, update->Object_Instance);
+        }
+        if (changed) {
+            Analog_Input_Intrinsic_Reporting_Changed(update->Object_Instance);
+        }
+        applied++;
+    }
+
+    return applied;
+}
+
 /**
  * @brief For a given object instance-number, gets the Fault status flag
  * @param  object_instance - object-instance number of the object
@@ -744,6 +859,40 @@ bool Analog_Input_Encode_Value_List(
     return status;
 }
 
+/**
+ * @brief For a given object instance-number, reads the status-flags
+ *  without encoding them, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  status_flags - [out] the status-flags
+ * @return  true if the object instance exists
+ */
+bool Analog_Input_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags)
+{
+    bool status = false;
+    bool in_alarm = false;
+    bool out_of_service = false;
+    bool fault = false;
+    const bool overridden = false;
+    struct analog_input_descr *pObject;
+
+    pObject = Analog_Input_Object(object_instance);
+    if (pObject) {
+        if (pObject->Event_State != EVENT_STATE_NORMAL) {
+            in_alarm = true;
+        }
+        if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+            fault = true;
+        }
+        out_of_service = pObject->Out_Of_Service;
+        cov_status_flags_set(
+            status_flags, in_alarm, fault, overridden, out_of_service);
+        status = true;
+    }
+
+    return status;
+}
+
 /**
  * @brief For a given object instance-number, returns the COV-Increment value
  * @param  object_instance - object-instance number of the object
@@ -774,7 +923,8 @@ void Analog_Input_COV_Increment_Set(uint32_t object_instance, float value)
     pObject = Analog_Input_Object(object_instance);
     if (pObject) {
         pObject->COV_Increment = value;
-        Analog_Input_COV_Detect(pObject, pObject->Present_Value);
+        Analog_Input_COV_Detect(
+            object_instance, pObject, pObject->Present_Value);
     }
 }
 
@@ -855,6 +1005,7 @@ void Analog_Input_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Changed = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
         pObject->Out_Of_Service = value;
     }
@@ -1000,6 +1151,7 @@ int Analog_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     uint8_t *apdu = NULL;
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
+    BACNET_CHARACTER_STRING_VIEW char_view;
     float real_value = (float)1.414;
     bool state = false;
 #if defined(INTRINSIC_REPORTING)
@@ -1025,9 +1177,18 @@ int Analog_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 &apdu[0], Object_Type, rpdata->object_instance);
             break;
         case PROP_OBJECT_NAME:
-            Analog_Input_Object_Name(rpdata->object_instance, &char_string);
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            /* a name that is kept by the object is encoded in place */
+            if (characterstring_view_init_ansi(
+                    &char_view,
+                    Analog_Input_Name_ASCII(rpdata->object_instance)) &&
+                (char_view.length > 0)) {
+                apdu_len = encode_application_character_string_view(
+                    &apdu[0], &char_view);
+            } else {
+                Analog_Input_Object_Name(rpdata->object_instance, &char_string);
+                apdu_len =
+                    encode_application_character_string(&apdu[0], &char_string);
+            }
             break;
         case PROP_OBJECT_TYPE:
             apdu_len = encode_application_enumerated(&apdu[0], Object_Type);
@@ -1357,6 +1518,10 @@ bool Analog_Input_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             }
             break;
     }
+    if (status) {
+        /* limits and event properties are evaluated after a write */
+        Analog_Input_Intrinsic_Reporting_Changed(wp_data->object_instance);
+    }
 
     return status;
 }
@@ -1788,6 +1953,13 @@ void Analog_Input_Intrinsic_Reporting(uint32_t object_instance)
             }
         }
     }
+    Analog_Input_Event_Active_Update(object_instance, CurrentAI);
+    if (SendNotify ||
+        (CurrentAI->Remaining_Time_Delay != CurrentAI->Time_Delay)) {
+        /* evaluate the new event state, or the pending time delay,
+           on the next cycle */
+        Analog_Input_Intrinsic_Reporting_Changed(object_instance);
+    }
 #else
     (void)object_instance;
 #endif /* defined(INTRINSIC_REPORTING) */
@@ -1980,6 +2152,10 @@ int Analog_Input_Alarm_Ack(
     /* Need to send AckNotification. */
     CurrentAI->Ack_notify_data.bSendAckNotify = true;
     CurrentAI->Ack_notify_data.EventState = alarmack_data->eventStateAcked;
+    Analog_Input_Event_Active_Update(
+        alarmack_data->eventObjectIdentifier.instance, CurrentAI);
+    Analog_Input_Intrinsic_Reporting_Changed(
+        alarmack_data->eventObjectIdentifier.instance);
 
     return 1;
 }
@@ -2062,6 +2238,31 @@ void Analog_Input_Context_Set(uint32_t object_instance, void *context)
     }
 }
 
+/**
+ * @brief Set the default property values of a new Analog Input object
+ * @param pObject - object data, zeroed when allocated
+ */
+static void Analog_Input_Object_Defaults(struct analog_input_descr *pObject)
+{
+    pObject->Object_Name = NULL;
+    pObject->Description = NULL;
+    pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
+    pObject->COV_Increment = 1.0;
+    pObject->Present_Value = 0.0f;
+    pObject->Prior_Value = 0.0;
+    pObject->Units = UNITS_PERCENT;
+    pObject->Out_Of_Service = false;
+    pObject->Changed = false;
+    pObject->Event_State = EVENT_STATE_NORMAL;
+#if defined(INTRINSIC_REPORTING)
+    pObject->Event_Detection_Enable = true;
+    pObject->Time_Delay = 0;
+    /* notification class not connected */
+    pObject->Notification_Class = BACNET_MAX_INSTANCE;
+    Analog_Input_Reset_Event_Properties(pObject);
+#endif
+}
+
 /**
  * @brief Creates a Analog Input object
  * @param object_instance - object-instance number of the object
@@ -2087,29 +2288,13 @@ uint32_t Analog_Input_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct analog_input_descr));
+        pObject = Slab_Item_Alloc(&Object_Slab);
         if (pObject) {
-            pObject->Object_Name = NULL;
-            pObject->Description = NULL;
-            pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
-            pObject->COV_Increment = 1.0;
-            pObject->Present_Value = 0.0f;
-            pObject->Prior_Value = 0.0;
-            pObject->Units = UNITS_PERCENT;
-            pObject->Out_Of_Service = false;
-            pObject->Changed = false;
-            pObject->Event_State = EVENT_STATE_NORMAL;
-#if defined(INTRINSIC_REPORTING)
-            pObject->Event_Detection_Enable = true;
-            pObject->Time_Delay = 0;
-            /* notification class not connected */
-            pObject->Notification_Class = BACNET_MAX_INSTANCE;
-            Analog_Input_Reset_Event_Properties(pObject);
-#endif
+            Analog_Input_Object_Defaults(pObject);
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Slab_Free(&Object_Slab, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -2120,6 +2305,52 @@ uint32_t Analog_Input_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates the Analog Input objects of a range that do not exist
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of object instances in the range
+ * @return the number of objects that were created
+ */
+uint32_t Analog_Input_Create_Range(uint32_t object_instance, uint32_t count)
+{
+    struct analog_input_descr *pObject = NULL;
+    uint32_t instance = 0;
+    uint32_t created = 0;
+    uint32_t i = 0;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+    }
+    if ((count == 0) || (object_instance >= BACNET_MAX_INSTANCE) ||
+        (count > (BACNET_MAX_INSTANCE - object_instance))) {
+        return 0;
+    }
+    if (!Keylist_Reserve(Object_List, Keylist_Count(Object_List) + count)) {
+        return 0;
+    }
+    if (!Slab_Reserve(&Object_Slab, count)) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if (Keylist_Data(Object_List, instance)) {
+            continue;
+        }
+        pObject = Slab_Item_Alloc(&Object_Slab);
+        if (!pObject) {
+            break;
+        }
+        Analog_Input_Object_Defaults(pObject);
+        if (Keylist_Data_Add(Object_List, instance, pObject) < 0) {
+            Slab_Free(&Object_Slab, pObject);
+            break;
+        }
+        created++;
+    }
+
+    return created;
+}
+
 /**
  * @brief Deletes an Analog Input object
  * @param object_instance - object-instance number of the object
@@ -2132,13 +2363,29 @@ bool Analog_Input_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+#if defined(INTRINSIC_REPORTING)
+        handler_get_event_information_active_set(
+            Object_Type, object_instance, false);
+#endif
+        Slab_Free(&Object_Slab, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Reserves pool memory for Analog Input objects, see Slab_Reserve()
+ * @param count - number of objects to reserve memory for
+ * @return true if the memory was reserved
+ */
+bool Analog_Input_Pool_Reserve(uint32_t count)
+{
+    Slab_Retain_Set(&Object_Slab, true);
+
+    return Slab_Reserve(&Object_Slab, count);
+}
+
 /**
  * @brief Deletes all the Analog Inputs and their data
  */
@@ -2158,7 +2405,7 @@ void Analog_Input_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
-                    free(pObject);
+                    Slab_Free(&Object_Slab, pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
@@ -2166,6 +2413,7 @@ void Analog_Input_Cleanup(void)
         }
     }
 
+    Slab_Cleanup(&Object_Slab);
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
 #endif
@@ -2197,6 +2445,10 @@ void Analog_Input_Init(void)
     /* Set handler for GetEventInformation function */
     handler_get_event_information_set(
         Object_Type, Analog_Input_Event_Information);
+    handler_get_event_information_index_set(
+        Object_Type, Analog_Input_Instance_To_Index);
+    /* evaluate the event state only after a change */
+    Device_Intrinsic_Reporting_Change_Driven_Set(Object_Type, true);
     /* Set handler for AcknowledgeAlarm function */
     handler_alarm_ack_set(Object_Type, Analog_Input_Alarm_Ack);
     /* Set handler for GetAlarmSummary Service */
@@ -57,6 +57,13 @@ typedef struct analog_input_descr {
 #endif
 } ANALOG_INPUT_DESCR;
 
+/* present-value and reliability of one object, for a batch update */
+typedef struct analog_input_update {
+    uint32_t Object_Instance;
+    float Present_Value;
+    BACNET_RELIABILITY Reliability;
+} ANALOG_INPUT_UPDATE;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -113,7 +120,12 @@ bool Analog_Input_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
 BACNET_STACK_EXPORT
 float Analog_Input_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Analog_Input_Present_Value_Real(uint32_t object_instance, float *value);
+BACNET_STACK_EXPORT
 void Analog_Input_Present_Value_Set(uint32_t object_instance, float value);
+BACNET_STACK_EXPORT
+unsigned Analog_Input_Present_Value_Update(
+    const ANALOG_INPUT_UPDATE *updates, unsigned count);
 
 BACNET_STACK_EXPORT
 bool Analog_Input_Out_Of_Service(uint32_t object_instance);
@@ -136,6 +148,9 @@ void Analog_Input_Change_Of_Value_Clear(uint32_t instance);
 BACNET_STACK_EXPORT
 bool Analog_Input_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
+BACNET_STACK_EXPORT
+bool Analog_Input_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
 float Analog_Input_COV_Increment(uint32_t instance);
 BACNET_STACK_EXPORT
 void Analog_Input_COV_Increment_Set(uint32_t instance, float value);
@@ -226,8 +241,12 @@ void Analog_Input_Context_Set(uint32_t object_instance, void *context);
 BACNET_STACK_EXPORT
 uint32_t Analog_Input_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+uint32_t Analog_Input_Create_Range(uint32_t object_instance, uint32_t count);
+BACNET_STACK_EXPORT
 bool Analog_Input_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Analog_Input_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Analog_Input_Cleanup(void);
 BACNET_STACK_EXPORT
 void Analog_Input_Init(void);
@@ -28,6 +28,8 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/priority_array.h"
+#include "bacnet/basic/sys/slab.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
 /* me! */
@@ -39,7 +41,9 @@ struct object_data {
     bool Changed : 1;
     float COV_Increment;
     float Prior_Value;
-    bool Relinquished[BACNET_MAX_PRIORITY];
+    /* the effective value of the priority array, kept when it changes */
+    float Present_Value;
+    PRIORITY_ARRAY_STATE Priority_State;
     float Priority_Array[BACNET_MAX_PRIORITY];
     float Relinquish_Default;
     float Min_Pres_Value;
@@ -57,6 +61,9 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* memory pool for the object data */
+static SLAB_TYPE Object_Slab = SLAB_ACCOUNT_INITIALIZER(
+    sizeof(struct object_data), MEMSTAT_ACCOUNT_OBJECT(OBJECT_ANALOG_OUTPUT));
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_ANALOG_OUTPUT;
 /* callback for present value writes */
@@ -204,23 +211,35 @@ unsigned Analog_Output_Instance_To_Index(uint32_t object_instance)
 float Analog_Output_Present_Value(uint32_t object_instance)
 {
     float value = 0.0;
-    uint8_t priority = 0; /* loop counter */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        value = Analog_Output_Relinquish_Default(object_instance);
-        for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-            if (!pObject->Relinquished[priority]) {
-                value = pObject->Priority_Array[priority];
-                break;
-            }
-        }
+        value = pObject->Present_Value;
     }
 
     return value;
 }
 
+/**
+ * @brief For a given object instance-number, reads the present-value
+ *  without encoding it, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  value - [out] the present-value
+ * @return  true if the object instance exists
+ */
+bool Analog_Output_Present_Value_Real(uint32_t object_instance, float *value)
+{
+    if (!Analog_Output_Valid_Instance(object_instance)) {
+        return false;
+    }
+    if (value) {
+        *value = Analog_Output_Present_Value(object_instance);
+    }
+
+    return true;
+}
+
 /**
  * @brief For a given object instance-number, determines the priority
  * @param  object_instance - object-instance number of the object
@@ -228,23 +247,34 @@ float Analog_Output_Present_Value(uint32_t object_instance)
  */
 unsigned Analog_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (!pObject->Relinquished[p]) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = priority_array_active_priority(&pObject->Priority_State);
     }
 
     return priority;
 }
 
+/**
+ * @brief Keep the effective value of the priority array as the
+ *  present-value, after a slot or the relinquish-default changed
+ * @param  pObject - specific object with valid data
+ */
+static void Analog_Output_Present_Value_Update(struct object_data *pObject)
+{
+    unsigned priority;
+
+    priority = priority_array_active_priority(&pObject->Priority_State);
+    if (priority) {
+        pObject->Present_Value = pObject->Priority_Array[priority - 1];
+    } else {
+        pObject->Present_Value = pObject->Relinquish_Default;
+    }
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -264,7 +294,7 @@ static int Analog_Output_Priority_Array_Encode(
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && (index < BACNET_MAX_PRIORITY)) {
-        if (pObject->Relinquished[index]) {
+        if (!priority_array_active(&pObject->Priority_State, index + 1)) {
             apdu_len = encode_application_null(apdu);
         } else {
             real_value = pObject->Priority_Array[index];
@@ -275,6 +305,47 @@ static int Analog_Output_Priority_Array_Encode(
     return apdu_len;
 }
 
+/**
+ * @brief Encode the whole priority array, with each run of commanded
+ *  priorities encoded in one pass
+ * @param  object_instance - object-instance number of the object
+ * @param  apdu - buffer for the encoding, or NULL for the length
+ * @return number of bytes encoded, or BACNET_STATUS_ERROR
+ */
+static int Analog_Output_Priority_Array_Encode_All(
+    uint32_t object_instance, uint8_t *apdu)
+{
+    int apdu_len = 0, len;
+    struct object_data *pObject;
+    unsigned index = 0, first;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return BACNET_STATUS_ERROR;
+    }
+    while (index < BACNET_MAX_PRIORITY) {
+        if (!priority_array_active(&pObject->Priority_State, index + 1)) {
+            len = encode_application_null(apdu);
+            index++;
+        } else {
+            first = index;
+            do {
+                index++;
+            } while ((index < BACNET_MAX_PRIORITY) &&
+                     priority_array_active(
+                         &pObject->Priority_State, index + 1));
+            len = encode_application_real_array(
+                apdu, &pObject->Priority_Array[first], index - first);
+        }
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+
+    return apdu_len;
+}
+
 /**
  * For a given object instance-number, determines the relinquish-default value
  *
@@ -311,6 +382,7 @@ bool Analog_Output_Relinquish_Default_Set(uint32_t object_instance, float value)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Relinquish_Default = value;
+        Analog_Output_Present_Value_Update(pObject);
         status = true;
     }
 
@@ -323,25 +395,13 @@ bool Analog_Output_Relinquish_Default_Set(uint32_t object_instance, float value)
  * @param  pObject - specific object with valid data
  * @param  value - floating point analog value
  */
-static void
-Analog_Output_Present_Value_COV_Detect(struct object_data *pObject, float value)
+static void Analog_Output_Present_Value_COV_Detect(
+    uint32_t object_instance, struct object_data *pObject, float value)
 {
-    float prior_value = 0.0;
-    float cov_increment = 0.0;
-    float cov_delta = 0.0;
-
-    if (pObject) {
-        prior_value = pObject->Prior_Value;
-        cov_increment = pObject->COV_Increment;
-        if (prior_value > value) {
-            cov_delta = prior_value - value;
-        } else {
-            cov_delta = value - prior_value;
-        }
-        if (cov_delta >= cov_increment) {
-            pObject->Changed = true;
-            pObject->Prior_Value = value;
-        }
+    if (pObject &&
+        cov_filter_real(&pObject->Prior_Value, value, pObject->COV_Increment)) {
+        pObject->Changed = true;
+        cov_change_of_value_notify(Object_Type, object_instance);
     }
 }
 
@@ -364,10 +424,11 @@ bool Analog_Output_Present_Value_Set(
         if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY) &&
             (value >= pObject->Min_Pres_Value) &&
             (value <= pObject->Max_Pres_Value)) {
-            pObject->Relinquished[priority - 1] = false;
+            priority_array_command(&pObject->Priority_State, priority);
             pObject->Priority_Array[priority - 1] = value;
+            Analog_Output_Present_Value_Update(pObject);
             Analog_Output_Present_Value_COV_Detect(
-                pObject, Analog_Output_Present_Value(object_instance));
+                object_instance, pObject, pObject->Present_Value);
             status = true;
         }
     }
@@ -390,10 +451,11 @@ bool Analog_Output_Present_Value_Relinquish(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
-            pObject->Relinquished[priority - 1] = true;
+            priority_array_relinquish(&pObject->Priority_State, priority);
             pObject->Priority_Array[priority - 1] = 0.0;
+            Analog_Output_Present_Value_Update(pObject);
             Analog_Output_Present_Value_COV_Detect(
-                pObject, Analog_Output_Present_Value(object_instance));
+                object_instance, pObject, pObject->Present_Value);
             status = true;
         }
     }
@@ -414,8 +476,8 @@ bool Analog_Output_Priority_Array_Relinquished(
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
-        if (pObject->Relinquished[priority - 1]) {
+    if (pObject && (priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
+        if (!priority_array_active(&pObject->Priority_State, priority)) {
             status = true;
         }
     }
@@ -436,7 +498,7 @@ float Analog_Output_Priority_Array_Value(
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
+    if (pObject && (priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
         real_value = pObject->Priority_Array[priority - 1];
     }
 
@@ -710,6 +772,7 @@ void Analog_Output_Out_Of_Service_Set(uint32_t object_instance, bool value)
         if (pObject->Out_Of_Service != value) {
             pObject->Out_Of_Service = value;
             pObject->Changed = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
     }
 }
@@ -748,6 +811,7 @@ void Analog_Output_Overridden_Set(uint32_t object_instance, bool value)
         if (pObject->Overridden != value) {
             pObject->Overridden = value;
             pObject->Changed = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
     }
 }
@@ -808,6 +872,7 @@ bool Analog_Output_Reliability_Set(
             pObject->Reliability = value;
             if (fault != Analog_Output_Object_Fault(pObject)) {
                 pObject->Changed = true;
+                cov_change_of_value_notify(Object_Type, object_instance);
             }
             status = true;
         }
@@ -1006,6 +1071,35 @@ bool Analog_Output_Encode_Value_List(
     return status;
 }
 
+/**
+ * @brief For a given object instance-number, reads the status-flags
+ *  without encoding them, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  status_flags - [out] the status-flags
+ * @return  true if the object instance exists
+ */
+bool Analog_Output_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags)
+{
+    bool status = false;
+    struct object_data *pObject;
+    const bool in_alarm = false;
+    bool fault = false;
+    const bool overridden = false;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+            fault = true;
+        }
+        cov_status_flags_set(
+            status_flags, in_alarm, fault, overridden, pObject->Out_Of_Service);
+        status = true;
+    }
+
+    return status;
+}
+
 /**
  * @brief Get the COV change flag status
  * @param object_instance - object-instance number of the object
@@ -1054,6 +1148,7 @@ int Analog_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_size = 0;
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
+    BACNET_CHARACTER_STRING_VIEW char_view;
     uint8_t *apdu = NULL;
     uint32_t units = 0;
     float real_value = 0.0;
@@ -1079,9 +1174,19 @@ int Analog_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 &apdu[0], Object_Type, rpdata->object_instance);
             break;
         case PROP_OBJECT_NAME:
-            Analog_Output_Object_Name(rpdata->object_instance, &char_string);
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            /* a name that is kept by the object is encoded in place */
+            if (characterstring_view_init_ansi(
+                    &char_view,
+                    Analog_Output_Name_ASCII(rpdata->object_instance)) &&
+                (char_view.length > 0)) {
+                apdu_len = encode_application_character_string_view(
+                    &apdu[0], &char_view);
+            } else {
+                Analog_Output_Object_Name(
+                    rpdata->object_instance, &char_string);
+                apdu_len =
+                    encode_application_character_string(&apdu[0], &char_string);
+            }
             break;
         case PROP_OBJECT_TYPE:
             apdu_len = encode_application_enumerated(&apdu[0], Object_Type);
@@ -1126,10 +1231,21 @@ int Analog_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = encode_application_enumerated(&apdu[0], units);
             break;
         case PROP_PRIORITY_ARRAY:
-            apdu_len = bacnet_array_encode(
-                rpdata->object_instance, rpdata->array_index,
-                Analog_Output_Priority_Array_Encode, BACNET_MAX_PRIORITY, apdu,
-                apdu_size);
+            if (rpdata->array_index == BACNET_ARRAY_ALL) {
+                apdu_len = Analog_Output_Priority_Array_Encode_All(
+                    rpdata->object_instance, NULL);
+                if (apdu_len > apdu_size) {
+                    apdu_len = BACNET_STATUS_ABORT;
+                } else if (apdu_len > 0) {
+                    apdu_len = Analog_Output_Priority_Array_Encode_All(
+                        rpdata->object_instance, apdu);
+                }
+            } else {
+                apdu_len = bacnet_array_encode(
+                    rpdata->object_instance, rpdata->array_index,
+                    Analog_Output_Priority_Array_Encode, BACNET_MAX_PRIORITY,
+                    apdu, apdu_size);
+            }
             if (apdu_len == BACNET_STATUS_ABORT) {
                 rpdata->error_code =
                     ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
@@ -1324,6 +1440,32 @@ void Analog_Output_Context_Set(uint32_t object_instance, void *context)
     }
 }
 
+/**
+ * @brief Set the default property values of a new Analog Output object
+ * @param pObject - object data, zeroed when allocated
+ */
+static void Analog_Output_Object_Defaults(struct object_data *pObject)
+{
+    unsigned priority = 0;
+
+    pObject->Object_Name = NULL;
+    pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
+    pObject->Overridden = false;
+    priority_array_init(&pObject->Priority_State);
+    for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
+        pObject->Priority_Array[priority] = 0.0;
+    }
+    pObject->Relinquish_Default = 0.0;
+    pObject->Present_Value = 0.0;
+    pObject->COV_Increment = 1.0;
+    pObject->Prior_Value = 0.0;
+    pObject->Units = UNITS_NO_UNITS;
+    pObject->Out_Of_Service = false;
+    pObject->Changed = false;
+    pObject->Min_Pres_Value = 0;
+    pObject->Max_Pres_Value = 100;
+}
+
 /**
  * @brief Creates a Analog Output object
  * @param object_instance - object-instance number of the object
@@ -1333,7 +1475,6 @@ uint32_t Analog_Output_Create(uint32_t object_instance)
 {
     struct object_data *pObject = NULL;
     int index = 0;
-    unsigned priority = 0;
 
     if (!Object_List) {
         Object_List = Keylist_Create();
@@ -1350,27 +1491,13 @@ uint32_t Analog_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Slab_Item_Alloc(&Object_Slab);
         if (pObject) {
-            pObject->Object_Name = NULL;
-            pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
-            pObject->Overridden = false;
-            for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-                pObject->Relinquished[priority] = true;
-                pObject->Priority_Array[priority] = 0.0;
-            }
-            pObject->Relinquish_Default = 0.0;
-            pObject->COV_Increment = 1.0;
-            pObject->Prior_Value = 0.0;
-            pObject->Units = UNITS_NO_UNITS;
-            pObject->Out_Of_Service = false;
-            pObject->Changed = false;
-            pObject->Min_Pres_Value = 0;
-            pObject->Max_Pres_Value = 100;
+            Analog_Output_Object_Defaults(pObject);
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Slab_Free(&Object_Slab, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1381,6 +1508,52 @@ uint32_t Analog_Output_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates the Analog Output objects of a range that do not exist
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of object instances in the range
+ * @return the number of objects that were created
+ */
+uint32_t Analog_Output_Create_Range(uint32_t object_instance, uint32_t count)
+{
+    struct object_data *pObject = NULL;
+    uint32_t instance = 0;
+    uint32_t created = 0;
+    uint32_t i = 0;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+    }
+    if ((count == 0) || (object_instance >= BACNET_MAX_INSTANCE) ||
+        (count > (BACNET_MAX_INSTANCE - object_instance))) {
+        return 0;
+    }
+    if (!Keylist_Reserve(Object_List, Keylist_Count(Object_List) + count)) {
+        return 0;
+    }
+    if (!Slab_Reserve(&Object_Slab, count)) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if (Keylist_Data(Object_List, instance)) {
+            continue;
+        }
+        pObject = Slab_Item_Alloc(&Object_Slab);
+        if (!pObject) {
+            break;
+        }
+        Analog_Output_Object_Defaults(pObject);
+        if (Keylist_Data_Add(Object_List, instance, pObject) < 0) {
+            Slab_Free(&Object_Slab, pObject);
+            break;
+        }
+        created++;
+    }
+
+    return created;
+}
+
 /**
  * @brief Deletes an Analog Output object
  * @param object_instance - object-instance number of the object
@@ -1393,13 +1566,25 @@ bool Analog_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Slab_Free(&Object_Slab, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Reserves pool memory for Analog Output objects, see Slab_Reserve()
+ * @param count - number of objects to reserve memory for
+ * @return true if the memory was reserved
+ */
+bool Analog_Output_Pool_Reserve(uint32_t count)
+{
+    Slab_Retain_Set(&Object_Slab, true);
+
+    return Slab_Reserve(&Object_Slab, count);
+}
+
 /**
  * @brief Deletes all the Analog Outputs and their data
  */
@@ -1419,7 +1604,7 @@ void Analog_Output_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
-                    free(pObject);
+                    Slab_Free(&Object_Slab, pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
@@ -1427,6 +1612,7 @@ void Analog_Output_Cleanup(void)
         }
     }
 
+    Slab_Cleanup(&Object_Slab);
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
 #endif
@@ -53,6 +53,8 @@ bool Analog_Output_Object_Instance_Add(uint32_t instance);
 BACNET_STACK_EXPORT
 float Analog_Output_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Analog_Output_Present_Value_Real(uint32_t object_instance, float *value);
+BACNET_STACK_EXPORT
 bool Analog_Output_Present_Value_Set(
     uint32_t object_instance, float value, unsigned priority);
 BACNET_STACK_EXPORT
@@ -85,6 +87,9 @@ BACNET_STACK_EXPORT
 bool Analog_Output_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
 BACNET_STACK_EXPORT
+bool Analog_Output_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
+BACNET_STACK_EXPORT
 float Analog_Output_COV_Increment(uint32_t instance);
 BACNET_STACK_EXPORT
 void Analog_Output_COV_Increment_Set(uint32_t instance, float value);
@@ -145,8 +150,12 @@ void Analog_Output_Context_Set(uint32_t object_instance, void *context);
 BACNET_STACK_EXPORT
 uint32_t Analog_Output_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+uint32_t Analog_Output_Create_Range(uint32_t object_instance, uint32_t count);
+BACNET_STACK_EXPORT
 bool Analog_Output_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Analog_Output_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Analog_Output_Cleanup(void);
 BACNET_STACK_EXPORT
 void Analog_Output_Init(void);
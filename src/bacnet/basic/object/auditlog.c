@@ -88,21 +88,39 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/memstat.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
 /* me! */
 #include "auditlog.h"
 
-#ifndef BACNET_AUDIT_LOG_RECORDS_MAX
-#define BACNET_AUDIT_LOG_RECORDS_MAX 128
-#endif
+/* identifies a storage block header written by this module */
+#define AUDIT_LOG_STORAGE_MAGIC 0x42414C31UL
+/* offsets of the data in the storage block header */
+#define AUDIT_LOG_HEADER_MAGIC 0
+#define AUDIT_LOG_HEADER_RECORD_SIZE 4
+#define AUDIT_LOG_HEADER_BUFFER_SIZE 8
+#define AUDIT_LOG_HEADER_INDEX 12
+#define AUDIT_LOG_HEADER_RECORD_COUNT 16
+#define AUDIT_LOG_HEADER_TOTAL_RECORD_COUNT 20
+/* a record slot is the length of the encoded record, then the record */
+#define AUDIT_LOG_SLOT_LENGTH 0
+#define AUDIT_LOG_SLOT_RECORD 2
+#define AUDIT_LOG_SLOT_RECORD_MAX \
+    (BACNET_AUDIT_LOG_RECORD_SIZE - AUDIT_LOG_SLOT_RECORD)
 
 struct object_data {
     bool Enable;
     bool Out_Of_Service;
-    int Buffer_Size;
-    OS_Keylist Records;
-    int Record_Count_Total;
+    /* the records are kept encoded in a circular buffer of fixed size
+       slots in the storage block */
+    uint8_t *Storage;
+    size_t Storage_Size;
+    uint32_t Buffer_Size;
+    /* slot of the next record */
+    uint32_t Index;
+    uint32_t Record_Count;
+    uint32_t Record_Count_Total;
     const char *Object_Name;
     const char *Description;
     void *Context;
@@ -111,9 +129,26 @@ struct object_data {
 static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #ifdef BAC_ROUTING
 #define Object_List (Object_Lists[Routed_Device_Object_Index()])
+#define Log_Device_Index() (Routed_Device_Object_Index())
 #else
 #define Object_List (Object_Lists[0])
+#define Log_Device_Index() (0)
 #endif
+/* the record returned by Audit_Log_Record_Entry() */
+static BACNET_AUDIT_LOG_RECORD Record_Entry;
+
+static uint8_t *Audit_Log_Storage_Heap_Open(
+    unsigned device_index, uint32_t object_instance, size_t *size);
+static void Audit_Log_Storage_Heap_Close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge);
+static audit_log_storage_open_callback Storage_Open_Callback =
+    Audit_Log_Storage_Heap_Open;
+static audit_log_storage_close_callback Storage_Close_Callback =
+    Audit_Log_Storage_Heap_Close;
 
 static const int32_t Properties_Required[] = {
     /* required properties that are supported for this object */
@@ -267,9 +302,365 @@ unsigned Audit_Log_Instance_To_Index(uint32_t object_instance)
     return Keylist_Index(Object_List, object_instance);
 }
 
+/**
+ * @brief Get a storage block for the records of a log from the heap
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param size - [in,out] the size of the storage block
+ * @return the storage block, or NULL if there is not enough memory
+ */
+static uint8_t *Audit_Log_Storage_Heap_Open(
+    unsigned device_index, uint32_t object_instance, size_t *size)
+{
+    uint8_t *storage;
+
+    (void)device_index;
+    (void)object_instance;
+    storage = calloc(1, *size);
+    if (storage) {
+        MEMSTAT_ALLOC(MEMSTAT_LOG, *size);
+    }
+
+    return storage;
+}
+
+/**
+ * @brief Free a storage block from the heap
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param storage - the storage block
+ * @param size - the size of the storage block
+ * @param purge - true if the records are no longer wanted
+ */
+static void Audit_Log_Storage_Heap_Close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge)
+{
+    (void)device_index;
+    (void)object_instance;
+    (void)size;
+    (void)purge;
+    if (storage) {
+        MEMSTAT_FREE(MEMSTAT_LOG, size);
+    }
+    free(storage);
+}
+
+/**
+ * @brief Set the callbacks that keep the storage blocks of the logs,
+ *  for example in files that survive a restart of the device.
+ * @note Set them before the Audit Log objects are created, or call
+ *  Audit_Log_Cleanup() before changing them. NULL callbacks restore
+ *  the default storage from the heap.
+ * @param open_callback - callback to get the storage block of a log
+ * @param close_callback - callback to let go of a storage block
+ */
+void Audit_Log_Storage_Callback_Set(
+    audit_log_storage_open_callback open_callback,
+    audit_log_storage_close_callback close_callback)
+{
+    if (open_callback && close_callback) {
+        Storage_Open_Callback = open_callback;
+        Storage_Close_Callback = close_callback;
+    } else {
+        Storage_Open_Callback = Audit_Log_Storage_Heap_Open;
+        Storage_Close_Callback = Audit_Log_Storage_Heap_Close;
+    }
+}
+
+/**
+ * @brief Get a record slot in the storage block of a log
+ * @param pObject - object data
+ * @param slot - 0 based slot number, less than the buffer size
+ * @return the record slot
+ */
+static uint8_t *
+Audit_Log_Storage_Slot(const struct object_data *pObject, uint32_t slot)
+{
+    return &pObject->Storage
+                [BACNET_AUDIT_LOG_STORAGE_HEADER_SIZE +
+                 ((size_t)slot * BACNET_AUDIT_LOG_RECORD_SIZE)];
+}
+
+/**
+ * @brief Get the slot of a record of a log
+ * @param pObject - object data
+ * @param index - 0 based index of the record, oldest first,
+ *  less than the record count
+ * @return the record slot
+ */
+static uint8_t *
+Audit_Log_Record_Slot(const struct object_data *pObject, uint32_t index)
+{
+    uint32_t slot;
+
+    slot = pObject->Index + pObject->Buffer_Size - pObject->Record_Count;
+    slot = (slot + index) % pObject->Buffer_Size;
+
+    return Audit_Log_Storage_Slot(pObject, slot);
+}
+
+/**
+ * @brief Get the length of the encoded record in a slot
+ * @param slot - the record slot
+ * @return number of octets of the encoded record
+ */
+static uint16_t Audit_Log_Slot_Length(const uint8_t *slot)
+{
+    uint16_t len = 0;
+
+    decode_unsigned16(&slot[AUDIT_LOG_SLOT_LENGTH], &len);
+    if (len > AUDIT_LOG_SLOT_RECORD_MAX) {
+        len = 0;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Store the state of the circular buffer of a log in the header
+ *  of its storage block
+ * @param pObject - object data
+ */
+static void Audit_Log_Storage_Header_Update(const struct object_data *pObject)
+{
+    uint8_t *header = pObject->Storage;
+
+    if (header) {
+        encode_unsigned32(&header[AUDIT_LOG_HEADER_INDEX], pObject->Index);
+        encode_unsigned32(
+            &header[AUDIT_LOG_HEADER_RECORD_COUNT], pObject->Record_Count);
+        encode_unsigned32(
+            &header[AUDIT_LOG_HEADER_TOTAL_RECORD_COUNT],
+            pObject->Record_Count_Total);
+    }
+}
+
+/**
+ * @brief Get the storage block of a log, and resume the records that
+ *  are already in the block. An empty or foreign block is formatted.
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @param buffer_size - number of records for a new block
+ * @return true if the records of the block were resumed
+ */
+static bool Audit_Log_Storage_Open(
+    uint32_t object_instance, struct object_data *pObject, uint32_t buffer_size)
+{
+    size_t size = BACNET_AUDIT_LOG_STORAGE_SIZE(buffer_size);
+    uint8_t *header = NULL;
+    uint32_t magic = 0;
+    uint32_t record_size = 0;
+    uint32_t stored_size = 0;
+    uint32_t index = 0;
+    uint32_t count = 0;
+    bool status = false;
+
+    pObject->Buffer_Size = 0;
+    pObject->Index = 0;
+    pObject->Record_Count = 0;
+    header = Storage_Open_Callback(Log_Device_Index(), object_instance, &size);
+    if (header && (size < BACNET_AUDIT_LOG_STORAGE_SIZE(1))) {
+        /* too small to be a log: purge it, and ask for a new block */
+        Storage_Close_Callback(
+            Log_Device_Index(), object_instance, header, size, true);
+        size = BACNET_AUDIT_LOG_STORAGE_SIZE(buffer_size);
+        header =
+            Storage_Open_Callback(Log_Device_Index(), object_instance, &size);
+        if (header && (size < BACNET_AUDIT_LOG_STORAGE_SIZE(1))) {
+            Storage_Close_Callback(
+                Log_Device_Index(), object_instance, header, size, true);
+            header = NULL;
+        }
+    }
+    pObject->Storage = header;
+    pObject->Storage_Size = size;
+    if (!header) {
+        pObject->Storage_Size = 0;
+        return false;
+    }
+    decode_unsigned32(&header[AUDIT_LOG_HEADER_MAGIC], &magic);
+    decode_unsigned32(&header[AUDIT_LOG_HEADER_RECORD_SIZE], &record_size);
+    decode_unsigned32(&header[AUDIT_LOG_HEADER_BUFFER_SIZE], &stored_size);
+    decode_unsigned32(&header[AUDIT_LOG_HEADER_INDEX], &index);
+    decode_unsigned32(&header[AUDIT_LOG_HEADER_RECORD_COUNT], &count);
+    if ((magic == AUDIT_LOG_STORAGE_MAGIC) &&
+        (record_size == BACNET_AUDIT_LOG_RECORD_SIZE) && (stored_size > 0) &&
+        (stored_size <= BACNET_AUDIT_LOG_BUFFER_SIZE_MAX) &&
+        (BACNET_AUDIT_LOG_STORAGE_SIZE(stored_size) <= size) &&
+        (index < stored_size) && (count <= stored_size)) {
+        pObject->Buffer_Size = stored_size;
+        pObject->Index = index;
+        pObject->Record_Count = count;
+        decode_unsigned32(
+            &header[AUDIT_LOG_HEADER_TOTAL_RECORD_COUNT],
+            &pObject->Record_Count_Total);
+        status = true;
+    } else {
+        stored_size = (uint32_t)((size - BACNET_AUDIT_LOG_STORAGE_HEADER_SIZE) /
+                                 BACNET_AUDIT_LOG_RECORD_SIZE);
+        if (stored_size > buffer_size) {
+            stored_size = buffer_size;
+        }
+        pObject->Buffer_Size = stored_size;
+        pObject->Record_Count_Total = 0;
+        memset(header, 0, BACNET_AUDIT_LOG_STORAGE_HEADER_SIZE);
+        encode_unsigned32(
+            &header[AUDIT_LOG_HEADER_MAGIC], AUDIT_LOG_STORAGE_MAGIC);
+        encode_unsigned32(
+            &header[AUDIT_LOG_HEADER_RECORD_SIZE],
+            BACNET_AUDIT_LOG_RECORD_SIZE);
+        encode_unsigned32(&header[AUDIT_LOG_HEADER_BUFFER_SIZE], stored_size);
+        Audit_Log_Storage_Header_Update(pObject);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Let go of the storage block of a log
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @param purge - true if the records are no longer wanted
+ */
+static void Audit_Log_Storage_Close(
+    uint32_t object_instance, struct object_data *pObject, bool purge)
+{
+    if (pObject->Storage) {
+        Storage_Close_Callback(
+            Log_Device_Index(), object_instance, pObject->Storage,
+            pObject->Storage_Size, purge);
+    }
+    pObject->Storage = NULL;
+    pObject->Storage_Size = 0;
+    pObject->Buffer_Size = 0;
+    pObject->Index = 0;
+    pObject->Record_Count = 0;
+}
+
+/**
+ * @brief Encode a record for a record slot. The comments of a
+ *  notification are left out of a record that would not fit.
+ * @param apdu - buffer of AUDIT_LOG_SLOT_RECORD_MAX octets
+ * @param record - the record
+ * @return number of octets encoded, or 0 if the record does not fit
+ */
+static int
+Audit_Log_Record_Pack(uint8_t *apdu, const BACNET_AUDIT_LOG_RECORD *record)
+{
+    int len;
+
+    len = bacnet_audit_log_record_encode(NULL, record);
+    if ((len > AUDIT_LOG_SLOT_RECORD_MAX) &&
+        (record->tag == AUDIT_LOG_DATUM_TAG_NOTIFICATION)) {
+        if (record != &Record_Entry) {
+            memcpy(&Record_Entry, record, sizeof(Record_Entry));
+            record = &Record_Entry;
+        }
+        characterstring_init_ansi(
+            &Record_Entry.log_datum.notification.source_comment, "");
+        characterstring_init_ansi(
+            &Record_Entry.log_datum.notification.target_comment, "");
+        len = bacnet_audit_log_record_encode(NULL, record);
+    }
+    if ((len <= 0) || (len > AUDIT_LOG_SLOT_RECORD_MAX)) {
+        return 0;
+    }
+
+    return bacnet_audit_log_record_encode(apdu, record);
+}
+
+/**
+ * @brief Add an encoded record at the insertion point of a log,
+ *  overwriting the oldest record of a full log
+ * @param pObject - object data
+ * @param apdu - the encoded record
+ * @param apdu_len - number of octets of the record
+ * @return true if the record was added
+ */
+static bool Audit_Log_Record_Append(
+    struct object_data *pObject, const uint8_t *apdu, int apdu_len)
+{
+    uint8_t *slot;
+
+    if ((pObject->Buffer_Size == 0) || (apdu_len <= 0) ||
+        (apdu_len > AUDIT_LOG_SLOT_RECORD_MAX)) {
+        return false;
+    }
+    slot = Audit_Log_Storage_Slot(pObject, pObject->Index);
+    encode_unsigned16(&slot[AUDIT_LOG_SLOT_LENGTH], (uint16_t)apdu_len);
+    memcpy(&slot[AUDIT_LOG_SLOT_RECORD], apdu, apdu_len);
+    pObject->Index++;
+    if (pObject->Index >= pObject->Buffer_Size) {
+        pObject->Index = 0;
+    }
+    if (pObject->Record_Count < pObject->Buffer_Size) {
+        pObject->Record_Count++;
+    }
+    pObject->Record_Count_Total++;
+    Audit_Log_Storage_Header_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Encode a record of a log, copying it from its slot
+ * @param pObject - object data
+ * @param index - 0 based index of the record, oldest first
+ * @param apdu - buffer for the record, or NULL for the length
+ * @return number of octets of the record, or 0 if there is no record
+ */
+static int Audit_Log_Record_Copy(
+    const struct object_data *pObject, uint32_t index, uint8_t *apdu)
+{
+    const uint8_t *slot;
+    uint16_t len;
+
+    if (index >= pObject->Record_Count) {
+        return 0;
+    }
+    slot = Audit_Log_Record_Slot(pObject, index);
+    len = Audit_Log_Slot_Length(slot);
+    if (apdu) {
+        memcpy(apdu, &slot[AUDIT_LOG_SLOT_RECORD], len);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Get the timestamp of a record of a log
+ * @param pObject - object data
+ * @param index - 0 based index of the record, oldest first
+ * @param timestamp - [out] the timestamp of the record
+ * @return true if the record has a timestamp
+ */
+static bool Audit_Log_Record_Timestamp(
+    const struct object_data *pObject,
+    uint32_t index,
+    BACNET_DATE_TIME *timestamp)
+{
+    const uint8_t *slot;
+
+    if (index >= pObject->Record_Count) {
+        return false;
+    }
+    slot = Audit_Log_Record_Slot(pObject, index);
+
+    return bacnet_datetime_context_decode(
+               &slot[AUDIT_LOG_SLOT_RECORD], Audit_Log_Slot_Length(slot), 0,
+               timestamp) > 0;
+}
+
 /**
  * For a given object instance-number, returns the Audit Log entity by index.
  *
+ * @note The entity is decoded from the log buffer into a single copy
+ *  that is kept until the next call.
+ *
  * @param  object_instance - object-instance number of the object
  * @param  index - index of entity
  *
@@ -280,10 +671,19 @@ Audit_Log_Record_Entry(uint32_t object_instance, uint32_t index)
 {
     BACNET_AUDIT_LOG_RECORD *entry = NULL;
     struct object_data *pObject;
+    const uint8_t *slot;
+    int len;
 
     pObject = Object_Data(object_instance);
-    if (pObject) {
-        entry = Keylist_Data_Index(pObject->Records, index);
+    if (pObject && (index < pObject->Record_Count)) {
+        slot = Audit_Log_Record_Slot(pObject, index);
+        memset(&Record_Entry, 0, sizeof(Record_Entry));
+        len = bacnet_audit_log_record_decode(
+            &slot[AUDIT_LOG_SLOT_RECORD], Audit_Log_Slot_Length(slot),
+            &Record_Entry);
+        if (len > 0) {
+            entry = &Record_Entry;
+        }
     }
 
     return entry;
@@ -296,13 +696,24 @@ Audit_Log_Record_Entry(uint32_t object_instance, uint32_t index)
  */
 void Audit_Log_Record_Entry_Delete(uint32_t object_instance, uint32_t index)
 {
-    BACNET_AUDIT_LOG_RECORD *entry = NULL;
     struct object_data *pObject;
+    uint32_t i;
 
     pObject = Object_Data(object_instance);
-    if (pObject) {
-        entry = Keylist_Data_Delete(pObject->Records, index);
-        free(entry);
+    if (pObject && (index < pObject->Record_Count)) {
+        /* the newer records move down a slot */
+        for (i = index + 1; i < pObject->Record_Count; i++) {
+            memcpy(
+                Audit_Log_Record_Slot(pObject, i - 1),
+                Audit_Log_Record_Slot(pObject, i),
+                BACNET_AUDIT_LOG_RECORD_SIZE);
+        }
+        if (pObject->Index == 0) {
+            pObject->Index = pObject->Buffer_Size;
+        }
+        pObject->Index--;
+        pObject->Record_Count--;
+        Audit_Log_Storage_Header_Update(pObject);
     }
 }
 
@@ -320,34 +731,17 @@ void Audit_Log_Record_Entry_Delete(uint32_t object_instance, uint32_t index)
 bool Audit_Log_Record_Entry_Add(
     uint32_t object_instance, const BACNET_AUDIT_LOG_RECORD *value)
 {
-    BACNET_AUDIT_LOG_RECORD *entry = NULL;
+    uint8_t apdu[AUDIT_LOG_SLOT_RECORD_MAX];
     struct object_data *pObject;
-    int index;
+    int len;
 
     pObject = Object_Data(object_instance);
-    if (!pObject) {
+    if (!pObject || !value) {
         return false;
     }
-    if (Keylist_Count(pObject->Records) >= pObject->Buffer_Size) {
-        /* log is full, so delete oldest record before adding a new record */
-        entry = Keylist_Data_Delete_By_Index(pObject->Records, 0);
-    }
-    if (!entry) {
-        entry = calloc(1, sizeof(BACNET_AUDIT_LOG_RECORD));
-        if (!entry) {
-            return false;
-        }
-    }
-    memcpy(entry, value, sizeof(BACNET_AUDIT_LOG_RECORD));
-    index =
-        Keylist_Data_Add(pObject->Records, pObject->Record_Count_Total, entry);
-    if (index < 0) {
-        free(entry);
-        return false;
-    }
-    pObject->Record_Count_Total++;
+    len = Audit_Log_Record_Pack(apdu, value);
 
-    return true;
+    return Audit_Log_Record_Append(pObject, apdu, len);
 }
 
 /**
@@ -370,35 +764,80 @@ uint32_t Audit_Log_Buffer_Size(uint32_t object_instance)
 }
 
 /**
- * @brief Set the log record maximum length for this object instance
+ * @brief Set the log record maximum length for this object instance.
+ *  The newest records that fit are kept, and the log keeps its buffer
+ *  size if the new storage can not be had.
  * @param  object_instance - object-instance number of the object
- * @param  buffer_size - maximum number of log records
+ * @param  buffer_size - maximum number of log records, from 1 to
+ *  BACNET_AUDIT_LOG_BUFFER_SIZE_MAX
  * @return true if the maximum number of log records is set
  */
 bool Audit_Log_Buffer_Size_Set(uint32_t object_instance, uint32_t buffer_size)
 {
     struct object_data *pObject;
-    BACNET_AUDIT_LOG_RECORD *entry = NULL;
-    int i;
+    uint8_t *records = NULL;
+    uint32_t old_size, total_records, count, i;
+    bool status = false;
 
     pObject = Object_Data(object_instance);
     if (!pObject) {
         return false;
     }
-    if (buffer_size > INT_MAX) {
+    if ((buffer_size == 0) ||
+        (buffer_size > BACNET_AUDIT_LOG_BUFFER_SIZE_MAX)) {
         return false;
     }
-    if (buffer_size < pObject->Buffer_Size) {
-        /* The disposition of existing log records when Buffer_Size is written
-            is a local matter. We can shrink the log buffer. */
-        for (i = buffer_size; i < pObject->Buffer_Size; i++) {
-            entry = Keylist_Data_Delete_By_Index(pObject->Records, i);
-            free(entry);
+    if (buffer_size == pObject->Buffer_Size) {
+        return true;
+    }
+    /* The disposition of existing log records when Buffer_Size is written
+        is a local matter. We keep the newest records that fit. */
+    count = pObject->Record_Count;
+    if (count > buffer_size) {
+        count = buffer_size;
+    }
+    if (count > 0) {
+        records = malloc((size_t)count * BACNET_AUDIT_LOG_RECORD_SIZE);
+        if (!records) {
+            return false;
+        }
+        for (i = 0; i < count; i++) {
+            memcpy(
+                &records[(size_t)i * BACNET_AUDIT_LOG_RECORD_SIZE],
+                Audit_Log_Record_Slot(
+                    pObject, pObject->Record_Count - count + i),
+                BACNET_AUDIT_LOG_RECORD_SIZE);
         }
     }
-    pObject->Buffer_Size = buffer_size;
+    old_size = pObject->Buffer_Size;
+    total_records = pObject->Record_Count_Total;
+    Audit_Log_Storage_Close(object_instance, pObject, true);
+    Audit_Log_Storage_Open(object_instance, pObject, buffer_size);
+    if (pObject->Buffer_Size == buffer_size) {
+        status = true;
+    } else if (old_size > 0) {
+        Audit_Log_Storage_Close(object_instance, pObject, true);
+        Audit_Log_Storage_Open(object_instance, pObject, old_size);
+    }
+    if (count > pObject->Buffer_Size) {
+        count = pObject->Buffer_Size;
+    }
+    for (i = 0; i < count; i++) {
+        memcpy(
+            Audit_Log_Storage_Slot(pObject, i),
+            &records[(size_t)i * BACNET_AUDIT_LOG_RECORD_SIZE],
+            BACNET_AUDIT_LOG_RECORD_SIZE);
+    }
+    free(records);
+    if (pObject->Buffer_Size > 0) {
+        pObject->Index = count % pObject->Buffer_Size;
+        pObject->Record_Count = count;
+    }
+    /* the total record count carries on */
+    pObject->Record_Count_Total = total_records;
+    Audit_Log_Storage_Header_Update(pObject);
 
-    return true;
+    return status;
 }
 
 /**
@@ -609,7 +1048,7 @@ uint32_t Audit_Log_Record_Count(uint32_t object_instance)
 
     pObject = Object_Data(object_instance);
     if (pObject) {
-        record_count = Keylist_Count(pObject->Records);
+        record_count = pObject->Record_Count;
     }
 
     return record_count;
@@ -656,12 +1095,17 @@ bool Audit_Log_Buffer_Size_Write(
         if (pObject->Enable) {
             *error_class = ERROR_CLASS_PROPERTY;
             *error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
-        } else if (buffer_size > INT_MAX) {
-            /* keylist library uses 'int' so that is our limit */
+        } else if (
+            (buffer_size == 0) ||
+            (buffer_size > BACNET_AUDIT_LOG_BUFFER_SIZE_MAX)) {
             *error_class = ERROR_CLASS_PROPERTY;
             *error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
         } else {
             status = Audit_Log_Buffer_Size_Set(object_instance, buffer_size);
+            if (!status) {
+                *error_class = ERROR_CLASS_RESOURCES;
+                *error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            }
         }
     }
 
@@ -878,43 +1322,34 @@ void Audit_Log_Record_Status_Insert(
 }
 
 /**
- * @brief Determines if a given log notification is the same as another
- * @param object_instance - object-instance number of the object
- * @param record - log record
+ * @brief Determines if a given log record is the same as a record in
+ *  the log, other than its timestamp
+ * @param pObject - object data
+ * @param apdu - the encoded log record
+ * @param apdu_len - number of octets of the encoded log record
  * @return the index of the found log record, or -1 if not found
  */
 static int Audit_Log_Record_Search(
-    uint32_t object_instance, BACNET_AUDIT_LOG_RECORD *record)
+    const struct object_data *pObject, const uint8_t *apdu, int apdu_len)
 {
-    int i;
-    BACNET_AUDIT_LOG_RECORD *entry;
-    struct object_data *pObject;
+    BACNET_DATE_TIME timestamp;
+    const uint8_t *slot;
+    uint32_t i;
+    int offset;
 
-    if (!record) {
-        return -1;
-    }
-    pObject = Object_Data(object_instance);
-    if (!pObject) {
+    offset = bacnet_datetime_context_decode(apdu, apdu_len, 0, &timestamp);
+    if (offset <= 0) {
         return -1;
     }
-    for (i = 0; i < pObject->Buffer_Size; i++) {
-        entry = Audit_Log_Record_Entry(object_instance, i);
-        if (!entry) {
-            break;
-        }
-        if (entry->tag == record->tag) {
-            if (entry->tag == AUDIT_LOG_DATUM_TAG_STATUS) {
-                if (entry->log_datum.log_status ==
-                    record->log_datum.log_status) {
-                    return i;
-                }
-            } else if (entry->tag == AUDIT_LOG_DATUM_TAG_NOTIFICATION) {
-                if (bacnet_audit_log_notification_same(
-                        &entry->log_datum.notification,
-                        &record->log_datum.notification)) {
-                    return i;
-                }
-            }
+    /* the timestamps all encode to the same length, so the same datum
+       is the same octets after it */
+    for (i = 0; i < pObject->Record_Count; i++) {
+        slot = Audit_Log_Record_Slot(pObject, i);
+        if ((Audit_Log_Slot_Length(slot) == apdu_len) &&
+            (memcmp(
+                 &slot[AUDIT_LOG_SLOT_RECORD + offset], &apdu[offset],
+                 apdu_len - offset) == 0)) {
+            return (int)i;
         }
     }
 
@@ -931,8 +1366,9 @@ void Audit_Log_Record_Notification_Insert(
     uint32_t object_instance, BACNET_AUDIT_NOTIFICATION *notification)
 {
     BACNET_AUDIT_LOG_RECORD seek_entry = { 0 };
+    uint8_t apdu[AUDIT_LOG_SLOT_RECORD_MAX];
     struct object_data *pObject;
-    int index;
+    int index, len;
 
     pObject = Object_Data(object_instance);
     if (!pObject) {
@@ -949,14 +1385,18 @@ void Audit_Log_Record_Notification_Insert(
     memcpy(
         &seek_entry.log_datum.notification, notification,
         sizeof(BACNET_AUDIT_NOTIFICATION));
-    index = Audit_Log_Record_Search(object_instance, &seek_entry);
+    len = Audit_Log_Record_Pack(apdu, &seek_entry);
+    if (len <= 0) {
+        return;
+    }
+    index = Audit_Log_Record_Search(pObject, apdu, len);
     if (index >= 0) {
         /*  If a match is found, the existing record is updated with the new
             time stamp and the record is moved to the end of the list.
             i.e. delete the old entry and add the new entry */
         Audit_Log_Record_Entry_Delete(object_instance, index);
     }
-    Audit_Log_Record_Entry_Add(object_instance, &seek_entry);
+    Audit_Log_Record_Append(pObject, apdu, len);
 }
 
 /**
@@ -1000,20 +1440,23 @@ int Audit_Log_Read_Range(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
  */
 int Audit_Log_Read_Range_By_Position(BACNET_READ_RANGE_DATA *pRequest)
 {
-    int log_index = 0;
+    struct object_data *pObject;
     int apdu_len = 0;
     size_t apdu_size;
     int len;
     uint8_t *apdu;
     uint32_t record_count = 0;
-    BACNET_AUDIT_LOG_RECORD *entry = NULL;
     int32_t iTemp = 0;
     uint32_t uiIndex = 0; /* Current entry number */
     uint32_t uiFirst = 0; /* Entry number we started encoding from */
     uint32_t uiLast = 0; /* Entry number we finished encoding on */
     uint32_t uiTarget = 0; /* Last entry we are required to encode */
 
-    record_count = Audit_Log_Record_Count(pRequest->object_instance);
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject) {
+        return 0;
+    }
+    record_count = pObject->Record_Count;
     /* See how much space we have */
     apdu_size = pRequest->application_data_len - pRequest->Overhead;
     if (pRequest->RequestType == RR_READ_ALL) {
@@ -1071,9 +1514,7 @@ int Audit_Log_Read_Range_By_Position(BACNET_READ_RANGE_DATA *pRequest)
     uiFirst = uiIndex;
     apdu = pRequest->application_data;
     while (uiIndex <= uiTarget) {
-        log_index = uiIndex - 1;
-        entry = Audit_Log_Record_Entry(pRequest->object_instance, log_index);
-        len = bacnet_audit_log_record_encode(NULL, entry);
+        len = Audit_Log_Record_Copy(pObject, uiIndex - 1, NULL);
         if (len > (apdu_size - apdu_len)) {
             /*
              * Can't fit any more in! We just set the result flag to say there
@@ -1083,7 +1524,7 @@ int Audit_Log_Read_Range_By_Position(BACNET_READ_RANGE_DATA *pRequest)
                 &pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, true);
             break;
         }
-        len = bacnet_audit_log_record_encode(apdu, entry);
+        len = Audit_Log_Record_Copy(pObject, uiIndex - 1, apdu);
         apdu += len;
         apdu_len += len;
         /* Record the last entry encoded */
@@ -1106,130 +1547,67 @@ int Audit_Log_Read_Range_By_Position(BACNET_READ_RANGE_DATA *pRequest)
 
 /**
  * Handle encoding for the By Sequence option.
- * The fact that the buffer always has at least a single entry is used
- * implicetly in the following as we don't have to handle the case of an
- * empty buffer.
+ * Each record has the sequence number of the Total_Record_Count when
+ * it was added, so the oldest record has the Total_Record_Count less the
+ * Record_Count plus one, and a sequence number is found in the log by
+ * its distance from the oldest record. The distances also cover a
+ * sequence number range that wraps around the maximum for uint32_t.
  *
- * @param apdu - buffer to hold the bytes
  * @param pRequest - the read range request
  *
  * @return  number of bytes encoded, or 0 if unable to encode.
  */
 int Audit_Log_Read_Range_By_Sequence(BACNET_READ_RANGE_DATA *pRequest)
 {
+    struct object_data *pObject;
     int apdu_len = 0;
     size_t apdu_size;
     int len;
     uint8_t *apdu;
-    int record_index = 0;
     uint32_t record_count;
-    uint32_t total_record_count;
-    BACNET_AUDIT_LOG_RECORD *entry = NULL;
-    uint32_t uiIndex = 0; /* Current entry number */
-    uint32_t uiFirst = 0; /* Entry number we started encoding from */
-    uint32_t uiLast = 0; /* Entry number we finished encoding on */
-    uint32_t uiSequence = 0; /* Tracking sequence number when encoding */
     uint32_t uiFirstSeq = 0; /* Sequence number for 1st record in log */
     uint32_t uiBegin = 0; /* Starting Sequence number for request */
-    uint32_t uiEnd = 0; /* Ending Sequence number for request */
-    bool bWrapReq =
-        false; /* Has request sequence range spanned the max for uint32_t? */
-    bool bWrapLog =
-        false; /* Has log sequence range spanned the max for uint32_t? */
+    uint32_t uiIndex = 0; /* Current record index */
+    uint32_t uiLast = 0; /* Record index we finished encoding on */
+    int64_t iFirst = 0; /* first record index of the request */
+    int64_t iLast = 0; /* last record index of the request */
 
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject || (pObject->Record_Count == 0) || (pRequest->Count == 0)) {
+        return 0;
+    }
     /* See how much space we have */
     apdu = pRequest->application_data;
     apdu_size = pRequest->application_data_len - pRequest->Overhead;
-    record_count = Audit_Log_Record_Count(pRequest->object_instance);
-    total_record_count =
-        Audit_Log_Total_Record_Count(pRequest->object_instance);
-    /* Figure out the sequence number for the first record, last is
-     * ulTotalRecordCount */
-    uiFirstSeq = total_record_count - record_count - 1;
-    /* Calculate start and end sequence numbers from request */
+    record_count = pObject->Record_Count;
+    uiFirstSeq = pObject->Record_Count_Total - (record_count - 1);
+    /* Calculate the start sequence number from request */
     if (pRequest->Count < 0) {
         uiBegin = pRequest->Range.RefSeqNum + pRequest->Count + 1;
-        uiEnd = pRequest->Range.RefSeqNum;
     } else {
         uiBegin = pRequest->Range.RefSeqNum;
-        uiEnd = pRequest->Range.RefSeqNum + pRequest->Count - 1;
     }
-    /* See if we have any wrap around situations */
-    if (uiBegin > uiEnd) {
-        bWrapReq = true;
+    /* the records of the request, as their distance from the oldest */
+    iFirst = (int32_t)(uiBegin - uiFirstSeq);
+    if (pRequest->Count < 0) {
+        iLast = iFirst - (int64_t)pRequest->Count - 1;
+    } else {
+        iLast = iFirst + (int64_t)pRequest->Count - 1;
     }
-    if (uiFirstSeq > total_record_count) {
-        bWrapLog = true;
+    /* If no overlap between request range and buffer contents bail out */
+    if ((iLast < 0) || (iFirst >= (int64_t)record_count)) {
+        return 0;
     }
-
-    if ((bWrapReq == false) && (bWrapLog == false)) {
-        /* Simple case no wraps */
-        /* If no overlap between request range and buffer contents bail out */
-        if ((uiEnd < uiFirstSeq) || (uiBegin > total_record_count)) {
-            return (0);
-        }
-        /* Truncate range if necessary so it is guaranteed to lie
-         * between the first and last sequence numbers in the buffer
-         * inclusive.
-         */
-        if (uiBegin < uiFirstSeq) {
-            uiBegin = uiFirstSeq;
-        }
-
-        if (uiEnd > total_record_count) {
-            uiEnd = total_record_count;
-        }
-    } else {
-        /* There are wrap arounds to contend with */
-        /* First check for non overlap condition as it is common to all */
-        if ((uiBegin > total_record_count) && (uiEnd < uiFirstSeq)) {
-            return (0);
-        }
-
-        if (bWrapLog == false) {
-            /* Only request range wraps */
-            if (uiEnd < uiFirstSeq) {
-                uiEnd = total_record_count;
-                if (uiBegin < uiFirstSeq) {
-                    uiBegin = uiFirstSeq;
-                }
-            } else {
-                uiBegin = uiFirstSeq;
-                if (uiEnd > total_record_count) {
-                    uiEnd = total_record_count;
-                }
-            }
-        } else if (bWrapReq == false) {
-            /* Only log wraps */
-            if (uiBegin > total_record_count) {
-                if (uiBegin > uiFirstSeq) {
-                    uiBegin = uiFirstSeq;
-                }
-            } else {
-                if (uiEnd > total_record_count) {
-                    uiEnd = total_record_count;
-                }
-            }
-        } else { /* Both wrap */
-            if (uiBegin < uiFirstSeq) {
-                uiBegin = uiFirstSeq;
-            }
-
-            if (uiEnd > total_record_count) {
-                uiEnd = total_record_count;
-            }
-        }
+    /* Truncate range if necessary so it lies within the log buffer */
+    if (iFirst < 0) {
+        iFirst = 0;
     }
-    /* We now have a range that lies completely within the log buffer
-     * and we need to figure out where that starts in the buffer.
-     */
-    uiIndex = uiBegin - uiFirstSeq + 1;
-    uiSequence = uiBegin;
-    uiFirst = uiIndex; /* Record where we started from */
-    while (uiSequence != uiEnd + 1) {
-        record_index = uiIndex - 1;
-        entry = Audit_Log_Record_Entry(pRequest->object_instance, record_index);
-        len = bacnet_audit_log_record_encode(NULL, entry);
+    if (iLast >= (int64_t)record_count) {
+        iLast = record_count - 1;
+    }
+    uiIndex = (uint32_t)iFirst;
+    while (uiIndex <= (uint32_t)iLast) {
+        len = Audit_Log_Record_Copy(pObject, uiIndex, NULL);
         if (len > (apdu_size - apdu_len)) {
             /*
              * Can't fit any more in! We just set the result flag to say there
@@ -1239,24 +1617,21 @@ int Audit_Log_Read_Range_By_Sequence(BACNET_READ_RANGE_DATA *pRequest)
                 &pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, true);
             break;
         }
-        len = bacnet_audit_log_record_encode(apdu, entry);
+        len = Audit_Log_Record_Copy(pObject, uiIndex, apdu);
         apdu += len;
         apdu_len += len;
         uiLast = uiIndex; /* Record the last entry encoded */
         uiIndex++; /* and get ready for next one */
-        uiSequence++;
         pRequest->ItemCount++; /* Chalk up another one for the response count */
     }
-
     /* Set remaining result flags if necessary */
-    if (uiFirst == 1) {
+    if (iFirst == 0) {
         bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
     }
-
-    if (uiLast == record_count) {
+    if ((pRequest->ItemCount > 0) && (uiLast == (record_count - 1))) {
         bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
     }
-    pRequest->FirstSequence = uiBegin;
+    pRequest->FirstSequence = uiFirstSeq + (uint32_t)iFirst;
 
     return apdu_len;
 }
@@ -1274,14 +1649,14 @@ int Audit_Log_Read_Range_By_Sequence(BACNET_READ_RANGE_DATA *pRequest)
  */
 int Audit_Log_Read_Range_By_Time(BACNET_READ_RANGE_DATA *pRequest)
 {
+    struct object_data *pObject;
     int apdu_len = 0;
     size_t apdu_size;
     int len;
     uint8_t *apdu;
-    int record_index = 0;
     uint32_t record_count;
     uint32_t total_record_count;
-    BACNET_AUDIT_LOG_RECORD *entry = NULL;
+    BACNET_DATE_TIME timestamp = { 0 };
     int diff;
 
     int32_t iTemp = 0;
@@ -1291,12 +1666,15 @@ int Audit_Log_Read_Range_By_Time(BACNET_READ_RANGE_DATA *pRequest)
     uint32_t uiLast = 0; /* Entry number we finished encoding on */
     uint32_t uiFirstSeq = 0; /* Sequence number for 1st record in log */
 
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject || (pObject->Record_Count == 0)) {
+        return 0;
+    }
     /* See how much space we have */
     apdu = pRequest->application_data;
     apdu_size = pRequest->application_data_len - pRequest->Overhead;
-    record_count = Audit_Log_Record_Count(pRequest->object_instance);
-    total_record_count =
-        Audit_Log_Total_Record_Count(pRequest->object_instance);
+    record_count = pObject->Record_Count;
+    total_record_count = pObject->Record_Count_Total;
     if (pRequest->Count < 0) {
         /* Start at end of log and look for record which has
          * timestamp greater than or equal to the reference.
@@ -1305,11 +1683,8 @@ int Audit_Log_Read_Range_By_Time(BACNET_READ_RANGE_DATA *pRequest)
         /* Start out with the sequence number for the last record */
         uiFirstSeq = total_record_count;
         for (;;) {
-            record_index = iCount;
-            entry =
-                Audit_Log_Record_Entry(pRequest->object_instance, record_index);
-            diff =
-                datetime_compare(&entry->timestamp, &pRequest->Range.RefTime);
+            Audit_Log_Record_Timestamp(pObject, iCount, &timestamp);
+            diff = datetime_compare(&timestamp, &pRequest->Range.RefTime);
             if (diff < 0) {
                 /* If datetime1 is before datetime2, returns negative.*/
                 break;
@@ -1347,13 +1722,10 @@ int Audit_Log_Read_Range_By_Time(BACNET_READ_RANGE_DATA *pRequest)
         iCount = 0;
         /* Figure out the sequence number for the first record, last is
          * ulTotalRecordCount */
-        uiFirstSeq = total_record_count - record_count - 1;
+        uiFirstSeq = total_record_count - (record_count - 1);
         for (;;) {
-            record_index = iCount;
-            entry =
-                Audit_Log_Record_Entry(pRequest->object_instance, record_index);
-            diff =
-                datetime_compare(&entry->timestamp, &pRequest->Range.RefTime);
+            Audit_Log_Record_Timestamp(pObject, iCount, &timestamp);
+            diff = datetime_compare(&timestamp, &pRequest->Range.RefTime);
             if (diff > 0) {
                 /* If datetime1 is after datetime2, returns positive.*/
                 break;
@@ -1371,9 +1743,7 @@ int Audit_Log_Read_Range_By_Time(BACNET_READ_RANGE_DATA *pRequest)
     uiFirst = uiIndex; /* Record where we started from */
     iCount = pRequest->Count;
     while (iCount != 0) {
-        record_index = uiIndex - 1;
-        entry = Audit_Log_Record_Entry(pRequest->object_instance, record_index);
-        len = bacnet_audit_log_record_encode(NULL, entry);
+        len = Audit_Log_Record_Copy(pObject, uiIndex - 1, NULL);
         if (len > (apdu_size - apdu_len)) {
             /*
              * Can't fit any more in! We just set the result flag to say there
@@ -1383,7 +1753,7 @@ int Audit_Log_Read_Range_By_Time(BACNET_READ_RANGE_DATA *pRequest)
                 &pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, true);
             break;
         }
-        len = bacnet_audit_log_record_encode(apdu, entry);
+        len = Audit_Log_Record_Copy(pObject, uiIndex - 1, apdu);
         apdu += len;
         apdu_len += len;
         uiLast = uiIndex; /* Record the last entry encoded */
@@ -1471,13 +1841,19 @@ uint32_t Audit_Log_Create(uint32_t object_instance)
         }
         pObject->Object_Name = NULL;
         pObject->Description = NULL;
-        pObject->Records = Keylist_Create();
-        pObject->Buffer_Size = BACNET_AUDIT_LOG_RECORDS_MAX;
         pObject->Enable = false;
         pObject->Out_Of_Service = false;
+        /* the records of a log that was kept are resumed */
+        Audit_Log_Storage_Open(
+            object_instance, pObject, BACNET_AUDIT_LOG_RECORDS_MAX);
+        if (!pObject->Storage) {
+            free(pObject);
+            return BACNET_MAX_INSTANCE;
+        }
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
+            Audit_Log_Storage_Close(object_instance, pObject, true);
             free(pObject);
             return BACNET_MAX_INSTANCE;
         }
@@ -1486,20 +1862,6 @@ uint32_t Audit_Log_Create(uint32_t object_instance)
     return object_instance;
 }
 
-/**
- * @brief Deletes all the Audit Logs and their data
- */
-static void Audit_Log_Records_Cleanup(OS_Keylist list)
-{
-    BACNET_AUDIT_LOG_RECORD *entry;
-
-    while (Keylist_Count(list) > 0) {
-        entry = Keylist_Data_Pop(list);
-        free(entry);
-    }
-    Keylist_Delete(list);
-}
-
 /**
  * @brief Deletes an Audit Log object
  * @param object_instance - object-instance number of the object
@@ -1512,7 +1874,7 @@ bool Audit_Log_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        Audit_Log_Records_Cleanup(pObject->Records);
+        Audit_Log_Storage_Close(object_instance, pObject, true);
         free(pObject);
         status = true;
     }
@@ -1521,11 +1883,14 @@ bool Audit_Log_Delete(uint32_t object_instance)
 }
 
 /**
- * @brief Deletes all the Audit Logs and their data
+ * @brief Deletes all the Audit Logs and their data. The storage blocks
+ *  are let go of without a purge, so that kept records are resumed
+ *  when the Audit Logs are created again.
  */
 void Audit_Log_Cleanup(void)
 {
     struct object_data *pObject;
+    uint32_t object_instance;
     uint16_t dev_id;
 #ifdef BAC_ROUTING
     uint16_t current_dev_id = Routed_Device_Object_Index();
@@ -1536,13 +1901,14 @@ void Audit_Log_Cleanup(void)
         Set_Routed_Device_Object_Index(dev_id);
 #endif
         if (Object_List) {
-            do {
-                pObject = Keylist_Data_Pop(Object_List);
+            while (Keylist_Count(Object_List) > 0) {
+                object_instance = Audit_Log_Index_To_Instance(0);
+                pObject = Keylist_Data_Delete_By_Index(Object_List, 0);
                 if (pObject) {
-                    Audit_Log_Records_Cleanup(pObject->Records);
+                    Audit_Log_Storage_Close(object_instance, pObject, false);
                     free(pObject);
                 }
-            } while (pObject);
+            }
             Keylist_Delete(Object_List);
             Object_List = NULL;
         }
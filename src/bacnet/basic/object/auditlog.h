@@ -21,6 +21,7 @@
 #define AUDITLOG_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -33,6 +34,53 @@
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 
+/* Buffer_Size of a new Audit Log, in records */
+#ifndef BACNET_AUDIT_LOG_RECORDS_MAX
+#define BACNET_AUDIT_LOG_RECORDS_MAX 128
+#endif
+/* largest Buffer_Size of an Audit Log, in records */
+#ifndef BACNET_AUDIT_LOG_BUFFER_SIZE_MAX
+#define BACNET_AUDIT_LOG_BUFFER_SIZE_MAX 65535UL
+#endif
+/* size of a record slot in the storage block of an Audit Log: the
+   encoded BACnetAuditLogRecord and its 2 octet length. The comments of
+   a notification that does not fit are left out of its record. */
+#ifndef BACNET_AUDIT_LOG_RECORD_SIZE
+#define BACNET_AUDIT_LOG_RECORD_SIZE 256
+#endif
+/* size of the header of the storage block of an Audit Log */
+#define BACNET_AUDIT_LOG_STORAGE_HEADER_SIZE 24
+/* size of the storage block of an Audit Log with a given buffer size */
+#define BACNET_AUDIT_LOG_STORAGE_SIZE(buffer_size) \
+    (BACNET_AUDIT_LOG_STORAGE_HEADER_SIZE +      \
+     ((size_t)(buffer_size) * BACNET_AUDIT_LOG_RECORD_SIZE))
+
+/**
+ * @brief Callback to get the storage block of a log
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param size - [in] the size wanted for a new block,
+ *  [out] the size of the block, which may be an existing one
+ * @return the storage block, or NULL if there is none
+ */
+typedef uint8_t *(*audit_log_storage_open_callback)(
+    unsigned device_index, uint32_t object_instance, size_t *size);
+
+/**
+ * @brief Callback to let go of the storage block of a log
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param storage - the storage block
+ * @param size - the size of the storage block
+ * @param purge - true if the records are no longer wanted
+ */
+typedef void (*audit_log_storage_close_callback)(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -88,6 +136,10 @@ bool Audit_Log_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Audit_Log_Cleanup(void);
 BACNET_STACK_EXPORT
+void Audit_Log_Storage_Callback_Set(
+    audit_log_storage_open_callback open_callback,
+    audit_log_storage_close_callback close_callback);
+BACNET_STACK_EXPORT
 void Audit_Log_Init(void);
 
 BACNET_STACK_EXPORT
@@ -109,6 +109,8 @@ bool Analog_Value_Present_Value_Set(
     uint32_t object_instance, float value, uint8_t priority);
 BACNET_STACK_EXPORT
 float Analog_Value_Present_Value(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Analog_Value_Present_Value_Real(uint32_t object_instance, float *value);
 
 BACNET_STACK_EXPORT
 unsigned Analog_Value_Event_State(uint32_t object_instance);
@@ -123,6 +125,9 @@ BACNET_STACK_EXPORT
 bool Analog_Value_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
 BACNET_STACK_EXPORT
+bool Analog_Value_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
+BACNET_STACK_EXPORT
 float Analog_Value_COV_Increment(uint32_t instance);
 BACNET_STACK_EXPORT
 void Analog_Value_COV_Increment_Set(uint32_t instance, float value);
@@ -234,8 +239,12 @@ void Analog_Value_Context_Set(uint32_t object_instance, void *context);
 BACNET_STACK_EXPORT
 uint32_t Analog_Value_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+uint32_t Analog_Value_Create_Range(uint32_t object_instance, uint32_t count);
+BACNET_STACK_EXPORT
 bool Analog_Value_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Analog_Value_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Analog_Value_Cleanup(void);
 BACNET_STACK_EXPORT
 void Analog_Value_Init(void);
@@ -984,6 +984,45 @@ bool bacfile_write_property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 }
 
 #if MAX_TSM_TRANSACTIONS
+/**
+ * @brief Decode the file instance from an AtomicReadFile request
+ * @param npdu_data - network layer info of the request
+ * @param apdu - the request
+ * @param apdu_len - number of octets in the request
+ * @return file instance, or BACNET_MAX_INSTANCE + 1 if not found
+ */
+static uint32_t bacfile_instance_from_request(
+    const BACNET_NPDU_DATA *npdu_data, uint8_t *apdu, uint16_t apdu_len)
+{
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    uint8_t service_choice = 0;
+    uint8_t *service_request = NULL;
+    uint16_t service_request_len = 0;
+    int len = 0; /* apdu header length */
+    BACNET_ATOMIC_READ_FILE_DATA data = { 0 };
+    uint32_t object_instance = BACNET_MAX_INSTANCE + 1; /* return value */
+
+    if (!npdu_data->network_layer_message &&
+        npdu_data->data_expecting_reply &&
+        ((apdu[0] & 0xF0) == PDU_TYPE_CONFIRMED_SERVICE_REQUEST)) {
+        len = apdu_decode_confirmed_service_request(
+            &apdu[0], apdu_len, &service_data, &service_choice,
+            &service_request, &service_request_len);
+        if ((len > 0) &&
+            (service_choice == SERVICE_CONFIRMED_ATOMIC_READ_FILE)) {
+            len = arf_decode_service_request(
+                service_request, service_request_len, &data);
+            if (len > 0) {
+                if (data.object_type == OBJECT_FILE) {
+                    object_instance = data.object_instance;
+                }
+            }
+        }
+    }
+
+    return object_instance;
+}
+
 /* this is one way to match up the invoke ID with */
 /* the file ID from the AtomicReadFile request. */
 /* Another way would be to store the */
@@ -992,38 +1031,41 @@ bool bacfile_write_property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 uint32_t bacfile_instance_from_tsm(uint8_t invokeID)
 {
     BACNET_NPDU_DATA npdu_data = { 0 }; /* dummy for getting npdu length */
-    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
-    uint8_t service_choice = 0;
-    uint8_t *service_request = NULL;
-    uint16_t service_request_len = 0;
     BACNET_ADDRESS dest; /* where the original packet was destined */
     uint8_t apdu[MAX_PDU] = { 0 }; /* original APDU packet */
     uint16_t apdu_len = 0; /* original APDU packet length */
-    int len = 0; /* apdu header length */
-    BACNET_ATOMIC_READ_FILE_DATA data = { 0 };
     uint32_t object_instance = BACNET_MAX_INSTANCE + 1; /* return value */
     bool found = false;
 
     found = tsm_get_transaction_pdu(
         invokeID, &dest, &npdu_data, &apdu[0], &apdu_len);
     if (found) {
-        if (!npdu_data.network_layer_message &&
-            npdu_data.data_expecting_reply &&
-            ((apdu[0] & 0xF0) == PDU_TYPE_CONFIRMED_SERVICE_REQUEST)) {
-            len = apdu_decode_confirmed_service_request(
-                &apdu[0], apdu_len, &service_data, &service_choice,
-                &service_request, &service_request_len);
-            if ((len > 0) &&
-                (service_choice == SERVICE_CONFIRMED_ATOMIC_READ_FILE)) {
-                len = arf_decode_service_request(
-                    service_request, service_request_len, &data);
-                if (len > 0) {
-                    if (data.object_type == OBJECT_FILE) {
-                        object_instance = data.object_instance;
-                    }
-                }
-            }
-        }
+        object_instance =
+            bacfile_instance_from_request(&npdu_data, &apdu[0], apdu_len);
+    }
+
+    return object_instance;
+}
+
+/**
+ * @brief Find the file instance of the AtomicReadFile request
+ *  that was sent to a peer
+ * @param src - BACnet address of the peer
+ * @param invokeID - invoke ID of the request
+ * @return file instance, or BACNET_MAX_INSTANCE + 1 if not found
+ */
+uint32_t bacfile_instance_from_tsm_peer(
+    const BACNET_ADDRESS *src, uint8_t invokeID)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t apdu[MAX_PDU] = { 0 };
+    uint16_t apdu_len = 0;
+    uint32_t object_instance = BACNET_MAX_INSTANCE + 1;
+
+    if (tsm_get_transaction_pdu_peer(
+            src, invokeID, &npdu_data, &apdu[0], &apdu_len)) {
+        object_instance =
+            bacfile_instance_from_request(&npdu_data, &apdu[0], apdu_len);
     }
 
     return object_instance;
@@ -83,6 +83,9 @@ bool bacfile_file_size_set(
 /* when the request was sent */
 BACNET_STACK_EXPORT
 uint32_t bacfile_instance_from_tsm(uint8_t invokeID);
+BACNET_STACK_EXPORT
+uint32_t bacfile_instance_from_tsm_peer(
+    const BACNET_ADDRESS *src, uint8_t invokeID);
 
 /* handler ACK helper */
 BACNET_STACK_EXPORT
@@ -36,6 +36,13 @@ typedef void (*binary_input_write_present_value_callback)(
     BACNET_BINARY_PV old_value,
     BACNET_BINARY_PV value);
 
+/* present-value and reliability of one object, for a batch update */
+typedef struct binary_input_update {
+    uint32_t Object_Instance;
+    BACNET_BINARY_PV Present_Value;
+    BACNET_RELIABILITY Reliability;
+} BINARY_INPUT_UPDATE;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -71,8 +78,14 @@ const char *Binary_Input_Name_ASCII(uint32_t object_instance);
 BACNET_STACK_EXPORT
 BACNET_BINARY_PV Binary_Input_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Binary_Input_Present_Value_Enumerated(
+    uint32_t object_instance, uint32_t *value);
+BACNET_STACK_EXPORT
 bool Binary_Input_Present_Value_Set(
     uint32_t object_instance, BACNET_BINARY_PV value);
+BACNET_STACK_EXPORT
+unsigned Binary_Input_Present_Value_Update(
+    const BINARY_INPUT_UPDATE *updates, unsigned count);
 
 BACNET_STACK_EXPORT
 const char *Binary_Input_Description(uint32_t instance);
@@ -113,6 +126,9 @@ BACNET_STACK_EXPORT
 bool Binary_Input_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
 BACNET_STACK_EXPORT
+bool Binary_Input_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
+BACNET_STACK_EXPORT
 bool Binary_Input_Change_Of_Value(uint32_t instance);
 BACNET_STACK_EXPORT
 void Binary_Input_Change_Of_Value_Clear(uint32_t instance);
@@ -140,8 +156,12 @@ void Binary_Input_Context_Set(uint32_t object_instance, void *context);
 BACNET_STACK_EXPORT
 uint32_t Binary_Input_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+uint32_t Binary_Input_Create_Range(uint32_t object_instance, uint32_t count);
+BACNET_STACK_EXPORT
 bool Binary_Input_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Binary_Input_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Binary_Input_Cleanup(void);
 BACNET_STACK_EXPORT
 void Binary_Input_Init(void);
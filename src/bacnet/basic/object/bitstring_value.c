@@ -15,6 +15,7 @@
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacenum.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
 #include "bacnet/config.h"
 #include "bacnet/proplist.h"
 #include "bacnet/property.h"
@@ -218,6 +219,7 @@ bool BitString_Value_Present_Value_Set(
     if (pObject) {
         if (!bitstring_same(&pObject->Present_Value, value)) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(OBJECT_BITSTRING_VALUE, object_instance);
         }
         status = bitstring_copy(&pObject->Present_Value, value);
     }
@@ -303,11 +305,12 @@ bool BitString_Value_Out_Of_Service(uint32_t object_instance)
  * @param  value - out-of-service value
  */
 static void BitString_Value_Out_Of_Service_COV_Detect(
-    struct object_data *pObject, bool value)
+    uint32_t object_instance, struct object_data *pObject, bool value)
 {
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(OBJECT_BITSTRING_VALUE, object_instance);
         }
     }
 }
@@ -323,7 +326,8 @@ void BitString_Value_Out_Of_Service_Set(uint32_t object_instance, bool value)
 
     pObject = BitString_Value_Object(object_instance);
     if (pObject) {
-        BitString_Value_Out_Of_Service_COV_Detect(pObject, value);
+        BitString_Value_Out_Of_Service_COV_Detect(
+            object_instance, pObject, value);
         pObject->Out_Of_Service = value;
     }
 
@@ -353,7 +357,8 @@ static bool BitString_Value_Out_Of_Service_Write(
     pObject = BitString_Value_Object(object_instance);
     if (pObject) {
         if (pObject->Write_Enabled) {
-            BitString_Value_Out_Of_Service_COV_Detect(pObject, value);
+            BitString_Value_Out_Of_Service_COV_Detect(
+                object_instance, pObject, value);
             pObject->Out_Of_Service = value;
             status = true;
         } else {
@@ -423,6 +428,8 @@ bool BitString_Value_Reliablity_Set(
             pObject->Reliability = value;
             if (fault != BitString_Value_Object_Fault(pObject)) {
                 pObject->Change_Of_Value = true;
+                cov_change_of_value_notify(
+                    OBJECT_BITSTRING_VALUE, object_instance);
             }
             status = true;
         }
@@ -20,6 +20,7 @@
 #include "bacnet/lighting.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/priority_array.h"
 #include "bacnet/proplist.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
@@ -35,7 +36,7 @@ struct object_data {
     uint32_t Egress_Time;
     BACNET_BINARY_LIGHTING_PV Feedback_Value;
     BACNET_BINARY_LIGHTING_PV Priority_Array[BACNET_MAX_PRIORITY];
-    uint16_t Priority_Active_Bits;
+    PRIORITY_ARRAY_STATE Priority_State;
     BACNET_BINARY_LIGHTING_PV Relinquish_Default;
     float Power;
     uint32_t Elapsed_Active_Time;
@@ -217,9 +218,7 @@ static bool Priority_Array_Active(
     bool active = false;
 
     if (priority < BACNET_MAX_PRIORITY) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, priority)) {
-            active = true;
-        }
+        active = priority_array_active(&pObject->Priority_State, priority + 1);
     }
 
     return active;
@@ -240,10 +239,11 @@ static BACNET_BINARY_LIGHTING_PV Priority_Array_Next_Value(
     unsigned p = 0;
 
     value = pObject->Relinquish_Default;
-    for (p = priority; p < BACNET_MAX_PRIORITY; p++) {
-        if (Priority_Array_Active(pObject, p)) {
-            value = pObject->Priority_Array[p];
-            break;
+    if (priority < BACNET_MAX_PRIORITY) {
+        p = priority_array_next_priority(
+            &pObject->Priority_State, priority + 1);
+        if (p) {
+            value = pObject->Priority_Array[p - 1];
         }
     }
 
@@ -284,7 +284,7 @@ static BACNET_BINARY_LIGHTING_PV Priority_Array_Value(
     BACNET_BINARY_LIGHTING_PV value = BINARY_LIGHTING_PV_OFF;
 
     if (priority < BACNET_MAX_PRIORITY) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, priority)) {
+        if (Priority_Array_Active(pObject, priority)) {
             value = pObject->Priority_Array[priority];
         }
     }
@@ -333,14 +333,11 @@ static int Binary_Lighting_Output_Priority_Array_Encode(
  */
 static unsigned Present_Value_Priority(const struct object_data *pObject)
 {
-    unsigned p; /* loop counter */
-    unsigned priority = BACNET_MAX_PRIORITY + 1; /* return value */
+    unsigned priority; /* return value */
 
-    for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-            priority = p + 1;
-            break;
-        }
+    priority = priority_array_active_priority(&pObject->Priority_State);
+    if (priority == 0) {
+        priority = BACNET_MAX_PRIORITY + 1;
     }
 
     return priority;
@@ -362,8 +359,8 @@ Present_Value_Relinquish(struct object_data *pObject, unsigned priority)
 
     if (priority && (priority <= BACNET_MAX_PRIORITY) &&
         (priority != 6 /* reserved */)) {
+        priority_array_relinquish(&pObject->Priority_State, priority);
         priority--;
-        BIT_CLEAR(pObject->Priority_Active_Bits, priority);
         pObject->Priority_Array[priority] = BINARY_LIGHTING_PV_OFF;
         status = true;
     }
@@ -390,12 +387,11 @@ static bool Present_Value_Set(
 
     if (priority && (priority <= BACNET_MAX_PRIORITY) &&
         (priority != 6 /* reserved */)) {
-        priority--;
         if ((value == BINARY_LIGHTING_PV_OFF) ||
             (value == BINARY_LIGHTING_PV_ON)) {
             /* The logical state of the output shall be either ON or OFF */
-            BIT_SET(pObject->Priority_Active_Bits, priority);
-            pObject->Priority_Array[priority] = value;
+            priority_array_command(&pObject->Priority_State, priority);
+            pObject->Priority_Array[priority - 1] = value;
             status = true;
         }
     }
@@ -1621,9 +1617,9 @@ uint32_t Binary_Lighting_Output_Create(uint32_t object_instance)
         pObject->Egress_Time = 0;
         pObject->Feedback_Value = BINARY_LIGHTING_PV_OFF;
         pObject->Target_Value = BINARY_LIGHTING_PV_OFF;
+        priority_array_init(&pObject->Priority_State);
         for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
             pObject->Priority_Array[p] = BINARY_LIGHTING_PV_OFF;
-            BIT_CLEAR(pObject->Priority_Active_Bits, p);
         }
         pObject->Relinquish_Default = BINARY_LIGHTING_PV_OFF;
         pObject->Power = 0.0;
@@ -29,6 +29,8 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/priority_array.h"
+#include "bacnet/basic/sys/slab.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
 /* me! */
@@ -41,8 +43,10 @@ struct object_data {
     bool Changed : 1;
     bool Relinquish_Default : 1;
     bool Polarity : 1;
+    /* the effective value of the priority array, kept when it changes */
+    bool Present_Value : 1;
     uint16_t Priority_Array;
-    uint16_t Priority_Active_Bits;
+    PRIORITY_ARRAY_STATE Priority_State;
     uint8_t Reliability;
     const char *Object_Name;
     const char *Active_Text;
@@ -57,6 +61,9 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* memory pool for the object data */
+static SLAB_TYPE Object_Slab = SLAB_ACCOUNT_INITIALIZER(
+    sizeof(struct object_data), MEMSTAT_ACCOUNT_OBJECT(OBJECT_BINARY_OUTPUT));
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_BINARY_OUTPUT;
 /* callback for present value writes */
@@ -203,34 +210,40 @@ unsigned Binary_Output_Instance_To_Index(uint32_t object_instance)
 }
 
 /**
- * @brief Calculated the present-value property from the priority array.
+ * @brief Get the present-value property, which is kept as the effective
+ *  value of the priority array.
  * @param pObject - pointer to the object data
  * @return The present-value of the object
  */
-static BACNET_BINARY_PV Object_Present_Value(struct object_data *pObject)
+static BACNET_BINARY_PV Object_Present_Value(const struct object_data *pObject)
 {
     BACNET_BINARY_PV value = BINARY_INACTIVE;
-    unsigned p = 0;
 
-    if (pObject) {
-        if (pObject->Relinquish_Default) {
-            value = BINARY_ACTIVE;
-        }
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-                if (BIT_CHECK(pObject->Priority_Array, p)) {
-                    value = BINARY_ACTIVE;
-                } else {
-                    value = BINARY_INACTIVE;
-                }
-                break;
-            }
-        }
+    if (pObject && pObject->Present_Value) {
+        value = BINARY_ACTIVE;
     }
 
     return value;
 }
 
+/**
+ * @brief Keep the effective value of the priority array as the
+ *  present-value, after a slot or the relinquish-default changed
+ * @param pObject - pointer to the object data
+ */
+static void Object_Present_Value_Update(struct object_data *pObject)
+{
+    unsigned priority;
+
+    priority = priority_array_active_priority(&pObject->Priority_State);
+    if (priority) {
+        pObject->Present_Value =
+            BIT_CHECK(pObject->Priority_Array, priority - 1) != 0;
+    } else {
+        pObject->Present_Value = pObject->Relinquish_Default;
+    }
+}
+
 /**
  * For a given object instance-number, determines the present-value
  *
@@ -251,6 +264,26 @@ BACNET_BINARY_PV Binary_Output_Present_Value(uint32_t object_instance)
     return value;
 }
 
+/**
+ * @brief For a given object instance-number, reads the present-value
+ *  without encoding it, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  value - [out] the present-value
+ * @return  true if the object instance exists
+ */
+bool Binary_Output_Present_Value_Enumerated(
+    uint32_t object_instance, uint32_t *value)
+{
+    if (!Binary_Output_Valid_Instance(object_instance)) {
+        return false;
+    }
+    if (value) {
+        *value = Binary_Output_Present_Value(object_instance);
+    }
+
+    return true;
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -270,7 +303,7 @@ static int Binary_Output_Priority_Array_Encode(
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && (index < BACNET_MAX_PRIORITY)) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, index)) {
+        if (priority_array_active(&pObject->Priority_State, index + 1)) {
             if (BIT_CHECK(pObject->Priority_Array, index)) {
                 value = BINARY_ACTIVE;
             }
@@ -292,18 +325,12 @@ static int Binary_Output_Priority_Array_Encode(
  */
 unsigned Binary_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = priority_array_active_priority(&pObject->Priority_State);
     }
 
     return priority;
@@ -333,17 +360,19 @@ bool Binary_Output_Present_Value_Set(
             priority--;
             old_value = Object_Present_Value(pObject);
             if (binary_value < BINARY_PV_MAX) {
-                BIT_SET(pObject->Priority_Active_Bits, priority);
                 if (binary_value == BINARY_ACTIVE) {
                     BIT_SET(pObject->Priority_Array, priority);
                 } else {
                     BIT_CLEAR(pObject->Priority_Array, priority);
                 }
+                priority_array_command(&pObject->Priority_State, priority + 1);
+                Object_Present_Value_Update(pObject);
                 status = true;
             }
             new_value = Object_Present_Value(pObject);
             if (old_value != new_value) {
                 pObject->Changed = true;
+                cov_change_of_value_notify(Object_Type, object_instance);
             }
         }
     }
@@ -364,8 +393,8 @@ bool Binary_Output_Priority_Array_Relinquished(
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
-        if (!BIT_CHECK(pObject->Priority_Active_Bits, priority - 1)) {
+    if (pObject && (priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
+        if (!priority_array_active(&pObject->Priority_State, priority)) {
             status = true;
         }
     }
@@ -386,7 +415,7 @@ Binary_Output_Priority_Array_Value(uint32_t object_instance, unsigned priority)
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
+    if (pObject && (priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
         if (BIT_CHECK(pObject->Priority_Array, priority - 1)) {
             value = BINARY_ACTIVE;
         }
@@ -417,11 +446,13 @@ bool Binary_Output_Present_Value_Relinquish(
             (priority != 6 /* reserved */)) {
             priority--;
             old_value = Object_Present_Value(pObject);
-            BIT_CLEAR(pObject->Priority_Active_Bits, priority);
             BIT_CLEAR(pObject->Priority_Array, priority);
+            priority_array_relinquish(&pObject->Priority_State, priority + 1);
+            Object_Present_Value_Update(pObject);
             new_value = Object_Present_Value(pObject);
             if (old_value != new_value) {
                 pObject->Changed = true;
+                cov_change_of_value_notify(Object_Type, object_instance);
             }
             status = true;
         }
@@ -581,6 +612,7 @@ void Binary_Output_Out_Of_Service_Set(uint32_t object_instance, bool value)
         if (pObject->Out_Of_Service != value) {
             pObject->Out_Of_Service = value;
             pObject->Changed = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
     }
 }
@@ -759,6 +791,7 @@ bool Binary_Output_Relinquish_Default_Set(
             pObject->Relinquish_Default = false;
             status = true;
         }
+        Object_Present_Value_Update(pObject);
     }
 
     return status;
@@ -826,6 +859,7 @@ bool Binary_Output_Reliability_Set(
             pObject->Reliability = value;
             if (fault != Binary_Output_Object_Fault(pObject)) {
                 pObject->Changed = true;
+                cov_change_of_value_notify(Object_Type, object_instance);
             }
             status = true;
         }
@@ -1043,6 +1077,32 @@ bool Binary_Output_Encode_Value_List(
     return status;
 }
 
+/**
+ * @brief For a given object instance-number, reads the status-flags
+ *  without encoding them, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  status_flags - [out] the status-flags
+ * @return  true if the object instance exists
+ */
+bool Binary_Output_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags)
+{
+    bool status = false;
+    struct object_data *pObject;
+    const bool in_alarm = false;
+    bool fault = false;
+    const bool overridden = false;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        fault = Binary_Output_Object_Fault(pObject);
+        cov_status_flags_set(
+            status_flags, in_alarm, fault, overridden, pObject->Out_Of_Service);
+        status = true;
+    }
+    return status;
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -1058,6 +1118,7 @@ int Binary_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_len = 0; /* return value */
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
+    BACNET_CHARACTER_STRING_VIEW char_view;
     BACNET_BINARY_PV present_value = BINARY_INACTIVE;
     BACNET_POLARITY polarity = POLARITY_NORMAL;
     unsigned i = 0;
@@ -1084,9 +1145,19 @@ int Binary_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 &apdu[0], Object_Type, rpdata->object_instance);
             break;
         case PROP_OBJECT_NAME:
-            Binary_Output_Object_Name(rpdata->object_instance, &char_string);
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            /* a name that is kept by the object is encoded in place */
+            if (characterstring_view_init_ansi(
+                    &char_view,
+                    Binary_Output_Name_ASCII(rpdata->object_instance)) &&
+                (char_view.length > 0)) {
+                apdu_len = encode_application_character_string_view(
+                    &apdu[0], &char_view);
+            } else {
+                Binary_Output_Object_Name(
+                    rpdata->object_instance, &char_string);
+                apdu_len =
+                    encode_application_character_string(&apdu[0], &char_string);
+            }
             break;
         case PROP_OBJECT_TYPE:
             apdu_len = encode_application_enumerated(&apdu[0], Object_Type);
@@ -1308,6 +1379,22 @@ void Binary_Output_Context_Set(uint32_t object_instance, void *context)
     }
 }
 
+/**
+ * @brief Set the default property values of a new Binary Output object
+ * @param pObject - object data, zeroed when allocated
+ */
+static void Binary_Output_Object_Defaults(struct object_data *pObject)
+{
+    pObject->Object_Name = NULL;
+    pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
+    pObject->Out_Of_Service = false;
+    pObject->Active_Text = Default_Active_Text;
+    pObject->Inactive_Text = Default_Inactive_Text;
+    pObject->Changed = false;
+    priority_array_init(&pObject->Priority_State);
+    Object_Present_Value_Update(pObject);
+}
+
 /**
  * @brief Creates a Binary Output object
  * @param object_instance - object-instance number of the object
@@ -1333,18 +1420,13 @@ uint32_t Binary_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Slab_Item_Alloc(&Object_Slab);
         if (pObject) {
-            pObject->Object_Name = NULL;
-            pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
-            pObject->Out_Of_Service = false;
-            pObject->Active_Text = Default_Active_Text;
-            pObject->Inactive_Text = Default_Inactive_Text;
-            pObject->Changed = false;
+            Binary_Output_Object_Defaults(pObject);
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Slab_Free(&Object_Slab, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1355,6 +1437,52 @@ uint32_t Binary_Output_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates the Binary Output objects of a range that do not exist
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of object instances in the range
+ * @return the number of objects that were created
+ */
+uint32_t Binary_Output_Create_Range(uint32_t object_instance, uint32_t count)
+{
+    struct object_data *pObject = NULL;
+    uint32_t instance = 0;
+    uint32_t created = 0;
+    uint32_t i = 0;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+    }
+    if ((count == 0) || (object_instance >= BACNET_MAX_INSTANCE) ||
+        (count > (BACNET_MAX_INSTANCE - object_instance))) {
+        return 0;
+    }
+    if (!Keylist_Reserve(Object_List, Keylist_Count(Object_List) + count)) {
+        return 0;
+    }
+    if (!Slab_Reserve(&Object_Slab, count)) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if (Keylist_Data(Object_List, instance)) {
+            continue;
+        }
+        pObject = Slab_Item_Alloc(&Object_Slab);
+        if (!pObject) {
+            break;
+        }
+        Binary_Output_Object_Defaults(pObject);
+        if (Keylist_Data_Add(Object_List, instance, pObject) < 0) {
+            Slab_Free(&Object_Slab, pObject);
+            break;
+        }
+        created++;
+    }
+
+    return created;
+}
+
 /**
  * Initializes the Binary Input object data
  */
@@ -1374,7 +1502,7 @@ void Binary_Output_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
-                    free(pObject);
+                    Slab_Free(&Object_Slab, pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
@@ -1382,6 +1510,7 @@ void Binary_Output_Cleanup(void)
         }
     }
 
+    Slab_Cleanup(&Object_Slab);
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
 #endif
@@ -1397,13 +1526,25 @@ bool Binary_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Slab_Free(&Object_Slab, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Reserves pool memory for Binary Output objects, see Slab_Reserve()
+ * @param count - number of objects to reserve memory for
+ * @return true if the memory was reserved
+ */
+bool Binary_Output_Pool_Reserve(uint32_t count)
+{
+    Slab_Retain_Set(&Object_Slab, true);
+
+    return Slab_Reserve(&Object_Slab, count);
+}
+
 /**
  * Initializes the Binary Input object data
  */
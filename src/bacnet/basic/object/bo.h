@@ -77,6 +77,9 @@ bool Binary_Output_Active_Text_Set(uint32_t instance, const char *new_name);
 BACNET_STACK_EXPORT
 BACNET_BINARY_PV Binary_Output_Present_Value(uint32_t instance);
 BACNET_STACK_EXPORT
+bool Binary_Output_Present_Value_Enumerated(
+    uint32_t object_instance, uint32_t *value);
+BACNET_STACK_EXPORT
 bool Binary_Output_Present_Value_Set(
     uint32_t instance, BACNET_BINARY_PV binary_value, unsigned priority);
 
@@ -130,6 +133,9 @@ BACNET_STACK_EXPORT
 bool Binary_Output_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
 BACNET_STACK_EXPORT
+bool Binary_Output_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
+BACNET_STACK_EXPORT
 bool Binary_Output_Change_Of_Value(uint32_t instance);
 BACNET_STACK_EXPORT
 void Binary_Output_Change_Of_Value_Clear(uint32_t instance);
@@ -147,8 +153,12 @@ void Binary_Output_Context_Set(uint32_t object_instance, void *context);
 BACNET_STACK_EXPORT
 uint32_t Binary_Output_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+uint32_t Binary_Output_Create_Range(uint32_t object_instance, uint32_t count);
+BACNET_STACK_EXPORT
 bool Binary_Output_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Binary_Output_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Binary_Output_Cleanup(void);
 
 #ifdef __cplusplus
@@ -26,6 +26,7 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/slab.h"
 #include "bacnet/basic/sys/debug.h"
 /* me! */
 #include "bacnet/basic/object/bv.h"
@@ -66,6 +67,9 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* memory pool for the object data */
+static SLAB_TYPE Object_Slab = SLAB_ACCOUNT_INITIALIZER(
+    sizeof(struct object_data), MEMSTAT_ACCOUNT_OBJECT(OBJECT_BINARY_VALUE));
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_BINARY_VALUE;
 /* callback for present value writes */
@@ -170,6 +174,25 @@ static struct object_data *Binary_Value_Object(uint32_t object_instance)
     return Keylist_Data(Object_List, object_instance);
 }
 
+#if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
+/**
+ * @brief Report whether an object has an active event state, for the
+ *  GetEventInformation and GetAlarmSummary services
+ * @param  object_instance - object-instance number of the object
+ * @param  pObject - object data
+ */
+static void Binary_Value_Event_Active_Update(
+    uint32_t object_instance, const struct object_data *pObject)
+{
+    handler_get_event_information_active_set(
+        Object_Type, object_instance,
+        (pObject->Event_State != EVENT_STATE_NORMAL) ||
+            !pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ||
+            !pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ||
+            !pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked);
+}
+#endif
+
 /**
  * @brief Determines if a given object instance is valid
  * @param  object_instance - object-instance number of the object
@@ -274,17 +297,40 @@ BACNET_BINARY_PV Binary_Value_Present_Value(uint32_t object_instance)
     return value;
 }
 
+/**
+ * @brief For a given object instance-number, reads the present-value
+ *  without encoding it, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  value - [out] the present-value
+ * @return  true if the object instance exists
+ */
+bool Binary_Value_Present_Value_Enumerated(
+    uint32_t object_instance, uint32_t *value)
+{
+    if (!Binary_Value_Valid_Instance(object_instance)) {
+        return false;
+    }
+    if (value) {
+        *value = Binary_Value_Present_Value(object_instance);
+    }
+
+    return true;
+}
+
 /**
  * @brief For a given object instance-number, checks the present-value for COV
  * @param  pObject - specific object with valid data
  * @param  value - binary value
  */
 static void Binary_Value_Present_Value_COV_Detect(
-    struct object_data *pObject, BACNET_BINARY_PV value)
+    uint32_t object_instance,
+    struct object_data *pObject,
+    BACNET_BINARY_PV value)
 {
     if (pObject) {
         if (Binary_Present_Value(pObject->Present_Value) != value) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
     }
 }
@@ -323,6 +369,7 @@ void Binary_Value_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
         pObject->Out_Of_Service = value;
     }
@@ -389,6 +436,7 @@ bool Binary_Value_Reliability_Set(
             pObject->Reliability = value;
             if (fault != Binary_Value_Object_Fault(pObject)) {
                 pObject->Change_Of_Value = true;
+                cov_change_of_value_notify(Object_Type, object_instance);
             }
             status = true;
         }
@@ -481,6 +529,37 @@ bool Binary_Value_Encode_Value_List(
     return status;
 }
 
+/**
+ * @brief For a given object instance-number, reads the status-flags
+ *  without encoding them, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  status_flags - [out] the status-flags
+ * @return  true if the object instance exists
+ */
+bool Binary_Value_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags)
+{
+    bool status = false;
+    const bool in_alarm = false;
+    bool out_of_service = false;
+    bool fault = false;
+    const bool overridden = false;
+    struct object_data *pObject;
+
+    pObject = Binary_Value_Object(object_instance);
+    if (pObject) {
+        if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+            fault = true;
+        }
+        out_of_service = pObject->Out_Of_Service;
+        cov_status_flags_set(
+            status_flags, in_alarm, fault, overridden, out_of_service);
+        status = true;
+    }
+
+    return status;
+}
+
 /**
  * @brief For a given object instance-number, sets the present-value
  * @param  object_instance - object-instance number of the object
@@ -496,7 +575,8 @@ bool Binary_Value_Present_Value_Set(
     pObject = Binary_Value_Object(object_instance);
     if (pObject) {
         if (value < BINARY_PV_MAX) {
-            Binary_Value_Present_Value_COV_Detect(pObject, value);
+            Binary_Value_Present_Value_COV_Detect(
+                object_instance, pObject, value);
             pObject->Present_Value = Binary_Present_Value_Boolean(value);
             status = true;
         }
@@ -530,7 +610,8 @@ static bool Binary_Value_Present_Value_Write(
         if (value < BINARY_PV_MAX) {
             if (pObject->Write_Enabled) {
                 old_value = Binary_Present_Value(pObject->Present_Value);
-                Binary_Value_Present_Value_COV_Detect(pObject, value);
+                Binary_Value_Present_Value_COV_Detect(
+                    object_instance, pObject, value);
                 pObject->Present_Value = Binary_Present_Value_Boolean(value);
                 if (pObject->Out_Of_Service) {
                     /* The physical point that the object represents
@@ -855,6 +936,7 @@ int Binary_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_len = 0; /* return value */
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
+    BACNET_CHARACTER_STRING_VIEW char_view;
     uint8_t *apdu = NULL;
     bool state = false;
     struct object_data *pObject;
@@ -882,10 +964,19 @@ int Binary_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 &apdu[0], Object_Type, rpdata->object_instance);
             break;
         case PROP_OBJECT_NAME:
-            /* note: object name must be unique in our device */
-            Binary_Value_Object_Name(rpdata->object_instance, &char_string);
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            /* a name that is kept by the object is encoded in place */
+            if (characterstring_view_init_ansi(
+                    &char_view,
+                    Binary_Value_Name_ASCII(rpdata->object_instance)) &&
+                (char_view.length > 0)) {
+                apdu_len = encode_application_character_string_view(
+                    &apdu[0], &char_view);
+            } else {
+                /* note: object name must be unique in our device */
+                Binary_Value_Object_Name(rpdata->object_instance, &char_string);
+                apdu_len =
+                    encode_application_character_string(&apdu[0], &char_string);
+            }
             break;
         case PROP_OBJECT_TYPE:
             apdu_len = encode_application_enumerated(&apdu[0], Object_Type);
@@ -1253,6 +1344,50 @@ void Binary_Value_Context_Set(uint32_t object_instance, void *context)
     }
 }
 
+/**
+ * @brief Set the default property values of a new Binary Value object
+ * @param pObject - object data, zeroed when allocated
+ */
+static void Binary_Value_Object_Defaults(struct object_data *pObject)
+{
+#if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
+    unsigned j;
+#endif
+
+    pObject->Object_Name = NULL;
+    pObject->Description = NULL;
+    pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
+    pObject->Present_Value = false;
+    pObject->Out_Of_Service = false;
+    pObject->Active_Text = Default_Active_Text;
+    pObject->Inactive_Text = Default_Inactive_Text;
+    pObject->Change_Of_Value = false;
+    pObject->Write_Enabled = false;
+#if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
+    pObject->Event_State = EVENT_STATE_NORMAL;
+    pObject->Event_Detection_Enable = true;
+    /* notification class not connected */
+    pObject->Notification_Class = BACNET_MAX_INSTANCE;
+    /* initialize Event time stamps using wildcards and set
+     * Acked_transitions */
+    for (j = 0; j < MAX_BACNET_EVENT_TRANSITION; j++) {
+        datetime_wildcard_set(&pObject->Event_Time_Stamps[j]);
+        pObject->Acked_Transitions[j].bIsAcked = true;
+    }
+
+    /* Set handler for GetEventInformation function */
+    handler_get_event_information_set(
+        Object_Type, Binary_Value_Event_Information);
+    handler_get_event_information_index_set(
+        Object_Type, Binary_Value_Instance_To_Index);
+    /* Set handler for AcknowledgeAlarm function */
+    handler_alarm_ack_set(Object_Type, Binary_Value_Alarm_Ack);
+    /* Set handler for GetAlarmSummary Service */
+    handler_get_alarm_summary_set(
+        Object_Type, Binary_Value_Alarm_Summary);
+#endif
+}
+
 /**
  * @brief Creates a Binary Value object
  * @param object_instance - object-instance number of the object
@@ -1278,45 +1413,13 @@ uint32_t Binary_Value_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Slab_Item_Alloc(&Object_Slab);
         if (pObject) {
-#if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
-            unsigned j;
-#endif
-            pObject->Object_Name = NULL;
-            pObject->Description = NULL;
-            pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
-            pObject->Present_Value = false;
-            pObject->Out_Of_Service = false;
-            pObject->Active_Text = Default_Active_Text;
-            pObject->Inactive_Text = Default_Inactive_Text;
-            pObject->Change_Of_Value = false;
-            pObject->Write_Enabled = false;
-#if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
-            pObject->Event_State = EVENT_STATE_NORMAL;
-            pObject->Event_Detection_Enable = true;
-            /* notification class not connected */
-            pObject->Notification_Class = BACNET_MAX_INSTANCE;
-            /* initialize Event time stamps using wildcards and set
-             * Acked_transitions */
-            for (j = 0; j < MAX_BACNET_EVENT_TRANSITION; j++) {
-                datetime_wildcard_set(&pObject->Event_Time_Stamps[j]);
-                pObject->Acked_Transitions[j].bIsAcked = true;
-            }
-
-            /* Set handler for GetEventInformation function */
-            handler_get_event_information_set(
-                Object_Type, Binary_Value_Event_Information);
-            /* Set handler for AcknowledgeAlarm function */
-            handler_alarm_ack_set(Object_Type, Binary_Value_Alarm_Ack);
-            /* Set handler for GetAlarmSummary Service */
-            handler_get_alarm_summary_set(
-                Object_Type, Binary_Value_Alarm_Summary);
-#endif
+            Binary_Value_Object_Defaults(pObject);
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Slab_Free(&Object_Slab, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1327,6 +1430,52 @@ uint32_t Binary_Value_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates the Binary Value objects of a range that do not exist
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of object instances in the range
+ * @return the number of objects that were created
+ */
+uint32_t Binary_Value_Create_Range(uint32_t object_instance, uint32_t count)
+{
+    struct object_data *pObject = NULL;
+    uint32_t instance = 0;
+    uint32_t created = 0;
+    uint32_t i = 0;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+    }
+    if ((count == 0) || (object_instance >= BACNET_MAX_INSTANCE) ||
+        (count > (BACNET_MAX_INSTANCE - object_instance))) {
+        return 0;
+    }
+    if (!Keylist_Reserve(Object_List, Keylist_Count(Object_List) + count)) {
+        return 0;
+    }
+    if (!Slab_Reserve(&Object_Slab, count)) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if (Keylist_Data(Object_List, instance)) {
+            continue;
+        }
+        pObject = Slab_Item_Alloc(&Object_Slab);
+        if (!pObject) {
+            break;
+        }
+        Binary_Value_Object_Defaults(pObject);
+        if (Keylist_Data_Add(Object_List, instance, pObject) < 0) {
+            Slab_Free(&Object_Slab, pObject);
+            break;
+        }
+        created++;
+    }
+
+    return created;
+}
+
 /**
  * Deletes the Binary Value object data
  */
@@ -1346,7 +1495,7 @@ void Binary_Value_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
-                    free(pObject);
+                    Slab_Free(&Object_Slab, pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
@@ -1354,6 +1503,7 @@ void Binary_Value_Cleanup(void)
         }
     }
 
+    Slab_Cleanup(&Object_Slab);
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
 #endif
@@ -1369,13 +1519,29 @@ bool Binary_Value_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+#if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
+        handler_get_event_information_active_set(
+            Object_Type, object_instance, false);
+#endif
+        Slab_Free(&Object_Slab, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Reserves pool memory for Binary Value objects, see Slab_Reserve()
+ * @param count - number of objects to reserve memory for
+ * @return true if the memory was reserved
+ */
+bool Binary_Value_Pool_Reserve(uint32_t count)
+{
+    Slab_Retain_Set(&Object_Slab, true);
+
+    return Slab_Reserve(&Object_Slab, count);
+}
+
 /**
  * Initializes the Binary Value object data
  */
@@ -1747,6 +1913,8 @@ int Binary_Value_Alarm_Ack(
     }
     pObject->Ack_notify_data.bSendAckNotify = true;
     pObject->Ack_notify_data.EventState = alarmack_data->eventStateAcked;
+    Binary_Value_Event_Active_Update(
+        alarmack_data->eventObjectIdentifier.instance, pObject);
 
     return 1;
 }
@@ -2187,6 +2355,7 @@ void Binary_Value_Intrinsic_Reporting(uint32_t object_instance)
             }
         }
     }
+    Binary_Value_Event_Active_Update(object_instance, pObject);
 #endif /* defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING) \
         */
 }
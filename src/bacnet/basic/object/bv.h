@@ -86,6 +86,9 @@ BACNET_STACK_EXPORT
 bool Binary_Value_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
 BACNET_STACK_EXPORT
+bool Binary_Value_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
+BACNET_STACK_EXPORT
 bool Binary_Value_Change_Of_Value(uint32_t instance);
 BACNET_STACK_EXPORT
 void Binary_Value_Change_Of_Value_Clear(uint32_t instance);
@@ -93,6 +96,9 @@ void Binary_Value_Change_Of_Value_Clear(uint32_t instance);
 BACNET_STACK_EXPORT
 BACNET_BINARY_PV Binary_Value_Present_Value(uint32_t instance);
 BACNET_STACK_EXPORT
+bool Binary_Value_Present_Value_Enumerated(
+    uint32_t object_instance, uint32_t *value);
+BACNET_STACK_EXPORT
 bool Binary_Value_Present_Value_Set(uint32_t instance, BACNET_BINARY_PV value);
 BACNET_STACK_EXPORT
 void Binary_Value_Write_Present_Value_Callback_Set(
@@ -133,8 +139,12 @@ void Binary_Value_Context_Set(uint32_t object_instance, void *context);
 BACNET_STACK_EXPORT
 uint32_t Binary_Value_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+uint32_t Binary_Value_Create_Range(uint32_t object_instance, uint32_t count);
+BACNET_STACK_EXPORT
 bool Binary_Value_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Binary_Value_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Binary_Value_Cleanup(void);
 
 BACNET_STACK_EXPORT
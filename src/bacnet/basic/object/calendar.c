@@ -38,7 +38,10 @@
 struct object_data {
     bool Changed : 1;
     bool Write_Enabled : 1;
+    /* Present_Value holds for Present_Value_Date */
+    bool Present_Value_Valid : 1;
     bool Present_Value;
+    BACNET_DATE Present_Value_Date;
     OS_Keylist Date_List;
     const char *Object_Name;
     const char *Description;
@@ -257,6 +260,8 @@ Calendar_Date_List_Get(uint32_t object_instance, uint8_t index)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         entry = Keylist_Data_Index(pObject->Date_List, index);
+        /* the entry may be changed through the pointer */
+        pObject->Present_Value_Valid = false;
     }
 
     return entry;
@@ -293,6 +298,7 @@ bool Calendar_Date_List_Add(
         free(entry);
         return false;
     }
+    pObject->Present_Value_Valid = false;
 
     return true;
 }
@@ -313,6 +319,7 @@ bool Calendar_Date_List_Delete_All(uint32_t object_instance)
     }
 
     Calendar_Date_List_Clean(pObject->Date_List);
+    pObject->Present_Value_Valid = false;
 
     return true;
 }
@@ -348,13 +355,18 @@ int Calendar_Date_List_Encode(
     uint32_t object_instance, uint8_t *apdu, int max_apdu)
 {
     BACNET_CALENDAR_ENTRY *entry = NULL;
+    struct object_data *pObject;
     int apdu_len = 0;
     unsigned index = 0;
     unsigned size = 0;
 
-    size = Calendar_Date_List_Count(object_instance);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return 0;
+    }
+    size = Keylist_Count(pObject->Date_List);
     for (index = 0; index < size; index++) {
-        entry = Calendar_Date_List_Get(object_instance, index);
+        entry = Keylist_Data_Index(pObject->Date_List, index);
         apdu_len += bacnet_calendar_entry_encode(NULL, entry);
     }
     if (apdu_len > max_apdu) {
@@ -362,15 +374,74 @@ int Calendar_Date_List_Encode(
     }
     apdu_len = 0;
     for (index = 0; index < size; index++) {
-        entry = Calendar_Date_List_Get(object_instance, index);
+        entry = Keylist_Data_Index(pObject->Date_List, index);
         apdu_len += bacnet_calendar_entry_encode(&apdu[apdu_len], entry);
     }
 
     return apdu_len;
 }
 
+/**
+ * @brief Evaluates the Date_List of the object for a date, and keeps
+ *  the result as the present-value for that date
+ * @param  pObject - object data
+ * @param  date - the date to evaluate
+ * @return  present-value of the object
+ */
+static bool
+Calendar_Present_Value_Evaluate(
+    struct object_data *pObject, const BACNET_DATE *date)
+{
+    BACNET_CALENDAR_ENTRY *entry = NULL;
+    unsigned size = 0;
+    unsigned index;
+
+    pObject->Present_Value = false;
+    size = Keylist_Count(pObject->Date_List);
+    for (index = 0; index < size; index++) {
+        entry = Keylist_Data_Index(pObject->Date_List, index);
+        if (bacapp_date_in_calendar_entry(date, entry)) {
+            pObject->Present_Value = true;
+            break;
+        }
+    }
+    datetime_copy_date(&pObject->Present_Value_Date, date);
+    pObject->Present_Value_Valid = true;
+
+    return pObject->Present_Value;
+}
+
+/**
+ * @brief Gets the present-value of the object for today, evaluating
+ *  the Date_List only on a new day or after the Date_List changed
+ * @param  object_instance - object-instance number of the object
+ * @return  present-value of the object
+ */
+static bool Calendar_Present_Value_Today(uint32_t object_instance)
+{
+    BACNET_DATE date;
+    BACNET_TIME time;
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return false;
+    }
+    datetime_local(&date, &time, NULL, NULL);
+    if (pObject->Present_Value_Valid &&
+        datetime_date_same(&date, &pObject->Present_Value_Date)) {
+        return pObject->Present_Value;
+    }
+
+    return Calendar_Present_Value_Evaluate(pObject, &date);
+}
+
 /**
  * For a given object instance-number, determines the present-value
+ * by evaluating the Date_List for today.  ReadProperty uses the value
+ * from the last evaluation until the next day or a Date_List change,
+ * so call this after changing an entry from Calendar_Date_List_Get()
+ * at a later time.
  *
  * @param  object_instance - object-instance number of the object
  *
@@ -380,21 +451,34 @@ bool Calendar_Present_Value(uint32_t object_instance)
 {
     BACNET_DATE date;
     BACNET_TIME time;
-    BACNET_CALENDAR_ENTRY *entry = NULL;
-    unsigned size = 0;
-    int index;
+    struct object_data *pObject;
 
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return false;
+    }
     datetime_local(&date, &time, NULL, NULL);
 
-    size = Calendar_Date_List_Count(object_instance);
-    for (index = 0; index < size; index++) {
-        entry = Calendar_Date_List_Get(object_instance, index);
-        if (bacapp_date_in_calendar_entry(&date, entry)) {
-            return true;
-        }
+    return Calendar_Present_Value_Evaluate(pObject, &date);
+}
+
+/**
+ * @brief For a given object instance-number, reads the present-value
+ *  without encoding it, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  value - [out] the present-value
+ * @return  true if the object instance exists
+ */
+bool Calendar_Present_Value_Boolean(uint32_t object_instance, bool *value)
+{
+    if (!Calendar_Valid_Instance(object_instance)) {
+        return false;
+    }
+    if (value) {
+        *value = Calendar_Present_Value(object_instance);
     }
 
-    return false;
+    return true;
 }
 
 /**
@@ -557,7 +641,7 @@ int Calendar_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 encode_application_enumerated(&apdu[0], rpdata->object_type);
             break;
         case PROP_PRESENT_VALUE:
-            value = Calendar_Present_Value(rpdata->object_instance);
+            value = Calendar_Present_Value_Today(rpdata->object_instance);
             apdu_len = encode_application_boolean(apdu, value);
             break;
         case PROP_DATE_LIST:
@@ -610,7 +694,7 @@ bool Calendar_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     }
     switch (wp_data->object_property) {
         case PROP_DATE_LIST:
-            pv_old = Calendar_Present_Value(wp_data->object_instance);
+            pv_old = Calendar_Present_Value_Today(wp_data->object_instance);
             Calendar_Date_List_Delete_All(wp_data->object_instance);
             iOffset = 0;
             /* decode all packed */
@@ -769,6 +853,7 @@ uint32_t Calendar_Create(uint32_t object_instance)
         pObject->Description = NULL;
         pObject->Present_Value = false;
         pObject->Date_List = Keylist_Create();
+        pObject->Present_Value_Valid = false;
         pObject->Changed = false;
         pObject->Write_Enabled = false;
         /* add to list */
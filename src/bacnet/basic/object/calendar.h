@@ -66,6 +66,8 @@ bool Calendar_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
 BACNET_STACK_EXPORT
 bool Calendar_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Calendar_Present_Value_Boolean(uint32_t object_instance, bool *value);
+BACNET_STACK_EXPORT
 void Calendar_Write_Present_Value_Callback_Set(
     calendar_write_present_value_callback cb);
 
@@ -22,6 +22,7 @@
 #include "bacnet/property.h"
 #include "bacnet/bactext.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keyhash.h"
 #include "bacnet/basic/sys/keylist.h"
 #if defined(CHANNEL_LIGHTING_COMMAND) || defined(CHANNEL_COLOR_COMMAND)
 #include "bacnet/lighting.h"
@@ -59,6 +60,15 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* Index from a control group and channel number to the instance of each
+   Channel that is a member of the group, so that a WriteGroup-Request
+   only visits the channels it targets */
+static OS_Keyhash Group_Indexes[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Group_Index (Group_Indexes[Routed_Device_Object_Index()])
+#else
+#define Group_Index (Group_Indexes[0])
+#endif
 /* Internal write property callback */
 static write_property_function Write_Property_Internal_Callback;
 /* Write Property notification callbacks for logging or other purposes */
@@ -291,6 +301,87 @@ uint16_t Channel_Number(uint32_t object_instance)
     return value;
 }
 
+/**
+ * @brief Compute the hash of a control group and a channel number
+ * @param group_number - control group number 1..4294967295
+ * @param channel_number - channel number 0..65535
+ * @return hash value
+ */
+static uint32_t
+Channel_Group_Hash(uint32_t group_number, uint16_t channel_number)
+{
+    uint8_t data[6];
+
+    (void)encode_unsigned32(&data[0], group_number);
+    (void)encode_unsigned16(&data[4], channel_number);
+
+    return Keyhash_FNV1a(data, sizeof(data));
+}
+
+/**
+ * @brief Add or remove the control groups of a Channel in the group index.
+ *  A group that is in more than one element is indexed once.
+ * @param pObject - object data of the Channel
+ * @param object_instance - object-instance number of the Channel
+ * @param add - true to add the groups, false to remove them
+ */
+static void Channel_Group_Index_Update(
+    struct object_data *pObject, uint32_t object_instance, bool add)
+{
+    unsigned g, i;
+    uint32_t group_number, hash;
+    bool duplicate;
+
+    if (add && !Group_Index) {
+        Group_Index = Keyhash_Create();
+    }
+    if (!Group_Index) {
+        return;
+    }
+    for (g = 0; g < CONTROL_GROUPS_MAX; g++) {
+        group_number = pObject->Control_Groups[g];
+        if (group_number == 0) {
+            continue;
+        }
+        duplicate = false;
+        for (i = 0; i < g; i++) {
+            if (pObject->Control_Groups[i] == group_number) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) {
+            continue;
+        }
+        hash = Channel_Group_Hash(group_number, pObject->Channel_Number);
+        if (add) {
+            (void)Keyhash_Add(Group_Index, hash, object_instance);
+        } else {
+            (void)Keyhash_Remove(Group_Index, hash, object_instance);
+        }
+    }
+}
+
+/**
+ * @brief Determine if a Channel is a member of a control group
+ * @param pObject - object data of the Channel
+ * @param group_number - control group number
+ * @return true if one of the Control_Groups elements is the group
+ */
+static bool
+Channel_Control_Group_Member(struct object_data *pObject, uint32_t group_number)
+{
+    unsigned g;
+
+    for (g = 0; g < CONTROL_GROUPS_MAX; g++) {
+        if (pObject->Control_Groups[g] == group_number) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /**
  * For a given object instance-number, sets the channel-number
  * property value
@@ -307,7 +398,9 @@ bool Channel_Number_Set(uint32_t object_instance, uint16_t value)
 
     pObject = Object_Data(object_instance);
     if (pObject) {
+        Channel_Group_Index_Update(pObject, object_instance, false);
         pObject->Channel_Number = value;
+        Channel_Group_Index_Update(pObject, object_instance, true);
         status = true;
     }
 
@@ -532,20 +625,27 @@ Channel_Control_Groups_Element(uint32_t object_instance, int32_t array_index)
 
 /**
  * @brief Write the object property member value
+ * @param pObject - object data of the Channel
+ * @param object_instance - object-instance number of the Channel
  * @param array_index - 1-based array index
  * @param value - control group value 0..65535
  *
  * @return true if parameters are value and control group is set
  */
 static bool Control_Groups_Element_Set(
-    struct object_data *pObject, int32_t array_index, uint16_t value)
+    struct object_data *pObject,
+    uint32_t object_instance,
+    int32_t array_index,
+    uint16_t value)
 {
     bool status = false;
 
     if (pObject) {
         if ((array_index > 0) && (array_index <= CONTROL_GROUPS_MAX)) {
             array_index--;
+            Channel_Group_Index_Update(pObject, object_instance, false);
             pObject->Control_Groups[array_index] = value;
+            Channel_Group_Index_Update(pObject, object_instance, true);
             status = true;
         }
     }
@@ -570,7 +670,8 @@ bool Channel_Control_Groups_Element_Set(
 
     pObject = Object_Data(object_instance);
     if (pObject) {
-        status = Control_Groups_Element_Set(pObject, array_index, value);
+        status = Control_Groups_Element_Set(
+            pObject, object_instance, array_index, value);
     }
 
     return status;
@@ -603,6 +704,55 @@ static int Channel_Control_Groups_Element_Encode(
     return apdu_len;
 }
 
+/**
+ * @brief Determine the datatype a member property takes the channel value in
+ * @param  wp_data - the object type, property and array index of the member
+ * @return the application tag to coerce the channel value into, or
+ *  MAX_BACNET_APPLICATION_TAG if the channel value is not coerced
+ */
+static BACNET_APPLICATION_TAG
+Channel_Member_Coerce_Tag(const BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    bool present_value;
+
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        return MAX_BACNET_APPLICATION_TAG;
+    }
+    present_value = (wp_data->object_property == PROP_PRESENT_VALUE) ||
+        (wp_data->object_property == PROP_RELINQUISH_DEFAULT);
+    switch (wp_data->object_type) {
+        case OBJECT_ANALOG_OUTPUT:
+        case OBJECT_ANALOG_VALUE:
+        case OBJECT_LIGHTING_OUTPUT:
+            if (present_value) {
+                return BACNET_APPLICATION_TAG_REAL;
+            }
+            break;
+        case OBJECT_BINARY_OUTPUT:
+        case OBJECT_BINARY_VALUE:
+            if (present_value) {
+                return BACNET_APPLICATION_TAG_ENUMERATED;
+            }
+            break;
+        case OBJECT_MULTI_STATE_OUTPUT:
+        case OBJECT_MULTI_STATE_VALUE:
+            if (present_value) {
+                return BACNET_APPLICATION_TAG_UNSIGNED_INT;
+            }
+            break;
+        case OBJECT_COLOR_TEMPERATURE:
+            if ((wp_data->object_property == PROP_PRESENT_VALUE) ||
+                (wp_data->object_property == PROP_DEFAULT_COLOR_TEMPERATURE)) {
+                return BACNET_APPLICATION_TAG_UNSIGNED_INT;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return MAX_BACNET_APPLICATION_TAG;
+}
+
 /**
  * For a given object instance-number, sets the present-value at a given
  * priority 1..16.
@@ -617,68 +767,15 @@ bool Channel_Write_Member_Value(
 {
     bool status = false;
     int apdu_len = 0;
+    BACNET_APPLICATION_TAG tag;
 
     if (wp_data && value) {
-        if (((wp_data->object_type == OBJECT_ANALOG_OUTPUT) ||
-             (wp_data->object_type == OBJECT_ANALOG_VALUE)) &&
-            ((wp_data->object_property == PROP_PRESENT_VALUE) ||
-             (wp_data->object_property == PROP_RELINQUISH_DEFAULT)) &&
-            (wp_data->array_index == BACNET_ARRAY_ALL)) {
-            apdu_len = bacnet_channel_value_coerce_data_encode(
-                wp_data->application_data, wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_REAL);
-            if (apdu_len != BACNET_STATUS_ERROR) {
-                wp_data->application_data_len = apdu_len;
-                status = true;
-            }
-        } else if (
-            ((wp_data->object_type == OBJECT_BINARY_OUTPUT) ||
-             (wp_data->object_type == OBJECT_BINARY_VALUE)) &&
-            ((wp_data->object_property == PROP_PRESENT_VALUE) ||
-             (wp_data->object_property == PROP_RELINQUISH_DEFAULT)) &&
-            (wp_data->array_index == BACNET_ARRAY_ALL)) {
-            apdu_len = bacnet_channel_value_coerce_data_encode(
-                wp_data->application_data, wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_ENUMERATED);
-            if (apdu_len != BACNET_STATUS_ERROR) {
-                wp_data->application_data_len = apdu_len;
-                status = true;
-            }
-        } else if (
-            ((wp_data->object_type == OBJECT_MULTI_STATE_OUTPUT) ||
-             (wp_data->object_type == OBJECT_MULTI_STATE_VALUE)) &&
-            ((wp_data->object_property == PROP_PRESENT_VALUE) ||
-             (wp_data->object_property == PROP_RELINQUISH_DEFAULT)) &&
-            (wp_data->array_index == BACNET_ARRAY_ALL)) {
-            apdu_len = bacnet_channel_value_coerce_data_encode(
-                wp_data->application_data, wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_UNSIGNED_INT);
-            if (apdu_len != BACNET_STATUS_ERROR) {
-                wp_data->application_data_len = apdu_len;
-                status = true;
-            }
-        } else if (
-            (wp_data->object_type == OBJECT_LIGHTING_OUTPUT) &&
-            ((wp_data->object_property == PROP_PRESENT_VALUE) ||
-             (wp_data->object_property == PROP_RELINQUISH_DEFAULT)) &&
-            (wp_data->array_index == BACNET_ARRAY_ALL)) {
+        tag = Channel_Member_Coerce_Tag(wp_data);
+        if (tag < MAX_BACNET_APPLICATION_TAG) {
             apdu_len = bacnet_channel_value_coerce_data_encode(
                 wp_data->application_data, wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_REAL);
+                tag);
             if (apdu_len != BACNET_STATUS_ERROR) {
-                wp_data->application_data_len = apdu_len;
-                status = true;
-            }
-        } else if (
-            (wp_data->object_type == OBJECT_COLOR_TEMPERATURE) &&
-            ((wp_data->object_property == PROP_PRESENT_VALUE) ||
-             (wp_data->object_property == PROP_DEFAULT_COLOR_TEMPERATURE)) &&
-            (wp_data->array_index == BACNET_ARRAY_ALL)) {
-            apdu_len = bacnet_channel_value_coerce_data_encode(
-                wp_data->application_data, wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_UNSIGNED_INT);
-            if (apdu_len != BACNET_STATUS_ERROR) {
-                wp_data->application_data_len = apdu_len;
                 status = true;
             }
         } else {
@@ -687,10 +784,12 @@ bool Channel_Write_Member_Value(
                 wp_data->application_data, wp_data->application_data_len,
                 value);
             if (apdu_len > 0) {
-                wp_data->application_data_len = apdu_len;
                 status = true;
             }
         }
+        if (status) {
+            wp_data->application_data_len = apdu_len;
+        }
     }
 
     return status;
@@ -716,6 +815,9 @@ static bool Channel_Write_Members(
     bool status = false;
     unsigned m = 0;
     const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember = NULL;
+    BACNET_APPLICATION_TAG tag, encoded_tag = MAX_BACNET_APPLICATION_TAG;
+    bool encoded = false;
+    int encoded_len = 0;
 
     if (pObject && value) {
         pObject->Write_Status = BACNET_WRITE_STATUS_IN_PROGRESS;
@@ -740,8 +842,20 @@ static bool Channel_Write_Members(
                 wp_data.error_class = ERROR_CLASS_PROPERTY;
                 wp_data.error_code = ERROR_CODE_SUCCESS;
                 wp_data.priority = priority;
-                wp_data.application_data_len = sizeof(wp_data.application_data);
-                status = Channel_Write_Member_Value(&wp_data, value);
+                tag = Channel_Member_Coerce_Tag(&wp_data);
+                if (encoded && (tag == encoded_tag)) {
+                    /* same datatype as the previous member: the value
+                       is already encoded in the application data */
+                    wp_data.application_data_len = encoded_len;
+                    status = true;
+                } else {
+                    wp_data.application_data_len =
+                        sizeof(wp_data.application_data);
+                    status = Channel_Write_Member_Value(&wp_data, value);
+                    encoded = status;
+                    encoded_tag = tag;
+                    encoded_len = wp_data.application_data_len;
+                }
                 if (status) {
                     debug_printf(
                         "channel[%lu].Channel_Write_Member[%u] coerced\n",
@@ -1233,7 +1347,8 @@ static BACNET_ERROR_CODE Channel_Control_Groups_Write(
                     if (value.type.Unsigned_Int <= UINT16_MAX) {
                         control_group = (uint16_t)value.type.Unsigned_Int;
                         status = Control_Groups_Element_Set(
-                            pObject, array_index, control_group);
+                            pObject, object_instance, array_index,
+                            control_group);
                         if (status) {
                             error_code = ERROR_CODE_SUCCESS;
                         } else {
@@ -1359,48 +1474,45 @@ void Channel_Write_Group(
     BACNET_GROUP_CHANNEL_VALUE *change_list)
 {
     struct object_data *pObject;
-    unsigned count, g, priority;
-    uint32_t instance;
-    int index;
+    unsigned priority, iterator = 0;
+    uint32_t hash;
+    KEY instance;
     bool status = false, found = false;
 
     if (!data || !change_list) {
         return;
     }
     (void)change_list_index;
-    /* iterate through all channels to find
+    /* look up the channels with
        a) matching group number, and
        b) matching channel number
-       Then write the value to the channel */
-    count = Keylist_Count(Object_List);
-    for (index = 0; index < count; index++) {
-        pObject = Keylist_Data_Index(Object_List, index);
+       in the group index, and confirm them since different groups and
+       channels may share a hash.  Then write the value to the channel */
+    hash = Channel_Group_Hash(data->group_number, change_list->channel);
+    while (Keyhash_Find(Group_Index, hash, &iterator, &instance)) {
+        pObject = Object_Data(instance);
         if (!pObject) {
             continue;
         }
-        instance = Channel_Index_To_Instance(index);
-        for (g = 0; g < CONTROL_GROUPS_MAX; g++) {
-            if (pObject->Control_Groups[g] == 0) {
-                continue;
-            }
-            if ((pObject->Control_Groups[g] == data->group_number) &&
-                (pObject->Channel_Number == change_list->channel)) {
-                priority = change_list->overriding_priority;
-                if ((priority > BACNET_MAX_PRIORITY) ||
-                    (priority < BACNET_MIN_PRIORITY)) {
-                    priority = data->write_priority;
-                }
-                /* note: inhibit delay is ignored because this
-                   implementation does not support the execution-delay
-                   property */
-                status = Channel_Write_Members(
-                    pObject, instance, &change_list->value, priority);
-                if (status) {
-                    pObject->Last_Priority = priority;
-                }
-                found = true;
-            }
+        if ((data->group_number == 0) ||
+            (pObject->Channel_Number != change_list->channel) ||
+            !Channel_Control_Group_Member(pObject, data->group_number)) {
+            continue;
+        }
+        priority = change_list->overriding_priority;
+        if ((priority > BACNET_MAX_PRIORITY) ||
+            (priority < BACNET_MIN_PRIORITY)) {
+            priority = data->write_priority;
+        }
+        /* note: inhibit delay is ignored because this
+           implementation does not support the execution-delay
+           property */
+        status = Channel_Write_Members(
+            pObject, instance, &change_list->value, priority);
+        if (status) {
+            pObject->Last_Priority = priority;
         }
+        found = true;
     }
     if (!found) {
         debug_printf(
@@ -1561,6 +1673,7 @@ bool Channel_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
+        Channel_Group_Index_Update(pObject, object_instance, false);
         free(pObject);
         status = true;
     }
@@ -1593,6 +1706,8 @@ void Channel_Cleanup(void)
             Keylist_Delete(Object_List);
             Object_List = NULL;
         }
+        Keyhash_Delete(Group_Index);
+        Group_Index = NULL;
     }
 
 #ifdef BAC_ROUTING
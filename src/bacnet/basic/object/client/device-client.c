@@ -111,7 +111,12 @@ static object_functions_t Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Device_Writable_Property_List },
+      Device_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #if (BACNET_PROTOCOL_REVISION >= 17)
     { OBJECT_NETWORK_PORT,
       Network_Port_Init,
@@ -133,7 +138,12 @@ static object_functions_t Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Network_Port_Writable_Property_List },
+      Network_Port_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(BACFILE)
     { OBJECT_FILE,
@@ -156,7 +166,12 @@ static object_functions_t Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      BACfile_Writable_Property_List },
+      BACfile_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
     { MAX_BACNET_OBJECT_TYPE,
       NULL /* Init */,
@@ -178,7 +193,12 @@ static object_functions_t Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      NULL /* Writable_Property_List */ },
+      NULL /* Writable_Property_List */,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 };
 
 /** Glue function to let the Device object, when called by a handler,
@@ -950,6 +970,24 @@ bool Device_Valid_Object_Id(
     return status;
 }
 
+/** Looks up the requested Object to see if the functionality is supported.
+ * @ingroup ObjHelpers
+ * @param [in] The object type to be looked up.
+ * @return True if the object instance supports this feature.
+ */
+bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
+{
+    bool status = false;
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if ((pObject != NULL) && (pObject->Object_Value_List != NULL)) {
+        status = true;
+    }
+
+    return status;
+}
+
 /** Copy a child object's object_name value, given its ID.
  * @param object_type [in] The BACNET_OBJECT_TYPE of the child Object.
  * @param object_instance [in] The object instance number of the child Object.
@@ -1155,13 +1193,8 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
         case PROP_PROTOCOL_SERVICES_SUPPORTED:
             /* Note: list of services that are executed, not initiated. */
-            bitstring_init(&bit_string);
-            for (i = 0; i < MAX_BACNET_SERVICES_SUPPORTED; i++) {
-                /* automatic lookup based on handlers set */
-                bitstring_set_bit(
-                    &bit_string, (uint8_t)i,
-                    apdu_service_supported((BACNET_SERVICES_SUPPORTED)i));
-            }
+            /* automatic lookup based on handlers set */
+            apdu_services_supported(&bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_PROTOCOL_OBJECT_TYPES_SUPPORTED:
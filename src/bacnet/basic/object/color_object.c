@@ -29,6 +29,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/slab.h"
 #include "bacnet/basic/sys/linear.h"
 /* me! */
 #include "bacnet/basic/object/color_object.h"
@@ -64,8 +65,13 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* memory pool for the object data */
+static SLAB_TYPE Object_Slab = SLAB_ACCOUNT_INITIALIZER(
+    sizeof(struct object_data), MEMSTAT_ACCOUNT_OBJECT(OBJECT_COLOR));
 /* callback for present value writes */
 static color_write_present_value_callback Color_Write_Present_Value_Callback;
+/* callback for tracking the objects with a color command in progress */
+static color_active_callback Color_Active_Callback;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Color_Properties_Required[] = {
@@ -194,6 +200,29 @@ unsigned Color_Instance_To_Index(uint32_t object_instance)
     return Keylist_Index(Object_List, object_instance);
 }
 
+/**
+ * @brief Tells the active callback whether the color command of the
+ *  object has a fade in progress
+ * @param object_instance - object-instance number of the object
+ * @param pObject [in] object data
+ */
+static void
+Color_Active_Update(uint32_t object_instance, const struct object_data *pObject)
+{
+    bool active = true;
+
+    if (!Color_Active_Callback) {
+        return;
+    }
+    if ((pObject->Color_Command.operation !=
+         BACNET_COLOR_OPERATION_FADE_TO_COLOR) &&
+        (pObject->In_Progress == BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE)) {
+        /* nothing to do until the next color command */
+        active = false;
+    }
+    Color_Active_Callback(object_instance, active);
+}
+
 /**
  * For a given object instance-number, determines the present-value
  *
@@ -272,6 +301,7 @@ static bool Color_Present_Value_Write(
         }
         pObject->Color_Command.operation = BACNET_COLOR_OPERATION_FADE_TO_COLOR;
         xy_color_copy(&pObject->Color_Command.target.color, value);
+        Color_Active_Update(object_instance, pObject);
         status = true;
     } else {
         *error_class = ERROR_CLASS_OBJECT;
@@ -362,6 +392,7 @@ bool Color_Command_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && value) {
         color_command_copy(&pObject->Color_Command, value);
+        Color_Active_Update(object_instance, pObject);
         status = true;
     }
 
@@ -394,6 +425,7 @@ static bool Color_Command_Write(
         (void)priority;
         if (pObject->Write_Enabled) {
             color_command_copy(&pObject->Color_Command, value);
+            Color_Active_Update(object_instance, pObject);
             status = true;
         } else {
             *error_class = ERROR_CLASS_PROPERTY;
@@ -444,6 +476,7 @@ bool Color_In_Progress_Set(
     if (pObject) {
         if (value < BACNET_COLOR_OPERATION_IN_PROGRESS_MAX) {
             pObject->In_Progress = value;
+            Color_Active_Update(object_instance, pObject);
             status = true;
         }
     }
@@ -921,6 +954,7 @@ void Color_Timer(uint32_t object_instance, uint16_t milliseconds)
             default:
                 break;
         }
+        Color_Active_Update(object_instance, pObject);
     }
 }
 
@@ -1118,6 +1152,17 @@ void Color_Write_Present_Value_Callback_Set(
     Color_Write_Present_Value_Callback = cb;
 }
 
+/**
+ * @brief Sets a callback told when a color command starts or ends,
+ *  so that only the objects with a color command in progress need
+ *  Color_Timer()
+ * @param cb - callback used to track the active objects
+ */
+void Color_Active_Callback_Set(color_active_callback cb)
+{
+    Color_Active_Callback = cb;
+}
+
 /**
  * @brief Determines a object write-enabled flag state
  * @param object_instance - object-instance number of the object
@@ -1221,7 +1266,7 @@ uint32_t Color_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Slab_Item_Alloc(&Object_Slab);
         if (pObject) {
             pObject->Object_Name = NULL;
             /* color defaults */
@@ -1244,9 +1289,11 @@ uint32_t Color_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Slab_Free(&Object_Slab, pObject);
                 return BACNET_MAX_INSTANCE;
             }
+            /* the fade to the default color */
+            Color_Active_Update(object_instance, pObject);
         } else {
             return BACNET_MAX_INSTANCE;
         }
@@ -1267,13 +1314,28 @@ bool Color_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        if (Color_Active_Callback) {
+            Color_Active_Callback(object_instance, false);
+        }
+        Slab_Free(&Object_Slab, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Reserves pool memory for Color objects, see Slab_Reserve()
+ * @param count - number of objects to reserve memory for
+ * @return true if the memory was reserved
+ */
+bool Color_Pool_Reserve(uint32_t count)
+{
+    Slab_Retain_Set(&Object_Slab, true);
+
+    return Slab_Reserve(&Object_Slab, count);
+}
+
 /**
  * Deletes all the Colors and their data
  */
@@ -1293,7 +1355,7 @@ void Color_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
-                    free(pObject);
+                    Slab_Free(&Object_Slab, pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
@@ -1301,6 +1363,7 @@ void Color_Cleanup(void)
         }
     }
 
+    Slab_Cleanup(&Object_Slab);
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
 #endif
@@ -29,6 +29,14 @@ typedef void (*color_write_present_value_callback)(
     BACNET_XY_COLOR *old_value,
     BACNET_XY_COLOR *value);
 
+/**
+ * @brief Callback for tracking which Color objects have a fade in
+ *  progress, so that only those need to be given the elapsed time
+ * @param  object_instance - object instance number
+ * @param  active - true while the color command is in progress
+ */
+typedef void (*color_active_callback)(uint32_t object_instance, bool active);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -73,6 +81,8 @@ bool Color_Present_Value(uint32_t object_instance, BACNET_XY_COLOR *value);
 BACNET_STACK_EXPORT
 void Color_Write_Present_Value_Callback_Set(
     color_write_present_value_callback cb);
+BACNET_STACK_EXPORT
+void Color_Active_Callback_Set(color_active_callback cb);
 
 BACNET_STACK_EXPORT
 bool Color_Tracking_Value_Set(
@@ -134,6 +144,8 @@ uint32_t Color_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
 bool Color_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Color_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Color_Cleanup(void);
 BACNET_STACK_EXPORT
 void Color_Init(void);
@@ -62,6 +62,8 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 /* callback for present value writes */
 static color_temperature_write_present_value_callback
     Color_Temperature_Write_Present_Value_Callback;
+/* callback for tracking the objects with a color command in progress */
+static color_temperature_active_callback Color_Temperature_Active_Callback;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Color_Temperature_Properties_Required[] = {
@@ -204,6 +206,35 @@ unsigned Color_Temperature_Instance_To_Index(uint32_t object_instance)
     return Keylist_Index(Object_List, object_instance);
 }
 
+/**
+ * @brief Tells the active callback whether the color command of the
+ *  object has a fade, ramp or step in progress
+ * @param object_instance - object-instance number of the object
+ * @param pObject [in] object data
+ */
+static void Color_Temperature_Active_Update(
+    uint32_t object_instance, const struct object_data *pObject)
+{
+    bool active;
+
+    if (!Color_Temperature_Active_Callback) {
+        return;
+    }
+    /* once idle, nothing to do until the next color command */
+    active = (pObject->In_Progress != BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE);
+    switch (pObject->Color_Command.operation) {
+        case BACNET_COLOR_OPERATION_FADE_TO_CCT:
+        case BACNET_COLOR_OPERATION_RAMP_TO_CCT:
+        case BACNET_COLOR_OPERATION_STEP_UP_CCT:
+        case BACNET_COLOR_OPERATION_STEP_DOWN_CCT:
+            active = true;
+            break;
+        default:
+            break;
+    }
+    Color_Temperature_Active_Callback(object_instance, active);
+}
+
 /**
  * For a given object instance-number, determines the present-value
  *
@@ -290,6 +321,7 @@ static bool Color_Temperature_Present_Value_Write(
                     BACNET_COLOR_OPERATION_FADE_TO_CCT;
             }
             pObject->Color_Command.target.color_temperature = value;
+            Color_Temperature_Active_Update(object_instance, pObject);
             status = true;
         } else {
             *error_class = ERROR_CLASS_PROPERTY;
@@ -468,6 +500,7 @@ bool Color_Temperature_Command_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && value) {
         color_command_copy(&pObject->Color_Command, value);
+        Color_Temperature_Active_Update(object_instance, pObject);
         status = true;
     }
 
@@ -512,6 +545,7 @@ bool Color_Temperature_In_Progress_Set(
     if (pObject) {
         if (value < BACNET_COLOR_OPERATION_IN_PROGRESS_MAX) {
             pObject->In_Progress = value;
+            Color_Temperature_Active_Update(object_instance, pObject);
             status = true;
         }
     }
@@ -1335,6 +1369,7 @@ void Color_Temperature_Timer(uint32_t object_instance, uint16_t milliseconds)
                 pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
                 break;
         }
+        Color_Temperature_Active_Update(object_instance, pObject);
     }
 }
 
@@ -1568,6 +1603,18 @@ void Color_Temperature_Write_Present_Value_Callback_Set(
     Color_Temperature_Write_Present_Value_Callback = cb;
 }
 
+/**
+ * @brief Sets a callback told when a color command starts or ends,
+ *  so that only the objects with a color command in progress need
+ *  Color_Temperature_Timer()
+ * @param cb - callback used to track the active objects
+ */
+void Color_Temperature_Active_Callback_Set(
+    color_temperature_active_callback cb)
+{
+    Color_Temperature_Active_Callback = cb;
+}
+
 /**
  * @brief Determines a object write-enabled flag state
  * @param object_instance - object-instance number of the object
@@ -1699,6 +1746,8 @@ uint32_t Color_Temperature_Create(uint32_t object_instance)
                 free(pObject);
                 return BACNET_MAX_INSTANCE;
             }
+            /* the fade to the default color temperature */
+            Color_Temperature_Active_Update(object_instance, pObject);
         } else {
             return BACNET_MAX_INSTANCE;
         }
@@ -1719,6 +1768,9 @@ bool Color_Temperature_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
+        if (Color_Temperature_Active_Callback) {
+            Color_Temperature_Active_Callback(object_instance, false);
+        }
         free(pObject);
         status = true;
     }
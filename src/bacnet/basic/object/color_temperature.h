@@ -25,6 +25,16 @@
 typedef void (*color_temperature_write_present_value_callback)(
     uint32_t object_instance, uint32_t old_value, uint32_t value);
 
+/**
+ * @brief Callback for tracking which Color Temperature objects have a fade,
+ *  ramp or step in progress, so that only those need to be given the
+ *  elapsed time
+ * @param  object_instance - object instance number
+ * @param  active - true while the color command is in progress
+ */
+typedef void (*color_temperature_active_callback)(
+    uint32_t object_instance, bool active);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -69,6 +79,9 @@ uint32_t Color_Temperature_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Color_Temperature_Write_Present_Value_Callback_Set(
     color_temperature_write_present_value_callback cb);
+BACNET_STACK_EXPORT
+void Color_Temperature_Active_Callback_Set(
+    color_temperature_active_callback cb);
 
 BACNET_STACK_EXPORT
 bool Color_Temperature_Tracking_Value_Set(
@@ -39,6 +39,10 @@ static COMMAND_DESCR Command_Descrs[MAX_NUM_DEVICES][MAX_COMMANDS];
 #else
 #define Command_Descr (Command_Descrs[0])
 #endif
+/* writes the actions of the action lists */
+static command_action_write_callback Command_Action_Write_Callback;
+/* number of action writes that a command may have in process at once */
+static unsigned Command_Action_Writes_Limit = COMMAND_ACTION_WRITES_MAX;
 
 /* These arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Command_Properties_Required[] = {
@@ -129,6 +133,11 @@ void Command_Init(void)
             Command_Descr[i].In_Process = false;
             Command_Descr[i].All_Writes_Successful =
                 true; /* Optimistic default */
+            Command_Descr[i].Action_Next = NULL;
+            Command_Descr[i].Action_Writes_Pending = 0;
+            Command_Descr[i].Action_Delay_Milliseconds = 0;
+            Command_Descr[i].Action_Delay = false;
+            Command_Descr[i].Action_Issuing = false;
         }
     }
 
@@ -394,6 +403,169 @@ unsigned Command_Action_List_Count(uint32_t instance)
     return MAX_COMMAND_ACTIONS;
 }
 
+/**
+ * @brief Set the callback used to write the actions of the action lists
+ * @param cb [in] write callback, or NULL to fail every action write
+ */
+void Command_Action_Write_Callback_Set(command_action_write_callback cb)
+{
+    Command_Action_Write_Callback = cb;
+}
+
+/**
+ * @brief Set the number of action writes that a command may have in process
+ *  at once. Actions up to the next Post_Delay are started together, and
+ *  the order of their completion is not defined.
+ * @param count [in] number of writes, where 0 and 1 write the actions
+ *  one after the other
+ */
+void Command_Action_Writes_Max_Set(unsigned count)
+{
+    if (count == 0) {
+        count = 1;
+    }
+    Command_Action_Writes_Limit = count;
+}
+
+/**
+ * @brief Get the number of action writes that a command may have in process
+ * @return number of writes
+ */
+unsigned Command_Action_Writes_Max(void)
+{
+    return Command_Action_Writes_Limit;
+}
+
+/**
+ * @brief Records the result of an action write
+ * @param pObject [in] object data
+ * @param action [in] the action entry that was written
+ * @param success [in] true if the write was successful
+ */
+static void Command_Action_Complete(
+    COMMAND_DESCR *pObject, BACNET_ACTION_LIST *action, bool success)
+{
+    action->Write_Successful = success;
+    if (pObject->Action_Writes_Pending > 0) {
+        pObject->Action_Writes_Pending--;
+    }
+    if (!success) {
+        pObject->All_Writes_Successful = false;
+        if (action->Quit_On_Failure) {
+            /* the actions that were not started are never written */
+            pObject->Action_Next = NULL;
+            pObject->Action_Delay = false;
+        }
+    }
+}
+
+/**
+ * @brief Starts the action writes that may be in process, and ends the
+ *  action list once all of its writes are done
+ * @param object_instance [in] object-instance number of the object
+ * @param pObject [in] object data
+ */
+static void Command_Action_Process(
+    uint32_t object_instance, COMMAND_DESCR *pObject)
+{
+    BACNET_ACTION_LIST *action;
+
+    if (pObject->Action_Issuing) {
+        /* write results reported from the write callback */
+        return;
+    }
+    pObject->Action_Issuing = true;
+    while (pObject->Action_Next && !pObject->Action_Delay &&
+           (pObject->Action_Writes_Pending < Command_Action_Writes_Limit)) {
+        action = pObject->Action_Next;
+        pObject->Action_Next = action->next;
+        if ((action->Post_Delay > 0) && (action->Post_Delay != UINT32_MAX)) {
+            /* the next actions wait for this one and the delay */
+            pObject->Action_Delay = true;
+            pObject->Action_Delay_Milliseconds = action->Post_Delay * 1000UL;
+        }
+        action->Write_Successful = false;
+        pObject->Action_Writes_Pending++;
+        if (!Command_Action_Write_Callback ||
+            !Command_Action_Write_Callback(object_instance, action)) {
+            Command_Action_Complete(pObject, action, false);
+        }
+    }
+    pObject->Action_Issuing = false;
+    if (!pObject->Action_Next && (pObject->Action_Writes_Pending == 0)) {
+        pObject->Action_Delay = false;
+        pObject->In_Process = false;
+    }
+}
+
+/**
+ * @brief Starts the writes of an action list
+ * @param object_instance [in] object-instance number of the object
+ * @param pObject [in] object data
+ * @param value [in] the action list number, where 0 is no action
+ */
+static void Command_Action_Start(
+    uint32_t object_instance, COMMAND_DESCR *pObject, uint32_t value)
+{
+    if ((value == 0) || (value > MAX_COMMAND_ACTIONS)) {
+        return;
+    }
+    pObject->In_Process = true;
+    pObject->All_Writes_Successful = true;
+    pObject->Action_Next = &pObject->Action[value - 1];
+    pObject->Action_Writes_Pending = 0;
+    pObject->Action_Delay = false;
+    Command_Action_Process(object_instance, pObject);
+}
+
+/**
+ * @brief Reports the result of an action write that was started by
+ *  the write callback
+ * @param object_instance [in] object-instance number of the object
+ * @param action [in] the action entry that was written
+ * @param success [in] true if the write was successful
+ * @return true if the object was in process and the result was recorded
+ */
+bool Command_Action_Write_Result(
+    uint32_t object_instance, BACNET_ACTION_LIST *action, bool success)
+{
+    COMMAND_DESCR *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject || !action || !pObject->In_Process ||
+        (pObject->Action_Writes_Pending == 0)) {
+        return false;
+    }
+    Command_Action_Complete(pObject, action, success);
+    Command_Action_Process(object_instance, pObject);
+
+    return true;
+}
+
+/**
+ * @brief Updates the Post_Delay of the action list in process
+ * @param object_instance [in] object-instance number of the object
+ * @param milliseconds [in] number of milliseconds elapsed
+ */
+void Command_Timer(uint32_t object_instance, uint16_t milliseconds)
+{
+    COMMAND_DESCR *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject || !pObject->In_Process || !pObject->Action_Delay ||
+        (pObject->Action_Writes_Pending > 0)) {
+        /* the delay starts once the earlier writes are done */
+        return;
+    }
+    if (pObject->Action_Delay_Milliseconds > milliseconds) {
+        pObject->Action_Delay_Milliseconds -= milliseconds;
+    } else {
+        pObject->Action_Delay_Milliseconds = 0;
+        pObject->Action_Delay = false;
+        Command_Action_Process(object_instance, pObject);
+    }
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -528,13 +700,21 @@ bool Command_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             status = write_property_type_valid(
                 wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
             if (status) {
-                if (value.type.Unsigned_Int >= MAX_COMMAND_ACTIONS) {
+                if (value.type.Unsigned_Int > MAX_COMMAND_ACTIONS) {
                     wp_data->error_class = ERROR_CLASS_PROPERTY;
                     wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
                     return false;
                 }
+                if (Command_Descr[object_index].In_Process) {
+                    wp_data->error_class = ERROR_CLASS_OBJECT;
+                    wp_data->error_code = ERROR_CODE_BUSY;
+                    return false;
+                }
                 Command_Present_Value_Set(
                     wp_data->object_instance, value.type.Unsigned_Int);
+                Command_Action_Start(
+                    wp_data->object_instance, &Command_Descr[object_index],
+                    value.type.Unsigned_Int);
             } else {
                 wp_data->error_class = ERROR_CLASS_PROPERTY;
                 wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
@@ -24,6 +24,11 @@
 #define MAX_COMMAND_ACTIONS 8
 #endif
 
+/* number of action writes that a command may have in process at once */
+#ifndef COMMAND_ACTION_WRITES_MAX
+#define COMMAND_ACTION_WRITES_MAX 1
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -33,8 +38,25 @@ typedef struct command_descr {
     bool In_Process;
     bool All_Writes_Successful;
     BACNET_ACTION_LIST Action[MAX_COMMAND_ACTIONS];
+    /* action execution state */
+    BACNET_ACTION_LIST *Action_Next;
+    unsigned Action_Writes_Pending;
+    uint32_t Action_Delay_Milliseconds;
+    bool Action_Delay;
+    bool Action_Issuing;
 } COMMAND_DESCR;
 
+/**
+ * @brief Callback for writing one action of an action list
+ * @param object_instance [in] the Command object instance
+ * @param action [in] the action entry to write
+ * @return true if the write was started. The result shall be reported
+ *  with Command_Action_Write_Result(), which may be called before
+ *  this callback returns. False if the write could not be started.
+ */
+typedef bool (*command_action_write_callback)(
+    uint32_t object_instance, BACNET_ACTION_LIST *action);
+
 BACNET_STACK_EXPORT
 void Command_Property_Lists(
     const int32_t **pRequired,
@@ -103,6 +125,18 @@ Command_Action_List_Entry(uint32_t instance, unsigned index);
 BACNET_STACK_EXPORT
 unsigned Command_Action_List_Count(uint32_t instance);
 
+BACNET_STACK_EXPORT
+void Command_Action_Write_Callback_Set(command_action_write_callback cb);
+BACNET_STACK_EXPORT
+void Command_Action_Writes_Max_Set(unsigned count);
+BACNET_STACK_EXPORT
+unsigned Command_Action_Writes_Max(void);
+BACNET_STACK_EXPORT
+bool Command_Action_Write_Result(
+    uint32_t object_instance, BACNET_ACTION_LIST *action, bool success);
+BACNET_STACK_EXPORT
+void Command_Timer(uint32_t object_instance, uint16_t milliseconds);
+
 /* note: header of Intrinsic_Reporting function is required
    even when INTRINSIC_REPORTING is not defined */
 BACNET_STACK_EXPORT
@@ -16,6 +16,7 @@
 /* BACnet Stack API */
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 #include "bacnet/basic/object/csv.h"
@@ -445,6 +446,7 @@ void CharacterString_Value_Out_Of_Service_Set(
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Changed = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
             if (value) {
                 /* backup Present_Value when entering Out_Of_Service */
                 characterstring_copy(
@@ -21,6 +21,7 @@
 #include "bacnet/rp.h" /* ReadProperty handling */
 #include "bacnet/dcc.h" /* DeviceCommunicationControl handling */
 #include "bacnet/version.h"
+#include "bacnet/datalink/crc.h"
 #if defined(BACDL_MSTP)
 #include "bacnet/datalink/dlmstp.h"
 #endif
@@ -57,6 +58,8 @@
 #include "bacnet/basic/object/schedule.h"
 #include "bacnet/basic/object/structured_view.h"
 #include "bacnet/basic/object/trendlog.h"
+#include "bacnet/basic/object/trendlog_multiple.h"
+#include "bacnet/basic/object/eventlog.h"
 #include "bacnet/basic/object/nc.h"
 #include "bacnet/basic/object/bacfile.h"
 #include "bacnet/basic/object/bitstring_value.h"
@@ -72,6 +75,10 @@
 #include "bacnet/basic/object/netport.h"
 #include "bacnet/basic/object/color_object.h"
 #include "bacnet/basic/object/color_temperature.h"
+#include "bacnet/basic/sys/keyhash.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/perfstat.h"
+#include "bacnet/basic/tsm/tsm.h"
 /* for testing */
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/bactext.h"
@@ -84,6 +91,22 @@ Routed_Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data);
 /* may be overridden by outside table */
 static object_functions_t *Object_Table;
 
+/* property lists of each Object_Table entry, compiled at init */
+struct object_property_lists {
+    struct special_property_list_t lists;
+    /* Required and Optional members */
+    struct property_list_set set;
+    bool valid;
+};
+static struct object_property_lists *Object_Property_Lists;
+
+/* Object_Table entry of each ASHRAE object type, built at init */
+static struct object_functions *Object_Functions_Index[OBJECT_PROPRIETARY_MIN];
+/* Object_Table entries of the proprietary object types, sorted by type */
+static struct object_functions **Object_Functions_Proprietary;
+static size_t Object_Functions_Proprietary_Count;
+static bool Object_Functions_Index_Valid;
+
 static object_functions_t My_Object_Table[] = {
     { OBJECT_DEVICE,
       NULL /* Init - don't init Device or it will recourse! */,
@@ -105,7 +128,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Device_Writable_Property_List },
+      Device_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #if (BACNET_PROTOCOL_REVISION >= 17)
     { OBJECT_NETWORK_PORT,
       Network_Port_Init,
@@ -127,7 +155,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Network_Port_Writable_Property_List },
+      Network_Port_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_TIMER,
       Timer_Init,
       Timer_Count,
@@ -148,7 +181,12 @@ static object_functions_t My_Object_Table[] = {
       Timer_Create,
       Timer_Delete,
       Timer_Task,
-      Timer_Writable_Property_List },
+      Timer_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
     { OBJECT_ANALOG_INPUT,
       Analog_Input_Init,
@@ -170,7 +208,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Input_Create,
       Analog_Input_Delete,
       NULL /* Timer */,
-      Analog_Input_Writable_Property_List },
+      Analog_Input_Writable_Property_List,
+      Analog_Input_Present_Value_Real,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Analog_Input_Status_Flags },
     { OBJECT_ANALOG_OUTPUT,
       Analog_Output_Init,
       Analog_Output_Count,
@@ -191,7 +234,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Output_Create,
       Analog_Output_Delete,
       NULL /* Timer */,
-      Analog_Output_Writable_Property_List },
+      Analog_Output_Writable_Property_List,
+      Analog_Output_Present_Value_Real,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Analog_Output_Status_Flags },
     { OBJECT_ANALOG_VALUE,
       Analog_Value_Init,
       Analog_Value_Count,
@@ -212,7 +260,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Value_Create,
       Analog_Value_Delete,
       NULL /* Timer */,
-      Analog_Value_Writable_Property_List },
+      Analog_Value_Writable_Property_List,
+      Analog_Value_Present_Value_Real,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Analog_Value_Status_Flags },
     { OBJECT_BINARY_INPUT,
       Binary_Input_Init,
       Binary_Input_Count,
@@ -233,7 +286,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Input_Create,
       Binary_Input_Delete,
       NULL /* Timer */,
-      Binary_Input_Writable_Property_List },
+      Binary_Input_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      Binary_Input_Present_Value_Enumerated,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Binary_Input_Status_Flags },
     { OBJECT_BINARY_OUTPUT,
       Binary_Output_Init,
       Binary_Output_Count,
@@ -254,7 +312,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Output_Create,
       Binary_Output_Delete,
       NULL /* Timer */,
-      Binary_Output_Writable_Property_List },
+      Binary_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      Binary_Output_Present_Value_Enumerated,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Binary_Output_Status_Flags },
     { OBJECT_BINARY_VALUE,
       Binary_Value_Init,
       Binary_Value_Count,
@@ -275,7 +338,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Value_Create,
       Binary_Value_Delete,
       NULL /* Timer */,
-      Binary_Value_Writable_Property_List },
+      Binary_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      Binary_Value_Present_Value_Enumerated,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Binary_Value_Status_Flags },
     { OBJECT_CALENDAR,
       Calendar_Init,
       Calendar_Count,
@@ -296,7 +364,12 @@ static object_functions_t My_Object_Table[] = {
       Calendar_Create,
       Calendar_Delete,
       NULL /* Timer */,
-      Calendar_Writable_Property_List },
+      Calendar_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      Calendar_Present_Value_Boolean,
+      NULL /* Status_Flags */ },
 #if (BACNET_PROTOCOL_REVISION >= 10)
     { OBJECT_BITSTRING_VALUE,
       BitString_Value_Init,
@@ -318,7 +391,12 @@ static object_functions_t My_Object_Table[] = {
       BitString_Value_Create,
       BitString_Value_Delete,
       NULL /* Timer */,
-      BitString_Value_Writable_Property_List },
+      BitString_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_CHARACTERSTRING_VALUE,
       CharacterString_Value_Init,
       CharacterString_Value_Count,
@@ -339,7 +417,12 @@ static object_functions_t My_Object_Table[] = {
       CharacterString_Value_Create,
       CharacterString_Value_Delete,
       NULL /* Timer */,
-      CharacterString_Value_Writable_Property_List },
+      CharacterString_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_OCTETSTRING_VALUE,
       OctetString_Value_Init,
       OctetString_Value_Count,
@@ -360,7 +443,12 @@ static object_functions_t My_Object_Table[] = {
       OctetString_Value_Create,
       OctetString_Value_Delete,
       NULL /* Timer */,
-      OctetString_Value_Writable_Property_List },
+      OctetString_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_POSITIVE_INTEGER_VALUE,
       PositiveInteger_Value_Init,
       PositiveInteger_Value_Count,
@@ -381,7 +469,12 @@ static object_functions_t My_Object_Table[] = {
       PositiveInteger_Value_Create,
       PositiveInteger_Value_Delete,
       NULL /* Timer */,
-      PositiveInteger_Value_Writable_Property_List },
+      PositiveInteger_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_TIME_VALUE,
       Time_Value_Init,
       Time_Value_Count,
@@ -402,7 +495,12 @@ static object_functions_t My_Object_Table[] = {
       Time_Value_Create,
       Time_Value_Delete,
       NULL /* Timer */,
-      Time_Value_Writable_Property_List },
+      Time_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_INTEGER_VALUE,
       Integer_Value_Init,
       Integer_Value_Count,
@@ -423,7 +521,12 @@ static object_functions_t My_Object_Table[] = {
       Integer_Value_Create,
       Integer_Value_Delete,
       NULL /* Timer */,
-      Integer_Value_Writable_Property_List },
+      Integer_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
     { OBJECT_COMMAND,
       Command_Init,
@@ -445,7 +548,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Command_Writable_Property_List },
+      Command_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #if defined(INTRINSIC_REPORTING)
     { OBJECT_NOTIFICATION_CLASS,
       Notification_Class_Init,
@@ -467,7 +575,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Notification_Class_Writable_Property_List },
+      Notification_Class_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
     { OBJECT_LIFE_SAFETY_POINT,
       Life_Safety_Point_Init,
@@ -489,7 +602,12 @@ static object_functions_t My_Object_Table[] = {
       Life_Safety_Point_Create,
       Life_Safety_Point_Delete,
       NULL /* Timer */,
-      Life_Safety_Point_Writable_Property_List },
+      Life_Safety_Point_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_LIFE_SAFETY_ZONE,
       Life_Safety_Zone_Init,
       Life_Safety_Zone_Count,
@@ -510,7 +628,12 @@ static object_functions_t My_Object_Table[] = {
       Life_Safety_Zone_Create,
       Life_Safety_Zone_Delete,
       NULL /* Timer */,
-      Life_Safety_Zone_Writable_Property_List },
+      Life_Safety_Zone_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_LOAD_CONTROL,
       Load_Control_Init,
       Load_Control_Count,
@@ -531,7 +654,12 @@ static object_functions_t My_Object_Table[] = {
       Load_Control_Create,
       Load_Control_Delete,
       Load_Control_Timer,
-      Load_Control_Writable_Property_List },
+      Load_Control_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_MULTI_STATE_INPUT,
       Multistate_Input_Init,
       Multistate_Input_Count,
@@ -552,7 +680,12 @@ static object_functions_t My_Object_Table[] = {
       Multistate_Input_Create,
       Multistate_Input_Delete,
       NULL /* Timer */,
-      Multistate_Input_Writable_Property_List },
+      Multistate_Input_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      Multistate_Input_Present_Value_Unsigned,
+      NULL /* Present_Value_Boolean */,
+      Multistate_Input_Status_Flags },
     { OBJECT_MULTI_STATE_OUTPUT,
       Multistate_Output_Init,
       Multistate_Output_Count,
@@ -573,7 +706,12 @@ static object_functions_t My_Object_Table[] = {
       Multistate_Output_Create,
       Multistate_Output_Delete,
       NULL /* Timer */,
-      Multistate_Output_Writable_Property_List },
+      Multistate_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      Multistate_Output_Present_Value_Unsigned,
+      NULL /* Present_Value_Boolean */,
+      Multistate_Output_Status_Flags },
     { OBJECT_MULTI_STATE_VALUE,
       Multistate_Value_Init,
       Multistate_Value_Count,
@@ -594,7 +732,12 @@ static object_functions_t My_Object_Table[] = {
       Multistate_Value_Create,
       Multistate_Value_Delete,
       NULL /* Timer */,
-      Multistate_Value_Writable_Property_List },
+      Multistate_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      Multistate_Value_Present_Value_Unsigned,
+      NULL /* Present_Value_Boolean */,
+      Multistate_Value_Status_Flags },
     { OBJECT_TRENDLOG,
       Trend_Log_Init,
       Trend_Log_Count,
@@ -615,7 +758,64 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Trend_Log_Writable_Property_List },
+      Trend_Log_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
+    { OBJECT_TREND_LOG_MULTIPLE,
+      Trend_Log_Multiple_Init,
+      Trend_Log_Multiple_Count,
+      Trend_Log_Multiple_Index_To_Instance,
+      Trend_Log_Multiple_Valid_Instance,
+      Trend_Log_Multiple_Object_Name,
+      Trend_Log_Multiple_Read_Property,
+      Trend_Log_Multiple_Write_Property,
+      Trend_Log_Multiple_Property_Lists,
+      Trend_Log_Multiple_Read_Range_Info,
+      NULL /* Iterator */,
+      NULL /* Value_Lists */,
+      NULL /* COV */,
+      NULL /* COV Clear */,
+      NULL /* Intrinsic Reporting */,
+      NULL /* Add_List_Element */,
+      NULL /* Remove_List_Element */,
+      Trend_Log_Multiple_Create,
+      Trend_Log_Multiple_Delete,
+      Trend_Log_Multiple_Timer,
+      Trend_Log_Multiple_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
+    { OBJECT_EVENT_LOG,
+      Event_Log_Init,
+      Event_Log_Count,
+      Event_Log_Index_To_Instance,
+      Event_Log_Valid_Instance,
+      Event_Log_Object_Name,
+      Event_Log_Read_Property,
+      Event_Log_Write_Property,
+      Event_Log_Property_Lists,
+      Event_Log_Read_Range_Info,
+      NULL /* Iterator */,
+      NULL /* Value_Lists */,
+      NULL /* COV */,
+      NULL /* COV Clear */,
+      NULL /* Intrinsic Reporting */,
+      NULL /* Add_List_Element */,
+      NULL /* Remove_List_Element */,
+      Event_Log_Create,
+      Event_Log_Delete,
+      NULL /* Timer */,
+      Event_Log_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #if (BACNET_PROTOCOL_REVISION >= 14)
     { OBJECT_LIGHTING_OUTPUT,
       Lighting_Output_Init,
@@ -637,7 +837,12 @@ static object_functions_t My_Object_Table[] = {
       Lighting_Output_Create,
       Lighting_Output_Delete,
       Lighting_Output_Timer,
-      Lighting_Output_Writable_Property_List },
+      Lighting_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_CHANNEL,
       Channel_Init,
       Channel_Count,
@@ -658,7 +863,12 @@ static object_functions_t My_Object_Table[] = {
       Channel_Create,
       Channel_Delete,
       NULL /* Timer */,
-      Channel_Writable_Property_List },
+      Channel_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if (BACNET_PROTOCOL_REVISION >= 16)
     { OBJECT_BINARY_LIGHTING_OUTPUT,
@@ -681,7 +891,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Lighting_Output_Create,
       Binary_Lighting_Output_Delete,
       Binary_Lighting_Output_Timer,
-      Binary_Lighting_Output_Writable_Property_List },
+      Binary_Lighting_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if (BACNET_PROTOCOL_REVISION >= 24)
     { OBJECT_COLOR,
@@ -704,7 +919,12 @@ static object_functions_t My_Object_Table[] = {
       Color_Create,
       Color_Delete,
       Color_Timer,
-      Color_Writable_Property_List },
+      Color_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_COLOR_TEMPERATURE,
       Color_Temperature_Init,
       Color_Temperature_Count,
@@ -725,7 +945,12 @@ static object_functions_t My_Object_Table[] = {
       Color_Temperature_Create,
       Color_Temperature_Delete,
       Color_Temperature_Timer,
-      Color_Temperature_Writable_Property_List },
+      Color_Temperature_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
     { OBJECT_FILE,
       bacfile_init,
@@ -747,7 +972,12 @@ static object_functions_t My_Object_Table[] = {
       bacfile_create,
       bacfile_delete,
       NULL /* Timer */,
-      BACfile_Writable_Property_List },
+      BACfile_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_SCHEDULE,
       Schedule_Init,
       Schedule_Count,
@@ -768,7 +998,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       Schedule_Timer /* Timer */,
-      Schedule_Writable_Property_List },
+      Schedule_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_STRUCTURED_VIEW,
       Structured_View_Init,
       Structured_View_Count,
@@ -789,7 +1024,12 @@ static object_functions_t My_Object_Table[] = {
       Structured_View_Create,
       Structured_View_Delete,
       NULL /* Timer */,
-      Structured_View_Writable_Property_List },
+      Structured_View_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_ACCUMULATOR,
       Accumulator_Init,
       Accumulator_Count,
@@ -809,8 +1049,13 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Remove_List_Element */,
       NULL /* Create */,
       NULL /* Delete */,
-      NULL /* Timer */,
-      Accumulator_Writable_Property_List },
+      Accumulator_Timer,
+      Accumulator_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_LOOP,
       Loop_Init,
       Loop_Count,
@@ -831,7 +1076,12 @@ static object_functions_t My_Object_Table[] = {
       Loop_Create,
       Loop_Delete,
       Loop_Timer,
-      Loop_Writable_Property_List },
+      Loop_Writable_Property_List,
+      Loop_Present_Value_Real,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_PROGRAM,
       Program_Init,
       Program_Count,
@@ -852,7 +1102,12 @@ static object_functions_t My_Object_Table[] = {
       Program_Create,
       Program_Delete,
       Program_Timer,
-      Program_Writable_Property_List },
+      Program_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #if (BACNET_PROTOCOL_REVISION >= 9)
     { OBJECT_ACCESS_CREDENTIAL,
       Access_Credential_Init,
@@ -874,7 +1129,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Access_Credential_Writable_Property_List },
+      Access_Credential_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_ACCESS_DOOR,
       Access_Door_Init,
       Access_Door_Count,
@@ -895,7 +1155,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Access_Door_Writable_Property_List },
+      Access_Door_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_ACCESS_POINT,
       Access_Point_Init,
       Access_Point_Count,
@@ -916,7 +1181,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Access_Point_Writable_Property_List },
+      Access_Point_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_ACCESS_RIGHTS,
       Access_Rights_Init,
       Access_Rights_Count,
@@ -937,7 +1207,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Access_Rights_Writable_Property_List },
+      Access_Rights_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_ACCESS_USER,
       Access_User_Init,
       Access_User_Count,
@@ -958,7 +1233,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Access_User_Writable_Property_List },
+      Access_User_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_ACCESS_ZONE,
       Access_Zone_Init,
       Access_Zone_Count,
@@ -979,7 +1259,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Access_Zone_Writable_Property_List },
+      Access_Zone_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
     { OBJECT_CREDENTIAL_DATA_INPUT,
       Credential_Data_Input_Init,
       Credential_Data_Input_Count,
@@ -1000,7 +1285,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Credential_Data_Input_Writable_Property_List },
+      Credential_Data_Input_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if (BACNET_PROTOCOL_REVISION >= 20)
     { OBJECT_AUDIT_LOG,
@@ -1023,7 +1313,12 @@ static object_functions_t My_Object_Table[] = {
       Audit_Log_Create,
       Audit_Log_Delete,
       NULL /* Timer */,
-      Audit_Log_Writable_Property_List },
+      Audit_Log_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
     { MAX_BACNET_OBJECT_TYPE,
       NULL /* Init */,
@@ -1045,7 +1340,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      NULL /* Writable_Property_List */ }
+      NULL /* Writable_Property_List */,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ }
 };
 
 /* Proprietary property callback functions to enable proprietary
@@ -1123,7 +1423,28 @@ struct object_functions *
 Device_Object_Functions_Find(BACNET_OBJECT_TYPE Object_Type)
 {
     struct object_functions *pObject = NULL;
+    size_t low, high, middle;
+
+    if (Object_Functions_Index_Valid) {
+        if (Object_Type < OBJECT_PROPRIETARY_MIN) {
+            return Object_Functions_Index[Object_Type];
+        }
+        low = 0;
+        high = Object_Functions_Proprietary_Count;
+        while (low < high) {
+            middle = low + (high - low) / 2;
+            pObject = Object_Functions_Proprietary[middle];
+            if (pObject->Object_Type == Object_Type) {
+                return pObject;
+            } else if (pObject->Object_Type < Object_Type) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
 
+        return NULL;
+    }
     pObject = Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         /* handle each object type */
@@ -1136,6 +1457,69 @@ Device_Object_Functions_Find(BACNET_OBJECT_TYPE Object_Type)
     return (NULL);
 }
 
+/**
+ * @brief Build the index of the Object_Table by object type, so that
+ *  Device_Object_Functions_Find() is an array lookup for the ASHRAE object
+ *  types, and a binary search of a small list for the proprietary types.
+ * @note The first entry of a type wins, as it does in a table scan.
+ *  If the list of proprietary types can not be allocated, the table
+ *  is scanned instead.
+ */
+static void Device_Object_Functions_Index_Rebuild(void)
+{
+    struct object_functions *pObject;
+    size_t count = 0, index;
+
+    Object_Functions_Index_Valid = false;
+    memset(Object_Functions_Index, 0, sizeof(Object_Functions_Index));
+    free(Object_Functions_Proprietary);
+    Object_Functions_Proprietary = NULL;
+    Object_Functions_Proprietary_Count = 0;
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if (pObject->Object_Type >= OBJECT_PROPRIETARY_MIN) {
+            count++;
+        }
+        pObject++;
+    }
+    if (count > 0) {
+        Object_Functions_Proprietary =
+            calloc(count, sizeof(*Object_Functions_Proprietary));
+        if (!Object_Functions_Proprietary) {
+            return;
+        }
+    }
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if (pObject->Object_Type < OBJECT_PROPRIETARY_MIN) {
+            if (!Object_Functions_Index[pObject->Object_Type]) {
+                Object_Functions_Index[pObject->Object_Type] = pObject;
+            }
+        } else {
+            /* insertion sort: the table has few proprietary types */
+            index = Object_Functions_Proprietary_Count;
+            while ((index > 0) &&
+                   (Object_Functions_Proprietary[index - 1]->Object_Type >=
+                    pObject->Object_Type)) {
+                index--;
+            }
+            if ((index == Object_Functions_Proprietary_Count) ||
+                (Object_Functions_Proprietary[index]->Object_Type !=
+                 pObject->Object_Type)) {
+                memmove(
+                    &Object_Functions_Proprietary[index + 1],
+                    &Object_Functions_Proprietary[index],
+                    (Object_Functions_Proprietary_Count - index) *
+                        sizeof(*Object_Functions_Proprietary));
+                Object_Functions_Proprietary[index] = pObject;
+                Object_Functions_Proprietary_Count++;
+            }
+        }
+        pObject++;
+    }
+    Object_Functions_Index_Valid = true;
+}
+
 /** Try to find a rr_info_function helper function for the requested object
  * type.
  * @ingroup ObjIntf
@@ -1155,6 +1539,82 @@ rr_info_function Device_Objects_RR_Info(BACNET_OBJECT_TYPE object_type)
     return (pObject != NULL ? pObject->Object_RR_Info : NULL);
 }
 
+/**
+ * @brief Get the compiled property lists of an Object_Table entry
+ * @param pObject [in] entry of the Object_Table
+ * @return compiled property lists, or NULL if the lists of this entry
+ *  were not compiled
+ */
+static struct object_property_lists *
+Device_Object_Property_Lists(const struct object_functions *pObject)
+{
+    struct object_property_lists *pLists;
+
+    if (!Object_Property_Lists || !pObject) {
+        return NULL;
+    }
+    pLists = &Object_Property_Lists[pObject - Object_Table];
+    if (!pLists->valid) {
+        return NULL;
+    }
+
+    return pLists;
+}
+
+/**
+ * @brief Compile the property lists of each Object_Table entry, so that
+ *  the lists are counted once, and membership of the Required and Optional
+ *  lists is a bitset test.
+ * @note The object property lists are static, so this is done once at
+ *  Device_Init() before any other task reads them.  The lists of the
+ *  Network Port object depend on the network type of the port, which
+ *  is set after Device_Init(), so they are not compiled.
+ */
+static void Device_Object_Property_Lists_Rebuild(void)
+{
+    struct object_functions *pObject;
+    struct object_property_lists *pLists;
+    struct special_property_list_t *pList;
+    size_t count = 0;
+
+    free(Object_Property_Lists);
+    Object_Property_Lists = NULL;
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        count++;
+        pObject++;
+    }
+    if (count == 0) {
+        return;
+    }
+    Object_Property_Lists = calloc(count, sizeof(*Object_Property_Lists));
+    if (!Object_Property_Lists) {
+        /* the lists are scanned instead */
+        return;
+    }
+    pObject = Object_Table;
+    pLists = Object_Property_Lists;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if (pObject->Object_RPM_List &&
+            (pObject->Object_Type != OBJECT_NETWORK_PORT)) {
+            pList = &pLists->lists;
+            pObject->Object_RPM_List(
+                &pList->Required.pList, &pList->Optional.pList,
+                &pList->Proprietary.pList);
+            pList->Required.count = property_list_count(pList->Required.pList);
+            pList->Optional.count = property_list_count(pList->Optional.pList);
+            pList->Proprietary.count =
+                property_list_count(pList->Proprietary.pList);
+            property_list_set_init(&pLists->set);
+            pLists->valid =
+                property_list_set_add(&pLists->set, pList->Required.pList) &&
+                property_list_set_add(&pLists->set, pList->Optional.pList);
+        }
+        pObject++;
+        pLists++;
+    }
+}
+
 /** For a given object type, returns the special property list.
  * This function is used for ReadPropertyMultiple calls which want
  * just Required, just Optional, or All properties.
@@ -1172,6 +1632,7 @@ void Device_Objects_Property_List(
     struct special_property_list_t *pPropertyList)
 {
     struct object_functions *pObject = NULL;
+    const struct object_property_lists *pLists = NULL;
     const int32_t *proprietary_property_list = NULL;
 
     (void)object_instance;
@@ -1185,30 +1646,36 @@ void Device_Objects_Property_List(
      */
 
     pObject = Device_Object_Functions_Find(object_type);
-    if ((pObject != NULL) && (pObject->Object_RPM_List != NULL)) {
-        pObject->Object_RPM_List(
-            &pPropertyList->Required.pList, &pPropertyList->Optional.pList,
-            &pPropertyList->Proprietary.pList);
+    pLists = Device_Object_Property_Lists(pObject);
+    if (pLists) {
+        /* the lists were counted at init */
+        *pPropertyList = pLists->lists;
+    } else {
+        if ((pObject != NULL) && (pObject->Object_RPM_List != NULL)) {
+            pObject->Object_RPM_List(
+                &pPropertyList->Required.pList, &pPropertyList->Optional.pList,
+                &pPropertyList->Proprietary.pList);
+        }
+        /* Fetch the counts if available otherwise zero them */
+        pPropertyList->Required.count = pPropertyList->Required.pList == NULL
+            ? 0
+            : property_list_count(pPropertyList->Required.pList);
+        pPropertyList->Optional.count = pPropertyList->Optional.pList == NULL
+            ? 0
+            : property_list_count(pPropertyList->Optional.pList);
+        pPropertyList->Proprietary.count =
+            pPropertyList->Proprietary.pList == NULL
+            ? 0
+            : property_list_count(pPropertyList->Proprietary.pList);
     }
-
-    /* Fetch the counts if available otherwise zero them */
-    pPropertyList->Required.count = pPropertyList->Required.pList == NULL
-        ? 0
-        : property_list_count(pPropertyList->Required.pList);
-
-    pPropertyList->Optional.count = pPropertyList->Optional.pList == NULL
-        ? 0
-        : property_list_count(pPropertyList->Optional.pList);
-
     if (Property_List_Proprietary_Callback) {
         if (Property_List_Proprietary_Callback(
                 object_type, object_instance, &proprietary_property_list)) {
             pPropertyList->Proprietary.pList = proprietary_property_list;
+            pPropertyList->Proprietary.count =
+                property_list_count(proprietary_property_list);
         }
     }
-    pPropertyList->Proprietary.count = pPropertyList->Proprietary.pList == NULL
-        ? 0
-        : property_list_count(pPropertyList->Proprietary.pList);
 
     return;
 }
@@ -1261,6 +1728,11 @@ static const int32_t Device_Properties_Required[] = {
     PROP_NUMBER_OF_APDU_RETRIES,
     PROP_DEVICE_ADDRESS_BINDING,
     PROP_DATABASE_REVISION,
+#if BACNET_SEGMENTATION_ENABLED
+    /* required when segmentation is supported */
+    PROP_MAX_SEGMENTS_ACCEPTED,
+    PROP_APDU_SEGMENT_TIMEOUT,
+#endif
     -1
 };
 
@@ -1297,6 +1769,18 @@ static const int32_t Device_Properties_Optional[] = {
 
 static const int32_t Device_Properties_Proprietary[] = {
     /* List of Proprietary properties in this object */
+#if BACNET_PERFSTAT_ENABLED
+    PROP_PERFSTAT_DECODE_ERRORS,
+    PROP_PERFSTAT_CONFIRMED_REQUESTS,
+    PROP_PERFSTAT_UNCONFIRMED_REQUESTS,
+    PROP_PERFSTAT_TSM_ACTIVE_TRANSACTIONS,
+    PROP_PERFSTAT_TSM_RETRIES,
+    PROP_PERFSTAT_TSM_TIMEOUTS,
+    PROP_PERFSTAT_COV_SUBSCRIPTIONS,
+    PROP_PERFSTAT_COV_NOTIFICATIONS,
+    PROP_PERFSTAT_ADDRESS_CACHE_HITS,
+    PROP_PERFSTAT_ADDRESS_CACHE_MISSES,
+#endif
     -1
 };
 
@@ -1315,6 +1799,9 @@ static const int32_t Writable_Properties[] = {
     PROP_DESCRIPTION,
     PROP_APDU_TIMEOUT,
     PROP_NUMBER_OF_APDU_RETRIES,
+#if BACNET_SEGMENTATION_ENABLED
+    PROP_APDU_SEGMENT_TIMEOUT,
+#endif
     PROP_UTC_OFFSET,
 #if defined(BACNET_TIME_MASTER)
     PROP_TIME_SYNCHRONIZATION_INTERVAL,
@@ -1392,12 +1879,24 @@ bool Device_Objects_Property_List_Member(
 {
     bool found = false;
     struct special_property_list_t property_list = { 0 };
+    const struct object_property_lists *pLists = NULL;
 
+    pLists =
+        Device_Object_Property_Lists(Device_Object_Functions_Find(object_type));
+    if (pLists) {
+        found = property_list_set_member(&pLists->set, object_property);
+        if (found) {
+            return true;
+        }
+    }
     Device_Objects_Property_List(object_type, object_instance, &property_list);
-    found = property_list_member(property_list.Required.pList, object_property);
-    if (!found) {
+    if (!pLists) {
         found =
-            property_list_member(property_list.Optional.pList, object_property);
+            property_list_member(property_list.Required.pList, object_property);
+        if (!found) {
+            found = property_list_member(
+                property_list.Optional.pList, object_property);
+        }
     }
     if (!found) {
         found = property_list_member(
@@ -1443,6 +1942,15 @@ static BACNET_DATE Local_Date; /* rely on OS, if there is one */
    BACnet UTC offset is expressed in minutes. */
 static int16_t UTC_Offset = 5 * 60;
 static bool Daylight_Savings_Status = false; /* rely on OS */
+/* Once Device_Timer() runs, the clock is read from the OS once per period,
+   and the Local_Date and Local_Time are moved along by the timer between
+   the reads, so that timestamps do not each cost a timezone calculation */
+#ifndef BACNET_DEVICE_LOCAL_TIME_REFRESH_MS
+#define BACNET_DEVICE_LOCAL_TIME_REFRESH_MS 1000
+#endif
+static bool Local_Time_Cached;
+static BACNET_DATE_TIME Local_Time_Refreshed;
+static uint16_t Local_Time_Elapsed_Milliseconds;
 #if defined(BACNET_TIME_MASTER)
 static bool Align_Intervals;
 static uint32_t Interval_Minutes;
@@ -1727,8 +2235,11 @@ bool Device_Set_Object_Instance_Number(uint32_t object_id)
 
     if (object_id <= BACNET_MAX_INSTANCE) {
         /* Make the change and update the database revision */
+        Device_Object_Name_Index_Remove(OBJECT_DEVICE, Object_Instance_Number);
+        Device_Property_Cache_Invalidate(OBJECT_DEVICE, Object_Instance_Number);
         Object_Instance_Number = object_id;
         Device_Inc_Database_Revision();
+        Device_Object_Name_Index_Update(OBJECT_DEVICE, Object_Instance_Number);
     } else {
         status = false;
     }
@@ -1761,6 +2272,8 @@ bool Device_Set_Object_Name(const BACNET_CHARACTER_STRING *object_name)
         /* Make the change and update the database revision */
         status = characterstring_copy(&My_Object_Name, object_name);
         Device_Inc_Database_Revision();
+        Device_Object_Name_Index_Update(OBJECT_DEVICE, Object_Instance_Number);
+        Device_Property_Cache_Invalidate(OBJECT_DEVICE, Object_Instance_Number);
     }
 
     return status;
@@ -1773,7 +2286,13 @@ bool Device_Set_Object_Name(const BACNET_CHARACTER_STRING *object_name)
  */
 bool Device_Object_Name_ANSI_Init(const char *value)
 {
-    return characterstring_init_ansi(&My_Object_Name, value);
+    bool status;
+
+    status = characterstring_init_ansi(&My_Object_Name, value);
+    Device_Object_Name_Index_Update(OBJECT_DEVICE, Object_Instance_Number);
+    Device_Property_Cache_Invalidate(OBJECT_DEVICE, Object_Instance_Number);
+
+    return status;
 }
 
 /**
@@ -1920,6 +2439,7 @@ bool Device_Set_Vendor_Name(const char *name, size_t length)
 {
     (void)length;
     Vendor_Name = name;
+    Device_Property_Cache_Invalidate(OBJECT_DEVICE, Object_Instance_Number);
 
     return true;
 }
@@ -1951,6 +2471,7 @@ bool Device_Set_Model_Name(const char *name, size_t length)
     if (length < sizeof(Model_Name)) {
         memmove(Model_Name, name, length);
         Model_Name[length] = 0;
+        Device_Property_Cache_Invalidate(OBJECT_DEVICE, Object_Instance_Number);
         status = true;
     }
 
@@ -1969,6 +2490,7 @@ bool Device_Set_Firmware_Revision(const char *name, size_t length)
     if (length < sizeof(Firmware_Revision)) {
         memmove(Firmware_Revision, name, length);
         Firmware_Revision[length] = 0;
+        Device_Property_Cache_Invalidate(OBJECT_DEVICE, Object_Instance_Number);
         status = true;
     }
 
@@ -1987,6 +2509,7 @@ bool Device_Set_Application_Software_Version(const char *name, size_t length)
     if (length < sizeof(Application_Software_Version)) {
         memmove(Application_Software_Version, name, length);
         Application_Software_Version[length] = 0;
+        Device_Property_Cache_Invalidate(OBJECT_DEVICE, Object_Instance_Number);
         status = true;
     }
 
@@ -2005,6 +2528,7 @@ bool Device_Set_Description(const char *name, size_t length)
     if (length < sizeof(Description)) {
         memmove(Description, name, length);
         Description[length] = 0;
+        Device_Property_Cache_Invalidate(OBJECT_DEVICE, Object_Instance_Number);
         status = true;
     }
 
@@ -2122,160 +2646,934 @@ void Device_Inc_Database_Revision(void)
     Database_Revision++;
 }
 
-/** Get the total count of objects supported by this Device Object.
- * @note Since many network clients depend on the object list
- *       for discovery, it must be consistent!
- * @return The count of objects, for all supported Object types.
+/**
+ * @brief Call a function once for each of the devices in this file, with
+ *  that device as the current routed device
+ * @param callback [in] function to call
  */
-unsigned Device_Object_List_Count(void)
+static void Device_Each_Routed_Device(void (*callback)(void))
 {
-    unsigned count = 0; /* number of objects */
-    struct object_functions *pObject = NULL;
+#ifdef BAC_ROUTING
+    uint16_t current_dev_id = Routed_Device_Object_Index();
+    uint16_t dev_id = 0;
 
-    /* initialize the default return values */
-    pObject = Object_Table;
-    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
-        if (pObject->Object_Count) {
-            count += pObject->Object_Count();
-        }
-        pObject++;
-    }
+    do {
+        Set_Routed_Device_Object_Index(dev_id);
+        callback();
+        dev_id++;
+    } while (dev_id < Get_Num_Managed_Devices());
+    Set_Routed_Device_Object_Index(current_dev_id);
+#else
+    callback();
+#endif
+}
 
-    return count;
+/* optional snapshot of the Object_List property: the packed object
+   identifiers of every object, in Object_List order, and the
+   Database_Revision it was taken at */
+struct object_list_cache {
+    uint32_t *list;
+    uint32_t size;
+    uint32_t count;
+    uint32_t revision;
+    bool valid;
+};
+static struct object_list_cache Object_List_Caches[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Object_List_Cache (Object_List_Caches[Routed_Device_Object_Index()])
+#else
+#define Object_List_Cache (Object_List_Caches[0])
+#endif
+static bool Object_List_Cache_Enable_Flag;
+
+/**
+ * @brief Determine if the Object_List snapshot matches the objects
+ * @return true if the snapshot can be used
+ */
+static bool Device_Object_List_Cache_Current(void)
+{
+    return Object_List_Cache.valid &&
+        (Object_List_Cache.revision == Database_Revision);
 }
 
-/** Lookup the Object at the given array index in the Device's Object List.
- * Even though we don't keep a single linear array of objects in the Device,
- * this method acts as though we do and works through a virtual, concatenated
- * array of all of our object type arrays.
- *
- * @param array_index [in] The desired array index (1 to N)
- * @param object_type [out] The object's type, if found.
- * @param instance [out] The object's instance number, if found.
- * @return True if found, else false.
+/**
+ * @brief Mark the Object_List snapshot as out of date.
+ * @note Objects created or deleted through the BACnet services change
+ *  the Database_Revision, which also marks the snapshot as out of date.
+ *  Call this after an object is created or deleted directly, for
+ *  example after calling Analog_Input_Create(), when the snapshot is
+ *  enabled.
  */
-bool Device_Object_List_Identifier(
-    uint32_t array_index, BACNET_OBJECT_TYPE *object_type, uint32_t *instance)
+void Device_Object_List_Cache_Invalidate(void)
 {
-    bool status = false;
-    uint32_t count = 0;
-    uint32_t object_index = 0;
-    uint32_t temp_index = 0;
+    unsigned i;
+
+    for (i = 0; i < MAX_NUM_DEVICES; i++) {
+        Object_List_Caches[i].valid = false;
+    }
+}
+
+/**
+ * @brief Take a new snapshot of the Object_List, in one pass through
+ *  the objects of each object type.
+ * @note The snapshot is only taken here, and by Device_Timer() when it
+ *  is out of date, and never while the Object_List is being read.
+ * @return true if the snapshot was taken
+ */
+bool Device_Object_List_Cache_Rebuild(void)
+{
+    struct object_list_cache *cache = &Object_List_Cache;
     struct object_functions *pObject = NULL;
+    uint32_t *list = NULL;
+    uint32_t count = 0, object_count = 0, i = 0;
+    unsigned index = 0;
 
-    /* array index zero is length - so invalid */
-    if (array_index == 0) {
-        return status;
+    cache->valid = false;
+    if (!Object_List_Cache_Enable_Flag) {
+        return false;
+    }
+    count = Device_Object_List_Count();
+    if (count > cache->size) {
+        list = realloc(cache->list, count * sizeof(uint32_t));
+        if (!list) {
+            return false;
+        }
+        cache->list = list;
+        cache->size = count;
     }
-    object_index = array_index - 1;
-    /* initialize the default return values */
     pObject = Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Count) {
-            object_index -= count;
-            count = pObject->Object_Count();
-            if (object_index < count) {
-                /* Use the iterator function if available otherwise
-                 * look for the index to instance to get the ID */
+            object_count = pObject->Object_Count();
+            if (object_count && !pObject->Object_Index_To_Instance) {
+                /* the identifiers of this type are unknown */
+                return false;
+            }
+            if (pObject->Object_Iterator) {
+                index = pObject->Object_Iterator(~(unsigned)0);
+            } else {
+                index = 0;
+            }
+            while (object_count && (i < count)) {
+                cache->list[i] = BACNET_ID_VALUE(
+                    pObject->Object_Index_To_Instance(index),
+                    pObject->Object_Type);
                 if (pObject->Object_Iterator) {
-                    /* First find the first object */
-                    temp_index = pObject->Object_Iterator(~(unsigned)0);
-                    /* Then step through the objects to find the nth */
-                    while (object_index != 0) {
-                        temp_index = pObject->Object_Iterator(temp_index);
-                        object_index--;
-                    }
-                    /* set the object_index up before falling through to next
-                     * bit */
-                    object_index = temp_index;
-                }
-                if (pObject->Object_Index_To_Instance) {
-                    *object_type = pObject->Object_Type;
-                    *instance = pObject->Object_Index_To_Instance(object_index);
-                    status = true;
-                    break;
+                    index = pObject->Object_Iterator(index);
+                } else {
+                    index++;
                 }
+                object_count--;
+                i++;
             }
         }
         pObject++;
     }
+    cache->count = i;
+    cache->revision = Database_Revision;
+    cache->valid = true;
 
-    return status;
+    return true;
 }
 
 /**
- * @brief Encode a BACnetARRAY property element
- * @param object_instance [in] BACnet network port object instance number
- * @param array_index [in] array index requested:
- *    0 to N for individual array members
- * @param apdu [out] Buffer in which the APDU contents are built, or NULL to
- * return the length of buffer if it had been built
- * @return The length of the apdu encoded or
- *   BACNET_STATUS_ERROR for ERROR_CODE_INVALID_ARRAY_INDEX
+ * @brief Take a new snapshot of the Object_List, if it is out of date
  */
-int Device_Object_List_Element_Encode(
-    uint32_t object_instance, BACNET_ARRAY_INDEX array_index, uint8_t *apdu)
+static void Device_Object_List_Cache_Refresh(void)
 {
-    int apdu_len = BACNET_STATUS_ERROR;
-    BACNET_OBJECT_TYPE object_type;
-    uint32_t instance;
-    bool found;
-
-    if (object_instance == Device_Object_Instance_Number()) {
-        /* single element is zero based, add 1 for BACnetARRAY which is one
-         * based */
-        array_index++;
-        found =
-            Device_Object_List_Identifier(array_index, &object_type, &instance);
-        if (found) {
-            apdu_len =
-                encode_application_object_id(apdu, object_type, instance);
-        }
+    if (!Device_Object_List_Cache_Current()) {
+        (void)Device_Object_List_Cache_Rebuild();
     }
-
-    return apdu_len;
 }
 
-/** Determine if we have an object with the given object_name.
- * If the object_type and object_instance pointers are not null,
- * and the lookup succeeds, they will be given the resulting values.
- * @param object_name [in] The desired Object Name to look for.
- * @param object_type [out] The BACNET_OBJECT_TYPE of the matching Object.
- * @param object_instance [out] The object instance number of the matching
- * Object.
- * @return True on success or else False if not found.
+/**
+ * @brief Free the Object_List snapshot
  */
-bool Device_Valid_Object_Name(
-    const BACNET_CHARACTER_STRING *object_name1,
-    BACNET_OBJECT_TYPE *object_type,
-    uint32_t *object_instance)
+static void Device_Object_List_Cache_Free(void)
 {
-    bool found = false;
-    BACNET_OBJECT_TYPE type = OBJECT_NONE;
-    uint32_t instance;
-    uint32_t max_objects = 0, i = 0;
-    bool check_id = false;
-    BACNET_CHARACTER_STRING object_name2;
-    struct object_functions *pObject = NULL;
+    free(Object_List_Cache.list);
+    memset(&Object_List_Cache, 0, sizeof(struct object_list_cache));
+}
 
-    max_objects = Device_Object_List_Count();
-    for (i = 1; i <= max_objects; i++) {
-        check_id = Device_Object_List_Identifier(i, &type, &instance);
-        if (check_id) {
-            pObject = Device_Object_Functions_Find(type);
-            if ((pObject != NULL) && (pObject->Object_Name != NULL) &&
-                (pObject->Object_Name(instance, &object_name2) &&
-                 characterstring_same(object_name1, &object_name2))) {
-                found = true;
-                if (object_type) {
-                    *object_type = type;
-                }
-                if (object_instance) {
-                    *object_instance = instance;
-                }
-                break;
-            }
-        }
+/**
+ * @brief Enable or disable the Object_List snapshot.
+ * @details When enabled, the Object_List property is read from a flat
+ *  snapshot of the object identifiers, so that each element is found
+ *  without walking the objects of every object type.  While the
+ *  snapshot is out of date, the Object_List is read from the objects.
+ *  With routing, each of the routed devices has its own snapshot.
+ * @param enable [in] true to take and use the snapshot, false to free it
+ * @return true if the snapshot is enabled
+ */
+bool Device_Object_List_Cache_Enable(bool enable)
+{
+    Object_List_Cache_Enable_Flag = enable;
+    if (enable) {
+        Device_Object_List_Cache_Invalidate();
+        Device_Each_Routed_Device(Device_Object_List_Cache_Refresh);
+    } else {
+        Device_Each_Routed_Device(Device_Object_List_Cache_Free);
+    }
+
+    return Object_List_Cache_Enable_Flag;
+}
+
+/**
+ * @brief Determine if the Object_List snapshot is enabled
+ * @return true if the snapshot is enabled
+ */
+bool Device_Object_List_Cache_Enabled(void)
+{
+    return Object_List_Cache_Enable_Flag;
+}
+
+/* optional cache of the encoded values of the properties that rarely
+   change, so that reading one of them again copies its encoding */
+#ifndef BACNET_PROPERTY_CACHE_SIZE
+#define BACNET_PROPERTY_CACHE_SIZE 64
+#endif
+#ifndef BACNET_PROPERTY_CACHE_OCTETS
+#define BACNET_PROPERTY_CACHE_OCTETS 64
+#endif
+struct property_cache_entry {
+    KEY key;
+    BACNET_PROPERTY_ID property;
+    BACNET_ARRAY_INDEX array_index;
+    uint16_t apdu_len;
+    bool valid;
+    uint8_t apdu[BACNET_PROPERTY_CACHE_OCTETS];
+};
+static struct property_cache_entry *Property_Caches[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Property_Cache (Property_Caches[Routed_Device_Object_Index()])
+#else
+#define Property_Cache (Property_Caches[0])
+#endif
+static bool Property_Cache_Enable_Flag;
+/* false while other threads read the properties at the same time */
+static bool Property_Cache_Store_Flag = true;
+/* counts the changes that discard cached properties, so that the caches
+   of the encoded responses can tell if they are still current */
+static uint32_t Property_Cache_Changes;
+/* the properties that are kept in the cache */
+static const int Property_Cache_Properties[] = {
+    PROP_OBJECT_NAME,
+    PROP_DESCRIPTION,
+    PROP_UNITS,
+    PROP_STATE_TEXT,
+    PROP_ACTIVE_TEXT,
+    PROP_INACTIVE_TEXT,
+    PROP_PROPERTY_LIST,
+    PROP_VENDOR_NAME,
+    PROP_MODEL_NAME,
+    PROP_FIRMWARE_REVISION,
+    PROP_APPLICATION_SOFTWARE_VERSION,
+    PROP_PROTOCOL_SERVICES_SUPPORTED,
+    PROP_PROTOCOL_OBJECT_TYPES_SUPPORTED,
+    -1
+};
+
+/**
+ * @brief Find the cache entry of a property
+ * @param rpdata [in] the object, property, and array index
+ * @return the cache entry that holds the property, or would hold it
+ */
+static struct property_cache_entry *
+Device_Property_Cache_Entry(const BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    uint32_t value[3];
+
+    value[0] = KEY_ENCODE(rpdata->object_type, rpdata->object_instance);
+    value[1] = rpdata->object_property;
+    value[2] = rpdata->array_index;
+
+    return &Property_Cache[Keyhash_FNV1a(value, sizeof(value)) %
+                           BACNET_PROPERTY_CACHE_SIZE];
+}
+
+/**
+ * @brief Determine if an entry holds the property
+ * @param entry [in] the cache entry
+ * @param rpdata [in] the object, property, and array index
+ * @return true if the entry holds the property
+ */
+static bool Device_Property_Cache_Same(
+    const struct property_cache_entry *entry,
+    const BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    return entry->valid &&
+        (entry->key ==
+         KEY_ENCODE(rpdata->object_type, rpdata->object_instance)) &&
+        (entry->property == rpdata->object_property) &&
+        (entry->array_index == rpdata->array_index);
+}
+
+/**
+ * @brief Copy the encoded value of a property from the cache
+ * @param rpdata [in,out] the requested property, and its value on return
+ * @return number of APDU bytes copied, or zero if it is not in the cache
+ */
+static int Device_Property_Cache_Read(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    const struct property_cache_entry *entry;
+
+    if (!Property_Cache || !rpdata->application_data) {
+        return 0;
+    }
+    entry = Device_Property_Cache_Entry(rpdata);
+    if (!Device_Property_Cache_Same(entry, rpdata) ||
+        (entry->apdu_len > rpdata->application_data_len)) {
+        return 0;
+    }
+    memcpy(rpdata->application_data, entry->apdu, entry->apdu_len);
+
+    return entry->apdu_len;
+}
+
+/**
+ * @brief Keep the encoded value of a property in the cache, when it is
+ *  one of the properties that rarely change
+ * @param rpdata [in] the property, and its encoded value
+ * @param apdu_len [in] number of APDU bytes of the encoded value
+ */
+static void Device_Property_Cache_Store(
+    const BACNET_READ_PROPERTY_DATA *rpdata, int apdu_len)
+{
+    struct property_cache_entry *entry;
+
+    if (!Property_Cache || !Property_Cache_Store_Flag || (apdu_len <= 0) ||
+        (apdu_len > BACNET_PROPERTY_CACHE_OCTETS) ||
+        !property_list_member(
+            Property_Cache_Properties, rpdata->object_property)) {
+        return;
+    }
+    entry = Device_Property_Cache_Entry(rpdata);
+    entry->key = KEY_ENCODE(rpdata->object_type, rpdata->object_instance);
+    entry->property = rpdata->object_property;
+    entry->array_index = rpdata->array_index;
+    entry->apdu_len = (uint16_t)apdu_len;
+    memcpy(entry->apdu, rpdata->application_data, apdu_len);
+    entry->valid = true;
+}
+
+/**
+ * @brief Discard the cached properties of an object.
+ * @note WriteProperty, CreateObject, and DeleteObject discard them.
+ *  Call this after a cached property, such as the Object_Name, is
+ *  changed directly, for example with Analog_Input_Name_Set(), when the
+ *  cache is enabled.
+ * @param object_type [in] the object type
+ * @param object_instance [in] the object instance
+ */
+void Device_Property_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    KEY key = KEY_ENCODE(object_type, object_instance);
+    unsigned i;
+
+    Property_Cache_Changes++;
+    if (!Property_Cache) {
+        return;
+    }
+    for (i = 0; i < BACNET_PROPERTY_CACHE_SIZE; i++) {
+        if (Property_Cache[i].key == key) {
+            Property_Cache[i].valid = false;
+        }
+    }
+}
+
+/**
+ * @brief Get the count of the changes that discarded cached properties
+ * @details The count changes with every WriteProperty, CreateObject, and
+ *  DeleteObject, and with every Device_Property_Cache_Invalidate(), even
+ *  when the property cache is disabled.  A cache of encoded responses,
+ *  such as the ReadPropertyMultiple response cache, keeps the count with
+ *  a response and uses the response while the count is the same.
+ * @return the count of changes
+ */
+uint32_t Device_Property_Cache_Changes(void)
+{
+    return Property_Cache_Changes;
+}
+
+/**
+ * @brief Discard the cached properties of every object
+ */
+static void Device_Property_Cache_Clear(void)
+{
+    unsigned i;
+
+    Property_Cache_Changes++;
+    if (!Property_Cache) {
+        return;
+    }
+    for (i = 0; i < BACNET_PROPERTY_CACHE_SIZE; i++) {
+        Property_Cache[i].valid = false;
+    }
+}
+
+/**
+ * @brief Allocate the property cache
+ */
+static void Device_Property_Cache_Alloc(void)
+{
+    if (!Property_Cache) {
+        Property_Cache = calloc(
+            BACNET_PROPERTY_CACHE_SIZE, sizeof(struct property_cache_entry));
+    }
+}
+
+/**
+ * @brief Free the property cache
+ */
+static void Device_Property_Cache_Free(void)
+{
+    free(Property_Cache);
+    Property_Cache = NULL;
+}
+
+/**
+ * @brief Enable or disable the property cache.
+ * @details When enabled, the encoded values of the properties that rarely
+ *  change, such as the names, descriptions, units, state texts, and the
+ *  protocol bit strings, are kept after they are read, and are copied
+ *  into the next ReadProperty or ReadPropertyMultiple response.
+ *  With routing, each of the routed devices has its own cache.
+ * @note Device_Read_Property() keeps the values in the cache.  When other
+ *  threads call it at the same time, such as the BACnet/IP workers in
+ *  their shared read sections, see Device_Property_Cache_Store_Enable().
+ * @param enable [in] true to use the cache, false to free it
+ * @return true if the cache is enabled
+ */
+bool Device_Property_Cache_Enable(bool enable)
+{
+    Property_Cache_Enable_Flag = enable;
+    if (enable) {
+        Device_Each_Routed_Device(Device_Property_Cache_Alloc);
+        Device_Each_Routed_Device(Device_Property_Cache_Clear);
+    } else {
+        Device_Each_Routed_Device(Device_Property_Cache_Free);
+    }
+
+    return Property_Cache_Enable_Flag;
+}
+
+/**
+ * @brief Allow or stop the keeping of values in the property cache.
+ * @details Values are still copied from the cache while they are not
+ *  kept, so that several threads can read the properties at the same
+ *  time without changing the cache.  A thread that holds a lock that
+ *  excludes those readers, such as bip_workers_lock(), allows the keeping
+ *  while it holds the lock, and stops it before it releases the lock.
+ *  The keeping is allowed by default.
+ * @param enable [in] true to keep the values that are read
+ */
+void Device_Property_Cache_Store_Enable(bool enable)
+{
+    Property_Cache_Store_Flag = enable;
+}
+
+/**
+ * @brief Determine if the property cache is enabled
+ * @return true if the cache is enabled
+ */
+bool Device_Property_Cache_Enabled(void)
+{
+    return Property_Cache_Enable_Flag;
+}
+
+/** Get the total count of objects supported by this Device Object.
+ * @note Since many network clients depend on the object list
+ *       for discovery, it must be consistent!
+ * @return The count of objects, for all supported Object types.
+ */
+unsigned Device_Object_List_Count(void)
+{
+    unsigned count = 0; /* number of objects */
+    struct object_functions *pObject = NULL;
+
+    if (Device_Object_List_Cache_Current()) {
+        return Object_List_Cache.count;
+    }
+    /* initialize the default return values */
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if (pObject->Object_Count) {
+            count += pObject->Object_Count();
+        }
+        pObject++;
+    }
+
+    return count;
+}
+
+/** Lookup the Object at the given array index in the Device's Object List.
+ * Even though we don't keep a single linear array of objects in the Device,
+ * this method acts as though we do and works through a virtual, concatenated
+ * array of all of our object type arrays.
+ *
+ * When the Object_List snapshot is enabled and current, the object is
+ * taken from the snapshot instead.
+ *
+ * @param array_index [in] The desired array index (1 to N)
+ * @param object_type [out] The object's type, if found.
+ * @param instance [out] The object's instance number, if found.
+ * @return True if found, else false.
+ */
+bool Device_Object_List_Identifier(
+    uint32_t array_index, BACNET_OBJECT_TYPE *object_type, uint32_t *instance)
+{
+    bool status = false;
+    uint32_t count = 0;
+    uint32_t object_index = 0;
+    uint32_t temp_index = 0;
+    struct object_functions *pObject = NULL;
+
+    /* array index zero is length - so invalid */
+    if (array_index == 0) {
+        return status;
+    }
+    if (Device_Object_List_Cache_Current()) {
+        if (array_index > Object_List_Cache.count) {
+            return status;
+        }
+        temp_index = Object_List_Cache.list[array_index - 1];
+        *object_type = (BACNET_OBJECT_TYPE)BACNET_TYPE(temp_index);
+        *instance = BACNET_INSTANCE(temp_index);
+        if (*object_type == OBJECT_DEVICE) {
+            /* a routed device may be renumbered by the gateway */
+            *instance = Device_Object_Instance_Number();
+        }
+        return true;
+    }
+    object_index = array_index - 1;
+    /* initialize the default return values */
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if (pObject->Object_Count) {
+            object_index -= count;
+            count = pObject->Object_Count();
+            if (object_index < count) {
+                /* Use the iterator function if available otherwise
+                 * look for the index to instance to get the ID */
+                if (pObject->Object_Iterator) {
+                    /* First find the first object */
+                    temp_index = pObject->Object_Iterator(~(unsigned)0);
+                    /* Then step through the objects to find the nth */
+                    while (object_index != 0) {
+                        temp_index = pObject->Object_Iterator(temp_index);
+                        object_index--;
+                    }
+                    /* set the object_index up before falling through to next
+                     * bit */
+                    object_index = temp_index;
+                }
+                if (pObject->Object_Index_To_Instance) {
+                    *object_type = pObject->Object_Type;
+                    *instance = pObject->Object_Index_To_Instance(object_index);
+                    status = true;
+                    break;
+                }
+            }
+        }
+        pObject++;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Encode a BACnetARRAY property element
+ * @param object_instance [in] BACnet network port object instance number
+ * @param array_index [in] array index requested:
+ *    0 to N for individual array members
+ * @param apdu [out] Buffer in which the APDU contents are built, or NULL to
+ * return the length of buffer if it had been built
+ * @return The length of the apdu encoded or
+ *   BACNET_STATUS_ERROR for ERROR_CODE_INVALID_ARRAY_INDEX
+ */
+int Device_Object_List_Element_Encode(
+    uint32_t object_instance, BACNET_ARRAY_INDEX array_index, uint8_t *apdu)
+{
+    int apdu_len = BACNET_STATUS_ERROR;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t instance;
+    bool found;
+
+    if (object_instance == Device_Object_Instance_Number()) {
+        /* single element is zero based, add 1 for BACnetARRAY which is one
+         * based */
+        array_index++;
+        found =
+            Device_Object_List_Identifier(array_index, &object_type, &instance);
+        if (found) {
+            apdu_len =
+                encode_application_object_id(apdu, object_type, instance);
+        }
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode consecutive elements of the Object_List property,
+ *  as many as fit in the buffer.
+ * @param array_index [in] the first element to encode (1 to N)
+ * @param count [in] the most elements to encode
+ * @param apdu [out] Buffer in which the APDU contents are built, or NULL to
+ * return the length of buffer if it had been built
+ * @param apdu_size [in] size of the buffer
+ * @param item_count [out] the number of elements encoded, or NULL
+ * @return The length of the apdu encoded
+ */
+int Device_Object_List_Range_Encode(
+    uint32_t array_index,
+    uint32_t count,
+    uint8_t *apdu,
+    size_t apdu_size,
+    uint32_t *item_count)
+{
+    int apdu_len = 0, len = 0;
+    uint32_t items = 0;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t instance;
+
+    while ((items < count) &&
+           Device_Object_List_Identifier(
+               array_index + items, &object_type, &instance)) {
+        len = encode_application_object_id(NULL, object_type, instance);
+        if ((size_t)(apdu_len + len) > apdu_size) {
+            break;
+        }
+        if (apdu) {
+            len = encode_application_object_id(
+                &apdu[apdu_len], object_type, instance);
+        }
+        apdu_len += len;
+        items++;
+    }
+    if (item_count) {
+        *item_count = items;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the Object_List property for a ReadRange by position
+ * @param apdu [out] buffer for the ReadRange-ACK item data
+ * @param pRequest [in,out] the ReadRange request and result flags
+ * @return The length of the apdu encoded
+ */
+static int Device_Object_List_RR_Encode(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    int apdu_len = 0;
+    int32_t first = 0;
+    uint32_t total = 0, target = 0;
+
+    bitstring_init(&pRequest->ResultFlags);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, false);
+    pRequest->ItemCount = 0;
+    total = Device_Object_List_Count();
+    if (pRequest->RequestType == RR_READ_ALL) {
+        pRequest->Count = total;
+        pRequest->Range.RefIndex = 1;
+    }
+    if (pRequest->Count < 0) {
+        /* negative count is from the index backwards */
+        first = pRequest->Range.RefIndex;
+        first += pRequest->Count + 1;
+        if (first < 1) {
+            pRequest->Count = pRequest->Range.RefIndex;
+            pRequest->Range.RefIndex = 1;
+        } else {
+            pRequest->Range.RefIndex = first;
+            pRequest->Count = -pRequest->Count;
+        }
+    }
+    if ((pRequest->Range.RefIndex == 0) || (pRequest->Range.RefIndex > total)) {
+        return 0;
+    }
+    target = total - pRequest->Range.RefIndex + 1;
+    if ((uint32_t)pRequest->Count < target) {
+        target = pRequest->Count;
+    }
+    apdu_len = Device_Object_List_Range_Encode(
+        pRequest->Range.RefIndex, target, apdu,
+        MAX_APDU - pRequest->Overhead, &pRequest->ItemCount);
+    if (pRequest->ItemCount == 0) {
+        return apdu_len;
+    }
+    if (pRequest->Range.RefIndex == 1) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
+    }
+    if ((pRequest->Range.RefIndex + pRequest->ItemCount - 1) == total) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
+    }
+    if (pRequest->ItemCount < target) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, true);
+    }
+
+    return apdu_len;
+}
+
+/* optional index of object names: name hash to object key, and
+   the reverse of object key to name hash for renames and deletes */
+static OS_Keyhash Object_Name_Indexes[MAX_NUM_DEVICES];
+static OS_Keyhash Object_Name_Index_Reverses[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Object_Name_Index (Object_Name_Indexes[Routed_Device_Object_Index()])
+#define Object_Name_Index_Reverse \
+    (Object_Name_Index_Reverses[Routed_Device_Object_Index()])
+#else
+#define Object_Name_Index (Object_Name_Indexes[0])
+#define Object_Name_Index_Reverse (Object_Name_Index_Reverses[0])
+#endif
+
+/**
+ * @brief Compute the hash of an object name for the object name index
+ * @param object_name [in] The object name
+ * @return hash of the object name value
+ */
+static uint32_t Device_Object_Name_Hash(
+    const BACNET_CHARACTER_STRING *object_name)
+{
+    return Keyhash_FNV1a(
+        characterstring_value(object_name),
+        characterstring_length(object_name));
+}
+
+/**
+ * @brief Remove an object from the object name index
+ * @param object_type [in] The BACNET_OBJECT_TYPE of the object
+ * @param object_instance [in] The object instance number of the object
+ */
+void Device_Object_Name_Index_Remove(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    KEY key = KEY_ENCODE(object_type, object_instance);
+    KEY name_hash = 0;
+    unsigned iterator = 0;
+
+    if (!Object_Name_Index) {
+        return;
+    }
+    while (Keyhash_Find(
+        Object_Name_Index_Reverse, key, &iterator, &name_hash)) {
+        (void)Keyhash_Remove(Object_Name_Index, name_hash, key);
+        (void)Keyhash_Remove(Object_Name_Index_Reverse, key, name_hash);
+    }
+}
+
+/**
+ * @brief Add or refresh an object in the object name index.
+ * @note Call this after an object is created or renamed outside of
+ *  the WriteProperty and CreateObject services, for example after
+ *  calling Analog_Input_Name_Set(), when the index is enabled.
+ *  The Device object is not kept in the index, since a routed
+ *  device may be renamed by the gateway functions.
+ * @param object_type [in] The BACNET_OBJECT_TYPE of the object
+ * @param object_instance [in] The object instance number of the object
+ */
+void Device_Object_Name_Index_Update(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    KEY key = KEY_ENCODE(object_type, object_instance);
+    BACNET_CHARACTER_STRING object_name;
+    uint32_t name_hash;
+
+    if (!Object_Name_Index || (object_type == OBJECT_DEVICE)) {
+        return;
+    }
+    Device_Object_Name_Index_Remove(object_type, object_instance);
+    if (Device_Object_Name_Copy(object_type, object_instance, &object_name)) {
+        name_hash = Device_Object_Name_Hash(&object_name);
+        (void)Keyhash_Add(Object_Name_Index, name_hash, key);
+        (void)Keyhash_Add(Object_Name_Index_Reverse, key, name_hash);
+    }
+}
+
+/**
+ * @brief Rebuild the object name index from every object in the device
+ */
+void Device_Object_Name_Index_Rebuild(void)
+{
+    BACNET_OBJECT_TYPE type = OBJECT_NONE;
+    uint32_t instance = 0;
+    uint32_t max_objects = 0, i = 0;
+
+    if (!Object_Name_Index) {
+        return;
+    }
+    Keyhash_Clear(Object_Name_Index);
+    Keyhash_Clear(Object_Name_Index_Reverse);
+    max_objects = Device_Object_List_Count();
+    for (i = 1; i <= max_objects; i++) {
+        if (Device_Object_List_Identifier(i, &type, &instance)) {
+            Device_Object_Name_Index_Update(type, instance);
+        }
+    }
+}
+
+/**
+ * @brief Free the object name index
+ */
+static void Device_Object_Name_Index_Free(void)
+{
+    Keyhash_Delete(Object_Name_Index);
+    Keyhash_Delete(Object_Name_Index_Reverse);
+    Object_Name_Index = NULL;
+    Object_Name_Index_Reverse = NULL;
+}
+
+/**
+ * @brief Create and build the object name index
+ */
+static void Device_Object_Name_Index_Create(void)
+{
+    if (!Object_Name_Index) {
+        Object_Name_Index = Keyhash_Create();
+        Object_Name_Index_Reverse = Keyhash_Create();
+        if (!Object_Name_Index || !Object_Name_Index_Reverse) {
+            Device_Object_Name_Index_Free();
+            return;
+        }
+    }
+    Device_Object_Name_Index_Rebuild();
+}
+
+/**
+ * @brief Enable or disable the object name index.
+ * @details When enabled, Device_Valid_Object_Name() looks up names
+ *  in a hash index instead of reading the name of every object.
+ *  The index follows objects created, deleted, or renamed through
+ *  the BACnet services.  Applications that change object names
+ *  directly must call Device_Object_Name_Index_Update().
+ *  With routing, each of the routed devices has its own index, so
+ *  enable the index after the routed devices are added.
+ * @param enable [in] true to build and use the index, false to free it
+ * @return true if the index is enabled
+ */
+bool Device_Object_Name_Index_Enable(bool enable)
+{
+    if (enable) {
+        Device_Each_Routed_Device(Device_Object_Name_Index_Create);
+    } else {
+        Device_Each_Routed_Device(Device_Object_Name_Index_Free);
+    }
+
+    return Object_Name_Index != NULL;
+}
+
+/**
+ * @brief Determine if the object name index is enabled
+ * @return true if the index is enabled
+ */
+bool Device_Object_Name_Index_Enabled(void)
+{
+    return Object_Name_Index != NULL;
+}
+
+/**
+ * @brief Look for an object name using the object name index
+ * @param object_name1 [in] The desired Object Name to look for.
+ * @param object_type [out] The BACNET_OBJECT_TYPE of the matching Object.
+ * @param object_instance [out] The instance number of the matching Object.
+ * @return True on success or else False if not found.
+ */
+static bool Device_Object_Name_Index_Find(
+    const BACNET_CHARACTER_STRING *object_name1,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance)
+{
+    BACNET_CHARACTER_STRING object_name2;
+    BACNET_OBJECT_TYPE type;
+    uint32_t instance;
+    unsigned iterator = 0;
+    KEY key = 0;
+
+    /* the Device object is compared first, as it is first in the
+       Object_List, and is not in the index */
+    type = OBJECT_DEVICE;
+    instance = Device_Object_Instance_Number();
+    if (Device_Object_Name_Copy(type, instance, &object_name2) &&
+        characterstring_same(object_name1, &object_name2)) {
+        if (object_type) {
+            *object_type = type;
+        }
+        if (object_instance) {
+            *object_instance = instance;
+        }
+        return true;
+    }
+    while (Keyhash_Find(
+        Object_Name_Index, Device_Object_Name_Hash(object_name1), &iterator,
+        &key)) {
+        type = (BACNET_OBJECT_TYPE)KEY_DECODE_TYPE(key);
+        instance = (uint32_t)KEY_DECODE_ID(key);
+        /* different names may have the same hash */
+        if (Device_Object_Name_Copy(type, instance, &object_name2) &&
+            characterstring_same(object_name1, &object_name2)) {
+            if (object_type) {
+                *object_type = type;
+            }
+            if (object_instance) {
+                *object_instance = instance;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** Determine if we have an object with the given object_name.
+ * If the object_type and object_instance pointers are not null,
+ * and the lookup succeeds, they will be given the resulting values.
+ * @param object_name [in] The desired Object Name to look for.
+ * @param object_type [out] The BACNET_OBJECT_TYPE of the matching Object.
+ * @param object_instance [out] The object instance number of the matching
+ * Object.
+ * @return True on success or else False if not found.
+ */
+bool Device_Valid_Object_Name(
+    const BACNET_CHARACTER_STRING *object_name1,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance)
+{
+    bool found = false;
+    BACNET_OBJECT_TYPE type = OBJECT_NONE;
+    uint32_t instance;
+    uint32_t max_objects = 0, i = 0;
+    bool check_id = false;
+    BACNET_CHARACTER_STRING object_name2;
+    struct object_functions *pObject = NULL;
+
+    if (Object_Name_Index) {
+        return Device_Object_Name_Index_Find(
+            object_name1, object_type, object_instance);
+    }
+    max_objects = Device_Object_List_Count();
+    for (i = 1; i <= max_objects; i++) {
+        check_id = Device_Object_List_Identifier(i, &type, &instance);
+        if (check_id) {
+            pObject = Device_Object_Functions_Find(type);
+            if ((pObject != NULL) && (pObject->Object_Name != NULL) &&
+                (pObject->Object_Name(instance, &object_name2) &&
+                 characterstring_same(object_name1, &object_name2))) {
+                found = true;
+                if (object_type) {
+                    *object_type = type;
+                }
+                if (object_instance) {
+                    *object_instance = instance;
+                }
+                break;
+            }
+        }
     }
 
     return found;
@@ -2327,10 +3625,58 @@ bool Device_Object_Name_Copy(
     return found;
 }
 
-static void Update_Current_Time(void)
+/**
+ * @brief Read the clock from the OS into the Local_Date and Local_Time
+ */
+static void Device_Local_Time_Read(void)
 {
     datetime_local(
         &Local_Date, &Local_Time, &UTC_Offset, &Daylight_Savings_Status);
+    Local_Time_Refreshed.date = Local_Date;
+    Local_Time_Refreshed.time = Local_Time;
+    Local_Time_Elapsed_Milliseconds = 0;
+}
+
+/**
+ * @brief Read the clock from the OS now, instead of at the end of the
+ *  refresh period, such as after the clock was set by a TimeSynchronization
+ */
+void Device_Local_Time_Refresh(void)
+{
+    Device_Local_Time_Read();
+}
+
+/**
+ * @brief Move the cached clock along by the elapsed time, and read the
+ *  clock from the OS at the end of each refresh period
+ * @param milliseconds - number of milliseconds elapsed
+ */
+static void Device_Local_Time_Timer(uint16_t milliseconds)
+{
+    BACNET_DATE_TIME bdatetime;
+    uint32_t elapsed;
+
+    elapsed = (uint32_t)Local_Time_Elapsed_Milliseconds + milliseconds;
+    if (!Local_Time_Cached ||
+        (elapsed >= BACNET_DEVICE_LOCAL_TIME_REFRESH_MS)) {
+        Device_Local_Time_Read();
+        Local_Time_Cached = true;
+    } else if (milliseconds) {
+        /* from the last read, so that the remainders of the hundredths
+           of the short ticks are not lost */
+        Local_Time_Elapsed_Milliseconds = (uint16_t)elapsed;
+        bdatetime = Local_Time_Refreshed;
+        datetime_add_milliseconds(&bdatetime, (int32_t)elapsed);
+        Local_Date = bdatetime.date;
+        Local_Time = bdatetime.time;
+    }
+}
+
+static void Update_Current_Time(void)
+{
+    if (!Local_Time_Cached) {
+        Device_Local_Time_Read();
+    }
 }
 
 void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
@@ -2723,6 +4069,59 @@ void Device_Backup_Failure_Timeout_Countdown(uint32_t milliseconds)
 #endif
 }
 
+#if BACNET_PERFSTAT_ENABLED
+/**
+ * @brief Encode a stack statistic of the Device object
+ * @param apdu - buffer for the encoding
+ * @param property - one of the PROP_PERFSTAT_ properties of the Device
+ * @return number of bytes encoded, or zero if the property is not a
+ *  stack statistic of the Device object
+ */
+static int Device_Perfstat_Encode(uint8_t *apdu, uint32_t property)
+{
+    uint32_t value = 0;
+
+    switch (property) {
+        case PROP_PERFSTAT_DECODE_ERRORS:
+            value = perfstat_counter(PERFSTAT_DECODE_ERRORS);
+            break;
+        case PROP_PERFSTAT_CONFIRMED_REQUESTS:
+            value = perfstat_confirmed_requests();
+            break;
+        case PROP_PERFSTAT_UNCONFIRMED_REQUESTS:
+            value = perfstat_unconfirmed_requests();
+            break;
+        case PROP_PERFSTAT_TSM_ACTIVE_TRANSACTIONS:
+#if MAX_TSM_TRANSACTIONS
+            value = MAX_TSM_TRANSACTIONS - tsm_transaction_idle_count();
+#endif
+            break;
+        case PROP_PERFSTAT_TSM_RETRIES:
+            value = perfstat_counter(PERFSTAT_TSM_RETRIES);
+            break;
+        case PROP_PERFSTAT_TSM_TIMEOUTS:
+            value = perfstat_counter(PERFSTAT_TSM_TIMEOUTS);
+            break;
+        case PROP_PERFSTAT_COV_SUBSCRIPTIONS:
+            value = handler_cov_subscription_count();
+            break;
+        case PROP_PERFSTAT_COV_NOTIFICATIONS:
+            value = perfstat_counter(PERFSTAT_COV_NOTIFICATIONS);
+            break;
+        case PROP_PERFSTAT_ADDRESS_CACHE_HITS:
+            value = perfstat_counter(PERFSTAT_ADDRESS_CACHE_HITS);
+            break;
+        case PROP_PERFSTAT_ADDRESS_CACHE_MISSES:
+            value = perfstat_counter(PERFSTAT_ADDRESS_CACHE_MISSES);
+            break;
+        default:
+            return 0;
+    }
+
+    return encode_application_unsigned(apdu, value);
+}
+#endif
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -2738,7 +4137,6 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_len = 0; /* return value */
     BACNET_BIT_STRING bit_string = { 0 };
     BACNET_CHARACTER_STRING char_string = { 0 };
-    uint32_t i = 0;
     uint32_t count = 0;
     uint8_t *apdu = NULL;
     struct object_functions *pObject = NULL;
@@ -2826,23 +4224,15 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
         case PROP_PROTOCOL_SERVICES_SUPPORTED:
             /* Note: list of services that are executed, not initiated. */
-            bitstring_init(&bit_string);
-            for (i = 0; i < MAX_BACNET_SERVICES_SUPPORTED; i++) {
-                /* automatic lookup based on handlers set */
-                bitstring_set_bit(
-                    &bit_string, (uint8_t)i,
-                    apdu_service_supported((BACNET_SERVICES_SUPPORTED)i));
-            }
+            /* automatic lookup based on handlers set */
+            apdu_services_supported(&bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_PROTOCOL_OBJECT_TYPES_SUPPORTED:
             /* Note: this is the list of objects that can be in this device,
                not a list of objects that this device can access */
-            bitstring_init(&bit_string);
-            for (i = 0; i < MAX_ASHRAE_OBJECT_TYPE; i++) {
-                /* initialize all the object types to not-supported */
-                bitstring_set_bit(&bit_string, (uint8_t)i, false);
-            }
+            /* initialize all the object types to not-supported */
+            bitstring_init_octets(&bit_string, NULL, MAX_ASHRAE_OBJECT_TYPE);
             /* set the object types with objects to supported */
 
             pObject = Object_Table;
@@ -2885,6 +4275,16 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
         case PROP_NUMBER_OF_APDU_RETRIES:
             apdu_len = encode_application_unsigned(&apdu[0], apdu_retries());
             break;
+#if BACNET_SEGMENTATION_ENABLED
+        case PROP_MAX_SEGMENTS_ACCEPTED:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], BACNET_MAX_SEGMENTS_ACCEPTED);
+            break;
+        case PROP_APDU_SEGMENT_TIMEOUT:
+            apdu_len =
+                encode_application_unsigned(&apdu[0], apdu_segment_timeout());
+            break;
+#endif
         case PROP_DEVICE_ADDRESS_BINDING:
             apdu_len = address_list_encode(&apdu[0], apdu_max);
             break;
@@ -2980,6 +4380,13 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
                 bacapp_encode_timestamp(&apdu[0], &Time_Of_Device_Restart);
             break;
         default:
+#if BACNET_PERFSTAT_ENABLED
+            apdu_len =
+                Device_Perfstat_Encode(&apdu[0], rpdata->object_property);
+            if (apdu_len > 0) {
+                break;
+            }
+#endif
             rpdata->error_class = ERROR_CLASS_PROPERTY;
             rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
             apdu_len = BACNET_STATUS_ERROR;
@@ -3048,6 +4455,8 @@ static int Read_Property_Common(
  * APDU.
  * @ingroup ObjIntf
  * If the Object or Property can't be found, sets the error class and code.
+ * Threads that call this at the same time must not keep values in the
+ * property cache, see Device_Property_Cache_Store_Enable().
  *
  * @param rpdata [in,out] Structure with the desired Object and Property info
  *                 on entry, and APDU message on return.
@@ -3069,7 +4478,11 @@ int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     if (pObject != NULL) {
         if (pObject->Object_Valid_Instance &&
             pObject->Object_Valid_Instance(rpdata->object_instance)) {
-            apdu_len = Read_Property_Common(pObject, rpdata);
+            apdu_len = Device_Property_Cache_Read(rpdata);
+            if (apdu_len == 0) {
+                apdu_len = Read_Property_Common(pObject, rpdata);
+                Device_Property_Cache_Store(rpdata, apdu_len);
+            }
         } else {
             rpdata->error_class = ERROR_CLASS_OBJECT;
             rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
@@ -3138,6 +4551,23 @@ bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 apdu_timeout_set((uint16_t)value.type.Unsigned_Int);
             }
             break;
+#if BACNET_SEGMENTATION_ENABLED
+        case PROP_APDU_SEGMENT_TIMEOUT:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                if ((value.type.Unsigned_Int > 0) &&
+                    (value.type.Unsigned_Int <= UINT16_MAX)) {
+                    apdu_segment_timeout_set(
+                        (uint16_t)value.type.Unsigned_Int);
+                } else {
+                    status = false;
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                }
+            }
+            break;
+#endif
         case PROP_VENDOR_IDENTIFIER:
             status = write_property_type_valid(
                 wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
@@ -3433,6 +4863,10 @@ static bool Device_Write_Property_Object_Name(
         } else {
             status = Object_Write_Property(wp_data);
         }
+        if (status) {
+            Device_Object_Name_Index_Update(
+                wp_data->object_type, wp_data->object_instance);
+        }
     }
 
     return status;
@@ -3501,6 +4935,8 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     }
                 }
                 if (status) {
+                    Device_Property_Cache_Invalidate(
+                        wp_data->object_type, wp_data->object_instance);
                     Device_Write_Property_Store(wp_data);
                 }
             } else {
@@ -3621,82 +5057,218 @@ int Device_Remove_List_Element(BACNET_LIST_ELEMENT_DATA *list_element)
         list_element->error_code = ERROR_CODE_UNKNOWN_OBJECT;
     }
 
-    return status;
+    return status;
+}
+
+/** Looks up the requested Object, and fills the Property Value list.
+ * If the Object or Property can't be found, returns false.
+ * @ingroup ObjHelpers
+ * @param [in] The object type to be looked up.
+ * @param [in] The object instance number to be looked up.
+ * @param [out] The value list
+ * @return True if the object instance supports this feature
+ *         and was encoded correctly
+ */
+bool Device_Encode_Value_List(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    bool status = false; /* Ever the pessimist! */
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject != NULL) {
+        if (pObject->Object_Valid_Instance &&
+            pObject->Object_Valid_Instance(object_instance)) {
+            if (pObject->Object_Value_List) {
+                status =
+                    pObject->Object_Value_List(object_instance, value_list);
+            }
+        }
+    }
+
+    return (status);
+}
+
+/** Checks the COV flag in the requested Object
+ * @ingroup ObjHelpers
+ * @param [in] The object type to be looked up.
+ * @param [in] The object instance to be looked up.
+ * @return True if the COV flag is set
+ */
+bool Device_COV(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    bool status = false; /* Ever the pessamist! */
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject != NULL) {
+        if (pObject->Object_Valid_Instance &&
+            pObject->Object_Valid_Instance(object_instance)) {
+            if (pObject->Object_COV) {
+                status = pObject->Object_COV(object_instance);
+            }
+        }
+    }
+
+    return (status);
+}
+
+/** Clears the COV flag in the requested Object
+ * @ingroup ObjHelpers
+ * @param [in] The object type to be looked up.
+ * @param [in] The object instance to be looked up.
+ */
+void Device_COV_Clear(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject != NULL) {
+        if (pObject->Object_Valid_Instance &&
+            pObject->Object_Valid_Instance(object_instance)) {
+            if (pObject->Object_COV_Clear) {
+                pObject->Object_COV_Clear(object_instance);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reads the REAL Present_Value of a local object, without the
+ *  encoding and decoding of a ReadProperty
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param value - [out] the Present_Value
+ * @return true if the object type has a REAL Present_Value, and the
+ *  object instance is valid
+ */
+bool Device_Present_Value_Real(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, float *value)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject && pObject->Object_Present_Value_Real) {
+        return pObject->Object_Present_Value_Real(object_instance, value);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Gets the function that reads the REAL Present_Value of an
+ *  object type, for a caller that reads the same object repeatedly
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @return the read function, or NULL if the object type has none
+ */
+object_present_value_real_function
+Device_Present_Value_Real_Function(BACNET_OBJECT_TYPE object_type)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject) {
+        return pObject->Object_Present_Value_Real;
+    }
+
+    return NULL;
 }
 
-/** Looks up the requested Object, and fills the Property Value list.
- * If the Object or Property can't be found, returns false.
+/**
+ * @brief Reads the ENUMERATED Present_Value of a local object
  * @ingroup ObjHelpers
- * @param [in] The object type to be looked up.
- * @param [in] The object instance number to be looked up.
- * @param [out] The value list
- * @return True if the object instance supports this feature
- *         and was encoded correctly
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param value - [out] the Present_Value
+ * @return true if the object type has an ENUMERATED Present_Value, and
+ *  the object instance is valid
  */
-bool Device_Encode_Value_List(
+bool Device_Present_Value_Enumerated(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, uint32_t *value)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject && pObject->Object_Present_Value_Enumerated) {
+        return pObject->Object_Present_Value_Enumerated(
+            object_instance, value);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Reads the Unsigned Present_Value of a local object
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param value - [out] the Present_Value
+ * @return true if the object type has an Unsigned Present_Value, and
+ *  the object instance is valid
+ */
+bool Device_Present_Value_Unsigned(
     BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
-    BACNET_PROPERTY_VALUE *value_list)
+    BACNET_UNSIGNED_INTEGER *value)
 {
-    bool status = false; /* Ever the pessimist! */
     struct object_functions *pObject = NULL;
 
     pObject = Device_Object_Functions_Find(object_type);
-    if (pObject != NULL) {
-        if (pObject->Object_Valid_Instance &&
-            pObject->Object_Valid_Instance(object_instance)) {
-            if (pObject->Object_Value_List) {
-                status =
-                    pObject->Object_Value_List(object_instance, value_list);
-            }
-        }
+    if (pObject && pObject->Object_Present_Value_Unsigned) {
+        return pObject->Object_Present_Value_Unsigned(object_instance, value);
     }
 
-    return (status);
+    return false;
 }
 
-/** Checks the COV flag in the requested Object
+/**
+ * @brief Reads the BOOLEAN Present_Value of a local object
  * @ingroup ObjHelpers
- * @param [in] The object type to be looked up.
- * @param [in] The object instance to be looked up.
- * @return True if the COV flag is set
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param value - [out] the Present_Value
+ * @return true if the object type has a BOOLEAN Present_Value, and
+ *  the object instance is valid
  */
-bool Device_COV(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+bool Device_Present_Value_Boolean(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool *value)
 {
-    bool status = false; /* Ever the pessamist! */
     struct object_functions *pObject = NULL;
 
     pObject = Device_Object_Functions_Find(object_type);
-    if (pObject != NULL) {
-        if (pObject->Object_Valid_Instance &&
-            pObject->Object_Valid_Instance(object_instance)) {
-            if (pObject->Object_COV) {
-                status = pObject->Object_COV(object_instance);
-            }
-        }
+    if (pObject && pObject->Object_Present_Value_Boolean) {
+        return pObject->Object_Present_Value_Boolean(object_instance, value);
     }
 
-    return (status);
+    return false;
 }
 
-/** Clears the COV flag in the requested Object
+/**
+ * @brief Reads the Status_Flags of a local object
  * @ingroup ObjHelpers
- * @param [in] The object type to be looked up.
- * @param [in] The object instance to be looked up.
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param status_flags - [out] the Status_Flags
+ * @return true if the object type has a Status_Flags reader, and
+ *  the object instance is valid
  */
-void Device_COV_Clear(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+bool Device_Status_Flags(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_BIT_STRING *status_flags)
 {
     struct object_functions *pObject = NULL;
 
     pObject = Device_Object_Functions_Find(object_type);
-    if (pObject != NULL) {
-        if (pObject->Object_Valid_Instance &&
-            pObject->Object_Valid_Instance(object_instance)) {
-            if (pObject->Object_COV_Clear) {
-                pObject->Object_COV_Clear(object_instance);
-            }
-        }
+    if (pObject && pObject->Object_Status_Flags) {
+        return pObject->Object_Status_Flags(object_instance, status_flags);
     }
+
+    return false;
 }
 
 /**
@@ -3730,6 +5302,10 @@ bool Device_Create_Object(BACNET_CREATE_OBJECT_DATA *data)
     }
     if (status) {
         Device_Inc_Database_Revision();
+        Device_Object_Name_Index_Update(
+            data->object_type, data->object_instance);
+        Device_Property_Cache_Invalidate(
+            data->object_type, data->object_instance);
     }
 
     return status;
@@ -3762,6 +5338,10 @@ bool Device_Delete_Object(BACNET_DELETE_OBJECT_DATA *data)
             status = pObject->Object_Delete(data->object_instance);
             if (status) {
                 Device_Inc_Database_Revision();
+                Device_Object_Name_Index_Remove(
+                    data->object_type, data->object_instance);
+                Device_Property_Cache_Invalidate(
+                    data->object_type, data->object_instance);
             } else {
                 /* The object exists but cannot be deleted. */
                 data->error_class = ERROR_CLASS_OBJECT;
@@ -3813,11 +5393,95 @@ void Device_Delete_Objects(void)
                         continue;
                     }
                 }
-                pObject->Object_Delete(instance);
+                if (pObject->Object_Delete(instance)) {
+                    Device_Object_Name_Index_Remove(
+                        pObject->Object_Type, instance);
+                }
             }
         }
         pObject++;
     }
+    Device_Object_List_Cache_Invalidate();
+}
+
+/**
+ * @brief Encode an object as a BACnet CreateObject service request
+ *  with List of Initial Values for every writable property
+ * @param object_type - type of the object
+ * @param object_instance - instance number of the object
+ * @param apdu - buffer for the encoding
+ * @param apdu_size - size of the buffer
+ * @return number of bytes encoded, or zero or negative on error
+ */
+static int Device_Object_Create_Encode(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint8_t *apdu,
+    size_t apdu_size)
+{
+    const int32_t *writable_properties = NULL;
+    struct special_property_list_t property_list = { 0 };
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+
+    Device_Objects_Property_List(object_type, object_instance, &property_list);
+    (void)Device_Objects_Writable_Property_List(
+        object_type, object_instance, &writable_properties);
+    create_data.object_type = object_type;
+    create_data.object_instance = object_instance;
+    create_data.application_data_len = 0;
+
+    return create_object_writable_properties_encode(
+        apdu, apdu_size, &create_data, property_list.Required.pList,
+        property_list.Optional.pList, property_list.Proprietary.pList,
+        writable_properties, Device_Read_Property);
+}
+
+/**
+ * @brief Loop through the Device object-list property and export to
+ *  a file as BACnet CreateObject services with List of Initial Values
+ *  for every writable property
+ */
+void Device_Start_Backup(void)
+{
+#if defined BACNET_BACKUP_RESTORE
+    size_t i = 0;
+    uint32_t object_count = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    uint8_t object_apdu[MAX_APDU] = { 0 };
+    bool status = false;
+    int32_t len = 0, offset = 0;
+
+    object_count = Device_Object_List_Count();
+    for (i = 0; i < object_count; i++) {
+        /* get the object type and instance from the device object list */
+        status = Device_Object_List_Identifier(
+            (uint32_t)(i + 1), &object_type, &object_instance);
+        if (status) {
+            len = Device_Object_Create_Encode(
+                object_type, object_instance, object_apdu,
+                sizeof(object_apdu));
+            if (len > 0) {
+                (void)bacfile_write_offset(
+                    Configuration_Files[0], offset, &object_apdu[0],
+                    (uint32_t)len);
+                offset += len;
+            }
+        }
+    }
+    Backup_State = BACKUP_STATE_PERFORMING_A_BACKUP;
+#endif
+}
+
+/**
+ * @brief Create files for backup and restore, if supported, and set the state
+ * to performing a restore
+ */
+void Device_Start_Restore(void)
+{
+#if defined BACNET_BACKUP_RESTORE
+    Backup_State = BACKUP_STATE_PERFORMING_A_RESTORE;
+#endif
 }
 
 /**
@@ -3825,158 +5489,384 @@ void Device_Delete_Objects(void)
  *  a file as BACnet CreateObject services with List of Initial Values
  *  for every writable property
  */
-void Device_Start_Backup(void)
+void Device_End_Restore(void)
+{
+#if defined BACNET_BACKUP_RESTORE
+    BACNET_DATE_TIME bdateTime = { 0 };
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int32_t apdu_len = 0, offset = 0, file_size = 0;
+    int decoded_len = 0;
+
+    datetime_local(&bdateTime.date, &bdateTime.time, NULL, NULL);
+    bacapp_timestamp_datetime_set(&Last_Restore_Time, &bdateTime);
+    /* delete all existing objects before restore */
+    Device_Delete_Objects();
+    /* create objects from the backup file */
+    file_size = bacfile_file_size(Configuration_Files[0]);
+    while (offset < file_size) {
+        apdu_len = bacfile_read_offset(
+            Configuration_Files[0], offset, &apdu[0], sizeof(apdu));
+        if (apdu_len > 0) {
+            decoded_len = create_object_decode_service_request(
+                apdu, apdu_len, &create_data);
+            if (decoded_len > 0) {
+                offset += decoded_len;
+                create_data.error_class = ERROR_CLASS_PROPERTY;
+                create_data.error_code = ERROR_CODE_SUCCESS;
+                create_data.continue_on_error = true;
+                if (Device_Create_Object(&create_data)) {
+                    /* object created and initialized successfully */
+                } else {
+                    /* error creating object - keep going */
+                }
+            } else {
+                Backup_State = BACKUP_STATE_RESTORE_FAILURE;
+                /* error while decoding object  */
+                break;
+            }
+        } else {
+            Backup_State = BACKUP_STATE_RESTORE_FAILURE;
+            /* error while reading file  */
+            break;
+        }
+    }
+    if (Backup_State != BACKUP_STATE_RESTORE_FAILURE) {
+        Backup_State = BACKUP_STATE_IDLE;
+    }
+#endif
+}
+
+/**
+ * @brief Save every object that can be created into a snapshot,
+ *  so that a large object database is restored at startup without
+ *  parsing the configuration again.
+ *
+ *  The snapshot is a header, one record for each object, and a trailer.
+ *  Each record is the length and a CreateObject service request with
+ *  List of Initial Values for every writable property, as the backup
+ *  file uses.  Object structs are not copied, since they hold pointers
+ *  that are not valid after a restart.  The trailer has the number of
+ *  objects, the length of the records, and their CRC-16.
+ *
+ * @param write - function that appends octets to the snapshot
+ * @param context - context passed to the write function
+ * @return number of objects saved, or -1 on error
+ */
+int Device_Snapshot_Save(device_snapshot_write_function write, void *context)
+{
+    struct object_functions *pObject = NULL;
+    uint8_t record[2 + MAX_APDU] = { 0 };
+    uint8_t header[DEVICE_SNAPSHOT_HEADER_SIZE] = { 0 };
+    uint8_t trailer[DEVICE_SNAPSHOT_TRAILER_SIZE] = { 0 };
+    uint32_t object_count = 0, payload_len = 0;
+    uint32_t object_instance = 0;
+    uint16_t crc = 0xFFFF;
+    unsigned count = 0, index = 0;
+    int len = 0;
+
+    if (!write) {
+        return -1;
+    }
+    len = encode_unsigned32(&header[0], DEVICE_SNAPSHOT_MAGIC);
+    len += encode_unsigned16(&header[len], DEVICE_SNAPSHOT_VERSION);
+    (void)encode_unsigned16(&header[len], BACNET_PROTOCOL_REVISION);
+    if (!write(context, header, DEVICE_SNAPSHOT_HEADER_SIZE)) {
+        return -1;
+    }
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if ((pObject->Object_Type == OBJECT_DEVICE) ||
+            (!pObject->Object_Create) || (!pObject->Object_Count) ||
+            (!pObject->Object_Index_To_Instance)) {
+            /* the object type can not be created from a snapshot */
+            pObject++;
+            continue;
+        }
+        count = pObject->Object_Count();
+        for (index = 0; index < count; index++) {
+            object_instance = pObject->Object_Index_To_Instance(index);
+            len = Device_Object_Create_Encode(
+                pObject->Object_Type, object_instance, &record[2],
+                sizeof(record) - 2);
+            if ((len <= 0) || (len > UINT16_MAX)) {
+                return -1;
+            }
+            (void)encode_unsigned16(&record[0], (uint16_t)len);
+            len += 2;
+            if (!write(context, record, (size_t)len)) {
+                return -1;
+            }
+            crc = CRC_Calc_Data_Block(record, (size_t)len, crc);
+            payload_len += (uint32_t)len;
+            object_count++;
+        }
+        pObject++;
+    }
+    len = encode_unsigned32(&trailer[0], object_count);
+    len += encode_unsigned32(&trailer[len], payload_len);
+    (void)encode_unsigned16(&trailer[len], crc);
+    if (!write(context, trailer, DEVICE_SNAPSHOT_TRAILER_SIZE)) {
+        return -1;
+    }
+
+    return (int)object_count;
+}
+
+/**
+ * @brief Check a snapshot made with Device_Snapshot_Save()
+ * @param snapshot - the snapshot, such as a file mapped into memory
+ * @param snapshot_size - number of octets in the snapshot
+ * @param object_count - number of objects in the snapshot, or NULL
+ * @return true if the snapshot is complete and was made by this version
+ */
+bool Device_Snapshot_Valid(
+    const uint8_t *snapshot, size_t snapshot_size, uint32_t *object_count)
+{
+    const uint8_t *trailer = NULL;
+    uint32_t magic = 0, count = 0, payload_len = 0;
+    uint16_t version = 0, revision = 0, crc = 0;
+
+    if (!snapshot ||
+        (snapshot_size <
+         (DEVICE_SNAPSHOT_HEADER_SIZE + DEVICE_SNAPSHOT_TRAILER_SIZE))) {
+        return false;
+    }
+    (void)decode_unsigned32(&snapshot[0], &magic);
+    (void)decode_unsigned16(&snapshot[4], &version);
+    (void)decode_unsigned16(&snapshot[6], &revision);
+    if ((magic != DEVICE_SNAPSHOT_MAGIC) ||
+        (version != DEVICE_SNAPSHOT_VERSION) ||
+        (revision != BACNET_PROTOCOL_REVISION)) {
+        return false;
+    }
+    trailer = &snapshot[snapshot_size - DEVICE_SNAPSHOT_TRAILER_SIZE];
+    (void)decode_unsigned32(&trailer[0], &count);
+    (void)decode_unsigned32(&trailer[4], &payload_len);
+    (void)decode_unsigned16(&trailer[8], &crc);
+    if (payload_len !=
+        (snapshot_size - DEVICE_SNAPSHOT_HEADER_SIZE -
+         DEVICE_SNAPSHOT_TRAILER_SIZE)) {
+        return false;
+    }
+    if (crc !=
+        CRC_Calc_Data_Block(
+            &snapshot[DEVICE_SNAPSHOT_HEADER_SIZE], payload_len, 0xFFFF)) {
+        return false;
+    }
+    if (object_count) {
+        *object_count = count;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Create the objects of a snapshot made with Device_Snapshot_Save()
+ *  in one pass through the snapshot.  The snapshot is only read, so it
+ *  can be a file that is mapped into memory.  Objects that already exist
+ *  are given the values of the snapshot.
+ * @param snapshot - the snapshot, such as a file mapped into memory
+ * @param snapshot_size - number of octets in the snapshot
+ * @return number of objects created, or -1 if the snapshot is not valid
+ *  and the objects have to be created from the configuration instead
+ */
+int Device_Snapshot_Load(const uint8_t *snapshot, size_t snapshot_size)
+{
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    const uint8_t *record = NULL;
+    size_t offset = 0, end = 0;
+    uint16_t record_len = 0;
+    int decoded_len = 0;
+    int created = 0;
+
+    if (!Device_Snapshot_Valid(snapshot, snapshot_size, NULL)) {
+        return -1;
+    }
+    offset = DEVICE_SNAPSHOT_HEADER_SIZE;
+    end = snapshot_size - DEVICE_SNAPSHOT_TRAILER_SIZE;
+    while ((offset + 2) <= end) {
+        (void)decode_unsigned16(&snapshot[offset], &record_len);
+        offset += 2;
+        if ((offset + record_len) > end) {
+            break;
+        }
+        record = &snapshot[offset];
+        offset += record_len;
+        decoded_len = create_object_decode_service_request(
+            record, record_len, &create_data);
+        if (decoded_len <= 0) {
+            /* skip the object that could not be decoded */
+            continue;
+        }
+        create_data.error_class = ERROR_CLASS_PROPERTY;
+        create_data.error_code = ERROR_CODE_SUCCESS;
+        create_data.continue_on_error = true;
+        if (Device_Create_Object(&create_data)) {
+            created++;
+        }
+    }
+    Device_Object_List_Cache_Invalidate();
+
+    return created;
+}
+
+#if defined(INTRINSIC_REPORTING)
+/* Change driven intrinsic reporting: the object types that report their
+   changes with Device_Intrinsic_Reporting_Changed() are only evaluated
+   when a value or limit changed, or while a transition is pending,
+   instead of evaluating every object on each cycle. */
+static bool Intrinsic_Reporting_Change_Type[MAX_BACNET_OBJECT_TYPE];
+/* objects to evaluate on the next cycle, by object key, and the objects
+   that are evaluated on this cycle, for each device */
+static OS_Keylist Intrinsic_Reporting_Changed_List[MAX_NUM_DEVICES];
+static OS_Keylist Intrinsic_Reporting_Evaluate_List[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Intrinsic_Reporting_Changed \
+    (Intrinsic_Reporting_Changed_List[Routed_Device_Object_Index()])
+#define Intrinsic_Reporting_Evaluate \
+    (Intrinsic_Reporting_Evaluate_List[Routed_Device_Object_Index()])
+#else
+#define Intrinsic_Reporting_Changed (Intrinsic_Reporting_Changed_List[0])
+#define Intrinsic_Reporting_Evaluate (Intrinsic_Reporting_Evaluate_List[0])
+#endif
+
+/**
+ * @brief Set whether the objects of a type report their changes with
+ *  Device_Intrinsic_Reporting_Changed(), so that they are only evaluated
+ *  after a change instead of on every cycle
+ * @param object_type - object type that reports its changes
+ * @param enable - true if the objects of the type report their changes
+ */
+void Device_Intrinsic_Reporting_Change_Driven_Set(
+    BACNET_OBJECT_TYPE object_type, bool enable)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        Intrinsic_Reporting_Change_Type[object_type] = enable;
+    }
+}
+
+/**
+ * @brief Determine if the objects of a type report their changes with
+ *  Device_Intrinsic_Reporting_Changed()
+ * @param object_type - object type
+ * @return true if the objects of the type are only evaluated after a change
+ */
+bool Device_Intrinsic_Reporting_Change_Driven(BACNET_OBJECT_TYPE object_type)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        return Intrinsic_Reporting_Change_Type[object_type];
+    }
+
+    return false;
+}
+
+/**
+ * @brief Report that the event state of an object needs to be evaluated,
+ *  because its value, status, limits or event properties changed, or a
+ *  transition is waiting for its time delay
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ */
+void Device_Intrinsic_Reporting_Changed(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
 {
-#if defined BACNET_BACKUP_RESTORE
-    size_t i = 0;
-    uint32_t object_count = 0;
-    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
-    uint32_t object_instance = 0;
-    const int32_t *writable_properties = NULL;
-    struct special_property_list_t property_list = { 0 };
-    uint8_t object_apdu[MAX_APDU] = { 0 };
-    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
-    bool status = false;
-    int32_t len = 0, offset = 0;
+    KEY key;
 
-    object_count = Device_Object_List_Count();
-    for (i = 0; i < object_count; i++) {
-        /* get the object type and instance from the device object list */
-        status = Device_Object_List_Identifier(
-            (uint32_t)(i + 1), &object_type, &object_instance);
-        if (status) {
-            Device_Objects_Property_List(
-                object_type, object_instance, &property_list);
-            (void)Device_Objects_Writable_Property_List(
-                object_type, object_instance, &writable_properties);
-            create_data.object_type = object_type;
-            create_data.object_instance = object_instance;
-            create_data.application_data_len = 0;
-            len = create_object_writable_properties_encode(
-                object_apdu, sizeof(object_apdu), &create_data,
-                property_list.Required.pList, property_list.Optional.pList,
-                property_list.Proprietary.pList, writable_properties,
-                Device_Read_Property);
-            if (len > 0) {
-                (void)bacfile_write_offset(
-                    Configuration_Files[0], offset, &object_apdu[0],
-                    (uint32_t)len);
-                offset += len;
-            }
-        }
+    if (!Device_Intrinsic_Reporting_Change_Driven(object_type)) {
+        return;
+    }
+    if (!Intrinsic_Reporting_Changed) {
+        Intrinsic_Reporting_Changed = Keylist_Create();
+    }
+    key = KEY_ENCODE(object_type, object_instance);
+    if (Keylist_Index(Intrinsic_Reporting_Changed, key) < 0) {
+        (void)Keylist_Data_Add(Intrinsic_Reporting_Changed, key, NULL);
     }
-    Backup_State = BACKUP_STATE_PERFORMING_A_BACKUP;
-#endif
 }
 
 /**
- * @brief Create files for backup and restore, if supported, and set the state
- * to performing a restore
+ * @brief Get the number of objects that wait to be evaluated
+ * @return number of objects that reported a change
  */
-void Device_Start_Restore(void)
+unsigned Device_Intrinsic_Reporting_Changed_Count(void)
 {
-#if defined BACNET_BACKUP_RESTORE
-    Backup_State = BACKUP_STATE_PERFORMING_A_RESTORE;
-#endif
+    int count;
+
+    count = Keylist_Count(Intrinsic_Reporting_Changed);
+    if (count < 0) {
+        count = 0;
+    }
+
+    return (unsigned)count;
 }
 
 /**
- * @brief Loop through the Device object-list property and export to
- *  a file as BACnet CreateObject services with List of Initial Values
- *  for every writable property
+ * @brief Evaluate the intrinsic reporting of the objects of the current
+ *  device: every object of the polled types, and only the objects that
+ *  reported a change of the change driven types
  */
-void Device_End_Restore(void)
+static void Device_Intrinsic_Reporting_Task(void)
 {
-#if defined BACNET_BACKUP_RESTORE
-    BACNET_DATE_TIME bdateTime = { 0 };
-    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
-    uint8_t apdu[MAX_APDU] = { 0 };
-    int32_t apdu_len = 0, offset = 0, file_size = 0;
-    int decoded_len = 0;
+    struct object_functions *pObject = NULL;
+    OS_Keylist list;
+    uint32_t object_instance = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    KEY key;
+    unsigned count, index;
+    int i;
 
-    datetime_local(&bdateTime.date, &bdateTime.time, NULL, NULL);
-    bacapp_timestamp_datetime_set(&Last_Restore_Time, &bdateTime);
-    /* delete all existing objects before restore */
-    Device_Delete_Objects();
-    /* create objects from the backup file */
-    file_size = bacfile_file_size(Configuration_Files[0]);
-    while (offset < file_size) {
-        apdu_len = bacfile_read_offset(
-            Configuration_Files[0], offset, &apdu[0], sizeof(apdu));
-        if (apdu_len > 0) {
-            decoded_len = create_object_decode_service_request(
-                apdu, apdu_len, &create_data);
-            if (decoded_len > 0) {
-                offset += decoded_len;
-                create_data.error_class = ERROR_CLASS_PROPERTY;
-                create_data.error_code = ERROR_CODE_SUCCESS;
-                create_data.continue_on_error = true;
-                if (Device_Create_Object(&create_data)) {
-                    /* object created and initialized successfully */
-                } else {
-                    /* error creating object - keep going */
-                }
-            } else {
-                Backup_State = BACKUP_STATE_RESTORE_FAILURE;
-                /* error while decoding object  */
-                break;
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if (pObject->Object_Intrinsic_Reporting && pObject->Object_Count &&
+            pObject->Object_Index_To_Instance &&
+            !Device_Intrinsic_Reporting_Change_Driven(pObject->Object_Type)) {
+            count = pObject->Object_Count();
+            for (index = 0; index < count; index++) {
+                object_instance = pObject->Object_Index_To_Instance(index);
+                pObject->Object_Intrinsic_Reporting(object_instance);
             }
-        } else {
-            Backup_State = BACKUP_STATE_RESTORE_FAILURE;
-            /* error while reading file  */
+        }
+        pObject++;
+    }
+    /* the objects that change while they are evaluated, or that wait for
+       a time delay, report again and are evaluated on the next cycle */
+    list = Intrinsic_Reporting_Changed;
+    Intrinsic_Reporting_Changed = Intrinsic_Reporting_Evaluate;
+    Intrinsic_Reporting_Evaluate = list;
+    count = (unsigned)Keylist_Count(list);
+    for (index = 0; index < count; index++) {
+        if (!Keylist_Index_Key(list, (int)index, &key)) {
             break;
         }
+        object_type = (BACNET_OBJECT_TYPE)KEY_DECODE_TYPE(key);
+        object_instance = (uint32_t)KEY_DECODE_ID(key);
+        pObject = Device_Object_Functions_Find(object_type);
+        if (pObject && pObject->Object_Intrinsic_Reporting &&
+            pObject->Object_Valid_Instance &&
+            pObject->Object_Valid_Instance(object_instance)) {
+            pObject->Object_Intrinsic_Reporting(object_instance);
+        }
     }
-    if (Backup_State != BACKUP_STATE_RESTORE_FAILURE) {
-        Backup_State = BACKUP_STATE_IDLE;
+    /* empty the list from the end, which does not move the other keys */
+    for (i = Keylist_Count(list) - 1; i >= 0; i--) {
+        (void)Keylist_Data_Delete_By_Index(list, i);
     }
-#endif
 }
 
-#if defined(INTRINSIC_REPORTING)
 void Device_local_reporting(void)
 {
-    struct object_functions *pObject = NULL;
-    uint32_t objects_count = 0;
-    uint32_t object_instance = 0;
-    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
-    uint32_t idx = 0;
-
-/* loop for all objects */
 #ifdef BAC_ROUTING
     uint16_t dev_id = 0;
     uint16_t current_dev_id = Routed_Device_Object_Index();
+
     for (dev_id = 0; dev_id < Get_Num_Managed_Devices(); dev_id++) {
         Set_Routed_Device_Object_Index(dev_id);
-        objects_count = Device_Object_List_Count();
-        for (idx = 1; idx <= objects_count; idx++) {
-            Device_Object_List_Identifier(idx, &object_type, &object_instance);
-            pObject = Device_Object_Functions_Find(object_type);
-            if (pObject != NULL) {
-                if (pObject->Object_Valid_Instance &&
-                    pObject->Object_Valid_Instance(object_instance)) {
-                    if (pObject->Object_Intrinsic_Reporting) {
-                        pObject->Object_Intrinsic_Reporting(object_instance);
-                    }
-                }
-            }
-        }
+        Device_Intrinsic_Reporting_Task();
     }
     Set_Routed_Device_Object_Index(current_dev_id);
 #else
-    objects_count = Device_Object_List_Count();
-    for (idx = 1; idx <= objects_count; idx++) {
-        Device_Object_List_Identifier(idx, &object_type, &object_instance);
-        pObject = Device_Object_Functions_Find(object_type);
-        if (pObject != NULL) {
-            if (pObject->Object_Valid_Instance &&
-                pObject->Object_Valid_Instance(object_instance)) {
-                if (pObject->Object_Intrinsic_Reporting) {
-                    pObject->Object_Intrinsic_Reporting(object_instance);
-                }
-            }
-        }
-    }
+    Device_Intrinsic_Reporting_Task();
 #endif
 }
 #endif
@@ -4010,6 +5900,54 @@ struct object_functions *Device_Object_Functions(void)
     return Object_Table;
 }
 
+#if (BACNET_PROTOCOL_REVISION >= 14)
+static void Device_Timer_Lighting_Output_Active(uint32_t instance, bool active)
+{
+    Device_Timer_Object_Active_Set(OBJECT_LIGHTING_OUTPUT, instance, active);
+}
+#endif
+
+#if (BACNET_PROTOCOL_REVISION >= 17)
+static void Device_Timer_Timer_Active(uint32_t instance, bool active)
+{
+    Device_Timer_Object_Active_Set(OBJECT_TIMER, instance, active);
+}
+#endif
+
+#if (BACNET_PROTOCOL_REVISION >= 24)
+static void Device_Timer_Color_Active(uint32_t instance, bool active)
+{
+    Device_Timer_Object_Active_Set(OBJECT_COLOR, instance, active);
+}
+
+static void
+Device_Timer_Color_Temperature_Active(uint32_t instance, bool active)
+{
+    Device_Timer_Object_Active_Set(OBJECT_COLOR_TEMPERATURE, instance, active);
+}
+#endif
+
+/**
+ * @brief Bind a Loop variable reference to the REAL Present_Value of an
+ *  object, so that the Loop need not use ReadProperty for it
+ * @param object_type - object type of the reference
+ * @param object_property - property of the reference
+ * @param array_index - array index of the reference
+ * @return the read function, or NULL to use ReadProperty
+ */
+static loop_read_real_function Device_Loop_Read_Real_Bind(
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    if ((object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL)) {
+        return NULL;
+    }
+
+    return Device_Present_Value_Real_Function(object_type);
+}
+
 /** Initialize the Device Object.
  Initialize the group of object helper functions for any supported Object.
  Initialize each of the Device Object child Object instances.
@@ -4028,6 +5966,20 @@ void Device_Init(object_functions_t *object_table)
     } else {
         Object_Table = &My_Object_Table[0];
     }
+    Device_Object_Functions_Index_Rebuild();
+#if (BACNET_PROTOCOL_REVISION >= 14)
+    /* only the Lighting Outputs and Colors with a command in progress,
+       and the running Timers, need Device_Timer() */
+    Lighting_Output_Active_Callback_Set(Device_Timer_Lighting_Output_Active);
+#endif
+#if (BACNET_PROTOCOL_REVISION >= 17)
+    Timer_Active_Callback_Set(Device_Timer_Timer_Active);
+#endif
+#if (BACNET_PROTOCOL_REVISION >= 24)
+    Color_Active_Callback_Set(Device_Timer_Color_Active);
+    Color_Temperature_Active_Callback_Set(
+        Device_Timer_Color_Temperature_Active);
+#endif
     pObject = Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Init) {
@@ -4042,10 +5994,18 @@ void Device_Init(object_functions_t *object_table)
     /* link ReadProperty and WriteProperty to Loop object for references */
     Loop_Read_Property_Internal_Callback_Set(Device_Read_Property);
     Loop_Write_Property_Internal_Callback_Set(Device_Write_Property);
+    Loop_Read_Real_Bind_Callback_Set(Device_Loop_Read_Real_Bind);
 #if (BACNET_PROTOCOL_REVISION >= 17)
     /* link WriteProperty to Timer object for references */
     Timer_Write_Property_Internal_Callback_Set(Device_Write_Property);
 #endif
+    Device_Object_Property_Lists_Rebuild();
+    Device_Each_Routed_Device(Device_Object_Name_Index_Rebuild);
+    Device_Object_List_Cache_Invalidate();
+    if (Object_List_Cache_Enable_Flag) {
+        Device_Each_Routed_Device(Device_Object_List_Cache_Refresh);
+    }
+    Device_Each_Routed_Device(Device_Property_Cache_Clear);
 }
 
 bool DeviceGetRRInfo(
@@ -4078,6 +6038,12 @@ bool DeviceGetRRInfo(
             status = true;
             break;
 
+        case PROP_OBJECT_LIST:
+            pInfo->RequestTypes = RR_BY_POSITION;
+            pInfo->Handler = Device_Object_List_RR_Encode;
+            status = true;
+            break;
+
         case PROP_ACTIVE_COV_SUBSCRIPTIONS:
             pInfo->RequestTypes = RR_BY_POSITION;
             pRequest->error_class = ERROR_CLASS_PROPERTY;
@@ -4100,16 +6066,182 @@ bool DeviceGetRRInfo(
     return status;
 }
 
+/* Objects which told they have timed work to do, such as a fade, ramp
+   or countdown, sorted by object identifier.  Device_Timer() gives the
+   elapsed time only to these, for the object types that tell. */
+static OS_Keylist Timer_Active_Lists[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Timer_Active_List (Timer_Active_Lists[Routed_Device_Object_Index()])
+#else
+#define Timer_Active_List (Timer_Active_Lists[0])
+#endif
+
 /**
- * @brief Updates all the object timers with elapsed milliseconds
+ * @brief Determine if the objects of a type tell when they are active,
+ *  so that Device_Timer() does not need to visit each of them
+ * @param pObject - object functions of the object type
+ * @return true if only the active objects of the type need the timer
+ */
+static bool Device_Timer_Active_Type(const struct object_functions *pObject)
+{
+#if (BACNET_PROTOCOL_REVISION >= 14)
+    if ((pObject->Object_Type == OBJECT_LIGHTING_OUTPUT) &&
+        (pObject->Object_Timer == Lighting_Output_Timer)) {
+        return true;
+    }
+#endif
+#if (BACNET_PROTOCOL_REVISION >= 17)
+    if ((pObject->Object_Type == OBJECT_TIMER) &&
+        (pObject->Object_Timer == Timer_Task)) {
+        return true;
+    }
+#endif
+#if (BACNET_PROTOCOL_REVISION >= 24)
+    if ((pObject->Object_Type == OBJECT_COLOR) &&
+        (pObject->Object_Timer == Color_Timer)) {
+        return true;
+    }
+    if ((pObject->Object_Type == OBJECT_COLOR_TEMPERATURE) &&
+        (pObject->Object_Timer == Color_Temperature_Timer)) {
+        return true;
+    }
+#endif
+    (void)pObject;
+
+    return false;
+}
+
+/**
+ * @brief Tell Device_Timer() whether an object has timed work to do
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param active - true while the object needs the elapsed time
+ */
+void Device_Timer_Object_Active_Set(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool active)
+{
+    KEY key = KEY_ENCODE(object_type, object_instance);
+    int index;
+
+    index = Keylist_Index(Timer_Active_List, key);
+    if (active) {
+        if (index < 0) {
+            if (!Timer_Active_List) {
+                Timer_Active_List = Keylist_Create();
+            }
+            Keylist_Data_Add(Timer_Active_List, key, NULL);
+        }
+    } else if (index >= 0) {
+        Keylist_Data_Delete_By_Index(Timer_Active_List, index);
+    }
+}
+
+/**
+ * @brief Determine if an object told Device_Timer() it is active
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @return true if the object is active
+ */
+bool Device_Timer_Object_Active(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    return Keylist_Index(
+               Timer_Active_List,
+               KEY_ENCODE(object_type, object_instance)) >= 0;
+}
+
+/**
+ * @brief Get the number of objects which told Device_Timer() they
+ *  are active
+ * @return number of active objects
+ */
+unsigned Device_Timer_Object_Active_Count(void)
+{
+    return (unsigned)Keylist_Count(Timer_Active_List);
+}
+
+/**
+ * @brief Find the index of the first active object after a key
+ * @param key - the key of the last active object given the time
+ * @return index into the list of active objects
+ */
+static int Device_Timer_Active_Index_After(KEY key)
+{
+    int low = 0, high, mid;
+    KEY mid_key;
+
+    high = Keylist_Count(Timer_Active_List);
+    while (low < high) {
+        mid = low + ((high - low) / 2);
+        if (Keylist_Index_Key(Timer_Active_List, mid, &mid_key) &&
+            (mid_key <= key)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/**
+ * @brief Updates the object timers of this device with elapsed milliseconds
  * @param milliseconds - number of milliseconds elapsed
  */
-void Device_Timer(uint16_t milliseconds)
+static void Device_Timer_Objects(uint16_t milliseconds)
 {
     struct object_functions *pObject;
     unsigned count = 0;
+    BACNET_OBJECT_TYPE object_type;
     uint32_t instance;
+    int index = 0;
+    KEY key;
+
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        count = 0;
+        if ((pObject->Object_Count) && (!Device_Timer_Active_Type(pObject))) {
+            count = pObject->Object_Count();
+        }
+        while (count) {
+            count--;
+            if ((pObject->Object_Timer) &&
+                (pObject->Object_Index_To_Instance)) {
+                instance = pObject->Object_Index_To_Instance(count);
+                pObject->Object_Timer(instance, milliseconds);
+            }
+        }
+        pObject++;
+    }
+    /* only the active objects of the types that tell */
+    pObject = NULL;
+    while (Keylist_Index_Key(Timer_Active_List, index, &key)) {
+        object_type = (BACNET_OBJECT_TYPE)KEY_DECODE_TYPE(key);
+        if (!pObject || (pObject->Object_Type != object_type)) {
+            pObject = Device_Object_Functions_Find(object_type);
+        }
+        instance = KEY_DECODE_ID(key);
+        if (pObject && pObject->Object_Timer &&
+            (!pObject->Object_Valid_Instance ||
+             pObject->Object_Valid_Instance(instance))) {
+            pObject->Object_Timer(instance, milliseconds);
+        } else {
+            /* the object is gone */
+            Keylist_Data_Delete(Timer_Active_List, key);
+        }
+        /* objects may join or leave the list during their timer */
+        index = Device_Timer_Active_Index_After(key);
+    }
+}
 
+/**
+ * @brief Updates all the object timers with elapsed milliseconds
+ * @note Object types which tell when their objects are active, such as
+ *  Lighting Output, Timer and Color, only get the time for those objects.
+ * @param milliseconds - number of milliseconds elapsed
+ */
+void Device_Timer(uint16_t milliseconds)
+{
 #ifdef BAC_ROUTING
     uint16_t dev_id = 0;
     uint16_t current_dev_id = Routed_Device_Object_Index();
@@ -4128,44 +6260,22 @@ void Device_Timer(uint16_t milliseconds)
      *    for each device
      */
     Device_Backup_Failure_Timeout_Countdown(milliseconds);
+    Device_Local_Time_Timer(milliseconds);
     for (dev_id = 0; dev_id < Get_Num_Managed_Devices(); dev_id++) {
         Set_Routed_Device_Object_Index(dev_id);
-        pObject = Object_Table;
-        while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
-            count = 0;
-            if (pObject->Object_Count) {
-                count = pObject->Object_Count();
-            }
-            while (count) {
-                count--;
-                if ((pObject->Object_Timer) &&
-                    (pObject->Object_Index_To_Instance)) {
-                    instance = pObject->Object_Index_To_Instance(count);
-                    pObject->Object_Timer(instance, milliseconds);
-                }
-            }
-            pObject++;
+        if (Object_List_Cache_Enable_Flag) {
+            Device_Object_List_Cache_Refresh();
         }
+        Device_Timer_Objects(milliseconds);
     }
     Set_Routed_Device_Object_Index(current_dev_id);
 #else
-    Device_Backup_Failure_Timeout_Countdown(milliseconds);
-    pObject = Object_Table;
-    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
-        count = 0;
-        if (pObject->Object_Count) {
-            count = pObject->Object_Count();
-        }
-        while (count) {
-            count--;
-            if ((pObject->Object_Timer) &&
-                (pObject->Object_Index_To_Instance)) {
-                instance = pObject->Object_Index_To_Instance(count);
-                pObject->Object_Timer(instance, milliseconds);
-            }
-        }
-        pObject++;
+    if (Object_List_Cache_Enable_Flag) {
+        Device_Object_List_Cache_Refresh();
     }
+    Device_Backup_Failure_Timeout_Countdown(milliseconds);
+    Device_Local_Time_Timer(milliseconds);
+    Device_Timer_Objects(milliseconds);
 #endif
 }
 
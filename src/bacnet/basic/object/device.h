@@ -111,6 +111,31 @@ typedef void (*object_intrinsic_reporting_function)(uint32_t object_instance);
 typedef void (*object_timer_function)(
     uint32_t object_instance, uint16_t milliseconds);
 
+/** Reads the Present_Value of this object type without encoding it,
+ *  for the local reads of other objects, such as Trend Log and Loop.
+ * @ingroup ObjHelpers
+ * @param [in] The object instance number to be looked up.
+ * @param [out] The Present_Value
+ * @return True if the object instance is valid.
+ */
+typedef bool (*object_present_value_real_function)(
+    uint32_t object_instance, float *value);
+typedef bool (*object_present_value_enumerated_function)(
+    uint32_t object_instance, uint32_t *value);
+typedef bool (*object_present_value_unsigned_function)(
+    uint32_t object_instance, BACNET_UNSIGNED_INTEGER *value);
+typedef bool (*object_present_value_boolean_function)(
+    uint32_t object_instance, bool *value);
+
+/** Reads the Status_Flags of this object type without encoding them.
+ * @ingroup ObjHelpers
+ * @param [in] The object instance number to be looked up.
+ * @param [out] The Status_Flags
+ * @return True if the object instance is valid.
+ */
+typedef bool (*object_status_flags_function)(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
+
 /** Defines the group of object helper functions for any supported Object.
  * @ingroup ObjHelpers
  * Each Object must provide some implementation of each of these helpers
@@ -142,8 +167,30 @@ typedef struct object_functions {
     delete_object_function Object_Delete;
     object_timer_function Object_Timer;
     writable_property_list_function Object_Writable_Property_List;
+    object_present_value_real_function Object_Present_Value_Real;
+    object_present_value_enumerated_function Object_Present_Value_Enumerated;
+    object_present_value_unsigned_function Object_Present_Value_Unsigned;
+    object_present_value_boolean_function Object_Present_Value_Boolean;
+    object_status_flags_function Object_Status_Flags;
 } object_functions_t;
 
+/**
+ * @brief Append octets to a snapshot of the object database
+ * @param context - context given to Device_Snapshot_Save()
+ * @param data - octets to append
+ * @param length - number of octets to append
+ * @return true if the octets were appended
+ */
+typedef bool (*device_snapshot_write_function)(
+    void *context, const uint8_t *data, size_t length);
+
+/* snapshot of the object database: "BSNP", version, protocol revision */
+#define DEVICE_SNAPSHOT_MAGIC 0x42534E50UL
+#define DEVICE_SNAPSHOT_VERSION 1
+#define DEVICE_SNAPSHOT_HEADER_SIZE 8
+/* object count, length of the records, and CRC-16 of the records */
+#define DEVICE_SNAPSHOT_TRAILER_SIZE 10
+
 /* String Lengths - excluding any nul terminator */
 #define MAX_DEV_NAME_LEN 32
 #define MAX_DEV_LOC_LEN 64
@@ -207,6 +254,14 @@ Device_Object_Functions_Find(BACNET_OBJECT_TYPE Object_Type);
 
 BACNET_STACK_EXPORT
 void Device_Timer(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void Device_Timer_Object_Active_Set(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool active);
+BACNET_STACK_EXPORT
+bool Device_Timer_Object_Active(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+unsigned Device_Timer_Object_Active_Count(void);
 
 BACNET_STACK_EXPORT
 bool Device_Reinitialize(BACNET_REINITIALIZE_DEVICE_DATA *rd_data);
@@ -222,6 +277,8 @@ rr_info_function Device_Objects_RR_Info(BACNET_OBJECT_TYPE object_type);
 
 BACNET_STACK_EXPORT
 void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime);
+BACNET_STACK_EXPORT
+void Device_Local_Time_Refresh(void);
 
 BACNET_STACK_EXPORT
 int32_t Device_UTC_Offset(void);
@@ -314,6 +371,30 @@ bool Device_COV(BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Device_COV_Clear(BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
 
+/* functions to read local values without ReadProperty */
+BACNET_STACK_EXPORT
+bool Device_Present_Value_Real(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, float *value);
+BACNET_STACK_EXPORT
+object_present_value_real_function
+Device_Present_Value_Real_Function(BACNET_OBJECT_TYPE object_type);
+BACNET_STACK_EXPORT
+bool Device_Present_Value_Enumerated(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, uint32_t *value);
+BACNET_STACK_EXPORT
+bool Device_Present_Value_Unsigned(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_UNSIGNED_INTEGER *value);
+BACNET_STACK_EXPORT
+bool Device_Present_Value_Boolean(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool *value);
+BACNET_STACK_EXPORT
+bool Device_Status_Flags(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_BIT_STRING *status_flags);
+
 BACNET_STACK_EXPORT
 uint32_t Device_Object_Instance_Number(void);
 BACNET_STACK_EXPORT
@@ -336,6 +417,32 @@ bool Device_Object_List_Identifier(
 BACNET_STACK_EXPORT
 int Device_Object_List_Element_Encode(
     uint32_t object_instance, BACNET_ARRAY_INDEX array_index, uint8_t *apdu);
+BACNET_STACK_EXPORT
+int Device_Object_List_Range_Encode(
+    uint32_t array_index,
+    uint32_t count,
+    uint8_t *apdu,
+    size_t apdu_size,
+    uint32_t *item_count);
+BACNET_STACK_EXPORT
+bool Device_Object_List_Cache_Enable(bool enable);
+BACNET_STACK_EXPORT
+bool Device_Object_List_Cache_Enabled(void);
+BACNET_STACK_EXPORT
+bool Device_Object_List_Cache_Rebuild(void);
+BACNET_STACK_EXPORT
+void Device_Object_List_Cache_Invalidate(void);
+BACNET_STACK_EXPORT
+bool Device_Property_Cache_Enable(bool enable);
+BACNET_STACK_EXPORT
+bool Device_Property_Cache_Enabled(void);
+BACNET_STACK_EXPORT
+void Device_Property_Cache_Store_Enable(bool enable);
+BACNET_STACK_EXPORT
+void Device_Property_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Device_Property_Cache_Changes(void);
 
 BACNET_STACK_EXPORT
 bool Device_Create_Object(BACNET_CREATE_OBJECT_DATA *data);
@@ -351,6 +458,14 @@ void Device_Start_Restore(void);
 BACNET_STACK_EXPORT
 void Device_End_Restore(void);
 
+BACNET_STACK_EXPORT
+int Device_Snapshot_Save(device_snapshot_write_function write, void *context);
+BACNET_STACK_EXPORT
+bool Device_Snapshot_Valid(
+    const uint8_t *snapshot, size_t snapshot_size, uint32_t *object_count);
+BACNET_STACK_EXPORT
+int Device_Snapshot_Load(const uint8_t *snapshot, size_t snapshot_size);
+
 BACNET_STACK_EXPORT
 unsigned Device_Count(void);
 BACNET_STACK_EXPORT
@@ -446,6 +561,19 @@ BACNET_STACK_EXPORT
 bool Device_Valid_Object_Id(
     BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
 
+BACNET_STACK_EXPORT
+bool Device_Object_Name_Index_Enable(bool enable);
+BACNET_STACK_EXPORT
+bool Device_Object_Name_Index_Enabled(void);
+BACNET_STACK_EXPORT
+void Device_Object_Name_Index_Rebuild(void);
+BACNET_STACK_EXPORT
+void Device_Object_Name_Index_Update(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Device_Object_Name_Index_Remove(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+
 BACNET_STACK_EXPORT
 int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
 BACNET_STACK_EXPORT
@@ -482,6 +610,16 @@ void Device_Write_Property_Proprietary_Callback_Set(write_property_function cb);
 #if defined(INTRINSIC_REPORTING)
 BACNET_STACK_EXPORT
 void Device_local_reporting(void);
+BACNET_STACK_EXPORT
+void Device_Intrinsic_Reporting_Change_Driven_Set(
+    BACNET_OBJECT_TYPE object_type, bool enable);
+BACNET_STACK_EXPORT
+bool Device_Intrinsic_Reporting_Change_Driven(BACNET_OBJECT_TYPE object_type);
+BACNET_STACK_EXPORT
+void Device_Intrinsic_Reporting_Changed(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+unsigned Device_Intrinsic_Reporting_Changed_Count(void);
 #endif
 
 /* Prototypes for Routing functionality in the Device Object.
@@ -516,6 +654,11 @@ uint32_t Routed_Device_Index_To_Instance(unsigned index);
 BACNET_STACK_EXPORT
 bool Routed_Device_Valid_Object_Instance_Number(uint32_t object_id);
 BACNET_STACK_EXPORT
+bool Routed_Device_Instance_Find(uint32_t object_instance, uint16_t *idx);
+BACNET_STACK_EXPORT
+bool Routed_Device_Name_Find(
+    const BACNET_CHARACTER_STRING *object_name, uint16_t *idx);
+BACNET_STACK_EXPORT
 bool Routed_Device_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name);
 BACNET_STACK_EXPORT
@@ -536,6 +679,10 @@ int Routed_Device_Service_Approval(
     uint8_t *apdu_buff,
     uint8_t invoke_id);
 
+/* The routed device is selected per thread, but the Devices[] table, the
+   object lists of each routed device, the TSM and the transmit buffer
+   have no lock: serve each routed device from one thread, and do not run
+   anything else of the stack in another thread at the same time. */
 BACNET_STACK_EXPORT
 uint16_t Routed_Device_Object_Index(void);
 BACNET_STACK_EXPORT
@@ -0,0 +1,1916 @@
+/**
+ * @file
+ * @brief Event Log object, customize for your use
+ * @details An Event Log object records event notifications with timestamps
+ *  and other pertinent data in an internal buffer for subsequent retrieval.
+ *  Each timestamped buffer entry is called an event log "record."
+ *
+ *  The records are kept encoded as BACnetEventLogRecord values in a
+ *  circular buffer of fixed size slots in a storage block, which is
+ *  allocated once when the object is created, so adding a record never
+ *  allocates memory. Each slot also keeps the time of its record in
+ *  seconds, so the ReadRange service finds the records of a time range
+ *  with a binary search of the slots, and copies the encoded records
+ *  without decoding them. The storage block is from the heap by default,
+ *  and may be kept elsewhere by storage callbacks, such as in a file so
+ *  that the records are resumed after a restart of the device.
+ *
+ *  The log buffer is a fixed-size circular buffer. When it is full, the
+ *  oldest records are overwritten when new records are added, unless
+ *  Stop_When_Full is TRUE. Each record has an implied sequence number that
+ *  is equal to the value of the Total_Record_Count property immediately
+ *  after the record is added.
+ *
+ *  The event notifications that are reported by the Notification Class
+ *  objects of this device are logged by every enabled Event Log when
+ *  INTRINSIC_REPORTING is defined. Other notifications may be logged
+ *  with Event_Log_Record_Notification_Insert().
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/datetime.h"
+#include "bacnet/event.h"
+#include "bacnet/proplist.h"
+#include "bacnet/rp.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/sys/keylist.h"
+/* BACnet Stack Objects */
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/nc.h"
+/* me! */
+#include "bacnet/basic/object/eventlog.h"
+
+/* identifies a storage block header written by this module */
+#define EVENT_LOG_STORAGE_MAGIC 0x42454C31UL
+/* offsets of the data in the storage block header */
+#define EVENT_LOG_HEADER_MAGIC 0
+#define EVENT_LOG_HEADER_RECORD_SIZE 4
+#define EVENT_LOG_HEADER_BUFFER_SIZE 8
+#define EVENT_LOG_HEADER_INDEX 12
+#define EVENT_LOG_HEADER_RECORD_COUNT 16
+#define EVENT_LOG_HEADER_TOTAL_RECORD_COUNT 20
+/* a record slot is the time of the record in seconds, the length of
+   the encoded record, then the record */
+#define EVENT_LOG_SLOT_TIME 0
+#define EVENT_LOG_SLOT_LENGTH 4
+#define EVENT_LOG_SLOT_RECORD 6
+#define EVENT_LOG_SLOT_RECORD_MAX \
+    (BACNET_EVENT_LOG_RECORD_SIZE - EVENT_LOG_SLOT_RECORD)
+/* the choices of the logDatum of a BACnetEventLogRecord */
+#define EVENT_LOG_DATUM_LOG_STATUS 0
+#define EVENT_LOG_DATUM_NOTIFICATION 1
+
+struct object_data {
+    bool Enable;
+    bool Stop_When_Full;
+    /* the records are kept encoded in a circular buffer of fixed size
+       slots in the storage block */
+    uint8_t *Storage;
+    size_t Storage_Size;
+    uint32_t Buffer_Size;
+    /* slot of the next record */
+    uint32_t Index;
+    uint32_t Record_Count;
+    uint32_t Record_Count_Total;
+    /* number of records that are older than the record before them,
+       such as after the clock was set back. The records are searched
+       by time with a binary search only when there are none. */
+    uint32_t Descents;
+    const char *Object_Name;
+    const char *Description;
+    void *Context;
+};
+/* Key List for storing the object data sorted by instance number  */
+static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Object_List (Object_Lists[Routed_Device_Object_Index()])
+#define Log_Device_Index() (Routed_Device_Object_Index())
+#else
+#define Object_List (Object_Lists[0])
+#define Log_Device_Index() (0)
+#endif
+/* the copy of a notification that is logged, which leaves out
+   what does not fit in a record slot */
+static BACNET_EVENT_NOTIFICATION_DATA Notification_Entry;
+#if defined(INTRINSIC_REPORTING)
+/* logs the notifications reported by the Notification Class objects */
+static NC_EVENT_LISTENER Event_Listener = { NULL,
+                                            Event_Log_Event_Notification };
+#endif
+
+static uint8_t *Event_Log_Storage_Heap_Open(
+    unsigned device_index, uint32_t object_instance, size_t *size);
+static void Event_Log_Storage_Heap_Close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge);
+static event_log_storage_open_callback Storage_Open_Callback =
+    Event_Log_Storage_Heap_Open;
+static event_log_storage_close_callback Storage_Close_Callback =
+    Event_Log_Storage_Heap_Close;
+
+static const int32_t Properties_Required[] = {
+    /* required properties that are supported for this object */
+    PROP_OBJECT_IDENTIFIER,
+    PROP_OBJECT_NAME,
+    PROP_OBJECT_TYPE,
+    PROP_STATUS_FLAGS,
+    PROP_EVENT_STATE,
+    PROP_ENABLE,
+    PROP_STOP_WHEN_FULL,
+    PROP_BUFFER_SIZE,
+    PROP_LOG_BUFFER,
+    PROP_RECORD_COUNT,
+    PROP_TOTAL_RECORD_COUNT,
+    -1
+};
+
+static const int32_t Properties_Optional[] = { PROP_DESCRIPTION, -1 };
+
+static const int32_t Properties_Proprietary[] = { -1 };
+
+static const int32_t Writable_Properties[] = {
+    /* Every object shall have a Writable Property_List property
+    which is a BACnetARRAY of property identifiers,
+    one property identifier for each property within this object
+    that is always writable.  */
+    PROP_ENABLE, PROP_STOP_WHEN_FULL, PROP_BUFFER_SIZE, PROP_RECORD_COUNT, -1
+};
+
+/**
+ * Returns the list of required, optional, and proprietary properties.
+ * Used by ReadPropertyMultiple service.
+ *
+ * @param pRequired - pointer to list of int terminated by -1, of
+ * BACnet required properties for this object.
+ * @param pOptional - pointer to list of int terminated by -1, of
+ * BACnet optkional properties for this object.
+ * @param pProprietary - pointer to list of int terminated by -1, of
+ * BACnet proprietary properties for this object.
+ */
+void Event_Log_Property_Lists(
+    const int32_t **pRequired,
+    const int32_t **pOptional,
+    const int32_t **pProprietary)
+{
+    if (pRequired) {
+        *pRequired = Properties_Required;
+    }
+    if (pOptional) {
+        *pOptional = Properties_Optional;
+    }
+    if (pProprietary) {
+        *pProprietary = Properties_Proprietary;
+    }
+
+    return;
+}
+
+/**
+ * @brief Get the list of writable properties for an Event Log object
+ * @param  object_instance - object-instance number of the object
+ * @param  properties - Pointer to the pointer of writable properties.
+ */
+void Event_Log_Writable_Property_List(
+    uint32_t object_instance, const int32_t **properties)
+{
+    (void)object_instance;
+    if (properties) {
+        *properties = Writable_Properties;
+    }
+}
+
+/**
+ * @brief Gets an object from the list using an instance number as the key
+ * @param  object_instance - object-instance number of the object
+ * @return object found in the list, or NULL if not found
+ */
+static struct object_data *Object_Data(uint32_t object_instance)
+{
+    return Keylist_Data(Object_List, object_instance);
+}
+
+/**
+ * @brief Determines if a given object instance is valid
+ * @param  object_instance - object-instance number of the object
+ * @return  true if the instance is valid, and false if not
+ */
+bool Event_Log_Valid_Instance(uint32_t object_instance)
+{
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determines the number of objects
+ * @return  Number of objects
+ */
+unsigned Event_Log_Count(void)
+{
+    return Keylist_Count(Object_List);
+}
+
+/**
+ * @brief Determines the object instance-number for a given 0..N index
+ * of objects where N is the count.
+ * @param  index - 0..N value
+ * @return  object instance-number for a valid given index, or UINT32_MAX
+ */
+uint32_t Event_Log_Index_To_Instance(unsigned index)
+{
+    uint32_t instance = UINT32_MAX;
+
+    (void)Keylist_Index_Key(Object_List, index, &instance);
+
+    return instance;
+}
+
+/**
+ * @brief For a given object instance-number, determines a 0..N index
+ * of objects where N is the count.
+ * @param  object_instance - object-instance number of the object
+ * @return  index for the given instance-number, or count if not valid.
+ */
+unsigned Event_Log_Instance_To_Index(uint32_t object_instance)
+{
+    return Keylist_Index(Object_List, object_instance);
+}
+
+/**
+ * @brief Get a storage block for the records of a log from the heap
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param size - [in,out] the size of the storage block
+ * @return the storage block, or NULL if there is not enough memory
+ */
+static uint8_t *Event_Log_Storage_Heap_Open(
+    unsigned device_index, uint32_t object_instance, size_t *size)
+{
+    (void)device_index;
+    (void)object_instance;
+
+    return calloc(1, *size);
+}
+
+/**
+ * @brief Free a storage block from the heap
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param storage - the storage block
+ * @param size - the size of the storage block
+ * @param purge - true if the records are no longer wanted
+ */
+static void Event_Log_Storage_Heap_Close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge)
+{
+    (void)device_index;
+    (void)object_instance;
+    (void)size;
+    (void)purge;
+    free(storage);
+}
+
+/**
+ * @brief Set the callbacks that keep the storage blocks of the logs,
+ *  for example in files that survive a restart of the device.
+ * @note Set them before the Event Log objects are created, or call
+ *  Event_Log_Cleanup() before changing them. NULL callbacks restore
+ *  the default storage from the heap.
+ * @param open_callback - callback to get the storage block of a log
+ * @param close_callback - callback to let go of a storage block
+ */
+void Event_Log_Storage_Callback_Set(
+    event_log_storage_open_callback open_callback,
+    event_log_storage_close_callback close_callback)
+{
+    if (open_callback && close_callback) {
+        Storage_Open_Callback = open_callback;
+        Storage_Close_Callback = close_callback;
+    } else {
+        Storage_Open_Callback = Event_Log_Storage_Heap_Open;
+        Storage_Close_Callback = Event_Log_Storage_Heap_Close;
+    }
+}
+
+/**
+ * @brief Get a record slot in the storage block of a log
+ * @param pObject - object data
+ * @param slot - 0 based slot number, less than the buffer size
+ * @return the record slot
+ */
+static uint8_t *
+Event_Log_Storage_Slot(const struct object_data *pObject, uint32_t slot)
+{
+    return &pObject->Storage
+                [BACNET_EVENT_LOG_STORAGE_HEADER_SIZE +
+                 ((size_t)slot * BACNET_EVENT_LOG_RECORD_SIZE)];
+}
+
+/**
+ * @brief Get the slot of a record of a log
+ * @param pObject - object data
+ * @param index - 0 based index of the record, oldest first,
+ *  less than the record count
+ * @return the record slot
+ */
+static uint8_t *
+Event_Log_Record_Slot(const struct object_data *pObject, uint32_t index)
+{
+    uint32_t slot;
+
+    slot = pObject->Index + pObject->Buffer_Size - pObject->Record_Count;
+    slot = (slot + index) % pObject->Buffer_Size;
+
+    return Event_Log_Storage_Slot(pObject, slot);
+}
+
+/**
+ * @brief Get the length of the encoded record in a slot
+ * @param slot - the record slot
+ * @return number of octets of the encoded record
+ */
+static uint16_t Event_Log_Slot_Length(const uint8_t *slot)
+{
+    uint16_t len = 0;
+
+    decode_unsigned16(&slot[EVENT_LOG_SLOT_LENGTH], &len);
+    if (len > EVENT_LOG_SLOT_RECORD_MAX) {
+        len = 0;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Get the time of a record of a log
+ * @param pObject - object data
+ * @param index - 0 based index of the record, oldest first,
+ *  less than the record count
+ * @return the time of the record, in seconds since the epoch
+ */
+static uint32_t
+Event_Log_Record_Seconds(const struct object_data *pObject, uint32_t index)
+{
+    uint32_t seconds = 0;
+
+    decode_unsigned32(
+        &Event_Log_Record_Slot(pObject, index)[EVENT_LOG_SLOT_TIME], &seconds);
+
+    return seconds;
+}
+
+/**
+ * @brief Count the records of a log that are older than the record
+ *  before them
+ * @param pObject - object data
+ */
+static void Event_Log_Descents_Count(struct object_data *pObject)
+{
+    uint32_t prior, seconds, i;
+
+    pObject->Descents = 0;
+    if (pObject->Record_Count == 0) {
+        return;
+    }
+    prior = Event_Log_Record_Seconds(pObject, 0);
+    for (i = 1; i < pObject->Record_Count; i++) {
+        seconds = Event_Log_Record_Seconds(pObject, i);
+        if (seconds < prior) {
+            pObject->Descents++;
+        }
+        prior = seconds;
+    }
+}
+
+/**
+ * @brief Store the state of the circular buffer of a log in the header
+ *  of its storage block
+ * @param pObject - object data
+ */
+static void Event_Log_Storage_Header_Update(const struct object_data *pObject)
+{
+    uint8_t *header = pObject->Storage;
+
+    if (header) {
+        encode_unsigned32(&header[EVENT_LOG_HEADER_INDEX], pObject->Index);
+        encode_unsigned32(
+            &header[EVENT_LOG_HEADER_RECORD_COUNT], pObject->Record_Count);
+        encode_unsigned32(
+            &header[EVENT_LOG_HEADER_TOTAL_RECORD_COUNT],
+            pObject->Record_Count_Total);
+    }
+}
+
+/**
+ * @brief Get the storage block of a log, and resume the records that
+ *  are already in the block. An empty or foreign block is formatted.
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @param buffer_size - number of records for a new block
+ * @return true if the records of the block were resumed
+ */
+static bool Event_Log_Storage_Open(
+    uint32_t object_instance, struct object_data *pObject, uint32_t buffer_size)
+{
+    size_t size = BACNET_EVENT_LOG_STORAGE_SIZE(buffer_size);
+    uint8_t *header = NULL;
+    uint32_t magic = 0;
+    uint32_t record_size = 0;
+    uint32_t stored_size = 0;
+    uint32_t index = 0;
+    uint32_t count = 0;
+    bool status = false;
+
+    pObject->Buffer_Size = 0;
+    pObject->Index = 0;
+    pObject->Record_Count = 0;
+    pObject->Descents = 0;
+    header = Storage_Open_Callback(Log_Device_Index(), object_instance, &size);
+    if (header && (size < BACNET_EVENT_LOG_STORAGE_SIZE(1))) {
+        /* too small to be a log: purge it, and ask for a new block */
+        Storage_Close_Callback(
+            Log_Device_Index(), object_instance, header, size, true);
+        size = BACNET_EVENT_LOG_STORAGE_SIZE(buffer_size);
+        header =
+            Storage_Open_Callback(Log_Device_Index(), object_instance, &size);
+        if (header && (size < BACNET_EVENT_LOG_STORAGE_SIZE(1))) {
+            Storage_Close_Callback(
+                Log_Device_Index(), object_instance, header, size, true);
+            header = NULL;
+        }
+    }
+    pObject->Storage = header;
+    pObject->Storage_Size = size;
+    if (!header) {
+        pObject->Storage_Size = 0;
+        return false;
+    }
+    decode_unsigned32(&header[EVENT_LOG_HEADER_MAGIC], &magic);
+    decode_unsigned32(&header[EVENT_LOG_HEADER_RECORD_SIZE], &record_size);
+    decode_unsigned32(&header[EVENT_LOG_HEADER_BUFFER_SIZE], &stored_size);
+    decode_unsigned32(&header[EVENT_LOG_HEADER_INDEX], &index);
+    decode_unsigned32(&header[EVENT_LOG_HEADER_RECORD_COUNT], &count);
+    if ((magic == EVENT_LOG_STORAGE_MAGIC) &&
+        (record_size == BACNET_EVENT_LOG_RECORD_SIZE) && (stored_size > 0) &&
+        (stored_size <= BACNET_EVENT_LOG_BUFFER_SIZE_MAX) &&
+        (BACNET_EVENT_LOG_STORAGE_SIZE(stored_size) <= size) &&
+        (index < stored_size) && (count <= stored_size)) {
+        pObject->Buffer_Size = stored_size;
+        pObject->Index = index;
+        pObject->Record_Count = count;
+        decode_unsigned32(
+            &header[EVENT_LOG_HEADER_TOTAL_RECORD_COUNT],
+            &pObject->Record_Count_Total);
+        Event_Log_Descents_Count(pObject);
+        status = true;
+    } else {
+        stored_size = (uint32_t)((size - BACNET_EVENT_LOG_STORAGE_HEADER_SIZE) /
+                                 BACNET_EVENT_LOG_RECORD_SIZE);
+        if (stored_size > buffer_size) {
+            stored_size = buffer_size;
+        }
+        pObject->Buffer_Size = stored_size;
+        pObject->Record_Count_Total = 0;
+        memset(header, 0, BACNET_EVENT_LOG_STORAGE_HEADER_SIZE);
+        encode_unsigned32(
+            &header[EVENT_LOG_HEADER_MAGIC], EVENT_LOG_STORAGE_MAGIC);
+        encode_unsigned32(
+            &header[EVENT_LOG_HEADER_RECORD_SIZE],
+            BACNET_EVENT_LOG_RECORD_SIZE);
+        encode_unsigned32(&header[EVENT_LOG_HEADER_BUFFER_SIZE], stored_size);
+        Event_Log_Storage_Header_Update(pObject);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Let go of the storage block of a log
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @param purge - true if the records are no longer wanted
+ */
+static void Event_Log_Storage_Close(
+    uint32_t object_instance, struct object_data *pObject, bool purge)
+{
+    if (pObject->Storage) {
+        Storage_Close_Callback(
+            Log_Device_Index(), object_instance, pObject->Storage,
+            pObject->Storage_Size, purge);
+    }
+    pObject->Storage = NULL;
+    pObject->Storage_Size = 0;
+    pObject->Buffer_Size = 0;
+    pObject->Index = 0;
+    pObject->Record_Count = 0;
+    pObject->Descents = 0;
+}
+
+/**
+ * @brief Encode a BACnetEventLogRecord
+ * @param apdu - buffer for the record, or NULL for the length
+ * @param timestamp - the timestamp of the record
+ * @param data - the notification of the record, or NULL for
+ *  a log-status record
+ * @param log_status - the BACnetLogStatus bits of a log-status record
+ * @return number of octets encoded, or 0 if unable to encode
+ */
+static int Event_Log_Record_Encode(
+    uint8_t *apdu,
+    const BACNET_DATE_TIME *timestamp,
+    const BACNET_EVENT_NOTIFICATION_DATA *data,
+    uint8_t log_status)
+{
+    BACNET_BIT_STRING bit_string;
+    int apdu_len = 0;
+    int len;
+
+    len = bacapp_encode_context_datetime(apdu, 0, timestamp);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_opening_tag(apdu, 1);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    if (data) {
+        len = encode_opening_tag(apdu, EVENT_LOG_DATUM_NOTIFICATION);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        len = event_notify_encode_service_request(apdu, data);
+        if (len <= 0) {
+            return 0;
+        }
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        len = encode_closing_tag(apdu, EVENT_LOG_DATUM_NOTIFICATION);
+    } else {
+        bitstring_init(&bit_string);
+        bitstring_set_bits_used(&bit_string, 1, 8 - LOG_STATUS_MAX);
+        bitstring_set_octet(&bit_string, 0, log_status);
+        len = encode_context_bitstring(
+            apdu, EVENT_LOG_DATUM_LOG_STATUS, &bit_string);
+    }
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_closing_tag(apdu, 1);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode a notification record for a record slot. The message
+ *  text of a notification is left out of a record that would not fit.
+ * @param apdu - buffer of EVENT_LOG_SLOT_RECORD_MAX octets
+ * @param timestamp - the timestamp of the record
+ * @param data - the notification
+ * @return number of octets encoded, or 0 if the record does not fit
+ */
+static int Event_Log_Notification_Pack(
+    uint8_t *apdu,
+    const BACNET_DATE_TIME *timestamp,
+    const BACNET_EVENT_NOTIFICATION_DATA *data)
+{
+    int len;
+
+    if (data != &Notification_Entry) {
+        memcpy(&Notification_Entry, data, sizeof(Notification_Entry));
+    }
+    /* the log is not one of the recipients of the notification */
+    Notification_Entry.processIdentifier = 0;
+    len = Event_Log_Record_Encode(NULL, timestamp, &Notification_Entry, 0);
+    if ((len > EVENT_LOG_SLOT_RECORD_MAX) && Notification_Entry.messageText) {
+        Notification_Entry.messageText = NULL;
+        len = Event_Log_Record_Encode(NULL, timestamp, &Notification_Entry, 0);
+    }
+    if ((len <= 0) || (len > EVENT_LOG_SLOT_RECORD_MAX)) {
+        return 0;
+    }
+
+    return Event_Log_Record_Encode(apdu, timestamp, &Notification_Entry, 0);
+}
+
+/**
+ * @brief Add an encoded record at the insertion point of a log,
+ *  overwriting the oldest record of a full log
+ * @param pObject - object data
+ * @param seconds - the time of the record, in seconds since the epoch
+ * @param apdu - the encoded record
+ * @param apdu_len - number of octets of the record
+ * @return true if the record was added
+ */
+static bool Event_Log_Record_Append(
+    struct object_data *pObject,
+    uint32_t seconds,
+    const uint8_t *apdu,
+    int apdu_len)
+{
+    uint8_t *slot;
+    uint32_t prior = 0;
+    bool has_prior = false;
+
+    if ((pObject->Buffer_Size == 0) || (apdu_len <= 0) ||
+        (apdu_len > EVENT_LOG_SLOT_RECORD_MAX)) {
+        return false;
+    }
+    if (pObject->Record_Count == pObject->Buffer_Size) {
+        /* the oldest record is overwritten */
+        if ((pObject->Record_Count > 1) && (pObject->Descents > 0) &&
+            (Event_Log_Record_Seconds(pObject, 0) >
+             Event_Log_Record_Seconds(pObject, 1))) {
+            pObject->Descents--;
+        }
+        has_prior = pObject->Record_Count > 1;
+    } else {
+        has_prior = pObject->Record_Count > 0;
+    }
+    if (has_prior) {
+        prior = Event_Log_Record_Seconds(pObject, pObject->Record_Count - 1);
+    }
+    slot = Event_Log_Storage_Slot(pObject, pObject->Index);
+    encode_unsigned32(&slot[EVENT_LOG_SLOT_TIME], seconds);
+    encode_unsigned16(&slot[EVENT_LOG_SLOT_LENGTH], (uint16_t)apdu_len);
+    memcpy(&slot[EVENT_LOG_SLOT_RECORD], apdu, apdu_len);
+    pObject->Index++;
+    if (pObject->Index >= pObject->Buffer_Size) {
+        pObject->Index = 0;
+    }
+    if (pObject->Record_Count < pObject->Buffer_Size) {
+        pObject->Record_Count++;
+    }
+    pObject->Record_Count_Total++;
+    if (has_prior && (seconds < prior)) {
+        pObject->Descents++;
+    }
+    Event_Log_Storage_Header_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Copy the encoded record of a log from its slot
+ * @param pObject - object data
+ * @param index - 0 based index of the record, oldest first
+ * @param apdu - buffer for the record, or NULL for the length
+ * @return number of octets of the record, or 0 if there is no record
+ */
+static int Event_Log_Record_Copy(
+    const struct object_data *pObject, uint32_t index, uint8_t *apdu)
+{
+    const uint8_t *slot;
+    uint16_t len;
+
+    if (index >= pObject->Record_Count) {
+        return 0;
+    }
+    slot = Event_Log_Record_Slot(pObject, index);
+    len = Event_Log_Slot_Length(slot);
+    if (apdu) {
+        memcpy(apdu, &slot[EVENT_LOG_SLOT_RECORD], len);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Get the time of a new record from the clock of the device.
+ *  The timestamp is kept to the second, which is the resolution of
+ *  the time of the record slots.
+ * @param timestamp - [out] the timestamp of the record
+ * @return the time of the record, in seconds since the epoch
+ */
+static uint32_t Event_Log_Timestamp_Now(BACNET_DATE_TIME *timestamp)
+{
+    Device_getCurrentDateTime(timestamp);
+    timestamp->time.hundredths = 0;
+
+    return (uint32_t)datetime_seconds_since_epoch(timestamp);
+}
+
+/**
+ * @brief Inserts a status record into an event log, without regard to
+ *  the value of the Enable property
+ * @param  object_instance - object-instance number of the object
+ * @param  log_status - the log status
+ * @param  state - the state of the log status
+ */
+void Event_Log_Record_Status_Insert(
+    uint32_t object_instance, BACNET_LOG_STATUS log_status, bool state)
+{
+    uint8_t apdu[EVENT_LOG_SLOT_RECORD_MAX];
+    BACNET_DATE_TIME timestamp;
+    struct object_data *pObject;
+    uint8_t value = 0;
+    uint32_t seconds;
+    int len;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject) {
+        return;
+    }
+    /* the bits are set in the order that they are encoded */
+    if (state && (log_status < LOG_STATUS_MAX)) {
+        value = 1 << log_status;
+    }
+    seconds = Event_Log_Timestamp_Now(&timestamp);
+    len = Event_Log_Record_Encode(apdu, &timestamp, NULL, value);
+    Event_Log_Record_Append(pObject, seconds, apdu, len);
+}
+
+/**
+ * @brief Insert a notification record into an event log. The process
+ *  identifier of the recipients is not part of the record.
+ * @param  object_instance - object-instance number of the object
+ * @param  data - the event notification
+ * @return true if the record was added
+ */
+bool Event_Log_Record_Notification_Insert(
+    uint32_t object_instance, const BACNET_EVENT_NOTIFICATION_DATA *data)
+{
+    uint8_t apdu[EVENT_LOG_SLOT_RECORD_MAX];
+    BACNET_DATE_TIME timestamp;
+    struct object_data *pObject;
+    uint32_t seconds;
+    bool status;
+    int len;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject || !data || !pObject->Enable) {
+        return false;
+    }
+    seconds = Event_Log_Timestamp_Now(&timestamp);
+    len = Event_Log_Notification_Pack(apdu, &timestamp, data);
+    status = Event_Log_Record_Append(pObject, seconds, apdu, len);
+    if (status && pObject->Stop_When_Full &&
+        ((pObject->Record_Count + 1) >= pObject->Buffer_Size)) {
+        /* the last record of a full log is the log-status of disabling */
+        pObject->Enable = false;
+        Event_Log_Record_Status_Insert(
+            object_instance, LOG_STATUS_LOG_DISABLED, true);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Log an event notification in every enabled Event Log of this
+ *  device. It is called with each event notification that is reported
+ *  by the Notification Class objects.
+ * @param  data - the event notification
+ */
+void Event_Log_Event_Notification(const BACNET_EVENT_NOTIFICATION_DATA *data)
+{
+    unsigned index, count;
+
+    count = Keylist_Count(Object_List);
+    for (index = 0; index < count; index++) {
+        Event_Log_Record_Notification_Insert(
+            Event_Log_Index_To_Instance(index), data);
+    }
+}
+
+/**
+ * @brief Clear the records of a log, and add a log-status record
+ *  that the log buffer was purged
+ * @param pObject - object data
+ * @param object_instance - object-instance number of the object
+ */
+static void
+Event_Log_Records_Purge(struct object_data *pObject, uint32_t object_instance)
+{
+    pObject->Index = 0;
+    pObject->Record_Count = 0;
+    pObject->Descents = 0;
+    Event_Log_Storage_Header_Update(pObject);
+    Event_Log_Record_Status_Insert(
+        object_instance, LOG_STATUS_BUFFER_PURGED, true);
+}
+
+/**
+ * @brief Get the log record maximum length for this object instance
+ * @param  object_instance - object-instance number of the object
+ * @return  maximum number of log records
+ */
+uint32_t Event_Log_Buffer_Size(uint32_t object_instance)
+{
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject) {
+        return 0;
+    }
+
+    return pObject->Buffer_Size;
+}
+
+/**
+ * @brief Set the log record maximum length for this object instance.
+ *  The newest records that fit are kept, and the log keeps its buffer
+ *  size if the new storage can not be had.
+ * @param  object_instance - object-instance number of the object
+ * @param  buffer_size - maximum number of log records, from 1 to
+ *  BACNET_EVENT_LOG_BUFFER_SIZE_MAX
+ * @return true if the maximum number of log records is set
+ */
+bool Event_Log_Buffer_Size_Set(uint32_t object_instance, uint32_t buffer_size)
+{
+    struct object_data *pObject;
+    uint8_t *records = NULL;
+    uint32_t old_size, total_records, count, i;
+    bool status = false;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject) {
+        return false;
+    }
+    if ((buffer_size == 0) ||
+        (buffer_size > BACNET_EVENT_LOG_BUFFER_SIZE_MAX)) {
+        return false;
+    }
+    if (buffer_size == pObject->Buffer_Size) {
+        return true;
+    }
+    /* The disposition of existing log records when Buffer_Size is written
+        is a local matter. We keep the newest records that fit. */
+    count = pObject->Record_Count;
+    if (count > buffer_size) {
+        count = buffer_size;
+    }
+    if (count > 0) {
+        records = malloc((size_t)count * BACNET_EVENT_LOG_RECORD_SIZE);
+        if (!records) {
+            return false;
+        }
+        for (i = 0; i < count; i++) {
+            memcpy(
+                &records[(size_t)i * BACNET_EVENT_LOG_RECORD_SIZE],
+                Event_Log_Record_Slot(
+                    pObject, pObject->Record_Count - count + i),
+                BACNET_EVENT_LOG_RECORD_SIZE);
+        }
+    }
+    old_size = pObject->Buffer_Size;
+    total_records = pObject->Record_Count_Total;
+    Event_Log_Storage_Close(object_instance, pObject, true);
+    Event_Log_Storage_Open(object_instance, pObject, buffer_size);
+    if (pObject->Buffer_Size == buffer_size) {
+        status = true;
+    } else if (old_size > 0) {
+        Event_Log_Storage_Close(object_instance, pObject, true);
+        Event_Log_Storage_Open(object_instance, pObject, old_size);
+    }
+    if (count > pObject->Buffer_Size) {
+        count = pObject->Buffer_Size;
+    }
+    for (i = 0; i < count; i++) {
+        memcpy(
+            Event_Log_Storage_Slot(pObject, i),
+            &records[(size_t)i * BACNET_EVENT_LOG_RECORD_SIZE],
+            BACNET_EVENT_LOG_RECORD_SIZE);
+    }
+    free(records);
+    if (pObject->Buffer_Size > 0) {
+        pObject->Index = count % pObject->Buffer_Size;
+        pObject->Record_Count = count;
+    }
+    /* the total record count carries on */
+    pObject->Record_Count_Total = total_records;
+    Event_Log_Descents_Count(pObject);
+    Event_Log_Storage_Header_Update(pObject);
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines the property value
+ * @param  object_instance - object-instance number of the object
+ * @return the property value
+ */
+uint32_t Event_Log_Record_Count(uint32_t object_instance)
+{
+    uint32_t record_count = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        record_count = pObject->Record_Count;
+    }
+
+    return record_count;
+}
+
+/**
+ * @brief For a given object instance-number, determines the property value
+ * @param  object_instance - object-instance number of the object
+ * @return the property value
+ */
+uint32_t Event_Log_Total_Record_Count(uint32_t object_instance)
+{
+    uint32_t total_count = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        total_count = pObject->Record_Count_Total;
+    }
+
+    return total_count;
+}
+
+/**
+ * For a given object instance-number, loads the object-name into
+ * a characterstring. Note that the object name must be unique
+ * within this device.
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  object_name - holds the object-name retrieved
+ *
+ * @return  true if object-name was retrieved
+ */
+bool Event_Log_Object_Name(
+    uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
+{
+    bool status = false;
+    struct object_data *pObject;
+    char name_text[32] = "EVENT-LOG-4194303";
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        if (pObject->Object_Name) {
+            status =
+                characterstring_init_ansi(object_name, pObject->Object_Name);
+        } else {
+            snprintf(
+                name_text, sizeof(name_text), "EVENT-LOG-%lu",
+                (unsigned long)object_instance);
+            status = characterstring_init_ansi(object_name, name_text);
+        }
+    }
+
+    return status;
+}
+
+/**
+ * For a given object instance-number, sets the object-name
+ * Note that the object name must be unique within this device.
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  new_name - holds the object-name to be set
+ *
+ * @return  true if object-name was set
+ */
+bool Event_Log_Name_Set(uint32_t object_instance, const char *new_name)
+{
+    bool status = false; /* return value */
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        status = true;
+        pObject->Object_Name = new_name;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Return the object name C string
+ * @param object_instance [in] BACnet object instance number
+ * @return object name or NULL if not found
+ */
+const char *Event_Log_Name_ASCII(uint32_t object_instance)
+{
+    const char *name = NULL;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        name = pObject->Object_Name;
+    }
+
+    return name;
+}
+
+/**
+ * For a given object instance-number, returns the description
+ *
+ * @param  object_instance - object-instance number of the object
+ *
+ * @return description text or NULL if not found
+ */
+const char *Event_Log_Description(uint32_t object_instance)
+{
+    const char *name = NULL;
+    const struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        name = pObject->Description;
+    }
+
+    return name;
+}
+
+/**
+ * For a given object instance-number, sets the description
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  new_name - holds the description to be set
+ *
+ * @return  true if object-name was set
+ */
+bool Event_Log_Description_Set(uint32_t object_instance, const char *new_name)
+{
+    bool status = false; /* return value */
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        status = true;
+        pObject->Description = new_name;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Determines a object enabled flag state
+ *
+ * @note Logging occurs if and only if Enable is TRUE.
+ * Log_Buffer records of type log-status are recorded
+ * without regard to the value of the Enable property.
+ *
+ * @param object_instance - object-instance number of the object
+ * @return  enabled status flag
+ */
+bool Event_Log_Enable(uint32_t object_instance)
+{
+    bool value = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Enable;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the object enabled flag.
+ *  A change of the flag is recorded in the log buffer.
+ * @param  object_instance - object-instance number of the object
+ * @param  enable - holds the value to be set
+ * @return true if set
+ */
+bool Event_Log_Enable_Set(uint32_t object_instance, bool enable)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        if (pObject->Enable != enable) {
+            /* Only trigger this validation on a potential change of state */
+            pObject->Enable = enable;
+            Event_Log_Record_Status_Insert(
+                object_instance, LOG_STATUS_LOG_DISABLED, !enable);
+        }
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines Stop_When_Full
+ * @param  object_instance - object-instance number of the object
+ * @return true if the log is disabled when the log buffer is full
+ */
+bool Event_Log_Stop_When_Full(uint32_t object_instance)
+{
+    bool value = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Stop_When_Full;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets Stop_When_Full.
+ *  An enabled log that is already full is disabled.
+ * @param  object_instance - object-instance number of the object
+ * @param  stop_when_full - true to disable the log when it is full
+ * @return true if set
+ */
+bool Event_Log_Stop_When_Full_Set(uint32_t object_instance, bool stop_when_full)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        if (pObject->Stop_When_Full != stop_when_full) {
+            pObject->Stop_When_Full = stop_when_full;
+            if (stop_when_full && pObject->Enable &&
+                (pObject->Record_Count == pObject->Buffer_Size)) {
+                pObject->Enable = false;
+                Event_Log_Record_Status_Insert(
+                    object_instance, LOG_STATUS_LOG_DISABLED, true);
+            }
+        }
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * ReadProperty handler for this object.  For the given ReadProperty
+ * data, the application_data is loaded or the error flags are set.
+ *
+ * @param  rpdata - BACNET_READ_PROPERTY_DATA data, including
+ * requested data and space for the reply, or error response.
+ *
+ * @return number of APDU bytes in the response, or
+ * BACNET_STATUS_ERROR on error.
+ */
+int Event_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    int apdu_len = 0; /* return value */
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    BACNET_BIT_STRING bit_string = { 0 };
+    uint8_t *apdu = NULL;
+    struct object_data *pObject;
+
+    if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
+        (rpdata->application_data_len == 0)) {
+        return 0;
+    }
+    pObject = Object_Data(rpdata->object_instance);
+    if (!pObject) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return BACNET_STATUS_ERROR;
+    }
+    apdu = rpdata->application_data;
+    switch (rpdata->object_property) {
+        case PROP_OBJECT_IDENTIFIER:
+            apdu_len = encode_application_object_id(
+                &apdu[0], rpdata->object_type, rpdata->object_instance);
+            break;
+        case PROP_OBJECT_NAME:
+            Event_Log_Object_Name(rpdata->object_instance, &char_string);
+            apdu_len =
+                encode_application_character_string(&apdu[0], &char_string);
+            break;
+        case PROP_OBJECT_TYPE:
+            apdu_len =
+                encode_application_enumerated(&apdu[0], rpdata->object_type);
+            break;
+        case PROP_DESCRIPTION:
+            characterstring_init_ansi(&char_string, pObject->Description);
+            apdu_len =
+                encode_application_character_string(&apdu[0], &char_string);
+            break;
+        case PROP_ENABLE:
+            apdu_len = encode_application_boolean(&apdu[0], pObject->Enable);
+            break;
+        case PROP_STOP_WHEN_FULL:
+            apdu_len =
+                encode_application_boolean(&apdu[0], pObject->Stop_When_Full);
+            break;
+        case PROP_BUFFER_SIZE:
+            apdu_len =
+                encode_application_unsigned(&apdu[0], pObject->Buffer_Size);
+            break;
+        case PROP_LOG_BUFFER:
+            /* You can only read the buffer via the ReadRange service */
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_READ_ACCESS_DENIED;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+        case PROP_RECORD_COUNT:
+            apdu_len =
+                encode_application_unsigned(&apdu[0], pObject->Record_Count);
+            break;
+        case PROP_TOTAL_RECORD_COUNT:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], pObject->Record_Count_Total);
+            break;
+        case PROP_EVENT_STATE:
+            /* note: see the details in the standard on how to use this */
+            apdu_len =
+                encode_application_enumerated(&apdu[0], EVENT_STATE_NORMAL);
+            break;
+        case PROP_STATUS_FLAGS:
+            /* note: see the details in the standard on how to use these */
+            bitstring_init(&bit_string);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, false);
+            apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
+            break;
+        default:
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+    }
+    /*  only array properties can have array options */
+    if ((apdu_len >= 0) && (rpdata->object_property != PROP_LOG_BUFFER) &&
+        (rpdata->array_index != BACNET_ARRAY_ALL)) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        apdu_len = BACNET_STATUS_ERROR;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * WriteProperty handler for this object.  For the given WriteProperty
+ * data, the application_data is loaded or the error flags are set.
+ *
+ * @param  wp_data - BACNET_WRITE_PROPERTY_DATA data, including
+ * requested data and space for the reply, or error response.
+ *
+ * @return false if an error is loaded, true if no errors
+ */
+bool Event_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    bool status = false; /* return value */
+    int len = 0;
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    struct object_data *pObject;
+
+    pObject = Object_Data(wp_data->object_instance);
+    if (!pObject) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    /* decode the some of the request */
+    len = bacapp_decode_application_data(
+        wp_data->application_data, wp_data->application_data_len, &value);
+    if (len < 0) {
+        /* error while decoding - a value larger than we can handle */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return false;
+    }
+    if ((wp_data->object_property != PROP_LOG_BUFFER) &&
+        (wp_data->array_index != BACNET_ARRAY_ALL)) {
+        /*  only array properties can have array options */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return false;
+    }
+    switch (wp_data->object_property) {
+        case PROP_ENABLE:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (!status) {
+                break;
+            }
+            if (!pObject->Enable && value.type.Boolean &&
+                pObject->Stop_When_Full &&
+                ((pObject->Record_Count + 1) >= pObject->Buffer_Size)) {
+                /* can't enable a full log with stop when full set */
+                wp_data->error_class = ERROR_CLASS_OBJECT;
+                wp_data->error_code = ERROR_CODE_LOG_BUFFER_FULL;
+                status = false;
+            } else {
+                Event_Log_Enable_Set(
+                    wp_data->object_instance, value.type.Boolean);
+            }
+            break;
+        case PROP_STOP_WHEN_FULL:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status) {
+                Event_Log_Stop_When_Full_Set(
+                    wp_data->object_instance, value.type.Boolean);
+            }
+            break;
+        case PROP_BUFFER_SIZE:
+            /* the write is not allowed if enable is true */
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (!status) {
+                break;
+            }
+            if (pObject->Enable) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+                status = false;
+            } else if (
+                (value.type.Unsigned_Int == 0) ||
+                (value.type.Unsigned_Int > BACNET_EVENT_LOG_BUFFER_SIZE_MAX)) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                status = false;
+            } else {
+                status = Event_Log_Buffer_Size_Set(
+                    wp_data->object_instance,
+                    (uint32_t)value.type.Unsigned_Int);
+                if (!status) {
+                    wp_data->error_class = ERROR_CLASS_RESOURCES;
+                    wp_data->error_code =
+                        ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+                }
+            }
+            break;
+        case PROP_RECORD_COUNT:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (!status) {
+                break;
+            }
+            if (value.type.Unsigned_Int == 0) {
+                /* Time to clear down the log */
+                Event_Log_Records_Purge(pObject, wp_data->object_instance);
+            } else {
+                /* only a value of zero is accepted */
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                status = false;
+            }
+            break;
+        default:
+            if (property_lists_member(
+                    Properties_Required, Properties_Optional,
+                    Properties_Proprietary, wp_data->object_property)) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+            } else {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            }
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Get the space in a read range request for the records
+ * @param pRequest - the read range request
+ * @return number of octets for the records
+ */
+static size_t Event_Log_Read_Range_Size(const BACNET_READ_RANGE_DATA *pRequest)
+{
+    if (pRequest->application_data_len <= pRequest->Overhead) {
+        return 0;
+    }
+
+    return pRequest->application_data_len - pRequest->Overhead;
+}
+
+/**
+ * @brief Copy the records of a log from a given record, until the
+ *  count or the log or the space runs out, and set the result flags
+ * @param pObject - object data
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @param first - 0 based index of the first record to copy
+ * @param count - number of records to copy
+ * @return number of bytes copied
+ */
+static int Event_Log_Records_Copy(
+    const struct object_data *pObject,
+    uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    uint32_t first,
+    uint32_t count)
+{
+    size_t apdu_size;
+    int apdu_len = 0;
+    int len;
+    uint32_t index;
+
+    apdu_size = Event_Log_Read_Range_Size(pRequest);
+    if (count > (pObject->Record_Count - first)) {
+        count = pObject->Record_Count - first;
+    }
+    for (index = first; index < (first + count); index++) {
+        len = Event_Log_Record_Copy(pObject, index, NULL);
+        if ((size_t)len > (apdu_size - apdu_len)) {
+            /*
+             * Can't fit any more in! We just set the result flag to say there
+             * was more and drop out of the loop early
+             */
+            bitstring_set_bit(
+                &pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, true);
+            break;
+        }
+        len = Event_Log_Record_Copy(pObject, index, apdu);
+        apdu += len;
+        apdu_len += len;
+        /* Chalk up another one for the response count */
+        pRequest->ItemCount++;
+    }
+    /* Set remaining result flags if necessary */
+    if ((pRequest->ItemCount > 0) && (first == 0)) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
+    }
+    if ((pRequest->ItemCount > 0) && (index == pObject->Record_Count)) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
+    }
+    /* the sequence number of the first record copied */
+    pRequest->FirstSequence =
+        pObject->Record_Count_Total - pObject->Record_Count + first + 1;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Handle encoding for the By Position and All options.
+ *  Does All option by converting to a By Position request starting at index
+ *  1 and of maximum log size length.
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @return  number of bytes encoded, or 0 if unable to encode.
+ */
+int Event_Log_Read_Range_By_Position(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    struct object_data *pObject;
+    uint32_t record_count;
+    int32_t iTemp = 0;
+    uint32_t uiTarget = 0; /* Last entry we are required to encode */
+
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject || (pObject->Record_Count == 0)) {
+        return 0;
+    }
+    record_count = pObject->Record_Count;
+    if (pRequest->RequestType == RR_READ_ALL) {
+        /*
+         * Read all the list or as much as will fit in the buffer by selecting
+         * a range that covers the whole list and falling through to the next
+         * section of code
+         */
+        pRequest->Count = record_count;
+        /* Starting at the beginning */
+        pRequest->Range.RefIndex = 1;
+    }
+    if (pRequest->Count < 0) {
+        /*
+         * negative count means work from index backwards
+         *
+         * Convert from end index/negative count to
+         * start index/positive count and then process as
+         * normal. This assumes that the order to return items
+         * is always first to last, if this is not true we will
+         * have to handle this differently.
+         */
+        /* pull out and convert to signed */
+        iTemp = pRequest->Range.RefIndex;
+        /* Adjust backwards, remember count is -ve */
+        iTemp += pRequest->Count + 1;
+        if (iTemp < 1) {
+            /* if count is too much, return from 1 to start index */
+            pRequest->Count = pRequest->Range.RefIndex;
+            pRequest->Range.RefIndex = 1;
+        } else {
+            /* Otherwise adjust the start index and make count +ve */
+            pRequest->Range.RefIndex = iTemp;
+            pRequest->Count = -pRequest->Count;
+        }
+    }
+    /* From here on in we only have a starting point and a positive count */
+    if ((pRequest->Range.RefIndex == 0) ||
+        (pRequest->Range.RefIndex > record_count)) {
+        /* Nothing to return as we are past the end of the list */
+        return 0;
+    }
+    /* Index of last required entry */
+    uiTarget = pRequest->Range.RefIndex + pRequest->Count - 1;
+    if (uiTarget > record_count) {
+        /* Capped at end of list if necessary */
+        uiTarget = record_count;
+    }
+
+    return Event_Log_Records_Copy(
+        pObject, apdu, pRequest, pRequest->Range.RefIndex - 1,
+        uiTarget - pRequest->Range.RefIndex + 1);
+}
+
+/**
+ * @brief Handle encoding for the By Sequence option.
+ *  Each record has the sequence number of the Total_Record_Count when
+ *  it was added, so a sequence number is found in the log by its distance
+ *  from the oldest record, without a search. The distances also cover
+ *  a sequence number range that wraps around the maximum for uint32_t.
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @return  number of bytes encoded, or 0 if unable to encode.
+ */
+int Event_Log_Read_Range_By_Sequence(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    struct object_data *pObject;
+    uint32_t record_count;
+    uint32_t uiFirstSeq = 0; /* Sequence number for 1st record in log */
+    uint32_t uiBegin = 0; /* Starting Sequence number for request */
+    int64_t iFirst = 0; /* first record index of the request */
+    int64_t iLast = 0; /* last record index of the request */
+
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject || (pObject->Record_Count == 0) || (pRequest->Count == 0)) {
+        return 0;
+    }
+    record_count = pObject->Record_Count;
+    uiFirstSeq = pObject->Record_Count_Total - (record_count - 1);
+    /* Calculate the start sequence number from request */
+    if (pRequest->Count < 0) {
+        uiBegin = pRequest->Range.RefSeqNum + pRequest->Count + 1;
+    } else {
+        uiBegin = pRequest->Range.RefSeqNum;
+    }
+    /* the records of the request, as their distance from the oldest */
+    iFirst = (int32_t)(uiBegin - uiFirstSeq);
+    if (pRequest->Count < 0) {
+        iLast = iFirst - (int64_t)pRequest->Count - 1;
+    } else {
+        iLast = iFirst + (int64_t)pRequest->Count - 1;
+    }
+    /* If no overlap between request range and buffer contents bail out */
+    if ((iLast < 0) || (iFirst >= (int64_t)record_count)) {
+        return 0;
+    }
+    /* Truncate range if necessary so it lies within the log buffer */
+    if (iFirst < 0) {
+        iFirst = 0;
+    }
+    if (iLast >= (int64_t)record_count) {
+        iLast = record_count - 1;
+    }
+
+    return Event_Log_Records_Copy(
+        pObject, apdu, pRequest, (uint32_t)iFirst,
+        (uint32_t)(iLast - iFirst + 1));
+}
+
+/**
+ * @brief Find the first record of a log with a time after a reference
+ *  time, or with a time at or after it. The records are in time order
+ *  unless the clock was set back, so a binary search is used when they
+ *  are, and otherwise the records are scanned from the oldest or the
+ *  newest, the same as was asked.
+ * @param pObject - object data
+ * @param seconds - the reference time, in seconds since the epoch
+ * @param after - true for the first record with a later time, which is
+ *  scanned for from the oldest record; false for the first record that
+ *  follows the last record with an earlier time, which is scanned for
+ *  from the newest record
+ * @return 0 based index of the record, or the record count if none
+ */
+static uint32_t Event_Log_Time_Search(
+    const struct object_data *pObject, uint32_t seconds, bool after)
+{
+    uint32_t low = 0, high, middle, record_seconds;
+
+    high = pObject->Record_Count;
+    if (pObject->Descents == 0) {
+        while (low < high) {
+            middle = low + ((high - low) / 2);
+            record_seconds = Event_Log_Record_Seconds(pObject, middle);
+            if (after ? (record_seconds <= seconds)
+                      : (record_seconds < seconds)) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+    if (after) {
+        for (low = 0; low < pObject->Record_Count; low++) {
+            if (Event_Log_Record_Seconds(pObject, low) > seconds) {
+                break;
+            }
+        }
+        return low;
+    }
+    for (high = pObject->Record_Count; high > 0; high--) {
+        if (Event_Log_Record_Seconds(pObject, high - 1) < seconds) {
+            break;
+        }
+    }
+
+    return high;
+}
+
+/**
+ * @brief Handle encoding for the By Time option. The time of the records
+ *  is kept in their slots, so the start of the request is found without
+ *  decoding a record.
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @return  number of bytes encoded, or 0 if unable to encode.
+ */
+int Event_Log_Read_Range_By_Time(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    struct object_data *pObject;
+    uint32_t seconds;
+    uint32_t index;
+    uint32_t count;
+
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject || (pObject->Record_Count == 0) || (pRequest->Count == 0)) {
+        return 0;
+    }
+    seconds = (uint32_t)datetime_seconds_since_epoch(&pRequest->Range.RefTime);
+    if (pRequest->Count < 0) {
+        /* the records before the last record which has a timestamp
+           less than the reference time */
+        index = Event_Log_Time_Search(pObject, seconds, false);
+        if (index == 0) {
+            /* end of records, not found */
+            return 0;
+        }
+        /* work backwards to find where we should start from */
+        count = (uint32_t)(-pRequest->Count);
+        if (count > index) {
+            count = index;
+        }
+        index -= count;
+    } else {
+        /* the records from the 1st record which has a timestamp
+           greater than the reference time */
+        index = Event_Log_Time_Search(pObject, seconds, true);
+        if (index == pObject->Record_Count) {
+            return 0;
+        }
+        count = (uint32_t)pRequest->Count;
+    }
+
+    return Event_Log_Records_Copy(pObject, apdu, pRequest, index, count);
+}
+
+/**
+ * @brief For a given read range request, encodes log records
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @return  number of bytes encoded, or 0 if unable to encode.
+ */
+int Event_Log_Read_Range(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    int apdu_len = 0;
+
+    if (!pRequest) {
+        return 0;
+    }
+    /* Initialise result flags to all false */
+    bitstring_init(&pRequest->ResultFlags);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, false);
+    pRequest->ItemCount = 0; /* Start out with nothing */
+    if ((pRequest->RequestType == RR_BY_POSITION) ||
+        (pRequest->RequestType == RR_READ_ALL)) {
+        apdu_len = Event_Log_Read_Range_By_Position(apdu, pRequest);
+    } else if (pRequest->RequestType == RR_BY_SEQUENCE) {
+        apdu_len = Event_Log_Read_Range_By_Sequence(apdu, pRequest);
+    } else {
+        apdu_len = Event_Log_Read_Range_By_Time(apdu, pRequest);
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Get the ReadRange handler for a property of this object
+ * @param pRequest - the read range request
+ * @param pInfo - [out] the request types and handler for the property
+ * @return true if the property can be read with ReadRange
+ */
+bool Event_Log_Read_Range_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo)
+{
+    if (!Event_Log_Valid_Instance(pRequest->object_instance)) {
+        pRequest->error_class = ERROR_CLASS_OBJECT;
+        pRequest->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+    } else if (pRequest->object_property == PROP_LOG_BUFFER) {
+        pInfo->RequestTypes = RR_BY_POSITION | RR_BY_TIME | RR_BY_SEQUENCE;
+        pInfo->Handler = Event_Log_Read_Range;
+        return true;
+    } else {
+        pRequest->error_class = ERROR_CLASS_SERVICES;
+        pRequest->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get the context used with a specific object instance
+ * @param object_instance [in] BACnet object instance number
+ * @return pointer to the context, or NULL if not found
+ */
+void *Event_Log_Context_Get(uint32_t object_instance)
+{
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        return pObject->Context;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set the context used with a specific object instance
+ * @param object_instance [in] BACnet object instance number
+ * @param context [in] pointer to the context
+ */
+void Event_Log_Context_Set(uint32_t object_instance, void *context)
+{
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        pObject->Context = context;
+    }
+}
+
+/**
+ * @brief Creates an Event Log object
+ * @param object_instance - object-instance number of the object
+ * @return object_instance if the object is created, else BACNET_MAX_INSTANCE
+ */
+uint32_t Event_Log_Create(uint32_t object_instance)
+{
+    struct object_data *pObject = NULL;
+    int index = 0;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+    }
+    if (object_instance > BACNET_MAX_INSTANCE) {
+        return BACNET_MAX_INSTANCE;
+    } else if (object_instance == BACNET_MAX_INSTANCE) {
+        /* wildcard instance */
+        /* the Object_Identifier property of the newly created object
+            shall be initialized to a value that is unique within the
+            responding BACnet-user device. The method used to generate
+            the object identifier is a local matter.*/
+        object_instance = Keylist_Next_Empty_Key(Object_List, 1);
+    }
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        pObject = calloc(1, sizeof(struct object_data));
+        if (!pObject) {
+            return BACNET_MAX_INSTANCE;
+        }
+        pObject->Object_Name = NULL;
+        pObject->Description = NULL;
+        pObject->Enable = false;
+        pObject->Stop_When_Full = false;
+        /* the records of a log that was kept are resumed */
+        Event_Log_Storage_Open(
+            object_instance, pObject, BACNET_EVENT_LOG_RECORDS_MAX);
+        if (!pObject->Storage) {
+            free(pObject);
+            return BACNET_MAX_INSTANCE;
+        }
+        /* add to list */
+        index = Keylist_Data_Add(Object_List, object_instance, pObject);
+        if (index < 0) {
+            Event_Log_Storage_Close(object_instance, pObject, true);
+            free(pObject);
+            return BACNET_MAX_INSTANCE;
+        }
+    }
+
+    return object_instance;
+}
+
+/**
+ * @brief Deletes an Event Log object
+ * @param object_instance - object-instance number of the object
+ * @return true if the object is deleted
+ */
+bool Event_Log_Delete(uint32_t object_instance)
+{
+    bool status = false;
+    struct object_data *pObject = NULL;
+
+    pObject = Keylist_Data_Delete(Object_List, object_instance);
+    if (pObject) {
+        Event_Log_Storage_Close(object_instance, pObject, true);
+        free(pObject);
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes all the Event Logs and their data. The storage blocks
+ *  are let go of without a purge, so that kept records are resumed
+ *  when the Event Logs are created again.
+ */
+void Event_Log_Cleanup(void)
+{
+    struct object_data *pObject;
+    uint32_t object_instance;
+    uint16_t dev_id;
+#ifdef BAC_ROUTING
+    uint16_t current_dev_id = Routed_Device_Object_Index();
+#endif
+
+#if defined(INTRINSIC_REPORTING)
+    Notification_Class_Event_Listener_Remove(&Event_Listener);
+#endif
+    for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
+#ifdef BAC_ROUTING
+        Set_Routed_Device_Object_Index(dev_id);
+#endif
+        if (Object_List) {
+            while (Keylist_Count(Object_List) > 0) {
+                object_instance = Event_Log_Index_To_Instance(0);
+                pObject = Keylist_Data_Delete_By_Index(Object_List, 0);
+                if (pObject) {
+                    Event_Log_Storage_Close(object_instance, pObject, false);
+                    free(pObject);
+                }
+            }
+            Keylist_Delete(Object_List);
+            Object_List = NULL;
+        }
+    }
+
+#ifdef BAC_ROUTING
+    Set_Routed_Device_Object_Index(current_dev_id);
+#endif
+}
+
+/**
+ * @brief Initializes the Event Log object data, and logs the event
+ *  notifications that are reported by the Notification Class objects
+ */
+void Event_Log_Init(void)
+{
+    uint16_t dev_id;
+#ifdef BAC_ROUTING
+    uint16_t current_dev_id = Routed_Device_Object_Index();
+#endif
+
+    for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
+#ifdef BAC_ROUTING
+        Set_Routed_Device_Object_Index(dev_id);
+#endif
+        if (!Object_List) {
+            Object_List = Keylist_Create();
+        }
+    }
+
+#ifdef BAC_ROUTING
+    Set_Routed_Device_Object_Index(current_dev_id);
+#endif
+#if defined(INTRINSIC_REPORTING)
+    Notification_Class_Event_Listener_Add(&Event_Listener);
+#endif
+}
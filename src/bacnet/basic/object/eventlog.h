@@ -0,0 +1,173 @@
+/**
+ * @file
+ * @brief API for a basic Event Log object implementation.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_EVENT_LOG_H
+#define BACNET_BASIC_OBJECT_EVENT_LOG_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datetime.h"
+#include "bacnet/event.h"
+#include "bacnet/readrange.h"
+#include "bacnet/rp.h"
+#include "bacnet/wp.h"
+
+/* Buffer_Size of a new Event Log, in records */
+#ifndef BACNET_EVENT_LOG_RECORDS_MAX
+#define BACNET_EVENT_LOG_RECORDS_MAX 128
+#endif
+/* largest Buffer_Size of an Event Log, in records */
+#ifndef BACNET_EVENT_LOG_BUFFER_SIZE_MAX
+#define BACNET_EVENT_LOG_BUFFER_SIZE_MAX 65535UL
+#endif
+/* size of a record slot in the storage block of an Event Log: the
+   4 octet time of the record, the 2 octet length of the encoded
+   BACnetEventLogRecord, and the record. The message text of a
+   notification that does not fit is left out of its record. */
+#ifndef BACNET_EVENT_LOG_RECORD_SIZE
+#define BACNET_EVENT_LOG_RECORD_SIZE 256
+#endif
+/* size of the header of the storage block of an Event Log */
+#define BACNET_EVENT_LOG_STORAGE_HEADER_SIZE 24
+/* size of the storage block of an Event Log with a given buffer size */
+#define BACNET_EVENT_LOG_STORAGE_SIZE(buffer_size) \
+    (BACNET_EVENT_LOG_STORAGE_HEADER_SIZE +      \
+     ((size_t)(buffer_size) * BACNET_EVENT_LOG_RECORD_SIZE))
+
+/**
+ * @brief Callback to get the storage block of a log
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param size - [in] the size wanted for a new block,
+ *  [out] the size of the block, which may be an existing one
+ * @return the storage block, or NULL if there is none
+ */
+typedef uint8_t *(*event_log_storage_open_callback)(
+    unsigned device_index, uint32_t object_instance, size_t *size);
+
+/**
+ * @brief Callback to let go of the storage block of a log
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param storage - the storage block
+ * @param size - the size of the storage block
+ * @param purge - true if the records are no longer wanted
+ */
+typedef void (*event_log_storage_close_callback)(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Event_Log_Property_Lists(
+    const int32_t **pRequired,
+    const int32_t **pOptional,
+    const int32_t **pProprietary);
+BACNET_STACK_EXPORT
+void Event_Log_Writable_Property_List(
+    uint32_t object_instance, const int32_t **properties);
+
+BACNET_STACK_EXPORT
+bool Event_Log_Valid_Instance(uint32_t object_instance);
+BACNET_STACK_EXPORT
+unsigned Event_Log_Count(void);
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Index_To_Instance(unsigned index);
+BACNET_STACK_EXPORT
+unsigned Event_Log_Instance_To_Index(uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+bool Event_Log_Object_Name(
+    uint32_t object_instance, BACNET_CHARACTER_STRING *object_name);
+BACNET_STACK_EXPORT
+bool Event_Log_Name_Set(uint32_t object_instance, const char *new_name);
+BACNET_STACK_EXPORT
+const char *Event_Log_Name_ASCII(uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+const char *Event_Log_Description(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Log_Description_Set(uint32_t object_instance, const char *new_name);
+
+BACNET_STACK_EXPORT
+int Event_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
+BACNET_STACK_EXPORT
+bool Event_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
+
+BACNET_STACK_EXPORT
+bool Event_Log_Enable(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Log_Enable_Set(uint32_t object_instance, bool enable);
+BACNET_STACK_EXPORT
+bool Event_Log_Stop_When_Full(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Log_Stop_When_Full_Set(
+    uint32_t object_instance, bool stop_when_full);
+
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Buffer_Size(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Log_Buffer_Size_Set(uint32_t object_instance, uint32_t buffer_size);
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Record_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Total_Record_Count(uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+void Event_Log_Record_Status_Insert(
+    uint32_t object_instance, BACNET_LOG_STATUS log_status, bool state);
+BACNET_STACK_EXPORT
+bool Event_Log_Record_Notification_Insert(
+    uint32_t object_instance, const BACNET_EVENT_NOTIFICATION_DATA *data);
+BACNET_STACK_EXPORT
+void Event_Log_Event_Notification(const BACNET_EVENT_NOTIFICATION_DATA *data);
+
+BACNET_STACK_EXPORT
+int Event_Log_Read_Range_By_Position(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+BACNET_STACK_EXPORT
+int Event_Log_Read_Range_By_Sequence(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+BACNET_STACK_EXPORT
+int Event_Log_Read_Range_By_Time(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+BACNET_STACK_EXPORT
+int Event_Log_Read_Range(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+BACNET_STACK_EXPORT
+bool Event_Log_Read_Range_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo);
+
+BACNET_STACK_EXPORT
+void *Event_Log_Context_Get(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Event_Log_Context_Set(uint32_t object_instance, void *context);
+
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Create(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Log_Delete(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Event_Log_Cleanup(void);
+BACNET_STACK_EXPORT
+void Event_Log_Storage_Callback_Set(
+    event_log_storage_open_callback open_callback,
+    event_log_storage_close_callback close_callback);
+BACNET_STACK_EXPORT
+void Event_Log_Init(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -41,6 +41,7 @@
 /* os specific includes */
 #include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keyhash.h"
 
 /* forward prototypes */
 int Routed_Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata);
@@ -72,10 +73,185 @@ uint16_t Num_Managed_Devices = 0;
  * Since we are not using actual class objects here, the best we can do is
  * keep this local variable which notes which of the Devices the current
  * request is addressing.  Should default to 0, the main gateway Device.
+ * Each thread has its own copy, so that threads serving requests for
+ * different Devices do not switch the objects under each other.  Only
+ * the selection is per thread: nothing else here has a lock, so each
+ * routed Device must be served from one thread, and nothing else of the
+ * stack may run in another thread at the same time.  The Devices[] table
+ * and its indexes, which even a MAC address search may rebuild, are
+ * shared, as are the TSM and the transmit buffer.
  */
-uint16_t iCurrent_Device_Idx = 0;
+static BACNET_STACK_THREAD_LOCAL uint16_t iCurrent_Device_Idx = 0;
+
+/** Index of the Devices[] entries by Device object name hash, and by
+ * Device object instance number.  Without the index, for example when
+ * it can not be allocated, the Devices[] entries are searched.
+ */
+static OS_Keyhash Routed_Device_Name_Index;
+static OS_Keyhash Routed_Device_Instance_Index;
+/** Index of the routed Devices[] entries by virtual MAC address hash.
+ * The applications set the bacDevAddr of a Device directly, so every
+ * match is checked against the entry, and the index is rebuilt when a
+ * MAC address is not found in it.
+ */
+static OS_Keyhash Routed_Device_MAC_Index;
+
+/**
+ * @brief Compute the hash of a routed device name for the index
+ * @param name [in] The Device object name
+ * @param length [in] The length of the name
+ * @return hash of the name
+ */
+static uint32_t Routed_Device_Name_Hash(const char *name, size_t length)
+{
+    return Keyhash_FNV1a(name, length);
+}
+
+/**
+ * @brief Remove a Devices[] entry from the index, before its name or
+ *  instance number is changed
+ * @param idx [in] Index into Devices[] array
+ */
+static void Routed_Device_Index_Remove(uint16_t idx)
+{
+    DEVICE_OBJECT_DATA *pDev = &Devices[idx];
+
+    if (!Routed_Device_Name_Index) {
+        return;
+    }
+    (void)Keyhash_Remove(
+        Routed_Device_Name_Index,
+        Routed_Device_Name_Hash(
+            pDev->bacObj.Object_Name, strlen(pDev->bacObj.Object_Name)),
+        idx);
+    (void)Keyhash_Remove(
+        Routed_Device_Instance_Index, pDev->bacObj.Object_Instance_Number,
+        idx);
+}
+
+/**
+ * @brief Add a Devices[] entry to the index, after its name or
+ *  instance number is changed
+ * @param idx [in] Index into Devices[] array
+ */
+static void Routed_Device_Index_Add(uint16_t idx)
+{
+    DEVICE_OBJECT_DATA *pDev = &Devices[idx];
+
+    if (!Routed_Device_Name_Index) {
+        Routed_Device_Name_Index = Keyhash_Create();
+        Routed_Device_Instance_Index = Keyhash_Create();
+        if (!Routed_Device_Name_Index || !Routed_Device_Instance_Index) {
+            Keyhash_Delete(Routed_Device_Name_Index);
+            Keyhash_Delete(Routed_Device_Instance_Index);
+            Routed_Device_Name_Index = NULL;
+            Routed_Device_Instance_Index = NULL;
+            return;
+        }
+    }
+    (void)Keyhash_Add(
+        Routed_Device_Name_Index,
+        Routed_Device_Name_Hash(
+            pDev->bacObj.Object_Name, strlen(pDev->bacObj.Object_Name)),
+        idx);
+    (void)Keyhash_Add(
+        Routed_Device_Instance_Index, pDev->bacObj.Object_Instance_Number,
+        idx);
+}
+
+/**
+ * @brief Rebuild the index of the routed Devices[] entries by MAC address
+ * @return true if the index is available
+ */
+static bool Routed_Device_MAC_Index_Rebuild(void)
+{
+    const BACNET_ADDRESS *addr;
+    uint16_t idx;
+
+    if (!Routed_Device_MAC_Index) {
+        Routed_Device_MAC_Index = Keyhash_Create();
+        if (!Routed_Device_MAC_Index) {
+            return false;
+        }
+    } else {
+        Keyhash_Clear(Routed_Device_MAC_Index);
+    }
+    /* the gateway Device is not on the virtual network */
+    for (idx = 1; idx < min(MAX_NUM_DEVICES, Num_Managed_Devices); idx++) {
+        addr = &Devices[idx].bacDevAddr;
+        if ((addr->len > 0) && (addr->len <= MAX_MAC_LEN)) {
+            (void)Keyhash_Add(
+                Routed_Device_MAC_Index, Keyhash_FNV1a(addr->adr, addr->len),
+                idx);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find the first routed Device at or after an index, that has
+ *  a virtual MAC address
+ * @param dlen [in] Length of the MAC address, greater than 0
+ * @param dadr [in] The MAC address
+ * @param start [in] Index into Devices[] array to start the search at
+ * @param found [out] Index into Devices[] array of the Device
+ * @return true if a Device was found
+ */
+static bool Routed_Device_MAC_Find(
+    uint8_t dlen, const uint8_t *dadr, int start, int *found)
+{
+    unsigned iterator;
+    KEY key = 0;
+    bool rebuilt = false;
+    int idx = -1;
+
+    if (!Routed_Device_MAC_Index) {
+        if (!Routed_Device_MAC_Index_Rebuild()) {
+            /* without the index, the Devices[] entries are searched */
+            for (idx = start; idx < min(MAX_NUM_DEVICES, Num_Managed_Devices);
+                 idx++) {
+                if ((Devices[idx].bacDevAddr.len == dlen) &&
+                    (memcmp(Devices[idx].bacDevAddr.adr, dadr, dlen) == 0)) {
+                    *found = idx;
+                    return true;
+                }
+            }
+            return false;
+        }
+        rebuilt = true;
+    }
+    for (;;) {
+        iterator = 0;
+        while (Keyhash_Find(
+            Routed_Device_MAC_Index, Keyhash_FNV1a(dadr, dlen), &iterator,
+            &key)) {
+            /* different addresses may have the same hash */
+            if (((int)key >= start) && ((idx < 0) || ((int)key < idx)) &&
+                (key < min(MAX_NUM_DEVICES, Num_Managed_Devices)) &&
+                (Devices[key].bacDevAddr.len == dlen) &&
+                (memcmp(Devices[key].bacDevAddr.adr, dadr, dlen) == 0)) {
+                idx = (int)key;
+            }
+        }
+        if ((idx >= 0) || rebuilt) {
+            break;
+        }
+        /* a MAC address may have changed since the index was built */
+        (void)Routed_Device_MAC_Index_Rebuild();
+        rebuilt = true;
+    }
+    if (idx < 0) {
+        return false;
+    }
+    *found = idx;
+
+    return true;
+}
 
 /** Get the current routed device object index.
+ * @note The index is selected per thread, and defaults to 0, the gateway
+ *  Device, in each new thread.
  * @return Index of the currently active routed device in Devices[] array
  */
 uint16_t Routed_Device_Object_Index(void)
@@ -91,7 +267,11 @@ uint16_t Get_Num_Managed_Devices(void)
     return Num_Managed_Devices;
 }
 
-/** Set the current routed device object index.
+/** Set the current routed device object index of the calling thread.
+ * The object modules select the objects of this Device, so a thread that
+ * serves a request for a routed Device selects the Device first.  Other
+ * threads may select other Devices, but see iCurrent_Device_Idx for what
+ * they must not do at the same time.
  * @param idx [in] Index of the routed device to set as current
  * @return true if index is valid and set, false if index exceeds
  * MAX_NUM_DEVICES
@@ -136,6 +316,8 @@ uint16_t Add_Routed_Device(
         iCurrent_Device_Idx = i;
         pDev->bacObj.mObject_Type = OBJECT_DEVICE;
         pDev->bacObj.Object_Instance_Number = Object_Instance;
+        pDev->bacObj.Object_Name[0] = 0;
+        Routed_Device_Index_Add(i);
         if (sObject_Name != NULL) {
             Routed_Device_Set_Object_Name(
                 sObject_Name->encoding, sObject_Name->value,
@@ -319,13 +501,17 @@ bool Routed_Device_GetNext(
             /* Step over this case (starting point) */
             idx = 1;
         }
-        while (idx < min(MAX_NUM_DEVICES, Num_Managed_Devices)) {
+        if (dest->len > 0) {
+            /* directed to a virtual MAC address: find it in the index */
+            if ((dest->len <= MAX_MAC_LEN) &&
+                Routed_Device_MAC_Find(dest->len, dest->adr, idx, &idx)) {
+                bSuccess =
+                    Routed_Device_Address_Lookup(idx++, dest->len, dest->adr);
+            }
+        } else if (idx < min(MAX_NUM_DEVICES, Num_Managed_Devices)) {
+            /* a MAC broadcast matches each Device in turn */
             bSuccess =
                 Routed_Device_Address_Lookup(idx++, dest->len, dest->adr);
-            if (bSuccess) {
-                /* We don't need to keep looking */
-                break;
-            }
         }
     }
     if (!bSuccess) {
@@ -389,13 +575,11 @@ uint32_t Routed_Device_Index_To_Instance(unsigned index)
  */
 static uint32_t Routed_Device_Instance_To_Index(uint32_t Instance_Number)
 {
-    int i;
+    uint16_t idx = 0;
 
-    for (i = 0; i < min(MAX_NUM_DEVICES, Num_Managed_Devices); i++) {
-        if (Devices[i].bacObj.Object_Instance_Number == Instance_Number) {
-            /* Found Instance, so return the Device Index Number */
-            return i;
-        }
+    if (Routed_Device_Instance_Find(Instance_Number, &idx)) {
+        /* Found Instance, so return the Device Index Number */
+        return idx;
     }
 
     /* We did not find instance... so simply return an Index of 0
@@ -403,6 +587,92 @@ static uint32_t Routed_Device_Instance_To_Index(uint32_t Instance_Number)
     return 0;
 }
 
+/**
+ * @brief Find the routed device with a Device object instance number
+ * @param object_instance [in] Device object instance number to find
+ * @param idx [out] Index into Devices[] array of the device, if found
+ * @return true if the device was found
+ */
+bool Routed_Device_Instance_Find(uint32_t object_instance, uint16_t *idx)
+{
+    unsigned iterator = 0;
+    KEY key = 0;
+    int i;
+
+    if (Routed_Device_Instance_Index) {
+        while (Keyhash_Find(
+            Routed_Device_Instance_Index, object_instance, &iterator, &key)) {
+            if ((key < Num_Managed_Devices) &&
+                (Devices[key].bacObj.Object_Instance_Number ==
+                 object_instance)) {
+                if (idx) {
+                    *idx = (uint16_t)key;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+    for (i = 0; i < min(MAX_NUM_DEVICES, Num_Managed_Devices); i++) {
+        if (Devices[i].bacObj.Object_Instance_Number == object_instance) {
+            if (idx) {
+                *idx = (uint16_t)i;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Find the routed device with a Device object name
+ * @param object_name [in] Device object name to find
+ * @param idx [out] Index into Devices[] array of the device, if found
+ * @return true if the device was found
+ */
+bool Routed_Device_Name_Find(
+    const BACNET_CHARACTER_STRING *object_name, uint16_t *idx)
+{
+    BACNET_CHARACTER_STRING device_name;
+    unsigned iterator = 0;
+    KEY key = 0;
+    int i;
+
+    if (Routed_Device_Name_Index) {
+        while (Keyhash_Find(
+            Routed_Device_Name_Index,
+            Routed_Device_Name_Hash(
+                characterstring_value(object_name),
+                characterstring_length(object_name)),
+            &iterator, &key)) {
+            /* different names may have the same hash */
+            if ((key < Num_Managed_Devices) &&
+                characterstring_init_ansi(
+                    &device_name, Devices[key].bacObj.Object_Name) &&
+                characterstring_same(object_name, &device_name)) {
+                if (idx) {
+                    *idx = (uint16_t)key;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+    for (i = 0; i < min(MAX_NUM_DEVICES, Num_Managed_Devices); i++) {
+        if (characterstring_init_ansi(
+                &device_name, Devices[i].bacObj.Object_Name) &&
+            characterstring_same(object_name, &device_name)) {
+            if (idx) {
+                *idx = (uint16_t)i;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /**
  * Determines if a given Device instance is valid
  *
@@ -548,7 +818,9 @@ bool Routed_Device_Set_Object_Instance_Number(uint32_t object_id)
 
     if (object_id <= BACNET_MAX_INSTANCE) {
         /* Make the change and update the database revision */
+        Routed_Device_Index_Remove(iCurrent_Device_Idx);
         Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number = object_id;
+        Routed_Device_Index_Add(iCurrent_Device_Idx);
         Routed_Device_Inc_Database_Revision();
     } else {
         status = false;
@@ -571,8 +843,10 @@ bool Routed_Device_Set_Object_Name(
 
     if ((encoding == CHARACTER_UTF8) && (length < MAX_DEV_NAME_LEN)) {
         /* Make the change and update the database revision */
+        Routed_Device_Index_Remove(iCurrent_Device_Idx);
         memmove(pDev->bacObj.Object_Name, value, length);
         pDev->bacObj.Object_Name[length] = 0;
+        Routed_Device_Index_Add(iCurrent_Device_Idx);
         Routed_Device_Inc_Database_Revision();
         status = true;
     }
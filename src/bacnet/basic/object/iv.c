@@ -18,6 +18,7 @@
 /* BACnet Stack API */
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
 #include "bacnet/bactext.h"
 #include "bacnet/proplist.h"
 /* basic objects and services */
@@ -217,18 +218,14 @@ int32_t Integer_Value_Present_Value(uint32_t object_instance)
  * @param index  Object index
  * @param value  Given present value.
  */
-static void
-Integer_Value_COV_Detect(struct integer_object *pObject, int32_t value)
+static void Integer_Value_COV_Detect(
+    uint32_t object_instance, struct integer_object *pObject, int32_t value)
 {
-    if (pObject) {
-        int32_t prior_value = pObject->Prior_Value;
-        uint32_t cov_increment = pObject->COV_Increment;
-        uint32_t cov_delta = (uint32_t)abs(prior_value - value);
-
-        if (cov_delta >= cov_increment) {
-            pObject->Changed = true;
-            pObject->Prior_Value = value;
-        }
+    if (pObject &&
+        cov_filter_signed(
+            &pObject->Prior_Value, value, pObject->COV_Increment)) {
+        pObject->Changed = true;
+        cov_change_of_value_notify(Object_Type, object_instance);
     }
 }
 
@@ -249,7 +246,7 @@ bool Integer_Value_Present_Value_Set(
     (void)priority;
 
     if (pObject) {
-        Integer_Value_COV_Detect(pObject, value);
+        Integer_Value_COV_Detect(object_instance, pObject, value);
         pObject->Present_Value = value;
         status = true;
     }
@@ -749,7 +746,8 @@ void Integer_Value_COV_Increment_Set(uint32_t object_instance, uint32_t value)
 
     if (pObject) {
         pObject->COV_Increment = value;
-        Integer_Value_COV_Detect(pObject, pObject->Present_Value);
+        Integer_Value_COV_Detect(
+            object_instance, pObject, pObject->Present_Value);
     }
 }
 
@@ -94,6 +94,11 @@ struct object_data {
     /* state machine task time tracking per object */
     uint32_t Update_Interval;
     uint32_t Task_Milliseconds;
+    /* manipulated object write held back by the ramp window */
+    bool Write_Pending : 1;
+    bool Write_Relinquish : 1;
+    float Write_Value;
+    uint32_t Ramp_Milliseconds;
     void *Context;
     const char *Object_Name;
     const char *Description;
@@ -105,6 +110,12 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* manipulated object writes of many objects, given at once */
+static load_control_batch_write_callback Batch_Write_Callback;
+static BACNET_LOAD_CONTROL_WRITE Batch_Writes[LOAD_CONTROL_BATCH_WRITES_MAX];
+static unsigned Batch_Write_Count;
+/* window over which the shed and restore writes are spread */
+static uint32_t Ramp_Window_Milliseconds;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Load_Control_Properties_Required[] = {
@@ -477,12 +488,117 @@ static bool Able_To_Meet_Shed_Request(struct object_data *pObject)
     return status;
 }
 
+/**
+ * @brief Give the batched manipulated object writes to the batch callback
+ */
+static void Batch_Write_Flush(void)
+{
+    if (Batch_Write_Count > 0) {
+        if (Batch_Write_Callback) {
+            Batch_Write_Callback(Batch_Writes, Batch_Write_Count);
+        }
+        Batch_Write_Count = 0;
+    }
+}
+
+/**
+ * @brief Perform the manipulated object write that is held by the object
+ * @param pObject - object instance data
+ */
+static void Manipulated_Object_Deliver(struct object_data *pObject)
+{
+    BACNET_LOAD_CONTROL_WRITE *write;
+
+    pObject->Write_Pending = false;
+    if (Batch_Write_Callback) {
+        write = &Batch_Writes[Batch_Write_Count];
+        write->object_type = pObject->Manipulated_Object_Type;
+        write->object_instance = pObject->Manipulated_Object_Instance;
+        write->property_id = pObject->Manipulated_Object_Property;
+        write->priority = pObject->Priority_For_Writing;
+        write->relinquish = pObject->Write_Relinquish;
+        write->value = pObject->Write_Value;
+        Batch_Write_Count++;
+        if (Batch_Write_Count >= LOAD_CONTROL_BATCH_WRITES_MAX) {
+            Batch_Write_Flush();
+        }
+    } else if (pObject->Write_Relinquish) {
+        if (pObject->Manipulated_Object_Relinquish) {
+            pObject->Manipulated_Object_Relinquish(
+                pObject->Manipulated_Object_Type,
+                pObject->Manipulated_Object_Instance,
+                pObject->Manipulated_Object_Property,
+                pObject->Priority_For_Writing);
+        }
+    } else if (pObject->Manipulated_Object_Write) {
+        pObject->Manipulated_Object_Write(
+            pObject->Manipulated_Object_Type,
+            pObject->Manipulated_Object_Instance,
+            pObject->Manipulated_Object_Property,
+            pObject->Priority_For_Writing, pObject->Write_Value);
+    }
+}
+
+/**
+ * @brief Write or relinquish the manipulated object. When a ramp window
+ *  is set, the write of each object is held back by its share of the
+ *  window, so that the objects that shed or restore at the same moment
+ *  are spread over the window instead of written all at once.
+ * @param pObject - object instance data
+ * @param index - object index in the list
+ * @param relinquish - true to relinquish the priority for writing
+ * @param value - value to write, when not relinquishing
+ */
+static void Manipulated_Object_Command(
+    struct object_data *pObject, int index, bool relinquish, float value)
+{
+    int count;
+
+    if (!pObject->Write_Pending) {
+        pObject->Ramp_Milliseconds = 0;
+        count = Keylist_Count(Object_List);
+        if ((Ramp_Window_Milliseconds > 0) && (count > 1) && (index >= 0)) {
+            /* spread evenly using the position of this object */
+            pObject->Ramp_Milliseconds = (uint32_t)(
+                ((uint64_t)Ramp_Window_Milliseconds * (uint64_t)index) /
+                (uint64_t)count);
+        }
+    }
+    /* a held write is replaced by the newest value */
+    pObject->Write_Pending = true;
+    pObject->Write_Relinquish = relinquish;
+    pObject->Write_Value = value;
+    if (pObject->Ramp_Milliseconds == 0) {
+        Manipulated_Object_Deliver(pObject);
+    }
+}
+
+/**
+ * @brief Count down the ramp window share of a held write
+ * @param pObject - object instance data
+ * @param milliseconds - elapsed time in milliseconds
+ */
+static void Manipulated_Object_Ramp_Timer(
+    struct object_data *pObject, uint16_t milliseconds)
+{
+    if (!pObject->Write_Pending) {
+        return;
+    }
+    if (pObject->Ramp_Milliseconds > milliseconds) {
+        pObject->Ramp_Milliseconds -= milliseconds;
+    } else {
+        pObject->Ramp_Milliseconds = 0;
+        Manipulated_Object_Deliver(pObject);
+    }
+}
+
 /**
  * @brief Determine if the object can now comply with the shed request
  * @param pObject - object instance to get
+ * @param index - object index in the list
  * @return true if the object can comply with the shed request
  */
-static bool Can_Now_Comply_With_Shed(struct object_data *pObject)
+static bool Can_Now_Comply_With_Shed(struct object_data *pObject, int index)
 {
     float level = 0.0f;
     float requested_level = 0.0f;
@@ -502,14 +618,8 @@ static bool Can_Now_Comply_With_Shed(struct object_data *pObject)
     if (!status) {
         /* the object attempts to meet the shed request
            until the shed is achieved. */
-        if (pObject->Manipulated_Object_Write) {
-            pObject->Manipulated_Object_Write(
-                pObject->Manipulated_Object_Type,
-                pObject->Manipulated_Object_Instance,
-                pObject->Manipulated_Object_Property,
-                pObject->Priority_For_Writing,
-                Requested_Shed_Level_Value(pObject));
-        }
+        Manipulated_Object_Command(
+            pObject, index, false, Requested_Shed_Level_Value(pObject));
     }
 
     return status;
@@ -671,7 +781,7 @@ void Load_Control_State_Machine(
                 pObject->Present_Value = BACNET_SHED_REQUEST_PENDING;
                 break;
             }
-            if (Can_Now_Comply_With_Shed(pObject)) {
+            if (Can_Now_Comply_With_Shed(pObject, object_index)) {
                 /* CanNowComplyWithShed */
                 debug_printf(
                     "Load Control[%d]:Able to meet Shed Request\n",
@@ -696,13 +806,7 @@ void Load_Control_State_Machine(
                     "Duration\n",
                     object_index);
                 datetime_wildcard_set(&pObject->Start_Time);
-                if (pObject->Manipulated_Object_Relinquish) {
-                    pObject->Manipulated_Object_Relinquish(
-                        pObject->Manipulated_Object_Type,
-                        pObject->Manipulated_Object_Instance,
-                        pObject->Manipulated_Object_Property,
-                        pObject->Priority_For_Writing);
-                }
+                Manipulated_Object_Command(pObject, object_index, true, 0.0f);
                 pObject->Present_Value = BACNET_SHED_INACTIVE;
                 break;
             }
@@ -790,6 +894,43 @@ bool Load_Control_Update_Interval_Set(uint32_t object_instance, uint32_t value)
     return status;
 }
 
+/**
+ * @brief Steps the ramp window and the state machine of one object
+ * @param index - object index in the list
+ * @param milliseconds - elapsed time in milliseconds from last call
+ * @param bdatetime - local date and time, read once when first needed
+ * @param bdatetime_valid - true once bdatetime has been read
+ */
+static void Load_Control_Object_Timer(
+    int index,
+    uint16_t milliseconds,
+    BACNET_DATE_TIME *bdatetime,
+    bool *bdatetime_valid)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data_Index(Object_List, index);
+    if (!pObject) {
+        return;
+    }
+    Manipulated_Object_Ramp_Timer(pObject, milliseconds);
+    pObject->Task_Milliseconds += milliseconds;
+    if (pObject->Task_Milliseconds >= pObject->Update_Interval) {
+        pObject->Task_Milliseconds = 0;
+        if (!*bdatetime_valid) {
+            datetime_local(&bdatetime->date, &bdatetime->time, NULL, NULL);
+            *bdatetime_valid = true;
+        }
+        Load_Control_State_Machine(index, bdatetime);
+        if (pObject->Present_Value != pObject->Previous_Value) {
+            debug_printf(
+                "Load Control[%d]=%s\n", index,
+                bactext_shed_state_name(pObject->Present_Value));
+            pObject->Previous_Value = pObject->Present_Value;
+        }
+    }
+}
+
 /**
  * @brief Load Control State Machine Handler
  * @param object_instance - object-instance number of the object
@@ -798,25 +939,70 @@ bool Load_Control_Update_Interval_Set(uint32_t object_instance, uint32_t value)
 void Load_Control_Timer(uint32_t object_instance, uint16_t milliseconds)
 {
     BACNET_DATE_TIME bdatetime = { 0 };
-    struct object_data *pObject;
-    int index = 0;
+    bool bdatetime_valid = false;
+    int index;
 
-    pObject = Object_Instance_Data(object_instance);
-    if (pObject) {
-        pObject->Task_Milliseconds += milliseconds;
-        if (pObject->Task_Milliseconds >= pObject->Update_Interval) {
-            pObject->Task_Milliseconds = 0;
-            datetime_local(&bdatetime.date, &bdatetime.time, NULL, NULL);
-            index = Keylist_Index(Object_List, object_instance);
-            Load_Control_State_Machine(index, &bdatetime);
-            if (pObject->Present_Value != pObject->Previous_Value) {
-                debug_printf(
-                    "Load Control[%d]=%s\n", index,
-                    bactext_shed_state_name(pObject->Present_Value));
-                pObject->Previous_Value = pObject->Present_Value;
-            }
-        }
+    index = Keylist_Index(Object_List, object_instance);
+    if (index >= 0) {
+        Load_Control_Object_Timer(
+            index, milliseconds, &bdatetime, &bdatetime_valid);
+        Batch_Write_Flush();
+    }
+}
+
+/**
+ * @brief Demand response dispatcher: steps the state machine of every
+ *  Load Control object with one reading of the local date and time, and
+ *  gives the manipulated object writes of all the objects to the batch
+ *  write callback in batches of #LOAD_CONTROL_BATCH_WRITES_MAX.
+ * @note Use this instead of Load_Control_Timer() for each object,
+ *  not in addition to it.
+ * @param milliseconds - elapsed time in milliseconds from last call
+ */
+void Load_Control_Dispatch_Timer(uint16_t milliseconds)
+{
+    BACNET_DATE_TIME bdatetime = { 0 };
+    bool bdatetime_valid = false;
+    int index, count;
+
+    count = Keylist_Count(Object_List);
+    for (index = 0; index < count; index++) {
+        Load_Control_Object_Timer(
+            index, milliseconds, &bdatetime, &bdatetime_valid);
     }
+    Batch_Write_Flush();
+}
+
+/**
+ * @brief Sets the callback that performs the manipulated object writes of
+ *  many Load Control objects at once, instead of the write and relinquish
+ *  callbacks of each object
+ * @param cb - batch write callback, or NULL to use the object callbacks
+ */
+void Load_Control_Batch_Write_Callback_Set(load_control_batch_write_callback cb)
+{
+    Batch_Write_Flush();
+    Batch_Write_Callback = cb;
+}
+
+/**
+ * @brief Sets the window over which the shed and restore writes of the
+ *  Load Control objects are spread
+ * @param milliseconds - ramp window, or 0 to write at once
+ */
+void Load_Control_Ramp_Window_Set(uint32_t milliseconds)
+{
+    Ramp_Window_Milliseconds = milliseconds;
+}
+
+/**
+ * @brief Gets the window over which the shed and restore writes of the
+ *  Load Control objects are spread
+ * @return ramp window in milliseconds
+ */
+uint32_t Load_Control_Ramp_Window(void)
+{
+    return Ramp_Window_Milliseconds;
 }
 
 /**
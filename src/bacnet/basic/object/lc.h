@@ -68,6 +68,34 @@ typedef void (*load_control_manipulated_object_read_callback)(
     uint8_t *priority,
     float *value);
 
+/**
+ * @brief One write or relinquish of a manipulated object, given to the
+ *  batch write callback
+ */
+typedef struct load_control_write {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID property_id;
+    uint8_t priority;
+    /* true to relinquish the priority, false to write the value */
+    bool relinquish;
+    float value;
+} BACNET_LOAD_CONTROL_WRITE;
+
+/**
+ * @brief Callback for the manipulated object writes of many Load Control
+ *  objects at once
+ * @param  writes - the writes and relinquishes to perform
+ * @param  count - number of writes
+ */
+typedef void (*load_control_batch_write_callback)(
+    const BACNET_LOAD_CONTROL_WRITE *writes, unsigned count);
+
+/* number of manipulated object writes given to one batch write callback */
+#ifndef LOAD_CONTROL_BATCH_WRITES_MAX
+#define LOAD_CONTROL_BATCH_WRITES_MAX 32
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -218,6 +246,15 @@ bool Load_Control_Update_Interval_Set(uint32_t object_instance, uint32_t value);
 
 BACNET_STACK_EXPORT
 void Load_Control_Timer(uint32_t object_instance, uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void Load_Control_Dispatch_Timer(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void Load_Control_Batch_Write_Callback_Set(
+    load_control_batch_write_callback cb);
+BACNET_STACK_EXPORT
+void Load_Control_Ramp_Window_Set(uint32_t milliseconds);
+BACNET_STACK_EXPORT
+uint32_t Load_Control_Ramp_Window(void);
 
 /* functions used for unit testing */
 BACNET_STACK_EXPORT
@@ -21,9 +21,11 @@
 #include "bacnet/lighting.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/slab.h"
 #include "bacnet/basic/sys/linear.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/lighting_command.h"
+#include "bacnet/basic/sys/priority_array.h"
 #include "bacnet/bactext.h"
 #include "bacnet/proplist.h"
 /* BACnet Stack Objects */
@@ -45,7 +47,7 @@ struct object_data {
     BACNET_LIGHTING_TRANSITION Transition;
     float Feedback_Value;
     float Priority_Array[BACNET_MAX_PRIORITY];
-    uint16_t Priority_Active_Bits;
+    PRIORITY_ARRAY_STATE Priority_State;
     float Relinquish_Default;
     float Power;
     float Instantaneous_Power;
@@ -67,9 +69,14 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* memory pool for the object data */
+static SLAB_TYPE Object_Slab = SLAB_ACCOUNT_INITIALIZER(
+    sizeof(struct object_data), MEMSTAT_ACCOUNT_OBJECT(OBJECT_LIGHTING_OUTPUT));
 /* callback for present value writes */
 static lighting_command_tracking_value_callback
     Lighting_Command_Tracking_Value_Callback;
+/* callback for tracking the objects with a lighting command in progress */
+static lighting_output_active_callback Lighting_Output_Active_Callback;
 
 /* These arrays are used by the ReadPropertyMultiple handler and
    property-list property (as of protocol-revision 14) */
@@ -270,9 +277,7 @@ static bool Priority_Array_Active(
     bool active = false;
 
     if (priority < BACNET_MAX_PRIORITY) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, priority)) {
-            active = true;
-        }
+        active = priority_array_active(&pObject->Priority_State, priority + 1);
     }
 
     return active;
@@ -291,7 +296,7 @@ static float Priority_Array_Value(
     float real_value = 0.0;
 
     if (priority < BACNET_MAX_PRIORITY) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, priority)) {
+        if (Priority_Array_Active(pObject, priority)) {
             real_value = pObject->Priority_Array[priority];
         }
     }
@@ -330,10 +335,11 @@ static float Priority_Array_Next_Value(
     unsigned p;
 
     real_value = Relinquish_Default_Value(pObject);
-    for (p = priority; p < BACNET_MAX_PRIORITY; p++) {
-        if (Priority_Array_Active(pObject, p)) {
-            real_value = pObject->Priority_Array[p];
-            break;
+    if (priority < BACNET_MAX_PRIORITY) {
+        p = priority_array_next_priority(
+            &pObject->Priority_State, priority + 1);
+        if (p) {
+            real_value = pObject->Priority_Array[p - 1];
         }
     }
 
@@ -401,14 +407,11 @@ static int Lighting_Output_Priority_Array_Encode(
  */
 static unsigned Present_Value_Priority(const struct object_data *pObject)
 {
-    unsigned p; /* loop counter */
-    unsigned priority = BACNET_MAX_PRIORITY + 1; /* return value */
+    unsigned priority; /* return value */
 
-    for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-            priority = p + 1;
-            break;
-        }
+    priority = priority_array_active_priority(&pObject->Priority_State);
+    if (priority == 0) {
+        priority = BACNET_MAX_PRIORITY + 1;
     }
 
     return priority;
@@ -430,8 +433,8 @@ Present_Value_Relinquish(struct object_data *pObject, unsigned priority)
 
     if (priority && (priority <= BACNET_MAX_PRIORITY) &&
         (priority != 6 /* reserved */)) {
+        priority_array_relinquish(&pObject->Priority_State, priority);
         priority--;
-        BIT_CLEAR(pObject->Priority_Active_Bits, priority);
         pObject->Priority_Array[priority] = 0.0;
         status = true;
     }
@@ -470,8 +473,8 @@ Present_Value_Set(struct object_data *pObject, float value, unsigned priority)
 
     if (priority && (priority <= BACNET_MAX_PRIORITY) &&
         (priority != 6 /* reserved */)) {
+        priority_array_command(&pObject->Priority_State, priority);
         priority--;
-        BIT_SET(pObject->Priority_Active_Bits, priority);
         /* Writes to Present_Value at a value greater than 0.0%
            but less than 1.0% shall be clamped to 1.0%.*/
         if ((isgreater(value, 0.0)) && (isless(value, 1.0))) {
@@ -558,6 +561,31 @@ Lighting_Command_Trim_Apply(struct object_data *pObject, unsigned priority)
     }
 }
 
+/**
+ * @brief Tells the active callback whether the lighting command of the
+ *  object has a fade, ramp, step or blink in progress
+ * @param pObject [in] object data
+ */
+static void Lighting_Output_Active_Update(const struct object_data *pObject)
+{
+    const struct bacnet_lighting_command_data *data;
+    bool active = true;
+
+    if (!Lighting_Output_Active_Callback) {
+        return;
+    }
+    data = &pObject->Lighting_Command;
+    if (((data->Lighting_Operation == BACNET_LIGHTS_NONE) ||
+         (data->Lighting_Operation == BACNET_LIGHTS_STOP)) &&
+        (data->In_Progress == BACNET_LIGHTING_IDLE) &&
+        (!data->Timer_Notification_Head.callback) &&
+        (!data->Timer_Notification_Head.next)) {
+        /* nothing to do until the next lighting command */
+        active = false;
+    }
+    Lighting_Output_Active_Callback(data->Key, active);
+}
+
 /**
  * @brief Set the lighting command if the priority is active
  * @param object [in] BACnet object instance
@@ -583,6 +611,7 @@ static void Lighting_Command_Fade_To(
         Lighting_Command_Trim_Apply(pObject, priority);
         /* configure the Lighting Command */
         lighting_command_fade_to(&pObject->Lighting_Command, value, fade_time);
+        Lighting_Output_Active_Update(pObject);
     }
 }
 
@@ -611,6 +640,7 @@ static void Lighting_Command_Ramp_To(
         Lighting_Command_Trim_Apply(pObject, priority);
         /* configure the Lighting Command */
         lighting_command_ramp_to(&pObject->Lighting_Command, value, ramp_rate);
+        Lighting_Output_Active_Update(pObject);
     }
 }
 
@@ -672,6 +702,7 @@ Lighting_Command_Warn(struct object_data *pObject, unsigned priority)
         lighting_command_blink_warn(
             &pObject->Lighting_Command, BACNET_LIGHTS_WARN,
             &pObject->Lighting_Command.Blink);
+        Lighting_Output_Active_Update(pObject);
     }
 }
 
@@ -748,6 +779,7 @@ Lighting_Command_Warn_Off(struct object_data *pObject, unsigned priority)
             blink.Callback = Lighting_Command_Blink_Stop;
             lighting_command_blink_warn(
                 &pObject->Lighting_Command, BACNET_LIGHTS_WARN_OFF, &blink);
+            Lighting_Output_Active_Update(pObject);
         } else {
             /* the value 0.0% written at the specified priority immediately */
             Present_Value_Set(pObject, 0.0, priority);
@@ -822,6 +854,7 @@ Lighting_Command_Warn_Relinquish(struct object_data *pObject, unsigned priority)
             lighting_command_blink_warn(
                 &pObject->Lighting_Command, BACNET_LIGHTS_WARN_RELINQUISH,
                 &blink);
+            Lighting_Output_Active_Update(pObject);
         } else {
             /* the value at the specified priority shall be
                relinquished immediately */
@@ -883,6 +916,7 @@ static void Lighting_Command_Step_Up_On(
         Lighting_Command_Trim_Apply(pObject, priority);
         lighting_command_step(
             &pObject->Lighting_Command, operation, step_increment);
+        Lighting_Output_Active_Update(pObject);
     }
 }
 
@@ -941,6 +975,7 @@ static void Lighting_Command_Step_Down_Off(
         Lighting_Command_Trim_Apply(pObject, priority);
         lighting_command_step(
             &pObject->Lighting_Command, operation, step_increment);
+        Lighting_Output_Active_Update(pObject);
     }
 }
 
@@ -1474,6 +1509,7 @@ Lighting_Command_Stop(struct object_data *pObject, unsigned priority)
             Present_Value_Set(pObject, value, priority);
             /* configure the Lighting Command */
             lighting_command_stop(&pObject->Lighting_Command);
+            Lighting_Output_Active_Update(pObject);
         }
     }
 }
@@ -1741,6 +1777,7 @@ bool Lighting_Output_Lighting_Command_Refresh(uint32_t object_instance)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         lighting_command_refresh(&pObject->Lighting_Command);
+        Lighting_Output_Active_Update(pObject);
         status = true;
     }
 
@@ -2645,6 +2682,7 @@ bool Lighting_Output_High_End_Trim_Set(uint32_t object_instance, float value)
                 pObject, Present_Value_Priority(pObject));
             if (!Lighting_Command_In_Progress(pObject)) {
                 lighting_command_refresh(&pObject->Lighting_Command);
+                Lighting_Output_Active_Update(pObject);
             }
             status = true;
         }
@@ -2722,6 +2760,7 @@ bool Lighting_Output_Low_End_Trim_Set(uint32_t object_instance, float value)
                 pObject, Present_Value_Priority(pObject));
             if (!Lighting_Command_In_Progress(pObject)) {
                 lighting_command_refresh(&pObject->Lighting_Command);
+                Lighting_Output_Active_Update(pObject);
             }
             status = true;
         }
@@ -2800,6 +2839,7 @@ bool Lighting_Output_Trim_Fade_Time_Set(
                 pObject, Present_Value_Priority(pObject));
             if (!Lighting_Command_In_Progress(pObject)) {
                 lighting_command_refresh(&pObject->Lighting_Command);
+                Lighting_Output_Active_Update(pObject);
             }
             status = true;
         }
@@ -2853,6 +2893,7 @@ bool Lighting_Output_Overridden_Set(uint32_t object_instance, float value)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         lighting_command_override_set(&pObject->Lighting_Command, value);
+        Lighting_Output_Active_Update(pObject);
         status = true;
     }
 
@@ -2877,6 +2918,7 @@ bool Lighting_Output_Overridden_Clear(uint32_t object_instance)
     if (pObject) {
         value = Priority_Array_Next_Value(pObject, 0);
         lighting_command_override_clear(&pObject->Lighting_Command, value);
+        Lighting_Output_Active_Update(pObject);
         status = true;
     }
 
@@ -2901,6 +2943,7 @@ bool Lighting_Output_Overridden_Momentary(uint32_t object_instance, float value)
     if (pObject) {
         /* set the override */
         lighting_command_override_momentary(&pObject->Lighting_Command, value);
+        Lighting_Output_Active_Update(pObject);
         status = true;
     }
 
@@ -3764,6 +3807,7 @@ void Lighting_Output_Timer(uint32_t object_instance, uint16_t milliseconds)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         lighting_command_timer(&pObject->Lighting_Command, milliseconds);
+        Lighting_Output_Active_Update(pObject);
     }
 }
 
@@ -3791,6 +3835,17 @@ void Lighting_Output_Write_Present_Value_Callback_Set(
     Lighting_Command_Tracking_Value_Callback = cb;
 }
 
+/**
+ * @brief Sets a callback told when a lighting command starts or ends,
+ *  so that only the objects with a lighting command in progress need
+ *  Lighting_Output_Timer()
+ * @param cb - callback used to track the active objects
+ */
+void Lighting_Output_Active_Callback_Set(lighting_output_active_callback cb)
+{
+    Lighting_Output_Active_Callback = cb;
+}
+
 /**
  * @brief Set the context used with a specific object instance
  * @param object_instance [in] BACnet object instance number
@@ -3849,7 +3904,7 @@ uint32_t Lighting_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Slab_Item_Alloc(&Object_Slab);
         if (!pObject) {
             return BACNET_MAX_INSTANCE;
         }
@@ -3878,9 +3933,9 @@ uint32_t Lighting_Output_Create(uint32_t object_instance)
         pObject->Default_Step_Increment = 1.0f;
         pObject->Transition = BACNET_LIGHTING_TRANSITION_FADE;
         pObject->Feedback_Value = 0.0f;
+        priority_array_init(&pObject->Priority_State);
         for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
             pObject->Priority_Array[p] = 0.0f;
-            BIT_CLEAR(pObject->Priority_Active_Bits, p);
         }
         pObject->Relinquish_Default = 0.0f;
         pObject->Power = 0.0f;
@@ -3894,7 +3949,7 @@ uint32_t Lighting_Output_Create(uint32_t object_instance)
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
-            free(pObject);
+            Slab_Free(&Object_Slab, pObject);
             return BACNET_MAX_INSTANCE;
         }
     }
@@ -3914,13 +3969,28 @@ bool Lighting_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        if (Lighting_Output_Active_Callback) {
+            Lighting_Output_Active_Callback(object_instance, false);
+        }
+        Slab_Free(&Object_Slab, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Reserves pool memory for Lighting Output objects, see Slab_Reserve()
+ * @param count - number of objects to reserve memory for
+ * @return true if the memory was reserved
+ */
+bool Lighting_Output_Pool_Reserve(uint32_t count)
+{
+    Slab_Retain_Set(&Object_Slab, true);
+
+    return Slab_Reserve(&Object_Slab, count);
+}
+
 /**
  * Deletes all the objects and their data
  */
@@ -3940,7 +4010,7 @@ void Lighting_Output_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
-                    free(pObject);
+                    Slab_Free(&Object_Slab, pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
@@ -3948,6 +4018,7 @@ void Lighting_Output_Cleanup(void)
         }
     }
 
+    Slab_Cleanup(&Object_Slab);
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
 #endif
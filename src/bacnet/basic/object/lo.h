@@ -17,6 +17,16 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/sys/lighting_command.h"
 
+/**
+ * @brief Callback for tracking which Lighting Output objects have a fade,
+ *  ramp, step or blink in progress, so that only those need to be given
+ *  the elapsed time
+ * @param  object_instance - object instance number
+ * @param  active - true while the lighting command is in progress
+ */
+typedef void (*lighting_output_active_callback)(
+    uint32_t object_instance, bool active);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -242,6 +252,8 @@ void Lighting_Output_Timer(uint32_t object_instance, uint16_t milliseconds);
 BACNET_STACK_EXPORT
 void Lighting_Output_Write_Present_Value_Callback_Set(
     lighting_command_tracking_value_callback cb);
+BACNET_STACK_EXPORT
+void Lighting_Output_Active_Callback_Set(lighting_output_active_callback cb);
 
 BACNET_STACK_EXPORT
 void *Lighting_Output_Context_Get(uint32_t object_instance);
@@ -253,6 +265,8 @@ uint32_t Lighting_Output_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
 bool Lighting_Output_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Lighting_Output_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Lighting_Output_Cleanup(void);
 BACNET_STACK_EXPORT
 void Lighting_Output_Init(void);
@@ -45,14 +45,28 @@ static const BACNET_OBJECT_TYPE Object_Type = OBJECT_LOOP;
 /* handling for manipulated and reference properties */
 static write_property_function Write_Property_Internal_Callback;
 static read_property_function Read_Property_Internal_Callback;
+static loop_read_real_bind_function Read_Real_Bind_Callback;
+#if defined(BACNET_LOOP_FIXED_POINT)
+/* Q16.16 fixed-point numbers for the PID algorithm on FPU-less ports */
+typedef int32_t loop_fixed_t;
+#define LOOP_FIXED_ONE 65536L
+#endif
 /* Write Property notification callbacks for logging or other purposes */
 static struct loop_write_property_notification Write_Property_Notification_Head;
 
 struct object_data {
     /* internal variables for PID calculations */
     uint32_t Update_Timer;
+#if defined(BACNET_LOOP_FIXED_POINT)
+    loop_fixed_t Integral_Sum;
+    loop_fixed_t Error;
+#else
     float Integral_Sum;
     float Error;
+#endif
+    /* variable references bound to their read functions */
+    loop_read_real_function Controlled_Variable_Read;
+    loop_read_real_function Setpoint_Read;
     /* variables for object properties */
     uint32_t Update_Interval;
     float Present_Value;
@@ -80,6 +94,7 @@ struct object_data {
     BACNET_RELIABILITY Reliability;
     bool Out_Of_Service : 1;
     bool Changed : 1;
+    bool References_Bound : 1;
     void *Context;
 };
 
@@ -777,6 +792,7 @@ bool Loop_Controlled_Variable_Reference_Set(
     if (pObject) {
         status = bacnet_object_property_reference_copy(
             &pObject->Controlled_Variable_Reference, value);
+        pObject->References_Bound = false;
     }
 
     return status;
@@ -910,6 +926,7 @@ bool Loop_Setpoint_Reference_Set(
     if (pObject) {
         status = bacnet_object_property_reference_copy(
             &pObject->Setpoint_Reference, value);
+        pObject->References_Bound = false;
     }
 
     return status;
@@ -1976,21 +1993,145 @@ void Loop_Read_Property_Internal_Callback_Set(read_property_function cb)
     Read_Property_Internal_Callback = cb;
 }
 
+/**
+ * @brief Sets a callback used to bind the loop variable references to
+ *  functions which read their REAL values directly
+ * @param cb - callback used to find the read function of a reference
+ */
+void Loop_Read_Real_Bind_Callback_Set(loop_read_real_bind_function cb)
+{
+    struct object_data *pObject;
+    int index = 0;
+
+    Read_Real_Bind_Callback = cb;
+    /* bind the references again when the loops next run */
+    while ((pObject = Keylist_Data_Index(Object_List, index)) != NULL) {
+        pObject->References_Bound = false;
+        index++;
+    }
+}
+
+/**
+ * @brief Reads the Present_Value of a Loop object
+ * @param object_instance - object-instance number of the object
+ * @param value - [out] the property value
+ * @return true if the object exists
+ */
+bool Loop_Present_Value_Real(uint32_t object_instance, float *value)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject && value) {
+        *value = pObject->Present_Value;
+    }
+
+    return pObject != NULL;
+}
+
+/**
+ * @brief Reads the Controlled_Variable_Value of a Loop object
+ * @param object_instance - object-instance number of the object
+ * @param value - [out] the property value
+ * @return true if the object exists
+ */
+static bool
+Loop_Controlled_Variable_Value_Read(uint32_t object_instance, float *value)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        *value = pObject->Controlled_Variable_Value;
+    }
+
+    return pObject != NULL;
+}
+
+/**
+ * @brief Reads the Setpoint of a Loop object
+ * @param object_instance - object-instance number of the object
+ * @param value - [out] the property value
+ * @return true if the object exists
+ */
+static bool Loop_Setpoint_Read(uint32_t object_instance, float *value)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        *value = pObject->Setpoint;
+    }
+
+    return pObject != NULL;
+}
+
+/**
+ * @brief Finds the function which reads the REAL value of a reference
+ * @param reference - BACnet Object Property reference
+ * @return the read function, or NULL to use ReadProperty
+ */
+static loop_read_real_function
+Loop_Read_Real_Bind(const BACNET_OBJECT_PROPERTY_REFERENCE *reference)
+{
+    if (Object_Property_Reference_Empty(reference)) {
+        return NULL;
+    }
+    if ((reference->object_identifier.type == OBJECT_LOOP) &&
+        (reference->property_array_index == BACNET_ARRAY_ALL)) {
+        switch (reference->property_identifier) {
+            case PROP_PRESENT_VALUE:
+                return Loop_Present_Value_Real;
+            case PROP_CONTROLLED_VARIABLE_VALUE:
+                return Loop_Controlled_Variable_Value_Read;
+            case PROP_SETPOINT:
+                return Loop_Setpoint_Read;
+            default:
+                break;
+        }
+    }
+    if (Read_Real_Bind_Callback) {
+        return Read_Real_Bind_Callback(
+            reference->object_identifier.type, reference->property_identifier,
+            reference->property_array_index);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Binds the variable references of a loop to their read functions
+ * @param pObject - object instance data
+ */
+static void Loop_References_Bind(struct object_data *pObject)
+{
+    pObject->Controlled_Variable_Read =
+        Loop_Read_Real_Bind(&pObject->Controlled_Variable_Reference);
+    pObject->Setpoint_Read = Loop_Read_Real_Bind(&pObject->Setpoint_Reference);
+    pObject->References_Bound = true;
+}
+
 /**
  * @brief For a given object, reads a BACnet Object Property reference
- * @param value - application value
- * @param priority - BACnet priority 0=none,1..16
- * @return  true if values are within range and value is written.
+ * @param reference - BACnet Object Property reference
+ * @param read_function - function bound to the reference, or NULL
+ *  to read the reference with ReadProperty
+ * @param value - [out] application value
+ * @return  true if the value was read
  */
 static bool Loop_Read_Variable_Reference_Update(
-    const BACNET_OBJECT_PROPERTY_REFERENCE *reference, float *value)
+    const BACNET_OBJECT_PROPERTY_REFERENCE *reference,
+    loop_read_real_function read_function,
+    float *value)
 {
     BACNET_READ_PROPERTY_DATA data = { 0 };
     uint8_t apdu[32] = { 0 };
     int apdu_len = 0, len = 0;
     bool status = false;
 
-    if (!Object_Property_Reference_Empty(reference)) {
+    if (read_function) {
+        status = read_function(reference->object_identifier.instance, value);
+    } else if (!Object_Property_Reference_Empty(reference)) {
         data.object_type = reference->object_identifier.type;
         data.object_instance = reference->object_identifier.instance;
         data.object_property = reference->property_identifier;
@@ -2116,6 +2257,137 @@ static bool Loop_Write_Manipulated_Variable(
     return status;
 }
 
+#if defined(BACNET_LOOP_FIXED_POINT)
+/**
+ * @brief Limits a 64-bit intermediate result to the fixed-point range
+ * @param value - intermediate result in Q16.16
+ * @return the fixed-point value
+ */
+static loop_fixed_t Loop_Fixed_Saturate(int64_t value)
+{
+    if (value > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (value < INT32_MIN) {
+        return INT32_MIN;
+    }
+
+    return (loop_fixed_t)value;
+}
+
+/**
+ * @brief Converts a REAL property value to fixed-point
+ * @param value - REAL value
+ * @return the fixed-point value, limited to the fixed-point range
+ */
+static loop_fixed_t Loop_Fixed(float value)
+{
+    value *= (float)LOOP_FIXED_ONE;
+    if (isgreaterequal(value, (float)INT32_MAX)) {
+        return INT32_MAX;
+    }
+    if (islessequal(value, (float)INT32_MIN)) {
+        return INT32_MIN;
+    }
+
+    return (loop_fixed_t)value;
+}
+
+/**
+ * @brief Multiplies two fixed-point values
+ * @param a - fixed-point value
+ * @param b - fixed-point value
+ * @return the fixed-point product
+ */
+static loop_fixed_t Loop_Fixed_Multiply(loop_fixed_t a, loop_fixed_t b)
+{
+    return Loop_Fixed_Saturate(((int64_t)a * b) / LOOP_FIXED_ONE);
+}
+
+/**
+ * @brief Divides two fixed-point values
+ * @param a - fixed-point dividend
+ * @param b - fixed-point divisor, not zero
+ * @return the fixed-point quotient
+ */
+static loop_fixed_t Loop_Fixed_Divide(loop_fixed_t a, loop_fixed_t b)
+{
+    return Loop_Fixed_Saturate(((int64_t)a * LOOP_FIXED_ONE) / b);
+}
+
+/**
+ * @brief PID algorithm using Q16.16 fixed-point arithmetic, for ports
+ *  without a floating point unit.  The REAL properties are converted
+ *  on entry, limiting them to +/-32767.
+ * @param pObject - object instance data
+ * @param elapsed_milliseconds - number of milliseconds elapsed
+ * @return computed PID output value
+ */
+static float
+Loop_PID_Algorithm(struct object_data *pObject, uint32_t elapsed_milliseconds)
+{
+    loop_fixed_t output, error, elapsed_seconds;
+    loop_fixed_t integral_constant, integral_min, integral_max;
+    loop_fixed_t maximum_output, minimum_output;
+    loop_fixed_t proportional, integral, derivative;
+
+    if (elapsed_milliseconds == 0) {
+        return pObject->Bias;
+    }
+    error = Loop_Fixed_Saturate(
+        (int64_t)Loop_Fixed(pObject->Setpoint) -
+        Loop_Fixed(pObject->Controlled_Variable_Value));
+    if (pObject->Action == ACTION_REVERSE) {
+        /* In reverse action, an increase in the process variable
+           above the setpoint requires a decrease in the controller output
+           to bring the process variable back to the setpoint. */
+        error = Loop_Fixed_Saturate(-(int64_t)error);
+    }
+    proportional =
+        Loop_Fixed_Multiply(Loop_Fixed(pObject->Proportional_Constant), error);
+    elapsed_seconds = Loop_Fixed_Saturate(
+        ((int64_t)elapsed_milliseconds * LOOP_FIXED_ONE) / 1000);
+    if (elapsed_seconds == 0) {
+        elapsed_seconds = 1;
+    }
+    pObject->Integral_Sum = Loop_Fixed_Saturate(
+        (int64_t)pObject->Integral_Sum +
+        Loop_Fixed_Multiply(error, elapsed_seconds));
+    integral_constant = Loop_Fixed(pObject->Integral_Constant);
+    maximum_output = Loop_Fixed(pObject->Maximum_Output);
+    minimum_output = Loop_Fixed(pObject->Minimum_Output);
+    if (integral_constant != 0) {
+        /* clamp integral sum to prevent windup */
+        integral_max = Loop_Fixed_Divide(maximum_output, integral_constant);
+        if (pObject->Integral_Sum > integral_max) {
+            pObject->Integral_Sum = integral_max;
+        }
+        integral_min = Loop_Fixed_Divide(minimum_output, integral_constant);
+        if (pObject->Integral_Sum < integral_min) {
+            pObject->Integral_Sum = integral_min;
+        }
+    }
+    integral = Loop_Fixed_Multiply(integral_constant, pObject->Integral_Sum);
+    derivative = Loop_Fixed_Multiply(
+        Loop_Fixed(pObject->Derivative_Constant),
+        Loop_Fixed_Divide(
+            Loop_Fixed_Saturate((int64_t)error - pObject->Error),
+            elapsed_seconds));
+    pObject->Error = error;
+    output = Loop_Fixed_Saturate(
+        (int64_t)proportional + integral + derivative +
+        Loop_Fixed(pObject->Bias));
+    /* clamp the output within limits */
+    if (output > maximum_output) {
+        output = maximum_output;
+    }
+    if (output < minimum_output) {
+        output = minimum_output;
+    }
+
+    return (float)output / (float)LOOP_FIXED_ONE;
+}
+#else
 /**
  * @brief PID algorithm
  * @param pObject - object instance data
@@ -2170,6 +2442,7 @@ Loop_PID_Algorithm(struct object_data *pObject, uint32_t elapsed_milliseconds)
 
     return output;
 }
+#endif
 
 /**
  * @brief Updates the object loop operation
@@ -2183,11 +2456,16 @@ void Loop_Timer(uint32_t object_instance, uint16_t elapsed_milliseconds)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         /* update any variable references */
+        if (!pObject->References_Bound) {
+            Loop_References_Bind(pObject);
+        }
         Loop_Read_Variable_Reference_Update(
             &pObject->Controlled_Variable_Reference,
+            pObject->Controlled_Variable_Read,
             &pObject->Controlled_Variable_Value);
         Loop_Read_Variable_Reference_Update(
-            &pObject->Setpoint_Reference, &pObject->Setpoint);
+            &pObject->Setpoint_Reference, pObject->Setpoint_Read,
+            &pObject->Setpoint);
         /* loop algorithm updates the present-value */
         if (!pObject->Out_Of_Service) {
             /* When Out_Of_Service is TRUE:
@@ -33,6 +33,28 @@ struct loop_write_property_notification {
     loop_write_property_callback callback;
 };
 
+/**
+ * @brief Reads a REAL property value of an object directly, instead of
+ *  encoding and decoding it with ReadProperty
+ * @param  object_instance - object instance number
+ * @param  value - [out] the property value
+ * @return true if the object exists and the value was read
+ */
+typedef bool (*loop_read_real_function)(uint32_t object_instance, float *value);
+
+/**
+ * @brief Finds the function that reads a REAL property of an object type,
+ *  bound once to a Loop variable reference when the reference is set
+ * @param  object_type - object type of the reference
+ * @param  object_property - property of the reference
+ * @param  array_index - array index of the reference
+ * @return the read function, or NULL to use ReadProperty for the reference
+ */
+typedef loop_read_real_function (*loop_read_real_bind_function)(
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -84,6 +106,8 @@ bool Loop_Reliability_Set(uint32_t object_instance, BACNET_RELIABILITY value);
 BACNET_STACK_EXPORT
 float Loop_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Loop_Present_Value_Real(uint32_t object_instance, float *value);
+BACNET_STACK_EXPORT
 bool Loop_Present_Value_Set(uint32_t object_instance, float value);
 
 BACNET_STACK_EXPORT
@@ -204,6 +228,8 @@ void Loop_Write_Property_Internal_Callback_Set(write_property_function cb);
 BACNET_STACK_EXPORT
 void Loop_Read_Property_Internal_Callback_Set(read_property_function cb);
 BACNET_STACK_EXPORT
+void Loop_Read_Real_Bind_Callback_Set(loop_read_real_bind_function cb);
+BACNET_STACK_EXPORT
 void Loop_Write_Property_Notification_Add(
     struct loop_write_property_notification *notification);
 BACNET_STACK_EXPORT
@@ -44,6 +44,9 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #endif
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_LIFE_SAFETY_POINT;
+/* callback for present value changes */
+static life_safety_point_present_value_callback
+    Life_Safety_Point_Present_Value_Callback;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Life_Safety_Point_Properties_Required[] = {
@@ -199,16 +202,33 @@ bool Life_Safety_Point_Present_Value_Set(
 {
     bool status = false;
     struct object_data *pObject;
+    BACNET_LIFE_SAFETY_STATE old_value;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
+        old_value = pObject->Present_Value;
         pObject->Present_Value = value;
+        if ((old_value != value) && Life_Safety_Point_Present_Value_Callback) {
+            Life_Safety_Point_Present_Value_Callback(
+                object_instance, old_value, value);
+        }
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Sets a callback used when the present-value changes, either
+ *  from a BACnet WriteProperty or from the local application
+ * @param cb - callback used to provide indications
+ */
+void Life_Safety_Point_Present_Value_Callback_Set(
+    life_safety_point_present_value_callback cb)
+{
+    Life_Safety_Point_Present_Value_Callback = cb;
+}
+
 /**
  * For a given object instance-number, loads the object-name into
  * a characterstring. Note that the object name must be unique
@@ -794,6 +814,13 @@ bool Life_Safety_Point_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
+        if ((pObject->Present_Value != LIFE_SAFETY_STATE_QUIET) &&
+            Life_Safety_Point_Present_Value_Callback) {
+            /* a deleted point no longer contributes to any state */
+            Life_Safety_Point_Present_Value_Callback(
+                object_instance, pObject->Present_Value,
+                LIFE_SAFETY_STATE_QUIET);
+        }
         free(pObject);
         status = true;
     }
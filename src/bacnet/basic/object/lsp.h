@@ -16,6 +16,17 @@
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 
+/**
+ * @brief Callback for a change of the present-value
+ * @param  object_instance - object-instance number of the object
+ * @param  old_value - life safety state prior to the change
+ * @param  value - life safety state after the change
+ */
+typedef void (*life_safety_point_present_value_callback)(
+    uint32_t object_instance,
+    BACNET_LIFE_SAFETY_STATE old_value,
+    BACNET_LIFE_SAFETY_STATE value);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -52,6 +63,9 @@ Life_Safety_Point_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
 bool Life_Safety_Point_Present_Value_Set(
     uint32_t object_instance, BACNET_LIFE_SAFETY_STATE present_value);
+BACNET_STACK_EXPORT
+void Life_Safety_Point_Present_Value_Callback_Set(
+    life_safety_point_present_value_callback cb);
 
 BACNET_STACK_EXPORT
 BACNET_SILENCED_STATE Life_Safety_Point_Silenced(uint32_t object_instance);
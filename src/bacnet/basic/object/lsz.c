@@ -28,6 +28,7 @@
 #include "bacnet/proplist.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/lsp.h"
 /* me! */
 #include "bacnet/basic/object/lsz.h"
 
@@ -42,8 +43,18 @@ struct object_data {
     uint8_t Reliability;
     const char *Object_Name;
     OS_Keylist Zone_Members;
+    /* number of local Life Safety Point members in each state category */
+    unsigned Alarm_Count;
+    unsigned Trouble_Count;
+    unsigned Supervisory_Count;
     void *Context;
 };
+/* reverse membership: a zone that lists a Life Safety Point member */
+struct zone_membership {
+    struct object_data *pZone;
+    /* number of times the point is listed in the Zone_Members */
+    unsigned Count;
+};
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #ifdef BAC_ROUTING
@@ -51,6 +62,15 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* Key List of the parent zones of each local Life Safety Point member,
+   sorted by the point instance number; each entry is a Key List of
+   struct zone_membership sorted by the zone instance number */
+static OS_Keylist Member_Index_Lists[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Member_Index (Member_Index_Lists[Routed_Device_Object_Index()])
+#else
+#define Member_Index (Member_Index_Lists[0])
+#endif
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_LIFE_SAFETY_ZONE;
 
@@ -419,6 +439,273 @@ bool Life_Safety_Zone_Operation_Expected_Set(
     return status;
 }
 
+/**
+ * @brief Determine the member state counter of a zone for a given state
+ * @param pObject - object instance data
+ * @param state - life safety state of a member
+ * @return pointer to the alarm, trouble, or supervisory counter,
+ *  or NULL if the state does not count toward the zone state
+ */
+static unsigned *Life_Safety_Zone_State_Counter(
+    struct object_data *pObject, BACNET_LIFE_SAFETY_STATE state)
+{
+    switch (state) {
+        case LIFE_SAFETY_STATE_ALARM:
+        case LIFE_SAFETY_STATE_FAULT_ALARM:
+        case LIFE_SAFETY_STATE_HOLDUP:
+        case LIFE_SAFETY_STATE_DURESS:
+        case LIFE_SAFETY_STATE_TAMPER_ALARM:
+        case LIFE_SAFETY_STATE_LOCAL_ALARM:
+        case LIFE_SAFETY_STATE_GENERAL_ALARM:
+        case LIFE_SAFETY_STATE_OEO_ALARM:
+            return &pObject->Alarm_Count;
+        case LIFE_SAFETY_STATE_FAULT:
+        case LIFE_SAFETY_STATE_FAULT_PRE_ALARM:
+        case LIFE_SAFETY_STATE_NOT_READY:
+        case LIFE_SAFETY_STATE_TAMPER:
+        case LIFE_SAFETY_STATE_ABNORMAL:
+        case LIFE_SAFETY_STATE_BLOCKED:
+        case LIFE_SAFETY_STATE_OEO_UNAVAILABLE:
+            return &pObject->Trouble_Count;
+        case LIFE_SAFETY_STATE_SUPERVISORY:
+            return &pObject->Supervisory_Count;
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Derive the zone present-value from the member state counters.
+ *  Alarm has precedence over supervisory, which has precedence over
+ *  trouble. An out-of-service zone keeps its present-value.
+ * @param pObject - object instance data
+ */
+static void Life_Safety_Zone_Present_Value_Aggregate(
+    struct object_data *pObject)
+{
+    if (pObject->Out_Of_Service) {
+        return;
+    }
+    if (pObject->Alarm_Count > 0) {
+        pObject->Present_Value = LIFE_SAFETY_STATE_ALARM;
+    } else if (pObject->Supervisory_Count > 0) {
+        pObject->Present_Value = LIFE_SAFETY_STATE_SUPERVISORY;
+    } else if (pObject->Trouble_Count > 0) {
+        pObject->Present_Value = LIFE_SAFETY_STATE_FAULT;
+    } else {
+        pObject->Present_Value = LIFE_SAFETY_STATE_QUIET;
+    }
+}
+
+/**
+ * @brief Determine if a zone member refers to a Life Safety Point
+ *  object in this device
+ * @param data - the device object property reference of the member
+ * @return true if the member is a local Life Safety Point
+ */
+static bool Life_Safety_Zone_Member_Local_Point(
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *data)
+{
+    if (data->objectIdentifier.type != OBJECT_LIFE_SAFETY_POINT) {
+        return false;
+    }
+    if ((data->deviceIdentifier.type == OBJECT_DEVICE) &&
+        (data->deviceIdentifier.instance !=
+         Device_Object_Instance_Number())) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Add a zone to the reverse membership index of a local
+ *  Life Safety Point, and count the present state of the point
+ * @param pObject - zone object instance data
+ * @param object_instance - zone object-instance number
+ * @param member_instance - Life Safety Point object-instance number
+ * @return true if the zone was added to the index
+ */
+static bool Life_Safety_Zone_Member_Index_Add(
+    struct object_data *pObject,
+    uint32_t object_instance,
+    uint32_t member_instance)
+{
+    OS_Keylist zones;
+    struct zone_membership *membership;
+    unsigned *counter;
+
+    if (!Member_Index) {
+        Member_Index = Keylist_Create();
+        if (!Member_Index) {
+            return false;
+        }
+    }
+    zones = Keylist_Data(Member_Index, member_instance);
+    if (!zones) {
+        zones = Keylist_Create();
+        if (!zones) {
+            return false;
+        }
+        if (Keylist_Data_Add(Member_Index, member_instance, zones) < 0) {
+            Keylist_Delete(zones);
+            return false;
+        }
+    }
+    membership = Keylist_Data(zones, object_instance);
+    if (!membership) {
+        membership = calloc(1, sizeof(struct zone_membership));
+        if (!membership) {
+            return false;
+        }
+        membership->pZone = pObject;
+        if (Keylist_Data_Add(zones, object_instance, membership) < 0) {
+            free(membership);
+            return false;
+        }
+    }
+    membership->Count++;
+    counter = Life_Safety_Zone_State_Counter(
+        pObject, Life_Safety_Point_Present_Value(member_instance));
+    if (counter) {
+        (*counter)++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove a zone from the reverse membership index of a local
+ *  Life Safety Point
+ * @param object_instance - zone object-instance number
+ * @param member_instance - Life Safety Point object-instance number
+ */
+static void Life_Safety_Zone_Member_Index_Remove(
+    uint32_t object_instance, uint32_t member_instance)
+{
+    OS_Keylist zones;
+    struct zone_membership *membership;
+
+    zones = Keylist_Data(Member_Index, member_instance);
+    if (!zones) {
+        return;
+    }
+    membership = Keylist_Data_Delete(zones, object_instance);
+    free(membership);
+    if (Keylist_Count(zones) == 0) {
+        Keylist_Data_Delete(Member_Index, member_instance);
+        Keylist_Delete(zones);
+    }
+}
+
+/**
+ * @brief Remove all the members of a zone from the reverse membership
+ *  index, and free the Zone Members list entries
+ * @param pObject - zone object instance data
+ * @param object_instance - zone object-instance number
+ */
+static void Life_Safety_Zone_Members_Free(
+    struct object_data *pObject, uint32_t object_instance)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *data;
+
+    do {
+        data = Keylist_Data_Pop(pObject->Zone_Members);
+        if (data) {
+            if (Life_Safety_Zone_Member_Local_Point(data)) {
+                Life_Safety_Zone_Member_Index_Remove(
+                    object_instance, data->objectIdentifier.instance);
+            }
+            free(data);
+        }
+    } while (data);
+    pObject->Alarm_Count = 0;
+    pObject->Trouble_Count = 0;
+    pObject->Supervisory_Count = 0;
+}
+
+/**
+ * @brief Propagate a change of a Life Safety Point present-value to each
+ *  zone that lists the point as a member. The work is proportional to
+ *  the number of parent zones of the point, and is independent of the
+ *  number of members in each zone.
+ * @note Used as the Life Safety Point present-value callback, which is
+ *  installed by Life_Safety_Zone_Init(). An application that installs
+ *  its own callback shall call this function from it.
+ * @param member_instance - Life Safety Point object-instance number
+ * @param old_value - life safety state prior to the change
+ * @param value - life safety state after the change
+ */
+void Life_Safety_Zone_Member_Present_Value_Update(
+    uint32_t member_instance,
+    BACNET_LIFE_SAFETY_STATE old_value,
+    BACNET_LIFE_SAFETY_STATE value)
+{
+    OS_Keylist zones;
+    struct zone_membership *membership;
+    unsigned *counter;
+    int index, count;
+
+    zones = Keylist_Data(Member_Index, member_instance);
+    count = Keylist_Count(zones);
+    for (index = 0; index < count; index++) {
+        membership = Keylist_Data_Index(zones, index);
+        if (!membership) {
+            continue;
+        }
+        counter = Life_Safety_Zone_State_Counter(membership->pZone, old_value);
+        if (counter) {
+            if (*counter >= membership->Count) {
+                *counter -= membership->Count;
+            } else {
+                *counter = 0;
+            }
+        }
+        counter = Life_Safety_Zone_State_Counter(membership->pZone, value);
+        if (counter) {
+            *counter += membership->Count;
+        }
+        Life_Safety_Zone_Present_Value_Aggregate(membership->pZone);
+    }
+}
+
+/**
+ * @brief Get the number of local Life Safety Point members of a zone
+ *  in each of the alarm, trouble, and supervisory state categories
+ * @param object_instance - object-instance number of the object
+ * @param alarm_count - number of members in an alarm state, or NULL
+ * @param trouble_count - number of members in a trouble state, or NULL
+ * @param supervisory_count - number of members in a supervisory state,
+ *  or NULL
+ * @return true if the object-instance exists
+ */
+bool Life_Safety_Zone_Member_State_Count(
+    uint32_t object_instance,
+    unsigned *alarm_count,
+    unsigned *trouble_count,
+    unsigned *supervisory_count)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return false;
+    }
+    if (alarm_count) {
+        *alarm_count = pObject->Alarm_Count;
+    }
+    if (trouble_count) {
+        *trouble_count = pObject->Trouble_Count;
+    }
+    if (supervisory_count) {
+        *supervisory_count = pObject->Supervisory_Count;
+    }
+
+    return true;
+}
+
 /**
  * @brief For a given object instance-number, returns the out-of-service
  *  status flag
@@ -452,6 +739,9 @@ void Life_Safety_Zone_Out_Of_Service_Set(uint32_t object_instance, bool value)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Out_Of_Service = value;
+        if (!value && (Keylist_Count(pObject->Zone_Members) > 0)) {
+            Life_Safety_Zone_Present_Value_Aggregate(pObject);
+        }
     }
 }
 
@@ -550,9 +840,9 @@ bool Life_Safety_Zone_Members_Add(
     uint32_t object_instance,
     const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *data)
 {
-    bool status = false;
     BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *entry;
     struct object_data *pObject;
+    int index;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
@@ -563,10 +853,20 @@ bool Life_Safety_Zone_Members_Add(
         return false;
     }
     memcpy(entry, data, sizeof(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE));
-    status = Keylist_Data_Add(
+    index = Keylist_Data_Add(
         pObject->Zone_Members, Keylist_Count(pObject->Zone_Members), entry);
+    if (index < 0) {
+        free(entry);
+        return false;
+    }
+    if (Life_Safety_Zone_Member_Local_Point(entry)) {
+        if (Life_Safety_Zone_Member_Index_Add(
+                pObject, object_instance, entry->objectIdentifier.instance)) {
+            Life_Safety_Zone_Present_Value_Aggregate(pObject);
+        }
+    }
 
-    return status;
+    return true;
 }
 
 /**
@@ -579,7 +879,7 @@ void Life_Safety_Zone_Members_Clear(uint32_t object_instance)
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        Keylist_Data_Free(pObject->Zone_Members);
+        Life_Safety_Zone_Members_Free(pObject, object_instance);
     }
 }
 
@@ -977,7 +1277,7 @@ bool Life_Safety_Zone_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        Keylist_Data_Free(pObject->Zone_Members);
+        Life_Safety_Zone_Members_Free(pObject, object_instance);
         Keylist_Delete(pObject->Zone_Members);
         free(pObject);
         status = true;
@@ -992,6 +1292,7 @@ bool Life_Safety_Zone_Delete(uint32_t object_instance)
 void Life_Safety_Zone_Cleanup(void)
 {
     struct object_data *pObject;
+    OS_Keylist zones;
     uint16_t dev_id;
 #ifdef BAC_ROUTING
     uint16_t current_dev_id = Routed_Device_Object_Index();
@@ -1005,12 +1306,25 @@ void Life_Safety_Zone_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
+                    Keylist_Data_Free(pObject->Zone_Members);
+                    Keylist_Delete(pObject->Zone_Members);
                     free(pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
             Object_List = NULL;
         }
+        if (Member_Index) {
+            do {
+                zones = Keylist_Data_Pop(Member_Index);
+                if (zones) {
+                    Keylist_Data_Free(zones);
+                    Keylist_Delete(zones);
+                }
+            } while (zones);
+            Keylist_Delete(Member_Index);
+            Member_Index = NULL;
+        }
     }
 
 #ifdef BAC_ROUTING
@@ -1035,7 +1349,12 @@ void Life_Safety_Zone_Init(void)
         if (!Object_List) {
             Object_List = Keylist_Create();
         }
+        if (!Member_Index) {
+            Member_Index = Keylist_Create();
+        }
     }
+    Life_Safety_Point_Present_Value_Callback_Set(
+        Life_Safety_Zone_Member_Present_Value_Update);
 
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
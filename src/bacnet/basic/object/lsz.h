@@ -87,6 +87,17 @@ bool Life_Safety_Zone_Members_Add(
     const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *data);
 BACNET_STACK_EXPORT
 void Life_Safety_Zone_Members_Clear(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Life_Safety_Zone_Member_Present_Value_Update(
+    uint32_t member_instance,
+    BACNET_LIFE_SAFETY_STATE old_value,
+    BACNET_LIFE_SAFETY_STATE value);
+BACNET_STACK_EXPORT
+bool Life_Safety_Zone_Member_State_Count(
+    uint32_t object_instance,
+    unsigned *alarm_count,
+    unsigned *trouble_count,
+    unsigned *supervisory_count);
 
 BACNET_STACK_EXPORT
 bool Life_Safety_Zone_Maintenance_Required(uint32_t object_instance);
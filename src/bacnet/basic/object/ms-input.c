@@ -16,9 +16,11 @@
 /* BACnet Stack API */
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/slab.h"
 #include "bacnet/basic/services.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
@@ -44,6 +46,10 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* memory pool for the object data */
+static SLAB_TYPE Object_Slab = SLAB_ACCOUNT_INITIALIZER(
+    sizeof(struct object_data),
+    MEMSTAT_ACCOUNT_OBJECT(OBJECT_MULTI_STATE_INPUT));
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_MULTI_STATE_INPUT;
 /* callback for present value writes */
@@ -350,17 +356,38 @@ uint32_t Multistate_Input_Present_Value(uint32_t object_instance)
     return value;
 }
 
+/**
+ * @brief For a given object instance-number, reads the present-value
+ *  without encoding it, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  value - [out] the present-value
+ * @return  true if the object instance exists
+ */
+bool Multistate_Input_Present_Value_Unsigned(
+    uint32_t object_instance, BACNET_UNSIGNED_INTEGER *value)
+{
+    if (!Multistate_Input_Valid_Instance(object_instance)) {
+        return false;
+    }
+    if (value) {
+        *value = Multistate_Input_Present_Value(object_instance);
+    }
+
+    return true;
+}
+
 /**
  * @brief For a given object instance-number, checks the present-value for COV
  * @param  pObject - specific object with valid data
  * @param  value - multistate value
  */
 static void Multistate_Input_Present_Value_COV_Detect(
-    struct object_data *pObject, uint32_t value)
+    uint32_t object_instance, struct object_data *pObject, uint32_t value)
 {
     if (pObject) {
         if (pObject->Present_Value != value) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
     }
 }
@@ -382,7 +409,8 @@ bool Multistate_Input_Present_Value_Set(
     if (pObject) {
         max_states = state_name_count(pObject->State_Text);
         if ((value >= 1) && (value <= max_states)) {
-            Multistate_Input_Present_Value_COV_Detect(pObject, value);
+            Multistate_Input_Present_Value_COV_Detect(
+                object_instance, pObject, value);
             pObject->Present_Value = value;
             status = true;
         }
@@ -418,7 +446,8 @@ static bool Multistate_Input_Present_Value_Write(
         if ((value >= 1) && (value <= max_states)) {
             if (pObject->Write_Enabled) {
                 old_value = pObject->Present_Value;
-                Multistate_Input_Present_Value_COV_Detect(pObject, value);
+                Multistate_Input_Present_Value_COV_Detect(
+                    object_instance, pObject, value);
                 pObject->Present_Value = value;
                 if (pObject->Out_Of_Service) {
                     /* The physical point that the object represents
@@ -479,6 +508,7 @@ void Multistate_Input_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
         pObject->Out_Of_Service = value;
     }
@@ -648,6 +678,7 @@ bool Multistate_Input_Reliability_Set(
         pObject->Reliability = value;
         if (fault != Multistate_Input_Object_Fault(pObject)) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
         status = true;
     }
@@ -766,6 +797,32 @@ bool Multistate_Input_Encode_Value_List(
     return status;
 }
 
+/**
+ * @brief For a given object instance-number, reads the status-flags
+ *  without encoding them, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  status_flags - [out] the status-flags
+ * @return  true if the object instance exists
+ */
+bool Multistate_Input_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags)
+{
+    bool status = false;
+    struct object_data *pObject;
+    const bool in_alarm = false;
+    bool fault = false;
+    const bool overridden = false;
+
+    pObject = Multistate_Input_Object(object_instance);
+    if (pObject) {
+        fault = Multistate_Input_Object_Fault(pObject);
+        cov_status_flags_set(
+            status_flags, in_alarm, fault, overridden, pObject->Out_Of_Service);
+        status = true;
+    }
+    return status;
+}
+
 /**
  * @brief ReadProperty handler for this object.  For the given ReadProperty
  *  data, the application_data is loaded or the error flags are set.
@@ -780,6 +837,7 @@ int Multistate_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_size = 0;
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
+    BACNET_CHARACTER_STRING_VIEW char_view;
     uint32_t present_value = 0;
     uint32_t max_states = 0;
     bool state = false;
@@ -797,9 +855,19 @@ int Multistate_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 &apdu[0], Object_Type, rpdata->object_instance);
             break;
         case PROP_OBJECT_NAME:
-            Multistate_Input_Object_Name(rpdata->object_instance, &char_string);
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            /* a name that is kept by the object is encoded in place */
+            if (characterstring_view_init_ansi(
+                    &char_view,
+                    Multistate_Input_Name_ASCII(rpdata->object_instance)) &&
+                (char_view.length > 0)) {
+                apdu_len = encode_application_character_string_view(
+                    &apdu[0], &char_view);
+            } else {
+                Multistate_Input_Object_Name(
+                    rpdata->object_instance, &char_string);
+                apdu_len =
+                    encode_application_character_string(&apdu[0], &char_string);
+            }
             break;
         case PROP_OBJECT_TYPE:
             apdu_len = encode_application_enumerated(&apdu[0], Object_Type);
@@ -1041,7 +1109,7 @@ uint32_t Multistate_Input_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Slab_Item_Alloc(&Object_Slab);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->State_Text = Default_State_Text;
@@ -1053,7 +1121,7 @@ uint32_t Multistate_Input_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Slab_Free(&Object_Slab, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1076,13 +1144,25 @@ bool Multistate_Input_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Slab_Free(&Object_Slab, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Reserves pool memory for Multistate Input objects, see Slab_Reserve()
+ * @param count - number of objects to reserve memory for
+ * @return true if the memory was reserved
+ */
+bool Multistate_Input_Pool_Reserve(uint32_t count)
+{
+    Slab_Retain_Set(&Object_Slab, true);
+
+    return Slab_Reserve(&Object_Slab, count);
+}
+
 /**
  * @brief Cleans up the object list and its data
  */
@@ -1102,7 +1182,7 @@ void Multistate_Input_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
-                    free(pObject);
+                    Slab_Free(&Object_Slab, pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
@@ -1110,6 +1190,7 @@ void Multistate_Input_Cleanup(void)
         }
     }
 
+    Slab_Cleanup(&Object_Slab);
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
 #endif
@@ -69,6 +69,9 @@ const char *Multistate_Input_Name_ASCII(uint32_t object_instance);
 BACNET_STACK_EXPORT
 uint32_t Multistate_Input_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Multistate_Input_Present_Value_Unsigned(
+    uint32_t object_instance, BACNET_UNSIGNED_INTEGER *value);
+BACNET_STACK_EXPORT
 bool Multistate_Input_Present_Value_Set(
     uint32_t object_instance, uint32_t value);
 BACNET_STACK_EXPORT
@@ -89,6 +92,9 @@ void Multistate_Input_Change_Of_Value_Clear(uint32_t instance);
 BACNET_STACK_EXPORT
 bool Multistate_Input_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
+BACNET_STACK_EXPORT
+bool Multistate_Input_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
 
 BACNET_STACK_EXPORT
 bool Multistate_Input_Out_Of_Service(uint32_t object_instance);
@@ -132,6 +138,8 @@ uint32_t Multistate_Input_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
 bool Multistate_Input_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Multistate_Input_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Multistate_Input_Cleanup(void);
 
 BACNET_STACK_EXPORT
@@ -28,6 +28,8 @@
 #include "bacnet/proplist.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/priority_array.h"
+#include "bacnet/basic/sys/slab.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
 /* me! */
@@ -36,7 +38,9 @@
 struct object_data {
     bool Out_Of_Service : 1;
     bool Changed : 1;
-    bool Relinquished[BACNET_MAX_PRIORITY];
+    /* the effective value of the priority array, kept when it changes */
+    uint8_t Present_Value;
+    PRIORITY_ARRAY_STATE Priority_State;
     uint8_t Priority_Array[BACNET_MAX_PRIORITY];
     uint8_t Relinquish_Default;
     uint8_t Reliability;
@@ -53,6 +57,10 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* memory pool for the object data */
+static SLAB_TYPE Object_Slab = SLAB_ACCOUNT_INITIALIZER(
+    sizeof(struct object_data),
+    MEMSTAT_ACCOUNT_OBJECT(OBJECT_MULTI_STATE_OUTPUT));
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_MULTI_STATE_OUTPUT;
 /* callback for present value writes */
@@ -261,28 +269,39 @@ uint32_t Multistate_Output_Max_States(uint32_t object_instance)
 }
 
 /**
- * @brief For a given object instance-number, determines the present-value
- * @param  object_instance - object-instance number of the object
+ * @brief Get the present-value, which is kept as the effective value
+ *  of the priority array
+ * @param  pObject - specific object with valid data
  * @return  present-value of the object
  */
 static uint32_t Object_Present_Value(const struct object_data *pObject)
 {
     uint32_t value = 1;
-    uint8_t priority = 0; /* loop counter */
 
     if (pObject) {
-        value = pObject->Relinquish_Default;
-        for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-            if (!pObject->Relinquished[priority]) {
-                value = pObject->Priority_Array[priority];
-                break;
-            }
-        }
+        value = pObject->Present_Value;
     }
 
     return value;
 }
 
+/**
+ * @brief Keep the effective value of the priority array as the
+ *  present-value, after a slot or the relinquish-default changed
+ * @param  pObject - specific object with valid data
+ */
+static void Object_Present_Value_Update(struct object_data *pObject)
+{
+    unsigned priority;
+
+    priority = priority_array_active_priority(&pObject->Priority_State);
+    if (priority) {
+        pObject->Present_Value = pObject->Priority_Array[priority - 1];
+    } else {
+        pObject->Present_Value = pObject->Relinquish_Default;
+    }
+}
+
 /**
  * @brief For a given object instance-number, determines the present-value
  * @param  object_instance - object-instance number of the object
@@ -299,6 +318,26 @@ uint32_t Multistate_Output_Present_Value(uint32_t object_instance)
     return value;
 }
 
+/**
+ * @brief For a given object instance-number, reads the present-value
+ *  without encoding it, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  value - [out] the present-value
+ * @return  true if the object instance exists
+ */
+bool Multistate_Output_Present_Value_Unsigned(
+    uint32_t object_instance, BACNET_UNSIGNED_INTEGER *value)
+{
+    if (!Multistate_Output_Valid_Instance(object_instance)) {
+        return false;
+    }
+    if (value) {
+        *value = Multistate_Output_Present_Value(object_instance);
+    }
+
+    return true;
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -318,7 +357,7 @@ static int Multistate_Output_Priority_Array_Encode(
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && (priority < BACNET_MAX_PRIORITY)) {
-        if (pObject->Relinquished[priority]) {
+        if (!priority_array_active(&pObject->Priority_State, priority + 1)) {
             apdu_len = encode_application_null(apdu);
         } else {
             value = pObject->Priority_Array[priority];
@@ -336,18 +375,12 @@ static int Multistate_Output_Priority_Array_Encode(
  */
 unsigned Multistate_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (!pObject->Relinquished[p]) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = priority_array_active_priority(&pObject->Priority_State);
     }
 
     return priority;
@@ -387,6 +420,7 @@ bool Multistate_Output_Relinquish_Default_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Relinquish_Default = value;
+        Object_Present_Value_Update(pObject);
         status = true;
     }
 
@@ -467,11 +501,13 @@ bool Multistate_Output_Present_Value_Set(
         if ((value >= 1) && (value <= max_states) && (priority >= 1) &&
             (priority <= BACNET_MAX_PRIORITY)) {
             old_value = Object_Present_Value(pObject);
-            pObject->Relinquished[priority - 1] = false;
+            priority_array_command(&pObject->Priority_State, priority);
             pObject->Priority_Array[priority - 1] = value;
+            Object_Present_Value_Update(pObject);
             new_value = Object_Present_Value(pObject);
             if (old_value != new_value) {
                 pObject->Changed = true;
+                cov_change_of_value_notify(Object_Type, object_instance);
             }
             status = true;
         }
@@ -495,7 +531,8 @@ bool Multistate_Output_Priority_Array_Relinquished(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
-            status = pObject->Relinquished[priority - 1];
+            status =
+                !priority_array_active(&pObject->Priority_State, priority);
         }
     }
 
@@ -544,11 +581,13 @@ bool Multistate_Output_Present_Value_Relinquish(
     if (pObject) {
         if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
             old_value = Object_Present_Value(pObject);
-            pObject->Relinquished[priority - 1] = true;
+            priority_array_relinquish(&pObject->Priority_State, priority);
             pObject->Priority_Array[priority - 1] = 0;
+            Object_Present_Value_Update(pObject);
             new_value = Object_Present_Value(pObject);
             if (old_value != new_value) {
                 pObject->Changed = true;
+                cov_change_of_value_notify(Object_Type, object_instance);
             }
             status = true;
         }
@@ -705,6 +744,7 @@ void Multistate_Output_Out_Of_Service_Set(uint32_t object_instance, bool value)
         if (pObject->Out_Of_Service != value) {
             pObject->Out_Of_Service = value;
             pObject->Changed = true;
+            cov_change_of_value_notify(Object_Type, object_instance);
         }
     }
 }
@@ -920,6 +960,7 @@ bool Multistate_Output_Reliability_Set(
             pObject->Reliability = value;
             if (fault != Multistate_Output_Object_Fault(pObject)) {
                 pObject->Changed = true;
+                cov_change_of_value_notify(Object_Type, object_instance);
             }
             status = true;
         }
@@ -1041,6 +1082,32 @@ bool Multistate_Output_Encode_Value_List(
     return status;
 }
 
+/**
+ * @brief For a given object instance-number, reads the status-flags
+ *  without encoding them, for the local reads of other objects
+ * @param  object_instance - object-instance number of the object
+ * @param  status_flags - [out] the status-flags
+ * @return  true if the object instance exists
+ */
+bool Multistate_Output_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags)
+{
+    bool status = false;
+    struct object_data *pObject;
+    const bool in_alarm = false;
+    bool fault = false;
+    const bool overridden = false;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        fault = Multistate_Output_Object_Fault(pObject);
+        cov_status_flags_set(
+            status_flags, in_alarm, fault, overridden, pObject->Out_Of_Service);
+        status = true;
+    }
+    return status;
+}
+
 /**
  * @brief ReadProperty handler for this object.  For the given ReadProperty
  *  data, the application_data is loaded or the error flags are set.
@@ -1055,6 +1122,7 @@ int Multistate_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_size = 0;
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
+    BACNET_CHARACTER_STRING_VIEW char_view;
     uint32_t present_value = 0;
     unsigned i = 0;
     uint32_t max_states = 0;
@@ -1080,10 +1148,19 @@ int Multistate_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 &apdu[0], Object_Type, rpdata->object_instance);
             break;
         case PROP_OBJECT_NAME:
-            Multistate_Output_Object_Name(
-                rpdata->object_instance, &char_string);
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            /* a name that is kept by the object is encoded in place */
+            if (characterstring_view_init_ansi(
+                    &char_view,
+                    Multistate_Output_Name_ASCII(rpdata->object_instance)) &&
+                (char_view.length > 0)) {
+                apdu_len = encode_application_character_string_view(
+                    &apdu[0], &char_view);
+            } else {
+                Multistate_Output_Object_Name(
+                    rpdata->object_instance, &char_string);
+                apdu_len =
+                    encode_application_character_string(&apdu[0], &char_string);
+            }
             break;
         case PROP_OBJECT_TYPE:
             apdu_len = encode_application_enumerated(&apdu[0], Object_Type);
@@ -1336,22 +1413,23 @@ uint32_t Multistate_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = Slab_Item_Alloc(&Object_Slab);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->State_Text = Default_State_Text;
             pObject->Out_Of_Service = false;
             pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
             pObject->Changed = false;
+            priority_array_init(&pObject->Priority_State);
             for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-                pObject->Relinquished[priority] = true;
                 pObject->Priority_Array[priority] = 0;
             }
             pObject->Relinquish_Default = 1;
+            pObject->Present_Value = 1;
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Slab_Free(&Object_Slab, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1374,13 +1452,25 @@ bool Multistate_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Slab_Free(&Object_Slab, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Reserves pool memory for Multistate Output objects, see Slab_Reserve()
+ * @param count - number of objects to reserve memory for
+ * @return true if the memory was reserved
+ */
+bool Multistate_Output_Pool_Reserve(uint32_t count)
+{
+    Slab_Retain_Set(&Object_Slab, true);
+
+    return Slab_Reserve(&Object_Slab, count);
+}
+
 /**
  * @brief Cleans up the object list and its data
  */
@@ -1400,7 +1490,7 @@ void Multistate_Output_Cleanup(void)
             do {
                 pObject = Keylist_Data_Pop(Object_List);
                 if (pObject) {
-                    free(pObject);
+                    Slab_Free(&Object_Slab, pObject);
                 }
             } while (pObject);
             Keylist_Delete(Object_List);
@@ -1408,6 +1498,7 @@ void Multistate_Output_Cleanup(void)
         }
     }
 
+    Slab_Cleanup(&Object_Slab);
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
 #endif
@@ -66,6 +66,9 @@ const char *Multistate_Output_Name_ASCII(uint32_t object_instance);
 BACNET_STACK_EXPORT
 uint32_t Multistate_Output_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Multistate_Output_Present_Value_Unsigned(
+    uint32_t object_instance, BACNET_UNSIGNED_INTEGER *value);
+BACNET_STACK_EXPORT
 bool Multistate_Output_Present_Value_Set(
     uint32_t object_instance, uint32_t value, unsigned priority);
 
@@ -92,6 +95,9 @@ void Multistate_Output_Change_Of_Value_Clear(uint32_t instance);
 BACNET_STACK_EXPORT
 bool Multistate_Output_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
+BACNET_STACK_EXPORT
+bool Multistate_Output_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
 
 BACNET_STACK_EXPORT
 bool Multistate_Output_Out_Of_Service(uint32_t object_instance);
@@ -141,6 +147,8 @@ uint32_t Multistate_Output_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
 bool Multistate_Output_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Multistate_Output_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Multistate_Output_Cleanup(void);
 
 BACNET_STACK_EXPORT
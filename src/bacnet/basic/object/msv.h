@@ -68,6 +68,9 @@ const char *Multistate_Value_Name_ASCII(uint32_t object_instance);
 BACNET_STACK_EXPORT
 uint32_t Multistate_Value_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Multistate_Value_Present_Value_Unsigned(
+    uint32_t object_instance, BACNET_UNSIGNED_INTEGER *value);
+BACNET_STACK_EXPORT
 bool Multistate_Value_Present_Value_Set(
     uint32_t object_instance, uint32_t value);
 BACNET_STACK_EXPORT
@@ -88,6 +91,9 @@ void Multistate_Value_Change_Of_Value_Clear(uint32_t instance);
 BACNET_STACK_EXPORT
 bool Multistate_Value_Encode_Value_List(
     uint32_t object_instance, BACNET_PROPERTY_VALUE *value_list);
+BACNET_STACK_EXPORT
+bool Multistate_Value_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *status_flags);
 
 BACNET_STACK_EXPORT
 bool Multistate_Value_Out_Of_Service(uint32_t object_instance);
@@ -129,8 +135,13 @@ void Multistate_Value_Context_Set(uint32_t object_instance, void *context);
 BACNET_STACK_EXPORT
 uint32_t Multistate_Value_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+uint32_t
+Multistate_Value_Create_Range(uint32_t object_instance, uint32_t count);
+BACNET_STACK_EXPORT
 bool Multistate_Value_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Multistate_Value_Pool_Reserve(uint32_t count);
+BACNET_STACK_EXPORT
 void Multistate_Value_Cleanup(void);
 
 BACNET_STACK_EXPORT
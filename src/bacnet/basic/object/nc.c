@@ -43,6 +43,29 @@ static NOTIFICATION_CLASS_INFO NC_Infos[MAX_NUM_DEVICES]
 #endif
 /* buffer for sending event messages */
 static uint8_t Event_Buffer[MAX_APDU];
+/* the service request of an event, which is encoded once and then
+   copied into the message for each recipient */
+static uint8_t Event_Body[MAX_APDU];
+/* functions called with each event notification that is reported */
+static NC_EVENT_LISTENER *Event_Listeners;
+#if NC_EVENT_QUEUE_SIZE
+/* an event notification that could not be sent, and is sent again */
+typedef struct nc_event_queue_entry {
+    bool active;
+    bool confirmed;
+    uint8_t retries;
+    BACNET_RECIPIENT recipient;
+    uint32_t process_id;
+    BACNET_OBJECT_ID event_object;
+    uint32_t retry_ms;
+    uint32_t backoff_ms;
+    uint16_t body_len;
+    uint8_t body[NC_EVENT_BODY_SIZE];
+} NC_EVENT_QUEUE_ENTRY;
+static NC_EVENT_QUEUE_ENTRY Event_Queue[NC_EVENT_QUEUE_SIZE];
+static uint32_t Event_Queue_Dropped;
+static uint32_t Event_Queue_Superseded;
+#endif
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Properties_Required[] = {
@@ -156,6 +179,11 @@ void Notification_Class_Init(void)
 
 #ifdef BAC_ROUTING
     Set_Routed_Device_Object_Index(current_dev_id);
+#endif
+#if NC_EVENT_QUEUE_SIZE
+    memset(Event_Queue, 0, sizeof(Event_Queue));
+    Event_Queue_Dropped = 0;
+    Event_Queue_Superseded = 0;
 #endif
     npdu_set_i_am_router_to_network_handler(
         Notification_Class_I_Am_Router_To_Network_Handler);
@@ -628,6 +656,296 @@ void Notification_Class_Set_Ack_Required(
     }
 }
 
+/**
+ * @brief Send an event notification to a recipient
+ * @param recipient - device or address of the recipient
+ * @param process_id - Process Identifier of the recipient
+ * @param confirmed - true for a ConfirmedEventNotification
+ * @param body - service request after the Process Identifier
+ * @param body_len - number of bytes in the service request
+ * @return true if the notification was sent, false if it could not be
+ *  sent now, such as when no TSM slot is free or the device is not bound
+ */
+static bool Notification_Class_Event_Send(
+    const BACNET_RECIPIENT *recipient,
+    uint32_t process_id,
+    bool confirmed,
+    const uint8_t *body,
+    size_t body_len)
+{
+    BACNET_ADDRESS dest = { 0 };
+    unsigned max_apdu = 0;
+    uint32_t device_id;
+    bool status = false;
+
+    if (recipient->tag == BACNET_RECIPIENT_TAG_DEVICE) {
+        /* send notification to the specified device */
+        device_id = recipient->type.device.instance;
+        if (confirmed) {
+            status =
+                Send_CEvent_Notify_Body(device_id, process_id, body, body_len);
+        } else if (address_get_by_device(device_id, &max_apdu, &dest)) {
+            status = Send_UEvent_Notify_Body(
+                         Event_Buffer, sizeof(Event_Buffer), process_id, body,
+                         body_len, &dest) > 0;
+        }
+    } else if (recipient->tag == BACNET_RECIPIENT_TAG_ADDRESS) {
+        /* send notification to the address indicated */
+        bacnet_address_copy(&dest, &recipient->type.address);
+        if (confirmed) {
+            status = Send_CEvent_Notify_Body_Address(
+                Event_Buffer, sizeof(Event_Buffer), process_id, body,
+                body_len, &dest);
+        } else {
+            status = Send_UEvent_Notify_Body(
+                         Event_Buffer, sizeof(Event_Buffer), process_id, body,
+                         body_len, &dest) > 0;
+        }
+    }
+
+    return status;
+}
+
+#if NC_EVENT_QUEUE_SIZE
+/**
+ * @brief Find the queued notification of an event object for a recipient
+ * @param recipient - device or address of the recipient
+ * @param process_id - Process Identifier of the recipient
+ * @param event_object - object that the event is from
+ * @return the queued notification, or NULL if none is queued
+ */
+static NC_EVENT_QUEUE_ENTRY *Notification_Class_Event_Queue_Find(
+    const BACNET_RECIPIENT *recipient,
+    uint32_t process_id,
+    const BACNET_OBJECT_ID *event_object)
+{
+    NC_EVENT_QUEUE_ENTRY *entry;
+    unsigned i;
+
+    for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+        entry = &Event_Queue[i];
+        if (entry->active && (entry->process_id == process_id) &&
+            (entry->event_object.type == event_object->type) &&
+            (entry->event_object.instance == event_object->instance) &&
+            bacnet_recipient_same(&entry->recipient, recipient)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Deliver an event notification to a recipient, or queue it to
+ *  be sent again later by Notification_Class_Event_Queue_Timer()
+ * @details A newer transition of the same event object supersedes a
+ *  notification that is still queued for the recipient, so that the
+ *  older transition is not sent after the newer one.
+ * @param recipient - device or address of the recipient
+ * @param process_id - Process Identifier of the recipient
+ * @param confirmed - true for a ConfirmedEventNotification
+ * @param event_object - object that the event is from
+ * @param body - service request after the Process Identifier
+ * @param body_len - number of bytes in the service request
+ */
+static void Notification_Class_Event_Deliver(
+    const BACNET_RECIPIENT *recipient,
+    uint32_t process_id,
+    bool confirmed,
+    const BACNET_OBJECT_ID *event_object,
+    const uint8_t *body,
+    size_t body_len)
+{
+#if NC_EVENT_QUEUE_SIZE
+    NC_EVENT_QUEUE_ENTRY *entry;
+    unsigned i;
+
+    entry = Notification_Class_Event_Queue_Find(
+        recipient, process_id, event_object);
+    if (entry) {
+        /* superseded by this transition */
+        entry->active = false;
+        Event_Queue_Superseded++;
+    }
+    if (Notification_Class_Event_Send(
+            recipient, process_id, confirmed, body, body_len)) {
+        return;
+    }
+    entry = NULL;
+    if (body_len <= NC_EVENT_BODY_SIZE) {
+        for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+            if (!Event_Queue[i].active) {
+                entry = &Event_Queue[i];
+                break;
+            }
+        }
+    }
+    if (!entry) {
+        /* the queue is full, or the notification does not fit */
+        Event_Queue_Dropped++;
+        debug_printf_stderr("Notification Class: notification dropped\n");
+        return;
+    }
+    bacnet_recipient_copy(&entry->recipient, recipient);
+    entry->process_id = process_id;
+    entry->confirmed = confirmed;
+    entry->event_object = *event_object;
+    entry->retries = 0;
+    entry->backoff_ms = NC_EVENT_RETRY_MS;
+    entry->retry_ms = NC_EVENT_RETRY_MS;
+    memcpy(entry->body, body, body_len);
+    entry->body_len = (uint16_t)body_len;
+    entry->active = true;
+#else
+    (void)event_object;
+    (void)Notification_Class_Event_Send(
+        recipient, process_id, confirmed, body, body_len);
+#endif
+}
+
+/**
+ * @brief Send the queued event notifications that are due. At most
+ *  NC_EVENT_SEND_MAX notifications are sent per call, and each one that
+ *  fails again waits twice as long before the next try, up to
+ *  NC_EVENT_RETRY_MAX_MS, until it is dropped after NC_EVENT_RETRY_LIMIT
+ *  tries.
+ * @param milliseconds - number of milliseconds since the last call
+ */
+void Notification_Class_Event_Queue_Timer(uint32_t milliseconds)
+{
+#if NC_EVENT_QUEUE_SIZE
+    NC_EVENT_QUEUE_ENTRY *entry;
+    unsigned sent = 0;
+    unsigned i;
+
+    for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+        entry = &Event_Queue[i];
+        if (!entry->active) {
+            continue;
+        }
+        if (entry->retry_ms > milliseconds) {
+            entry->retry_ms -= milliseconds;
+            continue;
+        }
+        entry->retry_ms = 0;
+        if (sent >= NC_EVENT_SEND_MAX) {
+            /* due, and sent on the next call */
+            continue;
+        }
+        sent++;
+        if (Notification_Class_Event_Send(
+                &entry->recipient, entry->process_id, entry->confirmed,
+                entry->body, entry->body_len)) {
+            entry->active = false;
+        } else if (++entry->retries >= NC_EVENT_RETRY_LIMIT) {
+            entry->active = false;
+            Event_Queue_Dropped++;
+            debug_printf_stderr("Notification Class: notification dropped\n");
+        } else {
+            if (entry->backoff_ms < (NC_EVENT_RETRY_MAX_MS / 2)) {
+                entry->backoff_ms *= 2;
+            } else {
+                entry->backoff_ms = NC_EVENT_RETRY_MAX_MS;
+            }
+            entry->retry_ms = entry->backoff_ms;
+        }
+    }
+#else
+    (void)milliseconds;
+#endif
+}
+
+/**
+ * @brief Get the number of event notifications that are queued to be
+ *  sent again
+ * @return number of queued notifications
+ */
+unsigned Notification_Class_Event_Queue_Count(void)
+{
+    unsigned count = 0;
+#if NC_EVENT_QUEUE_SIZE
+    unsigned i;
+
+    for (i = 0; i < NC_EVENT_QUEUE_SIZE; i++) {
+        if (Event_Queue[i].active) {
+            count++;
+        }
+    }
+#endif
+
+    return count;
+}
+
+/**
+ * @brief Get the number of event notifications that were dropped, because
+ *  the queue was full or they were retried too many times
+ * @return number of dropped notifications since Notification_Class_Init()
+ */
+uint32_t Notification_Class_Event_Queue_Dropped(void)
+{
+#if NC_EVENT_QUEUE_SIZE
+    return Event_Queue_Dropped;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Get the number of queued event notifications that were replaced
+ *  by a newer transition of the same event object
+ * @return number of superseded notifications since Notification_Class_Init()
+ */
+uint32_t Notification_Class_Event_Queue_Superseded(void)
+{
+#if NC_EVENT_QUEUE_SIZE
+    return Event_Queue_Superseded;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Add a function to the list of functions that are called with
+ *  each event notification that is reported, such as to log it.
+ * @param listener - the listener, which is kept by the caller and
+ *  shall remain valid until it is removed
+ */
+void Notification_Class_Event_Listener_Add(NC_EVENT_LISTENER *listener)
+{
+    NC_EVENT_LISTENER *node;
+
+    if (!listener) {
+        return;
+    }
+    for (node = Event_Listeners; node; node = node->next) {
+        if (node == listener) {
+            /* already here! */
+            return;
+        }
+    }
+    listener->next = Event_Listeners;
+    Event_Listeners = listener;
+}
+
+/**
+ * @brief Remove a function from the list of functions that are called
+ *  with each event notification that is reported.
+ * @param listener - the listener to remove
+ */
+void Notification_Class_Event_Listener_Remove(NC_EVENT_LISTENER *listener)
+{
+    NC_EVENT_LISTENER **node;
+
+    for (node = &Event_Listeners; *node; node = &(*node)->next) {
+        if (*node == listener) {
+            *node = listener->next;
+            listener->next = NULL;
+            break;
+        }
+    }
+}
+
 static bool
 IsRecipientActive(BACNET_DESTINATION *pBacDest, uint8_t EventToState)
 {
@@ -687,8 +1005,10 @@ void Notification_Class_common_reporting_function(
 
     NOTIFICATION_CLASS_INFO *CurrentNotify;
     BACNET_DESTINATION *pBacDest;
+    NC_EVENT_LISTENER *listener;
     uint32_t notify_index;
     uint8_t index;
+    int body_len;
 
     notify_index =
         Notification_Class_Instance_To_Index(event_data->notificationClass);
@@ -737,7 +1057,23 @@ void Notification_Class_common_reporting_function(
         default: /* shouldn't happen */
             break;
     }
+    /* the notification is reported once, whatever the recipients */
+    for (listener = Event_Listeners; listener; listener = listener->next) {
+        if (listener->callback) {
+            listener->callback(event_data);
+        }
+    }
 
+    /* everything after the Process Identifier is the same for every
+       recipient, so encode it once */
+    body_len = event_notify_encode_service_request_body(NULL, event_data);
+    if ((body_len <= 0) || ((size_t)body_len > sizeof(Event_Body))) {
+        debug_printf_stderr(
+            "Notification Class[%u]: notification is too large\n",
+            event_data->notificationClass);
+        return;
+    }
+    body_len = event_notify_encode_service_request_body(Event_Body, event_data);
     /* send notifications for active recipients */
     debug_printf_stderr(
         "Notification Class[%u]: send notifications\n",
@@ -750,39 +1086,16 @@ void Notification_Class_common_reporting_function(
             continue;
         }
         if (IsRecipientActive(pBacDest, event_data->toState)) {
-            BACNET_ADDRESS dest;
-            uint32_t device_id;
-            unsigned max_apdu;
-
             /* Process Identifier */
             event_data->processIdentifier = pBacDest->ProcessIdentifier;
-
-            /* send notification */
-            if (pBacDest->Recipient.tag == BACNET_RECIPIENT_TAG_DEVICE) {
-                /* send notification to the specified device */
-                device_id = pBacDest->Recipient.type.device.instance;
-                debug_printf_stderr(
-                    "Notification Class[%u]: send notification to %u\n",
-                    event_data->notificationClass, (unsigned)device_id);
-                if (pBacDest->ConfirmedNotify == true) {
-                    Send_CEvent_Notify(device_id, event_data);
-                } else if (address_get_by_device(device_id, &max_apdu, &dest)) {
-                    Send_UEvent_Notify(Event_Buffer, event_data, &dest);
-                }
-            } else if (
-                pBacDest->Recipient.tag == BACNET_RECIPIENT_TAG_ADDRESS) {
-                debug_printf_stderr(
-                    "Notification Class[%u]: send notification to ADDR\n",
-                    event_data->notificationClass);
-                /* send notification to the address indicated */
-                bacnet_address_copy(&dest, &pBacDest->Recipient.type.address);
-                if (pBacDest->ConfirmedNotify == true) {
-                    Send_CEvent_Notify_Address(
-                        Event_Buffer, sizeof(Event_Buffer), event_data, &dest);
-                } else {
-                    Send_UEvent_Notify(Event_Buffer, event_data, &dest);
-                }
-            }
+            debug_printf_stderr(
+                "Notification Class[%u]: send notification\n",
+                event_data->notificationClass);
+            Notification_Class_Event_Deliver(
+                &pBacDest->Recipient, pBacDest->ProcessIdentifier,
+                pBacDest->ConfirmedNotify,
+                &event_data->eventObjectIdentifier, Event_Body,
+                (size_t)body_len);
         }
     }
 }
@@ -27,6 +27,31 @@ extern "C" {
 #define NC_MAX_RECIPIENTS 10
 #endif
 
+/* event notifications that could not be sent, such as when the TSM
+   is full, are queued and sent again. Set to 0 to not queue them. */
+#ifndef NC_EVENT_QUEUE_SIZE
+#define NC_EVENT_QUEUE_SIZE 8
+#endif
+/* max size of a queued service request */
+#ifndef NC_EVENT_BODY_SIZE
+#define NC_EVENT_BODY_SIZE 256
+#endif
+/* first retry delay, which doubles after each failed try */
+#ifndef NC_EVENT_RETRY_MS
+#define NC_EVENT_RETRY_MS 1000UL
+#endif
+#ifndef NC_EVENT_RETRY_MAX_MS
+#define NC_EVENT_RETRY_MAX_MS 60000UL
+#endif
+/* tries of a queued notification before it is dropped */
+#ifndef NC_EVENT_RETRY_LIMIT
+#define NC_EVENT_RETRY_LIMIT 10
+#endif
+/* max queued notifications that are sent per timer call */
+#ifndef NC_EVENT_SEND_MAX
+#define NC_EVENT_SEND_MAX 4
+#endif
+
 #if defined(INTRINSIC_REPORTING)
 
 /* Structure containing configuration for a Notification Class */
@@ -50,6 +75,16 @@ typedef struct Ack_Notification {
     uint8_t EventState;
 } ACK_NOTIFICATION;
 
+/* list of functions called with each event notification that is
+   reported, such as the local Event Logs */
+typedef void (*notification_class_event_callback)(
+    const BACNET_EVENT_NOTIFICATION_DATA *event_data);
+struct notification_class_event_listener;
+typedef struct notification_class_event_listener {
+    struct notification_class_event_listener *next;
+    notification_class_event_callback callback;
+} NC_EVENT_LISTENER;
+
 BACNET_STACK_EXPORT
 void Notification_Class_Property_Lists(
     const int32_t **pRequired,
@@ -116,6 +151,20 @@ void Notification_Class_common_reporting_function(
 
 BACNET_STACK_EXPORT
 void Notification_Class_find_recipient(void);
+
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Listener_Add(NC_EVENT_LISTENER *listener);
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Listener_Remove(NC_EVENT_LISTENER *listener);
+
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Queue_Timer(uint32_t milliseconds);
+BACNET_STACK_EXPORT
+unsigned Notification_Class_Event_Queue_Count(void);
+BACNET_STACK_EXPORT
+uint32_t Notification_Class_Event_Queue_Dropped(void);
+BACNET_STACK_EXPORT
+uint32_t Notification_Class_Event_Queue_Superseded(void);
 #endif /* defined(INTRINSIC_REPORTING) */
 
 #ifdef __cplusplus
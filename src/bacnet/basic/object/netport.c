@@ -25,6 +25,7 @@
 #include "bacnet/datalink/bvlc6.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/perfstat.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
 /* me */
@@ -369,7 +370,28 @@ static const int32_t BSC_Port_Writable_Properties[] = {
     -1
 };
 
-static const int32_t Network_Port_Properties_Proprietary[] = { -1 };
+static const int32_t Network_Port_Properties_Proprietary[] = {
+#if BACNET_PERFSTAT_ENABLED
+    PROP_PERFSTAT_PACKETS_RECEIVED,
+    PROP_PERFSTAT_PACKETS_SENT,
+#endif
+    -1
+};
+#if BACNET_PERFSTAT_ENABLED
+static const int32_t MSTP_Port_Properties_Proprietary[] = {
+    PROP_PERFSTAT_PACKETS_RECEIVED,
+    PROP_PERFSTAT_PACKETS_SENT,
+    PROP_PERFSTAT_TOKEN_ROTATION_TIME,
+    PROP_PERFSTAT_TOKEN_ROTATION_TIME_MAX,
+    -1
+};
+static const int32_t BBMD_Port_Properties_Proprietary[] = {
+    PROP_PERFSTAT_PACKETS_RECEIVED,
+    PROP_PERFSTAT_PACKETS_SENT,
+    PROP_PERFSTAT_BBMD_FORWARDS,
+    -1
+};
+#endif
 
 /**
  * Returns the list of required, optional, and proprietary properties.
@@ -422,6 +444,22 @@ void Network_Port_Property_List(
     }
     if (pProprietary) {
         *pProprietary = Network_Port_Properties_Proprietary;
+#if BACNET_PERFSTAT_ENABLED
+        index = Network_Port_Instance_To_Index(object_instance);
+        if (index < BACNET_NETWORK_PORTS_MAX) {
+            switch (Object_List[index].Network_Type) {
+                case PORT_TYPE_MSTP:
+                    *pProprietary = MSTP_Port_Properties_Proprietary;
+                    break;
+                case PORT_TYPE_BIP:
+                case PORT_TYPE_BIP6:
+                    *pProprietary = BBMD_Port_Properties_Proprietary;
+                    break;
+                default:
+                    break;
+            }
+        }
+#endif
     }
 
     return;
@@ -4067,6 +4105,70 @@ static int Network_Port_Virtual_MAC_Table_Encode(
     return apdu_len;
 }
 
+#if BACNET_PERFSTAT_ENABLED
+/**
+ * @brief Encode a stack statistic of the datalink of a Network Port
+ * @param object_instance - object-instance number of the object
+ * @param apdu - buffer for the encoding
+ * @param property - one of the PROP_PERFSTAT_ properties of the port
+ * @return number of bytes encoded, or zero if the property is not a
+ *  stack statistic of the Network Port object
+ */
+static int Network_Port_Perfstat_Encode(
+    uint32_t object_instance, uint8_t *apdu, uint32_t property)
+{
+    PERFSTAT_DATALINK datalink = PERFSTAT_DATALINK_NONE;
+    uint32_t value = 0;
+
+    switch (Network_Port_Type(object_instance)) {
+        case PORT_TYPE_BIP:
+            datalink = PERFSTAT_DATALINK_BIP;
+            break;
+        case PORT_TYPE_BIP6:
+            datalink = PERFSTAT_DATALINK_BIP6;
+            break;
+        case PORT_TYPE_MSTP:
+            datalink = PERFSTAT_DATALINK_MSTP;
+            break;
+        case PORT_TYPE_ETHERNET:
+            datalink = PERFSTAT_DATALINK_ETHERNET;
+            break;
+        case PORT_TYPE_ARCNET:
+            datalink = PERFSTAT_DATALINK_ARCNET;
+            break;
+        case PORT_TYPE_ZIGBEE:
+            datalink = PERFSTAT_DATALINK_ZIGBEE;
+            break;
+        case PORT_TYPE_BSC:
+            datalink = PERFSTAT_DATALINK_BSC;
+            break;
+        default:
+            break;
+    }
+    switch (property) {
+        case PROP_PERFSTAT_PACKETS_RECEIVED:
+            value = perfstat_datalink_receive_count(datalink);
+            break;
+        case PROP_PERFSTAT_PACKETS_SENT:
+            value = perfstat_datalink_send_count(datalink);
+            break;
+        case PROP_PERFSTAT_BBMD_FORWARDS:
+            value = perfstat_datalink_forward_count(datalink);
+            break;
+        case PROP_PERFSTAT_TOKEN_ROTATION_TIME:
+            value = perfstat_mstp_token_rotation();
+            break;
+        case PROP_PERFSTAT_TOKEN_ROTATION_TIME_MAX:
+            value = perfstat_mstp_token_rotation_max();
+            break;
+        default:
+            return 0;
+    }
+
+    return encode_application_unsigned(apdu, value);
+}
+#endif
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -4526,6 +4628,13 @@ int Network_Port_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
 #endif /* BACDL_BSC */
         default:
+#if BACNET_PERFSTAT_ENABLED
+            apdu_len = Network_Port_Perfstat_Encode(
+                rpdata->object_instance, &apdu[0], rpdata->object_property);
+            if (apdu_len > 0) {
+                break;
+            }
+#endif
             rpdata->error_class = ERROR_CLASS_PROPERTY;
             rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
             apdu_len = BACNET_STATUS_ERROR;
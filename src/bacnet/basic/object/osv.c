@@ -20,14 +20,15 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/string_pool.h"
 #include "bacnet/basic/object/osv.h"
 
 struct object_data {
     unsigned Event_State : 3;
     bool Out_Of_Service : 1;
     BACNET_OCTET_STRING_BUFFER Present_Value;
-    char *Object_Name;
-    char *Description;
+    const char *Object_Name;
+    const char *Description;
 };
 
 /* Key List for storing object data sorted by instance number */
@@ -157,8 +158,8 @@ bool OctetString_Value_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject->Description);
-        free(pObject->Object_Name);
+        String_Pool_Release(pObject->Description);
+        String_Pool_Release(pObject->Object_Name);
         free(pObject->Present_Value.buffer);
         free(pObject);
         return true;
@@ -388,8 +389,8 @@ bool OctetString_Value_Name_Set(uint32_t object_instance, const char *new_name)
     pObject = OctetString_Value_Object(object_instance);
     if (pObject) {
         status = true;
-        free(pObject->Object_Name);
-        pObject->Object_Name = bacnet_strdup(new_name);
+        String_Pool_Release(pObject->Object_Name);
+        pObject->Object_Name = String_Pool_Intern(new_name);
     }
 
     return status;
@@ -454,8 +455,8 @@ bool OctetString_Value_Description_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         status = true;
-        free(pObject->Description);
-        pObject->Description = bacnet_strdup(new_name);
+        String_Pool_Release(pObject->Description);
+        pObject->Description = String_Pool_Intern(new_name);
     }
 
     return status;
@@ -598,15 +599,23 @@ static bool OctetString_Value_Object_Name_Write(
     bool status = false; /* return value */
     struct object_data *pObject;
     char *utf8_name = NULL;
+    const char *name = NULL;
 
     pObject = Keylist_Data(Object_List, wp_data->object_instance);
     if (pObject) {
         utf8_name =
             write_property_characterstring_utf8_strdup(wp_data, cstring);
         if (utf8_name) {
-            free(pObject->Object_Name);
-            pObject->Object_Name = utf8_name;
-            status = true;
+            name = String_Pool_Intern(utf8_name);
+            free(utf8_name);
+            if (name) {
+                String_Pool_Release(pObject->Object_Name);
+                pObject->Object_Name = name;
+                status = true;
+            } else {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            }
         }
     } else {
         wp_data->error_class = ERROR_CLASS_PROPERTY;
@@ -630,15 +639,23 @@ static bool OctetString_Value_Description_Write(
     bool status = false; /* return value */
     struct object_data *pObject;
     char *utf8_name = NULL;
+    const char *name = NULL;
 
     pObject = Keylist_Data(Object_List, wp_data->object_instance);
     if (pObject) {
         utf8_name =
             write_property_characterstring_utf8_strdup(wp_data, cstring);
         if (utf8_name) {
-            free(pObject->Description);
-            pObject->Description = utf8_name;
-            status = true;
+            name = String_Pool_Intern(utf8_name);
+            free(utf8_name);
+            if (name) {
+                String_Pool_Release(pObject->Description);
+                pObject->Description = name;
+                status = true;
+            } else {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            }
         }
     } else {
         wp_data->error_class = ERROR_CLASS_PROPERTY;
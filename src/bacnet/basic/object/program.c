@@ -58,8 +58,36 @@ struct object_data {
     int (*Halt)(void *context);
     int (*Restart)(void *context);
     int (*Unload)(void *context);
+    /* run queue of the scheduler */
+    struct object_data *Run_Next;
+    bool Run_Queued : 1;
+    /* milliseconds remaining while the program is WAITING */
+    uint32_t Wait_Time;
+    /* number of Run calls, and the microseconds spent in them */
+    uint32_t Run_Count;
+    uint32_t Run_Time;
 };
 
+/* the run queue holds only the programs that are RUNNING */
+struct run_queue {
+    struct object_data *head;
+    struct object_data *tail;
+};
+static struct run_queue Run_Queues[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Run_Queue (Run_Queues[Routed_Device_Object_Index()])
+#else
+#define Run_Queue (Run_Queues[0])
+#endif
+/* Run calls per scheduler task, where zero disables the scheduler */
+static uint16_t Scheduler_Budget;
+/* Run calls that a program makes before the next one gets its turn */
+static uint16_t Scheduler_Quantum = 1;
+/* microseconds per scheduler task, where zero is unlimited */
+static uint32_t Scheduler_Time_Budget;
+/* free-running microsecond clock used to measure the Run calls */
+static uint32_t (*Scheduler_Clock)(void);
+
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Properties_Required[] = {
     /* unordered list of required properties */
@@ -80,7 +108,10 @@ static const int32_t Properties_Optional[] = {
     -1
 };
 
-static const int32_t Properties_Proprietary[] = { -1 };
+static const int32_t Properties_Proprietary[] = {
+    /* unordered list of proprietary properties */
+    PROP_PROGRAM_RUN_COUNT, PROP_PROGRAM_RUN_TIME, -1
+};
 
 /* Every object shall have a Writable Property_List property
    which is a BACnetARRAY of property identifiers,
@@ -144,6 +175,58 @@ static struct object_data *Object_Data(uint32_t object_instance)
     return Keylist_Data(Object_List, object_instance);
 }
 
+/**
+ * @brief Removes a program from the run queue, if it is queued
+ * @param pObject [in] pointer to the object data
+ */
+static void Program_Run_Queue_Remove(struct object_data *pObject)
+{
+    struct object_data *prev = NULL;
+    struct object_data *node;
+
+    if (!pObject->Run_Queued) {
+        return;
+    }
+    node = Run_Queue.head;
+    while (node && (node != pObject)) {
+        prev = node;
+        node = node->Run_Next;
+    }
+    if (node) {
+        if (prev) {
+            prev->Run_Next = node->Run_Next;
+        } else {
+            Run_Queue.head = node->Run_Next;
+        }
+        if (Run_Queue.tail == node) {
+            Run_Queue.tail = prev;
+        }
+    }
+    pObject->Run_Next = NULL;
+    pObject->Run_Queued = false;
+}
+
+/**
+ * @brief Puts a RUNNING program at the back of the run queue, and takes
+ *  any other program out of it
+ * @param pObject [in] pointer to the object data
+ */
+static void Program_Run_Queue_Update(struct object_data *pObject)
+{
+    if (pObject->Program_State != PROGRAM_STATE_RUNNING) {
+        Program_Run_Queue_Remove(pObject);
+    } else if (!pObject->Run_Queued) {
+        pObject->Run_Next = NULL;
+        if (Run_Queue.tail) {
+            Run_Queue.tail->Run_Next = pObject;
+        } else {
+            Run_Queue.head = pObject;
+        }
+        Run_Queue.tail = pObject;
+        pObject->Run_Queued = true;
+    }
+}
+
 /**
  * Determines if a given Integer Value instance is valid
  *
@@ -235,6 +318,7 @@ bool Program_State_Set(uint32_t object_instance, BACNET_PROGRAM_STATE value)
     pObject = Object_Data(object_instance);
     if (pObject) {
         pObject->Program_State = value;
+        Program_Run_Queue_Update(pObject);
         status = true;
     }
 
@@ -820,6 +904,35 @@ bool Program_Reliability_Set(uint32_t object_instance, BACNET_RELIABILITY value)
     return status;
 }
 
+/**
+ * @brief Encode a proprietary property of the Program object
+ * @param apdu - buffer for the encoding
+ * @param object_instance - object-instance number of the object
+ * @param property - one of the PROP_PROGRAM_RUN_ properties
+ * @return number of bytes encoded, or zero if the property is not a
+ *  proprietary property of the Program object
+ */
+static int Program_Proprietary_Encode(
+    uint8_t *apdu, uint32_t object_instance, uint32_t property)
+{
+    int apdu_len = 0;
+
+    switch (property) {
+        case PROP_PROGRAM_RUN_COUNT:
+            apdu_len = encode_application_unsigned(
+                apdu, Program_Run_Count(object_instance));
+            break;
+        case PROP_PROGRAM_RUN_TIME:
+            apdu_len = encode_application_unsigned(
+                apdu, Program_Run_Time(object_instance));
+            break;
+        default:
+            break;
+    }
+
+    return apdu_len;
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -913,9 +1026,13 @@ int Program_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = encode_application_enumerated(&apdu[0], enum_value);
             break;
         default:
-            rpdata->error_class = ERROR_CLASS_PROPERTY;
-            rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
-            apdu_len = BACNET_STATUS_ERROR;
+            apdu_len = Program_Proprietary_Encode(
+                &apdu[0], rpdata->object_instance, rpdata->object_property);
+            if (apdu_len == 0) {
+                rpdata->error_class = ERROR_CLASS_PROPERTY;
+                rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+                apdu_len = BACNET_STATUS_ERROR;
+            }
             break;
     }
 
@@ -1196,6 +1313,41 @@ static void Program_State_Halted_Handler(struct object_data *pObject)
     }
 }
 
+/**
+ * @brief Call the Run of the program, and handle what it returns
+ * @details The Run returns 0 to keep running, a positive number of
+ *  milliseconds to wait before it is called again, or negative when
+ *  the program has stopped.
+ * @param pObject [in] pointer to the object data
+ */
+static void Program_Run_Call(struct object_data *pObject)
+{
+    uint32_t start = 0;
+    int err;
+
+    if (!pObject->Run) {
+        return;
+    }
+    if (Scheduler_Clock) {
+        start = Scheduler_Clock();
+    }
+    err = pObject->Run(pObject->Context);
+    if (Scheduler_Clock) {
+        pObject->Run_Time += Scheduler_Clock() - start;
+    }
+    pObject->Run_Count++;
+    if (err == 0) {
+        pObject->Reason_For_Halt = PROGRAM_ERROR_NORMAL;
+    } else if (err > 0) {
+        pObject->Reason_For_Halt = PROGRAM_ERROR_NORMAL;
+        pObject->Wait_Time = (uint32_t)err;
+        pObject->Program_State = PROGRAM_STATE_WAITING;
+    } else {
+        pObject->Reason_For_Halt = PROGRAM_ERROR_INTERNAL;
+        pObject->Program_State = PROGRAM_STATE_HALTED;
+    }
+}
+
 /**
  * @brief Handle the RUNNING state of the program
  * @param pObject [in] pointer to the object data
@@ -1249,16 +1401,28 @@ static void Program_State_Running_Handler(struct object_data *pObject)
             pObject->Reason_For_Halt = PROGRAM_ERROR_NORMAL;
             pObject->Program_State = PROGRAM_STATE_RUNNING;
         }
+    } else if (Scheduler_Budget == 0) {
+        Program_Run_Call(pObject);
+    }
+}
+
+/**
+ * @brief Handle the WAITING state of the program
+ * @param pObject [in] pointer to the object data
+ * @param milliseconds [in] number of milliseconds elapsed
+ */
+static void Program_State_Waiting_Handler(
+    struct object_data *pObject, uint16_t milliseconds)
+{
+    if (pObject->Program_Change != PROGRAM_REQUEST_READY) {
+        Program_State_Running_Handler(pObject);
+    } else if (pObject->Wait_Time > milliseconds) {
+        pObject->Wait_Time -= milliseconds;
     } else {
-        if (pObject->Run) {
-            err = pObject->Run(pObject->Context);
-            if (err == 0) {
-                pObject->Reason_For_Halt = PROGRAM_ERROR_NORMAL;
-            } else {
-                pObject->Reason_For_Halt = PROGRAM_ERROR_INTERNAL;
-                pObject->Program_State = PROGRAM_STATE_HALTED;
-            }
-        }
+        /* wake up */
+        pObject->Wait_Time = 0;
+        pObject->Program_State = PROGRAM_STATE_RUNNING;
+        Program_State_Running_Handler(pObject);
     }
 }
 
@@ -1337,14 +1501,123 @@ void Program_Timer(uint32_t object_instance, uint16_t milliseconds)
                 Program_State_Running_Handler(pObject);
                 break;
             case PROGRAM_STATE_WAITING:
-                Program_State_Running_Handler(pObject);
+                Program_State_Waiting_Handler(pObject, milliseconds);
                 break;
             default:
                 /* do nothing */
                 break;
         }
         pObject->Program_Change = PROGRAM_REQUEST_READY;
+        Program_Run_Queue_Update(pObject);
+    }
+}
+
+/**
+ * @brief Sets the budget of the scheduler of the RUNNING programs
+ * @details With a budget, Program_Timer() only handles the changes of
+ *  the program state, and Program_Scheduler_Task() calls the Run of the
+ *  RUNNING programs in turn until the budget of the task is spent.
+ * @param budget - number of Run calls per task, or 0 to call the Run
+ *  once from each Program_Timer() as before
+ * @param quantum - number of Run calls that a program makes before
+ *  the next program gets its turn
+ * @param microseconds - time spent in the Run calls per task, or 0
+ *  for no limit. Needs the clock from Program_Scheduler_Clock_Set().
+ */
+void Program_Scheduler_Budget_Set(
+    uint16_t budget, uint16_t quantum, uint32_t microseconds)
+{
+    Scheduler_Budget = budget;
+    if (quantum == 0) {
+        quantum = 1;
+    }
+    Scheduler_Quantum = quantum;
+    Scheduler_Time_Budget = microseconds;
+}
+
+/**
+ * @brief Sets the clock used to measure the time spent in the Run calls
+ * @param clock - function returning a free-running microsecond count,
+ *  or NULL to not measure the time
+ */
+void Program_Scheduler_Clock_Set(uint32_t (*clock)(void))
+{
+    Scheduler_Clock = clock;
+}
+
+/**
+ * @brief Calls the Run of the RUNNING programs in round-robin order
+ *  until the budget set by Program_Scheduler_Budget_Set() is spent.
+ *  Programs that are WAITING are not in the run queue, and are woken
+ *  up by Program_Timer() when their wait time has elapsed.
+ */
+void Program_Scheduler_Task(void)
+{
+    struct object_data *pObject;
+    uint16_t budget = Scheduler_Budget;
+    uint16_t quantum;
+    uint32_t start = 0;
+
+    if (Scheduler_Clock) {
+        start = Scheduler_Clock();
     }
+    while ((budget > 0) && Run_Queue.head) {
+        pObject = Run_Queue.head;
+        Program_Run_Queue_Remove(pObject);
+        if (pObject->Program_Change != PROGRAM_REQUEST_READY) {
+            /* Program_Timer() handles the request, and queues it again */
+            continue;
+        }
+        quantum = Scheduler_Quantum;
+        while ((quantum > 0) && (budget > 0) &&
+               (pObject->Program_State == PROGRAM_STATE_RUNNING)) {
+            Program_Run_Call(pObject);
+            quantum--;
+            budget--;
+            if (Scheduler_Clock && Scheduler_Time_Budget &&
+                ((Scheduler_Clock() - start) >= Scheduler_Time_Budget)) {
+                budget = 0;
+            }
+        }
+        /* to the back of the queue, if still running */
+        Program_Run_Queue_Update(pObject);
+    }
+}
+
+/**
+ * @brief Gets the number of Run calls made by the program
+ * @param object_instance - object-instance number of the object
+ * @return number of Run calls
+ */
+uint32_t Program_Run_Count(uint32_t object_instance)
+{
+    uint32_t value = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Run_Count;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Gets the time spent in the Run calls of the program
+ * @param object_instance - object-instance number of the object
+ * @return number of microseconds, measured with the scheduler clock
+ */
+uint32_t Program_Run_Time(uint32_t object_instance)
+{
+    uint32_t value = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Run_Time;
+    }
+
+    return value;
 }
 
 /**
@@ -1418,6 +1691,7 @@ bool Program_Delete(uint32_t object_instance)
         Keylist_Data_Delete(Object_List, object_instance);
 
     if (pObject) {
+        Program_Run_Queue_Remove(pObject);
         free(pObject);
         status = true;
     }
@@ -1450,6 +1724,8 @@ void Program_Cleanup(void)
             Keylist_Delete(Object_List);
             Object_List = NULL;
         }
+        Run_Queue.head = NULL;
+        Run_Queue.tail = NULL;
     }
 
 #ifdef BAC_ROUTING
@@ -16,6 +16,17 @@
 #include "bacnet/wp.h"
 #include "bacnet/rp.h"
 
+/* proprietary properties of the Program object */
+#ifndef PROGRAM_PROPERTY_MIN
+#define PROGRAM_PROPERTY_MIN 512
+#endif
+typedef enum program_property {
+    /* number of Run calls made by the program */
+    PROP_PROGRAM_RUN_COUNT = PROGRAM_PROPERTY_MIN,
+    /* microseconds spent in the Run calls of the program */
+    PROP_PROGRAM_RUN_TIME = PROGRAM_PROPERTY_MIN + 1
+} PROGRAM_PROPERTY;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -108,6 +119,17 @@ void Program_Out_Of_Service_Set(uint32_t instance, bool oos_flag);
 BACNET_STACK_EXPORT
 void Program_Timer(uint32_t object_instance, uint16_t milliseconds);
 BACNET_STACK_EXPORT
+void Program_Scheduler_Budget_Set(
+    uint16_t budget, uint16_t quantum, uint32_t microseconds);
+BACNET_STACK_EXPORT
+void Program_Scheduler_Clock_Set(uint32_t (*clock)(void));
+BACNET_STACK_EXPORT
+void Program_Scheduler_Task(void);
+BACNET_STACK_EXPORT
+uint32_t Program_Run_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Program_Run_Time(uint32_t object_instance);
+BACNET_STACK_EXPORT
 uint32_t Program_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
 bool Program_Delete(uint32_t object_instance);
@@ -117,7 +139,9 @@ BACNET_STACK_EXPORT
 void Program_Init(void);
 
 /* API for the program requests
-    note: return value is 0 for success, non-zero for failure
+    note: return value is 0 for success, non-zero for failure.
+    The run returns 0 to keep running, a positive number of
+    milliseconds to wait in the WAITING state, or negative to halt.
 */
 BACNET_STACK_EXPORT
 void *Program_Context_Get(uint32_t object_instance);
@@ -25,12 +25,28 @@
 #define MAX_SCHEDULES 4
 #endif
 
+/* number of time values that the Weekly_Schedule of all of the Schedule
+   objects share.  By default every day can be full, as when each day had
+   its own BACNET_DAILY_SCHEDULE_TIME_VALUES_SIZE time values. */
+#ifndef BACNET_SCHEDULE_TIME_VALUES_POOL_SIZE
+#define BACNET_SCHEDULE_TIME_VALUES_POOL_SIZE                     \
+    (MAX_NUM_DEVICES * MAX_SCHEDULES * BACNET_WEEKLY_SCHEDULE_SIZE * \
+     BACNET_DAILY_SCHEDULE_TIME_VALUES_SIZE)
+#endif
+
 static SCHEDULE_DESCR Schedule_Descrs[MAX_NUM_DEVICES][MAX_SCHEDULES];
 #ifdef BAC_ROUTING
 #define Schedule_Descr (Schedule_Descrs[Routed_Device_Object_Index()])
 #else
 #define Schedule_Descr (Schedule_Descrs[0])
 #endif
+/* the time values of each day are kept together, one day after the
+   other, in the order that the days were written */
+static SCHEDULE_TIME_VALUE
+    Schedule_Time_Values[BACNET_SCHEDULE_TIME_VALUES_POOL_SIZE];
+static size_t Schedule_Time_Values_Used;
+/* a copy of a day for Schedule_Weekly_Schedule() */
+static BACNET_DAILY_SCHEDULE Schedule_Daily_Copy;
 
 static const int32_t Schedule_Properties_Required[] = {
     /* list of required properties */
@@ -158,6 +174,7 @@ void Schedule_Init(void)
     datetime_set_date(&end_date, 0, 12, 31);
     datetime_wildcard_year_set(&end_date);
     datetime_wildcard_weekday_set(&end_date);
+    Schedule_Time_Values_Used = 0;
     for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
 #ifdef BAC_ROUTING
         Set_Routed_Device_Object_Index(dev_id);
@@ -167,7 +184,9 @@ void Schedule_Init(void)
             datetime_copy_date(&psched->Start_Date, &start_date);
             datetime_copy_date(&psched->End_Date, &end_date);
             for (j = 0; j < BACNET_WEEKLY_SCHEDULE_SIZE; j++) {
+                psched->Weekly_Schedule[j].Time_Values = NULL;
                 psched->Weekly_Schedule[j].TV_Count = 0;
+                psched->Weekly_Schedule[j].Wildcard = false;
             }
             memcpy(
                 &psched->Present_Value, &psched->Schedule_Default,
@@ -179,6 +198,7 @@ void Schedule_Init(void)
             psched->obj_prop_ref_cnt = 0; /* no references, add as needed */
             psched->Priority_For_Writing = 16; /* lowest priority */
             psched->Out_Of_Service = false;
+            psched->Transition_Valid = false;
 #if BACNET_EXCEPTION_SCHEDULE_SIZE
             for (e = 0; e < BACNET_EXCEPTION_SCHEDULE_SIZE; e++) {
                 event = &psched->Exception_Schedule[e];
@@ -293,23 +313,178 @@ void Schedule_Out_Of_Service_Set(uint32_t object_instance, bool value)
     }
 }
 
+/**
+ * @brief Build the mask of the fields of a packed time key that are not
+ *  wildcards
+ * @param key - time packed by datetime_time_key()
+ * @return mask with zero bits for each wildcard field
+ */
+static uint32_t Schedule_Time_Key_Mask(uint32_t key)
+{
+    uint32_t mask = 0;
+    unsigned shift;
+
+    for (shift = 0; shift < 32; shift += 8) {
+        if (((key >> shift) & 0xFF) != 0xFF) {
+            mask |= 0xFFUL << shift;
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * @brief Copy a time value out of the pool
+ * @param tv - time value of a day of the Weekly_Schedule
+ * @param value - the time value as a BACnetTimeValue
+ */
+static void Schedule_Time_Value_Get(
+    const SCHEDULE_TIME_VALUE *tv, BACNET_TIME_VALUE *value)
+{
+    value->Time.hour = (uint8_t)(tv->Time_Key >> 24);
+    value->Time.min = (uint8_t)(tv->Time_Key >> 16);
+    value->Time.sec = (uint8_t)(tv->Time_Key >> 8);
+    value->Time.hundredths = (uint8_t)tv->Time_Key;
+    value->Value.tag = tv->Tag;
+    value->Value.type = tv->Value;
+}
+
+/**
+ * @brief Copy the time values of a day out of the pool
+ * @param daily - day of the Weekly_Schedule
+ * @param value - the day as a BACnetDailySchedule
+ */
+static void
+Schedule_Daily_Get(const SCHEDULE_DAILY *daily, BACNET_DAILY_SCHEDULE *value)
+{
+    uint16_t i;
+
+    for (i = 0; i < daily->TV_Count; i++) {
+        Schedule_Time_Value_Get(&daily->Time_Values[i], &value->Time_Values[i]);
+    }
+    value->TV_Count = daily->TV_Count;
+}
+
+/**
+ * @brief Release the time values of a day back to the pool. The days
+ *  that come after it in the pool are moved down over it.
+ * @param daily - day of the Weekly_Schedule
+ */
+static void Schedule_Daily_Release(SCHEDULE_DAILY *daily)
+{
+    SCHEDULE_TIME_VALUE *end;
+    SCHEDULE_DAILY *other;
+    unsigned dev_id, i, j;
+
+    if (daily->TV_Count == 0) {
+        return;
+    }
+    end = daily->Time_Values + daily->TV_Count;
+    memmove(
+        daily->Time_Values, end,
+        (size_t)(&Schedule_Time_Values[Schedule_Time_Values_Used] - end) *
+            sizeof(SCHEDULE_TIME_VALUE));
+    Schedule_Time_Values_Used -= daily->TV_Count;
+    for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
+        for (i = 0; i < MAX_SCHEDULES; i++) {
+            for (j = 0; j < BACNET_WEEKLY_SCHEDULE_SIZE; j++) {
+                other = &Schedule_Descrs[dev_id][i].Weekly_Schedule[j];
+                if (other->TV_Count && (other->Time_Values >= end)) {
+                    other->Time_Values -= daily->TV_Count;
+                }
+            }
+        }
+    }
+    daily->Time_Values = NULL;
+    daily->TV_Count = 0;
+    daily->Wildcard = false;
+}
+
+/**
+ * @brief Store the time values of a day in the pool, sorted by time
+ * @param daily - day of the Weekly_Schedule
+ * @param value - the day as a BACnetDailySchedule
+ * @return true if the day was stored, or false if the pool has too few
+ *  free time values, and the day is unchanged
+ */
+static bool
+Schedule_Daily_Set(SCHEDULE_DAILY *daily, const BACNET_DAILY_SCHEDULE *value)
+{
+    SCHEDULE_TIME_VALUE tv;
+    uint16_t count, i, j;
+
+    count = min(value->TV_Count, BACNET_DAILY_SCHEDULE_TIME_VALUES_SIZE);
+    if (count > (BACNET_SCHEDULE_TIME_VALUES_POOL_SIZE -
+                 Schedule_Time_Values_Used + daily->TV_Count)) {
+        return false;
+    }
+    Schedule_Daily_Release(daily);
+    if (count == 0) {
+        return true;
+    }
+    daily->Time_Values = &Schedule_Time_Values[Schedule_Time_Values_Used];
+    Schedule_Time_Values_Used += count;
+    daily->TV_Count = count;
+    for (i = 0; i < count; i++) {
+        tv.Time_Key = datetime_time_key(&value->Time_Values[i].Time);
+        tv.Tag = value->Time_Values[i].Value.tag;
+        tv.Value = value->Time_Values[i].Value.type;
+        if (Schedule_Time_Key_Mask(tv.Time_Key) != UINT32_MAX) {
+            daily->Wildcard = true;
+        }
+        /* insertion sort, which keeps the order of the same times */
+        j = i;
+        while ((j > 0) && (daily->Time_Values[j - 1].Time_Key > tv.Time_Key)) {
+            daily->Time_Values[j] = daily->Time_Values[j - 1];
+            j--;
+        }
+        daily->Time_Values[j] = tv;
+    }
+
+    return true;
+}
+
 /**
  * @brief Get the Weekly Schedule for a given object instance
  * @param object_instance - object-instance number of the object
  * @param array_index - index of the Weekly Schedule to get 0 to 6
- * @return pointer to the Weekly Schedule, or NULL if not found
+ * @return pointer to a read-only copy of the Weekly Schedule, which is
+ *  valid until the next call, or NULL if not found
+ * @deprecated Use Schedule_Weekly_Schedule_Get() instead, and
+ *  Schedule_Weekly_Schedule_Set() to change a day.
  */
-BACNET_DAILY_SCHEDULE *
+const BACNET_DAILY_SCHEDULE *
 Schedule_Weekly_Schedule(uint32_t object_instance, unsigned array_index)
+{
+    if (Schedule_Weekly_Schedule_Get(
+            object_instance, array_index, &Schedule_Daily_Copy)) {
+        return &Schedule_Daily_Copy;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get the Weekly Schedule for a given object instance
+ * @param object_instance - object-instance number of the object
+ * @param array_index - index of the Weekly Schedule to get 0 to 6
+ * @param value - the time values of the day, sorted by time
+ * @return true if the Weekly Schedule was found, and false if not
+ */
+bool Schedule_Weekly_Schedule_Get(
+    uint32_t object_instance,
+    unsigned array_index,
+    BACNET_DAILY_SCHEDULE *value)
 {
     SCHEDULE_DESCR *pObject;
 
     pObject = Schedule_Object(object_instance);
-    if (pObject && (array_index < BACNET_WEEKLY_SCHEDULE_SIZE)) {
-        return &pObject->Weekly_Schedule[array_index];
+    if (pObject && value && (array_index < BACNET_WEEKLY_SCHEDULE_SIZE)) {
+        Schedule_Daily_Get(&pObject->Weekly_Schedule[array_index], value);
+        return true;
     }
 
-    return NULL;
+    return false;
 }
 
 /**
@@ -317,7 +492,8 @@ Schedule_Weekly_Schedule(uint32_t object_instance, unsigned array_index)
  * @param object_instance - object-instance number of the object
  * @param array_index - index of the Weekly Schedule to set 0 to 6
  * @param value - pointer to the Weekly Schedule to set
- * @return true if the Weekly Schedule was set, and false if not
+ * @return true if the Weekly Schedule was set, and false if not, or if
+ *  there are too few free time values in the pool
  */
 bool Schedule_Weekly_Schedule_Set(
     uint32_t object_instance,
@@ -327,16 +503,26 @@ bool Schedule_Weekly_Schedule_Set(
     SCHEDULE_DESCR *pObject;
 
     pObject = Schedule_Object(object_instance);
-    if (pObject && (array_index < BACNET_WEEKLY_SCHEDULE_SIZE)) {
-        memcpy(
-            &pObject->Weekly_Schedule[array_index], value,
-            sizeof(pObject->Weekly_Schedule[array_index]));
-        return true;
+    if (pObject && value && (array_index < BACNET_WEEKLY_SCHEDULE_SIZE)) {
+        if (Schedule_Daily_Set(&pObject->Weekly_Schedule[array_index], value)) {
+            pObject->Transition_Valid = false;
+            return true;
+        }
     }
 
     return false;
 }
 
+/**
+ * @brief Get the number of time values that are free in the pool that
+ *  the Weekly_Schedule of all of the Schedule objects share
+ * @return number of time values
+ */
+size_t Schedule_Time_Values_Free(void)
+{
+    return BACNET_SCHEDULE_TIME_VALUES_POOL_SIZE - Schedule_Time_Values_Used;
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -350,8 +536,11 @@ bool Schedule_Weekly_Schedule_Set(
 static int Schedule_Weekly_Schedule_Encode(
     uint32_t object_instance, BACNET_ARRAY_INDEX array_index, uint8_t *apdu)
 {
-    int apdu_len;
+    int apdu_len = 0, len;
     SCHEDULE_DESCR *pObject;
+    const SCHEDULE_DAILY *daily;
+    BACNET_TIME_VALUE value;
+    uint16_t i;
 
     if (array_index >= BACNET_WEEKLY_SCHEDULE_SIZE) {
         return BACNET_STATUS_ERROR;
@@ -360,9 +549,31 @@ static int Schedule_Weekly_Schedule_Encode(
     if (!pObject) {
         return BACNET_STATUS_ERROR;
     }
-
-    apdu_len = bacnet_dailyschedule_context_encode(
-        apdu, 0, &pObject->Weekly_Schedule[array_index]);
+    daily = &pObject->Weekly_Schedule[array_index];
+    /* day-schedule [0] SEQUENCE OF BACnetTimeValue */
+    len = encode_opening_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    for (i = 0; i < daily->TV_Count; i++) {
+        /* encode only non-null values (NULL,00:00:00.00) */
+        if ((daily->Time_Values[i].Tag == BACNET_APPLICATION_TAG_NULL) &&
+            (daily->Time_Values[i].Time_Key == 0)) {
+            continue;
+        }
+        Schedule_Time_Value_Get(&daily->Time_Values[i], &value);
+        len = bacnet_time_value_encode(apdu, &value);
+        if (len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+    len = encode_closing_tag(apdu, 0);
+    apdu_len += len;
 
     return apdu_len;
 }
@@ -408,6 +619,7 @@ bool Schedule_Exception_Schedule_Set(
         memcpy(
             &pObject->Exception_Schedule[array_index], value,
             sizeof(BACNET_SPECIAL_EVENT));
+        pObject->Transition_Valid = false;
         return true;
     }
 
@@ -462,6 +674,7 @@ bool Schedule_Effective_Period_Set(
     if (pObject) {
         datetime_copy_date(&pObject->Start_Date, start_date);
         datetime_copy_date(&pObject->End_Date, end_date);
+        pObject->Transition_Valid = false;
         return true;
     }
 
@@ -713,7 +926,6 @@ static BACNET_ERROR_CODE Schedule_Weekly_Schedule_Element_Write(
 {
     BACNET_ERROR_CODE error_code = ERROR_CODE_UNKNOWN_OBJECT;
     BACNET_DAILY_SCHEDULE daily_schedule = { 0 };
-    size_t tv, tv_size;
     int len = 0;
     SCHEDULE_DESCR *pObject;
 
@@ -729,18 +941,14 @@ static BACNET_ERROR_CODE Schedule_Weekly_Schedule_Element_Write(
             len = bacnet_dailyschedule_context_decode(
                 application_data, application_data_len, 0, &daily_schedule);
             if (len > 0) {
-                tv_size =
-                    min(daily_schedule.TV_Count,
-                        BACNET_DAILY_SCHEDULE_TIME_VALUES_SIZE);
-                for (tv = 0; tv < tv_size; tv++) {
-                    /* copy the time value */
-                    memcpy(
-                        &pObject->Weekly_Schedule[array_index].Time_Values[tv],
-                        &daily_schedule.Time_Values[tv],
-                        sizeof(BACNET_TIME_VALUE));
+                if (Schedule_Daily_Set(
+                        &pObject->Weekly_Schedule[array_index],
+                        &daily_schedule)) {
+                    pObject->Transition_Valid = false;
+                    error_code = ERROR_CODE_SUCCESS;
+                } else {
+                    error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
                 }
-                pObject->Weekly_Schedule[array_index].TV_Count = tv_size;
-                error_code = ERROR_CODE_SUCCESS;
             } else {
                 error_code = ERROR_CODE_INVALID_DATA_TYPE;
             }
@@ -811,6 +1019,7 @@ static BACNET_ERROR_CODE Schedule_Exception_Schedule_Element_Write(
             if (len > 0) {
                 bacnet_special_event_copy(
                     &pObject->Exception_Schedule[array_index], &special_event);
+                pObject->Transition_Valid = false;
                 error_code = ERROR_CODE_SUCCESS;
             } else {
                 error_code = ERROR_CODE_INVALID_DATA_TYPE;
@@ -996,6 +1205,7 @@ bool Schedule_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 datetime_copy_date(
                     &Schedule_Descr[object_index].End_Date,
                     &value.type.Date_Range.enddate);
+                Schedule_Descr[object_index].Transition_Valid = false;
             }
             break;
 #if BACNET_EXCEPTION_SCHEDULE_SIZE
@@ -1062,11 +1272,16 @@ void Schedule_Recalculate_PV(
     SCHEDULE_DESCR *desc, BACNET_WEEKDAY wday, const BACNET_TIME *time)
 {
     int i, current, diff;
-    BACNET_TIME *tmptime;
+    const SCHEDULE_DAILY *daily;
+    BACNET_TIME_VALUE value;
+    uint32_t time_key, time_mask, tv_key, tv_mask;
+    uint32_t current_key = 0, current_mask = 0;
+    uint16_t low, high, middle;
 
     if (!desc || !time || (wday < 1) || (wday > 7)) {
         return;
     }
+    desc->Transition_Valid = false;
     desc->Present_Value.tag = BACNET_APPLICATION_TAG_NULL;
 
     /* for future development, here should be the loop for Exception Schedule */
@@ -1074,30 +1289,43 @@ void Schedule_Recalculate_PV(
     /*  Note to developers: please ping Edward at info@connect-ex.com
         for a more complete schedule object implementation. */
     current = -1;
-    tmptime = NULL;
-    for (i = 0; i < desc->Weekly_Schedule[wday - 1].TV_Count; i++) {
-        diff = datetime_wildcard_compare_time(
-            time, &desc->Weekly_Schedule[wday - 1].Time_Values[i].Time);
-        if (diff >= 0) {
-            if (tmptime == NULL) {
-                tmptime = &desc->Weekly_Schedule[wday - 1].Time_Values[i].Time;
-                current = i;
+    time_key = datetime_time_key(time);
+    time_mask = datetime_time_key_mask(time);
+    daily = &desc->Weekly_Schedule[wday - 1];
+    if (!daily->Wildcard && (time_mask == UINT32_MAX)) {
+        /* the last of the sorted times that is not after the time */
+        low = 0;
+        high = daily->TV_Count;
+        while (low < high) {
+            middle = low + (high - low) / 2;
+            if (daily->Time_Values[middle].Time_Key <= time_key) {
+                low = middle + 1;
             } else {
-                diff = datetime_wildcard_compare_time(
-                    &desc->Weekly_Schedule[wday - 1].Time_Values[i].Time,
-                    tmptime);
-                if (diff >= 0) {
-                    tmptime =
-                        &desc->Weekly_Schedule[wday - 1].Time_Values[i].Time;
+                high = middle;
+            }
+        }
+        current = (int)low - 1;
+    } else {
+        for (i = 0; i < daily->TV_Count; i++) {
+            tv_key = daily->Time_Values[i].Time_Key;
+            tv_mask = Schedule_Time_Key_Mask(tv_key);
+            diff = datetime_key_wildcard_compare32(
+                time_key, time_mask, tv_key, tv_mask);
+            if (diff >= 0) {
+                if ((current < 0) ||
+                    (datetime_key_wildcard_compare32(
+                         tv_key, tv_mask, current_key, current_mask) >= 0)) {
+                    current_key = tv_key;
+                    current_mask = tv_mask;
                     current = i;
                 }
             }
         }
     }
     if (current >= 0) {
+        Schedule_Time_Value_Get(&daily->Time_Values[current], &value);
         bacnet_primitive_to_application_data_value(
-            &desc->Present_Value,
-            &desc->Weekly_Schedule[wday - 1].Time_Values[current].Value);
+            &desc->Present_Value, &value.Value);
     } else {
         memcpy(
             &desc->Present_Value, &desc->Schedule_Default,
@@ -1105,8 +1333,110 @@ void Schedule_Recalculate_PV(
     }
 }
 
+/**
+ * @brief Find the next time of the day at which the Present Value of the
+ *  Schedule object may change
+ * @param desc - schedule descriptor
+ * @param wday - day of the week
+ * @param time - time of the day
+ * @param next - the next time of the day, or the last moment of the day
+ * @return true if the next time is known, false if the times of the
+ *  day use wildcards
+ */
+static bool Schedule_Next_Transition(
+    const SCHEDULE_DESCR *desc,
+    BACNET_WEEKDAY wday,
+    const BACNET_TIME *time,
+    BACNET_TIME *next)
+{
+    const SCHEDULE_DAILY *daily;
+    BACNET_TIME_VALUE value;
+    uint32_t time_key, next_key;
+    uint16_t low, high, middle;
+
+    daily = &desc->Weekly_Schedule[wday - 1];
+    if (daily->Wildcard) {
+        /* a wildcard time may match at any time */
+        return false;
+    }
+    datetime_set_time(next, 23, 59, 59, 99);
+    time_key = datetime_time_key(time);
+    next_key = datetime_time_key(next);
+    /* the first of the sorted times that is after the time */
+    low = 0;
+    high = daily->TV_Count;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (daily->Time_Values[middle].Time_Key <= time_key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if ((low < daily->TV_Count) &&
+        (daily->Time_Values[low].Time_Key < next_key)) {
+        Schedule_Time_Value_Get(&daily->Time_Values[low], &value);
+        datetime_copy_time(next, &value.Time);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Update the Present Value of the Schedule object, unless it
+ *  is known to hold until a later time of the same day
+ * @param desc - schedule descriptor
+ * @param bdatetime - the current date and time
+ * @return true if the Present Value was recalculated
+ */
+bool Schedule_Update_PV(SCHEDULE_DESCR *desc, const BACNET_DATE_TIME *bdatetime)
+{
+    BACNET_WEEKDAY wday;
+
+    if (!desc || !bdatetime) {
+        return false;
+    }
+    if (desc->Transition_Valid &&
+        datetime_date_same(&bdatetime->date, &desc->Transition_Date) &&
+        (datetime_compare_time(&bdatetime->time, &desc->Transition_Start) >=
+         0) &&
+        (datetime_compare_time(&bdatetime->time, &desc->Transition_Next) <
+         0)) {
+        return false;
+    }
+    wday = bdatetime->date.wday;
+    Schedule_Recalculate_PV(desc, wday, &bdatetime->time);
+    if ((wday >= 1) && (wday <= 7) &&
+        Schedule_Next_Transition(
+            desc, wday, &bdatetime->time, &desc->Transition_Next)) {
+        datetime_copy_date(&desc->Transition_Date, &bdatetime->date);
+        datetime_copy_time(&desc->Transition_Start, &bdatetime->time);
+        desc->Transition_Valid = true;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Have the next Schedule_Timer() recalculate the Present Value,
+ *  for example after the schedule was changed through the pointer from
+ *  Schedule_Exception_Schedule()
+ * @param object_instance - object-instance number of the object
+ */
+void Schedule_Transition_Invalidate(uint32_t object_instance)
+{
+    SCHEDULE_DESCR *pObject;
+
+    pObject = Schedule_Object(object_instance);
+    if (pObject) {
+        pObject->Transition_Valid = false;
+    }
+}
+
 /**
  * @brief Updates the Present Value of the Schedule object
+ * @note The Present Value is only recalculated at the next time of the
+ *  day it may change, or after the schedule was changed.
  * @param  object_instance - object-instance number of the object
  * @param milliseconds - Unused parameter
  */
@@ -1119,6 +1449,6 @@ void Schedule_Timer(uint32_t object_instance, uint16_t milliseconds)
     pObject = Schedule_Object(object_instance);
     if (pObject) {
         Device_getCurrentDateTime(&bdatetime);
-        Schedule_Recalculate_PV(pObject, bdatetime.date.wday, &bdatetime.time);
+        Schedule_Update_PV(pObject, &bdatetime);
     }
 }
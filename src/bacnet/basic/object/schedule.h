@@ -36,12 +36,31 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/* a time and value of a day of the Weekly_Schedule, in two thirds of
+   the memory of a BACNET_TIME_VALUE */
+typedef struct schedule_time_value {
+    uint32_t Time_Key; /* the time, packed by datetime_time_key() */
+    uint8_t Tag; /* application tag of the value */
+    BACNET_PRIMITIVE_DATA_TYPE Value;
+} SCHEDULE_TIME_VALUE;
+
+/* the time values of a day, taken from a pool that all of the Schedule
+   objects share, and sorted by their time from the earliest to the
+   latest, with the order of writing kept for the same times */
+typedef struct schedule_daily {
+    SCHEDULE_TIME_VALUE *Time_Values;
+    uint16_t TV_Count;
+    /* true if a time has a wildcard, so that it cannot be found with a
+       binary search */
+    bool Wildcard;
+} SCHEDULE_DAILY;
+
 typedef struct schedule {
     /* Effective Period: Start and End Date */
     BACNET_DATE Start_Date;
     BACNET_DATE End_Date;
     /* Properties concerning Present Value */
-    BACNET_DAILY_SCHEDULE Weekly_Schedule[BACNET_WEEKLY_SCHEDULE_SIZE];
+    SCHEDULE_DAILY Weekly_Schedule[BACNET_WEEKLY_SCHEDULE_SIZE];
 #if BACNET_EXCEPTION_SCHEDULE_SIZE
     BACNET_SPECIAL_EVENT Exception_Schedule[BACNET_EXCEPTION_SCHEDULE_SIZE];
 #endif
@@ -58,6 +77,12 @@ typedef struct schedule {
     uint8_t obj_prop_ref_cnt; /* actual number of obj_prop references */
     uint8_t Priority_For_Writing; /* (1..16) */
     bool Out_Of_Service;
+    /* Present_Value holds from Transition_Start until Transition_Next
+       on Transition_Date, and need not be recalculated in between */
+    bool Transition_Valid;
+    BACNET_DATE Transition_Date;
+    BACNET_TIME Transition_Start;
+    BACNET_TIME Transition_Next;
 } SCHEDULE_DESCR;
 
 BACNET_STACK_EXPORT
@@ -87,14 +112,24 @@ void Schedule_Out_Of_Service_Set(uint32_t object_instance, bool value);
 BACNET_STACK_EXPORT
 bool Schedule_Out_Of_Service(uint32_t object_instance);
 
+/* the days are kept in a pool of BACNET_SCHEDULE_TIME_VALUES_POOL_SIZE
+   time values, so this gives a copy, which cannot be changed */
+BACNET_STACK_DEPRECATED("Use Schedule_Weekly_Schedule_Get() instead")
 BACNET_STACK_EXPORT
-BACNET_DAILY_SCHEDULE *
+const BACNET_DAILY_SCHEDULE *
 Schedule_Weekly_Schedule(uint32_t object_instance, unsigned array_index);
 BACNET_STACK_EXPORT
+bool Schedule_Weekly_Schedule_Get(
+    uint32_t object_instance,
+    unsigned array_index,
+    BACNET_DAILY_SCHEDULE *value);
+BACNET_STACK_EXPORT
 bool Schedule_Weekly_Schedule_Set(
     uint32_t object_instance,
     unsigned array_index,
     const BACNET_DAILY_SCHEDULE *value);
+BACNET_STACK_EXPORT
+size_t Schedule_Time_Values_Free(void);
 
 BACNET_STACK_EXPORT
 BACNET_SPECIAL_EVENT *
@@ -146,6 +181,11 @@ bool Schedule_In_Effective_Period(
 BACNET_STACK_EXPORT
 void Schedule_Recalculate_PV(
     SCHEDULE_DESCR *desc, BACNET_WEEKDAY wday, const BACNET_TIME *time);
+BACNET_STACK_EXPORT
+bool Schedule_Update_PV(
+    SCHEDULE_DESCR *desc, const BACNET_DATE_TIME *bdatetime);
+BACNET_STACK_EXPORT
+void Schedule_Transition_Invalidate(uint32_t object_instance);
 
 BACNET_STACK_EXPORT
 void Schedule_Timer(uint32_t object_instance, uint16_t milliseconds);
@@ -21,20 +21,26 @@
 #include "bacnet/proplist.h"
 #include "bacnet/rp.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/string_pool.h"
 /* BACnet Stack Objects */
 #include "bacnet/basic/object/device.h"
 /* me! */
 #include "structured_view.h"
 
 struct object_data {
-    char *Object_Name;
-    char *Description;
+    const char *Object_Name;
+    const char *Description;
     BACNET_NODE_TYPE Node_Type;
-    char *Node_Subtype;
+    const char *Node_Subtype;
     void *Context;
     OS_Keylist Subordinate_List;
     BACNET_RELATIONSHIP Default_Subordinate_Relationship;
     BACNET_DEVICE_OBJECT_REFERENCE Represents;
+    /* hierarchy index: Subordinate_List elements that are local
+       Structured View objects, and the Structured Views that list us */
+    OS_Keylist Children;
+    OS_Keylist Parents;
+    unsigned Visit;
 };
 
 /* Key List for storing the object data sorted by instance number  */
@@ -44,6 +50,15 @@ static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
 #else
 #define Object_List (Object_Lists[0])
 #endif
+/* the hierarchy index is rebuilt after a Subordinate_List change */
+static bool Hierarchy_Valids[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Hierarchy_Valid (Hierarchy_Valids[Routed_Device_Object_Index()])
+#else
+#define Hierarchy_Valid (Hierarchy_Valids[0])
+#endif
+/* marks the Structured Views visited by a subtree enumeration */
+static unsigned Hierarchy_Visit;
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Properties_Required[] = {
@@ -237,8 +252,8 @@ bool Structured_View_Name_Set(uint32_t object_instance, const char *new_name)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         status = true;
-        free(pObject->Object_Name);
-        pObject->Object_Name = bacnet_strdup(new_name);
+        String_Pool_Release(pObject->Object_Name);
+        pObject->Object_Name = String_Pool_Intern(new_name);
     }
 
     return status;
@@ -303,8 +318,8 @@ bool Structured_View_Description_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         status = true;
-        free(pObject->Description);
-        pObject->Description = bacnet_strdup(new_name);
+        String_Pool_Release(pObject->Description);
+        pObject->Description = String_Pool_Intern(new_name);
     }
 
     return status;
@@ -386,8 +401,8 @@ bool Structured_View_Node_Subtype_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         status = true;
-        free(pObject->Node_Subtype);
-        pObject->Node_Subtype = bacnet_strdup(new_name);
+        String_Pool_Release(pObject->Node_Subtype);
+        pObject->Node_Subtype = String_Pool_Intern(new_name);
     }
 
     return status;
@@ -425,6 +440,7 @@ Subordinate_List_Element_Add(OS_Keylist list, KEY key)
 
     element = calloc(1, sizeof(BACNET_SUBORDINATE_DATA));
     if (element) {
+        Hierarchy_Valid = false;
         element->next = NULL;
         index = Keylist_Data_Add(list, key, element);
         if (index < 0) {
@@ -446,6 +462,7 @@ static void Subordinate_List_Element_Remove(OS_Keylist list, KEY key)
 
     element = Keylist_Data_Delete(list, key);
     if (element) {
+        Hierarchy_Valid = false;
         if (element->Annotation) {
             free(element->Annotation);
         }
@@ -719,6 +736,7 @@ static BACNET_ERROR_CODE Structured_View_Subordinate_List_Member_Write(
             if (len > 0) {
                 element = Subordinate_List_Element(pObject, array_index);
                 if (element) {
+                    Hierarchy_Valid = false;
                     element->Device_Instance =
                         reference.deviceIdentifier.instance;
                     element->Object_Type = reference.objectIdentifier.type;
@@ -1488,15 +1506,23 @@ static bool Structured_View_Object_Name_Write(
     bool status = false; /* return value */
     struct object_data *pObject;
     char *utf8_name = NULL;
+    const char *name = NULL;
 
     pObject = Keylist_Data(Object_List, wp_data->object_instance);
     if (pObject) {
         utf8_name =
             write_property_characterstring_utf8_strdup(wp_data, cstring);
         if (utf8_name) {
-            free(pObject->Object_Name);
-            pObject->Object_Name = utf8_name;
-            status = true;
+            name = String_Pool_Intern(utf8_name);
+            free(utf8_name);
+            if (name) {
+                String_Pool_Release(pObject->Object_Name);
+                pObject->Object_Name = name;
+                status = true;
+            } else {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            }
         }
     } else {
         wp_data->error_class = ERROR_CLASS_PROPERTY;
@@ -1520,15 +1546,23 @@ static bool Structured_View_Description_Write(
     bool status = false; /* return value */
     struct object_data *pObject;
     char *utf8_name = NULL;
+    const char *name = NULL;
 
     pObject = Keylist_Data(Object_List, wp_data->object_instance);
     if (pObject) {
         utf8_name =
             write_property_characterstring_utf8_strdup(wp_data, cstring);
         if (utf8_name) {
-            free(pObject->Description);
-            pObject->Description = utf8_name;
-            status = true;
+            name = String_Pool_Intern(utf8_name);
+            free(utf8_name);
+            if (name) {
+                String_Pool_Release(pObject->Description);
+                pObject->Description = name;
+                status = true;
+            } else {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            }
         }
     } else {
         wp_data->error_class = ERROR_CLASS_PROPERTY;
@@ -1552,15 +1586,23 @@ static bool Structured_View_Node_Subtype_Write(
     bool status = false; /* return value */
     struct object_data *pObject;
     char *utf8_name = NULL;
+    const char *name = NULL;
 
     pObject = Keylist_Data(Object_List, wp_data->object_instance);
     if (pObject) {
         utf8_name =
             write_property_characterstring_utf8_strdup(wp_data, cstring);
         if (utf8_name) {
-            free(pObject->Node_Subtype);
-            pObject->Node_Subtype = utf8_name;
-            status = true;
+            name = String_Pool_Intern(utf8_name);
+            free(utf8_name);
+            if (name) {
+                String_Pool_Release(pObject->Node_Subtype);
+                pObject->Node_Subtype = name;
+                status = true;
+            } else {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            }
         }
     } else {
         wp_data->error_class = ERROR_CLASS_PROPERTY;
@@ -1759,6 +1801,271 @@ void Structured_View_Context_Set(uint32_t object_instance, void *context)
     }
 }
 
+/**
+ * @brief Determine if a Subordinate_List element is a Structured View
+ *  object in this device
+ * @param element [in] the Subordinate_List element
+ * @return the object data of the Structured View, or NULL
+ */
+static struct object_data *
+Hierarchy_Child_Object(const BACNET_SUBORDINATE_DATA *element)
+{
+    if (!element || (element->Object_Type != OBJECT_STRUCTURED_VIEW)) {
+        return NULL;
+    }
+    if ((element->Device_Instance < BACNET_MAX_INSTANCE) &&
+        (element->Device_Instance != Device_Object_Instance_Number())) {
+        return NULL;
+    }
+
+    return Keylist_Data(Object_List, element->Object_Instance);
+}
+
+/**
+ * @brief Empty the hierarchy index of a Structured View object
+ * @param pObject [in] the object data
+ */
+static void Hierarchy_Object_Clear(struct object_data *pObject)
+{
+    if (!pObject->Children) {
+        pObject->Children = Keylist_Create();
+    }
+    if (!pObject->Parents) {
+        pObject->Parents = Keylist_Create();
+    }
+    while (Keylist_Count(pObject->Children) > 0) {
+        (void)Keylist_Data_Pop(pObject->Children);
+    }
+    while (Keylist_Count(pObject->Parents) > 0) {
+        (void)Keylist_Data_Pop(pObject->Parents);
+    }
+}
+
+/**
+ * @brief Rebuild the parent and child index of the Structured View
+ *  objects from their Subordinate_List. The index is rebuilt on demand
+ *  after a Subordinate_List change made through this API; call this after
+ *  changing the elements returned by Structured_View_Subordinate_List().
+ */
+void Structured_View_Hierarchy_Rebuild(void)
+{
+    struct object_data *pObject, *pChild;
+    BACNET_SUBORDINATE_DATA *element;
+    int index, count, element_index, element_count;
+    KEY instance = 0, key = 0;
+
+    count = Keylist_Count(Object_List);
+    for (index = 0; index < count; index++) {
+        pObject = Keylist_Data_Index(Object_List, index);
+        Hierarchy_Object_Clear(pObject);
+    }
+    for (index = 0; index < count; index++) {
+        pObject = Keylist_Data_Index(Object_List, index);
+        Keylist_Index_Key(Object_List, index, &instance);
+        element_count = Keylist_Count(pObject->Subordinate_List);
+        for (element_index = 0; element_index < element_count;
+             element_index++) {
+            element =
+                Keylist_Data_Index(pObject->Subordinate_List, element_index);
+            pChild = Hierarchy_Child_Object(element);
+            if (!pChild) {
+                continue;
+            }
+            Keylist_Index_Key(pObject->Subordinate_List, element_index, &key);
+            /* children keep the Subordinate_List order */
+            Keylist_Data_Add(pObject->Children, key, element);
+            if (!Keylist_Data(pChild->Parents, instance)) {
+                Keylist_Data_Add(pChild->Parents, instance, pObject);
+            }
+        }
+    }
+    Hierarchy_Valid = true;
+}
+
+/**
+ * @brief For a given object instance-number, returns the object data
+ *  with an up to date hierarchy index
+ * @param object_instance [in] object-instance number of the object
+ * @return object data, or NULL if not found
+ */
+static struct object_data *Hierarchy_Object(uint32_t object_instance)
+{
+    if (!Hierarchy_Valid) {
+        Structured_View_Hierarchy_Rebuild();
+    }
+
+    return Keylist_Data(Object_List, object_instance);
+}
+
+/**
+ * @brief For a given object instance-number, returns the number of
+ *  Structured View objects of this device in its Subordinate_List
+ * @param object_instance [in] object-instance number of the object
+ * @return number of child Structured View objects
+ */
+unsigned Structured_View_Hierarchy_Child_Count(uint32_t object_instance)
+{
+    struct object_data *pObject;
+
+    pObject = Hierarchy_Object(object_instance);
+    if (pObject) {
+        return Keylist_Count(pObject->Children);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief For a given object instance-number, returns a child Structured
+ *  View object, in the order of the Subordinate_List
+ * @param object_instance [in] object-instance number of the object
+ * @param index [in] 0..N-1 index of the child
+ * @return object-instance number of the child, or BACNET_MAX_INSTANCE
+ */
+uint32_t
+Structured_View_Hierarchy_Child(uint32_t object_instance, unsigned index)
+{
+    struct object_data *pObject;
+    BACNET_SUBORDINATE_DATA *element;
+
+    pObject = Hierarchy_Object(object_instance);
+    if (pObject) {
+        element = Keylist_Data_Index(pObject->Children, index);
+        if (element) {
+            return element->Object_Instance;
+        }
+    }
+
+    return BACNET_MAX_INSTANCE;
+}
+
+/**
+ * @brief For a given object instance-number, returns the number of
+ *  Structured View objects that have it in their Subordinate_List
+ * @param object_instance [in] object-instance number of the object
+ * @return number of parent Structured View objects
+ */
+unsigned Structured_View_Hierarchy_Parent_Count(uint32_t object_instance)
+{
+    struct object_data *pObject;
+
+    pObject = Hierarchy_Object(object_instance);
+    if (pObject) {
+        return Keylist_Count(pObject->Parents);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief For a given object instance-number, returns a parent Structured
+ *  View object, in the order of the instance numbers
+ * @param object_instance [in] object-instance number of the object
+ * @param index [in] 0..N-1 index of the parent
+ * @return object-instance number of the parent, or BACNET_MAX_INSTANCE
+ */
+uint32_t
+Structured_View_Hierarchy_Parent(uint32_t object_instance, unsigned index)
+{
+    struct object_data *pObject;
+    KEY key = BACNET_MAX_INSTANCE;
+
+    pObject = Hierarchy_Object(object_instance);
+    if (pObject) {
+        if (!Keylist_Index_Key(pObject->Parents, index, &key)) {
+            key = BACNET_MAX_INSTANCE;
+        }
+    }
+
+    return key;
+}
+
+/**
+ * @brief Visit a Structured View object and its unvisited children
+ * @param pObject [in] the object data
+ * @param object_instance [in] object-instance number of the object
+ * @param parent_instance [in] object-instance number of the parent
+ * @param depth [in] number of levels below the root
+ * @param callback [in] function called for each object
+ * @param context [in] context given to the callback
+ * @param count [in,out] number of objects visited
+ * @return false if the callback stopped the enumeration
+ */
+static bool Hierarchy_Subtree_Visit(
+    struct object_data *pObject,
+    uint32_t object_instance,
+    uint32_t parent_instance,
+    unsigned depth,
+    structured_view_subtree_callback callback,
+    void *context,
+    unsigned *count)
+{
+    struct object_data *pChild;
+    BACNET_SUBORDINATE_DATA *element;
+    int index, child_count;
+
+    pObject->Visit = Hierarchy_Visit;
+    (*count)++;
+    if (callback &&
+        !callback(object_instance, parent_instance, depth, context)) {
+        return false;
+    }
+    child_count = Keylist_Count(pObject->Children);
+    for (index = 0; index < child_count; index++) {
+        element = Keylist_Data_Index(pObject->Children, index);
+        pChild = Keylist_Data(Object_List, element->Object_Instance);
+        if (!pChild || (pChild->Visit == Hierarchy_Visit)) {
+            /* already listed elsewhere in the subtree, or a cycle */
+            continue;
+        }
+        if (!Hierarchy_Subtree_Visit(
+                pChild, element->Object_Instance, object_instance, depth + 1,
+                callback, context, count)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Enumerate the Structured View objects of a subtree of the
+ *  hierarchy, depth first in the order of the Subordinate_List. Each
+ *  object is enumerated once, even when it is referenced by more
+ *  than one Structured View of the subtree.
+ * @param object_instance [in] object-instance number of the root
+ * @param callback [in] function called for each object, or NULL to count
+ * @param context [in] context given to the callback
+ * @return number of Structured View objects enumerated
+ */
+unsigned Structured_View_Hierarchy_Subtree(
+    uint32_t object_instance,
+    structured_view_subtree_callback callback,
+    void *context)
+{
+    struct object_data *pObject, *pVisited;
+    unsigned count = 0;
+    int index;
+
+    pObject = Hierarchy_Object(object_instance);
+    if (pObject) {
+        Hierarchy_Visit++;
+        if (Hierarchy_Visit == 0) {
+            /* the visit counter wrapped: forget the old marks */
+            for (index = 0; index < Keylist_Count(Object_List); index++) {
+                pVisited = Keylist_Data_Index(Object_List, index);
+                pVisited->Visit = 0;
+            }
+            Hierarchy_Visit = 1;
+        }
+        (void)Hierarchy_Subtree_Visit(
+            pObject, object_instance, BACNET_MAX_INSTANCE, 0, callback,
+            context, &count);
+    }
+
+    return count;
+}
+
 /**
  * Creates a Structured View object
  * @param object_instance - object-instance number of the object
@@ -1799,12 +2106,19 @@ uint32_t Structured_View_Create(uint32_t object_instance)
         pObject->Represents.objectIdentifier.type = OBJECT_DEVICE;
         pObject->Represents.objectIdentifier.instance = BACNET_MAX_INSTANCE;
         pObject->Node_Type = BACNET_NODE_UNKNOWN;
+        pObject->Children = Keylist_Create();
+        pObject->Parents = Keylist_Create();
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
+            Keylist_Delete(pObject->Children);
+            Keylist_Delete(pObject->Parents);
+            Keylist_Delete(pObject->Subordinate_List);
             free(pObject);
             return BACNET_MAX_INSTANCE;
         }
+        /* other Structured Views may already list this object */
+        Hierarchy_Valid = false;
     }
 
     return object_instance;
@@ -1817,11 +2131,13 @@ uint32_t Structured_View_Create(uint32_t object_instance)
 static void Structured_View_Object_Free(struct object_data *pObject)
 {
     if (pObject) {
-        free(pObject->Description);
-        free(pObject->Node_Subtype);
-        free(pObject->Object_Name);
+        String_Pool_Release(pObject->Description);
+        String_Pool_Release(pObject->Node_Subtype);
+        String_Pool_Release(pObject->Object_Name);
         Subordinate_List_Purge(pObject);
         Keylist_Delete(pObject->Subordinate_List);
+        Keylist_Delete(pObject->Children);
+        Keylist_Delete(pObject->Parents);
         free(pObject);
     }
 }
@@ -1839,6 +2155,7 @@ bool Structured_View_Delete(uint32_t object_instance)
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
         Structured_View_Object_Free(pObject);
+        Hierarchy_Valid = false;
         status = true;
     }
 
@@ -1868,6 +2185,7 @@ void Structured_View_Cleanup(void)
             Keylist_Delete(Object_List);
             Object_List = NULL;
         }
+        Hierarchy_Valid = false;
     }
 
 #ifdef BAC_ROUTING
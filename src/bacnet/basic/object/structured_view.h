@@ -35,6 +35,21 @@ typedef struct BACnetSubordinateData {
     struct BACnetSubordinateData *next;
 } BACNET_SUBORDINATE_DATA;
 
+/**
+ * @brief Callback for each Structured View object of a hierarchy subtree
+ * @param object_instance [in] the Structured View object instance
+ * @param parent_instance [in] the Structured View that references it,
+ *  or BACNET_MAX_INSTANCE for the root of the subtree
+ * @param depth [in] number of levels below the root of the subtree
+ * @param context [in] context given to the enumeration
+ * @return true to continue the enumeration, false to stop it
+ */
+typedef bool (*structured_view_subtree_callback)(
+    uint32_t object_instance,
+    uint32_t parent_instance,
+    unsigned depth,
+    void *context);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -149,6 +164,24 @@ void *Structured_View_Context_Get(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Structured_View_Context_Set(uint32_t object_instance, void *context);
 
+BACNET_STACK_EXPORT
+void Structured_View_Hierarchy_Rebuild(void);
+BACNET_STACK_EXPORT
+unsigned Structured_View_Hierarchy_Child_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t
+Structured_View_Hierarchy_Child(uint32_t object_instance, unsigned index);
+BACNET_STACK_EXPORT
+unsigned Structured_View_Hierarchy_Parent_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t
+Structured_View_Hierarchy_Parent(uint32_t object_instance, unsigned index);
+BACNET_STACK_EXPORT
+unsigned Structured_View_Hierarchy_Subtree(
+    uint32_t object_instance,
+    structured_view_subtree_callback callback,
+    void *context);
+
 BACNET_STACK_EXPORT
 uint32_t Structured_View_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
@@ -207,11 +207,14 @@ bool Time_Value_Present_Value(uint32_t object_instance, BACNET_TIME *value)
  * @param  value - time value
  */
 static void Time_Value_Present_Value_COV_Detect(
-    struct object_data *pObject, const BACNET_TIME *value)
+    uint32_t object_instance,
+    struct object_data *pObject,
+    const BACNET_TIME *value)
 {
     if (pObject && value) {
         if (datetime_compare_time(&pObject->Present_Value, value) != 0) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(OBJECT_TIME_VALUE, object_instance);
         }
     }
 }
@@ -234,7 +237,8 @@ bool Time_Value_Present_Value_Set(
     if (pObject) {
         if (!pObject->Out_Of_Service) {
             if (value) {
-                Time_Value_Present_Value_COV_Detect(pObject, value);
+                Time_Value_Present_Value_COV_Detect(
+                    object_instance, pObject, value);
                 datetime_copy_time(&pObject->Present_Value, value);
                 status = true;
             }
@@ -271,7 +275,8 @@ static bool Time_Value_Present_Value_Write(
         (void)priority;
         if (pObject->Write_Enabled) {
             datetime_copy_time(&old_value, &pObject->Present_Value);
-            Time_Value_Present_Value_COV_Detect(pObject, value);
+            Time_Value_Present_Value_COV_Detect(
+                object_instance, pObject, value);
             datetime_copy_time(&pObject->Present_Value, value);
             if (pObject->Out_Of_Service) {
                 /* The physical point that the object represents
@@ -333,6 +338,7 @@ bool Time_Value_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Change_Of_Value = true;
+            cov_change_of_value_notify(OBJECT_TIME_VALUE, object_instance);
         }
         pObject->Out_Of_Service = value;
         status = true;
@@ -47,6 +47,8 @@ static write_property_function Write_Property_Internal_Callback;
 /* Write Property notification callbacks for logging or other purposes */
 static struct timer_write_property_notification
     Write_Property_Notification_Head;
+/* callback for tracking the running timers */
+static timer_active_callback Timer_Active_Callback;
 
 struct object_data {
     uint32_t Present_Value;
@@ -174,6 +176,20 @@ static struct object_data *Object_Data(uint32_t object_instance)
     return Keylist_Data(Object_List, object_instance);
 }
 
+/**
+ * @brief Tells the active callback whether the timer is running
+ * @param  object_instance - object-instance number of the object
+ * @param  pObject - object data of the object
+ */
+static void
+Timer_Active_Update(uint32_t object_instance, const struct object_data *pObject)
+{
+    if (Timer_Active_Callback) {
+        Timer_Active_Callback(
+            object_instance, pObject->Timer_State == TIMER_STATE_RUNNING);
+    }
+}
+
 /**
  * Determines if a given Timer instance is valid
  *
@@ -671,6 +687,9 @@ bool Timer_State_Set(uint32_t object_instance, BACNET_TIMER_STATE value)
         }
     }
 
+    if (pObject) {
+        Timer_Active_Update(object_instance, pObject);
+    }
     return status;
 }
 
@@ -800,6 +819,9 @@ bool Timer_Running_Set(uint32_t object_instance, bool start)
         status = true;
     }
 
+    if (pObject) {
+        Timer_Active_Update(object_instance, pObject);
+    }
     return status;
 }
 
@@ -1165,6 +1187,9 @@ bool Timer_Present_Value_Set(uint32_t object_instance, uint32_t value)
         }
     }
 
+    if (pObject) {
+        Timer_Active_Update(object_instance, pObject);
+    }
     return status;
 }
 
@@ -2137,6 +2162,15 @@ void Timer_Write_Property_Internal_Callback_Set(write_property_function cb)
     Write_Property_Internal_Callback = cb;
 }
 
+/**
+ * @brief Set the callback told when a timer starts or stops running
+ * @param cb - callback used to track the running timers
+ */
+void Timer_Active_Callback_Set(timer_active_callback cb)
+{
+    Timer_Active_Callback = cb;
+}
+
 /**
  * @brief Add a Timer write property notification callback
  * @param notification - pointer to the notification structure
@@ -2210,6 +2244,7 @@ void Timer_Task(uint32_t object_instance, uint16_t milliseconds)
                         &pObject->Update_Time.date, &pObject->Update_Time.time,
                         NULL, NULL);
                     Timer_Write_Request_Initiate(object_instance, pObject);
+                    Timer_Active_Update(object_instance, pObject);
                 }
                 break;
             case TIMER_STATE_EXPIRED:
@@ -2378,6 +2413,9 @@ bool Timer_Delete(uint32_t object_instance)
         Keylist_Data_Delete(Object_List, object_instance);
 
     if (pObject) {
+        if (Timer_Active_Callback) {
+            Timer_Active_Callback(object_instance, false);
+        }
         free(pObject);
         status = true;
     }
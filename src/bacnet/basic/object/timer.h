@@ -32,6 +32,13 @@ struct timer_write_property_notification {
     struct timer_write_property_notification *next;
     timer_write_property_callback callback;
 };
+/**
+ * @brief Callback for tracking which timers are running, so that only
+ *  those need to be given the elapsed time
+ * @param  instance - timer object instance number
+ * @param  active - true while the timer is running
+ */
+typedef void (*timer_active_callback)(uint32_t instance, bool active);
 
 #ifdef __cplusplus
 extern "C" {
@@ -183,6 +190,9 @@ bool Timer_State_Change_Value_Set(
 BACNET_STACK_EXPORT
 void Timer_Task(uint32_t object_instance, uint16_t milliseconds);
 
+BACNET_STACK_EXPORT
+void Timer_Active_Callback_Set(timer_active_callback cb);
+
 BACNET_STACK_EXPORT
 void Timer_Write_Property_Internal_Callback_Set(write_property_function cb);
 BACNET_STACK_EXPORT
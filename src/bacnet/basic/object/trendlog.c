@@ -7,6 +7,8 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -24,26 +26,122 @@
 #include "bacnet/basic/object/trendlog.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/object/bacfile.h"
+#include "bacnet/basic/sys/memstat.h"
 
 /* number of demo objects */
 #ifndef MAX_TREND_LOGS
 #define MAX_TREND_LOGS 8
 #endif
 
-static TL_DATA_REC Logs_Records[MAX_NUM_DEVICES][MAX_TREND_LOGS]
-                               [TL_MAX_ENTRIES];
-#ifdef BAC_ROUTING
-#define Logs (Logs_Records[Routed_Device_Object_Index()])
-#else
-#define Logs (Logs_Records[0])
-#endif
 static TL_LOG_INFO LogInfos[MAX_NUM_DEVICES][MAX_TREND_LOGS];
 #ifdef BAC_ROUTING
 #define LogInfo (LogInfos[Routed_Device_Object_Index()])
+#define Log_Device_Index() (Routed_Device_Object_Index())
 #else
 #define LogInfo (LogInfos[0])
+#define Log_Device_Index() (0)
+#endif
+
+/* identifies a storage block header written by this module */
+#define TL_STORAGE_MAGIC 0x42544C31UL
+/* offsets of the data in the storage block header */
+#define TL_HEADER_MAGIC 0
+#define TL_HEADER_RECORD_SIZE 4
+#define TL_HEADER_BUFFER_SIZE 8
+#define TL_HEADER_INDEX 12
+#define TL_HEADER_RECORD_COUNT 16
+#define TL_HEADER_TOTAL_RECORD_COUNT 20
+/* offsets of the data in a record slot */
+#define TL_SLOT_TIME_STAMP 0
+#define TL_SLOT_TYPE 5
+#define TL_SLOT_STATUS 6
+#define TL_SLOT_DATUM 7
+/* offsets of the data that a compressed header adds */
+#define TL_HEADER_BLOCKS_USED 24
+#define TL_HEADER_OLDEST_SKIP 28
+/* record size in the header of a compressed log, with the block size */
+#define TL_COMPRESSED_FLAG 0x80000000UL
+/* offsets of the data in a compressed block */
+#define TL_BLOCK_RECORD_COUNT 0
+#define TL_BLOCK_BIT_COUNT 2
+#define TL_BLOCK_TIME_STAMP 4
+#define TL_BLOCK_DATA 9
+/* bits of packed records that a block holds */
+#define TL_BLOCK_BITS ((TL_BLOCK_SIZE - TL_BLOCK_DATA) * 8)
+/* most bits that one record takes in a block */
+#define TL_BLOCK_RECORD_BITS_MAX 96
+/* largest interval between the records of a block, in seconds */
+#define TL_BLOCK_DELTA_MAX 0x3FFFFFFFL
+/* no value has changed yet in the block */
+#define TL_BLOCK_NO_WINDOW 0xFF
+#if (TL_BLOCK_SIZE < 64) || (TL_BLOCK_SIZE > 8191)
+#error "TL_BLOCK_SIZE must be from 64 to 8191 octets"
+#endif
+
+static uint8_t *TL_Storage_Heap_Open(
+    unsigned device_index, uint32_t object_instance, size_t *size);
+static void TL_Storage_Heap_Close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge);
+static trend_log_storage_open_callback Storage_Open_Callback =
+    TL_Storage_Heap_Open;
+static trend_log_storage_close_callback Storage_Close_Callback =
+    TL_Storage_Heap_Close;
+static bool Trend_Log_Initialized;
+/* sends the subscriptions to the remote sources of the COV logs */
+static trend_log_cov_subscribe_callback COV_Subscribe_Callback;
+/* the local objects report their changes to the COV logs */
+static COV_CHANGE_OF_VALUE_LISTENER COV_Listener;
+
+/* default seconds between the subscriptions to a remote source */
+#ifndef TL_COV_RESUBSCRIPTION_INTERVAL
+#define TL_COV_RESUBSCRIPTION_INTERVAL 3600
+#endif
+/* seconds to wait before trying again to subscribe to a remote source */
+#ifndef TL_COV_RETRY_SECONDS
+#define TL_COV_RETRY_SECONDS 10
+#endif
+
+/* number of one second slots in the timer wheel of the polled logs */
+#ifndef TL_WHEEL_SLOTS
+#define TL_WHEEL_SLOTS 64
+#endif
+#define TL_WHEEL_NONE (-1)
+
+/* The polled logs wait in a timer wheel, in the slot of the second
+ * they are next due, so that the timer only visits the logs that are
+ * due instead of checking every log every second. A log that is due
+ * in more than TL_WHEEL_SLOTS seconds waits for more than one turn. */
+typedef struct tl_schedule {
+    bool bReady; /* The wheel holds the logs */
+    bool bTriggers; /* A trigger was written to a log */
+    bool bCOV; /* The local source of a COV log reported a change */
+    bacnet_time_t tLastTime; /* Last second the wheel was run for */
+    int iSlot[TL_WHEEL_SLOTS]; /* First log waiting in each slot */
+    int iNext[MAX_TREND_LOGS]; /* Next log in the same slot */
+    int iPrev[MAX_TREND_LOGS]; /* Previous log in the same slot */
+    int iWaitSlot[MAX_TREND_LOGS]; /* Slot of the log, or TL_WHEEL_NONE */
+    bacnet_time_t tDueTime[MAX_TREND_LOGS]; /* When the log is due */
+} TL_SCHEDULE;
+static TL_SCHEDULE Schedules[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Schedule (Schedules[Routed_Device_Object_Index()])
+#else
+#define Schedule (Schedules[0])
 #endif
 
+static void TL_Schedule_Update(int iLog);
+static void TL_COV_Object_Changed(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+static bool TL_Source_Local(
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source);
+static void TL_COV_Start(int iLog);
+static void TL_COV_Stop(int iLog);
+static void TL_COV_Restart(int iLog);
+
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int32_t Trend_Log_Properties_Required[] = {
     PROP_OBJECT_IDENTIFIER,
@@ -65,9 +163,8 @@ static const int32_t Trend_Log_Properties_Optional[] = {
     PROP_DESCRIPTION, PROP_START_TIME, PROP_STOP_TIME,
     PROP_LOG_DEVICE_OBJECT_PROPERTY, PROP_LOG_INTERVAL,
 
-    /* Required if COV logging supported
-        PROP_COV_RESUBSCRIPTION_INTERVAL,
-        PROP_CLIENT_COV_INCREMENT, */
+    /* Required if COV logging supported */
+    PROP_COV_RESUBSCRIPTION_INTERVAL, PROP_CLIENT_COV_INCREMENT,
 
     /* Required if intrinsic reporting supported
         PROP_NOTIFICATION_THRESHOLD,
@@ -101,6 +198,8 @@ static const int32_t Writable_Properties[] = {
     PROP_ALIGN_INTERVALS,
     PROP_INTERVAL_OFFSET,
     PROP_TRIGGER,
+    PROP_COV_RESUBSCRIPTION_INTERVAL,
+    PROP_CLIENT_COV_INCREMENT,
     -1
 };
 
@@ -114,89 +213,1144 @@ static const int32_t Writable_Properties[] = {
  * @param pProprietary - pointer to list of int terminated by -1, of
  * BACnet proprietary properties for this object.
  */
-void Trend_Log_Property_Lists(
-    const int32_t **pRequired,
-    const int32_t **pOptional,
-    const int32_t **pProprietary)
+void Trend_Log_Property_Lists(
+    const int32_t **pRequired,
+    const int32_t **pOptional,
+    const int32_t **pProprietary)
+{
+    if (pRequired) {
+        *pRequired = Trend_Log_Properties_Required;
+    }
+    if (pOptional) {
+        *pOptional = Trend_Log_Properties_Optional;
+    }
+    if (pProprietary) {
+        *pProprietary = Trend_Log_Properties_Proprietary;
+    }
+
+    return;
+}
+
+/**
+ * @brief Get the list of writable properties for a Trend Log object
+ * @param  object_instance - object-instance number of the object
+ * @param  properties - Pointer to the pointer of writable properties.
+ */
+void Trend_Log_Writable_Property_List(
+    uint32_t object_instance, const int32_t **properties)
+{
+    (void)object_instance;
+    if (properties) {
+        *properties = Writable_Properties;
+    }
+}
+
+/* we simply have 0-n object instances.  Yours might be */
+/* more complex, and then you need validate that the */
+/* given instance exists */
+bool Trend_Log_Valid_Instance(uint32_t object_instance)
+{
+    if (object_instance < MAX_TREND_LOGS) {
+        return true;
+    }
+
+    return false;
+}
+
+/* we simply have 0-n object instances.  Yours might be */
+/* more complex, and then count how many you have */
+unsigned Trend_Log_Count(void)
+{
+    return MAX_TREND_LOGS;
+}
+
+/* we simply have 0-n object instances.  Yours might be */
+/* more complex, and then you need to return the instance */
+/* that correlates to the correct index */
+uint32_t Trend_Log_Index_To_Instance(unsigned index)
+{
+    return index;
+}
+
+/* we simply have 0-n object instances.  Yours might be */
+/* more complex, and then you need to return the index */
+/* that correlates to the correct instance number */
+unsigned Trend_Log_Instance_To_Index(uint32_t object_instance)
+{
+    unsigned index = MAX_TREND_LOGS;
+
+    if (object_instance < MAX_TREND_LOGS) {
+        index = object_instance;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Get the current time from the Device object
+ * @return current time in epoch seconds
+ */
+static bacnet_time_t Trend_Log_Epoch_Seconds_Now(void)
+{
+    BACNET_DATE_TIME bdatetime;
+
+    Device_getCurrentDateTime(&bdatetime);
+    return datetime_seconds_since_epoch(&bdatetime);
+}
+
+/**
+ * @brief Get a storage block for the records of a log from the heap
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param size - [in,out] the size of the storage block
+ * @return the storage block, or NULL if there is not enough memory
+ */
+static uint8_t *TL_Storage_Heap_Open(
+    unsigned device_index, uint32_t object_instance, size_t *size)
+{
+    uint8_t *storage;
+
+    (void)device_index;
+    (void)object_instance;
+    storage = calloc(1, *size);
+    if (storage) {
+        MEMSTAT_ALLOC(MEMSTAT_LOG, *size);
+    }
+
+    return storage;
+}
+
+/**
+ * @brief Free a storage block from the heap
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param storage - the storage block
+ * @param size - the size of the storage block
+ * @param purge - true if the records are no longer wanted
+ */
+static void TL_Storage_Heap_Close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge)
+{
+    (void)device_index;
+    (void)object_instance;
+    (void)size;
+    (void)purge;
+    if (storage) {
+        MEMSTAT_FREE(MEMSTAT_LOG, size);
+    }
+    free(storage);
+}
+
+/**
+ * @brief Set the callbacks that keep the storage blocks of the logs,
+ *  for example in files that survive a restart of the device.
+ * @note Set them before Trend_Log_Init(), or call Trend_Log_Cleanup()
+ *  before changing them. NULL callbacks restore the default storage
+ *  from the heap.
+ * @param open_callback - callback to get the storage block of a log
+ * @param close_callback - callback to let go of a storage block
+ */
+void Trend_Log_Storage_Callback_Set(
+    trend_log_storage_open_callback open_callback,
+    trend_log_storage_close_callback close_callback)
+{
+    if (open_callback && close_callback) {
+        Storage_Open_Callback = open_callback;
+        Storage_Close_Callback = close_callback;
+    } else {
+        Storage_Open_Callback = TL_Storage_Heap_Open;
+        Storage_Close_Callback = TL_Storage_Heap_Close;
+    }
+}
+
+/**
+ * @brief Get the slot of a record in the storage block of a log
+ * @param CurrentLog - the log
+ * @param uiSlot - 0 based slot number, less than the buffer size
+ * @return the slot of the record
+ */
+static uint8_t *TL_Record_Slot(const TL_LOG_INFO *CurrentLog, uint32_t uiSlot)
+{
+    return &CurrentLog
+                ->pStorage[TL_STORAGE_HEADER_SIZE + (uiSlot * TL_RECORD_SIZE)];
+}
+
+/**
+ * @brief Get the time stamp of a stored record
+ * @param pSlot - the slot of the record
+ * @return the time stamp of the record
+ */
+static bacnet_time_t TL_Record_Time_Stamp(const uint8_t *pSlot)
+{
+#ifdef UINT64_MAX
+    uint64_t tTimeStamp = 0;
+
+    decode_unsigned40(&pSlot[TL_SLOT_TIME_STAMP], &tTimeStamp);
+#else
+    uint32_t tTimeStamp = 0;
+
+    decode_unsigned32(&pSlot[TL_SLOT_TIME_STAMP + 1], &tTimeStamp);
+#endif
+
+    return (bacnet_time_t)tTimeStamp;
+}
+
+/**
+ * @brief Pack a record into a slot, with only the datum of its type
+ * @param pSlot - the slot of the record
+ * @param pRecord - the record to store
+ */
+static void TL_Record_Pack(uint8_t *pSlot, const TL_DATA_REC *pRecord)
+{
+    uint8_t *pDatum = &pSlot[TL_SLOT_DATUM];
+    uint8_t ucCount = 0;
+
+    memset(pSlot, 0, TL_RECORD_SIZE);
+#ifdef UINT64_MAX
+    encode_unsigned40(&pSlot[TL_SLOT_TIME_STAMP], pRecord->tTimeStamp);
+#else
+    encode_unsigned32(&pSlot[TL_SLOT_TIME_STAMP + 1], pRecord->tTimeStamp);
+#endif
+    pSlot[TL_SLOT_TYPE] = pRecord->ucRecType;
+    pSlot[TL_SLOT_STATUS] = pRecord->ucStatus;
+    switch (pRecord->ucRecType) {
+        case TL_TYPE_STATUS:
+            pDatum[0] = pRecord->Datum.ucLogStatus;
+            break;
+        case TL_TYPE_BOOL:
+            pDatum[0] = pRecord->Datum.ucBoolean;
+            break;
+        case TL_TYPE_REAL:
+            encode_bacnet_real(pRecord->Datum.fReal, pDatum);
+            break;
+        case TL_TYPE_ENUM:
+            encode_unsigned32(pDatum, pRecord->Datum.ulEnum);
+            break;
+        case TL_TYPE_UNSIGN:
+            encode_unsigned32(pDatum, pRecord->Datum.ulUValue);
+            break;
+        case TL_TYPE_SIGN:
+            encode_signed32(pDatum, pRecord->Datum.lSValue);
+            break;
+        case TL_TYPE_BITS:
+            pDatum[0] = pRecord->Datum.Bits.ucLen;
+            ucCount = pRecord->Datum.Bits.ucLen >> 4;
+            if (ucCount > sizeof(pRecord->Datum.Bits.ucStore)) {
+                ucCount = sizeof(pRecord->Datum.Bits.ucStore);
+            }
+            memcpy(&pDatum[1], pRecord->Datum.Bits.ucStore, ucCount);
+            break;
+        case TL_TYPE_ERROR:
+            encode_unsigned16(pDatum, pRecord->Datum.Error.usClass);
+            encode_unsigned16(&pDatum[2], pRecord->Datum.Error.usCode);
+            break;
+        case TL_TYPE_DELTA:
+            encode_bacnet_real(pRecord->Datum.fTime, pDatum);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Unpack a record from a slot
+ * @param pSlot - the slot of the record
+ * @param pRecord - [out] the record
+ */
+static void TL_Record_Unpack(const uint8_t *pSlot, TL_DATA_REC *pRecord)
+{
+    const uint8_t *pDatum = &pSlot[TL_SLOT_DATUM];
+    uint8_t ucCount = 0;
+
+    memset(pRecord, 0, sizeof(TL_DATA_REC));
+    pRecord->tTimeStamp = TL_Record_Time_Stamp(pSlot);
+    pRecord->ucRecType = pSlot[TL_SLOT_TYPE];
+    pRecord->ucStatus = pSlot[TL_SLOT_STATUS];
+    switch (pRecord->ucRecType) {
+        case TL_TYPE_STATUS:
+            pRecord->Datum.ucLogStatus = pDatum[0];
+            break;
+        case TL_TYPE_BOOL:
+            pRecord->Datum.ucBoolean = pDatum[0];
+            break;
+        case TL_TYPE_REAL:
+            decode_real(pDatum, &pRecord->Datum.fReal);
+            break;
+        case TL_TYPE_ENUM:
+            decode_unsigned32(pDatum, &pRecord->Datum.ulEnum);
+            break;
+        case TL_TYPE_UNSIGN:
+            decode_unsigned32(pDatum, &pRecord->Datum.ulUValue);
+            break;
+        case TL_TYPE_SIGN:
+            decode_signed32(pDatum, &pRecord->Datum.lSValue);
+            break;
+        case TL_TYPE_BITS:
+            pRecord->Datum.Bits.ucLen = pDatum[0];
+            ucCount = pRecord->Datum.Bits.ucLen >> 4;
+            if (ucCount > sizeof(pRecord->Datum.Bits.ucStore)) {
+                ucCount = sizeof(pRecord->Datum.Bits.ucStore);
+            }
+            memcpy(pRecord->Datum.Bits.ucStore, &pDatum[1], ucCount);
+            break;
+        case TL_TYPE_ERROR:
+            decode_unsigned16(pDatum, &pRecord->Datum.Error.usClass);
+            decode_unsigned16(&pDatum[2], &pRecord->Datum.Error.usCode);
+            break;
+        case TL_TYPE_DELTA:
+            decode_real(pDatum, &pRecord->Datum.fTime);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Get the bits of the value of a record, for the types whose
+ *  value is packed as the bits changed from the previous value
+ * @param pRecord - the record
+ * @param pulValue - [out] the bits of the value
+ * @return true if the value of the record is packed as changed bits
+ */
+static bool TL_Record_Value(const TL_DATA_REC *pRecord, uint32_t *pulValue)
+{
+    uint8_t ucReal[4] = { 0 };
+
+    switch (pRecord->ucRecType) {
+        case TL_TYPE_STATUS:
+            *pulValue = pRecord->Datum.ucLogStatus;
+            break;
+        case TL_TYPE_BOOL:
+            *pulValue = pRecord->Datum.ucBoolean;
+            break;
+        case TL_TYPE_REAL:
+            encode_bacnet_real(pRecord->Datum.fReal, ucReal);
+            decode_unsigned32(ucReal, pulValue);
+            break;
+        case TL_TYPE_ENUM:
+            *pulValue = pRecord->Datum.ulEnum;
+            break;
+        case TL_TYPE_UNSIGN:
+            *pulValue = pRecord->Datum.ulUValue;
+            break;
+        case TL_TYPE_SIGN:
+            *pulValue = (uint32_t)pRecord->Datum.lSValue;
+            break;
+        case TL_TYPE_ERROR:
+            *pulValue = ((uint32_t)pRecord->Datum.Error.usClass << 16) |
+                pRecord->Datum.Error.usCode;
+            break;
+        case TL_TYPE_DELTA:
+            encode_bacnet_real(pRecord->Datum.fTime, ucReal);
+            decode_unsigned32(ucReal, pulValue);
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Set the value of a record from the bits of the value
+ * @param pRecord - [in,out] the record, with its type
+ * @param ulValue - the bits of the value
+ */
+static void TL_Record_Value_Set(TL_DATA_REC *pRecord, uint32_t ulValue)
+{
+    uint8_t ucReal[4] = { 0 };
+
+    switch (pRecord->ucRecType) {
+        case TL_TYPE_STATUS:
+            pRecord->Datum.ucLogStatus = (uint8_t)ulValue;
+            break;
+        case TL_TYPE_BOOL:
+            pRecord->Datum.ucBoolean = (uint8_t)ulValue;
+            break;
+        case TL_TYPE_REAL:
+            encode_unsigned32(ucReal, ulValue);
+            decode_real(ucReal, &pRecord->Datum.fReal);
+            break;
+        case TL_TYPE_ENUM:
+            pRecord->Datum.ulEnum = ulValue;
+            break;
+        case TL_TYPE_UNSIGN:
+            pRecord->Datum.ulUValue = ulValue;
+            break;
+        case TL_TYPE_SIGN:
+            pRecord->Datum.lSValue = (int32_t)ulValue;
+            break;
+        case TL_TYPE_ERROR:
+            pRecord->Datum.Error.usClass = (uint16_t)(ulValue >> 16);
+            pRecord->Datum.Error.usCode = (uint16_t)ulValue;
+            break;
+        case TL_TYPE_DELTA:
+            encode_unsigned32(ucReal, ulValue);
+            decode_real(ucReal, &pRecord->Datum.fTime);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Put bits into the packed records of a block, most significant
+ *  bit first
+ * @param pData - the packed records of the block
+ * @param pusBit - [in,out] the bit position in the block
+ * @param ulValue - the bits to put, in the low bits
+ * @param ucCount - number of bits to put, up to 32
+ */
+static void TL_Bits_Put(
+    uint8_t *pData, uint16_t *pusBit, uint32_t ulValue, uint8_t ucCount)
+{
+    uint8_t ucMask = 0;
+
+    while (ucCount > 0) {
+        ucCount--;
+        if (*pusBit < TL_BLOCK_BITS) {
+            ucMask = (uint8_t)(0x80 >> (*pusBit % 8));
+            if (ulValue & (1UL << ucCount)) {
+                pData[*pusBit / 8] |= ucMask;
+            } else {
+                pData[*pusBit / 8] &= (uint8_t)~ucMask;
+            }
+        }
+        (*pusBit)++;
+    }
+}
+
+/**
+ * @brief Get bits from the packed records of a block
+ * @param pData - the packed records of the block
+ * @param pusBit - [in,out] the bit position in the block
+ * @param ucCount - number of bits to get, up to 32
+ * @return the bits, in the low bits
+ */
+static uint32_t
+TL_Bits_Get(const uint8_t *pData, uint16_t *pusBit, uint8_t ucCount)
+{
+    uint32_t ulValue = 0;
+
+    while (ucCount > 0) {
+        ucCount--;
+        ulValue <<= 1;
+        if ((*pusBit < TL_BLOCK_BITS) &&
+            (pData[*pusBit / 8] & (0x80 >> (*pusBit % 8)))) {
+            ulValue |= 1;
+        }
+        (*pusBit)++;
+    }
+
+    return ulValue;
+}
+
+/**
+ * @brief Get a block of a compressed log
+ * @param CurrentLog - the log
+ * @param ulBlock - 0 based block number, less than the block count
+ * @return the block
+ */
+static uint8_t *TL_Block(const TL_LOG_INFO *CurrentLog, uint32_t ulBlock)
+{
+    size_t offset =
+        TL_COMPRESSED_HEADER_SIZE + ((size_t)ulBlock * TL_BLOCK_SIZE);
+
+    return &CurrentLog->pStorage[offset];
+}
+
+/**
+ * @brief Get the number of records packed in a block
+ * @param pBlock - the block
+ * @return the number of records
+ */
+static uint16_t TL_Block_Record_Count(const uint8_t *pBlock)
+{
+    uint16_t usCount = 0;
+
+    decode_unsigned16(&pBlock[TL_BLOCK_RECORD_COUNT], &usCount);
+
+    return usCount;
+}
+
+/**
+ * @brief Set the state to the start of a block, before its first record
+ * @param pBlock - the block
+ * @param ulBlock - 0 based block number of the block
+ * @param pState - [out] the state
+ */
+static void TL_Block_State_Start(
+    const uint8_t *pBlock, uint32_t ulBlock, TL_BLOCK_STATE *pState)
+{
+    memset(pState, 0, sizeof(TL_BLOCK_STATE));
+    pState->ulBlock = ulBlock;
+    pState->tTimeStamp = TL_Record_Time_Stamp(&pBlock[TL_BLOCK_TIME_STAMP]);
+    pState->ucLeading = TL_BLOCK_NO_WINDOW;
+}
+
+/**
+ * @brief Start a block, with the time stamp of its first record
+ * @param pBlock - the block
+ * @param tTimeStamp - the time stamp of the first record
+ */
+static void TL_Block_Format(uint8_t *pBlock, bacnet_time_t tTimeStamp)
+{
+    memset(pBlock, 0, TL_BLOCK_SIZE);
+#ifdef UINT64_MAX
+    encode_unsigned40(&pBlock[TL_BLOCK_TIME_STAMP], tTimeStamp);
+#else
+    encode_unsigned32(&pBlock[TL_BLOCK_TIME_STAMP + 1], tTimeStamp);
+#endif
+}
+
+/**
+ * @brief Determine if a record can be packed at the end of a block
+ * @param pState - the state at the end of the block
+ * @param pRecord - the record
+ * @return true if the record fits in the block
+ */
+static bool
+TL_Block_Fits(const TL_BLOCK_STATE *pState, const TL_DATA_REC *pRecord)
+{
+    bacnet_time_t tDiff = 0;
+
+    if (pState->usRecord == 0) {
+        return true;
+    }
+    if ((pState->usRecord >= UINT16_MAX) ||
+        ((TL_BLOCK_BITS - pState->usBit) < TL_BLOCK_RECORD_BITS_MAX)) {
+        return false;
+    }
+    if (pRecord->tTimeStamp >= pState->tTimeStamp) {
+        tDiff = pRecord->tTimeStamp - pState->tTimeStamp;
+    } else {
+        tDiff = pState->tTimeStamp - pRecord->tTimeStamp;
+    }
+
+    return tDiff <= (bacnet_time_t)TL_BLOCK_DELTA_MAX;
+}
+
+/**
+ * @brief Pack a record at the end of a block. The time stamp is packed
+ *  as the change of the interval from the previous record, in 1 to 36
+ *  bits, and the value as the bits that changed from the previous value
+ *  of the same type, in 1 bit when it did not change.
+ * @param pData - the packed records of the block
+ * @param pState - [in,out] the state at the end of the block
+ * @param pRecord - the record, which fits in the block
+ */
+static void TL_Block_Pack(
+    uint8_t *pData, TL_BLOCK_STATE *pState, const TL_DATA_REC *pRecord)
+{
+    int32_t lDelta = 0;
+    int32_t lChange = 0;
+    uint32_t ulValue = 0;
+    uint32_t ulChanged = 0;
+    uint8_t ucLeading = 0;
+    uint8_t ucTrailing = 0;
+    uint8_t ucCount = 0;
+    uint8_t i = 0;
+    bool bNewType = true;
+
+    if (pState->usRecord > 0) {
+        if (pRecord->tTimeStamp >= pState->tTimeStamp) {
+            lDelta = (int32_t)(pRecord->tTimeStamp - pState->tTimeStamp);
+        } else {
+            lDelta = -(int32_t)(pState->tTimeStamp - pRecord->tTimeStamp);
+        }
+        lChange = lDelta - pState->lDelta;
+        if (lChange == 0) {
+            TL_Bits_Put(pData, &pState->usBit, 0x0, 1);
+        } else if ((lChange >= -63) && (lChange <= 64)) {
+            TL_Bits_Put(pData, &pState->usBit, 0x2, 2);
+            TL_Bits_Put(pData, &pState->usBit, (uint32_t)(lChange + 63), 7);
+        } else if ((lChange >= -255) && (lChange <= 256)) {
+            TL_Bits_Put(pData, &pState->usBit, 0x6, 3);
+            TL_Bits_Put(pData, &pState->usBit, (uint32_t)(lChange + 255), 9);
+        } else if ((lChange >= -2047) && (lChange <= 2048)) {
+            TL_Bits_Put(pData, &pState->usBit, 0xE, 4);
+            TL_Bits_Put(pData, &pState->usBit, (uint32_t)(lChange + 2047), 12);
+        } else {
+            TL_Bits_Put(pData, &pState->usBit, 0xF, 4);
+            TL_Bits_Put(pData, &pState->usBit, (uint32_t)lChange, 32);
+        }
+        bNewType = (pRecord->ucRecType != pState->ucRecType) ||
+            (pRecord->ucStatus != pState->ucStatus);
+        TL_Bits_Put(pData, &pState->usBit, bNewType ? 1 : 0, 1);
+    }
+    pState->tTimeStamp = pRecord->tTimeStamp;
+    pState->lDelta = lDelta;
+    if (bNewType) {
+        TL_Bits_Put(pData, &pState->usBit, pRecord->ucRecType, 4);
+        TL_Bits_Put(pData, &pState->usBit, pRecord->ucStatus, 8);
+        if (pRecord->ucRecType != pState->ucRecType) {
+            pState->ulValue = 0;
+            pState->ucLeading = TL_BLOCK_NO_WINDOW;
+        }
+        pState->ucRecType = pRecord->ucRecType;
+        pState->ucStatus = pRecord->ucStatus;
+    }
+    if (TL_Record_Value(pRecord, &ulValue)) {
+        ulChanged = ulValue ^ pState->ulValue;
+        if (ulChanged == 0) {
+            TL_Bits_Put(pData, &pState->usBit, 0x0, 1);
+        } else {
+            while (!(ulChanged & (0x80000000UL >> ucLeading))) {
+                ucLeading++;
+            }
+            while (!(ulChanged & (1UL << ucTrailing))) {
+                ucTrailing++;
+            }
+            if ((pState->ucLeading != TL_BLOCK_NO_WINDOW) &&
+                (ucLeading >= pState->ucLeading) &&
+                (ucTrailing >= pState->ucTrailing)) {
+                /* the changed bits are inside the previous window */
+                TL_Bits_Put(pData, &pState->usBit, 0x2, 2);
+            } else {
+                pState->ucLeading = ucLeading;
+                pState->ucTrailing = ucTrailing;
+                TL_Bits_Put(pData, &pState->usBit, 0x3, 2);
+                TL_Bits_Put(pData, &pState->usBit, ucLeading, 5);
+                TL_Bits_Put(
+                    pData, &pState->usBit,
+                    (uint32_t)(31 - ucLeading - ucTrailing), 5);
+            }
+            ucCount = 32 - pState->ucLeading - pState->ucTrailing;
+            TL_Bits_Put(
+                pData, &pState->usBit, ulChanged >> pState->ucTrailing,
+                ucCount);
+        }
+        pState->ulValue = ulValue;
+    } else if (pRecord->ucRecType == TL_TYPE_BITS) {
+        TL_Bits_Put(pData, &pState->usBit, pRecord->Datum.Bits.ucLen, 8);
+        ucCount = pRecord->Datum.Bits.ucLen >> 4;
+        for (i = 0; (i < ucCount) && (i < sizeof(pRecord->Datum.Bits.ucStore));
+             i++) {
+            TL_Bits_Put(
+                pData, &pState->usBit, pRecord->Datum.Bits.ucStore[i], 8);
+        }
+    }
+    pState->usRecord++;
+}
+
+/**
+ * @brief Unpack the next record of a block
+ * @param pData - the packed records of the block
+ * @param pState - [in,out] the state after the previous record
+ * @param pRecord - [out] the record
+ */
+static void TL_Block_Unpack(
+    const uint8_t *pData, TL_BLOCK_STATE *pState, TL_DATA_REC *pRecord)
+{
+    int32_t lChange = 0;
+    uint32_t ulValue = 0;
+    uint8_t ucCount = 0;
+    uint8_t i = 0;
+    bool bNewType = true;
+
+    memset(pRecord, 0, sizeof(TL_DATA_REC));
+    if (pState->usRecord > 0) {
+        if (TL_Bits_Get(pData, &pState->usBit, 1) == 0) {
+            lChange = 0;
+        } else if (TL_Bits_Get(pData, &pState->usBit, 1) == 0) {
+            lChange = (int32_t)TL_Bits_Get(pData, &pState->usBit, 7) - 63;
+        } else if (TL_Bits_Get(pData, &pState->usBit, 1) == 0) {
+            lChange = (int32_t)TL_Bits_Get(pData, &pState->usBit, 9) - 255;
+        } else if (TL_Bits_Get(pData, &pState->usBit, 1) == 0) {
+            lChange = (int32_t)TL_Bits_Get(pData, &pState->usBit, 12) - 2047;
+        } else {
+            lChange = (int32_t)TL_Bits_Get(pData, &pState->usBit, 32);
+        }
+        pState->lDelta += lChange;
+        if (pState->lDelta >= 0) {
+            pState->tTimeStamp += (bacnet_time_t)pState->lDelta;
+        } else {
+            pState->tTimeStamp -= (bacnet_time_t)(-pState->lDelta);
+        }
+        bNewType = TL_Bits_Get(pData, &pState->usBit, 1) != 0;
+    }
+    if (bNewType) {
+        pRecord->ucRecType = (uint8_t)TL_Bits_Get(pData, &pState->usBit, 4);
+        pRecord->ucStatus = (uint8_t)TL_Bits_Get(pData, &pState->usBit, 8);
+        if (pRecord->ucRecType != pState->ucRecType) {
+            pState->ulValue = 0;
+            pState->ucLeading = TL_BLOCK_NO_WINDOW;
+        }
+        pState->ucRecType = pRecord->ucRecType;
+        pState->ucStatus = pRecord->ucStatus;
+    }
+    pRecord->tTimeStamp = pState->tTimeStamp;
+    pRecord->ucRecType = pState->ucRecType;
+    pRecord->ucStatus = pState->ucStatus;
+    if (TL_Record_Value(pRecord, &ulValue)) {
+        if (TL_Bits_Get(pData, &pState->usBit, 1) != 0) {
+            if (TL_Bits_Get(pData, &pState->usBit, 1) != 0) {
+                pState->ucLeading =
+                    (uint8_t)TL_Bits_Get(pData, &pState->usBit, 5);
+                ucCount = (uint8_t)TL_Bits_Get(pData, &pState->usBit, 5);
+                pState->ucTrailing = 31 - pState->ucLeading - ucCount;
+                if (pState->ucTrailing > 31) {
+                    /* not a block from this module */
+                    pState->ucTrailing = 0;
+                }
+            } else if (pState->ucLeading == TL_BLOCK_NO_WINDOW) {
+                pState->ucLeading = 0;
+                pState->ucTrailing = 0;
+            }
+            ucCount = 32 - pState->ucLeading - pState->ucTrailing;
+            pState->ulValue ^= TL_Bits_Get(pData, &pState->usBit, ucCount)
+                << pState->ucTrailing;
+        }
+        TL_Record_Value_Set(pRecord, pState->ulValue);
+    } else if (pRecord->ucRecType == TL_TYPE_BITS) {
+        pRecord->Datum.Bits.ucLen =
+            (uint8_t)TL_Bits_Get(pData, &pState->usBit, 8);
+        ucCount = pRecord->Datum.Bits.ucLen >> 4;
+        for (i = 0; (i < ucCount) && (i < sizeof(pRecord->Datum.Bits.ucStore));
+             i++) {
+            pRecord->Datum.Bits.ucStore[i] =
+                (uint8_t)TL_Bits_Get(pData, &pState->usBit, 8);
+        }
+    }
+    pState->usRecord++;
+}
+
+/**
+ * @brief Drop the oldest block of a compressed log, with its records
+ * @param CurrentLog - the log
+ */
+static void TL_Block_Drop(TL_LOG_INFO *CurrentLog)
+{
+    uint32_t ulRecords = 0;
+
+    ulRecords = TL_Block_Record_Count(
+        TL_Block(CurrentLog, (uint32_t)CurrentLog->iIndex));
+    if (ulRecords > CurrentLog->ulOldestSkip) {
+        ulRecords -= CurrentLog->ulOldestSkip;
+    } else {
+        ulRecords = 0;
+    }
+    if (CurrentLog->ulRecordCount > ulRecords) {
+        CurrentLog->ulRecordCount -= ulRecords;
+    } else {
+        CurrentLog->ulRecordCount = 0;
+    }
+    if (CurrentLog->bReaderValid &&
+        (CurrentLog->Reader.ulBlock == (uint32_t)CurrentLog->iIndex)) {
+        CurrentLog->bReaderValid = false;
+    } else if (CurrentLog->bReaderValid) {
+        CurrentLog->ulReaderEntry -= ulRecords;
+    }
+    CurrentLog->iIndex =
+        (int)(((uint32_t)CurrentLog->iIndex + 1) % CurrentLog->ulBlockCount);
+    CurrentLog->ulBlocksUsed--;
+    CurrentLog->ulOldestSkip = 0;
+}
+
+/**
+ * @brief Add a record at the end of the newest block of a compressed log,
+ *  starting a new block when it does not fit. The oldest block is dropped
+ *  for a new block when all the blocks are used, and the oldest record is
+ *  pushed out of a full log.
+ * @param CurrentLog - the log
+ * @param pRecord - the record to add
+ */
+static void TL_Block_Append(TL_LOG_INFO *CurrentLog, const TL_DATA_REC *pRecord)
+{
+    uint8_t *pBlock = NULL;
+    uint32_t ulBlock = 0;
+
+    if ((CurrentLog->ulBlocksUsed == 0) ||
+        !TL_Block_Fits(&CurrentLog->Writer, pRecord)) {
+        if (CurrentLog->ulBlocksUsed >= CurrentLog->ulBlockCount) {
+            TL_Block_Drop(CurrentLog);
+        }
+        ulBlock = ((uint32_t)CurrentLog->iIndex + CurrentLog->ulBlocksUsed) %
+            CurrentLog->ulBlockCount;
+        CurrentLog->ulBlocksUsed++;
+        pBlock = TL_Block(CurrentLog, ulBlock);
+        TL_Block_Format(pBlock, pRecord->tTimeStamp);
+        TL_Block_State_Start(pBlock, ulBlock, &CurrentLog->Writer);
+    }
+    pBlock = TL_Block(CurrentLog, CurrentLog->Writer.ulBlock);
+    TL_Block_Pack(&pBlock[TL_BLOCK_DATA], &CurrentLog->Writer, pRecord);
+    encode_unsigned16(
+        &pBlock[TL_BLOCK_RECORD_COUNT], CurrentLog->Writer.usRecord);
+    encode_unsigned16(&pBlock[TL_BLOCK_BIT_COUNT], CurrentLog->Writer.usBit);
+    CurrentLog->ulRecordCount++;
+    if (CurrentLog->ulRecordCount > CurrentLog->ulBufferSize) {
+        /* push the oldest record out */
+        CurrentLog->ulRecordCount--;
+        CurrentLog->ulOldestSkip++;
+        if (CurrentLog->bReaderValid) {
+            if (CurrentLog->ulReaderEntry > 0) {
+                CurrentLog->ulReaderEntry--;
+            } else {
+                CurrentLog->bReaderValid = false;
+            }
+        }
+        if ((CurrentLog->ulBlocksUsed > 1) &&
+            (CurrentLog->ulOldestSkip >=
+             TL_Block_Record_Count(
+                 TL_Block(CurrentLog, (uint32_t)CurrentLog->iIndex)))) {
+            TL_Block_Drop(CurrentLog);
+        }
+    }
+}
+
+/**
+ * @brief Get a record of a compressed log. The record after the last one
+ *  read is unpacked from where the reader is, and any other record is
+ *  unpacked from the start of its block.
+ * @param CurrentLog - the log
+ * @param uiEntry - 0 based entry from the oldest record, less than the
+ *  record count
+ * @param pRecord - [out] the record
+ */
+static void
+TL_Block_Record(TL_LOG_INFO *CurrentLog, uint32_t uiEntry, TL_DATA_REC *pRecord)
+{
+    TL_BLOCK_STATE *pReader = &CurrentLog->Reader;
+    const uint8_t *pBlock = NULL;
+    uint32_t ulBlock = 0;
+    uint32_t ulTarget = 0;
+    uint32_t i = 0;
+    uint16_t usCount = 0;
+
+    if (CurrentLog->bReaderValid &&
+        (uiEntry == (CurrentLog->ulReaderEntry + 1))) {
+        pBlock = TL_Block(CurrentLog, pReader->ulBlock);
+        if (pReader->usRecord >= TL_Block_Record_Count(pBlock)) {
+            ulBlock = (pReader->ulBlock + 1) % CurrentLog->ulBlockCount;
+            pBlock = TL_Block(CurrentLog, ulBlock);
+            TL_Block_State_Start(pBlock, ulBlock, pReader);
+        }
+        TL_Block_Unpack(&pBlock[TL_BLOCK_DATA], pReader, pRecord);
+    } else {
+        ulTarget = uiEntry + CurrentLog->ulOldestSkip;
+        ulBlock = (uint32_t)CurrentLog->iIndex;
+        for (i = 1; i < CurrentLog->ulBlocksUsed; i++) {
+            usCount = TL_Block_Record_Count(TL_Block(CurrentLog, ulBlock));
+            if (ulTarget < usCount) {
+                break;
+            }
+            ulTarget -= usCount;
+            ulBlock = (ulBlock + 1) % CurrentLog->ulBlockCount;
+        }
+        pBlock = TL_Block(CurrentLog, ulBlock);
+        usCount = TL_Block_Record_Count(pBlock);
+        TL_Block_State_Start(pBlock, ulBlock, pReader);
+        do {
+            TL_Block_Unpack(&pBlock[TL_BLOCK_DATA], pReader, pRecord);
+        } while ((pReader->usRecord <= ulTarget) &&
+                 (pReader->usRecord < usCount));
+    }
+    CurrentLog->ulReaderEntry = uiEntry;
+    CurrentLog->bReaderValid = true;
+}
+
+/**
+ * @brief Carry on from the records of compressed storage, after checking
+ *  that the newest block unpacks to the bits that it holds
+ * @param CurrentLog - the log, with the state from the header
+ * @return true if the records can be resumed
+ */
+static bool TL_Block_Resume(TL_LOG_INFO *CurrentLog)
 {
-    if (pRequired) {
-        *pRequired = Trend_Log_Properties_Required;
+    const uint8_t *pBlock = NULL;
+    uint16_t usCount = 0;
+    uint16_t usBits = 0;
+    TL_DATA_REC TempRec;
+
+    if (CurrentLog->ulBlocksUsed == 0) {
+        return CurrentLog->ulRecordCount == 0;
     }
-    if (pOptional) {
-        *pOptional = Trend_Log_Properties_Optional;
+    pBlock = TL_Block(
+        CurrentLog,
+        ((uint32_t)CurrentLog->iIndex + CurrentLog->ulBlocksUsed - 1) %
+            CurrentLog->ulBlockCount);
+    usCount = TL_Block_Record_Count(pBlock);
+    decode_unsigned16(&pBlock[TL_BLOCK_BIT_COUNT], &usBits);
+    if ((usCount == 0) || (usBits > TL_BLOCK_BITS)) {
+        return false;
     }
-    if (pProprietary) {
-        *pProprietary = Trend_Log_Properties_Proprietary;
+    TL_Block_State_Start(
+        pBlock,
+        ((uint32_t)CurrentLog->iIndex + CurrentLog->ulBlocksUsed - 1) %
+            CurrentLog->ulBlockCount,
+        &CurrentLog->Writer);
+    while (CurrentLog->Writer.usRecord < usCount) {
+        TL_Block_Unpack(&pBlock[TL_BLOCK_DATA], &CurrentLog->Writer, &TempRec);
+    }
+    if (CurrentLog->Writer.usBit != usBits) {
+        return false;
     }
+    CurrentLog->tLastDataTime = CurrentLog->Writer.tTimeStamp;
 
-    return;
+    return true;
 }
 
 /**
- * @brief Get the list of writable properties for a Trend Log object
- * @param  object_instance - object-instance number of the object
- * @param  properties - Pointer to the pointer of writable properties.
+ * @brief Get a record of a log
+ * @param CurrentLog - the log
+ * @param uiEntry - 0 based entry from the oldest record, less than the
+ *  record count
+ * @param pRecord - [out] the record
  */
-void Trend_Log_Writable_Property_List(
-    uint32_t object_instance, const int32_t **properties)
+static void
+TL_Record_Read(TL_LOG_INFO *CurrentLog, uint32_t uiEntry, TL_DATA_REC *pRecord)
 {
-    (void)object_instance;
-    if (properties) {
-        *properties = Writable_Properties;
+    uint32_t uiOldest = 0;
+
+    if (CurrentLog->bCompressed) {
+        TL_Block_Record(CurrentLog, uiEntry, pRecord);
+    } else {
+        if (CurrentLog->ulRecordCount >= CurrentLog->ulBufferSize) {
+            uiOldest = (uint32_t)CurrentLog->iIndex;
+        }
+        TL_Record_Unpack(
+            TL_Record_Slot(
+                CurrentLog, (uiOldest + uiEntry) % CurrentLog->ulBufferSize),
+            pRecord);
     }
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need validate that the */
-/* given instance exists */
-bool Trend_Log_Valid_Instance(uint32_t object_instance)
+/**
+ * @brief Get the size of the storage block for the records of a log
+ * @param bCompressed - true for compressed records
+ * @param ulBufferSize - number of records
+ * @return size of the storage block in octets
+ */
+static size_t TL_Storage_Size(bool bCompressed, uint32_t ulBufferSize)
 {
-    if (object_instance < MAX_TREND_LOGS) {
-        return true;
+    if (bCompressed) {
+        return TL_COMPRESSED_STORAGE_SIZE(ulBufferSize);
     }
 
-    return false;
+    return TL_STORAGE_SIZE(ulBufferSize);
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then count how many you have */
-unsigned Trend_Log_Count(void)
+/**
+ * @brief Store the state of the circular buffer of a log in the header
+ *  of its storage block
+ * @param CurrentLog - the log
+ */
+static void TL_Storage_Header_Update(const TL_LOG_INFO *CurrentLog)
 {
-    return MAX_TREND_LOGS;
+    uint8_t *pHeader = CurrentLog->pStorage;
+
+    if (pHeader) {
+        encode_unsigned32(
+            &pHeader[TL_HEADER_INDEX], (uint32_t)CurrentLog->iIndex);
+        encode_unsigned32(
+            &pHeader[TL_HEADER_RECORD_COUNT], CurrentLog->ulRecordCount);
+        encode_unsigned32(
+            &pHeader[TL_HEADER_TOTAL_RECORD_COUNT],
+            CurrentLog->ulTotalRecordCount);
+        if (CurrentLog->bCompressed) {
+            encode_unsigned32(
+                &pHeader[TL_HEADER_BLOCKS_USED], CurrentLog->ulBlocksUsed);
+            encode_unsigned32(
+                &pHeader[TL_HEADER_OLDEST_SKIP], CurrentLog->ulOldestSkip);
+        }
+    }
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need to return the instance */
-/* that correlates to the correct index */
-uint32_t Trend_Log_Index_To_Instance(unsigned index)
+/**
+ * @brief Remove all the records of a log
+ * @param CurrentLog - the log
+ */
+static void TL_Records_Clear(TL_LOG_INFO *CurrentLog)
 {
-    return index;
+    CurrentLog->ulRecordCount = 0;
+    CurrentLog->iIndex = 0;
+    CurrentLog->ulBlocksUsed = 0;
+    CurrentLog->ulOldestSkip = 0;
+    CurrentLog->bReaderValid = false;
+    TL_Storage_Header_Update(CurrentLog);
 }
 
-/* we simply have 0-n object instances.  Yours might be */
-/* more complex, and then you need to return the index */
-/* that correlates to the correct instance number */
-unsigned Trend_Log_Instance_To_Index(uint32_t object_instance)
+/**
+ * @brief Get the storage block of a log, and resume the records that
+ *  are already in the block. An empty or foreign block is formatted,
+ *  as slots or as compressed blocks for the log.
+ * @param iLog - index of the log
+ * @param ulBufferSize - number of records for a new block
+ * @return true if the records of the block were resumed
+ */
+static bool TL_Storage_Open(int iLog, uint32_t ulBufferSize)
 {
-    unsigned index = MAX_TREND_LOGS;
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+    size_t size = TL_Storage_Size(CurrentLog->bCompressed, ulBufferSize);
+    size_t size_min = TL_Storage_Size(CurrentLog->bCompressed, 1);
+    uint8_t *pHeader = NULL;
+    uint32_t ulMagic = 0;
+    uint32_t ulRecordSize = 0;
+    uint32_t ulSize = 0;
+    uint32_t ulIndex = 0;
+    uint32_t ulCount = 0;
+    uint32_t ulBlocks = 0;
+    bool bCompressed = CurrentLog->bCompressed;
+    bool status = false;
 
-    if (object_instance < MAX_TREND_LOGS) {
-        index = object_instance;
+    CurrentLog->ulBufferSize = 0;
+    CurrentLog->ulBlockCount = 0;
+    CurrentLog->pStorage = NULL;
+    TL_Records_Clear(CurrentLog);
+    pHeader = Storage_Open_Callback(
+        Log_Device_Index(), Trend_Log_Index_To_Instance(iLog), &size);
+    if (pHeader && (size < size_min)) {
+        /* too small to be a log: purge it, and ask for a new block */
+        Storage_Close_Callback(
+            Log_Device_Index(), Trend_Log_Index_To_Instance(iLog), pHeader,
+            size, true);
+        size = TL_Storage_Size(CurrentLog->bCompressed, ulBufferSize);
+        pHeader = Storage_Open_Callback(
+            Log_Device_Index(), Trend_Log_Index_To_Instance(iLog), &size);
+        if (pHeader && (size < size_min)) {
+            Storage_Close_Callback(
+                Log_Device_Index(), Trend_Log_Index_To_Instance(iLog),
+                pHeader, size, true);
+            pHeader = NULL;
+        }
+    }
+    CurrentLog->pStorage = pHeader;
+    CurrentLog->StorageSize = size;
+    if (!pHeader) {
+        CurrentLog->StorageSize = 0;
+        return false;
+    }
+    decode_unsigned32(&pHeader[TL_HEADER_MAGIC], &ulMagic);
+    decode_unsigned32(&pHeader[TL_HEADER_RECORD_SIZE], &ulRecordSize);
+    decode_unsigned32(&pHeader[TL_HEADER_BUFFER_SIZE], &ulSize);
+    decode_unsigned32(&pHeader[TL_HEADER_INDEX], &ulIndex);
+    decode_unsigned32(&pHeader[TL_HEADER_RECORD_COUNT], &ulCount);
+    if ((ulMagic == TL_STORAGE_MAGIC) && (ulRecordSize == TL_RECORD_SIZE) &&
+        (ulSize > 0) && (ulSize <= TL_BUFFER_SIZE_MAX) &&
+        (TL_STORAGE_SIZE(ulSize) <= size) && (ulIndex < ulSize) &&
+        (ulCount <= ulSize)) {
+        CurrentLog->bCompressed = false;
+        CurrentLog->ulBufferSize = ulSize;
+        CurrentLog->iIndex = (int)ulIndex;
+        CurrentLog->ulRecordCount = ulCount;
+        decode_unsigned32(
+            &pHeader[TL_HEADER_TOTAL_RECORD_COUNT],
+            &CurrentLog->ulTotalRecordCount);
+        if (ulCount > 0) {
+            /* carry on from the newest record */
+            CurrentLog->tLastDataTime = TL_Record_Time_Stamp(
+                TL_Record_Slot(CurrentLog, (ulIndex + ulSize - 1) % ulSize));
+        }
+        status = true;
+    } else if (
+        (ulMagic == TL_STORAGE_MAGIC) &&
+        (ulRecordSize == (TL_COMPRESSED_FLAG | TL_BLOCK_SIZE)) &&
+        (size >= TL_COMPRESSED_STORAGE_SIZE(1)) && (ulSize > 0) &&
+        (ulSize <= TL_BUFFER_SIZE_MAX) && (ulCount <= ulSize)) {
+        ulBlocks =
+            (uint32_t)((size - TL_COMPRESSED_HEADER_SIZE) / TL_BLOCK_SIZE);
+        CurrentLog->bCompressed = true;
+        CurrentLog->ulBufferSize = ulSize;
+        CurrentLog->ulBlockCount = ulBlocks;
+        CurrentLog->iIndex = (int)ulIndex;
+        CurrentLog->ulRecordCount = ulCount;
+        decode_unsigned32(
+            &pHeader[TL_HEADER_TOTAL_RECORD_COUNT],
+            &CurrentLog->ulTotalRecordCount);
+        decode_unsigned32(
+            &pHeader[TL_HEADER_BLOCKS_USED], &CurrentLog->ulBlocksUsed);
+        decode_unsigned32(
+            &pHeader[TL_HEADER_OLDEST_SKIP], &CurrentLog->ulOldestSkip);
+        status = (ulIndex < ulBlocks) &&
+            (CurrentLog->ulBlocksUsed <= ulBlocks) &&
+            TL_Block_Resume(CurrentLog);
+    }
+    if (!status) {
+        CurrentLog->bCompressed = bCompressed;
+        CurrentLog->ulTotalRecordCount = 0;
+        CurrentLog->ulBlockCount = 0;
+        TL_Records_Clear(CurrentLog);
+        if (CurrentLog->bCompressed) {
+            ulSize = ulBufferSize;
+            CurrentLog->ulBlockCount =
+                (uint32_t)((size - TL_COMPRESSED_HEADER_SIZE) / TL_BLOCK_SIZE);
+            ulRecordSize = TL_COMPRESSED_FLAG | TL_BLOCK_SIZE;
+            memset(pHeader, 0, TL_COMPRESSED_HEADER_SIZE);
+        } else {
+            ulSize =
+                (uint32_t)((size - TL_STORAGE_HEADER_SIZE) / TL_RECORD_SIZE);
+            if (ulSize > ulBufferSize) {
+                ulSize = ulBufferSize;
+            }
+            ulRecordSize = TL_RECORD_SIZE;
+            memset(pHeader, 0, TL_STORAGE_HEADER_SIZE);
+        }
+        CurrentLog->ulBufferSize = ulSize;
+        encode_unsigned32(&pHeader[TL_HEADER_MAGIC], TL_STORAGE_MAGIC);
+        encode_unsigned32(&pHeader[TL_HEADER_RECORD_SIZE], ulRecordSize);
+        encode_unsigned32(&pHeader[TL_HEADER_BUFFER_SIZE], ulSize);
+        TL_Storage_Header_Update(CurrentLog);
     }
 
-    return index;
+    return status;
 }
 
 /**
- * @brief Get the current time from the Device object
- * @return current time in epoch seconds
+ * @brief Let go of the storage block of a log
+ * @param iLog - index of the log
+ * @param bPurge - true if the records are no longer wanted
  */
-static bacnet_time_t Trend_Log_Epoch_Seconds_Now(void)
+static void TL_Storage_Close(int iLog, bool bPurge)
 {
-    BACNET_DATE_TIME bdatetime;
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
 
-    Device_getCurrentDateTime(&bdatetime);
-    return datetime_seconds_since_epoch(&bdatetime);
+    if (CurrentLog->pStorage) {
+        Storage_Close_Callback(
+            Log_Device_Index(), Trend_Log_Index_To_Instance(iLog),
+            CurrentLog->pStorage, CurrentLog->StorageSize, bPurge);
+    }
+    CurrentLog->pStorage = NULL;
+    CurrentLog->StorageSize = 0;
+    CurrentLog->ulBufferSize = 0;
+    CurrentLog->ulBlockCount = 0;
+    TL_Records_Clear(CurrentLog);
+}
+
+/**
+ * @brief Add a record at the insertion point of a log, pushing the
+ *  oldest record out of a full log
+ * @param iLog - index of the log
+ * @param pRecord - the record to add
+ */
+static void TL_Record_Append(int iLog, const TL_DATA_REC *pRecord)
+{
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+
+    if (CurrentLog->ulBufferSize == 0) {
+        return;
+    }
+    if (CurrentLog->bCompressed) {
+        TL_Block_Append(CurrentLog, pRecord);
+        CurrentLog->ulTotalRecordCount++;
+        TL_Storage_Header_Update(CurrentLog);
+        return;
+    }
+    TL_Record_Pack(TL_Record_Slot(CurrentLog, CurrentLog->iIndex), pRecord);
+    CurrentLog->iIndex++;
+    if ((uint32_t)CurrentLog->iIndex >= CurrentLog->ulBufferSize) {
+        CurrentLog->iIndex = 0;
+    }
+
+    CurrentLog->ulTotalRecordCount++;
+
+    if (CurrentLog->ulRecordCount < CurrentLog->ulBufferSize) {
+        CurrentLog->ulRecordCount++;
+    }
+    TL_Storage_Header_Update(CurrentLog);
 }
 
 /*
@@ -205,19 +1359,22 @@ static bacnet_time_t Trend_Log_Epoch_Seconds_Now(void)
  */
 void Trend_Log_Init(void)
 {
-    static bool initialized = false;
     uint16_t dev_id;
     int iLog;
-    int iEntry;
+    uint32_t iEntry;
     BACNET_DATE_TIME bdatetime = { 0 };
     bacnet_time_t tClock;
     uint8_t month;
+    TL_DATA_REC TempRec = { 0 };
 #ifdef BAC_ROUTING
     uint16_t current_dev_id = Routed_Device_Object_Index();
 #endif
 
-    if (!initialized) {
-        initialized = true;
+    MEMSTAT_FIXED(MEMSTAT_LOG, LogInfos, sizeof(LogInfos));
+    if (!Trend_Log_Initialized) {
+        Trend_Log_Initialized = true;
+        COV_Listener.callback = TL_COV_Object_Changed;
+        cov_change_of_value_listener_add(&COV_Listener);
 
         /* initialize all the values */
 
@@ -225,42 +1382,50 @@ void Trend_Log_Init(void)
 #ifdef BAC_ROUTING
             Set_Routed_Device_Object_Index(dev_id);
 #endif
+            /* the timer fills the wheel when it first runs */
+            Schedule.bReady = false;
             for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
                 /*
-                 * Do we need to do anything here?
-                 * Trend logs are usually assumed to survive over resets
-                 * and are frequently implemented using Battery Backed RAM
-                 * If they are implemented using Flash or SD cards or some
-                 * such mechanism there may be some RAM based setup needed
-                 * for log management purposes.
+                 * Trend logs are usually assumed to survive over resets.
+                 * If the storage callbacks kept the records of the log,
+                 * e.g. in a file, we carry on from where the log was.
                  * We probably need to look at inserting LOG_INTERRUPTED
                  * entries into any active logs if the power down or reset
                  * may have caused us to miss readings.
                  */
-
-                /* We will just fill the logs with some entries for testing
-                 * purposes.
-                 */
-                /* Different month for each log */
-                month = iLog + 1;
-                datetime_set_values(&bdatetime, 2009, month, 1, 0, 0, 0, 0);
-                tClock = datetime_seconds_since_epoch(&bdatetime);
-                for (iEntry = 0; iEntry < TL_MAX_ENTRIES; iEntry++) {
-                    Logs[iLog][iEntry].tTimeStamp = tClock;
-                    Logs[iLog][iEntry].ucRecType = TL_TYPE_REAL;
-                    Logs[iLog][iEntry].Datum.fReal =
-                        (float)(iEntry + (iLog * TL_MAX_ENTRIES));
-                    /* Put status flags with every second log */
-                    if ((iLog & 1) == 0) {
-                        Logs[iLog][iEntry].ucStatus = 128;
-                    } else {
-                        Logs[iLog][iEntry].ucStatus = 0;
+                LogInfo[iLog].bCompressed = false;
+                if (!TL_Storage_Open(iLog, TL_MAX_ENTRIES)) {
+                    /* We will just fill the logs with some entries
+                     * for testing purposes.
+                     */
+                    /* Different month for each log */
+                    month = iLog + 1;
+                    datetime_set_values(
+                        &bdatetime, 2009, month, 1, 0, 0, 0, 0);
+                    tClock = datetime_seconds_since_epoch(&bdatetime);
+                    for (iEntry = 0; iEntry < LogInfo[iLog].ulBufferSize;
+                         iEntry++) {
+                        TempRec.tTimeStamp = tClock;
+                        TempRec.ucRecType = TL_TYPE_REAL;
+                        TempRec.Datum.fReal =
+                            (float)(iEntry + (iLog * TL_MAX_ENTRIES));
+                        /* Put status flags with every second log */
+                        if ((iLog & 1) == 0) {
+                            TempRec.ucStatus = 128;
+                        } else {
+                            TempRec.ucStatus = 0;
+                        }
+                        TL_Record_Append(iLog, &TempRec);
+                        /* advance 15 minutes, in seconds */
+                        tClock += 900;
+                    }
+                    LogInfo[iLog].tLastDataTime = tClock - 900;
+                    if (LogInfo[iLog].ulBufferSize > 0) {
+                        LogInfo[iLog].ulTotalRecordCount = 10000;
+                        TL_Storage_Header_Update(&LogInfo[iLog]);
                     }
-                    /* advance 15 minutes, in seconds */
-                    tClock += 900;
                 }
 
-                LogInfo[iLog].tLastDataTime = tClock - 900;
                 LogInfo[iLog].bAlignIntervals = true;
                 LogInfo[iLog].bEnable = true;
                 LogInfo[iLog].bStopWhenFull = false;
@@ -269,10 +1434,14 @@ void Trend_Log_Init(void)
                 LogInfo[iLog].Source.arrayIndex = 0;
                 LogInfo[iLog].ucTimeFlags = 0;
                 LogInfo[iLog].ulIntervalOffset = 0;
-                LogInfo[iLog].iIndex = 0;
                 LogInfo[iLog].ulLogInterval = 900;
-                LogInfo[iLog].ulRecordCount = TL_MAX_ENTRIES;
-                LogInfo[iLog].ulTotalRecordCount = 10000;
+                LogInfo[iLog].bCOVPending = false;
+                LogInfo[iLog].bCOVSubscribed = false;
+                LogInfo[iLog].tCOVDueTime = 0;
+                LogInfo[iLog].ulCOVResubscriptionInterval =
+                    TL_COV_RESUBSCRIPTION_INTERVAL;
+                LogInfo[iLog].bClientCOVIncrement = false;
+                LogInfo[iLog].fClientCOVIncrement = 0.0f;
 
                 LogInfo[iLog].Source.deviceIdentifier.instance =
                     Device_Object_Instance_Number();
@@ -301,6 +1470,36 @@ void Trend_Log_Init(void)
     return;
 }
 
+/**
+ * @brief Let go of the storage of all the Trend Logs. The records stay
+ *  in storage that outlives the stack, e.g. a file, and are resumed
+ *  by the next Trend_Log_Init().
+ */
+void Trend_Log_Cleanup(void)
+{
+    uint16_t dev_id;
+    int iLog;
+#ifdef BAC_ROUTING
+    uint16_t current_dev_id = Routed_Device_Object_Index();
+#endif
+
+    if (Trend_Log_Initialized) {
+        for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
+#ifdef BAC_ROUTING
+            Set_Routed_Device_Object_Index(dev_id);
+#endif
+            for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
+                TL_Storage_Close(iLog, false);
+            }
+        }
+        cov_change_of_value_listener_remove(&COV_Listener);
+        Trend_Log_Initialized = false;
+    }
+#ifdef BAC_ROUTING
+    Set_Routed_Device_Object_Index(current_dev_id);
+#endif
+}
+
 /*
  * Note: we use the instance number here and build the name based
  * on the assumption that there is a 1 to 1 correspondence. If there
@@ -359,11 +1558,109 @@ uint32_t Trend_Log_Buffer_Size(uint32_t object_instance)
 {
     uint32_t buffer_size = 0;
     if (object_instance < MAX_TREND_LOGS) {
-        buffer_size = TL_MAX_ENTRIES;
+        buffer_size = LogInfo[object_instance].ulBufferSize;
     }
     return buffer_size;
 }
 
+/**
+ * @brief Set the buffer size of a Trend Log object. The log is purged,
+ *  and keeps its buffer size if the new storage can not be had.
+ * @param object_instance - object-instance number of the object
+ * @param size - number of records, from 1 to TL_BUFFER_SIZE_MAX
+ * @return true if the buffer size was set
+ */
+bool Trend_Log_Buffer_Size_Set(uint32_t object_instance, uint32_t size)
+{
+    unsigned log_index;
+    uint32_t old_size;
+    uint32_t total_records;
+    bool status = false;
+
+    log_index = Trend_Log_Instance_To_Index(object_instance);
+    if ((log_index < MAX_TREND_LOGS) && (size > 0) &&
+        (size <= TL_BUFFER_SIZE_MAX)) {
+        old_size = LogInfo[log_index].ulBufferSize;
+        total_records = LogInfo[log_index].ulTotalRecordCount;
+        TL_Storage_Close(log_index, true);
+        TL_Storage_Open(log_index, size);
+        if (LogInfo[log_index].ulBufferSize == size) {
+            status = true;
+        } else if (old_size > 0) {
+            TL_Storage_Close(log_index, true);
+            TL_Storage_Open(log_index, old_size);
+        }
+        /* the total record count carries on over a purge */
+        LogInfo[log_index].ulTotalRecordCount = total_records;
+        TL_Insert_Status_Rec(log_index, LOG_STATUS_BUFFER_PURGED, true);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Determine if the records of a Trend Log object are compressed
+ * @param object_instance - object-instance number of the object
+ * @return true if the records are packed in compressed blocks
+ */
+bool Trend_Log_Compressed(uint32_t object_instance)
+{
+    unsigned log_index;
+    bool compressed = false;
+
+    log_index = Trend_Log_Instance_To_Index(object_instance);
+    if (log_index < MAX_TREND_LOGS) {
+        compressed = LogInfo[log_index].bCompressed;
+    }
+
+    return compressed;
+}
+
+/**
+ * @brief Set the records of a Trend Log object to be kept in slots or in
+ *  compressed blocks. The log is purged when this changes, and keeps its
+ *  records as they were kept if the new storage can not be had.
+ * @param object_instance - object-instance number of the object
+ * @param compressed - true to pack the records in compressed blocks
+ * @return true if the records are kept as asked
+ */
+bool Trend_Log_Compressed_Set(uint32_t object_instance, bool compressed)
+{
+    unsigned log_index;
+    uint32_t buffer_size;
+    uint32_t total_records;
+    TL_LOG_INFO *CurrentLog;
+    bool status = false;
+
+    log_index = Trend_Log_Instance_To_Index(object_instance);
+    if (log_index < MAX_TREND_LOGS) {
+        CurrentLog = &LogInfo[log_index];
+        if (CurrentLog->bCompressed == compressed) {
+            return true;
+        }
+        buffer_size = CurrentLog->ulBufferSize;
+        if (buffer_size == 0) {
+            buffer_size = TL_MAX_ENTRIES;
+        }
+        total_records = CurrentLog->ulTotalRecordCount;
+        TL_Storage_Close(log_index, true);
+        CurrentLog->bCompressed = compressed;
+        TL_Storage_Open(log_index, buffer_size);
+        if (CurrentLog->ulBufferSize == buffer_size) {
+            status = true;
+        } else {
+            TL_Storage_Close(log_index, true);
+            CurrentLog->bCompressed = !compressed;
+            TL_Storage_Open(log_index, buffer_size);
+        }
+        /* the total record count carries on over a purge */
+        CurrentLog->ulTotalRecordCount = total_records;
+        TL_Insert_Status_Rec(log_index, LOG_STATUS_BUFFER_PURGED, true);
+    }
+
+    return status;
+}
+
 /* return the length of the apdu encoded or BACNET_STATUS_ERROR for error or
    BACNET_STATUS_ABORT for abort message */
 int Trend_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
@@ -417,7 +1714,8 @@ int Trend_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
 
         case PROP_BUFFER_SIZE:
-            apdu_len = encode_application_unsigned(&apdu[0], TL_MAX_ENTRIES);
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulBufferSize);
             break;
 
         case PROP_LOG_BUFFER:
@@ -517,6 +1815,22 @@ int Trend_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 encode_application_boolean(&apdu[0], CurrentLog->bTrigger);
             break;
 
+        case PROP_COV_RESUBSCRIPTION_INTERVAL:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulCOVResubscriptionInterval);
+            break;
+
+        case PROP_CLIENT_COV_INCREMENT:
+            /* BACnetClientCOV ::= CHOICE {
+                   real-increment REAL, default-increment NULL } */
+            if (CurrentLog->bClientCOVIncrement) {
+                apdu_len = encode_application_real(
+                    &apdu[0], CurrentLog->fClientCOVIncrement);
+            } else {
+                apdu_len = encode_application_null(&apdu[0]);
+            }
+            break;
+
         default:
             rpdata->error_class = ERROR_CLASS_PROPERTY;
             rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
@@ -552,7 +1866,10 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     len = bacapp_decode_application_data(
         wp_data->application_data, wp_data->application_data_len, &value);
     /* FIXME: len < application_data_len: more data? */
-    if (len < 0) {
+    /* the device object property reference is context tagged,
+       and is decoded by itself */
+    if ((len < 0) &&
+        (wp_data->object_property != PROP_LOG_DEVICE_OBJECT_PROPERTY)) {
         /* error while decoding - a value larger than we can handle */
         wp_data->error_class = ERROR_CLASS_PROPERTY;
         wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
@@ -567,7 +1884,7 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                  * set */
                 if ((CurrentLog->bEnable == false) &&
                     (CurrentLog->bStopWhenFull == true) &&
-                    (CurrentLog->ulRecordCount == TL_MAX_ENTRIES) &&
+                    (CurrentLog->ulRecordCount == CurrentLog->ulBufferSize) &&
                     (value.type.Boolean == true)) {
                     status = false;
                     wp_data->error_class = ERROR_CLASS_OBJECT;
@@ -610,7 +1927,8 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     CurrentLog->bStopWhenFull = value.type.Boolean;
 
                     if ((value.type.Boolean == true) &&
-                        (CurrentLog->ulRecordCount == TL_MAX_ENTRIES) &&
+                        (CurrentLog->ulRecordCount ==
+                         CurrentLog->ulBufferSize) &&
                         (CurrentLog->bEnable == true)) {
                         /* When full log is switched from normal to stop when
                          * full disable the log and record the fact - see
@@ -625,12 +1943,33 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             break;
 
         case PROP_BUFFER_SIZE:
-            /* Fixed size buffer so deny write. If buffer size was writable
-             * we would probably erase the current log, resize, re-initalise
-             * and carry on - however write is not allowed if enable is true.
+            /* Resizing the buffer erases the current log, and the
+             * write is not allowed if enable is true.
              */
-            wp_data->error_class = ERROR_CLASS_PROPERTY;
-            wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                if (CurrentLog->bEnable) {
+                    status = false;
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+                } else if (
+                    (value.type.Unsigned_Int == 0) ||
+                    (value.type.Unsigned_Int > TL_BUFFER_SIZE_MAX)) {
+                    status = false;
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                } else {
+                    status = Trend_Log_Buffer_Size_Set(
+                        wp_data->object_instance,
+                        (uint32_t)value.type.Unsigned_Int);
+                    if (!status) {
+                        wp_data->error_class = ERROR_CLASS_RESOURCES;
+                        wp_data->error_code =
+                            ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+                    }
+                }
+            }
             break;
 
         case PROP_RECORD_COUNT:
@@ -639,8 +1978,7 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             if (status) {
                 if (value.type.Unsigned_Int == 0) {
                     /* Time to clear down the log */
-                    CurrentLog->ulRecordCount = 0;
-                    CurrentLog->iIndex = 0;
+                    TL_Records_Clear(CurrentLog);
                     TL_Insert_Status_Rec(
                         log_index, LOG_STATUS_BUFFER_PURGED, true);
                 }
@@ -649,33 +1987,37 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 
         case PROP_LOGGING_TYPE:
             /* logic
-             * triggered and polled options.
+             * triggered, polled and COV options.
              */
             status = write_property_type_valid(
                 wp_data, &value, BACNET_APPLICATION_TAG_ENUMERATED);
             if (status) {
-                if (value.type.Enumerated != LOGGING_TYPE_COV) {
-                    CurrentLog->LoggingType =
-                        (BACNET_LOGGING_TYPE)value.type.Enumerated;
-                    if (value.type.Enumerated == LOGGING_TYPE_POLLED) {
-                        /* As per 12.25.27 pick a suitable default if interval
-                         * is 0 */
-                        if (CurrentLog->ulLogInterval == 0) {
-                            CurrentLog->ulLogInterval = 900;
-                        }
-                    }
-                    if (value.type.Enumerated == LOGGING_TYPE_TRIGGERED) {
-                        /* As per 12.25.27 0 the interval if triggered logging
-                         * selected */
-                        CurrentLog->ulLogInterval = 0;
-                    }
-                } else {
-                    /* We don't currently support COV */
+                if ((value.type.Enumerated != LOGGING_TYPE_COV) &&
+                    !TL_Source_Local(&CurrentLog->Source)) {
+                    /* We only support COV logging of a remote source */
                     status = false;
                     wp_data->error_class = ERROR_CLASS_PROPERTY;
                     wp_data->error_code =
                         ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
+                    break;
                 }
+                TL_COV_Stop(log_index);
+                CurrentLog->LoggingType =
+                    (BACNET_LOGGING_TYPE)value.type.Enumerated;
+                if (value.type.Enumerated == LOGGING_TYPE_POLLED) {
+                    /* As per 12.25.27 pick a suitable default if interval
+                     * is 0 */
+                    if (CurrentLog->ulLogInterval == 0) {
+                        CurrentLog->ulLogInterval = 900;
+                    }
+                }
+                if ((value.type.Enumerated == LOGGING_TYPE_TRIGGERED) ||
+                    (value.type.Enumerated == LOGGING_TYPE_COV)) {
+                    /* As per 12.25.27 0 the interval if triggered or
+                     * COV logging selected */
+                    CurrentLog->ulLogInterval = 0;
+                }
+                TL_COV_Start(log_index);
             }
             break;
 
@@ -790,10 +2132,11 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 wp_data->error_code = ERROR_CODE_OTHER;
                 break;
             }
-            /* We only support references to objects in ourself for now */
-            if ((TempSource.deviceIdentifier.type == OBJECT_DEVICE) &&
-                (TempSource.deviceIdentifier.instance !=
-                 Device_Object_Instance_Number())) {
+            /* We only support references to objects in other devices
+               with COV logging, using a COV subscription */
+            if (!TL_Source_Local(&TempSource) &&
+                ((CurrentLog->LoggingType != LOGGING_TYPE_COV) ||
+                 !COV_Subscribe_Callback)) {
                 wp_data->error_class = ERROR_CLASS_PROPERTY;
                 wp_data->error_code =
                     ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
@@ -805,11 +2148,12 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     &TempSource, &CurrentLog->Source,
                     sizeof(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE)) != 0) {
                 /* Clear buffer if property being logged is changed */
-                CurrentLog->ulRecordCount = 0;
-                CurrentLog->iIndex = 0;
+                TL_Records_Clear(CurrentLog);
                 TL_Insert_Status_Rec(log_index, LOG_STATUS_BUFFER_PURGED, true);
+                TL_COV_Stop(log_index);
+                CurrentLog->Source = TempSource;
+                TL_COV_Start(log_index);
             }
-            CurrentLog->Source = TempSource;
             status = true;
             break;
 
@@ -825,9 +2169,9 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             if (status) {
                 if ((CurrentLog->LoggingType == LOGGING_TYPE_POLLED) &&
                     (value.type.Unsigned_Int == 0)) {
-                    /* We don't support COV at the moment so don't allow
-                     * switching to it by clearing interval whilst in polling
-                     * mode */
+                    /* An interval of 0 is not polling, and COV logging is
+                     * selected by writing the Logging_Type, so don't allow
+                     * clearing the interval whilst in polling mode */
                     wp_data->error_class = ERROR_CLASS_PROPERTY;
                     wp_data->error_code =
                         ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
@@ -879,15 +2223,59 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     status = false;
                 } else {
                     CurrentLog->bTrigger = value.type.Boolean;
+                    if (CurrentLog->bTrigger) {
+                        Schedule.bTriggers = true;
+                    }
                 }
             }
             break;
 
+        case PROP_COV_RESUBSCRIPTION_INTERVAL:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                if (value.type.Unsigned_Int <= UINT32_MAX) {
+                    CurrentLog->ulCOVResubscriptionInterval =
+                        value.type.Unsigned_Int;
+                    TL_COV_Restart(log_index);
+                } else {
+                    status = false;
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                }
+            }
+            break;
+
+        case PROP_CLIENT_COV_INCREMENT:
+            if (value.tag == BACNET_APPLICATION_TAG_NULL) {
+                CurrentLog->bClientCOVIncrement = false;
+                TL_COV_Restart(log_index);
+                status = true;
+            } else if (value.tag == BACNET_APPLICATION_TAG_REAL) {
+                if (isless(value.type.Real, 0.0f)) {
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                } else {
+                    CurrentLog->bClientCOVIncrement = true;
+                    CurrentLog->fClientCOVIncrement = value.type.Real;
+                    TL_COV_Restart(log_index);
+                    status = true;
+                }
+            } else {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+            }
+            break;
+
         default:
             wp_data->error_class = ERROR_CLASS_PROPERTY;
             wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
             break;
     }
+    if (status) {
+        /* the write may change when the log is next due */
+        TL_Schedule_Update(log_index);
+    }
 
     return status;
 }
@@ -923,11 +2311,8 @@ bool TrendLogGetRRInfo(
 
 void TL_Insert_Status_Rec(int iLog, BACNET_LOG_STATUS eStatus, bool bState)
 {
-    TL_LOG_INFO *CurrentLog;
     TL_DATA_REC TempRec;
 
-    CurrentLog = &LogInfo[iLog];
-
     TempRec.tTimeStamp = Trend_Log_Epoch_Seconds_Now();
     TempRec.ucRecType = TL_TYPE_STATUS;
     TempRec.ucStatus = 0;
@@ -952,27 +2337,18 @@ void TL_Insert_Status_Rec(int iLog, BACNET_LOG_STATUS eStatus, bool bState)
             break;
     }
 
-    Logs[iLog][CurrentLog->iIndex++] = TempRec;
-    if (CurrentLog->iIndex >= TL_MAX_ENTRIES) {
-        CurrentLog->iIndex = 0;
-    }
-
-    CurrentLog->ulTotalRecordCount++;
-
-    if (CurrentLog->ulRecordCount < TL_MAX_ENTRIES) {
-        CurrentLog->ulRecordCount++;
-    }
+    TL_Record_Append(iLog, &TempRec);
 }
 
 /*****************************************************************************
  * Use the combination of the enable flag and the enable times to determine  *
- * if the log is really enabled now. See 135-2008 sections 12.25.5 - 12.25.7 *
+ * if the log is really enabled at a given time.                             *
+ * See 135-2008 sections 12.25.5 - 12.25.7                                   *
  *****************************************************************************/
 
-bool TL_Is_Enabled(int iLog)
+static bool TL_Is_Enabled_Time(int iLog, bacnet_time_t tNow)
 {
     TL_LOG_INFO *CurrentLog;
-    bacnet_time_t tNow;
     bool bStatus;
 
     bStatus = true;
@@ -993,7 +2369,6 @@ bool TL_Is_Enabled(int iLog)
         bStatus = false;
     } else if (CurrentLog->ucTimeFlags != (TL_T_START_WILD | TL_T_STOP_WILD)) {
         /* enabled and either 1 wild card or none */
-        tNow = Trend_Log_Epoch_Seconds_Now();
 #if 0
         printf("\nFlags - %u, Current - %u, Start - %u, Stop - %u\n",
             (unsigned int) CurrentLog->ucTimeFlags, (unsigned int) Now,
@@ -1027,6 +2402,11 @@ bool TL_Is_Enabled(int iLog)
     return (bStatus);
 }
 
+bool TL_Is_Enabled(int iLog)
+{
+    return TL_Is_Enabled_Time(iLog, Trend_Log_Epoch_Seconds_Now());
+}
+
 /*****************************************************************************
  * Convert a BACnet time into a local time in seconds since the local epoch  *
  *****************************************************************************/
@@ -1391,6 +2771,40 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     return (iLen);
 }
 
+/**
+ * @brief Count the records, from the oldest, that are before a time.
+ *  The records are in time order, so a binary search over the ring
+ *  of records finds the count.
+ * @param iLog - Index of the log.
+ * @param tRefTime - The reference time in local format.
+ * @param bInclusive - true to count the records at the reference time too.
+ * @return number of records before the reference time, from 0 to the
+ *  record count of the log.
+ */
+static uint32_t
+TL_Time_Position(int iLog, bacnet_time_t tRefTime, bool bInclusive)
+{
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+    uint32_t uiLeft = 0;
+    uint32_t uiRight = CurrentLog->ulRecordCount;
+    uint32_t uiMiddle = 0;
+    bacnet_time_t tTime = 0;
+    TL_DATA_REC TempRec;
+
+    while (uiLeft < uiRight) {
+        uiMiddle = uiLeft + ((uiRight - uiLeft) / 2);
+        TL_Record_Read(CurrentLog, uiMiddle, &TempRec);
+        tTime = TempRec.tTimeStamp;
+        if ((tTime < tRefTime) || (bInclusive && (tTime == tRefTime))) {
+            uiLeft = uiMiddle + 1;
+        } else {
+            uiRight = uiMiddle;
+        }
+    }
+
+    return uiLeft;
+}
+
 /**
  * @brief Handle encoding for the By Time option.
  * @note The fact that the buffer always has at least a single entry
@@ -1422,32 +2836,17 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     CurrentLog = &LogInfo[log_index];
 
     tRefTime = TL_BAC_Time_To_Local(&pRequest->Range.RefTime);
-    /* Find correct position for oldest entry in log */
-    if (CurrentLog->ulRecordCount < TL_MAX_ENTRIES) {
-        uiIndex = 0;
-    } else {
-        uiIndex = CurrentLog->iIndex;
-    }
-
     if (pRequest->Count < 0) {
-        /* Start at end of log and look for record which has
-         * timestamp greater than or equal to the reference.
+        /* Look for the last record which has a timestamp
+         * less than the reference.
          */
-        iCount = CurrentLog->ulRecordCount - 1;
-        /* Start out with the sequence number for the last record */
-        uiFirstSeq = CurrentLog->ulTotalRecordCount;
-        for (;;) {
-            if (Logs[log_index][(uiIndex + iCount) % TL_MAX_ENTRIES]
-                    .tTimeStamp < tRefTime) {
-                break;
-            }
-
-            uiFirstSeq--;
-            iCount--;
-            if (iCount < 0) {
-                return (0);
-            }
+        iCount = (int)TL_Time_Position(log_index, tRefTime, false) - 1;
+        if (iCount < 0) {
+            return (0);
         }
+        /* The sequence number for that record */
+        uiFirstSeq = CurrentLog->ulTotalRecordCount -
+            (CurrentLog->ulRecordCount - 1 - (uint32_t)iCount);
 
         /* We have an and point for our request,
          * now work backwards to find where we should start from
@@ -1469,26 +2868,17 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
             iCount -= iTemp;
         }
     } else {
-        /* Start at beginning of log and look for 1st record which has
-         * timestamp greater than the reference time.
+        /* Look for the 1st record which has a timestamp
+         * greater than the reference time.
          */
-        iCount = 0;
-        /* Figure out the sequence number for the first record, last is
-         * ulTotalRecordCount */
-        uiFirstSeq =
-            CurrentLog->ulTotalRecordCount - (CurrentLog->ulRecordCount - 1);
-        for (;;) {
-            if (Logs[log_index][(uiIndex + iCount) % TL_MAX_ENTRIES]
-                    .tTimeStamp > tRefTime) {
-                break;
-            }
-
-            uiFirstSeq++;
-            iCount++;
-            if ((uint32_t)iCount == CurrentLog->ulRecordCount) {
-                return (0);
-            }
+        iCount = (int)TL_Time_Position(log_index, tRefTime, true);
+        if ((uint32_t)iCount == CurrentLog->ulRecordCount) {
+            return (0);
         }
+        /* Figure out the sequence number for that record, the first
+         * record is ulTotalRecordCount - (ulRecordCount - 1) */
+        uiFirstSeq = CurrentLog->ulTotalRecordCount -
+            (CurrentLog->ulRecordCount - 1) + (uint32_t)iCount;
     }
 
     /* We now have a starting point for the operation and a +ve count */
@@ -1546,21 +2936,16 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 int TL_encode_entry(uint8_t *apdu, int iLog, int iEntry)
 {
     int iLen = 0;
-    TL_DATA_REC *pSource = NULL;
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+    TL_DATA_REC TempRec;
+    TL_DATA_REC *pSource = &TempRec;
     BACNET_BIT_STRING TempBits;
     uint8_t ucCount = 0;
     BACNET_DATE_TIME TempTime;
 
-    /* Convert from BACnet 1 based to 0 based array index and then
-     * handle wrap around of the circular buffer */
-
-    if (LogInfo[iLog].ulRecordCount < TL_MAX_ENTRIES) {
-        pSource = &Logs[iLog][(iEntry - 1) % TL_MAX_ENTRIES];
-    } else {
-        pSource =
-            &Logs[iLog][(LogInfo[iLog].iIndex + iEntry - 1) % TL_MAX_ENTRIES];
-    }
-
+    /* Convert from BACnet 1 based to 0 based array index */
+    TL_Record_Read(CurrentLog, (uint32_t)(iEntry - 1), &TempRec);
+
     iLen = 0;
     /* First stick the time stamp in with tag [0] */
     TL_Local_Time_To_BAC(&TempTime, pSource->tTimeStamp);
@@ -1705,11 +3090,198 @@ static int local_read_property(
     return (len);
 }
 
+/**
+ * @brief Store a bit string in a record, truncated at 32 bits
+ * @param pRecord - the record
+ * @param pBits - the bit string
+ */
+static void
+TL_Record_Bits_Set(TL_DATA_REC *pRecord, const BACNET_BIT_STRING *pBits)
+{
+    uint8_t ucCount;
+
+    pRecord->ucRecType = TL_TYPE_BITS;
+    /* We truncate any bitstrings at 32 bits to conserve space */
+    if (bitstring_bits_used(pBits) < 32) {
+        /* Store the bytes used and the bits free
+           in the last byte */
+        pRecord->Datum.Bits.ucLen = bitstring_bytes_used(pBits) << 4;
+        pRecord->Datum.Bits.ucLen |= (8 - (bitstring_bits_used(pBits) % 8)) & 7;
+        /* Fetch the octets with the bits directly */
+        for (ucCount = 0; ucCount < bitstring_bytes_used(pBits); ucCount++) {
+            pRecord->Datum.Bits.ucStore[ucCount] =
+                bitstring_octet(pBits, ucCount);
+        }
+    } else {
+        /* We will only use the first 4 octets to save space */
+        pRecord->Datum.Bits.ucLen = 4 << 4;
+        for (ucCount = 0; ucCount < 4; ucCount++) {
+            pRecord->Datum.Bits.ucStore[ucCount] =
+                bitstring_octet(pBits, ucCount);
+        }
+    }
+}
+
+/**
+ * @brief Read the logged property of a local object with the typed
+ *  present-value and status-flags functions of the object, without
+ *  encoding and decoding the value, or building a value list.
+ * @param iLog - Index of the log to fetch the property for.
+ * @param pRecord - [out] the record with the value and status flags
+ * @return true if the object has the typed functions for the property
+ */
+static bool TL_fetch_present_value(int iLog, TL_DATA_REC *pRecord)
+{
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_BIT_STRING status_flags;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    bool boolean_value = false;
+
+    Source = &LogInfo[iLog].Source;
+    if (Source->arrayIndex != BACNET_ARRAY_ALL) {
+        return false;
+    }
+    object_type = Source->objectIdentifier.type;
+    object_instance = Source->objectIdentifier.instance;
+    if (!Device_Status_Flags(object_type, object_instance, &status_flags)) {
+        return false;
+    }
+    if (Source->propertyIdentifier == PROP_STATUS_FLAGS) {
+        TL_Record_Bits_Set(pRecord, &status_flags);
+    } else if (Source->propertyIdentifier != PROP_PRESENT_VALUE) {
+        return false;
+    } else if (Device_Present_Value_Real(
+                   object_type, object_instance, &pRecord->Datum.fReal)) {
+        pRecord->ucRecType = TL_TYPE_REAL;
+    } else if (Device_Present_Value_Enumerated(
+                   object_type, object_instance, &pRecord->Datum.ulEnum)) {
+        pRecord->ucRecType = TL_TYPE_ENUM;
+    } else if (Device_Present_Value_Unsigned(
+                   object_type, object_instance, &unsigned_value)) {
+        pRecord->ucRecType = TL_TYPE_UNSIGN;
+        pRecord->Datum.ulUValue = unsigned_value;
+    } else if (Device_Present_Value_Boolean(
+                   object_type, object_instance, &boolean_value)) {
+        pRecord->ucRecType = TL_TYPE_BOOL;
+        pRecord->Datum.ucBoolean = boolean_value;
+    } else {
+        return false;
+    }
+    pRecord->ucStatus = 128 | bitstring_octet(&status_flags, 0);
+
+    return true;
+}
+
+/**
+ * @brief Store the logged property from a list of values, such as the
+ *  value list of a local object or the values of a COV notification
+ * @param Source - the logged property
+ * @param value_list - the list of values
+ * @param bStatusRequired - true if the list must have the status flags
+ * @param pRecord - [out] the record with the value and status flags
+ * @return true if the list has the value of the logged property
+ */
+static bool TL_Record_Value_List(
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source,
+    const BACNET_PROPERTY_VALUE *value_list,
+    bool bStatusRequired,
+    TL_DATA_REC *pRecord)
+{
+    const BACNET_PROPERTY_VALUE *pValue;
+    const BACNET_APPLICATION_DATA_VALUE *pData = NULL;
+    const BACNET_APPLICATION_DATA_VALUE *pStatus = NULL;
+
+    for (pValue = value_list; pValue; pValue = pValue->next) {
+        if ((pValue->propertyIdentifier == Source->propertyIdentifier) &&
+            (pValue->propertyArrayIndex == Source->arrayIndex)) {
+            pData = &pValue->value;
+        }
+        if ((pValue->propertyIdentifier == PROP_STATUS_FLAGS) &&
+            (pValue->value.tag == BACNET_APPLICATION_TAG_BIT_STRING)) {
+            pStatus = &pValue->value;
+        }
+    }
+    if (!pData || (bStatusRequired && !pStatus)) {
+        return false;
+    }
+    switch (pData->tag) {
+        case BACNET_APPLICATION_TAG_NULL:
+            pRecord->ucRecType = TL_TYPE_NULL;
+            break;
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            pRecord->ucRecType = TL_TYPE_BOOL;
+            pRecord->Datum.ucBoolean = pData->type.Boolean;
+            break;
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            pRecord->ucRecType = TL_TYPE_UNSIGN;
+            pRecord->Datum.ulUValue = pData->type.Unsigned_Int;
+            break;
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            pRecord->ucRecType = TL_TYPE_SIGN;
+            pRecord->Datum.lSValue = pData->type.Signed_Int;
+            break;
+        case BACNET_APPLICATION_TAG_REAL:
+            pRecord->ucRecType = TL_TYPE_REAL;
+            pRecord->Datum.fReal = pData->type.Real;
+            break;
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            TL_Record_Bits_Set(pRecord, &pData->type.Bit_String);
+            break;
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            pRecord->ucRecType = TL_TYPE_ENUM;
+            pRecord->Datum.ulEnum = pData->type.Enumerated;
+            break;
+        default:
+            /* let the ReadProperty path handle the other datatypes */
+            return false;
+    }
+    if (pStatus) {
+        pRecord->ucStatus =
+            128 | bitstring_octet(&pStatus->type.Bit_String, 0);
+    } else {
+        pRecord->ucStatus = 0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read the logged property of a local object directly from the
+ *  value list of the object, which an object has for COV reporting,
+ *  without encoding and decoding the value.
+ * @param iLog - Index of the log to fetch the property for.
+ * @param pRecord - [out] the record with the value and status flags
+ * @return true if the object has the value in its value list
+ */
+static bool TL_fetch_value_list(int iLog, TL_DATA_REC *pRecord)
+{
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source;
+    BACNET_PROPERTY_VALUE value_list[2];
+
+    Source = &LogInfo[iLog].Source;
+    if ((Source->arrayIndex != BACNET_ARRAY_ALL) ||
+        ((Source->propertyIdentifier != PROP_PRESENT_VALUE) &&
+         (Source->propertyIdentifier != PROP_STATUS_FLAGS))) {
+        return false;
+    }
+    bacapp_property_value_list_init(value_list, 2);
+    if (!Device_Encode_Value_List(
+            Source->objectIdentifier.type, Source->objectIdentifier.instance,
+            value_list)) {
+        return false;
+    }
+
+    return TL_Record_Value_List(Source, value_list, true, pRecord);
+}
+
 /**
  * @brief Attempt to fetch the logged property and store it in the Trend Log
  * @param iLog - Index of the log to fetch the property for.
+ * @param tNow - the current time, in seconds since the epoch
  */
-static void TL_fetch_property(int iLog)
+static void TL_fetch_property(int iLog, bacnet_time_t tNow)
 {
     /* This is a big buffer in case someone selects
        the device object list for example */
@@ -1719,9 +3291,8 @@ static void TL_fetch_property(int iLog)
     BACNET_ERROR_CLASS error_class = ERROR_CLASS_SERVICES;
     BACNET_ERROR_CODE error_code = ERROR_CODE_OTHER;
     int iLen;
-    uint8_t ucCount;
     TL_LOG_INFO *CurrentLog;
-    TL_DATA_REC TempRec;
+    TL_DATA_REC TempRec = { 0 };
     BACNET_BIT_STRING TempBits;
     BACNET_UNSIGNED_INTEGER unsigned_value = 0;
     BACNET_TAG tag = { 0 };
@@ -1730,12 +3301,18 @@ static void TL_fetch_property(int iLog)
 
     /* Record the current time in the log entry and also in the info block
      * for the log so we can figure out when the next reading is due */
-    TempRec.tTimeStamp = Trend_Log_Epoch_Seconds_Now();
+    TempRec.tTimeStamp = tNow;
     CurrentLog->tLastDataTime = TempRec.tTimeStamp;
     TempRec.ucStatus = 0;
 
+    if (TL_fetch_present_value(iLog, &TempRec) ||
+        TL_fetch_value_list(iLog, &TempRec)) {
+        TL_Record_Append(iLog, &TempRec);
+        return;
+    }
     iLen = local_read_property(
         ValueBuf, StatusBuf, &LogInfo[iLog].Source, &error_class, &error_code);
+
     if (iLen < 0) {
         /* Insert error code into log */
         TempRec.Datum.Error.usClass = error_class;
@@ -1779,32 +3356,10 @@ static void TL_fetch_property(int iLog)
                 break;
 
             case BACNET_APPLICATION_TAG_BIT_STRING:
-                TempRec.ucRecType = TL_TYPE_BITS;
                 bacnet_bitstring_decode(
                     &ValueBuf[iLen], sizeof(ValueBuf) - iLen,
                     tag.len_value_type, &TempBits);
-                /* We truncate any bitstrings at 32 bits to conserve space */
-                if (bitstring_bits_used(&TempBits) < 32) {
-                    /* Store the bytes used and the bits free
-                       in the last byte */
-                    TempRec.Datum.Bits.ucLen = bitstring_bytes_used(&TempBits)
-                        << 4;
-                    TempRec.Datum.Bits.ucLen |=
-                        (8 - (bitstring_bits_used(&TempBits) % 8)) & 7;
-                    /* Fetch the octets with the bits directly */
-                    for (ucCount = 0; ucCount < bitstring_bytes_used(&TempBits);
-                         ucCount++) {
-                        TempRec.Datum.Bits.ucStore[ucCount] =
-                            bitstring_octet(&TempBits, ucCount);
-                    }
-                } else {
-                    /* We will only use the first 4 octets to save space */
-                    TempRec.Datum.Bits.ucLen = 4 << 4;
-                    for (ucCount = 0; ucCount < 4; ucCount++) {
-                        TempRec.Datum.Bits.ucStore[ucCount] =
-                            bitstring_octet(&TempBits, ucCount);
-                    }
-                }
+                TL_Record_Bits_Set(&TempRec, &TempBits);
                 break;
 
             case BACNET_APPLICATION_TAG_ENUMERATED:
@@ -1838,89 +3393,522 @@ static void TL_fetch_property(int iLog)
         TempRec.Datum.Error.usCode = ERROR_CODE_OTHER;
         TempRec.ucRecType = TL_TYPE_ERROR;
     }
-    Logs[iLog][CurrentLog->iIndex++] = TempRec;
-    if (CurrentLog->iIndex >= TL_MAX_ENTRIES) {
-        CurrentLog->iIndex = 0;
+    TL_Record_Append(iLog, &TempRec);
+}
+
+/**
+ * @brief Determine if the source of a log is an object in this device
+ * @param Source - the logged property
+ * @return true if the object is in this device
+ */
+static bool
+TL_Source_Local(const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source)
+{
+    return (Source->deviceIdentifier.type != OBJECT_DEVICE) ||
+        (Source->deviceIdentifier.instance == Device_Object_Instance_Number());
+}
+
+/**
+ * @brief Fill in the COV subscription of a log to its remote source.
+ *  SubscribeCOVProperty is used for the properties that are not in the
+ *  COV value list of an object, or to use the Client_COV_Increment.
+ * @param iLog - Index of the log.
+ * @param bCancel - true to cancel the subscription
+ * @param cov_data - [out] the subscription
+ */
+static void TL_COV_Subscription(
+    int iLog, bool bCancel, BACNET_SUBSCRIBE_COV_DATA *cov_data)
+{
+    const TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source;
+    uint32_t ulInterval = CurrentLog->ulCOVResubscriptionInterval;
+
+    Source = &CurrentLog->Source;
+    memset(cov_data, 0, sizeof(*cov_data));
+    cov_data->subscriberProcessIdentifier = Trend_Log_Index_To_Instance(iLog);
+    cov_data->monitoredObjectIdentifier = Source->objectIdentifier;
+    cov_data->cancellationRequest = bCancel;
+    cov_data->issueConfirmedNotifications = false;
+    /* the subscription outlives a late resubscription,
+       and without resubscription it lasts forever */
+    if (ulInterval <= (UINT32_MAX / 2)) {
+        cov_data->lifetime = ulInterval * 2;
     }
+    if (((Source->propertyIdentifier != PROP_PRESENT_VALUE) &&
+         (Source->propertyIdentifier != PROP_STATUS_FLAGS)) ||
+        (Source->arrayIndex != BACNET_ARRAY_ALL) ||
+        CurrentLog->bClientCOVIncrement) {
+        cov_data->covSubscribeToProperty = true;
+        cov_data->monitoredProperty.property_identifier =
+            Source->propertyIdentifier;
+        cov_data->monitoredProperty.property_array_index = Source->arrayIndex;
+        cov_data->covIncrementPresent = CurrentLog->bClientCOVIncrement;
+        cov_data->covIncrement = CurrentLog->fClientCOVIncrement;
+    }
+}
 
-    CurrentLog->ulTotalRecordCount++;
+/**
+ * @brief Subscribe a log to its remote source, and work out when to
+ *  subscribe again
+ * @param iLog - Index of the log.
+ * @param tNow - the current time, in seconds since the epoch
+ */
+static void TL_COV_Subscribe(int iLog, bacnet_time_t tNow)
+{
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+    BACNET_SUBSCRIBE_COV_DATA cov_data;
 
-    if (CurrentLog->ulRecordCount < TL_MAX_ENTRIES) {
-        CurrentLog->ulRecordCount++;
+    if (!COV_Subscribe_Callback) {
+        return;
+    }
+    TL_COV_Subscription(iLog, false, &cov_data);
+    if (COV_Subscribe_Callback(
+            CurrentLog->Source.deviceIdentifier.instance, &cov_data) != 0) {
+        CurrentLog->bCOVSubscribed = true;
+        CurrentLog->tCOVDueTime =
+            tNow + CurrentLog->ulCOVResubscriptionInterval;
+    } else {
+        /* e.g. the device is not bound yet */
+        CurrentLog->tCOVDueTime = tNow + TL_COV_RETRY_SECONDS;
+    }
+}
+
+/**
+ * @brief Determine if a log waits to subscribe to its remote source
+ * @param iLog - Index of the log.
+ * @return true if the log subscribes to its remote source
+ */
+static bool TL_COV_Subscribing(int iLog)
+{
+    const TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+
+    if (!COV_Subscribe_Callback || TL_Source_Local(&CurrentLog->Source)) {
+        return false;
+    }
+    if (CurrentLog->bCOVSubscribed &&
+        (CurrentLog->ulCOVResubscriptionInterval == 0)) {
+        /* subscribed for good */
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Start the COV logging of a log with a Logging_Type of COV.
+ *  A local source takes the first record at once, and a remote source
+ *  is subscribed to at once.
+ * @param iLog - Index of the log.
+ */
+static void TL_COV_Start(int iLog)
+{
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+
+    if (CurrentLog->LoggingType != LOGGING_TYPE_COV) {
+        return;
+    }
+    if (TL_Source_Local(&CurrentLog->Source)) {
+        CurrentLog->bCOVPending = true;
+        Schedule.bCOV = true;
+    } else {
+        CurrentLog->tCOVDueTime = 0;
+    }
+}
+
+/**
+ * @brief Stop the COV logging of a log, and cancel the subscription
+ *  to its remote source
+ * @param iLog - Index of the log.
+ */
+static void TL_COV_Stop(int iLog)
+{
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+    BACNET_SUBSCRIBE_COV_DATA cov_data;
+
+    if (CurrentLog->bCOVSubscribed && COV_Subscribe_Callback) {
+        TL_COV_Subscription(iLog, true, &cov_data);
+        (void)COV_Subscribe_Callback(
+            CurrentLog->Source.deviceIdentifier.instance, &cov_data);
+    }
+    CurrentLog->bCOVSubscribed = false;
+    CurrentLog->bCOVPending = false;
+    CurrentLog->tCOVDueTime = 0;
+}
+
+/**
+ * @brief Subscribe a log to its remote source again at once, after
+ *  a change to the subscription
+ * @param iLog - Index of the log.
+ */
+static void TL_COV_Restart(int iLog)
+{
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+
+    if ((CurrentLog->LoggingType == LOGGING_TYPE_COV) &&
+        !TL_Source_Local(&CurrentLog->Source)) {
+        CurrentLog->bCOVSubscribed = false;
+        CurrentLog->tCOVDueTime = 0;
+    }
+}
+
+/**
+ * @brief Note the change of a local object for the logs with a
+ *  Logging_Type of COV that log the object.  The record is taken by
+ *  the timer, after the object has finished changing.
+ * @param object_type - object type of the object that changed
+ * @param object_instance - object instance of the object that changed
+ */
+static void TL_COV_Object_Changed(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    TL_LOG_INFO *CurrentLog;
+    int iLog;
+
+    for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
+        CurrentLog = &LogInfo[iLog];
+        if ((CurrentLog->LoggingType == LOGGING_TYPE_COV) &&
+            (CurrentLog->Source.objectIdentifier.type == object_type) &&
+            (CurrentLog->Source.objectIdentifier.instance ==
+             object_instance) &&
+            TL_Source_Local(&CurrentLog->Source)) {
+            CurrentLog->bCOVPending = true;
+            Schedule.bCOV = true;
+        }
+    }
+}
+
+/**
+ * @brief Set the function that sends the COV subscriptions of the logs
+ *  with a Logging_Type of COV to their remote sources, such as
+ *  Send_COV_Subscribe().  Without it, only local sources can be logged.
+ * @param callback - function to send a subscription, or NULL for none
+ */
+void Trend_Log_COV_Subscribe_Callback_Set(
+    trend_log_cov_subscribe_callback callback)
+{
+    COV_Subscribe_Callback = callback;
+}
+
+/**
+ * @brief Record the values of a COV notification from a remote source
+ *  in the logs that subscribed to it.  Add it to the COV notification
+ *  handlers, such as with handler_ucov_notification_add().
+ * @param cov_data - data decoded from the COV notification
+ */
+void Trend_Log_COV_Notification(BACNET_COV_DATA *cov_data)
+{
+    TL_LOG_INFO *CurrentLog;
+    TL_DATA_REC TempRec = { 0 };
+    bacnet_time_t tNow;
+    int iLog;
+
+    if (!cov_data) {
+        return;
+    }
+    tNow = Trend_Log_Epoch_Seconds_Now();
+    for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
+        CurrentLog = &LogInfo[iLog];
+        if ((CurrentLog->LoggingType != LOGGING_TYPE_COV) ||
+            TL_Source_Local(&CurrentLog->Source) ||
+            (cov_data->subscriberProcessIdentifier !=
+             Trend_Log_Index_To_Instance(iLog)) ||
+            (cov_data->initiatingDeviceIdentifier !=
+             CurrentLog->Source.deviceIdentifier.instance) ||
+            (cov_data->monitoredObjectIdentifier.type !=
+             CurrentLog->Source.objectIdentifier.type) ||
+            (cov_data->monitoredObjectIdentifier.instance !=
+             CurrentLog->Source.objectIdentifier.instance)) {
+            continue;
+        }
+        if (!TL_Is_Enabled_Time(iLog, tNow)) {
+            continue;
+        }
+        if (TL_Record_Value_List(
+                &CurrentLog->Source, cov_data->listOfValues, false,
+                &TempRec)) {
+            TempRec.tTimeStamp = tNow;
+            CurrentLog->tLastDataTime = tNow;
+            TL_Record_Append(iLog, &TempRec);
+        }
+    }
+}
+
+/**
+ * @brief Take a record for the logs whose local source reported a
+ *  change since the last time
+ * @param tNow - the current time, in seconds since the epoch
+ */
+static void TL_Schedule_COV(bacnet_time_t tNow)
+{
+    TL_LOG_INFO *CurrentLog;
+    int iLog;
+
+    Schedule.bCOV = false;
+    for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
+        CurrentLog = &LogInfo[iLog];
+        if (!CurrentLog->bCOVPending) {
+            continue;
+        }
+        CurrentLog->bCOVPending = false;
+        if ((CurrentLog->LoggingType == LOGGING_TYPE_COV) &&
+            TL_Is_Enabled_Time(iLog, tNow)) {
+            TL_fetch_property(iLog, tNow);
+        }
+    }
+}
+
+/**
+ * @brief Take a log out of the timer wheel
+ * @param iLog - Index of the log.
+ */
+static void TL_Schedule_Remove(int iLog)
+{
+    int iSlot = Schedule.iWaitSlot[iLog];
+
+    if (iSlot == TL_WHEEL_NONE) {
+        return;
+    }
+    if (Schedule.iPrev[iLog] == TL_WHEEL_NONE) {
+        Schedule.iSlot[iSlot] = Schedule.iNext[iLog];
+    } else {
+        Schedule.iNext[Schedule.iPrev[iLog]] = Schedule.iNext[iLog];
+    }
+    if (Schedule.iNext[iLog] != TL_WHEEL_NONE) {
+        Schedule.iPrev[Schedule.iNext[iLog]] = Schedule.iPrev[iLog];
+    }
+    Schedule.iWaitSlot[iLog] = TL_WHEEL_NONE;
+}
+
+/**
+ * @brief Put a log in the slot of the timer wheel for the second it is due.
+ *  A log that is already due waits in the slot of the next second run.
+ * @param iLog - Index of the log.
+ * @param tDueTime - when the log is due, in seconds since the epoch
+ */
+static void TL_Schedule_Insert(int iLog, bacnet_time_t tDueTime)
+{
+    int iSlot;
+
+    if (tDueTime <= Schedule.tLastTime) {
+        iSlot = (int)((Schedule.tLastTime + 1) % TL_WHEEL_SLOTS);
+    } else {
+        iSlot = (int)(tDueTime % TL_WHEEL_SLOTS);
+    }
+    Schedule.tDueTime[iLog] = tDueTime;
+    Schedule.iWaitSlot[iLog] = iSlot;
+    Schedule.iPrev[iLog] = TL_WHEEL_NONE;
+    Schedule.iNext[iLog] = Schedule.iSlot[iSlot];
+    if (Schedule.iSlot[iSlot] != TL_WHEEL_NONE) {
+        Schedule.iPrev[Schedule.iSlot[iSlot]] = iLog;
+    }
+    Schedule.iSlot[iSlot] = iLog;
+}
+
+/**
+ * @brief Work out when a polled log is next due for a reading.
+ *  A clock aligned log is due at the next second after its last reading
+ *  that matches its interval offset, or when more than an interval has
+ *  gone by since its last reading. Any other log is due an interval
+ *  after its last reading. A log waiting for its start time is due then.
+ * @param iLog - Index of the log.
+ * @param tNow - the current time, in seconds since the epoch
+ * @param ptDueTime - [out] when the log is due
+ * @return true if the log is due at some time, false if it is not
+ *  polled or will not be enabled without a write
+ */
+static bool TL_Due_Time(int iLog, bacnet_time_t tNow, bacnet_time_t *ptDueTime)
+{
+    TL_LOG_INFO *CurrentLog = &LogInfo[iLog];
+    bacnet_time_t tInterval = CurrentLog->ulLogInterval;
+    bacnet_time_t tLast = CurrentLog->tLastDataTime;
+    bacnet_time_t tAligned;
+    bacnet_time_t tLate;
+
+    if (CurrentLog->LoggingType == LOGGING_TYPE_COV) {
+        /* only due to subscribe to a remote source */
+        if (!TL_COV_Subscribing(iLog)) {
+            return false;
+        }
+    } else if (
+        (CurrentLog->LoggingType != LOGGING_TYPE_POLLED) || (tInterval == 0)) {
+        return false;
+    }
+    if (CurrentLog->bEnable == false) {
+        return false;
+    }
+    if (!TL_Is_Enabled_Time(iLog, tNow)) {
+        if (((CurrentLog->ucTimeFlags & TL_T_START_WILD) == 0) &&
+            (tNow < CurrentLog->tStartTime) &&
+            TL_Is_Enabled_Time(iLog, CurrentLog->tStartTime)) {
+            *ptDueTime = CurrentLog->tStartTime;
+            return true;
+        }
+        return false;
+    }
+    if (CurrentLog->LoggingType == LOGGING_TYPE_COV) {
+        *ptDueTime = CurrentLog->tCOVDueTime;
+        if (*ptDueTime > (tNow + CurrentLog->ulCOVResubscriptionInterval)) {
+            /* the clock went back, so subscribe now */
+            *ptDueTime = tNow;
+        }
+    } else if (tLast > tNow) {
+        /* the clock went back, so take a reading now */
+        *ptDueTime = tNow;
+    } else if (CurrentLog->bAlignIntervals) {
+        tAligned = tLast + 1;
+        tAligned += ((CurrentLog->ulIntervalOffset % tInterval) + tInterval -
+                     (tAligned % tInterval)) %
+            tInterval;
+        tLate = tLast + tInterval + 1;
+        *ptDueTime = (tAligned < tLate) ? tAligned : tLate;
+    } else {
+        *ptDueTime = tLast + tInterval;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Put a log back in the timer wheel for when it is next due
+ * @param iLog - Index of the log.
+ * @param tNow - the current time, in seconds since the epoch
+ */
+static void TL_Schedule_Log(int iLog, bacnet_time_t tNow)
+{
+    bacnet_time_t tDueTime = 0;
+
+    TL_Schedule_Remove(iLog);
+    if (TL_Due_Time(iLog, tNow, &tDueTime)) {
+        TL_Schedule_Insert(iLog, tDueTime);
+    }
+}
+
+/**
+ * @brief Put a log back in the timer wheel after a write to the log
+ * @param iLog - Index of the log.
+ */
+static void TL_Schedule_Update(int iLog)
+{
+    if (Schedule.bReady) {
+        TL_Schedule_Log(iLog, Trend_Log_Epoch_Seconds_Now());
+    }
+}
+
+/**
+ * @brief Fill the timer wheel with all the polled logs
+ * @param tNow - the current time, in seconds since the epoch
+ */
+static void TL_Schedule_Rebuild(bacnet_time_t tNow)
+{
+    int iSlot;
+    int iLog;
+
+    for (iSlot = 0; iSlot < TL_WHEEL_SLOTS; iSlot++) {
+        Schedule.iSlot[iSlot] = TL_WHEEL_NONE;
+    }
+    Schedule.tLastTime = (tNow > 0) ? (tNow - 1) : 0;
+    for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
+        Schedule.iWaitSlot[iLog] = TL_WHEEL_NONE;
+        TL_Schedule_Log(iLog, tNow);
+    }
+    Schedule.bTriggers = true;
+    Schedule.bReady = true;
+}
+
+/**
+ * @brief Take a reading for the logs with a trigger. A trigger of a
+ *  disabled log waits until the log is enabled.
+ * @param tNow - the current time, in seconds since the epoch
+ */
+static void TL_Schedule_Triggers(bacnet_time_t tNow)
+{
+    TL_LOG_INFO *CurrentLog;
+    bool bTriggers = false;
+    int iLog;
+
+    for (iLog = 0; iLog < MAX_TREND_LOGS; iLog++) {
+        CurrentLog = &LogInfo[iLog];
+        if (!CurrentLog->bTrigger) {
+            continue;
+        }
+        if (!TL_Is_Enabled_Time(iLog, tNow)) {
+            bTriggers = true;
+            continue;
+        }
+        if ((CurrentLog->LoggingType == LOGGING_TYPE_TRIGGERED) ||
+            ((CurrentLog->LoggingType == LOGGING_TYPE_POLLED) &&
+             (CurrentLog->bAlignIntervals == false))) {
+            /* If not aligned take a reading when a trigger is set, and
+             * triggered logs take a reading when the trigger is set and
+             * then reset the trigger to wait for the next event
+             */
+            TL_fetch_property(iLog, tNow);
+            TL_Schedule_Log(iLog, tNow);
+        }
+        CurrentLog->bTrigger = false;
     }
+    Schedule.bTriggers = bTriggers;
 }
 
 /**
- * @brief Check each log to see if any data needs to be recorded.
+ * @brief Record the data of the logs that are due.
+ *  Only the slots of the timer wheel for the seconds since the last call
+ *  are visited, so the logs that are not due cost nothing.
  * @param uSeconds - Number of seconds since last called (not used).
  */
 void trend_log_timer(uint16_t uSeconds)
 {
-    TL_LOG_INFO *CurrentLog = NULL;
-    int iCount = 0;
     bacnet_time_t tNow = 0;
+    bacnet_time_t tTime = 0;
+    bacnet_time_t tCount = 0;
+    bacnet_time_t tDueTime = 0;
+    int iLog = 0;
+    int iNext = 0;
 
     (void)uSeconds;
     /* use OS to get the current time */
     tNow = Trend_Log_Epoch_Seconds_Now();
-    for (iCount = 0; iCount < MAX_TREND_LOGS; iCount++) {
-        CurrentLog = &LogInfo[iCount];
-        if (TL_Is_Enabled(iCount)) {
-            if (CurrentLog->LoggingType == LOGGING_TYPE_POLLED) {
-                /* For polled logs we first need to see if they are clock
-                 * aligned or not.
-                 */
-                if (CurrentLog->bAlignIntervals == true) {
-                    /* Aligned logging so use the combination of the
-                     * interval and the offset to decide when to log. Also
-                     * log a reading if more than interval time has elapsed
-                     * since last reading to ensure we don't miss a reading
-                     * if we aren't called at the precise second when the
-                     * match occurs.
-                     */
-                    /*                if(((tNow % CurrentLog->ulLogInterval)
-                     * >= (CurrentLog->ulIntervalOffset %
-                     * CurrentLog->ulLogInterval)) && */
-                    /*                   ((tNow - CurrentLog->tLastDataTime)
-                     * >= CurrentLog->ulLogInterval)) { */
-                    if ((tNow % CurrentLog->ulLogInterval) ==
-                        (CurrentLog->ulIntervalOffset %
-                         CurrentLog->ulLogInterval)) {
-                        /* Record value if time synchronised trigger
-                         * condition is met and at least one period has
-                         * elapsed.
-                         */
-                        TL_fetch_property(iCount);
-                    } else if (
-                        (tNow - CurrentLog->tLastDataTime) >
-                        CurrentLog->ulLogInterval) {
-                        /* Also record value if we have waited more than a
-                         * period since the last reading. This ensures we
-                         * take a reading as soon as possible after a power
-                         * down if we have been off for more than a single
-                         * period.
-                         */
-                        TL_fetch_property(iCount);
+    if (!Schedule.bReady || (tNow < Schedule.tLastTime)) {
+        /* start, or start over when the clock went back */
+        TL_Schedule_Rebuild(tNow);
+    }
+    if (Schedule.bTriggers) {
+        TL_Schedule_Triggers(tNow);
+    }
+    if (Schedule.bCOV) {
+        TL_Schedule_COV(tNow);
+    }
+    /* each slot is visited once at most, however long it has been */
+    tCount = tNow - Schedule.tLastTime;
+    if (tCount > TL_WHEEL_SLOTS) {
+        tCount = TL_WHEEL_SLOTS;
+    }
+    tTime = Schedule.tLastTime;
+    while (tCount > 0) {
+        tTime++;
+        tCount--;
+        iLog = Schedule.iSlot[tTime % TL_WHEEL_SLOTS];
+        while (iLog != TL_WHEEL_NONE) {
+            iNext = Schedule.iNext[iLog];
+            if (Schedule.tDueTime[iLog] <= tNow) {
+                TL_Schedule_Remove(iLog);
+                if (TL_Is_Enabled_Time(iLog, tNow)) {
+                    /* a log waiting for its start time is only due
+                       for a reading by its own interval */
+                    if (TL_Due_Time(iLog, tNow, &tDueTime) &&
+                        (tDueTime <= tNow)) {
+                        if (LogInfo[iLog].LoggingType == LOGGING_TYPE_COV) {
+                            /* COV logs are only due to subscribe */
+                            TL_COV_Subscribe(iLog, tNow);
+                        } else {
+                            TL_fetch_property(iLog, tNow);
+                        }
                     }
-                } else if (
-                    ((tNow - CurrentLog->tLastDataTime) >=
-                     CurrentLog->ulLogInterval) ||
-                    (CurrentLog->bTrigger == true)) {
-                    /* If not aligned take a reading when we have either
-                     * waited long enough or a trigger is set.
-                     */
-                    TL_fetch_property(iCount);
-                }
-                CurrentLog->bTrigger = false; /* Clear this every time */
-            } else if (CurrentLog->LoggingType == LOGGING_TYPE_TRIGGERED) {
-                /* Triggered logs take a reading when the trigger is set and
-                 * then reset the trigger to wait for the next event
-                 */
-                if (CurrentLog->bTrigger == true) {
-                    TL_fetch_property(iCount);
-                    CurrentLog->bTrigger = false;
                 }
+                TL_Schedule_Log(iLog, tNow);
             }
+            iLog = iNext;
         }
     }
+    Schedule.tLastTime = tNow;
 }
@@ -8,6 +8,7 @@
 #ifndef BACNET_BASIC_OBJECT_TRENDLOG_H
 #define BACNET_BASIC_OBJECT_TRENDLOG_H
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -67,7 +68,98 @@ typedef struct tl_data_record {
 #define TL_T_START_WILD 1 /* Start time is wild carded */
 #define TL_T_STOP_WILD 2 /* Stop Time is wild carded */
 
-#define TL_MAX_ENTRIES 1000 /* Entries per datalog */
+#ifndef TL_MAX_ENTRIES
+#define TL_MAX_ENTRIES 1000 /* Default entries per datalog */
+#endif
+
+/* Largest Buffer_Size that can be written to a datalog */
+#ifndef TL_BUFFER_SIZE_MAX
+#define TL_BUFFER_SIZE_MAX 262144UL
+#endif
+
+/* The records of a log are kept in a block of octets: a header with the
+ * state of the circular buffer, followed by Buffer_Size fixed size slots.
+ * Each slot holds the time stamp, type and status of a record and the
+ * datum packed for its type, so that the block can be kept in memory
+ * that outlives the stack, and be used again after a restart.
+ */
+#define TL_RECORD_SIZE 12
+#define TL_STORAGE_HEADER_SIZE 24
+#define TL_STORAGE_SIZE(buffer_size) \
+    (TL_STORAGE_HEADER_SIZE + ((size_t)(buffer_size) * TL_RECORD_SIZE))
+
+/* A compressed log keeps its records in a ring of fixed size blocks
+ * after a longer header. Each block starts with the full time stamp of
+ * its first record, and packs the records that follow as bit fields:
+ * the time stamp as the change of the interval between records, and the
+ * value as the bits that changed from the previous value. A slowly
+ * changing point that is logged at a fixed interval takes a few bits per
+ * record, so storage is sized for a nominal two octets per record, and
+ * the oldest block is dropped when the records do not pack as well.
+ */
+#ifndef TL_BLOCK_SIZE
+#define TL_BLOCK_SIZE 256
+#endif
+#define TL_COMPRESSED_RECORD_BITS 16
+#define TL_COMPRESSED_HEADER_SIZE 32
+#define TL_COMPRESSED_BLOCKS(buffer_size)                          \
+    (((((size_t)(buffer_size) * TL_COMPRESSED_RECORD_BITS) + 7) / 8 + \
+      TL_BLOCK_SIZE - 1) /                                          \
+         TL_BLOCK_SIZE +                                            \
+     1)
+#define TL_COMPRESSED_STORAGE_SIZE(buffer_size) \
+    (TL_COMPRESSED_HEADER_SIZE +                \
+     (TL_COMPRESSED_BLOCKS(buffer_size) * TL_BLOCK_SIZE))
+
+/* Where a compressed log is in its blocks, when writing or reading */
+typedef struct tl_block_state {
+    uint32_t ulBlock; /* Block in the ring of blocks */
+    uint16_t usRecord; /* Records of the block done */
+    uint16_t usBit; /* Bit position in the block */
+    bacnet_time_t tTimeStamp; /* Time stamp of the last record */
+    int32_t lDelta; /* Interval before the last record, in seconds */
+    uint32_t ulValue; /* Bits of the last value */
+    uint8_t ucRecType; /* Type of the last record */
+    uint8_t ucStatus; /* Status of the last record */
+    uint8_t ucLeading; /* Leading zero bits of the last changed value */
+    uint8_t ucTrailing; /* Trailing zero bits of the last changed value */
+} TL_BLOCK_STATE;
+
+/**
+ * @brief Callback to get the storage block of a log
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param size - [in] the size wanted for a new block,
+ *  [out] the size of the block returned, which may be an existing block
+ * @return the storage block, or NULL if there is none
+ */
+typedef uint8_t *(*trend_log_storage_open_callback)(
+    unsigned device_index, uint32_t object_instance, size_t *size);
+
+/**
+ * @brief Callback to let go of the storage block of a log
+ * @param device_index - index of the routed device, or 0
+ * @param object_instance - object-instance number of the log
+ * @param storage - the storage block from the open callback
+ * @param size - the size of the storage block
+ * @param purge - true if the records are no longer wanted
+ */
+typedef void (*trend_log_storage_close_callback)(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge);
+
+/**
+ * @brief Callback to send a SubscribeCOV or SubscribeCOVProperty request
+ *  for a Trend Log with a Logging_Type of COV and a remote source
+ * @param device_id - device instance of the remote source
+ * @param cov_data - the subscription
+ * @return invoke ID of the request, or 0 if it was not sent
+ */
+typedef uint8_t (*trend_log_cov_subscribe_callback)(
+    uint32_t device_id, const BACNET_SUBSCRIBE_COV_DATA *cov_data);
 
 /* Structure containing config and status info for a Trend Log */
 
@@ -92,6 +184,26 @@ typedef struct tl_log_info {
     bool bTrigger; /* Set to 1 to cause a reading to be taken */
     int iIndex; /* Current insertion point */
     bacnet_time_t tLastDataTime;
+    uint32_t ulBufferSize; /* Number of records the storage can hold */
+    uint8_t *pStorage; /* Storage block with the records */
+    size_t StorageSize; /* Size of the storage block in octets */
+    /* Compressed records: iIndex is the oldest block of the ring */
+    bool bCompressed; /* Records are packed in compressed blocks */
+    uint32_t ulBlockCount; /* Blocks in the storage block */
+    uint32_t ulBlocksUsed; /* Blocks with records, from the oldest */
+    uint32_t ulOldestSkip; /* Records of the oldest block pushed out */
+    TL_BLOCK_STATE Writer; /* End of the newest block */
+    TL_BLOCK_STATE Reader; /* Last record read, to read the next one */
+    uint32_t ulReaderEntry; /* Entry of the last record read, 0 based */
+    bool bReaderValid; /* The reader is at ulReaderEntry */
+    /* COV logging: a local source reports its changes to the log, and
+       a remote source is subscribed to with SubscribeCOV */
+    bool bCOVPending; /* The local source reported a change */
+    bool bCOVSubscribed; /* The remote source was subscribed to */
+    bacnet_time_t tCOVDueTime; /* When the remote source is subscribed */
+    uint32_t ulCOVResubscriptionInterval; /* Seconds, 0 for none */
+    bool bClientCOVIncrement; /* Client_COV_Increment is a REAL */
+    float fClientCOVIncrement; /* Increment for the remote source */
 } TL_LOG_INFO;
 
 /*
@@ -142,6 +254,12 @@ BACNET_STACK_EXPORT
 uint32_t Trend_Log_Record_Count(uint32_t object_instance);
 BACNET_STACK_EXPORT
 uint32_t Trend_Log_Buffer_Size(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Buffer_Size_Set(uint32_t object_instance, uint32_t size);
+BACNET_STACK_EXPORT
+bool Trend_Log_Compressed(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Compressed_Set(uint32_t object_instance, bool compressed);
 
 BACNET_STACK_EXPORT
 int Trend_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
@@ -150,6 +268,18 @@ BACNET_STACK_EXPORT
 bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
 BACNET_STACK_EXPORT
 void Trend_Log_Init(void);
+BACNET_STACK_EXPORT
+void Trend_Log_Cleanup(void);
+BACNET_STACK_EXPORT
+void Trend_Log_Storage_Callback_Set(
+    trend_log_storage_open_callback open_callback,
+    trend_log_storage_close_callback close_callback);
+
+BACNET_STACK_EXPORT
+void Trend_Log_COV_Subscribe_Callback_Set(
+    trend_log_cov_subscribe_callback callback);
+BACNET_STACK_EXPORT
+void Trend_Log_COV_Notification(BACNET_COV_DATA *cov_data);
 
 BACNET_STACK_EXPORT
 void TL_Insert_Status_Rec(int iLog, BACNET_LOG_STATUS eStatus, bool bState);
@@ -0,0 +1,2577 @@
+/**
+ * @file
+ * @brief Trend Log Multiple object, customize for your use
+ * @details A Trend Log Multiple object monitors the properties of one or
+ *  more referenced objects and, when predefined conditions are met, saves
+ *  ("logs") the values of all of them together in an internal buffer for
+ *  subsequent retrieval. Each timestamped buffer entry is called a trend
+ *  log "record."
+ *
+ *  The records are kept in columns rather than as a list of records:
+ *  one column holds the time stamps shared by all the members of the log,
+ *  one column holds the choice of each record, and each member in the
+ *  Log_DeviceObjectProperty array has a column for the datatype of its
+ *  value and a column for the value itself. A sample of the members is a
+ *  single pass that writes one row across the columns, and the ReadRange
+ *  service encodes each BACnetLogMultipleRecord straight from the columns.
+ *
+ *  The log buffer is a fixed-size circular buffer. When it is full, the
+ *  oldest records are overwritten when new records are added, unless
+ *  Stop_When_Full is TRUE. Each record has an implied sequence number that
+ *  is equal to the value of the Total_Record_Count property immediately
+ *  after the record is added.
+ *
+ *  Only the properties of objects in this device are logged. A reference
+ *  to an object in another device is rejected when it is written.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdevobjpropref.h"
+#include "bacnet/bacint.h"
+#include "bacnet/bacreal.h"
+#include "bacnet/datetime.h"
+#include "bacnet/proplist.h"
+#include "bacnet/rp.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/sys/keylist.h"
+/* BACnet Stack Objects */
+#include "bacnet/basic/object/device.h"
+/* me! */
+#include "bacnet/basic/object/trendlog_multiple.h"
+
+/* the choice of a record in the log-data of a BACnetLogMultipleRecord */
+#define TLM_ROW_LOG_STATUS 0
+#define TLM_ROW_LOG_DATA 1
+/* the choice of a member datum in the log-data, which is its context tag */
+#define TLM_DATUM_BOOLEAN 0
+#define TLM_DATUM_REAL 1
+#define TLM_DATUM_ENUMERATED 2
+#define TLM_DATUM_UNSIGNED 3
+#define TLM_DATUM_SIGNED 4
+#define TLM_DATUM_BITSTRING 5
+#define TLM_DATUM_NULL 6
+#define TLM_DATUM_FAILURE 7
+/* a bit string datum is kept in its value cell as the number of bits
+   in the upper octet and up to 24 bits in the lower octets */
+#define TLM_BITSTRING_OCTETS_MAX 3
+#define TLM_BITSTRING_BITS_MAX (TLM_BITSTRING_OCTETS_MAX * 8)
+
+struct object_data {
+    bool Enable;
+    bool Stop_When_Full;
+    bool Align_Intervals;
+    bool Trigger;
+    BACNET_LOGGING_TYPE Logging_Type;
+    /* interval and offset, in seconds */
+    uint32_t Log_Interval;
+    uint32_t Interval_Offset;
+    /* the next time a polled log is due for a sample */
+    bool Scheduled;
+    bacnet_time_t Due_Time;
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE
+    Members[BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX];
+    unsigned Member_Count;
+    /* the columns of the log buffer are in one block of memory:
+       a time stamp column and a record choice column for the rows,
+       and a datum choice column and a value column for each member */
+    void *Columns;
+    bacnet_time_t *Time_Stamps;
+    uint32_t *Values;
+    uint8_t *Datums;
+    uint8_t *Choices;
+    /* the number of value columns, which is at least one so that
+       a log-status record has a cell for its status bits */
+    unsigned Column_Count;
+    uint32_t Buffer_Size;
+    /* row of the next record */
+    uint32_t Index;
+    uint32_t Record_Count;
+    uint32_t Record_Count_Total;
+    const char *Object_Name;
+    const char *Description;
+};
+/* Key List for storing the object data sorted by instance number  */
+static OS_Keylist Object_Lists[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Object_List (Object_Lists[Routed_Device_Object_Index()])
+#else
+#define Object_List (Object_Lists[0])
+#endif
+
+static const int32_t Properties_Required[] = {
+    /* required properties that are supported for this object */
+    PROP_OBJECT_IDENTIFIER,
+    PROP_OBJECT_NAME,
+    PROP_OBJECT_TYPE,
+    PROP_STATUS_FLAGS,
+    PROP_EVENT_STATE,
+    PROP_ENABLE,
+    PROP_LOG_DEVICE_OBJECT_PROPERTY,
+    PROP_LOGGING_TYPE,
+    PROP_LOG_INTERVAL,
+    PROP_STOP_WHEN_FULL,
+    PROP_BUFFER_SIZE,
+    PROP_LOG_BUFFER,
+    PROP_RECORD_COUNT,
+    PROP_TOTAL_RECORD_COUNT,
+    -1
+};
+
+static const int32_t Properties_Optional[] = {
+    /* optional properties that are supported for this object */
+    PROP_DESCRIPTION, PROP_ALIGN_INTERVALS, PROP_INTERVAL_OFFSET,
+    PROP_TRIGGER, -1
+};
+
+static const int32_t Properties_Proprietary[] = { -1 };
+
+static const int32_t BACnetARRAY_Properties[] = {
+    /* standard properties that are arrays for this object */
+    PROP_LOG_DEVICE_OBJECT_PROPERTY,
+    PROP_EVENT_TIME_STAMPS,
+    PROP_EVENT_MESSAGE_TEXTS,
+    PROP_EVENT_MESSAGE_TEXTS_CONFIG,
+    PROP_TAGS,
+    -1
+};
+
+static const int32_t Writable_Properties[] = {
+    /* Every object shall have a Writable Property_List property
+    which is a BACnetARRAY of property identifiers,
+    one property identifier for each property within this object
+    that is always writable.  */
+    PROP_ENABLE,
+    PROP_LOG_DEVICE_OBJECT_PROPERTY,
+    PROP_LOGGING_TYPE,
+    PROP_LOG_INTERVAL,
+    PROP_STOP_WHEN_FULL,
+    PROP_BUFFER_SIZE,
+    PROP_RECORD_COUNT,
+    PROP_ALIGN_INTERVALS,
+    PROP_INTERVAL_OFFSET,
+    PROP_TRIGGER,
+    -1
+};
+
+/**
+ * @brief Determine if the object property is a BACnetARRAY property
+ * @param object_property - object-property to be checked
+ * @return true if the property is a BACnetARRAY property
+ */
+static bool BACnetARRAY_Property(int object_property)
+{
+    return property_list_member(BACnetARRAY_Properties, object_property);
+}
+
+/**
+ * Returns the list of required, optional, and proprietary properties.
+ * Used by ReadPropertyMultiple service.
+ *
+ * @param pRequired - pointer to list of int terminated by -1, of
+ * BACnet required properties for this object.
+ * @param pOptional - pointer to list of int terminated by -1, of
+ * BACnet optional properties for this object.
+ * @param pProprietary - pointer to list of int terminated by -1, of
+ * BACnet proprietary properties for this object.
+ */
+void Trend_Log_Multiple_Property_Lists(
+    const int32_t **pRequired,
+    const int32_t **pOptional,
+    const int32_t **pProprietary)
+{
+    if (pRequired) {
+        *pRequired = Properties_Required;
+    }
+    if (pOptional) {
+        *pOptional = Properties_Optional;
+    }
+    if (pProprietary) {
+        *pProprietary = Properties_Proprietary;
+    }
+
+    return;
+}
+
+/**
+ * @brief Get the list of writable properties for a Trend Log Multiple
+ * @param  object_instance - object-instance number of the object
+ * @param  properties - Pointer to the pointer of writable properties.
+ */
+void Trend_Log_Multiple_Writable_Property_List(
+    uint32_t object_instance, const int32_t **properties)
+{
+    (void)object_instance;
+    if (properties) {
+        *properties = Writable_Properties;
+    }
+}
+
+/**
+ * @brief Gets an object from the list using an instance number as the key
+ * @param  object_instance - object-instance number of the object
+ * @return object found in the list, or NULL if not found
+ */
+static struct object_data *Object_Data(uint32_t object_instance)
+{
+    return Keylist_Data(Object_List, object_instance);
+}
+
+/**
+ * @brief Determines if a given object instance is valid
+ * @param  object_instance - object-instance number of the object
+ * @return  true if the instance is valid, and false if not
+ */
+bool Trend_Log_Multiple_Valid_Instance(uint32_t object_instance)
+{
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determines the number of objects
+ * @return  Number of objects
+ */
+unsigned Trend_Log_Multiple_Count(void)
+{
+    return Keylist_Count(Object_List);
+}
+
+/**
+ * @brief Determines the object instance-number for a given 0..N index
+ * of objects where N is the count.
+ * @param  index - 0..N value
+ * @return  object instance-number for a valid given index, or UINT32_MAX
+ */
+uint32_t Trend_Log_Multiple_Index_To_Instance(unsigned index)
+{
+    uint32_t instance = UINT32_MAX;
+
+    (void)Keylist_Index_Key(Object_List, index, &instance);
+
+    return instance;
+}
+
+/**
+ * @brief For a given object instance-number, determines a 0..N index
+ * of objects where N is the count.
+ * @param  object_instance - object-instance number of the object
+ * @return  index for the given instance-number, or count if not valid.
+ */
+unsigned Trend_Log_Multiple_Instance_To_Index(uint32_t object_instance)
+{
+    return Keylist_Index(Object_List, object_instance);
+}
+
+/**
+ * @brief Get the current time from the Device object
+ * @return current time in epoch seconds
+ */
+static bacnet_time_t Trend_Log_Multiple_Epoch_Seconds_Now(void)
+{
+    BACNET_DATE_TIME bdatetime;
+
+    Device_getCurrentDateTime(&bdatetime);
+    return datetime_seconds_since_epoch(&bdatetime);
+}
+
+/**
+ * @brief Get the columns of the log buffer of a log, for a given number
+ *  of records and members. The records of the log are cleared.
+ * @param pObject - object data
+ * @param buffer_size - number of records in the log buffer
+ * @param member_count - number of members of the log
+ * @return true if the columns were allocated
+ */
+static bool Trend_Log_Multiple_Columns_Open(
+    struct object_data *pObject, uint32_t buffer_size, unsigned member_count)
+{
+    unsigned column_count;
+    uint8_t *columns;
+    size_t row_size;
+
+    if (buffer_size == 0) {
+        return false;
+    }
+    column_count = (member_count > 0) ? member_count : 1;
+    /* the wider columns go first, so each column is aligned */
+    row_size = sizeof(bacnet_time_t) +
+        (column_count * (sizeof(uint32_t) + sizeof(uint8_t))) +
+        sizeof(uint8_t);
+    columns = calloc(buffer_size, row_size);
+    if (!columns) {
+        return false;
+    }
+    free(pObject->Columns);
+    pObject->Columns = columns;
+    pObject->Time_Stamps = (bacnet_time_t *)columns;
+    columns += (size_t)buffer_size * sizeof(bacnet_time_t);
+    pObject->Values = (uint32_t *)columns;
+    columns += (size_t)buffer_size * column_count * sizeof(uint32_t);
+    pObject->Datums = columns;
+    columns += (size_t)buffer_size * column_count;
+    pObject->Choices = columns;
+    pObject->Column_Count = column_count;
+    pObject->Buffer_Size = buffer_size;
+    pObject->Index = 0;
+    pObject->Record_Count = 0;
+
+    return true;
+}
+
+/**
+ * @brief Let go of the columns of the log buffer of a log
+ * @param pObject - object data
+ */
+static void Trend_Log_Multiple_Columns_Close(struct object_data *pObject)
+{
+    free(pObject->Columns);
+    pObject->Columns = NULL;
+    pObject->Time_Stamps = NULL;
+    pObject->Values = NULL;
+    pObject->Datums = NULL;
+    pObject->Choices = NULL;
+    pObject->Column_Count = 0;
+    pObject->Index = 0;
+    pObject->Record_Count = 0;
+}
+
+/**
+ * @brief Get the row of a record of a log
+ * @param pObject - object data
+ * @param index - 0 based index of the record, oldest first,
+ *  less than the record count
+ * @return the row of the record in the columns
+ */
+static uint32_t
+Trend_Log_Multiple_Row(const struct object_data *pObject, uint32_t index)
+{
+    uint32_t row;
+
+    row = pObject->Index + pObject->Buffer_Size - pObject->Record_Count;
+
+    return (row + index) % pObject->Buffer_Size;
+}
+
+/**
+ * @brief Get the position of the cell of a member in a row of the
+ *  value and datum columns
+ * @param pObject - object data
+ * @param member - 0 based index of the member column
+ * @param row - row of the record
+ * @return the position of the cell
+ */
+static size_t Trend_Log_Multiple_Cell(
+    const struct object_data *pObject, unsigned member, uint32_t row)
+{
+    return ((size_t)member * pObject->Buffer_Size) + row;
+}
+
+/**
+ * @brief Add a row for a new record to the log buffer of a log,
+ *  writing over the oldest record when the log buffer is full
+ * @param pObject - object data
+ * @param tTime - time stamp of the record, in seconds since the epoch
+ * @param choice - the choice of log-data of the record
+ * @return the row of the new record
+ */
+static uint32_t Trend_Log_Multiple_Row_Append(
+    struct object_data *pObject, bacnet_time_t tTime, uint8_t choice)
+{
+    uint32_t row = pObject->Index;
+
+    pObject->Time_Stamps[row] = tTime;
+    pObject->Choices[row] = choice;
+    pObject->Index++;
+    if (pObject->Index >= pObject->Buffer_Size) {
+        pObject->Index = 0;
+    }
+    if (pObject->Record_Count < pObject->Buffer_Size) {
+        pObject->Record_Count++;
+    }
+    pObject->Record_Count_Total++;
+
+    return row;
+}
+
+/**
+ * @brief Store a member datum in its cells of a row
+ * @param pObject - object data
+ * @param member - 0 based index of the member column
+ * @param row - row of the record
+ * @param datum - the choice of the member datum
+ * @param value - the value of the member datum
+ */
+static void Trend_Log_Multiple_Datum_Set(
+    struct object_data *pObject,
+    unsigned member,
+    uint32_t row,
+    uint8_t datum,
+    uint32_t value)
+{
+    size_t cell = Trend_Log_Multiple_Cell(pObject, member, row);
+
+    pObject->Datums[cell] = datum;
+    pObject->Values[cell] = value;
+}
+
+/**
+ * @brief Get the value cell of a REAL member datum
+ * @param real_value - the REAL value
+ * @return the value cell
+ */
+static uint32_t Trend_Log_Multiple_Real_Value(float real_value)
+{
+    uint32_t value;
+
+    memcpy(&value, &real_value, sizeof(value));
+
+    return value;
+}
+
+/**
+ * @brief Get the value cell of a bit string member datum, truncated
+ *  at 24 bits
+ * @param bit_string - the bit string
+ * @return the value cell
+ */
+static uint32_t
+Trend_Log_Multiple_Bitstring_Value(const BACNET_BIT_STRING *bit_string)
+{
+    uint32_t value;
+    uint8_t bits_used;
+    uint8_t i;
+
+    bits_used = bitstring_bits_used(bit_string);
+    if (bits_used > TLM_BITSTRING_BITS_MAX) {
+        bits_used = TLM_BITSTRING_BITS_MAX;
+    }
+    value = (uint32_t)bits_used << 24;
+    for (i = 0; i < TLM_BITSTRING_OCTETS_MAX; i++) {
+        if ((i * 8) < bits_used) {
+            value |= (uint32_t)bitstring_octet(bit_string, i) << (i * 8);
+        }
+    }
+
+    return value;
+}
+
+/**
+ * @brief Sample a member property with the typed present-value and
+ *  status-flags functions of the object, without encoding and decoding
+ *  the value
+ * @param pObject - object data
+ * @param member - 0 based index of the member
+ * @param row - row of the record
+ * @return true if the object has the typed functions for the property
+ */
+static bool Trend_Log_Multiple_Member_Present_Value(
+    struct object_data *pObject, unsigned member, uint32_t row)
+{
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_BIT_STRING status_flags;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    uint32_t enumerated_value = 0;
+    bool boolean_value = false;
+    float real_value = 0.0f;
+
+    reference = &pObject->Members[member];
+    if (reference->arrayIndex != BACNET_ARRAY_ALL) {
+        return false;
+    }
+    object_type = reference->objectIdentifier.type;
+    object_instance = reference->objectIdentifier.instance;
+    if (reference->propertyIdentifier == PROP_STATUS_FLAGS) {
+        if (!Device_Status_Flags(object_type, object_instance, &status_flags)) {
+            return false;
+        }
+        Trend_Log_Multiple_Datum_Set(
+            pObject, member, row, TLM_DATUM_BITSTRING,
+            Trend_Log_Multiple_Bitstring_Value(&status_flags));
+    } else if (reference->propertyIdentifier != PROP_PRESENT_VALUE) {
+        return false;
+    } else if (Device_Present_Value_Real(
+                   object_type, object_instance, &real_value)) {
+        Trend_Log_Multiple_Datum_Set(
+            pObject, member, row, TLM_DATUM_REAL,
+            Trend_Log_Multiple_Real_Value(real_value));
+    } else if (Device_Present_Value_Enumerated(
+                   object_type, object_instance, &enumerated_value)) {
+        Trend_Log_Multiple_Datum_Set(
+            pObject, member, row, TLM_DATUM_ENUMERATED, enumerated_value);
+    } else if (Device_Present_Value_Unsigned(
+                   object_type, object_instance, &unsigned_value)) {
+        Trend_Log_Multiple_Datum_Set(
+            pObject, member, row, TLM_DATUM_UNSIGNED,
+            (uint32_t)unsigned_value);
+    } else if (Device_Present_Value_Boolean(
+                   object_type, object_instance, &boolean_value)) {
+        Trend_Log_Multiple_Datum_Set(
+            pObject, member, row, TLM_DATUM_BOOLEAN, boolean_value);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Sample a member property with ReadProperty, and store the first
+ *  application tagged value of the property
+ * @param pObject - object data
+ * @param member - 0 based index of the member
+ * @param row - row of the record
+ * @param buffer - buffer big enough for the encoded property
+ * @param buffer_size - size of the buffer
+ */
+static void Trend_Log_Multiple_Member_Read_Property(
+    struct object_data *pObject,
+    unsigned member,
+    uint32_t row,
+    uint8_t *buffer,
+    size_t buffer_size)
+{
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference;
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_TAG tag = { 0 };
+    BACNET_BIT_STRING bit_string;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    uint32_t enumerated_value = 0;
+    int32_t signed_value = 0;
+    float real_value = 0.0f;
+    int len;
+
+    reference = &pObject->Members[member];
+    rpdata.application_data = buffer;
+    rpdata.application_data_len = buffer_size;
+    rpdata.object_type = reference->objectIdentifier.type;
+    rpdata.object_instance = reference->objectIdentifier.instance;
+    rpdata.object_property = reference->propertyIdentifier;
+    rpdata.array_index = reference->arrayIndex;
+    len = Device_Read_Property(&rpdata);
+    if (len < 0) {
+        Trend_Log_Multiple_Datum_Set(
+            pObject, member, row, TLM_DATUM_FAILURE,
+            ((uint32_t)rpdata.error_class << 16) | rpdata.error_code);
+        return;
+    }
+    len = bacnet_tag_decode(buffer, len, &tag);
+    if ((len <= 0) || !tag.application) {
+        /* constructed values are not logged */
+        tag.number = MAX_BACNET_APPLICATION_TAG;
+    }
+    switch (tag.number) {
+        case BACNET_APPLICATION_TAG_NULL:
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_NULL, 0);
+            break;
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_BOOLEAN,
+                decode_boolean(tag.len_value_type));
+            break;
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            bacnet_unsigned_decode(
+                &buffer[len], buffer_size - len, tag.len_value_type,
+                &unsigned_value);
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_UNSIGNED,
+                (uint32_t)unsigned_value);
+            break;
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            bacnet_signed_decode(
+                &buffer[len], buffer_size - len, tag.len_value_type,
+                &signed_value);
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_SIGNED,
+                (uint32_t)signed_value);
+            break;
+        case BACNET_APPLICATION_TAG_REAL:
+            bacnet_real_decode(
+                &buffer[len], buffer_size - len, tag.len_value_type,
+                &real_value);
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_REAL,
+                Trend_Log_Multiple_Real_Value(real_value));
+            break;
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            bacnet_bitstring_decode(
+                &buffer[len], buffer_size - len, tag.len_value_type,
+                &bit_string);
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_BITSTRING,
+                Trend_Log_Multiple_Bitstring_Value(&bit_string));
+            break;
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            bacnet_enumerated_decode(
+                &buffer[len], buffer_size - len, tag.len_value_type,
+                &enumerated_value);
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_ENUMERATED,
+                enumerated_value);
+            break;
+        default:
+            /* log a failure for any datatypes we cannot handle */
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_FAILURE,
+                ((uint32_t)ERROR_CLASS_PROPERTY << 16) |
+                    ERROR_CODE_DATATYPE_NOT_SUPPORTED);
+            break;
+    }
+}
+
+/**
+ * @brief Determine if a member of a log references no object
+ * @param reference - the member
+ * @return true if the member references no object
+ */
+static bool Trend_Log_Multiple_Member_Empty(
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference)
+{
+    return reference->objectIdentifier.instance >= BACNET_MAX_INSTANCE;
+}
+
+/**
+ * @brief Determine if a member of a log is an object in this device
+ * @param reference - the member
+ * @return true if the object is in this device
+ */
+static bool Trend_Log_Multiple_Member_Local(
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference)
+{
+    return (reference->deviceIdentifier.type != OBJECT_DEVICE) ||
+        (reference->deviceIdentifier.instance ==
+         Device_Object_Instance_Number());
+}
+
+/**
+ * @brief Sample all the members of a log in one pass, adding one
+ *  log-data record with a single time stamp for all of them
+ * @param pObject - object data
+ * @param object_instance - object-instance number of the object
+ * @param tNow - the current time, in seconds since the epoch
+ */
+static void Trend_Log_Multiple_Row_Sample(
+    struct object_data *pObject, uint32_t object_instance, bacnet_time_t tNow)
+{
+    /* This is a big buffer in case someone selects
+       the device object list for example */
+    uint8_t buffer[MAX_APDU];
+    uint32_t row;
+    unsigned member;
+
+    row = Trend_Log_Multiple_Row_Append(pObject, tNow, TLM_ROW_LOG_DATA);
+    for (member = 0; member < pObject->Member_Count; member++) {
+        if (Trend_Log_Multiple_Member_Empty(&pObject->Members[member])) {
+            Trend_Log_Multiple_Datum_Set(
+                pObject, member, row, TLM_DATUM_NULL, 0);
+        } else if (!Trend_Log_Multiple_Member_Present_Value(
+                       pObject, member, row)) {
+            Trend_Log_Multiple_Member_Read_Property(
+                pObject, member, row, buffer, sizeof(buffer));
+        }
+    }
+    if (pObject->Stop_When_Full &&
+        ((pObject->Record_Count + 1) >= pObject->Buffer_Size)) {
+        /* the last record of a full log is the log-status of disabling */
+        pObject->Enable = false;
+        Trend_Log_Multiple_Record_Status_Insert(
+            object_instance, LOG_STATUS_LOG_DISABLED, true);
+    }
+}
+
+/**
+ * @brief Clear the records of a log, and add a log-status record
+ *  that the log buffer was purged
+ * @param pObject - object data
+ * @param object_instance - object-instance number of the object
+ */
+static void Trend_Log_Multiple_Records_Purge(
+    struct object_data *pObject, uint32_t object_instance)
+{
+    pObject->Index = 0;
+    pObject->Record_Count = 0;
+    Trend_Log_Multiple_Record_Status_Insert(
+        object_instance, LOG_STATUS_BUFFER_PURGED, true);
+}
+
+/**
+ * For a given object instance-number, loads the object-name into
+ * a characterstring. Note that the object name must be unique
+ * within this device.
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  object_name - holds the object-name retrieved
+ *
+ * @return  true if object-name was retrieved
+ */
+bool Trend_Log_Multiple_Object_Name(
+    uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
+{
+    bool status = false;
+    struct object_data *pObject;
+    char name_text[32] = "TREND-LOG-MULTIPLE-4194303";
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        if (pObject->Object_Name) {
+            status =
+                characterstring_init_ansi(object_name, pObject->Object_Name);
+        } else {
+            snprintf(
+                name_text, sizeof(name_text), "TREND-LOG-MULTIPLE-%lu",
+                (unsigned long)object_instance);
+            status = characterstring_init_ansi(object_name, name_text);
+        }
+    }
+
+    return status;
+}
+
+/**
+ * For a given object instance-number, sets the object-name
+ * Note that the object name must be unique within this device.
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  new_name - holds the object-name to be set
+ *
+ * @return  true if object-name was set
+ */
+bool Trend_Log_Multiple_Name_Set(
+    uint32_t object_instance, const char *new_name)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        status = true;
+        pObject->Object_Name = new_name;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Return the object name C string
+ * @param object_instance [in] BACnet object instance number
+ * @return object name or NULL if not found
+ */
+const char *Trend_Log_Multiple_Name_ASCII(uint32_t object_instance)
+{
+    const char *name = NULL;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        name = pObject->Object_Name;
+    }
+
+    return name;
+}
+
+/**
+ * For a given object instance-number, returns the description
+ *
+ * @param  object_instance - object-instance number of the object
+ *
+ * @return description text or NULL if not found
+ */
+const char *Trend_Log_Multiple_Description(uint32_t object_instance)
+{
+    const char *name = NULL;
+    const struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        name = pObject->Description;
+    }
+
+    return name;
+}
+
+/**
+ * For a given object instance-number, sets the description
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  new_name - holds the description to be set
+ *
+ * @return  true if description was set
+ */
+bool Trend_Log_Multiple_Description_Set(
+    uint32_t object_instance, const char *new_name)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        status = true;
+        pObject->Description = new_name;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Determines a object enabled flag state
+ * @note Logging occurs if and only if Enable is TRUE.
+ *  Log_Buffer records of type log-status are recorded
+ *  without regard to the value of the Enable property.
+ * @param  object_instance - object-instance number of the object
+ * @return true if the log is enabled
+ */
+bool Trend_Log_Multiple_Enable(uint32_t object_instance)
+{
+    bool value = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Enable;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the object enabled flag,
+ *  and records a change of state in the log buffer
+ * @param  object_instance - object-instance number of the object
+ * @param  enable - holds the value to be set
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Enable_Set(uint32_t object_instance, bool enable)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        if (pObject->Enable != enable) {
+            /* Only trigger this validation on a potential change of state */
+            pObject->Enable = enable;
+            pObject->Scheduled = false;
+            Trend_Log_Multiple_Record_Status_Insert(
+                object_instance, LOG_STATUS_LOG_DISABLED, !enable);
+        }
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines the Logging_Type
+ * @param  object_instance - object-instance number of the object
+ * @return the Logging_Type of the log
+ */
+BACNET_LOGGING_TYPE Trend_Log_Multiple_Logging_Type(uint32_t object_instance)
+{
+    BACNET_LOGGING_TYPE value = LOGGING_TYPE_POLLED;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Logging_Type;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the Logging_Type.
+ *  A Trend Log Multiple is not COV logged.
+ * @param  object_instance - object-instance number of the object
+ * @param  logging_type - polled or triggered
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Logging_Type_Set(
+    uint32_t object_instance, BACNET_LOGGING_TYPE logging_type)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        if ((logging_type == LOGGING_TYPE_POLLED) ||
+            (logging_type == LOGGING_TYPE_TRIGGERED)) {
+            pObject->Logging_Type = logging_type;
+            pObject->Scheduled = false;
+            status = true;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines the Log_Interval
+ * @param  object_instance - object-instance number of the object
+ * @return the interval between samples of a polled log, in seconds
+ */
+uint32_t Trend_Log_Multiple_Log_Interval(uint32_t object_instance)
+{
+    uint32_t value = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Log_Interval;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the Log_Interval
+ * @param  object_instance - object-instance number of the object
+ * @param  seconds - the interval between samples of a polled log
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Log_Interval_Set(
+    uint32_t object_instance, uint32_t seconds)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        pObject->Log_Interval = seconds;
+        pObject->Scheduled = false;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines Align_Intervals
+ * @param  object_instance - object-instance number of the object
+ * @return true if the samples are aligned to the interval
+ */
+bool Trend_Log_Multiple_Align_Intervals(uint32_t object_instance)
+{
+    bool value = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Align_Intervals;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets Align_Intervals
+ * @param  object_instance - object-instance number of the object
+ * @param  align - true to align the samples to the interval
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Align_Intervals_Set(
+    uint32_t object_instance, bool align)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        pObject->Align_Intervals = align;
+        pObject->Scheduled = false;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines Interval_Offset
+ * @param  object_instance - object-instance number of the object
+ * @return the offset of aligned samples from the interval, in seconds
+ */
+uint32_t Trend_Log_Multiple_Interval_Offset(uint32_t object_instance)
+{
+    uint32_t value = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Interval_Offset;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets Interval_Offset
+ * @param  object_instance - object-instance number of the object
+ * @param  seconds - the offset of aligned samples from the interval
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Interval_Offset_Set(
+    uint32_t object_instance, uint32_t seconds)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        pObject->Interval_Offset = seconds;
+        pObject->Scheduled = false;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines Stop_When_Full
+ * @param  object_instance - object-instance number of the object
+ * @return true if the log is disabled when the log buffer is full
+ */
+bool Trend_Log_Multiple_Stop_When_Full(uint32_t object_instance)
+{
+    bool value = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Stop_When_Full;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets Stop_When_Full.
+ *  An enabled log that is already full is disabled.
+ * @param  object_instance - object-instance number of the object
+ * @param  stop_when_full - true to disable the log when it is full
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Stop_When_Full_Set(
+    uint32_t object_instance, bool stop_when_full)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        if (pObject->Stop_When_Full != stop_when_full) {
+            pObject->Stop_When_Full = stop_when_full;
+            if (stop_when_full && pObject->Enable &&
+                (pObject->Record_Count == pObject->Buffer_Size)) {
+                pObject->Enable = false;
+                Trend_Log_Multiple_Record_Status_Insert(
+                    object_instance, LOG_STATUS_LOG_DISABLED, true);
+            }
+        }
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines the Trigger
+ * @param  object_instance - object-instance number of the object
+ * @return true if a sample is waiting to be taken
+ */
+bool Trend_Log_Multiple_Trigger(uint32_t object_instance)
+{
+    bool value = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Trigger;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the Trigger. A sample
+ *  of the members is taken by the next timer of an enabled log, and then
+ *  the Trigger is reset.
+ * @param  object_instance - object-instance number of the object
+ * @param  trigger - true to take a sample
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Trigger_Set(uint32_t object_instance, bool trigger)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        pObject->Trigger = trigger;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines the size of the
+ *  Log_DeviceObjectProperty array
+ * @param  object_instance - object-instance number of the object
+ * @return the number of members of the log
+ */
+unsigned Trend_Log_Multiple_Member_Count(uint32_t object_instance)
+{
+    unsigned value = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Member_Count;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Set the members of a log, and purge the log buffer when
+ *  the members change
+ * @param pObject - object data
+ * @param object_instance - object-instance number of the object
+ * @param members - the new members
+ * @param count - the number of new members
+ * @return true if the members are set
+ */
+static bool Trend_Log_Multiple_Members_Set(
+    struct object_data *pObject,
+    uint32_t object_instance,
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *members,
+    unsigned count)
+{
+    unsigned i;
+    bool changed = false;
+
+    if (count > BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX) {
+        return false;
+    }
+    if (count != pObject->Member_Count) {
+        /* a member column for each member */
+        if (!Trend_Log_Multiple_Columns_Open(
+                pObject, pObject->Buffer_Size, count)) {
+            return false;
+        }
+        changed = true;
+    }
+    for (i = 0; i < count; i++) {
+        if (!bacnet_device_object_property_reference_same(
+                &pObject->Members[i], &members[i])) {
+            bacnet_device_object_property_reference_copy(
+                &pObject->Members[i], &members[i]);
+            changed = true;
+        }
+    }
+    pObject->Member_Count = count;
+    if (changed) {
+        /* Clear buffer if the properties being logged are changed */
+        Trend_Log_Multiple_Records_Purge(pObject, object_instance);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Initialize a member that references no object
+ * @param reference - [out] the member
+ */
+static void Trend_Log_Multiple_Member_Init(
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference)
+{
+    reference->objectIdentifier.type = OBJECT_DEVICE;
+    reference->objectIdentifier.instance = BACNET_MAX_INSTANCE;
+    reference->propertyIdentifier = PROP_PRESENT_VALUE;
+    reference->arrayIndex = BACNET_ARRAY_ALL;
+    reference->deviceIdentifier.type = BACNET_NO_DEV_TYPE;
+    reference->deviceIdentifier.instance = BACNET_NO_DEV_ID;
+}
+
+/**
+ * @brief For a given object instance-number, sets the size of the
+ *  Log_DeviceObjectProperty array. New members reference no object,
+ *  and are logged as a null-value until they are set.
+ * @param  object_instance - object-instance number of the object
+ * @param  count - the number of members of the log
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Member_Count_Set(
+    uint32_t object_instance, unsigned count)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE
+    members[BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX];
+    struct object_data *pObject;
+    unsigned i;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject || (count > BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX)) {
+        return false;
+    }
+    for (i = 0; i < count; i++) {
+        if (i < pObject->Member_Count) {
+            members[i] = pObject->Members[i];
+        } else {
+            Trend_Log_Multiple_Member_Init(&members[i]);
+        }
+    }
+
+    return Trend_Log_Multiple_Members_Set(
+        pObject, object_instance, members, count);
+}
+
+/**
+ * @brief For a given object instance-number, gets a member
+ * @param  object_instance - object-instance number of the object
+ * @param  index - 0 based element of the Log_DeviceObjectProperty array
+ * @param  member - [out] the member
+ * @return true if the member exists
+ */
+bool Trend_Log_Multiple_Member(
+    uint32_t object_instance,
+    unsigned index,
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *member)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject && (index < pObject->Member_Count)) {
+        if (member) {
+            *member = pObject->Members[index];
+        }
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, sets a member, and purges
+ *  the log buffer when the member changes
+ * @param  object_instance - object-instance number of the object
+ * @param  index - 0 based element of the Log_DeviceObjectProperty array
+ * @param  member - the member
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Member_Set(
+    uint32_t object_instance,
+    unsigned index,
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *member)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE
+    members[BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX];
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject || !member || (index >= pObject->Member_Count)) {
+        return false;
+    }
+    memcpy(members, pObject->Members, sizeof(members));
+    members[index] = *member;
+
+    return Trend_Log_Multiple_Members_Set(
+        pObject, object_instance, members, pObject->Member_Count);
+}
+
+/**
+ * @brief For a given object instance-number, determines the Buffer_Size
+ * @param  object_instance - object-instance number of the object
+ * @return the number of records in the log buffer
+ */
+uint32_t Trend_Log_Multiple_Buffer_Size(uint32_t object_instance)
+{
+    uint32_t value = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Buffer_Size;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, sets the Buffer_Size.
+ *  The records of the log are cleared.
+ * @param  object_instance - object-instance number of the object
+ * @param  buffer_size - the number of records in the log buffer
+ * @return true if set
+ */
+bool Trend_Log_Multiple_Buffer_Size_Set(
+    uint32_t object_instance, uint32_t buffer_size)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject && (buffer_size <= BACNET_TREND_LOG_MULTIPLE_BUFFER_SIZE_MAX)) {
+        status = Trend_Log_Multiple_Columns_Open(
+            pObject, buffer_size, pObject->Member_Count);
+    }
+
+    return status;
+}
+
+/**
+ * @brief For a given object instance-number, determines the Record_Count
+ * @param  object_instance - object-instance number of the object
+ * @return the number of records in the log buffer
+ */
+uint32_t Trend_Log_Multiple_Record_Count(uint32_t object_instance)
+{
+    uint32_t value = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Record_Count;
+    }
+
+    return value;
+}
+
+/**
+ * @brief For a given object instance-number, determines the
+ *  Total_Record_Count
+ * @param  object_instance - object-instance number of the object
+ * @return the number of records added to the log buffer
+ */
+uint32_t Trend_Log_Multiple_Total_Record_Count(uint32_t object_instance)
+{
+    uint32_t value = 0;
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject) {
+        value = pObject->Record_Count_Total;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Insert a log-status record into a log, without regard to the
+ *  Enable property, which may push the oldest record out of the log
+ * @param  object_instance - object-instance number of the object
+ * @param  log_status - the log status
+ * @param  state - the state of the log status
+ */
+void Trend_Log_Multiple_Record_Status_Insert(
+    uint32_t object_instance, BACNET_LOG_STATUS log_status, bool state)
+{
+    struct object_data *pObject;
+    uint32_t value = 0;
+    uint32_t row;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject || !pObject->Columns) {
+        return;
+    }
+    /* Note we set the bits in correct order so that we can place them
+     * directly into the bitstring structure when we encode them */
+    if (state && (log_status < LOG_STATUS_MAX)) {
+        value = 1 << log_status;
+    }
+    row = Trend_Log_Multiple_Row_Append(
+        pObject, Trend_Log_Multiple_Epoch_Seconds_Now(), TLM_ROW_LOG_STATUS);
+    Trend_Log_Multiple_Datum_Set(pObject, 0, row, 0, value);
+}
+
+/**
+ * @brief Take a sample of all the members of an enabled log now,
+ *  for example when a triggered log has an event
+ * @param  object_instance - object-instance number of the object
+ */
+void Trend_Log_Multiple_Sample(uint32_t object_instance)
+{
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (pObject && pObject->Enable && pObject->Columns) {
+        Trend_Log_Multiple_Row_Sample(
+            pObject, object_instance, Trend_Log_Multiple_Epoch_Seconds_Now());
+    }
+}
+
+/**
+ * @brief Determine the earliest time at or after a given time that a
+ *  polled log is due for a sample
+ * @param pObject - object data
+ * @param tTime - the given time, in seconds since the epoch
+ * @return the time the log is due, in seconds since the epoch
+ */
+static bacnet_time_t Trend_Log_Multiple_Due_Time(
+    const struct object_data *pObject, bacnet_time_t tTime)
+{
+    bacnet_time_t tInterval = pObject->Log_Interval;
+
+    if (pObject->Align_Intervals) {
+        /* the samples are at the interval boundaries, plus the offset */
+        tTime += ((pObject->Interval_Offset % tInterval) + tInterval -
+                  (tTime % tInterval)) %
+            tInterval;
+    }
+
+    return tTime;
+}
+
+/**
+ * @brief Take the samples of a log that are due. A polled log samples all
+ *  of its members once per Log_Interval, and a set Trigger takes a sample
+ *  of an enabled log of any Logging_Type.
+ * @param  object_instance - object-instance number of the object
+ * @param  milliseconds - number of milliseconds elapsed (not used)
+ */
+void Trend_Log_Multiple_Timer(uint32_t object_instance, uint16_t milliseconds)
+{
+    struct object_data *pObject;
+    bacnet_time_t tNow;
+
+    (void)milliseconds;
+    pObject = Object_Data(object_instance);
+    if (!pObject || !pObject->Enable || !pObject->Columns) {
+        return;
+    }
+    tNow = Trend_Log_Multiple_Epoch_Seconds_Now();
+    if (pObject->Trigger) {
+        pObject->Trigger = false;
+        Trend_Log_Multiple_Row_Sample(pObject, object_instance, tNow);
+        return;
+    }
+    if ((pObject->Logging_Type != LOGGING_TYPE_POLLED) ||
+        (pObject->Log_Interval == 0)) {
+        return;
+    }
+    if (!pObject->Scheduled ||
+        (tNow + pObject->Log_Interval < pObject->Due_Time)) {
+        /* start, or start over when the clock went back */
+        pObject->Due_Time = Trend_Log_Multiple_Due_Time(pObject, tNow);
+        pObject->Scheduled = true;
+    }
+    if (tNow >= pObject->Due_Time) {
+        Trend_Log_Multiple_Row_Sample(pObject, object_instance, tNow);
+        if (pObject->Align_Intervals) {
+            pObject->Due_Time = Trend_Log_Multiple_Due_Time(pObject, tNow + 1);
+        } else {
+            pObject->Due_Time = tNow + pObject->Log_Interval;
+        }
+    }
+}
+
+/**
+ * @brief Encode a member datum of a log-data record from its cells
+ * @param pObject - object data
+ * @param member - 0 based index of the member column
+ * @param row - row of the record
+ * @param apdu - buffer for the encoding, or NULL for the length
+ * @return number of bytes encoded
+ */
+static int Trend_Log_Multiple_Datum_Encode(
+    const struct object_data *pObject,
+    unsigned member,
+    uint32_t row,
+    uint8_t *apdu)
+{
+    BACNET_BIT_STRING bit_string;
+    size_t cell;
+    uint8_t datum;
+    uint32_t value;
+    float real_value;
+    int apdu_len = 0, len;
+    uint8_t i;
+
+    cell = Trend_Log_Multiple_Cell(pObject, member, row);
+    datum = pObject->Datums[cell];
+    value = pObject->Values[cell];
+    switch (datum) {
+        case TLM_DATUM_BOOLEAN:
+            apdu_len = encode_context_boolean(apdu, datum, value != 0);
+            break;
+        case TLM_DATUM_REAL:
+            memcpy(&real_value, &value, sizeof(real_value));
+            apdu_len = encode_context_real(apdu, datum, real_value);
+            break;
+        case TLM_DATUM_ENUMERATED:
+            apdu_len = encode_context_enumerated(apdu, datum, value);
+            break;
+        case TLM_DATUM_UNSIGNED:
+            apdu_len = encode_context_unsigned(apdu, datum, value);
+            break;
+        case TLM_DATUM_SIGNED:
+            apdu_len = encode_context_signed(apdu, datum, (int32_t)value);
+            break;
+        case TLM_DATUM_BITSTRING:
+            bitstring_init(&bit_string);
+            bitstring_bits_used_set(&bit_string, (uint8_t)(value >> 24));
+            for (i = 0; i < TLM_BITSTRING_OCTETS_MAX; i++) {
+                bitstring_set_octet(
+                    &bit_string, i, (uint8_t)(value >> (i * 8)));
+            }
+            apdu_len = encode_context_bitstring(apdu, datum, &bit_string);
+            break;
+        case TLM_DATUM_FAILURE:
+            len = encode_opening_tag(apdu, datum);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+            len = encode_application_enumerated(apdu, value >> 16);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+            len = encode_application_enumerated(apdu, value & 0xFFFF);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+            len = encode_closing_tag(apdu, datum);
+            apdu_len += len;
+            break;
+        case TLM_DATUM_NULL:
+        default:
+            apdu_len = encode_context_null(apdu, TLM_DATUM_NULL);
+            break;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode a BACnetLogMultipleRecord straight from the columns
+ *
+ *  BACnetLogMultipleRecord ::= SEQUENCE {
+ *      timestamp [0] BACnetDateTime,
+ *      log-data [1] BACnetLogData
+ *  }
+ *  BACnetLogData ::= CHOICE {
+ *      log-status [0] BACnetLogStatus,
+ *      log-data [1] SEQUENCE OF CHOICE { ... },
+ *      time-change [2] REAL
+ *  }
+ *
+ * @param pObject - object data
+ * @param index - 0 based index of the record, oldest first
+ * @param apdu - buffer for the encoding, or NULL for the length
+ * @return number of bytes encoded
+ */
+static int Trend_Log_Multiple_Record_Encode(
+    const struct object_data *pObject, uint32_t index, uint8_t *apdu)
+{
+    BACNET_DATE_TIME timestamp;
+    BACNET_BIT_STRING bit_string;
+    uint32_t row;
+    unsigned member;
+    int apdu_len = 0, len;
+
+    row = Trend_Log_Multiple_Row(pObject, index);
+    datetime_since_epoch_seconds(&timestamp, pObject->Time_Stamps[row]);
+    len = bacapp_encode_context_datetime(apdu, 0, &timestamp);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_opening_tag(apdu, 1);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    if (pObject->Choices[row] == TLM_ROW_LOG_STATUS) {
+        bitstring_init(&bit_string);
+        bitstring_set_bits_used(&bit_string, 1, 8 - LOG_STATUS_MAX);
+        bitstring_set_octet(
+            &bit_string, 0,
+            (uint8_t)pObject->Values[Trend_Log_Multiple_Cell(pObject, 0, row)]);
+        len = encode_context_bitstring(apdu, TLM_ROW_LOG_STATUS, &bit_string);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    } else {
+        len = encode_opening_tag(apdu, TLM_ROW_LOG_DATA);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        for (member = 0; member < pObject->Member_Count; member++) {
+            len = Trend_Log_Multiple_Datum_Encode(pObject, member, row, apdu);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        len = encode_closing_tag(apdu, TLM_ROW_LOG_DATA);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+    len = encode_closing_tag(apdu, 1);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode a Log_DeviceObjectProperty array element
+ * @param object_instance - object-instance number of the object
+ * @param index - 0 based array index
+ * @param apdu - buffer for the encoding, or NULL for the length
+ * @return number of bytes encoded, or BACNET_STATUS_ERROR
+ */
+static int Trend_Log_Multiple_Member_Encode(
+    uint32_t object_instance, BACNET_ARRAY_INDEX index, uint8_t *apdu)
+{
+    struct object_data *pObject;
+
+    pObject = Object_Data(object_instance);
+    if (!pObject || (index >= pObject->Member_Count)) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return bacapp_encode_device_obj_property_ref(
+        apdu, &pObject->Members[index]);
+}
+
+/**
+ * ReadProperty handler for this object.  For the given ReadProperty
+ * data, the application_data is loaded or the error flags are set.
+ *
+ * @param  rpdata - BACNET_READ_PROPERTY_DATA data, including
+ * requested data and space for the reply, or error response.
+ *
+ * @return number of APDU bytes in the response, or
+ * BACNET_STATUS_ERROR on error.
+ */
+int Trend_Log_Multiple_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    int apdu_len = 0; /* return value */
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    BACNET_BIT_STRING bit_string = { 0 };
+    struct object_data *pObject;
+    uint8_t *apdu = NULL;
+    int apdu_size;
+
+    if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
+        (rpdata->application_data_len == 0)) {
+        return 0;
+    }
+    pObject = Object_Data(rpdata->object_instance);
+    if (!pObject) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return BACNET_STATUS_ERROR;
+    }
+    apdu = rpdata->application_data;
+    apdu_size = rpdata->application_data_len;
+    switch (rpdata->object_property) {
+        case PROP_OBJECT_IDENTIFIER:
+            apdu_len = encode_application_object_id(
+                &apdu[0], rpdata->object_type, rpdata->object_instance);
+            break;
+        case PROP_OBJECT_NAME:
+            Trend_Log_Multiple_Object_Name(
+                rpdata->object_instance, &char_string);
+            apdu_len =
+                encode_application_character_string(&apdu[0], &char_string);
+            break;
+        case PROP_OBJECT_TYPE:
+            apdu_len =
+                encode_application_enumerated(&apdu[0], rpdata->object_type);
+            break;
+        case PROP_DESCRIPTION:
+            characterstring_init_ansi(&char_string, pObject->Description);
+            apdu_len =
+                encode_application_character_string(&apdu[0], &char_string);
+            break;
+        case PROP_STATUS_FLAGS:
+            /* note: see the details in the standard on how to use these */
+            bitstring_init(&bit_string);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, false);
+            apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
+            break;
+        case PROP_EVENT_STATE:
+            /* note: see the details in the standard on how to use this */
+            apdu_len =
+                encode_application_enumerated(&apdu[0], EVENT_STATE_NORMAL);
+            break;
+        case PROP_ENABLE:
+            apdu_len = encode_application_boolean(&apdu[0], pObject->Enable);
+            break;
+        case PROP_LOG_DEVICE_OBJECT_PROPERTY:
+            apdu_len = bacnet_array_encode(
+                rpdata->object_instance, rpdata->array_index,
+                Trend_Log_Multiple_Member_Encode, pObject->Member_Count, apdu,
+                apdu_size);
+            if (apdu_len == BACNET_STATUS_ABORT) {
+                rpdata->error_code =
+                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+            } else if (apdu_len == BACNET_STATUS_ERROR) {
+                rpdata->error_class = ERROR_CLASS_PROPERTY;
+                rpdata->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+            }
+            break;
+        case PROP_LOGGING_TYPE:
+            apdu_len =
+                encode_application_enumerated(&apdu[0], pObject->Logging_Type);
+            break;
+        case PROP_LOG_INTERVAL:
+            /* We only log to 1 sec accuracy so must multiply by 100 before
+             * passing it on */
+            apdu_len = encode_application_unsigned(
+                &apdu[0], (BACNET_UNSIGNED_INTEGER)pObject->Log_Interval * 100);
+            break;
+        case PROP_STOP_WHEN_FULL:
+            apdu_len =
+                encode_application_boolean(&apdu[0], pObject->Stop_When_Full);
+            break;
+        case PROP_BUFFER_SIZE:
+            apdu_len =
+                encode_application_unsigned(&apdu[0], pObject->Buffer_Size);
+            break;
+        case PROP_LOG_BUFFER:
+            /* You can only read the buffer via the ReadRange service */
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_READ_ACCESS_DENIED;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+        case PROP_RECORD_COUNT:
+            apdu_len =
+                encode_application_unsigned(&apdu[0], pObject->Record_Count);
+            break;
+        case PROP_TOTAL_RECORD_COUNT:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], pObject->Record_Count_Total);
+            break;
+        case PROP_ALIGN_INTERVALS:
+            apdu_len =
+                encode_application_boolean(&apdu[0], pObject->Align_Intervals);
+            break;
+        case PROP_INTERVAL_OFFSET:
+            apdu_len = encode_application_unsigned(
+                &apdu[0],
+                (BACNET_UNSIGNED_INTEGER)pObject->Interval_Offset * 100);
+            break;
+        case PROP_TRIGGER:
+            apdu_len = encode_application_boolean(&apdu[0], pObject->Trigger);
+            break;
+        default:
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+    }
+    /*  only array properties can have array options */
+    if ((apdu_len >= 0) && (!BACnetARRAY_Property(rpdata->object_property)) &&
+        (rpdata->array_index != BACNET_ARRAY_ALL)) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        apdu_len = BACNET_STATUS_ERROR;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode a member for the Log_DeviceObjectProperty array, and
+ *  check that it is an object in this device
+ * @param wp_data - the WriteProperty data, for the error
+ * @param apdu - the encoded member
+ * @param apdu_size - number of octets of the encoded data
+ * @param member - [out] the decoded member
+ * @return number of octets decoded, or BACNET_STATUS_ERROR
+ */
+static int Trend_Log_Multiple_Member_Decode(
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    const uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *member)
+{
+    int len;
+
+    len = bacnet_device_object_property_reference_decode(
+        apdu, apdu_size, member);
+    if (len <= 0) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+        return BACNET_STATUS_ERROR;
+    }
+    /* We only support references to objects in this device */
+    if (!Trend_Log_Multiple_Member_Local(member)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Write the Log_DeviceObjectProperty array, all at once, its
+ *  size at element zero, or one of its elements
+ * @param pObject - object data
+ * @param wp_data - the WriteProperty data
+ * @return true if written
+ */
+static bool Trend_Log_Multiple_Members_Write(
+    struct object_data *pObject, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE
+    members[BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX];
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    unsigned count = 0;
+    size_t apdu_len = 0;
+    int len;
+
+    if (wp_data->array_index == 0) {
+        len = bacnet_unsigned_application_decode(
+            wp_data->application_data, wp_data->application_data_len,
+            &unsigned_value);
+        if (len <= 0) {
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+            return false;
+        }
+        if (unsigned_value > BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX) {
+            wp_data->error_class = ERROR_CLASS_RESOURCES;
+            wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            return false;
+        }
+        count = (unsigned)unsigned_value;
+        if (!Trend_Log_Multiple_Member_Count_Set(
+                wp_data->object_instance, count)) {
+            wp_data->error_class = ERROR_CLASS_RESOURCES;
+            wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            return false;
+        }
+        return true;
+    }
+    memcpy(members, pObject->Members, sizeof(members));
+    if (wp_data->array_index == BACNET_ARRAY_ALL) {
+        while (apdu_len < (size_t)wp_data->application_data_len) {
+            if (count >= BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX) {
+                wp_data->error_class = ERROR_CLASS_RESOURCES;
+                wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+                return false;
+            }
+            len = Trend_Log_Multiple_Member_Decode(
+                wp_data, &wp_data->application_data[apdu_len],
+                wp_data->application_data_len - apdu_len, &members[count]);
+            if (len < 0) {
+                return false;
+            }
+            apdu_len += len;
+            count++;
+        }
+    } else if (wp_data->array_index <= pObject->Member_Count) {
+        count = pObject->Member_Count;
+        len = Trend_Log_Multiple_Member_Decode(
+            wp_data, wp_data->application_data, wp_data->application_data_len,
+            &members[wp_data->array_index - 1]);
+        if (len < 0) {
+            return false;
+        }
+    } else {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+        return false;
+    }
+    if (!Trend_Log_Multiple_Members_Set(
+            pObject, wp_data->object_instance, members, count)) {
+        wp_data->error_class = ERROR_CLASS_RESOURCES;
+        wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * WriteProperty handler for this object.  For the given WriteProperty
+ * data, the application_data is loaded or the error flags are set.
+ *
+ * @param  wp_data - BACNET_WRITE_PROPERTY_DATA data, including
+ * requested data and space for the reply, or error response.
+ *
+ * @return false if an error is loaded, true if no errors
+ */
+bool Trend_Log_Multiple_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    bool status = false; /* return value */
+    int len = 0;
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    struct object_data *pObject;
+
+    pObject = Object_Data(wp_data->object_instance);
+    if (!pObject) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    if ((!BACnetARRAY_Property(wp_data->object_property)) &&
+        (wp_data->array_index != BACNET_ARRAY_ALL)) {
+        /*  only array properties can have array options */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return false;
+    }
+    if (wp_data->object_property == PROP_LOG_DEVICE_OBJECT_PROPERTY) {
+        /* the members are decoded as they are written */
+        return Trend_Log_Multiple_Members_Write(pObject, wp_data);
+    }
+    /* decode the some of the request */
+    len = bacapp_decode_application_data(
+        wp_data->application_data, wp_data->application_data_len, &value);
+    if (len < 0) {
+        /* error while decoding - a value larger than we can handle */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return false;
+    }
+    switch (wp_data->object_property) {
+        case PROP_ENABLE:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (!status) {
+                break;
+            }
+            if (!pObject->Enable && value.type.Boolean &&
+                pObject->Stop_When_Full &&
+                ((pObject->Record_Count + 1) >= pObject->Buffer_Size)) {
+                /* can't enable a full log with stop when full set */
+                wp_data->error_class = ERROR_CLASS_OBJECT;
+                wp_data->error_code = ERROR_CODE_LOG_BUFFER_FULL;
+                status = false;
+            } else {
+                Trend_Log_Multiple_Enable_Set(
+                    wp_data->object_instance, value.type.Boolean);
+            }
+            break;
+        case PROP_LOGGING_TYPE:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_ENUMERATED);
+            if (!status) {
+                break;
+            }
+            if ((value.type.Enumerated == LOGGING_TYPE_POLLED) &&
+                (pObject->Log_Interval == 0)) {
+                /* a polled log needs an interval */
+                pObject->Log_Interval = 1;
+            }
+            status = Trend_Log_Multiple_Logging_Type_Set(
+                wp_data->object_instance,
+                (BACNET_LOGGING_TYPE)value.type.Enumerated);
+            if (!status) {
+                /* COV logging is not permitted for this object */
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+            }
+            break;
+        case PROP_LOG_INTERVAL:
+            if (pObject->Logging_Type == LOGGING_TYPE_TRIGGERED) {
+                /* Read only if triggered log */
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+                break;
+            }
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (!status) {
+                break;
+            }
+            if (value.type.Unsigned_Int == 0) {
+                /* An interval of 0 is not polling */
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                status = false;
+            } else if (value.type.Unsigned_Int > (UINT32_MAX / 100 * 100)) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                status = false;
+            } else {
+                /* We only log to 1 sec accuracy so must divide by 100
+                 * before passing it on, and an interval of 0 is not a
+                 * good idea */
+                Trend_Log_Multiple_Log_Interval_Set(
+                    wp_data->object_instance,
+                    (value.type.Unsigned_Int < 100)
+                        ? 1
+                        : (uint32_t)(value.type.Unsigned_Int / 100));
+            }
+            break;
+        case PROP_STOP_WHEN_FULL:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status) {
+                Trend_Log_Multiple_Stop_When_Full_Set(
+                    wp_data->object_instance, value.type.Boolean);
+            }
+            break;
+        case PROP_BUFFER_SIZE:
+            /* Resizing the buffer erases the current log, and the
+             * write is not allowed if enable is true. */
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (!status) {
+                break;
+            }
+            if (pObject->Enable) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+                status = false;
+            } else if (
+                (value.type.Unsigned_Int == 0) ||
+                (value.type.Unsigned_Int >
+                 BACNET_TREND_LOG_MULTIPLE_BUFFER_SIZE_MAX)) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                status = false;
+            } else {
+                status = Trend_Log_Multiple_Buffer_Size_Set(
+                    wp_data->object_instance,
+                    (uint32_t)value.type.Unsigned_Int);
+                if (!status) {
+                    wp_data->error_class = ERROR_CLASS_RESOURCES;
+                    wp_data->error_code =
+                        ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+                }
+            }
+            break;
+        case PROP_RECORD_COUNT:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (!status) {
+                break;
+            }
+            if (value.type.Unsigned_Int == 0) {
+                /* Time to clear down the log */
+                Trend_Log_Multiple_Records_Purge(
+                    pObject, wp_data->object_instance);
+            } else {
+                /* only a value of zero is accepted */
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                status = false;
+            }
+            break;
+        case PROP_ALIGN_INTERVALS:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status) {
+                Trend_Log_Multiple_Align_Intervals_Set(
+                    wp_data->object_instance, value.type.Boolean);
+            }
+            break;
+        case PROP_INTERVAL_OFFSET:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                /* We only log to 1 sec accuracy so must divide by 100
+                 * before passing it on */
+                Trend_Log_Multiple_Interval_Offset_Set(
+                    wp_data->object_instance,
+                    (uint32_t)(value.type.Unsigned_Int / 100));
+            }
+            break;
+        case PROP_TRIGGER:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status) {
+                Trend_Log_Multiple_Trigger_Set(
+                    wp_data->object_instance, value.type.Boolean);
+            }
+            break;
+        default:
+            if (property_lists_member(
+                    Properties_Required, Properties_Optional,
+                    Properties_Proprietary, wp_data->object_property)) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+            } else {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            }
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Get the space for the records of a ReadRange response
+ * @param pRequest - the read range request
+ * @return number of octets for the records
+ */
+static size_t
+Trend_Log_Multiple_Read_Range_Size(const BACNET_READ_RANGE_DATA *pRequest)
+{
+    if (pRequest->application_data_len <= pRequest->Overhead) {
+        return 0;
+    }
+
+    return pRequest->application_data_len - pRequest->Overhead;
+}
+
+/**
+ * @brief Encode the records of a log from a given record, until the
+ *  count or the log or the space runs out, and set the result flags
+ * @param pObject - object data
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @param first - 0 based index of the first record to encode
+ * @param count - number of records to encode
+ * @return number of bytes encoded
+ */
+static int Trend_Log_Multiple_Records_Encode(
+    const struct object_data *pObject,
+    uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    uint32_t first,
+    uint32_t count)
+{
+    size_t apdu_size;
+    int apdu_len = 0;
+    int len;
+    uint32_t index;
+
+    apdu_size = Trend_Log_Multiple_Read_Range_Size(pRequest);
+    if (count > (pObject->Record_Count - first)) {
+        count = pObject->Record_Count - first;
+    }
+    for (index = first; index < (first + count); index++) {
+        len = Trend_Log_Multiple_Record_Encode(pObject, index, NULL);
+        if ((size_t)len > (apdu_size - apdu_len)) {
+            /*
+             * Can't fit any more in! We just set the result flag to say there
+             * was more and drop out of the loop early
+             */
+            bitstring_set_bit(
+                &pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, true);
+            break;
+        }
+        len = Trend_Log_Multiple_Record_Encode(pObject, index, apdu);
+        apdu += len;
+        apdu_len += len;
+        /* Chalk up another one for the response count */
+        pRequest->ItemCount++;
+    }
+    /* Set remaining result flags if necessary */
+    if ((pRequest->ItemCount > 0) && (first == 0)) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
+    }
+    if ((pRequest->ItemCount > 0) && (index == pObject->Record_Count)) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
+    }
+    /* the sequence number of the first record encoded */
+    pRequest->FirstSequence =
+        pObject->Record_Count_Total - pObject->Record_Count + first + 1;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Handle encoding for the By Position and All options.
+ *  Does All option by converting to a By Position request starting at index
+ *  1 and of maximum log size length.
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @return  number of bytes encoded, or 0 if unable to encode.
+ */
+int Trend_Log_Multiple_Read_Range_By_Position(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    struct object_data *pObject;
+    uint32_t record_count;
+    int32_t iTemp = 0;
+    uint32_t uiTarget = 0; /* Last entry we are required to encode */
+
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject || (pObject->Record_Count == 0)) {
+        return 0;
+    }
+    record_count = pObject->Record_Count;
+    if (pRequest->RequestType == RR_READ_ALL) {
+        /*
+         * Read all the list or as much as will fit in the buffer by selecting
+         * a range that covers the whole list and falling through to the next
+         * section of code
+         */
+        pRequest->Count = record_count;
+        /* Starting at the beginning */
+        pRequest->Range.RefIndex = 1;
+    }
+    if (pRequest->Count < 0) {
+        /*
+         * negative count means work from index backwards
+         *
+         * Convert from end index/negative count to
+         * start index/positive count and then process as
+         * normal. This assumes that the order to return items
+         * is always first to last, if this is not true we will
+         * have to handle this differently.
+         */
+        /* pull out and convert to signed */
+        iTemp = pRequest->Range.RefIndex;
+        /* Adjust backwards, remember count is -ve */
+        iTemp += pRequest->Count + 1;
+        if (iTemp < 1) {
+            /* if count is too much, return from 1 to start index */
+            pRequest->Count = pRequest->Range.RefIndex;
+            pRequest->Range.RefIndex = 1;
+        } else {
+            /* Otherwise adjust the start index and make count +ve */
+            pRequest->Range.RefIndex = iTemp;
+            pRequest->Count = -pRequest->Count;
+        }
+    }
+    /* From here on in we only have a starting point and a positive count */
+    if ((pRequest->Range.RefIndex == 0) ||
+        (pRequest->Range.RefIndex > record_count)) {
+        /* Nothing to return as we are past the end of the list */
+        return 0;
+    }
+    /* Index of last required entry */
+    uiTarget = pRequest->Range.RefIndex + pRequest->Count - 1;
+    if (uiTarget > record_count) {
+        /* Capped at end of list if necessary */
+        uiTarget = record_count;
+    }
+
+    return Trend_Log_Multiple_Records_Encode(
+        pObject, apdu, pRequest, pRequest->Range.RefIndex - 1,
+        uiTarget - pRequest->Range.RefIndex + 1);
+}
+
+/**
+ * @brief Handle encoding for the By Sequence option.
+ *  Each record has the sequence number of the Total_Record_Count when
+ *  it was added, so a sequence number is found in the log by its distance
+ *  from the oldest record. The distances also cover a sequence number
+ *  range that wraps around the maximum for uint32_t.
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @return  number of bytes encoded, or 0 if unable to encode.
+ */
+int Trend_Log_Multiple_Read_Range_By_Sequence(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    struct object_data *pObject;
+    uint32_t record_count;
+    uint32_t uiFirstSeq = 0; /* Sequence number for 1st record in log */
+    uint32_t uiBegin = 0; /* Starting Sequence number for request */
+    int64_t iFirst = 0; /* first record index of the request */
+    int64_t iLast = 0; /* last record index of the request */
+
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject || (pObject->Record_Count == 0) || (pRequest->Count == 0)) {
+        return 0;
+    }
+    record_count = pObject->Record_Count;
+    uiFirstSeq = pObject->Record_Count_Total - (record_count - 1);
+    /* Calculate the start sequence number from request */
+    if (pRequest->Count < 0) {
+        uiBegin = pRequest->Range.RefSeqNum + pRequest->Count + 1;
+    } else {
+        uiBegin = pRequest->Range.RefSeqNum;
+    }
+    /* the records of the request, as their distance from the oldest */
+    iFirst = (int32_t)(uiBegin - uiFirstSeq);
+    if (pRequest->Count < 0) {
+        iLast = iFirst - (int64_t)pRequest->Count - 1;
+    } else {
+        iLast = iFirst + (int64_t)pRequest->Count - 1;
+    }
+    /* If no overlap between request range and buffer contents bail out */
+    if ((iLast < 0) || (iFirst >= (int64_t)record_count)) {
+        return 0;
+    }
+    /* Truncate range if necessary so it lies within the log buffer */
+    if (iFirst < 0) {
+        iFirst = 0;
+    }
+    if (iLast >= (int64_t)record_count) {
+        iLast = record_count - 1;
+    }
+
+    return Trend_Log_Multiple_Records_Encode(
+        pObject, apdu, pRequest, (uint32_t)iFirst,
+        (uint32_t)(iLast - iFirst + 1));
+}
+
+/**
+ * @brief Handle encoding for the By Time option. The time stamp column
+ *  is searched with the reference time in seconds, so no record is
+ *  decoded to find where the request starts.
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @return  number of bytes encoded, or 0 if unable to encode.
+ */
+int Trend_Log_Multiple_Read_Range_By_Time(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    struct object_data *pObject;
+    bacnet_time_t tRefTime;
+    uint32_t record_count;
+    uint32_t index;
+    uint32_t count;
+
+    pObject = Object_Data(pRequest->object_instance);
+    if (!pObject || (pObject->Record_Count == 0) || (pRequest->Count == 0)) {
+        return 0;
+    }
+    record_count = pObject->Record_Count;
+    tRefTime = datetime_seconds_since_epoch(&pRequest->Range.RefTime);
+    if (pRequest->Count < 0) {
+        /* Start at end of log and look for the last record which has
+         * a timestamp less than the reference time */
+        index = record_count;
+        while (index > 0) {
+            if (pObject->Time_Stamps[Trend_Log_Multiple_Row(
+                    pObject, index - 1)] < tRefTime) {
+                break;
+            }
+            index--;
+        }
+        if (index == 0) {
+            /* end of records, not found */
+            return 0;
+        }
+        /* work backwards to find where we should start from */
+        count = (uint32_t)(-pRequest->Count);
+        if (count > index) {
+            count = index;
+        }
+        index -= count;
+    } else {
+        /* Start at beginning of log and look for 1st record which has
+         * timestamp greater than the reference time */
+        for (index = 0; index < record_count; index++) {
+            if (pObject->Time_Stamps[Trend_Log_Multiple_Row(pObject, index)] >
+                tRefTime) {
+                break;
+            }
+        }
+        if (index == record_count) {
+            return 0;
+        }
+        count = (uint32_t)pRequest->Count;
+    }
+
+    return Trend_Log_Multiple_Records_Encode(
+        pObject, apdu, pRequest, index, count);
+}
+
+/**
+ * @brief For a given read range request, encodes log records
+ * @param apdu - buffer to hold the bytes
+ * @param pRequest - the read range request
+ * @return  number of bytes encoded, or 0 if unable to encode.
+ */
+int Trend_Log_Multiple_Read_Range(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    int apdu_len = 0;
+
+    if (!pRequest) {
+        return 0;
+    }
+    /* Initialise result flags to all false */
+    bitstring_init(&pRequest->ResultFlags);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, false);
+    pRequest->ItemCount = 0; /* Start out with nothing */
+    if ((pRequest->RequestType == RR_BY_POSITION) ||
+        (pRequest->RequestType == RR_READ_ALL)) {
+        apdu_len = Trend_Log_Multiple_Read_Range_By_Position(apdu, pRequest);
+    } else if (pRequest->RequestType == RR_BY_SEQUENCE) {
+        apdu_len = Trend_Log_Multiple_Read_Range_By_Sequence(apdu, pRequest);
+    } else {
+        apdu_len = Trend_Log_Multiple_Read_Range_By_Time(apdu, pRequest);
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Get the ReadRange handler for a property of this object
+ * @param pRequest - the read range request
+ * @param pInfo - [out] the request types and handler for the property
+ * @return true if the property can be read with ReadRange
+ */
+bool Trend_Log_Multiple_Read_Range_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo)
+{
+    if (!Trend_Log_Multiple_Valid_Instance(pRequest->object_instance)) {
+        pRequest->error_class = ERROR_CLASS_OBJECT;
+        pRequest->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+    } else if (pRequest->object_property == PROP_LOG_BUFFER) {
+        pInfo->RequestTypes = RR_BY_POSITION | RR_BY_TIME | RR_BY_SEQUENCE;
+        pInfo->Handler = Trend_Log_Multiple_Read_Range;
+        return true;
+    } else {
+        pRequest->error_class = ERROR_CLASS_SERVICES;
+        pRequest->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Creates a Trend Log Multiple object
+ * @param object_instance - object-instance number of the object
+ * @return object_instance if the object is created, else BACNET_MAX_INSTANCE
+ */
+uint32_t Trend_Log_Multiple_Create(uint32_t object_instance)
+{
+    struct object_data *pObject = NULL;
+    int index = 0;
+
+    if (!Object_List) {
+        Object_List = Keylist_Create();
+    }
+    if (object_instance > BACNET_MAX_INSTANCE) {
+        return BACNET_MAX_INSTANCE;
+    } else if (object_instance == BACNET_MAX_INSTANCE) {
+        /* wildcard instance */
+        /* the Object_Identifier property of the newly created object
+            shall be initialized to a value that is unique within the
+            responding BACnet-user device. The method used to generate
+            the object identifier is a local matter.*/
+        object_instance = Keylist_Next_Empty_Key(Object_List, 1);
+    }
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        pObject = calloc(1, sizeof(struct object_data));
+        if (!pObject) {
+            return BACNET_MAX_INSTANCE;
+        }
+        pObject->Object_Name = NULL;
+        pObject->Description = NULL;
+        pObject->Enable = false;
+        pObject->Stop_When_Full = false;
+        pObject->Align_Intervals = false;
+        pObject->Trigger = false;
+        pObject->Logging_Type = LOGGING_TYPE_POLLED;
+        pObject->Log_Interval = 900;
+        pObject->Interval_Offset = 0;
+        pObject->Member_Count = 0;
+        if (!Trend_Log_Multiple_Columns_Open(
+                pObject, BACNET_TREND_LOG_MULTIPLE_RECORDS_MAX, 0)) {
+            free(pObject);
+            return BACNET_MAX_INSTANCE;
+        }
+        /* add to list */
+        index = Keylist_Data_Add(Object_List, object_instance, pObject);
+        if (index < 0) {
+            Trend_Log_Multiple_Columns_Close(pObject);
+            free(pObject);
+            return BACNET_MAX_INSTANCE;
+        }
+    }
+
+    return object_instance;
+}
+
+/**
+ * @brief Deletes a Trend Log Multiple object
+ * @param object_instance - object-instance number of the object
+ * @return true if the object is deleted
+ */
+bool Trend_Log_Multiple_Delete(uint32_t object_instance)
+{
+    bool status = false;
+    struct object_data *pObject = NULL;
+
+    pObject = Keylist_Data_Delete(Object_List, object_instance);
+    if (pObject) {
+        Trend_Log_Multiple_Columns_Close(pObject);
+        free(pObject);
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Deletes all the Trend Log Multiple objects and their data
+ */
+void Trend_Log_Multiple_Cleanup(void)
+{
+    struct object_data *pObject;
+    uint16_t dev_id;
+#ifdef BAC_ROUTING
+    uint16_t current_dev_id = Routed_Device_Object_Index();
+#endif
+
+    for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
+#ifdef BAC_ROUTING
+        Set_Routed_Device_Object_Index(dev_id);
+#endif
+        if (Object_List) {
+            while (Keylist_Count(Object_List) > 0) {
+                pObject = Keylist_Data_Delete_By_Index(Object_List, 0);
+                if (pObject) {
+                    Trend_Log_Multiple_Columns_Close(pObject);
+                    free(pObject);
+                }
+            }
+            Keylist_Delete(Object_List);
+            Object_List = NULL;
+        }
+    }
+#ifdef BAC_ROUTING
+    Set_Routed_Device_Object_Index(current_dev_id);
+#endif
+}
+
+/**
+ * @brief Initializes the Trend Log Multiple object data
+ */
+void Trend_Log_Multiple_Init(void)
+{
+    uint16_t dev_id;
+#ifdef BAC_ROUTING
+    uint16_t current_dev_id = Routed_Device_Object_Index();
+#endif
+
+    for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
+#ifdef BAC_ROUTING
+        Set_Routed_Device_Object_Index(dev_id);
+#endif
+        if (!Object_List) {
+            Object_List = Keylist_Create();
+        }
+    }
+#ifdef BAC_ROUTING
+    Set_Routed_Device_Object_Index(current_dev_id);
+#endif
+}
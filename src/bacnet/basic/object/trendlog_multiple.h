@@ -0,0 +1,177 @@
+/**
+ * @file
+ * @brief API for a basic Trend Log Multiple object implementation.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_TRENDLOG_MULTIPLE_H
+#define BACNET_BASIC_OBJECT_TRENDLOG_MULTIPLE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdevobjpropref.h"
+#include "bacnet/datetime.h"
+#include "bacnet/readrange.h"
+#include "bacnet/rp.h"
+#include "bacnet/wp.h"
+
+/* Buffer_Size of a new Trend Log Multiple, in records */
+#ifndef BACNET_TREND_LOG_MULTIPLE_RECORDS_MAX
+#define BACNET_TREND_LOG_MULTIPLE_RECORDS_MAX 128
+#endif
+/* largest Buffer_Size of a Trend Log Multiple, in records */
+#ifndef BACNET_TREND_LOG_MULTIPLE_BUFFER_SIZE_MAX
+#define BACNET_TREND_LOG_MULTIPLE_BUFFER_SIZE_MAX 65535UL
+#endif
+/* largest size of the Log_DeviceObjectProperty array */
+#ifndef BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX
+#define BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX 32
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Property_Lists(
+    const int32_t **pRequired,
+    const int32_t **pOptional,
+    const int32_t **pProprietary);
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Writable_Property_List(
+    uint32_t object_instance, const int32_t **properties);
+
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Valid_Instance(uint32_t object_instance);
+BACNET_STACK_EXPORT
+unsigned Trend_Log_Multiple_Count(void);
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Index_To_Instance(unsigned index);
+BACNET_STACK_EXPORT
+unsigned Trend_Log_Multiple_Instance_To_Index(uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Object_Name(
+    uint32_t object_instance, BACNET_CHARACTER_STRING *object_name);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Name_Set(
+    uint32_t object_instance, const char *new_name);
+BACNET_STACK_EXPORT
+const char *Trend_Log_Multiple_Name_ASCII(uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+const char *Trend_Log_Multiple_Description(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Description_Set(
+    uint32_t object_instance, const char *new_name);
+
+BACNET_STACK_EXPORT
+int Trend_Log_Multiple_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
+
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Enable(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Enable_Set(uint32_t object_instance, bool enable);
+
+BACNET_STACK_EXPORT
+BACNET_LOGGING_TYPE Trend_Log_Multiple_Logging_Type(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Logging_Type_Set(
+    uint32_t object_instance, BACNET_LOGGING_TYPE logging_type);
+
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Log_Interval(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Log_Interval_Set(
+    uint32_t object_instance, uint32_t seconds);
+
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Align_Intervals(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Align_Intervals_Set(
+    uint32_t object_instance, bool align);
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Interval_Offset(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Interval_Offset_Set(
+    uint32_t object_instance, uint32_t seconds);
+
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Stop_When_Full(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Stop_When_Full_Set(
+    uint32_t object_instance, bool stop_when_full);
+
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Trigger(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Trigger_Set(uint32_t object_instance, bool trigger);
+
+BACNET_STACK_EXPORT
+unsigned Trend_Log_Multiple_Member_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Member_Count_Set(
+    uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Member(
+    uint32_t object_instance,
+    unsigned index,
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *member);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Member_Set(
+    uint32_t object_instance,
+    unsigned index,
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *member);
+
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Buffer_Size(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Buffer_Size_Set(
+    uint32_t object_instance, uint32_t buffer_size);
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Record_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Total_Record_Count(uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Record_Status_Insert(
+    uint32_t object_instance, BACNET_LOG_STATUS log_status, bool state);
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Sample(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Timer(uint32_t object_instance, uint16_t milliseconds);
+
+BACNET_STACK_EXPORT
+int Trend_Log_Multiple_Read_Range_By_Position(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+BACNET_STACK_EXPORT
+int Trend_Log_Multiple_Read_Range_By_Sequence(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+BACNET_STACK_EXPORT
+int Trend_Log_Multiple_Read_Range_By_Time(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+BACNET_STACK_EXPORT
+int Trend_Log_Multiple_Read_Range(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Read_Range_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo);
+
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Create(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Delete(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Cleanup(void);
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Init(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
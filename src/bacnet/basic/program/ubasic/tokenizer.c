@@ -322,7 +322,9 @@ static uint8_t tokenizer_next_token(struct ubasic_tokenizer *tree)
     else {
         /* Check for keywords: */
         for (kt = keywords; kt->keyword != NULL; ++kt) {
-            if (strncmp(tree->ptr, kt->keyword, strlen(kt->keyword)) == 0) {
+            /* most keywords differ in the first character */
+            if ((*tree->ptr == kt->keyword[0]) &&
+                (strncmp(tree->ptr, kt->keyword, strlen(kt->keyword)) == 0)) {
                 tree->nextptr = tree->ptr + strlen(kt->keyword);
                 return kt->token;
             }
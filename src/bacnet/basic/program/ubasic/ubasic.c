@@ -553,6 +553,70 @@ ubasic_get_arrayvarnum(struct ubasic_data *data, uint8_t varnum, uint16_t idx)
 }
 #endif
 
+#if (UBASIC_LABEL_TABLE_SIZE > 0)
+/*---------------------------------------------------------------------------*/
+/**
+ * @brief Find the labels of the program once, in the order that
+ *  jump_label() scans for them, so that the first label of a name wins.
+ *  A label that is not in the table, for example when the table is full,
+ *  is scanned for.
+ * @param data - ubasic data structure
+ */
+static void label_table_build(struct ubasic_data *data)
+{
+    struct ubasic_tokenizer tree = { 0 };
+    struct ubasic_tokenizer after;
+    struct ubasic_label *label;
+    char name[UBASIC_LABEL_LEN_MAX];
+    const char *ptr;
+    uint8_t i;
+
+    data->label_count = 0;
+    data->label_program = data->program_ptr;
+    if (!data->program_ptr) {
+        return;
+    }
+    tokenizer_init(&tree, data->program_ptr);
+    while (tokenizer_token(&tree) != UBASIC_TOKENIZER_ENDOFINPUT) {
+        ptr = tree.ptr;
+        tokenizer_next(&tree);
+        if ((tokenizer_token(&tree) == UBASIC_TOKENIZER_ERROR) ||
+            (tree.ptr == ptr)) {
+            /* no more tokens: any later label is scanned for */
+            return;
+        }
+        if (tokenizer_token(&tree) != UBASIC_TOKENIZER_COLON) {
+            continue;
+        }
+        tokenizer_next(&tree);
+        if (tokenizer_token(&tree) != UBASIC_TOKENIZER_LABEL) {
+            continue;
+        }
+        tokenizer_label(&tree, name, sizeof(name));
+        for (i = 0; i < data->label_count; i++) {
+            if (strcmp(data->labels[i].name, name) == 0) {
+                break;
+            }
+        }
+        if (i < data->label_count) {
+            continue;
+        }
+        if (data->label_count >= UBASIC_LABEL_TABLE_SIZE) {
+            return;
+        }
+        /* where jump_label() leaves the tokenizer */
+        after = tree;
+        tokenizer_next(&after);
+        label = &data->labels[data->label_count];
+        memcpy(label->name, name, sizeof(label->name));
+        label->ptr_offset = (uint16_t)(after.ptr - after.prog);
+        label->nextptr_offset = (uint16_t)(after.nextptr - after.prog);
+        label->token = after.current_token;
+        data->label_count++;
+    }
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 void ubasic_load_program(struct ubasic_data *data, const char *program)
 {
@@ -567,6 +631,9 @@ void ubasic_load_program(struct ubasic_data *data, const char *program)
     if (data->program) {
         data->program_ptr = data->program;
         tokenizer_init(&data->tree, data->program_ptr);
+#if (UBASIC_LABEL_TABLE_SIZE > 0)
+        label_table_build(data);
+#endif
         data->status.bit.isRunning = 1;
     }
 }
@@ -1547,6 +1614,23 @@ static uint8_t jump_label(struct ubasic_data *data, char *label)
 {
     char currLabel[UBASIC_LABEL_LEN_MAX] = { '\0' };
     struct ubasic_tokenizer *tree = &data->tree;
+#if (UBASIC_LABEL_TABLE_SIZE > 0)
+    const struct ubasic_label *entry;
+    uint8_t i;
+
+    if (data->label_program && (data->label_program == data->program_ptr)) {
+        for (i = 0; i < data->label_count; i++) {
+            entry = &data->labels[i];
+            if (strcmp(label, entry->name) == 0) {
+                tree->prog = data->program_ptr;
+                tree->ptr = tree->prog + entry->ptr_offset;
+                tree->nextptr = tree->prog + entry->nextptr_offset;
+                tree->current_token = entry->token;
+                return 1;
+            }
+        }
+    }
+#endif
 
     tokenizer_init(tree, data->program_ptr);
 
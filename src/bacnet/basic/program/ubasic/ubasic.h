@@ -84,6 +84,18 @@ struct ubasic_while_state {
 #define UBASIC_GOSUB_STACK_DEPTH 10
 #endif
 
+#ifndef UBASIC_LABEL_TABLE_SIZE
+#define UBASIC_LABEL_TABLE_SIZE 16
+#endif
+/* a GOTO or GOSUB target, found once when the program is loaded */
+struct ubasic_label {
+    char name[UBASIC_LABEL_LEN_MAX];
+    /* tokenizer state after the label, as offsets into the program */
+    uint16_t ptr_offset;
+    uint16_t nextptr_offset;
+    uint8_t token;
+};
+
 #ifndef UBASIC_IF_THEN_STACK_DEPTH
 #define UBASIC_IF_THEN_STACK_DEPTH 4
 #endif
@@ -135,6 +147,14 @@ struct ubasic_data {
     struct ubasic_while_state while_stack[UBASIC_WHILE_LOOP_STACK_DEPTH];
     uint8_t while_stack_ptr;
 
+#if (UBASIC_LABEL_TABLE_SIZE > 0)
+    /* labels of the loaded program, so that a jump does not scan it */
+    struct ubasic_label labels[UBASIC_LABEL_TABLE_SIZE];
+    uint8_t label_count;
+    /* the program that the labels were found in */
+    const char *label_program;
+#endif
+
     UBASIC_VARIABLE_TYPE variables[UBASIC_VARNUM_MAX];
 
 #if defined(UBASIC_SCRIPT_HAVE_STORE_VARS_IN_FLASH)
@@ -7,6 +7,7 @@
  */
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack core API */
@@ -14,6 +15,7 @@
 #include "bacnet/dcc.h"
 #include "bacnet/iam.h"
 /* BACnet Stack basic services */
+#include "bacnet/basic/sys/journal.h"
 #include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/tsm/tsm.h"
@@ -37,6 +39,8 @@ static struct mstimer BACnet_Object_Timer;
 static unsigned long BACnet_Uptime_Seconds;
 /* packet counter for BACnet task */
 static unsigned long BACnet_Packet_Count;
+/* longest time to wait for a packet when there is nothing else to do */
+static unsigned long BACnet_Receive_Timeout;
 /* local Device ID to track changes */
 static uint32_t Device_ID = 0xFFFFFFFF;
 /* callbacks for custom features in BACnet thread */
@@ -45,6 +49,14 @@ static void *BACnet_Init_Context;
 static bacnet_basic_callback BACnet_Task_Callback;
 static void *BACnet_Task_Context;
 static bacnet_basic_store_callback BACnet_Store_Callback;
+/* journal that keeps the written values over a restart */
+static const BACNET_JOURNAL_STORAGE *BACnet_Journal_Storage;
+static BACNET_JOURNAL BACnet_Journal;
+static bool BACnet_Journal_Replay;
+/* callbacks to exclude other threads that read the objects */
+static bacnet_basic_callback BACnet_Lock_Callback;
+static bacnet_basic_callback BACnet_Unlock_Callback;
+static void *BACnet_Lock_Context;
 
 /**
  * @brief Set the callback for the BACnet initialization
@@ -90,6 +102,42 @@ static void bacnet_task_callback_handler(void)
     }
 }
 
+/**
+ * @brief Set the callbacks that exclude other threads from the stack
+ *  while the BACnet Task handles a message or runs the timers, for
+ *  example worker threads that answer read requests in a port
+ * @param lock [in] The callback function to take the exclusive lock
+ * @param unlock [in] The callback function to release the lock
+ * @param context [in] The context to pass to the callback functions
+ */
+void bacnet_basic_task_lock_callback_set(
+    bacnet_basic_callback lock, bacnet_basic_callback unlock, void *context)
+{
+    BACnet_Lock_Callback = lock;
+    BACnet_Unlock_Callback = unlock;
+    BACnet_Lock_Context = context;
+}
+
+/**
+ * @brief Take the exclusive lock for the BACnet Task
+ */
+static void bacnet_task_lock(void)
+{
+    if (BACnet_Lock_Callback) {
+        BACnet_Lock_Callback(BACnet_Lock_Context);
+    }
+}
+
+/**
+ * @brief Release the exclusive lock for the BACnet Task
+ */
+static void bacnet_task_unlock(void)
+{
+    if (BACnet_Unlock_Callback) {
+        BACnet_Unlock_Callback(BACnet_Lock_Context);
+    }
+}
+
 /**
  * @brief Set the callback for the BACnet WriteProperty Store
  * @param callback [in] The callback function to call after a successful
@@ -117,6 +165,21 @@ static void bacnet_store_callback_handler(
     uint8_t *application_data,
     int application_data_len)
 {
+    BACNET_JOURNAL_RECORD record = { 0 };
+
+    if (BACnet_Journal_Replay) {
+        /* the value is being restored from the journal */
+        return;
+    }
+    if (BACnet_Journal_Storage && (application_data_len >= 0)) {
+        record.object_type = object_type;
+        record.object_instance = object_instance;
+        record.object_property = object_property;
+        record.array_index = array_index;
+        record.application_data = application_data;
+        record.application_data_len = (size_t)application_data_len;
+        (void)bacnet_journal_write(&BACnet_Journal, &record);
+    }
     if (BACnet_Store_Callback) {
         BACnet_Store_Callback(
             object_type, object_instance, object_property, array_index,
@@ -124,6 +187,91 @@ static void bacnet_store_callback_handler(
     }
 }
 
+/**
+ * @brief Set the storage of the journal that keeps the values written
+ *  with WriteProperty over a restart.  The values are replayed into the
+ *  objects by bacnet_basic_init(), after the initialization callback
+ *  has created the objects.
+ * @param storage [in] Two banks of flash, or NULL for no journal.
+ *  The storage must stay valid while the BACnet task runs.
+ */
+void bacnet_basic_journal_storage_set(const BACNET_JOURNAL_STORAGE *storage)
+{
+    BACnet_Journal_Storage = storage;
+}
+
+/**
+ * @brief Program the values that wait in RAM into the journal, such as
+ *  before the device restarts or the power is removed
+ * @return true if there was nothing to program, or it was programmed
+ */
+bool bacnet_basic_journal_flush(void)
+{
+    bool status = true;
+
+    if (BACnet_Journal_Storage) {
+        bacnet_task_lock();
+        status = bacnet_journal_flush(&BACnet_Journal);
+        bacnet_task_unlock();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Write a value from the journal back into its object
+ * @param context [in] not used
+ * @param record [in] the property and its value
+ */
+static void bacnet_basic_journal_restore(
+    void *context, const BACNET_JOURNAL_RECORD *record)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+
+    (void)context;
+    if (record->application_data_len > sizeof(wp_data.application_data)) {
+        return;
+    }
+    wp_data.object_type = record->object_type;
+    wp_data.object_instance = record->object_instance;
+    wp_data.object_property = record->object_property;
+    wp_data.array_index = record->array_index;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    if ((record->object_property == PROP_PRESENT_VALUE) &&
+        !property_list_bacnet_array_member(
+            record->object_type, record->object_property) &&
+        Device_Objects_Property_List_Member(
+            record->object_type, record->object_instance,
+            PROP_PRIORITY_ARRAY)) {
+        /* the priority was stored as the array index */
+        wp_data.priority = (uint8_t)record->array_index;
+        wp_data.array_index = BACNET_ARRAY_ALL;
+    }
+    memcpy(
+        wp_data.application_data, record->application_data,
+        record->application_data_len);
+    wp_data.application_data_len = (int)record->application_data_len;
+    (void)Device_Write_Property(&wp_data);
+}
+
+/**
+ * @brief Open the journal and restore the values that it keeps
+ */
+static void bacnet_basic_journal_init(void)
+{
+    if (!BACnet_Journal_Storage) {
+        return;
+    }
+    if (!bacnet_journal_init(&BACnet_Journal, BACnet_Journal_Storage)) {
+        BACnet_Journal_Storage = NULL;
+        return;
+    }
+    BACnet_Journal_Replay = true;
+    (void)bacnet_journal_replay(
+        &BACnet_Journal, bacnet_basic_journal_restore, NULL);
+    BACnet_Journal_Replay = false;
+}
+
 /**
  * @brief Get the BACnet device uptime in seconds
  * @return The number of seconds the BACnet device has been running
@@ -142,6 +290,53 @@ unsigned long bacnet_basic_packet_count(void)
     return BACnet_Packet_Count;
 }
 
+/**
+ * @brief Set the longest time that the BACnet task waits for a packet.
+ *  The task never waits past the next timer deadline of the stack, so a
+ *  tickless main loop can call it without a delay of its own.
+ * @param milliseconds [in] The longest time to wait, or 0 to not wait
+ */
+void bacnet_basic_task_receive_timeout_set(unsigned long milliseconds)
+{
+    BACnet_Receive_Timeout = milliseconds;
+}
+
+/**
+ * @brief Get the time until a timer expires
+ * @param t [in] The timer
+ * @return milliseconds until the timer expires, or 0 if expired
+ */
+static unsigned long bacnet_basic_timer_remaining(const struct mstimer *t)
+{
+    if (mstimer_expired(t)) {
+        return 0;
+    }
+
+    return mstimer_remaining(t);
+}
+
+/**
+ * @brief Get the time until the BACnet task has timer work to do
+ * @return milliseconds until the next deadline of the BACnet task,
+ *  or 0 if the BACnet task has work to do now
+ */
+unsigned long bacnet_basic_task_deadline(void)
+{
+    unsigned long deadline, remaining;
+
+    if (Device_ID != Device_Object_Instance_Number()) {
+        /* hello, World! */
+        return 0;
+    }
+    deadline = bacnet_basic_timer_remaining(&BACnet_Task_Timer);
+    remaining = bacnet_basic_timer_remaining(&BACnet_Object_Timer);
+    if (remaining < deadline) {
+        deadline = remaining;
+    }
+
+    return deadline;
+}
+
 /**
  * @brief Set the BACnet task device object timer interval
  * @param milliseconds [in] The number of milliseconds for the timer interval
@@ -243,6 +438,8 @@ void bacnet_basic_init(void)
     Device_Init(NULL);
     /* initialize user data in this thread */
     bacnet_init_callback_handler();
+    /* restore the values that were written before the restart */
+    bacnet_basic_journal_init();
 }
 
 /* local buffer for incoming PDUs to process */
@@ -258,7 +455,10 @@ void bacnet_basic_task(void)
     BACNET_ADDRESS src = { 0 };
     uint32_t elapsed_milliseconds = 0;
     uint32_t elapsed_seconds = 0;
+    unsigned long deadline;
+    unsigned timeout;
 
+    bacnet_task_lock();
     /* hello, World! */
     if (Device_ID != Device_Object_Instance_Number()) {
         Device_ID = Device_Object_Instance_Number();
@@ -287,13 +487,29 @@ void bacnet_basic_task(void)
         elapsed_milliseconds = mstimer_elapsed(&BACnet_Object_Timer);
         mstimer_restart(&BACnet_Object_Timer);
         Device_Timer(elapsed_milliseconds);
+        if (BACnet_Journal_Storage) {
+            bacnet_journal_task(&BACnet_Journal, elapsed_milliseconds);
+        }
     }
+    bacnet_task_unlock();
     /* handle the messaging */
-    pdu_len = datalink_receive(&src, &PDUBuffer[0], sizeof(PDUBuffer), 0);
+    timeout = 0;
+    if (BACnet_Receive_Timeout > 0) {
+        /* sleep until there is a packet or the next deadline */
+        deadline = bacnet_basic_task_deadline();
+        if (deadline > BACnet_Receive_Timeout) {
+            deadline = BACnet_Receive_Timeout;
+        }
+        timeout = (unsigned)deadline;
+    }
+    pdu_len =
+        datalink_receive(&src, &PDUBuffer[0], sizeof(PDUBuffer), timeout);
+    bacnet_task_lock();
     if (pdu_len) {
         npdu_handler(&src, &PDUBuffer[0], pdu_len);
         BACnet_Packet_Count++;
     }
     /* call user task in this thread */
     bacnet_task_callback_handler();
+    bacnet_task_unlock();
 }
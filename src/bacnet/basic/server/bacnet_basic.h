@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "bacnet/bacdef.h"
+#include "bacnet/basic/sys/journal.h"
 
 /**
  * @brief Callback function for BACnet initialization and task
@@ -52,9 +53,20 @@ void bacnet_basic_task_callback_set(
     bacnet_basic_callback callback, void *context);
 BACNET_STACK_EXPORT
 void bacnet_basic_task_object_timer_set(unsigned long milliseconds);
+BACNET_STACK_EXPORT
+void bacnet_basic_task_receive_timeout_set(unsigned long milliseconds);
+BACNET_STACK_EXPORT
+unsigned long bacnet_basic_task_deadline(void);
+BACNET_STACK_EXPORT
+void bacnet_basic_task_lock_callback_set(
+    bacnet_basic_callback lock, bacnet_basic_callback unlock, void *context);
 
 BACNET_STACK_EXPORT
 void bacnet_basic_store_callback_set(bacnet_basic_store_callback callback);
+BACNET_STACK_EXPORT
+void bacnet_basic_journal_storage_set(const BACNET_JOURNAL_STORAGE *storage);
+BACNET_STACK_EXPORT
+bool bacnet_basic_journal_flush(void);
 
 BACNET_STACK_EXPORT
 unsigned long bacnet_basic_uptime_seconds(void);
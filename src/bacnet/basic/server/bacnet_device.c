@@ -26,6 +26,7 @@
 #endif
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/keylist.h"
 /* include the device object */
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/object/acc.h"
@@ -242,7 +243,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Device_Writable_Property_List },
+      Device_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #if defined(CONFIG_BACNET_BASIC_OBJECT_NETWORK_PORT)
     { OBJECT_NETWORK_PORT,
       Network_Port_Init,
@@ -264,7 +270,12 @@ static object_functions_t My_Object_Table[] = {
       NULL /* Create */,
       NULL /* Delete */,
       NULL /* Timer */,
-      Network_Port_Writable_Property_List },
+      Network_Port_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_TIMER)
     { OBJECT_TIMER,
@@ -287,7 +298,12 @@ static object_functions_t My_Object_Table[] = {
       Timer_Create,
       Timer_Delete,
       Timer_Task,
-      Timer_Writable_Property_List },
+      Timer_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_ANALOG_INPUT)
     { OBJECT_ANALOG_INPUT,
@@ -310,7 +326,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Input_Create,
       Analog_Input_Delete,
       NULL /* Timer */,
-      Analog_Input_Writable_Property_List },
+      Analog_Input_Writable_Property_List,
+      Analog_Input_Present_Value_Real,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Analog_Input_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_ANALOG_OUTPUT)
     { OBJECT_ANALOG_OUTPUT,
@@ -333,7 +354,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Output_Create,
       Analog_Output_Delete,
       NULL /* Timer */,
-      Analog_Output_Writable_Property_List },
+      Analog_Output_Writable_Property_List,
+      Analog_Output_Present_Value_Real,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Analog_Output_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_ANALOG_VALUE)
     { OBJECT_ANALOG_VALUE,
@@ -356,7 +382,12 @@ static object_functions_t My_Object_Table[] = {
       Analog_Value_Create,
       Analog_Value_Delete,
       NULL /* Timer */,
-      Analog_Value_Writable_Property_List },
+      Analog_Value_Writable_Property_List,
+      Analog_Value_Present_Value_Real,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Analog_Value_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_BINARY_INPUT)
     { OBJECT_BINARY_INPUT,
@@ -379,7 +410,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Input_Create,
       Binary_Input_Delete,
       NULL /* Timer */,
-      Binary_Input_Writable_Property_List },
+      Binary_Input_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      Binary_Input_Present_Value_Enumerated,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Binary_Input_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_BINARY_OUTPUT)
     { OBJECT_BINARY_OUTPUT,
@@ -402,7 +438,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Output_Create,
       Binary_Output_Delete,
       NULL /* Timer */,
-      Binary_Output_Writable_Property_List },
+      Binary_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      Binary_Output_Present_Value_Enumerated,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Binary_Output_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_BINARY_VALUE)
     { OBJECT_BINARY_VALUE,
@@ -425,7 +466,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Value_Create,
       Binary_Value_Delete,
       NULL /* Timer */,
-      Binary_Value_Writable_Property_List },
+      Binary_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      Binary_Value_Present_Value_Enumerated,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      Binary_Value_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_CALENDAR)
     { OBJECT_CALENDAR,
@@ -448,7 +494,12 @@ static object_functions_t My_Object_Table[] = {
       Calendar_Create,
       Calendar_Delete,
       NULL /* Timer */,
-      Calendar_Writable_Property_List },
+      Calendar_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      Calendar_Present_Value_Boolean,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_BITSTRING_VALUE)
     { OBJECT_BITSTRING_VALUE,
@@ -471,7 +522,12 @@ static object_functions_t My_Object_Table[] = {
       BitString_Value_Create,
       BitString_Value_Delete,
       NULL /* Timer */,
-      BitString_Value_Writable_Property_List },
+      BitString_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_CHARACTERSTRING_VALUE)
     { OBJECT_CHARACTERSTRING_VALUE,
@@ -494,7 +550,12 @@ static object_functions_t My_Object_Table[] = {
       CharacterString_Value_Create,
       CharacterString_Value_Delete,
       NULL /* Timer */,
-      CharacterString_Value_Writable_Property_List },
+      CharacterString_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_OCTET_STRING_VALUE)
     { OBJECT_OCTETSTRING_VALUE,
@@ -517,7 +578,12 @@ static object_functions_t My_Object_Table[] = {
       OctetString_Value_Create,
       OctetString_Value_Delete,
       NULL /* Timer */,
-      OctetString_Value_Writable_Property_List },
+      OctetString_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_POSITIVE_INTEGER_VALUE)
     { OBJECT_POSITIVE_INTEGER_VALUE,
@@ -540,7 +606,12 @@ static object_functions_t My_Object_Table[] = {
       PositiveInteger_Value_Create,
       PositiveInteger_Value_Delete,
       NULL /* Timer */,
-      PositiveInteger_Value_Writable_Property_List },
+      PositiveInteger_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_TIME_VALUE)
     { OBJECT_TIME_VALUE,
@@ -563,7 +634,12 @@ static object_functions_t My_Object_Table[] = {
       Time_Value_Create,
       Time_Value_Delete,
       NULL /* Timer */,
-      Time_Value_Writable_Property_List },
+      Time_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_INTEGER_VALUE)
     { OBJECT_INTEGER_VALUE,
@@ -586,7 +662,12 @@ static object_functions_t My_Object_Table[] = {
       Integer_Value_Create,
       Integer_Value_Delete,
       NULL /* Timer */,
-      Integer_Value_Writable_Property_List },
+      Integer_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_LIFE_SAFETY_POINT)
     { OBJECT_LIFE_SAFETY_POINT,
@@ -609,7 +690,12 @@ static object_functions_t My_Object_Table[] = {
       Life_Safety_Point_Create,
       Life_Safety_Point_Delete,
       NULL /* Timer */,
-      Life_Safety_Point_Writable_Property_List },
+      Life_Safety_Point_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_LIFE_SAFETY_ZONE)
     { OBJECT_LIFE_SAFETY_ZONE,
@@ -632,7 +718,12 @@ static object_functions_t My_Object_Table[] = {
       Life_Safety_Zone_Create,
       Life_Safety_Zone_Delete,
       NULL /* Timer */,
-      Life_Safety_Zone_Writable_Property_List },
+      Life_Safety_Zone_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 
 #if defined(CONFIG_BACNET_BASIC_OBJECT_LOAD_CONTROL)
@@ -656,7 +747,12 @@ static object_functions_t My_Object_Table[] = {
       Load_Control_Create,
       Load_Control_Delete,
       Load_Control_Timer,
-      Load_Control_Writable_Property_List },
+      Load_Control_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_MULTISTATE_INPUT)
     { OBJECT_MULTI_STATE_INPUT,
@@ -679,7 +775,12 @@ static object_functions_t My_Object_Table[] = {
       Multistate_Input_Create,
       Multistate_Input_Delete,
       NULL /* Timer */,
-      Multistate_Input_Writable_Property_List },
+      Multistate_Input_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      Multistate_Input_Present_Value_Unsigned,
+      NULL /* Present_Value_Boolean */,
+      Multistate_Input_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_MULTISTATE_OUTPUT)
     { OBJECT_MULTI_STATE_OUTPUT,
@@ -702,7 +803,12 @@ static object_functions_t My_Object_Table[] = {
       Multistate_Output_Create,
       Multistate_Output_Delete,
       NULL /* Timer */,
-      Multistate_Output_Writable_Property_List },
+      Multistate_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      Multistate_Output_Present_Value_Unsigned,
+      NULL /* Present_Value_Boolean */,
+      Multistate_Output_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_MULTISTATE_VALUE)
     { OBJECT_MULTI_STATE_VALUE,
@@ -725,7 +831,12 @@ static object_functions_t My_Object_Table[] = {
       Multistate_Value_Create,
       Multistate_Value_Delete,
       NULL /* Timer */,
-      Multistate_Value_Writable_Property_List },
+      Multistate_Value_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      Multistate_Value_Present_Value_Unsigned,
+      NULL /* Present_Value_Boolean */,
+      Multistate_Value_Status_Flags },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_LIGHTING_OUTPUT)
     { OBJECT_LIGHTING_OUTPUT,
@@ -748,7 +859,12 @@ static object_functions_t My_Object_Table[] = {
       Lighting_Output_Create,
       Lighting_Output_Delete,
       Lighting_Output_Timer,
-      Lighting_Output_Writable_Property_List },
+      Lighting_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_CHANNEL)
     { OBJECT_CHANNEL,
@@ -771,7 +887,12 @@ static object_functions_t My_Object_Table[] = {
       Channel_Create,
       Channel_Delete,
       NULL /* Timer */,
-      Channel_Writable_Property_List },
+      Channel_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_BINARY_LIGHTING_OUTPUT)
     { OBJECT_BINARY_LIGHTING_OUTPUT,
@@ -794,7 +915,12 @@ static object_functions_t My_Object_Table[] = {
       Binary_Lighting_Output_Create,
       Binary_Lighting_Output_Delete,
       Binary_Lighting_Output_Timer,
-      Binary_Lighting_Output_Writable_Property_List },
+      Binary_Lighting_Output_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_COLOR)
     { OBJECT_COLOR,
@@ -817,7 +943,12 @@ static object_functions_t My_Object_Table[] = {
       Color_Create,
       Color_Delete,
       Color_Timer,
-      Color_Writable_Property_List },
+      Color_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_COLOR_TEMPERATURE)
     { OBJECT_COLOR_TEMPERATURE,
@@ -840,7 +971,12 @@ static object_functions_t My_Object_Table[] = {
       Color_Temperature_Create,
       Color_Temperature_Delete,
       Color_Temperature_Timer,
-      Color_Temperature_Writable_Property_List },
+      Color_Temperature_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_FILE)
     { OBJECT_FILE,
@@ -863,7 +999,12 @@ static object_functions_t My_Object_Table[] = {
       bacfile_create,
       bacfile_delete,
       NULL /* Timer */,
-      BACfile_Writable_Property_List },
+      BACfile_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_STRUCTURED_VIEW)
     { OBJECT_STRUCTURED_VIEW,
@@ -886,7 +1027,12 @@ static object_functions_t My_Object_Table[] = {
       Structured_View_Create,
       Structured_View_Delete,
       NULL /* Timer */,
-      NULL /* Writable_Property_List */ },
+      NULL /* Writable_Property_List */,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_LOOP)
     { OBJECT_LOOP,
@@ -909,7 +1055,12 @@ static object_functions_t My_Object_Table[] = {
       Loop_Create,
       Loop_Delete,
       Loop_Timer,
-      Loop_Writable_Property_List },
+      Loop_Writable_Property_List,
+      Loop_Present_Value_Real,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_PROGRAM)
     { OBJECT_PROGRAM,
@@ -932,7 +1083,12 @@ static object_functions_t My_Object_Table[] = {
       Program_Create,
       Program_Delete,
       Program_Timer,
-      Program_Writable_Property_List },
+      Program_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
 #if defined(CONFIG_BACNET_BASIC_OBJECT_AUDIT_LOG)
     { OBJECT_AUDIT_LOG,
@@ -955,7 +1111,12 @@ static object_functions_t My_Object_Table[] = {
       Audit_Log_Create,
       Audit_Log_Delete,
       NULL /* Timer */,
-      Audit_Log_Writable_Property_List },
+      Audit_Log_Writable_Property_List,
+      NULL /* Present_Value_Real */,
+      NULL /* Present_Value_Enumerated */,
+      NULL /* Present_Value_Unsigned */,
+      NULL /* Present_Value_Boolean */,
+      NULL /* Status_Flags */ },
 #endif
     {
         MAX_BACNET_OBJECT_TYPE,
@@ -978,7 +1139,12 @@ static object_functions_t My_Object_Table[] = {
         NULL /* Create */,
         NULL /* Delete */,
         NULL /* Timer */,
-        NULL /* Writable_Property_List */
+        NULL /* Writable_Property_List */,
+        NULL /* Present_Value_Real */,
+        NULL /* Present_Value_Enumerated */,
+        NULL /* Present_Value_Unsigned */,
+        NULL /* Present_Value_Boolean */,
+        NULL /* Status_Flags */
     }
 };
 
@@ -1361,6 +1527,8 @@ static const char *Firmware_Revision = BACNET_VERSION_TEXT;
 static const char *Device_Location_Default = BACNET_DEVICE_LOCATION_NAME;
 static const char *Device_Description_Default = BACNET_DEVICE_DESCRIPTION;
 static uint32_t Database_Revision;
+/* counts the writes, and the created and deleted objects */
+static uint32_t Property_Changes;
 static BACNET_REINITIALIZED_STATE Reinitialize_State = BACNET_REINIT_IDLE;
 static BACNET_CHARACTER_STRING Reinit_Password;
 static write_property_function Device_Write_Property_Store_Callback;
@@ -1377,6 +1545,15 @@ static BACNET_DATE Local_Date; /* rely on OS, if there is one */
    BACnet UTC offset is expressed in minutes. */
 static int16_t UTC_Offset = 5 * 60;
 static bool Daylight_Savings_Status = false; /* rely on OS */
+/* Once Device_Timer() runs, the clock is read from the OS once per period,
+   and the Local_Date and Local_Time are moved along by the timer between
+   the reads, so that timestamps do not each cost a timezone calculation */
+#ifndef BACNET_DEVICE_LOCAL_TIME_REFRESH_MS
+#define BACNET_DEVICE_LOCAL_TIME_REFRESH_MS 1000
+#endif
+static bool Local_Time_Cached;
+static BACNET_DATE_TIME Local_Time_Refreshed;
+static uint16_t Local_Time_Elapsed_Milliseconds;
 #if defined(BACNET_TIME_MASTER)
 static bool Align_Intervals;
 static uint32_t Interval_Minutes;
@@ -1995,6 +2172,18 @@ void Device_Set_Database_Revision(uint32_t revision)
 void Device_Inc_Database_Revision(void)
 {
     Database_Revision++;
+    Property_Changes++;
+}
+
+/**
+ * @brief Get the count of the changes that make cached responses stale
+ * @details The count changes with every WriteProperty, and with every
+ *  change of the Database_Revision, such as a CreateObject.
+ * @return the count of changes
+ */
+uint32_t Device_Property_Cache_Changes(void)
+{
+    return Property_Changes;
 }
 
 /** Get the total count of objects supported by this Device Object.
@@ -2185,10 +2374,58 @@ bool Device_Object_Name_Copy(
     return found;
 }
 
-static void Update_Current_Time(void)
+/**
+ * @brief Read the clock from the OS into the Local_Date and Local_Time
+ */
+static void Device_Local_Time_Read(void)
 {
     datetime_local(
         &Local_Date, &Local_Time, &UTC_Offset, &Daylight_Savings_Status);
+    Local_Time_Refreshed.date = Local_Date;
+    Local_Time_Refreshed.time = Local_Time;
+    Local_Time_Elapsed_Milliseconds = 0;
+}
+
+/**
+ * @brief Read the clock from the OS now, instead of at the end of the
+ *  refresh period, such as after the clock was set by a TimeSynchronization
+ */
+void Device_Local_Time_Refresh(void)
+{
+    Device_Local_Time_Read();
+}
+
+/**
+ * @brief Move the cached clock along by the elapsed time, and read the
+ *  clock from the OS at the end of each refresh period
+ * @param milliseconds - number of milliseconds elapsed
+ */
+static void Device_Local_Time_Timer(uint16_t milliseconds)
+{
+    BACNET_DATE_TIME bdatetime;
+    uint32_t elapsed;
+
+    elapsed = (uint32_t)Local_Time_Elapsed_Milliseconds + milliseconds;
+    if (!Local_Time_Cached ||
+        (elapsed >= BACNET_DEVICE_LOCAL_TIME_REFRESH_MS)) {
+        Device_Local_Time_Read();
+        Local_Time_Cached = true;
+    } else if (milliseconds) {
+        /* from the last read, so that the remainders of the hundredths
+           of the short ticks are not lost */
+        Local_Time_Elapsed_Milliseconds = (uint16_t)elapsed;
+        bdatetime = Local_Time_Refreshed;
+        datetime_add_milliseconds(&bdatetime, (int32_t)elapsed);
+        Local_Date = bdatetime.date;
+        Local_Time = bdatetime.time;
+    }
+}
+
+static void Update_Current_Time(void)
+{
+    if (!Local_Time_Cached) {
+        Device_Local_Time_Read();
+    }
 }
 
 void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
@@ -2687,13 +2924,8 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
         case PROP_PROTOCOL_SERVICES_SUPPORTED:
             /* Note: list of services that are executed, not initiated. */
-            bitstring_init(&bit_string);
-            for (i = 0; i < MAX_BACNET_SERVICES_SUPPORTED; i++) {
-                /* automatic lookup based on handlers set */
-                bitstring_set_bit(
-                    &bit_string, (uint8_t)i,
-                    apdu_service_supported((BACNET_SERVICES_SUPPORTED)i));
-            }
+            /* automatic lookup based on handlers set */
+            apdu_services_supported(&bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_PROTOCOL_OBJECT_TYPES_SUPPORTED:
@@ -3365,6 +3597,7 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     }
                 }
                 if (status) {
+                    Property_Changes++;
                     Device_Write_Property_Store(wp_data);
                 }
             } else {
@@ -3563,6 +3796,142 @@ void Device_COV_Clear(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
     }
 }
 
+/**
+ * @brief Reads the REAL Present_Value of a local object, without the
+ *  encoding and decoding of a ReadProperty
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param value - [out] the Present_Value
+ * @return true if the object type has a REAL Present_Value, and the
+ *  object instance is valid
+ */
+bool Device_Present_Value_Real(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, float *value)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject && pObject->Object_Present_Value_Real) {
+        return pObject->Object_Present_Value_Real(object_instance, value);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Gets the function that reads the REAL Present_Value of an
+ *  object type, for a caller that reads the same object repeatedly
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @return the read function, or NULL if the object type has none
+ */
+object_present_value_real_function
+Device_Present_Value_Real_Function(BACNET_OBJECT_TYPE object_type)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject) {
+        return pObject->Object_Present_Value_Real;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Reads the ENUMERATED Present_Value of a local object
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param value - [out] the Present_Value
+ * @return true if the object type has an ENUMERATED Present_Value, and
+ *  the object instance is valid
+ */
+bool Device_Present_Value_Enumerated(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, uint32_t *value)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject && pObject->Object_Present_Value_Enumerated) {
+        return pObject->Object_Present_Value_Enumerated(
+            object_instance, value);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Reads the Unsigned Present_Value of a local object
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param value - [out] the Present_Value
+ * @return true if the object type has an Unsigned Present_Value, and
+ *  the object instance is valid
+ */
+bool Device_Present_Value_Unsigned(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_UNSIGNED_INTEGER *value)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject && pObject->Object_Present_Value_Unsigned) {
+        return pObject->Object_Present_Value_Unsigned(object_instance, value);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Reads the BOOLEAN Present_Value of a local object
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param value - [out] the Present_Value
+ * @return true if the object type has a BOOLEAN Present_Value, and
+ *  the object instance is valid
+ */
+bool Device_Present_Value_Boolean(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool *value)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject && pObject->Object_Present_Value_Boolean) {
+        return pObject->Object_Present_Value_Boolean(object_instance, value);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Reads the Status_Flags of a local object
+ * @ingroup ObjHelpers
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ * @param status_flags - [out] the Status_Flags
+ * @return true if the object type has a Status_Flags reader, and
+ *  the object instance is valid
+ */
+bool Device_Status_Flags(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_BIT_STRING *status_flags)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Object_Functions_Find(object_type);
+    if (pObject && pObject->Object_Status_Flags) {
+        return pObject->Object_Status_Flags(object_instance, status_flags);
+    }
+
+    return false;
+}
+
 /**
  * @brief Creates a child object, if supported
  * @ingroup ObjHelpers
@@ -3798,29 +4167,136 @@ void Device_End_Restore(void)
 }
 
 #if defined(INTRINSIC_REPORTING)
+/* Change driven intrinsic reporting: the object types that report their
+   changes with Device_Intrinsic_Reporting_Changed() are only evaluated
+   when a value or limit changed, or while a transition is pending,
+   instead of evaluating every object on each cycle. */
+static bool Intrinsic_Reporting_Change_Type[MAX_BACNET_OBJECT_TYPE];
+/* objects to evaluate on the next cycle, by object key, and the objects
+   that are evaluated on this cycle */
+static OS_Keylist Intrinsic_Reporting_Changed;
+static OS_Keylist Intrinsic_Reporting_Evaluate;
+
+/**
+ * @brief Set whether the objects of a type report their changes with
+ *  Device_Intrinsic_Reporting_Changed(), so that they are only evaluated
+ *  after a change instead of on every cycle
+ * @param object_type - object type that reports its changes
+ * @param enable - true if the objects of the type report their changes
+ */
+void Device_Intrinsic_Reporting_Change_Driven_Set(
+    BACNET_OBJECT_TYPE object_type, bool enable)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        Intrinsic_Reporting_Change_Type[object_type] = enable;
+    }
+}
+
+/**
+ * @brief Determine if the objects of a type report their changes with
+ *  Device_Intrinsic_Reporting_Changed()
+ * @param object_type - object type
+ * @return true if the objects of the type are only evaluated after a change
+ */
+bool Device_Intrinsic_Reporting_Change_Driven(BACNET_OBJECT_TYPE object_type)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        return Intrinsic_Reporting_Change_Type[object_type];
+    }
+
+    return false;
+}
+
+/**
+ * @brief Report that the event state of an object needs to be evaluated,
+ *  because its value, status, limits or event properties changed, or a
+ *  transition is waiting for its time delay
+ * @param object_type - object type of the object
+ * @param object_instance - object instance of the object
+ */
+void Device_Intrinsic_Reporting_Changed(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    KEY key;
+
+    if (!Device_Intrinsic_Reporting_Change_Driven(object_type)) {
+        return;
+    }
+    if (!Intrinsic_Reporting_Changed) {
+        Intrinsic_Reporting_Changed = Keylist_Create();
+    }
+    key = KEY_ENCODE(object_type, object_instance);
+    if (Keylist_Index(Intrinsic_Reporting_Changed, key) < 0) {
+        (void)Keylist_Data_Add(Intrinsic_Reporting_Changed, key, NULL);
+    }
+}
+
+/**
+ * @brief Get the number of objects that wait to be evaluated
+ * @return number of objects that reported a change
+ */
+unsigned Device_Intrinsic_Reporting_Changed_Count(void)
+{
+    int count;
+
+    count = Keylist_Count(Intrinsic_Reporting_Changed);
+    if (count < 0) {
+        count = 0;
+    }
+
+    return (unsigned)count;
+}
+
+/**
+ * @brief Evaluate the intrinsic reporting of every object of the polled
+ *  types, and only of the objects that reported a change of the change
+ *  driven types
+ */
 void Device_local_reporting(void)
 {
     struct object_functions *pObject = NULL;
-    uint32_t objects_count = 0;
+    OS_Keylist list;
     uint32_t object_instance = 0;
     BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
-    uint32_t idx = 0;
+    KEY key;
+    unsigned count, index;
+    int i;
 
-    objects_count = Device_Object_List_Count();
-
-    /* loop for all objects */
-    for (idx = 1; idx <= objects_count; idx++) {
-        Device_Object_List_Identifier(idx, &object_type, &object_instance);
-
-        pObject = Device_Object_Functions_Find(object_type);
-        if (pObject != NULL) {
-            if (pObject->Object_Valid_Instance &&
-                pObject->Object_Valid_Instance(object_instance)) {
-                if (pObject->Object_Intrinsic_Reporting) {
-                    pObject->Object_Intrinsic_Reporting(object_instance);
-                }
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if (pObject->Object_Intrinsic_Reporting && pObject->Object_Count &&
+            pObject->Object_Index_To_Instance &&
+            !Device_Intrinsic_Reporting_Change_Driven(pObject->Object_Type)) {
+            count = pObject->Object_Count();
+            for (index = 0; index < count; index++) {
+                object_instance = pObject->Object_Index_To_Instance(index);
+                pObject->Object_Intrinsic_Reporting(object_instance);
             }
         }
+        pObject++;
+    }
+    /* the objects that change while they are evaluated, or that wait for
+       a time delay, report again and are evaluated on the next cycle */
+    list = Intrinsic_Reporting_Changed;
+    Intrinsic_Reporting_Changed = Intrinsic_Reporting_Evaluate;
+    Intrinsic_Reporting_Evaluate = list;
+    count = (unsigned)Keylist_Count(list);
+    for (index = 0; index < count; index++) {
+        if (!Keylist_Index_Key(list, (int)index, &key)) {
+            break;
+        }
+        object_type = (BACNET_OBJECT_TYPE)KEY_DECODE_TYPE(key);
+        object_instance = (uint32_t)KEY_DECODE_ID(key);
+        pObject = Device_Object_Functions_Find(object_type);
+        if (pObject && pObject->Object_Intrinsic_Reporting &&
+            pObject->Object_Valid_Instance &&
+            pObject->Object_Valid_Instance(object_instance)) {
+            pObject->Object_Intrinsic_Reporting(object_instance);
+        }
+    }
+    /* empty the list from the end, which does not move the other keys */
+    for (i = Keylist_Count(list) - 1; i >= 0; i--) {
+        (void)Keylist_Data_Delete_By_Index(list, i);
     }
 }
 #endif
@@ -3854,6 +4330,29 @@ struct object_functions *Device_Object_Functions(void)
     return Object_Table;
 }
 
+#ifdef CONFIG_BACNET_BASIC_OBJECT_LOOP
+/**
+ * @brief Bind a Loop variable reference to the REAL Present_Value of an
+ *  object, so that the Loop need not use ReadProperty for it
+ * @param object_type - object type of the reference
+ * @param object_property - property of the reference
+ * @param array_index - array index of the reference
+ * @return the read function, or NULL to use ReadProperty
+ */
+static loop_read_real_function Device_Loop_Read_Real_Bind(
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    if ((object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL)) {
+        return NULL;
+    }
+
+    return Device_Present_Value_Real_Function(object_type);
+}
+#endif
+
 /** Initialize the Device Object.
  Initialize the group of object helper functions for any supported Object.
  Initialize each of the Device Object child Object instances.
@@ -3894,6 +4393,7 @@ void Device_Init(object_functions_t *object_table)
     /* link ReadProperty and WriteProperty to Loop object for references */
     Loop_Read_Property_Internal_Callback_Set(Device_Read_Property);
     Loop_Write_Property_Internal_Callback_Set(Device_Write_Property);
+    Loop_Read_Real_Bind_Callback_Set(Device_Loop_Read_Real_Bind);
 #endif
 #ifdef CONFIG_BACNET_BASIC_OBJECT_TIMER
     /* link WriteProperty to Timer object for references */
@@ -3964,6 +4464,7 @@ void Device_Timer(uint16_t milliseconds)
     uint32_t instance;
 
     Device_Backup_Failure_Timeout_Countdown(milliseconds);
+    Device_Local_Time_Timer(milliseconds);
     pObject = Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         count = 0;
@@ -28,6 +28,20 @@ static uint16_t Timer_Seconds;
  */
 void bacnet_port_mstp_task(uint16_t elapsed_seconds)
 {
+    uint32_t instance = Network_Port_Index_To_Instance(0);
+
+    /* show the values chosen by the adaptive tuning, unless a client
+       wrote changes that are pending */
+    if (dlmstp_adaptive_enabled() && !Network_Port_Changes_Pending(instance)) {
+        if ((Network_Port_MSTP_Max_Info_Frames(instance) !=
+             dlmstp_max_info_frames()) ||
+            (Network_Port_MSTP_Max_Master(instance) != dlmstp_max_master())) {
+            Network_Port_MSTP_Max_Info_Frames_Set(
+                instance, dlmstp_max_info_frames());
+            Network_Port_MSTP_Max_Master_Set(instance, dlmstp_max_master());
+            Network_Port_Changes_Pending_Set(instance, false);
+        }
+    }
     Timer_Seconds += elapsed_seconds;
     if (Timer_Seconds >= 60) {
         Timer_Seconds = 0;
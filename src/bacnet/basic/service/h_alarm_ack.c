@@ -69,7 +69,7 @@ void handler_alarm_ack(
     int ack_result = 0;
     BACNET_ADDRESS my_address;
     BACNET_NPDU_DATA npdu_data;
-    BACNET_ALARM_ACK_DATA data;
+    BACNET_ALARM_ACK_DATA *data;
     BACNET_ERROR_CODE error_code;
     BACNET_ERROR_CLASS error_class;
 
@@ -78,6 +78,14 @@ void handler_alarm_ack(
     npdu_encode_npdu_data(&npdu_data, false, service_data->priority);
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    data = apdu_scratch_alloc(sizeof(BACNET_ALARM_ACK_DATA));
+    if (!data) {
+        len = abort_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
+            ABORT_REASON_OUT_OF_RESOURCES, true);
+        debug_print("Alarm Ack: Out of scratch memory. Sending Abort!\n");
+        goto AA_ABORT;
+    }
     if (service_len == 0) {
         len = reject_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
@@ -93,7 +101,7 @@ void handler_alarm_ack(
         goto AA_ABORT;
     }
 
-    len = alarm_ack_decode_service_request(service_request, service_len, &data);
+    len = alarm_ack_decode_service_request(service_request, service_len, data);
     if (len <= 0) {
         debug_print("Alarm Ack: Unable to decode Request!\n");
     }
@@ -109,19 +117,19 @@ void handler_alarm_ack(
         stderr,
         "Alarm Ack Operation: Received acknowledge for object id (%d, %lu) "
         "from %s for process id %lu \n",
-        data.eventObjectIdentifier.type,
-        (unsigned long)data.eventObjectIdentifier.instance,
-        data.ackSource.value, (unsigned long)data.ackProcessIdentifier);
+        data->eventObjectIdentifier.type,
+        (unsigned long)data->eventObjectIdentifier.instance,
+        data->ackSource.value, (unsigned long)data->ackProcessIdentifier);
     if (!Device_Valid_Object_Id(
-            data.eventObjectIdentifier.type,
-            data.eventObjectIdentifier.instance)) {
+            data->eventObjectIdentifier.type,
+            data->eventObjectIdentifier.instance)) {
         len = bacerror_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
             SERVICE_CONFIRMED_ACKNOWLEDGE_ALARM, ERROR_CLASS_OBJECT,
             ERROR_CODE_UNKNOWN_OBJECT);
-    } else if (Alarm_Ack[data.eventObjectIdentifier.type]) {
+    } else if (Alarm_Ack[data->eventObjectIdentifier.type]) {
         ack_result =
-            Alarm_Ack[data.eventObjectIdentifier.type](&data, &error_code);
+            Alarm_Ack[data->eventObjectIdentifier.type](data, &error_code);
         switch (ack_result) {
             case 1:
                 len = encode_simple_ack(
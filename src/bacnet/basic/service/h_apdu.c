@@ -18,6 +18,9 @@
 #include "bacnet/iam.h"
 /* basic objects, services, TSM */
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/sys/arena.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 
@@ -25,6 +28,14 @@
 static uint16_t Timeout_Milliseconds = 3000;
 /* Number of APDU Retries */
 static uint8_t Number_Of_Retries = 3;
+/* memory that the service handlers take their large request data from */
+static uint8_t Scratch_Buffer[BACNET_APDU_SCRATCH_SIZE];
+static ARENA_TYPE Scratch_Arena =
+    ARENA_INITIALIZER(Scratch_Buffer, sizeof(Scratch_Buffer));
+#if BACNET_SEGMENTATION_ENABLED
+/* APDU Segment Timeout in Milliseconds */
+static uint16_t Segment_Timeout_Milliseconds = 2000;
+#endif
 static uint8_t Local_Network_Priority; /* Fixing test 10.1.2 Network priority */
 
 /* a simple table for crossing the services supported */
@@ -107,6 +118,9 @@ static BACNET_SERVICES_SUPPORTED
 /* Confirmed Function Handlers */
 /* If they are not set, they are handled by a reject message */
 static confirmed_function Confirmed_Function[MAX_BACNET_CONFIRMED_SERVICE];
+/* the services supported by the handlers that are set, updated as each
+   handler is set so that Protocol_Services_Supported is a copy */
+static BACNET_BIT_STRING Services_Supported;
 
 /**
  * @brief Set a handler function for the given confirmed service.
@@ -119,6 +133,10 @@ void apdu_set_confirmed_handler(
 {
     if (service_choice < MAX_BACNET_CONFIRMED_SERVICE) {
         Confirmed_Function[service_choice] = pFunction;
+        bitstring_set_bit(
+            &Services_Supported,
+            (uint8_t)confirmed_service_supported[service_choice],
+            pFunction != NULL);
     }
 }
 
@@ -152,6 +170,10 @@ void apdu_set_unconfirmed_handler(
 {
     if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
         Unconfirmed_Function[service_choice] = pFunction;
+        bitstring_set_bit(
+            &Services_Supported,
+            (uint8_t)unconfirmed_service_supported[service_choice],
+            pFunction != NULL);
     }
 }
 
@@ -164,6 +186,7 @@ void apdu_set_unconfirmed_handler(
  */
 bool apdu_service_supported(BACNET_SERVICES_SUPPORTED service_supported)
 {
+#ifdef BAC_ROUTING
     int i = 0;
     bool status = false;
     bool found = false;
@@ -203,6 +226,36 @@ bool apdu_service_supported(BACNET_SERVICES_SUPPORTED service_supported)
         }
     }
     return status;
+#else
+    if (service_supported >= MAX_BACNET_SERVICES_SUPPORTED) {
+        return false;
+    }
+
+    return bitstring_bit(&Services_Supported, (uint8_t)service_supported);
+#endif
+}
+
+/**
+ * @brief Get the services that are supported by the handlers that are set,
+ *  as the Protocol_Services_Supported bit string
+ * @param bit_string [out] the services supported
+ */
+void apdu_services_supported(BACNET_BIT_STRING *bit_string)
+{
+#ifdef BAC_ROUTING
+    unsigned i;
+
+    /* the current Device may not approve all of the services */
+    bitstring_init(bit_string);
+    for (i = 0; i < MAX_BACNET_SERVICES_SUPPORTED; i++) {
+        bitstring_set_bit(
+            bit_string, (uint8_t)i,
+            apdu_service_supported((BACNET_SERVICES_SUPPORTED)i));
+    }
+#else
+    (void)bitstring_copy(bit_string, &Services_Supported);
+#endif
+    (void)bitstring_bits_used_set(bit_string, MAX_BACNET_SERVICES_SUPPORTED);
 }
 
 /** Function to translate a SERVICE_SUPPORTED_ enum to its SERVICE_CONFIRMED_
@@ -492,6 +545,65 @@ void apdu_retries_set(uint8_t value)
     Number_Of_Retries = value;
 }
 
+/**
+ * @brief Give the service handlers other memory to take their large
+ *  request data from, such as a buffer sized for the largest request
+ *  of the application, or go back to the built-in scratch memory
+ * @param buffer - memory for the handlers, or NULL for the built-in
+ *  scratch memory of BACNET_APDU_SCRATCH_SIZE octets
+ * @param size - number of octets in the buffer
+ */
+void apdu_scratch_set(uint8_t *buffer, size_t size)
+{
+    if (buffer) {
+        Arena_Init(&Scratch_Arena, buffer, size);
+    } else {
+        Arena_Init(&Scratch_Arena, Scratch_Buffer, sizeof(Scratch_Buffer));
+    }
+}
+
+/**
+ * @brief Get the scratch memory of the service handlers, for example
+ *  to size it with the Arena_Peak() of the requests of the application
+ * @return the scratch memory arena
+ */
+OS_Arena apdu_scratch(void)
+{
+    return &Scratch_Arena;
+}
+
+/**
+ * @brief Take memory for the request that is being processed from the
+ *  scratch memory, instead of the stack. The memory is cleared, and is
+ *  taken back after the service handler returns to apdu_handler().
+ * @param size - number of octets
+ * @return the memory, or NULL if there is not enough scratch memory
+ */
+void *apdu_scratch_alloc(size_t size)
+{
+    return Arena_Alloc(&Scratch_Arena, size);
+}
+
+#if BACNET_SEGMENTATION_ENABLED
+/**
+ * @brief Get the time to wait for a segment or a SegmentACK
+ * @return APDU Segment Timeout in milliseconds
+ */
+uint16_t apdu_segment_timeout(void)
+{
+    return Segment_Timeout_Milliseconds;
+}
+
+/**
+ * @brief Set the time to wait for a segment or a SegmentACK
+ * @param milliseconds - APDU Segment Timeout in milliseconds
+ */
+void apdu_segment_timeout_set(uint16_t milliseconds)
+{
+    Segment_Timeout_Milliseconds = milliseconds;
+}
+#endif
+
 /* When network communications are completely disabled,
    only DeviceCommunicationControl and ReinitializeDevice APDUs
    shall be processed and no messages shall be initiated.
@@ -572,14 +684,23 @@ void apdu_handler(
     uint8_t *service_request = NULL;
     uint16_t service_request_len = 0;
     int len = 0; /* counts where we are in PDU */
-#if !BACNET_SVC_SERVER
+#if !BACNET_SVC_SERVER || BACNET_SEGMENTATION_ENABLED
     uint8_t invoke_id = 0;
+    bool server = false;
+#endif
+#if !BACNET_SVC_SERVER
+    uint8_t reason = 0;
     BACNET_CONFIRMED_SERVICE_ACK_DATA service_ack_data = { 0 };
     BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
     BACNET_ERROR_CLASS error_class = ERROR_CLASS_SERVICES;
-    uint8_t reason = 0;
-    bool server = false;
 #endif
+#if BACNET_SEGMENTATION_ENABLED
+    bool segmented = false;
+#endif
+#if BACNET_PERFSTAT_ENABLED
+    uint32_t start = perfstat_clock();
+#endif
+    size_t scratch_mark;
 
     if (!apdu) {
         return;
@@ -587,7 +708,9 @@ void apdu_handler(
     if (apdu_len == 0) {
         return;
     }
+    scratch_mark = Arena_Mark(&Scratch_Arena);
     pdu_type = apdu[0] & 0xF0;
+    BACTRACE_APDU_BEGIN(pdu_type, apdu_len);
     switch (pdu_type) {
         case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
             len = apdu_decode_confirmed_service_request(
@@ -595,6 +718,7 @@ void apdu_handler(
                 &service_request, &service_request_len);
             if (len == 0) {
                 /* service data unable to be decoded - simply drop */
+                PERFSTAT_COUNT(PERFSTAT_DECODE_ERRORS);
                 break;
             }
             if (apdu_confirmed_dcc_disabled(service_choice)) {
@@ -604,6 +728,24 @@ void apdu_handler(
                     initiated. */
                 break;
             }
+#if BACNET_SEGMENTATION_ENABLED
+            if (service_data.segmented_message) {
+                if (!tsm_segment_receive(
+                        src, false, service_data.invoke_id,
+                        service_data.sequence_number,
+                        service_data.proposed_window_number,
+                        service_data.more_follows, service_request,
+                        service_request_len, &service_request,
+                        &service_request_len)) {
+                    /* wait for the rest of the segments */
+                    break;
+                }
+                /* the handlers get the whole request */
+                segmented = true;
+                service_data.segmented_message = false;
+                service_data.more_follows = false;
+            }
+#endif
             if ((service_choice < MAX_BACNET_CONFIRMED_SERVICE) &&
                 (Confirmed_Function[service_choice])) {
                 Confirmed_Function[service_choice](
@@ -612,6 +754,14 @@ void apdu_handler(
                 Unrecognized_Service_Handler(
                     service_request, service_request_len, src, &service_data);
             }
+#if BACNET_PERFSTAT_ENABLED
+            perfstat_confirmed_service(service_choice, start);
+#endif
+#if BACNET_SEGMENTATION_ENABLED
+            if (segmented) {
+                tsm_segmented_message_free(src, false, service_data.invoke_id);
+            }
+#endif
             break;
         case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
             if (apdu_len < 2) {
@@ -635,6 +785,9 @@ void apdu_handler(
                     Unconfirmed_Function[service_choice](
                         service_request, service_request_len, src);
                 }
+#if BACNET_PERFSTAT_ENABLED
+                perfstat_unconfirmed_service(service_choice, start);
+#endif
             }
             break;
 #if !BACNET_SVC_SERVER
@@ -649,7 +802,7 @@ void apdu_handler(
                     Confirmed_ACK_Function[service_choice].simple(
                         src, invoke_id);
                 }
-                tsm_free_invoke_id(invoke_id);
+                tsm_free_invoke_id_peer(src, invoke_id);
             }
             break;
         case PDU_TYPE_COMPLEX_ACK:
@@ -672,23 +825,54 @@ void apdu_handler(
             /* prepare the service request buffer and length */
             service_request_len = apdu_len - (uint16_t)len;
             service_request = &apdu[len];
-            if (!apdu_confirmed_simple_ack_service(service_choice)) {
-                if (service_choice < MAX_BACNET_CONFIRMED_SERVICE) {
-                    if (Confirmed_ACK_Function[service_choice].complex !=
-                        NULL) {
-                        Confirmed_ACK_Function[service_choice].complex(
-                            service_request, service_request_len, src,
-                            &service_ack_data);
-                    }
+            if (apdu_confirmed_simple_ack_service(service_choice)) {
+                break;
+            }
+#if BACNET_SEGMENTATION_ENABLED
+            if (service_ack_data.segmented_message) {
+                if (!tsm_segment_receive(
+                        src, true, invoke_id,
+                        service_ack_data.sequence_number,
+                        service_ack_data.proposed_window_number,
+                        service_ack_data.more_follows, service_request,
+                        service_request_len, &service_request,
+                        &service_request_len)) {
+                    /* wait for the rest of the segments */
+                    break;
                 }
-                tsm_free_invoke_id(invoke_id);
+                /* the handlers get the whole ComplexACK */
+                segmented = true;
+                service_ack_data.segmented_message = false;
+                service_ack_data.more_follows = false;
             }
+#endif
+            if (service_choice < MAX_BACNET_CONFIRMED_SERVICE) {
+                if (Confirmed_ACK_Function[service_choice].complex != NULL) {
+                    Confirmed_ACK_Function[service_choice].complex(
+                        service_request, service_request_len, src,
+                        &service_ack_data);
+                }
+            }
+#if BACNET_SEGMENTATION_ENABLED
+            if (segmented) {
+                tsm_segmented_message_free(src, true, invoke_id);
+            }
+#endif
+            tsm_free_invoke_id_peer(src, invoke_id);
             break;
+#endif
         case PDU_TYPE_SEGMENT_ACK:
-            /* FIXME: what about a denial of service attack here?
-                we could check src to see if that matched the tsm */
-            tsm_free_invoke_id(invoke_id);
+#if BACNET_SEGMENTATION_ENABLED
+            if (apdu_len < 4) {
+                break;
+            }
+            /* the window of a segmented reply was received */
+            tsm_segment_ack_handler(
+                src, (apdu[0] & BIT(1)) ? true : false,
+                (apdu[0] & BIT(0)) ? true : false, apdu[1], apdu[2], apdu[3]);
+#endif
             break;
+#if !BACNET_SVC_SERVER
         case PDU_TYPE_ERROR:
             if (apdu_len < 3) {
                 break;
@@ -714,7 +898,7 @@ void apdu_handler(
                         (BACNET_ERROR_CODE)error_code);
                 }
             }
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(src, invoke_id);
             break;
         case PDU_TYPE_REJECT:
             if (apdu_len < 3) {
@@ -725,22 +909,32 @@ void apdu_handler(
             if (Reject_Function) {
                 Reject_Function(src, invoke_id, reason);
             }
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(src, invoke_id);
             break;
+#endif
+#if !BACNET_SVC_SERVER || BACNET_SEGMENTATION_ENABLED
         case PDU_TYPE_ABORT:
             if (apdu_len < 3) {
                 break;
             }
             server = apdu[0] & 0x01;
             invoke_id = apdu[1];
+#if BACNET_SEGMENTATION_ENABLED
+            tsm_segmented_abort_handler(src, server, invoke_id);
+#endif
+#if !BACNET_SVC_SERVER
             reason = apdu[2];
             if (Abort_Function) {
                 Abort_Function(src, invoke_id, reason, server);
             }
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(src, invoke_id);
+#endif
             break;
 #endif
         default:
             break;
     }
+    /* the scratch memory of the request is taken back all at once */
+    Arena_Release(&Scratch_Arena, scratch_mark);
+    BACTRACE_APDU_END(pdu_type, service_choice);
 }
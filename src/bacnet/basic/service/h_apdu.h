@@ -13,6 +13,15 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/apdu.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/basic/sys/arena.h"
+
+/* size of the built-in scratch memory that the service handlers take
+   their large request data from, instead of the stack, while
+   apdu_handler() processes a request */
+#ifndef BACNET_APDU_SCRATCH_SIZE
+#define BACNET_APDU_SCRATCH_SIZE (MAX_APDU + 256)
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -111,6 +120,8 @@ void apdu_set_unconfirmed_handler(
 /* returns true if the service is supported by a handler */
 BACNET_STACK_EXPORT
 bool apdu_service_supported(BACNET_SERVICES_SUPPORTED service_supported);
+BACNET_STACK_EXPORT
+void apdu_services_supported(BACNET_BIT_STRING *bit_string);
 
 /* Function to translate a SERVICE_SUPPORTED_ enum to its SERVICE_CONFIRMED_
  *  or SERVICE_UNCONFIRMED_ index.
@@ -155,6 +166,19 @@ BACNET_STACK_EXPORT
 uint8_t apdu_retries(void);
 BACNET_STACK_EXPORT
 void apdu_retries_set(uint8_t value);
+#if BACNET_SEGMENTATION_ENABLED
+BACNET_STACK_EXPORT
+uint16_t apdu_segment_timeout(void);
+BACNET_STACK_EXPORT
+void apdu_segment_timeout_set(uint16_t milliseconds);
+#endif
+
+BACNET_STACK_EXPORT
+void apdu_scratch_set(uint8_t *buffer, size_t size);
+BACNET_STACK_EXPORT
+OS_Arena apdu_scratch(void);
+BACNET_STACK_EXPORT
+void *apdu_scratch_alloc(size_t size);
 
 BACNET_STACK_EXPORT
 void apdu_handler(
@@ -83,7 +83,7 @@ void handler_atomic_read_file(
     BACNET_ADDRESS *src,
     BACNET_CONFIRMED_SERVICE_DATA *service_data)
 {
-    BACNET_ATOMIC_READ_FILE_DATA data;
+    BACNET_ATOMIC_READ_FILE_DATA *data;
     int len = 0;
     int pdu_len = 0;
     bool error = false;
@@ -101,6 +101,14 @@ void handler_atomic_read_file(
     npdu_encode_npdu_data(&npdu_data, false, service_data->priority);
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    data = apdu_scratch_alloc(sizeof(BACNET_ATOMIC_READ_FILE_DATA));
+    if (!data) {
+        len = abort_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
+            ABORT_REASON_OUT_OF_RESOURCES, true);
+        debug_print("ARF: Out of scratch memory. Sending Abort!\n");
+        goto ARF_ABORT;
+    }
     if (service_len == 0) {
         len = reject_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
@@ -114,7 +122,7 @@ void handler_atomic_read_file(
         debug_print("ARF: Segmented Message. Sending Abort!\n");
         goto ARF_ABORT;
     }
-    len = arf_decode_service_request(service_request, service_len, &data);
+    len = arf_decode_service_request(service_request, service_len, data);
     /* bad decoding - send an abort */
     if (len < 0) {
         len = abort_encode_apdu(
@@ -123,20 +131,20 @@ void handler_atomic_read_file(
         debug_print("ARF: Bad Encoding. Sending Abort!\n");
         goto ARF_ABORT;
     }
-    if (data.object_type == OBJECT_FILE) {
-        if (!bacfile_valid_instance(data.object_instance)) {
+    if (data->object_type == OBJECT_FILE) {
+        if (!bacfile_valid_instance(data->object_instance)) {
             error = true;
-        } else if (data.access == FILE_STREAM_ACCESS) {
-            if (data.type.stream.requestedOctetCount <=
-                octetstring_capacity(&data.fileData[0])) {
-                bacfile_read_stream_data(&data);
+        } else if (data->access == FILE_STREAM_ACCESS) {
+            if (data->type.stream.requestedOctetCount <=
+                octetstring_capacity(&data->fileData[0])) {
+                bacfile_read_stream_data(data);
                 debug_fprintf(
                     stderr, "ARF: Stream offset %d, %d octets.\n",
-                    (int)data.type.stream.fileStartPosition,
-                    (int)data.type.stream.requestedOctetCount);
+                    (int)data->type.stream.fileStartPosition,
+                    (int)data->type.stream.requestedOctetCount);
                 len = arf_ack_encode_apdu(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                    &data);
+                    data);
             } else {
                 len = abort_encode_apdu(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
@@ -145,23 +153,23 @@ void handler_atomic_read_file(
                     stderr,
                     "ARF: Too Big To Send (%d >= %d). "
                     "Sending Abort!\n",
-                    (int)data.type.stream.requestedOctetCount,
-                    (int)octetstring_capacity(&data.fileData[0]));
+                    (int)data->type.stream.requestedOctetCount,
+                    (int)octetstring_capacity(&data->fileData[0]));
             }
-        } else if (data.access == FILE_RECORD_ACCESS) {
-            if (data.type.record.fileStartRecord >=
+        } else if (data->access == FILE_RECORD_ACCESS) {
+            if (data->type.record.fileStartRecord >=
                 BACNET_READ_FILE_RECORD_COUNT) {
                 error_class = ERROR_CLASS_SERVICES;
                 error_code = ERROR_CODE_INVALID_FILE_START_POSITION;
                 error = true;
-            } else if (bacfile_read_record_data(&data)) {
+            } else if (bacfile_read_record_data(data)) {
                 debug_fprintf(
                     stderr, "ARF: fileStartRecord %d, %u RecordCount.\n",
-                    (int)data.type.record.fileStartRecord,
-                    (unsigned)data.type.record.RecordCount);
+                    (int)data->type.record.fileStartRecord,
+                    (unsigned)data->type.record.RecordCount);
                 len = arf_ack_encode_apdu(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                    &data);
+                    data);
             } else {
                 error = true;
                 error_class = ERROR_CLASS_OBJECT;
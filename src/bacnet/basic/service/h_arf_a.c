@@ -35,9 +35,8 @@ void handler_atomic_read_file_ack(
     BACNET_ATOMIC_READ_FILE_DATA data;
     uint32_t instance = 0;
 
-    (void)src;
     /* get the file instance from the tsm data before freeing it */
-    instance = bacfile_instance_from_tsm(service_data->invoke_id);
+    instance = bacfile_instance_from_tsm_peer(src, service_data->invoke_id);
     len = arf_ack_decode_service_request(service_request, service_len, &data);
 #if PRINT_ENABLED
     fprintf(stderr, "Received Read-File Ack!\n");
@@ -63,7 +63,7 @@ void handler_atomic_write_file(
     BACNET_ADDRESS *src,
     BACNET_CONFIRMED_SERVICE_DATA *service_data)
 {
-    BACNET_ATOMIC_WRITE_FILE_DATA data;
+    BACNET_ATOMIC_WRITE_FILE_DATA *data;
     int len = 0;
     int pdu_len = 0;
     bool error = false;
@@ -79,6 +79,14 @@ void handler_atomic_write_file(
     npdu_encode_npdu_data(&npdu_data, false, service_data->priority);
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    data = apdu_scratch_alloc(sizeof(BACNET_ATOMIC_WRITE_FILE_DATA));
+    if (!data) {
+        len = abort_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
+            ABORT_REASON_OUT_OF_RESOURCES, true);
+        debug_print("AWF: Out of scratch memory. Sending Abort!\n");
+        goto AWF_ABORT;
+    }
     if (service_len == 0) {
         len = reject_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
@@ -92,7 +100,7 @@ void handler_atomic_write_file(
         debug_print("AWF:Segmented Message. Sending Abort!\n");
         goto AWF_ABORT;
     }
-    len = awf_decode_service_request(service_request, service_len, &data);
+    len = awf_decode_service_request(service_request, service_len, data);
     /* bad decoding - send an abort */
     if (len < 0) {
         len = abort_encode_apdu(
@@ -101,32 +109,32 @@ void handler_atomic_write_file(
         debug_print("AWF: Bad Encoding. Sending Abort!\n");
         goto AWF_ABORT;
     }
-    if (data.object_type == OBJECT_FILE) {
-        if (!bacfile_valid_instance(data.object_instance)) {
+    if (data->object_type == OBJECT_FILE) {
+        if (!bacfile_valid_instance(data->object_instance)) {
             error = true;
-        } else if (data.access == FILE_STREAM_ACCESS) {
-            if (bacfile_write_stream_data(&data)) {
+        } else if (data->access == FILE_STREAM_ACCESS) {
+            if (bacfile_write_stream_data(data)) {
                 debug_fprintf(
                     stderr, "AWF: Stream offset %d, %d bytes\n",
-                    data.type.stream.fileStartPosition,
-                    (int)octetstring_length(&data.fileData[0]));
+                    data->type.stream.fileStartPosition,
+                    (int)octetstring_length(&data->fileData[0]));
                 len = awf_ack_encode_apdu(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                    &data);
+                    data);
             } else {
                 error = true;
                 error_class = ERROR_CLASS_OBJECT;
                 error_code = ERROR_CODE_FILE_ACCESS_DENIED;
             }
-        } else if (data.access == FILE_RECORD_ACCESS) {
-            if (bacfile_write_record_data(&data)) {
+        } else if (data->access == FILE_RECORD_ACCESS) {
+            if (bacfile_write_record_data(data)) {
                 debug_fprintf(
                     stderr, "AWF: StartRecord %d, RecordCount %u\n",
-                    data.type.record.fileStartRecord,
-                    data.type.record.returnedRecordCount);
+                    data->type.record.fileStartRecord,
+                    data->type.record.returnedRecordCount);
                 len = awf_ack_encode_apdu(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                    &data);
+                    data);
             } else {
                 error = true;
                 error_class = ERROR_CLASS_OBJECT;
@@ -5,9 +5,11 @@
  * @date 2007
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -29,6 +31,11 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keyhash.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/memstat.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/datalink/datalink.h"
 
 #ifndef MAX_COV_PROPERTIES
@@ -37,6 +44,8 @@
 
 typedef struct BACnet_COV_Address {
     bool valid : 1;
+    /* number of subscriptions using this address */
+    unsigned count;
     BACNET_ADDRESS dest;
 } BACNET_COV_ADDRESS;
 
@@ -54,24 +63,123 @@ typedef struct BACnet_COV_Subscription {
     uint8_t invokeID; /* for confirmed COV */
     uint32_t subscriberProcessIdentifier;
     uint32_t lifetime; /* optional */
+    /* COV_Seconds when a subscription with a lifetime expires */
+    uint32_t expires;
+    /* timer wheel slot list when valid, free list when not valid */
+    unsigned next;
+    unsigned prev;
     BACNET_OBJECT_ID monitoredObjectIdentifier;
 } BACNET_COV_SUBSCRIPTION;
 
+/* The subscriptions are stored in an array that grows as needed up to
+   MAX_COV_SUBCRIPTIONS per device, so the maximum can be large without
+   using the memory until the subscriptions are made.  The index of a
+   subscription in the array does not change while it is valid. */
 #ifndef MAX_COV_SUBCRIPTIONS
 #define MAX_COV_SUBCRIPTIONS 128
 #endif
+/* number of one second slots in the lifetime timer wheel - power of 2 */
+#ifndef COV_TIMER_WHEEL_SIZE
+#define COV_TIMER_WHEEL_SIZE 64
+#endif
+#define COV_TIMER_WHEEL_MASK (COV_TIMER_WHEEL_SIZE - 1)
+/* no subscription - end of a list */
+#define COV_INDEX_NONE UINT_MAX
+/* minimum number of subscriptions or addresses to allocate memory for */
+#define COV_ARRAY_SIZE_MIN 8
+
+typedef struct BACnet_COV_Subscription_Store {
+    BACNET_COV_SUBSCRIPTION *subscriptions;
+    /* number of subscriptions in the array, valid or not */
+    unsigned size;
+    /* first subscription that is not valid */
+    unsigned free_index;
+    /* subscriber address index, process identifier, and monitored
+       object hash to the index of the subscription */
+    OS_Keyhash subscriber_index;
+    /* subscriptions with a lifetime, by the second when they expire */
+    unsigned timer_wheel[COV_TIMER_WHEEL_SIZE];
+} BACNET_COV_SUBSCRIPTION_STORE;
 
-static BACNET_COV_SUBSCRIPTION COV_Subscriptions_List[MAX_NUM_DEVICES]
-                                                     [MAX_COV_SUBCRIPTIONS];
+static BACNET_COV_SUBSCRIPTION_STORE COV_Store_List[MAX_NUM_DEVICES];
 #ifdef BAC_ROUTING
-#define COV_Subscriptions (COV_Subscriptions_List[Routed_Device_Object_Index()])
+#define COV_Store (COV_Store_List[Routed_Device_Object_Index()])
 #else
-#define COV_Subscriptions (COV_Subscriptions_List[0])
+#define COV_Store (COV_Store_List[0])
 #endif
+#define COV_Subscriptions (COV_Store.subscriptions)
+/* seconds since the COV handler was initialized */
+static uint32_t COV_Seconds;
+/* The addresses are shared by the subscriptions of all the devices, and
+   grow as needed up to MAX_COV_ADDRESSES. */
 #ifndef MAX_COV_ADDRESSES
 #define MAX_COV_ADDRESSES 16
 #endif
-static BACNET_COV_ADDRESS COV_Addresses[MAX_COV_ADDRESSES];
+static BACNET_COV_ADDRESS *COV_Addresses;
+static unsigned COV_Addresses_Size;
+/* address hash to the index of the address */
+static OS_Keyhash COV_Address_Index;
+/* Batched notifications: the requested notifications to the same
+   subscriber are sent together, up to the batch limit, and optionally
+   in one COVNotificationMultiple. */
+#ifndef COV_NOTIFICATION_BATCH_MAX
+#define COV_NOTIFICATION_BATCH_MAX 16
+#endif
+static unsigned COV_Notification_Batch_Limit;
+static bool COV_Notification_Multiple;
+/* Group notifications: the unconfirmed subscribers to the same object
+   that share a process identifier on the same network are sent one
+   broadcast notification, instead of one notification each. */
+static bool COV_Notification_Group;
+/* Change driven COV: the objects report that they changed with
+   cov_change_of_value_notify(), and only the subscriptions to the
+   changed objects are marked and sent, instead of polling every
+   subscribed object for a change. */
+static bool COV_Change_Driven;
+/* objects that reported a change, by object key */
+static OS_Keylist COV_Changed_Objects_List[MAX_NUM_DEVICES];
+/* subscriptions, by index, that have a notification to send */
+static OS_Keylist COV_Send_List[MAX_NUM_DEVICES];
+/* subscriptions, by index, that wait for a confirmed notification */
+static OS_Keylist COV_Confirmed_List[MAX_NUM_DEVICES];
+/* object key to the index of each subscription to the object */
+static OS_Keyhash COV_Object_Index_List[MAX_NUM_DEVICES];
+/* The list of values of an object is encoded once when it changes, and
+   is sent to each subscriber of the object until the object changes or
+   is subscribed to again.  Lists longer than COV_VALUE_CACHE_OCTETS are
+   encoded for each notification. */
+#ifndef COV_VALUE_CACHE_SIZE
+#define COV_VALUE_CACHE_SIZE 4
+#endif
+#ifndef COV_VALUE_CACHE_OCTETS
+#define COV_VALUE_CACHE_OCTETS 64
+#endif
+typedef struct BACnet_COV_Value_Entry {
+    bool valid : 1;
+    KEY key;
+    uint16_t len;
+    uint8_t values[COV_VALUE_CACHE_OCTETS];
+} BACNET_COV_VALUE_ENTRY;
+typedef struct BACnet_COV_Value_Cache {
+    BACNET_COV_VALUE_ENTRY entries[COV_VALUE_CACHE_SIZE];
+    /* the entry that is replaced next when none are free */
+    unsigned next;
+} BACNET_COV_VALUE_CACHE;
+static BACNET_COV_VALUE_CACHE COV_Value_Cache_List[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define COV_Changed_Objects \
+    (COV_Changed_Objects_List[Routed_Device_Object_Index()])
+#define COV_Send (COV_Send_List[Routed_Device_Object_Index()])
+#define COV_Confirmed (COV_Confirmed_List[Routed_Device_Object_Index()])
+#define COV_Object_Index (COV_Object_Index_List[Routed_Device_Object_Index()])
+#define COV_Value_Cache (COV_Value_Cache_List[Routed_Device_Object_Index()])
+#else
+#define COV_Changed_Objects (COV_Changed_Objects_List[0])
+#define COV_Send (COV_Send_List[0])
+#define COV_Confirmed (COV_Confirmed_List[0])
+#define COV_Object_Index (COV_Object_Index_List[0])
+#define COV_Value_Cache (COV_Value_Cache_List[0])
+#endif
 
 /**
  * Gets the address from the list of COV addresses
@@ -85,7 +193,7 @@ static BACNET_ADDRESS *cov_address_get(unsigned index)
 {
     BACNET_ADDRESS *cov_dest = NULL;
 
-    if (index < MAX_COV_ADDRESSES) {
+    if (index < COV_Addresses_Size) {
         if (COV_Addresses[index].valid) {
             cov_dest = &COV_Addresses[index].dest;
         }
@@ -95,61 +203,56 @@ static BACNET_ADDRESS *cov_address_get(unsigned index)
 }
 
 /**
- * Removes the address from the list of COV addresses, if it is not
- * used by other COV subscriptions
+ * Finds the address in the list of COV addresses
+ *
+ * @param  dest - address to be found
+ *
+ * @return index number 0..N, or -1 if not found
  */
-static void cov_address_remove_unused(void)
+static int cov_address_find(const BACNET_ADDRESS *dest)
 {
-    unsigned index = 0;
-    unsigned cov_index = 0;
-    bool found = false;
+    unsigned iterator = 0;
+    KEY key = 0;
+    uint32_t hash;
 
-#ifdef BAC_ROUTING
-    uint16_t current_dev_id = Routed_Device_Object_Index();
-    uint16_t dev_id = 0;
-    for (cov_index = 0; cov_index < MAX_COV_ADDRESSES; cov_index++) {
-        if (COV_Addresses[cov_index].valid) {
-            found = false;
-            for (dev_id = 0; dev_id < Get_Num_Managed_Devices(); dev_id++) {
-                Set_Routed_Device_Object_Index(dev_id);
-                for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-                    if ((COV_Subscriptions[index].flag.valid) &&
-                        (COV_Subscriptions[index].dest_index == cov_index)) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (found) {
-                    break;
-                }
-            }
-            if (!found) {
-                COV_Addresses[cov_index].valid = false;
-            }
+    if (!dest) {
+        return -1;
+    }
+    hash = bacnet_address_hash(dest);
+    while (Keyhash_Find(COV_Address_Index, hash, &iterator, &key)) {
+        if ((key < COV_Addresses_Size) && (COV_Addresses[key].valid) &&
+            bacnet_address_same(dest, &COV_Addresses[key].dest)) {
+            return (int)key;
         }
     }
-    Set_Routed_Device_Object_Index(current_dev_id);
-#else
-    for (cov_index = 0; cov_index < MAX_COV_ADDRESSES; cov_index++) {
-        if (COV_Addresses[cov_index].valid) {
-            found = false;
-            for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-                if ((COV_Subscriptions[index].flag.valid) &&
-                    (COV_Subscriptions[index].dest_index == cov_index)) {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                COV_Addresses[cov_index].valid = false;
-            }
+
+    return -1;
+}
+
+/**
+ * Removes a subscription from an address in the list of COV addresses,
+ * and removes the address when it is not used by other COV subscriptions
+ *
+ * @param  index - offset into COV address list where address is stored
+ */
+static void cov_address_remove(unsigned index)
+{
+    if ((index < COV_Addresses_Size) && (COV_Addresses[index].valid)) {
+        if (COV_Addresses[index].count > 0) {
+            COV_Addresses[index].count--;
+        }
+        if (COV_Addresses[index].count == 0) {
+            (void)Keyhash_Remove(
+                COV_Address_Index,
+                bacnet_address_hash(&COV_Addresses[index].dest), index);
+            COV_Addresses[index].valid = false;
         }
     }
-#endif
 }
 
 /**
- * Adds the address to the list of COV addresses
+ * Adds a subscription to the address in the list of COV addresses,
+ * adding the address when it is not already in the list
  *
  * @param  dest - address to be added if there is room in the list
  *
@@ -157,42 +260,519 @@ static void cov_address_remove_unused(void)
  */
 static int cov_address_add(const BACNET_ADDRESS *dest)
 {
-    int index = -1;
+    BACNET_COV_ADDRESS *cov_addresses = NULL;
+    unsigned size = 0;
     unsigned i = 0;
-    bool found = false;
-    bool valid = false;
-    BACNET_ADDRESS *cov_dest = NULL;
+    int index = -1;
 
-    if (dest) {
-        for (i = 0; i < MAX_COV_ADDRESSES; i++) {
-            valid = COV_Addresses[i].valid;
-            if (valid) {
-                cov_dest = &COV_Addresses[i].dest;
-                found = bacnet_address_same(dest, cov_dest);
-                if (found) {
-                    index = i;
-                    break;
-                }
+    if (!dest) {
+        return -1;
+    }
+    index = cov_address_find(dest);
+    if (index < 0) {
+        /* find a free place to add a new address */
+        for (i = 0; i < COV_Addresses_Size; i++) {
+            if (!COV_Addresses[i].valid) {
+                index = i;
+                break;
             }
         }
-        if (!found) {
-            /* find a free place to add a new address */
-            for (i = 0; i < MAX_COV_ADDRESSES; i++) {
-                valid = COV_Addresses[i].valid;
-                if (!valid) {
-                    index = i;
-                    cov_dest = &COV_Addresses[i].dest;
-                    bacnet_address_copy(cov_dest, dest);
-                    COV_Addresses[i].valid = true;
-                    break;
-                }
+    }
+    if ((index < 0) && (COV_Addresses_Size < MAX_COV_ADDRESSES)) {
+        size = COV_Addresses_Size * 2;
+        if (size < COV_ARRAY_SIZE_MIN) {
+            size = COV_ARRAY_SIZE_MIN;
+        }
+        if (size > MAX_COV_ADDRESSES) {
+            size = MAX_COV_ADDRESSES;
+        }
+        cov_addresses =
+            realloc(COV_Addresses, size * sizeof(BACNET_COV_ADDRESS));
+        if (cov_addresses) {
+            MEMSTAT_FREE(
+                MEMSTAT_COV, COV_Addresses_Size * sizeof(BACNET_COV_ADDRESS));
+            MEMSTAT_ALLOC(MEMSTAT_COV, size * sizeof(BACNET_COV_ADDRESS));
+            memset(
+                &cov_addresses[COV_Addresses_Size], 0,
+                (size - COV_Addresses_Size) * sizeof(BACNET_COV_ADDRESS));
+            index = COV_Addresses_Size;
+            COV_Addresses = cov_addresses;
+            COV_Addresses_Size = size;
+        }
+    }
+    if (index < 0) {
+        return -1;
+    }
+    if (!COV_Addresses[index].valid) {
+        if (!COV_Address_Index) {
+            COV_Address_Index = Keyhash_Create();
+        }
+        if (!Keyhash_Add(COV_Address_Index, bacnet_address_hash(dest), index)) {
+            return -1;
+        }
+        bacnet_address_copy(&COV_Addresses[index].dest, dest);
+        COV_Addresses[index].count = 0;
+        COV_Addresses[index].valid = true;
+    }
+    COV_Addresses[index].count++;
+
+    return index;
+}
+
+/**
+ * @brief Compute the hash of the subscriber and monitored object
+ *  of a subscription
+ * @param dest_index - index of the subscriber address
+ * @param pid - subscriber process identifier
+ * @param object_id - monitored object identifier
+ * @return hash value
+ */
+static uint32_t cov_subscriber_hash(
+    unsigned dest_index, uint32_t pid, const BACNET_OBJECT_ID *object_id)
+{
+    uint32_t data[4];
+
+    data[0] = dest_index;
+    data[1] = pid;
+    data[2] = object_id->type;
+    data[3] = object_id->instance;
+
+    return Keyhash_FNV1a(data, sizeof(data));
+}
+
+/**
+ * @brief Find a subscription by subscriber and monitored object
+ * @param dest_index - index of the subscriber address
+ * @param pid - subscriber process identifier
+ * @param object_id - monitored object identifier
+ * @return index of the subscription, or COV_INDEX_NONE if not found
+ */
+static unsigned cov_subscription_find(
+    unsigned dest_index, uint32_t pid, const BACNET_OBJECT_ID *object_id)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription;
+    unsigned iterator = 0;
+    KEY key = 0;
+    uint32_t hash;
+
+    hash = cov_subscriber_hash(dest_index, pid, object_id);
+    while (Keyhash_Find(COV_Store.subscriber_index, hash, &iterator, &key)) {
+        if (key < COV_Store.size) {
+            cov_subscription = &COV_Subscriptions[key];
+            if ((cov_subscription->flag.valid) &&
+                (cov_subscription->dest_index == dest_index) &&
+                (cov_subscription->subscriberProcessIdentifier == pid) &&
+                (cov_subscription->monitoredObjectIdentifier.type ==
+                 object_id->type) &&
+                (cov_subscription->monitoredObjectIdentifier.instance ==
+                 object_id->instance)) {
+                return key;
             }
         }
     }
 
+    return COV_INDEX_NONE;
+}
+
+/**
+ * @brief Add a subscription to the lifetime timer wheel
+ * @param index - subscription index
+ */
+static void cov_timer_add(unsigned index)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription = &COV_Subscriptions[index];
+    unsigned slot;
+
+    cov_subscription->next = COV_INDEX_NONE;
+    cov_subscription->prev = COV_INDEX_NONE;
+    if (cov_subscription->lifetime == 0) {
+        /* indefinite lifetime - never expires */
+        return;
+    }
+    cov_subscription->expires = COV_Seconds + cov_subscription->lifetime;
+    slot = cov_subscription->expires & COV_TIMER_WHEEL_MASK;
+    cov_subscription->next = COV_Store.timer_wheel[slot];
+    if (cov_subscription->next != COV_INDEX_NONE) {
+        COV_Subscriptions[cov_subscription->next].prev = index;
+    }
+    COV_Store.timer_wheel[slot] = index;
+}
+
+/**
+ * @brief Remove a subscription from the lifetime timer wheel
+ * @param index - subscription index
+ */
+static void cov_timer_remove(unsigned index)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription = &COV_Subscriptions[index];
+    unsigned slot;
+
+    if (cov_subscription->lifetime == 0) {
+        return;
+    }
+    if (cov_subscription->prev != COV_INDEX_NONE) {
+        COV_Subscriptions[cov_subscription->prev].next = cov_subscription->next;
+    } else {
+        slot = cov_subscription->expires & COV_TIMER_WHEEL_MASK;
+        COV_Store.timer_wheel[slot] = cov_subscription->next;
+    }
+    if (cov_subscription->next != COV_INDEX_NONE) {
+        COV_Subscriptions[cov_subscription->next].prev = cov_subscription->prev;
+    }
+    cov_subscription->next = COV_INDEX_NONE;
+    cov_subscription->prev = COV_INDEX_NONE;
+}
+
+/**
+ * @brief Get the number of seconds before a subscription expires
+ * @param cov_subscription - subscription
+ * @return seconds remaining, or 0 for an indefinite lifetime
+ */
+static uint32_t
+cov_subscription_time_remaining(const BACNET_COV_SUBSCRIPTION *cov_subscription)
+{
+    if (cov_subscription->lifetime == 0) {
+        return 0;
+    }
+
+    return cov_subscription->expires - COV_Seconds;
+}
+
+/**
+ * @brief Get a subscription that is not valid, growing the array of
+ *  subscriptions when there are none
+ * @return index of the subscription, or COV_INDEX_NONE if no space
+ */
+static unsigned cov_subscription_alloc(void)
+{
+    BACNET_COV_SUBSCRIPTION *subscriptions = NULL;
+    unsigned index = COV_INDEX_NONE;
+    unsigned size = 0;
+    unsigned i = 0;
+
+    if (COV_Store.size == 0) {
+        COV_Store.free_index = COV_INDEX_NONE;
+        for (i = 0; i < COV_TIMER_WHEEL_SIZE; i++) {
+            COV_Store.timer_wheel[i] = COV_INDEX_NONE;
+        }
+    }
+    if (COV_Store.free_index == COV_INDEX_NONE) {
+        if (COV_Store.size >= MAX_COV_SUBCRIPTIONS) {
+            return COV_INDEX_NONE;
+        }
+        size = COV_Store.size * 2;
+        if (size < COV_ARRAY_SIZE_MIN) {
+            size = COV_ARRAY_SIZE_MIN;
+        }
+        if (size > MAX_COV_SUBCRIPTIONS) {
+            size = MAX_COV_SUBCRIPTIONS;
+        }
+        subscriptions = realloc(
+            COV_Store.subscriptions, size * sizeof(BACNET_COV_SUBSCRIPTION));
+        if (!subscriptions) {
+            return COV_INDEX_NONE;
+        }
+        MEMSTAT_FREE(
+            MEMSTAT_COV, COV_Store.size * sizeof(BACNET_COV_SUBSCRIPTION));
+        MEMSTAT_ALLOC(MEMSTAT_COV, size * sizeof(BACNET_COV_SUBSCRIPTION));
+        /* add the new subscriptions to the free list in order */
+        for (i = size; i > COV_Store.size; i--) {
+            memset(&subscriptions[i - 1], 0, sizeof(BACNET_COV_SUBSCRIPTION));
+            subscriptions[i - 1].dest_index = MAX_COV_ADDRESSES;
+            subscriptions[i - 1].next = COV_Store.free_index;
+            COV_Store.free_index = i - 1;
+        }
+        COV_Store.subscriptions = subscriptions;
+        COV_Store.size = size;
+    }
+    index = COV_Store.free_index;
+    COV_Store.free_index = COV_Subscriptions[index].next;
+
     return index;
 }
 
+/**
+ * @brief Make a subscription that is not valid available for reuse
+ * @param index - subscription index
+ */
+static void cov_subscription_free(unsigned index)
+{
+    COV_Subscriptions[index].flag.valid = false;
+    COV_Subscriptions[index].flag.send_requested = false;
+    COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
+    COV_Subscriptions[index].next = COV_Store.free_index;
+    COV_Store.free_index = index;
+}
+
+/**
+ * @brief Add a key to a list once, creating the list when needed
+ * @param pList - pointer to the list
+ * @param key - key to add
+ */
+static void cov_key_list_add(OS_Keylist *pList, KEY key)
+{
+    if (!*pList) {
+        *pList = Keylist_Create();
+    }
+    if (Keylist_Index(*pList, key) < 0) {
+        (void)Keylist_Data_Add(*pList, key, NULL);
+    }
+}
+
+/**
+ * @brief Get the object key of the object monitored by a subscription
+ * @param index - subscription index
+ * @return object key
+ */
+static KEY cov_subscription_object_key(unsigned index)
+{
+    return KEY_ENCODE(
+        COV_Subscriptions[index].monitoredObjectIdentifier.type,
+        COV_Subscriptions[index].monitoredObjectIdentifier.instance);
+}
+
+/**
+ * @brief Add a valid subscription to the object index
+ * @param index - subscription index
+ */
+static void cov_subscription_index_add(unsigned index)
+{
+    if (COV_Change_Driven) {
+        if (!COV_Object_Index) {
+            COV_Object_Index = Keyhash_Create();
+        }
+        (void)Keyhash_Add(
+            COV_Object_Index, cov_subscription_object_key(index), index);
+    }
+}
+
+/**
+ * @brief Remove a subscription from the object index, before it is
+ *  made invalid
+ * @param index - subscription index
+ */
+static void cov_subscription_index_remove(unsigned index)
+{
+    if (COV_Change_Driven) {
+        (void)Keyhash_Remove(
+            COV_Object_Index, cov_subscription_object_key(index), index);
+    }
+}
+
+/**
+ * @brief Discard the encoded list of values of an object, so that it is
+ *  encoded again for the next notification
+ * @param key - object key
+ */
+static void cov_value_cache_invalidate(KEY key)
+{
+    unsigned i;
+
+    for (i = 0; i < COV_VALUE_CACHE_SIZE; i++) {
+        if (COV_Value_Cache.entries[i].valid &&
+            (COV_Value_Cache.entries[i].key == key)) {
+            COV_Value_Cache.entries[i].valid = false;
+        }
+    }
+}
+
+/**
+ * @brief Find the encoded list of values of an object
+ * @param key - object key
+ * @return the cache entry, or NULL if the list is not encoded
+ */
+static const BACNET_COV_VALUE_ENTRY *cov_value_cache_find(KEY key)
+{
+    unsigned i;
+
+    for (i = 0; i < COV_VALUE_CACHE_SIZE; i++) {
+        if (COV_Value_Cache.entries[i].valid &&
+            (COV_Value_Cache.entries[i].key == key)) {
+            return &COV_Value_Cache.entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Encode the list of values of an object into a free cache entry,
+ *  or into the oldest one when none are free
+ * @param key - object key
+ * @param value_list - the list of values of the object
+ * @return the cache entry, or NULL if the list does not fit in one
+ */
+static const BACNET_COV_VALUE_ENTRY *
+cov_value_cache_add(KEY key, const BACNET_PROPERTY_VALUE *value_list)
+{
+    BACNET_COV_VALUE_ENTRY *entry = NULL;
+    int len;
+    unsigned i;
+
+    len = cov_notify_value_list_encode(NULL, value_list);
+    if ((len <= 0) || (len > COV_VALUE_CACHE_OCTETS)) {
+        return NULL;
+    }
+    for (i = 0; i < COV_VALUE_CACHE_SIZE; i++) {
+        if (!COV_Value_Cache.entries[i].valid) {
+            entry = &COV_Value_Cache.entries[i];
+            break;
+        }
+    }
+    if (!entry) {
+        entry = &COV_Value_Cache.entries[COV_Value_Cache.next];
+        COV_Value_Cache.next =
+            (COV_Value_Cache.next + 1) % COV_VALUE_CACHE_SIZE;
+    }
+    entry->len = (uint16_t)cov_notify_value_list_encode(
+        &entry->values[0], value_list);
+    entry->key = key;
+    entry->valid = true;
+
+    return entry;
+}
+
+/**
+ * @brief Request that a notification be sent for a subscription,
+ *  with the current list of values of the monitored object
+ * @param index - subscription index
+ */
+static void cov_subscription_send_request(unsigned index)
+{
+    cov_value_cache_invalidate(cov_subscription_object_key(index));
+    COV_Subscriptions[index].flag.send_requested = true;
+    if (COV_Change_Driven) {
+        cov_key_list_add(&COV_Send, index);
+    }
+}
+
+/**
+ * @brief Queue an object that reported a change of value, so that its
+ *  subscriptions are notified by the change driven COV task.
+ *  Objects without subscriptions are not queued.
+ * @param object_type - object type of the changed object
+ * @param object_instance - object instance of the changed object
+ */
+void handler_cov_object_changed(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    unsigned iterator = 0;
+    KEY key;
+
+    if (!COV_Change_Driven) {
+        return;
+    }
+    key = KEY_ENCODE(object_type, object_instance);
+    if (Keyhash_Find(COV_Object_Index, key, &iterator, NULL)) {
+        cov_key_list_add(&COV_Changed_Objects, key);
+    }
+}
+
+/**
+ * @brief Rebuild the change driven lists and index of one device
+ *  from its subscriptions, or release them when disabled
+ */
+static void cov_change_driven_rebuild(void)
+{
+    unsigned index;
+
+    Keyhash_Delete(COV_Object_Index);
+    COV_Object_Index = NULL;
+    Keylist_Delete(COV_Changed_Objects);
+    COV_Changed_Objects = NULL;
+    Keylist_Delete(COV_Send);
+    COV_Send = NULL;
+    Keylist_Delete(COV_Confirmed);
+    COV_Confirmed = NULL;
+    if (!COV_Change_Driven) {
+        return;
+    }
+    for (index = 0; index < COV_Store.size; index++) {
+        if (COV_Subscriptions[index].flag.valid) {
+            cov_subscription_index_add(index);
+            /* a change may have been flagged before now */
+            cov_key_list_add(
+                &COV_Changed_Objects, cov_subscription_object_key(index));
+            if (COV_Subscriptions[index].flag.send_requested) {
+                cov_key_list_add(&COV_Send, index);
+            }
+            if (COV_Subscriptions[index].invokeID) {
+                cov_key_list_add(&COV_Confirmed, index);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Enable or disable change driven COV.  When enabled, only the
+ *  objects that report a change with cov_change_of_value_notify() are
+ *  checked for COV, which is much less work than polling every
+ *  subscription when there are many subscriptions and few changes.
+ *  Only enable it when every object type that supports COV in
+ *  the device reports its changes.
+ * @param enable - true to enable change driven COV
+ */
+void handler_cov_change_driven_set(bool enable)
+{
+#ifdef BAC_ROUTING
+    uint16_t current_dev_id = Routed_Device_Object_Index();
+    uint16_t dev_id = 0;
+#endif
+
+    COV_Change_Driven = enable;
+    if (enable) {
+        cov_change_of_value_callback_set(handler_cov_object_changed);
+    } else {
+        cov_change_of_value_callback_set(NULL);
+    }
+#ifdef BAC_ROUTING
+    for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
+        Set_Routed_Device_Object_Index(dev_id);
+        cov_change_driven_rebuild();
+    }
+    Set_Routed_Device_Object_Index(current_dev_id);
+#else
+    cov_change_driven_rebuild();
+#endif
+}
+
+/**
+ * @brief Determine if change driven COV is enabled
+ * @return true if change driven COV is enabled
+ */
+bool handler_cov_change_driven(void)
+{
+    return COV_Change_Driven;
+}
+
+/**
+ * @brief Remove a valid subscription, and make it available for reuse
+ * @param index - subscription index
+ */
+static void cov_subscription_remove(unsigned index)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription = &COV_Subscriptions[index];
+
+    cov_subscription_index_remove(index);
+    cov_timer_remove(index);
+    (void)Keyhash_Remove(
+        COV_Store.subscriber_index,
+        cov_subscriber_hash(
+            cov_subscription->dest_index,
+            cov_subscription->subscriberProcessIdentifier,
+            &cov_subscription->monitoredObjectIdentifier),
+        index);
+    if (cov_subscription->invokeID) {
+        tsm_free_invoke_id_peer(
+            cov_address_get(cov_subscription->dest_index),
+            cov_subscription->invokeID);
+        cov_subscription->invokeID = 0;
+    }
+    cov_address_remove(cov_subscription->dest_index);
+    /* initialize with invalid COV address */
+    cov_subscription_free(index);
+}
+
 /*
 BACnetCOVSubscription ::= SEQUENCE {
 Recipient [0] BACnetRecipientProcess,
@@ -293,8 +873,8 @@ static int cov_encode_subscription(
         &apdu[apdu_len], 2, cov_subscription->flag.issueConfirmedNotifications);
     apdu_len += len;
     /* TimeRemaining [3] Unsigned, */
-    len =
-        encode_context_unsigned(&apdu[apdu_len], 3, cov_subscription->lifetime);
+    len = encode_context_unsigned(
+        &apdu[apdu_len], 3, cov_subscription_time_remaining(cov_subscription));
     apdu_len += len;
 
     return apdu_len;
@@ -310,6 +890,25 @@ static int cov_encode_subscription(
  *  @return How many bytes were encoded in the buffer, or -2 if the response
  *          would not fit within the buffer.
  */
+/**
+ * @brief Count the COV subscriptions of this device, for example to see
+ *  how full the subscription table is
+ * @return number of valid COV subscriptions
+ */
+unsigned handler_cov_subscription_count(void)
+{
+    unsigned index = 0;
+    unsigned count = 0;
+
+    for (index = 0; index < COV_Store.size; index++) {
+        if (COV_Subscriptions[index].flag.valid) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
 /* Maximume length for an encoded COV subscription  - 31 bytes for BACNET IP6
  * 35 bytes for IPv4 (longest MAC) with the maximum length
  * of PID (5 bytes) and lets round it up to the 64bit machine word
@@ -324,7 +923,7 @@ int handler_cov_encode_subscriptions(uint8_t *apdu, int max_apdu)
         unsigned index = 0;
         int apdu_len = 0;
 
-        for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
+        for (index = 0; index < COV_Store.size; index++) {
             if (COV_Subscriptions[index].flag.valid) {
                 /* Lets encode a COV subscription into an intermediate buffer
                  * that can hold it */
@@ -348,50 +947,58 @@ int handler_cov_encode_subscriptions(uint8_t *apdu, int max_apdu)
     return 0;
 }
 
+/**
+ * @brief Release the memory of the subscriptions of one device
+ */
+static void cov_store_cleanup(void)
+{
+    unsigned i;
+
+    Keyhash_Delete(COV_Store.subscriber_index);
+    COV_Store.subscriber_index = NULL;
+    MEMSTAT_FREE(
+        MEMSTAT_COV, COV_Store.size * sizeof(BACNET_COV_SUBSCRIPTION));
+    free(COV_Store.subscriptions);
+    COV_Store.subscriptions = NULL;
+    COV_Store.size = 0;
+    COV_Store.free_index = COV_INDEX_NONE;
+    for (i = 0; i < COV_TIMER_WHEEL_SIZE; i++) {
+        COV_Store.timer_wheel[i] = COV_INDEX_NONE;
+    }
+    for (i = 0; i < COV_VALUE_CACHE_SIZE; i++) {
+        COV_Value_Cache.entries[i].valid = false;
+    }
+    COV_Value_Cache.next = 0;
+}
+
 /** Handler to initialize the COV list, clearing and disabling each entry.
  * @ingroup DSCOV
  */
 void handler_cov_init(void)
 {
-    unsigned index = 0;
 #ifdef BAC_ROUTING
     uint16_t current_dev_id = Routed_Device_Object_Index();
     uint16_t dev_id = 0;
     for (dev_id = 0; dev_id < MAX_NUM_DEVICES; dev_id++) {
         Set_Routed_Device_Object_Index(dev_id);
-        for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-            /* initialize with invalid COV address */
-            COV_Subscriptions[index].flag.valid = false;
-            COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
-            COV_Subscriptions[index].subscriberProcessIdentifier = 0;
-            COV_Subscriptions[index].monitoredObjectIdentifier.type =
-                OBJECT_ANALOG_INPUT;
-            COV_Subscriptions[index].monitoredObjectIdentifier.instance = 0;
-            COV_Subscriptions[index].flag.issueConfirmedNotifications = false;
-            COV_Subscriptions[index].invokeID = 0;
-            COV_Subscriptions[index].lifetime = 0;
-            COV_Subscriptions[index].flag.send_requested = false;
-        }
+        cov_store_cleanup();
     }
     Set_Routed_Device_Object_Index(current_dev_id);
 #else
-    for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-        /* initialize with invalid COV address */
-        COV_Subscriptions[index].flag.valid = false;
-        COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
-        COV_Subscriptions[index].subscriberProcessIdentifier = 0;
-        COV_Subscriptions[index].monitoredObjectIdentifier.type =
-            OBJECT_ANALOG_INPUT;
-        COV_Subscriptions[index].monitoredObjectIdentifier.instance = 0;
-        COV_Subscriptions[index].flag.issueConfirmedNotifications = false;
-        COV_Subscriptions[index].invokeID = 0;
-        COV_Subscriptions[index].lifetime = 0;
-        COV_Subscriptions[index].flag.send_requested = false;
-    }
+    cov_store_cleanup();
 #endif
-    for (index = 0; index < MAX_COV_ADDRESSES; index++) {
-        COV_Addresses[index].valid = false;
-    }
+    MEMSTAT_FIXED(MEMSTAT_COV, COV_Store_List, sizeof(COV_Store_List));
+    MEMSTAT_FIXED(
+        MEMSTAT_COV, COV_Value_Cache_List, sizeof(COV_Value_Cache_List));
+    MEMSTAT_FREE(
+        MEMSTAT_COV, COV_Addresses_Size * sizeof(BACNET_COV_ADDRESS));
+    free(COV_Addresses);
+    COV_Addresses = NULL;
+    COV_Addresses_Size = 0;
+    Keyhash_Delete(COV_Address_Index);
+    COV_Address_Index = NULL;
+    COV_Seconds = 0;
+    handler_cov_change_driven_set(COV_Change_Driven);
 }
 
 static bool cov_list_subscribe(
@@ -400,105 +1007,104 @@ static bool cov_list_subscribe(
     BACNET_ERROR_CLASS *error_class,
     BACNET_ERROR_CODE *error_code)
 {
-    bool existing_entry = false;
-    int index;
-    int first_invalid_index = -1;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+    unsigned index = COV_INDEX_NONE;
+    int dest_index = -1;
     bool found = true;
-    bool address_match = false;
-    const BACNET_ADDRESS *dest = NULL;
-
-    /* unable to subscribe - resources? */
-    /* unable to cancel subscription - other? */
 
     /* existing? - match Object ID and Process ID and address */
-    for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-        if (COV_Subscriptions[index].flag.valid) {
-            dest = cov_address_get(COV_Subscriptions[index].dest_index);
-            if (dest) {
-                address_match = bacnet_address_same(src, dest);
-            } else {
-                /* skip address matching - we don't have an address */
-                address_match = true;
-            }
-            if ((COV_Subscriptions[index].monitoredObjectIdentifier.type ==
-                 cov_data->monitoredObjectIdentifier.type) &&
-                (COV_Subscriptions[index].monitoredObjectIdentifier.instance ==
-                 cov_data->monitoredObjectIdentifier.instance) &&
-                (COV_Subscriptions[index].subscriberProcessIdentifier ==
-                 cov_data->subscriberProcessIdentifier) &&
-                address_match) {
-                existing_entry = true;
-                if (cov_data->cancellationRequest) {
-                    /* initialize with invalid COV address */
-                    COV_Subscriptions[index].flag.valid = false;
-                    COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
-                    cov_address_remove_unused();
-                } else {
-                    COV_Subscriptions[index].dest_index = cov_address_add(src);
-                    COV_Subscriptions[index].flag.issueConfirmedNotifications =
-                        cov_data->issueConfirmedNotifications;
-                    COV_Subscriptions[index].lifetime = cov_data->lifetime;
-                    COV_Subscriptions[index].flag.send_requested = true;
-                }
-                if (COV_Subscriptions[index].invokeID) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
-                    COV_Subscriptions[index].invokeID = 0;
-                }
-                break;
-            }
+    dest_index = cov_address_find(src);
+    if (dest_index >= 0) {
+        index = cov_subscription_find(
+            dest_index, cov_data->subscriberProcessIdentifier,
+            &cov_data->monitoredObjectIdentifier);
+    }
+    if (index != COV_INDEX_NONE) {
+        if (cov_data->cancellationRequest) {
+            cov_subscription_remove(index);
         } else {
-            if (first_invalid_index < 0) {
-                first_invalid_index = index;
+            cov_subscription = &COV_Subscriptions[index];
+            cov_subscription->flag.issueConfirmedNotifications =
+                cov_data->issueConfirmedNotifications;
+            if (cov_subscription->invokeID) {
+                tsm_free_invoke_id_peer(src, cov_subscription->invokeID);
+                cov_subscription->invokeID = 0;
             }
+            cov_timer_remove(index);
+            cov_subscription->lifetime = cov_data->lifetime;
+            cov_timer_add(index);
+            cov_subscription_send_request(index);
         }
-    }
-    if (!existing_entry && (first_invalid_index >= 0) &&
-        (!cov_data->cancellationRequest)) {
-        const int addr_add_ret = cov_address_add(src);
-
-        if (addr_add_ret < 0) {
-            *error_class = ERROR_CLASS_RESOURCES;
-            *error_code = ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT;
-            found = false;
-        } else {
-            index = first_invalid_index;
-            found = true;
-            COV_Subscriptions[index].dest_index = addr_add_ret;
-            COV_Subscriptions[index].flag.valid = true;
-            COV_Subscriptions[index].monitoredObjectIdentifier.type =
+    } else if (cov_data->cancellationRequest) {
+        /* cancellationRequest - valid object not subscribed */
+        /* From BACnet Standard 135-2010-13.14.2
+           ...Cancellations that are issued for which no matching COV
+           context can be found shall succeed as if a context had
+           existed, returning 'Result(+)'. */
+        found = true;
+    } else {
+        index = cov_subscription_alloc();
+        if (index != COV_INDEX_NONE) {
+            dest_index = cov_address_add(src);
+            if (dest_index < 0) {
+                cov_subscription_free(index);
+                index = COV_INDEX_NONE;
+            }
+        }
+        if (index != COV_INDEX_NONE) {
+            cov_subscription = &COV_Subscriptions[index];
+            cov_subscription->dest_index = dest_index;
+            cov_subscription->monitoredObjectIdentifier.type =
                 cov_data->monitoredObjectIdentifier.type;
-            COV_Subscriptions[index].monitoredObjectIdentifier.instance =
+            cov_subscription->monitoredObjectIdentifier.instance =
                 cov_data->monitoredObjectIdentifier.instance;
-            COV_Subscriptions[index].subscriberProcessIdentifier =
+            cov_subscription->subscriberProcessIdentifier =
                 cov_data->subscriberProcessIdentifier;
-            COV_Subscriptions[index].flag.issueConfirmedNotifications =
-                cov_data->issueConfirmedNotifications;
-            COV_Subscriptions[index].invokeID = 0;
-            COV_Subscriptions[index].lifetime = cov_data->lifetime;
-            COV_Subscriptions[index].flag.send_requested = true;
+            if (!COV_Store.subscriber_index) {
+                COV_Store.subscriber_index = Keyhash_Create();
+            }
+            if (!Keyhash_Add(
+                    COV_Store.subscriber_index,
+                    cov_subscriber_hash(
+                        dest_index, cov_data->subscriberProcessIdentifier,
+                        &cov_data->monitoredObjectIdentifier),
+                    index)) {
+                cov_address_remove(dest_index);
+                cov_subscription_free(index);
+                index = COV_INDEX_NONE;
+            }
         }
-    } else if (!existing_entry) {
-        if (first_invalid_index < 0) {
+        if (index == COV_INDEX_NONE) {
             /* Out of resources */
             *error_class = ERROR_CLASS_RESOURCES;
             *error_code = ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT;
             found = false;
         } else {
-            /* cancellationRequest - valid object not subscribed */
-            /* From BACnet Standard 135-2010-13.14.2
-               ...Cancellations that are issued for which no matching COV
-               context can be found shall succeed as if a context had
-               existed, returning 'Result(+)'. */
-            found = true;
+            cov_subscription->flag.valid = true;
+            cov_subscription->flag.issueConfirmedNotifications =
+                cov_data->issueConfirmedNotifications;
+            cov_subscription->invokeID = 0;
+            cov_subscription->lifetime = cov_data->lifetime;
+            cov_timer_add(index);
+            cov_subscription_index_add(index);
+            cov_subscription_send_request(index);
         }
     }
 
     return found;
 }
 
+/**
+ * @brief Send the COV notification of one subscription
+ * @param cov_subscription - the subscription
+ * @param value_list - the list of values, used when there is no entry
+ * @param entry - the encoded list of values, or NULL
+ * @return true if the notification was sent
+ */
 static bool cov_send_request(
     BACNET_COV_SUBSCRIPTION *cov_subscription,
-    BACNET_PROPERTY_VALUE *value_list)
+    BACNET_PROPERTY_VALUE *value_list,
+    const BACNET_COV_VALUE_ENTRY *entry)
 {
     int len = 0;
     int pdu_len = 0;
@@ -540,19 +1146,31 @@ static bool cov_send_request(
         cov_subscription->monitoredObjectIdentifier.type;
     cov_data.monitoredObjectIdentifier.instance =
         cov_subscription->monitoredObjectIdentifier.instance;
-    cov_data.timeRemaining = cov_subscription->lifetime;
+    cov_data.timeRemaining = cov_subscription_time_remaining(cov_subscription);
     cov_data.listOfValues = value_list;
     if (cov_subscription->flag.issueConfirmedNotifications) {
-        invoke_id = tsm_next_free_invokeID();
+        invoke_id = tsm_next_free_invokeID_peer(dest);
         if (invoke_id) {
             cov_subscription->invokeID = invoke_id;
-            len = ccov_notify_encode_apdu(
-                &Handler_Transmit_Buffer[pdu_len],
-                sizeof(Handler_Transmit_Buffer) - pdu_len, invoke_id,
-                &cov_data);
+            if (entry) {
+                len = ccov_notify_encode_apdu_values(
+                    &Handler_Transmit_Buffer[pdu_len],
+                    sizeof(Handler_Transmit_Buffer) - pdu_len, invoke_id,
+                    &cov_data, &entry->values[0], entry->len);
+            } else {
+                len = ccov_notify_encode_apdu(
+                    &Handler_Transmit_Buffer[pdu_len],
+                    sizeof(Handler_Transmit_Buffer) - pdu_len, invoke_id,
+                    &cov_data);
+            }
         } else {
             goto COV_FAILED;
         }
+    } else if (entry) {
+        len = ucov_notify_encode_apdu_values(
+            &Handler_Transmit_Buffer[pdu_len],
+            sizeof(Handler_Transmit_Buffer) - pdu_len, &cov_data,
+            &entry->values[0], entry->len);
     } else {
         len = ucov_notify_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len],
@@ -568,6 +1186,13 @@ static bool cov_send_request(
         dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent > 0) {
         status = true;
+        PERFSTAT_COUNT(PERFSTAT_COV_NOTIFICATIONS);
+        BACTRACE_COV_SEND(
+            cov_subscription->flag.issueConfirmedNotifications, 1,
+            BACNET_ID_VALUE(
+                cov_subscription->monitoredObjectIdentifier.instance,
+                cov_subscription->monitoredObjectIdentifier.type),
+            cov_subscription->subscriberProcessIdentifier);
 #if PRINT_ENABLED
         debug_fprintf(stderr, "COVnotification: Sent!\n");
 #endif
@@ -578,105 +1203,754 @@ COV_FAILED:
     return status;
 }
 
-static void cov_lifetime_expiration_handler(
-    unsigned index, uint32_t elapsed_seconds, uint32_t lifetime_seconds)
+/**
+ * @brief Determine if the requested notification of a subscription
+ *  can be sent now
+ * @param index - subscription index
+ * @return true if the notification can be sent
+ */
+static bool cov_subscription_sendable(unsigned index)
+{
+    const BACNET_COV_SUBSCRIPTION *cov_subscription = &COV_Subscriptions[index];
+
+    if ((!cov_subscription->flag.valid) ||
+        (!cov_subscription->flag.send_requested)) {
+        return false;
+    }
+    if (cov_subscription->flag.issueConfirmedNotifications) {
+        if (cov_subscription->invokeID != 0) {
+            /* already sending */
+            return false;
+        }
+        if (!tsm_transaction_available()) {
+            /* no transactions available - can't send now */
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Send the requested notification of one subscription
+ * @param index - subscription index
+ * @return true if the notification was sent
+ */
+static bool cov_subscription_send(unsigned index)
 {
-    if (index < MAX_COV_SUBCRIPTIONS) {
-        /* handle lifetime expiration */
-        if (lifetime_seconds >= elapsed_seconds) {
-            COV_Subscriptions[index].lifetime -= elapsed_seconds;
-#if 0
-            fprintf(stderr, "COVtimer: subscription[%d].lifetime=%lu\n", index,
-                (unsigned long) COV_Subscriptions[index].lifetime);
+    BACNET_COV_SUBSCRIPTION *cov_subscription = &COV_Subscriptions[index];
+    BACNET_PROPERTY_VALUE value_list[MAX_COV_PROPERTIES] = { 0 };
+    const BACNET_COV_VALUE_ENTRY *entry;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    bool status = false;
+
+    object_type =
+        (BACNET_OBJECT_TYPE)cov_subscription->monitoredObjectIdentifier.type;
+    object_instance = cov_subscription->monitoredObjectIdentifier.instance;
+#if PRINT_ENABLED
+    debug_fprintf(stderr, "COVtask: Sending...\n");
 #endif
-        } else {
-            COV_Subscriptions[index].lifetime = 0;
+    entry = cov_value_cache_find(cov_subscription_object_key(index));
+    if (entry) {
+        status = true;
+    } else {
+        /* configure the linked list for the two properties */
+        bacapp_property_value_list_init(&value_list[0], MAX_COV_PROPERTIES);
+        status = Device_Encode_Value_List(
+            object_type, object_instance, &value_list[0]);
+        if (status) {
+            entry = cov_value_cache_add(
+                cov_subscription_object_key(index), &value_list[0]);
+        }
+    }
+    if (status) {
+        status = cov_send_request(cov_subscription, &value_list[0], entry);
+    }
+    if (status) {
+        cov_subscription->flag.send_requested = false;
+    }
+    if (COV_Change_Driven && cov_subscription->invokeID) {
+        cov_key_list_add(&COV_Confirmed, index);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Determine if two subscriptions notify the same subscriber
+ *  process in the same way
+ * @param index - subscription index
+ * @param other_index - other subscription index
+ * @return true if the subscriber is the same
+ */
+static bool cov_subscriber_same(unsigned index, unsigned other_index)
+{
+    const BACNET_COV_SUBSCRIPTION *cov_subscription = &COV_Subscriptions[index];
+    const BACNET_COV_SUBSCRIPTION *other = &COV_Subscriptions[other_index];
+
+    return (cov_subscription->dest_index == other->dest_index) &&
+        (cov_subscription->subscriberProcessIdentifier ==
+         other->subscriberProcessIdentifier) &&
+        (cov_subscription->flag.issueConfirmedNotifications ==
+         other->flag.issueConfirmedNotifications);
+}
+
+/**
+ * @brief Collect the subscriptions of the same subscriber that have
+ *  a notification that can be sent now
+ * @param index - subscription index of the first notification
+ * @param batch - [out] the subscription indices, starting with index
+ * @param batch_size - maximum number of subscription indices
+ * @return number of subscription indices in the batch
+ */
+static unsigned
+cov_batch_collect(unsigned index, unsigned *batch, unsigned batch_size)
+{
+    unsigned count = 0;
+    unsigned other_index;
+    KEY key = 0;
+    int i, n;
+
+    batch[count++] = index;
+    if (COV_Change_Driven) {
+        n = Keylist_Count(COV_Send);
+        for (i = 0; (i < n) && (count < batch_size); i++) {
+            if (Keylist_Index_Key(COV_Send, i, &key) &&
+                (key < COV_Store.size) && (key != index) &&
+                cov_subscriber_same(index, key) &&
+                cov_subscription_sendable(key)) {
+                batch[count++] = key;
+            }
+        }
+    } else {
+        for (other_index = 0;
+             (other_index < COV_Store.size) && (count < batch_size);
+             other_index++) {
+            if ((other_index != index) &&
+                cov_subscriber_same(index, other_index) &&
+                cov_subscription_sendable(other_index)) {
+                batch[count++] = other_index;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Send the requested notifications of a batch of subscriptions
+ *  of the same subscriber in one COVNotificationMultiple, with as many
+ *  of the objects as fit in the APDU.  The time remaining is from the
+ *  first subscription.
+ * @param batch - the subscription indices
+ * @param count - number of subscription indices in the batch
+ * @return true if the notification was sent
+ */
+static bool cov_send_multiple_request(const unsigned *batch, unsigned count)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription = &COV_Subscriptions[batch[0]];
+    BACNET_PROPERTY_VALUE value_list[MAX_COV_PROPERTIES] = { 0 };
+    bool confirmed = cov_subscription->flag.issueConfirmedNotifications;
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS my_address = { 0 };
+    BACNET_COV_DATA cov_data = { 0 };
+    BACNET_ADDRESS *dest = NULL;
+    unsigned included[COV_NOTIFICATION_BATCH_MAX];
+    unsigned included_count = 0;
+    int max_pdu_len = 0;
+    int pdu_len = 0;
+    int len = 0;
+    int bytes_sent = 0;
+    uint8_t invoke_id = 0;
+    unsigned i;
+
+    if (!dcc_communication_enabled()) {
+        return false;
+    }
+    dest = cov_address_get(cov_subscription->dest_index);
+    if (!dest) {
+        return false;
+    }
+    if (confirmed) {
+        invoke_id = tsm_next_free_invokeID_peer(dest);
+        if (!invoke_id) {
+            return false;
+        }
+    }
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, confirmed, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], dest, &my_address, &npdu_data);
+    max_pdu_len = pdu_len + MAX_APDU;
+    if (max_pdu_len > (int)sizeof(Handler_Transmit_Buffer)) {
+        max_pdu_len = (int)sizeof(Handler_Transmit_Buffer);
+    }
+    cov_data.subscriberProcessIdentifier =
+        cov_subscription->subscriberProcessIdentifier;
+    cov_data.initiatingDeviceIdentifier = Device_Object_Instance_Number();
+    cov_data.timeRemaining = cov_subscription_time_remaining(cov_subscription);
+    if (confirmed) {
+        pdu_len += ccov_notify_multiple_encode_apdu_init(
+            &Handler_Transmit_Buffer[pdu_len], invoke_id, &cov_data);
+    } else {
+        pdu_len += ucov_notify_multiple_encode_apdu_init(
+            &Handler_Transmit_Buffer[pdu_len], &cov_data);
+    }
+    for (i = 0; i < count; i++) {
+        cov_subscription = &COV_Subscriptions[batch[i]];
+        cov_data.monitoredObjectIdentifier.type =
+            cov_subscription->monitoredObjectIdentifier.type;
+        cov_data.monitoredObjectIdentifier.instance =
+            cov_subscription->monitoredObjectIdentifier.instance;
+        bacapp_property_value_list_init(&value_list[0], MAX_COV_PROPERTIES);
+        if (!Device_Encode_Value_List(
+                cov_data.monitoredObjectIdentifier.type,
+                cov_data.monitoredObjectIdentifier.instance, &value_list[0])) {
+            continue;
+        }
+        cov_data.listOfValues = &value_list[0];
+        len = cov_notify_multiple_encode_object(NULL, &cov_data);
+        if ((pdu_len + len + cov_notify_multiple_encode_end(NULL)) >
+            max_pdu_len) {
+            break;
+        }
+        pdu_len += cov_notify_multiple_encode_object(
+            &Handler_Transmit_Buffer[pdu_len], &cov_data);
+        included[included_count++] = batch[i];
+    }
+    if (included_count == 0) {
+        if (invoke_id) {
+            tsm_free_invoke_id_peer(dest, invoke_id);
+        }
+        return false;
+    }
+    pdu_len +=
+        cov_notify_multiple_encode_end(&Handler_Transmit_Buffer[pdu_len]);
+    if (confirmed) {
+        tsm_set_confirmed_unsegmented_transaction(
+            invoke_id, dest, &npdu_data, &Handler_Transmit_Buffer[0],
+            (uint16_t)pdu_len);
+        for (i = 0; i < included_count; i++) {
+            COV_Subscriptions[included[i]].invokeID = invoke_id;
+            if (COV_Change_Driven) {
+                cov_key_list_add(&COV_Confirmed, included[i]);
+            }
+        }
+    }
+#if PRINT_ENABLED
+    debug_fprintf(
+        stderr, "COVtask: Sending %u in one notification...\n",
+        included_count);
+#endif
+    bytes_sent = datalink_send_pdu(
+        dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent <= 0) {
+        return false;
+    }
+    PERFSTAT_COUNT_ADD(PERFSTAT_COV_NOTIFICATIONS, included_count);
+    BACTRACE_COV_SEND(
+        confirmed, included_count,
+        BACNET_ID_VALUE(
+            cov_subscription->monitoredObjectIdentifier.instance,
+            cov_subscription->monitoredObjectIdentifier.type),
+        cov_subscription->subscriberProcessIdentifier);
+    for (i = 0; i < included_count; i++) {
+        COV_Subscriptions[included[i]].flag.send_requested = false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Determine if two subscriptions are notified of the same object
+ *  by one unconfirmed notification to the same process identifier on
+ *  the same network
+ * @param index - subscription index
+ * @param other_index - other subscription index
+ * @return true if the subscriptions are in the same group
+ */
+static bool cov_group_same(unsigned index, unsigned other_index)
+{
+    const BACNET_COV_SUBSCRIPTION *cov_subscription = &COV_Subscriptions[index];
+    const BACNET_COV_SUBSCRIPTION *other = &COV_Subscriptions[other_index];
+    const BACNET_ADDRESS *dest;
+    const BACNET_ADDRESS *other_dest;
+
+    if ((other->flag.issueConfirmedNotifications) ||
+        (cov_subscription->subscriberProcessIdentifier !=
+         other->subscriberProcessIdentifier) ||
+        (cov_subscription->monitoredObjectIdentifier.type !=
+         other->monitoredObjectIdentifier.type) ||
+        (cov_subscription->monitoredObjectIdentifier.instance !=
+         other->monitoredObjectIdentifier.instance)) {
+        return false;
+    }
+    if (cov_subscription->dest_index == other->dest_index) {
+        return true;
+    }
+    dest = cov_address_get(cov_subscription->dest_index);
+    other_dest = cov_address_get(other->dest_index);
+    if ((!dest) || (!other_dest) || (dest->net != other_dest->net)) {
+        return false;
+    }
+    if (dest->net == 0) {
+        return true;
+    }
+    /* a remote network is reached through the same router */
+    return (dest->mac_len == other_dest->mac_len) &&
+        (memcmp(dest->mac, other_dest->mac, dest->mac_len) == 0);
+}
+
+/**
+ * @brief Collect the unconfirmed subscriptions to the same object that
+ *  share the process identifier and the network of a subscription, and
+ *  have a notification that can be sent now
+ * @param index - subscription index of the first notification
+ * @param group - [out] the subscription indices, starting with index
+ * @param group_size - maximum number of subscription indices
+ * @return number of subscription indices in the group
+ */
+static unsigned
+cov_group_collect(unsigned index, unsigned *group, unsigned group_size)
+{
+    unsigned count = 0;
+    unsigned other_index;
+    KEY object_key;
+    KEY key = 0;
+    unsigned iterator = 0;
+
+    group[count++] = index;
+    if (COV_Change_Driven) {
+        object_key = cov_subscription_object_key(index);
+        while ((count < group_size) &&
+               Keyhash_Find(COV_Object_Index, object_key, &iterator, &key)) {
+            if ((key < COV_Store.size) && (key != index) &&
+                cov_subscription_sendable(key) && cov_group_same(index, key)) {
+                group[count++] = key;
+            }
+        }
+    } else {
+        for (other_index = 0;
+             (other_index < COV_Store.size) && (count < group_size);
+             other_index++) {
+            if ((other_index != index) &&
+                cov_subscription_sendable(other_index) &&
+                cov_group_same(index, other_index)) {
+                group[count++] = other_index;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Send the requested notifications of a group of unconfirmed
+ *  subscriptions in one notification to the broadcast address of their
+ *  network.  The time remaining is the shortest of the group.
+ * @param group - the subscription indices
+ * @param count - number of subscription indices in the group
+ * @return true if the notification was sent
+ */
+static bool cov_send_group_request(const unsigned *group, unsigned count)
+{
+    const BACNET_COV_SUBSCRIPTION *cov_subscription =
+        &COV_Subscriptions[group[0]];
+    BACNET_PROPERTY_VALUE value_list[MAX_COV_PROPERTIES] = { 0 };
+    const BACNET_COV_VALUE_ENTRY *entry;
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS my_address = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_COV_DATA cov_data = { 0 };
+    const BACNET_ADDRESS *subscriber;
+    uint32_t time_remaining;
+    int pdu_len = 0;
+    int bytes_sent = 0;
+    unsigned i;
+
+    if (!dcc_communication_enabled()) {
+        return false;
+    }
+    subscriber = cov_address_get(cov_subscription->dest_index);
+    if (!subscriber) {
+        return false;
+    }
+    if (subscriber->net == 0) {
+        datalink_get_broadcast_address(&dest);
+    } else {
+        /* remote broadcast through the router of the subscribers */
+        bacnet_address_copy(&dest, subscriber);
+        dest.len = 0;
+    }
+    entry = cov_value_cache_find(cov_subscription_object_key(group[0]));
+    if (!entry) {
+        bacapp_property_value_list_init(&value_list[0], MAX_COV_PROPERTIES);
+        if (!Device_Encode_Value_List(
+                cov_subscription->monitoredObjectIdentifier.type,
+                cov_subscription->monitoredObjectIdentifier.instance,
+                &value_list[0])) {
+            return false;
+        }
+        entry = cov_value_cache_add(
+            cov_subscription_object_key(group[0]), &value_list[0]);
+    }
+    cov_data.subscriberProcessIdentifier =
+        cov_subscription->subscriberProcessIdentifier;
+    cov_data.initiatingDeviceIdentifier = Device_Object_Instance_Number();
+    cov_data.monitoredObjectIdentifier.type =
+        cov_subscription->monitoredObjectIdentifier.type;
+    cov_data.monitoredObjectIdentifier.instance =
+        cov_subscription->monitoredObjectIdentifier.instance;
+    cov_data.timeRemaining = 0;
+    for (i = 0; i < count; i++) {
+        time_remaining =
+            cov_subscription_time_remaining(&COV_Subscriptions[group[i]]);
+        if ((time_remaining != 0) &&
+            ((cov_data.timeRemaining == 0) ||
+             (time_remaining < cov_data.timeRemaining))) {
+            cov_data.timeRemaining = time_remaining;
+        }
+    }
+    cov_data.listOfValues = &value_list[0];
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], &dest, &my_address, &npdu_data);
+    if (entry) {
+        pdu_len += ucov_notify_encode_apdu_values(
+            &Handler_Transmit_Buffer[pdu_len],
+            sizeof(Handler_Transmit_Buffer) - pdu_len, &cov_data,
+            &entry->values[0], entry->len);
+    } else {
+        pdu_len += ucov_notify_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len],
+            sizeof(Handler_Transmit_Buffer) - pdu_len, &cov_data);
+    }
+#if PRINT_ENABLED
+    debug_fprintf(
+        stderr, "COVtask: Sending one notification to %u subscribers...\n",
+        count);
+#endif
+    bytes_sent = datalink_send_pdu(
+        &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent <= 0) {
+        return false;
+    }
+    PERFSTAT_COUNT(PERFSTAT_COV_NOTIFICATIONS);
+    BACTRACE_COV_SEND(
+        false, 1,
+        BACNET_ID_VALUE(
+            cov_subscription->monitoredObjectIdentifier.instance,
+            cov_subscription->monitoredObjectIdentifier.type),
+        cov_subscription->subscriberProcessIdentifier);
+    for (i = 0; i < count; i++) {
+        COV_Subscriptions[group[i]].flag.send_requested = false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Send the requested notification of one subscription, and when
+ *  batching, the other requested notifications to the same subscriber
+ *  up to the batch limit
+ * @param index - subscription index
+ * @return true if the notification of this subscription was sent
+ */
+static bool cov_subscription_notify(unsigned index)
+{
+    unsigned batch[COV_NOTIFICATION_BATCH_MAX];
+    unsigned count, i;
+
+    if (!cov_subscription_sendable(index)) {
+        return false;
+    }
+    if (COV_Notification_Group &&
+        (!COV_Subscriptions[index].flag.issueConfirmedNotifications)) {
+        count = cov_group_collect(index, batch, COV_NOTIFICATION_BATCH_MAX);
+        if ((count > 1) && cov_send_group_request(batch, count)) {
+            return true;
         }
-        if (COV_Subscriptions[index].lifetime == 0) {
+    }
+    if (COV_Notification_Batch_Limit == 0) {
+        return cov_subscription_send(index);
+    }
+    count = cov_batch_collect(index, batch, COV_Notification_Batch_Limit);
+    if (COV_Notification_Multiple && (count > 1)) {
+        (void)cov_send_multiple_request(batch, count);
+    } else {
+        /* send them back to back */
+        for (i = 0; i < count; i++) {
+            if ((i == 0) || cov_subscription_sendable(batch[i])) {
+                if (!cov_subscription_send(batch[i])) {
+                    break;
+                }
+            }
+        }
+    }
+
+    return !COV_Subscriptions[index].flag.send_requested;
+}
+
+/**
+ * @brief Set the number of requested notifications to the same subscriber
+ *  that are sent together in one pass of the COV task.  In the change
+ *  driven COV task, the notifications that are requested are sent from
+ *  a list, so batching visits far fewer subscriptions.
+ * @param limit - maximum number of notifications sent together, limited
+ *  to COV_NOTIFICATION_BATCH_MAX, or 0 to send one notification per pass
+ */
+void handler_cov_notification_batch_set(unsigned limit)
+{
+    if (limit > COV_NOTIFICATION_BATCH_MAX) {
+        limit = COV_NOTIFICATION_BATCH_MAX;
+    }
+    COV_Notification_Batch_Limit = limit;
+}
+
+/**
+ * @brief Get the number of requested notifications to the same subscriber
+ *  that are sent together in one pass of the COV task
+ * @return maximum number of notifications sent together, or 0 if disabled
+ */
+unsigned handler_cov_notification_batch(void)
+{
+    return COV_Notification_Batch_Limit;
+}
+
+/**
+ * @brief Enable or disable sending the notifications that are batched for
+ *  a subscriber in one COVNotificationMultiple, so that one confirmed
+ *  notification uses one transaction for the whole batch.  Only enable it
+ *  when the subscribers support COVNotificationMultiple.
+ * @param enable - true to send COVNotificationMultiple
+ */
+void handler_cov_notification_multiple_set(bool enable)
+{
+    COV_Notification_Multiple = enable;
+}
+
+/**
+ * @brief Determine if batched notifications are sent as
+ *  COVNotificationMultiple
+ * @return true if batched notifications are sent as COVNotificationMultiple
+ */
+bool handler_cov_notification_multiple(void)
+{
+    return COV_Notification_Multiple;
+}
+
+/**
+ * @brief Enable or disable sending one broadcast notification to the
+ *  unconfirmed subscribers of an object that share a process identifier
+ *  on the same network, instead of one notification to each of them.
+ *  The subscribers receive the notifications of the other subscribers
+ *  with their process identifier, so only enable it when the subscribers,
+ *  such as the workstations of one HMI, expect them.
+ * @param enable - true to send group notifications
+ */
+void handler_cov_notification_group_set(bool enable)
+{
+    COV_Notification_Group = enable;
+}
+
+/**
+ * @brief Determine if group notifications are sent
+ * @return true if group notifications are sent
+ */
+bool handler_cov_notification_group(void)
+{
+    return COV_Notification_Group;
+}
+
+/**
+ * @brief Expire the subscriptions in one slot of the lifetime timer wheel
+ *  that have reached the end of their lifetime
+ * @param slot - timer wheel slot
+ */
+static void cov_timer_wheel_expire(unsigned slot)
+{
+    unsigned index, next;
+
+    index = COV_Store.timer_wheel[slot];
+    while (index != COV_INDEX_NONE) {
+        next = COV_Subscriptions[index].next;
+        if ((int32_t)(COV_Subscriptions[index].expires - COV_Seconds) <= 0) {
             /* expire the subscription */
 #if PRINT_ENABLED
             debug_fprintf(
-                stderr, "COVtimer: PID=%u %s %u time remaining=%u seconds\n",
+                stderr, "COVtimer: PID=%u %s %u expired\n",
                 COV_Subscriptions[index].subscriberProcessIdentifier,
                 bactext_object_type_name(
                     COV_Subscriptions[index].monitoredObjectIdentifier.type),
-                COV_Subscriptions[index].monitoredObjectIdentifier.instance,
-                COV_Subscriptions[index].lifetime);
+                COV_Subscriptions[index].monitoredObjectIdentifier.instance);
 #endif
-            /* initialize with invalid COV address */
-            COV_Subscriptions[index].flag.valid = false;
-            COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
-            cov_address_remove_unused();
-            if (COV_Subscriptions[index].flag.issueConfirmedNotifications) {
-                if (COV_Subscriptions[index].invokeID) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
-                    COV_Subscriptions[index].invokeID = 0;
-                }
-            }
+            cov_subscription_remove(index);
         }
+        index = next;
     }
 }
 
-/** Handler to check the list of subscribed objects for any that have changed
- *  and so need to have notifications sent.
+/**
+ * @brief Expire the subscriptions of one device for the seconds that
+ *  have elapsed, checking only the timer wheel slots of those seconds
+ * @param seconds - COV_Seconds before the seconds elapsed
+ * @param elapsed_seconds - number of seconds elapsed
+ */
+static void cov_timer_wheel_task(uint32_t seconds, uint32_t elapsed_seconds)
+{
+    uint32_t i;
+
+    if (COV_Store.size == 0) {
+        return;
+    }
+    if (elapsed_seconds > COV_TIMER_WHEEL_SIZE) {
+        elapsed_seconds = COV_TIMER_WHEEL_SIZE;
+    }
+    for (i = 1; i <= elapsed_seconds; i++) {
+        cov_timer_wheel_expire((seconds + i) & COV_TIMER_WHEEL_MASK);
+    }
+}
+
+/** Handler to expire the subscriptions that have reached the end
+ *  of their lifetime.
  * @ingroup DSCOV
  * This handler will be invoked by the main program every second or so.
- * This example only handles Binary Inputs, but can be easily extended to
- * support other types.
- * For each subscribed object,
- *  - See if the subscription has timed out
- *    - Remove it if it has timed out.
- *  - See if the subscribed object instance has changed
- *    (eg, check with Binary_Input_Change_Of_Value() )
- *  - If changed,
- *    - Clear the COV (eg, Binary_Input_Change_Of_Value_Clear() )
- *    - Send the notice with cov_send_request()
- *      - Will be confirmed or unconfirmed, as per the subscription.
- *
- * @note worst case tasking: MS/TP with the ability to send only
- *        one notification per task cycle.
+ * The subscriptions with a lifetime are kept in a timer wheel by the
+ * second that they expire, so only the subscriptions that might expire
+ * in the elapsed seconds are checked.
  *
  * @param elapsed_seconds [in] How many seconds have elapsed since last called.
  */
 void handler_cov_timer_seconds(uint32_t elapsed_seconds)
 {
-    unsigned index = 0;
-    uint32_t lifetime_seconds = 0;
+    uint32_t seconds = COV_Seconds;
 #ifdef BAC_ROUTING
     uint16_t current_dev_id = Routed_Device_Object_Index();
     uint16_t dev_id = 0;
-    if (elapsed_seconds) {
-        /* handle the subscription timeouts */
-        for (dev_id = 0; dev_id < Get_Num_Managed_Devices(); dev_id++) {
-            Set_Routed_Device_Object_Index(dev_id);
-            for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-                if (COV_Subscriptions[index].flag.valid) {
-                    lifetime_seconds = COV_Subscriptions[index].lifetime;
-                    if (lifetime_seconds) {
-                        /* only expire COV with definite lifetimes */
-                        cov_lifetime_expiration_handler(
-                            index, elapsed_seconds, lifetime_seconds);
-                    }
-                }
-            }
-        }
+#endif
+
+    if (elapsed_seconds == 0) {
+        return;
+    }
+    COV_Seconds += elapsed_seconds;
+#ifdef BAC_ROUTING
+    /* handle the subscription timeouts */
+    for (dev_id = 0; dev_id < Get_Num_Managed_Devices(); dev_id++) {
+        Set_Routed_Device_Object_Index(dev_id);
+        cov_timer_wheel_task(seconds, elapsed_seconds);
     }
     Set_Routed_Device_Object_Index(current_dev_id);
 #else
-    if (elapsed_seconds) {
-        /* handle the subscription timeouts */
-        for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-            if (COV_Subscriptions[index].flag.valid) {
-                lifetime_seconds = COV_Subscriptions[index].lifetime;
-                if (lifetime_seconds) {
-                    /* only expire COV with definite lifetimes */
-                    cov_lifetime_expiration_handler(
-                        index, elapsed_seconds, lifetime_seconds);
+    /* handle the subscription timeouts */
+    cov_timer_wheel_task(seconds, elapsed_seconds);
+#endif
+}
+
+/**
+ * @brief Change driven COV task: check one changed object, one confirmed
+ *  notification, and one requested notification on each call.
+ * @return true when the changed objects and the requested notifications
+ *  have each been checked once
+ */
+static bool cov_change_driven_fsm(void)
+{
+    static int send_indices[MAX_NUM_DEVICES] = { 0 };
+    static int confirmed_indices[MAX_NUM_DEVICES] = { 0 };
+#ifdef BAC_ROUTING
+    const int dev_id = Routed_Device_Object_Index();
+#else
+    const int dev_id = 0;
+#endif
+    BACNET_OBJECT_TYPE object_type = MAX_BACNET_OBJECT_TYPE;
+    uint32_t object_instance = 0;
+    unsigned iterator = 0;
+    KEY object_key = 0;
+    KEY key = 0;
+    BACNET_ADDRESS *dest = NULL;
+    bool status = false;
+    bool done = true;
+    int index = 0;
+
+    /* mark the subscriptions of one changed object, or of all the
+       changed objects when batching so that the notifications to each
+       subscriber are requested before they are sent */
+    while (Keylist_Index_Key(COV_Changed_Objects, 0, &object_key)) {
+        (void)Keylist_Data_Delete_By_Index(COV_Changed_Objects, 0);
+        object_type = (BACNET_OBJECT_TYPE)KEY_DECODE_TYPE(object_key);
+        object_instance = KEY_DECODE_ID(object_key);
+        if (Device_COV(object_type, object_instance)) {
+            iterator = 0;
+            while (Keyhash_Find(
+                COV_Object_Index, object_key, &iterator, &key)) {
+                if ((key < COV_Store.size) &&
+                    (COV_Subscriptions[key].flag.valid)) {
+#if PRINT_ENABLED
+                    debug_fprintf(stderr, "COVtask: Marking...\n");
+#endif
+                    cov_subscription_send_request(key);
                 }
             }
+            Device_COV_Clear(object_type, object_instance);
+        }
+        done = false;
+        if (COV_Notification_Batch_Limit == 0) {
+            break;
         }
     }
-#endif
+    /* confirmed notification house keeping */
+    index = confirmed_indices[dev_id];
+    if (index >= Keylist_Count(COV_Confirmed)) {
+        index = 0;
+    }
+    if (Keylist_Index_Key(COV_Confirmed, index, &key)) {
+        status = true;
+        if ((key < COV_Store.size) &&
+            (COV_Subscriptions[key].flag.valid) &&
+            (COV_Subscriptions[key].invokeID)) {
+            dest = cov_address_get(COV_Subscriptions[key].dest_index);
+            if (tsm_invoke_id_free_peer(
+                    dest, COV_Subscriptions[key].invokeID)) {
+                COV_Subscriptions[key].invokeID = 0;
+            } else if (tsm_invoke_id_failed_peer(
+                           dest, COV_Subscriptions[key].invokeID)) {
+                tsm_free_invoke_id_peer(
+                    dest, COV_Subscriptions[key].invokeID);
+                COV_Subscriptions[key].invokeID = 0;
+            } else {
+                /* still waiting - check it again later */
+                status = false;
+            }
+        }
+        if (status) {
+            (void)Keylist_Data_Delete_By_Index(COV_Confirmed, index);
+        } else {
+            index++;
+        }
+    }
+    confirmed_indices[dev_id] = index;
+    /* send one of the requested notifications */
+    index = send_indices[dev_id];
+    if (index >= Keylist_Count(COV_Send)) {
+        index = 0;
+    } else if (Keylist_Index_Key(COV_Send, index, &key)) {
+        if ((key >= COV_Store.size) ||
+            (!COV_Subscriptions[key].flag.valid) ||
+            (!COV_Subscriptions[key].flag.send_requested)) {
+            (void)Keylist_Data_Delete_By_Index(COV_Send, index);
+        } else {
+            if (cov_subscription_notify(key)) {
+                (void)Keylist_Data_Delete_By_Index(COV_Send, index);
+            } else {
+                index++;
+            }
+        }
+        done = false;
+    }
+    send_indices[dev_id] = index;
+
+    return done;
 }
 
 bool handler_cov_fsm(void)
@@ -690,9 +1964,8 @@ bool handler_cov_fsm(void)
 
     BACNET_OBJECT_TYPE object_type = MAX_BACNET_OBJECT_TYPE;
     uint32_t object_instance = 0;
+    BACNET_ADDRESS *dest = NULL;
     bool status = false;
-    bool send = false;
-    BACNET_PROPERTY_VALUE value_list[MAX_COV_PROPERTIES] = { 0 };
 
     /* states for transmitting */
     typedef enum cov_fsm_state {
@@ -709,13 +1982,22 @@ bool handler_cov_fsm(void)
     int index = indices[dev_id];
     cov_fsm_state_t cov_task_state = cov_task_states[dev_id];
 
+    if (COV_Change_Driven) {
+        return cov_change_driven_fsm();
+    }
+    if (index >= (int)COV_Store.size) {
+        /* no subscriptions yet, or fewer than before */
+        indices[dev_id] = 0;
+        cov_task_states[dev_id] = COV_STATE_IDLE;
+        return true;
+    }
     switch (cov_task_state) {
         case COV_STATE_IDLE:
             if (COV_Subscriptions[index].flag.valid) {
                 cov_task_state = COV_STATE_MARK;
             } else {
                 index++;
-                if (index >= MAX_COV_SUBCRIPTIONS) {
+                if (index >= (int)COV_Store.size) {
                     index = 0;
                 }
             }
@@ -729,6 +2011,8 @@ bool handler_cov_fsm(void)
                     COV_Subscriptions[index].monitoredObjectIdentifier.instance;
                 status = Device_COV(object_type, object_instance);
                 if (status) {
+                    cov_value_cache_invalidate(
+                        KEY_ENCODE(object_type, object_instance));
                     COV_Subscriptions[index].flag.send_requested = true;
 #if PRINT_ENABLED
                     debug_fprintf(stderr, "COVtask: Marking...\n");
@@ -736,7 +2020,7 @@ bool handler_cov_fsm(void)
                 }
             }
             index++;
-            if (index >= MAX_COV_SUBCRIPTIONS) {
+            if (index >= (int)COV_Store.size) {
                 index = 0;
                 cov_task_state = COV_STATE_CLEAR;
             }
@@ -752,7 +2036,7 @@ bool handler_cov_fsm(void)
                 Device_COV_Clear(object_type, object_instance);
             }
             index++;
-            if (index >= MAX_COV_SUBCRIPTIONS) {
+            if (index >= (int)COV_Store.size) {
                 index = 0;
                 cov_task_state = COV_STATE_FREE;
             }
@@ -762,16 +2046,19 @@ bool handler_cov_fsm(void)
             if ((COV_Subscriptions[index].flag.valid) &&
                 (COV_Subscriptions[index].flag.issueConfirmedNotifications) &&
                 (COV_Subscriptions[index].invokeID)) {
-                if (tsm_invoke_id_free(COV_Subscriptions[index].invokeID)) {
+                dest = cov_address_get(COV_Subscriptions[index].dest_index);
+                if (tsm_invoke_id_free_peer(
+                        dest, COV_Subscriptions[index].invokeID)) {
                     COV_Subscriptions[index].invokeID = 0;
-                } else if (tsm_invoke_id_failed(
-                               COV_Subscriptions[index].invokeID)) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
+                } else if (tsm_invoke_id_failed_peer(
+                               dest, COV_Subscriptions[index].invokeID)) {
+                    tsm_free_invoke_id_peer(
+                        dest, COV_Subscriptions[index].invokeID);
                     COV_Subscriptions[index].invokeID = 0;
                 }
             }
             index++;
-            if (index >= MAX_COV_SUBCRIPTIONS) {
+            if (index >= (int)COV_Store.size) {
                 index = 0;
                 cov_task_state = COV_STATE_SEND;
             }
@@ -780,41 +2067,10 @@ bool handler_cov_fsm(void)
             /* send any COVs that are requested */
             if ((COV_Subscriptions[index].flag.valid) &&
                 (COV_Subscriptions[index].flag.send_requested)) {
-                send = true;
-                if (COV_Subscriptions[index].flag.issueConfirmedNotifications) {
-                    if (COV_Subscriptions[index].invokeID != 0) {
-                        /* already sending */
-                        send = false;
-                    }
-                    if (!tsm_transaction_available()) {
-                        /* no transactions available - can't send now */
-                        send = false;
-                    }
-                }
-                if (send) {
-                    object_type = (BACNET_OBJECT_TYPE)COV_Subscriptions[index]
-                                      .monitoredObjectIdentifier.type;
-                    object_instance = COV_Subscriptions[index]
-                                          .monitoredObjectIdentifier.instance;
-#if PRINT_ENABLED
-                    debug_fprintf(stderr, "COVtask: Sending...\n");
-#endif
-                    /* configure the linked list for the two properties */
-                    bacapp_property_value_list_init(
-                        &value_list[0], MAX_COV_PROPERTIES);
-                    status = Device_Encode_Value_List(
-                        object_type, object_instance, &value_list[0]);
-                    if (status) {
-                        status = cov_send_request(
-                            &COV_Subscriptions[index], &value_list[0]);
-                    }
-                    if (status) {
-                        COV_Subscriptions[index].flag.send_requested = false;
-                    }
-                }
+                (void)cov_subscription_notify(index);
             }
             index++;
-            if (index >= MAX_COV_SUBCRIPTIONS) {
+            if (index >= (int)COV_Store.size) {
                 index = 0;
                 cov_task_state = COV_STATE_IDLE;
             }
@@ -37,6 +37,27 @@ BACNET_STACK_EXPORT
 void handler_cov_init(void);
 BACNET_STACK_EXPORT
 int handler_cov_encode_subscriptions(uint8_t *apdu, int max_apdu);
+BACNET_STACK_EXPORT
+unsigned handler_cov_subscription_count(void);
+BACNET_STACK_EXPORT
+void handler_cov_object_changed(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+void handler_cov_change_driven_set(bool enable);
+BACNET_STACK_EXPORT
+bool handler_cov_change_driven(void);
+BACNET_STACK_EXPORT
+void handler_cov_notification_batch_set(unsigned limit);
+BACNET_STACK_EXPORT
+unsigned handler_cov_notification_batch(void);
+BACNET_STACK_EXPORT
+void handler_cov_notification_multiple_set(bool enable);
+BACNET_STACK_EXPORT
+bool handler_cov_notification_multiple(void);
+BACNET_STACK_EXPORT
+void handler_cov_notification_group_set(bool enable);
+BACNET_STACK_EXPORT
+bool handler_cov_notification_group(void);
 
 #ifdef __cplusplus
 }
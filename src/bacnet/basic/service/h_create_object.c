@@ -49,7 +49,7 @@ void handler_create_object(
     BACNET_ADDRESS *src,
     BACNET_CONFIRMED_SERVICE_DATA *service_data)
 {
-    BACNET_CREATE_OBJECT_DATA data = { 0 };
+    BACNET_CREATE_OBJECT_DATA *data;
     BACNET_NPDU_DATA npdu_data = { 0 };
     BACNET_ADDRESS my_address = { 0 };
     int len = 0;
@@ -63,7 +63,14 @@ void handler_create_object(
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
     debug_print("CreateObject: Received Request!\n");
-    if (service_len == 0) {
+    data = apdu_scratch_alloc(sizeof(BACNET_CREATE_OBJECT_DATA));
+    if (!data) {
+        len = abort_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
+            ABORT_REASON_OUT_OF_RESOURCES, true);
+        debug_print("CreateObject: Out of scratch memory. Sending Abort!\n");
+        status = false;
+    } else if (service_len == 0) {
         len = reject_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
             REJECT_REASON_MISSING_REQUIRED_PARAMETER);
@@ -80,12 +87,12 @@ void handler_create_object(
     if (status) {
         /* decode the service request only */
         len = create_object_decode_service_request(
-            service_request, service_len, &data);
+            service_request, service_len, data);
         if (len > 0) {
             debug_printf_stderr(
                 "CreateObject: type=%lu instance=%lu\n",
-                (unsigned long)data.object_type,
-                (unsigned long)data.object_instance);
+                (unsigned long)data->object_type,
+                (unsigned long)data->object_instance);
         } else {
             debug_print("CreateObject: Unable to decode request!\n");
         }
@@ -94,24 +101,24 @@ void handler_create_object(
             if (len == BACNET_STATUS_ABORT) {
                 len = abort_encode_apdu(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                    abort_convert_error_code(data.error_code), true);
+                    abort_convert_error_code(data->error_code), true);
                 debug_print("CreateObject: Sending Abort!\n");
             } else if (len == BACNET_STATUS_REJECT) {
                 len = reject_encode_apdu(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                    reject_convert_error_code(data.error_code));
+                    reject_convert_error_code(data->error_code));
                 debug_print("CreateObject: Sending Reject!\n");
             }
         } else {
-            if (Device_Create_Object(&data)) {
+            if (Device_Create_Object(data)) {
                 len = create_object_ack_encode(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                    &data);
+                    data);
                 debug_print("CreateObject: Sending ACK!\n");
             } else {
                 len = create_object_error_ack_encode(
                     &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                    &data);
+                    data);
                 debug_print("CreateObject: Sending Error!\n");
             }
         }
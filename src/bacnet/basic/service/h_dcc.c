@@ -89,7 +89,7 @@ void handler_device_communication_control(
 {
     uint16_t timeDuration = 0;
     BACNET_COMMUNICATION_ENABLE_DISABLE state = COMMUNICATION_ENABLE;
-    BACNET_CHARACTER_STRING password;
+    BACNET_CHARACTER_STRING *password;
     int len = 0;
     int pdu_len = 0;
     BACNET_NPDU_DATA npdu_data;
@@ -101,6 +101,15 @@ void handler_device_communication_control(
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
     debug_print("DeviceCommunicationControl!\n");
+    password = apdu_scratch_alloc(sizeof(BACNET_CHARACTER_STRING));
+    if (!password) {
+        len = abort_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
+            ABORT_REASON_OUT_OF_RESOURCES, true);
+        debug_print("DeviceCommunicationControl: "
+                    "Out of scratch memory. Sending Abort!\n");
+        goto DCC_FAILURE;
+    }
     if (service_len == 0) {
         len = reject_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
@@ -118,14 +127,14 @@ void handler_device_communication_control(
     }
     /* decode the service request only */
     len = dcc_decode_service_request(
-        service_request, service_len, &timeDuration, &state, &password);
+        service_request, service_len, &timeDuration, &state, password);
     if (len > 0) {
         debug_fprintf(
             stderr,
             "DeviceCommunicationControl: "
             "timeout=%u state=%u password=%s\n",
             (unsigned)timeDuration, (unsigned)state,
-            characterstring_value(&password));
+            characterstring_value(password));
     }
     /* bad decoding or invalid service parameter
        send an abort or reject */
@@ -174,7 +183,7 @@ void handler_device_communication_control(
         }
 #endif
         if ((My_Password[0] == '\0') ||
-            characterstring_ansi_same(&password, My_Password)) {
+            characterstring_ansi_same(password, My_Password)) {
             len = encode_simple_ack(
                 &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
                 SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL);
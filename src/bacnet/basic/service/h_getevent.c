@@ -25,9 +25,22 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/keylist.h"
 #include "bacnet/datalink/datalink.h"
 
 static get_event_info_function Get_Event_Info[MAX_BACNET_OBJECT_TYPE];
+/* instance to index of the object types that report their active event
+   states with handler_get_event_information_active_set() */
+static get_event_info_index_function
+    Get_Event_Info_Index[MAX_BACNET_OBJECT_TYPE];
+/* objects with an active event state, by object key, for each device,
+   so that the services only visit the active objects of those types */
+static OS_Keylist Event_Active_List[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define Event_Active (Event_Active_List[Routed_Device_Object_Index()])
+#else
+#define Event_Active (Event_Active_List[0])
+#endif
 
 /**
  * @brief print the data for a GetEventInformation service request
@@ -72,6 +85,167 @@ void handler_get_event_information_set(
     }
 }
 
+/**
+ * @brief Set the instance to index function of an object type that
+ *  reports its active event states with
+ *  handler_get_event_information_active_set().  The GetEventInformation
+ *  and GetAlarmSummary services then visit only the objects of that type
+ *  with an active event state, instead of every object of that type.
+ * @param object_type [in] The BACNET_OBJECT_TYPE to set the function for.
+ * @param pFunction [in] The instance to index function of the object type,
+ *  or NULL to visit every object of that type.
+ */
+void handler_get_event_information_index_set(
+    BACNET_OBJECT_TYPE object_type, get_event_info_index_function pFunction)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        Get_Event_Info_Index[object_type] = pFunction;
+    }
+}
+
+/**
+ * @brief Determine if the objects of a type report their active event
+ *  states with handler_get_event_information_active_set()
+ * @param object_type [in] The BACNET_OBJECT_TYPE
+ * @return true if the active objects of the type are listed
+ */
+bool handler_get_event_information_indexed(BACNET_OBJECT_TYPE object_type)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        return Get_Event_Info_Index[object_type] != NULL;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Report a change of the active event state of an object.
+ *  An object has an active event state when its Event_State is not
+ *  NORMAL, or when one of its Acked_Transitions is FALSE.
+ * @param object_type [in] The BACNET_OBJECT_TYPE of the object
+ * @param object_instance [in] The object instance of the object
+ * @param active [in] true if the object has an active event state
+ */
+void handler_get_event_information_active_set(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool active)
+{
+    KEY key;
+
+    if ((object_type >= MAX_BACNET_OBJECT_TYPE) ||
+        (object_instance > BACNET_MAX_INSTANCE)) {
+        return;
+    }
+    key = KEY_ENCODE(object_type, object_instance);
+    if (active) {
+        if (!Event_Active) {
+            Event_Active = Keylist_Create();
+        }
+        if (Keylist_Index(Event_Active, key) < 0) {
+            (void)Keylist_Data_Add(Event_Active, key, NULL);
+        }
+    } else {
+        (void)Keylist_Data_Delete(Event_Active, key);
+    }
+}
+
+/**
+ * @brief Find the position of the first active object with a key that is
+ *  not less than a key
+ * @param key [in] The object key
+ * @return position in the list of active objects
+ */
+static int handler_get_event_information_active_position(KEY key)
+{
+    int left = 0;
+    int right = Keylist_Count(Event_Active);
+    int middle = 0;
+    KEY middle_key = 0;
+
+    while (left < right) {
+        middle = left + ((right - left) / 2);
+        (void)Keylist_Index_Key(Event_Active, middle, &middle_key);
+        if (middle_key < key) {
+            left = middle + 1;
+        } else {
+            right = middle;
+        }
+    }
+
+    return left;
+}
+
+/**
+ * @brief Find the next object of a type with an active event state
+ * @param object_type [in] The BACNET_OBJECT_TYPE to find
+ * @param object_instance [in,out] The first object instance to look at,
+ *  and the object instance that was found
+ * @param index [out] The index of the object that was found
+ * @return true if an object was found, false if there are no more active
+ *  objects of the type, or if the type does not list its active objects
+ */
+bool handler_get_event_information_active_next(
+    BACNET_OBJECT_TYPE object_type, uint32_t *object_instance, unsigned *index)
+{
+    int position;
+    KEY key = 0;
+
+    if (!handler_get_event_information_indexed(object_type) ||
+        (*object_instance > BACNET_MAX_INSTANCE)) {
+        return false;
+    }
+    position = handler_get_event_information_active_position(
+        KEY_ENCODE(object_type, *object_instance));
+    if (!Keylist_Index_Key(Event_Active, position, &key) ||
+        ((BACNET_OBJECT_TYPE)KEY_DECODE_TYPE(key) != object_type)) {
+        return false;
+    }
+    *object_instance = KEY_DECODE_ID(key);
+    *index = Get_Event_Info_Index[object_type](*object_instance);
+
+    return true;
+}
+
+/**
+ * @brief Encode the event summary of an object into the
+ *  GetEventInformation-ACK in the transmit buffer
+ * @param getevent_data [in] The event summary of the object
+ * @param pdu_len [in,out] The length of the PDU so far
+ * @param apdu_len [in,out] The length of the APDU so far
+ * @param max_resp [in] The maximum APDU accepted by the client
+ * @return number of bytes encoded, 0 if the ACK is full, or
+ *  BACNET_STATUS_ERROR or BACNET_STATUS_ABORT
+ */
+static int handler_get_event_information_encode(
+    BACNET_GET_EVENT_INFORMATION_DATA *getevent_data,
+    int *pdu_len,
+    int *apdu_len,
+    uint16_t max_resp)
+{
+    int len;
+
+    getevent_data->next = NULL;
+    len = getevent_ack_encode_apdu_data(
+        &Handler_Transmit_Buffer[*pdu_len],
+        sizeof(Handler_Transmit_Buffer) - *pdu_len, getevent_data);
+    if (len < 0) {
+        return len;
+    } else if (len == 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    *apdu_len += len;
+    if ((*apdu_len >= max_resp - 2) || (*apdu_len >= MAX_APDU - 2)) {
+        /* Device must be able to fit minimum one event information.
+           Length of one event information needs more than 50 octets. */
+        if ((max_resp < 128) || (MAX_APDU < 128)) {
+            return BACNET_STATUS_ABORT;
+        }
+        return 0;
+    }
+    *pdu_len += len;
+
+    return len;
+}
+
 /**
  * @brief Handle a GetEventInformation service request.
  * @details The GetEventInformation service is used by a client BACnet-user to
@@ -103,6 +277,9 @@ void handler_get_event_information(
     BACNET_ADDRESS my_address;
     BACNET_OBJECT_ID object_id;
     unsigned i = 0, j = 0; /* counter */
+    unsigned index = 0;
+    uint32_t instance = 0, first_instance = 0;
+    bool indexed = false;
     BACNET_GET_EVENT_INFORMATION_DATA getevent_data = { 0 };
     int valid_event = 0;
 
@@ -143,56 +320,47 @@ void handler_get_event_information(
     }
     pdu_len += len;
     apdu_len = len;
-    for (i = 0; i < MAX_BACNET_OBJECT_TYPE; i++) {
-        if (Get_Event_Info[i]) {
-            for (j = 0; j < 0xffff; j++) {
-                valid_event = Get_Event_Info[i](j, &getevent_data);
-                if (valid_event > 0) {
-                    /* encode GetEvent_data only when type of object_id has max
-                     * value */
-                    if (object_id.type != MAX_BACNET_OBJECT_TYPE) {
-                        if ((object_id.type ==
-                             getevent_data.objectIdentifier.type) &&
-                            (object_id.instance ==
-                             getevent_data.objectIdentifier.instance)) {
-                            /* found 'Last Received Object Identifier'
-                               so should set type of object_id to max value */
-                            object_id.type = MAX_BACNET_OBJECT_TYPE;
-                        }
-                        continue;
-                    }
-
-                    getevent_data.next = NULL;
-                    len = getevent_ack_encode_apdu_data(
-                        &Handler_Transmit_Buffer[pdu_len],
-                        sizeof(Handler_Transmit_Buffer) - pdu_len,
-                        &getevent_data);
-                    if (len <= 0) {
-                        error = true;
-                        goto GET_EVENT_ERROR;
-                    }
-                    apdu_len += len;
-                    if ((apdu_len >= service_data->max_resp - 2) ||
-                        (apdu_len >= MAX_APDU - 2)) {
-                        /* Device must be able to fit minimum
-                           one event information.
-                           Length of one event information needs
-                           more than 50 octets. */
-                        if ((service_data->max_resp < 128) ||
-                            (MAX_APDU < 128)) {
-                            len = BACNET_STATUS_ABORT;
-                            error = true;
-                            goto GET_EVENT_ERROR;
-                        } else {
-                            more_events = true;
-                        }
-                        break;
-                    } else {
-                        pdu_len += len;
-                    }
-                } else if (valid_event < 0) {
+    for (i = 0; (i < MAX_BACNET_OBJECT_TYPE) && !more_events; i++) {
+        if (!Get_Event_Info[i]) {
+            continue;
+        }
+        /* continue after the 'Last Received Object Identifier' */
+        if ((object_id.type != MAX_BACNET_OBJECT_TYPE) &&
+            (i < object_id.type)) {
+            continue;
+        }
+        first_instance = 0;
+        if (i == object_id.type) {
+            first_instance = object_id.instance + 1;
+        }
+        indexed = handler_get_event_information_indexed(i);
+        instance = first_instance;
+        for (j = 0; (j < 0xffff) && !more_events; j++) {
+            if (indexed) {
+                /* only the objects with an active event state */
+                if (!handler_get_event_information_active_next(
+                        i, &instance, &index)) {
                     break;
                 }
+                instance++;
+            } else {
+                index = j;
+            }
+            valid_event = Get_Event_Info[i](index, &getevent_data);
+            if ((valid_event < 0) && !indexed) {
+                break;
+            }
+            if ((valid_event > 0) &&
+                (getevent_data.objectIdentifier.instance >= first_instance)) {
+                len = handler_get_event_information_encode(
+                    &getevent_data, &pdu_len, &apdu_len,
+                    service_data->max_resp);
+                if (len < 0) {
+                    error = true;
+                    goto GET_EVENT_ERROR;
+                } else if (len == 0) {
+                    more_events = true;
+                }
             }
         }
     }
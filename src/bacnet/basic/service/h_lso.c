@@ -31,7 +31,7 @@ void handler_lso(
     BACNET_ADDRESS *src,
     BACNET_CONFIRMED_SERVICE_DATA *service_data)
 {
-    BACNET_LSO_DATA data;
+    BACNET_LSO_DATA *data;
     int len = 0;
     int pdu_len = 0;
     BACNET_NPDU_DATA npdu_data;
@@ -43,6 +43,14 @@ void handler_lso(
     npdu_encode_npdu_data(&npdu_data, false, service_data->priority);
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    data = apdu_scratch_alloc(sizeof(BACNET_LSO_DATA));
+    if (!data) {
+        len = abort_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
+            ABORT_REASON_OUT_OF_RESOURCES, true);
+        debug_print("LSO: Out of scratch memory. Sending Abort!\n");
+        goto LSO_ABORT;
+    }
     if (service_len == 0) {
         len = reject_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
@@ -58,7 +66,7 @@ void handler_lso(
         goto LSO_ABORT;
     }
 
-    len = lso_decode_service_request(service_request, service_len, &data);
+    len = lso_decode_service_request(service_request, service_len, data);
     if (len <= 0) {
         debug_print("LSO: Unable to decode Request!\n");
     }
@@ -78,8 +86,8 @@ void handler_lso(
         stderr,
         "Life Safety Operation: Received operation %d from process id %lu "
         "for object %lu\n",
-        data.operation, (unsigned long)data.processId,
-        (unsigned long)data.targetObject.instance);
+        data->operation, (unsigned long)data->processId,
+        (unsigned long)data->targetObject.instance);
     len = encode_simple_ack(
         &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
         SERVICE_CONFIRMED_LIFE_SAFETY_OPERATION);
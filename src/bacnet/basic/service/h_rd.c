@@ -52,7 +52,7 @@ void handler_reinitialize_device(
     BACNET_ADDRESS *src,
     BACNET_CONFIRMED_SERVICE_DATA *service_data)
 {
-    BACNET_REINITIALIZE_DEVICE_DATA rd_data = { 0 };
+    BACNET_REINITIALIZE_DEVICE_DATA *rd_data;
     int len = 0;
     int pdu_len = 0;
     BACNET_NPDU_DATA npdu_data = { 0 };
@@ -64,6 +64,15 @@ void handler_reinitialize_device(
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
     debug_print("ReinitializeDevice!\n");
+    rd_data = apdu_scratch_alloc(sizeof(BACNET_REINITIALIZE_DEVICE_DATA));
+    if (!rd_data) {
+        len = abort_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
+            ABORT_REASON_OUT_OF_RESOURCES, true);
+        debug_print("ReinitializeDevice: "
+                    "Out of scratch memory. Sending Abort!\n");
+        goto RD_ABORT;
+    }
     if (service_len == 0) {
         len = reject_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
@@ -80,13 +89,13 @@ void handler_reinitialize_device(
     }
     /* decode the service request only */
     len = rd_decode_service_request(
-        service_request, service_len, &rd_data.state, &rd_data.password);
+        service_request, service_len, &rd_data->state, &rd_data->password);
     if (len > 0) {
         debug_fprintf(
             stderr, "ReinitializeDevice: state=%u password=%*s\n",
-            (unsigned)rd_data.state,
-            (int)characterstring_length(&rd_data.password),
-            characterstring_value(&rd_data.password));
+            (unsigned)rd_data->state,
+            (int)characterstring_length(&rd_data->password),
+            characterstring_value(&rd_data->password));
     } else {
         debug_print("ReinitializeDevice: Unable to decode request!\n");
     }
@@ -99,7 +108,7 @@ void handler_reinitialize_device(
         goto RD_ABORT;
     }
     /* check the data from the request */
-    if (rd_data.state >= BACNET_REINIT_MAX) {
+    if (rd_data->state >= BACNET_REINIT_MAX) {
         len = reject_encode_apdu(
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
             REJECT_REASON_UNDEFINED_ENUMERATION);
@@ -109,13 +118,13 @@ void handler_reinitialize_device(
 #ifdef BAC_ROUTING
         /* Check to see if the current Device supports this service. */
         len = Routed_Device_Service_Approval(
-            SERVICE_SUPPORTED_REINITIALIZE_DEVICE, (int)rd_data.state,
+            SERVICE_SUPPORTED_REINITIALIZE_DEVICE, (int)rd_data->state,
             &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id);
         if (len > 0) {
             goto RD_ABORT;
         }
 #endif
-        if (Device_Reinitialize(&rd_data)) {
+        if (Device_Reinitialize(rd_data)) {
             len = encode_simple_ack(
                 &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
                 SERVICE_CONFIRMED_REINITIALIZE_DEVICE);
@@ -123,8 +132,8 @@ void handler_reinitialize_device(
         } else {
             len = bacerror_encode_apdu(
                 &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                SERVICE_CONFIRMED_REINITIALIZE_DEVICE, rd_data.error_class,
-                rd_data.error_code);
+                SERVICE_CONFIRMED_REINITIALIZE_DEVICE, rd_data->error_class,
+                rd_data->error_code);
             debug_print("ReinitializeDevice: Sending Error.\n");
         }
     }
@@ -32,48 +32,45 @@
 
 /** @file h_rp.c  Handles Read Property requests. */
 
-/** Handler for a ReadProperty Service request.
- * @ingroup DSRP
- * This handler will be invoked by apdu_handler() if it has been enabled
- * by a call to apdu_set_confirmed_handler().
- * This handler builds a response packet, which is
- * - an Abort if
- *   - the message is segmented
- *   - if decoding fails
- *   - if the response would be too large
- * - the result from Device_Read_Property(), if it succeeds
- * - an Error if Device_Read_Property() fails
- *   or there isn't enough room in the APDU to fit the data.
+/**
+ * @brief Encode the reply to a ReadProperty Service request
+ *
+ * The reply is the same as what handler_read_property() sends, encoded
+ * into the given buffer instead of the handler transmit buffer, so that
+ * it can be used by a thread other than the one that calls npdu_handler().
  *
+ * @param pdu [out] Buffer for the NPDU of the reply
+ * @param pdu_size [in] Size of the buffer, at least MAX_PDU bytes
  * @param service_request [in] The contents of the service request.
  * @param service_len [in] The length of the service_request.
  * @param src [in] BACNET_ADDRESS of the source of the message
  * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
  *                          decoded from the APDU header of this message.
+ * @param npdu_data [out] The NPDU data for sending the reply
+ * @return number of bytes encoded into the buffer
  */
-void handler_read_property(
+int handler_read_property_encode(
+    uint8_t *pdu,
+    uint16_t pdu_size,
     uint8_t *service_request,
     uint16_t service_len,
     BACNET_ADDRESS *src,
-    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    BACNET_NPDU_DATA *npdu_data)
 {
     BACNET_READ_PROPERTY_DATA rpdata;
     int len = 0;
-    int pdu_len = 0;
     int apdu_len = -1;
     int npdu_len = -1;
-    BACNET_NPDU_DATA npdu_data;
     bool error = true; /* assume that there is an error */
-    int bytes_sent = 0;
     BACNET_ADDRESS my_address;
 
     /* configure default error code as an abort since it is common */
     rpdata.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
     /* encode the NPDU portion of the packet */
     datalink_get_my_address(&my_address);
-    npdu_encode_npdu_data(&npdu_data, false, service_data->priority);
-    npdu_len = npdu_encode_pdu(
-        &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    npdu_encode_npdu_data(npdu_data, false, service_data->priority);
+    npdu_len = npdu_encode_pdu(&pdu[0], src, &my_address, npdu_data);
     if (npdu_len <= 0) {
         /* If 0 or negative, there were problems with the data or encoding. */
         len = BACNET_STATUS_ABORT;
@@ -117,13 +114,10 @@ void handler_read_property(
             }
 #endif
             apdu_len = rp_ack_encode_apdu_init(
-                &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
-                &rpdata);
+                &pdu[npdu_len], service_data->invoke_id, &rpdata);
             /* configure our storage */
-            rpdata.application_data =
-                &Handler_Transmit_Buffer[npdu_len + apdu_len];
-            rpdata.application_data_len =
-                sizeof(Handler_Transmit_Buffer) - (npdu_len + apdu_len);
+            rpdata.application_data = &pdu[npdu_len + apdu_len];
+            rpdata.application_data_len = pdu_size - (npdu_len + apdu_len);
             if (!read_property_bacnet_array_valid(&rpdata)) {
                 len = BACNET_STATUS_ERROR;
             } else {
@@ -132,7 +126,7 @@ void handler_read_property(
             if (len >= 0) {
                 apdu_len += len;
                 len = rp_ack_encode_apdu_object_property_end(
-                    &Handler_Transmit_Buffer[npdu_len + apdu_len]);
+                    &pdu[npdu_len + apdu_len]);
                 apdu_len += len;
                 if (apdu_len > service_data->max_resp) {
                     /* too big for the sender - send an abort!
@@ -164,25 +158,71 @@ void handler_read_property(
     if (error) {
         if (len == BACNET_STATUS_ABORT) {
             apdu_len = abort_encode_apdu(
-                &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
+                &pdu[npdu_len], service_data->invoke_id,
                 abort_convert_error_code(rpdata.error_code), true);
             debug_print("RP: Sending Abort!\n");
         } else if (len == BACNET_STATUS_ERROR) {
             apdu_len = bacerror_encode_apdu(
-                &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
+                &pdu[npdu_len], service_data->invoke_id,
                 SERVICE_CONFIRMED_READ_PROPERTY, rpdata.error_class,
                 rpdata.error_code);
             debug_print("RP: Sending Error!\n");
         } else if (len == BACNET_STATUS_REJECT) {
             apdu_len = reject_encode_apdu(
-                &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
+                &pdu[npdu_len], service_data->invoke_id,
                 reject_convert_error_code(rpdata.error_code));
             debug_print("RP: Sending Reject!\n");
         }
     }
-    pdu_len = npdu_len + apdu_len;
-    bytes_sent = datalink_send_pdu(
-        src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+
+    return npdu_len + apdu_len;
+}
+
+/** Handler for a ReadProperty Service request.
+ * @ingroup DSRP
+ * This handler will be invoked by apdu_handler() if it has been enabled
+ * by a call to apdu_set_confirmed_handler().
+ * This handler builds a response packet, which is
+ * - an Abort if
+ *   - the message is segmented
+ *   - if decoding fails
+ *   - if the response would be too large
+ * - the result from Device_Read_Property(), if it succeeds
+ * - an Error if Device_Read_Property() fails
+ *   or there isn't enough room in the APDU to fit the data.
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_read_property(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    BACNET_NPDU_DATA npdu_data;
+    uint8_t *pdu = &Handler_Transmit_Buffer[0];
+    uint16_t pdu_size = sizeof(Handler_Transmit_Buffer);
+    int pdu_len = 0;
+    int bytes_sent = 0;
+
+#if BACNET_SEGMENTATION_ENABLED
+    pdu = tsm_segmented_reply_buffer(src, service_data, &pdu_size);
+    if (!pdu) {
+        pdu = &Handler_Transmit_Buffer[0];
+    }
+#endif
+    pdu_len = handler_read_property_encode(
+        pdu, pdu_size, service_request, service_len, src, service_data,
+        &npdu_data);
+#if BACNET_SEGMENTATION_ENABLED
+    bytes_sent = tsm_segmented_reply_send(src, &npdu_data, pdu, pdu_len);
+#else
+    bytes_sent = datalink_send_pdu(src, &npdu_data, pdu, pdu_len);
+#endif
     if (bytes_sent <= 0) {
         debug_perror("RP: Failed to send PDU");
     }
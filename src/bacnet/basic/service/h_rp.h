@@ -19,6 +19,7 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/apdu.h"
+#include "bacnet/npdu.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,15 @@ void handler_read_property(
     uint16_t service_len,
     BACNET_ADDRESS *src,
     BACNET_CONFIRMED_SERVICE_DATA *service_data);
+BACNET_STACK_EXPORT
+int handler_read_property_encode(
+    uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    BACNET_NPDU_DATA *npdu_data);
 
 #ifdef __cplusplus
 }
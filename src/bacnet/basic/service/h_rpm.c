@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -31,9 +32,30 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#if BACNET_RPM_CACHE_ENABLED
+#include "bacnet/basic/sys/keyhash.h"
+#include "bacnet/basic/sys/mstimer.h"
+#endif
 #include "bacnet/datalink/datalink.h"
 
-static uint8_t Temp_Buf[MAX_APDU] = { 0 };
+#if BACNET_RPM_CACHE_ENABLED
+/* optional cache of the encoded responses, so that the same request
+   polled again while nothing was written is answered with a copy */
+struct rpm_cache_entry {
+    bool valid;
+    uint32_t digest;
+    uint32_t device_instance;
+    uint32_t changes;
+    uint16_t max_apdu;
+    unsigned long timestamp;
+    uint16_t request_len;
+    uint8_t request[BACNET_RPM_CACHE_REQUEST_MAX];
+    uint16_t apdu_len;
+    uint8_t apdu[BACNET_RPM_CACHE_APDU_MAX];
+};
+static struct rpm_cache_entry *RPM_Cache;
+static uint16_t RPM_Cache_Milliseconds;
+#endif
 
 /**
  * @brief Fetches the lists of properties (array of BACNET_PROPERTY_ID's) for
@@ -121,26 +143,33 @@ static int RPM_Encode_Property(
     uint8_t *apdu, uint16_t offset, uint16_t max_apdu, BACNET_RPM_DATA *rpmdata)
 {
     int len = 0;
-    size_t copy_len = 0;
     int apdu_len = 0;
+    unsigned value_offset = 0;
     BACNET_READ_PROPERTY_DATA rpdata;
 
     len = rpm_ack_encode_apdu_object_property(
-        &Temp_Buf[0], rpmdata->object_property, rpmdata->array_index);
-    copy_len = memcopy(&apdu[0], &Temp_Buf[0], offset, len, max_apdu);
-    if (copy_len == 0) {
+        NULL, rpmdata->object_property, rpmdata->array_index);
+    if (!memcopylen(offset, max_apdu, len)) {
         rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
         return BACNET_STATUS_ABORT;
     }
-    apdu_len += len;
+    apdu_len += rpm_ack_encode_apdu_object_property(
+        &apdu[offset], rpmdata->object_property, rpmdata->array_index);
     rpdata.error_class = ERROR_CLASS_OBJECT;
     rpdata.error_code = ERROR_CODE_UNKNOWN_OBJECT;
     rpdata.object_type = rpmdata->object_type;
     rpdata.object_instance = rpmdata->object_instance;
     rpdata.object_property = rpmdata->object_property;
     rpdata.array_index = rpmdata->array_index;
-    rpdata.application_data = &Temp_Buf[0];
-    rpdata.application_data_len = sizeof(Temp_Buf);
+    /* the value is read in place, after its opening tag,
+       leaving room for its closing tag */
+    value_offset = offset + apdu_len + 1;
+    rpdata.application_data = &apdu[value_offset];
+    if ((value_offset + 1) < max_apdu) {
+        rpdata.application_data_len = max_apdu - (value_offset + 1);
+    } else {
+        rpdata.application_data_len = 0;
+    }
 
     if ((rpmdata->object_property == PROP_ALL) ||
         (rpmdata->object_property == PROP_REQUIRED) ||
@@ -149,6 +178,10 @@ static int RPM_Encode_Property(
         len = BACNET_STATUS_ERROR;
     } else if (!read_property_bacnet_array_valid(&rpdata)) {
         len = BACNET_STATUS_ERROR;
+    } else if (rpdata.application_data_len == 0) {
+        /* no room for any value */
+        rpdata.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        len = BACNET_STATUS_ABORT;
     } else {
         len = Device_Read_Property(&rpdata);
     }
@@ -159,20 +192,20 @@ static int RPM_Encode_Property(
             /* pass along aborts and rejects for now */
             return len; /* Ie, Abort */
         }
-        /* error was returned - encode that for the response */
+        /* error was returned - encode that for the response,
+           over anything that was read in place */
         len = rpm_ack_encode_apdu_object_property_error(
-            &Temp_Buf[0], rpdata.error_class, rpdata.error_code);
-        copy_len =
-            memcopy(&apdu[0], &Temp_Buf[0], offset + apdu_len, len, max_apdu);
-
-        if (copy_len == 0) {
+            NULL, rpdata.error_class, rpdata.error_code);
+        if (!memcopylen(offset + apdu_len, max_apdu, len)) {
             rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
             return BACNET_STATUS_ABORT;
         }
-    } else if ((offset + apdu_len + 1 + len + 1) < max_apdu) {
+        len = rpm_ack_encode_apdu_object_property_error(
+            &apdu[offset + apdu_len], rpdata.error_class, rpdata.error_code);
+    } else if ((value_offset + len + 1) <= max_apdu) {
         /* enough room to fit the property value and tags */
         len = rpm_ack_encode_apdu_object_property_value(
-            &apdu[offset + apdu_len], &Temp_Buf[0], len);
+            &apdu[offset + apdu_len], rpdata.application_data, len);
     } else {
         /* not enough room - abort! */
         rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
@@ -183,50 +216,214 @@ static int RPM_Encode_Property(
     return apdu_len;
 }
 
-/** Handler for a ReadPropertyMultiple Service request.
- * @ingroup DSRPM
- * This handler will be invoked by apdu_handler() if it has been enabled
- * by a call to apdu_set_confirmed_handler().
- * This handler builds a response packet, which is
- * - an Abort if
- *   - the message is segmented
- *   - if decoding fails
- *   - if the response would be too large
- * - the result from each included read request, if it succeeds
- * - an Error if processing fails for all, or individual errors if only some
- * fail, or there isn't enough room in the APDU to fit the data.
- *
+#if BACNET_RPM_CACHE_ENABLED
+/**
+ * @brief Find the cache entry of a request
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param digest [out] the digest of the request
+ * @return the entry where the response of the request is kept, or NULL
+ *  when the cache is disabled or the request is too long to keep
+ */
+static struct rpm_cache_entry *RPM_Cache_Entry(
+    const uint8_t *service_request, uint16_t service_len, uint32_t *digest)
+{
+    if (!RPM_Cache || (service_len == 0) ||
+        (service_len > BACNET_RPM_CACHE_REQUEST_MAX)) {
+        return NULL;
+    }
+    *digest = Keyhash_FNV1a(service_request, service_len);
+
+    return &RPM_Cache[*digest % BACNET_RPM_CACHE_SIZE];
+}
+
+/**
+ * @brief Copy the cached response of a request, when it is still current
+ * @param apdu [out] buffer for the response
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param invoke_id [in] invoke ID of the request
+ * @param max_apdu [in] size of the response that the sender accepts
+ * @return number of bytes copied, or 0 if the request must be run
+ */
+static int RPM_Cache_Read(
+    uint8_t *apdu,
+    const uint8_t *service_request,
+    uint16_t service_len,
+    uint8_t invoke_id,
+    uint16_t max_apdu)
+{
+    const struct rpm_cache_entry *entry;
+    uint32_t digest = 0;
+
+    entry = RPM_Cache_Entry(service_request, service_len, &digest);
+    if (!entry || !entry->valid || (entry->digest != digest) ||
+        (entry->max_apdu != max_apdu) ||
+        (entry->device_instance != Device_Object_Instance_Number()) ||
+        (entry->changes != Device_Property_Cache_Changes()) ||
+        ((mstimer_now() - entry->timestamp) >= RPM_Cache_Milliseconds) ||
+        (entry->request_len != service_len) ||
+        (memcmp(entry->request, service_request, service_len) != 0)) {
+        return 0;
+    }
+    memcpy(apdu, entry->apdu, entry->apdu_len);
+    /* the ACK differs only in the invoke ID of the request */
+    apdu[1] = invoke_id;
+
+    return entry->apdu_len;
+}
+
+/**
+ * @brief Keep the encoded response of a request
+ * @param apdu [in] the encoded ReadPropertyMultiple-ACK
+ * @param apdu_len [in] number of bytes in the response
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param max_apdu [in] size of the response that the sender accepts
+ */
+static void RPM_Cache_Store(
+    const uint8_t *apdu,
+    int apdu_len,
+    const uint8_t *service_request,
+    uint16_t service_len,
+    uint16_t max_apdu)
+{
+    struct rpm_cache_entry *entry;
+    uint32_t digest = 0;
+
+    entry = RPM_Cache_Entry(service_request, service_len, &digest);
+    if (!entry || (apdu_len <= 0) || (apdu_len > BACNET_RPM_CACHE_APDU_MAX)) {
+        return;
+    }
+    entry->valid = true;
+    entry->digest = digest;
+    entry->device_instance = Device_Object_Instance_Number();
+    entry->changes = Device_Property_Cache_Changes();
+    entry->max_apdu = max_apdu;
+    entry->timestamp = mstimer_now();
+    entry->request_len = service_len;
+    memcpy(entry->request, service_request, service_len);
+    entry->apdu_len = (uint16_t)apdu_len;
+    memcpy(entry->apdu, apdu, (size_t)apdu_len);
+}
+
+#endif
+
+/**
+ * @brief Enable or disable the cache of the encoded responses
+ * @details When enabled, the ReadPropertyMultiple-ACK of a request is kept,
+ *  and the same request from any client is answered with a copy of it,
+ *  with the invoke ID of the request, until it is older than the given
+ *  time, or until a WriteProperty, CreateObject, DeleteObject, or
+ *  Device_Property_Cache_Invalidate() changes the device.  Values that
+ *  the application changes directly, such as a Present_Value that is
+ *  updated from a sensor, are as old as the given time at most.
+ * @note Replies are only kept by handler_read_property_multiple(), on the
+ *  thread that calls npdu_handler().  Other threads, such as the BACnet/IP
+ *  workers, only copy from the cache with
+ *  handler_read_property_multiple_encode(), while that thread does not
+ *  change it, for example by holding bip_workers_lock().
+ * @param milliseconds [in] time that a response is used, or 0 to disable
+ *  the cache and free it
+ * @return true if the cache is enabled
+ */
+bool handler_read_property_multiple_cache_enable(uint16_t milliseconds)
+{
+#if BACNET_RPM_CACHE_ENABLED
+    RPM_Cache_Milliseconds = milliseconds;
+    if (milliseconds) {
+        if (!RPM_Cache) {
+            RPM_Cache = calloc(
+                BACNET_RPM_CACHE_SIZE, sizeof(struct rpm_cache_entry));
+        }
+        handler_read_property_multiple_cache_invalidate();
+    } else {
+        free(RPM_Cache);
+        RPM_Cache = NULL;
+    }
+
+    return RPM_Cache != NULL;
+#else
+    (void)milliseconds;
+    return false;
+#endif
+}
+
+/**
+ * @brief Discard the cached responses
+ */
+void handler_read_property_multiple_cache_invalidate(void)
+{
+#if BACNET_RPM_CACHE_ENABLED
+    unsigned i;
+
+    if (!RPM_Cache) {
+        return;
+    }
+    for (i = 0; i < BACNET_RPM_CACHE_SIZE; i++) {
+        RPM_Cache[i].valid = false;
+    }
+#endif
+}
+
+/**
+ * @brief Encode the reply to a ReadPropertyMultiple Service request
+ * @param pdu [out] Buffer for the NPDU of the reply
+ * @param pdu_size [in] Size of the buffer, at least MAX_PDU bytes
  * @param service_request [in] The contents of the service request.
  * @param service_len [in] The length of the service_request.
  * @param src [in] BACNET_ADDRESS of the source of the message
  * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
  *                          decoded from the APDU header of this message.
+ * @param npdu_data [out] The NPDU data for sending the reply
+ * @param cache_store [in] true to keep the reply in the response cache,
+ *  which is only done by the thread that calls npdu_handler()
+ * @return number of bytes encoded into the buffer, or 0 if there is
+ *  nothing to send
  */
-void handler_read_property_multiple(
+static int read_property_multiple_encode(
+    uint8_t *pdu,
+    uint16_t pdu_size,
     uint8_t *service_request,
     uint16_t service_len,
     BACNET_ADDRESS *src,
-    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    BACNET_NPDU_DATA *npdu_data,
+    bool cache_store)
 {
     bool berror = false;
     int len = 0;
-    uint16_t copy_len = 0;
     uint16_t decode_len = 0;
     int pdu_len = 0;
-    BACNET_NPDU_DATA npdu_data;
-    int bytes_sent;
     BACNET_ADDRESS my_address;
     BACNET_RPM_DATA rpmdata;
     int apdu_len = 0;
     int npdu_len = 0;
     int tag_len = 0;
     int error = 0;
+    uint16_t max_apdu = MAX_APDU;
 
+#if !BACNET_RPM_CACHE_ENABLED
+    (void)cache_store;
+#endif
     if (service_data) {
         datalink_get_my_address(&my_address);
-        npdu_encode_npdu_data(&npdu_data, false, service_data->priority);
-        npdu_len = npdu_encode_pdu(
-            &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+        npdu_encode_npdu_data(npdu_data, false, service_data->priority);
+        npdu_len = npdu_encode_pdu(&pdu[0], src, &my_address, npdu_data);
+        if ((pdu_size - npdu_len) < max_apdu) {
+            max_apdu = pdu_size - npdu_len;
+        }
+#if BACNET_SEGMENTATION_ENABLED
+        if (pdu_size > MAX_PDU) {
+            /* a buffer larger than one PDU is for a segmented reply */
+            max_apdu = pdu_size - npdu_len;
+        }
+#endif
+        /* encode within what the sender accepts, so that a reply
+           that is too big is aborted as soon as it is known */
+        if (service_data->max_resp < max_apdu) {
+            max_apdu = service_data->max_resp;
+        }
         if (service_len == 0) {
             rpmdata.error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
             error = BACNET_STATUS_REJECT;
@@ -235,11 +432,18 @@ void handler_read_property_multiple(
             rpmdata.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
             error = BACNET_STATUS_ABORT;
             debug_print("RPM: Segmented message. Sending Abort!\r\n");
+#if BACNET_RPM_CACHE_ENABLED
+        } else if (
+            (apdu_len = RPM_Cache_Read(
+                 &pdu[npdu_len], service_request, service_len,
+                 service_data->invoke_id, max_apdu)) > 0) {
+            debug_print("RPM: Sending the cached response.\n");
+#endif
         } else {
             /* decode apdu request & encode apdu reply
                encode complex ack, invoke id, service choice */
             apdu_len = rpm_ack_encode_apdu_init(
-                &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id);
+                &pdu[npdu_len], service_data->invoke_id);
 
             for (;;) {
                 /* Start by looking for an object ID */
@@ -280,11 +484,8 @@ void handler_read_property_multiple(
                 }
 #endif
                 /* Stick this object id into the reply - if it will fit */
-                len = rpm_ack_encode_apdu_object_begin(&Temp_Buf[0], &rpmdata);
-                copy_len = memcopy(
-                    &Handler_Transmit_Buffer[npdu_len], &Temp_Buf[0], apdu_len,
-                    len, MAX_APDU);
-                if (copy_len == 0) {
+                len = rpm_ack_encode_apdu_object_begin(NULL, &rpmdata);
+                if (!memcopylen(apdu_len, max_apdu, len)) {
                     debug_print("RPM: Response too big!\n");
                     rpmdata.error_code =
                         ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
@@ -292,7 +493,8 @@ void handler_read_property_multiple(
                     berror = true;
                     break;
                 }
-                apdu_len += copy_len;
+                apdu_len += rpm_ack_encode_apdu_object_begin(
+                    &pdu[npdu_len + apdu_len], &rpmdata);
                 /* do each property of this object of the RPM request */
                 for (;;) {
                     /* Fetch a property */
@@ -321,8 +523,8 @@ void handler_read_property_multiple(
                         if (!Device_Valid_Object_Id(
                                 rpmdata.object_type, rpmdata.object_instance)) {
                             len = RPM_Encode_Property(
-                                &Handler_Transmit_Buffer[npdu_len],
-                                (uint16_t)apdu_len, MAX_APDU, &rpmdata);
+                                &pdu[npdu_len], (uint16_t)apdu_len, max_apdu,
+                                &rpmdata);
                             if (len > 0) {
                                 apdu_len += len;
                             } else {
@@ -337,14 +539,12 @@ void handler_read_property_multiple(
                             /* No array index options for this special property.
                                Encode error for this object property response */
                             len = rpm_ack_encode_apdu_object_property(
-                                &Temp_Buf[0], rpmdata.object_property,
+                                NULL, rpmdata.object_property,
                                 rpmdata.array_index);
-
-                            copy_len = memcopy(
-                                &Handler_Transmit_Buffer[npdu_len],
-                                &Temp_Buf[0], apdu_len, len, MAX_APDU);
-
-                            if (copy_len == 0) {
+                            len += rpm_ack_encode_apdu_object_property_error(
+                                NULL, ERROR_CLASS_PROPERTY,
+                                ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY);
+                            if (!memcopylen(apdu_len, max_apdu, len)) {
                                 debug_print(
                                     "RPM: Too full to encode property!\n");
                                 rpmdata.error_code =
@@ -356,25 +556,13 @@ void handler_read_property_multiple(
                                 break;
                             }
 
+                            len = rpm_ack_encode_apdu_object_property(
+                                &pdu[npdu_len + apdu_len],
+                                rpmdata.object_property, rpmdata.array_index);
                             apdu_len += len;
                             len = rpm_ack_encode_apdu_object_property_error(
-                                &Temp_Buf[0], ERROR_CLASS_PROPERTY,
+                                &pdu[npdu_len + apdu_len], ERROR_CLASS_PROPERTY,
                                 ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY);
-
-                            copy_len = memcopy(
-                                &Handler_Transmit_Buffer[npdu_len],
-                                &Temp_Buf[0], apdu_len, len, MAX_APDU);
-
-                            if (copy_len == 0) {
-                                debug_print("RPM: Too full to encode error!\n");
-                                rpmdata.error_code =
-                                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-                                error = BACNET_STATUS_ABORT;
-                                /* The berror flag ensures that
-                                   both loops will be broken! */
-                                berror = true;
-                                break;
-                            }
                             apdu_len += len;
                         } else {
                             special_object_property = rpmdata.object_property;
@@ -396,8 +584,8 @@ void handler_read_property_multiple(
                                         rpmdata.object_type,
                                         rpmdata.object_instance)) {
                                     len = RPM_Encode_Property(
-                                        &Handler_Transmit_Buffer[npdu_len],
-                                        (uint16_t)apdu_len, MAX_APDU, &rpmdata);
+                                        &pdu[npdu_len], (uint16_t)apdu_len,
+                                        max_apdu, &rpmdata);
                                     if (len > 0) {
                                         apdu_len += len;
                                     } else {
@@ -418,8 +606,8 @@ void handler_read_property_multiple(
                                             &property_list,
                                             special_object_property, index);
                                     len = RPM_Encode_Property(
-                                        &Handler_Transmit_Buffer[npdu_len],
-                                        (uint16_t)apdu_len, MAX_APDU, &rpmdata);
+                                        &pdu[npdu_len], (uint16_t)apdu_len,
+                                        max_apdu, &rpmdata);
                                     if (len > 0) {
                                         apdu_len += len;
                                     } else {
@@ -437,8 +625,8 @@ void handler_read_property_multiple(
                     } else {
                         /* handle an individual property */
                         len = RPM_Encode_Property(
-                            &Handler_Transmit_Buffer[npdu_len],
-                            (uint16_t)apdu_len, MAX_APDU, &rpmdata);
+                            &pdu[npdu_len], (uint16_t)apdu_len, max_apdu,
+                            &rpmdata);
                         if (len > 0) {
                             apdu_len += len;
                         } else {
@@ -458,11 +646,8 @@ void handler_read_property_multiple(
                         /* Reached end of property list so cap the result list
                          */
                         decode_len += tag_len;
-                        len = rpm_ack_encode_apdu_object_end(&Temp_Buf[0]);
-                        copy_len = memcopy(
-                            &Handler_Transmit_Buffer[npdu_len], &Temp_Buf[0],
-                            apdu_len, len, MAX_APDU);
-                        if (copy_len == 0) {
+                        len = rpm_ack_encode_apdu_object_end(NULL);
+                        if (!memcopylen(apdu_len, max_apdu, len)) {
                             debug_print(
                                 "RPM: Too full to encode object end!\n");
                             rpmdata.error_code =
@@ -473,7 +658,8 @@ void handler_read_property_multiple(
                             berror = true;
                             break;
                         } else {
-                            apdu_len += copy_len;
+                            apdu_len += rpm_ack_encode_apdu_object_end(
+                                &pdu[npdu_len + apdu_len]);
                         }
                         /* finished with this property list */
                         break;
@@ -487,42 +673,126 @@ void handler_read_property_multiple(
                     break;
                 }
             }
-            /* If not having an error so far, check the remaining space. */
-            if (!berror) {
-                if (apdu_len > service_data->max_resp) {
-                    /* too big for the sender - send an abort */
-                    rpmdata.error_code =
-                        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-                    error = BACNET_STATUS_ABORT;
-                    debug_print("RPM: Message too large.  Sending Abort!\n");
-                }
+#if BACNET_RPM_CACHE_ENABLED
+            if (!error && cache_store) {
+                RPM_Cache_Store(
+                    &pdu[npdu_len], apdu_len, service_request, service_len,
+                    max_apdu);
             }
+#endif
         }
         /* Error fallback. */
         if (error) {
             if (error == BACNET_STATUS_ABORT) {
                 apdu_len = abort_encode_apdu(
-                    &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
+                    &pdu[npdu_len], service_data->invoke_id,
                     abort_convert_error_code(rpmdata.error_code), true);
                 debug_print("RPM: Sending Abort!\n");
             } else if (error == BACNET_STATUS_ERROR) {
                 apdu_len = bacerror_encode_apdu(
-                    &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
+                    &pdu[npdu_len], service_data->invoke_id,
                     SERVICE_CONFIRMED_READ_PROP_MULTIPLE, rpmdata.error_class,
                     rpmdata.error_code);
                 debug_print("RPM: Sending Error!\n");
             } else if (error == BACNET_STATUS_REJECT) {
                 apdu_len = reject_encode_apdu(
-                    &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
+                    &pdu[npdu_len], service_data->invoke_id,
                     reject_convert_error_code(rpmdata.error_code));
                 debug_print("RPM: Sending Reject!\n");
             }
         }
         pdu_len = apdu_len + npdu_len;
-        bytes_sent = datalink_send_pdu(
-            src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    }
+
+    return pdu_len;
+}
+
+/**
+ * @brief Encode the reply to a ReadPropertyMultiple Service request
+ *
+ * The reply is the same as what handler_read_property_multiple() sends,
+ * encoded into the given buffers instead of the handler transmit buffer,
+ * so that it can be used by a thread other than the one that calls
+ * npdu_handler().  The reply may be copied from the response cache, but
+ * is not kept in it, so that readers on several threads at once do not
+ * change the cache; only handler_read_property_multiple() keeps replies.
+ *
+ * @param pdu [out] Buffer for the NPDU of the reply
+ * @param pdu_size [in] Size of the buffer, at least MAX_PDU bytes
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ * @param npdu_data [out] The NPDU data for sending the reply
+ * @return number of bytes encoded into the buffer, or 0 if there is
+ *  nothing to send
+ */
+int handler_read_property_multiple_encode(
+    uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    BACNET_NPDU_DATA *npdu_data)
+{
+    return read_property_multiple_encode(
+        pdu, pdu_size, service_request, service_len, src, service_data,
+        npdu_data, false);
+}
+
+/** Handler for a ReadPropertyMultiple Service request.
+ * @ingroup DSRPM
+ * This handler will be invoked by apdu_handler() if it has been enabled
+ * by a call to apdu_set_confirmed_handler().
+ * This handler builds a response packet, which is
+ * - an Abort if
+ *   - the message is segmented
+ *   - if decoding fails
+ *   - if the response would be too large
+ * - the result from each included read request, if it succeeds
+ * - an Error if processing fails for all, or individual errors if only some
+ * fail, or there isn't enough room in the APDU to fit the data.
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_read_property_multiple(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    BACNET_NPDU_DATA npdu_data;
+    uint8_t *pdu = &Handler_Transmit_Buffer[0];
+    uint16_t pdu_size = sizeof(Handler_Transmit_Buffer);
+    int pdu_len = 0;
+    int bytes_sent;
+
+#if BACNET_SEGMENTATION_ENABLED
+    pdu = tsm_segmented_reply_buffer(src, service_data, &pdu_size);
+    if (!pdu) {
+        pdu = &Handler_Transmit_Buffer[0];
+    }
+#endif
+    pdu_len = read_property_multiple_encode(
+        pdu, pdu_size, service_request, service_len, src, service_data,
+        &npdu_data, true);
+#if BACNET_SEGMENTATION_ENABLED
+    bytes_sent = tsm_segmented_reply_send(src, &npdu_data, pdu, pdu_len);
+    if ((pdu_len > 0) && (bytes_sent <= 0)) {
+        debug_perror("RPM: Failed to send PDU");
+    }
+#else
+    if (pdu_len > 0) {
+        bytes_sent = datalink_send_pdu(src, &npdu_data, pdu, pdu_len);
         if (bytes_sent <= 0) {
             debug_perror("RPM: Failed to send PDU");
         }
     }
+#endif
 }
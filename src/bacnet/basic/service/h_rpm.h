@@ -19,6 +19,24 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/apdu.h"
+#include "bacnet/npdu.h"
+
+/* cache of the encoded responses, for the same request polled again.
+   It uses Device_Property_Cache_Changes() of the Device object. */
+#ifndef BACNET_RPM_CACHE_ENABLED
+#define BACNET_RPM_CACHE_ENABLED 0
+#endif
+/* number of responses in the response cache */
+#ifndef BACNET_RPM_CACHE_SIZE
+#define BACNET_RPM_CACHE_SIZE 8
+#endif
+/* longest request, and longest response, that are kept in the cache */
+#ifndef BACNET_RPM_CACHE_REQUEST_MAX
+#define BACNET_RPM_CACHE_REQUEST_MAX 128
+#endif
+#ifndef BACNET_RPM_CACHE_APDU_MAX
+#define BACNET_RPM_CACHE_APDU_MAX MAX_APDU
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +48,19 @@ void handler_read_property_multiple(
     uint16_t service_len,
     BACNET_ADDRESS *src,
     BACNET_CONFIRMED_SERVICE_DATA *service_data);
+BACNET_STACK_EXPORT
+int handler_read_property_multiple_encode(
+    uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    BACNET_NPDU_DATA *npdu_data);
+BACNET_STACK_EXPORT
+bool handler_read_property_multiple_cache_enable(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void handler_read_property_multiple_cache_invalidate(void);
 
 #ifdef __cplusplus
 }
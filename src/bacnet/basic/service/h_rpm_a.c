@@ -5,6 +5,7 @@
  * @date 2008
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -20,6 +21,7 @@
 /* some demo stuff needed */
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/arena.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
@@ -27,19 +29,57 @@
 #define PRINTF debug_printf_stdout
 #define PERROR debug_printf_stderr
 
+/**
+ * @brief Get cleared memory for the decoded RPM data
+ * @param arena [in] arena that the memory is carved from, or NULL for
+ *  the heap
+ * @param size [in] number of bytes
+ * @param failed [out] set to true if there was no memory
+ * @return pointer to the memory, or NULL if there was no memory
+ */
+static void *rpm_ack_alloc(OS_Arena arena, size_t size, bool *failed)
+{
+    void *memory;
+
+    if (arena) {
+        memory = Arena_Alloc(arena, size);
+    } else {
+        memory = calloc(1, size);
+    }
+    if (!memory) {
+        *failed = true;
+    }
+
+    return memory;
+}
+
+/**
+ * @brief Free memory of the decoded RPM data that is not used
+ * @param arena [in] arena that the memory was carved from, which takes
+ *  it back with the rest of the arena, or NULL for the heap
+ * @param memory [in] the memory
+ */
+static void rpm_ack_free(OS_Arena arena, void *memory)
+{
+    if (!arena) {
+        free(memory);
+    }
+}
+
 /** Decode the received RPM data and make a linked list of the results.
- * @ingroup DSRPM
- *
  * @param apdu [in] The received apdu data.
  * @param apdu_len [in] Total length of the apdu.
  * @param read_access_data [out] Pointer to the head of the linked list
  *          where the RPM data is to be stored.
+ * @param arena [in] arena that the list is carved from, or NULL for the
+ *          heap
  * @return The number of bytes decoded, or -1 on error
  */
-int rpm_ack_decode_service_request(
+static int rpm_ack_decode_list(
     const uint8_t *apdu,
     int apdu_len,
-    BACNET_READ_ACCESS_DATA *read_access_data)
+    BACNET_READ_ACCESS_DATA *read_access_data,
+    OS_Arena arena)
 {
     int decoded_len = 0; /* return value */
     uint32_t error_value = 0; /* decoded error value */
@@ -53,6 +93,7 @@ int rpm_ack_decode_service_request(
     BACNET_PROPERTY_REFERENCE *old_rpm_property;
     BACNET_APPLICATION_DATA_VALUE *value;
     BACNET_APPLICATION_DATA_VALUE *old_value;
+    bool alloc_failed = false;
 
     if (!read_access_data) {
         return 0;
@@ -67,7 +108,7 @@ int rpm_ack_decode_service_request(
             old_rpm_object->next = NULL;
             if (rpm_object != read_access_data) {
                 /* don't free original */
-                free(rpm_object);
+                rpm_ack_free(arena, rpm_object);
                 rpm_object = NULL;
             }
             break;
@@ -75,7 +116,8 @@ int rpm_ack_decode_service_request(
         decoded_len += len;
         apdu_len -= len;
         apdu += len;
-        rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+        rpm_property = rpm_ack_alloc(
+            arena, sizeof(BACNET_PROPERTY_REFERENCE), &alloc_failed);
         rpm_object->listOfProperties = rpm_property;
         old_rpm_property = rpm_property;
         while (rpm_property && apdu_len) {
@@ -88,7 +130,7 @@ int rpm_ack_decode_service_request(
                     /* was this the only property in the list? */
                     rpm_object->listOfProperties = NULL;
                 }
-                free(rpm_property);
+                rpm_ack_free(arena, rpm_property);
                 rpm_property = NULL;
                 break;
             }
@@ -102,7 +144,9 @@ int rpm_ack_decode_service_request(
                 decoded_len += tag_len;
                 apdu_len -= tag_len;
                 apdu += tag_len;
-                value = calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                value = rpm_ack_alloc(
+                    arena, sizeof(BACNET_APPLICATION_DATA_VALUE),
+                    &alloc_failed);
                 rpm_property->value = value;
                 if (apdu_len &&
                     bacnet_is_closing_tag_number(apdu, apdu_len, 4, &tag_len)) {
@@ -153,8 +197,9 @@ int rpm_ack_decode_service_request(
                             break;
                         } else if (len > 0) {
                             old_value = value;
-                            value = calloc(
-                                1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                            value = rpm_ack_alloc(
+                                arena, sizeof(BACNET_APPLICATION_DATA_VALUE),
+                                &alloc_failed);
                             old_value->next = value;
                         } else {
                             PERROR(
@@ -213,7 +258,8 @@ int rpm_ack_decode_service_request(
                 }
             }
             old_rpm_property = rpm_property;
-            rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+            rpm_property = rpm_ack_alloc(
+                arena, sizeof(BACNET_PROPERTY_REFERENCE), &alloc_failed);
             old_rpm_property->next = rpm_property;
         }
         len = rpm_decode_object_end(apdu, apdu_len);
@@ -224,14 +270,61 @@ int rpm_ack_decode_service_request(
         }
         if (apdu_len) {
             old_rpm_object = rpm_object;
-            rpm_object = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+            rpm_object = rpm_ack_alloc(
+                arena, sizeof(BACNET_READ_ACCESS_DATA), &alloc_failed);
             old_rpm_object->next = rpm_object;
         }
     }
+    if (alloc_failed && apdu_len) {
+        /* out of memory before the end of the data */
+        return BACNET_STATUS_ERROR;
+    }
 
     return decoded_len;
 }
 
+/** Decode the received RPM data and make a linked list of the results.
+ * @ingroup DSRPM
+ *
+ * @param apdu [in] The received apdu data.
+ * @param apdu_len [in] Total length of the apdu.
+ * @param read_access_data [out] Pointer to the head of the linked list
+ *          where the RPM data is to be stored.
+ * @return The number of bytes decoded, or -1 on error
+ */
+int rpm_ack_decode_service_request(
+    const uint8_t *apdu,
+    int apdu_len,
+    BACNET_READ_ACCESS_DATA *read_access_data)
+{
+    return rpm_ack_decode_list(apdu, apdu_len, read_access_data, NULL);
+}
+
+/** Decode the received RPM data and make a linked list of the results,
+ * carving the objects, properties, and values of the list from an arena
+ * instead of the heap.  The list is released with the arena, using
+ * Arena_Reset() or Arena_Release(), and not with rpm_data_free().
+ * @ingroup DSRPM
+ *
+ * @param apdu [in] The received apdu data.
+ * @param apdu_len [in] Total length of the apdu.
+ * @param read_access_data [out] Pointer to the head of the linked list
+ *          where the RPM data is to be stored, which may be carved from
+ *          the arena as well.
+ * @param arena [in] arena that the list is carved from, or NULL for the
+ *          heap as with rpm_ack_decode_service_request()
+ * @return The number of bytes decoded, or -1 on error, including when
+ *          the arena is too small for the data
+ */
+int rpm_ack_decode_service_request_arena(
+    const uint8_t *apdu,
+    int apdu_len,
+    BACNET_READ_ACCESS_DATA *read_access_data,
+    OS_Arena arena)
+{
+    return rpm_ack_decode_list(apdu, apdu_len, read_access_data, arena);
+}
+
 /* for debugging... */
 void rpm_ack_print_data(BACNET_READ_ACCESS_DATA *rpm_data)
 {
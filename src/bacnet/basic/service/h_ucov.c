@@ -26,8 +26,18 @@
 #define MAX_COV_PROPERTIES 2
 #endif
 
+/* number of subscriber process identifiers that are accepted */
+#ifndef UCOV_PROCESS_IDENTIFIER_MAX
+#define UCOV_PROCESS_IDENTIFIER_MAX 8
+#endif
+
 /* COV notification callbacks list */
 static BACNET_COV_NOTIFICATION Unconfirmed_COV_Notification_Head;
+/* When notifications are sent to a group of subscribers, the broadcast
+   notifications to the other process identifiers are dropped before
+   their values are decoded. None in the list accepts all of them. */
+static uint32_t UCOV_Process_Identifiers[UCOV_PROCESS_IDENTIFIER_MAX];
+static unsigned UCOV_Process_Identifier_Count;
 
 /**
  * @brief call the COV notification callbacks
@@ -68,6 +78,69 @@ void handler_ucov_notification_add(BACNET_COV_NOTIFICATION *cb)
     } while (head);
 }
 
+/**
+ * @brief Accept the notifications to a subscriber process identifier.
+ *  Once one is added, the notifications to the process identifiers that
+ *  were not added are dropped.
+ * @param process_id - subscriber process identifier
+ * @return true if the process identifier was added or already accepted
+ */
+bool handler_ucov_process_identifier_add(uint32_t process_id)
+{
+    unsigned i;
+
+    for (i = 0; i < UCOV_Process_Identifier_Count; i++) {
+        if (UCOV_Process_Identifiers[i] == process_id) {
+            return true;
+        }
+    }
+    if (UCOV_Process_Identifier_Count >= UCOV_PROCESS_IDENTIFIER_MAX) {
+        return false;
+    }
+    UCOV_Process_Identifiers[UCOV_Process_Identifier_Count] = process_id;
+    UCOV_Process_Identifier_Count++;
+
+    return true;
+}
+
+/**
+ * @brief Accept the notifications to any subscriber process identifier
+ */
+void handler_ucov_process_identifier_clear(void)
+{
+    UCOV_Process_Identifier_Count = 0;
+}
+
+/**
+ * @brief Determine if the notification is to an accepted subscriber
+ *  process identifier, decoding only the process identifier
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @return true if the notification is accepted
+ */
+static bool handler_ucov_process_identifier_accepted(
+    const uint8_t *service_request, uint16_t service_len)
+{
+    BACNET_UNSIGNED_INTEGER process_id = 0;
+    unsigned i;
+
+    if (UCOV_Process_Identifier_Count == 0) {
+        return true;
+    }
+    if (bacnet_unsigned_context_decode(
+            service_request, service_len, 0, &process_id) <= 0) {
+        /* let the full decoding find the problem */
+        return true;
+    }
+    for (i = 0; i < UCOV_Process_Identifier_Count; i++) {
+        if (UCOV_Process_Identifiers[i] == process_id) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /**
  * @brief Print the UnconfirmedCOV data
  * @param cov_data - data decoded from the COV notification
@@ -124,6 +197,11 @@ void handler_ucov_notification(
 
     /* src not needed for this application */
     (void)src;
+    if (!handler_ucov_process_identifier_accepted(
+            service_request, service_len)) {
+        debug_print("UCOV: Notification to another process!\n");
+        return;
+    }
     /* create linked list to store data if more
        than one property value is expected */
     bacapp_property_value_list_init(&property_value[0], MAX_COV_PROPERTIES);
@@ -27,6 +27,11 @@ extern "C" {
 BACNET_STACK_EXPORT
 void handler_ucov_notification_add(BACNET_COV_NOTIFICATION *callback);
 
+BACNET_STACK_EXPORT
+bool handler_ucov_process_identifier_add(uint32_t process_id);
+BACNET_STACK_EXPORT
+void handler_ucov_process_identifier_clear(void);
+
 BACNET_STACK_EXPORT
 void handler_ucov_data_print(BACNET_COV_DATA *cov_data);
 
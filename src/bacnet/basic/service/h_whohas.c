@@ -101,6 +101,11 @@ void handler_who_has(
  * Will respond if the device Object ID matches, and we have
  * the Object or Object Name requested.
  *
+ * The Device object of a routed device is found once with the routed
+ * device indexes.  The other objects are looked up in each of the
+ * routed devices, using the object name index of the device when it
+ * is enabled.
+ *
  * @ingroup DMDOB
  * @param service_request [in] The received message to be handled.
  * @param service_len [in] Length of the service_request message.
@@ -115,19 +120,39 @@ void handler_who_has_for_routing(
     int cursor = 0; /* Starting hint */
     int32_t my_list[2] = { 0, -1 }; /* Not really used, so dummy values */
     BACNET_ADDRESS bcast_net;
+    BACNET_CHARACTER_STRING object_name;
+    uint16_t device_idx = 0;
+    bool device_found = false;
 
     (void)src;
     len = whohas_decode_service_request(service_request, service_len, &data);
-    if (len > 0) {
-        /* Go through all devices, starting with the root gateway Device */
-        memset(&bcast_net, 0, sizeof(BACNET_ADDRESS));
-        bcast_net.net =
-            BACNET_BROADCAST_NETWORK; /* That's all we have to set */
-        while (Routed_Device_GetNext(&bcast_net, my_list, &cursor)) {
-            dev_instance = Device_Object_Instance_Number();
-            if ((data.low_limit == -1) || (data.high_limit == -1) ||
-                ((dev_instance >= data.low_limit) &&
-                 (dev_instance <= data.high_limit))) {
+    if (len <= 0) {
+        return;
+    }
+    if (data.is_object_name) {
+        device_found = Routed_Device_Name_Find(&data.object.name, &device_idx);
+    } else if (data.object.identifier.type == OBJECT_DEVICE) {
+        device_found = Routed_Device_Instance_Find(
+            data.object.identifier.instance, &device_idx);
+        if (!device_found) {
+            return;
+        }
+    }
+    /* Go through all devices, starting with the root gateway Device */
+    memset(&bcast_net, 0, sizeof(BACNET_ADDRESS));
+    bcast_net.net = BACNET_BROADCAST_NETWORK; /* That's all we have to set */
+    while (Routed_Device_GetNext(&bcast_net, my_list, &cursor)) {
+        dev_instance = Device_Object_Instance_Number();
+        if ((data.low_limit == -1) || (data.high_limit == -1) ||
+            ((dev_instance >= data.low_limit) &&
+             (dev_instance <= data.high_limit))) {
+            if (device_found && (Routed_Device_Object_Index() == device_idx)) {
+                (void)Routed_Device_Name(dev_instance, &object_name);
+                Send_I_Have(
+                    dev_instance, OBJECT_DEVICE, dev_instance, &object_name);
+            } else if (
+                data.is_object_name ||
+                (data.object.identifier.type != OBJECT_DEVICE)) {
                 match_name_or_object(&data);
             }
         }
@@ -8,6 +8,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -17,11 +18,64 @@
 #include "bacnet/iam.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/tsm/tsm.h"
 
 /** @file h_whois.c  Handles Who-Is requests. */
 
-/** Handler for Who-Is requests, with broadcast I-Am response.
+/* largest random delay of a broadcast I-Am in milliseconds, or 0 */
+static uint16_t Who_Is_Jitter;
+/* a broadcast I-Am is waiting for its delay */
+static bool Who_Is_I_Am_Pending;
+static struct mstimer Who_Is_I_Am_Timer;
+
+/**
+ * @brief Send a broadcast I-Am, after a random delay when the jitter
+ *  is set.  The Who-Is that arrive during the delay share the I-Am.
+ */
+static void handler_who_is_i_am_broadcast(void)
+{
+    if (Who_Is_Jitter == 0) {
+        Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+    } else if (!Who_Is_I_Am_Pending) {
+        mstimer_set(&Who_Is_I_Am_Timer, 1 + (rand() % Who_Is_Jitter));
+        Who_Is_I_Am_Pending = true;
+    }
+}
+
+/**
+ * @brief Set the largest random delay of the broadcast I-Am that answers
+ *  a Who-Is, to spread the I-Am of many devices that answer the same
+ *  Who-Is.  When set, handler_who_is_task() sends the I-Am.
+ * @param milliseconds - largest delay, or 0 to answer at once
+ */
+void handler_who_is_jitter_set(uint16_t milliseconds)
+{
+    Who_Is_Jitter = milliseconds;
+}
+
+/**
+ * @brief Get the largest random delay of the broadcast I-Am
+ * @return largest delay in milliseconds, or 0 when answered at once
+ */
+uint16_t handler_who_is_jitter(void)
+{
+    return Who_Is_Jitter;
+}
+
+/**
+ * @brief Send the broadcast I-Am whose delay has passed
+ */
+void handler_who_is_task(void)
+{
+    if (Who_Is_I_Am_Pending && mstimer_expired(&Who_Is_I_Am_Timer)) {
+        Who_Is_I_Am_Pending = false;
+        Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+    }
+}
+
+/** Handler for Who-Is requests, with broadcast I-Am response,
+ * which may be delayed by handler_who_is_jitter_set().
  * @ingroup DMDDB
  * @param service_request [in] The received message to be handled.
  * @param service_len [in] Length of the service_request message.
@@ -38,12 +92,12 @@ void handler_who_is(
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
     if (len == 0) {
-        Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+        handler_who_is_i_am_broadcast();
     } else if (len != BACNET_STATUS_ERROR) {
         /* is my device id within the limits? */
         if ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
             (Device_Object_Instance_Number() <= (uint32_t)high_limit)) {
-            Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+            handler_who_is_i_am_broadcast();
         }
     }
 
@@ -141,6 +195,9 @@ void handler_who_is_who_am_i_unicast(
 /** Local function to check Who-Is requests against our Device IDs.
  * Will check the gateway (root Device) and all virtual routed
  * Devices against the range and respond for each that matches.
+ * A range narrower than the number of Devices is looked up by instance
+ * with the routed device index, so that the cost follows the number
+ * of responses.
  *
  * @param service_request [in] The received message to be handled.
  * @param service_len [in] Length of the service_request message.
@@ -162,6 +219,7 @@ static void check_who_is_for_routing(
     int cursor = 0; /* Starting hint */
     int32_t my_list[2] = { 0, -1 }; /* Not really used, so dummy values */
     BACNET_ADDRESS bcast_net;
+    uint16_t device_idx = 0;
 
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
@@ -169,6 +227,21 @@ static void check_who_is_for_routing(
         /* Invalid; just leave */
         return;
     }
+    if ((len > 0) && (high_limit >= low_limit) &&
+        ((uint32_t)(high_limit - low_limit) < Get_Num_Managed_Devices())) {
+        for (dev_instance = low_limit; dev_instance <= high_limit;
+             dev_instance++) {
+            if (Routed_Device_Instance_Find(dev_instance, &device_idx) &&
+                Get_Routed_Device_Object(device_idx)) {
+                if (is_unicast) {
+                    Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+                } else {
+                    Send_I_Am_Broadcast(&Handler_Transmit_Buffer[0]);
+                }
+            }
+        }
+        return;
+    }
     /* Go through all devices, starting with the root gateway Device */
     memset(&bcast_net, 0, sizeof(BACNET_ADDRESS));
     bcast_net.net = BACNET_BROADCAST_NETWORK; /* That's all we have to set */
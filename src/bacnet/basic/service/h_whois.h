@@ -28,6 +28,15 @@ BACNET_STACK_EXPORT
 void handler_who_is(
     uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src);
 
+BACNET_STACK_EXPORT
+void handler_who_is_jitter_set(uint16_t milliseconds);
+
+BACNET_STACK_EXPORT
+uint16_t handler_who_is_jitter(void);
+
+BACNET_STACK_EXPORT
+void handler_who_is_task(void);
+
 BACNET_STACK_EXPORT
 void handler_who_is_unicast(
     uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src);
@@ -70,6 +70,7 @@ handler_write_property_relinquish_bypass(BACNET_WRITE_PROPERTY_DATA *wp_data)
  * - an Abort if
  *   - the message is segmented
  *   - if decoding fails
+ *   - there is not enough scratch memory for the request
  *   - the WriteProperty fails and error code is an Abort
  * - a Reject if the WriteProperty fails and error code is a Reject
  * - an ACK if Device_Write_Property() succeeds
@@ -88,7 +89,7 @@ void handler_write_property(
     BACNET_ADDRESS *src,
     BACNET_CONFIRMED_SERVICE_DATA *service_data)
 {
-    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_WRITE_PROPERTY_DATA *wp_data;
     int len = 0;
     bool success = false;
     int pdu_len = 0;
@@ -102,42 +103,50 @@ void handler_write_property(
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
     debug_print("WP: Received Request!\n");
+    wp_data = apdu_scratch_alloc(sizeof(BACNET_WRITE_PROPERTY_DATA));
+    if (!wp_data) {
+        len = abort_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
+            ABORT_REASON_OUT_OF_RESOURCES, true);
+        debug_print("WP: Out of scratch memory. Sending Abort!\n");
+        goto WP_ABORT;
+    }
     if (service_len == 0) {
-        wp_data.error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
+        wp_data->error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
         len = BACNET_STATUS_REJECT;
         debug_print("WP: Missing Required Parameter. Sending Reject!\n");
     } else if (service_data->segmented_message) {
-        wp_data.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        wp_data->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
         len = BACNET_STATUS_ABORT;
         debug_print("WP: Segmented message.  Sending Abort!\n");
     } else {
         /* decode the service request only */
-        wp_data.error_class = ERROR_CLASS_PROPERTY;
-        wp_data.error_code = ERROR_CODE_SUCCESS;
-        len = wp_decode_service_request(service_request, service_len, &wp_data);
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_SUCCESS;
+        len = wp_decode_service_request(service_request, service_len, wp_data);
     }
     if (len > 0) {
         debug_fprintf(
             stderr,
             "WP: type=%lu instance=%lu property=%lu priority=%lu "
             "index=%ld\n",
-            (unsigned long)wp_data.object_type,
-            (unsigned long)wp_data.object_instance,
-            (unsigned long)wp_data.object_property,
-            (unsigned long)wp_data.priority, (long)wp_data.array_index);
+            (unsigned long)wp_data->object_type,
+            (unsigned long)wp_data->object_instance,
+            (unsigned long)wp_data->object_property,
+            (unsigned long)wp_data->priority, (long)wp_data->array_index);
     } else {
         debug_print("WP: Unable to decode Request!\n");
     }
     if (len > 0) {
-        success = handler_write_property_relinquish_bypass(&wp_data);
+        success = handler_write_property_relinquish_bypass(wp_data);
         if (success) {
             /* this object property is not commandable,
                 and therefore, not able to be relinquished,
                 so it "shall not be changed, and
                 the write shall be considered successful." */
         } else {
-            if (write_property_bacnet_array_valid(&wp_data)) {
-                success = Device_Write_Property(&wp_data);
+            if (write_property_bacnet_array_valid(wp_data)) {
+                success = Device_Write_Property(wp_data);
             }
         }
         if (success) {
@@ -150,24 +159,25 @@ void handler_write_property(
         }
     }
     if (len < 0) {
-        if (abort_valid_error_code(wp_data.error_code)) {
+        if (abort_valid_error_code(wp_data->error_code)) {
             len = abort_encode_apdu(
                 &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                abort_convert_error_code(wp_data.error_code), true);
+                abort_convert_error_code(wp_data->error_code), true);
             debug_print("WP: Sending Abort!\n");
-        } else if (reject_valid_error_code(wp_data.error_code)) {
+        } else if (reject_valid_error_code(wp_data->error_code)) {
             len = reject_encode_apdu(
                 &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                reject_convert_error_code(wp_data.error_code));
+                reject_convert_error_code(wp_data->error_code));
             debug_print("WP: Sending Reject!\n");
         } else {
             len = bacerror_encode_apdu(
                 &Handler_Transmit_Buffer[pdu_len], service_data->invoke_id,
-                SERVICE_CONFIRMED_WRITE_PROPERTY, wp_data.error_class,
-                wp_data.error_code);
+                SERVICE_CONFIRMED_WRITE_PROPERTY, wp_data->error_class,
+                wp_data->error_code);
             debug_print("WP: Sending Error!\n");
         }
     }
+WP_ABORT:
     /* Send PDU */
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
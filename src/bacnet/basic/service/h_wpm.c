@@ -17,6 +17,7 @@
 #include "bacnet/apdu.h"
 #include "bacnet/npdu.h"
 #include "bacnet/abort.h"
+#include "bacnet/rp.h"
 #include "bacnet/wp.h"
 #include "bacnet/reject.h"
 #include "bacnet/wpm.h"
@@ -27,6 +28,244 @@
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/datalink/datalink.h"
 
+/* When atomic, the value of each property is read before it is written,
+   and if a write fails, the earlier writes of the request are undone
+   in reverse order, so that a request is either applied as a whole or
+   not at all.  Otherwise the writes before the failure remain, as
+   specified for the WritePropertyMultiple service. */
+static bool WPM_Atomic;
+/* earlier values: header, encoded value, and the size of the entry */
+struct wpm_undo_entry {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    uint8_t priority;
+    uint16_t application_data_len;
+};
+static uint8_t WPM_Undo_Buffer[BACNET_WPM_UNDO_SIZE];
+static size_t WPM_Undo_Len;
+static BACNET_WRITE_PROPERTY_DATA WPM_Undo_Data;
+/* objects written by the request, for the once per object callback */
+static handler_write_property_multiple_object_callback WPM_Object_Callback;
+static BACNET_OBJECT_ID WPM_Objects[BACNET_WPM_OBJECTS_MAX];
+static unsigned WPM_Objects_Count;
+
+/**
+ * @brief Set whether a WritePropertyMultiple request is applied as a whole
+ *  or not at all
+ * @param enable - true to undo the earlier writes of a request when a
+ *  write fails, false to keep them as the standard specifies
+ */
+void handler_write_property_multiple_atomic_set(bool enable)
+{
+    WPM_Atomic = enable;
+}
+
+/**
+ * @brief Get whether a WritePropertyMultiple request is applied as a whole
+ *  or not at all
+ * @return true if the earlier writes of a request are undone when a
+ *  write fails
+ */
+bool handler_write_property_multiple_atomic(void)
+{
+    return WPM_Atomic;
+}
+
+/**
+ * @brief Set the function that is called once for each object written by
+ *  a WritePropertyMultiple request, after all of its writes, instead of
+ *  once for each property, for example to save or audit the object
+ * @param cb - function to call, or NULL to stop the calls
+ */
+void handler_write_property_multiple_object_callback_set(
+    handler_write_property_multiple_object_callback cb)
+{
+    WPM_Object_Callback = cb;
+}
+
+/**
+ * @brief Call the object callback for the objects written so far
+ */
+static void write_property_multiple_objects_notify(void)
+{
+    unsigned i;
+
+    if (WPM_Object_Callback) {
+        for (i = 0; i < WPM_Objects_Count; i++) {
+            WPM_Object_Callback(WPM_Objects[i].type, WPM_Objects[i].instance);
+        }
+    }
+    WPM_Objects_Count = 0;
+}
+
+/**
+ * @brief Remember an object that was written by the request
+ * @param object_type - type of the object
+ * @param object_instance - instance number of the object
+ */
+static void write_property_multiple_object_add(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    unsigned i;
+
+    if (!WPM_Object_Callback) {
+        return;
+    }
+    /* the writes to an object are usually together, so look from the end */
+    i = WPM_Objects_Count;
+    while (i > 0) {
+        i--;
+        if ((WPM_Objects[i].type == object_type) &&
+            (WPM_Objects[i].instance == object_instance)) {
+            return;
+        }
+    }
+    if (WPM_Objects_Count >= BACNET_WPM_OBJECTS_MAX) {
+        write_property_multiple_objects_notify();
+    }
+    WPM_Objects[WPM_Objects_Count].type = object_type;
+    WPM_Objects[WPM_Objects_Count].instance = object_instance;
+    WPM_Objects_Count++;
+}
+
+/**
+ * @brief Keep the value of a property before it is written.  For a
+ *  commanded Present_Value, the slot of the priority array is kept.
+ * @param wp_data - the property about to be written
+ * @return true if the value was kept, false with the error set in wp_data
+ */
+static bool write_property_multiple_undo_save(
+    BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    struct wpm_undo_entry entry = { 0 };
+    size_t offset = 0;
+    uint16_t entry_len = 0;
+    int len = BACNET_STATUS_ERROR;
+
+    offset = WPM_Undo_Len + sizeof(entry);
+    if ((offset + sizeof(entry_len)) >= sizeof(WPM_Undo_Buffer)) {
+        wp_data->error_class = ERROR_CLASS_RESOURCES;
+        wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+        return false;
+    }
+    rpdata.object_type = wp_data->object_type;
+    rpdata.object_instance = wp_data->object_instance;
+    rpdata.application_data = &WPM_Undo_Buffer[offset];
+    /* the value is written back from WPM_Undo_Data, so it must fit */
+    rpdata.application_data_len =
+        (int)(sizeof(WPM_Undo_Buffer) - offset - sizeof(entry_len));
+    if (rpdata.application_data_len >
+        (int)sizeof(WPM_Undo_Data.application_data)) {
+        rpdata.application_data_len =
+            (int)sizeof(WPM_Undo_Data.application_data);
+    }
+    entry.object_type = wp_data->object_type;
+    entry.object_instance = wp_data->object_instance;
+    entry.priority = wp_data->priority;
+    if ((wp_data->object_property == PROP_PRESENT_VALUE) &&
+        (wp_data->array_index == BACNET_ARRAY_ALL) &&
+        (wp_data->priority >= BACNET_MIN_PRIORITY) &&
+        (wp_data->priority <= BACNET_MAX_PRIORITY)) {
+        rpdata.object_property = PROP_PRIORITY_ARRAY;
+        rpdata.array_index = wp_data->priority;
+        len = Device_Read_Property(&rpdata);
+    }
+    if (len < 0) {
+        /* not commandable: keep the value itself */
+        rpdata.object_property = wp_data->object_property;
+        rpdata.array_index = wp_data->array_index;
+        len = Device_Read_Property(&rpdata);
+    }
+    if (len == BACNET_STATUS_ABORT) {
+        wp_data->error_class = ERROR_CLASS_RESOURCES;
+        wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+        return false;
+    }
+    if (len > rpdata.application_data_len) {
+        wp_data->error_class = ERROR_CLASS_RESOURCES;
+        wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+        return false;
+    }
+    if (len < 0) {
+        wp_data->error_class = rpdata.error_class;
+        wp_data->error_code = rpdata.error_code;
+        return false;
+    }
+    entry.object_property = wp_data->object_property;
+    entry.array_index = wp_data->array_index;
+    entry.application_data_len = (uint16_t)len;
+    memcpy(&WPM_Undo_Buffer[WPM_Undo_Len], &entry, sizeof(entry));
+    offset += (size_t)len;
+    entry_len = (uint16_t)(offset + sizeof(entry_len) - WPM_Undo_Len);
+    memcpy(&WPM_Undo_Buffer[offset], &entry_len, sizeof(entry_len));
+    WPM_Undo_Len = offset + sizeof(entry_len);
+
+    return true;
+}
+
+/**
+ * @brief Write the kept values back, newest first
+ */
+static void write_property_multiple_undo(void)
+{
+    struct wpm_undo_entry entry;
+    uint16_t entry_len = 0;
+    size_t offset = 0;
+
+    while (WPM_Undo_Len >= (sizeof(entry) + sizeof(entry_len))) {
+        memcpy(
+            &entry_len, &WPM_Undo_Buffer[WPM_Undo_Len - sizeof(entry_len)],
+            sizeof(entry_len));
+        offset = WPM_Undo_Len - entry_len;
+        memcpy(&entry, &WPM_Undo_Buffer[offset], sizeof(entry));
+        WPM_Undo_Data.object_type = entry.object_type;
+        WPM_Undo_Data.object_instance = entry.object_instance;
+        WPM_Undo_Data.object_property = entry.object_property;
+        WPM_Undo_Data.array_index = entry.array_index;
+        WPM_Undo_Data.priority = entry.priority;
+        memcpy(
+            WPM_Undo_Data.application_data,
+            &WPM_Undo_Buffer[offset + sizeof(entry)],
+            entry.application_data_len);
+        WPM_Undo_Data.application_data_len = entry.application_data_len;
+        if (!Device_Write_Property(&WPM_Undo_Data)) {
+            debug_printf_stderr(
+                "WPM: type=%lu instance=%lu property=%lu not undone!\n",
+                (unsigned long)entry.object_type,
+                (unsigned long)entry.object_instance,
+                (unsigned long)entry.object_property);
+        }
+        WPM_Undo_Len = offset;
+    }
+    WPM_Undo_Len = 0;
+}
+
+/**
+ * @brief Write one property of the request
+ * @param wp_data - the property to write
+ * @return true if the property was written
+ */
+static bool write_property_multiple_write(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    bool status = false;
+
+    if (WPM_Atomic) {
+        if (!write_property_multiple_undo_save(wp_data)) {
+            return false;
+        }
+    }
+    status = Device_Write_Property(wp_data);
+    if (status) {
+        write_property_multiple_object_add(
+            wp_data->object_type, wp_data->object_instance);
+    }
+
+    return status;
+}
+
 /** Decoding for an object property.
  *
  * @param apdu [in] The contents of the APDU buffer.
@@ -116,6 +355,7 @@ static int write_property_multiple_decode(
  * - an Abort if
  *   - the message is segmented
  *   - if decoding fails
+ *   - there is not enough scratch memory for the request
  * - an ACK if Device_Write_Property_Multiple() succeeds
  * - an Error if Device_Write_PropertyMultiple() encounters an error
  *
@@ -135,28 +375,42 @@ void handler_write_property_multiple(
     int apdu_len = 0;
     int npdu_len = 0;
     int pdu_len = 0;
-    BACNET_WRITE_PROPERTY_DATA wp_data;
+    BACNET_WRITE_PROPERTY_DATA *wp_data;
     BACNET_NPDU_DATA npdu_data;
     BACNET_ADDRESS my_address;
     int bytes_sent = 0;
 
-    if (service_len == 0) {
-        wp_data.error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
+    wp_data = apdu_scratch_alloc(sizeof(BACNET_WRITE_PROPERTY_DATA));
+    if (!wp_data) {
+        len = BACNET_STATUS_ABORT;
+        debug_print("WPM: Out of scratch memory.\n");
+    } else if (service_len == 0) {
+        wp_data->error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
         len = BACNET_STATUS_REJECT;
         debug_print("WPM: Missing Required Parameter. "
                     "Sending Reject!\n");
     } else if (service_data->segmented_message) {
-        wp_data.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        wp_data->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
         len = BACNET_STATUS_ABORT;
         debug_print("WPM: Segmented message. "
                     "Sending Abort!\n");
     } else {
         /* first time - detect malformed request before writing any data */
         len = write_property_multiple_decode(
-            service_request, service_len, &wp_data, NULL);
+            service_request, service_len, wp_data, NULL);
         if (len > 0) {
+            WPM_Undo_Len = 0;
+            WPM_Objects_Count = 0;
             len = write_property_multiple_decode(
-                service_request, service_len, &wp_data, Device_Write_Property);
+                service_request, service_len, wp_data,
+                write_property_multiple_write);
+            if ((len <= 0) && WPM_Atomic) {
+                write_property_multiple_undo();
+                /* the objects have their earlier values again */
+                WPM_Objects_Count = 0;
+            }
+            WPM_Undo_Len = 0;
+            write_property_multiple_objects_notify();
         }
     }
     /* encode the confirmed reply */
@@ -170,20 +424,25 @@ void handler_write_property_multiple(
         debug_print("WPM: Sending Ack!\n");
     } else {
         /* handle any errors */
-        if (abort_valid_error_code(wp_data.error_code)) {
+        if (!wp_data) {
+            apdu_len = abort_encode_apdu(
+                &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
+                ABORT_REASON_OUT_OF_RESOURCES, true);
+            debug_print("WPM: Sending Abort!\n");
+        } else if (abort_valid_error_code(wp_data->error_code)) {
             apdu_len = abort_encode_apdu(
                 &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
-                abort_convert_error_code(wp_data.error_code), true);
+                abort_convert_error_code(wp_data->error_code), true);
             debug_print("WPM: Sending Abort!\n");
-        } else if (reject_valid_error_code(wp_data.error_code)) {
+        } else if (reject_valid_error_code(wp_data->error_code)) {
             apdu_len = reject_encode_apdu(
                 &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
-                reject_convert_error_code(wp_data.error_code));
+                reject_convert_error_code(wp_data->error_code));
             debug_print("WPM: Sending Reject!\n");
         } else {
             apdu_len = wpm_error_ack_encode_apdu(
                 &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
-                &wp_data);
+                wp_data);
             debug_print("WPM: Sending Error!\n");
         }
     }
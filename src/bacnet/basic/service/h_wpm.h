@@ -21,10 +21,35 @@
 #include "bacnet/bacapp.h"
 #include "bacnet/apdu.h"
 
+/* octets that keep the earlier values of an atomic request */
+#ifndef BACNET_WPM_UNDO_SIZE
+#define BACNET_WPM_UNDO_SIZE (2 * MAX_APDU)
+#endif
+/* objects of a request that are remembered for the object callback */
+#ifndef BACNET_WPM_OBJECTS_MAX
+#define BACNET_WPM_OBJECTS_MAX 32
+#endif
+
+/**
+ * @brief Called once for each object written by a WritePropertyMultiple
+ *  request, after all of the writes of the request
+ * @param object_type - type of the object
+ * @param object_instance - instance number of the object
+ */
+typedef void (*handler_write_property_multiple_object_callback)(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+BACNET_STACK_EXPORT
+void handler_write_property_multiple_atomic_set(bool enable);
+BACNET_STACK_EXPORT
+bool handler_write_property_multiple_atomic(void);
+BACNET_STACK_EXPORT
+void handler_write_property_multiple_object_callback_set(
+    handler_write_property_multiple_object_callback cb);
 BACNET_STACK_EXPORT
 void handler_write_property_multiple(
     uint8_t *service_request,
@@ -54,7 +54,7 @@ uint8_t Send_Alarm_Acknowledgement_Address(
         return 0;
     }
     /* is there a tsm available? */
-    invoke_id = tsm_next_free_invokeID();
+    invoke_id = tsm_next_free_invokeID_peer(dest);
     if (invoke_id) {
         /* encode the NPDU portion of the packet */
         datalink_get_my_address(&my_address);
@@ -77,7 +77,7 @@ uint8_t Send_Alarm_Acknowledgement_Address(
                 debug_perror("Failed to Send Alarm Ack Request");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(dest, invoke_id);
             invoke_id = 0;
             debug_printf_stderr("Failed to Send Alarm Ack Request "
                                 "(exceeds destination maximum APDU)!\n");
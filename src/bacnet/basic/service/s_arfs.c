@@ -50,7 +50,7 @@ uint8_t Send_Atomic_Read_File_Stream(
     status = address_get_by_device(device_id, &max_apdu, &dest);
     /* is there a tsm available? */
     if (status) {
-        invoke_id = tsm_next_free_invokeID();
+        invoke_id = tsm_next_free_invokeID_peer(&dest);
     }
     if (invoke_id) {
         /* load the data for the encoding */
@@ -82,7 +82,7 @@ uint8_t Send_Atomic_Read_File_Stream(
                 debug_perror("Failed to Send AtomicReadFile Request");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(&dest, invoke_id);
             invoke_id = 0;
             debug_fprintf(
                 stderr,
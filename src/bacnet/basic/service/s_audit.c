@@ -0,0 +1,427 @@
+/**
+ * @file
+ * @brief Send an AuditNotification Request, and report audit
+ *  notifications in batches so that several of them share one request.
+ * @date October 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "bacnet/bacaudit.h"
+#include "bacnet/dcc.h"
+#include "bacnet/npdu.h"
+/* some demo stuff needed */
+#include "bacnet/basic/object/device.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/services.h"
+
+/* confirmed service request header plus the notifications [0] tags */
+#define AUDIT_NOTIFICATION_APDU_OVERHEAD 6
+
+/* where the batched audit notifications are sent */
+static BACNET_RECIPIENT Audit_Recipient;
+static bool Audit_Recipient_Valid;
+/* which operations are reported */
+static BACNET_AUDIT_LEVEL Audit_Level = AUDIT_LEVEL_DEFAULT;
+/* how long a notification may wait for others to join it */
+static uint16_t Audit_Latency = AUDIT_REPORTER_LATENCY_MS;
+/* zero uses the max-APDU of the recipient address binding */
+static uint16_t Audit_Max_APDU;
+static audit_reporter_send_callback Audit_Send_Callback =
+    Send_Audit_Notification_Body;
+/* encoded notifications waiting to be sent */
+static uint8_t Audit_Body[AUDIT_REPORTER_BUFFER_SIZE];
+static size_t Audit_Body_Len;
+static unsigned Audit_Body_Count;
+static uint32_t Audit_Body_Age;
+
+/**
+ * @brief Sends a ConfirmedAuditNotification from a service request body
+ *  holding one or more BACnetAuditNotification encodings
+ * @param pdu [in] the PDU buffer used for sending the message
+ * @param pdu_size [in] Size of the PDU buffer
+ * @param body [in] concatenated bacnet_audit_log_notification_encode()
+ * @param body_len [in] number of bytes in the service request body
+ * @param dest [in] BACNET_ADDRESS of the destination device
+ * @return invoke id of outgoing message, or 0 if communication is disabled,
+ *         or no tsm slot is available.
+ */
+uint8_t Send_Audit_Notification_Body_Address(
+    uint8_t *pdu,
+    uint16_t pdu_size,
+    const uint8_t *body,
+    size_t body_len,
+    BACNET_ADDRESS *dest)
+{
+    size_t len = 0;
+    int pdu_len = 0;
+    int bytes_sent = 0;
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    uint8_t invoke_id = 0;
+
+    if (!dcc_communication_enabled()) {
+        return 0;
+    }
+    if (!dest) {
+        return 0;
+    }
+    /* is there a tsm available? */
+    invoke_id = tsm_next_free_invokeID_peer(dest);
+    if (invoke_id) {
+        /* encode the NPDU portion of the packet */
+        datalink_get_my_address(&my_address);
+        npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+        pdu_len = npdu_encode_pdu(pdu, dest, &my_address, &npdu_data);
+        /* copy the APDU portion of the packet */
+        if ((unsigned)pdu_len < pdu_size) {
+            len = bacnet_audit_notification_apdu_body_encode(
+                &pdu[pdu_len], pdu_size - pdu_len, true, invoke_id, body,
+                body_len);
+        }
+        pdu_len += (int)len;
+        if ((len > 0) && ((uint16_t)pdu_len < pdu_size)) {
+            tsm_set_confirmed_unsegmented_transaction(
+                invoke_id, dest, &npdu_data, pdu, (uint16_t)pdu_len);
+            bytes_sent = datalink_send_pdu(dest, &npdu_data, pdu, pdu_len);
+            if (bytes_sent <= 0) {
+                debug_perror(
+                    "Failed to Send ConfirmedAuditNotification Request");
+            }
+        } else {
+            tsm_free_invoke_id_peer(dest, invoke_id);
+            invoke_id = 0;
+            debug_fprintf(
+                stderr,
+                "Failed to Send ConfirmedAuditNotification Request "
+                "(exceeds destination maximum APDU)!\n");
+        }
+    }
+
+    return invoke_id;
+}
+
+/**
+ * @brief Sends a ConfirmedAuditNotification from a service request body
+ *  holding one or more BACnetAuditNotification encodings
+ * @param recipient [in] the device or address of the destination
+ * @param body [in] concatenated bacnet_audit_log_notification_encode()
+ * @param body_len [in] number of bytes in the service request body
+ * @return invoke id of outgoing message, or 0 if communication is disabled,
+ *         the device is not bound, or no tsm slot is available.
+ */
+uint8_t Send_Audit_Notification_Body(
+    const BACNET_RECIPIENT *recipient, const uint8_t *body, size_t body_len)
+{
+    BACNET_ADDRESS dest = { 0 };
+    unsigned max_apdu = 0;
+    uint8_t invoke_id = 0;
+    bool status = false;
+
+    if (!recipient) {
+        return 0;
+    }
+    if (recipient->tag == BACNET_RECIPIENT_TAG_DEVICE) {
+        /* is the device bound? */
+        status = address_get_by_device(
+            recipient->type.device.instance, &max_apdu, &dest);
+    } else if (recipient->tag == BACNET_RECIPIENT_TAG_ADDRESS) {
+        bacnet_address_copy(&dest, &recipient->type.address);
+        max_apdu = MAX_APDU;
+        status = true;
+    }
+    if (status) {
+        if (sizeof(Handler_Transmit_Buffer) < max_apdu) {
+            max_apdu = sizeof(Handler_Transmit_Buffer);
+        }
+        invoke_id = Send_Audit_Notification_Body_Address(
+            Handler_Transmit_Buffer, max_apdu, body, body_len, &dest);
+    }
+
+    return invoke_id;
+}
+
+/**
+ * @brief Determine if an audit level reports a notification.
+ *
+ *  AUDIT_LEVEL_NONE reports nothing and AUDIT_LEVEL_AUDIT_ALL reports
+ *  everything. AUDIT_LEVEL_DEFAULT reports everything except reads.
+ *  AUDIT_LEVEL_AUDIT_CONFIG reports only the operations that change
+ *  the configuration of a device, leaving out the operational traffic
+ *  such as present-value writes, alarm acknowledgments, and reads.
+ *  Proprietary levels report everything.
+ *
+ * @param level [in] the audit level of the reporter
+ * @param notification [in] the audit notification
+ * @return true if the notification is reported at this level
+ */
+bool Audit_Reporter_Level_Reports(
+    BACNET_AUDIT_LEVEL level, const BACNET_AUDIT_NOTIFICATION *notification)
+{
+    bool status = false;
+
+    if (!notification) {
+        return false;
+    }
+    switch (level) {
+        case AUDIT_LEVEL_NONE:
+            status = false;
+            break;
+        case AUDIT_LEVEL_AUDIT_ALL:
+            status = true;
+            break;
+        case AUDIT_LEVEL_DEFAULT:
+            status = notification->operation != AUDIT_OPERATION_READ;
+            break;
+        case AUDIT_LEVEL_AUDIT_CONFIG:
+            switch (notification->operation) {
+                case AUDIT_OPERATION_READ:
+                case AUDIT_OPERATION_LIFE_SAFETY:
+                case AUDIT_OPERATION_ACKNOWLEDGE_ALARM:
+                case AUDIT_OPERATION_SUBSCRIPTION:
+                case AUDIT_OPERATION_NOTIFICATION:
+                    status = false;
+                    break;
+                case AUDIT_OPERATION_WRITE:
+                    status = true;
+#ifdef BACNET_AUDIT_NOTIFICATION_TARGET_PROPERTY_ENABLE
+                    if (notification->target_property.property_identifier ==
+                        PROP_PRESENT_VALUE) {
+                        status = false;
+                    }
+#endif
+                    break;
+                default:
+                    status = true;
+                    break;
+            }
+            break;
+        default:
+            status = true;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Determine how many bytes of notifications fit in one request
+ * @return number of bytes available for the notifications body
+ */
+static size_t audit_reporter_capacity(void)
+{
+    BACNET_ADDRESS dest = { 0 };
+    unsigned max_apdu = MAX_APDU;
+
+    if (Audit_Max_APDU) {
+        max_apdu = Audit_Max_APDU;
+    } else if (Audit_Recipient.tag == BACNET_RECIPIENT_TAG_DEVICE) {
+        if (!address_get_by_device(
+                Audit_Recipient.type.device.instance, &max_apdu, &dest)) {
+            max_apdu = MAX_APDU;
+        }
+    }
+    if (max_apdu > (sizeof(Audit_Body) + AUDIT_NOTIFICATION_APDU_OVERHEAD)) {
+        max_apdu = sizeof(Audit_Body) + AUDIT_NOTIFICATION_APDU_OVERHEAD;
+    }
+    if (max_apdu <= AUDIT_NOTIFICATION_APDU_OVERHEAD) {
+        return 0;
+    }
+
+    return max_apdu - AUDIT_NOTIFICATION_APDU_OVERHEAD;
+}
+
+/**
+ * @brief Send the notifications waiting in the reporter as one
+ *  AuditNotification request
+ * @return true if nothing is left waiting in the reporter
+ */
+bool Audit_Reporter_Flush(void)
+{
+    uint8_t invoke_id = 0;
+
+    if (Audit_Body_Count == 0) {
+        return true;
+    }
+    if (!Audit_Send_Callback) {
+        return false;
+    }
+    invoke_id =
+        Audit_Send_Callback(&Audit_Recipient, Audit_Body, Audit_Body_Len);
+    if (invoke_id == 0) {
+        /* keep them and try again on the next task */
+        return false;
+    }
+    Audit_Body_Len = 0;
+    Audit_Body_Count = 0;
+    Audit_Body_Age = 0;
+
+    return true;
+}
+
+/**
+ * @brief Add an audit notification to the next AuditNotification request.
+ *  The request is sent when the next notification would exceed the
+ *  recipient max-APDU, or when the oldest notification has waited for
+ *  the reporter latency.
+ * @param notification [in] the audit notification to report
+ * @return true if the notification was accepted for reporting
+ */
+bool Audit_Reporter_Notify(const BACNET_AUDIT_NOTIFICATION *notification)
+{
+    size_t capacity = 0;
+    int len = 0;
+
+    if (!notification || !Audit_Recipient_Valid) {
+        return false;
+    }
+    if (!Audit_Reporter_Level_Reports(Audit_Level, notification)) {
+        return false;
+    }
+    len = bacnet_audit_log_notification_encode(NULL, notification);
+    capacity = audit_reporter_capacity();
+    if ((len <= 0) || ((size_t)len > capacity)) {
+        return false;
+    }
+    if ((Audit_Body_Len + len) > capacity) {
+        (void)Audit_Reporter_Flush();
+        if ((Audit_Body_Len + len) > capacity) {
+            return false;
+        }
+    }
+    len = bacnet_audit_log_notification_encode(
+        &Audit_Body[Audit_Body_Len], notification);
+    if (Audit_Body_Count == 0) {
+        Audit_Body_Age = 0;
+    }
+    Audit_Body_Len += len;
+    Audit_Body_Count++;
+    if (Audit_Latency == 0) {
+        (void)Audit_Reporter_Flush();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the number of notifications waiting in the reporter
+ * @return number of notifications waiting to be sent
+ */
+unsigned Audit_Reporter_Pending(void)
+{
+    return Audit_Body_Count;
+}
+
+/**
+ * @brief Send the waiting notifications once the oldest one has
+ *  waited for the reporter latency
+ * @param elapsed_milliseconds [in] time since the last call
+ */
+void Audit_Reporter_Task(uint16_t elapsed_milliseconds)
+{
+    if (Audit_Body_Count == 0) {
+        return;
+    }
+    if (Audit_Body_Age < (UINT32_MAX - elapsed_milliseconds)) {
+        Audit_Body_Age += elapsed_milliseconds;
+    }
+    if (Audit_Body_Age >= Audit_Latency) {
+        (void)Audit_Reporter_Flush();
+    }
+}
+
+/**
+ * @brief Set the recipient of the audit notifications, and discard any
+ *  notifications that were waiting for the previous recipient
+ * @param recipient [in] device or address of the recipient, or NULL
+ */
+void Audit_Reporter_Recipient_Set(const BACNET_RECIPIENT *recipient)
+{
+    if (recipient) {
+        bacnet_recipient_copy(&Audit_Recipient, recipient);
+        Audit_Recipient_Valid = true;
+    } else {
+        Audit_Recipient_Valid = false;
+    }
+    Audit_Body_Len = 0;
+    Audit_Body_Count = 0;
+    Audit_Body_Age = 0;
+}
+
+/**
+ * @brief Set the audit level of the reporter
+ * @param level [in] the audit level
+ */
+void Audit_Reporter_Level_Set(BACNET_AUDIT_LEVEL level)
+{
+    Audit_Level = level;
+}
+
+/**
+ * @brief Get the audit level of the reporter
+ * @return the audit level
+ */
+BACNET_AUDIT_LEVEL Audit_Reporter_Level(void)
+{
+    return Audit_Level;
+}
+
+/**
+ * @brief Set how long a notification may wait for others to join it.
+ *  Zero sends each notification in its own request.
+ * @param milliseconds [in] the reporter latency
+ */
+void Audit_Reporter_Latency_Set(uint16_t milliseconds)
+{
+    Audit_Latency = milliseconds;
+}
+
+/**
+ * @brief Get how long a notification may wait for others to join it
+ * @return the reporter latency in milliseconds
+ */
+uint16_t Audit_Reporter_Latency(void)
+{
+    return Audit_Latency;
+}
+
+/**
+ * @brief Set the max-APDU that bounds each request, for recipients
+ *  behind a router with a smaller max-APDU than the binding shows
+ * @param max_apdu [in] the max-APDU, or zero to use the address binding
+ */
+void Audit_Reporter_Max_APDU_Set(uint16_t max_apdu)
+{
+    Audit_Max_APDU = max_apdu;
+}
+
+/**
+ * @brief Set the function that sends each batch of notifications
+ * @param callback [in] the send function, or NULL for the default
+ */
+void Audit_Reporter_Send_Callback_Set(audit_reporter_send_callback callback)
+{
+    if (callback) {
+        Audit_Send_Callback = callback;
+    } else {
+        Audit_Send_Callback = Send_Audit_Notification_Body;
+    }
+}
+
+/**
+ * @brief Initialize the audit reporter with no recipient
+ */
+void Audit_Reporter_Init(void)
+{
+    Audit_Recipient_Valid = false;
+    Audit_Level = AUDIT_LEVEL_DEFAULT;
+    Audit_Latency = AUDIT_REPORTER_LATENCY_MS;
+    Audit_Max_APDU = 0;
+    Audit_Body_Len = 0;
+    Audit_Body_Count = 0;
+    Audit_Body_Age = 0;
+}
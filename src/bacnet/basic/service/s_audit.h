@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @date October 2026
+ * @brief Header file for a basic AuditNotification service send and
+ *  an audit reporter that batches notifications into one request
+ *
+ * @section LICENSE
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#ifndef SEND_AUDIT_NOTIFICATION_H
+#define SEND_AUDIT_NOTIFICATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/bacaudit.h"
+#include "bacnet/bacdest.h"
+
+/* number of bytes of encoded BACnetAuditNotification held by the reporter
+   before they are sent, bounded again by the recipient max-APDU */
+#ifndef AUDIT_REPORTER_BUFFER_SIZE
+#define AUDIT_REPORTER_BUFFER_SIZE MAX_APDU
+#endif
+/* default number of milliseconds a notification may wait in the reporter */
+#ifndef AUDIT_REPORTER_LATENCY_MS
+#define AUDIT_REPORTER_LATENCY_MS 1000
+#endif
+
+/**
+ * @brief Callback used by the audit reporter to send a batch
+ * @param recipient [in] the audit notification recipient
+ * @param body [in] concatenated BACnetAuditNotification encodings
+ * @param body_len [in] number of bytes in the body
+ * @return invoke id of the outgoing message, or 0 if it was not sent
+ */
+typedef uint8_t (*audit_reporter_send_callback)(
+    const BACNET_RECIPIENT *recipient, const uint8_t *body, size_t body_len);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+uint8_t Send_Audit_Notification_Body_Address(
+    uint8_t *pdu,
+    uint16_t pdu_size,
+    const uint8_t *body,
+    size_t body_len,
+    BACNET_ADDRESS *dest);
+BACNET_STACK_EXPORT
+uint8_t Send_Audit_Notification_Body(
+    const BACNET_RECIPIENT *recipient, const uint8_t *body, size_t body_len);
+
+BACNET_STACK_EXPORT
+void Audit_Reporter_Init(void);
+BACNET_STACK_EXPORT
+void Audit_Reporter_Recipient_Set(const BACNET_RECIPIENT *recipient);
+BACNET_STACK_EXPORT
+void Audit_Reporter_Level_Set(BACNET_AUDIT_LEVEL level);
+BACNET_STACK_EXPORT
+BACNET_AUDIT_LEVEL Audit_Reporter_Level(void);
+BACNET_STACK_EXPORT
+void Audit_Reporter_Latency_Set(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+uint16_t Audit_Reporter_Latency(void);
+BACNET_STACK_EXPORT
+void Audit_Reporter_Max_APDU_Set(uint16_t max_apdu);
+BACNET_STACK_EXPORT
+void Audit_Reporter_Send_Callback_Set(audit_reporter_send_callback callback);
+BACNET_STACK_EXPORT
+bool Audit_Reporter_Level_Reports(
+    BACNET_AUDIT_LEVEL level, const BACNET_AUDIT_NOTIFICATION *notification);
+BACNET_STACK_EXPORT
+bool Audit_Reporter_Notify(const BACNET_AUDIT_NOTIFICATION *notification);
+BACNET_STACK_EXPORT
+unsigned Audit_Reporter_Pending(void);
+BACNET_STACK_EXPORT
+bool Audit_Reporter_Flush(void);
+BACNET_STACK_EXPORT
+void Audit_Reporter_Task(uint16_t elapsed_milliseconds);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -49,7 +49,7 @@ uint8_t Send_Atomic_Write_File_Stream(
     status = address_get_by_device(device_id, &max_apdu, &dest);
     /* is there a tsm available? */
     if (status) {
-        invoke_id = tsm_next_free_invokeID();
+        invoke_id = tsm_next_free_invokeID_peer(&dest);
     }
     if (invoke_id) {
         /* load the data for the encoding */
@@ -83,7 +83,7 @@ uint8_t Send_Atomic_Write_File_Stream(
                     debug_perror("Failed to Send AtomicWriteFile Request");
                 }
             } else {
-                tsm_free_invoke_id(invoke_id);
+                tsm_free_invoke_id_peer(&dest, invoke_id);
                 invoke_id = 0;
                 debug_fprintf(
                     stderr,
@@ -92,7 +92,7 @@ uint8_t Send_Atomic_Write_File_Stream(
                     pdu_len, max_apdu);
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(&dest, invoke_id);
             invoke_id = 0;
             debug_fprintf(
                 stderr,
@@ -48,7 +48,7 @@ uint8_t Send_CEvent_Notify_Address(
         return 0;
     }
     /* is there a tsm available? */
-    invoke_id = tsm_next_free_invokeID();
+    invoke_id = tsm_next_free_invokeID_peer(dest);
     if (invoke_id) {
         /* encode the NPDU portion of the packet */
         datalink_get_my_address(&my_address);
@@ -71,7 +71,7 @@ uint8_t Send_CEvent_Notify_Address(
                     "Failed to Send ConfirmedEventNotification Request");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(dest, invoke_id);
             invoke_id = 0;
             debug_fprintf(
                 stderr,
@@ -111,3 +111,110 @@ uint8_t Send_CEvent_Notify(
 
     return invoke_id;
 }
+
+/**
+ * @brief Sends a Confirmed Alarm/Event Notification from a service request
+ *  body that was encoded once for all of the recipients of an event
+ * @ingroup EVNOTFCN
+ * @param pdu [in] the PDU buffer used for sending the message
+ * @param pdu_size [in] Size of the PDU buffer
+ * @param process_id [in] processIdentifier of the recipient
+ * @param body [in] service request from
+ *  event_notify_encode_service_request_body()
+ * @param body_len [in] number of bytes in the service request body
+ * @param dest [in] BACNET_ADDRESS of the destination device
+ * @return invoke id of outgoing message, or 0 if communication is disabled,
+ *         or no tsm slot is available.
+ */
+uint8_t Send_CEvent_Notify_Body_Address(
+    uint8_t *pdu,
+    uint16_t pdu_size,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len,
+    BACNET_ADDRESS *dest)
+{
+    size_t len = 0;
+    int pdu_len = 0;
+    int bytes_sent = 0;
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    uint8_t invoke_id = 0;
+
+    if (!dcc_communication_enabled()) {
+        return 0;
+    }
+    if (!dest) {
+        return 0;
+    }
+    /* is there a tsm available? */
+    invoke_id = tsm_next_free_invokeID_peer(dest);
+    if (invoke_id) {
+        /* encode the NPDU portion of the packet */
+        datalink_get_my_address(&my_address);
+        npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+        pdu_len = npdu_encode_pdu(pdu, dest, &my_address, &npdu_data);
+        /* copy the APDU portion of the packet */
+        if ((unsigned)pdu_len < pdu_size) {
+            len = event_notify_encode_apdu_body(
+                &pdu[pdu_len], pdu_size - pdu_len, true, invoke_id,
+                process_id, body, body_len);
+        }
+        pdu_len += (int)len;
+        if ((len > 0) && ((uint16_t)pdu_len < pdu_size)) {
+            tsm_set_confirmed_unsegmented_transaction(
+                invoke_id, dest, &npdu_data, pdu, (uint16_t)pdu_len);
+            bytes_sent = datalink_send_pdu(dest, &npdu_data, pdu, pdu_len);
+            if (bytes_sent <= 0) {
+                debug_perror(
+                    "Failed to Send ConfirmedEventNotification Request");
+            }
+        } else {
+            tsm_free_invoke_id_peer(dest, invoke_id);
+            invoke_id = 0;
+            debug_fprintf(
+                stderr,
+                "Failed to Send ConfirmedEventNotification Request "
+                "(exceeds destination maximum APDU)!\n");
+        }
+    }
+
+    return invoke_id;
+}
+
+/**
+ * @brief Sends a Confirmed Alarm/Event Notification from a service request
+ *  body that was encoded once for all of the recipients of an event
+ * @ingroup EVNOTFCN
+ * @param device_id [in] ID of the destination device
+ * @param process_id [in] processIdentifier of the recipient
+ * @param body [in] service request from
+ *  event_notify_encode_service_request_body()
+ * @param body_len [in] number of bytes in the service request body
+ * @return invoke id of outgoing message, or 0 if communication is disabled,
+ *         or no tsm slot is available.
+ */
+uint8_t Send_CEvent_Notify_Body(
+    uint32_t device_id,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len)
+{
+    BACNET_ADDRESS dest = { 0 };
+    unsigned max_apdu = 0;
+    uint8_t invoke_id = 0;
+    bool status = false;
+
+    /* is the device bound? */
+    status = address_get_by_device(device_id, &max_apdu, &dest);
+    if (status) {
+        if (sizeof(Handler_Transmit_Buffer) < max_apdu) {
+            max_apdu = sizeof(Handler_Transmit_Buffer);
+        }
+        invoke_id = Send_CEvent_Notify_Body_Address(
+            Handler_Transmit_Buffer, max_apdu, process_id, body, body_len,
+            &dest);
+    }
+
+    return invoke_id;
+}
@@ -35,6 +35,20 @@ uint8_t Send_CEvent_Notify_Address(
     uint16_t pdu_size,
     const BACNET_EVENT_NOTIFICATION_DATA *data,
     BACNET_ADDRESS *dest);
+BACNET_STACK_EXPORT
+uint8_t Send_CEvent_Notify_Body(
+    uint32_t device_id,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len);
+BACNET_STACK_EXPORT
+uint8_t Send_CEvent_Notify_Body_Address(
+    uint8_t *pdu,
+    uint16_t pdu_size,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len,
+    BACNET_ADDRESS *dest);
 
 #ifdef __cplusplus
 }
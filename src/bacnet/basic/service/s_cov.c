@@ -112,7 +112,7 @@ uint8_t Send_COV_Subscribe_Address(
         return 0;
     }
     /* is there a tsm available? */
-    invoke_id = tsm_next_free_invokeID();
+    invoke_id = tsm_next_free_invokeID_peer(dest);
     if (invoke_id) {
         /* encode the NPDU portion of the packet */
         datalink_get_my_address(&my_address);
@@ -147,7 +147,7 @@ uint8_t Send_COV_Subscribe_Address(
                 debug_perror("Failed to Send SubscribeCOV Request");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(dest, invoke_id);
             invoke_id = 0;
             debug_fprintf(
                 stderr,
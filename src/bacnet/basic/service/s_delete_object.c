@@ -61,7 +61,7 @@ uint8_t Send_Delete_Object_Request(
     status = address_get_by_device(device_id, &max_apdu, &dest);
     /* is there a tsm available? */
     if (status) {
-        invoke_id = tsm_next_free_invokeID();
+        invoke_id = tsm_next_free_invokeID_peer(&dest);
     }
     if (invoke_id) {
         /* encode the NPDU portion of the packet */
@@ -102,7 +102,7 @@ uint8_t Send_Delete_Object_Request(
                 debug_perror("DeleteObject: Failed to Send");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(&dest, invoke_id);
             invoke_id = 0;
             debug_printf_stderr(
                 "%s service: Failed to Send "
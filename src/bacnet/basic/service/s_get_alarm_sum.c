@@ -36,7 +36,7 @@ uint8_t Send_Get_Alarm_Summary_Address(BACNET_ADDRESS *dest, uint16_t max_apdu)
     int bytes_sent = 0;
 
     /* is there a tsm available? */
-    invoke_id = tsm_next_free_invokeID();
+    invoke_id = tsm_next_free_invokeID_peer(dest);
     if (invoke_id) {
         datalink_get_my_address(&my_address);
         /* encode the NPDU portion of the packet */
@@ -59,7 +59,7 @@ uint8_t Send_Get_Alarm_Summary_Address(BACNET_ADDRESS *dest, uint16_t max_apdu)
                 debug_perror("Failed to Send Get Alarm Summary Request");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(dest, invoke_id);
             invoke_id = 0;
             debug_fprintf(
                 stderr,
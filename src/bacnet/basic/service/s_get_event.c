@@ -42,7 +42,7 @@ uint8_t Send_Get_Event_Information_Address(
     int bytes_sent = 0;
 
     /* is there a tsm available? */
-    invoke_id = tsm_next_free_invokeID();
+    invoke_id = tsm_next_free_invokeID_peer(dest);
     if (invoke_id) {
         datalink_get_my_address(&my_address);
         /* encode the NPDU portion of the packet */
@@ -65,7 +65,7 @@ uint8_t Send_Get_Event_Information_Address(
                 debug_perror("Failed to Send Get Event Information Request");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(dest, invoke_id);
             invoke_id = 0;
             debug_fprintf(
                 stderr,
@@ -46,7 +46,7 @@ uint8_t Send_GetEvent(
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], target_address, &my_address, &npdu_data);
 
-    invoke_id = tsm_next_free_invokeID();
+    invoke_id = tsm_next_free_invokeID_peer(target_address);
     if (invoke_id) {
         /* encode the APDU portion of the packet */
         len = getevent_encode_apdu(
@@ -59,7 +59,7 @@ uint8_t Send_GetEvent(
             debug_perror("Failed to Send GetEventInformation Request");
         }
     } else {
-        tsm_free_invoke_id(invoke_id);
+        tsm_free_invoke_id_peer(target_address, invoke_id);
         invoke_id = 0;
         debug_fprintf(
             stderr,
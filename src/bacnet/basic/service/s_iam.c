@@ -63,6 +63,58 @@ void Send_I_Am_To_Network(
     }
 }
 
+/* an I-Am is 2 octets of header and four tagged values of 5 octets */
+#define I_AM_APDU_MAX 22
+
+/* pre-encoded I-Am of a device, rebuilt when one of its values changes */
+struct i_am_template {
+    uint32_t device_id;
+    unsigned max_apdu;
+    int segmentation;
+    uint16_t vendor_id;
+    uint8_t apdu_len;
+    uint8_t apdu[I_AM_APDU_MAX];
+};
+static struct i_am_template I_Am_Templates[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define I_Am_Template (I_Am_Templates[Routed_Device_Object_Index()])
+#else
+#define I_Am_Template (I_Am_Templates[0])
+#endif
+
+/**
+ * @brief Copy the I-Am APDU of the current device from its template,
+ *  and encode the template again only when the values of the device
+ *  that are in the I-Am have changed.
+ * @param apdu [out] Buffer for the APDU of the I-Am
+ * @return number of bytes copied into the buffer
+ */
+static int iam_template_encode_apdu(uint8_t *apdu)
+{
+    struct i_am_template *entry = &I_Am_Template;
+    uint32_t device_id;
+    int segmentation;
+    uint16_t vendor_id;
+
+    device_id = Device_Object_Instance_Number();
+    segmentation = Device_Segmentation_Supported();
+    vendor_id = Device_Vendor_Identifier();
+    if ((entry->apdu_len == 0) || (entry->device_id != device_id) ||
+        (entry->max_apdu != MAX_APDU) ||
+        (entry->segmentation != segmentation) ||
+        (entry->vendor_id != vendor_id)) {
+        entry->apdu_len = (uint8_t)iam_encode_apdu(
+            entry->apdu, device_id, MAX_APDU, segmentation, vendor_id);
+        entry->device_id = device_id;
+        entry->max_apdu = MAX_APDU;
+        entry->segmentation = segmentation;
+        entry->vendor_id = vendor_id;
+    }
+    memcpy(apdu, entry->apdu, entry->apdu_len);
+
+    return entry->apdu_len;
+}
+
 /** Encode an I Am message to be broadcast.
  * @param buffer [in,out] The buffer to use for building the message.
  * @param dest [out] The destination address information.
@@ -83,9 +135,7 @@ int iam_encode_pdu(
     pdu_len = npdu_encode_pdu(&buffer[0], dest, &my_address, npdu_data);
 
     /* encode the APDU portion of the packet */
-    len = iam_encode_apdu(
-        &buffer[pdu_len], Device_Object_Instance_Number(), MAX_APDU,
-        Device_Segmentation_Supported(), Device_Vendor_Identifier());
+    len = iam_template_encode_apdu(&buffer[pdu_len]);
     pdu_len += len;
 
     return pdu_len;
@@ -156,9 +206,7 @@ int iam_unicast_encode_pdu(
     npdu_encode_npdu_data(npdu_data, false, MESSAGE_PRIORITY_NORMAL);
     npdu_len = npdu_encode_pdu(&buffer[0], dest, &my_address, npdu_data);
     /* encode the APDU portion of the packet */
-    apdu_len = iam_encode_apdu(
-        &buffer[npdu_len], Device_Object_Instance_Number(), MAX_APDU,
-        Device_Segmentation_Supported(), Device_Vendor_Identifier());
+    apdu_len = iam_template_encode_apdu(&buffer[npdu_len]);
     pdu_len = npdu_len + apdu_len;
 
     return pdu_len;
@@ -24,6 +24,62 @@
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/services.h"
 
+/* the PDU type, service choice and deviceIdentifier of an I-Have */
+#define I_HAVE_HEADER_MAX 7
+
+/* pre-encoded I-Have header of a device, rebuilt when its ID changes */
+struct i_have_template {
+    uint32_t device_id;
+    uint8_t apdu_len;
+    uint8_t apdu[I_HAVE_HEADER_MAX];
+};
+static struct i_have_template I_Have_Templates[MAX_NUM_DEVICES];
+#ifdef BAC_ROUTING
+#define I_Have_Template (I_Have_Templates[Routed_Device_Object_Index()])
+#else
+#define I_Have_Template (I_Have_Templates[0])
+#endif
+
+/**
+ * @brief Encode the APDU of an I-Have, copying the part that is the
+ *  same for every I-Have of the device from its template.
+ * @param apdu [out] Buffer for the APDU of the I-Have
+ * @param device_id [in] My device ID.
+ * @param object_type [in] The BACNET_OBJECT_TYPE that I Have.
+ * @param object_instance [in] The Object ID that I Have.
+ * @param object_name [in] The Name of the Object I Have.
+ * @return number of bytes encoded into the buffer
+ */
+static int ihave_template_encode_apdu(
+    uint8_t *apdu,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    const BACNET_CHARACTER_STRING *object_name)
+{
+    struct i_have_template *entry = &I_Have_Template;
+    int apdu_len;
+
+    if ((entry->apdu_len == 0) || (entry->device_id != device_id)) {
+        entry->apdu[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+        entry->apdu[1] = SERVICE_UNCONFIRMED_I_HAVE;
+        entry->apdu_len = 2 +
+            (uint8_t)encode_application_object_id(
+                &entry->apdu[2], OBJECT_DEVICE, device_id);
+        entry->device_id = device_id;
+    }
+    memcpy(apdu, entry->apdu, entry->apdu_len);
+    apdu_len = entry->apdu_len;
+    /* objectIdentifier */
+    apdu_len += encode_application_object_id(
+        &apdu[apdu_len], object_type, object_instance);
+    /* objectName */
+    apdu_len +=
+        encode_application_character_string(&apdu[apdu_len], object_name);
+
+    return apdu_len;
+}
+
 /** Broadcast an I Have message.
  * @ingroup DMDOB
  *
@@ -42,7 +98,6 @@ void Send_I_Have(
     int pdu_len = 0;
     BACNET_ADDRESS dest;
     int bytes_sent = 0;
-    BACNET_I_HAVE_DATA data;
     BACNET_NPDU_DATA npdu_data;
     BACNET_ADDRESS my_address;
 
@@ -59,12 +114,9 @@ void Send_I_Have(
         &Handler_Transmit_Buffer[0], &dest, &my_address, &npdu_data);
 
     /* encode the APDU portion of the packet */
-    data.device_id.type = OBJECT_DEVICE;
-    data.device_id.instance = device_id;
-    data.object_id.type = object_type;
-    data.object_id.instance = object_instance;
-    characterstring_copy(&data.object_name, object_name);
-    len = ihave_encode_apdu(&Handler_Transmit_Buffer[pdu_len], &data);
+    len = ihave_template_encode_apdu(
+        &Handler_Transmit_Buffer[pdu_len], device_id, object_type,
+        object_instance, object_name);
     pdu_len += len;
     /* send the data */
     bytes_sent = datalink_send_pdu(
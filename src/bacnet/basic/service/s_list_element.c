@@ -72,7 +72,7 @@ uint8_t Send_List_Element_Request_Data(
     status = address_get_by_device(device_id, &max_apdu, &dest);
     /* is there a tsm available? */
     if (status) {
-        invoke_id = tsm_next_free_invokeID();
+        invoke_id = tsm_next_free_invokeID_peer(&dest);
     }
     if (invoke_id) {
         /* encode the NPDU portion of the packet */
@@ -111,7 +111,7 @@ uint8_t Send_List_Element_Request_Data(
                 debug_perror("ListElement: Failed to Send");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(&dest, invoke_id);
             invoke_id = 0;
             debug_printf_stderr(
                 "%s service: Failed to Send "
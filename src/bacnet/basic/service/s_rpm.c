@@ -55,7 +55,7 @@ uint8_t Send_Read_Property_Multiple_Request_Address(
     if (!dcc_communication_enabled()) {
         return 0;
     }
-    invoke_id = tsm_next_free_invokeID();
+    invoke_id = tsm_next_free_invokeID_peer(dest);
     if (invoke_id) {
         /* encode the NPDU portion of the packet */
         datalink_get_my_address(&my_address);
@@ -81,7 +81,7 @@ uint8_t Send_Read_Property_Multiple_Request_Address(
                 debug_perror("Failed to Send ReadPropertyMultiple Request");
             }
         } else {
-            tsm_free_invoke_id(invoke_id);
+            tsm_free_invoke_id_peer(dest, invoke_id);
             invoke_id = 0;
             debug_fprintf(
                 stderr,
@@ -77,3 +77,53 @@ int Send_UEvent_Notify_Device(
 
     return bytes_sent;
 }
+
+/**
+ * @brief Sends an Unconfirmed Alarm/Event Notification from a service
+ *  request body that was encoded once for all of the recipients of an event
+ * @ingroup BIBB-AE-N-A
+ * @param buffer [in,out] The buffer to build the message in for sending.
+ * @param buffer_size [in] Size of the buffer
+ * @param process_id [in] processIdentifier of the recipient
+ * @param body [in] service request from
+ *  event_notify_encode_service_request_body()
+ * @param body_len [in] number of bytes in the service request body
+ * @param dest [in] The destination address information (may be a broadcast).
+ * @return Size of the message sent (bytes), or a negative value on error.
+ */
+int Send_UEvent_Notify_Body(
+    uint8_t *buffer,
+    size_t buffer_size,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len,
+    BACNET_ADDRESS *dest)
+{
+    size_t len = 0;
+    int pdu_len = 0;
+    int bytes_sent = 0;
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+
+    datalink_get_my_address(&my_address);
+    /* encode the NPDU portion of the packet */
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(buffer, dest, &my_address, &npdu_data);
+    /* copy the APDU portion of the packet */
+    if ((size_t)pdu_len < buffer_size) {
+        len = event_notify_encode_apdu_body(
+            &buffer[pdu_len], buffer_size - pdu_len, false, 0, process_id,
+            body, body_len);
+    }
+    if (len == 0) {
+        return -1;
+    }
+    pdu_len += (int)len;
+    /* send the data */
+    bytes_sent = datalink_send_pdu(dest, &npdu_data, &buffer[0], pdu_len);
+    if (bytes_sent <= 0) {
+        debug_perror("Failed to Send EventNotification Request");
+    }
+
+    return bytes_sent;
+}
@@ -37,6 +37,15 @@ int Send_UEvent_Notify_Device(
     const BACNET_EVENT_NOTIFICATION_DATA *data,
     uint32_t device_id);
 
+BACNET_STACK_EXPORT
+int Send_UEvent_Notify_Body(
+    uint8_t *buffer,
+    size_t buffer_size,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len,
+    BACNET_ADDRESS *dest);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -60,6 +60,7 @@
 #include "bacnet/basic/service/s_abort.h"
 #include "bacnet/basic/service/s_ack_alarm.h"
 #include "bacnet/basic/service/s_arfs.h"
+#include "bacnet/basic/service/s_audit.h"
 #include "bacnet/basic/service/s_awfs.h"
 #include "bacnet/basic/service/s_cevent.h"
 #include "bacnet/basic/service/s_cov.h"
@@ -0,0 +1,139 @@
+/**
+ * @file
+ * @brief Arena library of memory carved from one buffer
+ * @details Each allocation bumps an offset into the buffer of the
+ *  caller, after padding it for the alignment of the data types that
+ *  are stored, and the memory is cleared like calloc().  Nothing is
+ *  freed on its own: the whole arena is reset at once, or released back
+ *  to a mark that was taken before, so the cost of releasing does not
+ *  depend on how many pieces were given out.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/arena.h"
+
+/* alignment suitable for the data types stored in the arena */
+union Arena_Align {
+    void *pointer;
+    double real;
+    uint64_t unsigned64;
+};
+#define ARENA_ALIGNMENT sizeof(union Arena_Align)
+
+/**
+ * @brief Initialize an arena to give out the memory of a buffer
+ * @param arena - pointer to the arena
+ * @param buffer - memory that the arena gives out, or NULL for none
+ * @param size - size of the buffer in bytes
+ */
+void Arena_Init(OS_Arena arena, void *buffer, size_t size)
+{
+    if (!arena) {
+        return;
+    }
+    arena->buffer = buffer;
+    arena->size = buffer ? size : 0;
+    arena->used = 0;
+    arena->peak = 0;
+}
+
+/**
+ * @brief Get cleared memory from an arena
+ * @param arena - pointer to the arena
+ * @param size - number of bytes
+ * @return pointer to the memory, aligned for any data type, or NULL if
+ *  the arena does not have that much left
+ */
+void *Arena_Alloc(OS_Arena arena, size_t size)
+{
+    uintptr_t address;
+    size_t padding;
+    uint8_t *memory;
+
+    if (!arena || !arena->buffer || (size == 0)) {
+        return NULL;
+    }
+    address = (uintptr_t)(arena->buffer + arena->used);
+    padding = (ARENA_ALIGNMENT - (address % ARENA_ALIGNMENT)) %
+        ARENA_ALIGNMENT;
+    if ((padding > (arena->size - arena->used)) ||
+        (size > (arena->size - arena->used - padding))) {
+        return NULL;
+    }
+    memory = arena->buffer + arena->used + padding;
+    arena->used += padding + size;
+    if (arena->used > arena->peak) {
+        arena->peak = arena->used;
+    }
+    memset(memory, 0, size);
+
+    return memory;
+}
+
+/**
+ * @brief Get a mark of the memory given out so far, so that the memory
+ *  given out after it can be released with Arena_Release()
+ * @param arena - pointer to the arena
+ * @return the mark
+ */
+size_t Arena_Mark(OS_Arena arena)
+{
+    return arena ? arena->used : 0;
+}
+
+/**
+ * @brief Take back the memory that was given out after a mark
+ * @param arena - pointer to the arena
+ * @param mark - mark from Arena_Mark()
+ */
+void Arena_Release(OS_Arena arena, size_t mark)
+{
+    if (arena && (mark < arena->used)) {
+        arena->used = mark;
+    }
+}
+
+/**
+ * @brief Take back all of the memory of an arena
+ * @param arena - pointer to the arena
+ */
+void Arena_Reset(OS_Arena arena)
+{
+    if (arena) {
+        arena->used = 0;
+    }
+}
+
+/**
+ * @brief Get the number of bytes given out by an arena
+ * @param arena - pointer to the arena
+ * @return number of bytes, including the alignment padding
+ */
+size_t Arena_Used(OS_Arena arena)
+{
+    return arena ? arena->used : 0;
+}
+
+/**
+ * @brief Get the number of bytes that an arena has left
+ * @param arena - pointer to the arena
+ * @return number of bytes, before any alignment padding
+ */
+size_t Arena_Available(OS_Arena arena)
+{
+    return arena ? (arena->size - arena->used) : 0;
+}
+
+/**
+ * @brief Get the largest number of bytes given out by an arena at once,
+ *  to size its buffer
+ * @param arena - pointer to the arena
+ * @return number of bytes
+ */
+size_t Arena_Peak(OS_Arena arena)
+{
+    return arena ? arena->peak : 0;
+}
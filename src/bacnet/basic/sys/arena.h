@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @brief API for an Arena library of memory carved from one buffer
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_ARENA_H
+#define BACNET_SYS_ARENA_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* An arena gives out memory from a buffer of the caller, one piece
+   after the other, and takes all of it back at once with Arena_Reset(),
+   or back to a mark with Arena_Release().  The pieces are not freed one
+   by one, so a result that is built from many small pieces, such as a
+   decoded service request, is released in constant time, and never
+   uses more memory than the buffer. */
+typedef struct Arena {
+    uint8_t *buffer; /* memory given out by the arena */
+    size_t size; /* size of the buffer in bytes */
+    size_t used; /* bytes given out, including the alignment padding */
+    size_t peak; /* largest number of bytes given out since Arena_Init */
+} ARENA_TYPE;
+typedef ARENA_TYPE *OS_Arena;
+
+/* static initializer for an arena of a buffer */
+#define ARENA_INITIALIZER(buffer, size) { (uint8_t *)(buffer), (size), 0, 0 }
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Arena_Init(OS_Arena arena, void *buffer, size_t size);
+
+BACNET_STACK_EXPORT
+void *Arena_Alloc(OS_Arena arena, size_t size);
+
+BACNET_STACK_EXPORT
+size_t Arena_Mark(OS_Arena arena);
+
+BACNET_STACK_EXPORT
+void Arena_Release(OS_Arena arena, size_t mark);
+
+BACNET_STACK_EXPORT
+void Arena_Reset(OS_Arena arena);
+
+BACNET_STACK_EXPORT
+size_t Arena_Used(OS_Arena arena);
+
+BACNET_STACK_EXPORT
+size_t Arena_Available(OS_Arena arena);
+
+BACNET_STACK_EXPORT
+size_t Arena_Peak(OS_Arena arena);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,301 @@
+/**
+ * @file
+ * @brief Binary trace of the BACnet stack hot paths
+ * @details The trace points at the datalinks, the NPDU and APDU
+ * handlers, the TSM, and the COV notifications write fixed size events
+ * in a ring, like a flight recorder.  Each thread writes in a ring of
+ * its own, so writing an event takes no lock and no system call, and the
+ * trace can stay enabled under full load.  A reader copies the events
+ * from the rings without stopping the writers, and then discards the
+ * events that were overwritten while it copied them.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "bacnet/bacint.h"
+#include "bacnet/basic/sys/bactrace.h"
+
+#define BACTRACE_RING_MASK (BACTRACE_RING_SIZE - 1U)
+
+struct bactrace_ring {
+    /* number of events written, which only the owner thread changes */
+    uint32_t head;
+    BACTRACE_EVENT event[BACTRACE_RING_SIZE];
+};
+
+static struct bactrace_ring Bactrace_Ring[BACTRACE_RINGS];
+/* number of threads that asked for a ring */
+static uint32_t Bactrace_Ring_Claims;
+/* events of the threads that did not get a ring */
+static uint32_t Bactrace_Dropped;
+static bactrace_clock_function Bactrace_Clock;
+/* ring of this thread: zero until its first event, then the index of
+   the ring plus one, or more than BACTRACE_RINGS without a ring.  Without
+   thread local storage, all the threads share the first ring, which is
+   only safe when one thread traces. */
+static BACNET_STACK_THREAD_LOCAL unsigned Bactrace_Thread_Ring;
+/* the events of one ring, copied for a trace file */
+static BACTRACE_EVENT Bactrace_Dump_Events[BACTRACE_RING_SIZE];
+
+static const char *Bactrace_Event_Names[BACTRACE_EVENT_MAX] = {
+    "none",       "datalink-receive", "datalink-send", "npdu",
+    "apdu-begin", "apdu-end",         "tsm-state",     "cov-send"
+};
+
+/**
+ * @brief Get the ring of the calling thread, and give it one the first
+ *  time that it is called from a thread
+ * @return the ring, or NULL when all the rings are taken
+ */
+static struct bactrace_ring *bactrace_thread_ring(void)
+{
+    uint32_t index;
+
+    if (Bactrace_Thread_Ring == 0) {
+        index = BACNET_STACK_FETCH_ADD(&Bactrace_Ring_Claims, 1U);
+        if (index < BACTRACE_RINGS) {
+            Bactrace_Thread_Ring = index + 1U;
+        } else {
+            Bactrace_Thread_Ring = BACTRACE_RINGS + 1U;
+        }
+    }
+    if (Bactrace_Thread_Ring > BACTRACE_RINGS) {
+        return NULL;
+    }
+
+    return &Bactrace_Ring[Bactrace_Thread_Ring - 1U];
+}
+
+/**
+ * @brief Write an event in the ring of the calling thread
+ * @param type - one of BACTRACE_EVENT_TYPE
+ * @param arg8 - small argument, depending on the type
+ * @param arg16 - argument, depending on the type
+ * @param arg32_0 - argument, depending on the type
+ * @param arg32_1 - argument, depending on the type
+ */
+void bactrace_event(
+    uint8_t type,
+    uint8_t arg8,
+    uint16_t arg16,
+    uint32_t arg32_0,
+    uint32_t arg32_1)
+{
+    struct bactrace_ring *ring;
+    BACTRACE_EVENT *event;
+    uint32_t head;
+
+    ring = bactrace_thread_ring();
+    if (!ring) {
+        (void)BACNET_STACK_FETCH_ADD(&Bactrace_Dropped, 1U);
+        return;
+    }
+    head = BACNET_STACK_LOAD(&ring->head);
+    event = &ring->event[head & BACTRACE_RING_MASK];
+    event->time = Bactrace_Clock ? Bactrace_Clock() : 0;
+    event->type = type;
+    event->arg8 = arg8;
+    event->arg16 = arg16;
+    event->arg32[0] = arg32_0;
+    event->arg32[1] = arg32_1;
+    /* the event is written before a reader can see it */
+    BACNET_STACK_RELEASE();
+    BACNET_STACK_STORE(&ring->head, head + 1U);
+}
+
+/**
+ * @brief Set the clock of the event times.  Without a clock, the times
+ *  are zero.
+ * @param clock - function returning a free running time in microseconds,
+ *  or NULL
+ */
+void bactrace_clock_set(bactrace_clock_function clock)
+{
+    Bactrace_Clock = clock;
+}
+
+/**
+ * @brief Get the number of rings that are in use, one for each thread
+ *  that has traced
+ * @return number of rings
+ */
+unsigned bactrace_ring_count(void)
+{
+    uint32_t count = BACNET_STACK_LOAD(&Bactrace_Ring_Claims);
+
+    if (count > BACTRACE_RINGS) {
+        count = BACTRACE_RINGS;
+    }
+
+    return (unsigned)count;
+}
+
+/**
+ * @brief Copy the events of a ring that were written since a position,
+ *  while the ring is written.  The events that were overwritten before
+ *  they could be copied are skipped, so the number of them is the new
+ *  position, less the old position, less the number of events copied.
+ * @param ring - index of the ring, less than bactrace_ring_count()
+ * @param position - number of events of the ring that were read before,
+ *  zero to start with the oldest event, and returned with the number of
+ *  events read with this call
+ * @param events - the copied events, oldest first
+ * @param max_events - size of the events buffer
+ * @return number of events copied
+ */
+unsigned bactrace_read(
+    unsigned ring,
+    uint32_t *position,
+    BACTRACE_EVENT *events,
+    unsigned max_events)
+{
+    struct bactrace_ring *pring;
+    uint32_t head, first;
+    unsigned count = 0, skip = 0;
+
+    if ((ring >= bactrace_ring_count()) || !position || !events) {
+        return 0;
+    }
+    pring = &Bactrace_Ring[ring];
+    head = BACNET_STACK_LOAD(&pring->head);
+    BACNET_STACK_ACQUIRE();
+    first = *position;
+    if ((head - first) >= BACTRACE_RING_SIZE) {
+        /* the events after the position were overwritten, and the oldest
+           event is in the slot that the writer writes next */
+        first = head - (BACTRACE_RING_SIZE - 1U);
+    }
+    while (((first + count) != head) && (count < max_events)) {
+        events[count] = pring->event[(first + count) & BACTRACE_RING_MASK];
+        count++;
+    }
+    /* the writer may have overwritten the oldest events while they were
+       copied: the event it writes now is one ring behind its head */
+    BACNET_STACK_ACQUIRE();
+    head = BACNET_STACK_LOAD(&pring->head);
+    while ((skip < count) && ((head - (first + skip)) >= BACTRACE_RING_SIZE)) {
+        skip++;
+    }
+    if (skip > 0) {
+        count -= skip;
+        memmove(&events[0], &events[skip], count * sizeof(BACTRACE_EVENT));
+        first += skip;
+    }
+    *position = first + count;
+
+    return count;
+}
+
+/**
+ * @brief Get the number of events that were not traced because all
+ *  the rings were taken by other threads
+ * @return number of events
+ */
+uint32_t bactrace_dropped(void)
+{
+    return BACNET_STACK_LOAD(&Bactrace_Dropped);
+}
+
+/**
+ * @brief Encode an event for a trace file
+ * @param buffer - BACTRACE_EVENT_SIZE octets for the encoded event
+ * @param event - the event
+ */
+void bactrace_event_encode(uint8_t *buffer, const BACTRACE_EVENT *event)
+{
+    if (buffer && event) {
+        (void)encode_unsigned32(&buffer[0], event->time);
+        buffer[4] = event->type;
+        buffer[5] = event->arg8;
+        (void)encode_unsigned16(&buffer[6], event->arg16);
+        (void)encode_unsigned32(&buffer[8], event->arg32[0]);
+        (void)encode_unsigned32(&buffer[12], event->arg32[1]);
+    }
+}
+
+/**
+ * @brief Decode an event of a trace file
+ * @param buffer - BACTRACE_EVENT_SIZE octets of the encoded event
+ * @param event - the decoded event
+ */
+void bactrace_event_decode(const uint8_t *buffer, BACTRACE_EVENT *event)
+{
+    if (buffer && event) {
+        (void)decode_unsigned32(&buffer[0], &event->time);
+        event->type = buffer[4];
+        event->arg8 = buffer[5];
+        (void)decode_unsigned16(&buffer[6], &event->arg16);
+        (void)decode_unsigned32(&buffer[8], &event->arg32[0]);
+        (void)decode_unsigned32(&buffer[12], &event->arg32[1]);
+    }
+}
+
+/**
+ * @brief Get the name of an event type
+ * @param type - one of BACTRACE_EVENT_TYPE
+ * @return the name, or "unknown"
+ */
+const char *bactrace_event_name(uint8_t type)
+{
+    if (type < BACTRACE_EVENT_MAX) {
+        return Bactrace_Event_Names[type];
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief Write the events of all the rings to a trace file, while the
+ *  rings are written.  It is not reentrant.
+ * @param pathname - name of the trace file, which is replaced
+ * @return true if the file was written
+ */
+bool bactrace_dump(const char *pathname)
+{
+    FILE *file;
+    uint8_t buffer[BACTRACE_FILE_HEADER_SIZE];
+    unsigned rings, ring, count, i;
+    uint32_t position;
+    bool status = true;
+
+    if (!pathname) {
+        return false;
+    }
+    file = fopen(pathname, "wb");
+    if (!file) {
+        return false;
+    }
+    rings = bactrace_ring_count();
+    memcpy(&buffer[0], BACTRACE_FILE_MAGIC, BACTRACE_FILE_MAGIC_SIZE);
+    (void)encode_unsigned16(&buffer[8], BACTRACE_FILE_VERSION);
+    (void)encode_unsigned16(&buffer[10], BACTRACE_EVENT_SIZE);
+    (void)encode_unsigned32(&buffer[12], rings);
+    (void)encode_unsigned32(&buffer[16], bactrace_dropped());
+    if (fwrite(buffer, BACTRACE_FILE_HEADER_SIZE, 1, file) != 1) {
+        status = false;
+    }
+    for (ring = 0; status && (ring < rings); ring++) {
+        position = 0;
+        count = bactrace_read(
+            ring, &position, Bactrace_Dump_Events, BACTRACE_RING_SIZE);
+        (void)encode_unsigned32(&buffer[0], count);
+        (void)encode_unsigned32(&buffer[4], position - count);
+        if (fwrite(buffer, BACTRACE_FILE_RING_HEADER_SIZE, 1, file) != 1) {
+            status = false;
+        }
+        for (i = 0; status && (i < count); i++) {
+            bactrace_event_encode(buffer, &Bactrace_Dump_Events[i]);
+            if (fwrite(buffer, BACTRACE_EVENT_SIZE, 1, file) != 1) {
+                status = false;
+            }
+        }
+    }
+    if (fclose(file) != 0) {
+        status = false;
+    }
+
+    return status;
+}
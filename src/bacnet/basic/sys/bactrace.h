@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief API for the binary trace of the BACnet stack hot paths
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_BACTRACE_H
+#define BACNET_SYS_BACTRACE_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* The stack writes a trace event where it happens when this is enabled.
+   When it is disabled, the BACTRACE_ macros at those places compile
+   to nothing. */
+#ifndef BACNET_TRACE_ENABLED
+#define BACNET_TRACE_ENABLED 0
+#endif
+
+/* Each thread that traces gets a ring of its own, so the events are
+   written without a lock.  The threads after the last ring are not
+   traced, and their events are counted as dropped. */
+#ifndef BACTRACE_RINGS
+#define BACTRACE_RINGS 4
+#endif
+/* number of events in a ring - must be a power of two.  The oldest
+   events are overwritten when a ring is full, and a reader gets at most
+   the newest BACTRACE_RING_SIZE - 1 of them, since the slot of the
+   oldest one is the next one written. */
+#ifndef BACTRACE_RING_SIZE
+#define BACTRACE_RING_SIZE 1024
+#endif
+/* A trace file has a header of the 8 octets of BACTRACE_FILE_MAGIC,
+   the version and the event size as Unsigned16, and the number of rings
+   and of dropped events as Unsigned32.  Each ring follows, with the
+   number of its events and of its overwritten events as Unsigned32, and
+   then its events, oldest first.  The numbers are big endian. */
+#define BACTRACE_FILE_MAGIC "BACTRACE"
+#define BACTRACE_FILE_MAGIC_SIZE 8
+#define BACTRACE_FILE_VERSION 1
+#define BACTRACE_FILE_HEADER_SIZE 20
+#define BACTRACE_FILE_RING_HEADER_SIZE 8
+/* size of an encoded event */
+#define BACTRACE_EVENT_SIZE 16
+
+typedef enum bactrace_event_type {
+    BACTRACE_EVENT_NONE = 0,
+    /* arg8: PERFSTAT_DATALINK, arg16: NPDU length */
+    BACTRACE_EVENT_DATALINK_RECEIVE,
+    /* arg8: PERFSTAT_DATALINK, arg16: NPDU length */
+    BACTRACE_EVENT_DATALINK_SEND,
+    /* arg8: BACTRACE_NPDU, arg16: DNET, arg32[0]: SNET,
+       arg32[1]: NPDU length */
+    BACTRACE_EVENT_NPDU,
+    /* arg8: BACNET_PDU_TYPE, arg16: APDU length */
+    BACTRACE_EVENT_APDU_BEGIN,
+    /* arg8: BACNET_PDU_TYPE, arg16: service choice */
+    BACTRACE_EVENT_APDU_END,
+    /* arg8: BACNET_TSM_STATE, arg16: invoke ID,
+       arg32[0]: index of the transaction, arg32[1]: number of retries */
+    BACTRACE_EVENT_TSM_STATE,
+    /* arg8: true if confirmed, arg16: number of notifications,
+       arg32[0]: object identifier, arg32[1]: subscriber process ID */
+    BACTRACE_EVENT_COV_SEND,
+    BACTRACE_EVENT_MAX
+} BACTRACE_EVENT_TYPE;
+
+/* what the NPDU handler did with an NPDU */
+typedef enum bactrace_npdu {
+    BACTRACE_NPDU_APDU = 0,
+    BACTRACE_NPDU_NETWORK_MESSAGE,
+    BACTRACE_NPDU_DISCARDED,
+    BACTRACE_NPDU_DECODE_ERROR
+} BACTRACE_NPDU;
+
+typedef struct bactrace_event {
+    /* microseconds, from the trace clock */
+    uint32_t time;
+    /* one of BACTRACE_EVENT_TYPE */
+    uint8_t type;
+    uint8_t arg8;
+    uint16_t arg16;
+    uint32_t arg32[2];
+} BACTRACE_EVENT;
+
+/**
+ * @brief Callback for a free running clock
+ * @return the time in microseconds
+ */
+typedef uint32_t (*bactrace_clock_function)(void);
+
+#if BACNET_TRACE_ENABLED
+#define BACTRACE_DATALINK_RECEIVE(datalink, len)              \
+    bactrace_event(                                           \
+        BACTRACE_EVENT_DATALINK_RECEIVE, (uint8_t)(datalink), \
+        (uint16_t)(len), 0, 0)
+#define BACTRACE_DATALINK_SEND(datalink, len)              \
+    bactrace_event(                                        \
+        BACTRACE_EVENT_DATALINK_SEND, (uint8_t)(datalink), \
+        (uint16_t)(len), 0, 0)
+#define BACTRACE_NPDU(disposition, dnet, snet, len)                    \
+    bactrace_event(                                                    \
+        BACTRACE_EVENT_NPDU, (uint8_t)(disposition), (uint16_t)(dnet), \
+        (uint32_t)(snet), (uint32_t)(len))
+#define BACTRACE_APDU_BEGIN(pdu_type, len) \
+    bactrace_event(                        \
+        BACTRACE_EVENT_APDU_BEGIN, (uint8_t)(pdu_type), (uint16_t)(len), 0, 0)
+#define BACTRACE_APDU_END(pdu_type, service)                               \
+    bactrace_event(                                                        \
+        BACTRACE_EVENT_APDU_END, (uint8_t)(pdu_type), (uint16_t)(service), \
+        0, 0)
+#define BACTRACE_TSM_STATE(state, invoke_id, index, retries)               \
+    bactrace_event(                                                        \
+        BACTRACE_EVENT_TSM_STATE, (uint8_t)(state), (uint16_t)(invoke_id), \
+        (uint32_t)(index), (uint32_t)(retries))
+#define BACTRACE_COV_SEND(confirmed, count, object_id, process_id)        \
+    bactrace_event(                                                       \
+        BACTRACE_EVENT_COV_SEND, (uint8_t)(confirmed), (uint16_t)(count), \
+        (uint32_t)(object_id), (uint32_t)(process_id))
+#else
+#define BACTRACE_DATALINK_RECEIVE(datalink, len) ((void)0)
+#define BACTRACE_DATALINK_SEND(datalink, len) ((void)0)
+#define BACTRACE_NPDU(disposition, dnet, snet, len) ((void)0)
+#define BACTRACE_APDU_BEGIN(pdu_type, len) ((void)0)
+#define BACTRACE_APDU_END(pdu_type, service) ((void)0)
+#define BACTRACE_TSM_STATE(state, invoke_id, index, retries) ((void)0)
+#define BACTRACE_COV_SEND(confirmed, count, object_id, process_id) ((void)0)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bactrace_event(
+    uint8_t type,
+    uint8_t arg8,
+    uint16_t arg16,
+    uint32_t arg32_0,
+    uint32_t arg32_1);
+
+BACNET_STACK_EXPORT
+void bactrace_clock_set(bactrace_clock_function clock);
+
+BACNET_STACK_EXPORT
+unsigned bactrace_ring_count(void);
+BACNET_STACK_EXPORT
+unsigned bactrace_read(
+    unsigned ring,
+    uint32_t *position,
+    BACTRACE_EVENT *events,
+    unsigned max_events);
+BACNET_STACK_EXPORT
+uint32_t bactrace_dropped(void);
+
+BACNET_STACK_EXPORT
+void bactrace_event_encode(uint8_t *buffer, const BACTRACE_EVENT *event);
+BACNET_STACK_EXPORT
+void bactrace_event_decode(const uint8_t *buffer, BACTRACE_EVENT *event);
+BACNET_STACK_EXPORT
+const char *bactrace_event_name(uint8_t type);
+BACNET_STACK_EXPORT
+bool bactrace_dump(const char *pathname);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
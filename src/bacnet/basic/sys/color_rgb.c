@@ -622,3 +622,245 @@ void color_rgb_from_temperature(
         *b = (uint8_t)blue;
     }
 }
+
+/* The fast conversions use tables instead of pow() and log(), in single
+   precision.  The tables are filled from the accurate functions above
+   when a fast conversion is first used. */
+/* linear value 0.0..1.0 of each gamma corrected sRGB value 0..255 */
+static float Color_Gamma_Linear[256];
+/* sRGB of each hundred Kelvin from 1000 K to 40000 K */
+#define COLOR_KELVIN_MIN 10
+#define COLOR_KELVIN_MAX 400
+static uint8_t Color_Kelvin_RGB[COLOR_KELVIN_MAX - COLOR_KELVIN_MIN + 1][3];
+static bool Color_Table_Initialized;
+
+/**
+ * @brief Fill the tables of the fast conversions
+ */
+static void color_rgb_table_init(void)
+{
+    float value;
+    unsigned i;
+
+    if (Color_Table_Initialized) {
+        return;
+    }
+    for (i = 0; i < 256; i++) {
+        /* the same gamma correction as color_rgb_to_xy_gamma() */
+        value = (float)i / 255.0f;
+        value = (value > 0.04045f)
+            ? (float)pow(((double)value + 0.055) / (1.0 + 0.055), 2.4)
+            : (value / 12.92f);
+        Color_Gamma_Linear[i] = value;
+    }
+    for (i = COLOR_KELVIN_MIN; i <= COLOR_KELVIN_MAX; i++) {
+        color_rgb_from_temperature(
+            (uint16_t)(i * 100), &Color_Kelvin_RGB[i - COLOR_KELVIN_MIN][0],
+            &Color_Kelvin_RGB[i - COLOR_KELVIN_MIN][1],
+            &Color_Kelvin_RGB[i - COLOR_KELVIN_MIN][2]);
+    }
+    Color_Table_Initialized = true;
+}
+
+/**
+ * @brief Convert a linear value to a gamma corrected sRGB value by a
+ *  binary search of the linear value of each sRGB value
+ * @param linear - linear value 0.0..1.0
+ * @return the largest sRGB value 0..255 whose linear value is not
+ *  more than the linear value
+ */
+static uint8_t color_rgb_gamma_encode(float linear)
+{
+    unsigned low = 0, high = 255, mid;
+
+    if (!(linear > 0.0f)) {
+        return 0;
+    }
+    if (linear >= Color_Gamma_Linear[255]) {
+        return 255;
+    }
+    while (low < high) {
+        mid = (low + high + 1) / 2;
+        if (Color_Gamma_Linear[mid] <= linear) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return (uint8_t)low;
+}
+
+/**
+ * @brief Convert sRGB to CIE xy, with gamma correction from a table
+ * @param r - R value of sRGB 0..255
+ * @param g - G value of sRGB 0..255
+ * @param b - B value of sRGB 0..255
+ * @param x_coordinate - return x of CIE xy 0.0..1.0
+ * @param y_coordinate - return y of CIE xy 0.0..1.0
+ * @param brightness - return brightness of the CIE xy color 0..255
+ * @note same as color_rgb_to_xy_gamma(), without pow()
+ */
+void color_rgb_to_xy_gamma_fast(
+    uint8_t r,
+    uint8_t g,
+    uint8_t b,
+    float *x_coordinate,
+    float *y_coordinate,
+    uint8_t *brightness)
+{
+    float red, green, blue;
+    float X, Y, Z, sum;
+    float x = 0.0f, y = 0.0f;
+
+    color_rgb_table_init();
+    red = Color_Gamma_Linear[r];
+    green = Color_Gamma_Linear[g];
+    blue = Color_Gamma_Linear[b];
+    /* Wide RGB D65 conversion */
+    X = red * 0.649926f + green * 0.103455f + blue * 0.197109f;
+    Y = red * 0.234327f + green * 0.743075f + blue * 0.022598f;
+    Z = green * 0.053077f + blue * 1.035763f;
+    sum = X + Y + Z;
+    if (sum > 0.0f) {
+        x = X / sum;
+        y = Y / sum;
+    }
+    if (x_coordinate) {
+        *x_coordinate = (x > 1.0f) ? 1.0f : x;
+    }
+    if (y_coordinate) {
+        *y_coordinate = (y > 1.0f) ? 1.0f : y;
+    }
+    Y = Y * 255.0f;
+    if (brightness) {
+        *brightness = (Y > 255.0f) ? 255 : (uint8_t)Y;
+    }
+}
+
+/**
+ * @brief Convert sRGB from CIE xy and brightness, with gamma correction
+ *  from a table
+ * @param red - return R value of sRGB
+ * @param green - return G value of sRGB
+ * @param blue - return B value of sRGB
+ * @param x_coordinate - x of CIE xy
+ * @param y_coordinate - y of CIE xy
+ * @param brightness - brightness of the CIE xy color
+ * @note same as color_rgb_from_xy_gamma(), without pow()
+ */
+void color_rgb_from_xy_gamma_fast(
+    uint8_t *red,
+    uint8_t *green,
+    uint8_t *blue,
+    float x_coordinate,
+    float y_coordinate,
+    uint8_t brightness)
+{
+    float z, X, Y, Z;
+
+    color_rgb_table_init();
+    z = 1.0f - x_coordinate - y_coordinate;
+    Y = (float)brightness / 255.0f;
+    X = x_coordinate * (Y / y_coordinate);
+    Z = z * (Y / y_coordinate);
+    if (red) {
+        *red = color_rgb_gamma_encode(
+            X * 1.4628067f - Y * 0.1840623f - Z * 0.2743606f);
+    }
+    if (green) {
+        *green = color_rgb_gamma_encode(
+            -X * 0.5217933f + Y * 1.4472381f + Z * 0.0677227f);
+    }
+    if (blue) {
+        *blue = color_rgb_gamma_encode(
+            X * 0.0349342f - Y * 0.0968930f + Z * 1.2884099f);
+    }
+}
+
+/**
+ * @brief Convert the CIE xy and brightness of many colors to sRGB,
+ *  with gamma correction from a table
+ * @param rgb - return R, G, and B value of each color
+ * @param x_coordinate - x of CIE xy of each color
+ * @param y_coordinate - y of CIE xy of each color
+ * @param brightness - brightness of each color
+ * @param count - number of colors
+ */
+void color_rgb_from_xy_gamma_batch(
+    uint8_t *rgb,
+    const float *x_coordinate,
+    const float *y_coordinate,
+    const uint8_t *brightness,
+    size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        color_rgb_from_xy_gamma_fast(
+            &rgb[i * 3], &rgb[i * 3 + 1], &rgb[i * 3 + 2], x_coordinate[i],
+            y_coordinate[i], brightness[i]);
+    }
+}
+
+/**
+ * @brief Return an RGB color from a color temperature in Kelvin, from a
+ *  table of each hundred Kelvin with linear interpolation between them
+ * @param temperature_kelvin - color temperature 1000..40000 K
+ * @param r - return R value of sRGB
+ * @param g - return G value of sRGB
+ * @param b - return B value of sRGB
+ * @note same as color_rgb_from_temperature() at each hundred Kelvin,
+ *  and without its steps of a hundred Kelvin in between
+ */
+void color_rgb_from_temperature_fast(
+    uint16_t temperature_kelvin, uint8_t *r, uint8_t *g, uint8_t *b)
+{
+    const uint8_t *low, *high;
+    unsigned index, fraction;
+    uint8_t rgb[3];
+    unsigned i;
+
+    color_rgb_table_init();
+    if (temperature_kelvin < (COLOR_KELVIN_MIN * 100)) {
+        temperature_kelvin = COLOR_KELVIN_MIN * 100;
+    } else if (temperature_kelvin > (COLOR_KELVIN_MAX * 100)) {
+        temperature_kelvin = COLOR_KELVIN_MAX * 100;
+    }
+    index = (temperature_kelvin / 100) - COLOR_KELVIN_MIN;
+    fraction = temperature_kelvin % 100;
+    low = Color_Kelvin_RGB[index];
+    high = (fraction > 0) ? Color_Kelvin_RGB[index + 1] : low;
+    for (i = 0; i < 3; i++) {
+        rgb[i] = (uint8_t)(((unsigned)low[i] * (100 - fraction) +
+                            (unsigned)high[i] * fraction) /
+                           100);
+    }
+    if (r) {
+        *r = rgb[0];
+    }
+    if (g) {
+        *g = rgb[1];
+    }
+    if (b) {
+        *b = rgb[2];
+    }
+}
+
+/**
+ * @brief Return the RGB colors of many color temperatures in Kelvin
+ * @param rgb - return R, G, and B value of each color
+ * @param temperature_kelvin - color temperature of each color
+ * @param count - number of colors
+ */
+void color_rgb_from_temperature_batch(
+    uint8_t *rgb, const uint16_t *temperature_kelvin, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        color_rgb_from_temperature_fast(
+            temperature_kelvin[i], &rgb[i * 3], &rgb[i * 3 + 1],
+            &rgb[i * 3 + 2]);
+    }
+}
@@ -7,6 +7,7 @@
  */
 #ifndef BACNET_SYS_COLOR_RGB_H
 #define BACNET_SYS_COLOR_RGB_H
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 /* BACnet Stack defines - first */
@@ -75,6 +76,38 @@ BACNET_STACK_EXPORT
 void color_rgb_from_temperature(
     uint16_t temperature_kelvin, uint8_t *r, uint8_t *g, uint8_t *b);
 
+/* fast conversions from tables, in single precision, for the fades and
+   the outputs of many fixtures */
+BACNET_STACK_EXPORT
+void color_rgb_to_xy_gamma_fast(
+    uint8_t r,
+    uint8_t g,
+    uint8_t b,
+    float *x_coordinate,
+    float *y_coordinate,
+    uint8_t *brightness);
+BACNET_STACK_EXPORT
+void color_rgb_from_xy_gamma_fast(
+    uint8_t *red,
+    uint8_t *green,
+    uint8_t *blue,
+    float x_coordinate,
+    float y_coordinate,
+    uint8_t brightness);
+BACNET_STACK_EXPORT
+void color_rgb_from_xy_gamma_batch(
+    uint8_t *rgb,
+    const float *x_coordinate,
+    const float *y_coordinate,
+    const uint8_t *brightness,
+    size_t count);
+BACNET_STACK_EXPORT
+void color_rgb_from_temperature_fast(
+    uint16_t temperature_kelvin, uint8_t *r, uint8_t *g, uint8_t *b);
+BACNET_STACK_EXPORT
+void color_rgb_from_temperature_batch(
+    uint8_t *rgb, const uint16_t *temperature_kelvin, size_t count);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
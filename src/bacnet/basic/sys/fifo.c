@@ -10,7 +10,9 @@
  * This library only uses a byte sized chunk for a data element.
  * It uses a data store whose size is a power of 2 (8, 16, 32, 64, ...)
  * and doesn't waste any data bytes.  It has very low overhead, and
- * utilizes modulo for indexing the data in the data store.
+ * utilizes a mask for indexing the data in the data store.  Bytes are
+ * added and pulled in bulk with one copy before the end of the data
+ * store and one copy after it.
  *
  * To use this library, first declare a data store, sized for a power of 2:
  * {@code
@@ -61,8 +63,60 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/basic/sys/fifo.h"
 
+/* The producer only moves the head and the consumer only moves the tail.
+   The fences order the data with the index that hands it over, so the
+   bulk copies, which are not volatile, are done before the index moves,
+   and an interrupt or thread on one side needs no lock.  The fences are
+   BACNET_STACK_ACQUIRE() and BACNET_STACK_RELEASE() from platform.h. */
+
+/* index of a free running head or tail in the data store */
+#define FIFO_INDEX(b, n) ((n) & ((b)->buffer_len - 1))
+
+/**
+ * @brief Copy bytes out of the data store, in the span up to the end
+ *  of the data store and the span from its start
+ * @param b - pointer to FIFO_BUFFER structure
+ * @param tail - free running index of the first byte
+ * @param buffer [out] - buffer to hold the bytes
+ * @param count - number of bytes to copy
+ */
+static void FIFO_Copy_Out(
+    FIFO_BUFFER const *b, unsigned tail, uint8_t *buffer, unsigned count)
+{
+    unsigned index = FIFO_INDEX(b, tail);
+    unsigned span = b->buffer_len - index;
+
+    if (span > count) {
+        span = count;
+    }
+    memcpy(buffer, (const uint8_t *)&b->buffer[index], span);
+    memcpy(&buffer[span], (const uint8_t *)&b->buffer[0], count - span);
+}
+
+/**
+ * @brief Copy bytes into the data store, in the span up to the end
+ *  of the data store and the span from its start
+ * @param b - pointer to FIFO_BUFFER structure
+ * @param head - free running index of the first byte
+ * @param buffer [in] - the bytes
+ * @param count - number of bytes to copy
+ */
+static void FIFO_Copy_In(
+    FIFO_BUFFER *b, unsigned head, const uint8_t *buffer, unsigned count)
+{
+    unsigned index = FIFO_INDEX(b, head);
+    unsigned span = b->buffer_len - index;
+
+    if (span > count) {
+        span = count;
+    }
+    memcpy((uint8_t *)&b->buffer[index], buffer, span);
+    memcpy((uint8_t *)&b->buffer[0], &buffer[span], count - span);
+}
+
 /**
  * Returns the number of bytes in the FIFO
  *
@@ -77,6 +131,8 @@ unsigned FIFO_Count(FIFO_BUFFER const *b)
     if (b) {
         head = b->head;
         tail = b->tail;
+        /* the data is not read or written before the indexes */
+        BACNET_STACK_ACQUIRE();
         return head - tail;
     } else {
         return 0;
@@ -134,7 +190,7 @@ uint8_t FIFO_Peek(FIFO_BUFFER const *b)
     unsigned index;
 
     if (b) {
-        index = b->tail % b->buffer_len;
+        index = FIFO_INDEX(b, b->tail);
         return (b->buffer[index]);
     }
 
@@ -153,9 +209,6 @@ uint8_t FIFO_Peek(FIFO_BUFFER const *b)
 unsigned FIFO_Peek_Ahead(FIFO_BUFFER const *b, uint8_t *buffer, unsigned length)
 {
     unsigned count = 0;
-    unsigned index;
-    unsigned tail;
-    unsigned i;
 
     if (b) {
         count = FIFO_Count(b);
@@ -163,11 +216,8 @@ unsigned FIFO_Peek_Ahead(FIFO_BUFFER const *b, uint8_t *buffer, unsigned length)
             /* adjust to limit the number of bytes peeked */
             count = length;
         }
-        tail = b->tail;
-        for (i = 0; i < count; i++) {
-            index = tail % b->buffer_len;
-            buffer[i] = b->buffer[index];
-            tail++;
+        if (buffer) {
+            FIFO_Copy_Out(b, b->tail, buffer, count);
         }
     }
 
@@ -190,8 +240,9 @@ uint8_t FIFO_Get(FIFO_BUFFER *b)
     unsigned index;
 
     if (!FIFO_Empty(b)) {
-        index = b->tail % b->buffer_len;
+        index = FIFO_INDEX(b, b->tail);
         data_byte = b->buffer[index];
+        BACNET_STACK_RELEASE();
         b->tail++;
     }
     return data_byte;
@@ -211,30 +262,21 @@ uint8_t FIFO_Get(FIFO_BUFFER *b)
 unsigned FIFO_Pull(FIFO_BUFFER *b, uint8_t *buffer, unsigned length)
 {
     unsigned count;
-    uint8_t data_byte;
-    unsigned index;
 
     count = FIFO_Count(b);
     if (count > length) {
         /* adjust to limit the number of bytes pulled */
         count = length;
     }
-    if (length > count) {
-        /* adjust the return value */
-        length = count;
-    }
-    while (count) {
-        index = b->tail % b->buffer_len;
-        data_byte = b->buffer[index];
-        b->tail++;
+    if (count) {
         if (buffer) {
-            *buffer = data_byte;
-            buffer++;
+            FIFO_Copy_Out(b, b->tail, buffer, count);
         }
-        count--;
+        BACNET_STACK_RELEASE();
+        b->tail += count;
     }
 
-    return length;
+    return count;
 }
 
 /**
@@ -253,8 +295,9 @@ bool FIFO_Put(FIFO_BUFFER *b, uint8_t data_byte)
     if (b) {
         /* limit the buffer to prevent overwriting */
         if (!FIFO_Full(b)) {
-            index = b->head % b->buffer_len;
+            index = FIFO_INDEX(b, b->head);
             b->buffer[index] = data_byte;
+            BACNET_STACK_RELEASE();
             b->head++;
             status = true;
         }
@@ -275,17 +318,12 @@ bool FIFO_Put(FIFO_BUFFER *b, uint8_t data_byte)
 bool FIFO_Add(FIFO_BUFFER *b, const uint8_t *buffer, unsigned count)
 {
     bool status = false; /* return value */
-    unsigned index;
 
     /* limit the buffer to prevent overwriting */
     if (FIFO_Available(b, count) && buffer) {
-        while (count) {
-            index = b->head % b->buffer_len;
-            b->buffer[index] = *buffer;
-            b->head++;
-            buffer++;
-            count--;
-        }
+        FIFO_Copy_In(b, b->head, buffer, count);
+        BACNET_STACK_RELEASE();
+        b->head += count;
         status = true;
     }
 
@@ -314,13 +352,19 @@ void FIFO_Flush(FIFO_BUFFER *b)
  *
  * @param  b - pointer to FIFO_BUFFER structure
  * @param  buffer [in] - data bytes used to store bytes used by the FIFO
- * @param  buffer_len [in] - size of the buffer in bytes - must be power of 2.
+ * @param  buffer_len [in] - size of the buffer in bytes - should be a
+ *  power of 2, such as a FIFO_DATA_STORE(), else only the largest power
+ *  of 2 that fits in the buffer is used.
  *
  * @return      none
  */
 void FIFO_Init(FIFO_BUFFER *b, volatile uint8_t *buffer, unsigned buffer_len)
 {
     if (b && buffer && buffer_len) {
+        /* the indexes are masked, so clear all but the highest bit */
+        while (buffer_len & (buffer_len - 1)) {
+            buffer_len &= buffer_len - 1;
+        }
         b->head = 0;
         b->tail = 0;
         b->buffer = buffer;
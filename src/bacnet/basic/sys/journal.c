@@ -0,0 +1,593 @@
+/**
+ * @file
+ * @brief An append-only journal of property values in flash
+ * @details Each successful WriteProperty is kept as a record of the
+ *  property key and its encoded value.  Records wait in a RAM cache,
+ *  where a newer value of the same property replaces the older one, and
+ *  the cache is programmed into flash in one write when it fills or when
+ *  its oldest record has waited long enough.  Records are only appended,
+ *  so flash is erased only when the active bank is full.  Then the latest
+ *  value of each property is copied into the other bank, which becomes
+ *  the active bank, so that the two banks wear evenly and a restart
+ *  replays no more than one bank of records.  A bank is marked active
+ *  only after its records are programmed, so a power failure during the
+ *  copy leaves the older bank in use.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/bacint.h"
+#include "bacnet/datalink/crc.h"
+#include "bacnet/basic/sys/journal.h"
+
+/* the bank header */
+#define JOURNAL_MAGIC 0x4A4EU
+#define JOURNAL_VERSION 1U
+/* the length of a record that was never programmed */
+#define JOURNAL_ERASED_LENGTH 0xFFFFU
+
+/**
+ * @brief Compute the CRC of the octets of a record
+ * @param data - the octets
+ * @param length - number of octets
+ * @return the CRC-16 value
+ */
+static uint16_t journal_crc(const uint8_t *data, size_t length)
+{
+    return CRC_Calc_Data_Block(data, length, 0xFFFF);
+}
+
+/**
+ * @brief Get the size of a record from its header
+ * @param header - the record header
+ * @return the number of octets of the record, or 0 if the header is
+ *  erased or is not a record
+ */
+static size_t journal_record_size(const uint8_t *header)
+{
+    uint16_t data_len = 0;
+
+    decode_unsigned16(&header[0], &data_len);
+    if ((data_len == JOURNAL_ERASED_LENGTH) ||
+        (data_len > BACNET_JOURNAL_DATA_MAX)) {
+        return 0;
+    }
+
+    return BACNET_JOURNAL_RECORD_SIZE(data_len);
+}
+
+/**
+ * @brief Determine if two record headers are for the same property
+ * @param header - one record header
+ * @param other - the other record header
+ * @return true if the object, property, and array index are the same
+ */
+static bool journal_key_same(const uint8_t *header, const uint8_t *other)
+{
+    /* the key follows the length */
+    return memcmp(&header[2], &other[2], 14) == 0;
+}
+
+/**
+ * @brief Encode the header of a record
+ * @param header - buffer for BACNET_JOURNAL_RECORD_HEADER_SIZE octets
+ * @param record - the record
+ */
+static void
+journal_header_encode(uint8_t *header, const BACNET_JOURNAL_RECORD *record)
+{
+    encode_unsigned16(&header[0], (uint16_t)record->application_data_len);
+    encode_unsigned16(&header[2], (uint16_t)record->object_type);
+    encode_unsigned32(&header[4], record->object_instance);
+    encode_unsigned32(&header[8], (uint32_t)record->object_property);
+    encode_unsigned32(&header[12], record->array_index);
+}
+
+/**
+ * @brief Decode a record that is held in a buffer
+ * @param data - the record octets
+ * @param record - the record that points into the buffer
+ */
+static void
+journal_record_decode(const uint8_t *data, BACNET_JOURNAL_RECORD *record)
+{
+    uint16_t unsigned16 = 0;
+    uint32_t unsigned32 = 0;
+
+    decode_unsigned16(&data[0], &unsigned16);
+    record->application_data_len = unsigned16;
+    decode_unsigned16(&data[2], &unsigned16);
+    record->object_type = (BACNET_OBJECT_TYPE)unsigned16;
+    decode_unsigned32(&data[4], &record->object_instance);
+    decode_unsigned32(&data[8], &unsigned32);
+    record->object_property = (BACNET_PROPERTY_ID)unsigned32;
+    decode_unsigned32(&data[12], &unsigned32);
+    record->array_index = unsigned32;
+    record->application_data = &data[BACNET_JOURNAL_RECORD_HEADER_SIZE];
+}
+
+/**
+ * @brief Read a whole record from a bank into the scratch buffer
+ * @param journal - the journal
+ * @param bank - the bank number
+ * @param offset - offset of the record in the bank
+ * @param limit - offset just past the last octet that may be read
+ * @return the number of octets of the record, or 0 if there is no valid
+ *  record at the offset
+ */
+static size_t journal_record_read(
+    BACNET_JOURNAL *journal, unsigned bank, uint32_t offset, uint32_t limit)
+{
+    const BACNET_JOURNAL_STORAGE *storage = journal->storage;
+    uint8_t *data = &journal->scratch[0];
+    size_t size = 0;
+    uint16_t crc = 0;
+
+    if ((offset > limit) ||
+        ((limit - offset) < BACNET_JOURNAL_RECORD_HEADER_SIZE)) {
+        return 0;
+    }
+    if (!storage->read(
+            storage->context, bank, offset, data,
+            BACNET_JOURNAL_RECORD_HEADER_SIZE)) {
+        return 0;
+    }
+    size = journal_record_size(data);
+    if ((size == 0) || (size > (limit - offset))) {
+        return 0;
+    }
+    if (!storage->read(
+            storage->context, bank, offset + BACNET_JOURNAL_RECORD_HEADER_SIZE,
+            &data[BACNET_JOURNAL_RECORD_HEADER_SIZE],
+            size - BACNET_JOURNAL_RECORD_HEADER_SIZE)) {
+        return 0;
+    }
+    decode_unsigned16(&data[size - BACNET_JOURNAL_RECORD_TRAILER_SIZE], &crc);
+    if (crc != journal_crc(data, size - BACNET_JOURNAL_RECORD_TRAILER_SIZE)) {
+        return 0;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Read the header of a bank
+ * @param journal - the journal
+ * @param bank - the bank number
+ * @param sequence - the sequence number of the bank, if it is valid
+ * @return true if the bank holds a journal
+ */
+static bool
+journal_bank_valid(BACNET_JOURNAL *journal, unsigned bank, uint32_t *sequence)
+{
+    const BACNET_JOURNAL_STORAGE *storage = journal->storage;
+    uint8_t header[BACNET_JOURNAL_BANK_HEADER_SIZE] = { 0 };
+    uint16_t magic = 0;
+
+    if (!storage->read(storage->context, bank, 0, header, sizeof(header))) {
+        return false;
+    }
+    decode_unsigned16(&header[0], &magic);
+    if ((magic != JOURNAL_MAGIC) || (header[2] != JOURNAL_VERSION)) {
+        return false;
+    }
+    decode_unsigned32(&header[4], sequence);
+
+    return true;
+}
+
+/**
+ * @brief Mark a bank as holding the journal
+ * @param journal - the journal
+ * @param bank - the bank number
+ * @param sequence - the sequence number of the bank
+ * @return true if the header was programmed
+ */
+static bool journal_bank_header_write(
+    BACNET_JOURNAL *journal, unsigned bank, uint32_t sequence)
+{
+    const BACNET_JOURNAL_STORAGE *storage = journal->storage;
+    uint8_t header[BACNET_JOURNAL_BANK_HEADER_SIZE] = { 0 };
+
+    encode_unsigned16(&header[0], JOURNAL_MAGIC);
+    header[2] = JOURNAL_VERSION;
+    header[3] = 0;
+    encode_unsigned32(&header[4], sequence);
+
+    return storage->write(storage->context, bank, 0, header, sizeof(header));
+}
+
+/**
+ * @brief Erase a bank of the journal
+ * @param journal - the journal
+ * @param bank - the bank number
+ * @return true if the bank was erased
+ */
+static bool journal_bank_erase(BACNET_JOURNAL *journal, unsigned bank)
+{
+    const BACNET_JOURNAL_STORAGE *storage = journal->storage;
+
+    journal->erase_count++;
+
+    return storage->erase(storage->context, bank);
+}
+
+/**
+ * @brief Find a record for a property in the RAM cache
+ * @param journal - the journal
+ * @param header - a record header with the property key
+ * @param size - the size of the record that was found
+ * @return the offset of the record in the cache, or the cache length
+ *  if there is none
+ */
+static size_t journal_cache_find(
+    const BACNET_JOURNAL *journal, const uint8_t *header, size_t *size)
+{
+    size_t offset = 0;
+    size_t record_size = 0;
+
+    while (offset < journal->cache_len) {
+        record_size = journal_record_size(&journal->cache[offset]);
+        if (record_size == 0) {
+            break;
+        }
+        if (journal_key_same(&journal->cache[offset], header)) {
+            *size = record_size;
+            return offset;
+        }
+        offset += record_size;
+    }
+
+    return journal->cache_len;
+}
+
+/**
+ * @brief Determine if a later record in the active bank or in the cache
+ *  holds a newer value of the property
+ * @param journal - the journal
+ * @param offset - offset of the first record after the one to check
+ * @param header - the header of the record to check
+ * @return true if the record is superseded
+ */
+static bool journal_superseded(
+    BACNET_JOURNAL *journal, uint32_t offset, const uint8_t *header)
+{
+    const BACNET_JOURNAL_STORAGE *storage = journal->storage;
+    uint8_t other[BACNET_JOURNAL_RECORD_HEADER_SIZE] = { 0 };
+    size_t size = 0;
+
+    if (journal_cache_find(journal, header, &size) < journal->cache_len) {
+        return true;
+    }
+    /* the records before the offset of the active bank were checked
+       when the journal was opened or programmed */
+    while ((journal->offset - offset) >= BACNET_JOURNAL_RECORD_HEADER_SIZE) {
+        if (!storage->read(
+                storage->context, journal->bank, offset, other,
+                sizeof(other))) {
+            break;
+        }
+        size = journal_record_size(other);
+        if (size == 0) {
+            break;
+        }
+        if (journal_key_same(other, header)) {
+            return true;
+        }
+        offset += size;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Copy the latest value of each property into the other bank,
+ *  and make it the active bank
+ * @param journal - the journal
+ * @return true if the other bank is now the active bank
+ */
+static bool journal_compact(BACNET_JOURNAL *journal)
+{
+    const BACNET_JOURNAL_STORAGE *storage = journal->storage;
+    uint8_t header[BACNET_JOURNAL_RECORD_HEADER_SIZE] = { 0 };
+    unsigned bank = journal->bank ^ 1U;
+    uint32_t source = BACNET_JOURNAL_BANK_HEADER_SIZE;
+    uint32_t offset = BACNET_JOURNAL_BANK_HEADER_SIZE;
+    size_t size = 0;
+
+    if (!journal_bank_erase(journal, bank)) {
+        return false;
+    }
+    while (source < journal->offset) {
+        size = journal_record_read(
+            journal, journal->bank, source, journal->offset);
+        if (size == 0) {
+            break;
+        }
+        source += size;
+        memcpy(header, journal->scratch, sizeof(header));
+        if (journal_superseded(journal, source, header)) {
+            continue;
+        }
+        if (size > (storage->bank_size - offset)) {
+            return false;
+        }
+        if (!storage->write(
+                storage->context, bank, offset, journal->scratch, size)) {
+            return false;
+        }
+        offset += size;
+    }
+    if (!journal_bank_header_write(journal, bank, journal->sequence + 1)) {
+        return false;
+    }
+    journal->bank = bank;
+    journal->sequence++;
+    journal->offset = offset;
+    journal->sealed = false;
+
+    return true;
+}
+
+/**
+ * @brief Open the journal in its storage, and find where the next
+ *  record goes.  Empty storage is made into an empty journal.
+ * @param journal - the journal
+ * @param storage - the two banks of storage, which must stay valid
+ *  while the journal is used
+ * @return true if the journal is ready for use
+ */
+bool bacnet_journal_init(
+    BACNET_JOURNAL *journal, const BACNET_JOURNAL_STORAGE *storage)
+{
+    uint32_t sequence[2] = { 0, 0 };
+    bool valid[2] = { false, false };
+    uint8_t header[BACNET_JOURNAL_RECORD_HEADER_SIZE] = { 0 };
+    uint32_t remaining = 0;
+    size_t size = 0;
+    unsigned bank = 0;
+    size_t i = 0;
+
+    if (!journal) {
+        return false;
+    }
+    memset(journal, 0, sizeof(*journal));
+    if (!storage || !storage->read || !storage->write || !storage->erase ||
+        (storage->bank_size <
+         (BACNET_JOURNAL_BANK_HEADER_SIZE + BACNET_JOURNAL_RECORD_SIZE_MAX))) {
+        return false;
+    }
+    journal->storage = storage;
+    for (bank = 0; bank < 2; bank++) {
+        valid[bank] = journal_bank_valid(journal, bank, &sequence[bank]);
+    }
+    if (!valid[0] && !valid[1]) {
+        journal->bank = 0;
+        journal->sequence = 1;
+        journal->offset = BACNET_JOURNAL_BANK_HEADER_SIZE;
+        if (!journal_bank_erase(journal, 0) ||
+            !journal_bank_header_write(journal, 0, journal->sequence)) {
+            journal->storage = NULL;
+            return false;
+        }
+        return true;
+    }
+    if (valid[0] && valid[1]) {
+        /* the newer bank, allowing the sequence number to wrap */
+        bank = ((int32_t)(sequence[1] - sequence[0]) > 0) ? 1 : 0;
+    } else {
+        bank = valid[1] ? 1 : 0;
+    }
+    journal->bank = bank;
+    journal->sequence = sequence[bank];
+    journal->offset = BACNET_JOURNAL_BANK_HEADER_SIZE;
+    for (;;) {
+        size = journal_record_read(
+            journal, bank, journal->offset, storage->bank_size);
+        if (size == 0) {
+            break;
+        }
+        journal->offset += size;
+    }
+    /* anything but erased flash after the last record is a record that
+       was only partly programmed, and nothing may be programmed over it */
+    remaining = storage->bank_size - journal->offset;
+    if (remaining > sizeof(header)) {
+        remaining = sizeof(header);
+    }
+    if (storage->read(
+            storage->context, bank, journal->offset, header, remaining)) {
+        for (i = 0; i < remaining; i++) {
+            if (header[i] != 0xFF) {
+                journal->sealed = true;
+                break;
+            }
+        }
+    } else {
+        journal->sealed = true;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Call a function for each record in the journal, oldest first,
+ *  such as to restore the property values at startup
+ * @param journal - the journal
+ * @param callback - called for each record
+ * @param context - passed to the callback
+ * @return the number of records that were replayed
+ */
+unsigned bacnet_journal_replay(
+    BACNET_JOURNAL *journal,
+    bacnet_journal_replay_callback callback,
+    void *context)
+{
+    BACNET_JOURNAL_RECORD record = { 0 };
+    uint32_t offset = BACNET_JOURNAL_BANK_HEADER_SIZE;
+    size_t size = 0;
+    unsigned count = 0;
+
+    if (!journal || !journal->storage || !callback) {
+        return 0;
+    }
+    while (offset < journal->offset) {
+        size = journal_record_read(
+            journal, journal->bank, offset, journal->offset);
+        if (size == 0) {
+            break;
+        }
+        offset += size;
+        journal_record_decode(journal->scratch, &record);
+        callback(context, &record);
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Add the value of a property to the journal.  The record waits
+ *  in RAM until the journal is flushed, and replaces a record for the
+ *  same property that is still waiting.
+ * @param journal - the journal
+ * @param record - the property and its encoded value
+ * @return true if the record was added
+ */
+bool bacnet_journal_write(
+    BACNET_JOURNAL *journal, const BACNET_JOURNAL_RECORD *record)
+{
+    uint8_t header[BACNET_JOURNAL_RECORD_HEADER_SIZE] = { 0 };
+    uint8_t *data = NULL;
+    size_t capacity = 0;
+    size_t offset = 0;
+    size_t size = 0;
+    uint16_t crc = 0;
+
+    if (!journal || !record) {
+        return false;
+    }
+    if (!journal->storage ||
+        (record->application_data_len > BACNET_JOURNAL_DATA_MAX) ||
+        (record->application_data_len && !record->application_data)) {
+        journal->dropped_count++;
+        return false;
+    }
+    journal_header_encode(header, record);
+    offset = journal_cache_find(journal, header, &size);
+    if (offset < journal->cache_len) {
+        memmove(
+            &journal->cache[offset], &journal->cache[offset + size],
+            journal->cache_len - (offset + size));
+        journal->cache_len -= size;
+    }
+    size = BACNET_JOURNAL_RECORD_SIZE(record->application_data_len);
+    /* the cache is flushed before it holds more than a bank */
+    capacity = sizeof(journal->cache);
+    if (capacity >
+        (journal->storage->bank_size - BACNET_JOURNAL_BANK_HEADER_SIZE)) {
+        capacity =
+            journal->storage->bank_size - BACNET_JOURNAL_BANK_HEADER_SIZE;
+    }
+    if (size > (capacity - journal->cache_len)) {
+        if (!bacnet_journal_flush(journal)) {
+            journal->dropped_count++;
+            return false;
+        }
+    }
+    if (journal->cache_len == 0) {
+        journal->cache_ms = 0;
+    }
+    data = &journal->cache[journal->cache_len];
+    memcpy(data, header, sizeof(header));
+    if (record->application_data_len) {
+        memcpy(
+            &data[BACNET_JOURNAL_RECORD_HEADER_SIZE], record->application_data,
+            record->application_data_len);
+    }
+    crc = journal_crc(data, size - BACNET_JOURNAL_RECORD_TRAILER_SIZE);
+    encode_unsigned16(&data[size - BACNET_JOURNAL_RECORD_TRAILER_SIZE], crc);
+    journal->cache_len += size;
+
+    return true;
+}
+
+/**
+ * @brief Program the records that wait in RAM into the journal storage,
+ *  moving to the other bank when the active bank is full
+ * @param journal - the journal
+ * @return true if the records were programmed.  On failure, the records
+ *  are kept in RAM for another try, unless they will never fit.
+ */
+bool bacnet_journal_flush(BACNET_JOURNAL *journal)
+{
+    const BACNET_JOURNAL_STORAGE *storage = NULL;
+
+    if (!journal || !journal->storage) {
+        return false;
+    }
+    if (journal->cache_len == 0) {
+        return true;
+    }
+    storage = journal->storage;
+    if (journal->sealed ||
+        (journal->cache_len > (storage->bank_size - journal->offset))) {
+        if (!journal_compact(journal)) {
+            return false;
+        }
+        if (journal->cache_len > (storage->bank_size - journal->offset)) {
+            /* the latest values do not fit in a bank */
+            journal->dropped_count++;
+            journal->cache_len = 0;
+            return false;
+        }
+    }
+    if (!storage->write(
+            storage->context, journal->bank, journal->offset, journal->cache,
+            journal->cache_len)) {
+        /* some of the octets may be programmed */
+        journal->sealed = true;
+        return false;
+    }
+    journal->offset += (uint32_t)journal->cache_len;
+    journal->cache_len = 0;
+    journal->flush_count++;
+
+    return true;
+}
+
+/**
+ * @brief Flush the journal when its oldest record in RAM has waited
+ *  for BACNET_JOURNAL_FLUSH_MS
+ * @param journal - the journal
+ * @param elapsed_ms - milliseconds since the last call
+ */
+void bacnet_journal_task(BACNET_JOURNAL *journal, uint32_t elapsed_ms)
+{
+    if (!journal || (journal->cache_len == 0)) {
+        return;
+    }
+    journal->cache_ms += elapsed_ms;
+    if (journal->cache_ms >= BACNET_JOURNAL_FLUSH_MS) {
+        if (!bacnet_journal_flush(journal)) {
+            /* try again after another interval */
+            journal->cache_ms = 0;
+        }
+    }
+}
+
+/**
+ * @brief Get the number of octets of records that wait in RAM
+ * @param journal - the journal
+ * @return the number of octets that the next flush programs
+ */
+size_t bacnet_journal_pending(const BACNET_JOURNAL *journal)
+{
+    if (!journal) {
+        return 0;
+    }
+
+    return journal->cache_len;
+}
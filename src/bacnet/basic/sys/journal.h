@@ -0,0 +1,159 @@
+/**
+ * @file
+ * @brief API for an append-only journal of property values in flash
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_JOURNAL_H
+#define BACNET_SYS_JOURNAL_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+#include "bacnet/bacenum.h"
+
+/* the largest encoded value that is kept for a property */
+#ifndef BACNET_JOURNAL_DATA_MAX
+#define BACNET_JOURNAL_DATA_MAX 128
+#endif
+/* octets of records that wait in RAM before they are written */
+#ifndef BACNET_JOURNAL_CACHE_SIZE
+#define BACNET_JOURNAL_CACHE_SIZE 512
+#endif
+/* how long the first record waits in RAM before it is written */
+#ifndef BACNET_JOURNAL_FLUSH_MS
+#define BACNET_JOURNAL_FLUSH_MS 5000UL
+#endif
+
+/* octets at the start of a bank: magic, version, and sequence number */
+#define BACNET_JOURNAL_BANK_HEADER_SIZE 8
+/* octets of a record before its value: length and property key */
+#define BACNET_JOURNAL_RECORD_HEADER_SIZE 16
+/* octets of a record after its value: CRC-16 */
+#define BACNET_JOURNAL_RECORD_TRAILER_SIZE 2
+#define BACNET_JOURNAL_RECORD_SIZE(data_len)          \
+    (BACNET_JOURNAL_RECORD_HEADER_SIZE + (data_len) + \
+     BACNET_JOURNAL_RECORD_TRAILER_SIZE)
+#define BACNET_JOURNAL_RECORD_SIZE_MAX \
+    BACNET_JOURNAL_RECORD_SIZE(BACNET_JOURNAL_DATA_MAX)
+
+/**
+ * @brief Read octets from a bank of the journal storage
+ * @param context - context of the storage
+ * @param bank - bank number 0 or 1
+ * @param offset - offset of the first octet in the bank
+ * @param data - buffer for the octets
+ * @param length - number of octets to read
+ * @return true if the octets were read
+ */
+typedef bool (*bacnet_journal_read_callback)(
+    void *context,
+    unsigned bank,
+    uint32_t offset,
+    uint8_t *data,
+    size_t length);
+
+/**
+ * @brief Program octets into an erased part of a bank
+ * @param context - context of the storage
+ * @param bank - bank number 0 or 1
+ * @param offset - offset of the first octet in the bank
+ * @param data - the octets to program
+ * @param length - number of octets to program
+ * @return true if the octets were programmed
+ */
+typedef bool (*bacnet_journal_write_callback)(
+    void *context,
+    unsigned bank,
+    uint32_t offset,
+    const uint8_t *data,
+    size_t length);
+
+/**
+ * @brief Erase a whole bank, so that every octet reads as 0xFF
+ * @param context - context of the storage
+ * @param bank - bank number 0 or 1
+ * @return true if the bank was erased
+ */
+typedef bool (*bacnet_journal_erase_callback)(void *context, unsigned bank);
+
+/* Two equal banks of flash, such as two erase sectors.  Records are only
+   appended to the active bank, so an octet is programmed once between
+   erases.  When the active bank is full, the latest value of each
+   property is copied into the other bank, and only then is the other
+   bank marked as the active one. */
+typedef struct bacnet_journal_storage {
+    uint32_t bank_size;
+    bacnet_journal_read_callback read;
+    bacnet_journal_write_callback write;
+    bacnet_journal_erase_callback erase;
+    void *context;
+} BACNET_JOURNAL_STORAGE;
+
+/* the value of one property, as it was written with WriteProperty */
+typedef struct bacnet_journal_record {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    /* the array index, or the priority of a commanded Present_Value */
+    BACNET_ARRAY_INDEX array_index;
+    const uint8_t *application_data;
+    size_t application_data_len;
+} BACNET_JOURNAL_RECORD;
+
+/**
+ * @brief Called for each record when the journal is replayed
+ * @param context - context given to bacnet_journal_replay()
+ * @param record - the record, valid until the callback returns
+ */
+typedef void (*bacnet_journal_replay_callback)(
+    void *context, const BACNET_JOURNAL_RECORD *record);
+
+typedef struct bacnet_journal {
+    const BACNET_JOURNAL_STORAGE *storage;
+    /* the active bank, its sequence number, and the next free octet */
+    unsigned bank;
+    uint32_t sequence;
+    uint32_t offset;
+    /* nothing more is appended to the active bank: it is full, or a
+       record was only partly programmed when the power failed */
+    bool sealed;
+    /* records that are written at the next flush, newest last */
+    uint8_t cache[BACNET_JOURNAL_CACHE_SIZE];
+    size_t cache_len;
+    uint32_t cache_ms;
+    /* one record read from the storage */
+    uint8_t scratch[BACNET_JOURNAL_RECORD_SIZE_MAX];
+    /* diagnostics */
+    uint32_t flush_count;
+    uint32_t erase_count;
+    uint32_t dropped_count;
+} BACNET_JOURNAL;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool bacnet_journal_init(
+    BACNET_JOURNAL *journal, const BACNET_JOURNAL_STORAGE *storage);
+BACNET_STACK_EXPORT
+unsigned bacnet_journal_replay(
+    BACNET_JOURNAL *journal,
+    bacnet_journal_replay_callback callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_journal_write(
+    BACNET_JOURNAL *journal, const BACNET_JOURNAL_RECORD *record);
+BACNET_STACK_EXPORT
+bool bacnet_journal_flush(BACNET_JOURNAL *journal);
+BACNET_STACK_EXPORT
+void bacnet_journal_task(BACNET_JOURNAL *journal, uint32_t elapsed_ms);
+BACNET_STACK_EXPORT
+size_t bacnet_journal_pending(const BACNET_JOURNAL *journal);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
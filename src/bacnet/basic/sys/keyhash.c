@@ -0,0 +1,323 @@
+/**
+ * @file
+ * @brief Key Hash library
+ * @details This is an open addressing hash index of 32-bit hash values
+ * to 32-bit keys.  The entries are stored inline in one power of two
+ * sized array and probed linearly, so a lookup touches a few adjacent
+ * entries instead of walking separately allocated nodes.  The same
+ * hash may be stored with several keys, and the same key with several
+ * hashes; only the exact hash and key pair is unique.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/basic/sys/keyhash.h"
+
+/* entry states */
+#define KEYHASH_EMPTY 0
+#define KEYHASH_USED 1
+#define KEYHASH_DELETED 2
+/* minimum number of entries to allocate memory for */
+#define KEYHASH_SIZE_MIN 16
+
+/**
+ * @brief Spread the bits of the hash so that structured values,
+ *  like object keys, use the whole table.
+ * @param hash - value to be mixed
+ * @return mixed value
+ */
+static uint32_t Keyhash_Mix(uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bUL;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35UL;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+/**
+ * @brief Move the entries into a new array of the given size
+ * @param list - pointer to the hash list
+ * @param new_size - number of entries, which must be a power of two
+ * @return true if the memory was available
+ */
+static bool Keyhash_Resize(OS_Keyhash list, unsigned new_size)
+{
+    struct Keyhash_Entry *new_array;
+    struct Keyhash_Entry *entry;
+    unsigned mask = new_size - 1;
+    unsigned index, i;
+
+    new_array = calloc(new_size, sizeof(struct Keyhash_Entry));
+    if (!new_array) {
+        return false;
+    }
+    for (i = 0; i < list->size; i++) {
+        entry = &list->array[i];
+        if (entry->state == KEYHASH_USED) {
+            index = Keyhash_Mix(entry->hash) & mask;
+            while (new_array[index].state != KEYHASH_EMPTY) {
+                index = (index + 1) & mask;
+            }
+            new_array[index] = *entry;
+        }
+    }
+    free(list->array);
+    list->array = new_array;
+    list->size = new_size;
+    list->deleted = 0;
+
+    return true;
+}
+
+/**
+ * @brief Check to see if the array has room for one more entry,
+ *  keeping the load including deleted entries under 3/4.
+ * @param list - pointer to the hash list
+ * @return true if there is room
+ */
+static bool Keyhash_Check_Size(OS_Keyhash list)
+{
+    unsigned new_size;
+
+    if (((list->count + list->deleted + 1) * 4) <= (list->size * 3)) {
+        return true;
+    }
+    new_size = list->size;
+    if (new_size < KEYHASH_SIZE_MIN) {
+        new_size = KEYHASH_SIZE_MIN;
+    }
+    /* only grow when the used entries need it, otherwise just
+       clean out the deleted entries */
+    while (((list->count + 1) * 2) > new_size) {
+        new_size *= 2;
+    }
+
+    return Keyhash_Resize(list, new_size);
+}
+
+/**
+ * @brief Find the entry with the exact hash and key pair
+ * @param list - pointer to the hash list
+ * @param hash - hash value
+ * @param key - key value
+ * @return pointer to the entry, or NULL if not found
+ */
+static struct Keyhash_Entry *
+Keyhash_Entry_Find(OS_Keyhash list, uint32_t hash, KEY key)
+{
+    struct Keyhash_Entry *entry;
+    unsigned mask, index, i;
+
+    if (!list || !list->array || !list->count) {
+        return NULL;
+    }
+    mask = list->size - 1;
+    index = Keyhash_Mix(hash) & mask;
+    for (i = 0; i < list->size; i++) {
+        entry = &list->array[index];
+        if (entry->state == KEYHASH_EMPTY) {
+            break;
+        }
+        if ((entry->state == KEYHASH_USED) && (entry->hash == hash) &&
+            (entry->key == key)) {
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a hash and key pair to the index
+ * @param list - pointer to the hash list
+ * @param hash - hash value
+ * @param key - key value
+ * @return true if added, or already a member
+ */
+bool Keyhash_Add(OS_Keyhash list, uint32_t hash, KEY key)
+{
+    struct Keyhash_Entry *entry;
+    unsigned mask, index;
+
+    if (!list) {
+        return false;
+    }
+    if (Keyhash_Entry_Find(list, hash, key)) {
+        return true;
+    }
+    if (!Keyhash_Check_Size(list)) {
+        return false;
+    }
+    mask = list->size - 1;
+    index = Keyhash_Mix(hash) & mask;
+    for (;;) {
+        entry = &list->array[index];
+        if (entry->state != KEYHASH_USED) {
+            break;
+        }
+        index = (index + 1) & mask;
+    }
+    if (entry->state == KEYHASH_DELETED) {
+        list->deleted--;
+    }
+    entry->hash = hash;
+    entry->key = key;
+    entry->state = KEYHASH_USED;
+    list->count++;
+
+    return true;
+}
+
+/**
+ * @brief Remove a hash and key pair from the index
+ * @param list - pointer to the hash list
+ * @param hash - hash value
+ * @param key - key value
+ * @return true if found and removed
+ */
+bool Keyhash_Remove(OS_Keyhash list, uint32_t hash, KEY key)
+{
+    struct Keyhash_Entry *entry;
+
+    entry = Keyhash_Entry_Find(list, hash, key);
+    if (!entry) {
+        return false;
+    }
+    entry->state = KEYHASH_DELETED;
+    list->count--;
+    list->deleted++;
+    if (list->count == 0) {
+        Keyhash_Clear(list);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find the keys stored with a hash, one at a time
+ * @param list - pointer to the hash list
+ * @param hash - hash value
+ * @param iterator - [in,out] set to zero before the first call,
+ *  and passed back unchanged for each of the next keys
+ * @param pKey - [out] the next key stored with this hash
+ * @return true if another key was found
+ */
+bool Keyhash_Find(OS_Keyhash list, uint32_t hash, unsigned *iterator, KEY *pKey)
+{
+    struct Keyhash_Entry *entry;
+    unsigned mask, index, i;
+
+    if (!list || !list->array || !list->count || !iterator) {
+        return false;
+    }
+    mask = list->size - 1;
+    index = Keyhash_Mix(hash) & mask;
+    for (i = *iterator; i < list->size; i++) {
+        entry = &list->array[(index + i) & mask];
+        if (entry->state == KEYHASH_EMPTY) {
+            break;
+        }
+        if ((entry->state == KEYHASH_USED) && (entry->hash == hash)) {
+            *iterator = i + 1;
+            if (pKey) {
+                *pKey = entry->key;
+            }
+            return true;
+        }
+    }
+    *iterator = list->size;
+
+    return false;
+}
+
+/**
+ * @brief Determine if a hash and key pair is in the index
+ * @param list - pointer to the hash list
+ * @param hash - hash value
+ * @param key - key value
+ * @return true if found
+ */
+bool Keyhash_Member(OS_Keyhash list, uint32_t hash, KEY key)
+{
+    return Keyhash_Entry_Find(list, hash, key) != NULL;
+}
+
+/**
+ * @brief Return the number of hash and key pairs in the index
+ * @param list - pointer to the hash list
+ * @return number of entries
+ */
+unsigned Keyhash_Count(OS_Keyhash list)
+{
+    unsigned count = 0;
+
+    if (list) {
+        count = list->count;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Compute the 32-bit FNV-1a hash of a block of data
+ * @param data - data to be hashed
+ * @param length - number of bytes of data
+ * @return hash value
+ */
+uint32_t Keyhash_FNV1a(const void *data, size_t length)
+{
+    const uint8_t *octets = data;
+    uint32_t hash = 2166136261UL;
+    size_t i;
+
+    if (octets) {
+        for (i = 0; i < length; i++) {
+            hash ^= octets[i];
+            hash *= 16777619UL;
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Remove all the entries and release the memory for them
+ * @param list - pointer to the hash list
+ */
+void Keyhash_Clear(OS_Keyhash list)
+{
+    if (list) {
+        free(list->array);
+        list->array = NULL;
+        list->count = 0;
+        list->deleted = 0;
+        list->size = 0;
+    }
+}
+
+/**
+ * @brief Create an empty hash list
+ * @return pointer to the hash list, or NULL if no memory
+ */
+OS_Keyhash Keyhash_Create(void)
+{
+    return calloc(1, sizeof(struct Keyhash));
+}
+
+/**
+ * @brief Delete a hash list and the memory for its entries
+ * @param list - pointer to the hash list
+ */
+void Keyhash_Delete(OS_Keyhash list)
+{
+    if (list) {
+        Keyhash_Clear(list);
+        free(list);
+    }
+}
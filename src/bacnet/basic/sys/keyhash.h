@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @brief API for a Key Hash library - an open addressing hash index
+ *  of 32-bit hash values to 32-bit keys.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_KEYHASH_H
+#define BACNET_SYS_KEYHASH_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/key.h"
+
+/* This is an index that maps a hash to one or more keys.  The caller
+   computes the hash of the thing being indexed (for example, an object
+   name) and stores the KEY of the owner.  Since different things may
+   hash to the same value, a lookup returns every candidate KEY and the
+   caller confirms the match.  Entries are kept inline in one array. */
+
+struct Keyhash_Entry {
+    uint32_t hash; /* hash of the indexed value */
+    KEY key; /* key associated with the hash */
+    uint8_t state; /* empty, used, or deleted */
+};
+
+typedef struct Keyhash {
+    struct Keyhash_Entry *array; /* power of two sized array of entries */
+    unsigned count; /* number of used entries */
+    unsigned deleted; /* number of deleted entries (tombstones) */
+    unsigned size; /* number of available entries */
+} KEYHASH_TYPE;
+typedef KEYHASH_TYPE *OS_Keyhash;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+OS_Keyhash Keyhash_Create(void);
+
+BACNET_STACK_EXPORT
+void Keyhash_Delete(OS_Keyhash list);
+
+BACNET_STACK_EXPORT
+void Keyhash_Clear(OS_Keyhash list);
+
+BACNET_STACK_EXPORT
+bool Keyhash_Add(OS_Keyhash list, uint32_t hash, KEY key);
+
+BACNET_STACK_EXPORT
+bool Keyhash_Remove(OS_Keyhash list, uint32_t hash, KEY key);
+
+BACNET_STACK_EXPORT
+bool Keyhash_Find(
+    OS_Keyhash list, uint32_t hash, unsigned *iterator, KEY *pKey);
+
+BACNET_STACK_EXPORT
+bool Keyhash_Member(OS_Keyhash list, uint32_t hash, KEY key);
+
+BACNET_STACK_EXPORT
+unsigned Keyhash_Count(OS_Keyhash list);
+
+BACNET_STACK_EXPORT
+uint32_t Keyhash_FNV1a(const void *data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -5,6 +5,8 @@
  * The list is sorted, indexed, and keyed. The array is much faster
  * than a linked list.  It stores a pointer to data, which you must
  * malloc and free on your own, or just use static data.
+ * The keys and data pointers are stored together in one contiguous
+ * array that grows and shrinks geometrically.
  * @author Steve Karg <skarg@users.sourceforge.net>
  * @date 2003
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
@@ -12,80 +14,104 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/memstat.h"
 
 /******************************************************************** */
 /* Generic node routines */
 /******************************************************************** */
 
-/** Grab memory for a node (Keylist_Node).
+/* minimum number of nodes to allocate memory for */
+#define KEYLIST_CHUNK 8
+
+/** Grab memory for a list (Keylist).
  *
  * @return Pointer to the allocated memory or
  *         NULL under an Out Of Memory situation.
  */
-static struct Keylist_Node *NodeCreate(void)
+static struct Keylist *KeylistCreate(void)
 {
-    return calloc(1, sizeof(struct Keylist_Node));
+    struct Keylist *list;
+
+    list = calloc(1, sizeof(struct Keylist));
+    if (list) {
+        MEMSTAT_ALLOC(MEMSTAT_KEYLIST, sizeof(struct Keylist));
+    }
+
+    return list;
 }
 
-/** Grab memory for a list (Keylist).
+/** Change the size of the node array, keeping the nodes in it.
  *
- * @return Pointer to the allocated memory or
- *         NULL under an Out Of Memory situation.
+ * @param list  Pointer to the list to be resized.
+ * @param new_size  Number of nodes to allocate memory for.
+ *
+ * @return Returns true if success, false if failed
  */
-static struct Keylist *KeylistCreate(void)
+static bool ResizeArray(OS_Keylist list, int new_size)
 {
-    return calloc(1, sizeof(struct Keylist));
+    struct Keylist_Node *new_array = NULL; /* new array of nodes */
+
+    new_array =
+        realloc(list->array, (size_t)new_size * sizeof(struct Keylist_Node));
+    if (!new_array) {
+        return false;
+    }
+    MEMSTAT_FREE(
+        MEMSTAT_KEYLIST, (size_t)list->size * sizeof(struct Keylist_Node));
+    MEMSTAT_ALLOC(
+        MEMSTAT_KEYLIST, (size_t)new_size * sizeof(struct Keylist_Node));
+    list->array = new_array;
+    list->size = new_size;
+
+    return true;
 }
 
-/** Check to see if the array is big enough for an addition
- * or is too big when we are deleting and we can shrink.
+/** Check to see if the array is big enough for an addition.
+ * The array grows by doubling, so that adding many nodes
+ * does not copy the array for every few nodes.
  *
  * @param list  Pointer to the list to be tested.
  *
- * @return Returns true if success, false if failed
+ * @return Returns true if there is room for another node
  */
 static bool CheckArraySize(OS_Keylist list)
 {
     int new_size = 0; /* set it up so that no size change is the default */
-    const int chunk = 8; /* minimum number of nodes to allocate memory for */
-    struct Keylist_Node **new_array = NULL; /* new array of nodes, if needed */
-    int i; /* counter */
+
     if (!list) {
         return false;
     }
-
-    /* indicates the need for more memory allocation */
-    if (list->count == list->size) {
-        new_size = list->size + chunk;
-
-        /* allow for shrinking memory */
-    } else if ((list->size > chunk) && (list->count < (list->size - chunk))) {
-        new_size = list->size - chunk;
-    }
-    if (new_size > 0) {
-        /* Allocate more room for node pointer array */
-        new_array = calloc((size_t)new_size, sizeof(struct Keylist_Node *));
-
-        /* See if we got the memory we wanted */
-        if (!new_array) {
-            return true;
-        }
-
-        /* copy the nodes from the old array to the new array */
-        if (list->array) {
-            for (i = 0; i < list->count; i++) {
-                new_array[i] = list->array[i];
-            }
-            free(list->array);
+    if (list->count >= list->size) {
+        /* indicates the need for more memory allocation */
+        if (list->size < KEYLIST_CHUNK) {
+            new_size = KEYLIST_CHUNK;
+        } else {
+            new_size = list->size * 2;
         }
-        list->array = new_array;
-        list->size = new_size;
+        return ResizeArray(list, new_size);
     }
 
     return true;
 }
 
+/** Check to see if the array is too big after deleting, and shrink it.
+ * The array shrinks by half when it is less than one quarter used,
+ * so that reserved room is kept until nodes are deleted and deleting
+ * many nodes does not copy the array for every few nodes.
+ *
+ * @param list  Pointer to the list to be tested.
+ */
+static void ShrinkArraySize(OS_Keylist list)
+{
+    if (list && (list->size > KEYLIST_CHUNK) &&
+        (list->count < (list->size / 4))) {
+        /* allow for shrinking memory - failure is harmless */
+        (void)ResizeArray(list, list->size / 2);
+    }
+}
+
 /** Find the index of the key that we are looking for.
  * Since it is sorted, we can optimize the search.
  * returns true if found, and false not found.
@@ -102,7 +128,6 @@ static bool CheckArraySize(OS_Keylist list)
  */
 static bool FindIndex(OS_Keylist list, KEY key, int *pIndex)
 {
-    struct Keylist_Node *node; /* holds the new node */
     int left = 0; /* the left branch of tree, beginning of list */
     int right = 0; /* the right branch on the tree, end of list */
     int index = 0; /* our current search place in the array */
@@ -118,15 +143,16 @@ static bool FindIndex(OS_Keylist list, KEY key, int *pIndex)
         return false;
     }
     right = list->count - 1;
+    /* the common case of adding to the end of the list */
+    if (key > list->array[right].key) {
+        *pIndex = list->count;
+        return false;
+    }
     /* assume that the list is sorted */
     do {
         /* A binary search */
         index = (left + right) / 2;
-        node = list->array[index];
-        if (!node) {
-            break;
-        }
-        current_key = node->key;
+        current_key = list->array[index].key;
         if (key < current_key) {
             right = index - 1;
 
@@ -166,9 +192,7 @@ static bool FindIndex(OS_Keylist list, KEY key, int *pIndex)
  */
 int Keylist_Data_Add(OS_Keylist list, KEY key, void *data)
 {
-    struct Keylist_Node *node; /* holds the new node */
     int index = -1; /* return value */
-    int i; /* counts through the array */
 
     if (list && CheckArraySize(list)) {
         /* figure out where to put the new node */
@@ -183,21 +207,19 @@ int Keylist_Data_Add(OS_Keylist list, KEY key, void *data)
                 index = list->count;
             }
             /* Move all the items up to make room for the new one */
-            for (i = list->count; i > index; i--) {
-                list->array[i] = list->array[i - 1];
+            if (index < list->count) {
+                memmove(
+                    &list->array[index + 1], &list->array[index],
+                    (size_t)(list->count - index) *
+                        sizeof(struct Keylist_Node));
             }
         } else {
             index = 0;
         }
-
-        /* create and add the node */
-        node = NodeCreate();
-        if (node) {
-            list->count++;
-            node->key = key;
-            node->data = data;
-            list->array[index] = node;
-        }
+        /* add the node */
+        list->array[index].key = key;
+        list->array[index].data = data;
+        list->count++;
     }
     return index;
 }
@@ -212,37 +234,23 @@ int Keylist_Data_Add(OS_Keylist list, KEY key, void *data)
  */
 void *Keylist_Data_Delete_By_Index(OS_Keylist list, int index)
 {
-    struct Keylist_Node *node;
     void *data = NULL;
 
     if (list) {
         if (list->array && list->count && (index >= 0) &&
             (index < list->count)) {
-            node = list->array[index];
-            if (node) {
-                data = node->data;
-            }
+            data = list->array[index].data;
             /* move the nodes to account for the deleted one */
-            if (list->count == 1) {
-                /* There is no node shifting to do */
-            } else if (index == (list->count - 1)) {
-                /* We are the last one */
-                /* There is no node shifting to do */
-            } else {
+            if (index < (list->count - 1)) {
                 /* Move all the nodes down one */
-                int i; /* counter */
-                int count = list->count - 1;
-                for (i = index; i < count; i++) {
-                    list->array[i] = list->array[i + 1];
-                }
+                memmove(
+                    &list->array[index], &list->array[index + 1],
+                    (size_t)(list->count - 1 - index) *
+                        sizeof(struct Keylist_Node));
             }
             list->count--;
-            if (node) {
-                free(node);
-            }
-
             /* potentially reduce the size of the array */
-            (void)CheckArraySize(list);
+            ShrinkArraySize(list);
         }
     }
     return (data);
@@ -321,7 +329,7 @@ void *Keylist_Data(OS_Keylist list, KEY key)
     if (list) {
         if (list->array && list->count) {
             if (FindIndex(list, key, &index)) {
-                node = list->array[index];
+                node = &list->array[index];
             }
         }
     }
@@ -349,6 +357,28 @@ int Keylist_Index(OS_Keylist list, KEY key)
     return index;
 }
 
+/** Returns the index from the node specified by key, checking the node
+ * at the hint index before searching the list.  Walking a list in key
+ * order with hint set to the previous index plus one finds each key
+ * without a search.
+ *
+ * @param list  Pointer to the list
+ * @param key  Key whose index shall be retrieved.
+ * @param hint  Index where the key is expected to be found.
+ *
+ * @return Index of the key or -1, if not found.
+ */
+int Keylist_Index_Hint(OS_Keylist list, KEY key, int hint)
+{
+    if (list && list->array && (hint >= 0) && (hint < list->count)) {
+        if (list->array[hint].key == key) {
+            return hint;
+        }
+    }
+
+    return Keylist_Index(list, key);
+}
+
 /** Returns the data specified by index
  *
  * @param list  Pointer to the list
@@ -363,7 +393,7 @@ void *Keylist_Data_Index(OS_Keylist list, int index)
     if (list) {
         if (list->array && list->count && (index >= 0) &&
             (index < list->count)) {
-            node = list->array[index];
+            node = &list->array[index];
         }
     }
     return node ? node->data : NULL;
@@ -385,7 +415,7 @@ KEY Keylist_Key(OS_Keylist list, int index)
     if (list) {
         if (list->array && list->count && (index >= 0) &&
             (index < list->count)) {
-            node = list->array[index];
+            node = &list->array[index];
             if (node) {
                 key = node->key;
             }
@@ -410,7 +440,7 @@ bool Keylist_Index_Key(OS_Keylist list, int index, KEY *pKey)
     if (list) {
         if (list->array && list->count && (index >= 0) &&
             (index < list->count)) {
-            node = list->array[index];
+            node = &list->array[index];
             if (node) {
                 status = true;
                 if (pKey) {
@@ -463,6 +493,26 @@ int Keylist_Count(OS_Keylist list)
     return (cnt);
 }
 
+/** Make room in the list for a number of nodes, so that adding
+ * them one at a time does not resize the array.
+ *
+ * @param list  Pointer to the list
+ * @param count  Total number of nodes the list will hold
+ *
+ * @return true if the list has room for the nodes
+ */
+bool Keylist_Reserve(OS_Keylist list, int count)
+{
+    if (!list || (count < 0)) {
+        return false;
+    }
+    if (count <= list->size) {
+        return true;
+    }
+
+    return ResizeArray(list, count);
+}
+
 /******************************************************************** */
 /* Public List functions */
 /******************************************************************** */
@@ -495,8 +545,12 @@ void Keylist_Delete(OS_Keylist list)
             (void)Keylist_Data_Delete_By_Index(list, 0);
         }
         if (list->array) {
+            MEMSTAT_FREE(
+                MEMSTAT_KEYLIST,
+                (size_t)list->size * sizeof(struct Keylist_Node));
             free(list->array);
         }
+        MEMSTAT_FREE(MEMSTAT_KEYLIST, sizeof(struct Keylist));
         free(list);
     }
 
@@ -23,7 +23,7 @@ struct Keylist_Node {
 };
 
 typedef struct Keylist {
-    struct Keylist_Node **array; /* array of nodes */
+    struct Keylist_Node *array; /* contiguous array of nodes */
     int count; /* number of nodes in this list - more efficient than loop */
     int size; /* number of available nodes on this list - can grow or shrink */
 } KEYLIST_TYPE;
@@ -73,6 +73,10 @@ void *Keylist_Data(OS_Keylist list, KEY key);
 BACNET_STACK_EXPORT
 int Keylist_Index(OS_Keylist list, KEY key);
 
+/* returns the index from the node specified by key, trying a hint first */
+BACNET_STACK_EXPORT
+int Keylist_Index_Hint(OS_Keylist list, KEY key, int hint);
+
 /* returns the data specified by index */
 BACNET_STACK_EXPORT
 void *Keylist_Data_Index(OS_Keylist list, int index);
@@ -94,6 +98,10 @@ KEY Keylist_Next_Empty_Key(OS_Keylist list, KEY key);
 BACNET_STACK_EXPORT
 int Keylist_Count(OS_Keylist list);
 
+/* makes room for a number of nodes before adding them */
+BACNET_STACK_EXPORT
+bool Keylist_Reserve(OS_Keylist list, int count);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
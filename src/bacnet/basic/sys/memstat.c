@@ -0,0 +1,207 @@
+/**
+ * @file
+ * @brief Memory accounting of the BACnet stack
+ * @details The pools, lists and tables of the stack report the bytes
+ *  they take from the heap, and their static tables, to an account of a
+ *  subsystem or of an object type.  The accounts are updated by the
+ *  thread that runs the stack, like the pools and lists themselves.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/basic/sys/memstat.h"
+
+/* a static table, which is only accounted once */
+struct memstat_fixed_table {
+    const void *table;
+    size_t bytes;
+    MEMSTAT_SUBSYSTEM subsystem;
+};
+
+static MEMSTAT_USAGE Memstat_Subsystem[MEMSTAT_SUBSYSTEM_MAX];
+static MEMSTAT_USAGE Memstat_Object[OBJECT_PROPRIETARY_MIN];
+static struct memstat_fixed_table Memstat_Fixed[MEMSTAT_FIXED_MAX];
+
+static const char *Memstat_Subsystem_Names[MEMSTAT_SUBSYSTEM_MAX] = {
+    "other", "object", "keylist", "cov", "tsm", "address", "log"
+};
+
+/**
+ * @brief Add bytes to a usage, and keep its peak
+ * @param usage - the usage
+ * @param bytes - number of bytes
+ */
+static void memstat_usage_add(MEMSTAT_USAGE *usage, size_t bytes)
+{
+    usage->heap += bytes;
+    if (usage->heap > usage->peak) {
+        usage->peak = usage->heap;
+    }
+}
+
+/**
+ * @brief Remove bytes from a usage
+ * @param usage - the usage
+ * @param bytes - number of bytes
+ */
+static void memstat_usage_remove(MEMSTAT_USAGE *usage, size_t bytes)
+{
+    if (usage->heap > bytes) {
+        usage->heap -= bytes;
+    } else {
+        usage->heap = 0;
+    }
+}
+
+/**
+ * @brief Account heap memory that was allocated
+ * @param account - a MEMSTAT_SUBSYSTEM or a MEMSTAT_ACCOUNT_OBJECT()
+ * @param bytes - number of bytes allocated
+ */
+void memstat_alloc(MEMSTAT_ACCOUNT account, size_t bytes)
+{
+    unsigned object_type;
+
+    if (account < MEMSTAT_SUBSYSTEM_MAX) {
+        memstat_usage_add(&Memstat_Subsystem[account], bytes);
+    } else {
+        memstat_usage_add(&Memstat_Subsystem[MEMSTAT_OBJECT], bytes);
+        object_type = account - MEMSTAT_SUBSYSTEM_MAX;
+        if (object_type < OBJECT_PROPRIETARY_MIN) {
+            memstat_usage_add(&Memstat_Object[object_type], bytes);
+        }
+    }
+}
+
+/**
+ * @brief Account heap memory that was freed
+ * @param account - a MEMSTAT_SUBSYSTEM or a MEMSTAT_ACCOUNT_OBJECT()
+ * @param bytes - number of bytes freed
+ */
+void memstat_free(MEMSTAT_ACCOUNT account, size_t bytes)
+{
+    unsigned object_type;
+
+    if (account < MEMSTAT_SUBSYSTEM_MAX) {
+        memstat_usage_remove(&Memstat_Subsystem[account], bytes);
+    } else {
+        memstat_usage_remove(&Memstat_Subsystem[MEMSTAT_OBJECT], bytes);
+        object_type = account - MEMSTAT_SUBSYSTEM_MAX;
+        if (object_type < OBJECT_PROPRIETARY_MIN) {
+            memstat_usage_remove(&Memstat_Object[object_type], bytes);
+        }
+    }
+}
+
+/**
+ * @brief Account a static table of a subsystem.  A table that was
+ *  already accounted, such as when its module is initialized again,
+ *  is not added twice.
+ * @param subsystem - the subsystem
+ * @param table - the table
+ * @param bytes - size of the table in bytes
+ */
+void memstat_fixed(
+    MEMSTAT_SUBSYSTEM subsystem, const void *table, size_t bytes)
+{
+    unsigned i;
+
+    if ((subsystem >= MEMSTAT_SUBSYSTEM_MAX) || !table) {
+        return;
+    }
+    for (i = 0; i < MEMSTAT_FIXED_MAX; i++) {
+        if (Memstat_Fixed[i].table == table) {
+            return;
+        }
+        if (!Memstat_Fixed[i].table) {
+            Memstat_Fixed[i].table = table;
+            Memstat_Fixed[i].bytes = bytes;
+            Memstat_Fixed[i].subsystem = subsystem;
+            Memstat_Subsystem[subsystem].fixed += bytes;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Get the memory usage of a subsystem
+ * @param subsystem - the subsystem
+ * @param usage - [out] the memory usage
+ * @return true if the subsystem is valid
+ */
+bool memstat_subsystem(MEMSTAT_SUBSYSTEM subsystem, MEMSTAT_USAGE *usage)
+{
+    if (subsystem >= MEMSTAT_SUBSYSTEM_MAX) {
+        return false;
+    }
+    if (usage) {
+        *usage = Memstat_Subsystem[subsystem];
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the memory usage of the pool of an object type
+ * @param object_type - the object type
+ * @param usage - [out] the memory usage
+ * @return true if the object type is accounted
+ */
+bool memstat_object_type(BACNET_OBJECT_TYPE object_type, MEMSTAT_USAGE *usage)
+{
+    if (object_type >= OBJECT_PROPRIETARY_MIN) {
+        return false;
+    }
+    if (usage) {
+        *usage = Memstat_Object[object_type];
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the memory of all the subsystems
+ * @return bytes of the heap and of the static tables
+ */
+size_t memstat_total(void)
+{
+    size_t total = 0;
+    unsigned i;
+
+    for (i = 0; i < MEMSTAT_SUBSYSTEM_MAX; i++) {
+        total += Memstat_Subsystem[i].heap + Memstat_Subsystem[i].fixed;
+    }
+
+    return total;
+}
+
+/**
+ * @brief Get the name of a subsystem
+ * @param subsystem - the subsystem
+ * @return the name, or "unknown"
+ */
+const char *memstat_subsystem_name(MEMSTAT_SUBSYSTEM subsystem)
+{
+    if (subsystem < MEMSTAT_SUBSYSTEM_MAX) {
+        return Memstat_Subsystem_Names[subsystem];
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief Set the peaks to the present heap usage
+ */
+void memstat_reset(void)
+{
+    unsigned i;
+
+    for (i = 0; i < MEMSTAT_SUBSYSTEM_MAX; i++) {
+        Memstat_Subsystem[i].peak = Memstat_Subsystem[i].heap;
+    }
+    for (i = 0; i < OBJECT_PROPRIETARY_MIN; i++) {
+        Memstat_Object[i].peak = Memstat_Object[i].heap;
+    }
+}
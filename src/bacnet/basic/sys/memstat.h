@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @brief API for the memory accounting of the BACnet stack
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_MEMSTAT_H
+#define BACNET_SYS_MEMSTAT_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* The stack accounts the memory of its pools, lists and tables where
+   they are allocated when this is enabled.  When it is disabled, the
+   MEMSTAT_ macros at those places compile to nothing. */
+#ifndef BACNET_MEMSTAT_ENABLED
+#define BACNET_MEMSTAT_ENABLED 0
+#endif
+
+/* number of static tables that can be accounted */
+#ifndef MEMSTAT_FIXED_MAX
+#define MEMSTAT_FIXED_MAX 16
+#endif
+
+typedef enum memstat_subsystem {
+    MEMSTAT_OTHER = 0,
+    /* the pools of the object data, also accounted by object type */
+    MEMSTAT_OBJECT,
+    /* the node arrays of the Keylists */
+    MEMSTAT_KEYLIST,
+    MEMSTAT_COV,
+    MEMSTAT_TSM,
+    MEMSTAT_ADDRESS,
+    /* the trend, event and audit log buffers */
+    MEMSTAT_LOG,
+    MEMSTAT_SUBSYSTEM_MAX
+} MEMSTAT_SUBSYSTEM;
+
+/* An account is a subsystem, or an object type of the MEMSTAT_OBJECT
+   subsystem.  Proprietary object types are only in the subsystem. */
+typedef uint16_t MEMSTAT_ACCOUNT;
+#define MEMSTAT_ACCOUNT_OBJECT(object_type) \
+    ((MEMSTAT_ACCOUNT)(MEMSTAT_SUBSYSTEM_MAX + (object_type)))
+
+typedef struct memstat_usage {
+    /* bytes that are allocated from the heap now */
+    size_t heap;
+    /* the most bytes that were allocated from the heap at once */
+    size_t peak;
+    /* bytes of the static tables */
+    size_t fixed;
+} MEMSTAT_USAGE;
+
+#if BACNET_MEMSTAT_ENABLED
+#define MEMSTAT_ALLOC(account, bytes) memstat_alloc((account), (bytes))
+#define MEMSTAT_FREE(account, bytes) memstat_free((account), (bytes))
+#define MEMSTAT_FIXED(subsystem, table, bytes) \
+    memstat_fixed((subsystem), (table), (bytes))
+#else
+#define MEMSTAT_ALLOC(account, bytes) ((void)0)
+#define MEMSTAT_FREE(account, bytes) ((void)0)
+#define MEMSTAT_FIXED(subsystem, table, bytes) ((void)0)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void memstat_alloc(MEMSTAT_ACCOUNT account, size_t bytes);
+BACNET_STACK_EXPORT
+void memstat_free(MEMSTAT_ACCOUNT account, size_t bytes);
+BACNET_STACK_EXPORT
+void memstat_fixed(
+    MEMSTAT_SUBSYSTEM subsystem, const void *table, size_t bytes);
+
+BACNET_STACK_EXPORT
+bool memstat_subsystem(MEMSTAT_SUBSYSTEM subsystem, MEMSTAT_USAGE *usage);
+BACNET_STACK_EXPORT
+bool memstat_object_type(BACNET_OBJECT_TYPE object_type, MEMSTAT_USAGE *usage);
+BACNET_STACK_EXPORT
+size_t memstat_total(void);
+BACNET_STACK_EXPORT
+const char *memstat_subsystem_name(MEMSTAT_SUBSYSTEM subsystem);
+BACNET_STACK_EXPORT
+void memstat_reset(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
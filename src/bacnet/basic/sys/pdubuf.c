@@ -0,0 +1,247 @@
+/**
+ * @file
+ * @brief Reference counted PDU buffers with headroom
+ * @details A PDU is encoded once into a buffer from a static pool,
+ *  after room that is reserved for the headers of the lower layers.
+ *  Each layer then prepends its header in place with pdubuf_push(),
+ *  and removes it on receipt with pdubuf_pull(), so that the PDU is
+ *  not copied from one layer's buffer into the next.  A layer that
+ *  keeps the PDU after it returns, for example to queue or retry it,
+ *  takes a reference that it releases when it is done.  The pool is
+ *  not protected for use from more than one thread.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "bacnet/basic/sys/pdubuf.h"
+
+static PDU_BUFFER PDU_Buffer_Pool[PDUBUF_POOL_SIZE];
+
+/**
+ * @brief Take a PDU buffer from the pool
+ * @param headroom - number of bytes to reserve for the headers
+ * @return pointer to an empty buffer with one reference, or NULL if
+ *  the headroom is too large or the pool is empty
+ */
+PDU_BUFFER *pdubuf_alloc(uint16_t headroom)
+{
+    unsigned i;
+
+    if (headroom > PDUBUF_SIZE) {
+        return NULL;
+    }
+    for (i = 0; i < PDUBUF_POOL_SIZE; i++) {
+        if (PDU_Buffer_Pool[i].refcount == 0) {
+            PDU_Buffer_Pool[i].refcount = 1;
+            PDU_Buffer_Pool[i].offset = headroom;
+            PDU_Buffer_Pool[i].length = 0;
+            return &PDU_Buffer_Pool[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Take another reference to a PDU buffer
+ * @param buf - PDU buffer
+ * @return the PDU buffer, or NULL if it is not in use or has too many
+ *  references
+ */
+PDU_BUFFER *pdubuf_ref(PDU_BUFFER *buf)
+{
+    if (!buf || (buf->refcount == 0) || (buf->refcount == UINT8_MAX)) {
+        return NULL;
+    }
+    buf->refcount++;
+
+    return buf;
+}
+
+/**
+ * @brief Release a reference to a PDU buffer, and return the buffer to
+ *  the pool when it was the last reference
+ * @param buf - PDU buffer
+ */
+void pdubuf_unref(PDU_BUFFER *buf)
+{
+    if (buf && (buf->refcount > 0)) {
+        buf->refcount--;
+    }
+}
+
+/**
+ * @brief Get the number of references to a PDU buffer
+ * @param buf - PDU buffer
+ * @return number of references
+ */
+unsigned pdubuf_refcount(const PDU_BUFFER *buf)
+{
+    if (!buf) {
+        return 0;
+    }
+
+    return buf->refcount;
+}
+
+/**
+ * @brief Get the first byte of the PDU
+ * @param buf - PDU buffer
+ * @return pointer to the PDU, or NULL
+ */
+uint8_t *pdubuf_data(PDU_BUFFER *buf)
+{
+    if (!buf) {
+        return NULL;
+    }
+
+    return &buf->storage[buf->offset];
+}
+
+/**
+ * @brief Get the number of bytes in the PDU
+ * @param buf - PDU buffer
+ * @return number of bytes
+ */
+uint16_t pdubuf_length(const PDU_BUFFER *buf)
+{
+    if (!buf) {
+        return 0;
+    }
+
+    return buf->length;
+}
+
+/**
+ * @brief Get the number of bytes that can be prepended to the PDU
+ * @param buf - PDU buffer
+ * @return number of bytes
+ */
+uint16_t pdubuf_headroom(const PDU_BUFFER *buf)
+{
+    if (!buf) {
+        return 0;
+    }
+
+    return buf->offset;
+}
+
+/**
+ * @brief Get the number of bytes that can be appended to the PDU
+ * @param buf - PDU buffer
+ * @return number of bytes
+ */
+uint16_t pdubuf_tailroom(const PDU_BUFFER *buf)
+{
+    if (!buf) {
+        return 0;
+    }
+
+    return (uint16_t)(PDUBUF_SIZE - buf->offset - buf->length);
+}
+
+/**
+ * @brief Get the byte after the end of the PDU, where the PDU is encoded
+ * @param buf - PDU buffer
+ * @return pointer to the byte after the PDU, or NULL
+ */
+uint8_t *pdubuf_tail(PDU_BUFFER *buf)
+{
+    if (!buf) {
+        return NULL;
+    }
+
+    return &buf->storage[buf->offset + buf->length];
+}
+
+/**
+ * @brief Append bytes to the end of the PDU, for example after they
+ *  were encoded at pdubuf_tail()
+ * @param buf - PDU buffer
+ * @param len - number of bytes to append
+ * @return pointer to the appended bytes, or NULL if there is no room
+ */
+uint8_t *pdubuf_put(PDU_BUFFER *buf, uint16_t len)
+{
+    uint8_t *tail;
+
+    if (!buf || (len > pdubuf_tailroom(buf))) {
+        return NULL;
+    }
+    tail = pdubuf_tail(buf);
+    buf->length += len;
+
+    return tail;
+}
+
+/**
+ * @brief Prepend room for a header to the PDU
+ * @param buf - PDU buffer
+ * @param len - number of bytes in the header
+ * @return pointer to the header, which is the new start of the PDU,
+ *  or NULL if there is not enough headroom
+ */
+uint8_t *pdubuf_push(PDU_BUFFER *buf, uint16_t len)
+{
+    if (!buf || (len > pdubuf_headroom(buf))) {
+        return NULL;
+    }
+    buf->offset -= len;
+    buf->length += len;
+
+    return pdubuf_data(buf);
+}
+
+/**
+ * @brief Remove a header from the start of the PDU
+ * @param buf - PDU buffer
+ * @param len - number of bytes in the header
+ * @return pointer to the new start of the PDU, or NULL if the PDU
+ *  is shorter than the header
+ */
+uint8_t *pdubuf_pull(PDU_BUFFER *buf, uint16_t len)
+{
+    if (!buf || (len > pdubuf_length(buf))) {
+        return NULL;
+    }
+    buf->offset += len;
+    buf->length -= len;
+
+    return pdubuf_data(buf);
+}
+
+/**
+ * @brief Shorten the PDU, for example to remove a trailer
+ * @param buf - PDU buffer
+ * @param len - new number of bytes in the PDU
+ * @return true if the PDU was at least len bytes
+ */
+bool pdubuf_trim(PDU_BUFFER *buf, uint16_t len)
+{
+    if (!buf || (len > pdubuf_length(buf))) {
+        return false;
+    }
+    buf->length = len;
+
+    return true;
+}
+
+/**
+ * @brief Get the number of PDU buffers in the pool
+ * @return number of buffers that are not in use
+ */
+unsigned pdubuf_free_count(void)
+{
+    unsigned count = 0;
+    unsigned i;
+
+    for (i = 0; i < PDUBUF_POOL_SIZE; i++) {
+        if (PDU_Buffer_Pool[i].refcount == 0) {
+            count++;
+        }
+    }
+
+    return count;
+}
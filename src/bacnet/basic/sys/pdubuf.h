@@ -0,0 +1,78 @@
+/**
+ * @file
+ * @brief API for reference counted PDU buffers with headroom
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_PDUBUF_H
+#define BACNET_SYS_PDUBUF_H
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* number of PDU buffers in the static pool */
+#ifndef PDUBUF_POOL_SIZE
+#define PDUBUF_POOL_SIZE 4
+#endif
+/* room reserved before the NPDU for the datalink headers */
+#ifndef PDUBUF_HEADROOM
+#define PDUBUF_HEADROOM 32
+#endif
+/* size of each PDU buffer, including the headroom */
+#ifndef PDUBUF_SIZE
+#define PDUBUF_SIZE (PDUBUF_HEADROOM + MAX_PDU)
+#endif
+
+/* A PDU buffer holds a PDU between the offset and the offset plus the
+   length.  The bytes before the offset are headroom, so that each layer
+   can prepend its header in place, and the bytes after the PDU are
+   tailroom for the encoding of the PDU itself.  The buffer returns to
+   the pool when the last reference to it is released. */
+typedef struct PDU_Buffer {
+    uint8_t refcount; /* zero when the buffer is in the pool */
+    uint16_t offset; /* index of the first byte of the PDU */
+    uint16_t length; /* number of bytes in the PDU */
+    uint8_t storage[PDUBUF_SIZE];
+} PDU_BUFFER;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+PDU_BUFFER *pdubuf_alloc(uint16_t headroom);
+BACNET_STACK_EXPORT
+PDU_BUFFER *pdubuf_ref(PDU_BUFFER *buf);
+BACNET_STACK_EXPORT
+void pdubuf_unref(PDU_BUFFER *buf);
+BACNET_STACK_EXPORT
+unsigned pdubuf_refcount(const PDU_BUFFER *buf);
+
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_data(PDU_BUFFER *buf);
+BACNET_STACK_EXPORT
+uint16_t pdubuf_length(const PDU_BUFFER *buf);
+BACNET_STACK_EXPORT
+uint16_t pdubuf_headroom(const PDU_BUFFER *buf);
+BACNET_STACK_EXPORT
+uint16_t pdubuf_tailroom(const PDU_BUFFER *buf);
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_tail(PDU_BUFFER *buf);
+
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_put(PDU_BUFFER *buf, uint16_t len);
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_push(PDU_BUFFER *buf, uint16_t len);
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_pull(PDU_BUFFER *buf, uint16_t len);
+BACNET_STACK_EXPORT
+bool pdubuf_trim(PDU_BUFFER *buf, uint16_t len);
+
+BACNET_STACK_EXPORT
+unsigned pdubuf_free_count(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
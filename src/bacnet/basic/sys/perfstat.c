@@ -0,0 +1,483 @@
+/**
+ * @file
+ * @brief Performance counters and latency histograms of the BACnet stack
+ * @details The counters are updated with relaxed atomic operations where
+ * the compiler has them, so the stack threads and the thread taking a
+ * snapshot need no lock.  The latency histograms are log-linear: each
+ * power of two of microseconds is split into a few equal buckets, like
+ * an HDR histogram with a fixed range of 32 bits.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/perfstat.h"
+
+/* the 64 bit sum is only added whole where the target has the lock free
+   64 bit atomics; the 32 bit counters use the shim from platform.h */
+#if BACNET_STACK_ATOMIC64
+#define PERFSTAT_ADD64(p, n) (void)BACNET_STACK_FETCH_ADD((p), (n))
+#define PERFSTAT_LOAD64(p) BACNET_STACK_LOAD(p)
+#else
+#define PERFSTAT_ADD64(p, n) (*(p) += (n))
+#define PERFSTAT_LOAD64(p) (*(p))
+#endif
+
+static PERFSTAT_DATA Perfstat_Data;
+static perfstat_clock_function Perfstat_Clock;
+/* clock time of the last token received by this MS/TP node */
+static uint32_t Perfstat_Token_Time;
+static bool Perfstat_Token_Time_Valid;
+
+/**
+ * @brief Add to a counter
+ * @param counter - one of PERFSTAT_COUNTER
+ * @param count - number to add
+ */
+void perfstat_count(PERFSTAT_COUNTER counter, uint32_t count)
+{
+    if (counter < PERFSTAT_COUNTER_MAX) {
+        (void)BACNET_STACK_FETCH_ADD(&Perfstat_Data.counter[counter], count);
+    }
+}
+
+/**
+ * @brief Count a packet received from a datalink
+ * @param datalink - one of PERFSTAT_DATALINK
+ */
+void perfstat_datalink_receive(PERFSTAT_DATALINK datalink)
+{
+    if (datalink < PERFSTAT_DATALINK_MAX) {
+        (void)BACNET_STACK_FETCH_ADD(
+            &Perfstat_Data.datalink_receive[datalink], 1U);
+    }
+}
+
+/**
+ * @brief Count a packet sent to a datalink
+ * @param datalink - one of PERFSTAT_DATALINK
+ */
+void perfstat_datalink_send(PERFSTAT_DATALINK datalink)
+{
+    if (datalink < PERFSTAT_DATALINK_MAX) {
+        (void)BACNET_STACK_FETCH_ADD(
+            &Perfstat_Data.datalink_send[datalink], 1U);
+    }
+}
+
+/**
+ * @brief Count the BVLL messages forwarded by a BBMD
+ * @param datalink - one of PERFSTAT_DATALINK
+ * @param count - number of destinations the message was sent to
+ */
+void perfstat_datalink_forward(PERFSTAT_DATALINK datalink, uint32_t count)
+{
+    if (datalink < PERFSTAT_DATALINK_MAX) {
+        (void)BACNET_STACK_FETCH_ADD(
+            &Perfstat_Data.datalink_forward[datalink], count);
+    }
+}
+
+/**
+ * @brief Record the token rotation time when this MS/TP node receives
+ *  the token.  The MS/TP state machine runs in one thread, so the time
+ *  of the last token needs no atomic operations.
+ */
+void perfstat_mstp_token_received(void)
+{
+    uint32_t now;
+
+    if (!Perfstat_Clock) {
+        return;
+    }
+    now = Perfstat_Clock();
+    if (Perfstat_Token_Time_Valid) {
+        BACNET_STACK_STORE(
+            &Perfstat_Data.mstp_token_rotation, now - Perfstat_Token_Time);
+        perfstat_histogram_record(
+            &Perfstat_Data.mstp_token_rotation_histogram,
+            now - Perfstat_Token_Time);
+    }
+    Perfstat_Token_Time = now;
+    Perfstat_Token_Time_Valid = true;
+}
+
+/**
+ * @brief Set the clock used to measure the service handler latency.
+ *  Without a clock, the requests are counted but not measured.
+ * @param clock - function returning a free running time in microseconds,
+ *  or NULL
+ */
+void perfstat_clock_set(perfstat_clock_function clock)
+{
+    Perfstat_Clock = clock;
+}
+
+/**
+ * @brief Get the time of the clock used for the latency
+ * @return the time in microseconds, or zero without a clock
+ */
+uint32_t perfstat_clock(void)
+{
+    if (Perfstat_Clock) {
+        return Perfstat_Clock();
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Count a request given to a service handler, and record the
+ *  latency of the handler
+ * @param service - the service of the request
+ * @param start - the time from perfstat_clock() before the handler
+ */
+static void perfstat_service(PERFSTAT_SERVICE *service, uint32_t start)
+{
+    (void)BACNET_STACK_FETCH_ADD(&service->requests, 1U);
+    if (Perfstat_Clock) {
+        perfstat_histogram_record(&service->latency, Perfstat_Clock() - start);
+    }
+}
+
+/**
+ * @brief Count a confirmed service request, and record the latency of
+ *  its handler
+ * @param service - BACNET_CONFIRMED_SERVICE of the request
+ * @param start - the time from perfstat_clock() before the handler
+ */
+void perfstat_confirmed_service(uint8_t service, uint32_t start)
+{
+    if (service < MAX_BACNET_CONFIRMED_SERVICE) {
+        perfstat_service(&Perfstat_Data.confirmed[service], start);
+    }
+}
+
+/**
+ * @brief Count an unconfirmed service request, and record the latency of
+ *  its handler
+ * @param service - BACNET_UNCONFIRMED_SERVICE of the request
+ * @param start - the time from perfstat_clock() before the handler
+ */
+void perfstat_unconfirmed_service(uint8_t service, uint32_t start)
+{
+    if (service < MAX_BACNET_UNCONFIRMED_SERVICE) {
+        perfstat_service(&Perfstat_Data.unconfirmed[service], start);
+    }
+}
+
+/**
+ * @brief Get the histogram bucket of a value
+ * @param value - the value
+ * @return index of the bucket, less than PERFSTAT_HISTOGRAM_BUCKETS
+ */
+unsigned perfstat_histogram_bucket(uint32_t value)
+{
+    unsigned shift = 0;
+
+    /* the values below two powers of the sub-buckets have a bucket
+       each, and from there each power of two has the sub-buckets */
+    while ((value >> shift) >= (2U * PERFSTAT_HISTOGRAM_SUB_BUCKETS)) {
+        shift++;
+    }
+
+    return (shift * PERFSTAT_HISTOGRAM_SUB_BUCKETS) + (value >> shift);
+}
+
+/**
+ * @brief Get the largest value of a histogram bucket, for example for
+ *  the upper bound of a cumulative histogram bucket
+ * @param index - index of the bucket
+ * @return the largest value counted in the bucket
+ */
+uint32_t perfstat_histogram_bucket_limit(unsigned index)
+{
+    unsigned shift = 0;
+    uint32_t base = 0;
+
+    if (index >= PERFSTAT_HISTOGRAM_BUCKETS) {
+        return UINT32_MAX;
+    }
+    if (index >= (2U * PERFSTAT_HISTOGRAM_SUB_BUCKETS)) {
+        shift = (index / PERFSTAT_HISTOGRAM_SUB_BUCKETS) - 1U;
+    }
+    base = index - (shift * PERFSTAT_HISTOGRAM_SUB_BUCKETS);
+
+    return (uint32_t)((((uint64_t)base + 1U) << shift) - 1U);
+}
+
+/**
+ * @brief Record a value in a histogram
+ * @param histogram - the histogram
+ * @param value - the value, for example a latency in microseconds
+ */
+void perfstat_histogram_record(PERFSTAT_HISTOGRAM *histogram, uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    uint32_t max;
+#endif
+
+    if (!histogram) {
+        return;
+    }
+    (void)BACNET_STACK_FETCH_ADD(&histogram->count, 1U);
+    PERFSTAT_ADD64(&histogram->sum, (uint64_t)value);
+    (void)BACNET_STACK_FETCH_ADD(
+        &histogram->bucket[perfstat_histogram_bucket(value)], 1U);
+#if defined(__GNUC__) || defined(__clang__)
+    max = BACNET_STACK_LOAD(&histogram->max);
+    while ((value > max) &&
+           !__atomic_compare_exchange_n(
+               &histogram->max, &max, value, true, __ATOMIC_RELAXED,
+               __ATOMIC_RELAXED)) {
+        /* another thread changed the largest value - try again */
+    }
+#else
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+#endif
+}
+
+/**
+ * @brief Estimate a quantile of the values in a histogram, in tenths
+ *  of a percent, for the tail latency like the 99.9th percentile
+ * @param histogram - the histogram
+ * @param permille - the quantile, 0 to 1000
+ * @return the largest value of the bucket that holds the quantile,
+ *  but not more than the largest value recorded, or zero when empty
+ */
+uint32_t perfstat_histogram_permille(
+    const PERFSTAT_HISTOGRAM *histogram, unsigned permille)
+{
+    uint64_t rank = 0;
+    uint64_t total = 0;
+    uint32_t limit = 0;
+    unsigned index = 0;
+
+    if (!histogram || (histogram->count == 0)) {
+        return 0;
+    }
+    if (permille > 1000) {
+        permille = 1000;
+    }
+    /* the rank of the value, counting from one */
+    rank = (((uint64_t)histogram->count * permille) + 999U) / 1000U;
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (index = 0; index < PERFSTAT_HISTOGRAM_BUCKETS; index++) {
+        total += histogram->bucket[index];
+        if (total >= rank) {
+            limit = perfstat_histogram_bucket_limit(index);
+            break;
+        }
+    }
+    if (limit > histogram->max) {
+        limit = histogram->max;
+    }
+
+    return limit;
+}
+
+/**
+ * @brief Estimate a percentile of the values in a histogram
+ * @param histogram - the histogram
+ * @param percent - the percentile, 0 to 100
+ * @return the largest value of the bucket that holds the percentile,
+ *  but not more than the largest value recorded, or zero when empty
+ */
+uint32_t perfstat_histogram_percentile(
+    const PERFSTAT_HISTOGRAM *histogram, unsigned percent)
+{
+    if (percent > 100) {
+        percent = 100;
+    }
+
+    return perfstat_histogram_permille(histogram, percent * 10U);
+}
+
+/**
+ * @brief Get a counter, without the copy of a snapshot
+ * @param counter - one of PERFSTAT_COUNTER
+ * @return the count, or zero for an unknown counter
+ */
+uint32_t perfstat_counter(PERFSTAT_COUNTER counter)
+{
+    if (counter < PERFSTAT_COUNTER_MAX) {
+        return BACNET_STACK_LOAD(&Perfstat_Data.counter[counter]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the number of packets received from a datalink
+ * @param datalink - one of PERFSTAT_DATALINK
+ * @return the count, or zero for an unknown datalink
+ */
+uint32_t perfstat_datalink_receive_count(PERFSTAT_DATALINK datalink)
+{
+    if (datalink < PERFSTAT_DATALINK_MAX) {
+        return BACNET_STACK_LOAD(&Perfstat_Data.datalink_receive[datalink]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the number of packets sent to a datalink
+ * @param datalink - one of PERFSTAT_DATALINK
+ * @return the count, or zero for an unknown datalink
+ */
+uint32_t perfstat_datalink_send_count(PERFSTAT_DATALINK datalink)
+{
+    if (datalink < PERFSTAT_DATALINK_MAX) {
+        return BACNET_STACK_LOAD(&Perfstat_Data.datalink_send[datalink]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the number of BVLL messages forwarded by a BBMD
+ * @param datalink - one of PERFSTAT_DATALINK
+ * @return the count, or zero for an unknown datalink
+ */
+uint32_t perfstat_datalink_forward_count(PERFSTAT_DATALINK datalink)
+{
+    if (datalink < PERFSTAT_DATALINK_MAX) {
+        return BACNET_STACK_LOAD(&Perfstat_Data.datalink_forward[datalink]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the number of confirmed service requests of all services
+ * @return the count
+ */
+uint32_t perfstat_confirmed_requests(void)
+{
+    uint32_t count = 0;
+    unsigned i;
+
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        count += BACNET_STACK_LOAD(&Perfstat_Data.confirmed[i].requests);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the number of unconfirmed service requests of all services
+ * @return the count
+ */
+uint32_t perfstat_unconfirmed_requests(void)
+{
+    uint32_t count = 0;
+    unsigned i;
+
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        count += BACNET_STACK_LOAD(&Perfstat_Data.unconfirmed[i].requests);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the last MS/TP token rotation time
+ * @return the time in microseconds, or zero when not measured
+ */
+uint32_t perfstat_mstp_token_rotation(void)
+{
+    return BACNET_STACK_LOAD(&Perfstat_Data.mstp_token_rotation);
+}
+
+/**
+ * @brief Get the longest MS/TP token rotation time
+ * @return the time in microseconds, or zero when not measured
+ */
+uint32_t perfstat_mstp_token_rotation_max(void)
+{
+    return BACNET_STACK_LOAD(&Perfstat_Data.mstp_token_rotation_histogram.max);
+}
+
+/**
+ * @brief Copy a histogram
+ * @param target - the copy
+ * @param source - the histogram
+ */
+static void
+perfstat_histogram_copy(PERFSTAT_HISTOGRAM *target, PERFSTAT_HISTOGRAM *source)
+{
+    unsigned i;
+
+    target->count = BACNET_STACK_LOAD(&source->count);
+    target->max = BACNET_STACK_LOAD(&source->max);
+    target->sum = PERFSTAT_LOAD64(&source->sum);
+    for (i = 0; i < PERFSTAT_HISTOGRAM_BUCKETS; i++) {
+        target->bucket[i] = BACNET_STACK_LOAD(&source->bucket[i]);
+    }
+}
+
+/**
+ * @brief Copy the counters of a service
+ * @param target - the copy
+ * @param source - the counters
+ */
+static void
+perfstat_service_copy(PERFSTAT_SERVICE *target, PERFSTAT_SERVICE *source)
+{
+    target->requests = BACNET_STACK_LOAD(&source->requests);
+    perfstat_histogram_copy(&target->latency, &source->latency);
+}
+
+/**
+ * @brief Copy the counters and histograms, for example for an exporter.
+ *  The counters keep counting while they are copied, so they are not
+ *  all from the same instant.
+ * @param data - the copy
+ */
+void perfstat_snapshot(PERFSTAT_DATA *data)
+{
+    unsigned i;
+
+    if (!data) {
+        return;
+    }
+    for (i = 0; i < PERFSTAT_DATALINK_MAX; i++) {
+        data->datalink_receive[i] =
+            BACNET_STACK_LOAD(&Perfstat_Data.datalink_receive[i]);
+        data->datalink_send[i] =
+            BACNET_STACK_LOAD(&Perfstat_Data.datalink_send[i]);
+        data->datalink_forward[i] =
+            BACNET_STACK_LOAD(&Perfstat_Data.datalink_forward[i]);
+    }
+    for (i = 0; i < PERFSTAT_COUNTER_MAX; i++) {
+        data->counter[i] = BACNET_STACK_LOAD(&Perfstat_Data.counter[i]);
+    }
+    data->mstp_token_rotation =
+        BACNET_STACK_LOAD(&Perfstat_Data.mstp_token_rotation);
+    perfstat_histogram_copy(
+        &data->mstp_token_rotation_histogram,
+        &Perfstat_Data.mstp_token_rotation_histogram);
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        perfstat_service_copy(
+            &data->confirmed[i], &Perfstat_Data.confirmed[i]);
+    }
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        perfstat_service_copy(
+            &data->unconfirmed[i], &Perfstat_Data.unconfirmed[i]);
+    }
+}
+
+/**
+ * @brief Set all the counters and histograms to zero
+ */
+void perfstat_reset(void)
+{
+    memset(&Perfstat_Data, 0, sizeof(Perfstat_Data));
+    Perfstat_Token_Time_Valid = false;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file
+ * @brief API for the performance counters and latency histograms
+ *  of the BACnet stack
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_PERFSTAT_H
+#define BACNET_SYS_PERFSTAT_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* The stack counts its work where it happens when this is enabled.
+   When it is disabled, the PERFSTAT_ macros at those places compile
+   to nothing, and the snapshot stays zero. */
+#ifndef BACNET_PERFSTAT_ENABLED
+#define BACNET_PERFSTAT_ENABLED 0
+#endif
+
+/* The latency histograms keep 2^N buckets for each power of two of
+   microseconds, so a value is known within 1/2^N of itself. */
+#ifndef PERFSTAT_HISTOGRAM_SUB_BUCKET_BITS
+#define PERFSTAT_HISTOGRAM_SUB_BUCKET_BITS 2
+#endif
+#define PERFSTAT_HISTOGRAM_SUB_BUCKETS \
+    (1U << PERFSTAT_HISTOGRAM_SUB_BUCKET_BITS)
+#define PERFSTAT_HISTOGRAM_BUCKETS                \
+    ((33U - PERFSTAT_HISTOGRAM_SUB_BUCKET_BITS) * \
+     PERFSTAT_HISTOGRAM_SUB_BUCKETS)
+
+typedef enum perfstat_datalink {
+    PERFSTAT_DATALINK_NONE = 0,
+    PERFSTAT_DATALINK_BIP,
+    PERFSTAT_DATALINK_BIP6,
+    PERFSTAT_DATALINK_MSTP,
+    PERFSTAT_DATALINK_ETHERNET,
+    PERFSTAT_DATALINK_ARCNET,
+    PERFSTAT_DATALINK_ZIGBEE,
+    PERFSTAT_DATALINK_BSC,
+    PERFSTAT_DATALINK_MAX
+} PERFSTAT_DATALINK;
+
+typedef enum perfstat_counter {
+    /* NPDU or APDU that could not be decoded and were dropped */
+    PERFSTAT_DECODE_ERRORS = 0,
+    /* confirmed requests sent again after the APDU timeout */
+    PERFSTAT_TSM_RETRIES,
+    /* confirmed requests that were not confirmed after the retries */
+    PERFSTAT_TSM_TIMEOUTS,
+    /* COV notifications sent, one for each subscription notified */
+    PERFSTAT_COV_NOTIFICATIONS,
+    /* device address lookups answered from the address cache */
+    PERFSTAT_ADDRESS_CACHE_HITS,
+    /* device address lookups that needed a binding */
+    PERFSTAT_ADDRESS_CACHE_MISSES,
+    PERFSTAT_COUNTER_MAX
+} PERFSTAT_COUNTER;
+
+/* latency of a service handler, in microseconds */
+typedef struct perfstat_histogram {
+    uint32_t count;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t bucket[PERFSTAT_HISTOGRAM_BUCKETS];
+} PERFSTAT_HISTOGRAM;
+
+typedef struct perfstat_service {
+    /* number of requests given to the service handler */
+    uint32_t requests;
+    /* measured when a clock is set */
+    PERFSTAT_HISTOGRAM latency;
+} PERFSTAT_SERVICE;
+
+/* All counters count up from the start or the last reset, and wrap
+   around at 2^32. */
+typedef struct perfstat_data {
+    uint32_t datalink_receive[PERFSTAT_DATALINK_MAX];
+    uint32_t datalink_send[PERFSTAT_DATALINK_MAX];
+    /* BVLL messages forwarded by a BBMD, one for each destination */
+    uint32_t datalink_forward[PERFSTAT_DATALINK_MAX];
+    uint32_t counter[PERFSTAT_COUNTER_MAX];
+    /* time from one token received by this MS/TP node to the next,
+       measured when a clock is set */
+    uint32_t mstp_token_rotation;
+    PERFSTAT_HISTOGRAM mstp_token_rotation_histogram;
+    PERFSTAT_SERVICE confirmed[MAX_BACNET_CONFIRMED_SERVICE];
+    PERFSTAT_SERVICE unconfirmed[MAX_BACNET_UNCONFIRMED_SERVICE];
+} PERFSTAT_DATA;
+
+/**
+ * @brief Callback for a free running clock
+ * @return the time in microseconds
+ */
+typedef uint32_t (*perfstat_clock_function)(void);
+
+#if BACNET_PERFSTAT_ENABLED
+#define PERFSTAT_COUNT(counter) perfstat_count((counter), 1)
+#define PERFSTAT_COUNT_ADD(counter, n) perfstat_count((counter), (n))
+#define PERFSTAT_DATALINK_RECEIVE(datalink) \
+    perfstat_datalink_receive(datalink)
+#define PERFSTAT_DATALINK_SEND(datalink) perfstat_datalink_send(datalink)
+#define PERFSTAT_DATALINK_FORWARD(datalink, n) \
+    perfstat_datalink_forward((datalink), (n))
+#define PERFSTAT_MSTP_TOKEN_RECEIVED() perfstat_mstp_token_received()
+#else
+#define PERFSTAT_COUNT(counter) ((void)0)
+#define PERFSTAT_COUNT_ADD(counter, n) ((void)0)
+#define PERFSTAT_DATALINK_RECEIVE(datalink) ((void)0)
+#define PERFSTAT_DATALINK_SEND(datalink) ((void)0)
+#define PERFSTAT_DATALINK_FORWARD(datalink, n) ((void)0)
+#define PERFSTAT_MSTP_TOKEN_RECEIVED() ((void)0)
+#endif
+
+/* The counters are readable as proprietary properties of the Device
+   and Network Port objects, so that they can be trended over BACnet.
+   The properties are Unsigned, and the times are in microseconds. */
+#ifndef PERFSTAT_PROPERTY_MIN
+#define PERFSTAT_PROPERTY_MIN 512
+#endif
+typedef enum perfstat_property {
+    /* Device object */
+    PROP_PERFSTAT_DECODE_ERRORS = PERFSTAT_PROPERTY_MIN,
+    PROP_PERFSTAT_CONFIRMED_REQUESTS,
+    PROP_PERFSTAT_UNCONFIRMED_REQUESTS,
+    PROP_PERFSTAT_TSM_ACTIVE_TRANSACTIONS,
+    PROP_PERFSTAT_TSM_RETRIES,
+    PROP_PERFSTAT_TSM_TIMEOUTS,
+    PROP_PERFSTAT_COV_SUBSCRIPTIONS,
+    PROP_PERFSTAT_COV_NOTIFICATIONS,
+    PROP_PERFSTAT_ADDRESS_CACHE_HITS,
+    PROP_PERFSTAT_ADDRESS_CACHE_MISSES,
+    /* Network Port object */
+    PROP_PERFSTAT_PACKETS_RECEIVED,
+    PROP_PERFSTAT_PACKETS_SENT,
+    PROP_PERFSTAT_BBMD_FORWARDS,
+    PROP_PERFSTAT_TOKEN_ROTATION_TIME,
+    PROP_PERFSTAT_TOKEN_ROTATION_TIME_MAX
+} PERFSTAT_PROPERTY;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void perfstat_count(PERFSTAT_COUNTER counter, uint32_t count);
+BACNET_STACK_EXPORT
+void perfstat_datalink_receive(PERFSTAT_DATALINK datalink);
+BACNET_STACK_EXPORT
+void perfstat_datalink_send(PERFSTAT_DATALINK datalink);
+BACNET_STACK_EXPORT
+void perfstat_datalink_forward(PERFSTAT_DATALINK datalink, uint32_t count);
+BACNET_STACK_EXPORT
+void perfstat_mstp_token_received(void);
+
+BACNET_STACK_EXPORT
+void perfstat_clock_set(perfstat_clock_function clock);
+BACNET_STACK_EXPORT
+uint32_t perfstat_clock(void);
+BACNET_STACK_EXPORT
+void perfstat_confirmed_service(uint8_t service, uint32_t start);
+BACNET_STACK_EXPORT
+void perfstat_unconfirmed_service(uint8_t service, uint32_t start);
+
+BACNET_STACK_EXPORT
+void perfstat_histogram_record(PERFSTAT_HISTOGRAM *histogram, uint32_t value);
+BACNET_STACK_EXPORT
+unsigned perfstat_histogram_bucket(uint32_t value);
+BACNET_STACK_EXPORT
+uint32_t perfstat_histogram_bucket_limit(unsigned index);
+BACNET_STACK_EXPORT
+uint32_t perfstat_histogram_percentile(
+    const PERFSTAT_HISTOGRAM *histogram, unsigned percent);
+BACNET_STACK_EXPORT
+uint32_t perfstat_histogram_permille(
+    const PERFSTAT_HISTOGRAM *histogram, unsigned permille);
+
+BACNET_STACK_EXPORT
+uint32_t perfstat_counter(PERFSTAT_COUNTER counter);
+BACNET_STACK_EXPORT
+uint32_t perfstat_datalink_receive_count(PERFSTAT_DATALINK datalink);
+BACNET_STACK_EXPORT
+uint32_t perfstat_datalink_send_count(PERFSTAT_DATALINK datalink);
+BACNET_STACK_EXPORT
+uint32_t perfstat_datalink_forward_count(PERFSTAT_DATALINK datalink);
+BACNET_STACK_EXPORT
+uint32_t perfstat_confirmed_requests(void);
+BACNET_STACK_EXPORT
+uint32_t perfstat_unconfirmed_requests(void);
+BACNET_STACK_EXPORT
+uint32_t perfstat_mstp_token_rotation(void);
+BACNET_STACK_EXPORT
+uint32_t perfstat_mstp_token_rotation_max(void);
+
+BACNET_STACK_EXPORT
+void perfstat_snapshot(PERFSTAT_DATA *data);
+BACNET_STACK_EXPORT
+void perfstat_reset(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -10,6 +10,7 @@
 #ifndef BACNET_SYS_PLATFORM_H
 #define BACNET_SYS_PLATFORM_H
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <limits.h>
 #include <math.h>
@@ -45,6 +46,88 @@
 #define BACNET_STACK_DEPRECATED(message)
 #endif
 
+/* marking some data as one copy per thread, for example the data that
+   selects which routed device the calling thread is accessing */
+#if defined(BACNET_STACK_THREAD_LOCAL_DISABLE)
+#define BACNET_STACK_THREAD_LOCAL
+#elif defined(_MSC_VER)
+#define BACNET_STACK_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define BACNET_STACK_THREAD_LOCAL __thread
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+    !defined(__STDC_NO_THREADS__)
+#define BACNET_STACK_THREAD_LOCAL _Thread_local
+#else
+#define BACNET_STACK_THREAD_LOCAL
+#endif
+
+/* ordering the data that one thread or interrupt hands over to another
+   with the index, counter, or sequence that hands it over: the producer
+   stores the data, then BACNET_STACK_RELEASE(), then the index, and the
+   consumer loads the index, then BACNET_STACK_ACQUIRE(), then the data.
+   The loads and stores of a 32 bit index are whole, and the add is a
+   read, modify, write where the GCC builtins exist.  The fences are
+   empty, with BACNET_STACK_ATOMIC_FENCES 0, only when the compiler has
+   none, which is enough for an interrupt on a single core target. */
+#if defined(__GNUC__)
+#define BACNET_STACK_ATOMIC_FENCES 1
+#define BACNET_STACK_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define BACNET_STACK_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define BACNET_STACK_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define BACNET_STACK_STORE(p, n) __atomic_store_n((p), (n), __ATOMIC_RELAXED)
+#define BACNET_STACK_FETCH_ADD(p, n) \
+    __atomic_fetch_add((p), (n), __ATOMIC_RELAXED)
+#if defined(__GCC_ATOMIC_LLONG_LOCK_FREE) && \
+    (__GCC_ATOMIC_LLONG_LOCK_FREE == 2)
+#define BACNET_STACK_ATOMIC64 1
+#endif
+#else
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && \
+    !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define BACNET_STACK_ATOMIC_FENCES 1
+#define BACNET_STACK_ACQUIRE() atomic_thread_fence(memory_order_acquire)
+#define BACNET_STACK_RELEASE() atomic_thread_fence(memory_order_release)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+/* x86 loads acquire and stores release, so only the compiler
+   has to be kept from moving the accesses */
+#include <intrin.h>
+#define BACNET_STACK_ATOMIC_FENCES 1
+#define BACNET_STACK_ACQUIRE() _ReadWriteBarrier()
+#define BACNET_STACK_RELEASE() _ReadWriteBarrier()
+#else
+#define BACNET_STACK_ATOMIC_FENCES 0
+#define BACNET_STACK_ACQUIRE() ((void)0)
+#define BACNET_STACK_RELEASE() ((void)0)
+#endif
+#define BACNET_STACK_LOAD(p) (*(volatile const uint32_t *)(p))
+#define BACNET_STACK_STORE(p, n) (*(volatile uint32_t *)(p) = (n))
+#define BACNET_STACK_FETCH_ADD(p, n) ((*(p) += (n)) - (n))
+#endif
+#ifndef BACNET_STACK_ATOMIC64
+#define BACNET_STACK_ATOMIC64 0
+#endif
+
+/* marking constant tables that stay in program memory on Harvard
+   architecture targets such as AVR, instead of being copied to RAM at
+   startup. The tables are then only read with the bacnet_progmem_*()
+   accessors, which are plain reads on the other targets. */
+#ifndef BACNET_STACK_PROGMEM_ENABLED
+#define BACNET_STACK_PROGMEM_ENABLED 0
+#endif
+#if BACNET_STACK_PROGMEM_ENABLED && defined(__AVR__) && defined(__GNUC__)
+#include <avr/pgmspace.h>
+#define BACNET_STACK_PROGMEM PROGMEM
+#define bacnet_progmem_uint32(address) pgm_read_dword(address)
+#define bacnet_progmem_pointer(address) ((const void *)pgm_read_word(address))
+#elif BACNET_STACK_PROGMEM_ENABLED
+#error "BACNET_STACK_PROGMEM_ENABLED needs avr-gcc and avr-libc"
+#else
+#define BACNET_STACK_PROGMEM
+#define bacnet_progmem_uint32(address) (*(address))
+#define bacnet_progmem_pointer(address) ((const void *)*(address))
+#endif
+
 #if defined(_MSC_VER)
 #ifndef __inline__
 #define __inline__ __inline
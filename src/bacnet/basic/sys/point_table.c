@@ -0,0 +1,323 @@
+/**
+ * @file
+ * @brief A table of point values shared with other processes, where
+ *  each point is a seqlock with one writer and one reader
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "bacnet/basic/sys/point_table.h"
+
+/* The sequence is read and written whole, and the fences order it with
+   the point data: the writer makes the sequence odd before it changes
+   the data and even after, and the reader reads the data between two
+   reads of the sequence. */
+#if !BACNET_STACK_ATOMIC_FENCES
+#error "the point table needs the memory fences of platform.h"
+#endif
+
+/* number of times a reader copies a point that is changing before
+   it leaves it for the next poll */
+#ifndef POINT_TABLE_READ_RETRIES
+#define POINT_TABLE_READ_RETRIES 16
+#endif
+
+/**
+ * @brief Get the points that follow the header of the table
+ * @param table - the point table
+ * @return the first point
+ */
+static struct Point_Table_Point *Point_Table_Points(const POINT_TABLE *table)
+{
+    return (struct Point_Table_Point *)(void *)((uint8_t *)table +
+                                                sizeof(POINT_TABLE));
+}
+
+/**
+ * @brief Get a point of the table
+ * @param table - the point table
+ * @param index - 0..count-1
+ * @return the point, or NULL if the index is out of range
+ */
+static struct Point_Table_Point *
+Point_Table_Point(const POINT_TABLE *table, unsigned index)
+{
+    if (!table || (index >= table->count)) {
+        return NULL;
+    }
+
+    return &Point_Table_Points(table)[index];
+}
+
+/**
+ * @brief Get the number of bytes of memory for a table of points
+ * @param count - number of points
+ * @return number of bytes
+ */
+size_t Point_Table_Size(unsigned count)
+{
+    return sizeof(POINT_TABLE) + (count * sizeof(struct Point_Table_Point));
+}
+
+/**
+ * @brief Make a new table of unbound points in a block of memory
+ * @param memory - block of memory, aligned for a double
+ * @param size - number of bytes in the block
+ * @param count - number of points
+ * @return the table, or NULL if the block is too small
+ */
+POINT_TABLE *Point_Table_Format(void *memory, size_t size, unsigned count)
+{
+    POINT_TABLE *table = memory;
+
+    if (!table || (size < Point_Table_Size(count))) {
+        return NULL;
+    }
+    memset(memory, 0, Point_Table_Size(count));
+    table->version = POINT_TABLE_VERSION;
+    table->point_size = sizeof(struct Point_Table_Point);
+    table->count = count;
+    /* the magic is last, so another process attaching sees a whole
+       header or none */
+    BACNET_STACK_RELEASE();
+    BACNET_STACK_STORE(&table->magic, POINT_TABLE_MAGIC);
+
+    return table;
+}
+
+/**
+ * @brief Use a table of points that was made by another process
+ * @param memory - block of memory holding the table
+ * @param size - number of bytes in the block
+ * @return the table, or NULL if the block does not hold a valid table
+ */
+POINT_TABLE *Point_Table_Attach(void *memory, size_t size)
+{
+    POINT_TABLE *table = memory;
+
+    if (!table || (size < sizeof(POINT_TABLE))) {
+        return NULL;
+    }
+    if (BACNET_STACK_LOAD(&table->magic) != POINT_TABLE_MAGIC) {
+        return NULL;
+    }
+    BACNET_STACK_ACQUIRE();
+    if ((table->version != POINT_TABLE_VERSION) ||
+        (table->point_size != sizeof(struct Point_Table_Point)) ||
+        (size < Point_Table_Size(table->count))) {
+        return NULL;
+    }
+
+    return table;
+}
+
+/**
+ * @brief Get the number of points in the table
+ * @param table - the point table
+ * @return number of points
+ */
+unsigned Point_Table_Count(const POINT_TABLE *table)
+{
+    if (!table) {
+        return 0;
+    }
+
+    return table->count;
+}
+
+/**
+ * @brief Bind a point to an object. The point has no valid value until
+ *  the writer gives it one.
+ * @param table - the point table
+ * @param index - 0..count-1
+ * @param object_type - the object type of the point
+ * @param object_instance - the object instance of the point
+ * @return true if the point was bound
+ */
+bool Point_Table_Bind(
+    POINT_TABLE *table,
+    unsigned index,
+    uint16_t object_type,
+    uint32_t object_instance)
+{
+    struct Point_Table_Point *point;
+    uint32_t sequence;
+
+    point = Point_Table_Point(table, index);
+    if (!point) {
+        return false;
+    }
+    sequence = BACNET_STACK_LOAD(&point->sequence);
+    BACNET_STACK_STORE(&point->sequence, sequence | 1UL);
+    BACNET_STACK_RELEASE();
+    point->object_type = object_type;
+    point->object_instance = object_instance;
+    point->flags = POINT_TABLE_FLAG_BOUND;
+    BACNET_STACK_RELEASE();
+    BACNET_STACK_STORE(&point->sequence, (sequence | 1UL) + 1UL);
+    /* nothing to pick up until the writer gives it a value */
+    point->applied = (sequence | 1UL) + 1UL;
+
+    return true;
+}
+
+/**
+ * @brief Find the point that is bound to an object
+ * @param table - the point table
+ * @param object_type - the object type of the point
+ * @param object_instance - the object instance of the point
+ * @return index of the point, or -1 if not found
+ */
+int Point_Table_Find(
+    const POINT_TABLE *table, uint16_t object_type, uint32_t object_instance)
+{
+    const struct Point_Table_Point *point;
+    unsigned index;
+
+    if (!table) {
+        return -1;
+    }
+    point = Point_Table_Points(table);
+    for (index = 0; index < table->count; index++) {
+        if ((point[index].flags & POINT_TABLE_FLAG_BOUND) &&
+            (point[index].object_type == object_type) &&
+            (point[index].object_instance == object_instance)) {
+            return (int)index;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Write the value of a point, from the one writer of the point
+ * @param table - the point table
+ * @param index - 0..count-1
+ * @param value - the new value of the point
+ * @return true if the point is bound and was written
+ */
+bool Point_Table_Write(
+    POINT_TABLE *table, unsigned index, const POINT_TABLE_VALUE *value)
+{
+    struct Point_Table_Point *point;
+    uint32_t sequence;
+
+    point = Point_Table_Point(table, index);
+    if (!point || !value || !(point->flags & POINT_TABLE_FLAG_BOUND)) {
+        return false;
+    }
+    sequence = BACNET_STACK_LOAD(&point->sequence);
+    BACNET_STACK_STORE(&point->sequence, sequence + 1UL);
+    BACNET_STACK_RELEASE();
+    point->value = value->value;
+    point->timestamp = value->timestamp;
+    point->reliability = value->reliability;
+    point->flags |= POINT_TABLE_FLAG_VALID;
+    BACNET_STACK_RELEASE();
+    BACNET_STACK_STORE(&point->sequence, sequence + 2UL);
+
+    return true;
+}
+
+/**
+ * @brief Copy the value of a point, as one consistent value
+ * @param point - the point
+ * @param value - [out] the value of the point
+ * @param sequence - [out] the sequence of the copied value
+ * @return true if a consistent and valid value was copied
+ */
+static bool Point_Table_Point_Read(
+    struct Point_Table_Point *point,
+    POINT_TABLE_VALUE *value,
+    uint32_t *sequence)
+{
+    uint32_t before, after;
+    uint8_t flags;
+    unsigned retries = POINT_TABLE_READ_RETRIES;
+
+    do {
+        before = BACNET_STACK_LOAD(&point->sequence);
+        if (before & 1UL) {
+            continue;
+        }
+        BACNET_STACK_ACQUIRE();
+        value->value = point->value;
+        value->timestamp = point->timestamp;
+        value->reliability = point->reliability;
+        flags = point->flags;
+        BACNET_STACK_ACQUIRE();
+        after = BACNET_STACK_LOAD(&point->sequence);
+        if (before == after) {
+            *sequence = before;
+            return (flags & POINT_TABLE_FLAG_VALID) != 0;
+        }
+    } while (--retries);
+
+    return false;
+}
+
+/**
+ * @brief Read the value of a point
+ * @param table - the point table
+ * @param index - 0..count-1
+ * @param value - [out] the value of the point
+ * @return true if the point has a valid value that was not changing
+ */
+bool Point_Table_Read(
+    POINT_TABLE *table, unsigned index, POINT_TABLE_VALUE *value)
+{
+    struct Point_Table_Point *point;
+    uint32_t sequence;
+
+    point = Point_Table_Point(table, index);
+    if (!point || !value) {
+        return false;
+    }
+
+    return Point_Table_Point_Read(point, value, &sequence);
+}
+
+/**
+ * @brief Pick up the points that changed since the last poll, from the
+ *  one reader of the table. A point that is changing during the poll is
+ *  picked up by the next poll.
+ * @param table - the point table
+ * @param callback - called with each changed point
+ * @param context - passed to the callback
+ * @return number of points that were picked up
+ */
+unsigned Point_Table_Poll(
+    POINT_TABLE *table, point_table_update_callback callback, void *context)
+{
+    struct Point_Table_Point *point;
+    POINT_TABLE_VALUE value;
+    uint32_t sequence;
+    unsigned index;
+    unsigned count = 0;
+
+    if (!table) {
+        return 0;
+    }
+    point = Point_Table_Points(table);
+    for (index = 0; index < table->count; index++) {
+        if (BACNET_STACK_LOAD(&point[index].sequence) ==
+            point[index].applied) {
+            continue;
+        }
+        if (!Point_Table_Point_Read(&point[index], &value, &sequence)) {
+            continue;
+        }
+        point[index].applied = sequence;
+        if (callback) {
+            callback(
+                point[index].object_type, point[index].object_instance,
+                &value, context);
+        }
+        count++;
+    }
+
+    return count;
+}
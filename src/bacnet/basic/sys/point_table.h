@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @brief API for a table of point values shared with other processes
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_POINT_TABLE_H
+#define BACNET_SYS_POINT_TABLE_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* A point table is a header and an array of points in one block of
+   memory, such as a shared memory mapping, that holds no pointers, so
+   each process can map it at its own address.  Each point is bound to
+   an object, and has one writer, such as a field-bus driver process,
+   and one reader, the BACnet stack.  A sequence number makes each point
+   a seqlock: the writer makes it odd while the value changes and even
+   when done, and the reader copies the value and keeps it only if the
+   sequence was even and unchanged, so neither side takes a lock or
+   makes a system call.  The reader remembers the sequence it applied,
+   and a poll picks up only the points that changed since then. */
+#define POINT_TABLE_MAGIC 0x50544142UL
+#define POINT_TABLE_VERSION 1
+
+/* point flags */
+#define POINT_TABLE_FLAG_BOUND 0x01
+/* the reliability and value are from the writer */
+#define POINT_TABLE_FLAG_VALID 0x02
+
+typedef struct Point_Table_Value {
+    double value;
+    /* milliseconds since the epoch of the writer, for staleness checks */
+    uint64_t timestamp;
+    /* BACNET_RELIABILITY of the value */
+    uint8_t reliability;
+} POINT_TABLE_VALUE;
+
+struct Point_Table_Point {
+    /* odd while the writer changes the point */
+    uint32_t sequence;
+    /* sequence last picked up by the reader */
+    uint32_t applied;
+    uint32_t object_instance;
+    uint16_t object_type;
+    uint8_t flags;
+    uint8_t reliability;
+    double value;
+    uint64_t timestamp;
+};
+
+typedef struct Point_Table {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t point_size;
+    uint32_t count;
+    uint32_t reserved;
+    /* followed by count of struct Point_Table_Point */
+} POINT_TABLE;
+
+/**
+ * @brief Called for each point that changed since the last poll
+ * @param object_type - the object type bound to the point
+ * @param object_instance - the object instance bound to the point
+ * @param value - a consistent copy of the point value
+ * @param context - the context given to the poll
+ */
+typedef void (*point_table_update_callback)(
+    uint16_t object_type,
+    uint32_t object_instance,
+    const POINT_TABLE_VALUE *value,
+    void *context);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+size_t Point_Table_Size(unsigned count);
+BACNET_STACK_EXPORT
+POINT_TABLE *Point_Table_Format(void *memory, size_t size, unsigned count);
+BACNET_STACK_EXPORT
+POINT_TABLE *Point_Table_Attach(void *memory, size_t size);
+BACNET_STACK_EXPORT
+unsigned Point_Table_Count(const POINT_TABLE *table);
+
+BACNET_STACK_EXPORT
+bool Point_Table_Bind(
+    POINT_TABLE *table,
+    unsigned index,
+    uint16_t object_type,
+    uint32_t object_instance);
+BACNET_STACK_EXPORT
+int Point_Table_Find(
+    const POINT_TABLE *table, uint16_t object_type, uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+bool Point_Table_Write(
+    POINT_TABLE *table, unsigned index, const POINT_TABLE_VALUE *value);
+BACNET_STACK_EXPORT
+bool Point_Table_Read(
+    POINT_TABLE *table, unsigned index, POINT_TABLE_VALUE *value);
+BACNET_STACK_EXPORT
+unsigned Point_Table_Poll(
+    POINT_TABLE *table, point_table_update_callback callback, void *context);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file
+ * @brief The state of a BACnet priority array, which is shared by the
+ *  commandable objects. The commanded slots are kept as bits, and the
+ *  active priority is found when a slot is commanded or relinquished,
+ *  so that reading the Present_Value does not scan the 16 slots.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "bacnet/basic/sys/priority_array.h"
+
+/**
+ * @brief Find the highest commanded priority at or below a priority
+ * @param active_bits - the commanded slots
+ * @param priority - the priority 1..16 to start from
+ * @return the commanded priority 1..16, or 0 if none is commanded
+ */
+static unsigned
+priority_array_bits_next(uint16_t active_bits, unsigned priority)
+{
+    if (priority == 0) {
+        priority = 1;
+    }
+    /* drop the higher priorities, then count up to the first bit */
+    active_bits >>= (priority - 1);
+    if (active_bits == 0) {
+        return 0;
+    }
+    while ((active_bits & 1) == 0) {
+        active_bits >>= 1;
+        priority++;
+    }
+
+    return priority;
+}
+
+/**
+ * @brief Relinquish every slot of a priority array
+ * @param state - the priority array state
+ */
+void priority_array_init(PRIORITY_ARRAY_STATE *state)
+{
+    if (state) {
+        state->active_bits = 0;
+        state->active_priority = 0;
+    }
+}
+
+/**
+ * @brief Mark a slot of a priority array as commanded
+ * @param state - the priority array state
+ * @param priority - the priority 1..16
+ * @return true if the priority is valid
+ */
+bool priority_array_command(PRIORITY_ARRAY_STATE *state, unsigned priority)
+{
+    if (!state || (priority < 1) || (priority > BACNET_MAX_PRIORITY)) {
+        return false;
+    }
+    state->active_bits |= (uint16_t)(1U << (priority - 1));
+    if ((state->active_priority == 0) || (priority < state->active_priority)) {
+        state->active_priority = (uint8_t)priority;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Mark a slot of a priority array as relinquished
+ * @param state - the priority array state
+ * @param priority - the priority 1..16
+ * @return true if the priority is valid
+ */
+bool priority_array_relinquish(PRIORITY_ARRAY_STATE *state, unsigned priority)
+{
+    if (!state || (priority < 1) || (priority > BACNET_MAX_PRIORITY)) {
+        return false;
+    }
+    state->active_bits &= (uint16_t)~(1U << (priority - 1));
+    if (priority == state->active_priority) {
+        state->active_priority =
+            (uint8_t)priority_array_bits_next(state->active_bits, priority);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Determine if a slot of a priority array is commanded
+ * @param state - the priority array state
+ * @param priority - the priority 1..16
+ * @return true if the slot is commanded, false if relinquished or invalid
+ */
+bool priority_array_active(const PRIORITY_ARRAY_STATE *state, unsigned priority)
+{
+    if (!state || (priority < 1) || (priority > BACNET_MAX_PRIORITY)) {
+        return false;
+    }
+
+    return (state->active_bits & (1U << (priority - 1))) != 0;
+}
+
+/**
+ * @brief Get the active priority of a priority array
+ * @param state - the priority array state
+ * @return the highest commanded priority 1..16, or 0 if all slots are
+ *  relinquished and the Relinquish_Default is the Present_Value
+ */
+unsigned priority_array_active_priority(const PRIORITY_ARRAY_STATE *state)
+{
+    if (!state) {
+        return 0;
+    }
+
+    return state->active_priority;
+}
+
+/**
+ * @brief Get the highest commanded priority at or below a priority, such
+ *  as the priority that takes over when a slot is relinquished
+ * @param state - the priority array state
+ * @param priority - the priority 1..16 to start from
+ * @return the commanded priority 1..16, or 0 if none is commanded
+ */
+unsigned priority_array_next_priority(
+    const PRIORITY_ARRAY_STATE *state, unsigned priority)
+{
+    if (!state || (priority > BACNET_MAX_PRIORITY)) {
+        return 0;
+    }
+    if (priority <= state->active_priority) {
+        /* nothing is commanded above the active priority */
+        return state->active_priority;
+    }
+
+    return priority_array_bits_next(state->active_bits, priority);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @brief API for the state of a BACnet priority array, which is shared by
+ *  the commandable objects to keep the active priority without scanning
+ *  the 16 slots on every read of the Present_Value
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_PRIORITY_ARRAY_H
+#define BACNET_SYS_PRIORITY_ARRAY_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* The values of the slots are kept by each object in its own datatype */
+typedef struct priority_array_state {
+    /* bit N is set when priority N+1 is commanded */
+    uint16_t active_bits;
+    /* the highest commanded priority 1..16, or 0 when all relinquished */
+    uint8_t active_priority;
+} PRIORITY_ARRAY_STATE;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void priority_array_init(PRIORITY_ARRAY_STATE *state);
+BACNET_STACK_EXPORT
+bool priority_array_command(PRIORITY_ARRAY_STATE *state, unsigned priority);
+BACNET_STACK_EXPORT
+bool priority_array_relinquish(PRIORITY_ARRAY_STATE *state, unsigned priority);
+BACNET_STACK_EXPORT
+bool priority_array_active(
+    const PRIORITY_ARRAY_STATE *state, unsigned priority);
+BACNET_STACK_EXPORT
+unsigned priority_array_active_priority(const PRIORITY_ARRAY_STATE *state);
+BACNET_STACK_EXPORT
+unsigned priority_array_next_priority(
+    const PRIORITY_ARRAY_STATE *state, unsigned priority);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -3,7 +3,7 @@
  * @brief  Generic ring buffer library for deeply embedded system.
  * @details Generic ring buffer library that uses a data store whose size
  * is a power of 2 (8, 16, 32, 64, ...) and doesn't waste any data bytes.
- * It has very low overhead, and utilizes modulo for indexing the data
+ * It has very low overhead, and utilizes a mask for indexing the data
  * in the data store. The ring buffer uses separate variables for
  * consumer and producer so it can be used in multithreaded environment.
  * @author Steve Karg <skarg@users.sourceforge.net>
@@ -13,8 +13,20 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/basic/sys/ringbuf.h"
 
+/* The producer only moves the head and the consumer only moves the tail.
+   The fences order the element data with the index that hands it over,
+   so one producer thread and one consumer thread need no lock.  The
+   fences are BACNET_STACK_ACQUIRE() and BACNET_STACK_RELEASE() from
+   platform.h. */
+
+/* data element of a free running head or tail; the element count is a
+   power of two, so the index is masked */
+#define RINGBUF_ELEMENT(b, n) \
+    ((b)->buffer + (((n) & ((b)->element_count - 1)) * (b)->element_size))
+
 /**
  * Returns the number of elements in the ring buffer
  *
@@ -28,6 +40,8 @@ unsigned Ringbuf_Count(RING_BUFFER const *b)
     if (b) {
         head = b->head;
         tail = b->tail;
+        /* the elements are not read or written before the indexes */
+        BACNET_STACK_ACQUIRE();
         return head - tail;
     }
 
@@ -136,8 +150,7 @@ volatile void *Ringbuf_Peek(RING_BUFFER const *b)
     volatile uint8_t *data_element = NULL; /* return value */
 
     if (!Ringbuf_Empty(b)) {
-        data_element = b->buffer;
-        data_element += ((b->tail % b->element_count) * b->element_size);
+        data_element = RINGBUF_ELEMENT(b, b->tail);
     }
 
     return data_element;
@@ -154,18 +167,18 @@ volatile void *
 Ringbuf_Peek_Next(RING_BUFFER const *b, const uint8_t *data_element)
 {
     unsigned index; /* list index */
+    unsigned count;
     volatile uint8_t *this_element;
     volatile uint8_t *next_element = NULL; /* return value */
-    if (!Ringbuf_Empty(b) && data_element != NULL) {
-        /* Use (b->head-1) here to avoid walking off end of ring */
-        for (index = b->tail; index < b->head - 1; index++) {
+    count = Ringbuf_Count(b);
+    if ((count > 0) && data_element != NULL) {
+        /* Use (count-1) here to avoid walking off end of ring */
+        for (index = b->tail; index < b->tail + count - 1; index++) {
             /* Find the specified data_element */
-            this_element =
-                b->buffer + ((index % b->element_count) * b->element_size);
+            this_element = RINGBUF_ELEMENT(b, index);
             if (data_element == this_element) {
                 /* Found the current element, get the next one on the list */
-                next_element = b->buffer +
-                    (((index + 1) % b->element_count) * b->element_size);
+                next_element = RINGBUF_ELEMENT(b, index + 1);
                 break;
             }
         }
@@ -185,16 +198,13 @@ bool Ringbuf_Pop(RING_BUFFER *b, uint8_t *data_element)
 {
     bool status = false; /* return value */
     volatile uint8_t *ring_data = NULL; /* used to help point ring data */
-    unsigned i; /* loop counter */
 
     if (!Ringbuf_Empty(b)) {
-        ring_data = b->buffer;
-        ring_data += ((b->tail % b->element_count) * b->element_size);
+        ring_data = RINGBUF_ELEMENT(b, b->tail);
         if (data_element) {
-            for (i = 0; i < b->element_size; i++) {
-                data_element[i] = ring_data[i];
-            }
+            memcpy(data_element, (const uint8_t *)ring_data, b->element_size);
         }
+        BACNET_STACK_RELEASE();
         b->tail++;
         status = true;
     }
@@ -218,37 +228,37 @@ bool Ringbuf_Pop_Element(
     volatile uint8_t *ring_data = NULL; /* used to help point ring data */
     volatile uint8_t *prev_data;
     unsigned index; /* list index */
-    unsigned this_index = b->head; /* index of element to remove */
-    unsigned i; /* loop counter */
-    if (!Ringbuf_Empty(b) && this_element != NULL) {
-        for (index = b->tail; index < b->head; index++) {
+    unsigned head; /* index after the last element */
+    unsigned this_index; /* index of element to remove */
+    head = b->tail + Ringbuf_Count(b);
+    this_index = head;
+    if ((head != b->tail) && this_element != NULL) {
+        for (index = b->tail; index < head; index++) {
             /* Find the specified data_element */
-            ring_data =
-                b->buffer + ((index % b->element_count) * b->element_size);
+            ring_data = RINGBUF_ELEMENT(b, index);
             if (this_element == ring_data) {
                 /* Found the specified element, copy the data if required */
                 this_index = index;
                 if (data_element) {
-                    for (i = 0; i < b->element_size; i++) {
-                        data_element[i] = ring_data[i];
-                    }
+                    memcpy(
+                        data_element, (const uint8_t *)ring_data,
+                        b->element_size);
                 }
                 break;
             }
         }
-        if (this_index < b->head) {
+        if (this_index < head) {
             /* Found a match, move elements up the list to fill the gap */
             for (index = this_index; index > b->tail; index--) {
                 /* Get pointers to current and previous data_elements */
-                ring_data =
-                    b->buffer + ((index % b->element_count) * b->element_size);
-                prev_data = b->buffer +
-                    (((index - 1) % b->element_count) * b->element_size);
-                for (i = 0; i < b->element_size; i++) {
-                    ring_data[i] = prev_data[i];
-                }
+                ring_data = RINGBUF_ELEMENT(b, index);
+                prev_data = RINGBUF_ELEMENT(b, index - 1);
+                memcpy(
+                    (uint8_t *)ring_data, (const uint8_t *)prev_data,
+                    b->element_size);
             }
         }
+        BACNET_STACK_RELEASE();
         b->tail++;
         status = true;
     }
@@ -267,16 +277,13 @@ bool Ringbuf_Put(RING_BUFFER *b, const uint8_t *data_element)
 {
     bool status = false; /* return value */
     volatile uint8_t *ring_data = NULL; /* used to help point ring data */
-    unsigned i; /* loop counter */
 
     if (b && data_element) {
         /* limit the amount of elements that we accept */
         if (!Ringbuf_Full(b)) {
-            ring_data = b->buffer;
-            ring_data += ((b->head % b->element_count) * b->element_size);
-            for (i = 0; i < b->element_size; i++) {
-                ring_data[i] = data_element[i];
-            }
+            ring_data = RINGBUF_ELEMENT(b, b->head);
+            memcpy((uint8_t *)ring_data, data_element, b->element_size);
+            BACNET_STACK_RELEASE();
             b->head++;
             Ringbuf_Depth_Update(b);
             status = true;
@@ -301,18 +308,14 @@ bool Ringbuf_Put_Front(RING_BUFFER *b, const uint8_t *data_element)
 {
     bool status = false; /* return value */
     volatile uint8_t *ring_data = NULL; /* used to help point ring data */
-    unsigned i = 0; /* loop counter */
 
     if (b && data_element) {
         /* limit the amount of elements that we accept */
         if (!Ringbuf_Full(b)) {
             b->tail--;
-            ring_data = b->buffer;
-            ring_data += ((b->tail % b->element_count) * b->element_size);
+            ring_data = RINGBUF_ELEMENT(b, b->tail);
             /* copy the data to the ring data element */
-            for (i = 0; i < b->element_size; i++) {
-                ring_data[i] = data_element[i];
-            }
+            memcpy((uint8_t *)ring_data, data_element, b->element_size);
             Ringbuf_Depth_Update(b);
             status = true;
         }
@@ -335,8 +338,7 @@ volatile void *Ringbuf_Data_Peek(RING_BUFFER *b)
     if (b) {
         /* limit the amount of elements that we accept */
         if (!Ringbuf_Full(b)) {
-            ring_data = b->buffer;
-            ring_data += ((b->head % b->element_count) * b->element_size);
+            ring_data = RINGBUF_ELEMENT(b, b->head);
         }
     }
 
@@ -360,10 +362,10 @@ bool Ringbuf_Data_Put(RING_BUFFER *b, const volatile uint8_t *data_element)
     if (b) {
         /* limit the amount of elements that we accept */
         if (!Ringbuf_Full(b)) {
-            ring_data = b->buffer;
-            ring_data += ((b->head % b->element_count) * b->element_size);
+            ring_data = RINGBUF_ELEMENT(b, b->head);
             if (ring_data == data_element) {
                 /* same chunk of memory - okay to signal the head */
+                BACNET_STACK_RELEASE();
                 b->head++;
                 Ringbuf_Depth_Update(b);
                 status = true;
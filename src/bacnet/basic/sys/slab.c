@@ -0,0 +1,373 @@
+/**
+ * @file
+ * @brief Slab library of fixed size items
+ * @details Items of the same size are allocated together in blocks,
+ *  instead of one heap allocation per item, so that items created
+ *  together are packed together in memory.  Each item has a small
+ *  header that points to its block, so releasing an item does not
+ *  search for it.  Released items are kept on a free list and given
+ *  out again before another block is allocated, and a block is
+ *  returned to the heap when the last of its items is released, unless
+ *  the slab list retains its memory.  A slab list that reserves its
+ *  items up front and retains them never uses the heap again while
+ *  items are created and deleted within the reserved number.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/slab.h"
+
+/* alignment suitable for the data types stored in the items */
+union Slab_Align {
+    void *pointer;
+    double real;
+    uint64_t unsigned64;
+};
+#define SLAB_ROUND(size)                                      \
+    ((((size) + sizeof(union Slab_Align) - 1) /               \
+      sizeof(union Slab_Align)) *                             \
+     sizeof(union Slab_Align))
+#define SLAB_BLOCK_SIZE SLAB_ROUND(sizeof(struct Slab_Block))
+#define SLAB_HEADER_SIZE SLAB_ROUND(sizeof(struct Slab_Item))
+
+/**
+ * @brief Get the number of bytes from one item header to the next
+ * @param slab - pointer to the slab list
+ * @return number of bytes
+ */
+static size_t Slab_Stride(OS_Slab slab)
+{
+    return SLAB_HEADER_SIZE + SLAB_ROUND(slab->item_size);
+}
+
+/**
+ * @brief Get the header of an item in a block
+ * @param slab - pointer to the slab list
+ * @param block - pointer to the block
+ * @param index - zero based index of the item in the block
+ * @return pointer to the item header
+ */
+static struct Slab_Item *
+Slab_Block_Item(OS_Slab slab, struct Slab_Block *block, size_t index)
+{
+    uint8_t *octets = (uint8_t *)block + SLAB_BLOCK_SIZE;
+
+    return (struct Slab_Item *)(octets + (index * Slab_Stride(slab)));
+}
+
+/**
+ * @brief Allocate a block of items and put them on the free list
+ * @param slab - pointer to the slab list
+ * @param count - number of items in the block
+ * @return true if the memory was available
+ */
+static bool Slab_Block_New(OS_Slab slab, size_t count)
+{
+    struct Slab_Block *block;
+    struct Slab_Item *item;
+    size_t stride;
+    size_t i;
+
+    if ((slab->item_size == 0) || (count == 0)) {
+        return false;
+    }
+    stride = Slab_Stride(slab);
+    if (count > ((SIZE_MAX - SLAB_BLOCK_SIZE) / stride)) {
+        return false;
+    }
+    block = calloc(1, SLAB_BLOCK_SIZE + (count * stride));
+    if (!block) {
+        return false;
+    }
+    MEMSTAT_ALLOC(slab->account, SLAB_BLOCK_SIZE + (count * stride));
+    block->slab = slab;
+    block->count = count;
+    block->used = 0;
+    block->next = slab->head;
+    slab->head = block;
+    /* in reverse, so the items are given out in address order */
+    i = count;
+    while (i > 0) {
+        i--;
+        item = Slab_Block_Item(slab, block, i);
+        item->block = block;
+        item->next = slab->free_list;
+        slab->free_list = item;
+    }
+    slab->free_count += count;
+
+    return true;
+}
+
+/**
+ * @brief Release an unused block and remove its items from the free list
+ * @param slab - pointer to the slab list
+ * @param block - pointer to the block
+ */
+static void Slab_Block_Release(OS_Slab slab, struct Slab_Block *block)
+{
+    struct Slab_Item **pItem;
+    struct Slab_Block **pBlock;
+
+    pItem = &slab->free_list;
+    while (*pItem) {
+        if ((*pItem)->block == block) {
+            *pItem = (*pItem)->next;
+            slab->free_count--;
+        } else {
+            pItem = &(*pItem)->next;
+        }
+    }
+    pBlock = &slab->head;
+    while (*pBlock) {
+        if (*pBlock == block) {
+            *pBlock = block->next;
+            break;
+        }
+        pBlock = &(*pBlock)->next;
+    }
+    MEMSTAT_FREE(
+        slab->account, SLAB_BLOCK_SIZE + (block->count * Slab_Stride(slab)));
+    free(block);
+}
+
+/**
+ * @brief Initialize an empty slab list for items of a fixed size
+ * @param slab - pointer to the slab list
+ * @param item_size - size of each item in bytes
+ */
+void Slab_Init(OS_Slab slab, size_t item_size)
+{
+    if (slab) {
+        slab->item_size = item_size;
+        slab->head = NULL;
+        slab->free_list = NULL;
+        slab->free_count = 0;
+        slab->grow = 0;
+        slab->retain = false;
+        slab->account = MEMSTAT_OTHER;
+    }
+}
+
+/**
+ * @brief Set the memory account that the blocks of a slab list are
+ *  counted in, when the memory accounting is enabled
+ * @param slab - pointer to the slab list
+ * @param account - a MEMSTAT_SUBSYSTEM or a MEMSTAT_ACCOUNT_OBJECT()
+ */
+void Slab_Account_Set(OS_Slab slab, MEMSTAT_ACCOUNT account)
+{
+    if (slab) {
+        slab->account = account;
+    }
+}
+
+/**
+ * @brief Set the number of items in each new block, when an item is
+ *  needed and none are free.  More items per block packs items that
+ *  are created one at a time closer together.
+ * @param slab - pointer to the slab list
+ * @param count - number of items in a new block; zero means one
+ */
+void Slab_Grow_Set(OS_Slab slab, size_t count)
+{
+    if (slab) {
+        slab->grow = count;
+    }
+}
+
+/**
+ * @brief Set whether the slab list keeps the memory of its empty blocks
+ *  for the items created later, instead of returning it to the heap.
+ * @param slab - pointer to the slab list
+ * @param retain - true to keep empty blocks
+ */
+void Slab_Retain_Set(OS_Slab slab, bool retain)
+{
+    struct Slab_Block *block;
+    struct Slab_Block *next;
+
+    if (!slab) {
+        return;
+    }
+    slab->retain = retain;
+    if (!retain) {
+        block = slab->head;
+        while (block) {
+            next = block->next;
+            if (block->used == 0) {
+                Slab_Block_Release(slab, block);
+            }
+            block = next;
+        }
+    }
+}
+
+/**
+ * @brief Make sure a number of items can be given out without another
+ *  allocation, allocating one block for any that are missing.
+ * @param slab - pointer to the slab list
+ * @param count - number of items
+ * @return true if the items are available
+ */
+bool Slab_Reserve(OS_Slab slab, size_t count)
+{
+    if (!slab) {
+        return false;
+    }
+    if (count <= slab->free_count) {
+        return true;
+    }
+
+    return Slab_Block_New(slab, count - slab->free_count);
+}
+
+/**
+ * @brief Give out one zeroed item, from the free list or a new block
+ * @param slab - pointer to the slab list
+ * @return pointer to the item, or NULL if no memory
+ */
+void *Slab_Item_Alloc(OS_Slab slab)
+{
+    struct Slab_Item *item;
+    uint8_t *data;
+
+    if (!slab) {
+        return NULL;
+    }
+    if (!slab->free_list) {
+        if (!Slab_Block_New(slab, slab->grow ? slab->grow : 1)) {
+            return NULL;
+        }
+    }
+    item = slab->free_list;
+    slab->free_list = item->next;
+    slab->free_count--;
+    item->next = NULL;
+    item->block->used++;
+    data = (uint8_t *)item + SLAB_HEADER_SIZE;
+    memset(data, 0, slab->item_size);
+
+    return data;
+}
+
+/**
+ * @brief Release an item, and its block when no items remain in use
+ *  and the slab list does not retain its memory
+ * @param slab - pointer to the slab list
+ * @param item - pointer to an item from Slab_Item_Alloc() of this list
+ * @return true if the item was released
+ */
+bool Slab_Free(OS_Slab slab, void *item)
+{
+    struct Slab_Item *header;
+    struct Slab_Block *block;
+
+    if (!slab || !item) {
+        return false;
+    }
+    header = (struct Slab_Item *)((uint8_t *)item - SLAB_HEADER_SIZE);
+    block = header->block;
+    if (!block || (block->slab != slab) || (block->used == 0)) {
+        return false;
+    }
+    block->used--;
+    header->next = slab->free_list;
+    slab->free_list = header;
+    slab->free_count++;
+    if ((block->used == 0) && !slab->retain) {
+        Slab_Block_Release(slab, block);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Determine if an item is in one of the blocks of this slab list
+ * @param slab - pointer to the slab list
+ * @param item - pointer to the item
+ * @return true if the item is in one of the blocks
+ */
+bool Slab_Member(OS_Slab slab, const void *item)
+{
+    struct Slab_Block *block;
+    const uint8_t *octets = item;
+    const uint8_t *first;
+
+    if (!slab || !item) {
+        return false;
+    }
+    block = slab->head;
+    while (block) {
+        first = (const uint8_t *)Slab_Block_Item(slab, block, 0);
+        if ((octets >= first) &&
+            (octets < (first + (block->count * Slab_Stride(slab))))) {
+            return true;
+        }
+        block = block->next;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Count the items given out from this slab list
+ * @param slab - pointer to the slab list
+ * @return number of items not yet released
+ */
+size_t Slab_Count(OS_Slab slab)
+{
+    struct Slab_Block *block;
+    size_t count = 0;
+
+    if (slab) {
+        block = slab->head;
+        while (block) {
+            count += block->used;
+            block = block->next;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Count the items that can be given out without an allocation
+ * @param slab - pointer to the slab list
+ * @return number of items on the free list
+ */
+size_t Slab_Free_Count(OS_Slab slab)
+{
+    size_t count = 0;
+
+    if (slab) {
+        count = slab->free_count;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Release all the blocks, whether or not items are in use
+ * @param slab - pointer to the slab list
+ */
+void Slab_Cleanup(OS_Slab slab)
+{
+    struct Slab_Block *block;
+
+    if (slab) {
+        while (slab->head) {
+            block = slab->head;
+            slab->head = block->next;
+            MEMSTAT_FREE(
+                slab->account,
+                SLAB_BLOCK_SIZE + (block->count * Slab_Stride(slab)));
+            free(block);
+        }
+        slab->free_list = NULL;
+        slab->free_count = 0;
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @brief API for a Slab library of fixed size items
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_SLAB_H
+#define BACNET_SYS_SLAB_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/memstat.h"
+
+/* A slab list is a pool of fixed size items, allocated from the heap
+   in blocks of one or more items.  Released items are kept on a free
+   list and given out again before another block is allocated, and a
+   block is returned to the heap when the last of its items is released
+   unless the slab list is set to retain its memory.
+
+   The basic objects keep the data of each object type in a slab list.
+   Their Pool_Reserve() functions reserve items and retain the memory,
+   so objects created and deleted later, for example by the CreateObject
+   and DeleteObject services, use no more heap memory while within the
+   reserved number.  Their Create_Range() functions allocate the data of
+   a whole range of objects in one block, which is faster than creating
+   each object for devices with many objects. */
+struct Slab_Block {
+    struct Slab_Block *next;
+    struct Slab *slab; /* slab list that owns this block */
+    size_t count; /* number of items in the block */
+    size_t used; /* number of items given out */
+};
+
+/* header stored before each item */
+struct Slab_Item {
+    struct Slab_Block *block; /* block that holds this item */
+    struct Slab_Item *next; /* next free item */
+};
+
+typedef struct Slab {
+    size_t item_size; /* size of each item in bytes */
+    struct Slab_Block *head; /* list of blocks */
+    struct Slab_Item *free_list; /* items ready to be given out */
+    size_t free_count; /* number of items on the free list */
+    size_t grow; /* number of items in a new block; zero means one */
+    bool retain; /* keep empty blocks on the free list */
+    MEMSTAT_ACCOUNT account; /* memory account of the blocks */
+} SLAB_TYPE;
+typedef SLAB_TYPE *OS_Slab;
+
+/* static initializer for a slab list of items of a fixed size */
+#define SLAB_INITIALIZER(size) { (size), NULL, NULL, 0, 0, false, 0 }
+/* static initializer for a slab list with a memory account */
+#define SLAB_ACCOUNT_INITIALIZER(size, account) \
+    { (size), NULL, NULL, 0, 0, false, (account) }
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Slab_Init(OS_Slab slab, size_t item_size);
+
+BACNET_STACK_EXPORT
+void Slab_Grow_Set(OS_Slab slab, size_t count);
+
+BACNET_STACK_EXPORT
+void Slab_Retain_Set(OS_Slab slab, bool retain);
+
+BACNET_STACK_EXPORT
+void Slab_Account_Set(OS_Slab slab, MEMSTAT_ACCOUNT account);
+
+BACNET_STACK_EXPORT
+bool Slab_Reserve(OS_Slab slab, size_t count);
+
+BACNET_STACK_EXPORT
+void *Slab_Item_Alloc(OS_Slab slab);
+
+BACNET_STACK_EXPORT
+bool Slab_Free(OS_Slab slab, void *item);
+
+BACNET_STACK_EXPORT
+bool Slab_Member(OS_Slab slab, const void *item);
+
+BACNET_STACK_EXPORT
+size_t Slab_Count(OS_Slab slab);
+
+BACNET_STACK_EXPORT
+size_t Slab_Free_Count(OS_Slab slab);
+
+BACNET_STACK_EXPORT
+void Slab_Cleanup(OS_Slab slab);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,246 @@
+/**
+ * @file
+ * @brief Pool of shared, reference counted C strings
+ * @details Each distinct string is stored once, in one allocation with
+ *  its hash and reference count in front of the text.  A hash index
+ *  maps the hash of the text to the slot of each entry, so interning a
+ *  string that is already in the pool costs a hash and a compare, and
+ *  objects that share a name, description, or state text share one
+ *  copy of it in memory.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/keyhash.h"
+#include "bacnet/basic/sys/string_pool.h"
+
+struct String_Pool_Entry {
+    uint32_t hash; /* hash of the text */
+    unsigned references; /* number of String_Pool_Intern() not released */
+    char text[1]; /* the text and its nul terminator */
+};
+
+/* index of the hash of each text to the slot of its entry */
+static OS_Keyhash Pool_Index;
+/* entries by slot; an unused slot is NULL and is on the free stack */
+static struct String_Pool_Entry **Pool_Slots;
+static unsigned *Pool_Free_Slots;
+static unsigned Pool_Free_Count;
+static unsigned Pool_Slots_Size;
+/* octets of all of the entries */
+static size_t Pool_Size;
+
+/**
+ * @brief Find the entry of a text
+ * @param string - the text
+ * @param hash - hash of the text
+ * @param slot - [out] slot of the entry, or NULL
+ * @return the entry, or NULL if the text is not in the pool
+ */
+static struct String_Pool_Entry *
+String_Pool_Find(const char *string, uint32_t hash, KEY *slot)
+{
+    struct String_Pool_Entry *entry;
+    unsigned iterator = 0;
+    KEY key;
+
+    while (Keyhash_Find(Pool_Index, hash, &iterator, &key)) {
+        entry = Pool_Slots[key];
+        if (entry && (strcmp(entry->text, string) == 0)) {
+            if (slot) {
+                *slot = key;
+            }
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get an unused slot, growing the slots when they are all used
+ * @param slot - [out] the unused slot
+ * @return true if a slot is available
+ */
+static bool String_Pool_Slot_Get(KEY *slot)
+{
+    struct String_Pool_Entry **slots;
+    unsigned *free_slots;
+    unsigned size, i;
+
+    if (Pool_Free_Count == 0) {
+        size = Pool_Slots_Size ? (Pool_Slots_Size * 2) : 16;
+        slots = realloc(Pool_Slots, size * sizeof(*slots));
+        if (!slots) {
+            return false;
+        }
+        Pool_Slots = slots;
+        free_slots = realloc(Pool_Free_Slots, size * sizeof(*free_slots));
+        if (!free_slots) {
+            return false;
+        }
+        Pool_Free_Slots = free_slots;
+        /* push the new slots so that the lowest is used first */
+        for (i = size; i > Pool_Slots_Size; i--) {
+            Pool_Slots[i - 1] = NULL;
+            Pool_Free_Slots[Pool_Free_Count] = i - 1;
+            Pool_Free_Count++;
+        }
+        Pool_Slots_Size = size;
+    }
+    Pool_Free_Count--;
+    *slot = Pool_Free_Slots[Pool_Free_Count];
+
+    return true;
+}
+
+/**
+ * @brief Get the shared copy of a string, and add a reference to it
+ * @param string - the C string, which may be freed after the call
+ * @return the shared copy, which is valid until its last reference is
+ *  released, or NULL if string is NULL or no memory is available
+ */
+const char *String_Pool_Intern(const char *string)
+{
+    struct String_Pool_Entry *entry;
+    size_t length;
+    uint32_t hash;
+    KEY slot;
+
+    if (!string) {
+        return NULL;
+    }
+    length = strlen(string);
+    hash = Keyhash_FNV1a(string, length);
+    entry = String_Pool_Find(string, hash, NULL);
+    if (entry) {
+        entry->references++;
+        return entry->text;
+    }
+    if (!Pool_Index) {
+        Pool_Index = Keyhash_Create();
+        if (!Pool_Index) {
+            return NULL;
+        }
+    }
+    entry = malloc(offsetof(struct String_Pool_Entry, text) + length + 1);
+    if (!entry) {
+        return NULL;
+    }
+    if (!String_Pool_Slot_Get(&slot)) {
+        free(entry);
+        return NULL;
+    }
+    if (!Keyhash_Add(Pool_Index, hash, slot)) {
+        Pool_Free_Slots[Pool_Free_Count] = slot;
+        Pool_Free_Count++;
+        free(entry);
+        return NULL;
+    }
+    entry->hash = hash;
+    entry->references = 1;
+    memcpy(entry->text, string, length + 1);
+    Pool_Slots[slot] = entry;
+    Pool_Size += offsetof(struct String_Pool_Entry, text) + length + 1;
+
+    return entry->text;
+}
+
+/**
+ * @brief Release a reference to a shared copy, and free the copy with
+ *  its last reference
+ * @param string - shared copy from String_Pool_Intern(), or NULL
+ * @return true if the string is a shared copy from the pool
+ */
+bool String_Pool_Release(const char *string)
+{
+    struct String_Pool_Entry *entry;
+    size_t length;
+    KEY slot;
+
+    if (!string) {
+        return false;
+    }
+    length = strlen(string);
+    entry = String_Pool_Find(string, Keyhash_FNV1a(string, length), &slot);
+    if (!entry || (entry->text != string)) {
+        /* not a shared copy */
+        return false;
+    }
+    entry->references--;
+    if (entry->references == 0) {
+        (void)Keyhash_Remove(Pool_Index, entry->hash, slot);
+        Pool_Slots[slot] = NULL;
+        Pool_Free_Slots[Pool_Free_Count] = slot;
+        Pool_Free_Count++;
+        Pool_Size -= offsetof(struct String_Pool_Entry, text) + length + 1;
+        free(entry);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the number of references to the shared copy of a string
+ * @param string - the C string
+ * @return number of references, or zero if the string is not in the pool
+ */
+unsigned String_Pool_References(const char *string)
+{
+    struct String_Pool_Entry *entry;
+
+    if (!string) {
+        return 0;
+    }
+    entry = String_Pool_Find(
+        string, Keyhash_FNV1a(string, strlen(string)), NULL);
+    if (entry) {
+        return entry->references;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the number of distinct strings in the pool
+ * @return number of strings
+ */
+unsigned String_Pool_Count(void)
+{
+    return Keyhash_Count(Pool_Index);
+}
+
+/**
+ * @brief Get the number of octets used by the strings in the pool,
+ *  not counting the index
+ * @return number of octets
+ */
+size_t String_Pool_Size(void)
+{
+    return Pool_Size;
+}
+
+/**
+ * @brief Free every string in the pool, whatever its references.
+ *  The shared copies are no longer valid.
+ */
+void String_Pool_Cleanup(void)
+{
+    unsigned i;
+
+    for (i = 0; i < Pool_Slots_Size; i++) {
+        free(Pool_Slots[i]);
+    }
+    free(Pool_Slots);
+    free(Pool_Free_Slots);
+    Keyhash_Delete(Pool_Index);
+    Pool_Slots = NULL;
+    Pool_Free_Slots = NULL;
+    Pool_Free_Count = 0;
+    Pool_Slots_Size = 0;
+    Pool_Index = NULL;
+    Pool_Size = 0;
+}
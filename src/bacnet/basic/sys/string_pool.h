@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @brief API for a pool of shared, reference counted C strings
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_STRING_POOL_H
+#define BACNET_SYS_STRING_POOL_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* The string pool keeps one copy of each distinct C string, such as the
+   names, descriptions, and state texts that many objects share.  Each
+   String_Pool_Intern() of a string returns the same copy and adds a
+   reference, and each String_Pool_Release() removes one.  The copy is
+   freed with its last reference.  The pool is not thread safe. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+const char *String_Pool_Intern(const char *string);
+
+BACNET_STACK_EXPORT
+bool String_Pool_Release(const char *string);
+
+BACNET_STACK_EXPORT
+unsigned String_Pool_References(const char *string);
+
+BACNET_STACK_EXPORT
+unsigned String_Pool_Count(void);
+
+BACNET_STACK_EXPORT
+size_t String_Pool_Size(void);
+
+BACNET_STACK_EXPORT
+void String_Pool_Cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
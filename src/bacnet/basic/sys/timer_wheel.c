@@ -0,0 +1,319 @@
+/**
+ * @file
+ * @brief Hierarchical timer wheel of deadlines
+ * @details The first level has a slot for each of the next ticks, and
+ *  each higher level has a slot for each turn of the level below it.
+ *  A timer is put in the lowest level whose span holds its deadline.
+ *  When a level turns over, the timers of the next slot of the level
+ *  above are moved down, so a timer moves at most once per level.
+ *  Each slot is a doubly linked list, so adding and cancelling a timer
+ *  take constant time, and a tick only looks at the slots of that tick.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/basic/sys/timer_wheel.h"
+
+/**
+ * @brief Put a timer into the slot of its deadline
+ * @param wheel - timer wheel
+ * @param entry - timer with its deadline set
+ */
+static void
+Timer_Wheel_Link(TIMER_WHEEL *wheel, struct Timer_Wheel_Entry *entry)
+{
+    uint32_t delta = entry->expires - wheel->now;
+    unsigned level = 0;
+    unsigned slot;
+    struct Timer_Wheel_Entry **head;
+
+    while ((level < (TIMER_WHEEL_LEVELS - 1)) &&
+           (delta >= (1UL << (TIMER_WHEEL_SLOT_BITS * (level + 1))))) {
+        level++;
+    }
+    slot = (entry->expires >> (TIMER_WHEEL_SLOT_BITS * level)) &
+        TIMER_WHEEL_SLOT_MASK;
+    head = &wheel->slot[level][slot];
+    entry->prev = NULL;
+    entry->next = *head;
+    if (*head) {
+        (*head)->prev = entry;
+    }
+    *head = entry;
+}
+
+/**
+ * @brief Take a timer out of its slot
+ * @param wheel - timer wheel
+ * @param entry - timer in a slot
+ * @param head - the list head of its slot, when known, or NULL
+ */
+static void Timer_Wheel_Unlink(
+    TIMER_WHEEL *wheel,
+    struct Timer_Wheel_Entry *entry,
+    struct Timer_Wheel_Entry **head)
+{
+    unsigned level, slot;
+
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        if (!head) {
+            /* the first timer of a slot: find its slot */
+            for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+                slot = (entry->expires >> (TIMER_WHEEL_SLOT_BITS * level)) &
+                    TIMER_WHEEL_SLOT_MASK;
+                if (wheel->slot[level][slot] == entry) {
+                    head = &wheel->slot[level][slot];
+                    break;
+                }
+            }
+        }
+        if (head) {
+            *head = entry->next;
+        }
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    }
+    entry->next = NULL;
+    entry->prev = NULL;
+}
+
+/**
+ * @brief Initialize a timer wheel with no timers
+ * @param wheel - timer wheel
+ */
+void Timer_Wheel_Init(TIMER_WHEEL *wheel)
+{
+    unsigned level, slot;
+
+    if (!wheel) {
+        return;
+    }
+    wheel->now = 0;
+    wheel->count = 0;
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            wheel->slot[level][slot] = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Initialize a timer that is not pending
+ * @param entry - timer
+ * @param callback - function called when the timer expires
+ * @param context - context given to the callback
+ */
+void Timer_Wheel_Entry_Init(
+    struct Timer_Wheel_Entry *entry,
+    timer_wheel_callback callback,
+    void *context)
+{
+    if (entry) {
+        entry->next = NULL;
+        entry->prev = NULL;
+        entry->expires = 0;
+        entry->pending = false;
+        entry->callback = callback;
+        entry->context = context;
+    }
+}
+
+/**
+ * @brief Set a timer to expire after a number of ticks. A pending timer
+ *  is moved to its new deadline.
+ * @param wheel - timer wheel
+ * @param entry - timer
+ * @param ticks - number of ticks from now, from 1 to #TIMER_WHEEL_TICKS_MAX,
+ *  where 0 is the same as 1 and larger values are clamped
+ */
+void Timer_Wheel_Add(
+    TIMER_WHEEL *wheel, struct Timer_Wheel_Entry *entry, uint32_t ticks)
+{
+    if (!wheel || !entry) {
+        return;
+    }
+    (void)Timer_Wheel_Cancel(wheel, entry);
+    if (ticks == 0) {
+        ticks = 1;
+    } else if (ticks > TIMER_WHEEL_TICKS_MAX) {
+        ticks = TIMER_WHEEL_TICKS_MAX;
+    }
+    entry->expires = wheel->now + ticks;
+    entry->pending = true;
+    Timer_Wheel_Link(wheel, entry);
+    wheel->count++;
+}
+
+/**
+ * @brief Stop a timer
+ * @param wheel - timer wheel
+ * @param entry - timer
+ * @return true if the timer was pending
+ */
+bool Timer_Wheel_Cancel(TIMER_WHEEL *wheel, struct Timer_Wheel_Entry *entry)
+{
+    if (!wheel || !entry || !entry->pending) {
+        return false;
+    }
+    Timer_Wheel_Unlink(wheel, entry, NULL);
+    entry->pending = false;
+    if (wheel->count > 0) {
+        wheel->count--;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Determine if a timer is pending
+ * @param entry - timer
+ * @return true if the timer is pending
+ */
+bool Timer_Wheel_Pending(const struct Timer_Wheel_Entry *entry)
+{
+    return entry && entry->pending;
+}
+
+/**
+ * @brief Get the number of ticks until a timer expires
+ * @param wheel - timer wheel
+ * @param entry - timer
+ * @return number of ticks, or 0 if the timer is not pending
+ */
+uint32_t Timer_Wheel_Remaining(
+    const TIMER_WHEEL *wheel, const struct Timer_Wheel_Entry *entry)
+{
+    if (!wheel || !entry || !entry->pending) {
+        return 0;
+    }
+
+    return entry->expires - wheel->now;
+}
+
+/**
+ * @brief Move the timers of the current slot of a level down the wheel
+ * @param wheel - timer wheel
+ * @param level - level 1 or higher
+ */
+static void Timer_Wheel_Cascade(TIMER_WHEEL *wheel, unsigned level)
+{
+    struct Timer_Wheel_Entry *entry, *next;
+    unsigned slot;
+
+    slot = (wheel->now >> (TIMER_WHEEL_SLOT_BITS * level)) &
+        TIMER_WHEEL_SLOT_MASK;
+    entry = wheel->slot[level][slot];
+    wheel->slot[level][slot] = NULL;
+    while (entry) {
+        next = entry->next;
+        Timer_Wheel_Link(wheel, entry);
+        entry = next;
+    }
+}
+
+/**
+ * @brief Move time forward, and call the callbacks of the timers that
+ *  expire, in the order of their deadlines
+ * @param wheel - timer wheel
+ * @param ticks - number of ticks elapsed
+ */
+void Timer_Wheel_Advance(TIMER_WHEEL *wheel, uint32_t ticks)
+{
+    struct Timer_Wheel_Entry *entry, **head;
+    unsigned level;
+
+    if (!wheel) {
+        return;
+    }
+    while (ticks > 0) {
+        if (wheel->count == 0) {
+            /* nothing to expire */
+            wheel->now += ticks;
+            break;
+        }
+        ticks--;
+        wheel->now++;
+        for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if ((wheel->now &
+                 ((1UL << (TIMER_WHEEL_SLOT_BITS * level)) - 1UL)) != 0) {
+                break;
+            }
+            /* the level below turned over */
+            Timer_Wheel_Cascade(wheel, level);
+        }
+        head = &wheel->slot[0][wheel->now & TIMER_WHEEL_SLOT_MASK];
+        while (*head) {
+            entry = *head;
+            Timer_Wheel_Unlink(wheel, entry, head);
+            entry->pending = false;
+            wheel->count--;
+            if (entry->callback) {
+                entry->callback(entry, entry->context);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Get the number of ticks until the next timer expires, so that
+ *  a tickless main loop can sleep until then
+ * @param wheel - timer wheel
+ * @return number of ticks, or UINT32_MAX if no timers are pending
+ */
+uint32_t Timer_Wheel_Next(const TIMER_WHEEL *wheel)
+{
+    const struct Timer_Wheel_Entry *entry;
+    uint32_t next = UINT32_MAX;
+    uint32_t delta;
+    unsigned level, slot, i;
+
+    if (!wheel || (wheel->count == 0)) {
+        return UINT32_MAX;
+    }
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        slot = (wheel->now >> (TIMER_WHEEL_SLOT_BITS * level)) &
+            TIMER_WHEEL_SLOT_MASK;
+        /* the slots of a level are in the order of their deadlines,
+           starting after the current slot */
+        for (i = 1; i <= TIMER_WHEEL_SLOTS; i++) {
+            entry = wheel->slot[level][(slot + i) & TIMER_WHEEL_SLOT_MASK];
+            if (entry) {
+                while (entry) {
+                    delta = entry->expires - wheel->now;
+                    if (delta < next) {
+                        next = delta;
+                    }
+                    entry = entry->next;
+                }
+                break;
+            }
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief Get the number of pending timers
+ * @param wheel - timer wheel
+ * @return number of pending timers
+ */
+size_t Timer_Wheel_Count(const TIMER_WHEEL *wheel)
+{
+    return wheel ? wheel->count : 0;
+}
+
+/**
+ * @brief Get the current tick of the wheel
+ * @param wheel - timer wheel
+ * @return ticks since the wheel was initialized, wrapping around
+ */
+uint32_t Timer_Wheel_Now(const TIMER_WHEEL *wheel)
+{
+    return wheel ? wheel->now : 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief API for a hierarchical timer wheel of deadlines
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_TIMER_WHEEL_H
+#define BACNET_SYS_TIMER_WHEEL_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* A timer wheel keeps timers sorted into slots by their deadline, in
+   ticks of a unit chosen by the user, such as milliseconds or seconds.
+   Each level has a slot for each tick of the one below it, so adding,
+   cancelling and expiring a timer take constant time, and a tick only
+   looks at the slot of that tick.  Timers are embedded in the data of
+   the user, and the wheel never allocates memory. */
+#ifndef TIMER_WHEEL_SLOT_BITS
+#define TIMER_WHEEL_SLOT_BITS 6
+#endif
+#define TIMER_WHEEL_SLOTS (1UL << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1UL)
+#ifndef TIMER_WHEEL_LEVELS
+#define TIMER_WHEEL_LEVELS 4
+#endif
+/* longest time that a timer can be set to, in ticks */
+#define TIMER_WHEEL_TICKS_MAX \
+    ((1UL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1UL)
+
+struct Timer_Wheel;
+struct Timer_Wheel_Entry;
+
+/**
+ * @brief Called when a timer expires. The timer is no longer pending,
+ *  and may be added again from this callback.
+ * @param entry - the timer that expired
+ * @param context - the context of the timer
+ */
+typedef void (*timer_wheel_callback)(
+    struct Timer_Wheel_Entry *entry, void *context);
+
+struct Timer_Wheel_Entry {
+    struct Timer_Wheel_Entry *next;
+    struct Timer_Wheel_Entry *prev;
+    uint32_t expires; /* tick of the deadline */
+    bool pending; /* true while in a slot of the wheel */
+    timer_wheel_callback callback;
+    void *context;
+};
+
+typedef struct Timer_Wheel {
+    uint32_t now; /* ticks since the wheel was initialized */
+    size_t count; /* number of pending timers */
+    struct Timer_Wheel_Entry *slot[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} TIMER_WHEEL;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Timer_Wheel_Init(TIMER_WHEEL *wheel);
+
+BACNET_STACK_EXPORT
+void Timer_Wheel_Entry_Init(
+    struct Timer_Wheel_Entry *entry,
+    timer_wheel_callback callback,
+    void *context);
+
+BACNET_STACK_EXPORT
+void Timer_Wheel_Add(
+    TIMER_WHEEL *wheel, struct Timer_Wheel_Entry *entry, uint32_t ticks);
+
+BACNET_STACK_EXPORT
+bool Timer_Wheel_Cancel(TIMER_WHEEL *wheel, struct Timer_Wheel_Entry *entry);
+
+BACNET_STACK_EXPORT
+bool Timer_Wheel_Pending(const struct Timer_Wheel_Entry *entry);
+
+BACNET_STACK_EXPORT
+uint32_t Timer_Wheel_Remaining(
+    const TIMER_WHEEL *wheel, const struct Timer_Wheel_Entry *entry);
+
+BACNET_STACK_EXPORT
+void Timer_Wheel_Advance(TIMER_WHEEL *wheel, uint32_t ticks);
+
+BACNET_STACK_EXPORT
+uint32_t Timer_Wheel_Next(const TIMER_WHEEL *wheel);
+
+BACNET_STACK_EXPORT
+size_t Timer_Wheel_Count(const TIMER_WHEEL *wheel);
+
+BACNET_STACK_EXPORT
+uint32_t Timer_Wheel_Now(const TIMER_WHEEL *wheel);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
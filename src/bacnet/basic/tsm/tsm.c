@@ -9,14 +9,22 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/abort.h"
 #include "bacnet/apdu.h"
 #include "bacnet/bacaddr.h"
 #include "bacnet/bacdcode.h"
+#if BACNET_SEGMENTATION_ENABLED
+#include "bacnet/segmentack.h"
+#endif
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/memstat.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/binding/address.h"
@@ -31,110 +39,480 @@ uint8_t Handler_Transmit_Buffer[MAX_PDU];
 /* If we are only a server and only initiate broadcasts, */
 /* then we don't need a TSM layer. */
 
-/* FIXME: not coded for segmentation */
-
 /* declare space for the TSM transactions, and set it up in the init. */
 /* table rules: an Invoke ID = 0 is an unused spot in the table */
 static BACNET_TSM_DATA TSM_List[MAX_TSM_TRANSACTIONS];
+/* first transaction plus one using each invoke ID, or zero */
+static uint16_t TSM_Invoke_ID_Head[256];
+/* free list of the transactions that were used before, by index plus one */
+static uint16_t TSM_Free_Head;
+/* the transactions from this index to the end have never been used */
+static unsigned TSM_Unused_Index;
+/* number of transactions with an invoke ID */
+static unsigned TSM_Used_Count;
+/* transactions awaiting confirmation, in a min-heap by request timeout */
+static uint16_t TSM_Timeout_Heap[MAX_TSM_TRANSACTIONS];
+static unsigned TSM_Timeout_Count;
+/* milliseconds counted by tsm_timer_milliseconds() */
+static uint32_t TSM_Milliseconds;
+
+/* The peers with a transaction that uses a per-peer invoke ID,
+   or with their own window size. */
+typedef struct BACnet_TSM_Peer {
+    BACNET_ADDRESS address;
+    /* number of transactions with this peer */
+    uint16_t transactions;
+    /* maximum number of transactions with this peer, or zero for
+       the default of MAX_TSM_PEER_WINDOW */
+    uint8_t window;
+    /* invoke ID for incrementing between subsequent calls */
+    uint8_t invoke_id;
+    /* next peer plus one, in the same hash bucket or the free list */
+    uint16_t next;
+} BACNET_TSM_PEER;
+static BACNET_TSM_PEER TSM_Peer_List[MAX_TSM_PEERS];
+/* first peer plus one in each hash bucket, or zero */
+static uint16_t TSM_Peer_Head[MAX_TSM_PEERS];
+/* free list of the peers that were used before, by index plus one */
+static uint16_t TSM_Peer_Free_Head;
+/* the peers from this index to the end have never been used */
+static unsigned TSM_Peer_Unused_Index;
 
 /* invoke ID for incrementing between subsequent calls. */
 static uint8_t Current_Invoke_ID = 1;
 
 static tsm_timeout_function Timeout_Function;
+static tsm_timeout_peer_function Timeout_Peer_Function;
 
+/**
+ * @brief Set the handler called with the invoke ID when a transaction
+ *  fails to be confirmed.  An invoke ID from tsm_next_free_invokeID_peer()
+ *  may also be used with another peer; see tsm_set_timeout_peer_handler()
+ * @param pFunction - handler function, or NULL
+ */
 void tsm_set_timeout_handler(tsm_timeout_function pFunction)
 {
     Timeout_Function = pFunction;
 }
 
-/** Find the given Invoke-Id in the list and
- *  return the index.
- *
- * @param invokeID  Invoke Id
- *
- * @return Index of the id or MAX_TSM_TRANSACTIONS
- *         if not found
+/**
+ * @brief Set the handler called with the peer address and invoke ID
+ *  when a transaction fails to be confirmed
+ * @param pFunction - handler function, or NULL
+ */
+void tsm_set_timeout_peer_handler(tsm_timeout_peer_function pFunction)
+{
+    Timeout_Peer_Function = pFunction;
+}
+
+/**
+ * @brief Increment an invoke ID, skipping zero which we treat
+ *  internally as invalid or no free
+ * @param invokeID - invoke ID
+ * @return the next invoke ID
  */
-static uint8_t tsm_find_invokeID_index(uint8_t invokeID)
+static uint8_t tsm_invoke_id_next(uint8_t invokeID)
 {
-    unsigned i = 0; /* counter */
-    uint8_t index = MAX_TSM_TRANSACTIONS; /* return value */
+    invokeID++;
+    if (invokeID == 0) {
+        invokeID = 1;
+    }
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+    return invokeID;
+}
 
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->InvokeID == invokeID) {
-            index = (uint8_t)i;
-            break;
+/**
+ * @brief Compute the hash bucket of a peer address
+ * @param address - peer address
+ * @return hash bucket 0..MAX_TSM_PEERS-1
+ */
+static unsigned tsm_peer_bucket(const BACNET_ADDRESS *address)
+{
+    return (unsigned)(bacnet_address_hash(address) % MAX_TSM_PEERS);
+}
+
+/**
+ * @brief Find a peer by its address
+ * @param address - peer address
+ * @return index of the peer, or MAX_TSM_PEERS if not found
+ */
+static unsigned tsm_peer_find(const BACNET_ADDRESS *address)
+{
+    unsigned index;
+    uint16_t next;
+
+    next = TSM_Peer_Head[tsm_peer_bucket(address)];
+    while (next) {
+        index = next - 1;
+        if (bacnet_address_same(&TSM_Peer_List[index].address, address)) {
+            return index;
         }
+        next = TSM_Peer_List[index].next;
     }
 
+    return MAX_TSM_PEERS;
+}
+
+/**
+ * @brief Find a peer by its address, or add it if there is room
+ * @param address - peer address
+ * @return index of the peer, or MAX_TSM_PEERS if the list is full
+ */
+static unsigned tsm_peer_add(const BACNET_ADDRESS *address)
+{
+    unsigned index;
+    unsigned bucket;
+    BACNET_TSM_PEER *peer;
+
+    index = tsm_peer_find(address);
+    if (index < MAX_TSM_PEERS) {
+        return index;
+    }
+    if (TSM_Peer_Free_Head) {
+        index = TSM_Peer_Free_Head - 1;
+        TSM_Peer_Free_Head = TSM_Peer_List[index].next;
+    } else if (TSM_Peer_Unused_Index < MAX_TSM_PEERS) {
+        index = TSM_Peer_Unused_Index++;
+    } else {
+        return MAX_TSM_PEERS;
+    }
+    peer = &TSM_Peer_List[index];
+    bacnet_address_copy(&peer->address, address);
+    peer->transactions = 0;
+    peer->window = 0;
+    /* start each peer somewhere else, so that fewer peers
+       share an invoke ID */
+    peer->invoke_id = Current_Invoke_ID;
+    Current_Invoke_ID = tsm_invoke_id_next(Current_Invoke_ID);
+    bucket = tsm_peer_bucket(address);
+    peer->next = TSM_Peer_Head[bucket];
+    TSM_Peer_Head[bucket] = (uint16_t)(index + 1);
+
     return index;
 }
 
+/**
+ * @brief Remove a peer that has no transactions and the default window
+ * @param index - index of the peer
+ */
+static void tsm_peer_remove_unused(unsigned index)
+{
+    BACNET_TSM_PEER *peer = &TSM_Peer_List[index];
+    uint16_t *link;
+
+    if (peer->transactions || peer->window) {
+        return;
+    }
+    link = &TSM_Peer_Head[tsm_peer_bucket(&peer->address)];
+    while (*link) {
+        if (*link == (index + 1)) {
+            *link = peer->next;
+            break;
+        }
+        link = &TSM_Peer_List[*link - 1].next;
+    }
+    peer->next = TSM_Peer_Free_Head;
+    TSM_Peer_Free_Head = (uint16_t)(index + 1);
+}
+
+/**
+ * @brief Get the number of transactions allowed with a peer
+ * @param peer - peer
+ * @return window size
+ */
+static unsigned tsm_peer_window_size(const BACNET_TSM_PEER *peer)
+{
+    if (peer->window) {
+        return peer->window;
+    }
+
+    return MAX_TSM_PEER_WINDOW;
+}
+
 /** Find the first free index in the TSM table.
  *
  * @return Index of the id or MAX_TSM_TRANSACTIONS
  *         if no entry is free.
  */
-static uint8_t tsm_find_first_free_index(void)
+static unsigned tsm_find_first_free_index(void)
 {
-    unsigned i = 0; /* counter */
-    uint8_t index = MAX_TSM_TRANSACTIONS; /* return value */
+    unsigned index = MAX_TSM_TRANSACTIONS; /* return value */
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+    if (TSM_Free_Head) {
+        index = TSM_Free_Head - 1;
+    } else if (TSM_Unused_Index < MAX_TSM_TRANSACTIONS) {
+        index = TSM_Unused_Index;
+    }
 
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->InvokeID == 0) {
-            index = (uint8_t)i;
-            break;
+    return index;
+}
+
+/** Find the given Invoke-Id in the list and
+ *  return the index.
+ *
+ * @param peer  Address of the peer, or NULL to find the transaction
+ *              with an invoke ID that is unique among all the peers,
+ *              or else the first transaction with the invoke ID
+ * @param invokeID  Invoke Id, or zero to find a free entry
+ *
+ * @return Index of the id or MAX_TSM_TRANSACTIONS
+ *         if not found
+ */
+static unsigned
+tsm_find_invokeID_index(const BACNET_ADDRESS *peer, uint8_t invokeID)
+{
+    BACNET_TSM_DATA *plist;
+    uint16_t next;
+    unsigned index = MAX_TSM_TRANSACTIONS;
+
+    if (invokeID == 0) {
+        return tsm_find_first_free_index();
+    }
+    next = TSM_Invoke_ID_Head[invokeID];
+    while (next) {
+        plist = &TSM_List[next - 1];
+        /* an invoke ID from tsm_next_free_invokeID() is unique,
+           so it matches any peer, while an invoke ID from
+           tsm_next_free_invokeID_peer() only matches its peer */
+        if (plist->Peer == 0) {
+            return next - 1;
+        }
+        if (peer) {
+            if (bacnet_address_same(
+                    &TSM_Peer_List[plist->Peer - 1].address, peer)) {
+                return next - 1;
+            }
+        } else if (index == MAX_TSM_TRANSACTIONS) {
+            /* the functions without a peer address still find the
+               invoke IDs from tsm_next_free_invokeID_peer(), which
+               are only shared by peers when more than 255 are used */
+            index = next - 1;
         }
+        next = plist->InvokeNext;
     }
 
     return index;
 }
 
-/** Check if space for transactions is available.
- *
- * @return true/false
+/**
+ * @brief Determine if an invoke ID may be used with a peer
+ * @param peer_index - index of the peer, or MAX_TSM_PEERS for an
+ *  invoke ID that is unique among all the peers
+ * @param invokeID - invoke ID
+ * @return true if the invoke ID is not in use with the peer
  */
-bool tsm_transaction_available(void)
+static bool tsm_invoke_id_available(unsigned peer_index, uint8_t invokeID)
 {
-    bool status = false; /* return value */
-    unsigned i = 0; /* counter */
+    uint16_t next;
+
+    next = TSM_Invoke_ID_Head[invokeID];
+    if (peer_index >= MAX_TSM_PEERS) {
+        return next == 0;
+    }
+    while (next) {
+        if ((TSM_List[next - 1].Peer == 0) ||
+            (TSM_List[next - 1].Peer == (peer_index + 1))) {
+            return false;
+        }
+        next = TSM_List[next - 1].InvokeNext;
+    }
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+    return true;
+}
 
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->InvokeID == 0) {
-            /* one is available! */
-            status = true;
+/**
+ * @brief Determine if one transaction times out before another
+ * @param index - index of the transaction
+ * @param other_index - index of the other transaction
+ * @return true if the transaction times out first
+ */
+static bool tsm_timeout_before(unsigned index, unsigned other_index)
+{
+    return (int32_t)(TSM_List[index].RequestTimeout -
+                     TSM_List[other_index].RequestTimeout) < 0;
+}
+
+/**
+ * @brief Place a transaction at a position in the timeout heap
+ * @param position - position in the heap
+ * @param index - index of the transaction
+ */
+static void tsm_timeout_heap_set(unsigned position, unsigned index)
+{
+    TSM_Timeout_Heap[position] = (uint16_t)index;
+    TSM_List[index].TimeoutHeapIndex = (uint16_t)(position + 1);
+}
+
+/**
+ * @brief Move the transaction at a position in the timeout heap
+ *  toward the top until the heap is in order
+ * @param position - position in the heap
+ */
+static void tsm_timeout_heap_up(unsigned position)
+{
+    unsigned index = TSM_Timeout_Heap[position];
+    unsigned parent;
+
+    while (position > 0) {
+        parent = (position - 1) / 2;
+        if (!tsm_timeout_before(index, TSM_Timeout_Heap[parent])) {
             break;
         }
+        tsm_timeout_heap_set(position, TSM_Timeout_Heap[parent]);
+        position = parent;
     }
+    tsm_timeout_heap_set(position, index);
+}
 
-    return status;
+/**
+ * @brief Move the transaction at a position in the timeout heap
+ *  toward the bottom until the heap is in order
+ * @param position - position in the heap
+ */
+static void tsm_timeout_heap_down(unsigned position)
+{
+    unsigned index = TSM_Timeout_Heap[position];
+    unsigned child;
+
+    for (;;) {
+        child = (2 * position) + 1;
+        if (child >= TSM_Timeout_Count) {
+            break;
+        }
+        if (((child + 1) < TSM_Timeout_Count) &&
+            tsm_timeout_before(
+                TSM_Timeout_Heap[child + 1], TSM_Timeout_Heap[child])) {
+            child++;
+        }
+        if (!tsm_timeout_before(TSM_Timeout_Heap[child], index)) {
+            break;
+        }
+        tsm_timeout_heap_set(position, TSM_Timeout_Heap[child]);
+        position = child;
+    }
+    tsm_timeout_heap_set(position, index);
 }
 
-/** Return the count of idle transaction.
- *
- * @return Count of idle transaction.
+/**
+ * @brief Remove a transaction from the timeout heap, if it is there
+ * @param index - index of the transaction
  */
-uint8_t tsm_transaction_idle_count(void)
+static void tsm_timeout_remove(unsigned index)
 {
-    uint8_t count = 0; /* return value */
-    unsigned i = 0; /* counter */
+    unsigned position;
+    unsigned last;
+
+    if (TSM_List[index].TimeoutHeapIndex == 0) {
+        return;
+    }
+    position = TSM_List[index].TimeoutHeapIndex - 1;
+    TSM_List[index].TimeoutHeapIndex = 0;
+    TSM_Timeout_Count--;
+    if (position < TSM_Timeout_Count) {
+        last = TSM_Timeout_Heap[TSM_Timeout_Count];
+        tsm_timeout_heap_set(position, last);
+        tsm_timeout_heap_down(position);
+        tsm_timeout_heap_up(TSM_List[last].TimeoutHeapIndex - 1);
+    }
+}
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+/**
+ * @brief Start the request timer of a transaction, and add it to
+ *  the timeout heap
+ * @param index - index of the transaction
+ */
+static void tsm_timeout_start(unsigned index)
+{
+    tsm_timeout_remove(index);
+    TSM_List[index].RequestTimer = apdu_timeout();
+    TSM_List[index].RequestTimeout =
+        TSM_Milliseconds + TSM_List[index].RequestTimer;
+    tsm_timeout_heap_set(TSM_Timeout_Count, index);
+    TSM_Timeout_Count++;
+    tsm_timeout_heap_up(TSM_Timeout_Count - 1);
+}
 
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if ((plist->InvokeID == 0) && (plist->state == TSM_STATE_IDLE)) {
-            /* one is available! */
-            count++;
+/**
+ * @brief Reserve a free transaction for an invoke ID
+ * @param peer_index - index of the peer, or MAX_TSM_PEERS for an
+ *  invoke ID that is unique among all the peers
+ * @param invokeID - invoke ID
+ */
+static void tsm_transaction_reserve(unsigned peer_index, uint8_t invokeID)
+{
+    unsigned index;
+    BACNET_TSM_DATA *plist;
+
+    index = tsm_find_first_free_index();
+    if (TSM_Free_Head) {
+        TSM_Free_Head = TSM_List[index].NextFree;
+    } else {
+        TSM_Unused_Index++;
+    }
+    plist = &TSM_List[index];
+    plist->InvokeID = invokeID;
+    plist->state = TSM_STATE_IDLE;
+    plist->RequestTimer = apdu_timeout();
+    plist->InvokeNext = TSM_Invoke_ID_Head[invokeID];
+    TSM_Invoke_ID_Head[invokeID] = (uint16_t)(index + 1);
+    if (peer_index < MAX_TSM_PEERS) {
+        plist->Peer = (uint16_t)(peer_index + 1);
+        TSM_Peer_List[peer_index].transactions++;
+        bacnet_address_copy(&plist->dest, &TSM_Peer_List[peer_index].address);
+    } else {
+        plist->Peer = 0;
+    }
+    TSM_Used_Count++;
+}
+
+/**
+ * @brief Free a transaction and sets its state to IDLE
+ * @param index - index of the transaction
+ */
+static void tsm_transaction_free(unsigned index)
+{
+    BACNET_TSM_DATA *plist = &TSM_List[index];
+    uint16_t *link;
+
+    tsm_timeout_remove(index);
+    link = &TSM_Invoke_ID_Head[plist->InvokeID];
+    while (*link) {
+        if (*link == (index + 1)) {
+            *link = plist->InvokeNext;
+            break;
         }
+        link = &TSM_List[*link - 1].InvokeNext;
+    }
+    if (plist->Peer) {
+        TSM_Peer_List[plist->Peer - 1].transactions--;
+        tsm_peer_remove_unused(plist->Peer - 1);
+        plist->Peer = 0;
     }
+    plist->state = TSM_STATE_IDLE;
+    BACTRACE_TSM_STATE(plist->state, plist->InvokeID, index, plist->RetryCount);
+    plist->InvokeID = 0;
+    plist->NextFree = TSM_Free_Head;
+    TSM_Free_Head = (uint16_t)(index + 1);
+    TSM_Used_Count--;
+}
 
-    return count;
+/** Check if space for transactions is available.
+ *
+ * @return true/false
+ */
+bool tsm_transaction_available(void)
+{
+    return TSM_Used_Count < MAX_TSM_TRANSACTIONS;
+}
+
+/** Return the count of idle transaction.
+ *
+ * @return Count of idle transaction.
+ */
+unsigned tsm_transaction_idle_count(void)
+{
+    /* the entries without an invoke ID are always idle */
+    return MAX_TSM_TRANSACTIONS - TSM_Used_Count;
 }
 
 /**
@@ -153,53 +531,164 @@ void tsm_invokeID_set(uint8_t invokeID)
 /** Gets the next free invokeID,
  * and reserves a spot in the table
  * returns 0 if none are available.
+ * The invoke ID is not used with any other peer, so at most 255
+ * of these are outstanding at once.
  *
  * @return free invoke ID
  */
 uint8_t tsm_next_free_invokeID(void)
 {
-    uint8_t index = 0;
     uint8_t invokeID = 0;
-    bool found = false;
-    BACNET_TSM_DATA *plist = NULL;
+    unsigned i;
 
     /* Is there even space available? */
     if (tsm_transaction_available()) {
-        while (!found) {
-            index = tsm_find_invokeID_index(Current_Invoke_ID);
-            if (index == MAX_TSM_TRANSACTIONS) {
-                /* Not found, so this invokeID is not used */
-                found = true;
-                /* set this id into the table */
-                index = tsm_find_first_free_index();
-                if (index != MAX_TSM_TRANSACTIONS) {
-                    plist = &TSM_List[index];
-                    plist->InvokeID = invokeID = Current_Invoke_ID;
-                    plist->state = TSM_STATE_IDLE;
-                    plist->RequestTimer = apdu_timeout();
-                    /* update for the next call or check */
-                    Current_Invoke_ID++;
-                    /* skip zero - we treat that internally as invalid or no
-                     * free */
-                    if (Current_Invoke_ID == 0) {
-                        Current_Invoke_ID = 1;
-                    }
-                }
-            } else {
-                /* found! This invokeID is already used */
-                /* try next one */
-                Current_Invoke_ID++;
-                /* skip zero - we treat that internally as invalid or no free */
-                if (Current_Invoke_ID == 0) {
-                    Current_Invoke_ID = 1;
-                }
+        for (i = 0; i < 255; i++) {
+            if (tsm_invoke_id_available(MAX_TSM_PEERS, Current_Invoke_ID)) {
+                invokeID = Current_Invoke_ID;
+                break;
+            }
+            /* found! This invokeID is already used */
+            /* try next one */
+            Current_Invoke_ID = tsm_invoke_id_next(Current_Invoke_ID);
+        }
+    }
+    if (invokeID) {
+        /* set this id into the table */
+        tsm_transaction_reserve(MAX_TSM_PEERS, invokeID);
+        /* update for the next call or check */
+        Current_Invoke_ID = tsm_invoke_id_next(Current_Invoke_ID);
+    }
+
+    return invokeID;
+}
+
+/** Gets the next free invokeID for a peer,
+ * and reserves a spot in the table
+ * returns 0 if none are available, or if the window
+ * of transactions with the peer is full.
+ * The invoke ID is unique among all the peers while one is free,
+ * and after that only unique for this peer, so the transaction is
+ * found using the peer address and invoke ID.
+ *
+ * @param dest  Pointer to the BACnet address of the peer.
+ *
+ * @return free invoke ID
+ */
+uint8_t tsm_next_free_invokeID_peer(const BACNET_ADDRESS *dest)
+{
+    BACNET_TSM_PEER *peer;
+    unsigned peer_index;
+    uint8_t invokeID = 0;
+    unsigned i;
+
+    if (!dest || !tsm_transaction_available()) {
+        return 0;
+    }
+    peer_index = tsm_peer_add(dest);
+    if (peer_index >= MAX_TSM_PEERS) {
+        return 0;
+    }
+    peer = &TSM_Peer_List[peer_index];
+    if (peer->transactions < tsm_peer_window_size(peer)) {
+        /* an invoke ID that no other peer uses is found by the
+           functions without a peer address, so it is used first */
+        for (i = 0; i < 255; i++) {
+            if (tsm_invoke_id_available(MAX_TSM_PEERS, peer->invoke_id)) {
+                invokeID = peer->invoke_id;
+                break;
             }
+            peer->invoke_id = tsm_invoke_id_next(peer->invoke_id);
+        }
+        for (i = 0; (invokeID == 0) && (i < 255); i++) {
+            if (tsm_invoke_id_available(peer_index, peer->invoke_id)) {
+                invokeID = peer->invoke_id;
+                break;
+            }
+            peer->invoke_id = tsm_invoke_id_next(peer->invoke_id);
         }
     }
+    if (invokeID) {
+        tsm_transaction_reserve(peer_index, invokeID);
+        peer->invoke_id = tsm_invoke_id_next(peer->invoke_id);
+    } else {
+        tsm_peer_remove_unused(peer_index);
+    }
 
     return invokeID;
 }
 
+/**
+ * @brief Set the number of transactions allowed at once with a peer
+ *  that uses tsm_next_free_invokeID_peer()
+ * @param dest - BACnet address of the peer
+ * @param window - number of transactions 1..255, or zero for the
+ *  default of MAX_TSM_PEER_WINDOW
+ * @return true if the window size was set
+ */
+bool tsm_peer_window_set(const BACNET_ADDRESS *dest, uint8_t window)
+{
+    unsigned peer_index;
+
+    if (!dest) {
+        return false;
+    }
+    if (window == 0) {
+        peer_index = tsm_peer_find(dest);
+        if (peer_index < MAX_TSM_PEERS) {
+            TSM_Peer_List[peer_index].window = 0;
+            tsm_peer_remove_unused(peer_index);
+        }
+        return true;
+    }
+    peer_index = tsm_peer_add(dest);
+    if (peer_index >= MAX_TSM_PEERS) {
+        return false;
+    }
+    TSM_Peer_List[peer_index].window = window;
+
+    return true;
+}
+
+/**
+ * @brief Get the number of transactions allowed at once with a peer
+ * @param dest - BACnet address of the peer
+ * @return window size
+ */
+uint8_t tsm_peer_window(const BACNET_ADDRESS *dest)
+{
+    unsigned peer_index = MAX_TSM_PEERS;
+
+    if (dest) {
+        peer_index = tsm_peer_find(dest);
+    }
+    if (peer_index < MAX_TSM_PEERS) {
+        return (uint8_t)tsm_peer_window_size(&TSM_Peer_List[peer_index]);
+    }
+
+    return MAX_TSM_PEER_WINDOW;
+}
+
+/**
+ * @brief Get the number of transactions with a peer that use
+ *  tsm_next_free_invokeID_peer()
+ * @param dest - BACnet address of the peer
+ * @return number of transactions
+ */
+unsigned tsm_peer_transaction_count(const BACNET_ADDRESS *dest)
+{
+    unsigned peer_index = MAX_TSM_PEERS;
+
+    if (dest) {
+        peer_index = tsm_peer_find(dest);
+    }
+    if (peer_index < MAX_TSM_PEERS) {
+        return TSM_Peer_List[peer_index].transactions;
+    }
+
+    return 0;
+}
+
 /** Set for an unsegmented transaction
  *  the state to await confirmation.
  *
@@ -217,18 +706,19 @@ void tsm_set_confirmed_unsegmented_transaction(
     uint16_t apdu_len)
 {
     uint16_t j = 0;
-    uint8_t index;
+    unsigned index;
     BACNET_TSM_DATA *plist;
 
     if (invokeID && ndpu_data && apdu && (apdu_len > 0)) {
-        index = tsm_find_invokeID_index(invokeID);
+        index = tsm_find_invokeID_index(dest, invokeID);
         if (index < MAX_TSM_TRANSACTIONS) {
             plist = &TSM_List[index];
             /* SendConfirmedUnsegmented */
             plist->state = TSM_STATE_AWAIT_CONFIRMATION;
             plist->RetryCount = 0;
+            BACTRACE_TSM_STATE(plist->state, invokeID, index, 0);
             /* start the timer */
-            plist->RequestTimer = apdu_timeout();
+            tsm_timeout_start(index);
             /* copy the data */
             for (j = 0; j < apdu_len; j++) {
                 plist->apdu[j] = apdu[j];
@@ -262,12 +752,12 @@ bool tsm_get_transaction_pdu(
     uint16_t *apdu_len)
 {
     uint16_t j = 0;
-    uint8_t index;
+    unsigned index;
     bool found = false;
     BACNET_TSM_DATA *plist;
 
     if (invokeID && apdu && ndpu_data && apdu_len) {
-        index = tsm_find_invokeID_index(invokeID);
+        index = tsm_find_invokeID_index(NULL, invokeID);
         /* how much checking is needed?  state?  dest match? just invokeID? */
         if (index < MAX_TSM_TRANSACTIONS) {
             /* FIXME: we may want to free the transaction so it doesn't timeout
@@ -290,85 +780,1054 @@ bool tsm_get_transaction_pdu(
     return found;
 }
 
-/** Called once a millisecond or slower.
- *  This function calls the handler for a
- *  timeout 'Timeout_Function', if necessary.
+/** Used to retrieve the payload of a transaction with a peer,
+ *  i.e. when we get an ack from the peer.
  *
- * @param milliseconds - Count of milliseconds passed, since the last call.
+ * @param src  Pointer to the BACnet address of the peer.
+ * @param invokeID  Invoke-ID
+ * @param ndpu_data  Pointer to the NPDU structure.
+ * @param apdu  Pointer to the sent message.
+ * @param apdu_len  Pointer to a variable, that takes
+ *                  the count of bytes valid in the
+ *                  sent message.
+ * @return true if the transaction is found
  */
-void tsm_timer_milliseconds(uint16_t milliseconds)
+bool tsm_get_transaction_pdu_peer(
+    const BACNET_ADDRESS *src,
+    uint8_t invokeID,
+    BACNET_NPDU_DATA *ndpu_data,
+    uint8_t *apdu,
+    uint16_t *apdu_len)
 {
-    unsigned i = 0; /* counter */
-    int bytes_sent = 0;
-
-    BACNET_TSM_DATA *plist = &TSM_List[0];
+    uint16_t j = 0;
+    unsigned index;
+    BACNET_TSM_DATA *plist;
 
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->state == TSM_STATE_AWAIT_CONFIRMATION) {
-            if (plist->RequestTimer > milliseconds) {
-                plist->RequestTimer -= milliseconds;
-            } else {
-                plist->RequestTimer = 0;
-            }
-            /* AWAIT_CONFIRMATION */
-            if (plist->RequestTimer == 0) {
-                if (plist->RetryCount < apdu_retries()) {
-                    plist->RequestTimer = apdu_timeout();
-                    plist->RetryCount++;
-                    bytes_sent = datalink_send_pdu(
-                        &plist->dest, &plist->npdu_data, &plist->apdu[0],
-                        plist->apdu_len);
-                    DEBUG_PRINTF(
-                        "invoke-id[%u] Retry %u of %u after %ums\n",
-                        plist->InvokeID, plist->RetryCount, apdu_retries(),
-                        plist->RequestTimer);
-                    if (bytes_sent <= 0) {
-                        debug_perror("invoke-id[%u] Failed to Send Retry");
-                    }
-                } else {
-                    /* note: the invoke id has not been cleared yet
-                       and this indicates a failed message:
-                       IDLE and a valid invoke id */
-                    plist->state = TSM_STATE_IDLE;
-                    if (plist->InvokeID != 0) {
-                        if (Timeout_Function) {
-                            Timeout_Function(plist->InvokeID);
-                        }
-                    }
-                }
-            }
-        }
+    if (!src || !invokeID || !apdu || !ndpu_data || !apdu_len) {
+        return false;
+    }
+    index = tsm_find_invokeID_index(src, invokeID);
+    if (index >= MAX_TSM_TRANSACTIONS) {
+        return false;
+    }
+    plist = &TSM_List[index];
+    *apdu_len = (uint16_t)plist->apdu_len;
+    if (*apdu_len > MAX_PDU) {
+        *apdu_len = MAX_PDU;
     }
+    for (j = 0; j < *apdu_len; j++) {
+        apdu[j] = plist->apdu[j];
+    }
+    npdu_copy_data(ndpu_data, &plist->npdu_data);
+
+    return true;
 }
 
-/** Frees the invokeID and sets its state to IDLE
- *
- * @param invokeID  Invoke-ID
+/**
+ * @brief Mark a transaction as failed to be confirmed, and call
+ *  the timeout handlers
+ * @param index - index of the transaction
  */
-void tsm_free_invoke_id(uint8_t invokeID)
+static void tsm_transaction_failed(unsigned index)
 {
-    uint8_t index;
-    BACNET_TSM_DATA *plist;
+    BACNET_TSM_DATA *plist = &TSM_List[index];
 
-    index = tsm_find_invokeID_index(invokeID);
-    if (index < MAX_TSM_TRANSACTIONS) {
-        plist = &TSM_List[index];
-        plist->state = TSM_STATE_IDLE;
-        plist->InvokeID = 0;
+    /* note: the invoke id has not been cleared yet
+       and this indicates a failed message:
+       IDLE and a valid invoke id */
+    tsm_timeout_remove(index);
+    plist->state = TSM_STATE_IDLE;
+    BACTRACE_TSM_STATE(plist->state, plist->InvokeID, index, plist->RetryCount);
+    plist->RequestTimer = 0;
+    if (plist->InvokeID != 0) {
+        if (Timeout_Function) {
+            Timeout_Function(plist->InvokeID);
+        }
+        if (Timeout_Peer_Function) {
+            Timeout_Peer_Function(&plist->dest, plist->InvokeID);
+        }
     }
 }
 
-/** Check if the invoke ID has been made free by the Transaction State Machine.
- * @param invokeID [in] The invokeID to be checked, normally of last message
- * sent.
- * @return True if it is free (done with), False if still pending in the TSM.
- */
-bool tsm_invoke_id_free(uint8_t invokeID)
-{
-    bool status = true;
-    uint8_t index;
+#if BACNET_SEGMENTATION_ENABLED
+/* the buffer of a segmented message holds one ASDU, and the service
+   handlers count its octets with 16 bits */
+#if (MAX_ASDU > 65535)
+#define TSM_SEGMENTED_BUFFER_SIZE 65535
+#else
+#define TSM_SEGMENTED_BUFFER_SIZE MAX_ASDU
+#endif
+/* octets in the header of a segment of a ComplexACK */
+#define TSM_SEGMENTED_ACK_HEADER_SIZE 5
 
-    index = tsm_find_invokeID_index(invokeID);
+typedef enum {
+    TSM_SEGMENTED_IDLE,
+    /* a reply is being encoded into the buffer */
+    TSM_SEGMENTED_RESERVED,
+    /* the segments of a reply are sent */
+    TSM_SEGMENTED_SENDING,
+    /* the segments of a message are received */
+    TSM_SEGMENTED_RECEIVING,
+    /* all the segments of a message were received */
+    TSM_SEGMENTED_RECEIVED
+} BACNET_TSM_SEGMENTED_STATE;
+
+/* a segment received while a segment before it is missing */
+typedef struct BACnet_TSM_Segment {
+    bool used;
+    bool more_follows;
+    uint8_t sequence_number;
+    uint16_t length;
+    uint8_t data[MAX_APDU];
+} BACNET_TSM_SEGMENT;
+
+/* 5.4.1 Variables And Parameters, for a segmented message */
+typedef struct BACnet_TSM_Segmented {
+    BACNET_TSM_SEGMENTED_STATE state;
+    /* the peer and invoke ID of the transaction */
+    BACNET_ADDRESS peer;
+    uint8_t invoke_id;
+    /* true if we are the client of the transaction */
+    bool client;
+    /* true when the segment with more-follows clear was received */
+    bool last_segment;
+    /* true when a negative SegmentACK was sent for a missing segment */
+    bool nak_sent;
+    /* the number of segments of a reply, or the number of segments
+       received in order */
+    uint16_t segment_count;
+    /* index of the first segment of the window */
+    uint16_t initial_index;
+    /* number of segments sent in the window */
+    uint8_t window_sent;
+    /* stores the current window size */
+    uint8_t actual_window_size;
+    /* used to count segment retries */
+    uint8_t retry_count;
+    /* the service choice of a reply */
+    uint8_t service_choice;
+    /* used to perform timeout on PDU segments, in milliseconds */
+    uint32_t segment_timer;
+    /* the largest APDU of the peer, and the number of segments that it
+       accepts, or zero when the number is not specified */
+    uint16_t max_apdu;
+    uint16_t max_segments;
+    /* the network layer info of a reply */
+    BACNET_NPDU_DATA npdu_data;
+    /* the service data of a reply are at this offset in the buffer */
+    uint16_t offset;
+    /* number of octets of service data */
+    uint16_t length;
+    uint8_t buffer[TSM_SEGMENTED_BUFFER_SIZE];
+    BACNET_TSM_SEGMENT out_of_order[MAX_TSM_SEGMENTS_OUT_OF_ORDER];
+} BACNET_TSM_SEGMENTED;
+
+static BACNET_TSM_SEGMENTED TSM_Segmented_List[MAX_TSM_SEGMENTED_TRANSACTIONS];
+/* buffer for sending a segment, a SegmentACK, or an Abort */
+static uint8_t TSM_Segment_PDU[MAX_PDU];
+
+/**
+ * @brief Find a segmented message of a transaction
+ * @param peer - address of the peer
+ * @param invoke_id - invoke ID of the transaction
+ * @param client - true if we are the client of the transaction
+ * @param state - state of the segmented message
+ * @return the segmented message, or NULL if not found
+ */
+static BACNET_TSM_SEGMENTED *tsm_segmented_find(
+    const BACNET_ADDRESS *peer,
+    uint8_t invoke_id,
+    bool client,
+    BACNET_TSM_SEGMENTED_STATE state)
+{
+    BACNET_TSM_SEGMENTED *seg;
+    unsigned i;
+
+    for (i = 0; i < MAX_TSM_SEGMENTED_TRANSACTIONS; i++) {
+        seg = &TSM_Segmented_List[i];
+        if ((seg->state == state) && (seg->invoke_id == invoke_id) &&
+            (seg->client == client) && bacnet_address_same(&seg->peer, peer)) {
+            return seg;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Reserve a free segmented message for a transaction
+ * @param peer - address of the peer
+ * @param invoke_id - invoke ID of the transaction
+ * @param client - true if we are the client of the transaction
+ * @param state - state of the segmented message
+ * @return the segmented message, or NULL if none is free
+ */
+static BACNET_TSM_SEGMENTED *tsm_segmented_reserve(
+    const BACNET_ADDRESS *peer,
+    uint8_t invoke_id,
+    bool client,
+    BACNET_TSM_SEGMENTED_STATE state)
+{
+    BACNET_TSM_SEGMENTED *seg;
+    unsigned i;
+
+    for (i = 0; i < MAX_TSM_SEGMENTED_TRANSACTIONS; i++) {
+        seg = &TSM_Segmented_List[i];
+        if (seg->state == TSM_SEGMENTED_IDLE) {
+            seg->state = state;
+            bacnet_address_copy(&seg->peer, peer);
+            seg->invoke_id = invoke_id;
+            seg->client = client;
+            seg->last_segment = false;
+            seg->nak_sent = false;
+            seg->segment_count = 0;
+            seg->initial_index = 0;
+            seg->window_sent = 0;
+            seg->actual_window_size = 1;
+            seg->retry_count = 0;
+            seg->segment_timer = 0;
+            seg->offset = 0;
+            seg->length = 0;
+            return seg;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Free a segmented message
+ * @param seg - segmented message
+ */
+static void tsm_segmented_free(BACNET_TSM_SEGMENTED *seg)
+{
+    unsigned i;
+
+    seg->state = TSM_SEGMENTED_IDLE;
+    for (i = 0; i < MAX_TSM_SEGMENTS_OUT_OF_ORDER; i++) {
+        seg->out_of_order[i].used = false;
+    }
+}
+
+/**
+ * @brief Send an APDU that does not expect a reply to a peer
+ * @param dest - address of the peer
+ * @param apdu - the APDU
+ * @param apdu_len - number of octets of the APDU
+ */
+static void
+tsm_segmented_apdu_send(BACNET_ADDRESS *dest, const uint8_t *apdu, int apdu_len)
+{
+    BACNET_ADDRESS my_address;
+    BACNET_NPDU_DATA npdu_data;
+    int pdu_len;
+
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len =
+        npdu_encode_pdu(&TSM_Segment_PDU[0], dest, &my_address, &npdu_data);
+    memcpy(&TSM_Segment_PDU[pdu_len], apdu, apdu_len);
+    pdu_len += apdu_len;
+    if (datalink_send_pdu(dest, &npdu_data, &TSM_Segment_PDU[0], pdu_len) <=
+        0) {
+        debug_perror("TSM: Failed to send PDU");
+    }
+}
+
+/**
+ * @brief Send an Abort of a transaction to a peer
+ * @param dest - address of the peer
+ * @param invoke_id - invoke ID of the transaction
+ * @param reason - abort reason
+ * @param server - true if we are the server of the transaction
+ */
+static void tsm_segmented_abort_send(
+    BACNET_ADDRESS *dest, uint8_t invoke_id, uint8_t reason, bool server)
+{
+    uint8_t apdu[3];
+    int apdu_len;
+
+    apdu_len = abort_encode_apdu(&apdu[0], invoke_id, reason, server);
+    tsm_segmented_apdu_send(dest, &apdu[0], apdu_len);
+}
+
+/**
+ * @brief Send a SegmentACK for the last segment received in order
+ * @param seg - segmented message that is received
+ * @param negative - true for a negative SegmentACK
+ */
+static void tsm_segment_ack_send(BACNET_TSM_SEGMENTED *seg, bool negative)
+{
+    uint8_t apdu[4];
+    int apdu_len;
+
+    apdu_len = segmentack_encode_apdu(
+        &apdu[0], negative, !seg->client, seg->invoke_id,
+        (uint8_t)(seg->segment_count - 1), seg->actual_window_size);
+    tsm_segmented_apdu_send(&seg->peer, &apdu[0], apdu_len);
+}
+
+/**
+ * @brief Send a segment of a reply
+ * @param seg - segmented message that is sent
+ * @param index - index of the segment
+ * @return number of bytes sent
+ */
+static int tsm_segment_send(BACNET_TSM_SEGMENTED *seg, uint16_t index)
+{
+    BACNET_ADDRESS my_address;
+    uint32_t offset;
+    uint16_t length;
+    uint8_t *apdu;
+    int pdu_len;
+    int bytes_sent;
+
+    length = seg->max_apdu - TSM_SEGMENTED_ACK_HEADER_SIZE;
+    offset = (uint32_t)index * length;
+    if ((offset + length) > seg->length) {
+        length = (uint16_t)(seg->length - offset);
+    }
+    datalink_get_my_address(&my_address);
+    pdu_len = npdu_encode_pdu(
+        &TSM_Segment_PDU[0], &seg->peer, &my_address, &seg->npdu_data);
+    apdu = &TSM_Segment_PDU[pdu_len];
+    apdu[0] = PDU_TYPE_COMPLEX_ACK | BIT(3);
+    if ((index + 1) < seg->segment_count) {
+        apdu[0] |= BIT(2);
+    }
+    apdu[1] = seg->invoke_id;
+    apdu[2] = (uint8_t)index;
+    apdu[3] = MAX_TSM_SEGMENT_WINDOW;
+    apdu[4] = seg->service_choice;
+    memcpy(
+        &apdu[TSM_SEGMENTED_ACK_HEADER_SIZE],
+        &seg->buffer[seg->offset + offset], length);
+    pdu_len += TSM_SEGMENTED_ACK_HEADER_SIZE + length;
+    bytes_sent = datalink_send_pdu(
+        &seg->peer, &seg->npdu_data, &TSM_Segment_PDU[0], pdu_len);
+    if (bytes_sent <= 0) {
+        debug_perror("TSM: Failed to send segment");
+    }
+
+    return bytes_sent;
+}
+
+/**
+ * @brief Send the segments of the window of a reply, and start the
+ *  segment timer to wait for the SegmentACK
+ * @param seg - segmented message that is sent
+ * @return number of bytes sent
+ */
+static int tsm_segment_window_send(BACNET_TSM_SEGMENTED *seg)
+{
+    int bytes_sent = 0;
+    unsigned i;
+
+    seg->window_sent = seg->actual_window_size;
+    if ((seg->initial_index + seg->window_sent) > seg->segment_count) {
+        seg->window_sent = (uint8_t)(seg->segment_count - seg->initial_index);
+    }
+    for (i = 0; i < seg->window_sent; i++) {
+        bytes_sent += tsm_segment_send(seg, seg->initial_index + i);
+    }
+    seg->segment_timer = apdu_segment_timeout();
+
+    return bytes_sent;
+}
+
+/**
+ * @brief Get a buffer for a reply that may be sent in segments.
+ *  When the client accepts a segmented response, the buffer holds
+ *  the largest reply that the client accepts in segments, and the
+ *  max_resp of the service data is raised to the number of octets
+ *  that the buffer holds for the reply APDU.  Each buffer that is given
+ *  shall be sent, or released, with tsm_segmented_reply_send().
+ * @param dest - address of the client
+ * @param service_data - service data of the request
+ * @param pdu_size - size of the buffer, if one is given
+ * @return a buffer for the NPDU of the reply, or NULL if the reply is
+ *  not segmented
+ */
+uint8_t *tsm_segmented_reply_buffer(
+    const BACNET_ADDRESS *dest,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    uint16_t *pdu_size)
+{
+    BACNET_TSM_SEGMENTED *seg;
+    uint32_t capacity;
+    uint16_t max_apdu;
+
+    if (!dest || !service_data || !pdu_size ||
+        !service_data->segmented_response_accepted) {
+        return NULL;
+    }
+    max_apdu = MAX_APDU;
+    if ((service_data->max_resp > 0) && (service_data->max_resp < max_apdu)) {
+        max_apdu = (uint16_t)service_data->max_resp;
+    }
+    if (max_apdu <= TSM_SEGMENTED_ACK_HEADER_SIZE) {
+        return NULL;
+    }
+    /* a request that is sent again starts the reply again */
+    seg = tsm_segmented_find(
+        dest, service_data->invoke_id, false, TSM_SEGMENTED_SENDING);
+    if (seg) {
+        tsm_segmented_free(seg);
+    }
+    seg = tsm_segmented_reserve(
+        dest, service_data->invoke_id, false, TSM_SEGMENTED_RESERVED);
+    if (!seg) {
+        return NULL;
+    }
+    seg->max_apdu = max_apdu;
+    /* 20.1.2.4 max-segments-accepted of 0 is unspecified,
+       and more than 64 segments is decoded as 65 */
+    if ((service_data->max_segs > 0) && (service_data->max_segs <= 64)) {
+        seg->max_segments = (uint16_t)service_data->max_segs;
+        capacity = 3 +
+            ((uint32_t)seg->max_segments *
+             (max_apdu - TSM_SEGMENTED_ACK_HEADER_SIZE));
+    } else {
+        seg->max_segments = 0;
+        capacity = TSM_SEGMENTED_BUFFER_SIZE;
+    }
+    if (capacity > (TSM_SEGMENTED_BUFFER_SIZE - MAX_NPDU)) {
+        capacity = TSM_SEGMENTED_BUFFER_SIZE - MAX_NPDU;
+    }
+    if (capacity > (uint32_t)service_data->max_resp) {
+        service_data->max_resp = (int)capacity;
+    }
+    *pdu_size = TSM_SEGMENTED_BUFFER_SIZE;
+
+    return &seg->buffer[0];
+}
+
+/**
+ * @brief Send a reply, in segments when the APDU is larger than the
+ *  client accepts in one.  A reply that is not in a buffer from
+ *  tsm_segmented_reply_buffer() is sent as it is.
+ * @param dest - address of the client
+ * @param npdu_data - network layer info of the reply
+ * @param pdu - the NPDU of the reply
+ * @param pdu_len - number of octets of the reply, or zero or negative
+ *  to release the buffer without sending anything
+ * @return number of bytes sent
+ */
+int tsm_segmented_reply_send(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    int pdu_len)
+{
+    BACNET_TSM_SEGMENTED *seg = NULL;
+    BACNET_NPDU_DATA reply_npdu_data = { 0 };
+    uint16_t length;
+    int apdu_offset = 0;
+    int bytes_sent = 0;
+    unsigned i;
+
+    for (i = 0; i < MAX_TSM_SEGMENTED_TRANSACTIONS; i++) {
+        if ((TSM_Segmented_List[i].state == TSM_SEGMENTED_RESERVED) &&
+            (pdu == &TSM_Segmented_List[i].buffer[0])) {
+            seg = &TSM_Segmented_List[i];
+            break;
+        }
+    }
+    if (!seg) {
+        if (pdu_len > 0) {
+            bytes_sent = datalink_send_pdu(dest, npdu_data, pdu, pdu_len);
+        }
+        return bytes_sent;
+    }
+    if (pdu_len > 0) {
+        apdu_offset = bacnet_npdu_decode(
+            pdu, (uint16_t)pdu_len, NULL, NULL, &reply_npdu_data);
+    }
+    if ((apdu_offset <= 0) || (apdu_offset >= pdu_len)) {
+        tsm_segmented_free(seg);
+        return 0;
+    }
+    if ((pdu_len - apdu_offset) <= seg->max_apdu) {
+        bytes_sent = datalink_send_pdu(dest, npdu_data, pdu, pdu_len);
+        tsm_segmented_free(seg);
+        return bytes_sent;
+    }
+    if (((pdu[apdu_offset] & 0xF0) != PDU_TYPE_COMPLEX_ACK) ||
+        (pdu[apdu_offset] & BIT(3)) || ((pdu_len - apdu_offset) < 3)) {
+        /* only a whole ComplexACK is sent in segments */
+        tsm_segmented_free(seg);
+        return 0;
+    }
+    seg->service_choice = pdu[apdu_offset + 2];
+    seg->offset = (uint16_t)(apdu_offset + 3);
+    seg->length = (uint16_t)(pdu_len - seg->offset);
+    length = seg->max_apdu - TSM_SEGMENTED_ACK_HEADER_SIZE;
+    seg->segment_count = (seg->length + length - 1) / length;
+    if ((seg->segment_count > 256) ||
+        (seg->max_segments && (seg->segment_count > seg->max_segments))) {
+        tsm_segmented_abort_send(
+            &seg->peer, seg->invoke_id, ABORT_REASON_BUFFER_OVERFLOW, true);
+        tsm_segmented_free(seg);
+        return 0;
+    }
+    npdu_copy_data(&seg->npdu_data, npdu_data);
+    /* the client replies to each window with a SegmentACK */
+    seg->npdu_data.data_expecting_reply = true;
+    /* SendSegmentedComplexACK: the first segment is sent alone */
+    seg->state = TSM_SEGMENTED_SENDING;
+    seg->initial_index = 0;
+    seg->actual_window_size = 1;
+    seg->retry_count = 0;
+    bytes_sent = tsm_segment_window_send(seg);
+
+    return bytes_sent;
+}
+
+/**
+ * @brief Handle a SegmentACK from a peer
+ * @param src - address of the peer
+ * @param negative - true for a negative SegmentACK
+ * @param server - true if the SegmentACK was sent by the server
+ * @param invoke_id - invoke ID of the transaction
+ * @param sequence_number - sequence number of the last segment received
+ * @param actual_window_size - number of segments for the next window
+ */
+void tsm_segment_ack_handler(
+    const BACNET_ADDRESS *src,
+    bool negative,
+    bool server,
+    uint8_t invoke_id,
+    uint8_t sequence_number,
+    uint8_t actual_window_size)
+{
+    BACNET_TSM_SEGMENTED *seg;
+    uint8_t offset;
+
+    (void)negative;
+    if (!src || server) {
+        /* we only send the segments of a ComplexACK */
+        return;
+    }
+    seg = tsm_segmented_find(src, invoke_id, false, TSM_SEGMENTED_SENDING);
+    if (!seg) {
+        return;
+    }
+    offset = (uint8_t)(sequence_number - (uint8_t)seg->initial_index);
+    if (offset >= seg->window_sent) {
+        /* DuplicateACK_Received */
+        seg->segment_timer = apdu_segment_timeout();
+        return;
+    }
+    if ((seg->initial_index + offset + 1U) >= seg->segment_count) {
+        /* FinalSegmentAckReceived */
+        tsm_segmented_free(seg);
+        return;
+    }
+    /* NewACK_Received: the segments after the acknowledged one are sent,
+       which is also how the missing ones of a negative SegmentACK
+       are sent again */
+    seg->initial_index += offset + 1U;
+    if ((actual_window_size >= 1) && (actual_window_size <= 127)) {
+        seg->actual_window_size = actual_window_size;
+    }
+    seg->retry_count = 0;
+    (void)tsm_segment_window_send(seg);
+}
+
+/**
+ * @brief Append a segment to a segmented message that is received
+ * @param seg - segmented message
+ * @param more_follows - true if more segments follow this one
+ * @param data - service data of the segment
+ * @param data_len - number of octets of service data
+ * @return true if the segment fits into the buffer
+ */
+static bool tsm_segment_append(
+    BACNET_TSM_SEGMENTED *seg,
+    bool more_follows,
+    const uint8_t *data,
+    uint16_t data_len)
+{
+    if ((seg->length + (uint32_t)data_len) > sizeof(seg->buffer)) {
+        return false;
+    }
+    if (data_len) {
+        memcpy(&seg->buffer[seg->length], data, data_len);
+    }
+    seg->length += data_len;
+    seg->segment_count++;
+    if (!more_follows) {
+        seg->last_segment = true;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Append the segments that were received out of order, and
+ *  that now follow the segments received in order
+ * @param seg - segmented message
+ * @return true if the segments fit into the buffer
+ */
+static bool tsm_segment_out_of_order_drain(BACNET_TSM_SEGMENTED *seg)
+{
+    BACNET_TSM_SEGMENT *segment;
+    bool found;
+    unsigned i;
+
+    do {
+        found = false;
+        for (i = 0; i < MAX_TSM_SEGMENTS_OUT_OF_ORDER; i++) {
+            segment = &seg->out_of_order[i];
+            if (segment->used && !seg->last_segment &&
+                (segment->sequence_number == (uint8_t)seg->segment_count)) {
+                segment->used = false;
+                if (!tsm_segment_append(
+                        seg, segment->more_follows, &segment->data[0],
+                        segment->length)) {
+                    return false;
+                }
+                found = true;
+            }
+        }
+    } while (found);
+
+    return true;
+}
+
+/**
+ * @brief Keep a segment that was received ahead of a missing segment
+ * @param seg - segmented message
+ * @param sequence_number - sequence number of the segment
+ * @param more_follows - true if more segments follow this one
+ * @param data - service data of the segment
+ * @param data_len - number of octets of service data
+ */
+static void tsm_segment_out_of_order_add(
+    BACNET_TSM_SEGMENTED *seg,
+    uint8_t sequence_number,
+    bool more_follows,
+    const uint8_t *data,
+    uint16_t data_len)
+{
+    BACNET_TSM_SEGMENT *segment = NULL;
+    unsigned i;
+
+    if (data_len > MAX_APDU) {
+        return;
+    }
+    for (i = 0; i < MAX_TSM_SEGMENTS_OUT_OF_ORDER; i++) {
+        if (seg->out_of_order[i].used) {
+            if (seg->out_of_order[i].sequence_number == sequence_number) {
+                /* already kept */
+                return;
+            }
+        } else if (!segment) {
+            segment = &seg->out_of_order[i];
+        }
+    }
+    if (segment) {
+        segment->used = true;
+        segment->sequence_number = sequence_number;
+        segment->more_follows = more_follows;
+        segment->length = data_len;
+        if (data_len) {
+            memcpy(&segment->data[0], data, data_len);
+        }
+    }
+}
+
+/**
+ * @brief Stop receiving a segmented message after an error, and abort
+ *  the transaction
+ * @param seg - segmented message
+ * @param reason - abort reason
+ */
+static void
+tsm_segmented_receive_abort(BACNET_TSM_SEGMENTED *seg, uint8_t reason)
+{
+    unsigned index;
+
+    tsm_segmented_abort_send(
+        &seg->peer, seg->invoke_id, reason, !seg->client);
+    if (seg->client) {
+        index = tsm_find_invokeID_index(&seg->peer, seg->invoke_id);
+        if (index < MAX_TSM_TRANSACTIONS) {
+            tsm_transaction_failed(index);
+        }
+    }
+    tsm_segmented_free(seg);
+}
+
+/**
+ * @brief Receive a segment of a segmented confirmed request, or of a
+ *  segmented ComplexACK for one of our requests, and reply with the
+ *  SegmentACKs.  Segments that arrive ahead of a missing segment are
+ *  kept until the missing segment is sent again.
+ * @param src - address of the peer
+ * @param server - true if the segment was sent by the server, that is
+ *  a segment of a ComplexACK
+ * @param invoke_id - invoke ID of the transaction
+ * @param sequence_number - sequence number of the segment
+ * @param proposed_window_size - window size proposed by the peer
+ * @param more_follows - true if more segments follow this one
+ * @param data - service data of the segment
+ * @param data_len - number of octets of service data
+ * @param message - the service data of the whole message, when
+ *  all of its segments were received
+ * @param message_len - number of octets of the whole message
+ * @return true if all the segments of the message were received.
+ *  The message is then released with tsm_segmented_message_free().
+ */
+bool tsm_segment_receive(
+    const BACNET_ADDRESS *src,
+    bool server,
+    uint8_t invoke_id,
+    uint8_t sequence_number,
+    uint8_t proposed_window_size,
+    bool more_follows,
+    const uint8_t *data,
+    uint16_t data_len,
+    uint8_t **message,
+    uint16_t *message_len)
+{
+    BACNET_TSM_SEGMENTED *seg;
+    BACNET_ADDRESS peer;
+    unsigned index = MAX_TSM_TRANSACTIONS;
+    uint8_t ahead;
+
+    if (!src || !message || !message_len || (data_len && !data)) {
+        return false;
+    }
+    seg = tsm_segmented_find(src, invoke_id, server, TSM_SEGMENTED_RECEIVING);
+    if (!seg) {
+        if (sequence_number != 0) {
+            /* not the first segment of a message */
+            return false;
+        }
+        if (server) {
+            /* a ComplexACK is only received for a request that waits */
+            index = tsm_find_invokeID_index(src, invoke_id);
+            if ((index >= MAX_TSM_TRANSACTIONS) ||
+                (TSM_List[index].state != TSM_STATE_AWAIT_CONFIRMATION)) {
+                return false;
+            }
+        }
+        seg = tsm_segmented_reserve(
+            src, invoke_id, server, TSM_SEGMENTED_RECEIVING);
+        if (!seg) {
+            bacnet_address_copy(&peer, src);
+            tsm_segmented_abort_send(
+                &peer, invoke_id, ABORT_REASON_OUT_OF_RESOURCES, !server);
+            if (server) {
+                tsm_transaction_failed(index);
+            }
+            return false;
+        }
+        if (server) {
+            /* SegmentedConfirmation: the request is answered, and the
+               segment timer takes over from the request timer */
+            tsm_timeout_remove(index);
+            TSM_List[index].state = TSM_STATE_SEGMENTED_CONFIRMATION;
+            BACTRACE_TSM_STATE(
+                TSM_List[index].state, invoke_id, index,
+                TSM_List[index].RetryCount);
+        }
+        if ((proposed_window_size < 1) || (proposed_window_size > 127)) {
+            tsm_segmented_receive_abort(
+                seg, ABORT_REASON_WINDOW_SIZE_OUT_OF_RANGE);
+            return false;
+        }
+        seg->actual_window_size = proposed_window_size;
+        if (seg->actual_window_size > MAX_TSM_SEGMENT_WINDOW) {
+            seg->actual_window_size = MAX_TSM_SEGMENT_WINDOW;
+        }
+        if (!tsm_segment_append(seg, more_follows, data, data_len)) {
+            tsm_segmented_receive_abort(seg, ABORT_REASON_BUFFER_OVERFLOW);
+            return false;
+        }
+        seg->initial_index = seg->segment_count;
+        tsm_segment_ack_send(seg, false);
+    } else if (sequence_number == (uint8_t)seg->segment_count) {
+        /* NewSegmentReceived */
+        if (!tsm_segment_append(seg, more_follows, data, data_len) ||
+            !tsm_segment_out_of_order_drain(seg)) {
+            tsm_segmented_receive_abort(seg, ABORT_REASON_BUFFER_OVERFLOW);
+            return false;
+        }
+        seg->nak_sent = false;
+        if (seg->last_segment ||
+            ((seg->segment_count - seg->initial_index) >=
+             seg->actual_window_size)) {
+            tsm_segment_ack_send(seg, false);
+            seg->initial_index = seg->segment_count;
+        }
+    } else {
+        ahead = (uint8_t)(sequence_number - (uint8_t)seg->segment_count);
+        if (ahead < (seg->initial_index + seg->actual_window_size -
+                     seg->segment_count)) {
+            /* SegmentReceivedOutOfOrder: the sender begins its next
+               window after the last segment received in order */
+            tsm_segment_out_of_order_add(
+                seg, sequence_number, more_follows, data, data_len);
+            if (!seg->nak_sent) {
+                tsm_segment_ack_send(seg, true);
+                seg->nak_sent = true;
+                seg->initial_index = seg->segment_count;
+            }
+        } else {
+            /* DuplicateSegmentReceived */
+            tsm_segment_ack_send(seg, false);
+        }
+    }
+    seg->segment_timer = 4UL * apdu_segment_timeout();
+    if (!seg->last_segment) {
+        return false;
+    }
+    seg->state = TSM_SEGMENTED_RECEIVED;
+    *message = &seg->buffer[0];
+    *message_len = seg->length;
+
+    return true;
+}
+
+/**
+ * @brief Release a segmented message that was received
+ * @param src - address of the peer
+ * @param server - true if the message was sent by the server
+ * @param invoke_id - invoke ID of the transaction
+ */
+void tsm_segmented_message_free(
+    const BACNET_ADDRESS *src, bool server, uint8_t invoke_id)
+{
+    BACNET_TSM_SEGMENTED *seg;
+
+    if (!src) {
+        return;
+    }
+    seg = tsm_segmented_find(src, invoke_id, server, TSM_SEGMENTED_RECEIVED);
+    if (seg) {
+        tsm_segmented_free(seg);
+    }
+}
+
+/**
+ * @brief Stop the segmented messages of a transaction that was aborted
+ * @param src - address of the peer
+ * @param server - true if the Abort was sent by the server
+ * @param invoke_id - invoke ID of the transaction
+ */
+void tsm_segmented_abort_handler(
+    const BACNET_ADDRESS *src, bool server, uint8_t invoke_id)
+{
+    BACNET_TSM_SEGMENTED *seg;
+    unsigned i;
+
+    if (!src) {
+        return;
+    }
+    for (i = 0; i < MAX_TSM_SEGMENTED_TRANSACTIONS; i++) {
+        seg = &TSM_Segmented_List[i];
+        if ((seg->state != TSM_SEGMENTED_IDLE) &&
+            (seg->state != TSM_SEGMENTED_RESERVED) &&
+            (seg->invoke_id == invoke_id) && (seg->client == server) &&
+            bacnet_address_same(&seg->peer, src)) {
+            tsm_segmented_free(seg);
+        }
+    }
+}
+
+/**
+ * @brief Get the number of segmented messages that are sent or received
+ * @return number of segmented messages
+ */
+unsigned tsm_segmented_count(void)
+{
+    unsigned count = 0;
+    unsigned i;
+
+    for (i = 0; i < MAX_TSM_SEGMENTED_TRANSACTIONS; i++) {
+        if (TSM_Segmented_List[i].state != TSM_SEGMENTED_IDLE) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Count down the segment timers.  The window of a reply is sent
+ *  again when its SegmentACK does not arrive, and a message that is
+ *  received is dropped when its next segment does not arrive.
+ * @param milliseconds - Count of milliseconds passed, since the last call.
+ */
+static void tsm_segmented_timer(uint16_t milliseconds)
+{
+    BACNET_TSM_SEGMENTED *seg;
+    unsigned index;
+    unsigned i;
+
+    for (i = 0; i < MAX_TSM_SEGMENTED_TRANSACTIONS; i++) {
+        seg = &TSM_Segmented_List[i];
+        if ((seg->state != TSM_SEGMENTED_SENDING) &&
+            (seg->state != TSM_SEGMENTED_RECEIVING)) {
+            continue;
+        }
+        if (seg->segment_timer > milliseconds) {
+            seg->segment_timer -= milliseconds;
+            continue;
+        }
+        seg->segment_timer = 0;
+        if (seg->state == TSM_SEGMENTED_SENDING) {
+            if (seg->retry_count < apdu_retries()) {
+                seg->retry_count++;
+                (void)tsm_segment_window_send(seg);
+            } else {
+                tsm_segmented_free(seg);
+            }
+        } else {
+            if (seg->client) {
+                index = tsm_find_invokeID_index(&seg->peer, seg->invoke_id);
+                if (index < MAX_TSM_TRANSACTIONS) {
+                    tsm_transaction_failed(index);
+                }
+            }
+            tsm_segmented_free(seg);
+        }
+    }
+}
+#endif
+
+/** Called once a millisecond or slower.
+ *  This function calls the handler for a
+ *  timeout 'Timeout_Function', if necessary.
+ *  Only the transactions whose request timer has expired are visited,
+ *  in the order that they expire.
+ *
+ * @param milliseconds - Count of milliseconds passed, since the last call.
+ */
+void tsm_timer_milliseconds(uint16_t milliseconds)
+{
+    int bytes_sent = 0;
+    unsigned index;
+    BACNET_TSM_DATA *plist;
+
+    /* the TSM has no init, so its tables are accounted here; tables
+       that are already accounted are not added again */
+    MEMSTAT_FIXED(MEMSTAT_TSM, TSM_List, sizeof(TSM_List));
+    MEMSTAT_FIXED(MEMSTAT_TSM, TSM_Peer_List, sizeof(TSM_Peer_List));
+#if BACNET_SEGMENTATION_ENABLED
+    MEMSTAT_FIXED(
+        MEMSTAT_TSM, TSM_Segmented_List, sizeof(TSM_Segmented_List));
+#endif
+    TSM_Milliseconds += milliseconds;
+    while (TSM_Timeout_Count > 0) {
+        index = TSM_Timeout_Heap[0];
+        plist = &TSM_List[index];
+        if ((int32_t)(TSM_Milliseconds - plist->RequestTimeout) < 0) {
+            break;
+        }
+        tsm_timeout_remove(index);
+        /* AWAIT_CONFIRMATION */
+        if (plist->RetryCount < apdu_retries()) {
+            tsm_timeout_start(index);
+            plist->RetryCount++;
+            PERFSTAT_COUNT(PERFSTAT_TSM_RETRIES);
+            BACTRACE_TSM_STATE(
+                plist->state, plist->InvokeID, index, plist->RetryCount);
+            bytes_sent = datalink_send_pdu(
+                &plist->dest, &plist->npdu_data, &plist->apdu[0],
+                plist->apdu_len);
+            DEBUG_PRINTF(
+                "invoke-id[%u] Retry %u of %u after %ums\n", plist->InvokeID,
+                plist->RetryCount, apdu_retries(), plist->RequestTimer);
+            if (bytes_sent <= 0) {
+                debug_perror("invoke-id[%u] Failed to Send Retry");
+            }
+        } else {
+            PERFSTAT_COUNT(PERFSTAT_TSM_TIMEOUTS);
+            tsm_transaction_failed(index);
+        }
+    }
+#if BACNET_SEGMENTATION_ENABLED
+    tsm_segmented_timer(milliseconds);
+#endif
+}
+
+/** Frees the invokeID and sets its state to IDLE.
+ *  Only an invoke ID from tsm_next_free_invokeID() is found,
+ *  use tsm_free_invoke_id_peer() for any invoke ID.
+ *
+ * @param invokeID  Invoke-ID
+ */
+void tsm_free_invoke_id(uint8_t invokeID)
+{
+    unsigned index;
+
+    if (invokeID == 0) {
+        return;
+    }
+    index = tsm_find_invokeID_index(NULL, invokeID);
+    if (index < MAX_TSM_TRANSACTIONS) {
+        tsm_transaction_free(index);
+    }
+}
+
+/** Frees the invokeID of a transaction with a peer,
+ *  and sets its state to IDLE
+ *
+ * @param src  Pointer to the BACnet address of the peer.
+ * @param invokeID  Invoke-ID
+ */
+void tsm_free_invoke_id_peer(const BACNET_ADDRESS *src, uint8_t invokeID)
+{
+    unsigned index;
+
+    if ((invokeID == 0) || !src) {
+        return;
+    }
+    index = tsm_find_invokeID_index(src, invokeID);
+    if (index < MAX_TSM_TRANSACTIONS) {
+        tsm_transaction_free(index);
+    }
+}
+
+/** Check if the invoke ID has been made free by the Transaction State Machine.
+ *  Only an invoke ID from tsm_next_free_invokeID() is found,
+ *  use tsm_invoke_id_free_peer() for any invoke ID.
+ * @param invokeID [in] The invokeID to be checked, normally of last message
+ * sent.
+ * @return True if it is free (done with), False if still pending in the TSM.
+ */
+bool tsm_invoke_id_free(uint8_t invokeID)
+{
+    bool status = true;
+    unsigned index;
+
+    index = tsm_find_invokeID_index(NULL, invokeID);
+    if (index < MAX_TSM_TRANSACTIONS) {
+        status = false;
+    }
+
+    return status;
+}
+
+/** Check if the invoke ID of a transaction with a peer has been
+ *  made free by the Transaction State Machine.
+ * @param dest [in] The BACnet address of the peer.
+ * @param invokeID [in] The invokeID to be checked, normally of last message
+ * sent.
+ * @return True if it is free (done with), False if still pending in the TSM.
+ */
+bool tsm_invoke_id_free_peer(const BACNET_ADDRESS *dest, uint8_t invokeID)
+{
+    bool status = true;
+    unsigned index;
+
+    if (!dest) {
+        return status;
+    }
+    index = tsm_find_invokeID_index(dest, invokeID);
     if (index < MAX_TSM_TRANSACTIONS) {
         status = false;
     }
@@ -378,6 +1837,8 @@ bool tsm_invoke_id_free(uint8_t invokeID)
 
 /** See if we failed get a confirmation for the message associated
  *  with this invoke ID.
+ *  Only an invoke ID from tsm_next_free_invokeID() is found,
+ *  use tsm_invoke_id_failed_peer() for any invoke ID.
  * @param invokeID [in] The invokeID to be checked, normally of last message
  * sent.
  * @return True if already failed, False if done or segmented or still waiting
@@ -386,9 +1847,9 @@ bool tsm_invoke_id_free(uint8_t invokeID)
 bool tsm_invoke_id_failed(uint8_t invokeID)
 {
     bool status = false;
-    uint8_t index;
+    unsigned index;
 
-    index = tsm_find_invokeID_index(invokeID);
+    index = tsm_find_invokeID_index(NULL, invokeID);
     if (index < MAX_TSM_TRANSACTIONS) {
         /* a valid invoke ID and the state is IDLE is a
            message that failed to confirm */
@@ -399,4 +1860,30 @@ bool tsm_invoke_id_failed(uint8_t invokeID)
 
     return status;
 }
+
+/** See if we failed get a confirmation for the message associated
+ *  with this invoke ID and peer.
+ * @param dest [in] The BACnet address of the peer.
+ * @param invokeID [in] The invokeID to be checked, normally of last message
+ * sent.
+ * @return True if already failed, False if done or segmented or still waiting
+ *         for a confirmation.
+ */
+bool tsm_invoke_id_failed_peer(const BACNET_ADDRESS *dest, uint8_t invokeID)
+{
+    bool status = false;
+    unsigned index;
+
+    if (!dest) {
+        return status;
+    }
+    index = tsm_find_invokeID_index(dest, invokeID);
+    if (index < MAX_TSM_TRANSACTIONS) {
+        if (TSM_List[index].state == TSM_STATE_IDLE) {
+            status = true;
+        }
+    }
+
+    return status;
+}
 #endif
@@ -14,6 +14,7 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/apdu.h"
 #include "bacnet/npdu.h"
 
 /* note: TSM functionality is optional - only needed if we are
@@ -32,6 +33,27 @@ BACNET_STACK_EXPORT extern uint8_t Handler_Transmit_Buffer[MAX_PDU];
 
 #if (!MAX_TSM_TRANSACTIONS)
 #define tsm_free_invoke_id(x) (void)x;
+#define tsm_free_invoke_id_peer(s, x) \
+    (void)s;                          \
+    (void)x;
+#if BACNET_SEGMENTATION_ENABLED
+/* without a TSM, the replies are not segmented */
+#define tsm_segmented_reply_buffer(d, s, n) ((void)(d), (void)(s), NULL)
+#define tsm_segmented_reply_send(d, n, p, l) \
+    (((l) > 0) ? datalink_send_pdu(d, n, p, l) : 0)
+#define tsm_segment_receive(s, v, i, q, w, m, d, l, p, n) false
+#define tsm_segmented_message_free(s, v, i) \
+    (void)s;                                \
+    (void)v;                                \
+    (void)i;
+#define tsm_segmented_abort_handler(s, v, i) \
+    (void)s;                                 \
+    (void)v;                                 \
+    (void)i;
+#define tsm_segment_ack_handler(s, k, v, i, q, w) \
+    (void)s;                                      \
+    (void)i;
+#endif
 #else
 typedef enum {
     TSM_STATE_IDLE,
@@ -65,6 +87,17 @@ typedef struct BACnet_TSM_Data {
     /* used to perform timeout on Confirmed Requests */
     /* in milliseconds */
     uint16_t RequestTimer;
+    /* TSM millisecond count when the request timer expires */
+    uint32_t RequestTimeout;
+    /* position in the timeout heap plus one, or zero if not waiting */
+    uint16_t TimeoutHeapIndex;
+    /* next free transaction index plus one, or zero at the end */
+    uint16_t NextFree;
+    /* next transaction index plus one with the same invoke ID, or zero */
+    uint16_t InvokeNext;
+    /* peer index plus one when the invoke ID is only unique for the
+       peer, or zero when it is unique among all the peers */
+    uint16_t Peer;
     /* unique id */
     uint8_t InvokeID;
     /* state that the TSM is in */
@@ -79,6 +112,8 @@ typedef struct BACnet_TSM_Data {
 } BACNET_TSM_DATA;
 
 typedef void (*tsm_timeout_function)(uint8_t invoke_id);
+typedef void (*tsm_timeout_peer_function)(
+    const BACNET_ADDRESS *dest, uint8_t invoke_id);
 
 #ifdef __cplusplus
 extern "C" {
@@ -86,21 +121,34 @@ extern "C" {
 
 BACNET_STACK_EXPORT
 void tsm_set_timeout_handler(tsm_timeout_function pFunction);
+BACNET_STACK_EXPORT
+void tsm_set_timeout_peer_handler(tsm_timeout_peer_function pFunction);
 
 BACNET_STACK_EXPORT
 bool tsm_transaction_available(void);
 BACNET_STACK_EXPORT
-uint8_t tsm_transaction_idle_count(void);
+unsigned tsm_transaction_idle_count(void);
 BACNET_STACK_EXPORT
 void tsm_timer_milliseconds(uint16_t milliseconds);
 /* free the invoke ID when the reply comes back */
 BACNET_STACK_EXPORT
 void tsm_free_invoke_id(uint8_t invokeID);
+BACNET_STACK_EXPORT
+void tsm_free_invoke_id_peer(const BACNET_ADDRESS *src, uint8_t invokeID);
 /* use these in tandem */
 BACNET_STACK_EXPORT
 uint8_t tsm_next_free_invokeID(void);
 BACNET_STACK_EXPORT
 void tsm_invokeID_set(uint8_t invokeID);
+/* invoke IDs that are unique per peer, with a window per peer */
+BACNET_STACK_EXPORT
+uint8_t tsm_next_free_invokeID_peer(const BACNET_ADDRESS *dest);
+BACNET_STACK_EXPORT
+bool tsm_peer_window_set(const BACNET_ADDRESS *dest, uint8_t window);
+BACNET_STACK_EXPORT
+uint8_t tsm_peer_window(const BACNET_ADDRESS *dest);
+BACNET_STACK_EXPORT
+unsigned tsm_peer_transaction_count(const BACNET_ADDRESS *dest);
 /* returns the same invoke ID that was given */
 BACNET_STACK_EXPORT
 void tsm_set_confirmed_unsegmented_transaction(
@@ -117,11 +165,70 @@ bool tsm_get_transaction_pdu(
     BACNET_NPDU_DATA *ndpu_data,
     uint8_t *apdu,
     uint16_t *apdu_len);
+BACNET_STACK_EXPORT
+bool tsm_get_transaction_pdu_peer(
+    const BACNET_ADDRESS *src,
+    uint8_t invokeID,
+    BACNET_NPDU_DATA *ndpu_data,
+    uint8_t *apdu,
+    uint16_t *apdu_len);
 
+/* the functions without a peer address find the invoke IDs from
+   tsm_next_free_invokeID(), and the first transaction with an invoke
+   ID from tsm_next_free_invokeID_peer().  That one is unique until more
+   than 255 transactions are outstanding, then use the _peer functions */
 BACNET_STACK_EXPORT
 bool tsm_invoke_id_free(uint8_t invokeID);
 BACNET_STACK_EXPORT
 bool tsm_invoke_id_failed(uint8_t invokeID);
+BACNET_STACK_EXPORT
+bool tsm_invoke_id_free_peer(const BACNET_ADDRESS *dest, uint8_t invokeID);
+BACNET_STACK_EXPORT
+bool tsm_invoke_id_failed_peer(const BACNET_ADDRESS *dest, uint8_t invokeID);
+
+#if BACNET_SEGMENTATION_ENABLED
+/* segmented replies */
+BACNET_STACK_EXPORT
+uint8_t *tsm_segmented_reply_buffer(
+    const BACNET_ADDRESS *dest,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    uint16_t *pdu_size);
+BACNET_STACK_EXPORT
+int tsm_segmented_reply_send(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    int pdu_len);
+BACNET_STACK_EXPORT
+void tsm_segment_ack_handler(
+    const BACNET_ADDRESS *src,
+    bool negative,
+    bool server,
+    uint8_t invoke_id,
+    uint8_t sequence_number,
+    uint8_t actual_window_size);
+/* segmented requests and ComplexACKs */
+BACNET_STACK_EXPORT
+bool tsm_segment_receive(
+    const BACNET_ADDRESS *src,
+    bool server,
+    uint8_t invoke_id,
+    uint8_t sequence_number,
+    uint8_t proposed_window_size,
+    bool more_follows,
+    const uint8_t *data,
+    uint16_t data_len,
+    uint8_t **message,
+    uint16_t *message_len);
+BACNET_STACK_EXPORT
+void tsm_segmented_message_free(
+    const BACNET_ADDRESS *src, bool server, uint8_t invoke_id);
+BACNET_STACK_EXPORT
+void tsm_segmented_abort_handler(
+    const BACNET_ADDRESS *src, bool server, uint8_t invoke_id);
+BACNET_STACK_EXPORT
+unsigned tsm_segmented_count(void);
+#endif
 
 #ifdef __cplusplus
 }
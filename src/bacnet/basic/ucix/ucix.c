@@ -10,6 +10,7 @@
 
 #include <uci_config.h>
 #include <uci.h>
+#include "bacnet/basic/sys/keyhash.h"
 #include "bacnet/basic/ucix/ucix.h"
 /*#include "log.h" */
 
@@ -247,6 +248,261 @@ void ucix_for_each_section_type(
         cb(e->name, priv);
 }
 
+/**
+ * @brief Call a function with each section of a type.  The sections are
+ *  visited in one walk of the package, and the function reads the options
+ *  with ucix_section_option(), so loading N sections does not look up
+ *  each section by name through the package again.  With a NULL function
+ *  the sections are only counted, for example to reserve the objects
+ *  with the *_Pool_Reserve() function of an object type before they are
+ *  created.
+ * @param ctx - UCI context
+ * @param p - package name
+ * @param t - section type
+ * @param cb - function called with each section
+ * @param priv - context passed to the function
+ * @return number of sections of the type
+ */
+int ucix_for_each_section(
+    struct uci_context *ctx,
+    const char *p,
+    const char *t,
+    ucix_section_callback cb,
+    void *priv)
+{
+    struct uci_package *package;
+    struct uci_section *s;
+    struct uci_element *e;
+    int count = 0;
+
+    if (ucix_get_ptr(ctx, p, NULL, NULL, NULL) || !ptr.p) {
+        return 0;
+    }
+    package = ptr.p;
+    uci_foreach_element(&package->sections, e)
+    {
+        s = uci_to_section(e);
+        if (strcmp(t, s->type) == 0) {
+            if (cb) {
+                cb(ctx, s, priv);
+            }
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Compare two options by name, type, and value
+ * @return true if the options are the same
+ */
+static bool ucix_option_same(struct uci_option *a, struct uci_option *b)
+{
+    struct uci_list *la, *lb;
+
+    if ((strcmp(a->e.name, b->e.name) != 0) || (a->type != b->type)) {
+        return false;
+    }
+    if (a->type == UCI_TYPE_STRING) {
+        return (strcmp(a->v.string, b->v.string) == 0);
+    }
+    la = a->v.list.next;
+    lb = b->v.list.next;
+    while ((la != &a->v.list) && (lb != &b->v.list)) {
+        if (strcmp(list_to_element(la)->name, list_to_element(lb)->name) !=
+            0) {
+            return false;
+        }
+        la = la->next;
+        lb = lb->next;
+    }
+
+    return (la == &a->v.list) && (lb == &b->v.list);
+}
+
+/**
+ * @brief Compare two sections by type and options, in order
+ * @return true if the sections are the same
+ */
+static bool ucix_section_same(struct uci_section *a, struct uci_section *b)
+{
+    struct uci_list *la, *lb;
+
+    if (strcmp(a->type, b->type) != 0) {
+        return false;
+    }
+    la = a->options.next;
+    lb = b->options.next;
+    while ((la != &a->options) && (lb != &b->options)) {
+        if (!ucix_option_same(
+                uci_to_option(list_to_element(la)),
+                uci_to_option(list_to_element(lb)))) {
+            return false;
+        }
+        la = la->next;
+        lb = lb->next;
+    }
+
+    return (la == &a->options) && (lb == &b->options);
+}
+
+/**
+ * @brief Call a function with each section of a type that was added or
+ *  changed since an earlier load of the same package, and with each
+ *  section that was removed, so that a reload only updates the objects
+ *  of the changed sections.  The earlier sections are indexed by a hash
+ *  of their name, so a reload takes one walk of each package.
+ * @param old_ctx - UCI context of the earlier load
+ * @param ctx - UCI context of the new load
+ * @param p - package name
+ * @param t - section type
+ * @param changed_cb - called with each added or changed section of ctx
+ * @param removed_cb - called with each removed section of old_ctx
+ * @param priv - context passed to the functions
+ * @return number of sections added, changed, or removed, or -1 on error
+ */
+int ucix_for_each_changed_section(
+    struct uci_context *old_ctx,
+    struct uci_context *ctx,
+    const char *p,
+    const char *t,
+    ucix_section_callback changed_cb,
+    ucix_section_callback removed_cb,
+    void *priv)
+{
+    struct uci_package *old_package = NULL, *package = NULL;
+    struct uci_section **old_sections = NULL;
+    struct uci_section *s;
+    struct uci_element *e;
+    bool *matched = NULL;
+    OS_Keyhash index = NULL;
+    unsigned old_count = 0, i = 0, iterator;
+    uint32_t hash;
+    KEY key;
+    bool found;
+    int count = 0;
+
+    if (!ucix_get_ptr(old_ctx, p, NULL, NULL, NULL)) {
+        old_package = ptr.p;
+    }
+    if (!ucix_get_ptr(ctx, p, NULL, NULL, NULL)) {
+        package = ptr.p;
+    }
+    if (old_package) {
+        uci_foreach_element(&old_package->sections, e)
+        {
+            if (strcmp(t, uci_to_section(e)->type) == 0) {
+                old_count++;
+            }
+        }
+    }
+    if (old_count > 0) {
+        old_sections = calloc(old_count, sizeof(*old_sections));
+        matched = calloc(old_count, sizeof(*matched));
+        index = Keyhash_Create();
+        if (!old_sections || !matched || !index) {
+            free(old_sections);
+            free(matched);
+            Keyhash_Delete(index);
+            return -1;
+        }
+        uci_foreach_element(&old_package->sections, e)
+        {
+            s = uci_to_section(e);
+            if (strcmp(t, s->type) == 0) {
+                old_sections[i] = s;
+                hash = Keyhash_FNV1a(e->name, strlen(e->name));
+                (void)Keyhash_Add(index, hash, i);
+                i++;
+            }
+        }
+    }
+    if (package) {
+        uci_foreach_element(&package->sections, e)
+        {
+            s = uci_to_section(e);
+            if (strcmp(t, s->type) != 0) {
+                continue;
+            }
+            found = false;
+            if (index) {
+                hash = Keyhash_FNV1a(e->name, strlen(e->name));
+                iterator = 0;
+                while (Keyhash_Find(index, hash, &iterator, &key)) {
+                    if (strcmp(old_sections[key]->e.name, e->name) == 0) {
+                        matched[key] = true;
+                        found = ucix_section_same(old_sections[key], s);
+                        break;
+                    }
+                }
+            }
+            if (!found) {
+                if (changed_cb) {
+                    changed_cb(ctx, s, priv);
+                }
+                count++;
+            }
+        }
+    }
+    for (i = 0; i < old_count; i++) {
+        if (!matched[i]) {
+            if (removed_cb) {
+                removed_cb(old_ctx, old_sections[i], priv);
+            }
+            count++;
+        }
+    }
+    free(old_sections);
+    free(matched);
+    Keyhash_Delete(index);
+
+    return count;
+}
+
+/**
+ * @brief Get the name of a section
+ * @param s - UCI section
+ * @return name of the section
+ */
+const char *ucix_section_name(const struct uci_section *s)
+{
+    return s->e.name;
+}
+
+/**
+ * @brief Get the value of an option of a section
+ * @param ctx - UCI context
+ * @param s - UCI section
+ * @param o - option name
+ * @return value of the option, or NULL if it is missing or a list
+ */
+const char *ucix_section_option(
+    struct uci_context *ctx, struct uci_section *s, const char *o)
+{
+    return uci_lookup_option_string(ctx, s, o);
+}
+
+/**
+ * @brief Get the integer value of an option of a section
+ * @param ctx - UCI context
+ * @param s - UCI section
+ * @param o - option name
+ * @param def - value when the option is missing
+ * @return value of the option
+ */
+int ucix_section_option_int(
+    struct uci_context *ctx, struct uci_section *s, const char *o, int def)
+{
+    const char *tmp = uci_lookup_option_string(ctx, s, o);
+    int ret = def;
+
+    if (tmp) {
+        ret = atoi(tmp);
+    }
+    return ret;
+}
+
 int ucix_commit(struct uci_context *ctx, const char *p)
 {
     if (ucix_get_ptr(ctx, p, NULL, NULL, NULL)) {
@@ -10,6 +10,14 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 
+struct uci_context;
+struct uci_section;
+
+/* Called with each section of a type, so that its options are read
+   from the section without looking the section up again by name */
+typedef void (*ucix_section_callback)(
+    struct uci_context *ctx, struct uci_section *s, void *priv);
+
 BACNET_STACK_EXPORT
 struct uci_context *ucix_init(const char *config_file);
 BACNET_STACK_EXPORT
@@ -77,4 +85,28 @@ void ucix_for_each_section_type(
     const char *t,
     void (*cb)(const char *, void *),
     void *priv);
+BACNET_STACK_EXPORT
+int ucix_for_each_section(
+    struct uci_context *ctx,
+    const char *p,
+    const char *t,
+    ucix_section_callback cb,
+    void *priv);
+BACNET_STACK_EXPORT
+int ucix_for_each_changed_section(
+    struct uci_context *old_ctx,
+    struct uci_context *ctx,
+    const char *p,
+    const char *t,
+    ucix_section_callback changed_cb,
+    ucix_section_callback removed_cb,
+    void *priv);
+BACNET_STACK_EXPORT
+const char *ucix_section_name(const struct uci_section *s);
+BACNET_STACK_EXPORT
+const char *ucix_section_option(
+    struct uci_context *ctx, struct uci_section *s, const char *o);
+BACNET_STACK_EXPORT
+int ucix_section_option_int(
+    struct uci_context *ctx, struct uci_section *s, const char *o, int def);
 #endif
@@ -0,0 +1,392 @@
+/**
+ * @file
+ * @brief A compact form of the primitive BACnet application values
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacstr.h"
+#include "bacnet/datetime.h"
+#include "bacnet/compact_value.h"
+
+/**
+ * @brief Initialize a compact value to Null
+ * @param value - compact value to initialize
+ */
+void bacnet_compact_value_init(BACNET_COMPACT_VALUE *value)
+{
+    if (value) {
+        memset(value, 0, sizeof(*value));
+        value->tag = BACNET_APPLICATION_TAG_NULL;
+    }
+}
+
+/**
+ * @brief Release the heap buffer of a compact value, if any, and leave
+ *  the value as Null
+ * @param value - compact value to release
+ */
+void bacnet_compact_value_free(BACNET_COMPACT_VALUE *value)
+{
+    if (value) {
+        if (value->heap) {
+            free(value->type.Heap);
+        }
+        bacnet_compact_value_init(value);
+    }
+}
+
+/**
+ * @brief Get the octets of a string or bit string compact value
+ * @param value - compact value
+ * @return the octets, wherever they are kept, or NULL if there are none
+ */
+const uint8_t *bacnet_compact_value_octets(const BACNET_COMPACT_VALUE *value)
+{
+    if (!value || (value->length == 0)) {
+        return NULL;
+    }
+    if (value->heap) {
+        return value->type.Heap;
+    }
+
+    return value->type.Inline;
+}
+
+/**
+ * @brief Store the octets of a string or bit string in a compact value
+ * @param value - compact value, without octets
+ * @param octets - octets to store
+ * @param length - number of octets
+ * @return true if the octets were stored
+ */
+static bool bacnet_compact_value_octets_set(
+    BACNET_COMPACT_VALUE *value, const uint8_t *octets, size_t length)
+{
+    if (length > UINT16_MAX) {
+        return false;
+    }
+    if (length > BACNET_COMPACT_VALUE_INLINE_SIZE) {
+        value->type.Heap = malloc(length);
+        if (!value->type.Heap) {
+            return false;
+        }
+        value->heap = true;
+        memcpy(value->type.Heap, octets, length);
+    } else if (length > 0) {
+        memcpy(value->type.Inline, octets, length);
+    }
+    value->length = (uint16_t)length;
+
+    return true;
+}
+
+/**
+ * @brief Convert an application value into a compact value
+ * @param dest - compact value, which is overwritten. A heap buffer that
+ *  it holds is not released, so use bacnet_compact_value_free() first.
+ * @param src - application value of a primitive datatype
+ * @return true if converted, or false if the datatype is not primitive
+ *  or the heap buffer could not be allocated
+ */
+bool bacnet_compact_value_from_application(
+    BACNET_COMPACT_VALUE *dest, const BACNET_APPLICATION_DATA_VALUE *src)
+{
+    const uint8_t *octets = NULL;
+    size_t length = 0;
+
+    if (!dest || !src) {
+        return false;
+    }
+    bacnet_compact_value_init(dest);
+    switch (src->tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            break;
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            dest->type.Boolean = src->type.Boolean;
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            dest->type.Unsigned_Int = src->type.Unsigned_Int;
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            dest->type.Signed_Int = src->type.Signed_Int;
+            break;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            dest->type.Real = src->type.Real;
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            dest->type.Double = src->type.Double;
+            break;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            octets = src->type.Octet_String.value;
+            length = src->type.Octet_String.length;
+            break;
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            octets = (const uint8_t *)src->type.Character_String.value;
+            length = src->type.Character_String.length;
+            dest->encoding = src->type.Character_String.encoding;
+            break;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            octets = src->type.Bit_String.value;
+            length = bitstring_bytes_used(&src->type.Bit_String);
+            dest->encoding = bitstring_bits_used(&src->type.Bit_String);
+            break;
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            dest->type.Enumerated = src->type.Enumerated;
+            break;
+#endif
+#if defined(BACAPP_DATE)
+        case BACNET_APPLICATION_TAG_DATE:
+            datetime_copy_date(&dest->type.Date, &src->type.Date);
+            break;
+#endif
+#if defined(BACAPP_TIME)
+        case BACNET_APPLICATION_TAG_TIME:
+            datetime_copy_time(&dest->type.Time, &src->type.Time);
+            break;
+#endif
+#if defined(BACAPP_OBJECT_ID)
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            dest->type.Object_Id.type = src->type.Object_Id.type;
+            dest->type.Object_Id.instance = src->type.Object_Id.instance;
+            break;
+#endif
+        default:
+            return false;
+    }
+    if (!bacnet_compact_value_octets_set(dest, octets, length)) {
+        bacnet_compact_value_init(dest);
+        return false;
+    }
+    dest->tag = src->tag;
+    dest->context_specific = src->context_specific;
+    dest->context_tag = src->context_tag;
+
+    return true;
+}
+
+/**
+ * @brief Convert a compact value into an application value
+ * @param dest - application value, which is overwritten
+ * @param src - compact value
+ * @return true if converted, or false if the string does not fit
+ */
+bool bacnet_compact_value_to_application(
+    BACNET_APPLICATION_DATA_VALUE *dest, const BACNET_COMPACT_VALUE *src)
+{
+    const uint8_t *octets;
+    bool status = true;
+    uint16_t i;
+
+    if (!dest || !src) {
+        return false;
+    }
+    octets = bacnet_compact_value_octets(src);
+    switch (src->tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            break;
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            dest->type.Boolean = src->type.Boolean;
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            dest->type.Unsigned_Int = src->type.Unsigned_Int;
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            dest->type.Signed_Int = src->type.Signed_Int;
+            break;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            dest->type.Real = src->type.Real;
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            dest->type.Double = src->type.Double;
+            break;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            status = octetstring_init(
+                &dest->type.Octet_String, octets, src->length);
+            break;
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            status = characterstring_init(
+                &dest->type.Character_String, src->encoding,
+                (const char *)octets, src->length);
+            break;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            bitstring_init(&dest->type.Bit_String);
+            if (src->length > MAX_BITSTRING_BYTES) {
+                status = false;
+                break;
+            }
+            for (i = 0; i < src->length; i++) {
+                bitstring_set_octet(&dest->type.Bit_String, i, octets[i]);
+            }
+            bitstring_bits_used_set(&dest->type.Bit_String, src->encoding);
+            break;
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            dest->type.Enumerated = src->type.Enumerated;
+            break;
+#endif
+#if defined(BACAPP_DATE)
+        case BACNET_APPLICATION_TAG_DATE:
+            datetime_copy_date(&dest->type.Date, &src->type.Date);
+            break;
+#endif
+#if defined(BACAPP_TIME)
+        case BACNET_APPLICATION_TAG_TIME:
+            datetime_copy_time(&dest->type.Time, &src->type.Time);
+            break;
+#endif
+#if defined(BACAPP_OBJECT_ID)
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            dest->type.Object_Id.type = src->type.Object_Id.type;
+            dest->type.Object_Id.instance = src->type.Object_Id.instance;
+            break;
+#endif
+        default:
+            status = false;
+            break;
+    }
+    if (status) {
+        dest->tag = src->tag;
+        dest->context_specific = src->context_specific;
+        dest->context_tag = src->context_tag;
+        dest->next = NULL;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Copy a compact value, with its own heap buffer if needed
+ * @param dest - compact value, which is overwritten. A heap buffer that
+ *  it holds is not released, so use bacnet_compact_value_free() first.
+ * @param src - compact value to copy
+ * @return true if copied, or false if the heap buffer could not be
+ *  allocated
+ */
+bool bacnet_compact_value_copy(
+    BACNET_COMPACT_VALUE *dest, const BACNET_COMPACT_VALUE *src)
+{
+    if (!dest || !src) {
+        return false;
+    }
+    memcpy(dest, src, sizeof(*dest));
+    if (src->heap) {
+        dest->heap = false;
+        if (!bacnet_compact_value_octets_set(
+                dest, src->type.Heap, src->length)) {
+            bacnet_compact_value_init(dest);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compare two compact values
+ * @param value1 - compact value
+ * @param value2 - compact value
+ * @return true if the values are the same
+ */
+bool bacnet_compact_value_same(
+    const BACNET_COMPACT_VALUE *value1, const BACNET_COMPACT_VALUE *value2)
+{
+    if (!value1 || !value2) {
+        return false;
+    }
+    if ((value1->tag != value2->tag) ||
+        (value1->context_specific != value2->context_specific) ||
+        (value1->context_specific &&
+         (value1->context_tag != value2->context_tag))) {
+        return false;
+    }
+    switch (value1->tag) {
+        case BACNET_APPLICATION_TAG_NULL:
+            return true;
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            return value1->type.Boolean == value2->type.Boolean;
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            return value1->type.Unsigned_Int == value2->type.Unsigned_Int;
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            return value1->type.Signed_Int == value2->type.Signed_Int;
+        case BACNET_APPLICATION_TAG_REAL:
+            return !islessgreater(value1->type.Real, value2->type.Real);
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            return !islessgreater(value1->type.Double, value2->type.Double);
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            return value1->type.Enumerated == value2->type.Enumerated;
+        case BACNET_APPLICATION_TAG_DATE:
+            return datetime_compare_date(
+                       &value1->type.Date, &value2->type.Date) == 0;
+        case BACNET_APPLICATION_TAG_TIME:
+            return datetime_compare_time(
+                       &value1->type.Time, &value2->type.Time) == 0;
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            return (value1->type.Object_Id.type ==
+                    value2->type.Object_Id.type) &&
+                (value1->type.Object_Id.instance ==
+                 value2->type.Object_Id.instance);
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            if ((value1->encoding != value2->encoding) ||
+                (value1->length != value2->length)) {
+                return false;
+            }
+            if (value1->length == 0) {
+                return true;
+            }
+            return memcmp(
+                       bacnet_compact_value_octets(value1),
+                       bacnet_compact_value_octets(value2),
+                       value1->length) == 0;
+        default:
+            break;
+    }
+
+    return false;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @brief API for a compact form of the primitive BACnet application values
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_COMPACT_VALUE_H
+#define BACNET_COMPACT_VALUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/datetime.h"
+
+/* octets of a string or bit string that are kept in the value itself.
+   Longer strings are kept in a heap buffer. */
+#ifndef BACNET_COMPACT_VALUE_INLINE_SIZE
+#define BACNET_COMPACT_VALUE_INLINE_SIZE 16
+#endif
+
+/* A primitive application value, for caches and lists that hold many
+   values. It holds the same data as BACNET_APPLICATION_DATA_VALUE for
+   the primitive datatypes, without the fixed size string buffers. */
+typedef struct BACnet_Compact_Value {
+    uint8_t tag; /* application tag data type */
+    uint8_t context_tag; /* only used for context specific data */
+    bool context_specific : 1; /* true if context specific data */
+    bool heap : 1; /* true if the octets are in type.Heap */
+    /* character set of a character string, or bits used of a bit string */
+    uint8_t encoding;
+    /* number of octets of a string or bit string */
+    uint16_t length;
+    union {
+        bool Boolean;
+        BACNET_UNSIGNED_INTEGER Unsigned_Int;
+        int32_t Signed_Int;
+        float Real;
+        double Double;
+        uint32_t Enumerated;
+        BACNET_DATE Date;
+        BACNET_TIME Time;
+        BACNET_OBJECT_ID Object_Id;
+        uint8_t Inline[BACNET_COMPACT_VALUE_INLINE_SIZE];
+        uint8_t *Heap;
+    } type;
+} BACNET_COMPACT_VALUE;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_compact_value_init(BACNET_COMPACT_VALUE *value);
+BACNET_STACK_EXPORT
+void bacnet_compact_value_free(BACNET_COMPACT_VALUE *value);
+
+BACNET_STACK_EXPORT
+bool bacnet_compact_value_from_application(
+    BACNET_COMPACT_VALUE *dest, const BACNET_APPLICATION_DATA_VALUE *src);
+BACNET_STACK_EXPORT
+bool bacnet_compact_value_to_application(
+    BACNET_APPLICATION_DATA_VALUE *dest, const BACNET_COMPACT_VALUE *src);
+
+BACNET_STACK_EXPORT
+bool bacnet_compact_value_copy(
+    BACNET_COMPACT_VALUE *dest, const BACNET_COMPACT_VALUE *src);
+BACNET_STACK_EXPORT
+bool bacnet_compact_value_same(
+    const BACNET_COMPACT_VALUE *value1, const BACNET_COMPACT_VALUE *value2);
+
+BACNET_STACK_EXPORT
+const uint8_t *bacnet_compact_value_octets(const BACNET_COMPACT_VALUE *value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -40,6 +40,8 @@
 #define BACDL_BSC
 #undef BACDL_ZIGBEE
 #define BACDL_ZIGBEE
+#undef BACDL_LOOPBACK
+#define BACDL_LOOPBACK
 #endif
 
 #if defined(BACDL_ETHERNET)
@@ -88,6 +90,13 @@
 #define BACDL_SOME_DATALINK_ENABLED 1
 #endif
 
+#if defined(BACDL_LOOPBACK)
+#if defined(BACDL_SOME_DATALINK_ENABLED)
+#define BACDL_MULTIPLE 1
+#endif
+#define BACDL_SOME_DATALINK_ENABLED 1
+#endif
+
 #if defined(BACDL_CUSTOM)
 #if defined(BACDL_SOME_DATALINK_ENABLED)
 #define BACDL_MULTIPLE 1
@@ -156,7 +165,13 @@
 #define MAX_APDU 480
 #elif defined(BACDL_MSTP) && !defined(BACNET_SECURITY)
 /* note: MS/TP extended frames can be up to 1476 bytes */
+#if defined(BACNET_MSTP_EXTENDED_FRAMES)
+/* the larger PDUs are sent in extended frames to the stations that
+   accept them, and are refused for the stations known to not */
+#define MAX_APDU 1476
+#else
 #define MAX_APDU 480
+#endif
 #elif defined(BACDL_ETHERNET) && !defined(BACNET_SECURITY)
 #define MAX_APDU 1476
 #elif defined(BACDL_ETHERNET) && defined(BACNET_SECURITY)
@@ -175,15 +190,44 @@
 #ifndef BACNET_SEGMENTATION_ENABLED
 #define BACNET_SEGMENTATION_ENABLED 0
 #endif
+#if BACNET_SEGMENTATION_ENABLED
+/* the number of segmented messages that are sent or received */
+/* at the same time.  Each one has a buffer of MAX_ASDU octets. */
+#if !defined(MAX_TSM_SEGMENTED_TRANSACTIONS)
+#define MAX_TSM_SEGMENTED_TRANSACTIONS 2
+#endif
+/* the largest window of segments that we accept, 1..127 */
+#if !defined(MAX_TSM_SEGMENT_WINDOW)
+#define MAX_TSM_SEGMENT_WINDOW 16
+#endif
+/* the number of segments received ahead of a missing segment */
+/* that are kept by each segmented message until it arrives */
+#if !defined(MAX_TSM_SEGMENTS_OUT_OF_ORDER)
+#define MAX_TSM_SEGMENTS_OUT_OF_ORDER 4
+#endif
+#endif
 
 /* for confirmed messages, this is the number of transactions */
 /* that we hold in a queue waiting for timeout. */
 /* Configure to zero if you don't want any confirmed messages */
-/* Configure from 1..255 for number of outstanding confirmed */
-/* requests available. */
+/* Configure from 1..65535 for number of outstanding confirmed */
+/* requests available.  Invoke IDs from tsm_next_free_invokeID() */
+/* are unique among all the peers, so at most 255 of those are */
+/* outstanding, while invoke IDs from tsm_next_free_invokeID_peer() */
+/* are only unique for each peer. */
 #if !defined(MAX_TSM_TRANSACTIONS)
 #define MAX_TSM_TRANSACTIONS 255
 #endif
+/* the number of peers that can have transactions using invoke IDs */
+/* from tsm_next_free_invokeID_peer() at the same time */
+#if !defined(MAX_TSM_PEERS)
+#define MAX_TSM_PEERS MAX_TSM_TRANSACTIONS
+#endif
+/* the default number of outstanding confirmed requests to one peer, */
+/* from 1..255, for invoke IDs from tsm_next_free_invokeID_peer() */
+#if !defined(MAX_TSM_PEER_WINDOW)
+#define MAX_TSM_PEER_WINDOW 255
+#endif
 /* The address cache is used for binding to BACnet devices */
 /* The number of entries corresponds to the number of */
 /* devices that might respond to an I-Am on the network. */
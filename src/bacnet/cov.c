@@ -6,6 +6,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -21,21 +22,22 @@ COV Notification
 Unconfirmed COV Notification
 */
 
+/* callback for objects reporting a change of value */
+static cov_change_of_value_callback COV_Change_Of_Value_Callback;
+/* other functions called for objects reporting a change of value */
+static COV_CHANGE_OF_VALUE_LISTENER *COV_Change_Of_Value_Listeners;
+
 /**
- * @brief Encode APDU for COV Notification.
+ * @brief Encode the COV Notification up to the list of values
  * @param apdu  Pointer to the buffer, or NULL for length
  * @param data  Pointer to the data to encode.
- * @return number of bytes encoded, or zero on error.
+ * @return number of bytes encoded
  */
-int cov_notify_encode_apdu(uint8_t *apdu, const BACNET_COV_DATA *data)
+static int cov_notify_encode_header(uint8_t *apdu, const BACNET_COV_DATA *data)
 {
     int len = 0; /* length of each encoding */
     int apdu_len = 0; /* total length of the apdu, return value */
-    const BACNET_PROPERTY_VALUE *value = NULL; /* value in list */
 
-    if (!data) {
-        return 0;
-    }
     /* tag 0 - subscriberProcessIdentifier */
     len = encode_context_unsigned(apdu, 0, data->subscriberProcessIdentifier);
     apdu_len += len;
@@ -60,9 +62,25 @@ int cov_notify_encode_apdu(uint8_t *apdu, const BACNET_COV_DATA *data)
     /* tag 3 - timeRemaining */
     len = encode_context_unsigned(apdu, 3, data->timeRemaining);
     apdu_len += len;
-    if (apdu) {
-        apdu += len;
-    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the list of values of a COV Notification, so that it can
+ *  be encoded once and sent to each subscriber of the object with
+ *  ccov_notify_encode_apdu_values() or ucov_notify_encode_apdu_values()
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param value_list  Pointer to the first value in the list, or NULL
+ * @return number of bytes encoded
+ */
+int cov_notify_value_list_encode(
+    uint8_t *apdu, const BACNET_PROPERTY_VALUE *value_list)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+    const BACNET_PROPERTY_VALUE *value = NULL; /* value in list */
+
     /* tag 4 - listOfValues */
     len = encode_opening_tag(apdu, 4);
     apdu_len += len;
@@ -70,7 +88,7 @@ int cov_notify_encode_apdu(uint8_t *apdu, const BACNET_COV_DATA *data)
         apdu += len;
     }
     /* the first value includes a pointer to the next value, etc */
-    value = data->listOfValues;
+    value = value_list;
     while (value != NULL) {
         len = bacapp_property_value_encode(apdu, value);
         apdu_len += len;
@@ -86,6 +104,67 @@ int cov_notify_encode_apdu(uint8_t *apdu, const BACNET_COV_DATA *data)
     return apdu_len;
 }
 
+/**
+ * @brief Encode APDU for COV Notification.
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param data  Pointer to the data to encode.
+ * @return number of bytes encoded, or zero on error.
+ */
+int cov_notify_encode_apdu(uint8_t *apdu, const BACNET_COV_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+
+    if (!data) {
+        return 0;
+    }
+    len = cov_notify_encode_header(apdu, data);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_notify_value_list_encode(apdu, data->listOfValues);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the COVNotification service request with a list of
+ *  values that was encoded with cov_notify_value_list_encode().
+ *  The listOfValues of the service data is not used.
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param apdu_size number of bytes available in the buffer
+ * @param data  Pointer to the service data used for encoding values
+ * @param values  Pointer to the encoded list of values
+ * @param values_len  Number of bytes in the encoded list of values
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+static size_t cov_notify_service_request_encode_values(
+    uint8_t *apdu,
+    size_t apdu_size,
+    const BACNET_COV_DATA *data,
+    const uint8_t *values,
+    size_t values_len)
+{
+    size_t apdu_len = 0; /* total length of the apdu, return value */
+
+    if (!data || !values) {
+        return 0;
+    }
+    apdu_len = cov_notify_encode_header(NULL, data);
+    if ((apdu_len + values_len) > apdu_size) {
+        return 0;
+    }
+    if (apdu) {
+        apdu_len = cov_notify_encode_header(apdu, data);
+        memcpy(&apdu[apdu_len], values, values_len);
+    }
+    apdu_len += values_len;
+
+    return apdu_len;
+}
+
 /**
  * @brief Encode the COVNotification service request
  * @param apdu  Pointer to the buffer for encoding into
@@ -180,6 +259,90 @@ int ucov_notify_encode_apdu(
     return apdu_len;
 }
 
+/**
+ * @brief Encode APDU for confirmed notification with a list of values
+ *  that was encoded with cov_notify_value_list_encode()
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param apdu_size number of bytes available in the buffer
+ * @param invoke_id  ID to invoke for notification
+ * @param data  Pointer to the service data, without the listOfValues
+ * @param values  Pointer to the encoded list of values
+ * @param values_len  Number of bytes in the encoded list of values
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+int ccov_notify_encode_apdu_values(
+    uint8_t *apdu,
+    unsigned apdu_size,
+    uint8_t invoke_id,
+    const BACNET_COV_DATA *data,
+    const uint8_t *values,
+    size_t values_len)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* return value */
+
+    if (apdu_size < 4) {
+        return 0;
+    }
+    if (apdu) {
+        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+        apdu[2] = invoke_id;
+        apdu[3] = SERVICE_CONFIRMED_COV_NOTIFICATION;
+        apdu += 4;
+    }
+    apdu_len = 4;
+    len = cov_notify_service_request_encode_values(
+        apdu, apdu_size - apdu_len, data, values, values_len);
+    if (len > 0) {
+        apdu_len += len;
+    } else {
+        apdu_len = 0;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode APDU for unconfirmed notification with a list of values
+ *  that was encoded with cov_notify_value_list_encode()
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param apdu_size number of bytes available in the buffer
+ * @param data  Pointer to the service data, without the listOfValues
+ * @param values  Pointer to the encoded list of values
+ * @param values_len  Number of bytes in the encoded list of values
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+int ucov_notify_encode_apdu_values(
+    uint8_t *apdu,
+    unsigned apdu_size,
+    const BACNET_COV_DATA *data,
+    const uint8_t *values,
+    size_t values_len)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* return value */
+
+    if (apdu_size < 2) {
+        return 0;
+    }
+    if (apdu) {
+        apdu[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+        apdu[1] = SERVICE_UNCONFIRMED_COV_NOTIFICATION;
+        apdu += 2;
+    }
+    apdu_len = 2;
+    len = cov_notify_service_request_encode_values(
+        apdu, apdu_size - apdu_len, data, values, values_len);
+    if (len > 0) {
+        apdu_len += len;
+    } else {
+        apdu_len = 0;
+    }
+
+    return apdu_len;
+}
+
 /**
  * @brief Decode the COV-service request only.
  *
@@ -300,6 +463,440 @@ int cov_notify_decode_service_request(
     return len;
 }
 
+/*
+ConfirmedCOVNotificationMultiple-Request ::= SEQUENCE {
+    subscriber-process-identifier [0] Unsigned32,
+    initiating-device-identifier [1] BACnetObjectIdentifier,
+    time-remaining [2] Unsigned,
+    timestamp [3] BACnetDateTime OPTIONAL,
+    list-of-cov-notifications [4] SEQUENCE OF SEQUENCE {
+        monitored-object-identifier [0] BACnetObjectIdentifier,
+        list-of-values [1] SEQUENCE OF SEQUENCE {
+            property-identifier [0] BACnetPropertyIdentifier,
+            property-array-index [1] Unsigned OPTIONAL,
+            value [2] ABSTRACT-SYNTAX.&Type,
+            time-of-change [3] Time OPTIONAL
+        }
+    }
+}
+The UnconfirmedCOVNotificationMultiple-Request is the same.
+*/
+
+/**
+ * @brief Encode the beginning of the COVNotificationMultiple service
+ *  request, up to and including the opening of the list of notifications.
+ *  The timestamp is not encoded.
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param data  Pointer to the service data with the subscriber process
+ *  identifier, the initiating device identifier, and the time remaining
+ * @return number of bytes encoded
+ */
+int cov_notify_multiple_encode_init(uint8_t *apdu, const BACNET_COV_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+
+    if (!data) {
+        return 0;
+    }
+    /* tag 0 - subscriberProcessIdentifier */
+    len = encode_context_unsigned(apdu, 0, data->subscriberProcessIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 1 - initiatingDeviceIdentifier */
+    len = encode_context_object_id(
+        apdu, 1, OBJECT_DEVICE, data->initiatingDeviceIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 2 - timeRemaining */
+    len = encode_context_unsigned(apdu, 2, data->timeRemaining);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 4 - listOfCOVNotifications */
+    len = encode_opening_tag(apdu, 4);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the notification of one object within
+ *  the COVNotificationMultiple service request.
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param data  Pointer to the service data with the monitored object
+ *  identifier and the list of values
+ * @return number of bytes encoded
+ */
+int cov_notify_multiple_encode_object(
+    uint8_t *apdu, const BACNET_COV_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+    const BACNET_PROPERTY_VALUE *value = NULL; /* value in list */
+    const BACNET_APPLICATION_DATA_VALUE *app_data = NULL;
+
+    if (!data) {
+        return 0;
+    }
+    /* tag 0 - monitoredObjectIdentifier */
+    len = encode_context_object_id(
+        apdu, 0, data->monitoredObjectIdentifier.type,
+        data->monitoredObjectIdentifier.instance);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 1 - listOfValues */
+    len = encode_opening_tag(apdu, 1);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* the first value includes a pointer to the next value, etc */
+    value = data->listOfValues;
+    while (value != NULL) {
+        /* tag 0 - propertyIdentifier */
+        len = encode_context_enumerated(apdu, 0, value->propertyIdentifier);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        /* tag 1 - propertyArrayIndex OPTIONAL */
+        if (value->propertyArrayIndex != BACNET_ARRAY_ALL) {
+            len = encode_context_unsigned(apdu, 1, value->propertyArrayIndex);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        /* tag 2 - value */
+        len = encode_opening_tag(apdu, 2);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        app_data = &value->value;
+        while (app_data != NULL) {
+            len = bacapp_encode_application_data(apdu, app_data);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+            app_data = app_data->next;
+        }
+        len = encode_closing_tag(apdu, 2);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        /* is there another one to encode? */
+        value = value->next;
+    }
+    len = encode_closing_tag(apdu, 1);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the end of the COVNotificationMultiple service request
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @return number of bytes encoded
+ */
+int cov_notify_multiple_encode_end(uint8_t *apdu)
+{
+    /* tag 4 - listOfCOVNotifications */
+    return encode_closing_tag(apdu, 4);
+}
+
+/**
+ * @brief Encode the beginning of the APDU for a confirmed
+ *  COVNotificationMultiple, up to the first object notification
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param invoke_id  ID to invoke for notification
+ * @param data  Pointer to the service data used for encoding values
+ * @return number of bytes encoded
+ */
+int ccov_notify_multiple_encode_apdu_init(
+    uint8_t *apdu, uint8_t invoke_id, const BACNET_COV_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* return value */
+
+    if (apdu) {
+        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+        apdu[2] = invoke_id;
+        apdu[3] = SERVICE_CONFIRMED_COV_NOTIFICATION_MULTIPLE;
+    }
+    len = 4;
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_notify_multiple_encode_init(apdu, data);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the beginning of the APDU for an unconfirmed
+ *  COVNotificationMultiple, up to the first object notification
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param data  Pointer to the service data used for encoding values
+ * @return number of bytes encoded
+ */
+int ucov_notify_multiple_encode_apdu_init(
+    uint8_t *apdu, const BACNET_COV_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* return value */
+
+    if (apdu) {
+        apdu[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+        apdu[1] = SERVICE_UNCONFIRMED_COV_NOTIFICATION_MULTIPLE;
+    }
+    len = 2;
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_notify_multiple_encode_init(apdu, data);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode the beginning of the COVNotificationMultiple service
+ *  request, up to and including the opening of the list of notifications.
+ *  The timestamp is skipped.
+ * @param apdu  Pointer to the buffer.
+ * @param apdu_size  Number of valid bytes in the buffer.
+ * @param data  Pointer to the data to store the subscriber process
+ *  identifier, the initiating device identifier, and the time remaining,
+ *  or NULL for length
+ * @return Bytes decoded or BACNET_STATUS_ERROR on error.
+ */
+int cov_notify_multiple_decode_init(
+    const uint8_t *apdu, unsigned apdu_size, BACNET_COV_DATA *data)
+{
+    int len = 0; /* return value */
+    int value_len = 0, tag_len = 0;
+    BACNET_UNSIGNED_INTEGER decoded_value = 0;
+    BACNET_OBJECT_TYPE decoded_type = OBJECT_NONE;
+    uint32_t decoded_instance = 0;
+
+    if (!apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    /* subscriber-process-identifier [0] Unsigned32 */
+    value_len = bacnet_unsigned_context_decode(
+        &apdu[len], apdu_size - len, 0, &decoded_value);
+    if ((value_len > 0) && (decoded_value <= UINT32_MAX)) {
+        if (data) {
+            data->subscriberProcessIdentifier = decoded_value;
+        }
+        len += value_len;
+    } else {
+        return BACNET_STATUS_ERROR;
+    }
+    /* initiating-device-identifier [1] BACnetObjectIdentifier */
+    value_len = bacnet_object_id_context_decode(
+        &apdu[len], apdu_size - len, 1, &decoded_type, &decoded_instance);
+    if ((value_len > 0) && (decoded_type == OBJECT_DEVICE)) {
+        if (data) {
+            data->initiatingDeviceIdentifier = decoded_instance;
+        }
+        len += value_len;
+    } else {
+        return BACNET_STATUS_ERROR;
+    }
+    /* time-remaining [2] Unsigned */
+    value_len = bacnet_unsigned_context_decode(
+        &apdu[len], apdu_size - len, 2, &decoded_value);
+    if ((value_len > 0) && (decoded_value <= UINT32_MAX)) {
+        if (data) {
+            data->timeRemaining = decoded_value;
+        }
+        len += value_len;
+    } else {
+        return BACNET_STATUS_ERROR;
+    }
+    /* timestamp [3] BACnetDateTime OPTIONAL */
+    if (bacnet_is_opening_tag_number(
+            &apdu[len], apdu_size - len, 3, &tag_len)) {
+        value_len = bacnet_enclosed_data_length(&apdu[len], apdu_size - len);
+        if (value_len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        len += tag_len + value_len;
+        if (bacnet_is_closing_tag_number(
+                &apdu[len], apdu_size - len, 3, &tag_len)) {
+            len += tag_len;
+        } else {
+            return BACNET_STATUS_ERROR;
+        }
+    }
+    /* list-of-cov-notifications [4] */
+    if (bacnet_is_opening_tag_number(
+            &apdu[len], apdu_size - len, 4, &tag_len)) {
+        len += tag_len;
+    } else {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Decode the notification of one object within
+ *  the COVNotificationMultiple service request.  Any time of change
+ *  of a value is skipped.
+ * @param apdu  Pointer to the buffer.
+ * @param apdu_size  Number of valid bytes in the buffer.
+ * @param data  Pointer to the data to store the monitored object identifier
+ *  and the list of values, or NULL for length
+ * @return Bytes decoded, zero at the end of the list of notifications,
+ *  or BACNET_STATUS_ERROR on error.
+ */
+int cov_notify_multiple_decode_object(
+    const uint8_t *apdu, unsigned apdu_size, BACNET_COV_DATA *data)
+{
+    int len = 0; /* return value */
+    int value_len = 0, tag_len = 0;
+    uint32_t len_value_type = 0;
+    uint32_t enumerated_value = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    BACNET_OBJECT_TYPE decoded_type = OBJECT_NONE;
+    uint32_t decoded_instance = 0;
+    BACNET_PROPERTY_VALUE *value = NULL;
+    BACNET_APPLICATION_DATA_VALUE *app_data = NULL;
+
+    if (!apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (bacnet_is_closing_tag_number(apdu, apdu_size, 4, &tag_len)) {
+        /* end of the list of notifications */
+        return 0;
+    }
+    /* monitored-object-identifier [0] BACnetObjectIdentifier */
+    value_len = bacnet_object_id_context_decode(
+        &apdu[len], apdu_size - len, 0, &decoded_type, &decoded_instance);
+    if (value_len > 0) {
+        if (data) {
+            data->monitoredObjectIdentifier.type = decoded_type;
+            data->monitoredObjectIdentifier.instance = decoded_instance;
+        }
+        len += value_len;
+    } else {
+        return BACNET_STATUS_ERROR;
+    }
+    /* list-of-values [1] */
+    if (!bacnet_is_opening_tag_number(
+            &apdu[len], apdu_size - len, 1, &tag_len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (!data) {
+        value_len = bacnet_enclosed_data_length(&apdu[len], apdu_size - len);
+        if (value_len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        len += tag_len + value_len;
+        if (bacnet_is_closing_tag_number(
+                &apdu[len], apdu_size - len, 1, &tag_len)) {
+            return len + tag_len;
+        }
+        return BACNET_STATUS_ERROR;
+    }
+    len += tag_len;
+    /* the first value includes a pointer to the next value, etc */
+    value = data->listOfValues;
+    while (!bacnet_is_closing_tag_number(
+        &apdu[len], apdu_size - len, 1, &tag_len)) {
+        if (value == NULL) {
+            /* out of room to store next value */
+            return BACNET_STATUS_ERROR;
+        }
+        /* property-identifier [0] BACnetPropertyIdentifier */
+        value_len = bacnet_enumerated_context_decode(
+            &apdu[len], apdu_size - len, 0, &enumerated_value);
+        if (value_len > 0) {
+            value->propertyIdentifier = enumerated_value;
+            len += value_len;
+        } else {
+            return BACNET_STATUS_ERROR;
+        }
+        /* property-array-index [1] Unsigned OPTIONAL */
+        value->propertyArrayIndex = BACNET_ARRAY_ALL;
+        if (bacnet_is_context_tag_number(
+                &apdu[len], apdu_size - len, 1, &tag_len, &len_value_type)) {
+            len += tag_len;
+            value_len = bacnet_unsigned_decode(
+                &apdu[len], apdu_size - len, len_value_type, &unsigned_value);
+            if ((value_len > 0) && (unsigned_value <= UINT32_MAX)) {
+                value->propertyArrayIndex = unsigned_value;
+                len += value_len;
+            } else {
+                return BACNET_STATUS_ERROR;
+            }
+        }
+        /* value [2] ABSTRACT-SYNTAX.&Type */
+        if (!bacnet_is_opening_tag_number(
+                &apdu[len], apdu_size - len, 2, &tag_len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        len += tag_len;
+        app_data = &value->value;
+        while (app_data != NULL) {
+            value_len = bacapp_decode_known_array_property(
+                &apdu[len], apdu_size - len, app_data, decoded_type,
+                value->propertyIdentifier, value->propertyArrayIndex);
+            if (value_len < 0) {
+                return BACNET_STATUS_ERROR;
+            }
+            len += value_len;
+            if (bacnet_is_closing_tag_number(
+                    &apdu[len], apdu_size - len, 2, &tag_len)) {
+                break;
+            }
+            app_data = app_data->next;
+        }
+        if (bacnet_is_closing_tag_number(
+                &apdu[len], apdu_size - len, 2, &tag_len)) {
+            len += tag_len;
+        } else {
+            return BACNET_STATUS_ERROR;
+        }
+        /* time-of-change [3] Time OPTIONAL */
+        if (bacnet_is_context_tag_number(
+                &apdu[len], apdu_size - len, 3, &tag_len, &len_value_type)) {
+            if (len_value_type > (apdu_size - len - tag_len)) {
+                return BACNET_STATUS_ERROR;
+            }
+            len += tag_len + len_value_type;
+        }
+        value->priority = BACNET_NO_PRIORITY;
+        /* is there another one to decode? */
+        if (bacnet_is_closing_tag_number(
+                &apdu[len], apdu_size - len, 1, &tag_len)) {
+            value->next = NULL;
+        } else {
+            value = value->next;
+        }
+    }
+    len += tag_len;
+
+    return len;
+}
+
 /*
 12.11.38Active_COV_Subscriptions
 The Active_COV_Subscriptions property is a List of BACnetCOVSubscription,
@@ -880,6 +1477,31 @@ void cov_data_value_list_link(
     }
 }
 
+/**
+ * @brief Set the Status-Flags, as the Value Lists encode them
+ * @param status_flags - [out] the Status-Flags bit string
+ * @param in_alarm - value of in-alarm status-flags
+ * @param fault - value of fault status-flags
+ * @param overridden - value of overridden status-flags
+ * @param out_of_service - value of out-of-service status-flags
+ */
+void cov_status_flags_set(
+    BACNET_BIT_STRING *status_flags,
+    bool in_alarm,
+    bool fault,
+    bool overridden,
+    bool out_of_service)
+{
+    if (status_flags) {
+        bitstring_init(status_flags);
+        bitstring_set_bit(status_flags, STATUS_FLAG_IN_ALARM, in_alarm);
+        bitstring_set_bit(status_flags, STATUS_FLAG_FAULT, fault);
+        bitstring_set_bit(status_flags, STATUS_FLAG_OVERRIDDEN, overridden);
+        bitstring_set_bit(
+            status_flags, STATUS_FLAG_OUT_OF_SERVICE, out_of_service);
+    }
+}
+
 /**
  * @brief Encode the Value List for REAL Present-Value and Status-Flags
  * @param value_list - #BACNET_PROPERTY_VALUE with at least 2 entries
@@ -1221,3 +1843,140 @@ bool cov_value_list_encode_bit_string(
     return status;
 }
 #endif
+
+/**
+ * @brief Set the function called when an object reports that its
+ *  change of value flag was set, such as the COV handler queue of
+ *  changed objects.
+ * @param callback - function to call, or NULL for none
+ */
+void cov_change_of_value_callback_set(cov_change_of_value_callback callback)
+{
+    COV_Change_Of_Value_Callback = callback;
+}
+
+/**
+ * @brief Add a function to the list of functions that are called, after
+ *  the change of value callback, when an object reports a change.
+ * @param listener - the listener to add, which is kept in the list and
+ *  must outlive it
+ */
+void cov_change_of_value_listener_add(COV_CHANGE_OF_VALUE_LISTENER *listener)
+{
+    COV_CHANGE_OF_VALUE_LISTENER *node;
+
+    if (!listener) {
+        return;
+    }
+    for (node = COV_Change_Of_Value_Listeners; node; node = node->next) {
+        if (node == listener) {
+            /* already here! */
+            return;
+        }
+    }
+    listener->next = COV_Change_Of_Value_Listeners;
+    COV_Change_Of_Value_Listeners = listener;
+}
+
+/**
+ * @brief Remove a function from the list of functions that are called
+ *  when an object reports a change.
+ * @param listener - the listener to remove
+ */
+void cov_change_of_value_listener_remove(
+    COV_CHANGE_OF_VALUE_LISTENER *listener)
+{
+    COV_CHANGE_OF_VALUE_LISTENER **node;
+
+    for (node = &COV_Change_Of_Value_Listeners; *node; node = &(*node)->next) {
+        if (*node == listener) {
+            *node = listener->next;
+            listener->next = NULL;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Report that the change of value flag of an object was set,
+ *  so that the subscriptions to the object can be notified without
+ *  polling every object for changes.
+ * @param object_type - object type of the object that changed
+ * @param object_instance - object instance of the object that changed
+ */
+void cov_change_of_value_notify(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    COV_CHANGE_OF_VALUE_LISTENER *node;
+
+    if (COV_Change_Of_Value_Callback) {
+        COV_Change_Of_Value_Callback(object_type, object_instance);
+    }
+    for (node = COV_Change_Of_Value_Listeners; node; node = node->next) {
+        if (node->callback) {
+            node->callback(object_type, object_instance);
+        }
+    }
+}
+
+/**
+ * @brief Filter a REAL Present-Value with its COV_Increment, as in
+ *  13.1.3 of the standard, so that only a change of at least the
+ *  increment since the last reported value is a change of value.
+ * @param prior_value - [in,out] the last reported value, which is set
+ *  to the given value when the change is reported
+ * @param value - the new value
+ * @param cov_increment - the COV_Increment of the object
+ * @return true if the change is reported
+ */
+bool cov_filter_real(float *prior_value, float value, float cov_increment)
+{
+    float cov_delta;
+
+    if (!prior_value) {
+        return false;
+    }
+    if (*prior_value > value) {
+        cov_delta = *prior_value - value;
+    } else {
+        cov_delta = value - *prior_value;
+    }
+    if (cov_delta >= cov_increment) {
+        *prior_value = value;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Filter a signed INTEGER Present-Value with its COV_Increment,
+ *  so that only a change of at least the increment since the last
+ *  reported value is a change of value.
+ * @param prior_value - [in,out] the last reported value, which is set
+ *  to the given value when the change is reported
+ * @param value - the new value
+ * @param cov_increment - the COV_Increment of the object
+ * @return true if the change is reported
+ */
+bool cov_filter_signed(
+    int32_t *prior_value, int32_t value, uint32_t cov_increment)
+{
+    uint32_t cov_delta;
+
+    if (!prior_value) {
+        return false;
+    }
+    /* the difference of any two int32_t fits in a uint32_t */
+    if (*prior_value > value) {
+        cov_delta = (uint32_t)*prior_value - (uint32_t)value;
+    } else {
+        cov_delta = (uint32_t)value - (uint32_t)*prior_value;
+    }
+    if (cov_delta >= cov_increment) {
+        *prior_value = value;
+        return true;
+    }
+
+    return false;
+}
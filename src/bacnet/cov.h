@@ -48,6 +48,17 @@ typedef struct BACnet_COV_Notification {
     BACnet_COV_Notification_Callback callback;
 } BACNET_COV_NOTIFICATION;
 
+/* callback for objects to report that their change of value flag was set */
+typedef void (*cov_change_of_value_callback)(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+/* list of other functions called when an object reports a change,
+   such as the local Trend Logs with a Logging_Type of COV */
+struct cov_change_of_value_listener;
+typedef struct cov_change_of_value_listener {
+    struct cov_change_of_value_listener *next;
+    cov_change_of_value_callback callback;
+} COV_CHANGE_OF_VALUE_LISTENER;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -59,6 +70,26 @@ size_t cov_notify_service_request_encode(
 BACNET_STACK_EXPORT
 int cov_notify_encode_apdu(uint8_t *apdu, const BACNET_COV_DATA *data);
 
+/* COVNotification - the list of values encoded once for many subscribers */
+BACNET_STACK_EXPORT
+int cov_notify_value_list_encode(
+    uint8_t *apdu, const BACNET_PROPERTY_VALUE *value_list);
+BACNET_STACK_EXPORT
+int ccov_notify_encode_apdu_values(
+    uint8_t *apdu,
+    unsigned apdu_size,
+    uint8_t invoke_id,
+    const BACNET_COV_DATA *data,
+    const uint8_t *values,
+    size_t values_len);
+BACNET_STACK_EXPORT
+int ucov_notify_encode_apdu_values(
+    uint8_t *apdu,
+    unsigned apdu_size,
+    const BACNET_COV_DATA *data,
+    const uint8_t *values,
+    size_t values_len);
+
 BACNET_STACK_EXPORT
 int ucov_notify_encode_apdu(
     uint8_t *apdu, unsigned max_apdu_len, const BACNET_COV_DATA *data);
@@ -90,6 +121,27 @@ BACNET_STACK_EXPORT
 int cov_notify_decode_service_request(
     const uint8_t *apdu, unsigned apdu_len, BACNET_COV_DATA *data);
 
+/* COVNotificationMultiple - encoded one object at a time */
+BACNET_STACK_EXPORT
+int cov_notify_multiple_encode_init(uint8_t *apdu, const BACNET_COV_DATA *data);
+BACNET_STACK_EXPORT
+int cov_notify_multiple_encode_object(
+    uint8_t *apdu, const BACNET_COV_DATA *data);
+BACNET_STACK_EXPORT
+int cov_notify_multiple_encode_end(uint8_t *apdu);
+BACNET_STACK_EXPORT
+int ccov_notify_multiple_encode_apdu_init(
+    uint8_t *apdu, uint8_t invoke_id, const BACNET_COV_DATA *data);
+BACNET_STACK_EXPORT
+int ucov_notify_multiple_encode_apdu_init(
+    uint8_t *apdu, const BACNET_COV_DATA *data);
+BACNET_STACK_EXPORT
+int cov_notify_multiple_decode_init(
+    const uint8_t *apdu, unsigned apdu_size, BACNET_COV_DATA *data);
+BACNET_STACK_EXPORT
+int cov_notify_multiple_decode_object(
+    const uint8_t *apdu, unsigned apdu_size, BACNET_COV_DATA *data);
+
 BACNET_STACK_EXPORT
 int cov_subscribe_property_decode_service_request(
     const uint8_t *apdu, unsigned apdu_len, BACNET_SUBSCRIBE_COV_DATA *data);
@@ -136,6 +188,13 @@ void cov_data_value_list_link(
     BACNET_COV_DATA *data, BACNET_PROPERTY_VALUE *value_list, size_t count);
 
 BACNET_STACK_EXPORT
+void cov_status_flags_set(
+    BACNET_BIT_STRING *status_flags,
+    bool in_alarm,
+    bool fault,
+    bool overridden,
+    bool out_of_service);
+BACNET_STACK_EXPORT
 bool cov_value_list_encode_real(
     BACNET_PROPERTY_VALUE *value_list,
     float value,
@@ -184,6 +243,22 @@ bool cov_value_list_encode_bit_string(
     bool overridden,
     bool out_of_service);
 
+BACNET_STACK_EXPORT
+void cov_change_of_value_callback_set(cov_change_of_value_callback callback);
+BACNET_STACK_EXPORT
+void cov_change_of_value_listener_add(COV_CHANGE_OF_VALUE_LISTENER *listener);
+BACNET_STACK_EXPORT
+void cov_change_of_value_listener_remove(
+    COV_CHANGE_OF_VALUE_LISTENER *listener);
+BACNET_STACK_EXPORT
+void cov_change_of_value_notify(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool cov_filter_real(float *prior_value, float value, float cov_increment);
+BACNET_STACK_EXPORT
+bool cov_filter_signed(
+    int32_t *prior_value, int32_t value, uint32_t cov_increment);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
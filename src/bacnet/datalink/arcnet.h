@@ -32,6 +32,8 @@ BACNET_STACK_EXPORT
 void arcnet_cleanup(void);
 BACNET_STACK_EXPORT
 bool arcnet_init(char *interface_name);
+BACNET_STACK_EXPORT
+int arcnet_get_socket(void);
 
 /* function to send a packet out the 802.2 socket */
 /* returns zero on success, non-zero on failure */
@@ -63,6 +63,13 @@ BACNET_STACK_EXPORT
 int bip_send_mpdu(
     const BACNET_IP_ADDRESS *dest, const uint8_t *mtu, uint16_t mtu_len);
 
+BACNET_STACK_EXPORT
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len);
+
 BACNET_STACK_EXPORT
 uint16_t bip_receive(
     BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout);
@@ -114,6 +121,12 @@ int bip_get_broadcast_socket(void);
 BACNET_STACK_EXPORT
 int bip_set_broadcast_binding(const char *ip4_broadcast);
 
+BACNET_STACK_EXPORT
+bool bip_set_multicast_group(const BACNET_IP_ADDRESS *group, uint8_t ttl);
+
+BACNET_STACK_EXPORT
+bool bip_get_multicast_group(BACNET_IP_ADDRESS *group);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
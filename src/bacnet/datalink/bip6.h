@@ -39,6 +39,8 @@ bool bip6_init(char *ifname);
 BACNET_STACK_EXPORT
 void bip6_cleanup(void);
 BACNET_STACK_EXPORT
+int bip6_get_socket(void);
+BACNET_STACK_EXPORT
 void bip6_join_group(void);
 BACNET_STACK_EXPORT
 void bip6_leave_group(void);
@@ -83,6 +85,12 @@ BACNET_STACK_EXPORT
 int bip6_send_mpdu(
     const BACNET_IP6_ADDRESS *addr, const uint8_t *mtu, uint16_t mtu_len);
 BACNET_STACK_EXPORT
+int bip6_send_mpdu_multiple(
+    const BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len);
+BACNET_STACK_EXPORT
 bool bip6_send_pdu_queue_empty(void);
 BACNET_STACK_EXPORT
 void bip6_receive_callback(void);
@@ -68,10 +68,40 @@
 #define BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM (BSC_CONF_HUB_FUNCTIONS_NUM * 10)
 #endif
 
+/* Keep a connection to the failover hub open while the hub connector is
+   connected to the primary hub, so that a failover is immediate. It uses
+   the second connection of the hub connector, and the failover hub holds
+   an idle connection for each node of the site. */
+#ifndef BSC_CONF_HUB_CONNECTOR_STANDBY
+#define BSC_CONF_HUB_CONNECTOR_STANDBY 0
+#endif
+
 #ifndef BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM
 #define BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM 10
 #endif
 
+/* Number of peers whose unicast traffic through the hub is counted to
+   open direct connections automatically, the seconds of traffic that
+   the rate to a peer is measured over, and the defaults that open no
+   more than half of the direct connections, and close them after five
+   minutes without traffic. See bsc_node_switch_auto_connect_set(). */
+#ifndef BSC_CONF_NODE_SWITCH_AUTO_PEERS_NUM
+#define BSC_CONF_NODE_SWITCH_AUTO_PEERS_NUM 16
+#endif
+
+#ifndef BSC_CONF_NODE_SWITCH_AUTO_WINDOW_S
+#define BSC_CONF_NODE_SWITCH_AUTO_WINDOW_S 10
+#endif
+
+#ifndef BSC_CONF_NODE_SWITCH_AUTO_LINKS_NUM
+#define BSC_CONF_NODE_SWITCH_AUTO_LINKS_NUM \
+    (BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM / 2)
+#endif
+
+#ifndef BSC_CONF_NODE_SWITCH_AUTO_IDLE_S
+#define BSC_CONF_NODE_SWITCH_AUTO_IDLE_S 300
+#endif
+
 /* Total amount of client(initiator) webosocket connections */
 #ifndef BSC_CONF_CLIENT_CONNECTIONS_NUM
 #define BSC_CONF_CLIENT_CONNECTIONS_NUM       \
@@ -92,6 +122,18 @@
 #define BSC_CONF_SOCKET_TX_BUFFERED_PACKET_NUM 2
 #define BSC_CONF_DATALINK_BUFFERED_PACKET_NUM 10
 
+/* Number of broadcast BVLC messages that can wait in the send queues
+   of the sockets at the same time. A broadcast is copied once into a
+   shared buffer, and the send queue of each socket holds a reference. */
+#ifndef BSC_CONF_SOCK_SHARED_TX_BUFFERS_NUM
+#define BSC_CONF_SOCK_SHARED_TX_BUFFERS_NUM 8
+#endif
+
+/* Number of threads that service the connections of a websocket server */
+#ifndef BSC_CONF_WEBSOCKET_SERVICE_THREADS_NUM
+#define BSC_CONF_WEBSOCKET_SERVICE_THREADS_NUM 1
+#endif
+
 #define BSC_CONF_SOCK_RX_BUFFER_SIZE BVLC_SC_NPDU_SIZE_CONF
 
 /* 2 bytes is a prefix containing BVLC message length.
@@ -7,6 +7,8 @@
  */
 #include "bacnet/basic/sys/debug.h"
 #include <bacnet/basic/sys/fifo.h>
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/datalink/bsc/bsc-conf.h"
 #include "bacnet/datalink/bsc/bvlc-sc.h"
 #include "bacnet/datalink/bsc/bsc-datalink.h"
@@ -275,6 +277,10 @@ int bsc_send_pdu(
     }
 
     bws_dispatch_unlock();
+    if (len > 0) {
+        PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_BSC);
+        BACTRACE_DATALINK_SEND(PERFSTAT_DATALINK_BSC, pdu_len);
+    }
     DEBUG_PRINTF("bsc_send_pdu() <<< ret = %d\n", len);
     return len;
 }
@@ -369,6 +375,10 @@ uint16_t bsc_receive(
         }
     }
     bws_dispatch_unlock();
+    if (pdu_len > 0) {
+        PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_BSC);
+        BACTRACE_DATALINK_RECEIVE(PERFSTAT_DATALINK_BSC, pdu_len);
+    }
 
     return pdu_len;
 }
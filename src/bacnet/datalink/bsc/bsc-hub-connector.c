@@ -5,6 +5,7 @@
  * @date July 2022
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
+#include <limits.h>
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/datalink/bsc/bvlc-sc.h"
 #include "bacnet/datalink/bsc/bsc-socket.h"
@@ -51,13 +52,26 @@ typedef enum {
     BSC_HUB_CONNECTOR_STATE_DUPLICATED_VMAC = 7
 } BSC_HUB_CONNECTOR_STATE;
 
+/* the connection to the failover hub that is kept open while the hub
+   connector is connected to the primary hub */
+typedef enum {
+    BSC_HUB_STANDBY_STATE_IDLE = 0,
+    BSC_HUB_STANDBY_STATE_CONNECTING = 1,
+    BSC_HUB_STANDBY_STATE_CONNECTED = 2
+} BSC_HUB_STANDBY_STATE;
+
 typedef struct BSC_Hub_Connector {
     bool used;
     BSC_SOCKET_CTX ctx;
     BSC_CONTEXT_CFG cfg;
     BSC_SOCKET sock[2];
     BSC_HUB_CONNECTOR_STATE state;
+    BSC_HUB_STANDBY_STATE standby;
+    unsigned int min_reconnect_timeout_s;
     unsigned int reconnect_timeout_s;
+    /* failed connection attempts since the last connection to a hub */
+    unsigned int reconnect_attempts;
+    uint32_t jitter;
     uint8_t primary_url[BSC_WSURL_MAX_LEN + 1];
     uint8_t failover_url[BSC_WSURL_MAX_LEN + 1];
     struct mstimer t;
@@ -151,6 +165,151 @@ static void hub_conector_update_status(
     }
 }
 
+/**
+ * @brief Seed the pseudo random numbers of a hub connector
+ * @details The seed is a hash of the UUID and VMAC of the node, so that
+ *  the nodes of a site, which all lose their hub at the same moment when
+ *  it restarts, do not all retry at the same moment.
+ * @param p - pointer to the hub connector
+ */
+static void hub_connector_jitter_init(BSC_HUB_CONNECTOR *p)
+{
+    uint32_t hash = 2166136261UL;
+    size_t i;
+
+    for (i = 0; i < sizeof(p->cfg.local_uuid.uuid); i++) {
+        hash = (hash ^ p->cfg.local_uuid.uuid[i]) * 16777619UL;
+    }
+    for (i = 0; i < sizeof(p->cfg.local_vmac.address); i++) {
+        hash = (hash ^ p->cfg.local_vmac.address[i]) * 16777619UL;
+    }
+    /* xorshift must not be seeded with zero */
+    p->jitter = hash ? hash : 1;
+}
+
+/**
+ * @brief Get the next pseudo random number of a hub connector
+ * @param p - pointer to the hub connector
+ * @return pseudo random number (xorshift32)
+ */
+static uint32_t hub_connector_jitter(BSC_HUB_CONNECTOR *p)
+{
+    uint32_t x = p->jitter;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    p->jitter = x;
+
+    return x;
+}
+
+/**
+ * @brief Get the reconnect window of a hub connector
+ * @details The window starts at the minimum reconnect time and doubles
+ *  with each failed attempt, up to the maximum reconnect time.
+ * @param p - pointer to the hub connector
+ * @return window in milliseconds
+ */
+static unsigned long hub_connector_reconnect_window(BSC_HUB_CONNECTOR *p)
+{
+    unsigned long max_ms = p->reconnect_timeout_s * 1000UL;
+    unsigned long window_ms = p->min_reconnect_timeout_s * 1000UL;
+    unsigned int i;
+
+    if ((window_ms == 0) || (window_ms > max_ms)) {
+        window_ms = max_ms;
+    }
+    for (i = 0; (i < p->reconnect_attempts) && (window_ms < max_ms); i++) {
+        window_ms *= 2;
+    }
+    if (window_ms > max_ms) {
+        window_ms = max_ms;
+    }
+
+    return window_ms;
+}
+
+/**
+ * @brief Get the wait after a failed attempt to connect, which is a random
+ *  time between half and all of the reconnect window, and count the attempt
+ * @param p - pointer to the hub connector
+ * @return wait in milliseconds
+ */
+static unsigned long hub_connector_backoff(BSC_HUB_CONNECTOR *p)
+{
+    unsigned long window_ms = hub_connector_reconnect_window(p);
+
+    if (p->reconnect_attempts < UINT_MAX) {
+        p->reconnect_attempts++;
+    }
+
+    return window_ms / 2 + hub_connector_jitter(p) % (window_ms / 2 + 1);
+}
+
+/**
+ * @brief Wait after a failed attempt, before the next attempt to connect
+ *  to the hubs
+ * @param p - pointer to the hub connector
+ */
+static void hub_connector_wait_for_reconnect(BSC_HUB_CONNECTOR *p)
+{
+    p->state = BSC_HUB_CONNECTOR_STATE_WAIT_FOR_RECONNECT;
+    mstimer_set(&p->t, hub_connector_backoff(p));
+    DEBUG_PRINTF(
+        "hub_connector_wait_for_reconnect() hub = %p wait for %lu ms\n", p,
+        mstimer_interval(&p->t));
+}
+
+/**
+ * @brief Wait a random time within the first reconnect window, after the
+ *  connection to a hub is lost, before the attempt to connect again
+ * @param p - pointer to the hub connector
+ */
+static void hub_connector_wait_after_disconnect(BSC_HUB_CONNECTOR *p)
+{
+    unsigned long window_ms;
+
+    p->reconnect_attempts = 0;
+    window_ms = hub_connector_reconnect_window(p);
+    p->state = BSC_HUB_CONNECTOR_STATE_WAIT_FOR_RECONNECT;
+    /* a timer with no interval never expires */
+    mstimer_set(&p->t, 1 + hub_connector_jitter(p) % window_ms);
+    DEBUG_PRINTF(
+        "hub_connector_wait_after_disconnect() hub = %p wait for %lu ms\n",
+        p, mstimer_interval(&p->t));
+}
+
+/**
+ * @brief Open the standby connection to the failover hub, if it is
+ *  enabled and the hub connector is connected to the primary hub
+ * @param p - pointer to the hub connector
+ */
+static void hub_connector_standby_connect(BSC_HUB_CONNECTOR *p)
+{
+#if BSC_CONF_HUB_CONNECTOR_STANDBY
+    BSC_SC_RET ret;
+
+    if ((p->state != BSC_HUB_CONNECTOR_STATE_CONNECTED_PRIMARY) ||
+        (p->standby != BSC_HUB_STANDBY_STATE_IDLE) ||
+        (p->failover_url[0] == 0)) {
+        return;
+    }
+    DEBUG_PRINTF(
+        "hub_connector_standby_connect() hub = %p connecting to url %s\n", p,
+        p->failover_url);
+    ret = bsc_connect(
+        &p->ctx, &p->sock[BSC_HUB_CONN_FAILOVER], (char *)p->failover_url);
+    if (ret == BSC_SC_SUCCESS) {
+        p->standby = BSC_HUB_STANDBY_STATE_CONNECTING;
+    } else {
+        mstimer_set(&p->t, hub_connector_backoff(p));
+    }
+#else
+    (void)p;
+#endif
+}
+
 /**
  * @brief Connect to a BACnet hub
  * @param p - pointer to the hub connector
@@ -170,8 +329,7 @@ static void hub_connector_connect(BSC_HUB_CONNECTOR *p, BSC_HUB_CONN_TYPE type)
         "hub_connector_connect() hub = %p connecting to url %s\n", p, url);
 
     if (url[0] == 0) {
-        mstimer_set(&p->t, p->reconnect_timeout_s * 1000);
-        p->state = BSC_HUB_CONNECTOR_STATE_WAIT_FOR_RECONNECT;
+        hub_connector_wait_for_reconnect(p);
         return;
     }
 
@@ -198,6 +356,10 @@ static void hub_connector_process_state(BSC_HUB_CONNECTOR *c)
         if (mstimer_expired(&c->t)) {
             hub_connector_connect(c, BSC_HUB_CONN_PRIMARY);
         }
+    } else if (c->state == BSC_HUB_CONNECTOR_STATE_CONNECTED_PRIMARY) {
+        if (mstimer_expired(&c->t)) {
+            hub_connector_standby_connect(c);
+        }
     }
 }
 
@@ -219,6 +381,67 @@ void bsc_hub_connector_maintenance_timer(uint16_t seconds)
     bws_dispatch_unlock();
 }
 
+#if BSC_CONF_HUB_CONNECTOR_STANDBY
+/**
+ * @brief Handle an event of the standby connection to the failover hub
+ * @param hc - pointer to the hub connector
+ * @param ev - event
+ * @param disconnect_reason - disconnect reason
+ * @param disconnect_reason_desc - disconnect reason description
+ * @return true if the event was handled, false if it is handled as an
+ *  event of the hub connector
+ */
+static bool hub_connector_standby_event(
+    BSC_HUB_CONNECTOR *hc,
+    BSC_SOCKET_EVENT ev,
+    BACNET_ERROR_CODE disconnect_reason,
+    const char *disconnect_reason_desc)
+{
+    BACNET_SC_CONNECTION_STATE st =
+        BACNET_SC_CONNECTION_STATE_DISCONNECTED_WITH_ERRORS;
+
+    if (ev == BSC_SOCKET_EVENT_CONNECTED) {
+        DEBUG_PRINTF(
+            "hub_connector_standby_event() hub_connector = %p "
+            "connected standby failover\n",
+            hc);
+        hc->standby = BSC_HUB_STANDBY_STATE_CONNECTED;
+        hub_conector_update_status(
+            &hc->failover_status, BACNET_SC_CONNECTION_STATE_CONNECTED,
+            ERROR_CODE_DEFAULT, NULL);
+        return true;
+    }
+    if (ev == BSC_SOCKET_EVENT_RECEIVED) {
+        /* the node sends and receives through the primary hub only */
+        return true;
+    }
+    if (disconnect_reason == ERROR_CODE_NODE_DUPLICATE_VMAC) {
+        hc->standby = BSC_HUB_STANDBY_STATE_IDLE;
+        return false;
+    }
+    if (hc->standby == BSC_HUB_STANDBY_STATE_CONNECTING) {
+        hub_conector_update_status(
+            &hc->failover_status, BACNET_SC_CONNECTION_STATE_FAILED_TO_CONNECT,
+            disconnect_reason, disconnect_reason_desc);
+    } else {
+        if (disconnect_reason == ERROR_CODE_WEBSOCKET_CLOSED_BY_PEER ||
+            disconnect_reason == ERROR_CODE_SUCCESS) {
+            st = BACNET_SC_CONNECTION_STATE_NOT_CONNECTED;
+        }
+        hub_conector_update_status(
+            &hc->failover_status, st, ERROR_CODE_DEFAULT, NULL);
+    }
+    hc->standby = BSC_HUB_STANDBY_STATE_IDLE;
+    mstimer_set(&hc->t, hub_connector_backoff(hc));
+    DEBUG_PRINTF(
+        "hub_connector_standby_event() standby failover is lost, wait for "
+        "%lu ms\n",
+        mstimer_interval(&hc->t));
+
+    return true;
+}
+#endif
+
 /**
  * @brief Hub connector socket event
  * @param c - pointer to the socket
@@ -250,6 +473,16 @@ static void hub_connector_socket_event(
         "pdu = %p, pdu_len = %d\n",
         hc, c, ev, disconnect_reason, disconnect_reason_desc, pdu, pdu_len);
     DEBUG_PRINTF("hub_connector_socket_event() state = %d\n", hc->state);
+#if BSC_CONF_HUB_CONNECTOR_STANDBY
+    if ((c == &hc->sock[BSC_HUB_CONN_FAILOVER]) &&
+        (hc->standby != BSC_HUB_STANDBY_STATE_IDLE) &&
+        hub_connector_standby_event(
+            hc, ev, disconnect_reason, disconnect_reason_desc)) {
+        bws_dispatch_unlock();
+        DEBUG_PRINTF("hub_connector_socket_event() <<<\n");
+        return;
+    }
+#endif
     if (ev == BSC_SOCKET_EVENT_CONNECTED) {
         if (hc->state == BSC_HUB_CONNECTOR_STATE_CONNECTING_PRIMARY) {
             DEBUG_PRINTF(
@@ -257,18 +490,21 @@ static void hub_connector_socket_event(
                 "connected primary\n",
                 hc);
             hc->state = BSC_HUB_CONNECTOR_STATE_CONNECTED_PRIMARY;
+            hc->reconnect_attempts = 0;
             hub_conector_update_status(
                 &hc->primary_status, BACNET_SC_CONNECTION_STATE_CONNECTED,
                 ERROR_CODE_DEFAULT, NULL);
             hc->event_func(
                 BSC_HUBC_EVENT_CONNECTED_PRIMARY, hc, hc->user_arg, NULL, 0,
                 NULL);
+            hub_connector_standby_connect(hc);
         } else if (hc->state == BSC_HUB_CONNECTOR_STATE_CONNECTING_FAILOVER) {
             DEBUG_PRINTF(
                 "hub_connector_socket_event() hub_connector = %p "
                 "connected failover\n",
                 hc);
             hc->state = BSC_HUB_CONNECTOR_STATE_CONNECTED_FAILOVER;
+            hc->reconnect_attempts = 0;
             hub_conector_update_status(
                 &hc->failover_status, BACNET_SC_CONNECTION_STATE_CONNECTED,
                 ERROR_CODE_DEFAULT, NULL);
@@ -306,15 +542,11 @@ static void hub_connector_socket_event(
                 disconnect_reason_desc);
             hub_connector_connect(hc, BSC_HUB_CONN_FAILOVER);
         } else if (hc->state == BSC_HUB_CONNECTOR_STATE_CONNECTING_FAILOVER) {
-            DEBUG_PRINTF(
-                "hub_connector_socket_event() wait for %d seconds\n",
-                hc->reconnect_timeout_s);
             hub_conector_update_status(
                 &hc->failover_status,
                 BACNET_SC_CONNECTION_STATE_FAILED_TO_CONNECT, disconnect_reason,
                 disconnect_reason_desc);
-            hc->state = BSC_HUB_CONNECTOR_STATE_WAIT_FOR_RECONNECT;
-            mstimer_set(&hc->t, hc->reconnect_timeout_s * 1000);
+            hub_connector_wait_for_reconnect(hc);
         } else if (
             hc->state == BSC_HUB_CONNECTOR_STATE_CONNECTED_PRIMARY ||
             hc->state == BSC_HUB_CONNECTOR_STATE_CONNECTED_FAILOVER) {
@@ -329,9 +561,24 @@ static void hub_connector_socket_event(
                 hub_conector_update_status(
                     &hc->failover_status, st, ERROR_CODE_DEFAULT, NULL);
             }
-            DEBUG_PRINTF(
-                "hub_connector_socket_event() try to connect to primary hub\n");
-            hub_connector_connect(hc, BSC_HUB_CONN_PRIMARY);
+            if (hc->standby == BSC_HUB_STANDBY_STATE_CONNECTED) {
+                DEBUG_PRINTF("hub_connector_socket_event() fail over to the "
+                             "standby failover hub\n");
+                hc->standby = BSC_HUB_STANDBY_STATE_IDLE;
+                hc->state = BSC_HUB_CONNECTOR_STATE_CONNECTED_FAILOVER;
+                hc->event_func(
+                    BSC_HUBC_EVENT_CONNECTED_FAILOVER, hc, hc->user_arg, NULL,
+                    0, NULL);
+            } else if (hc->standby == BSC_HUB_STANDBY_STATE_CONNECTING) {
+                DEBUG_PRINTF("hub_connector_socket_event() wait for the "
+                             "standby failover hub\n");
+                hc->standby = BSC_HUB_STANDBY_STATE_IDLE;
+                hc->state = BSC_HUB_CONNECTOR_STATE_CONNECTING_FAILOVER;
+            } else {
+                DEBUG_PRINTF("hub_connector_socket_event() try to connect to "
+                             "primary hub\n");
+                hub_connector_wait_after_disconnect(hc);
+            }
         }
     } else if (ev == BSC_SOCKET_EVENT_RECEIVED) {
         DEBUG_PRINTF(
@@ -390,7 +637,9 @@ static void hub_connector_context_event(BSC_SOCKET_CTX *ctx, BSC_CTX_EVENT ev)
  * @param disconnect_timeout_s - disconnect timeout in seconds
  * @param primaryURL - primary hub URL
  * @param failoverURL - failover hub URL
- * @param reconnect_timeout_s - reconnect timeout in seconds
+ * @param min_reconnect_timeout_s - minimum reconnect timeout in seconds,
+ *  or zero to use the maximum reconnect timeout
+ * @param reconnect_timeout_s - maximum reconnect timeout in seconds
  * @param event_func - event function
  * @param user_arg - user argument
  * @param h - pointer to the hub connector handle
@@ -412,6 +661,7 @@ BSC_SC_RET bsc_hub_connector_start(
     unsigned int disconnect_timeout_s,
     char *primaryURL,
     char *failoverURL,
+    unsigned int min_reconnect_timeout_s,
     unsigned int reconnect_timeout_s,
     BSC_HUB_CONNECTOR_EVENT_FUNC event_func,
     void *user_arg,
@@ -445,6 +695,7 @@ BSC_SC_RET bsc_hub_connector_start(
             "bsc_hub_connector_start() <<< ret = BSC_SC_NO_RESOURCES\n");
         return BSC_SC_NO_RESOURCES;
     }
+    c->min_reconnect_timeout_s = min_reconnect_timeout_s;
     c->reconnect_timeout_s = reconnect_timeout_s;
     c->primary_url[0] = 0;
     c->failover_url[0] = 0;
@@ -462,6 +713,7 @@ BSC_SC_RET bsc_hub_connector_start(
         key_size, local_uuid, local_vmac, max_local_bvlc_len,
         max_local_npdu_len, connect_timeout_s, heartbeat_timeout_s,
         disconnect_timeout_s);
+    hub_connector_jitter_init(c);
 
     DEBUG_PRINTF(
         "bsc_hub_connector_start() uuid = %s, vmac = %s\n",
@@ -52,6 +52,7 @@ BSC_SC_RET bsc_hub_connector_start(
     unsigned int disconnect_timeout_s,
     char *primaryURL,
     char *failoverURL,
+    unsigned int min_reconnect_timeout_s,
     unsigned int reconnnect_timeout_s,
     BSC_HUB_CONNECTOR_EVENT_FUNC event_func,
     void *user_arg,
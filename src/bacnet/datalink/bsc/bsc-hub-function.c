@@ -5,6 +5,7 @@
  * @date July 2022
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
+#include <stdlib.h>
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/datalink/bsc/bsc-conf.h"
 #include "bacnet/datalink/bsc/bvlc-sc.h"
@@ -65,7 +66,9 @@ typedef struct BSC_Hub_Connector {
     bool used;
     BSC_SOCKET_CTX ctx;
     BSC_CONTEXT_CFG cfg;
-    BSC_SOCKET sock[BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM];
+    /* connections, allocated in one block when the hub function starts */
+    BSC_SOCKET *sock;
+    size_t sock_num;
     BSC_HUB_FUNCTION_STATE state;
     BSC_HUB_EVENT_FUNC event_func;
     void *user_arg;
@@ -77,6 +80,10 @@ static BSC_HUB_FUNCTION bsc_hub_function[BSC_CONF_HUB_FUNCTIONS_NUM] = { 0 };
 static BSC_HUB_FUNCTION *bsc_hub_function = NULL;
 #endif
 
+/* number of connections of the hub functions that start next */
+static size_t bsc_hub_function_connections_num =
+    BSC_CONF_HUB_FUNCTION_CONNECTIONS_NUM;
+
 static BSC_SOCKET_CTX_FUNCS bsc_hub_function_ctx_funcs = {
     hub_function_find_connection_for_vmac,
     hub_function_find_connection_for_uuid, hub_function_socket_event,
@@ -105,6 +112,9 @@ static BSC_HUB_FUNCTION *hub_function_alloc(void)
  */
 static void hub_function_free(BSC_HUB_FUNCTION *p)
 {
+    free(p->sock);
+    p->sock = NULL;
+    p->sock_num = 0;
     p->used = false;
 }
 
@@ -117,28 +127,12 @@ static void hub_function_free(BSC_HUB_FUNCTION *p)
 static BSC_SOCKET *hub_function_find_connection_for_vmac(
     BACNET_SC_VMAC_ADDRESS *vmac, void *user_arg)
 {
-    int i;
-    BSC_HUB_FUNCTION *f;
+    BSC_HUB_FUNCTION *f = (BSC_HUB_FUNCTION *)user_arg;
 
-    bws_dispatch_lock();
-    f = (BSC_HUB_FUNCTION *)user_arg;
     DEBUG_PRINTF(
-        "hubf = %p local_vmac = %s\n", f,
-        bsc_vmac_to_string(&f->cfg.local_vmac));
-    for (i = 0; i < sizeof(f->sock) / sizeof(BSC_SOCKET); i++) {
-        DEBUG_PRINTF(
-            "hubf = %p, sock %p, state = %d, vmac = %s\n", f, &f->sock[i],
-            f->sock[i].state, bsc_vmac_to_string(&f->sock[i].vmac));
-        if (f->sock[i].state != BSC_SOCK_STATE_IDLE &&
-            !memcmp(
-                &vmac->address[0], &f->sock[i].vmac.address[0],
-                sizeof(vmac->address))) {
-            bws_dispatch_unlock();
-            return &f->sock[i];
-        }
-    }
-    bws_dispatch_unlock();
-    return NULL;
+        "hubf = %p local_vmac = %s, vmac = %s\n", f,
+        bsc_vmac_to_string(&f->cfg.local_vmac), bsc_vmac_to_string(vmac));
+    return bsc_find_socket_for_vmac(&f->ctx, vmac);
 }
 
 /**
@@ -150,25 +144,11 @@ static BSC_SOCKET *hub_function_find_connection_for_vmac(
 static BSC_SOCKET *
 hub_function_find_connection_for_uuid(BACNET_SC_UUID *uuid, void *user_arg)
 {
-    int i;
-    BSC_HUB_FUNCTION *f;
+    BSC_HUB_FUNCTION *f = (BSC_HUB_FUNCTION *)user_arg;
 
-    bws_dispatch_lock();
-    f = (BSC_HUB_FUNCTION *)user_arg;
-    for (i = 0; i < sizeof(f->sock) / sizeof(BSC_SOCKET); i++) {
-        DEBUG_PRINTF_VERBOSE(
-            "hubf = %p, sock %p, state = %d, uuid = %s\n", f, &f->sock[i],
-            f->sock[i].state, bsc_uuid_to_string(&f->sock[i].uuid));
-        if (f->sock[i].state != BSC_SOCK_STATE_IDLE &&
-            !memcmp(
-                &uuid->uuid[0], &f->sock[i].uuid.uuid[0], sizeof(uuid->uuid))) {
-            bws_dispatch_unlock();
-            DEBUG_PRINTF_VERBOSE("found socket\n");
-            return &f->sock[i];
-        }
-    }
-    bws_dispatch_unlock();
-    return NULL;
+    DEBUG_PRINTF_VERBOSE(
+        "hubf = %p, uuid = %s\n", f, bsc_uuid_to_string(uuid));
+    return bsc_find_socket_for_uuid(&f->ctx, uuid);
 }
 
 /**
@@ -281,7 +261,6 @@ static void hub_function_socket_event(
 {
     BSC_SOCKET *dst;
     BSC_SC_RET ret;
-    int i;
     uint8_t *p_pdu;
     BSC_HUB_FUNCTION *f;
     size_t len;
@@ -302,37 +281,22 @@ static void hub_function_socket_event(
         /* although such kind of check is already in bsc-socket.c */
         if (!decoded_pdu->hdr.origin && decoded_pdu->hdr.dest) {
             if (bvlc_sc_is_vmac_broadcast(decoded_pdu->hdr.dest)) {
-                if (bsc_socket_get_global_buf_size() >= pdu_len) {
-                    p_pdu = bsc_socket_get_global_buf();
-                    len = pdu_len;
-                    memcpy(p_pdu, pdu, len);
-                    for (i = 0; i < sizeof(f->sock) / sizeof(BSC_SOCKET); i++) {
-                        if ((&f->sock[i] != c) &&
-                            (f->sock[i].state == BSC_SOCK_STATE_CONNECTED)) {
-                            /* change origin address if presented or add origin
-                             */
-                            /* address into pdu by extending of it's header */
-                            len = (uint16_t)bvlc_sc_set_orig(
-                                &p_pdu, len, &c->vmac);
-                            ret = bsc_send(&f->sock[i], p_pdu, len);
-                            if (ret == BSC_SC_SUCCESS) {
-                                DEBUG_PRINTF(
-                                    "BSC-HUB: "
-                                    "sent pdu of %d bytes\n",
-                                    len);
-                            } else {
-                                DEBUG_PRINTF(
-                                    "BSC-HUB: "
-                                    "sending of reconstructed pdu failed, "
-                                    "err = %s\n",
-                                    bsc_return_code_to_string(ret));
-                            }
-                        }
-                    }
+                p_pdu = pdu;
+                /* add origin address into the received pdu by extending
+                   of it's header in place, into the BSC_PRE bytes that
+                   are reserved behind it, once for all the connections */
+                len = bvlc_sc_set_orig(&p_pdu, pdu_len, &c->vmac);
+                /* the pdu is shared by the send queues of the
+                   connections, and a full queue drops only the
+                   copy of its own connection */
+                ret = bsc_send_broadcast(c->ctx, c, p_pdu, len);
+                if (ret == BSC_SC_SUCCESS) {
+                    DEBUG_PRINTF("BSC-HUB: broadcast pdu of %d bytes\n", len);
                 } else {
                     DEBUG_PRINTF(
-                        "BSC-HUB: received pdu with len = %d is dropped\n",
-                        pdu_len);
+                        "BSC-HUB: broadcast of reconstructed pdu failed, "
+                        "err = %s\n",
+                        bsc_return_code_to_string(ret));
                 }
             } else {
                 dst = hub_function_find_connection_for_vmac(
@@ -469,6 +433,17 @@ BSC_SC_RET bsc_hub_function_start(
             "BSC-HUB: alloc failed. err=%s\n", bsc_return_code_to_string(ret));
         return ret;
     }
+    f->sock_num = bsc_hub_function_connections_num;
+    f->sock = calloc(f->sock_num, sizeof(BSC_SOCKET));
+    if (!f->sock) {
+        hub_function_free(f);
+        bws_dispatch_unlock();
+        ret = BSC_SC_NO_RESOURCES;
+        DEBUG_PRINTF(
+            "BSC-HUB: connections alloc failed. err=%s\n",
+            bsc_return_code_to_string(ret));
+        return ret;
+    }
     f->user_arg = user_arg;
     f->event_func = event_func;
     bsc_init_ctx_cfg(
@@ -479,8 +454,8 @@ BSC_SC_RET bsc_hub_function_start(
         disconnect_timeout_s);
 
     ret = bsc_init_ctx(
-        &f->ctx, &f->cfg, &bsc_hub_function_ctx_funcs, f->sock,
-        sizeof(f->sock) / sizeof(BSC_SOCKET), f);
+        &f->ctx, &f->cfg, &bsc_hub_function_ctx_funcs, f->sock, f->sock_num,
+        f);
 
     if (ret == BSC_SC_SUCCESS) {
         f->state = BSC_HUB_FUNCTION_STATE_STARTING;
@@ -557,3 +532,32 @@ bool bsc_hub_function_started(BSC_HUB_FUNCTION_HANDLE h)
 
     return ret;
 }
+
+/**
+ * @brief Set the number of connections of the hub functions that start
+ *  afterwards. The connections are allocated when a hub function starts.
+ * @param num - number of connections, greater than zero
+ */
+void bsc_hub_function_connections_set(size_t num)
+{
+    if (num > 0) {
+        bws_dispatch_lock();
+        bsc_hub_function_connections_num = num;
+        bws_dispatch_unlock();
+    }
+}
+
+/**
+ * @brief Get the number of connections of the hub functions that start next
+ * @return number of connections
+ */
+size_t bsc_hub_function_connections(void)
+{
+    size_t num;
+
+    bws_dispatch_lock();
+    num = bsc_hub_function_connections_num;
+    bws_dispatch_unlock();
+
+    return num;
+}
@@ -59,4 +59,10 @@ bool bsc_hub_function_stopped(BSC_HUB_FUNCTION_HANDLE h);
 BACNET_STACK_EXPORT
 bool bsc_hub_function_started(BSC_HUB_FUNCTION_HANDLE h);
 
+BACNET_STACK_EXPORT
+void bsc_hub_function_connections_set(size_t num);
+
+BACNET_STACK_EXPORT
+size_t bsc_hub_function_connections(void);
+
 #endif
@@ -5,6 +5,7 @@
  * @date October 2022
  * @copyright SPDX-License-Identifier: GPL-2\.0-or-later WITH GCC-exception-2.0
  */
+#include <stdlib.h>
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/datalink/bsc/bvlc-sc.h"
 #include "bacnet/datalink/bsc/bsc-socket.h"
@@ -81,7 +82,9 @@ node_switch_initiator_context_event(BSC_SOCKET_CTX *ctx, BSC_CTX_EVENT ev);
 typedef struct BSC_Node_Switch_Acceptor {
     BSC_SOCKET_CTX ctx;
     BSC_CONTEXT_CFG cfg;
-    BSC_SOCKET sock[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
+    /* connections, allocated in one block when the node switch starts */
+    BSC_SOCKET *sock;
+    size_t sock_num;
     BSC_NODE_SWITCH_STATE state;
     BACNET_SC_DIRECT_CONNECTION_STATUS *status;
 } BSC_NODE_SWITCH_ACCEPTOR;
@@ -102,9 +105,21 @@ typedef struct BSC_Node_Switch_Initiator {
     BACNET_SC_VMAC_ADDRESS dest_vmac[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
     struct mstimer t[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
     BSC_NODE_SWITCH_URLS urls[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
+    /* true if the connection was opened for the traffic to the peer,
+       and is closed when it has been idle for a while */
+    bool auto_link[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
+    uint32_t idle_s[BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM];
     BSC_NODE_SWITCH_STATE state;
 } BSC_NODE_SWITCH_INITIATOR;
 
+/* a peer that unicast traffic is sent to through the hub */
+typedef struct {
+    bool used;
+    BACNET_SC_VMAC_ADDRESS vmac;
+    /* octets sent to the peer in this window */
+    uint32_t octets;
+} BSC_NODE_SWITCH_PEER;
+
 typedef struct {
     bool used;
     BSC_NODE_SWITCH_ACCEPTOR acceptor;
@@ -114,15 +129,28 @@ typedef struct {
     unsigned int address_resolution_timeout_s;
     bool direct_connect_accept_enable;
     bool direct_connect_initiate_enable;
+    BSC_NODE_SWITCH_PEER peer[BSC_CONF_NODE_SWITCH_AUTO_PEERS_NUM];
+    uint16_t auto_window_s;
     void *user_arg;
 } BSC_NODE_SWITCH_CTX;
 
 #if BSC_CONF_NODE_SWITCHES_NUM > 0
 static BSC_NODE_SWITCH_CTX bsc_node_switch[BSC_CONF_NODE_SWITCHES_NUM] = { 0 };
+
+/* number of accepted connections of the node switches that start next */
+static size_t bsc_node_switch_connections_num =
+    BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM;
 #else
 static BSC_NODE_SWITCH_CTX *bsc_node_switch = NULL;
 #endif
 
+/* octets per second sent to a peer through the hub that open a direct
+   connection to the peer, or zero to open them only on request */
+static uint32_t bsc_node_switch_auto_rate = 0;
+static size_t bsc_node_switch_auto_links_num =
+    BSC_CONF_NODE_SWITCH_AUTO_LINKS_NUM;
+static uint16_t bsc_node_switch_auto_idle_s = BSC_CONF_NODE_SWITCH_AUTO_IDLE_S;
+
 static BSC_SOCKET_CTX_FUNCS bsc_node_switch_acceptor_ctx_funcs = {
     node_switch_acceptor_find_connection_for_vmac,
     node_switch_acceptor_find_connection_for_uuid,
@@ -155,6 +183,9 @@ static BSC_NODE_SWITCH_CTX *node_switch_alloc(void)
             memset(
                 &bsc_node_switch[i].acceptor, 0,
                 sizeof(bsc_node_switch[i].acceptor));
+            memset(
+                &bsc_node_switch[i].peer, 0, sizeof(bsc_node_switch[i].peer));
+            bsc_node_switch[i].auto_window_s = 0;
             return &bsc_node_switch[i];
         }
     }
@@ -166,6 +197,9 @@ static BSC_NODE_SWITCH_CTX *node_switch_alloc(void)
  */
 static void node_switch_free(BSC_NODE_SWITCH_CTX *ctx)
 {
+    free(ctx->acceptor.sock);
+    ctx->acceptor.sock = NULL;
+    ctx->acceptor.sock_num = 0;
     ctx->used = false;
 }
 
@@ -303,25 +337,10 @@ copy_urls2(BSC_NODE_SWITCH_CTX *ctx, int index, char **urls, size_t urls_cnt)
 static BSC_SOCKET *node_switch_acceptor_find_connection_for_vmac(
     BACNET_SC_VMAC_ADDRESS *vmac, void *user_arg)
 {
-    int i;
-    BSC_NODE_SWITCH_CTX *c;
-    bws_dispatch_lock();
-    c = (BSC_NODE_SWITCH_CTX *)user_arg;
-    for (i = 0; i < sizeof(c->acceptor.sock) / sizeof(BSC_SOCKET); i++) {
-        DEBUG_PRINTF(
-            "ns = %p, sock %p, state = %d, vmac = %s\n", c,
-            &c->acceptor.sock[i], c->acceptor.sock[i].state,
-            bsc_vmac_to_string(&c->acceptor.sock[i].vmac));
-        if (c->acceptor.sock[i].state != BSC_SOCK_STATE_IDLE &&
-            !memcmp(
-                &vmac->address[0], &c->acceptor.sock[i].vmac.address[0],
-                sizeof(vmac->address))) {
-            bws_dispatch_unlock();
-            return &c->acceptor.sock[i];
-        }
-    }
-    bws_dispatch_unlock();
-    return NULL;
+    BSC_NODE_SWITCH_CTX *c = (BSC_NODE_SWITCH_CTX *)user_arg;
+
+    DEBUG_PRINTF("ns = %p, vmac = %s\n", c, bsc_vmac_to_string(vmac));
+    return bsc_find_socket_for_vmac(&c->acceptor.ctx, vmac);
 }
 
 /**
@@ -333,26 +352,10 @@ static BSC_SOCKET *node_switch_acceptor_find_connection_for_vmac(
 static BSC_SOCKET *node_switch_acceptor_find_connection_for_uuid(
     BACNET_SC_UUID *uuid, void *user_arg)
 {
-    int i;
-    BSC_NODE_SWITCH_CTX *c;
-    bws_dispatch_lock();
-    c = (BSC_NODE_SWITCH_CTX *)user_arg;
-    for (i = 0; i < sizeof(c->acceptor.sock) / sizeof(BSC_SOCKET); i++) {
-        DEBUG_PRINTF(
-            "ns = %p, sock %p, state = %d, uuid = %s\n", c,
-            &c->acceptor.sock[i], c->acceptor.sock[i].state,
-            bsc_uuid_to_string(&c->acceptor.sock[i].uuid));
-        if (c->acceptor.sock[i].state != BSC_SOCK_STATE_IDLE &&
-            !memcmp(
-                &uuid->uuid[0], &c->acceptor.sock[i].uuid.uuid[0],
-                sizeof(uuid->uuid))) {
-            DEBUG_PRINTF("found\n");
-            bws_dispatch_unlock();
-            return &c->acceptor.sock[i];
-        }
-    }
-    bws_dispatch_unlock();
-    return NULL;
+    BSC_NODE_SWITCH_CTX *c = (BSC_NODE_SWITCH_CTX *)user_arg;
+
+    DEBUG_PRINTF("ns = %p, uuid = %s\n", c, bsc_uuid_to_string(uuid));
+    return bsc_find_socket_for_uuid(&c->acceptor.ctx, uuid);
 }
 
 /**
@@ -408,10 +411,6 @@ static void node_switch_acceptor_socket_event(
 {
     uint8_t *p_pdu;
     BSC_NODE_SWITCH_CTX *ctx;
-    uint16_t error_class;
-    uint16_t error_code;
-    const char *err_desc;
-    bool res = true;
 
     DEBUG_PRINTF(
         "node_switch_acceptor_socket_event() >>> c %p, ev = %d\n", c, ev);
@@ -424,19 +423,14 @@ static void node_switch_acceptor_socket_event(
 
     if (ctx->acceptor.state == BSC_NODE_SWITCH_STATE_STARTED) {
         if (ev == BSC_SOCKET_EVENT_RECEIVED) {
-            if (bsc_socket_get_global_buf_size() >= pdu_len) {
-                p_pdu = bsc_socket_get_global_buf();
-                memcpy(p_pdu, pdu, pdu_len);
-                pdu_len = bvlc_sc_set_orig(&p_pdu, pdu_len, &c->vmac);
-                res = bvlc_sc_decode_message(
-                    p_pdu, pdu_len, decoded_pdu, &error_code, &error_class,
-                    &err_desc);
-                if (res) {
-                    ctx->event_func(
-                        BSC_NODE_SWITCH_EVENT_RECEIVED, ctx, ctx->user_arg,
-                        NULL, p_pdu, pdu_len, decoded_pdu);
-                }
-            }
+            /* add origin address in place, into the BSC_PRE bytes that
+               are reserved behind the received pdu */
+            p_pdu = pdu;
+            pdu_len =
+                bvlc_sc_set_orig_decoded(&p_pdu, pdu_len, &c->vmac, decoded_pdu);
+            ctx->event_func(
+                BSC_NODE_SWITCH_EVENT_RECEIVED, ctx, ctx->user_arg, NULL, p_pdu,
+                pdu_len, decoded_pdu);
         } else if (ev == BSC_SOCKET_EVENT_DISCONNECTED) {
             node_switch_update_status(
                 ctx, false, false, NULL, c, ev, disconnect_reason,
@@ -535,9 +529,22 @@ static int node_switch_initiator_find_connection_index_for_vmac(
 static int node_switch_acceptor_find_connection_index_for_vmac(
     BACNET_SC_VMAC_ADDRESS *vmac, BSC_NODE_SWITCH_CTX *ctx)
 {
-    int i;
+    BSC_SOCKET *c;
+    size_t i;
 
-    for (i = 0; i < sizeof(ctx->acceptor.sock) / sizeof(BSC_SOCKET); i++) {
+    if (!ctx->acceptor.sock) {
+        return -1;
+    }
+    c = bsc_find_socket_for_vmac(&ctx->acceptor.ctx, vmac);
+    if (!c) {
+        return -1;
+    }
+    if (c->state == BSC_SOCK_STATE_CONNECTED) {
+        return (int)(c - ctx->acceptor.sock);
+    }
+    /* another socket of the peer may be connected while this one is
+       going away */
+    for (i = 0; i < ctx->acceptor.sock_num; i++) {
         if (ctx->acceptor.sock[i].state == BSC_SOCK_STATE_CONNECTED &&
             !memcmp(
                 &ctx->acceptor.sock[i].vmac.address[0], &vmac->address[0],
@@ -680,6 +687,162 @@ static void node_switch_initiator_runloop(BSC_NODE_SWITCH_CTX *ns)
     }
 }
 
+/**
+ * @brief Close a connection of the node switch initiator
+ * @param ns - pointer to the node switch context
+ * @param index - socket index
+ */
+static void node_switch_initiator_disconnect(BSC_NODE_SWITCH_CTX *ns, int index)
+{
+    if (ns->initiator.sock_state[index] !=
+        BSC_NODE_SWITCH_CONNECTION_STATE_LOCAL_DISCONNECT) {
+        if (ns->initiator.sock_state[index] ==
+                BSC_NODE_SWITCH_CONNECTION_STATE_CONNECTED ||
+            ns->initiator.sock_state[index] ==
+                BSC_NODE_SWITCH_CONNECTION_STATE_WAIT_CONNECTION) {
+            bsc_disconnect(&ns->initiator.sock[index]);
+            ns->initiator.sock_state[index] =
+                BSC_NODE_SWITCH_CONNECTION_STATE_LOCAL_DISCONNECT;
+        } else {
+            ns->initiator.sock_state[index] =
+                BSC_NODE_SWITCH_CONNECTION_STATE_IDLE;
+            ns->initiator.auto_link[index] = false;
+            ns->event_func(
+                BSC_NODE_SWITCH_EVENT_DISCONNECTED, ns, ns->user_arg,
+                &ns->initiator.dest_vmac[index], NULL, 0, NULL);
+        }
+    }
+}
+
+/**
+ * @brief Count the octets of a unicast PDU that is sent to a peer
+ *  through the hub
+ * @param ns - pointer to the node switch context
+ * @param dest - pointer to the VMAC address of the peer
+ * @param pdu_len - PDU length
+ */
+static void node_switch_auto_count(
+    BSC_NODE_SWITCH_CTX *ns, BACNET_SC_VMAC_ADDRESS *dest, size_t pdu_len)
+{
+    BSC_NODE_SWITCH_PEER *p;
+    size_t i;
+
+    if (!bsc_node_switch_auto_rate || !ns->direct_connect_initiate_enable) {
+        return;
+    }
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_AUTO_PEERS_NUM; i++) {
+        if (ns->peer[i].used &&
+            !memcmp(
+                &ns->peer[i].vmac.address[0], &dest->address[0],
+                sizeof(dest->address))) {
+            ns->peer[i].octets += pdu_len;
+            return;
+        }
+    }
+    /* a new peer takes a free entry, or else the entry of the peer with
+       the least traffic and its count, so that many light peers do not
+       push a heavy peer out of the table */
+    p = &ns->peer[0];
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_AUTO_PEERS_NUM; i++) {
+        if (!ns->peer[i].used) {
+            p = &ns->peer[i];
+            p->octets = 0;
+            break;
+        }
+        if (ns->peer[i].octets < p->octets) {
+            p = &ns->peer[i];
+        }
+    }
+    p->used = true;
+    memcpy(&p->vmac.address[0], &dest->address[0], sizeof(dest->address));
+    p->octets += pdu_len;
+}
+
+/**
+ * @brief Open direct connections to the peers that were sent more than
+ *  the rate through the hub in the window that ended, and start the
+ *  next window
+ * @param ns - pointer to the node switch context
+ * @param window_s - number of seconds in the window
+ */
+static void node_switch_auto_connect(BSC_NODE_SWITCH_CTX *ns, uint16_t window_s)
+{
+    BSC_NODE_SWITCH_PEER *p;
+    size_t links = 0;
+    size_t i;
+    int index;
+
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM; i++) {
+        if (ns->initiator.auto_link[i]) {
+            links++;
+        }
+    }
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_AUTO_PEERS_NUM; i++) {
+        p = &ns->peer[i];
+        if (p->used && bsc_node_switch_auto_rate &&
+            (p->octets / window_s) >= bsc_node_switch_auto_rate &&
+            links < bsc_node_switch_auto_links_num &&
+            node_switch_initiator_find_connection_index_for_vmac(
+                &p->vmac, ns) == -1 &&
+            node_switch_acceptor_find_connection_index_for_vmac(
+                &p->vmac, ns) == -1) {
+            index = node_switch_initiator_alloc_sock(ns);
+            if (index != -1) {
+                DEBUG_PRINTF(
+                    "node_switch_auto_connect() %lu octets/s to %s\n",
+                    (unsigned long)(p->octets / window_s),
+                    bsc_vmac_to_string(&p->vmac));
+                ns->initiator.auto_link[index] = true;
+                ns->initiator.idle_s[index] = 0;
+                ns->initiator.urls[index].urls_cnt = 0;
+                memcpy(
+                    &ns->initiator.dest_vmac[index].address[0],
+                    &p->vmac.address[0], BVLC_SC_VMAC_SIZE);
+                node_switch_connect_or_delay(ns, &p->vmac, index);
+                links++;
+            }
+        }
+        p->used = false;
+        p->octets = 0;
+    }
+}
+
+/**
+ * @brief Close the direct connections that were opened for the traffic
+ *  to a peer and have been idle for the idle time, and open new ones at
+ *  the end of each window
+ * @param ns - pointer to the node switch context
+ * @param seconds - number of seconds elapsed from the previous call
+ */
+static void node_switch_auto_runloop(BSC_NODE_SWITCH_CTX *ns, uint16_t seconds)
+{
+    int i;
+
+    if (ns->initiator.state != BSC_NODE_SWITCH_STATE_STARTED) {
+        return;
+    }
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM; i++) {
+        if (ns->initiator.auto_link[i]) {
+            if (ns->initiator.sock_state[i] ==
+                BSC_NODE_SWITCH_CONNECTION_STATE_IDLE) {
+                ns->initiator.auto_link[i] = false;
+            } else {
+                if (ns->initiator.idle_s[i] < bsc_node_switch_auto_idle_s) {
+                    ns->initiator.idle_s[i] += seconds;
+                }
+                if (ns->initiator.idle_s[i] >= bsc_node_switch_auto_idle_s) {
+                    node_switch_initiator_disconnect(ns, i);
+                }
+            }
+        }
+    }
+    ns->auto_window_s += seconds;
+    if (ns->auto_window_s >= BSC_CONF_NODE_SWITCH_AUTO_WINDOW_S) {
+        node_switch_auto_connect(ns, ns->auto_window_s);
+        ns->auto_window_s = 0;
+    }
+}
+
 /**
  * @brief Run the node switch maintenance timer
  * @param seconds - number of seconds elapsed from the previous call
@@ -687,12 +850,12 @@ static void node_switch_initiator_runloop(BSC_NODE_SWITCH_CTX *ns)
 void bsc_node_switch_maintenance_timer(uint16_t seconds)
 {
     int i;
-    (void)seconds;
 
     bws_dispatch_lock();
     for (i = 0; i < BSC_CONF_NODE_SWITCHES_NUM; i++) {
         if (bsc_node_switch[i].used) {
             node_switch_initiator_runloop(&bsc_node_switch[i]);
+            node_switch_auto_runloop(&bsc_node_switch[i], seconds);
         }
     }
     bws_dispatch_unlock();
@@ -721,10 +884,6 @@ static void node_switch_initiator_socket_event(
     uint8_t *p_pdu = NULL;
     BSC_NODE_SWITCH_CTX *ns;
     int elem;
-    uint16_t error_class;
-    uint16_t error_code;
-    const char *err_desc;
-    bool res;
 
     DEBUG_PRINTF(
         "node_switch_initiator_socket_event() >>> c %p, ev = %d\n", c, ev);
@@ -740,19 +899,18 @@ static void node_switch_initiator_socket_event(
                 BSC_NODE_SWITCH_EVENT_DUPLICATED_VMAC, ns, ns->user_arg, NULL,
                 NULL, 0, NULL);
         } else if (ev == BSC_SOCKET_EVENT_RECEIVED) {
-            if (bsc_socket_get_global_buf_size() >= pdu_len) {
-                p_pdu = bsc_socket_get_global_buf();
-                memcpy(p_pdu, pdu, pdu_len);
-                pdu_len = bvlc_sc_set_orig(&p_pdu, pdu_len, &c->vmac);
-                res = bvlc_sc_decode_message(
-                    p_pdu, pdu_len, decoded_pdu, &error_code, &error_class,
-                    &err_desc);
-                if (res) {
-                    ns->event_func(
-                        BSC_NODE_SWITCH_EVENT_RECEIVED, ns, ns->user_arg, NULL,
-                        p_pdu, pdu_len, decoded_pdu);
-                }
+            index = node_switch_initiator_get_index(ns, c);
+            if (index > -1) {
+                ns->initiator.idle_s[index] = 0;
             }
+            /* add origin address in place, into the BSC_PRE bytes that
+               are reserved behind the received pdu */
+            p_pdu = pdu;
+            pdu_len =
+                bvlc_sc_set_orig_decoded(&p_pdu, pdu_len, &c->vmac, decoded_pdu);
+            ns->event_func(
+                BSC_NODE_SWITCH_EVENT_RECEIVED, ns, ns->user_arg, NULL, p_pdu,
+                pdu_len, decoded_pdu);
         }
 
         index = node_switch_initiator_get_index(ns, c);
@@ -821,6 +979,7 @@ static void node_switch_initiator_socket_event(
                         c, ev, ERROR_CODE_SUCCESS, NULL);
                     ns->initiator.sock_state[index] =
                         BSC_NODE_SWITCH_CONNECTION_STATE_IDLE;
+                    ns->initiator.auto_link[index] = false;
                     ns->event_func(
                         BSC_NODE_SWITCH_EVENT_DISCONNECTED, ns, ns->user_arg,
                         &ns->initiator.dest_vmac[index], NULL, 0, NULL);
@@ -955,6 +1114,18 @@ BSC_SC_RET bsc_node_switch_start(
     ns->initiator.state = BSC_NODE_SWITCH_STATE_IDLE;
     ns->acceptor.state = BSC_NODE_SWITCH_STATE_IDLE;
 
+    if (direct_connect_accept_enable) {
+        ns->acceptor.sock_num = bsc_node_switch_connections_num;
+        ns->acceptor.sock = calloc(ns->acceptor.sock_num, sizeof(BSC_SOCKET));
+        if (!ns->acceptor.sock) {
+            node_switch_free(ns);
+            bws_dispatch_unlock();
+            DEBUG_PRINTF(
+                "bsc_node_switch_start() <<< ret = BSC_SC_NO_RESOURCES\n");
+            return BSC_SC_NO_RESOURCES;
+        }
+    }
+
     if (direct_connect_initiate_enable) {
         bsc_init_ctx_cfg(
             BSC_SOCKET_CTX_INITIATOR, &ns->initiator.cfg,
@@ -981,7 +1152,7 @@ BSC_SC_RET bsc_node_switch_start(
         ret = bsc_init_ctx(
             &ns->acceptor.ctx, &ns->acceptor.cfg,
             &bsc_node_switch_acceptor_ctx_funcs, ns->acceptor.sock,
-            sizeof(ns->acceptor.sock) / sizeof(BSC_SOCKET), ns);
+            ns->acceptor.sock_num, ns);
         if (ret == BSC_SC_SUCCESS) {
             ns->acceptor.state = BSC_NODE_SWITCH_STATE_STARTING;
         }
@@ -1132,6 +1303,7 @@ BSC_SC_RET bsc_node_switch_connect(
             if (i == -1) {
                 ret = BSC_SC_NO_RESOURCES;
             } else {
+                ns->initiator.auto_link[i] = false;
                 copy_urls2(ns, i, urls, urls_cnt);
                 ns->initiator.urls[i].url_elem = 0;
                 node_switch_connect_or_delay(ns, NULL, i);
@@ -1140,12 +1312,16 @@ BSC_SC_RET bsc_node_switch_connect(
         } else {
             i = node_switch_initiator_find_connection_index_for_vmac(dest, ns);
             if (i != -1) {
+                /* a connection that was opened for the traffic is kept
+                   open from now on */
+                ns->initiator.auto_link[i] = false;
                 ret = BSC_SC_SUCCESS;
             } else {
                 i = node_switch_initiator_alloc_sock(ns);
                 if (i == -1) {
                     ret = BSC_SC_NO_RESOURCES;
                 } else {
+                    ns->initiator.auto_link[i] = false;
                     ns->initiator.urls[i].urls_cnt = 0;
                     node_switch_connect_or_delay(ns, dest, i);
                     ret = BSC_SC_SUCCESS;
@@ -1200,7 +1376,6 @@ void bsc_node_switch_disconnect(
     BSC_NODE_SWITCH_HANDLE h, BACNET_SC_VMAC_ADDRESS *dest)
 {
     BSC_NODE_SWITCH_CTX *ns;
-    BSC_SOCKET *c;
     int i;
 
     DEBUG_PRINTF(
@@ -1212,24 +1387,7 @@ void bsc_node_switch_disconnect(
         i = node_switch_initiator_find_connection_index_for_vmac(dest, ns);
 
         if (i != -1) {
-            if (ns->initiator.sock_state[i] !=
-                BSC_NODE_SWITCH_CONNECTION_STATE_LOCAL_DISCONNECT) {
-                if (ns->initiator.sock_state[i] ==
-                        BSC_NODE_SWITCH_CONNECTION_STATE_CONNECTED ||
-                    ns->initiator.sock_state[i] ==
-                        BSC_NODE_SWITCH_CONNECTION_STATE_WAIT_CONNECTION) {
-                    c = &ns->initiator.sock[i];
-                    bsc_disconnect(c);
-                    ns->initiator.sock_state[i] =
-                        BSC_NODE_SWITCH_CONNECTION_STATE_LOCAL_DISCONNECT;
-                } else {
-                    ns->initiator.sock_state[i] =
-                        BSC_NODE_SWITCH_CONNECTION_STATE_IDLE;
-                    ns->event_func(
-                        BSC_NODE_SWITCH_EVENT_DISCONNECTED, ns, ns->user_arg,
-                        &ns->initiator.dest_vmac[i], NULL, 0, NULL);
-                }
-            }
+            node_switch_initiator_disconnect(ns, i);
         }
     }
 
@@ -1268,6 +1426,7 @@ bsc_node_switch_send(BSC_NODE_SWITCH_HANDLE h, uint8_t *pdu, size_t pdu_len)
                 ns->initiator.sock_state[i] ==
                     BSC_NODE_SWITCH_CONNECTION_STATE_CONNECTED) {
                 c = &ns->initiator.sock[i];
+                ns->initiator.idle_s[i] = 0;
             }
             if (!c) {
                 c = node_switch_acceptor_find_connection_for_vmac(&dest, ns);
@@ -1278,6 +1437,7 @@ bsc_node_switch_send(BSC_NODE_SWITCH_HANDLE h, uint8_t *pdu, size_t pdu_len)
                     ret = bsc_send(c, *ppdu, pdu_len);
                 }
             } else {
+                node_switch_auto_count(ns, &dest, pdu_len);
                 ret = bsc_node_hub_connector_send(ns->user_arg, pdu, pdu_len);
             }
         }
@@ -1361,3 +1521,84 @@ bool bsc_node_switch_connected(
     bws_dispatch_unlock();
     return ret;
 }
+
+/**
+ * @brief Set the number of connections that the node switches which start
+ *  afterwards accept. The connections are allocated when a node switch
+ *  starts.
+ * @param num - number of connections, greater than zero
+ */
+void bsc_node_switch_connections_set(size_t num)
+{
+    if (num > 0) {
+        bws_dispatch_lock();
+        bsc_node_switch_connections_num = num;
+        bws_dispatch_unlock();
+    }
+}
+
+/**
+ * @brief Get the number of connections that the node switches which start
+ *  next accept
+ * @return number of connections
+ */
+size_t bsc_node_switch_connections(void)
+{
+    size_t num;
+
+    bws_dispatch_lock();
+    num = bsc_node_switch_connections_num;
+    bws_dispatch_unlock();
+
+    return num;
+}
+
+/**
+ * @brief Open direct connections to the peers that this node sends the
+ *  most unicast traffic to through the hub. A connection is opened to a
+ *  peer through the address resolution of its VMAC when the traffic in
+ *  a window of BSC_CONF_NODE_SWITCH_AUTO_WINDOW_S seconds is more than
+ *  the rate, and is closed when nothing is sent or received on it for
+ *  the idle time. The connections are opened only by a node switch that
+ *  initiates direct connections.
+ * @param rate - octets per second to a peer, or zero to open direct
+ *  connections only on request
+ * @param links - maximum number of connections that are open at a time
+ *  for the traffic
+ * @param idle_s - seconds that a connection is idle before it is closed
+ */
+void bsc_node_switch_auto_connect_set(
+    uint32_t rate, size_t links, uint16_t idle_s)
+{
+    bws_dispatch_lock();
+    bsc_node_switch_auto_rate = rate;
+    bsc_node_switch_auto_links_num = links;
+    bsc_node_switch_auto_idle_s = idle_s;
+    bws_dispatch_unlock();
+}
+
+/**
+ * @brief Get the number of connected direct connections of a node switch
+ *  that were opened for the traffic to a peer
+ * @param h - pointer to the node switch handle
+ * @return number of connections
+ */
+size_t bsc_node_switch_auto_connections(BSC_NODE_SWITCH_HANDLE h)
+{
+    BSC_NODE_SWITCH_CTX *ns;
+    size_t num = 0;
+    size_t i;
+
+    bws_dispatch_lock();
+    ns = (BSC_NODE_SWITCH_CTX *)h;
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_CONNECTIONS_NUM; i++) {
+        if (ns->initiator.auto_link[i] &&
+            ns->initiator.sock_state[i] ==
+                BSC_NODE_SWITCH_CONNECTION_STATE_CONNECTED) {
+            num++;
+        }
+    }
+    bws_dispatch_unlock();
+
+    return num;
+}
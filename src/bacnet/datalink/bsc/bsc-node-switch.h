@@ -116,6 +116,19 @@ BACNET_STACK_EXPORT
 void bsc_node_switch_process_address_resolution(
     BSC_NODE_SWITCH_HANDLE h, BSC_ADDRESS_RESOLUTION *r);
 
+BACNET_STACK_EXPORT
+void bsc_node_switch_connections_set(size_t num);
+
+BACNET_STACK_EXPORT
+size_t bsc_node_switch_connections(void);
+
+BACNET_STACK_EXPORT
+void bsc_node_switch_auto_connect_set(
+    uint32_t rate, size_t links, uint16_t idle_s);
+
+BACNET_STACK_EXPORT
+size_t bsc_node_switch_auto_connections(BSC_NODE_SWITCH_HANDLE h);
+
 BACNET_STACK_EXPORT
 BSC_SC_RET
 bsc_node_switch_send(BSC_NODE_SWITCH_HANDLE h, uint8_t *pdu, size_t pdu_len);
@@ -15,6 +15,7 @@
 #include "bacnet/datalink/bsc/bsc-node-switch.h"
 #include "bacnet/datalink/bsc/bsc-socket.h"
 #include "bacnet/basic/object/sc_netport.h"
+#include "bacnet/basic/sys/keyhash.h"
 #include "bacnet/bacdef.h"
 #include "bacnet/npdu.h"
 #include "bacnet/bacenum.h"
@@ -40,12 +41,15 @@ struct BSC_Node {
     BSC_NODE_STATE state;
     BSC_NODE_CONF *conf;
     BSC_ADDRESS_RESOLUTION *resolution;
+    OS_Keyhash *resolution_index;
     BSC_HUB_CONNECTOR_HANDLE hub_connector;
     BSC_HUB_FUNCTION_HANDLE hub_function;
     BSC_NODE_SWITCH_HANDLE node_switch;
     BACNET_SC_FAILED_CONNECTION_REQUEST *failed;
     BACNET_SC_DIRECT_CONNECTION_STATUS *direct_status;
+    OS_Keyhash *direct_status_index;
     BACNET_SC_HUB_FUNCTION_CONNECTION_STATUS *hub_status;
+    OS_Keyhash *hub_status_index;
 };
 
 #if defined(BSC_CONF_NODES_NUM) && (BSC_CONF_NODES_NUM < 1)
@@ -73,18 +77,99 @@ static BSC_ADDRESS_RESOLUTION
     bsc_address_resolution[BSC_CONF_NODES_NUM]
                           [BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM];
 
+/* indexes of the entries of the tables above by the VMAC address of the
+   peer, which live as long as their tables.  Without an index, a table
+   is searched entry by entry. */
+static OS_Keyhash bsc_direct_status_index[BSC_CONF_NODES_NUM];
+static OS_Keyhash bsc_hub_status_index[BSC_CONF_NODES_NUM];
+static OS_Keyhash bsc_address_resolution_index[BSC_CONF_NODES_NUM];
+
 static BSC_NODE_CONF bsc_conf[BSC_CONF_NODES_NUM];
 
 static BSC_SC_RET bsc_node_start_state(BSC_NODE *node, BSC_NODE_STATE state);
 
+/**
+ * @brief Get the hash of a VMAC address for the indexes of a node
+ * @param vmac - pointer to the VMAC address
+ * @return hash of the VMAC address
+ */
+static uint32_t node_vmac_hash(const uint8_t *vmac)
+{
+    return Keyhash_FNV1a(vmac, BVLC_SC_VMAC_SIZE);
+}
+
+/**
+ * @brief Create an index of a node table, or empty an existing one
+ * @param index - pointer to the index
+ */
+static void node_index_reset(OS_Keyhash *index)
+{
+    if (*index) {
+        Keyhash_Clear(*index);
+    } else {
+        *index = Keyhash_Create();
+    }
+}
+
+/**
+ * @brief Add an entry of a node table to the index of the table
+ * @param index - pointer to the index
+ * @param vmac - VMAC address of the entry
+ * @param entry - position of the entry in the table
+ */
+static void node_index_add(OS_Keyhash *index, const uint8_t *vmac, int entry)
+{
+    if (*index && !Keyhash_Add(*index, node_vmac_hash(vmac), (KEY)entry)) {
+        /* without memory for the index, search the table */
+        Keyhash_Delete(*index);
+        *index = NULL;
+    }
+}
+
+/**
+ * @brief Remove an entry of a node table from the index of the table
+ * @param index - pointer to the index
+ * @param vmac - VMAC address of the entry
+ * @param entry - position of the entry in the table
+ */
+static void
+node_index_remove(OS_Keyhash *index, const uint8_t *vmac, int entry)
+{
+    if (*index) {
+        (void)Keyhash_Remove(*index, node_vmac_hash(vmac), (KEY)entry);
+    }
+}
+
+/**
+ * @brief Get the next entry of a node table that may have a VMAC address
+ * @param index - pointer to the index
+ * @param vmac - VMAC address to look for
+ * @param iterator - [in,out] position of the search, 0 to start
+ * @param entry - [out] position of the entry in the table
+ * @return true if a candidate entry was found, which the caller confirms
+ */
+static bool node_index_next(
+    OS_Keyhash *index, const uint8_t *vmac, unsigned *iterator, int *entry)
+{
+    KEY key = 0;
+
+    if (Keyhash_Find(*index, node_vmac_hash(vmac), iterator, &key)) {
+        *entry = (int)key;
+        return true;
+    }
+    return false;
+}
+
 /**
  * @brief Initialize direct connection status
  * @param s - pointer to the direct connection status
  */
-static void bsc_node_init_direct_status(BACNET_SC_DIRECT_CONNECTION_STATUS *s)
+static void bsc_node_init_direct_status(
+    BACNET_SC_DIRECT_CONNECTION_STATUS *s, OS_Keyhash *index)
 {
     int j;
 
+    node_index_reset(index);
     for (j = 0; j < BSC_CONF_NODE_SWITCH_CONNECTION_STATUS_MAX_NUM; j++) {
         memset(&s[j], 0, sizeof(*s));
         memset(&s[j].Connect_Timestamp, 0xFF, sizeof(s[j].Connect_Timestamp));
@@ -99,10 +184,12 @@ static void bsc_node_init_direct_status(BACNET_SC_DIRECT_CONNECTION_STATUS *s)
  * @param s - pointer to the hub connection status
  */
 static void
-bsc_node_init_hub_status(BACNET_SC_HUB_FUNCTION_CONNECTION_STATUS *s)
+bsc_node_init_hub_status(
+    BACNET_SC_HUB_FUNCTION_CONNECTION_STATUS *s, OS_Keyhash *index)
 {
     int j;
 
+    node_index_reset(index);
     for (j = 0; j < BSC_CONF_HUB_FUNCTION_CONNECTION_STATUS_MAX_NUM; j++) {
         memset(&s[j], 0, sizeof(*s));
         memset(&s[j].Connect_Timestamp, 0xFF, sizeof(s[j].Connect_Timestamp));
@@ -129,26 +216,32 @@ static BSC_NODE *bsc_alloc_node(void)
                                           *)&bsc_hub_status[i][0];
             bsc_node[i].direct_status =
                 (BACNET_SC_DIRECT_CONNECTION_STATUS *)&bsc_direct_status[i][0];
+            bsc_node[i].hub_status_index = &bsc_hub_status_index[i];
+            bsc_node[i].direct_status_index = &bsc_direct_status_index[i];
 
             /* Start/stop cycles of a node must not make an influence to history
                That's why hub and direct status arrays are initialized
                only once */
 
             if (!bsc_hub_status_initialized[i]) {
-                bsc_node_init_hub_status(bsc_node[i].hub_status);
+                bsc_node_init_hub_status(
+                    bsc_node[i].hub_status, bsc_node[i].hub_status_index);
             }
 
             if (!bsc_direct_status_initialized[i]) {
-                bsc_node_init_direct_status(bsc_node[i].direct_status);
+                bsc_node_init_direct_status(
+                    bsc_node[i].direct_status, bsc_node[i].direct_status_index);
             }
 
             bsc_node[i].conf = &bsc_conf[i];
             bsc_node[i].resolution = &bsc_address_resolution[i][0];
+            bsc_node[i].resolution_index = &bsc_address_resolution_index[i];
             bsc_node[i].failed = &bsc_failed_request[i][0];
             memset(
                 bsc_node[i].resolution, 0,
                 sizeof(BSC_ADDRESS_RESOLUTION) *
                     BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM);
+            node_index_reset(bsc_node[i].resolution_index);
 
             /* Start/stop cycles of a node must not make an influence to history
              * about failed requests */
@@ -200,7 +293,21 @@ static BSC_ADDRESS_RESOLUTION *
 node_get_address_resolution(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
 {
     int i;
-
+    unsigned iterator = 0;
+
+    if (*node->resolution_index) {
+        while (node_index_next(
+            node->resolution_index, &vmac->address[0], &iterator, &i)) {
+            if ((i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM) &&
+                node->resolution[i].used &&
+                !memcmp(
+                    &vmac->address[0], &node->resolution[i].vmac.address[0],
+                    BVLC_SC_VMAC_SIZE)) {
+                return &node->resolution[i];
+            }
+        }
+        return NULL;
+    }
     for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
         if (node->resolution[i].used &&
             !memcmp(
@@ -214,12 +321,19 @@ node_get_address_resolution(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
 
 /**
  * @brief Free the address resolution
+ * @param node - pointer to the BACnet/SC node
  * @param r - pointer to the address resolution
  */
-static void node_free_address_resolution(BSC_ADDRESS_RESOLUTION *r)
+static void
+node_free_address_resolution(BSC_NODE *node, BSC_ADDRESS_RESOLUTION *r)
 {
+    if (r->used) {
+        node_index_remove(
+            node->resolution_index, &r->vmac.address[0],
+            (int)(r - node->resolution));
+    }
     r->used = false;
-    r->urls_num = false;
+    r->urls_num = 0;
 }
 
 /**
@@ -237,28 +351,31 @@ node_alloc_address_resolution(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
 
     for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
         if (!node->resolution[i].used) {
-            node->resolution[i].used = true;
-            mstimer_set(
-                &node->resolution[i].fresh_timer,
-                node->conf->address_resolution_freshness_timeout_s * 1000);
-            memcpy(
-                &node->resolution[i].vmac.address[0], &vmac->address[0],
-                BVLC_SC_VMAC_SIZE);
-            return &node->resolution[i];
+            break;
         }
     }
 
-    /* find and remove oldest resolution */
-
-    for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
-        if (mstimer_elapsed(&node->resolution[i].fresh_timer) > max) {
-            max = mstimer_elapsed(&node->resolution[i].fresh_timer);
-            max_index = i;
+    if (i == BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM) {
+        /* find and remove oldest resolution */
+        for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
+            if (mstimer_elapsed(&node->resolution[i].fresh_timer) > max) {
+                max = mstimer_elapsed(&node->resolution[i].fresh_timer);
+                max_index = i;
+            }
         }
+        i = max_index;
+        node_free_address_resolution(node, &node->resolution[i]);
     }
 
-    node->resolution[max_index].urls_num = 0;
-    return &node->resolution[max_index];
+    node->resolution[i].used = true;
+    mstimer_set(
+        &node->resolution[i].fresh_timer,
+        node->conf->address_resolution_freshness_timeout_s * 1000);
+    memcpy(
+        &node->resolution[i].vmac.address[0], &vmac->address[0],
+        BVLC_SC_VMAC_SIZE);
+    node_index_add(node->resolution_index, &vmac->address[0], i);
+    return &node->resolution[i];
 }
 
 /**
@@ -840,6 +957,7 @@ static BSC_SC_RET bsc_node_start_state(BSC_NODE *node, BSC_NODE_STATE state)
             node->resolution, 0,
             sizeof(BSC_ADDRESS_RESOLUTION) *
                 BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM);
+        node_index_reset(node->resolution_index);
     } else {
         bsc_generate_random_vmac(&node->conf->local_vmac);
         DEBUG_PRINTF(
@@ -856,6 +974,7 @@ static BSC_SC_RET bsc_node_start_state(BSC_NODE *node, BSC_NODE_STATE state)
             node->conf->max_local_npdu_len, node->conf->connect_timeout_s,
             node->conf->heartbeat_timeout_s, node->conf->disconnect_timeout_s,
             node->conf->primaryURL, node->conf->failoverURL,
+            node->conf->min_reconnect_timeout_s,
             node->conf->reconnnect_timeout_s, bsc_hub_connector_event, node,
             &node->hub_connector);
 
@@ -1075,7 +1194,7 @@ BSC_SC_RET bsc_node_send(BSC_NODE *p_node, uint8_t *pdu, size_t pdu_len)
 BSC_ADDRESS_RESOLUTION *
 bsc_node_get_address_resolution(void *p_node, BACNET_SC_VMAC_ADDRESS *vmac)
 {
-    int i;
+    BSC_ADDRESS_RESOLUTION *r;
     BSC_NODE *node = (BSC_NODE *)p_node;
     bws_dispatch_lock();
 
@@ -1083,23 +1202,13 @@ bsc_node_get_address_resolution(void *p_node, BACNET_SC_VMAC_ADDRESS *vmac)
         bws_dispatch_unlock();
         return NULL;
     }
-    for (i = 0; i < BSC_CONF_SERVER_DIRECT_CONNECTIONS_MAX_NUM; i++) {
-        if (node->resolution[i].used &&
-            !memcmp(
-                &vmac->address[0], &node->resolution[i].vmac.address[0],
-                BVLC_SC_VMAC_SIZE)) {
-            if (!mstimer_expired(&node->resolution[i].fresh_timer)) {
-                bws_dispatch_unlock();
-                return &node->resolution[i];
-            } else {
-                node_free_address_resolution(&node->resolution[i]);
-                bws_dispatch_unlock();
-                return NULL;
-            }
-        }
+    r = node_get_address_resolution(node, vmac);
+    if (r && mstimer_expired(&r->fresh_timer)) {
+        node_free_address_resolution(node, r);
+        r = NULL;
     }
     bws_dispatch_unlock();
-    return NULL;
+    return r;
 }
 
 /**
@@ -1381,13 +1490,35 @@ bsc_node_failed_requests_status(BSC_NODE *node, size_t *cnt)
 }
 
 /**
- * @brief Find the BACnet/SC node direct connection status for the VMAC address
+ * @brief Give an entry of a connection status table to a VMAC address
+ * @param index - pointer to the index of the table
+ * @param peer_vmac - VMAC address of the entry
+ * @param vmac - pointer to the VMAC address that gets the entry
+ * @param entry - position of the entry in the table
+ */
+static void node_status_bind(
+    OS_Keyhash *index,
+    uint8_t *peer_vmac,
+    BACNET_SC_VMAC_ADDRESS *vmac,
+    int entry)
+{
+    if (memcmp(peer_vmac, &vmac->address[0], BVLC_SC_VMAC_SIZE)) {
+        node_index_remove(index, peer_vmac, entry);
+        memcpy(peer_vmac, &vmac->address[0], BVLC_SC_VMAC_SIZE);
+    }
+    if (*index && !Keyhash_Member(*index, node_vmac_hash(peer_vmac), entry)) {
+        node_index_add(index, peer_vmac, entry);
+    }
+}
+
+/**
+ * @brief Choose the direct connection status entry for the VMAC address
  * @param node - pointer to the BACnet/SC node
  * @param vmac - pointer to the VMAC address
- * @return pointer to the direct connection status
+ * @return position of the entry in the direct connection status table
  */
-BACNET_SC_DIRECT_CONNECTION_STATUS *bsc_node_find_direct_status_for_vmac(
-    BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
+static int
+node_direct_status_entry(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
 {
     int i;
     int index = -1;
@@ -1397,12 +1528,12 @@ BACNET_SC_DIRECT_CONNECTION_STATUS *bsc_node_find_direct_status_for_vmac(
         if (!datetime_is_valid(
                 &node->direct_status[i].Connect_Timestamp.date,
                 &node->direct_status[i].Connect_Timestamp.time)) {
-            return &node->direct_status[i];
+            return i;
         }
         if (!memcmp(
                 &node->direct_status[i].Peer_VMAC[0], &vmac->address[0],
                 BVLC_SC_VMAC_SIZE)) {
-            return &node->direct_status[i];
+            return i;
         }
     }
 
@@ -1428,7 +1559,7 @@ BACNET_SC_DIRECT_CONNECTION_STATUS *bsc_node_find_direct_status_for_vmac(
     }
 
     if (index != -1) {
-        return &node->direct_status[index];
+        return index;
     }
 
     /* ok, all entries are already filled and all are in connected state,
@@ -1449,17 +1580,45 @@ BACNET_SC_DIRECT_CONNECTION_STATUS *bsc_node_find_direct_status_for_vmac(
         }
     }
 
-    return &node->direct_status[index];
+    return index;
 }
 
 /**
- * @brief Find the BACnet/SC node hub function status for the VMAC address
+ * @brief Find the BACnet/SC node direct connection status for the VMAC address
  * @param node - pointer to the BACnet/SC node
  * @param vmac - pointer to the VMAC address
- * @return pointer to the hub function status
+ * @return pointer to the direct connection status
  */
-BACNET_SC_HUB_FUNCTION_CONNECTION_STATUS *
-bsc_node_find_hub_status_for_vmac(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
+BACNET_SC_DIRECT_CONNECTION_STATUS *bsc_node_find_direct_status_for_vmac(
+    BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
+{
+    int i;
+    unsigned iterator = 0;
+    BACNET_SC_DIRECT_CONNECTION_STATUS *s = node->direct_status;
+
+    if (*node->direct_status_index) {
+        while (node_index_next(
+            node->direct_status_index, &vmac->address[0], &iterator, &i)) {
+            if ((i < BSC_CONF_NODE_SWITCH_CONNECTION_STATUS_MAX_NUM) &&
+                !memcmp(
+                    &s[i].Peer_VMAC[0], &vmac->address[0],
+                    BVLC_SC_VMAC_SIZE)) {
+                return &s[i];
+            }
+        }
+    }
+    i = node_direct_status_entry(node, vmac);
+    node_status_bind(node->direct_status_index, &s[i].Peer_VMAC[0], vmac, i);
+    return &s[i];
+}
+
+/**
+ * @brief Choose the hub function status entry for the VMAC address
+ * @param node - pointer to the BACnet/SC node
+ * @param vmac - pointer to the VMAC address
+ * @return position of the entry in the hub function status table
+ */
+static int node_hub_status_entry(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
 {
     int i;
     int index = -1;
@@ -1469,12 +1628,12 @@ bsc_node_find_hub_status_for_vmac(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
         if (!datetime_is_valid(
                 &node->hub_status[i].Connect_Timestamp.date,
                 &node->hub_status[i].Connect_Timestamp.time)) {
-            return &node->hub_status[i];
+            return i;
         }
         if (!memcmp(
                 &node->hub_status[i].Peer_VMAC[0], &vmac->address[0],
                 BVLC_SC_VMAC_SIZE)) {
-            return &node->hub_status[i];
+            return i;
         }
     }
 
@@ -1499,7 +1658,7 @@ bsc_node_find_hub_status_for_vmac(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
     }
 
     if (index != -1) {
-        return &node->hub_status[index];
+        return index;
     }
 
     /* ok, all entries are already filled and all are in connected state,
@@ -1519,5 +1678,34 @@ bsc_node_find_hub_status_for_vmac(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
         }
     }
 
-    return &node->hub_status[index];
+    return index;
+}
+
+/**
+ * @brief Find the BACnet/SC node hub function status for the VMAC address
+ * @param node - pointer to the BACnet/SC node
+ * @param vmac - pointer to the VMAC address
+ * @return pointer to the hub function status
+ */
+BACNET_SC_HUB_FUNCTION_CONNECTION_STATUS *
+bsc_node_find_hub_status_for_vmac(BSC_NODE *node, BACNET_SC_VMAC_ADDRESS *vmac)
+{
+    int i;
+    unsigned iterator = 0;
+    BACNET_SC_HUB_FUNCTION_CONNECTION_STATUS *s = node->hub_status;
+
+    if (*node->hub_status_index) {
+        while (node_index_next(
+            node->hub_status_index, &vmac->address[0], &iterator, &i)) {
+            if ((i < BSC_CONF_HUB_FUNCTION_CONNECTION_STATUS_MAX_NUM) &&
+                !memcmp(
+                    &s[i].Peer_VMAC[0], &vmac->address[0],
+                    BVLC_SC_VMAC_SIZE)) {
+                return &s[i];
+            }
+        }
+    }
+    i = node_hub_status_entry(node, vmac);
+    node_status_bind(node->hub_status_index, &s[i].Peer_VMAC[0], vmac, i);
+    return &s[i];
 }
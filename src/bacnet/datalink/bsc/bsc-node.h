@@ -65,6 +65,8 @@ typedef struct {
     uint16_t heartbeat_timeout_s;
     uint16_t disconnect_timeout_s;
     uint16_t reconnnect_timeout_s;
+    /* zero to always wait for reconnnect_timeout_s */
+    uint16_t min_reconnect_timeout_s;
     uint16_t address_resolution_timeout_s;
     uint16_t address_resolution_freshness_timeout_s;
     char *primaryURL;
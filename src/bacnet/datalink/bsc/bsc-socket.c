@@ -56,6 +56,111 @@ static BVLC_SC_DECODED_MESSAGE bsc_dm = { 0 };
             BSC_CONF_TX_PRE)                                        \
          : 0)
 
+/* A frame in tx_buf is a length, BSC_CONF_TX_PRE reserved bytes and the
+   PDU. A zero length frame is a reference to a shared buffer instead,
+   and is followed by the index of the shared buffer. */
+#define TX_BUF_REF_SIZE (2 * sizeof(uint16_t))
+
+#define TX_BUF_REF_AVAIL(c) \
+    ((sizeof(c->tx_buf) - c->tx_buf_size) >= TX_BUF_REF_SIZE)
+
+/* a PDU that is sent to many sockets, with a reference from each of
+   their send queues */
+typedef struct {
+    unsigned int ref_count;
+    uint16_t len;
+    uint8_t buf[BSC_CONF_TX_PRE + BSC_PRE + BVLC_SC_NPDU_SIZE_CONF];
+} BSC_SHARED_TX_BUF;
+
+static BSC_SHARED_TX_BUF
+    bsc_shared_tx_buf[BSC_CONF_SOCK_SHARED_TX_BUFFERS_NUM] = { 0 };
+
+/**
+ * @brief Get a free shared buffer
+ * @return index of the shared buffer, or -1 if there is no free buffer
+ */
+static int bsc_shared_tx_buf_alloc(void)
+{
+    int i;
+
+    for (i = 0; i < BSC_CONF_SOCK_SHARED_TX_BUFFERS_NUM; i++) {
+        if (bsc_shared_tx_buf[i].ref_count == 0) {
+            bsc_shared_tx_buf[i].ref_count = 1;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Release a reference to a shared buffer
+ * @param index - index of the shared buffer
+ */
+static void bsc_shared_tx_buf_release(uint16_t index)
+{
+    if ((index < BSC_CONF_SOCK_SHARED_TX_BUFFERS_NUM) &&
+        (bsc_shared_tx_buf[index].ref_count > 0)) {
+        bsc_shared_tx_buf[index].ref_count--;
+    }
+}
+
+/**
+ * @brief Get the PDU of a frame in the send queue of a socket
+ * @param p - pointer to the frame
+ * @param pdu_len - [out] length of the PDU
+ * @param frame_size - [out] size of the frame in the send queue
+ * @return pointer to the PDU, with BSC_CONF_TX_PRE bytes reserved before it
+ */
+static uint8_t *
+bsc_tx_frame_pdu(uint8_t *p, uint16_t *pdu_len, size_t *frame_size)
+{
+    uint16_t index;
+
+    memcpy(pdu_len, p, sizeof(*pdu_len));
+    if (*pdu_len == 0) {
+        memcpy(&index, &p[sizeof(*pdu_len)], sizeof(index));
+        *pdu_len = bsc_shared_tx_buf[index].len;
+        *frame_size = TX_BUF_REF_SIZE;
+        return &bsc_shared_tx_buf[index].buf[BSC_CONF_TX_PRE];
+    }
+    *frame_size = sizeof(*pdu_len) + BSC_CONF_TX_PRE + *pdu_len;
+    return &p[sizeof(*pdu_len) + BSC_CONF_TX_PRE];
+}
+
+/**
+ * @brief Release a frame in the send queue of a socket after it was sent
+ * @param p - pointer to the frame
+ */
+static void bsc_tx_frame_release(uint8_t *p)
+{
+    uint16_t len;
+    uint16_t index;
+
+    memcpy(&len, p, sizeof(len));
+    if (len == 0) {
+        memcpy(&index, &p[sizeof(len)], sizeof(index));
+        bsc_shared_tx_buf_release(index);
+    }
+}
+
+/**
+ * @brief Empty the send queue of a socket
+ * @param c - pointer to the socket
+ */
+static void bsc_tx_buf_clear(BSC_SOCKET *c)
+{
+    size_t offset = 0;
+    size_t frame_size;
+    uint16_t len;
+
+    while (offset < c->tx_buf_size) {
+        (void)bsc_tx_frame_pdu(&c->tx_buf[offset], &len, &frame_size);
+        bsc_tx_frame_release(&c->tx_buf[offset]);
+        offset += frame_size;
+    }
+    c->tx_buf_size = 0;
+}
+
 /**
  * @brief Add the socket context to the list
  * @param ctx - pointer to the socket context
@@ -86,6 +191,72 @@ static void bsc_ctx_remove(BSC_SOCKET_CTX *ctx)
             break;
         }
     }
+    Keyhash_Delete(ctx->vmac_index);
+    ctx->vmac_index = NULL;
+    Keyhash_Delete(ctx->uuid_index);
+    ctx->uuid_index = NULL;
+}
+
+/**
+ * @brief Get the key of a socket in the indexes of its context
+ * @param c - pointer to the socket
+ * @param key - [out] index of the socket in the sockets of the context
+ * @return true if the socket belongs to a context with indexes
+ */
+static bool bsc_socket_index_key(BSC_SOCKET *c, KEY *key)
+{
+    BSC_SOCKET_CTX *ctx = c->ctx;
+
+    if (!ctx || !ctx->vmac_index || !ctx->uuid_index || (c < ctx->sock) ||
+        (c >= &ctx->sock[ctx->sock_num])) {
+        return false;
+    }
+    *key = (KEY)(c - ctx->sock);
+    return true;
+}
+
+/**
+ * @brief Add a socket to the VMAC and UUID indexes of its context
+ * @param c - pointer to the socket with the VMAC and UUID of its peer
+ */
+static void bsc_socket_index_add(BSC_SOCKET *c)
+{
+    KEY key;
+
+    if (bsc_socket_index_key(c, &key)) {
+        if (!Keyhash_Add(
+                c->ctx->vmac_index,
+                Keyhash_FNV1a(c->vmac.address, sizeof(c->vmac.address)),
+                key) ||
+            !Keyhash_Add(
+                c->ctx->uuid_index,
+                Keyhash_FNV1a(c->uuid.uuid, sizeof(c->uuid.uuid)), key)) {
+            /* without memory for the indexes, find the sockets by
+               looking at each of them */
+            Keyhash_Delete(c->ctx->vmac_index);
+            c->ctx->vmac_index = NULL;
+            Keyhash_Delete(c->ctx->uuid_index);
+            c->ctx->uuid_index = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Remove a socket from the VMAC and UUID indexes of its context
+ * @param c - pointer to the socket with the VMAC and UUID of its peer
+ */
+static void bsc_socket_index_remove(BSC_SOCKET *c)
+{
+    KEY key;
+
+    if (bsc_socket_index_key(c, &key)) {
+        (void)Keyhash_Remove(
+            c->ctx->vmac_index,
+            Keyhash_FNV1a(c->vmac.address, sizeof(c->vmac.address)), key);
+        (void)Keyhash_Remove(
+            c->ctx->uuid_index,
+            Keyhash_FNV1a(c->uuid.uuid, sizeof(c->uuid.uuid)), key);
+    }
 }
 
 /**
@@ -94,9 +265,10 @@ static void bsc_ctx_remove(BSC_SOCKET_CTX *ctx)
  */
 static void bsc_reset_socket(BSC_SOCKET *c)
 {
+    bsc_socket_index_remove(c);
     memset(&c->vmac, 0, sizeof(c->vmac));
     memset(&c->uuid, 0, sizeof(c->uuid));
-    c->tx_buf_size = 0;
+    bsc_tx_buf_clear(c);
 }
 
 /**
@@ -372,10 +544,26 @@ static bool bsc_prepare_protocol_error(
  */
 static void bsc_clear_vmac_and_uuid(BSC_SOCKET *c)
 {
+    bsc_socket_index_remove(c);
     memset(&c->vmac, 0, sizeof(c->vmac));
     memset(&c->uuid, 0, sizeof(c->uuid));
 }
 
+/**
+ * @brief Set the VMAC and UUID of the peer of a BACnet Secure Connect socket
+ * @param c - pointer to the socket
+ * @param vmac - VMAC address of the peer
+ * @param uuid - UUID of the peer
+ */
+static void bsc_set_vmac_and_uuid(
+    BSC_SOCKET *c, BACNET_SC_VMAC_ADDRESS *vmac, BACNET_SC_UUID *uuid)
+{
+    bsc_socket_index_remove(c);
+    bsc_copy_vmac(&c->vmac, vmac);
+    bsc_copy_uuid(&c->uuid, uuid);
+    bsc_socket_index_add(c);
+}
+
 /**
  * @brief Set the BACnet Secure Connect socket to the idle state
  * @param c - pointer to the socket
@@ -384,6 +572,8 @@ static void bsc_set_socket_idle(BSC_SOCKET *c)
 {
     c->state = BSC_SOCK_STATE_IDLE;
     c->wh = BSC_WEBSOCKET_INVALID_HANDLE;
+    /* release the shared buffers of the frames that were not sent */
+    bsc_tx_buf_clear(c);
 }
 
 /**
@@ -864,8 +1054,9 @@ static void bsc_process_srv_awaiting_request(
                 "bsc_process_srv_awaiting_request() existing = %p, "
                 "existing->state = %s, c = %p\n",
                 existing, bsc_socket_state_to_string(existing->state), c);
-            bsc_copy_vmac(&c->vmac, dm->payload.connect_request.vmac);
-            bsc_copy_uuid(&c->uuid, dm->payload.connect_request.uuid);
+            bsc_set_vmac_and_uuid(
+                c, dm->payload.connect_request.vmac,
+                dm->payload.connect_request.uuid);
             c->max_npdu_len = dm->payload.connect_request.max_npdu_len;
             c->max_bvlc_len = dm->payload.connect_request.max_bvlc_len;
             message_id = dm->hdr.message_id;
@@ -972,8 +1163,9 @@ static void bsc_process_srv_awaiting_request(
             return;
         }
 
-        bsc_copy_vmac(&c->vmac, dm->payload.connect_request.vmac);
-        bsc_copy_uuid(&c->uuid, dm->payload.connect_request.uuid);
+        bsc_set_vmac_and_uuid(
+            c, dm->payload.connect_request.vmac,
+            dm->payload.connect_request.uuid);
 
         DEBUG_PRINTF(
             "bsc_process_srv_awaiting_request() local vmac = %s, "
@@ -1095,8 +1287,10 @@ static void bsc_dispatch_srv_func(
     BSC_SOCKET *c = NULL;
     BSC_WEBSOCKET_RET wret;
     uint8_t *p;
+    uint8_t *pdu;
     bool failed = false;
     uint16_t len;
+    size_t frame_size;
     size_t i;
 
     (void)sh;
@@ -1110,6 +1304,7 @@ static void bsc_dispatch_srv_func(
     if (ev == BSC_WEBSOCKET_SERVER_STOPPED) {
         for (i = 0; i < ctx->sock_num; i++) {
             ctx->sock[i].state = BSC_SOCK_STATE_IDLE;
+            bsc_tx_buf_clear(&ctx->sock[i]);
         }
         DEBUG_PRINTF("bsc_dispatch_srv_func() ctx %p is deinitialized\n", ctx);
         bsc_ctx_remove(ctx);
@@ -1192,9 +1387,8 @@ static void bsc_dispatch_srv_func(
         p = c->tx_buf;
 
         while (c->tx_buf_size > 0) {
-            memcpy(&len, p, sizeof(len));
-            wret = bws_srv_dispatch_send(
-                c->ctx->sh, c->wh, &p[sizeof(len) + BSC_CONF_TX_PRE], len);
+            pdu = bsc_tx_frame_pdu(p, &len, &frame_size);
+            wret = bws_srv_dispatch_send(c->ctx->sh, c->wh, pdu, len);
             if (wret != BSC_WEBSOCKET_SUCCESS) {
                 DEBUG_PRINTF(
                     "bsc_dispatch_srv_func() send data failed. "
@@ -1208,8 +1402,9 @@ static void bsc_dispatch_srv_func(
                 failed = true;
                 break;
             } else {
-                c->tx_buf_size -= len + sizeof(len) + BSC_CONF_TX_PRE;
-                p += len + sizeof(len) + BSC_CONF_TX_PRE;
+                bsc_tx_frame_release(p);
+                c->tx_buf_size -= frame_size;
+                p += frame_size;
             }
         }
 
@@ -1264,8 +1459,9 @@ static void bsc_process_cli_awaiting_accept(
                 "bsc_process_cli_awaiting_accept() set state of "
                 "socket %p to BSC_SOCKET_EVENT_CONNECTED\n",
                 c);
-            bsc_copy_vmac(&c->vmac, dm->payload.connect_accept.vmac);
-            bsc_copy_uuid(&c->uuid, dm->payload.connect_accept.uuid);
+            bsc_set_vmac_and_uuid(
+                c, dm->payload.connect_accept.vmac,
+                dm->payload.connect_accept.uuid);
             c->max_bvlc_len = dm->payload.connect_accept.max_bvlc_len;
             c->max_npdu_len = dm->payload.connect_accept.max_npdu_len;
             mstimer_set(&c->heartbeat, c->ctx->cfg->heartbeat_timeout_s * 1000);
@@ -1363,6 +1559,8 @@ static void bsc_dispatch_cli_func(
     uint16_t pdu_len;
     BSC_WEBSOCKET_RET wret;
     uint8_t *p;
+    uint8_t *pdu;
+    size_t frame_size;
     size_t i;
     bool all_socket_disconnected = true;
     bool failed = false;
@@ -1458,11 +1656,10 @@ static void bsc_dispatch_cli_func(
         p = c->tx_buf;
 
         while (c->tx_buf_size > 0) {
-            memcpy(&pdu_len, p, sizeof(pdu_len));
+            pdu = bsc_tx_frame_pdu(p, &pdu_len, &frame_size);
             DEBUG_PRINTF(
                 "bsc_dispatch_cli_func() sending pdu of %d bytes\n", pdu_len);
-            wret = bws_cli_dispatch_send(
-                c->wh, &p[sizeof(pdu_len) + BSC_CONF_TX_PRE], pdu_len);
+            wret = bws_cli_dispatch_send(c->wh, pdu, pdu_len);
             if (wret != BSC_WEBSOCKET_SUCCESS) {
                 DEBUG_PRINTF(
                     "bsc_dispatch_cli_func() pdu send failed, err = %d, start "
@@ -1476,8 +1673,9 @@ static void bsc_dispatch_cli_func(
                 failed = true;
                 break;
             } else {
-                c->tx_buf_size -= pdu_len + sizeof(pdu_len) + BSC_CONF_TX_PRE;
-                p += pdu_len + sizeof(pdu_len) + BSC_CONF_TX_PRE;
+                bsc_tx_frame_release(p);
+                c->tx_buf_size -= frame_size;
+                p += frame_size;
             }
         }
         if (!failed) {
@@ -1563,14 +1761,31 @@ BSC_SC_RET bsc_init_ctx(
     ctx->sock_num = sockets_num;
 
     for (i = 0; i < sockets_num; i++) {
+        /* the sockets have no frames left from an earlier context */
+        ctx->sock[i].ctx = ctx;
+        ctx->sock[i].tx_buf_size = 0;
         bsc_set_socket_idle(&ctx->sock[i]);
     }
+    /* without memory for the indexes, the sockets are found by
+       looking at each of them */
+    ctx->vmac_index = Keyhash_Create();
+    ctx->uuid_index = Keyhash_Create();
+    if (!ctx->vmac_index || !ctx->uuid_index) {
+        Keyhash_Delete(ctx->vmac_index);
+        ctx->vmac_index = NULL;
+        Keyhash_Delete(ctx->uuid_index);
+        ctx->uuid_index = NULL;
+    }
 
     ctx->state = BSC_CTX_STATE_INITIALIZING;
     if (!bsc_ctx_add(ctx)) {
+        bsc_ctx_remove(ctx);
         sc_ret = BSC_SC_NO_RESOURCES;
     } else {
         if (cfg->type == BSC_SOCKET_CTX_ACCEPTOR) {
+            /* the websocket server accepts as many connections
+               as the context has sockets */
+            bws_srv_connections_set(cfg->proto, (int)sockets_num);
             ret = bws_srv_start(
                 cfg->proto, cfg->port, cfg->iface, cfg->ca_cert_chain,
                 cfg->ca_cert_chain_size, cfg->cert_chain, cfg->cert_chain_size,
@@ -1663,7 +1878,7 @@ BSC_SC_RET bsc_connect(BSC_SOCKET_CTX *ctx, BSC_SOCKET *c, char *url)
             ctx->cfg->type == BSC_SOCKET_CTX_INITIATOR) {
             c->ctx = ctx;
             c->state = BSC_SOCK_STATE_AWAITING_WEBSOCKET;
-            c->tx_buf_size = 0;
+            bsc_tx_buf_clear(c);
             wret = bws_cli_connect(
                 ctx->cfg->proto, url, ctx->cfg->ca_cert_chain,
                 ctx->cfg->ca_cert_chain_size, ctx->cfg->cert_chain,
@@ -1778,6 +1993,192 @@ BSC_SC_RET bsc_send(BSC_SOCKET *c, uint8_t *pdu, size_t pdu_len)
     return ret;
 }
 
+/**
+ * @brief Schedule transmitting of a pdu to all connected sockets of
+ *  a context. The pdu is copied once into a shared buffer, and the
+ *  send queue of each socket holds a reference to it.
+ * @param ctx - socket context
+ * @param exclude - socket that does not get the pdu, or NULL
+ * @param pdu - pdu to send
+ * @param pdu_len - length of the pdu
+ * @return BSC_SC_SUCCESS if the pdu was queued for all the sockets,
+ *  BSC_SC_NO_RESOURCES if the send queue of some socket was full,
+ *  BSC_SC_INVALID_OPERATION if the context is not initialized,
+ *  BSC_SC_BAD_PARAM if some input parameter is incorrect.
+ */
+BSC_SC_RET bsc_send_broadcast(
+    BSC_SOCKET_CTX *ctx, BSC_SOCKET *exclude, uint8_t *pdu, size_t pdu_len)
+{
+    BSC_SC_RET ret = BSC_SC_SUCCESS;
+    BSC_SOCKET *c;
+    uint16_t index;
+    int shared;
+    size_t i;
+
+    DEBUG_PRINTF(
+        "bsc_send_broadcast() >>> ctx = %p, pdu = %p, pdu_len = %d\n", ctx,
+        pdu, pdu_len);
+
+    if (!ctx || !pdu || !pdu_len ||
+        (pdu_len > (sizeof(bsc_shared_tx_buf[0].buf) - BSC_CONF_TX_PRE))) {
+        ret = BSC_SC_BAD_PARAM;
+    } else {
+        bws_dispatch_lock();
+        if (ctx->state != BSC_CTX_STATE_INITIALIZED) {
+            ret = BSC_SC_INVALID_OPERATION;
+        } else {
+            /* the reference of this function keeps the buffer
+               while the send queue of each socket takes its own */
+            shared = bsc_shared_tx_buf_alloc();
+            if (shared >= 0) {
+                index = (uint16_t)shared;
+                memcpy(
+                    &bsc_shared_tx_buf[index].buf[BSC_CONF_TX_PRE], pdu,
+                    pdu_len);
+                bsc_shared_tx_buf[index].len = (uint16_t)pdu_len;
+            }
+            for (i = 0; i < ctx->sock_num; i++) {
+                c = &ctx->sock[i];
+                if ((c == exclude) || (c->state != BSC_SOCK_STATE_CONNECTED)) {
+                    continue;
+                }
+                if (shared < 0) {
+                    /* no shared buffer is free: copy the pdu instead */
+                    if (TX_BUF_BYTES_AVAIL(c) < pdu_len) {
+                        ret = BSC_SC_NO_RESOURCES;
+                        continue;
+                    }
+                    memcpy(TX_BUF_PTR(c), pdu, pdu_len);
+                    TX_BUF_UPDATE(c, pdu_len);
+                } else {
+                    if (!TX_BUF_REF_AVAIL(c)) {
+                        DEBUG_PRINTF(
+                            "bsc_send_broadcast() send queue of socket %p "
+                            "is full\n",
+                            c);
+                        ret = BSC_SC_NO_RESOURCES;
+                        continue;
+                    }
+                    memset(&c->tx_buf[c->tx_buf_size], 0, sizeof(uint16_t));
+                    memcpy(
+                        &c->tx_buf[c->tx_buf_size + sizeof(uint16_t)],
+                        &index, sizeof(index));
+                    c->tx_buf_size += TX_BUF_REF_SIZE;
+                    bsc_shared_tx_buf[index].ref_count++;
+                }
+                if (ctx->cfg->type == BSC_SOCKET_CTX_INITIATOR) {
+                    bws_cli_send(c->wh);
+                } else {
+                    bws_srv_send(ctx->sh, c->wh);
+                }
+            }
+            if (shared >= 0) {
+                bsc_shared_tx_buf_release(index);
+            }
+        }
+        bws_dispatch_unlock();
+    }
+
+    DEBUG_PRINTF_VERBOSE("bsc_send_broadcast() <<< ret = %d\n", ret);
+    return ret;
+}
+
+/**
+ * @brief Find the socket of a context whose peer has a VMAC address
+ * @param ctx - socket context
+ * @param vmac - VMAC address of the peer
+ * @return pointer to the socket, or NULL if not found
+ */
+BSC_SOCKET *
+bsc_find_socket_for_vmac(BSC_SOCKET_CTX *ctx, BACNET_SC_VMAC_ADDRESS *vmac)
+{
+    BSC_SOCKET *c = NULL;
+    unsigned iterator = 0;
+    KEY key;
+    size_t i;
+
+    if (!ctx || !vmac || !ctx->sock) {
+        return NULL;
+    }
+    bws_dispatch_lock();
+    if (ctx->vmac_index) {
+        /* a lookup gives every socket with the hash, and the first
+           of those in the context is the one that was found before */
+        while (Keyhash_Find(
+            ctx->vmac_index,
+            Keyhash_FNV1a(vmac->address, sizeof(vmac->address)), &iterator,
+            &key)) {
+            if ((key < ctx->sock_num) &&
+                (ctx->sock[key].state != BSC_SOCK_STATE_IDLE) &&
+                (memcmp(
+                     &vmac->address[0], &ctx->sock[key].vmac.address[0],
+                     sizeof(vmac->address)) == 0) &&
+                (!c || (&ctx->sock[key] < c))) {
+                c = &ctx->sock[key];
+            }
+        }
+    } else {
+        for (i = 0; i < ctx->sock_num; i++) {
+            if ((ctx->sock[i].state != BSC_SOCK_STATE_IDLE) &&
+                (memcmp(
+                     &vmac->address[0], &ctx->sock[i].vmac.address[0],
+                     sizeof(vmac->address)) == 0)) {
+                c = &ctx->sock[i];
+                break;
+            }
+        }
+    }
+    bws_dispatch_unlock();
+
+    return c;
+}
+
+/**
+ * @brief Find the socket of a context whose peer has a UUID
+ * @param ctx - socket context
+ * @param uuid - UUID of the peer
+ * @return pointer to the socket, or NULL if not found
+ */
+BSC_SOCKET *bsc_find_socket_for_uuid(BSC_SOCKET_CTX *ctx, BACNET_SC_UUID *uuid)
+{
+    BSC_SOCKET *c = NULL;
+    unsigned iterator = 0;
+    KEY key;
+    size_t i;
+
+    if (!ctx || !uuid || !ctx->sock) {
+        return NULL;
+    }
+    bws_dispatch_lock();
+    if (ctx->uuid_index) {
+        while (Keyhash_Find(
+            ctx->uuid_index, Keyhash_FNV1a(uuid->uuid, sizeof(uuid->uuid)),
+            &iterator, &key)) {
+            if ((key < ctx->sock_num) &&
+                (ctx->sock[key].state != BSC_SOCK_STATE_IDLE) &&
+                (memcmp(
+                     &uuid->uuid[0], &ctx->sock[key].uuid.uuid[0],
+                     sizeof(uuid->uuid)) == 0) &&
+                (!c || (&ctx->sock[key] < c))) {
+                c = &ctx->sock[key];
+            }
+        }
+    } else {
+        for (i = 0; i < ctx->sock_num; i++) {
+            if ((ctx->sock[i].state != BSC_SOCK_STATE_IDLE) &&
+                (memcmp(
+                     &uuid->uuid[0], &ctx->sock[i].uuid.uuid[0],
+                     sizeof(uuid->uuid)) == 0)) {
+                c = &ctx->sock[i];
+                break;
+            }
+        }
+    }
+    bws_dispatch_unlock();
+
+    return c;
+}
+
 /**
  * @brief Get the next message ID
  * @return uint16_t - message ID
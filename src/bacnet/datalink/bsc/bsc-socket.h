@@ -23,6 +23,7 @@
 #include "bacnet/datalink/bsc/bsc-retcodes.h"
 #include "bacnet/datalink/bsc/bsc-conf.h"
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/keyhash.h"
 #include "bacnet/basic/object/sc_netport.h"
 
 #define BSC_RX_BUFFER_SIZE BSC_CONF_SOCK_RX_BUFFER_SIZE
@@ -175,6 +176,9 @@ struct BSC_SocketContext {
     BSC_CONTEXT_CFG *cfg;
     bool deinit_in_progress;
     void *user_arg;
+    /* index of the sockets by the VMAC and the UUID of their peers */
+    OS_Keyhash vmac_index;
+    OS_Keyhash uuid_index;
 };
 
 /* max_local_bvlc_len - The maximum BVLC message size int bytes that can be */
@@ -278,6 +282,44 @@ void bsc_disconnect(BSC_SOCKET *c);
 BACNET_STACK_EXPORT
 BSC_SC_RET bsc_send(BSC_SOCKET *c, uint8_t *pdu, size_t pdu_len);
 
+/**
+ * @brief  bsc_send_broadcast() function schedules transmitting of pdu
+ *         to every connected BACnet socket of a context except one.
+ *         The pdu is copied once and shared by the send queues of
+ *         the sockets. A socket whose send queue is full does not get
+ *         the pdu, and BSC_SC_NO_RESOURCES is returned.
+ *
+ * @param ctx - socket context
+ * @param exclude - socket that does not get the pdu, or NULL
+ * @param pdu - data to send
+ * @param pdu_len - length of data to send
+ *
+ * @return error code from BSC_SC_RET enum
+ */
+
+BACNET_STACK_EXPORT
+BSC_SC_RET bsc_send_broadcast(
+    BSC_SOCKET_CTX *ctx, BSC_SOCKET *exclude, uint8_t *pdu, size_t pdu_len);
+
+/**
+ * @brief  bsc_find_socket_for_vmac() and bsc_find_socket_for_uuid()
+ *         functions find the socket of a context whose peer has
+ *         the specified VMAC or UUID and which is not idle.
+ *
+ * @param ctx - socket context
+ * @param vmac - VMAC address of the peer
+ * @param uuid - UUID of the peer
+ *
+ * @return pointer to the socket, or NULL if not found
+ */
+
+BACNET_STACK_EXPORT
+BSC_SOCKET *
+bsc_find_socket_for_vmac(BSC_SOCKET_CTX *ctx, BACNET_SC_VMAC_ADDRESS *vmac);
+
+BACNET_STACK_EXPORT
+BSC_SOCKET *bsc_find_socket_for_uuid(BSC_SOCKET_CTX *ctx, BACNET_SC_UUID *uuid);
+
 BACNET_STACK_EXPORT
 uint16_t bsc_get_next_message_id(void);
 
@@ -193,6 +193,8 @@ bool bsc_node_conf_fill_from_netport(
         (uint16_t)Network_Port_SC_Disconnect_Wait_Timeout(instance);
     bsc_conf->reconnnect_timeout_s =
         (uint16_t)Network_Port_SC_Maximum_Reconnect_Time(instance);
+    bsc_conf->min_reconnect_timeout_s =
+        (uint16_t)Network_Port_SC_Minimum_Reconnect_Time(instance);
     bsc_conf->address_resolution_timeout_s = bsc_conf->connect_timeout_s;
     bsc_conf->address_resolution_freshness_timeout_s =
         bsc_conf->connect_timeout_s;
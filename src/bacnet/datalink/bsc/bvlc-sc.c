@@ -2220,6 +2220,37 @@ bvlc_sc_set_orig(uint8_t **ppdu, size_t pdu_len, BACNET_SC_VMAC_ADDRESS *orig)
     }
 }
 
+/**
+ * @brief Function changes or adds originating address into a decoded
+ *                 BACnet/SC message, like bvlc_sc_set_orig(), and updates
+ *                 the decoded message so that it needs no new decoding.
+ *                 The decoded message refers to the octets of the pdu,
+ *                 and only the fixed header moves when the originating
+ *                 address is added, so only the origin changes.
+ * @param ppdu - pointer to buffer which holds BACnet/SC PDU, with
+ *               BSC_PRE bytes behind it.
+ * @param pdu_len - length of a buffer which holds BACnet/SC PDU.
+ * @param orig- origination vmac.
+ * @param message - the decoded message of the PDU.
+ * @return new pdu length if function succeeded and ppdu points to beginning of
+ *         changed pdu, otherwise returns old pdu_len and ppdu is not changed.
+ */
+size_t bvlc_sc_set_orig_decoded(
+    uint8_t **ppdu,
+    size_t pdu_len,
+    BACNET_SC_VMAC_ADDRESS *orig,
+    BVLC_SC_DECODED_MESSAGE *message)
+{
+    size_t len;
+
+    len = bvlc_sc_set_orig(ppdu, pdu_len, orig);
+    if (message && *ppdu && (len > 4)) {
+        message->hdr.origin = (BACNET_SC_VMAC_ADDRESS *)&(*ppdu)[4];
+    }
+
+    return len;
+}
+
 /**
  * @brief Function checks if vmac address is broadcast.
  * @param vmac - pointer vmac address.
@@ -400,6 +400,13 @@ BACNET_STACK_EXPORT
 size_t
 bvlc_sc_set_orig(uint8_t **ppdu, size_t pdu_len, BACNET_SC_VMAC_ADDRESS *orig);
 
+BACNET_STACK_EXPORT
+size_t bvlc_sc_set_orig_decoded(
+    uint8_t **ppdu,
+    size_t pdu_len,
+    BACNET_SC_VMAC_ADDRESS *orig,
+    BVLC_SC_DECODED_MESSAGE *message);
+
 BACNET_STACK_EXPORT
 bool bvlc_sc_is_vmac_broadcast(BACNET_SC_VMAC_ADDRESS *vmac);
 
@@ -63,6 +63,15 @@
 #endif
 /** @} */
 
+/**
+ * Number of writable bytes in front of the data of a
+ * BSC_WEBSOCKET_RECEIVED event, so that a hub or a node switch can add
+ * an originating address to a received BVLC message in place.
+ * @{
+ */
+#define BSC_WEBSOCKET_RX_PRE BSC_PRE
+/** @} */
+
 /**
  * Maximum number of sockets supported for direct websocket server
  * @{
@@ -250,6 +259,21 @@ void bws_cli_send(BSC_WEBSOCKET_HANDLE h);
 BSC_WEBSOCKET_RET bws_cli_dispatch_send(
     BSC_WEBSOCKET_HANDLE h, uint8_t *payload, size_t payload_size);
 
+/**
+ * @brief bws_srv_connections_set() function sets the number of
+ * connections that a websocket server of a protocol accepts. It
+ * applies to the servers that are started afterwards. By default the
+ * number is BSC_SERVER_HUB_WEBSOCKETS_MAX_NUM or
+ * BSC_SERVER_DIRECT_WEBSOCKETS_MAX_NUM. A port that keeps its
+ * connections in static tables limits the number to those values.
+ *
+ * @param proto - type of BACnet websocket protocol defined in
+ *                BSC_WEBSOCKET_PROTOCOL enum.
+ * @param num - number of connections.
+ */
+
+void bws_srv_connections_set(BSC_WEBSOCKET_PROTOCOL proto, int num);
+
 /**
  * @brief Asynchronous bws_srv_start() function triggers process of
  * starting of a websocket server on a specified port for specified
@@ -79,6 +79,46 @@ int bvlc_decode_header(
     return bytes_consumed;
 }
 
+/**
+ * @brief Get the network priority of the NPDU in a BVLL message,
+ *  so that a datalink can give the datagram that priority on the wire.
+ *
+ * @param pdu - buffer of the BVLL message
+ * @param pdu_len - length of the BVLL message
+ *
+ * @return the network priority from the NPDU control octet, or
+ *  MESSAGE_PRIORITY_NORMAL for the BVLL messages that carry no NPDU
+ */
+BACNET_MESSAGE_PRIORITY
+bvlc_network_priority(const uint8_t *pdu, uint16_t pdu_len)
+{
+    uint8_t message_type = 0;
+    uint16_t offset = 0;
+
+    if (bvlc_decode_header(pdu, pdu_len, &message_type, NULL) == 0) {
+        return MESSAGE_PRIORITY_NORMAL;
+    }
+    switch (message_type) {
+        case BVLC_ORIGINAL_UNICAST_NPDU:
+        case BVLC_ORIGINAL_BROADCAST_NPDU:
+        case BVLC_DISTRIBUTE_BROADCAST_TO_NETWORK:
+            offset = 4;
+            break;
+        case BVLC_FORWARDED_NPDU:
+            /* B/IP address of the originating device comes first */
+            offset = 4 + BIP_ADDRESS_MAX;
+            break;
+        default:
+            return MESSAGE_PRIORITY_NORMAL;
+    }
+    /* protocol version, then the control octet */
+    if ((pdu_len < (offset + 2)) || (pdu[offset] != BACNET_PROTOCOL_VERSION)) {
+        return MESSAGE_PRIORITY_NORMAL;
+    }
+
+    return (BACNET_MESSAGE_PRIORITY)(pdu[offset + 1] & 0x03);
+}
+
 /**
  * @brief J.2.1 BVLC-Result: Encode
  *
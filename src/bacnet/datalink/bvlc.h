@@ -380,6 +380,9 @@ int bvlc_decode_header(
     uint16_t pdu_len,
     uint8_t *message_type,
     uint16_t *length);
+BACNET_STACK_EXPORT
+BACNET_MESSAGE_PRIORITY
+bvlc_network_priority(const uint8_t *pdu, uint16_t pdu_len);
 
 BACNET_STACK_EXPORT
 void bvlc_foreign_device_table_maintenance_timer(
@@ -9,8 +9,195 @@
  */
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/datalink/mstpdef.h"
 #include "bacnet/datalink/cobs.h"
+#include "bacnet/datalink/crc.h"
+
+#if defined(CRC_USE_TABLE)
+/* cobs_crc32k() of each octet value, starting from zero */
+static const uint32_t CRC32K_Table[256] = {
+    0x00000000, 0x9695c4ca, 0xfb4839c9, 0x6dddfd03, 0x20f3c3cf, 0xb6660705,
+    0xdbbbfa06, 0x4d2e3ecc, 0x41e7879e, 0xd7724354, 0xbaafbe57, 0x2c3a7a9d,
+    0x61144451, 0xf781809b, 0x9a5c7d98, 0x0cc9b952, 0x83cf0f3c, 0x155acbf6,
+    0x788736f5, 0xee12f23f, 0xa33cccf3, 0x35a90839, 0x5874f53a, 0xcee131f0,
+    0xc22888a2, 0x54bd4c68, 0x3960b16b, 0xaff575a1, 0xe2db4b6d, 0x744e8fa7,
+    0x199372a4, 0x8f06b66e, 0xd1fdae25, 0x47686aef, 0x2ab597ec, 0xbc205326,
+    0xf10e6dea, 0x679ba920, 0x0a465423, 0x9cd390e9, 0x901a29bb, 0x068fed71,
+    0x6b521072, 0xfdc7d4b8, 0xb0e9ea74, 0x267c2ebe, 0x4ba1d3bd, 0xdd341777,
+    0x5232a119, 0xc4a765d3, 0xa97a98d0, 0x3fef5c1a, 0x72c162d6, 0xe454a61c,
+    0x89895b1f, 0x1f1c9fd5, 0x13d52687, 0x8540e24d, 0xe89d1f4e, 0x7e08db84,
+    0x3326e548, 0xa5b32182, 0xc86edc81, 0x5efb184b, 0x7598ec17, 0xe30d28dd,
+    0x8ed0d5de, 0x18451114, 0x556b2fd8, 0xc3feeb12, 0xae231611, 0x38b6d2db,
+    0x347f6b89, 0xa2eaaf43, 0xcf375240, 0x59a2968a, 0x148ca846, 0x82196c8c,
+    0xefc4918f, 0x79515545, 0xf657e32b, 0x60c227e1, 0x0d1fdae2, 0x9b8a1e28,
+    0xd6a420e4, 0x4031e42e, 0x2dec192d, 0xbb79dde7, 0xb7b064b5, 0x2125a07f,
+    0x4cf85d7c, 0xda6d99b6, 0x9743a77a, 0x01d663b0, 0x6c0b9eb3, 0xfa9e5a79,
+    0xa4654232, 0x32f086f8, 0x5f2d7bfb, 0xc9b8bf31, 0x849681fd, 0x12034537,
+    0x7fdeb834, 0xe94b7cfe, 0xe582c5ac, 0x73170166, 0x1ecafc65, 0x885f38af,
+    0xc5710663, 0x53e4c2a9, 0x3e393faa, 0xa8acfb60, 0x27aa4d0e, 0xb13f89c4,
+    0xdce274c7, 0x4a77b00d, 0x07598ec1, 0x91cc4a0b, 0xfc11b708, 0x6a8473c2,
+    0x664dca90, 0xf0d80e5a, 0x9d05f359, 0x0b903793, 0x46be095f, 0xd02bcd95,
+    0xbdf63096, 0x2b63f45c, 0xeb31d82e, 0x7da41ce4, 0x1079e1e7, 0x86ec252d,
+    0xcbc21be1, 0x5d57df2b, 0x308a2228, 0xa61fe6e2, 0xaad65fb0, 0x3c439b7a,
+    0x519e6679, 0xc70ba2b3, 0x8a259c7f, 0x1cb058b5, 0x716da5b6, 0xe7f8617c,
+    0x68fed712, 0xfe6b13d8, 0x93b6eedb, 0x05232a11, 0x480d14dd, 0xde98d017,
+    0xb3452d14, 0x25d0e9de, 0x2919508c, 0xbf8c9446, 0xd2516945, 0x44c4ad8f,
+    0x09ea9343, 0x9f7f5789, 0xf2a2aa8a, 0x64376e40, 0x3acc760b, 0xac59b2c1,
+    0xc1844fc2, 0x57118b08, 0x1a3fb5c4, 0x8caa710e, 0xe1778c0d, 0x77e248c7,
+    0x7b2bf195, 0xedbe355f, 0x8063c85c, 0x16f60c96, 0x5bd8325a, 0xcd4df690,
+    0xa0900b93, 0x3605cf59, 0xb9037937, 0x2f96bdfd, 0x424b40fe, 0xd4de8434,
+    0x99f0baf8, 0x0f657e32, 0x62b88331, 0xf42d47fb, 0xf8e4fea9, 0x6e713a63,
+    0x03acc760, 0x953903aa, 0xd8173d66, 0x4e82f9ac, 0x235f04af, 0xb5cac065,
+    0x9ea93439, 0x083cf0f3, 0x65e10df0, 0xf374c93a, 0xbe5af7f6, 0x28cf333c,
+    0x4512ce3f, 0xd3870af5, 0xdf4eb3a7, 0x49db776d, 0x24068a6e, 0xb2934ea4,
+    0xffbd7068, 0x6928b4a2, 0x04f549a1, 0x92608d6b, 0x1d663b05, 0x8bf3ffcf,
+    0xe62e02cc, 0x70bbc606, 0x3d95f8ca, 0xab003c00, 0xc6ddc103, 0x504805c9,
+    0x5c81bc9b, 0xca147851, 0xa7c98552, 0x315c4198, 0x7c727f54, 0xeae7bb9e,
+    0x873a469d, 0x11af8257, 0x4f549a1c, 0xd9c15ed6, 0xb41ca3d5, 0x2289671f,
+    0x6fa759d3, 0xf9329d19, 0x94ef601a, 0x027aa4d0, 0x0eb31d82, 0x9826d948,
+    0xf5fb244b, 0x636ee081, 0x2e40de4d, 0xb8d51a87, 0xd508e784, 0x439d234e,
+    0xcc9b9520, 0x5a0e51ea, 0x37d3ace9, 0xa1466823, 0xec6856ef, 0x7afd9225,
+    0x17206f26, 0x81b5abec, 0x8d7c12be, 0x1be9d674, 0x76342b77, 0xe0a1efbd,
+    0xad8fd171, 0x3b1a15bb, 0x56c7e8b8, 0xc0522c72
+};
+
+#if defined(CRC_USE_SLICE_BY_4)
+/* CRC32K_Table followed by one, two, and three more octets of zero,
+   so that four octets are accumulated with four lookups */
+static const uint32_t CRC32K_Slice[3][256] = {
+    { 0x00000000, 0x24901faa, 0x49203f54, 0x6db020fe, 0x92407ea8, 0xb6d06102,
+      0xdb6041fc, 0xfff05e56, 0xf2e34d0d, 0xd67352a7, 0xbbc37259, 0x9f536df3,
+      0x60a333a5, 0x44332c0f, 0x29830cf1, 0x0d13135b, 0x33a52a47, 0x173535ed,
+      0x7a851513, 0x5e150ab9, 0xa1e554ef, 0x85754b45, 0xe8c56bbb, 0xcc557411,
+      0xc146674a, 0xe5d678e0, 0x8866581e, 0xacf647b4, 0x530619e2, 0x77960648,
+      0x1a2626b6, 0x3eb6391c, 0x674a548e, 0x43da4b24, 0x2e6a6bda, 0x0afa7470,
+      0xf50a2a26, 0xd19a358c, 0xbc2a1572, 0x98ba0ad8, 0x95a91983, 0xb1390629,
+      0xdc8926d7, 0xf819397d, 0x07e9672b, 0x23797881, 0x4ec9587f, 0x6a5947d5,
+      0x54ef7ec9, 0x707f6163, 0x1dcf419d, 0x395f5e37, 0xc6af0061, 0xe23f1fcb,
+      0x8f8f3f35, 0xab1f209f, 0xa60c33c4, 0x829c2c6e, 0xef2c0c90, 0xcbbc133a,
+      0x344c4d6c, 0x10dc52c6, 0x7d6c7238, 0x59fc6d92, 0xce94a91c, 0xea04b6b6,
+      0x87b49648, 0xa32489e2, 0x5cd4d7b4, 0x7844c81e, 0x15f4e8e0, 0x3164f74a,
+      0x3c77e411, 0x18e7fbbb, 0x7557db45, 0x51c7c4ef, 0xae379ab9, 0x8aa78513,
+      0xe717a5ed, 0xc387ba47, 0xfd31835b, 0xd9a19cf1, 0xb411bc0f, 0x9081a3a5,
+      0x6f71fdf3, 0x4be1e259, 0x2651c2a7, 0x02c1dd0d, 0x0fd2ce56, 0x2b42d1fc,
+      0x46f2f102, 0x6262eea8, 0x9d92b0fe, 0xb902af54, 0xd4b28faa, 0xf0229000,
+      0xa9defd92, 0x8d4ee238, 0xe0fec2c6, 0xc46edd6c, 0x3b9e833a, 0x1f0e9c90,
+      0x72bebc6e, 0x562ea3c4, 0x5b3db09f, 0x7fadaf35, 0x121d8fcb, 0x368d9061,
+      0xc97dce37, 0xededd19d, 0x805df163, 0xa4cdeec9, 0x9a7bd7d5, 0xbeebc87f,
+      0xd35be881, 0xf7cbf72b, 0x083ba97d, 0x2cabb6d7, 0x411b9629, 0x658b8983,
+      0x68989ad8, 0x4c088572, 0x21b8a58c, 0x0528ba26, 0xfad8e470, 0xde48fbda,
+      0xb3f8db24, 0x9768c48e, 0x4b4ae265, 0x6fdafdcf, 0x026add31, 0x26fac29b,
+      0xd90a9ccd, 0xfd9a8367, 0x902aa399, 0xb4babc33, 0xb9a9af68, 0x9d39b0c2,
+      0xf089903c, 0xd4198f96, 0x2be9d1c0, 0x0f79ce6a, 0x62c9ee94, 0x4659f13e,
+      0x78efc822, 0x5c7fd788, 0x31cff776, 0x155fe8dc, 0xeaafb68a, 0xce3fa920,
+      0xa38f89de, 0x871f9674, 0x8a0c852f, 0xae9c9a85, 0xc32cba7b, 0xe7bca5d1,
+      0x184cfb87, 0x3cdce42d, 0x516cc4d3, 0x75fcdb79, 0x2c00b6eb, 0x0890a941,
+      0x652089bf, 0x41b09615, 0xbe40c843, 0x9ad0d7e9, 0xf760f717, 0xd3f0e8bd,
+      0xdee3fbe6, 0xfa73e44c, 0x97c3c4b2, 0xb353db18, 0x4ca3854e, 0x68339ae4,
+      0x0583ba1a, 0x2113a5b0, 0x1fa59cac, 0x3b358306, 0x5685a3f8, 0x7215bc52,
+      0x8de5e204, 0xa975fdae, 0xc4c5dd50, 0xe055c2fa, 0xed46d1a1, 0xc9d6ce0b,
+      0xa466eef5, 0x80f6f15f, 0x7f06af09, 0x5b96b0a3, 0x3626905d, 0x12b68ff7,
+      0x85de4b79, 0xa14e54d3, 0xccfe742d, 0xe86e6b87, 0x179e35d1, 0x330e2a7b,
+      0x5ebe0a85, 0x7a2e152f, 0x773d0674, 0x53ad19de, 0x3e1d3920, 0x1a8d268a,
+      0xe57d78dc, 0xc1ed6776, 0xac5d4788, 0x88cd5822, 0xb67b613e, 0x92eb7e94,
+      0xff5b5e6a, 0xdbcb41c0, 0x243b1f96, 0x00ab003c, 0x6d1b20c2, 0x498b3f68,
+      0x44982c33, 0x60083399, 0x0db81367, 0x29280ccd, 0xd6d8529b, 0xf2484d31,
+      0x9ff86dcf, 0xbb687265, 0xe2941ff7, 0xc604005d, 0xabb420a3, 0x8f243f09,
+      0x70d4615f, 0x54447ef5, 0x39f45e0b, 0x1d6441a1, 0x107752fa, 0x34e74d50,
+      0x59576dae, 0x7dc77204, 0x82372c52, 0xa6a733f8, 0xcb171306, 0xef870cac,
+      0xd13135b0, 0xf5a12a1a, 0x98110ae4, 0xbc81154e, 0x43714b18, 0x67e154b2,
+      0x0a51744c, 0x2ec16be6, 0x23d278bd, 0x07426717, 0x6af247e9, 0x4e625843,
+      0xb1920615, 0x950219bf, 0xf8b23941, 0xdc2226eb },
+    { 0x00000000, 0x80475843, 0xd6ed00db, 0x56aa5898, 0x7bb9b1eb, 0xfbfee9a8,
+      0xad54b130, 0x2d13e973, 0xf77363d6, 0x77343b95, 0x219e630d, 0xa1d93b4e,
+      0x8ccad23d, 0x0c8d8a7e, 0x5a27d2e6, 0xda608aa5, 0x388577f1, 0xb8c22fb2,
+      0xee68772a, 0x6e2f2f69, 0x433cc61a, 0xc37b9e59, 0x95d1c6c1, 0x15969e82,
+      0xcff61427, 0x4fb14c64, 0x191b14fc, 0x995c4cbf, 0xb44fa5cc, 0x3408fd8f,
+      0x62a2a517, 0xe2e5fd54, 0x710aefe2, 0xf14db7a1, 0xa7e7ef39, 0x27a0b77a,
+      0x0ab35e09, 0x8af4064a, 0xdc5e5ed2, 0x5c190691, 0x86798c34, 0x063ed477,
+      0x50948cef, 0xd0d3d4ac, 0xfdc03ddf, 0x7d87659c, 0x2b2d3d04, 0xab6a6547,
+      0x498f9813, 0xc9c8c050, 0x9f6298c8, 0x1f25c08b, 0x323629f8, 0xb27171bb,
+      0xe4db2923, 0x649c7160, 0xbefcfbc5, 0x3ebba386, 0x6811fb1e, 0xe856a35d,
+      0xc5454a2e, 0x4502126d, 0x13a84af5, 0x93ef12b6, 0xe215dfc4, 0x62528787,
+      0x34f8df1f, 0xb4bf875c, 0x99ac6e2f, 0x19eb366c, 0x4f416ef4, 0xcf0636b7,
+      0x1566bc12, 0x9521e451, 0xc38bbcc9, 0x43cce48a, 0x6edf0df9, 0xee9855ba,
+      0xb8320d22, 0x38755561, 0xda90a835, 0x5ad7f076, 0x0c7da8ee, 0x8c3af0ad,
+      0xa12919de, 0x216e419d, 0x77c41905, 0xf7834146, 0x2de3cbe3, 0xada493a0,
+      0xfb0ecb38, 0x7b49937b, 0x565a7a08, 0xd61d224b, 0x80b77ad3, 0x00f02290,
+      0x931f3026, 0x13586865, 0x45f230fd, 0xc5b568be, 0xe8a681cd, 0x68e1d98e,
+      0x3e4b8116, 0xbe0cd955, 0x646c53f0, 0xe42b0bb3, 0xb281532b, 0x32c60b68,
+      0x1fd5e21b, 0x9f92ba58, 0xc938e2c0, 0x497fba83, 0xab9a47d7, 0x2bdd1f94,
+      0x7d77470c, 0xfd301f4f, 0xd023f63c, 0x5064ae7f, 0x06cef6e7, 0x8689aea4,
+      0x5ce92401, 0xdcae7c42, 0x8a0424da, 0x0a437c99, 0x275095ea, 0xa717cda9,
+      0xf1bd9531, 0x71facd72, 0x12480fd5, 0x920f5796, 0xc4a50f0e, 0x44e2574d,
+      0x69f1be3e, 0xe9b6e67d, 0xbf1cbee5, 0x3f5be6a6, 0xe53b6c03, 0x657c3440,
+      0x33d66cd8, 0xb391349b, 0x9e82dde8, 0x1ec585ab, 0x486fdd33, 0xc8288570,
+      0x2acd7824, 0xaa8a2067, 0xfc2078ff, 0x7c6720bc, 0x5174c9cf, 0xd133918c,
+      0x8799c914, 0x07de9157, 0xddbe1bf2, 0x5df943b1, 0x0b531b29, 0x8b14436a,
+      0xa607aa19, 0x2640f25a, 0x70eaaac2, 0xf0adf281, 0x6342e037, 0xe305b874,
+      0xb5afe0ec, 0x35e8b8af, 0x18fb51dc, 0x98bc099f, 0xce165107, 0x4e510944,
+      0x943183e1, 0x1476dba2, 0x42dc833a, 0xc29bdb79, 0xef88320a, 0x6fcf6a49,
+      0x396532d1, 0xb9226a92, 0x5bc797c6, 0xdb80cf85, 0x8d2a971d, 0x0d6dcf5e,
+      0x207e262d, 0xa0397e6e, 0xf69326f6, 0x76d47eb5, 0xacb4f410, 0x2cf3ac53,
+      0x7a59f4cb, 0xfa1eac88, 0xd70d45fb, 0x574a1db8, 0x01e04520, 0x81a71d63,
+      0xf05dd011, 0x701a8852, 0x26b0d0ca, 0xa6f78889, 0x8be461fa, 0x0ba339b9,
+      0x5d096121, 0xdd4e3962, 0x072eb3c7, 0x8769eb84, 0xd1c3b31c, 0x5184eb5f,
+      0x7c97022c, 0xfcd05a6f, 0xaa7a02f7, 0x2a3d5ab4, 0xc8d8a7e0, 0x489fffa3,
+      0x1e35a73b, 0x9e72ff78, 0xb361160b, 0x33264e48, 0x658c16d0, 0xe5cb4e93,
+      0x3fabc436, 0xbfec9c75, 0xe946c4ed, 0x69019cae, 0x441275dd, 0xc4552d9e,
+      0x92ff7506, 0x12b82d45, 0x81573ff3, 0x011067b0, 0x57ba3f28, 0xd7fd676b,
+      0xfaee8e18, 0x7aa9d65b, 0x2c038ec3, 0xac44d680, 0x76245c25, 0xf6630466,
+      0xa0c95cfe, 0x208e04bd, 0x0d9dedce, 0x8ddab58d, 0xdb70ed15, 0x5b37b556,
+      0xb9d24802, 0x39951041, 0x6f3f48d9, 0xef78109a, 0xc26bf9e9, 0x422ca1aa,
+      0x1486f932, 0x94c1a171, 0x4ea12bd4, 0xcee67397, 0x984c2b0f, 0x180b734c,
+      0x35189a3f, 0xb55fc27c, 0xe3f59ae4, 0x63b2c2a7 },
+    { 0x00000000, 0x18c5564c, 0x318aac98, 0x294ffad4, 0x63155930, 0x7bd00f7c,
+      0x529ff5a8, 0x4a5aa3e4, 0xc62ab260, 0xdeefe42c, 0xf7a01ef8, 0xef6548b4,
+      0xa53feb50, 0xbdfabd1c, 0x94b547c8, 0x8c701184, 0x5a36d49d, 0x42f382d1,
+      0x6bbc7805, 0x73792e49, 0x39238dad, 0x21e6dbe1, 0x08a92135, 0x106c7779,
+      0x9c1c66fd, 0x84d930b1, 0xad96ca65, 0xb5539c29, 0xff093fcd, 0xe7cc6981,
+      0xce839355, 0xd646c519, 0xb46da93a, 0xaca8ff76, 0x85e705a2, 0x9d2253ee,
+      0xd778f00a, 0xcfbda646, 0xe6f25c92, 0xfe370ade, 0x72471b5a, 0x6a824d16,
+      0x43cdb7c2, 0x5b08e18e, 0x1152426a, 0x09971426, 0x20d8eef2, 0x381db8be,
+      0xee5b7da7, 0xf69e2beb, 0xdfd1d13f, 0xc7148773, 0x8d4e2497, 0x958b72db,
+      0xbcc4880f, 0xa401de43, 0x2871cfc7, 0x30b4998b, 0x19fb635f, 0x013e3513,
+      0x4b6496f7, 0x53a1c0bb, 0x7aee3a6f, 0x622b6c23, 0xbeb8e229, 0xa67db465,
+      0x8f324eb1, 0x97f718fd, 0xddadbb19, 0xc568ed55, 0xec271781, 0xf4e241cd,
+      0x78925049, 0x60570605, 0x4918fcd1, 0x51ddaa9d, 0x1b870979, 0x03425f35,
+      0x2a0da5e1, 0x32c8f3ad, 0xe48e36b4, 0xfc4b60f8, 0xd5049a2c, 0xcdc1cc60,
+      0x879b6f84, 0x9f5e39c8, 0xb611c31c, 0xaed49550, 0x22a484d4, 0x3a61d298,
+      0x132e284c, 0x0beb7e00, 0x41b1dde4, 0x59748ba8, 0x703b717c, 0x68fe2730,
+      0x0ad54b13, 0x12101d5f, 0x3b5fe78b, 0x239ab1c7, 0x69c01223, 0x7105446f,
+      0x584abebb, 0x408fe8f7, 0xccfff973, 0xd43aaf3f, 0xfd7555eb, 0xe5b003a7,
+      0xafeaa043, 0xb72ff60f, 0x9e600cdb, 0x86a55a97, 0x50e39f8e, 0x4826c9c2,
+      0x61693316, 0x79ac655a, 0x33f6c6be, 0x2b3390f2, 0x027c6a26, 0x1ab93c6a,
+      0x96c92dee, 0x8e0c7ba2, 0xa7438176, 0xbf86d73a, 0xf5dc74de, 0xed192292,
+      0xc456d846, 0xdc938e0a, 0xab12740f, 0xb3d72243, 0x9a98d897, 0x825d8edb,
+      0xc8072d3f, 0xd0c27b73, 0xf98d81a7, 0xe148d7eb, 0x6d38c66f, 0x75fd9023,
+      0x5cb26af7, 0x44773cbb, 0x0e2d9f5f, 0x16e8c913, 0x3fa733c7, 0x2762658b,
+      0xf124a092, 0xe9e1f6de, 0xc0ae0c0a, 0xd86b5a46, 0x9231f9a2, 0x8af4afee,
+      0xa3bb553a, 0xbb7e0376, 0x370e12f2, 0x2fcb44be, 0x0684be6a, 0x1e41e826,
+      0x541b4bc2, 0x4cde1d8e, 0x6591e75a, 0x7d54b116, 0x1f7fdd35, 0x07ba8b79,
+      0x2ef571ad, 0x363027e1, 0x7c6a8405, 0x64afd249, 0x4de0289d, 0x55257ed1,
+      0xd9556f55, 0xc1903919, 0xe8dfc3cd, 0xf01a9581, 0xba403665, 0xa2856029,
+      0x8bca9afd, 0x930fccb1, 0x454909a8, 0x5d8c5fe4, 0x74c3a530, 0x6c06f37c,
+      0x265c5098, 0x3e9906d4, 0x17d6fc00, 0x0f13aa4c, 0x8363bbc8, 0x9ba6ed84,
+      0xb2e91750, 0xaa2c411c, 0xe076e2f8, 0xf8b3b4b4, 0xd1fc4e60, 0xc939182c,
+      0x15aa9626, 0x0d6fc06a, 0x24203abe, 0x3ce56cf2, 0x76bfcf16, 0x6e7a995a,
+      0x4735638e, 0x5ff035c2, 0xd3802446, 0xcb45720a, 0xe20a88de, 0xfacfde92,
+      0xb0957d76, 0xa8502b3a, 0x811fd1ee, 0x99da87a2, 0x4f9c42bb, 0x575914f7,
+      0x7e16ee23, 0x66d3b86f, 0x2c891b8b, 0x344c4dc7, 0x1d03b713, 0x05c6e15f,
+      0x89b6f0db, 0x9173a697, 0xb83c5c43, 0xa0f90a0f, 0xeaa3a9eb, 0xf266ffa7,
+      0xdb290573, 0xc3ec533f, 0xa1c73f1c, 0xb9026950, 0x904d9384, 0x8888c5c8,
+      0xc2d2662c, 0xda173060, 0xf358cab4, 0xeb9d9cf8, 0x67ed8d7c, 0x7f28db30,
+      0x566721e4, 0x4ea277a8, 0x04f8d44c, 0x1c3d8200, 0x357278d4, 0x2db72e98,
+      0xfbf1eb81, 0xe334bdcd, 0xca7b4719, 0xd2be1155, 0x98e4b2b1, 0x8021e4fd,
+      0xa96e1e29, 0xb1ab4865, 0x3ddb59e1, 0x251e0fad, 0x0c51f579, 0x1494a335,
+      0x5ece00d1, 0x460b569d, 0x6f44ac49, 0x7781fa05 }
+};
+#endif
+#endif
 
 /**
  * @brief Encode the CRC32K as little-endian byte order
@@ -38,10 +225,14 @@ size_t cobs_crc32k_encode(uint8_t *buffer, size_t buffer_size, uint32_t crc)
  * @param dataValue new data value equivalent to one octet.
  * @param crc32kValue accumulated value equivalent to four octets.
  * @return value is updated CRC.
- * @note This function is copied directly from the BACnet standard.
+ * @note This function is copied directly from the BACnet standard,
+ *  unless the CRC tables are built with CRC_USE_TABLE.
  */
 uint32_t cobs_crc32k(uint8_t dataValue, uint32_t crc32kValue)
 {
+#if defined(CRC_USE_TABLE)
+    return (crc32kValue >> 8) ^ CRC32K_Table[(crc32kValue ^ dataValue) & 0xFF];
+#else
     uint8_t data, b;
     uint32_t crc;
 
@@ -59,86 +250,182 @@ uint32_t cobs_crc32k(uint8_t dataValue, uint32_t crc32kValue)
     }
 
     return crc; /* Return updated crc value */
+#endif
 }
 
 /**
- * @brief Encodes 'length' octets of data located at 'from' and
- * writes one or more COBS code blocks at 'buffer', removing
- * any 0x55 octets that may present be in the encoded data.
+ * @brief Accumulate a block of octets into the CRC in "crc32kValue".
+ * @param buffer - octets to accumulate
+ * @param length - number of octets in the buffer
+ * @param crc32kValue accumulated value equivalent to four octets.
+ * @return value is updated CRC.
+ */
+uint32_t
+cobs_crc32k_block(const uint8_t *buffer, size_t length, uint32_t crc32kValue)
+{
+    size_t i = 0;
+
+#if defined(CRC_USE_SLICE_BY_4)
+    for (; (i + 4) <= length; i += 4) {
+        crc32kValue ^= (uint32_t)buffer[i] | ((uint32_t)buffer[i + 1] << 8) |
+            ((uint32_t)buffer[i + 2] << 16) | ((uint32_t)buffer[i + 3] << 24);
+        crc32kValue = CRC32K_Slice[2][crc32kValue & 0xFF] ^
+            CRC32K_Slice[1][(crc32kValue >> 8) & 0xFF] ^
+            CRC32K_Slice[0][(crc32kValue >> 16) & 0xFF] ^
+            CRC32K_Table[crc32kValue >> 24];
+    }
+#endif
+    for (; i < length; i++) {
+        crc32kValue = cobs_crc32k(buffer[i], crc32kValue);
+    }
+
+    return crc32kValue;
+}
+
+/* a word that has each octet set to the value */
+#define COBS_WORD(x) ((uint32_t)(x) * 0x01010101UL)
+/* non-zero if any octet of the word is zero */
+#define COBS_WORD_HAS_ZERO(w) \
+    (((w) - COBS_WORD(0x01)) & ~(w) & COBS_WORD(0x80))
+
+/**
+ * @brief Count the non-zero octets at the start of the data, looking at
+ *  four octets at a time until a word that has a zero octet
+ * @param from - data to scan
+ * @param length - most octets to scan
+ * @return number of non-zero octets before the first zero octet
+ */
+static size_t cobs_nonzero_length(const uint8_t *from, size_t length)
+{
+    size_t i = 0;
+    uint32_t word;
+
+    while ((i + 4) <= length) {
+        memcpy(&word, &from[i], sizeof(word));
+        if (COBS_WORD_HAS_ZERO(word)) {
+            break;
+        }
+        i += 4;
+    }
+    while ((i < length) && (from[i] != 0)) {
+        i++;
+    }
+
+    return i;
+}
+
+/**
+ * @brief Copy octets with each one exclusive-or'ed with the mask, four
+ *  octets at a time. Safe to call with 'buffer' <= 'from'.
+ * @param buffer - destination
+ * @param from - source
+ * @param length - number of octets to copy
+ * @param mask - value that each octet is exclusive-or'ed with
+ */
+static void cobs_mask_copy(
+    uint8_t *buffer, const uint8_t *from, size_t length, uint8_t mask)
+{
+    size_t i = 0;
+    uint32_t word;
+
+    for (; (i + 4) <= length; i += 4) {
+        memcpy(&word, &from[i], sizeof(word));
+        word ^= COBS_WORD(mask);
+        memcpy(&buffer[i], &word, sizeof(word));
+    }
+    for (; i < length; i++) {
+        buffer[i] = from[i] ^ mask;
+    }
+}
+
+/**
+ * @brief Encodes the data into COBS code blocks, and accumulates the
+ *  CRC32K of each code block as it is written
  * @param buffer - encoded buffer
  * @param buffer_size - encoded buffer size
  * @param from - buffer to encode
  * @param length - number of bytes in the buffer to encode
+ * @param mask - value that each encoded octet is exclusive-or'ed with
+ * @param crc32kValue - CRC32K that is accumulated, or NULL
  * @return the length of the encoded data, or 0 if error
- * @note This function is copied mostly from the BACnet standard.
  */
-size_t cobs_encode(
+static size_t cobs_encode_crc32k(
     uint8_t *buffer,
     size_t buffer_size,
     const uint8_t *from,
     size_t length,
-    uint8_t mask)
+    uint8_t mask,
+    uint32_t *crc32kValue)
 {
     size_t code_index = 0;
     size_t read_index = 0;
-    size_t write_index = 1;
-    uint8_t code = 1;
-    uint8_t data = 0;
-    uint8_t last_code = 0;
+    size_t run;
 
     if ((buffer_size < 1) || (length < 1)) {
         /* error - buffer too small */
         return 0;
     }
-    while (read_index < length) {
-        data = from[read_index++];
+    for (;;) {
         /*
-         * In the case of encountering a non-zero octet in the data,
-         * simply copy input to output and increment the code octet.
+         * Each code block holds up to 254 non-zero octets, and ends at
+         * a zero in the data, at 254 octets, or at the end of the data
+         * as if a "phantom zero" is appended to the data.
          */
-        if (data != 0) {
-            if (write_index == buffer_size) {
-                /* error - buffer too small */
-                return 0;
-            }
-            buffer[write_index++] = data ^ mask;
-            code++;
-            if (code != 255) {
-                continue;
-            }
+        run = length - read_index;
+        if (run > 254) {
+            run = 254;
         }
-        /*
-         * In the case of encountering a zero in the data or having
-         * copied the maximum number (254) of non-zero octets, store
-         * the code octet and reset the encoder state variables.
-         */
-        last_code = code;
-        if (code_index == buffer_size) {
+        run = cobs_nonzero_length(&from[read_index], run);
+        if ((buffer_size - code_index) < (run + 1)) {
             /* error - buffer too small */
             return 0;
         }
-        buffer[code_index] = code ^ mask;
-        code_index = write_index++;
-        code = 1;
-    }
-    /*
-     * If the last chunk contains exactly 254 non-zero octets, then
-     * this exception is handled above (and returned length must be
-     * adjusted). Otherwise, encode the last chunk normally, as if
-     * a "phantom zero" is appended to the data.
-     */
-    if ((last_code == 255) && (code == 1)) {
-        write_index--;
-    } else {
-        if (code_index == buffer_size) {
-            /* error - buffer too small */
-            return 0;
+        buffer[code_index] = (uint8_t)(run + 1) ^ mask;
+        cobs_mask_copy(&buffer[code_index + 1], &from[read_index], run, mask);
+        if (crc32kValue) {
+            *crc32kValue =
+                cobs_crc32k_block(&buffer[code_index], run + 1, *crc32kValue);
+        }
+        code_index += run + 1;
+        read_index += run;
+        if (run == 254) {
+            /* a full block has no implicit zero */
+            if (read_index == length) {
+                break;
+            }
+        } else if (read_index < length) {
+            /* skip the zero that ended the block */
+            read_index++;
+        } else {
+            break;
         }
-        buffer[code_index] = code ^ mask;
     }
 
-    return write_index;
+    return code_index;
 }
+
+/**
+ * @brief Encodes 'length' octets of data located at 'from' and
+ * writes one or more COBS code blocks at 'buffer', removing
+ * any 0x55 octets that may present be in the encoded data.
+ * @param buffer - encoded buffer
+ * @param buffer_size - encoded buffer size
+ * @param from - buffer to encode
+ * @param length - number of bytes in the buffer to encode
+ * @return the length of the encoded data, or 0 if error
+ * @note The encoding is the one in the BACnet standard, with the
+ *  non-zero octets found and copied four at a time.
+ */
+size_t cobs_encode(
+    uint8_t *buffer,
+    size_t buffer_size,
+    const uint8_t *from,
+    size_t length,
+    uint8_t mask)
+{
+    return cobs_encode_crc32k(buffer, buffer_size, from, length, mask, NULL);
+}
+
 /**
  * @brief Encodes 'length' octets of client data located at 'from' and writes
  * the COBS-encoded Encoded Data and Encoded CRC-32K fields at 'buffer'.
@@ -155,24 +442,18 @@ size_t cobs_frame_encode(
     size_t cobs_data_len, cobs_crc_len;
     uint32_t crc32K;
     uint8_t crc_buffer[4];
-    int i;
 
     /*
-     * Prepare the Encoded Data field for transmission.
+     * Prepare the Encoded Data field for transmission, and calculate
+     * the CRC-32K over the Encoded Data field as it is written.
      */
-    cobs_data_len =
-        cobs_encode(buffer, buffer_size, from, length, MSTP_PREAMBLE_X55);
+    crc32K = CRC32K_INITIAL_VALUE;
+    /* See Clause G.3.1 */
+    cobs_data_len = cobs_encode_crc32k(
+        buffer, buffer_size, from, length, MSTP_PREAMBLE_X55, &crc32K);
     if (cobs_data_len == 0) {
         return 0;
     }
-    /*
-     * Calculate CRC-32K over the Encoded Data field.
-     * NOTE: May be done as each octet is transmitted to reduce latency.
-     */
-    crc32K = CRC32K_INITIAL_VALUE;
-    for (i = 0; i < cobs_data_len; i++) {
-        crc32K = cobs_crc32k(buffer[i], crc32K); /* See Clause G.3.1 */
-    }
     /*
      * Prepare the Encoded CRC-32K field for transmission.
      */
@@ -192,55 +473,55 @@ size_t cobs_frame_encode(
 }
 
 /**
- * @brief Decodes 'length' octets of data located at 'from' and
- * writes the original client data at 'buffer', restoring any
- * 'mask' octets that may present in the encoded data.
+ * @brief Decodes the COBS code blocks, and accumulates the CRC32K of
+ *  each code block before it is decoded
  * @param buffer - decoded buffer
  * @param buffer_size - decoded buffer size
  * @param from - buffer to decode
  * @param length - number of bytes in the buffer to decode
+ * @param mask - value that each encoded octet is exclusive-or'ed with
+ * @param crc32kValue - CRC32K that is accumulated, or NULL
  * @return the length of the decoded buffer, or 0 if error
- * @note This function is copied directly from the BACnet standard.
  */
-size_t cobs_decode(
+static size_t cobs_decode_crc32k(
     uint8_t *buffer,
     size_t buffer_size,
     const uint8_t *from,
     size_t length,
-    uint8_t mask)
+    uint8_t mask,
+    uint32_t *crc32kValue)
 {
     size_t read_index = 0;
     size_t write_index = 0;
-    uint8_t code, last_code;
+    uint8_t code;
 
     while (read_index < length) {
         code = from[read_index] ^ mask;
-        last_code = code;
         /*
-         * Sanity check the encoding to prevent the while() loop below
+         * Sanity check the encoding to prevent the copy below
          * from overrunning the output buffer.
          */
         if ((code == 0) || ((read_index + code) > length)) {
             return 0;
         }
-        read_index++;
-        while (--code > 0) {
-            if (write_index == buffer_size) {
-                /* error - destination buffer too small */
-                return 0;
-            }
-            if (read_index == length) {
-                /* error - source buffer too small */
-                return 0;
-            }
-            buffer[write_index++] = from[read_index++] ^ mask;
+        if ((buffer_size - write_index) < (size_t)(code - 1)) {
+            /* error - destination buffer too small */
+            return 0;
+        }
+        if (crc32kValue) {
+            *crc32kValue =
+                cobs_crc32k_block(&from[read_index], code, *crc32kValue);
         }
+        cobs_mask_copy(
+            &buffer[write_index], &from[read_index + 1], code - 1, mask);
+        write_index += code - 1;
+        read_index += code;
         /*
          * Restore the implicit zero at the end of each decoded block
          * except when it contains exactly 254 non-zero octets or the
          * end of data has been reached.
          */
-        if ((last_code != 255) && (read_index < length)) {
+        if ((code != 255) && (read_index < length)) {
             if (write_index == buffer_size) {
                 /* error - destination buffer too small */
                 return 0;
@@ -252,6 +533,28 @@ size_t cobs_decode(
     return write_index;
 }
 
+/**
+ * @brief Decodes 'length' octets of data located at 'from' and
+ * writes the original client data at 'buffer', restoring any
+ * 'mask' octets that may present in the encoded data.
+ * @param buffer - decoded buffer
+ * @param buffer_size - decoded buffer size
+ * @param from - buffer to decode
+ * @param length - number of bytes in the buffer to decode
+ * @return the length of the decoded buffer, or 0 if error
+ * @note The decoding is the one in the BACnet standard, with the
+ *  octets of each code block copied four at a time.
+ */
+size_t cobs_decode(
+    uint8_t *buffer,
+    size_t buffer_size,
+    const uint8_t *from,
+    size_t length,
+    uint8_t mask)
+{
+    return cobs_decode_crc32k(buffer, buffer_size, from, length, mask, NULL);
+}
+
 /**
  * Decodes Encoded Data and Encoded CRC-32K fields at 'from' and
  * writes the decoded client data at 'buffer'. Assumes 'length' contains
@@ -271,24 +574,21 @@ size_t cobs_frame_decode(
     size_t data_len, crc_len;
     uint32_t crc32K;
     uint8_t crc_buffer[4];
-    int i;
 
     if (length < COBS_ENCODED_CRC_SIZE) {
         /* error during decode */
         return 0;
     }
     /*
-     * Calculate the CRC32K over the Encoded Data octets before decoding.
+     * Calculate the CRC32K over each block of the Encoded Data octets
+     * before it is decoded.
      * NOTE: Adjust 'length' by removing size of Encoded CRC-32K field.
      */
     data_len = length - COBS_ENCODED_CRC_SIZE;
     crc32K = CRC32K_INITIAL_VALUE;
-    for (i = 0; i < data_len; i++) {
-        /* See Clause G.3.1 */
-        crc32K = cobs_crc32k(from[i], crc32K);
-    }
-    data_len =
-        cobs_decode(buffer, buffer_size, from, data_len, MSTP_PREAMBLE_X55);
+    /* See Clause G.3.1 */
+    data_len = cobs_decode_crc32k(
+        buffer, buffer_size, from, data_len, MSTP_PREAMBLE_X55, &crc32K);
     if (data_len == 0) {
         /* error during decode */
         return 0;
@@ -308,9 +608,7 @@ size_t cobs_frame_decode(
     /*
      * Continue to verify CRC32K of incoming frame.
      */
-    for (i = 0; i < crc_len; i++) {
-        crc32K = cobs_crc32k(crc_buffer[i], crc32K);
-    }
+    crc32K = cobs_crc32k_block(crc_buffer, crc_len, crc32K);
     if (crc32K == CRC32K_RESIDUE) {
         return data_len;
     }
@@ -15,6 +15,15 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 
+/* Build options for the CRC implementation:
+   default - bit operations, copied from the BACnet standard
+   CRC_USE_TABLE - one 256 entry table per CRC
+   CRC_USE_SLICE_BY_4 - three more tables per CRC, so that the block
+   functions accumulate four octets at a time */
+#if defined(CRC_USE_SLICE_BY_4) && !defined(CRC_USE_TABLE)
+#define CRC_USE_TABLE
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -23,6 +32,9 @@ BACNET_STACK_EXPORT
 uint8_t CRC_Calc_Header(uint8_t dataValue, uint8_t crcValue);
 BACNET_STACK_EXPORT
 uint16_t CRC_Calc_Data(uint8_t dataValue, uint16_t crcValue);
+BACNET_STACK_EXPORT
+uint16_t
+CRC_Calc_Data_Block(const uint8_t *buffer, size_t length, uint16_t crcValue);
 
 #ifdef __cplusplus
 }
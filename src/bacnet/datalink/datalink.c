@@ -36,108 +36,123 @@
 #if defined(BACDL_BSC)
 #include "bacnet/datalink/bsc/bsc-datalink.h"
 #endif
-
-static enum {
-    DATALINK_NONE = 0,
-    DATALINK_ARCNET,
-    DATALINK_ETHERNET,
-    DATALINK_BIP,
-    DATALINK_BIP6,
-    DATALINK_MSTP,
-    DATALINK_ZIGBEE,
-    DATALINK_BSC
-} Datalink_Transport;
-
-void datalink_set(char *datalink_string)
-{
-    if (bacnet_stricmp("none", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_NONE;
-    }
-#if defined(BACDL_BIP)
-    else if (bacnet_stricmp("bip", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_BIP;
-    }
-#endif
-#if defined(BACDL_BIP6)
-    else if (bacnet_stricmp("bip6", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_BIP6;
-    }
-#endif
-#if defined(BACDL_ETHERNET)
-    else if (bacnet_stricmp("ethernet", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_ETHERNET;
-    }
-#endif
-#if defined(BACDL_ARCNET)
-    else if (bacnet_stricmp("arcnet", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_ARCNET;
-    }
-#endif
-#if defined(BACDL_MSTP)
-    else if (bacnet_stricmp("mstp", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_MSTP;
-    }
+#if defined(BACDL_LOOPBACK)
+#include "bacnet/datalink/loopback.h"
 #endif
-#if defined(BACDL_ZIGBEE)
-    else if (bacnet_stricmp("zigbee", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_ARCNET;
-    }
-#endif
-#if defined(BACDL_BSC)
-    else if (bacnet_stricmp("bsc", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_BSC;
-    }
-#endif
-}
-
-bool datalink_init(char *ifname)
-{
-    bool status = false;
 
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            status = true;
-            break;
+/* the datalinks that are built in, by name and Network Port type */
+static const BACNET_DATALINK_FUNCTIONS Datalink_Functions_Table[] = {
 #if defined(BACDL_ARCNET)
-        case DATALINK_ARCNET:
-            status = arcnet_init(ifname);
-            break;
+    { "arcnet", PORT_TYPE_ARCNET, arcnet_init, arcnet_send_pdu, NULL,
+      arcnet_receive, arcnet_cleanup, arcnet_get_broadcast_address,
+      arcnet_get_my_address, NULL },
 #endif
 #if defined(BACDL_ETHERNET)
-        case DATALINK_ETHERNET:
-            status = ethernet_init(ifname);
-            break;
+    { "ethernet", PORT_TYPE_ETHERNET, ethernet_init, ethernet_send_pdu, NULL,
+      ethernet_receive, ethernet_cleanup, ethernet_get_broadcast_address,
+      ethernet_get_my_address, NULL },
 #endif
 #if defined(BACDL_BIP)
-        case DATALINK_BIP:
-            status = bip_init(ifname);
-            break;
+    { "bip", PORT_TYPE_BIP, bip_init, bip_send_pdu, bvlc_send_pdubuf,
+      bip_receive, bip_cleanup, bip_get_broadcast_address,
+      bip_get_my_address, bvlc_maintenance_timer },
 #endif
 #if defined(BACDL_BIP6)
-        case DATALINK_BIP6:
-            status = bip6_init(ifname);
-            break;
+    { "bip6", PORT_TYPE_BIP6, bip6_init, bip6_send_pdu, NULL, bip6_receive,
+      bip6_cleanup, bip6_get_broadcast_address, bip6_get_my_address,
+      bvlc6_maintenance_timer },
 #endif
 #if defined(BACDL_MSTP)
-        case DATALINK_MSTP:
-            status = dlmstp_init(ifname);
-            break;
+    { "mstp", PORT_TYPE_MSTP, dlmstp_init, dlmstp_send_pdu, NULL,
+      dlmstp_receive, dlmstp_cleanup, dlmstp_get_broadcast_address,
+      dlmstp_get_my_address, NULL },
 #endif
 #if defined(BACDL_ZIGBEE)
-        case DATALINK_ZIGBEE:
-            status = bzll_init(ifname);
-            break;
+    { "zigbee", PORT_TYPE_ZIGBEE, bzll_init, bzll_send_pdu, NULL,
+      bzll_receive, bzll_cleanup, bzll_get_broadcast_address,
+      bzll_get_my_address, bzll_maintenance_timer },
 #endif
 #if defined(BACDL_BSC)
-        case DATALINK_BSC:
-            status = bsc_init(ifname);
-            break;
-#endif
-        default:
-            break;
+    { "bsc", PORT_TYPE_BSC, bsc_init, bsc_send_pdu, NULL, bsc_receive,
+      bsc_cleanup, bsc_get_broadcast_address, bsc_get_my_address,
+      bsc_maintenance_timer },
+#endif
+#if defined(BACDL_LOOPBACK)
+    { "loopback", PORT_TYPE_VIRTUAL, loopback_init, loopback_send_pdu, NULL,
+      loopback_receive, loopback_cleanup, loopback_get_broadcast_address,
+      loopback_get_my_address, NULL },
+#endif
+};
+#define DATALINK_FUNCTIONS_COUNT \
+    (sizeof(Datalink_Functions_Table) / sizeof(Datalink_Functions_Table[0]))
+
+/* the datalink of datalink_init() and the others, or NULL for none */
+static const BACNET_DATALINK_FUNCTIONS *Datalink_Transport;
+/* the datalinks that are active at once, each with its own port */
+static BACNET_DATALINK_PORT *Datalink_Port_List;
+
+/**
+ * @brief Get the functions of a datalink that is built in
+ * @param name - name of the datalink, such as "bip" or "mstp"
+ * @return the functions of the datalink, or NULL if it is not built in
+ */
+const BACNET_DATALINK_FUNCTIONS *datalink_functions(const char *name)
+{
+    unsigned i;
+
+    if (!name) {
+        return NULL;
+    }
+    for (i = 0; i < DATALINK_FUNCTIONS_COUNT; i++) {
+        if (bacnet_stricmp(Datalink_Functions_Table[i].name, name) == 0) {
+            return &Datalink_Functions_Table[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get the functions of the datalink of a Network Port type
+ * @param port_type - Network_Type of a Network Port object, such as
+ *  PORT_TYPE_BIP or PORT_TYPE_MSTP
+ * @return the functions of the datalink, or NULL if it is not built in
+ */
+const BACNET_DATALINK_FUNCTIONS *
+datalink_functions_by_port_type(uint8_t port_type)
+{
+    unsigned i;
+
+    for (i = 0; i < DATALINK_FUNCTIONS_COUNT; i++) {
+        if (Datalink_Functions_Table[i].port_type == port_type) {
+            return &Datalink_Functions_Table[i];
+        }
     }
 
-    return status;
+    return NULL;
+}
+
+void datalink_set(char *datalink_string)
+{
+    const BACNET_DATALINK_FUNCTIONS *functions;
+
+    if (bacnet_stricmp("none", datalink_string) == 0) {
+        Datalink_Transport = NULL;
+    } else {
+        functions = datalink_functions(datalink_string);
+        if (functions) {
+            Datalink_Transport = functions;
+        }
+    }
+}
+
+bool datalink_init(char *ifname)
+{
+    if (!Datalink_Transport) {
+        return true;
+    }
+
+    return Datalink_Transport->init(ifname);
 }
 
 int datalink_send_pdu(
@@ -146,324 +161,234 @@ int datalink_send_pdu(
     uint8_t *pdu,
     unsigned pdu_len)
 {
-    int bytes = 0;
-
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            bytes = pdu_len;
-            break;
-#if defined(BACDL_ARCNET)
-        case DATALINK_ARCNET:
-            bytes = arcnet_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-#endif
-#if defined(BACDL_ETHERNET)
-        case DATALINK_ETHERNET:
-            bytes = ethernet_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-#endif
-#if defined(BACDL_BIP)
-        case DATALINK_BIP:
-            bytes = bip_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-#endif
-#if defined(BACDL_BIP6)
-        case DATALINK_BIP6:
-            bytes = bip6_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-#endif
-#if defined(BACDL_MSTP)
-        case DATALINK_MSTP:
-            bytes = dlmstp_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-#endif
-#if defined(BACDL_ZIGBEE)
-        case DATALINK_ZIGBEE:
-            bytes = bzll_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-#endif
-#if defined(BACDL_BSC)
-        case DATALINK_BSC:
-            bytes = bsc_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-#endif
-        default:
-            break;
+    if (!Datalink_Transport) {
+        return pdu_len;
     }
 
-    return bytes;
+    return Datalink_Transport->send_pdu(dest, npdu_data, pdu, pdu_len);
 }
 
 uint16_t datalink_receive(
     BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
 {
-    uint16_t bytes = 0;
-
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-#if defined(BACDL_ARCNET)
-        case DATALINK_ARCNET:
-            bytes = arcnet_receive(src, pdu, max_pdu, timeout);
-            break;
-#endif
-#if defined(BACDL_ETHERNET)
-        case DATALINK_ETHERNET:
-            bytes = ethernet_receive(src, pdu, max_pdu, timeout);
-            break;
-#endif
-#if defined(BACDL_BIP)
-        case DATALINK_BIP:
-            bytes = bip_receive(src, pdu, max_pdu, timeout);
-            break;
-#endif
-#if defined(BACDL_BIP6)
-        case DATALINK_BIP6:
-            bytes = bip6_receive(src, pdu, max_pdu, timeout);
-            break;
-#endif
-#if defined(BACDL_MSTP)
-        case DATALINK_MSTP:
-            bytes = dlmstp_receive(src, pdu, max_pdu, timeout);
-            break;
-#endif
-#if defined(BACDL_ZIGBEE)
-        case DATALINK_ZIGBEE:
-            bytes = bzll_receive(src, pdu, max_pdu, timeout);
-            break;
-#endif
-#if defined(BACDL_BSC)
-        case DATALINK_BSC:
-            bytes = bsc_receive(src, pdu, max_pdu, timeout);
-            break;
-#endif
-        default:
-            break;
+    if (!Datalink_Transport) {
+        return 0;
     }
 
-    return bytes;
+    return Datalink_Transport->receive(src, pdu, max_pdu, timeout);
 }
 
 void datalink_cleanup(void)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-#if defined(BACDL_ARCNET)
-        case DATALINK_ARCNET:
-            arcnet_cleanup();
-            break;
-#endif
-#if defined(BACDL_ETHERNET)
-        case DATALINK_ETHERNET:
-            ethernet_cleanup();
-            break;
-#endif
-#if defined(BACDL_BIP)
-        case DATALINK_BIP:
-            bip_cleanup();
-            break;
-#endif
-#if defined(BACDL_BIP6)
-        case DATALINK_BIP6:
-            bip6_cleanup();
-            break;
-#endif
-#if defined(BACDL_MSTP)
-        case DATALINK_MSTP:
-            dlmstp_cleanup();
-            break;
-#endif
-#if defined(BACDL_ZIGBEE)
-        case DATALINK_ZIGBEE:
-            bzll_cleanup();
-            break;
-#endif
-#if defined(BACDL_BSC)
-        case DATALINK_BSC:
-            bsc_cleanup();
-            break;
-#endif
-        default:
-            break;
+    if (Datalink_Transport) {
+        Datalink_Transport->cleanup();
     }
 }
 
 void datalink_get_broadcast_address(BACNET_ADDRESS *dest)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-#if defined(BACDL_ARCNET)
-        case DATALINK_ARCNET:
-            arcnet_get_broadcast_address(dest);
-            break;
-#endif
-#if defined(BACDL_ETHERNET)
-        case DATALINK_ETHERNET:
-            ethernet_get_broadcast_address(dest);
-            break;
-#endif
-#if defined(BACDL_BIP)
-        case DATALINK_BIP:
-            bip_get_broadcast_address(dest);
-            break;
-#endif
-#if defined(BACDL_BIP6)
-        case DATALINK_BIP6:
-            bip6_get_broadcast_address(dest);
-            break;
-#endif
-#if defined(BACDL_MSTP)
-        case DATALINK_MSTP:
-            dlmstp_get_broadcast_address(dest);
-            break;
-#endif
-#if defined(BACDL_ZIGBEE)
-        case DATALINK_ZIGBEE:
-            bzll_get_broadcast_address(dest);
-            break;
-#endif
-#if defined(BACDL_BSC)
-        case DATALINK_BSC:
-            bsc_get_broadcast_address(dest);
-            break;
-#endif
-        default:
-            break;
+    if (Datalink_Transport) {
+        Datalink_Transport->get_broadcast_address(dest);
     }
 }
 
 void datalink_get_my_address(BACNET_ADDRESS *my_address)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-#if defined(BACDL_ARCNET)
-        case DATALINK_ARCNET:
-            arcnet_get_my_address(my_address);
-            break;
-#endif
-#if defined(BACDL_ETHERNET)
-        case DATALINK_ETHERNET:
-            ethernet_get_my_address(my_address);
-            break;
-#endif
-#if defined(BACDL_BIP)
-        case DATALINK_BIP:
-            bip_get_my_address(my_address);
-            break;
-#endif
-#if defined(BACDL_BIP6)
-        case DATALINK_BIP6:
-            bip6_get_my_address(my_address);
-            break;
-#endif
-#if defined(BACDL_MSTP)
-        case DATALINK_MSTP:
-            dlmstp_get_my_address(my_address);
-            break;
-#endif
-#if defined(BACDL_ZIGBEE)
-        case DATALINK_ZIGBEE:
-            bzll_get_my_address(my_address);
-            break;
-#endif
-#if defined(BACDL_BSC)
-        case DATALINK_BSC:
-            bsc_get_my_address(my_address);
-            break;
-#endif
-        default:
-            break;
+    if (Datalink_Transport) {
+        Datalink_Transport->get_my_address(my_address);
     }
 }
 
 void datalink_set_interface(char *ifname)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            (void)ifname;
-            break;
-#if defined(BACDL_ARCNET)
-        case DATALINK_ARCNET:
-            (void)ifname;
-            break;
-#endif
-#if defined(BACDL_ETHERNET)
-        case DATALINK_ETHERNET:
-            (void)ifname;
-            break;
-#endif
-#if defined(BACDL_BIP)
-        case DATALINK_BIP:
-            (void)ifname;
-            break;
-#endif
-#if defined(BACDL_BIP6)
-        case DATALINK_BIP6:
-            (void)ifname;
-            break;
-#endif
-#if defined(BACDL_MSTP)
-        case DATALINK_MSTP:
-            (void)ifname;
-            break;
-#endif
-#if defined(BACDL_ZIGBEE)
-        case DATALINK_ZIGBEE:
-            (void)ifname;
-            break;
-#endif
-#if defined(BACDL_BSC)
-        case DATALINK_BSC:
-            (void)ifname;
-            break;
-#endif
-        default:
-            break;
-    }
+    (void)ifname;
 }
 
 void datalink_maintenance_timer(uint16_t seconds)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-#if defined(BACDL_ARCNET)
-        case DATALINK_ARCNET:
-            break;
-#endif
-#if defined(BACDL_ETHERNET)
-        case DATALINK_ETHERNET:
-            break;
-#endif
-#if defined(BACDL_BIP)
-        case DATALINK_BIP:
-            bvlc_maintenance_timer(seconds);
-            break;
-#endif
-#if defined(BACDL_BIP6)
-        case DATALINK_BIP6:
-            bvlc6_maintenance_timer(seconds);
-            break;
-#endif
-#if defined(BACDL_MSTP)
-        case DATALINK_MSTP:
-            break;
-#endif
-#if defined(BACDL_ZIGBEE)
-        case DATALINK_ZIGBEE:
-            bzll_maintenance_timer(seconds);
-            break;
-#endif
-#if defined(BACDL_BSC)
-        case DATALINK_BSC:
-            bsc_maintenance_timer(seconds);
-            break;
-#endif
-        default:
+    if (Datalink_Transport && Datalink_Transport->maintenance_timer) {
+        Datalink_Transport->maintenance_timer(seconds);
+    }
+}
+
+/**
+ * @brief Add a port for a datalink that is active at the same time as the
+ *  datalinks of the other ports.  Each datalink keeps its own state, so
+ *  each datalink can have one port.
+ * @param port - the port, which is kept in the list of ports
+ * @param functions - the functions of the datalink of the port
+ * @param network_port_instance - instance of the Network Port object
+ *  that configures the datalink
+ * @return true if the port was added
+ */
+bool datalink_port_add(
+    BACNET_DATALINK_PORT *port,
+    const BACNET_DATALINK_FUNCTIONS *functions,
+    uint32_t network_port_instance)
+{
+    BACNET_DATALINK_PORT **next;
+
+    if (!port || !functions) {
+        return false;
+    }
+    next = &Datalink_Port_List;
+    while (*next) {
+        if ((*next == port) || ((*next)->functions == functions) ||
+            ((*next)->network_port_instance == network_port_instance)) {
+            return false;
+        }
+        next = &(*next)->next;
+    }
+    port->functions = functions;
+    port->network_port_instance = network_port_instance;
+    port->next = NULL;
+    *next = port;
+
+    return true;
+}
+
+/**
+ * @brief Find the port of a Network Port object
+ * @param network_port_instance - instance of the Network Port object
+ * @return the port, or NULL if there is no port for the object
+ */
+BACNET_DATALINK_PORT *datalink_port_find(uint32_t network_port_instance)
+{
+    BACNET_DATALINK_PORT *port;
+
+    for (port = Datalink_Port_List; port; port = port->next) {
+        if (port->network_port_instance == network_port_instance) {
             break;
+        }
+    }
+
+    return port;
+}
+
+/**
+ * @brief Initialize the datalink of a port
+ * @param port - the port
+ * @param ifname - name of the interface of the datalink, or NULL
+ * @return true if the datalink was initialized
+ */
+bool datalink_port_init(BACNET_DATALINK_PORT *port, char *ifname)
+{
+    if (!port || !port->functions) {
+        return false;
+    }
+
+    return port->functions->init(ifname);
+}
+
+/**
+ * @brief Send an NPDU out of the datalink of a port
+ * @param port - the port
+ * @param dest - destination address
+ * @param npdu_data - network layer control flags and data
+ * @param pdu - the NPDU
+ * @param pdu_len - number of bytes in the NPDU
+ * @return number of bytes sent, or <= 0 if not sent
+ */
+int datalink_port_send_pdu(
+    BACNET_DATALINK_PORT *port,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    if (!port || !port->functions) {
+        return -1;
+    }
+
+    return port->functions->send_pdu(dest, npdu_data, pdu, pdu_len);
+}
+
+/**
+ * @brief Receive and handle the NPDUs of all of the ports in one loop
+ *
+ * Each port is polled once without waiting, so that a busy port does not
+ * hold up the others.  When none of the ports had an NPDU, the ports are
+ * polled again, and the timeout is shared among them.  Each NPDU is passed
+ * to the handler with its port, before the next one is received into the
+ * same buffer.
+ *
+ * @param src - buffer for the source address of each NPDU
+ * @param pdu - buffer for each NPDU
+ * @param max_pdu - size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for an NPDU
+ * @param handler - function called with each NPDU and its port
+ * @return number of NPDUs handled
+ */
+unsigned datalink_port_receive(
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout,
+    datalink_port_receive_handler handler)
+{
+    BACNET_DATALINK_PORT *port;
+    unsigned count = 0, ports = 0;
+    unsigned wait = 0;
+    uint16_t pdu_len;
+
+    for (port = Datalink_Port_List; port; port = port->next) {
+        pdu_len = port->functions->receive(src, pdu, max_pdu, 0);
+        if (pdu_len > 0) {
+            if (handler) {
+                handler(port, src, pdu, pdu_len);
+            }
+            count++;
+        }
+        ports++;
+    }
+    if ((count == 0) && (ports > 0) && (timeout > 0)) {
+        wait = timeout / ports;
+        if (wait == 0) {
+            wait = 1;
+        }
+        for (port = Datalink_Port_List; port; port = port->next) {
+            pdu_len = port->functions->receive(src, pdu, max_pdu, wait);
+            if (pdu_len > 0) {
+                if (handler) {
+                    handler(port, src, pdu, pdu_len);
+                }
+                count++;
+                /* the other ports are only polled */
+                wait = 0;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Pass the elapsed time to the datalink of each port
+ * @param seconds - number of elapsed seconds since the last call
+ */
+void datalink_port_maintenance_timer(uint16_t seconds)
+{
+    BACNET_DATALINK_PORT *port;
+
+    for (port = Datalink_Port_List; port; port = port->next) {
+        if (port->functions->maintenance_timer) {
+            port->functions->maintenance_timer(seconds);
+        }
+    }
+}
+
+/**
+ * @brief Clean up the datalink of each port, and empty the list of ports
+ */
+void datalink_port_cleanup(void)
+{
+    BACNET_DATALINK_PORT *port;
+
+    while (Datalink_Port_List) {
+        port = Datalink_Port_List;
+        Datalink_Port_List = port->next;
+        port->functions->cleanup();
+        port->next = NULL;
     }
 }
 #endif
@@ -530,3 +455,79 @@ void datalink_maintenance_timer(uint16_t seconds)
     (void)seconds;
 }
 #endif
+
+#if !defined(BACDL_TEST)
+/**
+ * @brief Receive and handle a burst of NPDUs from the datalink
+ *
+ * Waits up to timeout milliseconds for the first NPDU, then takes any
+ * further NPDUs that are already waiting, up to max_packets, without
+ * waiting again. Each NPDU is passed to the handler (for example,
+ * npdu_handler) before the next one is received into the same buffer.
+ * Datalinks that read datagrams in batches, such as BACnet/IP on Linux,
+ * return the rest of a batch here without any further system calls.
+ *
+ * @param src - buffer for the source address of each NPDU
+ * @param pdu - buffer for each NPDU
+ * @param max_pdu - size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for the first NPDU
+ * @param max_packets - maximum number of NPDUs to handle
+ * @param handler - function called with each NPDU
+ * @return number of NPDUs handled
+ */
+unsigned datalink_receive_batch(
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout,
+    unsigned max_packets,
+    datalink_receive_handler handler)
+{
+    unsigned count = 0;
+    uint16_t pdu_len;
+
+    while (count < max_packets) {
+        pdu_len = datalink_receive(src, pdu, max_pdu, timeout);
+        if (pdu_len == 0) {
+            break;
+        }
+        if (handler) {
+            handler(src, pdu, pdu_len);
+        }
+        count++;
+        timeout = 0;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Send an NPDU from a PDU buffer
+ *
+ * Datalinks that can prepend their header in the headroom of the buffer,
+ * such as BACnet/IP, send the NPDU without copying it into a frame
+ * buffer of their own.  The others are given a copy of the NPDU as
+ * by datalink_send_pdu().  The buffer is not released, and may hold the
+ * datalink frame after this returns.
+ *
+ * @param dest - destination address
+ * @param npdu_data - network layer control flags and data
+ * @param buf - PDU buffer holding the NPDU
+ * @return number of bytes sent, or -1 on error
+ */
+int datalink_send_pdubuf(
+    BACNET_ADDRESS *dest, BACNET_NPDU_DATA *npdu_data, PDU_BUFFER *buf)
+{
+#if defined(BACDL_BIP) && !defined(BACDL_MULTIPLE)
+    return bvlc_send_pdubuf(dest, npdu_data, buf);
+#else
+#if defined(BACDL_MULTIPLE)
+    if (Datalink_Transport && Datalink_Transport->send_pdubuf) {
+        return Datalink_Transport->send_pdubuf(dest, npdu_data, buf);
+    }
+#endif
+    return datalink_send_pdu(
+        dest, npdu_data, pdubuf_data(buf), pdubuf_length(buf));
+#endif
+}
+#endif
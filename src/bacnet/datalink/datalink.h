@@ -38,6 +38,9 @@
 #include "bacnet/datalink/bsc/bsc-conf.h"
 #include "bacnet/datalink/bsc/bsc-datalink.h"
 #endif
+#if defined(BACDL_LOOPBACK)
+#include "bacnet/datalink/loopback.h"
+#endif
 
 #if defined(BACDL_ETHERNET) && !defined(BACDL_MULTIPLE)
 #define MAX_MPDU ETHERNET_MPDU_MAX
@@ -129,6 +132,17 @@ void routed_get_my_address(BACNET_ADDRESS *my_address);
 #define datalink_get_my_address bsc_get_my_address
 #define datalink_maintenance_timer(s) bsc_maintenance_timer(s)
 
+#elif defined(BACDL_LOOPBACK) && !defined(BACDL_MULTIPLE)
+#define MAX_MPDU LOOPBACK_MPDU_MAX
+
+#define datalink_init loopback_init
+#define datalink_send_pdu loopback_send_pdu
+#define datalink_receive loopback_receive
+#define datalink_cleanup loopback_cleanup
+#define datalink_get_broadcast_address loopback_get_broadcast_address
+#define datalink_get_my_address loopback_get_my_address
+#define datalink_maintenance_timer(s)
+
 #elif !defined(BACDL_TEST) /* Multiple, none or custom datalink */
 #include "bacnet/npdu.h"
 
@@ -171,6 +185,137 @@ void datalink_set(char *datalink_string);
 BACNET_STACK_EXPORT
 void datalink_maintenance_timer(uint16_t seconds);
 
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#if defined(BACDL_MULTIPLE)
+#include "bacnet/basic/sys/pdubuf.h"
+
+/* the functions of a datalink, which are chosen at runtime by name
+   with datalink_set(), or given to each port of the datalinks that
+   are active at the same time */
+typedef struct bacnet_datalink_functions {
+    /* name of the datalink, such as "bip" or "mstp" */
+    const char *name;
+    /* Network_Type of the Network Port object of the datalink */
+    uint8_t port_type;
+    bool (*init)(char *ifname);
+    int (*send_pdu)(
+        BACNET_ADDRESS *dest,
+        BACNET_NPDU_DATA *npdu_data,
+        uint8_t *pdu,
+        unsigned pdu_len);
+    /* optional: send from the headroom of a PDU buffer */
+    int (*send_pdubuf)(
+        const BACNET_ADDRESS *dest,
+        const BACNET_NPDU_DATA *npdu_data,
+        PDU_BUFFER *buf);
+    uint16_t (*receive)(
+        BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout);
+    void (*cleanup)(void);
+    void (*get_broadcast_address)(BACNET_ADDRESS *dest);
+    void (*get_my_address)(BACNET_ADDRESS *my_address);
+    /* optional: called about once a second */
+    void (*maintenance_timer)(uint16_t seconds);
+} BACNET_DATALINK_FUNCTIONS;
+
+/* a datalink that is active at the same time as the datalinks of the
+   other ports, such as in a gateway between BACnet/IP and MS/TP */
+typedef struct bacnet_datalink_port {
+    const BACNET_DATALINK_FUNCTIONS *functions;
+    /* instance of the Network Port object of the datalink */
+    uint32_t network_port_instance;
+    struct bacnet_datalink_port *next;
+} BACNET_DATALINK_PORT;
+
+/**
+ * @brief Callback for each NPDU returned by datalink_port_receive()
+ * @param port - port where the NPDU was received
+ * @param src - source address of the NPDU
+ * @param pdu - the NPDU
+ * @param pdu_len - number of bytes in the NPDU
+ */
+typedef void (*datalink_port_receive_handler)(
+    BACNET_DATALINK_PORT *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t pdu_len);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+const BACNET_DATALINK_FUNCTIONS *datalink_functions(const char *name);
+BACNET_STACK_EXPORT
+const BACNET_DATALINK_FUNCTIONS *
+datalink_functions_by_port_type(uint8_t port_type);
+
+BACNET_STACK_EXPORT
+bool datalink_port_add(
+    BACNET_DATALINK_PORT *port,
+    const BACNET_DATALINK_FUNCTIONS *functions,
+    uint32_t network_port_instance);
+BACNET_STACK_EXPORT
+BACNET_DATALINK_PORT *datalink_port_find(uint32_t network_port_instance);
+BACNET_STACK_EXPORT
+bool datalink_port_init(BACNET_DATALINK_PORT *port, char *ifname);
+BACNET_STACK_EXPORT
+int datalink_port_send_pdu(
+    BACNET_DATALINK_PORT *port,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len);
+BACNET_STACK_EXPORT
+unsigned datalink_port_receive(
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout,
+    datalink_port_receive_handler handler);
+BACNET_STACK_EXPORT
+void datalink_port_maintenance_timer(uint16_t seconds);
+BACNET_STACK_EXPORT
+void datalink_port_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
+#endif
+
+#if !defined(BACDL_TEST)
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/pdubuf.h"
+
+/**
+ * @brief Callback for each NPDU returned by datalink_receive_batch()
+ * @param src - source address of the NPDU
+ * @param pdu - the NPDU
+ * @param pdu_len - number of bytes in the NPDU
+ */
+typedef void (*datalink_receive_handler)(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+unsigned datalink_receive_batch(
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout,
+    unsigned max_packets,
+    datalink_receive_handler handler);
+
+BACNET_STACK_EXPORT
+int datalink_send_pdubuf(
+    BACNET_ADDRESS *dest, BACNET_NPDU_DATA *npdu_data, PDU_BUFFER *buf);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -194,9 +339,13 @@ void datalink_maintenance_timer(uint16_t seconds);
  * - BACDL_BIP      -- for ANNEX J - BACnet/IPv4
  * - BACDL_BIP6     -- for ANNEX U - BACnet/IPv6
  * - BACDL_BSC      -- for ANNEX AB - BACnet Secure Connect (BACnet/SC)
+ * - BACDL_LOOPBACK -- for the in-process loopback, which benchmarks and
+ *                     profiles the stack talking to itself without sockets
  * - BACDL_ALL      -- Unspecified for the build, so the transport can be
  *                     chosen at runtime from among these choices.
- * - BACDL_MULTIPLE  -- For multiple transports enabled in the same application
+ * - BACDL_MULTIPLE  -- For multiple transports enabled in the same application,
+ *                     one chosen with datalink_set(), or each active at once
+ *                     on its own port with datalink_port_add()
  * - BACDL_NONE      -- Unspecified for the build for unit testing
  * - BACDL_CUSTOM    -- For externally linked datalink_xxx functions
  * - Clause 10 POINT-TO-POINT (PTP) and Clause 11 EIA/CEA-709.1 ("LonTalk") LAN
@@ -11,12 +11,16 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <signal.h>
+#include <time.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/apdu.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/bactrace.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 #include "bacnet/basic/object/netport.h"
@@ -27,6 +31,8 @@
 #include "bacnet/datalink/bsc/bsc-util.h"
 #include "bacnet/datalink/bsc/bsc-datalink.h"
 #include "bacnet/datalink/bsc/bsc-event.h"
+#include "bacnet/datalink/bsc/bsc-hub-function.h"
+#include "bacnet/datalink/bsc/bsc-node-switch.h"
 #include "bacnet/datalink/bvlc.h"
 #include "bacnet/datalink/bvlc6.h"
 #include "bacnet/datalink/datalink.h"
@@ -51,6 +57,30 @@ static BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY BBMD_Table_Entry;
 #endif
 static uint32_t Network_Port_Instance = 1;
 
+#if BACNET_TRACE_ENABLED
+/* name of the trace file written at exit, or when asked with SIGUSR1 */
+static const char *Trace_Filename;
+static volatile sig_atomic_t Trace_Dump_Requested;
+#endif
+
+#if (BACNET_PERFSTAT_ENABLED || BACNET_TRACE_ENABLED) && \
+    defined(CLOCK_MONOTONIC)
+/**
+ * @brief Clock for the latency of the service handlers, and for the
+ *  times of the trace events
+ * @return free running time in microseconds
+ */
+static uint32_t dlenv_clock_usec(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000U) +
+                      ((uint64_t)now.tv_nsec / 1000U));
+}
+#endif
+
 /**
  * @brief Enabled debug printing of BACnet/IPv4 DL
  */
@@ -369,6 +399,7 @@ static void dlenv_network_port_bip_init(uint32_t instance)
 #if defined(BACDL_BIP)
     BACNET_IP_ADDRESS addr = { 0 };
     uint8_t prefix = 0;
+    uint8_t ttl = 1;
     uint8_t addr0, addr1, addr2, addr3;
     char *pEnv = NULL;
     BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_table = NULL;
@@ -403,6 +434,19 @@ static void dlenv_network_port_bip_init(uint32_t instance)
     if (pEnv) {
         bip_set_broadcast_binding(pEnv);
     }
+    pEnv = getenv("BACNET_IP_MULTICAST_GROUP");
+    if (pEnv) {
+        if (bip_get_addr_by_name(pEnv, &addr)) {
+            pEnv = getenv("BACNET_IP_MULTICAST_TTL");
+            if (pEnv) {
+                ttl = (uint8_t)strtol(pEnv, NULL, 0);
+            }
+            if (!bip_set_multicast_group(&addr, ttl)) {
+                debug_fprintf(
+                    stderr, "BACNET_IP_MULTICAST_GROUP is not a group!\n");
+            }
+        }
+    }
     pEnv = getenv("BACNET_IP_NAT_ADDR");
     if (pEnv) {
         if (bip_get_addr_by_name(pEnv, &addr)) {
@@ -470,6 +514,7 @@ void dlenv_network_port_mstp_init(uint32_t instance)
     long max_info_frames = 1;
     long baud_rate = 38400;
     long mac_address = 127;
+    bool adaptive = false;
 
     pEnv = getenv("BACNET_MSTP_DEBUG");
     if (pEnv) {
@@ -491,17 +536,22 @@ void dlenv_network_port_mstp_init(uint32_t instance)
     if (pEnv) {
         mac_address = strtol(pEnv, NULL, 0);
     }
+    pEnv = getenv("BACNET_MSTP_ADAPTIVE");
+    if (pEnv) {
+        adaptive = strtol(pEnv, NULL, 0) != 0;
+    }
     if (Datalink_Debug) {
         debug_fprintf(
             stderr,
             "Network Port[%lu] mode=MSTP bitrate=%ld mac[0]=%ld "
-            "max_info_frames=%ld, max_master=%ld\n",
+            "max_info_frames=%ld, max_master=%ld adaptive=%s\n",
             (unsigned long)instance, baud_rate, mac_address, max_info_frames,
-            max_master);
+            max_master, adaptive ? "true" : "false");
     }
 #ifdef BACDL_MSTP
     dlmstp_set_max_info_frames(max_info_frames);
     dlmstp_set_max_master(max_master);
+    dlmstp_adaptive_enabled_set(adaptive);
     dlmstp_set_baud_rate(baud_rate);
     dlmstp_set_mac_address(mac_address);
 #endif
@@ -649,6 +699,8 @@ void dlenv_network_port_bsc_init(uint32_t instance)
     char *hub_binding;
     char *direct_connect_initiate;
     char *direct_connect_accept_urls;
+    char *pEnv;
+    long long_value;
     uint32_t file_instance;
     char c;
 
@@ -662,6 +714,39 @@ void dlenv_network_port_bsc_init(uint32_t instance)
     hub_binding = getenv("BACNET_SC_HUB_FUNCTION_BINDING");
     direct_connect_initiate = getenv("BACNET_SC_DIRECT_CONNECT_INITIATE");
     direct_connect_accept_urls = getenv("BACNET_SC_DIRECT_CONNECT_ACCEPT_URLS");
+    pEnv = getenv("BACNET_SC_HUB_FUNCTION_CONNECTIONS");
+    if (pEnv) {
+        long_value = strtol(pEnv, NULL, 0);
+        if (long_value > 0) {
+            bsc_hub_function_connections_set((size_t)long_value);
+        }
+    }
+    pEnv = getenv("BACNET_SC_DIRECT_CONNECT_CONNECTIONS");
+    if (pEnv) {
+        long_value = strtol(pEnv, NULL, 0);
+        if (long_value > 0) {
+            bsc_node_switch_connections_set((size_t)long_value);
+        }
+    }
+    pEnv = getenv("BACNET_SC_DIRECT_CONNECT_AUTO_RATE");
+    if (pEnv) {
+        long_value = strtol(pEnv, NULL, 0);
+        if (long_value > 0) {
+            size_t links = BSC_CONF_NODE_SWITCH_AUTO_LINKS_NUM;
+            uint16_t idle_s = BSC_CONF_NODE_SWITCH_AUTO_IDLE_S;
+
+            pEnv = getenv("BACNET_SC_DIRECT_CONNECT_AUTO_LINKS");
+            if (pEnv) {
+                links = (size_t)strtol(pEnv, NULL, 0);
+            }
+            pEnv = getenv("BACNET_SC_DIRECT_CONNECT_AUTO_IDLE");
+            if (pEnv) {
+                idle_s = (uint16_t)strtol(pEnv, NULL, 0);
+            }
+            bsc_node_switch_auto_connect_set(
+                (uint32_t)long_value, links, idle_s);
+        }
+    }
 #endif
     if (getenv("BACNET_SC_DEBUG")) {
         dlenv_debug_enable();
@@ -882,6 +967,78 @@ static bool bsc_register_as_node(uint32_t instance, bool wait_until_connected)
 #endif
 }
 
+#if BACNET_TRACE_ENABLED
+/**
+ * @brief Write the trace file
+ */
+static void dlenv_trace_dump(void)
+{
+    if (!bactrace_dump(Trace_Filename)) {
+        debug_fprintf(
+            stderr, "BACTRACE: unable to write %s\n", Trace_Filename);
+    }
+}
+
+#if defined(SIGUSR1)
+/**
+ * @brief Ask for the trace file, which is written by the next
+ *  maintenance timer, since a signal handler cannot write a file
+ * @param signo - the signal number
+ */
+static void dlenv_trace_signal(int signo)
+{
+    (void)signo;
+    Trace_Dump_Requested = 1;
+}
+#endif
+
+/**
+ * @brief Start the clock of the trace events, and write the trace file
+ *  named by BACNET_TRACE_FILE at exit, and with SIGUSR1 when the
+ *  platform has it
+ */
+static void dlenv_trace_init(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    bactrace_clock_set(dlenv_clock_usec);
+#endif
+    Trace_Filename = getenv("BACNET_TRACE_FILE");
+    if (Trace_Filename) {
+        atexit(dlenv_trace_dump);
+#if defined(SIGUSR1)
+        signal(SIGUSR1, dlenv_trace_signal);
+#endif
+    }
+}
+#endif
+
+#ifdef BACDL_MSTP
+/**
+ * @brief Copy the MS/TP max-info-frames and max-master values chosen
+ *  by the adaptive tuning into the Network Port object, unless a client
+ *  wrote changes into it that are pending
+ * @param instance - Network Port object instance
+ */
+static void dlenv_network_port_mstp_update(uint32_t instance)
+{
+    if (!dlmstp_adaptive_enabled()) {
+        return;
+    }
+    if (Network_Port_Changes_Pending(instance)) {
+        return;
+    }
+    if ((Network_Port_MSTP_Max_Info_Frames(instance) ==
+         dlmstp_max_info_frames()) &&
+        (Network_Port_MSTP_Max_Master(instance) == dlmstp_max_master())) {
+        return;
+    }
+    Network_Port_MSTP_Max_Info_Frames_Set(instance, dlmstp_max_info_frames());
+    Network_Port_MSTP_Max_Master_Set(instance, dlmstp_max_master());
+    /* the datalink already uses these values */
+    Network_Port_Changes_Pending_Set(instance, false);
+}
+#endif
+
 /** Datalink maintenance timer
  * @ingroup DataLink
  *
@@ -894,6 +1051,12 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
     struct dlmstp_statistics statistics = { 0 };
 #endif
 
+#if BACNET_TRACE_ENABLED
+    if (Trace_Dump_Requested) {
+        Trace_Dump_Requested = 0;
+        dlenv_trace_dump();
+    }
+#endif
     if (BBMD_Timer_Seconds) {
         if (BBMD_Timer_Seconds <= elapsed_seconds) {
             BBMD_Timer_Seconds = 0;
@@ -914,6 +1077,9 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
         }
     }
     if (Network_Port_Type(Network_Port_Instance) == PORT_TYPE_MSTP) {
+#ifdef BACDL_MSTP
+        dlenv_network_port_mstp_update(Network_Port_Instance);
+#endif
         Datalink_Debug_Timer_Seconds += elapsed_seconds;
         if (Datalink_Debug_Timer_Seconds >= 60) {
             Datalink_Debug_Timer_Seconds = 0;
@@ -947,7 +1113,8 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
  * @return Detected port type based on environment variables and
  * compile-time configuration, which can be PORT_TYPE_BIP,
  * PORT_TYPE_BIP6, PORT_TYPE_MSTP, PORT_TYPE_BSC, PORT_TYPE_ETHERNET,
- * PORT_TYPE_ARCNET, PORT_TYPE_ZIGBEE, or PORT_TYPE_NON_BACNET.
+ * PORT_TYPE_ARCNET, PORT_TYPE_ZIGBEE, PORT_TYPE_VIRTUAL (loopback),
+ * or PORT_TYPE_NON_BACNET.
  */
 uint8_t dlenv_get_port_type(void)
 {
@@ -974,6 +1141,8 @@ uint8_t dlenv_get_port_type(void)
             port_type = PORT_TYPE_MSTP;
         } else if (bacnet_stricmp("bsc", pEnv) == 0) {
             port_type = PORT_TYPE_BSC;
+        } else if (bacnet_stricmp("loopback", pEnv) == 0) {
+            port_type = PORT_TYPE_VIRTUAL;
         }
     } else {
 #if defined(BACDL_BIP)
@@ -997,6 +1166,9 @@ uint8_t dlenv_get_port_type(void)
 #elif defined(BACDL_BSC)
         datalink_set("bsc");
         port_type = PORT_TYPE_BSC;
+#elif defined(BACDL_LOOPBACK)
+        datalink_set("loopback");
+        port_type = PORT_TYPE_VIRTUAL;
 #else
         datalink_set("none");
         port_type = PORT_TYPE_NON_BACNET;
@@ -1019,6 +1191,8 @@ uint8_t dlenv_get_port_type(void)
     port_type = PORT_TYPE_ZIGBEE;
 #elif defined(BACDL_BSC)
     port_type = PORT_TYPE_BSC;
+#elif defined(BACDL_LOOPBACK)
+    port_type = PORT_TYPE_VIRTUAL;
 #else
     port_type = PORT_TYPE_NON_BACNET;
 #endif
@@ -1153,6 +1327,9 @@ bool dlenv_register_device(uint8_t port_type, bool wait_until_connected)
  *     waits for a response from a BACnet device.
  *   - BACNET_APDU_RETRIES - indicate the maximum number of times that
  *     an APDU shall be retransmitted.
+ *   - BACNET_TRACE_FILE - with BACNET_TRACE_ENABLED, the name of the
+ *     binary trace file that is written at exit, and when the process
+ *     gets SIGUSR1.
  *   - BACNET_IFACE - set this value to dotted IP address (Windows) of
  *     the interface (see ipconfig command on Windows) for which you
  *     want to bind.  On Linux, set this to the /dev interface
@@ -1175,11 +1352,18 @@ bool dlenv_register_device(uint8_t port_type, bool wait_until_connected)
  *       entry 1..128 (optional)
  *   - BACNET_IP_NAT_ADDR - dotted IPv4 address of the public facing router
  *   - BACNET_IP_BROADCAST_BIND_ADDR - dotted IPv4 address to bind broadcasts
+ *   - BACNET_IP_MULTICAST_GROUP - dotted IPv4 multicast group address that
+ *       is used for the BACnet broadcasts instead of the subnet directed
+ *       broadcast address (Annex J.8)
+ *   - BACNET_IP_MULTICAST_TTL - time-to-live of the multicasts (optional),
+ *       defaults to 1 to keep them on the local subnet
  * - BACDL_MSTP: (BACnet MS/TP)
  *   - BACNET_MAX_INFO_FRAMES
  *   - BACNET_MAX_MASTER
  *   - BACNET_MSTP_BAUD
  *   - BACNET_MSTP_MAC
+ *   - BACNET_MSTP_ADAPTIVE - non-zero to adapt the max-info-frames and
+ *     max-master values in use to the traffic on the MS/TP trunk
  * - BACDL_BIP6: (BACnet/IPv6)
  *   - BACNET_BIP6_PORT - UDP/IP port number (0..65534) used for BACnet/IPv6
  *     communications.  Default is 47808 (0xBAC0).
@@ -1206,10 +1390,27 @@ bool dlenv_register_device(uint8_t port_type, bool wait_until_connected)
  *   - BACNET_SC_DIRECT_CONNECT_ACCEPT_URLS - list of direct connect accept URLs
  *       separated by a space character, e.g.
  *       "wss://192.0.0.1:40000 wss://192.0.0.2:6666"
+ *   - BACNET_SC_HUB_FUNCTION_CONNECTIONS - number of connections that
+ *       the hub function accepts
+ *   - BACNET_SC_DIRECT_CONNECT_CONNECTIONS - number of direct connections
+ *       that the node accepts
+ *   - BACNET_SC_DIRECT_CONNECT_AUTO_RATE - octets per second of unicast
+ *       traffic through the hub to a peer that open a direct connection
+ *       to the peer
+ *   - BACNET_SC_DIRECT_CONNECT_AUTO_LINKS - maximum number of direct
+ *       connections that are opened for the traffic
+ *   - BACNET_SC_DIRECT_CONNECT_AUTO_IDLE - seconds without traffic before
+ *       such a direct connection is closed
  */
 void dlenv_init(void)
 {
     uint8_t port_type = dlenv_get_port_type();
+#if BACNET_PERFSTAT_ENABLED && defined(CLOCK_MONOTONIC)
+    perfstat_clock_set(dlenv_clock_usec);
+#endif
+#if BACNET_TRACE_ENABLED
+    dlenv_trace_init();
+#endif
     dlenv_init_no_device_registration(port_type);
     if (!dlenv_register_device(port_type, true)) {
         debug_fprintf(
@@ -16,6 +16,8 @@
 /* BACnet Stack API */
 #include "bacnet/basic/sys/ringbuf.h"
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/bactrace.h"
+#include "bacnet/basic/sys/perfstat.h"
 #include "bacnet/datalink/crc.h"
 #include "bacnet/datalink/mstp.h"
 #include "bacnet/datalink/dlmstp.h"
@@ -26,6 +28,58 @@
 /* the current MSTP port that the datalink is using */
 static struct mstp_port_struct_t *MSTP_Port;
 
+/**
+ * @brief Choose the transmit queue for a PDU. Replies to the request that
+ *  the node is answering, and life safety or critical equipment messages,
+ *  go to the priority queue, unless it is full.
+ * @param user - user data of the MSTP port
+ * @param mac - MS/TP destination address
+ * @param npdu_data - network layer information
+ * @return the transmit queue
+ */
+static RING_BUFFER *dlmstp_send_queue(
+    struct dlmstp_user_data_t *user,
+    uint8_t mac,
+    const BACNET_NPDU_DATA *npdu_data)
+{
+#if DLMSTP_PRIORITY_PACKETS
+    bool priority = false;
+
+    if (npdu_data->priority >= MESSAGE_PRIORITY_CRITICAL_EQUIPMENT) {
+        priority = true;
+    } else if (
+        (!npdu_data->data_expecting_reply) &&
+        (MSTP_Port->master_state == MSTP_MASTER_STATE_ANSWER_DATA_REQUEST) &&
+        (MSTP_Port->SourceAddress == mac)) {
+        priority = true;
+    }
+    if (priority && !Ringbuf_Full(&user->PDU_Priority_Queue)) {
+        return &user->PDU_Priority_Queue;
+    }
+#else
+    (void)mac;
+    (void)npdu_data;
+#endif
+
+    return &user->PDU_Queue;
+}
+
+/**
+ * @brief Get the transmit queue with the next PDU to send
+ * @param user - user data of the MSTP port
+ * @return the priority queue, unless it is empty
+ */
+static RING_BUFFER *dlmstp_next_queue(struct dlmstp_user_data_t *user)
+{
+#if DLMSTP_PRIORITY_PACKETS
+    if (!Ringbuf_Empty(&user->PDU_Priority_Queue)) {
+        return &user->PDU_Priority_Queue;
+    }
+#endif
+
+    return &user->PDU_Queue;
+}
+
 /**
  * @brief send an PDU via MSTP
  * @param dest - BACnet destination address
@@ -44,6 +98,8 @@ int dlmstp_send_pdu(
     unsigned i = 0; /* loop counter */
     struct dlmstp_user_data_t *user = NULL;
     struct dlmstp_packet *pkt;
+    RING_BUFFER *queue;
+    uint8_t mac = MSTP_BROADCAST_ADDRESS;
 
     if (!MSTP_Port) {
         return 0;
@@ -52,7 +108,17 @@ int dlmstp_send_pdu(
     if (!user) {
         return 0;
     }
-    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Data_Peek(&user->PDU_Queue);
+    if (dest && dest->mac_len) {
+        mac = dest->mac[0];
+    }
+    if ((pdu_len > MSTP_FRAME_NPDU_MAX) &&
+        MSTP_Extended_Frames_Refused(MSTP_Port, mac)) {
+        /* the station does not accept the extended frame that
+           the PDU needs, so the caller segments it or sends less */
+        return 0;
+    }
+    queue = dlmstp_send_queue(user, mac, npdu_data);
+    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Data_Peek(queue);
     if (pkt && (pdu_len <= DLMSTP_MPDU_MAX)) {
         if (npdu_data->data_expecting_reply) {
             pkt->frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
@@ -63,16 +129,10 @@ int dlmstp_send_pdu(
             pkt->pdu[i] = pdu[i];
         }
         pkt->pdu_len = pdu_len;
-        if (dest && dest->mac_len) {
-            pkt->address.mac_len = 1;
-            pkt->address.mac[0] = dest->mac[0];
-            pkt->address.len = 0;
-        } else {
-            pkt->address.mac_len = 1;
-            pkt->address.mac[0] = MSTP_BROADCAST_ADDRESS;
-            pkt->address.len = 0;
-        }
-        if (Ringbuf_Data_Put(&user->PDU_Queue, (uint8_t *)pkt)) {
+        pkt->address.mac_len = 1;
+        pkt->address.mac[0] = mac;
+        pkt->address.len = 0;
+        if (Ringbuf_Data_Put(queue, (uint8_t *)pkt)) {
             bytes_sent = pdu_len;
         }
     }
@@ -91,6 +151,7 @@ uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     uint16_t pdu_len = 0;
     struct dlmstp_packet *pkt;
     struct dlmstp_user_data_t *user;
+    RING_BUFFER *queue;
 
     (void)timeout;
     if (!mstp_port) {
@@ -100,35 +161,65 @@ uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     if (!user) {
         return 0;
     }
-    if (Ringbuf_Empty(&user->PDU_Queue)) {
+    queue = dlmstp_next_queue(user);
+    if (Ringbuf_Empty(queue)) {
         return 0;
     }
     /* look at next PDU in queue without removing it */
-    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek(&user->PDU_Queue);
+    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek(queue);
     /* convert the PDU into the MSTP Frame */
     pdu_len = MSTP_Create_Frame(
         &mstp_port->OutputBuffer[0], mstp_port->OutputBufferSize,
         pkt->frame_type, pkt->address.mac[0], mstp_port->This_Station,
         &pkt->pdu[0], pkt->pdu_len);
     user->Statistics.transmit_pdu_counter++;
-    (void)Ringbuf_Pop(&user->PDU_Queue, NULL);
+    PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_MSTP);
+    BACTRACE_DATALINK_SEND(PERFSTAT_DATALINK_MSTP, pkt->pdu_len);
+    (void)Ringbuf_Pop(queue, NULL);
 
     return pdu_len;
 }
 
+/**
+ * @brief Determine if the next PDU of a transmit queue is the reply
+ *  to the DATA_EXPECTING_REPLY frame that the node is answering
+ * @param mstp_port MSTP port structure for this port
+ * @param queue - the transmit queue
+ * @return the PDU, or NULL if it is not the reply
+ */
+static struct dlmstp_packet *
+dlmstp_reply_packet(struct mstp_port_struct_t *mstp_port, RING_BUFFER *queue)
+{
+    struct dlmstp_packet *pkt;
+
+    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek(queue);
+    if (pkt &&
+        npdu_is_data_expecting_reply(
+            &mstp_port->InputBuffer[0], mstp_port->DataLength,
+            mstp_port->SourceAddress, &pkt->pdu[0], pkt->pdu_len,
+            pkt->address.mac[0])) {
+        return pkt;
+    }
+
+    return NULL;
+}
+
 /**
  * @brief The MS/TP state machine uses this function for getting data to send
  *  as the reply to a DATA_EXPECTING_REPLY frame, or nothing
  * @param mstp_port MSTP port structure for this port
  * @param timeout number of milliseconds to wait for a packet
  * @return number of bytes, or 0 if no reply is available
+ * @note The reply is found at the head of the priority queue, where
+ *  dlmstp_send_pdu() puts it, or at the head of the PDU queue, so only
+ *  two PDUs are compared with the request.
  */
 uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 {
     uint16_t pdu_len = 0;
-    bool matched = false;
     struct dlmstp_user_data_t *user = NULL;
-    struct dlmstp_packet *pkt;
+    struct dlmstp_packet *pkt = NULL;
+    RING_BUFFER *queue = NULL;
 
     (void)timeout;
     if (!mstp_port) {
@@ -138,17 +229,15 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     if (!user) {
         return 0;
     }
-    if (Ringbuf_Empty(&user->PDU_Queue)) {
-        return 0;
+#if DLMSTP_PRIORITY_PACKETS
+    queue = &user->PDU_Priority_Queue;
+    pkt = dlmstp_reply_packet(mstp_port, queue);
+#endif
+    if (!pkt) {
+        queue = &user->PDU_Queue;
+        pkt = dlmstp_reply_packet(mstp_port, queue);
     }
-    /* look at next PDU in queue without removing it */
-    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek(&user->PDU_Queue);
-    /* is this the reply to the DER? */
-    matched = npdu_is_data_expecting_reply(
-        &mstp_port->InputBuffer[0], mstp_port->DataLength,
-        mstp_port->SourceAddress, &pkt->pdu[0], pkt->pdu_len,
-        pkt->address.mac[0]);
-    if (!matched) {
+    if (!pkt) {
         return 0;
     }
     if (npdu_is_segmented_complex_ack_reply(pkt->pdu, pkt->pdu_len)) {
@@ -171,7 +260,9 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
         pkt->frame_type, pkt->address.mac[0], mstp_port->This_Station,
         &pkt->pdu[0], pkt->pdu_len);
     user->Statistics.transmit_pdu_counter++;
-    (void)Ringbuf_Pop(&user->PDU_Queue, NULL);
+    PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_MSTP);
+    BACTRACE_DATALINK_SEND(PERFSTAT_DATALINK_MSTP, pkt->pdu_len);
+    (void)Ringbuf_Pop(queue, NULL);
 
     return pdu_len;
 }
@@ -238,6 +329,9 @@ uint16_t dlmstp_receive(
 {
     uint16_t pdu_len = 0;
     uint8_t data_register = 0;
+    const uint8_t *block = NULL;
+    uint16_t block_len = 0;
+    bool block_read = false;
     struct dlmstp_user_data_t *user;
     struct dlmstp_rs485_driver *driver;
     uint16_t i;
@@ -263,8 +357,29 @@ uint16_t dlmstp_receive(
         /* we're transmitting; do nothing else */
         return 0;
     }
+    block_read = driver->read_block && driver->read_block_done;
+    if (block_read && (MSTP_Port->ReceivedValidFrame == false) &&
+        (MSTP_Port->ReceivedInvalidFrame == false) &&
+        (MSTP_Port->ReceivedValidFrameNotForUs == false)) {
+        /* the driver hands over each run of octets in one block */
+        block_len = driver->read_block(&block);
+        if (block_len > 0) {
+            block_len =
+                (uint16_t)MSTP_Receive_Frame_Block(MSTP_Port, block, block_len);
+            driver->read_block_done(block_len);
+        } else {
+            /* no data: run the timeouts */
+            MSTP_Port->DataAvailable = false;
+            MSTP_Receive_Frame_FSM(MSTP_Port);
+        }
+        if (MSTP_Port->receive_state == MSTP_RECEIVE_STATE_PREAMBLE) {
+            if (user->Preamble_Callback) {
+                user->Preamble_Callback();
+            }
+        }
+    }
     /* only do receive state machine while we don't have a frame */
-    while ((MSTP_Port->ReceivedValidFrame == false) &&
+    while (!block_read && (MSTP_Port->ReceivedValidFrame == false) &&
            (MSTP_Port->ReceivedInvalidFrame == false) &&
            (MSTP_Port->ReceivedValidFrameNotForUs == false)) {
         MSTP_Port->DataAvailable = driver->read(&data_register);
@@ -349,7 +464,9 @@ uint16_t dlmstp_receive(
     if (user->ReceivePacketPending) {
         user->ReceivePacketPending = false;
         user->Statistics.receive_pdu_counter++;
+        PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_MSTP);
         pdu_len = MSTP_Port->DataLength;
+        BACTRACE_DATALINK_RECEIVE(PERFSTAT_DATALINK_MSTP, pdu_len);
         if (pdu_len > max_pdu) {
             /* PDU is too large */
             return 0;
@@ -458,14 +575,15 @@ void dlmstp_set_max_info_frames(uint8_t max_info_frames)
 
 /**
  * @brief Get the MSTP max-info-frames value
- * @return the MSTP max-info-frames value
+ * @return the MSTP max-info-frames value, which is the value chosen
+ *  by the adaptive tuning when it is enabled
  */
 uint8_t dlmstp_max_info_frames(void)
 {
     uint8_t value = 0;
 
     if (MSTP_Port) {
-        value = MSTP_Port->Nmax_info_frames;
+        value = MSTP_Max_Info_Frames(MSTP_Port);
     }
 
     return value;
@@ -493,14 +611,15 @@ void dlmstp_set_max_master(uint8_t max_master)
 
 /**
  * @brief Get the largest peer MAC address that we will seek
- * @return largest peer MAC address
+ * @return largest peer MAC address, which is the value chosen
+ *  by the adaptive tuning when it is enabled
  */
 uint8_t dlmstp_max_master(void)
 {
     uint8_t value = 0;
 
     if (MSTP_Port) {
-        value = MSTP_Port->Nmax_master;
+        value = MSTP_Max_Master(MSTP_Port);
     }
 
     return value;
@@ -620,6 +739,22 @@ bool dlmstp_zero_config_enabled_set(bool flag)
     return true;
 }
 
+/**
+ * @brief Set the MSTP port ZeroConfigAccelerated flag
+ * @param flag - true if the Zero Configuration address is acquired
+ *  from an address chosen by the UUID, skipping the addresses in use
+ * @return true if the MSTP port ZeroConfigAccelerated was set
+ */
+bool dlmstp_zero_config_accelerated_set(bool flag)
+{
+    if (!MSTP_Port) {
+        return false;
+    }
+    MSTP_Port->ZeroConfigAccelerated = flag;
+
+    return true;
+}
+
 /**
  * @brief Get the MSTP port AutoBaudEnabled status
  * @return true if the MSTP port has AutoBaudEnabled
@@ -653,6 +788,44 @@ bool dlmstp_check_auto_baud_set(bool flag)
     return true;
 }
 
+/**
+ * @brief Get the MSTP port AdaptiveEnabled status
+ * @return true if the MSTP port has AdaptiveEnabled
+ */
+bool dlmstp_adaptive_enabled(void)
+{
+    if (!MSTP_Port) {
+        return false;
+    }
+    return MSTP_Port->AdaptiveEnabled;
+}
+
+/**
+ * @brief Set the MSTP port AdaptiveEnabled flag
+ * @param flag - true if the MSTP port has AdaptiveEnabled
+ * @return true if the MSTP port AdaptiveEnabled was set
+ * @note This flag is used to enable the adaptive tuning of the MSTP port.
+ *  The max-info-frames value set for the port is raised, up to the number
+ *  of PDUs in the transmit queue, while the queue keeps the node busy for
+ *  its whole token. The Poll For Master sweeps stop at the highest master
+ *  node on the network, and go up to the max-master value set for the port
+ *  every MSTP_ADAPTIVE_SWEEPS sweeps to find new master nodes.
+ */
+bool dlmstp_adaptive_enabled_set(bool flag)
+{
+    if (!MSTP_Port) {
+        return false;
+    }
+    MSTP_Port->AdaptiveEnabled = flag;
+    MSTP_Port->Adaptive_Max_Info_Frames = DLMSTP_MAX_INFO_FRAMES;
+    MSTP_Port->Adaptive_Info_Frames = MSTP_Port->Nmax_info_frames;
+    MSTP_Port->Adaptive_Idle_Tokens = 0;
+    MSTP_Port->Adaptive_Max_Master_Seen = MSTP_Port->This_Station;
+    MSTP_Port->Adaptive_Sweep_Count = 0;
+
+    return true;
+}
+
 /**
  * @brief Get the MSTP port MAC address that this node prefers to use.
  * @return ZeroConfigStation value, or an out-of-range value if invalid
@@ -697,6 +870,9 @@ bool dlmstp_send_pdu_queue_empty(void)
         user = MSTP_Port->UserData;
         if (user) {
             status = Ringbuf_Empty(&user->PDU_Queue);
+#if DLMSTP_PRIORITY_PACKETS
+            status = status && Ringbuf_Empty(&user->PDU_Priority_Queue);
+#endif
         }
     }
 
@@ -1039,6 +1215,13 @@ bool dlmstp_init(char *ifname)
                 &user->PDU_Queue, (volatile uint8_t *)user->PDU_Buffer,
                 sizeof(user->PDU_Buffer), sizeof(struct dlmstp_packet),
                 DLMSTP_MAX_INFO_FRAMES);
+#if DLMSTP_PRIORITY_PACKETS
+            Ringbuf_Initialize(
+                &user->PDU_Priority_Queue,
+                (volatile uint8_t *)user->PDU_Priority_Buffer,
+                sizeof(user->PDU_Priority_Buffer), sizeof(struct dlmstp_packet),
+                DLMSTP_PRIORITY_PACKETS);
+#endif
             MSTP_Init(MSTP_Port);
             user->Initialized = true;
         }
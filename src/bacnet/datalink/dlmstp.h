@@ -46,12 +46,32 @@ typedef struct dlmstp_statistics {
     uint32_t poll_for_master_counter;
 } DLMSTP_STATISTICS;
 
+/* container for the timing of the state machines, for ports that
+   measure it */
+typedef struct dlmstp_timing_statistics {
+    /* timeouts that the state machines handled, and how much later
+       than the timeout that was */
+    uint32_t timeout_counter;
+    uint32_t timeout_late_max_usec;
+    uint64_t timeout_late_sum_usec;
+    /* frames sent, and their time from the last octet on the wire */
+    uint32_t turnaround_counter;
+    uint32_t turnaround_min_usec;
+    uint32_t turnaround_max_usec;
+} DLMSTP_TIMING_STATISTICS;
+
 #ifndef DLMSTP_MAX_INFO_FRAMES
 #define DLMSTP_MAX_INFO_FRAMES DEFAULT_MAX_INFO_FRAMES
 #endif
 #ifndef DLMSTP_MAX_MASTER
 #define DLMSTP_MAX_MASTER DEFAULT_MAX_MASTER
 #endif
+/* number of PDUs in the priority transmit queue, which holds the reply
+   to the request that the node is answering, and the life safety and
+   critical equipment messages. Zero, or else a power of two. */
+#ifndef DLMSTP_PRIORITY_PACKETS
+#define DLMSTP_PRIORITY_PACKETS 1
+#endif
 #ifndef DLMSTP_BAUD_RATE_DEFAULT
 #define DLMSTP_BAUD_RATE_DEFAULT 38400UL
 #endif
@@ -83,6 +103,14 @@ struct dlmstp_rs485_driver {
 
     /** Reset the silence time */
     void (*silence_reset)(void);
+
+    /** Optional: get a run of received octets that arrived without a gap,
+        such as a DMA transfer that ended when the line went idle.
+        Returns the number of octets, and leaves them in the driver. */
+    uint16_t (*read_block)(const uint8_t **buffer);
+
+    /** Optional: release the octets consumed from the read_block run */
+    void (*read_block_done)(uint16_t count);
 };
 
 /* callback to signify the receipt of a preamble */
@@ -110,6 +138,11 @@ struct dlmstp_user_data_t {
     /* the PDU Queue is made of Nmax_info_frames x dlmstp_packet's */
     RING_BUFFER PDU_Queue;
     struct dlmstp_packet PDU_Buffer[DLMSTP_MAX_INFO_FRAMES];
+#if DLMSTP_PRIORITY_PACKETS
+    /* the PDUs in this queue are sent before the PDU Queue */
+    RING_BUFFER PDU_Priority_Queue;
+    struct dlmstp_packet PDU_Priority_Buffer[DLMSTP_PRIORITY_PACKETS];
+#endif
     bool Initialized;
     bool ReceivePacketPending;
     void *Context;
@@ -129,6 +162,10 @@ BACNET_STACK_EXPORT
 void dlmstp_reset(void);
 BACNET_STACK_EXPORT
 void dlmstp_cleanup(void);
+/* file descriptor that is readable while a received PDU is waiting,
+   for ports that provide one to an event loop */
+BACNET_STACK_EXPORT
+int dlmstp_get_receive_fd(void);
 
 /* returns number of bytes sent on success, negative on failure */
 BACNET_STACK_EXPORT
@@ -201,10 +238,16 @@ bool dlmstp_zero_config_enabled(void);
 BACNET_STACK_EXPORT
 bool dlmstp_zero_config_enabled_set(bool flag);
 BACNET_STACK_EXPORT
+bool dlmstp_zero_config_accelerated_set(bool flag);
+BACNET_STACK_EXPORT
 bool dlmstp_check_auto_baud(void);
 BACNET_STACK_EXPORT
 bool dlmstp_check_auto_baud_set(bool flag);
 BACNET_STACK_EXPORT
+bool dlmstp_adaptive_enabled(void);
+BACNET_STACK_EXPORT
+bool dlmstp_adaptive_enabled_set(bool flag);
+BACNET_STACK_EXPORT
 uint8_t dlmstp_zero_config_preferred_station(void);
 BACNET_STACK_EXPORT
 bool dlmstp_zero_config_preferred_station_set(uint8_t station);
@@ -264,6 +307,19 @@ void dlmstp_reset_statistics(void);
 BACNET_STACK_EXPORT
 void dlmstp_fill_statistics(struct dlmstp_statistics *statistics);
 
+/* Precise timing of the state machines, and its statistics, for ports
+   that provide it.  Enable it, and the CPU to pin the thread to or -1,
+   before dlmstp_init() */
+BACNET_STACK_EXPORT
+void dlmstp_precise_timing_set(bool enable, int cpu);
+BACNET_STACK_EXPORT
+bool dlmstp_precise_timing(void);
+BACNET_STACK_EXPORT
+void dlmstp_reset_timing_statistics(void);
+BACNET_STACK_EXPORT
+void dlmstp_fill_timing_statistics(
+    struct dlmstp_timing_statistics *statistics);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
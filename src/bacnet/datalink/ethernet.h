@@ -32,6 +32,8 @@ BACNET_STACK_EXPORT
 void ethernet_cleanup(void);
 BACNET_STACK_EXPORT
 bool ethernet_init(char *interface_name);
+BACNET_STACK_EXPORT
+int ethernet_get_socket(void);
 
 /* function to send a packet out the 802.2 socket */
 /* returns number of bytes sent on success, negative on failure */
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @brief In-process loopback datalink
+ *
+ * The PDUs that the stack sends to its own station address, or as a
+ * broadcast, are put in a memory queue and received again by the stack,
+ * as if they came from the network.  A confirmed request that the stack
+ * sends to its own device is then answered by its own service handlers,
+ * and the answer goes to its own TSM, so the network, application, and
+ * object code can be profiled and benchmarked without any sockets or
+ * system calls.  The PDUs sent to any other station are not delivered.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DataLink
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacaddr.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/datalink/loopback.h"
+
+struct loopback_packet {
+    uint16_t pdu_len;
+    uint8_t pdu[LOOPBACK_MPDU_MAX];
+};
+
+static struct loopback_packet Loopback_Packets[LOOPBACK_QUEUE_SIZE];
+static RING_BUFFER Loopback_Queue;
+static bool Loopback_Initialized;
+/* PDUs for this node that did not fit in the queue */
+static uint32_t Loopback_Dropped;
+
+/**
+ * @brief Initialize the loopback datalink, and empty its queue
+ * @param ifname - not used, since there is no interface
+ * @return true if the datalink was initialized
+ */
+bool loopback_init(char *ifname)
+{
+    (void)ifname;
+    Loopback_Initialized = Ringbuf_Init(
+        &Loopback_Queue, (volatile uint8_t *)Loopback_Packets,
+        sizeof(struct loopback_packet), LOOPBACK_QUEUE_SIZE);
+    Loopback_Dropped = 0;
+
+    return Loopback_Initialized;
+}
+
+/**
+ * @brief Stop the loopback datalink, and discard the PDUs in its queue
+ */
+void loopback_cleanup(void)
+{
+    Loopback_Initialized = false;
+}
+
+/**
+ * @brief Send a PDU, which is given back to this node when it is
+ *  addressed to this node or is a broadcast
+ * @param dest - BACnet destination address
+ * @param npdu_data - network layer information
+ * @param pdu - PDU data to send
+ * @param pdu_len - number of bytes of PDU data to send
+ * @return number of bytes sent, or -1 when the queue is full
+ */
+int loopback_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    struct loopback_packet *pkt;
+
+    (void)npdu_data;
+    if (!Loopback_Initialized || !pdu || (pdu_len > LOOPBACK_MPDU_MAX)) {
+        return -1;
+    }
+    if (dest && (dest->mac_len == 1) &&
+        (dest->mac[0] != LOOPBACK_MAC_ADDRESS) &&
+        (dest->mac[0] != LOOPBACK_BROADCAST_ADDRESS)) {
+        /* there are no other stations to receive it */
+        return (int)pdu_len;
+    }
+    pkt = (struct loopback_packet *)(void *)Ringbuf_Data_Peek(&Loopback_Queue);
+    if (!pkt) {
+        Loopback_Dropped++;
+        return -1;
+    }
+    memcpy(pkt->pdu, pdu, pdu_len);
+    pkt->pdu_len = (uint16_t)pdu_len;
+    (void)Ringbuf_Data_Put(&Loopback_Queue, (volatile uint8_t *)pkt);
+
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Receive the next PDU from the queue
+ * @param src - source address of the PDU, which is this node
+ * @param pdu - buffer for the PDU
+ * @param max_pdu - size of the buffer
+ * @param timeout - not used: the queue is only filled by this node,
+ *  so nothing arrives while waiting
+ * @return number of bytes of the PDU, or 0 when the queue is empty
+ */
+uint16_t loopback_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    struct loopback_packet *pkt;
+    uint16_t pdu_len = 0;
+
+    (void)timeout;
+    if (!Loopback_Initialized || Ringbuf_Empty(&Loopback_Queue)) {
+        return 0;
+    }
+    pkt = (struct loopback_packet *)(void *)Ringbuf_Peek(&Loopback_Queue);
+    if (pdu && (pkt->pdu_len <= max_pdu)) {
+        memcpy(pdu, pkt->pdu, pkt->pdu_len);
+        pdu_len = pkt->pdu_len;
+        if (src) {
+            loopback_get_my_address(src);
+        }
+    }
+    (void)Ringbuf_Pop(&Loopback_Queue, NULL);
+
+    return pdu_len;
+}
+
+/**
+ * @brief Get the station address of this node
+ * @param my_address - address of this node
+ */
+void loopback_get_my_address(BACNET_ADDRESS *my_address)
+{
+    if (my_address) {
+        bacnet_address_init(my_address, NULL, 0, NULL);
+        my_address->mac_len = 1;
+        my_address->mac[0] = LOOPBACK_MAC_ADDRESS;
+    }
+}
+
+/**
+ * @brief Get the broadcast address of the loopback datalink
+ * @param dest - the broadcast address
+ */
+void loopback_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    if (dest) {
+        bacnet_address_init(dest, NULL, BACNET_BROADCAST_NETWORK, NULL);
+        dest->mac_len = 1;
+        dest->mac[0] = LOOPBACK_BROADCAST_ADDRESS;
+    }
+}
+
+/**
+ * @brief Get the number of PDUs waiting in the queue
+ * @return number of PDUs
+ */
+unsigned loopback_queue_count(void)
+{
+    if (!Loopback_Initialized) {
+        return 0;
+    }
+
+    return Ringbuf_Count(&Loopback_Queue);
+}
+
+/**
+ * @brief Get the number of PDUs for this node that did not fit in the
+ *  queue since the datalink was initialized
+ * @return number of PDUs
+ */
+uint32_t loopback_dropped_count(void)
+{
+    return Loopback_Dropped;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief API for the in-process loopback datalink, which gives the PDUs
+ *  that the stack sends to itself back to it through a memory queue
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DataLink
+ */
+#ifndef BACNET_DATALINK_LOOPBACK_H
+#define BACNET_DATALINK_LOOPBACK_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/npdu.h"
+
+/* there is no frame, so the MPDU is the NPDU */
+#define LOOPBACK_MPDU_MAX MAX_PDU
+/* the one octet station address of this node, and of a broadcast */
+#ifndef LOOPBACK_MAC_ADDRESS
+#define LOOPBACK_MAC_ADDRESS 0x01
+#endif
+#define LOOPBACK_BROADCAST_ADDRESS 0xFF
+/* number of PDUs that can wait in the queue - must be a power of two */
+#ifndef LOOPBACK_QUEUE_SIZE
+#define LOOPBACK_QUEUE_SIZE 64
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool loopback_init(char *ifname);
+BACNET_STACK_EXPORT
+void loopback_cleanup(void);
+BACNET_STACK_EXPORT
+int loopback_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len);
+BACNET_STACK_EXPORT
+uint16_t loopback_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout);
+BACNET_STACK_EXPORT
+void loopback_get_my_address(BACNET_ADDRESS *my_address);
+BACNET_STACK_EXPORT
+void loopback_get_broadcast_address(BACNET_ADDRESS *dest);
+
+BACNET_STACK_EXPORT
+unsigned loopback_queue_count(void);
+BACNET_STACK_EXPORT
+uint32_t loopback_dropped_count(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -26,6 +26,7 @@
 #if PRINT_ENABLED
 #include <stdio.h>
 #endif
+#include "bacnet/bacdcode.h"
 #include "bacnet/datalink/cobs.h"
 #include "bacnet/datalink/crc.h"
 #include "bacnet/datalink/mstp.h"
@@ -33,6 +34,7 @@
 #include "bacnet/datalink/mstptext.h"
 #include "bacnet/npdu.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/perfstat.h"
 
 #if PRINT_ENABLED
 #undef PRINT_ENABLED_RECEIVE
@@ -220,8 +222,8 @@ uint16_t MSTP_Create_Frame(
         }
         for (index = 8; index < (data_len + 8); index++, data++) {
             buffer[index] = *data;
-            crc16 = CRC_Calc_Data(buffer[index], crc16);
         }
+        crc16 = CRC_Calc_Data_Block(&buffer[8], data_len, crc16);
         crc16 = ~crc16;
         buffer[index] = crc16 & 0xFF; /* LSB first */
         buffer[index + 1] = crc16 >> 8;
@@ -274,6 +276,121 @@ void MSTP_Create_And_Send_Frame(
     /* FIXME: be sure to reset SilenceTimer() after each octet is sent! */
 }
 
+/**
+ * @brief Determine if a station is known to accept extended frames
+ * @param mstp_port MSTP port context data
+ * @param station - MS/TP address of the station
+ * @return true if the station sent an extended frame, or an I-Am with a
+ *  Max-APDU that needs one
+ */
+bool MSTP_Extended_Frames_Accepted(
+    const struct mstp_port_struct_t *mstp_port, uint8_t station)
+{
+    if (!mstp_port) {
+        return false;
+    }
+
+    return (mstp_port->Extended_Frame_Stations[station / 8] &
+            (1 << (station % 8))) != 0;
+}
+
+/**
+ * @brief Determine if a station is known to not accept extended frames
+ * @param mstp_port MSTP port context data
+ * @param station - MS/TP address of the station
+ * @return true if the station sent an I-Am with a Max-APDU that fits
+ *  in a non-extended frame, and never sent an extended frame
+ */
+bool MSTP_Extended_Frames_Refused(
+    const struct mstp_port_struct_t *mstp_port, uint8_t station)
+{
+    if (!mstp_port) {
+        return false;
+    }
+
+    return (mstp_port->Legacy_Frame_Stations[station / 8] &
+            (1 << (station % 8))) != 0;
+}
+
+/**
+ * @brief Set whether a station accepts extended frames, such as from
+ *  the configuration of the port
+ * @param mstp_port MSTP port context data
+ * @param station - MS/TP address of the station
+ * @param accepted - true if the station accepts extended frames
+ */
+void MSTP_Extended_Frames_Set(
+    struct mstp_port_struct_t *mstp_port, uint8_t station, bool accepted)
+{
+    uint8_t mask = (uint8_t)(1 << (station % 8));
+
+    if (!mstp_port || (station == MSTP_BROADCAST_ADDRESS)) {
+        return;
+    }
+    if (accepted) {
+        mstp_port->Extended_Frame_Stations[station / 8] |= mask;
+        mstp_port->Legacy_Frame_Stations[station / 8] &= (uint8_t)~mask;
+    } else {
+        mstp_port->Legacy_Frame_Stations[station / 8] |= mask;
+        mstp_port->Extended_Frame_Stations[station / 8] &= (uint8_t)~mask;
+    }
+}
+
+/**
+ * @brief Learn whether the source of a good data frame accepts extended
+ *  frames. An extended frame shows that it does. A local I-Am shows it
+ *  with its Max-APDU, unless the station already sent an extended frame.
+ * @param mstp_port MSTP port context data
+ */
+static void MSTP_Extended_Frames_Learn(struct mstp_port_struct_t *mstp_port)
+{
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    BACNET_UNSIGNED_INTEGER max_apdu = 0;
+    uint32_t object_instance = 0;
+    const uint8_t *apdu;
+    uint16_t apdu_len;
+    int len;
+
+    if ((mstp_port->FrameType ==
+         FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY) ||
+        (mstp_port->FrameType ==
+         FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY)) {
+        MSTP_Extended_Frames_Set(mstp_port, mstp_port->SourceAddress, true);
+        return;
+    }
+    if ((mstp_port->FrameType != FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY) ||
+        (mstp_port->DataLength > mstp_port->InputBufferSize) ||
+        MSTP_Extended_Frames_Accepted(mstp_port, mstp_port->SourceAddress)) {
+        return;
+    }
+    len = bacnet_npdu_decode(
+        mstp_port->InputBuffer, mstp_port->DataLength, NULL, &src, &npdu_data);
+    if ((len <= 0) || npdu_data.network_layer_message || (src.net != 0) ||
+        ((len + 2) > mstp_port->DataLength)) {
+        return;
+    }
+    apdu = &mstp_port->InputBuffer[len];
+    apdu_len = mstp_port->DataLength - len;
+    if ((apdu[0] != PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) ||
+        (apdu[1] != SERVICE_UNCONFIRMED_I_AM)) {
+        return;
+    }
+    len = bacnet_object_id_application_decode(
+        &apdu[2], apdu_len - 2, &object_type, &object_instance);
+    if ((len <= 0) || (object_type != OBJECT_DEVICE)) {
+        return;
+    }
+    len = bacnet_unsigned_application_decode(
+        &apdu[2 + len], apdu_len - 2 - len, &max_apdu);
+    if (len > 0) {
+        MSTP_Extended_Frames_Set(
+            mstp_port, mstp_port->SourceAddress,
+            max_apdu > MSTP_FRAME_NPDU_MAX);
+    }
+}
+
 static bool MSTP_Frame_For_Us(struct mstp_port_struct_t *mstp_port)
 {
     if ((mstp_port->DestinationAddress == mstp_port->This_Station) ||
@@ -565,6 +682,7 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                             mstp_port->Index + 1);
                         if (mstp_port->DataLength > 0) {
                             /* GoodCRC */
+                            MSTP_Extended_Frames_Learn(mstp_port);
                             if (mstp_port->receive_state ==
                                 MSTP_RECEIVE_STATE_DATA) {
                                 /* ForUs */
@@ -584,6 +702,7 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                         /* STATE DATA CRC - no need for new state */
                         if (mstp_port->DataCRC == 0xF0B8) {
                             /* GoodCRC */
+                            MSTP_Extended_Frames_Learn(mstp_port);
                             if (mstp_port->receive_state ==
                                 MSTP_RECEIVE_STATE_DATA) {
                                 /* ForUs */
@@ -621,6 +740,201 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
     return;
 }
 
+/**
+ * @brief Run the receive state machine over a run of octets that arrived
+ *  without a gap between them, such as one DMA transfer that ended when
+ *  the line went idle, instead of one DataAvailable event per octet.
+ * @details The first octet is checked against Tframe_abort like any other
+ *  octet. The octets of the data field are then taken in one step, with
+ *  one CRC calculation and one silence timer reset. The port should keep
+ *  its silence timer from the idle-line timestamp of the run.
+ * @param mstp_port MSTP port context data
+ * @param buffer - octets received, in order
+ * @param length - number of octets in the buffer
+ * @return number of octets consumed, which is less than length when a
+ *  frame was received: the caller handles the ReceivedValidFrame,
+ *  ReceivedValidFrameNotForUs, or ReceivedInvalidFrame flag, and then
+ *  passes the remaining octets again.
+ */
+size_t MSTP_Receive_Frame_Block(
+    struct mstp_port_struct_t *mstp_port, const uint8_t *buffer, size_t length)
+{
+    size_t offset = 0;
+    size_t count, copy;
+
+    if (!mstp_port || !buffer) {
+        return 0;
+    }
+    while ((offset < length) && !mstp_port->ReceivedValidFrame &&
+           !mstp_port->ReceivedValidFrameNotForUs &&
+           !mstp_port->ReceivedInvalidFrame) {
+        if ((offset > 0) && !mstp_port->ReceiveError &&
+            ((mstp_port->receive_state == MSTP_RECEIVE_STATE_DATA) ||
+             (mstp_port->receive_state == MSTP_RECEIVE_STATE_SKIP_DATA)) &&
+            (mstp_port->Index < mstp_port->DataLength)) {
+            /* DataOctet - up to the CRC octets */
+            count = mstp_port->DataLength - mstp_port->Index;
+            if (count > (length - offset)) {
+                count = length - offset;
+            }
+            mstp_port->DataCRC =
+                CRC_Calc_Data_Block(&buffer[offset], count, mstp_port->DataCRC);
+            if (mstp_port->Index < mstp_port->InputBufferSize) {
+                copy = mstp_port->InputBufferSize - mstp_port->Index;
+                if (copy > count) {
+                    copy = count;
+                }
+                memcpy(
+                    &mstp_port->InputBuffer[mstp_port->Index], &buffer[offset],
+                    copy);
+            }
+            mstp_port->Index += count;
+            mstp_port->SilenceTimerReset((void *)mstp_port);
+            offset += count;
+        } else {
+            mstp_port->DataRegister = buffer[offset];
+            mstp_port->DataAvailable = true;
+            MSTP_Receive_Frame_FSM(mstp_port);
+            if (!mstp_port->DataAvailable) {
+                offset++;
+            }
+        }
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Get the number of information frames that this node may send
+ *  before it must pass the token, which is the value of its Max_Info_Frames
+ * @param mstp_port MSTP port context data
+ * @return Nmax_info_frames, or the number chosen by an adaptive node
+ */
+uint8_t MSTP_Max_Info_Frames(const struct mstp_port_struct_t *mstp_port)
+{
+    uint8_t value = 0;
+
+    if (!mstp_port) {
+        return 0;
+    }
+    value = mstp_port->Nmax_info_frames;
+    if (mstp_port->AdaptiveEnabled &&
+        (mstp_port->Adaptive_Max_Info_Frames > value) &&
+        (mstp_port->Adaptive_Info_Frames > value)) {
+        value = mstp_port->Adaptive_Info_Frames;
+        if (value > mstp_port->Adaptive_Max_Info_Frames) {
+            value = mstp_port->Adaptive_Max_Info_Frames;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * @brief Get the highest address that this node polls for a master node,
+ *  which is the value of its Max_Master
+ * @param mstp_port MSTP port context data
+ * @return Nmax_master, or the highest master node found by an adaptive node
+ */
+uint8_t MSTP_Max_Master(const struct mstp_port_struct_t *mstp_port)
+{
+    uint8_t value = 0;
+
+    if (!mstp_port) {
+        return 0;
+    }
+    value = mstp_port->Nmax_master;
+    if (mstp_port->AdaptiveEnabled && (mstp_port->Adaptive_Sweep_Count > 0) &&
+        (mstp_port->Adaptive_Max_Master < value) &&
+        (mstp_port->Adaptive_Max_Master >= mstp_port->This_Station)) {
+        value = mstp_port->Adaptive_Max_Master;
+    }
+
+    return value;
+}
+
+/**
+ * @brief An adaptive node learns the master nodes from the frames
+ *  that only a master node sends
+ * @param mstp_port MSTP port context data
+ */
+static void MSTP_Adaptive_Master_Seen(struct mstp_port_struct_t *mstp_port)
+{
+    uint8_t mac = mstp_port->SourceAddress;
+
+    switch (mstp_port->FrameType) {
+        case FRAME_TYPE_TOKEN:
+        case FRAME_TYPE_POLL_FOR_MASTER:
+        case FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER:
+            if (mac > Nmax_master_station) {
+                break;
+            }
+            if (mac > mstp_port->Adaptive_Max_Master_Seen) {
+                mstp_port->Adaptive_Max_Master_Seen = mac;
+            }
+            if (mac > mstp_port->Adaptive_Max_Master) {
+                mstp_port->Adaptive_Max_Master = mac;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief An adaptive node finished a Poll For Master sweep. After a sweep
+ *  up to Nmax_master, the next sweeps stop at the highest master node
+ *  seen since the sweep before it.
+ * @param mstp_port MSTP port context data
+ */
+static void MSTP_Adaptive_Sweep_Done(struct mstp_port_struct_t *mstp_port)
+{
+    if (!mstp_port->AdaptiveEnabled) {
+        return;
+    }
+    if (mstp_port->Adaptive_Sweep_Count > 0) {
+        mstp_port->Adaptive_Sweep_Count--;
+    } else {
+        mstp_port->Adaptive_Max_Master = mstp_port->Adaptive_Max_Master_Seen;
+        if (mstp_port->Adaptive_Max_Master < mstp_port->This_Station) {
+            mstp_port->Adaptive_Max_Master = mstp_port->This_Station;
+        }
+        mstp_port->Adaptive_Max_Master_Seen = mstp_port->This_Station;
+        mstp_port->Adaptive_Sweep_Count = MSTP_ADAPTIVE_SWEEPS;
+    }
+}
+
+/**
+ * @brief An adaptive node passes the token. It sends one more information
+ *  frame in its next tokens when it sent all of them, and one less after
+ *  MSTP_ADAPTIVE_IDLE_TOKENS tokens in which its transmit queue emptied.
+ * @param mstp_port MSTP port context data
+ * @param full true if the node sent all of its information frames
+ */
+static void
+MSTP_Adaptive_Token_Done(struct mstp_port_struct_t *mstp_port, bool full)
+{
+    uint8_t info_frames;
+
+    mstp_port->Adaptive_Token_Full = false;
+    if (!mstp_port->AdaptiveEnabled) {
+        return;
+    }
+    info_frames = MSTP_Max_Info_Frames(mstp_port);
+    if (full) {
+        mstp_port->Adaptive_Idle_Tokens = 0;
+        if (info_frames < mstp_port->Adaptive_Max_Info_Frames) {
+            mstp_port->Adaptive_Info_Frames = info_frames + 1;
+        }
+    } else if (info_frames > mstp_port->Nmax_info_frames) {
+        mstp_port->Adaptive_Idle_Tokens++;
+        if (mstp_port->Adaptive_Idle_Tokens >= MSTP_ADAPTIVE_IDLE_TOKENS) {
+            mstp_port->Adaptive_Idle_Tokens = 0;
+            mstp_port->Adaptive_Info_Frames = info_frames - 1;
+        }
+    }
+}
+
 /**
  * @brief Finite State Machine for receiving an MSTP frame
  * @param mstp_port MSTP port context data
@@ -632,18 +946,23 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
     uint8_t next_poll_station = 0;
     uint8_t next_this_station = 0;
     uint8_t next_next_station = 0;
+    uint8_t info_frames = 0, max_master = 0;
     uint16_t my_timeout = 10, ns_timeout = 0, mm_timeout = 0;
     /* transition immediately to the next state */
     bool transition_now = false;
     MSTP_MASTER_STATE master_state = mstp_port->master_state;
 
+    if (mstp_port->AdaptiveEnabled &&
+        ((mstp_port->ReceivedValidFrame == true) ||
+         (mstp_port->ReceivedValidFrameNotForUs == true))) {
+        MSTP_Adaptive_Master_Seen(mstp_port);
+    }
     /* some calculations that several states need */
-    next_poll_station =
-        (mstp_port->Poll_Station + 1) % (mstp_port->Nmax_master + 1);
-    next_this_station =
-        (mstp_port->This_Station + 1) % (mstp_port->Nmax_master + 1);
-    next_next_station =
-        (mstp_port->Next_Station + 1) % (mstp_port->Nmax_master + 1);
+    info_frames = MSTP_Max_Info_Frames(mstp_port);
+    max_master = MSTP_Max_Master(mstp_port);
+    next_poll_station = (mstp_port->Poll_Station + 1) % (max_master + 1);
+    next_this_station = (mstp_port->This_Station + 1) % (max_master + 1);
+    next_next_station = (mstp_port->Next_Station + 1) % (max_master + 1);
     /* The zero config checks before running FSM */
     if ((mstp_port->ZeroConfigEnabled) &&
         (mstp_port->master_state != MSTP_MASTER_STATE_INITIALIZE) &&
@@ -726,6 +1045,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                         mstp_port->ReceivedValidFrame = false;
                         mstp_port->FrameCount = 0;
                         mstp_port->SoleMaster = false;
+                        PERFSTAT_MSTP_TOKEN_RECEIVED();
                         mstp_port->master_state = MSTP_MASTER_STATE_USE_TOKEN;
                         transition_now = true;
                         break;
@@ -810,7 +1130,8 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
             length = (unsigned)MSTP_Get_Send(mstp_port, 0);
             if (length < 1) {
                 /* NothingToSend */
-                mstp_port->FrameCount = mstp_port->Nmax_info_frames;
+                MSTP_Adaptive_Token_Done(mstp_port, false);
+                mstp_port->FrameCount = info_frames;
                 mstp_port->master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
                 transition_now = true;
             } else {
@@ -819,6 +1140,9 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 MSTP_Send_Frame(
                     mstp_port, &mstp_port->OutputBuffer[0], (uint16_t)length);
                 mstp_port->FrameCount++;
+                if (mstp_port->FrameCount >= info_frames) {
+                    mstp_port->Adaptive_Token_Full = true;
+                }
                 switch (frame_type) {
                     case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
                         if (destination == MSTP_BROADCAST_ADDRESS) {
@@ -851,7 +1175,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 mstp_port->Treply_timeout) {
                 /* ReplyTimeout */
                 /* assume that the request has failed */
-                mstp_port->FrameCount = mstp_port->Nmax_info_frames;
+                mstp_port->FrameCount = info_frames;
                 mstp_port->master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
                 /* Any retry of the data frame shall await the next entry */
                 /* to the USE_TOKEN state. (Because of the length of the
@@ -918,8 +1242,14 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
         case MSTP_MASTER_STATE_DONE_WITH_TOKEN:
             /* The DONE_WITH_TOKEN state either sends another data frame,  */
             /* passes the token, or initiates a Poll For Master cycle. */
+            if ((mstp_port->FrameCount >= info_frames) &&
+                mstp_port->Adaptive_Token_Full) {
+                /* the transmit queue kept this node busy for every
+                   information frame that it may send */
+                MSTP_Adaptive_Token_Done(mstp_port, true);
+            }
             /* SendAnotherFrame */
-            if (mstp_port->FrameCount < mstp_port->Nmax_info_frames) {
+            if (mstp_port->FrameCount < info_frames) {
                 /* then this node may send another information frame  */
                 /* before passing the token.  */
                 mstp_port->master_state = MSTP_MASTER_STATE_USE_TOKEN;
@@ -967,6 +1297,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                     mstp_port->master_state = MSTP_MASTER_STATE_PASS_TOKEN;
                 }
             } else if (next_poll_station == mstp_port->Next_Station) {
+                MSTP_Adaptive_Sweep_Done(mstp_port);
                 if (mstp_port->SoleMaster == true) {
                     /* SoleMasterRestartMaintenancePFM */
                     mstp_port->Poll_Station = next_next_station;
@@ -1179,6 +1510,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                             /* DeclareSoleMaster */
                             /* to indicate that this station is the only master
                              */
+                            MSTP_Adaptive_Sweep_Done(mstp_port);
                             mstp_port->SoleMaster = true;
                             mstp_port->FrameCount = 0;
                             mstp_port->master_state =
@@ -1416,6 +1748,68 @@ unsigned MSTP_Zero_Config_Station_Increment(unsigned station)
     return next_station;
 }
 
+/**
+ * @brief Determine if an accelerated zero config node saw a station in use
+ * @param mstp_port the context of the MSTP port
+ * @param station the station address
+ * @return true if a frame was seen from the station
+ */
+static bool MSTP_Zero_Config_Station_Used(
+    const struct mstp_port_struct_t *mstp_port, unsigned station)
+{
+    if (station > Nmax_master_station) {
+        return false;
+    }
+
+    return (mstp_port->Zero_Config_Stations_Used[station / 8] &
+            (1 << (station % 8))) != 0;
+}
+
+/**
+ * @brief An accelerated zero config node learns the stations in use
+ *  from the source of every valid frame, including those not for us
+ * @param mstp_port the context of the MSTP port
+ */
+static void MSTP_Zero_Config_Station_Seen(struct mstp_port_struct_t *mstp_port)
+{
+    uint8_t station = mstp_port->SourceAddress;
+
+    if ((mstp_port->ReceivedValidFrame ||
+         mstp_port->ReceivedValidFrameNotForUs) &&
+        (station <= Nmax_master_station)) {
+        mstp_port->Zero_Config_Stations_Used[station / 8] |=
+            (uint8_t)(1 << (station % 8));
+    }
+}
+
+/**
+ * @brief Choose the next Zero Configuration Station address to monitor.
+ *  An accelerated node skips the addresses that it has seen in use,
+ *  unless all of them are in use.
+ * @param mstp_port the context of the MSTP port
+ * @return the next station address
+ */
+static uint8_t MSTP_Zero_Config_Station_Next(
+    const struct mstp_port_struct_t *mstp_port)
+{
+    unsigned station, i;
+
+    station =
+        MSTP_Zero_Config_Station_Increment(mstp_port->Zero_Config_Station);
+    if (!mstp_port->ZeroConfigAccelerated) {
+        return (uint8_t)station;
+    }
+    for (i = Nmin_poll_station; i <= Nmax_poll_station; i++) {
+        if (!MSTP_Zero_Config_Station_Used(mstp_port, station)) {
+            return (uint8_t)station;
+        }
+        station = MSTP_Zero_Config_Station_Increment(station);
+    }
+
+    return (uint8_t)MSTP_Zero_Config_Station_Increment(
+        mstp_port->Zero_Config_Station);
+}
+
 /**
  * @brief The ZERO_CONFIGURATION_INIT state is entered when
  *  ZeroConfigurationMode is TRUE
@@ -1423,7 +1817,8 @@ unsigned MSTP_Zero_Config_Station_Increment(unsigned station)
  */
 static void MSTP_Zero_Config_State_Init(struct mstp_port_struct_t *mstp_port)
 {
-    uint32_t slots;
+    uint32_t slots, uuid_hash;
+    unsigned i;
 
     if (!mstp_port) {
         return;
@@ -1436,6 +1831,22 @@ static void MSTP_Zero_Config_State_Init(struct mstp_port_struct_t *mstp_port)
     }
     mstp_port->Zero_Config_Station = mstp_port->Zero_Config_Preferred_Station;
     mstp_port->Npoll_slot = 1 + (mstp_port->UUID[0] % Nmax_poll_slot);
+    if (mstp_port->ZeroConfigAccelerated) {
+        /* many nodes that power up together start at different
+           addresses, so that they look for free addresses in parallel
+           instead of all of them after the others */
+        memset(
+            mstp_port->Zero_Config_Stations_Used, 0,
+            sizeof(mstp_port->Zero_Config_Stations_Used));
+        uuid_hash = 0;
+        for (i = 0; i < MSTP_UUID_SIZE; i++) {
+            uuid_hash = (uuid_hash * 31) + mstp_port->UUID[i];
+        }
+        mstp_port->Zero_Config_Station = Nmin_poll_station +
+            (uuid_hash % ((Nmax_poll_station - Nmin_poll_station) + 1));
+        mstp_port->Npoll_slot =
+            1 + (mstp_port->UUID[0] % Nmax_poll_slot_accelerated);
+    }
     /* basic silence timeout is the dropped token time plus
         one Tslot after the last master node. Add one Tslot of
         silence timeout per zero config priority slot */
@@ -1511,11 +1922,14 @@ static void MSTP_Zero_Config_State_Lurk(struct mstp_port_struct_t *mstp_port)
                 mstp_port->Zero_Config_Max_Master = dst;
             }
         }
-        if (src == mstp_port->Zero_Config_Station) {
+        if ((src == mstp_port->Zero_Config_Station) ||
+            (mstp_port->ZeroConfigAccelerated &&
+             MSTP_Zero_Config_Station_Used(
+                 mstp_port, mstp_port->Zero_Config_Station))) {
             /* LurkAddressInUse */
             /* monitor PFM from the next address */
-            mstp_port->Zero_Config_Station = MSTP_Zero_Config_Station_Increment(
-                mstp_port->Zero_Config_Station);
+            mstp_port->Zero_Config_Station =
+                MSTP_Zero_Config_Station_Next(mstp_port);
             mstp_port->Poll_Count = 0;
         } else if (
             (frame == FRAME_TYPE_POLL_FOR_MASTER) &&
@@ -1570,8 +1984,8 @@ static void MSTP_Zero_Config_State_Claim(struct mstp_port_struct_t *mstp_port)
         if (src == mstp_port->Zero_Config_Station) {
             /* ClaimAddressInUse */
             /* monitor PFM from the next address */
-            mstp_port->Zero_Config_Station = MSTP_Zero_Config_Station_Increment(
-                mstp_port->Zero_Config_Station);
+            mstp_port->Zero_Config_Station =
+                MSTP_Zero_Config_Station_Next(mstp_port);
             mstp_port->Poll_Count = 0;
             mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_LURK;
         } else if (frame == FRAME_TYPE_TOKEN) {
@@ -1643,8 +2057,8 @@ static void MSTP_Zero_Config_State_Confirm(struct mstp_port_struct_t *mstp_port)
         } else if (src == mstp_port->Zero_Config_Station) {
             /* ConfirmationAddressInUse */
             /* monitor PFM from the next address */
-            mstp_port->Zero_Config_Station = MSTP_Zero_Config_Station_Increment(
-                mstp_port->Zero_Config_Station);
+            mstp_port->Zero_Config_Station =
+                MSTP_Zero_Config_Station_Next(mstp_port);
             mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_LURK;
         }
     } else if (mstp_port->ReceivedInvalidFrame) {
@@ -1676,6 +2090,11 @@ void MSTP_Zero_Config_FSM(struct mstp_port_struct_t *mstp_port)
     if (!mstp_port->ZeroConfigEnabled) {
         return;
     }
+    if (mstp_port->ZeroConfigAccelerated &&
+        (mstp_port->Zero_Config_State != MSTP_ZERO_CONFIG_STATE_INIT) &&
+        (mstp_port->Zero_Config_State != MSTP_ZERO_CONFIG_STATE_USE)) {
+        MSTP_Zero_Config_Station_Seen(mstp_port);
+    }
     switch (mstp_port->Zero_Config_State) {
         case MSTP_ZERO_CONFIG_STATE_INIT:
             MSTP_Zero_Config_State_Init(mstp_port);
@@ -1699,6 +2118,11 @@ void MSTP_Zero_Config_FSM(struct mstp_port_struct_t *mstp_port)
     }
 }
 
+/* the baud rates that the auto-baud tries, in order */
+static const uint32_t TestBaudrates[6] = {
+    115200, 76800, 57600, 38400, 19200, 9600
+};
+
 /**
  * @brief Get the baud rate for auto-baud at a given index
  * @param baud_rate_index the index of the baud rate
@@ -1708,9 +2132,6 @@ void MSTP_Zero_Config_FSM(struct mstp_port_struct_t *mstp_port)
  */
 uint32_t MSTP_Auto_Baud_Rate(unsigned baud_rate_index)
 {
-    const uint32_t TestBaudrates[6] = {
-        115200, 76800, 57600, 38400, 19200, 9600
-    };
     unsigned index;
 
     index = baud_rate_index % ARRAY_SIZE(TestBaudrates);
@@ -1718,6 +2139,68 @@ uint32_t MSTP_Auto_Baud_Rate(unsigned baud_rate_index)
     return TestBaudrates[index];
 }
 
+/**
+ * @brief Get the index of the auto-baud rate with the bit time that
+ *  is nearest to a measured bit time
+ * @param bit_time the shortest time between two edges, in nanoseconds
+ * @return the index of the baud rate
+ */
+unsigned MSTP_Auto_Baud_Rate_Index(uint32_t bit_time)
+{
+    uint32_t rate_bit_time, difference, nearest = UINT32_MAX;
+    unsigned i, index = 0;
+
+    for (i = 0; i < ARRAY_SIZE(TestBaudrates); i++) {
+        rate_bit_time = 1000000000UL / TestBaudrates[i];
+        if (bit_time > rate_bit_time) {
+            difference = bit_time - rate_bit_time;
+        } else {
+            difference = rate_bit_time - bit_time;
+        }
+        if (difference < nearest) {
+            nearest = difference;
+            index = i;
+        }
+    }
+
+    return index;
+}
+
+/**
+ * @brief The port reports the time between two edges of the received
+ *  signal, such as from a timer input capture. The shortest time is kept,
+ *  since it is one bit time once a start bit or a lone bit was seen.
+ * @param mstp_port the context of the MSTP port
+ * @param bit_time the time between two edges, in nanoseconds,
+ *  or zero to forget the measurement
+ */
+void MSTP_Auto_Baud_Bit_Time_Set(
+    struct mstp_port_struct_t *mstp_port, uint32_t bit_time)
+{
+    if (!mstp_port) {
+        return;
+    }
+    if ((bit_time == 0) || (mstp_port->Auto_Baud_Bit_Time == 0) ||
+        (bit_time < mstp_port->Auto_Baud_Bit_Time)) {
+        mstp_port->Auto_Baud_Bit_Time = bit_time;
+    }
+}
+
+/**
+ * @brief Change the trial baud rate of the auto-baud
+ * @param mstp_port the context of the MSTP port
+ * @param baud_rate_index the index of the baud rate
+ */
+static void MSTP_Auto_Baud_Rate_Try(
+    struct mstp_port_struct_t *mstp_port, unsigned baud_rate_index)
+{
+    mstp_port->BaudRateIndex = baud_rate_index;
+    mstp_port->BaudRateSet(MSTP_Auto_Baud_Rate(baud_rate_index));
+    mstp_port->ValidFrames = 0;
+    mstp_port->Auto_Baud_Invalid_Frames = 0;
+    mstp_port->ValidFrameTimerReset((void *)mstp_port);
+}
+
 /**
  * @brief The MSTP_AUTO_BAUD_STATE_INIT state is entered when
  *  CheckAutoBaud is TRUE
@@ -1732,6 +2215,12 @@ static void MSTP_Auto_Baud_State_Init(struct mstp_port_struct_t *mstp_port)
     }
     mstp_port->ValidFrames = 0;
     mstp_port->BaudRateIndex = 0;
+    if (mstp_port->AutoBaudFast && mstp_port->Auto_Baud_Bit_Time) {
+        /* MeasuredBaudRate */
+        mstp_port->BaudRateIndex =
+            MSTP_Auto_Baud_Rate_Index(mstp_port->Auto_Baud_Bit_Time);
+    }
+    mstp_port->Auto_Baud_Invalid_Frames = 0;
     mstp_port->ValidFrameTimerReset((void *)mstp_port);
     baud = MSTP_Auto_Baud_Rate(mstp_port->BaudRateIndex);
     mstp_port->BaudRateSet(baud);
@@ -1745,15 +2234,13 @@ static void MSTP_Auto_Baud_State_Init(struct mstp_port_struct_t *mstp_port)
  */
 static void MSTP_Auto_Baud_State_Idle(struct mstp_port_struct_t *mstp_port)
 {
-    uint32_t baud;
-
     if (!mstp_port) {
         return;
     }
     if (mstp_port->ReceivedValidFrame) {
         /* IdleValidFrame */
         mstp_port->ValidFrames++;
-        if (mstp_port->ValidFrames >= 4) {
+        if ((mstp_port->ValidFrames >= 4) || mstp_port->AutoBaudFast) {
             /* GoodBaudRate */
             mstp_port->CheckAutoBaud = false;
             mstp_port->Auto_Baud_State = MSTP_AUTO_BAUD_STATE_USE;
@@ -1763,13 +2250,27 @@ static void MSTP_Auto_Baud_State_Idle(struct mstp_port_struct_t *mstp_port)
         /* IdleInvalidFrame */
         mstp_port->ValidFrames = 0;
         mstp_port->ReceivedInvalidFrame = false;
+        if (mstp_port->AutoBaudFast) {
+            mstp_port->Auto_Baud_Invalid_Frames++;
+            if (mstp_port->Auto_Baud_Invalid_Frames >=
+                Nmax_auto_baud_invalid_frames) {
+                /* BadBaudRate: the measurement was wrong, or noise */
+                mstp_port->Auto_Baud_Bit_Time = 0;
+                MSTP_Auto_Baud_Rate_Try(
+                    mstp_port, mstp_port->BaudRateIndex + 1);
+            }
+        }
+    } else if (
+        mstp_port->AutoBaudFast && mstp_port->Auto_Baud_Bit_Time &&
+        (MSTP_Auto_Baud_Rate_Index(mstp_port->Auto_Baud_Bit_Time) !=
+         (mstp_port->BaudRateIndex % ARRAY_SIZE(TestBaudrates)))) {
+        /* MeasuredBaudRate */
+        MSTP_Auto_Baud_Rate_Try(
+            mstp_port,
+            MSTP_Auto_Baud_Rate_Index(mstp_port->Auto_Baud_Bit_Time));
     } else if (mstp_port->ValidFrameTimer((void *)mstp_port) >= 5000UL) {
         /* IdleTimeout */
-        mstp_port->BaudRateIndex++;
-        baud = MSTP_Auto_Baud_Rate(mstp_port->BaudRateIndex);
-        mstp_port->BaudRateSet(baud);
-        mstp_port->ValidFrames = 0;
-        mstp_port->ValidFrameTimerReset((void *)mstp_port);
+        MSTP_Auto_Baud_Rate_Try(mstp_port, mstp_port->BaudRateIndex + 1);
     }
 }
 
@@ -1867,6 +2368,20 @@ void MSTP_Init(struct mstp_port_struct_t *mstp_port)
         mstp_port->SoleMaster = false;
         mstp_port->SourceAddress = 0;
         mstp_port->TokenCount = 0;
+        /* adaptive Max_Info_Frames and Max_Master */
+        mstp_port->Adaptive_Token_Full = false;
+        mstp_port->Adaptive_Info_Frames = mstp_port->Nmax_info_frames;
+        mstp_port->Adaptive_Idle_Tokens = 0;
+        mstp_port->Adaptive_Max_Master = mstp_port->Nmax_master;
+        mstp_port->Adaptive_Max_Master_Seen = mstp_port->This_Station;
+        mstp_port->Adaptive_Sweep_Count = 0;
+        /* extended frames are learned again */
+        memset(
+            mstp_port->Extended_Frame_Stations, 0,
+            sizeof(mstp_port->Extended_Frame_Stations));
+        memset(
+            mstp_port->Legacy_Frame_Stations, 0,
+            sizeof(mstp_port->Legacy_Frame_Stations));
         /* zero config */
         mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_INIT;
     }
@@ -58,6 +58,10 @@ struct mstp_port_struct_t {
     unsigned SlaveNodeEnabled : 1;
     /* A Boolean flag set to TRUE if this node is using a ZeroConfig address */
     unsigned ZeroConfigEnabled : 1;
+    /* A Boolean flag set to TRUE if a ZeroConfig node starts at an
+       address chosen from its UUID, skips the addresses that it has
+       seen in use, and claims an address after fewer polls */
+    unsigned ZeroConfigAccelerated : 1;
     /* stores the latest received data */
     uint8_t DataRegister;
     /* Used to accumulate the CRC on the data field of a frame. */
@@ -157,6 +161,39 @@ struct mstp_port_struct_t {
        its value shall be 127. */
     uint8_t Nmax_master;
 
+    /* A Boolean flag set to TRUE if this node adapts the number of
+       information frames that it sends to its transmit queue, and its
+       Poll For Master sweeps to the highest master node on the network.
+       Nmax_info_frames and Nmax_master are then the lowest and the highest
+       values that the node may choose. */
+    unsigned AdaptiveEnabled : 1;
+    /* A Boolean flag set to TRUE by the master machine if an adaptive
+       node sent all of its information frames while it held the token. */
+    unsigned Adaptive_Token_Full : 1;
+    /* The highest number of information frames that an adaptive node may
+       send before it must pass the token. Zero or a value below
+       Nmax_info_frames disables the raising of the information frames. */
+    uint8_t Adaptive_Max_Info_Frames;
+    /* The number of information frames chosen by an adaptive node */
+    uint8_t Adaptive_Info_Frames;
+    /* The number of tokens that an adaptive node used without sending
+       all of its information frames */
+    uint8_t Adaptive_Idle_Tokens;
+    /* The highest master node address found by the last sweep up to
+       Nmax_master, and the highest one seen since that sweep */
+    uint8_t Adaptive_Max_Master;
+    uint8_t Adaptive_Max_Master_Seen;
+    /* The number of Poll For Master sweeps left that stop at
+       Adaptive_Max_Master. Zero means the sweep goes up to Nmax_master. */
+    uint8_t Adaptive_Sweep_Count;
+    /* One bit per station address: the stations that sent an extended
+       (COBS) data frame, or an I-Am with a Max-APDU above the largest
+       non-extended frame, and the stations that sent an I-Am with a
+       Max-APDU that fits a non-extended frame. A station in neither
+       is unknown. */
+    uint8_t Extended_Frame_Stations[32];
+    uint8_t Legacy_Frame_Stations[32];
+
     /* An array of octets, used to store octets for transmitting
        OutputBuffer is indexed from 0 to OutputBufferSize-1.
        FIXME: assign this to an actual array of bytes!
@@ -187,6 +224,9 @@ struct mstp_port_struct_t {
        The value of this parameter shall be less than or equal to 127.
        In the absence of other fixed address nodes, this value shall be 127. */
     uint8_t Zero_Config_Max_Master;
+    /* One bit per station address: the stations seen sending a frame
+       while an accelerated ZeroConfig node looks for its address */
+    uint8_t Zero_Config_Stations_Used[16];
 
     /* The minimum time without a DataAvailable or ReceiveError event within
        a frame before a receiving node may discard the frame: 60 bit times.
@@ -237,6 +277,16 @@ struct mstp_port_struct_t {
     void (*BaudRateSet)(uint32_t baud);
     /* The zero-based index in TestBaudrates of the next baudrate to try. */
     unsigned BaudRateIndex;
+    /* A Boolean flag set to TRUE if the baud rate is chosen from the bit
+       time measured by the port, a baud rate is used after one valid
+       header, and a baud rate with invalid frames is left at once */
+    unsigned AutoBaudFast : 1;
+    /* The shortest time between two edges of the received signal, in
+       nanoseconds, measured by the port with an edge capture. Zero if
+       not measured. */
+    uint32_t Auto_Baud_Bit_Time;
+    /* The number of invalid frames at the current trial baudrate */
+    uint8_t Auto_Baud_Invalid_Frames;
 
     /*Platform-specific port data */
     void *UserData;
@@ -251,6 +301,9 @@ void MSTP_Init(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
 void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
+size_t MSTP_Receive_Frame_Block(
+    struct mstp_port_struct_t *mstp_port, const uint8_t *buffer, size_t length);
+BACNET_STACK_EXPORT
 bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
 void MSTP_Slave_Node_FSM(struct mstp_port_struct_t *mstp_port);
@@ -278,6 +331,21 @@ void MSTP_Create_And_Send_Frame(
     const uint8_t *data,
     uint16_t data_len);
 
+BACNET_STACK_EXPORT
+uint8_t MSTP_Max_Info_Frames(const struct mstp_port_struct_t *mstp_port);
+BACNET_STACK_EXPORT
+uint8_t MSTP_Max_Master(const struct mstp_port_struct_t *mstp_port);
+
+BACNET_STACK_EXPORT
+bool MSTP_Extended_Frames_Accepted(
+    const struct mstp_port_struct_t *mstp_port, uint8_t station);
+BACNET_STACK_EXPORT
+bool MSTP_Extended_Frames_Refused(
+    const struct mstp_port_struct_t *mstp_port, uint8_t station);
+BACNET_STACK_EXPORT
+void MSTP_Extended_Frames_Set(
+    struct mstp_port_struct_t *mstp_port, uint8_t station, bool accepted);
+
 BACNET_STACK_EXPORT
 void MSTP_Fill_BACnet_Address(BACNET_ADDRESS *src, uint8_t mstp_address);
 
@@ -293,6 +361,12 @@ void MSTP_Zero_Config_FSM(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
 uint32_t MSTP_Auto_Baud_Rate(unsigned baud_rate_index);
 
+BACNET_STACK_EXPORT
+unsigned MSTP_Auto_Baud_Rate_Index(uint32_t bit_time);
+BACNET_STACK_EXPORT
+void MSTP_Auto_Baud_Bit_Time_Set(
+    struct mstp_port_struct_t *mstp_port, uint32_t bit_time);
+
 BACNET_STACK_EXPORT
 void MSTP_Auto_Baud_FSM(struct mstp_port_struct_t *mstp_port);
 
@@ -97,6 +97,12 @@ typedef enum MSTP_Auto_Baud_State {
     MSTP_AUTO_BAUD_STATE_USE = 2
 } MSTP_AUTO_BAUD_STATE;
 
+/* The number of invalid frames at a trial baud rate before a fast
+   auto-baud node tries the next one */
+#ifndef Nmax_auto_baud_invalid_frames
+#define Nmax_auto_baud_invalid_frames 4
+#endif
+
 /* The time without a DataAvailable or ReceiveError event before declaration */
 /* of loss of token: 500 milliseconds. */
 #define Tno_token 500
@@ -130,6 +136,12 @@ typedef enum MSTP_Auto_Baud_State {
 /* The number of zero-config station poll slots: 64 */
 #define Nmax_poll_slot 64
 
+/* The number of zero-config station poll slots when the acquisition is
+   accelerated, since the nodes start at addresses spread by their UUID */
+#ifndef Nmax_poll_slot_accelerated
+#define Nmax_poll_slot_accelerated 8
+#endif
+
 /* The last master node address: 127 */
 #define Nmax_master_station 127
 
@@ -167,6 +179,18 @@ typedef enum MSTP_Auto_Baud_State {
 #define DEFAULT_MAX_MASTER 127
 #define DEFAULT_MAC_ADDRESS 127
 
+/* The number of Poll For Master sweeps of an adaptive node that stop at */
+/* the highest master node found, before a sweep up to Max_Master. */
+#ifndef MSTP_ADAPTIVE_SWEEPS
+#define MSTP_ADAPTIVE_SWEEPS 10
+#endif
+
+/* The number of tokens that an adaptive node uses without sending all of */
+/* its information frames before it sends one frame less. */
+#ifndef MSTP_ADAPTIVE_IDLE_TOKENS
+#define MSTP_ADAPTIVE_IDLE_TOKENS Npoll
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -0,0 +1,420 @@
+/**
+ * @file
+ * @brief MS/TP trunk analyzer
+ *
+ * The frames seen on an MS/TP trunk are counted as they arrive, in a
+ * sample of the current interval and in a record for each MAC address,
+ * so that a capture of any length is analyzed in a fixed amount of
+ * memory.  The token rotation is the time between a node getting the
+ * token and getting it again.  The Poll For Master overhead is the time
+ * from each Poll For Master to the next frame, which is either the reply
+ * or the wait for the reply of an absent station.  The utilization is
+ * the share of the bit times of the baud rate taken by the frames.
+ *
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DLMSTP
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/datalink/mstpstat.h"
+
+/* the limit of the microsecond timer differences */
+#define MSTPSTAT_INTERVAL_MAX_MS 3600000UL
+
+/**
+ * @brief Start the analysis, and the first sample, with the first frame
+ * @param ms - analyzer
+ * @param time_us - time of the frame
+ */
+static void mstpstat_start(MSTPSTAT *ms, uint32_t time_us)
+{
+    if (!ms->started) {
+        ms->started = true;
+        ms->sample_start_us = time_us;
+    }
+}
+
+/**
+ * @brief Add a token rotation time to a sample
+ * @param sample - the sample
+ * @param rotation_us - time between two tokens received by a node
+ */
+static void mstpstat_rotation(MSTPSTAT_SAMPLE *sample, uint32_t rotation_us)
+{
+    if ((sample->rotation_count == 0) ||
+        (rotation_us < sample->rotation_min_us)) {
+        sample->rotation_min_us = rotation_us;
+    }
+    if (rotation_us > sample->rotation_max_us) {
+        sample->rotation_max_us = rotation_us;
+    }
+    sample->rotation_sum_us += rotation_us;
+    sample->rotation_count++;
+}
+
+/**
+ * @brief Count a frame that a node sends while it holds the token
+ * @param node - the node
+ */
+static void mstpstat_token_frame(MSTPSTAT_NODE *node)
+{
+    if (node->token_held && (node->token_frames < UINT8_MAX)) {
+        node->token_frames++;
+    }
+}
+
+/**
+ * @brief End the token of a node when it passes the token
+ * @param node - the node
+ * @param time_us - time of the token frame
+ */
+static void mstpstat_token_end(MSTPSTAT_NODE *node, uint32_t time_us)
+{
+    if (!node->token_held) {
+        return;
+    }
+    node->token_held = false;
+    node->token_time_us += time_us - node->token_start_us;
+    if (node->token_frames > 0) {
+        node->data_tokens++;
+        if (node->token_frames > node->max_info_frames) {
+            node->max_info_frames = node->token_frames;
+            node->full_tokens = 0;
+        }
+        if (node->token_frames == node->max_info_frames) {
+            node->full_tokens++;
+        }
+    }
+}
+
+/**
+ * @brief Add a sample to another one
+ * @param total - the sample that is added to
+ * @param sample - the sample to add
+ */
+static void
+mstpstat_sample_add(MSTPSTAT_SAMPLE *total, const MSTPSTAT_SAMPLE *sample)
+{
+    total->duration_us += sample->duration_us;
+    total->frames += sample->frames;
+    total->invalid_frames += sample->invalid_frames;
+    total->octets += sample->octets;
+    total->tokens += sample->tokens;
+    total->token_retries += sample->token_retries;
+    total->pfm += sample->pfm;
+    total->pfm_time_us += sample->pfm_time_us;
+    total->der += sample->der;
+    total->reply_postponed += sample->reply_postponed;
+    if (sample->rotation_count > 0) {
+        if ((total->rotation_count == 0) ||
+            (sample->rotation_min_us < total->rotation_min_us)) {
+            total->rotation_min_us = sample->rotation_min_us;
+        }
+        if (sample->rotation_max_us > total->rotation_max_us) {
+            total->rotation_max_us = sample->rotation_max_us;
+        }
+        total->rotation_sum_us += sample->rotation_sum_us;
+        total->rotation_count += sample->rotation_count;
+    }
+}
+
+/**
+ * @brief Initialize the analyzer
+ * @param ms - analyzer
+ * @param interval_ms - length of a sample, up to an hour, or zero for
+ *  a single sample
+ */
+void mstpstat_init(MSTPSTAT *ms, uint32_t interval_ms)
+{
+    if (!ms) {
+        return;
+    }
+    memset(ms, 0, sizeof(MSTPSTAT));
+    if (interval_ms > MSTPSTAT_INTERVAL_MAX_MS) {
+        interval_ms = MSTPSTAT_INTERVAL_MAX_MS;
+    }
+    ms->interval_us = interval_ms * 1000UL;
+    ms->last_frame_type = FRAME_TYPE_PROPRIETARY_MAX;
+}
+
+/**
+ * @brief Analyze a valid frame
+ * @param ms - analyzer
+ * @param time_us - free running time of the frame in microseconds
+ * @param frame_type - MS/TP frame type
+ * @param dst - destination MAC address
+ * @param src - source MAC address
+ * @param data_len - number of data octets of the frame
+ */
+void mstpstat_frame(
+    MSTPSTAT *ms,
+    uint32_t time_us,
+    uint8_t frame_type,
+    uint8_t dst,
+    uint8_t src,
+    uint16_t data_len)
+{
+    MSTPSTAT_NODE *node, *dst_node;
+    uint32_t octets, delta;
+
+    if (!ms) {
+        return;
+    }
+    mstpstat_start(ms, time_us);
+    octets = MSTPSTAT_HEADER_OCTETS;
+    if (data_len > 0) {
+        /* data and data CRC */
+        octets += (uint32_t)data_len + 2U;
+    }
+    ms->sample.frames++;
+    ms->sample.octets += octets;
+    node = &ms->node[src];
+    dst_node = &ms->node[dst];
+    node->frames++;
+    node->octets += octets;
+    if (ms->last_frame_type == FRAME_TYPE_POLL_FOR_MASTER) {
+        delta = time_us - ms->last_time_us;
+        ms->sample.pfm_time_us += delta;
+        if ((frame_type != FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER) &&
+            (src == ms->last_src) && (delta > node->tusage_max_us)) {
+            /* the polled station did not reply */
+            node->tusage_max_us = delta;
+        }
+    }
+    switch (frame_type) {
+        case FRAME_TYPE_TOKEN:
+            ms->sample.tokens++;
+            if ((ms->last_frame_type == FRAME_TYPE_TOKEN) &&
+                (ms->last_src == src) && (ms->last_dst == dst)) {
+                /* the token was not used, and is passed again */
+                ms->sample.token_retries++;
+                break;
+            }
+            mstpstat_token_end(node, time_us);
+            if (!ms->master_seen || (src > ms->max_master)) {
+                ms->max_master = src;
+                ms->master_seen = true;
+            }
+            if (dst_node->token_seen) {
+                delta = time_us - dst_node->token_start_us;
+                mstpstat_rotation(&ms->sample, delta);
+                if (delta > dst_node->rotation_max_us) {
+                    dst_node->rotation_max_us = delta;
+                }
+                dst_node->rotation_sum_us += delta;
+                dst_node->rotation_count++;
+            }
+            dst_node->tokens++;
+            dst_node->token_seen = true;
+            dst_node->token_held = true;
+            dst_node->token_start_us = time_us;
+            dst_node->token_frames = 0;
+            break;
+        case FRAME_TYPE_POLL_FOR_MASTER:
+            ms->sample.pfm++;
+            node->pfm++;
+            if (dst > node->max_master) {
+                node->max_master = dst;
+            }
+            break;
+        case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY:
+            ms->sample.der++;
+            if (dst != MSTP_BROADCAST_ADDRESS) {
+                dst_node->der_received++;
+            }
+            mstpstat_token_frame(node);
+            break;
+        case FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY:
+        case FRAME_TYPE_TEST_REQUEST:
+        case FRAME_TYPE_IPV6_ENCAPSULATION:
+            /* a reply is sent by a node that does not hold the token,
+               so it is not counted */
+            mstpstat_token_frame(node);
+            break;
+        case FRAME_TYPE_REPLY_POSTPONED:
+            ms->sample.reply_postponed++;
+            node->reply_postponed++;
+            break;
+        default:
+            break;
+    }
+    ms->last_time_us = time_us;
+    ms->last_frame_type = frame_type;
+    ms->last_dst = dst;
+    ms->last_src = src;
+}
+
+/**
+ * @brief Analyze an invalid frame, or the octets that were not a frame
+ * @param ms - analyzer
+ * @param time_us - free running time of the frame in microseconds
+ * @param octets - number of octets received
+ */
+void mstpstat_invalid_frame(MSTPSTAT *ms, uint32_t time_us, uint32_t octets)
+{
+    if (!ms) {
+        return;
+    }
+    mstpstat_start(ms, time_us);
+    ms->sample.invalid_frames++;
+    ms->sample.octets += octets;
+}
+
+/**
+ * @brief Determine if the current sample interval has ended
+ * @param ms - analyzer
+ * @param time_us - free running time now, in microseconds
+ * @return true if the sample should be taken
+ */
+bool mstpstat_sample_ready(const MSTPSTAT *ms, uint32_t time_us)
+{
+    if (!ms || !ms->started || (ms->interval_us == 0)) {
+        return false;
+    }
+
+    return (time_us - ms->sample_start_us) >= ms->interval_us;
+}
+
+/**
+ * @brief End the current sample, add it to the total, and start the next
+ * @param ms - analyzer
+ * @param time_us - free running time now, in microseconds
+ * @param sample - the ended sample, or NULL
+ * @return true if a sample was taken, false before the first frame
+ */
+bool mstpstat_sample_take(
+    MSTPSTAT *ms, uint32_t time_us, MSTPSTAT_SAMPLE *sample)
+{
+    if (!ms || !ms->started) {
+        return false;
+    }
+    ms->sample.duration_us = time_us - ms->sample_start_us;
+    mstpstat_sample_add(&ms->total, &ms->sample);
+    if (sample) {
+        *sample = ms->sample;
+    }
+    memset(&ms->sample, 0, sizeof(MSTPSTAT_SAMPLE));
+    ms->sample_start_us = time_us;
+
+    return true;
+}
+
+/**
+ * @brief Get the sum of the samples taken
+ * @param ms - analyzer
+ * @return the sum of the samples, or NULL
+ */
+const MSTPSTAT_SAMPLE *mstpstat_total(const MSTPSTAT *ms)
+{
+    if (!ms) {
+        return NULL;
+    }
+
+    return &ms->total;
+}
+
+/**
+ * @brief Get what a node did since the analysis started
+ * @param ms - analyzer
+ * @param mac - MAC address of the node
+ * @return the node, or NULL
+ */
+const MSTPSTAT_NODE *mstpstat_node(const MSTPSTAT *ms, uint8_t mac)
+{
+    if (!ms) {
+        return NULL;
+    }
+
+    return &ms->node[mac];
+}
+
+/**
+ * @brief Get the utilization of the trunk during a sample
+ * @param sample - the sample
+ * @param baud - baud rate of the trunk
+ * @return share of the bit times taken by frames, in permille
+ */
+uint32_t mstpstat_utilization(const MSTPSTAT_SAMPLE *sample, uint32_t baud)
+{
+    uint64_t bits_per_second;
+
+    if (!sample || (sample->duration_us == 0) || (baud == 0)) {
+        return 0;
+    }
+    bits_per_second = (sample->octets * MSTPSTAT_OCTET_BITS * 1000000ULL) /
+        sample->duration_us;
+
+    return (uint32_t)((bits_per_second * 1000ULL) / baud);
+}
+
+/**
+ * @brief Get the share of the time spent on Poll For Master during
+ *  a sample
+ * @param sample - the sample
+ * @return share of the time, in permille
+ */
+uint32_t mstpstat_pfm_permille(const MSTPSTAT_SAMPLE *sample)
+{
+    if (!sample || (sample->duration_us == 0)) {
+        return 0;
+    }
+
+    return (uint32_t)((sample->pfm_time_us * 1000ULL) / sample->duration_us);
+}
+
+/**
+ * @brief Get the average token rotation time of a sample
+ * @param sample - the sample
+ * @return the average time in microseconds, or zero
+ */
+uint32_t mstpstat_rotation_average(const MSTPSTAT_SAMPLE *sample)
+{
+    if (!sample || (sample->rotation_count == 0)) {
+        return 0;
+    }
+
+    return (uint32_t)(sample->rotation_sum_us / sample->rotation_count);
+}
+
+/**
+ * @brief Get the settings of a node that look wrong from its frames
+ * @param ms - analyzer
+ * @param mac - MAC address of the node
+ * @return MSTPSTAT_ADVICE flags, or zero when the node looks fine
+ */
+unsigned mstpstat_advice(const MSTPSTAT *ms, uint8_t mac)
+{
+    const MSTPSTAT_NODE *node;
+    unsigned advice = 0;
+
+    if (!ms) {
+        return 0;
+    }
+    node = &ms->node[mac];
+    if ((node->data_tokens >= MSTPSTAT_ADVICE_MIN) &&
+        ((node->full_tokens * 100ULL) >=
+         (node->data_tokens * (uint64_t)MSTPSTAT_FULL_TOKEN_PERCENT))) {
+        /* it always has more to send than it may */
+        advice |= MSTPSTAT_ADVICE_MAX_INFO_FRAMES;
+    }
+    if (ms->master_seen && (node->pfm >= MSTPSTAT_ADVICE_MIN) &&
+        (node->max_master > ms->max_master)) {
+        /* it polls for masters above the highest one */
+        advice |= MSTPSTAT_ADVICE_MAX_MASTER;
+    }
+    if (node->tusage_max_us > MSTPSTAT_TUSAGE_MAX_US) {
+        advice |= MSTPSTAT_ADVICE_TUSAGE_TIMEOUT;
+    }
+    if ((node->der_received >= MSTPSTAT_ADVICE_MIN) &&
+        ((node->reply_postponed * 100ULL) >=
+         (node->der_received * (uint64_t)MSTPSTAT_REPLY_POSTPONED_PERCENT))) {
+        advice |= MSTPSTAT_ADVICE_REPLY_POSTPONED;
+    }
+
+    return advice;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file
+ * @brief API for the MS/TP trunk analyzer, which computes the token
+ *  rotation, the usage of each master, and the utilization of an MS/TP
+ *  trunk from the frames seen on the wire
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DLMSTP
+ */
+#ifndef BACNET_MSTPSTAT_H
+#define BACNET_MSTPSTAT_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/mstpdef.h"
+
+/* number of MAC addresses on a trunk */
+#define MSTPSTAT_NODES 256
+/* octets of a frame header, with the preamble */
+#define MSTPSTAT_HEADER_OCTETS 8
+/* bit times of an octet on the wire: start, 8 data, and stop bits */
+#define MSTPSTAT_OCTET_BITS 10
+
+/* A node that sends as many frames as it may in at least this share of
+   the tokens that it uses is held back by its Max_Info_Frames. */
+#ifndef MSTPSTAT_FULL_TOKEN_PERCENT
+#define MSTPSTAT_FULL_TOKEN_PERCENT 50
+#endif
+/* A node that waits longer than this for a reply to a Poll For Master
+   wastes token rotation time on the absent stations. */
+#ifndef MSTPSTAT_TUSAGE_MAX_US
+#define MSTPSTAT_TUSAGE_MAX_US 50000UL
+#endif
+/* A node that postpones at least this share of the requests that expect
+   a reply from it makes its clients wait for a token rotation. */
+#ifndef MSTPSTAT_REPLY_POSTPONED_PERCENT
+#define MSTPSTAT_REPLY_POSTPONED_PERCENT 10
+#endif
+/* number of tokens or requests needed before any advice is given */
+#ifndef MSTPSTAT_ADVICE_MIN
+#define MSTPSTAT_ADVICE_MIN 10
+#endif
+
+/* the settings of a node that look wrong from the frames on the wire */
+#define MSTPSTAT_ADVICE_MAX_INFO_FRAMES 0x01
+#define MSTPSTAT_ADVICE_MAX_MASTER 0x02
+#define MSTPSTAT_ADVICE_TUSAGE_TIMEOUT 0x04
+#define MSTPSTAT_ADVICE_REPLY_POSTPONED 0x08
+
+/* the trunk during a sample interval, or since the analysis started */
+typedef struct mstpstat_sample {
+    uint64_t duration_us;
+    uint32_t frames;
+    uint32_t invalid_frames;
+    /* octets of all the frames, the invalid ones too */
+    uint64_t octets;
+    /* tokens passed, and the tokens passed again for lack of use */
+    uint32_t tokens;
+    uint32_t token_retries;
+    uint32_t pfm;
+    /* time from a Poll For Master to the next frame, which is the
+       reply or the wait for the reply of an absent station */
+    uint64_t pfm_time_us;
+    uint32_t der;
+    uint32_t reply_postponed;
+    /* time between a node getting the token and getting it again */
+    uint32_t rotation_count;
+    uint32_t rotation_min_us;
+    uint32_t rotation_max_us;
+    uint64_t rotation_sum_us;
+} MSTPSTAT_SAMPLE;
+
+/* what a node did since the analysis started */
+typedef struct mstpstat_node {
+    /* frames and octets sent by the node */
+    uint32_t frames;
+    uint64_t octets;
+    /* tokens that the node received, and the time it held them */
+    uint32_t tokens;
+    uint64_t token_time_us;
+    uint32_t rotation_count;
+    uint32_t rotation_max_us;
+    uint64_t rotation_sum_us;
+    /* tokens in which the node sent data, the most data frames that it
+       sent in one token, and the tokens in which it sent that many */
+    uint32_t data_tokens;
+    uint8_t max_info_frames;
+    uint32_t full_tokens;
+    uint32_t pfm;
+    /* highest MAC that the node polled, and its longest wait for the
+       reply of an absent station */
+    uint8_t max_master;
+    uint32_t tusage_max_us;
+    /* requests that expect a reply sent to the node, and the replies
+       that it postponed */
+    uint32_t der_received;
+    uint32_t reply_postponed;
+    /* -- state while the node holds the token -- */
+    bool token_seen;
+    bool token_held;
+    uint32_t token_start_us;
+    uint8_t token_frames;
+} MSTPSTAT_NODE;
+
+typedef struct mstpstat {
+    uint32_t interval_us;
+    bool started;
+    uint32_t sample_start_us;
+    MSTPSTAT_SAMPLE sample;
+    MSTPSTAT_SAMPLE total;
+    MSTPSTAT_NODE node[MSTPSTAT_NODES];
+    /* the highest MAC that passed a token */
+    uint8_t max_master;
+    bool master_seen;
+    /* the last frame */
+    uint32_t last_time_us;
+    uint8_t last_frame_type;
+    uint8_t last_dst;
+    uint8_t last_src;
+} MSTPSTAT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void mstpstat_init(MSTPSTAT *ms, uint32_t interval_ms);
+BACNET_STACK_EXPORT
+void mstpstat_frame(
+    MSTPSTAT *ms,
+    uint32_t time_us,
+    uint8_t frame_type,
+    uint8_t dst,
+    uint8_t src,
+    uint16_t data_len);
+BACNET_STACK_EXPORT
+void mstpstat_invalid_frame(MSTPSTAT *ms, uint32_t time_us, uint32_t octets);
+
+BACNET_STACK_EXPORT
+bool mstpstat_sample_ready(const MSTPSTAT *ms, uint32_t time_us);
+BACNET_STACK_EXPORT
+bool mstpstat_sample_take(
+    MSTPSTAT *ms, uint32_t time_us, MSTPSTAT_SAMPLE *sample);
+BACNET_STACK_EXPORT
+const MSTPSTAT_SAMPLE *mstpstat_total(const MSTPSTAT *ms);
+BACNET_STACK_EXPORT
+const MSTPSTAT_NODE *mstpstat_node(const MSTPSTAT *ms, uint8_t mac);
+
+BACNET_STACK_EXPORT
+uint32_t mstpstat_utilization(const MSTPSTAT_SAMPLE *sample, uint32_t baud);
+BACNET_STACK_EXPORT
+uint32_t mstpstat_pfm_permille(const MSTPSTAT_SAMPLE *sample);
+BACNET_STACK_EXPORT
+uint32_t mstpstat_rotation_average(const MSTPSTAT_SAMPLE *sample);
+BACNET_STACK_EXPORT
+unsigned mstpstat_advice(const MSTPSTAT *ms, uint8_t mac);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
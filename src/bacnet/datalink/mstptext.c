@@ -15,7 +15,7 @@
 
 /** @file mstptext.c  Text mapping functions for BACnet MS/TP */
 
-static INDTEXT_DATA mstp_receive_state_text[] = {
+static INDTEXT_DATA mstp_receive_state_text[] BACNET_STACK_PROGMEM = {
     { MSTP_RECEIVE_STATE_IDLE, "IDLE" },
     { MSTP_RECEIVE_STATE_PREAMBLE, "PREAMBLE" },
     { MSTP_RECEIVE_STATE_HEADER, "HEADER" },
@@ -28,7 +28,7 @@ const char *mstptext_receive_state(unsigned index)
     return indtext_by_index_default(mstp_receive_state_text, index, "unknown");
 }
 
-static INDTEXT_DATA mstp_master_state_text[] = {
+static INDTEXT_DATA mstp_master_state_text[] BACNET_STACK_PROGMEM = {
     { MSTP_MASTER_STATE_INITIALIZE, "INITIALIZE" },
     { MSTP_MASTER_STATE_IDLE, "IDLE" },
     { MSTP_MASTER_STATE_USE_TOKEN, "USE_TOKEN" },
@@ -46,7 +46,7 @@ const char *mstptext_master_state(unsigned index)
     return indtext_by_index_default(mstp_master_state_text, index, "unknown");
 }
 
-static INDTEXT_DATA mstp_frame_type_text[] = {
+static INDTEXT_DATA mstp_frame_type_text[] BACNET_STACK_PROGMEM = {
     { FRAME_TYPE_TOKEN, "TOKEN" },
     { FRAME_TYPE_POLL_FOR_MASTER, "POLL_FOR_MASTER" },
     { FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER, "REPLY_TO_POLL_FOR_MASTER" },
@@ -71,7 +71,7 @@ const char *mstptext_frame_type(unsigned index)
         "PROPRIETARY");
 }
 
-static INDTEXT_DATA mstp_zero_config_state_text[] = {
+static INDTEXT_DATA mstp_zero_config_state_text[] BACNET_STACK_PROGMEM = {
     { MSTP_ZERO_CONFIG_STATE_INIT, "INIT" },
     { MSTP_ZERO_CONFIG_STATE_IDLE, "IDLE" },
     { MSTP_ZERO_CONFIG_STATE_LURK, "LURK" },
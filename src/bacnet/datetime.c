@@ -129,6 +129,14 @@ uint32_t datetime_day_of_year(const BACNET_DATE *bdate)
     return days;
 }
 
+/* The epoch conversions count the days in a calendar that starts on
+   March 1 of year 0, so that the leap day is the last day of each year,
+   and use the 400 year cycle of 146097 days, instead of counting the
+   years and the months since the BACnet epoch one at a time. */
+#define DATETIME_DAYS_PER_ERA 146097UL
+/* days from March 1 of year 0 until January 1, 1900 */
+#define DATETIME_DAYS_TO_EPOCH 693901UL
+
 /**
  * Converts days since BACnet epoch
  *
@@ -141,9 +149,22 @@ uint32_t
 datetime_ymd_to_days_since_epoch(uint16_t year, uint8_t month, uint8_t day)
 {
     uint32_t days = 0; /* return value */
+    uint32_t era, year_of_era, day_of_year;
 
     if (datetime_ymd_is_valid(year, month, day)) {
-        days = days_since_epoch(BACNET_DATE_YEAR_EPOCH, year, month, day);
+        /* January and February are the end of the prior year */
+        if (month <= 2) {
+            year--;
+            month += 9;
+        } else {
+            month -= 3;
+        }
+        era = year / 400;
+        year_of_era = year - (era * 400);
+        day_of_year = (((153 * (uint32_t)month) + 2) / 5) + day - 1;
+        days = (era * DATETIME_DAYS_PER_ERA) + (year_of_era * 365) +
+            (year_of_era / 4) - (year_of_era / 100) + day_of_year;
+        days -= DATETIME_DAYS_TO_EPOCH;
     }
 
     return days;
@@ -178,28 +199,34 @@ uint32_t datetime_days_since_epoch(const BACNET_DATE *bdate)
 void datetime_ymd_from_days_since_epoch(
     uint32_t days, uint16_t *pYear, uint8_t *pMonth, uint8_t *pDay)
 {
-    uint16_t year = BACNET_DATE_YEAR_EPOCH;
-    uint8_t month = 1;
-    uint8_t day = 1;
-
-    while (days >= 365) {
-        if ((days_is_leap_year(year)) && (days == 365)) {
-            break;
-        }
-        days -= 365;
-        if (days_is_leap_year(year)) {
-            --days;
-        }
-        year++;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint32_t era, day_of_era, year_of_era, day_of_year, month_index;
+
+    days += DATETIME_DAYS_TO_EPOCH;
+    era = days / DATETIME_DAYS_PER_ERA;
+    day_of_era = days - (era * DATETIME_DAYS_PER_ERA);
+    /* skip the leap days, which come every 4 years except every 100 years
+       except every 400 years */
+    year_of_era = (day_of_era - (day_of_era / 1460) + (day_of_era / 36524) -
+                   (day_of_era / (DATETIME_DAYS_PER_ERA - 1))) /
+        365;
+    day_of_year = day_of_era -
+        ((year_of_era * 365) + (year_of_era / 4) - (year_of_era / 100));
+    /* March=0...February=11 */
+    month_index = ((5 * day_of_year) + 2) / 153;
+    day = (uint8_t)(day_of_year - (((153 * month_index) + 2) / 5) + 1);
+    if (month_index < 10) {
+        month = (uint8_t)(month_index + 3);
+    } else {
+        month = (uint8_t)(month_index - 9);
     }
-
-    while (days >= (uint32_t)days_per_month(year, month)) {
-        days -= days_per_month(year, month);
-        month++;
+    year = (uint16_t)(year_of_era + (era * 400));
+    if (month <= 2) {
+        year++;
     }
 
-    day = (uint8_t)(day + days);
-
     if (pYear) {
         *pYear = year;
     }
@@ -277,6 +304,194 @@ bool datetime_is_valid(const BACNET_DATE *bdate, const BACNET_TIME *btime)
     return datetime_date_is_valid(bdate) && datetime_time_is_valid(btime);
 }
 
+/**
+ * @brief Pack a date into a key that sorts the same as the date fields,
+ *  with the year in bits 31..16, month in 15..8, and day in 7..0.
+ *  The day of the week is not part of the key, nor of the comparison.
+ * @param bdate - Pointer to a BACNET_DATE structure
+ * @return packed date key
+ */
+uint32_t datetime_date_key(const BACNET_DATE *bdate)
+{
+    uint32_t key = 0;
+
+    if (bdate) {
+        key = ((uint32_t)bdate->year << 16) | ((uint32_t)bdate->month << 8) |
+            (uint32_t)bdate->day;
+    }
+
+    return key;
+}
+
+/**
+ * @brief Build the mask of the date key fields that are not wildcards
+ * @param bdate - Pointer to a BACNET_DATE structure
+ * @return mask with zero bits for each wildcard field
+ */
+uint32_t datetime_date_key_mask(const BACNET_DATE *bdate)
+{
+    uint32_t mask = 0;
+
+    if (bdate) {
+        if (bdate->year != 1900 + 0xFF) {
+            mask |= 0xFFFF0000UL;
+        }
+        if (bdate->month != 0xFF) {
+            mask |= 0x0000FF00UL;
+        }
+        if (bdate->day != 0xFF) {
+            mask |= 0x000000FFUL;
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * @brief Pack a time into a key that sorts the same as the time fields,
+ *  with the hour in bits 31..24, minute in 23..16, second in 15..8,
+ *  and hundredths in 7..0.
+ * @param btime - Pointer to a BACNET_TIME structure
+ * @return packed time key
+ */
+uint32_t datetime_time_key(const BACNET_TIME *btime)
+{
+    uint32_t key = 0;
+
+    if (btime) {
+        key = ((uint32_t)btime->hour << 24) | ((uint32_t)btime->min << 16) |
+            ((uint32_t)btime->sec << 8) | (uint32_t)btime->hundredths;
+    }
+
+    return key;
+}
+
+/**
+ * @brief Build the mask of the time key fields that are not wildcards
+ * @param btime - Pointer to a BACNET_TIME structure
+ * @return mask with zero bits for each wildcard field
+ */
+uint32_t datetime_time_key_mask(const BACNET_TIME *btime)
+{
+    uint32_t mask = 0;
+
+    if (btime) {
+        if (btime->hour != 0xFF) {
+            mask |= 0xFF000000UL;
+        }
+        if (btime->min != 0xFF) {
+            mask |= 0x00FF0000UL;
+        }
+        if (btime->sec != 0xFF) {
+            mask |= 0x0000FF00UL;
+        }
+        if (btime->hundredths != 0xFF) {
+            mask |= 0x000000FFUL;
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * @brief Compare two packed date or time keys
+ * @param key1 - packed key from datetime_date_key() or datetime_time_key()
+ * @param key2 - packed key of the same kind
+ * @return -1 if key1 is before key2, 0 if the same, +1 if after
+ */
+int datetime_key_compare32(uint32_t key1, uint32_t key2)
+{
+    return (key1 > key2) - (key1 < key2);
+}
+
+/**
+ * @brief Compare two packed date or time keys, skipping the fields
+ *  that are a wildcard in either of them
+ * @param key1 - packed key from datetime_date_key() or datetime_time_key()
+ * @param mask1 - wildcard mask of key1
+ * @param key2 - packed key of the same kind
+ * @param mask2 - wildcard mask of key2
+ * @return -1 if key1 is before key2, 0 if the same, +1 if after
+ */
+int datetime_key_wildcard_compare32(
+    uint32_t key1, uint32_t mask1, uint32_t key2, uint32_t mask2)
+{
+    uint32_t mask = mask1 & mask2;
+
+    return datetime_key_compare32(key1 & mask, key2 & mask);
+}
+
+#ifdef UINT64_MAX
+/**
+ * @brief Pack a date and time into one key that sorts the same as
+ *  datetime_compare(), so that a comparison is one integer compare.
+ * @param bdatetime - Pointer to a BACNET_DATE_TIME structure
+ * @return packed date and time key
+ */
+bacnet_datetime_key_t datetime_key(const BACNET_DATE_TIME *bdatetime)
+{
+    bacnet_datetime_key_t key = 0;
+
+    if (bdatetime) {
+        key = (bacnet_datetime_key_t)datetime_date_key(&bdatetime->date)
+            << 32;
+        key |= datetime_time_key(&bdatetime->time);
+    }
+
+    return key;
+}
+
+/**
+ * @brief Build the mask of the date and time key fields that are not
+ *  wildcards, for use with datetime_key_wildcard_compare()
+ * @param bdatetime - Pointer to a BACNET_DATE_TIME structure
+ * @return mask with zero bits for each wildcard field
+ */
+bacnet_datetime_key_t datetime_key_mask(const BACNET_DATE_TIME *bdatetime)
+{
+    bacnet_datetime_key_t mask = 0;
+
+    if (bdatetime) {
+        mask = (bacnet_datetime_key_t)datetime_date_key_mask(&bdatetime->date)
+            << 32;
+        mask |= datetime_time_key_mask(&bdatetime->time);
+    }
+
+    return mask;
+}
+
+/**
+ * @brief Compare two packed date and time keys
+ * @param key1 - packed key from datetime_key()
+ * @param key2 - packed key from datetime_key()
+ * @return -1 if key1 is before key2, 0 if the same, +1 if after
+ */
+int datetime_key_compare(bacnet_datetime_key_t key1, bacnet_datetime_key_t key2)
+{
+    return (key1 > key2) - (key1 < key2);
+}
+
+/**
+ * @brief Compare two packed date and time keys, skipping the fields
+ *  that are a wildcard in either of them
+ * @param key1 - packed key from datetime_key()
+ * @param mask1 - mask from datetime_key_mask() of key1
+ * @param key2 - packed key from datetime_key()
+ * @param mask2 - mask from datetime_key_mask() of key2
+ * @return -1 if key1 is before key2, 0 if the same, +1 if after
+ */
+int datetime_key_wildcard_compare(
+    bacnet_datetime_key_t key1,
+    bacnet_datetime_key_t mask1,
+    bacnet_datetime_key_t key2,
+    bacnet_datetime_key_t mask2)
+{
+    bacnet_datetime_key_t mask = mask1 & mask2;
+
+    return datetime_key_compare(key1 & mask, key2 & mask);
+}
+#endif
+
 /**
  * If the date1 is the same as date2, return is 0.
  * If date1 is after date2, returns positive.
@@ -292,13 +507,8 @@ int datetime_compare_date(const BACNET_DATE *date1, const BACNET_DATE *date2)
     int diff = 0;
 
     if (date1 && date2) {
-        diff = (int)date1->year - (int)date2->year;
-        if (diff == 0) {
-            diff = (int)date1->month - (int)date2->month;
-            if (diff == 0) {
-                diff = (int)date1->day - (int)date2->day;
-            }
-        }
+        diff = datetime_key_compare32(
+            datetime_date_key(date1), datetime_date_key(date2));
     }
 
     return diff;
@@ -338,16 +548,8 @@ int datetime_compare_time(const BACNET_TIME *time1, const BACNET_TIME *time2)
     int diff = 0;
 
     if (time1 && time2) {
-        diff = (int)time1->hour - (int)time2->hour;
-        if (diff == 0) {
-            diff = (int)time1->min - (int)time2->min;
-            if (diff == 0) {
-                diff = (int)time1->sec - (int)time2->sec;
-                if (diff == 0) {
-                    diff = (int)time1->hundredths - (int)time2->hundredths;
-                }
-            }
-        }
+        diff = datetime_key_compare32(
+            datetime_time_key(time1), datetime_time_key(time2));
     }
 
     return diff;
@@ -387,10 +589,15 @@ int datetime_compare(
 {
     int diff = 0;
 
+#ifdef UINT64_MAX
+    diff =
+        datetime_key_compare(datetime_key(datetime1), datetime_key(datetime2));
+#else
     diff = datetime_compare_date(&datetime1->date, &datetime2->date);
     if (diff == 0) {
         diff = datetime_compare_time(&datetime1->time, &datetime2->time);
     }
+#endif
 
     return diff;
 }
@@ -421,20 +628,10 @@ int datetime_wildcard_compare_date(
     int diff = 0;
 
     if (date1 && date2) {
-        if ((date1->year != 1900 + 0xFF) && (date2->year != 1900 + 0xFF)) {
-            diff = (int)date1->year - (int)date2->year;
-        }
-        if (diff == 0) {
-            if ((date1->month != 0xFF) && (date2->month != 0xFF)) {
-                diff = (int)date1->month - (int)date2->month;
-            }
-            if (diff == 0) {
-                if ((date1->day != 0xFF) && (date2->day != 0xFF)) {
-                    diff = (int)date1->day - (int)date2->day;
-                }
-                /* we ignore weekday in comparison */
-            }
-        }
+        /* we ignore weekday in comparison */
+        diff = datetime_key_wildcard_compare32(
+            datetime_date_key(date1), datetime_date_key_mask(date1),
+            datetime_date_key(date2), datetime_date_key_mask(date2));
     }
 
     return diff;
@@ -446,25 +643,9 @@ int datetime_wildcard_compare_time(
     int diff = 0;
 
     if (time1 && time2) {
-        if ((time1->hour != 0xFF) && (time2->hour != 0xFF)) {
-            diff = (int)time1->hour - (int)time2->hour;
-        }
-        if (diff == 0) {
-            if ((time1->min != 0xFF) && (time2->min != 0xFF)) {
-                diff = (int)time1->min - (int)time2->min;
-            }
-            if (diff == 0) {
-                if ((time1->sec != 0xFF) && (time2->sec != 0xFF)) {
-                    diff = (int)time1->sec - (int)time2->sec;
-                }
-                if (diff == 0) {
-                    if ((time1->hundredths != 0xFF) &&
-                        (time2->hundredths != 0xFF)) {
-                        diff = (int)time1->hundredths - (int)time2->hundredths;
-                    }
-                }
-            }
-        }
+        diff = datetime_key_wildcard_compare32(
+            datetime_time_key(time1), datetime_time_key_mask(time1),
+            datetime_time_key(time2), datetime_time_key_mask(time2));
     }
 
     return diff;
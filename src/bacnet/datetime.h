@@ -72,6 +72,12 @@ typedef uint64_t bacnet_time_t;
 typedef uint32_t bacnet_time_t;
 #endif
 
+/* packed date and time that sorts the same as datetime_compare(),
+   year:16 month:8 day:8 hour:8 minute:8 second:8 hundredths:8 */
+#ifdef UINT64_MAX
+typedef uint64_t bacnet_datetime_key_t;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -184,6 +190,36 @@ BACNET_STACK_EXPORT
 int datetime_wildcard_compare(
     const BACNET_DATE_TIME *datetime1, const BACNET_DATE_TIME *datetime2);
 
+/* packed comparable keys - a wildcard field has zero bits in the mask */
+BACNET_STACK_EXPORT
+uint32_t datetime_date_key(const BACNET_DATE *bdate);
+BACNET_STACK_EXPORT
+uint32_t datetime_date_key_mask(const BACNET_DATE *bdate);
+BACNET_STACK_EXPORT
+uint32_t datetime_time_key(const BACNET_TIME *btime);
+BACNET_STACK_EXPORT
+uint32_t datetime_time_key_mask(const BACNET_TIME *btime);
+BACNET_STACK_EXPORT
+int datetime_key_compare32(uint32_t key1, uint32_t key2);
+BACNET_STACK_EXPORT
+int datetime_key_wildcard_compare32(
+    uint32_t key1, uint32_t mask1, uint32_t key2, uint32_t mask2);
+#ifdef UINT64_MAX
+BACNET_STACK_EXPORT
+bacnet_datetime_key_t datetime_key(const BACNET_DATE_TIME *bdatetime);
+BACNET_STACK_EXPORT
+bacnet_datetime_key_t datetime_key_mask(const BACNET_DATE_TIME *bdatetime);
+BACNET_STACK_EXPORT
+int datetime_key_compare(
+    bacnet_datetime_key_t key1, bacnet_datetime_key_t key2);
+BACNET_STACK_EXPORT
+int datetime_key_wildcard_compare(
+    bacnet_datetime_key_t key1,
+    bacnet_datetime_key_t mask1,
+    bacnet_datetime_key_t key2,
+    bacnet_datetime_key_t mask2);
+#endif
+
 /* utility copy functions */
 BACNET_STACK_EXPORT
 void datetime_copy_date(BACNET_DATE *dest, const BACNET_DATE *src);
@@ -7,6 +7,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <assert.h>
+#include <string.h>
 #include "bacnet/event.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/npdu.h"
@@ -471,12 +472,14 @@ static int event_discrete_value_decode(
 }
 
 /**
- * @brief Encode the EventNotification service request
+ * @brief Encode the EventNotification service request after the
+ *  processIdentifier, which is the part that is the same for every
+ *  recipient of the event
  * @param apdu  Pointer to the buffer for encoding into
  * @param data  Pointer to the service data used for encoding values
  * @return number of bytes encoded, or zero if unable to encode
  */
-int event_notify_encode_service_request(
+int event_notify_encode_service_request_body(
     uint8_t *apdu, const BACNET_EVENT_NOTIFICATION_DATA *data)
 {
     int len = 0; /* length of each encoding */
@@ -486,12 +489,6 @@ int event_notify_encode_service_request(
     if (!data) {
         return 0;
     }
-    /* tag 0 - processIdentifier */
-    len = encode_context_unsigned(apdu, 0, data->processIdentifier);
-    apdu_len += len;
-    if (apdu) {
-        apdu += len;
-    }
     /* tag 1 - initiatingObjectIdentifier */
     len = encode_context_object_id(
         apdu, 1, data->initiatingObjectIdentifier.type,
@@ -1551,6 +1548,93 @@ int event_notify_encode_service_request(
     return apdu_len;
 }
 
+/**
+ * @brief Encode the EventNotification service request
+ * @param apdu  Pointer to the buffer for encoding into
+ * @param data  Pointer to the service data used for encoding values
+ * @return number of bytes encoded, or zero if unable to encode
+ */
+int event_notify_encode_service_request(
+    uint8_t *apdu, const BACNET_EVENT_NOTIFICATION_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+
+    if (!data) {
+        return 0;
+    }
+    /* tag 0 - processIdentifier */
+    len = encode_context_unsigned(apdu, 0, data->processIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = event_notify_encode_service_request_body(apdu, data);
+    if (len > 0) {
+        apdu_len += len;
+    } else {
+        apdu_len = 0;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode an EventNotification APDU from a service request body
+ *  that was encoded once for all of the recipients of an event
+ * @param apdu  Pointer to the buffer for encoding into
+ * @param apdu_size number of bytes available in the buffer
+ * @param confirmed  true for a ConfirmedEventNotification
+ * @param invoke_id  ID to invoke for a confirmed notification
+ * @param process_id  processIdentifier of the recipient
+ * @param body  service request from event_notify_encode_service_request_body()
+ * @param body_len  number of bytes in the service request body
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+size_t event_notify_encode_apdu_body(
+    uint8_t *apdu,
+    size_t apdu_size,
+    bool confirmed,
+    uint8_t invoke_id,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len)
+{
+    size_t apdu_len = 0; /* total length of the apdu, return value */
+    uint8_t header[4] = { 0 };
+    size_t header_len;
+
+    if (!body || (body_len == 0)) {
+        return 0;
+    }
+    if (confirmed) {
+        header[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        header[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+        header[2] = invoke_id;
+        header[3] = SERVICE_CONFIRMED_EVENT_NOTIFICATION;
+        header_len = 4;
+    } else {
+        header[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+        header[1] = SERVICE_UNCONFIRMED_EVENT_NOTIFICATION;
+        header_len = 2;
+    }
+    /* tag 0 - processIdentifier */
+    apdu_len = header_len + encode_context_unsigned(NULL, 0, process_id);
+    apdu_len += body_len;
+    if (apdu_len > apdu_size) {
+        return 0;
+    }
+    if (apdu) {
+        memcpy(apdu, header, header_len);
+        apdu_len = header_len;
+        apdu_len += encode_context_unsigned(&apdu[apdu_len], 0, process_id);
+        memcpy(&apdu[apdu_len], body, body_len);
+        apdu_len += body_len;
+    }
+
+    return apdu_len;
+}
+
 /**
  * @brief Encode the EventNotification service request
  * @param apdu  Pointer to the buffer for encoding into
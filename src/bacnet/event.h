@@ -446,6 +446,18 @@ int uevent_notify_encode_apdu(
 BACNET_STACK_EXPORT
 int event_notify_encode_service_request(
     uint8_t *apdu, const BACNET_EVENT_NOTIFICATION_DATA *data);
+BACNET_STACK_EXPORT
+int event_notify_encode_service_request_body(
+    uint8_t *apdu, const BACNET_EVENT_NOTIFICATION_DATA *data);
+BACNET_STACK_EXPORT
+size_t event_notify_encode_apdu_body(
+    uint8_t *apdu,
+    size_t apdu_size,
+    bool confirmed,
+    uint8_t invoke_id,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len);
 
 BACNET_STACK_EXPORT
 size_t event_notification_service_request_encode(
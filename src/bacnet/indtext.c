@@ -6,12 +6,191 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/bacstr.h"
 #include "bacnet/indtext.h"
 
+#if INDTEXT_INDEX_TABLES && BACNET_STACK_PROGMEM_ENABLED
+#error "the lookup index reads the lists directly, without progmem"
+#endif
+
+#if INDTEXT_INDEX_TABLES
+/* The lookup index of a list, which is built the first time that the list
+   is searched, so that the large lists of bactext are not scanned on each
+   lookup. The lists are static and const, so the index is never stale. */
+typedef struct indtext_index {
+    INDTEXT_DATA *data_list;
+    uint16_t count;
+    /* position+1 of the first entry of each index from index_min,
+       or NULL when the indices are too sparse */
+    uint32_t index_min;
+    uint32_t index_span;
+    uint16_t *by_index;
+    /* positions sorted by the case insensitive string, then position */
+    uint16_t *by_string;
+} INDTEXT_INDEX;
+
+static INDTEXT_INDEX Indtext_Index[INDTEXT_INDEX_TABLES];
+static unsigned Indtext_Index_Count;
+/* true when every lookup index is taken */
+static bool Indtext_Index_Full;
+
+/**
+ * @brief Build the index of the indices of a list
+ * @param entry - the lookup index of the list
+ */
+static void indtext_index_by_index(INDTEXT_INDEX *entry)
+{
+    INDTEXT_DATA *data_list = entry->data_list;
+    uint32_t index_max;
+    uint16_t i;
+
+    entry->index_min = data_list[0].index;
+    index_max = data_list[0].index;
+    for (i = 1; i < entry->count; i++) {
+        if (data_list[i].index < entry->index_min) {
+            entry->index_min = data_list[i].index;
+        }
+        if (data_list[i].index > index_max) {
+            index_max = data_list[i].index;
+        }
+    }
+    entry->index_span = index_max - entry->index_min + 1;
+    if ((entry->index_span == 0) ||
+        (entry->index_span > ((uint32_t)entry->count * 4))) {
+        return;
+    }
+    entry->by_index = calloc(entry->index_span, sizeof(uint16_t));
+    if (!entry->by_index) {
+        return;
+    }
+    for (i = 0; i < entry->count; i++) {
+        uint16_t *slot =
+            &entry->by_index[data_list[i].index - entry->index_min];
+        if (*slot == 0) {
+            *slot = i + 1;
+        }
+    }
+}
+
+/**
+ * @brief Build the index of the strings of a list with an insertion sort,
+ *  which keeps the entries with the same string in the order of the list
+ * @param entry - the lookup index of the list
+ */
+static void indtext_index_by_string(INDTEXT_INDEX *entry)
+{
+    INDTEXT_DATA *data_list = entry->data_list;
+    uint16_t i, j, position;
+
+    entry->by_string = calloc(entry->count, sizeof(uint16_t));
+    if (!entry->by_string) {
+        return;
+    }
+    for (i = 0; i < entry->count; i++) {
+        position = i;
+        j = i;
+        while ((j > 0) &&
+               (bacnet_stricmp(
+                    data_list[entry->by_string[j - 1]].pString,
+                    data_list[position].pString) > 0)) {
+            entry->by_string[j] = entry->by_string[j - 1];
+            j--;
+        }
+        entry->by_string[j] = position;
+    }
+}
+
+/**
+ * @brief Find the lookup index of a list, and build it the first time
+ * @param data_list - list of strings and indices
+ * @return the lookup index, or NULL if the list is not indexed
+ */
+static INDTEXT_INDEX *indtext_index(INDTEXT_DATA *data_list)
+{
+    INDTEXT_INDEX *entry;
+    uint32_t count = 0;
+    unsigned i;
+
+    for (i = 0; i < Indtext_Index_Count; i++) {
+        if (Indtext_Index[i].data_list == data_list) {
+            return &Indtext_Index[i];
+        }
+    }
+    if (Indtext_Index_Full) {
+        return NULL;
+    }
+    while (data_list[count].pString) {
+        count++;
+        if (count > UINT16_MAX) {
+            return NULL;
+        }
+    }
+    if (count < INDTEXT_INDEX_COUNT_MIN) {
+        return NULL;
+    }
+    entry = &Indtext_Index[Indtext_Index_Count];
+    entry->data_list = data_list;
+    entry->count = (uint16_t)count;
+    indtext_index_by_index(entry);
+    indtext_index_by_string(entry);
+    Indtext_Index_Count++;
+    if (Indtext_Index_Count >= INDTEXT_INDEX_TABLES) {
+        Indtext_Index_Full = true;
+    }
+
+    return entry;
+}
+
+/**
+ * @brief Find a string in the lookup index of a list
+ * @param entry - the lookup index of the list
+ * @param search_name - string to search for
+ * @param case_insensitive - true to ignore the case of the string
+ * @param found_index - index of the string found
+ * @return true if the matching string is found
+ */
+static bool indtext_index_string(
+    const INDTEXT_INDEX *entry,
+    const char *search_name,
+    bool case_insensitive,
+    uint32_t *found_index)
+{
+    INDTEXT_DATA *data_list = entry->data_list;
+    uint16_t low = 0, high = entry->count, middle;
+
+    /* the first entry that is not before the string */
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (bacnet_stricmp(
+                data_list[entry->by_string[middle]].pString, search_name) <
+            0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    for (; low < entry->count; low++) {
+        INDTEXT_DATA *data = &data_list[entry->by_string[low]];
+        if (bacnet_stricmp(data->pString, search_name) != 0) {
+            break;
+        }
+        if (case_insensitive ||
+            (bacnet_strcmp(data->pString, search_name) == 0)) {
+            if (found_index) {
+                *found_index = data->index;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
 /**
  * @brief Search a list of strings to find a matching string
  * @param data_list - list of strings and indices
@@ -24,11 +203,20 @@ bool indtext_by_string(
 {
     bool found = false;
     uint32_t index = 0;
+#if INDTEXT_INDEX_TABLES
+    const INDTEXT_INDEX *entry;
 
     if (data_list && search_name) {
-        while (data_list->pString) {
-            if (bacnet_strcmp(data_list->pString, search_name) == 0) {
-                index = data_list->index;
+        entry = indtext_index(data_list);
+        if (entry && entry->by_string) {
+            return indtext_index_string(entry, search_name, false, found_index);
+        }
+    }
+#endif
+    if (data_list && search_name) {
+        while (INDTEXT_STRING(data_list)) {
+            if (bacnet_strcmp(INDTEXT_STRING(data_list), search_name) == 0) {
+                index = INDTEXT_INDEX(data_list);
                 found = true;
                 break;
             }
@@ -55,11 +243,20 @@ bool indtext_by_istring(
 {
     bool found = false;
     uint32_t index = 0;
+#if INDTEXT_INDEX_TABLES
+    const INDTEXT_INDEX *entry;
 
     if (data_list && search_name) {
-        while (data_list->pString) {
-            if (bacnet_stricmp(data_list->pString, search_name) == 0) {
-                index = data_list->index;
+        entry = indtext_index(data_list);
+        if (entry && entry->by_string) {
+            return indtext_index_string(entry, search_name, true, found_index);
+        }
+    }
+#endif
+    if (data_list && search_name) {
+        while (INDTEXT_STRING(data_list)) {
+            if (bacnet_stricmp(INDTEXT_STRING(data_list), search_name) == 0) {
+                index = INDTEXT_INDEX(data_list);
                 found = true;
                 break;
             }
@@ -124,11 +321,28 @@ const char *indtext_by_index_default(
     INDTEXT_DATA *data_list, uint32_t index, const char *default_string)
 {
     const char *pString = NULL;
+#if INDTEXT_INDEX_TABLES
+    const INDTEXT_INDEX *entry;
+    uint16_t position;
 
     if (data_list) {
-        while (data_list->pString) {
-            if (data_list->index == index) {
-                pString = data_list->pString;
+        entry = indtext_index(data_list);
+        if (entry && entry->by_index) {
+            if ((index >= entry->index_min) &&
+                ((index - entry->index_min) < entry->index_span)) {
+                position = entry->by_index[index - entry->index_min];
+                if (position) {
+                    pString = data_list[position - 1].pString;
+                }
+            }
+            return pString ? pString : default_string;
+        }
+    }
+#endif
+    if (data_list) {
+        while (INDTEXT_STRING(data_list)) {
+            if (INDTEXT_INDEX(data_list) == index) {
+                pString = INDTEXT_STRING(data_list);
                 break;
             }
             data_list++;
@@ -181,9 +395,18 @@ const char *indtext_by_index(INDTEXT_DATA *data_list, uint32_t index)
 uint32_t indtext_count(INDTEXT_DATA *data_list)
 {
     uint32_t count = 0; /* return value */
+#if INDTEXT_INDEX_TABLES
+    const INDTEXT_INDEX *entry;
 
     if (data_list) {
-        while (data_list->pString) {
+        entry = indtext_index(data_list);
+        if (entry) {
+            return entry->count;
+        }
+    }
+#endif
+    if (data_list) {
+        while (INDTEXT_STRING(data_list)) {
             count++;
             data_list++;
         }
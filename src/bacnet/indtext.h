@@ -14,11 +14,30 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 
-/* index and text pairs */
+/* Number of lists that get a lookup index the first time that they are
+   searched, and the shortest list that gets one. The other lists are
+   scanned. Use 0 to scan every list, such as when there is no heap, or
+   when the lists are in program memory. */
+#ifndef INDTEXT_INDEX_TABLES
+#if BACNET_STACK_PROGMEM_ENABLED
+#define INDTEXT_INDEX_TABLES 0
+#else
+#define INDTEXT_INDEX_TABLES 32
+#endif
+#endif
+#ifndef INDTEXT_INDEX_COUNT_MIN
+#define INDTEXT_INDEX_COUNT_MIN 16
+#endif
+
+/* index and text pairs. Define each list with BACNET_STACK_PROGMEM,
+   and read its entries with INDTEXT_INDEX() and INDTEXT_STRING(). */
 typedef const struct {
     const uint32_t index; /* index number that matches the text */
     const char *pString; /* text pair - use NULL to end the list */
 } INDTEXT_DATA;
+#define INDTEXT_INDEX(data) ((uint32_t)bacnet_progmem_uint32(&(data)->index))
+#define INDTEXT_STRING(data) \
+    ((const char *)bacnet_progmem_pointer(&(data)->pString))
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,17 +23,18 @@
 /** @file property.c  List of Required and Optional object properties */
 /* note: the PROP_PROPERTY_LIST is NOT included in these lists, on purpose */
 
-static const int32_t Default_Properties_Required[] = {
+static const int32_t Default_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME, PROP_OBJECT_TYPE, -1
 };
 
-static const int32_t Default_Properties_Optional[] = {
+static const int32_t Default_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     -1
 };
 
-static const int32_t Access_Credential_Properties_Required[] = {
+static const int32_t Access_Credential_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -51,7 +52,8 @@ static const int32_t Access_Credential_Properties_Required[] = {
     -1
 };
 
-static const int32_t Access_Credential_Properties_Optional[] = {
+static const int32_t Access_Credential_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DAYS_REMAINING,
@@ -74,7 +76,7 @@ static const int32_t Access_Credential_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Access_Door_Properties_Required[] = {
+static const int32_t Access_Door_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -93,7 +95,7 @@ static const int32_t Access_Door_Properties_Required[] = {
     -1
 };
 
-static const int32_t Access_Door_Properties_Optional[] = {
+static const int32_t Access_Door_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DOOR_STATUS,
@@ -132,7 +134,7 @@ static const int32_t Access_Door_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Access_Point_Properties_Required[] = {
+static const int32_t Access_Point_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -154,7 +156,7 @@ static const int32_t Access_Point_Properties_Required[] = {
     -1
 };
 
-static const int32_t Access_Point_Properties_Optional[] = {
+static const int32_t Access_Point_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_AUTHENTICATION_POLICY_LIST,
@@ -197,7 +199,8 @@ static const int32_t Access_Point_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Access_Rights_Properties_Required[] = {
+static const int32_t Access_Rights_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -211,7 +214,8 @@ static const int32_t Access_Rights_Properties_Required[] = {
     -1
 };
 
-static const int32_t Access_Rights_Properties_Optional[] = {
+static const int32_t Access_Rights_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_ACCOMPANIMENT,
@@ -224,14 +228,14 @@ static const int32_t Access_Rights_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Access_User_Properties_Required[] = {
+static const int32_t Access_User_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_GLOBAL_IDENTIFIER, PROP_STATUS_FLAGS, PROP_RELIABILITY,
     PROP_USER_TYPE,         PROP_CREDENTIALS,  -1
 };
 
-static const int32_t Access_User_Properties_Optional[] = {
+static const int32_t Access_User_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_USER_NAME,
@@ -248,7 +252,7 @@ static const int32_t Access_User_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Access_Zone_Properties_Required[] = {
+static const int32_t Access_Zone_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,     PROP_OBJECT_TYPE,
     PROP_GLOBAL_IDENTIFIER, PROP_OCCUPANCY_STATE, PROP_STATUS_FLAGS,
@@ -256,7 +260,7 @@ static const int32_t Access_Zone_Properties_Required[] = {
     PROP_ENTRY_POINTS,      PROP_EXIT_POINTS,     -1
 };
 
-static const int32_t Access_Zone_Properties_Optional[] = {
+static const int32_t Access_Zone_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_OCCUPANCY_COUNT,
@@ -293,7 +297,7 @@ static const int32_t Access_Zone_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Accumulator_Properties_Required[] = {
+static const int32_t Accumulator_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -308,7 +312,7 @@ static const int32_t Accumulator_Properties_Required[] = {
     -1
 };
 
-static const int32_t Accumulator_Properties_Optional[] = {
+static const int32_t Accumulator_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -347,7 +351,8 @@ static const int32_t Accumulator_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Alert_Enrollment_Properties_Required[] = {
+static const int32_t Alert_Enrollment_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,  PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,        PROP_PRESENT_VALUE,
@@ -357,7 +362,8 @@ static const int32_t Alert_Enrollment_Properties_Required[] = {
     PROP_EVENT_TIME_STAMPS,  -1
 };
 
-static const int32_t Alert_Enrollment_Properties_Optional[] = {
+static const int32_t Alert_Enrollment_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_MESSAGE_TEXTS,
@@ -372,14 +378,14 @@ static const int32_t Alert_Enrollment_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Analog_Input_Properties_Required[] = {
+static const int32_t Analog_Input_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, PROP_EVENT_STATE,
     PROP_OUT_OF_SERVICE,    PROP_UNITS,        -1
 };
 
-static const int32_t Analog_Input_Properties_Optional[] = {
+static const int32_t Analog_Input_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -417,7 +423,8 @@ static const int32_t Analog_Input_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Analog_Output_Properties_Required[] = {
+static const int32_t Analog_Output_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -435,7 +442,8 @@ static const int32_t Analog_Output_Properties_Required[] = {
     -1
 };
 
-static const int32_t Analog_Output_Properties_Optional[] = {
+static const int32_t Analog_Output_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -475,14 +483,14 @@ static const int32_t Analog_Output_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Analog_Value_Properties_Required[] = {
+static const int32_t Analog_Value_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, PROP_EVENT_STATE,
     PROP_OUT_OF_SERVICE,    PROP_UNITS,        -1
 };
 
-static const int32_t Analog_Value_Properties_Optional[] = {
+static const int32_t Analog_Value_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -525,7 +533,7 @@ static const int32_t Analog_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Averaging_Properties_Required[] = {
+static const int32_t Averaging_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,    PROP_OBJECT_TYPE,
     PROP_MINIMUM_VALUE,     PROP_AVERAGE_VALUE,  PROP_MAXIMUM_VALUE,
@@ -533,7 +541,7 @@ static const int32_t Averaging_Properties_Required[] = {
     PROP_WINDOW_INTERVAL,   PROP_WINDOW_SAMPLES, -1
 };
 
-static const int32_t Averaging_Properties_Optional[] = {
+static const int32_t Averaging_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_MINIMUM_VALUE_TIMESTAMP,
     PROP_VARIANCE_VALUE,
@@ -547,14 +555,14 @@ static const int32_t Averaging_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Binary_Input_Properties_Required[] = {
+static const int32_t Binary_Input_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, PROP_EVENT_STATE,
     PROP_OUT_OF_SERVICE,    PROP_POLARITY,     -1
 };
 
-static const int32_t Binary_Input_Properties_Optional[] = {
+static const int32_t Binary_Input_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -589,7 +597,8 @@ static const int32_t Binary_Input_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Binary_Lighting_Output_Properties_Required[] = {
+static const int32_t Binary_Lighting_Output_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -606,7 +615,8 @@ static const int32_t Binary_Lighting_Output_Properties_Required[] = {
     -1
 };
 
-static const int32_t Binary_Lighting_Output_Properties_Optional[] = {
+static const int32_t Binary_Lighting_Output_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -639,7 +649,8 @@ static const int32_t Binary_Lighting_Output_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Binary_Output_Properties_Required[] = {
+static const int32_t Binary_Output_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -657,7 +668,8 @@ static const int32_t Binary_Output_Properties_Required[] = {
     -1
 };
 
-static const int32_t Binary_Output_Properties_Optional[] = {
+static const int32_t Binary_Output_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -699,7 +711,7 @@ static const int32_t Binary_Output_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Binary_Value_Properties_Required[] = {
+static const int32_t Binary_Value_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,       PROP_PRESENT_VALUE,
@@ -707,7 +719,7 @@ static const int32_t Binary_Value_Properties_Required[] = {
     PROP_OUT_OF_SERVICE,    -1
 };
 
-static const int32_t Binary_Value_Properties_Optional[] = {
+static const int32_t Binary_Value_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -750,13 +762,15 @@ static const int32_t Binary_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t BitString_Value_Properties_Required[] = {
+static const int32_t BitString_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t BitString_Value_Properties_Optional[] = {
+static const int32_t BitString_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -792,13 +806,13 @@ static const int32_t BitString_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Calendar_Properties_Required[] = {
+static const int32_t Calendar_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME, PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_DATE_LIST,   -1
 };
 
-static const int32_t Calendar_Properties_Optional[] = {
+static const int32_t Calendar_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_AUDIT_LEVEL,
@@ -809,7 +823,7 @@ static const int32_t Calendar_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Channel_Properties_Required[] = {
+static const int32_t Channel_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -825,7 +839,7 @@ static const int32_t Channel_Properties_Required[] = {
     -1
 };
 
-static const int32_t Channel_Properties_Optional[] = {
+static const int32_t Channel_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -850,7 +864,7 @@ static const int32_t Channel_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Command_Properties_Required[] = {
+static const int32_t Command_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -862,7 +876,7 @@ static const int32_t Command_Properties_Required[] = {
     -1
 };
 
-static const int32_t Command_Properties_Optional[] = {
+static const int32_t Command_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_ACTION_TEXT,
@@ -887,13 +901,15 @@ static const int32_t Command_Properties_Optional[] = {
     -1
 };
 
-static const int32_t CharacterString_Value_Properties_Required[] = {
+static const int32_t CharacterString_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t CharacterString_Value_Properties_Optional[] = {
+static const int32_t CharacterString_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -929,7 +945,7 @@ static const int32_t CharacterString_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Color_Properties_Required[] = {
+static const int32_t Color_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,       PROP_PRESENT_VALUE,
@@ -938,7 +954,7 @@ static const int32_t Color_Properties_Required[] = {
     PROP_DEFAULT_FADE_TIME, -1
 };
 
-static const int32_t Color_Properties_Optional[] = {
+static const int32_t Color_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_RELIABILITY,  PROP_DESCRIPTION,
     PROP_TRANSITION,   PROP_VALUE_SOURCE,
@@ -947,7 +963,8 @@ static const int32_t Color_Properties_Optional[] = {
     PROP_PROFILE_NAME, -1
 };
 
-static const int32_t Color_Temperature_Properties_Required[] = {
+static const int32_t Color_Temperature_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -963,7 +980,8 @@ static const int32_t Color_Temperature_Properties_Required[] = {
     -1
 };
 
-static const int32_t Color_Temperature_Properties_Optional[] = {
+static const int32_t Color_Temperature_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_MIN_PRES_VALUE,
@@ -978,7 +996,8 @@ static const int32_t Color_Temperature_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Credential_Data_Input_Properties_Required[] = {
+static const int32_t Credential_Data_Input_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,       PROP_PRESENT_VALUE,
@@ -987,7 +1006,8 @@ static const int32_t Credential_Data_Input_Properties_Required[] = {
     PROP_UPDATE_TIME,       -1
 };
 
-static const int32_t Credential_Data_Input_Properties_Optional[] = {
+static const int32_t Credential_Data_Input_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_SUPPORTED_FORMAT_CLASSES,
@@ -1009,13 +1029,15 @@ static const int32_t Credential_Data_Input_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Date_Pattern_Value_Properties_Required[] = {
+static const int32_t Date_Pattern_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t Date_Pattern_Value_Properties_Optional[] = {
+static const int32_t Date_Pattern_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -1045,13 +1067,13 @@ static const int32_t Date_Pattern_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Date_Value_Properties_Required[] = {
+static const int32_t Date_Value_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t Date_Value_Properties_Optional[] = {
+static const int32_t Date_Value_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -1082,13 +1104,15 @@ static const int32_t Date_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t DateTime_Pattern_Value_Properties_Required[] = {
+static const int32_t DateTime_Pattern_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t DateTime_Pattern_Value_Properties_Optional[] = {
+static const int32_t DateTime_Pattern_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -1120,13 +1144,15 @@ static const int32_t DateTime_Pattern_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t DateTime_Value_Properties_Required[] = {
+static const int32_t DateTime_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t DateTime_Value_Properties_Optional[] = {
+static const int32_t DateTime_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -1158,7 +1184,7 @@ static const int32_t DateTime_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Device_Properties_Required[] = {
+static const int32_t Device_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1183,7 +1209,7 @@ static const int32_t Device_Properties_Required[] = {
     -1
 };
 
-static const int32_t Device_Properties_Optional[] = {
+static const int32_t Device_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_LOCATION,
     PROP_DESCRIPTION,
@@ -1240,7 +1266,8 @@ static const int32_t Device_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Elevator_Group_Properties_Required[] = {
+static const int32_t Elevator_Group_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1251,7 +1278,8 @@ static const int32_t Elevator_Group_Properties_Required[] = {
     -1
 };
 
-static const int32_t Elevator_Group_Properties_Optional[] = {
+static const int32_t Elevator_Group_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,   PROP_GROUP_MODE,
     PROP_LANDING_CALLS, PROP_LANDING_CALL_CONTROL,
@@ -1260,7 +1288,7 @@ static const int32_t Elevator_Group_Properties_Optional[] = {
     PROP_PROFILE_NAME,  -1
 };
 
-static const int32_t Escalator_Properties_Required[] = {
+static const int32_t Escalator_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1275,7 +1303,7 @@ static const int32_t Escalator_Properties_Required[] = {
     -1
 };
 
-static const int32_t Escalator_Properties_Optional[] = {
+static const int32_t Escalator_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_POWER_MODE,
@@ -1306,7 +1334,8 @@ static const int32_t Escalator_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Event_Enrollment_Properties_Required[] = {
+static const int32_t Event_Enrollment_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1326,7 +1355,8 @@ static const int32_t Event_Enrollment_Properties_Required[] = {
     -1
 };
 
-static const int32_t Event_Enrollment_Properties_Optional[] = {
+static const int32_t Event_Enrollment_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_MESSAGE_TEXTS,
@@ -1344,7 +1374,7 @@ static const int32_t Event_Enrollment_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Event_Log_Properties_Required[] = {
+static const int32_t Event_Log_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,        PROP_OBJECT_TYPE,
     PROP_STATUS_FLAGS,      PROP_EVENT_STATE,        PROP_ENABLE,
@@ -1352,7 +1382,7 @@ static const int32_t Event_Log_Properties_Required[] = {
     PROP_RECORD_COUNT,      PROP_TOTAL_RECORD_COUNT, -1
 };
 
-static const int32_t Event_Log_Properties_Optional[] = {
+static const int32_t Event_Log_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -1380,7 +1410,7 @@ static const int32_t Event_Log_Properties_Optional[] = {
     -1
 };
 
-static const int32_t File_Properties_Required[] = {
+static const int32_t File_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1394,7 +1424,7 @@ static const int32_t File_Properties_Required[] = {
     -1
 };
 
-static const int32_t File_Properties_Optional[] = {
+static const int32_t File_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,  PROP_RECORD_COUNT,
     PROP_AUDIT_LEVEL,  PROP_AUDITABLE_OPERATIONS,
@@ -1402,7 +1432,7 @@ static const int32_t File_Properties_Optional[] = {
     PROP_PROFILE_NAME, -1
 };
 
-static const int32_t Global_Group_Properties_Required[] = {
+static const int32_t Global_Group_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,       PROP_GROUP_MEMBERS,
@@ -1411,7 +1441,7 @@ static const int32_t Global_Group_Properties_Required[] = {
     PROP_OUT_OF_SERVICE,    -1
 };
 
-static const int32_t Global_Group_Properties_Optional[] = {
+static const int32_t Global_Group_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_GROUP_MEMBER_NAMES,
@@ -1443,13 +1473,13 @@ static const int32_t Global_Group_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Group_Properties_Required[] = {
+static const int32_t Group_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,     PROP_OBJECT_NAME,   PROP_OBJECT_TYPE,
     PROP_LIST_OF_GROUP_MEMBERS, PROP_PRESENT_VALUE, -1
 };
 
-static const int32_t Group_Properties_Optional[] = {
+static const int32_t Group_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_AUDIT_LEVEL,
@@ -1460,7 +1490,8 @@ static const int32_t Group_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Integer_Value_Properties_Required[] = {
+static const int32_t Integer_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1471,7 +1502,8 @@ static const int32_t Integer_Value_Properties_Required[] = {
     -1
 };
 
-static const int32_t Integer_Value_Properties_Optional[] = {
+static const int32_t Integer_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -1516,7 +1548,8 @@ static const int32_t Integer_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Large_Analog_Value_Properties_Required[] = {
+static const int32_t Large_Analog_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1527,7 +1560,8 @@ static const int32_t Large_Analog_Value_Properties_Required[] = {
     -1
 };
 
-static const int32_t Large_Analog_Value_Properties_Optional[] = {
+static const int32_t Large_Analog_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -1572,7 +1606,7 @@ static const int32_t Large_Analog_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Lift_Properties_Required[] = {
+static const int32_t Lift_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,    PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,          PROP_STATUS_FLAGS,
@@ -1583,7 +1617,7 @@ static const int32_t Lift_Properties_Required[] = {
     PROP_FAULT_SIGNALS,        -1
 };
 
-static const int32_t Lift_Properties_Optional[] = {
+static const int32_t Lift_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_FLOOR_TEXT,
@@ -1627,7 +1661,8 @@ static const int32_t Lift_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Lighting_Output_Properties_Required[] = {
+static const int32_t Lighting_Output_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1653,7 +1688,8 @@ static const int32_t Lighting_Output_Properties_Required[] = {
     -1
 };
 
-static const int32_t Lighting_Output_Properties_Optional[] = {
+static const int32_t Lighting_Output_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -1684,7 +1720,7 @@ static const int32_t Lighting_Output_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Load_Control_Properties_Required[] = {
+static const int32_t Load_Control_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1704,7 +1740,7 @@ static const int32_t Load_Control_Properties_Required[] = {
     -1
 };
 
-static const int32_t Load_Control_Properties_Optional[] = {
+static const int32_t Load_Control_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_STATE_DESCRIPTION,
@@ -1732,7 +1768,8 @@ static const int32_t Load_Control_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Life_Safety_Point_Properties_Required[] = {
+static const int32_t Life_Safety_Point_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,  PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,        PROP_PRESENT_VALUE,
@@ -1743,7 +1780,8 @@ static const int32_t Life_Safety_Point_Properties_Required[] = {
     PROP_OPERATION_EXPECTED, -1
 };
 
-static const int32_t Life_Safety_Point_Properties_Optional[] = {
+static const int32_t Life_Safety_Point_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -1777,7 +1815,8 @@ static const int32_t Life_Safety_Point_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Life_Safety_Zone_Properties_Required[] = {
+static const int32_t Life_Safety_Zone_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1796,7 +1835,8 @@ static const int32_t Life_Safety_Zone_Properties_Required[] = {
     -1
 };
 
-static const int32_t Life_Safety_Zone_Properties_Optional[] = {
+static const int32_t Life_Safety_Zone_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -1826,7 +1866,7 @@ static const int32_t Life_Safety_Zone_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Loop_Properties_Required[] = {
+static const int32_t Loop_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1847,7 +1887,7 @@ static const int32_t Loop_Properties_Required[] = {
     -1
 };
 
-static const int32_t Loop_Properties_Optional[] = {
+static const int32_t Loop_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -1886,14 +1926,16 @@ static const int32_t Loop_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Multistate_Input_Properties_Required[] = {
+static const int32_t Multistate_Input_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,      PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS,     PROP_EVENT_STATE,
     PROP_OUT_OF_SERVICE,    PROP_NUMBER_OF_STATES, -1
 };
 
-static const int32_t Multistate_Input_Properties_Optional[] = {
+static const int32_t Multistate_Input_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -1923,7 +1965,8 @@ static const int32_t Multistate_Input_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Multistate_Output_Properties_Required[] = {
+static const int32_t Multistate_Output_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -1941,7 +1984,8 @@ static const int32_t Multistate_Output_Properties_Required[] = {
     -1
 };
 
-static const int32_t Multistate_Output_Properties_Optional[] = {
+static const int32_t Multistate_Output_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_DEVICE_TYPE,
@@ -1975,14 +2019,16 @@ static const int32_t Multistate_Output_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Multistate_Value_Properties_Required[] = {
+static const int32_t Multistate_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,      PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS,     PROP_EVENT_STATE,
     PROP_OUT_OF_SERVICE,    PROP_NUMBER_OF_STATES, -1
 };
 
-static const int32_t Multistate_Value_Properties_Optional[] = {
+static const int32_t Multistate_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -2018,7 +2064,7 @@ static const int32_t Multistate_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Network_Port_Properties_Required[] = {
+static const int32_t Network_Port_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2038,7 +2084,7 @@ static const int32_t Network_Port_Properties_Required[] = {
     -1
 };
 
-static const int32_t Network_Port_Properties_Optional[] = {
+static const int32_t Network_Port_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_REFERENCE_PORT,
@@ -2109,7 +2155,8 @@ static const int32_t Network_Port_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Network_Security_Properties_Required[] = {
+static const int32_t Network_Security_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2128,7 +2175,8 @@ static const int32_t Network_Security_Properties_Required[] = {
     -1
 };
 
-static const int32_t Network_Security_Properties_Optional[] = {
+static const int32_t Network_Security_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_AUDIT_LEVEL,
@@ -2139,7 +2187,8 @@ static const int32_t Network_Security_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Notification_Class_Properties_Required[] = {
+static const int32_t Notification_Class_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,       PROP_NOTIFICATION_CLASS,
@@ -2147,7 +2196,8 @@ static const int32_t Notification_Class_Properties_Required[] = {
     PROP_RECIPIENT_LIST,    -1
 };
 
-static const int32_t Notification_Class_Properties_Optional[] = {
+static const int32_t Notification_Class_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_STATUS_FLAGS,
@@ -2169,7 +2219,8 @@ static const int32_t Notification_Class_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Notification_Forwarder_Properties_Required[] = {
+static const int32_t Notification_Forwarder_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2184,7 +2235,8 @@ static const int32_t Notification_Forwarder_Properties_Required[] = {
     -1
 };
 
-static const int32_t Notification_Forwarder_Properties_Optional[] = {
+static const int32_t Notification_Forwarder_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_PORT_FILTER,
@@ -2197,13 +2249,15 @@ static const int32_t Notification_Forwarder_Properties_Optional[] = {
     -1
 };
 
-static const int32_t OctetString_Value_Properties_Required[] = {
+static const int32_t OctetString_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t OctetString_Value_Properties_Optional[] = {
+static const int32_t OctetString_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -2226,7 +2280,8 @@ static const int32_t OctetString_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Positive_Integer_Value_Properties_Required[] = {
+static const int32_t Positive_Integer_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2237,7 +2292,8 @@ static const int32_t Positive_Integer_Value_Properties_Required[] = {
     -1
 };
 
-static const int32_t Positive_Integer_Value_Properties_Optional[] = {
+static const int32_t Positive_Integer_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -2282,7 +2338,7 @@ static const int32_t Positive_Integer_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Program_Properties_Required[] = {
+static const int32_t Program_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,       PROP_PROGRAM_STATE,
@@ -2290,7 +2346,7 @@ static const int32_t Program_Properties_Required[] = {
     PROP_OUT_OF_SERVICE,    -1
 };
 
-static const int32_t Program_Properties_Optional[] = {
+static const int32_t Program_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_REASON_FOR_HALT,
     PROP_DESCRIPTION_OF_HALT,
@@ -2316,7 +2372,8 @@ static const int32_t Program_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Pulse_Converter_Properties_Required[] = {
+static const int32_t Pulse_Converter_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2335,7 +2392,8 @@ static const int32_t Pulse_Converter_Properties_Required[] = {
     -1
 };
 
-static const int32_t Pulse_Converter_Properties_Optional[] = {
+static const int32_t Pulse_Converter_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_INPUT_REFERENCE,
@@ -2367,7 +2425,7 @@ static const int32_t Pulse_Converter_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Schedule_Properties_Required[] = {
+static const int32_t Schedule_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2383,7 +2441,7 @@ static const int32_t Schedule_Properties_Required[] = {
     -1
 };
 
-static const int32_t Schedule_Properties_Optional[] = {
+static const int32_t Schedule_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_WEEKLY_SCHEDULE,
@@ -2406,7 +2464,7 @@ static const int32_t Schedule_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Staging_Properties_Required[] = {
+static const int32_t Staging_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2426,7 +2484,7 @@ static const int32_t Staging_Properties_Required[] = {
     -1
 };
 
-static const int32_t Staging_Properties_Optional[] = {
+static const int32_t Staging_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_STAGE_NAMES,
     PROP_DESCRIPTION,
@@ -2450,13 +2508,15 @@ static const int32_t Staging_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Structured_View_Properties_Required[] = {
+static const int32_t Structured_View_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,      PROP_OBJECT_TYPE,
     PROP_NODE_TYPE,         PROP_SUBORDINATE_LIST, -1
 };
 
-static const int32_t Structured_View_Properties_Optional[] = {
+static const int32_t Structured_View_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_NODE_SUBTYPE,
@@ -2474,13 +2534,15 @@ static const int32_t Structured_View_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Time_Pattern_Value_Properties_Required[] = {
+static const int32_t Time_Pattern_Value_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t Time_Pattern_Value_Properties_Optional[] = {
+static const int32_t Time_Pattern_Value_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -2511,13 +2573,13 @@ static const int32_t Time_Pattern_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Time_Value_Properties_Required[] = {
+static const int32_t Time_Value_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,  PROP_OBJECT_TYPE,
     PROP_PRESENT_VALUE,     PROP_STATUS_FLAGS, -1
 };
 
-static const int32_t Time_Value_Properties_Optional[] = {
+static const int32_t Time_Value_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -2548,7 +2610,7 @@ static const int32_t Time_Value_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Timer_Properties_Required[] = {
+static const int32_t Timer_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME,
     PROP_OBJECT_TYPE,       PROP_PRESENT_VALUE,
@@ -2556,7 +2618,7 @@ static const int32_t Timer_Properties_Required[] = {
     PROP_TIMER_RUNNING,     -1
 };
 
-static const int32_t Timer_Properties_Optional[] = {
+static const int32_t Timer_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_EVENT_STATE,
@@ -2595,7 +2657,7 @@ static const int32_t Timer_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Trend_Log_Properties_Required[] = {
+static const int32_t Trend_Log_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2612,7 +2674,7 @@ static const int32_t Trend_Log_Properties_Required[] = {
     -1
 };
 
-static const int32_t Trend_Log_Properties_Optional[] = {
+static const int32_t Trend_Log_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_START_TIME,
@@ -2647,7 +2709,8 @@ static const int32_t Trend_Log_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Trend_Log_Multiple_Properties_Required[] = {
+static const int32_t Trend_Log_Multiple_Properties_Required[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2666,7 +2729,8 @@ static const int32_t Trend_Log_Multiple_Properties_Required[] = {
     -1
 };
 
-static const int32_t Trend_Log_Multiple_Properties_Optional[] = {
+static const int32_t Trend_Log_Multiple_Properties_Optional[]
+    BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -2697,7 +2761,7 @@ static const int32_t Trend_Log_Multiple_Properties_Optional[] = {
     -1
 };
 
-static const int32_t Audit_Log_Properties_Required[] = {
+static const int32_t Audit_Log_Properties_Required[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME,
@@ -2712,7 +2776,7 @@ static const int32_t Audit_Log_Properties_Required[] = {
     -1
 };
 
-static const int32_t Audit_Log_Properties_Optional[] = {
+static const int32_t Audit_Log_Properties_Optional[] BACNET_STACK_PROGMEM = {
     /* unordered list of properties */
     PROP_DESCRIPTION,
     PROP_RELIABILITY,
@@ -2736,6 +2800,40 @@ static const int32_t Audit_Log_Properties_Optional[] = {
     -1
 };
 
+#if BACNET_STACK_PROGMEM_ENABLED
+/* the lists are kept in program memory, and are copied to RAM to be
+   returned, since the API gives a pointer to the list */
+#ifndef PROPERTY_LIST_PROGMEM_MAX
+#define PROPERTY_LIST_PROGMEM_MAX 72
+#endif
+static int32_t Property_List_Required_RAM[PROPERTY_LIST_PROGMEM_MAX];
+static int32_t Property_List_Optional_RAM[PROPERTY_LIST_PROGMEM_MAX];
+
+/**
+ * @brief Copy a '-1' terminated list from program memory to RAM
+ * @param buffer [out] the RAM buffer of PROPERTY_LIST_PROGMEM_MAX entries
+ * @param pList [in] the list in program memory
+ * @return the buffer, which is always '-1' terminated
+ */
+static const int32_t *property_list_progmem_copy(
+    int32_t *buffer, const int32_t *pList)
+{
+    unsigned i;
+    int32_t property;
+
+    for (i = 0; i < (PROPERTY_LIST_PROGMEM_MAX - 1); i++) {
+        property = (int32_t)bacnet_progmem_uint32(&pList[i]);
+        if (property == -1) {
+            break;
+        }
+        buffer[i] = property;
+    }
+    buffer[i] = -1;
+
+    return buffer;
+}
+#endif
+
 /**
  * Function that returns the list of all Optional properties
  * of known standard objects.
@@ -2743,7 +2841,8 @@ static const int32_t Audit_Log_Properties_Optional[] = {
  * @param object_type - enumerated BACNET_OBJECT_TYPE
  * @return returns a pointer to a '-1' terminated array of
  * type 'int32_t' that contain BACnet object properties for the given object
- * type.
+ * type. With BACNET_STACK_PROGMEM_ENABLED, the list is a copy in RAM that
+ * is valid until the next call.
  */
 const int32_t *property_list_optional(BACNET_OBJECT_TYPE object_type)
 {
@@ -2946,6 +3045,9 @@ const int32_t *property_list_optional(BACNET_OBJECT_TYPE object_type)
             pList = Default_Properties_Optional;
             break;
     }
+#if BACNET_STACK_PROGMEM_ENABLED
+    pList = property_list_progmem_copy(Property_List_Optional_RAM, pList);
+#endif
 
     return pList;
 }
@@ -2957,7 +3059,8 @@ const int32_t *property_list_optional(BACNET_OBJECT_TYPE object_type)
  * @param object_type - enumerated BACNET_OBJECT_TYPE
  * @return returns a pointer to a '-1' terminated array of
  * type 'int32_t' that contain BACnet object properties for the given object
- * type.
+ * type. With BACNET_STACK_PROGMEM_ENABLED, the list is a copy in RAM that
+ * is valid until the next call.
  */
 const int32_t *property_list_required(BACNET_OBJECT_TYPE object_type)
 {
@@ -3160,6 +3263,9 @@ const int32_t *property_list_required(BACNET_OBJECT_TYPE object_type)
             pList = Default_Properties_Required;
             break;
     }
+#if BACNET_STACK_PROGMEM_ENABLED
+    pList = property_list_progmem_copy(Property_List_Required_RAM, pList);
+#endif
 
     return pList;
 }
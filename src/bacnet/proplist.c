@@ -6,6 +6,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -89,6 +90,83 @@ bool property_lists_member(
     return found;
 }
 
+/**
+ * @brief Initialize an empty property list set
+ * @param set - property list set to be initialized
+ */
+void property_list_set_init(struct property_list_set *set)
+{
+    if (set) {
+        memset(set, 0, sizeof(*set));
+    }
+}
+
+/**
+ * @brief Add the members of a property list to a property list set
+ * @param set - property list set to add the members to
+ * @param pList - array of type 'int32_t' that is a list of BACnet object
+ * properties, terminated by a '-1' value. The list must stay valid
+ * while the set is used, since members above the bitset are not copied.
+ * @return true if the members were added, false if the list has members
+ * above the bitset and there is no room to scan another list
+ */
+bool property_list_set_add(struct property_list_set *set, const int32_t *pList)
+{
+    const int32_t *pMember;
+    bool scan = false;
+
+    if (!set) {
+        return false;
+    }
+    if (!pList) {
+        return true;
+    }
+    for (pMember = pList; *pMember != -1; pMember++) {
+        if ((*pMember >= 0) && (*pMember < PROP_PROPRIETARY_RANGE_MIN)) {
+            set->bits[*pMember / 8] |= (uint8_t)(1 << (*pMember % 8));
+        } else {
+            scan = true;
+        }
+    }
+    if (scan) {
+        if (set->scan_count >= PROPERTY_LIST_SET_SCAN_MAX) {
+            return false;
+        }
+        set->pScan[set->scan_count] = pList;
+        set->scan_count++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Determine if the object property is a member of any of the lists
+ * that were added to a property list set
+ * @param set - property list set to be checked
+ * @param object_property - property enumeration or propritary value
+ * @return true if object_property is a member of the property list set
+ */
+bool property_list_set_member(
+    const struct property_list_set *set, int32_t object_property)
+{
+    uint8_t i;
+
+    if (!set || (object_property < 0)) {
+        return false;
+    }
+    if (object_property < PROP_PROPRIETARY_RANGE_MIN) {
+        return (set->bits[object_property / 8] &
+                (1 << (object_property % 8))) != 0;
+    }
+    for (i = 0; i < set->scan_count; i++) {
+        if (property_list_member(set->pScan[i], object_property)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /**
  * ReadProperty handler for this property.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
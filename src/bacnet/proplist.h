@@ -26,6 +26,20 @@ struct special_property_list_t {
     struct property_list_t Proprietary;
 };
 
+/* number of lists with members above the bitset that a set can scan */
+#ifndef PROPERTY_LIST_SET_SCAN_MAX
+#define PROPERTY_LIST_SET_SCAN_MAX 3
+#endif
+
+/* One or more property lists compiled for O(1) membership tests.
+   The standard properties below PROP_PROPRIETARY_RANGE_MIN are kept
+   in a bitset, and the few lists with members above it are scanned. */
+struct property_list_set {
+    uint8_t bits[PROP_PROPRIETARY_RANGE_MIN / 8];
+    const int32_t *pScan[PROPERTY_LIST_SET_SCAN_MAX];
+    uint8_t scan_count;
+};
+
 /**
  * @brief Callback function type for fetching a property list for a given
  * object instance.
@@ -59,6 +73,13 @@ bool property_lists_member(
     const int32_t *pProprietary,
     int32_t object_property);
 BACNET_STACK_EXPORT
+void property_list_set_init(struct property_list_set *set);
+BACNET_STACK_EXPORT
+bool property_list_set_add(struct property_list_set *set, const int32_t *pList);
+BACNET_STACK_EXPORT
+bool property_list_set_member(
+    const struct property_list_set *set, int32_t object_property);
+BACNET_STACK_EXPORT
 int property_list_encode(
     BACNET_READ_PROPERTY_DATA *rpdata,
     const int32_t *pListRequired,
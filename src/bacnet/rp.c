@@ -101,13 +101,8 @@ int rp_encode_apdu(
     int len = 0; /* length of each encoding */
     int apdu_len = 0; /* total length of the apdu, return value */
 
-    if (apdu) {
-        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
-        apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
-        apdu[2] = invoke_id;
-        apdu[3] = SERVICE_CONFIRMED_READ_PROPERTY; /* service choice */
-    }
-    len = 4;
+    len = encode_confirmed_request_header(
+        apdu, invoke_id, SERVICE_CONFIRMED_READ_PROPERTY);
     apdu_len += len;
     if (apdu) {
         apdu += len;
@@ -29,14 +29,8 @@
  */
 int rpm_encode_apdu_init(uint8_t *apdu, uint8_t invoke_id)
 {
-    if (apdu) {
-        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
-        apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
-        apdu[2] = invoke_id;
-        apdu[3] = SERVICE_CONFIRMED_READ_PROP_MULTIPLE; /* service choice */
-    }
-
-    return 4;
+    return encode_confirmed_request_header(
+        apdu, invoke_id, SERVICE_CONFIRMED_READ_PROP_MULTIPLE);
 }
 
 /** Encode the beginning, including
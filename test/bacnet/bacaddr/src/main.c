@@ -156,6 +156,18 @@ static void test_BACNET_ADDRESS(void)
     bacnet_address_router_set(&dest, &src);
     zassert_equal(dest.mac_len, 6, "len=%d", dest.mac_len);
     zassert_equal(dest.len, 0, NULL);
+    /* the same addresses have the same hash */
+    bacnet_address_from_ascii(&src, "{192.168.1.1:47808,0,0}");
+    bacnet_address_copy(&dest, &src);
+    /* fields that are not compared do not change the hash */
+    dest.mac[MAX_MAC_LEN - 1] = 0xFF;
+    dest.adr[0] = 0xFF;
+    zassert_true(bacnet_address_same(&dest, &src), NULL);
+    zassert_equal(bacnet_address_hash(&dest), bacnet_address_hash(&src), NULL);
+    dest.net = 1;
+    zassert_not_equal(
+        bacnet_address_hash(&dest), bacnet_address_hash(&src), NULL);
+    zassert_equal(bacnet_address_hash(NULL), 2166136261UL, NULL);
 }
 
 #if defined(CONFIG_ZTEST_NEW_API)
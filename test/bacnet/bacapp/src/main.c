@@ -6,6 +6,7 @@
  * @copyright SPDX-License-Identifier: MIT
  */
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <zephyr/ztest.h>
 #include <bacnet/bacdcode.h>
@@ -1523,6 +1524,118 @@ static void test_bacapp_sprintf_epics(void)
         BACNET_APPLICATION_TAG_OBJECT_ID, "0:0", "(analog-input, 0)");
 }
 
+/**
+ * @brief Helper function to test bacapp_snprintf_value_json()
+ * @param tag_number [in] The BACnet application tag to test
+ * @param argv [in] The string to parse into a BACNET_APPLICATION_DATA_VALUE
+ * @param expected [in] The expected string output
+ */
+static void test_bacapp_snprintf_json(
+    BACNET_APPLICATION_TAG tag_number, char *argv, const char *expected)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    char str[80] = { 0 };
+    int str_len = 0, len, test_len;
+
+    object_value.object_type = OBJECT_DEVICE;
+    object_value.object_property = PROP_SEGMENTATION_SUPPORTED;
+    object_value.array_index = BACNET_ARRAY_ALL;
+    object_value.value = &value;
+    zassert_true(bacapp_parse_application_data(tag_number, argv, &value), NULL);
+    str_len = bacapp_snprintf_value_json(NULL, 0, &object_value);
+    zassert_equal(str_len, strlen(expected), "expected='%s'", expected);
+    zassert_true(str_len < (int)sizeof(str), NULL);
+    len = bacapp_snprintf_value_json(str, sizeof(str), &object_value);
+    zassert_equal(len, str_len, NULL);
+    zassert_equal(
+        strcmp(str, expected), 0, "str='%s' expected='%s'", str, expected);
+    /* when the buffer is too small the behavior matches snprintf() */
+    for (test_len = str_len; test_len > 0; test_len--) {
+        memset(str, 'X', sizeof(str));
+        len = bacapp_snprintf_value_json(str, test_len, &object_value);
+        zassert_equal(len, str_len, NULL);
+        zassert_equal(str[test_len - 1], 0, NULL);
+        zassert_equal(strncmp(str, expected, test_len - 1), 0, NULL);
+    }
+}
+
+/**
+ * @brief Test the JSON text of the values
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacapp_tests, test_bacapp_sprintf_json)
+#else
+static void test_bacapp_sprintf_json(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    BACAPP_TEXT text = { 0 };
+    char bytes[] = { 'a', 0x01, (char)0xC3, (char)0xA9 };
+
+    test_bacapp_snprintf_json(BACNET_APPLICATION_TAG_NULL, NULL, "null");
+    test_bacapp_snprintf_json(BACNET_APPLICATION_TAG_BOOLEAN, "true", "true");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_BOOLEAN, "false", "false");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_UNSIGNED_INT, "4294967295", "4294967295");
+    test_bacapp_snprintf_json(BACNET_APPLICATION_TAG_UNSIGNED_INT, "0", "0");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_SIGNED_INT, "-2147483648", "-2147483648");
+    test_bacapp_snprintf_json(BACNET_APPLICATION_TAG_SIGNED_INT, "42", "42");
+    /* the fewest digits that read back as the same value */
+    test_bacapp_snprintf_json(BACNET_APPLICATION_TAG_REAL, "0.0", "0");
+    test_bacapp_snprintf_json(BACNET_APPLICATION_TAG_REAL, "21.5", "21.5");
+    test_bacapp_snprintf_json(BACNET_APPLICATION_TAG_REAL, "0.1", "0.1");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_REAL, "-3.14159", "-3.14159");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_REAL, "16777217", "16777216");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_REAL, "0.123456789", "0.12345679");
+    test_bacapp_snprintf_json(BACNET_APPLICATION_TAG_DOUBLE, "0.1", "0.1");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_DOUBLE, "0.30000000000000004",
+        "0.30000000000000004");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_OCTET_STRING, "1234567890ABCDEF",
+        "\"1234567890ABCDEF\"");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_CHARACTER_STRING, "say \"hi\"\\\t",
+        "\"say \\\"hi\\\"\\\\\\t\"");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_BIT_STRING, "101", "[true,false,true]");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_ENUMERATED, "0", "\"segmented-both\"");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_DATE, "2005/5/22:1",
+        "\"Monday, May 22, 2005\"");
+    test_bacapp_snprintf_json(
+        BACNET_APPLICATION_TAG_OBJECT_ID, "8:4194303",
+        "\"(device, 4194303)\"");
+    /* control characters are escaped, and UTF-8 is kept */
+    object_value.value = &value;
+    value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init(
+        &value.type.Character_String, CHARACTER_UTF8, bytes, sizeof(bytes));
+    zassert_true(bacapp_text_value_append(&text, &object_value, true), NULL);
+    zassert_equal(text.length, 11, NULL);
+    zassert_equal(strcmp(text.data, "\"a\\u0001\xC3\xA9\""), 0, NULL);
+    /* the text grows as the values are appended */
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 1234567890;
+    while (text.length < 1000) {
+        zassert_true(
+            bacapp_text_value_append(&text, &object_value, false), NULL);
+    }
+    zassert_true(text.size > text.length, NULL);
+    zassert_equal(text.length, 11 + (99 * 10), NULL);
+    zassert_equal(strcmp(&text.data[text.length - 10], "1234567890"), 0, NULL);
+    zassert_false(bacapp_text_value_append(NULL, &object_value, false), NULL);
+    free(text.data);
+}
+
 /**
  * @}
  */
@@ -1543,7 +1656,8 @@ void test_main(void)
         ztest_unit_test(testBACnetApplicationDataLength),
         ztest_unit_test(testBACnetApplicationData_Safe),
         ztest_unit_test(test_bacapp_data),
-        ztest_unit_test(test_bacapp_sprintf_epics));
+        ztest_unit_test(test_bacapp_sprintf_epics),
+        ztest_unit_test(test_bacapp_sprintf_json));
 
     ztest_run_test_suite(bacapp_tests);
 }
@@ -154,6 +154,93 @@ static void test_bacnet_audit_log_notification(void)
     zassert_equal(test_len, apdu_len, NULL);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacnet_audit_tests, test_bacnet_audit_notification_request)
+#else
+static void test_bacnet_audit_notification_request(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t body[MAX_APDU] = { 0 };
+    BACNET_AUDIT_NOTIFICATION value[3] = { 0 }, test_value[3] = { 0 };
+    int apdu_len = 0, null_len = 0, test_len = 0, body_len = 0;
+    size_t len = 0;
+    unsigned i = 0, count = 0;
+
+    for (i = 0; i < 3; i++) {
+        value[i].source_device.tag = BACNET_RECIPIENT_TAG_DEVICE;
+        value[i].source_device.type.device.type = OBJECT_DEVICE;
+        value[i].source_device.type.device.instance = 1234;
+        value[i].target_device.tag = BACNET_RECIPIENT_TAG_DEVICE;
+        value[i].target_device.type.device.type = OBJECT_DEVICE;
+        value[i].target_device.type.device.instance = 5678 + i;
+        value[i].operation = AUDIT_OPERATION_WRITE;
+        value[i].target_value.tag = BACNET_APPLICATION_TAG_REAL;
+        value[i].target_value.type.real_value = 1.0f + i;
+    }
+    null_len = bacnet_audit_notification_request_encode(NULL, value, 3);
+    apdu_len = bacnet_audit_notification_request_encode(apdu, value, 3);
+    zassert_equal(apdu_len, null_len, NULL);
+    zassert_true(apdu_len > 0, NULL);
+    test_len = bacnet_audit_notification_request_decode(
+        apdu, apdu_len, test_value, 3, &count);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(count, 3, NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_true(
+            bacnet_audit_log_notification_same(&value[i], &test_value[i]),
+            NULL);
+    }
+    /* decoding, some negative tests */
+    test_len = bacnet_audit_notification_request_decode(
+        apdu, apdu_len, test_value, 2, &count);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    test_len = bacnet_audit_notification_request_decode(
+        apdu, apdu_len, NULL, 0, &count);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(count, 3, NULL);
+    while (--apdu_len) {
+        test_len = bacnet_audit_notification_request_decode(
+            apdu, apdu_len, test_value, 3, &count);
+        zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    }
+    test_len = bacnet_audit_notification_request_decode(
+        NULL, 0, test_value, 3, &count);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    zassert_equal(
+        bacnet_audit_notification_request_encode(apdu, value, 0), 0, NULL);
+
+    /* a body of notifications encoded ahead of time */
+    for (i = 0; i < 3; i++) {
+        body_len +=
+            bacnet_audit_log_notification_encode(&body[body_len], &value[i]);
+    }
+    len = bacnet_audit_notification_apdu_body_encode(
+        NULL, sizeof(apdu), true, 1, body, body_len);
+    zassert_equal(len, 4 + null_len, NULL);
+    len = bacnet_audit_notification_apdu_body_encode(
+        apdu, sizeof(apdu), true, 1, body, body_len);
+    zassert_equal(len, 4 + null_len, NULL);
+    zassert_equal(apdu[0], PDU_TYPE_CONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(apdu[2], 1, NULL);
+    zassert_equal(apdu[3], SERVICE_CONFIRMED_AUDIT_NOTIFICATION, NULL);
+    test_len = bacnet_audit_notification_request_decode(
+        &apdu[4], len - 4, test_value, 3, &count);
+    zassert_equal(test_len, null_len, NULL);
+    zassert_equal(count, 3, NULL);
+    len = bacnet_audit_notification_apdu_body_encode(
+        apdu, sizeof(apdu), false, 0, body, body_len);
+    zassert_equal(len, 2 + null_len, NULL);
+    zassert_equal(apdu[0], PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(apdu[1], SERVICE_UNCONFIRMED_AUDIT_NOTIFICATION, NULL);
+    len = bacnet_audit_notification_apdu_body_encode(
+        apdu, 4 + null_len - 1, true, 1, body, body_len);
+    zassert_equal(len, 0, NULL);
+    len = bacnet_audit_notification_apdu_body_encode(
+        apdu, sizeof(apdu), true, 1, NULL, 0);
+    zassert_equal(len, 0, NULL);
+}
+
 uint8_t Test_APDU[MAX_APDU];
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(bacnet_audit_tests, test_bacnet_audit_log_record)
@@ -252,6 +339,7 @@ void test_main(void)
     ztest_test_suite(
         bacnet_audit_tests, ztest_unit_test(test_bacnet_audit_log_record),
         ztest_unit_test(test_bacnet_audit_log_notification),
+        ztest_unit_test(test_bacnet_audit_notification_request),
         ztest_unit_test(test_bacnet_audit_value));
 
     ztest_run_test_suite(bacnet_audit_tests);
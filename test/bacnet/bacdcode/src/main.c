@@ -1391,6 +1391,7 @@ static void testBACDCodeMaxSegsApdu(void)
     int i = 0;
     int j = 0;
     uint8_t octet = 0;
+    uint8_t apdu[4] = { 0 };
 
     /* test */
     for (i = 0; i < 8; i++) {
@@ -1400,6 +1401,30 @@ static void testBACDCodeMaxSegsApdu(void)
             zassert_equal(max_apdu[j], decode_max_apdu(octet), NULL);
         }
     }
+    /* the header of a confirmed request */
+    zassert_equal(
+        encode_confirmed_request_header(
+            NULL, 1, SERVICE_CONFIRMED_READ_PROPERTY),
+        4, NULL);
+    zassert_equal(
+        encode_confirmed_request_header(
+            apdu, 1, SERVICE_CONFIRMED_READ_PROPERTY),
+        4, NULL);
+    zassert_equal(apdu[0] & 0xF0, PDU_TYPE_CONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(decode_max_apdu(apdu[1]), MAX_APDU, NULL);
+    zassert_equal(apdu[2], 1, NULL);
+    zassert_equal(apdu[3], SERVICE_CONFIRMED_READ_PROPERTY, NULL);
+#if BACNET_SEGMENTATION_ENABLED
+    zassert_true(apdu[0] & BIT(1), NULL);
+    zassert_equal(
+        decode_max_segs(apdu[1]),
+        decode_max_segs(
+            encode_max_segs_max_apdu(BACNET_MAX_SEGMENTS_ACCEPTED, MAX_APDU)),
+        NULL);
+#else
+    zassert_false(apdu[0] & BIT(1), NULL);
+    zassert_equal(decode_max_segs(apdu[1]), 0, NULL);
+#endif
 }
 
 #if defined(CONFIG_ZTEST_NEW_API)
@@ -2348,6 +2373,224 @@ static void test_bacnet_enclosed_data_length(void)
     }
 }
 
+/**
+ * @brief The tag by tag walk of bacnet_enclosed_data_length(), kept as
+ *  the reference for the equivalence test of the fast skipper
+ */
+static int test_enclosed_data_length_reference(
+    const uint8_t *apdu, size_t apdu_size)
+{
+    int len = 0;
+    int total_len = 0;
+    int apdu_len = 0;
+    BACNET_TAG tag = { 0 };
+    uint8_t opening_tag_number = 0;
+    uint8_t opening_tag_number_counter = 0;
+    bool total_len_enable = false;
+
+    if (!apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (apdu_size <= apdu_len) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (!bacnet_is_opening_tag(apdu, apdu_size)) {
+        return BACNET_STATUS_ERROR;
+    }
+    do {
+        len = bacnet_tag_decode(apdu, apdu_size - apdu_len, &tag);
+        if (len == 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        if (tag.opening) {
+            if (opening_tag_number_counter == 0) {
+                opening_tag_number = tag.number;
+                opening_tag_number_counter = 1;
+                total_len_enable = false;
+            } else if (tag.number == opening_tag_number) {
+                total_len_enable = true;
+                opening_tag_number_counter++;
+            } else {
+                total_len_enable = true;
+            }
+        } else if (tag.closing) {
+            if (tag.number == opening_tag_number) {
+                if (opening_tag_number_counter > 0) {
+                    opening_tag_number_counter--;
+                }
+            }
+            total_len_enable = true;
+        } else if (tag.context) {
+            if (tag.len_value_type > INT_MAX) {
+                return BACNET_STATUS_ERROR;
+            }
+            len += tag.len_value_type;
+            total_len_enable = true;
+        } else {
+            if (tag.len_value_type > INT_MAX) {
+                return BACNET_STATUS_ERROR;
+            }
+            len +=
+                bacnet_application_data_length(tag.number, tag.len_value_type);
+            total_len_enable = true;
+        }
+        if (opening_tag_number_counter > 0) {
+            if (len > 0) {
+                if (total_len_enable) {
+                    total_len += len;
+                }
+            } else {
+                return BACNET_STATUS_ERROR;
+            }
+            apdu_len += len;
+            if (apdu_size <= apdu_len) {
+                return BACNET_STATUS_ERROR;
+            }
+            apdu += len;
+        }
+    } while (opening_tag_number_counter > 0);
+
+    return total_len;
+}
+
+static uint32_t Test_Random_Seed = 1;
+/**
+ * @brief Simple repeatable pseudo random numbers for the fuzz test
+ * @return pseudo random number 0..32767
+ */
+static uint32_t test_random(void)
+{
+    Test_Random_Seed = (Test_Random_Seed * 1103515245UL) + 12345UL;
+
+    return (Test_Random_Seed >> 16) & 0x7FFF;
+}
+
+/**
+ * @brief Encode a random tag number, mostly small
+ * @return tag number
+ */
+static uint8_t test_random_tag_number(void)
+{
+    if ((test_random() % 8) == 0) {
+        return (uint8_t)(test_random() % 256);
+    }
+
+    return (uint8_t)(test_random() % 16);
+}
+
+/**
+ * @brief Encode random tagged data enclosed in an opening and closing
+ *  tag, with nested constructed data
+ * @param apdu - buffer for the data
+ * @param apdu_size - size of the buffer, at least 64 octets
+ * @return number of octets encoded
+ */
+static int test_random_enclosed_encode(uint8_t *apdu, int apdu_size)
+{
+    uint8_t tag_stack[8];
+    unsigned depth = 0;
+    uint32_t len_value_type, i;
+    int len = 0;
+
+    tag_stack[depth] = test_random_tag_number();
+    len += encode_opening_tag(&apdu[len], tag_stack[depth]);
+    depth++;
+    while ((len + 24) < apdu_size) {
+        switch (test_random() % 6) {
+            case 0:
+                if (depth < sizeof(tag_stack)) {
+                    tag_stack[depth] = test_random_tag_number();
+                    len += encode_opening_tag(&apdu[len], tag_stack[depth]);
+                    depth++;
+                }
+                break;
+            case 1:
+                if (depth > 1) {
+                    depth--;
+                    len += encode_closing_tag(&apdu[len], tag_stack[depth]);
+                }
+                break;
+            default:
+                if ((test_random() % 8) == 0) {
+                    len_value_type = test_random() % 300;
+                } else {
+                    len_value_type = test_random() % 8;
+                }
+                if ((len + 8 + len_value_type) >= (uint32_t)apdu_size) {
+                    len_value_type = 0;
+                }
+                len += encode_tag(
+                    &apdu[len], test_random_tag_number(),
+                    (test_random() % 2) == 0, len_value_type);
+                for (i = 0; i < len_value_type; i++) {
+                    apdu[len++] = (uint8_t)test_random();
+                }
+                break;
+        }
+        if ((test_random() % 16) == 0) {
+            break;
+        }
+    }
+    while (depth > 0) {
+        depth--;
+        len += encode_closing_tag(&apdu[len], tag_stack[depth]);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Test the fast skipper of bacnet_enclosed_data_length() against
+ *  the tag by tag walk, with random and corrupted tagged data
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_enclosed_data_length_fuzz)
+#else
+static void test_bacnet_enclosed_data_length_fuzz(void)
+#endif
+{
+    uint8_t apdu[480] = { 0 };
+    int apdu_len, apdu_size, test_len, ref_len;
+    unsigned i, j, valid = 0;
+
+    for (i = 0; i < 20000; i++) {
+        apdu_len = test_random_enclosed_encode(apdu, sizeof(apdu));
+        apdu_size = apdu_len;
+        switch (i % 4) {
+            case 0:
+                /* as encoded */
+                break;
+            case 1:
+                /* some of the octets changed */
+                for (j = 0; j < 1 + (test_random() % 4); j++) {
+                    apdu[test_random() % apdu_len] = (uint8_t)test_random();
+                }
+                break;
+            case 2:
+                /* truncated */
+                apdu_size = test_random() % (apdu_len + 1);
+                break;
+            default:
+                /* random octets after a valid opening tag */
+                for (j = 1; j < (unsigned)apdu_len; j++) {
+                    apdu[j] = (uint8_t)test_random();
+                }
+                break;
+        }
+        ref_len = test_enclosed_data_length_reference(apdu, apdu_size);
+        test_len = bacnet_enclosed_data_length(apdu, apdu_size);
+        zassert_equal(
+            test_len, ref_len, "i=%u size=%d test=%d ref=%d", i, apdu_size,
+            test_len, ref_len);
+        if (ref_len >= 0) {
+            valid++;
+        }
+    }
+    /* the comparison covered both results */
+    zassert_true(valid > 5000, "valid=%u", valid);
+    zassert_true(valid < 19000, "valid=%u", valid);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(bacdcode_tests, test_octet_string_buffer)
 #else
@@ -2490,6 +2733,75 @@ static void test_bacnet_character_string_buffer(void)
     }
 }
 
+/**
+ * @brief Test the encoding and decoding of character string views
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_character_string_view)
+#else
+static void test_bacnet_character_string_view(void)
+#endif
+{
+    uint8_t apdu[50] = { 0 }, test_apdu[50] = { 0 };
+    BACNET_CHARACTER_STRING_VIEW value = { 0 }, test_value = { 0 };
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    int apdu_len = 0, null_len = 0, test_len = 0;
+    const char *name = "ANALOG INPUT 1";
+    uint8_t tag_number = 5;
+
+    characterstring_view_init_ansi(&value, name);
+    characterstring_init_ansi(&char_string, name);
+    /* the same encoding as a BACnet character string */
+    apdu_len = encode_application_character_string_view(apdu, &value);
+    null_len = encode_application_character_string_view(NULL, &value);
+    zassert_equal(apdu_len, null_len, NULL);
+    test_len = encode_application_character_string(test_apdu, &char_string);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(memcmp(apdu, test_apdu, apdu_len), 0, NULL);
+    null_len = bacnet_character_string_view_application_encode(
+        apdu, apdu_len - 1, &value);
+    zassert_equal(null_len, 0, NULL);
+    null_len = bacnet_character_string_view_application_encode(
+        apdu, sizeof(apdu), &value);
+    zassert_equal(null_len, apdu_len, NULL);
+    /* the decoded view refers to the APDU */
+    test_len = bacnet_character_string_view_application_decode(
+        apdu, apdu_len, &test_value);
+    zassert_equal(test_len, apdu_len, NULL);
+    zassert_equal(test_value.value, (const char *)&apdu[apdu_len - 14], NULL);
+    zassert_true(characterstring_view_same(&test_value, &char_string), NULL);
+    test_len = bacnet_character_string_view_application_decode(
+        apdu, apdu_len - 1, &test_value);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    test_len = bacnet_character_string_view_context_decode(
+        apdu, apdu_len, tag_number, &test_value);
+    zassert_equal(test_len, 0, NULL);
+    /* context tagged */
+    apdu_len = encode_context_character_string_view(apdu, tag_number, &value);
+    null_len = encode_context_character_string_view(NULL, tag_number, &value);
+    zassert_equal(apdu_len, null_len, NULL);
+    test_len = encode_context_character_string(
+        test_apdu, tag_number, &char_string);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(memcmp(apdu, test_apdu, apdu_len), 0, NULL);
+    test_len = bacnet_character_string_view_context_decode(
+        apdu, apdu_len, tag_number, &test_value);
+    zassert_equal(test_len, apdu_len, NULL);
+    zassert_true(characterstring_view_ansi_same(&test_value, name), NULL);
+    test_len = bacnet_character_string_view_application_decode(
+        apdu, apdu_len, &test_value);
+    zassert_equal(test_len, 0, NULL);
+    /* an empty string */
+    characterstring_view_init_ansi(&value, "");
+    apdu_len = encode_application_character_string_view(apdu, &value);
+    zassert_equal(apdu_len, 2, NULL);
+    test_len = bacnet_character_string_view_application_decode(
+        apdu, apdu_len, &test_value);
+    zassert_equal(test_len, apdu_len, NULL);
+    zassert_equal(test_value.length, 0, NULL);
+    zassert_equal(encode_bacnet_character_string_view(apdu, NULL), 0, NULL);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(bacdcode_tests, test_bacnet_constructed_value)
 #else
@@ -2518,6 +2830,141 @@ static void test_bacnet_constructed_value(void)
     zassert_true(status, NULL);
 }
 
+/**
+ * @brief Test the tag iterator and tag views over an RPM-ACK list
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_tag_iterator)
+#else
+static void test_bacnet_tag_iterator(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_TAG_ITERATOR iter = { 0 };
+    BACNET_TAG_VIEW view = { 0 };
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    uint32_t instance = 0, enum_value = 0, length = 0;
+    const char *name = NULL;
+    uint8_t encoding = 0xFF;
+    float real_value = 0.0f;
+    bool boolean_value = false;
+    int len = 0;
+
+    /* objectIdentifier, then listOfResults */
+    len += encode_context_object_id(&apdu[len], 0, OBJECT_ANALOG_INPUT, 17);
+    len += encode_opening_tag(&apdu[len], 1);
+    /* object-name, which the caller skips */
+    len += encode_context_enumerated(&apdu[len], 2, PROP_OBJECT_NAME);
+    len += encode_opening_tag(&apdu[len], 4);
+    characterstring_init_ansi(&char_string, "AI-17");
+    len += encode_application_character_string(&apdu[len], &char_string);
+    len += encode_closing_tag(&apdu[len], 4);
+    /* present-value */
+    len += encode_context_enumerated(&apdu[len], 2, PROP_PRESENT_VALUE);
+    len += encode_opening_tag(&apdu[len], 4);
+    len += encode_application_real(&apdu[len], 42.5f);
+    len += encode_closing_tag(&apdu[len], 4);
+    /* out-of-service */
+    len += encode_context_enumerated(&apdu[len], 2, PROP_OUT_OF_SERVICE);
+    len += encode_opening_tag(&apdu[len], 4);
+    len += encode_application_boolean(&apdu[len], true);
+    len += encode_application_unsigned(&apdu[len], 1000);
+    len += encode_closing_tag(&apdu[len], 4);
+    len += encode_closing_tag(&apdu[len], 1);
+
+    bacnet_tag_iterator_init(&iter, apdu, len);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(view.tag.context, NULL);
+    zassert_equal(view.depth, 0, NULL);
+    zassert_true(
+        bacnet_tag_view_object_id(&view, &object_type, &instance), NULL);
+    zassert_equal(object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(instance, 17, NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(view.tag.opening, NULL);
+    zassert_is_null(view.value, NULL);
+    zassert_false(bacnet_tag_view_unsigned(&view, &unsigned_value), NULL);
+    zassert_equal(iter.depth, 1, NULL);
+    /* skip the object-name value */
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(bacnet_tag_view_enumerated(&view, &enum_value), NULL);
+    zassert_equal(enum_value, PROP_OBJECT_NAME, NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(view.tag.opening, NULL);
+    zassert_equal(view.tag.number, 4, NULL);
+    zassert_true(bacnet_tag_iterator_skip(&iter), NULL);
+    zassert_equal(iter.depth, 1, NULL);
+    /* present-value */
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(bacnet_tag_view_enumerated(&view, &enum_value), NULL);
+    zassert_equal(enum_value, PROP_PRESENT_VALUE, NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_equal(view.depth, 2, NULL);
+    zassert_false(bacnet_tag_view_boolean(&view, &boolean_value), NULL);
+    zassert_true(bacnet_tag_view_real(&view, &real_value), NULL);
+    zassert_false(islessgreater(real_value, 42.5f), NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(view.tag.closing, NULL);
+    zassert_equal(view.depth, 1, NULL);
+    /* out-of-service */
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(bacnet_tag_view_boolean(&view, &boolean_value), NULL);
+    zassert_true(boolean_value, NULL);
+    zassert_equal(view.value_len, 0, NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(bacnet_tag_view_unsigned(&view, &unsigned_value), NULL);
+    zassert_equal(unsigned_value, 1000, NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(view.tag.closing, NULL);
+    zassert_equal(view.depth, 0, NULL);
+    zassert_false(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_false(iter.error, NULL);
+    zassert_equal(iter.offset, len, NULL);
+    zassert_false(bacnet_tag_iterator_skip(&iter), NULL);
+
+    /* the character string is a view into the APDU */
+    bacnet_tag_iterator_init(&iter, apdu, len);
+    while (bacnet_tag_iterator_next(&iter, &view)) {
+        if (view.tag.application &&
+            bacnet_tag_view_character_string(
+                &view, &encoding, &name, &length)) {
+            break;
+        }
+    }
+    zassert_equal(encoding, CHARACTER_ANSI_X34, NULL);
+    zassert_equal(length, 5, NULL);
+    zassert_true((name > (const char *)apdu), NULL);
+    zassert_true((name < (const char *)&apdu[len]), NULL);
+    zassert_equal(memcmp(name, "AI-17", 5), 0, NULL);
+
+    /* a value that runs past the end of the APDU */
+    bacnet_tag_iterator_init(&iter, apdu, 3);
+    zassert_false(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(iter.error, NULL);
+    zassert_false(bacnet_tag_iterator_next(&iter, &view), NULL);
+    /* a closing tag without an opening tag */
+    len = encode_closing_tag(apdu, 1);
+    bacnet_tag_iterator_init(&iter, apdu, len);
+    zassert_false(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_true(iter.error, NULL);
+    /* an opening tag without a closing tag */
+    len = encode_opening_tag(apdu, 1);
+    len += encode_application_null(&apdu[len]);
+    bacnet_tag_iterator_init(&iter, apdu, len);
+    zassert_true(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_false(bacnet_tag_iterator_skip(&iter), NULL);
+    zassert_false(iter.error, NULL);
+    bacnet_tag_iterator_init(&iter, NULL, len);
+    zassert_false(bacnet_tag_iterator_next(&iter, &view), NULL);
+    zassert_false(bacnet_tag_view_null(NULL), NULL);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(bacdcode_tests, test_simple_ack)
 #else
@@ -2538,6 +2985,54 @@ static void test_simple_ack(void)
     zassert_equal(len, null_len, NULL);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_array_encoders)
+#else
+static void test_bacnet_array_encoders(void)
+#endif
+{
+    const float real_values[] = { 0.0f, 1.5f, -3.25f, 1e30f, 72.0f };
+    const BACNET_UNSIGNED_INTEGER unsigned_values[] = {
+        0, 255, 256, 65536, 4294967295UL,
+#ifdef UINT64_MAX
+        4294967296ULL, UINT64_MAX
+#endif
+    };
+    uint8_t apdu[128] = { 0 };
+    uint8_t test_apdu[128] = { 0 };
+    int len, test_len = 0, null_len;
+    size_t i;
+
+    len = encode_application_real_array(
+        apdu, real_values, ARRAY_SIZE(real_values));
+    null_len = encode_application_real_array(
+        NULL, real_values, ARRAY_SIZE(real_values));
+    zassert_equal(len, null_len, NULL);
+    for (i = 0; i < ARRAY_SIZE(real_values); i++) {
+        test_len +=
+            encode_application_real(&test_apdu[test_len], real_values[i]);
+    }
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    len = encode_application_real_array(apdu, real_values, 0);
+    zassert_equal(len, 0, NULL);
+
+    test_len = 0;
+    len = encode_application_unsigned_array(
+        apdu, unsigned_values, ARRAY_SIZE(unsigned_values));
+    null_len = encode_application_unsigned_array(
+        NULL, unsigned_values, ARRAY_SIZE(unsigned_values));
+    zassert_equal(len, null_len, NULL);
+    for (i = 0; i < ARRAY_SIZE(unsigned_values); i++) {
+        test_len += encode_application_unsigned(
+            &test_apdu[test_len], unsigned_values[i]);
+    }
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    len = encode_application_unsigned_array(apdu, NULL, 1);
+    zassert_equal(len, 0, NULL);
+}
+
 /**
  * @}
  */
@@ -2581,10 +3076,14 @@ void test_main(void)
         ztest_unit_test(testBACDCodeDouble),
         ztest_unit_test(test_bacnet_array_encode),
         ztest_unit_test(test_bacnet_enclosed_data_length),
+        ztest_unit_test(test_bacnet_enclosed_data_length_fuzz),
         ztest_unit_test(test_octet_string_buffer),
         ztest_unit_test(test_bacnet_character_string_buffer),
+        ztest_unit_test(test_bacnet_character_string_view),
         ztest_unit_test(test_bacnet_constructed_value),
-        ztest_unit_test(test_simple_ack));
+        ztest_unit_test(test_simple_ack),
+        ztest_unit_test(test_bacnet_array_encoders),
+        ztest_unit_test(test_bacnet_tag_iterator));
 
     ztest_run_test_suite(bacdcode_tests);
 }
@@ -0,0 +1,385 @@
+/**
+ * @file
+ * @brief test the export of encoded BACnet application data
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/bacexport.h>
+#include <bacnet/cov.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Export application data as JSON and compare it, and check that
+ *  a buffer that is too small gets the same length and a complete prefix
+ * @param apdu [in] encoded application data
+ * @param apdu_len [in] number of octets of encoded data
+ * @param object_type [in] object type of the data
+ * @param property [in] property of the data
+ * @param expected [in] expected JSON text
+ */
+static void test_bacexport_json(
+    const uint8_t *apdu,
+    int apdu_len,
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID property,
+    const char *expected)
+{
+    BACEXPORT exp = { 0 };
+    uint8_t buffer[256] = { 0 };
+    size_t expected_len = strlen(expected), size;
+    int len;
+
+    bacexport_init(&exp, BACEXPORT_FORMAT_JSON, buffer, sizeof(buffer));
+    len = bacexport_application_data(
+        &exp, apdu, apdu_len, object_type, property);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_true(bacexport_complete(&exp), NULL);
+    zassert_equal(exp.length, expected_len, NULL);
+    zassert_equal(
+        strcmp((char *)buffer, expected), 0, "json='%s' expected='%s'",
+        (char *)buffer, expected);
+    for (size = expected_len; size > 0; size--) {
+        memset(buffer, 'X', sizeof(buffer));
+        bacexport_init(&exp, BACEXPORT_FORMAT_JSON, buffer, size);
+        len = bacexport_application_data(
+            &exp, apdu, apdu_len, object_type, property);
+        zassert_equal(len, apdu_len, NULL);
+        zassert_false(bacexport_complete(&exp), NULL);
+        zassert_equal(exp.length, expected_len, NULL);
+        zassert_equal(buffer[size - 1], 0, NULL);
+        zassert_equal(memcmp(buffer, expected, size - 1), 0, NULL);
+    }
+}
+
+/**
+ * @brief Test the export of application data as JSON
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacexport_tests, test_bacexport_application_json)
+#else
+static void test_bacexport_application_json(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACEXPORT exp = { 0 };
+    int apdu_len = 0;
+
+    apdu_len = encode_application_real(apdu, 72.5f);
+    test_bacexport_json(
+        apdu, apdu_len, OBJECT_ANALOG_INPUT, PROP_PRESENT_VALUE, "72.5");
+    /* enumerations are named from the object and property */
+    apdu_len = encode_application_enumerated(apdu, BINARY_ACTIVE);
+    test_bacexport_json(
+        apdu, apdu_len, OBJECT_BINARY_INPUT, PROP_PRESENT_VALUE,
+        "\"active\"");
+    /* a list of values */
+    apdu_len = encode_application_unsigned(&apdu[0], 1);
+    apdu_len += encode_application_null(&apdu[apdu_len]);
+    apdu_len += encode_application_signed(&apdu[apdu_len], -2);
+    test_bacexport_json(
+        apdu, apdu_len, OBJECT_DEVICE, PROP_PRIORITY_ARRAY, "[1,null,-2]");
+    test_bacexport_json(apdu, 0, OBJECT_DEVICE, PROP_PRIORITY_ARRAY, "[]");
+    /* context tagged values, and constructed data */
+    apdu_len = encode_opening_tag(&apdu[0], 0);
+    apdu_len += encode_application_unsigned(&apdu[apdu_len], 5);
+    apdu_len += encode_context_unsigned(&apdu[apdu_len], 1, 7);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 0);
+    apdu_len += encode_context_boolean(&apdu[apdu_len], 2, true);
+    test_bacexport_json(
+        apdu, apdu_len, OBJECT_DEVICE, PROP_DESCRIPTION,
+        "[{\"0\":[5,{\"1\":\"07\"}]},{\"2\":\"01\"}]");
+    /* the data ends at a closing tag */
+    apdu_len = encode_application_boolean(&apdu[0], true);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 3);
+    bacexport_init(&exp, BACEXPORT_FORMAT_JSON, NULL, 0);
+    zassert_equal(
+        bacexport_application_data(
+            &exp, apdu, apdu_len, OBJECT_DEVICE, PROP_DESCRIPTION),
+        1, NULL);
+    zassert_equal(exp.length, 4, NULL);
+    zassert_false(bacexport_complete(&exp), NULL);
+    /* malformed data */
+    apdu_len = encode_opening_tag(&apdu[0], 0);
+    apdu_len += encode_application_unsigned(&apdu[apdu_len], 5);
+    zassert_equal(
+        bacexport_application_data(
+            &exp, apdu, apdu_len, OBJECT_DEVICE, PROP_DESCRIPTION),
+        BACNET_STATUS_ERROR, NULL);
+    apdu_len = encode_application_unsigned(&apdu[0], 100000);
+    zassert_equal(
+        bacexport_application_data(
+            &exp, apdu, apdu_len - 1, OBJECT_DEVICE, PROP_DESCRIPTION),
+        BACNET_STATUS_ERROR, NULL);
+    zassert_equal(
+        bacexport_application_data(
+            NULL, apdu, apdu_len, OBJECT_DEVICE, PROP_DESCRIPTION),
+        BACNET_STATUS_ERROR, NULL);
+}
+
+/**
+ * @brief Test the export of application data as CBOR
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacexport_tests, test_bacexport_application_cbor)
+#else
+static void test_bacexport_application_cbor(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t buffer[64] = { 0 };
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    BACNET_OCTET_STRING octet_string = { 0 };
+    BACNET_BIT_STRING bit_string = { 0 };
+    BACEXPORT exp = { 0 };
+    int apdu_len = 0, len;
+    const uint8_t octets[] = { 0x12, 0xAB };
+    const uint8_t expected[] = {
+        /* array of 10 */
+        0x8A,
+        /* 1.5 */
+        0xFA, 0x3F, 0xC0, 0x00, 0x00,
+        /* 500 */
+        0x19, 0x01, 0xF4,
+        /* -10 */
+        0x29,
+        /* 4294967295 */
+        0x1A, 0xFF, 0xFF, 0xFF, 0xFF,
+        /* "abc" */
+        0x63, 'a', 'b', 'c',
+        /* h'12AB' */
+        0x42, 0x12, 0xAB,
+        /* [true, false, true] */
+        0x83, 0xF5, 0xF4, 0xF5,
+        /* false, null */
+        0xF4, 0xF6,
+        /* "active" */
+        0x66, 'a', 'c', 't', 'i', 'v', 'e'
+    };
+
+    apdu_len = encode_application_real(&apdu[0], 1.5f);
+    apdu_len += encode_application_unsigned(&apdu[apdu_len], 500);
+    apdu_len += encode_application_signed(&apdu[apdu_len], -10);
+    apdu_len += encode_application_unsigned(&apdu[apdu_len], 4294967295UL);
+    characterstring_init_ansi(&char_string, "abc");
+    apdu_len +=
+        encode_application_character_string(&apdu[apdu_len], &char_string);
+    octetstring_init(&octet_string, octets, sizeof(octets));
+    apdu_len +=
+        encode_application_octet_string(&apdu[apdu_len], &octet_string);
+    bitstring_init(&bit_string);
+    bitstring_set_bit(&bit_string, 0, true);
+    bitstring_set_bit(&bit_string, 1, false);
+    bitstring_set_bit(&bit_string, 2, true);
+    apdu_len += encode_application_bitstring(&apdu[apdu_len], &bit_string);
+    apdu_len += encode_application_boolean(&apdu[apdu_len], false);
+    apdu_len += encode_application_null(&apdu[apdu_len]);
+    apdu_len += encode_application_enumerated(&apdu[apdu_len], BINARY_ACTIVE);
+    bacexport_init(&exp, BACEXPORT_FORMAT_CBOR, buffer, sizeof(buffer));
+    len = bacexport_application_data(
+        &exp, apdu, apdu_len, OBJECT_BINARY_VALUE, PROP_PRESENT_VALUE);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_true(bacexport_complete(&exp), NULL);
+    zassert_equal(exp.length, sizeof(expected), NULL);
+    zassert_equal(memcmp(buffer, expected, sizeof(expected)), 0, NULL);
+    /* only the length */
+    bacexport_init(&exp, BACEXPORT_FORMAT_CBOR, NULL, sizeof(buffer));
+    len = bacexport_application_data(
+        &exp, apdu, apdu_len, OBJECT_BINARY_VALUE, PROP_PRESENT_VALUE);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_equal(exp.length, sizeof(expected), NULL);
+    /* a head with an 8-bit and a 64-bit argument */
+    apdu_len = encode_application_unsigned(&apdu[0], 24);
+    bacexport_init(&exp, BACEXPORT_FORMAT_CBOR, buffer, sizeof(buffer));
+    bacexport_application_data(
+        &exp, apdu, apdu_len, OBJECT_DEVICE, PROP_PRESENT_VALUE);
+    zassert_equal(exp.length, 2, NULL);
+    zassert_equal(buffer[0], 0x18, NULL);
+    zassert_equal(buffer[1], 24, NULL);
+#ifdef UINT64_MAX
+    apdu_len = encode_application_unsigned(&apdu[0], UINT64_MAX);
+    bacexport_init(&exp, BACEXPORT_FORMAT_CBOR, buffer, sizeof(buffer));
+    bacexport_application_data(
+        &exp, apdu, apdu_len, OBJECT_DEVICE, PROP_PRESENT_VALUE);
+    if (sizeof(BACNET_UNSIGNED_INTEGER) == 8) {
+        zassert_equal(exp.length, 9, NULL);
+        zassert_equal(buffer[0], 0x1B, NULL);
+        zassert_equal(buffer[8], 0xFF, NULL);
+    }
+#endif
+}
+
+/**
+ * @brief Test the export of a ReadPropertyMultiple acknowledgment
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacexport_tests, test_bacexport_rpm_ack)
+#else
+static void test_bacexport_rpm_ack(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t buffer[512] = { 0 };
+    BACEXPORT exp = { 0 };
+    int apdu_len = 0, len;
+    const char *expected =
+        "[{\"objectIdentifier\":\"(analog-input, 1)\",\"listOfResults\":["
+        "{\"propertyIdentifier\":85,\"propertyValue\":21.5},"
+        "{\"propertyIdentifier\":87,\"propertyArrayIndex\":1,"
+        "\"propertyValue\":null},"
+        "{\"propertyIdentifier\":9999,\"propertyAccessError\":"
+        "{\"errorClass\":2,\"errorCode\":32}}]},"
+        "{\"objectIdentifier\":\"(binary-input, 2)\",\"listOfResults\":["
+        "{\"propertyIdentifier\":85,\"propertyValue\":\"inactive\"}]}]";
+
+    apdu_len = encode_context_object_id(&apdu[0], 0, OBJECT_ANALOG_INPUT, 1);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 1);
+    apdu_len +=
+        encode_context_enumerated(&apdu[apdu_len], 2, PROP_PRESENT_VALUE);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 4);
+    apdu_len += encode_application_real(&apdu[apdu_len], 21.5f);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 4);
+    apdu_len +=
+        encode_context_enumerated(&apdu[apdu_len], 2, PROP_PRIORITY_ARRAY);
+    apdu_len += encode_context_unsigned(&apdu[apdu_len], 3, 1);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 4);
+    apdu_len += encode_application_null(&apdu[apdu_len]);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 4);
+    apdu_len += encode_context_enumerated(&apdu[apdu_len], 2, 9999);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 5);
+    apdu_len +=
+        encode_application_enumerated(&apdu[apdu_len], ERROR_CLASS_PROPERTY);
+    apdu_len += encode_application_enumerated(
+        &apdu[apdu_len], ERROR_CODE_UNKNOWN_PROPERTY);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 5);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 1);
+    apdu_len +=
+        encode_context_object_id(&apdu[apdu_len], 0, OBJECT_BINARY_INPUT, 2);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 1);
+    apdu_len +=
+        encode_context_enumerated(&apdu[apdu_len], 2, PROP_PRESENT_VALUE);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 4);
+    apdu_len += encode_application_enumerated(&apdu[apdu_len], BINARY_INACTIVE);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 4);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 1);
+    bacexport_init(&exp, BACEXPORT_FORMAT_JSON, buffer, sizeof(buffer));
+    len = bacexport_rpm_ack(&exp, apdu, apdu_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_true(bacexport_complete(&exp), NULL);
+    zassert_equal(
+        strcmp((char *)buffer, expected), 0, "json='%s'", (char *)buffer);
+    /* the arrays have an indefinite length in CBOR */
+    bacexport_init(&exp, BACEXPORT_FORMAT_CBOR, buffer, sizeof(buffer));
+    len = bacexport_rpm_ack(&exp, apdu, apdu_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_true(bacexport_complete(&exp), NULL);
+    zassert_equal(buffer[0], 0x9F, NULL);
+    zassert_equal(buffer[1], 0xA2, NULL);
+    zassert_equal(buffer[2], 0x70, NULL);
+    zassert_equal(memcmp(&buffer[3], "objectIdentifier", 16), 0, NULL);
+    zassert_equal(buffer[exp.length - 2], 0xFF, NULL);
+    zassert_equal(buffer[exp.length - 1], 0xFF, NULL);
+    /* a missing closing tag */
+    zassert_equal(
+        bacexport_rpm_ack(&exp, apdu, apdu_len - 1), BACNET_STATUS_ERROR,
+        NULL);
+    zassert_equal(bacexport_rpm_ack(&exp, NULL, 0), BACNET_STATUS_ERROR, NULL);
+}
+
+/**
+ * @brief Test the export of a COV notification
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacexport_tests, test_bacexport_cov_notification)
+#else
+static void test_bacexport_cov_notification(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t buffer[512] = { 0 };
+    BACNET_PROPERTY_VALUE value_list[2] = { 0 };
+    BACNET_COV_DATA cov_data = { 0 };
+    BACEXPORT exp = { 0 };
+    int apdu_len = 0, len;
+    const char *expected =
+        "{\"subscriberProcessIdentifier\":1,"
+        "\"initiatingDeviceIdentifier\":\"(device, 123)\","
+        "\"monitoredObjectIdentifier\":\"(binary-value, 5)\","
+        "\"timeRemaining\":60,\"listOfValues\":["
+        "{\"propertyIdentifier\":85,\"value\":\"active\",\"priority\":8},"
+        "{\"propertyIdentifier\":111,"
+        "\"value\":[false,false,false,false]}]}";
+
+    cov_data.subscriberProcessIdentifier = 1;
+    cov_data.initiatingDeviceIdentifier = 123;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_BINARY_VALUE;
+    cov_data.monitoredObjectIdentifier.instance = 5;
+    cov_data.timeRemaining = 60;
+    cov_data.listOfValues = &value_list[0];
+    value_list[0].propertyIdentifier = PROP_PRESENT_VALUE;
+    value_list[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+    value_list[0].value.tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    value_list[0].value.type.Enumerated = BINARY_ACTIVE;
+    value_list[0].priority = 8;
+    value_list[0].next = &value_list[1];
+    value_list[1].propertyIdentifier = PROP_STATUS_FLAGS;
+    value_list[1].propertyArrayIndex = BACNET_ARRAY_ALL;
+    value_list[1].value.tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value_list[1].value.type.Bit_String);
+    bitstring_set_bit(
+        &value_list[1].value.type.Bit_String, STATUS_FLAG_OUT_OF_SERVICE,
+        false);
+    value_list[1].priority = BACNET_NO_PRIORITY;
+    apdu_len = cov_notify_service_request_encode(apdu, sizeof(apdu), &cov_data);
+    zassert_true(apdu_len > 0, NULL);
+    bacexport_init(&exp, BACEXPORT_FORMAT_JSON, buffer, sizeof(buffer));
+    len = bacexport_cov_notification(&exp, apdu, apdu_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_true(bacexport_complete(&exp), NULL);
+    zassert_equal(
+        strcmp((char *)buffer, expected), 0, "json='%s'", (char *)buffer);
+    /* the length without a buffer */
+    bacexport_init(&exp, BACEXPORT_FORMAT_JSON, NULL, 0);
+    len = bacexport_cov_notification(&exp, apdu, apdu_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_equal(exp.length, strlen(expected), NULL);
+    /* the values have no count in CBOR, since the priority is last */
+    bacexport_init(&exp, BACEXPORT_FORMAT_CBOR, buffer, sizeof(buffer));
+    len = bacexport_cov_notification(&exp, apdu, apdu_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_equal(buffer[0], 0xA5, NULL);
+    zassert_equal(buffer[exp.length - 2], 0xFF, NULL);
+    zassert_equal(buffer[exp.length - 1], 0xFF, NULL);
+    /* malformed data */
+    zassert_equal(
+        bacexport_cov_notification(&exp, apdu, apdu_len - 1),
+        BACNET_STATUS_ERROR, NULL);
+    zassert_equal(
+        bacexport_cov_notification(&exp, apdu, 1), BACNET_STATUS_ERROR, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bacexport_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        bacexport_tests, ztest_unit_test(test_bacexport_application_json),
+        ztest_unit_test(test_bacexport_application_cbor),
+        ztest_unit_test(test_bacexport_rpm_ack),
+        ztest_unit_test(test_bacexport_cov_notification));
+
+    ztest_run_test_suite(bacexport_tests);
+}
+#endif
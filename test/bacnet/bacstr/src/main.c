@@ -149,6 +149,11 @@ static void testBitString(void)
     zassert_equal(
         bitstring_bits_used(&bit_string), MAX_BITSTRING_BYTES * 8,
         "Should have max bits");
+    status = bitstring_copy(&bit_string2, &bit_string);
+    zassert_true(status, NULL);
+    zassert_true(bitstring_same(&bit_string, &bit_string2), NULL);
+    bitstring_set_bit(&bit_string2, (MAX_BITSTRING_BYTES * 8) - 1, false);
+    zassert_false(bitstring_same(&bit_string, &bit_string2), NULL);
     /* test string with mixed valid and invalid characters */
     status = bitstring_init_ascii(&bit_string, "1a1b0c0d1e0");
     zassert_true(status, "Mixed valid/invalid chars should skip invalid ones");
@@ -157,6 +162,50 @@ static void testBitString(void)
         "Should have 6 bits from valid chars: 110010");
 }
 
+/**
+ * @brief Test initializing a bit string from its octets
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacstr_tests, testBitStringInitOctets)
+#else
+static void testBitStringInitOctets(void)
+#endif
+{
+    BACNET_BIT_STRING bit_string = { 0 };
+    BACNET_BIT_STRING test_bit_string = { 0 };
+    const uint8_t octets[2] = { 0xA5, 0xFF };
+    bool status = false;
+    unsigned i;
+
+    status = bitstring_init_octets(&bit_string, octets, 12);
+    zassert_true(status, NULL);
+    zassert_equal(bitstring_bits_used(&bit_string), 12, NULL);
+    zassert_equal(bitstring_octet(&bit_string, 0), 0xA5, NULL);
+    /* the unused bits of the last octet are clear */
+    zassert_equal(bitstring_octet(&bit_string, 1), 0x0F, NULL);
+    bitstring_init(&test_bit_string);
+    for (i = 0; i < 12; i++) {
+        bitstring_set_bit(
+            &test_bit_string, (uint8_t)i, (i < 8) ? (0xA5 & (1 << i)) : true);
+    }
+    zassert_true(bitstring_same(&bit_string, &test_bit_string), NULL);
+    /* all of the bits clear */
+    status = bitstring_init_octets(&bit_string, NULL, 20);
+    zassert_true(status, NULL);
+    zassert_equal(bitstring_bits_used(&bit_string), 20, NULL);
+    for (i = 0; i < 20; i++) {
+        zassert_false(bitstring_bit(&bit_string, (uint8_t)i), NULL);
+    }
+    status = bitstring_init_octets(&bit_string, octets, 0);
+    zassert_true(status, NULL);
+    zassert_equal(bitstring_bits_used(&bit_string), 0, NULL);
+    status = bitstring_init_octets(
+        &bit_string, NULL, (MAX_BITSTRING_BYTES * 8) + 1);
+    zassert_false(status, NULL);
+    status = bitstring_init_octets(NULL, octets, 8);
+    zassert_false(status, NULL);
+}
+
 /**
  * @brief Test encode/decode API for character strings
  */
@@ -524,6 +573,62 @@ static void testCharacterStringUtf8Strdup(void)
     dup_string = NULL;
 }
 
+/**
+ * @brief Test the non-owning BACnet character string view
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacstr_tests, testCharacterStringView)
+#else
+static void testCharacterStringView(void)
+#endif
+{
+    BACNET_CHARACTER_STRING_VIEW view = { 0 };
+    BACNET_CHARACTER_STRING bacnet_string = { 0 };
+    static char long_value[MAX_CHARACTER_STRING_BYTES + 1];
+    const char *value = "Joshua,Mary,Anna";
+    bool status = false;
+
+    status = characterstring_view_init_ansi(&view, value);
+    zassert_true(status, NULL);
+    zassert_equal(view.value, value, "the view does not copy the value");
+    zassert_equal(view.length, strlen(value), NULL);
+    zassert_equal(view.encoding, CHARACTER_ANSI_X34, NULL);
+    zassert_true(characterstring_view_ansi_same(&view, value), NULL);
+    zassert_false(characterstring_view_ansi_same(&view, "Joshua"), NULL);
+    zassert_false(characterstring_view_ansi_same(&view, NULL), NULL);
+    /* compare and copy to a BACnet character string */
+    characterstring_init_ansi(&bacnet_string, value);
+    zassert_true(characterstring_view_same(&view, &bacnet_string), NULL);
+    characterstring_init_ansi(&bacnet_string, "Joshua,Mary,Anne");
+    zassert_false(characterstring_view_same(&view, &bacnet_string), NULL);
+    status = characterstring_view_copy(&bacnet_string, &view);
+    zassert_true(status, NULL);
+    zassert_true(characterstring_ansi_same(&bacnet_string, value), NULL);
+    zassert_false(characterstring_view_copy(&bacnet_string, NULL), NULL);
+    characterstring_set_encoding(&bacnet_string, CHARACTER_MS_DBCS);
+    zassert_false(characterstring_view_same(&view, &bacnet_string), NULL);
+    /* a view of a BACnet character string */
+    characterstring_view_from(&view, &bacnet_string);
+    zassert_equal(view.value, characterstring_value(&bacnet_string), NULL);
+    zassert_equal(view.encoding, CHARACTER_MS_DBCS, NULL);
+    zassert_true(characterstring_view_same(&view, &bacnet_string), NULL);
+    zassert_false(characterstring_view_same(NULL, &bacnet_string), NULL);
+    /* empty strings */
+    status = characterstring_view_init_ansi(&view, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(view.length, 0, NULL);
+    zassert_true(characterstring_view_ansi_same(&view, ""), NULL);
+    characterstring_init_ansi(&bacnet_string, "");
+    zassert_true(characterstring_view_same(&view, &bacnet_string), NULL);
+    /* a value that does not fit in a BACnet character string */
+    memset(long_value, 'A', sizeof(long_value) - 1);
+    status = characterstring_view_init_ansi(&view, long_value);
+    zassert_false(status, NULL);
+    zassert_equal(view.length, sizeof(long_value) - 1, NULL);
+    zassert_false(characterstring_view_copy(&bacnet_string, &view), NULL);
+    zassert_false(characterstring_view_init(NULL, 0, value, 1), NULL);
+}
+
 /**
  * @brief Test encode/decode API for octet strings
  */
@@ -1404,9 +1509,11 @@ void test_main(void)
 {
     ztest_test_suite(
         bacstr_tests, ztest_unit_test(testBitString),
+        ztest_unit_test(testBitStringInitOctets),
         ztest_unit_test(testCharacterString), ztest_unit_test(testUtf8IsValid),
         ztest_unit_test(testCharacterStringUtf8Valid),
         ztest_unit_test(testCharacterStringUtf8Strdup),
+        ztest_unit_test(testCharacterStringView),
         ztest_unit_test(testOctetString),
         ztest_unit_test(test_octetstring_init_ascii_epics),
         ztest_unit_test(test_bacnet_stricmp),
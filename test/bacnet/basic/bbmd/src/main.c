@@ -36,6 +36,9 @@ static uint8_t Test_Sent_Message_Length;
 static uint8_t Test_Sent_Message_Buffer[MAX_APDU];
 static uint16_t Test_Sent_Message_Buffer_Length;
 static BACNET_IP_ADDRESS Test_Sent_Message_Dest;
+/* for the fan out of one message to many destinations */
+static unsigned Test_Sent_Message_Count;
+static BACNET_IP_ADDRESS Test_Sent_Message_Dest_List[8];
 
 /* network stub functions */
 /**
@@ -89,7 +92,37 @@ int bip_send_mpdu(
         Test_Sent_Message_Buffer_Length = 0;
     }
 
-    return 0;
+    return mtu_len;
+}
+
+/**
+ * The send function for BACnet/IP driver layer to send the same MPDU
+ * to many destinations
+ *
+ * @param dest - array of BACNET_IP_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return the number of destinations the MPDU was sent to
+ */
+int bip_send_mpdu_multiple(
+    const BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned i;
+
+    for (i = 0; i < dest_count; i++) {
+        (void)bip_send_mpdu(&dest[i], mtu, mtu_len);
+        if (i < 8) {
+            bvlc_address_copy(&Test_Sent_Message_Dest_List[i], &dest[i]);
+        }
+    }
+    Test_Sent_Message_Count = dest_count;
+
+    return dest_count;
 }
 
 /** Return the Object Instance number for our (single) Device Object.
@@ -227,11 +260,384 @@ static void test_BBMD_Result(void)
     }
 }
 
+/**
+ * @brief Test a Distribute-Broadcast-To-Network from a foreign device
+ *  is sent once to the local subnet and each other foreign device
+ */
+static void test_Distribute_Broadcast_To_Network(void)
+{
+    BACNET_IP_ADDRESS fd_addr[3];
+    BACNET_IP_ADDRESS fwd_address;
+    BACNET_ADDRESS src = { 0 };
+    uint8_t npdu[] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF, 0x10, 0x08 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    uint8_t test_npdu[MAX_APDU] = { 0 };
+    uint16_t test_npdu_len = 0;
+    uint16_t mtu_len = 0;
+    unsigned i = 0;
+    int result = 0;
+
+    test_setup();
+    for (i = 0; i < 3; i++) {
+        bvlc_address_set(&fd_addr[i], 10, 0, 0, 1 + i);
+        fd_addr[i].port = 0xBAC0;
+        mtu_len = bvlc_encode_register_foreign_device(&mtu[0], sizeof(mtu), 60);
+        result =
+            bvlc_bbmd_enabled_handler(&fd_addr[i], &src, &mtu[0], mtu_len);
+        assert(result == 0);
+        assert(Test_Sent_Message_Type == BVLC_RESULT);
+    }
+    mtu_len = bvlc_encode_distribute_broadcast_to_network(
+        &mtu[0], sizeof(mtu), npdu, sizeof(npdu));
+    Test_Sent_Message_Count = 0;
+    result = bvlc_bbmd_enabled_handler(&fd_addr[1], &src, &mtu[0], mtu_len);
+    assert(result == 0);
+    /* local broadcast, then the other foreign devices */
+    assert(Test_Sent_Message_Count == 3);
+    assert(!bvlc_address_different(
+        &IUT.BIP_Broadcast_Addr, &Test_Sent_Message_Dest_List[0]));
+    assert(!bvlc_address_different(
+        &fd_addr[0], &Test_Sent_Message_Dest_List[1]));
+    assert(!bvlc_address_different(
+        &fd_addr[2], &Test_Sent_Message_Dest_List[2]));
+    assert(Test_Sent_Message_Type == BVLC_FORWARDED_NPDU);
+    result = bvlc_decode_forwarded_npdu(
+        Test_Sent_Message_Buffer, Test_Sent_Message_Buffer_Length,
+        &fwd_address, test_npdu, sizeof(test_npdu), &test_npdu_len);
+    assert(result > 0);
+    assert(!bvlc_address_different(&fwd_address, &fd_addr[1]));
+    assert(test_npdu_len == sizeof(npdu));
+    assert(memcmp(test_npdu, npdu, sizeof(npdu)) == 0);
+    test_cleanup();
+}
+
+/**
+ * @brief Test that a broadcast that reaches the BBMD again within the
+ *  window is dropped instead of forwarded again
+ */
+static void test_Duplicate_Broadcast(void)
+{
+    BACNET_IP_ADDRESS fd_addr[2];
+    BACNET_IP_ADDRESS peer_addr;
+    BACNET_ADDRESS src = { 0 };
+    uint8_t npdu[] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF, 0x10, 0x08 };
+    uint8_t other_npdu[] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF, 0x10, 0x08 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    uint16_t mtu_len = 0;
+    uint32_t count = 0;
+    unsigned i = 0;
+    int result = 0;
+
+    test_setup();
+    for (i = 0; i < 2; i++) {
+        bvlc_address_set(&fd_addr[i], 10, 0, 1, 1 + i);
+        fd_addr[i].port = 0xBAC0;
+        mtu_len = bvlc_encode_register_foreign_device(&mtu[0], sizeof(mtu), 60);
+        result =
+            bvlc_bbmd_enabled_handler(&fd_addr[i], &src, &mtu[0], mtu_len);
+        assert(result == 0);
+    }
+    count = bvlc_bbmd_duplicate_count();
+    mtu_len = bvlc_encode_distribute_broadcast_to_network(
+        &mtu[0], sizeof(mtu), npdu, sizeof(npdu));
+    Test_Sent_Message_Count = 0;
+    result = bvlc_bbmd_enabled_handler(&fd_addr[0], &src, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Count > 0);
+    /* the same broadcast from the same foreign device is dropped */
+    Test_Sent_Message_Count = 0;
+    result = bvlc_bbmd_enabled_handler(&fd_addr[0], &src, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Count == 0);
+    assert(bvlc_bbmd_duplicate_count() == (count + 1));
+    /* another broadcast of the same length from it is forwarded */
+    other_npdu[sizeof(other_npdu) - 1] = 0x09;
+    mtu_len = bvlc_encode_distribute_broadcast_to_network(
+        &mtu[0], sizeof(mtu), other_npdu, sizeof(other_npdu));
+    result = bvlc_bbmd_enabled_handler(&fd_addr[0], &src, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Count > 0);
+    assert(bvlc_bbmd_duplicate_count() == (count + 1));
+    mtu_len = bvlc_encode_distribute_broadcast_to_network(
+        &mtu[0], sizeof(mtu), npdu, sizeof(npdu));
+    /* the same broadcast from another foreign device is forwarded */
+    Test_Sent_Message_Count = 0;
+    result = bvlc_bbmd_enabled_handler(&fd_addr[1], &src, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Count > 0);
+    /* the same broadcast forwarded by a peer BBMD is dropped */
+    bvlc_address_set(&peer_addr, 192, 168, 2, 10);
+    peer_addr.port = 0xBAC0;
+    mtu_len = bvlc_encode_forwarded_npdu(
+        &mtu[0], sizeof(mtu), &fd_addr[0], npdu, sizeof(npdu));
+    Test_Sent_Message_Count = 0;
+    result = bvlc_bbmd_enabled_handler(&peer_addr, &src, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Count == 0);
+    assert(bvlc_bbmd_duplicate_count() == (count + 2));
+    /* after the window, the broadcast is forwarded again */
+    bvlc_maintenance_timer(2);
+    result = bvlc_bbmd_enabled_handler(&peer_addr, &src, &mtu[0], mtu_len);
+    assert(result > 0);
+    assert(Test_Sent_Message_Count > 0);
+    assert(bvlc_bbmd_duplicate_count() == (count + 2));
+    test_cleanup();
+}
+
+/**
+ * @brief Count the valid entries in the FDT
+ * @param addr - address of an entry to find, or NULL
+ * @param ttl_seconds_remaining - [out] remaining time of the entry found
+ * @return number of valid entries
+ */
+static unsigned
+test_fdt_count(const BACNET_IP_ADDRESS *addr, uint16_t *ttl_seconds_remaining)
+{
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_entry;
+    unsigned count = 0;
+
+    fdt_entry = bvlc_fdt_list();
+    while (fdt_entry) {
+        if (fdt_entry->valid) {
+            count++;
+            if (addr &&
+                !bvlc_address_different(addr, &fdt_entry->dest_address)) {
+                *ttl_seconds_remaining = fdt_entry->ttl_seconds_remaining;
+            }
+        }
+        fdt_entry = fdt_entry->next;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Send a BVLL message to the BBMD from a foreign device
+ * @param addr - address of the foreign device
+ * @param mtu - the BVLL message
+ * @param mtu_len - number of bytes in the message
+ * @return the BVLC-Result code that was sent back
+ */
+static uint16_t test_fdt_request(
+    const BACNET_IP_ADDRESS *addr, uint8_t *mtu, uint16_t mtu_len)
+{
+    BACNET_IP_ADDRESS fd_addr;
+    BACNET_ADDRESS src = { 0 };
+    uint16_t result_code = 0xFFFF;
+
+    bvlc_address_copy(&fd_addr, addr);
+    Test_Sent_Message_Type = 0;
+    (void)bvlc_bbmd_enabled_handler(&fd_addr, &src, mtu, mtu_len);
+    assert(Test_Sent_Message_Type == BVLC_RESULT);
+    (void)decode_unsigned16(Test_Sent_Message_Buffer, &result_code);
+
+    return result_code;
+}
+
+/**
+ * @brief Test registering, deleting, and expiring many foreign devices
+ *  in a Foreign-Device-Table that is sized at runtime
+ */
+static void test_Foreign_Device_Table(void)
+{
+    BACNET_IP_ADDRESS fd_addr;
+    uint8_t mtu[MAX_APDU] = { 0 };
+    uint16_t mtu_len = 0;
+    uint16_t ttl_seconds_remaining = 0;
+    const unsigned fd_count = 1000;
+    unsigned i;
+
+    test_setup();
+    /* expire the foreign devices of the other tests */
+    bvlc_maintenance_timer(UINT16_MAX);
+    assert(test_fdt_count(NULL, NULL) == 0);
+    assert(bvlc_fdt_size_set(fd_count));
+    assert(bvlc_fdt_size() == fd_count);
+    for (i = 0; i < fd_count; i++) {
+        bvlc_address_set(&fd_addr, 10, 1, i / 256, i % 256);
+        fd_addr.port = 0xBAC0;
+        mtu_len = bvlc_encode_register_foreign_device(
+            &mtu[0], sizeof(mtu), i % 100);
+        assert(
+            test_fdt_request(&fd_addr, mtu, mtu_len) ==
+            BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    }
+    assert(test_fdt_count(NULL, NULL) == fd_count);
+    /* the table is full */
+    bvlc_address_set(&fd_addr, 10, 2, 0, 1);
+    assert(
+        test_fdt_request(&fd_addr, mtu, mtu_len) ==
+        BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK);
+    /* registering again restarts the time-to-live */
+    bvlc_address_set(&fd_addr, 10, 1, 0, 0);
+    mtu_len = bvlc_encode_register_foreign_device(&mtu[0], sizeof(mtu), 500);
+    assert(
+        test_fdt_request(&fd_addr, mtu, mtu_len) ==
+        BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    assert(test_fdt_count(&fd_addr, &ttl_seconds_remaining) == fd_count);
+    assert(ttl_seconds_remaining == 530);
+    /* delete an entry */
+    bvlc_address_set(&fd_addr, 10, 1, 0, 1);
+    mtu_len = bvlc_encode_delete_foreign_device(&mtu[0], sizeof(mtu), &fd_addr);
+    assert(
+        test_fdt_request(&fd_addr, mtu, mtu_len) ==
+        BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    assert(test_fdt_count(NULL, NULL) == (fd_count - 1));
+    assert(
+        test_fdt_request(&fd_addr, mtu, mtu_len) ==
+        BVLC_RESULT_DELETE_FOREIGN_DEVICE_TABLE_ENTRY_NAK);
+    /* the entries with a time-to-live of zero expire after the grace
+       period, except the one that registered again */
+    bvlc_maintenance_timer(29);
+    assert(test_fdt_count(NULL, NULL) == (fd_count - 1));
+    bvlc_maintenance_timer(1);
+    assert(test_fdt_count(NULL, NULL) == (fd_count - 1 - 9));
+    bvlc_address_set(&fd_addr, 10, 1, 0, 0);
+    assert(test_fdt_count(&fd_addr, &ttl_seconds_remaining) > 0);
+    assert(ttl_seconds_remaining == 500);
+    /* more seconds than the timer wheel has slots */
+    bvlc_maintenance_timer(200);
+    assert(test_fdt_count(&fd_addr, &ttl_seconds_remaining) == 1);
+    assert(ttl_seconds_remaining == 300);
+    /* back to the default size, keeping the valid entry */
+    assert(bvlc_fdt_size_set(0));
+    assert(test_fdt_count(&fd_addr, &ttl_seconds_remaining) == 1);
+    assert(ttl_seconds_remaining == 300);
+    bvlc_maintenance_timer(300);
+    assert(test_fdt_count(NULL, NULL) == 0);
+    test_cleanup();
+}
+
+/**
+ * @brief Test that a BDT entry for the multicast group that the peer
+ *  BBMDs have joined (Annex J.8) is not sent an original broadcast that
+ *  was already multicast to that group
+ */
+static void test_Multicast_Group_BDT(void)
+{
+    BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY bdt_entry = { 0 };
+    BACNET_IP_BROADCAST_DISTRIBUTION_MASK mask = { 0 };
+    BACNET_IP_ADDRESS group_addr;
+    BACNET_IP_ADDRESS peer_addr;
+    BACNET_ADDRESS src = { 0 };
+    uint8_t npdu[] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF, 0x10, 0x08 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    uint16_t mtu_len = 0;
+    unsigned fd_count = 0;
+    int result = 0;
+
+    test_setup();
+    fd_count = test_fdt_count(NULL, NULL);
+    bvlc_address_set(&IUT.BIP_Broadcast_Addr, 239, 255, 186, 192);
+    IUT.BIP_Broadcast_Addr.port = 0xBAC0;
+    bvlc_address_copy(&group_addr, &IUT.BIP_Broadcast_Addr);
+    IUT.BIP_Addr.port = 0xBAC0;
+    TD.BIP_Addr.port = 0xBAC0;
+    bvlc_bdt_list_clear();
+    bvlc_broadcast_distribution_mask_from_host(&mask, 0xFFFFFFFF);
+    bvlc_broadcast_distribution_table_entry_set(
+        &bdt_entry, &IUT.BIP_Addr, &mask);
+    bvlc_broadcast_distribution_table_entry_append(bvlc_bdt_list(), &bdt_entry);
+    bvlc_broadcast_distribution_table_entry_set(
+        &bdt_entry, &IUT.BIP_Broadcast_Addr, &mask);
+    bvlc_broadcast_distribution_table_entry_append(bvlc_bdt_list(), &bdt_entry);
+    bvlc_address_set(&peer_addr, 192, 168, 3, 10);
+    peer_addr.port = 0xBAC0;
+    bvlc_broadcast_distribution_table_entry_set(&bdt_entry, &peer_addr, &mask);
+    bvlc_broadcast_distribution_table_entry_append(bvlc_bdt_list(), &bdt_entry);
+    /* an original broadcast received on the group goes to the peer
+       that has not joined the group */
+    mtu_len = bvlc_encode_original_broadcast(
+        &mtu[0], sizeof(mtu), npdu, sizeof(npdu));
+    Test_Sent_Message_Count = 0;
+    result = bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, &mtu[0], mtu_len);
+    assert(result > 0);
+    /* and to the foreign devices */
+    assert(Test_Sent_Message_Count == (1 + fd_count));
+    assert(
+        !bvlc_address_different(&peer_addr, &Test_Sent_Message_Dest_List[0]));
+    /* with a subnet broadcast address, the group is sent the forward */
+    bvlc_address_set(&IUT.BIP_Broadcast_Addr, 192, 168, 1, 255);
+    npdu[7] = 0x09;
+    mtu_len = bvlc_encode_original_broadcast(
+        &mtu[0], sizeof(mtu), npdu, sizeof(npdu));
+    Test_Sent_Message_Count = 0;
+    result = bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, &mtu[0], mtu_len);
+    assert(result > 0);
+    assert(Test_Sent_Message_Count == (2 + fd_count));
+    assert(!bvlc_address_different(
+        &group_addr, &Test_Sent_Message_Dest_List[0]));
+    bvlc_bdt_list_clear();
+    test_cleanup();
+}
+
+/**
+ * @brief Test sending an NPDU from a PDU buffer with headroom
+ */
+static void test_Send_PDU_Buffer(void)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    PDU_BUFFER *buf;
+    uint8_t *pdu;
+    int npdu_len, apdu_len, result;
+
+    test_setup();
+    /* the IUT sends a unicast to the TD */
+    bvlc_ip_address_to_bacnet_local(&dest, &TD.BIP_Addr);
+    buf = pdubuf_alloc(PDUBUF_HEADROOM);
+    assert(buf);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu = pdubuf_tail(buf);
+    npdu_len = npdu_encode_pdu(pdu, &dest, &IUT.BACnet_Address, &npdu_data);
+    apdu_len = iam_encode_apdu(
+        &pdu[npdu_len], IUT.Device_ID, MAX_APDU, SEGMENTATION_NONE,
+        BACNET_VENDOR_ID);
+    assert(pdubuf_put(buf, npdu_len + apdu_len) == pdu);
+    result = bvlc_send_pdubuf(&dest, &npdu_data, buf);
+    assert(result == (4 + npdu_len + apdu_len));
+    assert(!bvlc_address_different(&TD.BIP_Addr, &Test_Sent_Message_Dest));
+    assert(Test_Sent_Message_Type == BVLC_ORIGINAL_UNICAST_NPDU);
+    assert(Test_Sent_Message_Length == (4 + npdu_len + apdu_len));
+    assert(Test_Sent_Message_Buffer_Length == (npdu_len + apdu_len));
+    assert(memcmp(Test_Sent_Message_Buffer, pdu, npdu_len + apdu_len) == 0);
+    /* the BVLC header was prepended in place */
+    assert(pdubuf_data(buf) == (pdu - 4));
+    assert(pdubuf_headroom(buf) == (PDUBUF_HEADROOM - 4));
+    pdubuf_unref(buf);
+    assert(pdubuf_free_count() == PDUBUF_POOL_SIZE);
+    /* without headroom, the NPDU is copied */
+    buf = pdubuf_alloc(0);
+    assert(buf);
+    pdu = pdubuf_put(buf, npdu_len + apdu_len);
+    assert(pdu);
+    memcpy(pdu, Test_Sent_Message_Buffer, npdu_len + apdu_len);
+    Test_Sent_Message_Type = 0;
+    result = bvlc_send_pdubuf(&dest, &npdu_data, buf);
+    assert(result == (4 + npdu_len + apdu_len));
+    assert(Test_Sent_Message_Type == BVLC_ORIGINAL_UNICAST_NPDU);
+    assert(pdubuf_length(buf) == (npdu_len + apdu_len));
+    pdubuf_unref(buf);
+    /* an invalid address */
+    buf = pdubuf_alloc(PDUBUF_HEADROOM);
+    dest.mac_len = 3;
+    dest.net = 0;
+    assert(bvlc_send_pdubuf(&dest, &npdu_data, buf) == -1);
+    assert(pdubuf_length(buf) == 0);
+    pdubuf_unref(buf);
+    test_cleanup();
+}
+
 int main(void)
 {
     /* individual tests */
     test_BBMD_Result();
     test_Initiate_Original_Broadcast_NPDU();
+    test_Distribute_Broadcast_To_Network();
+    test_Duplicate_Broadcast();
+    test_Multicast_Group_BDT();
+    test_Foreign_Device_Table();
+    test_Send_PDU_Buffer();
 
     return 0;
 }
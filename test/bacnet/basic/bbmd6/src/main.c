@@ -41,6 +41,10 @@ static uint8_t Test_Sent_Message_Length;
 static uint8_t Test_Sent_Message_Buffer[MAX_MPDU];
 static uint16_t Test_Sent_Message_Buffer_Length;
 static BACNET_IP6_ADDRESS Test_Sent_Message_Dest;
+/* for the batch sent from the handler */
+static unsigned Test_Sent_Multiple_Count;
+static BACNET_IP6_ADDRESS Test_Sent_Multiple_Dest[8];
+static uint8_t Test_Sent_Multiple_Type;
 
 /* network stub functions */
 /**
@@ -97,6 +101,51 @@ int bip6_send_mpdu(
     return 0;
 }
 
+/**
+ * The send function of one MPDU to many destinations.
+ *
+ * @param dest - BACNET_IP6_ADDRESS array of destinations
+ * @param dest_count - number of destinations
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return number of destinations the MPDU was sent to
+ */
+int bip6_send_mpdu_multiple(
+    const BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    const uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    uint16_t message_length = 0;
+    unsigned i = 0;
+
+    (void)bvlc6_decode_header(
+        mtu, mtu_len, &Test_Sent_Multiple_Type, &message_length);
+    Test_Sent_Multiple_Count = dest_count;
+    for (i = 0; (i < dest_count) && (i < 8); i++) {
+        bvlc6_address_copy(&Test_Sent_Multiple_Dest[i], &dest[i]);
+    }
+
+    return (int)dest_count;
+}
+
+/**
+ * @brief Determine if an address was in the last batch sent
+ */
+static bool test_sent_multiple_dest(const BACNET_IP6_ADDRESS *addr)
+{
+    unsigned i = 0;
+
+    for (i = 0; (i < Test_Sent_Multiple_Count) && (i < 8); i++) {
+        if (!bvlc6_address_different(&Test_Sent_Multiple_Dest[i], addr)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /**
  * @brief Leave a multicast group
  */
@@ -285,6 +334,62 @@ static void test_Execute_Virtual_Address_Resolution(void)
     test_cleanup();
 }
 
+/**
+ * @brief Test the VMAC table lookups by VMAC address
+ */
+static void test_VMAC_Find_By_Data(void)
+{
+    struct vmac_data vmac = { 0 };
+    uint32_t device_id = 0;
+    uint32_t i = 0;
+    bool status = false;
+
+    VMAC_Init();
+    vmac.mac_len = 18;
+    for (i = 0; i < 100; i++) {
+        vmac.mac[15] = (uint8_t)i;
+        status = VMAC_Add(1000 + i, &vmac);
+        assert(status);
+    }
+    assert(VMAC_Count() == 100);
+    for (i = 0; i < 100; i++) {
+        vmac.mac[15] = (uint8_t)i;
+        status = VMAC_Find_By_Data(&vmac, &device_id);
+        assert(status);
+        assert(device_id == (1000 + i));
+    }
+    /* deleted addresses are not found */
+    for (i = 0; i < 100; i += 2) {
+        status = VMAC_Delete(1000 + i);
+        assert(status);
+    }
+    for (i = 0; i < 100; i++) {
+        vmac.mac[15] = (uint8_t)i;
+        status = VMAC_Find_By_Data(&vmac, &device_id);
+        if ((i % 2) == 0) {
+            assert(!status);
+        } else {
+            assert(status);
+            assert(device_id == (1000 + i));
+        }
+    }
+    /* a different length is a different address */
+    vmac.mac[15] = 1;
+    vmac.mac_len = 17;
+    status = VMAC_Find_By_Data(&vmac, &device_id);
+    assert(!status);
+    /* a deleted device ID may be added with another address */
+    vmac.mac_len = 18;
+    vmac.mac[15] = 200;
+    status = VMAC_Add(1000, &vmac);
+    assert(status);
+    status = VMAC_Find_By_Data(&vmac, &device_id);
+    assert(status);
+    assert(device_id == 1000);
+    VMAC_Cleanup();
+    assert(VMAC_Count() == 0);
+}
+
 static void test_BBMD_Result(void)
 {
     int result = 0;
@@ -323,11 +428,238 @@ static void test_BBMD_Result(void)
     }
 }
 
+/**
+ * @brief Test the BBMD foreign device table registration
+ */
+static void test_BBMD_Register_Foreign_Device(void)
+{
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint16_t mtu_len = 0;
+    uint32_t test_vmac_src = 0;
+    uint16_t test_result_code = 0;
+    const BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *fdt_entry;
+    unsigned count = 0;
+    int result = 0;
+
+    test_setup();
+    mtu_len = bvlc6_encode_register_foreign_device(
+        &mtu[0], sizeof(mtu), TD.Device_ID, 60);
+    result = bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Type == BVLC6_RESULT);
+    assert(!bvlc6_address_different(&Test_Sent_Message_Dest, &TD.BIP6_Addr));
+    bvlc6_decode_result(
+        Test_Sent_Message_Buffer, Test_Sent_Message_Buffer_Length,
+        &test_vmac_src, &test_result_code);
+    assert(test_vmac_src == IUT.Device_ID);
+    assert(test_result_code == BVLC6_RESULT_SUCCESSFUL_COMPLETION);
+    assert(VMAC_Find_By_Key(TD.Device_ID) != NULL);
+    /* re-registration restarts the timer of the same entry */
+    result = bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result == 0);
+    for (fdt_entry = bvlc6_fdt_list(); fdt_entry;
+         fdt_entry = fdt_entry->next) {
+        if (fdt_entry->valid) {
+            assert(!bvlc6_address_different(
+                &fdt_entry->bip6_address, &TD.BIP6_Addr));
+            assert(fdt_entry->ttl_seconds == 60);
+            assert(fdt_entry->ttl_seconds_remaining == 90);
+            count++;
+        }
+    }
+    assert(count == 1);
+    /* delete the entry, then fail to delete it again */
+    mtu_len = bvlc6_encode_delete_foreign_device(
+        &mtu[0], sizeof(mtu), TD.Device_ID, &TD.BIP6_Addr);
+    result = bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result == 0);
+    bvlc6_decode_result(
+        Test_Sent_Message_Buffer, Test_Sent_Message_Buffer_Length,
+        &test_vmac_src, &test_result_code);
+    assert(test_result_code == BVLC6_RESULT_SUCCESSFUL_COMPLETION);
+    result = bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result == 0);
+    bvlc6_decode_result(
+        Test_Sent_Message_Buffer, Test_Sent_Message_Buffer_Length,
+        &test_vmac_src, &test_result_code);
+    assert(test_result_code == BVLC6_RESULT_DELETE_FOREIGN_DEVICE_NAK);
+    /* the entry expires without re-registration */
+    mtu_len = bvlc6_encode_register_foreign_device(
+        &mtu[0], sizeof(mtu), TD.Device_ID, 60);
+    (void)bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    bvlc6_maintenance_timer(89);
+    assert(bvlc6_fdt_list()->valid);
+    bvlc6_maintenance_timer(1);
+    assert(!bvlc6_fdt_list()->valid);
+    test_cleanup();
+}
+
+/**
+ * @brief Test the BBMD forwarding of broadcasts from foreign devices,
+ *  peer BBMDs, and the local multicast domain
+ */
+static void test_BBMD_Forwarding(void)
+{
+    uint8_t pdu[MAX_MPDU] = { 0 };
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint16_t mtu_len = 0;
+    int npdu_len = 0;
+    int pdu_len = 0;
+    uint32_t test_vmac_src = 0;
+    uint16_t test_result_code = 0;
+    BACNET_IP6_ADDRESS peer_addr = { 0 };
+    BACNET_IP6_ADDRESS node_addr = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int result = 0;
+
+    test_setup();
+    bvlc6_address_set(
+        &peer_addr, 0x2001, 0x0DBB, 0xAC10, 0xFE02, 0, 0, 1,
+        BIP6_MULTICAST_GROUP_ID);
+    bvlc6_address_set(
+        &node_addr, 0x2001, 0x0DBB, 0xAC10, 0xFE01, 0, 0, 7,
+        BIP6_MULTICAST_GROUP_ID);
+    assert(bvlc6_bdt_entry_add(&peer_addr));
+    /* an unconfirmed broadcast NPDU */
+    dest.net = BACNET_BROADCAST_NETWORK;
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(&pdu[0], &dest, &TD.BACnet_Address, &npdu_data);
+    pdu_len = npdu_len + iam_encode_apdu(
+                             &pdu[npdu_len], TD.Device_ID, MAX_APDU,
+                             SEGMENTATION_NONE, BACNET_VENDOR_ID);
+    /* only a registered foreign device may distribute a broadcast */
+    mtu_len = bvlc6_encode_distribute_broadcast_to_network(
+        &mtu[0], sizeof(mtu), TD.Device_ID, pdu, pdu_len);
+    Test_Sent_Multiple_Count = 0;
+    result = bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Multiple_Count == 0);
+    bvlc6_decode_result(
+        Test_Sent_Message_Buffer, Test_Sent_Message_Buffer_Length,
+        &test_vmac_src, &test_result_code);
+    assert(
+        test_result_code == BVLC6_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK);
+    mtu_len = bvlc6_encode_register_foreign_device(
+        &mtu[0], sizeof(mtu), TD.Device_ID, 60);
+    (void)bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    mtu_len = bvlc6_encode_distribute_broadcast_to_network(
+        &mtu[0], sizeof(mtu), TD.Device_ID, pdu, pdu_len);
+    result = bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result > 0);
+    /* local multicast and the peer BBMD, but not back to the originator */
+    assert(Test_Sent_Multiple_Type == BVLC6_FORWARDED_NPDU);
+    assert(Test_Sent_Multiple_Count == 2);
+    assert(test_sent_multiple_dest(&IUT.BIP6_Broadcast_Addr));
+    assert(test_sent_multiple_dest(&peer_addr));
+    assert(!test_sent_multiple_dest(&TD.BIP6_Addr));
+    /* from the local multicast domain: the peer BBMD and foreign device */
+    mtu_len = bvlc6_encode_original_broadcast(
+        &mtu[0], sizeof(mtu), 4321, pdu, pdu_len);
+    Test_Sent_Multiple_Count = 0;
+    result = bvlc6_bbmd_enabled_handler(
+        &node_addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result > 0);
+    assert(Test_Sent_Multiple_Type == BVLC6_FORWARDED_NPDU);
+    assert(Test_Sent_Multiple_Count == 2);
+    assert(test_sent_multiple_dest(&peer_addr));
+    assert(test_sent_multiple_dest(&TD.BIP6_Addr));
+    /* from a peer BBMD: local multicast and the foreign device */
+    mtu_len = bvlc6_encode_forwarded_npdu(
+        &mtu[0], sizeof(mtu), 4321, &node_addr, pdu, pdu_len);
+    Test_Sent_Multiple_Count = 0;
+    result = bvlc6_bbmd_enabled_handler(
+        &peer_addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result > 0);
+    assert(Test_Sent_Multiple_Count == 2);
+    assert(test_sent_multiple_dest(&IUT.BIP6_Broadcast_Addr));
+    assert(test_sent_multiple_dest(&TD.BIP6_Addr));
+    assert(VMAC_Find_By_Key(4321) != NULL);
+    /* not from a peer BBMD: delivered, but not forwarded */
+    Test_Sent_Multiple_Count = 0;
+    result = bvlc6_bbmd_enabled_handler(
+        &node_addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result > 0);
+    assert(Test_Sent_Multiple_Count == 0);
+    /* our own broadcasts go to the peer BBMD and foreign device */
+    bvlc6_send_pdu(&dest, &npdu_data, pdu, pdu_len);
+    assert(Test_Sent_Message_Type == BVLC6_ORIGINAL_BROADCAST_NPDU);
+    assert(Test_Sent_Multiple_Count == 2);
+    assert(test_sent_multiple_dest(&peer_addr));
+    assert(test_sent_multiple_dest(&TD.BIP6_Addr));
+    bvlc6_bdt_list_clear();
+    assert(!bvlc6_bdt_list()->valid);
+    test_cleanup();
+}
+
+/**
+ * @brief Test the BBMD forwarding of Address-Resolution
+ */
+static void test_BBMD_Address_Resolution(void)
+{
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint16_t mtu_len = 0;
+    uint32_t test_vmac_src = 0;
+    uint32_t test_vmac_dst = 0;
+    BACNET_IP6_ADDRESS peer_addr = { 0 };
+    struct vmac_data *vmac = NULL;
+    int function_len = 0;
+    int result = 0;
+
+    test_setup();
+    bvlc6_address_set(
+        &peer_addr, 0x2001, 0x0DBB, 0xAC10, 0xFE02, 0, 0, 1,
+        BIP6_MULTICAST_GROUP_ID);
+    assert(bvlc6_bdt_entry_add(&peer_addr));
+    /* resolution of another node is forwarded to the peer BBMD */
+    mtu_len = bvlc6_encode_address_resolution(
+        &mtu[0], sizeof(mtu), TD.Device_ID, 4321);
+    Test_Sent_Multiple_Count = 0;
+    result = bvlc6_bbmd_enabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Multiple_Type == BVLC6_FORWARDED_ADDRESS_RESOLUTION);
+    assert(Test_Sent_Multiple_Count == 1);
+    assert(test_sent_multiple_dest(&peer_addr));
+    /* forwarded resolution of me is answered to the originator */
+    mtu_len = bvlc6_encode_forwarded_address_resolution(
+        &mtu[0], sizeof(mtu), TD.Device_ID, IUT.Device_ID, &TD.BIP6_Addr);
+    result = bvlc6_bbmd_disabled_handler(
+        &peer_addr, &TD.BACnet_Address, &mtu[0], mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Type == BVLC6_ADDRESS_RESOLUTION_ACK);
+    assert(!bvlc6_address_different(&Test_Sent_Message_Dest, &TD.BIP6_Addr));
+    function_len = bvlc6_decode_address_resolution_ack(
+        Test_Sent_Message_Buffer, Test_Sent_Message_Buffer_Length,
+        &test_vmac_src, &test_vmac_dst);
+    assert(function_len > 0);
+    assert(test_vmac_src == IUT.Device_ID);
+    assert(test_vmac_dst == TD.Device_ID);
+    /* the VMAC is the originator, not the peer BBMD */
+    vmac = VMAC_Find_By_Key(TD.Device_ID);
+    assert(vmac != NULL);
+    assert(vmac->mac_len == 18);
+    assert(memcmp(vmac->mac, TD.BIP6_Addr.address, IP6_ADDRESS_MAX) == 0);
+    test_cleanup();
+}
+
 int main(void)
 {
     test_BBMD_Result();
     test_Execute_Virtual_Address_Resolution();
     test_Initiate_Original_Broadcast_NPDU();
+    test_VMAC_Find_By_Data();
+    test_BBMD_Register_Foreign_Device();
+    test_BBMD_Forwarding();
+    test_BBMD_Address_Resolution();
 
     return 0;
 }
@@ -139,6 +139,8 @@ static void testAddressFile(void)
     zassert_equal(address_count(), 1, NULL);
     address_remove_device(device_id);
     zassert_equal(address_count(), 0, NULL);
+    /* address_init() loads the file, so leave none for the next tests */
+    (void)remove(Address_Cache_Filename);
 }
 #endif
 
@@ -262,6 +264,276 @@ static void testAddress(void)
         zassert_equal(count, (MAX_ADDRESS_CACHE - i - 1), NULL);
     }
 }
+
+/**
+ * @brief Test that the least recently used entry is removed when full
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressLRU)
+#else
+static void testAddressLRU(void)
+#endif
+{
+    unsigned i, count;
+    BACNET_ADDRESS src;
+    BACNET_ADDRESS test_address;
+    unsigned test_max_apdu = 0;
+    uint32_t test_device_id = 0;
+
+    address_init();
+    /* static entries from the address cache file are kept */
+    count = address_count();
+    for (i = 0; i < (MAX_ADDRESS_CACHE - count); i++) {
+        set_address(i, &src);
+        address_add(1000 + i, 480, &src);
+    }
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE, NULL);
+    /* use the oldest entry, and make the next oldest static */
+    zassert_true(
+        address_get_by_device(1000, &test_max_apdu, &test_address), NULL);
+    address_set_device_TTL(1001, 0, true);
+    /* the least recently used entry that is not static is replaced */
+    set_address(1, &src);
+    src.net = 8;
+    address_add(5000, 480, &src);
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE, NULL);
+    zassert_true(
+        address_get_by_device(5000, &test_max_apdu, &test_address), NULL);
+    zassert_true(bacnet_address_same(&test_address, &src), NULL);
+    zassert_true(address_get_device_id(&src, &test_device_id), NULL);
+    zassert_equal(test_device_id, 5000, NULL);
+    zassert_true(
+        address_get_by_device(1000, &test_max_apdu, &test_address), NULL);
+    zassert_true(
+        address_get_by_device(1001, &test_max_apdu, &test_address), NULL);
+    zassert_false(
+        address_get_by_device(1002, &test_max_apdu, &test_address), NULL);
+    set_address(2, &src);
+    zassert_false(address_get_device_id(&src, &test_device_id), NULL);
+    /* a bind request also replaces the least recently used entry */
+    zassert_false(
+        address_bind_request(6000, &test_max_apdu, &test_address), NULL);
+    zassert_false(
+        address_get_by_device(1003, &test_max_apdu, &test_address), NULL);
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE - 1, NULL);
+    set_address(2, &src);
+    src.net = 8;
+    address_add_binding(6000, 480, &src);
+    zassert_true(
+        address_bind_request(6000, &test_max_apdu, &test_address), NULL);
+    zassert_true(bacnet_address_same(&test_address, &src), NULL);
+    zassert_true(address_get_device_id(&src, &test_device_id), NULL);
+    zassert_equal(test_device_id, 6000, NULL);
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE, NULL);
+    /* expired entries are removed, except static entries */
+    address_cache_timer(60000);
+    address_cache_timer(60000);
+    zassert_equal(address_count(), count + 1, NULL);
+    zassert_true(
+        address_get_by_device(1001, &test_max_apdu, &test_address), NULL);
+    address_init();
+    zassert_equal(address_count(), count, NULL);
+}
+
+/**
+ * @brief Test that entries expire once their time to live has passed
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressTimeToLive)
+#else
+static void testAddressTimeToLive(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    BACNET_ADDRESS test_address;
+    unsigned test_max_apdu = 0;
+    uint32_t test_ttl = 0;
+    unsigned count;
+
+    address_init();
+    count = address_count();
+    set_address(7, &src);
+    address_add(7000, 480, &src);
+    zassert_true(
+        address_device_bind_request(
+            7000, &test_ttl, &test_max_apdu, &test_address),
+        NULL);
+    zassert_equal(test_ttl, 3600, NULL);
+    address_cache_timer(600);
+    zassert_true(
+        address_device_bind_request(
+            7000, &test_ttl, &test_max_apdu, &test_address),
+        NULL);
+    zassert_equal(test_ttl, 3000, NULL);
+    address_set_device_TTL(7000, 10, false);
+    zassert_equal(address_cache_timer_next(), 11, NULL);
+    address_cache_timer(10);
+    zassert_true(
+        address_device_bind_request(
+            7000, &test_ttl, &test_max_apdu, &test_address),
+        NULL);
+    zassert_equal(test_ttl, 0, NULL);
+    address_cache_timer(1);
+    zassert_false(
+        address_get_by_device(7000, &test_max_apdu, &test_address), NULL);
+    zassert_equal(address_count(), count, NULL);
+    /* static entries never expire */
+    address_add(7001, 480, &src);
+    address_set_device_TTL(7001, 0, true);
+    address_cache_timer(60000);
+    zassert_true(
+        address_device_bind_request(
+            7001, &test_ttl, &test_max_apdu, &test_address),
+        NULL);
+    zassert_equal(test_ttl, UINT32_MAX, NULL);
+    address_init();
+}
+
+/**
+ * @brief Test what is known of the capabilities of a device
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressCapability)
+#else
+static void testAddressCapability(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    BACNET_BIT_STRING services;
+    int segmentation = 0;
+    uint16_t vendor_id = 0;
+    bool supported = false;
+
+    address_init();
+    /* unknown devices are not stored */
+    zassert_false(address_device_iam_set(2000, SEGMENTATION_NONE, 260), NULL);
+    zassert_false(address_device_iam(2000, &segmentation, &vendor_id), NULL);
+    set_address(0, &src);
+    address_add(2000, 480, &src);
+    zassert_false(address_device_iam(2000, &segmentation, &vendor_id), NULL);
+    zassert_true(address_device_iam_set(2000, SEGMENTATION_NONE, 260), NULL);
+    zassert_true(address_device_iam(2000, &segmentation, &vendor_id), NULL);
+    zassert_equal(segmentation, SEGMENTATION_NONE, NULL);
+    zassert_equal(vendor_id, 260, NULL);
+    /* services are unknown until they are stored */
+    zassert_false(
+        address_device_service_supported(
+            2000, SERVICE_SUPPORTED_READ_PROP_MULTIPLE, &supported),
+        NULL);
+    bitstring_init(&services);
+    bitstring_set_bit(&services, SERVICE_SUPPORTED_READ_PROPERTY, true);
+    bitstring_set_bit(&services, SERVICE_SUPPORTED_READ_PROP_MULTIPLE, false);
+    zassert_true(address_device_services_set(2000, &services), NULL);
+    zassert_true(
+        address_device_service_supported(
+            2000, SERVICE_SUPPORTED_READ_PROPERTY, &supported),
+        NULL);
+    zassert_true(supported, NULL);
+    zassert_true(
+        address_device_service_supported(
+            2000, SERVICE_SUPPORTED_READ_PROP_MULTIPLE, &supported),
+        NULL);
+    zassert_false(supported, NULL);
+    /* one service is learned from a reject */
+    zassert_false(
+        address_device_service_supported(
+            2000, SERVICE_SUPPORTED_SUBSCRIBE_COV_PROPERTY, &supported),
+        NULL);
+    zassert_true(
+        address_device_service_set(
+            2000, SERVICE_SUPPORTED_SUBSCRIBE_COV_PROPERTY, false),
+        NULL);
+    zassert_true(
+        address_device_service_supported(
+            2000, SERVICE_SUPPORTED_SUBSCRIBE_COV_PROPERTY, &supported),
+        NULL);
+    zassert_false(supported, NULL);
+    /* a new device in the entry is not known */
+    address_remove_device(2000);
+    address_add(2001, 480, &src);
+    zassert_false(address_device_iam(2001, &segmentation, &vendor_id), NULL);
+    zassert_false(
+        address_device_service_supported(
+            2001, SERVICE_SUPPORTED_READ_PROPERTY, &supported),
+        NULL);
+    address_init();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressPersist)
+#else
+static void testAddressPersist(void)
+#endif
+{
+    const char *filename = "address_cache.bin";
+    BACNET_ADDRESS src, test_address;
+    unsigned test_max_apdu = 0;
+    uint32_t device_ttl = 0;
+    int segmentation = 0;
+    uint16_t vendor_id = 0;
+
+#ifdef BACNET_ADDRESS_CACHE_FILE
+    /* start without the bindings that address_init() would load */
+    (void)remove(Address_Cache_Filename);
+#endif
+    (void)remove(filename);
+    address_init();
+    zassert_false(address_cache_file_load(filename), NULL);
+    set_address(1, &src);
+    address_add(1001, 480, &src);
+    zassert_true(address_device_iam_set(1001, SEGMENTATION_NONE, 260), NULL);
+    set_address(2, &src);
+    address_add(1002, 1476, &src);
+    address_set_device_TTL(1002, 0, true);
+    /* a bind request is not kept */
+    zassert_false(address_bind_request(1003, NULL, NULL), NULL);
+    /* the first flush writes the whole file */
+    zassert_equal(address_cache_file_flush(filename), MAX_ADDRESS_CACHE, NULL);
+    zassert_equal(address_cache_file_flush(filename), 0, NULL);
+    /* the bindings are usable right after a restart */
+    address_init();
+    zassert_equal(address_count(), 0, NULL);
+    zassert_true(address_cache_file_load(filename), NULL);
+    zassert_equal(address_count(), 2, NULL);
+    zassert_true(
+        address_get_by_device(1001, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_max_apdu, 480, NULL);
+    set_address(1, &src);
+    zassert_true(bacnet_address_same(&test_address, &src), NULL);
+    zassert_true(address_device_iam(1001, &segmentation, &vendor_id), NULL);
+    zassert_equal(vendor_id, 260, NULL);
+    zassert_false(address_bind_request(1003, NULL, NULL), NULL);
+    /* the static binding stays, the learned one is revalidated */
+    zassert_true(
+        address_device_bind_request(1002, &device_ttl, NULL, NULL), NULL);
+    zassert_equal(device_ttl, 0xFFFFFFFF, NULL);
+    zassert_true(
+        address_device_bind_request(1001, &device_ttl, NULL, NULL), NULL);
+    zassert_true(device_ttl <= 3600, NULL);
+    /* only the changed entries are written */
+    zassert_equal(address_cache_file_flush(filename), MAX_ADDRESS_CACHE, NULL);
+    address_remove_device(1001);
+    zassert_equal(address_cache_file_flush(filename), 1, NULL);
+    address_init();
+    zassert_true(address_cache_file_load(filename), NULL);
+    zassert_equal(address_count(), 1, NULL);
+    zassert_false(address_get_by_device(1001, NULL, &test_address), NULL);
+    zassert_true(address_get_by_device(1002, NULL, &test_address), NULL);
+    /* the changed entries are written by the timer */
+    zassert_true(address_cache_file_persist(filename, 60), NULL);
+    set_address(4, &src);
+    address_add(1004, 480, &src);
+    address_cache_timer(59);
+    zassert_true(address_cache_timer_next() <= 1, NULL);
+    address_cache_timer(1);
+    zassert_equal(address_cache_file_flush(filename), 0, NULL);
+    address_init();
+    zassert_true(address_cache_file_load(filename), NULL);
+    zassert_true(address_get_by_device(1004, NULL, &test_address), NULL);
+    zassert_true(address_cache_file_persist(NULL, 0) == false, NULL);
+    address_init();
+    (void)remove(filename);
+}
 /**
  * @}
  */
@@ -274,13 +546,20 @@ void test_main(void)
 #ifdef BACNET_ADDRESS_CACHE_FILE
     ztest_test_suite(
         address_tests, ztest_unit_test(testAddressFile),
-        ztest_unit_test(testAddress), ztest_unit_test(test_rr_address));
+        ztest_unit_test(testAddress), ztest_unit_test(test_rr_address),
+        ztest_unit_test(testAddressLRU),
+        ztest_unit_test(testAddressTimeToLive),
+        ztest_unit_test(testAddressCapability),
+        ztest_unit_test(testAddressPersist));
 
     ztest_run_test_suite(address_tests);
 #else
     ztest_test_suite(
         address_tests, ztest_unit_test(testAddress),
-        ztest_unit_test(test_rr_address));
+        ztest_unit_test(test_rr_address), ztest_unit_test(testAddressLRU),
+        ztest_unit_test(testAddressTimeToLive),
+        ztest_unit_test(testAddressCapability),
+        ztest_unit_test(testAddressPersist));
 
     ztest_run_test_suite(address_tests);
 #endif
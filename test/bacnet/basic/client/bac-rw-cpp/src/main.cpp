@@ -0,0 +1,223 @@
+/**
+ * @file
+ * @brief test the C++20 coroutine API of the BACnet read and write client
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <cstring>
+#include <vector>
+#include <zephyr/ztest.h>
+#include <bacnet/bacaddr.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/bacerror.h>
+#include <bacnet/npdu.h>
+#include <bacnet/rp.h>
+#include <bacnet/basic/binding/address.h>
+#include <bacnet/basic/client/bac-rw.hpp>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/service/h_apdu.h>
+#include <bacnet/basic/sys/mstimer.h>
+#include <bacnet/basic/tsm/tsm.h>
+#include <bacnet/datalink/datalink.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the device at the other end of the loopback, and the value of the
+   Present_Value of its Analog Value 1 */
+#define TEST_DEVICE_ID 100
+#define TEST_DEVICE_MAC 1
+#define TEST_PRESENT_VALUE 42.0f
+
+/* the reply of the device to the last request, received by the loop */
+static uint8_t Loopback_APDU[MAX_APDU];
+static int Loopback_APDU_Len;
+static unsigned Loopback_Requests;
+static unsigned long Test_Milliseconds;
+
+/**
+ * @brief Make the address of the test device
+ * @param dest - the address
+ */
+static void test_device_address(BACNET_ADDRESS *dest)
+{
+    BACNET_MAC_ADDRESS mac_address = {};
+
+    mac_address.len = 1;
+    mac_address.adr[0] = TEST_DEVICE_MAC;
+    bacnet_address_init(dest, &mac_address, 0, NULL);
+}
+
+/**
+ * @brief Answer a ReadProperty request as the test device: the
+ *  Present_Value of Analog Value 1 is read, any other property is an
+ *  Error, and the other requests are not answered.
+ */
+int datalink_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    BACNET_NPDU_DATA decoded = {};
+    BACNET_READ_PROPERTY_DATA rpdata = {};
+    uint8_t value[8] = { 0 };
+    const uint8_t *apdu;
+    uint8_t invoke_id;
+    int offset;
+    int len;
+
+    (void)dest;
+    (void)npdu_data;
+    offset = bacnet_npdu_decode(pdu, (uint16_t)pdu_len, NULL, NULL, &decoded);
+    if ((offset <= 0) || (pdu_len <= (unsigned)offset + 4)) {
+        return (int)pdu_len;
+    }
+    apdu = &pdu[offset];
+    if (((apdu[0] & 0xF0) != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) ||
+        (apdu[3] != SERVICE_CONFIRMED_READ_PROPERTY)) {
+        return (int)pdu_len;
+    }
+    Loopback_Requests++;
+    invoke_id = apdu[2];
+    len = rp_decode_service_request(
+        &apdu[4], (unsigned)(pdu_len - (unsigned)offset - 4), &rpdata);
+    if ((len > 0) && (rpdata.object_type == OBJECT_ANALOG_VALUE) &&
+        (rpdata.object_instance == 1) &&
+        (rpdata.object_property == PROP_PRESENT_VALUE)) {
+        rpdata.application_data = value;
+        rpdata.application_data_len =
+            encode_application_real(value, TEST_PRESENT_VALUE);
+        Loopback_APDU_Len =
+            rp_ack_encode_apdu(Loopback_APDU, invoke_id, &rpdata);
+    } else {
+        Loopback_APDU_Len = bacerror_encode_apdu(
+            Loopback_APDU, invoke_id, SERVICE_CONFIRMED_READ_PROPERTY,
+            ERROR_CLASS_PROPERTY, ERROR_CODE_UNKNOWN_PROPERTY);
+    }
+
+    return (int)pdu_len;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    std::memset(my_address, 0, sizeof(*my_address));
+}
+
+void datalink_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    bacnet_address_init(dest, NULL, BACNET_BROADCAST_NETWORK, NULL);
+}
+
+unsigned long mstimer_now(void)
+{
+    return Test_Milliseconds;
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
+/**
+ * @brief Run the loop of the application: receive the reply of the
+ *  loopback device, and run the client and the coroutines
+ * @param done - set by the coroutine when it returns
+ */
+static void test_loop(const bool &done)
+{
+    BACNET_ADDRESS src = {};
+    unsigned i;
+
+    test_device_address(&src);
+    for (i = 0; (i < 10) && !done; i++) {
+        if (Loopback_APDU_Len > 0) {
+            int len = Loopback_APDU_Len;
+
+            Loopback_APDU_Len = 0;
+            apdu_handler(&src, Loopback_APDU, (uint16_t)len);
+        }
+        bacnet::read_write_task();
+    }
+}
+
+/**
+ * @brief Read the Present_Value, and a property that the device does not
+ *  have, of the loopback device
+ */
+static bacnet::task test_read_coroutine(
+    bacnet::result &value, bacnet::result &error, bool &done)
+{
+    value = co_await bacnet::read_property(
+        TEST_DEVICE_ID, OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE);
+    error = co_await bacnet::read_property(
+        TEST_DEVICE_ID, OBJECT_ANALOG_VALUE, 1, PROP_DESCRIPTION);
+    done = true;
+}
+
+/**
+ * @brief Start the test with no requests, and with the loopback device
+ *  bound
+ */
+static void test_setup(void)
+{
+    BACNET_ADDRESS dest = {};
+
+    address_init();
+    bacnet_read_write_init();
+    Loopback_APDU_Len = 0;
+    Loopback_Requests = 0;
+    test_device_address(&dest);
+    address_add(TEST_DEVICE_ID, MAX_APDU, &dest);
+}
+
+/**
+ * @brief Test a coroutine that awaits reads through the loopback device
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_cpp_tests, test_read_property_await)
+#else
+static void test_read_property_await(void)
+#endif
+{
+    bacnet::result value;
+    bacnet::result error;
+    bool done = false;
+
+    test_setup();
+    test_read_coroutine(value, error, done);
+    zassert_false(done, NULL);
+    test_loop(done);
+    zassert_true(done, NULL);
+    zassert_equal(Loopback_Requests, 2, NULL);
+    zassert_true(value.ok(), NULL);
+    zassert_equal(value.object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(value.object_property, PROP_PRESENT_VALUE, NULL);
+    zassert_equal(value.values.size(), 1, NULL);
+    zassert_equal(value.values[0].tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    zassert_false(
+        islessgreater(value.values[0].type.Real, TEST_PRESENT_VALUE), NULL);
+    zassert_false(error.ok(), NULL);
+    zassert_equal(error.object_property, PROP_DESCRIPTION, NULL);
+    zassert_equal(error.error_class, ERROR_CLASS_PROPERTY, NULL);
+    zassert_equal(error.error_code, ERROR_CODE_UNKNOWN_PROPERTY, NULL);
+    zassert_true(error.values.empty(), NULL);
+    zassert_true(bacnet_read_write_idle(), NULL);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bac_rw_cpp_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        bac_rw_cpp_tests, ztest_unit_test(test_read_property_await));
+
+    ztest_run_test_suite(bac_rw_cpp_tests);
+}
+#endif
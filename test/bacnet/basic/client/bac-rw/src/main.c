@@ -0,0 +1,519 @@
+/**
+ * @file
+ * @brief test the contexts of the BACnet read and write client
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/abort.h>
+#include <bacnet/bacaddr.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/bacerror.h>
+#include <bacnet/iam.h>
+#include <bacnet/npdu.h>
+#include <bacnet/rp.h>
+#include <bacnet/basic/binding/address.h>
+#include <bacnet/basic/client/bac-rw.h>
+#include <bacnet/basic/service/h_apdu.h>
+#include <bacnet/basic/sys/mstimer.h>
+#include <bacnet/basic/tsm/tsm.h>
+#include <bacnet/datalink/datalink.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the confirmed requests that were sent */
+#define TEST_SENT_MAX 8
+struct test_sent {
+    BACNET_ADDRESS dest;
+    uint8_t invoke_id;
+    uint8_t service;
+};
+static struct test_sent Test_Sent[TEST_SENT_MAX];
+static unsigned Test_Sent_Count;
+static unsigned long Test_Milliseconds;
+
+/* the results given to the result callbacks, one for each device */
+#define TEST_DEVICE_MAX 4
+struct test_result {
+    unsigned count;
+    uint32_t device_id;
+    bool value;
+    float real;
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+};
+static struct test_result Test_Result[TEST_DEVICE_MAX];
+/* the I-Am that were given to the device callbacks */
+static unsigned Test_IAm_Count[TEST_DEVICE_MAX];
+static uint32_t Test_IAm_Device[TEST_DEVICE_MAX];
+
+int datalink_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    BACNET_NPDU_DATA decoded = { 0 };
+    const uint8_t *apdu;
+    int offset;
+
+    (void)npdu_data;
+    offset = bacnet_npdu_decode(pdu, (uint16_t)pdu_len, NULL, NULL, &decoded);
+    if ((offset > 0) && (pdu_len > (unsigned)offset + 3)) {
+        apdu = &pdu[offset];
+        if (((apdu[0] & 0xF0) == PDU_TYPE_CONFIRMED_SERVICE_REQUEST) &&
+            (Test_Sent_Count < TEST_SENT_MAX)) {
+            Test_Sent[Test_Sent_Count].dest = *dest;
+            Test_Sent[Test_Sent_Count].invoke_id = apdu[2];
+            Test_Sent[Test_Sent_Count].service = apdu[3];
+            Test_Sent_Count++;
+        }
+    }
+
+    return (int)pdu_len;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(*my_address));
+}
+
+void datalink_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    bacnet_address_init(dest, NULL, BACNET_BROADCAST_NETWORK, NULL);
+}
+
+unsigned long mstimer_now(void)
+{
+    return Test_Milliseconds;
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
+/**
+ * @brief Make the address of a test device
+ * @param dest - the address
+ * @param mac - the MAC address of the device
+ */
+static void test_device_address(BACNET_ADDRESS *dest, uint8_t mac)
+{
+    BACNET_MAC_ADDRESS mac_address = { 0 };
+
+    mac_address.len = 1;
+    mac_address.adr[0] = mac;
+    bacnet_address_init(dest, &mac_address, 0, NULL);
+}
+
+/**
+ * @brief Bind a test device, whose device instance is 100 times its MAC
+ * @param mac - the MAC address of the device, 1..TEST_DEVICE_MAX
+ * @return the device instance
+ */
+static uint32_t test_device_bind(uint8_t mac)
+{
+    BACNET_ADDRESS dest = { 0 };
+
+    test_device_address(&dest, mac);
+    address_add(100U * mac, MAX_APDU, &dest);
+
+    return 100U * mac;
+}
+
+/**
+ * @brief Keep the result of a request, by the device that it was for
+ */
+static void test_result_callback(
+    void *context,
+    uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    struct test_result *result = context;
+
+    result->count++;
+    result->device_id = device_instance;
+    result->error_class = rp_data->error_class;
+    result->error_code = rp_data->error_code;
+    result->value = false;
+    if (value && (value->tag == BACNET_APPLICATION_TAG_REAL)) {
+        result->value = true;
+        result->real = value->type.Real;
+    }
+}
+
+/**
+ * @brief Keep the I-Am given to the device callback of a context, by the
+ *  vendor filter of the context
+ */
+static void test_iam_callback(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_instance,
+    unsigned max_apdu,
+    int segmentation,
+    uint16_t vendor_id)
+{
+    unsigned index = bacnet_read_write_context_vendor_id_filter(rw_context);
+
+    (void)max_apdu;
+    (void)segmentation;
+    (void)vendor_id;
+    if (index < TEST_DEVICE_MAX) {
+        Test_IAm_Count[index]++;
+        Test_IAm_Device[index] = device_instance;
+    }
+}
+
+/**
+ * @brief Find the confirmed request that was sent to a device
+ * @param mac - the MAC address of the device
+ * @return the request, or NULL if none was sent
+ */
+static const struct test_sent *test_sent_find(uint8_t mac)
+{
+    unsigned i;
+
+    for (i = 0; i < Test_Sent_Count; i++) {
+        if ((Test_Sent[i].dest.mac_len == 1) &&
+            (Test_Sent[i].dest.mac[0] == mac)) {
+            return &Test_Sent[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Receive a ReadProperty-ACK with a REAL value from a test device
+ * @param mac - the MAC address of the device
+ * @param invoke_id - the invoke ID of the request
+ * @param real - the value
+ */
+static void test_receive_read_ack(uint8_t mac, uint8_t invoke_id, float real)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t value[8] = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int apdu_len;
+
+    test_device_address(&src, mac);
+    rpdata.object_type = OBJECT_ANALOG_VALUE;
+    rpdata.object_instance = 1;
+    rpdata.object_property = PROP_PRESENT_VALUE;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    rpdata.application_data = value;
+    rpdata.application_data_len = encode_application_real(value, real);
+    apdu_len = rp_ack_encode_apdu(apdu, invoke_id, &rpdata);
+    zassert_true(apdu_len > 0, NULL);
+    apdu_handler(&src, apdu, (uint16_t)apdu_len);
+}
+
+/**
+ * @brief Receive an Error from a test device
+ * @param mac - the MAC address of the device
+ * @param invoke_id - the invoke ID of the request
+ * @param service - the service of the request
+ */
+static void test_receive_error(uint8_t mac, uint8_t invoke_id, uint8_t service)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int apdu_len;
+
+    test_device_address(&src, mac);
+    apdu_len = bacerror_encode_apdu(
+        apdu, invoke_id, (BACNET_CONFIRMED_SERVICE)service,
+        ERROR_CLASS_PROPERTY, ERROR_CODE_UNKNOWN_PROPERTY);
+    apdu_handler(&src, apdu, (uint16_t)apdu_len);
+}
+
+/**
+ * @brief Receive an Abort from a test device
+ * @param mac - the MAC address of the device
+ * @param invoke_id - the invoke ID of the request
+ */
+static void test_receive_abort(uint8_t mac, uint8_t invoke_id)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int apdu_len;
+
+    test_device_address(&src, mac);
+    apdu_len = abort_encode_apdu(
+        apdu, invoke_id, ABORT_REASON_SEGMENTATION_NOT_SUPPORTED, true);
+    apdu_handler(&src, apdu, (uint16_t)apdu_len);
+}
+
+/**
+ * @brief Receive an I-Am from a test device
+ * @param mac - the MAC address of the device
+ * @param vendor_id - the vendor of the device
+ */
+static void test_receive_iam(uint8_t mac, uint16_t vendor_id)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int apdu_len;
+
+    test_device_address(&src, mac);
+    apdu_len = iam_encode_apdu(
+        apdu, 100U * mac, MAX_APDU, SEGMENTATION_NONE, vendor_id);
+    apdu_handler(&src, apdu, (uint16_t)apdu_len);
+}
+
+/**
+ * @brief Queue a read of the Present_Value of Analog Value 1 of a device
+ * @param rw_context - context of the request
+ * @param device_id - the device
+ * @param result - where the result is kept
+ */
+static void test_read_queue(
+    BACNET_READ_WRITE_CONTEXT *rw_context,
+    uint32_t device_id,
+    struct test_result *result)
+{
+    zassert_true(
+        bacnet_read_write_context_read_property(
+            rw_context, device_id, OBJECT_ANALOG_VALUE, 1,
+            PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, test_result_callback,
+            result),
+        NULL);
+}
+
+/**
+ * @brief Start each test with no requests, bindings, or results
+ */
+static void test_setup(void)
+{
+    address_init();
+    bacnet_read_write_init();
+    apdu_timeout_set(1000);
+    apdu_retries_set(0);
+    memset(Test_Sent, 0, sizeof(Test_Sent));
+    Test_Sent_Count = 0;
+    memset(Test_Result, 0, sizeof(Test_Result));
+    memset(Test_IAm_Count, 0, sizeof(Test_IAm_Count));
+    memset(Test_IAm_Device, 0, sizeof(Test_IAm_Device));
+}
+
+/**
+ * @brief Test that each reply finishes the request of its own context,
+ *  for the ACK, Error, Abort, and timeout of a request
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, test_context_replies)
+#else
+static void test_context_replies(void)
+#endif
+{
+    BACNET_READ_WRITE_CONTEXT *context_a, *context_b;
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    const struct test_sent *sent_1, *sent_2;
+    uint32_t device_1, device_2;
+
+    test_setup();
+    context_a = bacnet_read_write_context_create();
+    context_b = bacnet_read_write_context_create();
+    zassert_not_null(context_a, NULL);
+    zassert_not_null(context_b, NULL);
+    device_1 = test_device_bind(1);
+    device_2 = test_device_bind(2);
+    /* an ACK and an Error, each for the request of its context */
+    test_read_queue(context_a, device_1, &Test_Result[1]);
+    test_read_queue(context_b, device_2, &Test_Result[2]);
+    zassert_equal(bacnet_read_write_context_queue_count(context_a), 1, NULL);
+    zassert_equal(bacnet_read_write_context_queue_count(context_b), 1, NULL);
+    zassert_equal(bacnet_read_write_queue_count(), 0, NULL);
+    bacnet_read_write_task();
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    zassert_equal(bacnet_read_write_context_active_count(context_a), 1, NULL);
+    zassert_equal(bacnet_read_write_context_active_count(context_b), 1, NULL);
+    sent_1 = test_sent_find(1);
+    sent_2 = test_sent_find(2);
+    zassert_not_null(sent_1, NULL);
+    zassert_not_null(sent_2, NULL);
+    zassert_equal(sent_1->service, SERVICE_CONFIRMED_READ_PROPERTY, NULL);
+    test_receive_read_ack(2, sent_2->invoke_id, 2.0f);
+    zassert_equal(Test_Result[2].count, 1, NULL);
+    zassert_equal(Test_Result[2].device_id, device_2, NULL);
+    zassert_true(Test_Result[2].value, NULL);
+    zassert_false(islessgreater(Test_Result[2].real, 2.0f), NULL);
+    zassert_equal(Test_Result[1].count, 0, NULL);
+    test_receive_error(1, sent_1->invoke_id, sent_1->service);
+    bacnet_read_write_task();
+    zassert_equal(Test_Result[1].count, 1, NULL);
+    zassert_equal(Test_Result[1].device_id, device_1, NULL);
+    zassert_false(Test_Result[1].value, NULL);
+    zassert_equal(Test_Result[1].error_class, ERROR_CLASS_PROPERTY, NULL);
+    zassert_equal(Test_Result[1].error_code, ERROR_CODE_UNKNOWN_PROPERTY, NULL);
+    zassert_equal(Test_Result[2].count, 1, NULL);
+    zassert_true(bacnet_read_write_context_idle(context_a), NULL);
+    zassert_true(bacnet_read_write_context_idle(context_b), NULL);
+    /* an Abort of a write, and the timeout of a read */
+    memset(Test_Result, 0, sizeof(Test_Result));
+    Test_Sent_Count = 0;
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 1.0f;
+    zassert_true(
+        bacnet_read_write_context_write_property(
+            context_a, device_1, OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE,
+            &value, 8, BACNET_ARRAY_ALL, test_result_callback,
+            &Test_Result[1]),
+        NULL);
+    test_read_queue(context_b, device_2, &Test_Result[2]);
+    bacnet_read_write_task();
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    sent_1 = test_sent_find(1);
+    zassert_not_null(sent_1, NULL);
+    zassert_equal(sent_1->service, SERVICE_CONFIRMED_WRITE_PROPERTY, NULL);
+    test_receive_abort(1, sent_1->invoke_id);
+    bacnet_read_write_task();
+    zassert_equal(Test_Result[1].count, 1, NULL);
+    zassert_equal(Test_Result[1].error_class, ERROR_CLASS_SERVICES, NULL);
+    zassert_equal(
+        Test_Result[1].error_code, ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED,
+        NULL);
+    zassert_equal(Test_Result[2].count, 0, NULL);
+    tsm_timer_milliseconds(1000);
+    bacnet_read_write_task();
+    zassert_equal(Test_Result[2].count, 1, NULL);
+    zassert_equal(Test_Result[2].error_class, ERROR_CLASS_SERVICES, NULL);
+    zassert_equal(
+        Test_Result[2].error_code, ERROR_CODE_ABORT_TSM_TIMEOUT, NULL);
+    zassert_equal(Test_Result[1].count, 1, NULL);
+    zassert_true(bacnet_read_write_context_idle(context_a), NULL);
+    zassert_true(bacnet_read_write_context_idle(context_b), NULL);
+    zassert_equal(tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS, NULL);
+    bacnet_read_write_context_delete(context_a);
+    bacnet_read_write_context_delete(context_b);
+}
+
+/**
+ * @brief Test the requests to different devices that wait for a reply
+ *  with the same invoke ID, in one context and in two contexts
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, test_context_invoke_id_chain)
+#else
+static void test_context_invoke_id_chain(void)
+#endif
+{
+    BACNET_READ_WRITE_CONTEXT *context_a, *context_b;
+    const struct test_sent *sent;
+    uint8_t invoke_id[255] = { 0 };
+    uint8_t shared_id;
+    unsigned i;
+
+    test_setup();
+    context_a = bacnet_read_write_context_create();
+    context_b = bacnet_read_write_context_create();
+    zassert_not_null(context_a, NULL);
+    zassert_not_null(context_b, NULL);
+    /* leave one invoke ID that no transaction uses, so that the
+       devices get the same invoke ID */
+    for (i = 0; i < 254; i++) {
+        invoke_id[i] = tsm_next_free_invokeID();
+        zassert_not_equal(invoke_id[i], 0, NULL);
+    }
+    test_read_queue(context_a, test_device_bind(1), &Test_Result[1]);
+    test_read_queue(context_a, test_device_bind(2), &Test_Result[2]);
+    test_read_queue(context_b, test_device_bind(3), &Test_Result[3]);
+    bacnet_read_write_task();
+    zassert_equal(Test_Sent_Count, 3, NULL);
+    shared_id = Test_Sent[0].invoke_id;
+    zassert_equal(Test_Sent[1].invoke_id, shared_id, NULL);
+    zassert_equal(Test_Sent[2].invoke_id, shared_id, NULL);
+    /* each reply finds the request of its device */
+    sent = test_sent_find(2);
+    zassert_not_null(sent, NULL);
+    test_receive_read_ack(2, sent->invoke_id, 2.0f);
+    sent = test_sent_find(3);
+    zassert_not_null(sent, NULL);
+    test_receive_read_ack(3, sent->invoke_id, 3.0f);
+    sent = test_sent_find(1);
+    zassert_not_null(sent, NULL);
+    test_receive_read_ack(1, sent->invoke_id, 1.0f);
+    bacnet_read_write_task();
+    for (i = 1; i <= 3; i++) {
+        zassert_equal(Test_Result[i].count, 1, NULL);
+        zassert_equal(Test_Result[i].device_id, 100U * i, NULL);
+        zassert_true(Test_Result[i].value, NULL);
+        zassert_false(islessgreater(Test_Result[i].real, (float)i), NULL);
+    }
+    zassert_true(bacnet_read_write_context_idle(context_a), NULL);
+    zassert_true(bacnet_read_write_context_idle(context_b), NULL);
+    for (i = 0; i < 254; i++) {
+        tsm_free_invoke_id(invoke_id[i]);
+    }
+    zassert_equal(tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS, NULL);
+    bacnet_read_write_context_delete(context_a);
+    bacnet_read_write_context_delete(context_b);
+}
+
+/**
+ * @brief Test that an I-Am is given to the contexts whose vendor filter
+ *  it passes
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, test_context_iam_filter)
+#else
+static void test_context_iam_filter(void)
+#endif
+{
+    BACNET_READ_WRITE_CONTEXT *context_a, *context_b;
+
+    test_setup();
+    context_a = bacnet_read_write_context_create();
+    context_b = bacnet_read_write_context_create();
+    zassert_not_null(context_a, NULL);
+    zassert_not_null(context_b, NULL);
+    /* the vendor filter is also the index of the kept I-Am */
+    bacnet_read_write_context_vendor_id_filter_set(context_a, 1);
+    bacnet_read_write_context_vendor_id_filter_set(context_b, 2);
+    bacnet_read_write_context_device_callback_set(
+        context_a, test_iam_callback);
+    bacnet_read_write_context_device_callback_set(
+        context_b, test_iam_callback);
+    bacnet_read_write_vendor_id_filter_set(4);
+    test_receive_iam(1, 1);
+    zassert_equal(Test_IAm_Count[1], 1, NULL);
+    zassert_equal(Test_IAm_Device[1], 100, NULL);
+    zassert_equal(Test_IAm_Count[2], 0, NULL);
+    test_receive_iam(2, 2);
+    zassert_equal(Test_IAm_Count[1], 1, NULL);
+    zassert_equal(Test_IAm_Count[2], 1, NULL);
+    zassert_equal(Test_IAm_Device[2], 200, NULL);
+    /* a vendor that no filter passes is not bound */
+    test_receive_iam(3, 3);
+    zassert_equal(Test_IAm_Count[1], 1, NULL);
+    zassert_equal(Test_IAm_Count[2], 1, NULL);
+    zassert_false(address_bind_request(300, NULL, NULL), NULL);
+    zassert_true(address_bind_request(100, NULL, NULL), NULL);
+    bacnet_read_write_context_delete(context_a);
+    bacnet_read_write_context_delete(context_b);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bac_rw_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        bac_rw_tests, ztest_unit_test(test_context_replies),
+        ztest_unit_test(test_context_invoke_id_chain),
+        ztest_unit_test(test_context_iam_filter));
+
+    ztest_run_test_suite(bac_rw_tests);
+}
+#endif
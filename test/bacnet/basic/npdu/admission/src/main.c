@@ -0,0 +1,253 @@
+/**
+ * @file
+ * @brief test the admission control of the received NPDU
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacaddr.h>
+#include <bacnet/basic/npdu/h_admission.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* a global broadcast Who-Is without limits */
+static const uint8_t Test_Who_Is[] = { 0x01, 0x20, 0xFF, 0xFF,
+                                       0x00, 0xFF, 0x10, 0x08 };
+/* a Who-Is-Router-To-Network */
+static const uint8_t Test_Network[] = { 0x01, 0x80, 0x00 };
+
+static uint16_t test_read_property_encode(uint8_t *pdu, uint8_t invoke_id)
+{
+    const uint8_t rp[] = { 0x01, 0x04, 0x00, 0x05, 0x00, 0x0C, 0x0C,
+                           0x00, 0x00, 0x00, 0x01, 0x19, 0x55 };
+
+    memcpy(pdu, rp, sizeof(rp));
+    pdu[4] = invoke_id;
+
+    return sizeof(rp);
+}
+
+static uint16_t test_write_property_encode(uint8_t *pdu, uint8_t invoke_id)
+{
+    const uint8_t wp[] = { 0x01, 0x04, 0x00, 0x05, 0x00, 0x0F,
+                           0x0C, 0x00, 0x00, 0x00, 0x01, 0x19,
+                           0x55, 0x3E, 0x44, 0x41, 0xF0, 0x00,
+                           0x00, 0x3F };
+
+    memcpy(pdu, wp, sizeof(wp));
+    pdu[4] = invoke_id;
+
+    return sizeof(wp);
+}
+
+static uint16_t test_simple_ack_encode(uint8_t *pdu, uint8_t invoke_id)
+{
+    const uint8_t ack[] = { 0x01, 0x00, 0x20, 0x00, 0x0F };
+
+    memcpy(pdu, ack, sizeof(ack));
+    pdu[3] = invoke_id;
+
+    return sizeof(ack);
+}
+
+static void test_source_init(BACNET_ADDRESS *src, uint8_t mac)
+{
+    memset(src, 0, sizeof(*src));
+    src->mac_len = 1;
+    src->mac[0] = mac;
+}
+
+/**
+ * @brief Test the classes of the received messages
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(admission_tests, testAdmissionClassify)
+#else
+static void testAdmissionClassify(void)
+#endif
+{
+    uint8_t pdu[32] = { 0 };
+    uint16_t pdu_len;
+
+    zassert_equal(
+        bacnet_admission_classify(Test_Who_Is, sizeof(Test_Who_Is)),
+        BACNET_ADMISSION_CLASS_UNCONFIRMED, NULL);
+    zassert_equal(
+        bacnet_admission_classify(Test_Network, sizeof(Test_Network)),
+        BACNET_ADMISSION_CLASS_NETWORK, NULL);
+    pdu_len = test_read_property_encode(pdu, 1);
+    zassert_equal(
+        bacnet_admission_classify(pdu, pdu_len), BACNET_ADMISSION_CLASS_READ,
+        NULL);
+    pdu_len = test_write_property_encode(pdu, 1);
+    zassert_equal(
+        bacnet_admission_classify(pdu, pdu_len), BACNET_ADMISSION_CLASS_WRITE,
+        NULL);
+    pdu_len = test_simple_ack_encode(pdu, 1);
+    zassert_equal(
+        bacnet_admission_classify(pdu, pdu_len), BACNET_ADMISSION_CLASS_REPLY,
+        NULL);
+    zassert_equal(
+        bacnet_admission_classify(pdu, 1), BACNET_ADMISSION_CLASS_INVALID,
+        NULL);
+    zassert_equal(
+        bacnet_admission_classify(NULL, 0), BACNET_ADMISSION_CLASS_INVALID,
+        NULL);
+}
+
+/**
+ * @brief Test the token buckets, and the priority of the writes
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(admission_tests, testAdmissionRate)
+#else
+static void testAdmissionRate(void)
+#endif
+{
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS deferred_src = { 0 };
+    uint8_t pdu[32] = { 0 };
+    uint16_t pdu_len;
+    uint8_t invoke_id;
+
+    test_source_init(&src, 0x01);
+    bacnet_admission_init();
+    /* without a rate, every message is admitted */
+    zassert_false(bacnet_admission_enabled(), NULL);
+    for (invoke_id = 0; invoke_id < 10; invoke_id++) {
+        pdu_len = test_read_property_encode(pdu, 1);
+        zassert_equal(
+            bacnet_admission_check(&src, pdu, pdu_len),
+            BACNET_ADMISSION_ACCEPT, NULL);
+    }
+    /* a bucket of 4 tokens keeps 1 token for the writes */
+    bacnet_admission_rate_set(10, 4);
+    zassert_true(bacnet_admission_enabled(), NULL);
+    for (invoke_id = 0; invoke_id < 3; invoke_id++) {
+        pdu_len = test_read_property_encode(pdu, invoke_id);
+        zassert_equal(
+            bacnet_admission_check(&src, pdu, pdu_len),
+            BACNET_ADMISSION_DEFER, NULL);
+    }
+    pdu_len = test_read_property_encode(pdu, invoke_id++);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_DROP,
+        NULL);
+    zassert_equal(
+        bacnet_admission_dropped(BACNET_ADMISSION_DROP_RATE), 1, NULL);
+    pdu_len = test_write_property_encode(pdu, invoke_id++);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_ACCEPT,
+        NULL);
+    pdu_len = test_write_property_encode(pdu, invoke_id++);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_DROP,
+        NULL);
+    zassert_equal(
+        bacnet_admission_dropped(BACNET_ADMISSION_DROP_RATE), 2, NULL);
+    /* replies and network layer messages are always admitted */
+    pdu_len = test_simple_ack_encode(pdu, invoke_id);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_ACCEPT,
+        NULL);
+    zassert_equal(
+        bacnet_admission_check(&src, Test_Network, sizeof(Test_Network)),
+        BACNET_ADMISSION_ACCEPT, NULL);
+    /* another source has its own bucket */
+    test_source_init(&deferred_src, 0x02);
+    pdu_len = test_write_property_encode(pdu, invoke_id++);
+    zassert_equal(
+        bacnet_admission_check(&deferred_src, pdu, pdu_len),
+        BACNET_ADMISSION_ACCEPT, NULL);
+    /* the deferred reads are taken in their order */
+    for (invoke_id = 0; invoke_id < 3; invoke_id++) {
+        memset(pdu, 0, sizeof(pdu));
+        pdu_len = bacnet_admission_deferred(&deferred_src, pdu, sizeof(pdu));
+        zassert_equal(pdu_len, 13, NULL);
+        zassert_equal(pdu[4], invoke_id, NULL);
+        zassert_true(bacnet_address_same(&deferred_src, &src), NULL);
+    }
+    zassert_equal(bacnet_admission_deferred(&deferred_src, pdu, 32), 0, NULL);
+    zassert_equal(bacnet_admission_deferred_count(), 3, NULL);
+    /* the timer refills the bucket */
+    bacnet_admission_timer(100);
+    pdu_len = test_write_property_encode(pdu, invoke_id++);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_ACCEPT,
+        NULL);
+}
+
+/**
+ * @brief Test the duplicate Who-Is and the retried requests
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(admission_tests, testAdmissionDuplicate)
+#else
+static void testAdmissionDuplicate(void)
+#endif
+{
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS other_src = { 0 };
+    uint8_t pdu[32] = { 0 };
+    uint16_t pdu_len;
+
+    test_source_init(&src, 0x01);
+    test_source_init(&other_src, 0x02);
+    bacnet_admission_init();
+    bacnet_admission_rate_set(100, 100);
+    zassert_equal(
+        bacnet_admission_check(&src, Test_Who_Is, sizeof(Test_Who_Is)),
+        BACNET_ADMISSION_ACCEPT, NULL);
+    zassert_equal(
+        bacnet_admission_check(&src, Test_Who_Is, sizeof(Test_Who_Is)),
+        BACNET_ADMISSION_DROP, NULL);
+    zassert_equal(
+        bacnet_admission_dropped(BACNET_ADMISSION_DROP_DISCOVERY), 1, NULL);
+    zassert_equal(
+        bacnet_admission_check(&other_src, Test_Who_Is, sizeof(Test_Who_Is)),
+        BACNET_ADMISSION_ACCEPT, NULL);
+    pdu_len = test_write_property_encode(pdu, 7);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_ACCEPT,
+        NULL);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_DROP,
+        NULL);
+    zassert_equal(
+        bacnet_admission_dropped(BACNET_ADMISSION_DROP_RETRY), 1, NULL);
+    pdu_len = test_write_property_encode(pdu, 8);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_ACCEPT,
+        NULL);
+    /* the requests are forgotten after a while */
+    bacnet_admission_timer(BACNET_ADMISSION_DUPLICATE_MS);
+    zassert_equal(
+        bacnet_admission_check(&src, Test_Who_Is, sizeof(Test_Who_Is)),
+        BACNET_ADMISSION_ACCEPT, NULL);
+    pdu_len = test_write_property_encode(pdu, 7);
+    zassert_equal(
+        bacnet_admission_check(&src, pdu, pdu_len), BACNET_ADMISSION_ACCEPT,
+        NULL);
+    zassert_equal(bacnet_admission_accepted(), 6, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(admission_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        admission_tests, ztest_unit_test(testAdmissionClassify),
+        ztest_unit_test(testAdmissionRate),
+        ztest_unit_test(testAdmissionDuplicate));
+
+    ztest_run_test_suite(admission_tests);
+}
+#endif
@@ -0,0 +1,419 @@
+/**
+ * @file
+ * @brief test a caching read proxy for the devices behind a router
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/cov.h>
+#include <bacnet/npdu.h>
+#include <bacnet/rp.h>
+#include <bacnet/rpm.h>
+#include <bacnet/wp.h>
+#include <bacnet/basic/npdu/h_router.h>
+#include <bacnet/basic/npdu/h_router_proxy.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* what a port sent out of its datalink */
+struct test_sent {
+    unsigned count;
+    BACNET_ADDRESS dest;
+    uint8_t pdu[BACNET_ROUTER_PDU_MAX];
+    unsigned pdu_len;
+};
+
+static BACNET_ROUTING_PORT Test_Port_1;
+static BACNET_ROUTING_PORT Test_Port_2;
+static struct test_sent Test_Sent_1;
+static struct test_sent Test_Sent_2;
+/* the MS/TP device on network 2 */
+static BACNET_ADDRESS Test_Device;
+
+static void test_sent_record(
+    struct test_sent *sent, BACNET_ADDRESS *dest, uint8_t *pdu, unsigned len)
+{
+    sent->count++;
+    bacnet_address_copy(&sent->dest, dest);
+    memcpy(sent->pdu, pdu, len);
+    sent->pdu_len = len;
+}
+
+static int test_send_pdu_1(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)npdu_data;
+    test_sent_record(&Test_Sent_1, dest, pdu, pdu_len);
+    return (int)pdu_len;
+}
+
+static int test_send_pdu_2(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)npdu_data;
+    test_sent_record(&Test_Sent_2, dest, pdu, pdu_len);
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Set up a router between network 1 on port 1 and network 2
+ *  on port 2, with the Present_Value of Analog Input 1 of the device
+ *  at MAC 5 on network 2 in the cache
+ */
+static void test_setup(void)
+{
+    BACNET_ADDRESS address = { 0 };
+
+    bacnet_router_cleanup();
+    memset(&Test_Sent_1, 0, sizeof(Test_Sent_1));
+    memset(&Test_Sent_2, 0, sizeof(Test_Sent_2));
+    address.mac_len = 1;
+    address.mac[0] = 0x80;
+    bacnet_router_port_add(&Test_Port_1, 1, &address, test_send_pdu_1);
+    address.mac[0] = 0x81;
+    bacnet_router_port_add(&Test_Port_2, 2, &address, test_send_pdu_2);
+    bacnet_router_proxy_init();
+    memset(&Test_Device, 0, sizeof(Test_Device));
+    Test_Device.net = 2;
+    Test_Device.len = 1;
+    Test_Device.adr[0] = 0x05;
+    zassert_true(
+        bacnet_router_proxy_add(
+            &Test_Device, OBJECT_ANALOG_INPUT, 1, PROP_PRESENT_VALUE,
+            BACNET_ARRAY_ALL, 10),
+        NULL);
+}
+
+/**
+ * @brief Send an APDU from a client on network 1 to the device
+ * @param mac - MAC address of the client on network 1
+ * @param apdu - the APDU
+ * @param apdu_len - number of bytes in the APDU
+ */
+static void test_client_send(uint8_t mac, const uint8_t *apdu, int apdu_len)
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, &Test_Device, NULL, &npdu_data);
+    memcpy(&pdu[len], apdu, (size_t)apdu_len);
+    src.mac_len = 1;
+    src.mac[0] = mac;
+    zassert_equal(
+        bacnet_router_npdu_handler(
+            &Test_Port_1, &src, pdu, (uint16_t)(len + apdu_len)),
+        0, NULL);
+}
+
+/**
+ * @brief Send an APDU from the device to a client on network 1
+ * @param mac - MAC address of the client on network 1
+ * @param apdu - the APDU
+ * @param apdu_len - number of bytes in the APDU
+ */
+static void test_device_send(uint8_t mac, const uint8_t *apdu, int apdu_len)
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS src = { 0 }, dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    dest.net = 1;
+    dest.len = 1;
+    dest.adr[0] = mac;
+    len = npdu_encode_pdu(pdu, &dest, NULL, &npdu_data);
+    memcpy(&pdu[len], apdu, (size_t)apdu_len);
+    src.mac_len = 1;
+    src.mac[0] = Test_Device.adr[0];
+    zassert_equal(
+        bacnet_router_npdu_handler(
+            &Test_Port_2, &src, pdu, (uint16_t)(len + apdu_len)),
+        0, NULL);
+}
+
+/**
+ * @brief Encode a ReadProperty request of Analog Input 1
+ * @param apdu - buffer for the APDU
+ * @param invoke_id - invoke ID of the request
+ * @return number of bytes encoded
+ */
+static int test_read_property_encode(uint8_t *apdu, uint8_t invoke_id)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+
+    rp_data.object_type = OBJECT_ANALOG_INPUT;
+    rp_data.object_instance = 1;
+    rp_data.object_property = PROP_PRESENT_VALUE;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+
+    return rp_encode_apdu(apdu, invoke_id, &rp_data);
+}
+
+/**
+ * @brief Encode a ReadProperty-ACK of Analog Input 1
+ * @param apdu - buffer for the APDU
+ * @param invoke_id - invoke ID of the request
+ * @param value - the Present_Value
+ * @return number of bytes encoded
+ */
+static int test_read_property_ack_encode(
+    uint8_t *apdu, uint8_t invoke_id, float value)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    uint8_t application_data[8] = { 0 };
+
+    rp_data.object_type = OBJECT_ANALOG_INPUT;
+    rp_data.object_instance = 1;
+    rp_data.object_property = PROP_PRESENT_VALUE;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = application_data;
+    rp_data.application_data_len =
+        encode_application_real(application_data, value);
+
+    return rp_ack_encode_apdu(apdu, invoke_id, &rp_data);
+}
+
+/**
+ * @brief Decode the Present_Value of a ReadProperty-ACK for network 1
+ * @param pdu - the NPDU of the ACK
+ * @param pdu_len - number of bytes in the NPDU
+ * @param invoke_id - [out] invoke ID of the ACK
+ * @param value - [out] the decoded Present_Value
+ * @return true if the NPDU is a ReadProperty-ACK from the device
+ */
+static bool test_read_property_ack_decode(
+    uint8_t *pdu, unsigned pdu_len, uint8_t *invoke_id, float *value)
+{
+    BACNET_ADDRESS dest = { 0 }, src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    uint8_t *apdu;
+    int offset;
+
+    offset =
+        bacnet_npdu_decode(pdu, (uint16_t)pdu_len, &dest, &src, &npdu_data);
+    if ((offset <= 0) || (src.net != 2) || (src.len != 1) ||
+        (src.adr[0] != Test_Device.adr[0])) {
+        return false;
+    }
+    apdu = &pdu[offset];
+    if ((apdu[0] != PDU_TYPE_COMPLEX_ACK) ||
+        (apdu[2] != SERVICE_CONFIRMED_READ_PROPERTY)) {
+        return false;
+    }
+    *invoke_id = apdu[1];
+    if (rp_ack_decode_service_request(
+            &apdu[3], (int)pdu_len - offset - 3, &rp_data) <= 0) {
+        return false;
+    }
+
+    return bacnet_real_application_decode(
+               rp_data.application_data,
+               (uint32_t)rp_data.application_data_len, value) > 0;
+}
+
+/**
+ * @brief Test the ReadProperty requests that are answered from the cache,
+ *  and that wait for the reply of the device
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(router_proxy_tests, testRouterProxyReadProperty)
+#else
+static void testRouterProxyReadProperty(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_ROUTER_PACKET *packet;
+    uint8_t invoke_id = 0;
+    float value = 0.0f;
+    int apdu_len;
+
+    test_setup();
+    /* nothing is cached, so the first request is forwarded */
+    apdu_len = test_read_property_encode(apdu, 1);
+    test_client_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 1, NULL);
+    /* the next request for the same property waits for the reply */
+    apdu_len = test_read_property_encode(apdu, 7);
+    test_client_send(0x02, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 0, NULL);
+    zassert_equal(Test_Sent_2.count, 1, NULL);
+    zassert_equal(bacnet_router_proxy_misses(), 2, NULL);
+    /* the reply goes to both clients, with their own invoke IDs */
+    apdu_len = test_read_property_ack_encode(apdu, 1, 42.0f);
+    test_device_send(0x01, apdu, apdu_len);
+    zassert_equal(Test_Port_1.queue_count, 2, NULL);
+    packet = &Test_Port_1.queue[Test_Port_1.queue_head];
+    zassert_equal(packet->dest.mac[0], 0x02, NULL);
+    zassert_true(
+        test_read_property_ack_decode(
+            packet->pdu, packet->pdu_len, &invoke_id, &value),
+        NULL);
+    zassert_equal(invoke_id, 7, NULL);
+    zassert_false(islessgreater(value, 42.0f), NULL);
+    zassert_equal(bacnet_router_task(), 2, NULL);
+    zassert_equal(Test_Sent_1.count, 2, NULL);
+    zassert_equal(Test_Sent_1.dest.mac[0], 0x01, NULL);
+    zassert_true(
+        test_read_property_ack_decode(
+            Test_Sent_1.pdu, Test_Sent_1.pdu_len, &invoke_id, &value),
+        NULL);
+    zassert_equal(invoke_id, 1, NULL);
+    /* the value is fresh, so the request is answered by the router */
+    apdu_len = test_read_property_encode(apdu, 9);
+    test_client_send(0x03, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 1, NULL);
+    zassert_equal(Test_Sent_1.count, 3, NULL);
+    zassert_equal(Test_Sent_1.dest.mac[0], 0x03, NULL);
+    zassert_true(
+        test_read_property_ack_decode(
+            Test_Sent_1.pdu, Test_Sent_1.pdu_len, &invoke_id, &value),
+        NULL);
+    zassert_equal(invoke_id, 9, NULL);
+    zassert_false(islessgreater(value, 42.0f), NULL);
+    zassert_equal(bacnet_router_proxy_hits(), 1, NULL);
+    /* the value gets old, and the request is forwarded again */
+    bacnet_router_proxy_timer(10);
+    apdu_len = test_read_property_encode(apdu, 10);
+    test_client_send(0x03, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 2, NULL);
+    /* the reply does not come, and the waiting stops */
+    bacnet_router_proxy_timer(BACNET_ROUTER_PROXY_WAIT_SECONDS);
+    apdu_len = test_read_property_encode(apdu, 11);
+    test_client_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 3, NULL);
+    bacnet_router_proxy_cleanup();
+}
+
+/**
+ * @brief Test the ReadPropertyMultiple requests, the writes that forget
+ *  the cached values, and the COV notifications that fill the cache
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(router_proxy_tests, testRouterProxyMultiple)
+#else
+static void testRouterProxyMultiple(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_RPM_DATA rpm_data = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_COV_DATA cov_data = { 0 };
+    BACNET_PROPERTY_VALUE cov_value = { 0 };
+    uint8_t invoke_id = 0;
+    float value = 0.0f;
+    int apdu_len;
+
+    test_setup();
+    /* a COV notification from the device fills the cache */
+    cov_data.subscriberProcessIdentifier = 1;
+    cov_data.initiatingDeviceIdentifier = 5;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    cov_data.monitoredObjectIdentifier.instance = 1;
+    cov_data.timeRemaining = 60;
+    cov_data.listOfValues = &cov_value;
+    cov_value.propertyIdentifier = PROP_PRESENT_VALUE;
+    cov_value.propertyArrayIndex = BACNET_ARRAY_ALL;
+    cov_value.value.tag = BACNET_APPLICATION_TAG_REAL;
+    cov_value.value.type.Real = 21.5f;
+    apdu_len = ucov_notify_encode_apdu(apdu, sizeof(apdu), &cov_data);
+    zassert_true(apdu_len > 0, NULL);
+    test_device_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    apdu_len = test_read_property_encode(apdu, 2);
+    test_client_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 0, NULL);
+    zassert_true(
+        test_read_property_ack_decode(
+            Test_Sent_1.pdu, Test_Sent_1.pdu_len, &invoke_id, &value),
+        NULL);
+    zassert_false(islessgreater(value, 21.5f), NULL);
+    /* a ReadPropertyMultiple of the cached property is answered */
+    rpm_data.object_type = OBJECT_ANALOG_INPUT;
+    rpm_data.object_instance = 1;
+    apdu_len = rpm_encode_apdu_init(apdu, 3);
+    apdu_len += rpm_encode_apdu_object_begin(
+        &apdu[apdu_len], OBJECT_ANALOG_INPUT, 1);
+    apdu_len += rpm_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    apdu_len += rpm_encode_apdu_object_end(&apdu[apdu_len]);
+    test_client_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 0, NULL);
+    zassert_equal(bacnet_router_proxy_hits(), 2, NULL);
+    /* a property that is not cached is read from the device */
+    apdu_len = rpm_encode_apdu_init(apdu, 4);
+    apdu_len += rpm_encode_apdu_object_begin(
+        &apdu[apdu_len], OBJECT_ANALOG_INPUT, 1);
+    apdu_len += rpm_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+    apdu_len += rpm_encode_apdu_object_property(
+        &apdu[apdu_len], PROP_STATUS_FLAGS, BACNET_ARRAY_ALL);
+    apdu_len += rpm_encode_apdu_object_end(&apdu[apdu_len]);
+    test_client_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 1, NULL);
+    /* a write of the property is forwarded, and forgets the value */
+    wp_data.object_type = OBJECT_ANALOG_INPUT;
+    wp_data.object_instance = 1;
+    wp_data.object_property = PROP_PRESENT_VALUE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    wp_data.application_data_len =
+        encode_application_real(wp_data.application_data, 30.0f);
+    apdu_len = wp_encode_apdu(apdu, 5, &wp_data);
+    test_client_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 2, NULL);
+    apdu_len = test_read_property_encode(apdu, 6);
+    test_client_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 3, NULL);
+    /* without the proxy, the requests are forwarded */
+    apdu_len = test_read_property_ack_encode(apdu, 6, 30.0f);
+    test_device_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    bacnet_router_proxy_cleanup();
+    apdu_len = test_read_property_encode(apdu, 8);
+    test_client_send(0x01, apdu, apdu_len);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.count, 4, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(router_proxy_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        router_proxy_tests, ztest_unit_test(testRouterProxyReadProperty),
+        ztest_unit_test(testRouterProxyMultiple));
+
+    ztest_run_test_suite(router_proxy_tests);
+}
+#endif
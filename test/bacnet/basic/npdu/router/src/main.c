@@ -0,0 +1,590 @@
+/**
+ * @file
+ * @brief test a basic BACnet router with a port for each datalink
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacaddr.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/npdu.h>
+#include <bacnet/basic/npdu/h_router.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* what a port sent out of its datalink */
+struct test_sent {
+    unsigned count;
+    BACNET_ADDRESS dest;
+    uint8_t pdu[BACNET_ROUTER_PDU_MAX];
+    unsigned pdu_len;
+};
+
+static BACNET_ROUTING_PORT Test_Port_1;
+static BACNET_ROUTING_PORT Test_Port_2;
+static struct test_sent Test_Sent_1;
+static struct test_sent Test_Sent_2;
+
+static void test_sent_record(
+    struct test_sent *sent, BACNET_ADDRESS *dest, uint8_t *pdu, unsigned len)
+{
+    sent->count++;
+    bacnet_address_copy(&sent->dest, dest);
+    memcpy(sent->pdu, pdu, len);
+    sent->pdu_len = len;
+}
+
+static int test_send_pdu_1(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)npdu_data;
+    test_sent_record(&Test_Sent_1, dest, pdu, pdu_len);
+    return (int)pdu_len;
+}
+
+static int test_send_pdu_2(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)npdu_data;
+    test_sent_record(&Test_Sent_2, dest, pdu, pdu_len);
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Set up a router between network 1 on port 1 and network 2
+ *  on port 2
+ */
+static void test_setup(void)
+{
+    BACNET_ADDRESS address = { 0 };
+
+    bacnet_router_cleanup();
+    memset(&Test_Sent_1, 0, sizeof(Test_Sent_1));
+    memset(&Test_Sent_2, 0, sizeof(Test_Sent_2));
+    address.mac_len = 1;
+    address.mac[0] = 0x80;
+    bacnet_router_port_add(&Test_Port_1, 1, &address, test_send_pdu_1);
+    address.mac[0] = 0x81;
+    bacnet_router_port_add(&Test_Port_2, 2, &address, test_send_pdu_2);
+}
+
+/**
+ * @brief Encode an unconfirmed request NPDU
+ * @param pdu - buffer for the NPDU
+ * @param dest - destination of the NPDU, or NULL for a local message
+ * @return number of bytes encoded
+ */
+static unsigned test_apdu_encode(uint8_t *pdu, BACNET_ADDRESS *dest)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, dest, NULL, &npdu_data);
+    /* an Unconfirmed Who-Is */
+    pdu[len++] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+    pdu[len++] = SERVICE_UNCONFIRMED_WHO_IS;
+
+    return (unsigned)len;
+}
+
+/**
+ * @brief Encode a network layer message with one network number
+ * @param pdu - buffer for the NPDU
+ * @param type - network message type
+ * @param dnet - network number, or 0 for none
+ * @return number of bytes encoded
+ */
+static unsigned test_network_message_encode(
+    uint8_t *pdu, BACNET_NETWORK_MESSAGE_TYPE type, uint16_t dnet)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    npdu_encode_npdu_network(&npdu_data, type, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, NULL, NULL, &npdu_data);
+    if (dnet) {
+        len += encode_unsigned16(&pdu[len], dnet);
+    }
+
+    return (unsigned)len;
+}
+
+/**
+ * @brief Decode the NPDU that a port sent
+ * @param sent - what the port sent
+ * @param dest - [out] the routed destination of the NPDU
+ * @param src - [out] the routed source of the NPDU
+ * @param npdu_data - [out] the network information of the NPDU
+ * @return offset of the rest of the NPDU after the NPCI
+ */
+static int test_sent_decode(
+    const struct test_sent *sent,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    BACNET_NPDU_DATA *npdu_data)
+{
+    return bacnet_npdu_decode(
+        sent->pdu, (uint16_t)sent->pdu_len, dest, src, npdu_data);
+}
+
+/**
+ * @brief Test routing to a directly connected network
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(router_tests, testRouterDirect)
+#else
+static void testRouterDirect(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS src = { 0 }, dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned pdu_len;
+    int offset;
+
+    test_setup();
+    zassert_equal(bacnet_router_port_find(1), &Test_Port_1, NULL);
+    zassert_equal(bacnet_router_port_find(2), &Test_Port_2, NULL);
+    zassert_is_null(bacnet_router_port_find(3), NULL);
+    zassert_equal(bacnet_router_dnet_find(2, NULL), &Test_Port_2, NULL);
+    /* never route a directly connected network elsewhere */
+    zassert_false(bacnet_router_dnet_add(&Test_Port_1, 2, NULL), NULL);
+    /* a local message is for the application of the router */
+    pdu_len = test_apdu_encode(pdu, NULL);
+    src.mac_len = 1;
+    src.mac[0] = 0x01;
+    offset = bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_equal(offset, 2, NULL);
+    zassert_equal(bacnet_router_task(), 0, NULL);
+    /* a message for network 2 */
+    dest.net = 2;
+    dest.len = 1;
+    dest.adr[0] = 0x05;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    offset = bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_equal(offset, 0, NULL);
+    zassert_equal(Test_Sent_2.count, 0, NULL);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_1.count, 0, NULL);
+    zassert_equal(Test_Sent_2.count, 1, NULL);
+    zassert_equal(Test_Sent_2.dest.mac_len, 1, NULL);
+    zassert_equal(Test_Sent_2.dest.mac[0], 0x05, NULL);
+    memset(&dest, 0, sizeof(dest));
+    offset = test_sent_decode(&Test_Sent_2, &dest, &src, &npdu_data);
+    zassert_true(offset > 0, NULL);
+    zassert_equal(dest.net, 0, NULL);
+    zassert_equal(src.net, 1, NULL);
+    zassert_equal(src.len, 1, NULL);
+    zassert_equal(src.adr[0], 0x01, NULL);
+    zassert_equal(
+        Test_Sent_2.pdu[offset], PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST, NULL);
+    /* a message back to the network it came from is discarded */
+    memset(&src, 0, sizeof(src));
+    dest.net = 1;
+    dest.len = 1;
+    dest.adr[0] = 0x02;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    offset = bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_equal(offset, 0, NULL);
+    zassert_equal(bacnet_router_task(), 0, NULL);
+}
+
+/**
+ * @brief Test routing to a remote network through the next router
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(router_tests, testRouterRemote)
+#else
+static void testRouterRemote(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS src = { 0 }, dest = { 0 }, router = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned pdu_len;
+
+    test_setup();
+    /* learn network 3 from an I-Am-Router-To-Network on port 2 */
+    pdu_len = test_network_message_encode(
+        pdu, NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK, 3);
+    router.mac_len = 1;
+    router.mac[0] = 0x07;
+    zassert_equal(
+        bacnet_router_npdu_handler(&Test_Port_2, &router, pdu, pdu_len), 0,
+        NULL);
+    zassert_equal(bacnet_router_dnet_find(3, &dest), &Test_Port_2, NULL);
+    zassert_equal(dest.mac_len, 1, NULL);
+    zassert_equal(dest.mac[0], 0x07, NULL);
+    zassert_false(bacnet_router_dnet_busy(3), NULL);
+    /* the route that was learned first is kept */
+    zassert_false(bacnet_router_dnet_add(&Test_Port_1, 3, &src), NULL);
+    zassert_equal(bacnet_router_dnet_find(3, NULL), &Test_Port_2, NULL);
+    /* a message for network 3 */
+    memset(&dest, 0, sizeof(dest));
+    dest.net = 3;
+    dest.len = 1;
+    dest.adr[0] = 0x09;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    src.mac_len = 1;
+    src.mac[0] = 0x01;
+    zassert_equal(
+        bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len), 0, NULL);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_2.dest.mac[0], 0x07, NULL);
+    memset(&dest, 0, sizeof(dest));
+    zassert_true(
+        test_sent_decode(&Test_Sent_2, &dest, &src, &npdu_data) > 0, NULL);
+    zassert_equal(dest.net, 3, NULL);
+    zassert_equal(dest.adr[0], 0x09, NULL);
+    zassert_equal(src.net, 1, NULL);
+    zassert_equal(npdu_data.hop_count, HOP_COUNT_DEFAULT - 1, NULL);
+    /* the next router says it is busy */
+    pdu_len = test_network_message_encode(
+        pdu, NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK, 3);
+    zassert_equal(
+        bacnet_router_npdu_handler(&Test_Port_2, &router, pdu, pdu_len), 0,
+        NULL);
+    zassert_true(bacnet_router_dnet_busy(3), NULL);
+    /* so messages for network 3 are rejected */
+    memset(&dest, 0, sizeof(dest));
+    dest.net = 3;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    memset(&src, 0, sizeof(src));
+    src.mac_len = 1;
+    src.mac[0] = 0x01;
+    zassert_equal(
+        bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len), 0, NULL);
+    zassert_equal(bacnet_router_task(), 0, NULL);
+    zassert_equal(Test_Sent_1.count, 1, NULL);
+    zassert_equal(Test_Sent_1.dest.mac[0], 0x01, NULL);
+    pdu_len = (unsigned)test_sent_decode(&Test_Sent_1, &dest, &src, &npdu_data);
+    zassert_true(npdu_data.network_layer_message, NULL);
+    zassert_equal(
+        npdu_data.network_message_type,
+        NETWORK_MESSAGE_REJECT_MESSAGE_TO_NETWORK, NULL);
+    zassert_equal(Test_Sent_1.pdu[pdu_len], NETWORK_REJECT_ROUTER_BUSY, NULL);
+    /* and the route moves to another router */
+    memset(&src, 0, sizeof(src));
+    src.mac_len = 1;
+    src.mac[0] = 0x11;
+    zassert_true(bacnet_router_dnet_add(&Test_Port_1, 3, &src), NULL);
+    zassert_equal(bacnet_router_dnet_find(3, &dest), &Test_Port_1, NULL);
+    zassert_equal(dest.mac[0], 0x11, NULL);
+    zassert_false(bacnet_router_dnet_busy(3), NULL);
+}
+
+/**
+ * @brief Test global broadcasts and unknown networks
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(router_tests, testRouterBroadcast)
+#else
+static void testRouterBroadcast(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS src = { 0 }, dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned pdu_len;
+    int offset;
+
+    test_setup();
+    /* a global broadcast is also for the application of the router */
+    dest.net = BACNET_BROADCAST_NETWORK;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    src.mac_len = 1;
+    src.mac[0] = 0x01;
+    offset = bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_true(offset > 0, NULL);
+    zassert_equal(pdu[offset], PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(bacnet_router_task(), 1, NULL);
+    zassert_equal(Test_Sent_1.count, 0, NULL);
+    zassert_equal(Test_Sent_2.count, 1, NULL);
+    zassert_true(
+        test_sent_decode(&Test_Sent_2, &dest, &src, &npdu_data) > 0, NULL);
+    zassert_equal(dest.net, BACNET_BROADCAST_NETWORK, NULL);
+    zassert_equal(src.net, 1, NULL);
+    /* a message for an unknown network waits while the next router
+       to it is sought */
+    memset(&dest, 0, sizeof(dest));
+    dest.net = 9;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    memset(&src, 0, sizeof(src));
+    src.mac_len = 1;
+    src.mac[0] = 0x01;
+    zassert_equal(
+        bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len), 0, NULL);
+    zassert_equal(Test_Sent_2.count, 2, NULL);
+    (void)test_sent_decode(&Test_Sent_2, &dest, &src, &npdu_data);
+    zassert_equal(
+        npdu_data.network_message_type,
+        NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK, NULL);
+    zassert_equal(Test_Sent_2.dest.net, BACNET_BROADCAST_NETWORK, NULL);
+    zassert_equal(bacnet_router_task(), 0, NULL);
+    /* a Who-Is-Router-To-Network is answered with our networks */
+    pdu_len = test_network_message_encode(
+        pdu, NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK, 0);
+    zassert_true(bacnet_router_dnet_add(&Test_Port_2, 3, NULL), NULL);
+    memset(&src, 0, sizeof(src));
+    zassert_equal(
+        bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len), 0, NULL);
+    zassert_equal(Test_Sent_1.count, 1, NULL);
+    offset = test_sent_decode(&Test_Sent_1, &dest, &src, &npdu_data);
+    zassert_equal(
+        npdu_data.network_message_type,
+        NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK, NULL);
+    zassert_equal(Test_Sent_1.pdu_len, offset + 4, NULL);
+    zassert_equal(Test_Sent_1.pdu[offset + 1], 2, NULL);
+    zassert_equal(Test_Sent_1.pdu[offset + 3], 3, NULL);
+}
+
+/**
+ * @brief Test the messages that wait for an unknown network, and the
+ *  networks that are not found
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(router_tests, testRouterDiscovery)
+#else
+static void testRouterDiscovery(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS src = { 0 }, dest = { 0 }, router = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned pdu_len, offset;
+    unsigned sent;
+    unsigned i;
+
+    test_setup();
+    src.mac_len = 1;
+    src.mac[0] = 0x01;
+    dest.net = 9;
+    dest.len = 1;
+    dest.adr[0] = 0x09;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_equal(Test_Sent_2.count, 1, NULL);
+    /* the network is sought once for all of the messages and requests */
+    (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    pdu_len = test_network_message_encode(
+        pdu, NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK, 9);
+    (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_equal(Test_Sent_2.count, 1, NULL);
+    zassert_equal(bacnet_router_task(), 0, NULL);
+    /* the waiting messages are sent when the next router is found */
+    pdu_len = test_network_message_encode(
+        pdu, NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK, 9);
+    router.mac_len = 1;
+    router.mac[0] = 0x07;
+    (void)bacnet_router_npdu_handler(&Test_Port_2, &router, pdu, pdu_len);
+    zassert_equal(bacnet_router_task(), 2, NULL);
+    zassert_equal(Test_Sent_2.count, 3, NULL);
+    zassert_equal(Test_Sent_2.dest.mac[0], 0x07, NULL);
+    memset(&dest, 0, sizeof(dest));
+    zassert_true(
+        test_sent_decode(&Test_Sent_2, &dest, &router, &npdu_data) > 0, NULL);
+    zassert_equal(dest.net, 9, NULL);
+    zassert_equal(dest.adr[0], 0x09, NULL);
+    zassert_false(bacnet_router_dnet_unreachable(9), NULL);
+    /* a network that is not found is unreachable */
+    memset(&dest, 0, sizeof(dest));
+    dest.net = 10;
+    dest.len = 1;
+    dest.adr[0] = 0x0A;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    sent = Test_Sent_2.count;
+    for (i = 1; i < BACNET_ROUTER_DISCOVERY_ATTEMPTS; i++) {
+        bacnet_router_maintenance_timer(BACNET_ROUTER_DISCOVERY_SECONDS);
+    }
+    zassert_equal(
+        Test_Sent_2.count, sent + BACNET_ROUTER_DISCOVERY_ATTEMPTS - 1, NULL);
+    zassert_false(bacnet_router_dnet_unreachable(10), NULL);
+    zassert_equal(Test_Sent_1.count, 0, NULL);
+    bacnet_router_maintenance_timer(BACNET_ROUTER_DISCOVERY_SECONDS);
+    zassert_true(bacnet_router_dnet_unreachable(10), NULL);
+    zassert_equal(bacnet_router_task(), 0, NULL);
+    /* and the waiting message is rejected */
+    zassert_equal(Test_Sent_1.count, 1, NULL);
+    zassert_equal(Test_Sent_1.dest.mac[0], 0x01, NULL);
+    offset =
+        (unsigned)test_sent_decode(&Test_Sent_1, &dest, &router, &npdu_data);
+    zassert_equal(
+        npdu_data.network_message_type,
+        NETWORK_MESSAGE_REJECT_MESSAGE_TO_NETWORK, NULL);
+    zassert_equal(Test_Sent_1.pdu[offset], NETWORK_REJECT_NO_ROUTE, NULL);
+    /* the messages to it are rejected without seeking it again */
+    sent = Test_Sent_2.count;
+    memset(&dest, 0, sizeof(dest));
+    dest.net = 10;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_equal(Test_Sent_1.count, 2, NULL);
+    zassert_equal(Test_Sent_2.count, sent, NULL);
+    /* until the time is over, and then it is sought again */
+    bacnet_router_maintenance_timer(BACNET_ROUTER_UNREACHABLE_SECONDS);
+    zassert_false(bacnet_router_dnet_unreachable(10), NULL);
+    (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_equal(Test_Sent_2.count, sent + 1, NULL);
+    for (i = 0; i < BACNET_ROUTER_DISCOVERY_ATTEMPTS; i++) {
+        bacnet_router_maintenance_timer(BACNET_ROUTER_DISCOVERY_SECONDS);
+    }
+    /* not found again, it is unreachable for twice as long */
+    zassert_true(bacnet_router_dnet_unreachable(10), NULL);
+    bacnet_router_maintenance_timer(BACNET_ROUTER_UNREACHABLE_SECONDS);
+    zassert_true(bacnet_router_dnet_unreachable(10), NULL);
+    bacnet_router_maintenance_timer(BACNET_ROUTER_UNREACHABLE_SECONDS);
+    zassert_false(bacnet_router_dnet_unreachable(10), NULL);
+    /* a route to it stops the backoff */
+    zassert_true(bacnet_router_dnet_add(&Test_Port_2, 10, &router), NULL);
+    zassert_equal(bacnet_router_dnet_find(10, NULL), &Test_Port_2, NULL);
+    zassert_false(bacnet_router_dnet_unreachable(10), NULL);
+}
+
+/**
+ * @brief Test the send queue of a port, and the Router-Busy-To-Network
+ *  and Router-Available-To-Network that it causes
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(router_tests, testRouterBusy)
+#else
+static void testRouterBusy(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS src = { 0 }, dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned pdu_len;
+    unsigned i;
+    int offset;
+
+    test_setup();
+    dest.net = 2;
+    dest.len = 1;
+    dest.adr[0] = 0x05;
+    pdu_len = test_apdu_encode(pdu, &dest);
+    src.mac_len = 1;
+    src.mac[0] = 0x01;
+    for (i = 0; i < BACNET_ROUTER_QUEUE_BUSY - 1; i++) {
+        (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    }
+    zassert_false(Test_Port_2.busy, NULL);
+    zassert_equal(Test_Sent_1.count, 0, NULL);
+    (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_true(Test_Port_2.busy, NULL);
+    zassert_equal(Test_Sent_1.count, 1, NULL);
+    offset = test_sent_decode(&Test_Sent_1, &dest, &src, &npdu_data);
+    zassert_equal(
+        npdu_data.network_message_type,
+        NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK, NULL);
+    zassert_equal(Test_Sent_1.pdu_len, offset + 2, NULL);
+    zassert_equal(Test_Sent_1.pdu[offset + 1], 2, NULL);
+    /* fill the queue, then the next message is rejected */
+    memset(&src, 0, sizeof(src));
+    src.mac_len = 1;
+    src.mac[0] = 0x01;
+    for (i = BACNET_ROUTER_QUEUE_BUSY; i < BACNET_ROUTER_QUEUE_SIZE; i++) {
+        (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    }
+    zassert_equal(Test_Port_2.queue_count, BACNET_ROUTER_QUEUE_SIZE, NULL);
+    zassert_equal(Test_Sent_1.count, 1, NULL);
+    (void)bacnet_router_npdu_handler(&Test_Port_1, &src, pdu, pdu_len);
+    zassert_equal(Test_Port_2.queue_discards, 1, NULL);
+    zassert_equal(Test_Sent_1.count, 2, NULL);
+    offset = test_sent_decode(&Test_Sent_1, &dest, &src, &npdu_data);
+    zassert_equal(
+        npdu_data.network_message_type,
+        NETWORK_MESSAGE_REJECT_MESSAGE_TO_NETWORK, NULL);
+    zassert_equal(Test_Sent_1.pdu[offset], NETWORK_REJECT_ROUTER_BUSY, NULL);
+    /* the busy state is renewed while the port is still busy */
+    bacnet_router_maintenance_timer(BACNET_ROUTER_BUSY_SECONDS / 2);
+    zassert_equal(Test_Sent_1.count, 3, NULL);
+    /* drain the queue in batches */
+    for (i = 0; Test_Port_2.queue_count > 0; i++) {
+        zassert_true(bacnet_router_task() <= BACNET_ROUTER_BATCH_SIZE, NULL);
+    }
+    zassert_true(i > 1, NULL);
+    zassert_equal(Test_Sent_2.count, BACNET_ROUTER_QUEUE_SIZE, NULL);
+    zassert_false(Test_Port_2.busy, NULL);
+    zassert_equal(Test_Sent_1.count, 4, NULL);
+    (void)test_sent_decode(&Test_Sent_1, &dest, &src, &npdu_data);
+    zassert_equal(
+        npdu_data.network_message_type,
+        NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK, NULL);
+}
+
+/**
+ * @brief Test the expiry of a Router-Busy-To-Network from another router
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(router_tests, testRouterBusyTimer)
+#else
+static void testRouterBusyTimer(void)
+#endif
+{
+    uint8_t pdu[MAX_PDU] = { 0 };
+    BACNET_ADDRESS router = { 0 }, other = { 0 };
+    unsigned pdu_len;
+
+    test_setup();
+    router.mac_len = 1;
+    router.mac[0] = 0x07;
+    zassert_true(bacnet_router_dnet_add(&Test_Port_2, 3, &router), NULL);
+    zassert_true(bacnet_router_dnet_add(&Test_Port_2, 4, &router), NULL);
+    /* a busy message from another router is not about our routes */
+    other.mac_len = 1;
+    other.mac[0] = 0x08;
+    pdu_len = test_network_message_encode(
+        pdu, NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK, 0);
+    (void)bacnet_router_npdu_handler(&Test_Port_2, &other, pdu, pdu_len);
+    zassert_false(bacnet_router_dnet_busy(3), NULL);
+    /* an empty list is all of the networks of the router */
+    (void)bacnet_router_npdu_handler(&Test_Port_2, &router, pdu, pdu_len);
+    zassert_true(bacnet_router_dnet_busy(3), NULL);
+    zassert_true(bacnet_router_dnet_busy(4), NULL);
+    bacnet_router_maintenance_timer(BACNET_ROUTER_BUSY_SECONDS - 1);
+    zassert_true(bacnet_router_dnet_busy(3), NULL);
+    bacnet_router_maintenance_timer(1);
+    zassert_false(bacnet_router_dnet_busy(3), NULL);
+    zassert_false(bacnet_router_dnet_busy(4), NULL);
+    /* or the router says it is available */
+    (void)bacnet_router_npdu_handler(&Test_Port_2, &router, pdu, pdu_len);
+    zassert_true(bacnet_router_dnet_busy(4), NULL);
+    pdu_len = test_network_message_encode(
+        pdu, NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK, 4);
+    (void)bacnet_router_npdu_handler(&Test_Port_2, &router, pdu, pdu_len);
+    zassert_false(bacnet_router_dnet_busy(4), NULL);
+    zassert_true(bacnet_router_dnet_busy(3), NULL);
+    bacnet_router_cleanup();
+    zassert_is_null(bacnet_router_dnet_find(3, NULL), NULL);
+    zassert_is_null(bacnet_router_port_find(1), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(router_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        router_tests, ztest_unit_test(testRouterDirect),
+        ztest_unit_test(testRouterRemote), ztest_unit_test(testRouterBroadcast),
+        ztest_unit_test(testRouterDiscovery), ztest_unit_test(testRouterBusy),
+        ztest_unit_test(testRouterBusyTimer));
+
+    ztest_run_test_suite(router_tests);
+}
+#endif
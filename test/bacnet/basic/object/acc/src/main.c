@@ -36,7 +36,7 @@ static void test_Accumulator(void)
     BACNET_UNSIGNED_INTEGER unsigned_value = 1;
     bool status = false;
     const int32_t *writable_properties;
-    const int32_t skip_fail_property_list[] = { -1 };
+    const int32_t skip_fail_property_list[] = { PROP_PRESCALE, -1 };
     char *sample_context = "context";
 
     Accumulator_Init();
@@ -98,6 +98,84 @@ static void test_Accumulator(void)
 
     return;
 }
+/**
+ * @brief Test the batched pulse ingestion
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(acc_tests, test_Accumulator_Pulses)
+#else
+static void test_Accumulator_Pulses(void)
+#endif
+{
+    const uint32_t instance = 1;
+    uint32_t multiplier = 0, modulo_divide = 0;
+    unsigned i;
+    bool status = false;
+
+    Accumulator_Init();
+    Accumulator_Create(instance);
+    status = Accumulator_Prescale(instance, &multiplier, &modulo_divide);
+    zassert_true(status, NULL);
+    zassert_equal(multiplier, 1, NULL);
+    zassert_equal(modulo_divide, 1, NULL);
+    status = Accumulator_Prescale_Set(instance, 1, 0);
+    zassert_false(status, NULL);
+    /* 3 units per 1000 pulses, with the remainder kept */
+    status = Accumulator_Prescale_Set(instance, 3, 1000);
+    zassert_true(status, NULL);
+    Accumulator_Pulses_Add(instance, 500);
+    zassert_equal(Accumulator_Present_Value(instance), 0, NULL);
+    Accumulator_Timer(instance, 100);
+    zassert_equal(Accumulator_Present_Value(instance), 1, NULL);
+    Accumulator_Pulses_Add(instance, 200);
+    Accumulator_Pulses_Add(instance, 300);
+    Accumulator_Timer(instance, 100);
+    zassert_equal(Accumulator_Present_Value(instance), 3, NULL);
+    /* the first snapshot of a free-running counter is the start */
+    Accumulator_Prescale_Set(instance, 1, 1);
+    Accumulator_Pulse_Counter_Update(instance, UINT32_MAX - 9);
+    Accumulator_Pulse_Counter_Update(instance, 10);
+    Accumulator_Timer(instance, 100);
+    zassert_equal(Accumulator_Present_Value(instance), 3 + 20, NULL);
+    /* rolls over after the Max_Pres_Value */
+    Accumulator_Max_Pres_Value_Set(instance, 99);
+    Accumulator_Present_Value_Set(instance, 95);
+    Accumulator_Pulses_Add(instance, 10);
+    Accumulator_Timer(instance, 100);
+    zassert_equal(Accumulator_Present_Value(instance), 5, NULL);
+    /* the Pulse_Rate over a sliding window of 6 seconds */
+    Accumulator_Change_Of_Value_Clear(instance);
+    status = Accumulator_Limit_Monitoring_Interval_Set(instance, 0);
+    zassert_false(status, NULL);
+    status = Accumulator_Limit_Monitoring_Interval_Set(instance, 6);
+    zassert_true(status, NULL);
+    zassert_equal(Accumulator_Limit_Monitoring_Interval(instance), 6, NULL);
+    for (i = 0; i < ACCUMULATOR_PULSE_RATE_SLOTS; i++) {
+        Accumulator_Pulses_Add(instance, 10);
+        Accumulator_Timer(instance, 500);
+        zassert_false(Accumulator_Change_Of_Value(instance), NULL);
+        Accumulator_Timer(instance, 500);
+        zassert_true(Accumulator_Change_Of_Value(instance), NULL);
+        Accumulator_Change_Of_Value_Clear(instance);
+    }
+    zassert_equal(
+        Accumulator_Pulse_Rate(instance), 10 * ACCUMULATOR_PULSE_RATE_SLOTS,
+        NULL);
+    /* the oldest slot leaves the window */
+    Accumulator_Timer(instance, 1000);
+    zassert_equal(
+        Accumulator_Pulse_Rate(instance),
+        10 * (ACCUMULATOR_PULSE_RATE_SLOTS - 1), NULL);
+    zassert_false(Accumulator_Change_Of_Value(instance), NULL);
+    /* out of service does not count the pulses */
+    Accumulator_Out_Of_Service_Set(instance, true);
+    i = Accumulator_Present_Value(instance);
+    Accumulator_Pulses_Add(instance, 10);
+    Accumulator_Timer(instance, 100);
+    zassert_equal(Accumulator_Present_Value(instance), i, NULL);
+    Accumulator_Delete(instance);
+    zassert_false(Accumulator_Pulses_Add(instance, 1), NULL);
+}
 /**
  * @}
  */
@@ -107,7 +185,9 @@ ZTEST_SUITE(acc_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(acc_tests, ztest_unit_test(test_Accumulator));
+    ztest_test_suite(
+        acc_tests, ztest_unit_test(test_Accumulator),
+        ztest_unit_test(test_Accumulator_Pulses));
 
     ztest_run_test_suite(acc_tests);
 }
@@ -7,7 +7,9 @@
  */
 #include <zephyr/ztest.h>
 #include <bacnet/bacdcode.h>
+#include <bacnet/basic/object/access_credential.h>
 #include <bacnet/basic/object/access_point.h>
+#include <bacnet/basic/object/access_rights.h>
 #include <bacnet/bactext.h>
 
 /**
@@ -15,6 +17,12 @@
  * @{
  */
 
+/* stub for the device object instance */
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
 /**
  * @brief Test
  */
@@ -68,6 +76,103 @@ static void testAccessPoint(void)
         required_property++;
     }
 }
+
+/**
+ * @brief Test the access decision for a presented authentication factor
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(access_point_tests, testAccessPointAuthenticate)
+#else
+static void testAccessPointAuthenticate(void)
+#endif
+{
+    BACNET_CREDENTIAL_AUTHENTICATION_FACTOR factor = { 0 };
+    BACNET_AUTHENTICATION_FACTOR presented = { 0 };
+    BACNET_ASSIGNED_ACCESS_RIGHTS rights = { 0 };
+    BACNET_ACCESS_RULE rule = { 0 };
+    BACNET_ACCESS_EVENT access_event;
+    uint32_t credential_instance = 0;
+    uint8_t card[4] = { 0x12, 0x34, 0x56, 0x78 };
+    bool status = false;
+
+    Access_Point_Init();
+    Access_Credential_Init();
+    Access_Rights_Init();
+    /* access rights 1 grant access at access point 1 only */
+    rule.time_range_specifier = TIME_RANGE_SPECIFIER_ALWAYS;
+    rule.location_specifier = LOCATION_SPECIFIER_SPECIFIED;
+    rule.location.deviceIdentifier.type = OBJECT_DEVICE;
+    rule.location.deviceIdentifier.instance = Device_Object_Instance_Number();
+    rule.location.objectIdentifier.type = OBJECT_ACCESS_POINT;
+    rule.location.objectIdentifier.instance = 1;
+    rule.enable = true;
+    status = Access_Rights_Positive_Access_Rule_Add(1, &rule);
+    zassert_true(status, NULL);
+    status = Access_Rights_Enable_Set(1, true);
+    zassert_true(status, NULL);
+    zassert_true(Access_Rights_Access_Point_Granted(1, 1), NULL);
+    zassert_false(Access_Rights_Access_Point_Granted(1, 2), NULL);
+    /* credential 2 holds the card and the access rights */
+    factor.disable = ACCESS_AUTHENTICATION_FACTOR_DISABLE_NONE;
+    factor.authentication_factor.format_type =
+        AUTHENTICATION_FACTOR_SIMPLE_NUMBER32;
+    factor.authentication_factor.format_class = 0;
+    octetstring_init(&factor.authentication_factor.value, card, sizeof(card));
+    status = Access_Credential_Authentication_Factor_Add(2, &factor);
+    zassert_true(status, NULL);
+    rights.assigned_access_rights.deviceIdentifier.type = BACNET_NO_DEV_TYPE;
+    rights.assigned_access_rights.deviceIdentifier.instance = BACNET_NO_DEV_ID;
+    rights.assigned_access_rights.objectIdentifier.type = OBJECT_ACCESS_RIGHTS;
+    rights.assigned_access_rights.objectIdentifier.instance = 1;
+    rights.enable = true;
+    status = Access_Credential_Assigned_Access_Rights_Add(2, &rights);
+    zassert_true(status, NULL);
+    status = Access_Credential_Status_Set(2, true);
+    zassert_true(status, NULL);
+    /* the presented card is found in the index */
+    presented = factor.authentication_factor;
+    status = Access_Credential_Authentication_Factor_Find(
+        &presented, &credential_instance, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(credential_instance, 2, NULL);
+    access_event = Access_Point_Authenticate(1, &presented);
+    zassert_equal(access_event, ACCESS_EVENT_GRANTED, NULL);
+    access_event = Access_Point_Authenticate(2, &presented);
+    zassert_equal(
+        access_event, ACCESS_EVENT_DENIED_POINT_NO_ACCESS_RIGHTS, NULL);
+    /* an unknown card */
+    card[3] = 0x79;
+    octetstring_init(&presented.value, card, sizeof(card));
+    access_event = Access_Point_Authenticate(1, &presented);
+    zassert_equal(access_event, ACCESS_EVENT_DENIED_UNKNOWN_CREDENTIAL, NULL);
+    /* the same value in another format is a different factor */
+    presented = factor.authentication_factor;
+    presented.format_type = AUTHENTICATION_FACTOR_SIMPLE_ALPHA_NUMERIC;
+    access_event = Access_Point_Authenticate(1, &presented);
+    zassert_equal(access_event, ACCESS_EVENT_DENIED_UNKNOWN_CREDENTIAL, NULL);
+    /* a disabled credential */
+    presented = factor.authentication_factor;
+    Access_Credential_Disable_Set(2, ACCESS_CREDENTIAL_DISABLE_MANUAL);
+    access_event = Access_Point_Authenticate(1, &presented);
+    zassert_equal(
+        access_event, ACCESS_EVENT_DENIED_CREDENTIAL_MANUAL_DISABLE, NULL);
+    Access_Credential_Disable_Set(2, ACCESS_CREDENTIAL_DISABLE_NONE);
+    /* a negative rule takes precedence after the index is rebuilt */
+    status = Access_Rights_Negative_Access_Rule_Add(1, &rule);
+    zassert_true(status, NULL);
+    access_event = Access_Point_Authenticate(1, &presented);
+    zassert_equal(access_event, ACCESS_EVENT_GRANTED, NULL);
+    Access_Credential_Index_Rebuild();
+    access_event = Access_Point_Authenticate(1, &presented);
+    zassert_equal(
+        access_event, ACCESS_EVENT_DENIED_POINT_NO_ACCESS_RIGHTS, NULL);
+    /* cleared factors are removed from the index */
+    Access_Credential_Authentication_Factors_Clear(2);
+    access_event = Access_Point_Authenticate(1, &presented);
+    zassert_equal(access_event, ACCESS_EVENT_DENIED_UNKNOWN_CREDENTIAL, NULL);
+    Access_Credential_Assigned_Access_Rights_Clear(2);
+    Access_Rights_Access_Rules_Clear(1);
+}
 /**
  * @}
  */
@@ -77,7 +182,9 @@ ZTEST_SUITE(access_point_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(access_point_tests, ztest_unit_test(testAccessPoint));
+    ztest_test_suite(
+        access_point_tests, ztest_unit_test(testAccessPoint),
+        ztest_unit_test(testAccessPointAuthenticate));
 
     ztest_run_test_suite(access_point_tests);
 }
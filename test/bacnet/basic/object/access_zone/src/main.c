@@ -13,6 +13,12 @@
  * @{
  */
 
+/* stub for the device object instance */
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
 /**
  * @brief Test
  */
@@ -7,6 +7,7 @@
  *
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/ai.h>
 #include <property_test.h>
@@ -29,6 +30,8 @@ static void testAnalogInput(void)
     unsigned count = 0;
     uint32_t object_instance = BACNET_MAX_INSTANCE, test_object_instance = 0;
     const int32_t skip_fail_property_list[] = { -1 };
+    BACNET_BIT_STRING status_flags = { 0 };
+    float value = 0.0f;
 
     Analog_Input_Init();
     object_instance = Analog_Input_Create(object_instance);
@@ -42,9 +45,152 @@ static void testAnalogInput(void)
         skip_fail_property_list);
     bacnet_object_name_ascii_test(
         object_instance, Analog_Input_Name_Set, Analog_Input_Name_ASCII);
+    /* typed reads without encoding */
+    Analog_Input_Present_Value_Set(object_instance, 42.0f);
+    Analog_Input_Out_Of_Service_Set(object_instance, true);
+    zassert_true(
+        Analog_Input_Present_Value_Real(object_instance, &value), NULL);
+    zassert_false(islessgreater(value, 42.0f), NULL);
+    zassert_true(
+        Analog_Input_Status_Flags(object_instance, &status_flags), NULL);
+    zassert_true(
+        bitstring_bit(&status_flags, STATUS_FLAG_OUT_OF_SERVICE), NULL);
+    zassert_false(bitstring_bit(&status_flags, STATUS_FLAG_FAULT), NULL);
+    zassert_false(
+        Analog_Input_Present_Value_Real(object_instance + 1, &value), NULL);
+    zassert_false(
+        Analog_Input_Status_Flags(object_instance + 1, &status_flags), NULL);
     status = Analog_Input_Delete(object_instance);
     zassert_true(status, NULL);
 }
+/**
+ * @brief Test creating a range of objects at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ai_tests, testAnalogInputCreateRange)
+#else
+static void testAnalogInputCreateRange(void)
+#endif
+{
+    uint32_t object_instance = 0, created = 0;
+    const int32_t skip_fail_property_list[] = { -1 };
+
+    Analog_Input_Init();
+    object_instance = Analog_Input_Create(5);
+    zassert_equal(object_instance, 5, NULL);
+    /* existing objects in the range are left alone */
+    created = Analog_Input_Create_Range(1, 10);
+    zassert_equal(created, 9, NULL);
+    zassert_equal(Analog_Input_Count(), 10, NULL);
+    for (object_instance = 1; object_instance <= 10; object_instance++) {
+        zassert_true(Analog_Input_Valid_Instance(object_instance), NULL);
+    }
+    zassert_false(Analog_Input_Valid_Instance(11), NULL);
+    bacnet_object_properties_read_write_test(
+        OBJECT_ANALOG_INPUT, 10, Analog_Input_Property_Lists,
+        Analog_Input_Read_Property, Analog_Input_Write_Property,
+        skip_fail_property_list);
+    created = Analog_Input_Create_Range(1, 10);
+    zassert_equal(created, 0, NULL);
+    created = Analog_Input_Create_Range(BACNET_MAX_INSTANCE - 1, 2);
+    zassert_equal(created, 0, NULL);
+    zassert_true(Analog_Input_Delete(3), NULL);
+    zassert_true(Analog_Input_Delete(5), NULL);
+    zassert_false(Analog_Input_Delete(5), NULL);
+    zassert_equal(Analog_Input_Count(), 8, NULL);
+    Analog_Input_Cleanup();
+    zassert_equal(Analog_Input_Count(), 0, NULL);
+}
+/**
+ * @brief Test creating and deleting objects from the reserved pool
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ai_tests, testAnalogInputPool)
+#else
+static void testAnalogInputPool(void)
+#endif
+{
+    uint32_t object_instance = 0;
+    unsigned pass = 0;
+
+    Analog_Input_Init();
+    zassert_true(Analog_Input_Pool_Reserve(4), NULL);
+    for (pass = 0; pass < 3; pass++) {
+        for (object_instance = 1; object_instance <= 4; object_instance++) {
+            zassert_equal(
+                Analog_Input_Create(object_instance), object_instance, NULL);
+            zassert_true(
+                Analog_Input_Units(object_instance) == UNITS_PERCENT, NULL);
+        }
+        zassert_equal(Analog_Input_Create_Range(1, 4), 0, NULL);
+        zassert_equal(Analog_Input_Count(), 4, NULL);
+        for (object_instance = 1; object_instance <= 4; object_instance++) {
+            zassert_true(Analog_Input_Delete(object_instance), NULL);
+        }
+        zassert_equal(Analog_Input_Count(), 0, NULL);
+    }
+    /* more than the reserved number of objects */
+    zassert_equal(Analog_Input_Create_Range(1, 8), 8, NULL);
+    Analog_Input_Cleanup();
+    zassert_equal(Analog_Input_Count(), 0, NULL);
+}
+/**
+ * @brief Test the batch update of present-value and reliability
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ai_tests, testAnalogInputPresentValueUpdate)
+#else
+static void testAnalogInputPresentValueUpdate(void)
+#endif
+{
+    ANALOG_INPUT_UPDATE updates[5] = {
+        { 1, 10.0f, RELIABILITY_NO_FAULT_DETECTED },
+        { 2, 20.0f, RELIABILITY_NO_FAULT_DETECTED },
+        { 3, 30.0f, RELIABILITY_OVER_RANGE },
+        { 9, 90.0f, RELIABILITY_NO_FAULT_DETECTED },
+        { 4, 40.0f, RELIABILITY_NO_FAULT_DETECTED },
+    };
+    uint32_t object_instance;
+    unsigned applied;
+
+    Analog_Input_Init();
+    zassert_equal(Analog_Input_Create_Range(1, 4), 4, NULL);
+    for (object_instance = 1; object_instance <= 4; object_instance++) {
+        Analog_Input_COV_Increment_Set(object_instance, 5.0f);
+        Analog_Input_Change_Of_Value_Clear(object_instance);
+    }
+    Analog_Input_Out_Of_Service_Set(2, true);
+    Analog_Input_Change_Of_Value_Clear(2);
+    applied = Analog_Input_Present_Value_Update(updates, 5);
+    /* instance 9 does not exist, and instance 2 is out-of-service */
+    zassert_equal(applied, 3, NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(1), 10.0f), NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(2), 0.0f), NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(3), 30.0f), NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(4), 40.0f), NULL);
+    zassert_equal(Analog_Input_Reliability(3), RELIABILITY_OVER_RANGE, NULL);
+    zassert_true(Analog_Input_Change_Of_Value(1), NULL);
+    zassert_false(Analog_Input_Change_Of_Value(2), NULL);
+    zassert_true(Analog_Input_Change_Of_Value(3), NULL);
+    /* changes smaller than the COV increment are not a COV */
+    Analog_Input_Change_Of_Value_Clear(1);
+    updates[0].Present_Value = 11.0f;
+    applied = Analog_Input_Present_Value_Update(updates, 1);
+    zassert_equal(applied, 1, NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(1), 11.0f), NULL);
+    zassert_false(Analog_Input_Change_Of_Value(1), NULL);
+    /* a change in fault status is a COV */
+    updates[0].Reliability = RELIABILITY_NO_SENSOR;
+    applied = Analog_Input_Present_Value_Update(updates, 1);
+    zassert_equal(applied, 1, NULL);
+    zassert_true(Analog_Input_Change_Of_Value(1), NULL);
+    /* unsorted updates are found by searching */
+    applied = Analog_Input_Present_Value_Update(&updates[2], 3);
+    zassert_equal(applied, 2, NULL);
+    applied = Analog_Input_Present_Value_Update(NULL, 5);
+    zassert_equal(applied, 0, NULL);
+    Analog_Input_Cleanup();
+}
 /**
  * @}
  */
@@ -54,7 +200,11 @@ ZTEST_SUITE(ai_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(ai_tests, ztest_unit_test(testAnalogInput));
+    ztest_test_suite(
+        ai_tests, ztest_unit_test(testAnalogInput),
+        ztest_unit_test(testAnalogInputCreateRange),
+        ztest_unit_test(testAnalogInputPool),
+        ztest_unit_test(testAnalogInputPresentValueUpdate));
 
     ztest_run_test_suite(ai_tests);
 }
@@ -7,6 +7,7 @@
  *
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/ao.h>
 #include <property_test.h>
@@ -45,6 +46,93 @@ static void testAnalogOutput(void)
     status = Analog_Output_Delete(object_instance);
     zassert_true(status, NULL);
 }
+/**
+ * @brief Test creating a range of objects at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ao_tests, testAnalogOutputCreateRange)
+#else
+static void testAnalogOutputCreateRange(void)
+#endif
+{
+    uint32_t object_instance = 0, created = 0;
+    const int32_t skip_fail_property_list[] = { -1 };
+
+    Analog_Output_Init();
+    object_instance = Analog_Output_Create(5);
+    zassert_equal(object_instance, 5, NULL);
+    /* existing objects in the range are left alone */
+    created = Analog_Output_Create_Range(1, 10);
+    zassert_equal(created, 9, NULL);
+    zassert_equal(Analog_Output_Count(), 10, NULL);
+    for (object_instance = 1; object_instance <= 10; object_instance++) {
+        zassert_true(Analog_Output_Valid_Instance(object_instance), NULL);
+    }
+    zassert_false(Analog_Output_Valid_Instance(11), NULL);
+    bacnet_object_properties_read_write_test(
+        OBJECT_ANALOG_OUTPUT, 10, Analog_Output_Property_Lists,
+        Analog_Output_Read_Property, Analog_Output_Write_Property,
+        skip_fail_property_list);
+    created = Analog_Output_Create_Range(1, 10);
+    zassert_equal(created, 0, NULL);
+    created = Analog_Output_Create_Range(BACNET_MAX_INSTANCE - 1, 2);
+    zassert_equal(created, 0, NULL);
+    zassert_true(Analog_Output_Delete(3), NULL);
+    zassert_true(Analog_Output_Delete(5), NULL);
+    zassert_false(Analog_Output_Delete(5), NULL);
+    zassert_equal(Analog_Output_Count(), 8, NULL);
+    Analog_Output_Cleanup();
+    zassert_equal(Analog_Output_Count(), 0, NULL);
+}
+
+/**
+ * @brief Test the present-value and the active priority as the
+ *  priority-array slots are commanded and relinquished
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ao_tests, testAnalogOutputPriorityArray)
+#else
+static void testAnalogOutputPriorityArray(void)
+#endif
+{
+    uint32_t object_instance = 1;
+
+    Analog_Output_Init();
+    Analog_Output_Create(object_instance);
+    zassert_true(
+        Analog_Output_Relinquish_Default_Set(object_instance, 10.0f), NULL);
+    zassert_false(
+        islessgreater(Analog_Output_Present_Value(object_instance), 10.0f),
+        NULL);
+    zassert_equal(
+        Analog_Output_Present_Value_Priority(object_instance), 0, NULL);
+    zassert_true(
+        Analog_Output_Present_Value_Set(object_instance, 50.0f, 16), NULL);
+    zassert_true(
+        Analog_Output_Present_Value_Set(object_instance, 20.0f, 8), NULL);
+    zassert_false(
+        Analog_Output_Present_Value_Set(object_instance, 30.0f, 17), NULL);
+    zassert_equal(
+        Analog_Output_Present_Value_Priority(object_instance), 8, NULL);
+    zassert_false(
+        islessgreater(Analog_Output_Present_Value(object_instance), 20.0f),
+        NULL);
+    zassert_true(
+        Analog_Output_Present_Value_Relinquish(object_instance, 8), NULL);
+    zassert_equal(
+        Analog_Output_Present_Value_Priority(object_instance), 16, NULL);
+    zassert_false(
+        islessgreater(Analog_Output_Present_Value(object_instance), 50.0f),
+        NULL);
+    zassert_true(
+        Analog_Output_Present_Value_Relinquish(object_instance, 16), NULL);
+    zassert_equal(
+        Analog_Output_Present_Value_Priority(object_instance), 0, NULL);
+    zassert_false(
+        islessgreater(Analog_Output_Present_Value(object_instance), 10.0f),
+        NULL);
+    Analog_Output_Cleanup();
+}
 /**
  * @}
  */
@@ -54,7 +142,10 @@ ZTEST_SUITE(ao_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(ao_tests, ztest_unit_test(testAnalogOutput));
+    ztest_test_suite(
+        ao_tests, ztest_unit_test(testAnalogOutput),
+        ztest_unit_test(testAnalogOutputCreateRange),
+        ztest_unit_test(testAnalogOutputPriorityArray));
 
     ztest_run_test_suite(ao_tests);
 }
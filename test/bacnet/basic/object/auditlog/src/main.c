@@ -12,6 +12,9 @@
 #include <bacnet/basic/object/device.h>
 #include <property_test.h>
 
+/* a comment that does not fit in a record slot */
+#define AUDIT_LOG_TEST_COMMENT_SIZE BACNET_AUDIT_LOG_RECORD_SIZE
+
 /**
  * @addtogroup bacnet_tests
  * @{
@@ -184,6 +187,192 @@ static void testLogs(void)
 
     Audit_Log_Cleanup();
 }
+
+/* a storage block that is kept when the logs are cleaned up */
+static uint8_t Test_Storage[BACNET_AUDIT_LOG_STORAGE_SIZE(8)];
+static unsigned Test_Storage_Open_Count;
+static bool Test_Storage_Purged;
+
+static uint8_t *
+test_storage_open(unsigned device_index, uint32_t object_instance, size_t *size)
+{
+    (void)device_index;
+    (void)object_instance;
+    Test_Storage_Open_Count++;
+    if (*size > sizeof(Test_Storage)) {
+        *size = sizeof(Test_Storage);
+    }
+
+    return Test_Storage;
+}
+
+static void test_storage_close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge)
+{
+    (void)device_index;
+    (void)object_instance;
+    zassert_equal(storage, Test_Storage, NULL);
+    zassert_true(size <= sizeof(Test_Storage), NULL);
+    if (purge) {
+        memset(Test_Storage, 0, sizeof(Test_Storage));
+    }
+    Test_Storage_Purged = purge;
+}
+
+/**
+ * @brief Add a notification record to a log
+ * @param instance - object-instance number of the log
+ * @param operation - the operation of the notification
+ */
+static void test_record_add(uint32_t instance, uint8_t operation)
+{
+    BACNET_AUDIT_LOG_RECORD record = { 0 };
+
+    record.tag = AUDIT_LOG_DATUM_TAG_NOTIFICATION;
+    record.log_datum.notification.operation = operation;
+    zassert_true(Audit_Log_Record_Entry_Add(instance, &record), NULL);
+}
+
+/**
+ * @brief Get the operation of a notification record of a log
+ * @param instance - object-instance number of the log
+ * @param index - 0 based index of the record, oldest first
+ * @return the operation of the notification
+ */
+static uint8_t test_record_operation(uint32_t instance, uint32_t index)
+{
+    BACNET_AUDIT_LOG_RECORD *record;
+
+    record = Audit_Log_Record_Entry(instance, index);
+    zassert_not_null(record, NULL);
+    zassert_equal(record->tag, AUDIT_LOG_DATUM_TAG_NOTIFICATION, NULL);
+
+    return record->log_datum.notification.operation;
+}
+
+static void testRecordStore(void)
+{
+    const uint32_t instance = 1;
+    uint8_t apdu[MAX_APDU] = { 0 };
+    char comment[AUDIT_LOG_TEST_COMMENT_SIZE + 1] = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    BACNET_AUDIT_NOTIFICATION notification = { 0 };
+    BACNET_AUDIT_LOG_RECORD *record;
+    uint8_t i;
+
+    Audit_Log_Init();
+    zassert_equal(Audit_Log_Create(instance), instance, NULL);
+    zassert_false(Audit_Log_Buffer_Size_Set(instance, 0), NULL);
+    zassert_false(
+        Audit_Log_Buffer_Size_Set(
+            instance, BACNET_AUDIT_LOG_BUFFER_SIZE_MAX + 1),
+        NULL);
+    zassert_true(Audit_Log_Buffer_Size_Set(instance, 4), NULL);
+    /* the oldest records are overwritten */
+    zassert_true(Audit_Log_Enable_Set(instance, true), NULL);
+    for (i = 0; i < 6; i++) {
+        test_record_add(instance, i);
+    }
+    zassert_equal(Audit_Log_Record_Count(instance), 4, NULL);
+    zassert_equal(Audit_Log_Total_Record_Count(instance), 7, NULL);
+    for (i = 0; i < 4; i++) {
+        zassert_equal(test_record_operation(instance, i), i + 2, NULL);
+    }
+    zassert_is_null(Audit_Log_Record_Entry(instance, 4), NULL);
+    /* a record is deleted from the middle of the wrapped buffer */
+    Audit_Log_Record_Entry_Delete(instance, 1);
+    zassert_equal(Audit_Log_Record_Count(instance), 3, NULL);
+    test_record_add(instance, 6);
+    zassert_equal(Audit_Log_Record_Count(instance), 4, NULL);
+    zassert_equal(Audit_Log_Total_Record_Count(instance), 8, NULL);
+    zassert_equal(test_record_operation(instance, 0), 2, NULL);
+    zassert_equal(test_record_operation(instance, 1), 4, NULL);
+    zassert_equal(test_record_operation(instance, 2), 5, NULL);
+    zassert_equal(test_record_operation(instance, 3), 6, NULL);
+    /* the oldest record has the sequence number 5 */
+    request.object_type = OBJECT_AUDIT_LOG;
+    request.object_instance = instance;
+    request.object_property = PROP_LOG_BUFFER;
+    request.array_index = BACNET_ARRAY_ALL;
+    request.application_data = apdu;
+    request.application_data_len = sizeof(apdu);
+    request.RequestType = RR_BY_SEQUENCE;
+    request.Range.RefSeqNum = 6;
+    request.Count = 2;
+    zassert_true(Audit_Log_Read_Range(apdu, &request) > 0, NULL);
+    zassert_equal(request.ItemCount, 2, NULL);
+    zassert_equal(request.FirstSequence, 6, NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    request.Range.RefSeqNum = 8;
+    request.Count = -10;
+    zassert_true(Audit_Log_Read_Range(apdu, &request) > 0, NULL);
+    zassert_equal(request.ItemCount, 4, NULL);
+    zassert_equal(request.FirstSequence, 5, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    request.Range.RefSeqNum = 9;
+    request.Count = 1;
+    zassert_equal(Audit_Log_Read_Range(apdu, &request), 0, NULL);
+    zassert_equal(request.ItemCount, 0, NULL);
+    /* a matching notification moves its record to the end */
+    notification.operation = 4;
+    Audit_Log_Record_Notification_Insert(instance, &notification);
+    zassert_equal(Audit_Log_Record_Count(instance), 4, NULL);
+    zassert_equal(Audit_Log_Total_Record_Count(instance), 9, NULL);
+    zassert_equal(test_record_operation(instance, 1), 5, NULL);
+    zassert_equal(test_record_operation(instance, 3), 4, NULL);
+    /* the comments of a notification that does not fit are left out,
+       so it is the same as the notification without comments */
+    memset(comment, 'A', AUDIT_LOG_TEST_COMMENT_SIZE);
+    characterstring_init_ansi(&notification.source_comment, comment);
+    Audit_Log_Record_Notification_Insert(instance, &notification);
+    zassert_equal(Audit_Log_Record_Count(instance), 4, NULL);
+    zassert_equal(Audit_Log_Total_Record_Count(instance), 10, NULL);
+    record = Audit_Log_Record_Entry(instance, 3);
+    zassert_not_null(record, NULL);
+    zassert_equal(
+        characterstring_length(
+            &record->log_datum.notification.source_comment),
+        0, NULL);
+    /* a smaller buffer keeps the newest records */
+    zassert_true(Audit_Log_Buffer_Size_Set(instance, 2), NULL);
+    zassert_equal(Audit_Log_Record_Count(instance), 2, NULL);
+    zassert_equal(Audit_Log_Total_Record_Count(instance), 10, NULL);
+    zassert_equal(test_record_operation(instance, 0), 6, NULL);
+    zassert_equal(test_record_operation(instance, 1), 4, NULL);
+    Audit_Log_Cleanup();
+    /* the records in a kept storage block are resumed */
+    Audit_Log_Storage_Callback_Set(test_storage_open, test_storage_close);
+    Audit_Log_Init();
+    zassert_equal(Audit_Log_Create(instance), instance, NULL);
+    zassert_equal(Audit_Log_Buffer_Size(instance), 8, NULL);
+    zassert_equal(Audit_Log_Record_Count(instance), 0, NULL);
+    for (i = 0; i < 10; i++) {
+        test_record_add(instance, i);
+    }
+    Audit_Log_Cleanup();
+    zassert_false(Test_Storage_Purged, NULL);
+    Audit_Log_Init();
+    zassert_equal(Audit_Log_Create(instance), instance, NULL);
+    zassert_equal(Audit_Log_Record_Count(instance), 8, NULL);
+    zassert_equal(Audit_Log_Total_Record_Count(instance), 10, NULL);
+    zassert_equal(test_record_operation(instance, 0), 2, NULL);
+    zassert_equal(test_record_operation(instance, 7), 9, NULL);
+    zassert_true(Audit_Log_Delete(instance), NULL);
+    zassert_true(Test_Storage_Purged, NULL);
+    zassert_equal(Test_Storage_Open_Count, 2, NULL);
+    Audit_Log_Cleanup();
+    Audit_Log_Storage_Callback_Set(NULL, NULL);
+}
 /**
  * @}
  */
@@ -192,7 +381,7 @@ void test_main(void)
 {
     ztest_test_suite(
         auditlog_tests, ztest_unit_test(testAuditlog),
-        ztest_unit_test(testLogs));
+        ztest_unit_test(testLogs), ztest_unit_test(testRecordStore));
 
     ztest_run_test_suite(auditlog_tests);
 }
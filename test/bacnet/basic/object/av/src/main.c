@@ -45,6 +45,44 @@ static void testAnalog_Value(void)
     status = Analog_Value_Delete(object_instance);
     zassert_true(status, NULL);
 }
+/**
+ * @brief Test creating a range of objects at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(av_tests, testAnalog_ValueCreateRange)
+#else
+static void testAnalog_ValueCreateRange(void)
+#endif
+{
+    uint32_t object_instance = 0, created = 0;
+    const int32_t skip_fail_property_list[] = { -1 };
+
+    Analog_Value_Init();
+    object_instance = Analog_Value_Create(5);
+    zassert_equal(object_instance, 5, NULL);
+    /* existing objects in the range are left alone */
+    created = Analog_Value_Create_Range(1, 10);
+    zassert_equal(created, 9, NULL);
+    zassert_equal(Analog_Value_Count(), 10, NULL);
+    for (object_instance = 1; object_instance <= 10; object_instance++) {
+        zassert_true(Analog_Value_Valid_Instance(object_instance), NULL);
+    }
+    zassert_false(Analog_Value_Valid_Instance(11), NULL);
+    bacnet_object_properties_read_write_test(
+        OBJECT_ANALOG_VALUE, 10, Analog_Value_Property_Lists,
+        Analog_Value_Read_Property, Analog_Value_Write_Property,
+        skip_fail_property_list);
+    created = Analog_Value_Create_Range(1, 10);
+    zassert_equal(created, 0, NULL);
+    created = Analog_Value_Create_Range(BACNET_MAX_INSTANCE - 1, 2);
+    zassert_equal(created, 0, NULL);
+    zassert_true(Analog_Value_Delete(3), NULL);
+    zassert_true(Analog_Value_Delete(5), NULL);
+    zassert_false(Analog_Value_Delete(5), NULL);
+    zassert_equal(Analog_Value_Count(), 8, NULL);
+    Analog_Value_Cleanup();
+    zassert_equal(Analog_Value_Count(), 0, NULL);
+}
 /**
  * @}
  */
@@ -54,7 +92,9 @@ ZTEST_SUITE(av_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(av_tests, ztest_unit_test(testAnalog_Value));
+    ztest_test_suite(
+        av_tests, ztest_unit_test(testAnalog_Value),
+        ztest_unit_test(testAnalog_ValueCreateRange));
 
     ztest_run_test_suite(av_tests);
 }
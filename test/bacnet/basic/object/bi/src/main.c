@@ -30,6 +30,8 @@ static void testBinaryInput(void)
     unsigned count = 0;
     uint32_t object_instance = BACNET_MAX_INSTANCE, test_object_instance = 0;
     const int32_t skip_fail_property_list[] = { -1 };
+    BACNET_BIT_STRING status_flags = { 0 };
+    uint32_t value = 0;
 
     Binary_Input_Init();
     object_instance = Binary_Input_Create(object_instance);
@@ -43,9 +45,112 @@ static void testBinaryInput(void)
         skip_fail_property_list);
     bacnet_object_name_ascii_test(
         object_instance, Binary_Input_Name_Set, Binary_Input_Name_ASCII);
+    /* typed reads without encoding */
+    Binary_Input_Present_Value_Set(object_instance, BINARY_ACTIVE);
+    zassert_true(
+        Binary_Input_Present_Value_Enumerated(object_instance, &value), NULL);
+    zassert_equal(value, BINARY_ACTIVE, NULL);
+    Binary_Input_Polarity_Set(object_instance, POLARITY_REVERSE);
+    zassert_true(
+        Binary_Input_Present_Value_Enumerated(object_instance, &value), NULL);
+    zassert_equal(value, BINARY_INACTIVE, NULL);
+    Binary_Input_Out_Of_Service_Set(object_instance, true);
+    zassert_true(
+        Binary_Input_Status_Flags(object_instance, &status_flags), NULL);
+    zassert_true(
+        bitstring_bit(&status_flags, STATUS_FLAG_OUT_OF_SERVICE), NULL);
+    zassert_false(
+        Binary_Input_Status_Flags(object_instance + 1, &status_flags), NULL);
     status = Binary_Input_Delete(object_instance);
     zassert_true(status, NULL);
 }
+/**
+ * @brief Test creating a range of objects at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bi_tests, testBinaryInputCreateRange)
+#else
+static void testBinaryInputCreateRange(void)
+#endif
+{
+    uint32_t object_instance = 0, created = 0;
+    const int32_t skip_fail_property_list[] = { -1 };
+
+    Binary_Input_Init();
+    object_instance = Binary_Input_Create(5);
+    zassert_equal(object_instance, 5, NULL);
+    /* existing objects in the range are left alone */
+    created = Binary_Input_Create_Range(1, 10);
+    zassert_equal(created, 9, NULL);
+    zassert_equal(Binary_Input_Count(), 10, NULL);
+    for (object_instance = 1; object_instance <= 10; object_instance++) {
+        zassert_true(Binary_Input_Valid_Instance(object_instance), NULL);
+    }
+    zassert_false(Binary_Input_Valid_Instance(11), NULL);
+    bacnet_object_properties_read_write_test(
+        OBJECT_BINARY_INPUT, 10, Binary_Input_Property_Lists,
+        Binary_Input_Read_Property, Binary_Input_Write_Property,
+        skip_fail_property_list);
+    created = Binary_Input_Create_Range(1, 10);
+    zassert_equal(created, 0, NULL);
+    created = Binary_Input_Create_Range(BACNET_MAX_INSTANCE - 1, 2);
+    zassert_equal(created, 0, NULL);
+    zassert_true(Binary_Input_Delete(3), NULL);
+    zassert_true(Binary_Input_Delete(5), NULL);
+    zassert_false(Binary_Input_Delete(5), NULL);
+    zassert_equal(Binary_Input_Count(), 8, NULL);
+    Binary_Input_Cleanup();
+    zassert_equal(Binary_Input_Count(), 0, NULL);
+}
+/**
+ * @brief Test the batch update of present-value and reliability
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bi_tests, testBinaryInputPresentValueUpdate)
+#else
+static void testBinaryInputPresentValueUpdate(void)
+#endif
+{
+    BINARY_INPUT_UPDATE updates[4] = {
+        { 1, BINARY_ACTIVE, RELIABILITY_NO_FAULT_DETECTED },
+        { 2, BINARY_ACTIVE, RELIABILITY_NO_FAULT_DETECTED },
+        { 3, BINARY_INACTIVE, RELIABILITY_NO_SENSOR },
+        { 4, BINARY_PV_MAX, RELIABILITY_NO_FAULT_DETECTED },
+    };
+    uint32_t object_instance;
+    unsigned applied;
+
+    Binary_Input_Init();
+    zassert_equal(Binary_Input_Create_Range(1, 4), 4, NULL);
+    Binary_Input_Polarity_Set(2, POLARITY_REVERSE);
+    for (object_instance = 1; object_instance <= 4; object_instance++) {
+        Binary_Input_Change_Of_Value_Clear(object_instance);
+    }
+    applied = Binary_Input_Present_Value_Update(updates, 4);
+    /* instance 4 has an invalid value */
+    zassert_equal(applied, 3, NULL);
+    zassert_equal(Binary_Input_Present_Value(1), BINARY_ACTIVE, NULL);
+    zassert_equal(Binary_Input_Present_Value(2), BINARY_ACTIVE, NULL);
+    zassert_equal(Binary_Input_Present_Value(3), BINARY_INACTIVE, NULL);
+    zassert_equal(Binary_Input_Reliability(3), RELIABILITY_NO_SENSOR, NULL);
+    zassert_true(Binary_Input_Change_Of_Value(1), NULL);
+    /* reverse polarity was already reporting active */
+    zassert_false(Binary_Input_Change_Of_Value(2), NULL);
+    zassert_true(Binary_Input_Change_Of_Value(3), NULL);
+    zassert_false(Binary_Input_Change_Of_Value(4), NULL);
+    /* the same values are not a COV */
+    Binary_Input_Change_Of_Value_Clear(1);
+    applied = Binary_Input_Present_Value_Update(updates, 1);
+    zassert_equal(applied, 1, NULL);
+    zassert_false(Binary_Input_Change_Of_Value(1), NULL);
+    /* out-of-service objects are decoupled from the input */
+    Binary_Input_Out_Of_Service_Set(1, true);
+    updates[0].Present_Value = BINARY_INACTIVE;
+    applied = Binary_Input_Present_Value_Update(updates, 1);
+    zassert_equal(applied, 0, NULL);
+    zassert_equal(Binary_Input_Present_Value(1), BINARY_ACTIVE, NULL);
+    Binary_Input_Cleanup();
+}
 /**
  * @}
  */
@@ -55,7 +160,10 @@ ZTEST_SUITE(bi_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(bi_tests, ztest_unit_test(testBinaryInput));
+    ztest_test_suite(
+        bi_tests, ztest_unit_test(testBinaryInput),
+        ztest_unit_test(testBinaryInputCreateRange),
+        ztest_unit_test(testBinaryInputPresentValueUpdate));
 
     ztest_run_test_suite(bi_tests);
 }
@@ -17,6 +17,7 @@
 #include "bacnet/getevent.h"
 #include "bacnet/get_alarm_sum.h"
 #include "bacnet/npdu.h"
+#include "bacnet/basic/service/h_getevent.h"
 
 bool datetime_local(
     BACNET_DATE *bdate,
@@ -52,6 +53,21 @@ void handler_get_event_information_set(
     (void)pFunction;
 }
 
+void handler_get_event_information_index_set(
+    BACNET_OBJECT_TYPE object_type, get_event_info_index_function pFunction)
+{
+    (void)object_type;
+    (void)pFunction;
+}
+
+void handler_get_event_information_active_set(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool active)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)active;
+}
+
 void handler_alarm_ack_set(
     BACNET_OBJECT_TYPE object_type, alarm_ack_function pFunction)
 {
@@ -45,6 +45,44 @@ static void testBinaryOutput(void)
     status = Binary_Output_Delete(object_instance);
     zassert_true(status, NULL);
 }
+/**
+ * @brief Test creating a range of objects at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bo_tests, testBinaryOutputCreateRange)
+#else
+static void testBinaryOutputCreateRange(void)
+#endif
+{
+    uint32_t object_instance = 0, created = 0;
+    const int32_t skip_fail_property_list[] = { -1 };
+
+    Binary_Output_Init();
+    object_instance = Binary_Output_Create(5);
+    zassert_equal(object_instance, 5, NULL);
+    /* existing objects in the range are left alone */
+    created = Binary_Output_Create_Range(1, 10);
+    zassert_equal(created, 9, NULL);
+    zassert_equal(Binary_Output_Count(), 10, NULL);
+    for (object_instance = 1; object_instance <= 10; object_instance++) {
+        zassert_true(Binary_Output_Valid_Instance(object_instance), NULL);
+    }
+    zassert_false(Binary_Output_Valid_Instance(11), NULL);
+    bacnet_object_properties_read_write_test(
+        OBJECT_BINARY_OUTPUT, 10, Binary_Output_Property_Lists,
+        Binary_Output_Read_Property, Binary_Output_Write_Property,
+        skip_fail_property_list);
+    created = Binary_Output_Create_Range(1, 10);
+    zassert_equal(created, 0, NULL);
+    created = Binary_Output_Create_Range(BACNET_MAX_INSTANCE - 1, 2);
+    zassert_equal(created, 0, NULL);
+    zassert_true(Binary_Output_Delete(3), NULL);
+    zassert_true(Binary_Output_Delete(5), NULL);
+    zassert_false(Binary_Output_Delete(5), NULL);
+    zassert_equal(Binary_Output_Count(), 8, NULL);
+    Binary_Output_Cleanup();
+    zassert_equal(Binary_Output_Count(), 0, NULL);
+}
 /**
  * @}
  */
@@ -54,7 +92,9 @@ ZTEST_SUITE(bo_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(bo_tests, ztest_unit_test(testBinaryOutput));
+    ztest_test_suite(
+        bo_tests, ztest_unit_test(testBinaryOutput),
+        ztest_unit_test(testBinaryOutputCreateRange));
 
     ztest_run_test_suite(bo_tests);
 }
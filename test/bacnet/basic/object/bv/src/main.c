@@ -44,6 +44,44 @@ static void testBinary_Value(void)
     status = Binary_Value_Delete(object_instance);
     zassert_true(status, NULL);
 }
+/**
+ * @brief Test creating a range of objects at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bv_tests, testBinary_ValueCreateRange)
+#else
+static void testBinary_ValueCreateRange(void)
+#endif
+{
+    uint32_t object_instance = 0, created = 0;
+    const int32_t skip_fail_property_list[] = { -1 };
+
+    Binary_Value_Init();
+    object_instance = Binary_Value_Create(5);
+    zassert_equal(object_instance, 5, NULL);
+    /* existing objects in the range are left alone */
+    created = Binary_Value_Create_Range(1, 10);
+    zassert_equal(created, 9, NULL);
+    zassert_equal(Binary_Value_Count(), 10, NULL);
+    for (object_instance = 1; object_instance <= 10; object_instance++) {
+        zassert_true(Binary_Value_Valid_Instance(object_instance), NULL);
+    }
+    zassert_false(Binary_Value_Valid_Instance(11), NULL);
+    bacnet_object_properties_read_write_test(
+        OBJECT_BINARY_VALUE, 10, Binary_Value_Property_Lists,
+        Binary_Value_Read_Property, Binary_Value_Write_Property,
+        skip_fail_property_list);
+    created = Binary_Value_Create_Range(1, 10);
+    zassert_equal(created, 0, NULL);
+    created = Binary_Value_Create_Range(BACNET_MAX_INSTANCE - 1, 2);
+    zassert_equal(created, 0, NULL);
+    zassert_true(Binary_Value_Delete(3), NULL);
+    zassert_true(Binary_Value_Delete(5), NULL);
+    zassert_false(Binary_Value_Delete(5), NULL);
+    zassert_equal(Binary_Value_Count(), 8, NULL);
+    Binary_Value_Cleanup();
+    zassert_equal(Binary_Value_Count(), 0, NULL);
+}
 /**
  * @}
  */
@@ -53,7 +91,9 @@ ZTEST_SUITE(bv_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(bv_tests, ztest_unit_test(testBinary_Value));
+    ztest_test_suite(
+        bv_tests, ztest_unit_test(testBinary_Value),
+        ztest_unit_test(testBinary_ValueCreateRange));
 
     ztest_run_test_suite(bv_tests);
 }
@@ -155,6 +155,10 @@ static void testPresentValue(void)
     BACNET_CALENDAR_ENTRY entry;
     BACNET_CALENDAR_ENTRY *value;
     uint32_t test_instance = 0;
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_APPLICATION_DATA_VALUE pv = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len = 0;
 
     Calendar_Init();
     test_instance = Calendar_Create(instance);
@@ -247,6 +251,34 @@ static void testPresentValue(void)
     Calendar_Date_List_Delete_All(instance);
     zassert_equal(0, Calendar_Date_List_Count(instance), NULL);
 
+    // ReadProperty follows changes of the Date_List
+    rpdata.application_data = apdu;
+    rpdata.application_data_len = sizeof(apdu);
+    rpdata.object_type = OBJECT_CALENDAR;
+    rpdata.object_instance = instance;
+    rpdata.object_property = PROP_PRESENT_VALUE;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    len = Calendar_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    bacapp_decode_application_data(apdu, len, &pv);
+    zassert_false(pv.type.Boolean, NULL);
+    entry.tag = BACNET_CALENDAR_DATE;
+    entry.type.Date = date;
+    Calendar_Date_List_Add(instance, &entry);
+    len = Calendar_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    bacapp_decode_application_data(apdu, len, &pv);
+    zassert_true(pv.type.Boolean, NULL);
+    len = Calendar_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    bacapp_decode_application_data(apdu, len, &pv);
+    zassert_true(pv.type.Boolean, NULL);
+    Calendar_Date_List_Delete_All(instance);
+    len = Calendar_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    bacapp_decode_application_data(apdu, len, &pv);
+    zassert_false(pv.type.Boolean, NULL);
+
     zassert_true(Calendar_Delete(instance), NULL);
 }
 
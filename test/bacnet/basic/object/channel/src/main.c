@@ -7,6 +7,7 @@
  *
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/channel.h>
 #include <bacnet/bactext.h>
@@ -40,6 +41,20 @@ static void Channel_Write_Property_Notification_Callback(
         sizeof(BACNET_WRITE_PROPERTY_DATA));
 }
 
+static BACNET_APPLICATION_DATA_VALUE Write_Member_Values[8];
+static unsigned Write_Member_Count;
+static bool Write_Member_Internal(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    if (Write_Member_Count < ARRAY_SIZE(Write_Member_Values)) {
+        bacapp_decode_application_data(
+            wp_data->application_data, wp_data->application_data_len,
+            &Write_Member_Values[Write_Member_Count]);
+        Write_Member_Count++;
+    }
+
+    return true;
+}
+
 /**
  * @brief Test
  */
@@ -352,6 +367,139 @@ static void test_Channel_Property_Read_Write(void)
     zassert_true(status, NULL);
     Channel_Cleanup();
 }
+/**
+ * @brief Test that each member is written the value in its own datatype
+ */
+static void test_Channel_Write_Members_Coerce(void)
+{
+    const uint32_t instance = 124;
+    const BACNET_OBJECT_TYPE member_type[] = {
+        OBJECT_ANALOG_OUTPUT, OBJECT_ANALOG_VALUE,       OBJECT_BINARY_OUTPUT,
+        OBJECT_BINARY_VALUE,  OBJECT_MULTI_STATE_OUTPUT, OBJECT_LIGHTING_OUTPUT
+    };
+    const BACNET_APPLICATION_TAG member_tag[] = {
+        BACNET_APPLICATION_TAG_REAL,
+        BACNET_APPLICATION_TAG_REAL,
+        BACNET_APPLICATION_TAG_ENUMERATED,
+        BACNET_APPLICATION_TAG_ENUMERATED,
+        BACNET_APPLICATION_TAG_UNSIGNED_INT,
+        BACNET_APPLICATION_TAG_REAL
+    };
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+    BACNET_CHANNEL_VALUE channel_value = { 0 };
+    unsigned m, index;
+    bool status = false;
+
+    Channel_Init();
+    Channel_Create(instance);
+    Channel_Write_Property_Internal_Callback_Set(Write_Member_Internal);
+    member.deviceIdentifier.type = OBJECT_DEVICE;
+    member.deviceIdentifier.instance = 0;
+    member.propertyIdentifier = PROP_PRESENT_VALUE;
+    member.arrayIndex = BACNET_ARRAY_ALL;
+    for (m = 0; m < ARRAY_SIZE(member_type); m++) {
+        member.objectIdentifier.type = member_type[m];
+        member.objectIdentifier.instance = m + 1;
+        index = Channel_Reference_List_Member_Element_Add(instance, &member);
+        zassert_not_equal(index, 0, NULL);
+    }
+    Write_Member_Count = 0;
+    channel_value.tag = BACNET_APPLICATION_TAG_REAL;
+    channel_value.type.Real = 1.0f;
+    status = Channel_Present_Value_Set(instance, 1, &channel_value);
+    zassert_true(status, NULL);
+    zassert_equal(Write_Member_Count, ARRAY_SIZE(member_type), NULL);
+    for (m = 0; m < ARRAY_SIZE(member_type); m++) {
+        zassert_equal(Write_Member_Values[m].tag, member_tag[m], "m=%u", m);
+    }
+    zassert_equal(Write_Member_Values[2].type.Enumerated, BINARY_ACTIVE, NULL);
+    zassert_equal(Write_Member_Values[4].type.Unsigned_Int, 1, NULL);
+    zassert_false(islessgreater(Write_Member_Values[5].type.Real, 1.0f), NULL);
+    Channel_Write_Property_Internal_Callback_Set(NULL);
+    status = Channel_Delete(instance);
+    zassert_true(status, NULL);
+    Channel_Cleanup();
+}
+
+/**
+ * @brief Test that a WriteGroup reaches the channels of its group and
+ *  channel number, as the Channel configuration changes
+ */
+static void test_Channel_Write_Group_Index(void)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+    BACNET_WRITE_GROUP_DATA wg_data = { 0 };
+    uint32_t instance;
+    unsigned index;
+    bool status = false;
+
+    Channel_Init();
+    Channel_Write_Property_Internal_Callback_Set(Write_Member_Internal);
+    member.deviceIdentifier.type = OBJECT_DEVICE;
+    member.deviceIdentifier.instance = 0;
+    member.objectIdentifier.type = OBJECT_ANALOG_VALUE;
+    member.propertyIdentifier = PROP_PRESENT_VALUE;
+    member.arrayIndex = BACNET_ARRAY_ALL;
+    /* channels 1..3 use channel-number 5, and channel 3 uses group 2 */
+    for (instance = 1; instance <= 3; instance++) {
+        zassert_equal(Channel_Create(instance), instance, NULL);
+        member.objectIdentifier.instance = instance;
+        index = Channel_Reference_List_Member_Element_Add(instance, &member);
+        zassert_not_equal(index, 0, NULL);
+        status = Channel_Number_Set(instance, 5);
+        zassert_true(status, NULL);
+        status = Channel_Control_Groups_Element_Set(
+            instance, 1, (instance == 3) ? 2 : 1);
+        zassert_true(status, NULL);
+    }
+    /* the same group in two elements is written once */
+    status = Channel_Control_Groups_Element_Set(1, 2, 1);
+    zassert_true(status, NULL);
+    wg_data.group_number = 1;
+    wg_data.write_priority = BACNET_MAX_PRIORITY;
+    wg_data.change_list.channel = 5;
+    wg_data.change_list.overriding_priority = 8;
+    wg_data.change_list.value.tag = BACNET_APPLICATION_TAG_REAL;
+    wg_data.change_list.value.type.Real = 1.0f;
+    Write_Member_Count = 0;
+    Channel_Write_Group(&wg_data, 0, &wg_data.change_list);
+    zassert_equal(Write_Member_Count, 2, NULL);
+    zassert_equal(Channel_Last_Priority(1), 8, NULL);
+    zassert_equal(Channel_Last_Priority(2), 8, NULL);
+    zassert_equal(Channel_Last_Priority(3), BACNET_NO_PRIORITY, NULL);
+    /* another channel-number */
+    wg_data.change_list.channel = 6;
+    Write_Member_Count = 0;
+    Channel_Write_Group(&wg_data, 0, &wg_data.change_list);
+    zassert_equal(Write_Member_Count, 0, NULL);
+    status = Channel_Number_Set(2, 6);
+    zassert_true(status, NULL);
+    Channel_Write_Group(&wg_data, 0, &wg_data.change_list);
+    zassert_equal(Write_Member_Count, 1, NULL);
+    /* group membership is changed */
+    wg_data.change_list.channel = 5;
+    status = Channel_Control_Groups_Element_Set(1, 1, 0);
+    zassert_true(status, NULL);
+    Write_Member_Count = 0;
+    Channel_Write_Group(&wg_data, 0, &wg_data.change_list);
+    zassert_equal(Write_Member_Count, 1, NULL);
+    status = Channel_Control_Groups_Element_Set(1, 2, 0);
+    zassert_true(status, NULL);
+    Write_Member_Count = 0;
+    Channel_Write_Group(&wg_data, 0, &wg_data.change_list);
+    zassert_equal(Write_Member_Count, 0, NULL);
+    wg_data.group_number = 2;
+    Channel_Write_Group(&wg_data, 0, &wg_data.change_list);
+    zassert_equal(Write_Member_Count, 1, NULL);
+    /* a deleted channel is not written */
+    status = Channel_Delete(3);
+    zassert_true(status, NULL);
+    Write_Member_Count = 0;
+    Channel_Write_Group(&wg_data, 0, &wg_data.change_list);
+    zassert_equal(Write_Member_Count, 0, NULL);
+    Channel_Write_Property_Internal_Callback_Set(NULL);
+    Channel_Cleanup();
+}
 /**
  * @}
  */
@@ -359,7 +507,9 @@ static void test_Channel_Property_Read_Write(void)
 void test_main(void)
 {
     ztest_test_suite(
-        channel_tests, ztest_unit_test(test_Channel_Property_Read_Write));
+        channel_tests, ztest_unit_test(test_Channel_Property_Read_Write),
+        ztest_unit_test(test_Channel_Write_Members_Coerce),
+        ztest_unit_test(test_Channel_Write_Group_Index));
 
     ztest_run_test_suite(channel_tests);
 }
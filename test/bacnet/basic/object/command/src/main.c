@@ -10,6 +10,9 @@
 #include <bacnet/basic/object/command.h>
 #include <property_test.h>
 
+static BACNET_ACTION_LIST *Test_Action_Written[8];
+static unsigned Test_Action_Written_Count;
+
 /**
  * @addtogroup bacnet_tests
  * @{
@@ -61,6 +64,146 @@ static void test_object_command(void)
         OBJECT_COMMAND, object_instance, Command_Property_Lists,
         Command_Read_Property, Command_Write_Property, skip_fail_property_list);
 }
+
+static bool test_action_write(
+    uint32_t object_instance, BACNET_ACTION_LIST *action)
+{
+    (void)object_instance;
+    if (Test_Action_Written_Count < ARRAY_SIZE(Test_Action_Written)) {
+        Test_Action_Written[Test_Action_Written_Count] = action;
+        Test_Action_Written_Count++;
+    }
+
+    return true;
+}
+
+static bool test_command_present_value_write(
+    uint32_t object_instance, uint32_t value, BACNET_ERROR_CODE *error_code)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE data_value = { 0 };
+    bool status;
+
+    wp_data.object_type = OBJECT_COMMAND;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = PROP_PRESENT_VALUE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_MAX_PRIORITY;
+    data_value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    data_value.type.Unsigned_Int = value;
+    wp_data.application_data_len =
+        bacapp_encode_application_data(wp_data.application_data, &data_value);
+    status = Command_Write_Property(&wp_data);
+    if (error_code) {
+        *error_code = wp_data.error_code;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Test the execution of the action lists
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tests_object_command, test_object_command_actions)
+#else
+static void test_object_command_actions(void)
+#endif
+{
+    BACNET_ACTION_LIST action[4] = { 0 };
+    BACNET_ACTION_LIST *pAction;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+    uint32_t object_instance;
+    unsigned i;
+    bool status;
+
+    Command_Init();
+    Command_Action_Write_Callback_Set(test_action_write);
+    object_instance = Command_Index_To_Instance(0);
+    pAction = Command_Action_List_Entry(object_instance, 0);
+    zassert_not_null(pAction, NULL);
+    /* the first action list writes 5 actions, with a delay after 3 */
+    for (i = 0; i < ARRAY_SIZE(action); i++) {
+        action[i].Post_Delay = UINT32_MAX;
+        action[i].next = (i < (ARRAY_SIZE(action) - 1)) ? &action[i + 1] : NULL;
+    }
+    action[1].Post_Delay = 1;
+    pAction->Post_Delay = UINT32_MAX;
+    pAction->Quit_On_Failure = false;
+    pAction->next = &action[0];
+    /* two writes in process at once */
+    Command_Action_Writes_Max_Set(2);
+    zassert_equal(Command_Action_Writes_Max(), 2, NULL);
+    Test_Action_Written_Count = 0;
+    status = test_command_present_value_write(object_instance, 1, NULL);
+    zassert_true(status, NULL);
+    zassert_true(Command_In_Process(object_instance), NULL);
+    zassert_equal(Test_Action_Written_Count, 2, NULL);
+    zassert_equal(Test_Action_Written[0], pAction, NULL);
+    zassert_equal(Test_Action_Written[1], &action[0], NULL);
+    /* a command in process is busy */
+    status =
+        test_command_present_value_write(object_instance, 1, &error_code);
+    zassert_false(status, NULL);
+    zassert_equal(error_code, ERROR_CODE_BUSY, NULL);
+    /* each completed write starts the next one, up to the delay */
+    status = Command_Action_Write_Result(object_instance, pAction, true);
+    zassert_true(status, NULL);
+    zassert_equal(Test_Action_Written_Count, 3, NULL);
+    zassert_equal(Test_Action_Written[2], &action[1], NULL);
+    Command_Action_Write_Result(object_instance, &action[0], false);
+    zassert_equal(Test_Action_Written_Count, 3, NULL);
+    zassert_false(action[0].Write_Successful, NULL);
+    zassert_false(Command_All_Writes_Successful(object_instance), NULL);
+    /* the delay starts once the writes are done */
+    Command_Timer(object_instance, 1000);
+    zassert_equal(Test_Action_Written_Count, 3, NULL);
+    Command_Action_Write_Result(object_instance, &action[1], true);
+    zassert_true(action[1].Write_Successful, NULL);
+    Command_Timer(object_instance, 500);
+    zassert_equal(Test_Action_Written_Count, 3, NULL);
+    Command_Timer(object_instance, 500);
+    zassert_equal(Test_Action_Written_Count, 5, NULL);
+    zassert_equal(Test_Action_Written[3], &action[2], NULL);
+    zassert_equal(Test_Action_Written[4], &action[3], NULL);
+    Command_Action_Write_Result(object_instance, &action[3], true);
+    zassert_true(Command_In_Process(object_instance), NULL);
+    Command_Action_Write_Result(object_instance, &action[2], true);
+    zassert_false(Command_In_Process(object_instance), NULL);
+    zassert_false(Command_All_Writes_Successful(object_instance), NULL);
+    /* results after the action list are ignored */
+    status = Command_Action_Write_Result(object_instance, pAction, true);
+    zassert_false(status, NULL);
+    /* a failed write that quits on failure ends the action list */
+    pAction->Quit_On_Failure = true;
+    Test_Action_Written_Count = 0;
+    status = test_command_present_value_write(object_instance, 1, NULL);
+    zassert_true(status, NULL);
+    zassert_true(Command_All_Writes_Successful(object_instance), NULL);
+    zassert_equal(Test_Action_Written_Count, 2, NULL);
+    Command_Action_Write_Result(object_instance, pAction, false);
+    zassert_equal(Test_Action_Written_Count, 2, NULL);
+    zassert_true(Command_In_Process(object_instance), NULL);
+    Command_Action_Write_Result(object_instance, &action[0], true);
+    zassert_false(Command_In_Process(object_instance), NULL);
+    zassert_false(Command_All_Writes_Successful(object_instance), NULL);
+    zassert_equal(Test_Action_Written_Count, 2, NULL);
+    /* an action list without a write callback fails */
+    Command_Action_Write_Callback_Set(NULL);
+    pAction->Quit_On_Failure = false;
+    status = test_command_present_value_write(object_instance, 1, NULL);
+    zassert_true(status, NULL);
+    zassert_true(Command_In_Process(object_instance), NULL);
+    Command_Timer(object_instance, 1000);
+    zassert_false(Command_In_Process(object_instance), NULL);
+    zassert_false(Command_All_Writes_Successful(object_instance), NULL);
+    zassert_false(action[3].Write_Successful, NULL);
+    /* action 0 does nothing */
+    status = test_command_present_value_write(object_instance, 0, NULL);
+    zassert_true(status, NULL);
+    zassert_false(Command_In_Process(object_instance), NULL);
+    Command_Action_Writes_Max_Set(COMMAND_ACTION_WRITES_MAX);
+}
 /**
  * @}
  */
@@ -71,7 +214,8 @@ ZTEST_SUITE(tests_object_command, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(
-        tests_object_command, ztest_unit_test(test_object_command));
+        tests_object_command, ztest_unit_test(test_object_command),
+        ztest_unit_test(test_object_command_actions));
 
     ztest_run_test_suite(tests_object_command);
 }
@@ -5,8 +5,15 @@
  * @date 2004
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <math.h>
+#include <string.h>
 #include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/object/av.h>
+#include <bacnet/basic/object/color_temperature.h>
 #include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/lo.h>
+#include <bacnet/basic/object/timer.h>
 #include <bacnet/bactext.h>
 #include <bacnet/proplist.h>
 
@@ -306,6 +313,7 @@ static void testDevice(void)
     uint32_t object_instance;
     const int32_t *properties;
     struct special_property_list_t property_list;
+    BACNET_PROPERTY_ID property;
 
     Device_Init(NULL);
     count = Device_Count();
@@ -417,10 +425,757 @@ static void testDevice(void)
         Device_Objects_Property_List(
             object_type, object_instance, &property_list);
         zassert_true(property_list.Required.count > 0, NULL);
+        zassert_equal(
+            property_list.Required.count,
+            property_list_count(property_list.Required.pList), NULL);
+        for (property = 0; property < 1024; property++) {
+            zassert_equal(
+                Device_Objects_Property_List_Member(
+                    object_type, object_instance, property),
+                property_lists_member(
+                    property_list.Required.pList, property_list.Optional.pList,
+                    property_list.Proprietary.pList, property),
+                "%s-%u property %u", bactext_object_type_name(object_type),
+                object_instance, (unsigned)property);
+        }
     }
 
     return;
 }
+
+/**
+ * @brief Test the optional object name index
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Object_Name_Index)
+#else
+static void test_Device_Object_Name_Index(void)
+#endif
+{
+    bool status = false;
+    unsigned i, count;
+    BACNET_OBJECT_TYPE object_type, found_type;
+    uint32_t object_instance, found_instance;
+    BACNET_CHARACTER_STRING object_name, test_name;
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+
+    Device_Init(NULL);
+    zassert_false(Device_Object_Name_Index_Enabled(), NULL);
+    status = Device_Object_Name_Index_Enable(true);
+    zassert_true(status, NULL);
+    zassert_true(Device_Object_Name_Index_Enabled(), NULL);
+    /* every object is found by its name */
+    count = Device_Object_List_Count();
+    for (i = 1; i <= count; i++) {
+        status =
+            Device_Object_List_Identifier(i, &object_type, &object_instance);
+        zassert_true(status, NULL);
+        status =
+            Device_Object_Name_Copy(object_type, object_instance, &object_name);
+        zassert_true(status, NULL);
+        status = Device_Valid_Object_Name(
+            &object_name, &found_type, &found_instance);
+        zassert_true(status, NULL);
+        zassert_equal(found_type, object_type, NULL);
+        zassert_equal(found_instance, object_instance, NULL);
+    }
+    characterstring_init_ansi(&test_name, "Object-Name-Index-Test");
+    status = Device_Valid_Object_Name(&test_name, NULL, NULL);
+    zassert_false(status, NULL);
+    /* device object renamed */
+    status = Device_Set_Object_Name(&test_name);
+    zassert_true(status, NULL);
+    status = Device_Valid_Object_Name(&test_name, &found_type, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(found_type, OBJECT_DEVICE, NULL);
+    characterstring_init_ansi(&test_name, "Object-Name-Index-Device");
+    status = Device_Set_Object_Name(&test_name);
+    zassert_true(status, NULL);
+    /* created object */
+    create_data.object_type = OBJECT_ANALOG_VALUE;
+    create_data.object_instance = BACNET_MAX_INSTANCE;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    object_instance = create_data.object_instance;
+    status = Device_Object_Name_Copy(
+        OBJECT_ANALOG_VALUE, object_instance, &object_name);
+    zassert_true(status, NULL);
+    status =
+        Device_Valid_Object_Name(&object_name, &found_type, &found_instance);
+    zassert_true(status, NULL);
+    zassert_equal(found_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(found_instance, object_instance, NULL);
+    /* renamed directly, then refreshed */
+    status = Analog_Value_Name_Set(object_instance, "Object-Name-Index-AV");
+    zassert_true(status, NULL);
+    Device_Object_Name_Index_Update(OBJECT_ANALOG_VALUE, object_instance);
+    status = Device_Valid_Object_Name(&object_name, NULL, NULL);
+    zassert_false(status, NULL);
+    characterstring_init_ansi(&test_name, "Object-Name-Index-AV");
+    status =
+        Device_Valid_Object_Name(&test_name, &found_type, &found_instance);
+    zassert_true(status, NULL);
+    zassert_equal(found_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(found_instance, object_instance, NULL);
+    /* duplicate name is refused using the index */
+    wp_data.object_type = OBJECT_DEVICE;
+    wp_data.object_instance = Device_Object_Instance_Number();
+    wp_data.object_property = PROP_OBJECT_NAME;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    wp_data.application_data_len = encode_application_character_string(
+        wp_data.application_data, &test_name);
+    status = Device_Write_Property(&wp_data);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_DUPLICATE_NAME, NULL);
+    /* renamed with WriteProperty */
+    characterstring_init_ansi(&test_name, "Object-Name-Index-WP");
+    wp_data.application_data_len = encode_application_character_string(
+        wp_data.application_data, &test_name);
+    status = Device_Write_Property(&wp_data);
+    zassert_true(status, NULL);
+    status = Device_Valid_Object_Name(&test_name, &found_type, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(found_type, OBJECT_DEVICE, NULL);
+    characterstring_init_ansi(&test_name, "Object-Name-Index-Device");
+    status = Device_Valid_Object_Name(&test_name, NULL, NULL);
+    zassert_false(status, NULL);
+    characterstring_init_ansi(&test_name, "Object-Name-Index-AV");
+    /* deleted object */
+    delete_data.object_type = OBJECT_ANALOG_VALUE;
+    delete_data.object_instance = object_instance;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    status = Device_Valid_Object_Name(&test_name, NULL, NULL);
+    zassert_false(status, NULL);
+    /* without the index */
+    status = Device_Object_Name_Index_Enable(false);
+    zassert_false(status, NULL);
+    characterstring_init_ansi(&test_name, "Object-Name-Index-WP");
+    status = Device_Valid_Object_Name(&test_name, &found_type, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(found_type, OBJECT_DEVICE, NULL);
+}
+
+/**
+ * @brief Test the optional Object_List snapshot
+ */
+static uint8_t Snapshot[32 * 1024];
+static size_t Snapshot_Len;
+
+static bool snapshot_write(void *context, const uint8_t *data, size_t length)
+{
+    (void)context;
+    if ((Snapshot_Len + length) > sizeof(Snapshot)) {
+        return false;
+    }
+    memcpy(&Snapshot[Snapshot_Len], data, length);
+    Snapshot_Len += length;
+
+    return true;
+}
+
+/**
+ * @brief Test the snapshot of the object database
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Snapshot)
+#else
+static void test_Device_Snapshot(void)
+#endif
+{
+    const uint32_t instance = 1234;
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    uint32_t object_count = 0;
+    unsigned count = 0;
+    int saved = 0, loaded = 0;
+    bool status = false;
+
+    Device_Init(NULL);
+    create_data.object_type = OBJECT_ANALOG_VALUE;
+    create_data.object_instance = instance;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    status = Analog_Value_Units_Set(instance, UNITS_DEGREES_CELSIUS);
+    zassert_true(status, NULL);
+    status = Analog_Value_Present_Value_Set(instance, 42.0f, 16);
+    zassert_true(status, NULL);
+    count = Analog_Value_Count();
+    Snapshot_Len = 0;
+    saved = Device_Snapshot_Save(snapshot_write, NULL);
+    zassert_true(saved >= (int)count, NULL);
+    status = Device_Snapshot_Valid(Snapshot, Snapshot_Len, &object_count);
+    zassert_true(status, NULL);
+    zassert_equal(object_count, (uint32_t)saved, NULL);
+    /* the objects are created again from the snapshot */
+    Device_Delete_Objects();
+    zassert_false(Analog_Value_Valid_Instance(instance), NULL);
+    loaded = Device_Snapshot_Load(Snapshot, Snapshot_Len);
+    zassert_equal(loaded, saved, NULL);
+    zassert_equal(Analog_Value_Count(), count, NULL);
+    zassert_true(Analog_Value_Valid_Instance(instance), NULL);
+    zassert_equal(Analog_Value_Units(instance), UNITS_DEGREES_CELSIUS, NULL);
+    zassert_false(
+        islessgreater(Analog_Value_Present_Value(instance), 42.0f), NULL);
+    /* a damaged or truncated snapshot is not loaded */
+    Snapshot[DEVICE_SNAPSHOT_HEADER_SIZE + 4] ^= 0x01;
+    zassert_false(Device_Snapshot_Valid(Snapshot, Snapshot_Len, NULL), NULL);
+    zassert_equal(Device_Snapshot_Load(Snapshot, Snapshot_Len), -1, NULL);
+    Snapshot[DEVICE_SNAPSHOT_HEADER_SIZE + 4] ^= 0x01;
+    zassert_equal(Device_Snapshot_Load(Snapshot, Snapshot_Len - 1), -1, NULL);
+    zassert_equal(Device_Snapshot_Load(Snapshot, 4), -1, NULL);
+    zassert_equal(Device_Snapshot_Save(NULL, NULL), -1, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Object_List_Cache)
+#else
+static void test_Device_Object_List_Cache(void)
+#endif
+{
+    bool status = false;
+    unsigned i, count;
+    BACNET_OBJECT_TYPE object_type, test_type;
+    uint32_t object_instance, test_instance, items = 0;
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+    BACNET_READ_RANGE_DATA rr_data = { 0 };
+    RR_PROP_INFO rr_info = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    int len = 0, test_len = 0;
+
+    Device_Init(NULL);
+    zassert_false(Device_Object_List_Cache_Enabled(), NULL);
+    zassert_false(Device_Object_List_Cache_Rebuild(), NULL);
+    count = Device_Object_List_Count();
+    len = Device_Object_List_Range_Encode(1, count, apdu, sizeof(apdu), &items);
+    zassert_equal(items, count, NULL);
+    status = Device_Object_List_Cache_Enable(true);
+    zassert_true(status, NULL);
+    zassert_true(Device_Object_List_Cache_Enabled(), NULL);
+    /* the snapshot has the same elements */
+    zassert_equal(Device_Object_List_Count(), count, NULL);
+    test_len = Device_Object_List_Range_Encode(
+        1, count, test_apdu, sizeof(test_apdu), &items);
+    zassert_equal(items, count, NULL);
+    zassert_equal(test_len, len, NULL);
+    zassert_mem_equal(test_apdu, apdu, len, NULL);
+    status = Device_Object_List_Identifier(0, &test_type, &test_instance);
+    zassert_false(status, NULL);
+    status =
+        Device_Object_List_Identifier(count + 1, &test_type, &test_instance);
+    zassert_false(status, NULL);
+    /* range limited by the buffer */
+    test_len = Device_Object_List_Range_Encode(2, count, NULL, 10, &items);
+    zassert_true(test_len <= 10, NULL);
+    zassert_true(items > 0, NULL);
+    zassert_true(items < count, NULL);
+    /* created object is in the list, before and after the new snapshot */
+    create_data.object_type = OBJECT_ANALOG_VALUE;
+    create_data.object_instance = BACNET_MAX_INSTANCE;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    object_instance = create_data.object_instance;
+    zassert_equal(Device_Object_List_Count(), count + 1, NULL);
+    for (i = 0; i < 2; i++) {
+        status = false;
+        for (items = 1; items <= count + 1; items++) {
+            zassert_true(
+                Device_Object_List_Identifier(
+                    items, &object_type, &test_instance),
+                NULL);
+            if ((object_type == OBJECT_ANALOG_VALUE) &&
+                (test_instance == object_instance)) {
+                status = true;
+            }
+        }
+        zassert_true(status, NULL);
+        Device_Timer(0);
+        zassert_equal(Device_Object_List_Count(), count + 1, NULL);
+    }
+    /* ReadRange by position of the Object_List */
+    rr_data.object_type = OBJECT_DEVICE;
+    rr_data.object_instance = Device_Object_Instance_Number();
+    rr_data.object_property = PROP_OBJECT_LIST;
+    rr_data.array_index = BACNET_ARRAY_ALL;
+    status = DeviceGetRRInfo(&rr_data, &rr_info);
+    zassert_true(status, NULL);
+    zassert_equal(rr_info.RequestTypes, RR_BY_POSITION, NULL);
+    rr_data.RequestType = RR_BY_POSITION;
+    rr_data.Overhead = RR_OVERHEAD;
+    rr_data.Range.RefIndex = 2;
+    rr_data.Count = 2;
+    len = rr_info.Handler(apdu, &rr_data);
+    zassert_equal(rr_data.ItemCount, 2, NULL);
+    zassert_false(
+        bitstring_bit(&rr_data.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&rr_data.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&rr_data.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    test_len = Device_Object_List_Range_Encode(
+        2, 2, test_apdu, sizeof(test_apdu), NULL);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    /* negative count ends at the reference index */
+    rr_data.Range.RefIndex = count + 1;
+    rr_data.Count = -1;
+    len = rr_info.Handler(apdu, &rr_data);
+    zassert_equal(rr_data.ItemCount, 1, NULL);
+    zassert_true(
+        bitstring_bit(&rr_data.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    rr_data.Range.RefIndex = count + 2;
+    rr_data.Count = 1;
+    len = rr_info.Handler(apdu, &rr_data);
+    zassert_equal(len, 0, NULL);
+    zassert_equal(rr_data.ItemCount, 0, NULL);
+    rr_data.RequestType = RR_READ_ALL;
+    len = rr_info.Handler(apdu, &rr_data);
+    zassert_true(rr_data.ItemCount > 0, NULL);
+    zassert_true(
+        bitstring_bit(&rr_data.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    /* deleted object is gone from the list */
+    delete_data.object_type = OBJECT_ANALOG_VALUE;
+    delete_data.object_instance = object_instance;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    zassert_equal(Device_Object_List_Count(), count, NULL);
+    Device_Timer(0);
+    zassert_equal(Device_Object_List_Count(), count, NULL);
+    /* without the snapshot */
+    status = Device_Object_List_Cache_Enable(false);
+    zassert_false(status, NULL);
+    zassert_equal(Device_Object_List_Count(), count, NULL);
+}
+
+/**
+ * @brief Read a property of an object with Device_Read_Property()
+ * @param object_type [in] the object type
+ * @param object_instance [in] the object instance
+ * @param object_property [in] the property
+ * @param value [out] the decoded value
+ * @return number of APDU bytes of the value, or BACNET_STATUS_ERROR
+ */
+static int device_read_property(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    int len;
+
+    rpdata.object_type = object_type;
+    rpdata.object_instance = object_instance;
+    rpdata.object_property = object_property;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    rpdata.application_data = apdu;
+    rpdata.application_data_len = sizeof(apdu);
+    len = Device_Read_Property(&rpdata);
+    if (len > 0) {
+        zassert_equal(
+            bacapp_decode_application_data(apdu, len, value), len, NULL);
+    }
+
+    return len;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Property_Cache)
+#else
+static void test_Device_Property_Cache(void)
+#endif
+{
+    const uint32_t instance = 77;
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len = 0;
+    bool status = false;
+
+    Device_Init(NULL);
+    zassert_false(Device_Property_Cache_Enabled(), NULL);
+    create_data.object_type = OBJECT_ANALOG_VALUE;
+    create_data.object_instance = instance;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    status = Analog_Value_Name_Set(instance, "Zone Temperature");
+    zassert_true(status, NULL);
+    status = Device_Property_Cache_Enable(true);
+    zassert_true(status, NULL);
+    zassert_true(Device_Property_Cache_Enabled(), NULL);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_OBJECT_NAME, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(
+        strcmp(
+            characterstring_value(&value.type.Character_String),
+            "Zone Temperature"),
+        0, NULL);
+    /* a direct change is read from the cache until it is invalidated */
+    status = Analog_Value_Name_Set(instance, "Zone Setpoint");
+    zassert_true(status, NULL);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_OBJECT_NAME, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(
+        strcmp(
+            characterstring_value(&value.type.Character_String),
+            "Zone Temperature"),
+        0, NULL);
+    Device_Property_Cache_Invalidate(OBJECT_ANALOG_VALUE, instance);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_OBJECT_NAME, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(
+        strcmp(
+            characterstring_value(&value.type.Character_String),
+            "Zone Setpoint"),
+        0, NULL);
+    /* while readers share the cache, values are copied but not kept */
+    Device_Property_Cache_Store_Enable(false);
+    status = Analog_Value_Name_Set(instance, "Zone Humidity");
+    zassert_true(status, NULL);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_OBJECT_NAME, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(
+        strcmp(
+            characterstring_value(&value.type.Character_String),
+            "Zone Setpoint"),
+        0, NULL);
+    Device_Property_Cache_Invalidate(OBJECT_ANALOG_VALUE, instance);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_OBJECT_NAME, &value);
+    zassert_true(len > 0, NULL);
+    status = Analog_Value_Name_Set(instance, "Zone Setpoint");
+    zassert_true(status, NULL);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_OBJECT_NAME, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(
+        strcmp(
+            characterstring_value(&value.type.Character_String),
+            "Zone Setpoint"),
+        0, NULL);
+    Device_Property_Cache_Store_Enable(true);
+    /* WriteProperty invalidates the object properties */
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_UNITS, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(value.type.Enumerated, Analog_Value_Units(instance), NULL);
+    wp_data.object_type = OBJECT_ANALOG_VALUE;
+    wp_data.object_instance = instance;
+    wp_data.object_property = PROP_UNITS;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    wp_data.application_data_len =
+        encode_application_enumerated(wp_data.application_data, UNITS_PERCENT);
+    status = Device_Write_Property(&wp_data);
+    zassert_true(status, NULL);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_UNITS, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(value.type.Enumerated, UNITS_PERCENT, NULL);
+    /* values that change are not kept */
+    status = Analog_Value_Present_Value_Set(instance, 1.0f, 16);
+    zassert_true(status, NULL);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_PRESENT_VALUE, &value);
+    zassert_true(len > 0, NULL);
+    status = Analog_Value_Present_Value_Set(instance, 2.0f, 16);
+    zassert_true(status, NULL);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_PRESENT_VALUE, &value);
+    zassert_true(len > 0, NULL);
+    zassert_false(islessgreater(value.type.Real, 2.0f), NULL);
+    /* the Device object setters invalidate the Device properties */
+    len = device_read_property(
+        OBJECT_DEVICE, Device_Object_Instance_Number(), PROP_MODEL_NAME,
+        &value);
+    zassert_true(len > 0, NULL);
+    status = Device_Set_Model_Name("Cached", 6);
+    zassert_true(status, NULL);
+    len = device_read_property(
+        OBJECT_DEVICE, Device_Object_Instance_Number(), PROP_MODEL_NAME,
+        &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(
+        strcmp(characterstring_value(&value.type.Character_String), "Cached"),
+        0, NULL);
+    /* a deleted object is not read from the cache */
+    delete_data.object_type = OBJECT_ANALOG_VALUE;
+    delete_data.object_instance = instance;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    len = device_read_property(
+        OBJECT_ANALOG_VALUE, instance, PROP_OBJECT_NAME, &value);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    status = Device_Property_Cache_Enable(false);
+    zassert_false(status, NULL);
+    zassert_false(Device_Property_Cache_Enabled(), NULL);
+    Device_Property_Cache_Invalidate(OBJECT_ANALOG_VALUE, instance);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Timer_Active)
+#else
+static void test_Device_Timer_Active(void)
+#endif
+{
+    bool status = false;
+    uint32_t timer_instance, lo_instance, cct_instance;
+    unsigned count;
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+    BACNET_LIGHTING_COMMAND command = { 0 };
+    BACNET_COLOR_COMMAND color_command = { 0 };
+
+    Device_Init(NULL);
+    count = Device_Timer_Object_Active_Count();
+    create_data.object_type = OBJECT_TIMER;
+    create_data.object_instance = BACNET_MAX_INSTANCE;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    timer_instance = create_data.object_instance;
+    create_data.object_type = OBJECT_LIGHTING_OUTPUT;
+    create_data.object_instance = BACNET_MAX_INSTANCE;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    lo_instance = create_data.object_instance;
+    /* idle objects are not given the time */
+    zassert_false(
+        Device_Timer_Object_Active(OBJECT_TIMER, timer_instance), NULL);
+    zassert_false(
+        Device_Timer_Object_Active(OBJECT_LIGHTING_OUTPUT, lo_instance), NULL);
+    zassert_equal(Device_Timer_Object_Active_Count(), count, NULL);
+    /* a running timer counts down until it expires */
+    status = Timer_Default_Timeout_Set(timer_instance, 1000);
+    zassert_true(status, NULL);
+    status = Timer_Running_Set(timer_instance, true);
+    zassert_true(status, NULL);
+    zassert_true(
+        Device_Timer_Object_Active(OBJECT_TIMER, timer_instance), NULL);
+    Device_Timer(600);
+    zassert_equal(Timer_Present_Value(timer_instance), 400, NULL);
+    Device_Timer(600);
+    zassert_equal(Timer_State(timer_instance), TIMER_STATE_EXPIRED, NULL);
+    zassert_false(
+        Device_Timer_Object_Active(OBJECT_TIMER, timer_instance), NULL);
+    /* a fade is given the time until it ends */
+    command.operation = BACNET_LIGHTS_FADE_TO;
+    command.use_target_level = true;
+    command.target_level = 100.0f;
+    command.use_fade_time = true;
+    command.fade_time = 1000;
+    status = Lighting_Output_Lighting_Command_Set(lo_instance, &command);
+    zassert_true(status, NULL);
+    zassert_true(
+        Device_Timer_Object_Active(OBJECT_LIGHTING_OUTPUT, lo_instance), NULL);
+    Device_Timer(500);
+    zassert_true(
+        Device_Timer_Object_Active(OBJECT_LIGHTING_OUTPUT, lo_instance), NULL);
+    Device_Timer(1000);
+    zassert_false(
+        Device_Timer_Object_Active(OBJECT_LIGHTING_OUTPUT, lo_instance), NULL);
+    zassert_false(
+        islessgreater(Lighting_Output_Tracking_Value(lo_instance), 100.0f),
+        NULL);
+    /* deleted objects leave the list */
+    status = Timer_Running_Set(timer_instance, true);
+    zassert_true(status, NULL);
+    zassert_equal(Device_Timer_Object_Active_Count(), count + 1, NULL);
+    delete_data.object_type = OBJECT_TIMER;
+    delete_data.object_instance = timer_instance;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    zassert_equal(Device_Timer_Object_Active_Count(), count, NULL);
+    delete_data.object_type = OBJECT_LIGHTING_OUTPUT;
+    delete_data.object_instance = lo_instance;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    /* a color temperature fades to its default at powerup */
+    create_data.object_type = OBJECT_COLOR_TEMPERATURE;
+    create_data.object_instance = BACNET_MAX_INSTANCE;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    cct_instance = create_data.object_instance;
+    zassert_true(
+        Device_Timer_Object_Active(OBJECT_COLOR_TEMPERATURE, cct_instance),
+        NULL);
+    Device_Timer(BACNET_COLOR_FADE_TIME_MIN);
+    zassert_false(
+        Device_Timer_Object_Active(OBJECT_COLOR_TEMPERATURE, cct_instance),
+        NULL);
+    zassert_equal(Device_Timer_Object_Active_Count(), count, NULL);
+    /* and is given the time again for the next color command */
+    color_command.operation = BACNET_COLOR_OPERATION_RAMP_TO_CCT;
+    color_command.target.color_temperature =
+        Color_Temperature_Tracking_Value(cct_instance) + 1000;
+    color_command.transit.ramp_rate = 1000;
+    status = Color_Temperature_Command_Set(cct_instance, &color_command);
+    zassert_true(status, NULL);
+    zassert_true(
+        Device_Timer_Object_Active(OBJECT_COLOR_TEMPERATURE, cct_instance),
+        NULL);
+    Device_Timer(1000);
+    zassert_equal(
+        Color_Temperature_Tracking_Value(cct_instance),
+        color_command.target.color_temperature, NULL);
+    Device_Timer(1000);
+    zassert_false(
+        Device_Timer_Object_Active(OBJECT_COLOR_TEMPERATURE, cct_instance),
+        NULL);
+    delete_data.object_type = OBJECT_COLOR_TEMPERATURE;
+    delete_data.object_instance = cct_instance;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Object_Functions_Find)
+#else
+static void test_Device_Object_Functions_Find(void)
+#endif
+{
+    static object_functions_t object_table[] = {
+        { .Object_Type = OBJECT_DEVICE },
+        { .Object_Type = OBJECT_PROPRIETARY_MIN + 5 },
+        { .Object_Type = OBJECT_ANALOG_INPUT },
+        { .Object_Type = OBJECT_PROPRIETARY_MIN + 1 },
+        { .Object_Type = OBJECT_ANALOG_INPUT },
+        { .Object_Type = OBJECT_PROPRIETARY_MIN + 5 },
+        { .Object_Type = OBJECT_PROPRIETARY_MAX },
+        { .Object_Type = MAX_BACNET_OBJECT_TYPE },
+    };
+    const struct object_functions *pObject;
+    BACNET_OBJECT_TYPE object_type;
+
+    /* every type of the default table finds its first entry */
+    Device_Init(NULL);
+    for (pObject = Device_Object_Functions();
+         pObject->Object_Type < MAX_BACNET_OBJECT_TYPE; pObject++) {
+        object_type = pObject->Object_Type;
+        zassert_not_null(Device_Object_Functions_Find(object_type), NULL);
+        zassert_equal(
+            Device_Object_Functions_Find(object_type)->Object_Type,
+            object_type, NULL);
+    }
+    zassert_is_null(
+        Device_Object_Functions_Find(BACNET_OBJECT_TYPE_RESERVED_MIN), NULL);
+    zassert_is_null(
+        Device_Object_Functions_Find(OBJECT_PROPRIETARY_MIN), NULL);
+    /* an outside table with proprietary and duplicate types */
+    Device_Init(object_table);
+    zassert_equal(
+        Device_Object_Functions_Find(OBJECT_DEVICE), &object_table[0], NULL);
+    zassert_equal(
+        Device_Object_Functions_Find(OBJECT_ANALOG_INPUT), &object_table[2],
+        NULL);
+    zassert_equal(
+        Device_Object_Functions_Find(OBJECT_PROPRIETARY_MIN + 1),
+        &object_table[3], NULL);
+    zassert_equal(
+        Device_Object_Functions_Find(OBJECT_PROPRIETARY_MIN + 5),
+        &object_table[1], NULL);
+    zassert_equal(
+        Device_Object_Functions_Find(OBJECT_PROPRIETARY_MAX), &object_table[6],
+        NULL);
+    zassert_is_null(
+        Device_Object_Functions_Find(OBJECT_PROPRIETARY_MIN + 2), NULL);
+    zassert_is_null(Device_Object_Functions_Find(OBJECT_BINARY_INPUT), NULL);
+    Device_Init(NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Present_Value)
+#else
+static void test_Device_Present_Value(void)
+#endif
+{
+    BACNET_BIT_STRING status_flags = { 0 };
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    uint32_t instance = 0;
+    float value = 0.0f;
+
+    Device_Init(NULL);
+    instance = Analog_Value_Create(BACNET_MAX_INSTANCE);
+    zassert_not_equal(instance, BACNET_MAX_INSTANCE, NULL);
+    zassert_true(Analog_Value_Present_Value_Set(instance, 12.5f, 16), NULL);
+    Analog_Value_Out_Of_Service_Set(instance, true);
+    zassert_not_null(
+        Device_Present_Value_Real_Function(OBJECT_ANALOG_VALUE), NULL);
+    zassert_true(
+        Device_Present_Value_Real(OBJECT_ANALOG_VALUE, instance, &value),
+        NULL);
+    zassert_false(islessgreater(value, 12.5f), NULL);
+    zassert_true(
+        Device_Status_Flags(OBJECT_ANALOG_VALUE, instance, &status_flags),
+        NULL);
+    zassert_true(
+        bitstring_bit(&status_flags, STATUS_FLAG_OUT_OF_SERVICE), NULL);
+    /* the present-value of an analog object is not unsigned */
+    zassert_false(
+        Device_Present_Value_Unsigned(
+            OBJECT_ANALOG_VALUE, instance, &unsigned_value),
+        NULL);
+    /* an object that does not exist */
+    zassert_false(
+        Device_Present_Value_Real(OBJECT_ANALOG_VALUE, instance + 1, &value),
+        NULL);
+    zassert_true(Analog_Value_Delete(instance), NULL);
+}
+
+/**
+ * @brief Test the clock that Device_Timer() moves along between the
+ *  reads of the clock from the OS
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Local_Time)
+#else
+static void test_Device_Local_Time(void)
+#endif
+{
+    BACNET_DATE bdate = { 0 };
+    BACNET_TIME btime = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+
+    datetime_set_date(&bdate, 2024, 12, 31);
+    datetime_set_time(&btime, 23, 59, 59, 90);
+    datetime_timesync(&bdate, &btime, false);
+    Device_Timer(0);
+    Device_Local_Time_Refresh();
+    Device_getCurrentDateTime(&bdatetime);
+    zassert_true(datetime_date_same(&bdatetime.date, &bdate), NULL);
+    zassert_true(datetime_time_same(&bdatetime.time, &btime), NULL);
+    /* the OS clock is not read again until the refresh period ends */
+    datetime_set_date(&bdate, 2025, 6, 1);
+    datetime_set_time(&btime, 12, 0, 0, 0);
+    datetime_timesync(&bdate, &btime, false);
+    Device_Timer(250);
+    Device_getCurrentDateTime(&bdatetime);
+    zassert_equal(bdatetime.date.year, 2025, NULL);
+    zassert_equal(bdatetime.date.month, 1, NULL);
+    zassert_equal(bdatetime.date.day, 1, NULL);
+    zassert_equal(bdatetime.time.hour, 0, NULL);
+    zassert_equal(bdatetime.time.min, 0, NULL);
+    zassert_equal(bdatetime.time.sec, 0, NULL);
+    zassert_equal(bdatetime.time.hundredths, 15, NULL);
+    /* short ticks are not lost */
+    Device_Timer(5);
+    Device_Timer(5);
+    Device_getCurrentDateTime(&bdatetime);
+    zassert_equal(bdatetime.time.hundredths, 16, NULL);
+    Device_Timer(740);
+    Device_getCurrentDateTime(&bdatetime);
+    zassert_true(datetime_date_same(&bdatetime.date, &bdate), NULL);
+    zassert_true(datetime_time_same(&bdatetime.time, &btime), NULL);
+}
 /**
  * @}
  */
@@ -432,7 +1187,15 @@ void test_main(void)
 {
     ztest_test_suite(
         device_tests, ztest_unit_test(testDevice),
-        ztest_unit_test(test_Device_Data_Sharing));
+        ztest_unit_test(test_Device_Data_Sharing),
+        ztest_unit_test(test_Device_Object_Name_Index),
+        ztest_unit_test(test_Device_Object_List_Cache),
+        ztest_unit_test(test_Device_Property_Cache),
+        ztest_unit_test(test_Device_Snapshot),
+        ztest_unit_test(test_Device_Timer_Active),
+        ztest_unit_test(test_Device_Object_Functions_Find),
+        ztest_unit_test(test_Device_Present_Value),
+        ztest_unit_test(test_Device_Local_Time));
 
     ztest_run_test_suite(device_tests);
 }
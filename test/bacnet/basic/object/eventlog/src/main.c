@@ -0,0 +1,574 @@
+/**
+ * @file
+ * @brief Unit test for the Event Log object
+ * @date 2026
+ *
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/object/eventlog.h>
+#include <property_test.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the clock of the device, in seconds since the epoch */
+static bacnet_time_t Test_Clock;
+/* a storage block that is kept over a cleanup of the logs */
+static uint8_t Test_Storage[BACNET_EVENT_LOG_STORAGE_SIZE(10)];
+static bool Test_Storage_Purged;
+
+bool Device_Valid_Object_Name(
+    const BACNET_CHARACTER_STRING *object_name,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance)
+{
+    (void)object_name;
+    (void)object_type;
+    (void)object_instance;
+    return true;
+}
+
+void Device_Inc_Database_Revision(void)
+{
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 0;
+}
+
+void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
+{
+    datetime_since_epoch_seconds(DateTime, Test_Clock);
+}
+
+static uint8_t *test_Event_Log_Storage_Open(
+    unsigned device_index, uint32_t object_instance, size_t *size)
+{
+    (void)device_index;
+    (void)object_instance;
+    *size = sizeof(Test_Storage);
+
+    return Test_Storage;
+}
+
+static void test_Event_Log_Storage_Close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge)
+{
+    (void)device_index;
+    (void)object_instance;
+    if (purge) {
+        memset(storage, 0, size);
+        Test_Storage_Purged = true;
+    }
+}
+
+/**
+ * @brief Set up an event notification of an object
+ * @param data - notification to set up
+ * @param instance - instance of the Analog Input of the event
+ */
+static void test_Event_Log_Notification_Init(
+    BACNET_EVENT_NOTIFICATION_DATA *data, uint32_t instance)
+{
+    memset(data, 0, sizeof(*data));
+    data->processIdentifier = 1234;
+    data->initiatingObjectIdentifier.type = OBJECT_DEVICE;
+    data->initiatingObjectIdentifier.instance = 0;
+    data->eventObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    data->eventObjectIdentifier.instance = instance;
+    data->timeStamp.tag = TIME_STAMP_SEQUENCE;
+    data->timeStamp.value.sequenceNum = 1;
+    data->notificationClass = 1;
+    data->priority = 100;
+    data->eventType = EVENT_OUT_OF_RANGE;
+    data->notifyType = NOTIFY_ALARM;
+    data->ackRequired = true;
+    data->fromState = EVENT_STATE_NORMAL;
+    data->toState = EVENT_STATE_HIGH_LIMIT;
+    data->notificationParams.outOfRange.exceedingValue = 3.45f;
+    data->notificationParams.outOfRange.deadband = 2.34f;
+    data->notificationParams.outOfRange.exceededLimit = 1.23f;
+    bitstring_init(&data->notificationParams.outOfRange.statusFlags);
+    bitstring_set_bit(
+        &data->notificationParams.outOfRange.statusFlags, STATUS_FLAG_IN_ALARM,
+        true);
+    bitstring_set_bit(
+        &data->notificationParams.outOfRange.statusFlags, STATUS_FLAG_FAULT,
+        false);
+    bitstring_set_bit(
+        &data->notificationParams.outOfRange.statusFlags,
+        STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(
+        &data->notificationParams.outOfRange.statusFlags,
+        STATUS_FLAG_OUT_OF_SERVICE, false);
+}
+
+/**
+ * @brief Set up a ReadRange request of an event log
+ * @param pRequest - request to set up
+ * @param object_instance - event log instance
+ * @param apdu - buffer for the response
+ * @param apdu_size - size of the buffer
+ */
+static void test_Event_Log_Request(
+    BACNET_READ_RANGE_DATA *pRequest,
+    uint32_t object_instance,
+    uint8_t *apdu,
+    size_t apdu_size)
+{
+    memset(pRequest, 0, sizeof(*pRequest));
+    pRequest->object_type = OBJECT_EVENT_LOG;
+    pRequest->object_instance = object_instance;
+    pRequest->object_property = PROP_LOG_BUFFER;
+    pRequest->array_index = BACNET_ARRAY_ALL;
+    pRequest->application_data = apdu;
+    pRequest->application_data_len = apdu_size;
+    pRequest->Overhead = 0;
+}
+
+/**
+ * @brief Decode a BACnetEventLogRecord
+ * @param apdu - the encoded record
+ * @param apdu_size - size of the encoded data
+ * @param seconds - [out] time stamp of the record
+ * @param choice - [out] the choice of log-datum
+ * @param data - [out] the notification of a notification record
+ * @return number of bytes decoded
+ */
+static int test_Event_Log_Record_Decode(
+    const uint8_t *apdu,
+    size_t apdu_size,
+    bacnet_time_t *seconds,
+    uint8_t *choice,
+    BACNET_EVENT_NOTIFICATION_DATA *data)
+{
+    BACNET_DATE_TIME timestamp = { 0 };
+    BACNET_BIT_STRING bit_string = { 0 };
+    int apdu_len = 0, len = 0;
+
+    len = bacnet_datetime_context_decode(apdu, apdu_size, 0, &timestamp);
+    zassert_true(len > 0, NULL);
+    apdu_len += len;
+    *seconds = datetime_seconds_since_epoch(&timestamp);
+    zassert_true(
+        bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &len),
+        NULL);
+    apdu_len += len;
+    len = bacnet_tag_number_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, choice);
+    zassert_true(len > 0, NULL);
+    if (*choice == 1) {
+        zassert_true(
+            bacnet_is_opening_tag_number(
+                &apdu[apdu_len], apdu_size - apdu_len, 1, &len),
+            NULL);
+        apdu_len += len;
+        len = event_notify_decode_service_request(
+            &apdu[apdu_len], apdu_size - apdu_len, data);
+        zassert_true(len > 0, NULL);
+        apdu_len += len;
+        zassert_true(
+            bacnet_is_closing_tag_number(
+                &apdu[apdu_len], apdu_size - apdu_len, 1, &len),
+            NULL);
+    } else {
+        len = bacnet_bitstring_context_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, 0, &bit_string);
+        zassert_true(len > 0, NULL);
+    }
+    apdu_len += len;
+    zassert_true(
+        bacnet_is_closing_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &len),
+        NULL);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+static void test_Event_Log_ReadProperty(void)
+{
+    unsigned count = 0;
+    uint32_t object_instance = 0;
+    bool status = false;
+    const int32_t known_fail_property_list[] = { -1 };
+
+    Event_Log_Init();
+    object_instance = Event_Log_Create(1);
+    zassert_equal(object_instance, 1, NULL);
+    count = Event_Log_Count();
+    zassert_equal(count, 1, NULL);
+    zassert_equal(Event_Log_Index_To_Instance(0), 1, NULL);
+    zassert_equal(Event_Log_Instance_To_Index(1), 0, NULL);
+    status = Event_Log_Valid_Instance(object_instance);
+    zassert_true(status, NULL);
+    zassert_equal(
+        Event_Log_Buffer_Size(object_instance), BACNET_EVENT_LOG_RECORDS_MAX,
+        NULL);
+    bacnet_object_properties_read_write_test(
+        OBJECT_EVENT_LOG, object_instance, Event_Log_Property_Lists,
+        Event_Log_Read_Property, Event_Log_Write_Property,
+        known_fail_property_list);
+    bacnet_object_name_ascii_test(
+        object_instance, Event_Log_Name_Set, Event_Log_Name_ASCII);
+    /* a wildcard instance is the next free instance */
+    zassert_equal(Event_Log_Create(BACNET_MAX_INSTANCE), 2, NULL);
+    zassert_true(Event_Log_Delete(2), NULL);
+    zassert_false(Event_Log_Delete(2), NULL);
+    zassert_true(Event_Log_Delete(object_instance), NULL);
+    zassert_equal(Event_Log_Count(), 0, NULL);
+    Event_Log_Cleanup();
+}
+
+static void test_Event_Log_Notification(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    char text[BACNET_EVENT_LOG_RECORD_SIZE] = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    BACNET_EVENT_NOTIFICATION_DATA data = { 0 };
+    BACNET_EVENT_NOTIFICATION_DATA test_data = { 0 };
+    BACNET_CHARACTER_STRING message = { 0 };
+    BACNET_CHARACTER_STRING test_message = { 0 };
+    const uint32_t object_instance = 1;
+    bacnet_time_t seconds = 0;
+    uint8_t choice = 0;
+    int len = 0, record_len = 0;
+
+    Event_Log_Init();
+    Test_Clock = 1000000;
+    zassert_equal(Event_Log_Create(object_instance), 1, NULL);
+    zassert_equal(Event_Log_Create(2), 2, NULL);
+    test_Event_Log_Notification_Init(&data, 7);
+    /* a disabled log does not log notifications */
+    zassert_false(
+        Event_Log_Record_Notification_Insert(object_instance, &data), NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 0, NULL);
+    zassert_true(Event_Log_Enable_Set(object_instance, true), NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 1, NULL);
+    characterstring_init_ansi(&message, "high limit");
+    data.messageText = &message;
+    Test_Clock++;
+    zassert_true(
+        Event_Log_Record_Notification_Insert(object_instance, &data), NULL);
+    /* the message text of a notification that is too large is left out */
+    memset(text, 'A', sizeof(text) - 1);
+    characterstring_init_ansi(&message, text);
+    Test_Clock++;
+    zassert_true(
+        Event_Log_Record_Notification_Insert(object_instance, &data), NULL);
+    /* every enabled log gets the notifications that are reported */
+    data.messageText = NULL;
+    Test_Clock++;
+    Event_Log_Event_Notification(&data);
+    zassert_equal(Event_Log_Record_Count(object_instance), 4, NULL);
+    zassert_equal(Event_Log_Total_Record_Count(object_instance), 4, NULL);
+    zassert_equal(Event_Log_Record_Count(2), 0, NULL);
+    /* the records are read back as they were logged */
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_READ_ALL;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 4, NULL);
+    zassert_equal(request.FirstSequence, 1, NULL);
+    record_len = test_Event_Log_Record_Decode(
+        apdu, len, &seconds, &choice, &test_data);
+    zassert_equal(seconds, 1000000, NULL);
+    zassert_equal(choice, 0, NULL);
+    test_data.messageText = &test_message;
+    record_len += test_Event_Log_Record_Decode(
+        &apdu[record_len], len - record_len, &seconds, &choice, &test_data);
+    zassert_equal(seconds, 1000001, NULL);
+    zassert_equal(choice, 1, NULL);
+    zassert_equal(
+        test_data.eventObjectIdentifier.type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(test_data.eventObjectIdentifier.instance, 7, NULL);
+    zassert_equal(test_data.toState, EVENT_STATE_HIGH_LIMIT, NULL);
+    /* the log is not a recipient of the notification */
+    zassert_equal(test_data.processIdentifier, 0, NULL);
+    zassert_true(
+        characterstring_ansi_same(&test_message, "high limit"), NULL);
+    memset(&test_data, 0, sizeof(test_data));
+    characterstring_init_ansi(&test_message, "");
+    test_data.messageText = &test_message;
+    record_len += test_Event_Log_Record_Decode(
+        &apdu[record_len], len - record_len, &seconds, &choice, &test_data);
+    zassert_equal(seconds, 1000002, NULL);
+    zassert_equal(choice, 1, NULL);
+    zassert_equal(characterstring_length(&test_message), 0, NULL);
+    record_len += test_Event_Log_Record_Decode(
+        &apdu[record_len], len - record_len, &seconds, &choice, &test_data);
+    zassert_equal(seconds, 1000003, NULL);
+    zassert_equal(record_len, len, NULL);
+    Event_Log_Cleanup();
+    Test_Clock = 0;
+}
+
+static void test_Event_Log_ReadRange(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    BACNET_EVENT_NOTIFICATION_DATA data = { 0 };
+    BACNET_DATE_TIME ref_time = { 0 };
+    const uint32_t object_instance = 1;
+    const bacnet_time_t start_time = 1000000;
+    uint32_t i;
+    int len = 0;
+
+    Event_Log_Init();
+    zassert_equal(Event_Log_Create(object_instance), 1, NULL);
+    zassert_true(Event_Log_Buffer_Size_Set(object_instance, 20), NULL);
+    Test_Clock = start_time;
+    zassert_true(Event_Log_Enable_Set(object_instance, true), NULL);
+    test_Event_Log_Notification_Init(&data, 1);
+    /* wrap around the log buffer, one record each second */
+    for (i = 0; i < 29; i++) {
+        Test_Clock = start_time + 1 + i;
+        zassert_true(
+            Event_Log_Record_Notification_Insert(object_instance, &data),
+            NULL);
+    }
+    zassert_equal(Event_Log_Record_Count(object_instance), 20, NULL);
+    zassert_equal(Event_Log_Total_Record_Count(object_instance), 30, NULL);
+    /* by position: all */
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_READ_ALL;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 20, NULL);
+    zassert_equal(request.FirstSequence, 11, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    /* by position: only as many as fit */
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_POSITION;
+    request.Range.RefIndex = 1;
+    request.Count = 20;
+    request.application_data_len = (len / 20) * 3;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    /* by sequence */
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_SEQUENCE;
+    request.Range.RefSeqNum = 15;
+    request.Count = 5;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_equal(request.FirstSequence, 15, NULL);
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_SEQUENCE;
+    request.Range.RefSeqNum = 12;
+    request.Count = -5;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_equal(request.ItemCount, 2, NULL);
+    zassert_equal(request.FirstSequence, 11, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    /* the records are gone from the log */
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_SEQUENCE;
+    request.Range.RefSeqNum = 1;
+    request.Count = 5;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_equal(len, 0, NULL);
+    zassert_equal(request.ItemCount, 0, NULL);
+    /* by time: the records after the reference time */
+    datetime_since_epoch_seconds(&ref_time, start_time + 20);
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    request.Range.RefTime = ref_time;
+    request.Count = 5;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_equal(request.FirstSequence, 22, NULL);
+    /* by time: the records before the reference time */
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    request.Range.RefTime = ref_time;
+    request.Count = -5;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_equal(request.FirstSequence, 16, NULL);
+    /* by time: no records after the newest */
+    datetime_since_epoch_seconds(&ref_time, start_time + 29);
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    request.Range.RefTime = ref_time;
+    request.Count = 5;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_equal(len, 0, NULL);
+    /* the clock is set back: the records are no longer in time order,
+       and are scanned from the end that was asked for */
+    Test_Clock = start_time + 5;
+    zassert_true(
+        Event_Log_Record_Notification_Insert(object_instance, &data), NULL);
+    datetime_since_epoch_seconds(&ref_time, start_time + 20);
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    request.Range.RefTime = ref_time;
+    request.Count = 5;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_equal(request.FirstSequence, 22, NULL);
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    request.Range.RefTime = ref_time;
+    request.Count = -5;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_equal(request.FirstSequence, 27, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    /* once the older records are overwritten, they are in order again */
+    for (i = 0; i < 20; i++) {
+        Test_Clock = start_time + 100 + i;
+        zassert_true(
+            Event_Log_Record_Notification_Insert(object_instance, &data),
+            NULL);
+    }
+    datetime_since_epoch_seconds(&ref_time, start_time + 105);
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    request.Range.RefTime = ref_time;
+    request.Count = -3;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_equal(request.FirstSequence, 34, NULL);
+    /* the records are kept when the buffer is resized */
+    zassert_true(Event_Log_Buffer_Size_Set(object_instance, 10), NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 10, NULL);
+    zassert_equal(Event_Log_Total_Record_Count(object_instance), 51, NULL);
+    test_Event_Log_Request(&request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    request.Range.RefTime = ref_time;
+    request.Count = 3;
+    len = Event_Log_Read_Range(apdu, &request);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_equal(request.FirstSequence, 42, NULL);
+    Event_Log_Cleanup();
+    Test_Clock = 0;
+}
+
+static void test_Event_Log_Stop_When_Full(void)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_EVENT_NOTIFICATION_DATA data = { 0 };
+    const uint32_t object_instance = 1;
+    uint32_t i;
+
+    Event_Log_Init();
+    zassert_equal(Event_Log_Create(object_instance), 1, NULL);
+    zassert_true(Event_Log_Buffer_Size_Set(object_instance, 10), NULL);
+    zassert_true(Event_Log_Stop_When_Full_Set(object_instance, true), NULL);
+    zassert_true(Event_Log_Stop_When_Full(object_instance), NULL);
+    zassert_true(Event_Log_Enable_Set(object_instance, true), NULL);
+    test_Event_Log_Notification_Init(&data, 1);
+    for (i = 0; i < 20; i++) {
+        Event_Log_Record_Notification_Insert(object_instance, &data);
+    }
+    /* the last record is the log-status of the log disabling itself */
+    zassert_false(Event_Log_Enable(object_instance), NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 10, NULL);
+    zassert_equal(Event_Log_Total_Record_Count(object_instance), 10, NULL);
+    /* a full log cannot be enabled */
+    wp_data.object_type = OBJECT_EVENT_LOG;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = PROP_ENABLE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.application_data_len =
+        encode_application_boolean(wp_data.application_data, true);
+    zassert_false(Event_Log_Write_Property(&wp_data), NULL);
+    zassert_equal(wp_data.error_class, ERROR_CLASS_OBJECT, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_LOG_BUFFER_FULL, NULL);
+    /* until the log is cleared */
+    wp_data.object_property = PROP_RECORD_COUNT;
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 1);
+    zassert_false(Event_Log_Write_Property(&wp_data), NULL);
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 0);
+    zassert_true(Event_Log_Write_Property(&wp_data), NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 1, NULL);
+    wp_data.object_property = PROP_ENABLE;
+    wp_data.application_data_len =
+        encode_application_boolean(wp_data.application_data, true);
+    zassert_true(Event_Log_Write_Property(&wp_data), NULL);
+    zassert_true(Event_Log_Enable(object_instance), NULL);
+    /* the buffer cannot be resized while the log is enabled */
+    wp_data.object_property = PROP_BUFFER_SIZE;
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 100);
+    zassert_false(Event_Log_Write_Property(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    Event_Log_Cleanup();
+}
+
+static void test_Event_Log_Storage(void)
+{
+    BACNET_EVENT_NOTIFICATION_DATA data = { 0 };
+    const uint32_t object_instance = 1;
+    uint32_t i;
+
+    Event_Log_Storage_Callback_Set(
+        test_Event_Log_Storage_Open, test_Event_Log_Storage_Close);
+    memset(Test_Storage, 0, sizeof(Test_Storage));
+    Test_Storage_Purged = false;
+    Event_Log_Init();
+    zassert_equal(Event_Log_Create(object_instance), 1, NULL);
+    /* the buffer size is what fits in the storage block */
+    zassert_equal(Event_Log_Buffer_Size(object_instance), 10, NULL);
+    zassert_true(Event_Log_Enable_Set(object_instance, true), NULL);
+    test_Event_Log_Notification_Init(&data, 1);
+    for (i = 0; i < 12; i++) {
+        zassert_true(
+            Event_Log_Record_Notification_Insert(object_instance, &data),
+            NULL);
+    }
+    zassert_equal(Event_Log_Record_Count(object_instance), 10, NULL);
+    /* the records are resumed when the log is created again */
+    Event_Log_Cleanup();
+    zassert_false(Test_Storage_Purged, NULL);
+    Event_Log_Init();
+    zassert_equal(Event_Log_Create(object_instance), 1, NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 10, NULL);
+    zassert_equal(Event_Log_Total_Record_Count(object_instance), 13, NULL);
+    /* and are purged when the log is deleted */
+    zassert_true(Event_Log_Delete(object_instance), NULL);
+    zassert_true(Test_Storage_Purged, NULL);
+    Event_Log_Cleanup();
+    Event_Log_Storage_Callback_Set(NULL, NULL);
+}
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+    ztest_test_suite(
+        eventlog_tests, ztest_unit_test(test_Event_Log_ReadProperty),
+        ztest_unit_test(test_Event_Log_Notification),
+        ztest_unit_test(test_Event_Log_ReadRange),
+        ztest_unit_test(test_Event_Log_Stop_When_Full),
+        ztest_unit_test(test_Event_Log_Storage));
+
+    ztest_run_test_suite(eventlog_tests);
+}
@@ -984,6 +984,116 @@ static void test_ShedInactive_gets_RcvShedRequests(void)
     zassert_equal(wp_data.error_code, ERROR_CODE_VALUE_OUT_OF_RANGE, NULL);
 }
 
+static unsigned Test_Batch_Calls;
+static unsigned Test_Batch_Writes[5];
+
+static void test_load_control_batch_write(
+    const BACNET_LOAD_CONTROL_WRITE *writes, unsigned count)
+{
+    unsigned i;
+
+    zassert_true(count <= LOAD_CONTROL_BATCH_WRITES_MAX, NULL);
+    Test_Batch_Calls++;
+    for (i = 0; i < count; i++) {
+        zassert_equal(writes[i].object_type, OBJECT_ANALOG_OUTPUT, NULL);
+        zassert_equal(writes[i].property_id, PROP_PRESENT_VALUE, NULL);
+        zassert_equal(writes[i].priority, 4, NULL);
+        zassert_false(writes[i].relinquish, NULL);
+        zassert_true(isgreaterequal(writes[i].value, 50.0f), NULL);
+        zassert_true(
+            writes[i].object_instance < ARRAY_SIZE(Test_Batch_Writes), NULL);
+        Test_Batch_Writes[writes[i].object_instance]++;
+    }
+}
+
+static void test_load_control_full_load_read(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID property_id,
+    uint8_t *priority,
+    float *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)property_id;
+    /* the load never sheds, so the objects keep writing */
+    *priority = BACNET_MAX_PRIORITY;
+    *value = 100.0f;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(lc_tests, test_Load_Control_Dispatch)
+#else
+static void test_Load_Control_Dispatch(void)
+#endif
+{
+    BACNET_OBJECT_PROPERTY_REFERENCE reference = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    unsigned writes[ARRAY_SIZE(Test_Batch_Writes)];
+    unsigned calls;
+    uint32_t instance;
+
+    Load_Control_Init();
+    datetime_set_values(&bdatetime, 2007, 2, 27, 15, 1, 0, 0);
+    datetime_timesync(&bdatetime.date, &bdatetime.time, false);
+    for (instance = 1; instance <= 4; instance++) {
+        zassert_equal(Load_Control_Create(instance), instance, NULL);
+        reference.object_identifier.type = OBJECT_ANALOG_OUTPUT;
+        reference.object_identifier.instance = instance;
+        reference.property_identifier = PROP_PRESENT_VALUE;
+        Load_Control_Manipulated_Variable_Reference_Set(instance, &reference);
+        Load_Control_Manipulated_Object_Read_Callback_Set(
+            instance, test_load_control_full_load_read);
+        Load_Control_Priority_For_Writing_Set(instance, 4);
+        Load_Control_Update_Interval_Set(instance, 0);
+        Load_Control_WriteProperty_Enable(instance, true);
+        Load_Control_WriteProperty_Request_Shed_Level(
+            instance, BACNET_SHED_TYPE_PERCENT, 50.0f);
+        Load_Control_WriteProperty_Shed_Duration(instance, 60);
+        Load_Control_WriteProperty_Start_Time(
+            instance, 2007, 2, 27, 15, 0, 0, 0);
+    }
+    Load_Control_Batch_Write_Callback_Set(test_load_control_batch_write);
+    Load_Control_Ramp_Window_Set(4000);
+    zassert_equal(Load_Control_Ramp_Window(), 4000, NULL);
+    /* RcvShedRequest and CannotMeetShed */
+    Load_Control_Dispatch_Timer(1);
+    Load_Control_Dispatch_Timer(1);
+    for (instance = 1; instance <= 4; instance++) {
+        zassert_equal(
+            Load_Control_Present_Value(instance), BACNET_SHED_NON_COMPLIANT,
+            NULL);
+    }
+    zassert_equal(Test_Batch_Calls, 0, NULL);
+    /* the shed writes are spread over the ramp window */
+    Load_Control_Dispatch_Timer(1);
+    zassert_equal(Test_Batch_Calls, 1, NULL);
+    zassert_equal(Test_Batch_Writes[1], 1, NULL);
+    zassert_equal(Test_Batch_Writes[2], 0, NULL);
+    Load_Control_Dispatch_Timer(1000);
+    zassert_equal(Test_Batch_Calls, 2, NULL);
+    zassert_equal(Test_Batch_Writes[1], 2, NULL);
+    zassert_equal(Test_Batch_Writes[2], 1, NULL);
+    zassert_equal(Test_Batch_Writes[3], 0, NULL);
+    zassert_equal(Test_Batch_Writes[4], 0, NULL);
+    Load_Control_Dispatch_Timer(2000);
+    zassert_equal(Test_Batch_Calls, 3, NULL);
+    zassert_equal(Test_Batch_Writes[3], 1, NULL);
+    zassert_equal(Test_Batch_Writes[4], 1, NULL);
+    /* without a ramp window, every object writes at once */
+    Load_Control_Ramp_Window_Set(0);
+    Load_Control_Dispatch_Timer(4000);
+    memcpy(writes, Test_Batch_Writes, sizeof(writes));
+    calls = Test_Batch_Calls;
+    Load_Control_Dispatch_Timer(1);
+    zassert_equal(Test_Batch_Calls, calls + 1, NULL);
+    for (instance = 1; instance <= 4; instance++) {
+        zassert_equal(Test_Batch_Writes[instance], writes[instance] + 1, NULL);
+    }
+    Load_Control_Batch_Write_Callback_Set(NULL);
+    Load_Control_Cleanup();
+}
+
 /**
  * @}
  */
@@ -996,7 +1106,8 @@ void test_main(void)
     ztest_test_suite(
         lc_tests, ztest_unit_test(test_Load_Control_Read_Write_Property),
         ztest_unit_test(testLoadControlStateMachine),
-        ztest_unit_test(test_ShedInactive_gets_RcvShedRequests));
+        ztest_unit_test(test_ShedInactive_gets_RcvShedRequests),
+        ztest_unit_test(test_Load_Control_Dispatch));
 
     ztest_run_test_suite(lc_tests);
 }
@@ -5,6 +5,7 @@
  * @date October 2025
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/loop.h>
 #include <bacnet/bactext.h>
@@ -365,6 +366,87 @@ static void test_Loop_Operation(void)
     /* cleanup all */
     Loop_Cleanup();
 }
+
+static float Read_Real_Value;
+static uint32_t Read_Real_Instance;
+static bool Read_Real(uint32_t object_instance, float *value)
+{
+    Read_Real_Instance = object_instance;
+    *value = Read_Real_Value;
+
+    return true;
+}
+
+static loop_read_real_function Read_Real_Bind(
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    if ((object_type == OBJECT_ANALOG_INPUT) &&
+        (object_property == PROP_PRESENT_VALUE) &&
+        (array_index == BACNET_ARRAY_ALL)) {
+        return Read_Real;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Test the variable references bound to read functions
+ */
+static void test_Loop_Read_Real_Bind(void)
+{
+    const uint32_t instance = 123;
+    BACNET_OBJECT_PROPERTY_REFERENCE reference = { 0 };
+    float value;
+
+    Loop_Init();
+    Loop_Create(instance);
+    Loop_Read_Property_Internal_Callback_Set(Read_Property_Internal);
+    Loop_Write_Property_Internal_Callback_Set(Write_Property_Internal);
+    Loop_Read_Real_Bind_Callback_Set(Read_Real_Bind);
+    memset(
+        &Read_Property_Internal_Data, 0, sizeof(Read_Property_Internal_Data));
+    Loop_Setpoint_Set(instance, 10.0f);
+    Loop_Proportional_Constant_Set(instance, 1.0f);
+    Loop_Integral_Constant_Set(instance, 0.0f);
+    Loop_Derivative_Constant_Set(instance, 0.0f);
+    Loop_Bias_Set(instance, 0.0f);
+    Loop_Maximum_Output_Set(instance, 100.0f);
+    Loop_Minimum_Output_Set(instance, 0.0f);
+    reference.object_identifier.type = OBJECT_ANALOG_INPUT;
+    reference.object_identifier.instance = 1;
+    reference.property_identifier = PROP_PRESENT_VALUE;
+    reference.property_array_index = BACNET_ARRAY_ALL;
+    Loop_Controlled_Variable_Reference_Set(instance, &reference);
+    reference.object_identifier.type = OBJECT_ANALOG_OUTPUT;
+    Loop_Manipulated_Variable_Reference_Set(instance, &reference);
+    reference.object_identifier.type = OBJECT_ANALOG_INPUT;
+    Read_Real_Value = 4.0f;
+    Loop_Timer(instance, 1000);
+    zassert_equal(Read_Real_Instance, 1, NULL);
+    value = Loop_Controlled_Variable_Value(instance);
+    zassert_false(islessgreater(value, 4.0f), "value=%f", (double)value);
+    value = Loop_Present_Value(instance);
+    zassert_true(fabsf(value - 6.0f) < 0.01f, "value=%f", (double)value);
+    /* the bound references do not use ReadProperty */
+    zassert_equal(Read_Property_Internal_Data.application_data, NULL, NULL);
+    /* the integral term, also in the fixed-point PID */
+    Loop_Integral_Constant_Set(instance, 0.5f);
+    Loop_Timer(instance, 1000);
+    value = Loop_Present_Value(instance);
+    zassert_true(fabsf(value - 12.0f) < 0.01f, "value=%f", (double)value);
+    /* references without a read function use ReadProperty */
+    reference.object_identifier.type = OBJECT_ANALOG_VALUE;
+    Loop_Setpoint_Reference_Set(instance, &reference);
+    Loop_Timer(instance, 1000);
+    zassert_equal(
+        Read_Property_Internal_Data.object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(
+        Read_Property_Internal_Data.object_property, PROP_PRESENT_VALUE, NULL);
+    Loop_Read_Real_Bind_Callback_Set(NULL);
+    Loop_Cleanup();
+}
 /**
  * @}
  */
@@ -373,7 +455,8 @@ void test_main(void)
 {
     ztest_test_suite(
         loop_tests, ztest_unit_test(test_Loop_Read_Write),
-        ztest_unit_test(test_Loop_Operation));
+        ztest_unit_test(test_Loop_Operation),
+        ztest_unit_test(test_Loop_Read_Real_Bind));
 
     ztest_run_test_suite(loop_tests);
 }
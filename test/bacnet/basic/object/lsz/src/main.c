@@ -7,6 +7,7 @@
  */
 #include <zephyr/ztest.h>
 #include <bacnet/bactext.h>
+#include <bacnet/basic/object/lsp.h>
 #include <bacnet/basic/object/lsz.h>
 #include <property_test.h>
 
@@ -15,6 +16,12 @@
  * @{
  */
 
+/* stub for the device object instance */
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
 /**
  * @brief Test
  */
@@ -53,6 +60,122 @@ static void testLifeSafetyZone(void)
     /* cleanup */
     status = Life_Safety_Zone_Delete(object_instance);
 }
+
+/**
+ * @brief Test the member state propagation from points to zones
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(testsLifeSafetyZone, testLifeSafetyZoneMembers)
+#else
+static void testLifeSafetyZoneMembers(void)
+#endif
+{
+    bool status;
+    uint32_t zone_instance = 0, other_zone_instance = 0;
+    uint32_t point_instance = 0, other_point_instance = 0;
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+    unsigned alarm_count = 0, trouble_count = 0, supervisory_count = 0;
+
+    Life_Safety_Point_Init();
+    Life_Safety_Zone_Init();
+    zone_instance = Life_Safety_Zone_Create(1);
+    other_zone_instance = Life_Safety_Zone_Create(2);
+    point_instance = Life_Safety_Point_Create(1);
+    other_point_instance = Life_Safety_Point_Create(2);
+    /* a point already in alarm is counted when added */
+    status = Life_Safety_Point_Present_Value_Set(
+        point_instance, LIFE_SAFETY_STATE_ALARM);
+    zassert_true(status, NULL);
+    member.objectIdentifier.type = OBJECT_LIFE_SAFETY_POINT;
+    member.objectIdentifier.instance = point_instance;
+    member.propertyIdentifier = PROP_PRESENT_VALUE;
+    member.arrayIndex = BACNET_ARRAY_ALL;
+    member.deviceIdentifier.type = OBJECT_DEVICE;
+    member.deviceIdentifier.instance = Device_Object_Instance_Number();
+    status = Life_Safety_Zone_Members_Add(zone_instance, &member);
+    zassert_true(status, NULL);
+    status = Life_Safety_Zone_Members_Add(other_zone_instance, &member);
+    zassert_true(status, NULL);
+    member.objectIdentifier.instance = other_point_instance;
+    member.deviceIdentifier.type = BACNET_NO_DEV_TYPE;
+    member.deviceIdentifier.instance = BACNET_NO_DEV_ID;
+    status = Life_Safety_Zone_Members_Add(zone_instance, &member);
+    zassert_true(status, NULL);
+    /* a point in another device is not a local member */
+    member.objectIdentifier.instance = 3;
+    member.deviceIdentifier.type = OBJECT_DEVICE;
+    member.deviceIdentifier.instance = Device_Object_Instance_Number() + 1;
+    status = Life_Safety_Zone_Members_Add(zone_instance, &member);
+    zassert_true(status, NULL);
+    status = Life_Safety_Zone_Member_State_Count(
+        zone_instance, &alarm_count, &trouble_count, &supervisory_count);
+    zassert_true(status, NULL);
+    zassert_equal(alarm_count, 1, NULL);
+    zassert_equal(trouble_count, 0, NULL);
+    zassert_equal(supervisory_count, 0, NULL);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(zone_instance), LIFE_SAFETY_STATE_ALARM,
+        NULL);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(other_zone_instance),
+        LIFE_SAFETY_STATE_ALARM, NULL);
+    /* changes propagate to every parent zone */
+    Life_Safety_Point_Present_Value_Set(
+        other_point_instance, LIFE_SAFETY_STATE_SUPERVISORY);
+    Life_Safety_Point_Present_Value_Set(
+        point_instance, LIFE_SAFETY_STATE_FAULT);
+    Life_Safety_Zone_Member_State_Count(
+        zone_instance, &alarm_count, &trouble_count, &supervisory_count);
+    zassert_equal(alarm_count, 0, NULL);
+    zassert_equal(trouble_count, 1, NULL);
+    zassert_equal(supervisory_count, 1, NULL);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(zone_instance),
+        LIFE_SAFETY_STATE_SUPERVISORY, NULL);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(other_zone_instance),
+        LIFE_SAFETY_STATE_FAULT, NULL);
+    /* an out-of-service zone keeps its present-value */
+    Life_Safety_Zone_Out_Of_Service_Set(other_zone_instance, true);
+    Life_Safety_Point_Present_Value_Set(
+        point_instance, LIFE_SAFETY_STATE_QUIET);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(other_zone_instance),
+        LIFE_SAFETY_STATE_FAULT, NULL);
+    Life_Safety_Zone_Out_Of_Service_Set(other_zone_instance, false);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(other_zone_instance),
+        LIFE_SAFETY_STATE_QUIET, NULL);
+    /* a deleted point no longer counts */
+    status = Life_Safety_Point_Delete(other_point_instance);
+    zassert_true(status, NULL);
+    Life_Safety_Zone_Member_State_Count(
+        zone_instance, &alarm_count, &trouble_count, &supervisory_count);
+    zassert_equal(supervisory_count, 0, NULL);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(zone_instance), LIFE_SAFETY_STATE_QUIET,
+        NULL);
+    /* cleared members no longer propagate */
+    Life_Safety_Zone_Members_Clear(zone_instance);
+    Life_Safety_Point_Present_Value_Set(
+        point_instance, LIFE_SAFETY_STATE_ALARM);
+    Life_Safety_Zone_Member_State_Count(
+        zone_instance, &alarm_count, &trouble_count, &supervisory_count);
+    zassert_equal(alarm_count, 0, NULL);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(zone_instance), LIFE_SAFETY_STATE_QUIET,
+        NULL);
+    zassert_equal(
+        Life_Safety_Zone_Present_Value(other_zone_instance),
+        LIFE_SAFETY_STATE_ALARM, NULL);
+    /* cleanup */
+    status = Life_Safety_Zone_Delete(other_zone_instance);
+    zassert_true(status, NULL);
+    Life_Safety_Point_Present_Value_Set(
+        point_instance, LIFE_SAFETY_STATE_QUIET);
+    Life_Safety_Zone_Cleanup();
+    Life_Safety_Point_Cleanup();
+}
 /**
  * @}
  */
@@ -62,7 +185,9 @@ ZTEST_SUITE(testsLifeSafetyZone, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(testsLifeSafetyZone, ztest_unit_test(testLifeSafetyZone));
+    ztest_test_suite(
+        testsLifeSafetyZone, ztest_unit_test(testLifeSafetyZone),
+        ztest_unit_test(testLifeSafetyZoneMembers));
 
     ztest_run_test_suite(testsLifeSafetyZone);
 }
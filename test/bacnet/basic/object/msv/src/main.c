@@ -47,6 +47,44 @@ static void testMultistateValue(void)
     status = Multistate_Value_Delete(object_instance);
     zassert_true(status, NULL);
 }
+/**
+ * @brief Test creating a range of objects at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(msv_tests, testMultistateValueCreateRange)
+#else
+static void testMultistateValueCreateRange(void)
+#endif
+{
+    uint32_t object_instance = 0, created = 0;
+    const int32_t skip_fail_property_list[] = { -1 };
+
+    Multistate_Value_Init();
+    object_instance = Multistate_Value_Create(5);
+    zassert_equal(object_instance, 5, NULL);
+    /* existing objects in the range are left alone */
+    created = Multistate_Value_Create_Range(1, 10);
+    zassert_equal(created, 9, NULL);
+    zassert_equal(Multistate_Value_Count(), 10, NULL);
+    for (object_instance = 1; object_instance <= 10; object_instance++) {
+        zassert_true(Multistate_Value_Valid_Instance(object_instance), NULL);
+    }
+    zassert_false(Multistate_Value_Valid_Instance(11), NULL);
+    bacnet_object_properties_read_write_test(
+        OBJECT_MULTI_STATE_VALUE, 10, Multistate_Value_Property_Lists,
+        Multistate_Value_Read_Property, Multistate_Value_Write_Property,
+        skip_fail_property_list);
+    created = Multistate_Value_Create_Range(1, 10);
+    zassert_equal(created, 0, NULL);
+    created = Multistate_Value_Create_Range(BACNET_MAX_INSTANCE - 1, 2);
+    zassert_equal(created, 0, NULL);
+    zassert_true(Multistate_Value_Delete(3), NULL);
+    zassert_true(Multistate_Value_Delete(5), NULL);
+    zassert_false(Multistate_Value_Delete(5), NULL);
+    zassert_equal(Multistate_Value_Count(), 8, NULL);
+    Multistate_Value_Cleanup();
+    zassert_equal(Multistate_Value_Count(), 0, NULL);
+}
 /**
  * @}
  */
@@ -56,7 +94,9 @@ ZTEST_SUITE(msv_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(msv_tests, ztest_unit_test(testMultistateValue));
+    ztest_test_suite(
+        msv_tests, ztest_unit_test(testMultistateValue),
+        ztest_unit_test(testMultistateValueCreateRange));
 
     ztest_run_test_suite(msv_tests);
 }
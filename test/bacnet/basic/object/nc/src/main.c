@@ -11,7 +11,14 @@
 #include <bacnet/rp.h>
 #include <bacnet/wp.h>
 #include <bacnet/list_element.h>
+#include <bacnet/event.h>
 #include <bacnet/basic/object/nc.h>
+#include <bacnet/basic/binding/address.h>
+
+/* the last notification that was sent, as recorded by the stubs */
+unsigned Stub_Event_Body_Sent(
+    uint32_t *process_id, const uint8_t **body, size_t *body_len);
+void Stub_Event_Body_Send_Status(bool status);
 
 /**
  * @addtogroup bacnet_tests
@@ -394,12 +401,120 @@ static void test_Notification_Class_Common_Reporting(void)
     const uint32_t instance = 1;
     bool status = false;
     BACNET_EVENT_NOTIFICATION_DATA event_data = { 0 };
+    BACNET_DESTINATION recipient_list[NC_MAX_RECIPIENTS] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_DATE bdate = { 0 };
+    BACNET_TIME btime = { 0 };
+    uint8_t body[MAX_APDU] = { 0 };
+    const uint8_t *sent_body = NULL;
+    size_t sent_body_len = 0;
+    uint32_t process_id = 0;
+    unsigned count, i;
+    int body_len;
 
     Notification_Class_Init();
     status = Notification_Class_Valid_Instance(instance);
     zassert_true(status, NULL);
 
     Notification_Class_common_reporting_function(&event_data);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 0, NULL);
+    /* one confirmed and one unconfirmed recipient */
+    datetime_set_date(&bdate, 2026, 10, 14);
+    datetime_set_time(&btime, 12, 0, 0, 0);
+    datetime_timesync(&bdate, &btime, false);
+    for (i = 0; i < NC_MAX_RECIPIENTS; i++) {
+        bacnet_destination_default_init(&recipient_list[i]);
+    }
+    for (i = 0; i < 2; i++) {
+        bitstring_set_bit(
+            &recipient_list[i].Transitions, TRANSITION_TO_OFFNORMAL, true);
+        bitstring_set_bit(
+            &recipient_list[i].Transitions, TRANSITION_TO_NORMAL, true);
+    }
+    recipient_list[0].Recipient.tag = BACNET_RECIPIENT_TAG_ADDRESS;
+    recipient_list[0].Recipient.type.address.mac_len = 1;
+    recipient_list[0].Recipient.type.address.mac[0] = 1;
+    recipient_list[0].ProcessIdentifier = 7;
+    recipient_list[0].ConfirmedNotify = true;
+    recipient_list[1].Recipient.type.device.instance = 1234;
+    recipient_list[1].ProcessIdentifier = 8;
+    dest.mac_len = 1;
+    dest.mac[0] = 2;
+    address_add(1234, MAX_APDU, &dest);
+    status = Notification_Class_Set_Recipient_List(instance, recipient_list);
+    zassert_true(status, NULL);
+    event_data.notificationClass = instance;
+    event_data.eventObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    event_data.eventObjectIdentifier.instance = 1;
+    event_data.timeStamp.tag = TIME_STAMP_SEQUENCE;
+    event_data.timeStamp.value.sequenceNum = 1;
+    event_data.eventType = EVENT_NONE;
+    event_data.notifyType = NOTIFY_EVENT;
+    event_data.fromState = EVENT_STATE_NORMAL;
+    event_data.toState = EVENT_STATE_OFFNORMAL;
+    Notification_Class_common_reporting_function(&event_data);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(process_id, 8, NULL);
+    /* the body is the service request without the Process Identifier */
+    body_len = event_notify_encode_service_request_body(body, &event_data);
+    zassert_true(body_len > 0, NULL);
+    zassert_equal(sent_body_len, (size_t)body_len, NULL);
+    zassert_mem_equal(sent_body, body, sent_body_len, NULL);
+    /* a transition that no recipient wants */
+    event_data.toState = EVENT_STATE_FAULT;
+    Notification_Class_common_reporting_function(&event_data);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 0, NULL);
+    zassert_equal(Notification_Class_Event_Queue_Count(), 0, NULL);
+    /* notifications that could not be sent are queued */
+    Stub_Event_Body_Send_Status(false);
+    event_data.toState = EVENT_STATE_OFFNORMAL;
+    Notification_Class_common_reporting_function(&event_data);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(Notification_Class_Event_Queue_Count(), 2, NULL);
+    /* a newer transition of the same object supersedes them */
+    event_data.fromState = EVENT_STATE_OFFNORMAL;
+    event_data.toState = EVENT_STATE_NORMAL;
+    Notification_Class_common_reporting_function(&event_data);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(Notification_Class_Event_Queue_Count(), 2, NULL);
+    zassert_equal(Notification_Class_Event_Queue_Superseded(), 2, NULL);
+    /* not due yet */
+    Notification_Class_Event_Queue_Timer(NC_EVENT_RETRY_MS - 1);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 0, NULL);
+    /* due, and fails again, so the next try waits longer */
+    Notification_Class_Event_Queue_Timer(1);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 2, NULL);
+    Notification_Class_Event_Queue_Timer(NC_EVENT_RETRY_MS);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 0, NULL);
+    /* sent the queued newer transition */
+    Stub_Event_Body_Send_Status(true);
+    Notification_Class_Event_Queue_Timer(NC_EVENT_RETRY_MS);
+    count = Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
+    zassert_equal(count, 2, NULL);
+    body_len = event_notify_encode_service_request_body(body, &event_data);
+    zassert_equal(sent_body_len, (size_t)body_len, NULL);
+    zassert_mem_equal(sent_body, body, sent_body_len, NULL);
+    zassert_equal(Notification_Class_Event_Queue_Count(), 0, NULL);
+    zassert_equal(Notification_Class_Event_Queue_Dropped(), 0, NULL);
+    /* dropped after too many tries */
+    Stub_Event_Body_Send_Status(false);
+    Notification_Class_common_reporting_function(&event_data);
+    zassert_equal(Notification_Class_Event_Queue_Count(), 2, NULL);
+    for (i = 0; i < NC_EVENT_RETRY_LIMIT; i++) {
+        Notification_Class_Event_Queue_Timer(NC_EVENT_RETRY_MAX_MS);
+    }
+    zassert_equal(Notification_Class_Event_Queue_Count(), 0, NULL);
+    zassert_equal(Notification_Class_Event_Queue_Dropped(), 2, NULL);
+    Stub_Event_Body_Send_Status(true);
+    (void)Stub_Event_Body_Sent(&process_id, &sent_body, &sent_body_len);
 }
 
 /**
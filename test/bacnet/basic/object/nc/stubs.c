@@ -7,7 +7,9 @@
  * @copyright SPDX-License-Identifier: MIT
  */
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/datetime.h"
 #include "bacnet/bacdef.h"
 #include "bacnet/npdu.h"
@@ -46,6 +48,84 @@ Send_CEvent_Notify(uint32_t device_id, BACNET_EVENT_NOTIFICATION_DATA *data)
     return 0;
 }
 
+/* the notifications that were sent from an encoded body */
+static unsigned Event_Body_Sent_Count;
+static uint32_t Event_Body_Process_ID;
+static uint8_t Event_Body[MAX_APDU];
+static size_t Event_Body_Len;
+static bool Event_Body_Send_Status = true;
+
+void Stub_Event_Body_Send_Status(bool status)
+{
+    Event_Body_Send_Status = status;
+}
+
+static void event_body_sent(
+    uint32_t process_id, const uint8_t *body, size_t body_len)
+{
+    Event_Body_Sent_Count++;
+    Event_Body_Process_ID = process_id;
+    Event_Body_Len = 0;
+    if (body_len <= sizeof(Event_Body)) {
+        memcpy(Event_Body, body, body_len);
+        Event_Body_Len = body_len;
+    }
+}
+
+unsigned Stub_Event_Body_Sent(
+    uint32_t *process_id, const uint8_t **body, size_t *body_len)
+{
+    unsigned count = Event_Body_Sent_Count;
+
+    *process_id = Event_Body_Process_ID;
+    *body = Event_Body;
+    *body_len = Event_Body_Len;
+    Event_Body_Sent_Count = 0;
+
+    return count;
+}
+
+uint8_t Send_CEvent_Notify_Body(
+    uint32_t device_id,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len)
+{
+    (void)device_id;
+    event_body_sent(process_id, body, body_len);
+    return Event_Body_Send_Status ? 1 : 0;
+}
+
+uint8_t Send_CEvent_Notify_Body_Address(
+    uint8_t *pdu,
+    uint16_t pdu_size,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len,
+    BACNET_ADDRESS *dest)
+{
+    (void)pdu;
+    (void)pdu_size;
+    (void)dest;
+    event_body_sent(process_id, body, body_len);
+    return Event_Body_Send_Status ? 1 : 0;
+}
+
+int Send_UEvent_Notify_Body(
+    uint8_t *buffer,
+    size_t buffer_size,
+    uint32_t process_id,
+    const uint8_t *body,
+    size_t body_len,
+    BACNET_ADDRESS *dest)
+{
+    (void)buffer;
+    (void)buffer_size;
+    (void)dest;
+    event_body_sent(process_id, body, body_len);
+    return Event_Body_Send_Status ? (int)body_len : -1;
+}
+
 void Send_WhoIs(int32_t low_limit, int32_t high_limit)
 {
     (void)low_limit;
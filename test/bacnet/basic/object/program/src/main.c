@@ -100,6 +100,106 @@ static void test_program_task(uint32_t object_instance)
         Program_State(object_instance), PROGRAM_STATE_UNLOADING, NULL);
 }
 
+struct test_program {
+    unsigned runs;
+    int wait;
+};
+
+static int Test_Program_Run(void *context)
+{
+    struct test_program *program = context;
+    int wait = program->wait;
+
+    program->runs++;
+    program->wait = 0;
+
+    return wait;
+}
+
+static uint32_t Test_Clock_Value;
+static uint32_t Test_Clock(void)
+{
+    Test_Clock_Value += 10;
+
+    return Test_Clock_Value;
+}
+
+/**
+ * @brief Test the budgeted round-robin scheduler
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(program_object_tests, testProgramScheduler)
+#else
+static void testProgramScheduler(void)
+#endif
+{
+    struct test_program program[3] = { 0 };
+    uint32_t instance[3];
+    unsigned i;
+
+    Program_Init();
+    for (i = 0; i < 3; i++) {
+        instance[i] = Program_Create(1 + i);
+        Program_Context_Set(instance[i], &program[i]);
+        Program_Run_Set(instance[i], Test_Program_Run);
+    }
+    Program_Scheduler_Budget_Set(4, 1, 0);
+    /* nothing runs until the programs are RUNNING */
+    Program_Scheduler_Task();
+    zassert_equal(program[0].runs, 0, NULL);
+    for (i = 0; i < 3; i++) {
+        Program_State_Set(instance[i], PROGRAM_STATE_RUNNING);
+    }
+    /* the timer only handles the state when the scheduler runs them */
+    Program_Timer(instance[0], 10);
+    zassert_equal(program[0].runs, 0, NULL);
+    Program_Scheduler_Task();
+    zassert_equal(program[0].runs, 2, NULL);
+    zassert_equal(program[1].runs, 1, NULL);
+    zassert_equal(program[2].runs, 1, NULL);
+    Program_Scheduler_Task();
+    zassert_equal(program[0].runs, 3, NULL);
+    zassert_equal(program[1].runs, 3, NULL);
+    zassert_equal(program[2].runs, 2, NULL);
+    zassert_equal(Program_Run_Count(instance[1]), 3, NULL);
+    /* a program that waits sleeps out of the run queue */
+    program[2].wait = 100;
+    Program_Scheduler_Task();
+    zassert_equal(
+        Program_State(instance[2]), PROGRAM_STATE_WAITING, NULL);
+    Program_Scheduler_Task();
+    zassert_equal(program[2].runs, 3, NULL);
+    Program_Timer(instance[2], 50);
+    zassert_equal(
+        Program_State(instance[2]), PROGRAM_STATE_WAITING, NULL);
+    Program_Timer(instance[2], 50);
+    zassert_equal(
+        Program_State(instance[2]), PROGRAM_STATE_RUNNING, NULL);
+    zassert_equal(program[2].runs, 3, NULL);
+    Program_Scheduler_Task();
+    zassert_equal(program[2].runs, 4, NULL);
+    /* a halted program leaves the run queue */
+    Program_Change_Set(instance[0], PROGRAM_REQUEST_HALT);
+    Program_Timer(instance[0], 10);
+    zassert_equal(Program_State(instance[0]), PROGRAM_STATE_HALTED, NULL);
+    i = program[0].runs;
+    Program_Scheduler_Task();
+    zassert_equal(program[0].runs, i, NULL);
+    /* the time budget, and the time spent in each program */
+    Program_Scheduler_Clock_Set(Test_Clock);
+    Program_Scheduler_Budget_Set(4, 4, 30);
+    i = program[1].runs + program[2].runs;
+    Program_Scheduler_Task();
+    zassert_equal(program[1].runs + program[2].runs, i + 1, NULL);
+    zassert_equal(
+        Program_Run_Time(instance[1]) + Program_Run_Time(instance[2]), 10,
+        NULL);
+    Program_Scheduler_Clock_Set(NULL);
+    Program_Scheduler_Budget_Set(0, 0, 0);
+    zassert_true(Program_Delete(instance[1]), NULL);
+    Program_Cleanup();
+}
+
 /**
  * @brief Test
  */
@@ -140,7 +240,9 @@ ZTEST_SUITE(program_object_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(program_object_tests, ztest_unit_test(testProgramObject));
+    ztest_test_suite(
+        program_object_tests, ztest_unit_test(testProgramObject),
+        ztest_unit_test(testProgramScheduler));
 
     ztest_run_test_suite(program_object_tests);
 }
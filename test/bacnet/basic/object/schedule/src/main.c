@@ -7,6 +7,7 @@
  * @copyright SPDX-License-Identifier: MIT
  */
 
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/schedule.h>
 #include <property_test.h>
@@ -16,6 +17,29 @@
  * @{
  */
 
+/**
+ * @brief Sort the time values of a day the way that the Schedule object
+ *  keeps them, by time, with the order kept for the same times
+ * @param daily - the day to sort
+ */
+static void daily_schedule_sort(BACNET_DAILY_SCHEDULE *daily)
+{
+    BACNET_TIME_VALUE tv;
+    size_t i, j;
+
+    for (i = 1; i < daily->TV_Count; i++) {
+        tv = daily->Time_Values[i];
+        j = i;
+        while ((j > 0) &&
+               (datetime_compare_time(
+                    &daily->Time_Values[j - 1].Time, &tv.Time) > 0)) {
+            daily->Time_Values[j] = daily->Time_Values[j - 1];
+            j--;
+        }
+        daily->Time_Values[j] = tv;
+    }
+}
+
 /**
  * @brief Test
  */
@@ -28,7 +52,7 @@ static void testSchedule(void)
     unsigned count = 0;
     uint32_t object_instance = 0;
     const int32_t skip_fail_property_list[] = { -1 };
-    BACNET_DAILY_SCHEDULE daily_schedule = { 0 }, *test_daily_schedule;
+    BACNET_DAILY_SCHEDULE daily_schedule = { 0 }, test_daily_schedule = { 0 };
     BACNET_SPECIAL_EVENT special_event = { 0 }, *test_special_event;
     BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE object_property_reference = { 0 },
                                             test_object_property_reference = {
@@ -58,10 +82,15 @@ static void testSchedule(void)
                 BACNET_APPLICATION_TAG_REAL;
             daily_schedule.Time_Values[tv].Value.type.Real = 1.0f + tv;
         }
-        Schedule_Weekly_Schedule_Set(object_instance, day, &daily_schedule);
-        test_daily_schedule = Schedule_Weekly_Schedule(object_instance, day);
         status =
-            bacnet_dailyschedule_same(&daily_schedule, test_daily_schedule);
+            Schedule_Weekly_Schedule_Set(object_instance, day, &daily_schedule);
+        zassert_true(status, NULL);
+        status = Schedule_Weekly_Schedule_Get(
+            object_instance, day, &test_daily_schedule);
+        zassert_true(status, NULL);
+        daily_schedule_sort(&daily_schedule);
+        status =
+            bacnet_dailyschedule_same(&daily_schedule, &test_daily_schedule);
         zassert_true(status, NULL);
     }
     for (i = 0; i < BACNET_EXCEPTION_SCHEDULE_SIZE; i++) {
@@ -130,6 +159,202 @@ static void testSchedule(void)
         Schedule_Object(object_instance), BACNET_WEEKDAY_SUNDAY, NULL);
     Schedule_Timer(BACNET_MAX_INSTANCE, 0);
 }
+
+/**
+ * @brief Test that the Present Value is only recalculated when it may change
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(schedule_tests, testScheduleUpdate)
+#else
+static void testScheduleUpdate(void)
+#endif
+{
+    uint32_t object_instance = 0;
+    SCHEDULE_DESCR *pObject;
+    BACNET_DAILY_SCHEDULE daily_schedule = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    size_t day = 0;
+    bool status = false;
+
+    Schedule_Init();
+    object_instance = Schedule_Index_To_Instance(0);
+    pObject = Schedule_Object(object_instance);
+    zassert_not_null(pObject, NULL);
+    daily_schedule.TV_Count = 2;
+    datetime_set_time(&daily_schedule.Time_Values[0].Time, 8, 0, 0, 0);
+    daily_schedule.Time_Values[0].Value.tag = BACNET_APPLICATION_TAG_REAL;
+    daily_schedule.Time_Values[0].Value.type.Real = 1.0f;
+    datetime_set_time(&daily_schedule.Time_Values[1].Time, 17, 0, 0, 0);
+    daily_schedule.Time_Values[1].Value.tag = BACNET_APPLICATION_TAG_REAL;
+    daily_schedule.Time_Values[1].Value.type.Real = 2.0f;
+    for (day = 0; day < BACNET_WEEKLY_SCHEDULE_SIZE; day++) {
+        Schedule_Weekly_Schedule_Set(object_instance, day, &daily_schedule);
+    }
+    datetime_set_date(&bdatetime.date, 2024, 1, 1);
+    datetime_set_time(&bdatetime.time, 7, 0, 0, 0);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_true(status, NULL);
+    zassert_equal(
+        pObject->Present_Value.tag, pObject->Schedule_Default.tag, NULL);
+    /* nothing changes until 08:00 */
+    datetime_set_time(&bdatetime.time, 7, 59, 59, 99);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_false(status, NULL);
+    datetime_set_time(&bdatetime.time, 8, 0, 0, 0);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_true(status, NULL);
+    zassert_equal(
+        pObject->Present_Value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    zassert_false(islessgreater(pObject->Present_Value.type.Real, 1.0f), NULL);
+    datetime_set_time(&bdatetime.time, 12, 0, 0, 0);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_false(status, NULL);
+    /* a changed schedule is recalculated */
+    daily_schedule.Time_Values[0].Value.type.Real = 3.0f;
+    Schedule_Weekly_Schedule_Set(
+        object_instance, bdatetime.date.wday - 1, &daily_schedule);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_true(status, NULL);
+    zassert_false(islessgreater(pObject->Present_Value.type.Real, 3.0f), NULL);
+    Schedule_Transition_Invalidate(object_instance);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_true(status, NULL);
+    /* as is the time going back, or another day */
+    datetime_set_time(&bdatetime.time, 7, 0, 0, 0);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_true(status, NULL);
+    datetime_set_date(&bdatetime.date, 2024, 1, 2);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_true(status, NULL);
+    /* after the last time of the day, nothing changes until tomorrow */
+    datetime_set_time(&bdatetime.time, 17, 0, 0, 0);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_true(status, NULL);
+    zassert_false(islessgreater(pObject->Present_Value.type.Real, 2.0f), NULL);
+    datetime_set_time(&bdatetime.time, 23, 0, 0, 0);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_false(status, NULL);
+    status = Schedule_Update_PV(NULL, &bdatetime);
+    zassert_false(status, NULL);
+    status = Schedule_Update_PV(pObject, NULL);
+    zassert_false(status, NULL);
+}
+
+/**
+ * @brief Test the time values that the Weekly_Schedule keeps in a pool,
+ *  sorted by time
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(schedule_tests, testScheduleTimeValues)
+#else
+static void testScheduleTimeValues(void)
+#endif
+{
+    uint32_t object_instance = 0;
+    SCHEDULE_DESCR *pObject;
+    BACNET_DAILY_SCHEDULE daily_schedule = { 0 }, test_daily_schedule = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    BACNET_TIME time_of_day = { 0 };
+    size_t free_count = 0, day = 0, tv = 0;
+    unsigned hour, index;
+    bool status = false;
+
+    Schedule_Init();
+    object_instance = Schedule_Index_To_Instance(0);
+    pObject = Schedule_Object(object_instance);
+    zassert_not_null(pObject, NULL);
+    free_count = Schedule_Time_Values_Free();
+    zassert_true(free_count > 0, NULL);
+    /* written out of order, and read back sorted by time */
+    daily_schedule.TV_Count = 3;
+    datetime_set_time(&daily_schedule.Time_Values[0].Time, 17, 0, 0, 0);
+    daily_schedule.Time_Values[0].Value.tag = BACNET_APPLICATION_TAG_REAL;
+    daily_schedule.Time_Values[0].Value.type.Real = 2.0f;
+    datetime_set_time(&daily_schedule.Time_Values[1].Time, 8, 0, 0, 0);
+    daily_schedule.Time_Values[1].Value.tag = BACNET_APPLICATION_TAG_REAL;
+    daily_schedule.Time_Values[1].Value.type.Real = 1.0f;
+    datetime_set_time(&daily_schedule.Time_Values[2].Time, 12, 0, 0, 0);
+    daily_schedule.Time_Values[2].Value.tag = BACNET_APPLICATION_TAG_NULL;
+    status = Schedule_Weekly_Schedule_Set(object_instance, 0, &daily_schedule);
+    zassert_true(status, NULL);
+    zassert_equal(Schedule_Time_Values_Free(), free_count - 3, NULL);
+    status =
+        Schedule_Weekly_Schedule_Get(object_instance, 0, &test_daily_schedule);
+    zassert_true(status, NULL);
+    zassert_equal(test_daily_schedule.TV_Count, 3, NULL);
+    zassert_equal(test_daily_schedule.Time_Values[0].Time.hour, 8, NULL);
+    zassert_equal(test_daily_schedule.Time_Values[1].Time.hour, 12, NULL);
+    zassert_equal(test_daily_schedule.Time_Values[2].Time.hour, 17, NULL);
+    zassert_false(
+        islessgreater(test_daily_schedule.Time_Values[2].Value.type.Real, 2.0f),
+        NULL);
+    /* another day after it in the pool keeps its values when the first
+       day shrinks */
+    daily_schedule.TV_Count = 2;
+    status = Schedule_Weekly_Schedule_Set(object_instance, 1, &daily_schedule);
+    zassert_true(status, NULL);
+    daily_schedule.TV_Count = 1;
+    status = Schedule_Weekly_Schedule_Set(object_instance, 0, &daily_schedule);
+    zassert_true(status, NULL);
+    zassert_equal(Schedule_Time_Values_Free(), free_count - 3, NULL);
+    status =
+        Schedule_Weekly_Schedule_Get(object_instance, 1, &test_daily_schedule);
+    zassert_true(status, NULL);
+    zassert_equal(test_daily_schedule.TV_Count, 2, NULL);
+    zassert_equal(test_daily_schedule.Time_Values[0].Time.hour, 8, NULL);
+    zassert_equal(test_daily_schedule.Time_Values[1].Time.hour, 17, NULL);
+    /* the value at a time is the last time value that is not after it */
+    for (hour = 0; hour < 24; hour++) {
+        datetime_set_time(&time_of_day, hour, 30, 0, 0);
+        Schedule_Recalculate_PV(pObject, BACNET_WEEKDAY_TUESDAY, &time_of_day);
+        if (hour < 8) {
+            zassert_equal(
+                pObject->Present_Value.tag, pObject->Schedule_Default.tag,
+                NULL);
+        } else if (hour < 17) {
+            zassert_false(
+                islessgreater(pObject->Present_Value.type.Real, 1.0f), NULL);
+        } else {
+            zassert_false(
+                islessgreater(pObject->Present_Value.type.Real, 2.0f), NULL);
+        }
+    }
+    /* a wildcard time is found without the sort order */
+    daily_schedule.TV_Count = 1;
+    datetime_set_time(&daily_schedule.Time_Values[0].Time, 0xFF, 30, 0, 0);
+    daily_schedule.Time_Values[0].Value.tag = BACNET_APPLICATION_TAG_REAL;
+    daily_schedule.Time_Values[0].Value.type.Real = 5.0f;
+    status = Schedule_Weekly_Schedule_Set(object_instance, 2, &daily_schedule);
+    zassert_true(status, NULL);
+    datetime_set_date(&bdatetime.date, 2024, 1, 3);
+    zassert_equal(bdatetime.date.wday, BACNET_WEEKDAY_WEDNESDAY, NULL);
+    datetime_set_time(&bdatetime.time, 10, 45, 0, 0);
+    status = Schedule_Update_PV(pObject, &bdatetime);
+    zassert_true(status, NULL);
+    zassert_false(islessgreater(pObject->Present_Value.type.Real, 5.0f), NULL);
+    zassert_false(pObject->Transition_Valid, NULL);
+    /* fill the pool with the days of the other objects, until a day does
+       not fit, which is then not changed */
+    daily_schedule.TV_Count = BACNET_DAILY_SCHEDULE_TIME_VALUES_SIZE;
+    for (tv = 0; tv < daily_schedule.TV_Count; tv++) {
+        datetime_set_time(&daily_schedule.Time_Values[tv].Time, 1, tv, 0, 0);
+    }
+    status = true;
+    for (index = 1; status && (index < Schedule_Count()); index++) {
+        object_instance = Schedule_Index_To_Instance(index);
+        for (day = 0; status && (day < BACNET_WEEKLY_SCHEDULE_SIZE); day++) {
+            status = Schedule_Weekly_Schedule_Set(
+                object_instance, day, &daily_schedule);
+        }
+    }
+    zassert_false(status, NULL);
+    free_count = Schedule_Time_Values_Free();
+    zassert_true(free_count < BACNET_DAILY_SCHEDULE_TIME_VALUES_SIZE, NULL);
+    status = Schedule_Weekly_Schedule_Get(
+        object_instance, day - 1, &test_daily_schedule);
+    zassert_true(status, NULL);
+    zassert_equal(test_daily_schedule.TV_Count, 0, NULL);
+}
 /**
  * @}
  */
@@ -139,7 +364,10 @@ ZTEST_SUITE(schedule_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(schedule_tests, ztest_unit_test(testSchedule));
+    ztest_test_suite(
+        schedule_tests, ztest_unit_test(testSchedule),
+        ztest_unit_test(testScheduleUpdate),
+        ztest_unit_test(testScheduleTimeValues));
 
     ztest_run_test_suite(schedule_tests);
 }
@@ -15,6 +15,12 @@
  * @{
  */
 
+/* stub for the device object instance */
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
 static void Structured_View_Subordinate_List_Member_Same(
     BACNET_SUBORDINATE_DATA *list_member_a,
     BACNET_SUBORDINATE_DATA *list_member_b)
@@ -1010,6 +1016,136 @@ static void test_subordinate_list_resize(void)
     Structured_View_Cleanup();
 }
 
+struct test_subtree_data {
+    uint32_t instance[8];
+    uint32_t parent[8];
+    unsigned depth[8];
+    unsigned count;
+    unsigned limit;
+};
+
+static bool test_subtree_callback(
+    uint32_t object_instance,
+    uint32_t parent_instance,
+    unsigned depth,
+    void *context)
+{
+    struct test_subtree_data *data = context;
+
+    if (data->count < ARRAY_SIZE(data->instance)) {
+        data->instance[data->count] = object_instance;
+        data->parent[data->count] = parent_instance;
+        data->depth[data->count] = depth;
+    }
+    data->count++;
+
+    return data->count < data->limit;
+}
+
+static void test_subordinate_add(
+    uint32_t object_instance,
+    uint32_t device_instance,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t subordinate_instance)
+{
+    BACNET_SUBORDINATE_DATA element = { 0 };
+    BACNET_ARRAY_INDEX array_index;
+
+    element.Device_Instance = device_instance;
+    element.Object_Type = object_type;
+    element.Object_Instance = subordinate_instance;
+    array_index =
+        Structured_View_Subordinate_List_Element_Add(object_instance, &element);
+    zassert_not_equal(array_index, BACNET_ARRAY_ALL, NULL);
+}
+
+/**
+ * @brief Test the Structured View hierarchy index
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tests_object_structured_view, test_hierarchy)
+#else
+static void test_hierarchy(void)
+#endif
+{
+    struct test_subtree_data data = { 0 };
+    BACNET_SUBORDINATE_DATA element = { 0 };
+    BACNET_ARRAY_INDEX array_index;
+    unsigned count;
+    uint32_t instance;
+
+    Structured_View_Init();
+    for (instance = 1; instance <= 4; instance++) {
+        zassert_equal(Structured_View_Create(instance), instance, NULL);
+    }
+    /* 1 lists 2 and 3, 2 and 3 list 4, and 3 lists 1 again */
+    test_subordinate_add(1, 1234, OBJECT_STRUCTURED_VIEW, 2);
+    test_subordinate_add(1, 1234, OBJECT_ANALOG_INPUT, 5);
+    test_subordinate_add(1, 99, OBJECT_STRUCTURED_VIEW, 6);
+    test_subordinate_add(1, BACNET_MAX_INSTANCE, OBJECT_STRUCTURED_VIEW, 3);
+    test_subordinate_add(2, 1234, OBJECT_STRUCTURED_VIEW, 4);
+    test_subordinate_add(3, 1234, OBJECT_STRUCTURED_VIEW, 4);
+    test_subordinate_add(3, 1234, OBJECT_STRUCTURED_VIEW, 1);
+    count = Structured_View_Hierarchy_Child_Count(1);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(Structured_View_Hierarchy_Child(1, 0), 2, NULL);
+    zassert_equal(Structured_View_Hierarchy_Child(1, 1), 3, NULL);
+    zassert_equal(
+        Structured_View_Hierarchy_Child(1, 2), BACNET_MAX_INSTANCE, NULL);
+    zassert_equal(Structured_View_Hierarchy_Child_Count(4), 0, NULL);
+    count = Structured_View_Hierarchy_Parent_Count(4);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(Structured_View_Hierarchy_Parent(4, 0), 2, NULL);
+    zassert_equal(Structured_View_Hierarchy_Parent(4, 1), 3, NULL);
+    zassert_equal(Structured_View_Hierarchy_Parent_Count(1), 1, NULL);
+    zassert_equal(Structured_View_Hierarchy_Parent(1, 0), 3, NULL);
+    zassert_equal(Structured_View_Hierarchy_Parent_Count(5), 0, NULL);
+    /* depth first, each object once, and the cycle is not followed */
+    data.limit = UINT32_MAX;
+    count = Structured_View_Hierarchy_Subtree(1, test_subtree_callback, &data);
+    zassert_equal(count, 4, NULL);
+    zassert_equal(data.count, 4, NULL);
+    zassert_equal(data.instance[0], 1, NULL);
+    zassert_equal(data.parent[0], BACNET_MAX_INSTANCE, NULL);
+    zassert_equal(data.depth[0], 0, NULL);
+    zassert_equal(data.instance[1], 2, NULL);
+    zassert_equal(data.parent[1], 1, NULL);
+    zassert_equal(data.depth[1], 1, NULL);
+    zassert_equal(data.instance[2], 4, NULL);
+    zassert_equal(data.parent[2], 2, NULL);
+    zassert_equal(data.depth[2], 2, NULL);
+    zassert_equal(data.instance[3], 3, NULL);
+    zassert_equal(data.parent[3], 1, NULL);
+    zassert_equal(data.depth[3], 1, NULL);
+    count = Structured_View_Hierarchy_Subtree(3, NULL, NULL);
+    zassert_equal(count, 4, NULL);
+    count = Structured_View_Hierarchy_Subtree(4, NULL, NULL);
+    zassert_equal(count, 1, NULL);
+    count = Structured_View_Hierarchy_Subtree(5, NULL, NULL);
+    zassert_equal(count, 0, NULL);
+    /* the callback stops the enumeration */
+    data.count = 0;
+    data.limit = 2;
+    count = Structured_View_Hierarchy_Subtree(1, test_subtree_callback, &data);
+    zassert_equal(count, 2, NULL);
+    /* the index follows the Subordinate_List changes */
+    element.Device_Instance = 1234;
+    element.Object_Type = OBJECT_STRUCTURED_VIEW;
+    element.Object_Instance = 2;
+    array_index =
+        Structured_View_Subordinate_List_Element_Remove(1, &element);
+    zassert_not_equal(array_index, BACNET_ARRAY_ALL, NULL);
+    zassert_equal(Structured_View_Hierarchy_Child_Count(1), 1, NULL);
+    zassert_equal(Structured_View_Hierarchy_Child(1, 0), 3, NULL);
+    zassert_true(Structured_View_Delete(3), NULL);
+    zassert_equal(Structured_View_Hierarchy_Parent_Count(4), 1, NULL);
+    zassert_equal(Structured_View_Hierarchy_Parent(4, 0), 2, NULL);
+    zassert_equal(Structured_View_Hierarchy_Child_Count(1), 0, NULL);
+    zassert_equal(Structured_View_Create(3), 3, NULL);
+    zassert_equal(Structured_View_Hierarchy_Child_Count(1), 1, NULL);
+    Structured_View_Cleanup();
+}
+
 /**
  * @}
  */
@@ -1034,7 +1170,8 @@ void test_main(void)
         ztest_unit_test(test_sequential_add_remove_cycles),
         ztest_unit_test(test_invalid_instance_validation),
         ztest_unit_test(test_state_consistency_after_purge),
-        ztest_unit_test(test_subordinate_list_resize));
+        ztest_unit_test(test_subordinate_list_resize),
+        ztest_unit_test(test_hierarchy));
 
     ztest_run_test_suite(tests_object_structured_view);
 }
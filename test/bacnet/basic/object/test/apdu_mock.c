@@ -15,6 +15,16 @@ bool apdu_service_supported(BACNET_SERVICES_SUPPORTED service_supported)
     return true;
 }
 
+void apdu_services_supported(BACNET_BIT_STRING *bit_string)
+{
+    unsigned i;
+
+    bitstring_init(bit_string);
+    for (i = 0; i < MAX_BACNET_SERVICES_SUPPORTED; i++) {
+        bitstring_set_bit(bit_string, (uint8_t)i, true);
+    }
+}
+
 static uint16_t Timeout_Milliseconds = 1000;
 uint16_t apdu_timeout(void)
 {
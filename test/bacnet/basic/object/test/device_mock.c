@@ -46,3 +46,63 @@ int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     (void)rpdata;
     return 0;
 }
+
+bool Device_Encode_Value_List(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value_list;
+    return false;
+}
+
+bool Device_Status_Flags(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_BIT_STRING *status_flags)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)status_flags;
+    return false;
+}
+
+bool Device_Present_Value_Real(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, float *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
+bool Device_Present_Value_Enumerated(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, uint32_t *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
+bool Device_Present_Value_Unsigned(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_UNSIGNED_INTEGER *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
+bool Device_Present_Value_Boolean(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
@@ -24,3 +24,19 @@ bool tsm_get_transaction_pdu(
 
     return false;
 }
+
+bool tsm_get_transaction_pdu_peer(
+    const BACNET_ADDRESS *src,
+    uint8_t invokeID,
+    BACNET_NPDU_DATA *ndpu_data,
+    uint8_t *apdu,
+    uint16_t *apdu_len)
+{
+    (void)src;
+    (void)invokeID;
+    (void)ndpu_data;
+    (void)apdu;
+    (void)apdu_len;
+
+    return false;
+}
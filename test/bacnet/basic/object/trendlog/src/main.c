@@ -7,15 +7,173 @@
  * @copyright SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/trendlog.h>
 #include <property_test.h>
 
+/* the Analog Input object, and Trend Log index, that has no value list */
+#define TEST_READ_PROPERTY_INSTANCE 3
+/* the Analog Input object, and Trend Log index, that has typed reads */
+#define TEST_TYPED_INSTANCE 4
+
 /**
  * @addtogroup bacnet_tests
  * @{
  */
 
+/* the clock of the device, in seconds since the epoch */
+static bacnet_time_t Test_Clock;
+/* the value of the objects that are logged */
+static float Test_Present_Value = 42.0f;
+static unsigned Test_Read_Property_Count;
+static unsigned Test_Value_List_Count;
+static unsigned Test_Typed_Count;
+
+bool Device_Valid_Object_Name(
+    const BACNET_CHARACTER_STRING *object_name,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance)
+{
+    (void)object_name;
+    (void)object_type;
+    (void)object_instance;
+    return true;
+}
+
+void Device_Inc_Database_Revision(void)
+{
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 0;
+}
+
+bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    (void)wp_data;
+    return false;
+}
+
+void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
+{
+    datetime_since_epoch_seconds(DateTime, Test_Clock);
+}
+
+/* the Analog Input object without a value list is read with ReadProperty */
+int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    BACNET_BIT_STRING bit_string;
+
+    if ((rpdata->object_type != OBJECT_ANALOG_INPUT) ||
+        (rpdata->object_instance != TEST_READ_PROPERTY_INSTANCE)) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return BACNET_STATUS_ERROR;
+    }
+    if (rpdata->object_property == PROP_STATUS_FLAGS) {
+        bitstring_init(&bit_string);
+        bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
+        bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, false);
+        bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
+        bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, false);
+        return encode_application_bitstring(
+            rpdata->application_data, &bit_string);
+    }
+    Test_Read_Property_Count++;
+
+    return encode_application_real(
+        rpdata->application_data, Test_Present_Value);
+}
+
+/* the other Analog Input objects have a value list */
+bool Device_Encode_Value_List(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    if ((object_type != OBJECT_ANALOG_INPUT) ||
+        (object_instance == TEST_READ_PROPERTY_INSTANCE) ||
+        (object_instance == TEST_TYPED_INSTANCE) || !value_list ||
+        !value_list->next) {
+        return false;
+    }
+    value_list->propertyIdentifier = PROP_PRESENT_VALUE;
+    value_list->value.tag = BACNET_APPLICATION_TAG_REAL;
+    value_list->value.type.Real = Test_Present_Value;
+    value_list = value_list->next;
+    value_list->propertyIdentifier = PROP_STATUS_FLAGS;
+    value_list->value.tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value_list->value.type.Bit_String);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_OUT_OF_SERVICE, true);
+    Test_Value_List_Count++;
+
+    return true;
+}
+
+/* one Analog Input object has the typed reads */
+bool Device_Status_Flags(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_BIT_STRING *status_flags)
+{
+    if ((object_type != OBJECT_ANALOG_INPUT) ||
+        (object_instance != TEST_TYPED_INSTANCE)) {
+        return false;
+    }
+    bitstring_init(status_flags);
+    bitstring_set_bit(status_flags, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(status_flags, STATUS_FLAG_FAULT, false);
+    bitstring_set_bit(status_flags, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(status_flags, STATUS_FLAG_OUT_OF_SERVICE, true);
+
+    return true;
+}
+
+bool Device_Present_Value_Real(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, float *value)
+{
+    if ((object_type != OBJECT_ANALOG_INPUT) ||
+        (object_instance != TEST_TYPED_INSTANCE)) {
+        return false;
+    }
+    *value = Test_Present_Value;
+    Test_Typed_Count++;
+
+    return true;
+}
+
+bool Device_Present_Value_Enumerated(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, uint32_t *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
+bool Device_Present_Value_Unsigned(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_UNSIGNED_INTEGER *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
+bool Device_Present_Value_Boolean(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
 /**
  * @brief Test
  */
@@ -140,6 +298,897 @@ static void test_Trend_Log_ReadRange_BySequence(void)
         (unsigned)pRequest.FirstSequence,
         (unsigned)(total_records - pRequest.ItemCount + 1));
 }
+
+/**
+ * @brief Set up a ReadRange by time request of a trend log
+ * @param pRequest - request to set up
+ * @param object_instance - trend log instance
+ * @param seconds - reference time, in seconds since the epoch
+ * @param count - number of records requested
+ */
+static void test_Trend_Log_ReadRange_Time_Request(
+    BACNET_READ_RANGE_DATA *pRequest,
+    uint32_t object_instance,
+    bacnet_time_t seconds,
+    int32_t count)
+{
+    memset(pRequest, 0, sizeof(*pRequest));
+    pRequest->object_type = OBJECT_TRENDLOG;
+    pRequest->object_instance = object_instance;
+    pRequest->object_property = PROP_LOG_BUFFER;
+    pRequest->array_index = BACNET_ARRAY_ALL;
+    pRequest->RequestType = RR_BY_TIME;
+    TL_Local_Time_To_BAC(&pRequest->Range.RefTime, seconds);
+    pRequest->Count = count;
+    pRequest->Overhead = 0;
+    bitstring_init(&pRequest->ResultFlags);
+}
+
+static void test_Trend_Log_ReadRange_ByTime(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA pRequest = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    bacnet_time_t first_time = 0;
+    int len = 0;
+    uint32_t object_instance = 0;
+    uint32_t total_records = 0;
+    uint32_t record_count = 0;
+    uint32_t first_seq = 0;
+
+    Trend_Log_Init();
+    /* the second log holds records every 15 minutes from February 2009 */
+    object_instance = Trend_Log_Index_To_Instance(1);
+    datetime_set_values(&bdatetime, 2009, 2, 1, 0, 0, 0, 0);
+    first_time = datetime_seconds_since_epoch(&bdatetime);
+    total_records = Trend_Log_Total_Record_Count(object_instance);
+    record_count = Trend_Log_Record_Count(object_instance);
+    first_seq = total_records - record_count + 1;
+
+    /* positive count: the records after the reference time */
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance, first_time + (900 * 10), 5);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pRequest.ItemCount, 5, NULL);
+    zassert_equal(pRequest.FirstSequence, first_seq + 11, NULL);
+    zassert_false(
+        bitstring_bit(&pRequest.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance, first_time + (900 * 10) + 1, 5);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pRequest.FirstSequence, first_seq + 11, NULL);
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance, first_time - 1, 5);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pRequest.ItemCount, 5, NULL);
+    zassert_equal(pRequest.FirstSequence, first_seq, NULL);
+    zassert_true(
+        bitstring_bit(&pRequest.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance,
+        first_time + (900 * (record_count - 3)), 5);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pRequest.ItemCount, 2, NULL);
+    zassert_equal(pRequest.FirstSequence, total_records - 1, NULL);
+    zassert_true(
+        bitstring_bit(&pRequest.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance,
+        first_time + (900 * (record_count - 1)), 5);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_equal(len, 0, NULL);
+    zassert_equal(pRequest.ItemCount, 0, NULL);
+
+    /* negative count: the records before the reference time */
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance, first_time + (900 * 10), -5);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pRequest.ItemCount, 5, NULL);
+    zassert_equal(pRequest.FirstSequence, first_seq + 5, NULL);
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance, first_time + (900 * 10) + 1, -5);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pRequest.ItemCount, 5, NULL);
+    zassert_equal(pRequest.FirstSequence, first_seq + 6, NULL);
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance, first_time + (900 * 10), -20);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pRequest.ItemCount, 10, NULL);
+    zassert_equal(pRequest.FirstSequence, first_seq, NULL);
+    zassert_true(
+        bitstring_bit(&pRequest.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    test_Trend_Log_ReadRange_Time_Request(
+        &pRequest, object_instance, first_time, -5);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_equal(len, 0, NULL);
+    zassert_equal(pRequest.ItemCount, 0, NULL);
+}
+
+/**
+ * @brief Write an unsigned or boolean property of a trend log
+ * @param object_instance - trend log instance
+ * @param property - property to write
+ * @param value - value to write
+ * @param boolean - true to write a boolean value
+ * @param wp_data - [out] the write request, with any error
+ * @return true if the write succeeded
+ */
+static bool test_Trend_Log_Write(
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID property,
+    uint32_t value,
+    bool boolean,
+    BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    memset(wp_data, 0, sizeof(*wp_data));
+    wp_data->object_type = OBJECT_TRENDLOG;
+    wp_data->object_instance = object_instance;
+    wp_data->object_property = property;
+    wp_data->array_index = BACNET_ARRAY_ALL;
+    wp_data->priority = BACNET_NO_PRIORITY;
+    if (boolean) {
+        wp_data->application_data_len =
+            encode_application_boolean(wp_data->application_data, value);
+    } else {
+        wp_data->application_data_len =
+            encode_application_unsigned(wp_data->application_data, value);
+    }
+
+    return Trend_Log_Write_Property(wp_data);
+}
+
+static void test_Trend_Log_Buffer_Size(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA pRequest = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint32_t object_instance = 0;
+    uint32_t total_records = 0;
+    int log_index = 0;
+    int len = 0;
+    uint32_t i;
+
+    Trend_Log_Init();
+    object_instance = Trend_Log_Index_To_Instance(2);
+    log_index = Trend_Log_Instance_To_Index(object_instance);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), TL_MAX_ENTRIES, NULL);
+    /* not while the log is enabled */
+    zassert_false(
+        test_Trend_Log_Write(
+            object_instance, PROP_BUFFER_SIZE, 10, false, &wp_data),
+        NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    zassert_true(
+        test_Trend_Log_Write(object_instance, PROP_ENABLE, 0, true, &wp_data),
+        NULL);
+    zassert_false(
+        test_Trend_Log_Write(
+            object_instance, PROP_BUFFER_SIZE, 0, false, &wp_data),
+        NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_VALUE_OUT_OF_RANGE, NULL);
+    zassert_false(
+        test_Trend_Log_Write(
+            object_instance, PROP_BUFFER_SIZE, TL_BUFFER_SIZE_MAX + 1, false,
+            &wp_data),
+        NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_VALUE_OUT_OF_RANGE, NULL);
+    /* resizing purges the log */
+    total_records = Trend_Log_Total_Record_Count(object_instance);
+    zassert_true(
+        test_Trend_Log_Write(
+            object_instance, PROP_BUFFER_SIZE, 10, false, &wp_data),
+        NULL);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), 10, NULL);
+    zassert_equal(Trend_Log_Record_Count(object_instance), 1, NULL);
+    zassert_equal(
+        Trend_Log_Total_Record_Count(object_instance), total_records + 1,
+        NULL);
+    /* the smaller log wraps around */
+    for (i = 0; i < 25; i++) {
+        TL_Insert_Status_Rec(log_index, LOG_STATUS_LOG_INTERRUPTED, true);
+    }
+    zassert_equal(Trend_Log_Record_Count(object_instance), 10, NULL);
+    zassert_equal(
+        Trend_Log_Total_Record_Count(object_instance), total_records + 26,
+        NULL);
+    pRequest.object_type = OBJECT_TRENDLOG;
+    pRequest.object_instance = object_instance;
+    pRequest.object_property = PROP_LOG_BUFFER;
+    pRequest.array_index = BACNET_ARRAY_ALL;
+    pRequest.RequestType = RR_READ_ALL;
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    zassert_equal(pRequest.ItemCount, 10, NULL);
+    zassert_true(
+        bitstring_bit(&pRequest.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&pRequest.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    zassert_true(
+        Trend_Log_Buffer_Size_Set(object_instance, TL_MAX_ENTRIES), NULL);
+    zassert_false(Trend_Log_Buffer_Size_Set(object_instance, 0), NULL);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), TL_MAX_ENTRIES, NULL);
+    zassert_true(
+        test_Trend_Log_Write(object_instance, PROP_ENABLE, 1, true, &wp_data),
+        NULL);
+}
+
+/* storage that outlives the trend logs, for as many as the test uses */
+#define TEST_STORAGE_LOGS 8
+static uint8_t Test_Storage[TEST_STORAGE_LOGS]
+                          [TL_STORAGE_SIZE(TL_MAX_ENTRIES)];
+static unsigned Test_Storage_Purge_Count;
+
+static uint8_t *test_Trend_Log_Storage_Open(
+    unsigned device_index, uint32_t object_instance, size_t *size)
+{
+    (void)device_index;
+    if ((object_instance >= TEST_STORAGE_LOGS) ||
+        (*size > sizeof(Test_Storage[0]))) {
+        return NULL;
+    }
+    *size = sizeof(Test_Storage[0]);
+
+    return Test_Storage[object_instance];
+}
+
+static void test_Trend_Log_Storage_Close(
+    unsigned device_index,
+    uint32_t object_instance,
+    uint8_t *storage,
+    size_t size,
+    bool purge)
+{
+    (void)device_index;
+    (void)object_instance;
+    if (purge) {
+        memset(storage, 0, size);
+        Test_Storage_Purge_Count++;
+    }
+}
+
+static void test_Trend_Log_Storage(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA pRequest = { 0 };
+    uint32_t object_instance = 0;
+    uint32_t total_records = 0;
+    uint32_t record_count = 0;
+    int log_index = 0;
+    int len = 0;
+    int test_len = 0;
+
+    zassert_true(Trend_Log_Count() <= TEST_STORAGE_LOGS, NULL);
+    Trend_Log_Cleanup();
+    Trend_Log_Storage_Callback_Set(
+        test_Trend_Log_Storage_Open, test_Trend_Log_Storage_Close);
+    /* new storage gets the test records */
+    Trend_Log_Init();
+    object_instance = Trend_Log_Index_To_Instance(0);
+    log_index = Trend_Log_Instance_To_Index(object_instance);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), TL_MAX_ENTRIES, NULL);
+    zassert_equal(
+        Trend_Log_Record_Count(object_instance), TL_MAX_ENTRIES, NULL);
+    TL_Insert_Status_Rec(log_index, LOG_STATUS_LOG_INTERRUPTED, true);
+    total_records = Trend_Log_Total_Record_Count(object_instance);
+    record_count = Trend_Log_Record_Count(object_instance);
+    pRequest.object_type = OBJECT_TRENDLOG;
+    pRequest.object_instance = object_instance;
+    pRequest.object_property = PROP_LOG_BUFFER;
+    pRequest.array_index = BACNET_ARRAY_ALL;
+    pRequest.RequestType = RR_BY_POSITION;
+    pRequest.Range.RefIndex = record_count;
+    pRequest.Count = -5;
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    /* the records are resumed after a restart */
+    Trend_Log_Cleanup();
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), 0, NULL);
+    Trend_Log_Init();
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), TL_MAX_ENTRIES, NULL);
+    zassert_equal(Trend_Log_Record_Count(object_instance), record_count, NULL);
+    zassert_equal(
+        Trend_Log_Total_Record_Count(object_instance), total_records, NULL);
+    pRequest.RequestType = RR_BY_POSITION;
+    pRequest.Range.RefIndex = record_count;
+    pRequest.Count = -5;
+    test_len = rr_trend_log_encode(test_apdu, &pRequest);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    /* a purged log gets new storage */
+    zassert_equal(Test_Storage_Purge_Count, 0, NULL);
+    zassert_true(Trend_Log_Buffer_Size_Set(object_instance, 100), NULL);
+    zassert_equal(Test_Storage_Purge_Count, 1, NULL);
+    zassert_equal(Trend_Log_Record_Count(object_instance), 1, NULL);
+    zassert_false(
+        Trend_Log_Buffer_Size_Set(object_instance, TL_MAX_ENTRIES + 1), NULL);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), 100, NULL);
+    Trend_Log_Cleanup();
+    Trend_Log_Init();
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), 100, NULL);
+    Trend_Log_Cleanup();
+    Trend_Log_Storage_Callback_Set(NULL, NULL);
+}
+
+/**
+ * @brief Check the readings that the trend log timer takes
+ * @param seconds - the time of the timer, in seconds since the epoch
+ * @param value_list_count - readings expected from value lists
+ * @param typed_count - readings expected from the typed reads
+ * @param read_property_count - readings expected with ReadProperty
+ */
+static void test_Trend_Log_Timer_Readings(
+    bacnet_time_t seconds,
+    unsigned value_list_count,
+    unsigned typed_count,
+    unsigned read_property_count)
+{
+    Test_Clock = seconds;
+    Test_Value_List_Count = 0;
+    Test_Typed_Count = 0;
+    Test_Read_Property_Count = 0;
+    trend_log_timer(1);
+    zassert_equal(Test_Value_List_Count, value_list_count, NULL);
+    zassert_equal(Test_Typed_Count, typed_count, NULL);
+    zassert_equal(Test_Read_Property_Count, read_property_count, NULL);
+}
+
+static void test_Trend_Log_Timer(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_READ_RANGE_DATA pRequest = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    bacnet_time_t start_time = 0;
+    uint32_t object_instance = 0;
+    uint32_t total_records = 0;
+    unsigned count = 0;
+    int len = 0;
+
+    Trend_Log_Init();
+    count = Trend_Log_Count() - 2;
+    object_instance = Trend_Log_Index_To_Instance(0);
+    /* on the quarter hour, within the start and stop times */
+    datetime_set_values(&bdatetime, 2015, 6, 1, 0, 0, 5, 0);
+    start_time = datetime_seconds_since_epoch(&bdatetime);
+    /* the last readings are long ago, so every log is due */
+    total_records = Trend_Log_Total_Record_Count(object_instance);
+    test_Trend_Log_Timer_Readings(start_time, count, 1, 1);
+    zassert_equal(
+        Trend_Log_Total_Record_Count(object_instance), total_records + 1,
+        NULL);
+    /* the newest record has the REAL value, and status flags with
+       OUT_OF_SERVICE set, of the object */
+    pRequest.object_type = OBJECT_TRENDLOG;
+    pRequest.object_instance = object_instance;
+    pRequest.object_property = PROP_LOG_BUFFER;
+    pRequest.array_index = BACNET_ARRAY_ALL;
+    pRequest.RequestType = RR_BY_POSITION;
+    pRequest.Range.RefIndex = Trend_Log_Record_Count(object_instance);
+    pRequest.Count = 1;
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_equal(pRequest.ItemCount, 1, NULL);
+    zassert_equal(len, 22, NULL);
+    zassert_equal(apdu[13], 0x2C, NULL);
+    zassert_equal(apdu[len - 1], 0x10, NULL);
+    /* the typed reads make the same record */
+    pRequest.object_instance =
+        Trend_Log_Index_To_Instance(TEST_TYPED_INSTANCE);
+    pRequest.Range.RefIndex =
+        Trend_Log_Record_Count(pRequest.object_instance);
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_equal(pRequest.ItemCount, 1, NULL);
+    zassert_equal(len, 22, NULL);
+    zassert_equal(apdu[13], 0x2C, NULL);
+    zassert_equal(apdu[len - 1], 0x10, NULL);
+    /* once a second, and then on the quarter hour */
+    test_Trend_Log_Timer_Readings(start_time, 0, 0, 0);
+    test_Trend_Log_Timer_Readings(start_time + 1, 0, 0, 0);
+    test_Trend_Log_Timer_Readings(start_time + 894, 0, 0, 0);
+    test_Trend_Log_Timer_Readings(start_time + 895, count, 1, 1);
+    test_Trend_Log_Timer_Readings(start_time + 896, 0, 0, 0);
+    /* one reading for a missed quarter hour */
+    test_Trend_Log_Timer_Readings(start_time + 2700 + 100, count, 1, 1);
+    test_Trend_Log_Timer_Readings(start_time + 3595, count, 1, 1);
+    /* the log read with ReadProperty, every minute */
+    object_instance = Trend_Log_Index_To_Instance(TEST_READ_PROPERTY_INSTANCE);
+    zassert_true(
+        test_Trend_Log_Write(
+            object_instance, PROP_ALIGN_INTERVALS, 0, true, &wp_data),
+        NULL);
+    zassert_true(
+        test_Trend_Log_Write(
+            object_instance, PROP_LOG_INTERVAL, 6000, false, &wp_data),
+        NULL);
+    test_Trend_Log_Timer_Readings(start_time + 3596, 0, 0, 0);
+    test_Trend_Log_Timer_Readings(start_time + 3595 + 59, 0, 0, 0);
+    test_Trend_Log_Timer_Readings(start_time + 3595 + 60, 0, 0, 1);
+    /* a trigger takes a reading at once */
+    zassert_true(
+        test_Trend_Log_Write(object_instance, PROP_TRIGGER, 1, true, &wp_data),
+        NULL);
+    test_Trend_Log_Timer_Readings(start_time + 3595 + 61, 0, 0, 1);
+    test_Trend_Log_Timer_Readings(start_time + 3595 + 62, 0, 0, 0);
+    test_Trend_Log_Timer_Readings(start_time + 3595 + 121, 0, 0, 1);
+    /* a disabled log takes no readings */
+    zassert_true(
+        test_Trend_Log_Write(object_instance, PROP_ENABLE, 0, true, &wp_data),
+        NULL);
+    test_Trend_Log_Timer_Readings(start_time + 3595 + 900, count, 1, 0);
+    zassert_true(
+        test_Trend_Log_Write(object_instance, PROP_ENABLE, 1, true, &wp_data),
+        NULL);
+    test_Trend_Log_Timer_Readings(start_time + 3595 + 901, 0, 0, 1);
+    /* the clock went back, so every log is due */
+    test_Trend_Log_Timer_Readings(start_time + 100, count, 1, 1);
+    test_Trend_Log_Timer_Readings(start_time + 101, 0, 0, 0);
+    Test_Clock = 0;
+}
+
+/**
+ * @brief Check that a compressed log reads the same records as a log
+ *  with slots, by position
+ * @param slot_instance - object instance of the log with slots
+ * @param slot_position - position of the first record in that log
+ * @param compressed_instance - object instance of the compressed log
+ * @param compressed_position - position of the first record in that log
+ * @param count - number of records to read
+ */
+static void test_Trend_Log_Compressed_Position(
+    uint32_t slot_instance,
+    uint32_t slot_position,
+    uint32_t compressed_instance,
+    uint32_t compressed_position,
+    int32_t count)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA pRequest = { 0 };
+    int len = 0;
+    int test_len = 0;
+
+    pRequest.object_type = OBJECT_TRENDLOG;
+    pRequest.object_property = PROP_LOG_BUFFER;
+    pRequest.array_index = BACNET_ARRAY_ALL;
+    pRequest.RequestType = RR_BY_POSITION;
+    pRequest.object_instance = slot_instance;
+    pRequest.Range.RefIndex = slot_position;
+    pRequest.Count = count;
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    pRequest.object_instance = compressed_instance;
+    pRequest.Range.RefIndex = compressed_position;
+    pRequest.Count = count;
+    test_len = rr_trend_log_encode(test_apdu, &pRequest);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+}
+
+/**
+ * @brief Check that a compressed log finds the same records as a log
+ *  with slots, by time
+ * @param slot_instance - object instance of the log with slots
+ * @param compressed_instance - object instance of the compressed log
+ * @param seconds - the reference time, in seconds since the epoch
+ * @param count - number of records to read
+ */
+static void test_Trend_Log_Compressed_Time(
+    uint32_t slot_instance,
+    uint32_t compressed_instance,
+    bacnet_time_t seconds,
+    int32_t count)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA pRequest = { 0 };
+    int len = 0;
+    int test_len = 0;
+
+    pRequest.object_type = OBJECT_TRENDLOG;
+    pRequest.object_property = PROP_LOG_BUFFER;
+    pRequest.array_index = BACNET_ARRAY_ALL;
+    pRequest.RequestType = RR_BY_TIME;
+    pRequest.object_instance = slot_instance;
+    datetime_since_epoch_seconds(&pRequest.Range.RefTime, seconds);
+    pRequest.Count = count;
+    len = rr_trend_log_encode(apdu, &pRequest);
+    pRequest.object_instance = compressed_instance;
+    pRequest.Count = count;
+    test_len = rr_trend_log_encode(test_apdu, &pRequest);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+}
+
+static void test_Trend_Log_Compressed(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA pRequest = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    bacnet_time_t start_time = 0;
+    uint32_t slot_instance = 0;
+    uint32_t compressed_instance = 0;
+    uint32_t record_count = 0;
+    uint32_t seed = 1;
+    int slot_index = 0;
+    int compressed_index = 0;
+    int len = 0;
+    int test_len = 0;
+    uint32_t i;
+
+    /* a slowly changing point takes a fraction of the slots */
+    zassert_true(
+        (TL_COMPRESSED_STORAGE_SIZE(TL_MAX_ENTRIES) * 5) <
+            TL_STORAGE_SIZE(TL_MAX_ENTRIES),
+        NULL);
+    Trend_Log_Init();
+    slot_instance = Trend_Log_Index_To_Instance(5);
+    slot_index = Trend_Log_Instance_To_Index(slot_instance);
+    compressed_instance = Trend_Log_Index_To_Instance(6);
+    compressed_index = Trend_Log_Instance_To_Index(compressed_instance);
+    datetime_set_values(&bdatetime, 2016, 3, 1, 0, 0, 0, 0);
+    start_time = datetime_seconds_since_epoch(&bdatetime);
+    Test_Clock = start_time;
+    zassert_false(Trend_Log_Compressed(compressed_instance), NULL);
+    zassert_true(Trend_Log_Compressed_Set(compressed_instance, true), NULL);
+    zassert_true(Trend_Log_Compressed(compressed_instance), NULL);
+    zassert_true(Trend_Log_Compressed_Set(compressed_instance, true), NULL);
+    zassert_equal(Trend_Log_Record_Count(compressed_instance), 1, NULL);
+    zassert_true(Trend_Log_Buffer_Size_Set(slot_instance, 50), NULL);
+    zassert_true(Trend_Log_Buffer_Size_Set(compressed_instance, 50), NULL);
+    zassert_equal(Trend_Log_Buffer_Size(compressed_instance), 50, NULL);
+    zassert_equal(Trend_Log_Record_Count(compressed_instance), 1, NULL);
+    /* readings on the quarter hour, with a status, a missed reading and
+       the clock going back now and then, so that the log wraps around */
+    Test_Present_Value = 20.0f;
+    for (i = 0; i < 200; i++) {
+        Test_Clock += 900;
+        if ((i % 37) == 0) {
+            TL_Insert_Status_Rec(slot_index, LOG_STATUS_LOG_INTERRUPTED, true);
+            TL_Insert_Status_Rec(
+                compressed_index, LOG_STATUS_LOG_INTERRUPTED, true);
+        }
+        if ((i % 41) == 0) {
+            Test_Clock += 900;
+        }
+        if ((i % 61) == 0) {
+            Test_Clock -= 3600;
+        }
+        Test_Present_Value += 0.25f;
+        trend_log_timer(1);
+    }
+    record_count = Trend_Log_Record_Count(slot_instance);
+    zassert_equal(record_count, 50, NULL);
+    zassert_equal(Trend_Log_Record_Count(compressed_instance), 50, NULL);
+    /* the records read the same, from any record and in any order */
+    test_Trend_Log_Compressed_Position(
+        slot_instance, 1, compressed_instance, 1, 50);
+    test_Trend_Log_Compressed_Position(
+        slot_instance, 50, compressed_instance, 50, -20);
+    test_Trend_Log_Compressed_Position(
+        slot_instance, 17, compressed_instance, 17, 3);
+    test_Trend_Log_Compressed_Position(
+        slot_instance, 2, compressed_instance, 2, 1);
+    test_Trend_Log_Compressed_Position(
+        slot_instance, 3, compressed_instance, 3, 1);
+    for (i = 0; i < 200; i += 15) {
+        test_Trend_Log_Compressed_Time(
+            slot_instance, compressed_instance, start_time + (i * 900), 10);
+        test_Trend_Log_Compressed_Time(
+            slot_instance, compressed_instance, start_time + (i * 900), -10);
+    }
+    /* and by sequence number, from the same oldest record */
+    pRequest.object_type = OBJECT_TRENDLOG;
+    pRequest.object_property = PROP_LOG_BUFFER;
+    pRequest.array_index = BACNET_ARRAY_ALL;
+    pRequest.RequestType = RR_BY_SEQUENCE;
+    pRequest.object_instance = slot_instance;
+    pRequest.Range.RefSeqNum = Trend_Log_Total_Record_Count(slot_instance) - 9;
+    pRequest.Count = 5;
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_true(len > 0, NULL);
+    pRequest.object_instance = compressed_instance;
+    pRequest.Range.RefSeqNum =
+        Trend_Log_Total_Record_Count(compressed_instance) - 9;
+    pRequest.Count = 5;
+    test_len = rr_trend_log_encode(test_apdu, &pRequest);
+    zassert_equal(len, test_len, NULL);
+    zassert_true(len > 5, NULL);
+    /* items after the sequence number, which differs between the logs */
+    zassert_equal(pRequest.ItemCount, 5, NULL);
+    /* values that change in every bit pack to fewer records than the
+       buffer size, and the newest records are kept */
+    zassert_true(Trend_Log_Buffer_Size_Set(slot_instance, 200), NULL);
+    zassert_true(Trend_Log_Buffer_Size_Set(compressed_instance, 200), NULL);
+    for (i = 0; i < 300; i++) {
+        Test_Clock += 900;
+        seed = (seed * 1103515245UL) + 12345UL;
+        Test_Present_Value = (float)(seed >> 8) / 1000.0f;
+        trend_log_timer(1);
+    }
+    zassert_equal(Trend_Log_Record_Count(slot_instance), 200, NULL);
+    record_count = Trend_Log_Record_Count(compressed_instance);
+    zassert_true(record_count > 0, NULL);
+    zassert_true(record_count < 200, NULL);
+    for (i = 1; i <= record_count; i++) {
+        test_Trend_Log_Compressed_Position(
+            slot_instance, 200 - record_count + i, compressed_instance, i, 1);
+    }
+    /* clearing the log leaves the purge record */
+    zassert_true(Trend_Log_Buffer_Size_Set(compressed_instance, 50), NULL);
+    zassert_equal(Trend_Log_Record_Count(compressed_instance), 1, NULL);
+    zassert_true(Trend_Log_Compressed_Set(compressed_instance, false), NULL);
+    zassert_false(Trend_Log_Compressed(compressed_instance), NULL);
+    zassert_equal(Trend_Log_Buffer_Size(compressed_instance), 50, NULL);
+    zassert_true(
+        Trend_Log_Buffer_Size_Set(compressed_instance, TL_MAX_ENTRIES), NULL);
+    zassert_true(
+        Trend_Log_Buffer_Size_Set(slot_instance, TL_MAX_ENTRIES), NULL);
+    /* the compressed records are resumed after a restart */
+    Trend_Log_Cleanup();
+    Trend_Log_Storage_Callback_Set(
+        test_Trend_Log_Storage_Open, test_Trend_Log_Storage_Close);
+    Trend_Log_Init();
+    zassert_true(Trend_Log_Compressed_Set(compressed_instance, true), NULL);
+    for (i = 0; i < 100; i++) {
+        Test_Clock += 900;
+        Test_Present_Value += 0.5f;
+        trend_log_timer(1);
+    }
+    record_count = Trend_Log_Record_Count(compressed_instance);
+    zassert_equal(record_count, 101, NULL);
+    pRequest.RequestType = RR_BY_POSITION;
+    pRequest.object_instance = compressed_instance;
+    pRequest.Range.RefIndex = record_count;
+    pRequest.Count = -10;
+    len = rr_trend_log_encode(apdu, &pRequest);
+    zassert_equal(pRequest.ItemCount, 10, NULL);
+    Trend_Log_Cleanup();
+    Trend_Log_Init();
+    zassert_true(Trend_Log_Compressed(compressed_instance), NULL);
+    zassert_equal(
+        Trend_Log_Record_Count(compressed_instance), record_count, NULL);
+    /* and the log carries on from the newest record */
+    TL_Insert_Status_Rec(compressed_index, LOG_STATUS_LOG_INTERRUPTED, true);
+    zassert_equal(
+        Trend_Log_Record_Count(compressed_instance), record_count + 1, NULL);
+    pRequest.Range.RefIndex = record_count;
+    pRequest.Count = -10;
+    test_len = rr_trend_log_encode(test_apdu, &pRequest);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    zassert_true(Trend_Log_Compressed_Set(compressed_instance, false), NULL);
+    Trend_Log_Cleanup();
+    Trend_Log_Storage_Callback_Set(NULL, NULL);
+    Test_Present_Value = 42.0f;
+    Test_Clock = 0;
+}
+/* the COV subscriptions sent for the logs with a remote source */
+static unsigned Test_COV_Subscribe_Count;
+static uint8_t Test_COV_Subscribe_Invoke_ID = 1;
+static uint32_t Test_COV_Subscribe_Device_ID;
+static BACNET_SUBSCRIBE_COV_DATA Test_COV_Subscribe_Data;
+
+static uint8_t test_Trend_Log_COV_Subscribe(
+    uint32_t device_id, const BACNET_SUBSCRIBE_COV_DATA *cov_data)
+{
+    Test_COV_Subscribe_Count++;
+    Test_COV_Subscribe_Device_ID = device_id;
+    Test_COV_Subscribe_Data = *cov_data;
+
+    return Test_COV_Subscribe_Invoke_ID;
+}
+
+/**
+ * @brief Write the Logging_Type of a log
+ * @param object_instance - object instance of the log
+ * @param logging_type - the Logging_Type
+ * @param wp_data - [out] the write request, with any error
+ * @return true if the write succeeded
+ */
+static bool test_Trend_Log_Logging_Type_Write(
+    uint32_t object_instance,
+    BACNET_LOGGING_TYPE logging_type,
+    BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    memset(wp_data, 0, sizeof(*wp_data));
+    wp_data->object_type = OBJECT_TRENDLOG;
+    wp_data->object_instance = object_instance;
+    wp_data->object_property = PROP_LOGGING_TYPE;
+    wp_data->array_index = BACNET_ARRAY_ALL;
+    wp_data->priority = BACNET_NO_PRIORITY;
+    wp_data->application_data_len =
+        encode_application_enumerated(wp_data->application_data, logging_type);
+
+    return Trend_Log_Write_Property(wp_data);
+}
+
+/**
+ * @brief Write the Log_DeviceObjectProperty of a log
+ * @param object_instance - object instance of the log
+ * @param device_instance - device instance of the source
+ * @param source_instance - object instance of the Analog Input source
+ * @param wp_data - [out] the write request, with any error
+ * @return true if the write succeeded
+ */
+static bool test_Trend_Log_Source_Write(
+    uint32_t object_instance,
+    uint32_t device_instance,
+    uint32_t source_instance,
+    BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE source = { 0 };
+
+    source.objectIdentifier.type = OBJECT_ANALOG_INPUT;
+    source.objectIdentifier.instance = source_instance;
+    source.propertyIdentifier = PROP_PRESENT_VALUE;
+    source.arrayIndex = BACNET_ARRAY_ALL;
+    source.deviceIdentifier.type = OBJECT_DEVICE;
+    source.deviceIdentifier.instance = device_instance;
+    memset(wp_data, 0, sizeof(*wp_data));
+    wp_data->object_type = OBJECT_TRENDLOG;
+    wp_data->object_instance = object_instance;
+    wp_data->object_property = PROP_LOG_DEVICE_OBJECT_PROPERTY;
+    wp_data->array_index = BACNET_ARRAY_ALL;
+    wp_data->priority = BACNET_NO_PRIORITY;
+    wp_data->application_data_len = bacapp_encode_device_obj_property_ref(
+        wp_data->application_data, &source);
+
+    return Trend_Log_Write_Property(wp_data);
+}
+
+static void test_Trend_Log_COV(void)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    BACNET_PROPERTY_VALUE value_list[2];
+    BACNET_COV_DATA cov_data = { 0 };
+    bacnet_time_t start_time = 0;
+    uint32_t local_instance = 0;
+    uint32_t remote_instance = 0;
+    uint32_t total_records = 0;
+    const uint32_t remote_device = 1234;
+
+    Trend_Log_Init();
+    local_instance = Trend_Log_Index_To_Instance(1);
+    remote_instance = Trend_Log_Index_To_Instance(2);
+    /* between the quarter hours, after the polled logs have their readings */
+    datetime_set_values(&bdatetime, 2016, 6, 1, 0, 1, 0, 0);
+    start_time = datetime_seconds_since_epoch(&bdatetime);
+    Test_Clock = start_time;
+    trend_log_timer(1);
+    test_Trend_Log_Timer_Readings(start_time + 1, 0, 0, 0);
+    /* a local source takes the first record when COV logging starts */
+    zassert_true(
+        test_Trend_Log_Logging_Type_Write(
+            local_instance, LOGGING_TYPE_COV, &wp_data),
+        NULL);
+    total_records = Trend_Log_Total_Record_Count(local_instance);
+    test_Trend_Log_Timer_Readings(start_time + 2, 1, 0, 0);
+    zassert_equal(
+        Trend_Log_Total_Record_Count(local_instance), total_records + 1, NULL);
+    test_Trend_Log_Timer_Readings(start_time + 3, 0, 0, 0);
+    /* and then one record for the changes of the object */
+    cov_change_of_value_notify(OBJECT_ANALOG_INPUT, 1);
+    cov_change_of_value_notify(OBJECT_ANALOG_INPUT, 1);
+    cov_change_of_value_notify(OBJECT_ANALOG_INPUT, 5);
+    cov_change_of_value_notify(OBJECT_BINARY_INPUT, 1);
+    test_Trend_Log_Timer_Readings(start_time + 4, 1, 0, 0);
+    test_Trend_Log_Timer_Readings(start_time + 5, 0, 0, 0);
+    /* no COV logging of a remote source without a subscription callback */
+    zassert_true(
+        test_Trend_Log_Logging_Type_Write(
+            remote_instance, LOGGING_TYPE_COV, &wp_data),
+        NULL);
+    zassert_false(
+        test_Trend_Log_Source_Write(
+            remote_instance, remote_device, 7, &wp_data),
+        NULL);
+    zassert_equal(
+        wp_data.error_code, ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED,
+        NULL);
+    Trend_Log_COV_Subscribe_Callback_Set(test_Trend_Log_COV_Subscribe);
+    zassert_true(
+        test_Trend_Log_Source_Write(
+            remote_instance, remote_device, 7, &wp_data),
+        NULL);
+    /* only COV logging of a remote source */
+    zassert_false(
+        test_Trend_Log_Logging_Type_Write(
+            remote_instance, LOGGING_TYPE_POLLED, &wp_data),
+        NULL);
+    /* the remote source is subscribed to, and not read */
+    Test_COV_Subscribe_Count = 0;
+    test_Trend_Log_Timer_Readings(start_time + 6, 0, 0, 0);
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    zassert_equal(Test_COV_Subscribe_Device_ID, remote_device, NULL);
+    zassert_equal(
+        Test_COV_Subscribe_Data.subscriberProcessIdentifier, remote_instance,
+        NULL);
+    zassert_equal(
+        Test_COV_Subscribe_Data.monitoredObjectIdentifier.type,
+        OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(
+        Test_COV_Subscribe_Data.monitoredObjectIdentifier.instance, 7, NULL);
+    zassert_false(Test_COV_Subscribe_Data.cancellationRequest, NULL);
+    zassert_false(Test_COV_Subscribe_Data.covSubscribeToProperty, NULL);
+    zassert_equal(Test_COV_Subscribe_Data.lifetime, 7200, NULL);
+    test_Trend_Log_Timer_Readings(start_time + 7, 0, 0, 0);
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    /* the notifications of the remote source are recorded */
+    bacapp_property_value_list_init(value_list, 2);
+    value_list[0].propertyIdentifier = PROP_PRESENT_VALUE;
+    value_list[0].value.tag = BACNET_APPLICATION_TAG_REAL;
+    value_list[0].value.type.Real = 7.5f;
+    value_list[1].propertyIdentifier = PROP_STATUS_FLAGS;
+    value_list[1].value.tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value_list[1].value.type.Bit_String);
+    cov_data.subscriberProcessIdentifier = remote_instance;
+    cov_data.initiatingDeviceIdentifier = remote_device;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    cov_data.monitoredObjectIdentifier.instance = 7;
+    cov_data.listOfValues = value_list;
+    total_records = Trend_Log_Total_Record_Count(remote_instance);
+    Trend_Log_COV_Notification(&cov_data);
+    zassert_equal(
+        Trend_Log_Total_Record_Count(remote_instance), total_records + 1,
+        NULL);
+    cov_data.subscriberProcessIdentifier = local_instance;
+    Trend_Log_COV_Notification(&cov_data);
+    Trend_Log_COV_Notification(NULL);
+    zassert_equal(
+        Trend_Log_Total_Record_Count(remote_instance), total_records + 1,
+        NULL);
+    /* subscribed again by the resubscription interval, while the
+       polled logs take their readings on the hour */
+    Test_Clock = start_time + 6 + 3599;
+    trend_log_timer(1);
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    Test_Clock = start_time + 6 + 3600;
+    trend_log_timer(1);
+    zassert_equal(Test_COV_Subscribe_Count, 2, NULL);
+    /* a subscription that was not sent is tried again */
+    zassert_true(
+        test_Trend_Log_Write(
+            remote_instance, PROP_COV_RESUBSCRIPTION_INTERVAL, 60, false,
+            &wp_data),
+        NULL);
+    Test_COV_Subscribe_Invoke_ID = 0;
+    start_time += 3606;
+    test_Trend_Log_Timer_Readings(start_time + 1, 0, 0, 0);
+    zassert_equal(Test_COV_Subscribe_Count, 3, NULL);
+    Test_COV_Subscribe_Invoke_ID = 1;
+    test_Trend_Log_Timer_Readings(start_time + 10, 0, 0, 0);
+    zassert_equal(Test_COV_Subscribe_Count, 3, NULL);
+    test_Trend_Log_Timer_Readings(start_time + 11, 0, 0, 0);
+    zassert_equal(Test_COV_Subscribe_Count, 4, NULL);
+    zassert_equal(Test_COV_Subscribe_Data.lifetime, 120, NULL);
+    /* the source is no longer remote, so the subscription is cancelled */
+    zassert_true(
+        test_Trend_Log_Source_Write(remote_instance, 0, 2, &wp_data), NULL);
+    zassert_equal(Test_COV_Subscribe_Count, 5, NULL);
+    zassert_true(Test_COV_Subscribe_Data.cancellationRequest, NULL);
+    test_Trend_Log_Timer_Readings(start_time + 12, 1, 0, 0);
+    zassert_equal(Test_COV_Subscribe_Count, 5, NULL);
+    /* back to polling */
+    zassert_true(
+        test_Trend_Log_Logging_Type_Write(
+            remote_instance, LOGGING_TYPE_POLLED, &wp_data),
+        NULL);
+    zassert_true(
+        test_Trend_Log_Logging_Type_Write(
+            local_instance, LOGGING_TYPE_POLLED, &wp_data),
+        NULL);
+    Trend_Log_COV_Subscribe_Callback_Set(NULL);
+    Test_Clock = 0;
+}
 /**
  * @}
  */
@@ -148,7 +1197,13 @@ void test_main(void)
 {
     ztest_test_suite(
         trendlog_tests, ztest_unit_test(test_Trend_Log_ReadProperty),
-        ztest_unit_test(test_Trend_Log_ReadRange_BySequence));
+        ztest_unit_test(test_Trend_Log_ReadRange_BySequence),
+        ztest_unit_test(test_Trend_Log_ReadRange_ByTime),
+        ztest_unit_test(test_Trend_Log_Buffer_Size),
+        ztest_unit_test(test_Trend_Log_Storage),
+        ztest_unit_test(test_Trend_Log_Timer),
+        ztest_unit_test(test_Trend_Log_COV),
+        ztest_unit_test(test_Trend_Log_Compressed));
 
     ztest_run_test_suite(trendlog_tests);
 }
@@ -0,0 +1,769 @@
+/**
+ * @file
+ * @brief Unit test for the Trend Log Multiple object
+ * @date 2026
+ *
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/object/trendlog_multiple.h>
+#include <property_test.h>
+
+/* the Analog Input object that is read with ReadProperty */
+#define TEST_READ_PROPERTY_INSTANCE 3
+/* the Analog Input object that has typed reads */
+#define TEST_TYPED_INSTANCE 4
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the clock of the device, in seconds since the epoch */
+static bacnet_time_t Test_Clock;
+/* the value of the objects that are logged */
+static float Test_Present_Value = 42.0f;
+static unsigned Test_Read_Property_Count;
+static unsigned Test_Typed_Count;
+
+bool Device_Valid_Object_Name(
+    const BACNET_CHARACTER_STRING *object_name,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *object_instance)
+{
+    (void)object_name;
+    (void)object_type;
+    (void)object_instance;
+    return true;
+}
+
+void Device_Inc_Database_Revision(void)
+{
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 0;
+}
+
+bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    (void)wp_data;
+    return false;
+}
+
+void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
+{
+    datetime_since_epoch_seconds(DateTime, Test_Clock);
+}
+
+/* one Analog Input object is read with ReadProperty */
+int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    if ((rpdata->object_type != OBJECT_ANALOG_INPUT) ||
+        (rpdata->object_instance != TEST_READ_PROPERTY_INSTANCE)) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return BACNET_STATUS_ERROR;
+    }
+    Test_Read_Property_Count++;
+
+    return encode_application_real(
+        rpdata->application_data, Test_Present_Value);
+}
+
+/* one Analog Input object has the typed reads */
+bool Device_Status_Flags(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_BIT_STRING *status_flags)
+{
+    if ((object_type != OBJECT_ANALOG_INPUT) ||
+        (object_instance != TEST_TYPED_INSTANCE)) {
+        return false;
+    }
+    bitstring_init(status_flags);
+    bitstring_set_bit(status_flags, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(status_flags, STATUS_FLAG_FAULT, false);
+    bitstring_set_bit(status_flags, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(status_flags, STATUS_FLAG_OUT_OF_SERVICE, true);
+
+    return true;
+}
+
+bool Device_Present_Value_Real(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, float *value)
+{
+    if ((object_type != OBJECT_ANALOG_INPUT) ||
+        (object_instance != TEST_TYPED_INSTANCE)) {
+        return false;
+    }
+    *value = Test_Present_Value;
+    Test_Typed_Count++;
+
+    return true;
+}
+
+bool Device_Present_Value_Enumerated(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, uint32_t *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
+bool Device_Present_Value_Unsigned(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_UNSIGNED_INTEGER *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
+bool Device_Present_Value_Boolean(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool *value)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value;
+    return false;
+}
+
+/**
+ * @brief Set a member of a Trend Log Multiple to a local object property
+ * @param object_instance - trend log multiple instance
+ * @param index - 0 based member index
+ * @param object_type - type of the logged object
+ * @param instance - instance of the logged object
+ * @param property - logged property
+ */
+static void test_Trend_Log_Multiple_Member_Object_Set(
+    uint32_t object_instance,
+    unsigned index,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t instance,
+    BACNET_PROPERTY_ID property)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+
+    member.objectIdentifier.type = object_type;
+    member.objectIdentifier.instance = instance;
+    member.propertyIdentifier = property;
+    member.arrayIndex = BACNET_ARRAY_ALL;
+    member.deviceIdentifier.type = BACNET_NO_DEV_TYPE;
+    member.deviceIdentifier.instance = BACNET_NO_DEV_ID;
+    zassert_true(
+        Trend_Log_Multiple_Member_Set(object_instance, index, &member), NULL);
+}
+
+/**
+ * @brief Set up a ReadRange request of a trend log multiple
+ * @param pRequest - request to set up
+ * @param object_instance - trend log multiple instance
+ * @param apdu - buffer for the response
+ * @param apdu_size - size of the buffer
+ */
+static void test_Trend_Log_Multiple_Request(
+    BACNET_READ_RANGE_DATA *pRequest,
+    uint32_t object_instance,
+    uint8_t *apdu,
+    size_t apdu_size)
+{
+    memset(pRequest, 0, sizeof(*pRequest));
+    pRequest->object_type = OBJECT_TREND_LOG_MULTIPLE;
+    pRequest->object_instance = object_instance;
+    pRequest->object_property = PROP_LOG_BUFFER;
+    pRequest->array_index = BACNET_ARRAY_ALL;
+    pRequest->application_data = apdu;
+    pRequest->application_data_len = apdu_size;
+    pRequest->Overhead = 0;
+}
+
+/**
+ * @brief Decode the start of a BACnetLogMultipleRecord
+ * @param apdu - the encoded record
+ * @param apdu_size - size of the encoded data
+ * @param seconds - [out] time stamp of the record
+ * @param choice - [out] the choice of log-data
+ * @return number of bytes decoded up to the log-data choice
+ */
+static int test_Trend_Log_Multiple_Record_Start(
+    const uint8_t *apdu,
+    size_t apdu_size,
+    bacnet_time_t *seconds,
+    uint8_t *choice)
+{
+    BACNET_DATE_TIME timestamp = { 0 };
+    int apdu_len = 0, len = 0;
+
+    len = bacnet_datetime_context_decode(apdu, apdu_size, 0, &timestamp);
+    zassert_true(len > 0, NULL);
+    apdu_len += len;
+    *seconds = datetime_seconds_since_epoch(&timestamp);
+    zassert_true(
+        bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &len),
+        NULL);
+    apdu_len += len;
+    len = bacnet_tag_number_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, choice);
+    zassert_true(len > 0, NULL);
+
+    return apdu_len;
+}
+
+static void test_Trend_Log_Multiple_ReadProperty(void)
+{
+    unsigned count = 0;
+    uint32_t object_instance = 0;
+    bool status = false;
+    const int32_t known_fail_property_list[] = { -1 };
+
+    Trend_Log_Multiple_Init();
+    object_instance = Trend_Log_Multiple_Create(1);
+    zassert_equal(object_instance, 1, NULL);
+    count = Trend_Log_Multiple_Count();
+    zassert_equal(count, 1, NULL);
+    zassert_equal(Trend_Log_Multiple_Index_To_Instance(0), 1, NULL);
+    zassert_equal(Trend_Log_Multiple_Instance_To_Index(1), 0, NULL);
+    status = Trend_Log_Multiple_Valid_Instance(object_instance);
+    zassert_true(status, NULL);
+    zassert_true(Trend_Log_Multiple_Member_Count_Set(object_instance, 2), NULL);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 0, OBJECT_ANALOG_INPUT, TEST_TYPED_INSTANCE,
+        PROP_PRESENT_VALUE);
+    bacnet_object_properties_read_write_test(
+        OBJECT_TREND_LOG_MULTIPLE, object_instance,
+        Trend_Log_Multiple_Property_Lists, Trend_Log_Multiple_Read_Property,
+        Trend_Log_Multiple_Write_Property, known_fail_property_list);
+    bacnet_object_name_ascii_test(
+        object_instance, Trend_Log_Multiple_Name_Set,
+        Trend_Log_Multiple_Name_ASCII);
+    /* a wildcard instance is the next free instance */
+    zassert_equal(
+        Trend_Log_Multiple_Create(BACNET_MAX_INSTANCE), 2, NULL);
+    zassert_true(Trend_Log_Multiple_Delete(2), NULL);
+    zassert_false(Trend_Log_Multiple_Delete(2), NULL);
+    zassert_true(Trend_Log_Multiple_Delete(object_instance), NULL);
+    zassert_equal(Trend_Log_Multiple_Count(), 0, NULL);
+    Trend_Log_Multiple_Cleanup();
+}
+
+static void test_Trend_Log_Multiple_Sample(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    BACNET_BIT_STRING bit_string = { 0 };
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+    const uint32_t object_instance = 1;
+    const bacnet_time_t start_time = 1000000;
+    bacnet_time_t seconds = 0;
+    uint32_t error_class = 0, error_code = 0;
+    uint8_t choice = 0;
+    float real_value = 0.0f;
+    int apdu_len = 0, len = 0, tag_len = 0;
+
+    Trend_Log_Multiple_Init();
+    zassert_equal(Trend_Log_Multiple_Create(object_instance), 1, NULL);
+    Test_Clock = start_time;
+    /* a member for each way that a member is sampled */
+    zassert_true(Trend_Log_Multiple_Member_Count_Set(object_instance, 5), NULL);
+    zassert_equal(Trend_Log_Multiple_Member_Count(object_instance), 5, NULL);
+    /* the purge of the buffer when the members change is recorded */
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 1, NULL);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 0, OBJECT_ANALOG_INPUT, TEST_TYPED_INSTANCE,
+        PROP_PRESENT_VALUE);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 1, OBJECT_ANALOG_INPUT, TEST_TYPED_INSTANCE,
+        PROP_STATUS_FLAGS);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 2, OBJECT_ANALOG_INPUT, TEST_READ_PROPERTY_INSTANCE,
+        PROP_PRESENT_VALUE);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 3, OBJECT_ANALOG_INPUT, 99, PROP_PRESENT_VALUE);
+    /* the last member references no object */
+    zassert_true(
+        Trend_Log_Multiple_Member(object_instance, 4, &member), NULL);
+    zassert_equal(
+        member.objectIdentifier.instance, BACNET_MAX_INSTANCE, NULL);
+    zassert_false(
+        Trend_Log_Multiple_Member(object_instance, 5, &member), NULL);
+    /* writing the members again without change does not purge */
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 0, OBJECT_ANALOG_INPUT, TEST_TYPED_INSTANCE,
+        PROP_PRESENT_VALUE);
+    zassert_equal(
+        Trend_Log_Multiple_Total_Record_Count(object_instance), 5, NULL);
+    /* a disabled log is not sampled */
+    Trend_Log_Multiple_Sample(object_instance);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 1, NULL);
+    zassert_true(Trend_Log_Multiple_Enable_Set(object_instance, true), NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 2, NULL);
+    Test_Typed_Count = 0;
+    Test_Read_Property_Count = 0;
+    Test_Clock = start_time + 10;
+    Trend_Log_Multiple_Sample(object_instance);
+    /* one record in one pass across all the members */
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 3, NULL);
+    zassert_equal(Trend_Log_Multiple_Total_Record_Count(object_instance), 7,
+        NULL);
+    zassert_equal(Test_Typed_Count, 1, NULL);
+    zassert_equal(Test_Read_Property_Count, 1, NULL);
+    /* read the last record, and walk its member data */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_POSITION;
+    request.Range.RefIndex = 3;
+    request.Count = 1;
+    apdu_len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(apdu_len > 0, NULL);
+    zassert_equal(request.ItemCount, 1, NULL);
+    zassert_equal(request.FirstSequence, 7, NULL);
+    len = test_Trend_Log_Multiple_Record_Start(
+        apdu, apdu_len, &seconds, &choice);
+    zassert_equal(seconds, start_time + 10, NULL);
+    zassert_equal(choice, 1, NULL);
+    zassert_true(
+        bacnet_is_opening_tag_number(
+            &apdu[len], apdu_len - len, 1, &tag_len),
+        NULL);
+    len += tag_len;
+    /* the typed present-value */
+    len += bacnet_real_context_decode(
+        &apdu[len], apdu_len - len, 1, &real_value);
+    zassert_false(islessgreater(real_value, Test_Present_Value), NULL);
+    /* the typed status-flags */
+    len += bacnet_bitstring_context_decode(
+        &apdu[len], apdu_len - len, 5, &bit_string);
+    zassert_true(
+        bitstring_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE), NULL);
+    zassert_false(bitstring_bit(&bit_string, STATUS_FLAG_FAULT), NULL);
+    /* the present-value read with ReadProperty */
+    real_value = 0.0f;
+    len += bacnet_real_context_decode(
+        &apdu[len], apdu_len - len, 1, &real_value);
+    zassert_false(islessgreater(real_value, Test_Present_Value), NULL);
+    /* the unknown object is a failure */
+    zassert_true(
+        bacnet_is_opening_tag_number(&apdu[len], apdu_len - len, 7, NULL),
+        NULL);
+    len++;
+    len += bacnet_enumerated_application_decode(
+        &apdu[len], apdu_len - len, &error_class);
+    len += bacnet_enumerated_application_decode(
+        &apdu[len], apdu_len - len, &error_code);
+    zassert_equal(error_class, ERROR_CLASS_OBJECT, NULL);
+    zassert_equal(error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    zassert_true(
+        bacnet_is_closing_tag_number(&apdu[len], apdu_len - len, 7, NULL),
+        NULL);
+    len++;
+    /* the empty member is a null-value */
+    zassert_equal(
+        bacnet_null_context_decode(&apdu[len], apdu_len - len, 6), 1, NULL);
+    len++;
+    zassert_true(
+        bacnet_is_closing_tag_number(&apdu[len], apdu_len - len, 1, NULL),
+        NULL);
+    len++;
+    zassert_true(
+        bacnet_is_closing_tag_number(&apdu[len], apdu_len - len, 1, NULL),
+        NULL);
+    /* the first record is the log-status of the purge */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_POSITION;
+    request.Range.RefIndex = 1;
+    request.Count = 1;
+    apdu_len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(apdu_len > 0, NULL);
+    len = test_Trend_Log_Multiple_Record_Start(
+        apdu, apdu_len, &seconds, &choice);
+    zassert_equal(choice, 0, NULL);
+    zassert_true(
+        bacnet_bitstring_context_decode(
+            &apdu[len], apdu_len - len, 0, &bit_string) > 0,
+        NULL);
+    zassert_true(bitstring_bit(&bit_string, LOG_STATUS_BUFFER_PURGED), NULL);
+    /* clear the log */
+    zassert_true(Trend_Log_Multiple_Enable_Set(object_instance, false), NULL);
+    zassert_true(
+        Trend_Log_Multiple_Buffer_Size_Set(object_instance, 10), NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 0, NULL);
+    zassert_equal(Trend_Log_Multiple_Buffer_Size(object_instance), 10, NULL);
+    zassert_equal(Trend_Log_Multiple_Member_Count(object_instance), 5, NULL);
+    Trend_Log_Multiple_Cleanup();
+    Test_Clock = 0;
+}
+
+static void test_Trend_Log_Multiple_ReadRange(void)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    BACNET_DATE_TIME ref_time = { 0 };
+    const uint32_t object_instance = 1;
+    const bacnet_time_t start_time = 1000000;
+    bacnet_time_t seconds = 0;
+    uint8_t choice = 0;
+    uint32_t i;
+    int len = 0;
+
+    Trend_Log_Multiple_Init();
+    zassert_equal(Trend_Log_Multiple_Create(object_instance), 1, NULL);
+    zassert_true(
+        Trend_Log_Multiple_Buffer_Size_Set(object_instance, 20), NULL);
+    Test_Clock = start_time;
+    zassert_true(Trend_Log_Multiple_Member_Count_Set(object_instance, 2), NULL);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 0, OBJECT_ANALOG_INPUT, TEST_TYPED_INSTANCE,
+        PROP_PRESENT_VALUE);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 1, OBJECT_ANALOG_INPUT, TEST_READ_PROPERTY_INSTANCE,
+        PROP_PRESENT_VALUE);
+    zassert_true(Trend_Log_Multiple_Enable_Set(object_instance, true), NULL);
+    /* wrap around the log buffer, one record each second */
+    for (i = 0; i < 30; i++) {
+        Test_Clock = start_time + 1 + i;
+        Trend_Log_Multiple_Sample(object_instance);
+    }
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 20, NULL);
+    zassert_equal(
+        Trend_Log_Multiple_Total_Record_Count(object_instance), 34, NULL);
+    /* by position: all */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_READ_ALL;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 20, NULL);
+    zassert_equal(request.FirstSequence, 15, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    /* the oldest record is the 11th sample, at the oldest time */
+    test_Trend_Log_Multiple_Record_Start(apdu, len, &seconds, &choice);
+    zassert_equal(seconds, start_time + 11, NULL);
+    zassert_equal(choice, 1, NULL);
+    /* by position: backwards from the end */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_POSITION;
+    request.Range.RefIndex = 20;
+    request.Count = -5;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_equal(request.FirstSequence, 30, NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    /* by position: past the end */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_POSITION;
+    request.Range.RefIndex = 21;
+    request.Count = 1;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_equal(len, 0, NULL);
+    zassert_equal(request.ItemCount, 0, NULL);
+    /* by sequence: the request is truncated to the log buffer */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_SEQUENCE;
+    request.Range.RefSeqNum = 10;
+    request.Count = 10;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_equal(request.FirstSequence, 15, NULL);
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_SEQUENCE;
+    request.Range.RefSeqNum = 30;
+    request.Count = -3;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_equal(request.FirstSequence, 28, NULL);
+    /* by sequence: no overlap */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_SEQUENCE;
+    request.Range.RefSeqNum = 35;
+    request.Count = 3;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_equal(len, 0, NULL);
+    /* by time: records after the reference time */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    datetime_since_epoch_seconds(&ref_time, start_time + 25);
+    request.Range.RefTime = ref_time;
+    request.Count = 3;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_equal(request.FirstSequence, 30, NULL);
+    test_Trend_Log_Multiple_Record_Start(apdu, len, &seconds, &choice);
+    zassert_equal(seconds, start_time + 26, NULL);
+    /* by time: records before the reference time */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    request.Range.RefTime = ref_time;
+    request.Count = -3;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_equal(request.FirstSequence, 26, NULL);
+    test_Trend_Log_Multiple_Record_Start(apdu, len, &seconds, &choice);
+    zassert_equal(seconds, start_time + 22, NULL);
+    /* by time: nothing after the newest record */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, sizeof(apdu));
+    request.RequestType = RR_BY_TIME;
+    datetime_since_epoch_seconds(&request.Range.RefTime, start_time + 30);
+    request.Count = 3;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_equal(len, 0, NULL);
+    /* a small response is truncated, with more items */
+    test_Trend_Log_Multiple_Request(
+        &request, object_instance, apdu, 64);
+    request.RequestType = RR_READ_ALL;
+    len = Trend_Log_Multiple_Read_Range(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_true(len <= 64, NULL);
+    zassert_true(request.ItemCount < 20, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    Trend_Log_Multiple_Cleanup();
+    Test_Clock = 0;
+}
+
+static void test_Trend_Log_Multiple_Stop_When_Full(void)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    const uint32_t object_instance = 1;
+    uint32_t i;
+
+    Trend_Log_Multiple_Init();
+    zassert_equal(Trend_Log_Multiple_Create(object_instance), 1, NULL);
+    zassert_true(
+        Trend_Log_Multiple_Buffer_Size_Set(object_instance, 10), NULL);
+    zassert_true(Trend_Log_Multiple_Member_Count_Set(object_instance, 1), NULL);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 0, OBJECT_ANALOG_INPUT, TEST_TYPED_INSTANCE,
+        PROP_PRESENT_VALUE);
+    zassert_true(
+        Trend_Log_Multiple_Stop_When_Full_Set(object_instance, true), NULL);
+    zassert_true(Trend_Log_Multiple_Enable_Set(object_instance, true), NULL);
+    for (i = 0; i < 20; i++) {
+        Trend_Log_Multiple_Sample(object_instance);
+    }
+    /* the last record is the log-status of the log disabling itself */
+    zassert_false(Trend_Log_Multiple_Enable(object_instance), NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 10, NULL);
+    zassert_equal(
+        Trend_Log_Multiple_Total_Record_Count(object_instance), 11, NULL);
+    /* a full log cannot be enabled */
+    wp_data.object_type = OBJECT_TREND_LOG_MULTIPLE;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = PROP_ENABLE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.application_data_len =
+        encode_application_boolean(wp_data.application_data, true);
+    zassert_false(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(wp_data.error_class, ERROR_CLASS_OBJECT, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_LOG_BUFFER_FULL, NULL);
+    /* until the log is cleared */
+    wp_data.object_property = PROP_RECORD_COUNT;
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 1);
+    zassert_false(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 0);
+    zassert_true(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 1, NULL);
+    wp_data.object_property = PROP_ENABLE;
+    wp_data.application_data_len =
+        encode_application_boolean(wp_data.application_data, true);
+    zassert_true(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_true(Trend_Log_Multiple_Enable(object_instance), NULL);
+    /* the buffer cannot be resized while the log is enabled */
+    wp_data.object_property = PROP_BUFFER_SIZE;
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 100);
+    zassert_false(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    /* COV logging is not supported */
+    wp_data.object_property = PROP_LOGGING_TYPE;
+    wp_data.application_data_len = encode_application_enumerated(
+        wp_data.application_data, LOGGING_TYPE_COV);
+    zassert_false(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_VALUE_OUT_OF_RANGE, NULL);
+    Trend_Log_Multiple_Cleanup();
+}
+
+static void test_Trend_Log_Multiple_Members_Write(void)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+    const uint32_t object_instance = 1;
+    int len = 0;
+
+    Trend_Log_Multiple_Init();
+    zassert_equal(Trend_Log_Multiple_Create(object_instance), 1, NULL);
+    member.objectIdentifier.type = OBJECT_ANALOG_INPUT;
+    member.objectIdentifier.instance = TEST_TYPED_INSTANCE;
+    member.propertyIdentifier = PROP_PRESENT_VALUE;
+    member.arrayIndex = BACNET_ARRAY_ALL;
+    member.deviceIdentifier.type = BACNET_NO_DEV_TYPE;
+    member.deviceIdentifier.instance = BACNET_NO_DEV_ID;
+    wp_data.object_type = OBJECT_TREND_LOG_MULTIPLE;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = PROP_LOG_DEVICE_OBJECT_PROPERTY;
+    /* the whole array */
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    len = bacapp_encode_device_obj_property_ref(
+        wp_data.application_data, &member);
+    member.objectIdentifier.instance = TEST_READ_PROPERTY_INSTANCE;
+    len += bacapp_encode_device_obj_property_ref(
+        &wp_data.application_data[len], &member);
+    wp_data.application_data_len = len;
+    zassert_true(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(Trend_Log_Multiple_Member_Count(object_instance), 2, NULL);
+    zassert_true(
+        Trend_Log_Multiple_Member(object_instance, 1, &member), NULL);
+    zassert_equal(
+        member.objectIdentifier.instance, TEST_READ_PROPERTY_INSTANCE, NULL);
+    /* the size of the array */
+    wp_data.array_index = 0;
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 3);
+    zassert_true(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(Trend_Log_Multiple_Member_Count(object_instance), 3, NULL);
+    wp_data.application_data_len = encode_application_unsigned(
+        wp_data.application_data, BACNET_TREND_LOG_MULTIPLE_MEMBERS_MAX + 1);
+    zassert_false(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(
+        wp_data.error_code, ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY, NULL);
+    /* one element of the array */
+    wp_data.array_index = 3;
+    member.objectIdentifier.instance = 7;
+    wp_data.application_data_len = bacapp_encode_device_obj_property_ref(
+        wp_data.application_data, &member);
+    zassert_true(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_true(
+        Trend_Log_Multiple_Member(object_instance, 2, &member), NULL);
+    zassert_equal(member.objectIdentifier.instance, 7, NULL);
+    wp_data.array_index = 4;
+    zassert_false(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_INVALID_ARRAY_INDEX, NULL);
+    /* an object in another device is not logged */
+    wp_data.array_index = 1;
+    member.deviceIdentifier.type = OBJECT_DEVICE;
+    member.deviceIdentifier.instance = 1234;
+    wp_data.application_data_len = bacapp_encode_device_obj_property_ref(
+        wp_data.application_data, &member);
+    zassert_false(Trend_Log_Multiple_Write_Property(&wp_data), NULL);
+    zassert_equal(
+        wp_data.error_code, ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED,
+        NULL);
+    Trend_Log_Multiple_Cleanup();
+}
+
+static void test_Trend_Log_Multiple_Timer(void)
+{
+    const uint32_t object_instance = 1;
+    const bacnet_time_t start_time = 1000003;
+    bacnet_time_t i;
+
+    Trend_Log_Multiple_Init();
+    zassert_equal(Trend_Log_Multiple_Create(object_instance), 1, NULL);
+    zassert_true(Trend_Log_Multiple_Member_Count_Set(object_instance, 1), NULL);
+    test_Trend_Log_Multiple_Member_Object_Set(
+        object_instance, 0, OBJECT_ANALOG_INPUT, TEST_TYPED_INSTANCE,
+        PROP_PRESENT_VALUE);
+    zassert_true(
+        Trend_Log_Multiple_Log_Interval_Set(object_instance, 10), NULL);
+    Test_Clock = start_time;
+    zassert_true(Trend_Log_Multiple_Enable_Set(object_instance, true), NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 2, NULL);
+    /* a polled log samples once per interval, starting now */
+    Test_Typed_Count = 0;
+    for (i = 0; i < 30; i++) {
+        Test_Clock = start_time + i;
+        Trend_Log_Multiple_Timer(object_instance, 1000);
+    }
+    zassert_equal(Test_Typed_Count, 3, NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 5, NULL);
+    /* aligned samples are at the interval boundaries, plus the offset */
+    zassert_true(
+        Trend_Log_Multiple_Align_Intervals_Set(object_instance, true), NULL);
+    zassert_true(
+        Trend_Log_Multiple_Interval_Offset_Set(object_instance, 2), NULL);
+    Test_Typed_Count = 0;
+    for (i = 0; i < 30; i++) {
+        Test_Clock = start_time + 30 + i;
+        Trend_Log_Multiple_Timer(object_instance, 1000);
+        if (Test_Typed_Count == 1) {
+            break;
+        }
+    }
+    zassert_equal(Test_Clock % 10, 2, NULL);
+    /* a triggered log samples when triggered */
+    zassert_true(
+        Trend_Log_Multiple_Logging_Type_Set(
+            object_instance, LOGGING_TYPE_TRIGGERED),
+        NULL);
+    zassert_false(
+        Trend_Log_Multiple_Logging_Type_Set(object_instance, LOGGING_TYPE_COV),
+        NULL);
+    Test_Typed_Count = 0;
+    for (i = 0; i < 30; i++) {
+        Test_Clock = start_time + 60 + i;
+        Trend_Log_Multiple_Timer(object_instance, 1000);
+    }
+    zassert_equal(Test_Typed_Count, 0, NULL);
+    zassert_true(Trend_Log_Multiple_Trigger_Set(object_instance, true), NULL);
+    Trend_Log_Multiple_Timer(object_instance, 1000);
+    zassert_equal(Test_Typed_Count, 1, NULL);
+    zassert_false(Trend_Log_Multiple_Trigger(object_instance), NULL);
+    /* a disabled log is not triggered */
+    zassert_true(Trend_Log_Multiple_Enable_Set(object_instance, false), NULL);
+    zassert_true(Trend_Log_Multiple_Trigger_Set(object_instance, true), NULL);
+    Trend_Log_Multiple_Timer(object_instance, 1000);
+    zassert_equal(Test_Typed_Count, 1, NULL);
+    Trend_Log_Multiple_Cleanup();
+    Test_Clock = 0;
+}
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+    ztest_test_suite(
+        trendlog_multiple_tests,
+        ztest_unit_test(test_Trend_Log_Multiple_ReadProperty),
+        ztest_unit_test(test_Trend_Log_Multiple_Sample),
+        ztest_unit_test(test_Trend_Log_Multiple_ReadRange),
+        ztest_unit_test(test_Trend_Log_Multiple_Stop_When_Full),
+        ztest_unit_test(test_Trend_Log_Multiple_Members_Write),
+        ztest_unit_test(test_Trend_Log_Multiple_Timer));
+
+    ztest_run_test_suite(trendlog_multiple_tests);
+}
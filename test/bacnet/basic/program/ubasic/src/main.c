@@ -484,6 +484,65 @@ static void test_ubasic(void)
 
     return;
 }
+
+/**
+ * @brief Test GOTO and GOSUB to labels
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ubasic_tests, test_ubasic_labels)
+#else
+static void test_ubasic_labels(void)
+#endif
+{
+    struct ubasic_data data = { 0 };
+    const char *program =
+        "n = 0;"
+        "c = 0;"
+        ":loop;"
+        "  n = n + 1;"
+        "  gosub add;"
+        "  if n < 10 then goto loop;"
+        "goto check;"
+        ":add c = c + n;"
+        "return;"
+        ":add c = c + 1000;"
+        "return;"
+        ":loop2 c = c + 1000;"
+        ":check;"
+        "  gosub l1;gosub l2;gosub l3;gosub l4;gosub l5;gosub l6;"
+        "  gosub l7;gosub l8;gosub l9;gosub l10;gosub l11;gosub l12;"
+        "  gosub l13;gosub l14;gosub l15;gosub l16;gosub l17;gosub l18;"
+        "end;"
+        ":l1 c = c + 1;return;:l2 c = c + 1;return;:l3 c = c + 1;return;"
+        ":l4 c = c + 1;return;:l5 c = c + 1;return;:l6 c = c + 1;return;"
+        ":l7 c = c + 1;return;:l8 c = c + 1;return;:l9 c = c + 1;return;"
+        ":l10 c = c + 1;return;:l11 c = c + 1;return;:l12 c = c + 1;return;"
+        ":l13 c = c + 1;return;:l14 c = c + 1;return;:l15 c = c + 1;return;"
+        ":l16 c = c + 1;return;:l17 c = c + 1;return;:l18 c = c + 1;return;";
+    UBASIC_VARIABLE_TYPE value = 0;
+
+    ubasic_load_program(&data, program);
+    zassert_equal(data.status.bit.isRunning, 1, NULL);
+    while (!ubasic_finished(&data)) {
+        ubasic_run_program(&data);
+    }
+    zassert_equal(data.status.bit.Error, 0, NULL);
+    value = ubasic_get_variable(&data, 'n');
+    zassert_equal(fixedpt_toint(value), 10, NULL);
+    /* the first label of a name is the target, and the labels beyond
+       the label table are found too */
+    value = ubasic_get_variable(&data, 'c');
+    zassert_equal(
+        fixedpt_toint(value), 55 + 18, "c value=%d", fixedpt_toint(value));
+    /* a program loaded again runs again */
+    ubasic_load_program(&data, NULL);
+    while (!ubasic_finished(&data)) {
+        ubasic_run_program(&data);
+    }
+    zassert_equal(data.status.bit.Error, 0, NULL);
+    value = ubasic_get_variable(&data, 'c');
+    zassert_equal(fixedpt_toint(value), 55 + 18, NULL);
+}
 /**
  * @}
  */
@@ -496,7 +555,8 @@ void test_main(void)
     ztest_test_suite(
         ubasic_tests, ztest_unit_test(test_ubasic),
         ztest_unit_test(test_ubasic_strings), ztest_unit_test(test_ubasic_math),
-        ztest_unit_test(test_ubasic_bacnet), ztest_unit_test(test_ubasic_gpio));
+        ztest_unit_test(test_ubasic_bacnet), ztest_unit_test(test_ubasic_gpio),
+        ztest_unit_test(test_ubasic_labels));
 
     ztest_run_test_suite(ubasic_tests);
 }
@@ -0,0 +1,427 @@
+/**
+ * @file
+ * @brief test the group notifications of the COV service handler
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/cov.h>
+#include <bacnet/npdu.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/service/h_cov.h>
+#include <bacnet/basic/tsm/tsm.h>
+#include <bacnet/datalink/datalink.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the notifications that the handler sent */
+#define TEST_SENT_MAX 8
+struct test_sent {
+    BACNET_ADDRESS dest;
+    bool confirmed;
+    BACNET_COV_DATA cov_data;
+};
+static struct test_sent Test_Sent[TEST_SENT_MAX];
+static unsigned Test_Sent_Count;
+/* Analog Value 1 changed */
+static bool Test_COV_Changed;
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+
+/**
+ * @brief Decode a COV notification that the handler sent
+ * @param sent - [out] the notification
+ * @param apdu - the APDU
+ * @param apdu_len - number of bytes in the APDU
+ * @return true if the APDU was a COV notification
+ */
+static bool test_notification_decode(
+    struct test_sent *sent, const uint8_t *apdu, unsigned apdu_len)
+{
+    unsigned offset;
+
+    if ((apdu_len > 2) && (apdu[0] == PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) &&
+        (apdu[1] == SERVICE_UNCONFIRMED_COV_NOTIFICATION)) {
+        sent->confirmed = false;
+        offset = 2;
+    } else if (
+        (apdu_len > 4) &&
+        ((apdu[0] & 0xF0) == PDU_TYPE_CONFIRMED_SERVICE_REQUEST) &&
+        (apdu[3] == SERVICE_CONFIRMED_COV_NOTIFICATION)) {
+        sent->confirmed = true;
+        offset = 4;
+    } else {
+        return false;
+    }
+    /* only the header of the notification is kept */
+    sent->cov_data.listOfValues = NULL;
+
+    return cov_notify_decode_service_request(
+               &apdu[offset], apdu_len - offset, &sent->cov_data) > 0;
+}
+
+int datalink_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    BACNET_NPDU_DATA decoded_npdu_data = { 0 };
+    struct test_sent *sent;
+    int len;
+
+    (void)npdu_data;
+    len = bacnet_npdu_decode(
+        pdu, (uint16_t)pdu_len, NULL, NULL, &decoded_npdu_data);
+    if ((len > 0) && (Test_Sent_Count < TEST_SENT_MAX)) {
+        sent = &Test_Sent[Test_Sent_Count];
+        if (test_notification_decode(sent, &pdu[len], pdu_len - len)) {
+            bacnet_address_copy(&sent->dest, dest);
+            Test_Sent_Count++;
+        }
+    }
+
+    return (int)pdu_len;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(*my_address));
+}
+
+void datalink_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    memset(dest, 0, sizeof(*dest));
+    dest->net = BACNET_BROADCAST_NETWORK;
+}
+
+bool tsm_transaction_available(void)
+{
+    return true;
+}
+
+uint8_t tsm_next_free_invokeID_peer(const BACNET_ADDRESS *dest)
+{
+    (void)dest;
+    return 1;
+}
+
+void tsm_set_confirmed_unsegmented_transaction(
+    uint8_t invokeID,
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *ndpu_data,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    (void)invokeID;
+    (void)dest;
+    (void)ndpu_data;
+    (void)apdu;
+    (void)apdu_len;
+}
+
+bool tsm_invoke_id_free_peer(const BACNET_ADDRESS *src, uint8_t invokeID)
+{
+    (void)src;
+    (void)invokeID;
+    return true;
+}
+
+bool tsm_invoke_id_failed_peer(const BACNET_ADDRESS *src, uint8_t invokeID)
+{
+    (void)src;
+    (void)invokeID;
+    return false;
+}
+
+void tsm_free_invoke_id_peer(const BACNET_ADDRESS *src, uint8_t invokeID)
+{
+    (void)src;
+    (void)invokeID;
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
+bool Device_Valid_Object_Id(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    return (object_type == OBJECT_ANALOG_VALUE) && (object_instance == 1);
+}
+
+bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
+{
+    return object_type == OBJECT_ANALOG_VALUE;
+}
+
+bool Device_COV(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    (void)object_type;
+    (void)object_instance;
+    return Test_COV_Changed;
+}
+
+void Device_COV_Clear(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    (void)object_type;
+    (void)object_instance;
+    Test_COV_Changed = false;
+}
+
+bool Device_Encode_Value_List(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    (void)object_type;
+    (void)object_instance;
+
+    return cov_value_list_encode_real(
+        value_list, 21.5f, false, false, false, false);
+}
+
+/**
+ * @brief Set the address of a subscriber
+ * @param src - [out] address of the subscriber
+ * @param net - network of the subscriber, or 0 for the local network
+ * @param router - last octet of the address of the router to the network
+ * @param mac - last octet of the address of the subscriber
+ */
+static void test_address_set(
+    BACNET_ADDRESS *src, uint16_t net, uint8_t router, uint8_t mac)
+{
+    memset(src, 0, sizeof(*src));
+    src->mac_len = 6;
+    src->mac[0] = 192;
+    src->mac[1] = 168;
+    src->mac[2] = 0;
+    src->mac[4] = 0xBA;
+    src->mac[5] = 0xC0;
+    if (net) {
+        src->net = net;
+        src->mac[3] = router;
+        src->len = 1;
+        src->adr[0] = mac;
+    } else {
+        src->mac[3] = mac;
+    }
+}
+
+/**
+ * @brief Subscribe to the changes of Analog Value 1
+ * @param src - address of the subscriber
+ * @param process_id - subscriber process identifier
+ * @param confirmed - true for confirmed notifications
+ * @param lifetime - seconds that the subscription lasts
+ */
+static void test_subscribe(
+    BACNET_ADDRESS *src, uint32_t process_id, bool confirmed, uint32_t lifetime)
+{
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int apdu_len;
+
+    cov_data.subscriberProcessIdentifier = process_id;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_VALUE;
+    cov_data.monitoredObjectIdentifier.instance = 1;
+    cov_data.issueConfirmedNotifications = confirmed;
+    cov_data.lifetime = lifetime;
+    apdu_len = cov_subscribe_encode_apdu(apdu, sizeof(apdu), 1, &cov_data);
+    zassert_true(apdu_len > 4, NULL);
+    service_data.invoke_id = 1;
+    handler_cov_subscribe(
+        &apdu[4], (uint16_t)(apdu_len - 4), src, &service_data);
+}
+
+/**
+ * @brief Run the COV task until each requested notification is sent
+ */
+static void test_task(void)
+{
+    unsigned i;
+
+    Test_Sent_Count = 0;
+    for (i = 0; i < 100; i++) {
+        handler_cov_task();
+    }
+}
+
+/**
+ * @brief Find the notification that was sent to an address
+ * @param dest - the address
+ * @return the notification, or NULL if none was sent to the address
+ */
+static const struct test_sent *test_sent_find(const BACNET_ADDRESS *dest)
+{
+    unsigned i;
+
+    for (i = 0; i < Test_Sent_Count; i++) {
+        if (bacnet_address_same(&Test_Sent[i].dest, dest)) {
+            return &Test_Sent[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void test_setup(void)
+{
+    handler_cov_init();
+    /* let the task see that the subscriptions are gone */
+    handler_cov_task();
+    handler_cov_notification_group_set(true);
+    Test_COV_Changed = false;
+    Test_Sent_Count = 0;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_cov_tests, testCOVGroupLocal)
+#else
+static void testCOVGroupLocal(void)
+#endif
+{
+    BACNET_ADDRESS src[4] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    const struct test_sent *sent;
+    unsigned i;
+
+    test_setup();
+    zassert_true(handler_cov_notification_group(), NULL);
+    for (i = 0; i < 4; i++) {
+        test_address_set(&src[i], 0, 0, (uint8_t)(10 + i));
+    }
+    test_subscribe(&src[0], 7, false, 300);
+    test_subscribe(&src[1], 7, false, 120);
+    test_subscribe(&src[2], 7, false, 600);
+    /* another process is not in the group */
+    test_subscribe(&src[3], 8, false, 300);
+    zassert_equal(handler_cov_subscription_count(), 4, NULL);
+    test_task();
+    /* one broadcast to the group and one notification to the other */
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    datalink_get_broadcast_address(&dest);
+    sent = test_sent_find(&dest);
+    zassert_not_null(sent, NULL);
+    zassert_false(sent->confirmed, NULL);
+    zassert_equal(sent->cov_data.subscriberProcessIdentifier, 7, NULL);
+    zassert_equal(sent->cov_data.initiatingDeviceIdentifier, 1234, NULL);
+    /* the time remaining is the shortest of the group */
+    zassert_true(sent->cov_data.timeRemaining <= 120, NULL);
+    zassert_true(sent->cov_data.timeRemaining > 0, NULL);
+    sent = test_sent_find(&src[3]);
+    zassert_not_null(sent, NULL);
+    zassert_equal(sent->cov_data.subscriberProcessIdentifier, 8, NULL);
+    /* without groups, each subscriber is sent its own notification */
+    handler_cov_notification_group_set(false);
+    zassert_false(handler_cov_notification_group(), NULL);
+    Test_COV_Changed = true;
+    test_task();
+    zassert_equal(Test_Sent_Count, 4, NULL);
+    for (i = 0; i < 4; i++) {
+        zassert_not_null(test_sent_find(&src[i]), NULL);
+    }
+    handler_cov_init();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_cov_tests, testCOVGroupRemote)
+#else
+static void testCOVGroupRemote(void)
+#endif
+{
+    BACNET_ADDRESS src[4] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    const struct test_sent *sent;
+
+    test_setup();
+    /* two subscribers on network 5 through the router at .1 */
+    test_address_set(&src[0], 5, 1, 10);
+    test_address_set(&src[1], 5, 1, 11);
+    /* one on network 5 through another router */
+    test_address_set(&src[2], 5, 2, 12);
+    /* one on network 6 through the same router */
+    test_address_set(&src[3], 6, 1, 10);
+    test_subscribe(&src[0], 7, false, 300);
+    test_subscribe(&src[1], 7, false, 300);
+    test_subscribe(&src[2], 7, false, 300);
+    test_subscribe(&src[3], 7, false, 300);
+    test_task();
+    zassert_equal(Test_Sent_Count, 3, NULL);
+    /* the remote broadcast of network 5 through the router at .1 */
+    dest = src[0];
+    dest.len = 0;
+    sent = test_sent_find(&dest);
+    zassert_not_null(sent, NULL);
+    zassert_false(sent->confirmed, NULL);
+    zassert_equal(sent->cov_data.subscriberProcessIdentifier, 7, NULL);
+    zassert_is_null(test_sent_find(&src[0]), NULL);
+    zassert_is_null(test_sent_find(&src[1]), NULL);
+    zassert_not_null(test_sent_find(&src[2]), NULL);
+    zassert_not_null(test_sent_find(&src[3]), NULL);
+    handler_cov_init();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_cov_tests, testCOVGroupConfirmed)
+#else
+static void testCOVGroupConfirmed(void)
+#endif
+{
+    BACNET_ADDRESS src[3] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    const struct test_sent *sent;
+    unsigned i;
+
+    test_setup();
+    for (i = 0; i < 3; i++) {
+        test_address_set(&src[i], 0, 0, (uint8_t)(10 + i));
+    }
+    /* a confirmed subscriber of the same process is not in the group */
+    test_subscribe(&src[0], 7, true, 300);
+    test_subscribe(&src[1], 7, false, 300);
+    test_subscribe(&src[2], 7, false, 300);
+    test_task();
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    sent = test_sent_find(&src[0]);
+    zassert_not_null(sent, NULL);
+    zassert_true(sent->confirmed, NULL);
+    datalink_get_broadcast_address(&dest);
+    sent = test_sent_find(&dest);
+    zassert_not_null(sent, NULL);
+    zassert_false(sent->confirmed, NULL);
+    /* a single unconfirmed subscriber is sent its own notification */
+    test_setup();
+    test_subscribe(&src[1], 7, false, 300);
+    test_subscribe(&src[2], 8, false, 300);
+    test_task();
+    zassert_equal(Test_Sent_Count, 2, NULL);
+    zassert_not_null(test_sent_find(&src[1]), NULL);
+    zassert_not_null(test_sent_find(&src[2]), NULL);
+    handler_cov_init();
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_cov_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        h_cov_tests, ztest_unit_test(testCOVGroupLocal),
+        ztest_unit_test(testCOVGroupRemote),
+        ztest_unit_test(testCOVGroupConfirmed));
+
+    ztest_run_test_suite(h_cov_tests);
+}
+#endif
@@ -0,0 +1,287 @@
+/**
+ * @file
+ * @brief test the response cache of the ReadPropertyMultiple handler
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/npdu.h>
+#include <bacnet/rp.h>
+#include <bacnet/rpm.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/netport.h>
+#include <bacnet/basic/service/h_rpm.h>
+#include <bacnet/basic/sys/mstimer.h>
+#include <bacnet/datalink/datalink.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the Present_Value of Analog Value 1 */
+static float Test_Present_Value;
+static unsigned Test_Read_Count;
+static uint32_t Test_Changes;
+static unsigned long Test_Milliseconds;
+/* what the handler sent */
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+static uint8_t Test_Sent[MAX_PDU];
+static unsigned Test_Sent_Len;
+
+int datalink_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    memcpy(Test_Sent, pdu, pdu_len);
+    Test_Sent_Len = pdu_len;
+
+    return (int)pdu_len;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(*my_address));
+}
+
+unsigned long mstimer_now(void)
+{
+    return Test_Milliseconds;
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 1234;
+}
+
+uint32_t Device_Property_Cache_Changes(void)
+{
+    return Test_Changes;
+}
+
+uint32_t Network_Port_Index_To_Instance(unsigned find_index)
+{
+    (void)find_index;
+    return 1;
+}
+
+bool Device_Valid_Object_Id(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    return (object_type == OBJECT_ANALOG_VALUE) && (object_instance == 1);
+}
+
+void Device_Objects_Property_List(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    struct special_property_list_t *pPropertyList)
+{
+    (void)object_type;
+    (void)object_instance;
+    memset(pPropertyList, 0, sizeof(*pPropertyList));
+}
+
+int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    Test_Read_Count++;
+    if (!Device_Valid_Object_Id(rpdata->object_type, rpdata->object_instance) ||
+        (rpdata->object_property != PROP_PRESENT_VALUE)) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_application_real(
+        rpdata->application_data, Test_Present_Value);
+}
+
+/**
+ * @brief Encode a request for the Present_Value of Analog Value 1
+ * @param apdu - buffer for the request
+ * @param apdu_size - size of the buffer
+ * @return number of bytes in the service request, after the header
+ */
+static int test_request_encode(uint8_t *apdu, size_t apdu_size)
+{
+    BACNET_READ_ACCESS_DATA read_access_data = { 0 };
+    BACNET_PROPERTY_REFERENCE property = { 0 };
+    int apdu_len;
+
+    read_access_data.object_type = OBJECT_ANALOG_VALUE;
+    read_access_data.object_instance = 1;
+    read_access_data.listOfProperties = &property;
+    property.propertyIdentifier = PROP_PRESENT_VALUE;
+    property.propertyArrayIndex = BACNET_ARRAY_ALL;
+    apdu_len = rpm_encode_apdu(apdu, apdu_size, 1, &read_access_data);
+    zassert_true(apdu_len > 4, NULL);
+    /* the service request follows the 4 octet confirmed header */
+    memmove(apdu, &apdu[4], (size_t)(apdu_len - 4));
+
+    return apdu_len - 4;
+}
+
+/**
+ * @brief Send the request to the handler, and get the APDU of the reply
+ * @param invoke_id - invoke ID of the request
+ * @param max_resp - size of the response that the client accepts
+ * @param apdu - the APDU of the reply
+ * @return number of bytes in the APDU of the reply
+ */
+static int
+test_request_send(uint8_t invoke_id, uint16_t max_resp, uint8_t **apdu)
+{
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t request[MAX_APDU] = { 0 };
+    int request_len;
+    int len;
+
+    request_len = test_request_encode(request, sizeof(request));
+    service_data.invoke_id = invoke_id;
+    service_data.max_resp = max_resp;
+    Test_Sent_Len = 0;
+    handler_read_property_multiple(
+        request, (uint16_t)request_len, &src, &service_data);
+    zassert_true(Test_Sent_Len > 0, NULL);
+    len = bacnet_npdu_decode(
+        Test_Sent, (uint16_t)Test_Sent_Len, NULL, NULL, &npdu_data);
+    zassert_true(len > 0, NULL);
+    *apdu = &Test_Sent[len];
+
+    return (int)Test_Sent_Len - len;
+}
+
+/**
+ * @brief Get the Present_Value of a ReadPropertyMultiple-ACK
+ */
+static float test_reply_value(uint8_t *apdu, int apdu_len)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len;
+
+    zassert_equal(apdu[0], PDU_TYPE_COMPLEX_ACK, NULL);
+    zassert_equal(apdu[2], SERVICE_CONFIRMED_READ_PROP_MULTIPLE, NULL);
+    /* object identifier, opening tag, property identifier, opening tag */
+    len = 3 + 5 + 1 + 2 + 1;
+    zassert_true(apdu_len > len, NULL);
+    len = bacapp_decode_application_data(
+        &apdu[len], (uint32_t)(apdu_len - len), &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+
+    return value.type.Real;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_rpm_tests, testReadPropertyMultipleCache)
+#else
+static void testReadPropertyMultipleCache(void)
+#endif
+{
+    uint8_t *apdu = NULL;
+    int apdu_len;
+
+    zassert_true(handler_read_property_multiple_cache_enable(1000), NULL);
+    Test_Present_Value = 1.0f;
+    Test_Read_Count = 0;
+    /* miss: the request is read from the object */
+    apdu_len = test_request_send(1, MAX_APDU, &apdu);
+    zassert_equal(Test_Read_Count, 1, NULL);
+    zassert_equal(apdu[1], 1, NULL);
+    zassert_false(islessgreater(test_reply_value(apdu, apdu_len), 1.0f), NULL);
+    /* hit: the cached reply with the invoke ID of the request */
+    Test_Present_Value = 2.0f;
+    apdu_len = test_request_send(2, MAX_APDU, &apdu);
+    zassert_equal(Test_Read_Count, 1, NULL);
+    zassert_equal(apdu[1], 2, NULL);
+    zassert_false(islessgreater(test_reply_value(apdu, apdu_len), 1.0f), NULL);
+    /* a write changes the device, so the request is read again */
+    Test_Changes++;
+    apdu_len = test_request_send(3, MAX_APDU, &apdu);
+    zassert_equal(Test_Read_Count, 2, NULL);
+    zassert_false(islessgreater(test_reply_value(apdu, apdu_len), 2.0f), NULL);
+    apdu_len = test_request_send(4, MAX_APDU, &apdu);
+    zassert_equal(Test_Read_Count, 2, NULL);
+    /* a client that accepts a different size is not given the copy */
+    Test_Present_Value = 3.0f;
+    apdu_len = test_request_send(5, 206, &apdu);
+    zassert_equal(Test_Read_Count, 3, NULL);
+    zassert_false(islessgreater(test_reply_value(apdu, apdu_len), 3.0f), NULL);
+    /* a reply older than the cache time is read again */
+    Test_Present_Value = 4.0f;
+    Test_Milliseconds += 1000;
+    apdu_len = test_request_send(6, MAX_APDU, &apdu);
+    zassert_equal(Test_Read_Count, 4, NULL);
+    zassert_false(islessgreater(test_reply_value(apdu, apdu_len), 4.0f), NULL);
+    /* discarded replies are read again */
+    Test_Present_Value = 5.0f;
+    handler_read_property_multiple_cache_invalidate();
+    apdu_len = test_request_send(7, MAX_APDU, &apdu);
+    zassert_equal(Test_Read_Count, 5, NULL);
+    zassert_false(islessgreater(test_reply_value(apdu, apdu_len), 5.0f), NULL);
+    zassert_false(handler_read_property_multiple_cache_enable(0), NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_rpm_tests, testReadPropertyMultipleCacheEncode)
+#else
+static void testReadPropertyMultipleCacheEncode(void)
+#endif
+{
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t request[MAX_APDU] = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint8_t *apdu = NULL;
+    int request_len;
+    int pdu_len;
+
+    zassert_true(handler_read_property_multiple_cache_enable(1000), NULL);
+    Test_Present_Value = 1.0f;
+    Test_Read_Count = 0;
+    request_len = test_request_encode(request, sizeof(request));
+    service_data.invoke_id = 1;
+    service_data.max_resp = MAX_APDU;
+    /* the encoder for the other threads does not keep its reply */
+    pdu_len = handler_read_property_multiple_encode(
+        pdu, sizeof(pdu), request, (uint16_t)request_len, &src,
+        &service_data, &npdu_data);
+    zassert_true(pdu_len > 0, NULL);
+    zassert_equal(Test_Read_Count, 1, NULL);
+    (void)test_request_send(2, MAX_APDU, &apdu);
+    zassert_equal(Test_Read_Count, 2, NULL);
+    /* but it uses the reply kept by the handler */
+    pdu_len = handler_read_property_multiple_encode(
+        pdu, sizeof(pdu), request, (uint16_t)request_len, &src,
+        &service_data, &npdu_data);
+    zassert_true(pdu_len > 0, NULL);
+    zassert_equal(Test_Read_Count, 2, NULL);
+    zassert_false(handler_read_property_multiple_cache_enable(0), NULL);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_rpm_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        h_rpm_tests, ztest_unit_test(testReadPropertyMultipleCache),
+        ztest_unit_test(testReadPropertyMultipleCacheEncode));
+
+    ztest_run_test_suite(h_rpm_tests);
+}
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @brief test the process identifier filter of the UnconfirmedCOV handler
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/cov.h>
+#include <bacnet/basic/service/h_ucov.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the notifications that were passed to the callback */
+static unsigned Test_Notification_Count;
+static uint32_t Test_Process_Identifier;
+
+static void test_notification_callback(BACNET_COV_DATA *cov_data)
+{
+    Test_Notification_Count++;
+    Test_Process_Identifier = cov_data->subscriberProcessIdentifier;
+}
+
+static BACNET_COV_NOTIFICATION Test_Notification = {
+    .next = NULL,
+    .callback = test_notification_callback
+};
+
+/**
+ * @brief Pass a notification to a subscriber process to the handler
+ * @param process_id - subscriber process identifier
+ * @return true if the notification was passed to the callback
+ */
+static bool test_notification_receive(uint32_t process_id)
+{
+    BACNET_PROPERTY_VALUE value_list[2] = { 0 };
+    BACNET_COV_DATA cov_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    unsigned count;
+    int apdu_len;
+
+    bacapp_property_value_list_init(&value_list[0], 2);
+    zassert_true(
+        cov_value_list_encode_real(
+            &value_list[0], 21.5f, false, false, false, false),
+        NULL);
+    cov_data.subscriberProcessIdentifier = process_id;
+    cov_data.initiatingDeviceIdentifier = 1234;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_VALUE;
+    cov_data.monitoredObjectIdentifier.instance = 1;
+    cov_data.timeRemaining = 60;
+    cov_data.listOfValues = &value_list[0];
+    apdu_len = ucov_notify_encode_apdu(apdu, sizeof(apdu), &cov_data);
+    zassert_true(apdu_len > 2, NULL);
+    count = Test_Notification_Count;
+    handler_ucov_notification(&apdu[2], (uint16_t)(apdu_len - 2), &src);
+    if (Test_Notification_Count == count) {
+        return false;
+    }
+    zassert_equal(Test_Process_Identifier, process_id, NULL);
+
+    return true;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_ucov_tests, testUCOVProcessIdentifier)
+#else
+static void testUCOVProcessIdentifier(void)
+#endif
+{
+    uint32_t process_id;
+
+    handler_ucov_notification_add(&Test_Notification);
+    /* an empty list accepts all of them */
+    handler_ucov_process_identifier_clear();
+    zassert_true(test_notification_receive(7), NULL);
+    zassert_true(test_notification_receive(8), NULL);
+    /* once one is added, only the listed ones are accepted */
+    zassert_true(handler_ucov_process_identifier_add(7), NULL);
+    zassert_true(test_notification_receive(7), NULL);
+    zassert_false(test_notification_receive(8), NULL);
+    /* one already listed is accepted again */
+    zassert_true(handler_ucov_process_identifier_add(7), NULL);
+    /* a full list refuses another one */
+    process_id = 100;
+    while (handler_ucov_process_identifier_add(process_id)) {
+        process_id++;
+        zassert_true(process_id < 1000, NULL);
+    }
+    zassert_false(handler_ucov_process_identifier_add(process_id), NULL);
+    zassert_true(test_notification_receive(7), NULL);
+    zassert_true(test_notification_receive(process_id - 1), NULL);
+    zassert_false(test_notification_receive(process_id), NULL);
+    zassert_false(test_notification_receive(8), NULL);
+    /* a cleared list accepts all of them again */
+    handler_ucov_process_identifier_clear();
+    zassert_true(test_notification_receive(8), NULL);
+    zassert_true(test_notification_receive(process_id), NULL);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_ucov_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(h_ucov_tests, ztest_unit_test(testUCOVProcessIdentifier));
+
+    ztest_run_test_suite(h_ucov_tests);
+}
+#endif
@@ -0,0 +1,282 @@
+/**
+ * @file
+ * @brief test the atomic WritePropertyMultiple service handler
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/bacerror.h>
+#include <bacnet/npdu.h>
+#include <bacnet/rp.h>
+#include <bacnet/wp.h>
+#include <bacnet/wpm.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/service/h_apdu.h>
+#include <bacnet/basic/service/h_wpm.h>
+#include <bacnet/datalink/datalink.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the Analog Values 1 to 4, with the encoded Present_Value of each */
+#define TEST_OBJECTS_MAX 5
+#define TEST_VALUE_SIZE (MAX_APDU + 16)
+static uint8_t Test_Value[TEST_OBJECTS_MAX][TEST_VALUE_SIZE];
+static int Test_Value_Len[TEST_OBJECTS_MAX];
+/* the instance whose write fails */
+static uint32_t Test_Write_Fail;
+/* what the handler sent */
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+static uint8_t Test_Sent[MAX_PDU];
+static unsigned Test_Sent_Len;
+static uint8_t Test_Scratch[sizeof(BACNET_WRITE_PROPERTY_DATA)];
+
+void *apdu_scratch_alloc(size_t size)
+{
+    if (size > sizeof(Test_Scratch)) {
+        return NULL;
+    }
+
+    return Test_Scratch;
+}
+
+int datalink_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    memcpy(Test_Sent, pdu, pdu_len);
+    Test_Sent_Len = pdu_len;
+
+    return (int)pdu_len;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(*my_address));
+}
+
+int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    uint32_t instance = rpdata->object_instance;
+
+    if ((rpdata->object_type != OBJECT_ANALOG_VALUE) ||
+        (instance >= TEST_OBJECTS_MAX) ||
+        (rpdata->object_property != PROP_PRESENT_VALUE)) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+        return BACNET_STATUS_ERROR;
+    }
+    if (Test_Value_Len[instance] > rpdata->application_data_len) {
+        rpdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        return BACNET_STATUS_ABORT;
+    }
+    memcpy(
+        rpdata->application_data, Test_Value[instance],
+        (size_t)Test_Value_Len[instance]);
+
+    return Test_Value_Len[instance];
+}
+
+bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    uint32_t instance = wp_data->object_instance;
+
+    if ((wp_data->object_type != OBJECT_ANALOG_VALUE) ||
+        (instance >= TEST_OBJECTS_MAX) || (instance == Test_Write_Fail)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    }
+    memcpy(
+        Test_Value[instance], wp_data->application_data,
+        (size_t)wp_data->application_data_len);
+    Test_Value_Len[instance] = wp_data->application_data_len;
+
+    return true;
+}
+
+/**
+ * @brief Give each Analog Value a REAL Present_Value of its instance
+ */
+static void test_setup(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < TEST_OBJECTS_MAX; i++) {
+        Test_Value_Len[i] = encode_application_real(Test_Value[i], (float)i);
+    }
+    Test_Write_Fail = TEST_OBJECTS_MAX;
+    Test_Sent_Len = 0;
+}
+
+/**
+ * @brief Get the REAL Present_Value of an Analog Value
+ */
+static float test_value(uint32_t instance)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len;
+
+    len = bacapp_decode_application_data(
+        Test_Value[instance], (uint32_t)Test_Value_Len[instance], &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+
+    return value.type.Real;
+}
+
+/**
+ * @brief Send a request that writes 10 times the instance of each
+ *  Analog Value to its Present_Value
+ * @param instances - the Analog Values, in the order of the request
+ * @param count - number of Analog Values
+ */
+static void test_request_send(const uint32_t *instances, unsigned count)
+{
+    BACNET_WRITE_ACCESS_DATA write_access_data[TEST_OBJECTS_MAX] = { 0 };
+    BACNET_PROPERTY_VALUE property_value[TEST_OBJECTS_MAX] = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int apdu_len;
+    unsigned i;
+
+    wpm_write_access_data_link_array(write_access_data, count);
+    for (i = 0; i < count; i++) {
+        write_access_data[i].object_type = OBJECT_ANALOG_VALUE;
+        write_access_data[i].object_instance = instances[i];
+        write_access_data[i].listOfProperties = &property_value[i];
+        bacapp_property_value_list_init(&property_value[i], 1);
+        property_value[i].propertyIdentifier = PROP_PRESENT_VALUE;
+        property_value[i].propertyArrayIndex = BACNET_ARRAY_ALL;
+        property_value[i].value.tag = BACNET_APPLICATION_TAG_REAL;
+        property_value[i].value.type.Real = 10.0f * (float)instances[i];
+        property_value[i].priority = BACNET_NO_PRIORITY;
+    }
+    apdu_len = wpm_encode_apdu(apdu, sizeof(apdu), 1, write_access_data);
+    zassert_true(apdu_len > 4, NULL);
+    service_data.invoke_id = 1;
+    handler_write_property_multiple(
+        &apdu[4], (uint16_t)(apdu_len - 4), &src, &service_data);
+    zassert_true(Test_Sent_Len > 0, NULL);
+}
+
+/**
+ * @brief Get the error of the reply that the handler sent
+ * @return true if the reply was a WritePropertyMultiple error
+ */
+static bool test_reply_error(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    len = bacnet_npdu_decode(
+        Test_Sent, (uint16_t)Test_Sent_Len, NULL, NULL, &npdu_data);
+    zassert_true(len > 0, NULL);
+    if (Test_Sent[len] != PDU_TYPE_ERROR) {
+        return false;
+    }
+    len += 3;
+
+    return wpm_error_ack_decode_apdu(
+               &Test_Sent[len], (uint16_t)(Test_Sent_Len - len), wp_data) > 0;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_wpm_tests, testWritePropertyMultipleAtomic)
+#else
+static void testWritePropertyMultipleAtomic(void)
+#endif
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    const uint32_t instances[] = { 1, 2, 3 };
+
+    /* every write succeeds */
+    test_setup();
+    handler_write_property_multiple_atomic_set(true);
+    zassert_true(handler_write_property_multiple_atomic(), NULL);
+    test_request_send(instances, 3);
+    zassert_false(test_reply_error(&wp_data), NULL);
+    zassert_false(islessgreater(test_value(1), 10.0f), NULL);
+    zassert_false(islessgreater(test_value(2), 20.0f), NULL);
+    zassert_false(islessgreater(test_value(3), 30.0f), NULL);
+    /* the last write fails, so the earlier writes are undone */
+    test_setup();
+    Test_Write_Fail = 3;
+    test_request_send(instances, 3);
+    zassert_true(test_reply_error(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    zassert_equal(wp_data.object_instance, 3, NULL);
+    zassert_false(islessgreater(test_value(1), 1.0f), NULL);
+    zassert_false(islessgreater(test_value(2), 2.0f), NULL);
+    zassert_false(islessgreater(test_value(3), 3.0f), NULL);
+    /* not atomic: the writes before the failure remain */
+    test_setup();
+    Test_Write_Fail = 3;
+    handler_write_property_multiple_atomic_set(false);
+    test_request_send(instances, 3);
+    zassert_true(test_reply_error(&wp_data), NULL);
+    zassert_false(islessgreater(test_value(1), 10.0f), NULL);
+    zassert_false(islessgreater(test_value(2), 20.0f), NULL);
+    zassert_false(islessgreater(test_value(3), 3.0f), NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_wpm_tests, testWritePropertyMultipleAtomicTooLarge)
+#else
+static void testWritePropertyMultipleAtomicTooLarge(void)
+#endif
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    const uint32_t instances[] = { 1, 4 };
+
+    /* the value of Analog Value 4 is too large to be written back */
+    test_setup();
+    memset(Test_Value[4], 0, sizeof(Test_Value[4]));
+    Test_Value_Len[4] = MAX_APDU + 1;
+    handler_write_property_multiple_atomic_set(true);
+    test_request_send(instances, 2);
+    zassert_true(test_reply_error(&wp_data), NULL);
+    zassert_equal(wp_data.error_class, ERROR_CLASS_RESOURCES, NULL);
+    zassert_equal(
+        wp_data.error_code, ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY, NULL);
+    zassert_equal(wp_data.object_instance, 4, NULL);
+    zassert_false(islessgreater(test_value(1), 1.0f), NULL);
+    zassert_equal(Test_Value_Len[4], MAX_APDU + 1, NULL);
+    /* a value that just fits is kept */
+    test_setup();
+    Test_Value_Len[4] = MAX_APDU;
+    Test_Write_Fail = 4;
+    test_request_send(instances, 2);
+    zassert_true(test_reply_error(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    zassert_false(islessgreater(test_value(1), 1.0f), NULL);
+    handler_write_property_multiple_atomic_set(false);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_wpm_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        h_wpm_tests, ztest_unit_test(testWritePropertyMultipleAtomic),
+        ztest_unit_test(testWritePropertyMultipleAtomicTooLarge));
+
+    ztest_run_test_suite(h_wpm_tests);
+}
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief test Arena library API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/arena.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test carving memory from an arena and releasing it at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(arena_tests, testArena)
+#else
+static void testArena(void)
+#endif
+{
+    static uint8_t buffer[256];
+    ARENA_TYPE arena = ARENA_INITIALIZER(buffer, sizeof(buffer));
+    uint8_t *octets, *other;
+    double *real;
+    size_t mark, used;
+
+    /* empty allocations and missing arenas give nothing */
+    zassert_is_null(Arena_Alloc(&arena, 0), NULL);
+    zassert_is_null(Arena_Alloc(NULL, 1), NULL);
+    zassert_equal(Arena_Used(NULL), 0, NULL);
+    zassert_equal(Arena_Available(NULL), 0, NULL);
+    Arena_Init(&arena, buffer, sizeof(buffer));
+    zassert_equal(Arena_Used(&arena), 0, NULL);
+    zassert_equal(Arena_Available(&arena), sizeof(buffer), NULL);
+    /* memory is cleared, and aligned for any data type */
+    memset(buffer, 0xA5, sizeof(buffer));
+    octets = Arena_Alloc(&arena, 3);
+    zassert_not_null(octets, NULL);
+    zassert_equal(octets[0], 0, NULL);
+    zassert_equal(octets[2], 0, NULL);
+    real = Arena_Alloc(&arena, sizeof(double));
+    zassert_not_null(real, NULL);
+    zassert_equal(((uintptr_t)real) % sizeof(double), 0, NULL);
+    zassert_true((uint8_t *)real >= (octets + 3), NULL);
+    *real = 1.5;
+    used = Arena_Used(&arena);
+    zassert_true(used >= (3 + sizeof(double)), NULL);
+    zassert_equal(Arena_Available(&arena), sizeof(buffer) - used, NULL);
+    /* memory after a mark is given out again after a release */
+    mark = Arena_Mark(&arena);
+    other = Arena_Alloc(&arena, 16);
+    zassert_not_null(other, NULL);
+    Arena_Release(&arena, mark);
+    zassert_equal(Arena_Used(&arena), used, NULL);
+    zassert_equal(Arena_Alloc(&arena, 16), other, NULL);
+    /* an arena does not give out more than its buffer */
+    zassert_is_null(Arena_Alloc(&arena, sizeof(buffer)), NULL);
+    zassert_not_null(Arena_Alloc(&arena, Arena_Available(&arena)), NULL);
+    zassert_equal(Arena_Available(&arena), 0, NULL);
+    zassert_is_null(Arena_Alloc(&arena, 1), NULL);
+    zassert_equal(Arena_Peak(&arena), sizeof(buffer), NULL);
+    /* all of the memory is taken back at once */
+    Arena_Reset(&arena);
+    zassert_equal(Arena_Used(&arena), 0, NULL);
+    zassert_equal(Arena_Peak(&arena), sizeof(buffer), NULL);
+    zassert_equal(Arena_Alloc(&arena, 3), octets, NULL);
+    /* an arena without a buffer gives nothing */
+    Arena_Init(&arena, NULL, sizeof(buffer));
+    zassert_equal(Arena_Available(&arena), 0, NULL);
+    zassert_is_null(Arena_Alloc(&arena, 1), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(arena_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(arena_tests, ztest_unit_test(testArena));
+
+    ztest_run_test_suite(arena_tests);
+}
+#endif
@@ -0,0 +1,231 @@
+/**
+ * @file
+ * @brief test the binary trace of the BACnet stack hot paths
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacint.h>
+#include <bacnet/basic/sys/bactrace.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static BACTRACE_EVENT Test_Events[BACTRACE_RING_SIZE];
+static uint32_t Test_Clock;
+
+static uint32_t test_clock(void)
+{
+    return ++Test_Clock;
+}
+
+/**
+ * @brief Read until the ring of this thread is empty
+ * @return the position after the last event
+ */
+static uint32_t test_position(void)
+{
+    uint32_t position = 0;
+
+    while (bactrace_read(0, &position, Test_Events, BACTRACE_RING_SIZE) > 0) {
+    }
+
+    return position;
+}
+
+/**
+ * @brief Test that the events are read back in the order they were written
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bactrace_tests, test_bactrace_read)
+#else
+static void test_bactrace_read(void)
+#endif
+{
+    uint32_t position, old_position;
+    unsigned count, i;
+
+    bactrace_clock_set(test_clock);
+    BACTRACE_DATALINK_RECEIVE(1, 480);
+    zassert_equal(bactrace_ring_count(), 1, NULL);
+    position = test_position();
+    BACTRACE_NPDU(BACTRACE_NPDU_APDU, 0xFFFF, 3, 21);
+    BACTRACE_APDU_BEGIN(0x30, 17);
+    BACTRACE_TSM_STATE(1, 42, 2, 3);
+    old_position = position;
+    count = bactrace_read(0, &position, Test_Events, BACTRACE_RING_SIZE);
+    zassert_equal(count, 3, NULL);
+    zassert_equal(position, old_position + 3, NULL);
+    zassert_equal(Test_Events[0].type, BACTRACE_EVENT_NPDU, NULL);
+    zassert_equal(Test_Events[0].arg8, BACTRACE_NPDU_APDU, NULL);
+    zassert_equal(Test_Events[0].arg16, 0xFFFF, NULL);
+    zassert_equal(Test_Events[0].arg32[0], 3, NULL);
+    zassert_equal(Test_Events[0].arg32[1], 21, NULL);
+    zassert_equal(Test_Events[1].type, BACTRACE_EVENT_APDU_BEGIN, NULL);
+    zassert_equal(Test_Events[1].arg8, 0x30, NULL);
+    zassert_equal(Test_Events[1].arg16, 17, NULL);
+    zassert_equal(Test_Events[2].type, BACTRACE_EVENT_TSM_STATE, NULL);
+    zassert_equal(Test_Events[2].arg16, 42, NULL);
+    zassert_equal(Test_Events[2].arg32[1], 3, NULL);
+    zassert_true(Test_Events[0].time < Test_Events[1].time, NULL);
+    zassert_true(Test_Events[1].time < Test_Events[2].time, NULL);
+    count = bactrace_read(0, &position, Test_Events, BACTRACE_RING_SIZE);
+    zassert_equal(count, 0, NULL);
+    /* a few at a time */
+    for (i = 0; i < 5; i++) {
+        BACTRACE_COV_SEND(true, 1, i, 7);
+    }
+    count = bactrace_read(0, &position, Test_Events, 2);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(Test_Events[1].arg32[0], 1, NULL);
+    count = bactrace_read(0, &position, Test_Events, 2);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(Test_Events[0].arg32[0], 2, NULL);
+    count = bactrace_read(0, &position, Test_Events, 2);
+    zassert_equal(count, 1, NULL);
+    zassert_equal(Test_Events[0].arg32[0], 4, NULL);
+    /* not a ring */
+    count = bactrace_read(1, &position, Test_Events, 2);
+    zassert_equal(count, 0, NULL);
+    count = bactrace_read(0, NULL, Test_Events, 2);
+    zassert_equal(count, 0, NULL);
+    zassert_equal(bactrace_dropped(), 0, NULL);
+}
+
+/**
+ * @brief Test that the overwritten events are skipped and counted
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bactrace_tests, test_bactrace_overwrite)
+#else
+static void test_bactrace_overwrite(void)
+#endif
+{
+    uint32_t position, old_position;
+    unsigned count, i;
+
+    position = test_position();
+    old_position = position;
+    for (i = 0; i < (BACTRACE_RING_SIZE + 10); i++) {
+        BACTRACE_COV_SEND(false, 1, i, 0);
+    }
+    count = bactrace_read(0, &position, Test_Events, BACTRACE_RING_SIZE);
+    zassert_equal(count, BACTRACE_RING_SIZE - 1, NULL);
+    zassert_equal(position - old_position - count, 11, NULL);
+    zassert_equal(Test_Events[0].arg32[0], 11, NULL);
+    zassert_equal(
+        Test_Events[count - 1].arg32[0], BACTRACE_RING_SIZE + 9, NULL);
+    count = bactrace_read(0, &position, Test_Events, BACTRACE_RING_SIZE);
+    zassert_equal(count, 0, NULL);
+}
+
+/**
+ * @brief Test the encoding of the events, and their names
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bactrace_tests, test_bactrace_encode)
+#else
+static void test_bactrace_encode(void)
+#endif
+{
+    BACTRACE_EVENT event = { 0 }, test_event = { 0 };
+    uint8_t buffer[BACTRACE_EVENT_SIZE] = { 0 };
+    uint32_t value = 0;
+
+    event.time = 0x12345678;
+    event.type = BACTRACE_EVENT_APDU_END;
+    event.arg8 = 0x20;
+    event.arg16 = 0xABCD;
+    event.arg32[0] = 0x01020304;
+    event.arg32[1] = 0xFFFFFFFF;
+    bactrace_event_encode(buffer, &event);
+    (void)decode_unsigned32(&buffer[0], &value);
+    zassert_equal(value, event.time, NULL);
+    bactrace_event_decode(buffer, &test_event);
+    zassert_equal(test_event.time, event.time, NULL);
+    zassert_equal(test_event.type, event.type, NULL);
+    zassert_equal(test_event.arg8, event.arg8, NULL);
+    zassert_equal(test_event.arg16, event.arg16, NULL);
+    zassert_equal(test_event.arg32[0], event.arg32[0], NULL);
+    zassert_equal(test_event.arg32[1], event.arg32[1], NULL);
+    zassert_equal(
+        strcmp(
+            bactrace_event_name(BACTRACE_EVENT_DATALINK_SEND), "datalink-send"),
+        0, NULL);
+    zassert_equal(
+        strcmp(bactrace_event_name(BACTRACE_EVENT_COV_SEND), "cov-send"), 0,
+        NULL);
+    zassert_equal(
+        strcmp(bactrace_event_name(BACTRACE_EVENT_MAX), "unknown"), 0, NULL);
+}
+
+/**
+ * @brief Test the header and the events of a trace file
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bactrace_tests, test_bactrace_dump)
+#else
+static void test_bactrace_dump(void)
+#endif
+{
+    const char *pathname = "bactrace_test.trace";
+    uint8_t buffer[BACTRACE_FILE_HEADER_SIZE] = { 0 };
+    BACTRACE_EVENT event = { 0 };
+    uint16_t value16 = 0;
+    uint32_t value32 = 0, count = 0;
+    FILE *file;
+
+    BACTRACE_APDU_END(0x10, 8);
+    zassert_true(bactrace_dump(pathname), NULL);
+    zassert_false(bactrace_dump(NULL), NULL);
+    file = fopen(pathname, "rb");
+    zassert_not_null(file, NULL);
+    zassert_equal(fread(buffer, BACTRACE_FILE_HEADER_SIZE, 1, file), 1, NULL);
+    zassert_mem_equal(
+        buffer, BACTRACE_FILE_MAGIC, BACTRACE_FILE_MAGIC_SIZE, NULL);
+    (void)decode_unsigned16(&buffer[8], &value16);
+    zassert_equal(value16, BACTRACE_FILE_VERSION, NULL);
+    (void)decode_unsigned16(&buffer[10], &value16);
+    zassert_equal(value16, BACTRACE_EVENT_SIZE, NULL);
+    (void)decode_unsigned32(&buffer[12], &value32);
+    zassert_equal(value32, 1, NULL);
+    zassert_equal(
+        fread(buffer, BACTRACE_FILE_RING_HEADER_SIZE, 1, file), 1, NULL);
+    (void)decode_unsigned32(&buffer[0], &count);
+    zassert_true(count > 0, NULL);
+    zassert_true(count <= BACTRACE_RING_SIZE, NULL);
+    /* the newest event is the last one */
+    zassert_equal(
+        fseek(file, (long)((count - 1) * BACTRACE_EVENT_SIZE), SEEK_CUR), 0,
+        NULL);
+    zassert_equal(fread(buffer, BACTRACE_EVENT_SIZE, 1, file), 1, NULL);
+    bactrace_event_decode(buffer, &event);
+    zassert_equal(event.type, BACTRACE_EVENT_APDU_END, NULL);
+    zassert_equal(event.arg8, 0x10, NULL);
+    zassert_equal(event.arg16, 8, NULL);
+    zassert_equal(fread(buffer, 1, 1, file), 0, NULL);
+    fclose(file);
+    zassert_equal(remove(pathname), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bactrace_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        bactrace_tests, ztest_unit_test(test_bactrace_read),
+        ztest_unit_test(test_bactrace_overwrite),
+        ztest_unit_test(test_bactrace_encode),
+        ztest_unit_test(test_bactrace_dump));
+
+    ztest_run_test_suite(bactrace_tests);
+}
+#endif
@@ -6,6 +6,7 @@
  */
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/sys/color_rgb.h>
@@ -162,6 +163,98 @@ static void test_color_rgb_ascii(void)
     }
 }
 
+/**
+ * @brief Check that two sRGB values differ by at most one
+ */
+static bool is_rgb_near(uint8_t value1, uint8_t value2)
+{
+    return abs((int)value1 - (int)value2) <= 1;
+}
+
+/**
+ * Unit Test for the fast sRGB conversions from tables
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(color_rgb_tests, test_color_rgb_fast)
+#else
+static void test_color_rgb_fast(void)
+#endif
+{
+    float x, y, test_x, test_y;
+    uint8_t brightness, test_brightness;
+    uint8_t red, green, blue, test_red, test_green, test_blue;
+    uint8_t low[3], high[3], test_rgb[3];
+    uint8_t rgb[3 * 3] = { 0 };
+    float x_list[3] = { 0.313f, 0.157f, 0.735f };
+    float y_list[3] = { 0.329f, 0.017f, 0.265f };
+    uint8_t brightness_list[3] = { 255, 5, 12 };
+    uint16_t kelvin_list[3] = { 2700, 6550, 40000 };
+    unsigned r, g, b, kelvin, i;
+
+    /* the same as the accurate functions */
+    for (r = 0; r < 256; r += 15) {
+        for (g = 0; g < 256; g += 15) {
+            for (b = 0; b < 256; b += 15) {
+                color_rgb_to_xy_gamma(r, g, b, &x, &y, &brightness);
+                color_rgb_to_xy_gamma_fast(
+                    r, g, b, &test_x, &test_y, &test_brightness);
+                zassert_true(is_float_equal(x, test_x), NULL);
+                zassert_true(is_float_equal(y, test_y), NULL);
+                zassert_true(is_rgb_near(brightness, test_brightness), NULL);
+                color_rgb_from_xy_gamma(
+                    &red, &green, &blue, x, y, brightness);
+                color_rgb_from_xy_gamma_fast(
+                    &test_red, &test_green, &test_blue, x, y, brightness);
+                zassert_true(is_rgb_near(red, test_red), NULL);
+                zassert_true(is_rgb_near(green, test_green), NULL);
+                zassert_true(is_rgb_near(blue, test_blue), NULL);
+            }
+        }
+    }
+    /* the same at each hundred Kelvin, and in between them */
+    for (kelvin = 500; kelvin <= 41000; kelvin += 100) {
+        color_rgb_from_temperature(kelvin, &red, &green, &blue);
+        color_rgb_from_temperature_fast(
+            kelvin, &test_red, &test_green, &test_blue);
+        zassert_equal(red, test_red, "K=%u", kelvin);
+        zassert_equal(green, test_green, "K=%u", kelvin);
+        zassert_equal(blue, test_blue, "K=%u", kelvin);
+    }
+    for (kelvin = 1000; kelvin < 40000; kelvin += 100) {
+        color_rgb_from_temperature(kelvin, &low[0], &low[1], &low[2]);
+        color_rgb_from_temperature(kelvin + 100, &high[0], &high[1], &high[2]);
+        color_rgb_from_temperature_fast(
+            kelvin + 50, &test_rgb[0], &test_rgb[1], &test_rgb[2]);
+        for (i = 0; i < 3; i++) {
+            zassert_true(
+                ((test_rgb[i] >= low[i]) && (test_rgb[i] <= high[i])) ||
+                    ((test_rgb[i] <= low[i]) && (test_rgb[i] >= high[i])),
+                "K=%u", kelvin + 50);
+        }
+    }
+    color_rgb_from_temperature_fast(6550, &test_red, &test_green, &test_blue);
+    color_rgb_from_temperature(6500, &red, &green, &blue);
+    zassert_true(test_blue > blue, NULL);
+    color_rgb_from_temperature(6600, &red, &green, &blue);
+    zassert_true(test_blue < blue, NULL);
+    /* many colors at once */
+    color_rgb_from_xy_gamma_batch(rgb, x_list, y_list, brightness_list, 3);
+    for (i = 0; i < 3; i++) {
+        color_rgb_from_xy_gamma_fast(
+            &red, &green, &blue, x_list[i], y_list[i], brightness_list[i]);
+        zassert_equal(rgb[i * 3], red, NULL);
+        zassert_equal(rgb[i * 3 + 1], green, NULL);
+        zassert_equal(rgb[i * 3 + 2], blue, NULL);
+    }
+    color_rgb_from_temperature_batch(rgb, kelvin_list, 3);
+    for (i = 0; i < 3; i++) {
+        color_rgb_from_temperature_fast(kelvin_list[i], &red, &green, &blue);
+        zassert_equal(rgb[i * 3], red, NULL);
+        zassert_equal(rgb[i * 3 + 1], green, NULL);
+        zassert_equal(rgb[i * 3 + 2], blue, NULL);
+    }
+}
+
 /**
  * @}
  */
@@ -173,7 +266,8 @@ void test_main(void)
 {
     ztest_test_suite(
         color_rgb_tests, ztest_unit_test(test_color_rgb_ascii),
-        ztest_unit_test(test_color_rgb_xy));
+        ztest_unit_test(test_color_rgb_xy),
+        ztest_unit_test(test_color_rgb_fast));
 
     ztest_run_test_suite(color_rgb_tests);
 }
@@ -6,9 +6,14 @@
  * @copyright SPDX-License-Identifier: MIT
  */
 #include <limits.h>
+#include <stdio.h>
+#include <time.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/sys/fifo.h>
 
+/* bytes moved by the throughput benchmark */
+#define FIFO_BENCH_BYTES (16UL * 1024UL * 1024UL)
+
 /**
  * @addtogroup bacnet_tests
  * @{
@@ -163,6 +168,101 @@ static void testFIFOBuffer(void)
 
     return;
 }
+
+/**
+ * @brief Unit Test for the bulk copies across the end of the data store,
+ *  and the wrap of the free running indexes
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(fifo_tests, testFIFOBulk)
+#else
+static void testFIFOBulk(void)
+#endif
+{
+    FIFO_BUFFER test_buffer = { 0 };
+    volatile uint8_t data_store[100] = { 0 };
+    uint8_t add_data[48] = { 0 };
+    uint8_t pull_data[48] = { 0 };
+    unsigned count = 0;
+    unsigned i, n;
+    bool status = false;
+
+    for (i = 0; i < sizeof(add_data); i++) {
+        add_data[i] = (uint8_t)(i + 1);
+    }
+    /* only the largest power of two that fits is used */
+    FIFO_Init(&test_buffer, data_store, sizeof(data_store));
+    zassert_true(FIFO_Available(&test_buffer, 64), NULL);
+    zassert_false(FIFO_Available(&test_buffer, 65), NULL);
+    /* start just before the indexes wrap */
+    test_buffer.head = UINT_MAX - 20;
+    test_buffer.tail = UINT_MAX - 20;
+    for (n = 0; n < 16; n++) {
+        zassert_true(FIFO_Empty(&test_buffer), NULL);
+        status = FIFO_Add(&test_buffer, add_data, sizeof(add_data));
+        zassert_true(status, NULL);
+        zassert_equal(FIFO_Count(&test_buffer), sizeof(add_data), NULL);
+        zassert_false(FIFO_Add(&test_buffer, add_data, 17), NULL);
+        zassert_equal(FIFO_Peek(&test_buffer), add_data[0], NULL);
+        count = FIFO_Peek_Ahead(&test_buffer, pull_data, sizeof(pull_data));
+        zassert_equal(count, sizeof(add_data), NULL);
+        zassert_mem_equal(pull_data, add_data, sizeof(add_data), NULL);
+        count = FIFO_Pull(&test_buffer, pull_data, 5);
+        zassert_equal(count, 5, NULL);
+        zassert_mem_equal(pull_data, add_data, 5, NULL);
+        /* only the available bytes are pulled */
+        count = FIFO_Pull(&test_buffer, pull_data, sizeof(pull_data));
+        zassert_equal(count, sizeof(add_data) - 5, NULL);
+        zassert_mem_equal(pull_data, &add_data[5], count, NULL);
+        zassert_equal(FIFO_Pull(&test_buffer, pull_data, 1), 0, NULL);
+    }
+    /* pulled bytes may also be dropped */
+    status = FIFO_Add(&test_buffer, add_data, sizeof(add_data));
+    zassert_true(status, NULL);
+    count = FIFO_Pull(&test_buffer, NULL, 10);
+    zassert_equal(count, 10, NULL);
+    zassert_equal(FIFO_Get(&test_buffer), add_data[10], NULL);
+}
+
+/**
+ * @brief Time the bulk adds and pulls, as the MS/TP receive path uses
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(fifo_tests, testFIFOBenchmark)
+#else
+static void testFIFOBenchmark(void)
+#endif
+{
+    static FIFO_DATA_STORE(data_store, 4096);
+    FIFO_BUFFER test_buffer = { 0 };
+    uint8_t add_data[501] = { 0 };
+    uint8_t pull_data[501] = { 0 };
+    unsigned long bytes = 0;
+    unsigned count = 0;
+    unsigned i;
+    clock_t start;
+    double seconds;
+
+    for (i = 0; i < sizeof(add_data); i++) {
+        add_data[i] = (uint8_t)(i * 7 + 3);
+    }
+    FIFO_Init(&test_buffer, data_store, sizeof(data_store));
+    start = clock();
+    while (bytes < FIFO_BENCH_BYTES) {
+        zassert_true(FIFO_Add(&test_buffer, add_data, sizeof(add_data)), NULL);
+        count = FIFO_Pull(&test_buffer, pull_data, sizeof(pull_data));
+        zassert_equal(count, sizeof(pull_data), NULL);
+        bytes += count;
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    zassert_mem_equal(pull_data, add_data, sizeof(add_data), NULL);
+    if (seconds > 0.0) {
+        printf(
+            "FIFO_Add/FIFO_Pull %8.1f MB/s %8.2f ns/byte\n",
+            (double)bytes / seconds / 1000000.0,
+            seconds * 1000000000.0 / (double)bytes);
+    }
+}
 /**
  * @}
  */
@@ -172,7 +272,9 @@ ZTEST_SUITE(fifo_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(fifo_tests, ztest_unit_test(testFIFOBuffer));
+    ztest_test_suite(
+        fifo_tests, ztest_unit_test(testFIFOBuffer),
+        ztest_unit_test(testFIFOBulk), ztest_unit_test(testFIFOBenchmark));
 
     ztest_run_test_suite(fifo_tests);
 }
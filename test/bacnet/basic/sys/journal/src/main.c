@@ -0,0 +1,332 @@
+/**
+ * @file
+ * @brief test the append-only journal of property values
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/journal.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* two banks of flash that can only be programmed after an erase */
+#define TEST_BANK_SIZE 256
+static uint8_t Test_Flash[2][TEST_BANK_SIZE];
+static bool Test_Flash_Write_Fail;
+
+static bool test_flash_read(
+    void *context, unsigned bank, uint32_t offset, uint8_t *data, size_t length)
+{
+    (void)context;
+    if ((bank > 1) || (offset > TEST_BANK_SIZE) ||
+        (length > (TEST_BANK_SIZE - offset))) {
+        return false;
+    }
+    memcpy(data, &Test_Flash[bank][offset], length);
+
+    return true;
+}
+
+static bool test_flash_write(
+    void *context,
+    unsigned bank,
+    uint32_t offset,
+    const uint8_t *data,
+    size_t length)
+{
+    size_t i;
+
+    (void)context;
+    if (Test_Flash_Write_Fail || (bank > 1) || (offset > TEST_BANK_SIZE) ||
+        (length > (TEST_BANK_SIZE - offset))) {
+        return false;
+    }
+    for (i = 0; i < length; i++) {
+        /* flash is programmed once between erases */
+        zassert_equal(Test_Flash[bank][offset + i], 0xFF, NULL);
+        Test_Flash[bank][offset + i] = data[i];
+    }
+
+    return true;
+}
+
+static bool test_flash_erase(void *context, unsigned bank)
+{
+    (void)context;
+    if (bank > 1) {
+        return false;
+    }
+    memset(Test_Flash[bank], 0xFF, TEST_BANK_SIZE);
+
+    return true;
+}
+
+static const BACNET_JOURNAL_STORAGE Test_Storage = {
+    TEST_BANK_SIZE, test_flash_read, test_flash_write, test_flash_erase, NULL
+};
+
+/* the latest replayed value of a few properties */
+struct test_replay {
+    unsigned count;
+    uint32_t instance[8];
+    uint8_t value[8];
+    size_t value_len[8];
+};
+
+static void
+test_replay_callback(void *context, const BACNET_JOURNAL_RECORD *record)
+{
+    struct test_replay *replay = context;
+    unsigned index;
+
+    zassert_equal(record->object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(record->object_property, PROP_PRESENT_VALUE, NULL);
+    zassert_true(record->object_instance < 8, NULL);
+    index = record->object_instance;
+    replay->instance[index] = record->object_instance;
+    replay->value_len[index] = record->application_data_len;
+    if (record->application_data_len > 0) {
+        /* the first octet is enough to tell the values apart */
+        replay->value[index] = record->application_data[0];
+    }
+    replay->count++;
+}
+
+static bool test_journal_value_write(
+    BACNET_JOURNAL *journal, uint32_t instance, uint8_t value, size_t len)
+{
+    BACNET_JOURNAL_RECORD record = { 0 };
+    uint8_t data[BACNET_JOURNAL_DATA_MAX] = { 0 };
+
+    memset(data, value, sizeof(data));
+    record.object_type = OBJECT_ANALOG_VALUE;
+    record.object_instance = instance;
+    record.object_property = PROP_PRESENT_VALUE;
+    record.array_index = 8;
+    record.application_data = data;
+    record.application_data_len = len;
+
+    return bacnet_journal_write(journal, &record);
+}
+
+static void test_flash_init(void)
+{
+    memset(Test_Flash, 0xFF, sizeof(Test_Flash));
+    Test_Flash_Write_Fail = false;
+}
+
+/**
+ * @brief Test that values wait in RAM and are replayed after a restart
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(journal_tests, test_journal_write_replay)
+#else
+static void test_journal_write_replay(void)
+#endif
+{
+    static BACNET_JOURNAL journal;
+    struct test_replay replay = { 0 };
+    BACNET_JOURNAL_STORAGE storage = Test_Storage;
+
+    test_flash_init();
+    zassert_false(bacnet_journal_init(NULL, &Test_Storage), NULL);
+    zassert_false(bacnet_journal_init(&journal, NULL), NULL);
+    storage.bank_size = BACNET_JOURNAL_RECORD_SIZE_MAX;
+    zassert_false(bacnet_journal_init(&journal, &storage), NULL);
+    zassert_false(test_journal_value_write(&journal, 1, 0x11, 4), NULL);
+    /* empty flash becomes an empty journal */
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    zassert_equal(journal.erase_count, 1, NULL);
+    zassert_equal(
+        bacnet_journal_replay(&journal, test_replay_callback, &replay), 0,
+        NULL);
+    zassert_true(test_journal_value_write(&journal, 1, 0x11, 4), NULL);
+    zassert_true(test_journal_value_write(&journal, 2, 0x22, 5), NULL);
+    zassert_true(test_journal_value_write(&journal, 3, 0x33, 0), NULL);
+    zassert_false(
+        test_journal_value_write(
+            &journal, 4, 0x44, BACNET_JOURNAL_DATA_MAX + 1),
+        NULL);
+    zassert_equal(journal.dropped_count, 1, NULL);
+    zassert_equal(
+        bacnet_journal_pending(&journal),
+        BACNET_JOURNAL_RECORD_SIZE(4) + BACNET_JOURNAL_RECORD_SIZE(5) +
+            BACNET_JOURNAL_RECORD_SIZE(0),
+        NULL);
+    /* nothing is programmed until the oldest value has waited */
+    bacnet_journal_task(&journal, BACNET_JOURNAL_FLUSH_MS - 1);
+    zassert_equal(journal.flush_count, 0, NULL);
+    bacnet_journal_task(&journal, 1);
+    zassert_equal(journal.flush_count, 1, NULL);
+    zassert_equal(bacnet_journal_pending(&journal), 0, NULL);
+    /* restart */
+    memset(&journal, 0, sizeof(journal));
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    zassert_equal(journal.erase_count, 0, NULL);
+    zassert_false(journal.sealed, NULL);
+    zassert_equal(
+        bacnet_journal_replay(&journal, test_replay_callback, &replay), 3,
+        NULL);
+    zassert_equal(replay.value[1], 0x11, NULL);
+    zassert_equal(replay.value_len[1], 4, NULL);
+    zassert_equal(replay.value[2], 0x22, NULL);
+    zassert_equal(replay.value_len[2], 5, NULL);
+    zassert_equal(replay.value_len[3], 0, NULL);
+}
+
+/**
+ * @brief Test that a newer value replaces an older one in RAM
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(journal_tests, test_journal_coalesce)
+#else
+static void test_journal_coalesce(void)
+#endif
+{
+    static BACNET_JOURNAL journal;
+    struct test_replay replay = { 0 };
+    uint32_t instance = 0;
+
+    test_flash_init();
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    zassert_true(test_journal_value_write(&journal, 1, 0x10, 4), NULL);
+    zassert_true(test_journal_value_write(&journal, 2, 0x20, 4), NULL);
+    zassert_true(test_journal_value_write(&journal, 1, 0x11, 8), NULL);
+    zassert_true(test_journal_value_write(&journal, 1, 0x12, 2), NULL);
+    zassert_equal(
+        bacnet_journal_pending(&journal),
+        BACNET_JOURNAL_RECORD_SIZE(4) + BACNET_JOURNAL_RECORD_SIZE(2), NULL);
+    zassert_true(bacnet_journal_flush(&journal), NULL);
+    zassert_true(bacnet_journal_flush(&journal), NULL);
+    zassert_equal(journal.flush_count, 1, NULL);
+    zassert_equal(
+        bacnet_journal_replay(&journal, test_replay_callback, &replay), 2,
+        NULL);
+    zassert_equal(replay.value[1], 0x12, NULL);
+    zassert_equal(replay.value_len[1], 2, NULL);
+    zassert_equal(replay.value[2], 0x20, NULL);
+    /* a full cache is programmed to make room */
+    while (journal.flush_count == 1) {
+        zassert_true(instance < 100, NULL);
+        instance++;
+        zassert_true(
+            test_journal_value_write(&journal, instance, 0x30, 8), NULL);
+    }
+    zassert_true(bacnet_journal_pending(&journal) > 0, NULL);
+}
+
+/**
+ * @brief Test that a full bank moves the latest values to the other bank
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(journal_tests, test_journal_compact)
+#else
+static void test_journal_compact(void)
+#endif
+{
+    static BACNET_JOURNAL journal;
+    struct test_replay replay = { 0 };
+    unsigned i;
+    unsigned bank;
+
+    test_flash_init();
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    bank = journal.bank;
+    for (i = 0; i < 40; i++) {
+        zassert_true(
+            test_journal_value_write(&journal, 1 + (i % 2), (uint8_t)i, 4),
+            NULL);
+        zassert_true(bacnet_journal_flush(&journal), NULL);
+    }
+    zassert_true(journal.erase_count > 1, NULL);
+    zassert_true(journal.sequence > 1, NULL);
+    /* restart */
+    memset(&journal, 0, sizeof(journal));
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    zassert_true((journal.bank == bank) || (journal.bank == (bank ^ 1)), NULL);
+    (void)bacnet_journal_replay(&journal, test_replay_callback, &replay);
+    zassert_true(replay.count <= 12, NULL);
+    zassert_equal(replay.value[1], 38, NULL);
+    zassert_equal(replay.value[2], 39, NULL);
+}
+
+/**
+ * @brief Test that a partly programmed record is not programmed over
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(journal_tests, test_journal_power_failure)
+#else
+static void test_journal_power_failure(void)
+#endif
+{
+    static BACNET_JOURNAL journal;
+    struct test_replay replay = { 0 };
+    uint32_t offset;
+
+    test_flash_init();
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    zassert_true(test_journal_value_write(&journal, 1, 0x11, 4), NULL);
+    zassert_true(test_journal_value_write(&journal, 2, 0x22, 4), NULL);
+    zassert_true(bacnet_journal_flush(&journal), NULL);
+    /* the power failed while the next record was programmed */
+    offset = journal.offset;
+    Test_Flash[journal.bank][offset] = 0x00;
+    Test_Flash[journal.bank][offset + 1] = 0x04;
+    Test_Flash[journal.bank][offset + 2] = 0x00;
+    memset(&journal, 0, sizeof(journal));
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    zassert_true(journal.sealed, NULL);
+    zassert_equal(journal.offset, offset, NULL);
+    zassert_equal(
+        bacnet_journal_replay(&journal, test_replay_callback, &replay), 2,
+        NULL);
+    /* the next flush moves to the other bank */
+    zassert_true(test_journal_value_write(&journal, 2, 0x23, 4), NULL);
+    zassert_true(bacnet_journal_flush(&journal), NULL);
+    zassert_false(journal.sealed, NULL);
+    memset(&journal, 0, sizeof(journal));
+    memset(&replay, 0, sizeof(replay));
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    zassert_equal(
+        bacnet_journal_replay(&journal, test_replay_callback, &replay), 2,
+        NULL);
+    zassert_equal(replay.value[1], 0x11, NULL);
+    zassert_equal(replay.value[2], 0x23, NULL);
+    /* a failed write keeps the values in RAM for another try */
+    zassert_true(test_journal_value_write(&journal, 1, 0x12, 4), NULL);
+    Test_Flash_Write_Fail = true;
+    zassert_false(bacnet_journal_flush(&journal), NULL);
+    zassert_true(bacnet_journal_pending(&journal) > 0, NULL);
+    Test_Flash_Write_Fail = false;
+    zassert_true(bacnet_journal_flush(&journal), NULL);
+    memset(&journal, 0, sizeof(journal));
+    memset(&replay, 0, sizeof(replay));
+    zassert_true(bacnet_journal_init(&journal, &Test_Storage), NULL);
+    (void)bacnet_journal_replay(&journal, test_replay_callback, &replay);
+    zassert_equal(replay.value[1], 0x12, NULL);
+    zassert_equal(replay.value[2], 0x23, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(journal_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        journal_tests, ztest_unit_test(test_journal_write_replay),
+        ztest_unit_test(test_journal_coalesce),
+        ztest_unit_test(test_journal_compact),
+        ztest_unit_test(test_journal_power_failure));
+
+    ztest_run_test_suite(journal_tests);
+}
+#endif
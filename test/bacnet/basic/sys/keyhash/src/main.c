@@ -0,0 +1,153 @@
+/**
+ * @file
+ * @brief test Key Hash index API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/keyhash.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test adding, finding, and removing hash and key pairs
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(keyhash_tests, testKeyHashBasic)
+#else
+static void testKeyHashBasic(void)
+#endif
+{
+    OS_Keyhash list;
+    unsigned iterator = 0;
+    KEY key = 0;
+    bool status;
+
+    list = Keyhash_Create();
+    zassert_not_null(list, NULL);
+    zassert_equal(Keyhash_Count(list), 0, NULL);
+    status = Keyhash_Find(list, 1, &iterator, &key);
+    zassert_false(status, NULL);
+
+    status = Keyhash_Add(list, 1, 100);
+    zassert_true(status, NULL);
+    status = Keyhash_Add(list, 1, 100);
+    zassert_true(status, NULL);
+    zassert_equal(Keyhash_Count(list), 1, NULL);
+    /* same hash, different key */
+    status = Keyhash_Add(list, 1, 101);
+    zassert_true(status, NULL);
+    status = Keyhash_Add(list, 2, 100);
+    zassert_true(status, NULL);
+    zassert_equal(Keyhash_Count(list), 3, NULL);
+    zassert_true(Keyhash_Member(list, 1, 100), NULL);
+    zassert_true(Keyhash_Member(list, 1, 101), NULL);
+    zassert_true(Keyhash_Member(list, 2, 100), NULL);
+    zassert_false(Keyhash_Member(list, 2, 101), NULL);
+
+    /* both keys with hash 1 are found */
+    iterator = 0;
+    status = Keyhash_Find(list, 1, &iterator, &key);
+    zassert_true(status, NULL);
+    zassert_true((key == 100) || (key == 101), NULL);
+    status = Keyhash_Find(list, 1, &iterator, &key);
+    zassert_true(status, NULL);
+    zassert_true((key == 100) || (key == 101), NULL);
+    status = Keyhash_Find(list, 1, &iterator, &key);
+    zassert_false(status, NULL);
+
+    status = Keyhash_Remove(list, 1, 100);
+    zassert_true(status, NULL);
+    status = Keyhash_Remove(list, 1, 100);
+    zassert_false(status, NULL);
+    zassert_false(Keyhash_Member(list, 1, 100), NULL);
+    zassert_true(Keyhash_Member(list, 1, 101), NULL);
+    zassert_equal(Keyhash_Count(list), 2, NULL);
+    iterator = 0;
+    status = Keyhash_Find(list, 1, &iterator, &key);
+    zassert_true(status, NULL);
+    zassert_equal(key, 101, NULL);
+
+    Keyhash_Clear(list);
+    zassert_equal(Keyhash_Count(list), 0, NULL);
+    zassert_false(Keyhash_Member(list, 1, 101), NULL);
+    Keyhash_Delete(list);
+}
+
+/**
+ * @brief Test growing the index and reusing deleted entries
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(keyhash_tests, testKeyHashLarge)
+#else
+static void testKeyHashLarge(void)
+#endif
+{
+    OS_Keyhash list;
+    const unsigned num_keys = 4096;
+    unsigned i, pass;
+    bool status;
+
+    list = Keyhash_Create();
+    zassert_not_null(list, NULL);
+    for (pass = 0; pass < 3; pass++) {
+        for (i = 0; i < num_keys; i++) {
+            status = Keyhash_Add(list, i * 7, KEY_ENCODE(pass, i));
+            zassert_true(status, NULL);
+        }
+        zassert_equal(Keyhash_Count(list), num_keys, NULL);
+        for (i = 0; i < num_keys; i++) {
+            zassert_true(
+                Keyhash_Member(list, i * 7, KEY_ENCODE(pass, i)), NULL);
+        }
+        /* remove every other one, then the rest */
+        for (i = 0; i < num_keys; i += 2) {
+            status = Keyhash_Remove(list, i * 7, KEY_ENCODE(pass, i));
+            zassert_true(status, NULL);
+        }
+        zassert_equal(Keyhash_Count(list), num_keys / 2, NULL);
+        for (i = 1; i < num_keys; i += 2) {
+            zassert_true(
+                Keyhash_Member(list, i * 7, KEY_ENCODE(pass, i)), NULL);
+            status = Keyhash_Remove(list, i * 7, KEY_ENCODE(pass, i));
+            zassert_true(status, NULL);
+        }
+        zassert_equal(Keyhash_Count(list), 0, NULL);
+    }
+    Keyhash_Delete(list);
+}
+
+/**
+ * @brief Test the FNV-1a hash function
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(keyhash_tests, testKeyHashFNV1a)
+#else
+static void testKeyHashFNV1a(void)
+#endif
+{
+    /* published FNV-1a 32-bit test vectors */
+    zassert_equal(Keyhash_FNV1a("", 0), 0x811c9dc5UL, NULL);
+    zassert_equal(Keyhash_FNV1a("a", 1), 0xe40c292cUL, NULL);
+    zassert_equal(Keyhash_FNV1a("foobar", 6), 0xbf9cf968UL, NULL);
+    zassert_equal(Keyhash_FNV1a(NULL, 6), 0x811c9dc5UL, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(keyhash_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        keyhash_tests, ztest_unit_test(testKeyHashBasic),
+        ztest_unit_test(testKeyHashLarge), ztest_unit_test(testKeyHashFNV1a));
+
+    ztest_run_test_suite(keyhash_tests);
+}
+#endif
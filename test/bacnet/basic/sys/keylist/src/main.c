@@ -155,6 +155,14 @@ static void testKeyListDataKey(void)
 
     zassert_equal(Keylist_Count(list), 3, NULL);
 
+    /* index lookup with a hint */
+    zassert_equal(Keylist_Index_Hint(list, 2, 1), 1, NULL);
+    zassert_equal(Keylist_Index_Hint(list, 3, 0), 2, NULL);
+    zassert_equal(Keylist_Index_Hint(list, 1, -1), 0, NULL);
+    zassert_equal(Keylist_Index_Hint(list, 1, 3), 0, NULL);
+    zassert_equal(Keylist_Index_Hint(list, 4, 2), -1, NULL);
+    zassert_equal(Keylist_Index_Hint(NULL, 1, 0), -1, NULL);
+
     /* look at the data */
     key = 2;
     data = Keylist_Data(list, key);
@@ -311,6 +319,52 @@ static void testKeyListLarge(void)
     return;
 }
 
+/* test the sorted order with growing and shrinking the list */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(keylist_tests, testKeyListGrowShrink)
+#else
+static void testKeyListGrowShrink(void)
+#endif
+{
+    static int data_list[4096];
+    int *data;
+    OS_Keylist list;
+    KEY key, prior_key;
+    int index;
+    const int num_keys = 4096;
+
+    list = Keylist_Create();
+    zassert_not_null(list, NULL);
+    /* add in descending order, which inserts at the front */
+    for (index = num_keys - 1; index >= 0; index--) {
+        data_list[index] = index;
+        Keylist_Data_Add(list, (KEY)index * 2, &data_list[index]);
+    }
+    zassert_equal(Keylist_Count(list), num_keys, NULL);
+    /* delete most of them, which shrinks the list */
+    for (index = 0; index < (num_keys - (num_keys / 8)); index++) {
+        data = Keylist_Data_Delete(list, (KEY)index * 2);
+        zassert_not_null(data, NULL);
+        zassert_equal(*data, index, NULL);
+    }
+    zassert_equal(Keylist_Count(list), num_keys / 8, NULL);
+    zassert_true(list->size < num_keys, NULL);
+    /* the rest are still sorted and found */
+    prior_key = 0;
+    for (index = 0; index < Keylist_Count(list); index++) {
+        zassert_true(Keylist_Index_Key(list, index, &key), NULL);
+        zassert_true(key > prior_key, NULL);
+        prior_key = key;
+        data = Keylist_Data(list, key);
+        zassert_not_null(data, NULL);
+        zassert_equal((KEY)*data * 2, key, NULL);
+    }
+    key = (KEY)(num_keys - 1) * 2;
+    zassert_equal(Keylist_Next_Empty_Key(list, key), key + 1, NULL);
+    zassert_equal(Keylist_Next_Empty_Key(list, 0), 0, NULL);
+    Keylist_Delete(list);
+}
+
 /* test the encode and decode macros */
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(keylist_tests, testKeySample)
@@ -343,6 +397,39 @@ static void testKeySample(void)
 
     return;
 }
+
+/**
+ * @brief Test reserving room in the list before adding nodes
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(keylist_tests, testKeyListReserve)
+#else
+static void testKeyListReserve(void)
+#endif
+{
+    static int data_list[1000];
+    OS_Keylist list;
+    int index;
+    const int num_keys = 1000;
+
+    list = Keylist_Create();
+    zassert_not_null(list, NULL);
+    zassert_false(Keylist_Reserve(NULL, num_keys), NULL);
+    zassert_false(Keylist_Reserve(list, -1), NULL);
+    zassert_true(Keylist_Reserve(list, num_keys), NULL);
+    zassert_equal(list->size, num_keys, NULL);
+    /* the reserved room is not given back while adding */
+    for (index = 0; index < num_keys; index++) {
+        data_list[index] = index;
+        Keylist_Data_Add(list, (KEY)index, &data_list[index]);
+        zassert_equal(list->size, num_keys, NULL);
+    }
+    zassert_equal(Keylist_Count(list), num_keys, NULL);
+    /* a smaller reservation does not shrink the list */
+    zassert_true(Keylist_Reserve(list, 1), NULL);
+    zassert_equal(list->size, num_keys, NULL);
+    Keylist_Delete(list);
+}
 /**
  * @}
  */
@@ -356,7 +443,9 @@ void test_main(void)
         keylist_tests, ztest_unit_test(testKeyListFIFO),
         ztest_unit_test(testKeyListFILO), ztest_unit_test(testKeyListDataKey),
         ztest_unit_test(testKeyListDataIndex),
-        ztest_unit_test(testKeyListLarge), ztest_unit_test(testKeySample));
+        ztest_unit_test(testKeyListLarge),
+        ztest_unit_test(testKeyListGrowShrink),
+        ztest_unit_test(testKeyListReserve), ztest_unit_test(testKeySample));
 
     ztest_run_test_suite(keylist_tests);
 }
@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @brief test the memory accounting API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/keylist.h>
+#include <bacnet/basic/sys/memstat.h>
+#include <bacnet/basic/sys/slab.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the accounts of the subsystems and object types
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(memstat_tests, testMemstatAccounts)
+#else
+static void testMemstatAccounts(void)
+#endif
+{
+    MEMSTAT_USAGE usage = { 0 };
+    static uint8_t table[100];
+    size_t total;
+    bool status;
+
+    total = memstat_total();
+    memstat_alloc(MEMSTAT_COV, 100);
+    memstat_alloc(MEMSTAT_COV, 50);
+    memstat_free(MEMSTAT_COV, 100);
+    status = memstat_subsystem(MEMSTAT_COV, &usage);
+    zassert_true(status, NULL);
+    zassert_equal(usage.heap, 50, NULL);
+    zassert_equal(usage.peak, 150, NULL);
+    memstat_reset();
+    memstat_subsystem(MEMSTAT_COV, &usage);
+    zassert_equal(usage.peak, 50, NULL);
+    /* freeing more than was allocated stops at zero */
+    memstat_free(MEMSTAT_COV, 100);
+    memstat_subsystem(MEMSTAT_COV, &usage);
+    zassert_equal(usage.heap, 0, NULL);
+    /* a static table is only accounted once */
+    memstat_fixed(MEMSTAT_TSM, table, sizeof(table));
+    memstat_fixed(MEMSTAT_TSM, table, sizeof(table));
+    memstat_subsystem(MEMSTAT_TSM, &usage);
+    zassert_equal(usage.fixed, sizeof(table), NULL);
+    zassert_equal(memstat_total(), total + sizeof(table), NULL);
+    /* an object type is also in the object subsystem */
+    memstat_alloc(MEMSTAT_ACCOUNT_OBJECT(OBJECT_ANALOG_VALUE), 64);
+    memstat_object_type(OBJECT_ANALOG_VALUE, &usage);
+    zassert_equal(usage.heap, 64, NULL);
+    memstat_subsystem(MEMSTAT_OBJECT, &usage);
+    zassert_equal(usage.heap, 64, NULL);
+    memstat_free(MEMSTAT_ACCOUNT_OBJECT(OBJECT_ANALOG_VALUE), 64);
+    memstat_subsystem(MEMSTAT_OBJECT, &usage);
+    zassert_equal(usage.heap, 0, NULL);
+    status = memstat_object_type(OBJECT_PROPRIETARY_MIN, &usage);
+    zassert_false(status, NULL);
+    status = memstat_subsystem(MEMSTAT_SUBSYSTEM_MAX, &usage);
+    zassert_false(status, NULL);
+    zassert_equal(strcmp(memstat_subsystem_name(MEMSTAT_LOG), "log"), 0, NULL);
+    zassert_equal(
+        strcmp(memstat_subsystem_name(MEMSTAT_SUBSYSTEM_MAX), "unknown"), 0,
+        NULL);
+}
+
+/**
+ * @brief Test the accounting of the Slab pools and the Keylists
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(memstat_tests, testMemstatPools)
+#else
+static void testMemstatPools(void)
+#endif
+{
+    SLAB_TYPE slab = SLAB_ACCOUNT_INITIALIZER(
+        32, MEMSTAT_ACCOUNT_OBJECT(OBJECT_BINARY_VALUE));
+    MEMSTAT_USAGE usage = { 0 };
+    OS_Keylist list;
+    void *item[4];
+    size_t bytes;
+    unsigned i;
+
+    for (i = 0; i < 4; i++) {
+        item[i] = Slab_Item_Alloc(&slab);
+        zassert_not_null(item[i], NULL);
+    }
+    memstat_object_type(OBJECT_BINARY_VALUE, &usage);
+    zassert_true(usage.heap >= 4 * 32, NULL);
+    for (i = 0; i < 4; i++) {
+        Slab_Free(&slab, item[i]);
+    }
+    memstat_object_type(OBJECT_BINARY_VALUE, &usage);
+    zassert_equal(usage.heap, 0, NULL);
+    Slab_Reserve(&slab, 8);
+    memstat_object_type(OBJECT_BINARY_VALUE, &usage);
+    zassert_true(usage.heap >= 8 * 32, NULL);
+    Slab_Cleanup(&slab);
+    memstat_object_type(OBJECT_BINARY_VALUE, &usage);
+    zassert_equal(usage.heap, 0, NULL);
+    /* the Keylist grows and shrinks its node array */
+    list = Keylist_Create();
+    memstat_subsystem(MEMSTAT_KEYLIST, &usage);
+    bytes = usage.heap;
+    zassert_true(bytes > 0, NULL);
+    for (i = 0; i < 100; i++) {
+        Keylist_Data_Add(list, i, &usage);
+    }
+    memstat_subsystem(MEMSTAT_KEYLIST, &usage);
+    zassert_true(usage.heap > bytes, NULL);
+    Keylist_Delete(list);
+    memstat_subsystem(MEMSTAT_KEYLIST, &usage);
+    zassert_equal(usage.heap, 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(memstat_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        memstat_tests, ztest_unit_test(testMemstatAccounts),
+        ztest_unit_test(testMemstatPools));
+
+    ztest_run_test_suite(memstat_tests);
+}
+#endif
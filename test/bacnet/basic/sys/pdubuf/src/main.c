@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief test reference counted PDU buffer API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/pdubuf.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test encoding a PDU and prepending headers in place
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(pdubuf_tests, testPDUBuffer)
+#else
+static void testPDUBuffer(void)
+#endif
+{
+    const uint8_t npdu[] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF, 0x10, 0x08 };
+    const uint8_t bvlc[] = { 0x81, 0x0A, 0x00, 0x0C };
+    PDU_BUFFER *buf;
+    uint8_t *pdu;
+
+    zassert_is_null(pdubuf_alloc(PDUBUF_SIZE + 1), NULL);
+    buf = pdubuf_alloc(PDUBUF_HEADROOM);
+    zassert_not_null(buf, NULL);
+    zassert_equal(pdubuf_refcount(buf), 1, NULL);
+    zassert_equal(pdubuf_length(buf), 0, NULL);
+    zassert_equal(pdubuf_headroom(buf), PDUBUF_HEADROOM, NULL);
+    zassert_equal(pdubuf_tailroom(buf), PDUBUF_SIZE - PDUBUF_HEADROOM, NULL);
+    /* encode the NPDU at the tail */
+    pdu = pdubuf_tail(buf);
+    memcpy(pdu, npdu, sizeof(npdu));
+    zassert_equal(pdubuf_put(buf, sizeof(npdu)), pdu, NULL);
+    zassert_equal(pdubuf_data(buf), pdu, NULL);
+    zassert_equal(pdubuf_length(buf), sizeof(npdu), NULL);
+    zassert_is_null(pdubuf_put(buf, pdubuf_tailroom(buf) + 1), NULL);
+    /* prepend a header without moving the NPDU */
+    zassert_is_null(pdubuf_push(buf, PDUBUF_HEADROOM + 1), NULL);
+    zassert_equal(pdubuf_push(buf, sizeof(bvlc)), pdu - sizeof(bvlc), NULL);
+    memcpy(pdubuf_data(buf), bvlc, sizeof(bvlc));
+    zassert_equal(pdubuf_length(buf), sizeof(bvlc) + sizeof(npdu), NULL);
+    zassert_equal(pdubuf_headroom(buf), PDUBUF_HEADROOM - sizeof(bvlc), NULL);
+    zassert_equal(memcmp(&pdubuf_data(buf)[4], npdu, sizeof(npdu)), 0, NULL);
+    /* remove the header, as on receipt */
+    zassert_equal(pdubuf_pull(buf, sizeof(bvlc)), pdu, NULL);
+    zassert_equal(pdubuf_length(buf), sizeof(npdu), NULL);
+    zassert_is_null(pdubuf_pull(buf, sizeof(npdu) + 1), NULL);
+    zassert_false(pdubuf_trim(buf, sizeof(npdu) + 1), NULL);
+    zassert_true(pdubuf_trim(buf, 2), NULL);
+    zassert_equal(pdubuf_length(buf), 2, NULL);
+    pdubuf_unref(buf);
+    zassert_equal(pdubuf_refcount(buf), 0, NULL);
+    zassert_equal(pdubuf_free_count(), PDUBUF_POOL_SIZE, NULL);
+    /* NULL buffers */
+    zassert_is_null(pdubuf_data(NULL), NULL);
+    zassert_is_null(pdubuf_tail(NULL), NULL);
+    zassert_is_null(pdubuf_put(NULL, 1), NULL);
+    zassert_is_null(pdubuf_push(NULL, 1), NULL);
+    zassert_is_null(pdubuf_pull(NULL, 1), NULL);
+    zassert_is_null(pdubuf_put(NULL, 0), NULL);
+    zassert_is_null(pdubuf_push(NULL, 0), NULL);
+    zassert_is_null(pdubuf_pull(NULL, 0), NULL);
+    zassert_false(pdubuf_trim(NULL, 0), NULL);
+    zassert_equal(pdubuf_length(NULL), 0, NULL);
+    zassert_equal(pdubuf_refcount(NULL), 0, NULL);
+    pdubuf_unref(NULL);
+}
+
+/**
+ * @brief Test the references and the pool
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(pdubuf_tests, testPDUBufferPool)
+#else
+static void testPDUBufferPool(void)
+#endif
+{
+    PDU_BUFFER *buf[PDUBUF_POOL_SIZE];
+    unsigned i;
+
+    for (i = 0; i < PDUBUF_POOL_SIZE; i++) {
+        buf[i] = pdubuf_alloc(0);
+        zassert_not_null(buf[i], NULL);
+    }
+    zassert_equal(pdubuf_free_count(), 0, NULL);
+    zassert_is_null(pdubuf_alloc(0), NULL);
+    /* a queued buffer is kept until the last reference is released */
+    zassert_equal(pdubuf_ref(buf[0]), buf[0], NULL);
+    zassert_equal(pdubuf_refcount(buf[0]), 2, NULL);
+    pdubuf_unref(buf[0]);
+    zassert_equal(pdubuf_free_count(), 0, NULL);
+    pdubuf_unref(buf[0]);
+    zassert_equal(pdubuf_free_count(), 1, NULL);
+    /* a released buffer can not be referenced again */
+    zassert_is_null(pdubuf_ref(buf[0]), NULL);
+    zassert_equal(pdubuf_alloc(0), buf[0], NULL);
+    for (i = 0; i < PDUBUF_POOL_SIZE; i++) {
+        pdubuf_unref(buf[i]);
+    }
+    zassert_equal(pdubuf_free_count(), PDUBUF_POOL_SIZE, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(pdubuf_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        pdubuf_tests, ztest_unit_test(testPDUBuffer),
+        ztest_unit_test(testPDUBufferPool));
+
+    ztest_run_test_suite(pdubuf_tests);
+}
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file
+ * @brief test the performance counters and latency histograms API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/perfstat.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static uint32_t Test_Clock;
+
+static uint32_t test_clock(void)
+{
+    return Test_Clock;
+}
+
+/**
+ * @brief Test the histogram buckets and their limits
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(perfstat_tests, testPerfstatBuckets)
+#else
+static void testPerfstatBuckets(void)
+#endif
+{
+    unsigned index;
+    uint32_t value;
+
+    /* the small values have a bucket each */
+    for (value = 0; value < (2U * PERFSTAT_HISTOGRAM_SUB_BUCKETS); value++) {
+        zassert_equal(perfstat_histogram_bucket(value), value, NULL);
+        zassert_equal(perfstat_histogram_bucket_limit(value), value, NULL);
+    }
+    /* each bucket starts after the limit of the one before */
+    for (index = 1; index < PERFSTAT_HISTOGRAM_BUCKETS; index++) {
+        value = perfstat_histogram_bucket_limit(index - 1);
+        zassert_true(value < perfstat_histogram_bucket_limit(index), NULL);
+        zassert_equal(perfstat_histogram_bucket(value), index - 1, NULL);
+        zassert_equal(perfstat_histogram_bucket(value + 1U), index, NULL);
+    }
+    zassert_equal(
+        perfstat_histogram_bucket(UINT32_MAX), PERFSTAT_HISTOGRAM_BUCKETS - 1,
+        NULL);
+    zassert_equal(
+        perfstat_histogram_bucket_limit(PERFSTAT_HISTOGRAM_BUCKETS - 1),
+        UINT32_MAX, NULL);
+    zassert_equal(
+        perfstat_histogram_bucket_limit(PERFSTAT_HISTOGRAM_BUCKETS),
+        UINT32_MAX, NULL);
+}
+
+/**
+ * @brief Test recording values and estimating percentiles
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(perfstat_tests, testPerfstatHistogram)
+#else
+static void testPerfstatHistogram(void)
+#endif
+{
+    PERFSTAT_HISTOGRAM histogram = { 0 };
+    uint32_t value;
+
+    zassert_equal(perfstat_histogram_percentile(&histogram, 50), 0, NULL);
+    zassert_equal(perfstat_histogram_percentile(NULL, 50), 0, NULL);
+    perfstat_histogram_record(NULL, 1);
+    for (value = 1; value <= 100; value++) {
+        perfstat_histogram_record(&histogram, value);
+    }
+    zassert_equal(histogram.count, 100, NULL);
+    zassert_equal(histogram.max, 100, NULL);
+    zassert_equal(histogram.sum, 5050, NULL);
+    /* the estimate is the limit of the bucket holding the percentile */
+    value = perfstat_histogram_percentile(&histogram, 50);
+    zassert_true(value >= 50, NULL);
+    zassert_true(value < (50 + (50 / PERFSTAT_HISTOGRAM_SUB_BUCKETS)), NULL);
+    zassert_equal(perfstat_histogram_percentile(&histogram, 0), 1, NULL);
+    zassert_equal(perfstat_histogram_percentile(&histogram, 100), 100, NULL);
+    zassert_equal(perfstat_histogram_percentile(&histogram, 200), 100, NULL);
+    /* the tail of the values, in tenths of a percent */
+    for (value = 1; value <= 900; value++) {
+        perfstat_histogram_record(&histogram, 1);
+    }
+    perfstat_histogram_record(&histogram, 5000);
+    zassert_equal(perfstat_histogram_permille(&histogram, 900), 1, NULL);
+    value = perfstat_histogram_permille(&histogram, 990);
+    zassert_true(value >= 90, NULL);
+    zassert_true(value <= 100, NULL);
+    zassert_equal(perfstat_histogram_permille(&histogram, 1000), 5000, NULL);
+    zassert_equal(perfstat_histogram_permille(NULL, 999), 0, NULL);
+}
+
+/**
+ * @brief Test the counters, the snapshot, and the reset
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(perfstat_tests, testPerfstatCounters)
+#else
+static void testPerfstatCounters(void)
+#endif
+{
+    PERFSTAT_DATA data = { 0 };
+
+    perfstat_reset();
+    PERFSTAT_COUNT(PERFSTAT_DECODE_ERRORS);
+    PERFSTAT_COUNT_ADD(PERFSTAT_COV_NOTIFICATIONS, 3);
+    PERFSTAT_COUNT(PERFSTAT_COUNTER_MAX);
+    PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_BIP);
+    PERFSTAT_DATALINK_RECEIVE(PERFSTAT_DATALINK_BIP);
+    PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_MSTP);
+    PERFSTAT_DATALINK_SEND(PERFSTAT_DATALINK_MAX);
+    PERFSTAT_DATALINK_FORWARD(PERFSTAT_DATALINK_BIP6, 4);
+    perfstat_snapshot(&data);
+    zassert_equal(data.counter[PERFSTAT_DECODE_ERRORS], 1, NULL);
+    zassert_equal(data.counter[PERFSTAT_COV_NOTIFICATIONS], 3, NULL);
+    zassert_equal(data.counter[PERFSTAT_TSM_TIMEOUTS], 0, NULL);
+    zassert_equal(data.datalink_receive[PERFSTAT_DATALINK_BIP], 2, NULL);
+    zassert_equal(data.datalink_send[PERFSTAT_DATALINK_BIP], 0, NULL);
+    zassert_equal(data.datalink_send[PERFSTAT_DATALINK_MSTP], 1, NULL);
+    zassert_equal(data.datalink_forward[PERFSTAT_DATALINK_BIP6], 4, NULL);
+    /* the same counters without a snapshot */
+    zassert_equal(perfstat_counter(PERFSTAT_COV_NOTIFICATIONS), 3, NULL);
+    zassert_equal(perfstat_counter(PERFSTAT_COUNTER_MAX), 0, NULL);
+    zassert_equal(
+        perfstat_datalink_receive_count(PERFSTAT_DATALINK_BIP), 2, NULL);
+    zassert_equal(
+        perfstat_datalink_send_count(PERFSTAT_DATALINK_MSTP), 1, NULL);
+    zassert_equal(
+        perfstat_datalink_forward_count(PERFSTAT_DATALINK_BIP6), 4, NULL);
+    zassert_equal(
+        perfstat_datalink_receive_count(PERFSTAT_DATALINK_MAX), 0, NULL);
+    perfstat_snapshot(NULL);
+    perfstat_reset();
+    perfstat_snapshot(&data);
+    zassert_equal(data.counter[PERFSTAT_DECODE_ERRORS], 0, NULL);
+    zassert_equal(data.datalink_receive[PERFSTAT_DATALINK_BIP], 0, NULL);
+}
+
+/**
+ * @brief Test the service request counters and their latency
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(perfstat_tests, testPerfstatServices)
+#else
+static void testPerfstatServices(void)
+#endif
+{
+    PERFSTAT_DATA data = { 0 };
+    uint32_t start;
+
+    perfstat_reset();
+    /* without a clock, the requests are only counted */
+    perfstat_clock_set(NULL);
+    zassert_equal(perfstat_clock(), 0, NULL);
+    perfstat_confirmed_service(SERVICE_CONFIRMED_READ_PROPERTY, 0);
+    perfstat_snapshot(&data);
+    zassert_equal(
+        data.confirmed[SERVICE_CONFIRMED_READ_PROPERTY].requests, 1, NULL);
+    zassert_equal(
+        data.confirmed[SERVICE_CONFIRMED_READ_PROPERTY].latency.count, 0,
+        NULL);
+    /* with a clock, the time in the handler is recorded */
+    perfstat_clock_set(test_clock);
+    Test_Clock = UINT32_MAX - 5;
+    start = perfstat_clock();
+    Test_Clock += 20;
+    perfstat_confirmed_service(SERVICE_CONFIRMED_READ_PROPERTY, start);
+    start = perfstat_clock();
+    Test_Clock += 7;
+    perfstat_unconfirmed_service(SERVICE_UNCONFIRMED_WHO_IS, start);
+    perfstat_unconfirmed_service(MAX_BACNET_UNCONFIRMED_SERVICE, start);
+    perfstat_confirmed_service(MAX_BACNET_CONFIRMED_SERVICE, start);
+    perfstat_snapshot(&data);
+    zassert_equal(
+        data.confirmed[SERVICE_CONFIRMED_READ_PROPERTY].requests, 2, NULL);
+    zassert_equal(
+        data.confirmed[SERVICE_CONFIRMED_READ_PROPERTY].latency.count, 1,
+        NULL);
+    zassert_equal(
+        data.confirmed[SERVICE_CONFIRMED_READ_PROPERTY].latency.max, 20,
+        NULL);
+    zassert_equal(
+        data.unconfirmed[SERVICE_UNCONFIRMED_WHO_IS].requests, 1, NULL);
+    zassert_equal(
+        data.unconfirmed[SERVICE_UNCONFIRMED_WHO_IS].latency.sum, 7, NULL);
+    zassert_equal(perfstat_confirmed_requests(), 2, NULL);
+    zassert_equal(perfstat_unconfirmed_requests(), 1, NULL);
+    perfstat_clock_set(NULL);
+}
+
+/**
+ * @brief Test the MS/TP token rotation time
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(perfstat_tests, testPerfstatTokenRotation)
+#else
+static void testPerfstatTokenRotation(void)
+#endif
+{
+    PERFSTAT_DATA data = { 0 };
+
+    perfstat_reset();
+    /* without a clock, nothing is measured */
+    perfstat_clock_set(NULL);
+    PERFSTAT_MSTP_TOKEN_RECEIVED();
+    PERFSTAT_MSTP_TOKEN_RECEIVED();
+    zassert_equal(perfstat_mstp_token_rotation(), 0, NULL);
+    /* the first token starts the measurement */
+    perfstat_clock_set(test_clock);
+    Test_Clock = 1000;
+    PERFSTAT_MSTP_TOKEN_RECEIVED();
+    zassert_equal(perfstat_mstp_token_rotation(), 0, NULL);
+    Test_Clock += 30000;
+    PERFSTAT_MSTP_TOKEN_RECEIVED();
+    zassert_equal(perfstat_mstp_token_rotation(), 30000, NULL);
+    Test_Clock += 10000;
+    PERFSTAT_MSTP_TOKEN_RECEIVED();
+    zassert_equal(perfstat_mstp_token_rotation(), 10000, NULL);
+    zassert_equal(perfstat_mstp_token_rotation_max(), 30000, NULL);
+    perfstat_snapshot(&data);
+    zassert_equal(data.mstp_token_rotation, 10000, NULL);
+    zassert_equal(data.mstp_token_rotation_histogram.count, 2, NULL);
+    /* after a reset, the next token starts the measurement again */
+    perfstat_reset();
+    Test_Clock += 5000;
+    PERFSTAT_MSTP_TOKEN_RECEIVED();
+    zassert_equal(perfstat_mstp_token_rotation(), 0, NULL);
+    perfstat_clock_set(NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(perfstat_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        perfstat_tests, ztest_unit_test(testPerfstatBuckets),
+        ztest_unit_test(testPerfstatHistogram),
+        ztest_unit_test(testPerfstatCounters),
+        ztest_unit_test(testPerfstatServices),
+        ztest_unit_test(testPerfstatTokenRotation));
+
+    ztest_run_test_suite(perfstat_tests);
+}
+#endif
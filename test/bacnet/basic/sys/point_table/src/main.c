@@ -0,0 +1,154 @@
+/**
+ * @file
+ * @brief test shared Point Table library API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/point_table.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_POINT_COUNT 4
+
+/* a block of memory aligned for a double, like a shared mapping */
+static double Test_Memory[64];
+static unsigned Test_Update_Count;
+static uint16_t Test_Update_Type;
+static uint32_t Test_Update_Instance;
+static POINT_TABLE_VALUE Test_Update_Value;
+
+static void point_table_test_update(
+    uint16_t object_type,
+    uint32_t object_instance,
+    const POINT_TABLE_VALUE *value,
+    void *context)
+{
+    zassert_equal(context, &Test_Update_Count, NULL);
+    Test_Update_Type = object_type;
+    Test_Update_Instance = object_instance;
+    Test_Update_Value = *value;
+    Test_Update_Count++;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(point_table_tests, testPointTable)
+#else
+static void testPointTable(void)
+#endif
+{
+    POINT_TABLE *table, *reader;
+    POINT_TABLE_VALUE value = { 0 }, test_value = { 0 };
+    struct Point_Table_Point *point;
+    unsigned count;
+    bool status;
+
+    zassert_true(
+        Point_Table_Size(TEST_POINT_COUNT) <= sizeof(Test_Memory), NULL);
+    table = Point_Table_Format(Test_Memory, 8, TEST_POINT_COUNT);
+    zassert_is_null(table, NULL);
+    reader = Point_Table_Attach(Test_Memory, sizeof(Test_Memory));
+    zassert_is_null(reader, NULL);
+    table = Point_Table_Format(
+        Test_Memory, sizeof(Test_Memory), TEST_POINT_COUNT);
+    zassert_not_null(table, NULL);
+    zassert_equal(Point_Table_Count(table), TEST_POINT_COUNT, NULL);
+    /* another process attaches to the same memory */
+    reader = Point_Table_Attach(Test_Memory, sizeof(Test_Memory));
+    zassert_equal(reader, table, NULL);
+    reader = Point_Table_Attach(Test_Memory, sizeof(POINT_TABLE));
+    zassert_is_null(reader, NULL);
+    reader = table;
+
+    /* binding */
+    zassert_true(Point_Table_Bind(table, 0, 0, 1), NULL);
+    zassert_true(Point_Table_Bind(table, 1, 3, 7), NULL);
+    zassert_false(Point_Table_Bind(table, TEST_POINT_COUNT, 0, 2), NULL);
+    zassert_equal(Point_Table_Find(table, 0, 1), 0, NULL);
+    zassert_equal(Point_Table_Find(table, 3, 7), 1, NULL);
+    zassert_equal(Point_Table_Find(table, 3, 8), -1, NULL);
+    /* nothing to pick up before the writer gives a value */
+    count = Point_Table_Poll(reader, point_table_test_update, NULL);
+    zassert_equal(count, 0, NULL);
+    zassert_false(Point_Table_Read(reader, 0, &test_value), NULL);
+    /* an unbound point can't be written */
+    zassert_false(Point_Table_Write(table, 2, &value), NULL);
+
+    value.value = 21.5;
+    value.timestamp = 1234567;
+    value.reliability = 0;
+    zassert_true(Point_Table_Write(table, 0, &value), NULL);
+    status = Point_Table_Read(reader, 0, &test_value);
+    zassert_true(status, NULL);
+    zassert_false(islessgreater(test_value.value, 21.5), NULL);
+    zassert_equal(test_value.timestamp, 1234567, NULL);
+    count = Point_Table_Poll(
+        reader, point_table_test_update, &Test_Update_Count);
+    zassert_equal(count, 1, NULL);
+    zassert_equal(Test_Update_Count, 1, NULL);
+    zassert_equal(Test_Update_Type, 0, NULL);
+    zassert_equal(Test_Update_Instance, 1, NULL);
+    zassert_false(islessgreater(Test_Update_Value.value, 21.5), NULL);
+    /* unchanged points are not picked up again */
+    count = Point_Table_Poll(
+        reader, point_table_test_update, &Test_Update_Count);
+    zassert_equal(count, 0, NULL);
+
+    /* several changes between polls are picked up once, as the last */
+    value.value = 1.0;
+    zassert_true(Point_Table_Write(table, 1, &value), NULL);
+    value.value = 2.0;
+    value.reliability = 7;
+    zassert_true(Point_Table_Write(table, 1, &value), NULL);
+    count = Point_Table_Poll(
+        reader, point_table_test_update, &Test_Update_Count);
+    zassert_equal(count, 1, NULL);
+    zassert_equal(Test_Update_Type, 3, NULL);
+    zassert_equal(Test_Update_Instance, 7, NULL);
+    zassert_false(islessgreater(Test_Update_Value.value, 2.0), NULL);
+    zassert_equal(Test_Update_Value.reliability, 7, NULL);
+
+    /* a point that the writer is changing is left for the next poll */
+    point = (struct Point_Table_Point *)(void *)(table + 1);
+    point[0].sequence++;
+    point[0].value = 99.0;
+    zassert_false(Point_Table_Read(reader, 0, &test_value), NULL);
+    count = Point_Table_Poll(
+        reader, point_table_test_update, &Test_Update_Count);
+    zassert_equal(count, 0, NULL);
+    point[0].sequence++;
+    count = Point_Table_Poll(
+        reader, point_table_test_update, &Test_Update_Count);
+    zassert_equal(count, 1, NULL);
+    zassert_false(islessgreater(Test_Update_Value.value, 99.0), NULL);
+
+    /* parameter checks */
+    zassert_equal(Point_Table_Count(NULL), 0, NULL);
+    zassert_equal(Point_Table_Poll(NULL, NULL, NULL), 0, NULL);
+    zassert_equal(Point_Table_Find(NULL, 0, 1), -1, NULL);
+    zassert_false(Point_Table_Write(table, 0, NULL), NULL);
+    zassert_false(Point_Table_Read(reader, 0, NULL), NULL);
+    zassert_is_null(Point_Table_Attach(NULL, 0), NULL);
+    /* a table with another layout is not attached */
+    table->version++;
+    zassert_is_null(
+        Point_Table_Attach(Test_Memory, sizeof(Test_Memory)), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(point_table_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(point_table_tests, ztest_unit_test(testPointTable));
+
+    ztest_run_test_suite(point_table_tests);
+}
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @brief test the state of a BACnet priority array
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/priority_array.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test commanding and relinquishing the slots
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(priority_array_tests, test_priority_array_command)
+#else
+static void test_priority_array_command(void)
+#endif
+{
+    PRIORITY_ARRAY_STATE state = { 0 };
+    unsigned priority;
+
+    priority_array_init(&state);
+    zassert_equal(priority_array_active_priority(&state), 0, NULL);
+    for (priority = 1; priority <= BACNET_MAX_PRIORITY; priority++) {
+        zassert_false(priority_array_active(&state, priority), NULL);
+    }
+    /* invalid priorities */
+    zassert_false(priority_array_command(&state, 0), NULL);
+    zassert_false(priority_array_command(&state, 17), NULL);
+    zassert_false(priority_array_relinquish(&state, 0), NULL);
+    zassert_false(priority_array_relinquish(&state, 17), NULL);
+    zassert_false(priority_array_active(&state, 0), NULL);
+    zassert_false(priority_array_active(&state, 17), NULL);
+    zassert_false(priority_array_command(NULL, 8), NULL);
+    zassert_equal(priority_array_active_priority(NULL), 0, NULL);
+    zassert_equal(priority_array_active_priority(&state), 0, NULL);
+    /* a lower priority does not take over */
+    zassert_true(priority_array_command(&state, 16), NULL);
+    zassert_equal(priority_array_active_priority(&state), 16, NULL);
+    zassert_true(priority_array_command(&state, 8), NULL);
+    zassert_equal(priority_array_active_priority(&state), 8, NULL);
+    zassert_true(priority_array_command(&state, 12), NULL);
+    zassert_equal(priority_array_active_priority(&state), 8, NULL);
+    zassert_true(priority_array_active(&state, 12), NULL);
+    zassert_false(priority_array_active(&state, 11), NULL);
+    /* relinquish a slot that is not the active one */
+    zassert_true(priority_array_relinquish(&state, 16), NULL);
+    zassert_equal(priority_array_active_priority(&state), 8, NULL);
+    zassert_false(priority_array_active(&state, 16), NULL);
+    /* relinquish the active slot */
+    zassert_true(priority_array_relinquish(&state, 8), NULL);
+    zassert_equal(priority_array_active_priority(&state), 12, NULL);
+    zassert_true(priority_array_relinquish(&state, 12), NULL);
+    zassert_equal(priority_array_active_priority(&state), 0, NULL);
+    /* relinquish a slot that was already relinquished */
+    zassert_true(priority_array_relinquish(&state, 12), NULL);
+    zassert_equal(priority_array_active_priority(&state), 0, NULL);
+    /* the highest and the lowest priority */
+    zassert_true(priority_array_command(&state, 1), NULL);
+    zassert_true(priority_array_command(&state, 16), NULL);
+    zassert_equal(priority_array_active_priority(&state), 1, NULL);
+    zassert_true(priority_array_relinquish(&state, 1), NULL);
+    zassert_equal(priority_array_active_priority(&state), 16, NULL);
+    priority_array_init(&state);
+    zassert_equal(priority_array_active_priority(&state), 0, NULL);
+    zassert_false(priority_array_active(&state, 16), NULL);
+}
+
+/**
+ * @brief Test the commanded priority at or below a priority
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(priority_array_tests, test_priority_array_next_priority)
+#else
+static void test_priority_array_next_priority(void)
+#endif
+{
+    PRIORITY_ARRAY_STATE state = { 0 };
+
+    priority_array_init(&state);
+    zassert_equal(priority_array_next_priority(&state, 1), 0, NULL);
+    zassert_equal(priority_array_next_priority(NULL, 1), 0, NULL);
+    priority_array_command(&state, 4);
+    priority_array_command(&state, 9);
+    priority_array_command(&state, 16);
+    zassert_equal(priority_array_next_priority(&state, 0), 4, NULL);
+    zassert_equal(priority_array_next_priority(&state, 1), 4, NULL);
+    zassert_equal(priority_array_next_priority(&state, 4), 4, NULL);
+    zassert_equal(priority_array_next_priority(&state, 5), 9, NULL);
+    zassert_equal(priority_array_next_priority(&state, 9), 9, NULL);
+    zassert_equal(priority_array_next_priority(&state, 10), 16, NULL);
+    zassert_equal(priority_array_next_priority(&state, 16), 16, NULL);
+    zassert_equal(priority_array_next_priority(&state, 17), 0, NULL);
+    priority_array_relinquish(&state, 16);
+    zassert_equal(priority_array_next_priority(&state, 10), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(priority_array_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        priority_array_tests, ztest_unit_test(test_priority_array_command),
+        ztest_unit_test(test_priority_array_next_priority));
+
+    ztest_run_test_suite(priority_array_tests);
+}
+#endif
@@ -6,6 +6,10 @@
  * @copyright SPDX-License-Identifier: MIT
  */
 #include <limits.h>
+#if defined(RINGBUF_TEST_THREADS)
+#include <pthread.h>
+#include <sched.h>
+#endif
 #include <zephyr/ztest.h>
 #include <bacnet/basic/sys/ringbuf.h>
 
@@ -351,6 +355,97 @@ static void testRingBufNextElementSizeSmall(void)
         sizeof(data_store) / sizeof(data_element));
     zassert_true(status, NULL);
 }
+
+#if defined(RINGBUF_TEST_THREADS)
+#define SPSC_ELEMENT_COUNT 8
+#define SPSC_TEST_COUNT 100000UL
+struct spsc_element {
+    unsigned long sequence;
+    uint8_t data[59];
+};
+static struct spsc_element SPSC_Store[SPSC_ELEMENT_COUNT];
+static RING_BUFFER SPSC_Queue;
+
+/**
+ * Producer thread that fills each element in place and then puts it
+ *
+ * @param  arg - not used
+ * @return NULL
+ */
+static void *testRingBufProducer(void *arg)
+{
+    volatile struct spsc_element *element;
+    unsigned long sequence = 0;
+    unsigned i;
+
+    (void)arg;
+    while (sequence < SPSC_TEST_COUNT) {
+        element = Ringbuf_Data_Peek(&SPSC_Queue);
+        if (!element) {
+            sched_yield();
+            continue;
+        }
+        element->sequence = sequence;
+        for (i = 0; i < sizeof(element->data); i++) {
+            element->data[i] = (uint8_t)(sequence + i);
+        }
+        if (Ringbuf_Data_Put(&SPSC_Queue, (volatile uint8_t *)element)) {
+            sequence++;
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+/**
+ * Unit Test for one producer thread and one consumer thread without a lock
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ringbuf_tests, testRingBufProducerConsumer)
+#else
+static void testRingBufProducerConsumer(void)
+#endif
+{
+#if defined(RINGBUF_TEST_THREADS)
+    volatile struct spsc_element *element;
+    unsigned long sequence = 0;
+    unsigned long errors = 0;
+    pthread_t producer;
+    unsigned i;
+
+    zassert_true(
+        Ringbuf_Init(
+            &SPSC_Queue, (volatile uint8_t *)SPSC_Store,
+            sizeof(struct spsc_element), SPSC_ELEMENT_COUNT),
+        NULL);
+    zassert_equal(
+        pthread_create(&producer, NULL, testRingBufProducer, NULL), 0, NULL);
+    while (sequence < SPSC_TEST_COUNT) {
+        element = Ringbuf_Peek(&SPSC_Queue);
+        if (!element) {
+            sched_yield();
+            continue;
+        }
+        if (element->sequence != sequence) {
+            errors++;
+        }
+        for (i = 0; i < sizeof(element->data); i++) {
+            if (element->data[i] != (uint8_t)(sequence + i)) {
+                errors++;
+            }
+        }
+        zassert_true(Ringbuf_Pop(&SPSC_Queue, NULL), NULL);
+        sequence++;
+    }
+    zassert_equal(pthread_join(producer, NULL), 0, NULL);
+    zassert_equal(errors, 0, NULL);
+    zassert_true(Ringbuf_Empty(&SPSC_Queue), NULL);
+    zassert_true(Ringbuf_Depth(&SPSC_Queue) <= SPSC_ELEMENT_COUNT, NULL);
+#else
+    ztest_test_skip();
+#endif
+}
 /**
  * @}
  */
@@ -365,7 +460,8 @@ void test_main(void)
         ztest_unit_test(testRingBufSizeSmall),
         ztest_unit_test(testRingBufSizeLarge),
         ztest_unit_test(testRingBufSizeInvalid),
-        ztest_unit_test(testRingBufNextElementSizeSmall));
+        ztest_unit_test(testRingBufNextElementSizeSmall),
+        ztest_unit_test(testRingBufProducerConsumer));
 
     ztest_run_test_suite(ringbuf_tests);
 }
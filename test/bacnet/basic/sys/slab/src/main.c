@@ -0,0 +1,156 @@
+/**
+ * @file
+ * @brief test Slab library API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/slab.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+struct slab_test_item {
+    uint32_t instance;
+    float value;
+    char name[13];
+};
+
+/**
+ * @brief Test giving out and releasing items
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(slab_tests, testSlab)
+#else
+static void testSlab(void)
+#endif
+{
+    SLAB_TYPE slab = SLAB_INITIALIZER(sizeof(struct slab_test_item));
+    struct slab_test_item *items[16];
+    struct slab_test_item *item;
+    const unsigned count = 16;
+    unsigned i;
+    bool status;
+
+    zassert_equal(Slab_Count(&slab), 0, NULL);
+    zassert_is_null(Slab_Item_Alloc(NULL), NULL);
+    for (i = 0; i < count; i++) {
+        items[i] = Slab_Item_Alloc(&slab);
+        zassert_not_null(items[i], NULL);
+        zassert_true(Slab_Member(&slab, items[i]), NULL);
+        /* the items are zeroed */
+        zassert_equal(items[i]->instance, 0, NULL);
+        items[i]->instance = i;
+        items[i]->value = 1.0f;
+    }
+    zassert_equal(Slab_Count(&slab), count, NULL);
+    /* without reserving, each item has its own block */
+    zassert_equal(Slab_Free_Count(&slab), 0, NULL);
+    for (i = 0; i < count; i++) {
+        zassert_equal(items[i]->instance, i, NULL);
+    }
+    status = Slab_Free(&slab, NULL);
+    zassert_false(status, NULL);
+    for (i = 0; i < count; i += 2) {
+        status = Slab_Free(&slab, items[i]);
+        zassert_true(status, NULL);
+    }
+    zassert_equal(Slab_Count(&slab), count / 2, NULL);
+    /* the blocks were returned to the heap */
+    zassert_equal(Slab_Free_Count(&slab), 0, NULL);
+    item = Slab_Item_Alloc(&slab);
+    zassert_not_null(item, NULL);
+    zassert_equal(item->instance, 0, NULL);
+    zassert_equal(Slab_Count(&slab), (count / 2) + 1, NULL);
+    Slab_Cleanup(&slab);
+    zassert_equal(Slab_Count(&slab), 0, NULL);
+    zassert_false(Slab_Member(&slab, item), NULL);
+}
+
+/**
+ * @brief Test reserving and retaining items in the pool
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(slab_tests, testSlabReserve)
+#else
+static void testSlabReserve(void)
+#endif
+{
+    SLAB_TYPE slab;
+    struct slab_test_item *items[8];
+    struct slab_test_item *item;
+    const unsigned count = 8;
+    unsigned i, pass;
+    bool status;
+
+    Slab_Init(&slab, sizeof(struct slab_test_item));
+    Slab_Retain_Set(&slab, true);
+    status = Slab_Reserve(&slab, count);
+    zassert_true(status, NULL);
+    zassert_equal(Slab_Free_Count(&slab), count, NULL);
+    zassert_equal(Slab_Count(&slab), 0, NULL);
+    /* reserving less does not allocate */
+    status = Slab_Reserve(&slab, 1);
+    zassert_true(status, NULL);
+    zassert_equal(Slab_Free_Count(&slab), count, NULL);
+    for (pass = 0; pass < 3; pass++) {
+        for (i = 0; i < count; i++) {
+            items[i] = Slab_Item_Alloc(&slab);
+            zassert_not_null(items[i], NULL);
+            zassert_equal(items[i]->instance, 0, NULL);
+            items[i]->instance = i + 1;
+        }
+        /* the reserved items are given out in address order */
+        for (i = 1; (pass == 0) && (i < count); i++) {
+            zassert_true(
+                (const char *)items[i] > (const char *)items[i - 1], NULL);
+        }
+        zassert_equal(Slab_Free_Count(&slab), 0, NULL);
+        for (i = 0; i < count; i++) {
+            status = Slab_Free(&slab, items[i]);
+            zassert_true(status, NULL);
+        }
+        /* the memory is kept for reuse */
+        zassert_equal(Slab_Free_Count(&slab), count, NULL);
+        zassert_equal(Slab_Count(&slab), 0, NULL);
+    }
+    /* a different slab list does not release our items */
+    item = Slab_Item_Alloc(&slab);
+    zassert_not_null(item, NULL);
+    {
+        SLAB_TYPE other = SLAB_INITIALIZER(sizeof(struct slab_test_item));
+        zassert_false(Slab_Free(&other, item), NULL);
+        zassert_false(Slab_Member(&other, item), NULL);
+    }
+    zassert_true(Slab_Free(&slab, item), NULL);
+    zassert_false(Slab_Free(&slab, item), NULL);
+    /* not retaining releases the empty blocks */
+    Slab_Retain_Set(&slab, false);
+    zassert_equal(Slab_Free_Count(&slab), 0, NULL);
+    /* grow several items at a time */
+    Slab_Grow_Set(&slab, 4);
+    item = Slab_Item_Alloc(&slab);
+    zassert_not_null(item, NULL);
+    zassert_equal(Slab_Free_Count(&slab), 3, NULL);
+    zassert_true(Slab_Free(&slab, item), NULL);
+    zassert_equal(Slab_Free_Count(&slab), 0, NULL);
+    Slab_Cleanup(&slab);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(slab_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        slab_tests, ztest_unit_test(testSlab),
+        ztest_unit_test(testSlabReserve));
+
+    ztest_run_test_suite(slab_tests);
+}
+#endif
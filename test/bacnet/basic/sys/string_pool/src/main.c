@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @brief test String Pool library API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/string_pool.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test sharing and releasing strings
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(string_pool_tests, testStringPool)
+#else
+static void testStringPool(void)
+#endif
+{
+    char buffer[32] = "Zone Temperature";
+    const char *name, *other, *text;
+    size_t size;
+
+    zassert_is_null(String_Pool_Intern(NULL), NULL);
+    zassert_false(String_Pool_Release(NULL), NULL);
+    zassert_equal(String_Pool_References(NULL), 0, NULL);
+    zassert_equal(String_Pool_Count(), 0, NULL);
+    zassert_equal(String_Pool_Size(), 0, NULL);
+    name = String_Pool_Intern(buffer);
+    zassert_not_null(name, NULL);
+    zassert_true(name != buffer, NULL);
+    zassert_equal(strcmp(name, buffer), 0, NULL);
+    zassert_equal(String_Pool_Count(), 1, NULL);
+    zassert_equal(String_Pool_References(buffer), 1, NULL);
+    size = String_Pool_Size();
+    zassert_true(size > strlen(buffer), NULL);
+    /* the same text shares the same copy */
+    other = String_Pool_Intern("Zone Temperature");
+    zassert_equal(other, name, NULL);
+    zassert_equal(String_Pool_Count(), 1, NULL);
+    zassert_equal(String_Pool_References(name), 2, NULL);
+    zassert_equal(String_Pool_Size(), size, NULL);
+    /* the caller may change its own copy */
+    strcpy(buffer, "Fan Status");
+    zassert_equal(strcmp(name, "Zone Temperature"), 0, NULL);
+    text = String_Pool_Intern(buffer);
+    zassert_not_null(text, NULL);
+    zassert_true(text != name, NULL);
+    zassert_equal(String_Pool_Count(), 2, NULL);
+    zassert_true(String_Pool_Size() > size, NULL);
+    /* only a shared copy is released */
+    zassert_false(String_Pool_Release(buffer), NULL);
+    zassert_false(String_Pool_Release("Unknown"), NULL);
+    zassert_equal(String_Pool_References(text), 1, NULL);
+    zassert_true(String_Pool_Release(text), NULL);
+    zassert_equal(String_Pool_Count(), 1, NULL);
+    zassert_equal(String_Pool_References(buffer), 0, NULL);
+    zassert_equal(String_Pool_Size(), size, NULL);
+    zassert_true(String_Pool_Release(name), NULL);
+    zassert_equal(String_Pool_References(name), 1, NULL);
+    zassert_true(String_Pool_Release(other), NULL);
+    zassert_equal(String_Pool_Count(), 0, NULL);
+    zassert_equal(String_Pool_Size(), 0, NULL);
+    String_Pool_Cleanup();
+}
+
+/**
+ * @brief Test many strings and the cleanup of the pool
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(string_pool_tests, testStringPoolCleanup)
+#else
+static void testStringPoolCleanup(void)
+#endif
+{
+    const char *texts[100];
+    char buffer[16];
+    const unsigned count = 100;
+    unsigned i;
+
+    for (i = 0; i < count; i++) {
+        snprintf(buffer, sizeof(buffer), "State %u", i);
+        texts[i] = String_Pool_Intern(buffer);
+        zassert_not_null(texts[i], NULL);
+    }
+    zassert_equal(String_Pool_Count(), count, NULL);
+    for (i = 0; i < count; i++) {
+        snprintf(buffer, sizeof(buffer), "State %u", i);
+        zassert_equal(String_Pool_Intern(buffer), texts[i], NULL);
+        zassert_equal(String_Pool_References(buffer), 2, NULL);
+    }
+    /* release every other text, and use the freed slots again */
+    for (i = 0; i < count; i += 2) {
+        zassert_true(String_Pool_Release(texts[i]), NULL);
+        zassert_true(String_Pool_Release(texts[i]), NULL);
+    }
+    zassert_equal(String_Pool_Count(), count / 2, NULL);
+    for (i = 0; i < count; i += 2) {
+        snprintf(buffer, sizeof(buffer), "Mode %u", i);
+        texts[i] = String_Pool_Intern(buffer);
+        zassert_not_null(texts[i], NULL);
+    }
+    zassert_equal(String_Pool_Count(), count, NULL);
+    String_Pool_Cleanup();
+    zassert_equal(String_Pool_Count(), 0, NULL);
+    zassert_equal(String_Pool_Size(), 0, NULL);
+    zassert_equal(String_Pool_References("State 1"), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(string_pool_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        string_pool_tests, ztest_unit_test(testStringPool),
+        ztest_unit_test(testStringPoolCleanup));
+
+    ztest_run_test_suite(string_pool_tests);
+}
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @brief test Timer Wheel library API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/timer_wheel.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+struct timer_wheel_test_item {
+    struct Timer_Wheel_Entry timer;
+    uint32_t expired_tick;
+    unsigned expired_count;
+    uint32_t repeat;
+};
+
+static TIMER_WHEEL Test_Wheel;
+static uint32_t Test_Order[8];
+static unsigned Test_Order_Count;
+
+static void timer_wheel_test_expired(
+    struct Timer_Wheel_Entry *entry, void *context)
+{
+    struct timer_wheel_test_item *item = context;
+
+    zassert_equal(&item->timer, entry, NULL);
+    zassert_false(Timer_Wheel_Pending(entry), NULL);
+    item->expired_tick = Timer_Wheel_Now(&Test_Wheel);
+    item->expired_count++;
+    if (Test_Order_Count < 8) {
+        Test_Order[Test_Order_Count] = item->expired_tick;
+        Test_Order_Count++;
+    }
+    if (item->repeat > 0) {
+        Timer_Wheel_Add(&Test_Wheel, entry, item->repeat);
+    }
+}
+
+/**
+ * @brief Test timers that expire in each level of the wheel
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(timer_wheel_tests, testTimerWheel)
+#else
+static void testTimerWheel(void)
+#endif
+{
+    static struct timer_wheel_test_item items[6];
+    const uint32_t delay[6] = { 1, 63, 64, 4095, 70000, 1000 };
+    unsigned i;
+
+    Timer_Wheel_Init(&Test_Wheel);
+    Test_Order_Count = 0;
+    for (i = 0; i < 6; i++) {
+        Timer_Wheel_Entry_Init(
+            &items[i].timer, timer_wheel_test_expired, &items[i]);
+        items[i].expired_count = 0;
+        items[i].repeat = 0;
+        zassert_false(Timer_Wheel_Pending(&items[i].timer), NULL);
+        Timer_Wheel_Add(&Test_Wheel, &items[i].timer, delay[i]);
+        zassert_true(Timer_Wheel_Pending(&items[i].timer), NULL);
+        zassert_equal(
+            Timer_Wheel_Remaining(&Test_Wheel, &items[i].timer), delay[i],
+            NULL);
+    }
+    zassert_equal(Timer_Wheel_Count(&Test_Wheel), 6, NULL);
+    /* cancel one, and the rest expire on their tick */
+    zassert_true(Timer_Wheel_Cancel(&Test_Wheel, &items[5].timer), NULL);
+    zassert_false(Timer_Wheel_Cancel(&Test_Wheel, &items[5].timer), NULL);
+    zassert_equal(Timer_Wheel_Count(&Test_Wheel), 5, NULL);
+    /* advance in uneven steps */
+    for (i = 0; i < 7000; i++) {
+        Timer_Wheel_Advance(&Test_Wheel, 10);
+        Timer_Wheel_Advance(&Test_Wheel, 0);
+    }
+    zassert_equal(Timer_Wheel_Now(&Test_Wheel), 70000, NULL);
+    zassert_equal(Timer_Wheel_Count(&Test_Wheel), 0, NULL);
+    for (i = 0; i < 5; i++) {
+        zassert_equal(items[i].expired_count, 1, NULL);
+        zassert_equal(items[i].expired_tick, delay[i], NULL);
+        zassert_equal(Test_Order[i], delay[i], NULL);
+    }
+    zassert_equal(items[5].expired_count, 0, NULL);
+    /* with nothing pending, time jumps forward */
+    Timer_Wheel_Advance(&Test_Wheel, 1000000UL);
+    zassert_equal(Timer_Wheel_Now(&Test_Wheel), 1070000UL, NULL);
+}
+
+/**
+ * @brief Test moving a pending timer and adding it from its callback
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(timer_wheel_tests, testTimerWheelReschedule)
+#else
+static void testTimerWheelReschedule(void)
+#endif
+{
+    static struct timer_wheel_test_item items[3];
+    unsigned i;
+
+    Timer_Wheel_Init(&Test_Wheel);
+    Test_Order_Count = 0;
+    for (i = 0; i < 3; i++) {
+        Timer_Wheel_Entry_Init(
+            &items[i].timer, timer_wheel_test_expired, &items[i]);
+        items[i].expired_count = 0;
+        items[i].repeat = 0;
+    }
+    /* several timers in the same slot */
+    Timer_Wheel_Add(&Test_Wheel, &items[0].timer, 5000);
+    Timer_Wheel_Add(&Test_Wheel, &items[1].timer, 5000);
+    Timer_Wheel_Add(&Test_Wheel, &items[2].timer, 5000);
+    /* move the middle and the head of the slot */
+    Timer_Wheel_Add(&Test_Wheel, &items[1].timer, 100);
+    Timer_Wheel_Add(&Test_Wheel, &items[2].timer, 0);
+    zassert_equal(Timer_Wheel_Count(&Test_Wheel), 3, NULL);
+    Timer_Wheel_Advance(&Test_Wheel, 1);
+    zassert_equal(items[2].expired_count, 1, NULL);
+    Timer_Wheel_Advance(&Test_Wheel, 99);
+    zassert_equal(items[1].expired_count, 1, NULL);
+    zassert_equal(items[0].expired_count, 0, NULL);
+    Timer_Wheel_Advance(&Test_Wheel, 4900);
+    zassert_equal(items[0].expired_count, 1, NULL);
+    zassert_equal(items[0].expired_tick, 5000, NULL);
+    /* a periodic timer */
+    items[0].repeat = 7;
+    Timer_Wheel_Add(&Test_Wheel, &items[0].timer, 7);
+    Timer_Wheel_Advance(&Test_Wheel, 70);
+    zassert_equal(items[0].expired_count, 11, NULL);
+    zassert_equal(Timer_Wheel_Count(&Test_Wheel), 1, NULL);
+    zassert_equal(Timer_Wheel_Remaining(&Test_Wheel, &items[0].timer), 7, NULL);
+    /* the next deadline, across the levels of the wheel */
+    Timer_Wheel_Add(&Test_Wheel, &items[1].timer, 90);
+    Timer_Wheel_Add(&Test_Wheel, &items[2].timer, 30);
+    zassert_equal(Timer_Wheel_Next(&Test_Wheel), 7, NULL);
+    Timer_Wheel_Cancel(&Test_Wheel, &items[0].timer);
+    zassert_equal(Timer_Wheel_Next(&Test_Wheel), 30, NULL);
+    Timer_Wheel_Advance(&Test_Wheel, 29);
+    zassert_equal(Timer_Wheel_Next(&Test_Wheel), 1, NULL);
+    Timer_Wheel_Advance(&Test_Wheel, 1);
+    zassert_equal(Timer_Wheel_Next(&Test_Wheel), 60, NULL);
+    Timer_Wheel_Cancel(&Test_Wheel, &items[1].timer);
+    zassert_equal(Timer_Wheel_Next(&Test_Wheel), UINT32_MAX, NULL);
+    /* the longest timer is clamped */
+    Timer_Wheel_Add(&Test_Wheel, &items[1].timer, UINT32_MAX);
+    zassert_equal(
+        Timer_Wheel_Remaining(&Test_Wheel, &items[1].timer),
+        TIMER_WHEEL_TICKS_MAX, NULL);
+    zassert_false(Timer_Wheel_Pending(NULL), NULL);
+    zassert_equal(Timer_Wheel_Count(NULL), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(timer_wheel_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        timer_wheel_tests, ztest_unit_test(testTimerWheel),
+        ztest_unit_test(testTimerWheelReschedule));
+
+    ztest_run_test_suite(timer_wheel_tests);
+}
+#endif
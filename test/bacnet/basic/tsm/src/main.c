@@ -0,0 +1,869 @@
+/**
+ * @file
+ * @brief test BACnet Transaction State Machine API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacaddr.h>
+#include <bacnet/npdu.h>
+#include <bacnet/basic/tsm/tsm.h>
+#include <bacnet/basic/service/h_apdu.h>
+#include <bacnet/datalink/datalink.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the test peers use the MAC addresses 1..TEST_PEER_MAX */
+#define TEST_PEER_MAX 5
+
+static unsigned Send_Count;
+static unsigned Timeout_Count;
+static uint8_t Timeout_Invoke_ID;
+/* the last PDU that was sent */
+static uint8_t Send_PDU[MAX_PDU];
+static unsigned Send_PDU_Len;
+
+uint16_t apdu_timeout(void)
+{
+    return 1000;
+}
+
+uint8_t apdu_retries(void)
+{
+    return 2;
+}
+
+int datalink_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    if (pdu_len <= sizeof(Send_PDU)) {
+        memcpy(Send_PDU, pdu, pdu_len);
+        Send_PDU_Len = pdu_len;
+    }
+    Send_Count++;
+
+    return (int)pdu_len;
+}
+
+uint16_t apdu_segment_timeout(void)
+{
+    return 100;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(*my_address));
+}
+
+static void test_timeout_handler(uint8_t invokeID)
+{
+    Timeout_Count++;
+    Timeout_Invoke_ID = invokeID;
+}
+
+/**
+ * @brief Start a confirmed transaction with a new invoke ID
+ * @return the invoke ID, or zero if none are available
+ */
+static uint8_t test_transaction_start(void)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t apdu[4] = { 0 };
+    uint8_t invokeID;
+
+    invokeID = tsm_next_free_invokeID();
+    if (invokeID) {
+        apdu[2] = invokeID;
+        tsm_set_confirmed_unsegmented_transaction(
+            invokeID, &dest, &npdu_data, apdu, sizeof(apdu));
+    }
+
+    return invokeID;
+}
+
+/**
+ * @brief Initialize a peer address
+ * @param dest - address to initialize
+ * @param mac - last octet of the MAC address
+ */
+static void test_peer_address(BACNET_ADDRESS *dest, uint8_t mac)
+{
+    BACNET_MAC_ADDRESS mac_address = { 0 };
+
+    mac_address.len = 6;
+    mac_address.adr[0] = 192;
+    mac_address.adr[1] = 168;
+    mac_address.adr[3] = mac;
+    mac_address.adr[4] = 0xBA;
+    mac_address.adr[5] = 0xC0;
+    bacnet_address_init(dest, &mac_address, 0, NULL);
+}
+
+/**
+ * @brief Free all the invoke IDs that are in use, including the ones
+ *  of the test peers
+ */
+static void test_transaction_free_all(void)
+{
+    BACNET_ADDRESS peer = { 0 };
+    unsigned i;
+    uint8_t mac;
+
+    for (i = 1; i < 256; i++) {
+        while (!tsm_invoke_id_free((uint8_t)i)) {
+            tsm_free_invoke_id((uint8_t)i);
+        }
+        for (mac = 1; mac <= TEST_PEER_MAX; mac++) {
+            test_peer_address(&peer, mac);
+            while (!tsm_invoke_id_free_peer(&peer, (uint8_t)i)) {
+                tsm_free_invoke_id_peer(&peer, (uint8_t)i);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Test allocating and freeing the invoke IDs
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tsm_tests, testTSMInvokeID)
+#else
+static void testTSMInvokeID(void)
+#endif
+{
+    uint8_t invokeID[255] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t apdu[MAX_PDU] = { 0 };
+    uint16_t apdu_len = 0;
+    uint8_t reused;
+    unsigned i, j;
+    bool status;
+
+    test_transaction_free_all();
+    tsm_invokeID_set(1);
+    zassert_true(tsm_transaction_available(), NULL);
+    zassert_equal(tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS, NULL);
+    /* the invoke IDs are unique among all the peers */
+    for (i = 0; i < 255; i++) {
+        invokeID[i] = test_transaction_start();
+        zassert_not_equal(invokeID[i], 0, NULL);
+        for (j = 0; j < i; j++) {
+            zassert_not_equal(invokeID[i], invokeID[j], NULL);
+        }
+        zassert_false(tsm_invoke_id_free(invokeID[i]), NULL);
+        zassert_false(tsm_invoke_id_failed(invokeID[i]), NULL);
+        zassert_equal(
+            tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS - (i + 1),
+            NULL);
+    }
+    zassert_true(tsm_transaction_available(), NULL);
+    zassert_equal(tsm_next_free_invokeID(), 0, NULL);
+    status = tsm_get_transaction_pdu(
+        invokeID[3], &dest, &npdu_data, apdu, &apdu_len);
+    zassert_true(status, NULL);
+    zassert_equal(apdu_len, 4, NULL);
+    zassert_equal(apdu[2], invokeID[3], NULL);
+    /* the only free invoke ID is reused */
+    tsm_free_invoke_id(invokeID[3]);
+    zassert_true(tsm_invoke_id_free(invokeID[3]), NULL);
+    status = tsm_get_transaction_pdu(
+        invokeID[3], &dest, &npdu_data, apdu, &apdu_len);
+    zassert_false(status, NULL);
+    zassert_true(tsm_transaction_available(), NULL);
+    reused = test_transaction_start();
+    zassert_not_equal(reused, 0, NULL);
+    zassert_equal(reused, invokeID[3], NULL);
+    zassert_equal(tsm_next_free_invokeID(), 0, NULL);
+    /* the invoke ID counter wraps and skips the IDs still in use */
+    tsm_free_invoke_id(reused);
+    tsm_invokeID_set(invokeID[0]);
+    reused = test_transaction_start();
+    zassert_not_equal(reused, 0, NULL);
+    for (i = 0; i < 255; i++) {
+        if (i != 3) {
+            zassert_not_equal(reused, invokeID[i], NULL);
+        }
+    }
+    test_transaction_free_all();
+    zassert_equal(tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS, NULL);
+}
+
+/**
+ * @brief Test the request timer retries and timeouts
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tsm_tests, testTSMTimeout)
+#else
+static void testTSMTimeout(void)
+#endif
+{
+    uint8_t first, second, third;
+
+    test_transaction_free_all();
+    tsm_set_timeout_handler(test_timeout_handler);
+    Send_Count = 0;
+    Timeout_Count = 0;
+    first = test_transaction_start();
+    tsm_timer_milliseconds(400);
+    second = test_transaction_start();
+    tsm_timer_milliseconds(400);
+    third = test_transaction_start();
+    zassert_not_equal(third, 0, NULL);
+    /* first expires at 1000ms, second at 1400ms */
+    tsm_timer_milliseconds(199);
+    zassert_equal(Send_Count, 0, NULL);
+    tsm_timer_milliseconds(1);
+    zassert_equal(Send_Count, 1, NULL);
+    tsm_timer_milliseconds(400);
+    zassert_equal(Send_Count, 2, NULL);
+    /* a freed transaction is not retried */
+    tsm_free_invoke_id(third);
+    tsm_timer_milliseconds(400);
+    zassert_equal(Send_Count, 2, NULL);
+    /* first: retry 2 at 2000ms, second: retry 2 at 2400ms */
+    tsm_timer_milliseconds(200);
+    zassert_equal(Send_Count, 3, NULL);
+    tsm_timer_milliseconds(400);
+    zassert_equal(Send_Count, 4, NULL);
+    zassert_equal(Timeout_Count, 0, NULL);
+    /* first times out at 3000ms, and second at 3400ms */
+    tsm_timer_milliseconds(600);
+    zassert_equal(Send_Count, 4, NULL);
+    zassert_equal(Timeout_Count, 1, NULL);
+    zassert_equal(Timeout_Invoke_ID, first, NULL);
+    zassert_true(tsm_invoke_id_failed(first), NULL);
+    zassert_false(tsm_invoke_id_free(first), NULL);
+    zassert_false(tsm_invoke_id_failed(second), NULL);
+    tsm_timer_milliseconds(400);
+    zassert_equal(Timeout_Count, 2, NULL);
+    zassert_equal(Timeout_Invoke_ID, second, NULL);
+    zassert_true(tsm_invoke_id_failed(second), NULL);
+    /* nothing left to time out */
+    tsm_timer_milliseconds(60000);
+    zassert_equal(Send_Count, 4, NULL);
+    zassert_equal(Timeout_Count, 2, NULL);
+    tsm_free_invoke_id(first);
+    tsm_free_invoke_id(second);
+    zassert_true(tsm_invoke_id_free(first), NULL);
+    zassert_equal(tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS, NULL);
+    tsm_set_timeout_handler(NULL);
+}
+
+static BACNET_ADDRESS Timeout_Peer;
+
+static void test_timeout_peer_handler(
+    const BACNET_ADDRESS *dest, uint8_t invokeID)
+{
+    Timeout_Count++;
+    Timeout_Invoke_ID = invokeID;
+    Timeout_Peer = *dest;
+}
+
+/**
+ * @brief Test the invoke IDs that are unique for each peer
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tsm_tests, testTSMPeer)
+#else
+static void testTSMPeer(void)
+#endif
+{
+    BACNET_ADDRESS peer_a = { 0 }, peer_b = { 0 }, peer_c = { 0 };
+    BACNET_ADDRESS peer_d = { 0 }, peer_e = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t apdu[4] = { 0 };
+    uint8_t invokeID[255] = { 0 };
+    uint8_t shared_invoke_id = 0;
+    uint8_t invoke_id;
+    unsigned i, j;
+
+    test_transaction_free_all();
+    test_peer_address(&peer_a, 1);
+    test_peer_address(&peer_b, 2);
+    test_peer_address(&peer_c, 3);
+    test_peer_address(&peer_d, 4);
+    test_peer_address(&peer_e, 5);
+    /* a small window for one peer */
+    zassert_equal(tsm_peer_window(&peer_a), MAX_TSM_PEER_WINDOW, NULL);
+    zassert_true(tsm_peer_window_set(&peer_a, 3), NULL);
+    zassert_equal(tsm_peer_window(&peer_a), 3, NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_not_equal(tsm_next_free_invokeID_peer(&peer_a), 0, NULL);
+    }
+    zassert_equal(tsm_next_free_invokeID_peer(&peer_a), 0, NULL);
+    zassert_equal(tsm_peer_transaction_count(&peer_a), 3, NULL);
+    /* more than 255 transactions, using the same invoke IDs */
+    for (i = 0; i < 250; i++) {
+        invokeID[i] = tsm_next_free_invokeID_peer(&peer_b);
+        zassert_not_equal(invokeID[i], 0, NULL);
+    }
+    for (i = 0; i < 47; i++) {
+        invoke_id = tsm_next_free_invokeID_peer(&peer_c);
+        zassert_not_equal(invoke_id, 0, NULL);
+        for (j = 0; j < 250; j++) {
+            if (invokeID[j] == invoke_id) {
+                shared_invoke_id = invoke_id;
+            }
+        }
+    }
+    zassert_equal(tsm_transaction_idle_count(), 0, NULL);
+    zassert_false(tsm_transaction_available(), NULL);
+    zassert_equal(tsm_next_free_invokeID_peer(&peer_c), 0, NULL);
+    zassert_equal(tsm_next_free_invokeID(), 0, NULL);
+    zassert_equal(tsm_peer_transaction_count(&peer_b), 250, NULL);
+    zassert_equal(tsm_peer_transaction_count(&peer_c), 47, NULL);
+    /* an acknowledgment frees the transaction of the peer that sent it */
+    zassert_not_equal(shared_invoke_id, 0, NULL);
+    tsm_free_invoke_id_peer(&peer_c, shared_invoke_id);
+    zassert_true(tsm_invoke_id_free_peer(&peer_c, shared_invoke_id), NULL);
+    zassert_false(tsm_invoke_id_free_peer(&peer_b, shared_invoke_id), NULL);
+    zassert_equal(tsm_peer_transaction_count(&peer_c), 46, NULL);
+    /* a peer that is not known has no transactions */
+    zassert_true(tsm_invoke_id_free_peer(&peer_d, invokeID[0]), NULL);
+    tsm_free_invoke_id_peer(&peer_d, invokeID[0]);
+    zassert_false(tsm_invoke_id_free_peer(&peer_b, invokeID[0]), NULL);
+    test_transaction_free_all();
+    zassert_equal(tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS, NULL);
+    zassert_equal(tsm_peer_transaction_count(&peer_b), 0, NULL);
+    /* the peer list is full while windows are set */
+    zassert_true(tsm_peer_window_set(&peer_b, 10), NULL);
+    zassert_true(tsm_peer_window_set(&peer_c, 10), NULL);
+    zassert_true(tsm_peer_window_set(&peer_d, 10), NULL);
+    zassert_false(tsm_peer_window_set(&peer_e, 10), NULL);
+    zassert_equal(tsm_next_free_invokeID_peer(&peer_e), 0, NULL);
+    zassert_true(tsm_peer_window_set(&peer_d, 0), NULL);
+    zassert_equal(tsm_peer_window(&peer_d), MAX_TSM_PEER_WINDOW, NULL);
+    invoke_id = tsm_next_free_invokeID_peer(&peer_e);
+    zassert_not_equal(invoke_id, 0, NULL);
+    /* a transaction that times out reports the peer */
+    tsm_set_timeout_peer_handler(test_timeout_peer_handler);
+    Timeout_Count = 0;
+    apdu[2] = invoke_id;
+    tsm_set_confirmed_unsegmented_transaction(
+        invoke_id, &peer_e, &npdu_data, apdu, sizeof(apdu));
+    tsm_timer_milliseconds(1000);
+    tsm_timer_milliseconds(1000);
+    tsm_timer_milliseconds(1000);
+    zassert_equal(Timeout_Count, 1, NULL);
+    zassert_equal(Timeout_Invoke_ID, invoke_id, NULL);
+    zassert_true(bacnet_address_same(&Timeout_Peer, &peer_e), NULL);
+    zassert_true(tsm_invoke_id_failed_peer(&peer_e, invoke_id), NULL);
+    zassert_false(tsm_invoke_id_failed_peer(&peer_d, invoke_id), NULL);
+    tsm_free_invoke_id_peer(&peer_e, invoke_id);
+    zassert_equal(tsm_peer_transaction_count(&peer_e), 0, NULL);
+    tsm_set_timeout_peer_handler(NULL);
+    zassert_true(tsm_peer_window_set(&peer_a, 0), NULL);
+    zassert_true(tsm_peer_window_set(&peer_b, 0), NULL);
+    zassert_true(tsm_peer_window_set(&peer_c, 0), NULL);
+}
+
+/**
+ * @brief Test the functions without a peer address with the invoke IDs
+ *  of the peers
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tsm_tests, testTSMPeerWithoutAddress)
+#else
+static void testTSMPeerWithoutAddress(void)
+#endif
+{
+    BACNET_ADDRESS peer_a = { 0 }, peer_b = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t apdu[4] = { 0 };
+    uint8_t invoke_id, other_id;
+
+    test_transaction_free_all();
+    test_peer_address(&peer_a, 1);
+    test_peer_address(&peer_b, 2);
+    /* the peers get invoke IDs that no other peer uses */
+    invoke_id = tsm_next_free_invokeID_peer(&peer_a);
+    zassert_not_equal(invoke_id, 0, NULL);
+    other_id = tsm_next_free_invokeID_peer(&peer_b);
+    zassert_not_equal(other_id, 0, NULL);
+    zassert_not_equal(other_id, invoke_id, NULL);
+    zassert_false(tsm_invoke_id_free(invoke_id), NULL);
+    zassert_false(tsm_invoke_id_free(other_id), NULL);
+    tsm_free_invoke_id(other_id);
+    zassert_true(tsm_invoke_id_free(other_id), NULL);
+    zassert_equal(tsm_peer_transaction_count(&peer_b), 0, NULL);
+    /* a timeout is reported without the peer address */
+    tsm_set_timeout_handler(test_timeout_handler);
+    Timeout_Count = 0;
+    apdu[2] = invoke_id;
+    tsm_set_confirmed_unsegmented_transaction(
+        invoke_id, &peer_a, &npdu_data, apdu, sizeof(apdu));
+    tsm_timer_milliseconds(1000);
+    tsm_timer_milliseconds(1000);
+    tsm_timer_milliseconds(1000);
+    zassert_equal(Timeout_Count, 1, NULL);
+    zassert_equal(Timeout_Invoke_ID, invoke_id, NULL);
+    zassert_true(tsm_invoke_id_failed(invoke_id), NULL);
+    zassert_false(tsm_invoke_id_free(invoke_id), NULL);
+    tsm_free_invoke_id(invoke_id);
+    zassert_true(tsm_invoke_id_free(invoke_id), NULL);
+    zassert_equal(tsm_peer_transaction_count(&peer_a), 0, NULL);
+    zassert_equal(tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS, NULL);
+    tsm_set_timeout_handler(NULL);
+}
+
+/**
+ * @brief Test two peers that use the same invoke ID at the same time
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tsm_tests, testTSMPeerSameInvokeID)
+#else
+static void testTSMPeerSameInvokeID(void)
+#endif
+{
+    BACNET_ADDRESS peer_a = { 0 }, peer_b = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t apdu_a[4] = { 0, 0, 0, 0xAA };
+    uint8_t apdu_b[4] = { 0, 0, 0, 0xBB };
+    uint8_t apdu[MAX_PDU] = { 0 };
+    uint16_t apdu_len = 0;
+    uint8_t invokeID[255] = { 0 };
+    uint8_t invoke_id, other_id = 0;
+    unsigned i, count = 0;
+
+    test_transaction_free_all();
+    test_peer_address(&peer_a, 1);
+    test_peer_address(&peer_b, 2);
+    invoke_id = tsm_next_free_invokeID_peer(&peer_a);
+    zassert_not_equal(invoke_id, 0, NULL);
+    /* the other peer gets the same invoke ID once the others are used */
+    while (other_id != invoke_id) {
+        zassert_true(count < 255, NULL);
+        other_id = tsm_next_free_invokeID_peer(&peer_b);
+        zassert_not_equal(other_id, 0, NULL);
+        invokeID[count++] = other_id;
+    }
+    for (i = 0; i < count - 1; i++) {
+        tsm_free_invoke_id_peer(&peer_b, invokeID[i]);
+    }
+    zassert_equal(tsm_peer_transaction_count(&peer_a), 1, NULL);
+    zassert_equal(tsm_peer_transaction_count(&peer_b), 1, NULL);
+    apdu_a[2] = invoke_id;
+    tsm_set_confirmed_unsegmented_transaction(
+        invoke_id, &peer_a, &npdu_data, apdu_a, sizeof(apdu_a));
+    apdu_b[2] = invoke_id;
+    tsm_set_confirmed_unsegmented_transaction(
+        invoke_id, &peer_b, &npdu_data, apdu_b, sizeof(apdu_b));
+    /* each peer finds its own transaction */
+    zassert_true(
+        tsm_get_transaction_pdu_peer(
+            &peer_a, invoke_id, &npdu_data, apdu, &apdu_len),
+        NULL);
+    zassert_equal(apdu_len, sizeof(apdu_a), NULL);
+    zassert_equal(apdu[3], 0xAA, NULL);
+    zassert_true(
+        tsm_get_transaction_pdu_peer(
+            &peer_b, invoke_id, &npdu_data, apdu, &apdu_len),
+        NULL);
+    zassert_equal(apdu[3], 0xBB, NULL);
+    /* without a peer address, one of the transactions is found */
+    zassert_false(tsm_invoke_id_free(invoke_id), NULL);
+    zassert_false(tsm_invoke_id_failed(invoke_id), NULL);
+    /* an acknowledgment from one peer leaves the other waiting */
+    tsm_free_invoke_id_peer(&peer_a, invoke_id);
+    zassert_true(tsm_invoke_id_free_peer(&peer_a, invoke_id), NULL);
+    zassert_false(tsm_invoke_id_free_peer(&peer_b, invoke_id), NULL);
+    zassert_false(
+        tsm_get_transaction_pdu_peer(
+            &peer_a, invoke_id, &npdu_data, apdu, &apdu_len),
+        NULL);
+    /* the timeout of the other is reported to both handlers */
+    tsm_set_timeout_handler(test_timeout_handler);
+    tsm_set_timeout_peer_handler(test_timeout_peer_handler);
+    Timeout_Count = 0;
+    tsm_timer_milliseconds(1000);
+    tsm_timer_milliseconds(1000);
+    tsm_timer_milliseconds(1000);
+    zassert_equal(Timeout_Count, 2, NULL);
+    zassert_equal(Timeout_Invoke_ID, invoke_id, NULL);
+    zassert_true(bacnet_address_same(&Timeout_Peer, &peer_b), NULL);
+    zassert_false(tsm_invoke_id_failed_peer(&peer_a, invoke_id), NULL);
+    zassert_true(tsm_invoke_id_failed_peer(&peer_b, invoke_id), NULL);
+    tsm_free_invoke_id_peer(&peer_b, invoke_id);
+    zassert_equal(tsm_transaction_idle_count(), MAX_TSM_TRANSACTIONS, NULL);
+    tsm_set_timeout_handler(NULL);
+    tsm_set_timeout_peer_handler(NULL);
+}
+/**
+ * @brief Get the APDU of the last PDU that was sent
+ * @return the APDU
+ */
+static uint8_t *test_sent_apdu(void)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int offset;
+
+    offset = bacnet_npdu_decode(
+        Send_PDU, (uint16_t)Send_PDU_Len, NULL, NULL, &npdu_data);
+    zassert_true(offset > 0, NULL);
+
+    return &Send_PDU[offset];
+}
+
+/**
+ * @brief Check the SegmentACK that was sent last
+ * @param negative - expected negative-ack bit
+ * @param server - expected server bit
+ * @param invoke_id - expected invoke ID
+ * @param sequence_number - expected sequence number
+ * @param window - expected actual window size
+ */
+static void test_segment_ack_check(
+    bool negative,
+    bool server,
+    uint8_t invoke_id,
+    uint8_t sequence_number,
+    uint8_t window)
+{
+    uint8_t *apdu = test_sent_apdu();
+    uint8_t pdu_type = PDU_TYPE_SEGMENT_ACK;
+
+    if (negative) {
+        pdu_type |= BIT(1);
+    }
+    if (server) {
+        pdu_type |= BIT(0);
+    }
+    zassert_equal(apdu[0], pdu_type, NULL);
+    zassert_equal(apdu[1], invoke_id, NULL);
+    zassert_equal(apdu[2], sequence_number, NULL);
+    zassert_equal(apdu[3], window, NULL);
+}
+
+/**
+ * @brief Receive a segment whose two octets of data are its sequence number
+ * @param src - address of the peer
+ * @param server - true if the segment is from the server
+ * @param invoke_id - invoke ID
+ * @param sequence_number - sequence number of the segment
+ * @param window - proposed window size
+ * @param more_follows - true if more segments follow
+ * @param message_len - number of octets of the whole message, when it
+ *  was received
+ * @return true if the whole message was received
+ */
+static bool test_segment_receive(
+    const BACNET_ADDRESS *src,
+    bool server,
+    uint8_t invoke_id,
+    uint8_t sequence_number,
+    uint8_t window,
+    bool more_follows,
+    uint16_t *message_len)
+{
+    uint8_t data[2];
+    uint8_t *message = NULL;
+    bool status;
+    unsigned i;
+
+    data[0] = sequence_number;
+    data[1] = sequence_number;
+    status = tsm_segment_receive(
+        src, server, invoke_id, sequence_number, window, more_follows, data,
+        sizeof(data), &message, message_len);
+    if (status) {
+        zassert_not_null(message, NULL);
+        for (i = 0; i < *message_len; i++) {
+            zassert_equal(message[i], i / 2, NULL);
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Test receiving the segments of a message
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tsm_tests, testTSMSegmentedReceive)
+#else
+static void testTSMSegmentedReceive(void)
+#endif
+{
+    BACNET_ADDRESS peer = { 0 };
+    BACNET_ADDRESS server = { 0 };
+    uint16_t message_len = 0;
+    uint8_t invoke_id;
+    uint8_t *apdu;
+
+    test_peer_address(&peer, 1);
+    Send_Count = 0;
+    /* the first segment of a request gets a SegmentACK with the window */
+    zassert_false(
+        test_segment_receive(&peer, false, 7, 0, 4, true, &message_len),
+        NULL);
+    zassert_equal(Send_Count, 1, NULL);
+    test_segment_ack_check(false, true, 7, 0, 4);
+    zassert_equal(tsm_segmented_count(), 1, NULL);
+    zassert_false(
+        test_segment_receive(&peer, false, 7, 1, 4, true, &message_len),
+        NULL);
+    zassert_equal(Send_Count, 1, NULL);
+    /* a missing segment gets one negative SegmentACK */
+    zassert_false(
+        test_segment_receive(&peer, false, 7, 3, 4, true, &message_len),
+        NULL);
+    zassert_equal(Send_Count, 2, NULL);
+    test_segment_ack_check(true, true, 7, 1, 4);
+    zassert_false(
+        test_segment_receive(&peer, false, 7, 4, 4, true, &message_len),
+        NULL);
+    zassert_equal(Send_Count, 2, NULL);
+    /* a duplicate segment is acknowledged again */
+    zassert_false(
+        test_segment_receive(&peer, false, 7, 1, 4, true, &message_len),
+        NULL);
+    zassert_equal(Send_Count, 3, NULL);
+    test_segment_ack_check(false, true, 7, 1, 4);
+    /* the missing segment brings in the ones that were kept */
+    zassert_false(
+        test_segment_receive(&peer, false, 7, 2, 4, true, &message_len),
+        NULL);
+    zassert_equal(Send_Count, 3, NULL);
+    zassert_true(
+        test_segment_receive(&peer, false, 7, 5, 4, false, &message_len),
+        NULL);
+    zassert_equal(Send_Count, 4, NULL);
+    test_segment_ack_check(false, true, 7, 5, 4);
+    zassert_equal(message_len, 12, NULL);
+    tsm_segmented_message_free(&peer, false, 7);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    /* a segment that is not the first is dropped */
+    zassert_false(
+        test_segment_receive(&peer, false, 8, 1, 4, true, &message_len),
+        NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    /* a ComplexACK is only received for a request */
+    zassert_false(
+        test_segment_receive(&server, true, 9, 0, 4, true, &message_len),
+        NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    zassert_equal(Send_Count, 4, NULL);
+    tsm_set_timeout_handler(test_timeout_handler);
+    Timeout_Count = 0;
+    invoke_id = test_transaction_start();
+    Send_Count = 0;
+    zassert_false(
+        test_segment_receive(
+            &server, true, invoke_id, 0, 200, true, &message_len),
+        NULL);
+    zassert_equal(Send_Count, 1, NULL);
+    apdu = test_sent_apdu();
+    zassert_equal(apdu[0], PDU_TYPE_ABORT, NULL);
+    zassert_equal(apdu[1], invoke_id, NULL);
+    zassert_equal(apdu[2], ABORT_REASON_WINDOW_SIZE_OUT_OF_RANGE, NULL);
+    zassert_true(tsm_invoke_id_failed(invoke_id), NULL);
+    zassert_equal(Timeout_Count, 1, NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    tsm_free_invoke_id(invoke_id);
+    /* the segment timer takes over from the request timer */
+    invoke_id = test_transaction_start();
+    Send_Count = 0;
+    zassert_false(
+        test_segment_receive(
+            &server, true, invoke_id, 0, 2, true, &message_len),
+        NULL);
+    test_segment_ack_check(false, false, invoke_id, 0, 2);
+    zassert_false(tsm_invoke_id_failed(invoke_id), NULL);
+    tsm_timer_milliseconds((4 * apdu_segment_timeout()) - 1);
+    zassert_equal(Send_Count, 1, NULL);
+    zassert_false(tsm_invoke_id_failed(invoke_id), NULL);
+    tsm_timer_milliseconds(1);
+    zassert_true(tsm_invoke_id_failed(invoke_id), NULL);
+    zassert_equal(Timeout_Count, 2, NULL);
+    zassert_equal(Timeout_Invoke_ID, invoke_id, NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    tsm_free_invoke_id(invoke_id);
+    tsm_set_timeout_handler(NULL);
+}
+
+/**
+ * @brief Encode a ReadProperty-ACK reply with some service data
+ * @param pdu - buffer for the reply
+ * @param npdu_data - network layer info of the reply
+ * @param invoke_id - invoke ID of the request
+ * @param length - number of octets of service data
+ * @return number of octets of the reply
+ */
+static int test_reply_encode(
+    uint8_t *pdu,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t invoke_id,
+    unsigned length)
+{
+    int len;
+    unsigned i;
+
+    npdu_encode_npdu_data(npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, NULL, NULL, npdu_data);
+    pdu[len++] = PDU_TYPE_COMPLEX_ACK;
+    pdu[len++] = invoke_id;
+    pdu[len++] = SERVICE_CONFIRMED_READ_PROPERTY;
+    for (i = 0; i < length; i++) {
+        pdu[len++] = (uint8_t)i;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Test sending a reply in segments
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tsm_tests, testTSMSegmentedReply)
+#else
+static void testTSMSegmentedReply(void)
+#endif
+{
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS peer = { 0 };
+    uint16_t pdu_size = 0;
+    uint8_t *pdu;
+    uint8_t *apdu;
+    int pdu_len;
+    unsigned i;
+
+    test_peer_address(&peer, 2);
+    service_data.invoke_id = 5;
+    service_data.max_segs = 4;
+    service_data.max_resp = 128;
+    /* the client does not accept a segmented response */
+    zassert_is_null(
+        tsm_segmented_reply_buffer(&peer, &service_data, &pdu_size), NULL);
+    service_data.segmented_response_accepted = true;
+    pdu = tsm_segmented_reply_buffer(&peer, &service_data, &pdu_size);
+    zassert_not_null(pdu, NULL);
+    zassert_true(pdu_size > MAX_PDU, NULL);
+    zassert_equal(service_data.max_resp, 3 + (4 * (128 - 5)), NULL);
+    /* a reply that fits into one APDU is sent as it is */
+    pdu_len = test_reply_encode(pdu, &npdu_data, 5, 100);
+    Send_Count = 0;
+    zassert_equal(
+        tsm_segmented_reply_send(&peer, &npdu_data, pdu, pdu_len), pdu_len,
+        NULL);
+    zassert_equal(Send_Count, 1, NULL);
+    zassert_equal(Send_PDU_Len, pdu_len, NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    /* a larger reply is sent in segments, the first one alone */
+    service_data.max_resp = 128;
+    pdu = tsm_segmented_reply_buffer(&peer, &service_data, &pdu_size);
+    zassert_not_null(pdu, NULL);
+    pdu_len = test_reply_encode(pdu, &npdu_data, 5, 300);
+    zassert_true(
+        tsm_segmented_reply_send(&peer, &npdu_data, pdu, pdu_len) > 0, NULL);
+    zassert_equal(Send_Count, 2, NULL);
+    apdu = test_sent_apdu();
+    zassert_equal(apdu[0], PDU_TYPE_COMPLEX_ACK | BIT(3) | BIT(2), NULL);
+    zassert_equal(apdu[1], 5, NULL);
+    zassert_equal(apdu[2], 0, NULL);
+    zassert_equal(apdu[3], MAX_TSM_SEGMENT_WINDOW, NULL);
+    zassert_equal(apdu[4], SERVICE_CONFIRMED_READ_PROPERTY, NULL);
+    zassert_equal(apdu[5], 0, NULL);
+    zassert_equal(tsm_segmented_count(), 1, NULL);
+    /* the window is sent again when the SegmentACK does not arrive */
+    tsm_timer_milliseconds(apdu_segment_timeout());
+    zassert_equal(Send_Count, 3, NULL);
+    /* the client asks for windows of two segments */
+    tsm_segment_ack_handler(&peer, false, false, 5, 0, 2);
+    zassert_equal(Send_Count, 5, NULL);
+    apdu = test_sent_apdu();
+    zassert_equal(apdu[0], PDU_TYPE_COMPLEX_ACK | BIT(3), NULL);
+    zassert_equal(apdu[2], 2, NULL);
+    zassert_equal(apdu[5], (uint8_t)(2 * (128 - 5)), NULL);
+    zassert_equal(
+        Send_PDU_Len, (unsigned)(apdu - Send_PDU) + 5 + 300 - (2 * 123),
+        NULL);
+    /* a SegmentACK from a server or outside the window is ignored */
+    tsm_segment_ack_handler(&peer, false, true, 5, 1, 2);
+    tsm_segment_ack_handler(&peer, false, false, 5, 0, 2);
+    zassert_equal(Send_Count, 5, NULL);
+    zassert_equal(tsm_segmented_count(), 1, NULL);
+    /* a negative SegmentACK sends the missing segment again */
+    tsm_segment_ack_handler(&peer, true, false, 5, 1, 2);
+    zassert_equal(Send_Count, 6, NULL);
+    apdu = test_sent_apdu();
+    zassert_equal(apdu[2], 2, NULL);
+    /* the SegmentACK of the last segment ends the reply */
+    tsm_segment_ack_handler(&peer, false, false, 5, 2, 2);
+    zassert_equal(Send_Count, 6, NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    /* a reply that is not acknowledged is dropped after the retries */
+    service_data.max_resp = 128;
+    pdu = tsm_segmented_reply_buffer(&peer, &service_data, &pdu_size);
+    pdu_len = test_reply_encode(pdu, &npdu_data, 5, 300);
+    (void)tsm_segmented_reply_send(&peer, &npdu_data, pdu, pdu_len);
+    Send_Count = 0;
+    for (i = 0; i < apdu_retries(); i++) {
+        tsm_timer_milliseconds(apdu_segment_timeout());
+    }
+    zassert_equal(Send_Count, apdu_retries(), NULL);
+    zassert_equal(tsm_segmented_count(), 1, NULL);
+    tsm_timer_milliseconds(apdu_segment_timeout());
+    zassert_equal(Send_Count, apdu_retries(), NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    /* or when the client aborts it */
+    service_data.max_resp = 128;
+    pdu = tsm_segmented_reply_buffer(&peer, &service_data, &pdu_size);
+    pdu_len = test_reply_encode(pdu, &npdu_data, 5, 300);
+    (void)tsm_segmented_reply_send(&peer, &npdu_data, pdu, pdu_len);
+    tsm_segmented_abort_handler(&peer, true, 5);
+    zassert_equal(tsm_segmented_count(), 1, NULL);
+    tsm_segmented_abort_handler(&peer, false, 5);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    /* a buffer without a reply is released */
+    pdu = tsm_segmented_reply_buffer(&peer, &service_data, &pdu_size);
+    zassert_equal(tsm_segmented_count(), 1, NULL);
+    zassert_equal(tsm_segmented_reply_send(&peer, &npdu_data, pdu, 0), 0, NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+    /* more segments than the client accepts */
+    service_data.max_resp = 128;
+    service_data.max_segs = 2;
+    pdu = tsm_segmented_reply_buffer(&peer, &service_data, &pdu_size);
+    zassert_equal(service_data.max_resp, 3 + (2 * (128 - 5)), NULL);
+    pdu_len = test_reply_encode(pdu, &npdu_data, 5, 300);
+    Send_Count = 0;
+    zassert_equal(
+        tsm_segmented_reply_send(&peer, &npdu_data, pdu, pdu_len), 0, NULL);
+    zassert_equal(Send_Count, 1, NULL);
+    apdu = test_sent_apdu();
+    zassert_equal(apdu[0], PDU_TYPE_ABORT | 1, NULL);
+    zassert_equal(apdu[2], ABORT_REASON_BUFFER_OVERFLOW, NULL);
+    zassert_equal(tsm_segmented_count(), 0, NULL);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(tsm_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        tsm_tests, ztest_unit_test(testTSMInvokeID),
+        ztest_unit_test(testTSMTimeout), ztest_unit_test(testTSMPeer),
+        ztest_unit_test(testTSMPeerWithoutAddress),
+        ztest_unit_test(testTSMPeerSameInvokeID),
+        ztest_unit_test(testTSMSegmentedReceive),
+        ztest_unit_test(testTSMSegmentedReply));
+
+    ztest_run_test_suite(tsm_tests);
+}
+#endif
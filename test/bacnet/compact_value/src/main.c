@@ -0,0 +1,200 @@
+/**
+ * @file
+ * @brief test the compact form of the primitive BACnet application values
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/compact_value.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Convert an application value to a compact value and back
+ * @param value - application value to convert
+ */
+static void test_compact_value_round_trip(
+    const BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_COMPACT_VALUE compact = { 0 }, test_compact = { 0 };
+    BACNET_APPLICATION_DATA_VALUE test_value = { 0 };
+
+    zassert_true(bacnet_compact_value_from_application(&compact, value), NULL);
+    zassert_equal(compact.tag, value->tag, NULL);
+    zassert_true(
+        bacnet_compact_value_to_application(&test_value, &compact), NULL);
+    zassert_true(bacapp_same_value(value, &test_value), "tag=%u", value->tag);
+    zassert_equal(test_value.context_specific, value->context_specific, NULL);
+    zassert_true(bacnet_compact_value_copy(&test_compact, &compact), NULL);
+    zassert_true(bacnet_compact_value_same(&compact, &test_compact), NULL);
+    if (compact.heap) {
+        zassert_not_equal(
+            bacnet_compact_value_octets(&compact),
+            bacnet_compact_value_octets(&test_compact), NULL);
+    }
+    bacnet_compact_value_free(&compact);
+    bacnet_compact_value_free(&test_compact);
+    zassert_equal(compact.tag, BACNET_APPLICATION_TAG_NULL, NULL);
+    zassert_false(compact.heap, NULL);
+}
+
+/**
+ * @brief Test the conversions of each primitive datatype
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(compact_value_tests, testCompactValue)
+#else
+static void testCompactValue(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    char long_string[200] = { 0 };
+
+    zassert_true(sizeof(BACNET_COMPACT_VALUE) <= 24, NULL);
+    zassert_true(
+        sizeof(BACNET_COMPACT_VALUE) < sizeof(BACNET_APPLICATION_DATA_VALUE),
+        NULL);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_NULL, "", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_BOOLEAN, "1", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_UNSIGNED_INT, "4194303", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_SIGNED_INT, "-42", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_REAL, "3.14159", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_DOUBLE, "2.718281828", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_ENUMERATED, "85", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_DATE, "2026/10/14:3", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_TIME, "23:59:59.12", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_OBJECT_ID, "8:4194303", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_OCTET_STRING, "0102030405", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_BIT_STRING, "1011010011", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    /* short strings are inline, long strings are on the heap */
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_CHARACTER_STRING, "AI-1", &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    memset(long_string, 'x', sizeof(long_string) - 1);
+    zassert_true(
+        bacapp_parse_application_data(
+            BACNET_APPLICATION_TAG_CHARACTER_STRING, long_string, &value),
+        NULL);
+    test_compact_value_round_trip(&value);
+    value.context_specific = true;
+    value.context_tag = 3;
+    test_compact_value_round_trip(&value);
+}
+
+/**
+ * @brief Test the comparisons and the datatypes without a compact form
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(compact_value_tests, testCompactValueSame)
+#else
+static void testCompactValueSame(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_COMPACT_VALUE compact1 = { 0 }, compact2 = { 0 };
+
+    bacnet_compact_value_init(&compact1);
+    bacnet_compact_value_init(&compact2);
+    zassert_true(bacnet_compact_value_same(&compact1, &compact2), NULL);
+    zassert_is_null(bacnet_compact_value_octets(&compact1), NULL);
+    zassert_false(bacnet_compact_value_same(&compact1, NULL), NULL);
+    bacapp_parse_application_data(
+        BACNET_APPLICATION_TAG_CHARACTER_STRING, "ABC", &value);
+    zassert_true(
+        bacnet_compact_value_from_application(&compact1, &value), NULL);
+    bacapp_parse_application_data(
+        BACNET_APPLICATION_TAG_CHARACTER_STRING, "ABD", &value);
+    zassert_true(
+        bacnet_compact_value_from_application(&compact2, &value), NULL);
+    zassert_false(bacnet_compact_value_same(&compact1, &compact2), NULL);
+    bacapp_parse_application_data(
+        BACNET_APPLICATION_TAG_OCTET_STRING, "414243", &value);
+    zassert_true(
+        bacnet_compact_value_from_application(&compact2, &value), NULL);
+    zassert_false(bacnet_compact_value_same(&compact1, &compact2), NULL);
+    bacapp_parse_application_data(BACNET_APPLICATION_TAG_REAL, "1.0", &value);
+    zassert_true(
+        bacnet_compact_value_from_application(&compact1, &value), NULL);
+    bacapp_parse_application_data(BACNET_APPLICATION_TAG_REAL, "2.0", &value);
+    zassert_true(
+        bacnet_compact_value_from_application(&compact2, &value), NULL);
+    zassert_false(bacnet_compact_value_same(&compact1, &compact2), NULL);
+    /* constructed datatypes stay in BACNET_APPLICATION_DATA_VALUE */
+    value.tag = BACNET_APPLICATION_TAG_DATETIME;
+    zassert_false(
+        bacnet_compact_value_from_application(&compact1, &value), NULL);
+    zassert_equal(compact1.tag, BACNET_APPLICATION_TAG_NULL, NULL);
+    zassert_false(bacnet_compact_value_from_application(NULL, &value), NULL);
+    zassert_false(bacnet_compact_value_to_application(NULL, &compact1), NULL);
+    bacnet_compact_value_free(NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(compact_value_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        compact_value_tests, ztest_unit_test(testCompactValue),
+        ztest_unit_test(testCompactValueSame));
+
+    ztest_run_test_suite(compact_value_tests);
+}
+#endif
@@ -5,6 +5,7 @@
  * @date 2012
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <zephyr/ztest.h>
 // #include <bacnet/bacapp.h>
 #include <bacnet/cov.h>
@@ -212,7 +213,9 @@ testCOVNotifyData(const BACNET_COV_DATA *data, BACNET_COV_DATA *test_data)
 static void testUCOVNotifyData(const BACNET_COV_DATA *data)
 {
     uint8_t apdu[480] = { 0 };
-    int len = 0, null_len = 0, apdu_len = 0;
+    uint8_t test_apdu[480] = { 0 };
+    uint8_t values[480] = { 0 };
+    int len = 0, null_len = 0, apdu_len = 0, values_len = 0;
     BACNET_COV_DATA test_data = { 0 };
     BACNET_PROPERTY_VALUE value_list[5] = { { 0 } };
 
@@ -221,6 +224,21 @@ static void testUCOVNotifyData(const BACNET_COV_DATA *data)
     zassert_true(len > 0, NULL);
     zassert_equal(len, null_len, NULL);
     apdu_len = len;
+    /* the same notification from the list of values encoded once */
+    values_len = cov_notify_value_list_encode(NULL, data->listOfValues);
+    zassert_equal(
+        cov_notify_value_list_encode(&values[0], data->listOfValues),
+        values_len, NULL);
+    null_len = ucov_notify_encode_apdu_values(
+        NULL, sizeof(test_apdu), data, &values[0], values_len);
+    zassert_equal(null_len, apdu_len, NULL);
+    len = ucov_notify_encode_apdu_values(
+        &test_apdu[0], sizeof(test_apdu), data, &values[0], values_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_mem_equal(&test_apdu[0], &apdu[0], apdu_len, NULL);
+    len = ucov_notify_encode_apdu_values(
+        &test_apdu[0], apdu_len - 1, data, &values[0], values_len);
+    zassert_equal(len, 0, NULL);
 
     cov_data_value_list_link(
         &test_data, &value_list[0], ARRAY_SIZE(value_list));
@@ -238,7 +256,9 @@ static void testUCOVNotifyData(const BACNET_COV_DATA *data)
 static void testCCOVNotifyData(uint8_t invoke_id, const BACNET_COV_DATA *data)
 {
     uint8_t apdu[480] = { 0 };
-    int len = 0, null_len = 0, apdu_len = 0;
+    uint8_t test_apdu[480] = { 0 };
+    uint8_t values[480] = { 0 };
+    int len = 0, null_len = 0, apdu_len = 0, values_len = 0;
     BACNET_COV_DATA test_data = { 0 };
     BACNET_PROPERTY_VALUE value_list[2] = { { 0 } };
     uint8_t test_invoke_id = 0;
@@ -248,6 +268,18 @@ static void testCCOVNotifyData(uint8_t invoke_id, const BACNET_COV_DATA *data)
     zassert_not_equal(len, 0, NULL);
     zassert_equal(len, null_len, NULL);
     apdu_len = len;
+    /* the same notification from the list of values encoded once */
+    values_len = cov_notify_value_list_encode(&values[0], data->listOfValues);
+    zassert_true(values_len > 0, NULL);
+    len = ccov_notify_encode_apdu_values(
+        &test_apdu[0], sizeof(test_apdu), invoke_id, data, &values[0],
+        values_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_mem_equal(&test_apdu[0], &apdu[0], apdu_len, NULL);
+    len = ccov_notify_encode_apdu_values(
+        &test_apdu[0], sizeof(test_apdu), invoke_id, NULL, &values[0],
+        values_len);
+    zassert_equal(len, 0, NULL);
 
     cov_data_value_list_link(&test_data, &value_list[0], 2);
 
@@ -399,6 +431,140 @@ static void testCOVSubscribePropertyEncoding(
     testCOVSubscribePropertyData(data, &test_data);
 }
 
+/**
+ * @brief Test encoding and decoding COVNotificationMultiple one object
+ *  at a time
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cov_tests, testCOVNotifyMultiple)
+#else
+static void testCOVNotifyMultiple(void)
+#endif
+{
+    uint8_t apdu[480] = { 0 };
+    uint8_t invoke_id = 12;
+    int len = 0, null_len = 0, apdu_len = 0;
+    BACNET_COV_DATA data = { 0 }, test_data = { 0 };
+    BACNET_PROPERTY_VALUE value_list[2] = { { 0 } };
+    BACNET_PROPERTY_VALUE test_value_list[2] = { { 0 } };
+    uint32_t instance;
+
+    data.subscriberProcessIdentifier = 1;
+    data.initiatingDeviceIdentifier = 123;
+    data.timeRemaining = 456;
+    cov_data_value_list_link(&data, &value_list[0], 2);
+    value_list[0].propertyIdentifier = PROP_PRESENT_VALUE;
+    value_list[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+    bacapp_parse_application_data(
+        BACNET_APPLICATION_TAG_REAL, "21.0", &value_list[0].value);
+    value_list[0].priority = BACNET_NO_PRIORITY;
+    value_list[1].propertyIdentifier = PROP_STATUS_FLAGS;
+    value_list[1].propertyArrayIndex = BACNET_ARRAY_ALL;
+    bacapp_parse_application_data(
+        BACNET_APPLICATION_TAG_BIT_STRING, "0000", &value_list[1].value);
+    value_list[1].priority = BACNET_NO_PRIORITY;
+
+    null_len = ccov_notify_multiple_encode_apdu_init(NULL, invoke_id, &data);
+    len = ccov_notify_multiple_encode_apdu_init(&apdu[0], invoke_id, &data);
+    zassert_true(len > 4, NULL);
+    zassert_equal(len, null_len, NULL);
+    zassert_equal(apdu[0], PDU_TYPE_CONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(apdu[2], invoke_id, NULL);
+    zassert_equal(apdu[3], SERVICE_CONFIRMED_COV_NOTIFICATION_MULTIPLE, NULL);
+    apdu_len = len;
+    for (instance = 1; instance <= 3; instance++) {
+        data.monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+        data.monitoredObjectIdentifier.instance = instance;
+        null_len = cov_notify_multiple_encode_object(NULL, &data);
+        len = cov_notify_multiple_encode_object(&apdu[apdu_len], &data);
+        zassert_true(len > 0, NULL);
+        zassert_equal(len, null_len, NULL);
+        apdu_len += len;
+    }
+    zassert_equal(cov_notify_multiple_encode_end(NULL), 1, NULL);
+    apdu_len += cov_notify_multiple_encode_end(&apdu[apdu_len]);
+    zassert_true(apdu_len <= sizeof(apdu), NULL);
+
+    /* decode */
+    len = cov_notify_multiple_decode_init(&apdu[4], apdu_len - 4, &test_data);
+    zassert_true(len > 0, NULL);
+    null_len = cov_notify_multiple_decode_init(&apdu[4], apdu_len - 4, NULL);
+    zassert_equal(len, null_len, NULL);
+    zassert_equal(test_data.subscriberProcessIdentifier, 1, NULL);
+    zassert_equal(test_data.initiatingDeviceIdentifier, 123, NULL);
+    zassert_equal(test_data.timeRemaining, 456, NULL);
+    len += 4;
+    for (instance = 1; instance <= 3; instance++) {
+        null_len = cov_notify_multiple_decode_object(
+            &apdu[len], apdu_len - len, NULL);
+        zassert_true(null_len > 0, NULL);
+        cov_data_value_list_link(&test_data, &test_value_list[0], 2);
+        null_len = cov_notify_multiple_decode_object(
+            &apdu[len], apdu_len - len, &test_data);
+        zassert_true(null_len > 0, NULL);
+        len += null_len;
+        zassert_equal(
+            test_data.monitoredObjectIdentifier.type, OBJECT_ANALOG_INPUT,
+            NULL);
+        zassert_equal(
+            test_data.monitoredObjectIdentifier.instance, instance, NULL);
+        data.monitoredObjectIdentifier = test_data.monitoredObjectIdentifier;
+        testCOVNotifyData(&data, &test_data);
+    }
+    /* end of the list */
+    null_len =
+        cov_notify_multiple_decode_object(&apdu[len], apdu_len - len, NULL);
+    zassert_equal(null_len, 0, NULL);
+    zassert_equal(len + 1, apdu_len, NULL);
+    /* truncated */
+    null_len = cov_notify_multiple_decode_init(&apdu[4], 2, &test_data);
+    zassert_true(null_len < 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cov_tests, testCOVNotifyMultipleTruncated)
+#else
+static void testCOVNotifyMultipleTruncated(void)
+#endif
+{
+    uint8_t apdu[64] = { 0 };
+    BACNET_COV_DATA data = { 0 };
+    BACNET_PROPERTY_VALUE value_list[2] = { { 0 } };
+    BACNET_TIME btime = { 12, 30, 0, 0 };
+    int len = 0, apdu_len = 0, time_len = 0;
+    unsigned size;
+
+    /* one object, with a value and its time of change */
+    apdu_len += encode_context_object_id(
+        &apdu[apdu_len], 0, OBJECT_ANALOG_INPUT, 1);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 1);
+    apdu_len += encode_context_enumerated(
+        &apdu[apdu_len], 0, PROP_PRESENT_VALUE);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 2);
+    apdu_len += encode_application_real(&apdu[apdu_len], 21.0f);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 2);
+    time_len = apdu_len;
+    apdu_len += encode_context_time(&apdu[apdu_len], 3, &btime);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 1);
+    cov_data_value_list_link(&data, &value_list[0], 2);
+    len = cov_notify_multiple_decode_object(apdu, apdu_len, &data);
+    zassert_equal(len, apdu_len, NULL);
+    len = cov_notify_multiple_decode_object(apdu, apdu_len, NULL);
+    zassert_equal(len, apdu_len, NULL);
+    /* the time of change is longer than what is left */
+    cov_data_value_list_link(&data, &value_list[0], 2);
+    len = cov_notify_multiple_decode_object(apdu, time_len + 1, &data);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    /* every shorter APDU is an error */
+    for (size = 0; size < (unsigned)apdu_len; size++) {
+        cov_data_value_list_link(&data, &value_list[0], 2);
+        len = cov_notify_multiple_decode_object(apdu, size, &data);
+        zassert_equal(len, BACNET_STATUS_ERROR, "size=%u", size);
+        len = cov_notify_multiple_decode_object(apdu, size, NULL);
+        zassert_equal(len, BACNET_STATUS_ERROR, "size=%u", size);
+    }
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(cov_tests, testCOVSubscribe)
 #else
@@ -593,6 +759,94 @@ static void test_COV_Value_List_Encode(void)
     zassert_equal(value_list[1].next, NULL, NULL);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cov_tests, test_COV_Filter)
+#else
+static void test_COV_Filter(void)
+#endif
+{
+    float real_prior = 10.0f;
+    int32_t signed_prior = 0;
+
+    zassert_false(cov_filter_real(NULL, 1.0f, 1.0f), NULL);
+    zassert_false(cov_filter_real(&real_prior, 10.5f, 1.0f), NULL);
+    zassert_false(cov_filter_real(&real_prior, 9.5f, 1.0f), NULL);
+    zassert_true(cov_filter_real(&real_prior, 11.0f, 1.0f), NULL);
+    zassert_false(islessgreater(real_prior, 11.0f), NULL);
+    zassert_true(cov_filter_real(&real_prior, 9.0f, 1.0f), NULL);
+    zassert_false(islessgreater(real_prior, 9.0f), NULL);
+    /* a zero increment reports any change, and an unchanged value */
+    zassert_true(cov_filter_real(&real_prior, 9.0f, 0.0f), NULL);
+
+    zassert_false(cov_filter_signed(NULL, 1, 1), NULL);
+    zassert_false(cov_filter_signed(&signed_prior, 4, 5), NULL);
+    zassert_false(cov_filter_signed(&signed_prior, -4, 5), NULL);
+    zassert_true(cov_filter_signed(&signed_prior, -5, 5), NULL);
+    zassert_equal(signed_prior, -5, NULL);
+    zassert_true(cov_filter_signed(&signed_prior, 0, 5), NULL);
+    zassert_equal(signed_prior, 0, NULL);
+    /* the full range of the difference does not overflow */
+    signed_prior = INT32_MIN;
+    zassert_false(
+        cov_filter_signed(&signed_prior, INT32_MAX - 1, UINT32_MAX), NULL);
+    zassert_true(cov_filter_signed(&signed_prior, INT32_MAX, UINT32_MAX), NULL);
+    zassert_equal(signed_prior, INT32_MAX, NULL);
+    zassert_true(cov_filter_signed(&signed_prior, INT32_MIN, 1), NULL);
+    zassert_equal(signed_prior, INT32_MIN, NULL);
+}
+
+static unsigned Test_COV_Callback_Count;
+static unsigned Test_COV_Listener_Count;
+static uint32_t Test_COV_Listener_Instance;
+
+static void test_COV_Callback(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    (void)object_type;
+    (void)object_instance;
+    Test_COV_Callback_Count++;
+}
+
+static void test_COV_Listener(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    (void)object_type;
+    Test_COV_Listener_Instance = object_instance;
+    Test_COV_Listener_Count++;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cov_tests, test_COV_Change_Of_Value_Listener)
+#else
+static void test_COV_Change_Of_Value_Listener(void)
+#endif
+{
+    COV_CHANGE_OF_VALUE_LISTENER listener = { 0 };
+
+    listener.callback = test_COV_Listener;
+    cov_change_of_value_callback_set(test_COV_Callback);
+    cov_change_of_value_notify(OBJECT_ANALOG_INPUT, 1);
+    zassert_equal(Test_COV_Callback_Count, 1, NULL);
+    zassert_equal(Test_COV_Listener_Count, 0, NULL);
+    /* adding twice is the same as adding once */
+    cov_change_of_value_listener_add(&listener);
+    cov_change_of_value_listener_add(&listener);
+    cov_change_of_value_listener_add(NULL);
+    cov_change_of_value_notify(OBJECT_ANALOG_INPUT, 2);
+    zassert_equal(Test_COV_Callback_Count, 2, NULL);
+    zassert_equal(Test_COV_Listener_Count, 1, NULL);
+    zassert_equal(Test_COV_Listener_Instance, 2, NULL);
+    /* the listeners are called without the callback */
+    cov_change_of_value_callback_set(NULL);
+    cov_change_of_value_notify(OBJECT_ANALOG_INPUT, 3);
+    zassert_equal(Test_COV_Callback_Count, 2, NULL);
+    zassert_equal(Test_COV_Listener_Count, 2, NULL);
+    cov_change_of_value_listener_remove(&listener);
+    cov_change_of_value_listener_remove(&listener);
+    cov_change_of_value_notify(OBJECT_ANALOG_INPUT, 4);
+    zassert_equal(Test_COV_Listener_Count, 2, NULL);
+}
+
 /**
  * @}
  */
@@ -604,9 +858,13 @@ void test_main(void)
 {
     ztest_test_suite(
         cov_tests, ztest_unit_test(testCOVNotify),
+        ztest_unit_test(testCOVNotifyMultiple),
+        ztest_unit_test(testCOVNotifyMultipleTruncated),
         ztest_unit_test(testCOVSubscribe),
         ztest_unit_test(testCOVSubscribeProperty),
-        ztest_unit_test(test_COV_Value_List_Encode));
+        ztest_unit_test(test_COV_Value_List_Encode),
+        ztest_unit_test(test_COV_Filter),
+        ztest_unit_test(test_COV_Change_Of_Value_Listener));
 
     ztest_run_test_suite(cov_tests);
 }
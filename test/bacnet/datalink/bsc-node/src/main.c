@@ -3388,6 +3388,423 @@ static void test_node_bad_cases(void)
     deinit_node_ev(&node_ev);
 }
 
+/**
+ * @brief Set a connection status timestamp to a second of a day that is
+ *  later than the connections made by the other tests
+ * @param timestamp - the timestamp
+ * @param seconds - second of the day
+ */
+static void node_status_timestamp_set(BACNET_DATE_TIME *timestamp, int seconds)
+{
+    datetime_set_values(
+        timestamp, 2099, 1, 1, (uint8_t)(seconds / 3600),
+        (uint8_t)((seconds / 60) % 60), (uint8_t)(seconds % 60), 0);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(node_test_8, test_node_vmac_index)
+#else
+static void test_node_vmac_index(void)
+#endif
+{
+    BSC_SC_RET ret;
+    BSC_NODE *node = NULL;
+    BSC_NODE_CONF conf = { 0 };
+    BACNET_SC_UUID node_uuid = { 0 };
+    BACNET_SC_VMAC_ADDRESS node_vmac = { 0 };
+    BACNET_SC_VMAC_ADDRESS
+        hub_vmac[BSC_CONF_HUB_FUNCTION_CONNECTION_STATUS_MAX_NUM];
+    BACNET_SC_VMAC_ADDRESS
+        direct_vmac[BSC_CONF_NODE_SWITCH_CONNECTION_STATUS_MAX_NUM];
+    BACNET_SC_VMAC_ADDRESS new_vmac = { 0 };
+    /* two VMAC addresses with the same hash in the indexes of a node */
+    BACNET_SC_VMAC_ADDRESS same_hash_vmac[2] = {
+        { { 0x38, 0x5C, 0x45, 0xE1, 0xB9, 0x7C } },
+        { { 0x1C, 0x33, 0x09, 0x62, 0xF2, 0x25 } }
+    };
+    BACNET_SC_HUB_FUNCTION_CONNECTION_STATUS
+        *hub[BSC_CONF_HUB_FUNCTION_CONNECTION_STATUS_MAX_NUM];
+    BACNET_SC_HUB_FUNCTION_CONNECTION_STATUS *h;
+    BACNET_SC_DIRECT_CONNECTION_STATUS
+        *direct[BSC_CONF_NODE_SWITCH_CONNECTION_STATUS_MAX_NUM];
+    BACNET_SC_DIRECT_CONNECTION_STATUS *d;
+    char node_primary_url[128] = { 0 };
+    int i;
+
+    memset(&node_uuid, 0x1, sizeof(node_uuid));
+    memset(&node_vmac, 0x2, sizeof(node_vmac));
+    snprintf(
+        node_primary_url, sizeof(node_primary_url), "wss://%s:%d",
+        BACNET_LOCALHOST, BACNET_CLOSED_PORT);
+    conf.ca_cert_chain = ca_cert;
+    conf.ca_cert_chain_size = sizeof(ca_cert);
+    conf.cert_chain = node_cert;
+    conf.cert_chain_size = sizeof(node_cert);
+    conf.key = node_key;
+    conf.key_size = sizeof(node_key);
+    conf.local_uuid = &node_uuid;
+    conf.local_vmac = node_vmac;
+    conf.max_local_bvlc_len = MAX_BVLC_LEN;
+    conf.max_local_npdu_len = MAX_NDPU_LEN;
+    conf.connect_timeout_s = BACNET_TIMEOUT;
+    conf.heartbeat_timeout_s = BACNET_INFINITE_TIMEOUT;
+    conf.disconnect_timeout_s = BACNET_TIMEOUT;
+    conf.reconnnect_timeout_s = BACNET_TIMEOUT;
+    conf.address_resolution_timeout_s = BACNET_TIMEOUT;
+    conf.address_resolution_freshness_timeout_s = BACNET_TIMEOUT;
+    conf.primaryURL = node_primary_url;
+    conf.failoverURL = node_primary_url;
+    conf.hub_server_port = BACNET_NODE_LOCAL_HUB_PORT;
+    conf.direct_server_port = BACNET_NODE_LOCAL_DIRECT_PORT;
+    conf.hub_iface = BSC_NETWORK_IFACE;
+    conf.direct_iface = BSC_NETWORK_IFACE;
+    conf.event_func = node_event;
+    ret = bsc_node_init(&conf, &node);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+
+    /* fill the hub function status table with connected peers, each
+       newer than the one before it */
+    for (i = 0; i < BSC_CONF_HUB_FUNCTION_CONNECTION_STATUS_MAX_NUM; i++) {
+        memset(&hub_vmac[i], 0, sizeof(hub_vmac[i]));
+        hub_vmac[i].address[0] = 0x40;
+        hub_vmac[i].address[5] = (uint8_t)i;
+        hub[i] = bsc_node_find_hub_status_for_vmac(node, &hub_vmac[i]);
+        zassert_not_null(hub[i], NULL);
+        zassert_equal(
+            memcmp(
+                hub[i]->Peer_VMAC, hub_vmac[i].address, BVLC_SC_VMAC_SIZE),
+            0, NULL);
+        hub[i]->State = BACNET_SC_CONNECTION_STATE_CONNECTED;
+        node_status_timestamp_set(&hub[i]->Connect_Timestamp, i);
+        memset(
+            &hub[i]->Disconnect_Timestamp, 0xFF,
+            sizeof(hub[i]->Disconnect_Timestamp));
+    }
+    for (i = 0; i < BSC_CONF_HUB_FUNCTION_CONNECTION_STATUS_MAX_NUM; i++) {
+        h = bsc_node_find_hub_status_for_vmac(node, &hub_vmac[i]);
+        zassert_equal(h == hub[i], true, 0);
+    }
+    /* a new peer takes the entry of the oldest one, and is found there */
+    new_vmac.address[0] = 0x41;
+    h = bsc_node_find_hub_status_for_vmac(node, &new_vmac);
+    zassert_equal(h == hub[0], true, 0);
+    zassert_equal(
+        memcmp(h->Peer_VMAC, new_vmac.address, BVLC_SC_VMAC_SIZE), 0, NULL);
+    node_status_timestamp_set(&h->Connect_Timestamp, 100);
+    zassert_equal(
+        bsc_node_find_hub_status_for_vmac(node, &new_vmac) == hub[0], true, 0);
+    for (i = 1; i < BSC_CONF_HUB_FUNCTION_CONNECTION_STATUS_MAX_NUM; i++) {
+        h = bsc_node_find_hub_status_for_vmac(node, &hub_vmac[i]);
+        zassert_equal(h == hub[i], true, 0);
+    }
+    /* the evicted peer is no longer found in its old entry */
+    h = bsc_node_find_hub_status_for_vmac(node, &hub_vmac[0]);
+    zassert_equal(h == hub[1], true, 0);
+    node_status_timestamp_set(&h->Connect_Timestamp, 101);
+    zassert_equal(
+        bsc_node_find_hub_status_for_vmac(node, &new_vmac) == hub[0], true, 0);
+    /* an entry of the index with the same hash and another VMAC is passed
+       over, and the peer gets an entry of its own */
+    h = bsc_node_find_hub_status_for_vmac(node, &same_hash_vmac[0]);
+    node_status_timestamp_set(&h->Connect_Timestamp, 200);
+    zassert_equal(
+        memcmp(h->Peer_VMAC, same_hash_vmac[0].address, BVLC_SC_VMAC_SIZE), 0,
+        NULL);
+    zassert_equal(
+        bsc_node_find_hub_status_for_vmac(node, &same_hash_vmac[1]) == h,
+        false, 0);
+    zassert_equal(
+        bsc_node_find_hub_status_for_vmac(node, &same_hash_vmac[0]) == h, true,
+        0);
+
+    /* the same for the direct connection status table */
+    for (i = 0; i < BSC_CONF_NODE_SWITCH_CONNECTION_STATUS_MAX_NUM; i++) {
+        memset(&direct_vmac[i], 0, sizeof(direct_vmac[i]));
+        direct_vmac[i].address[0] = 0x50;
+        direct_vmac[i].address[5] = (uint8_t)i;
+        direct[i] = bsc_node_find_direct_status_for_vmac(node, &direct_vmac[i]);
+        zassert_not_null(direct[i], NULL);
+        direct[i]->State = BACNET_SC_CONNECTION_STATE_CONNECTED;
+        node_status_timestamp_set(&direct[i]->Connect_Timestamp, i);
+        memset(
+            &direct[i]->Disconnect_Timestamp, 0xFF,
+            sizeof(direct[i]->Disconnect_Timestamp));
+    }
+    new_vmac.address[0] = 0x51;
+    d = bsc_node_find_direct_status_for_vmac(node, &new_vmac);
+    zassert_equal(d == direct[0], true, 0);
+    node_status_timestamp_set(&d->Connect_Timestamp, 100);
+    zassert_equal(
+        bsc_node_find_direct_status_for_vmac(node, &new_vmac) == direct[0],
+        true, 0);
+    for (i = 1; i < BSC_CONF_NODE_SWITCH_CONNECTION_STATUS_MAX_NUM; i++) {
+        d = bsc_node_find_direct_status_for_vmac(node, &direct_vmac[i]);
+        zassert_equal(d == direct[i], true, 0);
+    }
+    d = bsc_node_find_direct_status_for_vmac(node, &direct_vmac[0]);
+    zassert_equal(d == direct[1], true, 0);
+    ret = bsc_node_deinit(node);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+}
+
+
+/**
+ * @brief Send a unicast NPDU from one node to another through the hub
+ *  and wait until the other node receives it
+ */
+static void node_unicast_send(
+    BSC_NODE *node,
+    BACNET_SC_VMAC_ADDRESS *dest,
+    node_ev_t *dest_ev,
+    BSC_NODE *dest_node)
+{
+    uint8_t buf[256];
+    uint8_t npdu[128];
+    size_t len;
+    BSC_SC_RET ret;
+
+    memset(npdu, 0x33, sizeof(npdu));
+    len = bvlc_sc_encode_encapsulated_npdu(
+        buf, sizeof(buf), 113, NULL, dest, npdu, sizeof(npdu));
+    zassert_equal(len > 0, true, NULL);
+    ret = bsc_node_send(node, buf, len);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    wait_specific_node_ev(dest_ev, BSC_NODE_EVENT_RECEIVED_NPDU, dest_node);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(node_test_9, test_node_direct_connection_auto)
+#else
+static void test_node_direct_connection_auto(void)
+#endif
+{
+    BACNET_SC_UUID node_uuid;
+    BACNET_SC_VMAC_ADDRESS node_vmac;
+    BACNET_SC_UUID node_uuid2;
+    BACNET_SC_VMAC_ADDRESS node_vmac2;
+    BACNET_SC_UUID node_uuid3;
+    BACNET_SC_VMAC_ADDRESS node_vmac3;
+    BSC_NODE_CONF conf;
+    BSC_NODE_CONF conf2;
+    BSC_NODE_CONF conf3;
+    BSC_SC_RET ret;
+    BSC_NODE *node;
+    BSC_NODE *node2;
+    BSC_NODE *node3;
+    char node_primary_url[128];
+    char node_secondary_url[128];
+    char node_primary_url2[128];
+    char node_secondary_url2[128];
+    char node_primary_url3[128];
+    char node_secondary_url3[128];
+    char uris[256];
+    int i;
+
+    // test configuration
+    // node is a just a hub
+    // node2 connected to node using hub connector is configured
+    //       to accept direct connections
+    // node3 connected to node using hub connector sends unicast
+    //       traffic to node2 through the hub, and opens a direct
+    //       connection to node2 when the traffic is above the rate
+
+    memset(&node_uuid, 0x1, sizeof(node_uuid));
+    memset(&node_vmac, 0x2, sizeof(node_vmac));
+    memset(&node_uuid2, 0x3, sizeof(node_uuid2));
+    memset(&node_vmac2, 0x4, sizeof(node_vmac2));
+    memset(&node_uuid3, 0x5, sizeof(node_uuid2));
+    memset(&node_vmac3, 0x6, sizeof(node_vmac2));
+
+    snprintf(
+        node_primary_url, sizeof(node_primary_url), "wss://%s:%d",
+        BACNET_LOCALHOST, BACNET_CLOSED_PORT);
+    snprintf(
+        node_secondary_url, sizeof(node_secondary_url), "wss://%s:%d",
+        BACNET_LOCALHOST, BACNET_CLOSED_PORT);
+    snprintf(
+        node_primary_url2, sizeof(node_primary_url2), "wss://%s:%d",
+        BACNET_LOCALHOST, BACNET_NODE_LOCAL_HUB_PORT);
+    snprintf(
+        node_secondary_url2, sizeof(node_secondary_url2), "wss://%s:%d",
+        BACNET_LOCALHOST, BACNET_CLOSED_PORT);
+    snprintf(
+        node_primary_url3, sizeof(node_primary_url3), "wss://%s:%d",
+        BACNET_LOCALHOST, BACNET_NODE_LOCAL_HUB_PORT);
+    snprintf(
+        node_secondary_url3, sizeof(node_secondary_url3), "wss://%s:%d",
+        BACNET_LOCALHOST, BACNET_CLOSED_PORT);
+
+    conf.ca_cert_chain = ca_cert;
+    conf.ca_cert_chain_size = sizeof(ca_cert);
+    conf.cert_chain = node_cert;
+    conf.cert_chain_size = sizeof(node_cert);
+    conf.key = node_key;
+    conf.key_size = sizeof(node_key);
+    conf.local_uuid = &node_uuid;
+    conf.local_vmac = node_vmac;
+    conf.max_local_bvlc_len = MAX_BVLC_LEN;
+    conf.max_local_npdu_len = MAX_NDPU_LEN;
+    conf.connect_timeout_s = BACNET_TIMEOUT;
+    conf.heartbeat_timeout_s = BACNET_INFINITE_TIMEOUT;
+    conf.disconnect_timeout_s = BACNET_TIMEOUT;
+    conf.reconnnect_timeout_s = BACNET_TIMEOUT;
+    conf.address_resolution_timeout_s = BACNET_TIMEOUT;
+    conf.address_resolution_freshness_timeout_s = BACNET_TIMEOUT;
+    conf.primaryURL = node_primary_url;
+    conf.failoverURL = node_secondary_url;
+    conf.hub_server_port = BACNET_NODE_LOCAL_HUB_PORT;
+    conf.direct_server_port = BACNET_NODE_LOCAL_DIRECT_PORT;
+    conf.hub_iface = BSC_NETWORK_IFACE;
+    conf.direct_iface = BSC_NETWORK_IFACE;
+    conf.direct_connect_accept_enable = false;
+    conf.direct_connect_initiate_enable = false;
+    conf.hub_function_enabled = true;
+    conf.direct_connection_accept_uris = NULL;
+    conf.direct_connection_accept_uris_len = 0;
+    conf.event_func = node_event;
+
+    snprintf(
+        uris, sizeof(uris), "wss://%s:%d wss://%s:%d", BACNET_LOCALHOST,
+        BACNET_NODE_LOCAL_DIRECT_PORT2, BACNET_LOCALHOST,
+        BACNET_NODE_LOCAL_DIRECT_PORT2);
+    conf2.ca_cert_chain = ca_cert;
+    conf2.ca_cert_chain_size = sizeof(ca_cert);
+    conf2.cert_chain = node_cert;
+    conf2.cert_chain_size = sizeof(node_cert);
+    conf2.key = node_key;
+    conf2.key_size = sizeof(node_key);
+    conf2.local_uuid = &node_uuid2;
+    conf2.local_vmac = node_vmac2;
+    conf2.max_local_bvlc_len = MAX_BVLC_LEN;
+    conf2.max_local_npdu_len = MAX_NDPU_LEN;
+    conf2.connect_timeout_s = BACNET_TIMEOUT;
+    conf2.heartbeat_timeout_s = BACNET_INFINITE_TIMEOUT;
+    conf2.disconnect_timeout_s = BACNET_TIMEOUT;
+    conf2.reconnnect_timeout_s = BACNET_TIMEOUT;
+    conf2.address_resolution_timeout_s = BACNET_TIMEOUT;
+    conf2.address_resolution_freshness_timeout_s = BACNET_TIMEOUT;
+    conf2.primaryURL = node_primary_url2;
+    conf2.failoverURL = node_secondary_url2;
+    conf2.hub_server_port = 0;
+    conf2.direct_server_port = BACNET_NODE_LOCAL_DIRECT_PORT2;
+    conf2.hub_iface = BSC_NETWORK_IFACE;
+    conf2.direct_iface = BSC_NETWORK_IFACE;
+    conf2.direct_connect_accept_enable = true;
+    conf2.direct_connect_initiate_enable = true;
+    conf2.hub_function_enabled = false;
+    conf2.direct_connection_accept_uris = uris;
+    conf2.direct_connection_accept_uris_len = strlen(uris);
+    conf2.event_func = node_event2;
+
+    conf3.ca_cert_chain = ca_cert;
+    conf3.ca_cert_chain_size = sizeof(ca_cert);
+    conf3.cert_chain = node_cert;
+    conf3.cert_chain_size = sizeof(node_cert);
+    conf3.key = NODE_KEY;
+    conf3.key_size = sizeof(NODE_KEY);
+    conf3.local_uuid = &node_uuid3;
+    conf3.local_vmac = node_vmac3;
+    conf3.max_local_bvlc_len = MAX_BVLC_LEN;
+    conf3.max_local_npdu_len = MAX_NDPU_LEN;
+    conf3.connect_timeout_s = BACNET_TIMEOUT;
+    conf3.heartbeat_timeout_s = BACNET_INFINITE_TIMEOUT;
+    conf3.disconnect_timeout_s = BACNET_TIMEOUT;
+    conf3.reconnnect_timeout_s = BACNET_TIMEOUT;
+    conf3.address_resolution_timeout_s = BACNET_TIMEOUT;
+    conf3.address_resolution_freshness_timeout_s = BACNET_TIMEOUT;
+    conf3.primaryURL = node_primary_url3;
+    conf3.failoverURL = node_secondary_url3;
+    conf3.hub_server_port = 0;
+    conf3.direct_server_port = BACNET_NODE_LOCAL_DIRECT_PORT3;
+    conf3.hub_iface = BSC_NETWORK_IFACE;
+    conf3.direct_iface = BSC_NETWORK_IFACE;
+    conf3.direct_connect_accept_enable = true;
+    conf3.direct_connect_initiate_enable = true;
+    conf3.hub_function_enabled = false;
+    conf3.direct_connection_accept_uris = NULL;
+    conf3.direct_connection_accept_uris_len = 0;
+    conf3.event_func = node_event3;
+
+    init_node_ev(&node_ev);
+    init_node_ev(&node_ev2);
+    init_node_ev(&node_ev3);
+
+    ret = bsc_node_init(&conf, &node);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    ret = bsc_node_init(&conf2, &node2);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    ret = bsc_node_init(&conf3, &node3);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+
+    ret = bsc_node_start(node);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    zassert_equal(
+        wait_node_ev(&node_ev, BSC_NODE_EVENT_STARTED, node), true, 0);
+    ret = bsc_node_start(node2);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    zassert_equal(
+        wait_node_ev(&node_ev2, BSC_NODE_EVENT_STARTED, node2), true, 0);
+    ret = bsc_node_start(node3);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    zassert_equal(
+        wait_node_ev(&node_ev3, BSC_NODE_EVENT_STARTED, node3), true, 0);
+    // wait while node3 and node2 connects to node
+    wait_for_connection_to_hub(&node_ev3, node3);
+    wait_for_connection_to_hub(&node_ev2, node2);
+
+    // a PDU is about 140 octets, so one PDU in a window is below
+    // the rate of 50 octets per second, and ten are above it
+    bsc_node_switch_auto_connect_set(50, 1, BACNET_TIMEOUT);
+    node_unicast_send(node3, &node_vmac2, &node_ev2, node2);
+    wait_sec(BSC_CONF_NODE_SWITCH_AUTO_WINDOW_S);
+    zassert_equal(
+        bsc_node_direct_connection_established(node3, &node_vmac2, NULL, 0),
+        false, 0);
+
+    // more PDUs in a window are above the rate, so node3 resolves
+    // the address of node2 and opens a direct connection to it
+    for (i = 0; i < 10; i++) {
+        node_unicast_send(node3, &node_vmac2, &node_ev2, node2);
+    }
+    wait_specific_node_ev(&node_ev3, BSC_NODE_EVENT_DIRECT_CONNECTED, node3);
+    ret = memcmp(
+        &node_vmac2.address[0], &node_ev3.dest.address[0],
+        sizeof(node_ev3.dest.address));
+    zassert_equal(ret, 0, NULL);
+    zassert_equal(
+        bsc_node_direct_connection_established(node3, &node_vmac2, NULL, 0),
+        true, 0);
+    node_unicast_send(node3, &node_vmac2, &node_ev2, node2);
+
+    // the connection closes once it was idle for the idle time
+    wait_specific_node_ev(&node_ev3, BSC_NODE_EVENT_DIRECT_DISCONNECTED, node3);
+    ret = memcmp(
+        &node_vmac2.address[0], &node_ev3.dest.address[0],
+        sizeof(node_ev3.dest.address));
+    zassert_equal(ret, 0, NULL);
+    zassert_equal(
+        bsc_node_direct_connection_established(node3, &node_vmac2, NULL, 0),
+        false, 0);
+    bsc_node_switch_auto_connect_set(
+        0, BSC_CONF_NODE_SWITCH_AUTO_LINKS_NUM,
+        BSC_CONF_NODE_SWITCH_AUTO_IDLE_S);
+
+    bsc_node_stop(node);
+    wait_specific_node_ev(&node_ev, BSC_NODE_EVENT_STOPPED, node);
+    bsc_node_stop(node2);
+    wait_specific_node_ev(&node_ev2, BSC_NODE_EVENT_STOPPED, node2);
+    bsc_node_stop(node3);
+    wait_specific_node_ev(&node_ev3, BSC_NODE_EVENT_STOPPED, node3);
+    ret = bsc_node_deinit(node);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    ret = bsc_node_deinit(node2);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    ret = bsc_node_deinit(node3);
+    zassert_equal(ret == BSC_SC_SUCCESS, true, 0);
+    deinit_node_ev(&node_ev);
+    deinit_node_ev(&node_ev2);
+    deinit_node_ev(&node_ev3);
+}
 #if defined(CONFIG_ZTEST_NEW_API)
 static void *suite_setup(void)
 {
@@ -3402,6 +3819,8 @@ ZTEST_SUITE(node_test_4, NULL, suite_setup, NULL, NULL, NULL);
 ZTEST_SUITE(node_test_5, NULL, suite_setup, NULL, NULL, NULL);
 ZTEST_SUITE(node_test_6, NULL, suite_setup, NULL, NULL, NULL);
 ZTEST_SUITE(node_test_7, NULL, suite_setup, NULL, NULL, NULL);
+ZTEST_SUITE(node_test_8, NULL, suite_setup, NULL, NULL, NULL);
+ZTEST_SUITE(node_test_9, NULL, suite_setup, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
@@ -3417,6 +3836,9 @@ void test_main(void)
     ztest_test_suite(
         node_test_6, ztest_unit_test(test_node_direct_connection_unsupported));
     ztest_test_suite(node_test_7, ztest_unit_test(test_node_bad_cases));
+    ztest_test_suite(node_test_8, ztest_unit_test(test_node_vmac_index));
+    ztest_test_suite(
+        node_test_9, ztest_unit_test(test_node_direct_connection_auto));
     ztest_run_test_suite(node_test_1);
     ztest_run_test_suite(node_test_2);
     ztest_run_test_suite(node_test_3);
@@ -3424,5 +3846,7 @@ void test_main(void)
     ztest_run_test_suite(node_test_5);
     ztest_run_test_suite(node_test_6);
     ztest_run_test_suite(node_test_7);
+    ztest_run_test_suite(node_test_8);
+    ztest_run_test_suite(node_test_9);
 }
 #endif
@@ -2370,6 +2370,282 @@ static void test_error_case1(void)
     deinit_ctx_ev(&srv_ctx_ev);
 }
 
+/* message IDs of the encapsulated NPDUs received by each client */
+#define RECV_IDS_MAX 256
+static uint16_t recv_ids[2][RECV_IDS_MAX];
+static size_t recv_ids_num[2];
+
+static void record_socket_event(
+    size_t n,
+    sock_ev_t *sev,
+    BSC_SOCKET_EVENT ev,
+    BACNET_ERROR_CODE reason,
+    BVLC_SC_DECODED_MESSAGE *decoded_pdu)
+{
+    bws_dispatch_lock();
+    if (ev == BSC_SOCKET_EVENT_RECEIVED) {
+        if (decoded_pdu->hdr.bvlc_function == BVLC_SC_ENCAPSULATED_NPDU &&
+            recv_ids_num[n] < RECV_IDS_MAX) {
+            recv_ids[n][recv_ids_num[n]++] = decoded_pdu->hdr.message_id;
+        }
+    } else {
+        signal_sock_ev(sev, ev, reason);
+    }
+    bws_dispatch_unlock();
+}
+
+static void cli_record_socket_event(
+    BSC_SOCKET *c,
+    BSC_SOCKET_EVENT ev,
+    BACNET_ERROR_CODE reason,
+    const char *reason_desc,
+    uint8_t *pdu,
+    size_t pdu_len,
+    BVLC_SC_DECODED_MESSAGE *decoded_pdu)
+{
+    (void)c;
+    (void)reason_desc;
+    (void)pdu;
+    (void)pdu_len;
+    record_socket_event(0, &cli_ev, ev, reason, decoded_pdu);
+}
+
+static void cli_record_socket_event2(
+    BSC_SOCKET *c,
+    BSC_SOCKET_EVENT ev,
+    BACNET_ERROR_CODE reason,
+    const char *reason_desc,
+    uint8_t *pdu,
+    size_t pdu_len,
+    BVLC_SC_DECODED_MESSAGE *decoded_pdu)
+{
+    (void)c;
+    (void)reason_desc;
+    (void)pdu;
+    (void)pdu_len;
+    record_socket_event(1, &cli_ev2, ev, reason, decoded_pdu);
+}
+
+static void wait_recv_ids(size_t n, size_t num)
+{
+    call_maintenance_timer(1, 0);
+    while (1) {
+        bws_dispatch_lock();
+        if (recv_ids_num[n] >= num) {
+            bws_dispatch_unlock();
+            return;
+        }
+        bws_dispatch_unlock();
+        bsc_wait_ms(WAIT_EVENT_MS);
+        call_maintenance_timer(0, WAIT_EVENT_MS);
+    }
+}
+
+static size_t
+encode_npdu(uint8_t *buf, size_t buf_len, uint16_t message_id, size_t len)
+{
+    uint8_t npdu[200];
+
+    memset(npdu, 0x55, sizeof(npdu));
+    zassert_equal(len <= sizeof(npdu), true, 0);
+    return bvlc_sc_encode_encapsulated_npdu(
+        buf, buf_len, message_id, NULL, NULL, npdu, len);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(socket_test_7, test_send_queue)
+#else
+static void test_send_queue(void)
+#endif
+{
+    BSC_CONTEXT_CFG server_cfg;
+    BSC_CONTEXT_CFG client_cfg;
+    BSC_CONTEXT_CFG client_cfg2;
+    BACNET_SC_UUID server_uuid;
+    BACNET_SC_VMAC_ADDRESS server_vmac;
+    BACNET_SC_UUID client_uuid;
+    BACNET_SC_VMAC_ADDRESS client_vmac;
+    BACNET_SC_UUID client_uuid2;
+    BACNET_SC_VMAC_ADDRESS client_vmac2;
+    BSC_SC_RET ret;
+    BSC_SOCKET_CTX_FUNCS srv_funcs = { simple_find_connection_for_vmac,
+                                       srv_find_connection_for_uuid,
+                                       srv_simple_socket_event,
+                                       srv_simple_context_event, NULL };
+
+    BSC_SOCKET_CTX_FUNCS cli_funcs = { simple_find_connection_for_vmac,
+                                       simple_find_connection_for_uuid,
+                                       cli_record_socket_event,
+                                       cli_simple_context_event, NULL };
+    BSC_SOCKET_CTX_FUNCS cli_funcs2 = { simple_find_connection_for_vmac,
+                                        simple_find_connection_for_uuid,
+                                        cli_record_socket_event2,
+                                        cli_simple_context_event2, NULL };
+
+    BSC_SOCKET_CTX srv_ctx;
+    BSC_SOCKET_CTX cli_ctx;
+    BSC_SOCKET_CTX cli_ctx2;
+    BSC_SOCKET *srv_sock1;
+    char url[128];
+    uint8_t buf[256];
+    size_t len;
+    size_t num;
+    size_t i;
+
+    init_sock_ev(&cli_ev);
+    init_sock_ev(&cli_ev2);
+    init_sock_ev(&srv_ev);
+    init_ctx_ev(&cli_ctx_ev);
+    init_ctx_ev(&cli_ctx_ev2);
+    init_ctx_ev(&srv_ctx_ev);
+    memset(recv_ids_num, 0, sizeof(recv_ids_num));
+
+    memset(&srv_ctx, 0, sizeof(srv_ctx));
+    memset(&cli_ctx, 0, sizeof(cli_ctx));
+    memset(&cli_ctx2, 0, sizeof(cli_ctx));
+    memset(&server_uuid, 0x1, sizeof(server_uuid));
+    memset(&server_vmac, 0x2, sizeof(server_vmac));
+    memset(&client_uuid, 0x3, sizeof(server_uuid));
+    memset(&client_vmac, 0x4, sizeof(server_vmac));
+    memset(&client_uuid2, 0x6, sizeof(server_uuid));
+    memset(&client_vmac2, 0x5, sizeof(server_vmac));
+
+    snprintf(
+        url, sizeof(url), "wss://%s:%d", BACNET_WEBSOCKET_SERVER_ADDR,
+        BACNET_WEBSOCKET_SERVER_PORT);
+
+    bsc_init_ctx_cfg(
+        BSC_SOCKET_CTX_ACCEPTOR, &server_cfg, BSC_WEBSOCKET_DIRECT_PROTOCOL,
+        BACNET_WEBSOCKET_SERVER_PORT, BSC_NETWORK_IFACE, ca_cert,
+        sizeof(ca_cert), server_cert, sizeof(server_cert), server_key,
+        sizeof(server_key), &server_uuid, &server_vmac, MAX_BVLC_LEN,
+        MAX_NDPU_LEN, BACNET_SOCKET_TIMEOUT, BACNET_SOCKET_HEARTBEAT_TIMEOUT,
+        BACNET_SOCKET_TIMEOUT);
+
+    bsc_init_ctx_cfg(
+        BSC_SOCKET_CTX_INITIATOR, &client_cfg, BSC_WEBSOCKET_DIRECT_PROTOCOL,
+        BACNET_WEBSOCKET_SERVER_PORT, BSC_NETWORK_IFACE, ca_cert,
+        sizeof(ca_cert), client_cert, sizeof(client_cert), CLIENT_KEY,
+        sizeof(CLIENT_KEY), &client_uuid, &client_vmac, MAX_BVLC_LEN,
+        MAX_NDPU_LEN, BACNET_SOCKET_TIMEOUT, BACNET_SOCKET_HEARTBEAT_TIMEOUT,
+        BACNET_SOCKET_TIMEOUT);
+
+    bsc_init_ctx_cfg(
+        BSC_SOCKET_CTX_INITIATOR, &client_cfg2, BSC_WEBSOCKET_DIRECT_PROTOCOL,
+        BACNET_WEBSOCKET_SERVER_PORT, BSC_NETWORK_IFACE, ca_cert,
+        sizeof(ca_cert), client_cert, sizeof(client_cert), CLIENT_KEY,
+        sizeof(CLIENT_KEY), &client_uuid2, &client_vmac2, MAX_BVLC_LEN,
+        MAX_NDPU_LEN, BACNET_SOCKET_TIMEOUT, BACNET_SOCKET_HEARTBEAT_TIMEOUT,
+        BACNET_SOCKET_TIMEOUT);
+
+    ret = bsc_init_ctx(
+        &srv_ctx, &server_cfg, &srv_funcs, srv_socks, MAX_SERVER_SOCKETS, NULL);
+    zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    zassert_equal(wait_ctx_ev(&srv_ctx_ev, BSC_CTX_INITIALIZED), true, 0);
+    ret = bsc_init_ctx(
+        &cli_ctx, &client_cfg, &cli_funcs, cli_socks, MAX_CLIENT_SOCKETS, NULL);
+    zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    zassert_equal(wait_ctx_ev(&cli_ctx_ev, BSC_CTX_INITIALIZED), true, 0);
+    ret = bsc_init_ctx(
+        &cli_ctx2, &client_cfg2, &cli_funcs2, cli_socks2, MAX_CLIENT_SOCKETS,
+        NULL);
+    zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    zassert_equal(wait_ctx_ev(&cli_ctx_ev2, BSC_CTX_INITIALIZED), true, 0);
+    ret = bsc_connect(&cli_ctx, &cli_socks[0], url);
+    zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    zassert_equal(wait_sock_ev(&cli_ev, BSC_SOCKET_EVENT_CONNECTED), true, 0);
+    zassert_equal(wait_sock_ev(&srv_ev, BSC_SOCKET_EVENT_CONNECTED), true, 0);
+    srv_sock1 = srv_sock;
+    ret = bsc_connect(&cli_ctx2, &cli_socks2[0], url);
+    zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    zassert_equal(wait_sock_ev(&cli_ev2, BSC_SOCKET_EVENT_CONNECTED), true, 0);
+    zassert_equal(wait_sock_ev(&srv_ev, BSC_SOCKET_EVENT_CONNECTED), true, 0);
+
+    // the dispatch lock holds the frames in the send queues, so the
+    // broadcasts and the unicasts are interleaved in the queue of
+    // the first socket. Each queue must be drained in order.
+    bws_dispatch_lock();
+    for (i = 0; i < 3; i++) {
+        len = encode_npdu(buf, sizeof(buf), 100 + i, 10);
+        ret = bsc_send_broadcast(&srv_ctx, NULL, buf, len);
+        zassert_equal(ret, BSC_SC_SUCCESS, 0);
+        len = encode_npdu(buf, sizeof(buf), 200 + i, 10);
+        ret = bsc_send(srv_sock1, buf, len);
+        zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    }
+    len = encode_npdu(buf, sizeof(buf), 103, 10);
+    ret = bsc_send_broadcast(&srv_ctx, srv_sock1, buf, len);
+    zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    bws_dispatch_unlock();
+    wait_recv_ids(0, 6);
+    wait_recv_ids(1, 4);
+    bws_dispatch_lock();
+    zassert_equal(recv_ids_num[0] == 6, true, 0);
+    zassert_equal(recv_ids_num[1] == 4, true, 0);
+    for (i = 0; i < 3; i++) {
+        zassert_equal(recv_ids[0][2 * i] == 100 + i, true, 0);
+        zassert_equal(recv_ids[0][2 * i + 1] == 200 + i, true, 0);
+        zassert_equal(recv_ids[1][i] == 100 + i, true, 0);
+    }
+    zassert_equal(recv_ids[1][3] == 103, true, 0);
+    memset(recv_ids_num, 0, sizeof(recv_ids_num));
+    bws_dispatch_unlock();
+
+    // fill the queue of the first socket sooner with a larger unicast,
+    // then broadcast until a queue is full. That uses all of the shared
+    // buffers and then the copies. The full queue drops the broadcast
+    // only for its own socket.
+    bws_dispatch_lock();
+    len = encode_npdu(buf, sizeof(buf), 299, 200);
+    ret = bsc_send(srv_sock1, buf, len);
+    zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    for (num = 0; num < RECV_IDS_MAX - 2; num++) {
+        len = encode_npdu(buf, sizeof(buf), 300 + num, 10);
+        ret = bsc_send_broadcast(&srv_ctx, NULL, buf, len);
+        if (ret != BSC_SC_SUCCESS) {
+            break;
+        }
+    }
+    zassert_equal(ret, BSC_SC_NO_RESOURCES, 0);
+    zassert_equal(num > BSC_CONF_SOCK_SHARED_TX_BUFFERS_NUM, true, 0);
+    bws_dispatch_unlock();
+    wait_recv_ids(0, num + 1);
+    wait_recv_ids(1, num + 1);
+    bws_dispatch_lock();
+    zassert_equal(recv_ids_num[0] == num + 1, true, 0);
+    zassert_equal(recv_ids_num[1] == num + 1, true, 0);
+    zassert_equal(recv_ids[0][0] == 299, true, 0);
+    for (i = 0; i < num; i++) {
+        zassert_equal(recv_ids[0][i + 1] == 300 + i, true, 0);
+        zassert_equal(recv_ids[1][i] == 300 + i, true, 0);
+    }
+    zassert_equal(recv_ids[1][num] == 300 + num, true, 0);
+    memset(recv_ids_num, 0, sizeof(recv_ids_num));
+    bws_dispatch_unlock();
+
+    // the drained queues take broadcasts again
+    len = encode_npdu(buf, sizeof(buf), 400, 10);
+    ret = bsc_send_broadcast(&srv_ctx, NULL, buf, len);
+    zassert_equal(ret, BSC_SC_SUCCESS, 0);
+    wait_recv_ids(0, 1);
+    wait_recv_ids(1, 1);
+    zassert_equal(recv_ids[0][0] == 400, true, 0);
+    zassert_equal(recv_ids[1][0] == 400, true, 0);
+
+    bsc_deinit_ctx(&cli_ctx);
+    zassert_equal(wait_ctx_ev(&cli_ctx_ev, BSC_CTX_DEINITIALIZED), true, 0);
+    bsc_deinit_ctx(&cli_ctx2);
+    zassert_equal(wait_ctx_ev(&cli_ctx_ev2, BSC_CTX_DEINITIALIZED), true, 0);
+    bsc_deinit_ctx(&srv_ctx);
+    zassert_equal(wait_ctx_ev(&srv_ctx_ev, BSC_CTX_DEINITIALIZED), true, 0);
+    deinit_sock_ev(&cli_ev);
+    deinit_sock_ev(&cli_ev2);
+    deinit_sock_ev(&srv_ev);
+    deinit_ctx_ev(&cli_ctx_ev);
+    deinit_ctx_ev(&cli_ctx_ev2);
+    deinit_ctx_ev(&srv_ctx_ev);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 static void *suite_setup(void)
 {
@@ -2383,6 +2659,7 @@ ZTEST_SUITE(socket_test_3, NULL, suite_setup, NULL, NULL, NULL);
 ZTEST_SUITE(socket_test_4, NULL, suite_setup, NULL, NULL, NULL);
 ZTEST_SUITE(socket_test_5, NULL, suite_setup, NULL, NULL, NULL);
 ZTEST_SUITE(socket_test_6, NULL, suite_setup, NULL, NULL, NULL);
+ZTEST_SUITE(socket_test_7, NULL, suite_setup, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
@@ -2398,11 +2675,13 @@ void test_main(void)
         socket_test_4, ztest_unit_test(test_duplicated_uuid_on_server));
     ztest_test_suite(socket_test_5, ztest_unit_test(test_bad_params));
     ztest_test_suite(socket_test_6, ztest_unit_test(test_error_case1));
+    ztest_test_suite(socket_test_7, ztest_unit_test(test_send_queue));
     ztest_run_test_suite(socket_test_1);
     ztest_run_test_suite(socket_test_2);
     ztest_run_test_suite(socket_test_3);
     ztest_run_test_suite(socket_test_4);
     ztest_run_test_suite(socket_test_5);
     ztest_run_test_suite(socket_test_6);
+    ztest_run_test_suite(socket_test_7);
 }
 #endif
@@ -210,6 +210,22 @@ static void test_header_modifications(
         zassert_equal(
             memcmp(&test.address, message.hdr.origin, sizeof(test.address)), 0,
             NULL);
+        /* the decoded message is changed with the pdu, without decoding */
+        memcpy(buf, pdu, pdu_size);
+        ppdu = buf;
+        ret = bvlc_sc_decode_message(
+            ppdu, pdu_size, &message, &error_code, &error_class, &err_desc);
+        zassert_equal(ret, true, NULL);
+        len = bvlc_sc_set_orig_decoded(&ppdu, pdu_size, &test, &message);
+        zassert_equal(ppdu + len, buf + pdu_size, NULL);
+        ret = verify_bsc_bvll_header(
+            &message.hdr, bvlc_function, message_id, &test, dest,
+            dest_options_absent, data_options_absent, payload_len);
+        zassert_equal(ret, true, NULL);
+        zassert_equal(message.hdr.payload_len, payload_len, NULL);
+        res = memcmp(message.hdr.payload, payload, payload_len);
+        zassert_equal(res, 0, NULL);
+        zassert_equal((uint8_t *)message.hdr.origin, &ppdu[4], NULL);
     } else {
         len = pdu_size;
     }
@@ -1017,6 +1017,49 @@ static void test_BVLC_BBMD_Address(void)
     zassert_false(status, NULL);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bvlc_tests, test_BVLC_Network_Priority)
+#else
+static void test_BVLC_Network_Priority(void)
+#endif
+{
+    /* NPDU protocol version, control octet, and an APDU octet */
+    uint8_t npdu[3] = { BACNET_PROTOCOL_VERSION, 0, 0 };
+    uint16_t npdu_len = sizeof(npdu);
+    uint8_t pdu[60] = { 0 };
+    BACNET_IP_ADDRESS address = { 0 };
+    BACNET_MESSAGE_PRIORITY priority;
+    int pdu_len;
+
+    for (priority = MESSAGE_PRIORITY_NORMAL;
+         priority <= MESSAGE_PRIORITY_LIFE_SAFETY; priority++) {
+        /* expecting reply bit, so the priority is not the whole octet */
+        npdu[1] = BIT(2) | priority;
+        pdu_len =
+            bvlc_encode_original_unicast(pdu, sizeof(pdu), npdu, npdu_len);
+        zassert_equal(
+            bvlc_network_priority(pdu, (uint16_t)pdu_len), priority, NULL);
+        pdu_len =
+            bvlc_encode_original_broadcast(pdu, sizeof(pdu), npdu, npdu_len);
+        zassert_equal(
+            bvlc_network_priority(pdu, (uint16_t)pdu_len), priority, NULL);
+        pdu_len = bvlc_encode_forwarded_npdu(
+            pdu, sizeof(pdu), &address, npdu, npdu_len);
+        zassert_equal(
+            bvlc_network_priority(pdu, (uint16_t)pdu_len), priority, NULL);
+        /* too short to hold the control octet */
+        zassert_equal(
+            bvlc_network_priority(pdu, 11), MESSAGE_PRIORITY_NORMAL, NULL);
+    }
+    /* no NPDU */
+    pdu_len = bvlc_encode_register_foreign_device(pdu, sizeof(pdu), 60);
+    zassert_equal(
+        bvlc_network_priority(pdu, (uint16_t)pdu_len), MESSAGE_PRIORITY_NORMAL,
+        NULL);
+    zassert_equal(
+        bvlc_network_priority(NULL, 0), MESSAGE_PRIORITY_NORMAL, NULL);
+}
+
 /**
  * @}
  */
@@ -1042,7 +1085,8 @@ void test_main(void)
         ztest_unit_test(test_BVLC_Address_Copy),
         ztest_unit_test(test_BVLC_Address_Get_Set),
         ztest_unit_test(test_BVLC_BBMD_Address),
-        ztest_unit_test(test_BVLC_Network_Port_Foreign_Device));
+        ztest_unit_test(test_BVLC_Network_Port_Foreign_Device),
+        ztest_unit_test(test_BVLC_Network_Priority));
 
     ztest_run_test_suite(bvlc_tests);
 }
@@ -7,7 +7,9 @@
  */
 #include <zephyr/ztest.h>
 #include <stdlib.h>
+#include <string.h>
 #include <bacnet/datalink/cobs.h>
+#include <bacnet/datalink/mstpdef.h>
 #include <bacnet/basic/sys/bytes.h>
 
 /**
@@ -49,6 +51,247 @@ static void test_COBS_Encode_Decode(void)
     zassert_true(
         test_buffer_length == sizeof(buffer), "COBS encode/decode length fail");
 }
+
+/**
+ * @brief Test the CRC32K of a block against the CRC32K of each octet
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cobs_tests, test_COBS_CRC32K_Block)
+#else
+static void test_COBS_CRC32K_Block(void)
+#endif
+{
+    uint8_t frame[1497];
+    uint32_t crc;
+    size_t i, length;
+
+    for (i = 0; i < sizeof(frame); i++) {
+        frame[i] = (uint8_t)(i * 7 + 3);
+    }
+    crc = cobs_crc32k_block(frame, sizeof(frame), CRC32K_INITIAL_VALUE);
+    zassert_equal(crc, 0x1D82A62F, NULL);
+    /* every alignment of the remainder */
+    for (length = 0; length < 16; length++) {
+        crc = CRC32K_INITIAL_VALUE;
+        for (i = 0; i < length; i++) {
+            crc = cobs_crc32k(frame[i + 1], crc);
+        }
+        zassert_equal(
+            cobs_crc32k_block(&frame[1], length, CRC32K_INITIAL_VALUE), crc,
+            NULL);
+    }
+}
+/**
+ * @brief Encode one octet at a time, as in the BACnet standard
+ */
+static size_t reference_cobs_encode(
+    uint8_t *buffer,
+    size_t buffer_size,
+    const uint8_t *from,
+    size_t length,
+    uint8_t mask)
+{
+    size_t code_index = 0;
+    size_t read_index = 0;
+    size_t write_index = 1;
+    uint8_t code = 1;
+    uint8_t data = 0;
+    uint8_t last_code = 0;
+
+    if ((buffer_size < 1) || (length < 1)) {
+        return 0;
+    }
+    while (read_index < length) {
+        data = from[read_index++];
+        if (data != 0) {
+            if (write_index == buffer_size) {
+                return 0;
+            }
+            buffer[write_index++] = data ^ mask;
+            code++;
+            if (code != 255) {
+                continue;
+            }
+        }
+        last_code = code;
+        if (code_index == buffer_size) {
+            return 0;
+        }
+        buffer[code_index] = code ^ mask;
+        code_index = write_index++;
+        code = 1;
+    }
+    if ((last_code == 255) && (code == 1)) {
+        write_index--;
+    } else {
+        if (code_index == buffer_size) {
+            return 0;
+        }
+        buffer[code_index] = code ^ mask;
+    }
+
+    return write_index;
+}
+
+/**
+ * @brief Decode one octet at a time, as in the BACnet standard
+ */
+static size_t reference_cobs_decode(
+    uint8_t *buffer,
+    size_t buffer_size,
+    const uint8_t *from,
+    size_t length,
+    uint8_t mask)
+{
+    size_t read_index = 0;
+    size_t write_index = 0;
+    uint8_t code, last_code;
+
+    while (read_index < length) {
+        code = from[read_index] ^ mask;
+        last_code = code;
+        if ((code == 0) || ((read_index + code) > length)) {
+            return 0;
+        }
+        read_index++;
+        while (--code > 0) {
+            if (write_index == buffer_size) {
+                return 0;
+            }
+            if (read_index == length) {
+                return 0;
+            }
+            buffer[write_index++] = from[read_index++] ^ mask;
+        }
+        if ((last_code != 255) && (read_index < length)) {
+            if (write_index == buffer_size) {
+                return 0;
+            }
+            buffer[write_index++] = 0;
+        }
+    }
+
+    return write_index;
+}
+
+/**
+ * @brief Fill the data with non-zero octets and a zero at every interval
+ */
+static void test_data_fill(uint8_t *data, size_t length, size_t interval)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        data[i] = (uint8_t)((i % 255) + 1);
+        if (interval && ((i % interval) == (interval - 1))) {
+            data[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Compare the encoding and the decoding of the data with the
+ *  octet at a time functions of the BACnet standard
+ */
+static void test_cobs_compare(const uint8_t *data, size_t length)
+{
+    static uint8_t encoded[COBS_ENCODED_SIZE(1497) + COBS_ENCODED_CRC_SIZE];
+    static uint8_t expected[COBS_ENCODED_SIZE(1497) + COBS_ENCODED_CRC_SIZE];
+    static uint8_t decoded[1497];
+    static uint8_t reference[1497];
+    size_t encoded_len, expected_len, decoded_len, reference_len, size;
+    uint32_t crc;
+    uint8_t crc_buffer[4];
+
+    expected_len = reference_cobs_encode(
+        expected, sizeof(expected), data, length, MSTP_PREAMBLE_X55);
+    encoded_len =
+        cobs_encode(encoded, sizeof(encoded), data, length, MSTP_PREAMBLE_X55);
+    zassert_equal(encoded_len, expected_len, "length=%u", (unsigned)length);
+    zassert_equal(memcmp(encoded, expected, encoded_len), 0, NULL);
+    /* the same errors for a buffer that is too small */
+    for (size = expected_len - 2; size <= expected_len; size++) {
+        zassert_equal(
+            cobs_encode(encoded, size, data, length, MSTP_PREAMBLE_X55),
+            reference_cobs_encode(
+                expected, size, data, length, MSTP_PREAMBLE_X55),
+            NULL);
+    }
+    reference_len = reference_cobs_decode(
+        reference, sizeof(reference), expected, expected_len,
+        MSTP_PREAMBLE_X55);
+    decoded_len = cobs_decode(
+        decoded, sizeof(decoded), expected, expected_len, MSTP_PREAMBLE_X55);
+    zassert_equal(decoded_len, reference_len, NULL);
+    zassert_equal(decoded_len, length, NULL);
+    zassert_equal(memcmp(decoded, data, length), 0, NULL);
+    zassert_equal(
+        cobs_decode(
+            decoded, length - 1, expected, expected_len, MSTP_PREAMBLE_X55),
+        reference_cobs_decode(
+            reference, length - 1, expected, expected_len, MSTP_PREAMBLE_X55),
+        NULL);
+    /* the frame is the standard encoding with a separate CRC pass */
+    crc = ~cobs_crc32k_block(expected, expected_len, CRC32K_INITIAL_VALUE);
+    (void)cobs_crc32k_encode(crc_buffer, sizeof(crc_buffer), crc);
+    expected_len += reference_cobs_encode(
+        &expected[expected_len], sizeof(expected) - expected_len, crc_buffer,
+        sizeof(crc_buffer), MSTP_PREAMBLE_X55);
+    encoded_len = cobs_frame_encode(encoded, sizeof(encoded), data, length);
+    zassert_equal(encoded_len, expected_len, NULL);
+    zassert_equal(memcmp(encoded, expected, encoded_len), 0, NULL);
+    decoded_len =
+        cobs_frame_decode(decoded, sizeof(decoded), encoded, encoded_len);
+    zassert_equal(decoded_len, length, NULL);
+    zassert_equal(memcmp(decoded, data, length), 0, NULL);
+    /* a changed octet fails the CRC */
+    encoded[encoded_len / 2] ^= 0x01;
+    zassert_equal(
+        cobs_frame_decode(decoded, sizeof(decoded), encoded, encoded_len), 0,
+        NULL);
+}
+
+/**
+ * @brief Test the COBS functions against the octet at a time functions
+ *  of the BACnet standard
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cobs_tests, test_COBS_Equivalence)
+#else
+static void test_COBS_Equivalence(void)
+#endif
+{
+    static uint8_t data[1497];
+    static const size_t lengths[] = { 1,   2,   3,   4,   5,   253,  254, 255,
+                                      256, 507, 508, 509, 762, 1476, 1497 };
+    static const size_t intervals[] = { 0,   1,   2,   3,   4,  5,
+                                        7,   253, 254, 255, 256 };
+    size_t i, j;
+
+    for (i = 0; i < ARRAY_SIZE(lengths); i++) {
+        for (j = 0; j < ARRAY_SIZE(intervals); j++) {
+            test_data_fill(data, lengths[i], intervals[j]);
+            test_cobs_compare(data, lengths[i]);
+        }
+        /* the mask value in the data, and a zero at the end */
+        memset(data, MSTP_PREAMBLE_X55, lengths[i]);
+        test_cobs_compare(data, lengths[i]);
+        data[lengths[i] - 1] = 0;
+        test_cobs_compare(data, lengths[i]);
+    }
+    srand(1);
+    for (i = 0; i < 200; i++) {
+        for (j = 0; j < sizeof(data); j++) {
+            /* about one zero in 32 octets */
+            data[j] = (uint8_t)rand();
+            if ((rand() % 32) == 0) {
+                data[j] = 0;
+            }
+        }
+        test_cobs_compare(data, 1 + ((size_t)rand() % sizeof(data)));
+    }
+}
+
 /**
  * @}
  */
@@ -58,7 +301,10 @@ ZTEST_SUITE(cobs_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(cobs_tests, ztest_unit_test(test_COBS_Encode_Decode));
+    ztest_test_suite(
+        cobs_tests, ztest_unit_test(test_COBS_Encode_Decode),
+        ztest_unit_test(test_COBS_CRC32K_Block),
+        ztest_unit_test(test_COBS_Equivalence));
 
     ztest_run_test_suite(cobs_tests);
 }
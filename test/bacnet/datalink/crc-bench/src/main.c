@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief Micro-benchmark of the MS/TP CRC8, CRC16, and CRC32K builds
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <time.h>
+#include <zephyr/ztest.h>
+#include <bacnet/datalink/cobs.h>
+#include <bacnet/datalink/crc.h>
+#include <bacnet/datalink/mstpdef.h>
+
+#ifndef CRC_BENCH_NAME
+#define CRC_BENCH_NAME "bitwise"
+#endif
+/* a long extended frame */
+#define CRC_BENCH_FRAME_SIZE 1497
+#define CRC_BENCH_ITERATIONS 4000
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static uint8_t Frame[CRC_BENCH_FRAME_SIZE];
+/* keeps the CRC results, so that the loops are not optimized away */
+static volatile uint32_t CRC_Result;
+
+/**
+ * @brief Print the throughput of one benchmark
+ * @param name - name of the CRC and the function
+ * @param start - clock at the start of the benchmark
+ */
+static void crc_bench_print(const char *name, clock_t start)
+{
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double bytes = (double)CRC_BENCH_ITERATIONS * sizeof(Frame);
+
+    if (seconds > 0.0) {
+        printf(
+            "%-12s %-22s %8.1f MB/s %8.2f ns/byte\n", CRC_BENCH_NAME, name,
+            bytes / seconds / 1000000.0, seconds * 1000000000.0 / bytes);
+    }
+}
+
+/**
+ * @brief Test that the build agrees with the BACnet standard, and time it
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(crc_bench_tests, testCRCBenchmark)
+#else
+static void testCRCBenchmark(void)
+#endif
+{
+    clock_t start;
+    uint32_t crc32k;
+    uint16_t crc16;
+    uint8_t crc8;
+    unsigned n;
+    size_t i;
+
+    for (i = 0; i < sizeof(Frame); i++) {
+        Frame[i] = (uint8_t)(i * 7 + 3);
+    }
+    /* the same known answers in every build */
+    zassert_equal(
+        CRC_Calc_Data_Block(Frame, sizeof(Frame), 0xFFFF), 0x954F, NULL);
+    zassert_equal(
+        cobs_crc32k_block(Frame, sizeof(Frame), CRC32K_INITIAL_VALUE),
+        0x1D82A62F, NULL);
+    start = clock();
+    for (n = 0; n < CRC_BENCH_ITERATIONS; n++) {
+        crc8 = 0xFF;
+        for (i = 0; i < sizeof(Frame); i++) {
+            crc8 = CRC_Calc_Header(Frame[i], crc8);
+        }
+        CRC_Result = crc8;
+    }
+    crc_bench_print("CRC_Calc_Header", start);
+    start = clock();
+    for (n = 0; n < CRC_BENCH_ITERATIONS; n++) {
+        crc16 = 0xFFFF;
+        for (i = 0; i < sizeof(Frame); i++) {
+            crc16 = CRC_Calc_Data(Frame[i], crc16);
+        }
+        CRC_Result = crc16;
+    }
+    crc_bench_print("CRC_Calc_Data", start);
+    start = clock();
+    for (n = 0; n < CRC_BENCH_ITERATIONS; n++) {
+        CRC_Result = CRC_Calc_Data_Block(Frame, sizeof(Frame), 0xFFFF);
+    }
+    crc_bench_print("CRC_Calc_Data_Block", start);
+    start = clock();
+    for (n = 0; n < CRC_BENCH_ITERATIONS; n++) {
+        crc32k = CRC32K_INITIAL_VALUE;
+        for (i = 0; i < sizeof(Frame); i++) {
+            crc32k = cobs_crc32k(Frame[i], crc32k);
+        }
+        CRC_Result = crc32k;
+    }
+    crc_bench_print("cobs_crc32k", start);
+    start = clock();
+    for (n = 0; n < CRC_BENCH_ITERATIONS; n++) {
+        CRC_Result =
+            cobs_crc32k_block(Frame, sizeof(Frame), CRC32K_INITIAL_VALUE);
+    }
+    crc_bench_print("cobs_crc32k_block", start);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(crc_bench_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(crc_bench_tests, ztest_unit_test(testCRCBenchmark));
+
+    ztest_run_test_suite(crc_bench_tests);
+}
+#endif
@@ -73,6 +73,35 @@ static void testCRC16(void)
     zassert_equal(crc, 0xF0B8, NULL);
 }
 
+/**
+ * @brief Test the CRC16 of a block against the CRC16 of each octet
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(crc_tests, testCRC16Block)
+#else
+static void testCRC16Block(void)
+#endif
+{
+    uint8_t frame[1497];
+    uint16_t crc;
+    size_t i, length;
+
+    for (i = 0; i < sizeof(frame); i++) {
+        frame[i] = (uint8_t)(i * 7 + 3);
+    }
+    crc = CRC_Calc_Data_Block(frame, sizeof(frame), 0xffff);
+    zassert_equal(crc, 0x954F, NULL);
+    /* every alignment of the remainder */
+    for (length = 0; length < 16; length++) {
+        crc = 0xffff;
+        for (i = 0; i < length; i++) {
+            crc = CRC_Calc_Data(frame[i + 1], crc);
+        }
+        zassert_equal(
+            CRC_Calc_Data_Block(&frame[1], length, 0xffff), crc, NULL);
+    }
+}
+
 /**
  * @brief "Test" to create/log generated CRC8 table
  */
@@ -139,6 +168,7 @@ void test_main(void)
 {
     ztest_test_suite(
         crc_tests, ztest_unit_test(testCRC8), ztest_unit_test(testCRC16),
+        ztest_unit_test(testCRC16Block),
         ztest_unit_test(testCRC8CreateTable),
         ztest_unit_test(testCRC16CreateTable));
 
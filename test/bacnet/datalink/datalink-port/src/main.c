@@ -0,0 +1,221 @@
+/**
+ * @file
+ * @brief test the datalinks that are active at once, each on its own port
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacaddr.h>
+#include <bacnet/datalink/datalink.h>
+
+/* the MS/TP datalink stub, with one PDU that waits to be received */
+static bool MSTP_Initialized;
+static unsigned MSTP_Send_Count;
+static unsigned MSTP_Receive_Timeout;
+static uint8_t MSTP_Receive_PDU[4];
+static uint16_t MSTP_Receive_PDU_Len;
+
+bool dlmstp_init(char *ifname)
+{
+    (void)ifname;
+    MSTP_Initialized = true;
+
+    return true;
+}
+
+void dlmstp_cleanup(void)
+{
+    MSTP_Initialized = false;
+}
+
+int dlmstp_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)pdu;
+    MSTP_Send_Count++;
+
+    return (int)pdu_len;
+}
+
+uint16_t dlmstp_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    uint16_t pdu_len = MSTP_Receive_PDU_Len;
+
+    MSTP_Receive_Timeout = timeout;
+    if ((pdu_len == 0) || (pdu_len > max_pdu)) {
+        return 0;
+    }
+    memcpy(pdu, MSTP_Receive_PDU, pdu_len);
+    dlmstp_get_my_address(src);
+    MSTP_Receive_PDU_Len = 0;
+
+    return pdu_len;
+}
+
+void dlmstp_get_my_address(BACNET_ADDRESS *my_address)
+{
+    bacnet_address_init(my_address, NULL, 0, NULL);
+    my_address->mac_len = 1;
+    my_address->mac[0] = 42;
+}
+
+void dlmstp_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    bacnet_address_init(dest, NULL, BACNET_BROADCAST_NETWORK, NULL);
+    dest->mac_len = 1;
+    dest->mac[0] = 0xFF;
+}
+
+/* the NPDUs that were received from each port */
+static BACNET_DATALINK_PORT *Test_Port[4];
+static unsigned Test_Port_Count;
+
+static void test_port_handler(
+    BACNET_DATALINK_PORT *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t pdu_len)
+{
+    (void)src;
+    (void)pdu;
+    (void)pdu_len;
+    if (Test_Port_Count < 4) {
+        Test_Port[Test_Port_Count] = port;
+    }
+    Test_Port_Count++;
+}
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test choosing the datalink of datalink_send_pdu() at runtime
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(datalink_port_tests, test_datalink_functions)
+#else
+static void test_datalink_functions(void)
+#endif
+{
+    const BACNET_DATALINK_FUNCTIONS *functions;
+    uint8_t pdu[4] = { 0x01, 0x04, 0x02, 0x75 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+
+    functions = datalink_functions("MSTP");
+    zassert_not_null(functions, NULL);
+    zassert_equal(functions->port_type, PORT_TYPE_MSTP, NULL);
+    zassert_equal(
+        datalink_functions_by_port_type(PORT_TYPE_MSTP), functions, NULL);
+    functions = datalink_functions("loopback");
+    zassert_not_null(functions, NULL);
+    zassert_equal(
+        datalink_functions_by_port_type(PORT_TYPE_VIRTUAL), functions, NULL);
+    /* not built in */
+    zassert_is_null(datalink_functions("bip"), NULL);
+    zassert_is_null(datalink_functions_by_port_type(PORT_TYPE_BIP), NULL);
+    zassert_is_null(datalink_functions(NULL), NULL);
+    /* the datalink of datalink_send_pdu() */
+    datalink_set("mstp");
+    MSTP_Send_Count = 0;
+    zassert_equal(datalink_send_pdu(&dest, &npdu_data, pdu, 4), 4, NULL);
+    zassert_equal(MSTP_Send_Count, 1, NULL);
+    /* an unknown datalink is not chosen */
+    datalink_set("bip");
+    zassert_equal(datalink_send_pdu(&dest, &npdu_data, pdu, 4), 4, NULL);
+    zassert_equal(MSTP_Send_Count, 2, NULL);
+    datalink_set("none");
+    zassert_equal(datalink_send_pdu(&dest, &npdu_data, pdu, 4), 4, NULL);
+    zassert_equal(MSTP_Send_Count, 2, NULL);
+}
+
+/**
+ * @brief Test the datalinks of two ports, active and polled at once
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(datalink_port_tests, test_datalink_ports)
+#else
+static void test_datalink_ports(void)
+#endif
+{
+    BACNET_DATALINK_PORT loopback_port = { 0 }, mstp_port = { 0 };
+    BACNET_DATALINK_PORT other_port = { 0 };
+    uint8_t pdu[4] = { 0x01, 0x04, 0x02, 0x75 };
+    uint8_t test_pdu[MAX_MPDU] = { 0 };
+    BACNET_ADDRESS dest = { 0 }, src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned count;
+    int bytes;
+
+    zassert_true(
+        datalink_port_add(&loopback_port, datalink_functions("loopback"), 1),
+        NULL);
+    zassert_true(
+        datalink_port_add(
+            &mstp_port, datalink_functions_by_port_type(PORT_TYPE_MSTP), 2),
+        NULL);
+    /* one port for each datalink, and for each Network Port object */
+    zassert_false(
+        datalink_port_add(&other_port, datalink_functions("mstp"), 3), NULL);
+    zassert_false(
+        datalink_port_add(&other_port, datalink_functions("bip"), 3), NULL);
+    zassert_false(datalink_port_add(&mstp_port, mstp_port.functions, 2), NULL);
+    zassert_equal(datalink_port_find(1), &loopback_port, NULL);
+    zassert_equal(datalink_port_find(2), &mstp_port, NULL);
+    zassert_is_null(datalink_port_find(3), NULL);
+    zassert_true(datalink_port_init(&loopback_port, NULL), NULL);
+    zassert_true(datalink_port_init(&mstp_port, NULL), NULL);
+    zassert_true(MSTP_Initialized, NULL);
+    /* an NPDU waits on each port */
+    loopback_port.functions->get_my_address(&dest);
+    bytes = datalink_port_send_pdu(&loopback_port, &dest, &npdu_data, pdu, 4);
+    zassert_equal(bytes, 4, NULL);
+    memcpy(MSTP_Receive_PDU, pdu, sizeof(pdu));
+    MSTP_Receive_PDU_Len = sizeof(pdu);
+    Test_Port_Count = 0;
+    count = datalink_port_receive(
+        &src, test_pdu, sizeof(test_pdu), 100, test_port_handler);
+    zassert_equal(count, 2, NULL);
+    zassert_equal(Test_Port_Count, 2, NULL);
+    zassert_equal(Test_Port[0], &loopback_port, NULL);
+    zassert_equal(Test_Port[1], &mstp_port, NULL);
+    /* the ports are only polled while there are NPDUs */
+    zassert_equal(MSTP_Receive_Timeout, 0, NULL);
+    /* no NPDUs: the timeout is shared by the ports */
+    count = datalink_port_receive(
+        &src, test_pdu, sizeof(test_pdu), 100, test_port_handler);
+    zassert_equal(count, 0, NULL);
+    zassert_equal(MSTP_Receive_Timeout, 50, NULL);
+    datalink_port_maintenance_timer(1);
+    /* the datalinks are cleaned up and the ports are removed */
+    datalink_port_cleanup();
+    zassert_false(MSTP_Initialized, NULL);
+    zassert_is_null(datalink_port_find(1), NULL);
+    zassert_true(
+        datalink_port_add(&other_port, datalink_functions("mstp"), 3), NULL);
+    datalink_port_cleanup();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(datalink_port_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        datalink_port_tests, ztest_unit_test(test_datalink_functions),
+        ztest_unit_test(test_datalink_ports));
+
+    ztest_run_test_suite(datalink_port_tests);
+}
+#endif
@@ -157,6 +157,13 @@ static void test_MSTP_Datalink(void)
     dlmstp_set_max_info_frames(10);
     test_frames = dlmstp_max_info_frames();
     zassert_equal(test_frames, 10, NULL);
+    zassert_false(dlmstp_adaptive_enabled(), NULL);
+    zassert_true(dlmstp_adaptive_enabled_set(true), NULL);
+    zassert_true(dlmstp_adaptive_enabled(), NULL);
+    zassert_equal(
+        MSTP_Port.Adaptive_Max_Info_Frames, DLMSTP_MAX_INFO_FRAMES, NULL);
+    zassert_true(dlmstp_adaptive_enabled_set(false), NULL);
+    zassert_false(dlmstp_adaptive_enabled(), NULL);
     test_mac_address = dlmstp_mac_address();
     zassert_equal(test_mac_address, MSTP_Port.This_Station, NULL);
     dlmstp_set_mac_address(10);
@@ -184,6 +191,11 @@ static void test_MSTP_Datalink(void)
     dlmstp_zero_config_enabled_set(true);
     status = dlmstp_zero_config_enabled();
     zassert_equal(status, true, NULL);
+    status = dlmstp_zero_config_accelerated_set(true);
+    zassert_equal(status, true, NULL);
+    zassert_true(MSTP_Port.ZeroConfigAccelerated, NULL);
+    status = dlmstp_zero_config_accelerated_set(false);
+    zassert_equal(status, true, NULL);
     status = dlmstp_slave_mode_enabled_set(true);
     zassert_equal(status, true, NULL);
     status = dlmstp_slave_mode_enabled();
@@ -225,6 +237,44 @@ static void test_MSTP_Datalink(void)
     zassert_equal(
         test_length, sizeof(test_data) + DLMSTP_HEADER_MAX,
         "MSTP_Get_Send() length=%d", test_length);
+    zassert_true(dlmstp_send_pdu_queue_empty(), NULL);
+    /* a life safety message is sent before the queued bulk message */
+    test_length = dlmstp_send_pdu(
+        &test_address, &test_npdu_data, test_data, sizeof(test_data));
+    zassert_equal(test_length, sizeof(test_data), NULL);
+    dlmstp_fill_bacnet_address(&test_address, 20);
+    test_npdu_data.priority = MESSAGE_PRIORITY_LIFE_SAFETY;
+    test_length = dlmstp_send_pdu(
+        &test_address, &test_npdu_data, test_data, sizeof(test_data));
+    zassert_equal(test_length, sizeof(test_data), NULL);
+    zassert_false(dlmstp_send_pdu_queue_empty(), NULL);
+    ztest_expect_value(MSTP_Create_Frame, buffer, &MSTP_Port.OutputBuffer[0]);
+    ztest_expect_value(
+        MSTP_Create_Frame, buffer_len, MSTP_Port.OutputBufferSize);
+    ztest_expect_value(
+        MSTP_Create_Frame, frame_type,
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY);
+    ztest_expect_value(MSTP_Create_Frame, destination, 20);
+    ztest_expect_value(MSTP_Create_Frame, source, MSTP_Port.This_Station);
+    ztest_expect_data(MSTP_Create_Frame, data, test_data);
+    ztest_returns_value(
+        MSTP_Create_Frame, sizeof(test_data) + DLMSTP_HEADER_MAX);
+    test_length = MSTP_Get_Send(&MSTP_Port, 0);
+    zassert_equal(test_length, sizeof(test_data) + DLMSTP_HEADER_MAX, NULL);
+    ztest_expect_value(MSTP_Create_Frame, buffer, &MSTP_Port.OutputBuffer[0]);
+    ztest_expect_value(
+        MSTP_Create_Frame, buffer_len, MSTP_Port.OutputBufferSize);
+    ztest_expect_value(
+        MSTP_Create_Frame, frame_type,
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY);
+    ztest_expect_value(MSTP_Create_Frame, destination, MSTP_BROADCAST_ADDRESS);
+    ztest_expect_value(MSTP_Create_Frame, source, MSTP_Port.This_Station);
+    ztest_expect_data(MSTP_Create_Frame, data, test_data);
+    ztest_returns_value(
+        MSTP_Create_Frame, sizeof(test_data) + DLMSTP_HEADER_MAX);
+    test_length = MSTP_Get_Send(&MSTP_Port, 0);
+    zassert_equal(test_length, sizeof(test_data) + DLMSTP_HEADER_MAX, NULL);
+    zassert_true(dlmstp_send_pdu_queue_empty(), NULL);
 }
 /**
  * @}
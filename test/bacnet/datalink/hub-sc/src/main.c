@@ -1561,6 +1561,7 @@ static void test_hub_connector_url(bool primary)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_SUCCESS, NULL);
@@ -1592,6 +1593,7 @@ static void test_hub_connector_url(bool primary)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid2, &hubc_h2);
     zassert_equal(ret, BSC_SC_SUCCESS, NULL);
@@ -1712,6 +1714,7 @@ static void test_hub_connector_bad_primary_url(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_SUCCESS, NULL);
@@ -1731,6 +1734,7 @@ static void test_hub_connector_bad_primary_url(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, NULL,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_BAD_PARAM, NULL);
@@ -1780,6 +1784,7 @@ static void test_hub_bad_params(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_BAD_PARAM, 0);
@@ -1791,6 +1796,7 @@ static void test_hub_bad_params(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_BAD_PARAM, 0);
@@ -1804,6 +1810,7 @@ static void test_hub_bad_params(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_BAD_PARAM, 0);
@@ -1822,6 +1829,7 @@ static void test_hub_bad_params(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_BAD_PARAM, 0);
@@ -1841,6 +1849,7 @@ static void test_hub_bad_params(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_vmac, &hubc_h);
     zassert_equal(ret, BSC_SC_SUCCESS, 0);
@@ -1852,6 +1861,7 @@ static void test_hub_bad_params(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_vmac2, &hubc_h2);
     zassert_equal(ret, BSC_SC_SUCCESS, 0);
@@ -1863,6 +1873,7 @@ static void test_hub_bad_params(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_h3, &hubc_h3);
     zassert_equal(ret, BSC_SC_NO_RESOURCES, 0);
@@ -1966,6 +1977,7 @@ static void test_hub_connector_reconnect(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_SUCCESS, NULL);
@@ -2023,6 +2035,7 @@ static void test_hub_connector_reconnect(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, NULL,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_SUCCESS, NULL);
@@ -2106,6 +2119,7 @@ static void test_hub_connector_duplicated_vmac(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_SUCCESS, NULL);
@@ -2273,6 +2287,7 @@ static void test_hub_function_duplicated_uuid(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid, &hubc_h);
     zassert_equal(ret, BSC_SC_SUCCESS, NULL);
@@ -2288,6 +2303,7 @@ static void test_hub_function_duplicated_uuid(void)
         BACNET_TIMEOUT, // heartbeat timeout
         BACNET_TIMEOUT, // disconnect timeout
         primary_url, secondary_url,
+        0, // minimum reconnect timeout
         BACNET_TIMEOUT, // reconnect timeout
         hub_connector_event, &hubc_uuid2, &hubc_h2);
     zassert_equal(ret, BSC_SC_SUCCESS, NULL);
@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @brief test the in-process loopback datalink
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacaddr.h>
+#include <bacnet/datalink/loopback.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test that PDUs for this node and broadcasts are received again
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(loopback_tests, test_loopback_send_receive)
+#else
+static void test_loopback_send_receive(void)
+#endif
+{
+    uint8_t pdu[LOOPBACK_MPDU_MAX] = { 0x01, 0x04, 0x02, 0x75 };
+    uint8_t test_pdu[LOOPBACK_MPDU_MAX] = { 0 };
+    BACNET_ADDRESS dest = { 0 }, src = { 0 }, my_address = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint16_t pdu_len;
+    int bytes;
+
+    zassert_true(loopback_init(NULL), NULL);
+    zassert_equal(loopback_queue_count(), 0, NULL);
+    pdu_len = loopback_receive(&src, test_pdu, sizeof(test_pdu), 0);
+    zassert_equal(pdu_len, 0, NULL);
+    /* to this node */
+    loopback_get_my_address(&my_address);
+    zassert_equal(my_address.mac_len, 1, NULL);
+    zassert_equal(my_address.mac[0], LOOPBACK_MAC_ADDRESS, NULL);
+    bytes = loopback_send_pdu(&my_address, &npdu_data, pdu, 4);
+    zassert_equal(bytes, 4, NULL);
+    zassert_equal(loopback_queue_count(), 1, NULL);
+    pdu_len = loopback_receive(&src, test_pdu, sizeof(test_pdu), 0);
+    zassert_equal(pdu_len, 4, NULL);
+    zassert_mem_equal(test_pdu, pdu, 4, NULL);
+    zassert_true(bacnet_address_same(&src, &my_address), NULL);
+    zassert_equal(loopback_queue_count(), 0, NULL);
+    /* a broadcast */
+    loopback_get_broadcast_address(&dest);
+    zassert_equal(dest.net, BACNET_BROADCAST_NETWORK, NULL);
+    zassert_equal(dest.mac[0], LOOPBACK_BROADCAST_ADDRESS, NULL);
+    bytes = loopback_send_pdu(&dest, &npdu_data, pdu, 3);
+    zassert_equal(bytes, 3, NULL);
+    pdu_len = loopback_receive(&src, test_pdu, sizeof(test_pdu), 0);
+    zassert_equal(pdu_len, 3, NULL);
+    /* to another station, which is not there */
+    dest.net = 0;
+    dest.mac[0] = LOOPBACK_MAC_ADDRESS + 1;
+    bytes = loopback_send_pdu(&dest, &npdu_data, pdu, 4);
+    zassert_equal(bytes, 4, NULL);
+    zassert_equal(loopback_queue_count(), 0, NULL);
+    zassert_equal(loopback_dropped_count(), 0, NULL);
+    /* too large for the datalink, or for the receive buffer */
+    bytes = loopback_send_pdu(
+        &my_address, &npdu_data, pdu, LOOPBACK_MPDU_MAX + 1);
+    zassert_equal(bytes, -1, NULL);
+    bytes = loopback_send_pdu(&my_address, &npdu_data, pdu, 4);
+    zassert_equal(bytes, 4, NULL);
+    pdu_len = loopback_receive(&src, test_pdu, 3, 0);
+    zassert_equal(pdu_len, 0, NULL);
+    zassert_equal(loopback_queue_count(), 0, NULL);
+    loopback_cleanup();
+    bytes = loopback_send_pdu(&my_address, &npdu_data, pdu, 4);
+    zassert_equal(bytes, -1, NULL);
+}
+
+/**
+ * @brief Test that the PDUs that do not fit in the queue are counted
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(loopback_tests, test_loopback_queue_full)
+#else
+static void test_loopback_queue_full(void)
+#endif
+{
+    uint8_t pdu[8] = { 0 };
+    uint8_t test_pdu[8] = { 0 };
+    BACNET_ADDRESS my_address = { 0 };
+    unsigned i;
+    int bytes;
+
+    zassert_true(loopback_init(NULL), NULL);
+    loopback_get_my_address(&my_address);
+    for (i = 0; i < LOOPBACK_QUEUE_SIZE; i++) {
+        pdu[0] = (uint8_t)i;
+        bytes = loopback_send_pdu(&my_address, NULL, pdu, sizeof(pdu));
+        zassert_equal(bytes, sizeof(pdu), NULL);
+    }
+    zassert_equal(loopback_queue_count(), LOOPBACK_QUEUE_SIZE, NULL);
+    bytes = loopback_send_pdu(&my_address, NULL, pdu, sizeof(pdu));
+    zassert_equal(bytes, -1, NULL);
+    zassert_equal(loopback_dropped_count(), 1, NULL);
+    /* first in, first out */
+    for (i = 0; i < LOOPBACK_QUEUE_SIZE; i++) {
+        zassert_equal(
+            loopback_receive(NULL, test_pdu, sizeof(test_pdu), 0),
+            sizeof(test_pdu), NULL);
+        zassert_equal(test_pdu[0], i, NULL);
+    }
+    zassert_equal(loopback_queue_count(), 0, NULL);
+    /* the queue is emptied when the datalink is initialized again */
+    bytes = loopback_send_pdu(&my_address, NULL, pdu, sizeof(pdu));
+    zassert_equal(bytes, sizeof(pdu), NULL);
+    zassert_true(loopback_init(NULL), NULL);
+    zassert_equal(loopback_queue_count(), 0, NULL);
+    zassert_equal(loopback_dropped_count(), 0, NULL);
+    loopback_cleanup();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(loopback_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        loopback_tests, ztest_unit_test(test_loopback_send_receive),
+        ztest_unit_test(test_loopback_queue_full));
+
+    ztest_run_test_suite(loopback_tests);
+}
+#endif
@@ -26,6 +26,18 @@ void bvlc6_maintenance_timer(uint16_t seconds)
  * @{
  */
 
+static unsigned Receive_Handler_Count;
+static uint16_t Receive_Handler_Len;
+
+static void
+test_receive_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
+{
+    (void)src;
+    (void)pdu;
+    Receive_Handler_Count++;
+    Receive_Handler_Len += pdu_len;
+}
+
 /**
  * @brief Test datalink
  */
@@ -173,6 +185,41 @@ static void test_datalink_bip(void)
     zassert_mem_equal(expected_data, data, sizeof(data), NULL);
     zassert_equal(z_cleanup_mock(), 0, NULL);
 
+    // receive_batch - only the first receive waits
+    ztest_expect_value(bip_receive, src, &addr);
+    ztest_expect_value(bip_receive, timeout, 10);
+    ztest_expect_data(bip_receive, pdu, expected_data);
+    ztest_returns_value(bip_receive, 4);
+    ztest_expect_value(bip_receive, src, &addr);
+    ztest_expect_value(bip_receive, timeout, 0);
+    ztest_expect_data(bip_receive, pdu, expected_data);
+    ztest_returns_value(bip_receive, 3);
+    ztest_expect_value(bip_receive, src, &addr);
+    ztest_expect_value(bip_receive, timeout, 0);
+    ztest_expect_data(bip_receive, pdu, expected_data);
+    ztest_returns_value(bip_receive, 0);
+    Receive_Handler_Count = 0;
+    Receive_Handler_Len = 0;
+    zassert_equal(
+        datalink_receive_batch(
+            &addr, data, sizeof(data), 10, 8, test_receive_handler),
+        2, NULL);
+    zassert_equal(Receive_Handler_Count, 2, NULL);
+    zassert_equal(Receive_Handler_Len, 7, NULL);
+    zassert_equal(z_cleanup_mock(), 0, NULL);
+    // receive_batch - stops at the maximum number of packets
+    ztest_expect_value(bip_receive, src, &addr);
+    ztest_expect_value(bip_receive, timeout, 10);
+    ztest_expect_data(bip_receive, pdu, expected_data);
+    ztest_returns_value(bip_receive, 4);
+    Receive_Handler_Count = 0;
+    zassert_equal(
+        datalink_receive_batch(
+            &addr, data, sizeof(data), 10, 1, test_receive_handler),
+        1, NULL);
+    zassert_equal(Receive_Handler_Count, 1, NULL);
+    zassert_equal(z_cleanup_mock(), 0, NULL);
+
     // get_broadcast_address
     ztest_expect_value(bip_get_broadcast_address, dest, &addr);
     datalink_get_broadcast_address(&addr2);
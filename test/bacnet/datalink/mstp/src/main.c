@@ -12,6 +12,7 @@
 #/* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/bacdcode.h"
 #include "bacnet/bacint.h"
 #include <bacnet/datalink/crc.h>
 #include <bacnet/datalink/cobs.h>
@@ -22,6 +23,7 @@
 #include <bacnet/datalink/crc.h>
 #include <bacnet/basic/sys/bytes.h>
 #include <bacnet/basic/sys/fifo.h>
+#include "bacnet/npdu.h"
 
 /**
  * @addtogroup bacnet_tests
@@ -68,7 +70,7 @@ static void Load_Input_Buffer(const uint8_t *buffer, size_t len)
     static bool initialized = false; /* tracks our init */
     if (!initialized) {
         initialized = true;
-        FIFO_Init(&Test_Queue, Test_Queue_Data, MAX_MPDU);
+        FIFO_Init(&Test_Queue, Test_Queue_Data, sizeof(Test_Queue_Data));
     }
     /* empty any the existing data */
     FIFO_Flush(&Test_Queue);
@@ -104,12 +106,22 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
  * @param timeout milliseconds to wait for a packet to send
  * @return amount of PDU data
  */
+/* number of PDUs in the transmit queue of the test */
+static unsigned Test_Send_Count;
 uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 {
-    (void)mstp_port;
+    uint8_t data[8] = { 0 };
+
     (void)timeout;
+    if (Test_Send_Count == 0) {
+        return 0;
+    }
+    Test_Send_Count--;
 
-    return 0;
+    return MSTP_Create_Frame(
+        mstp_port->OutputBuffer, mstp_port->OutputBufferSize,
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, MSTP_BROADCAST_ADDRESS,
+        mstp_port->This_Station, data, sizeof(data));
 }
 
 /**
@@ -619,6 +631,191 @@ static void testReceiveNodeFSM(void)
         NULL);
 }
 
+/**
+ * @brief Test the receive state machine with a block of octets
+ */
+static void testReceiveFrameBlock(void)
+{
+    struct mstp_port_struct_t mstp_port = { 0 };
+    uint8_t my_mac = 0x05;
+    uint8_t buffer[MAX_MPDU * 2] = { 0 };
+    uint8_t data[MAX_PDU] = { 0 };
+    size_t len, first_len, offset, i;
+
+    mstp_port.InputBuffer = &RxBuffer[0];
+    mstp_port.InputBufferSize = sizeof(RxBuffer);
+    mstp_port.OutputBuffer = &TxBuffer[0];
+    mstp_port.OutputBufferSize = sizeof(TxBuffer);
+    mstp_port.SilenceTimer = Timer_Silence;
+    mstp_port.SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port.This_Station = my_mac;
+    mstp_port.Nmax_info_frames = 1;
+    mstp_port.Nmax_master = 127;
+    MSTP_Init(&mstp_port);
+    zassert_equal(MSTP_Receive_Frame_Block(NULL, buffer, 1), 0, NULL);
+    zassert_equal(MSTP_Receive_Frame_Block(&mstp_port, NULL, 1), 0, NULL);
+    /* two frames back to back in one block */
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+    first_len = MSTP_Create_Frame(
+        buffer, sizeof(buffer), FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        my_mac, 0x10, data, 200);
+    zassert_true(first_len > 0, NULL);
+    len = MSTP_Create_Frame(
+        &buffer[first_len], sizeof(buffer) - first_len, FRAME_TYPE_TOKEN,
+        0x10, my_mac, NULL, 0);
+    zassert_true(len > 0, NULL);
+    len += first_len;
+    SilenceTime = 0;
+    offset = MSTP_Receive_Frame_Block(&mstp_port, buffer, len);
+    zassert_equal(offset, first_len, NULL);
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_false(mstp_port.ReceivedInvalidFrame, NULL);
+    zassert_equal(mstp_port.DataLength, 200, NULL);
+    zassert_equal(memcmp(mstp_port.InputBuffer, data, 200), 0, NULL);
+    zassert_equal(mstp_port.receive_state, MSTP_RECEIVE_STATE_IDLE, NULL);
+    /* nothing is consumed until the frame is handled */
+    zassert_equal(
+        MSTP_Receive_Frame_Block(&mstp_port, &buffer[offset], len - offset), 0,
+        NULL);
+    mstp_port.ReceivedValidFrame = false;
+    zassert_equal(
+        MSTP_Receive_Frame_Block(&mstp_port, &buffer[offset], len - offset),
+        len - offset, NULL);
+    zassert_true(mstp_port.ReceivedValidFrameNotForUs, NULL);
+    zassert_equal(mstp_port.FrameType, FRAME_TYPE_TOKEN, NULL);
+    mstp_port.ReceivedValidFrameNotForUs = false;
+    /* a frame split across blocks, as with a full DMA buffer */
+    len = MSTP_Create_Frame(
+        buffer, sizeof(buffer), FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY, my_mac,
+        0x10, data, 100);
+    zassert_equal(MSTP_Receive_Frame_Block(&mstp_port, buffer, 20), 20, NULL);
+    zassert_equal(mstp_port.receive_state, MSTP_RECEIVE_STATE_DATA, NULL);
+    zassert_equal(
+        MSTP_Receive_Frame_Block(&mstp_port, &buffer[20], len - 20), len - 20,
+        NULL);
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_equal(mstp_port.DataLength, 100, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    /* extended frame */
+    len = MSTP_Create_Frame(
+        buffer, sizeof(buffer), FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY,
+        my_mac, my_mac, data, Nmin_COBS_length_BACnet);
+    zassert_true(len > 0, NULL);
+    zassert_equal(MSTP_Receive_Frame_Block(&mstp_port, buffer, len), len, NULL);
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    zassert_equal(mstp_port.DataLength, Nmin_COBS_length_BACnet, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    /* bad data CRC */
+    len = MSTP_Create_Frame(
+        buffer, sizeof(buffer), FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        my_mac, 0x10, data, 50);
+    buffer[8 + 10] ^= 0x01;
+    zassert_equal(MSTP_Receive_Frame_Block(&mstp_port, buffer, len), len, NULL);
+    zassert_true(mstp_port.ReceivedInvalidFrame, NULL);
+    zassert_false(mstp_port.ReceivedValidFrame, NULL);
+    mstp_port.ReceivedInvalidFrame = false;
+}
+
+/**
+ * @brief Encode a local I-Am with the given Max-APDU
+ */
+static int encode_iam_pdu(uint8_t *pdu, unsigned max_apdu)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(pdu, NULL, NULL, &npdu_data);
+    pdu[len++] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+    pdu[len++] = SERVICE_UNCONFIRMED_I_AM;
+    len += encode_application_object_id(&pdu[len], OBJECT_DEVICE, 1234);
+    len += encode_application_unsigned(&pdu[len], max_apdu);
+    len += encode_application_enumerated(&pdu[len], SEGMENTATION_NONE);
+    len += encode_application_unsigned(&pdu[len], 260);
+
+    return len;
+}
+
+/**
+ * @brief Test the learning of the stations that accept extended frames
+ */
+static void testExtendedFrames(void)
+{
+    struct mstp_port_struct_t mstp_port = { 0 };
+    uint8_t my_mac = 0x05;
+    uint8_t buffer[MAX_MPDU] = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    size_t len;
+    int pdu_len;
+
+    mstp_port.InputBuffer = &RxBuffer[0];
+    mstp_port.InputBufferSize = sizeof(RxBuffer);
+    mstp_port.OutputBuffer = &TxBuffer[0];
+    mstp_port.OutputBufferSize = sizeof(TxBuffer);
+    mstp_port.SilenceTimer = Timer_Silence;
+    mstp_port.SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port.This_Station = my_mac;
+    mstp_port.Nmax_info_frames = 1;
+    mstp_port.Nmax_master = 127;
+    MSTP_Init(&mstp_port);
+    zassert_false(MSTP_Extended_Frames_Accepted(&mstp_port, 0x10), NULL);
+    zassert_false(MSTP_Extended_Frames_Refused(&mstp_port, 0x10), NULL);
+    zassert_false(MSTP_Extended_Frames_Accepted(NULL, 0x10), NULL);
+    zassert_false(MSTP_Extended_Frames_Refused(NULL, 0x10), NULL);
+    /* an I-Am with a Max-APDU that fits a non-extended frame */
+    pdu_len = encode_iam_pdu(pdu, 480);
+    len = MSTP_Create_Frame(
+        buffer, sizeof(buffer), FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        MSTP_BROADCAST_ADDRESS, 0x10, pdu, pdu_len);
+    SilenceTime = 0;
+    zassert_equal(MSTP_Receive_Frame_Block(&mstp_port, buffer, len), len, NULL);
+    zassert_true(mstp_port.ReceivedValidFrame, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    zassert_false(MSTP_Extended_Frames_Accepted(&mstp_port, 0x10), NULL);
+    zassert_true(MSTP_Extended_Frames_Refused(&mstp_port, 0x10), NULL);
+    /* an I-Am with a Max-APDU that needs an extended frame */
+    pdu_len = encode_iam_pdu(pdu, 1476);
+    len = MSTP_Create_Frame(
+        buffer, sizeof(buffer), FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        MSTP_BROADCAST_ADDRESS, 0x11, pdu, pdu_len);
+    zassert_equal(MSTP_Receive_Frame_Block(&mstp_port, buffer, len), len, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    zassert_true(MSTP_Extended_Frames_Accepted(&mstp_port, 0x11), NULL);
+    zassert_false(MSTP_Extended_Frames_Refused(&mstp_port, 0x11), NULL);
+    /* an extended frame is learned, even if it is not for us */
+    memset(pdu, 0, sizeof(pdu));
+    len = MSTP_Create_Frame(
+        buffer, sizeof(buffer),
+        FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY, 0x20, 0x10, pdu,
+        Nmin_COBS_length_BACnet);
+    zassert_equal(MSTP_Receive_Frame_Block(&mstp_port, buffer, len), len, NULL);
+    zassert_true(mstp_port.ReceivedValidFrameNotForUs, NULL);
+    mstp_port.ReceivedValidFrameNotForUs = false;
+    zassert_true(MSTP_Extended_Frames_Accepted(&mstp_port, 0x10), NULL);
+    zassert_false(MSTP_Extended_Frames_Refused(&mstp_port, 0x10), NULL);
+    /* a later small I-Am does not undo an extended frame */
+    pdu_len = encode_iam_pdu(pdu, 480);
+    len = MSTP_Create_Frame(
+        buffer, sizeof(buffer), FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+        MSTP_BROADCAST_ADDRESS, 0x10, pdu, pdu_len);
+    zassert_equal(MSTP_Receive_Frame_Block(&mstp_port, buffer, len), len, NULL);
+    mstp_port.ReceivedValidFrame = false;
+    zassert_true(MSTP_Extended_Frames_Accepted(&mstp_port, 0x10), NULL);
+    /* configured stations, and the broadcast address is never known */
+    MSTP_Extended_Frames_Set(&mstp_port, 0x10, false);
+    zassert_true(MSTP_Extended_Frames_Refused(&mstp_port, 0x10), NULL);
+    zassert_false(MSTP_Extended_Frames_Accepted(&mstp_port, 0x10), NULL);
+    MSTP_Extended_Frames_Set(&mstp_port, MSTP_BROADCAST_ADDRESS, false);
+    zassert_false(
+        MSTP_Extended_Frames_Refused(&mstp_port, MSTP_BROADCAST_ADDRESS), NULL);
+    /* learned again after init */
+    MSTP_Init(&mstp_port);
+    zassert_false(MSTP_Extended_Frames_Refused(&mstp_port, 0x10), NULL);
+    zassert_false(MSTP_Extended_Frames_Accepted(&mstp_port, 0x11), NULL);
+}
+
 static void testMasterNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port; /* port data */
@@ -646,6 +843,125 @@ static void testMasterNodeFSM(void)
     /* FIXME: write a unit test for the Master Node State Machine */
 }
 
+/* number of Poll For Master frames sent by the test node */
+static unsigned Test_PFM_Count;
+
+/**
+ * @brief Give the token to a master node, and run its state machine
+ *  until it passes the token to the next station
+ * @param mstp_port port specific context data
+ * @param source MAC address of the node that passed the token
+ * @return number of information frames sent in the token
+ */
+static unsigned testMasterNodeToken(
+    struct mstp_port_struct_t *mstp_port, uint8_t source)
+{
+    unsigned count = Test_Send_Count, i;
+
+    SilenceTime = 0;
+    mstp_port->ReceivedValidFrame = true;
+    mstp_port->FrameType = FRAME_TYPE_TOKEN;
+    mstp_port->DestinationAddress = mstp_port->This_Station;
+    mstp_port->SourceAddress = source;
+    for (i = 0; i < 300; i++) {
+        (void)MSTP_Master_Node_FSM(mstp_port);
+        if (mstp_port->master_state == MSTP_MASTER_STATE_POLL_FOR_MASTER) {
+            /* no master node replies */
+            Test_PFM_Count++;
+            SilenceTime = mstp_port->Tusage_timeout + 1;
+        } else if (mstp_port->master_state == MSTP_MASTER_STATE_PASS_TOKEN) {
+            break;
+        }
+    }
+    zassert_equal(mstp_port->master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+    /* the next station uses the token */
+    mstp_port->master_state = MSTP_MASTER_STATE_IDLE;
+
+    return count - Test_Send_Count;
+}
+
+/**
+ * @brief Initialize a master node that is in the IDLE state
+ * @param mstp_port port specific context data
+ * @param this_station MAC address of the node
+ * @param next_station MAC address of the next master node
+ */
+static void testMasterNodeAdaptive_Init(
+    struct mstp_port_struct_t *mstp_port,
+    uint8_t this_station,
+    uint8_t next_station)
+{
+    memset(mstp_port, 0, sizeof(*mstp_port));
+    mstp_port->InputBuffer = &RxBuffer[0];
+    mstp_port->InputBufferSize = sizeof(RxBuffer);
+    mstp_port->OutputBuffer = &TxBuffer[0];
+    mstp_port->OutputBufferSize = sizeof(TxBuffer);
+    mstp_port->Nmax_info_frames = 1;
+    mstp_port->Nmax_master = 127;
+    mstp_port->SilenceTimer = Timer_Silence;
+    mstp_port->SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port->This_Station = this_station;
+    mstp_port->AdaptiveEnabled = true;
+    mstp_port->Adaptive_Max_Info_Frames = 4;
+    MSTP_Init(mstp_port);
+    (void)MSTP_Master_Node_FSM(mstp_port);
+    zassert_equal(mstp_port->master_state, MSTP_MASTER_STATE_IDLE, NULL);
+    mstp_port->Next_Station = next_station;
+    mstp_port->TokenCount = 0;
+    Test_Send_Count = 0;
+    Test_PFM_Count = 0;
+}
+
+static void testMasterNodeAdaptive(void)
+{
+    struct mstp_port_struct_t MSTP_Port; /* port data */
+    unsigned i;
+
+    /* the information frames follow the transmit queue */
+    testMasterNodeAdaptive_Init(&MSTP_Port, 5, 7);
+    zassert_equal(MSTP_Max_Info_Frames(&MSTP_Port), 1, NULL);
+    Test_Send_Count = 100;
+    for (i = 1; i <= 4; i++) {
+        zassert_equal(testMasterNodeToken(&MSTP_Port, 3), i, NULL);
+    }
+    zassert_equal(testMasterNodeToken(&MSTP_Port, 3), 4, NULL);
+    zassert_equal(MSTP_Max_Info_Frames(&MSTP_Port), 4, NULL);
+    Test_Send_Count = 0;
+    for (i = 1; i < MSTP_ADAPTIVE_IDLE_TOKENS; i++) {
+        zassert_equal(testMasterNodeToken(&MSTP_Port, 3), 0, NULL);
+    }
+    zassert_equal(MSTP_Max_Info_Frames(&MSTP_Port), 4, NULL);
+    zassert_equal(testMasterNodeToken(&MSTP_Port, 3), 0, NULL);
+    zassert_equal(MSTP_Max_Info_Frames(&MSTP_Port), 3, NULL);
+    MSTP_Port.AdaptiveEnabled = false;
+    zassert_equal(MSTP_Max_Info_Frames(&MSTP_Port), 1, NULL);
+    zassert_equal(MSTP_Max_Info_Frames(NULL), 0, NULL);
+    /* the highest master node is 10, so its sweeps wrap around
+       to find the next station 2 */
+    testMasterNodeAdaptive_Init(&MSTP_Port, 10, 2);
+    zassert_equal(MSTP_Max_Master(&MSTP_Port), 127, NULL);
+    for (i = 0; i < 1000; i++) {
+        (void)testMasterNodeToken(&MSTP_Port, 7);
+        if (MSTP_Max_Master(&MSTP_Port) != 127) {
+            break;
+        }
+    }
+    /* a sweep up to Max_Master polls 11..127, 0, and 1 */
+    zassert_equal(Test_PFM_Count, 119, NULL);
+    zassert_equal(MSTP_Max_Master(&MSTP_Port), 10, NULL);
+    /* the next sweeps poll 0 and 1 */
+    Test_PFM_Count = 0;
+    for (i = 0; i < 1000; i++) {
+        (void)testMasterNodeToken(&MSTP_Port, 7);
+        if (MSTP_Max_Master(&MSTP_Port) != 10) {
+            break;
+        }
+    }
+    zassert_equal(Test_PFM_Count, 2 * MSTP_ADAPTIVE_SWEEPS, NULL);
+    zassert_equal(MSTP_Max_Master(&MSTP_Port), 127, NULL);
+    zassert_equal(MSTP_Max_Master(NULL), 0, NULL);
+}
+
 static void testSlaveNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
@@ -1103,6 +1419,88 @@ testZeroConfigNode_Test_DuplicateNode(struct mstp_port_struct_t *mstp_port)
     zassert_equal(mstp_port->This_Station, 255, NULL);
 }
 
+/**
+ * @brief Test the accelerated zero config address acquisition
+ */
+static void testZeroConfigAccelerated(void)
+{
+    struct mstp_port_struct_t mstp_port = { 0 };
+    struct mstp_port_struct_t other_port = { 0 };
+    unsigned uuid_hash = 0, station, used, i, count;
+    bool transition_now;
+
+    testZeroConfigNode_Init(&mstp_port);
+    for (i = 0; i < MSTP_UUID_SIZE; i++) {
+        mstp_port.UUID[i] = (uint8_t)(i + 1);
+        uuid_hash = (uuid_hash * 31) + mstp_port.UUID[i];
+    }
+    mstp_port.ZeroConfigAccelerated = true;
+    MSTP_Init(&mstp_port);
+    transition_now = MSTP_Master_Node_FSM(&mstp_port);
+    zassert_false(transition_now, NULL);
+    zassert_equal(
+        mstp_port.Zero_Config_State, MSTP_ZERO_CONFIG_STATE_IDLE, NULL);
+    /* the start address is chosen from the UUID */
+    station = Nmin_poll_station +
+        (uuid_hash % ((Nmax_poll_station - Nmin_poll_station) + 1));
+    zassert_equal(mstp_port.Zero_Config_Station, station, NULL);
+    zassert_true(mstp_port.Npoll_slot >= 1, NULL);
+    zassert_true(mstp_port.Npoll_slot <= Nmax_poll_slot_accelerated, NULL);
+    /* another node starts somewhere else */
+    testZeroConfigNode_Init(&other_port);
+    for (i = 0; i < MSTP_UUID_SIZE; i++) {
+        other_port.UUID[i] = (uint8_t)(MSTP_UUID_SIZE - i);
+    }
+    other_port.ZeroConfigAccelerated = true;
+    MSTP_Init(&other_port);
+    (void)MSTP_Master_Node_FSM(&other_port);
+    zassert_not_equal(
+        other_port.Zero_Config_Station, mstp_port.Zero_Config_Station, NULL);
+    /* the stations after the start address are seen in use */
+    SilenceTime = 0;
+    mstp_port.FrameType = FRAME_TYPE_TOKEN;
+    mstp_port.DestinationAddress = 0;
+    used = station;
+    for (i = 1; i <= 3; i++) {
+        used = MSTP_Zero_Config_Station_Increment(used);
+        mstp_port.SourceAddress = used;
+        mstp_port.ReceivedValidFrameNotForUs = true;
+        (void)MSTP_Master_Node_FSM(&mstp_port);
+        zassert_false(mstp_port.ReceivedValidFrameNotForUs, NULL);
+    }
+    zassert_equal(mstp_port.Zero_Config_Station, station, NULL);
+    /* the start address is in use: the next free one is monitored */
+    mstp_port.SourceAddress = station;
+    mstp_port.ReceivedValidFrame = true;
+    (void)MSTP_Master_Node_FSM(&mstp_port);
+    zassert_equal(
+        mstp_port.Zero_Config_State, MSTP_ZERO_CONFIG_STATE_LURK, NULL);
+    (void)MSTP_Master_Node_FSM(&mstp_port);
+    zassert_false(mstp_port.ReceivedValidFrame, NULL);
+    station = MSTP_Zero_Config_Station_Increment(station);
+    station = MSTP_Zero_Config_Station_Increment(station);
+    station = MSTP_Zero_Config_Station_Increment(station);
+    station = MSTP_Zero_Config_Station_Increment(station);
+    zassert_equal(mstp_port.Zero_Config_Station, station, NULL);
+    /* the address is claimed after fewer polls */
+    mstp_port.SourceAddress = 0;
+    mstp_port.FrameType = FRAME_TYPE_POLL_FOR_MASTER;
+    mstp_port.DestinationAddress = station;
+    for (count = 0; count < (Nmin_poll + Nmax_poll_slot); count++) {
+        mstp_port.ReceivedValidFrame = true;
+        (void)MSTP_Master_Node_FSM(&mstp_port);
+        if (mstp_port.Zero_Config_State == MSTP_ZERO_CONFIG_STATE_CLAIM) {
+            break;
+        }
+    }
+    zassert_equal(
+        mstp_port.Zero_Config_State, MSTP_ZERO_CONFIG_STATE_CLAIM, NULL);
+    zassert_equal(count, Nmin_poll + mstp_port.Npoll_slot, NULL);
+    zassert_equal(
+        mstp_port.OutputBuffer[2], FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER, NULL);
+    zassert_equal(mstp_port.OutputBuffer[4], station, NULL);
+}
+
 static void testZeroConfigNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
@@ -1332,6 +1730,75 @@ static void testAutoBaudNode_Idle_Timeout(struct mstp_port_struct_t *mstp_port)
     zassert_true(mstp_port->ValidFrameTimer(NULL) == 0, NULL);
 }
 
+/**
+ * @brief Test the auto-baud from a measured bit time
+ */
+static void testAutoBaudFast(void)
+{
+    struct mstp_port_struct_t mstp_port = { 0 };
+    unsigned i;
+
+    /* the nearest rate to each bit time */
+    zassert_equal(MSTP_Auto_Baud_Rate_Index(8680), 0, NULL);
+    zassert_equal(MSTP_Auto_Baud_Rate_Index(13020), 1, NULL);
+    zassert_equal(MSTP_Auto_Baud_Rate_Index(17361), 2, NULL);
+    zassert_equal(MSTP_Auto_Baud_Rate_Index(26000), 3, NULL);
+    zassert_equal(MSTP_Auto_Baud_Rate_Index(52000), 4, NULL);
+    zassert_equal(MSTP_Auto_Baud_Rate_Index(104166), 5, NULL);
+    zassert_equal(MSTP_Auto_Baud_Rate_Index(1), 0, NULL);
+    zassert_equal(MSTP_Auto_Baud_Rate_Index(UINT32_MAX), 5, NULL);
+    /* the shortest edge time is kept */
+    MSTP_Auto_Baud_Bit_Time_Set(NULL, 1000);
+    MSTP_Auto_Baud_Bit_Time_Set(&mstp_port, 3 * 26041);
+    MSTP_Auto_Baud_Bit_Time_Set(&mstp_port, 26041);
+    MSTP_Auto_Baud_Bit_Time_Set(&mstp_port, 2 * 26041);
+    zassert_equal(mstp_port.Auto_Baud_Bit_Time, 26041, NULL);
+    MSTP_Auto_Baud_Bit_Time_Set(&mstp_port, 0);
+    zassert_equal(mstp_port.Auto_Baud_Bit_Time, 0, NULL);
+    /* the measured rate is tried at once, and one valid frame is enough */
+    mstp_port.AutoBaudFast = true;
+    testAutoBaudNode_Init(&mstp_port);
+    zassert_equal(mstp_port.BaudRate(), 115200, NULL);
+    Good_Header_Time = 0;
+    MSTP_Auto_Baud_Bit_Time_Set(&mstp_port, 26041);
+    (void)MSTP_Master_Node_FSM(&mstp_port);
+    zassert_equal(mstp_port.BaudRateIndex, 3, NULL);
+    zassert_equal(mstp_port.BaudRate(), 38400, NULL);
+    zassert_equal(mstp_port.Auto_Baud_State, MSTP_AUTO_BAUD_STATE_IDLE, NULL);
+    mstp_port.ReceivedValidFrame = true;
+    (void)MSTP_Master_Node_FSM(&mstp_port);
+    zassert_false(mstp_port.ReceivedValidFrame, NULL);
+    zassert_false(mstp_port.CheckAutoBaud, NULL);
+    zassert_equal(mstp_port.Auto_Baud_State, MSTP_AUTO_BAUD_STATE_USE, NULL);
+    zassert_equal(mstp_port.BaudRate(), 38400, NULL);
+    /* a measurement before the start is tried first */
+    MSTP_Auto_Baud_Bit_Time_Set(&mstp_port, 0);
+    MSTP_Auto_Baud_Bit_Time_Set(&mstp_port, 52083);
+    mstp_port.CheckAutoBaud = true;
+    mstp_port.Auto_Baud_State = MSTP_AUTO_BAUD_STATE_INIT;
+    (void)MSTP_Master_Node_FSM(&mstp_port);
+    zassert_equal(mstp_port.Auto_Baud_State, MSTP_AUTO_BAUD_STATE_IDLE, NULL);
+    zassert_equal(mstp_port.BaudRateIndex, 4, NULL);
+    zassert_equal(mstp_port.BaudRate(), 19200, NULL);
+    /* a wrong measurement is left after some invalid frames */
+    for (i = 0; i < Nmax_auto_baud_invalid_frames; i++) {
+        zassert_equal(mstp_port.BaudRateIndex, 4, NULL);
+        mstp_port.ReceivedInvalidFrame = true;
+        (void)MSTP_Master_Node_FSM(&mstp_port);
+        zassert_false(mstp_port.ReceivedInvalidFrame, NULL);
+    }
+    zassert_equal(mstp_port.BaudRateIndex, 5, NULL);
+    zassert_equal(mstp_port.BaudRate(), 9600, NULL);
+    zassert_equal(mstp_port.Auto_Baud_Bit_Time, 0, NULL);
+    zassert_equal(mstp_port.Auto_Baud_Invalid_Frames, 0, NULL);
+    zassert_true(mstp_port.CheckAutoBaud, NULL);
+    /* a new measurement is tried at once */
+    MSTP_Auto_Baud_Bit_Time_Set(&mstp_port, 8680);
+    (void)MSTP_Master_Node_FSM(&mstp_port);
+    zassert_equal(mstp_port.BaudRate(), 115200, NULL);
+    zassert_equal(mstp_port.ValidFrameTimer(NULL), 0, NULL);
+}
+
 static void testAutoBaudNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
@@ -1367,9 +1834,15 @@ void test_main(void)
 {
     ztest_test_suite(
         crc_tests, ztest_unit_test(testReceiveNodeFSM),
-        ztest_unit_test(testMasterNodeFSM), ztest_unit_test(testSlaveNodeFSM),
+        ztest_unit_test(testReceiveFrameBlock),
+        ztest_unit_test(testExtendedFrames),
+        ztest_unit_test(testMasterNodeFSM),
+        ztest_unit_test(testMasterNodeAdaptive),
+        ztest_unit_test(testSlaveNodeFSM),
         ztest_unit_test(testZeroConfigNodeFSM),
-        ztest_unit_test(testAutoBaudNodeFSM));
+        ztest_unit_test(testZeroConfigAccelerated),
+        ztest_unit_test(testAutoBaudNodeFSM),
+        ztest_unit_test(testAutoBaudFast));
 
     ztest_run_test_suite(crc_tests);
 }
@@ -0,0 +1,173 @@
+/**
+ * @file
+ * @brief test the MS/TP trunk analyzer
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/datalink/mstpstat.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static MSTPSTAT Test_Analyzer;
+
+/**
+ * @brief Simulate a token rotation of two masters, where MAC 2 sends a
+ *  request to MAC 1, which postpones its reply, and then polls for
+ *  a master that is absent
+ * @param start_us - time of the first token
+ */
+static void test_rotation(uint32_t start_us)
+{
+    MSTPSTAT *ms = &Test_Analyzer;
+
+    mstpstat_frame(ms, start_us, FRAME_TYPE_TOKEN, 2, 1, 0);
+    mstpstat_frame(
+        ms, start_us + 1000, FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY, 1, 2,
+        20);
+    mstpstat_frame(ms, start_us + 3000, FRAME_TYPE_REPLY_POSTPONED, 2, 1, 0);
+    mstpstat_frame(ms, start_us + 4000, FRAME_TYPE_POLL_FOR_MASTER, 3, 2, 0);
+    mstpstat_frame(ms, start_us + 64000, FRAME_TYPE_TOKEN, 1, 2, 0);
+}
+
+/**
+ * @brief Test the counts and the times of a sample
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(mstpstat_tests, test_mstpstat_sample)
+#else
+static void test_mstpstat_sample(void)
+#endif
+{
+    MSTPSTAT *ms = &Test_Analyzer;
+    MSTPSTAT_SAMPLE sample = { 0 };
+    const MSTPSTAT_NODE *node;
+
+    mstpstat_init(ms, 1000);
+    zassert_false(mstpstat_sample_take(ms, 0, &sample), NULL);
+    test_rotation(0);
+    /* the second token to MAC 2 ends the first rotation */
+    mstpstat_frame(ms, 70000, FRAME_TYPE_TOKEN, 2, 1, 0);
+    /* MAC 2 does not use it, and it is passed again */
+    mstpstat_frame(ms, 70100, FRAME_TYPE_TOKEN, 2, 1, 0);
+    mstpstat_invalid_frame(ms, 80000, 5);
+    zassert_false(mstpstat_sample_ready(ms, 999999), NULL);
+    zassert_true(mstpstat_sample_ready(ms, 1000000), NULL);
+    zassert_true(mstpstat_sample_take(ms, 1000000, &sample), NULL);
+    zassert_equal(sample.duration_us, 1000000, NULL);
+    zassert_equal(sample.frames, 7, NULL);
+    zassert_equal(sample.invalid_frames, 1, NULL);
+    zassert_equal(sample.octets, (7 * 8) + 22 + 5, NULL);
+    zassert_equal(sample.tokens, 4, NULL);
+    zassert_equal(sample.token_retries, 1, NULL);
+    zassert_equal(sample.pfm, 1, NULL);
+    zassert_equal(sample.pfm_time_us, 60000, NULL);
+    zassert_equal(sample.der, 1, NULL);
+    zassert_equal(sample.reply_postponed, 1, NULL);
+    /* MAC 2 at 70000, since MAC 1 had the token only once */
+    zassert_equal(sample.rotation_count, 1, NULL);
+    zassert_equal(sample.rotation_min_us, 70000, NULL);
+    zassert_equal(sample.rotation_max_us, 70000, NULL);
+    zassert_equal(mstpstat_rotation_average(&sample), 70000, NULL);
+    /* 83 octets of 10 bits in 1 second at 9600 bps */
+    zassert_equal(mstpstat_utilization(&sample, 9600), 86, NULL);
+    zassert_equal(mstpstat_utilization(&sample, 0), 0, NULL);
+    zassert_equal(mstpstat_pfm_permille(&sample), 60, NULL);
+    /* the next sample starts empty */
+    zassert_false(mstpstat_sample_ready(ms, 1500000), NULL);
+    zassert_true(mstpstat_sample_take(ms, 1500000, &sample), NULL);
+    zassert_equal(sample.frames, 0, NULL);
+    zassert_equal(sample.duration_us, 500000, NULL);
+    zassert_equal(mstpstat_rotation_average(&sample), 0, NULL);
+    zassert_equal(mstpstat_total(ms)->duration_us, 1500000, NULL);
+    zassert_equal(mstpstat_total(ms)->frames, 7, NULL);
+    /* the nodes */
+    node = mstpstat_node(ms, 2);
+    zassert_equal(node->frames, 3, NULL);
+    zassert_equal(node->octets, 8 + 30 + 8, NULL);
+    zassert_equal(node->tokens, 2, NULL);
+    zassert_equal(node->token_time_us, 64000, NULL);
+    zassert_equal(node->data_tokens, 1, NULL);
+    zassert_equal(node->max_info_frames, 1, NULL);
+    zassert_equal(node->full_tokens, 1, NULL);
+    zassert_equal(node->max_master, 3, NULL);
+    zassert_equal(node->tusage_max_us, 60000, NULL);
+    node = mstpstat_node(ms, 1);
+    zassert_equal(node->tokens, 1, NULL);
+    zassert_equal(node->der_received, 1, NULL);
+    zassert_equal(node->reply_postponed, 1, NULL);
+    zassert_is_null(mstpstat_node(NULL, 1), NULL);
+}
+
+/**
+ * @brief Test the settings that look wrong from the frames
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(mstpstat_tests, test_mstpstat_advice)
+#else
+static void test_mstpstat_advice(void)
+#endif
+{
+    MSTPSTAT *ms = &Test_Analyzer;
+    unsigned i, advice;
+
+    mstpstat_init(ms, 0);
+    for (i = 0; i < MSTPSTAT_ADVICE_MIN; i++) {
+        test_rotation(i * 70000UL);
+    }
+    zassert_false(mstpstat_sample_ready(ms, 0xFFFFFFFF), NULL);
+    advice = mstpstat_advice(ms, 2);
+    zassert_true(advice & MSTPSTAT_ADVICE_MAX_INFO_FRAMES, NULL);
+    zassert_true(advice & MSTPSTAT_ADVICE_MAX_MASTER, NULL);
+    zassert_true(advice & MSTPSTAT_ADVICE_TUSAGE_TIMEOUT, NULL);
+    zassert_false(advice & MSTPSTAT_ADVICE_REPLY_POSTPONED, NULL);
+    advice = mstpstat_advice(ms, 1);
+    zassert_equal(advice, MSTPSTAT_ADVICE_REPLY_POSTPONED, NULL);
+    zassert_equal(mstpstat_advice(ms, 3), 0, NULL);
+    zassert_equal(mstpstat_advice(NULL, 1), 0, NULL);
+}
+
+/**
+ * @brief Test the samples when the microsecond time wraps around
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(mstpstat_tests, test_mstpstat_wrap)
+#else
+static void test_mstpstat_wrap(void)
+#endif
+{
+    MSTPSTAT *ms = &Test_Analyzer;
+    MSTPSTAT_SAMPLE sample = { 0 };
+    uint32_t start_us = 0xFFFFFFFFUL - 50000UL;
+
+    mstpstat_init(ms, 100);
+    test_rotation(start_us);
+    mstpstat_frame(ms, start_us + 70000UL, FRAME_TYPE_TOKEN, 2, 1, 0);
+    zassert_false(mstpstat_sample_ready(ms, start_us + 99999UL), NULL);
+    zassert_true(mstpstat_sample_ready(ms, start_us + 100000UL), NULL);
+    zassert_true(
+        mstpstat_sample_take(ms, start_us + 100000UL, &sample), NULL);
+    zassert_equal(sample.duration_us, 100000, NULL);
+    zassert_equal(sample.rotation_max_us, 70000, NULL);
+    zassert_equal(sample.pfm_time_us, 60000, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(mstpstat_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        mstpstat_tests, ztest_unit_test(test_mstpstat_sample),
+        ztest_unit_test(test_mstpstat_advice),
+        ztest_unit_test(test_mstpstat_wrap));
+
+    ztest_run_test_suite(mstpstat_tests);
+}
+#endif
@@ -20,6 +20,14 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
     ztest_check_expected_value(mstp_port);
 }
 
+size_t MSTP_Receive_Frame_Block(
+    struct mstp_port_struct_t *mstp_port, const uint8_t *buffer, size_t length)
+{
+    ztest_check_expected_value(mstp_port);
+    (void)buffer;
+    return length;
+}
+
 bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
 {
     ztest_check_expected_value(mstp_port);
@@ -70,6 +78,24 @@ void MSTP_Create_And_Send_Frame(
     ztest_check_expected_data(data, data_len);
 }
 
+uint8_t MSTP_Max_Info_Frames(const struct mstp_port_struct_t *mstp_port)
+{
+    return mstp_port ? mstp_port->Nmax_info_frames : 0;
+}
+
+uint8_t MSTP_Max_Master(const struct mstp_port_struct_t *mstp_port)
+{
+    return mstp_port ? mstp_port->Nmax_master : 0;
+}
+
+bool MSTP_Extended_Frames_Refused(
+    const struct mstp_port_struct_t *mstp_port, uint8_t station)
+{
+    (void)mstp_port;
+    (void)station;
+    return false;
+}
+
 void MSTP_Fill_BACnet_Address(BACNET_ADDRESS *src, uint8_t mstp_address)
 {
     ztest_check_expected_value(src);
@@ -615,6 +615,101 @@ static void testDatetimeConvertUTC(void)
     testDatetimeConvertUTCSpecific(
         &utc_time, &local_time, utc_offset_minutes, dst_adjust_minutes);
 }
+
+/* field by field reference, skipping the fields that are a wildcard */
+static int testDatetimeFieldCompare(
+    const BACNET_DATE_TIME *dt1, const BACNET_DATE_TIME *dt2, bool wildcard)
+{
+    const int w[7] = { 1900 + 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    int v1[7], v2[7];
+    int i;
+
+    v1[0] = dt1->date.year;
+    v1[1] = dt1->date.month;
+    v1[2] = dt1->date.day;
+    v1[3] = dt1->time.hour;
+    v1[4] = dt1->time.min;
+    v1[5] = dt1->time.sec;
+    v1[6] = dt1->time.hundredths;
+    v2[0] = dt2->date.year;
+    v2[1] = dt2->date.month;
+    v2[2] = dt2->date.day;
+    v2[3] = dt2->time.hour;
+    v2[4] = dt2->time.min;
+    v2[5] = dt2->time.sec;
+    v2[6] = dt2->time.hundredths;
+    for (i = 0; i < 7; i++) {
+        if (wildcard && ((v1[i] == w[i]) || (v2[i] == w[i]))) {
+            continue;
+        }
+        if (v1[i] != v2[i]) {
+            return (v1[i] > v2[i]) ? 1 : -1;
+        }
+    }
+
+    return 0;
+}
+
+static int testDatetimeSign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacnet_datetime, testDatetimeKey)
+#else
+static void testDatetimeKey(void)
+#endif
+{
+    BACNET_DATE_TIME dt[6] = { 0 };
+    unsigned i, j;
+    int diff;
+
+    datetime_set_values(&dt[0], 2024, 6, 6, 12, 30, 15, 50);
+    datetime_set_values(&dt[1], 2024, 6, 6, 12, 30, 15, 51);
+    datetime_set_values(&dt[2], 2023, 12, 31, 23, 59, 59, 99);
+    datetime_set_values(&dt[3], 2024, 7, 1, 0, 0, 0, 0);
+    datetime_set_values(&dt[4], 2024, 6, 6, 12, 30, 15, 50);
+    datetime_wildcard_year_set(&dt[4].date);
+    datetime_wildcard_hundredths_set(&dt[4].time);
+    datetime_set_values(&dt[5], 2024, 13, 6, 12, 30, 15, 50);
+    datetime_wildcard_day_set(&dt[5].date);
+    datetime_wildcard_minute_set(&dt[5].time);
+    for (i = 0; i < 6; i++) {
+        for (j = 0; j < 6; j++) {
+            diff = testDatetimeFieldCompare(&dt[i], &dt[j], false);
+            zassert_equal(
+                testDatetimeSign(datetime_compare(&dt[i], &dt[j])), diff,
+                NULL);
+            zassert_equal(
+                datetime_key_compare(
+                    datetime_key(&dt[i]), datetime_key(&dt[j])),
+                diff, NULL);
+            zassert_equal(
+                testDatetimeSign(
+                    datetime_compare_date(&dt[i].date, &dt[j].date)),
+                datetime_key_compare32(
+                    datetime_date_key(&dt[i].date),
+                    datetime_date_key(&dt[j].date)),
+                NULL);
+            diff = testDatetimeFieldCompare(&dt[i], &dt[j], true);
+            zassert_equal(
+                testDatetimeSign(datetime_wildcard_compare(&dt[i], &dt[j])),
+                diff, NULL);
+            zassert_equal(
+                datetime_key_wildcard_compare(
+                    datetime_key(&dt[i]), datetime_key_mask(&dt[i]),
+                    datetime_key(&dt[j]), datetime_key_mask(&dt[j])),
+                diff, NULL);
+        }
+    }
+    zassert_equal(datetime_time_key_mask(&dt[0].time), UINT32_MAX, NULL);
+    zassert_equal(datetime_date_key_mask(&dt[0].date), UINT32_MAX, NULL);
+    zassert_equal(datetime_time_key_mask(&dt[4].time), 0xFFFFFF00UL, NULL);
+    zassert_equal(datetime_date_key_mask(&dt[4].date), 0x0000FFFFUL, NULL);
+    zassert_equal(datetime_key(NULL), 0, NULL);
+    zassert_equal(datetime_key_mask(NULL), 0, NULL);
+}
 /**
  * @}
  */
@@ -635,7 +730,8 @@ void test_main(void)
         ztest_unit_test(testWildcardDateTime),
         ztest_unit_test(testBACnetDateTimeSeconds),
         ztest_unit_test(testDayOfYear),
-        ztest_unit_test(testDatetimeConvertUTC));
+        ztest_unit_test(testDatetimeConvertUTC),
+        ztest_unit_test(testDatetimeKey));
 
     ztest_run_test_suite(bacnet_datetime);
 }
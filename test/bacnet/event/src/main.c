@@ -1662,7 +1662,9 @@ static void testEventNotification(void)
 #endif
 {
     uint8_t apdu[MAX_APDU];
-    int apdu_len, test_len, null_len;
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    uint8_t body[MAX_APDU] = { 0 };
+    int apdu_len, test_len, null_len, body_len;
     uint8_t invoke_id = 2;
 
     /* common to all the notification types */
@@ -1793,6 +1795,35 @@ static void testEventNotification(void)
             event_notification_service_request_encode(apdu, apdu_len, &Data);
         zassert_equal(test_len, 0, NULL);
     }
+    /* a body encoded once gives the same APDU as the full encoding */
+    body_len = event_notify_encode_service_request_body(NULL, &Data);
+    zassert_true(body_len > 0, NULL);
+    zassert_equal(
+        event_notify_encode_service_request_body(body, &Data), body_len, NULL);
+    apdu_len = cevent_notify_encode_apdu(apdu, invoke_id, &Data);
+    test_len = (int)event_notify_encode_apdu_body(
+        test_apdu, sizeof(test_apdu), true, invoke_id, Data.processIdentifier,
+        body, (size_t)body_len);
+    zassert_equal(test_len, apdu_len, NULL);
+    zassert_mem_equal(test_apdu, apdu, (size_t)apdu_len, NULL);
+    null_len = (int)event_notify_encode_apdu_body(
+        NULL, sizeof(test_apdu), true, invoke_id, Data.processIdentifier,
+        body, (size_t)body_len);
+    zassert_equal(null_len, apdu_len, NULL);
+    test_len = (int)event_notify_encode_apdu_body(
+        test_apdu, (size_t)apdu_len - 1, true, invoke_id,
+        Data.processIdentifier, body, (size_t)body_len);
+    zassert_equal(test_len, 0, NULL);
+    apdu_len = uevent_notify_encode_apdu(apdu, &Data);
+    test_len = (int)event_notify_encode_apdu_body(
+        test_apdu, sizeof(test_apdu), false, 0, Data.processIdentifier, body,
+        (size_t)body_len);
+    zassert_equal(test_len, apdu_len, NULL);
+    zassert_mem_equal(test_apdu, apdu, (size_t)apdu_len, NULL);
+    test_len = (int)event_notify_encode_apdu_body(
+        test_apdu, sizeof(test_apdu), false, 0, Data.processIdentifier, NULL,
+        0);
+    zassert_equal(test_len, 0, NULL);
 }
 /**
  * @}
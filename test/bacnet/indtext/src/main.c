@@ -61,6 +61,77 @@ static void testIndexText(void)
     zassert_equal(
         index, indtext_by_istring_default(data_list, "ANNA", index), NULL);
 }
+
+/* long enough to get a lookup index, out of order, with a duplicate
+   index, and the same string in another case */
+static INDTEXT_DATA long_list[] = {
+    { 17, "seventeen" }, { 3, "three" },    { 4, "four" },
+    { 5, "five" },       { 6, "six" },      { 7, "seven" },
+    { 8, "eight" },      { 9, "nine" },     { 10, "ten" },
+    { 11, "eleven" },    { 12, "twelve" },  { 13, "thirteen" },
+    { 14, "fourteen" },  { 15, "fifteen" }, { 16, "Sixteen" },
+    { 1, "one" },        { 2, "two" },      { 3, "drei" },
+    { 18, "sixteen" },   { 0, NULL }
+};
+
+/* long enough to get a lookup index, but too sparse to index by index */
+static INDTEXT_DATA sparse_list[] = {
+    { 1, "a" },       { 10, "b" },      { 100, "c" },     { 1000, "d" },
+    { 2000, "e" },    { 3000, "f" },    { 4000, "g" },    { 5000, "h" },
+    { 6000, "i" },    { 7000, "j" },    { 8000, "k" },    { 9000, "l" },
+    { 10000, "m" },   { 11000, "n" },   { 12000, "o" },   { 65535, "p" },
+    { 4194303, "q" }, { 0, NULL }
+};
+
+/**
+ * @brief Test the lookups of the lists that get a lookup index
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(indtext_tests, testIndexTextLong)
+#else
+static void testIndexTextLong(void)
+#endif
+{
+    uint32_t index = 0;
+
+    zassert_equal(indtext_count(long_list), 19, NULL);
+    zassert_equal(indtext_count(long_list), 19, NULL);
+    zassert_equal(
+        strcmp(indtext_by_index(long_list, 17), "seventeen"), 0, NULL);
+    zassert_equal(strcmp(indtext_by_index(long_list, 1), "one"), 0, NULL);
+    /* the first of a duplicate index */
+    zassert_equal(strcmp(indtext_by_index(long_list, 3), "three"), 0, NULL);
+    zassert_is_null(indtext_by_index(long_list, 0), NULL);
+    zassert_is_null(indtext_by_index(long_list, 19), NULL);
+    zassert_equal(
+        strcmp(indtext_by_index_default(long_list, 99, "none"), "none"), 0,
+        NULL);
+    zassert_true(indtext_by_string(long_list, "drei", &index), NULL);
+    zassert_equal(index, 3, NULL);
+    zassert_true(indtext_by_string(long_list, "two", &index), NULL);
+    zassert_equal(index, 2, NULL);
+    zassert_false(indtext_by_string(long_list, "TWO", &index), NULL);
+    zassert_true(indtext_by_istring(long_list, "TWO", &index), NULL);
+    zassert_equal(index, 2, NULL);
+    zassert_false(indtext_by_istring(long_list, "twenty", &index), NULL);
+    zassert_false(indtext_by_istring(long_list, "", &index), NULL);
+    /* the same string in another case */
+    zassert_true(indtext_by_string(long_list, "sixteen", &index), NULL);
+    zassert_equal(index, 18, NULL);
+    zassert_true(indtext_by_string(long_list, "Sixteen", &index), NULL);
+    zassert_equal(index, 16, NULL);
+    zassert_true(indtext_by_istring(long_list, "SIXTEEN", &index), NULL);
+    zassert_equal(index, 16, NULL);
+    zassert_false(indtext_by_string(long_list, "SIXTEEN", &index), NULL);
+    /* sparse */
+    zassert_equal(indtext_count(sparse_list), 17, NULL);
+    zassert_equal(strcmp(indtext_by_index(sparse_list, 4194303), "q"), 0, NULL);
+    zassert_is_null(indtext_by_index(sparse_list, 2), NULL);
+    zassert_true(indtext_by_string(sparse_list, "p", &index), NULL);
+    zassert_equal(index, 65535, NULL);
+    zassert_true(indtext_by_istring(sparse_list, "A", &index), NULL);
+    zassert_equal(index, 1, NULL);
+}
 /**
  * @}
  */
@@ -70,7 +141,9 @@ ZTEST_SUITE(indtext_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(indtext_tests, ztest_unit_test(testIndexText));
+    ztest_test_suite(
+        indtext_tests, ztest_unit_test(testIndexText),
+        ztest_unit_test(testIndexTextLong));
 
     ztest_run_test_suite(indtext_tests);
 }
@@ -13,6 +13,7 @@
 #include <bacnet/reject.h>
 #include <bacnet/rp.h>
 #include <bacnet/whois.h>
+#include <bacnet/basic/service/h_apdu.h>
 
 /**
  * @addtogroup bacnet_tests
@@ -538,6 +539,67 @@ static void test_NPDU_Data_Expecting_Reply(void)
         reply_pdu, reply_pdu_len, &test_address, npdu_len + 3);
 }
 
+static void *Scratch_Memory;
+static size_t Scratch_Used;
+
+static void test_scratch_handler(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    Scratch_Memory = apdu_scratch_alloc(MAX_APDU);
+    Scratch_Used = Arena_Used(apdu_scratch());
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(npdu_tests, test_APDU_Scratch)
+#else
+static void test_APDU_Scratch(void)
+#endif
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    static uint8_t buffer[MAX_APDU / 2];
+    void *memory;
+    int apdu_len;
+
+    rpdata.object_type = OBJECT_DEVICE;
+    rpdata.object_instance = 12345;
+    rpdata.object_property = PROP_OBJECT_NAME;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    apdu_len = rp_encode_apdu(apdu, 1, &rpdata);
+    zassert_true(apdu_len > 0, NULL);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, test_scratch_handler);
+    /* the handler takes memory of the request from the scratch memory,
+       and it is taken back after the request */
+    zassert_true(
+        Arena_Available(apdu_scratch()) >= BACNET_APDU_SCRATCH_SIZE, NULL);
+    apdu_handler(&src, apdu, apdu_len);
+    zassert_not_null(Scratch_Memory, NULL);
+    zassert_true(Scratch_Used >= MAX_APDU, NULL);
+    zassert_equal(Arena_Used(apdu_scratch()), 0, NULL);
+    memory = Scratch_Memory;
+    apdu_handler(&src, apdu, apdu_len);
+    zassert_equal(Scratch_Memory, memory, NULL);
+    zassert_true(Arena_Peak(apdu_scratch()) >= MAX_APDU, NULL);
+    /* memory of the application is too small for the handler */
+    apdu_scratch_set(buffer, sizeof(buffer));
+    apdu_handler(&src, apdu, apdu_len);
+    zassert_is_null(Scratch_Memory, NULL);
+    /* back to the built-in scratch memory */
+    apdu_scratch_set(NULL, 0);
+    apdu_handler(&src, apdu, apdu_len);
+    zassert_equal(Scratch_Memory, memory, NULL);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_READ_PROPERTY, NULL);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST_SUITE(npdu_tests, NULL, NULL, NULL, NULL, NULL);
 #else
@@ -548,7 +610,8 @@ void test_main(void)
         ztest_unit_test(test_NPDU_Network), ztest_unit_test(test_NPDU_Copy),
         ztest_unit_test(test_NPDU_Confirmed_Service),
         ztest_unit_test(test_NPDU_Segmented_Complex_Ack_Reply),
-        ztest_unit_test(test_NPDU_Data_Expecting_Reply));
+        ztest_unit_test(test_NPDU_Data_Expecting_Reply),
+        ztest_unit_test(test_APDU_Scratch));
 
     ztest_run_test_suite(npdu_tests);
 }
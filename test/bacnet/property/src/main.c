@@ -455,6 +455,66 @@ static void testPropListBACnetList(void)
         "proprietary properties should be considered BACnetLIST members");
 }
 
+/**
+ * @brief Test the property list sets against the property list scan
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(property_tests, testPropListSet)
+#else
+static void testPropListSet(void)
+#endif
+{
+    static const int32_t High_List[] = { PROP_OBJECT_NAME, 512, 4194304, -1 };
+    static const int32_t Empty_List[] = { -1 };
+    struct special_property_list_t property_list = { 0 };
+    struct property_list_set set = { 0 };
+    unsigned i = 0;
+    int32_t property = 0;
+    bool status = false;
+
+    for (i = 0; i < OBJECT_PROPRIETARY_MIN; i++) {
+        property_list_special((BACNET_OBJECT_TYPE)i, &property_list);
+        property_list_set_init(&set);
+        status = property_list_set_add(&set, property_list.Required.pList);
+        zassert_true(status, NULL);
+        status = property_list_set_add(&set, property_list.Optional.pList);
+        zassert_true(status, NULL);
+        status = property_list_set_add(&set, property_list.Proprietary.pList);
+        zassert_true(status, NULL);
+        for (property = -1; property <= PROP_RESERVED_RANGE_LAST; property++) {
+            if (property == 1024) {
+                /* skip most of the proprietary range */
+                property = PROP_PROPRIETARY_RANGE_MAX - 8;
+            }
+            zassert_equal(
+                property_list_set_member(&set, property),
+                property_lists_member(
+                    property_list.Required.pList, property_list.Optional.pList,
+                    property_list.Proprietary.pList, property),
+                "%s: property %d",
+                bactext_object_type_name((BACNET_OBJECT_TYPE)i), property);
+        }
+    }
+    /* members above the bitset are scanned */
+    property_list_set_init(&set);
+    zassert_false(property_list_set_member(&set, PROP_OBJECT_NAME), NULL);
+    zassert_true(property_list_set_add(&set, NULL), NULL);
+    zassert_true(property_list_set_add(&set, Empty_List), NULL);
+    zassert_equal(set.scan_count, 0, NULL);
+    for (i = 0; i < PROPERTY_LIST_SET_SCAN_MAX; i++) {
+        zassert_true(property_list_set_add(&set, High_List), NULL);
+    }
+    zassert_equal(set.scan_count, PROPERTY_LIST_SET_SCAN_MAX, NULL);
+    zassert_false(property_list_set_add(&set, High_List), NULL);
+    zassert_true(property_list_set_member(&set, PROP_OBJECT_NAME), NULL);
+    zassert_true(property_list_set_member(&set, 512), NULL);
+    zassert_true(property_list_set_member(&set, 4194304), NULL);
+    zassert_false(property_list_set_member(&set, 513), NULL);
+    zassert_false(property_list_set_member(&set, -1), NULL);
+    zassert_false(property_list_set_member(NULL, PROP_OBJECT_NAME), NULL);
+    zassert_false(property_list_set_add(NULL, High_List), NULL);
+}
+
 /**
  * @}
  */
@@ -468,7 +528,8 @@ void test_main(void)
         property_tests, ztest_unit_test(testPropList),
         ztest_unit_test(testPropListCommon),
         ztest_unit_test(testPropListEncode),
-        ztest_unit_test(testPropListBACnetList));
+        ztest_unit_test(testPropListBACnetList),
+        ztest_unit_test(testPropListSet));
 
     ztest_run_test_suite(property_tests);
 }
@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @brief Tests for the Audit Log storage in memory mapped files on Linux
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <zephyr/ztest.h>
+#include "bacnet/basic/object/auditlog.h"
+#include "auditlog-mmap.h"
+
+#define TEST_INSTANCE 7
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Get the size of the storage file of a log
+ * @param directory - directory of the storage files
+ * @param object_instance - object-instance number of the log
+ * @return size of the file, or -1 if there is no file
+ */
+static long test_file_size(const char *directory, uint32_t object_instance)
+{
+    char pathname[PATH_MAX];
+    struct stat st = { 0 };
+
+    snprintf(
+        pathname, sizeof(pathname), "%s/auditlog-0-%lu.dat", directory,
+        (unsigned long)object_instance);
+    if (stat(pathname, &st) != 0) {
+        return -1;
+    }
+
+    return (long)st.st_size;
+}
+
+/**
+ * @brief Encode all the records of a log
+ * @param apdu - buffer for the records
+ * @param apdu_size - size of the buffer
+ * @return number of bytes encoded
+ */
+static int test_records_encode(uint8_t *apdu, size_t apdu_size)
+{
+    BACNET_READ_RANGE_DATA request = { 0 };
+
+    request.object_type = OBJECT_AUDIT_LOG;
+    request.object_instance = TEST_INSTANCE;
+    request.object_property = PROP_LOG_BUFFER;
+    request.array_index = BACNET_ARRAY_ALL;
+    request.application_data = apdu;
+    request.application_data_len = apdu_size;
+    request.RequestType = RR_READ_ALL;
+
+    return Audit_Log_Read_Range(apdu, &request);
+}
+
+/**
+ * @brief Test the records of the audit logs surviving a restart
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(auditlog_mmap_tests, test_auditlog_mmap)
+#else
+static void test_auditlog_mmap(void)
+#endif
+{
+    char directory[] = "/tmp/auditlog-mmap-XXXXXX";
+    BACNET_AUDIT_NOTIFICATION notification = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    uint32_t total_records;
+    int len, test_len;
+    uint8_t i;
+
+    zassert_not_null(mkdtemp(directory), NULL);
+    zassert_false(audit_log_mmap_init(NULL), NULL);
+    zassert_false(audit_log_mmap_init("/nonexistent/auditlog"), NULL);
+    zassert_true(audit_log_mmap_init(directory), NULL);
+    Audit_Log_Init();
+    zassert_equal(Audit_Log_Create(TEST_INSTANCE), TEST_INSTANCE, NULL);
+    zassert_equal(
+        test_file_size(directory, TEST_INSTANCE),
+        (long)BACNET_AUDIT_LOG_STORAGE_SIZE(BACNET_AUDIT_LOG_RECORDS_MAX),
+        NULL);
+    zassert_true(Audit_Log_Buffer_Size_Set(TEST_INSTANCE, 16), NULL);
+    zassert_equal(
+        test_file_size(directory, TEST_INSTANCE),
+        (long)BACNET_AUDIT_LOG_STORAGE_SIZE(16), NULL);
+    zassert_true(Audit_Log_Enable_Set(TEST_INSTANCE, true), NULL);
+    for (i = 0; i < 20; i++) {
+        notification.operation = AUDIT_OPERATION_WRITE;
+        notification.invoke_id = i;
+        Audit_Log_Record_Notification_Insert(TEST_INSTANCE, &notification);
+    }
+    zassert_equal(Audit_Log_Record_Count(TEST_INSTANCE), 16, NULL);
+    total_records = Audit_Log_Total_Record_Count(TEST_INSTANCE);
+    zassert_equal(total_records, 21, NULL);
+    len = test_records_encode(apdu, sizeof(apdu));
+    zassert_true(len > 0, NULL);
+    /* the records are resumed from the file after a restart */
+    audit_log_mmap_cleanup();
+    zassert_false(Audit_Log_Valid_Instance(TEST_INSTANCE), NULL);
+    zassert_true(audit_log_mmap_init(directory), NULL);
+    Audit_Log_Init();
+    zassert_equal(Audit_Log_Create(TEST_INSTANCE), TEST_INSTANCE, NULL);
+    zassert_equal(Audit_Log_Buffer_Size(TEST_INSTANCE), 16, NULL);
+    zassert_equal(Audit_Log_Record_Count(TEST_INSTANCE), 16, NULL);
+    zassert_equal(
+        Audit_Log_Total_Record_Count(TEST_INSTANCE), total_records, NULL);
+    test_len = test_records_encode(test_apdu, sizeof(test_apdu));
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    /* the file is removed with the object */
+    zassert_true(Audit_Log_Delete(TEST_INSTANCE), NULL);
+    zassert_equal(test_file_size(directory, TEST_INSTANCE), -1, NULL);
+    audit_log_mmap_cleanup();
+    zassert_equal(rmdir(directory), 0, NULL);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(auditlog_mmap_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        auditlog_mmap_tests, ztest_unit_test(test_auditlog_mmap));
+
+    ztest_run_test_suite(auditlog_mmap_tests);
+}
+#endif
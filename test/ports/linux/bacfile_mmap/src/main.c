@@ -0,0 +1,192 @@
+/**
+ * @file
+ * @brief Tests for the File object stream access in memory mapped files
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zephyr/ztest.h>
+#include "bacnet/arf.h"
+#include "bacnet/awf.h"
+#include "bacnet/basic/object/bacfile.h"
+#include "bacfile-mmap.h"
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static char Test_Directory[] = "bacfile-mmap-XXXXXX";
+
+/**
+ * @brief Get the pathname of a test file
+ * @param pathname - [out] buffer for the pathname
+ * @param size - size of the buffer
+ * @param name - name of the file
+ */
+static void test_pathname(char *pathname, size_t size, const char *name)
+{
+    snprintf(pathname, size, "%s/%s", Test_Directory, name);
+}
+
+/**
+ * @brief Test the stream access through the File object
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacfile_mmap_tests, test_bacfile_mmap_object)
+#else
+static void test_bacfile_mmap_object(void)
+#endif
+{
+    BACNET_ATOMIC_READ_FILE_DATA read_data = { 0 };
+    BACNET_ATOMIC_WRITE_FILE_DATA write_data = { 0 };
+    char pathname[PATH_MAX];
+    uint8_t chunk[100];
+    unsigned i;
+
+    zassert_not_null(mkdtemp(Test_Directory), NULL);
+    test_pathname(pathname, sizeof(pathname), "firmware.bin");
+    bacfile_init();
+    bacfile_mmap_init();
+    bacfile_create(1);
+    bacfile_pathname_set(1, pathname);
+    /* write the file in chunks, the first one as a clean slate */
+    for (i = 0; i < sizeof(chunk); i++) {
+        chunk[i] = (uint8_t)i;
+    }
+    write_data.object_instance = 1;
+    write_data.access = FILE_STREAM_ACCESS;
+    for (i = 0; i < 10; i++) {
+        write_data.type.stream.fileStartPosition = i * sizeof(chunk);
+        octetstring_init(&write_data.fileData[0], chunk, sizeof(chunk));
+        zassert_true(bacfile_write_stream_data(&write_data), NULL);
+    }
+    zassert_equal(bacfile_file_size(1), 10 * sizeof(chunk), NULL);
+    /* read the file in chunks */
+    read_data.object_instance = 1;
+    read_data.access = FILE_STREAM_ACCESS;
+    read_data.type.stream.requestedOctetCount = 64;
+    read_data.type.stream.fileStartPosition = 960;
+    zassert_true(bacfile_read_stream_data(&read_data), NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 40, NULL);
+    zassert_true(read_data.endOfFile, NULL);
+    zassert_equal(octetstring_value(&read_data.fileData[0])[0], 60, NULL);
+    read_data.type.stream.fileStartPosition = 150;
+    zassert_true(bacfile_read_stream_data(&read_data), NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 64, NULL);
+    zassert_false(read_data.endOfFile, NULL);
+    zassert_equal(octetstring_value(&read_data.fileData[0])[0], 50, NULL);
+    zassert_equal(octetstring_value(&read_data.fileData[0])[63], 13, NULL);
+    /* past the end of the file */
+    read_data.type.stream.fileStartPosition = 1000;
+    zassert_true(bacfile_read_stream_data(&read_data), NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 0, NULL);
+    zassert_true(read_data.endOfFile, NULL);
+    /* append, and the mapping follows the size of the file */
+    write_data.type.stream.fileStartPosition = -1;
+    octetstring_init(&write_data.fileData[0], chunk, 10);
+    zassert_true(bacfile_write_stream_data(&write_data), NULL);
+    zassert_equal(bacfile_file_size(1), 1010, NULL);
+    zassert_true(bacfile_read_stream_data(&read_data), NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 10, NULL);
+    zassert_equal(octetstring_value(&read_data.fileData[0])[9], 9, NULL);
+    /* a write at the start is a clean slate */
+    write_data.type.stream.fileStartPosition = 0;
+    octetstring_init(&write_data.fileData[0], chunk, 20);
+    zassert_true(bacfile_write_stream_data(&write_data), NULL);
+    zassert_equal(bacfile_file_size(1), 20, NULL);
+    read_data.type.stream.fileStartPosition = 0;
+    zassert_true(bacfile_read_stream_data(&read_data), NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 20, NULL);
+    zassert_true(read_data.endOfFile, NULL);
+    /* the file size is writable */
+    zassert_true(bacfile_mmap_file_size_set(pathname, 5), NULL);
+    zassert_equal(bacfile_mmap_file_size(pathname), 5, NULL);
+    zassert_equal(
+        bacfile_mmap_read_stream_data(pathname, 0, chunk, sizeof(chunk)), 5,
+        NULL);
+    bacfile_mmap_cleanup();
+    bacfile_cleanup();
+    unlink(pathname);
+}
+
+/**
+ * @brief Test more files than are kept open, and a replaced file
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacfile_mmap_tests, test_bacfile_mmap_files)
+#else
+static void test_bacfile_mmap_files(void)
+#endif
+{
+    char pathname[PATH_MAX];
+    char replaced[PATH_MAX];
+    char name[32];
+    uint8_t octet;
+    unsigned i;
+
+    zassert_equal(bacfile_mmap_read_stream_data(NULL, 0, &octet, 1), 0, NULL);
+    test_pathname(pathname, sizeof(pathname), "missing.bin");
+    zassert_equal(
+        bacfile_mmap_read_stream_data(pathname, 0, &octet, 1), 0, NULL);
+    zassert_equal(bacfile_mmap_file_size(pathname), 0, NULL);
+    zassert_false(bacfile_mmap_file_size_set(pathname, 1), NULL);
+    /* every file keeps its own contents when entries are reused */
+    for (i = 0; i < (2 * BACFILE_MMAP_FILES_MAX); i++) {
+        snprintf(name, sizeof(name), "file-%u.bin", i);
+        test_pathname(pathname, sizeof(pathname), name);
+        octet = (uint8_t)i;
+        zassert_equal(
+            bacfile_mmap_write_stream_data(pathname, 0, &octet, 1), 1, NULL);
+        zassert_equal(
+            bacfile_mmap_read_stream_data(pathname, 0, &octet, 1), 1, NULL);
+    }
+    for (i = 0; i < (2 * BACFILE_MMAP_FILES_MAX); i++) {
+        snprintf(name, sizeof(name), "file-%u.bin", i);
+        test_pathname(pathname, sizeof(pathname), name);
+        zassert_equal(
+            bacfile_mmap_read_stream_data(pathname, 0, &octet, 1), 1, NULL);
+        zassert_equal(octet, i, NULL);
+    }
+    /* a file replaced under its pathname is seen after invalidate */
+    test_pathname(pathname, sizeof(pathname), "file-0.bin");
+    test_pathname(replaced, sizeof(replaced), "file-1.bin");
+    zassert_equal(
+        bacfile_mmap_read_stream_data(pathname, 0, &octet, 1), 1, NULL);
+    zassert_equal(rename(replaced, pathname), 0, NULL);
+    zassert_equal(
+        bacfile_mmap_read_stream_data(pathname, 0, &octet, 1), 1, NULL);
+    zassert_equal(octet, 0, NULL);
+    bacfile_mmap_invalidate(pathname);
+    zassert_equal(
+        bacfile_mmap_read_stream_data(pathname, 0, &octet, 1), 1, NULL);
+    zassert_equal(octet, 1, NULL);
+    bacfile_mmap_cleanup();
+    for (i = 0; i < (2 * BACFILE_MMAP_FILES_MAX); i++) {
+        snprintf(name, sizeof(name), "file-%u.bin", i);
+        test_pathname(pathname, sizeof(pathname), name);
+        unlink(pathname);
+    }
+    rmdir(Test_Directory);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bacfile_mmap_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        bacfile_mmap_tests, ztest_unit_test(test_bacfile_mmap_object),
+        ztest_unit_test(test_bacfile_mmap_files));
+
+    ztest_run_test_suite(bacfile_mmap_tests);
+}
+#endif
@@ -0,0 +1,225 @@
+/**
+ * @file
+ * @brief Tests for the BACnet/IP worker threads on Linux
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <zephyr/ztest.h>
+#include "bacnet/bacdcode.h"
+#include "bacnet/npdu.h"
+#include "bacnet/rp.h"
+#include "bacnet/datalink/bip.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bip-workers.h"
+
+#define TEST_PORT 47833
+#define TEST_CLIENTS 32
+#define TEST_DEVICE_INSTANCE 1234
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static int Client_Socket[TEST_CLIENTS];
+
+/**
+ * @brief Encode a confirmed request from a client to the device
+ * @param mtu - buffer for the datagram
+ * @param invoke_id - invoke ID of the request
+ * @param write - true for a WriteProperty, false for a ReadProperty
+ * @return number of bytes in the datagram
+ */
+static int test_request_encode(uint8_t *mtu, uint8_t invoke_id, bool write)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    len = BIP_HEADER_MAX;
+    len += npdu_encode_pdu(&mtu[len], NULL, NULL, &npdu_data);
+    rpdata.object_type = OBJECT_DEVICE;
+    rpdata.object_instance = TEST_DEVICE_INSTANCE;
+    rpdata.object_property = PROP_OBJECT_IDENTIFIER;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    len += rp_encode_apdu(&mtu[len], invoke_id, &rpdata);
+    if (write) {
+        /* the owner gets it, whatever the rest of the request is */
+        mtu[BIP_HEADER_MAX + 2 + 3] = SERVICE_CONFIRMED_WRITE_PROPERTY;
+    }
+    bvlc_encode_header(mtu, BIP_HEADER_MAX, BVLC_ORIGINAL_UNICAST_NPDU, len);
+
+    return len;
+}
+
+/**
+ * @brief Open the clients, each with its own source port, and send a
+ *  request from each of them to the device
+ * @param write - true for a WriteProperty, false for a ReadProperty
+ */
+static void test_clients_send(bool write)
+{
+    struct sockaddr_in sin = { 0 };
+    uint8_t mtu[64];
+    int len, i;
+
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sin.sin_port = htons(TEST_PORT);
+    for (i = 0; i < TEST_CLIENTS; i++) {
+        Client_Socket[i] = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        zassert_true(Client_Socket[i] >= 0, NULL);
+        len = test_request_encode(mtu, i, write);
+        zassert_equal(
+            sendto(
+                Client_Socket[i], mtu, len, 0, (struct sockaddr *)&sin,
+                sizeof(sin)),
+            len, NULL);
+    }
+}
+
+/**
+ * @brief Count the replies to the clients, and close the clients
+ * @return number of clients that got a ReadProperty-ACK
+ */
+static unsigned test_clients_reply_count(void)
+{
+    struct pollfd fds = { 0 };
+    uint8_t mtu[BIP_MPDU_MAX];
+    uint8_t message_type = 0;
+    uint16_t message_length = 0;
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned count = 0;
+    int len, offset, i;
+
+    for (i = 0; i < TEST_CLIENTS; i++) {
+        fds.fd = Client_Socket[i];
+        fds.events = POLLIN;
+        if (poll(&fds, 1, 100) == 1) {
+            len = recv(Client_Socket[i], mtu, sizeof(mtu), 0);
+            zassert_equal(
+                bvlc_decode_header(mtu, len, &message_type, &message_length),
+                BIP_HEADER_MAX, NULL);
+            zassert_equal(message_type, BVLC_ORIGINAL_UNICAST_NPDU, NULL);
+            zassert_equal(message_length, len, NULL);
+            offset = BIP_HEADER_MAX;
+            offset += bacnet_npdu_decode(
+                &mtu[offset], len - offset, &dest, NULL, &npdu_data);
+            zassert_equal(mtu[offset], PDU_TYPE_COMPLEX_ACK, NULL);
+            zassert_equal(mtu[offset + 1], i, NULL);
+            zassert_equal(
+                mtu[offset + 2], SERVICE_CONFIRMED_READ_PROPERTY, NULL);
+            count++;
+        }
+        close(Client_Socket[i]);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Count the NPDUs that reach the owner through bip_receive()
+ * @return number of NPDUs
+ */
+static unsigned test_owner_receive_count(void)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint8_t npdu[MAX_NPDU + MAX_APDU];
+    unsigned count = 0;
+
+    while (bip_receive(&src, npdu, sizeof(npdu), 100) > 0) {
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Test the worker threads sharing the BACnet/IP port
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bip_workers_tests, test_bip_workers)
+#else
+static void test_bip_workers(void)
+#endif
+{
+    unsigned replies, owner, i;
+
+    bip_set_port(TEST_PORT);
+    /* without SO_REUSEPORT the workers can not share the port */
+    zassert_true(bip_init("lo"), NULL);
+    zassert_false(bip_workers_init(1), NULL);
+    zassert_equal(bip_workers_count(), 0, NULL);
+    bip_cleanup();
+    bip_set_port(TEST_PORT);
+    bip_set_reuse_port(true);
+    zassert_true(bip_init("lo"), NULL);
+    zassert_false(bip_workers_init(0), NULL);
+    zassert_false(bip_workers_init(BIP_WORKERS_MAX + 1), NULL);
+    zassert_true(bip_workers_init(3), NULL);
+    zassert_equal(bip_workers_count(), 3, NULL);
+    zassert_false(bip_workers_init(1), NULL);
+    zassert_true(bip_get_handoff_fd() >= 0, NULL);
+    /* reads are answered by a worker, or received by the owner */
+    test_clients_send(false);
+    owner = test_owner_receive_count();
+    replies = test_clients_reply_count();
+    zassert_equal(replies + owner, TEST_CLIENTS, NULL);
+    zassert_equal(replies, bip_workers_reply_count(), NULL);
+    zassert_true(replies > 0, NULL);
+    /* everything else is for the owner */
+    test_clients_send(true);
+    owner = test_owner_receive_count();
+    zassert_equal(test_clients_reply_count(), 0, NULL);
+    zassert_equal(owner, TEST_CLIENTS, NULL);
+    zassert_equal(replies, bip_workers_reply_count(), NULL);
+    /* the workers wait while the owner has the lock */
+    bip_workers_lock();
+    test_clients_send(false);
+    usleep(50000);
+    zassert_equal(replies, bip_workers_reply_count(), NULL);
+    bip_workers_unlock();
+    owner = test_owner_receive_count();
+    replies = test_clients_reply_count();
+    zassert_equal(replies + owner, TEST_CLIENTS, NULL);
+    /* the workers read again after many short writes */
+    for (i = 0; i < 1000; i++) {
+        bip_workers_lock();
+        bip_workers_unlock();
+    }
+    test_clients_send(false);
+    owner = test_owner_receive_count();
+    replies = test_clients_reply_count();
+    zassert_equal(replies + owner, TEST_CLIENTS, NULL);
+    bip_workers_cleanup();
+    zassert_equal(bip_workers_count(), 0, NULL);
+    /* no lock without the workers */
+    bip_workers_lock();
+    bip_workers_unlock();
+    bip_set_reuse_port(false);
+    bip_cleanup();
+    zassert_equal(bip_get_handoff_fd(), -1, NULL);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bip_workers_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bip_workers_tests, ztest_unit_test(test_bip_workers));
+
+    ztest_run_test_suite(bip_workers_tests);
+}
+#endif
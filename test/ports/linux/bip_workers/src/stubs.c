@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @brief Stubs for the BACnet/IP worker thread tests
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/bacdcode.h"
+#include "bacnet/basic/bbmd/h_bbmd.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/datalink/bip.h"
+
+#define TEST_DEVICE_INSTANCE 1234
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+
+void tsm_free_invoke_id_peer(const BACNET_ADDRESS *src, uint8_t invokeID)
+{
+    (void)src;
+    (void)invokeID;
+}
+
+int bvlc_handler(
+    BACNET_IP_ADDRESS *addr,
+    BACNET_ADDRESS *src,
+    uint8_t *npdu,
+    uint16_t npdu_len)
+{
+    (void)npdu;
+    if (npdu_len <= BIP_HEADER_MAX) {
+        return 0;
+    }
+    bvlc_ip_address_to_bacnet_local(src, addr);
+
+    return BIP_HEADER_MAX;
+}
+
+int bvlc_broadcast_handler(
+    BACNET_IP_ADDRESS *addr,
+    BACNET_ADDRESS *src,
+    uint8_t *npdu,
+    uint16_t npdu_len)
+{
+    return bvlc_handler(addr, src, npdu, npdu_len);
+}
+
+int bvlc_send_pdu(
+    const BACNET_ADDRESS *dest,
+    const BACNET_NPDU_DATA *npdu_data,
+    const uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)pdu;
+
+    return pdu_len;
+}
+
+void bvlc_init(void)
+{
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return TEST_DEVICE_INSTANCE;
+}
+
+bool Device_Valid_Object_Id(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    return (object_type == OBJECT_DEVICE) &&
+        (object_instance == TEST_DEVICE_INSTANCE);
+}
+
+void Device_Objects_Property_List(
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    struct special_property_list_t *pPropertyList)
+{
+    static const int32_t Required[] = { PROP_OBJECT_IDENTIFIER, -1 };
+    static const int32_t Empty[] = { -1 };
+
+    (void)object_type;
+    (void)object_instance;
+    pPropertyList->Required.pList = Required;
+    pPropertyList->Required.count = 1;
+    pPropertyList->Optional.pList = Empty;
+    pPropertyList->Optional.count = 0;
+    pPropertyList->Proprietary.pList = Empty;
+    pPropertyList->Proprietary.count = 0;
+}
+
+int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    if (!Device_Valid_Object_Id(
+            rpdata->object_type, rpdata->object_instance)) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return BACNET_STATUS_ERROR;
+    }
+    if (rpdata->object_property != PROP_OBJECT_IDENTIFIER) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+        return BACNET_STATUS_ERROR;
+    }
+
+    return encode_application_object_id(
+        rpdata->application_data, OBJECT_DEVICE, TEST_DEVICE_INSTANCE);
+}
+
+uint32_t Network_Port_Index_To_Instance(unsigned find_index)
+{
+    (void)find_index;
+
+    return 1;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file
+ * @brief Tests for the point table shared in a memory mapped file on Linux
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zephyr/ztest.h>
+#include "bacnet/basic/object/ai.h"
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/bi.h"
+#include "bacnet/basic/object/bv.h"
+#include "bacnet/basic/object/ms-input.h"
+#include "bacnet/basic/object/msv.h"
+#include "mmap-file.h"
+#include "point-table-mmap.h"
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the last object write, from the stubs below */
+static BACNET_OBJECT_TYPE Test_Object_Type = MAX_BACNET_OBJECT_TYPE;
+static uint32_t Test_Object_Instance;
+static float Test_Real_Value;
+static uint32_t Test_Unsigned_Value;
+static BACNET_RELIABILITY Test_Reliability;
+
+void Analog_Input_Present_Value_Set(uint32_t object_instance, float value)
+{
+    Test_Object_Type = OBJECT_ANALOG_INPUT;
+    Test_Object_Instance = object_instance;
+    Test_Real_Value = value;
+}
+
+bool Analog_Input_Reliability_Set(
+    uint32_t object_instance, BACNET_RELIABILITY value)
+{
+    (void)object_instance;
+    Test_Reliability = value;
+    return true;
+}
+
+bool Analog_Value_Present_Value_Set(
+    uint32_t object_instance, float value, uint8_t priority)
+{
+    (void)priority;
+    Test_Object_Type = OBJECT_ANALOG_VALUE;
+    Test_Object_Instance = object_instance;
+    Test_Real_Value = value;
+    return true;
+}
+
+bool Analog_Value_Reliability_Set(
+    uint32_t object_instance, BACNET_RELIABILITY value)
+{
+    (void)object_instance;
+    Test_Reliability = value;
+    return true;
+}
+
+bool Binary_Input_Present_Value_Set(
+    uint32_t object_instance, BACNET_BINARY_PV value)
+{
+    Test_Object_Type = OBJECT_BINARY_INPUT;
+    Test_Object_Instance = object_instance;
+    Test_Unsigned_Value = value;
+    return true;
+}
+
+bool Binary_Input_Reliability_Set(
+    uint32_t object_instance, BACNET_RELIABILITY value)
+{
+    (void)object_instance;
+    Test_Reliability = value;
+    return true;
+}
+
+bool Binary_Value_Present_Value_Set(uint32_t instance, BACNET_BINARY_PV value)
+{
+    Test_Object_Type = OBJECT_BINARY_VALUE;
+    Test_Object_Instance = instance;
+    Test_Unsigned_Value = value;
+    return true;
+}
+
+bool Binary_Value_Reliability_Set(
+    uint32_t object_instance, BACNET_RELIABILITY value)
+{
+    (void)object_instance;
+    Test_Reliability = value;
+    return true;
+}
+
+bool Multistate_Input_Present_Value_Set(
+    uint32_t object_instance, uint32_t value)
+{
+    Test_Object_Type = OBJECT_MULTI_STATE_INPUT;
+    Test_Object_Instance = object_instance;
+    Test_Unsigned_Value = value;
+    return true;
+}
+
+bool Multistate_Input_Reliability_Set(
+    uint32_t object_instance, BACNET_RELIABILITY value)
+{
+    (void)object_instance;
+    Test_Reliability = value;
+    return true;
+}
+
+bool Multistate_Value_Present_Value_Set(
+    uint32_t object_instance, uint32_t value)
+{
+    Test_Object_Type = OBJECT_MULTI_STATE_VALUE;
+    Test_Object_Instance = object_instance;
+    Test_Unsigned_Value = value;
+    return true;
+}
+
+bool Multistate_Value_Reliability_Set(
+    uint32_t object_instance, BACNET_RELIABILITY value)
+{
+    (void)object_instance;
+    Test_Reliability = value;
+    return true;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(point_table_mmap_tests, test_point_table_mmap)
+#else
+static void test_point_table_mmap(void)
+#endif
+{
+    char directory[] = "/tmp/point-table-mmap-XXXXXX";
+    char pathname[PATH_MAX];
+    POINT_TABLE *table, *driver;
+    POINT_TABLE_VALUE value = { 0 };
+    uint8_t *storage;
+    size_t size = 0;
+    unsigned count;
+
+    zassert_not_null(mkdtemp(directory), NULL);
+    snprintf(pathname, sizeof(pathname), "%s/points", directory);
+    zassert_is_null(point_table_mmap(), NULL);
+    table = point_table_mmap_init(pathname, 8);
+    zassert_not_null(table, NULL);
+    zassert_equal(point_table_mmap(), table, NULL);
+    zassert_equal(Point_Table_Count(table), 8, NULL);
+    zassert_true(Point_Table_Bind(table, 0, OBJECT_ANALOG_INPUT, 1), NULL);
+    zassert_true(Point_Table_Bind(table, 1, OBJECT_BINARY_VALUE, 2), NULL);
+    zassert_true(
+        Point_Table_Bind(table, 2, OBJECT_MULTI_STATE_INPUT, 3), NULL);
+    zassert_equal(point_table_mmap_task(), 0, NULL);
+
+    /* a driver process maps the same file at its own address */
+    storage = mmap_file_open(pathname, &size);
+    zassert_not_null(storage, NULL);
+    zassert_equal(size, Point_Table_Size(8), NULL);
+    driver = Point_Table_Attach(storage, size);
+    zassert_not_null(driver, NULL);
+    zassert_not_equal(driver, table, NULL);
+    zassert_equal(Point_Table_Find(driver, OBJECT_BINARY_VALUE, 2), 1, NULL);
+    value.value = 42.25;
+    value.reliability = RELIABILITY_NO_FAULT_DETECTED;
+    zassert_true(Point_Table_Write(driver, 0, &value), NULL);
+    count = point_table_mmap_task();
+    zassert_equal(count, 1, NULL);
+    zassert_equal(Test_Object_Type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(Test_Object_Instance, 1, NULL);
+    zassert_false(islessgreater(Test_Real_Value, 42.25f), NULL);
+    value.value = 1.0;
+    value.reliability = RELIABILITY_COMMUNICATION_FAILURE;
+    zassert_true(Point_Table_Write(driver, 1, &value), NULL);
+    count = point_table_mmap_task();
+    zassert_equal(count, 1, NULL);
+    zassert_equal(Test_Object_Type, OBJECT_BINARY_VALUE, NULL);
+    zassert_equal(Test_Object_Instance, 2, NULL);
+    zassert_equal(Test_Unsigned_Value, BINARY_ACTIVE, NULL);
+    zassert_equal(Test_Reliability, RELIABILITY_COMMUNICATION_FAILURE, NULL);
+    value.value = 3.0;
+    value.reliability = RELIABILITY_NO_FAULT_DETECTED;
+    zassert_true(Point_Table_Write(driver, 2, &value), NULL);
+    count = point_table_mmap_task();
+    zassert_equal(count, 1, NULL);
+    zassert_equal(Test_Object_Type, OBJECT_MULTI_STATE_INPUT, NULL);
+    zassert_equal(Test_Unsigned_Value, 3, NULL);
+    zassert_equal(point_table_mmap_task(), 0, NULL);
+    mmap_file_close(NULL, storage, size, false);
+
+    /* the table and its bindings survive a restart of the server */
+    point_table_mmap_cleanup(false);
+    zassert_is_null(point_table_mmap(), NULL);
+    table = point_table_mmap_init(pathname, 4);
+    zassert_not_null(table, NULL);
+    zassert_equal(Point_Table_Count(table), 8, NULL);
+    zassert_equal(
+        Point_Table_Find(table, OBJECT_MULTI_STATE_INPUT, 3), 2, NULL);
+    point_table_mmap_cleanup(true);
+    zassert_equal(access(pathname, F_OK), -1, NULL);
+    zassert_equal(rmdir(directory), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(point_table_mmap_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        point_table_mmap_tests, ztest_unit_test(test_point_table_mmap));
+
+    ztest_run_test_suite(point_table_mmap_tests);
+}
+#endif
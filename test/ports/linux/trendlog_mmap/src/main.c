@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @brief Tests for the Trend Log storage in memory mapped files on Linux
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <zephyr/ztest.h>
+#include "bacnet/basic/object/trendlog.h"
+#include "trendlog-mmap.h"
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Get the size of the storage file of a log
+ * @param directory - directory of the storage files
+ * @param object_instance - object-instance number of the log
+ * @return size of the file, or -1 if there is no file
+ */
+static long test_file_size(const char *directory, uint32_t object_instance)
+{
+    char pathname[PATH_MAX];
+    struct stat st = { 0 };
+
+    snprintf(
+        pathname, sizeof(pathname), "%s/trendlog-0-%lu.dat", directory,
+        (unsigned long)object_instance);
+    if (stat(pathname, &st) != 0) {
+        return -1;
+    }
+
+    return (long)st.st_size;
+}
+
+/**
+ * @brief Encode the newest records of a log
+ * @param apdu - buffer for the records
+ * @param object_instance - object-instance number of the log
+ * @return number of bytes encoded
+ */
+static int test_newest_records_encode(uint8_t *apdu, uint32_t object_instance)
+{
+    BACNET_READ_RANGE_DATA request = { 0 };
+
+    request.object_type = OBJECT_TRENDLOG;
+    request.object_instance = object_instance;
+    request.object_property = PROP_LOG_BUFFER;
+    request.array_index = BACNET_ARRAY_ALL;
+    request.RequestType = RR_BY_POSITION;
+    request.Range.RefIndex = Trend_Log_Record_Count(object_instance);
+    request.Count = -10;
+
+    return rr_trend_log_encode(apdu, &request);
+}
+
+/**
+ * @brief Test the records of the trend logs surviving a restart
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(trendlog_mmap_tests, test_trendlog_mmap)
+#else
+static void test_trendlog_mmap(void)
+#endif
+{
+    char directory[] = "/tmp/trendlog-mmap-XXXXXX";
+    char pathname[PATH_MAX];
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    uint32_t object_instance, total_records;
+    unsigned count, i;
+    int len, test_len;
+    FILE *file;
+
+    zassert_not_null(mkdtemp(directory), NULL);
+    zassert_false(trend_log_mmap_init(NULL), NULL);
+    zassert_false(trend_log_mmap_init("/nonexistent/trendlog"), NULL);
+    zassert_true(trend_log_mmap_init(directory), NULL);
+    /* a file that is too small is replaced by a new log */
+    object_instance = Trend_Log_Index_To_Instance(1);
+    snprintf(
+        pathname, sizeof(pathname), "%s/trendlog-0-%lu.dat", directory,
+        (unsigned long)object_instance);
+    file = fopen(pathname, "w");
+    zassert_not_null(file, NULL);
+    fputs("junk", file);
+    fclose(file);
+    /* new files get the test records */
+    Trend_Log_Init();
+    count = Trend_Log_Count();
+    for (i = 0; i < count; i++) {
+        object_instance = Trend_Log_Index_To_Instance(i);
+        zassert_equal(
+            test_file_size(directory, object_instance),
+            (long)TL_STORAGE_SIZE(TL_MAX_ENTRIES), NULL);
+        zassert_equal(
+            Trend_Log_Record_Count(object_instance), TL_MAX_ENTRIES, NULL);
+    }
+    object_instance = Trend_Log_Index_To_Instance(0);
+    TL_Insert_Status_Rec(
+        Trend_Log_Instance_To_Index(object_instance),
+        LOG_STATUS_LOG_INTERRUPTED, true);
+    total_records = Trend_Log_Total_Record_Count(object_instance);
+    len = test_newest_records_encode(apdu, object_instance);
+    zassert_true(len > 0, NULL);
+    /* the records are resumed from the files after a restart */
+    trend_log_mmap_cleanup();
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), 0, NULL);
+    zassert_true(trend_log_mmap_init(directory), NULL);
+    Trend_Log_Init();
+    zassert_equal(
+        Trend_Log_Total_Record_Count(object_instance), total_records, NULL);
+    test_len = test_newest_records_encode(test_apdu, object_instance);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    /* a resized log gets a new file, which is kept at its size */
+    zassert_true(Trend_Log_Buffer_Size_Set(object_instance, 43200), NULL);
+    zassert_equal(
+        test_file_size(directory, object_instance),
+        (long)TL_STORAGE_SIZE(43200), NULL);
+    zassert_equal(Trend_Log_Record_Count(object_instance), 1, NULL);
+    trend_log_mmap_cleanup();
+    zassert_true(trend_log_mmap_init(directory), NULL);
+    Trend_Log_Init();
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), 43200, NULL);
+    zassert_equal(Trend_Log_Record_Count(object_instance), 1, NULL);
+    zassert_equal(
+        Trend_Log_Total_Record_Count(object_instance), total_records + 1,
+        NULL);
+    trend_log_mmap_cleanup();
+    for (i = 0; i < count; i++) {
+        snprintf(
+            pathname, sizeof(pathname), "%s/trendlog-0-%lu.dat", directory,
+            (unsigned long)Trend_Log_Index_To_Instance(i));
+        zassert_equal(unlink(pathname), 0, NULL);
+    }
+    zassert_equal(rmdir(directory), 0, NULL);
+}
+
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(trendlog_mmap_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        trendlog_mmap_tests, ztest_unit_test(test_trendlog_mmap));
+
+    ztest_run_test_suite(trendlog_mmap_tests);
+}
+#endif
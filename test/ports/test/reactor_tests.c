@@ -0,0 +1,223 @@
+/**
+ * @file
+ * @brief Tests for the event loop of the Linux, BSD, and Windows ports
+ *  for datalinks, events, and timers
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#if defined(_WIN32)
+#include "bacport.h"
+#else
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
+#include "reactor.h"
+
+static unsigned Callback_Count;
+static int Callback_FD;
+static int Remove_FD;
+
+static void test_callback(int fd, void *context)
+{
+    char data;
+
+    Callback_Count++;
+    Callback_FD = fd;
+    if (context) {
+        /* a socket: consume the data that woke us up */
+#if defined(_WIN32)
+        (void)recv((SOCKET)fd, &data, sizeof(data), 0);
+#else
+        (void)read(fd, &data, sizeof(data));
+#endif
+    }
+}
+
+static void test_stop_callback(int fd, void *context)
+{
+    (void)context;
+    Callback_Count++;
+    Callback_FD = fd;
+    reactor_stop();
+}
+
+static void test_remove_callback(int fd, void *context)
+{
+    (void)fd;
+    (void)context;
+    Callback_Count++;
+    reactor_close(Remove_FD);
+}
+
+static void test_npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t len)
+{
+    (void)src;
+    (void)pdu;
+    (void)len;
+    Callback_Count++;
+}
+
+#if defined(_WIN32)
+static void test_reactor_fd(void)
+{
+    struct sockaddr_in sin = { 0 };
+    int sin_len = sizeof(sin);
+    WSADATA wd;
+    SOCKET sock;
+    char data = 0x55;
+
+    zassert_equal(WSAStartup(MAKEWORD(2, 2), &wd), 0, NULL);
+    zassert_true(reactor_init(), NULL);
+    /* a datagram socket that sends to itself */
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    zassert_true(sock != INVALID_SOCKET, NULL);
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    zassert_equal(bind(sock, (struct sockaddr *)&sin, sizeof(sin)), 0, NULL);
+    zassert_equal(
+        getsockname(sock, (struct sockaddr *)&sin, &sin_len), 0, NULL);
+    zassert_true(reactor_fd_add((int)sock, test_callback, &sock), NULL);
+    /* the same socket can only be added once */
+    zassert_false(reactor_fd_add((int)sock, test_callback, NULL), NULL);
+    zassert_false(reactor_fd_add(-1, test_callback, NULL), NULL);
+    Callback_Count = 0;
+    zassert_equal(reactor_run_once(0), 0, NULL);
+    zassert_equal(
+        sendto(
+            sock, &data, sizeof(data), 0, (struct sockaddr *)&sin,
+            sizeof(sin)),
+        1, NULL);
+    zassert_equal(reactor_run_once(1000), 1, NULL);
+    zassert_equal(Callback_Count, 1, NULL);
+    zassert_equal(Callback_FD, (int)sock, NULL);
+    zassert_equal(reactor_run_once(0), 0, NULL);
+    /* removed, but still open */
+    zassert_true(reactor_fd_remove((int)sock), NULL);
+    zassert_false(reactor_fd_remove((int)sock), NULL);
+    closesocket(sock);
+    reactor_cleanup();
+    WSACleanup();
+}
+#else
+static void test_reactor_fd(void)
+{
+    int sv[2];
+    char data = 0x55;
+
+    zassert_true(reactor_init(), NULL);
+    zassert_equal(socketpair(AF_UNIX, SOCK_DGRAM, 0, sv), 0, NULL);
+    zassert_true(reactor_fd_add(sv[0], test_callback, &sv[0]), NULL);
+    /* the same file descriptor can only be added once */
+    zassert_false(reactor_fd_add(sv[0], test_callback, NULL), NULL);
+    zassert_false(reactor_fd_add(-1, test_callback, NULL), NULL);
+    zassert_false(reactor_fd_add(sv[1], NULL, NULL), NULL);
+    Callback_Count = 0;
+    zassert_equal(reactor_run_once(0), 0, NULL);
+    zassert_equal(write(sv[1], &data, sizeof(data)), 1, NULL);
+    zassert_equal(reactor_run_once(1000), 1, NULL);
+    zassert_equal(Callback_Count, 1, NULL);
+    zassert_equal(Callback_FD, sv[0], NULL);
+    zassert_equal(reactor_run_once(0), 0, NULL);
+    /* removed, but still open */
+    zassert_true(reactor_fd_remove(sv[0]), NULL);
+    zassert_false(reactor_fd_remove(sv[0]), NULL);
+    zassert_equal(write(sv[1], &data, sizeof(data)), 1, NULL);
+    zassert_equal(reactor_run_once(0), 0, NULL);
+    zassert_equal(read(sv[0], &data, sizeof(data)), 1, NULL);
+    close(sv[0]);
+    close(sv[1]);
+    reactor_cleanup();
+}
+#endif
+
+static void test_reactor_timer(void)
+{
+    int fd;
+
+    zassert_true(reactor_init(), NULL);
+    zassert_equal(reactor_timer_add(0, test_callback, NULL), -1, NULL);
+    fd = reactor_timer_add(10, test_callback, NULL);
+    zassert_true(fd >= 0, NULL);
+    Callback_Count = 0;
+    zassert_equal(reactor_run_once(1000), 1, NULL);
+    zassert_equal(Callback_FD, fd, NULL);
+    zassert_equal(reactor_run_once(1000), 1, NULL);
+    zassert_equal(Callback_Count, 2, NULL);
+    reactor_close(fd);
+    zassert_equal(reactor_run_once(20), 0, NULL);
+    /* reactor_run() until a timer stops it */
+    fd = reactor_timer_add(10, test_stop_callback, NULL);
+    zassert_true(fd >= 0, NULL);
+    Callback_Count = 0;
+    reactor_run();
+    zassert_equal(Callback_Count, 1, NULL);
+    reactor_cleanup();
+}
+
+static void test_reactor_event(void)
+{
+    int fd, fd2;
+
+    zassert_true(reactor_init(), NULL);
+    fd = reactor_event_add(test_callback, NULL);
+    zassert_true(fd >= 0, NULL);
+    Callback_Count = 0;
+    zassert_equal(reactor_run_once(0), 0, NULL);
+    /* signals before the wait are combined into one callback */
+    zassert_true(reactor_event_signal(fd), NULL);
+    zassert_true(reactor_event_signal(fd), NULL);
+    zassert_equal(reactor_run_once(1000), 1, NULL);
+    zassert_equal(Callback_FD, fd, NULL);
+    zassert_equal(reactor_run_once(0), 0, NULL);
+    zassert_false(reactor_event_signal(-1), NULL);
+    reactor_close(fd);
+    /* an event removed by an earlier callback in the same wait */
+    fd = reactor_event_add(test_remove_callback, NULL);
+    fd2 = reactor_event_add(test_remove_callback, NULL);
+    zassert_true(fd >= 0, NULL);
+    zassert_true(fd2 >= 0, NULL);
+    Remove_FD = fd2;
+    zassert_true(reactor_event_signal(fd), NULL);
+    zassert_true(reactor_event_signal(fd2), NULL);
+    Callback_Count = 0;
+    (void)reactor_run_once(1000);
+    if (Callback_Count == 1) {
+        zassert_equal(reactor_run_once(0), 0, NULL);
+    } else {
+        /* the second event was first: it removed itself */
+        zassert_equal(Callback_Count, 2, NULL);
+    }
+    reactor_cleanup();
+    zassert_false(reactor_event_signal(fd2), NULL);
+}
+
+static void test_reactor_datalink(void)
+{
+    uint8_t pdu[MAX_MPDU];
+
+    zassert_false(
+        reactor_datalink_add(pdu, sizeof(pdu), test_npdu_handler), NULL);
+    zassert_true(reactor_init(), NULL);
+    zassert_false(reactor_datalink_add(NULL, sizeof(pdu), NULL), NULL);
+    zassert_true(
+        reactor_datalink_add(pdu, sizeof(pdu), test_npdu_handler), NULL);
+    Callback_Count = 0;
+    /* the datalink is checked once when added */
+    zassert_equal(reactor_run_once(1000), 1, NULL);
+    zassert_equal(reactor_run_once(0), 0, NULL);
+    zassert_equal(Callback_Count, 0, NULL);
+    reactor_datalink_remove();
+    reactor_cleanup();
+    zassert_equal(reactor_run_once(0), -1, NULL);
+}
+
+void test_main(void)
+{
+    ztest_test_suite(
+        reactor_test, ztest_unit_test(test_reactor_fd),
+        ztest_unit_test(test_reactor_timer),
+        ztest_unit_test(test_reactor_event),
+        ztest_unit_test(test_reactor_datalink));
+    ztest_run_test_suite(reactor_test);
+}